@@ -230,6 +230,10 @@ if _ACTION then
 		uuid "23112391-0616-46AF-B0C2-5325E8530FBC"
 		kind "StaticLib"
 		language "C++"
+		defines
+		{
+			"BT_THREADSAFE=1",
+		}
 		includedirs
 		{
 			"bullet/src/",
@@ -512,6 +516,10 @@ if _ACTION then
 			"nvtt/src/nvtt/cuda/*.cpp",
 			"nvtt/src/nvtt/squish/*.h",
 			"nvtt/src/nvtt/squish/*.cpp",
+			"nvtt/src/bc6h/*.h",
+			"nvtt/src/bc6h/*.cpp",
+			"nvtt/src/bc7/*.h",
+			"nvtt/src/bc7/*.cpp",
 		}
 		excludes
 		{
@@ -524,7 +532,6 @@ if _ACTION then
 			"nvtt/src/nvtt/squish/singlecolourfit.*",
 			"nvtt/src/nvtt/squish/singlechannelfit.*",
 			"nvtt/src/nvtt/squish/squish.*",
-			"nvtt/src/nvtt/CompressorDX11.*",
 		}
 
 		configuration "linux"
@@ -6,6 +6,7 @@
 #include "GameLibrary/GameLogic/PlayerManager.h"
 #include "Foundation/Numeric.h"
 #include "Framework/World.h"
+#include "Components/SpatialHashComponent.h"
 
 using namespace Helium;
 using namespace GameLibrary;
@@ -33,68 +34,83 @@ void AIComponentChasePlayerDefinition::PopulateMetaType( Helium::Reflect::MetaSt
 //////////////////////////////////////////////////////////////////////////
 // TaskProcessAI
 
-typedef DynamicArray< Pair< PlayerComponent *, Simd::Vector3 > > PlayerList;
-static PlayerList g_PlayerList;
+// Chasing agents are gathered first so their targets can be found with one batched spatial hash query. The arrays
+// keep their capacity from the last tick, and are per thread so sharded worlds can run AI at the same time
+static thread_local DynamicArray< AvatarControllerComponent * > g_ChaseControllers;
+static thread_local DynamicArray< Simd::Vector3 > g_ChasePositions;
+static thread_local DynamicArray< SpatialHashComponent::Result > g_ChaseTargets;
+static thread_local DynamicArray< size_t > g_ChaseTargetOffsets;
 
-void UpdateAI_ChasePlayer( AIComponentChasePlayer *pAiComponent, AvatarControllerComponent *pController )
+void StopAvatar( AvatarControllerComponent *pController )
 {
-	PlayerComponent *pTarget = NULL;
-	float pTargetDistanceSquared = NumericLimits<float>::Maximum;
-	Simd::Vector3 targetPosition = Simd::Vector3::Zero;
-	Simd::Vector3 myPosition = Simd::Vector3::Zero;
+	pController->m_MoveDir = Simd::Vector2::Zero;
+	pController->m_AimDir = Simd::Vector3::Zero;
+	pController->m_bShoot = false;
+}
 
+void GatherAI_ChasePlayer( AIComponentChasePlayer *pAiComponent, AvatarControllerComponent *pController )
+{
 	TransformComponent *pTransform = pAiComponent->GetComponentCollection()->GetFirst<TransformComponent>();
 	
 	if ( pTransform )
 	{
-		myPosition = pTransform->GetPosition();
-		for (PlayerList::Iterator iter = g_PlayerList.Begin(); iter != g_PlayerList.End(); ++iter)
-		{
-			float d = (iter->Second() - myPosition).GetMagnitudeSquared();
-			if ( d < pTargetDistanceSquared )
-			{
-				pTargetDistanceSquared = d;
-				pTarget = iter->First();
-				targetPosition = iter->Second();
-			}
-		}
-	}
-	
-	if ( pTarget )
-	{
-		Simd::Vector3 moveDir = (targetPosition - myPosition).GetNormalized();
-
-		pController->m_MoveDir.SetX( moveDir.GetElement(0));
-		pController->m_MoveDir.SetY( moveDir.GetElement(1));
-		pController->m_AimDir = Simd::Vector3::Zero;
-		pController->m_bShoot = false;
+		g_ChaseControllers.Push( pController );
+		g_ChasePositions.Push( pTransform->GetPosition() );
 	}
 	else
 	{
-		pController->m_MoveDir = Simd::Vector2::Zero;
-		pController->m_AimDir = Simd::Vector3::Zero;
-		pController->m_bShoot = false;
+		StopAvatar( pController );
 	}
 }
 
 void ProcessAI( World *pWorld )
 {
-	g_PlayerList.Clear();
+	g_ChaseControllers.Resize( 0 );
+	g_ChasePositions.Resize( 0 );
+	g_ChaseTargets.Resize( 0 );
 
-	for ( ImplementingComponentIterator<PlayerComponent> iterator( *pWorld->GetComponentManager() ); iterator.GetBaseComponent(); iterator.Advance() )
+	QueryComponents< AIComponentChasePlayer, AvatarControllerComponent, GatherAI_ChasePlayer >( pWorld );
+
+	// The spatial hash is created by UpdateSpatialHashTask, so there is none on the very first frame
+	SpatialHashComponent *pSpatialHash = pWorld->GetComponents().GetFirst<SpatialHashComponent>();
+	if ( !pSpatialHash )
 	{
-		if ( iterator->m_Avatar )
+		for ( size_t agentIndex = 0; agentIndex < g_ChaseControllers.GetSize(); ++agentIndex )
 		{
-			TransformComponent *pTransform = iterator->m_Avatar->GetFirst<TransformComponent>();
-
-			if ( pTransform )
-			{
-				g_PlayerList.New( *iterator, pTransform->GetPosition() );
-			}
+			StopAvatar( g_ChaseControllers[ agentIndex ] );
 		}
+
+		return;
 	}
 
-	QueryComponents< AIComponentChasePlayer, AvatarControllerComponent, UpdateAI_ChasePlayer >( pWorld );
+	pSpatialHash->FindNearestBatch(
+		g_ChasePositions.GetData(),
+		g_ChasePositions.GetSize(),
+		PlayerComponent::AVATAR_SPATIAL_LAYER,
+		1,
+		NumericLimits<float>::Maximum,
+		g_ChaseTargets,
+		g_ChaseTargetOffsets );
+
+	for ( size_t agentIndex = 0; agentIndex < g_ChaseControllers.GetSize(); ++agentIndex )
+	{
+		AvatarControllerComponent *pController = g_ChaseControllers[ agentIndex ];
+		
+		if ( g_ChaseTargetOffsets[ agentIndex + 1 ] > g_ChaseTargetOffsets[ agentIndex ] )
+		{
+			const SpatialHashComponent::Result &rTarget = g_ChaseTargets[ g_ChaseTargetOffsets[ agentIndex ] ];
+			Simd::Vector3 moveDir = (rTarget.m_Position - g_ChasePositions[ agentIndex ]).GetNormalized();
+
+			pController->m_MoveDir.SetX( moveDir.GetElement(0));
+			pController->m_MoveDir.SetY( moveDir.GetElement(1));
+			pController->m_AimDir = Simd::Vector3::Zero;
+			pController->m_bShoot = false;
+		}
+		else
+		{
+			StopAvatar( pController );
+		}
+	}
 }
 
 HELIUM_DEFINE_TASK( TaskProcessAI, ( ForEachWorld< ProcessAI > ), TickTypes::Gameplay )
@@ -102,5 +118,9 @@ HELIUM_DEFINE_TASK( TaskProcessAI, ( ForEachWorld< ProcessAI > ), TickTypes::Gam
 void TaskProcessAI::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecuteAfter<Helium::StandardDependencies::ReceiveInput>();
+	rContract.ExecuteBefore<GameLibrary::ControlAvatarTask>();
 	rContract.ExecuteBefore<Helium::StandardDependencies::ProcessPhysics>();
+
+	// Only writes the controllers of AI-driven avatars and only reads the spatial hash, which is updated after gameplay
+	rContract.AllowConcurrentExecution();
 }
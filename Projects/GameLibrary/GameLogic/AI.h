@@ -30,4 +30,6 @@ namespace GameLibrary
 
 		virtual void DefineContract(Helium::TaskContract &rContract);
 	};
-}
\ No newline at end of file
+}
+
+HELIUM_COMPONENT_PREFAB_IMAGE( GameLibrary::AIComponentChasePlayer )
@@ -62,7 +62,7 @@ void ApplyPlayerInputToAvatar( PlayerInputComponent *pPlayerInput, AvatarControl
 	pController->m_bShoot = pPlayerInput->m_bFirePrimary;
 }
 
-HELIUM_DEFINE_TASK( ApplyPlayerInputToAvatarTask, (ForEachWorld< QueryComponents< PlayerInputComponent, AvatarControllerComponent, ApplyPlayerInputToAvatar > >), TickTypes::Gameplay )
+HELIUM_DEFINE_TASK( ApplyPlayerInputToAvatarTask, (ForEachWorld< CachedQueryComponents< PlayerInputComponent, AvatarControllerComponent, ApplyPlayerInputToAvatar > >), TickTypes::Gameplay )
 
 void GameLibrary::ApplyPlayerInputToAvatarTask::DefineContract( Helium::TaskContract &rContract )
 {
@@ -42,10 +42,9 @@ void DamageOnContactComponentDefinition::PopulateMetaType( Reflect::MetaStruct&
 
 void ApplyDamage( HasPhysicalContactsComponent *pHasPhysicalContacts, DamageOnContactComponent *pDamageOnContact )
 {
-	for (Set<EntityWPtr>::Iterator iter = pHasPhysicalContacts->m_EverTouchedThisFrame.Begin();
-		iter != pHasPhysicalContacts->m_EverTouchedThisFrame.End(); ++iter)
+	for (size_t i = 0; i < pHasPhysicalContacts->m_EverTouchedThisFrame.GetSize(); ++i)
 	{
-		Entity *pOtherEntity = *iter;
+		Entity *pOtherEntity = pHasPhysicalContacts->m_EverTouchedThisFrame[i];
 
 		if (!pOtherEntity)
 		{
@@ -65,7 +64,7 @@ void ApplyDamage( HasPhysicalContactsComponent *pHasPhysicalContacts, DamageOnCo
 	}
 }
 
-HELIUM_DEFINE_TASK( ApplyDamageOnContact, (ForEachWorld< QueryComponents< HasPhysicalContactsComponent, DamageOnContactComponent, ApplyDamage > >), TickTypes::Gameplay )
+HELIUM_DEFINE_TASK( ApplyDamageOnContact, (ForEachWorld< CachedQueryComponents< HasPhysicalContactsComponent, DamageOnContactComponent, ApplyDamage > >), TickTypes::Gameplay )
 
 void GameLibrary::ApplyDamageOnContact::DefineContract( Helium::TaskContract &rContract )
 {
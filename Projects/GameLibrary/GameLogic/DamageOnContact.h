@@ -48,3 +48,5 @@ namespace GameLibrary
 		virtual void DefineContract(Helium::TaskContract &rContract);
 	};
 }
+
+HELIUM_COMPONENT_PREFAB_IMAGE( GameLibrary::DamageOnContactComponent )
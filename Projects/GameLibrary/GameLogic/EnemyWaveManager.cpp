@@ -122,8 +122,51 @@ bool PredicateEnemyWaveAlive::Evaluate( World &pWorld, ParameterSet *pParamSet )
 	return (fractionAlive + HELIUM_EPSILON) > m_FractionAlive;
 }
 
+uint32_t PredicateEnemyWaveAlive::GetInputStamp( World &pWorld, ParameterSet *pParamSet )
+{
+	EnemyWaveManagerComponent *pEnemyWaveManager = pWorld.GetComponents().GetFirst<EnemyWaveManagerComponent>();
+
+	return pEnemyWaveManager ? pEnemyWaveManager->GetWaveManager().GetChangeStamp() : Invalid< uint32_t >();
+}
+
 //////////////////////////////////////////////////////////////////////////
 // EnemyWaveManager
+EnemyWaveManager::WaveState::WaveState( EnemyWaveManager *pManager, EnemyWaveDefinition *pDefinition, uint32_t entityCount )
+: m_pManager( pManager )
+, m_WaveDefinition( pDefinition )
+, m_EntityCount( entityCount )
+, m_AliveCount( 0 )
+{
+	m_Entities.Reserve( entityCount );
+}
+
+void EnemyWaveManager::WaveState::OnEntityDestroyed( Entity *pEntity )
+{
+	HELIUM_ASSERT( m_AliveCount > 0 );
+	--m_AliveCount;
+	++m_pManager->m_ChangeStamp;
+}
+
+EnemyWaveManager::~EnemyWaveManager()
+{
+	// Entities can outlive the manager, so make sure none of them call back into a freed wave
+	for (DynamicArray< WaveState * >::Iterator wave_iter = m_ActiveWaves.Begin();
+		wave_iter != m_ActiveWaves.End(); ++wave_iter)
+	{
+		WaveState *pWaveState = *wave_iter;
+		for (DynamicArray< EntityWPtr >::Iterator entity_iter = pWaveState->m_Entities.Begin(); 
+			entity_iter != pWaveState->m_Entities.End(); ++entity_iter)
+		{
+			if (*entity_iter)
+			{
+				(*entity_iter)->SetOnDestroyed( Delegate<Entity*>() );
+			}
+		}
+
+		delete pWaveState;
+	}
+}
+
 void EnemyWaveManager::Initialize(World *pWorld)
 {
 	m_pWorld = pWorld;
@@ -131,21 +174,14 @@ void EnemyWaveManager::Initialize(World *pWorld)
 
 void EnemyWaveManager::Update( float dt )
 {
+	// Waves are only dropped here rather than from the destruction callback, which runs inside the wave itself
 	for (size_t i = m_ActiveWaves.GetSize() - 1; i < m_ActiveWaves.GetSize(); --i)
 	{
-		bool hasEntityRemaining = false;
-
-		for (Helium::DynamicArray< WaveEntityState >::Iterator entity_iter = m_ActiveWaves[i].m_Entities.Begin(); 
-			entity_iter != m_ActiveWaves[i].m_Entities.End(); ++entity_iter)
+		if (m_ActiveWaves[i]->m_AliveCount == 0)
 		{
-			if (entity_iter->m_Entity)
-			{
-				hasEntityRemaining = true;
-				break;
-			}
+			delete m_ActiveWaves[i];
+			m_ActiveWaves.RemoveSwap(i);
 		}
-
-		m_ActiveWaves.RemoveSwap(i);
 	}
 }
 
@@ -153,8 +189,8 @@ void EnemyWaveManager::SpawnWave( EnemyWaveDefinition *pWave, ParameterSet_Actio
 {
 	HELIUM_ASSERT(pParameters);
 
-	WaveState *pWaveState = m_ActiveWaves.New();
-	pWaveState->m_Entities.Reserve(pParameters->m_Count);
+	WaveState *pWaveState = new WaveState( this, pWave, static_cast<uint32_t>( Max( pParameters->m_Count, 0 ) ) );
+	m_ActiveWaves.Push( pWaveState );
 
 	for (int i = 0; i < pParameters->m_Count; ++i)
 	{
@@ -173,30 +209,28 @@ void EnemyWaveManager::SpawnWave( EnemyWaveDefinition *pWave, ParameterSet_Actio
 		HELIUM_ASSERT( pWave->m_Entity );
 		Entity *pEntity = m_pWorld->GetRootSlice()->CreateEntity(pWave->m_Entity, builder.GetSet());
 
-		WaveEntityState *pEntityState = pWaveState->m_Entities.New();
-		pEntityState->m_Entity = pEntity;
+		if (pEntity)
+		{
+			pEntity->SetOnDestroyed( Delegate<Entity*>( pWaveState, &WaveState::OnEntityDestroyed ) );
+			pWaveState->m_Entities.Push( pEntity );
+			++pWaveState->m_AliveCount;
+		}
 	}
+
+	++m_ChangeStamp;
 }
 
 float GameLibrary::EnemyWaveManager::GetPercentAlive( EnemyWaveDefinition *pDefinition )
 {
 	float returnValue = 0.0f;
 
-	for (DynamicArray< WaveState >::Iterator wave_iter = m_ActiveWaves.Begin();
+	for (DynamicArray< WaveState * >::Iterator wave_iter = m_ActiveWaves.Begin();
 		wave_iter != m_ActiveWaves.End(); ++wave_iter)
 	{
-		if (wave_iter->m_WaveDefinition.Get() == pDefinition)
+		const WaveState *pWaveState = *wave_iter;
+		if (pWaveState->m_WaveDefinition.Get() == pDefinition && pWaveState->m_EntityCount != 0)
 		{
-			float fractionalValue = 1.0f / static_cast<float>(wave_iter->m_Entities.GetSize());
-
-			for (Helium::DynamicArray< WaveEntityState >::Iterator entity_iter = wave_iter->m_Entities.Begin(); 
-				entity_iter != wave_iter->m_Entities.End(); ++entity_iter)
-			{
-				if (entity_iter->m_Entity)
-				{
-					returnValue += fractionalValue;
-				}
-			}
+			returnValue += static_cast<float>(pWaveState->m_AliveCount) / static_cast<float>(pWaveState->m_EntityCount);
 		}
 	}
 
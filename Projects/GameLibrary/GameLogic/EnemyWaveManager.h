@@ -3,6 +3,7 @@
 
 #include "Engine/Asset.h"
 #include "Framework/Action.h"
+#include "Framework/Entity.h"
 #include "Framework/Predicate.h"
 
 namespace GameLibrary
@@ -76,6 +77,7 @@ namespace GameLibrary
 		static void PopulateMetaType( Helium::Reflect::MetaStruct& comp );
 
 		virtual bool Evaluate( Helium::World &pWorld, Helium::ParameterSet *pParamSet ) override;
+		virtual uint32_t GetInputStamp( Helium::World &pWorld, Helium::ParameterSet *pParamSet ) override;
 
 		EnemyWaveDefinitionPtr m_WaveDefinition;
 		float m_FractionAlive;
@@ -85,26 +87,37 @@ namespace GameLibrary
 	class GAME_LIBRARY_API EnemyWaveManager
 	{
 	public:
+		EnemyWaveManager() : m_pWorld( NULL ), m_ChangeStamp( 0 ) { }
+		~EnemyWaveManager();
+
 		void Initialize(Helium::World *pWorld);
 		void Update(float dt);
 
 		void SpawnWave( EnemyWaveDefinition *pWave, ParameterSet_ActionSpawnEnemyWave *pParameters );
 		float GetPercentAlive( EnemyWaveDefinition *pDefinition );
 
-	private:
-		struct WaveEntityState
-		{
-			Helium::WeakPtr< Helium::Entity > m_Entity;
-		};
+		// Changes whenever a wave is spawned or the number of entities alive in a wave changes
+		uint32_t GetChangeStamp() const { return m_ChangeStamp; }
 
+	private:
+		// Waves count their living entities through each entity's destruction callback, so reading how much of a
+		// wave is alive never has to look at the entities themselves
 		struct WaveState
 		{
+			WaveState( EnemyWaveManager *pManager, EnemyWaveDefinition *pDefinition, uint32_t entityCount );
+
+			void OnEntityDestroyed( Helium::Entity *pEntity );
+
+			EnemyWaveManager *m_pManager;
 			EnemyWaveDefinitionPtr m_WaveDefinition;
-			Helium::DynamicArray< WaveEntityState > m_Entities;
+			Helium::DynamicArray< Helium::EntityWPtr > m_Entities; // Only used to detach the callbacks early
+			uint32_t m_EntityCount;
+			uint32_t m_AliveCount;
 		};
 
 		Helium::World *m_pWorld;
-		Helium::DynamicArray< WaveState > m_ActiveWaves;
+		Helium::DynamicArray< WaveState * > m_ActiveWaves;
+		uint32_t m_ChangeStamp;
 	};
 
 	//////////////////////////////////////////////////////////////////////////
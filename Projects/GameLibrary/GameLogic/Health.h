@@ -52,3 +52,6 @@ namespace GameLibrary
 		virtual void DefineContract(Helium::TaskContract &rContract);
 	};
 }
+
+HELIUM_COMPONENT_PREFAB_IMAGE( GameLibrary::HealthComponent )
+HELIUM_COMPONENT_SNAPSHOT( GameLibrary::HealthComponent )
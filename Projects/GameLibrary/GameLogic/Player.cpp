@@ -3,6 +3,7 @@
 #include "GameLibrary/GameLogic/Player.h"
 #include "Reflect/TranslatorDeduction.h"
 #include "Framework/World.h"
+#include "Components/TransformComponent.h"
 
 #include "GameLibrary/GameLogic/PlayerInput.h"
 
@@ -46,6 +47,12 @@ void PlayerComponent::Respawn()
 	{
 		m_Avatar = GetWorld()->GetRootSlice()->CreateEntity( m_Definition->m_AvatarEntity );
 		m_Avatar->Allocate<PlayerInputComponent>();
+
+		TransformComponent *pTransform = m_Avatar->GetFirst<TransformComponent>();
+		if ( pTransform )
+		{
+			pTransform->SetSpatialLayers( pTransform->GetSpatialLayers() | AVATAR_SPATIAL_LAYER );
+		}
 	}
 }
 
@@ -26,6 +26,9 @@ namespace GameLibrary
 	{
 		HELIUM_DECLARE_COMPONENT( GameLibrary::PlayerComponent, Helium::Component );
 		static void PopulateMetaType( Helium::Reflect::MetaStruct& comp );
+
+		// Spatial layer of avatar transforms, so proximity queries can look for players only
+		static const uint32_t AVATAR_SPATIAL_LAYER = 1 << 1;
 		
 		void Initialize( const PlayerComponentDefinition &definition);
 
@@ -38,28 +38,11 @@ void PlayerInputComponentDefinition::PopulateMetaType( Reflect::MetaStruct& comp
 
 void GatherInput( PlayerInputComponent *pPlayerInput )
 {
-	float x = 0.0f;
-	float y = 0.0f;
-
-	if ( Helium::Input::IsKeyDown(Input::KeyCodes::KC_LEFT) )
-	{
-		x -= 1.0f;
-	}
-	
-	if ( Helium::Input::IsKeyDown(Input::KeyCodes::KC_RIGHT) )
-	{
-		x += 1.0f;
-	}
-
-	if ( Helium::Input::IsKeyDown(Input::KeyCodes::KC_UP) )
-	{
-		y += 1.0f;
-	}
-
-	if ( Helium::Input::IsKeyDown(Input::KeyCodes::KC_DOWN) )
-	{
-		y -= 1.0f;
-	}
+	// With the input capture thread running, keys only held for part of the frame only move for that part
+	float x = Helium::Input::GetKeyHeldFractionThisFrame(Input::KeyCodes::KC_RIGHT) -
+		Helium::Input::GetKeyHeldFractionThisFrame(Input::KeyCodes::KC_LEFT);
+	float y = Helium::Input::GetKeyHeldFractionThisFrame(Input::KeyCodes::KC_UP) -
+		Helium::Input::GetKeyHeldFractionThisFrame(Input::KeyCodes::KC_DOWN);
 	
 	pPlayerInput->m_ScreenSpaceFocusPosition = Helium::Input::GetMousePosNormalized();
 
@@ -106,7 +89,8 @@ void GatherInput( PlayerInputComponent *pPlayerInput )
 		pGraphics->GetBufferedDrawer().DrawLineStrip(verts, 2);
 #endif
 
-		pPlayerInput->m_bFirePrimary = Helium::Input::IsMouseButtonDown( Helium::Input::MouseButtons::Left );
+		// Clicks shorter than a frame still count
+		pPlayerInput->m_bFirePrimary = Helium::Input::WasMouseButtonDownThisFrame( Helium::Input::MouseButtons::Left );
 		pPlayerInput->m_WorldSpaceFocusPosition = pointOnPlane;
 		pPlayerInput->m_bHasWorldSpaceFocus = true;
 	}
@@ -117,8 +101,11 @@ void GatherInput( PlayerInputComponent *pPlayerInput )
 		pPlayerInput->m_bHasWorldSpaceFocus = false;
 	}
 	
+	// Partial holds scale the move down, but diagonals still don't move faster than straight lines
 	pPlayerInput->m_MoveDir = Simd::Vector2(x, y);
+	float moveLength = Max( Abs( x ), Abs( y ) );
 	pPlayerInput->m_MoveDir.NormalizeOrZero();
+	pPlayerInput->m_MoveDir *= moveLength;
 
 }
 
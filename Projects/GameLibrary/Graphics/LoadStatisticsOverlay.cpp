@@ -0,0 +1,139 @@
+#include "Precompile.h"
+
+#include "GameLibrary/Graphics/LoadStatisticsOverlay.h"
+#include "Reflect/TranslatorDeduction.h"
+#include "Engine/LoadStatistics.h"
+#include "Framework/ComponentQuery.h"
+#include "Graphics/BufferedDrawer.h"
+#include "Graphics/Font.h"
+#include "Graphics/GraphicsManagerComponent.h"
+#include "Graphics/RenderResourceManager.h"
+#include "Framework/World.h"
+
+using namespace Helium;
+using namespace GameLibrary;
+
+//////////////////////////////////////////////////////////////////////////
+// LoadStatisticsOverlayComponent
+
+HELIUM_DEFINE_COMPONENT(GameLibrary::LoadStatisticsOverlayComponent, EXAMPLE_GAME_MAX_WORLDS);
+
+void LoadStatisticsOverlayComponent::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+
+}
+
+GameLibrary::LoadStatisticsOverlayComponent::LoadStatisticsOverlayComponent()
+{
+
+}
+
+void LoadStatisticsOverlayComponent::Initialize( const LoadStatisticsOverlayComponentDefinition &definition )
+{
+	m_Definition.Set( &definition );
+}
+
+void GameLibrary::LoadStatisticsOverlayComponent::Render( Helium::GraphicsManagerComponent &rGraphicsManager )
+{
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+	HELIUM_ASSERT( pRenderResourceManager );
+
+	Font* pFont = pRenderResourceManager->GetDebugFont( RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+	if ( !pFont )
+	{
+		return;
+	}
+
+	LoadStatistics::Update();
+
+	LoadStatistics::Stats stats;
+	LoadStatistics::GetStats( stats );
+
+	Helium::BufferedDrawer &rBufferedDrawer = rGraphicsManager.GetBufferedDrawer();
+
+	float width = static_cast<float>(rGraphicsManager.GetGraphicsScene()->GetSceneView(0)->GetViewportWidth());
+	float height = static_cast<float>(rGraphicsManager.GetGraphicsScene()->GetSceneView(0)->GetViewportHeight());
+
+	const int32_t x = static_cast<int32_t>( width * m_Definition->m_Position.GetX() );
+	const int32_t lineHeight = static_cast<int32_t>( pFont->GetHeightFloat() + 0.5f );
+	const Color textColor( 0xffffffff );
+	int32_t y = static_cast<int32_t>( height * m_Definition->m_Position.GetY() );
+
+	String text;
+	text.Format(
+		"Assets waiting: preload %" PRId64 ", link %" PRId64 ", precache %" PRId64 ", finalize %" PRId64,
+		stats.gauges[LoadStatistics::GAUGE_ASSETS_PRELOADING],
+		stats.gauges[LoadStatistics::GAUGE_ASSETS_LINKING],
+		stats.gauges[LoadStatistics::GAUGE_ASSETS_PRECACHING],
+		stats.gauges[LoadStatistics::GAUGE_ASSETS_FINALIZING] );
+	rBufferedDrawer.DrawScreenText( x, y, text, textColor, RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+	y += lineHeight;
+
+	text.Format(
+		"Asset loads: %" PRIu64 " begun, %" PRIu64 " completed, %.2f ms average",
+		stats.counters[LoadStatistics::COUNTER_ASSET_LOADS_BEGUN],
+		stats.counters[LoadStatistics::COUNTER_ASSET_LOADS_COMPLETED],
+		stats.averageAssetLoadMilliseconds );
+	rBufferedDrawer.DrawScreenText( x, y, text, textColor, RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+	y += lineHeight;
+
+	text.Format(
+		"Cache: %" PRIu64 " hits, %" PRIu64 " misses (%.0f%% hit recently), %" PRIu64 " prefetched",
+		stats.counters[LoadStatistics::COUNTER_CACHE_HITS],
+		stats.counters[LoadStatistics::COUNTER_CACHE_MISSES],
+		stats.cacheHitRatio * 100.0f,
+		stats.counters[LoadStatistics::COUNTER_PREFETCH_HITS] );
+	rBufferedDrawer.DrawScreenText( x, y, text, textColor, RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+	y += lineHeight;
+
+	text.Format(
+		"Reads: %" PRId64 " in flight (%" PRId64 " KiB), %.2f MiB/s, %.2f ms average",
+		stats.gauges[LoadStatistics::GAUGE_READS_IN_FLIGHT],
+		stats.gauges[LoadStatistics::GAUGE_READ_BYTES_IN_FLIGHT] / 1024,
+		stats.readBytesPerSecond / ( 1024.0f * 1024.0f ),
+		stats.averageReadMilliseconds );
+	rBufferedDrawer.DrawScreenText( x, y, text, textColor, RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+#endif
+}
+
+HELIUM_DEFINE_CLASS(GameLibrary::LoadStatisticsOverlayComponentDefinition);
+
+void GameLibrary::LoadStatisticsOverlayComponentDefinition::PopulateMetaType( Helium::Reflect::MetaStruct& comp )
+{
+	comp.AddField( &LoadStatisticsOverlayComponentDefinition::m_Position, "m_Position" );
+}
+
+GameLibrary::LoadStatisticsOverlayComponentDefinition::LoadStatisticsOverlayComponentDefinition()
+	: m_Position(0.02f, 0.1f)
+{
+
+}
+
+static GraphicsManagerComponent *g_pLoadStatisticsGraphicsManager;
+
+void DrawLoadStatisticsOverlay( LoadStatisticsOverlayComponent *pOverlayComponent )
+{
+	pOverlayComponent->Render( *g_pLoadStatisticsGraphicsManager );
+};
+
+void DrawLoadStatisticsOverlay( World *pWorld )
+{
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+	// Worlds without a graphics manager (such as headless worlds) have nothing to draw with.
+	g_pLoadStatisticsGraphicsManager = pWorld->GetComponents().GetFirst<GraphicsManagerComponent>();
+	if ( !g_pLoadStatisticsGraphicsManager )
+	{
+		return;
+	}
+
+	QueryComponents< LoadStatisticsOverlayComponent, DrawLoadStatisticsOverlay >( pWorld );
+#endif
+}
+
+HELIUM_DEFINE_TASK( DrawLoadStatisticsOverlayTask, (ForEachWorld< DrawLoadStatisticsOverlay >), TickTypes::Render )
+
+void GameLibrary::DrawLoadStatisticsOverlayTask::DefineContract( Helium::TaskContract &rContract )
+{
+	rContract.ExecutesWithin<Helium::StandardDependencies::Render>();
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Reflect/MetaStruct.h"
+#include "Engine/Asset.h"
+#include "Framework/ComponentDefinition.h"
+#include "Framework/TaskScheduler.h"
+#include "Framework/Entity.h"
+
+#include "Graphics/BufferedDrawer.h"
+#include "Graphics/GraphicsManagerComponent.h"
+
+namespace GameLibrary
+{
+	struct LoadStatisticsOverlayComponentDefinition;
+	
+	typedef Helium::StrongPtr<LoadStatisticsOverlayComponentDefinition> LoadStatisticsOverlayComponentDefinitionPtr;	
+	typedef Helium::StrongPtr<const LoadStatisticsOverlayComponentDefinition> ConstLoadStatisticsOverlayComponentDefinition;
+	
+	//////////////////////////////////////////////////////////////////////////
+	// LoadStatisticsOverlayComponent
+	//
+	// Draws the live asset loading and streaming statistics (see Helium::LoadStatistics) as screen text: load requests
+	// waiting in each stage, file reads and bytes in flight, cache hits and misses, and average load and read times.
+	// Add the component to a world definition to show the overlay in that world
+	class GAME_LIBRARY_API LoadStatisticsOverlayComponent : public Helium::Component
+	{
+	public:
+		HELIUM_DECLARE_COMPONENT( GameLibrary::LoadStatisticsOverlayComponent, Helium::Component );
+		static void PopulateMetaType( Helium::Reflect::MetaStruct& comp );
+
+		LoadStatisticsOverlayComponent();
+		
+		void Initialize( const LoadStatisticsOverlayComponentDefinition &definition);
+
+		void Render( Helium::GraphicsManagerComponent &rGraphicsManager );
+		
+	private:
+		ConstLoadStatisticsOverlayComponentDefinition m_Definition;
+	};
+	
+	struct GAME_LIBRARY_API LoadStatisticsOverlayComponentDefinition : public Helium::ComponentDefinitionHelper<LoadStatisticsOverlayComponent, LoadStatisticsOverlayComponentDefinition>
+	{
+		HELIUM_DECLARE_CLASS( GameLibrary::LoadStatisticsOverlayComponentDefinition, Helium::ComponentDefinition );
+		static void PopulateMetaType( Helium::Reflect::MetaStruct& comp );
+
+		LoadStatisticsOverlayComponentDefinition();
+	
+		// Position of the first line, as a fraction of the viewport size
+		Helium::Simd::Vector2 m_Position;
+	};
+
+	struct GAME_LIBRARY_API DrawLoadStatisticsOverlayTask : public Helium::TaskDefinition
+	{
+		HELIUM_DECLARE_TASK(DrawLoadStatisticsOverlayTask)
+
+		virtual void DefineContract(Helium::TaskContract &rContract);
+	};
+}
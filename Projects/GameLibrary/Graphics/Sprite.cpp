@@ -6,6 +6,10 @@
 #include "Graphics/BufferedDrawer.h"
 #include "Graphics/GraphicsManagerComponent.h"
 #include "Framework/World.h"
+#include "Engine/FrameArena.h"
+#include "EngineJobs/JobManager.h"
+
+#include <algorithm>
 
 using namespace Helium;
 using namespace GameLibrary;
@@ -41,32 +45,69 @@ void SpriteComponent::Initialize( const SpriteComponentDefinition &definition )
 	m_Scale = Simd::Vector3( definition.GetScale().GetX(), definition.GetScale().GetY(), 1.0f );
 	m_Rotation = definition.GetRotation();
 	m_Dirty = true;
+
+	definition.BuildUVTable();
+}
+
+void GameLibrary::SpriteComponent::UpdateUVCoordinates()
+{
+	m_Definition->GetUVCoordinates( m_Frame, m_UvTopLeft, m_UvBottomRight );
+
+	if ( m_FlipHorizontal )
+	{
+		float32_t x_temp = m_UvTopLeft.GetX();
+		m_UvTopLeft.SetX( m_UvBottomRight.GetX() );
+		m_UvBottomRight.SetX( x_temp );
+	}
+	
+	if ( m_FlipVertical )
+	{
+		Helium::Swap( m_UvTopLeft.GetElement(1), m_UvBottomRight.GetElement(1) );
+	}
+
+	m_Dirty = false;
 }
 
 void GameLibrary::SpriteComponent::Render( Helium::BufferedDrawer &rBufferedDrawer, Helium::TransformComponent &rTransform )
 {
-	if ( !m_Texture )
+	SimpleTexturedVertex vertices[ QUAD_VERTEX_COUNT ];
+	RTexture2d *pTexture = PrepareQuad( rTransform, vertices );
+	if ( !pTexture )
 	{
 		return;
 	}
 
-	if ( m_Dirty )
+	rBufferedDrawer.DrawTextured(
+		RENDERER_PRIMITIVE_TYPE_TRIANGLE_LIST,
+		Simd::Matrix44::IDENTITY,
+		vertices,
+		QUAD_VERTEX_COUNT,
+		GetQuadIndices(),
+		2,
+		pTexture,
+		Color( 0xffffffff ),
+		Helium::RenderResourceManager::RASTERIZER_STATE_DOUBLE_SIDED,
+		Helium::RenderResourceManager::DEPTH_STENCIL_STATE_TEST_ONLY);
+}
+
+Helium::RTexture2d *GameLibrary::SpriteComponent::PrepareQuad( const Helium::TransformComponent &rTransform, Helium::SimpleTexturedVertex *pVertices )
+{
+	HELIUM_ASSERT( pVertices );
+
+	if ( !m_Texture )
 	{
-		m_Definition->GetUVCoordinates( m_Frame, m_UvTopLeft, m_UvBottomRight );
+		return NULL;
+	}
 
-		if ( m_FlipHorizontal )
-		{
-			float32_t x_temp = m_UvTopLeft.GetX();
-			m_UvTopLeft.SetX( m_UvBottomRight.GetX() );
-			m_UvBottomRight.SetX( x_temp );
-		}
-		
-		if ( m_FlipVertical )
-		{
-			Helium::Swap( m_UvTopLeft.GetElement(1), m_UvBottomRight.GetElement(1) );
-		}
+	RTexture2d *pTexture = m_Texture->GetRenderResource2d();
+	if ( !pTexture )
+	{
+		return NULL;
+	}
 
-		m_Dirty = false;
+	if ( m_Dirty )
+	{
+		UpdateUVCoordinates();
 	}
 	
 	// Not really sure why I had to split this into two matrices but it works
@@ -82,11 +123,35 @@ void GameLibrary::SpriteComponent::Render( Helium::BufferedDrawer &rBufferedDraw
 	Helium::Simd::Matrix44 composite =
 		scaling * matrix;
 
-	rBufferedDrawer.DrawTexturedQuad(
-		m_Texture->GetRenderResource2d(),
-		composite,
-		m_UvTopLeft,
-		m_UvBottomRight);
+	// Same corners as BufferedDrawer::DrawTexturedQuad(), transformed here so that many sprites can share a draw call
+	pVertices[ 0 ] = SimpleTexturedVertex(
+		composite.TransformPoint( Simd::Vector3( -0.5f, 0.5f, 1.0f ) ),
+		Simd::Vector2( m_UvTopLeft.GetX(), m_UvBottomRight.GetY() ) );
+	pVertices[ 1 ] = SimpleTexturedVertex(
+		composite.TransformPoint( Simd::Vector3( 0.5f, 0.5f, 1.0f ) ),
+		m_UvBottomRight );
+	pVertices[ 2 ] = SimpleTexturedVertex(
+		composite.TransformPoint( Simd::Vector3( -0.5f, -0.5f, 1.0f ) ),
+		m_UvTopLeft );
+	pVertices[ 3 ] = SimpleTexturedVertex(
+		composite.TransformPoint( Simd::Vector3( 0.5f, -0.5f, 1.0f ) ),
+		Simd::Vector2( m_UvBottomRight.GetX(), m_UvTopLeft.GetY() ) );
+
+	return pTexture;
+}
+
+uint32_t GameLibrary::SpriteComponent::sm_MaxSpritesPerFrame = 0;
+
+void GameLibrary::SpriteComponent::SetMaxSpritesPerFrame( uint32_t maxSprites )
+{
+	sm_MaxSpritesPerFrame = maxSprites;
+}
+
+const uint16_t *GameLibrary::SpriteComponent::GetQuadIndices()
+{
+	// The two triangles of the strip drawn by BufferedDrawer::DrawTexturedQuad()
+	static const uint16_t indices[ QUAD_INDEX_COUNT ] = { 0, 1, 2, 2, 1, 3 };
+	return indices;
 }
 
 HELIUM_DEFINE_CLASS(GameLibrary::SpriteComponentDefinition);
@@ -120,6 +185,35 @@ Helium::Point GameLibrary::SpriteComponentDefinition::GetPixelCoordinates( uint3
 }
 
 void GameLibrary::SpriteComponentDefinition::GetUVCoordinates( uint32_t frame, Simd::Vector2 &topLeft, Simd::Vector2 &bottomRight ) const
+{
+	if ( frame < m_UVTable.GetSize() )
+	{
+		const UVRect &rRect = m_UVTable[ frame ];
+		topLeft = rRect.m_TopLeft;
+		bottomRight = rRect.m_BottomRight;
+		return;
+	}
+
+	ComputeUVCoordinates( frame, topLeft, bottomRight );
+}
+
+void GameLibrary::SpriteComponentDefinition::BuildUVTable() const
+{
+	if ( !m_UVTable.IsEmpty() || !m_Texture )
+	{
+		return;
+	}
+
+	const uint32_t frameCount = Max< uint32_t >( m_FrameCount, 1 );
+	m_UVTable.Resize( frameCount );
+	for ( uint32_t frame = 0; frame < frameCount; ++frame )
+	{
+		UVRect &rRect = m_UVTable[ frame ];
+		ComputeUVCoordinates( frame, rRect.m_TopLeft, rRect.m_BottomRight );
+	}
+}
+
+void GameLibrary::SpriteComponentDefinition::ComputeUVCoordinates( uint32_t frame, Simd::Vector2 &topLeft, Simd::Vector2 &bottomRight ) const
 {
 	Helium::Point topLeftPixel = GetPixelCoordinates(frame);
 
@@ -154,13 +248,70 @@ GameLibrary::SpriteComponentDefinition::SpriteComponentDefinition()
 
 }
 
-static BufferedDrawer *g_pBufferedDrawer;
-
-void DrawSprite( SpriteComponent *pShaderComponent, Helium::TransformComponent *pTransformComponent )
+namespace
 {
-	// TODO: Make this not use buffered drawer
-	pShaderComponent->Render( *g_pBufferedDrawer, *pTransformComponent );
-};
+	// Sprites prepared per job, and the most quads sent in one draw call (so indices fit in 16 bits)
+	const size_t SPRITES_PER_PREPARE_JOB = 256;
+	const size_t MAX_QUADS_PER_DRAW = 65536 / SpriteComponent::QUAD_VERTEX_COUNT;
+
+	struct SpriteEntry
+	{
+		SpriteComponent *m_pSprite;
+		TransformComponent *m_pTransform;
+		Texture2d *m_pSortTexture; // Texture asset the sprite draws with, used to group sprites before preparing them
+		RTexture2d *m_pTexture; // Set when prepared, NULL if the sprite has nothing to draw
+	};
+
+	// Orders sprites by texture so each texture is one run (and one draw call, up to MAX_QUADS_PER_DRAW), keeping
+	// the query order within a texture when used with a stable sort
+	struct SpriteTextureLess
+	{
+		bool operator()( const SpriteEntry &rLhs, const SpriteEntry &rRhs ) const
+		{
+			return std::less< const Texture2d * >()( rLhs.m_pSortTexture, rRhs.m_pSortTexture );
+		}
+	};
+
+	// A contiguous run of sprites, each writing its quad to its own slot of the shared vertex stream
+	struct SpritePrepareJob
+	{
+		SpriteEntry *m_pEntries;
+		SimpleTexturedVertex *m_pVertices;
+		size_t m_EntryCount;
+	};
+
+	DynamicArray< SpriteEntry, FrameAllocator > *g_pSpriteEntries;
+	size_t g_SkippedSpriteCount;
+
+	void GatherSprite( SpriteComponent *pSpriteComponent, Helium::TransformComponent *pTransformComponent )
+	{
+		const uint32_t maxSprites = SpriteComponent::GetMaxSpritesPerFrame();
+		if ( maxSprites && g_pSpriteEntries->GetSize() >= maxSprites )
+		{
+			++g_SkippedSpriteCount;
+			return;
+		}
+
+		SpriteEntry *pEntry = g_pSpriteEntries->New();
+		HELIUM_ASSERT( pEntry );
+		pEntry->m_pSprite = pSpriteComponent;
+		pEntry->m_pTransform = pTransformComponent;
+		pEntry->m_pSortTexture = pSpriteComponent->GetTexture();
+		pEntry->m_pTexture = NULL;
+	}
+
+	void RunSpritePrepareJob( void *pJob )
+	{
+		const SpritePrepareJob &rJob = *static_cast< const SpritePrepareJob * >( pJob );
+		for ( size_t entryIndex = 0; entryIndex < rJob.m_EntryCount; ++entryIndex )
+		{
+			SpriteEntry &rEntry = rJob.m_pEntries[ entryIndex ];
+			rEntry.m_pTexture = rEntry.m_pSprite->PrepareQuad(
+				*rEntry.m_pTransform,
+				rJob.m_pVertices + entryIndex * SpriteComponent::QUAD_VERTEX_COUNT );
+		}
+	}
+}
 
 void DrawSprites( World *pWorld )
 {
@@ -171,8 +322,119 @@ void DrawSprites( World *pWorld )
 	GraphicsManagerComponent *pGraphicsManager = pWorld->GetComponents().GetFirst<GraphicsManagerComponent>();
 	HELIUM_ASSERT( pGraphicsManager );
 
-	g_pBufferedDrawer = &pGraphicsManager->GetBufferedDrawer();
-	QueryComponents< SpriteComponent, TransformComponent, DrawSprite >( pWorld );
+	// Sprites are gathered up front so that preparing them can be split into jobs
+	DynamicArray< SpriteEntry, FrameAllocator > entries;
+	entries.Reserve( SpriteComponent::GetMaxSpritesPerFrame() );
+	g_pSpriteEntries = &entries;
+	g_SkippedSpriteCount = 0;
+	QueryComponents< SpriteComponent, TransformComponent, GatherSprite >( pWorld );
+	g_pSpriteEntries = NULL;
+
+	// Only reported when it changes, rather than every frame
+	static size_t lastSkippedSpriteCount = 0;
+	if ( g_SkippedSpriteCount != lastSkippedSpriteCount && g_SkippedSpriteCount )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"DrawSprites: Skipped %" PRIuSZ " sprites over the per-frame limit of %" PRIu32 ".\n",
+			g_SkippedSpriteCount,
+			SpriteComponent::GetMaxSpritesPerFrame() );
+	}
+	lastSkippedSpriteCount = g_SkippedSpriteCount;
+
+	const size_t spriteCount = entries.GetSize();
+	if ( !spriteCount )
+	{
+		return;
+	}
+
+	// Sprites sharing a texture (typically frames of one sheet) end up next to each other, so the number of draw calls
+	// follows the number of textures in use rather than how their sprites interleave in the query
+	std::stable_sort( entries.GetData(), entries.GetData() + spriteCount, SpriteTextureLess() );
+
+	// Quads are written straight into the drawer's vertex list, so they aren't copied again when drawn
+	BufferedDrawer &rBufferedDrawer = pGraphicsManager->GetBufferedDrawer();
+	uint32_t baseVertexIndex;
+	SimpleTexturedVertex *pVertices = rBufferedDrawer.AllocateTexturedVertices(
+		static_cast< uint32_t >( spriteCount * SpriteComponent::QUAD_VERTEX_COUNT ),
+		baseVertexIndex );
+	if ( !pVertices )
+	{
+		return;
+	}
+
+	JobManager *pJobManager = JobManager::GetInstance();
+	if ( !pJobManager || !pJobManager->GetWorkerCount() || spriteCount < 2 * SPRITES_PER_PREPARE_JOB )
+	{
+		SpritePrepareJob job = { entries.GetData(), pVertices, spriteCount };
+		RunSpritePrepareJob( &job );
+	}
+	else
+	{
+		DynamicArray< SpritePrepareJob, FrameAllocator > jobs;
+		jobs.Reserve( ( spriteCount + SPRITES_PER_PREPARE_JOB - 1 ) / SPRITES_PER_PREPARE_JOB );
+
+		JobCounter counter;
+		for ( size_t firstEntry = 0; firstEntry < spriteCount; firstEntry += SPRITES_PER_PREPARE_JOB )
+		{
+			SpritePrepareJob *pJob = jobs.New();
+			HELIUM_ASSERT( pJob );
+			pJob->m_pEntries = entries.GetData() + firstEntry;
+			pJob->m_pVertices = pVertices + firstEntry * SpriteComponent::QUAD_VERTEX_COUNT;
+			pJob->m_EntryCount = Min( SPRITES_PER_PREPARE_JOB, spriteCount - firstEntry );
+
+			pJobManager->Spawn( RunSpritePrepareJob, pJob, counter );
+		}
+
+		pJobManager->WaitForCounter( counter );
+	}
+
+	// Index pattern shared by every draw call, one quad after another
+	const size_t maxQuadsPerDraw = Min( spriteCount, MAX_QUADS_PER_DRAW );
+	DynamicArray< uint16_t, FrameAllocator > indices;
+	indices.Reserve( maxQuadsPerDraw * SpriteComponent::QUAD_INDEX_COUNT );
+	const uint16_t *pQuadIndices = SpriteComponent::GetQuadIndices();
+	for ( size_t quadIndex = 0; quadIndex < maxQuadsPerDraw; ++quadIndex )
+	{
+		const uint16_t baseVertex = static_cast< uint16_t >( quadIndex * SpriteComponent::QUAD_VERTEX_COUNT );
+		for ( size_t index = 0; index < SpriteComponent::QUAD_INDEX_COUNT; ++index )
+		{
+			indices.Push( static_cast< uint16_t >( baseVertex + pQuadIndices[ index ] ) );
+		}
+	}
+
+	// Runs of consecutive sprites with the same texture go out as a single draw call
+	size_t entryIndex = 0;
+	while ( entryIndex < spriteCount )
+	{
+		RTexture2d *pTexture = entries[ entryIndex ].m_pTexture;
+		if ( !pTexture )
+		{
+			++entryIndex;
+			continue;
+		}
+
+		size_t runEnd = entryIndex + 1;
+		while ( runEnd < spriteCount && runEnd - entryIndex < maxQuadsPerDraw && entries[ runEnd ].m_pTexture == pTexture )
+		{
+			++runEnd;
+		}
+
+		const uint32_t quadCount = static_cast< uint32_t >( runEnd - entryIndex );
+		rBufferedDrawer.DrawAllocatedTextured(
+			RENDERER_PRIMITIVE_TYPE_TRIANGLE_LIST,
+			Simd::Matrix44::IDENTITY,
+			baseVertexIndex + static_cast< uint32_t >( entryIndex * SpriteComponent::QUAD_VERTEX_COUNT ),
+			quadCount * SpriteComponent::QUAD_VERTEX_COUNT,
+			indices.GetData(),
+			quadCount * 2,
+			pTexture,
+			Color( 0xffffffff ),
+			Helium::RenderResourceManager::RASTERIZER_STATE_DOUBLE_SIDED,
+			Helium::RenderResourceManager::DEPTH_STENCIL_STATE_TEST_ONLY);
+
+		entryIndex = runEnd;
+	}
 #endif
 }
 
@@ -35,6 +35,23 @@ namespace GameLibrary
 
 		void Render( Helium::BufferedDrawer &rBufferedDrawer, Helium::TransformComponent &rTransform );
 
+		// Writes the sprite's quad in world space to the four vertices at pVertices (see GetQuadIndices() for the
+		// triangles) and returns the texture to draw it with, or NULL if there is nothing to draw. Only touches this
+		// sprite, so sprites can be prepared from several threads at once
+		Helium::RTexture2d *PrepareQuad( const Helium::TransformComponent &rTransform, Helium::SimpleTexturedVertex *pVertices );
+
+		// Triangle list indices of the quads written by PrepareQuad(), relative to the quad's first vertex
+		static const uint32_t QUAD_VERTEX_COUNT = 4;
+		static const uint32_t QUAD_INDEX_COUNT = 6;
+		static const uint16_t *GetQuadIndices();
+
+		// Most sprites DrawSpritesTask draws in one frame (0 for no limit); sprites past it are skipped for the frame.
+		// Also the number of sprites the per-frame arrays are sized for up front
+		static void SetMaxSpritesPerFrame( uint32_t maxSprites );
+		static uint32_t GetMaxSpritesPerFrame() { return sm_MaxSpritesPerFrame; }
+
+		Helium::Texture2d *GetTexture() const { return m_Texture; }
+
 		void SetFrame(uint32_t frame) { m_Frame = frame; m_Dirty = true;}
 		void SetFlipHorizontal( bool shouldFlip ) { m_FlipHorizontal = shouldFlip; m_Dirty = true; }
 		void SetFlipVertical( bool shouldFlip ) { m_FlipVertical = shouldFlip; m_Dirty = true; }
@@ -51,6 +68,10 @@ namespace GameLibrary
 		bool m_FlipHorizontal;
 		bool m_FlipVertical;
 		bool m_Dirty;
+
+		void UpdateUVCoordinates();
+
+		static uint32_t sm_MaxSpritesPerFrame;
 	};
 	
 	class GAME_LIBRARY_API SpriteComponentDefinition : public Helium::ComponentDefinitionHelper<SpriteComponent, SpriteComponentDefinition>
@@ -69,8 +90,20 @@ namespace GameLibrary
 
 		Helium::Point GetPixelCoordinates( uint32_t frame ) const;
 		void GetUVCoordinates(uint32_t frame, Helium::Simd::Vector2 &topLeft, Helium::Simd::Vector2 &bottomRight) const;
+
+		// Fills the UV table so GetUVCoordinates() is a lookup. Called when a sprite is initialized from this definition,
+		// since the texture size is only known once the texture has loaded
+		void BuildUVTable() const;
 	
 	private:
+		struct UVRect
+		{
+			Helium::Simd::Vector2 m_TopLeft;
+			Helium::Simd::Vector2 m_BottomRight;
+		};
+
+		void ComputeUVCoordinates(uint32_t frame, Helium::Simd::Vector2 &topLeft, Helium::Simd::Vector2 &bottomRight) const;
+
 		Helium::Simd::Vector2 m_Scale;
 		Helium::Texture2dPtr m_Texture;
 		Helium::Point m_TopLeftPixel;
@@ -78,6 +111,10 @@ namespace GameLibrary
 		float m_Rotation;
 		uint32_t m_FramesPerColumn;
 		uint32_t m_FrameCount;
+
+		// UVs of each frame, indexed by frame. Frames past the end (or all of them, before the table is built) are
+		// computed on demand
+		mutable Helium::DynamicArray< UVRect > m_UVTable;
 	};
 
 	struct GAME_LIBRARY_API DrawSpritesTask : public Helium::TaskDefinition
@@ -13,6 +13,17 @@
 /// Dev/Engine/Include/GraphicsTypes/VertexTypes.h).
 #define BONE_COUNT_MAX 75
 
+/// Clustered light grid dimensions and limits (must match the same constants in
+/// Source/Engine/Graphics/ClusteredLightGrid.h).
+#define CLUSTER_TILE_COUNT_X 16
+#define CLUSTER_TILE_COUNT_Y 8
+#define CLUSTER_DEPTH_SLICE_COUNT 24
+#define CLUSTER_LIGHT_COUNT_MAX 256
+#define CLUSTER_LIGHT_INDEX_TEXTURE_WIDTH 1024
+#define CLUSTER_LIGHT_INDEX_TEXTURE_HEIGHT 8
+/// Maximum number of index texels read for a single cluster (four light indices per texel).
+#define CLUSTER_LIGHT_INDEX_TEXEL_COUNT_MAX 8
+
 /// Per-view vertex shader constant data for all passes.
 struct ViewVertexConstantGlobalData
 {
@@ -50,6 +61,14 @@ struct ViewPixelConstantBasePassData
 
     /// Inverse shadow map resolution (z & w components are unused).
     float4 inverseShadowMapResolution;
+
+    /// Projection matrix terms contributing to clip-space x (_11, _31, _41; w component is unused).
+    float4 clusterProjectionX;
+    /// Projection matrix terms contributing to clip-space y (_22, _32, _42; w component is unused).
+    float4 clusterProjectionY;
+    /// x & y: Projection matrix terms contributing to clip-space w (_34, _44)
+    /// z & w: Clustered light depth slice scale and bias (applied to the base-2 logarithm of view-space depth)
+    float4 clusterProjectionWAndDepthSlice;
 };
 
 /// Per-instance vertex shader constant data for all passes.
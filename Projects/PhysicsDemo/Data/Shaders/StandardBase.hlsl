@@ -9,7 +9,9 @@
 //! @toggle_p NORMAL_MAP
 //! @select SPECULAR NONE SPECULAR_DIFFUSE_ALPHA SPECULAR_MAP
 //! @sysselect_v SKINNING NONE SKINNING_SMOOTH SKINNING_RIGID
+//! @sysselect_v INSTANCING NONE INSTANCING_TRANSFORM
 //! @sysselect SHADOWS NONE SHADOWS_SIMPLE SHADOWS_PCF_DITHERED
+//! @systoggle CLUSTERED_LIGHTS
 
 #include "Common.inl"
 
@@ -32,6 +34,13 @@ struct VertexOutput
 #if SHADOWS_PCF_DITHERED
     float3 screenPos          : TEXCOORD5;
 #endif
+
+#if CLUSTERED_LIGHTS
+    // View-space tangent frame, with the view-space position packed in the w components.
+    float4 viewTangent        : TEXCOORD6;
+    float4 viewBinormal       : TEXCOORD7;
+    float4 viewNormal         : TEXCOORD8;
+#endif
 };
 
 #if HELIUM_TYPE_VERTEX
@@ -50,6 +59,11 @@ struct VertexInput
     float4 color        : COLOR;
 #endif
     float4 texCoord0    : TEXCOORD0;
+#if INSTANCING
+    float4 instanceTransform0 : TEXCOORD4;
+    float4 instanceTransform1 : TEXCOORD5;
+    float4 instanceTransform2 : TEXCOORD6;
+#endif
 };
 
 cbuffer ViewGlobalData
@@ -92,6 +106,9 @@ float4 main( VertexInput vIn, out VertexOutput vOut ) : POSITION
 #endif
 
 	matrix worldMatrix = matrix( partialSkinningMatrix, float4( 0, 0, 0, 1 ) );
+#elif INSTANCING
+    float3x4 instanceTransform = float3x4( vIn.instanceTransform0, vIn.instanceTransform1, vIn.instanceTransform2 );
+    matrix worldMatrix = matrix( instanceTransform, float4( 0, 0, 0, 1 ) );
 #else
     matrix worldMatrix = matrix( InstanceGlobalData.transform, float4( 0, 0, 0, 1 ) );
 #endif
@@ -118,6 +135,13 @@ float4 main( VertexInput vIn, out VertexOutput vOut ) : POSITION
     vOut.toEye = half3( normalize( -mul( worldInvView, localPosition ).xyz ) );
 #endif
 
+#if CLUSTERED_LIGHTS
+    float3 viewPosition = mul( worldInvView, localPosition ).xyz;
+    vOut.viewTangent = float4( tangent, viewPosition.x );
+    vOut.viewBinormal = float4( binormal, viewPosition.y );
+    vOut.viewNormal = float4( normal, viewPosition.z );
+#endif
+
     matrix worldInvViewProjection = mul( ViewGlobalData.inverseViewProjection, worldMatrix );
     
     float4 outPosition = mul( worldInvViewProjection, localPosition );
@@ -179,6 +203,55 @@ sampler _ShadowMap = sampler_state
 #endif  // HELIUM_PROFILE_PC_SM4
 #endif  // SHADOWS
 
+#if CLUSTERED_LIGHTS
+// Clustered dynamic light data, light list of each cluster, and packed light indices (see ClusteredLightGrid).  Note
+// that these names must match the names returned by GraphicsScene::GetClusterLightsTextureName(),
+// GetClusterGridTextureName(), and GetClusterLightIndicesTextureName().
+#if HELIUM_PROFILE_PC_SM4
+Texture2D _ClusterLights;
+Texture2D _ClusterGrid;
+Texture2D _ClusterLightIndices;
+
+#define CLUSTER_TEXEL( tex, x, y, width, height ) tex.Load( int3( int( x ), int( y ), 0 ) )
+#else  // HELIUM_PROFILE_PC_SM4
+Texture2D _ClusterLightsTexture;
+sampler _ClusterLights = sampler_state
+{
+	Texture = <_ClusterLightsTexture>;
+	MipFilter = POINT;
+	MinFilter = POINT;
+	MagFilter = POINT;
+	AddressU = CLAMP;
+	AddressV = CLAMP;
+};
+
+Texture2D _ClusterGridTexture;
+sampler _ClusterGrid = sampler_state
+{
+	Texture = <_ClusterGridTexture>;
+	MipFilter = POINT;
+	MinFilter = POINT;
+	MagFilter = POINT;
+	AddressU = CLAMP;
+	AddressV = CLAMP;
+};
+
+Texture2D _ClusterLightIndicesTexture;
+sampler _ClusterLightIndices = sampler_state
+{
+	Texture = <_ClusterLightIndicesTexture>;
+	MipFilter = POINT;
+	MinFilter = POINT;
+	MagFilter = POINT;
+	AddressU = CLAMP;
+	AddressV = CLAMP;
+};
+
+#define CLUSTER_TEXEL( tex, x, y, width, height ) \
+	tex2Dlod( tex, float4( ( float2( x, y ) + 0.5 ) / float2( width, height ), 0, 0 ) )
+#endif  // HELIUM_PROFILE_PC_SM4
+#endif  // CLUSTERED_LIGHTS
+
 cbuffer ViewPassData
 {
     ViewPixelConstantBasePassData ViewPassData : register( c0 );
@@ -187,14 +260,46 @@ cbuffer ViewPassData
 cbuffer MaterialParameters
 {
 #if NORMAL_MAP
-    float NormalMapHeightScale : register( c4 );
+    float NormalMapHeightScale : register( c7 );
 #endif
 
 #if SPECULAR
-    float SpecularExponent : register( c5 );
+    float SpecularExponent : register( c8 );
 #endif
 }
 
+#if CLUSTERED_LIGHTS
+/// Add the contribution of a clustered dynamic light.
+///
+/// @param[in]    lightIndex    Index of the light in the light data texture.
+/// @param[in]    viewPosition  View-space position being shaded.
+/// @param[in]    viewNormal    View-space surface normal.
+/// @param[in]    toEye         Normalized view-space direction from the position being shaded to the eye.
+/// @param[inout] diffuse       Diffuse lighting to which to add.
+/// @param[inout] specular      Specular lighting to which to add.
+void ApplyClusterLight(
+    float lightIndex, float3 viewPosition, float3 viewNormal, float3 toEye,
+    inout float3 diffuse, inout float3 specular )
+{
+    float4 positionAndInvRadius = CLUSTER_TEXEL( _ClusterLights, lightIndex, 0, CLUSTER_LIGHT_COUNT_MAX, 3 );
+    float4 colorAndSpotScale = CLUSTER_TEXEL( _ClusterLights, lightIndex, 1, CLUSTER_LIGHT_COUNT_MAX, 3 );
+    float4 directionAndSpotOffset = CLUSTER_TEXEL( _ClusterLights, lightIndex, 2, CLUSTER_LIGHT_COUNT_MAX, 3 );
+
+    float3 toLight = positionAndInvRadius.xyz - viewPosition;
+    float lightDistance = length( toLight );
+    toLight /= max( lightDistance, 0.0001 );
+
+    float falloff = saturate( 1 - lightDistance * lightDistance * positionAndInvRadius.w * positionAndInvRadius.w );
+    float spot = saturate( dot( -toLight, directionAndSpotOffset.xyz ) * colorAndSpotScale.w + directionAndSpotOffset.w );
+    float3 lightColor = colorAndSpotScale.rgb * ( falloff * falloff * spot * spot );
+
+    diffuse += lightColor * saturate( dot( viewNormal, toLight ) );
+#if SPECULAR
+    specular += lightColor * pow( saturate( dot( toEye, reflect( -toLight, viewNormal ) ) ), SpecularExponent );
+#endif
+}
+#endif  // CLUSTERED_LIGHTS
+
 #if SHADOWS_PCF_DITHERED
 static const float4 PCF_BASE_KERNEL[] =
 {
@@ -271,6 +376,69 @@ float4 main( VertexOutput vOut ) : SV_Target
     half3 directionalLightColor = half3( ViewPassData.directionalLightColor.rgb );
     diffuse += directionalLightColor * half( saturate( dot( normal, toDirectionalLight ) ) ) * shadow;
 
+#if CLUSTERED_LIGHTS
+    float3 viewPosition = float3( vOut.viewTangent.w, vOut.viewBinormal.w, vOut.viewNormal.w );
+    float3 viewNormal = normalize(
+        normal.x * vOut.viewTangent.xyz + normal.y * vOut.viewBinormal.xyz + normal.z * vOut.viewNormal.xyz );
+    float3 viewToEye = normalize( -viewPosition );
+
+    // Locate the cluster containing the position being shaded.
+    float4 projectionWAndDepthSlice = ViewPassData.clusterProjectionWAndDepthSlice;
+    float clipW = viewPosition.z * projectionWAndDepthSlice.x + projectionWAndDepthSlice.y;
+    float2 clipXY = float2(
+        dot( float3( viewPosition.xz, 1 ), ViewPassData.clusterProjectionX.xyz ),
+        dot( float3( viewPosition.yz, 1 ), ViewPassData.clusterProjectionY.xyz ) );
+    float2 tile = clamp(
+        floor( ( clipXY / clipW * 0.5 + 0.5 ) * float2( CLUSTER_TILE_COUNT_X, CLUSTER_TILE_COUNT_Y ) ),
+        0,
+        float2( CLUSTER_TILE_COUNT_X - 1, CLUSTER_TILE_COUNT_Y - 1 ) );
+    float slice = clamp(
+        floor( log2( max( viewPosition.z, 0.01 ) ) * projectionWAndDepthSlice.z + projectionWAndDepthSlice.w ),
+        0,
+        CLUSTER_DEPTH_SLICE_COUNT - 1 );
+
+    float4 cluster = CLUSTER_TEXEL(
+        _ClusterGrid,
+        tile.y * CLUSTER_TILE_COUNT_X + tile.x,
+        slice,
+        CLUSTER_TILE_COUNT_X * CLUSTER_TILE_COUNT_Y,
+        CLUSTER_DEPTH_SLICE_COUNT );
+    float clusterLightCount = cluster.y;
+
+    float3 clusterDiffuse = float3( 0, 0, 0 );
+    float3 clusterSpecular = float3( 0, 0, 0 );
+
+    [loop]
+    for( int texelIndex = 0; texelIndex < CLUSTER_LIGHT_INDEX_TEXEL_COUNT_MAX; ++texelIndex )
+    {
+        float listStart = texelIndex * 4;
+        if( listStart >= clusterLightCount )
+        {
+            break;
+        }
+
+        float texel = cluster.x + texelIndex;
+        float4 lightIndices = CLUSTER_TEXEL(
+            _ClusterLightIndices,
+            fmod( texel, CLUSTER_LIGHT_INDEX_TEXTURE_WIDTH ),
+            floor( texel / CLUSTER_LIGHT_INDEX_TEXTURE_WIDTH ),
+            CLUSTER_LIGHT_INDEX_TEXTURE_WIDTH,
+            CLUSTER_LIGHT_INDEX_TEXTURE_HEIGHT );
+
+        [unroll]
+        for( int component = 0; component < 4; ++component )
+        {
+            if( listStart + component < clusterLightCount )
+            {
+                ApplyClusterLight(
+                    lightIndices[ component ], viewPosition, viewNormal, viewToEye, clusterDiffuse, clusterSpecular );
+            }
+        }
+    }
+
+    diffuse += half3( clusterDiffuse );
+#endif
+
     color.rgb += diffuse * diffuseSample.rgb;
 
 #if SPECULAR
@@ -288,6 +456,9 @@ float4 main( VertexOutput vOut ) : SV_Target
         half( pow( saturate( dot( toEye, reflect( toDirectionalLight, normal ) ) ), specularExponent ) );
 
     half3 specular = directionalLightColor * directionalSpecularAtten * shadow;
+#if CLUSTERED_LIGHTS
+    specular += half3( clusterSpecular );
+#endif
 
     color.rgb += specular * specularSample;
 #endif
@@ -7,6 +7,7 @@
 
 //! @sysselect TEXTURING NONE TEXTURING_BLEND TEXTURING_ALPHA
 //! @systoggle_v POINT_SPRITE
+//! @sysselect_v INSTANCING NONE INSTANCING_TRANSFORM
 
 #include "Common.inl"
 
@@ -27,8 +28,14 @@ struct VertexInput
 #if TEXTURING
     float2 texCoord : TEXCOORD0;
 #endif
+#if INSTANCING
+    float4 instanceTransform0 : TEXCOORD4;
+    float4 instanceTransform1 : TEXCOORD5;
+    float4 instanceTransform2 : TEXCOORD6;
+#endif
 };
 
+// When instancing, the world transform comes from the instance data and this only holds the inverse view/projection.
 cbuffer InstanceData
 {
     matrix WorldInverseViewProjection : register( c0 );
@@ -53,7 +60,14 @@ void main(
     vPointSize = 5.0f;
 #endif
 
-    vPos = mul( WorldInverseViewProjection, vIn.position );
+#if INSTANCING
+    float3x4 instanceTransform = float3x4( vIn.instanceTransform0, vIn.instanceTransform1, vIn.instanceTransform2 );
+    float4 position = float4( mul( instanceTransform, vIn.position ), 1.0f );
+#else
+    float4 position = vIn.position;
+#endif
+
+    vPos = mul( WorldInverseViewProjection, position );
 }
 
 #endif  // HELIUM_TYPE_VERTEX
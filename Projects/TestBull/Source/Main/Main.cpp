@@ -9,6 +9,8 @@
 #include "Engine/FileLocations.h"
 #include "Framework/SceneDefinition.h"
 #include "Framework/WorldManager.h"
+#include "Framework/Benchmark.h"
+#include "FrameworkImpl/NullRendererInitializationImpl.h"
 
 #include "Rendering/Renderer.h"
 #include "Windowing/Window.h"
@@ -54,6 +56,21 @@ int main( int argc, const char* argv[] )
 
 	int32_t result = 0;
 
+	// Check for a benchmark run, a run without a renderer, or a headless (dedicated server) run, and for hitch capture
+	// settings.
+	BenchmarkParameters benchmarkParameters;
+	HeadlessParameters headlessParameters;
+	HitchCaptureParameters hitchCaptureParameters;
+#if HELIUM_OS_WIN
+	Benchmark::ParseCommandLine( __argc, __argv, benchmarkParameters );
+	GameSystem::ParseHeadlessCommandLine( __argc, __argv, headlessParameters );
+	HitchCapture::ParseCommandLine( __argc, __argv, hitchCaptureParameters );
+#else
+	Benchmark::ParseCommandLine( argc, argv, benchmarkParameters );
+	GameSystem::ParseHeadlessCommandLine( argc, argv, headlessParameters );
+	HitchCapture::ParseCommandLine( argc, argv, hitchCaptureParameters );
+#endif
+
 	{
 		// Initialize a GameSystem instance.
 		MemoryHeapPreInitializationImpl memoryHeapPreInitialization;
@@ -65,6 +82,10 @@ int main( int argc, const char* argv[] )
 		WindowManagerInitializationImpl windowManagerInitialization;
 #endif
 		RendererInitializationImpl rendererInitialization;
+		NullRendererInitializationImpl nullRendererInitialization;
+		RendererInitialization& rRendererInitialization = ( benchmarkParameters.bNullRenderer
+			? static_cast< RendererInitialization& >( nullRendererInitialization )
+			: static_cast< RendererInitialization& >( rendererInitialization ) );
 		AssetPath systemDefinitionPath( "/System:System" );
 
 		FilePath base ( __FILE__ );
@@ -74,18 +95,30 @@ int main( int argc, const char* argv[] )
 		base.Set( fullPath );
 		FileLocations::SetBaseDirectory( base );
 
+		// Create the benchmark before loading any scene, so that scene setup uses its random seed.
+		Benchmark benchmark( benchmarkParameters );
+
 		GameSystem::Startup();
 		GameSystem* pGameSystem = GameSystem::GetInstance();
 		HELIUM_ASSERT( pGameSystem );
+		pGameSystem->SetHeadlessParameters( headlessParameters );
+		pGameSystem->SetHitchCaptureParameters( hitchCaptureParameters );
 		bool bSystemInitSuccess = pGameSystem->Initialize(
 			memoryHeapPreInitialization,
 			assetLoaderInitialization,
 			configInitialization,
 			windowManagerInitialization,
-			rendererInitialization,
+			rRendererInitialization,
 			systemDefinitionPath);
-		
-		if( bSystemInitSuccess )
+
+		// Load benchmarks only time loading the asset given on the command line, so the scene and loop are skipped.
+		bool bLoadBenchmark = bSystemInitSuccess && benchmark.IsLoadBenchmark();
+		if( bLoadBenchmark )
+		{
+			result = ( benchmark.RunLoad() ? 0 : 1 );
+		}
+
+		if( bSystemInitSuccess && !bLoadBenchmark )
 		{
 			World *pWorld = NULL; 
 
@@ -105,14 +138,36 @@ int main( int argc, const char* argv[] )
 
 			if ( pWorld )
 			{
-				Window::NativeHandle windowHandle = rendererInitialization.GetMainWindow()->GetNativeHandle();
-				Input::Initialize(windowHandle, false);
-				Input::SetWindowSize( 
-					rendererInitialization.GetMainWindow()->GetWidth(),
-					rendererInitialization.GetMainWindow()->GetHeight());
-
-				// Run the application.
-				result = pGameSystem->Run();
+				// Runs without a renderer have no window to take input from, so they play back scripted input instead.
+				// Headless runs only tick gameplay, so they take no input at all.
+				bool bScriptedInput = ( !headlessParameters.bEnabled &&
+					( benchmarkParameters.bNullRenderer || !benchmarkParameters.inputScriptPath.IsEmpty() ) );
+				if( bScriptedInput )
+				{
+					if( !Input::BeginScriptedInput( *benchmarkParameters.inputScriptPath ) )
+					{
+						result = 1;
+					}
+				}
+				else if( !headlessParameters.bEnabled )
+				{
+					Window::NativeHandle windowHandle = rendererInitialization.GetMainWindow()->GetNativeHandle();
+					Input::Initialize(windowHandle, false);
+					Input::SetWindowSize( 
+						rendererInitialization.GetMainWindow()->GetWidth(),
+						rendererInitialization.GetMainWindow()->GetHeight());
+				}
+
+				if( result == 0 )
+				{
+					// Run the application.
+					result = ( benchmarkParameters.bEnabled ? pGameSystem->RunBenchmark( benchmark ) : pGameSystem->Run() );
+				}
+
+				if( bScriptedInput )
+				{
+					Input::EndScriptedInput();
+				}
 			}
 		}
 
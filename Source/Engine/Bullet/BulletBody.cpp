@@ -4,33 +4,11 @@
 #include "Bullet/BulletBodyDefinition.h"
 #include "Bullet/BulletShapes.h"
 #include "Bullet/BulletWorld.h"
+#include "Bullet/BulletMotionState.h"
+#include "Components/TransformComponent.h"
 
 using namespace Helium;
 
-namespace Helium
-{
-	struct BulletMotionState : public btMotionState
-	{
-		BulletMotionState(const btTransform &worldTrans)
-			: m_Transform(worldTrans)
-		{
-
-		}
-
-		virtual void getWorldTransform( btTransform& worldTrans ) const
-		{
-			worldTrans = m_Transform;
-		}
-
-		virtual void setWorldTransform( const btTransform& worldTrans ) 
-		{
-			m_Transform = worldTrans;
-		}
-
-		btTransform m_Transform;
-	};
-}
-
 Helium::BulletBody::BulletBody()
 	: m_Body(0),
 	  m_MotionState(0)
@@ -48,7 +26,7 @@ Helium::BulletBody::~BulletBody()
 	HELIUM_ASSERT(!m_Body);
 }
 
-void BulletBody::Initialize( BulletWorld &rWorld, const BulletBodyDefinition &rBodyDefinition, const Helium::Simd::Vector3 &rInitialPosition, const Helium::Simd::Quat &rInitialRotation )
+void BulletBody::Initialize( BulletWorld &rWorld, const BulletBodyDefinition &rBodyDefinition, const Helium::Simd::Vector3 &rInitialPosition, const Helium::Simd::Quat &rInitialRotation, uint16_t collisionFilterGroup, uint16_t collisionFilterMask )
 {
 	HELIUM_ASSERT(rWorld.GetBulletWorld());
 
@@ -59,51 +37,11 @@ void BulletBody::Initialize( BulletWorld &rWorld, const BulletBodyDefinition &rB
 		return;
 	}
 
-	btCollisionShape *pFinalShape = 0;
+	// Identical bodies share their shapes through the world's cache
 	btVector3 finalInertia;
 	float finalMass;
-
-	if (rBodyDefinition.m_Shapes.GetSize() > 1 || rBodyDefinition.m_Shapes[0]->m_Position.GetMagnitudeSquared() > HELIUM_EPSILON)
-	{
-		btCompoundShape *pCompoundShape = new btCompoundShape( true );
-
-		float mass = 0.0f;
-		for (size_t i = 0; i < rBodyDefinition.m_Shapes.GetSize(); ++i)
-		{
-			btVector3 position;
-			btQuaternion rotation;
-
-			ConvertToBullet( rBodyDefinition.m_Shapes[i]->m_Position, position );
-			ConvertToBullet( rBodyDefinition.m_Shapes[i]->m_Rotation, rotation );
-
-			btCollisionShape *pBulletShape = rBodyDefinition.m_Shapes[i]->CreateShape();
-			pCompoundShape->addChildShape(
-				btTransform(rotation, position), 
-				pBulletShape);
-
-			mass += rBodyDefinition.m_Shapes[i]->m_Mass;
-		}
-
-		if (mass != 0.0f)
-		{
-			pCompoundShape->calculateLocalInertia(mass, finalInertia);
-		}
-		pFinalShape = pCompoundShape;
-		finalMass = mass;
-	}
-	else
-	{
-		BulletShape *pShape = rBodyDefinition.m_Shapes[0];
-		btCollisionShape *pBulletShape = pShape->CreateShape();
-		
-		if (pShape->m_Mass != 0.0f)
-		{
-			pBulletShape->calculateLocalInertia(pShape->m_Mass, finalInertia);
-		}
-
-		pFinalShape = pBulletShape;
-		finalMass = pShape->m_Mass;
-	}
+	btCollisionShape *pFinalShape = rWorld.GetShapeCache().Acquire( rBodyDefinition, 1.0f, finalMass, finalInertia );
+	HELIUM_ASSERT( pFinalShape );
 
 	btVector3 origin;
 	ConvertToBullet(rInitialPosition, origin);
@@ -122,6 +60,7 @@ void BulletBody::Initialize( BulletWorld &rWorld, const BulletBodyDefinition &rB
 	}
 	
 	m_MotionState = new BulletMotionState(startTransform);
+	m_MotionState->m_pAsyncWorld = rWorld.IsAsync() ? &rWorld : NULL;
 	m_Body = new btRigidBody(finalMass, m_MotionState, pFinalShape, finalInertia);
 	m_Body->setRestitution(rBodyDefinition.m_Restitution);
 	
@@ -149,7 +88,8 @@ void BulletBody::Initialize( BulletWorld &rWorld, const BulletBodyDefinition &rB
 		m_Body->setCollisionFlags( m_Body->getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE );
 	}
 	
-	rWorld.GetBulletWorld()->addRigidBody(m_Body);
+	// All 16 bits set reads back as -1 (bullet's AllFilter) whether bullet stores the filter as short or int
+	rWorld.GetBulletWorld()->addRigidBody(m_Body, static_cast<short>(collisionFilterGroup), static_cast<short>(collisionFilterMask));
 }
 
 void Helium::BulletBody::GetPosition( Helium::Simd::Vector3 &rPosition )
@@ -190,19 +130,35 @@ void Helium::BulletBody::SetRotation( const Helium::Simd::Quat &rRotation )
 	m_Body->activate();
 }
 
+void Helium::BulletBody::SetTransform( const btTransform &rTransform )
+{
+	HELIUM_ASSERT(m_MotionState);
+
+	m_MotionState->m_Transform = rTransform;
+	m_Body->activate();
+}
+
+void Helium::BulletBody::BindTransform( TransformComponent *pTransform )
+{
+	HELIUM_ASSERT(m_MotionState);
+
+	m_MotionState->m_TransformComponent = pTransform;
+}
+
+TransformComponent *Helium::BulletBody::GetBoundTransform()
+{
+	return m_MotionState ? m_MotionState->m_TransformComponent.Get() : NULL;
+}
+
 void Helium::BulletBody::Destruct( BulletWorld &rWorld )
 {
+	rWorld.ForgetMotionState(m_MotionState);
 	delete m_MotionState;
 
+	// Shapes belong to the world's shape cache
 	rWorld.GetBulletWorld()->removeCollisionObject(m_Body);
 	delete m_Body;
 
-	for (DynamicArray<btCollisionShape *>::Iterator shape = m_Shapes.Begin();
-		shape != m_Shapes.End(); ++shape)
-	{
-		delete *shape;
-	}
-
 #if HELIUM_ASSERT_ENABLED
 	// Clear m_Body so that the assert will succeed
 	m_Body = NULL;
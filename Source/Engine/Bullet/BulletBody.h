@@ -13,11 +13,13 @@ class btSequentialImpulseConstraintSolver;
 class btDiscreteDynamicsWorld;
 class btCollisionShape;
 class btRigidBody;
+class btTransform;
 struct btDefaultMotionState;
 
 namespace Helium
 {
 	class BulletWorld;
+	class TransformComponent;
 	struct BulletBodyDefinition;
 	struct BulletMotionState;
 
@@ -32,11 +34,15 @@ namespace Helium
 		bool HasBody() { return m_Body != NULL; }
 		btRigidBody *GetBody() { return m_Body; }
 
+		// The collision filter group and mask are handed to bullet's broadphase, which only pairs two bodies if each
+		// body's group overlaps the other's mask
 		void Initialize( 
 			BulletWorld &rWorld,
 			const BulletBodyDefinition &rBodyDefinition, 
 			const Helium::Simd::Vector3 &rInitialPosition, 
-			const Helium::Simd::Quat &rInitialRotation );
+			const Helium::Simd::Quat &rInitialRotation,
+			uint16_t collisionFilterGroup = 0xFFFF,
+			uint16_t collisionFilterMask = 0xFFFF );
 
 		void Destruct(BulletWorld &rWorld);
 
@@ -45,9 +51,13 @@ namespace Helium
 
 		void SetPosition(const Helium::Simd::Vector3 &rPosition);
 		void SetRotation(const Helium::Simd::Quat &rRotation);
+		void SetTransform(const btTransform &rTransform);
+
+		// Once bound, bullet writes the body's motion straight into the transform, and only while the body is active
+		void BindTransform(TransformComponent *pTransform);
+		TransformComponent *GetBoundTransform();
 		
 	private:
-		DynamicArray<btCollisionShape *> m_Shapes;
 		btRigidBody *m_Body;
 		BulletMotionState *m_MotionState;
 	};
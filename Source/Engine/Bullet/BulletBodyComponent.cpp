@@ -7,6 +7,8 @@
 #include "Bullet/BulletWorldComponent.h"
 #include "Framework/ComponentQuery.h"
 #include "Framework/World.h"
+#include "MathSimd/Matrix44Soa.h"
+#include "MathSimd/QuatSoa.h"
 
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 
@@ -93,11 +95,20 @@ void BulletBodyComponent::Finalize( const BulletBodyComponentDefinition &definit
 	TransformComponent *pTransform = GetComponentCollection()->GetFirst<TransformComponent>();
 	HELIUM_ASSERT( pTransform );
 
+	// Bodies can't be added while the world is stepping
+	pBulletWorldComponent->CompleteSimulation();
+
+	// Ungrouped bodies get every group bit so that they still collide with anything that does not exclude them all
+	const uint16_t assignedGroups = static_cast<uint16_t>( definition.m_AssignedGroups );
+	const BulletSystemComponent *pBulletSystem = BulletSystemComponent::GetInstance();
+
 	m_Body.Initialize(
 		*pBulletWorldComponent->GetBulletWorld(), 
 		definition.m_BodyDefinition, 
 		pTransform ? pTransform->GetPosition() : Simd::Vector3::Zero, 
-		pTransform ? pTransform->GetRotation() : Simd::Quat::IDENTITY);
+		pTransform ? pTransform->GetRotation() : Simd::Quat::IDENTITY,
+		assignedGroups ? assignedGroups : 0xFFFF,
+		pBulletSystem ? pBulletSystem->GetCollisionMask( assignedGroups ) : 0xFFFF);
 
 	btVector3 velocity;
 	ConvertToBullet(definition.m_InitialVelocity, velocity);
@@ -106,6 +117,16 @@ void BulletBodyComponent::Finalize( const BulletBodyComponentDefinition &definit
 
 	m_AssignedGroups = definition.m_AssignedGroups;
 	m_TrackPhysicalContactGroupMask = definition.m_TrackPhysicalContactGroupMask;
+
+	if (m_Body.HasBody())
+	{
+		m_Body.BindTransform(pTransform);
+
+		if (m_Body.GetBody()->isKinematicObject())
+		{
+			pBulletWorldComponent->AddKinematicBody(this);
+		}
+	}
 }
 
 BulletBodyComponent::~BulletBodyComponent()
@@ -114,17 +135,36 @@ BulletBodyComponent::~BulletBodyComponent()
 	{
 		BulletWorldComponent *pBulletWorldComponent = GetWorld()->GetComponents().GetFirst<BulletWorldComponent>();
 
+		// Nor removed
+		pBulletWorldComponent->CompleteSimulation();
+		pBulletWorldComponent->ForgetBodyCommands(m_Body.GetBody());
+
+		if (m_Body.GetBody()->isKinematicObject())
+		{
+			pBulletWorldComponent->RemoveKinematicBody(this);
+		}
+
 		m_Body.Destruct( *pBulletWorldComponent->GetBulletWorld() );
 	}
 }
 
 void BulletBodyComponent::WakeUp()
 {
+	if (GetWorld()->GetComponents().GetFirst<BulletWorldComponent>()->LatchBodyCommand(m_Body.GetBody(), BulletBodyCommand::WAKE_UP))
+	{
+		return;
+	}
+
 	m_Body.GetBody()->activate();
 }
 
 void BulletBodyComponent::ApplyForce( const Simd::Vector3 &force )
 {
+	if (GetWorld()->GetComponents().GetFirst<BulletWorldComponent>()->LatchBodyCommand(m_Body.GetBody(), BulletBodyCommand::APPLY_FORCE, force))
+	{
+		return;
+	}
+
 	btVector3 bulletForce;
 	ConvertToBullet(force, bulletForce);
 	m_Body.GetBody()->activate();
@@ -133,6 +173,11 @@ void BulletBodyComponent::ApplyForce( const Simd::Vector3 &force )
 
 void BulletBodyComponent::SetVelocity( const Simd::Vector3 &velocity )
 {
+	if (GetWorld()->GetComponents().GetFirst<BulletWorldComponent>()->LatchBodyCommand(m_Body.GetBody(), BulletBodyCommand::SET_VELOCITY, velocity))
+	{
+		return;
+	}
+
 	btVector3 bulletVelocity;
 	ConvertToBullet(velocity, bulletVelocity);
 	m_Body.GetBody()->activate();
@@ -141,6 +186,11 @@ void BulletBodyComponent::SetVelocity( const Simd::Vector3 &velocity )
 
 void BulletBodyComponent::SetAngularVelocity( const Simd::Vector3 &velocity )
 {
+	if (GetWorld()->GetComponents().GetFirst<BulletWorldComponent>()->LatchBodyCommand(m_Body.GetBody(), BulletBodyCommand::SET_ANGULAR_VELOCITY, velocity))
+	{
+		return;
+	}
+
 	btVector3 bulletVelocity;
 	ConvertToBullet(velocity, bulletVelocity);
 	m_Body.GetBody()->activate();
@@ -149,42 +199,68 @@ void BulletBodyComponent::SetAngularVelocity( const Simd::Vector3 &velocity )
 
 //////////////////////////////////////////////////////////////////////////
 
-void DoPreProcessPhysics( BulletBodyComponent *pBodyComponent, Helium::TransformComponent *pTransformComponent )
+// Kinematic transforms are converted to bullet one SIMD register of bodies at a time
+static const size_t KINEMATIC_BATCH_SIZE = 4;
+
+void DoPreProcessPhysics( BulletWorldComponent *pWorldComponent )
 {
-	if (pBodyComponent->GetBody().GetBody()->isKinematicObject())
+	// The steps spawned last frame must be done before kinematic bodies move
+	pWorldComponent->CompleteSimulation();
+
+	const DynamicArray< BulletBodyComponent * > &rKinematicBodies = pWorldComponent->GetKinematicBodies();
+
+	HELIUM_SIMD_ALIGN_PRE float32_t rotation[ 4 ][ KINEMATIC_BATCH_SIZE ] HELIUM_SIMD_ALIGN_POST;
+	HELIUM_SIMD_ALIGN_PRE float32_t basis[ 3 ][ 3 ][ KINEMATIC_BATCH_SIZE ] HELIUM_SIMD_ALIGN_POST;
+
+	for ( size_t firstIndex = 0; firstIndex < rKinematicBodies.GetSize(); firstIndex += KINEMATIC_BATCH_SIZE )
 	{
-		pBodyComponent->GetBody().SetPosition(pTransformComponent->GetPosition());
-		pBodyComponent->GetBody().SetRotation(pTransformComponent->GetRotation());
-	}
-};
+		const size_t count = Min( KINEMATIC_BATCH_SIZE, rKinematicBodies.GetSize() - firstIndex );
+		BulletBodyComponent * const *ppBodies = rKinematicBodies.GetData() + firstIndex;
 
-HELIUM_DEFINE_TASK( PreProcessPhysics, (ForEachWorld< QueryComponents< BulletBodyComponent, TransformComponent, DoPreProcessPhysics > >), TickTypes::Gameplay )
+		// Lanes past the end of a partial batch repeat the first body and are never written back
+		for ( size_t lane = 0; lane < KINEMATIC_BATCH_SIZE; ++lane )
+		{
+			const Simd::Quat &rRotation = ppBodies[ lane < count ? lane : 0 ]->GetBody().GetBoundTransform()->GetRotation();
+			rotation[ 0 ][ lane ] = rRotation.GetElement( 0 );
+			rotation[ 1 ][ lane ] = rRotation.GetElement( 1 );
+			rotation[ 2 ][ lane ] = rRotation.GetElement( 2 );
+			rotation[ 3 ][ lane ] = rRotation.GetElement( 3 );
+		}
 
-void PreProcessPhysics::DefineContract( Helium::TaskContract &rContract )
-{
-	rContract.ExecutesWithin<Helium::StandardDependencies::ProcessPhysics>();
-	rContract.ExecuteBefore<Helium::ProcessPhysics>();
-}
+		Simd::QuatSoa rotationSoa;
+		rotationSoa.Load( rotation[ 0 ], rotation[ 1 ], rotation[ 2 ], rotation[ 3 ] );
 
-//////////////////////////////////////////////////////////////////////////
+		Simd::Matrix44Soa rotationMatrixSoa( Simd::Matrix44Soa::INIT_ROTATION, rotationSoa );
+		for ( size_t row = 0; row < 3; ++row )
+		{
+			for ( size_t column = 0; column < 3; ++column )
+			{
+				Simd::StoreAligned( basis[ row ][ column ], rotationMatrixSoa.m_matrix[ row ][ column ] );
+			}
+		}
 
-void DoPostProcessPhysics( BulletBodyComponent *pBodyComponent, Helium::TransformComponent *pTransformComponent )
-{
-	Simd::Vector3 position;
-	Simd::Quat rotation;
+		for ( size_t lane = 0; lane < count; ++lane )
+		{
+			BulletBody &rBody = ppBodies[ lane ]->GetBody();
+
+			btVector3 origin;
+			ConvertToBullet( rBody.GetBoundTransform()->GetPosition(), origin );
 
-	// TODO: This extra copy is lame, either make a mutable Get on transform component or refactor motion state to talk straight to transform component
-	pBodyComponent->GetBody().GetPosition(position);
-	pTransformComponent->SetPosition(position);
+			// Helium matrices transform row vectors and bullet's transform column vectors, so the basis is transposed
+			btMatrix3x3 bulletBasis(
+				basis[ 0 ][ 0 ][ lane ], basis[ 1 ][ 0 ][ lane ], basis[ 2 ][ 0 ][ lane ],
+				basis[ 0 ][ 1 ][ lane ], basis[ 1 ][ 1 ][ lane ], basis[ 2 ][ 1 ][ lane ],
+				basis[ 0 ][ 2 ][ lane ], basis[ 1 ][ 2 ][ lane ], basis[ 2 ][ 2 ][ lane ] );
 
-	pBodyComponent->GetBody().GetRotation(rotation);
-	pTransformComponent->SetRotation(rotation);
+			rBody.SetTransform( btTransform( bulletBasis, origin ) );
+		}
+	}
 };
 
-HELIUM_DEFINE_TASK( PostProcessPhysics, (ForEachWorld< QueryComponents< BulletBodyComponent, TransformComponent, DoPostProcessPhysics > >), TickTypes::Gameplay )
+HELIUM_DEFINE_TASK( PreProcessPhysics, (ForEachWorld< QueryComponents< BulletWorldComponent, DoPreProcessPhysics > >), TickTypes::Gameplay )
 
-void PostProcessPhysics::DefineContract( Helium::TaskContract &rContract )
+void PreProcessPhysics::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecutesWithin<Helium::StandardDependencies::ProcessPhysics>();
-	rContract.ExecuteAfter<Helium::ProcessPhysics>();
+	rContract.ExecuteBefore<Helium::ProcessPhysics>();
 }
@@ -35,6 +35,7 @@ namespace Helium
 		inline bool                          GetShouldTrackPhysicalContact( BulletBodyComponent *pOther );
 
 		BulletBody &GetBody() { return m_Body; }
+		uint16_t GetAssignedGroups() const { return m_AssignedGroups; }
 
 		enum
 		{
@@ -74,6 +75,7 @@ namespace Helium
 	};
 	typedef StrongPtr<BulletBodyComponentDefinition> BulletBodyComponentDefinitionPtr;
 
+	// Pushes every kinematic body's transform to bullet
 	struct HELIUM_BULLET_API PreProcessPhysics : public Helium::TaskDefinition
 	{
 		HELIUM_DECLARE_TASK(PreProcessPhysics)
@@ -81,12 +83,10 @@ namespace Helium
 		virtual void DefineContract(Helium::TaskContract &rContract);
 	};
 
-	struct HELIUM_BULLET_API PostProcessPhysics : public Helium::TaskDefinition
-	{
-		HELIUM_DECLARE_TASK(PostProcessPhysics)
-
-		virtual void DefineContract(Helium::TaskContract &rContract);
-	};
+	// Dynamic bodies need no task of their own after ProcessPhysics: bullet writes active bodies straight into their
+	// transforms through the motion state while it simulates
 }
 
+HELIUM_CACHE_COMPONENT_SLOT( Helium::BulletBodyComponent, 3 )
+
 #include "BulletBodyComponent.inl"
@@ -7,6 +7,7 @@
 #include "Rendering/Renderer.h"
 
 #include "Graphics/BufferedDrawer.h"
+#include "Graphics/GraphicsScene.h"
 #include "Graphics/GraphicsManagerComponent.h"
 #include "Rendering/RVertexBuffer.h"
 
@@ -16,12 +17,46 @@
 
 #define POINTS_IN_SPHERE (288)
 
+// Debug geometry farther than this from the active view is not drawn
+#define DEBUG_DRAW_DISTANCE (200.0f)
+
 using namespace Helium;
 
-BulletDebugDrawer::BulletDebugDrawer( BufferedDrawer &pBufferedDrawer, int debugMode ) 
-	: m_DebugMode( debugMode )
-	, m_pDrawer( pBufferedDrawer )
+namespace
+{
+	uint32_t PackColor( const btVector3& color )
+	{
+		uint8_t bytes[ 4 ];
+		bytes[0] = static_cast<uint8_t>(color.x() * 255.0);
+		bytes[1] = static_cast<uint8_t>(color.y() * 255.0);
+		bytes[2] = static_cast<uint8_t>(color.z() * 255.0);
+		bytes[3] = 0xFF;
+
+		uint32_t packed;
+		MemoryCopy( &packed, bytes, sizeof( packed ) );
+		return packed;
+	}
+}
+
+BulletDebugDrawer::BulletDebugDrawer( int debugMode ) 
+	: m_pDrawer( NULL )
+	, m_pRecorder( NULL )
+	, m_DebugMode( debugMode )
+	, m_MaxDistance( 0.0f )
 {
+	m_ViewOrigin[0] = 0.0f;
+	m_ViewOrigin[1] = 0.0f;
+	m_ViewOrigin[2] = 0.0f;
+
+	m_LineFromX.Reserve( LINE_CAPACITY );
+	m_LineFromY.Reserve( LINE_CAPACITY );
+	m_LineFromZ.Reserve( LINE_CAPACITY );
+	m_LineToX.Reserve( LINE_CAPACITY );
+	m_LineToY.Reserve( LINE_CAPACITY );
+	m_LineToZ.Reserve( LINE_CAPACITY );
+	m_LineColors.Reserve( LINE_CAPACITY );
+	m_LineVertices.Reserve( LINE_CAPACITY * 2 );
+
 	m_Sphere.Reserve(POINTS_IN_SPHERE);
 
 	int32_t dphi = 180 / 8;
@@ -105,42 +140,107 @@ BulletDebugDrawer::BulletDebugDrawer( BufferedDrawer &pBufferedDrawer, int debug
 
 }
 
+void BulletDebugDrawer::BeginDraw( BufferedDrawer &rDrawer, const Simd::Vector3 &rViewOrigin, float32_t maxDistance )
+{
+	HELIUM_ASSERT( !m_pDrawer );
+	HELIUM_ASSERT( m_LineColors.IsEmpty() );
+
+	m_pDrawer = &rDrawer;
+	m_pRecorder = rDrawer.AcquireRecorder();
+	m_ViewOrigin[0] = rViewOrigin.GetElement( 0 );
+	m_ViewOrigin[1] = rViewOrigin.GetElement( 1 );
+	m_ViewOrigin[2] = rViewOrigin.GetElement( 2 );
+	m_MaxDistance = maxDistance;
+}
+
+void BulletDebugDrawer::EndDraw()
+{
+	HELIUM_ASSERT( m_pDrawer );
+
+	size_t lineCount = m_LineColors.GetSize();
+	if ( lineCount != 0 )
+	{
+		m_LineVertices.Resize( lineCount * 2 );
+		SimpleVertex *pVertex = m_LineVertices.GetData();
+
+		for ( size_t lineIndex = 0; lineIndex < lineCount; ++lineIndex )
+		{
+			pVertex[0].position[0] = m_LineFromX[ lineIndex ];
+			pVertex[0].position[1] = m_LineFromY[ lineIndex ];
+			pVertex[0].position[2] = m_LineFromZ[ lineIndex ];
+			MemoryCopy( pVertex[0].color, &m_LineColors[ lineIndex ], sizeof( pVertex[0].color ) );
+
+			pVertex[1].position[0] = m_LineToX[ lineIndex ];
+			pVertex[1].position[1] = m_LineToY[ lineIndex ];
+			pVertex[1].position[2] = m_LineToZ[ lineIndex ];
+			MemoryCopy( pVertex[1].color, &m_LineColors[ lineIndex ], sizeof( pVertex[1].color ) );
+
+			pVertex += 2;
+		}
+
+		m_pRecorder->DrawLineList( m_LineVertices.GetData(), static_cast<uint32_t>( lineCount * 2 ) );
+	}
+
+	// Keep the capacity for the next step
+	m_LineFromX.Resize( 0 );
+	m_LineFromY.Resize( 0 );
+	m_LineFromZ.Resize( 0 );
+	m_LineToX.Resize( 0 );
+	m_LineToY.Resize( 0 );
+	m_LineToZ.Resize( 0 );
+	m_LineColors.Resize( 0 );
+	m_LineVertices.Resize( 0 );
+
+	m_pDrawer = NULL;
+	m_pRecorder = NULL;
+}
+
+bool BulletDebugDrawer::IsBeyondViewDistance( const btVector3& center, btScalar radius ) const
+{
+	if ( m_MaxDistance <= 0.0f )
+	{
+		return false;
+	}
+
+	float32_t dx = static_cast<float32_t>( center.x() ) - m_ViewOrigin[0];
+	float32_t dy = static_cast<float32_t>( center.y() ) - m_ViewOrigin[1];
+	float32_t dz = static_cast<float32_t>( center.z() ) - m_ViewOrigin[2];
+	float32_t limit = m_MaxDistance + static_cast<float32_t>( radius );
+
+	return ( dx * dx + dy * dy + dz * dz > limit * limit );
+}
+
 void BulletDebugDrawer::drawLine( const btVector3& from, const btVector3& to, const btVector3& color )
 {
-	SimpleVertex v[2];
-
-	v[0].position[0] = from.x();
-	v[0].position[1] = from.y();
-	v[0].position[2] = from.z();
-	v[0].color[0] = static_cast<uint8_t>(color.x() * 255.0);
-	v[0].color[1] = static_cast<uint8_t>(color.y() * 255.0);
-	v[0].color[2] = static_cast<uint8_t>(color.z() * 255.0);
-
-	v[1].position[0] = to.x();
-	v[1].position[1] = to.y();
-	v[1].position[2] = to.z();
-	v[1].color[0] = v[0].color[0];
-	v[1].color[1] = v[0].color[1];
-	v[1].color[2] = v[0].color[2];
-
-	m_pDrawer.DrawLineList( v, 2 );
+	if ( IsBeyondViewDistance( ( from + to ) * btScalar( 0.5 ), ( to - from ).length() * btScalar( 0.5 ) ) )
+	{
+		return;
+	}
+
+	m_LineFromX.Push( static_cast<float32_t>( from.x() ) );
+	m_LineFromY.Push( static_cast<float32_t>( from.y() ) );
+	m_LineFromZ.Push( static_cast<float32_t>( from.z() ) );
+	m_LineToX.Push( static_cast<float32_t>( to.x() ) );
+	m_LineToY.Push( static_cast<float32_t>( to.y() ) );
+	m_LineToZ.Push( static_cast<float32_t>( to.z() ) );
+	m_LineColors.Push( PackColor( color ) );
 }
 
 void BulletDebugDrawer::drawSphere(btScalar radius, const btTransform& transform, const btVector3& color)
 {
-	uint8_t vColor[ 4 ];
+	HELIUM_ASSERT( m_pDrawer );
 
-	vColor[0] = static_cast<uint8_t>(color.x() * 255.0);
-	vColor[1] = static_cast<uint8_t>(color.y() * 255.0);
-	vColor[2] = static_cast<uint8_t>(color.z() * 255.0);
-	vColor[3] = 0xFF;
+	if ( IsBeyondViewDistance( transform.getOrigin(), radius ) )
+	{
+		return;
+	}
 
 	Simd::Matrix44 scaling(Simd::Matrix44::INIT_SCALING, radius);
 	Simd::Matrix44 rotateTranslate;
 
 	ConvertFromBullet( transform, rotateTranslate );
 	
-	m_pDrawer.DrawLineList(
+	m_pDrawer->DrawLineList(
 		scaling * rotateTranslate,
 		m_pSphereVertexBuffer.Get(), 
 		0,
@@ -150,15 +250,21 @@ void BulletDebugDrawer::drawSphere(btScalar radius, const btTransform& transform
 
 void BulletDebugDrawer::drawContactPoint( const btVector3& PointOnB, const btVector3& normalOnB, btScalar distance, int lifeTime, const btVector3& color )
 {
+	HELIUM_ASSERT( m_pDrawer );
+
+	if ( !( m_DebugMode & DBG_DrawContactPoints ) || IsBeyondViewDistance( PointOnB, btScalar( 0.0 ) ) )
+	{
+		return;
+	}
+
 	SimpleVertex v;
 	v.position[0] = PointOnB.x();
 	v.position[1] = PointOnB.y();
 	v.position[2] = PointOnB.z();
-	v.color[0] = static_cast<uint8_t>(color.x() * 255.0);
-	v.color[1] = static_cast<uint8_t>(color.y() * 255.0);
-	v.color[2] = static_cast<uint8_t>(color.z() * 255.0);
+	uint32_t packedColor = PackColor( color );
+	MemoryCopy( v.color, &packedColor, sizeof( v.color ) );
 
-	m_pDrawer.DrawPoints( &v, 1 );
+	m_pRecorder->DrawPoints( &v, 1 );
 
 	btVector3 normal_end = PointOnB + normalOnB * distance;
 
@@ -176,7 +282,8 @@ void BulletDebugDrawer::reportErrorWarning( const char* warningString )
 void BulletDebugDrawer::draw3dText( const btVector3& location,const char* textString )
 {
 	Simd::Matrix44 transform(Simd::Matrix44::INIT_TRANSLATION, Simd::Vector3(location.getX(), location.getY(), location.getZ()));
-	m_pDrawer.DrawWorldText(transform, String(textString));
+	HELIUM_ASSERT( m_pDrawer );
+	m_pDrawer->DrawWorldText(transform, String(textString));
 }
 
 void BulletDebugDrawer::setDebugMode( int debugMode )
@@ -201,10 +308,30 @@ void DoDrawDebugPhysics( World *pWorld )
 		btDynamicsWorld *pBulletWorld = pWorldC->GetBulletWorld()->GetBulletWorld();
 
 #if GRAPHICS_SCENE_BUFFERED_DRAWER
-		BulletDebugDrawer bdd( pGraphicsC->GetBufferedDrawer(),  btIDebugDraw::DBG_DrawWireframe /* | btIDebugDraw::DBG_DrawContactPoints */ );
-		pBulletWorld->setDebugDrawer( &bdd );
+		BulletDebugDrawer *pDebugDrawer = pWorldC->GetDebugDrawer();
+		if ( pDebugDrawer->getDebugMode() == btIDebugDraw::DBG_NoDebug )
+		{
+			return;
+		}
+
+		// Drawing reads every body, so it can't overlap with asynchronous steps
+		pWorldC->CompleteSimulation();
+
+		// Lines far from the active view aren't worth the vertices
+		Simd::Vector3 viewOrigin( 0.0f );
+		float32_t maxDistance = 0.0f;
+		GraphicsScene *pGraphicsScene = pGraphicsC->GetGraphicsScene();
+		if ( pGraphicsScene && IsValid( pGraphicsScene->GetActiveSceneViewId() ) )
+		{
+			viewOrigin = pGraphicsScene->GetSceneView( pGraphicsScene->GetActiveSceneViewId() )->GetOrigin();
+			maxDistance = DEBUG_DRAW_DISTANCE;
+		}
+
+		pDebugDrawer->BeginDraw( pGraphicsC->GetBufferedDrawer(), viewOrigin, maxDistance );
+		pBulletWorld->setDebugDrawer( pDebugDrawer );
 		pBulletWorld->debugDrawWorld();
 		pBulletWorld->setDebugDrawer( NULL );
+		pDebugDrawer->EndDraw();
 #endif
 	}
 };
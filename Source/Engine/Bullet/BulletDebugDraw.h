@@ -3,20 +3,32 @@
 #include "Framework/TaskScheduler.h"
 #include "Rendering/RRenderResource.h"
 #include "GraphicsTypes/VertexTypes.h"
+#include "MathSimd/Vector3.h"
+#include "Graphics/BufferedDrawer.h"
 
 // It is advised that you DO NOT include this file from anything but Bullet .cpp files. There's no need
 // for any other system to use this class
 
 namespace Helium
 {
-	class BufferedDrawer;
 	class RVertexBuffer;
 	HELIUM_DECLARE_RPTR( RVertexBuffer );
 
+	// Lines from bullet are collected into a structure-of-arrays buffer that keeps its capacity from step to step, and
+	// are handed to a BufferedDrawer::Recorder with a single DrawLineList() in EndDraw(), so drawing doesn't have to be
+	// serialized with other tasks recording into the same drawer. Lines entirely beyond the view distance are dropped
+	// as they come in
 	class BulletDebugDrawer : public btIDebugDraw
 	{
 	public:
-		BulletDebugDrawer( BufferedDrawer &pBufferedDrawer, int debugMode );
+		// Number of lines the buffer is sized for up front
+		static const size_t LINE_CAPACITY = 16384;
+
+		BulletDebugDrawer( int debugMode );
+
+		// maxDistance <= 0 disables distance filtering
+		void BeginDraw( BufferedDrawer &rDrawer, const Simd::Vector3 &rViewOrigin, float32_t maxDistance );
+		void EndDraw();
 
 		virtual void drawLine( const btVector3& from, const btVector3& to, const btVector3& color );
 		virtual void drawSphere(btScalar radius, const btTransform& transform, const btVector3& color);
@@ -27,10 +39,28 @@ namespace Helium
 		virtual int getDebugMode() const;
 
 	private:
-		BufferedDrawer &m_pDrawer;
+		bool IsBeyondViewDistance( const btVector3& center, btScalar radius ) const;
+
+		BufferedDrawer *m_pDrawer;
+		BufferedDrawer::Recorder *m_pRecorder;
 		RVertexBufferPtr m_pSphereVertexBuffer;
 		int m_DebugMode;
 
+		float32_t m_ViewOrigin[ 3 ];
+		float32_t m_MaxDistance;
+
+		// Line buffer, one entry per line
+		DynamicArray<float32_t> m_LineFromX;
+		DynamicArray<float32_t> m_LineFromY;
+		DynamicArray<float32_t> m_LineFromZ;
+		DynamicArray<float32_t> m_LineToX;
+		DynamicArray<float32_t> m_LineToY;
+		DynamicArray<float32_t> m_LineToZ;
+		DynamicArray<uint32_t> m_LineColors;
+
+		// Vertices built from the line buffer when it is flushed
+		DynamicArray<SimpleVertex> m_LineVertices;
+
 		DynamicArray<SimpleVertex> m_Sphere;
 	};
 
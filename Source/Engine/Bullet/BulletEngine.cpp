@@ -8,12 +8,99 @@
 
 using namespace Helium;
 
+HELIUM_DEFINE_BASE_STRUCT( Helium::BulletBodyGroupCollisions );
+
+void BulletBodyGroupCollisions::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+	comp.AddField( &BulletBodyGroupCollisions::m_Group, "m_Group" );
+	comp.AddField( &BulletBodyGroupCollisions::m_CollidesWithGroups, "m_CollidesWithGroups" );
+}
+
+bool BulletBodyGroupCollisions::operator==( const BulletBodyGroupCollisions& _rhs ) const
+{
+	return ( 
+		m_Group == _rhs.m_Group &&
+		m_CollidesWithGroups == _rhs.m_CollidesWithGroups
+		);
+}
+
+bool BulletBodyGroupCollisions::operator!=( const BulletBodyGroupCollisions& _rhs ) const
+{
+	return !( *this == _rhs );
+}
+
 HELIUM_IMPLEMENT_ASSET( Helium::BulletSystemComponent, Bullet, 0 )
 
 void Helium::BulletSystemComponent::Initialize()
 {
 	ms_Instance = this;
 	HELIUM_ASSERT( !m_BodyFlags || m_BodyFlags->GetFlagCount() < BulletBodyComponent::MAX_BULLET_BODY_FLAGS );
+
+	// Groups collide with everything until a rule says otherwise. Several rules for the same group add up
+	uint16_t groupsWithRules = 0;
+	m_GroupCollisionMasks.Resize( 0 );
+	m_GroupCollisionMasks.Add( 0xFFFF, BulletBodyComponent::MAX_BULLET_BODY_FLAGS );
+
+	if ( !m_BodyFlags )
+	{
+		if ( !m_BodyGroupCollisions.IsEmpty() )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"BulletSystemComponent::Initialize - m_BodyGroupCollisions is set, but no flags are defined in m_BodyFlags\n" );
+		}
+
+		return;
+	}
+
+	for ( DynamicArray< BulletBodyGroupCollisions >::ConstIterator iter = m_BodyGroupCollisions.Begin();
+		iter != m_BodyGroupCollisions.End(); ++iter )
+	{
+		uint16_t group = 0;
+		if ( !m_BodyFlags->GetFlag( iter->m_Group, group ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"BulletSystemComponent::Initialize - m_BodyGroupCollisions refers to group '%s', which is not defined in '%s'\n",
+				*iter->m_Group,
+				*m_BodyFlags->GetPath().ToString() );
+
+			continue;
+		}
+
+		uint16_t collidesWith = 0;
+		m_BodyFlags->GetBitset( iter->m_CollidesWithGroups, collidesWith );
+
+		for ( size_t bit = 0; bit < BulletBodyComponent::MAX_BULLET_BODY_FLAGS; ++bit )
+		{
+			const uint16_t groupBit = static_cast< uint16_t >( 1 << bit );
+			if ( group & groupBit )
+			{
+				m_GroupCollisionMasks[ bit ] = ( groupsWithRules & groupBit ) ? ( m_GroupCollisionMasks[ bit ] | collidesWith ) : collidesWith;
+				groupsWithRules |= groupBit;
+			}
+		}
+	}
+}
+
+uint16_t Helium::BulletSystemComponent::GetCollisionMask( uint16_t assignedGroups ) const
+{
+	if ( !assignedGroups || m_GroupCollisionMasks.IsEmpty() )
+	{
+		return 0xFFFF;
+	}
+
+	// A body in several groups collides with whatever any of its groups collides with
+	uint16_t mask = 0;
+	for ( size_t bit = 0; bit < BulletBodyComponent::MAX_BULLET_BODY_FLAGS; ++bit )
+	{
+		if ( assignedGroups & ( 1 << bit ) )
+		{
+			mask |= m_GroupCollisionMasks[ bit ];
+		}
+	}
+
+	return mask;
 }
 
 void Helium::BulletSystemComponent::Cleanup()
@@ -28,6 +115,7 @@ void Helium::BulletSystemComponent::Destroy()
 void BulletSystemComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 {
 	comp.AddField( &BulletSystemComponent::m_BodyFlags, "m_BodyFlags" );
+	comp.AddField( &BulletSystemComponent::m_BodyGroupCollisions, "m_BodyGroupCollisions" );
 }
 
 BulletSystemComponent *BulletSystemComponent::ms_Instance = NULL;
\ No newline at end of file
@@ -7,6 +7,20 @@
 
 namespace Helium
 {
+	// Lists the body groups that bodies assigned to a group may collide with. A pair of bodies is rejected in the
+	// broadphase, before bullet generates any contacts for it, if either body's groups exclude the other's
+	struct HELIUM_BULLET_API BulletBodyGroupCollisions : public Reflect::Struct
+	{
+		HELIUM_DECLARE_BASE_STRUCT( Helium::BulletBodyGroupCollisions );
+		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+		Name m_Group;
+		DynamicArray< Name > m_CollidesWithGroups;
+
+		bool operator==( const BulletBodyGroupCollisions& _rhs ) const;
+		bool operator!=( const BulletBodyGroupCollisions& _rhs ) const;
+	};
+
 	class HELIUM_BULLET_API BulletSystemComponent : public SystemComponent
 	{
 		HELIUM_DECLARE_ASSET( BulletSystemComponent, SystemComponent )
@@ -21,8 +35,17 @@ namespace Helium
 			return ms_Instance;
 		}
 
+		// Bullet collision filter mask for a body assigned to the given groups. Groups without an entry in
+		// m_BodyGroupCollisions, and bodies with no groups at all, collide with everything
+		uint16_t GetCollisionMask( uint16_t assignedGroups ) const;
+
 	public:
 		FlagSetDefinitionPtr m_BodyFlags;
+		DynamicArray< BulletBodyGroupCollisions > m_BodyGroupCollisions;
 		static BulletSystemComponent *ms_Instance;
+
+	private:
+		// Resolved from m_BodyGroupCollisions on initialize, indexed by group bit
+		DynamicArray< uint16_t > m_GroupCollisionMasks;
 	};
 }
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Bullet/Bullet.h"
+#include "Bullet/BulletUtilities.h"
+#include "Bullet/BulletWorld.h"
+#include "Components/TransformComponent.h"
+
+#include "LinearMath/btMotionState.h"
+#include "LinearMath/btTransform.h"
+
+namespace Helium
+{
+	struct BulletMotionState : public btMotionState
+	{
+		BulletMotionState(const btTransform &worldTrans)
+			: m_Transform(worldTrans)
+			, m_PreviousTransform(worldTrans)
+			, m_pAsyncWorld(NULL)
+			, m_StepStamp(0)
+			, m_MovedIndex(Invalid< size_t >())
+		{
+
+		}
+
+		virtual void getWorldTransform( btTransform& worldTrans ) const
+		{
+			worldTrans = m_Transform;
+		}
+
+		// Bullet only calls this for active, non-kinematic bodies when it synchronizes motion states
+		virtual void setWorldTransform( const btTransform& worldTrans )
+		{
+			if ( m_pAsyncWorld )
+			{
+				// Simulating on a worker, so the transform can't be touched here. The world blends the poses of the
+				// last two steps into it once the step has completed
+				m_PreviousTransform = m_Transform;
+				m_Transform = worldTrans;
+				m_pAsyncWorld->NoteMoved( this );
+				return;
+			}
+
+			m_Transform = worldTrans;
+
+			TransformComponent *pTransform = m_TransformComponent.Get();
+			if ( pTransform )
+			{
+				ConvertFromBullet( worldTrans.getOrigin(), pTransform->ModifyPosition() );
+				ConvertFromBullet( worldTrans.getRotation(), pTransform->ModifyRotation() );
+			}
+		}
+
+		// Pose after the latest step, and after the step before it
+		btTransform m_Transform;
+		btTransform m_PreviousTransform;
+
+		TransformComponentPtr m_TransformComponent;
+
+		// Set if the body lives in a world that simulates asynchronously
+		BulletWorld *m_pAsyncWorld;
+		// Batch of steps that last moved this body, and its index in the world's list of moving bodies
+		uint32_t m_StepStamp;
+		size_t m_MovedIndex;
+	};
+}
@@ -0,0 +1,289 @@
+#include "Precompile.h"
+#include "Bullet/BulletSceneQuery.h"
+#include "Bullet/BulletBodyComponent.h"
+#include "Bullet/BulletUtilities.h"
+#include "EngineJobs/JobManager.h"
+
+#include "BulletCollision/CollisionDispatch/btCollisionWorld.h"
+#include "BulletCollision/CollisionShapes/btSphereShape.h"
+
+using namespace Helium;
+
+namespace
+{
+	// Filters on the body component stored in each collision object's user pointer
+	bool ShouldQueryObject( const btCollisionObject *pObject, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody )
+	{
+		const BulletBodyComponent *pBody = static_cast< const BulletBodyComponent * >( pObject->getUserPointer() );
+		return pBody && pBody != pIgnoreBody && ( pBody->GetAssignedGroups() & groupMask ) != 0;
+	}
+
+	struct QueryRayCallback : public btCollisionWorld::ClosestRayResultCallback
+	{
+		QueryRayCallback( const btVector3 &rFrom, const btVector3 &rTo, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody )
+			: btCollisionWorld::ClosestRayResultCallback( rFrom, rTo )
+			, m_GroupMask( groupMask )
+			, m_pIgnoreBody( pIgnoreBody )
+		{
+
+		}
+
+		virtual bool needsCollision( btBroadphaseProxy* proxy0 ) const
+		{
+			return ShouldQueryObject( static_cast< const btCollisionObject * >( proxy0->m_clientObject ), m_GroupMask, m_pIgnoreBody );
+		}
+
+		uint16_t m_GroupMask;
+		const BulletBodyComponent *m_pIgnoreBody;
+	};
+
+	struct QuerySweepCallback : public btCollisionWorld::ClosestConvexResultCallback
+	{
+		QuerySweepCallback( const btVector3 &rFrom, const btVector3 &rTo, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody )
+			: btCollisionWorld::ClosestConvexResultCallback( rFrom, rTo )
+			, m_GroupMask( groupMask )
+			, m_pIgnoreBody( pIgnoreBody )
+		{
+
+		}
+
+		virtual bool needsCollision( btBroadphaseProxy* proxy0 ) const
+		{
+			return ShouldQueryObject( static_cast< const btCollisionObject * >( proxy0->m_clientObject ), m_GroupMask, m_pIgnoreBody );
+		}
+
+		uint16_t m_GroupMask;
+		const BulletBodyComponent *m_pIgnoreBody;
+	};
+
+	// Collects bodies whose broadphase bounds touch the sphere. Candidates are refined against their bounds only,
+	// which keeps the query inside the broadphase and free of narrowphase allocations
+	struct QueryOverlapCallback : public btBroadphaseAabbCallback
+	{
+		QueryOverlapCallback( const btVector3 &rCenter, float32_t radius, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody, BulletBodyComponent **ppResults, size_t maxResults )
+			: m_Center( rCenter )
+			, m_RadiusSquared( radius * radius )
+			, m_GroupMask( groupMask )
+			, m_pIgnoreBody( pIgnoreBody )
+			, m_ppResults( ppResults )
+			, m_MaxResults( maxResults )
+			, m_ResultCount( 0 )
+		{
+
+		}
+
+		virtual bool process( const btBroadphaseProxy* proxy )
+		{
+			// Older versions of bullet ignore the return value and keep walking the broadphase
+			if ( m_ResultCount >= m_MaxResults )
+			{
+				return false;
+			}
+
+			const btCollisionObject *pObject = static_cast< const btCollisionObject * >( proxy->m_clientObject );
+			if ( !ShouldQueryObject( pObject, m_GroupMask, m_pIgnoreBody ) )
+			{
+				return true;
+			}
+
+			btVector3 closest = m_Center;
+			closest.setMax( proxy->m_aabbMin );
+			closest.setMin( proxy->m_aabbMax );
+			if ( closest.distance2( m_Center ) > m_RadiusSquared )
+			{
+				return true;
+			}
+
+			m_ppResults[ m_ResultCount++ ] = static_cast< BulletBodyComponent * >( pObject->getUserPointer() );
+			return m_ResultCount < m_MaxResults;
+		}
+
+		btVector3 m_Center;
+		btScalar m_RadiusSquared;
+		uint16_t m_GroupMask;
+		const BulletBodyComponent *m_pIgnoreBody;
+
+		BulletBodyComponent **m_ppResults;
+		size_t m_MaxResults;
+		size_t m_ResultCount;
+	};
+
+	void ClearHit( BulletQueryHit &rHit )
+	{
+		rHit.m_pBody = NULL;
+		rHit.m_Fraction = 1.0f;
+		rHit.m_Position[ 0 ] = rHit.m_Position[ 1 ] = rHit.m_Position[ 2 ] = 0.0f;
+		rHit.m_Normal[ 0 ] = rHit.m_Normal[ 1 ] = rHit.m_Normal[ 2 ] = 0.0f;
+	}
+
+	void SetHit( BulletQueryHit &rHit, const btCollisionObject *pObject, btScalar fraction, const btVector3 &rPosition, const btVector3 &rNormal )
+	{
+		rHit.m_pBody = static_cast< BulletBodyComponent * >( pObject->getUserPointer() );
+		rHit.m_Fraction = fraction;
+		rHit.m_Position[ 0 ] = rPosition.getX();
+		rHit.m_Position[ 1 ] = rPosition.getY();
+		rHit.m_Position[ 2 ] = rPosition.getZ();
+		rHit.m_Normal[ 0 ] = rNormal.getX();
+		rHit.m_Normal[ 1 ] = rNormal.getY();
+		rHit.m_Normal[ 2 ] = rNormal.getZ();
+	}
+}
+
+Helium::BulletSceneQueryBatch::BulletSceneQueryBatch()
+{
+
+}
+
+void Helium::BulletSceneQueryBatch::Clear()
+{
+	m_Rays.Resize( 0 );
+	m_Sweeps.Resize( 0 );
+	m_Overlaps.Resize( 0 );
+	m_RayHits.Resize( 0 );
+	m_SweepHits.Resize( 0 );
+	m_OverlapResults.Resize( 0 );
+}
+
+Helium::BulletSceneQueryBatch::Query Helium::BulletSceneQueryBatch::MakeQuery( const Simd::Vector3 &rFrom, const Simd::Vector3 &rTo, float32_t radius, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody )
+{
+	Query query;
+	query.m_From[ 0 ] = rFrom.GetElement( 0 );
+	query.m_From[ 1 ] = rFrom.GetElement( 1 );
+	query.m_From[ 2 ] = rFrom.GetElement( 2 );
+	query.m_To[ 0 ] = rTo.GetElement( 0 );
+	query.m_To[ 1 ] = rTo.GetElement( 1 );
+	query.m_To[ 2 ] = rTo.GetElement( 2 );
+	query.m_Radius = radius;
+	query.m_GroupMask = groupMask;
+	query.m_pIgnoreBody = pIgnoreBody;
+	query.m_ResultOffset = 0;
+	query.m_MaxResults = 0;
+	query.m_ResultCount = 0;
+
+	return query;
+}
+
+size_t Helium::BulletSceneQueryBatch::AddRay( const Simd::Vector3 &rFrom, const Simd::Vector3 &rTo, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody )
+{
+	m_Rays.Push( MakeQuery( rFrom, rTo, 0.0f, groupMask, pIgnoreBody ) );
+	return m_Rays.GetSize() - 1;
+}
+
+size_t Helium::BulletSceneQueryBatch::AddSphereSweep( const Simd::Vector3 &rFrom, const Simd::Vector3 &rTo, float32_t radius, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody )
+{
+	HELIUM_ASSERT( radius > 0.0f );
+
+	m_Sweeps.Push( MakeQuery( rFrom, rTo, radius, groupMask, pIgnoreBody ) );
+	return m_Sweeps.GetSize() - 1;
+}
+
+size_t Helium::BulletSceneQueryBatch::AddSphereOverlap( const Simd::Vector3 &rCenter, float32_t radius, size_t maxResults, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody )
+{
+	HELIUM_ASSERT( maxResults > 0 );
+
+	// Each overlap gets its own slice of the result buffer so jobs can fill them without synchronizing
+	Query query = MakeQuery( rCenter, rCenter, radius, groupMask, pIgnoreBody );
+	query.m_ResultOffset = m_OverlapResults.GetSize();
+	query.m_MaxResults = maxResults;
+	m_OverlapResults.Resize( m_OverlapResults.GetSize() + maxResults );
+
+	m_Overlaps.Push( query );
+	return m_Overlaps.GetSize() - 1;
+}
+
+BulletBodyComponent * const *Helium::BulletSceneQueryBatch::GetOverlapResults( size_t index, size_t &rCount ) const
+{
+	const Query &rQuery = m_Overlaps[ index ];
+	rCount = rQuery.m_ResultCount;
+	return m_OverlapResults.GetData() + rQuery.m_ResultOffset;
+}
+
+void Helium::BulletSceneQueryBatch::Execute( const btCollisionWorld &rWorld )
+{
+	m_RayHits.Resize( m_Rays.GetSize() );
+	m_SweepHits.Resize( m_Sweeps.GetSize() );
+
+	ExecuteContext context;
+	context.m_pBatch = this;
+	context.m_pWorld = &rWorld;
+
+	JobManager::ParallelFor( ExecuteQuery, &context, m_Rays.GetSize() + m_Sweeps.GetSize() + m_Overlaps.GetSize() );
+}
+
+void Helium::BulletSceneQueryBatch::ExecuteQuery( void *pContext, size_t index )
+{
+	ExecuteContext *pExecuteContext = static_cast< ExecuteContext * >( pContext );
+	BulletSceneQueryBatch *pBatch = pExecuteContext->m_pBatch;
+
+	if ( index < pBatch->m_Rays.GetSize() )
+	{
+		pBatch->RunRay( *pExecuteContext->m_pWorld, index );
+		return;
+	}
+
+	index -= pBatch->m_Rays.GetSize();
+	if ( index < pBatch->m_Sweeps.GetSize() )
+	{
+		pBatch->RunSweep( *pExecuteContext->m_pWorld, index );
+		return;
+	}
+
+	index -= pBatch->m_Sweeps.GetSize();
+	pBatch->RunOverlap( *pExecuteContext->m_pWorld, index );
+}
+
+void Helium::BulletSceneQueryBatch::RunRay( const btCollisionWorld &rWorld, size_t index )
+{
+	const Query &rQuery = m_Rays[ index ];
+	BulletQueryHit &rHit = m_RayHits[ index ];
+
+	btVector3 from( rQuery.m_From[ 0 ], rQuery.m_From[ 1 ], rQuery.m_From[ 2 ] );
+	btVector3 to( rQuery.m_To[ 0 ], rQuery.m_To[ 1 ], rQuery.m_To[ 2 ] );
+
+	QueryRayCallback callback( from, to, rQuery.m_GroupMask, rQuery.m_pIgnoreBody );
+	rWorld.rayTest( from, to, callback );
+
+	if ( callback.hasHit() )
+	{
+		SetHit( rHit, callback.m_collisionObject, callback.m_closestHitFraction, callback.m_hitPointWorld, callback.m_hitNormalWorld );
+	}
+	else
+	{
+		ClearHit( rHit );
+	}
+}
+
+void Helium::BulletSceneQueryBatch::RunSweep( const btCollisionWorld &rWorld, size_t index )
+{
+	const Query &rQuery = m_Sweeps[ index ];
+	BulletQueryHit &rHit = m_SweepHits[ index ];
+
+	btVector3 from( rQuery.m_From[ 0 ], rQuery.m_From[ 1 ], rQuery.m_From[ 2 ] );
+	btVector3 to( rQuery.m_To[ 0 ], rQuery.m_To[ 1 ], rQuery.m_To[ 2 ] );
+
+	btSphereShape sphere( rQuery.m_Radius );
+	QuerySweepCallback callback( from, to, rQuery.m_GroupMask, rQuery.m_pIgnoreBody );
+	rWorld.convexSweepTest( &sphere, btTransform( btQuaternion::getIdentity(), from ), btTransform( btQuaternion::getIdentity(), to ), callback );
+
+	if ( callback.hasHit() )
+	{
+		SetHit( rHit, callback.m_hitCollisionObject, callback.m_closestHitFraction, callback.m_hitPointWorld, callback.m_hitNormalWorld );
+	}
+	else
+	{
+		ClearHit( rHit );
+	}
+}
+
+void Helium::BulletSceneQueryBatch::RunOverlap( const btCollisionWorld &rWorld, size_t index )
+{
+	Query &rQuery = m_Overlaps[ index ];
+
+	btVector3 center( rQuery.m_From[ 0 ], rQuery.m_From[ 1 ], rQuery.m_From[ 2 ] );
+	btVector3 extent( rQuery.m_Radius, rQuery.m_Radius, rQuery.m_Radius );
+
+	QueryOverlapCallback callback( center, rQuery.m_Radius, rQuery.m_GroupMask, rQuery.m_pIgnoreBody, m_OverlapResults.GetData() + rQuery.m_ResultOffset, rQuery.m_MaxResults );
+	const_cast< btCollisionWorld & >( rWorld ).getBroadphase()->aabbTest( center - extent, center + extent, callback );
+
+	rQuery.m_ResultCount = callback.m_ResultCount;
+}
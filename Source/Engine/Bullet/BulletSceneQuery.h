@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Bullet/Bullet.h"
+#include "MathSimd/Vector3.h"
+#include "Foundation/DynamicArray.h"
+
+class btCollisionWorld;
+
+namespace Helium
+{
+	class BulletBodyComponent;
+
+	// Closest hit of a ray or sweep. Kept as plain floats so results pack tightly
+	struct BulletQueryHit
+	{
+		// NULL if nothing was hit
+		BulletBodyComponent *m_pBody;
+		// Fraction of the way from the start to the end of the query where the hit happened
+		float32_t m_Fraction;
+		float32_t m_Position[ 3 ];
+		float32_t m_Normal[ 3 ];
+
+		inline bool HasHit() const { return m_pBody != NULL; }
+		inline Simd::Vector3 GetPosition() const { return Simd::Vector3( m_Position[ 0 ], m_Position[ 1 ], m_Position[ 2 ] ); }
+		inline Simd::Vector3 GetNormal() const { return Simd::Vector3( m_Normal[ 0 ], m_Normal[ 1 ], m_Normal[ 2 ] ); }
+	};
+
+	// A batch of rays, sphere sweeps and sphere overlaps that are run together, split across job threads. Queries are
+	// added up front, then BulletWorldComponent::RunSceneQueries() fills in every result at once. Only bodies whose
+	// assigned groups intersect a query's group mask are considered, and a body may be excluded (usually the caller's
+	// own). Reusing a batch from frame to frame keeps it from allocating.
+	class HELIUM_BULLET_API BulletSceneQueryBatch
+	{
+	public:
+		BulletSceneQueryBatch();
+
+		void Clear();
+
+		// Each returns the index of the query among those of its kind, used to read its result
+		size_t AddRay( const Simd::Vector3 &rFrom, const Simd::Vector3 &rTo, uint16_t groupMask = 0xffff, const BulletBodyComponent *pIgnoreBody = NULL );
+		size_t AddSphereSweep( const Simd::Vector3 &rFrom, const Simd::Vector3 &rTo, float32_t radius, uint16_t groupMask = 0xffff, const BulletBodyComponent *pIgnoreBody = NULL );
+		size_t AddSphereOverlap( const Simd::Vector3 &rCenter, float32_t radius, size_t maxResults, uint16_t groupMask = 0xffff, const BulletBodyComponent *pIgnoreBody = NULL );
+
+		size_t GetRayCount() const { return m_Rays.GetSize(); }
+		size_t GetSweepCount() const { return m_Sweeps.GetSize(); }
+		size_t GetOverlapCount() const { return m_Overlaps.GetSize(); }
+
+		const BulletQueryHit &GetRayHit( size_t index ) const { return m_RayHits[ index ]; }
+		const BulletQueryHit &GetSweepHit( size_t index ) const { return m_SweepHits[ index ]; }
+
+		// Bodies overlapping the sphere, at most maxResults of them
+		BulletBodyComponent * const *GetOverlapResults( size_t index, size_t &rCount ) const;
+
+		// Runs every query against the given world. Called by BulletWorldComponent::RunSceneQueries()
+		void Execute( const btCollisionWorld &rWorld );
+
+	private:
+		struct Query
+		{
+			float32_t m_From[ 3 ];
+			float32_t m_To[ 3 ];
+			float32_t m_Radius;
+			uint16_t m_GroupMask;
+			const BulletBodyComponent *m_pIgnoreBody;
+
+			// Overlaps only: range of m_OverlapResults reserved for this query, and how much of it was filled
+			size_t m_ResultOffset;
+			size_t m_MaxResults;
+			size_t m_ResultCount;
+		};
+
+		struct ExecuteContext
+		{
+			BulletSceneQueryBatch *m_pBatch;
+			const btCollisionWorld *m_pWorld;
+		};
+
+		static void ExecuteQuery( void *pContext, size_t index );
+		static Query MakeQuery( const Simd::Vector3 &rFrom, const Simd::Vector3 &rTo, float32_t radius, uint16_t groupMask, const BulletBodyComponent *pIgnoreBody );
+
+		void RunRay( const btCollisionWorld &rWorld, size_t index );
+		void RunSweep( const btCollisionWorld &rWorld, size_t index );
+		void RunOverlap( const btCollisionWorld &rWorld, size_t index );
+
+		DynamicArray< Query > m_Rays;
+		DynamicArray< Query > m_Sweeps;
+		DynamicArray< Query > m_Overlaps;
+
+		DynamicArray< BulletQueryHit > m_RayHits;
+		DynamicArray< BulletQueryHit > m_SweepHits;
+		DynamicArray< BulletBodyComponent * > m_OverlapResults;
+	};
+}
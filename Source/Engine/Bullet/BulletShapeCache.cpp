@@ -0,0 +1,172 @@
+#include "Precompile.h"
+#include "Bullet/BulletShapeCache.h"
+#include "Bullet/BulletBodyDefinition.h"
+#include "Bullet/BulletShapes.h"
+
+using namespace Helium;
+
+struct Helium::BulletShapeCache::CachedShape
+{
+	DynamicArray< uint8_t > m_Key;
+
+	// Every bullet shape created for this entry, children of a compound included
+	DynamicArray< btCollisionShape * > m_OwnedShapes;
+	btCollisionShape *m_pShape;
+
+	// Kept as plain floats since entries are not allocated with bullet's alignment
+	float m_Mass;
+	float m_LocalInertia[ 3 ];
+
+	// Next entry whose key hashes the same
+	CachedShape *m_pNext;
+};
+
+static uint32_t HashCacheKey( const DynamicArray< uint8_t > &rKey )
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+	for ( size_t i = 0; i < rKey.GetSize(); ++i )
+	{
+		hash = ( hash ^ rKey[ i ] ) * 16777619u;
+	}
+
+	return hash;
+}
+
+static bool CacheKeysEqual( const DynamicArray< uint8_t > &rA, const DynamicArray< uint8_t > &rB )
+{
+	return rA.GetSize() == rB.GetSize() && MemoryCompare( rA.GetData(), rB.GetData(), rA.GetSize() ) == 0;
+}
+
+Helium::BulletShapeCache::BulletShapeCache()
+{
+
+}
+
+Helium::BulletShapeCache::~BulletShapeCache()
+{
+	Clear();
+}
+
+btCollisionShape *Helium::BulletShapeCache::Acquire( const BulletBodyDefinition &rBodyDefinition, float scale, float &rMass, btVector3 &rLocalInertia )
+{
+	if ( rBodyDefinition.m_Shapes.IsEmpty() )
+	{
+		return NULL;
+	}
+
+	MutexScopeLock scopeLock( m_Lock );
+
+	m_ScratchKey.Resize( 0 );
+	m_ScratchKey.AddArray( reinterpret_cast< const uint8_t * >( &scale ), sizeof( scale ) );
+	for ( size_t i = 0; i < rBodyDefinition.m_Shapes.GetSize(); ++i )
+	{
+		rBodyDefinition.m_Shapes[ i ]->AppendCacheKey( m_ScratchKey );
+	}
+
+	uint32_t hash = HashCacheKey( m_ScratchKey );
+
+	HashMap< uint32_t, CachedShape * >::Iterator shapeIter = m_Shapes.Find( hash );
+	if ( shapeIter != m_Shapes.End() )
+	{
+		for ( CachedShape *pCachedShape = shapeIter->Second(); pCachedShape; pCachedShape = pCachedShape->m_pNext )
+		{
+			if ( CacheKeysEqual( pCachedShape->m_Key, m_ScratchKey ) )
+			{
+				rMass = pCachedShape->m_Mass;
+				rLocalInertia.setValue( pCachedShape->m_LocalInertia[ 0 ], pCachedShape->m_LocalInertia[ 1 ], pCachedShape->m_LocalInertia[ 2 ] );
+				return pCachedShape->m_pShape;
+			}
+		}
+	}
+
+	CachedShape *pCachedShape = new CachedShape;
+	pCachedShape->m_Key = m_ScratchKey;
+
+	if ( rBodyDefinition.m_Shapes.GetSize() > 1 || rBodyDefinition.m_Shapes[0]->m_Position.GetMagnitudeSquared() > HELIUM_EPSILON )
+	{
+		btCompoundShape *pCompoundShape = new btCompoundShape( true );
+
+		float mass = 0.0f;
+		for ( size_t i = 0; i < rBodyDefinition.m_Shapes.GetSize(); ++i )
+		{
+			btVector3 position;
+			btQuaternion rotation;
+
+			ConvertToBullet( rBodyDefinition.m_Shapes[i]->m_Position, position );
+			ConvertToBullet( rBodyDefinition.m_Shapes[i]->m_Rotation, rotation );
+
+			btCollisionShape *pBulletShape = rBodyDefinition.m_Shapes[i]->CreateShape();
+			pCompoundShape->addChildShape(
+				btTransform(rotation, position),
+				pBulletShape);
+			pCachedShape->m_OwnedShapes.Push( pBulletShape );
+
+			mass += rBodyDefinition.m_Shapes[i]->m_Mass;
+		}
+
+		pCachedShape->m_pShape = pCompoundShape;
+		pCachedShape->m_Mass = mass;
+	}
+	else
+	{
+		pCachedShape->m_pShape = rBodyDefinition.m_Shapes[0]->CreateShape();
+		pCachedShape->m_Mass = rBodyDefinition.m_Shapes[0]->m_Mass;
+	}
+
+	pCachedShape->m_OwnedShapes.Push( pCachedShape->m_pShape );
+
+	if ( scale != 1.0f )
+	{
+		pCachedShape->m_pShape->setLocalScaling( btVector3( scale, scale, scale ) );
+	}
+
+	btVector3 localInertia( 0.0f, 0.0f, 0.0f );
+	if ( pCachedShape->m_Mass != 0.0f )
+	{
+		pCachedShape->m_pShape->calculateLocalInertia( pCachedShape->m_Mass, localInertia );
+	}
+
+	pCachedShape->m_LocalInertia[ 0 ] = localInertia.getX();
+	pCachedShape->m_LocalInertia[ 1 ] = localInertia.getY();
+	pCachedShape->m_LocalInertia[ 2 ] = localInertia.getZ();
+
+	if ( shapeIter != m_Shapes.End() )
+	{
+		pCachedShape->m_pNext = shapeIter->Second();
+		shapeIter->Second() = pCachedShape;
+	}
+	else
+	{
+		pCachedShape->m_pNext = NULL;
+		m_Shapes.Insert( shapeIter, HashMap< uint32_t, CachedShape * >::ValueType( hash, pCachedShape ) );
+	}
+
+	rMass = pCachedShape->m_Mass;
+	rLocalInertia = localInertia;
+	return pCachedShape->m_pShape;
+}
+
+void Helium::BulletShapeCache::Clear()
+{
+	MutexScopeLock scopeLock( m_Lock );
+
+	for ( HashMap< uint32_t, CachedShape * >::Iterator shapeIter = m_Shapes.Begin(); shapeIter != m_Shapes.End(); ++shapeIter )
+	{
+		CachedShape *pCachedShape = shapeIter->Second();
+		while ( pCachedShape )
+		{
+			// Compounds are pushed last, so they are deleted before the children they refer to
+			for ( size_t i = pCachedShape->m_OwnedShapes.GetSize(); i > 0; --i )
+			{
+				delete pCachedShape->m_OwnedShapes[ i - 1 ];
+			}
+
+			CachedShape *pNext = pCachedShape->m_pNext;
+			delete pCachedShape;
+			pCachedShape = pNext;
+		}
+	}
+
+	m_Shapes.Clear();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Bullet/Bullet.h"
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/HashMap.h"
+
+class btCollisionShape;
+class btVector3;
+
+namespace Helium
+{
+	struct BulletBodyDefinition;
+
+	// Bullet shapes keyed by the contents of the shape definitions they were created from and their scale. Bodies with
+	// identical shapes share one btCollisionShape (or compound), and spawning one no longer allocates any shapes
+	// or recomputes inertia. Shapes stay cached until the cache is destroyed, so waves of short lived bodies keep
+	// reusing them.
+	class HELIUM_BULLET_API BulletShapeCache
+	{
+	public:
+		BulletShapeCache();
+		~BulletShapeCache();
+
+		// Returns the shared shape for the definition, creating it the first time it is seen. Mass and local inertia
+		// of the whole shape are returned too. Returns NULL if the definition has no shapes.
+		btCollisionShape *Acquire( const BulletBodyDefinition &rBodyDefinition, float scale, float &rMass, btVector3 &rLocalInertia );
+
+		void Clear();
+
+	private:
+		struct CachedShape;
+
+		HashMap< uint32_t, CachedShape * > m_Shapes;
+		DynamicArray< uint8_t > m_ScratchKey;
+		Mutex m_Lock;
+	};
+}
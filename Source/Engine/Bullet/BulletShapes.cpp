@@ -23,6 +23,26 @@ Helium::BulletShape::BulletShape()
 	
 }
 
+void Helium::BulletShape::AppendCacheKey( DynamicArray< uint8_t > &rKey ) const
+{
+	const Reflect::MetaClass *pType = GetMetaClass();
+	AppendCacheKeyData( rKey, &pType, sizeof( pType ) );
+	AppendCacheKeyData( rKey, &m_Mass, sizeof( m_Mass ) );
+
+	// Only the used elements, since padding may hold anything
+	float32_t transform[ 7 ] =
+	{
+		m_Position.GetElement( 0 ), m_Position.GetElement( 1 ), m_Position.GetElement( 2 ),
+		m_Rotation.GetElement( 0 ), m_Rotation.GetElement( 1 ), m_Rotation.GetElement( 2 ), m_Rotation.GetElement( 3 )
+	};
+	AppendCacheKeyData( rKey, transform, sizeof( transform ) );
+}
+
+void Helium::BulletShape::AppendCacheKeyData( DynamicArray< uint8_t > &rKey, const void *pData, size_t size )
+{
+	rKey.AddArray( static_cast< const uint8_t * >( pData ), size );
+}
+
 //REFLECT_DEFINE_DERIVED_STRUCT(Helium::BulletShapeSphere);
 HELIUM_DEFINE_CLASS(Helium::BulletShapeSphere);
 
@@ -36,6 +56,12 @@ btCollisionShape * Helium::BulletShapeSphere::CreateShape() const
 	return new btSphereShape(m_Radius);
 }
 
+void Helium::BulletShapeSphere::AppendCacheKey( DynamicArray< uint8_t > &rKey ) const
+{
+	BulletShape::AppendCacheKey( rKey );
+	AppendCacheKeyData( rKey, &m_Radius, sizeof( m_Radius ) );
+}
+
 Helium::BulletShapeSphere::BulletShapeSphere()
 	: m_Radius(1.0f)
 {
@@ -57,6 +83,14 @@ btCollisionShape * Helium::BulletShapeBox::CreateShape() const
 	return new btBoxShape(extents);
 }
 
+void Helium::BulletShapeBox::AppendCacheKey( DynamicArray< uint8_t > &rKey ) const
+{
+	BulletShape::AppendCacheKey( rKey );
+
+	float32_t extents[ 3 ] = { m_Extents.GetElement( 0 ), m_Extents.GetElement( 1 ), m_Extents.GetElement( 2 ) };
+	AppendCacheKeyData( rKey, extents, sizeof( extents ) );
+}
+
 Helium::BulletShapeBox::BulletShapeBox()
 	: m_Extents(1.0f, 1.0f, 1.0f)
 {
@@ -3,6 +3,7 @@
 #include "Bullet/Bullet.h"
 #include "Reflect/Object.h"
 #include "Math/Vector3.h"
+#include "Foundation/DynamicArray.h"
 
 
 class btCollisionShape;
@@ -30,8 +31,12 @@ namespace Helium
 
 		//virtual btCollisionShape *CreateShape() const = 0;
 		virtual btCollisionShape *CreateShape() const { HELIUM_ASSERT( 0 ); return NULL; } // Must implement because using HELIUM_DECLARE_CLASS instead of HELIUM_DECLARE_ABSTRACT
+
+		// Appends everything that affects the created shape, so that identical shapes can share one bullet shape
+		virtual void AppendCacheKey( DynamicArray< uint8_t > &rKey ) const;
 	protected:
 		void ConfigureShape(btCollisionShape *pShape);
+		static void AppendCacheKeyData( DynamicArray< uint8_t > &rKey, const void *pData, size_t size );
 	};
 	typedef Helium::StrongPtr<BulletShape> BulletShapePtr;
 	
@@ -47,6 +52,7 @@ namespace Helium
 		inline bool operator!=( const BulletShapeSphere& _rhs ) const { return !( *this == _rhs ); }
 		
 		virtual btCollisionShape *CreateShape() const override;
+		virtual void AppendCacheKey( DynamicArray< uint8_t > &rKey ) const override;
 
 		float m_Radius;
 	};
@@ -64,6 +70,7 @@ namespace Helium
 		inline bool operator!=( const BulletShapeBox& _rhs ) const { return !( *this == _rhs ); }
 		
 		virtual btCollisionShape *CreateShape() const override;
+		virtual void AppendCacheKey( DynamicArray< uint8_t > &rKey ) const override;
 
 		Simd::Vector3 m_Extents;
 	};
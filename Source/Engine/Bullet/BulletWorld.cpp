@@ -4,130 +4,291 @@
 #include "Bullet/BulletWorldDefinition.h"
 #include "Bullet/BulletBodyComponent.h"
 #include "Bullet/BulletWorldComponent.h"
+#include "Bullet/BulletMotionState.h"
+#include "EngineJobs/JobManager.h"
+#include "Engine/FrameProfiler.h"
+
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include "LinearMath/btThreads.h"
 
 using namespace Helium;
 
-void InternalTickCallback(btDynamicsWorld *world, btScalar timeStep)
+// Runs Bullet's parallel loops on the engine's job threads instead of a separate Bullet thread pool.  Bullet assigns
+// per-thread data lazily through btGetCurrentThreadIndex(), so any thread the job system picks is fine.
+class BulletJobTaskScheduler : public btITaskScheduler
 {
-	BulletWorld * pWorld = static_cast<BulletWorld *>( world->getWorldUserInfo() );
+public:
+	BulletJobTaskScheduler()
+		: btITaskScheduler( "HeliumJobs" )
+	{
+	}
 
-	ComponentManager &pComponentManager = *static_cast<BulletWorldComponent *>(world->getWorldUserInfo())->GetComponentManager();
-	for (ComponentIteratorT<HasPhysicalContactsComponent> iter( pComponentManager ); iter.GetBaseComponent(); iter.Advance())
+	virtual int getMaxNumThreads() const
 	{
-		//HELIUM_TRACE( TraceLevels::Debug, "iter->m_EndFrameTouching.Clear %d\n", iter->m_EndFrameTouching.GetSize());
-		iter->m_EndFrameTouching.Clear();
+		JobManager *pJobManager = JobManager::GetInstance();
+		return Min( static_cast< int >( ( pJobManager ? pJobManager->GetWorkerCount() : 0 ) + 1 ), BT_MAX_THREAD_COUNT );
 	}
 
-	int numManifolds = world->getDispatcher()->getNumManifolds();
-	for (int i=0;i<numManifolds;i++)
+	virtual int getNumThreads() const
 	{
-		btPersistentManifold* contactManifold =  world->getDispatcher()->getManifoldByIndexInternal(i);
-		const btCollisionObject* obA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
-		const btCollisionObject* obB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
-		
-		BulletBodyComponent *pBodyComponentA = static_cast<BulletBodyComponent *>( obA->getUserPointer() );
-		BulletBodyComponent *pBodyComponentB = static_cast<BulletBodyComponent *>( obB->getUserPointer() );
+		return getMaxNumThreads();
+	}
+
+	virtual void setNumThreads( int /*numThreads*/ )
+	{
+		// The job manager owns the thread count
+	}
+
+	virtual void parallelFor( int iBegin, int iEnd, int grainSize, const btIParallelForBody& body )
+	{
+		ForContext context = { &body, iBegin, iEnd, Max( grainSize, 1 ) };
+		JobManager::ParallelFor( ForCallback, &context, GetChunkCount( iBegin, iEnd, context.grainSize ) );
+	}
+
+	virtual btScalar parallelSum( int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body )
+	{
+		SumContext context = { &body, iBegin, iEnd, Max( grainSize, 1 ) };
+		size_t chunkCount = GetChunkCount( iBegin, iEnd, context.grainSize );
+		context.sums.Resize( chunkCount );
+		JobManager::ParallelFor( SumCallback, &context, chunkCount );
+
+		btScalar sum = btScalar( 0 );
+		for ( size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex )
+		{
+			sum += context.sums[ chunkIndex ];
+		}
+
+		return sum;
+	}
+
+private:
+	struct ForContext
+	{
+		const btIParallelForBody *pBody;
+		int begin;
+		int end;
+		int grainSize;
+	};
+
+	struct SumContext
+	{
+		const btIParallelSumBody *pBody;
+		int begin;
+		int end;
+		int grainSize;
+		DynamicArray< btScalar > sums;
+	};
+
+	static size_t GetChunkCount( int iBegin, int iEnd, int grainSize )
+	{
+		return ( iEnd > iBegin ) ? static_cast< size_t >( ( iEnd - iBegin + grainSize - 1 ) / grainSize ) : 0;
+	}
+
+	static void ForCallback( void *pContext, size_t chunkIndex )
+	{
+		const ForContext &rContext = *static_cast< const ForContext * >( pContext );
+		int chunkBegin = rContext.begin + static_cast< int >( chunkIndex ) * rContext.grainSize;
+		rContext.pBody->forLoop( chunkBegin, Min( chunkBegin + rContext.grainSize, rContext.end ) );
+	}
+
+	static void SumCallback( void *pContext, size_t chunkIndex )
+	{
+		SumContext &rContext = *static_cast< SumContext * >( pContext );
+		int chunkBegin = rContext.begin + static_cast< int >( chunkIndex ) * rContext.grainSize;
+		rContext.sums[ chunkIndex ] = rContext.pBody->sumLoop( chunkBegin, Min( chunkBegin + rContext.grainSize, rContext.end ) );
+	}
+};
+
+static BulletJobTaskScheduler *s_pTaskScheduler = NULL;
+
+// Collision configuration and solver pool shared by every world created with m_ShareResources. Like the task
+// scheduler, worlds are only created and destroyed on the main thread, so no lock is needed here. Stepping worlds at the
+// same time is safe: with BT_THREADSAFE the configuration's pool allocators lock, and the solver pool hands out each of
+// its solvers to one island at a time.
+struct BulletSharedResources
+{
+	btDefaultCollisionConfiguration *m_pCollisionConfiguration;
+	btConstraintSolverPoolMt *m_pSolverPool;
+	uint32_t m_WorldCount;
+};
+
+static BulletSharedResources s_SharedResources = { NULL, NULL, 0 };
+
+static void AcquireSharedResources()
+{
+	if ( !s_SharedResources.m_WorldCount++ )
+	{
+		// One solver for every thread that might be stepping a world
+		JobManager *pJobManager = JobManager::GetInstance();
+		int solverCount = static_cast< int >( ( pJobManager ? pJobManager->GetWorkerCount() : 0 ) + 1 );
+
+		s_SharedResources.m_pCollisionConfiguration = new btDefaultCollisionConfiguration();
+		s_SharedResources.m_pSolverPool = new btConstraintSolverPoolMt( Min( solverCount, BT_MAX_THREAD_COUNT ) );
+	}
+}
 
-		bool trackACollisions = pBodyComponentA && pBodyComponentA->ShouldTrackCollisions();
-		bool trackBCollisions = pBodyComponentB && pBodyComponentB->ShouldTrackCollisions();
+static void ReleaseSharedResources()
+{
+	HELIUM_ASSERT( s_SharedResources.m_WorldCount );
+	if ( !--s_SharedResources.m_WorldCount )
+	{
+		delete s_SharedResources.m_pSolverPool;
+		delete s_SharedResources.m_pCollisionConfiguration;
+		s_SharedResources.m_pSolverPool = NULL;
+		s_SharedResources.m_pCollisionConfiguration = NULL;
+	}
+}
 
-		trackACollisions = pBodyComponentA->GetShouldTrackPhysicalContact( pBodyComponentB );
-		trackBCollisions = pBodyComponentB->GetShouldTrackPhysicalContact( pBodyComponentA );
+// Steps simulated per frame at most, so a long frame can't make physics fall further and further behind
+static const int MAX_SUB_STEPS = 10;
 
-		if ( trackACollisions || trackBCollisions )
+void InternalTickCallback(btDynamicsWorld *world, btScalar timeStep)
+{
+	// Only record who touched whom; the pairs are sorted and published once the whole frame has been simulated
+	BulletWorldComponent *pWorldComponent = static_cast<BulletWorldComponent *>( world->getWorldUserInfo() );
+	pWorldComponent->GatherTouchedPairs();
+
+	// If we want more complex collision tracking than just touch, we could maybe gather the below per contact point
+	// given the existence of a "complex touch tracking" flag
+#if 0
+	int numContacts = contactManifold->getNumContacts();
+	for (int j=0;j<numContacts;j++)
+	{
+		btManifoldPoint& pt = contactManifold->getContactPoint(j);
+		if (pt.getDistance()<0.f)
 		{
-			int numContacts = contactManifold->getNumContacts();
+			Simd::Vector3 ptA;
+			Simd::Vector3 ptB;
+			Simd::Vector3 normalB;
 
-			if (numContacts)
+			ConvertFromBullet( pt.getPositionWorldOnA(), ptA );
+			ConvertFromBullet( pt.getPositionWorldOnB(), ptB );
+			ConvertFromBullet( pt.m_normalWorldOnB, normalB );
+
+			if ( trackACollisions )
 			{
-				if ( trackACollisions )
-				{
-					HasPhysicalContactsComponent *pContacts = pBodyComponentA->GetOrCreateHasPhysicalContactsComponent();
-					pContacts->m_EverTouchedThisFrame.Insert( pBodyComponentB->GetEntity() );
-
-					// TODO: Only need to do this on last subtick really
-					pContacts->m_EndFrameTouching.Insert( pBodyComponentB->GetEntity() );
-				}
-
-				if ( trackBCollisions )
-				{
-					HasPhysicalContactsComponent *pContacts = pBodyComponentB->GetOrCreateHasPhysicalContactsComponent();
-					pContacts->m_EverTouchedThisFrame.Insert( pBodyComponentA->GetEntity() );
-
-					// TODO: Only need to do this on last subtick really
-					pContacts->m_EndFrameTouching.Insert( pBodyComponentA->GetEntity() );
-				}
+				HasPhysicalContactsComponent *pContacts = pBodyComponentA->GetOrCreateHasPhysicalContactsComponent();
+				ContactInfo *pInfo = pContacts->CreateContact();
+				pInfo->m_pEntity = pBodyComponentB->GetEntity();
+				pInfo->m_OurPosition = ptA;
+				pInfo->m_TheirPosition = ptB;
+				pInfo->m_Normal = normalB;
 			}
 
-			// If we want more complex collision tracking than just touch, we could maybe run the below code given the existence of a "complex touch tracking" flag
-#if 0
-			int numContacts = contactManifold->getNumContacts();
-			for (int j=0;j<numContacts;j++)
+			if ( trackBCollisions )
 			{
-				HELIUM_TRACE(
-					TraceLevels::Debug,
-					"%d\n",
-					numContacts);
-
-				btManifoldPoint& pt = contactManifold->getContactPoint(j);
-				if (pt.getDistance()<0.f)
-				{
-					Simd::Vector3 ptA;
-					Simd::Vector3 ptB;
-					Simd::Vector3 normalB;
-
-					ConvertFromBullet( pt.getPositionWorldOnA(), ptA );
-					ConvertFromBullet( pt.getPositionWorldOnB(), ptB );
-					ConvertFromBullet( pt.m_normalWorldOnB, normalB );
-
-					if ( trackACollisions )
-					{
-						HasPhysicalContactsComponent *pContacts = pBodyComponentA->GetOrCreateHasPhysicalContactsComponent();
-						ContactInfo *pInfo = pContacts->CreateContact();
-						pInfo->m_pEntity = pBodyComponentB->GetEntity();
-						pInfo->m_OurPosition = ptA;
-						pInfo->m_TheirPosition = ptB;
-						pInfo->m_Normal = normalB;
-					}
-
-					if ( trackBCollisions )
-					{
-						Simd::Vector3 normalA;
-						normalB.GetNegated( normalA );
-
-						HasPhysicalContactsComponent *pContacts = pBodyComponentB->GetOrCreateHasPhysicalContactsComponent();
-						ContactInfo *pInfo = pContacts->CreateContact();
-						pInfo->m_pEntity = pBodyComponentA->GetEntity();
-						pInfo->m_OurPosition = ptB;
-						pInfo->m_TheirPosition = ptA;
-						pInfo->m_Normal = normalA;
-					}
-				}
+				Simd::Vector3 normalA;
+				normalB.GetNegated( normalA );
+
+				HasPhysicalContactsComponent *pContacts = pBodyComponentB->GetOrCreateHasPhysicalContactsComponent();
+				ContactInfo *pInfo = pContacts->CreateContact();
+				pInfo->m_pEntity = pBodyComponentA->GetEntity();
+				pInfo->m_OurPosition = ptB;
+				pInfo->m_TheirPosition = ptA;
+				pInfo->m_Normal = normalA;
 			}
-#endif
 		}
 	}
+#endif
+}
+
+BulletWorld::BulletWorld()
+	: m_CollisionConfiguration(NULL)
+	, m_Dispatcher(NULL)
+	, m_OverlappingPairCache(NULL)
+	, m_Solver(NULL)
+	, m_SolverPool(NULL)
+	, m_DynamicsWorld(NULL)
+	, m_SharesResources(false)
+	, m_AsyncSimulation(false)
+	, m_FixedTimeStep(0.0f)
+	, m_TimeAccumulator(0.0f)
+	, m_StepStamp(1)
+{
+
 }
 
 void BulletWorld::Initialize(const BulletWorldDefinition &rWorldDefinition)
 {	
-	// collision configuration contains default setup for memory, collision setup. Advanced users can create their own configuration.
-	m_CollisionConfiguration = new btDefaultCollisionConfiguration();
+	m_AsyncSimulation = rWorldDefinition.m_AsyncSimulation && rWorldDefinition.m_FixedTimeStep > 0.0f;
+	m_FixedTimeStep = rWorldDefinition.m_FixedTimeStep;
 
-	// use the default collision dispatcher. For parallel processing you can use a diffent dispatcher (see Extras/BulletMultiThreaded)
-	m_Dispatcher = new btCollisionDispatcher(m_CollisionConfiguration);
+	m_SharesResources = rWorldDefinition.m_ShareResources;
+	if ( m_SharesResources )
+	{
+		AcquireSharedResources();
+		m_CollisionConfiguration = s_SharedResources.m_pCollisionConfiguration;
+	}
+	else
+	{
+		// collision configuration contains default setup for memory, collision setup. Advanced users can create their own configuration.
+		m_CollisionConfiguration = new btDefaultCollisionConfiguration();
+	}
 
 	// btDbvtBroadphase is a good general purpose broadphase. You can also try out btAxis3Sweep.
 	m_OverlappingPairCache = new btDbvtBroadphase();
 
-	// the default constraint solver. For parallel processing you can use a different solver (see Extras/BulletMultiThreaded)
-	m_Solver = new btSequentialImpulseConstraintSolver;
-	
-	m_DynamicsWorld = new btDiscreteDynamicsWorld(
-		m_Dispatcher,
-		m_OverlappingPairCache,
-		m_Solver,
-		m_CollisionConfiguration);
+	m_SolverPool = NULL;
+
+	if ( rWorldDefinition.m_Multithreaded )
+	{
+		// Bullet's task scheduler is global, and every multithreaded world shares the one backed by the job system
+		if ( !s_pTaskScheduler )
+		{
+			s_pTaskScheduler = new BulletJobTaskScheduler();
+			btSetTaskScheduler( s_pTaskScheduler );
+		}
+
+		// narrowphase pairs are processed in parallel batches
+		m_Dispatcher = new btCollisionDispatcherMt(m_CollisionConfiguration);
+
+		// simulation islands are solved in parallel by a pool of solvers, and large islands by a parallel solver
+		if ( m_SharesResources )
+		{
+			m_SolverPool = s_SharedResources.m_pSolverPool;
+		}
+		else
+		{
+			int solverPoolSize = rWorldDefinition.m_SolverPoolSize ? static_cast< int >( rWorldDefinition.m_SolverPoolSize ) : s_pTaskScheduler->getNumThreads();
+			m_SolverPool = new btConstraintSolverPoolMt(Min( solverPoolSize, BT_MAX_THREAD_COUNT ));
+		}
+		m_Solver = new btSequentialImpulseConstraintSolverMt;
+
+		m_DynamicsWorld = new btDiscreteDynamicsWorldMt(
+			m_Dispatcher,
+			m_OverlappingPairCache,
+			m_SolverPool,
+			m_Solver,
+			m_CollisionConfiguration);
+	}
+	else
+	{
+		// use the default collision dispatcher.
+		m_Dispatcher = new btCollisionDispatcher(m_CollisionConfiguration);
+
+		btConstraintSolver *pSolver = NULL;
+		if ( m_SharesResources )
+		{
+			// the pool hands each island to whichever of its solvers is free, so worlds stepping at the same time
+			// never share one solver's scratch memory
+			m_Solver = NULL;
+			pSolver = s_SharedResources.m_pSolverPool;
+		}
+		else
+		{
+			// the default constraint solver.
+			m_Solver = new btSequentialImpulseConstraintSolver;
+			pSolver = m_Solver;
+		}
+
+		m_DynamicsWorld = new btDiscreteDynamicsWorld(
+			m_Dispatcher,
+			m_OverlappingPairCache,
+			pSolver,
+			m_CollisionConfiguration);
+	}
 
 	btVector3 gravity;
 	//ConvertToBullet(pWorldDefinition->m_Gravity, gravity);
@@ -143,10 +304,184 @@ BulletWorld::~BulletWorld()
 	delete m_Solver;
 	delete m_OverlappingPairCache;
 	delete m_Dispatcher;
-	delete m_CollisionConfiguration;
+
+	if ( m_SharesResources )
+	{
+		ReleaseSharedResources();
+	}
+	else
+	{
+		delete m_SolverPool;
+		delete m_CollisionConfiguration;
+	}
 }
 
 void BulletWorld::Simulate( float dt )
 {
-	m_DynamicsWorld->stepSimulation(dt,10);
+	HELIUM_FRAME_PROFILER_SCOPE( "BulletWorld::Simulate" );
+	m_DynamicsWorld->stepSimulation(dt,MAX_SUB_STEPS);
+}
+
+uint32_t BulletWorld::AccumulateTime( float dt, float &rAlpha )
+{
+	HELIUM_ASSERT( m_AsyncSimulation );
+
+	m_TimeAccumulator += dt;
+
+	uint32_t stepCount = static_cast< uint32_t >( m_TimeAccumulator / m_FixedTimeStep );
+	if ( stepCount > static_cast< uint32_t >( MAX_SUB_STEPS ) )
+	{
+		// Drop the time we can't catch up on, like stepSimulation does
+		stepCount = MAX_SUB_STEPS;
+		m_TimeAccumulator = 0.0f;
+	}
+	else
+	{
+		m_TimeAccumulator = Max( m_TimeAccumulator - static_cast< float >( stepCount ) * m_FixedTimeStep, 0.0f );
+	}
+
+	rAlpha = Min( m_TimeAccumulator / m_FixedTimeStep, 1.0f );
+	return stepCount;
+}
+
+void BulletWorld::StepFixed()
+{
+	HELIUM_FRAME_PROFILER_SCOPE( "BulletWorld::StepFixed" );
+
+	// Without substeps bullet takes exactly one step of the given length and hands motion states the exact pose
+	// at the end of it, which is what we interpolate between
+	m_DynamicsWorld->stepSimulation(m_FixedTimeStep, 0);
+}
+
+void BulletWorld::FinishSteps()
+{
+	// Bodies the last batch of steps didn't move have come to rest, so leave them at their final pose
+	size_t keptCount = 0;
+	for ( size_t i = 0; i < m_MovedBodies.GetSize(); ++i )
+	{
+		BulletMotionState *pMotionState = m_MovedBodies[ i ];
+		if ( pMotionState->m_StepStamp == m_StepStamp )
+		{
+			pMotionState->m_MovedIndex = keptCount;
+			m_MovedBodies[ keptCount++ ] = pMotionState;
+			continue;
+		}
+
+		pMotionState->m_PreviousTransform = pMotionState->m_Transform;
+		pMotionState->m_MovedIndex = Invalid< size_t >();
+
+		TransformComponent *pTransform = pMotionState->m_TransformComponent.Get();
+		if ( pTransform )
+		{
+			ConvertFromBullet( pMotionState->m_Transform.getOrigin(), pTransform->ModifyPosition() );
+			ConvertFromBullet( pMotionState->m_Transform.getRotation(), pTransform->ModifyRotation() );
+		}
+	}
+
+	m_MovedBodies.Resize( keptCount );
+
+	Locker< DynamicArray< BulletMotionState * >, SpinLock >::Handle newlyMoved( m_NewlyMovedBodies );
+	for ( size_t i = 0; i < newlyMoved->GetSize(); ++i )
+	{
+		BulletMotionState *pMotionState = ( *newlyMoved )[ i ];
+		pMotionState->m_MovedIndex = m_MovedBodies.GetSize();
+		m_MovedBodies.Push( pMotionState );
+	}
+
+	newlyMoved->Resize( 0 );
+
+	++m_StepStamp;
+}
+
+void BulletWorld::InterpolateMovedBodies( float alpha )
+{
+	for ( size_t i = 0; i < m_MovedBodies.GetSize(); ++i )
+	{
+		const BulletMotionState *pMotionState = m_MovedBodies[ i ];
+
+		TransformComponent *pTransform = const_cast< BulletMotionState * >( pMotionState )->m_TransformComponent.Get();
+		if ( !pTransform )
+		{
+			continue;
+		}
+
+		btVector3 origin = pMotionState->m_PreviousTransform.getOrigin().lerp( pMotionState->m_Transform.getOrigin(), alpha );
+		btQuaternion rotation = pMotionState->m_PreviousTransform.getRotation().slerp( pMotionState->m_Transform.getRotation(), alpha );
+
+		ConvertFromBullet( origin, pTransform->ModifyPosition() );
+		ConvertFromBullet( rotation, pTransform->ModifyRotation() );
+	}
+}
+
+void BulletWorld::NoteMoved( BulletMotionState *pMotionState )
+{
+	if ( pMotionState->m_StepStamp == m_StepStamp )
+	{
+		return;
+	}
+
+	pMotionState->m_StepStamp = m_StepStamp;
+
+	// Bodies already in the moved list only need the stamp. It isn't touched by the main thread while stepping
+	if ( !IsValid( pMotionState->m_MovedIndex ) )
+	{
+		Locker< DynamicArray< BulletMotionState * >, SpinLock >::Handle newlyMoved( m_NewlyMovedBodies );
+		newlyMoved->Push( pMotionState );
+	}
+}
+
+void BulletWorld::ForgetMotionState( BulletMotionState *pMotionState )
+{
+	size_t movedIndex = pMotionState->m_MovedIndex;
+	if ( !IsValid( movedIndex ) )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( m_MovedBodies[ movedIndex ] == pMotionState );
+	m_MovedBodies.RemoveSwap( movedIndex );
+	if ( movedIndex < m_MovedBodies.GetSize() )
+	{
+		m_MovedBodies[ movedIndex ]->m_MovedIndex = movedIndex;
+	}
+
+	pMotionState->m_MovedIndex = Invalid< size_t >();
+}
+
+void BulletWorld::GatherTouchingPairs( DynamicArray< PhysicalContactPair > &rPairs ) const
+{
+	btDispatcher *pDispatcher = m_DynamicsWorld->getDispatcher();
+
+	int numManifolds = pDispatcher->getNumManifolds();
+	for (int i=0;i<numManifolds;i++)
+	{
+		btPersistentManifold* contactManifold = pDispatcher->getManifoldByIndexInternal(i);
+		if ( !contactManifold->getNumContacts() )
+		{
+			continue;
+		}
+
+		const btCollisionObject* obA = static_cast<const btCollisionObject*>(contactManifold->getBody0());
+		const btCollisionObject* obB = static_cast<const btCollisionObject*>(contactManifold->getBody1());
+
+		BulletBodyComponent *pBodyComponentA = static_cast<BulletBodyComponent *>( obA->getUserPointer() );
+		BulletBodyComponent *pBodyComponentB = static_cast<BulletBodyComponent *>( obB->getUserPointer() );
+
+		if ( !pBodyComponentA || !pBodyComponentB )
+		{
+			continue;
+		}
+
+		if ( pBodyComponentA->GetShouldTrackPhysicalContact( pBodyComponentB ) )
+		{
+			PhysicalContactPair pair = { pBodyComponentA, pBodyComponentB->GetEntity() };
+			rPairs.Push( pair );
+		}
+
+		if ( pBodyComponentB->GetShouldTrackPhysicalContact( pBodyComponentA ) )
+		{
+			PhysicalContactPair pair = { pBodyComponentB, pBodyComponentA->GetEntity() };
+			rPairs.Push( pair );
+		}
+	}
 }
@@ -2,12 +2,16 @@
 #pragma once 
 
 #include "Bullet/Bullet.h"
+#include "Bullet/BulletShapeCache.h"
 #include "Math/Vector3.h"
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
 
 class btDefaultCollisionConfiguration;
 class btCollisionDispatcher;
 class btBroadphaseInterface;
-class btSequentialImpulseConstraintSolver;
+class btConstraintSolver;
+class btConstraintSolverPoolMt;
 class btDiscreteDynamicsWorld;
 class btCollisionShape;
 class btDynamicsWorld;
@@ -18,10 +22,13 @@ class btAlignedObjectArray;
 namespace Helium
 {
     class BulletWorldDefinition;
+    struct PhysicalContactPair;
+    struct BulletMotionState;
 
     class HELIUM_BULLET_API BulletWorld
     {
     public:
+        BulletWorld();
         ~BulletWorld();
         
         void Initialize(const BulletWorldDefinition &rWorldDefinition);
@@ -30,12 +37,47 @@ namespace Helium
 
         void Simulate(float dt);
 
+        void GatherTouchingPairs(DynamicArray< PhysicalContactPair > &rPairs) const;
+
+        BulletShapeCache &GetShapeCache() { return m_ShapeCache; }
+
+        // Fixed timestep stepping for worlds that simulate asynchronously. The owner runs the steps on a job and
+        // calls FinishSteps() on the main thread once that job has completed
+        bool IsAsync() const { return m_AsyncSimulation; }
+        uint32_t AccumulateTime(float dt, float &rAlpha);
+        void StepFixed();
+        void FinishSteps();
+
+        // Blends the poses of the last two completed steps into the transforms of every body that is still moving
+        void InterpolateMovedBodies(float alpha);
+
+        // Called by motion states of an asynchronous world while stepping, and when their body is destroyed
+        void NoteMoved(BulletMotionState *pMotionState);
+        void ForgetMotionState(BulletMotionState *pMotionState);
+
     private:
         btDefaultCollisionConfiguration *m_CollisionConfiguration;
 	    btCollisionDispatcher* m_Dispatcher;
 	    btBroadphaseInterface* m_OverlappingPairCache;
-	    btSequentialImpulseConstraintSolver* m_Solver;
+	    btConstraintSolver* m_Solver;
+	    btConstraintSolverPoolMt* m_SolverPool;
         btDynamicsWorld * m_DynamicsWorld;
+
+        // The collision configuration and solver pool belong to every world sharing resources, not to this one
+        bool m_SharesResources;
+
+        bool m_AsyncSimulation;
+        float m_FixedTimeStep;
+        float m_TimeAccumulator;
+
+        // Motion states moved by the last batch of steps, and those first moved by the batch in flight. Every motion
+        // state records the batch that last moved it so bodies that come to rest can be dropped
+        DynamicArray< BulletMotionState * > m_MovedBodies;
+        Locker< DynamicArray< BulletMotionState * >, SpinLock > m_NewlyMovedBodies;
+        uint32_t m_StepStamp;
+
+        // Destroyed after the dynamics world, and so after every body using its shapes
+        BulletShapeCache m_ShapeCache;
     };
     typedef Helium::StrongPtr< BulletWorld > BulletWorldPtr;
 }
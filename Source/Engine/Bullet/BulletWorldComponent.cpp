@@ -4,8 +4,12 @@
 #include "Framework/WorldManager.h"
 #include "Framework/ComponentQuery.h"
 #include "Bullet/HasPhysicalContacts.h"
+#include "Bullet/BulletSceneQuery.h"
+#include "Bullet/BulletDebugDraw.h"
 #include "Framework/Entity.h"
 
+#include <algorithm>
+
 using namespace Helium;
 
 HELIUM_DEFINE_CLASS(Helium::BulletWorldComponentDefinition);
@@ -24,14 +28,27 @@ void Helium::BulletWorldComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 
 Helium::BulletWorldComponent::BulletWorldComponent()
 	: m_World(0)
+	, m_PendingStepCount(0)
+	, m_StepsInFlight(false)
+	, m_ContactsPublished(false)
+	, m_DebugDrawer(0)
 {
 	
 }
 
 Helium::BulletWorldComponent::~BulletWorldComponent()
 {
+	if (m_StepsInFlight)
+	{
+		JobManager::WaitOrReturn( m_StepCounter );
+		m_StepsInFlight = false;
+	}
+
 	delete m_World;
 	m_World = 0;
+
+	delete m_DebugDrawer;
+	m_DebugDrawer = 0;
 }
 
 void Helium::BulletWorldComponent::Initialize( const BulletWorldComponentDefinition &definition )
@@ -42,119 +59,406 @@ void Helium::BulletWorldComponent::Initialize( const BulletWorldComponentDefinit
 	m_World->GetBulletWorld()->setWorldUserInfo(this);
 }
 
+BulletDebugDrawer *Helium::BulletWorldComponent::GetDebugDrawer()
+{
+	if ( !m_DebugDrawer )
+	{
+		m_DebugDrawer = new BulletDebugDrawer( btIDebugDraw::DBG_DrawWireframe /* | btIDebugDraw::DBG_DrawContactPoints */ );
+	}
+
+	return m_DebugDrawer;
+}
+
 void Helium::BulletWorldComponent::Simulate( float dt )
 {
+	if ( m_World->IsAsync() )
+	{
+		SimulateAsync( dt );
+		return;
+	}
+
+	m_TouchedPairs.Resize( 0 );
+	m_EndTouchingPairs.Resize( 0 );
+
 	m_World->Simulate(dt);
+
+	// Manifolds are kept from the last substep that ran, so this is what is touching at the end of the frame even if no
+	// substep ran this frame
+	m_World->GatherTouchingPairs( m_EndTouchingPairs );
+
+	PublishPhysicalContacts();
 }
 
-//////////////////////////////////////////////////////////////////////////
+void Helium::BulletWorldComponent::SimulateAsync( float dt )
+{
+	CompleteSimulation();
 
-void DoProcessPhysics( BulletWorldComponent *pComponent )
+	// No steps completed since last frame, so nothing started or stopped touching
+	if ( !m_ContactsPublished )
+	{
+		RepeatPhysicalContacts();
+	}
+
+	m_ContactsPublished = false;
+
+	// Gameplay sees the last completed steps, one batch behind the steps spawned below
+	float alpha;
+	m_PendingStepCount = m_World->AccumulateTime( dt, alpha );
+	m_World->InterpolateMovedBodies( alpha );
+
+	if ( !m_PendingStepCount )
+	{
+		// Forces only last for the frame they're applied in, as they would if bullet took no substeps
+		size_t keptCount = 0;
+		for ( size_t i = 0; i < m_LatchedCommands.GetSize(); ++i )
+		{
+			if ( m_LatchedCommands[ i ].m_Type != BulletBodyCommand::APPLY_FORCE )
+			{
+				m_LatchedCommands[ keptCount++ ] = m_LatchedCommands[ i ];
+			}
+		}
+
+		m_LatchedCommands.Resize( keptCount );
+		return;
+	}
+
+	m_StepCommands.Swap( m_LatchedCommands );
+	m_TouchedPairs.Resize( 0 );
+	m_EndTouchingPairs.Resize( 0 );
+
+	m_StepsInFlight = true;
+	JobManager::SpawnOrRun( RunStepsCallback, this, m_StepCounter );
+}
+
+void Helium::BulletWorldComponent::RunSteps()
+{
+	for ( uint32_t stepIndex = 0; stepIndex < m_PendingStepCount; ++stepIndex )
+	{
+		// Bullet clears forces after every step
+		for ( size_t i = 0; i < m_StepCommands.GetSize(); ++i )
+		{
+			if ( stepIndex == 0 || m_StepCommands[ i ].m_Type == BulletBodyCommand::APPLY_FORCE )
+			{
+				m_StepCommands[ i ].Apply();
+			}
+		}
+
+		m_World->StepFixed();
+	}
+
+	m_World->GatherTouchingPairs( m_EndTouchingPairs );
+}
+
+void Helium::BulletWorldComponent::RunStepsCallback( void *pJob )
+{
+	static_cast< BulletWorldComponent * >( pJob )->RunSteps();
+}
+
+void Helium::BulletWorldComponent::CompleteSimulation()
+{
+	if ( !m_StepsInFlight )
+	{
+		return;
+	}
+
+	JobManager::WaitOrReturn( m_StepCounter );
+	m_StepsInFlight = false;
+
+	m_StepCommands.Resize( 0 );
+	m_World->FinishSteps();
+
+	// Publish right away so the pairs never outlive bodies destroyed after this
+	PublishPhysicalContacts();
+	m_TouchedPairs.Resize( 0 );
+	m_EndTouchingPairs.Resize( 0 );
+	m_ContactsPublished = true;
+}
+
+bool Helium::BulletWorldComponent::LatchBodyCommand( btRigidBody *pBody, BulletBodyCommand::Type type, const Simd::Vector3 &rVector )
+{
+	if ( !m_World->IsAsync() )
+	{
+		return false;
+	}
+
+	BulletBodyCommand command;
+	command.m_pBody = pBody;
+	command.m_Type = type;
+	command.m_Vector[ 0 ] = rVector.GetElement( 0 );
+	command.m_Vector[ 1 ] = rVector.GetElement( 1 );
+	command.m_Vector[ 2 ] = rVector.GetElement( 2 );
+	m_LatchedCommands.Push( command );
+
+	return true;
+}
+
+void Helium::BulletWorldComponent::ForgetBodyCommands( btRigidBody *pBody )
+{
+	HELIUM_ASSERT( !m_StepsInFlight );
+
+	size_t keptCount = 0;
+	for ( size_t i = 0; i < m_LatchedCommands.GetSize(); ++i )
+	{
+		if ( m_LatchedCommands[ i ].m_pBody != pBody )
+		{
+			m_LatchedCommands[ keptCount++ ] = m_LatchedCommands[ i ];
+		}
+	}
+
+	m_LatchedCommands.Resize( keptCount );
+}
+
+void Helium::BulletBodyCommand::Apply() const
+{
+	btVector3 vector( m_Vector[ 0 ], m_Vector[ 1 ], m_Vector[ 2 ] );
+	m_pBody->activate();
+
+	switch ( m_Type )
+	{
+	case APPLY_FORCE:
+		m_pBody->applyCentralForce( vector );
+		break;
+
+	case SET_VELOCITY:
+		m_pBody->setLinearVelocity( vector );
+		break;
+
+	case SET_ANGULAR_VELOCITY:
+		m_pBody->setAngularVelocity( vector );
+		break;
+
+	default:
+		break;
+	}
+}
+
+void Helium::BulletWorldComponent::AddKinematicBody( BulletBodyComponent *pBody )
+{
+	m_KinematicBodies.Push( pBody );
+}
+
+void Helium::BulletWorldComponent::RemoveKinematicBody( BulletBodyComponent *pBody )
+{
+	for ( size_t i = 0; i < m_KinematicBodies.GetSize(); ++i )
+	{
+		if ( m_KinematicBodies[ i ] == pBody )
+		{
+			m_KinematicBodies.RemoveSwap( i );
+			return;
+		}
+	}
+
+	HELIUM_ASSERT_MSG( false, "BulletWorldComponent::RemoveKinematicBody - Body was never added" );
+}
+
+void Helium::BulletWorldComponent::RunSceneQueries( BulletSceneQueryBatch &rBatch )
+{
+	// Queries must not run while bullet is stepping on another thread
+	CompleteSimulation();
+
+	rBatch.Execute( *m_World->GetBulletWorld() );
+}
+
+void Helium::BulletWorldComponent::GatherTouchedPairs()
+{
+	m_World->GatherTouchingPairs( m_TouchedPairs );
+}
+
+namespace
+{
+	bool EntityLess( const EntityWPtr &rA, const EntityWPtr &rB )
+	{
+		const Entity *pA = rA;
+		const Entity *pB = rB;
+		return pA < pB;
+	}
+
+	// Sorts and removes duplicates without giving up any capacity
+	void SortUnique( DynamicArray<EntityWPtr> &rEntities )
+	{
+		EntityWPtr *pBegin = rEntities.GetData();
+		EntityWPtr *pEnd = pBegin + rEntities.GetSize();
+		std::sort( pBegin, pEnd, EntityLess );
+		rEntities.Resize( static_cast< size_t >( std::unique( pBegin, pEnd ) - pBegin ) );
+	}
+
+	// Pushes everything in rFrom (sorted) that isn't in rExcluding (sorted) to rTo
+	void PushDifference( const DynamicArray<EntityWPtr> &rFrom, const DynamicArray<EntityWPtr> &rExcluding, DynamicArray<EntityWPtr> &rTo )
+	{
+		size_t excludingIndex = 0;
+		size_t excludingCount = rExcluding.GetSize();
+
+		for (size_t fromIndex = 0; fromIndex < rFrom.GetSize(); ++fromIndex)
+		{
+			while (excludingIndex < excludingCount && EntityLess( rExcluding[excludingIndex], rFrom[fromIndex] ))
+			{
+				++excludingIndex;
+			}
+
+			if (excludingIndex == excludingCount || EntityLess( rFrom[fromIndex], rExcluding[excludingIndex] ))
+			{
+				rTo.Push( rFrom[fromIndex] );
+			}
+		}
+	}
+
+	// Walks sorted pairs, skipping duplicates, and looks up each tracking body's contact component once
+	template< class Fn >
+	void ForEachContactPair( const DynamicArray< PhysicalContactPair > &rPairs, Fn fn )
+	{
+		BulletBodyComponent *pLastTracker = NULL;
+		HasPhysicalContactsComponent *pContacts = NULL;
+
+		for (size_t i = 0; i < rPairs.GetSize(); ++i)
+		{
+			const PhysicalContactPair &rPair = rPairs[i];
+			if (i > 0 && rPair == rPairs[i - 1])
+			{
+				continue;
+			}
+
+			if (rPair.m_pTracker != pLastTracker)
+			{
+				pLastTracker = rPair.m_pTracker;
+				pContacts = pLastTracker->GetOrCreateHasPhysicalContactsComponent();
+			}
+
+			fn( pContacts, rPair.m_pOther );
+		}
+	}
+
+	struct PushEverTouched
+	{
+		void operator()( HasPhysicalContactsComponent *pContacts, Entity *pOther ) const
+		{
+			pContacts->m_EverTouchedThisFrame.Push( pOther );
+		}
+	};
+
+	struct PushEndFrameTouching
+	{
+		void operator()( HasPhysicalContactsComponent *pContacts, Entity *pOther ) const
+		{
+			pContacts->m_EndFrameTouching.Push( pOther );
+			pContacts->m_EverTouchedThisFrame.Push( pOther );
+		}
+	};
+}
+
+void Helium::BulletWorldComponent::PublishPhysicalContacts()
 {
-	ComponentManager *pComponentManager = pComponent->GetComponentManager();
+	ComponentManager *pComponentManager = GetComponentManager();
 	HELIUM_ASSERT( pComponentManager );
 
-	// For each HasPhysicalContactsComponent
+	// What was touching at the end of last frame is what was touching as this frame began
 	for (ComponentIteratorT<HasPhysicalContactsComponent> iter( *pComponentManager ); iter.GetBaseComponent(); iter.Advance())
 	{
-		iter->m_BeginFrameTouching.Clear();
-		for (Set<EntityWPtr>::Iterator wptr_iter = iter->m_EndFrameTouching.Begin(); wptr_iter != iter->m_EndFrameTouching.End(); ++wptr_iter)
+		HasPhysicalContactsComponent *pHasPhysicalContacts = *iter;
+
+		pHasPhysicalContacts->m_BeginFrameTouching.Resize( 0 );
+		for (size_t i = 0; i < pHasPhysicalContacts->m_EndFrameTouching.GetSize(); ++i)
 		{
-			Entity *pEntity = *wptr_iter;
+			// Removing destroyed entities keeps the rest in order
+			Entity *pEntity = pHasPhysicalContacts->m_EndFrameTouching[i];
 			if (pEntity)
 			{
-				iter->m_BeginFrameTouching.Insert(pEntity);
+				pHasPhysicalContacts->m_BeginFrameTouching.Push(pEntity);
 			}
 		}
-		iter->m_EverTouchedThisFrame = iter->m_BeginFrameTouching;
-		iter->m_EndFrameTouching.Clear();
+
+		pHasPhysicalContacts->m_EndFrameTouching.Resize( 0 );
+		pHasPhysicalContacts->m_EverTouchedThisFrame.Resize( 0 );
+		pHasPhysicalContacts->m_EverTouchedThisFrame.AddArray(
+			pHasPhysicalContacts->m_BeginFrameTouching.GetData(),
+			pHasPhysicalContacts->m_BeginFrameTouching.GetSize() );
 	}
 
-	WorldManager* pWorldManager = WorldManager::GetInstance();
-	HELIUM_ASSERT( pWorldManager );
+	// Substeps report the same pairs over and over, so sort them and hand each body its contacts once. This allocates
+	// contact components for bodies that just started touching something.
+	std::sort( m_TouchedPairs.GetData(), m_TouchedPairs.GetData() + m_TouchedPairs.GetSize() );
+	std::sort( m_EndTouchingPairs.GetData(), m_EndTouchingPairs.GetData() + m_EndTouchingPairs.GetSize() );
 
-	pComponent->Simulate( pWorldManager->GetFrameDeltaSeconds() );
+	ForEachContactPair( m_TouchedPairs, PushEverTouched() );
+	ForEachContactPair( m_EndTouchingPairs, PushEndFrameTouching() );
 
 	for (ComponentIteratorT<HasPhysicalContactsComponent> iter( *pComponentManager ); iter.GetBaseComponent(); iter.Advance())
 	{
 		// We care about
 		// - BeginTouch = m_EverTouchedThisFrame - m_BeginFrameTouching
-		// - EndTouch = m_EverTouchedThisFrame - m_SubtickTouching
-		// - IsTouching = m_SubtickTouching
-		// - Were we still touching it at end of physics tick? We have what is touching in last subtick in m_SubtickTouching, combine with m_EverTouchedThisFrame to populate m_EndTouch
+		// - EndTouch = m_EverTouchedThisFrame - m_EndFrameTouching
+		// - IsTouching = m_EndFrameTouching
 		//   RATIONALE: Bouncing is important and must not get lost. Untouching a retouching during a frame is generally
 		//   something we don't care about since it would never get rendered. We want BeginTouch, EndTouch, and Touching
 		//   queries.
 		HasPhysicalContactsComponent *pHasPhysicalContacts = *iter;
 
-		pHasPhysicalContacts->m_BeginTouch.Clear();
-		pHasPhysicalContacts->m_EndTouch.Clear();
+		pHasPhysicalContacts->m_BeginTouch.Resize( 0 );
+		pHasPhysicalContacts->m_EndTouch.Resize( 0 );
 
 		if (pHasPhysicalContacts->m_EverTouchedThisFrame.IsEmpty())
 		{
 			// These have to be cleared since we're using deferred delete
 			HELIUM_ASSERT( pHasPhysicalContacts->m_BeginFrameTouching.IsEmpty() );
 			HELIUM_ASSERT( pHasPhysicalContacts->m_EndFrameTouching.IsEmpty() );
-			HELIUM_ASSERT( pHasPhysicalContacts->m_BeginTouch.IsEmpty() );
-			HELIUM_ASSERT( pHasPhysicalContacts->m_EndTouch.IsEmpty() );
-			HELIUM_ASSERT( pHasPhysicalContacts->m_EverTouchedThisFrame.IsEmpty() );
 			pHasPhysicalContacts->FreeComponentDeferred();
 			continue;
 		}
 
-		// TODO: I think there may be an O(n) way to do this if both sets are sorted
-		for (Set<EntityWPtr>::Iterator ever_touched = pHasPhysicalContacts->m_EverTouchedThisFrame.Begin(); ever_touched != pHasPhysicalContacts->m_EverTouchedThisFrame.End(); ++ever_touched)
-		{
-			// For everything that touches in any subtick
-			bool found = false;
+		// m_BeginFrameTouching and m_EndFrameTouching are already sorted and unique
+		SortUnique( pHasPhysicalContacts->m_EverTouchedThisFrame );
 
-			for (Set<EntityWPtr>::Iterator touching = pHasPhysicalContacts->m_BeginFrameTouching.Begin(); touching != pHasPhysicalContacts->m_BeginFrameTouching.End(); ++touching)
-			{
-				// See if it was touching when we started
-				if (*touching == *ever_touched)
-				{
-					found = true;
-					break;
-				}
-			}
+		PushDifference( pHasPhysicalContacts->m_EverTouchedThisFrame, pHasPhysicalContacts->m_BeginFrameTouching, pHasPhysicalContacts->m_BeginTouch );
+		PushDifference( pHasPhysicalContacts->m_EverTouchedThisFrame, pHasPhysicalContacts->m_EndFrameTouching, pHasPhysicalContacts->m_EndTouch );
+	}
+}
 
-			if (!found)
-			{
-				//HELIUM_TRACE(TraceLevels::Debug, "BeginTouch %x -> %x\n", pHasPhysicalContacts->GetOwner(), *ever_touched);
-				// It's in ever touched, and not in touching, so we must have them untouching
-				pHasPhysicalContacts->m_BeginTouch.Push(*ever_touched);
-			}
-		}
+void Helium::BulletWorldComponent::RepeatPhysicalContacts()
+{
+	ComponentManager *pComponentManager = GetComponentManager();
+	HELIUM_ASSERT( pComponentManager );
 
-		// TODO: I think there may be an O(n) way to do this if both sets are sorted
-		for (Set<EntityWPtr>::Iterator ever_touched = pHasPhysicalContacts->m_EverTouchedThisFrame.Begin(); ever_touched != pHasPhysicalContacts->m_EverTouchedThisFrame.End(); ++ever_touched)
-		{
-			// For everything that touches in any subtick
-			bool found = false;
+	// Everything that was touching at the end of the last steps still is
+	for (ComponentIteratorT<HasPhysicalContactsComponent> iter( *pComponentManager ); iter.GetBaseComponent(); iter.Advance())
+	{
+		HasPhysicalContactsComponent *pHasPhysicalContacts = *iter;
 
-			for (Set<EntityWPtr>::Iterator touching = pHasPhysicalContacts->m_EndFrameTouching.Begin(); touching != pHasPhysicalContacts->m_EndFrameTouching.End(); ++touching)
-			{
-				// See if it was still touching at end of last subtick
-				if (*touching == *ever_touched)
-				{
-					found = true;
-					break;
-				}
-			}
+		pHasPhysicalContacts->m_BeginTouch.Resize( 0 );
+		pHasPhysicalContacts->m_EndTouch.Resize( 0 );
+		pHasPhysicalContacts->m_BeginFrameTouching.Resize( 0 );
+		pHasPhysicalContacts->m_EverTouchedThisFrame.Resize( 0 );
 
-			if (!found)
+		size_t keptCount = 0;
+		for (size_t i = 0; i < pHasPhysicalContacts->m_EndFrameTouching.GetSize(); ++i)
+		{
+			Entity *pEntity = pHasPhysicalContacts->m_EndFrameTouching[i];
+			if (pEntity)
 			{
-				//HELIUM_TRACE(TraceLevels::Debug, "EndTouch %x -> %x\n", pHasPhysicalContacts->GetOwner(), *ever_touched);
-				// It's in ever touched, and not in touching, so we must have them untouching
-				pHasPhysicalContacts->m_EndTouch.Push(*ever_touched);
+				pHasPhysicalContacts->m_EndFrameTouching[keptCount++] = pEntity;
+				pHasPhysicalContacts->m_BeginFrameTouching.Push(pEntity);
+				pHasPhysicalContacts->m_EverTouchedThisFrame.Push(pEntity);
 			}
 		}
+
+		pHasPhysicalContacts->m_EndFrameTouching.Resize( keptCount );
 	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void DoProcessPhysics( BulletWorldComponent *pComponent )
+{
+	WorldManager* pWorldManager = WorldManager::GetInstance();
+	HELIUM_ASSERT( pWorldManager );
+
+	pComponent->Simulate( pWorldManager->GetFrameDeltaSeconds() );
 };
 
-HELIUM_DEFINE_TASK( ProcessPhysics, (ForEachWorld< QueryComponents< BulletWorldComponent, DoProcessPhysics > >), TickTypes::Gameplay )
+HELIUM_DEFINE_TASK( ProcessPhysics, (ParallelForEachWorld< QueryComponents< BulletWorldComponent, DoProcessPhysics > >), TickTypes::Gameplay )
 
 void ProcessPhysics::DefineContract( Helium::TaskContract &rContract )
 {
 	rContract.ExecutesWithin<Helium::StandardDependencies::ProcessPhysics>();
+
+	// Every world steps its own bullet world and only reports contacts to its own components
+	rContract.DisjointComponentWrites();
 }
@@ -4,12 +4,38 @@
 #include "Bullet/Bullet.h"
 #include "Bullet/BulletWorld.h"
 #include "Bullet/BulletWorldDefinition.h"
+#include "Bullet/HasPhysicalContacts.h"
+#include "EngineJobs/JobManager.h"
 #include "Framework/ComponentDefinition.h"
 #include "Framework/TaskScheduler.h"
 
+class btRigidBody;
+
 namespace Helium
 {
 	class BulletWorldComponentDefinition;
+	class BulletBodyComponent;
+	class BulletSceneQueryBatch;
+	class BulletDebugDrawer;
+
+	// Change to a body requested while an asynchronous world may be stepping, applied right before the next step.
+	// Forces are applied before every step of the batch, everything else before the first one
+	struct BulletBodyCommand
+	{
+		enum Type
+		{
+			WAKE_UP,
+			APPLY_FORCE,
+			SET_VELOCITY,
+			SET_ANGULAR_VELOCITY
+		};
+
+		btRigidBody *m_pBody;
+		Type m_Type;
+		float32_t m_Vector[ 3 ];
+
+		void Apply() const;
+	};
 
 	class HELIUM_BULLET_API BulletWorldComponent : public Component
 	{
@@ -26,11 +52,58 @@ namespace Helium
 
 		BulletWorld *GetBulletWorld() { return m_World; }
 
+		// Called by bullet after each internal substep
+		void GatherTouchedPairs();
+
+		void PublishPhysicalContacts();
+
+		// Waits for the steps in flight, if any, and publishes their results. Anything touching bullet bodies outside
+		// of the physics tasks must call this first
+		void CompleteSimulation();
+
+		// Returns false if the world steps synchronously, in which case the caller should apply the change directly
+		bool LatchBodyCommand( btRigidBody *pBody, BulletBodyCommand::Type type, const Simd::Vector3 &rVector = Simd::Vector3::Zero );
+		void ForgetBodyCommands( btRigidBody *pBody );
+
+		// Kinematic bodies are driven by their transforms, so they are kept apart to be pushed to bullet in one pass
+		void AddKinematicBody( BulletBodyComponent *pBody );
+		void RemoveKinematicBody( BulletBodyComponent *pBody );
+		const DynamicArray< BulletBodyComponent * > &GetKinematicBodies() const { return m_KinematicBodies; }
+
+		// Runs every query in the batch at once, spread across job threads. Waits for an asynchronous step first, so
+		// gather a frame's queries into one batch rather than running many small ones
+		void RunSceneQueries( BulletSceneQueryBatch &rBatch );
+
+		// Created on first use and kept so its line buffer and sphere geometry are reused by every debug draw
+		BulletDebugDrawer *GetDebugDrawer();
+
 	private:
+		void SimulateAsync( float dt );
+		void RepeatPhysicalContacts();
+		void RunSteps();
+		static void RunStepsCallback( void *pJob );
 		
 		// I would love to use an auto_ptr here but microsoft's compiler breaks when I try to do that. 
 		// http://www.youtube.com/watch?v=1ytCEuuW2_A
 		BulletWorld *m_World;
+
+		// Everything tracked touched during any substep of this frame, and what is still touching after the last one.
+		// Both keep their capacity from frame to frame.
+		DynamicArray< PhysicalContactPair > m_TouchedPairs;
+		DynamicArray< PhysicalContactPair > m_EndTouchingPairs;
+
+		DynamicArray< BulletBodyComponent * > m_KinematicBodies;
+
+		// Asynchronous stepping. Commands latched by gameplay wait in m_LatchedCommands, and move to m_StepCommands when
+		// the steps they apply to are spawned
+		DynamicArray< BulletBodyCommand > m_LatchedCommands;
+		DynamicArray< BulletBodyCommand > m_StepCommands;
+		JobCounter m_StepCounter;
+		uint32_t m_PendingStepCount;
+		bool m_StepsInFlight;
+		bool m_ContactsPublished;
+
+		BulletDebugDrawer *m_DebugDrawer;
 	};
 
 	class HELIUM_BULLET_API BulletWorldComponentDefinition : public Helium::ComponentDefinitionHelper<BulletWorldComponent, BulletWorldComponentDefinition>
@@ -49,3 +122,5 @@ namespace Helium
 		virtual void DefineContract(Helium::TaskContract &rContract);
 	};
 }
+
+HELIUM_CACHE_COMPONENT_SLOT( Helium::BulletWorldComponent, 2 )
@@ -6,7 +6,23 @@ using namespace Helium;
 
 HELIUM_DEFINE_BASE_STRUCT(Helium::BulletWorldDefinition);
 
+BulletWorldDefinition::BulletWorldDefinition()
+: m_Gravity( 0.0f )
+, m_Multithreaded( false )
+, m_SolverPoolSize( 0 )
+, m_AsyncSimulation( false )
+, m_FixedTimeStep( 1.0f / 60.0f )
+, m_ShareResources( false )
+{
+
+}
+
 void BulletWorldDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
 {
     comp.AddField(&BulletWorldDefinition::m_Gravity, "m_Gravity" );
+    comp.AddField(&BulletWorldDefinition::m_Multithreaded, "m_Multithreaded" );
+    comp.AddField(&BulletWorldDefinition::m_SolverPoolSize, "m_SolverPoolSize" );
+    comp.AddField(&BulletWorldDefinition::m_AsyncSimulation, "m_AsyncSimulation" );
+    comp.AddField(&BulletWorldDefinition::m_FixedTimeStep, "m_FixedTimeStep" );
+    comp.AddField(&BulletWorldDefinition::m_ShareResources, "m_ShareResources" );
 }
@@ -14,6 +14,27 @@ namespace Helium
         HELIUM_DECLARE_BASE_STRUCT(Helium::BulletWorldDefinition);
         static void PopulateMetaType( Reflect::MetaStruct& comp );
 
+        BulletWorldDefinition();
+
         Helium::Simd::Vector3 m_Gravity;
+
+        // Run the narrowphase, island solving and integration across the engine's job threads using Bullet's
+        // multithreaded dispatcher and solver pool. Only worth it for scenes with many active bodies
+        bool m_Multithreaded;
+
+        // Number of constraint solvers in the pool used when multithreaded (0 for one per job thread)
+        uint32_t m_SolverPoolSize;
+
+        // Step on a job at a fixed rate, overlapping with the rest of the frame. Transforms are blended from the last
+        // two completed steps and contacts are reported a frame later than when stepping synchronously
+        bool m_AsyncSimulation;
+
+        // Length of one step in seconds when simulating asynchronously
+        float m_FixedTimeStep;
+
+        // Use the collision configuration (and with it the pooled allocators for contact manifolds and collision
+        // algorithms) and pool of constraint solvers that every other world setting this shares, instead of creating
+        // its own. Cuts the fixed cost of each world when a process hosts many small ones
+        bool m_ShareResources;
     };
 }
@@ -15,6 +15,26 @@ namespace Helium
 		Entity *m_pEntity;
 	};
 
+	class BulletBodyComponent;
+
+	// A body that tracks contacts and an entity it touched. Pairs are gathered into a flat buffer while simulating and
+	// sorted once per frame so that every body's contacts end up next to each other, in the order of the touched entity.
+	struct PhysicalContactPair
+	{
+		BulletBodyComponent *m_pTracker;
+		Entity *m_pOther;
+
+		bool operator<( const PhysicalContactPair &rhs ) const
+		{
+			return m_pTracker < rhs.m_pTracker || ( m_pTracker == rhs.m_pTracker && m_pOther < rhs.m_pOther );
+		}
+
+		bool operator==( const PhysicalContactPair &rhs ) const
+		{
+			return m_pTracker == rhs.m_pTracker && m_pOther == rhs.m_pOther;
+		}
+	};
+
 	struct HELIUM_BULLET_API HasPhysicalContactsComponent : public Component
 	{
 		HELIUM_DECLARE_COMPONENT( Helium::HasPhysicalContactsComponent, Helium::Component );
@@ -22,15 +42,14 @@ namespace Helium
 
 		~HasPhysicalContactsComponent();
 
-		// TODO: There's a lot of dynamic allocation here.. maybe there's a clever way we could just have a wad of Entity* or some shorter
-		// handle used as a ringbuffer? BeginFrameTouching, then intermediate ticks, then EndFrameTouching? EndFrameTouching would be 
-		// BeginFrameTouching on next frame.
+		// Published once per frame by ProcessPhysics
 		DynamicArray<EntityWPtr> m_BeginTouch;
 		DynamicArray<EntityWPtr> m_EndTouch;
 
-		// Assuming that using fields, these will be small lists
-		Set<EntityWPtr> m_BeginFrameTouching;
-		Set<EntityWPtr> m_EndFrameTouching;
-		Set<EntityWPtr> m_EverTouchedThisFrame;
+		// All of these are sorted by entity address so that they can be compared in a single pass. They are resized rather
+		// than freed each frame, so once they have grown to fit a body's contacts tracking them no longer allocates.
+		DynamicArray<EntityWPtr> m_BeginFrameTouching;
+		DynamicArray<EntityWPtr> m_EndFrameTouching;
+		DynamicArray<EntityWPtr> m_EverTouchedThisFrame;
 	};
 }
@@ -0,0 +1,112 @@
+#include "Precompile.h"
+#include "Components/FlagsComponent.h"
+
+#include "Engine/FrameArena.h"
+#include "Framework/World.h"
+#include "Reflect/TranslatorDeduction.h"
+
+HELIUM_DEFINE_COMPONENT(Helium::FlagsComponent, 128);
+
+using namespace Helium;
+
+void Helium::FlagsComponent::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+}
+
+void Helium::FlagsComponent::DeclareStreams( Components::StreamList& rStreams )
+{
+	// Must be added in the order of the Streams enum
+	rStreams.Add< FlagMask >();
+}
+
+void Helium::FlagsComponent::Initialize( const FlagsComponentDefinition &definition )
+{
+	definition.CacheFlags();
+	SetFlags( definition.m_InitialMask );
+}
+
+size_t Helium::FlagsComponent::FindMatching( World *pWorld, FlagMask required, FlagMask excluded, DynamicArray< FlagsComponent * > &rResults )
+{
+	HELIUM_ASSERT( pWorld );
+
+	ComponentManager *pComponentManager = pWorld->GetComponentManager();
+	HELIUM_ASSERT( pComponentManager );
+
+	const size_t startSize = rResults.GetSize();
+	DynamicArray< uint32_t, FrameAllocator > matches;
+
+	const DynamicArray< Components::TypeId > &implementingTypes = Components::GetTypeData( Components::GetType< FlagsComponent >() )->m_ImplementingTypes;
+	for ( DynamicArray< Components::TypeId >::ConstIterator iter = implementingTypes.Begin(); iter != implementingTypes.End(); ++iter )
+	{
+		const Components::Pool *pPool = pComponentManager->GetPool( *iter );
+		if ( !pPool || !pPool->GetAllocatedCount() )
+		{
+			continue;
+		}
+
+		const Components::ComponentIndex allocatedCount = pPool->GetAllocatedCount();
+		matches.Resize( allocatedCount );
+
+		const size_t matchCount = FindMatchingFlags(
+			pPool->GetStream< FlagMask >( STREAM_FLAGS ),
+			allocatedCount,
+			required,
+			excluded,
+			matches.GetData() );
+
+		rResults.Reserve( rResults.GetSize() + matchCount );
+		for ( size_t matchIndex = 0; matchIndex < matchCount; ++matchIndex )
+		{
+			rResults.Push( static_cast< FlagsComponent * >( pPool->GetComponentByRosterIndex( static_cast< Components::ComponentIndex >( matches[ matchIndex ] ) ) ) );
+		}
+	}
+
+	return rResults.GetSize() - startSize;
+}
+
+HELIUM_DEFINE_CLASS(Helium::FlagsComponentDefinition);
+
+void Helium::FlagsComponentDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+	comp.AddField(&FlagsComponentDefinition::m_FlagSet, "m_FlagSet");
+	comp.AddField(&FlagsComponentDefinition::m_InitialFlags, "m_InitialFlags");
+}
+
+FlagsComponentDefinition::FlagsComponentDefinition()
+	: m_InitialMask( 0 )
+	, m_FlagsCached( false )
+{
+
+}
+
+void Helium::FlagsComponentDefinition::FinalizeLoad()
+{
+	m_InitialMask = 0;
+	m_FlagsCached = false;
+}
+
+void Helium::FlagsComponentDefinition::CacheFlags() const
+{
+	if ( m_FlagsCached )
+	{
+		return;
+	}
+
+	m_InitialMask = 0;
+	if ( !m_InitialFlags.IsEmpty() )
+	{
+		if ( !m_FlagSet )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"FlagsComponentDefinition::CacheFlags - Definition has values in m_InitialFlags, but no FlagSetDefinition is set in m_FlagSet\n" );
+		}
+		else
+		{
+			// Warns about any flag missing from the flag set
+			m_FlagSet->GetBitset( m_InitialFlags, m_InitialMask );
+		}
+	}
+
+	m_FlagsCached = true;
+}
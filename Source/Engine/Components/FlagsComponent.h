@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Components/Components.h"
+#include "Foundation/DynamicArray.h"
+#include "Framework/ComponentDefinition.h"
+#include "Framework/FlagSet.h"
+
+namespace Helium
+{
+	class FlagsComponentDefinition;
+
+	// Gameplay flags of an entity, as a bitmask of the flags in a FlagSetDefinition. Flag names are only looked up when
+	// the first component is made from a definition; tests are bitwise operations on masks resolved ahead of time
+	// with FlagSetDefinition::GetBitset(). The flags are kept in a stream of the pool so FindMatching() can test every
+	// entity of a world over packed words
+	class HELIUM_COMPONENTS_API FlagsComponent : public Component
+	{
+		HELIUM_DECLARE_COMPONENT( Helium::FlagsComponent, Helium::Component );
+		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+		enum Streams
+		{
+			STREAM_FLAGS,
+		};
+		static void DeclareStreams( Components::StreamList& rStreams );
+
+		void Initialize( const FlagsComponentDefinition &definition );
+
+		inline FlagMask GetFlags() const { return GetStreamElement< FlagMask >( STREAM_FLAGS ); }
+		inline void SetFlags( FlagMask flags ) { GetStreamElement< FlagMask >( STREAM_FLAGS ) = flags; }
+		inline void AddFlags( FlagMask flags ) { GetStreamElement< FlagMask >( STREAM_FLAGS ) |= flags; }
+		inline void RemoveFlags( FlagMask flags ) { GetStreamElement< FlagMask >( STREAM_FLAGS ) &= ~flags; }
+
+		inline bool HasAll( FlagMask flags ) const { return ( GetFlags() & flags ) == flags; }
+		inline bool HasAny( FlagMask flags ) const { return ( GetFlags() & flags ) != 0; }
+		inline bool Matches( FlagMask required, FlagMask excluded ) const { return FlagsMatch( GetFlags(), required, excluded ); }
+
+		// Append every flags component of the world with all the required flags and none of the excluded ones to
+		// rResults, returning the number added
+		static size_t FindMatching( World *pWorld, FlagMask required, FlagMask excluded, DynamicArray< FlagsComponent * > &rResults );
+	};
+
+	class HELIUM_COMPONENTS_API FlagsComponentDefinition : public Helium::ComponentDefinitionHelper<FlagsComponent, FlagsComponentDefinition>
+	{
+		HELIUM_DECLARE_CLASS( Helium::FlagsComponentDefinition, Helium::ComponentDefinition );
+		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+		FlagsComponentDefinition();
+
+		FlagSetDefinitionPtr m_FlagSet;
+		DynamicArray< Name > m_InitialFlags;
+
+		// m_InitialFlags as a bitmask. Resolved when the first component is made, since the flag set may not be
+		// finalized yet when this definition is
+		void CacheFlags() const;
+		virtual void FinalizeLoad();
+
+		mutable FlagMask m_InitialMask;
+		mutable bool m_FlagsCached;
+	};
+	typedef StrongPtr<FlagsComponentDefinition> FlagsComponentDefinitionPtr;
+}
@@ -7,6 +7,7 @@
 #include "Graphics/GraphicsScene.h"
 #include "Graphics/RenderResourceManager.h"
 #include "GraphicsTypes/VertexTypes.h"
+#include "MathSimd/VectorConversion.h"
 #include "Reflect/TranslatorDeduction.h"
 #include "Rendering/RVertexDescription.h"
 
@@ -24,6 +25,9 @@ void MeshComponent::Initialize( const MeshComponentDefinition& definition )
 	{
 		m_Mesh = definition.m_Mesh;
 	}
+
+	m_OccluderBounds = definition.m_OccluderBounds;
+	m_IsOccluder = definition.m_IsOccluder;
 }
 
 void MeshComponent::Finalize( const MeshComponentDefinition& definition )
@@ -45,15 +49,23 @@ void MeshComponent::Finalize( const MeshComponentDefinition& definition )
 
 HELIUM_DEFINE_CLASS(Helium::MeshComponentDefinition);
 
+MeshComponentDefinition::MeshComponentDefinition()
+: m_IsOccluder( false )
+{
+}
+
 void MeshComponentDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
 {
 	comp.AddField(&MeshComponentDefinition::m_Mesh, "m_Mesh");
 	comp.AddField(&MeshComponentDefinition::m_OverrideMaterials, "m_OverrideMaterials");
+	comp.AddField(&MeshComponentDefinition::m_OccluderBounds, "m_OccluderBounds");
+	comp.AddField(&MeshComponentDefinition::m_IsOccluder, "m_IsOccluder");
 }
 
 /// Constructor.
 MeshComponent::MeshComponent()
-: m_graphicsSceneObjectId( Invalid< size_t >() )
+: m_IsOccluder( false )
+, m_graphicsSceneObjectId( Invalid< size_t >() )
 {
 }
 
@@ -179,17 +191,14 @@ void MeshComponent::GraphicsSceneObjectUpdate(
 	HELIUM_ASSERT( pScene );
 	HELIUM_ASSERT( pSceneObject );
 	
-	const Simd::Vector3& rPosition = pTransform->GetPosition();
-	Simd::Matrix44 transform(
-		Simd::Matrix44::INIT_ROTATION_TRANSLATION,
-		pTransform->GetRotation(),
-		rPosition);
-	transform.ScaleLocal( pTransform->GetScale() );
+	// The world transform was already composed (along with any parent transforms) by UpdateTransformComponentsTask
+	const Simd::Matrix44& transform = pTransform->GetWorldTransform();
 	pSceneObject->SetTransform( transform );
 
 	Mesh* pMesh = pThis->m_Mesh;
 
-	Simd::AaBox worldBounds( rPosition, rPosition );
+	Simd::Vector3 position = Simd::Vector4ToVector3( transform.GetRow( 3 ) );
+	Simd::AaBox worldBounds( position, position );
 
 	// Only thing remaining if this is a transform-only update is the world bounds, so update it and return.
 	if( pSceneObject->GetUpdateMode() == GraphicsSceneObject::UPDATE_TRANSFORM_ONLY )
@@ -217,6 +226,7 @@ void MeshComponent::GraphicsSceneObjectUpdate(
 	}
 
 	pSceneObject->SetWorldBounds( worldBounds );
+	pSceneObject->SetOccluderBox( pThis->m_IsOccluder ? &pThis->m_OccluderBounds : NULL );
 
 	const DynamicArray< size_t >& rSubMeshDataIds = pThis->m_graphicsSceneObjectSubMeshDataIds;
 	size_t subMeshCount = rSubMeshDataIds.GetSize();
@@ -226,6 +236,7 @@ void MeshComponent::GraphicsSceneObjectUpdate(
 	{
 		pSceneObject->SetVertexData( NULL, NULL, 0 );
 		pSceneObject->SetIndexBuffer( NULL );
+		pSceneObject->SetLodScreenSizes( NULL, 1 );
 	}
 	else
 	{
@@ -247,6 +258,7 @@ void MeshComponent::GraphicsSceneObjectUpdate(
 
 		pSceneObject->SetVertexData( pVertexBuffer, pVertexDescription, vertexStride );
 		pSceneObject->SetIndexBuffer( pIndexBuffer );
+		pSceneObject->SetLodScreenSizes( pMesh->GetLodScreenSizes(), pMesh->GetLodCount() );
 
 		meshSectionCount = pMesh->GetSectionCount();
 		if( meshSectionCount > subMeshCount )
@@ -254,6 +266,9 @@ void MeshComponent::GraphicsSceneObjectUpdate(
 			meshSectionCount = subMeshCount;
 		}
 
+		// Sections of static meshes with more than one section are culled individually using their cached bounds.
+		bool bCullSections = ( meshSectionCount > 1 && !pMesh->IsSkinned() );
+
 		uint32_t sectionVertexOffset = 0;
 		uint32_t sectionIndexOffset = 0;
 		for( size_t meshSectionIndex = 0; meshSectionIndex < meshSectionCount; ++meshSectionIndex )
@@ -265,12 +280,20 @@ void MeshComponent::GraphicsSceneObjectUpdate(
 			uint32_t vertexCount = pMesh->GetSectionVertexCount( meshSectionIndex );
 			uint32_t triangleCount = pMesh->GetSectionTriangleCount( meshSectionIndex );
 
-			pSubMeshData->SetMaterial( pThis->GetMaterial( meshSectionIndex ) );
+			Material* pMaterial = pThis->GetMaterial( meshSectionIndex );
+			if( pMaterial )
+			{
+				pMaterial->PrecacheVertexInputLayouts( pVertexDescription );
+			}
+
+			pSubMeshData->SetMaterial( pMaterial );
 			pSubMeshData->SetPrimitiveType( RENDERER_PRIMITIVE_TYPE_TRIANGLE_LIST );
 			pSubMeshData->SetPrimitiveCount( triangleCount );
 			pSubMeshData->SetStartVertex( sectionVertexOffset );
 			pSubMeshData->SetVertexRange( vertexCount );
 			pSubMeshData->SetStartIndex( sectionIndexOffset );
+			pSubMeshData->SetLocalBounds( bCullSections ? pMesh->GetSectionBounds( meshSectionIndex ) : NULL );
+			pSubMeshData->SetLodIndexRanges( pMesh->GetSectionLodIndexRanges( meshSectionIndex ) );
 
 			sectionVertexOffset += vertexCount;
 			sectionIndexOffset += triangleCount * 3;
@@ -289,6 +312,8 @@ void MeshComponent::GraphicsSceneObjectUpdate(
 		pSubMeshData->SetStartVertex( 0 );
 		pSubMeshData->SetVertexRange( 0 );
 		pSubMeshData->SetStartIndex( 0 );
+		pSubMeshData->SetLocalBounds( NULL );
+		pSubMeshData->SetLodIndexRanges( NULL );
 	}
 }
 
@@ -369,6 +394,10 @@ void Helium::UpdateMeshComponentsTask::DefineContract( TaskContract &rContract )
 {
 	rContract.ExecuteBefore<StandardDependencies::Render>();
 	rContract.ExecuteAfter<StandardDependencies::ProcessPhysics>();
+	rContract.ExecuteAfter<UpdateTransformComponentsTask>();
+
+	// The graphics scene being updated is handed to the query callback through a static
+	rContract.EngineGlobal();
 }
 
 HELIUM_DEFINE_TASK( UpdateMeshComponentsTask, (ForEachWorld< UpdateMeshComponents >), TickTypes::Render );
@@ -63,6 +63,10 @@ namespace Helium
 		StrongPtr< Mesh > m_Mesh;
 		/// Override material set.
 		DynamicArray< MaterialPtr > m_OverrideMaterials;
+		/// Occluder box in local space (only used if m_IsOccluder is set).
+		Simd::AaBox m_OccluderBounds;
+		/// True if this mesh occludes other objects behind its occluder box.
+		bool m_IsOccluder;
 
 		/// ID of the scene object representing this entity in the graphics scene.
 		size_t m_graphicsSceneObjectId;
@@ -89,9 +93,15 @@ namespace Helium
 	public:
 		HELIUM_DECLARE_CLASS( Helium::MeshComponentDefinition, Helium::ComponentDefinition );
 		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+		MeshComponentDefinition();
 				
 		StrongPtr<Mesh> m_Mesh;
 		DynamicArray< MaterialPtr > m_OverrideMaterials;
+		/// Occluder box in local space, which must lie entirely inside of the solid geometry of the mesh.
+		Simd::AaBox m_OccluderBounds;
+		/// True if the mesh occludes other objects behind m_OccluderBounds.
+		bool m_IsOccluder;
 	};
 	typedef StrongPtr<MeshComponentDefinition> MeshComponentDefinitionPtr;
 	
@@ -0,0 +1,487 @@
+#include "Platform/Timer.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/MemoryStream.h"
+#include "Foundation/String.h"
+#include "Reflect/Registry.h"
+#include "Reflect/TranslatorDeduction.h"
+#include "Persist/ArchiveBson.h"
+#include "Persist/ArchiveJson.h"
+#include "Persist/ArchiveMessagePack.h"
+
+#include "Engine/AssetLoader.h"
+#include "Graphics/Material.h"
+#include "Graphics/Mesh.h"
+#include "Components/MeshComponent.h"
+#include "Components/RotateComponent.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace Helium;
+
+// Throughput benchmarks for the Persist archive formats.
+//
+// Each payload is a reflected object shaped like what the engine actually saves and caches: the persistent resource
+// data of a skinned mesh and of a material, component definitions, and an object made of large arrays. Every payload
+// is round-tripped through each archive format. Results are written to standard output as one JSON object per line:
+//
+//     {"benchmark":"Mesh::PersistentResourceData","format":"json","bytes":...,"write_mb_per_sec":...,"read_mb_per_sec":...,"write_allocations_per_object":...,"read_allocations_per_object":...,"peak_bytes":...}
+//
+// Throughput is measured against the size of the archive data in that format, so the formats are also compared by
+// "bytes". Allocations are counted at the C runtime allocator; modules built with their own heaps (HELIUM_HEAP)
+// allocate from those instead, so only compare counts between runs of the same build. Peak memory is the growth of the
+// resident set over one cold write and read of the payload. Both are null where the platform does not expose them.
+//
+// Pass a substring as the first argument to run only the benchmarks whose "<payload>/<format>" name contains it.
+
+// Minimum time to spend measuring each of writing and reading a payload in a format, in seconds
+static const float64_t MIN_BENCHMARK_SECONDS = 0.25;
+
+// Number of elements in each of the arrays of the large array payload
+static const size_t LARGE_ARRAY_SIZE = 256 * 1024;
+
+#if HELIUM_OS_LINUX && defined( __GLIBC__ )
+
+#define HELIUM_BENCHMARK_COUNT_ALLOCATIONS 1
+
+// Count allocations by interposing the C runtime allocator entry points. The benchmark is single threaded, so the
+// counter needs no synchronization
+static uint64_t s_AllocationCount = 0;
+
+extern "C"
+{
+	void* __libc_malloc( size_t size );
+	void* __libc_calloc( size_t count, size_t size );
+	void* __libc_realloc( void* pMemory, size_t size );
+	void* __libc_memalign( size_t alignment, size_t size );
+	void __libc_free( void* pMemory );
+
+	void* malloc( size_t size )
+	{
+		++s_AllocationCount;
+		return __libc_malloc( size );
+	}
+
+	void* calloc( size_t count, size_t size )
+	{
+		++s_AllocationCount;
+		return __libc_calloc( count, size );
+	}
+
+	void* realloc( void* pMemory, size_t size )
+	{
+		++s_AllocationCount;
+		return __libc_realloc( pMemory, size );
+	}
+
+	void* memalign( size_t alignment, size_t size )
+	{
+		++s_AllocationCount;
+		return __libc_memalign( alignment, size );
+	}
+
+	void* aligned_alloc( size_t alignment, size_t size )
+	{
+		++s_AllocationCount;
+		return __libc_memalign( alignment, size );
+	}
+
+	int posix_memalign( void** ppMemory, size_t alignment, size_t size )
+	{
+		++s_AllocationCount;
+		void* pMemory = __libc_memalign( alignment, size );
+		if ( !pMemory )
+		{
+			return ENOMEM;
+		}
+
+		*ppMemory = pMemory;
+		return 0;
+	}
+
+	void free( void* pMemory )
+	{
+		__libc_free( pMemory );
+	}
+}
+
+#else
+
+#define HELIUM_BENCHMARK_COUNT_ALLOCATIONS 0
+
+#endif
+
+namespace Helium
+{
+	// Payload standing in for bulk data such as vertex streams, animation tracks and baked lookup tables
+	struct BenchmarkLargeArrays : public Reflect::Object
+	{
+		HELIUM_DECLARE_CLASS( Helium::BenchmarkLargeArrays, Reflect::Object );
+		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+		DynamicArray< float32_t > m_Floats;
+		DynamicArray< uint32_t > m_Indices;
+		DynamicArray< uint8_t > m_Bytes;
+	};
+}
+
+HELIUM_DEFINE_CLASS( Helium::BenchmarkLargeArrays );
+
+void BenchmarkLargeArrays::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+	comp.AddField( &BenchmarkLargeArrays::m_Floats,  "m_Floats" );
+	comp.AddField( &BenchmarkLargeArrays::m_Indices, "m_Indices" );
+	comp.AddField( &BenchmarkLargeArrays::m_Bytes,   "m_Bytes" );
+}
+
+// Payload factory
+typedef Reflect::ObjectPtr ( *CREATE_PAYLOAD_CALLBACK )();
+
+// Archive format callbacks
+typedef void ( *WRITE_CALLBACK )( Reflect::Object* pObject, DynamicArray< uint8_t >& rBuffer );
+typedef void ( *READ_CALLBACK )( const DynamicArray< uint8_t >& rBuffer, Reflect::ObjectPtr& rspObject );
+
+struct PayloadEntry
+{
+	const char*             pName;
+	CREATE_PAYLOAD_CALLBACK pCreate;
+};
+
+struct FormatEntry
+{
+	const char*    pName;
+	WRITE_CALLBACK pWrite;
+	READ_CALLBACK  pRead;
+};
+
+// Get a deterministic pseudo-random value in the range [0, 1)
+static float32_t GetRandomUnit( uint32_t &rSeed )
+{
+	rSeed = rSeed * 1664525 + 1013904223;
+
+	return static_cast< float32_t >( rSeed >> 8 ) / static_cast< float32_t >( 1 << 24 );
+}
+
+// Skinned mesh with a few sections, levels of detail and a full skeleton
+static Reflect::ObjectPtr CreateMeshPayload()
+{
+	const size_t sectionCount = 8;
+	const size_t lodCount = 3;
+	const size_t boneCount = 64;
+
+	StrongPtr< Mesh::PersistentResourceData > spData( new Mesh::PersistentResourceData() );
+
+	uint32_t seed = 1;
+	for ( size_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex )
+	{
+		spData->m_sectionVertexCounts.Push( static_cast< uint16_t >( 2000 + sectionIndex * 100 ) );
+		spData->m_sectionTriangleCounts.Push( static_cast< uint32_t >( 3000 + sectionIndex * 150 ) );
+
+		Simd::Vector3 minimum( -GetRandomUnit( seed ), -GetRandomUnit( seed ), -GetRandomUnit( seed ) );
+		Simd::Vector3 maximum( GetRandomUnit( seed ), GetRandomUnit( seed ), GetRandomUnit( seed ) );
+		spData->m_sectionBounds.Push( Simd::AaBox( minimum, maximum ) );
+	}
+
+	for ( size_t paletteIndex = 0; paletteIndex < sectionCount * 32; ++paletteIndex )
+	{
+		spData->m_skinningPaletteMap.Push( static_cast< uint8_t >( paletteIndex % boneCount ) );
+	}
+
+	spData->m_vertexCount = 20000;
+	spData->m_triangleCount = 30000;
+	spData->m_bounds = Simd::AaBox( Simd::Vector3( -1.0f, -1.0f, -1.0f ), Simd::Vector3( 1.0f, 1.0f, 1.0f ) );
+
+	float32_t screenSize = 0.5f;
+	for ( size_t lodIndex = 0; lodIndex < lodCount; ++lodIndex )
+	{
+		spData->m_lodScreenSizes.Push( screenSize );
+		screenSize *= 0.5f;
+
+		for ( size_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex )
+		{
+			spData->m_lodSectionTriangleCounts.Push( static_cast< uint32_t >( 1500 >> lodIndex ) );
+		}
+	}
+
+#if !HELIUM_USE_GRANNY_ANIMATION
+	spData->m_boneCount = static_cast< uint8_t >( boneCount );
+	for ( size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex )
+	{
+		String boneName;
+		boneName.Format( "Bone%02u", static_cast< unsigned int >( boneIndex ) );
+
+		spData->m_pBoneNames.Push( Name( boneName.GetData() ) );
+		spData->m_pParentBoneIndices.Push( static_cast< uint8_t >( boneIndex == 0 ? 0xff : ( boneIndex - 1 ) / 2 ) );
+		spData->m_pReferencePose.Push( Simd::Matrix44(
+			Simd::Matrix44::INIT_ROTATION_TRANSLATION,
+			Simd::Quat::IDENTITY,
+			Simd::Vector3( GetRandomUnit( seed ), GetRandomUnit( seed ), GetRandomUnit( seed ) ) ) );
+	}
+#endif
+
+	return spData.Get();
+}
+
+static Reflect::ObjectPtr CreateMaterialPayload()
+{
+	StrongPtr< Material::PersistentResourceData > spData( new Material::PersistentResourceData() );
+	for ( size_t typeIndex = 0; typeIndex < HELIUM_ARRAY_COUNT( spData->m_shaderVariantIndices ); ++typeIndex )
+	{
+		spData->m_shaderVariantIndices[ typeIndex ] = static_cast< uint32_t >( 17 + typeIndex );
+	}
+
+	return spData.Get();
+}
+
+static Reflect::ObjectPtr CreateRotateDefinitionPayload()
+{
+	StrongPtr< RotateComponentDefinition > spDefinition( new RotateComponentDefinition() );
+	spDefinition->m_RotationPerSecond = Simd::Quat::IDENTITY;
+	spDefinition->m_Roll = 0.25f;
+	spDefinition->m_Pitch = 0.5f;
+	spDefinition->m_Yaw = 1.0f;
+
+	return spDefinition.Get();
+}
+
+// Mesh component definition; asset references are left null as they would need the asset loader to resolve
+static Reflect::ObjectPtr CreateMeshDefinitionPayload()
+{
+	StrongPtr< MeshComponentDefinition > spDefinition( new MeshComponentDefinition() );
+	spDefinition->m_OverrideMaterials.Resize( 4 );
+	spDefinition->m_OccluderBounds =
+		Simd::AaBox( Simd::Vector3( -2.0f, 0.0f, -2.0f ), Simd::Vector3( 2.0f, 4.0f, 2.0f ) );
+	spDefinition->m_IsOccluder = true;
+
+	return spDefinition.Get();
+}
+
+static Reflect::ObjectPtr CreateLargeArraysPayload()
+{
+	StrongPtr< BenchmarkLargeArrays > spArrays( new BenchmarkLargeArrays() );
+	spArrays->m_Floats.Reserve( LARGE_ARRAY_SIZE );
+	spArrays->m_Indices.Reserve( LARGE_ARRAY_SIZE );
+	spArrays->m_Bytes.Reserve( LARGE_ARRAY_SIZE );
+
+	uint32_t seed = 1;
+	for ( size_t index = 0; index < LARGE_ARRAY_SIZE; ++index )
+	{
+		spArrays->m_Floats.Push( GetRandomUnit( seed ) * 1000.0f );
+		spArrays->m_Indices.Push( static_cast< uint32_t >( ( index * 7 ) % 65536 ) );
+		spArrays->m_Bytes.Push( static_cast< uint8_t >( index ) );
+	}
+
+	return spArrays.Get();
+}
+
+template< class WriterT >
+static void WriteObject( Reflect::Object* pObject, DynamicArray< uint8_t >& rBuffer )
+{
+	AssetIdentifier identifier;
+	DynamicMemoryStream stream( &rBuffer );
+	WriterT::WriteToStream( pObject, stream, &identifier );
+}
+
+template< class ReaderT >
+static void ReadObject( const DynamicArray< uint8_t >& rBuffer, Reflect::ObjectPtr& rspObject )
+{
+	StaticMemoryStream stream( const_cast< uint8_t* >( rBuffer.GetData() ), rBuffer.GetSize() );
+	ReaderT::ReadFromStream( stream, rspObject, NULL );
+}
+
+static uint64_t ReadAllocationCount()
+{
+#if HELIUM_BENCHMARK_COUNT_ALLOCATIONS
+	return s_AllocationCount;
+#else
+	return 0;
+#endif
+}
+
+// Read a memory size field (reported in kB) from /proc/self/status, or return -1 if not available
+static int64_t ReadProcessStatusBytes( const char *pField )
+{
+	int64_t bytes = -1;
+#if HELIUM_OS_LINUX
+	FILE* pFile = fopen( "/proc/self/status", "r" );
+	if ( !pFile )
+	{
+		return -1;
+	}
+
+	size_t fieldLength = strlen( pField );
+	char line[ 256 ];
+	while ( fgets( line, sizeof( line ), pFile ) )
+	{
+		if ( !strncmp( line, pField, fieldLength ) && line[ fieldLength ] == ':' )
+		{
+			bytes = static_cast< int64_t >( strtoll( line + fieldLength + 1, NULL, 10 ) ) * 1024;
+			break;
+		}
+	}
+
+	fclose( pFile );
+#endif
+	return bytes;
+}
+
+// Reset the resident set high-water mark to the current resident set size
+static bool ResetPeakResidentBytes()
+{
+#if HELIUM_OS_LINUX
+	FILE* pFile = fopen( "/proc/self/clear_refs", "w" );
+	if ( !pFile )
+	{
+		return false;
+	}
+
+	bool bReset = fputs( "5", pFile ) >= 0;
+	bReset = ( fclose( pFile ) == 0 ) && bReset;
+
+	return bReset;
+#else
+	return false;
+#endif
+}
+
+static void RunBenchmark( const PayloadEntry &rPayload, const FormatEntry &rFormat )
+{
+	Reflect::ObjectPtr spObject = rPayload.pCreate();
+	HELIUM_ASSERT( spObject );
+
+	DynamicArray< uint8_t > buffer;
+	Reflect::ObjectPtr spReadObject;
+
+	// Measure the peak of a single cold round trip before the loops below warm up the heaps
+	int64_t peakBytes = -1;
+	bool bPeakReset = ResetPeakResidentBytes();
+	int64_t residentBytes = ReadProcessStatusBytes( "VmRSS" );
+
+	rFormat.pWrite( spObject.Get(), buffer );
+	rFormat.pRead( buffer, spReadObject );
+
+	int64_t peakResidentBytes = ReadProcessStatusBytes( "VmHWM" );
+	if ( bPeakReset && residentBytes >= 0 && peakResidentBytes >= 0 )
+	{
+		peakBytes = Max< int64_t >( peakResidentBytes - residentBytes, 0 );
+	}
+
+	if ( !spReadObject || spReadObject->GetMetaClass() != spObject->GetMetaClass() )
+	{
+		fprintf( stderr, "%s/%s: Failed to read back the written object.\n", rPayload.pName, rFormat.pName );
+		return;
+	}
+
+	const size_t archiveBytes = buffer.GetSize();
+	const uint64_t minTicks =
+		static_cast< uint64_t >( MIN_BENCHMARK_SECONDS * static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+
+	// Writes go into the same buffer each time, so its growth is only paid for by the cold round trip above
+	uint64_t writeCount = 0;
+	uint64_t writeTicks = 0;
+	uint64_t writeAllocations = 0;
+	while ( writeTicks < minTicks )
+	{
+		buffer.Resize( 0 );
+
+		uint64_t startAllocations = ReadAllocationCount();
+		uint64_t startTicks = Timer::GetTickCount();
+		rFormat.pWrite( spObject.Get(), buffer );
+		writeTicks += Timer::GetTickCount() - startTicks;
+		writeAllocations += ReadAllocationCount() - startAllocations;
+
+		++writeCount;
+	}
+
+	uint64_t readCount = 0;
+	uint64_t readTicks = 0;
+	uint64_t readAllocations = 0;
+	while ( readTicks < minTicks )
+	{
+		spReadObject.Release();
+
+		uint64_t startAllocations = ReadAllocationCount();
+		uint64_t startTicks = Timer::GetTickCount();
+		rFormat.pRead( buffer, spReadObject );
+		readTicks += Timer::GetTickCount() - startTicks;
+		readAllocations += ReadAllocationCount() - startAllocations;
+
+		++readCount;
+	}
+
+	const float64_t megabytes = static_cast< float64_t >( archiveBytes ) / ( 1024.0 * 1024.0 );
+	const float64_t writeSeconds = static_cast< float64_t >( writeTicks ) * Timer::GetSecondsPerTick();
+	const float64_t readSeconds = static_cast< float64_t >( readTicks ) * Timer::GetSecondsPerTick();
+
+	printf(
+		"{\"benchmark\":\"%s\",\"format\":\"%s\",\"bytes\":%llu,\"write_mb_per_sec\":%.3f,\"read_mb_per_sec\":%.3f",
+		rPayload.pName,
+		rFormat.pName,
+		static_cast< unsigned long long >( archiveBytes ),
+		megabytes * static_cast< float64_t >( writeCount ) / writeSeconds,
+		megabytes * static_cast< float64_t >( readCount ) / readSeconds );
+
+#if HELIUM_BENCHMARK_COUNT_ALLOCATIONS
+	printf(
+		",\"write_allocations_per_object\":%.2f,\"read_allocations_per_object\":%.2f",
+		static_cast< float64_t >( writeAllocations ) / static_cast< float64_t >( writeCount ),
+		static_cast< float64_t >( readAllocations ) / static_cast< float64_t >( readCount ) );
+#else
+	printf( ",\"write_allocations_per_object\":null,\"read_allocations_per_object\":null" );
+#endif
+
+	if ( peakBytes >= 0 )
+	{
+		printf( ",\"peak_bytes\":%lld}\n", static_cast< long long >( peakBytes ) );
+	}
+	else
+	{
+		printf( ",\"peak_bytes\":null}\n" );
+	}
+
+	fflush( stdout );
+}
+
+int main( int argc, const char* argv[] )
+{
+	const char* pFilter = argc > 1 ? argv[ 1 ] : NULL;
+
+	Reflect::Startup();
+
+	const PayloadEntry payloads[] =
+	{
+		{ "Mesh::PersistentResourceData", CreateMeshPayload },
+		{ "Material::PersistentResourceData", CreateMaterialPayload },
+		{ "RotateComponentDefinition", CreateRotateDefinitionPayload },
+		{ "MeshComponentDefinition", CreateMeshDefinitionPayload },
+		{ "LargeArrays", CreateLargeArraysPayload },
+	};
+
+	const FormatEntry formats[] =
+	{
+		{ "json", WriteObject< Persist::ArchiveWriterJson >, ReadObject< Persist::ArchiveReaderJson > },
+		{ "msgpack", WriteObject< Persist::ArchiveWriterMessagePack >, ReadObject< Persist::ArchiveReaderMessagePack > },
+		{ "bson", WriteObject< Persist::ArchiveWriterBson >, ReadObject< Persist::ArchiveReaderBson > },
+	};
+
+	for ( size_t payloadIndex = 0; payloadIndex < HELIUM_ARRAY_COUNT( payloads ); ++payloadIndex )
+	{
+		for ( size_t formatIndex = 0; formatIndex < HELIUM_ARRAY_COUNT( formats ); ++formatIndex )
+		{
+			String name;
+			name.Format( "%s/%s", payloads[ payloadIndex ].pName, formats[ formatIndex ].pName );
+			if ( pFilter && !strstr( *name, pFilter ) )
+			{
+				continue;
+			}
+
+			RunBenchmark( payloads[ payloadIndex ], formats[ formatIndex ] );
+		}
+	}
+
+	Reflect::Shutdown();
+
+	return 0;
+}
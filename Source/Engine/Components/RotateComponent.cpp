@@ -89,6 +89,13 @@ void Helium::UpdateRotateComponentsTask::DefineContract( TaskContract &rContract
 {
 	rContract.ExecuteBefore<StandardDependencies::ProcessPhysics>();
 	rContract.ExecuteAfter<StandardDependencies::ReceiveInput>();
+
+	// Each rotate component only writes the transform it is paired with
+	rContract.DisjointComponentWrites();
+
+	// Besides these, only input and the frame time are read, and neither changes once input is received
+	rContract.Reads<RotateComponent>();
+	rContract.Writes<TransformComponent>();
 }
 
-HELIUM_DEFINE_TASK( UpdateRotateComponentsTask, (ForEachWorld< QueryComponents< RotateComponent, TransformComponent, UpdateRotateComponents > >), TickTypes::Gameplay )
+HELIUM_DEFINE_TASK( UpdateRotateComponentsTask, (ParallelForEachWorld< ParallelQueryComponents< RotateComponent, TransformComponent, UpdateRotateComponents > >), TickTypes::Gameplay )
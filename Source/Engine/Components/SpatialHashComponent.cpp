@@ -0,0 +1,569 @@
+#include "Precompile.h"
+#include "Components/SpatialHashComponent.h"
+
+#include "Components/TransformComponent.h"
+#include "Framework/World.h"
+#include "Reflect/TranslatorDeduction.h"
+
+HELIUM_DEFINE_COMPONENT(Helium::SpatialHashComponent, 16);
+
+using namespace Helium;
+
+// Cell edge length for worlds that don't define a spatial hash
+static const float32_t DEFAULT_CELL_SIZE = 100.0f;
+
+static const int32_t CELL_COORDINATE_BITS = 21;
+static const int32_t CELL_COORDINATE_LIMIT = ( 1 << ( CELL_COORDINATE_BITS - 1 ) ) - 1;
+
+void Helium::SpatialHashComponent::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+}
+
+Helium::SpatialHashComponent::SpatialHashComponent()
+: m_CellSize( DEFAULT_CELL_SIZE )
+, m_InverseCellSize( 1.0f / DEFAULT_CELL_SIZE )
+{
+	m_MinimumCell.m_X = m_MinimumCell.m_Y = m_MinimumCell.m_Z = CELL_COORDINATE_LIMIT;
+	m_MaximumCell.m_X = m_MaximumCell.m_Y = m_MaximumCell.m_Z = -CELL_COORDINATE_LIMIT;
+}
+
+void Helium::SpatialHashComponent::Initialize( const SpatialHashComponentDefinition &definition )
+{
+	Initialize( definition.m_CellSize );
+}
+
+void Helium::SpatialHashComponent::Initialize( float32_t cellSize )
+{
+	HELIUM_ASSERT( m_Entries.IsEmpty() );
+
+	m_CellSize = cellSize > HELIUM_EPSILON ? cellSize : DEFAULT_CELL_SIZE;
+	m_InverseCellSize = 1.0f / m_CellSize;
+}
+
+SpatialHashComponent* Helium::SpatialHashComponent::Get( World *pWorld )
+{
+	HELIUM_ASSERT( pWorld );
+
+	SpatialHashComponent *pSpatialHash = pWorld->GetComponents().GetFirst<SpatialHashComponent>();
+	if ( !pSpatialHash )
+	{
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+
+		pSpatialHash = pComponentManager->Allocate<SpatialHashComponent>( pWorld, pWorld->GetComponents() );
+		if ( pSpatialHash )
+		{
+			pSpatialHash->Initialize( DEFAULT_CELL_SIZE );
+		}
+	}
+
+	return pSpatialHash;
+}
+
+void Helium::SpatialHashComponent::Update()
+{
+	ComponentManager *pComponentManager = GetComponentManager();
+	HELIUM_ASSERT( pComponentManager );
+
+	// Drop transforms freed since the last update. Walking backwards means the entry swapped into a removed slot has
+	// already been checked
+	for ( size_t entryIndex = m_Entries.GetSize() - 1; entryIndex < m_Entries.GetSize(); --entryIndex )
+	{
+		const Entry &rEntry = m_Entries[ entryIndex ];
+		if ( rEntry.m_pTransform->GetInlineData().m_Generation != rEntry.m_Generation )
+		{
+			RemoveEntry( static_cast< uint32_t >( entryIndex ) );
+		}
+	}
+
+	// Only dirty transforms need a new cell. The dirty flags of each pool are one packed stream
+	const DynamicArray< Components::TypeId > &implementingTypes = Components::GetTypeData( Components::GetType< TransformComponent >() )->m_ImplementingTypes;
+	for ( DynamicArray< Components::TypeId >::ConstIterator iter = implementingTypes.Begin(); iter != implementingTypes.End(); ++iter )
+	{
+		const Components::Pool *pPool = pComponentManager->GetPool( *iter );
+		if ( !pPool )
+		{
+			continue;
+		}
+
+		const Components::ComponentIndex allocatedCount = pPool->GetAllocatedCount();
+		const bool *pDirtyFlags = pPool->GetStream< bool >( TransformComponent::STREAM_DIRTY );
+		for ( Components::ComponentIndex rosterIndex = 0; rosterIndex < allocatedCount; ++rosterIndex )
+		{
+			if ( pDirtyFlags[ rosterIndex ] )
+			{
+				IndexTransform( static_cast< TransformComponent * >( pPool->GetComponentByRosterIndex( rosterIndex ) ) );
+			}
+		}
+	}
+}
+
+SpatialHashComponent::CellCoordinates Helium::SpatialHashComponent::GetCellCoordinates( const Simd::Vector3 &rPosition ) const
+{
+	const float32_t limit = static_cast< float32_t >( CELL_COORDINATE_LIMIT );
+
+	CellCoordinates cell;
+	cell.m_X = static_cast< int32_t >( Max( -limit, Min( Floor( rPosition.GetElement( 0 ) * m_InverseCellSize ), limit ) ) );
+	cell.m_Y = static_cast< int32_t >( Max( -limit, Min( Floor( rPosition.GetElement( 1 ) * m_InverseCellSize ), limit ) ) );
+	cell.m_Z = static_cast< int32_t >( Max( -limit, Min( Floor( rPosition.GetElement( 2 ) * m_InverseCellSize ), limit ) ) );
+
+	return cell;
+}
+
+uint64_t Helium::SpatialHashComponent::GetCellKey( const CellCoordinates &rCell )
+{
+	const uint64_t mask = ( static_cast< uint64_t >( 1 ) << CELL_COORDINATE_BITS ) - 1;
+
+	return
+		( ( static_cast< uint64_t >( rCell.m_X ) & mask ) << ( CELL_COORDINATE_BITS * 2 ) ) |
+		( ( static_cast< uint64_t >( rCell.m_Y ) & mask ) << CELL_COORDINATE_BITS ) |
+		( static_cast< uint64_t >( rCell.m_Z ) & mask );
+}
+
+void Helium::SpatialHashComponent::LinkEntry( uint32_t entryIndex )
+{
+	Entry &rEntry = m_Entries[ entryIndex ];
+
+	const CellCoordinates cell = GetCellCoordinates( rEntry.m_Position );
+	rEntry.m_CellKey = GetCellKey( cell );
+	SetInvalid( rEntry.m_PreviousInCell );
+
+	HashMap< uint64_t, uint32_t >::Iterator cellIter = m_CellHeads.Find( rEntry.m_CellKey );
+	if ( cellIter == m_CellHeads.End() )
+	{
+		m_CellHeads.Insert( cellIter, HashMap< uint64_t, uint32_t >::ValueType( rEntry.m_CellKey, entryIndex ) );
+		SetInvalid( rEntry.m_NextInCell );
+	}
+	else
+	{
+		rEntry.m_NextInCell = cellIter->Second();
+		if ( IsValid( rEntry.m_NextInCell ) )
+		{
+			m_Entries[ rEntry.m_NextInCell ].m_PreviousInCell = entryIndex;
+		}
+
+		cellIter->Second() = entryIndex;
+	}
+
+	m_MinimumCell.m_X = Min( m_MinimumCell.m_X, cell.m_X );
+	m_MinimumCell.m_Y = Min( m_MinimumCell.m_Y, cell.m_Y );
+	m_MinimumCell.m_Z = Min( m_MinimumCell.m_Z, cell.m_Z );
+	m_MaximumCell.m_X = Max( m_MaximumCell.m_X, cell.m_X );
+	m_MaximumCell.m_Y = Max( m_MaximumCell.m_Y, cell.m_Y );
+	m_MaximumCell.m_Z = Max( m_MaximumCell.m_Z, cell.m_Z );
+}
+
+void Helium::SpatialHashComponent::UnlinkEntry( uint32_t entryIndex )
+{
+	Entry &rEntry = m_Entries[ entryIndex ];
+
+	if ( IsValid( rEntry.m_NextInCell ) )
+	{
+		m_Entries[ rEntry.m_NextInCell ].m_PreviousInCell = rEntry.m_PreviousInCell;
+	}
+
+	if ( IsValid( rEntry.m_PreviousInCell ) )
+	{
+		m_Entries[ rEntry.m_PreviousInCell ].m_NextInCell = rEntry.m_NextInCell;
+	}
+	else
+	{
+		// Emptied cells keep their (invalid) head so that busy cells aren't reinserted into the map every frame
+		HashMap< uint64_t, uint32_t >::Iterator cellIter = m_CellHeads.Find( rEntry.m_CellKey );
+		HELIUM_ASSERT( cellIter != m_CellHeads.End() );
+		HELIUM_ASSERT( cellIter->Second() == entryIndex );
+		cellIter->Second() = rEntry.m_NextInCell;
+	}
+}
+
+void Helium::SpatialHashComponent::RemoveEntry( uint32_t entryIndex )
+{
+	UnlinkEntry( entryIndex );
+
+	const uint32_t lastIndex = static_cast< uint32_t >( m_Entries.GetSize() - 1 );
+	if ( entryIndex != lastIndex )
+	{
+		// Move the last entry into the freed slot, pointing everything that referred to it at the new index
+		Entry &rMoved = m_Entries[ lastIndex ];
+		if ( IsValid( rMoved.m_NextInCell ) )
+		{
+			m_Entries[ rMoved.m_NextInCell ].m_PreviousInCell = entryIndex;
+		}
+
+		if ( IsValid( rMoved.m_PreviousInCell ) )
+		{
+			m_Entries[ rMoved.m_PreviousInCell ].m_NextInCell = entryIndex;
+		}
+		else
+		{
+			HashMap< uint64_t, uint32_t >::Iterator cellIter = m_CellHeads.Find( rMoved.m_CellKey );
+			HELIUM_ASSERT( cellIter != m_CellHeads.End() );
+			cellIter->Second() = entryIndex;
+		}
+
+		rMoved.m_pTransform->m_SpatialHashIndex = entryIndex;
+	}
+
+	m_Entries.RemoveSwap( entryIndex );
+}
+
+void Helium::SpatialHashComponent::IndexTransform( TransformComponent *pTransform )
+{
+	HELIUM_ASSERT( pTransform );
+
+	uint32_t entryIndex = pTransform->m_SpatialHashIndex;
+	const bool bIndexed = ( entryIndex < m_Entries.GetSize() && m_Entries[ entryIndex ].m_pTransform == pTransform );
+	if ( !bIndexed )
+	{
+		entryIndex = static_cast< uint32_t >( m_Entries.GetSize() );
+		Entry *pEntry = m_Entries.New();
+		HELIUM_ASSERT( pEntry );
+		pEntry->m_pTransform = pTransform;
+		pEntry->m_Generation = pTransform->GetInlineData().m_Generation;
+		pTransform->m_SpatialHashIndex = entryIndex;
+	}
+
+	Entry &rEntry = m_Entries[ entryIndex ];
+	rEntry.m_Position = pTransform->GetPosition();
+	rEntry.m_Layers = pTransform->GetSpatialLayers();
+
+	if ( bIndexed )
+	{
+		// Transforms that stayed within their cell keep their place in it
+		if ( GetCellKey( GetCellCoordinates( rEntry.m_Position ) ) == rEntry.m_CellKey )
+		{
+			return;
+		}
+
+		UnlinkEntry( entryIndex );
+	}
+
+	LinkEntry( entryIndex );
+}
+
+bool Helium::SpatialHashComponent::Accept( const Entry &rEntry, const Simd::AaBox &rBox, const Simd::Vector3 &rCenter, float32_t radiusSquared, uint32_t layerMask, float32_t &rDistanceSquared )
+{
+	if ( !( rEntry.m_Layers & layerMask ) )
+	{
+		return false;
+	}
+
+	const Simd::Vector3 &rMinimum = rBox.GetMinimum();
+	const Simd::Vector3 &rMaximum = rBox.GetMaximum();
+	for ( size_t axis = 0; axis < 3; ++axis )
+	{
+		const float32_t value = rEntry.m_Position.GetElement( axis );
+		if ( value < rMinimum.GetElement( axis ) || value > rMaximum.GetElement( axis ) )
+		{
+			return false;
+		}
+	}
+
+	rDistanceSquared = ( rEntry.m_Position - rCenter ).GetMagnitudeSquared();
+
+	return rDistanceSquared <= radiusSquared;
+}
+
+size_t Helium::SpatialHashComponent::Gather( const Simd::AaBox &rBox, const Simd::Vector3 &rCenter, float32_t radiusSquared, uint32_t layerMask, DynamicArray< Result > &rResults ) const
+{
+	const size_t firstResult = rResults.GetSize();
+	if ( m_Entries.IsEmpty() )
+	{
+		return 0;
+	}
+
+	CellCoordinates minimum = GetCellCoordinates( rBox.GetMinimum() );
+	CellCoordinates maximum = GetCellCoordinates( rBox.GetMaximum() );
+	minimum.m_X = Max( minimum.m_X, m_MinimumCell.m_X );
+	minimum.m_Y = Max( minimum.m_Y, m_MinimumCell.m_Y );
+	minimum.m_Z = Max( minimum.m_Z, m_MinimumCell.m_Z );
+	maximum.m_X = Min( maximum.m_X, m_MaximumCell.m_X );
+	maximum.m_Y = Min( maximum.m_Y, m_MaximumCell.m_Y );
+	maximum.m_Z = Min( maximum.m_Z, m_MaximumCell.m_Z );
+	if ( minimum.m_X > maximum.m_X || minimum.m_Y > maximum.m_Y || minimum.m_Z > maximum.m_Z )
+	{
+		return 0;
+	}
+
+	Result result;
+	const uint64_t cellCount =
+		static_cast< uint64_t >( maximum.m_X - minimum.m_X + 1 ) *
+		static_cast< uint64_t >( maximum.m_Y - minimum.m_Y + 1 ) *
+		static_cast< uint64_t >( maximum.m_Z - minimum.m_Z + 1 );
+	if ( cellCount > m_CellHeads.GetSize() )
+	{
+		// Looking up every cell in range would cost more than testing every entry
+		for ( DynamicArray< Entry >::ConstIterator iter = m_Entries.Begin(); iter != m_Entries.End(); ++iter )
+		{
+			if ( Accept( *iter, rBox, rCenter, radiusSquared, layerMask, result.m_DistanceSquared ) )
+			{
+				result.m_pTransform = iter->m_pTransform;
+				result.m_Position = iter->m_Position;
+				rResults.Push( result );
+			}
+		}
+
+		return rResults.GetSize() - firstResult;
+	}
+
+	CellCoordinates cell;
+	for ( cell.m_X = minimum.m_X; cell.m_X <= maximum.m_X; ++cell.m_X )
+	{
+		for ( cell.m_Y = minimum.m_Y; cell.m_Y <= maximum.m_Y; ++cell.m_Y )
+		{
+			for ( cell.m_Z = minimum.m_Z; cell.m_Z <= maximum.m_Z; ++cell.m_Z )
+			{
+				HashMap< uint64_t, uint32_t >::ConstIterator cellIter = m_CellHeads.Find( GetCellKey( cell ) );
+				if ( cellIter == m_CellHeads.End() )
+				{
+					continue;
+				}
+
+				for ( uint32_t entryIndex = cellIter->Second(); IsValid( entryIndex ); entryIndex = m_Entries[ entryIndex ].m_NextInCell )
+				{
+					const Entry &rEntry = m_Entries[ entryIndex ];
+					if ( Accept( rEntry, rBox, rCenter, radiusSquared, layerMask, result.m_DistanceSquared ) )
+					{
+						result.m_pTransform = rEntry.m_pTransform;
+						result.m_Position = rEntry.m_Position;
+						rResults.Push( result );
+					}
+				}
+			}
+		}
+	}
+
+	return rResults.GetSize() - firstResult;
+}
+
+size_t Helium::SpatialHashComponent::FindInRadius( const Simd::Vector3 &rCenter, float32_t radius, uint32_t layerMask, DynamicArray< Result > &rResults ) const
+{
+	const Simd::Vector3 extent( radius );
+
+	return Gather( Simd::AaBox( rCenter - extent, rCenter + extent ), rCenter, radius * radius, layerMask, rResults );
+}
+
+size_t Helium::SpatialHashComponent::FindInBox( const Simd::AaBox &rBox, uint32_t layerMask, DynamicArray< Result > &rResults ) const
+{
+	const Simd::Vector3 center = ( rBox.GetMinimum() + rBox.GetMaximum() ) * 0.5f;
+
+	return Gather( rBox, center, NumericLimits< float32_t >::Maximum, layerMask, rResults );
+}
+
+void Helium::SpatialHashComponent::InsertNearest( const Entry &rEntry, float32_t distanceSquared, size_t firstResult, size_t maxCount, DynamicArray< Result > &rResults )
+{
+	// Results past firstResult are kept sorted. Once full, the farthest is dropped to make room
+	if ( rResults.GetSize() - firstResult >= maxCount )
+	{
+		rResults.Pop();
+	}
+
+	size_t insertIndex = rResults.GetSize();
+	while ( insertIndex > firstResult && rResults[ insertIndex - 1 ].m_DistanceSquared > distanceSquared )
+	{
+		--insertIndex;
+	}
+
+	Result result;
+	result.m_pTransform = rEntry.m_pTransform;
+	result.m_Position = rEntry.m_Position;
+	result.m_DistanceSquared = distanceSquared;
+	rResults.Insert( insertIndex, result );
+}
+
+void Helium::SpatialHashComponent::GatherNearestInCell( uint64_t cellKey, const Simd::Vector3 &rPosition, uint32_t layerMask, size_t firstResult, size_t maxCount, float32_t &rMaxDistanceSquared, DynamicArray< Result > &rResults ) const
+{
+	HashMap< uint64_t, uint32_t >::ConstIterator cellIter = m_CellHeads.Find( cellKey );
+	if ( cellIter == m_CellHeads.End() )
+	{
+		return;
+	}
+
+	for ( uint32_t entryIndex = cellIter->Second(); IsValid( entryIndex ); entryIndex = m_Entries[ entryIndex ].m_NextInCell )
+	{
+		const Entry &rEntry = m_Entries[ entryIndex ];
+		if ( !( rEntry.m_Layers & layerMask ) )
+		{
+			continue;
+		}
+
+		const float32_t distanceSquared = ( rEntry.m_Position - rPosition ).GetMagnitudeSquared();
+		if ( distanceSquared <= rMaxDistanceSquared )
+		{
+			InsertNearest( rEntry, distanceSquared, firstResult, maxCount, rResults );
+
+			// With a full set of results, only something closer than the farthest one can still get in
+			if ( rResults.GetSize() - firstResult == maxCount )
+			{
+				rMaxDistanceSquared = rResults.GetLast().m_DistanceSquared;
+			}
+		}
+	}
+}
+
+size_t Helium::SpatialHashComponent::FindNearest( const Simd::Vector3 &rPosition, uint32_t layerMask, size_t maxCount, float32_t maxDistance, DynamicArray< Result > &rResults ) const
+{
+	const size_t firstResult = rResults.GetSize();
+	if ( maxCount == 0 || m_Entries.IsEmpty() )
+	{
+		return 0;
+	}
+
+	// Unlimited searches pass NumericLimits< float32_t >::Maximum, which would overflow when squared
+	float32_t maxDistanceSquared = NumericLimits< float32_t >::Maximum;
+	if ( maxDistance < 1.0e18f )
+	{
+		maxDistanceSquared = maxDistance * maxDistance;
+	}
+
+	// Search shells of cells around the query cell, one ring further out at a time. Everything past ring r is at
+	// least r cells away, so the search ends once that is farther than the current result set (or maxDistance)
+	const CellCoordinates center = GetCellCoordinates( rPosition );
+	const int32_t ringLimit = Max(
+		Max( Max( center.m_X - m_MinimumCell.m_X, m_MaximumCell.m_X - center.m_X ), Max( center.m_Y - m_MinimumCell.m_Y, m_MaximumCell.m_Y - center.m_Y ) ),
+		Max( center.m_Z - m_MinimumCell.m_Z, m_MaximumCell.m_Z - center.m_Z ) );
+
+	size_t visitedCellCount = 0;
+	for ( int32_t ring = 0; ring <= ringLimit; ++ring )
+	{
+		const float32_t ringDistance = static_cast< float32_t >( Max( ring - 1, 0 ) ) * m_CellSize;
+		if ( ringDistance * ringDistance > maxDistanceSquared )
+		{
+			break;
+		}
+
+		if ( visitedCellCount > m_Entries.GetSize() )
+		{
+			// Sparse data far from the query: finish with a linear pass instead of walking mostly empty cells
+			rResults.Resize( firstResult );
+			for ( DynamicArray< Entry >::ConstIterator iter = m_Entries.Begin(); iter != m_Entries.End(); ++iter )
+			{
+				if ( iter->m_Layers & layerMask )
+				{
+					const float32_t distanceSquared = ( iter->m_Position - rPosition ).GetMagnitudeSquared();
+					if ( distanceSquared <= maxDistanceSquared )
+					{
+						InsertNearest( *iter, distanceSquared, firstResult, maxCount, rResults );
+						if ( rResults.GetSize() - firstResult == maxCount )
+						{
+							maxDistanceSquared = rResults.GetLast().m_DistanceSquared;
+						}
+					}
+				}
+			}
+
+			return rResults.GetSize() - firstResult;
+		}
+
+		const int32_t minimumX = Max( center.m_X - ring, m_MinimumCell.m_X );
+		const int32_t maximumX = Min( center.m_X + ring, m_MaximumCell.m_X );
+		const int32_t minimumY = Max( center.m_Y - ring, m_MinimumCell.m_Y );
+		const int32_t maximumY = Min( center.m_Y + ring, m_MaximumCell.m_Y );
+		const int32_t minimumZ = Max( center.m_Z - ring, m_MinimumCell.m_Z );
+		const int32_t maximumZ = Min( center.m_Z + ring, m_MaximumCell.m_Z );
+
+		CellCoordinates cell;
+		for ( cell.m_X = minimumX; cell.m_X <= maximumX; ++cell.m_X )
+		{
+			for ( cell.m_Y = minimumY; cell.m_Y <= maximumY; ++cell.m_Y )
+			{
+				if ( Abs( cell.m_X - center.m_X ) == ring || Abs( cell.m_Y - center.m_Y ) == ring )
+				{
+					for ( cell.m_Z = minimumZ; cell.m_Z <= maximumZ; ++cell.m_Z )
+					{
+						GatherNearestInCell( GetCellKey( cell ), rPosition, layerMask, firstResult, maxCount, maxDistanceSquared, rResults );
+						++visitedCellCount;
+					}
+
+					continue;
+				}
+
+				// Cells inside the shell were searched by an earlier ring, so only its two z faces are left
+				cell.m_Z = center.m_Z - ring;
+				if ( cell.m_Z >= minimumZ )
+				{
+					GatherNearestInCell( GetCellKey( cell ), rPosition, layerMask, firstResult, maxCount, maxDistanceSquared, rResults );
+					++visitedCellCount;
+				}
+
+				cell.m_Z = center.m_Z + ring;
+				if ( cell.m_Z <= maximumZ )
+				{
+					GatherNearestInCell( GetCellKey( cell ), rPosition, layerMask, firstResult, maxCount, maxDistanceSquared, rResults );
+					++visitedCellCount;
+				}
+			}
+		}
+
+		// Cells past this ring are at least ring cells away from any position in the query cell
+		const float32_t nextRingDistance = static_cast< float32_t >( ring ) * m_CellSize;
+		if ( rResults.GetSize() - firstResult == maxCount && maxDistanceSquared <= nextRingDistance * nextRingDistance )
+		{
+			break;
+		}
+	}
+
+	return rResults.GetSize() - firstResult;
+}
+
+void Helium::SpatialHashComponent::FindNearestBatch( const Simd::Vector3 *pPositions, size_t count, uint32_t layerMask, size_t maxCount, float32_t maxDistance, DynamicArray< Result > &rResults, DynamicArray< size_t > &rOffsets ) const
+{
+	HELIUM_ASSERT( pPositions || count == 0 );
+
+	rOffsets.Resize( count + 1 );
+	rResults.Reserve( rResults.GetSize() + count * maxCount );
+	for ( size_t queryIndex = 0; queryIndex < count; ++queryIndex )
+	{
+		rOffsets[ queryIndex ] = rResults.GetSize();
+		FindNearest( pPositions[ queryIndex ], layerMask, maxCount, maxDistance, rResults );
+	}
+
+	rOffsets[ count ] = rResults.GetSize();
+}
+
+void Helium::SpatialHashComponent::FindInRadiusBatch( const Simd::Vector3 *pCenters, size_t count, float32_t radius, uint32_t layerMask, DynamicArray< Result > &rResults, DynamicArray< size_t > &rOffsets ) const
+{
+	HELIUM_ASSERT( pCenters || count == 0 );
+
+	rOffsets.Resize( count + 1 );
+	for ( size_t queryIndex = 0; queryIndex < count; ++queryIndex )
+	{
+		rOffsets[ queryIndex ] = rResults.GetSize();
+		FindInRadius( pCenters[ queryIndex ], radius, layerMask, rResults );
+	}
+
+	rOffsets[ count ] = rResults.GetSize();
+}
+
+HELIUM_DEFINE_CLASS(Helium::SpatialHashComponentDefinition);
+
+Helium::SpatialHashComponentDefinition::SpatialHashComponentDefinition()
+: m_CellSize( DEFAULT_CELL_SIZE )
+{
+
+}
+
+void Helium::SpatialHashComponentDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+	comp.AddField(&SpatialHashComponentDefinition::m_CellSize, "m_CellSize");
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void UpdateSpatialHash( World *pWorld )
+{
+	SpatialHashComponent *pSpatialHash = SpatialHashComponent::Get( pWorld );
+	if ( pSpatialHash )
+	{
+		pSpatialHash->Update();
+	}
+}
+
+void Helium::UpdateSpatialHashTask::DefineContract( TaskContract &rContract )
+{
+	// Transforms stay dirty until after rendering, so everything gameplay moved this frame is picked up here
+	rContract.ExecuteAfter<StandardDependencies::PostPhysicsGameplay>();
+	rContract.ExecuteBefore<StandardDependencies::Render>();
+}
+
+HELIUM_DEFINE_TASK( UpdateSpatialHashTask, (ForEachWorld< UpdateSpatialHash >), TickTypes::Gameplay )
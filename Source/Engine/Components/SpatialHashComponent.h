@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Components/Components.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/HashMap.h"
+#include "MathSimd/AaBox.h"
+#include "MathSimd/Vector3.h"
+#include "Framework/ComponentDefinition.h"
+#include "Framework/TaskScheduler.h"
+
+namespace Helium
+{
+	class SpatialHashComponentDefinition;
+	class TransformComponent;
+
+	// World component indexing the position of every transform in a uniform grid, for gameplay proximity queries.
+	// Cells are kept in a hash map so the grid has no fixed bounds. UpdateSpatialHashTask only re-buckets transforms
+	// that are dirty (new transforms are always dirty), so queries see positions as of the end of the last gameplay
+	// update. Each transform is indexed under its spatial layers (see TransformComponent::SetSpatialLayers) and every
+	// query only returns transforms on at least one of the requested layers.
+	//
+	// Worlds without a SpatialHashComponentDefinition get one with the default cell size on their first update.
+	// Results hold raw transform pointers, which are only good until the end of the frame
+	class HELIUM_COMPONENTS_API SpatialHashComponent : public Component
+	{
+		HELIUM_DECLARE_COMPONENT( Helium::SpatialHashComponent, Helium::Component );
+		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+	public:
+		struct Result
+		{
+			TransformComponent *m_pTransform;
+			Simd::Vector3 m_Position;
+			float32_t m_DistanceSquared; // From the query position (or box center)
+		};
+
+		SpatialHashComponent();
+
+		void Initialize( const SpatialHashComponentDefinition &definition );
+		void Initialize( float32_t cellSize );
+
+		// Get the spatial hash of a world, creating one with the default settings if the world has none
+		static SpatialHashComponent* Get( World *pWorld );
+
+		void Update();
+
+		// Queries append to rResults and return the number of results added. Nearest queries return up to maxCount
+		// results sorted by distance; the others are unordered
+		size_t FindNearest( const Simd::Vector3 &rPosition, uint32_t layerMask, size_t maxCount, float32_t maxDistance, DynamicArray< Result > &rResults ) const;
+		size_t FindInRadius( const Simd::Vector3 &rCenter, float32_t radius, uint32_t layerMask, DynamicArray< Result > &rResults ) const;
+		size_t FindInBox( const Simd::AaBox &rBox, uint32_t layerMask, DynamicArray< Result > &rResults ) const;
+
+		// Batched queries run one query for each of the count positions, with every result appended to rResults.
+		// rOffsets is filled with count + 1 entries, the results of query i being [rOffsets[i], rOffsets[i + 1])
+		void FindNearestBatch( const Simd::Vector3 *pPositions, size_t count, uint32_t layerMask, size_t maxCount, float32_t maxDistance, DynamicArray< Result > &rResults, DynamicArray< size_t > &rOffsets ) const;
+		void FindInRadiusBatch( const Simd::Vector3 *pCenters, size_t count, float32_t radius, uint32_t layerMask, DynamicArray< Result > &rResults, DynamicArray< size_t > &rOffsets ) const;
+
+		inline float32_t GetCellSize() const { return m_CellSize; }
+		inline size_t GetEntryCount() const { return m_Entries.GetSize(); }
+
+	private:
+		struct Entry
+		{
+			Simd::Vector3 m_Position;
+			TransformComponent *m_pTransform;
+			uint64_t m_CellKey;
+			uint32_t m_PreviousInCell;
+			uint32_t m_NextInCell;
+			uint32_t m_Layers;
+			Components::GenerationIndex m_Generation; // To spot transforms freed since they were indexed
+		};
+
+		// Cell coordinates are clamped to 21 bits each so they pack into a single key
+		struct CellCoordinates
+		{
+			int32_t m_X;
+			int32_t m_Y;
+			int32_t m_Z;
+		};
+
+		CellCoordinates GetCellCoordinates( const Simd::Vector3 &rPosition ) const;
+		static uint64_t GetCellKey( const CellCoordinates &rCell );
+
+		void LinkEntry( uint32_t entryIndex );
+		void UnlinkEntry( uint32_t entryIndex );
+		void RemoveEntry( uint32_t entryIndex );
+		void IndexTransform( TransformComponent *pTransform );
+
+		size_t Gather( const Simd::AaBox &rBox, const Simd::Vector3 &rCenter, float32_t radiusSquared, uint32_t layerMask, DynamicArray< Result > &rResults ) const;
+		static bool Accept( const Entry &rEntry, const Simd::AaBox &rBox, const Simd::Vector3 &rCenter, float32_t radiusSquared, uint32_t layerMask, float32_t &rDistanceSquared );
+		void GatherNearestInCell( uint64_t cellKey, const Simd::Vector3 &rPosition, uint32_t layerMask, size_t firstResult, size_t maxCount, float32_t &rMaxDistanceSquared, DynamicArray< Result > &rResults ) const;
+		static void InsertNearest( const Entry &rEntry, float32_t distanceSquared, size_t firstResult, size_t maxCount, DynamicArray< Result > &rResults );
+
+		float32_t m_CellSize;
+		float32_t m_InverseCellSize;
+
+		DynamicArray< Entry > m_Entries;
+		// First entry of each occupied cell, with the entries of a cell linked through m_NextInCell
+		HashMap< uint64_t, uint32_t > m_CellHeads;
+
+		// Bounds of every cell that has held an entry so far (only grows), so searches can stop at the edge
+		CellCoordinates m_MinimumCell;
+		CellCoordinates m_MaximumCell;
+	};
+
+	class HELIUM_COMPONENTS_API SpatialHashComponentDefinition : public Helium::ComponentDefinitionHelper<SpatialHashComponent, SpatialHashComponentDefinition>
+	{
+		HELIUM_DECLARE_CLASS( Helium::SpatialHashComponentDefinition, Helium::ComponentDefinition );
+		static void PopulateMetaType( Reflect::MetaStruct& comp );
+
+		SpatialHashComponentDefinition();
+
+		// Edge length of a grid cell. Works best around the typical query radius
+		float32_t m_CellSize;
+	};
+	typedef StrongPtr<SpatialHashComponentDefinition> SpatialHashComponentDefinitionPtr;
+
+	// Re-buckets dirty transforms once gameplay is done moving things, so the next frame's queries see this frame's
+	// positions
+	struct HELIUM_COMPONENTS_API UpdateSpatialHashTask : public TaskDefinition
+	{
+		HELIUM_DECLARE_TASK(UpdateSpatialHashTask);
+		virtual void DefineContract(TaskContract &rContract);
+	};
+}
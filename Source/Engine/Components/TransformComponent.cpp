@@ -1,7 +1,11 @@
 #include "Precompile.h"
 #include "Components/TransformComponent.h"
 
+#include "EngineJobs/JobManager.h"
 #include "Framework/World.h"
+#include "MathSimd/Matrix44Soa.h"
+#include "MathSimd/QuatSoa.h"
+#include "MathSimd/Vector3Soa.h"
 #include "Reflect/TranslatorDeduction.h"
 
 HELIUM_DEFINE_COMPONENT(Helium::TransformComponent, 128);
@@ -12,12 +16,53 @@ void Helium::TransformComponent::PopulateMetaType( Reflect::MetaStruct& comp )
 {
 }
 
+void Helium::TransformComponent::DeclareStreams( Components::StreamList& rStreams )
+{
+	// Must be added in the order of the Streams enum
+	rStreams.Add< Simd::Vector3 >();
+	rStreams.Add< Simd::Quat >();
+	rStreams.Add< bool >();
+	rStreams.Add< Simd::Matrix44 >();
+}
+
 void Helium::TransformComponent::Initialize( const TransformComponentDefinition &definition )
 {
-	m_Position = definition.m_Position;
-	m_Rotation = definition.m_Rotation;
+	GetStreamElement< Simd::Vector3 >( STREAM_POSITION ) = definition.m_Position;
+	GetStreamElement< Simd::Quat >( STREAM_ROTATION ) = definition.m_Rotation;
+	GetStreamElement< bool >( STREAM_DIRTY ) = true;
+	GetStreamElement< Simd::Matrix44 >( STREAM_WORLD_TRANSFORM ) = Simd::Matrix44::IDENTITY;
 	m_Scale = definition.m_Scale;
-	m_bDirty = true;
+	m_SpatialLayers = SPATIAL_LAYER_DEFAULT;
+	SetInvalid( m_SpatialHashIndex );
+}
+
+void Helium::TransformComponent::SetParent( TransformComponent* pParent )
+{
+#ifdef HELIUM_ASSERT_ENABLED
+	for ( TransformComponent *pAncestor = pParent; pAncestor; pAncestor = pAncestor->GetParent() )
+	{
+		HELIUM_ASSERT( pAncestor != this );
+	}
+#endif
+
+	m_Parent = pParent;
+	GetStreamElement< bool >( STREAM_DIRTY ) = true;
+}
+
+void Helium::TransformComponent::SaveSnapshot( DynamicArray< uint8_t >& rData ) const
+{
+	rData.AddArray( reinterpret_cast< const uint8_t * >( &m_Scale ), sizeof( m_Scale ) );
+	rData.AddArray( reinterpret_cast< const uint8_t * >( &m_SpatialLayers ), sizeof( m_SpatialLayers ) );
+}
+
+void Helium::TransformComponent::RestoreSnapshot( const uint8_t*& rpData )
+{
+	MemoryCopy( &m_Scale, rpData, sizeof( m_Scale ) );
+	rpData += sizeof( m_Scale );
+	MemoryCopy( &m_SpatialLayers, rpData, sizeof( m_SpatialLayers ) );
+	rpData += sizeof( m_SpatialLayers );
+
+	GetStreamElement< bool >( STREAM_DIRTY ) = true;
 }
 
 HELIUM_DEFINE_CLASS(Helium::TransformComponentDefinition);
@@ -39,25 +84,194 @@ void Helium::TransformComponentDefinition::PopulateMetaType( Reflect::MetaStruct
 
 //////////////////////////////////////////////////////////////////////////
 
-//void ClearTransformComponentDirtyFlags( World *pWorld )
-//{
-//    Components::ComponentListT<TransformComponent> list = pWorld->GetComponentManager()->GetAllocatedComponents<TransformComponent>();
-// 
-//    for (int i = 0; i < list.m_Count; ++i)
-//    {
-//        list.m_pComponents[i]->ClearDirtyFlag();
-//    }
-//}
+// Transforms are composed one SIMD register of lanes at a time
+static const size_t TRANSFORM_BATCH_SIZE = 4;
+
+// Transforms at one depth of the hierarchy that need their world transform rebuilt this frame
+struct TransformLevel
+{
+	DynamicArray< TransformComponent * > m_Transforms;
+	bool m_HasParents;
+};
+
+static void UpdateTransformBatch( void *pContext, size_t batchIndex )
+{
+	const TransformLevel &rLevel = *static_cast< const TransformLevel * >( pContext );
+
+	const size_t firstIndex = batchIndex * TRANSFORM_BATCH_SIZE;
+	const size_t count = Min( TRANSFORM_BATCH_SIZE, rLevel.m_Transforms.GetSize() - firstIndex );
+	TransformComponent * const *ppTransforms = rLevel.m_Transforms.GetData() + firstIndex;
+
+	HELIUM_SIMD_ALIGN_PRE float32_t position[ 3 ][ TRANSFORM_BATCH_SIZE ] HELIUM_SIMD_ALIGN_POST;
+	HELIUM_SIMD_ALIGN_PRE float32_t rotation[ 4 ][ TRANSFORM_BATCH_SIZE ] HELIUM_SIMD_ALIGN_POST;
+	HELIUM_SIMD_ALIGN_PRE float32_t scale[ TRANSFORM_BATCH_SIZE ] HELIUM_SIMD_ALIGN_POST;
+	HELIUM_SIMD_ALIGN_PRE float32_t elements[ 16 ][ TRANSFORM_BATCH_SIZE ] HELIUM_SIMD_ALIGN_POST;
+
+	// Gather into SoA form. Lanes past the end of a partial batch repeat the first transform so every lane holds
+	// valid data, and are never written back
+	for ( size_t lane = 0; lane < TRANSFORM_BATCH_SIZE; ++lane )
+	{
+		const TransformComponent *pTransform = ppTransforms[ lane < count ? lane : 0 ];
+		const Simd::Vector3 &rPosition = pTransform->GetPosition();
+		const Simd::Quat &rRotation = pTransform->GetRotation();
+
+		position[ 0 ][ lane ] = rPosition.GetElement( 0 );
+		position[ 1 ][ lane ] = rPosition.GetElement( 1 );
+		position[ 2 ][ lane ] = rPosition.GetElement( 2 );
+		rotation[ 0 ][ lane ] = rRotation.GetElement( 0 );
+		rotation[ 1 ][ lane ] = rRotation.GetElement( 1 );
+		rotation[ 2 ][ lane ] = rRotation.GetElement( 2 );
+		rotation[ 3 ][ lane ] = rRotation.GetElement( 3 );
+		scale[ lane ] = pTransform->GetScale();
+	}
+
+	Simd::Vector3Soa positionSoa;
+	positionSoa.Load( position[ 0 ], position[ 1 ], position[ 2 ] );
+
+	Simd::QuatSoa rotationSoa;
+	rotationSoa.Load( rotation[ 0 ], rotation[ 1 ], rotation[ 2 ], rotation[ 3 ] );
+
+	Simd::Matrix44Soa transformSoa;
+	transformSoa.SetRotationTranslationScaling( rotationSoa, positionSoa, Simd::LoadAligned( scale ) );
+
+	if ( rLevel.m_HasParents )
+	{
+		// Parents are one level up, so their world transforms were finished before this level started
+		for ( size_t lane = 0; lane < TRANSFORM_BATCH_SIZE; ++lane )
+		{
+			const TransformComponent *pParent = ppTransforms[ lane < count ? lane : 0 ]->m_Parent.UncheckedGet();
+			HELIUM_ASSERT( pParent );
 
-void ClearTransformComponentDirtyFlags( TransformComponent *pComponent )
+			const Simd::Matrix44 &rParentTransform = pParent->GetWorldTransform();
+			for ( size_t elementIndex = 0; elementIndex < 16; ++elementIndex )
+			{
+				elements[ elementIndex ][ lane ] = rParentTransform.GetElement( elementIndex );
+			}
+		}
+
+		Simd::Matrix44Soa parentSoa;
+		for ( size_t elementIndex = 0; elementIndex < 16; ++elementIndex )
+		{
+			parentSoa.m_matrix[ elementIndex / 4 ][ elementIndex % 4 ] = Simd::LoadAligned( elements[ elementIndex ] );
+		}
+
+		transformSoa.MultiplySet( transformSoa, parentSoa );
+	}
+
+	for ( size_t elementIndex = 0; elementIndex < 16; ++elementIndex )
+	{
+		Simd::StoreAligned( elements[ elementIndex ], transformSoa.m_matrix[ elementIndex / 4 ][ elementIndex % 4 ] );
+	}
+
+	for ( size_t lane = 0; lane < count; ++lane )
+	{
+		Simd::Matrix44 &rWorldTransform = ppTransforms[ lane ]->GetStreamElement< Simd::Matrix44 >( TransformComponent::STREAM_WORLD_TRANSFORM );
+		for ( size_t elementIndex = 0; elementIndex < 16; ++elementIndex )
+		{
+			rWorldTransform.SetElement( elementIndex, elements[ elementIndex ][ lane ] );
+		}
+	}
+}
+
+void UpdateTransformComponents( World *pWorld )
+{
+	ComponentManager *pComponentManager = pWorld->GetComponentManager();
+	HELIUM_ASSERT( pComponentManager );
+
+	// Bucket every transform by its depth in the hierarchy. Nearly everything is a root, so deeper levels stay small
+	DynamicArray< DynamicArray< TransformComponent * > > transformsByDepth;
+
+	const DynamicArray< Components::TypeId > &implementingTypes = Components::GetTypeData( Components::GetType< TransformComponent >() )->m_ImplementingTypes;
+	for ( DynamicArray< Components::TypeId >::ConstIterator iter = implementingTypes.Begin(); iter != implementingTypes.End(); ++iter )
+	{
+		const Components::Pool *pPool = pComponentManager->GetPool( *iter );
+		if ( !pPool )
+		{
+			continue;
+		}
+
+		const Components::ComponentIndex allocatedCount = pPool->GetAllocatedCount();
+		for ( Components::ComponentIndex rosterIndex = 0; rosterIndex < allocatedCount; ++rosterIndex )
+		{
+			TransformComponent *pTransform = static_cast< TransformComponent * >( pPool->GetComponentByRosterIndex( rosterIndex ) );
+
+			size_t depth = 0;
+			for ( TransformComponent *pParent = pTransform->GetParent(); pParent; pParent = pParent->GetParent() )
+			{
+				++depth;
+			}
+
+			while ( transformsByDepth.GetSize() <= depth )
+			{
+				transformsByDepth.New();
+			}
+
+			transformsByDepth[ depth ].Push( pTransform );
+		}
+	}
+
+	// Resolve one level at a time: a transform needs a new world transform if it changed itself or if its parent got
+	// one this frame. Children of a moved parent are flagged dirty too so their consumers pick up the change
+	TransformLevel level;
+	for ( size_t depth = 0; depth < transformsByDepth.GetSize(); ++depth )
+	{
+		const DynamicArray< TransformComponent * > &rCandidates = transformsByDepth[ depth ];
+
+		level.m_Transforms.Resize( 0 );
+		level.m_HasParents = ( depth != 0 );
+
+		for ( DynamicArray< TransformComponent * >::ConstIterator iter = rCandidates.Begin(); iter != rCandidates.End(); ++iter )
+		{
+			TransformComponent *pTransform = *iter;
+			bool &rDirty = pTransform->GetStreamElement< bool >( TransformComponent::STREAM_DIRTY );
+			if ( depth != 0 && pTransform->m_Parent.UncheckedGet()->IsDirty() )
+			{
+				rDirty = true;
+			}
+
+			if ( rDirty )
+			{
+				level.m_Transforms.Push( pTransform );
+			}
+		}
+
+		const size_t batchCount = ( level.m_Transforms.GetSize() + TRANSFORM_BATCH_SIZE - 1 ) / TRANSFORM_BATCH_SIZE;
+		JobManager::ParallelFor( UpdateTransformBatch, &level, batchCount );
+	}
+}
+
+void Helium::UpdateTransformComponentsTask::DefineContract( TaskContract &rContract )
 {
-	pComponent->ClearDirtyFlag();
+	rContract.ExecuteAfter<StandardDependencies::ProcessPhysics>();
+	rContract.ExecuteBefore<StandardDependencies::Render>();
+
+	// Worlds have no transforms in common. Within a world, batches of a level only write their own transforms
+	rContract.DisjointComponentWrites();
+}
+
+HELIUM_DEFINE_TASK( UpdateTransformComponentsTask, (ParallelForEachWorld< UpdateTransformComponents >), TickTypes::Render )
+
+void ClearTransformComponentDirtyFlags( World *pWorld )
+{
+	ComponentManager *pComponentManager = pWorld->GetComponentManager();
+	HELIUM_ASSERT( pComponentManager );
+
+	// The dirty flags of each pool are one packed stream, so clearing them is a single fill per pool
+	const DynamicArray< Components::TypeId > &implementingTypes = Components::GetTypeData( Components::GetType< TransformComponent >() )->m_ImplementingTypes;
+	for ( DynamicArray< Components::TypeId >::ConstIterator iter = implementingTypes.Begin(); iter != implementingTypes.End(); ++iter )
+	{
+		const Components::Pool *pPool = pComponentManager->GetPool( *iter );
+		if ( pPool && pPool->GetAllocatedCount() )
+		{
+			MemoryZero( pPool->GetStream< bool >( TransformComponent::STREAM_DIRTY ), pPool->GetAllocatedCount() * sizeof( bool ) );
+		}
+	}
 }
 
 void Helium::ClearTransformComponentDirtyFlagsTask::DefineContract( TaskContract &rContract )
 {
 	rContract.ExecuteAfter<StandardDependencies::Render>();
+	rContract.DisjointComponentWrites();
 }
 
-//HELIUM_DEFINE_TASK(ClearTransformComponentDirtyFlagsTask, ForEachWorld<ClearTransformComponentDirtyFlags> )
-HELIUM_DEFINE_TASK( ClearTransformComponentDirtyFlagsTask, (ForEachWorld< QueryComponents< TransformComponent, ClearTransformComponentDirtyFlags > >), TickTypes::Render )
+HELIUM_DEFINE_TASK( ClearTransformComponentDirtyFlagsTask, (ParallelForEachWorld< ClearTransformComponentDirtyFlags >), TickTypes::Render )
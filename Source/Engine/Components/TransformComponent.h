@@ -16,24 +16,63 @@ namespace Helium
 		HELIUM_DECLARE_COMPONENT( Helium::TransformComponent, Helium::Component );
 		static void PopulateMetaType( Reflect::MetaStruct& comp );
 
+		// Position, rotation and the dirty flag are kept in SoA streams of the pool rather than in the component, so
+		// passes over every transform only touch the field they need. The world transform is written once per frame by
+		// UpdateTransformComponentsTask for every transform that is dirty or has a dirty parent
+		enum Streams
+		{
+			STREAM_POSITION,
+			STREAM_ROTATION,
+			STREAM_DIRTY,
+			STREAM_WORLD_TRANSFORM,
+		};
+		static void DeclareStreams( Components::StreamList& rStreams );
+
+		// Spatial layer every transform starts on. Other bits are free for gameplay code to assign
+		static const uint32_t SPATIAL_LAYER_DEFAULT = 1 << 0;
+
 		void Initialize( const TransformComponentDefinition &definition );
 				
-		inline const Simd::Vector3& GetPosition() const { return m_Position; }
-		virtual void SetPosition( const Simd::Vector3& rPosition ) { m_Position = rPosition; m_bDirty = true; }
+		inline const Simd::Vector3& GetPosition() const { return GetStreamElement< Simd::Vector3 >( STREAM_POSITION ); }
+		virtual void SetPosition( const Simd::Vector3& rPosition ) { GetStreamElement< Simd::Vector3 >( STREAM_POSITION ) = rPosition; GetStreamElement< bool >( STREAM_DIRTY ) = true; }
 
-		inline const Simd::Quat& GetRotation() const { return m_Rotation; }
-		virtual void SetRotation( const Simd::Quat& rRotation ) { m_Rotation = rRotation; m_bDirty = true; }
+		inline const Simd::Quat& GetRotation() const { return GetStreamElement< Simd::Quat >( STREAM_ROTATION ); }
+		virtual void SetRotation( const Simd::Quat& rRotation ) { GetStreamElement< Simd::Quat >( STREAM_ROTATION ) = rRotation; GetStreamElement< bool >( STREAM_DIRTY ) = true; }
+
+		// Direct access to position and rotation storage for systems that drive a transform every frame, such as physics.
+		// Marks the transform dirty
+		inline Simd::Vector3& ModifyPosition() { GetStreamElement< bool >( STREAM_DIRTY ) = true; return GetStreamElement< Simd::Vector3 >( STREAM_POSITION ); }
+		inline Simd::Quat& ModifyRotation() { GetStreamElement< bool >( STREAM_DIRTY ) = true; return GetStreamElement< Simd::Quat >( STREAM_ROTATION ); }
 
 		inline float32_t GetScale() const { return m_Scale; }
-		virtual void SetScale( float32_t scale ) { m_Scale = scale; }
+		virtual void SetScale( float32_t scale ) { m_Scale = scale; GetStreamElement< bool >( STREAM_DIRTY ) = true; }
 
-		bool IsDirty() const { return m_bDirty; }
-		void ClearDirtyFlag() { m_bDirty = false; }
+		// Position, rotation and scale are relative to the parent transform, if any
+		inline TransformComponent* GetParent() { return m_Parent.Get(); }
+		void SetParent( TransformComponent* pParent );
+
+		// Local-to-world matrix as of the last UpdateTransformComponentsTask
+		inline const Simd::Matrix44& GetWorldTransform() const { return GetStreamElement< Simd::Matrix44 >( STREAM_WORLD_TRANSFORM ); }
+
+		bool IsDirty() const { return GetStreamElement< bool >( STREAM_DIRTY ); }
+		void ClearDirtyFlag() { GetStreamElement< bool >( STREAM_DIRTY ) = false; }
+
+		// Bit mask of the layers SpatialHashComponent indexes the transform under. Marks the transform dirty
+		inline uint32_t GetSpatialLayers() const { return m_SpatialLayers; }
+		inline void SetSpatialLayers( uint32_t layers ) { m_SpatialLayers = layers; GetStreamElement< bool >( STREAM_DIRTY ) = true; }
+
+		// Save and restore the state kept outside of the streams (see HELIUM_COMPONENT_CUSTOM_SNAPSHOT). The parent and
+		// the spatial hash entry are left as they are, and a restored transform is marked dirty so that its world
+		// transform and spatial hash entry catch up
+		void SaveSnapshot( DynamicArray< uint8_t >& rData ) const;
+		void RestoreSnapshot( const uint8_t*& rpData );
 
-		Simd::Vector3 m_Position;
-		Simd::Quat m_Rotation;
 		float32_t m_Scale;
-		bool m_bDirty;
+		ComponentHandle< TransformComponent > m_Parent;
+
+		uint32_t m_SpatialLayers;
+		// Entry of the transform in the world's SpatialHashComponent, maintained by the spatial hash
+		uint32_t m_SpatialHashIndex;
 	};
 	typedef Helium::ComponentPtr<TransformComponent> TransformComponentPtr;
 		
@@ -50,6 +89,11 @@ namespace Helium
 		inline const Simd::Quat& GetRotation() const { return m_Rotation; }
 		virtual void SetRotation( const Simd::Quat& rRotation ) { m_Rotation = rRotation; }
 
+		// Direct access to position and rotation storage for systems that drive a transform every frame, such as physics.
+		// Marks the transform dirty
+		inline Simd::Vector3& ModifyPosition() { GetStreamElement< bool >( STREAM_DIRTY ) = true; return GetStreamElement< Simd::Vector3 >( STREAM_POSITION ); }
+		inline Simd::Quat& ModifyRotation() { GetStreamElement< bool >( STREAM_DIRTY ) = true; return GetStreamElement< Simd::Quat >( STREAM_ROTATION ); }
+
 		inline float32_t GetScale() const { return m_Scale; }
 		virtual void SetScale( float32_t scale ) { m_Scale = scale; }
 
@@ -59,9 +103,20 @@ namespace Helium
 	};
 	typedef StrongPtr<TransformComponentDefinition> TransformComponentDefinitionPtr;
 
+	// Builds the world transform of every dirty transform, and of every child of a dirty transform, in SoA batches.
+	// Hierarchies are resolved one depth level at a time so each level can be split across job threads
+	struct HELIUM_COMPONENTS_API UpdateTransformComponentsTask : public TaskDefinition
+	{
+		HELIUM_DECLARE_TASK(UpdateTransformComponentsTask);
+		virtual void DefineContract(TaskContract &rContract);
+	};
+
 	struct HELIUM_COMPONENTS_API ClearTransformComponentDirtyFlagsTask : public TaskDefinition
 	{
 		HELIUM_DECLARE_TASK(ClearTransformComponentDirtyFlagsTask);
 		virtual void DefineContract(TaskContract &rContract);
 	};
 }
+
+HELIUM_CACHE_COMPONENT_SLOT( Helium::TransformComponent, 0 )
+HELIUM_COMPONENT_CUSTOM_SNAPSHOT( Helium::TransformComponent )
@@ -19,6 +19,234 @@ HELIUM_IMPLEMENT_ASSET( Helium::AnimationResourceHandler, EditorSupport, 0 );
 
 using namespace Helium;
 
+#if !HELIUM_USE_GRANNY_ANIMATION
+/// Largest rotation error allowed when dropping a key (one minus the dot product of the rotations).
+static const float32_t ROTATION_ERROR_TOLERANCE = 1.0e-5f;
+/// Largest translation error allowed on each axis when dropping a key.
+static const float32_t TRANSLATION_ERROR_TOLERANCE = 1.0e-3f;
+/// Largest scale error allowed on each axis when dropping a key.
+static const float32_t SCALE_ERROR_TOLERANCE = 1.0e-3f;
+
+/// Flip key rotations so that each one is in the same hemisphere as the one before it.
+///
+/// @param[in] rKeys  Track key frames.
+static void MakeRotationsContinuous( DynamicArray< FbxSupport::Key >& rKeys )
+{
+    size_t keyCount = rKeys.GetSize();
+    for( size_t keyIndex = 1; keyIndex < keyCount; ++keyIndex )
+    {
+        const Simd::Quat& rPrevious = rKeys[ keyIndex - 1 ].rotation;
+        Simd::Quat& rRotation = rKeys[ keyIndex ].rotation;
+
+        float32_t dot = 0.0f;
+        for( size_t componentIndex = 0; componentIndex < 4; ++componentIndex )
+        {
+            dot += rPrevious.GetElement( componentIndex ) * rRotation.GetElement( componentIndex );
+        }
+
+        if( dot < 0.0f )
+        {
+            rRotation = Simd::Quat(
+                -rRotation.GetElement( 0 ),
+                -rRotation.GetElement( 1 ),
+                -rRotation.GetElement( 2 ),
+                -rRotation.GetElement( 3 ) );
+        }
+    }
+}
+
+/// Get whether a key is reproduced within tolerance by interpolating between two other keys.
+///
+/// Rotations are interpolated with a normalized linear interpolation, as they are at runtime.
+///
+/// @param[in] rKey0  Key before the tested key.
+/// @param[in] rKey1  Key after the tested key.
+/// @param[in] blend  Position of the tested key between the other two.
+/// @param[in] rKey   Tested key.
+///
+/// @return  True if the key is within tolerance, false if not.
+static bool IsKeyInterpolated(
+    const FbxSupport::Key& rKey0,
+    const FbxSupport::Key& rKey1,
+    float32_t blend,
+    const FbxSupport::Key& rKey )
+{
+    float32_t rotation[ 4 ];
+    float32_t magnitudeSquared = 0.0f;
+    for( size_t componentIndex = 0; componentIndex < 4; ++componentIndex )
+    {
+        float32_t component0 = rKey0.rotation.GetElement( componentIndex );
+        rotation[ componentIndex ] =
+            component0 + ( rKey1.rotation.GetElement( componentIndex ) - component0 ) * blend;
+        magnitudeSquared += rotation[ componentIndex ] * rotation[ componentIndex ];
+    }
+
+    float32_t dot = 0.0f;
+    for( size_t componentIndex = 0; componentIndex < 4; ++componentIndex )
+    {
+        dot += rotation[ componentIndex ] * rKey.rotation.GetElement( componentIndex );
+    }
+
+    if( magnitudeSquared <= HELIUM_EPSILON ||
+        1.0f - Abs( dot ) / sqrtf( magnitudeSquared ) > ROTATION_ERROR_TOLERANCE )
+    {
+        return false;
+    }
+
+    for( size_t componentIndex = 0; componentIndex < 3; ++componentIndex )
+    {
+        float32_t translation0 = rKey0.translation.GetElement( componentIndex );
+        float32_t translation = translation0 + ( rKey1.translation.GetElement( componentIndex ) - translation0 ) * blend;
+        if( Abs( translation - rKey.translation.GetElement( componentIndex ) ) > TRANSLATION_ERROR_TOLERANCE )
+        {
+            return false;
+        }
+
+        float32_t scale0 = rKey0.scale.GetElement( componentIndex );
+        float32_t scale = scale0 + ( rKey1.scale.GetElement( componentIndex ) - scale0 ) * blend;
+        if( Abs( scale - rKey.scale.GetElement( componentIndex ) ) > SCALE_ERROR_TOLERANCE )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Pick the key frames of a track that cannot be rebuilt by interpolating between their neighbors.
+///
+/// Each span between kept keys is grown one frame at a time until interpolating across it would put any of the
+/// frames it covers out of tolerance.  Tracks that hold still for the whole animation are reduced to a single key.
+///
+/// @param[in]  rKeys        Track key frames (one for each frame).
+/// @param[out] rKeptFrames  Indices of the frames to keep, in order.
+static void ReduceKeys( const DynamicArray< FbxSupport::Key >& rKeys, DynamicArray< uint32_t >& rKeptFrames )
+{
+    rKeptFrames.Resize( 0 );
+
+    size_t keyCount = rKeys.GetSize();
+    if( keyCount == 0 )
+    {
+        return;
+    }
+
+    rKeptFrames.Push( 0 );
+
+    bool bConstant = true;
+    for( size_t keyIndex = 1; keyIndex < keyCount && bConstant; ++keyIndex )
+    {
+        bConstant = IsKeyInterpolated( rKeys[ 0 ], rKeys[ 0 ], 0.0f, rKeys[ keyIndex ] );
+    }
+
+    if( bConstant )
+    {
+        return;
+    }
+
+    size_t anchorIndex = 0;
+    size_t endIndex = 2;
+    while( endIndex < keyCount )
+    {
+        const FbxSupport::Key& rAnchor = rKeys[ anchorIndex ];
+        const FbxSupport::Key& rEnd = rKeys[ endIndex ];
+        float32_t inverseSpan = 1.0f / static_cast< float32_t >( endIndex - anchorIndex );
+
+        bool bSpanValid = true;
+        for( size_t keyIndex = anchorIndex + 1; keyIndex < endIndex && bSpanValid; ++keyIndex )
+        {
+            float32_t blend = static_cast< float32_t >( keyIndex - anchorIndex ) * inverseSpan;
+            bSpanValid = IsKeyInterpolated( rAnchor, rEnd, blend, rKeys[ keyIndex ] );
+        }
+
+        if( bSpanValid )
+        {
+            ++endIndex;
+        }
+        else
+        {
+            anchorIndex = endIndex - 1;
+            rKeptFrames.Push( static_cast< uint32_t >( anchorIndex ) );
+            endIndex = anchorIndex + 2;
+        }
+    }
+
+    rKeptFrames.Push( static_cast< uint32_t >( keyCount - 1 ) );
+}
+
+/// Compress the kept keys of a track and add them to the animation data.
+///
+/// @param[in] rData        Animation data to update.
+/// @param[in] name         Name of the bone animated by the track.
+/// @param[in] rKeys        Track key frames (one for each frame).
+/// @param[in] rKeptFrames  Indices of the frames to keep.
+static void AddTrack(
+    Animation::PersistentResourceData& rData,
+    Name name,
+    const DynamicArray< FbxSupport::Key >& rKeys,
+    const DynamicArray< uint32_t >& rKeptFrames )
+{
+    rData.m_trackNames.Push( name );
+    rData.m_trackKeyOffsets.Push( static_cast< uint32_t >( rData.m_keyFrames.GetSize() ) );
+
+    size_t keptCount = rKeptFrames.GetSize();
+    HELIUM_ASSERT( keptCount != 0 );
+
+    // Quantize translations and scales within the range covered by the kept keys.
+    float32_t translationRange[ 6 ];
+    float32_t scaleRange[ 6 ];
+    for( size_t componentIndex = 0; componentIndex < 3; ++componentIndex )
+    {
+        float32_t translationMin = rKeys[ rKeptFrames[ 0 ] ].translation.GetElement( componentIndex );
+        float32_t translationMax = translationMin;
+        float32_t scaleMin = rKeys[ rKeptFrames[ 0 ] ].scale.GetElement( componentIndex );
+        float32_t scaleMax = scaleMin;
+        for( size_t keptIndex = 1; keptIndex < keptCount; ++keptIndex )
+        {
+            const FbxSupport::Key& rKey = rKeys[ rKeptFrames[ keptIndex ] ];
+            translationMin = Min( translationMin, rKey.translation.GetElement( componentIndex ) );
+            translationMax = Max( translationMax, rKey.translation.GetElement( componentIndex ) );
+            scaleMin = Min( scaleMin, rKey.scale.GetElement( componentIndex ) );
+            scaleMax = Max( scaleMax, rKey.scale.GetElement( componentIndex ) );
+        }
+
+        translationRange[ componentIndex ] = translationMin;
+        translationRange[ componentIndex + 3 ] = translationMax - translationMin;
+        scaleRange[ componentIndex ] = scaleMin;
+        scaleRange[ componentIndex + 3 ] = scaleMax - scaleMin;
+    }
+
+    for( size_t valueIndex = 0; valueIndex < HELIUM_ARRAY_COUNT( translationRange ); ++valueIndex )
+    {
+        rData.m_trackTranslationRanges.Push( translationRange[ valueIndex ] );
+        rData.m_trackScaleRanges.Push( scaleRange[ valueIndex ] );
+    }
+
+    for( size_t keptIndex = 0; keptIndex < keptCount; ++keptIndex )
+    {
+        uint32_t frameIndex = rKeptFrames[ keptIndex ];
+        const FbxSupport::Key& rKey = rKeys[ frameIndex ];
+
+        rData.m_keyFrames.Push( static_cast< uint16_t >( frameIndex ) );
+
+        uint16_t packedRotation[ 3 ];
+        Animation::PackRotation( rKey.rotation, packedRotation );
+
+        for( size_t componentIndex = 0; componentIndex < 3; ++componentIndex )
+        {
+            rData.m_keyRotations.Push( packedRotation[ componentIndex ] );
+            rData.m_keyTranslations.Push( Animation::QuantizeComponent(
+                rKey.translation.GetElement( componentIndex ),
+                translationRange[ componentIndex ],
+                translationRange[ componentIndex + 3 ] ) );
+            rData.m_keyScales.Push( Animation::QuantizeComponent(
+                rKey.scale.GetElement( componentIndex ),
+                scaleRange[ componentIndex ],
+                scaleRange[ componentIndex + 3 ] ) );
+        }
+    }
+}
+#endif  // !HELIUM_USE_GRANNY_ANIMATION
+
 /// Constructor.
 AnimationResourceHandler::AnimationResourceHandler()
 : m_rFbxSupport( FbxSupport::StaticAcquire() )
@@ -68,14 +296,84 @@ bool AnimationResourceHandler::CacheResource(
 
     return bCacheResult;
 #else
-    HELIUM_UNREF( pAssetPreprocessor );
-    HELIUM_UNREF( rSourceFilePath );
+    StrongPtr< Animation::PersistentResourceData > persistentResourceData( new Animation::PersistentResourceData() );
+    persistentResourceData->GetRefCountProxy()->AddStrongRef(); // stack allocated object!!
+
+    // Load the source key frames, one for each frame of the animation in every track.
+    DynamicArray< FbxSupport::AnimTrackData > tracks;
+    uint_fast32_t samplesPerSecond = 0;
+
+    bool bLoadSuccess = m_rFbxSupport.LoadAnimation( rSourceFilePath, 1, tracks, samplesPerSecond );
+    if( !bLoadSuccess )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "AnimationResourceHandler::CacheResource(): Failed to build animation from source file \"%s\".\n",
+            *rSourceFilePath );
+
+        return false;
+    }
+
+    size_t trackCount = tracks.GetSize();
+    size_t frameCount = ( trackCount != 0 ? tracks[ 0 ].keys.GetSize() : 0 );
+    if( frameCount > static_cast< size_t >( UINT16_MAX ) + 1 )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "AnimationResourceHandler::CacheResource(): Animation in source file \"%s\" has %" PRIuSZ " frames, which exceeds the limit of %" PRIu32 ".\n",
+            *rSourceFilePath,
+            frameCount,
+            static_cast< uint32_t >( UINT16_MAX ) + 1 );
+
+        return false;
+    }
 
+    persistentResourceData->m_frameCount = static_cast< uint32_t >( frameCount );
+    persistentResourceData->m_framesPerSecond = static_cast< float32_t >( samplesPerSecond );
+    persistentResourceData->m_trackNames.Reserve( trackCount );
+    persistentResourceData->m_trackKeyOffsets.Reserve( trackCount + 1 );
+    persistentResourceData->m_trackTranslationRanges.Reserve( trackCount * 6 );
+    persistentResourceData->m_trackScaleRanges.Reserve( trackCount * 6 );
+
+    size_t sourceKeyCount = 0;
+    DynamicArray< uint32_t > keptFrames;
+    for( size_t trackIndex = 0; trackIndex < trackCount; ++trackIndex )
+    {
+        FbxSupport::AnimTrackData& rTrack = tracks[ trackIndex ];
+        DynamicArray< FbxSupport::Key >& rKeys = rTrack.keys;
+        HELIUM_ASSERT( rKeys.GetSize() == frameCount );
+        sourceKeyCount += rKeys.GetSize();
+
+        MakeRotationsContinuous( rKeys );
+        ReduceKeys( rKeys, keptFrames );
+
+        AddTrack( *persistentResourceData, rTrack.name, rKeys, keptFrames );
+    }
+
+    persistentResourceData->m_trackKeyOffsets.Push(
+        static_cast< uint32_t >( persistentResourceData->m_keyFrames.GetSize() ) );
+
+    HELIUM_TRACE(
+        TraceLevels::Debug,
+        "AnimationResourceHandler::CacheResource(): Kept %" PRIuSZ " of %" PRIuSZ " keys in %" PRIuSZ " tracks of \"%s\".\n",
+        persistentResourceData->m_keyFrames.GetSize(),
+        sourceKeyCount,
+        trackCount,
+        *rSourceFilePath );
+
+    // Cache the data for each supported platform.
     for( size_t platformIndex = 0; platformIndex < static_cast< size_t >( Cache::PLATFORM_MAX ); ++platformIndex )
     {
+        PlatformPreprocessor* pPreprocessor = pAssetPreprocessor->GetPlatformPreprocessor(
+            static_cast< Cache::EPlatform >( platformIndex ) );
+        if( !pPreprocessor )
+        {
+            continue;
+        }
+
         Resource::PreprocessedData& rPreprocessedData = pResource->GetPreprocessedData(
             static_cast< Cache::EPlatform >( platformIndex ) );
-        rPreprocessedData.persistentDataBuffer.Clear();
+        Cache::WriteCacheObjectToBuffer( persistentResourceData.Get(), rPreprocessedData.persistentDataBuffer );
         rPreprocessedData.subDataBuffers.Clear();
         rPreprocessedData.bLoaded = true;
     }
@@ -4,6 +4,7 @@
 
 #include "EditorSupport/FbxSupport.h"
 
+#include "Platform/File.h"
 #include "MathSimd/Vector2.h"
 #include "Foundation/StringConverter.h"
 #include "Math/Color.h"
@@ -262,6 +263,8 @@ static void FlipTransform( FbxMatrix& rTransform )
 /// Destructor.
 FbxSupport::~FbxSupport()
 {
+	ClearSceneCache();
+
 	if( m_pSdkManager )
 	{
 		HELIUM_ASSERT( m_pIoSettings );
@@ -311,56 +314,10 @@ bool FbxSupport::LoadMesh(
 						  DynamicArray< uint8_t >& rSkinningPaletteMap,
 						  bool bStripNamespaces )
 {
-	LazyInitialize();
-
-#if HELIUM_OS_WIN
-	// Convert the source file path to a UTF-8 string readable by the FBX SDK.
-	char* pConvertedFilePath = NULL;
-	FbxAnsiToUTF8( *rSourceFilePath, pConvertedFilePath );
-#else
-	const char* pConvertedFilePath = NULL;
-	pConvertedFilePath = *rSourceFilePath;
-#endif
-	if( !pConvertedFilePath )
+	// Import the scene, or reuse the scene already imported for an earlier mesh or animation load.
+	FbxScene* pScene = AcquireScene( rSourceFilePath );
+	if( !pScene )
 	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"FbxSupport::LoadMesh(): Failed to convert source file path string \"%s\" to a UTF-8 string for use with the FBX SDK.\n",
-			*rSourceFilePath );
-
-		return false;
-	}
-
-	// Import the mesh into a new scene.
-	FbxScene* pScene = FbxScene::Create( m_pSdkManager, "Import Scene" );
-	HELIUM_ASSERT( pScene );
-
-	HELIUM_ASSERT( m_pImporter );
-	HELIUM_ASSERT( m_pIoSettings );
-	if( !m_pImporter->Initialize( pConvertedFilePath, -1, m_pIoSettings ) )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"FbxSupport::LoadMesh(): Initialization of FBX importer for source file \"%s\" failed.\n",
-			*rSourceFilePath );
-
-		return false;
-	}
-
-	m_pIoSettings->SetBoolProp( IMP_FBX_MODEL, true );
-	m_pIoSettings->SetBoolProp( IMP_FBX_ANIMATION, false );
-	m_pIoSettings->SetBoolProp( IMP_FBX_MATERIAL, false );
-	m_pIoSettings->SetBoolProp( IMP_FBX_TEXTURE, false );
-
-	if( !m_pImporter->Import( pScene ) )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"FbxSupport::LoadMesh(): Failed to import source file \"%s\".\n",
-			*rSourceFilePath );
-
-		pScene->Destroy();
-
 		return false;
 	}
 
@@ -375,8 +332,6 @@ bool FbxSupport::LoadMesh(
 		rSkinningPaletteMap,
 		bStripNamespaces );
 
-	pScene->Destroy();
-
 	if( !bParseSuccess )
 	{
 		HELIUM_TRACE(
@@ -405,57 +360,10 @@ bool FbxSupport::LoadAnimation(
 							   uint_fast32_t& rSamplesPerSecond,
 							   bool bStripNamespaces )
 {
-	LazyInitialize();
-
-#if HELIUM_OS_WIN
-	// Convert the source file path to a UTF-8 string readable by the FBX SDK.
-	char* pConvertedFilePath = NULL;
-	FbxAnsiToUTF8( *rSourceFilePath, pConvertedFilePath );
-#else
-	const char* pConvertedFilePath = NULL;
-	pConvertedFilePath = *rSourceFilePath;
-#endif
-	
-	if( !pConvertedFilePath )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"FbxSupport::LoadAnimation(): Failed to convert source file path string \"%s\" to a UTF-8 string for use with the FBX SDK.\n",
-			*rSourceFilePath );
-
-		return false;
-	}
-
-	// Import the animation into a new scene.
-	FbxScene* pScene = FbxScene::Create( m_pSdkManager, "Import Scene" );
-	HELIUM_ASSERT( pScene );
-
-	HELIUM_ASSERT( m_pImporter );
-	HELIUM_ASSERT( m_pIoSettings );
-	if( !m_pImporter->Initialize( pConvertedFilePath, -1, m_pIoSettings ) )
+	// Import the scene, or reuse the scene already imported for an earlier mesh or animation load.
+	FbxScene* pScene = AcquireScene( rSourceFilePath );
+	if( !pScene )
 	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"FbxSupport::LoadAnimation(): Initialization of FBX importer for source file \"%s\" failed.\n",
-			*rSourceFilePath );
-
-		return false;
-	}
-
-	m_pIoSettings->SetBoolProp( IMP_FBX_MODEL, false );
-	m_pIoSettings->SetBoolProp( IMP_FBX_ANIMATION, true );
-	m_pIoSettings->SetBoolProp( IMP_FBX_MATERIAL, false );
-	m_pIoSettings->SetBoolProp( IMP_FBX_TEXTURE, false );
-
-	if( !m_pImporter->Import( pScene ) )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"FbxSupport::LoadAnimation(): Failed to import source file \"%s\".\n",
-			*rSourceFilePath );
-
-		pScene->Destroy();
-
 		return false;
 	}
 
@@ -466,8 +374,6 @@ bool FbxSupport::LoadAnimation(
 		rSamplesPerSecond,
 		bStripNamespaces );
 
-	pScene->Destroy();
-
 	if( !bParseSuccess )
 	{
 		HELIUM_TRACE(
@@ -479,6 +385,24 @@ bool FbxSupport::LoadAnimation(
 	return bParseSuccess;
 }
 
+/// Destroy all scenes kept in the scene cache.
+///
+/// Scenes are cached so that mesh, skeleton, and animation data can be extracted from a source file with a single
+/// import.  The cache is bounded by SCENE_CACHE_SIZE_MAX, but this can be called to free the memory used by the
+/// cached scenes once a set of resources is done being preprocessed.
+void FbxSupport::ClearSceneCache()
+{
+	size_t sceneCount = m_cachedScenes.GetSize();
+	for( size_t sceneIndex = 0; sceneIndex < sceneCount; ++sceneIndex )
+	{
+		FbxScene* pScene = m_cachedScenes[ sceneIndex ].pScene;
+		HELIUM_ASSERT( pScene );
+		pScene->Destroy();
+	}
+
+	m_cachedScenes.Clear();
+}
+
 /// Acquire a reference to the static instance of this class, creating it if necessary.
 ///
 /// When done using an FbxSupport instance, it should be released by calling Release() on the instance.
@@ -532,6 +456,135 @@ void FbxSupport::LazyInitialize()
 	HELIUM_TRACE( TraceLevels::Info, "FBX support layer initialized.\n" );
 }
 
+/// Get the imported scene for a source file, importing it if it is not already in the scene cache.
+///
+/// Scenes are imported with both model and animation data so that every load from the same source file can share a
+/// single import.  A cached scene is imported again if the file time stamp or size has changed since it was
+/// imported.
+///
+/// @param[in] rSourceFilePath  Path name of the source file to import.
+///
+/// @return  Imported scene if successful, null if importing failed.  The scene remains owned by the scene cache.
+FbxScene* FbxSupport::AcquireScene( const String& rSourceFilePath )
+{
+	LazyInitialize();
+
+	Status stat;
+	if( !stat.Read( *rSourceFilePath ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"FbxSupport::AcquireScene(): Source file \"%s\" does not exist.\n",
+			*rSourceFilePath );
+
+		return NULL;
+	}
+
+	size_t sceneCount = m_cachedScenes.GetSize();
+	for( size_t sceneIndex = 0; sceneIndex < sceneCount; ++sceneIndex )
+	{
+		CachedScene& rCachedScene = m_cachedScenes[ sceneIndex ];
+		if( rCachedScene.sourceFilePath != rSourceFilePath )
+		{
+			continue;
+		}
+
+		FbxScene* pScene = rCachedScene.pScene;
+		HELIUM_ASSERT( pScene );
+
+		bool bUpToDate =
+			( rCachedScene.timestamp == stat.m_ModifiedTime &&
+			  rCachedScene.size == static_cast< uint64_t >( stat.m_Size ) );
+		m_cachedScenes.Remove( sceneIndex );
+
+		if( bUpToDate )
+		{
+			// Move the scene to the end of the cache as the most recently used.
+			CachedScene* pCachedScene = m_cachedScenes.New();
+			HELIUM_ASSERT( pCachedScene );
+			pCachedScene->sourceFilePath = rSourceFilePath;
+			pCachedScene->timestamp = stat.m_ModifiedTime;
+			pCachedScene->size = static_cast< uint64_t >( stat.m_Size );
+			pCachedScene->pScene = pScene;
+
+			return pScene;
+		}
+
+		pScene->Destroy();
+
+		break;
+	}
+
+#if HELIUM_OS_WIN
+	// Convert the source file path to a UTF-8 string readable by the FBX SDK.
+	char* pConvertedFilePath = NULL;
+	FbxAnsiToUTF8( *rSourceFilePath, pConvertedFilePath );
+#else
+	const char* pConvertedFilePath = NULL;
+	pConvertedFilePath = *rSourceFilePath;
+#endif
+	if( !pConvertedFilePath )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"FbxSupport::AcquireScene(): Failed to convert source file path string \"%s\" to a UTF-8 string for use with the FBX SDK.\n",
+			*rSourceFilePath );
+
+		return NULL;
+	}
+
+	HELIUM_ASSERT( m_pImporter );
+	HELIUM_ASSERT( m_pIoSettings );
+	if( !m_pImporter->Initialize( pConvertedFilePath, -1, m_pIoSettings ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"FbxSupport::AcquireScene(): Initialization of FBX importer for source file \"%s\" failed.\n",
+			*rSourceFilePath );
+
+		return NULL;
+	}
+
+	m_pIoSettings->SetBoolProp( IMP_FBX_MODEL, true );
+	m_pIoSettings->SetBoolProp( IMP_FBX_ANIMATION, true );
+	m_pIoSettings->SetBoolProp( IMP_FBX_MATERIAL, false );
+	m_pIoSettings->SetBoolProp( IMP_FBX_TEXTURE, false );
+
+	FbxScene* pScene = FbxScene::Create( m_pSdkManager, "Import Scene" );
+	HELIUM_ASSERT( pScene );
+
+	if( !m_pImporter->Import( pScene ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"FbxSupport::AcquireScene(): Failed to import source file \"%s\".\n",
+			*rSourceFilePath );
+
+		pScene->Destroy();
+
+		return NULL;
+	}
+
+	// Evict the least recently used scene if the cache is full.
+	if( m_cachedScenes.GetSize() >= SCENE_CACHE_SIZE_MAX )
+	{
+		FbxScene* pEvictedScene = m_cachedScenes[ 0 ].pScene;
+		HELIUM_ASSERT( pEvictedScene );
+		pEvictedScene->Destroy();
+
+		m_cachedScenes.Remove( 0 );
+	}
+
+	CachedScene* pCachedScene = m_cachedScenes.New();
+	HELIUM_ASSERT( pCachedScene );
+	pCachedScene->sourceFilePath = rSourceFilePath;
+	pCachedScene->timestamp = stat.m_ModifiedTime;
+	pCachedScene->size = static_cast< uint64_t >( stat.m_Size );
+	pCachedScene->pScene = pScene;
+
+	return pScene;
+}
+
 /// Build skinning information from the scene for use in runtime rendering.
 ///
 /// @param[in]  pScene                Scene to parse.
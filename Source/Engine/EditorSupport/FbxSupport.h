@@ -123,11 +123,19 @@ namespace Helium
             uint_fast32_t& rSamplesPerSecond, bool bStripNamespaces = true );
         //@}
 
+        /// @name Scene Caching
+        //@{
+        void ClearSceneCache();
+        //@}
+
         /// @name Static Access
         //@{
         static FbxSupport& StaticAcquire();
         //@}
 
+        /// Maximum number of imported scenes kept in the scene cache.
+        static const size_t SCENE_CACHE_SIZE_MAX = 2;
+
     private:
         /// Information about a given bone in the skeleton relevant only while building the skinning data during mesh
         /// loading.
@@ -151,6 +159,19 @@ namespace Helium
             uint8_t parentIndex;
         };
 
+        /// Imported scene kept for reuse by later mesh and animation loads from the same source file.
+        struct CachedScene
+        {
+            /// Source file path.
+            String sourceFilePath;
+            /// Source file time stamp when imported.
+            int64_t timestamp;
+            /// Source file size when imported.
+            uint64_t size;
+            /// Imported scene.
+            FbxScene* pScene;
+        };
+
         /// FBX SDK manager instance.
         FbxManager* m_pSdkManager;
         /// IO settings instance.
@@ -163,6 +184,9 @@ namespace Helium
         FbxMemoryAllocator m_memoryAllocator;
 #endif  // HELIUM_ENABLE_FBX_MEMORY_ALLOCATOR
 
+        /// Cached scenes, ordered from least to most recently used.
+        DynamicArray< CachedScene > m_cachedScenes;
+
         /// Reference count.
         volatile int32_t m_referenceCount;
 
@@ -179,6 +203,8 @@ namespace Helium
         //@{
         void LazyInitialize();
 
+        FbxScene* AcquireScene( const String& rSourceFilePath );
+
         void BuildSkinningInformation(
             FbxScene* pScene, FbxMesh* pMesh, FbxNode* pSkeletonRootNode,
             const DynamicArray< int >& rControlPointIndices, const DynamicArray< uint16_t >& rSectionVertexCounts,
@@ -6,6 +6,8 @@
 
 #include "Engine/FileLocations.h"
 #include "Foundation/FileStream.h"
+#include "Platform/Locks.h"
+#include "EngineJobs/JobManager.h"
 #include "PcSupport/AssetPreprocessor.h"
 #include "PcSupport/PlatformPreprocessor.h"
 #include "EditorSupport/Image.h"
@@ -15,6 +17,8 @@
 
 #include <nvtt/nvtt.h>
 
+#include <algorithm>
+
 HELIUM_IMPLEMENT_ASSET( Helium::FontResourceHandler, EditorSupport, 0 );
 
 using namespace Helium;
@@ -22,6 +26,398 @@ using namespace Helium;
 /// Maximum Unicode code point value.
 static const uint_fast32_t UNICODE_CODE_POINT_MAX = 0x10ffff;
 
+/// Number of glyphs rasterized by each parallel rasterization job.
+static const size_t GLYPH_RASTERIZATION_BATCH_SIZE = 64;
+
+/// Lock for creating and destroying font faces in glyph rasterization jobs (a FreeType library instance may be shared
+/// across threads as long as face creation and destruction are synchronized).
+static Mutex s_freeTypeFaceLock;
+
+/// Glyph bitmap and metrics rasterized for a single character.
+struct RasterizedGlyph
+{
+    /// Unicode code point.
+    uint32_t codePoint;
+    /// Glyph index in the font face.
+    FT_UInt characterIndex;
+
+    /// Bitmap width, in pixels.
+    uint16_t bitmapWidth;
+    /// Bitmap height, in pixels.
+    uint16_t bitmapHeight;
+    /// 8-bit grayscale bitmap pixels, packed without any padding between rows.
+    DynamicArray< uint8_t > bitmap;
+
+    /// Glyph width, in 26.6 fixed-point pixels.
+    int32_t width;
+    /// Glyph height, in 26.6 fixed-point pixels.
+    int32_t height;
+    /// Horizontal bearing, in 26.6 fixed-point pixels.
+    int32_t bearingX;
+    /// Vertical bearing, in 26.6 fixed-point pixels.
+    int32_t bearingY;
+    /// Horizontal advance, in 26.6 fixed-point pixels.
+    int32_t advance;
+
+    /// Texture sheet position of the glyph bitmap.
+    uint16_t imageX;
+    /// Texture sheet position of the glyph bitmap.
+    uint16_t imageY;
+    /// Index of the texture sheet containing the glyph bitmap.
+    uint8_t texture;
+
+    /// True if the glyph was rasterized successfully.
+    bool bSuccess;
+};
+
+/// Context passed to the parallel glyph rasterization callback.
+struct GlyphRasterizationContext
+{
+    /// FreeType library instance.
+    FT_Library pLibrary;
+    /// Font file data.
+    const uint8_t* pFileData;
+    /// Font file data size, in bytes.
+    FT_Long fileSize;
+    /// Point size, in 26.6 fixed-point.
+    int32_t pointSize;
+    /// Font resolution, in DPI.
+    uint32_t dpi;
+    /// True to render anti-aliased glyphs, false to render monochrome glyphs.
+    bool bAntialiased;
+    /// Glyphs to rasterize.
+    RasterizedGlyph* pGlyphs;
+    /// Number of glyphs to rasterize.
+    size_t glyphCount;
+};
+
+/// Sort key for packing glyphs into texture sheets from tallest to shortest.
+struct GlyphPackSortKey
+{
+    /// Bitmap height.
+    uint16_t height;
+    /// Bitmap width.
+    uint16_t width;
+    /// Glyph index.
+    uint32_t glyphIndex;
+
+    /// Order glyphs by decreasing height, then decreasing width, then increasing index.
+    bool operator<( const GlyphPackSortKey& rOther ) const
+    {
+        if( height != rOther.height )
+        {
+            return ( height > rOther.height );
+        }
+
+        if( width != rOther.width )
+        {
+            return ( width > rOther.width );
+        }
+
+        return ( glyphIndex < rOther.glyphIndex );
+    }
+};
+
+/// Rectangle packer for font texture sheets, tracking the top edge of the filled area as a skyline of horizontal
+/// segments and placing each rectangle at the lowest position where it fits.
+class GlyphSkylinePacker
+{
+public:
+    /// Reset the packer for an empty sheet of the given size.
+    void Reset( uint32_t width, uint32_t height )
+    {
+        m_width = width;
+        m_height = height;
+
+        m_nodes.Resize( 0 );
+        Node* pNode = m_nodes.New();
+        HELIUM_ASSERT( pNode );
+        pNode->x = 0;
+        pNode->y = 0;
+        pNode->width = width;
+    }
+
+    /// Place a rectangle, returning false if it does not fit in the remaining space.
+    bool Insert( uint32_t width, uint32_t height, uint32_t& rX, uint32_t& rY )
+    {
+        size_t bestNodeIndex = Invalid< size_t >();
+        uint32_t bestTop = UINT32_MAX;
+        uint32_t bestNodeWidth = UINT32_MAX;
+        uint32_t bestY = 0;
+
+        size_t nodeCount = m_nodes.GetSize();
+        for( size_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex )
+        {
+            uint32_t y;
+            if( !Fit( nodeIndex, width, height, y ) )
+            {
+                continue;
+            }
+
+            uint32_t top = y + height;
+            uint32_t nodeWidth = m_nodes[ nodeIndex ].width;
+            if( top < bestTop || ( top == bestTop && nodeWidth < bestNodeWidth ) )
+            {
+                bestNodeIndex = nodeIndex;
+                bestTop = top;
+                bestNodeWidth = nodeWidth;
+                bestY = y;
+            }
+        }
+
+        if( IsInvalid( bestNodeIndex ) )
+        {
+            return false;
+        }
+
+        rX = m_nodes[ bestNodeIndex ].x;
+        rY = bestY;
+
+        // Raise the skyline over the placed rectangle, trimming or removing the segments it now covers.
+        Node newNode;
+        newNode.x = rX;
+        newNode.y = bestTop;
+        newNode.width = width;
+        m_nodes.Insert( bestNodeIndex, newNode );
+
+        uint32_t right = rX + width;
+        size_t nodeIndex = bestNodeIndex + 1;
+        while( nodeIndex < m_nodes.GetSize() )
+        {
+            Node& rNode = m_nodes[ nodeIndex ];
+            if( rNode.x >= right )
+            {
+                break;
+            }
+
+            uint32_t nodeRight = rNode.x + rNode.width;
+            if( nodeRight <= right )
+            {
+                m_nodes.Remove( nodeIndex );
+
+                continue;
+            }
+
+            rNode.width = nodeRight - right;
+            rNode.x = right;
+
+            break;
+        }
+
+        // Merge neighboring segments at the same height.
+        for( nodeIndex = 0; nodeIndex + 1 < m_nodes.GetSize(); )
+        {
+            Node& rNode = m_nodes[ nodeIndex ];
+            const Node& rNextNode = m_nodes[ nodeIndex + 1 ];
+            if( rNode.y == rNextNode.y )
+            {
+                rNode.width += rNextNode.width;
+                m_nodes.Remove( nodeIndex + 1 );
+            }
+            else
+            {
+                ++nodeIndex;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    /// Horizontal skyline segment.
+    struct Node
+    {
+        /// Left edge.
+        uint32_t x;
+        /// Height of the filled area below the segment.
+        uint32_t y;
+        /// Segment width.
+        uint32_t width;
+    };
+
+    /// Skyline segments, ordered from left to right.
+    DynamicArray< Node > m_nodes;
+    /// Sheet width.
+    uint32_t m_width;
+    /// Sheet height.
+    uint32_t m_height;
+
+    /// Get the lowest position at which a rectangle fits when its left edge is placed at the given segment.
+    bool Fit( size_t nodeIndex, uint32_t width, uint32_t height, uint32_t& rY ) const
+    {
+        uint32_t x = m_nodes[ nodeIndex ].x;
+        if( x + width > m_width )
+        {
+            return false;
+        }
+
+        uint32_t y = 0;
+        uint32_t remainingWidth = width;
+        size_t nodeCount = m_nodes.GetSize();
+        for( ; remainingWidth != 0 && nodeIndex < nodeCount; ++nodeIndex )
+        {
+            const Node& rNode = m_nodes[ nodeIndex ];
+            y = Max( y, rNode.y );
+            if( y + height > m_height )
+            {
+                return false;
+            }
+
+            remainingWidth -= Min( remainingWidth, rNode.width );
+        }
+
+        rY = y;
+
+        return true;
+    }
+};
+
+/// Copy a rendered FreeType glyph bitmap into 8-bit grayscale pixels.
+///
+/// @param[in]  rBitmap       Rendered glyph bitmap.
+/// @param[in]  bAntialiased  True if the bitmap was rendered as 8-bit grayscale, false if it was rendered as 1-bit
+///                           monochrome.
+/// @param[out] pDestPixels   Grayscale pixel buffer, packed without any padding between rows.
+static void CopyGlyphBitmap( const FT_Bitmap& rBitmap, bool bAntialiased, uint8_t* pDestPixels )
+{
+    uint_fast32_t glyphRowCount = static_cast< uint32_t >( rBitmap.rows );
+    uint_fast32_t glyphWidth = static_cast< uint32_t >( rBitmap.width );
+    int_fast32_t glyphPitch = rBitmap.pitch;
+
+    const uint8_t* pGlyphBuffer = rBitmap.buffer;
+    HELIUM_ASSERT( pGlyphBuffer || glyphRowCount == 0 );
+
+    if( bAntialiased )
+    {
+        // Anti-aliased fonts are rendered as 8-bit grayscale images, so just copy the data as-is.
+        for( uint_fast32_t rowIndex = 0; rowIndex < glyphRowCount; ++rowIndex )
+        {
+            MemoryCopy( pDestPixels, pGlyphBuffer, glyphWidth );
+            pGlyphBuffer += glyphPitch;
+            pDestPixels += glyphWidth;
+        }
+
+        return;
+    }
+
+    // Fonts without anti-aliasing are rendered as 1-bit monochrome images, so we need to manually convert each row to
+    // 8-bit grayscale.
+    for( uint_fast32_t rowIndex = 0; rowIndex < glyphRowCount; ++rowIndex )
+    {
+        const uint8_t* pGlyphPixelBlock = pGlyphBuffer;
+        pGlyphBuffer += glyphPitch;
+
+        uint_fast32_t remainingPixelCount = glyphWidth;
+        while( remainingPixelCount >= 8 )
+        {
+            remainingPixelCount -= 8;
+
+            uint8_t pixelBlock = *pGlyphPixelBlock;
+            ++pGlyphPixelBlock;
+
+            *( pDestPixels++ ) = ( ( pixelBlock & ( 1 << 7 ) ) ? 255 : 0 );
+            *( pDestPixels++ ) = ( ( pixelBlock & ( 1 << 6 ) ) ? 255 : 0 );
+            *( pDestPixels++ ) = ( ( pixelBlock & ( 1 << 5 ) ) ? 255 : 0 );
+            *( pDestPixels++ ) = ( ( pixelBlock & ( 1 << 4 ) ) ? 255 : 0 );
+            *( pDestPixels++ ) = ( ( pixelBlock & ( 1 << 3 ) ) ? 255 : 0 );
+            *( pDestPixels++ ) = ( ( pixelBlock & ( 1 << 2 ) ) ? 255 : 0 );
+            *( pDestPixels++ ) = ( ( pixelBlock & ( 1 << 1 ) ) ? 255 : 0 );
+            *( pDestPixels++ ) = ( ( pixelBlock & ( 1 << 0 ) ) ? 255 : 0 );
+        }
+
+        if( remainingPixelCount != 0 )
+        {
+            uint8_t pixelBlock = *pGlyphPixelBlock;
+            uint8_t mask = ( 1 << 7 );
+            while( remainingPixelCount != 0 )
+            {
+                *( pDestPixels++ ) = ( ( pixelBlock & mask ) ? 255 : 0 );
+                mask >>= 1;
+                --remainingPixelCount;
+            }
+        }
+    }
+}
+
+/// JobManager::ParallelFor() callback for rasterizing a batch of glyphs.
+///
+/// Each batch creates its own face from the shared font file data, as FreeType faces cannot be used by more than one
+/// thread at a time.
+///
+/// @param[in] pContext  GlyphRasterizationContext of the font being cached.
+/// @param[in] index     Index of the batch of GLYPH_RASTERIZATION_BATCH_SIZE glyphs to rasterize.
+static void RasterizeGlyphBatchCallback( void* pContext, size_t index )
+{
+    GlyphRasterizationContext* pRasterizationContext = static_cast< GlyphRasterizationContext* >( pContext );
+    HELIUM_ASSERT( pRasterizationContext );
+
+    size_t glyphStart = index * GLYPH_RASTERIZATION_BATCH_SIZE;
+    size_t glyphEnd = Min( glyphStart + GLYPH_RASTERIZATION_BATCH_SIZE, pRasterizationContext->glyphCount );
+
+    FT_Face pFace = NULL;
+    FT_Error error;
+    {
+        MutexScopeLock scopeLock( s_freeTypeFaceLock );
+        error = FT_New_Memory_Face(
+            pRasterizationContext->pLibrary,
+            pRasterizationContext->pFileData,
+            pRasterizationContext->fileSize,
+            0,
+            &pFace );
+    }
+
+    if( error != 0 )
+    {
+        return;
+    }
+
+    int32_t pointSize = pRasterizationContext->pointSize;
+    uint32_t dpi = pRasterizationContext->dpi;
+    if( FT_Set_Char_Size( pFace, pointSize, pointSize, dpi, dpi ) == 0 )
+    {
+        bool bAntialiased = pRasterizationContext->bAntialiased;
+
+        FT_Int32 glyphLoadFlags = FT_LOAD_RENDER;
+        if( !bAntialiased )
+        {
+            glyphLoadFlags |= FT_LOAD_TARGET_MONO;
+        }
+
+        for( size_t glyphIndex = glyphStart; glyphIndex < glyphEnd; ++glyphIndex )
+        {
+            RasterizedGlyph& rGlyph = pRasterizationContext->pGlyphs[ glyphIndex ];
+            if( FT_Load_Glyph( pFace, rGlyph.characterIndex, glyphLoadFlags ) != 0 )
+            {
+                continue;
+            }
+
+            FT_GlyphSlot pGlyph = pFace->glyph;
+            HELIUM_ASSERT( pGlyph );
+
+            HELIUM_ASSERT( pGlyph->bitmap.rows >= 0 );
+            HELIUM_ASSERT( pGlyph->bitmap.width >= 0 );
+            HELIUM_ASSERT( pGlyph->bitmap.rows <= UINT16_MAX );
+            HELIUM_ASSERT( pGlyph->bitmap.width <= UINT16_MAX );
+            rGlyph.bitmapWidth = static_cast< uint16_t >( pGlyph->bitmap.width );
+            rGlyph.bitmapHeight = static_cast< uint16_t >( pGlyph->bitmap.rows );
+
+            rGlyph.bitmap.Resize( static_cast< size_t >( rGlyph.bitmapWidth ) * rGlyph.bitmapHeight );
+            CopyGlyphBitmap( pGlyph->bitmap, bAntialiased, rGlyph.bitmap.GetData() );
+
+            rGlyph.width = pGlyph->metrics.width;
+            rGlyph.height = pGlyph->metrics.height;
+            rGlyph.bearingX = pGlyph->metrics.horiBearingX;
+            rGlyph.bearingY = pGlyph->metrics.horiBearingY;
+            rGlyph.advance = pGlyph->metrics.horiAdvance;
+
+            rGlyph.bSuccess = true;
+        }
+    }
+
+    MutexScopeLock scopeLock( s_freeTypeFaceLock );
+    FT_Done_Face( pFace );
+}
+
 /// Allocate a block of memory for FreeType.
 ///
 /// @param[in] pMemory  Handle to the source memory manager.
@@ -329,161 +725,181 @@ bool FontResourceHandler::CacheResource(
 
     MemoryZero( pTextureBuffer, texturePixelCount );
 
-    // Build the texture sheets for our glyphs.
-    Font::ECompression textureCompression = pFont->GetTextureCompression();
-    bool bAntialiased = pFont->GetAntialiased();
-
-    DynamicArray< DynamicArray< uint8_t > > textureSheets;
+    // Find every character contained within the font, then rasterize all of their glyphs in parallel.
+    DynamicArray< RasterizedGlyph > glyphs;
 
-    uint16_t penX = 1;
-    uint16_t penY = 1;
-    uint16_t lineHeight = 0;
-
-    FT_Int32 glyphLoadFlags = FT_LOAD_RENDER;
-    if( !bAntialiased )
+    FT_UInt characterIndex = 0;
+    FT_ULong codePoint = FT_Get_First_Char( pFace, &characterIndex );
+    while( characterIndex != 0 && codePoint <= UNICODE_CODE_POINT_MAX )
     {
-        glyphLoadFlags |= FT_LOAD_TARGET_MONO;
+        RasterizedGlyph* pGlyph = glyphs.New();
+        HELIUM_ASSERT( pGlyph );
+        pGlyph->codePoint = static_cast< uint32_t >( codePoint );
+        pGlyph->characterIndex = characterIndex;
+        pGlyph->bSuccess = false;
+
+        codePoint = FT_Get_Next_Char( pFace, codePoint, &characterIndex );
     }
 
-    for( uint_fast32_t codePoint = 0; codePoint <= UNICODE_CODE_POINT_MAX; ++codePoint )
+    size_t glyphCount = glyphs.GetSize();
+
+    GlyphRasterizationContext rasterizationContext;
+    rasterizationContext.pLibrary = pLibrary;
+    rasterizationContext.pFileData = pFileData;
+    rasterizationContext.fileSize = static_cast< FT_Long >( bytesRead );
+    rasterizationContext.pointSize = pointSize;
+    rasterizationContext.dpi = dpi;
+    rasterizationContext.bAntialiased = pFont->GetAntialiased();
+    rasterizationContext.pGlyphs = glyphs.GetData();
+    rasterizationContext.glyphCount = glyphCount;
+
+    JobManager::ParallelFor(
+        RasterizeGlyphBatchCallback,
+        &rasterizationContext,
+        ( glyphCount + GLYPH_RASTERIZATION_BATCH_SIZE - 1 ) / GLYPH_RASTERIZATION_BATCH_SIZE );
+
+    for( size_t glyphIndex = 0; glyphIndex < glyphCount; ++glyphIndex )
     {
-        // Check whether the current code point is contained within the font.
-        FT_UInt characterIndex = FT_Get_Char_Index( pFace, static_cast< FT_ULong >( codePoint ) );
-        if( characterIndex == 0 )
+        if( !glyphs[ glyphIndex ].bSuccess )
         {
-            continue;
-        }
+            HELIUM_TRACE(
+                TraceLevels::Error,
+                "FontResourceHandler: Failed to render the glyph for character U+%04" PRIX32 " in font resource \"%s\".\n",
+                glyphs[ glyphIndex ].codePoint,
+                *pResource->GetPath().ToString() );
 
-        // Load and render the glyph for the current character.
-        HELIUM_VERIFY( FT_Load_Glyph( pFace, characterIndex, glyphLoadFlags ) == 0 );
+            delete [] pTextureBuffer;
+            FT_Done_Face( pFace );
+            delete [] pFileData;
 
-        FT_GlyphSlot pGlyph = pFace->glyph;
-        HELIUM_ASSERT( pGlyph );
+            return false;
+        }
+    }
 
-        // Proceed to the next line in the texture sheet or the next sheet itself if we don't have enough room in the
-        // current line/sheet.
-        HELIUM_ASSERT( pGlyph->bitmap.rows >= 0 );
-        HELIUM_ASSERT( pGlyph->bitmap.width >= 0 );
-        uint_fast32_t glyphRowCount = static_cast< uint32_t >( pGlyph->bitmap.rows );
-        uint_fast32_t glyphWidth = static_cast< uint32_t >( pGlyph->bitmap.width );
+    // Pack the glyphs into texture sheets from tallest to shortest, leaving at least a pixel of padding around each
+    // glyph.  Each glyph rectangle includes the padding to its right and bottom, and the packing area is offset by a
+    // pixel to pad the top and left edges of the sheet.
+    DynamicArray< GlyphPackSortKey > packOrder;
+    packOrder.Reserve( glyphCount );
+    for( size_t glyphIndex = 0; glyphIndex < glyphCount; ++glyphIndex )
+    {
+        const RasterizedGlyph& rGlyph = glyphs[ glyphIndex ];
 
-        if( penX + glyphWidth + 1 >= textureSheetWidth )
-        {
-            penX = 1;
+        GlyphPackSortKey* pKey = packOrder.New();
+        HELIUM_ASSERT( pKey );
+        pKey->height = rGlyph.bitmapHeight;
+        pKey->width = rGlyph.bitmapWidth;
+        pKey->glyphIndex = static_cast< uint32_t >( glyphIndex );
+    }
 
-            if( penY + glyphRowCount + 1 >= textureSheetHeight )
-            {
-                CompressTexture(
-                    pTextureBuffer,
-                    textureSheetWidth,
-                    textureSheetHeight,
-                    textureCompression,
-                    textureSheets );
-                MemoryZero( pTextureBuffer, texturePixelCount );
-
-                penY = 1;
-            }
-            else
-            {
-                penY += lineHeight + 1;
-            }
+    std::sort( packOrder.GetData(), packOrder.GetData() + glyphCount );
 
-            lineHeight = 0;
-        }
+    Font::ECompression textureCompression = pFont->GetTextureCompression();
 
-        // Copy the character data from the glyph bitmap to the texture sheet.
-        int_fast32_t glyphPitch = pGlyph->bitmap.pitch;
+    DynamicArray< DynamicArray< uint8_t > > textureSheets;
 
-        const uint8_t* pGlyphBuffer = pGlyph->bitmap.buffer;
-        HELIUM_ASSERT( pGlyphBuffer || glyphRowCount == 0 );
+    GlyphSkylinePacker packer;
+    packer.Reset( textureSheetWidth - 1U, textureSheetHeight - 1U );
+    bool bSheetEmpty = true;
 
-        uint8_t* pTexturePixel =
-            pTextureBuffer + static_cast< size_t >( penY ) * static_cast< size_t >( textureSheetWidth ) + penX;
+    for( size_t packIndex = 0; packIndex < glyphCount; ++packIndex )
+    {
+        RasterizedGlyph& rGlyph = glyphs[ packOrder[ packIndex ].glyphIndex ];
 
-        if( bAntialiased )
+        // Glyphs without any pixels (i.e. whitespace) don't need any space in a texture sheet.
+        if( rGlyph.bitmapWidth == 0 || rGlyph.bitmapHeight == 0 )
         {
-            // Anti-aliased fonts are rendered as 8-bit grayscale images, so just copy the data as-is.
-            for( uint_fast32_t rowIndex = 0; rowIndex < glyphRowCount; ++rowIndex )
-            {
-                MemoryCopy( pTexturePixel, pGlyphBuffer, glyphWidth );
-                pGlyphBuffer += glyphPitch;
-                pTexturePixel += textureSheetWidth;
-            }
+            rGlyph.imageX = 0;
+            rGlyph.imageY = 0;
+            rGlyph.texture = 0;
+
+            continue;
         }
-        else
+
+        uint32_t packX, packY;
+        if( !packer.Insert( rGlyph.bitmapWidth + 1U, rGlyph.bitmapHeight + 1U, packX, packY ) )
         {
-            // Fonts without anti-aliasing are rendered as 1-bit monochrome images, so we need to manually convert each
-            // row to 8-bit grayscale.
-            for( uint_fast32_t rowIndex = 0; rowIndex < glyphRowCount; ++rowIndex )
+            // Proceed to the next sheet if we don't have enough room in the current one.
+            if( bSheetEmpty )
             {
-                const uint8_t* pGlyphPixelBlock = pGlyphBuffer;
-                pGlyphBuffer += glyphPitch;
+                HELIUM_TRACE(
+                    TraceLevels::Error,
+                    "FontResourceHandler: Glyph for character U+%04" PRIX32 " (%" PRIu16 "x%" PRIu16 ") does not fit on a texture sheet for font resource \"%s\".\n",
+                    rGlyph.codePoint,
+                    rGlyph.bitmapWidth,
+                    rGlyph.bitmapHeight,
+                    *pResource->GetPath().ToString() );
+
+                delete [] pTextureBuffer;
+                FT_Done_Face( pFace );
+                delete [] pFileData;
+
+                return false;
+            }
 
-                uint8_t* pCurrentTexturePixel = pTexturePixel;
-                pTexturePixel += textureSheetWidth;
+            CompressTexture( pTextureBuffer, textureSheetWidth, textureSheetHeight, textureCompression, textureSheets );
+            MemoryZero( pTextureBuffer, texturePixelCount );
 
-                uint_fast32_t remainingPixelCount = glyphWidth;
-                while( remainingPixelCount >= 8 )
-                {
-                    remainingPixelCount -= 8;
-
-                    uint8_t pixelBlock = *pGlyphPixelBlock;
-                    ++pGlyphPixelBlock;
-
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & ( 1 << 7 ) ) ? 255 : 0 );
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & ( 1 << 6 ) ) ? 255 : 0 );
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & ( 1 << 5 ) ) ? 255 : 0 );
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & ( 1 << 4 ) ) ? 255 : 0 );
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & ( 1 << 3 ) ) ? 255 : 0 );
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & ( 1 << 2 ) ) ? 255 : 0 );
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & ( 1 << 1 ) ) ? 255 : 0 );
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & ( 1 << 0 ) ) ? 255 : 0 );
-                }
+            packer.Reset( textureSheetWidth - 1U, textureSheetHeight - 1U );
+            bSheetEmpty = true;
 
-                uint8_t pixelBlock = *pGlyphPixelBlock;
-                uint8_t mask = ( 1 << 7 );
-                while( remainingPixelCount != 0 )
-                {
-                    *( pCurrentTexturePixel++ ) = ( ( pixelBlock & mask ) ? 255 : 0 );
-                    mask >>= 1;
-                    --remainingPixelCount;
-                }
-            }
+            HELIUM_VERIFY( packer.Insert( rGlyph.bitmapWidth + 1U, rGlyph.bitmapHeight + 1U, packX, packY ) );
         }
 
-        // Store the character information in our character array.
-        Font::Character* pCharacter = resource_data->m_characters.New();
-        HELIUM_ASSERT( pCharacter );
-    
-        pCharacter->codePoint = static_cast< uint32_t >( codePoint );
-         
-        pCharacter->imageX = penX;
-        pCharacter->imageY = penY;
-        pCharacter->imageWidth = static_cast< uint16_t >( glyphWidth );
-        pCharacter->imageHeight = static_cast< uint16_t >( glyphRowCount );
-    
-        pCharacter->width = pGlyph->metrics.width;
-        pCharacter->height = pGlyph->metrics.height;
-        pCharacter->bearingX = pGlyph->metrics.horiBearingX;
-        pCharacter->bearingY = pGlyph->metrics.horiBearingY;
-        pCharacter->advance = pGlyph->metrics.horiAdvance;
-    
+        bSheetEmpty = false;
+
+        rGlyph.imageX = static_cast< uint16_t >( packX + 1 );
+        rGlyph.imageY = static_cast< uint16_t >( packY + 1 );
+
         HELIUM_ASSERT( textureSheets.GetSize() < UINT8_MAX );
-        pCharacter->texture = static_cast< uint8_t >( static_cast< uint8_t >( textureSheets.GetSize() ) );
-    
-        // Update the pen location as well as the maximum line height as appropriate based on the current line height.
-        penX += static_cast< uint16_t >( glyphWidth ) + 1;
-    
-        HELIUM_ASSERT( glyphRowCount <= UINT16_MAX );
-        lineHeight = Max< uint16_t >( lineHeight, static_cast< uint16_t >( glyphRowCount ) );
+        rGlyph.texture = static_cast< uint8_t >( textureSheets.GetSize() );
+
+        // Copy the character data from the glyph bitmap to the texture sheet.
+        const uint8_t* pGlyphPixels = rGlyph.bitmap.GetData();
+        uint8_t* pTexturePixel =
+            pTextureBuffer + static_cast< size_t >( rGlyph.imageY ) * static_cast< size_t >( textureSheetWidth ) +
+            rGlyph.imageX;
+        for( uint_fast32_t rowIndex = 0; rowIndex < rGlyph.bitmapHeight; ++rowIndex )
+        {
+            MemoryCopy( pTexturePixel, pGlyphPixels, rGlyph.bitmapWidth );
+            pGlyphPixels += rGlyph.bitmapWidth;
+            pTexturePixel += textureSheetWidth;
+        }
+
+        rGlyph.bitmap.Clear();
     }
 
     // Compress and store the last texture in the sheet.
-    if( !resource_data->m_characters.IsEmpty() )
+    if( glyphCount != 0 )
     {
         CompressTexture( pTextureBuffer, textureSheetWidth, textureSheetHeight, textureCompression, textureSheets );
     }
 
+    // Store the character information in our character array in code point order.
+    resource_data->m_characters.Reserve( glyphCount );
+    for( size_t glyphIndex = 0; glyphIndex < glyphCount; ++glyphIndex )
+    {
+        const RasterizedGlyph& rGlyph = glyphs[ glyphIndex ];
+
+        Font::Character* pCharacter = resource_data->m_characters.New();
+        HELIUM_ASSERT( pCharacter );
+
+        pCharacter->codePoint = rGlyph.codePoint;
+
+        pCharacter->imageX = rGlyph.imageX;
+        pCharacter->imageY = rGlyph.imageY;
+        pCharacter->imageWidth = rGlyph.bitmapWidth;
+        pCharacter->imageHeight = rGlyph.bitmapHeight;
+
+        pCharacter->width = rGlyph.width;
+        pCharacter->height = rGlyph.height;
+        pCharacter->bearingX = rGlyph.bearingX;
+        pCharacter->bearingY = rGlyph.bearingY;
+        pCharacter->advance = rGlyph.advance;
+
+        pCharacter->texture = rGlyph.texture;
+    }
+
     // Done processing the font itself, so free some resources.
     delete [] pTextureBuffer;
 
@@ -5,6 +5,19 @@
 #include "EditorSupport/Image.h"
 
 #include "Math/Color.h"
+#include "MathSimd/Simd.h"
+
+#if HELIUM_SIMD_SSE
+#include <emmintrin.h>
+
+/// Non-zero if 256-bit integer vector instructions can be used by the pixel conversion loops.
+#if defined( __AVX2__ )
+#define HELIUM_SIMD_AVX2 1
+#include <immintrin.h>
+#else
+#define HELIUM_SIMD_AVX2 0
+#endif
+#endif
 
 using namespace Helium;
 
@@ -559,6 +572,320 @@ void ConvertImageSourcePixelSizeSwitch(
     }
 }
 
+// Marker for a destination byte that is filled with 0xff (channel missing from the source image).
+static const int32_t BYTE_SOURCE_FILL = -1;
+// Marker for a destination byte that is cleared (not covered by any destination channel).
+static const int32_t BYTE_SOURCE_CLEAR = -2;
+
+// Get the byte index within a pixel for the given channel bit offset.
+static uint32_t GetPixelByteIndex( uint32_t bitOffset, uint32_t bytesPerPixel )
+{
+#if HELIUM_ENDIAN_LITTLE
+    HELIUM_UNREF( bytesPerPixel );
+
+    return bitOffset / 8;
+#else
+    return bytesPerPixel - 1 - bitOffset / 8;
+#endif
+}
+
+// Get the bit shift of the given byte within a pixel value loaded as a single 32-bit integer.
+static uint32_t GetPixelByteShift( int32_t byteIndex )
+{
+#if HELIUM_ENDIAN_LITTLE
+    return static_cast< uint32_t >( byteIndex ) * 8;
+#else
+    return ( 3 - static_cast< uint32_t >( byteIndex ) ) * 8;
+#endif
+}
+
+// Check whether every used channel in a format is a whole, byte-aligned 8-bit value in a 3 or 4-byte pixel, which
+// allows conversions between such formats to be performed as simple byte shuffles.
+static bool IsByteChannelFormat( const Image::Format& rFormat )
+{
+    if( rFormat.GetPalette() )
+    {
+        return false;
+    }
+
+    uint32_t bytesPerPixel = rFormat.GetBytesPerPixel();
+    if( bytesPerPixel != 3 && bytesPerPixel != 4 )
+    {
+        return false;
+    }
+
+    for( size_t channelIndex = 0; channelIndex < Image::CHANNEL_MAX; ++channelIndex )
+    {
+        Image::EChannel channel = static_cast< Image::EChannel >( channelIndex );
+
+        uint8_t bitCount = rFormat.GetChannelBitCount( channel );
+        if( bitCount != 0 && ( bitCount != 8 || rFormat.GetChannelBitOffset( channel ) % 8 != 0 ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Build the table of source byte indices from which each destination pixel byte is copied (matching the results of
+// the generic conversion loop: missing source channels are filled with their maximum value, and bytes not covered by
+// a destination channel are cleared).
+static void BuildByteShuffle(
+                             const Image::Format& rSourceFormat,
+                             const Image::Format& rDestFormat,
+                             int32_t* pDestByteSources )
+{
+    HELIUM_ASSERT( pDestByteSources );
+
+    uint32_t sourceBytesPerPixel = rSourceFormat.GetBytesPerPixel();
+    uint32_t destBytesPerPixel = rDestFormat.GetBytesPerPixel();
+
+    for( uint32_t byteIndex = 0; byteIndex < 4; ++byteIndex )
+    {
+        pDestByteSources[ byteIndex ] = BYTE_SOURCE_CLEAR;
+    }
+
+    for( size_t channelIndex = 0; channelIndex < Image::CHANNEL_MAX; ++channelIndex )
+    {
+        Image::EChannel channel = static_cast< Image::EChannel >( channelIndex );
+        if( rDestFormat.GetChannelBitCount( channel ) == 0 )
+        {
+            continue;
+        }
+
+        uint32_t destByte = GetPixelByteIndex( rDestFormat.GetChannelBitOffset( channel ), destBytesPerPixel );
+        if( rSourceFormat.GetChannelBitCount( channel ) == 0 )
+        {
+            pDestByteSources[ destByte ] = BYTE_SOURCE_FILL;
+        }
+        else
+        {
+            pDestByteSources[ destByte ] = static_cast< int32_t >(
+                GetPixelByteIndex( rSourceFormat.GetChannelBitOffset( channel ), sourceBytesPerPixel ) );
+        }
+    }
+}
+
+// Byte shuffle conversion loop for arbitrary 3 and 4-byte pixel sizes.
+static void ShuffleImageBytes(
+                              const int32_t* pDestByteSources,
+                              const void* pSourceData,
+                              uint32_t sourceBytesPerPixel,
+                              uint32_t sourcePitch,
+                              void* pDestData,
+                              uint32_t destBytesPerPixel,
+                              uint32_t destPitch,
+                              uint32_t width,
+                              uint32_t height )
+{
+    const uint8_t* pSourceRow = static_cast< const uint8_t* >( pSourceData );
+    uint8_t* pDestRow = static_cast< uint8_t* >( pDestData );
+
+    for( uint32_t y = 0; y < height; ++y )
+    {
+        const uint8_t* pSourcePixel = pSourceRow;
+        uint8_t* pDestPixel = pDestRow;
+
+        for( uint32_t x = 0; x < width; ++x )
+        {
+            for( uint32_t byteIndex = 0; byteIndex < destBytesPerPixel; ++byteIndex )
+            {
+                int32_t sourceByte = pDestByteSources[ byteIndex ];
+                pDestPixel[ byteIndex ] =
+                    ( sourceByte >= 0
+                    ? pSourcePixel[ sourceByte ]
+                    : ( sourceByte == BYTE_SOURCE_FILL ? 0xff : 0 ) );
+            }
+
+            pSourcePixel += sourceBytesPerPixel;
+            pDestPixel += destBytesPerPixel;
+        }
+
+        pSourceRow += sourcePitch;
+        pDestRow += destPitch;
+    }
+}
+
+// Byte shuffle conversion loop between 4-byte pixel formats (BGRA <-> RGBA and similar reorderings), performed as
+// shifts and masks on whole 32-bit pixel values so that it can be vectorized.
+static void ShuffleImagePixels32(
+                                 const int32_t* pDestByteSources,
+                                 const void* pSourceData,
+                                 uint32_t sourcePitch,
+                                 void* pDestData,
+                                 uint32_t destPitch,
+                                 uint32_t width,
+                                 uint32_t height )
+{
+    // Convert the byte table to a set of per-byte right shifts (source) and left shifts (destination), along with a
+    // constant mask of all filled destination bits.
+    uint32_t sourceShifts[ 4 ];
+    uint32_t destShifts[ 4 ];
+    uint32_t moveCount = 0;
+    uint32_t fillMask = 0;
+
+    for( int32_t byteIndex = 0; byteIndex < 4; ++byteIndex )
+    {
+        int32_t sourceByte = pDestByteSources[ byteIndex ];
+        if( sourceByte >= 0 )
+        {
+            sourceShifts[ moveCount ] = GetPixelByteShift( sourceByte );
+            destShifts[ moveCount ] = GetPixelByteShift( byteIndex );
+            ++moveCount;
+        }
+        else if( sourceByte == BYTE_SOURCE_FILL )
+        {
+            fillMask |= 0xffU << GetPixelByteShift( byteIndex );
+        }
+    }
+
+#if HELIUM_SIMD_SSE
+    __m128i byteMask = _mm_set1_epi32( 0xff );
+    __m128i fillMask128 = _mm_set1_epi32( static_cast< int >( fillMask ) );
+    __m128i sourceShifts128[ 4 ];
+    __m128i destShifts128[ 4 ];
+    for( uint32_t moveIndex = 0; moveIndex < moveCount; ++moveIndex )
+    {
+        sourceShifts128[ moveIndex ] = _mm_cvtsi32_si128( static_cast< int >( sourceShifts[ moveIndex ] ) );
+        destShifts128[ moveIndex ] = _mm_cvtsi32_si128( static_cast< int >( destShifts[ moveIndex ] ) );
+    }
+
+#if HELIUM_SIMD_AVX2
+    __m256i byteMask256 = _mm256_set1_epi32( 0xff );
+    __m256i fillMask256 = _mm256_set1_epi32( static_cast< int >( fillMask ) );
+#endif
+#endif
+
+    const uint8_t* pSourceRow = static_cast< const uint8_t* >( pSourceData );
+    uint8_t* pDestRow = static_cast< uint8_t* >( pDestData );
+
+    for( uint32_t y = 0; y < height; ++y )
+    {
+        const uint32_t* pSourcePixel = reinterpret_cast< const uint32_t* >( pSourceRow );
+        uint32_t* pDestPixel = reinterpret_cast< uint32_t* >( pDestRow );
+        uint32_t x = 0;
+
+#if HELIUM_SIMD_SSE
+#if HELIUM_SIMD_AVX2
+        for( ; x + 8 <= width; x += 8 )
+        {
+            __m256i source = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( pSourcePixel + x ) );
+            __m256i dest = fillMask256;
+            for( uint32_t moveIndex = 0; moveIndex < moveCount; ++moveIndex )
+            {
+                __m256i value = _mm256_and_si256(
+                    _mm256_srl_epi32( source, sourceShifts128[ moveIndex ] ),
+                    byteMask256 );
+                dest = _mm256_or_si256( dest, _mm256_sll_epi32( value, destShifts128[ moveIndex ] ) );
+            }
+
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( pDestPixel + x ), dest );
+        }
+#endif
+
+        for( ; x + 4 <= width; x += 4 )
+        {
+            __m128i source = _mm_loadu_si128( reinterpret_cast< const __m128i* >( pSourcePixel + x ) );
+            __m128i dest = fillMask128;
+            for( uint32_t moveIndex = 0; moveIndex < moveCount; ++moveIndex )
+            {
+                __m128i value = _mm_and_si128( _mm_srl_epi32( source, sourceShifts128[ moveIndex ] ), byteMask );
+                dest = _mm_or_si128( dest, _mm_sll_epi32( value, destShifts128[ moveIndex ] ) );
+            }
+
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( pDestPixel + x ), dest );
+        }
+#endif
+
+        for( ; x < width; ++x )
+        {
+            uint32_t source = pSourcePixel[ x ];
+            uint32_t dest = fillMask;
+            for( uint32_t moveIndex = 0; moveIndex < moveCount; ++moveIndex )
+            {
+                dest |= ( ( source >> sourceShifts[ moveIndex ] ) & 0xff ) << destShifts[ moveIndex ];
+            }
+
+            pDestPixel[ x ] = dest;
+        }
+
+        pSourceRow += sourcePitch;
+        pDestRow += destPitch;
+    }
+}
+
+// Attempt to convert between two formats using one of the specialized byte shuffle loops instead of the generic
+// per-channel conversion loop.  Returns false if the format pair is not supported by any of the specialized loops.
+static bool ConvertImageFast(
+                             const Image::Format& rSourceFormat,
+                             const void* pSourceData,
+                             uint32_t sourcePitch,
+                             const Image::Format& rDestFormat,
+                             void* pDestData,
+                             uint32_t destPitch,
+                             uint32_t width,
+                             uint32_t height )
+{
+    if( !IsByteChannelFormat( rSourceFormat ) || !IsByteChannelFormat( rDestFormat ) )
+    {
+        return false;
+    }
+
+    uint32_t sourceBytesPerPixel = rSourceFormat.GetBytesPerPixel();
+    uint32_t destBytesPerPixel = rDestFormat.GetBytesPerPixel();
+
+    int32_t destByteSources[ 4 ];
+    BuildByteShuffle( rSourceFormat, rDestFormat, destByteSources );
+
+    // Identical layouts only need each row copied.
+    bool bIdentity = ( sourceBytesPerPixel == destBytesPerPixel );
+    for( uint32_t byteIndex = 0; bIdentity && byteIndex < destBytesPerPixel; ++byteIndex )
+    {
+        bIdentity = ( destByteSources[ byteIndex ] == static_cast< int32_t >( byteIndex ) );
+    }
+
+    if( bIdentity )
+    {
+        const uint8_t* pSourceRow = static_cast< const uint8_t* >( pSourceData );
+        uint8_t* pDestRow = static_cast< uint8_t* >( pDestData );
+        size_t rowSize = static_cast< size_t >( width ) * destBytesPerPixel;
+
+        for( uint32_t y = 0; y < height; ++y )
+        {
+            MemoryCopy( pDestRow, pSourceRow, rowSize );
+            pSourceRow += sourcePitch;
+            pDestRow += destPitch;
+        }
+    }
+    else if( sourceBytesPerPixel == 4 && destBytesPerPixel == 4 )
+    {
+        ShuffleImagePixels32(
+            destByteSources,
+            pSourceData,
+            sourcePitch,
+            pDestData,
+            destPitch,
+            width,
+            height );
+    }
+    else
+    {
+        ShuffleImageBytes(
+            destByteSources,
+            pSourceData,
+            sourceBytesPerPixel,
+            sourcePitch,
+            pDestData,
+            destBytesPerPixel,
+            destPitch,
+            width,
+            height );
+    }
+
+    return true;
+}
+
 /// Constructor.
 Image::Image()
 : m_pPixelData( NULL )
@@ -777,6 +1104,23 @@ bool Image::Convert( Image& rDestination, const Format& rFormat ) const
         return false;
     }
 
+    // Common conversions between 8-bit per channel formats (RGB -> RGBA, BGRA <-> RGBA, etc.) only need to reorder
+    // bytes, so try the specialized conversion loops first.
+    if( ConvertImageFast(
+        m_format,
+        m_pPixelData,
+        m_pitch,
+        stagingImage.m_format,
+        stagingImage.m_pPixelData,
+        stagingImage.m_pitch,
+        m_width,
+        m_height ) )
+    {
+        rDestination.Swap( stagingImage );
+
+        return true;
+    }
+
     // Convert the image based on key properties of the source and destination formats (specifically, the number of
     // bytes per pixel and whether a color palette is used.
     uint32_t sourceBytesPerPixel = m_format.GetBytesPerPixel();
@@ -12,10 +12,742 @@
 #include "PcSupport/PlatformPreprocessor.h"
 #include "EditorSupport/FbxSupport.h"
 
+#include <algorithm>
+#include <cmath>
+
 HELIUM_IMPLEMENT_ASSET( Helium::MeshResourceHandler, EditorSupport, 0 );
 
 using namespace Helium;
 
+/// Maximum number of levels of detail generated for a mesh, including the full-detail mesh.
+static const size_t MESH_LOD_COUNT_MAX = 4;
+/// Fraction of the triangles of the previous level of detail targeted by each generated level of detail.
+static const float32_t MESH_LOD_TRIANGLE_RATIO = 0.5f;
+/// Fraction of the triangles of the previous level of detail above which a generated level of detail is discarded (and
+/// no further levels of detail are generated), as it would not save enough work to be worth switching to.
+static const float32_t MESH_LOD_MIN_REDUCTION_RATIO = 0.75f;
+/// Minimum number of triangles in a mesh for levels of detail to be generated.
+static const size_t MESH_LOD_MIN_TRIANGLE_COUNT = 128;
+/// Projected size, in pixels, below which the first generated level of detail is used (each further level of detail
+/// halves this size).
+static const float32_t MESH_LOD_FIRST_SCREEN_SIZE = 256.0f;
+/// Number of entries in the post-transform vertex cache modeled when optimizing triangle order.
+static const size_t MESH_VERTEX_CACHE_SIZE = 32;
+
+namespace
+{
+	/// Symmetric 4x4 error quadric, storing the upper triangle of the matrix.
+	struct Quadric
+	{
+		/// Matrix values (a2, ab, ac, ad, b2, bc, bd, c2, cd, d2).
+		float64_t values[ 10 ];
+	};
+
+	/// Edge collapse candidate for mesh simplification.
+	struct EdgeCollapse
+	{
+		/// Error introduced by the collapse.
+		float64_t cost;
+		/// Index of the vertex removed by the collapse.
+		uint16_t fromVertex;
+		/// Index of the vertex kept by the collapse.
+		uint16_t toVertex;
+
+		/// Sort by increasing cost.
+		bool operator<( const EdgeCollapse& rOther ) const
+		{
+			return ( cost < rOther.cost );
+		}
+	};
+
+	/// Comparison of vertex indices by vertex position, for welding vertices split along attribute seams.
+	struct VertexPositionLess
+	{
+		/// Vertices being compared.
+		const StaticMeshVertex< 1 >* pVertices;
+
+		/// Compare the positions of two vertices.
+		bool operator()( uint16_t index0, uint16_t index1 ) const
+		{
+			const float32_t* pPosition0 = pVertices[ index0 ].position;
+			const float32_t* pPosition1 = pVertices[ index1 ].position;
+			for( size_t axisIndex = 0; axisIndex < 3; ++axisIndex )
+			{
+				if( pPosition0[ axisIndex ] != pPosition1[ axisIndex ] )
+				{
+					return ( pPosition0[ axisIndex ] < pPosition1[ axisIndex ] );
+				}
+			}
+
+			return ( index0 < index1 );
+		}
+	};
+}
+
+/// Compute the unnormalized normal of a mesh triangle.
+///
+/// @param[in]  pVertices  Section vertices.
+/// @param[in]  index0     Index of the first triangle vertex.
+/// @param[in]  index1     Index of the second triangle vertex.
+/// @param[in]  index2     Index of the third triangle vertex.
+/// @param[out] pNormal    Triangle normal (three values), with a length of twice the area of the triangle.
+static void ComputeTriangleNormal(
+	const StaticMeshVertex< 1 >* pVertices, uint16_t index0, uint16_t index1, uint16_t index2, float64_t* pNormal )
+{
+	const float32_t* pPosition0 = pVertices[ index0 ].position;
+	const float32_t* pPosition1 = pVertices[ index1 ].position;
+	const float32_t* pPosition2 = pVertices[ index2 ].position;
+
+	float64_t edge0[ 3 ];
+	float64_t edge1[ 3 ];
+	for( size_t axisIndex = 0; axisIndex < 3; ++axisIndex )
+	{
+		edge0[ axisIndex ] = static_cast< float64_t >( pPosition1[ axisIndex ] ) - pPosition0[ axisIndex ];
+		edge1[ axisIndex ] = static_cast< float64_t >( pPosition2[ axisIndex ] ) - pPosition0[ axisIndex ];
+	}
+
+	pNormal[ 0 ] = edge0[ 1 ] * edge1[ 2 ] - edge0[ 2 ] * edge1[ 1 ];
+	pNormal[ 1 ] = edge0[ 2 ] * edge1[ 0 ] - edge0[ 0 ] * edge1[ 2 ];
+	pNormal[ 2 ] = edge0[ 0 ] * edge1[ 1 ] - edge0[ 1 ] * edge1[ 0 ];
+}
+
+/// Evaluate the error of an error quadric at a vertex position.
+///
+/// @param[in] rQuadric   Error quadric.
+/// @param[in] pPosition  Vertex position.
+///
+/// @return  Squared distance error.
+static float64_t EvaluateQuadric( const Quadric& rQuadric, const float32_t* pPosition )
+{
+	const float64_t* q = rQuadric.values;
+	float64_t x = pPosition[ 0 ];
+	float64_t y = pPosition[ 1 ];
+	float64_t z = pPosition[ 2 ];
+
+	return
+		q[ 0 ] * x * x + 2.0 * q[ 1 ] * x * y + 2.0 * q[ 2 ] * x * z + 2.0 * q[ 3 ] * x +
+		q[ 4 ] * y * y + 2.0 * q[ 5 ] * y * z + 2.0 * q[ 6 ] * y +
+		q[ 7 ] * z * z + 2.0 * q[ 8 ] * z +
+		q[ 9 ];
+}
+
+/// Compute the score of a vertex for vertex cache optimization.
+///
+/// Vertices in the cache score higher the more recently they were used (except for the vertices of the last emitted
+/// triangle, which are given a fixed score so that the next triangle does not always reuse the same edge), and
+/// vertices with few remaining triangles are boosted so that no isolated triangles are left behind.
+///
+/// @param[in] cachePosition           Position of the vertex in the modeled cache, or -1 if the vertex is not cached.
+/// @param[in] remainingTriangleCount  Number of triangles using the vertex that have not been emitted yet.
+///
+/// @return  Vertex score.
+static float32_t ComputeVertexCacheScore( int32_t cachePosition, uint32_t remainingTriangleCount )
+{
+	if( remainingTriangleCount == 0 )
+	{
+		return -1.0f;
+	}
+
+	float32_t score = 0.0f;
+	if( cachePosition >= 0 )
+	{
+		if( cachePosition < 3 )
+		{
+			score = 0.75f;
+		}
+		else
+		{
+			float32_t cacheFactor = 1.0f -
+				static_cast< float32_t >( cachePosition - 3 ) / static_cast< float32_t >( MESH_VERTEX_CACHE_SIZE - 3 );
+			score = powf( cacheFactor, 1.5f );
+		}
+	}
+
+	score += 2.0f / sqrtf( static_cast< float32_t >( remainingTriangleCount ) );
+
+	return score;
+}
+
+/// Reorder the triangles of a mesh section to improve post-transform vertex cache hits.
+///
+/// This greedily emits the triangle with the highest combined vertex score (see ComputeVertexCacheScore()), only
+/// rescoring the triangles touching the modeled cache after each step.  When no cached vertex has any triangles
+/// left, the next triangle is taken in source order, so triangles of separate mesh islands stay roughly in the
+/// order they were authored.
+///
+/// @param[in,out] pIndices     Section triangle indices to reorder.
+/// @param[in]     indexCount   Number of section indices.
+/// @param[in]     vertexCount  Number of section vertices.
+static void OptimizeMeshSectionVertexCache( uint16_t* pIndices, size_t indexCount, size_t vertexCount )
+{
+	HELIUM_ASSERT( pIndices || indexCount == 0 );
+	HELIUM_ASSERT( indexCount % 3 == 0 );
+
+	size_t triangleCount = indexCount / 3;
+	if( triangleCount < 2 || vertexCount == 0 )
+	{
+		return;
+	}
+
+	// Build the list of triangles using each vertex.
+	DynamicArray< uint32_t > vertexTriangleOffsets;
+	vertexTriangleOffsets.Resize( vertexCount + 1 );
+	MemoryZero( vertexTriangleOffsets.GetData(), vertexTriangleOffsets.GetSize() * sizeof( uint32_t ) );
+	for( size_t indexIndex = 0; indexIndex < indexCount; ++indexIndex )
+	{
+		HELIUM_ASSERT( pIndices[ indexIndex ] < vertexCount );
+		++vertexTriangleOffsets[ pIndices[ indexIndex ] + 1 ];
+	}
+
+	for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+	{
+		vertexTriangleOffsets[ vertexIndex + 1 ] += vertexTriangleOffsets[ vertexIndex ];
+	}
+
+	DynamicArray< uint32_t > vertexTriangles;
+	vertexTriangles.Resize( indexCount );
+
+	DynamicArray< uint32_t > vertexActiveTriangleCounts;
+	vertexActiveTriangleCounts.Resize( vertexCount );
+	MemoryZero( vertexActiveTriangleCounts.GetData(), vertexCount * sizeof( uint32_t ) );
+	for( size_t indexIndex = 0; indexIndex < indexCount; ++indexIndex )
+	{
+		uint16_t vertex = pIndices[ indexIndex ];
+		vertexTriangles[ vertexTriangleOffsets[ vertex ] + vertexActiveTriangleCounts[ vertex ] ] =
+			static_cast< uint32_t >( indexIndex / 3 );
+		++vertexActiveTriangleCounts[ vertex ];
+	}
+
+	// Compute the initial vertex scores.
+	DynamicArray< float32_t > vertexScores;
+	vertexScores.Resize( vertexCount );
+	for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+	{
+		vertexScores[ vertexIndex ] = ComputeVertexCacheScore( -1, vertexActiveTriangleCounts[ vertexIndex ] );
+	}
+
+	DynamicArray< bool > triangleEmitted;
+	triangleEmitted.Resize( triangleCount );
+	MemoryZero( triangleEmitted.GetData(), triangleCount * sizeof( bool ) );
+
+	DynamicArray< uint16_t > optimizedIndices;
+	optimizedIndices.Reserve( indexCount );
+
+	uint16_t cache[ MESH_VERTEX_CACHE_SIZE + 3 ];
+	uint16_t newCache[ MESH_VERTEX_CACHE_SIZE + 3 ];
+	size_t cacheCount = 0;
+
+	size_t nextSourceTriangle = 0;
+	size_t bestTriangle = 0;
+	while( optimizedIndices.GetSize() < indexCount )
+	{
+		HELIUM_ASSERT( !triangleEmitted[ bestTriangle ] );
+		triangleEmitted[ bestTriangle ] = true;
+
+		const uint16_t* pTriangle = pIndices + bestTriangle * 3;
+		optimizedIndices.Add( pTriangle, 3 );
+
+		// Remove the triangle from the active triangle lists of its vertices.
+		for( size_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex )
+		{
+			uint16_t vertex = pTriangle[ cornerIndex ];
+			uint32_t* pTriangles = vertexTriangles.GetData() + vertexTriangleOffsets[ vertex ];
+			uint32_t& rActiveCount = vertexActiveTriangleCounts[ vertex ];
+			for( uint32_t triangleIndex = 0; triangleIndex < rActiveCount; ++triangleIndex )
+			{
+				if( pTriangles[ triangleIndex ] == bestTriangle )
+				{
+					pTriangles[ triangleIndex ] = pTriangles[ rActiveCount - 1 ];
+					--rActiveCount;
+
+					break;
+				}
+			}
+		}
+
+		// Move the triangle vertices to the front of the cache, pushing the least recently used vertices out.
+		size_t newCacheCount = 0;
+		for( size_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex )
+		{
+			uint16_t vertex = pTriangle[ cornerIndex ];
+			if( std::find( newCache, newCache + newCacheCount, vertex ) == newCache + newCacheCount )
+			{
+				newCache[ newCacheCount++ ] = vertex;
+			}
+		}
+
+		for( size_t cacheIndex = 0; cacheIndex < cacheCount; ++cacheIndex )
+		{
+			uint16_t vertex = cache[ cacheIndex ];
+			if( vertex != pTriangle[ 0 ] && vertex != pTriangle[ 1 ] && vertex != pTriangle[ 2 ] )
+			{
+				newCache[ newCacheCount++ ] = vertex;
+			}
+		}
+
+		for( size_t cacheIndex = 0; cacheIndex < newCacheCount; ++cacheIndex )
+		{
+			uint16_t vertex = newCache[ cacheIndex ];
+			int32_t cachePosition = ( cacheIndex < MESH_VERTEX_CACHE_SIZE ? static_cast< int32_t >( cacheIndex ) : -1 );
+			vertexScores[ vertex ] = ComputeVertexCacheScore( cachePosition, vertexActiveTriangleCounts[ vertex ] );
+		}
+
+		// Rescore the remaining triangles touching the cache and pick the best one to emit next.
+		float32_t bestScore = -1.0f;
+		SetInvalid( bestTriangle );
+		for( size_t cacheIndex = 0; cacheIndex < newCacheCount; ++cacheIndex )
+		{
+			uint16_t vertex = newCache[ cacheIndex ];
+			const uint32_t* pTriangles = vertexTriangles.GetData() + vertexTriangleOffsets[ vertex ];
+			uint32_t activeCount = vertexActiveTriangleCounts[ vertex ];
+			for( uint32_t triangleIndex = 0; triangleIndex < activeCount; ++triangleIndex )
+			{
+				uint32_t triangle = pTriangles[ triangleIndex ];
+				const uint16_t* pCandidate = pIndices + triangle * 3;
+				float32_t score =
+					vertexScores[ pCandidate[ 0 ] ] + vertexScores[ pCandidate[ 1 ] ] + vertexScores[ pCandidate[ 2 ] ];
+				if( score > bestScore )
+				{
+					bestScore = score;
+					bestTriangle = triangle;
+				}
+			}
+		}
+
+		cacheCount = Min( newCacheCount, MESH_VERTEX_CACHE_SIZE );
+		MemoryCopy( cache, newCache, cacheCount * sizeof( uint16_t ) );
+
+		if( IsInvalid( bestTriangle ) )
+		{
+			while( nextSourceTriangle < triangleCount && triangleEmitted[ nextSourceTriangle ] )
+			{
+				++nextSourceTriangle;
+			}
+
+			if( nextSourceTriangle >= triangleCount )
+			{
+				break;
+			}
+
+			bestTriangle = nextSourceTriangle;
+		}
+	}
+
+	HELIUM_ASSERT( optimizedIndices.GetSize() == indexCount );
+	MemoryCopy( pIndices, optimizedIndices.GetData(), indexCount * sizeof( uint16_t ) );
+}
+
+/// Reorder the vertices of a mesh section in the order they are first referenced by its triangles.
+///
+/// Once triangles are ordered for the vertex cache, this makes vertex fetches walk through the vertex buffer mostly
+/// sequentially.  Vertices not referenced by any triangle are moved to the end of the section.
+///
+/// @param[in,out] pVertices    Section vertices to reorder.
+/// @param[in,out] pBlendData   Skinning blend data of each section vertex to reorder along with the vertices, or
+///                             null if the mesh is not skinned.
+/// @param[in]     vertexCount  Number of section vertices.
+/// @param[in,out] pIndices     Section triangle indices to remap to the new vertex order.
+/// @param[in]     indexCount   Number of section indices.
+static void ReorderMeshSectionVertices(
+	StaticMeshVertex< 1 >* pVertices,
+	FbxSupport::BlendData* pBlendData,
+	size_t vertexCount,
+	uint16_t* pIndices,
+	size_t indexCount )
+{
+	HELIUM_ASSERT( pVertices || vertexCount == 0 );
+	HELIUM_ASSERT( pIndices || indexCount == 0 );
+
+	if( vertexCount == 0 )
+	{
+		return;
+	}
+
+	DynamicArray< uint16_t > vertexRemap;
+	vertexRemap.Add( Invalid< uint16_t >(), vertexCount );
+
+	uint16_t nextVertex = 0;
+	for( size_t indexIndex = 0; indexIndex < indexCount; ++indexIndex )
+	{
+		uint16_t& rRemappedVertex = vertexRemap[ pIndices[ indexIndex ] ];
+		if( IsInvalid( rRemappedVertex ) )
+		{
+			rRemappedVertex = nextVertex++;
+		}
+
+		pIndices[ indexIndex ] = rRemappedVertex;
+	}
+
+	for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+	{
+		if( IsInvalid( vertexRemap[ vertexIndex ] ) )
+		{
+			vertexRemap[ vertexIndex ] = nextVertex++;
+		}
+	}
+
+	HELIUM_ASSERT( nextVertex == vertexCount );
+
+	DynamicArray< StaticMeshVertex< 1 > > reorderedVertices;
+	reorderedVertices.Resize( vertexCount );
+	for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+	{
+		reorderedVertices[ vertexRemap[ vertexIndex ] ] = pVertices[ vertexIndex ];
+	}
+
+	MemoryCopy( pVertices, reorderedVertices.GetData(), vertexCount * sizeof( StaticMeshVertex< 1 > ) );
+
+	if( pBlendData )
+	{
+		DynamicArray< FbxSupport::BlendData > reorderedBlendData;
+		reorderedBlendData.Resize( vertexCount );
+		for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+		{
+			reorderedBlendData[ vertexRemap[ vertexIndex ] ] = pBlendData[ vertexIndex ];
+		}
+
+		MemoryCopy( pBlendData, reorderedBlendData.GetData(), vertexCount * sizeof( FbxSupport::BlendData ) );
+	}
+}
+
+/// Simplify the triangles of a mesh section using quadric error edge collapses.
+///
+/// Vertices are only ever collapsed onto other existing vertices, so the simplified indices address a subset of the
+/// original section vertices and the vertex buffer can be shared between all levels of detail.  Vertices along open
+/// borders and along attribute seams (where vertices sharing a position were split) are never removed, so simplified
+/// sections keep their outline and do not tear apart along texture seams.
+///
+/// @param[in]  pVertices            Section vertices.
+/// @param[in]  vertexCount          Number of section vertices.
+/// @param[in]  rIndices             Section triangle indices to simplify.
+/// @param[in]  targetTriangleCount  Number of triangles to reduce the section to (the result may have more if no
+///                                  further edges can be collapsed).
+/// @param[out] rSimplifiedIndices   Simplified section triangle indices.
+static void SimplifyMeshSection(
+	const StaticMeshVertex< 1 >* pVertices,
+	size_t vertexCount,
+	const DynamicArray< uint16_t >& rIndices,
+	size_t targetTriangleCount,
+	DynamicArray< uint16_t >& rSimplifiedIndices )
+{
+	HELIUM_ASSERT( pVertices || vertexCount == 0 );
+	HELIUM_ASSERT( rIndices.GetSize() % 3 == 0 );
+
+	rSimplifiedIndices = rIndices;
+
+	size_t triangleCount = rIndices.GetSize() / 3;
+	if( triangleCount <= targetTriangleCount || vertexCount == 0 )
+	{
+		return;
+	}
+
+	// Weld vertices sharing the same position, so that borders can be told apart from attribute seams.
+	DynamicArray< uint16_t > weldedVertices;
+	weldedVertices.Resize( vertexCount );
+
+	DynamicArray< uint16_t > positionOrder;
+	positionOrder.Resize( vertexCount );
+	for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+	{
+		positionOrder[ vertexIndex ] = static_cast< uint16_t >( vertexIndex );
+	}
+
+	VertexPositionLess positionLess = { pVertices };
+	std::sort( positionOrder.GetData(), positionOrder.GetData() + vertexCount, positionLess );
+
+	DynamicArray< bool > lockedVertices;
+	lockedVertices.Resize( vertexCount );
+	MemoryZero( lockedVertices.GetData(), vertexCount * sizeof( bool ) );
+
+	for( size_t orderIndex = 0; orderIndex < vertexCount; )
+	{
+		uint16_t firstVertex = positionOrder[ orderIndex ];
+		size_t orderEnd = orderIndex + 1;
+		while( orderEnd < vertexCount &&
+			MemoryCompare(
+				pVertices[ positionOrder[ orderEnd ] ].position,
+				pVertices[ firstVertex ].position,
+				sizeof( pVertices[ firstVertex ].position ) ) == 0 )
+		{
+			++orderEnd;
+		}
+
+		bool bSeam = ( orderEnd - orderIndex > 1 );
+		for( ; orderIndex < orderEnd; ++orderIndex )
+		{
+			uint16_t vertexIndex = positionOrder[ orderIndex ];
+			weldedVertices[ vertexIndex ] = firstVertex;
+			lockedVertices[ vertexIndex ] = bSeam;
+		}
+	}
+
+	// Lock the vertices of border edges (edges used by a single triangle of the welded mesh).
+	{
+		DynamicArray< uint32_t > edgeKeys;
+		edgeKeys.Reserve( triangleCount * 3 );
+		for( size_t indexIndex = 0; indexIndex < triangleCount * 3; ++indexIndex )
+		{
+			size_t triangleBase = indexIndex - indexIndex % 3;
+			uint16_t vertex0 = weldedVertices[ rIndices[ indexIndex ] ];
+			uint16_t vertex1 = weldedVertices[ rIndices[ triangleBase + ( indexIndex + 1 ) % 3 ] ];
+			edgeKeys.Push(
+				( static_cast< uint32_t >( Min( vertex0, vertex1 ) ) << 16 ) | Max( vertex0, vertex1 ) );
+		}
+
+		std::sort( edgeKeys.GetData(), edgeKeys.GetData() + edgeKeys.GetSize() );
+
+		DynamicArray< bool > borderVertices;
+		borderVertices.Resize( vertexCount );
+		MemoryZero( borderVertices.GetData(), vertexCount * sizeof( bool ) );
+
+		size_t edgeKeyCount = edgeKeys.GetSize();
+		for( size_t keyIndex = 0; keyIndex < edgeKeyCount; )
+		{
+			size_t keyEnd = keyIndex + 1;
+			while( keyEnd < edgeKeyCount && edgeKeys[ keyEnd ] == edgeKeys[ keyIndex ] )
+			{
+				++keyEnd;
+			}
+
+			if( keyEnd - keyIndex == 1 )
+			{
+				borderVertices[ edgeKeys[ keyIndex ] >> 16 ] = true;
+				borderVertices[ edgeKeys[ keyIndex ] & 0xffff ] = true;
+			}
+
+			keyIndex = keyEnd;
+		}
+
+		for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+		{
+			if( borderVertices[ weldedVertices[ vertexIndex ] ] )
+			{
+				lockedVertices[ vertexIndex ] = true;
+			}
+		}
+	}
+
+	// Accumulate the plane quadrics of the triangles around each vertex, weighted by triangle area.
+	DynamicArray< Quadric > quadrics;
+	quadrics.Resize( vertexCount );
+	MemoryZero( quadrics.GetData(), vertexCount * sizeof( Quadric ) );
+
+	for( size_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex )
+	{
+		const uint16_t* pTriangle = &rIndices[ triangleIndex * 3 ];
+
+		float64_t normal[ 3 ];
+		ComputeTriangleNormal( pVertices, pTriangle[ 0 ], pTriangle[ 1 ], pTriangle[ 2 ], normal );
+
+		float64_t length = std::sqrt( normal[ 0 ] * normal[ 0 ] + normal[ 1 ] * normal[ 1 ] + normal[ 2 ] * normal[ 2 ] );
+		if( length <= 0.0 )
+		{
+			continue;
+		}
+
+		float64_t area = 0.5 * length;
+		float64_t a = normal[ 0 ] / length;
+		float64_t b = normal[ 1 ] / length;
+		float64_t c = normal[ 2 ] / length;
+		const float32_t* pPosition = pVertices[ pTriangle[ 0 ] ].position;
+		float64_t d = -( a * pPosition[ 0 ] + b * pPosition[ 1 ] + c * pPosition[ 2 ] );
+
+		float64_t planeValues[ 10 ] = { a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d };
+		for( size_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex )
+		{
+			float64_t* pValues = quadrics[ pTriangle[ cornerIndex ] ].values;
+			for( size_t valueIndex = 0; valueIndex < 10; ++valueIndex )
+			{
+				pValues[ valueIndex ] += planeValues[ valueIndex ] * area;
+			}
+		}
+	}
+
+	// Collapse the cheapest edges in passes, only touching each vertex neighborhood once per pass so that the vertex
+	// adjacency built at the start of each pass stays valid.
+	DynamicArray< uint32_t > vertexTriangleOffsets;
+	DynamicArray< uint32_t > vertexTriangles;
+	DynamicArray< EdgeCollapse > collapses;
+	DynamicArray< uint16_t > vertexRemap;
+	DynamicArray< bool > touchedVertices;
+
+	vertexRemap.Resize( vertexCount );
+	touchedVertices.Resize( vertexCount );
+
+	DynamicArray< uint16_t >& rCurrentIndices = rSimplifiedIndices;
+	for( ;; )
+	{
+		triangleCount = rCurrentIndices.GetSize() / 3;
+		if( triangleCount <= targetTriangleCount )
+		{
+			break;
+		}
+
+		vertexTriangleOffsets.Resize( 0 );
+		vertexTriangleOffsets.Resize( vertexCount + 1 );
+	MemoryZero( vertexTriangleOffsets.GetData(), vertexTriangleOffsets.GetSize() * sizeof( uint32_t ) );
+		for( size_t indexIndex = 0; indexIndex < triangleCount * 3; ++indexIndex )
+		{
+			++vertexTriangleOffsets[ rCurrentIndices[ indexIndex ] + 1 ];
+		}
+
+		for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+		{
+			vertexTriangleOffsets[ vertexIndex + 1 ] += vertexTriangleOffsets[ vertexIndex ];
+		}
+
+		vertexTriangles.Resize( triangleCount * 3 );
+		for( size_t indexIndex = 0; indexIndex < triangleCount * 3; ++indexIndex )
+		{
+			uint16_t vertexIndex = rCurrentIndices[ indexIndex ];
+			vertexTriangles[ vertexTriangleOffsets[ vertexIndex ]++ ] = static_cast< uint32_t >( indexIndex / 3 );
+		}
+
+		for( size_t vertexIndex = vertexCount; vertexIndex > 0; --vertexIndex )
+		{
+			vertexTriangleOffsets[ vertexIndex ] = vertexTriangleOffsets[ vertexIndex - 1 ];
+		}
+
+		vertexTriangleOffsets[ 0 ] = 0;
+
+		collapses.Resize( 0 );
+		for( size_t indexIndex = 0; indexIndex < triangleCount * 3; ++indexIndex )
+		{
+			size_t triangleBase = indexIndex - indexIndex % 3;
+			uint16_t fromVertex = rCurrentIndices[ indexIndex ];
+			uint16_t toVertex = rCurrentIndices[ triangleBase + ( indexIndex + 1 ) % 3 ];
+
+			for( size_t directionIndex = 0; directionIndex < 2; ++directionIndex )
+			{
+				if( !lockedVertices[ fromVertex ] )
+				{
+					Quadric combined = quadrics[ fromVertex ];
+					for( size_t valueIndex = 0; valueIndex < 10; ++valueIndex )
+					{
+						combined.values[ valueIndex ] += quadrics[ toVertex ].values[ valueIndex ];
+					}
+
+					EdgeCollapse collapse;
+					collapse.cost = EvaluateQuadric( combined, pVertices[ toVertex ].position );
+					collapse.fromVertex = fromVertex;
+					collapse.toVertex = toVertex;
+					collapses.Push( collapse );
+				}
+
+				uint16_t swapVertex = fromVertex;
+				fromVertex = toVertex;
+				toVertex = swapVertex;
+			}
+		}
+
+		std::sort( collapses.GetData(), collapses.GetData() + collapses.GetSize() );
+
+		for( size_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex )
+		{
+			vertexRemap[ vertexIndex ] = static_cast< uint16_t >( vertexIndex );
+		}
+
+		MemoryZero( touchedVertices.GetData(), vertexCount * sizeof( bool ) );
+
+		size_t remainingTriangleCount = triangleCount;
+		size_t collapseCount = collapses.GetSize();
+		size_t appliedCollapseCount = 0;
+		for( size_t collapseIndex = 0;
+			collapseIndex < collapseCount && remainingTriangleCount > targetTriangleCount;
+			++collapseIndex )
+		{
+			const EdgeCollapse& rCollapse = collapses[ collapseIndex ];
+			uint16_t fromVertex = rCollapse.fromVertex;
+			uint16_t toVertex = rCollapse.toVertex;
+			if( touchedVertices[ fromVertex ] || touchedVertices[ toVertex ] )
+			{
+				continue;
+			}
+
+			// Reject collapses that would flip the facing of any of the remaining triangles around the vertex.
+			uint32_t triangleStart = vertexTriangleOffsets[ fromVertex ];
+			uint32_t triangleEnd = vertexTriangleOffsets[ fromVertex + 1 ];
+			size_t removedTriangleCount = 0;
+			bool bFlips = false;
+			for( uint32_t adjacentIndex = triangleStart; adjacentIndex < triangleEnd && !bFlips; ++adjacentIndex )
+			{
+				const uint16_t* pTriangle = &rCurrentIndices[ vertexTriangles[ adjacentIndex ] * 3 ];
+				if( pTriangle[ 0 ] == toVertex || pTriangle[ 1 ] == toVertex || pTriangle[ 2 ] == toVertex )
+				{
+					++removedTriangleCount;
+
+					continue;
+				}
+
+				uint16_t collapsedTriangle[ 3 ];
+				for( size_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex )
+				{
+					collapsedTriangle[ cornerIndex ] =
+						( pTriangle[ cornerIndex ] == fromVertex ? toVertex : pTriangle[ cornerIndex ] );
+				}
+
+				float64_t normal[ 3 ];
+				float64_t collapsedNormal[ 3 ];
+				ComputeTriangleNormal( pVertices, pTriangle[ 0 ], pTriangle[ 1 ], pTriangle[ 2 ], normal );
+				ComputeTriangleNormal(
+					pVertices, collapsedTriangle[ 0 ], collapsedTriangle[ 1 ], collapsedTriangle[ 2 ], collapsedNormal );
+
+				float64_t facing =
+					normal[ 0 ] * collapsedNormal[ 0 ] +
+					normal[ 1 ] * collapsedNormal[ 1 ] +
+					normal[ 2 ] * collapsedNormal[ 2 ];
+				bFlips = ( facing <= 0.0 );
+			}
+
+			if( bFlips )
+			{
+				continue;
+			}
+
+			vertexRemap[ fromVertex ] = toVertex;
+			for( size_t valueIndex = 0; valueIndex < 10; ++valueIndex )
+			{
+				quadrics[ toVertex ].values[ valueIndex ] += quadrics[ fromVertex ].values[ valueIndex ];
+			}
+
+			for( uint32_t adjacentIndex = triangleStart; adjacentIndex < triangleEnd; ++adjacentIndex )
+			{
+				const uint16_t* pTriangle = &rCurrentIndices[ vertexTriangles[ adjacentIndex ] * 3 ];
+				touchedVertices[ pTriangle[ 0 ] ] = true;
+				touchedVertices[ pTriangle[ 1 ] ] = true;
+				touchedVertices[ pTriangle[ 2 ] ] = true;
+			}
+
+			remainingTriangleCount -= Min( removedTriangleCount, remainingTriangleCount );
+			++appliedCollapseCount;
+		}
+
+		if( appliedCollapseCount == 0 )
+		{
+			break;
+		}
+
+		// Apply the collapses and drop the triangles that became degenerate.
+		size_t keptIndexCount = 0;
+		for( size_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex )
+		{
+			uint16_t vertex0 = vertexRemap[ rCurrentIndices[ triangleIndex * 3 ] ];
+			uint16_t vertex1 = vertexRemap[ rCurrentIndices[ triangleIndex * 3 + 1 ] ];
+			uint16_t vertex2 = vertexRemap[ rCurrentIndices[ triangleIndex * 3 + 2 ] ];
+			if( vertex0 == vertex1 || vertex1 == vertex2 || vertex2 == vertex0 )
+			{
+				continue;
+			}
+
+			rCurrentIndices[ keptIndexCount++ ] = vertex0;
+			rCurrentIndices[ keptIndexCount++ ] = vertex1;
+			rCurrentIndices[ keptIndexCount++ ] = vertex2;
+		}
+
+		rCurrentIndices.Resize( keptIndexCount );
+	}
+}
+
 /// Constructor.
 MeshResourceHandler::MeshResourceHandler()
 : m_rFbxSupport( FbxSupport::StaticAcquire() )
@@ -111,7 +843,140 @@ bool MeshResourceHandler::CacheResource(
 			persistentResourceData->m_bounds.Expand( Simd::Vector3( pPosition[ 0 ], pPosition[ 1 ], pPosition[ 2 ] ) );
 		}
 	}
-	
+
+	// Compute the bounding box of each mesh section so that sections outside a view can be culled individually.
+	// Each section addresses its own contiguous range of vertices, stored in section order.
+	const DynamicArray< uint16_t >& rSectionVertexCounts = persistentResourceData->m_sectionVertexCounts;
+	size_t sectionCount = rSectionVertexCounts.GetSize();
+	DynamicArray< Simd::AaBox >& rSectionBounds = persistentResourceData->m_sectionBounds;
+	rSectionBounds.Reserve( sectionCount );
+	rSectionBounds.Resize( sectionCount );
+
+	size_t sectionVertexOffset = 0;
+	for( size_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex )
+	{
+		size_t sectionVertexCount = rSectionVertexCounts[ sectionIndex ];
+		HELIUM_ASSERT( sectionVertexOffset + sectionVertexCount <= vertexCountActual );
+
+		Simd::AaBox& rBounds = rSectionBounds[ sectionIndex ];
+		if( sectionVertexCount == 0 )
+		{
+			rBounds = persistentResourceData->m_bounds;
+			continue;
+		}
+
+		const float32_t* pPosition = vertices[ sectionVertexOffset ].position;
+		Simd::Vector3 position( pPosition[ 0 ], pPosition[ 1 ], pPosition[ 2 ] );
+		rBounds.Set( position, position );
+		for( size_t vertexIndex = 1; vertexIndex < sectionVertexCount; ++vertexIndex )
+		{
+			pPosition = vertices[ sectionVertexOffset + vertexIndex ].position;
+			rBounds.Expand( Simd::Vector3( pPosition[ 0 ], pPosition[ 1 ], pPosition[ 2 ] ) );
+		}
+
+		sectionVertexOffset += sectionVertexCount;
+	}
+
+	// Order the triangles of each section for the post-transform vertex cache, then the section vertices in the order
+	// they are first used so that vertex fetches walk through the vertex buffer mostly sequentially.
+	const DynamicArray< uint32_t >& rSectionTriangleCounts = persistentResourceData->m_sectionTriangleCounts;
+	HELIUM_ASSERT( rSectionTriangleCounts.GetSize() == sectionCount );
+
+	FbxSupport::BlendData* pBlendData =
+		( vertexBlendData.GetSize() == vertexCountActual ? vertexBlendData.GetData() : NULL );
+
+	sectionVertexOffset = 0;
+	size_t sectionIndexOffset = 0;
+	for( size_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex )
+	{
+		size_t sectionVertexCount = rSectionVertexCounts[ sectionIndex ];
+		size_t sectionIndexCount = static_cast< size_t >( rSectionTriangleCounts[ sectionIndex ] ) * 3;
+		HELIUM_ASSERT( sectionIndexOffset + sectionIndexCount <= indexCount );
+
+		uint16_t* pSectionIndices = indices.GetData() + sectionIndexOffset;
+		OptimizeMeshSectionVertexCache( pSectionIndices, sectionIndexCount, sectionVertexCount );
+		ReorderMeshSectionVertices(
+			vertices.GetData() + sectionVertexOffset,
+			( pBlendData ? pBlendData + sectionVertexOffset : NULL ),
+			sectionVertexCount,
+			pSectionIndices,
+			sectionIndexCount );
+
+		sectionVertexOffset += sectionVertexCount;
+		sectionIndexOffset += sectionIndexCount;
+	}
+
+	// Generate levels of detail by simplifying each section of the previous level of detail in turn.  Each level of
+	// detail only stores new indices, addressing a subset of the full-detail section vertices.
+	DynamicArray< DynamicArray< uint16_t > > lodIndices;
+	if( triangleCountActual >= MESH_LOD_MIN_TRIANGLE_COUNT )
+	{
+		DynamicArray< DynamicArray< uint16_t > > sectionIndices;
+		sectionIndices.Resize( sectionCount );
+
+		sectionIndexOffset = 0;
+		for( size_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex )
+		{
+			size_t sectionIndexCount = static_cast< size_t >( rSectionTriangleCounts[ sectionIndex ] ) * 3;
+			HELIUM_ASSERT( sectionIndexOffset + sectionIndexCount <= indexCount );
+			sectionIndices[ sectionIndex ].Add( indices.GetData() + sectionIndexOffset, sectionIndexCount );
+			sectionIndexOffset += sectionIndexCount;
+		}
+
+		DynamicArray< uint16_t > simplifiedIndices;
+		DynamicArray< uint32_t > lodSectionTriangleCounts;
+		size_t previousTriangleCount = triangleCountActual;
+		float32_t screenSize = MESH_LOD_FIRST_SCREEN_SIZE;
+
+		for( size_t lodIndex = 1; lodIndex < MESH_LOD_COUNT_MAX; ++lodIndex )
+		{
+			DynamicArray< uint16_t > levelIndices;
+			lodSectionTriangleCounts.Resize( 0 );
+
+			sectionVertexOffset = 0;
+			for( size_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex )
+			{
+				DynamicArray< uint16_t >& rSectionIndices = sectionIndices[ sectionIndex ];
+				size_t sectionVertexCount = rSectionVertexCounts[ sectionIndex ];
+				size_t targetTriangleCount = static_cast< size_t >(
+					static_cast< float32_t >( rSectionIndices.GetSize() / 3 ) * MESH_LOD_TRIANGLE_RATIO );
+
+				SimplifyMeshSection(
+					vertices.GetData() + sectionVertexOffset,
+					sectionVertexCount,
+					rSectionIndices,
+					targetTriangleCount,
+					simplifiedIndices );
+				OptimizeMeshSectionVertexCache(
+					simplifiedIndices.GetData(),
+					simplifiedIndices.GetSize(),
+					sectionVertexCount );
+
+				rSectionIndices = simplifiedIndices;
+				levelIndices.Add( rSectionIndices.GetData(), rSectionIndices.GetSize() );
+				lodSectionTriangleCounts.Push( static_cast< uint32_t >( rSectionIndices.GetSize() / 3 ) );
+
+				sectionVertexOffset += sectionVertexCount;
+			}
+
+			size_t levelTriangleCount = levelIndices.GetSize() / 3;
+			if( static_cast< float32_t >( levelTriangleCount ) >
+				static_cast< float32_t >( previousTriangleCount ) * MESH_LOD_MIN_REDUCTION_RATIO )
+			{
+				break;
+			}
+
+			lodIndices.Push( levelIndices );
+			persistentResourceData->m_lodScreenSizes.Push( screenSize );
+			persistentResourceData->m_lodSectionTriangleCounts.Add(
+				lodSectionTriangleCounts.GetData(),
+				lodSectionTriangleCounts.GetSize() );
+
+			previousTriangleCount = levelTriangleCount;
+			screenSize *= 0.5f;
+		}
+	}
+
 	persistentResourceData->m_pBoneNames.Resize(persistentResourceData->m_boneCount);
 	persistentResourceData->m_pParentBoneIndices.Resize(persistentResourceData->m_boneCount);
 	persistentResourceData->m_pReferencePose.Resize(persistentResourceData->m_boneCount);
@@ -136,9 +1001,11 @@ bool MeshResourceHandler::CacheResource(
 		Resource::PreprocessedData& rPreprocessedData = pResource->GetPreprocessedData(
 			static_cast< Cache::EPlatform >( platformIndex ) );
 
+		size_t lodRangeCount = lodIndices.GetSize();
+
 		DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
-		rSubDataBuffers.Reserve( 2 );
-		rSubDataBuffers.Resize( 2 );
+		rSubDataBuffers.Reserve( 2 + lodRangeCount );
+		rSubDataBuffers.Resize( 2 + lodRangeCount );
 		rSubDataBuffers.Trim();
 
 		Cache::WriteCacheObjectToBuffer( persistentResourceData.Get(), rPreprocessedData.persistentDataBuffer);
@@ -245,6 +1112,17 @@ bool MeshResourceHandler::CacheResource(
 		rSubDataBuffers[ 1 ].Resize(indexDataSize);
 		MemoryCopy(rSubDataBuffers[1].GetData(), indices.GetData(), indexDataSize);
 
+		// Serialize the indices of each level of detail past the first into their own sub-data.
+		for( size_t lodRangeIndex = 0; lodRangeIndex < lodRangeCount; ++lodRangeIndex )
+		{
+			const DynamicArray< uint16_t >& rLodIndices = lodIndices[ lodRangeIndex ];
+			size_t lodIndexDataSize = rLodIndices.GetSize() * sizeof( uint16_t );
+
+			DynamicArray< uint8_t >& rLodSubDataBuffer = rSubDataBuffers[ 2 + lodRangeIndex ];
+			rLodSubDataBuffer.Resize( lodIndexDataSize );
+			MemoryCopy( rLodSubDataBuffer.GetData(), rLodIndices.GetData(), lodIndexDataSize );
+		}
+
 		// Platform data is now loaded.
 		rPreprocessedData.bLoaded = true;
 	}
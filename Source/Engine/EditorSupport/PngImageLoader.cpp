@@ -181,6 +181,13 @@ bool PngImageLoader::Load( Image& rImage, Stream* pSourceStream )
     // Always convert 16-bit image data to 8-bit, as Image currently does not support more than 8 bits per channel.
     png_set_strip_16( pPng );
 
+    // Decode straight into 32-bit BGRA pixels, which is the layout texture processing converts all images to,
+    // letting libpng perform the expansion and reordering while unpacking each row instead of converting the image
+    // afterwards.
+    png_set_gray_to_rgb( pPng );
+    png_set_bgr( pPng );
+    png_set_filler( pPng, 0xff, PNG_FILLER_AFTER );
+
     // Get the number of passes for interlaced image handling (must be done before we call png_read_update_info()).
     int passCount = png_set_interlace_handling( pPng );
 
@@ -197,8 +204,7 @@ bool PngImageLoader::Load( Image& rImage, Stream* pSourceStream )
     HELIUM_ASSERT( bitDepth == 8 );
 
     png_byte channels = png_get_channels( pPng, pPngInfo );
-    HELIUM_ASSERT( channels >= 1 );
-    HELIUM_ASSERT( channels <= 4 );
+    HELIUM_ASSERT( channels == 4 );
 
     uint8_t bytesPerPixel = bitDepth * channels / 8;
 
@@ -207,77 +213,22 @@ bool PngImageLoader::Load( Image& rImage, Stream* pSourceStream )
     imageParameters.pitch = static_cast< uint32_t >( pitch );
     imageParameters.format.SetBytesPerPixel( bytesPerPixel );
 
-    switch( bytesPerPixel )
-    {
-        // Grayscale.
-    case 1:
-        {
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_RED, 8 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 0 );
-
-            break;
-        }
-
-        // Grayscale with alpha.
-    case 2:
-        {
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_RED, 8 );
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_ALPHA, 8 );
+    imageParameters.format.SetChannelBitCount( Image::CHANNEL_RED, 8 );
+    imageParameters.format.SetChannelBitCount( Image::CHANNEL_GREEN, 8 );
+    imageParameters.format.SetChannelBitCount( Image::CHANNEL_BLUE, 8 );
+    imageParameters.format.SetChannelBitCount( Image::CHANNEL_ALPHA, 8 );
 #if HELIUM_ENDIAN_LITTLE
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 0 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_ALPHA, 8 );
+    imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 16 );
+    imageParameters.format.SetChannelBitOffset( Image::CHANNEL_GREEN, 8 );
+    imageParameters.format.SetChannelBitOffset( Image::CHANNEL_BLUE, 0 );
+    imageParameters.format.SetChannelBitOffset( Image::CHANNEL_ALPHA, 24 );
 #else
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 8 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_ALPHA, 0 );
+    imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 8 );
+    imageParameters.format.SetChannelBitOffset( Image::CHANNEL_GREEN, 16 );
+    imageParameters.format.SetChannelBitOffset( Image::CHANNEL_BLUE, 24 );
+    imageParameters.format.SetChannelBitOffset( Image::CHANNEL_ALPHA, 0 );
 #endif
 
-            break;
-        }
-
-        // RGB.
-    case 3:
-        {
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_RED, 8 );
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_GREEN, 8 );
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_BLUE, 8 );
-#if HELIUM_ENDIAN_LITTLE
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 0 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_GREEN, 8 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_BLUE, 16 );
-#else
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 16 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_GREEN, 8 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_BLUE, 0 );
-#endif
-
-            break;
-        }
-
-        // RGBA
-    default:
-        {
-            HELIUM_ASSERT( bytesPerPixel == 4 );
-
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_RED, 8 );
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_GREEN, 8 );
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_BLUE, 8 );
-            imageParameters.format.SetChannelBitCount( Image::CHANNEL_ALPHA, 8 );
-#if HELIUM_ENDIAN_LITTLE
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 0 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_GREEN, 8 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_BLUE, 16 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_ALPHA, 24 );
-#else
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_RED, 24 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_GREEN, 16 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_BLUE, 8 );
-            imageParameters.format.SetChannelBitOffset( Image::CHANNEL_ALPHA, 0 );
-#endif
-
-            break;
-        }
-    }
-
     if( !rImage.Initialize( imageParameters ) )
     {
         HELIUM_TRACE(
@@ -12,15 +12,35 @@
 #include "Engine/AssetLoader.h"
 #include "Engine/PackageLoader.h"
 #include "Rendering/ShaderProfiles.h"
+#include "EngineJobs/JobManager.h"
 #include "PcSupport/AssetPreprocessor.h"
 
 HELIUM_IMPLEMENT_ASSET( Helium::ShaderVariantResourceHandler, EditorSupport, 0 );
 
 using namespace Helium;
 
+/// Header of a compiled shader file.
+struct CompiledShaderFileHeader
+{
+	/// File format version.
+	uint32_t version;
+	/// Size of the compiled code, in bytes.
+	uint32_t size;
+	/// Key of the permutation.
+	uint64_t compileKey;
+	/// Hash of the compiled code.
+	uint64_t contentHash;
+};
+
+/// Compiled shader file format version.
+static const uint32_t COMPILED_SHADER_FILE_VERSION = 1;
+
 /// Constructor.
 ShaderVariantResourceHandler::ShaderVariantResourceHandler()
 : m_loadRequestPool( LOAD_REQUEST_POOL_BLOCK_SIZE )
+, m_pCompileWorker( NULL )
+, m_pCompileThread( NULL )
+, m_compileStopCounter( 0 )
 {
 	// Objects of this type should only be constructed in the editor, and only the template should exist, so
 	// register ourself to override the shader variant load process.
@@ -34,6 +54,18 @@ ShaderVariantResourceHandler::ShaderVariantResourceHandler()
 /// Destructor.
 ShaderVariantResourceHandler::~ShaderVariantResourceHandler()
 {
+	if( m_pCompileThread )
+	{
+		AtomicExchangeRelease( m_compileStopCounter, 1 );
+		m_compileWakeUpSemaphore.Increment();
+
+		m_pCompileThread->Join();
+		delete m_pCompileThread;
+		m_pCompileThread = NULL;
+
+		delete m_pCompileWorker;
+		m_pCompileWorker = NULL;
+	}
 }
 
 /// @copydoc ResourceHandler::GetResourceType()
@@ -42,6 +74,20 @@ const AssetType* ShaderVariantResourceHandler::GetResourceType() const
 	return ShaderVariant::GetStaticType();
 }
 
+/// Set the directory in which compiled shader code is kept.
+///
+/// Pointing several machines at the same (shared) directory lets them reuse each other's compiled code.  This should
+/// only be changed while no shaders are being compiled.
+///
+/// @param[in] rDirectory  Compiled shader directory, or an empty path to use the default directory in the user data
+///                        directory.
+///
+/// @see GetCompiledShaderDirectory()
+void ShaderVariantResourceHandler::SetCompiledShaderDirectory( const FilePath& rDirectory )
+{
+	m_compiledShaderDirectory = rDirectory;
+}
+
 /// @copydoc ResourceHandler::CacheResource()
 bool ShaderVariantResourceHandler::CacheResource(
 	AssetPreprocessor* pAssetPreprocessor,
@@ -239,14 +285,9 @@ bool ShaderVariantResourceHandler::CacheResource(
 		rPreprocessedData.bLoaded = true;
 	}
 
-//     DynamicArray< uint8_t > compiledCodeBuffer;
-//     DynamicArray< ShaderConstantBufferInfo > constantBuffers, pcSm4ConstantBuffers;
-//     DynamicArray< ShaderSamplerInfo > samplerInputs;
-//     DynamicArray< ShaderTextureInfo > textureInputs;
-	
-	Helium::StrongPtr<CompiledShaderData> spCompiledShaderData(new CompiledShaderData());
-	
-	CompiledShaderData &csd_pc_sm4 = *spCompiledShaderData;
+	// Build the full token list of each system option set.
+	DynamicArray< DynamicArray< PlatformPreprocessor::ShaderToken > > optionSetTokens;
+	optionSetTokens.Resize( systemOptionSetCount );
 
 	for( size_t systemOptionSetIndex = 0; systemOptionSetIndex < systemOptionSetCount; ++systemOptionSetIndex )
 	{
@@ -277,126 +318,164 @@ bool ShaderVariantResourceHandler::CacheResource(
 			pToken->definition = "1";
 		}
 
-		// Compile for PC shader model 4 first so that we can get the constant buffer information.
-		PlatformPreprocessor* pPreprocessor = pAssetPreprocessor->GetPlatformPreprocessor( Cache::PLATFORM_PC );
-		HELIUM_ASSERT( pPreprocessor );
+		optionSetTokens[ systemOptionSetIndex ] = shaderTokens;
 
-		csd_pc_sm4.compiledCodeBuffer.Resize( 0 );
-		bool bCompiled = CompileShader(
-			pVariant,
-			pPreprocessor,
-			Cache::PLATFORM_PC,
-			ShaderProfile::PC_SM4,
-			shaderType,
-			pShaderSource,
-			size,
-			shaderTokens,
-			csd_pc_sm4.compiledCodeBuffer );
-		if( !bCompiled )
+		// Trim the system tokens off the shader token list for the next option set.
+		shaderTokens.Resize( userShaderTokenCount );
+	}
+
+	PermutationCompileContext compileContext;
+	compileContext.pHandler = this;
+	compileContext.pVariant = pVariant;
+	compileContext.shaderType = shaderType;
+	compileContext.pShaderSource = pShaderSource;
+	compileContext.shaderSourceSize = size;
+	compileContext.pOptionSetTokens = optionSetTokens.GetData();
+
+	// Compile every option set for PC shader model 4 first so that we can get the constant buffer information.
+	PlatformPreprocessor* pPcPreprocessor = pAssetPreprocessor->GetPlatformPreprocessor( Cache::PLATFORM_PC );
+	HELIUM_ASSERT( pPcPreprocessor );
+
+	DynamicArray< PermutationCompile > compiles;
+	compiles.Resize( systemOptionSetCount );
+	for( size_t systemOptionSetIndex = 0; systemOptionSetIndex < systemOptionSetCount; ++systemOptionSetIndex )
+	{
+		PermutationCompile& rCompile = compiles[ systemOptionSetIndex ];
+		rCompile.pPreprocessor = pPcPreprocessor;
+		rCompile.platformIndex = Cache::PLATFORM_PC;
+		rCompile.shaderProfileIndex = ShaderProfile::PC_SM4;
+		rCompile.systemOptionSetIndex = systemOptionSetIndex;
+		rCompile.bCompiled = false;
+	}
+
+	compileContext.pCompiles = compiles.GetData();
+	JobManager::ParallelFor( CompilePermutationCallback, &compileContext, compiles.GetSize() );
+
+	Helium::StrongPtr<CompiledShaderData> spCompiledShaderData(new CompiledShaderData());
+	
+	CompiledShaderData &csd_pc_sm4 = *spCompiledShaderData;
+
+	// Constant buffers of each option set read from its PC shader model 4 reflection data (only filled out for the
+	// option sets to build for the remaining targets).
+	DynamicArray< DynamicArray< ShaderConstantBufferInfo > > optionSetConstantBuffers;
+	optionSetConstantBuffers.Resize( systemOptionSetCount );
+	DynamicArray< size_t > reflectedOptionSetIndices;
+
+	for( size_t systemOptionSetIndex = 0; systemOptionSetIndex < systemOptionSetCount; ++systemOptionSetIndex )
+	{
+		PermutationCompile& rCompile = compiles[ systemOptionSetIndex ];
+		if( !rCompile.bCompiled )
 		{
 			HELIUM_TRACE(
 				TraceLevels::Error,
 				"ShaderVariantResourceHandler: Failed to compile shader for PC shader model 4, which is needed for reflection purposes.  Additional shader targets will not be built.\n" );
+
+			continue;
 		}
-		else
+
+		csd_pc_sm4.compiledCodeBuffer.Swap( rCompile.compiledCode );
+		csd_pc_sm4.constantBuffers.Resize( 0 );
+		csd_pc_sm4.samplerInputs.Resize( 0 );
+		csd_pc_sm4.textureInputs.Resize( 0 );
+		bool bReadConstantBuffers = pPcPreprocessor->FillShaderReflectionData(
+			ShaderProfile::PC_SM4,
+			csd_pc_sm4.compiledCodeBuffer.GetData(),
+			csd_pc_sm4.compiledCodeBuffer.GetSize(),
+			csd_pc_sm4.constantBuffers,
+			csd_pc_sm4.samplerInputs,
+			csd_pc_sm4.textureInputs );
+		if( !bReadConstantBuffers )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"ShaderVariantResourceHandler: Failed to read reflection information for PC shader model 4.  Additional shader targets will not be built.\n" );
+
+			continue;
+		}
+
+		Resource::PreprocessedData& rPcPreprocessedData = pVariant->GetPreprocessedData( Cache::PLATFORM_PC );
+		DynamicArray< DynamicArray< uint8_t > >& rPcSubDataBuffers = rPcPreprocessedData.subDataBuffers;
+		DynamicArray< uint8_t >& rPcSm4SubDataBuffer =
+			rPcSubDataBuffers[ ShaderProfile::PC_SM4 * systemOptionSetCount + systemOptionSetIndex ];
+
+		Cache::WriteCacheObjectToBuffer( &csd_pc_sm4, rPcSm4SubDataBuffer);
+
+		optionSetConstantBuffers[ systemOptionSetIndex ] = csd_pc_sm4.constantBuffers;
+		reflectedOptionSetIndices.Push( systemOptionSetIndex );
+	}
+
+	// Compile the remaining shader profiles of each supported target platform.
+	compiles.Resize( 0 );
+
+	size_t reflectedOptionSetCount = reflectedOptionSetIndices.GetSize();
+	for( size_t platformIndex = 0; platformIndex < static_cast< size_t >( Cache::PLATFORM_MAX ); ++platformIndex )
+	{
+		PlatformPreprocessor* pPreprocessor = pAssetPreprocessor->GetPlatformPreprocessor(
+			static_cast< Cache::EPlatform >( platformIndex ) );
+		if( !pPreprocessor )
+		{
+			continue;
+		}
+
+		size_t shaderProfileCount = pPreprocessor->GetShaderProfileCount();
+		for( size_t shaderProfileIndex = 0; shaderProfileIndex < shaderProfileCount; ++shaderProfileIndex )
 		{
-			csd_pc_sm4.constantBuffers.Resize( 0 );
-			csd_pc_sm4.samplerInputs.Resize( 0 );
-			csd_pc_sm4.textureInputs.Resize( 0 );
-			bool bReadConstantBuffers = pPreprocessor->FillShaderReflectionData(
-				ShaderProfile::PC_SM4,
-				csd_pc_sm4.compiledCodeBuffer.GetData(),
-				csd_pc_sm4.compiledCodeBuffer.GetSize(),
-				csd_pc_sm4.constantBuffers,
-				csd_pc_sm4.samplerInputs,
-				csd_pc_sm4.textureInputs );
-			if( !bReadConstantBuffers )
+			// Already cached PC shader model 4...
+			if( shaderProfileIndex == ShaderProfile::PC_SM4 && platformIndex == Cache::PLATFORM_PC )
 			{
-				HELIUM_TRACE(
-					TraceLevels::Error,
-					"ShaderVariantResourceHandler: Failed to read reflection information for PC shader model 4.  Additional shader targets will not be built.\n" );
+				continue;
 			}
-			else
+
+			for( size_t reflectedIndex = 0; reflectedIndex < reflectedOptionSetCount; ++reflectedIndex )
 			{
-				Resource::PreprocessedData& rPcPreprocessedData = pVariant->GetPreprocessedData(
-					Cache::PLATFORM_PC );
-				DynamicArray< DynamicArray< uint8_t > >& rPcSubDataBuffers = rPcPreprocessedData.subDataBuffers;
-				DynamicArray< uint8_t >& rPcSm4SubDataBuffer =
-					rPcSubDataBuffers[ ShaderProfile::PC_SM4 * systemOptionSetCount + systemOptionSetIndex ];
-
-				Cache::WriteCacheObjectToBuffer( &csd_pc_sm4, rPcSm4SubDataBuffer);
-				
-				// FOR EACH PLATFORM
-				for( size_t platformIndex = 0;
-					platformIndex < static_cast< size_t >( Cache::PLATFORM_MAX );
-					++platformIndex )
-				{
-					PlatformPreprocessor* pPreprocessor = pAssetPreprocessor->GetPlatformPreprocessor(
-						static_cast< Cache::EPlatform >( platformIndex ) );
-					if( !pPreprocessor )
-					{
-						continue;
-					}
-					
-					// GET PLATFORM'S SUBDATA BUFFER
-					Resource::PreprocessedData& rPreprocessedData = pVariant->GetPreprocessedData(
-						static_cast< Cache::EPlatform >( platformIndex ) );
-					DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
-
-					size_t shaderProfileCount = pPreprocessor->GetShaderProfileCount();
-					for( size_t shaderProfileIndex = 0;
-						shaderProfileIndex < shaderProfileCount;
-						++shaderProfileIndex )
-					{
-						CompiledShaderData csd;
-						csd.GetRefCountProxy()->AddStrongRef(); // stack allocated object!!
-
-						// Already cached PC shader model 4...
-						if( shaderProfileIndex == ShaderProfile::PC_SM4 && platformIndex == Cache::PLATFORM_PC )
-						{
-							continue;
-						}
-
-						bCompiled = CompileShader(
-							pVariant,
-							pPreprocessor,
-							platformIndex,
-							shaderProfileIndex,
-							shaderType,
-							pShaderSource,
-							size,
-							shaderTokens,
-							csd.compiledCodeBuffer );
-						if( !bCompiled )
-						{
-							continue;
-						}
-
-						csd.constantBuffers = csd_pc_sm4.constantBuffers;
-						csd.samplerInputs.Resize( 0 );
-						csd.textureInputs.Resize( 0 );
-						bReadConstantBuffers = pPreprocessor->FillShaderReflectionData(
-							shaderProfileIndex,
-							csd.compiledCodeBuffer.GetData(),
-							csd.compiledCodeBuffer.GetSize(),
-							csd.constantBuffers,
-							csd.samplerInputs,
-							csd.textureInputs );
-						if( !bReadConstantBuffers )
-						{
-							continue;
-						}
-
-						DynamicArray< uint8_t >& rTargetSubDataBuffer =
-							rSubDataBuffers[ shaderProfileIndex * systemOptionSetCount + systemOptionSetIndex ];
-						Cache::WriteCacheObjectToBuffer( &csd, rTargetSubDataBuffer);
-					}
-				}
+				PermutationCompile* pCompile = compiles.New();
+				HELIUM_ASSERT( pCompile );
+				pCompile->pPreprocessor = pPreprocessor;
+				pCompile->platformIndex = platformIndex;
+				pCompile->shaderProfileIndex = shaderProfileIndex;
+				pCompile->systemOptionSetIndex = reflectedOptionSetIndices[ reflectedIndex ];
+				pCompile->bCompiled = false;
 			}
 		}
+	}
 
-		// Trim the system tokens off the shader token list for the next pass.
-		shaderTokens.Resize( userShaderTokenCount );
+	compileContext.pCompiles = compiles.GetData();
+	JobManager::ParallelFor( CompilePermutationCallback, &compileContext, compiles.GetSize() );
+
+	size_t compileCount = compiles.GetSize();
+	for( size_t compileIndex = 0; compileIndex < compileCount; ++compileIndex )
+	{
+		PermutationCompile& rCompile = compiles[ compileIndex ];
+		if( !rCompile.bCompiled )
+		{
+			continue;
+		}
+
+		CompiledShaderData csd;
+		csd.GetRefCountProxy()->AddStrongRef(); // stack allocated object!!
+
+		csd.compiledCodeBuffer.Swap( rCompile.compiledCode );
+		csd.constantBuffers = optionSetConstantBuffers[ rCompile.systemOptionSetIndex ];
+		csd.samplerInputs.Resize( 0 );
+		csd.textureInputs.Resize( 0 );
+		bool bReadConstantBuffers = rCompile.pPreprocessor->FillShaderReflectionData(
+			rCompile.shaderProfileIndex,
+			csd.compiledCodeBuffer.GetData(),
+			csd.compiledCodeBuffer.GetSize(),
+			csd.constantBuffers,
+			csd.samplerInputs,
+			csd.textureInputs );
+		if( !bReadConstantBuffers )
+		{
+			continue;
+		}
+
+		Resource::PreprocessedData& rPreprocessedData = pVariant->GetPreprocessedData(
+			static_cast< Cache::EPlatform >( rCompile.platformIndex ) );
+		DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
+		DynamicArray< uint8_t >& rTargetSubDataBuffer =
+			rSubDataBuffers[ rCompile.shaderProfileIndex * systemOptionSetCount + rCompile.systemOptionSetIndex ];
+		Cache::WriteCacheObjectToBuffer( &csd, rTargetSubDataBuffer);
 	}
 
 	allocator.Free( pShaderSource );
@@ -424,10 +503,13 @@ size_t ShaderVariantResourceHandler::BeginLoadVariant(
 	// Attempt to locate an existing load request for the specified shader variant.
 	LoadRequest* pLoadRequest = m_loadRequestPool.Allocate();
 	HELIUM_ASSERT( pLoadRequest );
+	pLoadRequest->pShader = pShader;
 	pLoadRequest->shaderType = shaderType;
 	pLoadRequest->userOptionIndex = userOptionIndex;
 	HELIUM_ASSERT( !pLoadRequest->spVariant );
 	pLoadRequest->requestCount = 1;
+	pLoadRequest->compiledCounter = 1;
+	pLoadRequest->bPrecacheStarted = false;
 
 	LoadRequestSetType::ConstAccessor loadRequestConstAccessor;
 	if( !m_loadRequestSet.Insert( loadRequestConstAccessor, pLoadRequest ) )
@@ -481,27 +563,15 @@ size_t ShaderVariantResourceHandler::BeginLoadVariant(
 		}
 	}
 
-	// If we have an object for the shader variant, attempt to load its resource data.
+	// If we have an object for the shader variant, queue its resource data to be loaded (and compiled if it is not
+	// yet cached) on the compile thread.
 	ShaderVariant* pVariant = pLoadRequest->spVariant;
 	if( pVariant && !pVariant->GetAnyFlagSet( Asset::FLAG_PRECACHED ) )
 	{
-		AssetPreprocessor* pAssetPreprocessor = AssetPreprocessor::GetInstance();
-		HELIUM_ASSERT( pAssetPreprocessor );
 		HELIUM_ASSERT( !pVariant->GetPath().IsEmpty() );
 
-		pAssetPreprocessor->LoadResourceData( pVariant->GetPath(), pVariant );
-
-		// Resource data loaded, so deserialize the persistent data for the current platform and begin precaching.
-		CacheManager* pCacheManager = CacheManager::GetInstance();
-		HELIUM_ASSERT( pCacheManager );
-
-		const Resource::PreprocessedData& rPreprocessedData = pVariant->GetPreprocessedData(
-			pCacheManager->GetCurrentPlatform() );
-		const DynamicArray< uint8_t >& rPersistentDataBuffer = rPreprocessedData.persistentDataBuffer;
-
-		Reflect::ObjectPtr persistent_resource_data = Cache::ReadCacheObjectFromBuffer(rPersistentDataBuffer);
-		pVariant->LoadPersistentResourceObject(persistent_resource_data);
-		pVariant->BeginPrecacheResourceData();
+		pLoadRequest->compiledCounter = 0;
+		QueueCompile( pLoadRequest );
 	}
 
 	size_t loadId = m_loadRequestPool.GetIndex( pLoadRequest );
@@ -534,6 +604,29 @@ bool ShaderVariantResourceHandler::TryFinishLoadVariant( size_t loadId, ShaderVa
 	ShaderVariant* pVariant = pLoadRequest->spVariant;
 	if( pVariant && !pVariant->GetAnyFlagSet( Asset::FLAG_PRECACHED ) )
 	{
+		if( pLoadRequest->compiledCounter == 0 )
+		{
+			return false;
+		}
+
+		if( !pLoadRequest->bPrecacheStarted )
+		{
+			// Resource data loaded, so deserialize the persistent data for the current platform and begin
+			// precaching.
+			CacheManager* pCacheManager = CacheManager::GetInstance();
+			HELIUM_ASSERT( pCacheManager );
+
+			const Resource::PreprocessedData& rPreprocessedData = pVariant->GetPreprocessedData(
+				pCacheManager->GetCurrentPlatform() );
+			const DynamicArray< uint8_t >& rPersistentDataBuffer = rPreprocessedData.persistentDataBuffer;
+
+			Reflect::ObjectPtr persistent_resource_data = Cache::ReadCacheObjectFromBuffer(rPersistentDataBuffer);
+			pVariant->LoadPersistentResourceObject(persistent_resource_data);
+			pVariant->BeginPrecacheResourceData();
+
+			pLoadRequest->bPrecacheStarted = true;
+		}
+
 		if( !pVariant->TryFinishPrecacheResourceData() )
 		{
 			return false;
@@ -563,6 +656,55 @@ bool ShaderVariantResourceHandler::TryFinishLoadVariant( size_t loadId, ShaderVa
 	return true;
 }
 
+/// Queue a load request for its variant resource data to be loaded on the compile thread.
+///
+/// The compile thread is started the first time this is called.
+///
+/// @param[in] pRequest  Load request to queue.
+///
+/// @see PopCompileRequest()
+void ShaderVariantResourceHandler::QueueCompile( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+
+	if( !m_pCompileThread )
+	{
+		m_pCompileWorker = new CompileWorker( this );
+		HELIUM_ASSERT( m_pCompileWorker );
+
+		m_pCompileThread = new RunnableThread( m_pCompileWorker );
+		HELIUM_ASSERT( m_pCompileThread );
+		HELIUM_VERIFY( m_pCompileThread->Start( "ShaderVariantResourceHandler - shader compiling" ) );
+	}
+
+	{
+		MutexScopeLock scopeLock( m_compileQueueLock );
+		m_compileQueue.Push( pRequest );
+	}
+
+	m_compileWakeUpSemaphore.Increment();
+}
+
+/// Take the oldest load request from the compile queue.
+///
+/// @return  Load request to compile, or null if the queue is empty.
+///
+/// @see QueueCompile()
+ShaderVariantResourceHandler::LoadRequest* ShaderVariantResourceHandler::PopCompileRequest()
+{
+	MutexScopeLock scopeLock( m_compileQueueLock );
+
+	if( m_compileQueue.IsEmpty() )
+	{
+		return NULL;
+	}
+
+	LoadRequest* pRequest = m_compileQueue[ 0 ];
+	m_compileQueue.Remove( 0 );
+
+	return pRequest;
+}
+
 /// Callback registered with the Shader class to override variant begin-load calls.
 ///
 /// @param[in] pCallbackData    Pointer to the ShaderVariantResourceHandler instance registered as the callback data
@@ -614,6 +756,10 @@ bool ShaderVariantResourceHandler::TryFinishLoadVariantCallback(
 
 /// Helper function for compiling a shader for a specific profile.
 ///
+/// If the platform preprocessor supports preprocessing shaders, previously compiled code of a permutation with the
+/// same preprocessed source and target is reused, and newly compiled code is saved for reuse.  This may be called
+/// from several threads at once.
+///
 /// @param[in]  pVariant             Shader variant for which we are compiling.
 /// @param[in]  pPreprocessor        Platform preprocessor to use for compiling.
 /// @param[in]  platformIndex        Platform index.
@@ -634,15 +780,13 @@ bool ShaderVariantResourceHandler::CompileShader(
 	const void* pShaderSourceData,
 	size_t shaderSourceSize,
 	const DynamicArray< PlatformPreprocessor::ShaderToken >& rTokens,
-	DynamicArray< uint8_t >& rCompiledCodeBuffer )
+	DynamicArray< uint8_t >& rCompiledCodeBuffer ) const
 {
 	HELIUM_ASSERT( pVariant );
 	HELIUM_ASSERT( pPreprocessor );
 	HELIUM_ASSERT( static_cast< size_t >( shaderType ) < static_cast< size_t >( RShader::TYPE_MAX ) );
 	HELIUM_ASSERT( pShaderSourceData || shaderSourceSize == 0 );
 
-	HELIUM_UNREF( platformIndex );  // Variable is used for logging only.
-
 	rCompiledCodeBuffer.Resize( 0 );
 
 #if HELIUM_ENABLE_TRACE
@@ -661,6 +805,51 @@ bool ShaderVariantResourceHandler::CompileShader(
 
 	shaderFilePath += pVariant->GetPath().GetParent().ToFilePathString().GetData();
 
+	AssetPreprocessor* pAssetPreprocessor = AssetPreprocessor::GetInstance();
+	HELIUM_ASSERT( pAssetPreprocessor );
+
+	DynamicArray< FilePath > includedFiles;
+
+	// Identical permutations (such as those of different variants whose options do not affect the preprocessed
+	// source) share the same compiled code, so look it up by the hash of the preprocessed source first.
+	uint64_t compileKey = 0;
+	DynamicArray< uint8_t > preprocessedCode;
+	bool bPreprocessed = pPreprocessor->PreprocessShader(
+		shaderFilePath,
+		shaderProfileIndex,
+		shaderType,
+		pShaderSourceData,
+		shaderSourceSize,
+		rTokens.GetData(),
+		rTokens.GetSize(),
+		preprocessedCode,
+		&includedFiles );
+	if( bPreprocessed )
+	{
+		uint64_t keyInputs[] =
+		{
+			Cache::ComputeContentHash( preprocessedCode.GetData(), preprocessedCode.GetSize() ),
+			platformIndex,
+			shaderProfileIndex,
+			static_cast< uint64_t >( shaderType ),
+			pPreprocessor->GetCookOptionsHash()
+		};
+		compileKey = Cache::ComputeContentHash( keyInputs, sizeof( keyInputs ) );
+
+		if( LoadCompiledShader( compileKey, rCompiledCodeBuffer ) )
+		{
+			size_t includedFileCount = includedFiles.GetSize();
+			for( size_t fileIndex = 0; fileIndex < includedFileCount; ++fileIndex )
+			{
+				pAssetPreprocessor->AddCookDependency( pVariant, includedFiles[ fileIndex ] );
+			}
+
+			return true;
+		}
+
+		includedFiles.Resize( 0 );
+	}
+
 	bool bCompileResult = pPreprocessor->CompileShader(
 		shaderFilePath,
 		shaderProfileIndex,
@@ -675,7 +864,15 @@ bool ShaderVariantResourceHandler::CompileShader(
 #else
 		, NULL
 #endif
-		);
+		, &includedFiles );
+
+	// Record the included files as inputs of the variant so that it is compiled again once any of them changes.
+	size_t includedFileCount = includedFiles.GetSize();
+	for( size_t fileIndex = 0; fileIndex < includedFileCount; ++fileIndex )
+	{
+		pAssetPreprocessor->AddCookDependency( pVariant, includedFiles[ fileIndex ] );
+	}
+
 	if( !bCompileResult )
 	{
 		rCompiledCodeBuffer.Resize( 0 );
@@ -706,10 +903,210 @@ bool ShaderVariantResourceHandler::CompileShader(
 		}
 #endif  // HELIUM_ENABLE_TRACE
 	}
+	else if( compileKey != 0 )
+	{
+		SaveCompiledShader( compileKey, rCompiledCodeBuffer );
+	}
 
 	return bCompileResult;
 }
 
+/// Get the path of the file holding the compiled code of a shader permutation.
+///
+/// @param[in]  compileKey  Hash of the permutation's preprocessed source and target.
+/// @param[out] rPath       Compiled shader file path.
+///
+/// @return  True if the path was determined, false if the compiled shader directory could not be created.
+bool ShaderVariantResourceHandler::GetCompiledShaderFilePath( uint64_t compileKey, FilePath& rPath ) const
+{
+	FilePath directory( m_compiledShaderDirectory );
+	if( directory.Get().empty() )
+	{
+		FilePath userDirectory;
+		if( !FileLocations::GetUserDirectory( userDirectory ) )
+		{
+			return false;
+		}
+
+		directory = FilePath( userDirectory.Get() + "ShaderCache" );
+	}
+
+	// Another thread (or machine) may create the directory at the same time, so only fail if it still does not exist.
+	if( !directory.Exists() && !directory.MakePath() && !directory.Exists() )
+	{
+		return false;
+	}
+
+	String fileName;
+	fileName.Format( "%016" PRIx64 ".shader", compileKey );
+
+	rPath = FilePath( directory.Get() + "/" + fileName.GetData() );
+
+	return true;
+}
+
+/// Load previously compiled code of a shader permutation.
+///
+/// Files are validated against the hash of their contents, so partially written files (such as those of a process
+/// that was interrupted, or of another machine still writing to a shared directory) are ignored.
+///
+/// @param[in]  compileKey           Hash of the permutation's preprocessed source and target.
+/// @param[out] rCompiledCodeBuffer  Compiled code.
+///
+/// @return  True if the compiled code was loaded, false if it was not found.
+bool ShaderVariantResourceHandler::LoadCompiledShader(
+	uint64_t compileKey,
+	DynamicArray< uint8_t >& rCompiledCodeBuffer ) const
+{
+	rCompiledCodeBuffer.Resize( 0 );
+
+	FilePath filePath;
+	if( !GetCompiledShaderFilePath( compileKey, filePath ) || !filePath.Exists() )
+	{
+		return false;
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( filePath.Data(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		return false;
+	}
+
+	CompiledShaderFileHeader header;
+	bool bLoaded =
+		pFileStream->Read( &header, sizeof( header ), 1 ) == 1 &&
+		header.version == COMPILED_SHADER_FILE_VERSION &&
+		header.compileKey == compileKey;
+	if( bLoaded )
+	{
+		rCompiledCodeBuffer.Resize( header.size );
+		bLoaded =
+			pFileStream->Read( rCompiledCodeBuffer.GetData(), 1, header.size ) == header.size &&
+			Cache::ComputeContentHash( rCompiledCodeBuffer.GetData(), rCompiledCodeBuffer.GetSize() ) == header.contentHash;
+	}
+
+	delete pFileStream;
+
+	if( !bLoaded )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"ShaderVariantResourceHandler: Ignoring invalid compiled shader file \"%s\".\n",
+			filePath.Data() );
+
+		rCompiledCodeBuffer.Resize( 0 );
+
+		return false;
+	}
+
+	return true;
+}
+
+/// Save the compiled code of a shader permutation for reuse.
+///
+/// @param[in] compileKey           Hash of the permutation's preprocessed source and target.
+/// @param[in] rCompiledCodeBuffer  Compiled code.
+void ShaderVariantResourceHandler::SaveCompiledShader(
+	uint64_t compileKey,
+	const DynamicArray< uint8_t >& rCompiledCodeBuffer ) const
+{
+	if( rCompiledCodeBuffer.GetSize() > UINT32_MAX )
+	{
+		return;
+	}
+
+	FilePath filePath;
+	if( !GetCompiledShaderFilePath( compileKey, filePath ) )
+	{
+		return;
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( filePath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"ShaderVariantResourceHandler: Failed to open compiled shader file \"%s\" for writing.\n",
+			filePath.Data() );
+
+		return;
+	}
+
+	CompiledShaderFileHeader header;
+	header.version = COMPILED_SHADER_FILE_VERSION;
+	header.size = static_cast< uint32_t >( rCompiledCodeBuffer.GetSize() );
+	header.compileKey = compileKey;
+	header.contentHash = Cache::ComputeContentHash( rCompiledCodeBuffer.GetData(), rCompiledCodeBuffer.GetSize() );
+
+	pFileStream->Write( &header, sizeof( header ), 1 );
+	pFileStream->Write( rCompiledCodeBuffer.GetData(), 1, rCompiledCodeBuffer.GetSize() );
+
+	delete pFileStream;
+}
+
+/// JobManager::ParallelFor() callback for compiling each shader permutation.
+///
+/// @param[in] pContext  PermutationCompileContext of the variant being compiled.
+/// @param[in] index     Index of the permutation in the context's compile list.
+void ShaderVariantResourceHandler::CompilePermutationCallback( void* pContext, size_t index )
+{
+	PermutationCompileContext* pCompileContext = static_cast< PermutationCompileContext* >( pContext );
+	HELIUM_ASSERT( pCompileContext );
+	HELIUM_ASSERT( pCompileContext->pHandler );
+
+	PermutationCompile& rCompile = pCompileContext->pCompiles[ index ];
+	rCompile.bCompiled = pCompileContext->pHandler->CompileShader(
+		pCompileContext->pVariant,
+		rCompile.pPreprocessor,
+		rCompile.platformIndex,
+		rCompile.shaderProfileIndex,
+		pCompileContext->shaderType,
+		pCompileContext->pShaderSource,
+		pCompileContext->shaderSourceSize,
+		pCompileContext->pOptionSetTokens[ rCompile.systemOptionSetIndex ],
+		rCompile.compiledCode );
+}
+
+/// Constructor.
+///
+/// @param[in] pHandler  Owning resource handler.
+ShaderVariantResourceHandler::CompileWorker::CompileWorker( ShaderVariantResourceHandler* pHandler )
+: m_pHandler( pHandler )
+{
+	HELIUM_ASSERT( pHandler );
+}
+
+/// Destructor.
+ShaderVariantResourceHandler::CompileWorker::~CompileWorker()
+{
+}
+
+/// Load (and compile if necessary) the resource data of queued shader variants until told to stop.
+void ShaderVariantResourceHandler::CompileWorker::Run()
+{
+	while( m_pHandler->m_compileStopCounter == 0 )
+	{
+		LoadRequest* pRequest = m_pHandler->PopCompileRequest();
+		if( !pRequest )
+		{
+			m_pHandler->m_compileWakeUpSemaphore.Decrement();
+
+			continue;
+		}
+
+		// Requests remain valid until their compiled counter is set, as TryFinishLoadVariant() will not release them
+		// before then.
+		ShaderVariant* pVariant = pRequest->spVariant;
+		HELIUM_ASSERT( pVariant );
+
+		AssetPreprocessor* pAssetPreprocessor = AssetPreprocessor::GetInstance();
+		HELIUM_ASSERT( pAssetPreprocessor );
+		pAssetPreprocessor->LoadResourceData( pVariant->GetPath(), pVariant );
+
+		AtomicExchangeRelease( pRequest->compiledCounter, 1 );
+	}
+}
+
 /// Compute a hash value for a shader variant load request.
 ///
 /// @param[in] pRequest  Load request.
@@ -719,7 +1116,9 @@ size_t ShaderVariantResourceHandler::LoadRequestHash::operator()( const LoadRequ
 {
 	HELIUM_ASSERT( pRequest );
 
-	return ( static_cast< size_t >( pRequest->userOptionIndex ) * RShader::TYPE_MAX + pRequest->shaderType );
+	size_t shaderHash = reinterpret_cast< uintptr_t >( pRequest->pShader ) / sizeof( void* );
+
+	return ( ( shaderHash * 31 + pRequest->userOptionIndex ) * RShader::TYPE_MAX + pRequest->shaderType );
 }
 
 /// Test whether the two given load requests are for the same shader variant.
@@ -735,7 +1134,8 @@ bool ShaderVariantResourceHandler::LoadRequestEquals::operator()(
 	HELIUM_ASSERT( pRequest0 );
 	HELIUM_ASSERT( pRequest1 );
 
-	return ( pRequest0->userOptionIndex == pRequest1->userOptionIndex &&
+	return ( pRequest0->pShader == pRequest1->pShader &&
+		pRequest0->userOptionIndex == pRequest1->userOptionIndex &&
 		pRequest0->shaderType == pRequest1->shaderType );
 }
 
@@ -6,12 +6,25 @@
 
 #include "PcSupport/ResourceHandler.h"
 
+#include "Platform/Locks.h"
+#include "Platform/Semaphore.h"
+#include "Platform/Thread.h"
 #include "Graphics/Shader.h"
 #include "PcSupport/PlatformPreprocessor.h"
 
 namespace Helium
 {
     /// Resource handler for Shader resource types.
+    ///
+    /// Shader variants that are not yet in the resource cache are compiled on a dedicated background thread, so
+    /// requesting a new variant does not stall the calling thread while the shader compiler runs.  Precaching of the
+    /// compiled variant data (which creates renderer resources) is still performed on the thread that polls the load
+    /// through TryFinishLoadVariant().
+    ///
+    /// The permutations of a variant (one per system option set, shader profile, and target platform) are compiled
+    /// concurrently through JobManager::ParallelFor().  Compiled code is also kept in a compiled shader directory,
+    /// keyed by the hash of the preprocessed shader source, so identical permutations are only compiled once across
+    /// shaders, and across machines if the directory is shared.
     class HELIUM_EDITOR_SUPPORT_API ShaderVariantResourceHandler : public ResourceHandler
     {
         HELIUM_DECLARE_ASSET( ShaderVariantResourceHandler, ResourceHandler );
@@ -34,10 +47,38 @@ namespace Helium
             AssetPreprocessor* pAssetPreprocessor, Resource* pResource, const String& rSourceFilePath ) override;
         //@}
 
+        /// @name Compiled Shader Caching
+        //@{
+        void SetCompiledShaderDirectory( const FilePath& rDirectory );
+        inline const FilePath& GetCompiledShaderDirectory() const;
+        //@}
+
     private:
+        /// Shader variant compile thread runnable.
+        class CompileWorker : public Runnable
+        {
+        public:
+            /// @name Construction/Destruction
+            //@{
+            explicit CompileWorker( ShaderVariantResourceHandler* pHandler );
+            virtual ~CompileWorker();
+            //@}
+
+            /// @name Runnable Interface
+            //@{
+            virtual void Run();
+            //@}
+
+        private:
+            /// Owning resource handler.
+            ShaderVariantResourceHandler* m_pHandler;
+        };
+
         /// Shader variant load request.
         struct LoadRequest
         {
+            /// Parent shader resource.
+            Shader* pShader;
             /// Shader type.
             RShader::EType shaderType;
             /// User option index.
@@ -47,6 +88,46 @@ namespace Helium
             ShaderVariantPtr spVariant;
             /// Load request count.
             volatile int32_t requestCount;
+            /// Non-zero once the variant resource data has been compiled or loaded from the cache.
+            volatile int32_t compiledCounter;
+            /// True once precaching of the variant resource data has started.
+            bool bPrecacheStarted;
+        };
+
+        /// Shader permutation to compile.
+        struct PermutationCompile
+        {
+            /// Platform preprocessor with which to compile.
+            PlatformPreprocessor* pPreprocessor;
+            /// Platform index.
+            size_t platformIndex;
+            /// Index of the target shader profile.
+            size_t shaderProfileIndex;
+            /// Index of the system option set.
+            size_t systemOptionSetIndex;
+            /// Compiled code.
+            DynamicArray< uint8_t > compiledCode;
+            /// True if the permutation was compiled successfully.
+            bool bCompiled;
+        };
+
+        /// Context passed to the parallel permutation compile callback.
+        struct PermutationCompileContext
+        {
+            /// Resource handler.
+            ShaderVariantResourceHandler* pHandler;
+            /// Shader variant being compiled.
+            ShaderVariant* pVariant;
+            /// Shader type.
+            RShader::EType shaderType;
+            /// Shader source code.
+            const void* pShaderSource;
+            /// Size of the shader source code, in bytes.
+            size_t shaderSourceSize;
+            /// Preprocessor tokens of each system option set.
+            const DynamicArray< PlatformPreprocessor::ShaderToken >* pOptionSetTokens;
+            /// Permutations to compile.
+            PermutationCompile* pCompiles;
         };
 
         /// Shader variant load request hasher.
@@ -77,12 +158,35 @@ namespace Helium
         /// Load request lookup set.
         LoadRequestSetType m_loadRequestSet;
 
+        /// Load requests waiting for their variant resource data to be compiled.
+        DynamicArray< LoadRequest* > m_compileQueue;
+        /// Lock for synchronizing access to the compile queue.
+        Mutex m_compileQueueLock;
+        /// Semaphore used to wake up the compile thread when requests are queued (or when it should shut down).
+        Semaphore m_compileWakeUpSemaphore;
+
+        /// Compile thread runnable.
+        CompileWorker* m_pCompileWorker;
+        /// Compile thread (created on the first request that needs compiling).
+        RunnableThread* m_pCompileThread;
+        /// Non-zero if the compile thread should stop.
+        volatile int32_t m_compileStopCounter;
+
+        /// Directory in which compiled shader code is kept (empty to use the user data directory).
+        FilePath m_compiledShaderDirectory;
+
         /// @name Shader Variant Load Override Support
         //@{
         size_t BeginLoadVariant( Shader* pShader, RShader::EType shaderType, uint32_t userOptionIndex );
         bool TryFinishLoadVariant( size_t loadId, ShaderVariantPtr& rspVariant );
         //@}
 
+        /// @name Background Compile Support
+        //@{
+        void QueueCompile( LoadRequest* pRequest );
+        LoadRequest* PopCompileRequest();
+        //@}
+
         /// @name Shader Variant Load Override Callbacks
         //@{
         static size_t BeginLoadVariantCallback(
@@ -90,15 +194,23 @@ namespace Helium
         static bool TryFinishLoadVariantCallback( void* pCallbackData, size_t loadId, ShaderVariantPtr& rspVariant );
         //@}
 
-        /// @name Private Static Utility Functions
+        /// @name Private Utility Functions
         //@{
-        static bool CompileShader(
+        bool CompileShader(
             ShaderVariant* pVariant, PlatformPreprocessor* pPreprocessor, size_t platformIndex,
             size_t shaderProfileIndex, RShader::EType shaderType, const void* pShaderSourceData,
             size_t shaderSourceSize, const DynamicArray< PlatformPreprocessor::ShaderToken >& rTokens,
-            DynamicArray< uint8_t >& rCompiledCodeBuffer );
+            DynamicArray< uint8_t >& rCompiledCodeBuffer ) const;
+
+        bool GetCompiledShaderFilePath( uint64_t compileKey, FilePath& rPath ) const;
+        bool LoadCompiledShader( uint64_t compileKey, DynamicArray< uint8_t >& rCompiledCodeBuffer ) const;
+        void SaveCompiledShader( uint64_t compileKey, const DynamicArray< uint8_t >& rCompiledCodeBuffer ) const;
+
+        static void CompilePermutationCallback( void* pContext, size_t index );
         //@}
     };
 }
 
+#include "EditorSupport/ShaderVariantResourceHandler.inl"
+
 #endif  // HELIUM_TOOLS
@@ -0,0 +1,13 @@
+namespace Helium
+{
+    /// Get the directory in which compiled shader code is kept.
+    ///
+    /// @return  Compiled shader directory, or an empty path if the default directory in the user data directory is
+    ///          used.
+    ///
+    /// @see SetCompiledShaderDirectory()
+    const FilePath& ShaderVariantResourceHandler::GetCompiledShaderDirectory() const
+    {
+        return m_compiledShaderDirectory;
+    }
+}
@@ -7,6 +7,9 @@
 #include "Engine/FileLocations.h"
 #include "Foundation/FilePath.h"
 #include "Foundation/FileStream.h"
+#include "Foundation/Numeric.h"
+#include "Platform/Atomic.h"
+#include "EngineJobs/JobManager.h"
 #include "Graphics/Texture2d.h"
 #include "PcSupport/AssetPreprocessor.h"
 #include "PcSupport/PlatformPreprocessor.h"
@@ -22,6 +25,179 @@ HELIUM_IMPLEMENT_ASSET( Helium::Texture2dResourceHandler, EditorSupport, 0 );
 
 using namespace Helium;
 
+/// Number of pixel rows compressed by each texture compression job (a multiple of the compression block height).
+static const uint32_t COMPRESSION_STRIP_ROW_COUNT = 128;
+
+/// Non-zero while a texture is being compressed with CUDA acceleration.
+static volatile int32_t s_cudaCompressorInUse = 0;
+/// Non-zero once CUDA acceleration has been found to be unavailable.
+static volatile int32_t s_cudaUnavailable = 0;
+
+/// Horizontal strip of a mip level compressed by a single job.
+struct TextureCompressionStrip
+{
+    /// First BGRA pixel of the strip.
+    const uint8_t* pPixels;
+    /// Strip width, in pixels.
+    uint32_t width;
+    /// Strip height, in pixels.
+    uint32_t height;
+    /// Index of the mip level containing the strip.
+    uint32_t mipLevel;
+    /// Compressed strip data.
+    MemoryTextureOutputHandler::MipDataArray compressedData;
+    /// True if the strip was compressed successfully.
+    bool bSuccess;
+};
+
+/// Context passed to the parallel texture strip compression callback.
+struct TextureCompressionContext
+{
+    /// Compression options shared by all strips.
+    const nvtt::CompressionOptions* pCompressionOptions;
+    /// True if the texture is a normal map.
+    bool bNormalMap;
+    /// Strips to compress.
+    TextureCompressionStrip* pStrips;
+};
+
+/// JobManager::ParallelFor() callback for compressing each strip of a texture.
+///
+/// @param[in] pContext  TextureCompressionContext of the texture being compressed.
+/// @param[in] index     Index of the strip in the context's strip list.
+static void CompressTextureStripCallback( void* pContext, size_t index )
+{
+    TextureCompressionContext* pCompressionContext = static_cast< TextureCompressionContext* >( pContext );
+    HELIUM_ASSERT( pCompressionContext );
+    HELIUM_ASSERT( pCompressionContext->pCompressionOptions );
+
+    TextureCompressionStrip& rStrip = pCompressionContext->pStrips[ index ];
+
+    // The strip pixels are already in their final color space, so compress them as they are.
+    nvtt::InputOptions inputOptions;
+    inputOptions.setTextureLayout( nvtt::TextureType_2D, rStrip.width, rStrip.height );
+    inputOptions.setMipmapData( rStrip.pPixels, rStrip.width, rStrip.height );
+    inputOptions.setMipmapGeneration( false );
+    inputOptions.setGamma( 1.0f, 1.0f );
+    inputOptions.setNormalMap( pCompressionContext->bNormalMap );
+
+    MemoryTextureOutputHandler outputHandler( rStrip.width, rStrip.height, false, false );
+
+    nvtt::OutputOptions outputOptions;
+    outputOptions.setOutputHandler( &outputHandler );
+    outputOptions.setOutputHeader( false );
+
+    nvtt::Compressor compressor;
+    rStrip.bSuccess = compressor.process( inputOptions, *pCompressionContext->pCompressionOptions, outputOptions );
+    if( rStrip.bSuccess )
+    {
+        rStrip.compressedData = outputHandler.GetFace( 0 )[ 0 ];
+    }
+}
+
+/// Compress a texture on the CPU, splitting each mip level into strips of block rows compressed by separate jobs.
+///
+/// Mip levels are generated first in a single uncompressed pass, as filtering is cheap compared to block compression.
+/// Strips are then compressed through JobManager::ParallelFor(), and their compressed data concatenated in order
+/// (which matches the layout of the whole level, since block rows are stored one after the other).
+///
+/// @param[in]  rInputOptions        Input options of the whole texture (including mip generation settings).
+/// @param[in]  rCompressionOptions  Compression options.
+/// @param[in]  pPixels              BGRA pixel data of the top mip level.
+/// @param[in]  width                Top mip level width, in pixels.
+/// @param[in]  height               Top mip level height, in pixels.
+/// @param[in]  bMipmaps             True to compress a full mip chain, false to only compress the top level.
+/// @param[in]  bNormalMap           True if the texture is a normal map.
+/// @param[out] rMipLevels           Compressed data of each mip level.
+///
+/// @return  True if compression was successful, false if not.
+static bool CompressTextureInStrips(
+    const nvtt::InputOptions& rInputOptions,
+    const nvtt::CompressionOptions& rCompressionOptions,
+    const uint8_t* pPixels,
+    uint32_t width,
+    uint32_t height,
+    bool bMipmaps,
+    bool bNormalMap,
+    MemoryTextureOutputHandler::MipLevelArray& rMipLevels )
+{
+    HELIUM_ASSERT( pPixels );
+
+    rMipLevels.Resize( 0 );
+
+    // Generate the lower mip levels as uncompressed BGRA data.
+    MemoryTextureOutputHandler mipOutputHandler( width, height, false, bMipmaps );
+    if( bMipmaps )
+    {
+        nvtt::CompressionOptions mipCompressionOptions;
+        mipCompressionOptions.setFormat( nvtt::Format_RGBA );
+#if HELIUM_ENDIAN_LITTLE
+        mipCompressionOptions.setPixelFormat( 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+#else
+        mipCompressionOptions.setPixelFormat( 32, 0x0000ff00, 0x00ff0000, 0xff000000, 0x000000ff );
+#endif
+
+        nvtt::OutputOptions mipOutputOptions;
+        mipOutputOptions.setOutputHandler( &mipOutputHandler );
+        mipOutputOptions.setOutputHeader( false );
+
+        nvtt::Compressor mipCompressor;
+        if( !mipCompressor.process( rInputOptions, mipCompressionOptions, mipOutputOptions ) )
+        {
+            return false;
+        }
+    }
+
+    const MemoryTextureOutputHandler::MipLevelArray& rMipPixels = mipOutputHandler.GetFace( 0 );
+    uint32_t mipLevelCount = static_cast< uint32_t >( rMipPixels.GetSize() );
+    HELIUM_ASSERT( mipLevelCount != 0 );
+
+    // Split each level into strips.  The top level is compressed from the source pixels directly.
+    DynamicArray< TextureCompressionStrip > strips;
+    for( uint32_t mipLevel = 0; mipLevel < mipLevelCount; ++mipLevel )
+    {
+        uint32_t levelWidth = Max< uint32_t >( width >> mipLevel, 1 );
+        uint32_t levelHeight = Max< uint32_t >( height >> mipLevel, 1 );
+        const uint8_t* pLevelPixels = ( mipLevel == 0 ? pPixels : rMipPixels[ mipLevel ].GetData() );
+        HELIUM_ASSERT( mipLevel == 0 || rMipPixels[ mipLevel ].GetSize() >= levelWidth * levelHeight * 4 );
+
+        for( uint32_t row = 0; row < levelHeight; row += COMPRESSION_STRIP_ROW_COUNT )
+        {
+            TextureCompressionStrip* pStrip = strips.New();
+            HELIUM_ASSERT( pStrip );
+            pStrip->pPixels = pLevelPixels + static_cast< size_t >( row ) * levelWidth * 4;
+            pStrip->width = levelWidth;
+            pStrip->height = Min( COMPRESSION_STRIP_ROW_COUNT, levelHeight - row );
+            pStrip->mipLevel = mipLevel;
+            pStrip->bSuccess = false;
+        }
+    }
+
+    TextureCompressionContext context;
+    context.pCompressionOptions = &rCompressionOptions;
+    context.bNormalMap = bNormalMap;
+    context.pStrips = strips.GetData();
+    JobManager::ParallelFor( CompressTextureStripCallback, &context, strips.GetSize() );
+
+    rMipLevels.Resize( mipLevelCount );
+
+    size_t stripCount = strips.GetSize();
+    for( size_t stripIndex = 0; stripIndex < stripCount; ++stripIndex )
+    {
+        const TextureCompressionStrip& rStrip = strips[ stripIndex ];
+        if( !rStrip.bSuccess )
+        {
+            rMipLevels.Resize( 0 );
+
+            return false;
+        }
+
+        rMipLevels[ rStrip.mipLevel ].AddArray( rStrip.compressedData.GetData(), rStrip.compressedData.GetSize() );
+    }
+
+    return true;
+}
+
 /// Constructor.
 Texture2dResourceHandler::Texture2dResourceHandler()
 {
@@ -175,7 +351,8 @@ bool Texture2dResourceHandler::CacheResource(
     inputOptions.setTextureLayout( nvtt::TextureType_2D, imageWidth, imageHeight );
     inputOptions.setMipmapData( pImagePixelData, imageWidth, imageHeight );
     inputOptions.setMipmapGeneration( bCreateMipmaps );
-    inputOptions.setMipmapFilter( nvtt::MipmapFilter_Box );
+    inputOptions.setMipmapFilter( nvtt::MipmapFilter_Kaiser );
+    inputOptions.setKaiserParameters( 3.0f, 4.0f, 1.0f );
     inputOptions.setWrapMode( nvtt::WrapMode_Repeat );
 
     float gamma = ( bSrgb ? 2.2f : 1.0f );
@@ -184,13 +361,6 @@ bool Texture2dResourceHandler::CacheResource(
     inputOptions.setNormalMap( bIsNormalMap );
     inputOptions.setNormalizeMipmaps( bIsNormalMap );
 
-    // Set up the output options for the texture compressor.
-    MemoryTextureOutputHandler outputHandler( imageWidth, imageHeight, false, bCreateMipmaps );
-
-    nvtt::OutputOptions outputOptions;
-    outputOptions.setOutputHandler( &outputHandler );
-    outputOptions.setOutputHeader( false );
-
     // Set up the compression options for the texture compressor.
     nvtt::CompressionOptions compressionOptions;
 
@@ -268,6 +438,24 @@ bool Texture2dResourceHandler::CacheResource(
             break;
         }
 
+    case Texture::ECompression::COLOR_HIGH_QUALITY:
+        {
+            outputFormat = nvtt::Format_BC7;
+            pixelFormat = ( bSrgb ? RENDERER_PIXEL_FORMAT_BC7_SRGB : RENDERER_PIXEL_FORMAT_BC7 );
+
+            break;
+        }
+
+    case Texture::ECompression::NORMAL_MAP_HIGH_QUALITY:
+        {
+            // X and Y are stored in the red and green channels, which UnpackNormalMapSample() reads as-is since
+            // alpha samples as one.
+            outputFormat = nvtt::Format_BC5;
+            pixelFormat = RENDERER_PIXEL_FORMAT_BC5;
+
+            break;
+        }
+
     default:
         break;
     }
@@ -275,9 +463,50 @@ bool Texture2dResourceHandler::CacheResource(
     compressionOptions.setFormat( outputFormat );
     compressionOptions.setQuality( nvtt::Quality_Normal );
 
-    // Compress the texture.
-    nvtt::Compressor compressor;
-    bool bCompressSuccess = compressor.process( inputOptions, compressionOptions, outputOptions );
+    // Compress the texture, on the GPU if CUDA acceleration is available and no other texture is using it, or on the
+    // CPU through the job manager otherwise.
+    MemoryTextureOutputHandler::MipLevelArray mipLevels;
+    bool bCompressSuccess = false;
+    bool bCompressed = false;
+
+    if( s_cudaUnavailable == 0 && AtomicExchangeAcquire( s_cudaCompressorInUse, 1 ) == 0 )
+    {
+        nvtt::Compressor compressor;
+        compressor.enableCudaAcceleration( true );
+        if( compressor.isCudaAccelerationEnabled() )
+        {
+            MemoryTextureOutputHandler outputHandler( imageWidth, imageHeight, false, bCreateMipmaps );
+
+            nvtt::OutputOptions outputOptions;
+            outputOptions.setOutputHandler( &outputHandler );
+            outputOptions.setOutputHeader( false );
+
+            bCompressSuccess = compressor.process( inputOptions, compressionOptions, outputOptions );
+            bCompressed = true;
+
+            mipLevels = outputHandler.GetFace( 0 );
+        }
+        else
+        {
+            AtomicExchangeRelease( s_cudaUnavailable, 1 );
+        }
+
+        AtomicExchangeRelease( s_cudaCompressorInUse, 0 );
+    }
+
+    if( !bCompressed )
+    {
+        bCompressSuccess = CompressTextureInStrips(
+            inputOptions,
+            compressionOptions,
+            static_cast< const uint8_t* >( pImagePixelData ),
+            imageWidth,
+            imageHeight,
+            bCreateMipmaps,
+            bIsNormalMap,
+            mipLevels );
+    }
+
     HELIUM_ASSERT( bCompressSuccess );
     if( !bCompressSuccess )
     {
@@ -290,7 +519,7 @@ bool Texture2dResourceHandler::CacheResource(
     }
 
     // Cache the data for each supported platform.
-    const MemoryTextureOutputHandler::MipLevelArray& rMipLevels = outputHandler.GetFace( 0 );
+    const MemoryTextureOutputHandler::MipLevelArray& rMipLevels = mipLevels;
     uint32_t mipLevelCount = static_cast< uint32_t >( rMipLevels.GetSize() );
     HELIUM_ASSERT( mipLevelCount != 0 );
 
@@ -325,4 +554,11 @@ bool Texture2dResourceHandler::CacheResource(
     return true;
 }
 
+/// @copydoc ResourceHandler::CanCacheConcurrently()
+bool Texture2dResourceHandler::CanCacheConcurrently() const
+{
+    // Image loading and compression only use state local to each call.
+    return true;
+}
+
 #endif  // HELIUM_TOOLS
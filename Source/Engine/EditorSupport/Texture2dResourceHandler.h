@@ -28,6 +28,7 @@ namespace Helium
 
         virtual bool CacheResource(
             AssetPreprocessor* pAssetPreprocessor, Resource* pResource, const String& rSourceFilePath ) override;
+        virtual bool CanCacheConcurrently() const override;
         //@}
     };
 }
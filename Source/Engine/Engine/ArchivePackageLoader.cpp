@@ -0,0 +1,862 @@
+#include "Precompile.h"
+#include "Engine/ArchivePackageLoader.h"
+
+#include "Foundation/MemoryStream.h"
+#include "Platform/Timer.h"
+#include "Engine/AssetLoader.h"
+#include "Engine/AssetLoadTrace.h"
+#include "Engine/AsyncLoader.h"
+#include "Engine/CacheManager.h"
+#include "Engine/Resource.h"
+#include "Persist/ArchiveJson.h"
+
+using namespace Helium;
+
+/// Constructor.
+ArchivePackageLoader::ArchivePackageLoader()
+	: m_startPreloadCounter( 0 )
+	, m_preloadedCounter( 0 )
+	, m_loadRequestPool( LOAD_REQUEST_POOL_BLOCK_SIZE )
+	, m_parentPackageLoadId( Invalid< size_t >() )
+{
+}
+
+/// Destructor.
+ArchivePackageLoader::~ArchivePackageLoader()
+{
+	Cleanup();
+}
+
+/// Initialize this package loader.
+///
+/// @param[in] packagePath       Asset path of the package to load.
+/// @param[in] rArchiveFilePath  Path of the archive holding the package's objects.
+///
+/// @return  True if this loader was initialized successfully, false if not.
+///
+/// @see Cleanup()
+bool ArchivePackageLoader::Initialize( AssetPath packagePath, const FilePath& rArchiveFilePath )
+{
+	Cleanup();
+
+	if ( packagePath.IsEmpty() || !packagePath.IsPackage() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"ArchivePackageLoader::Initialize(): \"%s\" does not represent a package path.\n",
+			*packagePath.ToString() );
+
+		return false;
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Debug,
+		"ArchivePackageLoader::Initialize(): Initializing loader for package \"%s\" from archive \"%s\".\n",
+		*packagePath.ToString(),
+		rArchiveFilePath.Data() );
+
+	// Attempt to locate the specified package if it already happens to exist.
+	m_spPackage = Asset::Find< Package >( packagePath );
+	Package* pPackage = m_spPackage;
+	if ( pPackage )
+	{
+		if ( pPackage->GetLoader() )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"ArchivePackageLoader::Initialize(): Package \"%s\" already has a loader.\n",
+				*packagePath.ToString() );
+
+			m_spPackage.Release();
+
+			return false;
+		}
+	}
+	else
+	{
+		// Make sure we don't have a name clash with a non-package object.
+		AssetPtr spObject( Asset::FindObject( packagePath ) );
+		if ( spObject )
+		{
+			HELIUM_ASSERT( !spObject->IsPackage() );
+
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"ArchivePackageLoader::Initialize(): Package loader cannot be initialized for \"%s\", as an object with the same name exists that is not a package.\n",
+				*packagePath.ToString() );
+
+			return false;
+		}
+	}
+
+	if ( !m_archive.Open( rArchiveFilePath ) )
+	{
+		m_spPackage.Release();
+
+		return false;
+	}
+
+	size_t objectCount = m_archive.GetObjectCount();
+	m_objectPaths.Reserve( objectCount );
+	for ( size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex )
+	{
+		AssetPath* pObjectPath = m_objectPaths.New();
+		HELIUM_ASSERT( pObjectPath );
+		HELIUM_VERIFY( pObjectPath->Set( m_archive.GetObject( objectIndex ).name, false, packagePath ) );
+	}
+
+	m_packagePath = packagePath;
+
+	if ( pPackage )
+	{
+		pPackage->SetLoader( this );
+	}
+
+	return true;
+}
+
+/// Release the archive and any pending load requests.
+///
+/// @see Initialize()
+void ArchivePackageLoader::Cleanup()
+{
+	// Sync with any in-flight async load requests.
+	if ( m_startPreloadCounter )
+	{
+		while ( !TryFinishPreload() )
+		{
+			Tick();
+		}
+	}
+
+	HELIUM_ASSERT( IsInvalid( m_parentPackageLoadId ) );
+
+	// Unset the reference back to this loader in the package.
+	Package* pPackage = m_spPackage;
+	if ( pPackage )
+	{
+		pPackage->SetLoader( NULL );
+	}
+
+	m_spPackage.Release();
+	m_packagePath.Clear();
+
+	AtomicExchangeRelease( m_startPreloadCounter, 0 );
+	AtomicExchangeRelease( m_preloadedCounter, 0 );
+
+	size_t loadRequestCount = m_loadRequests.GetSize();
+	for ( size_t requestIndex = 0; requestIndex < loadRequestCount; ++requestIndex )
+	{
+		if ( m_loadRequests.IsElementValid( requestIndex ) )
+		{
+			LoadRequest* pRequest = m_loadRequests[ requestIndex ];
+			HELIUM_ASSERT( pRequest );
+			DefaultAllocator().Free( pRequest->pCachedObjectDataBuffer );
+			m_loadRequestPool.Release( pRequest );
+		}
+	}
+
+	m_loadRequests.Clear();
+
+	m_objectPaths.Clear();
+	m_archive.Close();
+}
+
+/// Begin asynchronous pre-loading of package information.
+///
+/// The archive index was read when the loader was initialized, so this only needs to wait for the parent package.
+///
+/// @see TryFinishPreload()
+bool ArchivePackageLoader::BeginPreload()
+{
+	HELIUM_ASSERT( !m_startPreloadCounter );
+	HELIUM_ASSERT( !m_preloadedCounter );
+	HELIUM_ASSERT( IsInvalid( m_parentPackageLoadId ) );
+
+	// Load the parent package if we need to create the current package.
+	if ( !m_spPackage )
+	{
+		AssetPath parentPackagePath = m_packagePath.GetParent();
+		if ( !parentPackagePath.IsEmpty() )
+		{
+			AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+			HELIUM_ASSERT( pAssetLoader );
+
+			m_parentPackageLoadId = pAssetLoader->BeginLoadObject( parentPackagePath );
+			HELIUM_ASSERT( IsValid( m_parentPackageLoadId ) );
+		}
+	}
+
+	AtomicExchangeRelease( m_startPreloadCounter, 1 );
+
+	return true;
+}
+
+/// @copydoc PackageLoader::TryFinishPreload()
+bool ArchivePackageLoader::TryFinishPreload()
+{
+	return ( m_preloadedCounter != 0 );
+}
+
+/// @copydoc PackageLoader::BeginLoadObject()
+size_t ArchivePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResolver *pResolver, bool forceReload )
+{
+	HELIUM_TRACE(
+		TraceLevels::Debug,
+		"ArchivePackageLoader::BeginLoadObject: Beginning load for path \"%s\".\n",
+		*path.ToString() );
+
+	// Make sure preloading has completed.
+	HELIUM_ASSERT( m_preloadedCounter != 0 );
+	if ( !m_preloadedCounter )
+	{
+		return Invalid< size_t >();
+	}
+
+	LoadRequest* pRequest = NULL;
+
+	// If this package is requested, simply provide the (already loaded) package instance.
+	if ( path == m_packagePath )
+	{
+		pRequest = m_loadRequestPool.Allocate();
+		HELIUM_ASSERT( pRequest );
+
+		HELIUM_ASSERT( m_spPackage );
+		pRequest->spObject = m_spPackage.Ptr();
+
+		SetInvalid( pRequest->index );
+		SetInvalid( pRequest->templateLoadId );
+		SetInvalid( pRequest->ownerLoadId );
+		SetInvalid( pRequest->persistentResourceDataLoadId );
+		pRequest->pCachedObjectDataBuffer = NULL;
+		pRequest->cachedObjectDataBufferSize = 0;
+		pRequest->pResolver = NULL;
+		pRequest->forceReload = forceReload;
+
+		pRequest->flags = LOAD_FLAG_PRELOADED;
+
+		return m_loadRequests.Add( pRequest );
+	}
+
+	size_t objectIndex = Invalid< size_t >();
+	if ( path.GetParent() == m_packagePath )
+	{
+		objectIndex = m_archive.FindObject( path.GetName() );
+	}
+
+	if ( IsInvalid( objectIndex ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"ArchivePackageLoader::BeginLoadObject(): Failed to locate \"%s\" for loading in the package archive.\n",
+			*path.ToString() );
+
+		return Invalid< size_t >();
+	}
+
+	const PackageArchive::Object& rArchiveObject = m_archive.GetObject( objectIndex );
+
+	// Locate the type object.
+	AssetType* pType = AssetType::Find( rArchiveObject.typeName );
+	if ( !pType )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"ArchivePackageLoader::BeginLoadObject(): Failed to locate type \"%s\" for loading object \"%s\".\n",
+			*rArchiveObject.typeName,
+			*path.ToString() );
+
+		return Invalid< size_t >();
+	}
+
+	pRequest = m_loadRequestPool.Allocate();
+	HELIUM_ASSERT( pRequest );
+	HELIUM_ASSERT( !pRequest->spObject );
+	pRequest->index = objectIndex;
+	pRequest->spType = pType;
+	HELIUM_ASSERT( !pRequest->spTemplate );
+	HELIUM_ASSERT( !pRequest->spOwner );
+	SetInvalid( pRequest->templateLoadId );
+	SetInvalid( pRequest->ownerLoadId );
+	SetInvalid( pRequest->persistentResourceDataLoadId );
+	pRequest->pCachedObjectDataBuffer = NULL;
+	pRequest->cachedObjectDataBufferSize = 0;
+	pRequest->pResolver = pResolver;
+	pRequest->forceReload = forceReload;
+
+	pRequest->flags = 0;
+
+	// If a fully-loaded object already exists with the same name, do not attempt to re-load the object (just mark
+	// the request as complete).
+	if ( !forceReload )
+	{
+		pRequest->spObject = Asset::FindObject( path );
+	}
+
+	Asset* pObject = pRequest->spObject;
+	if ( pObject && pObject->IsFullyLoaded() )
+	{
+		pRequest->flags = LOAD_FLAG_PRELOADED;
+	}
+	else
+	{
+		HELIUM_ASSERT( !pObject || !pObject->GetAnyFlagSet( Asset::FLAG_LOADED | Asset::FLAG_LINKED ) );
+
+		// Start paging in the object data while its template loads, so deserializing it does not stall on the disk.
+		m_archive.PrefetchObjectData( objectIndex );
+
+		// Begin loading the template object.  Objects in an archive are always owned by the package itself, which is
+		// already loaded.
+		AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+		HELIUM_ASSERT( pAssetLoader );
+
+		AssetPath templatePath;
+		if ( rArchiveObject.templatePath.IsEmpty() || !templatePath.Set( rArchiveObject.templatePath ) )
+		{
+			Asset* pTemplate = pType->GetTemplate();
+			if ( pTemplate->IsFullyLoaded() )
+			{
+				pRequest->spTemplate = pTemplate;
+			}
+			else
+			{
+				pRequest->templateLoadId = pAssetLoader->BeginLoadObject( pTemplate->GetPath() );
+			}
+		}
+		else
+		{
+			pRequest->templateLoadId = pAssetLoader->BeginLoadObject( templatePath );
+		}
+
+		pRequest->spOwner = m_spPackage.Ptr();
+	}
+
+	return m_loadRequests.Add( pRequest );
+}
+
+/// @copydoc PackageLoader::TryFinishLoadObject()
+bool ArchivePackageLoader::TryFinishLoadObject( size_t requestId, AssetPtr& rspObject )
+{
+	HELIUM_ASSERT( requestId < m_loadRequests.GetSize() );
+	HELIUM_ASSERT( m_loadRequests.IsElementValid( requestId ) );
+
+	LoadRequest* pRequest = m_loadRequests[ requestId ];
+	HELIUM_ASSERT( pRequest );
+	if ( ( pRequest->flags & LOAD_FLAG_PRELOADED ) != LOAD_FLAG_PRELOADED )
+	{
+		return false;
+	}
+
+	HELIUM_ASSERT( !IsValid( pRequest->templateLoadId ) );
+	HELIUM_ASSERT( !IsValid( pRequest->ownerLoadId ) );
+	HELIUM_ASSERT( !IsValid( pRequest->persistentResourceDataLoadId ) );
+
+	DefaultAllocator().Free( pRequest->pCachedObjectDataBuffer );
+	pRequest->pCachedObjectDataBuffer = NULL;
+	pRequest->cachedObjectDataBufferSize = 0;
+
+	rspObject = pRequest->spObject;
+	Asset* pObject = rspObject;
+	if ( pObject && ( pRequest->flags & LOAD_FLAG_ERROR ) )
+	{
+		pObject->SetFlags( Asset::FLAG_BROKEN );
+	}
+
+	pRequest->pResolver = NULL;
+	pRequest->spObject.Release();
+	pRequest->spType.Release();
+	pRequest->spTemplate.Release();
+	pRequest->spOwner.Release();
+
+	m_loadRequests.Remove( requestId );
+	m_loadRequestPool.Release( pRequest );
+
+	return true;
+}
+
+/// @copydoc PackageLoader::Tick()
+void ArchivePackageLoader::Tick()
+{
+	MutexScopeLock scopeLock( m_accessLock );
+
+	// Do nothing until pre-loading has been started.
+	if ( !m_startPreloadCounter )
+	{
+		return;
+	}
+
+	if ( !m_preloadedCounter )
+	{
+		TickPreload();
+	}
+	else
+	{
+		TickLoadRequests();
+	}
+}
+
+/// @copydoc PackageLoader::GetObjectCount()
+size_t ArchivePackageLoader::GetObjectCount() const
+{
+	return m_objectPaths.GetSize();
+}
+
+/// @copydoc PackageLoader::GetAssetPath()
+AssetPath ArchivePackageLoader::GetAssetPath( size_t index ) const
+{
+	HELIUM_ASSERT( index < m_objectPaths.GetSize() );
+
+	return m_objectPaths[ index ];
+}
+
+/// Get the package managed by this loader.
+///
+/// @return  Associated package.
+///
+/// @see GetPackagePath()
+Package* ArchivePackageLoader::GetPackage() const
+{
+	return m_spPackage;
+}
+
+/// Get the object path for the package managed by this loader.
+///
+/// @return  Path of the associated package.
+///
+/// @see GetPackage()
+AssetPath ArchivePackageLoader::GetPackagePath() const
+{
+	return m_packagePath;
+}
+
+#if HELIUM_TOOLS
+
+/// @copydoc PackageLoader::GetAssetTypeName()
+Name ArchivePackageLoader::GetAssetTypeName( const AssetPath &path ) const
+{
+	size_t objectIndex = m_archive.FindObject( path.GetRootName() );
+	if ( IsValid( objectIndex ) )
+	{
+		return m_archive.GetObject( objectIndex ).typeName;
+	}
+
+	return Name( NULL_NAME );
+}
+
+/// @copydoc PackageLoader::EnumerateChildren()
+void ArchivePackageLoader::EnumerateChildren( DynamicArray< AssetPath > &children ) const
+{
+	children.AddArray( m_objectPaths.GetData(), m_objectPaths.GetSize() );
+}
+
+#endif
+
+/// Update during the package preload process.
+void ArchivePackageLoader::TickPreload()
+{
+	HELIUM_ASSERT( m_startPreloadCounter != 0 );
+	HELIUM_ASSERT( m_preloadedCounter == 0 );
+
+	// Wait for the parent package to finish loading.
+	AssetPtr spParentPackage;
+	if ( IsValid( m_parentPackageLoadId ) )
+	{
+		AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+		HELIUM_ASSERT( pAssetLoader );
+		if ( !pAssetLoader->TryFinishLoad( m_parentPackageLoadId, spParentPackage ) )
+		{
+			return;
+		}
+
+		SetInvalid( m_parentPackageLoadId );
+
+		// Package loading should not fail.  If it does, this is a sign of a potentially serious issue.
+		HELIUM_ASSERT( spParentPackage );
+	}
+
+	// Create the package object if it does not yet exist.
+	Package* pPackage = m_spPackage;
+	if ( !pPackage )
+	{
+		HELIUM_ASSERT( spParentPackage ? !m_packagePath.GetParent().IsEmpty() : m_packagePath.GetParent().IsEmpty() );
+		HELIUM_VERIFY( Asset::Create< Package >( m_spPackage, m_packagePath.GetName(), spParentPackage ) );
+		pPackage = m_spPackage;
+		HELIUM_ASSERT( pPackage );
+		pPackage->SetLoader( this );
+	}
+
+	HELIUM_ASSERT( pPackage->GetLoader() == this );
+
+	// Package preloading is now complete.
+	pPackage->SetFlags( Asset::FLAG_PRELOADED | Asset::FLAG_LINKED );
+	pPackage->ConditionalFinalizeLoad();
+
+	AtomicExchangeRelease( m_preloadedCounter, 1 );
+}
+
+/// Update load processing of object load requests.
+void ArchivePackageLoader::TickLoadRequests()
+{
+	size_t loadRequestCount = m_loadRequests.GetSize();
+	for ( size_t loadRequestIndex = 0; loadRequestIndex < loadRequestCount; ++loadRequestIndex )
+	{
+		if ( !m_loadRequests.IsElementValid( loadRequestIndex ) )
+		{
+			continue;
+		}
+
+		LoadRequest* pRequest = m_loadRequests[ loadRequestIndex ];
+		HELIUM_ASSERT( pRequest );
+
+		if ( !( pRequest->flags & LOAD_FLAG_PROPERTY_PRELOADED ) )
+		{
+			if ( !TickDeserialize( pRequest ) )
+			{
+				continue;
+			}
+		}
+
+		if ( !( pRequest->flags & LOAD_FLAG_PERSISTENT_RESOURCE_PRELOADED ) )
+		{
+			TickPersistentResourcePreload( pRequest );
+		}
+	}
+
+	// Read the properties of every object whose template is ready, then finish them here on the ticking thread.
+	if ( !m_deserializeRequests.IsEmpty() )
+	{
+		m_deserializeFailures.Resize( 0 );
+		m_deserializeFailures.Add( false, m_deserializeRequests.GetSize() );
+
+		AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+		HELIUM_ASSERT( pAssetLoader );
+		pAssetLoader->RunParallel( DeserializeCallback, this, m_deserializeRequests.GetSize() );
+
+		for ( size_t deserializeIndex = 0; deserializeIndex < m_deserializeRequests.GetSize(); ++deserializeIndex )
+		{
+			FinishDeserialize( m_deserializeRequests[ deserializeIndex ], m_deserializeFailures[ deserializeIndex ] );
+		}
+
+		m_deserializeRequests.Resize( 0 );
+	}
+}
+
+/// Update processing of object property preloading for a given load request.
+///
+/// @param[in] pRequest  Load request to process.
+///
+/// @return  True if object property preloading for the given load request has completed, false if not.
+bool ArchivePackageLoader::TickDeserialize( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+	HELIUM_ASSERT( !( pRequest->flags & LOAD_FLAG_PROPERTY_PRELOADED ) );
+	HELIUM_ASSERT( pRequest->index < m_objectPaths.GetSize() );
+
+	const AssetPath& rObjectPath = m_objectPaths[ pRequest->index ];
+	Asset* pObject = pRequest->spObject;
+
+	// Wait for the template object to load.
+	if ( IsValid( pRequest->templateLoadId ) )
+	{
+		AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+		HELIUM_ASSERT( pAssetLoader );
+		if ( !pAssetLoader->TryFinishLoad( pRequest->templateLoadId, pRequest->spTemplate ) )
+		{
+			return false;
+		}
+
+		SetInvalid( pRequest->templateLoadId );
+	}
+
+	Asset* pTemplate = pRequest->spTemplate;
+	if ( !pTemplate )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"ArchivePackageLoader: Failed to load template object for \"%s\".\n",
+			*rObjectPath.ToString() );
+
+		if ( pObject )
+		{
+			pObject->SetFlags( Asset::FLAG_PRELOADED | Asset::FLAG_LINKED );
+			pObject->ConditionalFinalizeLoad();
+		}
+
+		pRequest->flags |= LOAD_FLAG_PRELOADED | LOAD_FLAG_ERROR;
+
+		return true;
+	}
+
+	Asset* pOwner = pRequest->spOwner;
+	AssetType* pType = pRequest->spType;
+	HELIUM_ASSERT( pOwner );
+	HELIUM_ASSERT( pType );
+	HELIUM_ASSERT( pTemplate->IsFullyLoaded() );
+
+	bool bObjectCreationFailure = false;
+
+	// If we already had an existing object, make sure the type matches.
+	if ( pObject )
+	{
+		const AssetType* pExistingType = pObject->GetAssetType();
+		HELIUM_ASSERT( pExistingType );
+		if ( pExistingType != pType )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"ArchivePackageLoader: Cannot load \"%s\" using the existing object as the types do not match (existing type: \"%s\"; serialized type: \"%s\".\n",
+				*rObjectPath.ToString(),
+				*pExistingType->GetName(),
+				*pType->GetName() );
+
+			pObject->SetFlags( Asset::FLAG_PRELOADED | Asset::FLAG_LINKED );
+			pObject->ConditionalFinalizeLoad();
+
+			bObjectCreationFailure = true;
+		}
+	}
+	else
+	{
+		bool bCreateResult = Asset::CreateObject(
+			pRequest->spObject,
+			pType,
+			pRequest->forceReload ? Name( NULL_NAME ) : rObjectPath.GetName(),
+			pRequest->forceReload ? NULL : pOwner,
+			pTemplate );
+		if ( !bCreateResult )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"ArchivePackageLoader: Failed to create \"%s\" during loading.\n",
+				*rObjectPath.ToString() );
+
+			bObjectCreationFailure = true;
+		}
+
+		pObject = pRequest->spObject;
+		HELIUM_ASSERT( pObject );
+	}
+
+	if ( !bObjectCreationFailure )
+	{
+		// Properties are read in parallel with those of the other objects ready this tick, after which
+		// FinishDeserialize() completes the request.
+		m_deserializeRequests.Push( pRequest );
+
+		return false;
+	}
+
+	FinishDeserialize( pRequest, true );
+
+	return true;
+}
+
+/// Read the properties of the object for a load request from the archive.
+///
+/// This runs through AssetLoader::RunParallel(), so it may run concurrently for different load requests.  Load
+/// requests begun by resolving object references are queued by the asset loader until its next tick.
+///
+/// @param[in] pRequest  Load request, for which the object has been created.
+///
+/// @return  True if the object data was read, false if it could not be decompressed.
+bool ArchivePackageLoader::DeserializeProperties( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+	HELIUM_ASSERT( pRequest->spObject );
+
+	const AssetPath& rObjectPath = m_objectPaths[ pRequest->index ];
+	uint64_t startTicks = AssetLoadTrace::IsEnabled() ? Timer::GetTickCount() : 0;
+
+	// Uncompressed objects are read straight from the mapped archive.
+	DynamicArray< uint8_t > decompressedData;
+	const uint8_t* pData = m_archive.GetObjectData( pRequest->index, decompressedData );
+	if ( !pData )
+	{
+		return false;
+	}
+
+	StaticMemoryStream archiveStream( (char *)pData, m_archive.GetObject( pRequest->index ).uncompressedSize );
+
+	DynamicArray< Reflect::ObjectPtr > objects;
+	objects.Push( pRequest->spObject.Get() ); // use existing objects
+	Persist::ArchiveReaderJson::ReadFromStream( archiveStream, objects, pRequest->pResolver );
+	HELIUM_ASSERT( objects[ 0 ].Get() == pRequest->spObject.Get() );
+
+	if ( startTicks != 0 )
+	{
+		AssetLoadTrace::RecordStage( AssetLoadTrace::STAGE_DESERIALIZE, rObjectPath, startTicks, Timer::GetTickCount() );
+	}
+
+	return true;
+}
+
+/// AssetLoader::RunParallel() callback reading the properties of one request in the current tick's deserialize list.
+///
+/// @param[in] pContext  Package loader.
+/// @param[in] index     Index of the request in the deserialize list.
+void ArchivePackageLoader::DeserializeCallback( void* pContext, size_t index )
+{
+	ArchivePackageLoader* pLoader = static_cast< ArchivePackageLoader* >( pContext );
+	HELIUM_ASSERT( pLoader );
+	HELIUM_ASSERT( index < pLoader->m_deserializeRequests.GetSize() );
+
+	if ( !pLoader->DeserializeProperties( pLoader->m_deserializeRequests[ index ] ) )
+	{
+		pLoader->m_deserializeFailures[ index ] = true;
+	}
+}
+
+/// Complete property preloading for a load request, and begin loading its persistent resource data if it has any.
+///
+/// @param[in] pRequest                Load request to finish.
+/// @param[in] bObjectCreationFailure  True if the object could not be created, reused or read.
+void ArchivePackageLoader::FinishDeserialize( LoadRequest* pRequest, bool bObjectCreationFailure )
+{
+	HELIUM_ASSERT( pRequest );
+
+	const AssetPath& rObjectPath = m_objectPaths[ pRequest->index ];
+	Asset* pObject = pRequest->spObject;
+	HELIUM_ASSERT( pObject );
+
+	pRequest->flags |= LOAD_FLAG_PROPERTY_PRELOADED;
+
+	if ( bObjectCreationFailure )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"ArchivePackageLoader: Deserialization of object \"%s\" failed.\n",
+			*rObjectPath.ToString() );
+
+		pObject->SetFlags( Asset::FLAG_PRELOADED | Asset::FLAG_LINKED );
+		pObject->ConditionalFinalizeLoad();
+
+		pRequest->flags |= LOAD_FLAG_ERROR;
+	}
+	else if ( !pObject->IsDefaultTemplate() )
+	{
+		// If the object is a resource (not including the default template object for resource types), attempt to begin
+		// loading any existing persistent resource data stored in the object cache.
+		Resource* pResource = Reflect::SafeCast< Resource >( pObject );
+		if ( pResource )
+		{
+			CacheManager* pCacheManager = CacheManager::GetInstance();
+			HELIUM_ASSERT( pCacheManager );
+
+			Cache* pCache = pCacheManager->GetCache( Name( HELIUM_ASSET_CACHE_NAME ) );
+			HELIUM_ASSERT( pCache );
+			pCache->EnforceTocLoad();
+
+			const Cache::Entry* pEntry = pCache->FindEntry( rObjectPath, 0 );
+			if ( pEntry && pEntry->size != 0 )
+			{
+				HELIUM_ASSERT( IsInvalid( pRequest->persistentResourceDataLoadId ) );
+				HELIUM_ASSERT( !pRequest->pCachedObjectDataBuffer );
+
+				pRequest->pCachedObjectDataBuffer =
+					static_cast< uint8_t* >( DefaultAllocator().Allocate( pEntry->uncompressedSize ) );
+				HELIUM_ASSERT( pRequest->pCachedObjectDataBuffer );
+				pRequest->cachedObjectDataBufferSize = pEntry->uncompressedSize;
+
+				AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+				HELIUM_ASSERT( pAsyncLoader );
+
+				pRequest->persistentResourceDataLoadId = pAsyncLoader->QueueRequest(
+					pRequest->pCachedObjectDataBuffer,
+					pCache->GetCacheFileName(),
+					pEntry->offset,
+					pEntry->size,
+					AsyncLoader::PRIORITY_NORMAL,
+					static_cast< CompressionCodec >( pEntry->codec ),
+					pEntry->uncompressedSize );
+				HELIUM_ASSERT( IsValid( pRequest->persistentResourceDataLoadId ) );
+			}
+		}
+	}
+
+	if ( IsInvalid( pRequest->persistentResourceDataLoadId ) )
+	{
+		// No persistent resource data needs to be loaded.
+		pObject->SetFlags( Asset::FLAG_PRELOADED );
+		pRequest->flags |= LOAD_FLAG_PERSISTENT_RESOURCE_PRELOADED;
+	}
+}
+
+/// Update processing of persistent resource data loading for a given load request.
+///
+/// @param[in] pRequest  Load request to process.
+///
+/// @return  True if persistent resource data loading for the given load request has completed, false if not.
+bool ArchivePackageLoader::TickPersistentResourcePreload( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+	HELIUM_ASSERT( !( pRequest->flags & LOAD_FLAG_PERSISTENT_RESOURCE_PRELOADED ) );
+
+	Resource* pResource = Reflect::AssertCast< Resource >( pRequest->spObject.Get() );
+	HELIUM_ASSERT( pResource );
+
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	HELIUM_ASSERT( pAsyncLoader );
+
+	// Wait for the cached data load to complete.
+	size_t bytesRead = 0;
+	HELIUM_ASSERT( IsValid( pRequest->persistentResourceDataLoadId ) );
+	if ( !pAsyncLoader->TrySyncRequest( pRequest->persistentResourceDataLoadId, bytesRead ) )
+	{
+		return false;
+	}
+
+	SetInvalid( pRequest->persistentResourceDataLoadId );
+
+	// Skip over the object property data, which was read from the archive, to the persistent resource data and the
+	// resource sub-data count that follows it.
+	uint8_t* pCachedObjectData = pRequest->pCachedObjectDataBuffer;
+	HELIUM_ASSERT( pCachedObjectData );
+
+	uint32_t propertyDataSize = 0;
+	if ( bytesRead >= sizeof( propertyDataSize ) )
+	{
+		MemoryCopy( &propertyDataSize, pCachedObjectData, sizeof( propertyDataSize ) );
+	}
+
+	size_t byteSkipCount = sizeof( propertyDataSize ) + propertyDataSize;
+	if ( bytesRead != pRequest->cachedObjectDataBufferSize || byteSkipCount + sizeof( uint32_t ) > bytesRead )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"ArchivePackageLoader: Cached persistent resource data for \"%s\" is truncated (%" PRIuSZ " of %" PRIu32 " bytes read).\n",
+			*pResource->GetPath().ToString(),
+			bytesRead,
+			pRequest->cachedObjectDataBufferSize );
+
+		pRequest->flags |= LOAD_FLAG_ERROR;
+	}
+	else
+	{
+		size_t bytesRemaining = bytesRead - byteSkipCount - sizeof( uint32_t );
+
+		Reflect::ObjectPtr persistent_data = Cache::ReadCacheObjectFromBuffer(
+			pCachedObjectData + byteSkipCount,
+			0,
+			bytesRemaining,
+			pRequest->pResolver );
+		if ( !pResource->LoadPersistentResourceObject( persistent_data ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"ArchivePackageLoader: Failed to load persistent resource object for \"%s\".\n",
+				*pResource->GetPath().ToString() );
+
+			pRequest->flags |= LOAD_FLAG_ERROR;
+		}
+	}
+
+	DefaultAllocator().Free( pRequest->pCachedObjectDataBuffer );
+	pRequest->pCachedObjectDataBuffer = NULL;
+	pRequest->cachedObjectDataBufferSize = 0;
+
+	pResource->SetFlags( Asset::FLAG_PRELOADED );
+
+	pRequest->flags |= LOAD_FLAG_PERSISTENT_RESOURCE_PRELOADED;
+
+	return true;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Engine/Asset.h"
+#include "Engine/PackageArchive.h"
+#include "Engine/PackageLoader.h"
+
+namespace Helium
+{
+	/// Package loader for loading the objects of a package from a packed archive (see PackageArchive).
+	///
+	/// The archive is mapped when the loader is initialized, so preloading the package does no I/O beyond loading the
+	/// parent package, and object properties are deserialized straight from the mapped archive.
+	class HELIUM_ENGINE_API ArchivePackageLoader : public PackageLoader
+	{
+	public:
+		/// Load request pool block size.
+		static const size_t LOAD_REQUEST_POOL_BLOCK_SIZE = 16;
+
+		/// @name Construction/Destruction
+		//@{
+		ArchivePackageLoader();
+		virtual ~ArchivePackageLoader();
+		//@}
+
+		/// @name Initialization
+		//@{
+		bool Initialize( AssetPath packagePath, const FilePath& rArchiveFilePath );
+		void Cleanup();
+		//@}
+
+		/// @name Loading
+		//@{
+		bool BeginPreload();
+		virtual bool TryFinishPreload();
+
+		virtual size_t BeginLoadObject( AssetPath path, Reflect::ObjectResolver *pResolver, bool forceReload = false );
+		virtual bool TryFinishLoadObject( size_t requestId, AssetPtr& rspObject );
+
+		virtual void Tick();
+		//@}
+
+		/// @name Data Access
+		//@{
+		virtual size_t GetObjectCount() const;
+		virtual AssetPath GetAssetPath( size_t index ) const;
+
+		Package* GetPackage() const;
+		AssetPath GetPackagePath() const;
+		//@}
+
+#if HELIUM_TOOLS
+		/// @name Package File Information
+		//@{
+		virtual Name GetAssetTypeName( const AssetPath &path ) const;
+		//@}
+
+		virtual void EnumerateChildren( DynamicArray< AssetPath > &children ) const;
+#endif
+
+	private:
+		/// Load request flags.
+		enum ELoadFlag
+		{
+			/// Set once property preloading has completed.
+			LOAD_FLAG_PROPERTY_PRELOADED            = 1 << 0,
+			/// Set once persistent resource data loading has completed.
+			LOAD_FLAG_PERSISTENT_RESOURCE_PRELOADED = 1 << 1,
+
+			/// Set once all preloading has completed.
+			LOAD_FLAG_PRELOADED = LOAD_FLAG_PROPERTY_PRELOADED | LOAD_FLAG_PERSISTENT_RESOURCE_PRELOADED,
+
+			/// Set when an error has occurred in the load process.
+			LOAD_FLAG_ERROR = 1 << 2
+		};
+
+		/// Asset load request data.
+		struct LoadRequest
+		{
+			/// Temporary object reference (hold while loading is in progress).
+			AssetPtr spObject;
+			/// Asset index.
+			size_t index;
+			/// Resolver from top-level request
+			Reflect::ObjectResolver *pResolver;
+
+			/// Cached type reference.
+			AssetTypePtr spType;
+			/// Cached template reference.
+			AssetPtr spTemplate;
+			/// Cached owner reference.
+			AssetPtr spOwner;
+			/// Template object load request ID.
+			size_t templateLoadId;
+			/// Owner object load request ID.
+			size_t ownerLoadId;
+
+			/// Async load ID for persistent resource data.
+			size_t persistentResourceDataLoadId;
+			/// Buffer for loading cached object data (for pre-loading the persistent resource data).
+			uint8_t* pCachedObjectDataBuffer;
+			/// Size of the cached object data buffer.
+			uint32_t cachedObjectDataBufferSize;
+
+			/// Load flags.
+			uint32_t flags;
+
+			bool forceReload;
+		};
+
+		/// Package reference.
+		PackagePtr m_spPackage;
+		/// Package path.
+		AssetPath m_packagePath;
+
+		/// Archive holding the package's objects.
+		PackageArchive m_archive;
+		/// Path of each object in the archive, by archive object index.
+		DynamicArray< AssetPath > m_objectPaths;
+
+		/// Non-zero if the preload process has started.
+		volatile int32_t m_startPreloadCounter;
+		/// Non-zero if the package has been preloaded.
+		volatile int32_t m_preloadedCounter;
+
+		/// Pending load requests.
+		SparseArray< LoadRequest* > m_loadRequests;
+		/// Load request pool.
+		ObjectPool< LoadRequest > m_loadRequestPool;
+
+		/// Load requests whose properties are read in parallel at the end of the current tick.
+		DynamicArray< LoadRequest* > m_deserializeRequests;
+		/// True for each entry in m_deserializeRequests whose properties failed to deserialize.
+		DynamicArray< bool > m_deserializeFailures;
+
+		/// Parent package load request ID.
+		size_t m_parentPackageLoadId;
+
+		/// Mutex for synchronizing access between threads.
+		mutable Mutex m_accessLock;
+
+		/// @name Private Utility Functions
+		//@{
+		void TickPreload();
+
+		void TickLoadRequests();
+		bool TickDeserialize( LoadRequest* pRequest );
+		bool DeserializeProperties( LoadRequest* pRequest );
+		void FinishDeserialize( LoadRequest* pRequest, bool bObjectCreationFailure );
+		static void DeserializeCallback( void* pContext, size_t index );
+		bool TickPersistentResourcePreload( LoadRequest* pRequest );
+		//@}
+	};
+}
@@ -3,6 +3,7 @@
 
 #include "Foundation/ObjectPool.h"
 #include "Engine/Asset.h"
+#include "Engine/MemoryTelemetry.h"
 #include "Engine/PackageLoader.h"
 
 HELIUM_DEFINE_CLASS_NO_REGISTRAR( Helium::Asset )
@@ -115,11 +116,9 @@ uint32_t Asset::s_DefaultPointerFlags = Reflect::FieldFlags::Share;
 SparseArray< AssetWPtr > Asset::sm_objects;
 AssetWPtr Asset::sm_wpFirstTopLevelObject;
 
-Asset::ChildNameInstanceIndexMap* Asset::sm_pNameInstanceIndexMap = NULL;
-Pair< AssetPath, Asset::NameInstanceIndexMap >* Asset::sm_pEmptyNameInstanceIndexMap = NULL;
-Pair< Name, Asset::InstanceIndexSet >* Asset::sm_pEmptyInstanceIndexSet = NULL;
+AssetRegistry Asset::sm_registry;
 
-ReadWriteLock Asset::sm_objectListLock;
+Mutex Asset::sm_objectListLock;
 
 DynamicArray< uint8_t > Asset::sm_serializationBuffer;
 
@@ -245,13 +244,13 @@ bool Asset::Rename( const RenameParameters& rParameters )
 
 	// Hold onto a reference to the current owner until we return from this function.  This is done in case this object
 	// has the last strong reference to it, in which case we would encounter a deadlock if clearing its reference while
-	// we still have a write lock on the object list (object destruction also requires acquiring a write lock).
+	// we still hold the object list lock (object destruction also requires acquiring the lock).
 	AssetPtr spOldOwner = m_spOwner;
 
 	{
-		// Acquire a write lock on the object list to prevent objects from being added and removed as well as keep
+		// Lock the object list to prevent objects from being added and removed as well as keep
 		// objects from being renamed while this object is being renamed.
-		ScopeWriteLock scopeLock( sm_objectListLock );
+		MutexScopeLock scopeLock( sm_objectListLock );
 
 		// Get the list of children belonging to the new owner.
 		AssetWPtr& rwpOwnerFirstChild = ( pOwner ? pOwner->m_wpFirstChild : sm_wpFirstTopLevelObject );
@@ -259,99 +258,44 @@ bool Asset::Rename( const RenameParameters& rParameters )
 		// Don't check for name clashes if we're clearing the object path name information.
 		if( !name.IsEmpty() )
 		{
-			// Resolve name clashes either through the instance index lookup map (if an instance index will be assigned)
-			// or through a child object search (if no instance index will be used).
-			if( IsValid( instanceIndex ) )
+			if( instanceIndex == INSTANCE_INDEX_AUTO )
 			{
-				// Get the instance index map for the requested object name.
-				ChildNameInstanceIndexMap& rNameInstanceIndexMap = GetNameInstanceIndexMap();
-				HELIUM_ASSERT( sm_pEmptyNameInstanceIndexMap );
-				HELIUM_ASSERT( sm_pEmptyInstanceIndexSet );
-
-				sm_pEmptyNameInstanceIndexMap->First() = ( pOwner ? pOwner->GetPath() : AssetPath( NULL_NAME ) );
-				sm_pEmptyInstanceIndexSet->First() = name;
-
-				ChildNameInstanceIndexMap::Accessor childNameMapAccessor;
-				rNameInstanceIndexMap.Insert( childNameMapAccessor, *sm_pEmptyNameInstanceIndexMap );
-
-				NameInstanceIndexMap::Accessor indexSetAccessor;
-				childNameMapAccessor->Second().Insert( indexSetAccessor, *sm_pEmptyInstanceIndexSet );
-
-				InstanceIndexSet& rIndexSet = indexSetAccessor->Second();
-				InstanceIndexSet::ConstAccessor indexAccessor;
-
-				if( instanceIndex == INSTANCE_INDEX_AUTO )
+				// Pick an unused instance index.
+				instanceIndex = 0;
+				while( sm_registry.Find( pOwner, name, instanceIndex ) )
 				{
-					// Pick an unused instance index.
-					instanceIndex = 0;
-					while( !rIndexSet.Insert( indexAccessor, instanceIndex ) )
-					{
-						++instanceIndex;
-						HELIUM_ASSERT( instanceIndex < INSTANCE_INDEX_AUTO );
-					}
-				}
-				else
-				{
-					// Attempt to acquire the specified instance index.
-					if( !rIndexSet.Insert( indexAccessor, instanceIndex ) )
-					{
-						HELIUM_TRACE(
-							TraceLevels::Error,
-							"Asset::Rename(): Object already exists with the specified owner (%s), name (%s), and instance index (%" PRIu32 ").\n",
-							pOwner ? *pOwner->GetPath().ToString() : "none",
-							*name,
-							instanceIndex );
-
-						return false;
-					}
+					++instanceIndex;
+					HELIUM_ASSERT( instanceIndex < INSTANCE_INDEX_AUTO );
 				}
 			}
-			else
+			else if( sm_registry.Find( pOwner, name, instanceIndex ) )
 			{
-				// Check each child of the new owner for a name clash.
-				for( Asset* pChild = rwpOwnerFirstChild; pChild != NULL; pChild = pChild->m_wpNextSibling )
+				if( IsValid( instanceIndex ) )
 				{
-					if( pChild->m_name == name && pChild->m_instanceIndex == instanceIndex )
-					{
-						HELIUM_TRACE(
-							TraceLevels::Error,
-							"Asset::Rename(): Object already exists with the specified owner (%s) and name (%s).\n",
-							pOwner ? *pOwner->GetPath().ToString() : "none",
-							*name );
-
-						return false;
-					}
+					HELIUM_TRACE(
+						TraceLevels::Error,
+						"Asset::Rename(): Object already exists with the specified owner (%s), name (%s), and instance index (%" PRIu32 ").\n",
+						pOwner ? *pOwner->GetPath().ToString() : "none",
+						*name,
+						instanceIndex );
 				}
+				else
+				{
+					HELIUM_TRACE(
+						TraceLevels::Error,
+						"Asset::Rename(): Object already exists with the specified owner (%s) and name (%s).\n",
+						pOwner ? *pOwner->GetPath().ToString() : "none",
+						*name );
+				}
+
+				return false;
 			}
 		}
 
-		// Remove any old instance index tracking for the old path name.
-		if( IsValid( m_instanceIndex ) )
+		// Remove the lookup entry for the old path name.
+		if( !m_name.IsEmpty() )
 		{
-			AssetPath ownerPath = ( spOldOwner ? spOldOwner->GetPath() : AssetPath( NULL_NAME ) );
-
-			ChildNameInstanceIndexMap& rNameInstanceIndexMap = GetNameInstanceIndexMap();
-
-			ChildNameInstanceIndexMap::Accessor childMapAccessor;
-			HELIUM_VERIFY( rNameInstanceIndexMap.Find( childMapAccessor, ownerPath ) );
-
-			NameInstanceIndexMap& rNameMap = childMapAccessor->Second();
-			NameInstanceIndexMap::Accessor nameMapAccessor;
-			HELIUM_VERIFY( rNameMap.Find( nameMapAccessor, m_name ) );
-
-			InstanceIndexSet& rIndexSet = nameMapAccessor->Second();
-			HELIUM_VERIFY( rIndexSet.Remove( m_instanceIndex ) );
-
-			/*
-			if( rIndexSet.IsEmpty() )
-			{
-				HELIUM_VERIFY( rNameMap.Remove( nameMapAccessor ) );
-				if( rNameMap.IsEmpty() )
-				{
-					HELIUM_VERIFY( rNameInstanceIndexMap.Remove( childMapAccessor ) );
-				}
-			}
-			*/
+			sm_registry.Remove( spOldOwner.Get(), m_name, m_instanceIndex );
 		}
 
 		// If the owner of this object is changing, remove this object from its old owner's list and add it to the new
@@ -398,6 +342,12 @@ bool Asset::Rename( const RenameParameters& rParameters )
 		m_spOwner = pOwner;
 		m_instanceIndex = instanceIndex;
 
+		// Make the object visible to lookups under its new path name.
+		if( !m_name.IsEmpty() )
+		{
+			sm_registry.Add( this, pOwner, m_name, m_instanceIndex );
+		}
+
 		// Update path information for this object and its children.
 		UpdatePath();
 	}
@@ -668,124 +618,147 @@ bool Helium::Asset::SaveAsset()
 
 struct AssetFixup
 {
+	/// Asset inheriting the field from the replaced asset.
 	Asset *pAsset;
+	/// Field to copy from the new asset.
+	const Reflect::Field* pField;
+	/// Element of the field to copy.
+	uint32_t index;
 };
 
+/// Replace an existing asset with a new instance, such as a copy reloaded from disk.
+///
+/// References to the old asset are redirected to the new one, which takes over the old asset's name, path, owner and
+/// children.  Assets using the old asset as a template (directly or indirectly) pick up the new value of each field
+/// that changed, unless they or a template between them and the old asset override it.  Fields that did not change are
+/// left alone, so dependents of an asset are only touched where the reload actually changed something.
+///
+/// @param[in] pNewAsset        New asset instance (not yet named or owned).
+/// @param[in] objectToReplace  Path of the asset to replace.
 void Asset::ReplaceAsset( Asset* pNewAsset, const AssetPath &objectToReplace )
 {
+	HELIUM_ASSERT( pNewAsset );
+
 	AssetAwareThreadSynchronizer::Lock assetLock;
 
-	// Acquire a write lock on the object list to prevent objects from being added and removed as well as keep
+	// Lock the object list to prevent objects from being added and removed as well as keep
 	// objects from being renamed while this object is being renamed.
-	ScopeWriteLock scopeLock( sm_objectListLock );
+	MutexScopeLock scopeLock( sm_objectListLock );
 
 	Asset *pOldAsset = Asset::FindObject( objectToReplace );
+	HELIUM_ASSERT( pOldAsset );
+	HELIUM_ASSERT( pOldAsset != pNewAsset );
 	HELIUM_ASSERT( pNewAsset->GetMetaClass()->IsType( pOldAsset->GetMetaClass() ) );
 
-	DynamicArray<AssetFixup> fixups;
+	// Get the fields whose value differs between the old and new asset, bases first so that changes ripple down the
+	// type hierarchy in declaration order.
+	// TODO: Declare a max count for fields to save heap allocs -geoff
+	DynamicArray< const Reflect::MetaStruct* > bases;
+	for ( const Reflect::MetaStruct* current = pOldAsset->GetMetaClass(); current != NULL; current = current->m_Base )
+	{
+		bases.Push( current );
+	}
 
-	// For every asset in existence
-	for ( SparseArray< AssetWPtr >::Iterator iter = sm_objects.Begin();
-		iter != sm_objects.End(); ++iter)
+	DynamicArray< AssetFixup > changedFields;
+	while ( !bases.IsEmpty() )
 	{
-		if ( !iter )
+		const Reflect::MetaStruct* current = bases.Pop();
+		DynamicArray< Reflect::Field >::ConstIterator itr = current->m_Fields.Begin();
+		DynamicArray< Reflect::Field >::ConstIterator end = current->m_Fields.End();
+		for ( ; itr != end; ++itr )
 		{
-			continue;
-		}
+			// Field is guaranteed to be in all objects of the template dependency chain
+			const Reflect::Field* field = &*itr;
 
-		Asset* pPossibleFixupAsset = iter->Get();
-		if ( !pPossibleFixupAsset || pPossibleFixupAsset->IsDefaultTemplate() )
-		{
-			continue;
+			for ( uint32_t i = 0; i < field->m_Count; ++i )
+			{
+				Reflect::Pointer oldAssetPointer( field, pOldAsset, i );
+				Reflect::Pointer newAssetPointer( field, pNewAsset, i );
+				if ( !field->m_Translator->Equals( oldAssetPointer, newAssetPointer ) )
+				{
+					AssetFixup &fixup = *changedFields.New();
+					fixup.pAsset = NULL;
+					fixup.pField = field;
+					fixup.index = i;
+				}
+			}
 		}
+	}
 
-		// Ignore it if it's the asset we're swapping
-		if ( pPossibleFixupAsset->m_id == pNewAsset->m_id || pPossibleFixupAsset->m_id == pOldAsset->m_id )
-		{
-			continue;
-		}
-		
-		// If the asset has the old asset as a template (direct or indirect)
-		Asset *pTemplate = pPossibleFixupAsset->GetTemplateAsset().Get();
-		
-		while ( pTemplate && !pTemplate->IsDefaultTemplate() )
+	// Find every field of every asset that inherits a changed field from the old asset.  All fixups are gathered before
+	// any are applied so that the override checks compare values from before the replacement.
+	DynamicArray< AssetFixup > fixups;
+	if ( !changedFields.IsEmpty() )
+	{
+		for ( SparseArray< AssetWPtr >::Iterator iter = sm_objects.Begin();
+			iter != sm_objects.End(); ++iter)
 		{
-			if ( pTemplate == pOldAsset )
+			if ( !iter )
 			{
-				// Then save it off
-				// TODO: Does order matter? Right now we probably want bases first so that changes ripple down the template
-				// tree but in future we should probably have a flag of some sort to say if a field is set or not. Maybe in tools only.
-				AssetFixup &fixup = *fixups.New();
-				fixup.pAsset = pPossibleFixupAsset;
-				break;
+				continue;
 			}
 
-			pTemplate = pTemplate->GetTemplateAsset().Get();
-		}
-	}
+			Asset* pPossibleFixupAsset = iter->Get();
+			if ( !pPossibleFixupAsset || pPossibleFixupAsset->IsDefaultTemplate() )
+			{
+				continue;
+			}
 
-	const Reflect::MetaStruct *pStruct = pOldAsset->GetMetaClass();
+			// Ignore it if it's the asset we're swapping
+			if ( pPossibleFixupAsset == pNewAsset || pPossibleFixupAsset == pOldAsset )
+			{
+				continue;
+			}
 
-	// Get all the bases
-	// TODO: Declare a max depth for inheritance to save heap allocs -geoff
-	DynamicArray< const Reflect::MetaStruct* > bases;
-	for ( const Reflect::MetaStruct* current = pStruct; current != NULL; current = current->m_Base )
-	{
-		bases.Push( current );
-	}
+			// Skip it unless it has the old asset as a template (direct or indirect)
+			Asset *pTemplate = pPossibleFixupAsset->GetTemplateAsset().Get();
+			while ( pTemplate && pTemplate != pOldAsset && !pTemplate->IsDefaultTemplate() )
+			{
+				pTemplate = pTemplate->GetTemplateAsset().Get();
+			}
 
-	// For all assets that depend on the changing asset
-	for ( DynamicArray<AssetFixup>::Iterator iter = fixups.Begin();
-		iter != fixups.End(); ++iter)
-	{
-		// Get the template (old) asset's type
-		Asset *pAsset = iter->pAsset;
+			if ( pTemplate != pOldAsset )
+			{
+				continue;
+			}
 
-		// Get all the fields that should be modified due to the base template changing
-		// TODO: Declare a max count for fields to save heap allocs -geoff
-		DynamicArray< const Reflect::Field* > fields;
-		while ( !bases.IsEmpty() )
-		{
-			const Reflect::MetaStruct* current = bases.Pop();
-			DynamicArray< Reflect::Field >::ConstIterator itr = current->m_Fields.Begin();
-			DynamicArray< Reflect::Field >::ConstIterator end = current->m_Fields.End();
-			for ( ; itr != end; ++itr )
+			for ( DynamicArray< AssetFixup >::ConstIterator fieldIter = changedFields.Begin();
+				fieldIter != changedFields.End(); ++fieldIter )
 			{
-				// Field is guaranteed to be in all objects of the template dependency chain
-				const Reflect::Field* field = &*itr;
+				const Reflect::Field* field = fieldIter->pField;
+				Reflect::Pointer assetPointer( field, pPossibleFixupAsset, fieldIter->index );
 
-				// For every field
-				for ( uint32_t i = 0; i < field->m_Count; ++i )
+				// Is there anywhere in the template chain, up to the old asset, that the field gets overridden?
+				bool isOverridden = false;
+				for ( pTemplate = pPossibleFixupAsset->GetTemplateAsset().Get(); pTemplate; )
 				{
-					bool isOverridden = false;
-					Reflect::Pointer assetPointer( field, pAsset, i );
-
-					// Is there anywhere in the template chain that the field gets overridden?
-					Asset *pTemplate = pAsset->GetTemplateAsset();
-					while ( pTemplate )
+					Reflect::Pointer templatePointer( field, pTemplate, fieldIter->index );
+					if ( !field->m_Translator->Equals( assetPointer, templatePointer ) )
 					{
-						Reflect::Pointer templatePointer( field, pTemplate, i );
-
-						if ( !field->m_Translator->Equals( assetPointer, templatePointer ) )
-						{
-							// Yes, bail
-							isOverridden = true;
-							break;
-						}
-
-						pTemplate == pOldAsset ? pTemplate = NULL : pTemplate->GetTemplate();
+						isOverridden = true;
+						break;
 					}
 
-					if ( !isOverridden )
-					{
-						Reflect::Pointer newAssetPointer( field, pNewAsset, i );
-						field->m_Translator->Copy( newAssetPointer, assetPointer, Reflect::CopyFlags::Shallow );
-					}
+					pTemplate = ( pTemplate == pOldAsset ) ? NULL : pTemplate->GetTemplateAsset().Get();
+				}
+
+				if ( !isOverridden )
+				{
+					AssetFixup &fixup = *fixups.New();
+					fixup = *fieldIter;
+					fixup.pAsset = pPossibleFixupAsset;
 				}
 			}
 		}
 	}
 
+	for ( DynamicArray< AssetFixup >::ConstIterator iter = fixups.Begin(); iter != fixups.End(); ++iter )
+	{
+		Reflect::Pointer newAssetPointer( iter->pField, pNewAsset, iter->index );
+		Reflect::Pointer assetPointer( iter->pField, iter->pAsset, iter->index );
+		iter->pField->m_Translator->Copy( newAssetPointer, assetPointer, Reflect::CopyFlags::Shallow );
+	}
+
 	pNewAsset->RefCountSwapProxies( pOldAsset );
 	Helium::Swap( pOldAsset->m_name, pNewAsset->m_name );
 	Helium::Swap( pOldAsset->m_instanceIndex, pNewAsset->m_instanceIndex );
@@ -994,6 +967,8 @@ bool Asset::CreateObject(
 
 /// Find an object based on its path name.
 ///
+/// This does not take any locks, so it is safe to call from any thread while objects are being loaded.
+///
 /// @param[in] path  FilePath of the object to locate.
 ///
 /// @return  Pointer to the object if found, null pointer if not found.
@@ -1058,19 +1033,7 @@ Asset* Asset::FindChildOf( const Asset* pObject, Name name, uint32_t instanceInd
 		return NULL;
 	}
 
-	ScopeReadLock scopeLock( sm_objectListLock );
-
-	for( Asset* pChild = ( pObject ? pObject->m_wpFirstChild : sm_wpFirstTopLevelObject );
-		 pChild != NULL;
-		 pChild = pChild->m_wpNextSibling )
-	{
-		if( pChild->GetName() == name && pChild->GetInstanceIndex() == instanceIndex )
-		{
-			return pChild;
-		}
-	}
-
-	return NULL;
+	return sm_registry.Find( pObject, name, instanceIndex );
 }
 
 /// Search for a child or grandchild of the given object with a relative path dictated by the given parameters.
@@ -1102,42 +1065,20 @@ Asset* Asset::FindChildOf(
 		return NULL;
 	}
 
-	// Search for the direct child of the given object in the path chain.
-	Asset* pChild = FindChildOf(
-		pObject,
-		pRelativePathNames[ 0 ],
-		( pInstanceIndices ? pInstanceIndices[ 0 ] : Invalid< uint32_t >() ) );
-	if( !pChild )
-	{
-		return NULL;
-	}
-
-	// Verify that the child object is of the correct type (package or non-package).
-	if( pChild->m_path.IsPackage() ? packageDepth == 0 : packageDepth != 0 )
-	{
-		return NULL;
-	}
-
-	// Check grandchildren if necessary.
-	--nameDepth;
-	if( !nameDepth )
-	{
-		return pChild;
-	}
-
-	if( packageDepth )
-	{
-		--packageDepth;
-	}
+	return sm_registry.Find( pObject, pRelativePathNames, pInstanceIndices, nameDepth, packageDepth );
+}
 
-	pChild = FindChildOf(
-		pChild,
-		pRelativePathNames + 1,
-		( pInstanceIndices ? pInstanceIndices + 1 : NULL ),
-		nameDepth,
-		packageDepth );
+/// Get the memory telemetry tracker for instances of the type of an object.
+///
+/// @param[in] pObject  Asset instance.
+///
+/// @return  Memory telemetry tracker ID.
+static uint32_t GetMemoryTracker( const Asset* pObject )
+{
+	const Reflect::MetaClass* pMetaClass = pObject->GetMetaClass();
+	HELIUM_ASSERT( pMetaClass );
 
-	return pChild;
+	return MemoryTelemetry::GetTracker( MemoryTelemetry::CATEGORY_ASSET_TYPE, Name( pMetaClass->m_Name ) );
 }
 
 /// Register an Asset instance for object management.
@@ -1151,7 +1092,7 @@ bool Asset::RegisterObject( Asset* pObject )
 {
 	HELIUM_ASSERT( pObject );
 
-	ScopeWriteLock scopeLock( sm_objectListLock );
+	MutexScopeLock scopeLock( sm_objectListLock );
 
 	// Check if the object has already been registered.
 	if( IsValid( pObject->m_id ) )
@@ -1177,6 +1118,8 @@ bool Asset::RegisterObject( Asset* pObject )
 
 	pObject->m_id = static_cast< uint32_t >( objectId );
 
+	MemoryTelemetry::RecordAllocation( GetMemoryTracker( pObject ), pObject->GetMetaClass()->m_Size );
+
 	return true;
 }
 
@@ -1189,7 +1132,7 @@ void Asset::UnregisterObject( Asset* pObject )
 {
 	HELIUM_ASSERT( pObject );
 
-	ScopeWriteLock scopeLock( sm_objectListLock );
+	MutexScopeLock scopeLock( sm_objectListLock );
 
 	// Check if the object has already been unregistered.
 	uint32_t objectId = pObject->m_id;
@@ -1216,6 +1159,8 @@ void Asset::UnregisterObject( Asset* pObject )
 		sm_objects.Remove( objectId );
 	}
 
+	MemoryTelemetry::RecordFree( GetMemoryTracker( pObject ), pObject->GetMetaClass()->m_Size );
+
 	SetInvalid( pObject->m_id );
 }
 
@@ -1269,14 +1214,7 @@ void Asset::Shutdown()
 	sm_objects.Clear();
 	sm_wpFirstTopLevelObject.Release();
 
-	delete sm_pNameInstanceIndexMap;
-	sm_pNameInstanceIndexMap = NULL;
-
-	delete sm_pEmptyNameInstanceIndexMap;
-	sm_pEmptyNameInstanceIndexMap = NULL;
-
-	delete sm_pEmptyInstanceIndexSet;
-	sm_pEmptyInstanceIndexSet = NULL;
+	sm_registry.Shutdown();
 
 	sm_serializationBuffer.Clear();
 }
@@ -1404,32 +1342,6 @@ void Asset::StandardCustomDestroy( Asset* pObject )
 	allocator.FreeAligned( pObject );
 }
 
-/// Get the static name instance lookup map, creating it if necessary.
-///
-/// Since our hash table implementation dynamically allocates buckets on construction and always keeps them around
-/// for the lifetime of the table, we dynamically construct our object name instance map so that we can destroy it
-/// during shutdown, ensuring that we no longer have any dynamic allocations within the engine.
-///
-/// @return  Reference to the name instance lookup map.
-Asset::ChildNameInstanceIndexMap& Asset::GetNameInstanceIndexMap()
-{
-	if( !sm_pNameInstanceIndexMap )
-	{
-		sm_pNameInstanceIndexMap = new ChildNameInstanceIndexMap;
-		HELIUM_ASSERT( sm_pNameInstanceIndexMap );
-
-		HELIUM_ASSERT( !sm_pEmptyNameInstanceIndexMap );
-		sm_pEmptyNameInstanceIndexMap = new Pair< AssetPath, NameInstanceIndexMap >;
-		HELIUM_ASSERT( sm_pEmptyNameInstanceIndexMap );
-
-		HELIUM_ASSERT( !sm_pEmptyInstanceIndexSet );
-		sm_pEmptyInstanceIndexSet = new Pair< Name, InstanceIndexSet >;
-		HELIUM_ASSERT( sm_pEmptyInstanceIndexSet );
-	}
-
-	return *sm_pNameInstanceIndexMap;
-}
-
 AssetRegistrar< Asset, void > Asset::s_Registrar("Helium::Asset");
 
 
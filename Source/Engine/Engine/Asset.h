@@ -12,6 +12,7 @@
 #include "Reflect/Object.h"
 
 #include "Engine/AssetPath.h"
+#include "Engine/AssetRegistry.h"
 
 /// @defgroup objectmacros Common "Asset"-class Macros
 //@{
@@ -375,13 +376,6 @@ namespace Helium
 		//@}
 
 	private:
-		/// Name instance index lookup set type.
-		typedef ConcurrentHashSet< uint32_t > InstanceIndexSet;
-		/// Name instance lookup map type.
-		typedef ConcurrentHashMap< Name, InstanceIndexSet > NameInstanceIndexMap;
-		/// Child object name instance lookup map type.
-		typedef ConcurrentHashMap< AssetPath, NameInstanceIndexMap > ChildNameInstanceIndexMap;
-
 		/// Object name.
 		Name m_name;
 		/// Instance index.
@@ -412,15 +406,11 @@ namespace Helium
 		/// First object in the list of top-level objects.
 		static AssetWPtr sm_wpFirstTopLevelObject;
 
-		/// Name instance lookup.
-		static ChildNameInstanceIndexMap* sm_pNameInstanceIndexMap;
-		/// Empty object name instance map.
-		static Pair< AssetPath, NameInstanceIndexMap >* sm_pEmptyNameInstanceIndexMap;
-		/// Empty name instance index lookup set.
-		static Pair< Name, InstanceIndexSet >* sm_pEmptyInstanceIndexSet;
+		/// Lookup of named objects by owner, name, and instance index.
+		static AssetRegistry sm_registry;
 
-		/// Read-write lock for synchronizing access to the object lists.
-		static ReadWriteLock sm_objectListLock;
+		/// Lock for synchronizing changes to the object lists (lookups through the registry do not need it).
+		static Mutex sm_objectListLock;
 
 		/// Cached serialization buffer.
 		static DynamicArray< uint8_t > sm_serializationBuffer;
@@ -434,11 +424,6 @@ namespace Helium
 		//@{
 		static void StandardCustomDestroy( Asset* pObject );
 		//@}
-
-		/// @name Static Asset Management
-		//@{
-		static ChildNameInstanceIndexMap& GetNameInstanceIndexMap();
-		//@}
 	};
 
 	/// @defgroup objectcast Type-checking Asset Casting Functions
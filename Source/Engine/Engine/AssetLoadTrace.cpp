@@ -0,0 +1,417 @@
+#include "Precompile.h"
+#include "Engine/AssetLoadTrace.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
+#include "Platform/Timer.h"
+
+#include "Foundation/FileStream.h"
+#include "Foundation/BufferedStream.h"
+#include "Foundation/HashMap.h"
+
+#include <algorithm>
+
+using namespace Helium;
+
+volatile int32_t AssetLoadTrace::sm_enabled = 0;
+
+namespace
+{
+	/// Recorded stage spans, in the order they were recorded.
+	DynamicArray< AssetLoadTrace::Event > s_events;
+	/// Type name reported for each asset.
+	HashMap< AssetPath, Name > s_assetTypes;
+	/// Lock for the recorded data.
+	Mutex s_traceLock;
+
+	/// Time at which an asset started loading.
+	struct LoadStart
+	{
+		/// Asset path.
+		AssetPath path;
+		/// Tick count when the first recorded stage of the asset began.
+		uint64_t startTicks;
+		/// Index of the asset in the order in which it was first recorded, to break ties.
+		size_t recordIndex;
+	};
+
+	/// Order assets by the time they started loading.
+	bool LoadStartLess( const LoadStart& rStart0, const LoadStart& rStart1 )
+	{
+		if( rStart0.startTicks != rStart1.startTicks )
+		{
+			return ( rStart0.startTicks < rStart1.startTicks );
+		}
+
+		return ( rStart0.recordIndex < rStart1.recordIndex );
+	}
+
+	/// Write a string to a stream.
+	void WriteString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( pString, sizeof( char ), StringLength( pString ) );
+	}
+
+	/// Write a string to a stream as a quoted JSON string.
+	void WriteJsonString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( "\"", sizeof( char ), 1 );
+
+		for( const char* pCharacter = pString; *pCharacter != '\0'; ++pCharacter )
+		{
+			if( *pCharacter == '"' || *pCharacter == '\\' )
+			{
+				rStream.Write( "\\", sizeof( char ), 1 );
+			}
+
+			rStream.Write( pCharacter, sizeof( char ), 1 );
+		}
+
+		rStream.Write( "\"", sizeof( char ), 1 );
+	}
+}
+
+/// Set whether load stages are recorded.
+///
+/// Recorded stages are kept when recording is disabled, until Clear() is called.
+///
+/// @param[in] bEnabled  True to record load stages, false to stop.
+///
+/// @see IsEnabled()
+void AssetLoadTrace::SetEnabled( bool bEnabled )
+{
+	AtomicExchangeRelease( sm_enabled, bEnabled ? 1 : 0 );
+}
+
+/// Record the time an asset spent in a load stage.
+///
+/// This does nothing if recording is disabled.  A stage may be recorded more than once for the same asset (for
+/// example, if its loader processes it over several ticks).
+///
+/// @param[in] stage       Load stage.
+/// @param[in] path        Asset path.
+/// @param[in] startTicks  Tick count when the stage began.
+/// @param[in] endTicks    Tick count when the stage ended.
+void AssetLoadTrace::RecordStage( EStage stage, AssetPath path, uint64_t startTicks, uint64_t endTicks )
+{
+	HELIUM_ASSERT( static_cast< size_t >( stage ) < static_cast< size_t >( STAGE_MAX ) );
+
+	if( !IsEnabled() )
+	{
+		return;
+	}
+
+	MutexScopeLock scopeLock( s_traceLock );
+
+	Event* pEvent = s_events.New();
+	HELIUM_ASSERT( pEvent );
+	pEvent->path = path;
+	pEvent->stage = stage;
+	pEvent->startTicks = startTicks;
+	pEvent->endTicks = Max( startTicks, endTicks );
+}
+
+/// Set the type of an asset, under which the time it spends in each load stage is summed up.
+///
+/// This does nothing if recording is disabled.  Only the first type reported for an asset is kept.
+///
+/// @param[in] path      Asset path.
+/// @param[in] typeName  Asset type name.
+void AssetLoadTrace::SetAssetType( AssetPath path, Name typeName )
+{
+	if( !IsEnabled() )
+	{
+		return;
+	}
+
+	MutexScopeLock scopeLock( s_traceLock );
+
+	HashMap< AssetPath, Name >::Iterator typeIterator = s_assetTypes.Find( path );
+	if( typeIterator == s_assetTypes.End() )
+	{
+		s_assetTypes.Insert( typeIterator, HashMap< AssetPath, Name >::ValueType( path, typeName ) );
+	}
+}
+
+/// Release all recorded load stages.
+void AssetLoadTrace::Clear()
+{
+	MutexScopeLock scopeLock( s_traceLock );
+
+	s_events.Clear();
+	s_assetTypes.Clear();
+}
+
+/// Get a copy of all recorded load stages.
+///
+/// @param[out] rEvents  Recorded stage spans, in the order they were recorded.
+void AssetLoadTrace::GetEvents( DynamicArray< Event >& rEvents )
+{
+	MutexScopeLock scopeLock( s_traceLock );
+
+	rEvents = s_events;
+}
+
+/// Get the order in which the assets in the recorded load stages started loading.
+///
+/// This is the order in which their data is read, and can be used to lay out cached data for sequential reads (see
+/// Cache::Compact()).
+///
+/// @param[out] rPaths  Path of each asset, in the order in which its first recorded stage began.
+void AssetLoadTrace::GetLoadOrder( DynamicArray< AssetPath >& rPaths )
+{
+	rPaths.Resize( 0 );
+
+	DynamicArray< LoadStart > loadStarts;
+	HashMap< AssetPath, size_t > loadStartIndices;
+
+	{
+		MutexScopeLock scopeLock( s_traceLock );
+
+		size_t eventCount = s_events.GetSize();
+		for( size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex )
+		{
+			const Event& rEvent = s_events[ eventIndex ];
+
+			HashMap< AssetPath, size_t >::Iterator indexIterator = loadStartIndices.Find( rEvent.path );
+			if( indexIterator != loadStartIndices.End() )
+			{
+				LoadStart& rLoadStart = loadStarts[ indexIterator->Second() ];
+				rLoadStart.startTicks = Min( rLoadStart.startTicks, rEvent.startTicks );
+
+				continue;
+			}
+
+			loadStartIndices.Insert(
+				indexIterator,
+				HashMap< AssetPath, size_t >::ValueType( rEvent.path, loadStarts.GetSize() ) );
+
+			LoadStart* pLoadStart = loadStarts.New();
+			HELIUM_ASSERT( pLoadStart );
+			pLoadStart->path = rEvent.path;
+			pLoadStart->startTicks = rEvent.startTicks;
+			pLoadStart->recordIndex = loadStarts.GetSize() - 1;
+		}
+	}
+
+	size_t loadStartCount = loadStarts.GetSize();
+	std::sort( loadStarts.GetData(), loadStarts.GetData() + loadStartCount, LoadStartLess );
+
+	rPaths.Reserve( loadStartCount );
+	for( size_t loadStartIndex = 0; loadStartIndex < loadStartCount; ++loadStartIndex )
+	{
+		rPaths.Push( loadStarts[ loadStartIndex ].path );
+	}
+}
+
+/// Get the time spent in each load stage, summed up per asset type.
+///
+/// @param[out] rStats  Statistics of each asset type, in the order each type first appears in the recorded stages.
+void AssetLoadTrace::GetTypeStats( DynamicArray< TypeStats >& rStats )
+{
+	rStats.Resize( 0 );
+
+	HashMap< Name, size_t > typeIndices;
+	HashMap< AssetPath, size_t > assetTypeIndices;
+
+	MutexScopeLock scopeLock( s_traceLock );
+
+	size_t eventCount = s_events.GetSize();
+	for( size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex )
+	{
+		const Event& rEvent = s_events[ eventIndex ];
+
+		// Look up the statistics of the asset's type, counting each asset once.
+		size_t typeIndex;
+		HashMap< AssetPath, size_t >::Iterator assetIterator = assetTypeIndices.Find( rEvent.path );
+		if( assetIterator != assetTypeIndices.End() )
+		{
+			typeIndex = assetIterator->Second();
+		}
+		else
+		{
+			Name typeName;
+			HashMap< AssetPath, Name >::ConstIterator typeNameIterator = s_assetTypes.Find( rEvent.path );
+			if( typeNameIterator != s_assetTypes.End() )
+			{
+				typeName = typeNameIterator->Second();
+			}
+
+			HashMap< Name, size_t >::Iterator typeIterator = typeIndices.Find( typeName );
+			if( typeIterator != typeIndices.End() )
+			{
+				typeIndex = typeIterator->Second();
+			}
+			else
+			{
+				typeIndex = rStats.GetSize();
+
+				TypeStats* pStats = rStats.New();
+				HELIUM_ASSERT( pStats );
+				pStats->typeName = typeName;
+				pStats->assetCount = 0;
+				for( size_t stageIndex = 0; stageIndex < STAGE_MAX; ++stageIndex )
+				{
+					pStats->stageTicks[ stageIndex ] = 0;
+					pStats->stageCounts[ stageIndex ] = 0;
+				}
+
+				typeIndices.Insert( typeIterator, HashMap< Name, size_t >::ValueType( typeName, typeIndex ) );
+			}
+
+			++rStats[ typeIndex ].assetCount;
+			assetTypeIndices.Insert( assetIterator, HashMap< AssetPath, size_t >::ValueType( rEvent.path, typeIndex ) );
+		}
+
+		TypeStats& rTypeStats = rStats[ typeIndex ];
+		rTypeStats.stageTicks[ rEvent.stage ] += rEvent.endTicks - rEvent.startTicks;
+		++rTypeStats.stageCounts[ rEvent.stage ];
+	}
+}
+
+/// Write the recorded load stages to a JSON file.
+///
+/// The file holds the time spent in each stage per asset type, in milliseconds, under "types", and a waterfall of
+/// the recorded stages under "traceEvents".  The waterfall shows one row per asset, in the order assets started
+/// loading, and can be viewed by loading the file in chrome://tracing.
+///
+/// @param[in] rPath  Report file path.
+///
+/// @return  True if the report was written successfully, false if not.
+bool AssetLoadTrace::WriteReport( const FilePath& rPath )
+{
+	DynamicArray< TypeStats > typeStats;
+	GetTypeStats( typeStats );
+
+	DynamicArray< Event > events;
+	GetEvents( events );
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"AssetLoadTrace::WriteReport(): Failed to open \"%s\" for writing.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+
+		const float64_t millisecondsPerTick = Timer::GetSecondsPerTick() * 1000.0;
+		char buffer[ 256 ];
+
+		WriteString( bufferedStream, "{\n\"types\":[" );
+
+		size_t typeCount = typeStats.GetSize();
+		for( size_t typeIndex = 0; typeIndex < typeCount; ++typeIndex )
+		{
+			const TypeStats& rStats = typeStats[ typeIndex ];
+
+			WriteString( bufferedStream, ( typeIndex == 0 ? "\n{\"type\":" : ",\n{\"type\":" ) );
+			WriteJsonString( bufferedStream, *rStats.typeName );
+
+			StringPrint( buffer, ",\"assets\":%" PRIu32, rStats.assetCount );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+
+			for( size_t stageIndex = 0; stageIndex < STAGE_MAX; ++stageIndex )
+			{
+				StringPrint(
+					buffer,
+					",\"%s\":{\"count\":%" PRIu32 ",\"ms\":%.4f}",
+					GetStageName( static_cast< EStage >( stageIndex ) ),
+					rStats.stageCounts[ stageIndex ],
+					static_cast< float64_t >( rStats.stageTicks[ stageIndex ] ) * millisecondsPerTick );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+			}
+
+			WriteString( bufferedStream, "}" );
+		}
+
+		WriteString( bufferedStream, "\n],\n\"traceEvents\":[" );
+
+		// Timestamps are in microseconds, relative to the earliest recorded stage.
+		uint64_t baseTicks = UINT64_MAX;
+		size_t eventCount = events.GetSize();
+		for( size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex )
+		{
+			baseTicks = Min( baseTicks, events[ eventIndex ].startTicks );
+		}
+
+		const float64_t microsecondsPerTick = millisecondsPerTick * 1000.0;
+
+		HashMap< AssetPath, uint32_t > assetRows;
+		bool bFirst = true;
+		for( size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex )
+		{
+			const Event& rEvent = events[ eventIndex ];
+
+			// Give each asset its own row, named after the asset.
+			uint32_t row;
+			HashMap< AssetPath, uint32_t >::Iterator rowIterator = assetRows.Find( rEvent.path );
+			if( rowIterator != assetRows.End() )
+			{
+				row = rowIterator->Second();
+			}
+			else
+			{
+				row = static_cast< uint32_t >( assetRows.GetSize() );
+				assetRows.Insert( rowIterator, HashMap< AssetPath, uint32_t >::ValueType( rEvent.path, row ) );
+
+				StringPrint(
+					buffer,
+					"%s{\"ph\":\"M\",\"pid\":0,\"tid\":%" PRIu32 ",\"name\":\"thread_name\",\"args\":{\"name\":",
+					( bFirst ? "\n" : ",\n" ),
+					row );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+				WriteJsonString( bufferedStream, *rEvent.path.ToString() );
+				WriteString( bufferedStream, "}}" );
+
+				bFirst = false;
+			}
+
+			StringPrint(
+				buffer,
+				",\n{\"ph\":\"X\",\"pid\":0,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f,\"name\":\"%s\"}",
+				row,
+				static_cast< float64_t >( rEvent.startTicks - baseTicks ) * microsecondsPerTick,
+				static_cast< float64_t >( rEvent.endTicks - rEvent.startTicks ) * microsecondsPerTick,
+				GetStageName( rEvent.stage ) );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+		}
+
+		WriteString( bufferedStream, "\n]\n}\n" );
+	}
+
+	delete pFileStream;
+
+	return true;
+}
+
+/// Get the name of a load stage, as used in reports.
+///
+/// @param[in] stage  Load stage.
+///
+/// @return  Stage name.
+const char* AssetLoadTrace::GetStageName( EStage stage )
+{
+	static const char* const STAGE_NAMES[] =
+	{
+		"io_wait",      // STAGE_IO_WAIT
+		"deserialize",  // STAGE_DESERIALIZE
+		"link",         // STAGE_LINK
+		"precache",     // STAGE_PRECACHE
+		"finalize",     // STAGE_FINALIZE
+	};
+
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( STAGE_NAMES ) == STAGE_MAX );
+	HELIUM_ASSERT( static_cast< size_t >( stage ) < static_cast< size_t >( STAGE_MAX ) );
+
+	return STAGE_NAMES[ stage ];
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/Name.h"
+#include "Engine/AssetPath.h"
+
+namespace Helium
+{
+	/// Recorder of the time each asset spends in each stage of the load process.
+	///
+	/// The asset loader and the package loaders record a span for every stage an asset goes through while recording is
+	/// enabled.  Spans can be summed up per asset type and stage with GetTypeStats(), or written out with WriteReport()
+	/// along with a waterfall of every asset load that can be viewed in chrome://tracing.
+	///
+	/// Recording takes a lock, so it is only meant to be enabled while measuring load performance.
+	class HELIUM_ENGINE_API AssetLoadTrace
+	{
+	public:
+		/// Load stages.
+		enum EStage
+		{
+			STAGE_FIRST   =  0,
+			STAGE_INVALID = -1,
+
+			/// Waiting on the asset data to be read from disk.
+			STAGE_IO_WAIT = STAGE_FIRST,
+			/// Deserializing the asset from its data.
+			STAGE_DESERIALIZE,
+			/// Resolving references to other assets.
+			STAGE_LINK,
+			/// Loading resource data (from the first attempt to its completion, so it includes I/O).
+			STAGE_PRECACHE,
+			/// Finalizing the load.
+			STAGE_FINALIZE,
+
+			STAGE_MAX,
+			STAGE_LAST = STAGE_MAX - 1
+		};
+
+		/// Recorded stage span.
+		struct Event
+		{
+			/// Asset path.
+			AssetPath path;
+			/// Load stage.
+			EStage stage;
+			/// Tick count when the stage began.
+			uint64_t startTicks;
+			/// Tick count when the stage ended.
+			uint64_t endTicks;
+		};
+
+		/// Time spent in each stage by all assets of a given type.
+		struct TypeStats
+		{
+			/// Asset type name (empty for assets that never reported a type, such as ones that failed to load).
+			Name typeName;
+			/// Number of assets of this type.
+			uint32_t assetCount;
+			/// Total ticks spent in each stage.
+			uint64_t stageTicks[ STAGE_MAX ];
+			/// Number of spans recorded for each stage.
+			uint32_t stageCounts[ STAGE_MAX ];
+		};
+
+		/// @name Recording
+		//@{
+		static void SetEnabled( bool bEnabled );
+		inline static bool IsEnabled();
+
+		static void RecordStage( EStage stage, AssetPath path, uint64_t startTicks, uint64_t endTicks );
+		static void SetAssetType( AssetPath path, Name typeName );
+
+		static void Clear();
+		//@}
+
+		/// @name Reading
+		//@{
+		static void GetEvents( DynamicArray< Event >& rEvents );
+		static void GetTypeStats( DynamicArray< TypeStats >& rStats );
+		static void GetLoadOrder( DynamicArray< AssetPath >& rPaths );
+		static bool WriteReport( const FilePath& rPath );
+
+		static const char* GetStageName( EStage stage );
+		//@}
+
+	private:
+		/// Non-zero while stages are recorded.
+		static volatile int32_t sm_enabled;
+	};
+}
+
+#include "Engine/AssetLoadTrace.inl"
@@ -0,0 +1,12 @@
+namespace Helium
+{
+	/// Get whether load stages are currently being recorded.
+	///
+	/// @return  True if recording, false if not.
+	///
+	/// @see SetEnabled()
+	bool AssetLoadTrace::IsEnabled()
+	{
+		return sm_enabled != 0;
+	}
+}
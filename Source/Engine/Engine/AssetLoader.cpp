@@ -1,10 +1,16 @@
 #include "Precompile.h"
 #include "Engine/AssetLoader.h"
 
+#include "Platform/Atomic.h"
 #include "Platform/Thread.h"
+#include "Platform/Timer.h"
 #include "Engine/Asset.h"
+#include "Engine/AsyncLoader.h"
 #include "Engine/PackageLoader.h"
 #include "Engine/FileLocations.h"
+#include "Engine/FrameProfiler.h"
+#include "Engine/AssetLoadTrace.h"
+#include "Engine/LoadStatistics.h"
 
 /// Asset cache name.
 
@@ -21,22 +27,44 @@ AssetTracker* AssetTracker::sm_pInstance = NULL;
 /// Constructor.
 AssetLoader::AssetLoader()
 : m_loadRequestPool( LOAD_REQUEST_POOL_BLOCK_SIZE )
+, m_workCondition( false, false )
+, m_pParallelFor( NULL )
+, m_parallelDepth( 0 )
+, m_tickBudgetMilliseconds( 0.0f )
+, m_tickBudgetTicks( 0 )
 {
+	MemoryZero( &m_lastTickStats, sizeof( m_lastTickStats ) );
+
+	// Wake anything waiting on load work whenever a read completes.
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	if( pAsyncLoader )
+	{
+		pAsyncLoader->SetCompletionCondition( &m_workCondition );
+	}
 }
 
 /// Destructor.
 AssetLoader::~AssetLoader()
 {
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	if( pAsyncLoader )
+	{
+		pAsyncLoader->SetCompletionCondition( NULL );
+	}
 }
 
 /// Begin asynchronous loading of an object.
 ///
-/// @param[in] path  Asset path.
+/// If a request for the object is already in progress, its priority is raised to the given priority if lower.
+///
+/// @param[in] path         Asset path.
+/// @param[in] forceReload  True to load the object again even if it is already loaded.
+/// @param[in] priority     Load priority.
 ///
 /// @return  ID for the load request if started successfully, invalid index if not.
 ///
 /// @see TryFinishLoad(), FinishLoad()
-size_t AssetLoader::BeginLoadObject( AssetPath path, bool forceReload )
+size_t AssetLoader::BeginLoadObject( AssetPath path, bool forceReload, EPriority priority )
 {
 	HELIUM_TRACE( TraceLevels::Info, " AssetLoader::BeginLoadObject - Loading path %s\n", *path.ToString() );
 	HELIUM_ASSERT( !path.GetName().IsEmpty() );
@@ -52,6 +80,8 @@ size_t AssetLoader::BeginLoadObject( AssetPath path, bool forceReload )
 		// We can release now, as the request shouldn't get released now that we've incremented its reference count.
 		requestConstAccessor.Release();
 
+		RaisePriority( pRequest, priority );
+
 		return m_loadRequestPool.GetIndex( pRequest );
 	}
 
@@ -102,13 +132,28 @@ size_t AssetLoader::BeginLoadObject( AssetPath path, bool forceReload )
 	HELIUM_ASSERT( !pRequest->spObject );
 	pRequest->spObject = pAsset;
 	pRequest->forceReload = forceReload;
+	pRequest->priority = priority;
+	pRequest->beginTicks = Timer::GetTickCount();
+	pRequest->precacheStartTicks = 0;
 
 	ConcurrentHashMap< AssetPath, LoadRequest* >::Accessor requestAccessor;
 	if( m_loadRequestMap.Insert( requestAccessor, KeyValue< AssetPath, LoadRequest* >( path, pRequest ) ) )
 	{
-		// New load request was created, so tick it once to get the load process running.
+		// New load request was created, so start its preload right away and queue it for Tick() to carry on with.
+		// Package loaders can only be updated from the thread calling Tick(), so requests begun by parallel load work
+		// wait for the next tick.
 		requestAccessor.Release();
-		TickLoadRequest( pRequest );
+		if( !pAsset )
+		{
+			LoadStatistics::AddCount( LoadStatistics::COUNTER_ASSET_LOADS_BEGUN );
+		}
+
+		if( !IsRunningParallel() )
+		{
+			TickLoadRequest( pRequest, TICK_FLAG_PRELOAD_ONLY );
+		}
+
+		QueueRequest( pRequest );
 	}
 	else
 	{
@@ -121,6 +166,8 @@ size_t AssetLoader::BeginLoadObject( AssetPath path, bool forceReload )
 
 		// We can release now, as the request shouldn't get released now that we've incremented its reference count.
 		requestAccessor.Release();
+
+		RaisePriority( pRequest, priority );
 	}
 
 	return m_loadRequestPool.GetIndex( pRequest );
@@ -173,6 +220,8 @@ bool AssetLoader::TryFinishLoad( size_t id, AssetPtr& rspObject )
 	int32_t newRequestCount = AtomicDecrementRelease( pRequest->requestCount );
 	if( newRequestCount == 0 )
 	{
+		HELIUM_ASSERT( pRequest->waiters.IsEmpty() );
+
 		pRequest->spObject.Release();
 		pRequest->resolver.Clear();
 
@@ -197,7 +246,8 @@ bool AssetLoader::TryFinishLoad( size_t id, AssetPtr& rspObject )
 
 /// Block the current thread while waiting for an object load request or package pre-load request to complete.
 ///
-/// Note that after a load request has completed, the request ID will no longer be valid.
+/// Note that after a load request has completed, the request ID will no longer be valid.  As the caller is blocking
+/// on it, the request is raised to PRIORITY_HIGH so that the tick budget does not hold it back.
 ///
 /// @param[in]  id         Load request ID.
 /// @param[out] rspObject  Smart pointer set to the loaded object if loading has completed.  If the object failed to
@@ -206,6 +256,12 @@ bool AssetLoader::TryFinishLoad( size_t id, AssetPtr& rspObject )
 /// @see TryFinishLoad(), BeginLoadObject(), BeginPreloadPackage()
 void AssetLoader::FinishLoad( size_t id, AssetPtr& rspObject )
 {
+	HELIUM_ASSERT( IsValid( id ) );
+
+	LoadRequest* pRequest = m_loadRequestPool.GetObject( id );
+	HELIUM_ASSERT( pRequest );
+	RaisePriority( pRequest, PRIORITY_HIGH );
+
 	while( !TryFinishLoad( id, rspObject ) )
 	{
 		Tick();
@@ -262,66 +318,377 @@ bool AssetLoader::CacheObject( Asset* /*pObject*/, bool /*bEvictPlatformPreproce
 	// Caching only supported when using the editor object loader.
 	return false;
 }
+
+/// Queue an asset to be loaded again, such as after its file has been changed by another program.
+///
+/// This may be called from any thread.  The asset is reloaded in the background by the following ticks, and once the
+/// new instance is fully loaded (including its resource data) it replaces the existing one in place (see
+/// Asset::ReplaceAsset()), after which AssetTracker::e_AssetChangedExternally is raised.  Assets that are not loaded
+/// are left alone, as loading them will read the changed file anyway.
+///
+/// @param[in] path  Path of the asset to reload.
+void AssetLoader::QueueHotReload( AssetPath path )
+{
+	HELIUM_ASSERT( !path.IsEmpty() );
+
+	{
+		MutexScopeLock scopeLock( m_hotReloadLock );
+		m_queuedHotReloads.Push( path );
+	}
+
+	m_workCondition.Signal();
+}
 #endif  // HELIUM_TOOLS
 
 /// Update object loading.
+///
+/// Requests are updated from the highest priority down.  Once the tick budget has been used up, requests below
+/// PRIORITY_HIGH are left where they are until the next tick.
+///
+/// @see SetTickBudget()
 void AssetLoader::Tick()
 {
+	HELIUM_FRAME_PROFILER_SCOPE( "AssetLoader::Tick" );
+
 	// Tick package loaders first.
 	TickPackageLoaders();
 
-	// Build the list of object load requests to update this tick, incrementing the request count on each to prevent
-	// them from being released while we don't have a lock on the request hash map.
-	//HELIUM_ASSERT( m_loadRequestTickArray.IsEmpty() );
-	/// List of load requests to update in the current tick.
-	DynamicArray< LoadRequest* > m_loadRequestTickArray;
+#if HELIUM_TOOLS
+	TickHotReloads();
+#endif
+
+	uint64_t startTickCount = Timer::GetTickCount();
+	size_t tickedRequestCount = 0;
+
+	TickStats stats;
+	MemoryZero( &stats, sizeof( stats ) );
+
+	// Pick up requests begun or woken since the last tick, and move requests whose priority has been raised to the
+	// matching list.  Priorities are only ever raised, so a single pass from the lowest priority up is enough.
+	{
+		MutexScopeLock scopeLock( m_queuedRequestLock );
+
+		size_t queuedRequestCount = m_queuedRequests.GetSize();
+		stats.queuedRequestCount = queuedRequestCount;
+		for( size_t queuedRequestIndex = 0; queuedRequestIndex < queuedRequestCount; ++queuedRequestIndex )
+		{
+			LoadRequest* pRequest = m_queuedRequests[ queuedRequestIndex ];
+			HELIUM_ASSERT( pRequest );
+			m_activeRequests[ pRequest->priority ].Push( pRequest );
+		}
+
+		m_queuedRequests.Resize( 0 );
+
+		for( int32_t priority = PRIORITY_FIRST; priority < PRIORITY_LAST; ++priority )
+		{
+			DynamicArray< LoadRequest* >& rActiveRequests = m_activeRequests[ priority ];
+
+			size_t requestIndex = 0;
+			while( requestIndex < rActiveRequests.GetSize() )
+			{
+				LoadRequest* pRequest = rActiveRequests[ requestIndex ];
+				HELIUM_ASSERT( pRequest );
+				if( pRequest->priority == priority )
+				{
+					++requestIndex;
+
+					continue;
+				}
+
+				rActiveRequests.RemoveSwap( requestIndex );
+				m_activeRequests[ pRequest->priority ].Push( pRequest );
+			}
+		}
+	}
+
+	// Update each request up to the point where it can be linked.  Requests waiting on other requests are parked
+	// with them and drop out of the active lists until woken, keeping their tick reference in the meantime.
+	HELIUM_ASSERT( m_linkRequests.IsEmpty() );
 
-	ConcurrentHashMap< AssetPath, LoadRequest* >::ConstAccessor loadRequestConstAccessor;
-	if( m_loadRequestMap.First( loadRequestConstAccessor ) )
+	for( int32_t priority = PRIORITY_LAST; priority >= PRIORITY_FIRST; --priority )
 	{
-		do
+		DynamicArray< LoadRequest* >& rActiveRequests = m_activeRequests[ priority ];
+
+		size_t requestIndex = 0;
+		while( requestIndex < rActiveRequests.GetSize() &&
+			!IsTickBudgetExhausted( startTickCount, priority, tickedRequestCount ) )
 		{
-			LoadRequest* pRequest = loadRequestConstAccessor->Second();
+			LoadRequest* pRequest = rActiveRequests[ requestIndex ];
 			HELIUM_ASSERT( pRequest );
-			AtomicIncrementUnsafe( pRequest->requestCount );
-			m_loadRequestTickArray.Add( pRequest );
 
-			++loadRequestConstAccessor;
-		} while( loadRequestConstAccessor.IsValid() );
+			ETickResult result = TickLoadRequest( pRequest, TICK_FLAG_DEFER_LINK );
+			++tickedRequestCount;
+			if( result == TICK_RESULT_PENDING )
+			{
+				++requestIndex;
+
+				continue;
+			}
+
+			rActiveRequests.RemoveSwap( requestIndex );
+
+			if( result == TICK_RESULT_LINK_READY )
+			{
+				m_linkRequests.Push( pRequest );
+			}
+			else if( result == TICK_RESULT_COMPLETE )
+			{
+				ReleaseTickReference( pRequest );
+				++stats.completedRequestCount;
+			}
+			else if( result == TICK_RESULT_BLOCKED )
+			{
+				++stats.blockedRequestCount;
+			}
+		}
+	}
+
+	// Apply the reference fixups of every request ready to link, splitting requests with many references into
+	// several ranges of work.  The targets of each request were looked up when it was found ready to link, so the
+	// ranges only write object references and can be applied in any order.
+	HELIUM_ASSERT( m_linkWork.IsEmpty() );
+
+	size_t linkRequestCount = m_linkRequests.GetSize();
+	stats.linkedRequestCount = linkRequestCount;
+	for( size_t linkRequestIndex = 0; linkRequestIndex < linkRequestCount; ++linkRequestIndex )
+	{
+		LoadRequest* pRequest = m_linkRequests[ linkRequestIndex ];
+		HELIUM_ASSERT( pRequest );
+		if( !pRequest->spObject.ReferencesObject() )
+		{
+			continue;
+		}
+
+		size_t fixupCount = pRequest->resolver.GetFixupCount();
+		for( size_t fixupStart = 0; fixupStart < fixupCount; fixupStart += LINK_WORK_FIXUP_COUNT )
+		{
+			LinkWork* pWork = m_linkWork.New();
+			HELIUM_ASSERT( pWork );
+			pWork->pRequest = pRequest;
+			pWork->fixupStart = fixupStart;
+			pWork->fixupCount = Min( fixupCount - fixupStart, static_cast< size_t >( LINK_WORK_FIXUP_COUNT ) );
+		}
 	}
 
-	// Tick object load requests.
-	size_t loadRequestCount = m_loadRequestTickArray.GetSize();
-	for( size_t requestIndex = 0; requestIndex < loadRequestCount; ++requestIndex )
+	uint64_t linkStartTicks = ( AssetLoadTrace::IsEnabled() ? Timer::GetTickCount() : 0 );
+	RunParallel( LinkCallback, this, m_linkWork.GetSize() );
+	m_linkWork.Resize( 0 );
+
+	// All fixups have been applied once RunParallel() returns, so the requests can be marked as linked and carried on
+	// through precaching and load finalization on this thread, as those steps may create resources tied to it.  The
+	// link list is already in priority order, and requests the budget no longer covers wait in their active list for
+	// the next tick.
+	for( size_t linkRequestIndex = 0; linkRequestIndex < linkRequestCount; ++linkRequestIndex )
 	{
-		LoadRequest* pRequest = m_loadRequestTickArray[ requestIndex ];
+		FinishLink( m_linkRequests[ linkRequestIndex ], linkStartTicks );
+	}
+
+	for( size_t linkRequestIndex = 0; linkRequestIndex < linkRequestCount; ++linkRequestIndex )
+	{
+		LoadRequest* pRequest = m_linkRequests[ linkRequestIndex ];
 		HELIUM_ASSERT( pRequest );
 
-		TickLoadRequest( pRequest );
+		int32_t priority = pRequest->priority;
+		if( IsTickBudgetExhausted( startTickCount, priority, tickedRequestCount ) )
+		{
+			m_activeRequests[ priority ].Push( pRequest );
 
-		int32_t newRequestCount = AtomicDecrementRelease( pRequest->requestCount );
-		if( newRequestCount == 0 )
+			continue;
+		}
+
+		ETickResult result = TickLoadRequest( pRequest );
+		++tickedRequestCount;
+		if( result == TICK_RESULT_PENDING )
 		{
-			ConcurrentHashMap< AssetPath, LoadRequest* >::Accessor loadRequestAccessor;
-			if( m_loadRequestMap.Find( loadRequestAccessor, pRequest->path ) )
-			{
-				pRequest = loadRequestAccessor->Second();
-				HELIUM_ASSERT( pRequest );
-				if( pRequest->requestCount == 0 )
-				{
-					HELIUM_ASSERT( ( pRequest->stateFlags & LOAD_FLAG_FULLY_LOADED ) == LOAD_FLAG_FULLY_LOADED );
+			m_activeRequests[ priority ].Push( pRequest );
+		}
+		else if( result == TICK_RESULT_COMPLETE )
+		{
+			ReleaseTickReference( pRequest );
+			++stats.completedRequestCount;
+		}
+		else if( result == TICK_RESULT_BLOCKED )
+		{
+			++stats.blockedRequestCount;
+		}
+	}
 
-					pRequest->spObject.Release();
-					pRequest->resolver.Clear();
+	m_linkRequests.Resize( 0 );
 
-					m_loadRequestMap.Remove( loadRequestAccessor );
-					m_loadRequestPool.Release( pRequest );
-				}
+	// Count the requests left for the next tick by the stage they are waiting on (requests parked with other requests
+	// are left out until woken).
+	int64_t stageCounts[ LoadStatistics::GAUGE_MAX ] = {};
+
+	stats.updatedRequestCount = tickedRequestCount;
+	for( int32_t priority = PRIORITY_FIRST; priority < PRIORITY_MAX; ++priority )
+	{
+		const DynamicArray< LoadRequest* >& rActiveRequests = m_activeRequests[ priority ];
+		size_t activeRequestCount = rActiveRequests.GetSize();
+		stats.activeRequestCount += activeRequestCount;
+
+		for( size_t requestIndex = 0; requestIndex < activeRequestCount; ++requestIndex )
+		{
+			int32_t stateFlags = rActiveRequests[ requestIndex ]->stateFlags;
+			if( !( stateFlags & LOAD_FLAG_PRELOADED ) )
+			{
+				++stageCounts[ LoadStatistics::GAUGE_ASSETS_PRELOADING ];
+			}
+			else if( !( stateFlags & LOAD_FLAG_LINKED ) )
+			{
+				++stageCounts[ LoadStatistics::GAUGE_ASSETS_LINKING ];
 			}
+			else if( !( stateFlags & LOAD_FLAG_PRECACHED ) )
+			{
+				++stageCounts[ LoadStatistics::GAUGE_ASSETS_PRECACHING ];
+			}
+			else if( !( stateFlags & LOAD_FLAG_LOADED ) )
+			{
+				++stageCounts[ LoadStatistics::GAUGE_ASSETS_FINALIZING ];
+			}
+		}
+	}
+
+	for( int32_t gauge = LoadStatistics::GAUGE_ASSETS_PRELOADING;
+		gauge <= LoadStatistics::GAUGE_ASSETS_FINALIZING;
+		++gauge )
+	{
+		LoadStatistics::SetGauge( static_cast< LoadStatistics::EGauge >( gauge ), stageCounts[ gauge ] );
+	}
+
+	m_lastTickStats = stats;
+}
+
+/// Set the time Tick() may spend updating requests below PRIORITY_HIGH.
+///
+/// Package loader updates and PRIORITY_HIGH requests are not limited by the budget, and at least one request is
+/// updated each tick regardless.
+///
+/// @param[in] milliseconds  Tick budget in milliseconds, or zero for no limit.
+///
+/// @see GetTickBudget()
+void AssetLoader::SetTickBudget( float32_t milliseconds )
+{
+	HELIUM_ASSERT( milliseconds >= 0.0f );
+
+	m_tickBudgetMilliseconds = milliseconds;
+	m_tickBudgetTicks = static_cast< uint64_t >(
+		static_cast< float64_t >( milliseconds ) * 0.001 * static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+	if( milliseconds > 0.0f && m_tickBudgetTicks == 0 )
+	{
+		m_tickBudgetTicks = 1;
+	}
+}
+
+/// Get whether any load work remains for Tick() to carry on with.
+///
+/// This includes requests waiting on I/O or their package loader, requests queued or woken since the last tick, and
+/// hot reloads in progress.  Requests parked with other requests are not counted, as they are woken (and queued) once
+/// the requests they wait on make progress.  This may only be called from the thread calling Tick().
+///
+/// @return  True if load work is pending, false if the loader is idle.
+///
+/// @see WaitForWork()
+bool AssetLoader::HasPendingWork()
+{
+	for( int32_t priority = PRIORITY_FIRST; priority < PRIORITY_MAX; ++priority )
+	{
+		if( !m_activeRequests[ priority ].IsEmpty() )
+		{
+			return true;
+		}
+	}
+
+#if HELIUM_TOOLS
+	if( !m_hotReloads.IsEmpty() )
+	{
+		return true;
+	}
+
+	{
+		MutexScopeLock scopeLock( m_hotReloadLock );
+		if( !m_queuedHotReloads.IsEmpty() )
+		{
+			return true;
+		}
+	}
+#endif
+
+	MutexScopeLock scopeLock( m_queuedRequestLock );
+
+	return !m_queuedRequests.IsEmpty();
+}
+
+/// Block the calling thread until new load work may be available or a timeout elapses.
+///
+/// The wait ends as soon as a request is begun or woken, a hot reload is queued, an AsyncLoader read completes, or
+/// SignalWork() is called.  Signals raised while no thread was waiting are not lost, so the next call returns
+/// immediately.  Progress that is not signaled (such as resource precaching waiting on other systems) is only picked
+/// up once the timeout elapses, so callers should pass a short timeout while HasPendingWork() returns true.
+///
+/// @param[in] timeoutMilliseconds  Maximum time to wait, in milliseconds.
+///
+/// @return  True if the wait was ended by a signal, false if it timed out.
+///
+/// @see HasPendingWork(), SignalWork()
+bool AssetLoader::WaitForWork( uint32_t timeoutMilliseconds )
+{
+	return m_workCondition.Wait( timeoutMilliseconds );
+}
+
+/// Wake the thread waiting in WaitForWork(), such as to have it check whether it should shut down.
+///
+/// @see WaitForWork()
+void AssetLoader::SignalWork()
+{
+	m_workCondition.Signal();
+}
+
+/// Set the function used to run load work in parallel.
+///
+/// @param[in] pParallelFor  Parallel-for function, or null to run all load work on the thread calling Tick().
+///
+/// @see RunParallel()
+void AssetLoader::SetParallelFor( ASSET_LOAD_PARALLEL_FOR pParallelFor )
+{
+	HELIUM_ASSERT( !IsRunningParallel() );
+
+	m_pParallelFor = pParallelFor;
+}
+
+/// Run a callback for each index in [0, count), in parallel if a parallel-for function has been set.
+///
+/// This may only be called from the thread calling Tick().  The callback must not update package loaders or load
+/// requests itself, though it may begin new load requests (which are queued until the next tick).
+///
+/// @param[in] pCallback  Callback to run for each index.
+/// @param[in] pContext   Context passed to the callback.
+/// @param[in] count      Number of indices to process.
+///
+/// @see SetParallelFor(), IsRunningParallel()
+void AssetLoader::RunParallel( ASSET_LOAD_WORK_CALLBACK pCallback, void* pContext, size_t count )
+{
+	HELIUM_ASSERT( pCallback );
+
+	if( count == 0 )
+	{
+		return;
+	}
+
+	AtomicIncrementAcquire( m_parallelDepth );
+
+	if( m_pParallelFor && count > 1 )
+	{
+		m_pParallelFor( pCallback, pContext, count );
+	}
+	else
+	{
+		for( size_t index = 0; index < count; ++index )
+		{
+			pCallback( pContext, index );
 		}
 	}
 
-	//m_loadRequestTickArray.Resize( 0 );
+	AtomicDecrementRelease( m_parallelDepth );
 }
 
 /// Get the global object loader instance.
@@ -381,10 +748,11 @@ void AssetLoader::OnLoadComplete( const AssetPath & /*path*/, Asset* /*pObject*/
 
 /// Update the given load request.
 ///
-/// @param[in] pRequest  Load request to update.
+/// @param[in] pRequest   Load request to update.
+/// @param[in] tickFlags  Combination of ETickFlag values.
 ///
-/// @return  True if the load request has completed, false if it still requires time to process.
-bool AssetLoader::TickLoadRequest( LoadRequest* pRequest )
+/// @return  Where the load request stands once updated.
+AssetLoader::ETickResult AssetLoader::TickLoadRequest( LoadRequest* pRequest, uint32_t tickFlags )
 {
 	HELIUM_ASSERT( pRequest );
 
@@ -396,7 +764,7 @@ bool AssetLoader::TickLoadRequest( LoadRequest* pRequest )
 	{ \
 	if( AtomicOrAcquire( pRequest->stateFlags, LOAD_FLAG_IN_TICK ) & LOAD_FLAG_IN_TICK ) \
 	{ \
-	return false; \
+	return TICK_RESULT_PENDING; \
 	} \
 	\
 	bLockedTick = true; \
@@ -412,39 +780,69 @@ bool AssetLoader::TickLoadRequest( LoadRequest* pRequest )
 		{
 			UNLOCK_TICK();
 
-			return false;
+			return TICK_RESULT_PENDING;
 		}
 		else
 		{
 			HELIUM_ASSERT( !pRequest->spObject.Get() || (pRequest->spObject->GetFlags() & Asset::FLAG_PRELOADED) );
 		}
+
+		WakeWaiters( pRequest );
+	}
+
+	if( tickFlags & TICK_FLAG_PRELOAD_ONLY )
+	{
+		if( bLockedTick )
+		{
+			UNLOCK_TICK();
+		}
+
+		return ( ( pRequest->stateFlags & LOAD_FLAG_FULLY_LOADED ) == LOAD_FLAG_FULLY_LOADED
+			? TICK_RESULT_COMPLETE
+			: TICK_RESULT_PENDING );
 	}
 
 	if( !( pRequest->stateFlags & LOAD_FLAG_LINKED ) )
 	{
 		LOCK_TICK();
 
-		if( !TickLink( pRequest ) )
+		size_t blockingLoadRequestId;
+		if( pRequest->spObject.ReferencesObject() && !pRequest->resolver.ReadyToApplyFixups( blockingLoadRequestId ) )
 		{
 			UNLOCK_TICK();
 
-			return false;
+			return ParkRequest( pRequest, blockingLoadRequestId, LOAD_FLAG_PRELOADED );
 		}
-		else
+
+		if( tickFlags & TICK_FLAG_DEFER_LINK )
 		{
-			HELIUM_ASSERT( !pRequest->spObject.Get() || pRequest->spObject->GetFlags() & Asset::FLAG_LINKED );
+			UNLOCK_TICK();
+
+			return TICK_RESULT_LINK_READY;
 		}
+
+		TickLink( pRequest );
+		HELIUM_ASSERT( !pRequest->spObject.Get() || pRequest->spObject->GetFlags() & Asset::FLAG_LINKED );
 	}
 
 	if( !( pRequest->stateFlags & LOAD_FLAG_PRECACHED ) )
 	{
 		LOCK_TICK();
 
+		size_t blockingLoadRequestId;
+		if( pRequest->spObject.ReferencesObject() &&
+			!pRequest->resolver.TryFinishPrecachingDependencies( blockingLoadRequestId ) )
+		{
+			UNLOCK_TICK();
+
+			return ParkRequest( pRequest, blockingLoadRequestId, LOAD_FLAG_LOADED );
+		}
+
 		if( !TickPrecache( pRequest ) )
 		{
 			UNLOCK_TICK();
 
-			return false;
+			return TICK_RESULT_PENDING;
 		}
 		else
 		{
@@ -460,12 +858,14 @@ bool AssetLoader::TickLoadRequest( LoadRequest* pRequest )
 		{
 			UNLOCK_TICK();
 
-			return false;
+			return TICK_RESULT_PENDING;
 		}
 		else
 		{
 			HELIUM_ASSERT( !pRequest->spObject.Get() ||  pRequest->spObject->GetFlags() & Asset::FLAG_LOADED );
 		}
+
+		WakeWaiters( pRequest );
 	}
 
 	if( bLockedTick )
@@ -476,7 +876,7 @@ bool AssetLoader::TickLoadRequest( LoadRequest* pRequest )
 #undef LOCK_TICK
 #undef UNLOCK_TICK
 
-	return true;
+	return TICK_RESULT_COMPLETE;
 }
 
 /// Update property preloading for the given object load request.
@@ -548,37 +948,64 @@ bool AssetLoader::TickPreload( LoadRequest* pRequest )
 	// Preload complete.
 	SetInvalid( pRequest->packageLoadRequestId );
 
+	if( AssetLoadTrace::IsEnabled() && pRequest->spObject )
+	{
+		const Reflect::MetaClass* pMetaClass = pRequest->spObject->GetMetaClass();
+		HELIUM_ASSERT( pMetaClass );
+		AssetLoadTrace::SetAssetType( pRequest->path, Name( pMetaClass->m_Name ) );
+	}
+
 	AtomicOrRelease( pRequest->stateFlags, LOAD_FLAG_PRELOADED );
 
 	return true;
 }
 
-/// Update object reference linking for the given object load request.
+/// Apply the object reference fixups for the given object load request.
+///
+/// All requests referenced by the fixups must already be preloaded.  Tick() applies the fixups of the requests it
+/// links itself, in parallel, and only calls FinishLink() for them.
 ///
 /// @param[in] pRequest  Load request to update.
 ///
-/// @return  True if linking still requires processing, false if it is complete.
-bool AssetLoader::TickLink( LoadRequest* pRequest )
+/// @see FinishLink()
+void AssetLoader::TickLink( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+
+	uint64_t startTicks = AssetLoadTrace::IsEnabled() ? Timer::GetTickCount() : 0;
+
+	if ( pRequest->spObject.ReferencesObject() )
+	{
+		pRequest->resolver.ApplyFixups( 0, pRequest->resolver.GetFixupCount() );
+	}
+
+	FinishLink( pRequest, startTicks );
+}
+
+/// Mark an object load request as linked once all of its reference fixups have been applied.
+///
+/// @param[in] pRequest    Load request to update.
+/// @param[in] startTicks  Tick count when fixups started being applied (only set while the load trace is enabled).
+///
+/// @see TickLink()
+void AssetLoader::FinishLink( LoadRequest* pRequest, uint64_t startTicks )
 {
 	HELIUM_ASSERT( pRequest );
 	HELIUM_ASSERT( !( pRequest->stateFlags & ( LOAD_FLAG_PRECACHED | LOAD_FLAG_LOADED ) ) );
 
 	if ( pRequest->spObject.ReferencesObject() )
 	{
-		if( !pRequest->resolver.ReadyToApplyFixups() )
-		{
-			return false;
-		}
-		
-		HELIUM_TRACE( TraceLevels::Info, "Resolving references for %s\n", *pRequest->path.ToString());
+		HELIUM_TRACE( TraceLevels::Info, "Resolved references for %s\n", *pRequest->path.ToString());
 
-		pRequest->resolver.ApplyFixups();
 		pRequest->spObject->SetFlags( Asset::FLAG_LINKED );
+
+		if( startTicks != 0 )
+		{
+			AssetLoadTrace::RecordStage( AssetLoadTrace::STAGE_LINK, pRequest->path, startTicks, Timer::GetTickCount() );
+		}
 	}
 
 	AtomicOrRelease( pRequest->stateFlags, LOAD_FLAG_LINKED );
-
-	return true;
 }
 
 /// Update resource precaching for the given object load request.
@@ -594,12 +1021,12 @@ bool AssetLoader::TickPrecache( LoadRequest* pRequest )
 	Asset* pAsset = pRequest->spObject;
 	if( pAsset )
 	{
-		// TODO: SHouldn't this be in the linking phase?
-		if ( !pRequest->resolver.TryFinishPrecachingDependencies() )
+		if( AssetLoadTrace::IsEnabled() && pRequest->precacheStartTicks == 0 )
 		{
-			return false;
+			pRequest->precacheStartTicks = Timer::GetTickCount();
 		}
 
+		// Dependencies have been fully loaded by this point (see TickLoadRequest()).
 		pRequest->resolver.Clear();
 
 		// Perform any pre-precaching work (note that we don't precache anything for the default template object for
@@ -635,6 +1062,15 @@ bool AssetLoader::TickPrecache( LoadRequest* pRequest )
 		}
 
 		pAsset->SetFlags( Asset::FLAG_PRECACHED );
+
+		if( pRequest->precacheStartTicks != 0 )
+		{
+			AssetLoadTrace::RecordStage(
+				AssetLoadTrace::STAGE_PRECACHE,
+				pRequest->path,
+				pRequest->precacheStartTicks,
+				Timer::GetTickCount() );
+		}
 	}
 
 	AtomicOrRelease( pRequest->stateFlags, LOAD_FLAG_PRECACHED );
@@ -654,17 +1090,273 @@ bool AssetLoader::TickFinalizeLoad( LoadRequest* pRequest )
 	Asset* pObject = pRequest->spObject;
 	if( pObject )
 	{
+		uint64_t startTicks = AssetLoadTrace::IsEnabled() ? Timer::GetTickCount() : 0;
+
 		pObject->ConditionalFinalizeLoad();
+
+		if( startTicks != 0 )
+		{
+			AssetLoadTrace::RecordStage( AssetLoadTrace::STAGE_FINALIZE, pRequest->path, startTicks, Timer::GetTickCount() );
+		}
 	}
 
 	// Loading now complete.
 	OnLoadComplete( pRequest->path, pObject, pRequest->pPackageLoader );
 	AtomicOrRelease( pRequest->stateFlags, LOAD_FLAG_LOADED );
 
+	LoadStatistics::AddCount( LoadStatistics::COUNTER_ASSET_LOADS_COMPLETED );
+	LoadStatistics::AddCount( LoadStatistics::COUNTER_ASSET_LOAD_TICKS, Timer::GetTickCount() - pRequest->beginTicks );
+
 	return true;
 }
 
+/// Test whether the current tick has used up its budget for requests of the given priority.
+///
+/// @param[in] startTickCount      Timer tick count when request updates started for the current tick.
+/// @param[in] priority            Priority of the request about to be updated.
+/// @param[in] tickedRequestCount  Number of requests updated so far in the current tick.
+///
+/// @return  True if the request should be left for the next tick, false if it can be updated.
+bool AssetLoader::IsTickBudgetExhausted( uint64_t startTickCount, int32_t priority, size_t tickedRequestCount ) const
+{
+	if( m_tickBudgetTicks == 0 || priority >= PRIORITY_HIGH || tickedRequestCount == 0 )
+	{
+		return false;
+	}
+
+	return ( Timer::GetTickCount() - startTickCount >= m_tickBudgetTicks );
+}
+
+/// Queue a new load request to be updated by Tick(), unless it has already completed.
+///
+/// @param[in] pRequest  Load request to queue.
+void AssetLoader::QueueRequest( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+
+	if( ( pRequest->stateFlags & LOAD_FLAG_FULLY_LOADED ) == LOAD_FLAG_FULLY_LOADED )
+	{
+		return;
+	}
+
+	// The queue holds a reference until Tick() is done with the request.
+	AtomicIncrementRelease( pRequest->requestCount );
+
+	{
+		MutexScopeLock scopeLock( m_queuedRequestLock );
+		m_queuedRequests.Push( pRequest );
+	}
+
+	m_workCondition.Signal();
+}
+
+/// Raise the priority of a load request, leaving it as is if it already has the given priority or higher.
+///
+/// Tick() moves the request to the list for its new priority the next time it runs.
+///
+/// @param[in] pRequest  Load request to update.
+/// @param[in] priority  Priority to raise the request to.
+void AssetLoader::RaisePriority( LoadRequest* pRequest, int32_t priority )
+{
+	HELIUM_ASSERT( pRequest );
+	HELIUM_ASSERT( static_cast< uint32_t >( priority ) < static_cast< uint32_t >( PRIORITY_MAX ) );
+
+	MutexScopeLock scopeLock( m_queuedRequestLock );
+	if( pRequest->priority < priority )
+	{
+		pRequest->priority = priority;
+	}
+}
+
+/// Park a load request with the request it is waiting on, so that it is not updated again until that request has
+/// made progress.  The blocking request inherits the priority of the parked request if it is higher.
+///
+/// @param[in] pRequest               Load request to park.  Its tick reference stays with it while it is parked.
+/// @param[in] blockingLoadRequestId  ID of the load request being waited on.
+/// @param[in] waitFlag               Load flag the blocking request must set before the request can continue.
+///
+/// @return  TICK_RESULT_BLOCKED if the request was parked, or TICK_RESULT_PENDING if the blocking request has set the
+///          flag in the meantime (in which case the request can simply be updated again).
+AssetLoader::ETickResult AssetLoader::ParkRequest(
+	LoadRequest* pRequest,
+	size_t blockingLoadRequestId,
+	int32_t waitFlag )
+{
+	HELIUM_ASSERT( pRequest );
+
+	LoadRequest* pBlockingRequest = m_loadRequestPool.GetObject( blockingLoadRequestId );
+	HELIUM_ASSERT( pBlockingRequest );
+
+	// Flags are set before waiters are woken, so checking under the lock cannot miss a wake-up.
+	MutexScopeLock scopeLock( m_queuedRequestLock );
+	if( pBlockingRequest->stateFlags & waitFlag )
+	{
+		return TICK_RESULT_PENDING;
+	}
+
+	pBlockingRequest->waiters.Push( pRequest );
+	if( pBlockingRequest->priority < pRequest->priority )
+	{
+		pBlockingRequest->priority = pRequest->priority;
+	}
+
+	return TICK_RESULT_BLOCKED;
+}
+
+/// Queue all load requests parked with the given request so that Tick() updates them again.
+///
+/// @param[in] pRequest  Load request that has made progress.
+void AssetLoader::WakeWaiters( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+
+	{
+		MutexScopeLock scopeLock( m_queuedRequestLock );
+		if( pRequest->waiters.IsEmpty() )
+		{
+			return;
+		}
+
+		m_queuedRequests.AddArray( pRequest->waiters.GetData(), pRequest->waiters.GetSize() );
+		pRequest->waiters.Resize( 0 );
+	}
+
+	m_workCondition.Signal();
+}
+
+/// Drop the reference held on a load request by Tick(), releasing the request if nothing else refers to it.
+///
+/// @param[in] pRequest  Load request Tick() is done with.
+void AssetLoader::ReleaseTickReference( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+
+	int32_t newRequestCount = AtomicDecrementRelease( pRequest->requestCount );
+	if( newRequestCount == 0 )
+	{
+		ConcurrentHashMap< AssetPath, LoadRequest* >::Accessor loadRequestAccessor;
+		if( m_loadRequestMap.Find( loadRequestAccessor, pRequest->path ) )
+		{
+			pRequest = loadRequestAccessor->Second();
+			HELIUM_ASSERT( pRequest );
+			if( pRequest->requestCount == 0 )
+			{
+				HELIUM_ASSERT( ( pRequest->stateFlags & LOAD_FLAG_FULLY_LOADED ) == LOAD_FLAG_FULLY_LOADED );
+				HELIUM_ASSERT( pRequest->waiters.IsEmpty() );
+
+				pRequest->spObject.Release();
+				pRequest->resolver.Clear();
+
+				m_loadRequestMap.Remove( loadRequestAccessor );
+				m_loadRequestPool.Release( pRequest );
+			}
+		}
+	}
+}
+
+/// RunParallel() callback applying one range of reference fixups of the requests in the current tick's link list.
+///
+/// @param[in] pContext  Asset loader.
+/// @param[in] index     Index of the fixup range in the link work list.
+void AssetLoader::LinkCallback( void* pContext, size_t index )
+{
+	AssetLoader* pAssetLoader = static_cast< AssetLoader* >( pContext );
+	HELIUM_ASSERT( pAssetLoader );
+	HELIUM_ASSERT( index < pAssetLoader->m_linkWork.GetSize() );
+
+	const LinkWork& rWork = pAssetLoader->m_linkWork[ index ];
+	rWork.pRequest->resolver.ApplyFixups( rWork.fixupStart, rWork.fixupCount );
+}
+
 #if HELIUM_TOOLS
+/// Swap in the assets of completed hot reloads and begin reloading the assets queued since the last tick.
+///
+/// @see QueueHotReload()
+void AssetLoader::TickHotReloads()
+{
+	size_t hotReloadIndex = 0;
+	while( hotReloadIndex < m_hotReloads.GetSize() )
+	{
+		HotReload& rHotReload = m_hotReloads[ hotReloadIndex ];
+
+		AssetPtr spNewAsset;
+		if( !TryFinishLoad( rHotReload.loadId, spNewAsset ) )
+		{
+			++hotReloadIndex;
+
+			continue;
+		}
+
+		Asset* pOldAsset = Asset::FindObject( rHotReload.path );
+		if( !spNewAsset || spNewAsset->GetAnyFlagSet( Asset::FLAG_BROKEN ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"AssetLoader: Failed to reload \"%s\"; the loaded instance will be kept.\n",
+				*rHotReload.path.ToString() );
+		}
+		else if( pOldAsset && pOldAsset != spNewAsset.Get() )
+		{
+			Asset::ReplaceAsset( spNewAsset.Get(), rHotReload.path );
+			AssetTracker::GetInstance()->NotifyAssetReloaded( spNewAsset.Get() );
+		}
+
+		m_hotReloads.RemoveSwap( hotReloadIndex );
+	}
+
+	MutexScopeLock scopeLock( m_hotReloadLock );
+
+	size_t queuedIndex = 0;
+	while( queuedIndex < m_queuedHotReloads.GetSize() )
+	{
+		AssetPath path = m_queuedHotReloads[ queuedIndex ];
+
+		// A reload still in progress may have read the file before its latest change, so leave the path queued until
+		// that reload has been swapped in.
+		bool bReloading = false;
+		size_t hotReloadCount = m_hotReloads.GetSize();
+		for( hotReloadIndex = 0; hotReloadIndex < hotReloadCount; ++hotReloadIndex )
+		{
+			if( m_hotReloads[ hotReloadIndex ].path == path )
+			{
+				bReloading = true;
+
+				break;
+			}
+		}
+
+		if( bReloading )
+		{
+			++queuedIndex;
+
+			continue;
+		}
+
+		m_queuedHotReloads.RemoveSwap( queuedIndex );
+
+		Asset* pAsset = Asset::FindObject( path );
+		if( !pAsset || !pAsset->IsFullyLoaded() )
+		{
+			continue;
+		}
+
+		size_t loadId = BeginLoadObject( path, true, PRIORITY_LOW );
+		if( IsInvalid( loadId ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"AssetLoader: Failed to begin reloading \"%s\".\n",
+				*path.ToString() );
+
+			continue;
+		}
+
+		HotReload& rHotReload = *m_hotReloads.New();
+		rHotReload.path = path;
+		rHotReload.loadId = loadId;
+	}
+}
+
 
 void AssetLoader::EnumerateRootPackages( DynamicArray< AssetPath > &packagePaths )
 {
@@ -682,8 +1374,24 @@ int64_t AssetLoader::GetAssetFileTimestamp( const AssetPath &path )
 	return pLoader->GetAssetFileSystemTimestamp( path );
 }
 
+const FilePath& AssetLoader::GetAssetFilePath( const AssetPath &path )
+{
+	Package *pPackage = Asset::Find<Package>( path.GetParentPackage() );
+	HELIUM_ASSERT( pPackage );
+
+	PackageLoader *pLoader = pPackage->GetLoader();
+	HELIUM_ASSERT( pLoader );
+
+	return pLoader->GetAssetFileSystemPath( path );
+}
+
 #endif
 
+Helium::AssetIdentifier::AssetIdentifier( DynamicArray< AssetPath >* pReferencedPaths )
+	: m_pReferencedPaths( pReferencedPaths )
+{
+}
+
 bool Helium::AssetIdentifier::Identify( const Reflect::ObjectPtr& object, Name* identity )
 {
 	Asset *pAsset = Reflect::SafeCast<Asset>(object);
@@ -696,6 +1404,22 @@ bool Helium::AssetIdentifier::Identify( const Reflect::ObjectPtr& object, Name*
 			HELIUM_TRACE( TraceLevels::Info, "Identifying object [%s]\n", identity->Get() );
 		}
 
+		if ( m_pReferencedPaths )
+		{
+			AssetPath path = pAsset->GetPath();
+
+			bool bListed = false;
+			for ( size_t i = 0; i < m_pReferencedPaths->GetSize() && !bListed; ++i )
+			{
+				bListed = ( m_pReferencedPaths->GetElement( i ) == path );
+			}
+
+			if ( !bListed )
+			{
+				m_pReferencedPaths->Push( path );
+			}
+		}
+
 		return true;
 	}
 	else if ( object )
@@ -706,6 +1430,12 @@ bool Helium::AssetIdentifier::Identify( const Reflect::ObjectPtr& object, Name*
 	return false;
 }
 
+Helium::AssetResolver::AssetResolver()
+	: m_PreloadedTargetCount( 0 )
+	, m_LoadedTargetCount( 0 )
+{
+}
+
 bool Helium::AssetResolver::Resolve( const Name& identity, Reflect::ObjectPtr& pointer, const Reflect::MetaClass* pointerClass )
 {
 	// Paths begin with /
@@ -716,8 +1446,27 @@ bool Helium::AssetResolver::Resolve( const Name& identity, Reflect::ObjectPtr& p
 		AssetPath p;
 		p.Set(*identity);
 
-		size_t loadRequestId = AssetLoader::GetInstance()->BeginLoadObject(p);
-		m_Fixups.Push( Fixup( pointer, pointerClass, loadRequestId ) );
+		// References to the same asset share one load request, so each target is only waited on and looked up once.
+		size_t targetIndex;
+		HashMap< AssetPath, size_t >::Iterator targetIterator = m_TargetIndices.Find( p );
+		if ( targetIterator != m_TargetIndices.End() )
+		{
+			targetIndex = targetIterator->Second();
+		}
+		else
+		{
+			targetIndex = m_Targets.GetSize();
+
+			FixupTarget* pTarget = m_Targets.New();
+			HELIUM_ASSERT( pTarget );
+			pTarget->m_Path = p;
+			pTarget->m_LoadRequestId = AssetLoader::GetInstance()->BeginLoadObject(p);
+			pTarget->m_pAsset = NULL;
+
+			m_TargetIndices.Insert( targetIterator, HashMap< AssetPath, size_t >::ValueType( p, targetIndex ) );
+		}
+
+		m_Fixups.Push( Fixup( pointer, pointerClass, targetIndex ) );
 
 		return true;
 	}
@@ -744,62 +1493,81 @@ bool Helium::AssetResolver::Resolve( const Name& identity, Reflect::ObjectPtr& p
 	return false;
 }
 
-bool Helium::AssetResolver::ReadyToApplyFixups()
+bool Helium::AssetResolver::ReadyToApplyFixups( size_t& rBlockingLoadRequestId )
 {
-	for ( DynamicArray< Fixup >::Iterator iter = m_Fixups.Begin();
-		iter != m_Fixups.End(); ++iter)
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+
+	// Preloading never regresses, so targets found preloaded by an earlier check are skipped.
+	size_t targetCount = m_Targets.GetSize();
+	for ( ; m_PreloadedTargetCount < targetCount; ++m_PreloadedTargetCount )
 	{
+		FixupTarget& rTarget = m_Targets[ m_PreloadedTargetCount ];
+
 		// Retrieve the load request and test whether it has completed.
-		AssetLoader::LoadRequest* pRequest = AssetLoader::GetInstance()->m_loadRequestPool.GetObject( iter->m_LoadRequestId );
+		AssetLoader::LoadRequest* pRequest = pAssetLoader->m_loadRequestPool.GetObject( rTarget.m_LoadRequestId );
 
 		if ( !( pRequest->stateFlags & AssetLoader::LOAD_FLAG_PRELOADED ) )
 		{
+			rBlockingLoadRequestId = rTarget.m_LoadRequestId;
 			return false;
 		}
+
+		// Grab each target object once here, so that the fixups themselves can be applied in any order.
+		if( !pRequest->spObject.ReferencesObject() )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "Reference to %s could not be found\n", *pRequest->path.ToString() );
+		}
+
+		rTarget.m_pAsset = pRequest->spObject.Get();
 	}
 
 	return true;
 }
 
-void Helium::AssetResolver::ApplyFixups()
+void Helium::AssetResolver::ApplyFixups( size_t fixupStart, size_t fixupCount )
 {
-	for ( DynamicArray< Fixup >::Iterator iter = m_Fixups.Begin();
-		iter != m_Fixups.End(); ++iter)
-	{
-		// Retrieve the load request and test whether it has completed.
-		AssetLoader::LoadRequest* pRequest = AssetLoader::GetInstance()->m_loadRequestPool.GetObject( iter->m_LoadRequestId );
+	HELIUM_ASSERT( m_PreloadedTargetCount == m_Targets.GetSize() );
+	HELIUM_ASSERT( fixupStart + fixupCount <= m_Fixups.GetSize() );
 
-		HELIUM_ASSERT( pRequest->stateFlags & AssetLoader::LOAD_FLAG_PRELOADED );
-		if( !pRequest->spObject.ReferencesObject() )
-		{
-			HELIUM_TRACE( TraceLevels::Warning, "Reference to %s could not be found\n", *pRequest->path.ToString() );
-		}
+	const FixupTarget* pTargets = m_Targets.GetData();
+	const Fixup* pFixups = m_Fixups.GetData() + fixupStart;
+	for ( size_t fixupIndex = 0; fixupIndex < fixupCount; ++fixupIndex )
+	{
+		const Fixup& rFixup = pFixups[ fixupIndex ];
+		HELIUM_ASSERT( rFixup.m_TargetIndex < m_Targets.GetSize() );
 
-		iter->m_Pointer.Set(pRequest->spObject);
+		rFixup.m_Pointer.Set( pTargets[ rFixup.m_TargetIndex ].m_pAsset );
 	}
 }
 
 void Helium::AssetResolver::Clear()
 {
 	m_Fixups.Clear();
+	m_Targets.Clear();
+	m_TargetIndices.Clear();
+	m_PreloadedTargetCount = 0;
+	m_LoadedTargetCount = 0;
 }
 
-bool Helium::AssetResolver::TryFinishPrecachingDependencies()
+bool Helium::AssetResolver::TryFinishPrecachingDependencies( size_t& rBlockingLoadRequestId )
 {
-	for ( DynamicArray< Fixup >::Iterator iter = m_Fixups.Begin();
-		iter != m_Fixups.End(); ++iter)
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+
+	size_t targetCount = m_Targets.GetSize();
+	for ( ; m_LoadedTargetCount < targetCount; ++m_LoadedTargetCount )
 	{
-		if ( IsValid( iter->m_LoadRequestId ) )
+		FixupTarget& rTarget = m_Targets[ m_LoadedTargetCount ];
+		if ( IsValid( rTarget.m_LoadRequestId ) )
 		{
 			AssetPtr asset;
-			if( !AssetLoader::GetInstance()->TryFinishLoad( iter->m_LoadRequestId, asset ) )
+			if( !pAssetLoader->TryFinishLoad( rTarget.m_LoadRequestId, asset ) )
 			{
+				rBlockingLoadRequestId = rTarget.m_LoadRequestId;
 				return false;
 			}
 		
-			SetInvalid( iter->m_LoadRequestId );
+			SetInvalid( rTarget.m_LoadRequestId );
 		}
-
 	}
 
 	return true;
@@ -846,7 +1614,13 @@ void Helium::AssetTracker::NotifyAssetCreatedExternally( const AssetPath &pAsset
 
 void Helium::AssetTracker::NotifyAssetChangedExternally( const AssetPath &pAsset )
 {
-	//e_AssetChangedExternally.Raise( AssetEventArgs( pAsset ) );
+	// The event is raised once the changed asset has been reloaded and swapped in (see NotifyAssetReloaded()).
+	AssetLoader::GetInstance()->QueueHotReload( pAsset );
+}
+
+void Helium::AssetTracker::NotifyAssetReloaded( Asset *pAsset )
+{
+	e_AssetChangedExternally.Raise( AssetEventArgs( pAsset ) );
 }
 
 void AssetTracker::OnAssetChanged( const Reflect::ObjectChangeArgs &args )
@@ -2,8 +2,11 @@
 
 #include "Engine/Engine.h"
 
+#include "Platform/Condition.h"
+#include "Platform/Locks.h"
 #include "Reflect/Translator.h"
 #include "Foundation/ConcurrentHashMap.h"
+#include "Foundation/HashMap.h"
 #include "Foundation/ObjectPool.h"
 #include "Engine/AssetPath.h"
 #include "Engine/Asset.h"
@@ -15,22 +18,42 @@ namespace Helium
 {
 	class PackageLoader;
 
+	/// Callback for one item of load work run through AssetLoader::RunParallel().
+	///
+	/// @param[in] pContext  Context given to RunParallel().
+	/// @param[in] index     Index of the item to process.
+	typedef void ( *ASSET_LOAD_WORK_CALLBACK )( void* pContext, size_t index );
+
+	/// Function that runs a callback for every index in [0, count), potentially in parallel, and returns once every
+	/// index has been processed.
+	typedef void ( *ASSET_LOAD_PARALLEL_FOR )( ASSET_LOAD_WORK_CALLBACK pCallback, void* pContext, size_t count );
+
 	class HELIUM_ENGINE_API AssetIdentifier : public Reflect::ObjectIdentifier
 	{
 	public:
+		// If given, the path of each asset identified is added to pReferencedPaths (once).
+		AssetIdentifier( DynamicArray< AssetPath >* pReferencedPaths = NULL );
+
 		virtual bool Identify( const Reflect::ObjectPtr& object, Name* identity ) override;
+
+	private:
+		DynamicArray< AssetPath >* m_pReferencedPaths;
 	};
 
 	class HELIUM_ENGINE_API AssetResolver : public Reflect::ObjectResolver
 	{
 	public:
+		AssetResolver();
+
 		// Reflect::ObjectResolver interface
 		virtual bool Resolve( const Name& identity, Reflect::ObjectPtr& pointer, const Reflect::MetaClass* pointerClass );
 
-		// Called by AssetLoader
-		bool ReadyToApplyFixups();
-		void ApplyFixups();
-		bool TryFinishPrecachingDependencies();
+		// Called by AssetLoader.  When either check fails, rBlockingLoadRequestId is set to the load request waited on.
+		// Fixups may be applied in several ranges in parallel once ReadyToApplyFixups() has succeeded.
+		bool ReadyToApplyFixups( size_t& rBlockingLoadRequestId );
+		void ApplyFixups( size_t fixupStart, size_t fixupCount );
+		inline size_t GetFixupCount() const;
+		bool TryFinishPrecachingDependencies( size_t& rBlockingLoadRequestId );
 		void Clear();
 
 		// Internal fixups that must be completed
@@ -39,28 +62,94 @@ namespace Helium
 			Fixup( const Fixup& rhs )
 				: m_Pointer( rhs.m_Pointer )
 				, m_PointerClass( rhs.m_PointerClass )
-				, m_LoadRequestId( rhs.m_LoadRequestId )
+				, m_TargetIndex( rhs.m_TargetIndex )
 			{}
 
-			Fixup( Reflect::ObjectPtr& pointer, const Reflect::MetaClass* pointerClass, size_t loadRequestId )
+			Fixup( Reflect::ObjectPtr& pointer, const Reflect::MetaClass* pointerClass, size_t targetIndex )
 				: m_Pointer( pointer )
 				, m_PointerClass( pointerClass )
-				, m_LoadRequestId( loadRequestId )
+				, m_TargetIndex( targetIndex )
 			{}
 
 			Reflect::ObjectPtr&       m_Pointer;
 			const Reflect::MetaClass* m_PointerClass;
-			size_t                    m_LoadRequestId;
+			size_t                    m_TargetIndex;
 		};
 		DynamicArray< Fixup >  m_Fixups;
+
+		// Asset referenced by one or more fixups, loaded through a single load request
+		struct FixupTarget
+		{
+			AssetPath m_Path;
+			size_t    m_LoadRequestId;
+			Asset*    m_pAsset;
+		};
+		DynamicArray< FixupTarget > m_Targets;
+
+	private:
+		// Index in m_Targets of each referenced path
+		HashMap< AssetPath, size_t > m_TargetIndices;
+		// Number of leading targets known to be preloaded, and to have finished loading
+		size_t m_PreloadedTargetCount;
+		size_t m_LoadedTargetCount;
 	};
 
 	/// Asynchronous object loading interface
+	///
+	/// Tick() only updates requests that can make progress on their own (those waiting on I/O or their package
+	/// loader).  A request waiting on another request is parked with that request until it is preloaded or fully
+	/// loaded.  Reference fixups for all requests ready to link in a tick are applied through RunParallel(), split into
+	/// ranges of up to LINK_WORK_FIXUP_COUNT so that requests with many references are spread over several workers, as
+	/// is object deserialization in CachePackageLoader, while resource precaching and load finalization stay on the
+	/// thread calling Tick().
+	///
+	/// Requests are updated in priority order.  If a tick budget is set, requests below PRIORITY_HIGH are left for
+	/// the next tick once it has been used up, so background loads can be spread over several frames.
+	///
+	/// A thread dedicated to ticking the loader can block in WaitForWork() between ticks.  It is woken as soon as a
+	/// request is begun or unparked, a hot reload is queued, or an AsyncLoader read completes, rather than waiting out
+	/// a fixed polling interval between load stages.
 	class HELIUM_ENGINE_API AssetLoader : NonCopyable
 	{
 	public:
 		/// Number of request objects to allocate in each block of the request pool.
 		static const size_t LOAD_REQUEST_POOL_BLOCK_SIZE = 64;
+		/// Maximum number of reference fixups applied in one item of parallel link work.
+		static const size_t LINK_WORK_FIXUP_COUNT = 1024;
+
+		/// Load request priorities.
+		enum EPriority
+		{
+			PRIORITY_FIRST   =  0,
+			PRIORITY_INVALID = -1,
+
+			/// Background loads, such as level streaming.
+			PRIORITY_LOW = PRIORITY_FIRST,
+			/// Regular loads.
+			PRIORITY_NORMAL,
+			/// Loads that are never held back by the tick budget.
+			PRIORITY_HIGH,
+
+			PRIORITY_MAX,
+			PRIORITY_LAST = PRIORITY_MAX - 1
+		};
+
+		/// Number of load requests that reached each stage during a single Tick().
+		struct TickStats
+		{
+			/// Requests picked up after being begun or woken since the previous tick.
+			size_t queuedRequestCount;
+			/// Request updates performed (a request may be updated both before and after linking).
+			size_t updatedRequestCount;
+			/// Requests parked with other requests they wait on.
+			size_t blockedRequestCount;
+			/// Requests linked.
+			size_t linkedRequestCount;
+			/// Requests that finished loading.
+			size_t completedRequestCount;
+			/// Requests left active for the next tick.
+			size_t activeRequestCount;
+		};
 
 		friend AssetIdentifier;
 		friend AssetResolver;
@@ -73,7 +162,7 @@ namespace Helium
 
 		/// @name Loading Interface
 		//@{
-		virtual size_t BeginLoadObject( AssetPath path, bool forceReload = false );
+		virtual size_t BeginLoadObject( AssetPath path, bool forceReload = false, EPriority priority = PRIORITY_NORMAL );
 		virtual bool TryFinishLoad( size_t id, AssetPtr& rspObject );
 		void FinishLoad( size_t id, AssetPtr& rspObject );
 
@@ -93,11 +182,44 @@ namespace Helium
 		virtual void EnumerateRootPackages( DynamicArray< AssetPath > &packagePaths );
 
 		static int64_t GetAssetFileTimestamp( const AssetPath &path );
+		static const FilePath& GetAssetFilePath( const AssetPath &path );
 #endif
 
 		virtual void Tick();
 		//@}
 
+#if HELIUM_TOOLS
+		/// @name Hot Reloading
+		//@{
+		void QueueHotReload( AssetPath path );
+		//@}
+#endif
+
+		/// @name Parallel Load Work
+		//@{
+		void SetParallelFor( ASSET_LOAD_PARALLEL_FOR pParallelFor );
+		void RunParallel( ASSET_LOAD_WORK_CALLBACK pCallback, void* pContext, size_t count );
+		inline bool IsRunningParallel() const;
+		//@}
+
+		/// @name Tick Budget
+		//@{
+		void SetTickBudget( float32_t milliseconds );
+		inline float32_t GetTickBudget() const;
+		//@}
+
+		/// @name Tick Statistics
+		//@{
+		inline const TickStats& GetLastTickStats() const;
+		//@}
+
+		/// @name Work Notification
+		//@{
+		bool HasPendingWork();
+		bool WaitForWork( uint32_t timeoutMilliseconds );
+		void SignalWork();
+		//@}
+
 		/// @name Static Access
 		//@{
 		static AssetLoader* GetInstance();
@@ -135,6 +257,28 @@ namespace Helium
 			LOAD_FLAG_IN_TICK = 1 << 6,
 		};
 
+		/// Load request tick options.
+		enum ETickFlag
+		{
+			/// Stop once preloading has been updated.
+			TICK_FLAG_PRELOAD_ONLY = 1 << 0,
+			/// Return TICK_RESULT_LINK_READY instead of linking, so that linking can be batched.
+			TICK_FLAG_DEFER_LINK   = 1 << 1,
+		};
+
+		/// Load request tick results.
+		enum ETickResult
+		{
+			/// Waiting on I/O or the package loader, so the request should be ticked again.
+			TICK_RESULT_PENDING,
+			/// Waiting on another load request, with which the request has been parked.
+			TICK_RESULT_BLOCKED,
+			/// Ready to link (only if TICK_FLAG_DEFER_LINK was given).
+			TICK_RESULT_LINK_READY,
+			/// Load process complete.
+			TICK_RESULT_COMPLETE,
+		};
+
 		/// Asset load request information.
 		struct LoadRequest
 		{
@@ -156,14 +300,81 @@ namespace Helium
 
 			AssetResolver resolver;
 
+			/// Requests parked until this request makes progress (guarded by m_queuedRequestLock).
+			DynamicArray< LoadRequest* > waiters;
+			/// Highest priority the request has been given (only raised, and only while m_queuedRequestLock is held).
+			volatile int32_t priority;
+
+			/// Tick count when the request was begun.
+			uint64_t beginTicks;
+			/// Tick count when resource precaching was first attempted (only set while the load trace is enabled).
+			uint64_t precacheStartTicks;
+
 			bool forceReload;
 		};
 
+		/// Range of the reference fixups of a link request applied as one item of parallel link work.
+		struct LinkWork
+		{
+			/// Load request being linked.
+			LoadRequest* pRequest;
+			/// Index of the first fixup to apply.
+			size_t fixupStart;
+			/// Number of fixups to apply.
+			size_t fixupCount;
+		};
+
 		/// Load request hash map.
 		ConcurrentHashMap< AssetPath, LoadRequest* > m_loadRequestMap;
 		/// Load request pool.
 		ObjectPool< LoadRequest > m_loadRequestPool;
 
+		/// Requests updated by Tick() for each priority, each holding a request count reference (only accessed by
+		/// Tick()).
+		DynamicArray< LoadRequest* > m_activeRequests[ PRIORITY_MAX ];
+		/// Requests ready to link in the current tick.
+		DynamicArray< LoadRequest* > m_linkRequests;
+		/// Fixup ranges of the requests ready to link in the current tick, applied in parallel.
+		DynamicArray< LinkWork > m_linkWork;
+		/// Requests added or woken since the last tick, each holding a request count reference.
+		DynamicArray< LoadRequest* > m_queuedRequests;
+		/// Lock for the queued requests and the waiters of each request.
+		Mutex m_queuedRequestLock;
+
+		/// Condition signaled when requests are queued or woken, hot reloads are queued, or async loads complete.
+		Condition m_workCondition;
+
+		/// Function used to run load work in parallel, or null to run it on the calling thread.
+		ASSET_LOAD_PARALLEL_FOR m_pParallelFor;
+		/// Non-zero while work given to RunParallel() is running.
+		volatile int32_t m_parallelDepth;
+
+		/// Stage counts of the last Tick().
+		TickStats m_lastTickStats;
+
+		/// Time Tick() may spend updating requests below PRIORITY_HIGH, in milliseconds (zero if unlimited).
+		float32_t m_tickBudgetMilliseconds;
+		/// Tick budget in timer ticks.
+		uint64_t m_tickBudgetTicks;
+
+#if HELIUM_TOOLS
+		/// Asset reload in progress for hot reloading.
+		struct HotReload
+		{
+			/// Asset path.
+			AssetPath path;
+			/// Load request ID of the new instance.
+			size_t loadId;
+		};
+
+		/// Paths of assets queued for hot reloading since the last tick.
+		DynamicArray< AssetPath > m_queuedHotReloads;
+		/// Lock for the queued hot reload paths.
+		Mutex m_hotReloadLock;
+		/// Hot reloads in progress (only accessed by Tick()).
+		DynamicArray< HotReload > m_hotReloads;
+#endif
+
 		/// Singleton instance.
 		static AssetLoader* sm_pInstance;
 
@@ -180,11 +391,26 @@ namespace Helium
 
 		/// @name Load Process Updating
 		//@{
-		bool TickLoadRequest( LoadRequest* pRequest );
+		ETickResult TickLoadRequest( LoadRequest* pRequest, uint32_t tickFlags = 0 );
 		bool TickPreload( LoadRequest* pRequest );
-		bool TickLink( LoadRequest* pRequest );
+		void TickLink( LoadRequest* pRequest );
+		void FinishLink( LoadRequest* pRequest, uint64_t startTicks );
 		bool TickPrecache( LoadRequest* pRequest );
 		bool TickFinalizeLoad( LoadRequest* pRequest );
+
+		bool IsTickBudgetExhausted( uint64_t startTickCount, int32_t priority, size_t tickedRequestCount ) const;
+
+		void QueueRequest( LoadRequest* pRequest );
+		void RaisePriority( LoadRequest* pRequest, int32_t priority );
+		ETickResult ParkRequest( LoadRequest* pRequest, size_t blockingLoadRequestId, int32_t waitFlag );
+		void WakeWaiters( LoadRequest* pRequest );
+		void ReleaseTickReference( LoadRequest* pRequest );
+
+#if HELIUM_TOOLS
+		void TickHotReloads();
+#endif
+
+		static void LinkCallback( void* pContext, size_t index );
 		//@}
 	};
 
@@ -214,6 +440,7 @@ namespace Helium
 		void NotifyAssetLoaded( Asset *pAsset );
 		void NotifyAssetCreatedExternally( const AssetPath &pAsset );
 		void NotifyAssetChangedExternally( const AssetPath &pAsset );
+		void NotifyAssetReloaded( Asset *pAsset );
 
 		// Callback registered with all loaded assets so that we can serve as a pinch point
 		// for general asset change notification
@@ -224,6 +451,9 @@ namespace Helium
 		AssetEventSignature::Event e_AssetChanged;
 
 		AssetEventSignature::Event e_AssetCreatedExternally;
+
+		// Raised on the thread ticking the asset loader once an asset changed on disk has been reloaded and swapped
+		// in place of the previously loaded instance
 		AssetEventSignature::Event e_AssetChangedExternally;
 
 	private:
@@ -233,3 +463,5 @@ namespace Helium
 	};
 #endif
 }
+
+#include "Engine/AssetLoader.inl"
@@ -0,0 +1,42 @@
+/// Get whether work given to RunParallel() is currently running.
+///
+/// Load requests begun while this is set are queued for the next Tick() rather than started immediately, as package
+/// loaders may only be updated from the thread calling Tick().
+///
+/// @return  True if parallel load work is in progress, false if not.
+///
+/// @see RunParallel()
+bool Helium::AssetLoader::IsRunningParallel() const
+{
+    return ( m_parallelDepth != 0 );
+}
+
+/// Get the time Tick() may spend updating requests below PRIORITY_HIGH.
+///
+/// @return  Tick budget in milliseconds, or zero if unlimited.
+///
+/// @see SetTickBudget()
+float32_t Helium::AssetLoader::GetTickBudget() const
+{
+    return m_tickBudgetMilliseconds;
+}
+
+/// Get the number of load requests that reached each stage during the last Tick().
+///
+/// This may only be called from the thread calling Tick().
+///
+/// @return  Stage counts of the last tick.
+const Helium::AssetLoader::TickStats& Helium::AssetLoader::GetLastTickStats() const
+{
+    return m_lastTickStats;
+}
+
+/// Get the number of reference fixups gathered by this resolver.
+///
+/// @return  Fixup count.
+///
+/// @see ApplyFixups()
+size_t Helium::AssetResolver::GetFixupCount() const
+{
+    return m_Fixups.GetSize();
+}
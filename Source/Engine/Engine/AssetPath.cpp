@@ -1,6 +1,7 @@
 #include "Precompile.h"
 #include "Engine/AssetPath.h"
 
+#include "Platform/Atomic.h"
 #include "Foundation/FilePath.h"
 
 #include "Foundation/ReferenceCounting.h"
@@ -17,9 +18,10 @@ struct Helium::AssetPath::PendingLink
 
 using namespace Helium;
 
-AssetPath::TableBucket* AssetPath::sm_pTable = NULL;
+AssetPath::Table* volatile AssetPath::sm_pTable = NULL;
+Mutex AssetPath::sm_tableLock;
 StackMemoryHeap<>* AssetPath::sm_pEntryMemoryHeap = NULL;
-ObjectPool<AssetPath::PendingLink> *AssetPath::sm_pPendingLinksPool = NULL;
+ConcurrentObjectPool<AssetPath::PendingLink> *AssetPath::sm_pPendingLinksPool = NULL;
 
 /// Parse the object path in the specified string and store it in this object.
 ///
@@ -493,6 +495,43 @@ void AssetPath::Clear()
 	m_pEntry = NULL;
 }
 
+/// Find an existing object path from its stable hash, without needing its string.
+///
+/// Only paths that have already been created during this run can be found.  The path table is not locked, so this is
+/// cheap enough to try before parsing a path string whose stable hash is known (such as one read from a cache TOC).
+///
+/// @param[in]  stableHash  Stable hash of the path (see GetStableHash()).
+/// @param[out] rPath       Path with the given hash, if found (left unchanged if not).
+///
+/// @return  True if a path with the given hash was found, false if not.
+///
+/// @see GetStableHash()
+bool AssetPath::FindByStableHash( uint64_t stableHash, AssetPath& rPath )
+{
+	Table* pTable = sm_pTable;
+	if( !pTable || stableHash == 0 )
+	{
+		return false;
+	}
+
+	size_t slotMask = pTable->slotMask;
+	for( size_t slotIndex = static_cast< size_t >( stableHash ) & slotMask; ; slotIndex = ( slotIndex + 1 ) & slotMask )
+	{
+		Entry* pTableEntry = pTable->pSlots[ slotIndex ];
+		if( !pTableEntry )
+		{
+			return false;
+		}
+
+		if( pTableEntry->stableHash == stableHash )
+		{
+			rPath.m_pEntry = pTableEntry;
+
+			return true;
+		}
+	}
+}
+
 /// Release the object path table and free all allocated memory.
 ///
 /// This should only be called immediately prior to application exit.
@@ -500,7 +539,15 @@ void AssetPath::Shutdown()
 {
 	HELIUM_TRACE( TraceLevels::Info, "Shutting down AssetPath table.\n" );
 
-	delete [] sm_pTable;
+	Table* pTable = sm_pTable;
+	while( pTable )
+	{
+		Table* pPrevious = pTable->pPrevious;
+		delete [] pTable->pSlots;
+		delete pTable;
+		pTable = pPrevious;
+	}
+
 	sm_pTable = NULL;
 
 	delete sm_pEntryMemoryHeap;
@@ -843,6 +890,9 @@ bool AssetPath::Parse(
 
 /// Look up a table entry, adding it if it does not exist.
 ///
+/// Entries already in the table are found without locking.  Adding an entry locks the table, so that entries are only
+/// ever added by one thread at a time.
+///
 /// This also handles lazy initialization of the path table and allocator.
 ///
 /// @param[in] rEntry  Entry to locate or add.
@@ -857,30 +907,136 @@ AssetPath::Entry* AssetPath::Add( const Entry& rEntry )
 		sm_pEntryMemoryHeap = new StackMemoryHeap<>( STACK_HEAP_BLOCK_SIZE );
 		HELIUM_ASSERT( sm_pEntryMemoryHeap );
 
-		sm_pPendingLinksPool = new ObjectPool<PendingLink>( PENDING_LINKS_POOL_BLOCK_SIZE );
+		sm_pPendingLinksPool = new ConcurrentObjectPool<PendingLink>( PENDING_LINKS_POOL_BLOCK_SIZE );
 		HELIUM_ASSERT( sm_pPendingLinksPool );
 
 		HELIUM_ASSERT( !sm_pTable );
-		sm_pTable = new TableBucket [ TABLE_BUCKET_COUNT ];
-		HELIUM_ASSERT( sm_pTable );
+		sm_pTable = CreateTable( TABLE_INITIAL_CAPACITY, NULL );
+	}
+
+	// The stable hash only depends on the parent's stable hash and this entry's own name, so it is cheap to compute
+	// before the entry is in the table.
+	uint64_t stableHash = ComputeEntryStableHash( rEntry );
+
+	Table* pTable = sm_pTable;
+	HELIUM_ASSERT( pTable );
+	Entry* pTableEntry = FindTableEntry( *pTable, rEntry, stableHash );
+	if( pTableEntry )
+	{
+		return pTableEntry;
 	}
 
-	HELIUM_ASSERT( sm_pTable );
+	// Check again once locked, as another thread may have added the entry (or grown the table) in the meantime.
+	MutexScopeLock scopeLock( sm_tableLock );
 
-	// Compute the entry's hash table index and retrieve the corresponding bucket.
-	uint32_t bucketIndex = ComputeEntryStringHash( rEntry ) % TABLE_BUCKET_COUNT;
-	TableBucket& rBucket = sm_pTable[ bucketIndex ];
+	pTable = sm_pTable;
+	pTableEntry = FindTableEntry( *pTable, rEntry, stableHash );
+	if( pTableEntry )
+	{
+		return pTableEntry;
+	}
 
-	// Locate the entry in the table.  If it does not exist, add it.
-	size_t entryCount = 0;
-	Entry* pTableEntry = rBucket.Find( rEntry, entryCount );
-	if( !pTableEntry )
+	// Keep the table at most three quarters full so that probe sequences stay short.
+	size_t slotCount = pTable->slotMask + 1;
+	if( ( pTable->entryCount + 1 ) * 4 > slotCount * 3 )
 	{
-		pTableEntry = rBucket.Add( rEntry, entryCount );
-		HELIUM_ASSERT( pTableEntry );
+		Table* pNewTable = CreateTable( slotCount * 2, pTable );
+		for( size_t slotIndex = 0; slotIndex < slotCount; ++slotIndex )
+		{
+			Entry* pSlotEntry = pTable->pSlots[ slotIndex ];
+			if( pSlotEntry )
+			{
+				InsertTableEntry( *pNewTable, pSlotEntry );
+			}
+		}
+
+		AtomicExchangeRelease( sm_pTable, pNewTable );
+		pTable = pNewTable;
 	}
 
-	return pTableEntry;
+	HELIUM_ASSERT( sm_pEntryMemoryHeap );
+	Entry* pNewEntry = static_cast< Entry* >( sm_pEntryMemoryHeap->Allocate( sizeof( Entry ) ) );
+	HELIUM_ASSERT( pNewEntry );
+	new( pNewEntry ) Entry( rEntry );
+	pNewEntry->stableHash = stableHash;
+
+	InsertTableEntry( *pTable, pNewEntry );
+
+	return pNewEntry;
+}
+
+/// Allocate an empty hash table.
+///
+/// @param[in] slotCount  Number of table slots (must be a power of two).
+/// @param[in] pPrevious  Table being replaced, if any.
+///
+/// @return  Newly allocated table.
+AssetPath::Table* AssetPath::CreateTable( size_t slotCount, Table* pPrevious )
+{
+	HELIUM_ASSERT( slotCount != 0 && ( slotCount & ( slotCount - 1 ) ) == 0 );
+
+	typedef Entry* volatile SlotType;
+
+	Table* pTable = new Table;
+	HELIUM_ASSERT( pTable );
+	pTable->slotMask = slotCount - 1;
+	pTable->entryCount = 0;
+	pTable->pSlots = new SlotType [ slotCount ]();
+	HELIUM_ASSERT( pTable->pSlots );
+	pTable->pPrevious = pPrevious;
+
+	return pTable;
+}
+
+/// Find an existing object path entry in a hash table.
+///
+/// This does not lock the table.  Since slots are never cleared, a concurrent addition can at worst cause an entry
+/// added at the same time to be missed, which Add() handles by searching again once locked.
+///
+/// @param[in] rTable      Table to search.
+/// @param[in] rEntry      Externally defined entry to match.
+/// @param[in] stableHash  Stable hash of the entry.
+///
+/// @return  Table entry if found, null if not found.
+AssetPath::Entry* AssetPath::FindTableEntry( const Table& rTable, const Entry& rEntry, uint64_t stableHash )
+{
+	size_t slotMask = rTable.slotMask;
+	for( size_t slotIndex = static_cast< size_t >( stableHash ) & slotMask; ; slotIndex = ( slotIndex + 1 ) & slotMask )
+	{
+		Entry* pTableEntry = rTable.pSlots[ slotIndex ];
+		if( !pTableEntry )
+		{
+			return NULL;
+		}
+
+		if( pTableEntry->stableHash == stableHash && EntryContentsMatch( rEntry, *pTableEntry ) )
+		{
+			return pTableEntry;
+		}
+	}
+}
+
+/// Store an entry in the first free slot of its probe sequence in a hash table.
+///
+/// The table lock must be held, and the table must have at least one free slot.
+///
+/// @param[in] rTable  Table in which to store the entry.
+/// @param[in] pEntry  Entry to store.
+void AssetPath::InsertTableEntry( Table& rTable, Entry* pEntry )
+{
+	HELIUM_ASSERT( pEntry );
+	HELIUM_ASSERT( rTable.entryCount < rTable.slotMask + 1 );
+
+	size_t slotMask = rTable.slotMask;
+	size_t slotIndex = static_cast< size_t >( pEntry->stableHash ) & slotMask;
+	while( rTable.pSlots[ slotIndex ] )
+	{
+		slotIndex = ( slotIndex + 1 ) & slotMask;
+	}
+
+	// Publish the slot only once the entry is fully constructed, for threads probing without the lock.
+	AtomicExchangeRelease( rTable.pSlots[ slotIndex ], pEntry );
+	++rTable.entryCount;
 }
 
 /// Recursive function for building the string representation of an object path entry.
@@ -926,26 +1082,40 @@ void AssetPath::EntryToFilePathString( const Entry& rEntry, String& rString )
 	rString += rEntry.name.Get();
 }
 
-/// Compute a hash value for an object path entry based on the contents of the name strings (slow, should only be
-/// used internally when a string comparison is needed).
+/// Compute the stable hash for an object path entry, continuing from the hash already stored for its parent.
 ///
 /// @param[in] rEntry  Asset path entry.
 ///
-/// @return  Hash value.
-size_t AssetPath::ComputeEntryStringHash( const Entry& rEntry )
+/// @return  64-bit FNV-1a hash of the entry's string representation.
+///
+/// @see GetStableHash()
+uint64_t AssetPath::ComputeEntryStableHash( const Entry& rEntry )
 {
-	size_t hash = StringHash( rEntry.name.GetDirect() );
-	hash = ( ( hash * 33 ) ^ rEntry.instanceIndex );
-	hash = ( ( hash * 33 ) ^
-		( rEntry.bPackage
-		? static_cast< size_t >( HELIUM_PACKAGE_PATH_CHAR )
-		: static_cast< size_t >( HELIUM_OBJECT_PATH_CHAR ) ) );
+	static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	static const uint64_t FNV_PRIME = 1099511628211ULL;
 
-	Entry* pParent = rEntry.pParent;
-	if( pParent )
+	uint64_t hash = ( rEntry.pParent ? rEntry.pParent->stableHash : FNV_OFFSET_BASIS );
+
+	hash = ( hash ^ static_cast< uint8_t >( rEntry.bPackage ? HELIUM_PACKAGE_PATH_CHAR : HELIUM_OBJECT_PATH_CHAR ) ) * FNV_PRIME;
+
+	for( const char* pCharacter = rEntry.name.Get(); *pCharacter != '\0'; ++pCharacter )
+	{
+		hash = ( hash ^ static_cast< uint8_t >( *pCharacter ) ) * FNV_PRIME;
+	}
+
+	if( IsValid( rEntry.instanceIndex ) )
 	{
-		size_t parentHash = ComputeEntryStringHash( *pParent );
-		hash = ( ( hash * 33 ) ^ parentHash );
+		char instanceIndexString[ 16 ];
+		StringPrint(
+			instanceIndexString,
+			HELIUM_INSTANCE_PATH_CHAR_STRING "%" PRIu32,
+			rEntry.instanceIndex );
+		instanceIndexString[ HELIUM_ARRAY_COUNT( instanceIndexString ) - 1 ] = '\0';
+
+		for( const char* pCharacter = instanceIndexString; *pCharacter != '\0'; ++pCharacter )
+		{
+			hash = ( hash ^ static_cast< uint8_t >( *pCharacter ) ) * FNV_PRIME;
+		}
 	}
 
 	return hash;
@@ -964,73 +1134,3 @@ bool AssetPath::EntryContentsMatch( const Entry& rEntry0, const Entry& rEntry1 )
 		( rEntry0.bPackage ? rEntry1.bPackage : !rEntry1.bPackage ) &&
 		rEntry0.pParent == rEntry1.pParent );
 }
-
-/// Find an existing object path entry in this table.
-///
-/// @param[in]  rEntry       Externally defined entry to match.
-/// @param[out] rEntryCount  Number of entries in this bucket when the search was performed.
-///
-/// @return  Table entry if found, null if not found.
-///
-/// @see Add()
-AssetPath::Entry* AssetPath::TableBucket::Find( const Entry& rEntry, size_t& rEntryCount )
-{
-	ScopeReadLock readLock( m_lock );
-
-	Entry* const * ppTableEntries = m_entries.GetData();
-	size_t entryCount = m_entries.GetSize();
-	HELIUM_ASSERT( ppTableEntries || entryCount == 0 );
-
-	rEntryCount = entryCount;
-
-	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
-	{
-		Entry* pTableEntry = ppTableEntries[ entryIndex ];
-		HELIUM_ASSERT( pTableEntry );
-		if( EntryContentsMatch( rEntry, *pTableEntry ) )
-		{
-			return pTableEntry;
-		}
-	}
-
-	return NULL;
-}
-
-/// Add an object path entry to this table if it does not already exist.
-///
-/// @param[in] rEntry              Externally defined entry to locate or add.
-/// @param[in] previousEntryCount  Number of entries already checked during a previous Find() call (existing entries
-///                                are not expected to change).  In other words, the entry index from which to start
-///                                checking for any additional string entries that may have been added since the
-///                                previous Find() call.
-///
-/// @return  Pointer to the object path table entry.
-///
-/// @see Find()
-AssetPath::Entry* AssetPath::TableBucket::Add( const Entry& rEntry, size_t previousEntryCount )
-{
-	ScopeWriteLock writeLock( m_lock );
-
-	Entry* const * ppTableEntries = m_entries.GetData();
-	size_t entryCount = m_entries.GetSize();
-	HELIUM_ASSERT( ppTableEntries || entryCount == 0 );
-	HELIUM_ASSERT( previousEntryCount <= entryCount );
-	for( size_t entryIndex = previousEntryCount; entryIndex < entryCount; ++entryIndex )
-	{
-		Entry* pTableEntry = ppTableEntries[ entryIndex ];
-		HELIUM_ASSERT( pTableEntry );
-		if( EntryContentsMatch( rEntry, *pTableEntry ) )
-		{
-			return pTableEntry;
-		}
-	}
-
-	HELIUM_ASSERT( sm_pEntryMemoryHeap );
-	Entry* pNewEntry = static_cast< Entry* >( sm_pEntryMemoryHeap->Allocate( sizeof( Entry ) ) );
-	HELIUM_ASSERT( pNewEntry );
-	new( pNewEntry ) Entry( rEntry );
-
-	m_entries.Push( pNewEntry );
-
-	return pNewEntry;
-}
@@ -3,10 +3,10 @@
 #include "Platform/Locks.h"
 
 #include "Foundation/Name.h"
-#include "Foundation/ObjectPool.h"
 #include "Foundation/ReferenceCounting.h"
 
 #include "Engine/Engine.h"
+#include "Engine/ConcurrentObjectPool.h"
 
 /// @defgroup objectpathdelims Asset FilePath Delimiter Characters
 //@{
@@ -35,8 +35,8 @@ namespace Helium
 	class HELIUM_ENGINE_API AssetPath
 	{
 	public:
-		/// Number of object path hash table buckets (prime numbers are recommended).
-		static const size_t TABLE_BUCKET_COUNT = 37;
+		/// Initial number of object path hash table slots (must be a power of two).
+		static const size_t TABLE_INITIAL_CAPACITY = 1024;
 		/// Asset path stack memory heap block size.
 		static const size_t STACK_HEAP_BLOCK_SIZE = sizeof( char ) * 8192;
 		/// Block size for pool of pending links
@@ -79,6 +79,9 @@ namespace Helium
 		void Clear();
 
 		inline size_t ComputeHash() const;
+		inline uint64_t GetStableHash() const;
+
+		static bool FindByStableHash( uint64_t stableHash, AssetPath& rPath );
 		//@}
 
 		/// @name Overloaded Operators
@@ -106,6 +109,8 @@ namespace Helium
 		{
 			/// Parent entry.
 			Entry* pParent;
+			/// 64-bit FNV-1a hash of the path string (set when the entry is added to the table).
+			uint64_t stableHash;
 			/// Asset name.
 			Name name;
 			/// Asset instance index.
@@ -114,31 +119,34 @@ namespace Helium
 			bool bPackage;
 		};
 
-		/// Asset path hash table bucket.
-		class TableBucket
+		/// Open-addressed asset path hash table, indexed by entry stable hash.
+		///
+		/// Slots are only ever filled (never cleared or moved), so lookups can probe a table without locking.  When a
+		/// table fills up, its entries are copied into a larger one, and the old table is kept alive until shutdown
+		/// for any thread that may still be probing it.
+		struct Table
 		{
-		public:
-			/// @name Access
-			//@{
-			Entry* Find( const Entry& rEntry, size_t& rEntryCount );
-			Entry* Add( const Entry& rEntry, size_t previousEntryCount );
-			//@}
-
-		private:
-			/// Array of entry pointers.
-			DynamicArray< Entry* > m_entries;
-			/// Read-write lock for synchronizing access.
-			ReadWriteLock m_lock;
+			/// Slot index mask (the slot count minus one).
+			size_t slotMask;
+			/// Number of slots in use.
+			size_t entryCount;
+			/// Entry slots (null if empty).
+			Entry* volatile* pSlots;
+			/// Previous (smaller) table.
+			Table* pPrevious;
 		};
 
 		/// Asset path entry.
 		Entry* m_pEntry;
 
 		/// Asset path hash table.
-		static TableBucket* sm_pTable;
+		static Table* volatile sm_pTable;
+		/// Mutex synchronizing additions to the hash table.
+		static Mutex sm_tableLock;
 		/// Stack-based memory heap for object path entry allocations.
 		static StackMemoryHeap<>* sm_pEntryMemoryHeap;
-		static ObjectPool<PendingLink> *sm_pPendingLinksPool;
+		/// Pool of pending links (may be used from loader threads).
+		static ConcurrentObjectPool<PendingLink> *sm_pPendingLinksPool;
 
 		/// @name Private Utility Functions
 		//@{
@@ -153,10 +161,14 @@ namespace Helium
 
 		static Entry* Add( const Entry& rEntry );
 
+		static Table* CreateTable( size_t slotCount, Table* pPrevious );
+		static Entry* FindTableEntry( const Table& rTable, const Entry& rEntry, uint64_t stableHash );
+		static void InsertTableEntry( Table& rTable, Entry* pEntry );
+
 		static void EntryToString( const Entry& rEntry, String& rString );
 		static void EntryToFilePathString( const Entry& rEntry, String& rString );
 
-		static size_t ComputeEntryStringHash( const Entry& rEntry );
+		static uint64_t ComputeEntryStableHash( const Entry& rEntry );
 		static bool EntryContentsMatch( const Entry& rEntry0, const Entry& rEntry1 );
 		//@}
 	};
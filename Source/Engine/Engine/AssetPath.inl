@@ -164,6 +164,17 @@ size_t Helium::AssetPath::ComputeHash() const
 	return static_cast< size_t >( reinterpret_cast< uintptr_t >( m_pEntry ) );
 }
 
+/// Get a hash of this object path that is stable across runs and platforms.
+///
+/// The hash is the 64-bit FNV-1a hash of the string returned by ToString(), so it can be stored in files (such as
+/// cache tables of contents) and compared against paths later.
+///
+/// @return  Stable 64-bit hash, or zero if this path is empty.
+uint64_t Helium::AssetPath::GetStableHash() const
+{
+	return ( m_pEntry ? m_pEntry->stableHash : 0 );
+}
+
 /// Equality comparison operator.
 ///
 /// @param[in] path  Asset path with which to compare.
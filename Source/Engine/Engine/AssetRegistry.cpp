@@ -0,0 +1,431 @@
+#include "Precompile.h"
+#include "Engine/AssetRegistry.h"
+
+#include "Platform/Atomic.h"
+#include "Engine/Asset.h"
+
+using namespace Helium;
+
+/// Slot asset value for assets that have been removed.
+static Asset* const REMOVED_OBJECT = reinterpret_cast< Asset* >( static_cast< uintptr_t >( 1 ) );
+
+/// Constructor.
+AssetRegistry::AssetRegistry()
+	: m_pTable( NULL )
+	, m_epoch( 0 )
+{
+	m_readerCounts[ 0 ] = 0;
+	m_readerCounts[ 1 ] = 0;
+}
+
+/// Destructor.
+AssetRegistry::~AssetRegistry()
+{
+	Shutdown();
+}
+
+/// Search for a direct child of an asset.
+///
+/// This can be called from any thread without locking.
+///
+/// @param[in] pOwner         Asset for which to locate a child, or null to search through top-level assets.
+/// @param[in] name           Asset name.
+/// @param[in] instanceIndex  Asset instance index.
+///
+/// @return  Child asset if found, null if not found.
+Asset* AssetRegistry::Find( const Asset* pOwner, Name name, uint32_t instanceIndex ) const
+{
+	int32_t epoch = BeginRead();
+
+	const Slot* pSlot = FindSlot( m_pTable, pOwner, name, instanceIndex );
+	Asset* pObject = ( pSlot ? pSlot->pObject : NULL );
+
+	EndRead( epoch );
+
+	return ( pObject != REMOVED_OBJECT ? pObject : NULL );
+}
+
+/// Search for a child or grandchild of an asset with a relative path dictated by the given parameters.
+///
+/// This can be called from any thread without locking.  The whole path is resolved within a single read, so the
+/// intermediate assets are not accessed.
+///
+/// @param[in] pOwner              Asset for which to locate a child, or null to search relative to top-level assets.
+/// @param[in] pRelativePathNames  Array of asset names comprising the relative path to the target asset, starting
+///                                from the top-most level.
+/// @param[in] pInstanceIndices    Array of asset instance indices corresponding to each entry in the name array, or
+///                                null if no instance indexing is used in the path.
+/// @param[in] nameDepth           Depth of the relative path name array.
+/// @param[in] packageDepth        Depth into the relative path name array of assets that are packages.
+///
+/// @return  Asset if found, null if not found.
+Asset* AssetRegistry::Find(
+	const Asset* pOwner,
+	const Name* pRelativePathNames,
+	const uint32_t* pInstanceIndices,
+	size_t nameDepth,
+	size_t packageDepth ) const
+{
+	HELIUM_ASSERT( pRelativePathNames || nameDepth == 0 );
+
+	int32_t epoch = BeginRead();
+
+	const Table* pTable = m_pTable;
+
+	Asset* pObject = NULL;
+	const Asset* pCurrentOwner = pOwner;
+	for( size_t nameIndex = 0; nameIndex < nameDepth; ++nameIndex )
+	{
+		const Slot* pSlot = FindSlot(
+			pTable,
+			pCurrentOwner,
+			pRelativePathNames[ nameIndex ],
+			( pInstanceIndices ? pInstanceIndices[ nameIndex ] : Invalid< uint32_t >() ) );
+		if( !pSlot || pSlot->bPackage != ( nameIndex < packageDepth ) )
+		{
+			pObject = NULL;
+
+			break;
+		}
+
+		pObject = pSlot->pObject;
+		if( pObject == REMOVED_OBJECT )
+		{
+			pObject = NULL;
+
+			break;
+		}
+
+		pCurrentOwner = pObject;
+	}
+
+	EndRead( epoch );
+
+	return pObject;
+}
+
+/// Add an asset to this registry.
+///
+/// Calls to this function must be serialized with all other modifications.
+///
+/// @param[in] pObject        Asset to add.
+/// @param[in] pOwner         Asset owner, or null for a top-level asset.
+/// @param[in] name           Asset name.
+/// @param[in] instanceIndex  Asset instance index.
+///
+/// @see Remove()
+void AssetRegistry::Add( Asset* pObject, const Asset* pOwner, Name name, uint32_t instanceIndex )
+{
+	HELIUM_ASSERT( pObject );
+	HELIUM_ASSERT( !name.IsEmpty() );
+	HELIUM_ASSERT( !FindSlot( m_pTable, pOwner, name, instanceIndex ) );
+
+	// Keep at least a quarter of the slots unused, rebuilding the table with room for twice the assets in use once
+	// it gets too full.
+	Table* pTable = m_pTable;
+	if( !pTable || ( pTable->usedSlotCount + 1 ) * 4 > pTable->slotCount * 3 )
+	{
+		size_t liveSlotCount = ( pTable ? pTable->liveSlotCount : 0 );
+
+		size_t slotCount = MIN_SLOT_COUNT;
+		while( slotCount * 3 < ( liveSlotCount + 1 ) * 8 )
+		{
+			slotCount *= 2;
+		}
+
+		pTable = Rebuild( slotCount );
+	}
+
+	size_t slotMask = pTable->slotCount - 1;
+	size_t slotIndex = ComputeHash( pOwner, name, instanceIndex ) & slotMask;
+	for( ; ; slotIndex = ( slotIndex + 1 ) & slotMask )
+	{
+		Slot& rSlot = pTable->pSlots[ slotIndex ];
+		if( !rSlot.pObject )
+		{
+			rSlot.pOwner = pOwner;
+			rSlot.name = name;
+			rSlot.instanceIndex = instanceIndex;
+			rSlot.bPackage = pObject->IsPackage();
+			AtomicExchangeRelease( rSlot.pObject, pObject );
+
+			++pTable->usedSlotCount;
+			++pTable->liveSlotCount;
+
+			break;
+		}
+	}
+
+	ReclaimTables();
+}
+
+/// Remove an asset from this registry.
+///
+/// Calls to this function must be serialized with all other modifications.
+///
+/// @param[in] pOwner         Asset owner, or null for a top-level asset.
+/// @param[in] name           Asset name.
+/// @param[in] instanceIndex  Asset instance index.
+///
+/// @see Add()
+void AssetRegistry::Remove( const Asset* pOwner, Name name, uint32_t instanceIndex )
+{
+	Slot* pSlot = const_cast< Slot* >( FindSlot( m_pTable, pOwner, name, instanceIndex ) );
+	HELIUM_ASSERT( pSlot );
+	if( pSlot )
+	{
+		AtomicExchangeRelease( pSlot->pObject, REMOVED_OBJECT );
+
+		HELIUM_ASSERT( m_pTable->liveSlotCount != 0 );
+		--m_pTable->liveSlotCount;
+	}
+
+	ReclaimTables();
+}
+
+/// Free all tables.
+///
+/// This must only be called once no more lookups can be done.
+void AssetRegistry::Shutdown()
+{
+	DestroyTable( m_pTable );
+	m_pTable = NULL;
+
+	size_t retiredTableCount = m_retiredTables.GetSize();
+	for( size_t tableIndex = 0; tableIndex < retiredTableCount; ++tableIndex )
+	{
+		DestroyTable( m_retiredTables[ tableIndex ].pTable );
+	}
+
+	m_retiredTables.Clear();
+}
+
+/// Register the calling thread as a reader in the current epoch.
+///
+/// @return  Epoch to pass to EndRead() once the lookup is done.
+///
+/// @see EndRead()
+int32_t AssetRegistry::BeginRead() const
+{
+	for( ; ; )
+	{
+		int32_t epoch = m_epoch;
+		AtomicIncrement( m_readerCounts[ epoch & 1 ] );
+
+		// If the epoch moved on before we were counted, the epoch's tables may already be getting freed, so register
+		// with the new epoch instead.
+		if( m_epoch == epoch )
+		{
+			return epoch;
+		}
+
+		AtomicDecrement( m_readerCounts[ epoch & 1 ] );
+	}
+}
+
+/// Unregister a reader registered with BeginRead().
+///
+/// @param[in] epoch  Epoch returned by BeginRead().
+///
+/// @see BeginRead()
+void AssetRegistry::EndRead( int32_t epoch ) const
+{
+	AtomicDecrementRelease( m_readerCounts[ epoch & 1 ] );
+}
+
+/// Replace the current table with a new table holding the assets not yet removed.
+///
+/// @param[in] slotCount  Number of slots in the new table.
+///
+/// @return  New table.
+AssetRegistry::Table* AssetRegistry::Rebuild( size_t slotCount )
+{
+	Table* pNewTable = CreateTable( slotCount );
+	HELIUM_ASSERT( pNewTable );
+
+	size_t slotMask = slotCount - 1;
+
+	Table* pOldTable = m_pTable;
+	if( pOldTable )
+	{
+		size_t oldSlotCount = pOldTable->slotCount;
+		for( size_t oldSlotIndex = 0; oldSlotIndex < oldSlotCount; ++oldSlotIndex )
+		{
+			const Slot& rOldSlot = pOldTable->pSlots[ oldSlotIndex ];
+			Asset* pObject = rOldSlot.pObject;
+			if( !pObject || pObject == REMOVED_OBJECT )
+			{
+				continue;
+			}
+
+			size_t slotIndex = ComputeHash( rOldSlot.pOwner, rOldSlot.name, rOldSlot.instanceIndex ) & slotMask;
+			while( pNewTable->pSlots[ slotIndex ].pObject )
+			{
+				slotIndex = ( slotIndex + 1 ) & slotMask;
+			}
+
+			Slot& rSlot = pNewTable->pSlots[ slotIndex ];
+			rSlot.pOwner = rOldSlot.pOwner;
+			rSlot.name = rOldSlot.name;
+			rSlot.instanceIndex = rOldSlot.instanceIndex;
+			rSlot.bPackage = rOldSlot.bPackage;
+			rSlot.pObject = pObject;
+		}
+
+		pNewTable->usedSlotCount = pOldTable->liveSlotCount;
+		pNewTable->liveSlotCount = pOldTable->liveSlotCount;
+	}
+
+	// Publish the fully initialized table, then keep the old one around until its readers are done.
+	AtomicExchangeRelease( m_pTable, pNewTable );
+
+	if( pOldTable )
+	{
+		RetiredTable* pRetiredTable = m_retiredTables.New();
+		HELIUM_ASSERT( pRetiredTable );
+		pRetiredTable->pTable = pOldTable;
+		pRetiredTable->epoch = m_epoch;
+	}
+
+	return pNewTable;
+}
+
+/// Free replaced tables that can no longer be in use by any reader.
+///
+/// Readers from the previous epoch share their counter with the next epoch, so the epoch is only advanced once that
+/// counter drops to zero.  At that point, only readers from the current epoch can be active, and any table replaced
+/// before the current epoch can be freed.
+void AssetRegistry::ReclaimTables()
+{
+	if( m_retiredTables.IsEmpty() )
+	{
+		return;
+	}
+
+	int32_t epoch = m_epoch;
+	if( m_readerCounts[ ( epoch + 1 ) & 1 ] != 0 )
+	{
+		return;
+	}
+
+	size_t tableIndex = 0;
+	while( tableIndex < m_retiredTables.GetSize() )
+	{
+		RetiredTable& rRetiredTable = m_retiredTables[ tableIndex ];
+		if( rRetiredTable.epoch != epoch )
+		{
+			DestroyTable( rRetiredTable.pTable );
+			m_retiredTables.RemoveSwap( tableIndex );
+		}
+		else
+		{
+			++tableIndex;
+		}
+	}
+
+	// Tables replaced during the current epoch can be freed once its readers are done.
+	if( !m_retiredTables.IsEmpty() )
+	{
+		AtomicIncrementRelease( m_epoch );
+	}
+}
+
+/// Search a table for the slot of an asset that has been added.
+///
+/// @param[in] pTable         Table to search (can be null).
+/// @param[in] pOwner         Asset owner.
+/// @param[in] name           Asset name.
+/// @param[in] instanceIndex  Asset instance index.
+///
+/// @return  Slot of the asset if it has been added and not removed, null if not found.
+const AssetRegistry::Slot* AssetRegistry::FindSlot(
+	const Table* pTable,
+	const Asset* pOwner,
+	Name name,
+	uint32_t instanceIndex )
+{
+	if( !pTable )
+	{
+		return NULL;
+	}
+
+	// Removed slots are never reused, so the search only has to check each slot's keys once it has been filled.
+	size_t slotMask = pTable->slotCount - 1;
+	size_t slotIndex = ComputeHash( pOwner, name, instanceIndex ) & slotMask;
+	for( ; ; slotIndex = ( slotIndex + 1 ) & slotMask )
+	{
+		const Slot& rSlot = pTable->pSlots[ slotIndex ];
+
+		Asset* pObject = rSlot.pObject;
+		if( !pObject )
+		{
+			return NULL;
+		}
+
+		if( pObject != REMOVED_OBJECT &&
+			rSlot.pOwner == pOwner &&
+			rSlot.name == name &&
+			rSlot.instanceIndex == instanceIndex )
+		{
+			return &rSlot;
+		}
+	}
+}
+
+/// Compute the hash of an asset key.
+///
+/// @param[in] pOwner         Asset owner.
+/// @param[in] name           Asset name.
+/// @param[in] instanceIndex  Asset instance index.
+///
+/// @return  Hash value.
+size_t AssetRegistry::ComputeHash( const Asset* pOwner, Name name, uint32_t instanceIndex )
+{
+	size_t hash = Hash< Name >()( name );
+	hash = hash * 33 + static_cast< size_t >( reinterpret_cast< uintptr_t >( pOwner ) >> 4 );
+	hash = hash * 33 + instanceIndex;
+
+	// Mix the upper bits down, as the table only uses the lower bits.
+	hash ^= hash >> 15;
+	hash *= 0x2c1b3c6d;
+	hash ^= hash >> 12;
+
+	return hash;
+}
+
+/// Allocate a table with all slots unused.
+///
+/// @param[in] slotCount  Number of slots (must be a power of two).
+///
+/// @return  Table.
+AssetRegistry::Table* AssetRegistry::CreateTable( size_t slotCount )
+{
+	HELIUM_ASSERT( slotCount != 0 && ( slotCount & ( slotCount - 1 ) ) == 0 );
+
+	Table* pTable = new Table;
+	HELIUM_ASSERT( pTable );
+	pTable->pSlots = new Slot [ slotCount ];
+	HELIUM_ASSERT( pTable->pSlots );
+	pTable->slotCount = slotCount;
+	pTable->usedSlotCount = 0;
+	pTable->liveSlotCount = 0;
+
+	for( size_t slotIndex = 0; slotIndex < slotCount; ++slotIndex )
+	{
+		pTable->pSlots[ slotIndex ].pObject = NULL;
+	}
+
+	return pTable;
+}
+
+/// Free a table.
+///
+/// @param[in] pTable  Table to free (can be null).
+void AssetRegistry::DestroyTable( Table* pTable )
+{
+	if( pTable )
+	{
+		delete [] pTable->pSlots;
+		delete pTable;
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/Name.h"
+
+#include "Engine/Engine.h"
+
+namespace Helium
+{
+	class Asset;
+
+	/// Lookup table of named assets, keyed by owner, name, and instance index.
+	///
+	/// Lookups do not take any locks, so they can be done from any thread while assets are being added, renamed, and
+	/// removed.  Modifications must be serialized by the caller (Asset does this with its object list lock).
+	///
+	/// Slots are written once: a slot is filled when an asset is added, and only flagged as removed when the asset is
+	/// removed, so readers never see a slot change keys under them.  Once too many slots are used, the live slots are
+	/// copied into a new table, which replaces the old one.  Replaced tables are reclaimed using a two-epoch scheme: a
+	/// table is only freed once all readers that could have started a lookup in it have finished.
+	class HELIUM_ENGINE_API AssetRegistry : NonCopyable
+	{
+	public:
+		/// Minimum number of slots in a table.
+		static const size_t MIN_SLOT_COUNT = 256;
+
+		/// @name Construction/Destruction
+		//@{
+		AssetRegistry();
+		~AssetRegistry();
+		//@}
+
+		/// @name Lookup
+		//@{
+		Asset* Find( const Asset* pOwner, Name name, uint32_t instanceIndex ) const;
+		Asset* Find(
+			const Asset* pOwner, const Name* pRelativePathNames, const uint32_t* pInstanceIndices, size_t nameDepth,
+			size_t packageDepth ) const;
+		//@}
+
+		/// @name Modification
+		//@{
+		void Add( Asset* pObject, const Asset* pOwner, Name name, uint32_t instanceIndex );
+		void Remove( const Asset* pOwner, Name name, uint32_t instanceIndex );
+
+		void Shutdown();
+		//@}
+
+	private:
+		/// Asset entry slot.
+		struct Slot
+		{
+			/// Owning asset (null for top-level assets).
+			const Asset* pOwner;
+			/// Asset name.
+			Name name;
+			/// Asset instance index.
+			uint32_t instanceIndex;
+			/// True if the asset is a package.
+			bool bPackage;
+
+			/// Asset, null if the slot has never been used, or a reserved value if the asset has been removed.  Set last
+			/// when filling a slot, so the fields above are valid whenever this is not null.
+			Asset* volatile pObject;
+		};
+
+		/// Slot table.
+		struct Table
+		{
+			/// Slots (the slot count is always a power of two).
+			Slot* pSlots;
+			/// Number of slots.
+			size_t slotCount;
+			/// Number of slots that have been filled (including those of removed assets).
+			size_t usedSlotCount;
+			/// Number of slots holding assets that have not been removed.
+			size_t liveSlotCount;
+		};
+
+		/// Table replaced while readers may still be using it.
+		struct RetiredTable
+		{
+			/// Table.
+			Table* pTable;
+			/// Epoch during which the table was replaced.
+			int32_t epoch;
+		};
+
+		/// Current table, or null if no assets have been added yet.
+		Table* volatile m_pTable;
+
+		/// Current reader epoch.
+		volatile int32_t m_epoch;
+		/// Number of active readers in even and odd epochs.
+		mutable volatile int32_t m_readerCounts[ 2 ];
+		/// Replaced tables waiting to be freed.
+		DynamicArray< RetiredTable > m_retiredTables;
+
+		/// @name Private Utility Functions
+		//@{
+		int32_t BeginRead() const;
+		void EndRead( int32_t epoch ) const;
+
+		Table* Rebuild( size_t slotCount );
+		void ReclaimTables();
+		//@}
+
+		/// @name Private Static Utility Functions
+		//@{
+		static const Slot* FindSlot( const Table* pTable, const Asset* pOwner, Name name, uint32_t instanceIndex );
+		static size_t ComputeHash( const Asset* pOwner, Name name, uint32_t instanceIndex );
+
+		static Table* CreateTable( size_t slotCount );
+		static void DestroyTable( Table* pTable );
+		//@}
+	};
+}
@@ -1,9 +1,13 @@
 #include "Precompile.h"
 #include "Engine/AsyncLoader.h"
 
+#include "Platform/Timer.h"
 #include "Engine/FileLocations.h"
+#include "Engine/LoadStatistics.h"
 #include "Foundation/FileStream.h"
 
+#include <algorithm>
+
 using namespace Helium;
 
 static uint32_t g_InitCount = 0;
@@ -12,8 +16,9 @@ AsyncLoader* AsyncLoader::sm_pInstance = NULL;
 /// Constructor.
 AsyncLoader::AsyncLoader()
 	: m_requestPool( REQUEST_POOL_BLOCK_SIZE )
-	, m_pThread( NULL )
-	, m_pWorker( NULL )
+	, m_stopCounter( 0 )
+	, m_busyWorkerCount( 0 )
+	, m_pCompletionCondition( NULL )
 {
 }
 
@@ -25,20 +30,45 @@ AsyncLoader::~AsyncLoader()
 
 /// Initialize the async loader.
 ///
+/// @param[in] workerCount  Number of file loading threads to start.  Several threads keep more reads in flight, which
+///                         matters most on storage that serves requests in parallel.
+///
 /// @return  True if initialization was sucessful, false if not.
 ///
 /// @see Cleanup()
-bool AsyncLoader::Initialize()
+bool AsyncLoader::Initialize( uint32_t workerCount )
 {
 	Cleanup();
 
-	// Start up the async loading thread.
-	m_pWorker = new LoadWorker;
-	HELIUM_ASSERT( m_pWorker );
+	if( workerCount == 0 )
+	{
+		workerCount = 1;
+	}
 
-	m_pThread = new RunnableThread( m_pWorker );
-	HELIUM_ASSERT( m_pThread );
-	HELIUM_VERIFY( m_pThread->Start( "AsyncLoader - file loading" ) );
+	AtomicExchangeRelease( m_stopCounter, 0 );
+
+	// Split the open file budget between the workers.
+	size_t fileStreamLimit = FILE_STREAM_LIMIT / workerCount;
+	if( fileStreamLimit == 0 )
+	{
+		fileStreamLimit = 1;
+	}
+
+	// Start up the async loading threads.
+	m_workers.Reserve( workerCount );
+	m_workerThreads.Reserve( workerCount );
+	for( uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+	{
+		LoadWorker* pWorker = new LoadWorker( this, fileStreamLimit );
+		HELIUM_ASSERT( pWorker );
+
+		RunnableThread* pThread = new RunnableThread( pWorker );
+		HELIUM_ASSERT( pThread );
+		HELIUM_VERIFY( pThread->Start( "AsyncLoader - file loading" ) );
+
+		m_workers.Push( pWorker );
+		m_workerThreads.Push( pThread );
+	}
 
 	return true;
 }
@@ -48,45 +78,89 @@ bool AsyncLoader::Initialize()
 /// @see Initialize()
 void AsyncLoader::Cleanup()
 {
-	if( m_pWorker )
+	AtomicExchangeRelease( m_stopCounter, 1 );
+
+	size_t workerCount = m_workerThreads.GetSize();
+	for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
 	{
-		m_pWorker->Stop();
+		m_wakeUpSemaphore.Increment();
 	}
 
-	if( m_pThread )
+	for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
 	{
-		m_pThread->Join();
-		delete m_pThread;
-		m_pThread = NULL;
+		m_workerThreads[ workerIndex ]->Join();
+		delete m_workerThreads[ workerIndex ];
+		delete m_workers[ workerIndex ];
 	}
 
-	delete m_pWorker;
-	m_pWorker = NULL;
+	m_workerThreads.Clear();
+	m_workers.Clear();
+	m_wakeUpSemaphore.Reset();
+}
+
+/// Get the ID of a file to load from, assigning a new ID if the file has not been used before.
+///
+/// File IDs remain valid for the lifetime of the loader.  Callers that queue many requests for the same file should
+/// look up its ID once and queue requests by ID, which avoids looking up the file name for each request.
+///
+/// @param[in] rFileName  FilePath name of the file.
+///
+/// @return  File ID.
+///
+/// @see QueueRequest()
+uint32_t AsyncLoader::GetFileId( const String& rFileName )
+{
+	Name fileName( *rFileName );
+
+	MutexScopeLock scopeLock( m_fileLock );
+
+	HashMap< Name, uint32_t >::Iterator fileIterator = m_fileIds.Find( fileName );
+	if( fileIterator != m_fileIds.End() )
+	{
+		return fileIterator->Second();
+	}
+
+	uint32_t fileId = static_cast< uint32_t >( m_fileNames.GetSize() );
+	m_fileNames.Push( rFileName );
+	m_fileIds.Insert( fileIterator, HashMap< Name, uint32_t >::ValueType( fileName, fileId ) );
+
+	return fileId;
 }
 
 /// Queue an async load request.
 ///
-/// @param[in] pBuffer    Buffer in which to load data.
-/// @param[in] rFileName  FilePath name of the file from which to load.
-/// @param[in] offset     Byte offset within the file from which to load.
-/// @param[in] size       Number of bytes to read.
-/// @param[in] priority   Load priority.
+/// If a codec is given, the data read is decompressed into the buffer by the worker that read it, and the number of
+/// bytes reported for the request is the number of bytes decompressed (zero if decompression failed).
+///
+/// @param[in] pBuffer             Buffer in which to load data.  If the data is compressed, this must be at least
+///                                uncompressedSize bytes.
+/// @param[in] fileId              ID of the file from which to load (see GetFileId()).
+/// @param[in] offset              Byte offset within the file from which to load.
+/// @param[in] size                Number of bytes to read.
+/// @param[in] priority            Load priority.
+/// @param[in] codec               Codec with which the data read is compressed.
+/// @param[in] uncompressedSize    Maximum number of bytes to decompress into the buffer, if the data is compressed.
+/// @param[in] pCompletionCounter  Counter to atomically increment once the request has completed, or null.  The
+///                                request must still be released with SyncRequest() or TrySyncRequest().
 ///
 /// @return  ID identifying the load request if queued successfully, invalid index if the request queue failed.
 ///
 /// @see SyncRequest(), TrySyncRequest()
 size_t AsyncLoader::QueueRequest(
 	void* pBuffer,
-	const String& rFileName,
+	uint32_t fileId,
 	uint64_t offset,
 	size_t size,
-	EPriority priority )
+	EPriority priority,
+	CompressionCodec codec,
+	size_t uncompressedSize,
+	volatile int32_t* pCompletionCounter )
 {
 	HELIUM_ASSERT( pBuffer );
 	HELIUM_ASSERT( static_cast< size_t >( priority ) < static_cast< size_t >( PRIORITY_MAX ) );
 
-	// Make sure the load worker is running.
-	if( !m_pWorker )
+	// Make sure the load workers are running.
+	if( m_workers.IsEmpty() )
 	{
 		return Invalid< size_t >();
 	}
@@ -95,15 +169,30 @@ size_t AsyncLoader::QueueRequest(
 	Request* pRequest = m_requestPool.Allocate();
 	HELIUM_ASSERT( pRequest );
 	pRequest->pBuffer = pBuffer;
-	pRequest->fileName = rFileName;
+	pRequest->fileId = fileId;
 	pRequest->offset = offset;
 	pRequest->size = size;
 	pRequest->priority = priority;
+	pRequest->codec = codec;
+	pRequest->uncompressedSize = uncompressedSize;
+	pRequest->pCompletionCounter = pCompletionCounter;
+	pRequest->queuedTicks = Timer::GetTickCount();
+	pRequest->bReadAheadHinted = false;
 
 	pRequest->bytesRead = 0;
 	AtomicExchangeRelease( pRequest->processedCounter, 0 );
 
-	m_pWorker->QueueRequest( pRequest );
+	LoadStatistics::RecordReadsQueued( 1, size );
+
+	{
+		// Prevent access to the load queue while an exclusive write lock is held.
+		ScopeReadLock nonExclusiveLock( m_writeLock );
+
+		Locker< RequestQueue, SpinLock >::Handle handle( m_requestQueue );
+		handle->requests[ priority ].Push( pRequest );
+	}
+
+	m_wakeUpSemaphore.Increment();
 
 	size_t requestIndex = m_requestPool.GetIndex( pRequest );
 	HELIUM_ASSERT( IsValid( requestIndex ) );
@@ -111,6 +200,121 @@ size_t AsyncLoader::QueueRequest(
 	return requestIndex;
 }
 
+/// Queue an async load request for a file by name.
+///
+/// @param[in] pBuffer           Buffer in which to load data.  If the data is compressed, this must be at least
+///                              uncompressedSize bytes.
+/// @param[in] rFileName         FilePath name of the file from which to load.
+/// @param[in] offset            Byte offset within the file from which to load.
+/// @param[in] size              Number of bytes to read.
+/// @param[in] priority          Load priority.
+/// @param[in] codec             Codec with which the data read is compressed.
+/// @param[in] uncompressedSize  Maximum number of bytes to decompress into the buffer, if the data is compressed.
+///
+/// @return  ID identifying the load request if queued successfully, invalid index if the request queue failed.
+///
+/// @see GetFileId(), SyncRequest(), TrySyncRequest()
+size_t AsyncLoader::QueueRequest(
+	void* pBuffer,
+	const String& rFileName,
+	uint64_t offset,
+	size_t size,
+	EPriority priority,
+	CompressionCodec codec,
+	size_t uncompressedSize )
+{
+	// Make sure the load workers are running before registering the file.
+	if( m_workers.IsEmpty() )
+	{
+		return Invalid< size_t >();
+	}
+
+	return QueueRequest( pBuffer, GetFileId( rFileName ), offset, size, priority, codec, uncompressedSize );
+}
+
+/// Queue a set of async load requests at once.
+///
+/// All the requests are added to the queue together, so workers see the whole set and can serve requests that follow
+/// each other in a file with a single seek.  Requests should be given in file offset order to get the most out of
+/// this.
+///
+/// @param[in]  pRequests     Requests to queue (see QueueRequest() for the meaning of each parameter).
+/// @param[in]  requestCount  Number of requests to queue.
+/// @param[out] pRequestIds   Set to the ID of each request if queued successfully, invalid index if not.
+/// @param[in]  priority      Load priority for all of the requests.
+///
+/// @see QueueRequest(), SyncRequest(), TrySyncRequest()
+void AsyncLoader::QueueRequests(
+	const RequestInfo* pRequests,
+	size_t requestCount,
+	size_t* pRequestIds,
+	EPriority priority )
+{
+	HELIUM_ASSERT( pRequests || requestCount == 0 );
+	HELIUM_ASSERT( pRequestIds || requestCount == 0 );
+	HELIUM_ASSERT( static_cast< size_t >( priority ) < static_cast< size_t >( PRIORITY_MAX ) );
+
+	// Make sure the load workers are running.
+	if( m_workers.IsEmpty() )
+	{
+		for( size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex )
+		{
+			SetInvalid( pRequestIds[ requestIndex ] );
+		}
+
+		return;
+	}
+
+	uint64_t queuedTicks = Timer::GetTickCount();
+	uint64_t queuedByteCount = 0;
+
+	for( size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex )
+	{
+		const RequestInfo& rInfo = pRequests[ requestIndex ];
+		HELIUM_ASSERT( rInfo.pBuffer );
+		HELIUM_ASSERT( rInfo.fileId < m_fileNames.GetSize() );
+
+		Request* pRequest = m_requestPool.Allocate();
+		HELIUM_ASSERT( pRequest );
+		pRequest->pBuffer = rInfo.pBuffer;
+		pRequest->fileId = rInfo.fileId;
+		pRequest->offset = rInfo.offset;
+		pRequest->size = rInfo.size;
+		pRequest->priority = priority;
+		pRequest->codec = rInfo.codec;
+		pRequest->uncompressedSize = rInfo.uncompressedSize;
+		pRequest->pCompletionCounter = rInfo.pCompletionCounter;
+		pRequest->queuedTicks = queuedTicks;
+		pRequest->bReadAheadHinted = false;
+
+		pRequest->bytesRead = 0;
+		AtomicExchangeRelease( pRequest->processedCounter, 0 );
+
+		pRequestIds[ requestIndex ] = m_requestPool.GetIndex( pRequest );
+		HELIUM_ASSERT( IsValid( pRequestIds[ requestIndex ] ) );
+
+		queuedByteCount += rInfo.size;
+	}
+
+	LoadStatistics::RecordReadsQueued( requestCount, queuedByteCount );
+
+	{
+		// Prevent access to the load queue while an exclusive write lock is held.
+		ScopeReadLock nonExclusiveLock( m_writeLock );
+
+		Locker< RequestQueue, SpinLock >::Handle handle( m_requestQueue );
+		for( size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex )
+		{
+			handle->requests[ priority ].Push( m_requestPool.GetObject( pRequestIds[ requestIndex ] ) );
+		}
+	}
+
+	for( size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex )
+	{
+		m_wakeUpSemaphore.Increment();
+	}
+}
+
 /// Block the current thread until the load request with the specified ID completes and release the request
 /// information.
 ///
@@ -176,10 +380,41 @@ bool AsyncLoader::TrySyncRequest( size_t id, size_t& rBytesRead )
 /// pending requests in order to free any associated resources.
 void AsyncLoader::Flush()
 {
-	if( m_pWorker )
+	// Workers only go idle once they have closed their files, so this also waits for all files to be closed.
+	while( !IsQueueEmpty() || m_busyWorkerCount != 0 )
+	{
+		Thread::Yield();
+	}
+}
+
+/// Get the number of load requests queued and not yet taken by a worker.
+///
+/// Requests a worker is serving are not counted (see GetBusyWorkerCount()).
+///
+/// @return  Number of queued requests, over all priorities.
+size_t AsyncLoader::GetQueuedRequestCount()
+{
+	size_t requestCount = 0;
+
+	Locker< RequestQueue, SpinLock >::Handle handle( m_requestQueue );
+	for( size_t priority = 0; priority < PRIORITY_MAX; ++priority )
 	{
-		m_pWorker->Flush();
+		requestCount += handle->requests[ priority ].GetSize();
 	}
+
+	return requestCount;
+}
+
+/// Set a condition to signal each time a load request completes.
+///
+/// The condition is signaled by the worker that completed the request, after the request has been flagged as
+/// processed, so a thread woken by it will find the request ready to sync.  This should be set before requests that
+/// rely on it are queued, and cleared before the condition is destroyed.
+///
+/// @param[in] pCondition  Condition to signal, or null to stop signaling.
+void AsyncLoader::SetCompletionCondition( Condition* pCondition )
+{
+	m_pCompletionCondition = pCondition;
 }
 
 /// Lock async loading for writing to files that may be in use.
@@ -187,10 +422,10 @@ void AsyncLoader::Flush()
 /// @see Unlock()
 void AsyncLoader::Lock()
 {
-	if( m_pWorker )
-	{
-		m_pWorker->Lock();
-	}
+	// Prevent other threads from queueing requests or writing out data while we have a write lock.
+	m_writeLock.LockWrite();
+
+	Flush();
 }
 
 /// Unlock a previous loader lock.
@@ -198,10 +433,7 @@ void AsyncLoader::Lock()
 /// @see Lock()
 void AsyncLoader::Unlock()
 {
-	if( m_pWorker )
-	{
-		m_pWorker->Unlock();
-	}
+	m_writeLock.UnlockWrite();
 }
 
 /// Get the singleton AsyncLoader instance.
@@ -245,17 +477,150 @@ void AsyncLoader::Shutdown()
 	}
 }
 
+/// Get the name of a file from its ID.
+///
+/// @param[in]  fileId     File ID.
+/// @param[out] rFileName  File name.
+void AsyncLoader::GetFileName( uint32_t fileId, String& rFileName )
+{
+	MutexScopeLock scopeLock( m_fileLock );
+
+	HELIUM_ASSERT( fileId < m_fileNames.GetSize() );
+	rFileName = m_fileNames[ fileId ];
+}
+
+/// Take the oldest request of the highest priority pending, along with any queued requests that continue reading
+/// the same file from where it ends.
+///
+/// @param[out] rRequests  Requests taken, in file order.
+///
+/// @return  True if any requests were taken, false if the queue was empty.
+bool AsyncLoader::TakeRequests( DynamicArray< Request* >& rRequests )
+{
+	rRequests.Resize( 0 );
+
+	Locker< RequestQueue, SpinLock >::Handle handle( m_requestQueue );
+
+	for( int32_t priority = PRIORITY_LAST; priority >= PRIORITY_FIRST; --priority )
+	{
+		DynamicArray< Request* >& rQueue = handle->requests[ priority ];
+		if( !rQueue.IsEmpty() )
+		{
+			rRequests.Push( rQueue[ 0 ] );
+			rQueue.Remove( 0 );
+			break;
+		}
+	}
+
+	if( rRequests.IsEmpty() )
+	{
+		return false;
+	}
+
+	// Follow the chain of adjacent reads across all priorities, since serving them now is cheaper than seeking back
+	// to them later.
+	uint32_t fileId = rRequests[ 0 ]->fileId;
+	bool bFound = true;
+	while( bFound && rRequests.GetSize() < COALESCED_REQUEST_LIMIT )
+	{
+		bFound = false;
+
+		const Request* pLast = rRequests.GetLast();
+		uint64_t nextOffset = pLast->offset + pLast->size;
+
+		for( int32_t priority = PRIORITY_LAST; priority >= PRIORITY_FIRST && !bFound; --priority )
+		{
+			DynamicArray< Request* >& rQueue = handle->requests[ priority ];
+			size_t queueSize = rQueue.GetSize();
+			for( size_t requestIndex = 0; requestIndex < queueSize; ++requestIndex )
+			{
+				Request* pRequest = rQueue[ requestIndex ];
+				if( pRequest->offset == nextOffset && pRequest->fileId == fileId )
+				{
+					rRequests.Push( pRequest );
+					rQueue.Remove( requestIndex );
+					bFound = true;
+
+					break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+/// Take the ranges of the next queued requests that have not been hinted for read-ahead yet, in the order they will be
+/// served, and flag them as hinted.
+///
+/// @param[out] rRanges  File ranges of the requests taken (at most READ_AHEAD_REQUEST_LIMIT).
+void AsyncLoader::TakeReadAheadRanges( DynamicArray< ReadAheadRange >& rRanges )
+{
+	rRanges.Resize( 0 );
+
+	Locker< RequestQueue, SpinLock >::Handle handle( m_requestQueue );
+
+	for( int32_t priority = PRIORITY_LAST; priority >= PRIORITY_FIRST; --priority )
+	{
+		DynamicArray< Request* >& rQueue = handle->requests[ priority ];
+		size_t queueSize = rQueue.GetSize();
+		for( size_t requestIndex = 0; requestIndex < queueSize; ++requestIndex )
+		{
+			if( rRanges.GetSize() >= READ_AHEAD_REQUEST_LIMIT )
+			{
+				return;
+			}
+
+			Request* pRequest = rQueue[ requestIndex ];
+			if( pRequest->bReadAheadHinted )
+			{
+				continue;
+			}
+
+			pRequest->bReadAheadHinted = true;
+
+			ReadAheadRange* pRange = rRanges.New();
+			HELIUM_ASSERT( pRange );
+			pRange->fileId = pRequest->fileId;
+			pRange->offset = pRequest->offset;
+			pRange->size = pRequest->size;
+		}
+	}
+}
+
+/// Get whether no requests are waiting in the queue (requests being processed are not counted).
+///
+/// @return  True if the request queue is empty, false if not.
+bool AsyncLoader::IsQueueEmpty()
+{
+	Locker< RequestQueue, SpinLock >::Handle handle( m_requestQueue );
+	for( size_t priority = 0; priority < PRIORITY_MAX; ++priority )
+	{
+		if( !handle->requests[ priority ].IsEmpty() )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /// Constructor.
-AsyncLoader::LoadWorker::LoadWorker()
-	: m_wakeUpCondition( false, false )
-	, m_stopCounter( 0 )
-	, m_processingCounter( 0 )
+///
+/// @param[in] pLoader          Owning loader.
+/// @param[in] fileStreamLimit  Maximum number of files this worker keeps open.
+AsyncLoader::LoadWorker::LoadWorker( AsyncLoader* pLoader, size_t fileStreamLimit )
+	: m_pLoader( pLoader )
+	, m_fileStreamLimit( fileStreamLimit )
 {
+	HELIUM_ASSERT( pLoader );
+	HELIUM_ASSERT( fileStreamLimit != 0 );
 }
 
 /// Destructor.
 AsyncLoader::LoadWorker::~LoadWorker()
 {
+	CloseCachedFiles();
 }
 
 /// Execute the async loading work.
@@ -264,119 +629,248 @@ void AsyncLoader::LoadWorker::Run()
 	BufferedStream* pBufferedStream = new BufferedStream;
 	HELIUM_ASSERT( pBufferedStream );
 
-	while( m_stopCounter == 0 )
-	{
-		AtomicExchangeAcquire( m_processingCounter, 1 );
+	AtomicIncrementAcquire( m_pLoader->m_busyWorkerCount );
 
-		Request* pRequest;
-		{
-			Locker< DynamicArray< Request* >, SpinLock >::Handle handle ( m_requestQueue );
-			pRequest = handle->IsEmpty() ? NULL : handle->Pop();
-		}
-		if( !pRequest )
+	while( m_pLoader->m_stopCounter == 0 )
+	{
+		if( !m_pLoader->TakeRequests( m_requests ) )
 		{
-			// Queue is empty, so sleep until notified.
-			AtomicExchangeRelease( m_processingCounter, 0 );
-			m_wakeUpCondition.Wait();
+			// Queue is empty, so release our files (they may be written while the loader is locked) and sleep until
+			// notified.
+			CloseCachedFiles();
+			AtomicDecrementRelease( m_pLoader->m_busyWorkerCount );
+
+			m_pLoader->m_wakeUpSemaphore.Decrement();
+
+			AtomicIncrementAcquire( m_pLoader->m_busyWorkerCount );
 
 			continue;
 		}
 
-		HELIUM_ASSERT( pRequest );
+		HintUpcomingReads();
+		ProcessRequests( pBufferedStream );
+	}
 
-		FileStream* pFileStream = FileStream::OpenFileStream( pRequest->fileName, FileStream::MODE_READ );
-		if( !pFileStream )
-		{
-			SetInvalid( pRequest->bytesRead );
-		}
-		else
+	CloseCachedFiles();
+	AtomicDecrementRelease( m_pLoader->m_busyWorkerCount );
+
+	delete pBufferedStream;
+}
+
+/// Hint the OS to start reading the data of the next queued requests.
+///
+/// Ranges are sorted and merged per file so that each file is opened once and adjacent requests are hinted as a
+/// single range.
+void AsyncLoader::LoadWorker::HintUpcomingReads()
+{
+	if( !ReadAhead::IsFileHintSupported() )
+	{
+		return;
+	}
+
+	m_pLoader->TakeReadAheadRanges( m_readAheadRanges );
+
+	size_t rangeCount = m_readAheadRanges.GetSize();
+	if( rangeCount == 0 )
+	{
+		return;
+	}
+
+	ReadAheadRange* pRanges = m_readAheadRanges.GetData();
+	std::sort( pRanges, pRanges + rangeCount );
+
+	size_t rangeIndex = 0;
+	while( rangeIndex < rangeCount )
+	{
+		uint32_t fileId = pRanges[ rangeIndex ].fileId;
+
+		m_fileReadAheadRanges.Resize( 0 );
+		for( ; rangeIndex < rangeCount && pRanges[ rangeIndex ].fileId == fileId; ++rangeIndex )
 		{
-			pRequest->bytesRead = 0;
+			const ReadAheadRange& rRange = pRanges[ rangeIndex ];
 
-			pBufferedStream->Open( pFileStream );
-			int64_t offset = pBufferedStream->Seek( pRequest->offset, SeekOrigins::Begin );
-			if( static_cast< uint64_t >( offset ) == pRequest->offset )
+			ReadAhead::Range* pLastRange = m_fileReadAheadRanges.IsEmpty() ? NULL : &m_fileReadAheadRanges.GetLast();
+			if( pLastRange && rRange.offset <= pLastRange->offset + pLastRange->size )
 			{
-				pRequest->bytesRead = pBufferedStream->Read( pRequest->pBuffer, 1, pRequest->size );
-			}
+				pLastRange->size = Max( pLastRange->size, rRange.offset + rRange.size - pLastRange->offset );
 
-			pBufferedStream->Open( NULL );
+				continue;
+			}
 
-			delete pFileStream;
+			ReadAhead::Range* pFileRange = m_fileReadAheadRanges.New();
+			HELIUM_ASSERT( pFileRange );
+			pFileRange->offset = rRange.offset;
+			pFileRange->size = rRange.size;
 		}
 
-		AtomicExchangeRelease( pRequest->processedCounter, 1 );
+		m_pLoader->GetFileName( fileId, m_fileName );
+		ReadAhead::HintFileRanges( *m_fileName, m_fileReadAheadRanges.GetData(), m_fileReadAheadRanges.GetSize() );
+	}
+}
 
-		Thread::Yield();
+/// Serve the requests taken by TakeRequests() with a single seek.
+///
+/// @param[in] pBufferedStream  Buffered stream to use for reading.
+void AsyncLoader::LoadWorker::ProcessRequests( BufferedStream* pBufferedStream )
+{
+	HELIUM_ASSERT( pBufferedStream );
+	HELIUM_ASSERT( !m_requests.IsEmpty() );
+
+	size_t requestCount = m_requests.GetSize();
+
+	FileStream* pFileStream = OpenCachedFile( m_requests[ 0 ]->fileId );
+	if( !pFileStream )
+	{
+		for( size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex )
+		{
+			Request* pRequest = m_requests[ requestIndex ];
+			SetInvalid( pRequest->bytesRead );
+			CompleteRequest( pRequest );
+		}
+
+		return;
 	}
 
-	AtomicExchangeRelease( m_processingCounter, 0 );
+	pBufferedStream->Open( pFileStream );
 
-	delete pBufferedStream;
-}
+	Request* pFirstRequest = m_requests[ 0 ];
+	int64_t offset = pBufferedStream->Seek( pFirstRequest->offset, SeekOrigins::Begin );
+	bool bInRange = ( static_cast< uint64_t >( offset ) == pFirstRequest->offset );
 
-/// Request the load worker to stop processing and return at the next possible opportunity.
-void AsyncLoader::LoadWorker::Stop()
-{
-	AtomicExchangeRelease( m_stopCounter, 1 );
-	m_wakeUpCondition.Signal();
+	for( size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex )
+	{
+		Request* pRequest = m_requests[ requestIndex ];
+		pRequest->bytesRead = 0;
+
+		// Once a read comes up short, the following requests start past the end of the file.
+		if( bInRange && pRequest->codec != CompressionCodecs::None )
+		{
+			m_compressedData.Resize( pRequest->size );
+			size_t compressedBytesRead = pBufferedStream->Read( m_compressedData.GetData(), 1, pRequest->size );
+			bInRange = ( compressedBytesRead == pRequest->size );
+
+			if( bInRange )
+			{
+				size_t decompressedSize = Compression::Decompress(
+					pRequest->codec,
+					pRequest->pBuffer,
+					pRequest->uncompressedSize,
+					m_compressedData.GetData(),
+					compressedBytesRead );
+				if( IsInvalid( decompressedSize ) )
+				{
+					m_pLoader->GetFileName( pRequest->fileId, m_fileName );
+					HELIUM_TRACE(
+						TraceLevels::Error,
+						"AsyncLoader: Failed to decompress %" PRIuSZ " bytes at offset %" PRIu64 " of \"%s\".\n",
+						pRequest->size,
+						pRequest->offset,
+						*m_fileName );
+
+					decompressedSize = 0;
+				}
+
+				pRequest->bytesRead = decompressedSize;
+			}
+		}
+		else if( bInRange )
+		{
+			pRequest->bytesRead = pBufferedStream->Read( pRequest->pBuffer, 1, pRequest->size );
+			bInRange = ( pRequest->bytesRead == pRequest->size );
+		}
+
+		CompleteRequest( pRequest );
+	}
+
+	pBufferedStream->Open( NULL );
 }
 
-/// Queue an async load request.
+/// Get an open stream to the given file, opening it if this worker does not already have it open.
 ///
-/// @param[in] pRequest  Request to queue.  Note that the @c processedCounter value should be set to 0 prior to
-///                      calling this function (the worker thread will set it to 1 once the request has been
-///                      processed).
+/// @param[in] fileId  ID of the file to open.
 ///
-/// @see Flush()
-void AsyncLoader::LoadWorker::QueueRequest( Request* pRequest )
+/// @return  Stream to the file, or null if the file could not be opened.
+FileStream* AsyncLoader::LoadWorker::OpenCachedFile( uint32_t fileId )
 {
-	HELIUM_ASSERT( pRequest );
-	HELIUM_ASSERT( pRequest->processedCounter == 0 );
+	size_t openFileCount = m_openFiles.GetSize();
+	for( size_t fileIndex = 0; fileIndex < openFileCount; ++fileIndex )
+	{
+		if( m_openFiles[ fileIndex ].fileId == fileId )
+		{
+			// Move to the most recently used end.
+			OpenFile openFile = m_openFiles[ fileIndex ];
+			m_openFiles.Remove( fileIndex );
+			m_openFiles.Push( openFile );
+
+			return openFile.pStream;
+		}
+	}
 
-	// Prevent access to the load queue while an exclusive write lock is held.
-	ScopeReadLock nonExclusiveLock( m_writeLock );
+	m_pLoader->GetFileName( fileId, m_fileName );
+	FileStream* pFileStream = FileStream::OpenFileStream( m_fileName, FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		return NULL;
+	}
 
+	if( openFileCount >= m_fileStreamLimit )
 	{
-		Locker< DynamicArray< Request* >, SpinLock >::Handle handle ( m_requestQueue );
-		handle->Push( pRequest );
+		delete m_openFiles[ 0 ].pStream;
+		m_openFiles.Remove( 0 );
 	}
 
-	m_wakeUpCondition.Signal();
+	OpenFile* pOpenFile = m_openFiles.New();
+	HELIUM_ASSERT( pOpenFile );
+	pOpenFile->fileId = fileId;
+	pOpenFile->pStream = pFileStream;
+
+	return pFileStream;
 }
 
-/// Block the current thread until all pending load requests have completed.
+/// Flag a request as processed and signal its completion counter, if any.
 ///
-/// @see QueueRequest()
-void AsyncLoader::LoadWorker::Flush()
+/// @param[in] pRequest  Request that has been processed.
+void AsyncLoader::LoadWorker::CompleteRequest( Request* pRequest )
 {
-	bool isEmpty;
+	HELIUM_ASSERT( pRequest );
+
+	// Compressed data is read in full before being decompressed, so the bytes read from the file are the compressed
+	// size of the request.
+	size_t bytesRead = pRequest->bytesRead;
+	if( IsInvalid( bytesRead ) )
 	{
-		Locker< DynamicArray< Request* >, SpinLock >::Handle handle ( m_requestQueue );
-		isEmpty = handle->IsEmpty();
+		bytesRead = 0;
 	}
-
-	while( m_processingCounter != 0 && !isEmpty )
+	else if( pRequest->codec != CompressionCodecs::None && bytesRead != 0 )
 	{
-		Thread::Yield();
+		bytesRead = pRequest->size;
 	}
-}
 
-/// Acquire an exclusive lock for writing to files and flush the async loader queue.
-///
-/// @see Unlock()
-void AsyncLoader::LoadWorker::Lock()
-{
-	// Prevent other threads from queueing requests or writing out data while we have a write lock.
-	m_writeLock.LockWrite();
+	LoadStatistics::RecordReadCompleted( pRequest->size, bytesRead, Timer::GetTickCount() - pRequest->queuedTicks );
 
-	Flush();
+	// Grab the counter first, since the request may be released as soon as it is flagged as processed.
+	volatile int32_t* pCompletionCounter = pRequest->pCompletionCounter;
+	AtomicExchangeRelease( pRequest->processedCounter, 1 );
+	if( pCompletionCounter )
+	{
+		AtomicIncrementRelease( *pCompletionCounter );
+	}
+
+	Condition* pCompletionCondition = m_pLoader->m_pCompletionCondition;
+	if( pCompletionCondition )
+	{
+		pCompletionCondition->Signal();
+	}
 }
 
-/// Release an exclusive lock for writing to files.
-///
-/// @see Lock()
-void AsyncLoader::LoadWorker::Unlock()
+/// Close all files held open by this worker.
+void AsyncLoader::LoadWorker::CloseCachedFiles()
 {
-	m_writeLock.UnlockWrite();
+	size_t openFileCount = m_openFiles.GetSize();
+	for( size_t fileIndex = 0; fileIndex < openFileCount; ++fileIndex )
+	{
+		delete m_openFiles[ fileIndex ].pStream;
+	}
+
+	m_openFiles.Clear();
 }
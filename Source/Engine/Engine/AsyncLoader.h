@@ -2,24 +2,53 @@
 
 #include "Platform/Condition.h"
 #include "Platform/Locks.h"
+#include "Platform/Semaphore.h"
 #include "Platform/Thread.h"
 
 #include "Foundation/DynamicArray.h"
+#include "Foundation/HashMap.h"
+#include "Foundation/Name.h"
 #include "Foundation/ObjectPool.h"
 #include "Foundation/String.h"
 
 #include "Engine/Engine.h"
+#include "Engine/Compression.h"
+#include "Engine/ReadAhead.h"
 
 namespace Helium
 {
+	class FileStream;
+	class BufferedStream;
+
 	/// Async loading manager.
+	///
+	/// Requests are served by a pool of file loading threads so that several reads can be in flight at once.  Each
+	/// priority level has its own FIFO queue, and higher priority queues are always drained first.  A worker that
+	/// takes a request also takes any queued requests that continue reading the same file where it leaves off, and
+	/// serves them with a single seek.  Workers keep recently used files open while there is work queued, and close
+	/// them all once the queue runs dry.  Before serving its requests, a worker also hints the OS to start reading the
+	/// ranges of the next few queued requests (see ReadAhead), so their data is already being fetched by the time a
+	/// worker gets to them.  Compressed requests are decompressed by the worker that read them as soon as
+	/// the read completes, so decompression runs in parallel across the workers.
+	///
+	/// File names are interned into numeric file IDs (see GetFileId()), so requests are plain records that can be
+	/// queued, matched against each other, and recycled without copying or allocating any strings.  Callers that queue
+	/// many requests can also pass a completion counter that is incremented as each request completes, and only poll
+	/// their requests once it has changed.  A thread waiting on loads can also have a condition signaled as each
+	/// request completes (see SetCompletionCondition()) instead of polling at a fixed interval.
 	class HELIUM_ENGINE_API AsyncLoader : NonCopyable
 	{
 	public:
 		/// Request pool block size.
 		static const size_t REQUEST_POOL_BLOCK_SIZE = 128;
-		/// Maximum number of open file streams.
+		/// Maximum number of open file streams, shared between all workers.
 		static const size_t FILE_STREAM_LIMIT = 16;
+		/// Default number of file loading threads.
+		static const uint32_t DEFAULT_WORKER_COUNT = 4;
+		/// Maximum number of adjacent requests served by a single seek.
+		static const size_t COALESCED_REQUEST_LIMIT = 32;
+		/// Maximum number of queued requests hinted for read-ahead by a worker at a time.
+		static const size_t READ_AHEAD_REQUEST_LIMIT = 16;
 
 		/// Load request priority.
 		enum EPriority
@@ -35,26 +64,66 @@ namespace Helium
 			PRIORITY_LAST = PRIORITY_MAX - 1
 		};
 
+		/// Parameters for one of a set of requests queued through QueueRequests().
+		struct RequestInfo
+		{
+			/// Buffer in which to load data.
+			void* pBuffer;
+			/// ID of the file from which to load (see GetFileId()).
+			uint32_t fileId;
+			/// Byte offset within the file from which to begin reading.
+			uint64_t offset;
+			/// Number of bytes to read.
+			size_t size;
+			/// Codec with which the data read is compressed.
+			CompressionCodec codec;
+			/// Number of bytes to decompress into the buffer, if the data is compressed.
+			size_t uncompressedSize;
+			/// Counter to increment once the request has completed, or null.
+			volatile int32_t* pCompletionCounter;
+		};
+
 		/// @name Initialization
 		//@{
-		bool Initialize();
+		bool Initialize( uint32_t workerCount = DEFAULT_WORKER_COUNT );
 		void Cleanup();
 		//@}
 
+		/// @name File Registration
+		//@{
+		uint32_t GetFileId( const String& rFileName );
+		//@}
+
 		/// @name Load Request Management
 		//@{
+		size_t QueueRequest(
+			void* pBuffer, uint32_t fileId, uint64_t offset, size_t size,
+			EPriority priority = PRIORITY_NORMAL, CompressionCodec codec = CompressionCodecs::None,
+			size_t uncompressedSize = 0, volatile int32_t* pCompletionCounter = NULL );
 		size_t QueueRequest(
 			void* pBuffer, const String& rFileName, uint64_t offset, size_t size,
+			EPriority priority = PRIORITY_NORMAL, CompressionCodec codec = CompressionCodecs::None,
+			size_t uncompressedSize = 0 );
+		void QueueRequests(
+			const RequestInfo* pRequests, size_t requestCount, size_t* pRequestIds,
 			EPriority priority = PRIORITY_NORMAL );
 		size_t SyncRequest( size_t id );
 		bool TrySyncRequest( size_t id, size_t& rBytesRead );
 
 		void Flush();
 
+		size_t GetQueuedRequestCount();
+		inline uint32_t GetBusyWorkerCount() const;
+
 		void Lock();
 		void Unlock();
 		//@}
 
+		/// @name Completion Notification
+		//@{
+		void SetCompletionCondition( Condition* pCondition );
+		//@}
+
 		/// @name Static Access
 		//@{
 		static AsyncLoader* GetInstance();
@@ -68,14 +137,24 @@ namespace Helium
 		{
 			/// Output buffer.
 			void* pBuffer;
-			/// File name.
-			String fileName;
+			/// File ID.
+			uint32_t fileId;
 			/// Offset from which to begin reading.
 			uint64_t offset;
 			/// Number of bytes to read.
 			size_t size;
 			/// Priority.
 			EPriority priority;
+			/// Codec with which the data read is compressed.
+			CompressionCodec codec;
+			/// Number of bytes to decompress into the output buffer, if the data is compressed.
+			size_t uncompressedSize;
+			/// Counter to increment once this request has been processed, or null.
+			volatile int32_t* pCompletionCounter;
+			/// Timer tick count when the request was queued.
+			uint64_t queuedTicks;
+			/// True once a read-ahead hint has been issued for the request (only accessed with the queue locked).
+			bool bReadAheadHinted;
 
 			/// Number of bytes read.
 			volatile size_t bytesRead;
@@ -83,13 +162,36 @@ namespace Helium
 			volatile int32_t processedCounter;
 		};
 
+		/// Queued requests, in FIFO order for each priority level.
+		struct RequestQueue
+		{
+			/// Pending requests for each priority.
+			DynamicArray< Request* > requests[ PRIORITY_MAX ];
+		};
+
+		/// File range of a queued request to hint for read-ahead.
+		struct ReadAheadRange
+		{
+			/// File ID.
+			uint32_t fileId;
+			/// Byte offset of the start of the range.
+			uint64_t offset;
+			/// Number of bytes in the range.
+			uint64_t size;
+
+			/// @name Overloaded Operators
+			//@{
+			inline bool operator<( const ReadAheadRange& rOther ) const;
+			//@}
+		};
+
 		/// Async loading thread runnable.
 		class LoadWorker : public Runnable
 		{
 		public:
 			/// @name Construction/Destruction
 			//@{
-			LoadWorker();
+			LoadWorker( AsyncLoader* pLoader, size_t fileStreamLimit );
 			virtual ~LoadWorker();
 			//@}
 
@@ -98,42 +200,73 @@ namespace Helium
 			virtual void Run();
 			//@}
 
-			/// @name External Thread Control
-			//@{
-			void Stop();
-			//@}
+		private:
+			/// File kept open between requests.
+			struct OpenFile
+			{
+				/// File ID.
+				uint32_t fileId;
+				/// Stream to the file.
+				FileStream* pStream;
+			};
 
-			/// @name External Request Queue Control
-			//@{
-			void QueueRequest( Request* pRequest );
-			void Flush();
+			/// Owning loader.
+			AsyncLoader* m_pLoader;
+			/// Open files, from least to most recently used.
+			DynamicArray< OpenFile > m_openFiles;
+			/// Maximum number of files this worker keeps open.
+			size_t m_fileStreamLimit;
+			/// Requests taken from the queue to be served together.
+			DynamicArray< Request* > m_requests;
+			/// Scratch buffer for compressed data.
+			DynamicArray< uint8_t > m_compressedData;
+			/// Scratch file name for opening files and reporting errors.
+			String m_fileName;
+			/// Scratch list of queued request ranges to hint for read-ahead.
+			DynamicArray< ReadAheadRange > m_readAheadRanges;
+			/// Scratch list of the merged read-ahead ranges of a single file.
+			DynamicArray< ReadAhead::Range > m_fileReadAheadRanges;
 
-			void Lock();
-			void Unlock();
+			/// @name Private Utility Functions
+			//@{
+			void HintUpcomingReads();
+			void ProcessRequests( BufferedStream* pBufferedStream );
+			FileStream* OpenCachedFile( uint32_t fileId );
+			void CompleteRequest( Request* pRequest );
+			void CloseCachedFiles();
 			//@}
-
-		private:
-			/// Async load request queue.
-			Locker< DynamicArray< Request* >, SpinLock > m_requestQueue;
-			/// Condition used to wake up the worker thread when load requests are queued (or when it should shut down).
-			Condition m_wakeUpCondition;
-
-			/// Read-write lock used for synchronization of external file writes.
-			ReadWriteLock m_writeLock;
-
-			/// Non-zero if this thread should stop when next possible, zero if it should continue.
-			volatile int32_t m_stopCounter;
-			/// Non-zero if this thread is currently processing a load request.
-			volatile int32_t m_processingCounter;
 		};
 
 		/// Pool of async load request objects.
 		ObjectPool< Request > m_requestPool;
 
-		/// Async loading thread.
-		RunnableThread* m_pThread;
-		/// Async loading thread worker.
-		LoadWorker* m_pWorker;
+		/// File IDs of each file name requested.
+		HashMap< Name, uint32_t > m_fileIds;
+		/// File names, indexed by file ID.
+		DynamicArray< String > m_fileNames;
+		/// Lock for the file ID table.
+		Mutex m_fileLock;
+
+		/// Async load request queue, shared by all workers.
+		Locker< RequestQueue, SpinLock > m_requestQueue;
+		/// Semaphore used to wake up sleeping workers when load requests are queued (or when they should shut down).
+		Semaphore m_wakeUpSemaphore;
+
+		/// Read-write lock used for synchronization of external file writes.
+		ReadWriteLock m_writeLock;
+
+		/// Async loading threads.
+		DynamicArray< RunnableThread* > m_workerThreads;
+		/// Async loading thread workers.
+		DynamicArray< LoadWorker* > m_workers;
+
+		/// Non-zero if the workers should stop when next possible, zero if they should continue.
+		volatile int32_t m_stopCounter;
+		/// Number of workers that are processing requests or may still hold open files.
+		volatile int32_t m_busyWorkerCount;
+
+		/// Condition signaled each time a request completes, or null.
+		Condition* volatile m_pCompletionCondition;
 
 		/// Singleton instance.
 		static AsyncLoader* sm_pInstance;
@@ -143,5 +276,17 @@ namespace Helium
 		AsyncLoader();
 		~AsyncLoader();
 		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		void GetFileName( uint32_t fileId, String& rFileName );
+
+		bool TakeRequests( DynamicArray< Request* >& rRequests );
+		void TakeReadAheadRanges( DynamicArray< ReadAheadRange >& rRanges );
+		bool IsQueueEmpty();
+		//@}
 	};
 }
+
+#include "Engine/AsyncLoader.inl"
+
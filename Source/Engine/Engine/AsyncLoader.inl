@@ -0,0 +1,22 @@
+namespace Helium
+{
+	/// Get the number of workers currently serving requests or holding open files.
+	///
+	/// @return  Number of busy workers.
+	///
+	/// @see GetQueuedRequestCount()
+	uint32_t AsyncLoader::GetBusyWorkerCount() const
+	{
+		return static_cast< uint32_t >( m_busyWorkerCount );
+	}
+
+	/// Order read-ahead ranges by file, then by offset within the file.
+	///
+	/// @param[in] rOther  Range with which to compare.
+	///
+	/// @return  True if this range comes before the given range, false if not.
+	bool AsyncLoader::ReadAheadRange::operator<( const ReadAheadRange& rOther ) const
+	{
+		return ( fileId != rOther.fileId ? fileId < rOther.fileId : offset < rOther.offset );
+	}
+}
@@ -1,13 +1,35 @@
 #include "Precompile.h"
 #include "Engine/Cache.h"
 
+#include "Platform/Atomic.h"
+
 #include "Foundation/FileStream.h"
 #include "Foundation/MemoryStream.h"
 #include "Foundation/StringConverter.h"
 
 #include "Engine/Asset.h"
+#include "Engine/CacheAccessTrace.h"
+#include "Engine/CookedObjectLayout.h"
 #include "Engine/FileLocations.h"
 #include "Engine/AsyncLoader.h"
+#include "Engine/MemoryTelemetry.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if HELIUM_CPU_X86
+#include <emmintrin.h>
+#endif
+
+#if HELIUM_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #define USE_BSON_FOR_CACHE_FORMAT 0
 #define USE_JSON_FOR_CACHE_FORMAT 1
@@ -32,8 +54,51 @@ using namespace Helium;
 static const uint32_t TOC_MAGIC = 0xcac4e70c;
 /// TOC header magic number (byte-swapped).
 static const uint32_t TOC_MAGIC_SWAPPED = 0x0ce7c4ca;
-/// Cache format version number.
-const uint32_t Cache::sm_Version = 0;
+/// Cache format version number.  Version 1 TOCs may be followed by a journal of appended entry records.  Version 2
+/// TOCs store fixed-size records keyed by path hash, optionally followed by a path table, ahead of the journal.
+/// Version 3 adds the compression codec and uncompressed size to each record, and flags whether the records are
+/// hashed or keyed by path strings.  Version 4 adds the hash of each entry's stored data, so that entries storing the
+/// same bytes can share their data.
+const uint32_t Cache::sm_Version = 4;
+
+/// TOC flag set if the records are followed by a path table (version 2 and up).
+static const uint32_t TOC_FLAG_PATH_TABLE = 1 << 0;
+/// TOC flag set if the records are hashed, fixed-size records (version 3 and up; version 2 records are always hashed).
+static const uint32_t TOC_FLAG_HASHED = 1 << 1;
+
+/// Hashed TOC record as stored in version 2 TOCs.
+struct TocRecordVersion2
+{
+	/// Stable hash of the entry path.
+	uint64_t pathHash;
+	/// Entry offset.
+	uint64_t offset;
+	/// Entry timestamp.
+	int64_t timestamp;
+	/// Sub-data index.
+	uint32_t subDataIndex;
+	/// Entry size.
+	uint32_t size;
+};
+
+/// Hashed TOC record as stored in version 3 TOCs.
+struct TocRecordVersion3
+{
+	/// Stable hash of the entry path.
+	uint64_t pathHash;
+	/// Entry offset.
+	uint64_t offset;
+	/// Entry timestamp.
+	int64_t timestamp;
+	/// Sub-data index.
+	uint32_t subDataIndex;
+	/// Entry size, as stored in the cache file.
+	uint32_t size;
+	/// Entry size once decompressed.
+	uint32_t uncompressedSize;
+	/// Codec with which the entry is compressed.
+	uint32_t codec;
+};
 
 /// Constructor.
 Cache::Cache()
@@ -44,6 +109,26 @@ Cache::Cache()
 , m_pTocBuffer( NULL )
 , m_tocSize( Invalid< uint32_t >() )
 , m_pEntryPool( NULL )
+, m_cacheFileSize( Invalid< uint64_t >() )
+, m_tocCompactedCount( 0 )
+, m_tocJournalCount( 0 )
+, m_bTocAppendable( false )
+, m_bExtentsBuilt( false )
+, m_pCacheReadStream( NULL )
+, m_pTocRecords( NULL )
+, m_pConvertedTocRecords( NULL )
+, m_tocRecordCount( 0 )
+, m_pTocPathTable( NULL )
+, m_pTocPathTableEnd( NULL )
+, m_bTocByteSwapped( false )
+, m_bTocExpanded( false )
+, m_pFrozenTags( NULL )
+, m_ppFrozenEntries( NULL )
+, m_frozenGroupMask( 0 )
+, m_overflowEntryCount( 0 )
+, m_pMappedData( NULL )
+, m_mappedSize( 0 )
+, m_memoryTracker( Invalid< uint32_t >() )
 {
 }
 
@@ -102,6 +187,14 @@ bool Cache::Initialize( Name name, EPlatform platform, const char* pTocFileName,
 	m_pEntryPool = new ObjectPool< Entry >( ENTRY_POOL_BLOCK_SIZE );
 	HELIUM_ASSERT( m_pEntryPool );
 
+	String trackerName( "Cache " );
+	trackerName += *name;
+	m_memoryTracker = MemoryTelemetry::RegisterSampler(
+		MemoryTelemetry::CATEGORY_HEAP,
+		Name( trackerName ),
+		SampleMemoryUsage,
+		this );
+
 	return true;
 }
 
@@ -110,6 +203,15 @@ bool Cache::Initialize( Name name, EPlatform platform, const char* pTocFileName,
 /// @see Initialize()
 void Cache::Shutdown()
 {
+	// Stop sampling before any of the sampled memory is released.
+	if( IsValid( m_memoryTracker ) )
+	{
+		MemoryTelemetry::UnregisterSampler( m_memoryTracker );
+		SetInvalid( m_memoryTracker );
+	}
+
+	UnmapCacheFile();
+
 	m_name = NULL_NAME;
 	m_platform = PLATFORM_INVALID;
 
@@ -125,19 +227,90 @@ void Cache::Shutdown()
 		SetInvalid( m_asyncLoadId );
 	}
 
+	m_pTocRecords = NULL;
+	DefaultAllocator().Free( m_pConvertedTocRecords );
+	m_pConvertedTocRecords = NULL;
+	m_tocRecordCount = 0;
+	m_pTocPathTable = NULL;
+	m_pTocPathTableEnd = NULL;
+	m_bTocByteSwapped = false;
+	m_bTocExpanded = false;
+
 	DefaultAllocator().Free( m_pTocBuffer );
 	m_pTocBuffer = NULL;
 	SetInvalid( m_tocSize );
 
 	m_bTocLoaded = false;
 
+	ReleaseFrozenEntries();
 	m_entries.Clear();
 	m_entryMap.Clear();
 
+	SetInvalid( m_cacheFileSize );
+	m_tocCompactedCount = 0;
+	m_tocJournalCount = 0;
+	m_bTocAppendable = false;
+	m_updatedEntries.Clear();
+
+	m_extentMap.Clear();
+	m_contentMap.Clear();
+	m_bExtentsBuilt = false;
+	m_compareData.Clear();
+
 	delete m_pEntryPool;
 	m_pEntryPool = NULL;
 }
 
+/// Get the number of bytes of memory currently allocated by this cache.
+///
+/// This includes the TOC buffer, entry information, and scratch buffers, but not the mapped view of the cache file
+/// (which is backed by the file itself).
+///
+/// @return  Memory usage, in bytes.
+size_t Cache::GetMemoryUsage() const
+{
+	size_t size = 0;
+	if( m_pTocBuffer )
+	{
+		size += m_tocSize;
+	}
+
+	if( m_pConvertedTocRecords )
+	{
+		size += m_tocRecordCount * sizeof( TocRecord );
+	}
+
+	{
+		MutexScopeLock scopeLock( m_entryLock );
+
+		size += m_entries.GetCapacity() * sizeof( Entry* ) + m_entries.GetSize() * sizeof( Entry );
+	}
+
+	if( m_pFrozenTags )
+	{
+		size += ( m_frozenGroupMask + 1 ) * FROZEN_GROUP_SIZE * ( sizeof( Entry* ) + sizeof( uint8_t ) );
+	}
+
+	size += m_updatedEntries.GetCapacity() * sizeof( Entry* );
+	size += m_compressedData.GetCapacity() + m_compareData.GetCapacity();
+	size += m_extentMap.GetSize() * sizeof( ExtentMapType::ValueType );
+	size += m_contentMap.GetSize() * sizeof( ContentMapType::ValueType );
+
+	return size;
+}
+
+/// MemoryTelemetry sampler callback.
+///
+/// @param[in] pCache  Cache to sample.
+///
+/// @return  Memory usage of the cache, in bytes.
+size_t Cache::SampleMemoryUsage( void* pCache )
+{
+	HELIUM_ASSERT( pCache );
+
+	return static_cast< const Cache* >( pCache )->GetMemoryUsage();
+}
+
 /// Begin asynchronous loading of the cache table of contents.
 ///
 /// This must be called after calling Initialize() in order to begin using an existing cache.
@@ -260,8 +433,22 @@ bool Cache::TryFinishLoadToc()
 
 		bool bFinalizeResult = FinalizeTocLoad();
 
-		DefaultAllocator().Free( m_pTocBuffer );
-		m_pTocBuffer = NULL;
+		// Hashed TOC records are used in place, so the buffer is kept around for as long as they are.
+		if( !bFinalizeResult )
+		{
+			m_pTocRecords = NULL;
+			DefaultAllocator().Free( m_pConvertedTocRecords );
+			m_pConvertedTocRecords = NULL;
+			m_tocRecordCount = 0;
+			m_pTocPathTable = NULL;
+			m_pTocPathTableEnd = NULL;
+		}
+
+		if( !m_pTocRecords || m_pConvertedTocRecords )
+		{
+			DefaultAllocator().Free( m_pTocBuffer );
+			m_pTocBuffer = NULL;
+		}
 
 		if( !bFinalizeResult )
 		{
@@ -275,13 +462,27 @@ bool Cache::TryFinishLoadToc()
 				m_pEntryPool->Release( pEntry );
 			}
 
+			ReleaseFrozenEntries();
 			m_entries.Clear();
 			m_entryMap.Clear();
+
+			m_bTocAppendable = false;
 		}
 	}
 
 	m_bTocLoaded = true;
 
+#if HELIUM_CACHE_MAPPING
+	if( m_tocRecordCount != 0 || !m_entries.IsEmpty() )
+	{
+		MapCacheFile();
+	}
+#endif
+
+#if HELIUM_CACHE_FREEZE
+	Freeze();
+#endif
+
 	return true;
 }
 
@@ -316,16 +517,81 @@ const Cache::Entry* Cache::FindEntry( AssetPath path, uint32_t subDataIndex ) co
 	key.path = path;
 	key.subDataIndex = subDataIndex;
 
-	EntryMapType::ConstAccessor mapAccessor;
-	if( !m_entryMap.Find( mapAccessor, key ) )
+	// Once lookups are frozen, the entry map only needs to be searched if entries have been added since.
+	bool bSearchMap = true;
+	if( m_pFrozenTags )
+	{
+		const Entry* pEntry = FindFrozenEntry( key );
+		if( pEntry )
+		{
+			return pEntry;
+		}
+
+		bSearchMap = ( m_overflowEntryCount != 0 );
+	}
+
+	if( bSearchMap )
+	{
+		EntryMapType::ConstAccessor mapAccessor;
+		if( m_entryMap.Find( mapAccessor, key ) )
+		{
+			Entry* pEntry = mapAccessor->Second();
+			HELIUM_ASSERT( pEntry );
+
+			return pEntry;
+		}
+	}
+
+	// Entries for hashed TOC records are added the first time they are looked up, using the path given here.
+	if( !m_pTocRecords || m_bTocExpanded )
+	{
+		return NULL;
+	}
+
+	const TocRecord* pRecord = FindTocRecord( path.GetStableHash(), subDataIndex );
+	if( !pRecord )
 	{
 		return NULL;
 	}
 
-	Entry* pEntry = mapAccessor->Second();
+	return AddTocRecordEntry( *pRecord, path );
+}
+
+/// Get the number of object entries in this cache.
+///
+/// If the TOC has entries that have not been looked up yet, entries are added for all of them first, which requires
+/// the TOC to have a path table.
+///
+/// @return  Asset entry count.
+///
+/// @see GetEntry()
+uint32_t Cache::GetEntryCount() const
+{
+	ExpandToc();
+
+	size_t entryCount = m_entries.GetSize();
+	HELIUM_ASSERT( entryCount <= UINT32_MAX );
+
+	return static_cast< uint32_t >( entryCount );
+}
+
+/// Get the information for the cache entry with the specified index.
+///
+/// @param[in] index  Asset entry index.
+///
+/// @return  Asset entry information.
+///
+/// @see GetEntryCount()
+const Cache::Entry& Cache::GetEntry( uint32_t index ) const
+{
+	ExpandToc();
+
+	HELIUM_ASSERT( index < m_entries.GetSize() );
+
+	Entry* pEntry = m_entries[ index ];
 	HELIUM_ASSERT( pEntry );
 
-	return pEntry;
+	return *pEntry;
 }
 
 /// Add or update an entry in the cache.
@@ -335,78 +601,77 @@ const Cache::Entry* Cache::FindEntry( AssetPath path, uint32_t subDataIndex ) co
 /// @param[in] pData         Data to cache.
 /// @param[in] timestamp     Timestamp value to associate with the entry in the cache.
 /// @param[in] size          Number of bytes to cache.
+/// @param[in] codec         Codec with which to compress the data.
 ///
 /// @return  True if the cache was updated successfully, false if not.
+///
+/// @see CacheEntries()
 bool Cache::CacheEntry(
 					   AssetPath path,
 					   uint32_t subDataIndex,
 					   const void* pData,
 					   int64_t timestamp,
-					   uint32_t size )
+					   uint32_t size,
+					   CompressionCodec codec )
 {
-	HELIUM_ASSERT( pData || size == 0 );
-
-	Status status;
-	status.Read( m_cacheFileName.GetData() );
-	int64_t cacheFileSize = status.m_Size;
-	uint64_t entryOffset = ( cacheFileSize == -1 ? 0 : static_cast< uint64_t >( cacheFileSize ) );
-
-	HELIUM_ASSERT( m_pEntryPool );
-	Entry* pEntryUpdate = m_pEntryPool->Allocate();
-	HELIUM_ASSERT( pEntryUpdate );
-	pEntryUpdate->offset = entryOffset;
-	pEntryUpdate->timestamp = timestamp;
-	pEntryUpdate->path = path;
-	pEntryUpdate->subDataIndex = subDataIndex;
-	pEntryUpdate->size = size;
-
-	uint64_t originalOffset = 0;
-	int64_t originalTimestamp = 0;
-	uint32_t originalSize = 0;
+	EntryUpdate update;
+	update.path = path;
+	update.subDataIndex = subDataIndex;
+	update.pData = pData;
+	update.timestamp = timestamp;
+	update.size = size;
+	update.codec = codec;
+
+	return CacheEntries( &update, 1 );
+}
 
-	EntryKey key;
-	key.path = path;
-	key.subDataIndex = subDataIndex;
+/// Add or update a set of entries in the cache.
+///
+/// All entries are written while holding a single AsyncLoader lock, and the TOC is updated once for the whole set by
+/// appending their records to the TOC journal (compacting the TOC instead if the journal has grown too long).
+///
+/// Entries whose stored data matches that of an existing entry byte for byte reference the existing data instead of
+/// writing another copy.  Data is only overwritten in place when no other entry references it.
+///
+/// If the cache file is mapped, it is unmapped for the write and mapped again afterward, so any pointers previously
+/// returned by GetMappedEntryData() are invalidated.
+///
+/// @param[in] pUpdates     Entries to write.
+/// @param[in] updateCount  Number of entries to write.
+///
+/// @return  True if every entry was cached successfully, false if any failed.
+///
+/// @see CacheEntry()
+bool Cache::CacheEntries( const EntryUpdate* pUpdates, size_t updateCount )
+{
+	HELIUM_ASSERT( pUpdates || updateCount == 0 );
 
-	EntryMapType::Accessor entryAccessor;
-	bool bNewEntry = m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntryUpdate ) );
-	if( bNewEntry )
+	if( updateCount == 0 )
 	{
-		HELIUM_TRACE( TraceLevels::Info, "Cache: Adding \"%s\" to cache \"%s\".\n", *path.ToString(), *m_cacheFileName );
-
-		m_entries.Push( pEntryUpdate );
+		return true;
 	}
-	else
-	{
-		HELIUM_TRACE( TraceLevels::Info, "Cache: Updating \"%s\" in cache \"%s\".\n", *path.ToString(), *m_cacheFileName );
-
-		m_pEntryPool->Release( pEntryUpdate );
 
-		pEntryUpdate = entryAccessor->Second();
-		HELIUM_ASSERT( pEntryUpdate );
-
-		originalOffset = pEntryUpdate->offset;
-		originalTimestamp = pEntryUpdate->timestamp;
-		originalSize = pEntryUpdate->size;
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	HELIUM_ASSERT( pAsyncLoader );
 
-		if( originalSize < size )
-		{
-			pEntryUpdate->offset = entryOffset;
-		}
-		else
-		{
-			entryOffset = originalOffset;
-		}
+	// The TOC can only be rewritten once every entry in it is known by path.
+	if( !ExpandToc() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Cache: Cannot update cache \"%s\", as its TOC has no path table.\n",
+			*m_cacheFileName );
 
-		pEntryUpdate->timestamp = timestamp;
-		pEntryUpdate->size = size;
+		return false;
 	}
 
-	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
-	HELIUM_ASSERT( pAsyncLoader );
+	BuildExtents();
 
 	pAsyncLoader->Lock();
 
+	bool bRemap = IsCacheFileMapped();
+	UnmapCacheFile();
+
 	bool bCacheSuccess = true;
 
 	FileStream* pCacheStream = FileStream::OpenFileStream( m_cacheFileName, FileStream::MODE_WRITE, false );
@@ -418,150 +683,1284 @@ bool Cache::CacheEntry(
 	}
 	else
 	{
-		HELIUM_TRACE(
-			TraceLevels::Info,
-			"Cache: Caching \"%s\" to \"%s\" (%" PRIu32 " bytes @ offset %" PRIu64 ").\n",
-			*path.ToString(),
-			*m_cacheFileName,
-			size,
-			entryOffset );
-
-		uint64_t seekOffset = static_cast< uint64_t >( pCacheStream->Seek(
-			static_cast< int64_t >( entryOffset ),
-			SeekOrigins::Begin ) );
-		if( seekOffset != entryOffset )
+		// Only this cache writes to the cache file, so its size only needs to be checked once.
+		if( IsInvalid( m_cacheFileSize ) )
 		{
-			HELIUM_TRACE( TraceLevels::Error, "Cache: Cache file offset seek failed.\n" );
+			int64_t cacheFileSize = pCacheStream->Seek( 0, SeekOrigins::End );
+			m_cacheFileSize = ( cacheFileSize < 0 ? 0 : static_cast< uint64_t >( cacheFileSize ) );
+		}
 
-			if( bNewEntry )
-			{
-				m_entries.Pop();
-				m_entryMap.Remove( entryAccessor );
-				m_pEntryPool->Release( pEntryUpdate );
-			}
-			else
-			{
-				pEntryUpdate->offset = originalOffset;
-				pEntryUpdate->timestamp = originalTimestamp;
-				pEntryUpdate->size = originalSize;
-			}
+		m_updatedEntries.Resize( 0 );
+		m_updatedEntries.Reserve( updateCount );
 
-			bCacheSuccess = false;
-		}
-		else
+		for( size_t updateIndex = 0; updateIndex < updateCount; ++updateIndex )
 		{
-			size_t writeSize = pCacheStream->Write( pData, 1, size );
-			if( writeSize != size )
+			Entry* pEntry = WriteEntryData( pCacheStream, pUpdates[ updateIndex ] );
+			if( pEntry )
 			{
-				HELIUM_TRACE(
-					TraceLevels::Error,
-					"Cache: Failed to write %" PRIu32 " bytes to cache \"%s\" (%" PRIuSZ " bytes written).\n",
-					size,
-					*m_cacheFileName,
-					writeSize );
-
-				if( bNewEntry )
-				{
-					m_entries.Pop();
-					m_entryMap.Remove( entryAccessor );
-					m_pEntryPool->Release( pEntryUpdate );
-				}
-				else
-				{
-					pEntryUpdate->offset = originalOffset;
-					pEntryUpdate->timestamp = originalTimestamp;
-					pEntryUpdate->size = originalSize;
-				}
-
-				bCacheSuccess = false;
+				m_updatedEntries.Push( pEntry );
 			}
 			else
 			{
-				HELIUM_TRACE( TraceLevels::Info, "Cache: Rewriting TOC file \"%s\".\n", *m_tocFileName );
+				bCacheSuccess = false;
+			}
+		}
 
-				FileStream* pTocStream = FileStream::OpenFileStream( m_tocFileName, FileStream::MODE_WRITE, true );
-				if( !pTocStream )
-				{
-					HELIUM_TRACE( TraceLevels::Error, "Cache: Failed to open TOC \"%s\" for writing.\n", *m_tocFileName );
-				}
-				else
-				{
-					BufferedStream* pBufferedStream = new BufferedStream( pTocStream );
-					HELIUM_ASSERT( pBufferedStream );
+		delete pCacheStream;
 
-					pBufferedStream->Write( &TOC_MAGIC, sizeof( TOC_MAGIC ), 1 );
-					pBufferedStream->Write( &sm_Version, sizeof( sm_Version ), 1 );
+		delete m_pCacheReadStream;
+		m_pCacheReadStream = NULL;
 
-					uint32_t entryCount = static_cast< uint32_t >( m_entries.GetSize() );
-					pBufferedStream->Write( &entryCount, sizeof( entryCount ), 1 );
+		if( !m_updatedEntries.IsEmpty() )
+		{
+			WriteToc();
+		}
+	}
 
-					String entryPath;
-					uint_fast32_t entryCountFast = entryCount;
-					for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
-					{
-						Entry* pEntry = m_entries[ entryIndex ];
-						HELIUM_ASSERT( pEntry );
+	if( bRemap )
+	{
+		MapCacheFile();
+	}
 
-						pEntry->path.ToString( entryPath );
-						HELIUM_ASSERT( entryPath.GetSize() < UINT16_MAX );
-						uint16_t pathSize = static_cast< uint16_t >( entryPath.GetSize() );
-						pBufferedStream->Write( &pathSize, sizeof( pathSize ), 1 );
+	pAsyncLoader->Unlock();
 
-						pBufferedStream->Write( *entryPath, sizeof( char ), pathSize );
+	return bCacheSuccess;
+}
 
-						pBufferedStream->Write( &pEntry->subDataIndex, sizeof( pEntry->subDataIndex ), 1 );
+/// Get the number of bytes in the cache file that are no longer referenced by any entry.
+///
+/// Data is left behind in the cache file whenever an entry is updated with data that does not fit in place, or with
+/// data shared with another entry.  This space is only reclaimed by Compact().
+///
+/// @return  Size of the unreferenced data, in bytes, or zero if it cannot be determined.
+///
+/// @see Compact()
+uint64_t Cache::GetUnreferencedDataSize()
+{
+	if( !ExpandToc() )
+	{
+		return 0;
+	}
 
-						pBufferedStream->Write( &pEntry->offset, sizeof( pEntry->offset ), 1 );
-						pBufferedStream->Write( &pEntry->timestamp, sizeof( pEntry->timestamp ), 1 );
-						pBufferedStream->Write( &pEntry->size, sizeof( pEntry->size ), 1 );
-					}
+	BuildExtents();
 
-					delete pBufferedStream;
-					delete pTocStream;
-				}
-			}
+	if( IsInvalid( m_cacheFileSize ) )
+	{
+		FileStream* pCacheStream = FileStream::OpenFileStream( m_cacheFileName, FileStream::MODE_READ );
+		if( !pCacheStream )
+		{
+			return 0;
 		}
 
+		int64_t cacheFileSize = pCacheStream->Seek( 0, SeekOrigins::End );
+		m_cacheFileSize = ( cacheFileSize < 0 ? 0 : static_cast< uint64_t >( cacheFileSize ) );
+
 		delete pCacheStream;
 	}
 
-	pAsyncLoader->Unlock();
+	uint64_t referencedSize = 0;
+	for( ExtentMapType::ConstIterator extentIterator = m_extentMap.Begin();
+		extentIterator != m_extentMap.End();
+		++extentIterator )
+	{
+		referencedSize += extentIterator->Second().size;
+	}
 
-	return bCacheSuccess;
+	return ( m_cacheFileSize > referencedSize ? m_cacheFileSize - referencedSize : 0 );
 }
 
-/// Finalize the TOC loading process.
+/// Entry being moved by CompactEntries().
+struct CompactedEntry
+{
+	/// Cache entry.
+	Cache::Entry* pEntry;
+	/// Position of the entry in the load order, or an invalid index if it is not in it.
+	size_t loadIndex;
+};
+
+/// Order entries for compaction.  Entries in the load order are sorted by load order, then by sub-data index, while
+/// the remaining entries follow in their current cache file order.
 ///
-/// Note that this does not free any resources on a failed load (the caller is responsible for such clean-up work).
+/// @param[in] rEntry0  First entry.
+/// @param[in] rEntry1  Second entry.
 ///
-/// @return  True if the TOC load was successful, false if not.
-bool Cache::FinalizeTocLoad()
+/// @return  True if the first entry sorts before the second, false if not.
+static bool CompactedEntryLess( const CompactedEntry& rEntry0, const CompactedEntry& rEntry1 )
 {
-	HELIUM_ASSERT( m_pTocBuffer );
+	if( rEntry0.loadIndex != rEntry1.loadIndex )
+	{
+		return ( rEntry0.loadIndex < rEntry1.loadIndex );
+	}
 
-	const uint8_t* pTocCurrent = m_pTocBuffer;
-	const uint8_t* pTocMax = pTocCurrent + m_tocSize;
+	// Entries sharing a position in the load order share the same path.
+	if( IsInvalid( rEntry0.loadIndex ) && rEntry0.pEntry->offset != rEntry1.pEntry->offset )
+	{
+		return ( rEntry0.pEntry->offset < rEntry1.pEntry->offset );
+	}
 
-	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+	return ( rEntry0.pEntry->subDataIndex < rEntry1.pEntry->subDataIndex );
+}
 
-	// Validate the TOC header.
-	uint32_t magic;
-	if( !CheckedTocRead( MemoryCopy, magic, "the header magic", pTocCurrent, pTocMax ) )
+/// Rewrite the cache file with only the data still referenced by its entries, laying out assets in load order.
+///
+/// Entries of assets listed in the given load order (see AssetLoadTrace::GetLoadOrder()) are written first, in that
+/// order and by sub-data index, followed by all other entries in their current order.  See CompactEntries() for how
+/// the cache is rewritten.
+///
+/// @param[in] pLoadOrder      Asset paths in the order in which they are loaded, or null.
+/// @param[in] loadOrderCount  Number of asset paths in the load order.
+///
+/// @return  True if the cache was compacted, false if not (in which case the cache is left as it was).
+///
+/// @see GetUnreferencedDataSize()
+bool Cache::Compact( const AssetPath* pLoadOrder, size_t loadOrderCount )
+{
+	HELIUM_ASSERT( pLoadOrder || loadOrderCount == 0 );
+
+	if( !ExpandToc() )
 	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Cache::Compact(): Cannot compact cache \"%s\", as its TOC has no path table.\n",
+			*m_cacheFileName );
+
 		return false;
 	}
 
-	LOAD_VALUE_CALLBACK* pLoadFunction = NULL;
-	if( magic == TOC_MAGIC )
+	HashMap< AssetPath, size_t > pathLoadIndices;
+	for( size_t loadIndex = 0; loadIndex < loadOrderCount; ++loadIndex )
 	{
-		HELIUM_TRACE(
-			TraceLevels::Info,
-			"Cache::FinalizeTocLoad(): TOC \"%s\" identified (no byte swapping).\n",
-			*m_tocFileName );
+		HashMap< AssetPath, size_t >::Iterator indexIterator;
+		pathLoadIndices.Insert(
+			indexIterator,
+			HashMap< AssetPath, size_t >::ValueType( pLoadOrder[ loadIndex ], loadIndex ) );
+	}
 
-		pLoadFunction = MemoryCopy;
+	size_t entryCount = m_entries.GetSize();
+
+	DynamicArray< size_t > loadIndices;
+	loadIndices.Resize( entryCount );
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		HashMap< AssetPath, size_t >::ConstIterator indexIterator = pathLoadIndices.Find( m_entries[ entryIndex ]->path );
+		loadIndices[ entryIndex ] =
+			( indexIterator != pathLoadIndices.End() ? indexIterator->Second() : Invalid< size_t >() );
 	}
-	else if( magic == TOC_MAGIC_SWAPPED )
+
+	return CompactEntries( loadIndices );
+}
+
+/// Rewrite the cache file with only the data still referenced by its entries, laying out entries in the order in which
+/// they were read in a recorded trace.
+///
+/// Entries in the trace are written first, in the order in which they were first read, with any other sub-data of the
+/// same assets right after the first of their entries read.  All other entries follow in their current order.  Only
+/// the trace records of this cache are used.  See CompactEntries() for how the cache is rewritten.
+///
+/// @param[in] rTrace  Cache access trace, such as the traces of all the scenes packaged, appended in load order.
+///
+/// @return  True if the cache was compacted, false if not (in which case the cache is left as it was).
+///
+/// @see GetUnreferencedDataSize()
+bool Cache::Compact( const CacheAccessTrace& rTrace )
+{
+	if( !ExpandToc() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Cache::Compact(): Cannot compact cache \"%s\", as its TOC has no path table.\n",
+			*m_cacheFileName );
+
+		return false;
+	}
+
+	size_t entryCount = m_entries.GetSize();
+
+	HashMap< uintptr_t, size_t > entryIndices;
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		HashMap< uintptr_t, size_t >::Iterator indexIterator;
+		entryIndices.Insert(
+			indexIterator,
+			HashMap< uintptr_t, size_t >::ValueType( reinterpret_cast< uintptr_t >( m_entries[ entryIndex ] ), entryIndex ) );
+	}
+
+	DynamicArray< size_t > loadIndices;
+	loadIndices.Resize( entryCount );
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		SetInvalid( loadIndices[ entryIndex ] );
+	}
+
+	// Place each entry read at its first read, and each asset at its first entry read.
+	HashMap< AssetPath, size_t > pathLoadIndices;
+
+	size_t recordCount = rTrace.GetRecordCount();
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		const CacheAccessTrace::Record& rRecord = rTrace.GetRecord( recordIndex );
+		if( rRecord.cacheName != m_name )
+		{
+			continue;
+		}
+
+		const Entry* pEntry = FindEntry( rRecord.path, rRecord.subDataIndex );
+		if( !pEntry )
+		{
+			continue;
+		}
+
+		HashMap< AssetPath, size_t >::Iterator pathIterator = pathLoadIndices.Find( rRecord.path );
+		if( pathIterator == pathLoadIndices.End() )
+		{
+			pathLoadIndices.Insert( pathIterator, HashMap< AssetPath, size_t >::ValueType( rRecord.path, recordIndex ) );
+		}
+
+		HashMap< uintptr_t, size_t >::ConstIterator indexIterator =
+			entryIndices.Find( reinterpret_cast< uintptr_t >( pEntry ) );
+		HELIUM_ASSERT( indexIterator != entryIndices.End() );
+		if( indexIterator != entryIndices.End() && IsInvalid( loadIndices[ indexIterator->Second() ] ) )
+		{
+			loadIndices[ indexIterator->Second() ] = recordIndex;
+		}
+	}
+
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		if( IsValid( loadIndices[ entryIndex ] ) )
+		{
+			continue;
+		}
+
+		HashMap< AssetPath, size_t >::ConstIterator pathIterator = pathLoadIndices.Find( m_entries[ entryIndex ]->path );
+		if( pathIterator != pathLoadIndices.End() )
+		{
+			loadIndices[ entryIndex ] = pathIterator->Second();
+		}
+	}
+
+	return CompactEntries( loadIndices );
+}
+
+/// Rewrite the cache file with only the data still referenced by its entries, in a given order.
+///
+/// Referenced data is copied to a new cache file in load order, so that entries loaded together are read
+/// sequentially.  Data shared by several entries is written once, where its first entry lands.
+///
+/// The new cache file and TOC are written next to the current ones and only swapped in once both are complete.  The
+/// current TOC is deleted before the files are swapped, so if the process is interrupted part way through the swap,
+/// the cache is left empty and rebuilt rather than left with a TOC that does not match its data.
+///
+/// This holds the AsyncLoader lock for the whole rewrite, and unmaps the cache file while it runs (see
+/// CacheEntries()).  It is intended to be run from tools between loads, when GetUnreferencedDataSize() shows that a
+/// significant part of the cache file is dead space, or when packaging caches for distribution.
+///
+/// @param[in] rLoadIndices  Position of each entry in the load order, or an invalid index for entries that are not in
+///                          the load order.  Entries sharing a position must have the same path.
+///
+/// @return  True if the cache was compacted, false if not (in which case the cache is left as it was).
+bool Cache::CompactEntries( const DynamicArray< size_t >& rLoadIndices )
+{
+	size_t entryCount = m_entries.GetSize();
+	HELIUM_ASSERT( rLoadIndices.GetSize() == entryCount );
+
+	BuildExtents();
+
+	DynamicArray< CompactedEntry > compactedEntries;
+	compactedEntries.Resize( entryCount );
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		CompactedEntry& rCompactedEntry = compactedEntries[ entryIndex ];
+		rCompactedEntry.pEntry = m_entries[ entryIndex ];
+		HELIUM_ASSERT( rCompactedEntry.pEntry );
+		rCompactedEntry.loadIndex = rLoadIndices[ entryIndex ];
+	}
+
+	std::sort( compactedEntries.GetData(), compactedEntries.GetData() + entryCount, CompactedEntryLess );
+
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	HELIUM_ASSERT( pAsyncLoader );
+
+	pAsyncLoader->Lock();
+
+	bool bRemap = IsCacheFileMapped();
+	UnmapCacheFile();
+
+	String compactedCacheFileName = m_cacheFileName;
+	compactedCacheFileName += ".compact";
+	String compactedTocFileName = m_tocFileName;
+	compactedTocFileName += ".compact";
+
+	// Copy each referenced extent to the new cache file, recording where it moved to.
+	HashMap< uint64_t, uint64_t > movedOffsets;
+	uint64_t originalSize = 0;
+	uint64_t compactedSize = 0;
+	bool bCopySuccess = false;
+
+	FileStream* pSourceStream = FileStream::OpenFileStream( m_cacheFileName, FileStream::MODE_READ );
+	FileStream* pDestinationStream =
+		FileStream::OpenFileStream( compactedCacheFileName, FileStream::MODE_WRITE, true );
+	if( !pSourceStream || !pDestinationStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Cache::Compact(): Failed to open \"%s\" and \"%s\" for compaction.\n",
+			*m_cacheFileName,
+			*compactedCacheFileName );
+	}
+	else
+	{
+		int64_t sourceSize = pSourceStream->Seek( 0, SeekOrigins::End );
+		originalSize = ( sourceSize < 0 ? 0 : static_cast< uint64_t >( sourceSize ) );
+
+		bCopySuccess = true;
+
+		for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+		{
+			const Entry* pEntry = compactedEntries[ entryIndex ].pEntry;
+			uint32_t size = pEntry->size;
+			if( size == 0 )
+			{
+				continue;
+			}
+
+			HashMap< uint64_t, uint64_t >::Iterator movedIterator = movedOffsets.Find( pEntry->offset );
+			if( movedIterator != movedOffsets.End() )
+			{
+				continue;
+			}
+
+			m_compareData.Resize( size );
+
+			int64_t seekOffset = pSourceStream->Seek( static_cast< int64_t >( pEntry->offset ), SeekOrigins::Begin );
+			if( static_cast< uint64_t >( seekOffset ) != pEntry->offset ||
+				pSourceStream->Read( m_compareData.GetData(), 1, size ) != size ||
+				pDestinationStream->Write( m_compareData.GetData(), 1, size ) != size )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					"Cache::Compact(): Failed to copy %" PRIu32 " bytes @ offset %" PRIu64 " of \"%s\".\n",
+					size,
+					pEntry->offset,
+					*m_cacheFileName );
+
+				bCopySuccess = false;
+
+				break;
+			}
+
+			movedOffsets.Insert( movedIterator, HashMap< uint64_t, uint64_t >::ValueType( pEntry->offset, compactedSize ) );
+			compactedSize += size;
+		}
+	}
+
+	delete pSourceStream;
+	delete pDestinationStream;
+
+	// Point the entries at their new data, keeping the old offsets in case the new files cannot be swapped in.
+	DynamicArray< uint64_t > originalOffsets;
+	bool bCompactSuccess = false;
+
+	if( bCopySuccess )
+	{
+		originalOffsets.Resize( entryCount );
+		for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+		{
+			Entry* pEntry = m_entries[ entryIndex ];
+			originalOffsets[ entryIndex ] = pEntry->offset;
+
+			if( pEntry->size != 0 )
+			{
+				HashMap< uint64_t, uint64_t >::ConstIterator movedIterator = movedOffsets.Find( pEntry->offset );
+				HELIUM_ASSERT( movedIterator != movedOffsets.End() );
+				pEntry->offset = movedIterator->Second();
+			}
+			else
+			{
+				pEntry->offset = 0;
+			}
+		}
+
+		bool bTocRemoved = false;
+
+		if( WriteToc( true, *compactedTocFileName ) )
+		{
+			RemoveFile( m_tocFileName );
+			bTocRemoved = true;
+
+			if( RenameFile( compactedCacheFileName, m_cacheFileName ) )
+			{
+				// If this fails, the entries still match the new cache file, so the TOC is written in place instead.
+				if( !RenameFile( compactedTocFileName, m_tocFileName ) )
+				{
+					WriteToc( true );
+				}
+
+				bCompactSuccess = true;
+			}
+		}
+
+		if( !bCompactSuccess )
+		{
+			for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+			{
+				m_entries[ entryIndex ]->offset = originalOffsets[ entryIndex ];
+			}
+
+			// The old TOC no longer matches the journal counts set when writing the new one, so always rewrite it.
+			if( bTocRemoved )
+			{
+				WriteToc( true );
+			}
+			else
+			{
+				m_bTocAppendable = false;
+			}
+		}
+	}
+
+	RemoveFile( compactedCacheFileName );
+	RemoveFile( compactedTocFileName );
+
+	if( bCompactSuccess )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"Cache::Compact(): Compacted \"%s\" from %" PRIu64 " to %" PRIu64 " bytes.\n",
+			*m_cacheFileName,
+			originalSize,
+			compactedSize );
+
+		m_cacheFileSize = compactedSize;
+
+		m_bExtentsBuilt = false;
+		BuildExtents();
+	}
+
+	if( bRemap )
+	{
+		MapCacheFile();
+	}
+
+	pAsyncLoader->Unlock();
+
+	return bCompactSuccess;
+}
+
+/// Freeze entry lookups.
+///
+/// This builds a read-only open-addressing table of the current entries, which FindEntry() searches first without
+/// taking any locks, comparing the tags of a whole group of slots at once.  Entries added afterwards (including those
+/// of hashed TOC records first looked up after freezing) are still found through the entry map, which is only searched
+/// once any have been added.  Freezing is meant for caches that are rarely written once loaded; it must not be done
+/// while other threads are using the cache.  Freezing again rebuilds the table with all entries.
+///
+/// @see IsFrozen()
+void Cache::Freeze()
+{
+	HELIUM_ASSERT( m_bTocLoaded );
+
+	ReleaseFrozenEntries();
+
+	size_t entryCount = m_entries.GetSize();
+	if( entryCount == 0 )
+	{
+		return;
+	}
+
+	// Keep the table at most 7/8 full, so that every probe sequence reaches a group with an empty slot.
+	size_t groupCount = 1;
+	while( groupCount * FROZEN_GROUP_SIZE * 7 < entryCount * 8 )
+	{
+		groupCount <<= 1;
+	}
+
+	size_t slotCount = groupCount * FROZEN_GROUP_SIZE;
+	m_ppFrozenEntries = static_cast< Entry** >(
+		DefaultAllocator().Allocate( slotCount * ( sizeof( Entry* ) + sizeof( uint8_t ) ) ) );
+	HELIUM_ASSERT( m_ppFrozenEntries );
+	m_pFrozenTags = reinterpret_cast< uint8_t* >( m_ppFrozenEntries + slotCount );
+	MemoryZero( m_pFrozenTags, slotCount );
+	m_frozenGroupMask = groupCount - 1;
+	m_overflowEntryCount = 0;
+
+	EntryKey key;
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Entry* pEntry = m_entries[ entryIndex ];
+		HELIUM_ASSERT( pEntry );
+
+		key.path = pEntry->path;
+		key.subDataIndex = pEntry->subDataIndex;
+
+		uint64_t hash = ComputeFrozenHash( key );
+		uint8_t tag = static_cast< uint8_t >( 0x80 | ( hash >> 57 ) );
+
+		size_t slotIndex = static_cast< size_t >( hash ) & m_frozenGroupMask;
+		slotIndex *= FROZEN_GROUP_SIZE;
+		while( m_pFrozenTags[ slotIndex ] != 0 )
+		{
+			slotIndex = ( slotIndex + 1 ) & ( slotCount - 1 );
+		}
+
+		m_pFrozenTags[ slotIndex ] = tag;
+		m_ppFrozenEntries[ slotIndex ] = pEntry;
+	}
+}
+
+/// Map the cache file into memory for read-only access.
+///
+/// While the cache file is mapped, GetMappedEntryData() can be used to access entry data in place rather than reading
+/// it into a separate buffer.  Failing to map the file (for example, due to lack of address space) is not an error;
+/// callers are expected to fall back to reading entries through the AsyncLoader.
+///
+/// @return  True if the cache file is mapped, false if not.
+///
+/// @see UnmapCacheFile(), IsCacheFileMapped(), GetMappedEntryData()
+bool Cache::MapCacheFile()
+{
+	if( m_pMappedData )
+	{
+		return true;
+	}
+
+	if( m_cacheFileName.IsEmpty() )
+	{
+		return false;
+	}
+
+	const void* pMappedData = NULL;
+	uint64_t mappedSize = 0;
+
+#if HELIUM_OS_WIN
+	HANDLE hFile = CreateFileA(
+		*m_cacheFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( hFile != INVALID_HANDLE_VALUE )
+	{
+		LARGE_INTEGER fileSize;
+		if( GetFileSizeEx( hFile, &fileSize ) && fileSize.QuadPart > 0 &&
+			static_cast< uint64_t >( fileSize.QuadPart ) <= static_cast< uint64_t >( static_cast< size_t >( -1 ) ) )
+		{
+			HANDLE hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+			if( hMapping )
+			{
+				// The view keeps the mapping object alive, so neither handle needs to be kept around.
+				pMappedData = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+				if( pMappedData )
+				{
+					mappedSize = static_cast< uint64_t >( fileSize.QuadPart );
+				}
+
+				CloseHandle( hMapping );
+			}
+		}
+
+		CloseHandle( hFile );
+	}
+#else
+	int fileDescriptor = open( *m_cacheFileName, O_RDONLY );
+	if( fileDescriptor >= 0 )
+	{
+		struct stat fileStat;
+		if( fstat( fileDescriptor, &fileStat ) == 0 && fileStat.st_size > 0 &&
+			static_cast< uint64_t >( fileStat.st_size ) <= static_cast< uint64_t >( static_cast< size_t >( -1 ) ) )
+		{
+			void* pView = mmap( NULL, static_cast< size_t >( fileStat.st_size ), PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+			if( pView != MAP_FAILED )
+			{
+				pMappedData = pView;
+				mappedSize = static_cast< uint64_t >( fileStat.st_size );
+			}
+		}
+
+		// The mapping remains valid after the file is closed.
+		close( fileDescriptor );
+	}
+#endif
+
+	if( !pMappedData )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"Cache::MapCacheFile(): Could not map cache file \"%s\"; entries will be read through the async loader.\n",
+			*m_cacheFileName );
+
+		return false;
+	}
+
+	m_pMappedData = static_cast< const uint8_t* >( pMappedData );
+	m_mappedSize = mappedSize;
+
+	HELIUM_TRACE(
+		TraceLevels::Debug,
+		"Cache::MapCacheFile(): Mapped %" PRIu64 " bytes of cache file \"%s\".\n",
+		m_mappedSize,
+		*m_cacheFileName );
+
+	return true;
+}
+
+/// Release the memory mapping of the cache file, if it is mapped.
+///
+/// Any pointers previously returned by GetMappedEntryData() are invalid once this has been called.
+///
+/// @see MapCacheFile(), IsCacheFileMapped()
+void Cache::UnmapCacheFile()
+{
+	if( !m_pMappedData )
+	{
+		return;
+	}
+
+#if HELIUM_OS_WIN
+	HELIUM_VERIFY( UnmapViewOfFile( m_pMappedData ) );
+#else
+	HELIUM_VERIFY( munmap( const_cast< uint8_t* >( m_pMappedData ), static_cast< size_t >( m_mappedSize ) ) == 0 );
+#endif
+
+	m_pMappedData = NULL;
+	m_mappedSize = 0;
+}
+
+/// Get a pointer to the data for a cache entry within the mapped cache file.
+///
+/// @param[in] rEntry  Cache entry.
+///
+/// @return  Pointer to the start of the entry data, or null if the cache file is not mapped or the entry does not lie
+///          entirely within the mapped view.
+///
+/// @see MapCacheFile(), IsCacheFileMapped()
+const uint8_t* Cache::GetMappedEntryData( const Entry& rEntry ) const
+{
+	if( !m_pMappedData || rEntry.offset > m_mappedSize || rEntry.size > m_mappedSize - rEntry.offset )
+	{
+		return NULL;
+	}
+
+	return m_pMappedData + rEntry.offset;
+}
+
+/// Write the data for an entry to the cache file and add or update its entry information.
+///
+/// @param[in] pCacheStream  Cache file stream, opened for writing.
+/// @param[in] rUpdate       Entry to write.
+///
+/// @return  Entry that was written, or null if writing failed (in which case the entry information is left as it was).
+Cache::Entry* Cache::WriteEntryData( FileStream* pCacheStream, const EntryUpdate& rUpdate )
+{
+	HELIUM_ASSERT( pCacheStream );
+	HELIUM_ASSERT( rUpdate.pData || rUpdate.size == 0 );
+	HELIUM_ASSERT( IsValid( m_cacheFileSize ) );
+
+	uint64_t entryOffset = m_cacheFileSize;
+
+	// Compress the data, keeping it as is if that does not make it any smaller.
+	const void* pData = rUpdate.pData;
+	uint32_t size = rUpdate.size;
+	CompressionCodec codec = CompressionCodecs::None;
+	if( rUpdate.codec != CompressionCodecs::None && rUpdate.size != 0 )
+	{
+		if( Compression::Compress( rUpdate.codec, rUpdate.pData, rUpdate.size, m_compressedData ) &&
+			m_compressedData.GetSize() < rUpdate.size )
+		{
+			pData = m_compressedData.GetData();
+			size = static_cast< uint32_t >( m_compressedData.GetSize() );
+			codec = rUpdate.codec;
+		}
+	}
+
+	// Reference the data of an existing extent storing the same bytes instead of writing them again.
+	uint64_t contentHash = ( size != 0 ? ComputeContentHash( pData, size ) : 0 );
+	uint64_t sharedOffset = FindSharedExtent( pData, size, contentHash );
+	bool bShared = IsValid( sharedOffset );
+	if( bShared )
+	{
+		entryOffset = sharedOffset;
+	}
+
+	HELIUM_ASSERT( m_pEntryPool );
+	Entry* pEntryUpdate = m_pEntryPool->Allocate();
+	HELIUM_ASSERT( pEntryUpdate );
+	pEntryUpdate->offset = entryOffset;
+	pEntryUpdate->timestamp = rUpdate.timestamp;
+	pEntryUpdate->contentHash = contentHash;
+	pEntryUpdate->path = rUpdate.path;
+	pEntryUpdate->subDataIndex = rUpdate.subDataIndex;
+	pEntryUpdate->size = size;
+	pEntryUpdate->uncompressedSize = rUpdate.size;
+	pEntryUpdate->codec = static_cast< uint8_t >( codec );
+
+	uint64_t originalOffset = 0;
+	int64_t originalTimestamp = 0;
+	uint64_t originalContentHash = 0;
+	uint32_t originalSize = 0;
+	uint32_t originalUncompressedSize = 0;
+	uint8_t originalCodec = 0;
+
+	EntryKey key;
+	key.path = rUpdate.path;
+	key.subDataIndex = rUpdate.subDataIndex;
+
+	bool bInPlace = false;
+
+	EntryMapType::Accessor entryAccessor;
+	bool bNewEntry = m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntryUpdate ) );
+	if( bNewEntry )
+	{
+		HELIUM_TRACE( TraceLevels::Info, "Cache: Adding \"%s\" to cache \"%s\".\n", *rUpdate.path.ToString(), *m_cacheFileName );
+
+		m_entries.Push( pEntryUpdate );
+		if( m_pFrozenTags )
+		{
+			AtomicIncrementRelease( m_overflowEntryCount );
+		}
+	}
+	else
+	{
+		HELIUM_TRACE( TraceLevels::Info, "Cache: Updating \"%s\" in cache \"%s\".\n", *rUpdate.path.ToString(), *m_cacheFileName );
+
+		m_pEntryPool->Release( pEntryUpdate );
+
+		pEntryUpdate = entryAccessor->Second();
+		HELIUM_ASSERT( pEntryUpdate );
+
+		originalOffset = pEntryUpdate->offset;
+		originalTimestamp = pEntryUpdate->timestamp;
+		originalContentHash = pEntryUpdate->contentHash;
+		originalSize = pEntryUpdate->size;
+		originalUncompressedSize = pEntryUpdate->uncompressedSize;
+		originalCodec = pEntryUpdate->codec;
+
+		// The old data can only be overwritten if it fits the new data and no other entry shares it.
+		if( bShared || originalSize < size || GetExtentReferenceCount( originalOffset ) > 1 )
+		{
+			pEntryUpdate->offset = entryOffset;
+		}
+		else
+		{
+			entryOffset = originalOffset;
+			bInPlace = true;
+		}
+
+		pEntryUpdate->timestamp = rUpdate.timestamp;
+		pEntryUpdate->contentHash = contentHash;
+		pEntryUpdate->size = size;
+		pEntryUpdate->uncompressedSize = rUpdate.size;
+		pEntryUpdate->codec = static_cast< uint8_t >( codec );
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"Cache: Caching \"%s\" to \"%s\" (%" PRIu32 " bytes, %" PRIu32 " stored @ offset %" PRIu64 ").\n",
+		*rUpdate.path.ToString(),
+		*m_cacheFileName,
+		rUpdate.size,
+		size,
+		entryOffset );
+
+	bool bWriteSuccess = false;
+
+	if( bShared )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"Cache: \"%s\" shares the data stored @ offset %" PRIu64 " in \"%s\".\n",
+			*rUpdate.path.ToString(),
+			entryOffset,
+			*m_cacheFileName );
+
+		bWriteSuccess = true;
+	}
+	else
+	{
+		uint64_t seekOffset = static_cast< uint64_t >( pCacheStream->Seek(
+			static_cast< int64_t >( entryOffset ),
+			SeekOrigins::Begin ) );
+		if( seekOffset != entryOffset )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "Cache: Cache file offset seek failed.\n" );
+		}
+		else
+		{
+			size_t writeSize = pCacheStream->Write( pData, 1, size );
+			if( writeSize != size )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					"Cache: Failed to write %" PRIu32 " bytes to cache \"%s\" (%" PRIuSZ " bytes written).\n",
+					size,
+					*m_cacheFileName,
+					writeSize );
+
+				// Part of the data may have been written past the end, so check the size again on the next write.
+				SetInvalid( m_cacheFileSize );
+			}
+			else
+			{
+				bWriteSuccess = true;
+			}
+		}
+	}
+
+	if( !bWriteSuccess )
+	{
+		if( bNewEntry )
+		{
+			m_entries.Pop();
+			m_entryMap.Remove( entryAccessor );
+			m_pEntryPool->Release( pEntryUpdate );
+			if( m_pFrozenTags )
+			{
+				AtomicDecrementRelease( m_overflowEntryCount );
+			}
+		}
+		else
+		{
+			pEntryUpdate->offset = originalOffset;
+			pEntryUpdate->timestamp = originalTimestamp;
+			pEntryUpdate->contentHash = originalContentHash;
+			pEntryUpdate->size = originalSize;
+			pEntryUpdate->uncompressedSize = originalUncompressedSize;
+			pEntryUpdate->codec = originalCodec;
+		}
+
+		return NULL;
+	}
+
+	uint64_t entryEnd = entryOffset + size;
+	if( entryEnd > m_cacheFileSize )
+	{
+		m_cacheFileSize = entryEnd;
+	}
+
+	// Move the entry's reference over to its new data.  Data overwritten in place is released first, as it no longer
+	// holds the old bytes, while other data is referenced first in case it is the same extent as before.
+	if( !bNewEntry && bInPlace )
+	{
+		ReleaseExtentReference( originalOffset );
+	}
+
+	AddExtentReference( entryOffset, size, contentHash );
+
+	if( !bNewEntry && !bInPlace )
+	{
+		ReleaseExtentReference( originalOffset );
+	}
+
+	return pEntryUpdate;
+}
+
+/// Count the references to the stored data of every entry, if that has not been done yet.
+///
+/// Entries from TOCs older than version 4 have no content hash, so their data is never shared with new entries, but
+/// it is still reference counted.
+void Cache::BuildExtents()
+{
+	if( m_bExtentsBuilt )
+	{
+		return;
+	}
+
+	m_extentMap.Clear();
+	m_contentMap.Clear();
+
+	size_t entryCount = m_entries.GetSize();
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		const Entry* pEntry = m_entries[ entryIndex ];
+		HELIUM_ASSERT( pEntry );
+		AddExtentReference( pEntry->offset, pEntry->size, pEntry->contentHash );
+	}
+
+	m_bExtentsBuilt = true;
+}
+
+/// Search for an extent storing the given bytes.
+///
+/// Extents with a matching hash and size are compared byte for byte with the given data before being shared.
+///
+/// @param[in] pData        Data as it will be stored.
+/// @param[in] size         Data size, in bytes.
+/// @param[in] contentHash  Stable hash of the data.
+///
+/// @return  Offset of an extent storing the same bytes, or an invalid offset if there is none.
+uint64_t Cache::FindSharedExtent( const void* pData, uint32_t size, uint64_t contentHash )
+{
+	if( size == 0 )
+	{
+		return Invalid< uint64_t >();
+	}
+
+	ContentMapType::ConstIterator contentIterator = m_contentMap.Find( contentHash );
+	if( contentIterator == m_contentMap.End() )
+	{
+		return Invalid< uint64_t >();
+	}
+
+	uint64_t offset = contentIterator->Second();
+
+	ExtentMapType::ConstIterator extentIterator = m_extentMap.Find( offset );
+	HELIUM_ASSERT( extentIterator != m_extentMap.End() );
+	if( extentIterator == m_extentMap.End() || extentIterator->Second().size != size )
+	{
+		return Invalid< uint64_t >();
+	}
+
+	if( !m_pCacheReadStream )
+	{
+		m_pCacheReadStream = FileStream::OpenFileStream( m_cacheFileName, FileStream::MODE_READ );
+		if( !m_pCacheReadStream )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"Cache: Failed to open cache \"%s\" for reading, so its stored data will not be shared.\n",
+				*m_cacheFileName );
+
+			return Invalid< uint64_t >();
+		}
+	}
+
+	m_compareData.Resize( size );
+
+	int64_t seekOffset = m_pCacheReadStream->Seek( static_cast< int64_t >( offset ), SeekOrigins::Begin );
+	if( static_cast< uint64_t >( seekOffset ) != offset ||
+		m_pCacheReadStream->Read( m_compareData.GetData(), 1, size ) != size )
+	{
+		return Invalid< uint64_t >();
+	}
+
+	if( memcmp( m_compareData.GetData(), pData, size ) != 0 )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Debug,
+			"Cache: Content hash collision @ offset %" PRIu64 " in \"%s\".\n",
+			offset,
+			*m_cacheFileName );
+
+		return Invalid< uint64_t >();
+	}
+
+	return offset;
+}
+
+/// Get the number of entries referencing the data stored at an offset.
+///
+/// @param[in] offset  Extent offset.
+///
+/// @return  Reference count (zero if no extent starts at the given offset).
+uint32_t Cache::GetExtentReferenceCount( uint64_t offset ) const
+{
+	ExtentMapType::ConstIterator extentIterator = m_extentMap.Find( offset );
+
+	return ( extentIterator != m_extentMap.End() ? extentIterator->Second().referenceCount : 0 );
+}
+
+/// Add a reference to the data stored at an offset, adding the extent if it is not referenced yet.
+///
+/// @param[in] offset       Extent offset.
+/// @param[in] size         Size of the stored data (nothing is referenced if this is zero).
+/// @param[in] contentHash  Stable hash of the stored data (zero if unknown).
+///
+/// @see ReleaseExtentReference()
+void Cache::AddExtentReference( uint64_t offset, uint32_t size, uint64_t contentHash )
+{
+	if( size == 0 )
+	{
+		return;
+	}
+
+	ExtentMapType::Iterator extentIterator = m_extentMap.Find( offset );
+	if( extentIterator != m_extentMap.End() )
+	{
+		Extent& rExtent = extentIterator->Second();
+		HELIUM_ASSERT( rExtent.size == size );
+		++rExtent.referenceCount;
+
+		return;
+	}
+
+	Extent extent;
+	extent.contentHash = contentHash;
+	extent.size = size;
+	extent.referenceCount = 1;
+	HELIUM_VERIFY( m_extentMap.Insert( extentIterator, ExtentMapType::ValueType( offset, extent ) ) );
+
+	if( contentHash != 0 )
+	{
+		ContentMapType::Iterator contentIterator;
+		m_contentMap.Insert( contentIterator, ContentMapType::ValueType( contentHash, offset ) );
+	}
+}
+
+/// Release a reference to the data stored at an offset, removing the extent once it is no longer referenced.
+///
+/// The bytes of an unreferenced extent stay in the cache file until they are overwritten or the cache file is
+/// compacted (see Compact()).
+///
+/// @param[in] offset  Extent offset.
+///
+/// @see AddExtentReference()
+void Cache::ReleaseExtentReference( uint64_t offset )
+{
+	ExtentMapType::Iterator extentIterator = m_extentMap.Find( offset );
+	if( extentIterator == m_extentMap.End() )
+	{
+		// Entries with no stored data do not reference any extent.
+		return;
+	}
+
+	Extent& rExtent = extentIterator->Second();
+	HELIUM_ASSERT( rExtent.referenceCount != 0 );
+	if( --rExtent.referenceCount != 0 )
+	{
+		return;
+	}
+
+	if( rExtent.contentHash != 0 )
+	{
+		ContentMapType::Iterator contentIterator = m_contentMap.Find( rExtent.contentHash );
+		if( contentIterator != m_contentMap.End() && contentIterator->Second() == offset )
+		{
+			m_contentMap.Remove( contentIterator );
+		}
+	}
+
+	m_extentMap.Remove( extentIterator );
+}
+
+/// Write one entry record to a TOC file stream.
+///
+/// @param[in] pStream      TOC file stream.
+/// @param[in] pEntry       Entry to write.
+/// @param[in] rEntryPath   Scratch string for the entry path.
+static void WriteTocRecord( BufferedStream* pStream, const Cache::Entry* pEntry, String& rEntryPath )
+{
+	HELIUM_ASSERT( pStream );
+	HELIUM_ASSERT( pEntry );
+
+	pEntry->path.ToString( rEntryPath );
+	HELIUM_ASSERT( rEntryPath.GetSize() < UINT16_MAX );
+	uint16_t pathSize = static_cast< uint16_t >( rEntryPath.GetSize() );
+	pStream->Write( &pathSize, sizeof( pathSize ), 1 );
+
+	pStream->Write( *rEntryPath, sizeof( char ), pathSize );
+
+	pStream->Write( &pEntry->subDataIndex, sizeof( pEntry->subDataIndex ), 1 );
+
+	pStream->Write( &pEntry->offset, sizeof( pEntry->offset ), 1 );
+	pStream->Write( &pEntry->timestamp, sizeof( pEntry->timestamp ), 1 );
+	pStream->Write( &pEntry->size, sizeof( pEntry->size ), 1 );
+	pStream->Write( &pEntry->uncompressedSize, sizeof( pEntry->uncompressedSize ), 1 );
+	pStream->Write( &pEntry->codec, sizeof( pEntry->codec ), 1 );
+	pStream->Write( &pEntry->contentHash, sizeof( pEntry->contentHash ), 1 );
+}
+
+/// Order entries by stable path hash, then by sub-data index, as hashed TOC records are stored.
+///
+/// @param[in] pEntry0  First entry.
+/// @param[in] pEntry1  Second entry.
+///
+/// @return  True if the first entry sorts before the second, false if not.
+static bool TocEntryLess( const Cache::Entry* pEntry0, const Cache::Entry* pEntry1 )
+{
+	uint64_t hash0 = pEntry0->path.GetStableHash();
+	uint64_t hash1 = pEntry1->path.GetStableHash();
+	if( hash0 != hash1 )
+	{
+		return ( hash0 < hash1 );
+	}
+
+	return ( pEntry0->subDataIndex < pEntry1->subDataIndex );
+}
+
+/// Update the TOC file for the entries written by the current CacheEntries() call.
+///
+/// Records for the written entries are appended to the TOC journal.  The whole TOC is rewritten instead if its file
+/// cannot be appended to, or if the journal would grow past both TOC_JOURNAL_COMPACT_MIN and the compacted entry
+/// count, which keeps the total amount of TOC data written linear in the number of entries cached.
+///
+/// A rewritten TOC uses hashed records, unless two entries share the same path hash and sub-data index, in which case
+/// records keyed by path strings are written instead.
+///
+/// @param[in] bRewrite      True to rewrite the whole TOC regardless of the journal length.
+/// @param[in] pTocFileName  File to write the TOC to instead of the TOC file (only with bRewrite), or null.
+///
+/// @return  True if the TOC file was opened for writing, false if not.
+bool Cache::WriteToc( bool bRewrite, const char* pTocFileName )
+{
+	uint32_t updatedCount = static_cast< uint32_t >( m_updatedEntries.GetSize() );
+	uint32_t journalLimit = TOC_JOURNAL_COMPACT_MIN;
+	if( m_tocCompactedCount > journalLimit )
+	{
+		journalLimit = m_tocCompactedCount;
+	}
+
+	bool bCompact = ( bRewrite || !m_bTocAppendable || m_tocJournalCount + updatedCount > journalLimit );
+	HELIUM_ASSERT( bCompact || !pTocFileName );
+
+	String tocFileName( pTocFileName ? pTocFileName : *m_tocFileName );
+
+	FileStream* pTocStream = FileStream::OpenFileStream( tocFileName, FileStream::MODE_WRITE, bCompact );
+	if( !pTocStream )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "Cache: Failed to open TOC \"%s\" for writing.\n", *tocFileName );
+
+		// The TOC on disk no longer matches the entries, so make sure the next write replaces it.
+		m_bTocAppendable = false;
+
+		return false;
+	}
+
+	if( !bCompact )
+	{
+		pTocStream->Seek( 0, SeekOrigins::End );
+	}
+
+	BufferedStream* pBufferedStream = new BufferedStream( pTocStream );
+	HELIUM_ASSERT( pBufferedStream );
+
+	String entryPath;
+
+	if( bCompact )
+	{
+		HELIUM_TRACE( TraceLevels::Info, "Cache: Rewriting TOC file \"%s\".\n", *tocFileName );
+
+		uint32_t entryCount = static_cast< uint32_t >( m_entries.GetSize() );
+		uint_fast32_t entryCountFast = entryCount;
+
+		DynamicArray< Entry* > sortedEntries( m_entries );
+		std::sort( sortedEntries.GetData(), sortedEntries.GetData() + entryCountFast, TocEntryLess );
+
+		uint32_t flags = TOC_FLAG_HASHED | ( HELIUM_CACHE_TOC_PATH_TABLE ? TOC_FLAG_PATH_TABLE : 0 );
+		for( uint_fast32_t entryIndex = 1; entryIndex < entryCountFast; ++entryIndex )
+		{
+			if( !TocEntryLess( sortedEntries[ entryIndex - 1 ], sortedEntries[ entryIndex ] ) )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Warning,
+					"Cache: \"%s\" and \"%s\" have the same path hash, so TOC \"%s\" will be keyed by path strings.\n",
+					*sortedEntries[ entryIndex - 1 ]->path.ToString(),
+					*sortedEntries[ entryIndex ]->path.ToString(),
+					*tocFileName );
+
+				flags = 0;
+
+				break;
+			}
+		}
+
+		pBufferedStream->Write( &TOC_MAGIC, sizeof( TOC_MAGIC ), 1 );
+		pBufferedStream->Write( &sm_Version, sizeof( sm_Version ), 1 );
+		pBufferedStream->Write( &entryCount, sizeof( entryCount ), 1 );
+		pBufferedStream->Write( &flags, sizeof( flags ), 1 );
+
+		if( !( flags & TOC_FLAG_HASHED ) )
+		{
+			for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
+			{
+				WriteTocRecord( pBufferedStream, m_entries[ entryIndex ], entryPath );
+			}
+		}
+		else
+		{
+			for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
+			{
+				const Entry* pEntry = sortedEntries[ entryIndex ];
+				HELIUM_ASSERT( pEntry );
+
+				TocRecord record;
+				record.pathHash = pEntry->path.GetStableHash();
+				record.offset = pEntry->offset;
+				record.timestamp = pEntry->timestamp;
+				record.contentHash = pEntry->contentHash;
+				record.subDataIndex = pEntry->subDataIndex;
+				record.size = pEntry->size;
+				record.uncompressedSize = pEntry->uncompressedSize;
+				record.codec = pEntry->codec;
+				pBufferedStream->Write( &record, sizeof( record ), 1 );
+			}
+
+			if( flags & TOC_FLAG_PATH_TABLE )
+			{
+				// Path strings in record order, each prefixed by its length.
+				DynamicArray< uint8_t > pathTable;
+				for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
+				{
+					sortedEntries[ entryIndex ]->path.ToString( entryPath );
+					HELIUM_ASSERT( entryPath.GetSize() < UINT16_MAX );
+					uint16_t pathSize = static_cast< uint16_t >( entryPath.GetSize() );
+
+					size_t tableSize = pathTable.GetSize();
+					pathTable.Resize( tableSize + sizeof( pathSize ) + pathSize );
+					MemoryCopy( pathTable.GetData() + tableSize, &pathSize, sizeof( pathSize ) );
+					MemoryCopy( pathTable.GetData() + tableSize + sizeof( pathSize ), *entryPath, pathSize );
+				}
+
+				HELIUM_ASSERT( pathTable.GetSize() <= UINT32_MAX );
+				uint32_t pathTableSize = static_cast< uint32_t >( pathTable.GetSize() );
+				pBufferedStream->Write( &pathTableSize, sizeof( pathTableSize ), 1 );
+				pBufferedStream->Write( pathTable.GetData(), 1, pathTableSize );
+			}
+		}
+
+		m_tocCompactedCount = entryCount;
+		m_tocJournalCount = 0;
+		m_bTocAppendable = true;
+	}
+	else
+	{
+		HELIUM_TRACE(
+			TraceLevels::Debug,
+			"Cache: Appending %" PRIu32 " records to TOC file \"%s\".\n",
+			updatedCount,
+			*tocFileName );
+
+		for( uint32_t entryIndex = 0; entryIndex < updatedCount; ++entryIndex )
+		{
+			WriteTocRecord( pBufferedStream, m_updatedEntries[ entryIndex ], entryPath );
+		}
+
+		m_tocJournalCount += updatedCount;
+	}
+
+	delete pBufferedStream;
+	delete pTocStream;
+
+	return true;
+}
+
+/// Finalize the TOC loading process.
+///
+/// Note that this does not free any resources on a failed load (the caller is responsible for such clean-up work).
+///
+/// @return  True if the TOC load was successful, false if not.
+bool Cache::FinalizeTocLoad()
+{
+	HELIUM_ASSERT( m_pTocBuffer );
+
+	const uint8_t* pTocCurrent = m_pTocBuffer;
+	const uint8_t* pTocMax = pTocCurrent + m_tocSize;
+
+	m_bTocAppendable = false;
+
+	// Validate the TOC header.
+	uint32_t magic;
+	if( !CheckedTocRead( MemoryCopy, magic, "the header magic", pTocCurrent, pTocMax ) )
+	{
+		return false;
+	}
+
+	LOAD_VALUE_CALLBACK* pLoadFunction = NULL;
+	if( magic == TOC_MAGIC )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"Cache::FinalizeTocLoad(): TOC \"%s\" identified (no byte swapping).\n",
+			*m_tocFileName );
+
+		pLoadFunction = MemoryCopy;
+	}
+	else if( magic == TOC_MAGIC_SWAPPED )
 	{
 		HELIUM_TRACE(
 			TraceLevels::Info,
@@ -584,149 +1983,760 @@ bool Cache::FinalizeTocLoad()
 		return false;
 	}
 
-	uint32_t version;
-	if( !CheckedTocRead( pLoadFunction, version, "the cache version number", pTocCurrent, pTocMax ) )
+	uint32_t version;
+	if( !CheckedTocRead( pLoadFunction, version, "the cache version number", pTocCurrent, pTocMax ) )
+	{
+		return false;
+	}
+
+	if( version > sm_Version )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Cache::FinalizeTocLoad(): Cache version number (%" PRIu32 ") exceeds the maximum supported version (%" PRIu32 ").\n",
+			version,
+			sm_Version );
+
+		return false;
+	}
+
+	// Read the numbers of entries in the cache.
+	uint32_t entryCount;
+	bool bReadResult = CheckedTocRead(
+		pLoadFunction,
+		entryCount,
+		"the number of entries in the cache",
+		pTocCurrent,
+		pTocMax );
+	if( !bReadResult )
+	{
+		return false;
+	}
+
+	// Version 3 flags whether the records are hashed, while version 2 records always are.
+	uint32_t flags = 0;
+	if( version >= 2 )
+	{
+		if( !CheckedTocRead( pLoadFunction, flags, "the TOC flags", pTocCurrent, pTocMax ) )
+		{
+			return false;
+		}
+
+		if( version == 2 )
+		{
+			flags |= TOC_FLAG_HASHED;
+		}
+	}
+
+	// Load the entry information.
+	EntryKey key;
+	Entry record;
+
+	uint_fast32_t entryCountFast = entryCount;
+	if( flags & TOC_FLAG_HASHED )
+	{
+		// Hashed records are fixed-size and already sorted, so they are used in place rather than parsed.
+		HELIUM_COMPILE_ASSERT( sizeof( TocRecord ) == 48 );
+		HELIUM_COMPILE_ASSERT( sizeof( TocRecordVersion2 ) == 32 );
+		HELIUM_COMPILE_ASSERT( sizeof( TocRecordVersion3 ) == 40 );
+
+		size_t recordSize = (
+			version == 2 ? sizeof( TocRecordVersion2 ) :
+			version == 3 ? sizeof( TocRecordVersion3 ) :
+			sizeof( TocRecord ) );
+		if( static_cast< size_t >( pTocMax - pTocCurrent ) / recordSize < entryCountFast )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"Cache::FinalizeTocLoad(): Not enough bytes in TOC \"%s\" for %" PRIu32 " entry records.\n",
+				*m_tocFileName,
+				entryCount );
+
+			return false;
+		}
+
+		// The header is 16 bytes, so records are 8-byte aligned within the (allocator-aligned) TOC buffer.
+		HELIUM_ASSERT( reinterpret_cast< uintptr_t >( pTocCurrent ) % sizeof( uint64_t ) == 0 );
+		uint8_t* pRecordData = const_cast< uint8_t* >( pTocCurrent );
+		pTocCurrent += recordSize * entryCountFast;
+
+		m_bTocByteSwapped = ( pLoadFunction != MemoryCopy );
+
+		TocRecord* pRecords;
+		if( version < sm_Version )
+		{
+			// Older records lack some of the current fields, so they are widened into a separate array.
+			pRecords = NULL;
+			if( entryCountFast != 0 )
+			{
+				pRecords = static_cast< TocRecord* >(
+					DefaultAllocator().Allocate( sizeof( TocRecord ) * entryCountFast ) );
+				HELIUM_ASSERT( pRecords );
+			}
+
+			for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
+			{
+				TocRecord& rRecord = pRecords[ entryIndex ];
+				if( version == 2 )
+				{
+					const TocRecordVersion2& rOldRecord =
+						reinterpret_cast< const TocRecordVersion2* >( pRecordData )[ entryIndex ];
+					pLoadFunction( &rRecord.pathHash, &rOldRecord.pathHash, sizeof( rRecord.pathHash ) );
+					pLoadFunction( &rRecord.offset, &rOldRecord.offset, sizeof( rRecord.offset ) );
+					pLoadFunction( &rRecord.timestamp, &rOldRecord.timestamp, sizeof( rRecord.timestamp ) );
+					pLoadFunction( &rRecord.subDataIndex, &rOldRecord.subDataIndex, sizeof( rRecord.subDataIndex ) );
+					pLoadFunction( &rRecord.size, &rOldRecord.size, sizeof( rRecord.size ) );
+					rRecord.uncompressedSize = rRecord.size;
+					rRecord.codec = CompressionCodecs::None;
+				}
+				else
+				{
+					const TocRecordVersion3& rOldRecord =
+						reinterpret_cast< const TocRecordVersion3* >( pRecordData )[ entryIndex ];
+					pLoadFunction( &rRecord.pathHash, &rOldRecord.pathHash, sizeof( rRecord.pathHash ) );
+					pLoadFunction( &rRecord.offset, &rOldRecord.offset, sizeof( rRecord.offset ) );
+					pLoadFunction( &rRecord.timestamp, &rOldRecord.timestamp, sizeof( rRecord.timestamp ) );
+					pLoadFunction( &rRecord.subDataIndex, &rOldRecord.subDataIndex, sizeof( rRecord.subDataIndex ) );
+					pLoadFunction( &rRecord.size, &rOldRecord.size, sizeof( rRecord.size ) );
+					pLoadFunction(
+						&rRecord.uncompressedSize,
+						&rOldRecord.uncompressedSize,
+						sizeof( rRecord.uncompressedSize ) );
+					pLoadFunction( &rRecord.codec, &rOldRecord.codec, sizeof( rRecord.codec ) );
+				}
+
+				rRecord.contentHash = 0;
+			}
+
+			// The widened records are already in our byte order.
+			m_bTocByteSwapped = false;
+			m_pConvertedTocRecords = pRecords;
+		}
+		else
+		{
+			pRecords = reinterpret_cast< TocRecord* >( pRecordData );
+			if( m_bTocByteSwapped )
+			{
+				for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
+				{
+					TocRecord& rRecord = pRecords[ entryIndex ];
+					TocRecord swapped;
+					ReverseByteOrder( &swapped.pathHash, &rRecord.pathHash, sizeof( swapped.pathHash ) );
+					ReverseByteOrder( &swapped.offset, &rRecord.offset, sizeof( swapped.offset ) );
+					ReverseByteOrder( &swapped.timestamp, &rRecord.timestamp, sizeof( swapped.timestamp ) );
+					ReverseByteOrder( &swapped.contentHash, &rRecord.contentHash, sizeof( swapped.contentHash ) );
+					ReverseByteOrder( &swapped.subDataIndex, &rRecord.subDataIndex, sizeof( swapped.subDataIndex ) );
+					ReverseByteOrder( &swapped.size, &rRecord.size, sizeof( swapped.size ) );
+					ReverseByteOrder(
+						&swapped.uncompressedSize,
+						&rRecord.uncompressedSize,
+						sizeof( swapped.uncompressedSize ) );
+					ReverseByteOrder( &swapped.codec, &rRecord.codec, sizeof( swapped.codec ) );
+					rRecord = swapped;
+				}
+			}
+		}
+
+		if( flags & TOC_FLAG_PATH_TABLE )
+		{
+			uint32_t pathTableSize;
+			if( !CheckedTocRead( pLoadFunction, pathTableSize, "the path table size", pTocCurrent, pTocMax ) )
+			{
+				return false;
+			}
+
+			if( pathTableSize > static_cast< size_t >( pTocMax - pTocCurrent ) )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					"Cache::FinalizeTocLoad(): Not enough bytes in TOC \"%s\" for its path table.\n",
+					*m_tocFileName );
+
+				return false;
+			}
+
+			m_pTocPathTable = pTocCurrent;
+			m_pTocPathTableEnd = pTocCurrent + pathTableSize;
+			pTocCurrent += pathTableSize;
+		}
+
+		m_pTocRecords = pRecords;
+		m_tocRecordCount = entryCount;
+		m_bTocExpanded = ( entryCount == 0 );
+	}
+	else
+	{
+		m_entries.Reserve( entryCountFast );
+		for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
+		{
+			if( !ReadTocRecord( pLoadFunction, version, pTocCurrent, pTocMax, key, record ) )
+			{
+				return false;
+			}
+
+			EntryMapType::ConstAccessor entryAccessor;
+			if( m_entryMap.Find( entryAccessor, key ) )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					"Cache::FinalizeTocLoad(): Duplicate entry found for AssetPath \"%s\", sub-data %" PRIu32 ".\n",
+					*key.path.ToString(),
+					key.subDataIndex );
+
+				return false;
+			}
+
+			Entry* pEntry = m_pEntryPool->Allocate();
+			HELIUM_ASSERT( pEntry );
+			*pEntry = record;
+
+			m_entries.Add( pEntry );
+
+			HELIUM_VERIFY( m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntry ) ) );
+		}
+	}
+
+	m_tocCompactedCount = entryCount;
+	m_tocJournalCount = 0;
+
+	// Apply the journal, in which later records replace earlier ones for the same entry.  Entries for journal records
+	// take precedence over hashed TOC records for the same path, as they are found first by FindEntry().
+	bool bJournalComplete = true;
+	while( pTocCurrent < pTocMax )
+	{
+		if( !ReadTocRecord( pLoadFunction, version, pTocCurrent, pTocMax, key, record ) )
+		{
+			// A record cut short by an interrupted write; everything before it is still good.
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"Cache::FinalizeTocLoad(): TOC \"%s\" ends with an incomplete journal record, which will be discarded.\n",
+				*m_tocFileName );
+
+			bJournalComplete = false;
+
+			break;
+		}
+
+		Entry* pEntry = m_pEntryPool->Allocate();
+		HELIUM_ASSERT( pEntry );
+		*pEntry = record;
+
+		EntryMapType::Accessor entryAccessor;
+		if( m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntry ) ) )
+		{
+			m_entries.Add( pEntry );
+		}
+		else
+		{
+			Entry* pExistingEntry = entryAccessor->Second();
+			HELIUM_ASSERT( pExistingEntry );
+			pExistingEntry->offset = record.offset;
+			pExistingEntry->timestamp = record.timestamp;
+			pExistingEntry->contentHash = record.contentHash;
+			pExistingEntry->size = record.size;
+			pExistingEntry->uncompressedSize = record.uncompressedSize;
+			pExistingEntry->codec = record.codec;
+
+			m_pEntryPool->Release( pEntry );
+		}
+
+		++m_tocJournalCount;
+	}
+
+	// Records can only be appended in our own byte order, after a journal that ends cleanly.
+	m_bTocAppendable = ( pLoadFunction == MemoryCopy && version == sm_Version && bJournalComplete );
+
+	return true;
+}
+
+/// Read one entry record from the cache TOC.
+///
+/// @param[in]  pLoadFunction  Function to use for reading values.
+/// @param[in]  version        TOC version number.
+/// @param[in]  rpTocCurrent   Pointer to the current offset within the TOC file buffer.
+/// @param[in]  pTocMax        Pointer to the end of the TOC file buffer.
+/// @param[out] rKey           Entry path and sub-data index.
+/// @param[out] rEntry         Entry information.
+///
+/// @return  True if the record was read successfully, false if not.
+bool Cache::ReadTocRecord(
+						  LOAD_VALUE_CALLBACK* pLoadFunction,
+						  uint32_t version,
+						  const uint8_t*& rpTocCurrent,
+						  const uint8_t* pTocMax,
+						  EntryKey& rKey,
+						  Entry& rEntry )
+{
+	if( !ReadTocPath( pLoadFunction, rpTocCurrent, pTocMax, rKey.path ) )
+	{
+		return false;
+	}
+
+	if( !CheckedTocRead( pLoadFunction, rKey.subDataIndex, "entry sub-data index", rpTocCurrent, pTocMax ) )
 	{
 		return false;
 	}
 
-	if( version > sm_Version )
+	if( !CheckedTocRead( pLoadFunction, rEntry.offset, "entry offset", rpTocCurrent, pTocMax ) )
 	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"Cache::FinalizeTocLoad(): Cache version number (%" PRIu32 ") exceeds the maximum supported version (%" PRIu32 ").\n",
-			version,
-			sm_Version );
-
 		return false;
 	}
 
-	// Read the numbers of entries in the cache.
-	uint32_t entryCount;
-	bool bReadResult = CheckedTocRead(
-		pLoadFunction,
-		entryCount,
-		"the number of entries in the cache",
-		pTocCurrent,
-		pTocMax );
-	if( !bReadResult )
+	if( !CheckedTocRead( pLoadFunction, rEntry.timestamp, "entry timestamp", rpTocCurrent, pTocMax ) )
 	{
 		return false;
 	}
 
-	// Load the entry information.
-	EntryKey key;
+	if( !CheckedTocRead( pLoadFunction, rEntry.size, "entry size", rpTocCurrent, pTocMax ) )
+	{
+		return false;
+	}
 
-	uint_fast32_t entryCountFast = entryCount;
-	m_entries.Reserve( entryCountFast );
-	for( uint_fast32_t entryIndex = 0; entryIndex < entryCountFast; ++entryIndex )
+	if( version >= 3 )
 	{
-		uint16_t entryPathSize;
-		bReadResult = CheckedTocRead(
-			pLoadFunction,
-			entryPathSize,
-			"entry AssetPath string size",
-			pTocCurrent,
-			pTocMax );
-		if( !bReadResult )
+		if( !CheckedTocRead( pLoadFunction, rEntry.uncompressedSize, "entry uncompressed size", rpTocCurrent, pTocMax ) )
 		{
 			return false;
 		}
 
-		uint_fast16_t entryPathSizeFast = entryPathSize;
-
-		StackMemoryHeap<>::Marker stackMarker( rStackHeap );
-		char* pPathString = static_cast< char* >( rStackHeap.Allocate(
-			sizeof( char ) * ( entryPathSizeFast + 1 ) ) );
-		HELIUM_ASSERT( pPathString );
-		pPathString[ entryPathSizeFast ] = '\0';
-
-		for( uint_fast16_t characterIndex = 0; characterIndex < entryPathSizeFast; ++characterIndex )
+		if( !CheckedTocRead( pLoadFunction, rEntry.codec, "entry codec", rpTocCurrent, pTocMax ) )
 		{
-			bReadResult = CheckedTocRead(
-				pLoadFunction,
-				pPathString[ characterIndex ],
-				"entry AssetPath string character",
-				pTocCurrent,
-				pTocMax );
-			if( !bReadResult )
-			{
-				return false;
-			}
+			return false;
 		}
 
-		AssetPath entryPath;
-		if( !entryPath.Set( pPathString ) )
+		if( rEntry.codec >= CompressionCodecs::Count )
 		{
 			HELIUM_TRACE(
 				TraceLevels::Error,
-				"Cache::FinalizeTocLoad(): Failed to set AssetPath for entry %" PRIuFAST16 ".\n",
-				entryIndex );
+				"Cache::ReadTocRecord(): Unknown entry codec %" PRIu32 ".\n",
+				static_cast< uint32_t >( rEntry.codec ) );
 
 			return false;
 		}
+	}
+	else
+	{
+		rEntry.uncompressedSize = rEntry.size;
+		rEntry.codec = CompressionCodecs::None;
+	}
 
-		uint32_t entrySubDataIndex;
-		bReadResult = CheckedTocRead(
-			pLoadFunction,
-			entrySubDataIndex,
-			"entry sub-data index",
-			pTocCurrent,
-			pTocMax );
-		if( !bReadResult )
+	if( version >= 4 )
+	{
+		if( !CheckedTocRead( pLoadFunction, rEntry.contentHash, "entry content hash", rpTocCurrent, pTocMax ) )
 		{
 			return false;
 		}
+	}
+	else
+	{
+		rEntry.contentHash = 0;
+	}
 
-		key.path = entryPath;
-		key.subDataIndex = entrySubDataIndex;
+	rEntry.path = rKey.path;
+	rEntry.subDataIndex = rKey.subDataIndex;
 
-		EntryMapType::ConstAccessor entryAccessor;
-		if( m_entryMap.Find( entryAccessor, key ) )
+	return true;
+}
+
+/// Binary search the hashed TOC records for the given entry.
+///
+/// @param[in] pathHash      Stable hash of the entry path.
+/// @param[in] subDataIndex  Sub-data index.
+///
+/// @return  Matching record, or null if there is none.
+const Cache::TocRecord* Cache::FindTocRecord( uint64_t pathHash, uint32_t subDataIndex ) const
+{
+	HELIUM_ASSERT( m_pTocRecords || m_tocRecordCount == 0 );
+
+	size_t low = 0;
+	size_t high = m_tocRecordCount;
+	while( low < high )
+	{
+		size_t middle = low + ( high - low ) / 2;
+		const TocRecord& rRecord = m_pTocRecords[ middle ];
+		if( rRecord.pathHash < pathHash ||
+			( rRecord.pathHash == pathHash && rRecord.subDataIndex < subDataIndex ) )
 		{
-			HELIUM_TRACE(
-				TraceLevels::Error,
-				"Cache::FinalizeTocLoad(): Duplicate entry found for AssetPath \"%s\", sub-data %" PRIu32 ".\n",
-				pPathString,
-				entrySubDataIndex );
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
 
-			return false;
+	if( low < m_tocRecordCount )
+	{
+		const TocRecord& rRecord = m_pTocRecords[ low ];
+		if( rRecord.pathHash == pathHash && rRecord.subDataIndex == subDataIndex )
+		{
+			return &rRecord;
 		}
+	}
+
+	return NULL;
+}
+
+/// Add the entry for a hashed TOC record, unless another thread has already added it.
+///
+/// @param[in] rRecord  TOC record.
+/// @param[in] path     Path of the entry.
+///
+/// @return  Entry for the record.
+Cache::Entry* Cache::AddTocRecordEntry( const TocRecord& rRecord, AssetPath path ) const
+{
+	HELIUM_ASSERT( path.GetStableHash() == rRecord.pathHash );
+
+	EntryKey key;
+	key.path = path;
+	key.subDataIndex = rRecord.subDataIndex;
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	EntryMapType::Accessor entryAccessor;
+	if( m_entryMap.Find( entryAccessor, key ) )
+	{
+		return entryAccessor->Second();
+	}
+
+	HELIUM_ASSERT( m_pEntryPool );
+	Entry* pEntry = m_pEntryPool->Allocate();
+	HELIUM_ASSERT( pEntry );
+	pEntry->path = path;
+	pEntry->subDataIndex = rRecord.subDataIndex;
+	pEntry->offset = rRecord.offset;
+	pEntry->timestamp = rRecord.timestamp;
+	pEntry->contentHash = rRecord.contentHash;
+	pEntry->size = rRecord.size;
+	pEntry->uncompressedSize = rRecord.uncompressedSize;
+	pEntry->codec = static_cast< uint8_t >( rRecord.codec );
+
+	m_entries.Push( pEntry );
+	HELIUM_VERIFY( m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntry ) ) );
+	if( m_pFrozenTags )
+	{
+		AtomicIncrementRelease( m_overflowEntryCount );
+	}
+
+	return pEntry;
+}
+
+/// Make sure an entry exists for every hashed TOC record, reading their paths from the path table.
+///
+/// @return  True if every record has an entry, false if the TOC has no (or an incomplete) path table.
+bool Cache::ExpandToc() const
+{
+	if( !m_pTocRecords || m_bTocExpanded )
+	{
+		return true;
+	}
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	if( m_bTocExpanded )
+	{
+		return true;
+	}
+
+	if( !m_pTocPathTable )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"Cache::ExpandToc(): TOC \"%s\" has no path table, so its entries can only be found by path.\n",
+			*m_tocFileName );
+
+		return false;
+	}
+
+	LOAD_VALUE_CALLBACK* pLoadFunction = ( m_bTocByteSwapped ? ReverseByteOrder : MemoryCopy );
+	const uint8_t* pTableCurrent = m_pTocPathTable;
+
+	m_entries.Reserve( m_entries.GetSize() + m_tocRecordCount );
 
-		uint64_t entryOffset;
-		if( !CheckedTocRead( pLoadFunction, entryOffset, "entry offset", pTocCurrent, pTocMax ) )
+	EntryKey key;
+	for( uint32_t recordIndex = 0; recordIndex < m_tocRecordCount; ++recordIndex )
+	{
+		const TocRecord& rRecord = m_pTocRecords[ recordIndex ];
+		if( !ReadTocPath( pLoadFunction, pTableCurrent, m_pTocPathTableEnd, key.path, rRecord.pathHash ) )
 		{
 			return false;
 		}
 
-		int64_t entryTimestamp;
-		if( !CheckedTocRead( pLoadFunction, entryTimestamp, "entry timestamp", pTocCurrent, pTocMax ) )
+		if( key.path.GetStableHash() != rRecord.pathHash )
 		{
-			return false;
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"Cache::ExpandToc(): Path hash for \"%s\" in TOC \"%s\" does not match its path.\n",
+				*key.path.ToString(),
+				*m_tocFileName );
 		}
 
-		uint32_t entrySize;
-		if( !CheckedTocRead( pLoadFunction, entrySize, "entry size", pTocCurrent, pTocMax ) )
+		key.subDataIndex = rRecord.subDataIndex;
+
+		EntryMapType::Accessor entryAccessor;
+		if( m_entryMap.Find( entryAccessor, key ) )
 		{
-			return false;
+			continue;
 		}
 
 		Entry* pEntry = m_pEntryPool->Allocate();
 		HELIUM_ASSERT( pEntry );
-		pEntry->path = entryPath;
-		pEntry->subDataIndex = entrySubDataIndex;
-		pEntry->offset = entryOffset;
-		pEntry->timestamp = entryTimestamp;
-		pEntry->size = entrySize;
+		pEntry->path = key.path;
+		pEntry->subDataIndex = rRecord.subDataIndex;
+		pEntry->offset = rRecord.offset;
+		pEntry->timestamp = rRecord.timestamp;
+		pEntry->contentHash = rRecord.contentHash;
+		pEntry->size = rRecord.size;
+		pEntry->uncompressedSize = rRecord.uncompressedSize;
+		pEntry->codec = static_cast< uint8_t >( rRecord.codec );
+
+		m_entries.Push( pEntry );
+		HELIUM_VERIFY( m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntry ) ) );
+		if( m_pFrozenTags )
+		{
+			AtomicIncrementRelease( m_overflowEntryCount );
+		}
+	}
 
-		m_entries.Add( pEntry );
+	m_bTocExpanded = true;
 
-		HELIUM_VERIFY( m_entryMap.Insert( entryAccessor, KeyValue< EntryKey, Entry* >( key, pEntry ) ) );
+	return true;
+}
+
+/// Search the frozen entry table for an entry.
+///
+/// @param[in] rKey  Entry key.
+///
+/// @return  Entry with the given key if it is in the frozen table, null if not.
+///
+/// @see Freeze()
+const Cache::Entry* Cache::FindFrozenEntry( const EntryKey& rKey ) const
+{
+	HELIUM_ASSERT( m_pFrozenTags );
+
+	uint64_t hash = ComputeFrozenHash( rKey );
+	uint8_t tag = static_cast< uint8_t >( 0x80 | ( hash >> 57 ) );
+
+	size_t groupIndex = static_cast< size_t >( hash ) & m_frozenGroupMask;
+	for( ; ; )
+	{
+		const uint8_t* pGroupTags = m_pFrozenTags + groupIndex * FROZEN_GROUP_SIZE;
+
+		uint32_t matchMask = 0;
+		uint32_t emptyMask = 0;
+#if HELIUM_CPU_X86
+		__m128i groupTags = _mm_loadu_si128( reinterpret_cast< const __m128i* >( pGroupTags ) );
+		matchMask = static_cast< uint32_t >(
+			_mm_movemask_epi8( _mm_cmpeq_epi8( groupTags, _mm_set1_epi8( static_cast< char >( tag ) ) ) ) );
+		emptyMask = static_cast< uint32_t >( _mm_movemask_epi8( _mm_cmpeq_epi8( groupTags, _mm_setzero_si128() ) ) );
+#else
+		for( uint32_t slotIndex = 0; slotIndex < FROZEN_GROUP_SIZE; ++slotIndex )
+		{
+			matchMask |= static_cast< uint32_t >( pGroupTags[ slotIndex ] == tag ) << slotIndex;
+			emptyMask |= static_cast< uint32_t >( pGroupTags[ slotIndex ] == 0 ) << slotIndex;
+		}
+#endif
+
+		for( uint32_t slotIndex = 0; matchMask != 0; ++slotIndex, matchMask >>= 1 )
+		{
+			if( matchMask & 1 )
+			{
+				const Entry* pEntry = m_ppFrozenEntries[ groupIndex * FROZEN_GROUP_SIZE + slotIndex ];
+				HELIUM_ASSERT( pEntry );
+				if( pEntry->subDataIndex == rKey.subDataIndex && pEntry->path == rKey.path )
+				{
+					return pEntry;
+				}
+			}
+		}
+
+		// Slots are filled in probe order, so the entry would have been placed in the first empty slot reached.
+		if( emptyMask != 0 )
+		{
+			return NULL;
+		}
+
+		groupIndex = ( groupIndex + 1 ) & m_frozenGroupMask;
+	}
+}
+
+/// Free the frozen entry table, if any.
+///
+/// @see Freeze()
+void Cache::ReleaseFrozenEntries()
+{
+	DefaultAllocator().Free( m_ppFrozenEntries );
+	m_ppFrozenEntries = NULL;
+	m_pFrozenTags = NULL;
+	m_frozenGroupMask = 0;
+	m_overflowEntryCount = 0;
+}
+
+/// Read a length-prefixed path string from the cache TOC.
+///
+/// @param[in]  pLoadFunction  Function to use for reading values.
+/// @param[in]  rpTocCurrent   Pointer to the current offset within the TOC file buffer.
+/// @param[in]  pTocMax        Pointer to the end of the TOC file buffer.
+/// @param[out] rPath          Path read.
+/// @param[in]  stableHash     Stable hash of the path if known from its TOC record, or zero if not.
+///
+/// @return  True if the path was read successfully, false if not.
+bool Cache::ReadTocPath(
+						LOAD_VALUE_CALLBACK* pLoadFunction,
+						const uint8_t*& rpTocCurrent,
+						const uint8_t* pTocMax,
+						AssetPath& rPath,
+						uint64_t stableHash )
+{
+	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+
+	uint16_t entryPathSize;
+	bool bReadResult = CheckedTocRead(
+		pLoadFunction,
+		entryPathSize,
+		"entry AssetPath string size",
+		rpTocCurrent,
+		pTocMax );
+	if( !bReadResult )
+	{
+		return false;
+	}
+
+	uint_fast16_t entryPathSizeFast = entryPathSize;
+
+	// Paths already created during this run are found from their stable hash without parsing the string.
+	if( stableHash != 0 && AssetPath::FindByStableHash( stableHash, rPath ) )
+	{
+		if( static_cast< size_t >( pTocMax - rpTocCurrent ) < entryPathSizeFast )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"Cache::ReadTocPath(): End of TOC reached while skipping an entry AssetPath string.\n" );
+
+			return false;
+		}
+
+		rpTocCurrent += entryPathSizeFast;
+
+		return true;
+	}
+
+	StackMemoryHeap<>::Marker stackMarker( rStackHeap );
+	char* pPathString = static_cast< char* >( rStackHeap.Allocate(
+		sizeof( char ) * ( entryPathSizeFast + 1 ) ) );
+	HELIUM_ASSERT( pPathString );
+	pPathString[ entryPathSizeFast ] = '\0';
+
+	for( uint_fast16_t characterIndex = 0; characterIndex < entryPathSizeFast; ++characterIndex )
+	{
+		bReadResult = CheckedTocRead(
+			pLoadFunction,
+			pPathString[ characterIndex ],
+			"entry AssetPath string character",
+			rpTocCurrent,
+			pTocMax );
+		if( !bReadResult )
+		{
+			return false;
+		}
+	}
+
+	if( !rPath.Set( pPathString ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Cache::FinalizeTocLoad(): Failed to set AssetPath for entry \"%s\".\n",
+			pPathString );
+
+		return false;
 	}
 
 	return true;
 }
 
+/// Compute the hash used to place an entry in the frozen entry table.
+///
+/// The entry key hash is mixed so that both its low bits (used to pick a slot group) and its high bits (used as the
+/// slot tag) vary with every bit of the key.
+///
+/// @param[in] rKey  Entry key.
+///
+/// @return  Frozen table hash.
+uint64_t Cache::ComputeFrozenHash( const EntryKey& rKey )
+{
+	uint64_t hash = static_cast< uint64_t >( EntryKeyHash()( rKey ) );
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+/// Compute the stable hash of data as stored in a cache file.
+///
+/// @param[in] pData  Data.
+/// @param[in] size   Data size, in bytes.
+///
+/// @return  64-bit FNV-1a hash of the data (never zero, which is reserved for unknown hashes).
+uint64_t Cache::ComputeContentHash( const void* pData, size_t size )
+{
+	static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+	HELIUM_ASSERT( pData || size == 0 );
+
+	uint64_t hash = FNV_OFFSET_BASIS;
+
+	const uint8_t* pBytes = static_cast< const uint8_t* >( pData );
+	for( size_t byteIndex = 0; byteIndex < size; ++byteIndex )
+	{
+		hash = ( hash ^ pBytes[ byteIndex ] ) * FNV_PRIME;
+	}
+
+	return ( hash != 0 ? hash : 1 );
+}
+
+/// Rename a file, replacing any existing file with the new name.
+///
+/// @param[in] rSourceFileName       Current file name.
+/// @param[in] rDestinationFileName  New file name.
+///
+/// @return  True if the file was renamed, false if not.
+bool Cache::RenameFile( const String& rSourceFileName, const String& rDestinationFileName )
+{
+#if HELIUM_OS_WIN
+	bool bRenamed = ( MoveFileExA(
+		*rSourceFileName, *rDestinationFileName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != FALSE );
+#else
+	bool bRenamed = ( rename( *rSourceFileName, *rDestinationFileName ) == 0 );
+#endif
+
+	if( !bRenamed )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Cache: Failed to rename \"%s\" to \"%s\".\n",
+			*rSourceFileName,
+			*rDestinationFileName );
+	}
+
+	return bRenamed;
+}
+
+/// Delete a file, if it exists.
+///
+/// @param[in] rFileName  File name.
+void Cache::RemoveFile( const String& rFileName )
+{
+#if HELIUM_OS_WIN
+	DeleteFileA( *rFileName );
+#else
+	unlink( *rFileName );
+#endif
+}
+
 /// Read a value from the cache TOC, check the TOC bounds in the process.
 ///
 /// @param[in]  pLoadFunction  Function to use for reading the value.
@@ -792,12 +2802,38 @@ size_t Cache::EntryKeyHash::operator()( const EntryKey& rKey ) const
 }
 
 #if HELIUM_TOOLS
-void Helium::Cache::WriteCacheObjectToBuffer( Reflect::Object* _object, DynamicArray< uint8_t > &_buffer )
+/// Serialize an object for storing in a cache.
+///
+/// Objects whose type declares a cooked layout (see CookedObjectLayout) are written in their cooked binary form,
+/// followed by the generic archive data, which is read back instead if the layout changes.
+///
+/// @param[in]  _object           Object to serialize.
+/// @param[out] _buffer           Serialized object data.
+/// @param[out] pReferencedPaths  If not null, filled with the paths of the assets referenced by the object.
+///
+/// @see ReadCacheObjectFromBuffer()
+void Helium::Cache::WriteCacheObjectToBuffer(
+	Reflect::Object* _object,
+	DynamicArray< uint8_t > &_buffer,
+	DynamicArray< AssetPath >* pReferencedPaths )
 {
-	AssetIdentifier identifier;
+	AssetIdentifier identifier( pReferencedPaths );
+
+	DynamicArray< uint8_t > cookedData;
+	if( !_object || !CookedObjectLayout::WriteObject( _object, cookedData ) )
+	{
+		DynamicMemoryStream archiveStream ( &_buffer );
+		CacheArchiveWriter::WriteToStream( _object, archiveStream, &identifier );
+
+		return;
+	}
 
-	DynamicMemoryStream archiveStream ( &_buffer );
+	DynamicArray< uint8_t > archiveData;
+	DynamicMemoryStream archiveStream ( &archiveData );
 	CacheArchiveWriter::WriteToStream( _object, archiveStream, &identifier );
+
+	_buffer.Swap( cookedData );
+	_buffer.AddArray( archiveData.GetData(), archiveData.GetSize() );
 }
 #endif
 
@@ -812,6 +2848,19 @@ Reflect::ObjectPtr Helium::Cache::ReadCacheObjectFromBuffer( const DynamicArray<
 	return ReadCacheObjectFromBuffer(_buffer.GetData(), 0, _buffer.GetSize(), _resolver);
 }
 
+/// Deserialize an object stored in a cache.
+///
+/// Cooked object data is copied straight into a new object if it was cooked with the current layout of its type.
+/// Otherwise, the object is read from the generic archive data.
+///
+/// @param[in] _buffer    Buffer containing the serialized object data.
+/// @param[in] _offset    Offset of the serialized object data in the buffer.
+/// @param[in] _count     Size of the serialized object data.
+/// @param[in] _resolver  Resolver for object references, or null to use the default resolver.
+///
+/// @return  Deserialized object, or null if the data is empty.
+///
+/// @see WriteCacheObjectToBuffer()
 Reflect::ObjectPtr Helium::Cache::ReadCacheObjectFromBuffer( const uint8_t *_buffer, const size_t _offset, const size_t _count, Reflect::ObjectResolver *_resolver )
 {
 	if (_count == 0)
@@ -820,8 +2869,14 @@ Reflect::ObjectPtr Helium::Cache::ReadCacheObjectFromBuffer( const uint8_t *_buf
 		return null_object;
 	}
 
-	Reflect::ObjectPtr cached_object;
-	StaticMemoryStream archiveStream( (char *)(_buffer + _offset), _count );
+	size_t genericOffset;
+	Reflect::ObjectPtr cached_object = CookedObjectLayout::ReadObject( _buffer + _offset, _count, genericOffset );
+	if( cached_object || genericOffset >= _count )
+	{
+		return cached_object;
+	}
+
+	StaticMemoryStream archiveStream( (char *)(_buffer + _offset + genericOffset), _count - genericOffset );
 	CacheArchiveReader::ReadFromStream( archiveStream, cached_object, _resolver );
 	return cached_object;
 }
\ No newline at end of file
@@ -3,13 +3,38 @@
 #include "Engine/Engine.h"
 #include "Reflect/Translator.h"
 
+#include "Platform/Locks.h"
+
 #include "Foundation/ConcurrentHashMap.h"
+#include "Foundation/HashMap.h"
 #include "Foundation/ObjectPool.h"
 #include "Engine/AssetPath.h"
+#include "Engine/Compression.h"
 #include "Reflect/Object.h"
 
+/// Non-zero to read cache entries through a read-only memory mapping of the cache file instead of copying them through
+/// the AsyncLoader.  Tools builds rewrite caches while running, so they keep reading through copies by default.
+#ifndef HELIUM_CACHE_MAPPING
+#define HELIUM_CACHE_MAPPING ( !HELIUM_TOOLS )
+#endif
+
+/// Non-zero to write a table of entry path strings when rewriting a TOC.  Lookups only use path hashes, but the path
+/// table is needed to enumerate a cache's entries or to modify the cache later on.
+#ifndef HELIUM_CACHE_TOC_PATH_TABLE
+#define HELIUM_CACHE_TOC_PATH_TABLE 1
+#endif
+
+/// Non-zero to freeze the entry lookups of each cache once its TOC is loaded (see Cache::Freeze()).  Tools builds keep
+/// adding entries while running, so they keep looking entries up through the concurrent hash map by default.
+#ifndef HELIUM_CACHE_FREEZE
+#define HELIUM_CACHE_FREEZE ( !HELIUM_TOOLS )
+#endif
+
 namespace Helium
 {
+	class FileStream;
+	class CacheAccessTrace;
+
 	/// Serialization cache interface.
 	class HELIUM_ENGINE_API Cache : NonCopyable
 	{
@@ -19,6 +44,11 @@ namespace Helium
 
 		/// Default Entry pool block size (for use with modifiable caches on the PC).
 		static const size_t ENTRY_POOL_BLOCK_SIZE = 64;
+		/// Minimum number of records appended to the TOC journal before the TOC is compacted.  Past this, the TOC is
+		/// compacted once the journal holds more records than the compacted part of the TOC.
+		static const uint32_t TOC_JOURNAL_COMPACT_MIN = 256;
+		/// Sub-data index of the prefetch manifest cached under each package path (see PrefetchManifest).
+		static const uint32_t PREFETCH_MANIFEST_SUB_DATA_INDEX = 0x7fffffff;
 
 		/// Cache platforms.
 		enum EPlatform
@@ -41,14 +71,39 @@ namespace Helium
 			uint64_t offset;
 			/// Entry timestamp.
 			int64_t timestamp;
+			/// Stable hash of the data as stored in the cache file, or zero if unknown (entries from TOCs older than
+			/// version 4).  Entries storing the same bytes share the same data in the cache file.
+			uint64_t contentHash;
 
 			/// Entry path name.
 			AssetPath path;
 			/// Sub-data index.
 			uint32_t subDataIndex;
 
-			/// Entry size.
+			/// Entry size, as stored in the cache file.
 			uint32_t size;
+			/// Entry size once decompressed (the same as the stored size for uncompressed entries).
+			uint32_t uncompressedSize;
+			/// Codec with which the entry is compressed (CompressionCodec value).
+			uint8_t codec;
+		};
+
+		/// Data for one entry to add or update through CacheEntries().
+		struct EntryUpdate
+		{
+			/// Asset path.
+			AssetPath path;
+			/// Sub-data index.
+			uint32_t subDataIndex;
+			/// Data to cache.
+			const void* pData;
+			/// Timestamp value to associate with the entry.
+			int64_t timestamp;
+			/// Number of bytes to cache.
+			uint32_t size;
+			/// Codec with which to compress the data.  The data is stored uncompressed if compressing it does not make
+			/// it any smaller.
+			CompressionCodec codec;
 		};
 
 		/// @name Construction/Destruction
@@ -80,15 +135,54 @@ namespace Helium
 		inline const String& GetTocFileName() const;
 		inline const String& GetCacheFileName() const;
 
-		inline uint32_t GetEntryCount() const;
-		inline const Entry& GetEntry( uint32_t index ) const;
+		uint32_t GetEntryCount() const;
+		const Entry& GetEntry( uint32_t index ) const;
 		const Entry* FindEntry( AssetPath path, uint32_t subDataIndex ) const;
 
-		bool CacheEntry( AssetPath path, uint32_t subDataIndex, const void* pData, int64_t timestamp, uint32_t size );
+		bool CacheEntry(
+			AssetPath path, uint32_t subDataIndex, const void* pData, int64_t timestamp, uint32_t size,
+			CompressionCodec codec = CompressionCodecs::None );
+		bool CacheEntries( const EntryUpdate* pUpdates, size_t updateCount );
+		//@}
+
+		/// @name Compaction
+		//@{
+		uint64_t GetUnreferencedDataSize();
+		bool Compact( const AssetPath* pLoadOrder = NULL, size_t loadOrderCount = 0 );
+		bool Compact( const CacheAccessTrace& rTrace );
+		//@}
+
+		/// @name Lookup Freezing
+		//@{
+		void Freeze();
+		inline bool IsFrozen() const;
+		//@}
+
+		/// @name Memory Mapping
+		//@{
+		bool MapCacheFile();
+		void UnmapCacheFile();
+		inline bool IsCacheFileMapped() const;
+
+		const uint8_t* GetMappedEntryData( const Entry& rEntry ) const;
+		//@}
+
+		/// @name Memory Usage
+		//@{
+		size_t GetMemoryUsage() const;
+		//@}
+
+		/// @name Static Utility Functions
+		//@{
+		static uint64_t ComputeContentHash( const void* pData, size_t size );
+		static bool RenameFile( const String& rSourceFileName, const String& rDestinationFileName );
+		static void RemoveFile( const String& rFileName );
 		//@}
 
 #if HELIUM_TOOLS
-		static void WriteCacheObjectToBuffer( Helium::Reflect::Object* _object, DynamicArray< uint8_t > &_buffer );
+		static void WriteCacheObjectToBuffer(
+			Helium::Reflect::Object* _object, DynamicArray< uint8_t > &_buffer,
+			DynamicArray< AssetPath >* pReferencedPaths = NULL );
 #endif
 		static Reflect::ObjectPtr ReadCacheObjectFromBuffer( const DynamicArray< uint8_t > &_buffer, Reflect::ObjectResolver *pResolver = 0 );
 		static Reflect::ObjectPtr ReadCacheObjectFromBuffer( const uint8_t *_buffer, const size_t _offset, const size_t _count, Reflect::ObjectResolver *pResolver = 0 );
@@ -124,6 +218,47 @@ namespace Helium
 		/// Cache entry hash map type.
 		typedef ConcurrentHashMap< EntryKey, Entry*, EntryKeyHash > EntryMapType;
 
+		/// Number of slots in each group of the frozen entry table, whose tags are all compared at once.
+		static const size_t FROZEN_GROUP_SIZE = 16;
+
+		/// Fixed-size entry record in a hashed TOC.  Records are sorted by path hash, then sub-data index, so they
+		/// can be binary searched in place.
+		struct TocRecord
+		{
+			/// Stable hash of the entry path (see AssetPath::GetStableHash()).
+			uint64_t pathHash;
+			/// Entry offset.
+			uint64_t offset;
+			/// Entry timestamp.
+			int64_t timestamp;
+			/// Stable hash of the data as stored in the cache file.
+			uint64_t contentHash;
+			/// Sub-data index.
+			uint32_t subDataIndex;
+			/// Entry size, as stored in the cache file.
+			uint32_t size;
+			/// Entry size once decompressed.
+			uint32_t uncompressedSize;
+			/// Codec with which the entry is compressed (CompressionCodec value).
+			uint32_t codec;
+		};
+
+		/// Range of the cache file holding the stored data of one or more entries.
+		struct Extent
+		{
+			/// Stable hash of the stored data (zero if unknown).
+			uint64_t contentHash;
+			/// Size of the stored data, in bytes.
+			uint32_t size;
+			/// Number of entries referencing the data.
+			uint32_t referenceCount;
+		};
+
+		/// Extent map type, keyed by cache file offset.
+		typedef HashMap< uint64_t, Extent > ExtentMapType;
+		/// Content map type, from stored data hash to the offset of an extent with that hash.
+		typedef HashMap< uint64_t, uint64_t > ContentMapType;
+
 		/// Cache name.
 		Name m_name;
 		/// Cache platform.
@@ -147,14 +282,101 @@ namespace Helium
 
 		/// Cache entry pool.
 		ObjectPool< Entry >* m_pEntryPool;
-		/// Cache entry information.
-		DynamicArray< Entry* > m_entries;
+		/// Cache entry information.  Entries for hashed TOC records are only added once they are first needed.
+		mutable DynamicArray< Entry* > m_entries;
 		/// Entry lookup hash map.
-		EntryMapType m_entryMap;
+		mutable EntryMapType m_entryMap;
+
+		/// Entry records of a hashed TOC, read in place from the TOC buffer, or null if the TOC has none.
+		const TocRecord* m_pTocRecords;
+		/// Records converted from an older TOC format, or null if the records are used in place.
+		TocRecord* m_pConvertedTocRecords;
+		/// Number of hashed TOC records.
+		uint32_t m_tocRecordCount;
+		/// Start of the hashed TOC path table, or null if the TOC has no path table.
+		const uint8_t* m_pTocPathTable;
+		/// End of the hashed TOC path table.
+		const uint8_t* m_pTocPathTableEnd;
+		/// True if the hashed TOC was byte swapped (its records have been swapped in place, its path table has not).
+		bool m_bTocByteSwapped;
+		/// True once entries have been added for every hashed TOC record.
+		mutable bool m_bTocExpanded;
+		/// Lock for adding entries for hashed TOC records.
+		mutable Mutex m_entryLock;
+
+		/// Tag of each frozen entry table slot (zero for empty slots), or null if entry lookups are not frozen.
+		uint8_t* m_pFrozenTags;
+		/// Entry in each frozen entry table slot.
+		Entry** m_ppFrozenEntries;
+		/// Number of groups in the frozen entry table less one (the group count is always a power of two).
+		size_t m_frozenGroupMask;
+		/// Number of entries added to the entry map since lookups were frozen.
+		mutable volatile int32_t m_overflowEntryCount;
+
+		/// Size of the cache file, in bytes, or invalid if it has not been checked since initialization.
+		uint64_t m_cacheFileSize;
+		/// Number of entry records in the compacted part of the TOC file, ahead of the journal.
+		uint32_t m_tocCompactedCount;
+		/// Number of entry records appended to the TOC file journal since it was last compacted.
+		uint32_t m_tocJournalCount;
+		/// True if entry records can be appended to the TOC file as it is on disk.
+		bool m_bTocAppendable;
+		/// Entries written by the current CacheEntries() call.
+		DynamicArray< Entry* > m_updatedEntries;
+		/// Scratch buffer for compressing entry data.
+		DynamicArray< uint8_t > m_compressedData;
+
+		/// Extents referenced by the entries, built when the cache is first written to.
+		ExtentMapType m_extentMap;
+		/// Extent lookup by stored data hash, for sharing the data of entries storing the same bytes.
+		ContentMapType m_contentMap;
+		/// True once the extent references of all entries have been counted.
+		bool m_bExtentsBuilt;
+		/// Cache file stream for comparing data with that of existing extents (only open during CacheEntries()).
+		FileStream* m_pCacheReadStream;
+		/// Scratch buffer for comparing data with that of existing extents.
+		DynamicArray< uint8_t > m_compareData;
+
+		/// Read-only view of the cache file, or null if it is not mapped.
+		const uint8_t* m_pMappedData;
+		/// Size of the mapped cache file view, in bytes.
+		uint64_t m_mappedSize;
+
+		/// MemoryTelemetry tracker sampling the memory usage of this cache, or invalid if not initialized.
+		uint32_t m_memoryTracker;
+
+		/// @name Memory Telemetry Callbacks
+		//@{
+		static size_t SampleMemoryUsage( void* pCache );
+		//@}
 
 		/// @name Loading Utility Functions
 		//@{
 		bool FinalizeTocLoad();
+		bool ReadTocRecord(
+			LOAD_VALUE_CALLBACK* pLoadFunction, uint32_t version, const uint8_t*& rpTocCurrent, const uint8_t* pTocMax,
+			EntryKey& rKey, Entry& rEntry );
+
+		const TocRecord* FindTocRecord( uint64_t pathHash, uint32_t subDataIndex ) const;
+		Entry* AddTocRecordEntry( const TocRecord& rRecord, AssetPath path ) const;
+		bool ExpandToc() const;
+
+		const Entry* FindFrozenEntry( const EntryKey& rKey ) const;
+		void ReleaseFrozenEntries();
+		//@}
+
+		/// @name Saving Utility Functions
+		//@{
+		Entry* WriteEntryData( FileStream* pCacheStream, const EntryUpdate& rUpdate );
+		bool WriteToc( bool bRewrite = false, const char* pTocFileName = NULL );
+
+		void BuildExtents();
+		uint64_t FindSharedExtent( const void* pData, uint32_t size, uint64_t contentHash );
+		uint32_t GetExtentReferenceCount( uint64_t offset ) const;
+		void AddExtentReference( uint64_t offset, uint32_t size, uint64_t contentHash );
+		void ReleaseExtentReference( uint64_t offset );
+
+		bool CompactEntries( const DynamicArray< size_t >& rLoadIndices );
 		//@}
 
 		/// @name Private Static Utility Functions
@@ -162,6 +384,10 @@ namespace Helium
 		template< typename T > static bool CheckedTocRead(
 			LOAD_VALUE_CALLBACK* pLoadFunction, T& rValue, const char* pDescription, const uint8_t*& rpTocCurrent,
 			const uint8_t* pTocMax );
+		static bool ReadTocPath(
+			LOAD_VALUE_CALLBACK* pLoadFunction, const uint8_t*& rpTocCurrent, const uint8_t* pTocMax,
+			AssetPath& rPath, uint64_t stableHash = 0 );
+		static uint64_t ComputeFrozenHash( const EntryKey& rKey );
 		//@}
 	};
 }
@@ -8,6 +8,26 @@ bool Helium::Cache::IsTocLoaded() const
     return m_bTocLoaded;
 }
 
+/// Get whether the cache file is currently memory mapped.
+///
+/// @return  True if entry data can be accessed through GetMappedEntryData(), false if not.
+///
+/// @see MapCacheFile(), UnmapCacheFile()
+bool Helium::Cache::IsCacheFileMapped() const
+{
+    return ( m_pMappedData != NULL );
+}
+
+/// Get whether entry lookups have been frozen.
+///
+/// @return  True if FindEntry() searches a frozen entry table first, false if not.
+///
+/// @see Freeze()
+bool Helium::Cache::IsFrozen() const
+{
+    return ( m_pFrozenTags != NULL );
+}
+
 /// Get the name used to identify this cache.
 ///
 /// @return  Cache name.
@@ -43,33 +63,3 @@ const Helium::String& Helium::Cache::GetCacheFileName() const
 {
     return m_cacheFileName;
 }
-
-/// Get the number of object entries in this cache.
-///
-/// @return  Asset entry count.
-///
-/// @see GetEntry()
-uint32_t Helium::Cache::GetEntryCount() const
-{
-    size_t entryCount = m_entries.GetSize();
-    HELIUM_ASSERT( entryCount <= UINT32_MAX );
-
-    return static_cast< uint32_t >( entryCount );
-}
-
-/// Get the information for the cache entry with the specified index.
-///
-/// @param[in] index  Asset entry index.
-///
-/// @return  Asset entry information.
-///
-/// @see GetEntryCount()
-const Helium::Cache::Entry& Helium::Cache::GetEntry( uint32_t index ) const
-{
-    HELIUM_ASSERT( index < m_entries.GetSize() );
-
-    Entry* pEntry = m_entries[ index ];
-    HELIUM_ASSERT( pEntry );
-
-    return *pEntry;
-}
@@ -0,0 +1,378 @@
+#include "Precompile.h"
+#include "Engine/CacheAccessTrace.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
+#include "Foundation/BufferedStream.h"
+#include "Foundation/FileStream.h"
+#include "Foundation/Stream.h"
+#include "Engine/FileLocations.h"
+
+using namespace Helium;
+
+volatile int32_t CacheAccessTrace::sm_recording = 0;
+
+namespace
+{
+	/// Trace being recorded.
+	CacheAccessTrace s_recordedTrace;
+	/// Lock for the trace being recorded.
+	Mutex s_traceLock;
+
+	/// Read a value from a trace buffer, advancing the read position.
+	///
+	/// @param[out]    rValue     Value read.
+	/// @param[in,out] rpCurrent  Current read position.
+	/// @param[in]     pEnd       End of the trace buffer.
+	///
+	/// @return  True if the value was read, false if the end of the buffer was reached.
+	template< typename T >
+	bool ReadTraceValue( T& rValue, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+	{
+		if( static_cast< size_t >( pEnd - rpCurrent ) < sizeof( T ) )
+		{
+			return false;
+		}
+
+		MemoryCopy( &rValue, rpCurrent, sizeof( T ) );
+		rpCurrent += sizeof( T );
+
+		return true;
+	}
+
+	/// Read a length-prefixed string from a trace buffer, advancing the read position.
+	///
+	/// @param[out]    rString    String read.
+	/// @param[in,out] rpCurrent  Current read position.
+	/// @param[in]     pEnd       End of the trace buffer.
+	///
+	/// @return  True if the string was read, false if the end of the buffer was reached.
+	bool ReadTraceString( String& rString, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+	{
+		uint32_t length = 0;
+		if( !ReadTraceValue( length, rpCurrent, pEnd ) || length > static_cast< size_t >( pEnd - rpCurrent ) )
+		{
+			return false;
+		}
+
+		rString = String( reinterpret_cast< const char* >( rpCurrent ), length );
+		rpCurrent += length;
+
+		return true;
+	}
+
+	/// Write a length-prefixed string to a trace stream.
+	///
+	/// @param[in] rStream  Stream to write to.
+	/// @param[in] rString  String to write.
+	void WriteTraceString( Stream& rStream, const String& rString )
+	{
+		uint32_t length = static_cast< uint32_t >( rString.GetSize() );
+		rStream.Write( &length, sizeof( length ), 1 );
+		rStream.Write( rString.GetData(), sizeof( char ), length );
+	}
+}
+
+/// Remove all records from this trace.
+void CacheAccessTrace::Clear()
+{
+	m_records.Clear();
+	m_recordedSubData.Clear();
+}
+
+/// Add an access record to the end of this trace, unless the entry has already been recorded.
+///
+/// Entries are identified by path and sub-data index only, as the same entry is never stored in more than one cache.
+///
+/// @param[in] cacheName     Name of the cache read from.
+/// @param[in] path          Asset path.
+/// @param[in] subDataIndex  Sub-data index.
+///
+/// @return  True if the record was added, false if the entry is already in this trace.
+bool CacheAccessTrace::AddRecord( Name cacheName, AssetPath path, uint32_t subDataIndex )
+{
+	HashMap< AssetPath, DynamicArray< uint32_t > >::Iterator subDataIterator = m_recordedSubData.Find( path );
+	if( subDataIterator == m_recordedSubData.End() )
+	{
+		HELIUM_VERIFY( m_recordedSubData.Insert(
+			subDataIterator,
+			HashMap< AssetPath, DynamicArray< uint32_t > >::ValueType( path, DynamicArray< uint32_t >() ) ) );
+	}
+
+	DynamicArray< uint32_t >& rSubData = subDataIterator->Second();
+
+	size_t subDataCount = rSubData.GetSize();
+	for( size_t subDataIndexIndex = 0; subDataIndexIndex < subDataCount; ++subDataIndexIndex )
+	{
+		if( rSubData[ subDataIndexIndex ] == subDataIndex )
+		{
+			return false;
+		}
+	}
+
+	rSubData.Push( subDataIndex );
+
+	Record* pRecord = m_records.New();
+	HELIUM_ASSERT( pRecord );
+	pRecord->cacheName = cacheName;
+	pRecord->path = path;
+	pRecord->subDataIndex = subDataIndex;
+
+	return true;
+}
+
+/// Add the records of another trace to the end of this trace, skipping entries already in this trace.
+///
+/// @param[in] rTrace  Trace to append.
+void CacheAccessTrace::Append( const CacheAccessTrace& rTrace )
+{
+	size_t recordCount = rTrace.m_records.GetSize();
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		const Record& rRecord = rTrace.m_records[ recordIndex ];
+		AddRecord( rRecord.cacheName, rRecord.path, rRecord.subDataIndex );
+	}
+}
+
+/// Write this trace to a stream.
+///
+/// @param[in] rStream  Stream to write to.
+///
+/// @see Read()
+void CacheAccessTrace::Write( Stream& rStream ) const
+{
+	uint32_t version = VERSION;
+	rStream.Write( &version, sizeof( version ), 1 );
+
+	HELIUM_ASSERT( m_records.GetSize() <= UINT32_MAX );
+	uint32_t recordCount = static_cast< uint32_t >( m_records.GetSize() );
+	rStream.Write( &recordCount, sizeof( recordCount ), 1 );
+
+	for( uint32_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		const Record& rRecord = m_records[ recordIndex ];
+
+		WriteTraceString( rStream, String( *rRecord.cacheName ) );
+		WriteTraceString( rStream, rRecord.path.ToString() );
+		rStream.Write( &rRecord.subDataIndex, sizeof( rRecord.subDataIndex ), 1 );
+	}
+}
+
+/// Replace the contents of this trace with those read from a buffer.
+///
+/// @param[in] pData  Trace data.
+/// @param[in] size   Size of the trace data, in bytes.
+///
+/// @return  True if the trace was read successfully, false if it is invalid (in which case this trace is left empty).
+///
+/// @see Write()
+bool CacheAccessTrace::Read( const uint8_t* pData, size_t size )
+{
+	HELIUM_ASSERT( pData || size == 0 );
+
+	Clear();
+
+	const uint8_t* pCurrent = pData;
+	const uint8_t* pEnd = pData + size;
+
+	uint32_t version = 0;
+	if( !ReadTraceValue( version, pCurrent, pEnd ) || version != VERSION )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"CacheAccessTrace::Read(): Trace version %" PRIu32 " does not match the current version (%" PRIu32 ").\n",
+			version,
+			VERSION );
+
+		return false;
+	}
+
+	uint32_t recordCount = 0;
+	if( !ReadTraceValue( recordCount, pCurrent, pEnd ) )
+	{
+		return false;
+	}
+
+	String cacheNameString;
+	String pathString;
+	for( uint32_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		AssetPath path;
+		uint32_t subDataIndex = 0;
+		bool bValid =
+			ReadTraceString( cacheNameString, pCurrent, pEnd ) &&
+			ReadTraceString( pathString, pCurrent, pEnd ) &&
+			path.Set( pathString ) &&
+			ReadTraceValue( subDataIndex, pCurrent, pEnd );
+		if( !bValid )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "CacheAccessTrace::Read(): Trace is truncated.\n" );
+
+			Clear();
+
+			return false;
+		}
+
+		AddRecord( Name( cacheNameString ), path, subDataIndex );
+	}
+
+	return true;
+}
+
+/// Replace the contents of this trace with those of a trace file.
+///
+/// @param[in] rPath  Trace file path.
+///
+/// @return  True if the trace file was read successfully, false if it does not exist or is invalid (in which case
+///          this trace is left empty).
+///
+/// @see SaveToFile()
+bool CacheAccessTrace::LoadFromFile( const FilePath& rPath )
+{
+	Clear();
+
+	if( !rPath.Exists() )
+	{
+		return false;
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"CacheAccessTrace::LoadFromFile(): Failed to open \"%s\" for reading.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	int64_t size64 = pFileStream->GetSize();
+	if( size64 < 0 || static_cast< uint64_t >( size64 ) > static_cast< size_t >( -1 ) )
+	{
+		delete pFileStream;
+
+		return false;
+	}
+
+	DynamicArray< uint8_t > data;
+	data.Resize( static_cast< size_t >( size64 ) );
+	size_t bytesRead = pFileStream->Read( data.GetData(), 1, data.GetSize() );
+
+	delete pFileStream;
+
+	if( bytesRead != data.GetSize() )
+	{
+		return false;
+	}
+
+	return Read( data.GetData(), data.GetSize() );
+}
+
+/// Write this trace to a file.
+///
+/// @param[in] rPath  Trace file path.
+///
+/// @return  True if the trace was written successfully, false if not.
+///
+/// @see LoadFromFile()
+bool CacheAccessTrace::SaveToFile( const FilePath& rPath ) const
+{
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"CacheAccessTrace::SaveToFile(): Failed to open \"%s\" for writing.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+		Write( bufferedStream );
+	}
+
+	delete pFileStream;
+
+	return true;
+}
+
+/// Get the path of the trace file of a scene.
+///
+/// Traces are kept in the "CacheAccessTraces" directory of the user data directory, named after the stable hash of
+/// the scene path.  The directory is created if it does not exist.
+///
+/// @param[in]  scenePath  Scene definition path.
+/// @param[out] rPath      Trace file path.
+///
+/// @return  True if the path was determined, false if no user data directory is available.
+bool CacheAccessTrace::GetTraceFilePath( AssetPath scenePath, FilePath& rPath )
+{
+	FilePath userDirectory;
+	if( !FileLocations::GetUserDirectory( userDirectory ) )
+	{
+		return false;
+	}
+
+	FilePath traceDirectory( userDirectory.Get() + "CacheAccessTraces/" );
+	traceDirectory.MakePath();
+
+	char fileName[ 32 ];
+	StringPrint( fileName, "%016" PRIx64 ".trace", scenePath.GetStableHash() );
+	fileName[ HELIUM_ARRAY_COUNT( fileName ) - 1 ] = '\0';
+
+	rPath = FilePath( traceDirectory.Get() + fileName );
+
+	return true;
+}
+
+/// Start recording cache accesses, discarding any accesses recorded previously.
+///
+/// @see EndRecording(), IsRecording()
+void CacheAccessTrace::BeginRecording()
+{
+	MutexScopeLock scopeLock( s_traceLock );
+
+	s_recordedTrace.Clear();
+	AtomicExchangeRelease( sm_recording, 1 );
+}
+
+/// Stop recording cache accesses.
+///
+/// @param[out] rTrace  Set to the cache accesses recorded since BeginRecording().
+///
+/// @see BeginRecording(), IsRecording()
+void CacheAccessTrace::EndRecording( CacheAccessTrace& rTrace )
+{
+	MutexScopeLock scopeLock( s_traceLock );
+
+	AtomicExchangeRelease( sm_recording, 0 );
+
+	rTrace.Clear();
+	rTrace.Append( s_recordedTrace );
+	s_recordedTrace.Clear();
+}
+
+/// Record a read of a cache entry.
+///
+/// This does nothing if recording is disabled.
+///
+/// @param[in] cacheName     Name of the cache read from.
+/// @param[in] path          Asset path.
+/// @param[in] subDataIndex  Sub-data index.
+void CacheAccessTrace::RecordAccess( Name cacheName, AssetPath path, uint32_t subDataIndex )
+{
+	if( !IsRecording() )
+	{
+		return;
+	}
+
+	MutexScopeLock scopeLock( s_traceLock );
+
+	if( IsRecording() )
+	{
+		s_recordedTrace.AddRecord( cacheName, path, subDataIndex );
+	}
+}
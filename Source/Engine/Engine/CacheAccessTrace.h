@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/HashMap.h"
+#include "Foundation/Name.h"
+#include "Engine/AssetPath.h"
+
+namespace Helium
+{
+	class Stream;
+
+	/// Order in which cache entries were first read while loading a scene.
+	///
+	/// While recording is enabled (see BeginRecording()), the package loaders and resources record the cache, path, and
+	/// sub-data index of every cache entry they read.  Only the first read of each entry is kept.  Traces are saved per
+	/// scene in the user data directory (see GetTraceFilePath()), and the cook uses them to lay out the cache files in
+	/// the order in which their entries are read (see Cache::Compact()), so that scene loads read each cache
+	/// sequentially instead of seeking all over it.
+	///
+	/// Recording takes a lock, so it is only meant to be enabled while capturing traces.
+	class HELIUM_ENGINE_API CacheAccessTrace
+	{
+	public:
+		/// Trace file format version.
+		static const uint32_t VERSION = 1;
+
+		/// Cache entry access record.
+		struct Record
+		{
+			/// Name of the cache read from.
+			Name cacheName;
+			/// Asset path.
+			AssetPath path;
+			/// Sub-data index.
+			uint32_t subDataIndex;
+		};
+
+		/// @name Record Access
+		//@{
+		void Clear();
+		bool AddRecord( Name cacheName, AssetPath path, uint32_t subDataIndex );
+		void Append( const CacheAccessTrace& rTrace );
+
+		inline size_t GetRecordCount() const;
+		inline const Record& GetRecord( size_t index ) const;
+		//@}
+
+		/// @name Serialization
+		//@{
+		void Write( Stream& rStream ) const;
+		bool Read( const uint8_t* pData, size_t size );
+
+		bool LoadFromFile( const FilePath& rPath );
+		bool SaveToFile( const FilePath& rPath ) const;
+
+		static bool GetTraceFilePath( AssetPath scenePath, FilePath& rPath );
+		//@}
+
+		/// @name Recording
+		//@{
+		static void BeginRecording();
+		static void EndRecording( CacheAccessTrace& rTrace );
+		inline static bool IsRecording();
+
+		static void RecordAccess( Name cacheName, AssetPath path, uint32_t subDataIndex );
+		//@}
+
+	private:
+		/// Access records, in the order in which each entry was first read.
+		DynamicArray< Record > m_records;
+		/// Sub-data indices recorded for each path, to skip repeated reads of the same entry.
+		HashMap< AssetPath, DynamicArray< uint32_t > > m_recordedSubData;
+
+		/// Non-zero while cache accesses are recorded.
+		static volatile int32_t sm_recording;
+	};
+}
+
+#include "Engine/CacheAccessTrace.inl"
@@ -0,0 +1,36 @@
+namespace Helium
+{
+	/// Get the number of access records in this trace.
+	///
+	/// @return  Record count.
+	///
+	/// @see GetRecord()
+	size_t CacheAccessTrace::GetRecordCount() const
+	{
+		return m_records.GetSize();
+	}
+
+	/// Get the access record with the given index.
+	///
+	/// @param[in] index  Record index.
+	///
+	/// @return  Access record.
+	///
+	/// @see GetRecordCount()
+	const CacheAccessTrace::Record& CacheAccessTrace::GetRecord( size_t index ) const
+	{
+		HELIUM_ASSERT( index < m_records.GetSize() );
+
+		return m_records[ index ];
+	}
+
+	/// Get whether cache accesses are currently being recorded.
+	///
+	/// @return  True if recording, false if not.
+	///
+	/// @see BeginRecording(), EndRecording()
+	bool CacheAccessTrace::IsRecording()
+	{
+		return sm_recording != 0;
+	}
+}
@@ -4,16 +4,34 @@
 #include "Engine/Asset.h"
 #include "Engine/AssetLoader.h"
 #include "Engine/AsyncLoader.h"
+#include "Engine/AssetLoadTrace.h"
+#include "Engine/CacheAccessTrace.h"
+#include "Engine/LoadStatistics.h"
+#include "Platform/Timer.h"
 #include "Engine/CacheManager.h"
 #include "Engine/Resource.h"
 
+#include <algorithm>
+
 using namespace Helium;
 
+/// Order cache entries by their offset in the cache file.
+///
+/// @param[in] pEntry0  First entry.
+/// @param[in] pEntry1  Second entry.
+///
+/// @return  True if the first entry comes before the second in the cache file, false if not.
+static bool EntryOffsetLess( const Cache::Entry* pEntry0, const Cache::Entry* pEntry1 )
+{
+	return ( pEntry0->offset < pEntry1->offset );
+}
+
 /// Constructor.
 CachePackageLoader::CachePackageLoader()
 : m_pCache( NULL )
 , m_bFinishedCacheTocLoad( false )
 , m_loadRequestPool( LOAD_REQUEST_POOL_BLOCK_SIZE )
+, m_completedPrefetchCount( 0 )
 {
 }
 
@@ -84,6 +102,36 @@ void CachePackageLoader::Shutdown()
 
 	m_loadRequests.Clear();
 
+	size_t prefetchedEntryCount = m_prefetchedEntries.GetSize();
+	for( size_t prefetchedEntryIndex = 0; prefetchedEntryIndex < prefetchedEntryCount; ++prefetchedEntryIndex )
+	{
+		PrefetchedEntry& rPrefetchedEntry = m_prefetchedEntries[ prefetchedEntryIndex ];
+		if( IsValid( rPrefetchedEntry.asyncLoadId ) )
+		{
+			pAsyncLoader->SyncRequest( rPrefetchedEntry.asyncLoadId );
+		}
+
+		allocator.Free( rPrefetchedEntry.pBuffer );
+	}
+
+	m_prefetchedEntries.Clear();
+
+	size_t packageManifestCount = m_packageManifests.GetSize();
+	for( size_t packageManifestIndex = 0; packageManifestIndex < packageManifestCount; ++packageManifestIndex )
+	{
+		PackageManifest* pManifest = m_packageManifests[ packageManifestIndex ];
+		HELIUM_ASSERT( pManifest );
+		if( IsValid( pManifest->asyncLoadId ) )
+		{
+			pAsyncLoader->SyncRequest( pManifest->asyncLoadId );
+		}
+
+		allocator.Free( pManifest->pAsyncLoadBuffer );
+		delete pManifest;
+	}
+
+	m_packageManifests.Clear();
+
 	m_pCache = NULL;
 	m_bFinishedCacheTocLoad = false;
 }
@@ -149,6 +197,7 @@ size_t CachePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 
 		SetInvalid( pRequest->asyncLoadId );
 		pRequest->pAsyncLoadBuffer = NULL;
+		pRequest->asyncLoadStartTicks = 0;
 		pRequest->pPropertyDataBegin = NULL;
 		pRequest->pPropertyDataEnd = NULL;
 		pRequest->pPersistentResourceDataBegin = NULL;
@@ -172,9 +221,15 @@ size_t CachePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 			"CachePackageLoader::BeginLoadObject(): \"%s\" is not cached in this package.  No load request added.\n",
 			*path.ToString() );
 
+		LoadStatistics::AddCount( LoadStatistics::COUNTER_CACHE_MISSES );
+
 		return Invalid< size_t >();
 	}
 
+	LoadStatistics::AddCount( LoadStatistics::COUNTER_CACHE_HITS );
+
+	CacheAccessTrace::RecordAccess( m_pCache->GetName(), path, 0 );
+
 #ifndef NDEBUG
 	size_t loadRequestSize = m_loadRequests.GetSize();
 	for( size_t loadRequestIndex = 0; loadRequestIndex < loadRequestSize; ++loadRequestIndex )
@@ -206,6 +261,8 @@ size_t CachePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 	HELIUM_ASSERT( !pRequest->spObject );
 	SetInvalid( pRequest->asyncLoadId );
 	pRequest->pAsyncLoadBuffer = NULL;
+	pRequest->asyncLoadStartTicks = 0;
+	pRequest->pCacheData = NULL;
 	pRequest->pPropertyDataBegin = NULL;
 	pRequest->pPropertyDataEnd = NULL;
 	pRequest->pPersistentResourceDataBegin = NULL;
@@ -234,24 +291,60 @@ size_t CachePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 	{
 		HELIUM_ASSERT( !pObject || !pObject->GetAnyFlagSet( Asset::FLAG_LOADED | Asset::FLAG_LINKED ) );
 
-		HELIUM_TRACE(
-			TraceLevels::Debug,
-			"CachePackageLoader::BeginLoadObject(): Issuing async load of property data for \"%s\".\n",
-			*path.ToString() );
+		// Read the entry along with everything it depends on if its package has a prefetch manifest.
+		PrefetchDependencies( pEntry );
 
-		size_t entrySize = pEntry->size;
-		pRequest->pAsyncLoadBuffer = static_cast< uint8_t* >( DefaultAllocator().Allocate( entrySize ) );
-		HELIUM_ASSERT( pRequest->pAsyncLoadBuffer );
+		// Read the entry in place if the cache file is mapped (and the entry is not compressed), otherwise copy it into a
+		// buffer of our own.
+		CompressionCodec codec = static_cast< CompressionCodec >( pEntry->codec );
+		if( codec == CompressionCodecs::None )
+		{
+			pRequest->pCacheData = m_pCache->GetMappedEntryData( *pEntry );
+		}
 
-		AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
-		HELIUM_ASSERT( pAsyncLoader );
+		if( pRequest->pCacheData )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Debug,
+				"CachePackageLoader::BeginLoadObject(): Reading property data for \"%s\" from the mapped cache.\n",
+				*path.ToString() );
+		}
+		else if( TakePrefetchedEntry( pRequest ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Debug,
+				"CachePackageLoader::BeginLoadObject(): Using prefetched property data for \"%s\".\n",
+				*path.ToString() );
+		}
+		else
+		{
+			HELIUM_TRACE(
+				TraceLevels::Debug,
+				"CachePackageLoader::BeginLoadObject(): Issuing async load of property data for \"%s\".\n",
+				*path.ToString() );
+
+			size_t entrySize = pEntry->uncompressedSize;
+			pRequest->pAsyncLoadBuffer = static_cast< uint8_t* >( DefaultAllocator().Allocate( entrySize ) );
+			HELIUM_ASSERT( pRequest->pAsyncLoadBuffer );
 
-		pRequest->asyncLoadId = pAsyncLoader->QueueRequest(
-			pRequest->pAsyncLoadBuffer,
-			m_pCache->GetCacheFileName(),
-			pEntry->offset,
-			entrySize );
-		HELIUM_ASSERT( IsValid( pRequest->asyncLoadId ) );
+			AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+			HELIUM_ASSERT( pAsyncLoader );
+
+			if( AssetLoadTrace::IsEnabled() )
+			{
+				pRequest->asyncLoadStartTicks = Timer::GetTickCount();
+			}
+
+			pRequest->asyncLoadId = pAsyncLoader->QueueRequest(
+				pRequest->pAsyncLoadBuffer,
+				m_pCache->GetCacheFileName(),
+				pEntry->offset,
+				pEntry->size,
+				AsyncLoader::PRIORITY_NORMAL,
+				codec,
+				entrySize );
+			HELIUM_ASSERT( IsValid( pRequest->asyncLoadId ) );
+		}
 	}
 
 	size_t requestId = m_loadRequests.Add( pRequest );
@@ -333,7 +426,12 @@ bool CachePackageLoader::TryFinishLoadObject( size_t requestId, AssetPtr& rspObj
 /// Update this package loader.
 void CachePackageLoader::Tick()
 {
-	// Process pending load requests.
+	TickPrefetching();
+
+	// Process pending load requests, gathering those ready to deserialize so that they can be deserialized in
+	// parallel once the rest have been updated.
+	HELIUM_ASSERT( m_deserializeRequests.IsEmpty() );
+
 	size_t loadRequestSize = m_loadRequests.GetSize();
 	for( size_t loadRequestIndex = 0; loadRequestIndex < loadRequestSize; ++loadRequestIndex )
 	{
@@ -347,7 +445,8 @@ void CachePackageLoader::Tick()
 
 		if( !( pRequest->flags & LOAD_FLAG_PRELOADED ) )
 		{
-			if( IsValid( pRequest->asyncLoadId ) )
+			// Property data pointers are set once the cache data has been read.
+			if( !pRequest->pPropertyDataEnd )
 			{
 				if( !TickCacheLoad( pRequest ) )
 				{
@@ -358,16 +457,30 @@ void CachePackageLoader::Tick()
 			// Preloaded flag may be set if the cache load step failed.
 			if( !( pRequest->flags & LOAD_FLAG_PRELOADED ) )
 			{
-				if( !TickDeserialize( pRequest ) )
+				if( !TickOwnerLoad( pRequest ) )
 				{
 					continue;
 				}
 			}
+
+			// ...or if the owner failed to load.
+			if( !( pRequest->flags & LOAD_FLAG_PRELOADED ) )
+			{
+				m_deserializeRequests.Push( pRequest );
+
+				continue;
+			}
 		}
 
 		HELIUM_ASSERT( IsInvalid( pRequest->asyncLoadId ) );
 		HELIUM_ASSERT( pRequest->pAsyncLoadBuffer == NULL );
 	}
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+	pAssetLoader->RunParallel( DeserializeCallback, this, m_deserializeRequests.GetSize() );
+
+	m_deserializeRequests.Resize( 0 );
 }
 
 /// @copydoc PackageLoader::GetObjectCount()
@@ -399,16 +512,37 @@ bool CachePackageLoader::TickCacheLoad( LoadRequest* pRequest )
 	HELIUM_ASSERT( pRequest );
 	HELIUM_ASSERT( !( pRequest->flags & LOAD_FLAG_PRELOADED ) );
 
-	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
-	HELIUM_ASSERT( pAsyncLoader );
-
 	size_t bytesRead = 0;
-	if( !pAsyncLoader->TrySyncRequest( pRequest->asyncLoadId, bytesRead ) )
+	if( pRequest->pCacheData )
 	{
-		return false;
+		// Entry is read in place from the mapped cache file or was prefetched, so there is nothing to wait on.
+		HELIUM_ASSERT( IsInvalid( pRequest->asyncLoadId ) );
+		HELIUM_ASSERT( pRequest->pEntry );
+		bytesRead = pRequest->pEntry->uncompressedSize;
 	}
+	else
+	{
+		AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+		HELIUM_ASSERT( pAsyncLoader );
 
-	SetInvalid( pRequest->asyncLoadId );
+		if( !pAsyncLoader->TrySyncRequest( pRequest->asyncLoadId, bytesRead ) )
+		{
+			return false;
+		}
+
+		SetInvalid( pRequest->asyncLoadId );
+		pRequest->pCacheData = pRequest->pAsyncLoadBuffer;
+
+		if( pRequest->asyncLoadStartTicks != 0 )
+		{
+			HELIUM_ASSERT( pRequest->pEntry );
+			AssetLoadTrace::RecordStage(
+				AssetLoadTrace::STAGE_IO_WAIT,
+				pRequest->pEntry->path,
+				pRequest->asyncLoadStartTicks,
+				Timer::GetTickCount() );
+		}
+	}
 
 	if( bytesRead == 0 || IsInvalid( bytesRead ) )
 	{
@@ -421,7 +555,7 @@ bool CachePackageLoader::TickCacheLoad( LoadRequest* pRequest )
 	}
 	else
 	{
-		uint8_t* pBufferEnd = pRequest->pAsyncLoadBuffer + bytesRead;
+		const uint8_t* pBufferEnd = pRequest->pCacheData + bytesRead;
 		pRequest->pPropertyDataEnd = pBufferEnd;
 		pRequest->pPersistentResourceDataEnd = pBufferEnd;
 
@@ -435,6 +569,7 @@ bool CachePackageLoader::TickCacheLoad( LoadRequest* pRequest )
 	// else will be done with the object itself from here on out).
 	DefaultAllocator().Free( pRequest->pAsyncLoadBuffer );
 	pRequest->pAsyncLoadBuffer = NULL;
+	pRequest->pCacheData = NULL;
 
 	Asset* pObject = pRequest->spObject;
 	if( pObject )
@@ -448,18 +583,17 @@ bool CachePackageLoader::TickCacheLoad( LoadRequest* pRequest )
 	return true;
 }
 
-/// Tick the object deserialization process for the given object load request.
+/// Tick the loading of the owner object for the given object load request.
 ///
 /// @param[in] pRequest  Load request.
 ///
-/// @return  True if the deserialization process has completed, false if it still needs time to process.
-bool CachePackageLoader::TickDeserialize( LoadRequest* pRequest )
+/// @return  True if the owner has finished loading (the request is marked as preloaded with an error if the owner
+///          failed to load), false if it is still loading.
+bool CachePackageLoader::TickOwnerLoad( LoadRequest* pRequest )
 {
 	HELIUM_ASSERT( pRequest );
 	HELIUM_ASSERT( !( pRequest->flags & LOAD_FLAG_PRELOADED ) );
 
-	HELIUM_ASSERT( !pRequest->spObject );
-
 	const Cache::Entry* pCacheEntry = pRequest->pEntry;
 	HELIUM_ASSERT( pCacheEntry );
 
@@ -486,6 +620,7 @@ bool CachePackageLoader::TickDeserialize( LoadRequest* pRequest )
 
 			DefaultAllocator().Free( pRequest->pAsyncLoadBuffer );
 			pRequest->pAsyncLoadBuffer = NULL;
+			pRequest->pCacheData = NULL;
 
 			pRequest->flags |= LOAD_FLAG_PRELOADED | LOAD_FLAG_ERROR;
 
@@ -493,9 +628,31 @@ bool CachePackageLoader::TickDeserialize( LoadRequest* pRequest )
 		}
 	}
 
+	return true;
+}
+
+/// Deserialize the object for the given object load request.
+///
+/// This runs through AssetLoader::RunParallel(), so it may run concurrently for different load requests.  Load
+/// requests begun by resolving object references are queued by the asset loader until its next tick.
+///
+/// @param[in] pRequest  Load request, for which the cache data has been read and the owner has been loaded.
+void CachePackageLoader::TickDeserialize( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+	HELIUM_ASSERT( !( pRequest->flags & LOAD_FLAG_PRELOADED ) );
+	HELIUM_ASSERT( IsInvalid( pRequest->ownerLoadIndex ) );
+
+	HELIUM_ASSERT( !pRequest->spObject );
+
+	const Cache::Entry* pCacheEntry = pRequest->pEntry;
+	HELIUM_ASSERT( pCacheEntry );
+
 	Asset* pOwner = pRequest->spOwner;
 
 	HELIUM_ASSERT( !pOwner || pOwner->IsFullyLoaded() );
+
+	uint64_t deserializeStartTicks = AssetLoadTrace::IsEnabled() ? Timer::GetTickCount() : 0;
 	
 	Reflect::ObjectPtr cached_object = Cache::ReadCacheObjectFromBuffer(
 		pRequest->pPropertyDataBegin, 
@@ -561,13 +718,395 @@ bool CachePackageLoader::TickDeserialize( LoadRequest* pRequest )
 
 	DefaultAllocator().Free( pRequest->pAsyncLoadBuffer );
 	pRequest->pAsyncLoadBuffer = NULL;
+	pRequest->pCacheData = NULL;
 
 	pObject->SetFlags( Asset::FLAG_PRELOADED );
 
-	pRequest->flags |= LOAD_FLAG_PRELOADED;
+	if( deserializeStartTicks != 0 )
+	{
+		AssetLoadTrace::RecordStage(
+			AssetLoadTrace::STAGE_DESERIALIZE,
+			pCacheEntry->path,
+			deserializeStartTicks,
+			Timer::GetTickCount() );
+	}
 
 	// Asset is now preloaded.
-	return true;
+	pRequest->flags |= LOAD_FLAG_PRELOADED;
+}
+
+/// AssetLoader::RunParallel() callback deserializing one request in the current tick's deserialize list.
+///
+/// @param[in] pContext  Package loader.
+/// @param[in] index     Index of the request in the deserialize list.
+void CachePackageLoader::DeserializeCallback( void* pContext, size_t index )
+{
+	CachePackageLoader* pLoader = static_cast< CachePackageLoader* >( pContext );
+	HELIUM_ASSERT( pLoader );
+	HELIUM_ASSERT( index < pLoader->m_deserializeRequests.GetSize() );
+
+	pLoader->TickDeserialize( pLoader->m_deserializeRequests[ index ] );
+}
+
+/// Prefetch the cache data of an entry and of everything it depends on, if its package has a prefetch manifest.
+///
+/// The manifest of a package is read the first time an object is loaded from it.  Until the manifest is available,
+/// entries are kept so that their dependencies can be prefetched once it has been read.
+///
+/// @param[in] pEntry  Cache entry of an object about to be loaded.
+void CachePackageLoader::PrefetchDependencies( const Cache::Entry* pEntry )
+{
+	HELIUM_ASSERT( pEntry );
+	HELIUM_ASSERT( m_pCache );
+
+	AssetPath packagePath = pEntry->path.GetParentPackage();
+	if( packagePath.IsEmpty() )
+	{
+		return;
+	}
+
+	PackageManifest* pManifest = NULL;
+
+	size_t packageManifestCount = m_packageManifests.GetSize();
+	for( size_t packageManifestIndex = 0; packageManifestIndex < packageManifestCount; ++packageManifestIndex )
+	{
+		if( m_packageManifests[ packageManifestIndex ]->packagePath == packagePath )
+		{
+			pManifest = m_packageManifests[ packageManifestIndex ];
+
+			break;
+		}
+	}
+
+	if( !pManifest )
+	{
+		pManifest = new PackageManifest;
+		HELIUM_ASSERT( pManifest );
+		pManifest->packagePath = packagePath;
+		SetInvalid( pManifest->asyncLoadId );
+		pManifest->pAsyncLoadBuffer = NULL;
+		pManifest->dataSize = 0;
+		m_packageManifests.Push( pManifest );
+
+		const Cache::Entry* pManifestEntry = m_pCache->FindEntry( packagePath, Cache::PREFETCH_MANIFEST_SUB_DATA_INDEX );
+		if( !pManifestEntry )
+		{
+			return;
+		}
+
+		CacheAccessTrace::RecordAccess( m_pCache->GetName(), packagePath, Cache::PREFETCH_MANIFEST_SUB_DATA_INDEX );
+
+		CompressionCodec codec = static_cast< CompressionCodec >( pManifestEntry->codec );
+		const uint8_t* pMappedData =
+			( codec == CompressionCodecs::None ? m_pCache->GetMappedEntryData( *pManifestEntry ) : NULL );
+		if( pMappedData )
+		{
+			pManifest->manifest.Read( pMappedData, pManifestEntry->size );
+		}
+		else
+		{
+			AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+			HELIUM_ASSERT( pAsyncLoader );
+
+			pManifest->dataSize = pManifestEntry->uncompressedSize;
+			pManifest->pAsyncLoadBuffer = static_cast< uint8_t* >( DefaultAllocator().Allocate( pManifest->dataSize ) );
+			HELIUM_ASSERT( pManifest->pAsyncLoadBuffer );
+
+			pManifest->asyncLoadId = pAsyncLoader->QueueRequest(
+				pManifest->pAsyncLoadBuffer,
+				m_pCache->GetCacheFileName(),
+				pManifestEntry->offset,
+				pManifestEntry->size,
+				AsyncLoader::PRIORITY_NORMAL,
+				codec,
+				pManifest->dataSize );
+			if( IsInvalid( pManifest->asyncLoadId ) )
+			{
+				DefaultAllocator().Free( pManifest->pAsyncLoadBuffer );
+				pManifest->pAsyncLoadBuffer = NULL;
+			}
+		}
+	}
+
+	if( IsValid( pManifest->asyncLoadId ) )
+	{
+		pManifest->pendingEntries.Push( pEntry );
+
+		return;
+	}
+
+	PrefetchEntries( pEntry, pManifest->manifest );
+}
+
+/// Issue reads for the cache data of an entry and of the dependencies listed for it in a prefetch manifest.
+///
+/// Entries that are read in place from the mapped cache file, that are already being loaded or prefetched, or whose
+/// objects are already in memory are skipped.  The rest are queued together in cache file order, so that they can be
+/// read in a single pass over the cache file.
+///
+/// @param[in] pEntry     Cache entry of an object being loaded.
+/// @param[in] rManifest  Prefetch manifest of the object's package.
+void CachePackageLoader::PrefetchEntries( const Cache::Entry* pEntry, const PrefetchManifest& rManifest )
+{
+	HELIUM_ASSERT( pEntry );
+
+	rManifest.GatherDependencies( pEntry->path, m_prefetchPaths );
+	if( m_prefetchPaths.IsEmpty() )
+	{
+		return;
+	}
+
+	m_prefetchPaths.Push( pEntry->path );
+
+	m_prefetchEntries.Resize( 0 );
+
+	size_t pathCount = m_prefetchPaths.GetSize();
+	for( size_t pathIndex = 0; pathIndex < pathCount; ++pathIndex )
+	{
+		AssetPath path = m_prefetchPaths[ pathIndex ];
+		const Cache::Entry* pPrefetchEntry = m_pCache->FindEntry( path, 0 );
+		if( !pPrefetchEntry )
+		{
+			continue;
+		}
+
+		if( pPrefetchEntry->codec == CompressionCodecs::None && m_pCache->GetMappedEntryData( *pPrefetchEntry ) )
+		{
+			continue;
+		}
+
+		if( pPrefetchEntry != pEntry && Asset::FindObject( path ) )
+		{
+			continue;
+		}
+
+		bool bSkip = false;
+
+		size_t prefetchEntryCount = m_prefetchEntries.GetSize();
+		for( size_t prefetchEntryIndex = 0; prefetchEntryIndex < prefetchEntryCount && !bSkip; ++prefetchEntryIndex )
+		{
+			bSkip = ( m_prefetchEntries[ prefetchEntryIndex ] == pPrefetchEntry );
+		}
+
+		size_t prefetchedEntryCount = m_prefetchedEntries.GetSize();
+		for( size_t prefetchedEntryIndex = 0;
+			prefetchedEntryIndex < prefetchedEntryCount && !bSkip;
+			++prefetchedEntryIndex )
+		{
+			bSkip = ( m_prefetchedEntries[ prefetchedEntryIndex ].pEntry == pPrefetchEntry );
+		}
+
+		size_t loadRequestSize = m_loadRequests.GetSize();
+		for( size_t loadRequestIndex = 0; loadRequestIndex < loadRequestSize && !bSkip; ++loadRequestIndex )
+		{
+			bSkip = ( m_loadRequests.IsElementValid( loadRequestIndex ) &&
+				m_loadRequests[ loadRequestIndex ]->pEntry == pPrefetchEntry );
+		}
+
+		if( !bSkip )
+		{
+			m_prefetchEntries.Push( pPrefetchEntry );
+		}
+	}
+
+	// Nothing to gain over reading the entry on its own.
+	size_t prefetchEntryCount = m_prefetchEntries.GetSize();
+	if( prefetchEntryCount < 2 )
+	{
+		return;
+	}
+
+	std::sort( m_prefetchEntries.GetData(), m_prefetchEntries.GetData() + prefetchEntryCount, EntryOffsetLess );
+
+	HELIUM_TRACE(
+		TraceLevels::Debug,
+		"CachePackageLoader: Prefetching %" PRIuSZ " entries for \"%s\".\n",
+		prefetchEntryCount,
+		*pEntry->path.ToString() );
+
+	DefaultAllocator allocator;
+
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	HELIUM_ASSERT( pAsyncLoader );
+	uint32_t cacheFileId = pAsyncLoader->GetFileId( m_pCache->GetCacheFileName() );
+
+	DynamicArray< AsyncLoader::RequestInfo > requests;
+	requests.Resize( prefetchEntryCount );
+	for( size_t prefetchEntryIndex = 0; prefetchEntryIndex < prefetchEntryCount; ++prefetchEntryIndex )
+	{
+		const Cache::Entry* pPrefetchEntry = m_prefetchEntries[ prefetchEntryIndex ];
+
+		AsyncLoader::RequestInfo& rRequest = requests[ prefetchEntryIndex ];
+		rRequest.pBuffer = allocator.Allocate( pPrefetchEntry->uncompressedSize );
+		HELIUM_ASSERT( rRequest.pBuffer );
+		rRequest.fileId = cacheFileId;
+		rRequest.offset = pPrefetchEntry->offset;
+		rRequest.size = pPrefetchEntry->size;
+		rRequest.codec = static_cast< CompressionCodec >( pPrefetchEntry->codec );
+		rRequest.uncompressedSize = pPrefetchEntry->uncompressedSize;
+		rRequest.pCompletionCounter = &m_completedPrefetchCount;
+	}
+
+	DynamicArray< size_t > requestIds;
+	requestIds.Resize( prefetchEntryCount );
+
+	pAsyncLoader->QueueRequests( requests.GetData(), prefetchEntryCount, requestIds.GetData() );
+
+	for( size_t prefetchEntryIndex = 0; prefetchEntryIndex < prefetchEntryCount; ++prefetchEntryIndex )
+	{
+		uint8_t* pBuffer = static_cast< uint8_t* >( requests[ prefetchEntryIndex ].pBuffer );
+		if( IsInvalid( requestIds[ prefetchEntryIndex ] ) )
+		{
+			allocator.Free( pBuffer );
+
+			continue;
+		}
+
+		PrefetchedEntry* pPrefetchedEntry = m_prefetchedEntries.New();
+		HELIUM_ASSERT( pPrefetchedEntry );
+		pPrefetchedEntry->pEntry = m_prefetchEntries[ prefetchEntryIndex ];
+		pPrefetchedEntry->asyncLoadId = requestIds[ prefetchEntryIndex ];
+		pPrefetchedEntry->pBuffer = pBuffer;
+		pPrefetchedEntry->bytesRead = 0;
+		pPrefetchedEntry->idleTickCount = 0;
+	}
+}
+
+/// Hand the data prefetched for a load request's cache entry over to the request, if any.
+///
+/// @param[in] pRequest  Load request for which the entry data has not been read yet.
+///
+/// @return  True if the request took over prefetched data (or the read in progress for it), false if nothing usable
+///          was prefetched for the entry.
+bool CachePackageLoader::TakePrefetchedEntry( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+	HELIUM_ASSERT( pRequest->pEntry );
+	HELIUM_ASSERT( IsInvalid( pRequest->asyncLoadId ) );
+	HELIUM_ASSERT( !pRequest->pAsyncLoadBuffer );
+
+	size_t prefetchedEntryCount = m_prefetchedEntries.GetSize();
+	for( size_t prefetchedEntryIndex = 0; prefetchedEntryIndex < prefetchedEntryCount; ++prefetchedEntryIndex )
+	{
+		PrefetchedEntry& rPrefetchedEntry = m_prefetchedEntries[ prefetchedEntryIndex ];
+		if( rPrefetchedEntry.pEntry != pRequest->pEntry )
+		{
+			continue;
+		}
+
+		bool bTaken = false;
+		if( IsValid( rPrefetchedEntry.asyncLoadId ) )
+		{
+			pRequest->asyncLoadId = rPrefetchedEntry.asyncLoadId;
+			pRequest->pAsyncLoadBuffer = rPrefetchedEntry.pBuffer;
+			bTaken = true;
+		}
+		else if( rPrefetchedEntry.bytesRead == pRequest->pEntry->uncompressedSize )
+		{
+			pRequest->pAsyncLoadBuffer = rPrefetchedEntry.pBuffer;
+			pRequest->pCacheData = rPrefetchedEntry.pBuffer;
+			bTaken = true;
+		}
+		else
+		{
+			// The prefetch failed, so let the request read the entry itself.
+			DefaultAllocator().Free( rPrefetchedEntry.pBuffer );
+		}
+
+		m_prefetchedEntries.RemoveSwap( prefetchedEntryIndex );
+
+		if( bTaken )
+		{
+			LoadStatistics::AddCount( LoadStatistics::COUNTER_PREFETCH_HITS );
+		}
+
+		return bTaken;
+	}
+
+	return false;
+}
+
+/// Update reads of prefetch manifests and of prefetched entry data.
+///
+/// Prefetched data that no load request has taken long after being read is released.
+void CachePackageLoader::TickPrefetching()
+{
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	HELIUM_ASSERT( pAsyncLoader );
+
+	size_t packageManifestCount = m_packageManifests.GetSize();
+	for( size_t packageManifestIndex = 0; packageManifestIndex < packageManifestCount; ++packageManifestIndex )
+	{
+		PackageManifest* pManifest = m_packageManifests[ packageManifestIndex ];
+		HELIUM_ASSERT( pManifest );
+
+		size_t bytesRead = 0;
+		if( IsInvalid( pManifest->asyncLoadId ) || !pAsyncLoader->TrySyncRequest( pManifest->asyncLoadId, bytesRead ) )
+		{
+			continue;
+		}
+
+		SetInvalid( pManifest->asyncLoadId );
+
+		if( bytesRead == pManifest->dataSize )
+		{
+			pManifest->manifest.Read( pManifest->pAsyncLoadBuffer, bytesRead );
+		}
+		else
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"CachePackageLoader: Failed to read the prefetch manifest of package \"%s\".\n",
+				*pManifest->packagePath.ToString() );
+		}
+
+		DefaultAllocator().Free( pManifest->pAsyncLoadBuffer );
+		pManifest->pAsyncLoadBuffer = NULL;
+
+		size_t pendingEntryCount = pManifest->pendingEntries.GetSize();
+		for( size_t pendingEntryIndex = 0; pendingEntryIndex < pendingEntryCount; ++pendingEntryIndex )
+		{
+			PrefetchEntries( pManifest->pendingEntries[ pendingEntryIndex ], pManifest->manifest );
+		}
+
+		pManifest->pendingEntries.Clear();
+	}
+
+	// Pending prefetch reads are only polled once the async loader has signaled that some of them have completed.
+	bool bPollPrefetchReads = ( AtomicExchangeAcquire( m_completedPrefetchCount, 0 ) != 0 );
+
+	size_t prefetchedEntryIndex = 0;
+	while( prefetchedEntryIndex < m_prefetchedEntries.GetSize() )
+	{
+		PrefetchedEntry& rPrefetchedEntry = m_prefetchedEntries[ prefetchedEntryIndex ];
+		if( IsValid( rPrefetchedEntry.asyncLoadId ) )
+		{
+			if( bPollPrefetchReads &&
+				pAsyncLoader->TrySyncRequest( rPrefetchedEntry.asyncLoadId, rPrefetchedEntry.bytesRead ) )
+			{
+				SetInvalid( rPrefetchedEntry.asyncLoadId );
+			}
+
+			++prefetchedEntryIndex;
+
+			continue;
+		}
+
+		if( ++rPrefetchedEntry.idleTickCount <= PREFETCH_EXPIRE_TICKS )
+		{
+			++prefetchedEntryIndex;
+
+			continue;
+		}
+
+		HELIUM_TRACE(
+			TraceLevels::Debug,
+			"CachePackageLoader: Releasing prefetched data for \"%s\", which was never requested.\n",
+			*rPrefetchedEntry.pEntry->path.ToString() );
+
+		DefaultAllocator().Free( rPrefetchedEntry.pBuffer );
+		m_prefetchedEntries.RemoveSwap( prefetchedEntryIndex );
+	}
 }
 
 /// Recursive function for resolving a package request.
@@ -608,8 +1147,8 @@ bool CachePackageLoader::ReadCacheData( LoadRequest* pRequest )
 {
 	HELIUM_ASSERT( pRequest );
 
-	uint8_t* pBufferCurrent = pRequest->pAsyncLoadBuffer;
-	uint8_t* pPropertyDataEnd = pRequest->pPropertyDataEnd;
+	const uint8_t* pBufferCurrent = pRequest->pCacheData;
+	const uint8_t* pPropertyDataEnd = pRequest->pPropertyDataEnd;
 	HELIUM_ASSERT( pBufferCurrent );
 	HELIUM_ASSERT( pPropertyDataEnd );
 	HELIUM_ASSERT( pBufferCurrent <= pPropertyDataEnd );
@@ -4,15 +4,22 @@
 #include "Engine/PackageLoader.h"
 
 #include "Engine/Cache.h"
+#include "Engine/PrefetchManifest.h"
 
 namespace Helium
 {
 	/// Package loader for loading objects from a binary cache.
+	///
+	/// When an object is loaded from a package with a prefetch manifest (see PrefetchManifest), the cache entries of
+	/// the object and of everything it depends on are read together, sorted by cache file offset, and the load
+	/// requests later made for the dependencies pick up the data read ahead for them.
 	class CachePackageLoader : public PackageLoader
 	{
 	public:
 		/// Load request pool block size.
 		static const size_t LOAD_REQUEST_POOL_BLOCK_SIZE = 16;
+		/// Number of ticks data read ahead for an object is kept once read if the object is not requested.
+		static const uint32_t PREFETCH_EXPIRE_TICKS = 300;
 
 		/// @name Construction/Destruction
 		//@{
@@ -69,15 +76,20 @@ namespace Helium
 			size_t asyncLoadId;
 			/// Async load buffer.
 			uint8_t* pAsyncLoadBuffer;
+			/// Tick count when the async load was issued (only set while the load trace is enabled).
+			uint64_t asyncLoadStartTicks;
 
-			/// Pointer to where the property data begins within the pAsyncLoadBuffer
-			uint8_t* pPropertyDataBegin;
+			/// Entry data, either within the pAsyncLoadBuffer or read in place from the mapped cache file.
+			const uint8_t* pCacheData;
+
+			/// Pointer to where the property data begins within the pCacheData
+			const uint8_t* pPropertyDataBegin;
 			/// End of the property data
-			uint8_t* pPropertyDataEnd;
-			/// Pointer to where the persistent resource data begins within the pAsyncLoadBuffer
-			uint8_t* pPersistentResourceDataBegin;
+			const uint8_t* pPropertyDataEnd;
+			/// Pointer to where the persistent resource data begins within the pCacheData
+			const uint8_t* pPersistentResourceDataBegin;
 			/// End of the persistent resource data.
-			uint8_t* pPersistentResourceDataEnd;
+			const uint8_t* pPersistentResourceDataEnd;
 
 			// Load index for the owning asset
 			size_t ownerLoadIndex;
@@ -91,6 +103,40 @@ namespace Helium
 			bool forceReload;
 		};
 
+		/// Prefetch manifest of a package.
+		struct PackageManifest
+		{
+			/// Package path.
+			AssetPath packagePath;
+			/// Manifest (empty if the package has none).
+			PrefetchManifest manifest;
+
+			/// Async load ID of the manifest data.
+			size_t asyncLoadId;
+			/// Async load buffer.
+			uint8_t* pAsyncLoadBuffer;
+			/// Size of the manifest data being read.
+			size_t dataSize;
+
+			/// Entries being loaded whose dependencies will be prefetched once the manifest has been read.
+			DynamicArray< const Cache::Entry* > pendingEntries;
+		};
+
+		/// Cache entry data read ahead of a load request for it.
+		struct PrefetchedEntry
+		{
+			/// Cache entry.
+			const Cache::Entry* pEntry;
+			/// Async load ID, or invalid once the read has completed.
+			size_t asyncLoadId;
+			/// Buffer holding the entry data.
+			uint8_t* pBuffer;
+			/// Number of bytes read, once the read has completed.
+			size_t bytesRead;
+			/// Number of ticks since the read completed.
+			uint32_t idleTickCount;
+		};
+
 		/// Cache from which objects will be loaded.
 		Cache* m_pCache;
 		/// True if we've synced the cache TOC load process.
@@ -100,15 +146,38 @@ namespace Helium
 		SparseArray< LoadRequest* > m_loadRequests;
 		/// Load request pool.
 		ObjectPool< LoadRequest > m_loadRequestPool;
+		/// Requests to deserialize in the current tick.
+		DynamicArray< LoadRequest* > m_deserializeRequests;
+
+		/// Prefetch manifests of the packages from which objects have been loaded.
+		DynamicArray< PackageManifest* > m_packageManifests;
+		/// Entry data read ahead of load requests.
+		DynamicArray< PrefetchedEntry > m_prefetchedEntries;
+		/// Scratch list of dependency paths to prefetch.
+		DynamicArray< AssetPath > m_prefetchPaths;
+		/// Scratch list of entries to prefetch.
+		DynamicArray< const Cache::Entry* > m_prefetchEntries;
+		/// Number of prefetch reads completed since the last tick (incremented by the async loader).
+		volatile int32_t m_completedPrefetchCount;
 
 		/// @name Load Ticking Functions
 		//@{
 		bool TickCacheLoad( LoadRequest* pRequest );
-		bool TickDeserialize( LoadRequest* pRequest );
+		bool TickOwnerLoad( LoadRequest* pRequest );
+		void TickDeserialize( LoadRequest* pRequest );
+		//@}
+
+		/// @name Prefetching
+		//@{
+		void PrefetchDependencies( const Cache::Entry* pEntry );
+		void PrefetchEntries( const Cache::Entry* pEntry, const PrefetchManifest& rManifest );
+		bool TakePrefetchedEntry( LoadRequest* pRequest );
+		void TickPrefetching();
 		//@}
 
 		/// @name Static Private Utility Functions
 		//@{
+		static void DeserializeCallback( void* pContext, size_t index );
 		static void ResolvePackage( AssetPtr& spPackage, AssetPath packagePath );
 		static bool ReadCacheData( LoadRequest* pRequest );
 		//@}
@@ -0,0 +1,153 @@
+#include "Precompile.h"
+#include "Engine/Compression.h"
+
+#include <zlib.h>
+
+using namespace Helium;
+
+/// Compress a block of data.
+///
+/// @param[in]  codec         Codec with which to compress the data.
+/// @param[in]  pSource       Data to compress.
+/// @param[in]  sourceSize    Number of bytes to compress.
+/// @param[out] rDestination  Compressed data.
+///
+/// @return  True if the data was compressed successfully, false if not.
+///
+/// @see Decompress()
+bool Compression::Compress(
+	CompressionCodec codec,
+	const void* pSource,
+	size_t sourceSize,
+	DynamicArray< uint8_t >& rDestination )
+{
+	HELIUM_ASSERT( pSource || sourceSize == 0 );
+
+	rDestination.Resize( 0 );
+
+	switch( codec )
+	{
+	case CompressionCodecs::None:
+		{
+			rDestination.Resize( sourceSize );
+			MemoryCopy( rDestination.GetData(), pSource, sourceSize );
+
+			return true;
+		}
+
+	case CompressionCodecs::Deflate:
+		{
+			if( sourceSize > UINT32_MAX )
+			{
+				return false;
+			}
+
+			uLong sourceLength = static_cast< uLong >( sourceSize );
+			uLongf destinationLength = compressBound( sourceLength );
+			rDestination.Resize( destinationLength );
+
+			int result = compress2(
+				rDestination.GetData(),
+				&destinationLength,
+				static_cast< const Bytef* >( pSource ),
+				sourceLength,
+				Z_DEFAULT_COMPRESSION );
+			if( result != Z_OK )
+			{
+				HELIUM_TRACE( TraceLevels::Error, "Compression::Compress(): zlib compression failed (%d).\n", result );
+
+				rDestination.Resize( 0 );
+
+				return false;
+			}
+
+			rDestination.Resize( destinationLength );
+
+			return true;
+		}
+
+	default:
+		break;
+	}
+
+	HELIUM_TRACE( TraceLevels::Error, "Compression::Compress(): Unknown codec %d.\n", static_cast< int >( codec ) );
+
+	return false;
+}
+
+/// Decompress a block of data.
+///
+/// If the destination buffer is smaller than the decompressed data, only as much data as fits is decompressed.
+///
+/// @param[in] codec            Codec with which the data was compressed.
+/// @param[in] pDestination     Buffer in which to store the decompressed data.
+/// @param[in] destinationSize  Size of the destination buffer, in bytes.
+/// @param[in] pSource          Compressed data.
+/// @param[in] sourceSize       Number of bytes of compressed data.
+///
+/// @return  Number of bytes written to the destination buffer, or an invalid index if the data could not be
+///          decompressed.
+///
+/// @see Compress()
+size_t Compression::Decompress(
+	CompressionCodec codec,
+	void* pDestination,
+	size_t destinationSize,
+	const void* pSource,
+	size_t sourceSize )
+{
+	HELIUM_ASSERT( pDestination || destinationSize == 0 );
+	HELIUM_ASSERT( pSource || sourceSize == 0 );
+
+	switch( codec )
+	{
+	case CompressionCodecs::None:
+		{
+			size_t copySize = Min( destinationSize, sourceSize );
+			MemoryCopy( pDestination, pSource, copySize );
+
+			return copySize;
+		}
+
+	case CompressionCodecs::Deflate:
+		{
+			if( sourceSize > UINT32_MAX || destinationSize > UINT32_MAX )
+			{
+				return Invalid< size_t >();
+			}
+
+			z_stream stream;
+			MemoryZero( &stream, sizeof( stream ) );
+			stream.next_in = static_cast< Bytef* >( const_cast< void* >( pSource ) );
+			stream.avail_in = static_cast< uInt >( sourceSize );
+			stream.next_out = static_cast< Bytef* >( pDestination );
+			stream.avail_out = static_cast< uInt >( destinationSize );
+
+			if( inflateInit( &stream ) != Z_OK )
+			{
+				return Invalid< size_t >();
+			}
+
+			// Running out of output space is fine, as the caller may only want the start of the data.
+			int result = inflate( &stream, Z_FINISH );
+			size_t decompressedSize = destinationSize - stream.avail_out;
+			inflateEnd( &stream );
+
+			if( result != Z_STREAM_END && !( result == Z_BUF_ERROR && stream.avail_out == 0 ) )
+			{
+				HELIUM_TRACE( TraceLevels::Error, "Compression::Decompress(): zlib decompression failed (%d).\n", result );
+
+				return Invalid< size_t >();
+			}
+
+			return decompressedSize;
+		}
+
+	default:
+		break;
+	}
+
+	HELIUM_TRACE( TraceLevels::Error, "Compression::Decompress(): Unknown codec %d.\n", static_cast< int >( codec ) );
+
+	return Invalid< size_t >();
+}
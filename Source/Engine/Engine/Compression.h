@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Foundation/DynamicArray.h"
+
+#include "Engine/Engine.h"
+
+namespace Helium
+{
+	/// Compression codecs for cached data.
+	namespace CompressionCodecs
+	{
+		enum Type
+		{
+			/// Data is stored as is.
+			None,
+			/// zlib (deflate) stream.
+			Deflate,
+
+			Count
+		};
+	}
+	typedef CompressionCodecs::Type CompressionCodec;
+
+	/// Compression and decompression of blocks of data.
+	class HELIUM_ENGINE_API Compression
+	{
+	public:
+		/// @name Compression
+		//@{
+		static bool Compress(
+			CompressionCodec codec, const void* pSource, size_t sourceSize, DynamicArray< uint8_t >& rDestination );
+		static size_t Decompress(
+			CompressionCodec codec, void* pDestination, size_t destinationSize, const void* pSource, size_t sourceSize );
+		//@}
+	};
+}
@@ -0,0 +1,271 @@
+#include "Precompile.h"
+#include "Engine/ConcurrentObjectPool.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/MemoryHeap.h"
+
+using namespace Helium;
+
+namespace
+{
+	/// Number of thread cache slots handed out so far (shared by all pools).
+	volatile int32_t s_threadCacheIndexCount = 0;
+
+	/// Thread cache slot of the current thread, assigned when the thread first uses any pool.
+	thread_local uint32_t s_threadCacheIndex = Invalid< uint32_t >();
+
+	/// Round a size up to a multiple of an alignment (which must be a power of two).
+	size_t AlignSize( size_t size, size_t alignment )
+	{
+		return ( size + alignment - 1 ) & ~( alignment - 1 );
+	}
+}
+
+/// Constructor.
+///
+/// @param[in] slotSize          Size of each object, in bytes.
+/// @param[in] slotAlignment     Alignment of each object, in bytes.
+/// @param[in] blockSize         Number of objects to allocate space for at a time.
+/// @param[in] threadCacheLimit  Number of free objects each thread may keep cached for itself.
+ConcurrentObjectPoolBase::ConcurrentObjectPoolBase(
+	size_t slotSize,
+	size_t slotAlignment,
+	size_t blockSize,
+	size_t threadCacheLimit )
+	: m_slotAlignment( Max( slotAlignment, static_cast< size_t >( alignof( FreeSlot ) ) ) )
+	, m_blockSize( Max( blockSize, static_cast< size_t >( 1 ) ) )
+	, m_threadCacheLimit( Max( threadCacheLimit, static_cast< size_t >( 1 ) ) )
+	, m_pSharedHead( NULL )
+	, m_pBlocks( NULL )
+{
+	m_slotSize = AlignSize( Max( slotSize, sizeof( FreeSlot ) ), m_slotAlignment );
+	MemoryZero( m_threadCaches, sizeof( m_threadCaches ) );
+}
+
+/// Destructor.
+///
+/// This frees all memory allocated by the pool.  All objects must have been released beforehand.
+ConcurrentObjectPoolBase::~ConcurrentObjectPoolBase()
+{
+	for( uint32_t cacheIndex = 0; cacheIndex < MAX_THREAD_CACHE_COUNT; ++cacheIndex )
+	{
+		delete m_threadCaches[ cacheIndex ];
+	}
+
+	DefaultAllocator allocator;
+
+	Block* pBlock = m_pBlocks;
+	while( pBlock )
+	{
+		Block* pNext = pBlock->pNext;
+		allocator.FreeAligned( pBlock );
+		pBlock = pNext;
+	}
+}
+
+/// Allocate a slot for an object.
+///
+/// @return  Uninitialized slot memory, or null if memory could not be allocated.
+///
+/// @see ReleaseSlot()
+void* ConcurrentObjectPoolBase::AllocateSlot()
+{
+	ThreadCache* pCache = GetThreadCache();
+	if( pCache && pCache->pHead )
+	{
+		FreeSlot* pSlot = pCache->pHead;
+		pCache->pHead = pSlot->pNext;
+		--pCache->count;
+
+		return pSlot;
+	}
+
+	// Take every slot on the shared list at once (taking single slots would be prone to the ABA problem), and only
+	// allocate a new block if none are left.
+	FreeSlot* pSlot = AtomicExchangeAcquire( m_pSharedHead, static_cast< FreeSlot* >( NULL ) );
+	if( !pSlot )
+	{
+		pSlot = AllocateBlock();
+		if( !pSlot )
+		{
+			return NULL;
+		}
+	}
+
+	FreeSlot* pRemaining = pSlot->pNext;
+	if( pRemaining )
+	{
+		if( pCache )
+		{
+			size_t remainingCount = 0;
+			for( FreeSlot* pRemainingSlot = pRemaining; pRemainingSlot; pRemainingSlot = pRemainingSlot->pNext )
+			{
+				++remainingCount;
+			}
+
+			pCache->pHead = pRemaining;
+			pCache->count = remainingCount;
+		}
+		else
+		{
+			FreeSlot* pTail = pRemaining;
+			while( pTail->pNext )
+			{
+				pTail = pTail->pNext;
+			}
+
+			PushShared( pRemaining, pTail );
+		}
+	}
+
+	return pSlot;
+}
+
+/// Return a slot to the pool.
+///
+/// @param[in] pSlot  Slot to release.  This may have been allocated on any thread.
+///
+/// @see AllocateSlot()
+void ConcurrentObjectPoolBase::ReleaseSlot( void* pSlot )
+{
+	HELIUM_ASSERT( pSlot );
+
+	FreeSlot* pFreeSlot = static_cast< FreeSlot* >( pSlot );
+
+	ThreadCache* pCache = GetThreadCache();
+	if( !pCache )
+	{
+		PushShared( pFreeSlot, pFreeSlot );
+
+		return;
+	}
+
+	pFreeSlot->pNext = pCache->pHead;
+	pCache->pHead = pFreeSlot;
+	++pCache->count;
+
+	// Keep half of the limit cached and hand the rest to the shared list, so a thread that mostly releases objects
+	// allocated elsewhere does not hoard them, and one that alternates around the limit does not spill every time.
+	if( pCache->count > m_threadCacheLimit )
+	{
+		size_t keepCount = m_threadCacheLimit / 2;
+
+		FreeSlot* pLastKept = NULL;
+		FreeSlot* pSpillHead = pCache->pHead;
+		for( size_t slotIndex = 0; slotIndex < keepCount; ++slotIndex )
+		{
+			pLastKept = pSpillHead;
+			pSpillHead = pSpillHead->pNext;
+		}
+
+		FreeSlot* pSpillTail = pSpillHead;
+		while( pSpillTail->pNext )
+		{
+			pSpillTail = pSpillTail->pNext;
+		}
+
+		if( pLastKept )
+		{
+			pLastKept->pNext = NULL;
+		}
+		else
+		{
+			pCache->pHead = NULL;
+		}
+
+		pCache->count = keepCount;
+
+		PushShared( pSpillHead, pSpillTail );
+	}
+}
+
+/// Get the free slot cache of the current thread, creating it if necessary.
+///
+/// @return  Cache for the current thread, or null if the thread was not given a cache slot.
+ConcurrentObjectPoolBase::ThreadCache* ConcurrentObjectPoolBase::GetThreadCache()
+{
+	uint32_t cacheIndex = s_threadCacheIndex;
+	if( IsInvalid( cacheIndex ) )
+	{
+		cacheIndex = static_cast< uint32_t >( AtomicIncrementUnsafe( s_threadCacheIndexCount ) - 1 );
+		s_threadCacheIndex = cacheIndex;
+	}
+
+	if( cacheIndex >= MAX_THREAD_CACHE_COUNT )
+	{
+		return NULL;
+	}
+
+	ThreadCache* pCache = m_threadCaches[ cacheIndex ];
+	if( !pCache )
+	{
+		pCache = new ThreadCache;
+		HELIUM_ASSERT( pCache );
+		pCache->pHead = NULL;
+		pCache->count = 0;
+
+		m_threadCaches[ cacheIndex ] = pCache;
+	}
+
+	return pCache;
+}
+
+/// Allocate a new block of slots.
+///
+/// @return  List of the slots in the new block, or null if memory could not be allocated.
+ConcurrentObjectPoolBase::FreeSlot* ConcurrentObjectPoolBase::AllocateBlock()
+{
+	size_t headerSize = AlignSize( sizeof( Block ), m_slotAlignment );
+
+	Block* pBlock = static_cast< Block* >( DefaultAllocator().AllocateAligned(
+		Max( m_slotAlignment, static_cast< size_t >( alignof( Block ) ) ),
+		headerSize + m_slotSize * m_blockSize ) );
+	if( !pBlock )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"ConcurrentObjectPool: Failed to allocate a block of %" PRIuSZ " objects.\n",
+			m_blockSize );
+
+		return NULL;
+	}
+
+	// Blocks are only ever added to this list, so a plain compare-and-swap loop is safe.
+	Block* pPreviousBlock;
+	do
+	{
+		pPreviousBlock = m_pBlocks;
+		pBlock->pNext = pPreviousBlock;
+	}
+	while( AtomicCompareExchangeRelease( m_pBlocks, pBlock, pPreviousBlock ) != pPreviousBlock );
+
+	uint8_t* pSlotMemory = reinterpret_cast< uint8_t* >( pBlock ) + headerSize;
+	FreeSlot* pHead = reinterpret_cast< FreeSlot* >( pSlotMemory );
+	for( size_t slotIndex = 0; slotIndex + 1 < m_blockSize; ++slotIndex )
+	{
+		reinterpret_cast< FreeSlot* >( pSlotMemory )->pNext = reinterpret_cast< FreeSlot* >( pSlotMemory + m_slotSize );
+		pSlotMemory += m_slotSize;
+	}
+
+	reinterpret_cast< FreeSlot* >( pSlotMemory )->pNext = NULL;
+
+	return pHead;
+}
+
+/// Push a chain of free slots onto the shared list.
+///
+/// @param[in] pHead  First slot of the chain.
+/// @param[in] pTail  Last slot of the chain (may be the same as the first).
+void ConcurrentObjectPoolBase::PushShared( FreeSlot* pHead, FreeSlot* pTail )
+{
+	HELIUM_ASSERT( pHead );
+	HELIUM_ASSERT( pTail );
+
+	FreeSlot* pPreviousHead;
+	do
+	{
+		pPreviousHead = m_pSharedHead;
+		pTail->pNext = pPreviousHead;
+	}
+	while( AtomicCompareExchangeRelease( m_pSharedHead, pHead, pPreviousHead ) != pPreviousHead );
+}
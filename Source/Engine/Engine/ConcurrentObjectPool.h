@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Platform/Utility.h"
+
+namespace Helium
+{
+	/// Untyped base of ConcurrentObjectPool.
+	///
+	/// Each thread keeps its own cache of free slots, which it allocates from and releases to without any atomic
+	/// operations.  When a thread's cache grows past its limit (such as when objects allocated on one thread are
+	/// released on another), the excess is returned to a shared free list with a single compare-and-swap, and threads
+	/// whose cache runs dry take the entire shared list with a single exchange before allocating a new block.  Since
+	/// slots are only ever pushed onto the shared list individually or in chains, and only ever taken off it all at once,
+	/// the shared list is not subject to the ABA problem.
+	///
+	/// Thread caches are set up the first time a thread uses a pool, for up to MAX_THREAD_CACHE_COUNT threads over the
+	/// life of the process; any threads beyond that allocate from and release to the shared list directly.  Slots left in
+	/// the cache of a thread that exits are not reclaimed until the pool is destroyed, so this is best suited to pools
+	/// used from the main thread and long-lived worker threads.
+	class HELIUM_ENGINE_API ConcurrentObjectPoolBase : NonCopyable
+	{
+	public:
+		/// Maximum number of threads given their own cache of free slots.
+		static const uint32_t MAX_THREAD_CACHE_COUNT = 64;
+		/// Default number of free slots a thread may keep cached before returning some to the shared list.
+		static const size_t DEFAULT_THREAD_CACHE_LIMIT = 64;
+
+	protected:
+		/// @name Construction/Destruction
+		//@{
+		ConcurrentObjectPoolBase( size_t slotSize, size_t slotAlignment, size_t blockSize, size_t threadCacheLimit );
+		~ConcurrentObjectPoolBase();
+		//@}
+
+		/// @name Slot Allocation
+		//@{
+		void* AllocateSlot();
+		void ReleaseSlot( void* pSlot );
+		//@}
+
+	private:
+		/// Free slot, linked through the memory of the slot itself.
+		struct FreeSlot
+		{
+			/// Next free slot in the list.
+			FreeSlot* pNext;
+		};
+
+		/// Block of slots, followed by the slots themselves.
+		struct Block
+		{
+			/// Next block allocated by the pool.
+			Block* pNext;
+		};
+
+		/// Free slots cached by a single thread.  Only the owning thread touches its cache until the pool is destroyed.
+		struct ThreadCache
+		{
+			/// First free slot.
+			FreeSlot* pHead;
+			/// Number of free slots.
+			size_t count;
+		};
+
+		/// Size of each slot, in bytes.
+		size_t m_slotSize;
+		/// Alignment of each slot, in bytes.
+		size_t m_slotAlignment;
+		/// Number of slots in each block.
+		size_t m_blockSize;
+		/// Number of free slots a thread may keep cached.
+		size_t m_threadCacheLimit;
+
+		/// Thread caches, indexed by thread cache slot (null until a thread first uses the pool).
+		ThreadCache* m_threadCaches[ MAX_THREAD_CACHE_COUNT ];
+		/// Free slots shared between threads.
+		FreeSlot* volatile m_pSharedHead;
+		/// Blocks allocated by the pool.
+		Block* volatile m_pBlocks;
+
+		/// @name Private Utility Functions
+		//@{
+		ThreadCache* GetThreadCache();
+		FreeSlot* AllocateBlock();
+		void PushShared( FreeSlot* pHead, FreeSlot* pTail );
+		//@}
+	};
+
+	/// Object pool that may be used from multiple threads at once without locking.
+	///
+	/// This offers the same allocation interface as ObjectPool: objects are default-constructed when allocated and
+	/// destroyed when released.  Objects may be released on a different thread from the one that allocated them.  All
+	/// objects must be released before the pool is destroyed.
+	///
+	/// @see ConcurrentObjectPoolBase
+	template< typename T >
+	class ConcurrentObjectPool : public ConcurrentObjectPoolBase
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		explicit ConcurrentObjectPool( size_t blockSize, size_t threadCacheLimit = DEFAULT_THREAD_CACHE_LIMIT );
+		//@}
+
+		/// @name Allocation
+		//@{
+		T* Allocate();
+		void Release( T* pObject );
+		//@}
+	};
+}
+
+#include "Engine/ConcurrentObjectPool.inl"
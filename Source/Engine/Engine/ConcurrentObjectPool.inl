@@ -0,0 +1,43 @@
+namespace Helium
+{
+	/// Constructor.
+	///
+	/// @param[in] blockSize         Number of objects to allocate space for at a time.
+	/// @param[in] threadCacheLimit  Number of free objects each thread may keep cached for itself.
+	template< typename T >
+	ConcurrentObjectPool< T >::ConcurrentObjectPool( size_t blockSize, size_t threadCacheLimit )
+		: ConcurrentObjectPoolBase( sizeof( T ), alignof( T ), blockSize, threadCacheLimit )
+	{
+	}
+
+	/// Allocate and construct an object.
+	///
+	/// @return  Newly constructed object, or null if memory could not be allocated.
+	///
+	/// @see Release()
+	template< typename T >
+	T* ConcurrentObjectPool< T >::Allocate()
+	{
+		void* pSlot = AllocateSlot();
+		if( !pSlot )
+		{
+			return NULL;
+		}
+
+		return new( pSlot ) T;
+	}
+
+	/// Destroy an object and return it to the pool.
+	///
+	/// @param[in] pObject  Object to release.  This may have been allocated on any thread.
+	///
+	/// @see Allocate()
+	template< typename T >
+	void ConcurrentObjectPool< T >::Release( T* pObject )
+	{
+		HELIUM_ASSERT( pObject );
+
+		pObject->~T();
+		ReleaseSlot( pObject );
+	}
+}
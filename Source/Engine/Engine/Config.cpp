@@ -1,20 +1,140 @@
 #include "Precompile.h"
 #include "Engine/Config.h"
 
+#include "Foundation/FileStream.h"
+
 #include "Engine/Asset.h"
 #include "Engine/AssetLoader.h"
+#include "Engine/Cache.h"
+#include "Engine/CacheManager.h"
 #include "Engine/PackageLoader.h"
 #include "Engine/FileLocations.h"
 #include "Persist/ArchiveJson.h"
 
+#include <cstring>
+
+#if HELIUM_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace Helium;
 
 static uint32_t g_InitCount = 0;
 Config* Config::sm_pInstance = NULL;
 
+/// Cooked configuration file magic number.
+static const uint32_t COOKED_CONFIG_MAGIC = 0xc0f16b1b;
+/// Cooked configuration file format version.
+static const uint32_t COOKED_CONFIG_VERSION = 1;
+
+/// Cooked configuration file header.  Followed by one record for each section, then the table of section names (each
+/// null-terminated), then the serialized configuration objects.
+struct CookedConfigHeader
+{
+	/// Magic number (COOKED_CONFIG_MAGIC).
+	uint32_t magic;
+	/// Format version (COOKED_CONFIG_VERSION).
+	uint32_t version;
+	/// Number of sections.
+	uint32_t sectionCount;
+	/// Reserved (zero).
+	uint32_t reserved;
+};
+
+/// Cooked configuration section record.  Offsets are from the start of the file.
+struct CookedConfigRecord
+{
+	/// Offset of the section name.
+	uint32_t nameOffset;
+	/// Offset of the serialized configuration object.
+	uint32_t offset;
+	/// Size of the serialized configuration object, in bytes.
+	uint32_t size;
+	/// Reserved (zero).
+	uint32_t reserved;
+};
+
+/// Map a file into memory for read-only access.
+///
+/// @param[in]  pFileName  Name of the file to map.
+/// @param[out] rSize      Size of the mapped file.
+///
+/// @return  Pointer to the mapped file, or null if the file does not exist, is empty, or could not be mapped.
+static const uint8_t* MapReadOnlyFile( const char* pFileName, uint64_t& rSize )
+{
+	const void* pMappedData = NULL;
+	rSize = 0;
+
+#if HELIUM_OS_WIN
+	HANDLE hFile = CreateFileA( pFileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( hFile != INVALID_HANDLE_VALUE )
+	{
+		LARGE_INTEGER fileSize;
+		if( GetFileSizeEx( hFile, &fileSize ) && fileSize.QuadPart > 0 &&
+			static_cast< uint64_t >( fileSize.QuadPart ) <= static_cast< uint64_t >( static_cast< size_t >( -1 ) ) )
+		{
+			HANDLE hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+			if( hMapping )
+			{
+				pMappedData = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+				if( pMappedData )
+				{
+					rSize = static_cast< uint64_t >( fileSize.QuadPart );
+				}
+
+				CloseHandle( hMapping );
+			}
+		}
+
+		CloseHandle( hFile );
+	}
+#else
+	int fileDescriptor = open( pFileName, O_RDONLY );
+	if( fileDescriptor >= 0 )
+	{
+		struct stat fileStat;
+		if( fstat( fileDescriptor, &fileStat ) == 0 && fileStat.st_size > 0 &&
+			static_cast< uint64_t >( fileStat.st_size ) <= static_cast< uint64_t >( static_cast< size_t >( -1 ) ) )
+		{
+			void* pView = mmap( NULL, static_cast< size_t >( fileStat.st_size ), PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+			if( pView != MAP_FAILED )
+			{
+				pMappedData = pView;
+				rSize = static_cast< uint64_t >( fileStat.st_size );
+			}
+		}
+
+		close( fileDescriptor );
+	}
+#endif
+
+	return static_cast< const uint8_t* >( pMappedData );
+}
+
+/// Release a mapping made with MapReadOnlyFile().
+///
+/// @param[in] pData  Mapped file.
+/// @param[in] size   Size of the mapped file.
+static void UnmapReadOnlyFile( const uint8_t* pData, uint64_t size )
+{
+#if HELIUM_OS_WIN
+	HELIUM_UNREF( size );
+	HELIUM_VERIFY( UnmapViewOfFile( pData ) );
+#else
+	HELIUM_VERIFY( munmap( const_cast< uint8_t* >( pData ), static_cast< size_t >( size ) ) == 0 );
+#endif
+}
+
 /// Constructor.
 Config::Config()
-	: m_bLoadingConfigPackage( false )
+	: m_pCookedData( NULL )
+	, m_cookedSize( 0 )
+	, m_bLoadingConfigPackage( false )
 {
 	HELIUM_VERIFY( m_configContainerPackagePath.Set(
 		Name( HELIUM_CONFIG_CONTAINER_PACKAGE ),
@@ -35,9 +155,10 @@ Config::Config()
 /// Destructor.
 Config::~Config()
 {
+	UnmapCooked();
 }
 
-Helium::FilePath Helium::Config::GetUserConfigObjectFilePath( Name name )
+Helium::FilePath Helium::Config::GetUserConfigObjectFilePath( Name name ) const
 {
 	String cacheFilePath( m_userDataDirectory.Data() );
 	cacheFilePath += m_defaultConfigPackagePath.ToFilePathString();
@@ -67,7 +188,9 @@ void Config::BeginLoad()
 	m_spDefaultConfigPackage.Release();
 
 	m_defaultConfigAssets.Clear();
+	m_configObjectNames.Clear();
 	m_configObjects.Clear();
+	UnmapCooked();
 
 	// Initiate pre-loading of the default and user configuration packages.
 	AssetLoader* pLoader = AssetLoader::GetInstance();
@@ -173,11 +296,13 @@ bool Config::TryFinishLoad()
 	}
 
 	m_configObjects.Resize( m_defaultConfigAssets.GetSize() );
+	m_configObjectNames.Resize( m_defaultConfigAssets.GetSize() );
 
 	//TODO: Do this asynchronously
 	for ( size_t index = 0; index < m_defaultConfigAssets.GetSize(); ++index )
 	{
 		const Name &name = m_defaultConfigAssets[ index ]->GetName();
+		m_configObjectNames[ index ] = name;
 		FilePath path = GetUserConfigObjectFilePath( name );
 
 		if (path.Exists())
@@ -243,6 +368,278 @@ bool Config::TryFinishLoad()
 	return true;
 }
 
+/// Get the path of the cooked configuration file for the current platform.
+///
+/// @return  Cooked configuration file path.
+///
+/// @see LoadCooked(), WriteCooked()
+Helium::FilePath Helium::Config::GetCookedConfigFilePath() const
+{
+	CacheManager* pCacheManager = CacheManager::GetInstance();
+	HELIUM_ASSERT( pCacheManager );
+
+	String cookedFilePath = pCacheManager->GetPlatformDataDirectory();
+	cookedFilePath += *m_defaultConfigPackagePath.GetName();
+	cookedFilePath += "." HELIUM_CONFIG_COOKED_EXTENSION;
+
+	return FilePath( *cookedFilePath );
+}
+
+/// Load the configuration from the cooked configuration file instead of the default configuration package.
+///
+/// The file stays mapped while the configuration is in use, and each configuration object is only deserialized the
+/// first time it is requested.  On failure the configuration is left empty, so that it can be loaded with BeginLoad()
+/// instead.
+///
+/// @return  True if the cooked configuration file was loaded, false if it is missing or invalid.
+///
+/// @see WriteCooked(), BeginLoad()
+bool Config::LoadCooked()
+{
+	if( !m_assetLoadIds.IsEmpty() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"Config::LoadCooked(): Called while configuration loading is already in progress.\n" );
+
+		return false;
+	}
+
+	m_spDefaultConfigPackage.Release();
+
+	m_defaultConfigAssets.Clear();
+	m_configObjectNames.Clear();
+	m_configObjects.Clear();
+	UnmapCooked();
+
+	FilePath cookedFilePath = GetCookedConfigFilePath();
+
+	uint64_t cookedSize = 0;
+	const uint8_t* pCookedData = MapReadOnlyFile( cookedFilePath.Data(), cookedSize );
+	if( !pCookedData )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"Config::LoadCooked(): No cooked configuration at \"%s\".\n",
+			cookedFilePath.Data() );
+
+		return false;
+	}
+
+	m_pCookedData = pCookedData;
+	m_cookedSize = cookedSize;
+
+	CookedConfigHeader header;
+	bool bValid = ( cookedSize >= sizeof( header ) );
+	if( bValid )
+	{
+		MemoryCopy( &header, pCookedData, sizeof( header ) );
+		bValid = ( header.magic == COOKED_CONFIG_MAGIC && header.version == COOKED_CONFIG_VERSION &&
+			header.sectionCount <= ( cookedSize - sizeof( header ) ) / sizeof( CookedConfigRecord ) );
+	}
+
+	if( bValid )
+	{
+		m_configObjectNames.Reserve( header.sectionCount );
+		m_cookedSections.Reserve( header.sectionCount );
+
+		const uint8_t* pRecords = pCookedData + sizeof( header );
+		for( uint32_t sectionIndex = 0; sectionIndex < header.sectionCount; ++sectionIndex )
+		{
+			CookedConfigRecord record;
+			MemoryCopy( &record, pRecords + sectionIndex * sizeof( record ), sizeof( record ) );
+
+			// Names are null-terminated, so make sure each name ends within the file.
+			if( record.nameOffset >= cookedSize || record.offset > cookedSize || record.size > cookedSize - record.offset ||
+				!memchr( pCookedData + record.nameOffset, 0, static_cast< size_t >( cookedSize - record.nameOffset ) ) )
+			{
+				bValid = false;
+				break;
+			}
+
+			m_configObjectNames.Push( Name( reinterpret_cast< const char* >( pCookedData + record.nameOffset ) ) );
+
+			CookedSection section;
+			section.offset = record.offset;
+			section.size = record.size;
+			m_cookedSections.Push( section );
+		}
+	}
+
+	if( !bValid )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"Config::LoadCooked(): Cooked configuration \"%s\" is invalid or out of date.\n",
+			cookedFilePath.Data() );
+
+		m_configObjectNames.Clear();
+		UnmapCooked();
+
+		return false;
+	}
+
+	m_configObjects.Resize( m_cookedSections.GetSize() );
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"Config::LoadCooked(): Mapped %" PRIuSZ " configuration sections from \"%s\".\n",
+		m_cookedSections.GetSize(),
+		cookedFilePath.Data() );
+
+	return true;
+}
+
+#if HELIUM_TOOLS
+/// Write the default configuration objects loaded from the default configuration package to the cooked configuration
+/// file, so that non-tools builds can load them with LoadCooked().
+///
+/// @return  True if the cooked configuration file was written, false if not.
+///
+/// @see LoadCooked()
+bool Config::WriteCooked() const
+{
+	if( IsCooked() || !m_assetLoadIds.IsEmpty() )
+	{
+		return false;
+	}
+
+	const size_t sectionCount = m_defaultConfigAssets.GetSize();
+
+	DynamicArray< uint8_t > names;
+	DynamicArray< uint8_t > data;
+	DynamicArray< CookedConfigRecord > records;
+	records.Reserve( sectionCount );
+
+	for( size_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex )
+	{
+		ConfigAsset* pDefaultConfigAsset = m_defaultConfigAssets[ sectionIndex ];
+		HELIUM_ASSERT( pDefaultConfigAsset );
+
+		Reflect::Object* pDefaultConfigObject = pDefaultConfigAsset->GetConfigObject();
+		if( !pDefaultConfigObject )
+		{
+			continue;
+		}
+
+		DynamicArray< uint8_t > objectData;
+		Cache::WriteCacheObjectToBuffer( pDefaultConfigObject, objectData );
+
+		const char* pName = *pDefaultConfigAsset->GetName();
+		const size_t nameSize = StringLength( pName ) + 1;
+
+		CookedConfigRecord* pRecord = records.New();
+		HELIUM_ASSERT( pRecord );
+		pRecord->nameOffset = static_cast< uint32_t >( names.GetSize() );
+		pRecord->offset = static_cast< uint32_t >( data.GetSize() );
+		pRecord->size = static_cast< uint32_t >( objectData.GetSize() );
+		pRecord->reserved = 0;
+
+		names.AddArray( reinterpret_cast< const uint8_t* >( pName ), nameSize );
+		data.AddArray( objectData.GetData(), objectData.GetSize() );
+	}
+
+	CookedConfigHeader header;
+	header.magic = COOKED_CONFIG_MAGIC;
+	header.version = COOKED_CONFIG_VERSION;
+	header.sectionCount = static_cast< uint32_t >( records.GetSize() );
+	header.reserved = 0;
+
+	// Rebase the name and data offsets now that the size of each table is known.
+	const size_t namesOffset = sizeof( header ) + records.GetSize() * sizeof( CookedConfigRecord );
+	const size_t dataOffset = namesOffset + names.GetSize();
+	HELIUM_ASSERT( dataOffset + data.GetSize() <= UINT32_MAX );
+	for( size_t recordIndex = 0; recordIndex < records.GetSize(); ++recordIndex )
+	{
+		records[ recordIndex ].nameOffset += static_cast< uint32_t >( namesOffset );
+		records[ recordIndex ].offset += static_cast< uint32_t >( dataOffset );
+	}
+
+	FilePath cookedFilePath = GetCookedConfigFilePath();
+	cookedFilePath.MakePath();
+
+	FileStream* pStream = FileStream::OpenFileStream( cookedFilePath.Data(), FileStream::MODE_WRITE, true );
+	if( !pStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Config::WriteCooked(): Failed to open \"%s\" for writing.\n",
+			cookedFilePath.Data() );
+
+		return false;
+	}
+
+	pStream->Write( &header, sizeof( header ), 1 );
+	pStream->Write( records.GetData(), sizeof( CookedConfigRecord ), records.GetSize() );
+	pStream->Write( names.GetData(), 1, names.GetSize() );
+	pStream->Write( data.GetData(), 1, data.GetSize() );
+	delete pStream;
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"Config::WriteCooked(): Wrote %" PRIu32 " configuration sections to \"%s\".\n",
+		header.sectionCount,
+		cookedFilePath.Data() );
+
+	return true;
+}
+#endif  // HELIUM_TOOLS
+
+/// Get the configuration object at the given index, deserializing it from the cooked configuration file if this is
+/// the first time it has been requested.
+///
+/// @param[in] index  Configuration object index.
+///
+/// @return  Configuration object, or null if it could not be loaded.
+Reflect::Object* Config::ResolveConfigObject( size_t index ) const
+{
+	HELIUM_ASSERT( index < m_configObjects.GetSize() );
+
+	Reflect::ObjectPtr& rspObject = m_configObjects[ index ];
+	if( rspObject || index >= m_cookedSections.GetSize() )
+	{
+		return rspObject.Get();
+	}
+
+	const Name &name = m_configObjectNames[ index ];
+	FilePath path = GetUserConfigObjectFilePath( name );
+	if( path.Exists() )
+	{
+		rspObject = Persist::ArchiveReader::ReadFromFile( path );
+		if( !rspObject )
+		{
+			HELIUM_TRACE( TraceLevels::Info, "User config object failed to load for \"%s\". It will be replaced with default settings.\n", *name );
+		}
+	}
+
+	if( !rspObject )
+	{
+		const CookedSection& rSection = m_cookedSections[ index ];
+		rspObject = Cache::ReadCacheObjectFromBuffer( m_pCookedData, rSection.offset, rSection.size );
+		if( !rspObject )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "Config: Failed to read cooked configuration object \"%s\".\n", *name );
+		}
+	}
+
+	return rspObject.Get();
+}
+
+/// Release the mapping of the cooked configuration file, if any.
+///
+/// Objects that were already deserialized are kept, but the sections of any that were not can no longer be read.
+void Config::UnmapCooked()
+{
+	m_cookedSections.Clear();
+
+	if( m_pCookedData )
+	{
+		UnmapReadOnlyFile( m_pCookedData, m_cookedSize );
+		m_pCookedData = NULL;
+		m_cookedSize = 0;
+	}
+}
+
 /// Get the singleton Config instance.
 ///
 /// @return  Pointer to the Config instance.
@@ -10,6 +10,8 @@
 #define HELIUM_CONFIG_DEFAULT_PACKAGE_BASE "Default"
 // User configuration base name.
 #define HELIUM_CONFIG_USER_PACKAGE_BASE "User"
+// Cooked configuration file extension.
+#define HELIUM_CONFIG_COOKED_EXTENSION "cfgbin"
 
 // Windows platform configuration suffix.
 #define HELIUM_CONFIG_PLATFORM_SUFFIX_WIN "Win"
@@ -30,6 +32,12 @@
 namespace Helium
 {
 	/// Configuration management.
+	///
+	/// Configuration objects are either loaded through the asset pipeline from the default configuration package, or
+	/// from a cooked configuration file.  The cooked file is written by tools builds once the package has loaded, and
+	/// holds each default configuration object serialized in its own section.  Loading it only maps the file and reads
+	/// the section table; each section is deserialized the first time its object is requested.  User configuration
+	/// objects still take precedence over the defaults in either case.
 	class HELIUM_ENGINE_API Config : NonCopyable
 	{
 	public:
@@ -48,10 +56,17 @@ namespace Helium
 		//@{
 		void BeginLoad();
 		bool TryFinishLoad();
+
+		bool LoadCooked();
+#if HELIUM_TOOLS
+		bool WriteCooked() const;
+#endif
+		inline bool IsCooked() const;
 		//@}
 
 		inline Name GetConfigObjectName( size_t index );
-		FilePath GetUserConfigObjectFilePath( Name name );
+		FilePath GetCookedConfigFilePath() const;
+		FilePath GetUserConfigObjectFilePath( Name name ) const;
 
 		/// @name Config Asset Access
 		//@{
@@ -68,6 +83,15 @@ namespace Helium
 		//@}
 
 	private:
+		/// Location of a configuration object within the cooked configuration file.
+		struct CookedSection
+		{
+			/// Offset of the serialized object from the start of the file.
+			uint32_t offset;
+			/// Size of the serialized object, in bytes.
+			uint32_t size;
+		};
+
 		/// FilePath for the overall configuration container package.
 		AssetPath m_configContainerPackagePath;
 		/// Default configuration package path.
@@ -80,8 +104,18 @@ namespace Helium
 
 		/// Default configuration objects
 		DynamicArray< ConfigAssetPtr > m_defaultConfigAssets;
-		/// Configuration objects (coming from user objects, or defaults if no user object is found)
-		DynamicArray< Reflect::ObjectPtr > m_configObjects;
+		/// Configuration object names, indexed the same as the configuration objects.
+		DynamicArray< Name > m_configObjectNames;
+		/// Configuration objects (coming from user objects, or defaults if no user object is found).  Objects from the
+		/// cooked configuration file are null until first requested.
+		mutable DynamicArray< Reflect::ObjectPtr > m_configObjects;
+
+		/// Cooked configuration sections, indexed the same as the configuration objects (empty if not cooked).
+		DynamicArray< CookedSection > m_cookedSections;
+		/// Mapped cooked configuration file, or null if not loaded from a cooked file.
+		const uint8_t* m_pCookedData;
+		/// Size of the mapped cooked configuration file.
+		uint64_t m_cookedSize;
 
 		/// Async object load IDs.
 		DynamicArray< size_t > m_assetLoadIds;
@@ -99,6 +133,12 @@ namespace Helium
 		Config();
 		~Config();
 		//@}
+
+		/// @name Cooked Configuration Support
+		//@{
+		Reflect::Object* ResolveConfigObject( size_t index ) const;
+		void UnmapCooked();
+		//@}
 	};
 }
 
@@ -42,12 +42,22 @@ bool Helium::Config::IsAssetPathInDefaultConfigPackage( const AssetPath &path )
 	return path.IsWithinAssetPath( m_defaultConfigPackagePath );
 }
 
+/// Get whether the configuration objects were loaded from the cooked configuration file.
+///
+/// @return  True if the configuration is cooked, false if it was loaded through the asset pipeline.
+///
+/// @see LoadCooked()
+bool Helium::Config::IsCooked() const
+{
+	return m_pCookedData != NULL;
+}
+
 /// Get the name of the config object at the given index
 ///
 /// @return  Name of the object.
 Helium::Name Helium::Config::GetConfigObjectName( size_t index )
 {
-	return m_defaultConfigAssets[ index ]->GetName();
+	return m_configObjectNames[ index ];
 }
 
 /// Get the number of loaded configuration objects.
@@ -72,7 +82,7 @@ T* Helium::Config::GetConfigObject( size_t index ) const
 {
 	HELIUM_ASSERT( index < m_configObjects.GetSize() );
 
-	Reflect::Object *pObject = m_configObjects[ index ];
+	Reflect::Object *pObject = ResolveConfigObject( index );
 	HELIUM_ASSERT( pObject );
 
 	return Reflect::AssertCast< T >( pObject );
@@ -91,11 +101,9 @@ T* Helium::Config::GetConfigObject( Name name ) const
 	size_t configObjectCount = m_configObjects.GetSize();
 	for( size_t objectIndex = 0; objectIndex < configObjectCount; ++objectIndex )
 	{
-		const Name &assetName = m_defaultConfigAssets[ objectIndex ]->GetName();
-
-		if( assetName == name )
+		if( m_configObjectNames[ objectIndex ] == name )
 		{		
-			Reflect::Object* pObject = m_configObjects[ objectIndex ];
+			Reflect::Object* pObject = ResolveConfigObject( objectIndex );
 			HELIUM_ASSERT( pObject );
 			return Reflect::AssertCast< T >( pObject );
 		}
@@ -0,0 +1,514 @@
+#include "Precompile.h"
+#include "Engine/CookedObjectLayout.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Helium;
+
+/// Cooked object data header magic number.
+static const uint32_t COOKED_OBJECT_MAGIC = 0xc00cedb5;
+
+CookedObjectLayout* CookedObjectLayout::sm_pFirst = NULL;
+
+/// Compute a 32-bit FNV-1a hash of a block of data.
+///
+/// @param[in] pData  Data to hash.
+/// @param[in] size   Data size, in bytes.
+/// @param[in] hash   Hash to continue from, or the FNV offset basis to start a new hash.
+///
+/// @return  Hash of the data.
+static uint32_t HashCookedData( const void* pData, size_t size, uint32_t hash = 2166136261U )
+{
+	const uint8_t* pBytes = static_cast< const uint8_t* >( pData );
+	for( size_t byteIndex = 0; byteIndex < size; ++byteIndex )
+	{
+		hash = ( hash ^ pBytes[ byteIndex ] ) * 16777619U;
+	}
+
+	return hash;
+}
+
+/// Append data to a buffer.
+///
+/// @param[in] rBuffer  Buffer to which to append.
+/// @param[in] pData    Data to append.
+/// @param[in] size     Number of bytes to append.
+static void AppendCookedData( DynamicArray< uint8_t >& rBuffer, const void* pData, size_t size )
+{
+	if( size != 0 )
+	{
+		rBuffer.AddArray( static_cast< const uint8_t* >( pData ), size );
+	}
+}
+
+/// Append a 32-bit value to a buffer.
+///
+/// @param[in] rBuffer  Buffer to which to append.
+/// @param[in] value    Value to append.
+static void AppendCookedValue( DynamicArray< uint8_t >& rBuffer, uint32_t value )
+{
+	AppendCookedData( rBuffer, &value, sizeof( value ) );
+}
+
+/// Read a 32-bit value from cooked data.
+///
+/// @param[in]     pData    Cooked data.
+/// @param[in]     size     Size of the cooked data.
+/// @param[in,out] rOffset  Read offset, advanced past the value if read.
+/// @param[out]    rValue   Value read.
+///
+/// @return  True if the value was read, false if the data is truncated.
+static bool ReadCookedValue( const uint8_t* pData, size_t size, size_t& rOffset, uint32_t& rValue )
+{
+	if( size - rOffset < sizeof( rValue ) )
+	{
+		return false;
+	}
+
+	memcpy( &rValue, pData + rOffset, sizeof( rValue ) );
+	rOffset += sizeof( rValue );
+
+	return true;
+}
+
+/// Member sort comparison function.
+struct CookedMemberOffsetCompare
+{
+	template< typename MemberT >
+	bool operator()( const MemberT& rMember0, const MemberT& rMember1 ) const
+	{
+		return ( rMember0.offset < rMember1.offset );
+	}
+};
+
+/// Constructor.
+///
+/// The layout is added to the list of declared layouts, but is not usable until Finalize() has been called.
+///
+/// @param[in] pTypeName             Name of the type for which this layout is declared.
+/// @param[in] pCreateCallback       Callback for creating objects of the type.
+/// @param[in] pMetaClassCallback    Callback for getting the reflected type.
+/// @param[in] pBaseAddressCallback  Callback for getting the address relative to which member offsets are computed.
+/// @param[in] objectSize            Size of the type.
+CookedObjectLayout::CookedObjectLayout(
+	const char* pTypeName,
+	CREATE_CALLBACK pCreateCallback,
+	META_CLASS_CALLBACK pMetaClassCallback,
+	BASE_ADDRESS_CALLBACK pBaseAddressCallback,
+	size_t objectSize )
+	: m_typeHash( 0 )
+	, m_layoutHash( 0 )
+	, m_pCreateCallback( pCreateCallback )
+	, m_pMetaClassCallback( pMetaClassCallback )
+	, m_pBaseAddressCallback( pBaseAddressCallback )
+	, m_objectSize( objectSize )
+	, m_fieldCount( 0 )
+	, m_pNext( sm_pFirst )
+{
+	HELIUM_ASSERT( pTypeName );
+	HELIUM_ASSERT( pCreateCallback );
+	HELIUM_ASSERT( pMetaClassCallback );
+	HELIUM_ASSERT( pBaseAddressCallback );
+
+	m_typeHash = HashCookedData( pTypeName, strlen( pTypeName ) );
+
+	sm_pFirst = this;
+}
+
+/// Write the cooked data of an object.
+///
+/// @param[in] pObject  Object of this layout's type.
+/// @param[in] rBuffer  Buffer to which to append the cooked data.
+///
+/// @see Read(), WriteObject()
+void CookedObjectLayout::Write( Reflect::Object* pObject, DynamicArray< uint8_t >& rBuffer ) const
+{
+	HELIUM_ASSERT( pObject );
+	HELIUM_ASSERT( pObject->GetMetaClass() == m_pMetaClassCallback() );
+
+	const uint8_t* pBase = static_cast< const uint8_t* >( m_pBaseAddressCallback( pObject ) );
+
+	size_t memberCount = m_members.GetSize();
+	for( size_t memberIndex = 0; memberIndex < memberCount; ++memberIndex )
+	{
+		const Member& rMember = m_members[ memberIndex ];
+		const void* pMember = pBase + rMember.offset;
+
+		switch( rMember.type )
+		{
+			case MEMBER_TYPE_PLAIN_DATA:
+			{
+				AppendCookedData( rBuffer, pMember, rMember.size );
+
+				break;
+			}
+
+			case MEMBER_TYPE_ARRAY:
+			{
+				size_t elementCount;
+				const void* pElements = rMember.pGetCallback( pMember, elementCount );
+
+				AppendCookedValue( rBuffer, static_cast< uint32_t >( elementCount ) );
+				AppendCookedData( rBuffer, pElements, elementCount * rMember.size );
+
+				break;
+			}
+
+			case MEMBER_TYPE_NAME_ARRAY:
+			{
+				const DynamicArray< Name >& rNames = *static_cast< const DynamicArray< Name >* >( pMember );
+
+				size_t nameCount = rNames.GetSize();
+				AppendCookedValue( rBuffer, static_cast< uint32_t >( nameCount ) );
+				for( size_t nameIndex = 0; nameIndex < nameCount; ++nameIndex )
+				{
+					const char* pName = rNames[ nameIndex ].Get();
+					size_t nameLength = strlen( pName );
+
+					AppendCookedValue( rBuffer, static_cast< uint32_t >( nameLength ) );
+					AppendCookedData( rBuffer, pName, nameLength + 1 );
+				}
+
+				break;
+			}
+		}
+	}
+}
+
+/// Create an object from its cooked data.
+///
+/// @param[in] pData  Cooked data, as written by Write().
+/// @param[in] size   Size of the cooked data.
+///
+/// @return  Object read, or null if the data is truncated or malformed.
+///
+/// @see Write(), ReadObject()
+Reflect::ObjectPtr CookedObjectLayout::Read( const uint8_t* pData, size_t size ) const
+{
+	HELIUM_ASSERT( pData || size == 0 );
+
+	Reflect::ObjectPtr spObject = m_pCreateCallback();
+	HELIUM_ASSERT( spObject );
+
+	uint8_t* pBase = static_cast< uint8_t* >( m_pBaseAddressCallback( spObject.Get() ) );
+
+	size_t offset = 0;
+
+	size_t memberCount = m_members.GetSize();
+	for( size_t memberIndex = 0; memberIndex < memberCount; ++memberIndex )
+	{
+		const Member& rMember = m_members[ memberIndex ];
+		void* pMember = pBase + rMember.offset;
+
+		switch( rMember.type )
+		{
+			case MEMBER_TYPE_PLAIN_DATA:
+			{
+				if( size - offset < rMember.size )
+				{
+					return Reflect::ObjectPtr();
+				}
+
+				memcpy( pMember, pData + offset, rMember.size );
+				offset += rMember.size;
+
+				break;
+			}
+
+			case MEMBER_TYPE_ARRAY:
+			{
+				uint32_t elementCount;
+				if( !ReadCookedValue( pData, size, offset, elementCount ) )
+				{
+					return Reflect::ObjectPtr();
+				}
+
+				size_t byteCount = static_cast< size_t >( elementCount ) * rMember.size;
+				if( size - offset < byteCount )
+				{
+					return Reflect::ObjectPtr();
+				}
+
+				void* pElements = rMember.pResizeCallback( pMember, elementCount );
+				if( byteCount != 0 )
+				{
+					memcpy( pElements, pData + offset, byteCount );
+				}
+
+				offset += byteCount;
+
+				break;
+			}
+
+			case MEMBER_TYPE_NAME_ARRAY:
+			{
+				uint32_t nameCount;
+				if( !ReadCookedValue( pData, size, offset, nameCount ) )
+				{
+					return Reflect::ObjectPtr();
+				}
+
+				DynamicArray< Name >& rNames = *static_cast< DynamicArray< Name >* >( pMember );
+				rNames.Clear();
+				rNames.Reserve( nameCount );
+
+				for( uint32_t nameIndex = 0; nameIndex < nameCount; ++nameIndex )
+				{
+					uint32_t nameLength;
+					if( !ReadCookedValue( pData, size, offset, nameLength ) ||
+						size - offset <= nameLength ||
+						pData[ offset + nameLength ] != '\0' )
+					{
+						return Reflect::ObjectPtr();
+					}
+
+					rNames.Push( Name( reinterpret_cast< const char* >( pData + offset ) ) );
+					offset += nameLength + 1;
+				}
+
+				break;
+			}
+		}
+	}
+
+	if( offset != size )
+	{
+		return Reflect::ObjectPtr();
+	}
+
+	return spObject;
+}
+
+/// Find the cooked layout declared for a given type.
+///
+/// @param[in] pType  Object type.
+///
+/// @return  Cooked layout, or null if the type does not have one.
+const CookedObjectLayout* CookedObjectLayout::Find( const Reflect::MetaClass* pType )
+{
+	for( const CookedObjectLayout* pLayout = sm_pFirst; pLayout != NULL; pLayout = pLayout->m_pNext )
+	{
+		if( pLayout->m_pMetaClassCallback() == pType )
+		{
+			return pLayout;
+		}
+	}
+
+	return NULL;
+}
+
+/// Find the cooked layout declared for the type with a given name hash.
+///
+/// @param[in] typeHash  Type name hash, as stored in the cooked data header.
+///
+/// @return  Cooked layout, or null if no layout matches.
+const CookedObjectLayout* CookedObjectLayout::Find( uint32_t typeHash )
+{
+	for( const CookedObjectLayout* pLayout = sm_pFirst; pLayout != NULL; pLayout = pLayout->m_pNext )
+	{
+		if( pLayout->m_typeHash == typeHash )
+		{
+			return pLayout;
+		}
+	}
+
+	return NULL;
+}
+
+/// Write the cooked data header and cooked data for an object if its type has a cooked layout.
+///
+/// The generic archive data for the object must be appended to the buffer right after the cooked data, so that it can
+/// be read instead if the layout changes.
+///
+/// @param[in] pObject  Object to write.
+/// @param[in] rBuffer  Buffer to which to append the cooked data.
+///
+/// @return  True if cooked data was written, false if the object type has no usable cooked layout.
+///
+/// @see ReadObject()
+bool CookedObjectLayout::WriteObject( Reflect::Object* pObject, DynamicArray< uint8_t >& rBuffer )
+{
+	HELIUM_ASSERT( pObject );
+
+	const CookedObjectLayout* pLayout = Find( pObject->GetMetaClass() );
+	if( !pLayout )
+	{
+		return false;
+	}
+
+	// Fields missing from the layout would silently be lost, so only use the layout if it covers every field.
+	if( !pLayout->CoversAllFields() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"CookedObjectLayout::WriteObject(): Layout for type \"%s\" does not list all of its fields.  Objects of "
+			"this type will only be cached in the generic format.\n",
+			pObject->GetMetaClass()->m_Name );
+
+		return false;
+	}
+
+	size_t headerOffset = rBuffer.GetSize();
+	AppendCookedValue( rBuffer, COOKED_OBJECT_MAGIC );
+	AppendCookedValue( rBuffer, pLayout->m_typeHash );
+	AppendCookedValue( rBuffer, pLayout->m_layoutHash );
+	AppendCookedValue( rBuffer, 0 );
+	HELIUM_ASSERT( rBuffer.GetSize() - headerOffset == HEADER_SIZE );
+
+	pLayout->Write( pObject, rBuffer );
+
+	uint32_t cookedSize = static_cast< uint32_t >( rBuffer.GetSize() - headerOffset - HEADER_SIZE );
+	memcpy( rBuffer.GetData() + headerOffset + HEADER_SIZE - sizeof( cookedSize ), &cookedSize, sizeof( cookedSize ) );
+
+	return true;
+}
+
+/// Read an object from its cooked data, if the given buffer starts with cooked data for a type whose layout still
+/// matches.
+///
+/// @param[in]  pBuffer         Cached object data.
+/// @param[in]  size            Size of the cached object data.
+/// @param[out] rGenericOffset  Offset of the generic archive data in the buffer (zero if the buffer contains no
+///                             cooked data).
+///
+/// @return  Object read, or null if the buffer contains no usable cooked data, in which case the object should be
+///          read from the generic archive data at the returned offset instead.
+///
+/// @see WriteObject()
+Reflect::ObjectPtr CookedObjectLayout::ReadObject( const uint8_t* pBuffer, size_t size, size_t& rGenericOffset )
+{
+	HELIUM_ASSERT( pBuffer || size == 0 );
+
+	rGenericOffset = 0;
+
+	size_t offset = 0;
+	uint32_t magic;
+	if( !ReadCookedValue( pBuffer, size, offset, magic ) || magic != COOKED_OBJECT_MAGIC || size < HEADER_SIZE )
+	{
+		return Reflect::ObjectPtr();
+	}
+
+	uint32_t typeHash, layoutHash, cookedSize;
+	ReadCookedValue( pBuffer, size, offset, typeHash );
+	ReadCookedValue( pBuffer, size, offset, layoutHash );
+	ReadCookedValue( pBuffer, size, offset, cookedSize );
+	HELIUM_ASSERT( offset == HEADER_SIZE );
+
+	if( size - HEADER_SIZE < cookedSize )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "CookedObjectLayout::ReadObject(): Cooked object data is truncated.\n" );
+
+		rGenericOffset = size;
+
+		return Reflect::ObjectPtr();
+	}
+
+	rGenericOffset = HEADER_SIZE + cookedSize;
+
+	const CookedObjectLayout* pLayout = Find( typeHash );
+	if( !pLayout || pLayout->m_layoutHash != layoutHash )
+	{
+		return Reflect::ObjectPtr();
+	}
+
+	Reflect::ObjectPtr spObject = pLayout->Read( pBuffer + HEADER_SIZE, cookedSize );
+	if( !spObject )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"CookedObjectLayout::ReadObject(): Malformed cooked object data.  Reading the generic data instead.\n" );
+	}
+
+	return spObject;
+}
+
+/// Sort the layout members by offset, coalesce adjacent plain data members into runs, and compute the layout hash.
+///
+/// This is called once all members have been added.
+void CookedObjectLayout::Finalize()
+{
+	std::sort( m_members.GetData(), m_members.GetData() + m_members.GetSize(), CookedMemberOffsetCompare() );
+
+	size_t memberCount = m_members.GetSize();
+	size_t runCount = 0;
+	for( size_t memberIndex = 0; memberIndex < memberCount; ++memberIndex )
+	{
+		const Member& rMember = m_members[ memberIndex ];
+		if( runCount != 0 )
+		{
+			Member& rRun = m_members[ runCount - 1 ];
+			if( rRun.type == MEMBER_TYPE_PLAIN_DATA && rMember.type == MEMBER_TYPE_PLAIN_DATA &&
+				rRun.offset + rRun.size == rMember.offset )
+			{
+				rRun.size += rMember.size;
+
+				continue;
+			}
+		}
+
+		m_members[ runCount ] = rMember;
+		++runCount;
+	}
+
+	m_members.Resize( runCount );
+	m_members.Trim();
+
+	// Any change to the type's size, member placement, or pointer size invalidates previously cooked data.
+	uint32_t objectSize = static_cast< uint32_t >( m_objectSize );
+	uint32_t pointerSize = static_cast< uint32_t >( sizeof( void* ) );
+
+	uint32_t hash = HashCookedData( &objectSize, sizeof( objectSize ) );
+	hash = HashCookedData( &pointerSize, sizeof( pointerSize ), hash );
+	for( size_t memberIndex = 0; memberIndex < runCount; ++memberIndex )
+	{
+		const Member& rMember = m_members[ memberIndex ];
+
+		uint32_t memberData[] = { static_cast< uint32_t >( rMember.type ), rMember.offset, rMember.size };
+		hash = HashCookedData( memberData, sizeof( memberData ), hash );
+	}
+
+	m_layoutHash = hash;
+}
+
+/// Add a member to this layout.
+///
+/// @param[in] type             Member type.
+/// @param[in] offset           Member offset.
+/// @param[in] size             Member size, or array element size.
+/// @param[in] pResizeCallback  Array resize callback (plain data arrays only).
+/// @param[in] pGetCallback     Array access callback (plain data arrays only).
+void CookedObjectLayout::AddMember(
+	EMemberType type,
+	size_t offset,
+	size_t size,
+	RESIZE_ARRAY_CALLBACK pResizeCallback,
+	GET_ARRAY_CALLBACK pGetCallback )
+{
+	HELIUM_ASSERT( offset + size <= m_objectSize || type != MEMBER_TYPE_PLAIN_DATA );
+	HELIUM_ASSERT( ( type == MEMBER_TYPE_ARRAY ) == ( pResizeCallback != NULL && pGetCallback != NULL ) );
+
+	Member* pMember = m_members.New();
+	HELIUM_ASSERT( pMember );
+	pMember->type = type;
+	pMember->offset = static_cast< uint32_t >( offset );
+	pMember->size = static_cast< uint32_t >( size );
+	pMember->pResizeCallback = pResizeCallback;
+	pMember->pGetCallback = pGetCallback;
+
+	++m_fieldCount;
+}
+
+/// Check whether this layout lists every field reflected by its type.
+///
+/// @return  True if the number of fields added to this layout matches the number of reflected fields.
+bool CookedObjectLayout::CoversAllFields() const
+{
+	size_t reflectedFieldCount = 0;
+	for( const Reflect::MetaStruct* pStruct = m_pMetaClassCallback(); pStruct != NULL; pStruct = pStruct->m_Base )
+	{
+		reflectedFieldCount += pStruct->m_Fields.GetSize();
+	}
+
+	return ( reflectedFieldCount == m_fieldCount );
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/Name.h"
+#include "Reflect/Object.h"
+
+/// Declare the cooked binary layout of a reflected object type.  Use at global scope in the type's source file, next to
+/// its HELIUM_DEFINE_CLASS().  The type must provide a static PopulateCookedLayout( CookedObjectLayout& ) function
+/// listing every field it registers in PopulateMetaType().
+#define HELIUM_DEFINE_COOKED_LAYOUT( TYPE ) \
+	static const Helium::CookedObjectLayoutT< TYPE > HELIUM_COOKED_LAYOUT_NAME( __LINE__ )( #TYPE );
+
+#define HELIUM_COOKED_LAYOUT_NAME( LINE ) HELIUM_COOKED_LAYOUT_NAME_2( LINE )
+#define HELIUM_COOKED_LAYOUT_NAME_2( LINE ) g_CookedLayout##LINE
+
+namespace Helium
+{
+	/// Cooked binary layout of a reflected object type, used to deserialize cached objects without going through the
+	/// generic Persist archive readers.
+	///
+	/// Generic archives store each field by name, so reading an object back means looking up every field in its
+	/// Reflect::MetaStruct and converting its value through the field's translator.  Types with a cooked layout are
+	/// also cached as the raw bytes of their fields: adjacent plain data fields are coalesced into runs copied with a
+	/// single memcpy, arrays of plain data are resized and filled in one copy, and name arrays are rebuilt from a string
+	/// table.  The generic archive data is still written after the cooked data, and is read instead whenever the
+	/// layout of the type no longer matches the one the data was cooked with (see ReadObject()).
+	///
+	/// Cooked layouts only cover fields holding plain data (no pointers, strings, or object references) and arrays of
+	/// such data, and only types deriving from Reflect::Object through single inheritance.
+	class HELIUM_ENGINE_API CookedObjectLayout : NonCopyable
+	{
+	public:
+		/// Number of bytes in the header preceding cooked object data.
+		static const size_t HEADER_SIZE = 16;
+
+		/// Object creation callback.
+		typedef Reflect::ObjectPtr ( *CREATE_CALLBACK )();
+		/// Object type lookup callback.
+		typedef const Reflect::MetaClass* ( *META_CLASS_CALLBACK )();
+		/// Callback converting an object pointer to the address of the type the layout offsets are relative to.
+		typedef void* ( *BASE_ADDRESS_CALLBACK )( Reflect::Object* pObject );
+		/// Array resize callback, returning the address of the array elements.
+		typedef void* ( *RESIZE_ARRAY_CALLBACK )( void* pArray, size_t count );
+		/// Array access callback, returning the address of the array elements and their count.
+		typedef const void* ( *GET_ARRAY_CALLBACK )( const void* pArray, size_t& rCount );
+
+		/// @name Construction/Destruction
+		//@{
+		CookedObjectLayout(
+			const char* pTypeName, CREATE_CALLBACK pCreateCallback, META_CLASS_CALLBACK pMetaClassCallback,
+			BASE_ADDRESS_CALLBACK pBaseAddressCallback, size_t objectSize );
+		//@}
+
+		/// @name Layout Definition
+		//@{
+		template< typename ClassT, typename T > void AddPlainData( T ClassT::* pMember );
+		template< typename ClassT, typename T > void AddArray( DynamicArray< T > ClassT::* pMember );
+		template< typename ClassT > void AddNameArray( DynamicArray< Name > ClassT::* pMember );
+		//@}
+
+		/// @name Serialization
+		//@{
+		void Write( Reflect::Object* pObject, DynamicArray< uint8_t >& rBuffer ) const;
+		Reflect::ObjectPtr Read( const uint8_t* pData, size_t size ) const;
+		//@}
+
+		/// @name Static Functions
+		//@{
+		static const CookedObjectLayout* Find( const Reflect::MetaClass* pType );
+		static const CookedObjectLayout* Find( uint32_t typeHash );
+
+		static bool WriteObject( Reflect::Object* pObject, DynamicArray< uint8_t >& rBuffer );
+		static Reflect::ObjectPtr ReadObject( const uint8_t* pBuffer, size_t size, size_t& rGenericOffset );
+		//@}
+
+	protected:
+		/// @name Layout Finalization
+		//@{
+		void Finalize();
+		//@}
+
+	private:
+		/// Member types.
+		enum EMemberType
+		{
+			/// Plain data run.
+			MEMBER_TYPE_PLAIN_DATA,
+			/// DynamicArray of plain data.
+			MEMBER_TYPE_ARRAY,
+			/// DynamicArray of names.
+			MEMBER_TYPE_NAME_ARRAY
+		};
+
+		/// Cooked object member.
+		struct Member
+		{
+			/// Member type.
+			EMemberType type;
+			/// Byte offset of the member in the object.
+			uint32_t offset;
+			/// Size of the plain data run, or of each array element.
+			uint32_t size;
+			/// Array resize callback (plain data arrays only).
+			RESIZE_ARRAY_CALLBACK pResizeCallback;
+			/// Array access callback (plain data arrays only).
+			GET_ARRAY_CALLBACK pGetCallback;
+		};
+
+		/// Hash of the type name, used to look up the layout when reading cooked data.
+		uint32_t m_typeHash;
+		/// Hash of the member offsets, sizes, and types, used to detect data cooked with a different layout.
+		uint32_t m_layoutHash;
+
+		/// Object creation callback.
+		CREATE_CALLBACK m_pCreateCallback;
+		/// Object type lookup callback.
+		META_CLASS_CALLBACK m_pMetaClassCallback;
+		/// Object base address callback.
+		BASE_ADDRESS_CALLBACK m_pBaseAddressCallback;
+		/// Size of the object type.
+		size_t m_objectSize;
+
+		/// Members in the order in which they are cooked.
+		DynamicArray< Member > m_members;
+		/// Number of fields added to the layout (before coalescing plain data runs).
+		size_t m_fieldCount;
+
+		/// Next layout in the list of declared layouts.
+		CookedObjectLayout* m_pNext;
+
+		/// Head of the list of declared layouts.
+		static CookedObjectLayout* sm_pFirst;
+
+		/// @name Private Utility Functions
+		//@{
+		void AddMember(
+			EMemberType type, size_t offset, size_t size, RESIZE_ARRAY_CALLBACK pResizeCallback = NULL,
+			GET_ARRAY_CALLBACK pGetCallback = NULL );
+		bool CoversAllFields() const;
+		//@}
+	};
+
+	/// Cooked binary layout declared for a specific type (see HELIUM_DEFINE_COOKED_LAYOUT()).
+	template< typename ClassT >
+	class CookedObjectLayoutT : public CookedObjectLayout
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		explicit CookedObjectLayoutT( const char* pTypeName );
+		//@}
+
+	private:
+		/// @name Callbacks
+		//@{
+		static Reflect::ObjectPtr Create();
+		static const Reflect::MetaClass* GetMetaClass();
+		static void* GetBaseAddress( Reflect::Object* pObject );
+		//@}
+	};
+}
+
+#include "Engine/CookedObjectLayout.inl"
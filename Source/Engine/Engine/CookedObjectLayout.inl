@@ -0,0 +1,124 @@
+namespace Helium
+{
+	/// Get the byte offset of a member variable within its class.
+	///
+	/// @param[in] pMember  Member pointer.
+	///
+	/// @return  Member offset.
+	template< typename ClassT, typename T >
+	size_t GetCookedMemberOffset( T ClassT::* pMember )
+	{
+		// Use a non-null base address to keep the compiler from folding away the null object.
+		static const uintptr_t BASE_ADDRESS = 0x1000;
+
+		const ClassT* pObject = reinterpret_cast< const ClassT* >( BASE_ADDRESS );
+
+		return reinterpret_cast< uintptr_t >( &( pObject->*pMember ) ) - BASE_ADDRESS;
+	}
+
+	/// Resize a plain data array.
+	///
+	/// @param[in] pArray  Array to resize.
+	/// @param[in] count   New element count.
+	///
+	/// @return  Address of the array elements.
+	template< typename T >
+	void* ResizeCookedArray( void* pArray, size_t count )
+	{
+		DynamicArray< T >& rArray = *static_cast< DynamicArray< T >* >( pArray );
+		rArray.Reserve( count );
+		rArray.Resize( count );
+
+		return rArray.GetData();
+	}
+
+	/// Get the contents of a plain data array.
+	///
+	/// @param[in]  pArray  Array to access.
+	/// @param[out] rCount  Element count.
+	///
+	/// @return  Address of the array elements.
+	template< typename T >
+	const void* GetCookedArray( const void* pArray, size_t& rCount )
+	{
+		const DynamicArray< T >& rArray = *static_cast< const DynamicArray< T >* >( pArray );
+		rCount = rArray.GetSize();
+
+		return rArray.GetData();
+	}
+
+	/// Add a plain data member to this layout.
+	///
+	/// @param[in] pMember  Member pointer.  The member type must be trivially copyable.
+	///
+	/// @see AddArray(), AddNameArray()
+	template< typename ClassT, typename T >
+	void CookedObjectLayout::AddPlainData( T ClassT::* pMember )
+	{
+		AddMember( MEMBER_TYPE_PLAIN_DATA, GetCookedMemberOffset( pMember ), sizeof( T ) );
+	}
+
+	/// Add an array of plain data to this layout.
+	///
+	/// @param[in] pMember  Member pointer.  The array element type must be trivially copyable.
+	///
+	/// @see AddPlainData(), AddNameArray()
+	template< typename ClassT, typename T >
+	void CookedObjectLayout::AddArray( DynamicArray< T > ClassT::* pMember )
+	{
+		AddMember(
+			MEMBER_TYPE_ARRAY, GetCookedMemberOffset( pMember ), sizeof( T ), ResizeCookedArray< T >,
+			GetCookedArray< T > );
+	}
+
+	/// Add an array of names to this layout.
+	///
+	/// @param[in] pMember  Member pointer.
+	///
+	/// @see AddPlainData(), AddArray()
+	template< typename ClassT >
+	void CookedObjectLayout::AddNameArray( DynamicArray< Name > ClassT::* pMember )
+	{
+		AddMember( MEMBER_TYPE_NAME_ARRAY, GetCookedMemberOffset( pMember ), sizeof( Name ) );
+	}
+
+	/// Constructor.
+	///
+	/// @param[in] pTypeName  Name of the type, as given to HELIUM_DEFINE_COOKED_LAYOUT().
+	template< typename ClassT >
+	CookedObjectLayoutT< ClassT >::CookedObjectLayoutT( const char* pTypeName )
+		: CookedObjectLayout( pTypeName, Create, GetMetaClass, GetBaseAddress, sizeof( ClassT ) )
+	{
+		ClassT::PopulateCookedLayout( *this );
+		Finalize();
+	}
+
+	/// Create an object of this layout's type.
+	///
+	/// @return  Newly created object.
+	template< typename ClassT >
+	Reflect::ObjectPtr CookedObjectLayoutT< ClassT >::Create()
+	{
+		return ClassT::CreateObject();
+	}
+
+	/// Get the reflected type of this layout's type.
+	///
+	/// @return  Type meta-class.
+	template< typename ClassT >
+	const Reflect::MetaClass* CookedObjectLayoutT< ClassT >::GetMetaClass()
+	{
+		return Reflect::GetMetaClass< ClassT >();
+	}
+
+	/// Get the address of an object relative to which member offsets are computed.
+	///
+	/// @param[in] pObject  Object of this layout's type.
+	///
+	/// @return  Object address.
+	template< typename ClassT >
+	void* CookedObjectLayoutT< ClassT >::GetBaseAddress( Reflect::Object* pObject )
+	{
+		return static_cast< ClassT* >( pObject );
+	}
+}
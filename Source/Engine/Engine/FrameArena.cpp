@@ -0,0 +1,397 @@
+#include "Precompile.h"
+#include "Engine/FrameArena.h"
+
+#include "Engine/MemoryTelemetry.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
+#include "Platform/MemoryHeap.h"
+
+#include "Foundation/DynamicArray.h"
+
+using namespace Helium;
+
+volatile int32_t FrameArena::sm_frameIndex = 0;
+
+namespace
+{
+	/// Block of arena memory, followed by the memory itself.
+	struct Block
+	{
+		/// Next block of the buffer, or null if this is the last one.
+		Block* pNext;
+		/// Number of bytes of memory following the block header.
+		size_t size;
+	};
+
+	/// Memory of a thread for one frame parity.
+	struct Buffer
+	{
+		/// First block of memory, or null if none has been allocated yet.
+		Block* pFirstBlock;
+		/// Block currently allocated from.
+		Block* pCurrentBlock;
+		/// Next free byte of the current block.
+		uint8_t* pCursor;
+		/// End of the current block.
+		uint8_t* pEnd;
+		/// Most recent allocation, which can be resized in place or rolled back.
+		void* pLastAllocation;
+		/// Frame the buffer is being used for.
+		uint32_t frameIndex;
+	};
+
+	/// Frame arena buffers of a single thread.  Only the owning thread ever touches them.
+	struct ThreadArena
+	{
+		/// Buffers for even and odd frames.
+		Buffer buffers[ 2 ];
+	};
+
+	/// Registered thread arenas, only released on shutdown.
+	DynamicArray< ThreadArena* > s_threadArenas;
+	/// Lock for the list of thread arenas (not taken while allocating).
+	Mutex s_threadArenaLock;
+
+	/// Arena for the current thread, created when the thread first allocates.
+	thread_local ThreadArena* s_pCurrentThreadArena = NULL;
+
+	/// Get the memory telemetry tracker for arena blocks.
+	uint32_t GetMemoryTracker()
+	{
+		return MemoryTelemetry::GetTracker( MemoryTelemetry::CATEGORY_HEAP, Name( "FrameArena" ) );
+	}
+
+	/// Allocate a block of arena memory.
+	Block* AllocateBlock( size_t size )
+	{
+		Block* pBlock = static_cast< Block* >( DefaultAllocator().AllocateAligned(
+			FrameArena::DEFAULT_ALIGNMENT,
+			sizeof( Block ) + size ) );
+		if( pBlock )
+		{
+			pBlock->pNext = NULL;
+			pBlock->size = size;
+
+			MemoryTelemetry::RecordAllocation( GetMemoryTracker(), sizeof( Block ) + size );
+		}
+
+		return pBlock;
+	}
+
+	/// Free all of the blocks of a buffer.
+	void FreeBlocks( Buffer& rBuffer )
+	{
+		Block* pBlock = rBuffer.pFirstBlock;
+		while( pBlock )
+		{
+			Block* pNext = pBlock->pNext;
+			MemoryTelemetry::RecordFree( GetMemoryTracker(), sizeof( Block ) + pBlock->size );
+			DefaultAllocator().FreeAligned( pBlock );
+			pBlock = pNext;
+		}
+
+		rBuffer.pFirstBlock = NULL;
+		rBuffer.pCurrentBlock = NULL;
+		rBuffer.pCursor = NULL;
+		rBuffer.pEnd = NULL;
+		rBuffer.pLastAllocation = NULL;
+	}
+
+	/// Start allocating from a block.
+	void SetCurrentBlock( Buffer& rBuffer, Block* pBlock )
+	{
+		rBuffer.pCurrentBlock = pBlock;
+		rBuffer.pCursor = reinterpret_cast< uint8_t* >( pBlock + 1 );
+		rBuffer.pEnd = rBuffer.pCursor + pBlock->size;
+	}
+
+	/// Release everything allocated from a buffer so it can be used for a new frame.
+	void ResetBuffer( Buffer& rBuffer, uint32_t frameIndex )
+	{
+		rBuffer.frameIndex = frameIndex;
+		rBuffer.pLastAllocation = NULL;
+
+		if( !rBuffer.pFirstBlock )
+		{
+			return;
+		}
+
+		// Replace the blocks of a buffer that overflowed with a single block large enough for all of them, so the
+		// same amount of data fits without allocating any more blocks.
+		if( rBuffer.pFirstBlock->pNext )
+		{
+			size_t totalSize = 0;
+			for( Block* pBlock = rBuffer.pFirstBlock; pBlock; pBlock = pBlock->pNext )
+			{
+				totalSize += pBlock->size;
+			}
+
+			FreeBlocks( rBuffer );
+
+			rBuffer.pFirstBlock = AllocateBlock( totalSize );
+			if( !rBuffer.pFirstBlock )
+			{
+				return;
+			}
+		}
+
+		SetCurrentBlock( rBuffer, rBuffer.pFirstBlock );
+	}
+
+	/// Get the buffer of the current thread for the current frame, registering an arena for the thread if needed.
+	Buffer& GetCurrentBuffer()
+	{
+		ThreadArena* pArena = s_pCurrentThreadArena;
+		if( !pArena )
+		{
+			pArena = new ThreadArena;
+			HELIUM_ASSERT( pArena );
+			MemoryZero( pArena, sizeof( *pArena ) );
+
+			MutexScopeLock scopeLock( s_threadArenaLock );
+			s_threadArenas.Push( pArena );
+
+			s_pCurrentThreadArena = pArena;
+		}
+
+		uint32_t frameIndex = FrameArena::GetFrameIndex();
+		Buffer& rBuffer = pArena->buffers[ frameIndex & 1 ];
+		if( rBuffer.frameIndex != frameIndex )
+		{
+			ResetBuffer( rBuffer, frameIndex );
+		}
+
+		return rBuffer;
+	}
+
+	/// Get the address of the size stored in front of an allocation.
+	size_t* GetSizeHeader( void* pMemory )
+	{
+		return static_cast< size_t* >( pMemory ) - 1;
+	}
+
+	/// Allocate from the current block of a buffer.
+	void* AllocateFromCurrentBlock( Buffer& rBuffer, size_t alignment, size_t size )
+	{
+		if( !rBuffer.pCursor )
+		{
+			return NULL;
+		}
+
+		uintptr_t address = reinterpret_cast< uintptr_t >( rBuffer.pCursor ) + sizeof( size_t );
+		address = ( address + alignment - 1 ) & ~static_cast< uintptr_t >( alignment - 1 );
+
+		uint8_t* pMemory = reinterpret_cast< uint8_t* >( address );
+		if( pMemory > rBuffer.pEnd || size > static_cast< size_t >( rBuffer.pEnd - pMemory ) )
+		{
+			return NULL;
+		}
+
+		*GetSizeHeader( pMemory ) = size;
+		rBuffer.pCursor = pMemory + size;
+		rBuffer.pLastAllocation = pMemory;
+
+		return pMemory;
+	}
+}
+
+/// Release the arena memory of all threads.
+///
+/// No thread may allocate from the arena during or after shutdown.
+void FrameArena::Shutdown()
+{
+	MutexScopeLock scopeLock( s_threadArenaLock );
+
+	size_t arenaCount = s_threadArenas.GetSize();
+	for( size_t arenaIndex = 0; arenaIndex < arenaCount; ++arenaIndex )
+	{
+		ThreadArena* pArena = s_threadArenas[ arenaIndex ];
+		HELIUM_ASSERT( pArena );
+
+		FreeBlocks( pArena->buffers[ 0 ] );
+		FreeBlocks( pArena->buffers[ 1 ] );
+		delete pArena;
+	}
+
+	s_threadArenas.Clear();
+	s_pCurrentThreadArena = NULL;
+}
+
+/// Advance to the next frame.
+///
+/// This releases the memory allocated two frames ago (memory allocated during the frame that is ending remains valid
+/// until the end of the frame that is beginning).  Must be called from the main thread while no other threads are
+/// allocating from the arena.
+///
+/// @see GetFrameIndex()
+void FrameArena::BeginFrame()
+{
+	AtomicIncrementRelease( sm_frameIndex );
+}
+
+/// Allocate a block of memory from the current thread's arena.
+///
+/// @param[in] size  Number of bytes to allocate.
+///
+/// @return  Base address of the allocation if successful, null if allocation failed.
+///
+/// @see AllocateAligned(), Reallocate(), Free()
+void* FrameArena::Allocate( size_t size )
+{
+	return AllocateAligned( DEFAULT_ALIGNMENT, size );
+}
+
+/// Allocate an aligned block of memory from the current thread's arena.
+///
+/// @param[in] alignment  Allocation alignment (must be a power of two).
+/// @param[in] size       Number of bytes to allocate.
+///
+/// @return  Base address of the allocation if successful, null if allocation failed.
+///
+/// @see Allocate(), ReallocateAligned(), Free()
+void* FrameArena::AllocateAligned( size_t alignment, size_t size )
+{
+	HELIUM_ASSERT( ( alignment & ( alignment - 1 ) ) == 0 );
+	alignment = Max( alignment, DEFAULT_ALIGNMENT );
+
+	Buffer& rBuffer = GetCurrentBuffer();
+
+	void* pMemory = AllocateFromCurrentBlock( rBuffer, alignment, size );
+	if( pMemory )
+	{
+		return pMemory;
+	}
+
+	// Out of space, add another block large enough for the allocation.
+	Block* pBlock = AllocateBlock( Max( BLOCK_SIZE, size + alignment + sizeof( size_t ) ) );
+	if( !pBlock )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"FrameArena::AllocateAligned(): Failed to allocate a block for %" PRIuSZ " bytes.\n",
+			size );
+
+		return NULL;
+	}
+
+	if( rBuffer.pCurrentBlock )
+	{
+		HELIUM_ASSERT( !rBuffer.pCurrentBlock->pNext );
+		rBuffer.pCurrentBlock->pNext = pBlock;
+	}
+	else
+	{
+		rBuffer.pFirstBlock = pBlock;
+	}
+
+	SetCurrentBlock( rBuffer, pBlock );
+
+	pMemory = AllocateFromCurrentBlock( rBuffer, alignment, size );
+	HELIUM_ASSERT( pMemory );
+
+	return pMemory;
+}
+
+/// Resize a block of memory allocated from the arena.
+///
+/// @param[in] pMemory  Base address of the allocation to resize (can be null).
+/// @param[in] size     New allocation size, in bytes.
+///
+/// @return  Base address of the resized allocation if successful, null if reallocation failed.
+///
+/// @see ReallocateAligned(), Allocate(), Free()
+void* FrameArena::Reallocate( void* pMemory, size_t size )
+{
+	return ReallocateAligned( pMemory, DEFAULT_ALIGNMENT, size );
+}
+
+/// Resize an aligned block of memory allocated from the arena.
+///
+/// The most recent allocation of the calling thread is resized in place if it fits, any other allocation is copied to
+/// a new allocation when growing.
+///
+/// @param[in] pMemory    Base address of the allocation to resize (can be null).
+/// @param[in] alignment  Allocation alignment (must be a power of two).
+/// @param[in] size       New allocation size, in bytes.
+///
+/// @return  Base address of the resized allocation if successful, null if reallocation failed.
+///
+/// @see Reallocate(), AllocateAligned(), Free()
+void* FrameArena::ReallocateAligned( void* pMemory, size_t alignment, size_t size )
+{
+	if( !pMemory )
+	{
+		return AllocateAligned( alignment, size );
+	}
+
+	if( size == 0 )
+	{
+		Free( pMemory );
+
+		return NULL;
+	}
+
+	alignment = Max( alignment, DEFAULT_ALIGNMENT );
+	bool bAligned = ( ( reinterpret_cast< uintptr_t >( pMemory ) & ( alignment - 1 ) ) == 0 );
+
+	Buffer& rBuffer = GetCurrentBuffer();
+
+	size_t* pSize = GetSizeHeader( pMemory );
+	if( bAligned && pMemory == rBuffer.pLastAllocation && size <= static_cast< size_t >( rBuffer.pEnd - static_cast< uint8_t* >( pMemory ) ) )
+	{
+		*pSize = size;
+		rBuffer.pCursor = static_cast< uint8_t* >( pMemory ) + size;
+
+		return pMemory;
+	}
+
+	size_t oldSize = *pSize;
+	if( bAligned && size <= oldSize )
+	{
+		return pMemory;
+	}
+
+	void* pNewMemory = AllocateAligned( alignment, size );
+	if( pNewMemory )
+	{
+		MemoryCopy( pNewMemory, pMemory, Min( oldSize, size ) );
+	}
+
+	return pNewMemory;
+}
+
+/// Free a block of memory allocated from the arena.
+///
+/// Only the most recent allocation of the calling thread is actually released, the memory of any other allocation is
+/// reclaimed along with the rest of its frame.
+///
+/// @param[in] pMemory  Base address of the allocation to free (can be null).
+///
+/// @see Allocate(), Reallocate()
+void FrameArena::Free( void* pMemory )
+{
+	if( !pMemory )
+	{
+		return;
+	}
+
+	Buffer& rBuffer = GetCurrentBuffer();
+	if( pMemory == rBuffer.pLastAllocation )
+	{
+		rBuffer.pCursor = reinterpret_cast< uint8_t* >( GetSizeHeader( pMemory ) );
+		rBuffer.pLastAllocation = NULL;
+	}
+}
+
+/// Get the size of a block of memory allocated from the arena.
+///
+/// @param[in] pMemory  Base address of the allocation.
+///
+/// @return  Allocation size, in bytes.
+size_t FrameArena::GetMemorySize( void* pMemory )
+{
+	HELIUM_ASSERT( pMemory );
+
+	return *GetSizeHeader( pMemory );
+}
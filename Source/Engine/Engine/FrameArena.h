@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+namespace Helium
+{
+	/// Linear allocator for transient per-frame data.
+	///
+	/// Each thread allocates from its own pair of buffers, so allocating takes no locks.  Allocations are served by
+	/// bumping a cursor, and are all released at once when their buffer is reused: the buffers alternate every frame,
+	/// so memory allocated during a frame stays valid until the end of the following frame.  Buffers that overflowed
+	/// are coalesced into a single block when reused, so after the first few frames no general heap allocations are
+	/// made at all.
+	///
+	/// Individual frees are ignored, except for the most recent allocation of the calling thread, which is rolled back
+	/// (this lets a growing array reallocate in place).
+	///
+	/// @see FrameAllocator
+	class HELIUM_ENGINE_API FrameArena
+	{
+	public:
+		/// Default size of each block of arena memory.
+		static const size_t BLOCK_SIZE = 256 * 1024;
+		/// Alignment of allocations made without an explicit alignment.
+		static const size_t DEFAULT_ALIGNMENT = 16;
+
+		/// @name Initialization
+		//@{
+		static void Shutdown();
+		//@}
+
+		/// @name Frame Boundaries
+		//@{
+		static void BeginFrame();
+		inline static uint32_t GetFrameIndex();
+		//@}
+
+		/// @name Allocation
+		//@{
+		static void* Allocate( size_t size );
+		static void* AllocateAligned( size_t alignment, size_t size );
+		static void* Reallocate( void* pMemory, size_t size );
+		static void* ReallocateAligned( void* pMemory, size_t alignment, size_t size );
+		static void Free( void* pMemory );
+		static size_t GetMemorySize( void* pMemory );
+		//@}
+
+	private:
+		/// Index of the current frame.
+		static volatile int32_t sm_frameIndex;
+	};
+
+	/// Allocator interface to the frame arena, for use with DynamicArray and other containers taking an allocator
+	/// parameter.
+	///
+	/// Containers using this allocator must not hold on to their memory for longer than the frame after the one it was
+	/// allocated in.  Containers kept between frames should be emptied with Clear() (not Resize( 0 )) at the start of
+	/// each frame so they let go of their buffer.
+	class FrameAllocator
+	{
+	public:
+		/// @name Allocation
+		//@{
+		inline void* Allocate( size_t size );
+		inline void* AllocateAligned( size_t alignment, size_t size );
+		inline void* Reallocate( void* pMemory, size_t size );
+		inline void* ReallocateAligned( void* pMemory, size_t alignment, size_t size );
+		inline void Free( void* pMemory );
+		inline void FreeAligned( void* pMemory );
+		inline size_t GetMemorySize( void* pMemory );
+		//@}
+	};
+}
+
+#include "Engine/FrameArena.inl"
@@ -0,0 +1,82 @@
+namespace Helium
+{
+	/// Get the index of the current frame.
+	///
+	/// @return  Current frame index.
+	///
+	/// @see BeginFrame()
+	uint32_t FrameArena::GetFrameIndex()
+	{
+		return static_cast< uint32_t >( sm_frameIndex );
+	}
+
+	/// Allocate a block of memory from the frame arena.
+	///
+	/// @param[in] size  Number of bytes to allocate.
+	///
+	/// @return  Base address of the allocation if successful, null if allocation failed.
+	void* FrameAllocator::Allocate( size_t size )
+	{
+		return FrameArena::Allocate( size );
+	}
+
+	/// Allocate an aligned block of memory from the frame arena.
+	///
+	/// @param[in] alignment  Allocation alignment (must be a power of two).
+	/// @param[in] size       Number of bytes to allocate.
+	///
+	/// @return  Base address of the allocation if successful, null if allocation failed.
+	void* FrameAllocator::AllocateAligned( size_t alignment, size_t size )
+	{
+		return FrameArena::AllocateAligned( alignment, size );
+	}
+
+	/// Resize a block of memory allocated from the frame arena.
+	///
+	/// @param[in] pMemory  Base address of the allocation to resize (can be null).
+	/// @param[in] size     New allocation size, in bytes.
+	///
+	/// @return  Base address of the resized allocation if successful, null if reallocation failed.
+	void* FrameAllocator::Reallocate( void* pMemory, size_t size )
+	{
+		return FrameArena::Reallocate( pMemory, size );
+	}
+
+	/// Resize an aligned block of memory allocated from the frame arena.
+	///
+	/// @param[in] pMemory    Base address of the allocation to resize (can be null).
+	/// @param[in] alignment  Allocation alignment (must be a power of two).
+	/// @param[in] size       New allocation size, in bytes.
+	///
+	/// @return  Base address of the resized allocation if successful, null if reallocation failed.
+	void* FrameAllocator::ReallocateAligned( void* pMemory, size_t alignment, size_t size )
+	{
+		return FrameArena::ReallocateAligned( pMemory, alignment, size );
+	}
+
+	/// Free a block of memory allocated from the frame arena.
+	///
+	/// @param[in] pMemory  Base address of the allocation to free (can be null).
+	void FrameAllocator::Free( void* pMemory )
+	{
+		FrameArena::Free( pMemory );
+	}
+
+	/// Free an aligned block of memory allocated from the frame arena.
+	///
+	/// @param[in] pMemory  Base address of the allocation to free (can be null).
+	void FrameAllocator::FreeAligned( void* pMemory )
+	{
+		FrameArena::Free( pMemory );
+	}
+
+	/// Get the size of a block of memory allocated from the frame arena.
+	///
+	/// @param[in] pMemory  Base address of the allocation.
+	///
+	/// @return  Allocation size, in bytes.
+	size_t FrameAllocator::GetMemorySize( void* pMemory )
+	{
+		return FrameArena::GetMemorySize( pMemory );
+	}
+}
@@ -0,0 +1,319 @@
+#include "Precompile.h"
+#include "Engine/FrameProfiler.h"
+
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
+#include "Platform/Timer.h"
+
+#include "Foundation/FileStream.h"
+#include "Foundation/BufferedStream.h"
+
+using namespace Helium;
+
+volatile int32_t FrameProfiler::sm_enabled = 0;
+
+namespace
+{
+	/// Scopes recorded by a single thread.  Only the owning thread writes to the buffer, and it publishes each event
+	/// by incrementing the write count, so readers can copy the buffer without locking out the writer.
+	struct ThreadBuffer
+	{
+		/// Recorded scopes, indexed by their write count modulo the buffer size.
+		FrameProfiler::Event events[ FrameProfiler::EVENT_BUFFER_SIZE ];
+		/// Number of events written so far.
+		volatile int32_t writeCount;
+
+		/// Names of the open scopes.
+		const char* scopeNames[ FrameProfiler::MAX_SCOPE_DEPTH ];
+		/// Start tick counts of the open scopes.
+		uint64_t scopeStartTicks[ FrameProfiler::MAX_SCOPE_DEPTH ];
+		/// Number of open scopes (including scopes too deep to record).
+		uint32_t depth;
+
+		/// Thread index.
+		uint32_t threadIndex;
+		/// Thread name (static string), or null if not named.
+		const char* volatile pThreadName;
+	};
+
+	/// Registered thread buffers.  Buffers are only released on shutdown, so scopes from threads that have exited
+	/// can still be read.
+	DynamicArray< ThreadBuffer* > s_threadBuffers;
+	/// Lock for the list of thread buffers (not taken while recording).
+	Mutex s_threadBufferLock;
+
+	/// Buffer for the current thread, created when the thread first records a scope.
+	thread_local ThreadBuffer* s_pCurrentThreadBuffer = NULL;
+
+	/// Get the buffer for the current thread, registering one if needed.
+	ThreadBuffer* GetCurrentThreadBuffer()
+	{
+		ThreadBuffer* pBuffer = s_pCurrentThreadBuffer;
+		if( !pBuffer )
+		{
+			pBuffer = new ThreadBuffer;
+			HELIUM_ASSERT( pBuffer );
+			pBuffer->writeCount = 0;
+			pBuffer->depth = 0;
+			pBuffer->pThreadName = NULL;
+
+			MutexScopeLock scopeLock( s_threadBufferLock );
+			pBuffer->threadIndex = static_cast< uint32_t >( s_threadBuffers.GetSize() );
+			s_threadBuffers.Push( pBuffer );
+
+			s_pCurrentThreadBuffer = pBuffer;
+		}
+
+		return pBuffer;
+	}
+
+	/// Write a string to a stream.
+	void WriteString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( pString, sizeof( char ), StringLength( pString ) );
+	}
+
+	/// Write a string to a stream as a quoted JSON string.
+	void WriteJsonString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( "\"", sizeof( char ), 1 );
+
+		for( const char* pCharacter = pString; *pCharacter != '\0'; ++pCharacter )
+		{
+			if( *pCharacter == '"' || *pCharacter == '\\' )
+			{
+				rStream.Write( "\\", sizeof( char ), 1 );
+			}
+
+			rStream.Write( pCharacter, sizeof( char ), 1 );
+		}
+
+		rStream.Write( "\"", sizeof( char ), 1 );
+	}
+}
+
+/// Stop recording and release the recorded scopes of all threads.
+///
+/// No thread may record scopes during or after shutdown.
+void FrameProfiler::Shutdown()
+{
+	SetEnabled( false );
+
+	MutexScopeLock scopeLock( s_threadBufferLock );
+
+	size_t bufferCount = s_threadBuffers.GetSize();
+	for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+	{
+		delete s_threadBuffers[ bufferIndex ];
+	}
+
+	s_threadBuffers.Clear();
+	s_pCurrentThreadBuffer = NULL;
+}
+
+/// Set whether scopes are recorded.
+///
+/// Scopes that were entered before recording was enabled are not recorded.
+///
+/// @param[in] bEnabled  True to record scopes, false to stop.
+///
+/// @see IsEnabled()
+void FrameProfiler::SetEnabled( bool bEnabled )
+{
+	AtomicExchangeRelease( sm_enabled, bEnabled ? 1 : 0 );
+}
+
+/// Set the name shown for the current thread.
+///
+/// @param[in] pName  Thread name (static string).
+void FrameProfiler::SetThreadName( const char* pName )
+{
+	GetCurrentThreadBuffer()->pThreadName = pName;
+}
+
+/// Enter a scope on the current thread.
+///
+/// @param[in] pName  Scope name (static string).
+///
+/// @see EndScope()
+void FrameProfiler::BeginScope( const char* pName )
+{
+	ThreadBuffer* pBuffer = GetCurrentThreadBuffer();
+
+	uint32_t depth = pBuffer->depth++;
+	if( depth < MAX_SCOPE_DEPTH )
+	{
+		pBuffer->scopeNames[ depth ] = pName;
+		pBuffer->scopeStartTicks[ depth ] = Timer::GetTickCount();
+	}
+}
+
+/// Exit the innermost scope on the current thread, recording it.
+///
+/// @see BeginScope()
+void FrameProfiler::EndScope()
+{
+	ThreadBuffer* pBuffer = s_pCurrentThreadBuffer;
+	HELIUM_ASSERT( pBuffer );
+	HELIUM_ASSERT( pBuffer->depth != 0 );
+
+	uint32_t depth = --pBuffer->depth;
+	if( depth < MAX_SCOPE_DEPTH )
+	{
+		uint32_t writeCount = static_cast< uint32_t >( pBuffer->writeCount );
+
+		Event& rEvent = pBuffer->events[ writeCount & ( EVENT_BUFFER_SIZE - 1 ) ];
+		rEvent.pName = pBuffer->scopeNames[ depth ];
+		rEvent.startTicks = pBuffer->scopeStartTicks[ depth ];
+		rEvent.endTicks = Timer::GetTickCount();
+		rEvent.depth = depth;
+
+		// Publish the event to readers.
+		AtomicIncrementRelease( pBuffer->writeCount );
+	}
+}
+
+/// Copy the recorded scopes of every thread.
+///
+/// Scopes recorded while copying may or may not be included.
+///
+/// @param[in]  startTicks  Only scopes exited at or after this tick count are copied.
+/// @param[out] rThreads    Recorded scopes for each thread that has recorded any.
+void FrameProfiler::GetEvents( uint64_t startTicks, DynamicArray< ThreadEvents >& rThreads )
+{
+	rThreads.Resize( 0 );
+
+	MutexScopeLock scopeLock( s_threadBufferLock );
+
+	size_t bufferCount = s_threadBuffers.GetSize();
+	rThreads.Reserve( bufferCount );
+
+	for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+	{
+		const ThreadBuffer* pBuffer = s_threadBuffers[ bufferIndex ];
+		HELIUM_ASSERT( pBuffer );
+
+		ThreadEvents* pThread = rThreads.New();
+		HELIUM_ASSERT( pThread );
+		pThread->threadIndex = pBuffer->threadIndex;
+		pThread->pThreadName = pBuffer->pThreadName;
+
+		uint32_t writeCount = static_cast< uint32_t >( AtomicOrAcquire( const_cast< volatile int32_t& >( pBuffer->writeCount ), 0 ) );
+		uint32_t readCount = ( writeCount > EVENT_BUFFER_SIZE ? writeCount - EVENT_BUFFER_SIZE : 0 );
+
+		pThread->events.Reserve( writeCount - readCount );
+		for( uint32_t eventIndex = readCount; eventIndex < writeCount; ++eventIndex )
+		{
+			pThread->events.Push( pBuffer->events[ eventIndex & ( EVENT_BUFFER_SIZE - 1 ) ] );
+		}
+
+		// Drop the events the writer may have overwritten while they were copied.  The writer may also be filling in the
+		// slot after the last event it has published, so the oldest event still safe is the one after that slot's.
+		uint32_t newWriteCount = static_cast< uint32_t >( AtomicOrAcquire( const_cast< volatile int32_t& >( pBuffer->writeCount ), 0 ) );
+		uint32_t safeCount = ( newWriteCount + 1 > EVENT_BUFFER_SIZE ? newWriteCount + 1 - EVENT_BUFFER_SIZE : 0 );
+
+		size_t removeCount = ( safeCount > readCount ? Min< size_t >( safeCount - readCount, pThread->events.GetSize() ) : 0 );
+
+		// Events are in the order they were exited, so the ones exited before the start time come first.
+		size_t copiedCount = pThread->events.GetSize();
+		while( removeCount < copiedCount && pThread->events[ removeCount ].endTicks < startTicks )
+		{
+			++removeCount;
+		}
+
+		pThread->events.Remove( 0, removeCount );
+	}
+}
+
+/// Write the recorded scopes of every thread to a file in the Chrome trace event format, for viewing in
+/// chrome://tracing or any other viewer supporting the format.
+///
+/// @param[in] rPath  Trace file path.
+///
+/// @return  True if the trace was written successfully, false if not.
+bool FrameProfiler::WriteChromeTrace( const FilePath& rPath )
+{
+	DynamicArray< ThreadEvents > threads;
+	GetEvents( 0, threads );
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"FrameProfiler::WriteChromeTrace(): Failed to open \"%s\" for writing.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+
+		// Timestamps are in microseconds, relative to the oldest recorded scope.
+		uint64_t baseTicks = UINT64_MAX;
+		size_t threadCount = threads.GetSize();
+		for( size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex )
+		{
+			const DynamicArray< Event >& rEvents = threads[ threadIndex ].events;
+			size_t eventCount = rEvents.GetSize();
+			for( size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex )
+			{
+				baseTicks = Min( baseTicks, rEvents[ eventIndex ].startTicks );
+			}
+		}
+
+		float64_t microsecondsPerTick = Timer::GetSecondsPerTick() * 1000000.0;
+
+		WriteString( bufferedStream, "{\"traceEvents\":[\n" );
+
+		bool bFirst = true;
+		char buffer[ 128 ];
+
+		for( size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex )
+		{
+			const ThreadEvents& rThread = threads[ threadIndex ];
+
+			if( rThread.pThreadName )
+			{
+				StringPrint(
+					buffer,
+					"%s{\"ph\":\"M\",\"pid\":0,\"tid\":%" PRIu32 ",\"name\":\"thread_name\",\"args\":{\"name\":",
+					( bFirst ? "" : ",\n" ),
+					rThread.threadIndex );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+				WriteJsonString( bufferedStream, rThread.pThreadName );
+				WriteString( bufferedStream, "}}" );
+
+				bFirst = false;
+			}
+
+			size_t eventCount = rThread.events.GetSize();
+			for( size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex )
+			{
+				const Event& rEvent = rThread.events[ eventIndex ];
+
+				StringPrint(
+					buffer,
+					"%s{\"ph\":\"X\",\"pid\":0,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+					( bFirst ? "" : ",\n" ),
+					rThread.threadIndex,
+					static_cast< float64_t >( rEvent.startTicks - baseTicks ) * microsecondsPerTick,
+					static_cast< float64_t >( rEvent.endTicks - rEvent.startTicks ) * microsecondsPerTick );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+				WriteJsonString( bufferedStream, rEvent.pName ? rEvent.pName : "" );
+				WriteString( bufferedStream, "}" );
+
+				bFirst = false;
+			}
+		}
+
+		WriteString( bufferedStream, "\n]}\n" );
+	}
+
+	delete pFileStream;
+
+	return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+
+/// Non-zero to compile in frame profiler scopes.  Scopes are compiled into all builds (including release) and only
+/// record while the profiler is enabled at runtime.
+#define HELIUM_ENABLE_FRAME_PROFILER 1
+
+namespace Helium
+{
+	/// Profiler recording hierarchical scopes for every thread, for display as a timeline or export as a trace.
+	///
+	/// Each thread records the scopes it closes into its own ring buffer, so recording takes no locks and threads never
+	/// contend with each other.  Older scopes are overwritten once a thread's buffer fills up.  The buffers may be read
+	/// from any thread while the scopes are being recorded.
+	class HELIUM_ENGINE_API FrameProfiler
+	{
+	public:
+		/// Number of scopes kept per thread.  Must be a power of two.
+		static const uint32_t EVENT_BUFFER_SIZE = 16384;
+		/// Maximum scope nesting depth recorded per thread (deeper scopes are not recorded).
+		static const uint32_t MAX_SCOPE_DEPTH = 64;
+
+		/// Recorded scope.
+		struct Event
+		{
+			/// Scope name (static string).
+			const char* pName;
+			/// Tick count when the scope was entered.
+			uint64_t startTicks;
+			/// Tick count when the scope was exited.
+			uint64_t endTicks;
+			/// Number of scopes this scope is nested within.
+			uint32_t depth;
+		};
+
+		/// Scopes recorded by a single thread.
+		struct ThreadEvents
+		{
+			/// Index of the thread, in the order threads first recorded a scope.
+			uint32_t threadIndex;
+			/// Thread name (static string), or null if not named.
+			const char* pThreadName;
+			/// Recorded scopes, in the order they were exited.
+			DynamicArray< Event > events;
+		};
+
+		/// @name Initialization
+		//@{
+		static void Shutdown();
+		//@}
+
+		/// @name Recording
+		//@{
+		static void SetEnabled( bool bEnabled );
+		inline static bool IsEnabled();
+
+		static void SetThreadName( const char* pName );
+
+		static void BeginScope( const char* pName );
+		static void EndScope();
+		//@}
+
+		/// @name Reading
+		//@{
+		static void GetEvents( uint64_t startTicks, DynamicArray< ThreadEvents >& rThreads );
+		static bool WriteChromeTrace( const FilePath& rPath );
+		//@}
+
+	private:
+		/// Non-zero while scopes are recorded.
+		static volatile int32_t sm_enabled;
+	};
+
+	/// Scope recorded by the frame profiler from construction to destruction.
+	class FrameProfilerScope : NonCopyable
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		inline explicit FrameProfilerScope( const char* pName );
+		inline ~FrameProfilerScope();
+		//@}
+
+	private:
+		/// True if the scope was begun (the profiler was enabled on construction).
+		bool m_bActive;
+	};
+}
+
+#define HELIUM_FRAME_PROFILER_CONCAT_INTERNAL( A, B ) A##B
+#define HELIUM_FRAME_PROFILER_CONCAT( A, B ) HELIUM_FRAME_PROFILER_CONCAT_INTERNAL( A, B )
+
+#if HELIUM_ENABLE_FRAME_PROFILER
+/// Record the rest of the enclosing block as a named scope.  The name must be a static string.
+# define HELIUM_FRAME_PROFILER_SCOPE( NAME ) \
+	Helium::FrameProfilerScope HELIUM_FRAME_PROFILER_CONCAT( frameProfilerScope_, __LINE__ )( NAME )
+#else
+# define HELIUM_FRAME_PROFILER_SCOPE( NAME )
+#endif
+
+#include "Engine/FrameProfiler.inl"
@@ -0,0 +1,33 @@
+namespace Helium
+{
+	/// Get whether scopes are currently being recorded.
+	///
+	/// @return  True if recording, false if not.
+	///
+	/// @see SetEnabled()
+	bool FrameProfiler::IsEnabled()
+	{
+		return sm_enabled != 0;
+	}
+
+	/// Constructor.
+	///
+	/// @param[in] pName  Scope name (static string).
+	FrameProfilerScope::FrameProfilerScope( const char* pName )
+		: m_bActive( FrameProfiler::IsEnabled() )
+	{
+		if( m_bActive )
+		{
+			FrameProfiler::BeginScope( pName );
+		}
+	}
+
+	/// Destructor.
+	FrameProfilerScope::~FrameProfilerScope()
+	{
+		if( m_bActive )
+		{
+			FrameProfiler::EndScope();
+		}
+	}
+}
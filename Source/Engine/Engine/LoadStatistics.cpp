@@ -0,0 +1,221 @@
+#include "Precompile.h"
+#include "Engine/LoadStatistics.h"
+
+#include "Platform/Locks.h"
+#include "Platform/Timer.h"
+
+using namespace Helium;
+
+namespace
+{
+	/// Minimum time between updates of the averages and rates, in seconds.
+	const float64_t RATE_INTERVAL_SECONDS = 1.0;
+
+	/// Current counters and gauges.
+	LoadStatistics::Stats s_stats;
+	/// Counter values when the averages and rates were last updated.
+	uint64_t s_rateBaseCounters[ LoadStatistics::COUNTER_MAX ];
+	/// Timer tick count when the averages and rates were last updated, or zero before the first update.
+	uint64_t s_rateBaseTicks = 0;
+	/// Lock for the statistics.
+	Mutex s_statsLock;
+
+	/// Get the average of a summed tick counter over a count counter, in milliseconds.
+	float32_t GetAverageMilliseconds( uint64_t tickDelta, uint64_t countDelta )
+	{
+		if( countDelta == 0 )
+		{
+			return 0.0f;
+		}
+
+		return static_cast< float32_t >(
+			static_cast< float64_t >( tickDelta ) * Timer::GetSecondsPerTick() * 1000.0 /
+			static_cast< float64_t >( countDelta ) );
+	}
+}
+
+/// Add to a counter.
+///
+/// This can be called from any thread.
+///
+/// @param[in] counter  Counter.
+/// @param[in] value    Value to add.
+void LoadStatistics::AddCount( ECounter counter, uint64_t value )
+{
+	HELIUM_ASSERT( static_cast< size_t >( counter ) < COUNTER_MAX );
+
+	MutexScopeLock scopeLock( s_statsLock );
+	s_stats.counters[ counter ] += value;
+}
+
+/// Add to or subtract from a gauge.
+///
+/// This can be called from any thread.
+///
+/// @param[in] gauge  Gauge.
+/// @param[in] delta  Value to add (negative to subtract).
+///
+/// @see SetGauge()
+void LoadStatistics::AdjustGauge( EGauge gauge, int64_t delta )
+{
+	HELIUM_ASSERT( static_cast< size_t >( gauge ) < GAUGE_MAX );
+
+	MutexScopeLock scopeLock( s_statsLock );
+	s_stats.gauges[ gauge ] += delta;
+}
+
+/// Set the value of a gauge.
+///
+/// This can be called from any thread.
+///
+/// @param[in] gauge  Gauge.
+/// @param[in] value  New value.
+///
+/// @see AdjustGauge()
+void LoadStatistics::SetGauge( EGauge gauge, int64_t value )
+{
+	HELIUM_ASSERT( static_cast< size_t >( gauge ) < GAUGE_MAX );
+
+	MutexScopeLock scopeLock( s_statsLock );
+	s_stats.gauges[ gauge ] = value;
+}
+
+/// Record file reads being queued.
+///
+/// This can be called from any thread.
+///
+/// @param[in] readCount  Number of reads queued.
+/// @param[in] byteCount  Total number of bytes to read.
+///
+/// @see RecordReadCompleted()
+void LoadStatistics::RecordReadsQueued( size_t readCount, uint64_t byteCount )
+{
+	MutexScopeLock scopeLock( s_statsLock );
+	s_stats.gauges[ GAUGE_READS_IN_FLIGHT ] += static_cast< int64_t >( readCount );
+	s_stats.gauges[ GAUGE_READ_BYTES_IN_FLIGHT ] += static_cast< int64_t >( byteCount );
+}
+
+/// Record the completion of a file read queued with RecordReadsQueued().
+///
+/// This can be called from any thread.
+///
+/// @param[in] queuedByteCount  Number of bytes the read was queued for.
+/// @param[in] bytesRead        Number of bytes actually read from the file.
+/// @param[in] ticks            Timer ticks between queuing and completion of the read.
+void LoadStatistics::RecordReadCompleted( uint64_t queuedByteCount, uint64_t bytesRead, uint64_t ticks )
+{
+	MutexScopeLock scopeLock( s_statsLock );
+	--s_stats.gauges[ GAUGE_READS_IN_FLIGHT ];
+	s_stats.gauges[ GAUGE_READ_BYTES_IN_FLIGHT ] -= static_cast< int64_t >( queuedByteCount );
+	++s_stats.counters[ COUNTER_READS_COMPLETED ];
+	s_stats.counters[ COUNTER_READ_BYTES ] += bytesRead;
+	s_stats.counters[ COUNTER_READ_TICKS ] += ticks;
+}
+
+/// Refresh the averages and rates.
+///
+/// Averages and rates are measured over intervals of at least a second, so calls made before a full interval has
+/// passed since the last refresh leave them as they are.
+void LoadStatistics::Update()
+{
+	MutexScopeLock scopeLock( s_statsLock );
+
+	uint64_t ticks = Timer::GetTickCount();
+	if( s_rateBaseTicks == 0 )
+	{
+		s_rateBaseTicks = ticks;
+		MemoryCopy( s_rateBaseCounters, s_stats.counters, sizeof( s_rateBaseCounters ) );
+
+		return;
+	}
+
+	float64_t seconds = static_cast< float64_t >( ticks - s_rateBaseTicks ) * Timer::GetSecondsPerTick();
+	if( seconds < RATE_INTERVAL_SECONDS )
+	{
+		return;
+	}
+
+	uint64_t deltas[ COUNTER_MAX ];
+	for( size_t counterIndex = 0; counterIndex < COUNTER_MAX; ++counterIndex )
+	{
+		deltas[ counterIndex ] = s_stats.counters[ counterIndex ] - s_rateBaseCounters[ counterIndex ];
+	}
+
+	s_stats.averageAssetLoadMilliseconds = GetAverageMilliseconds(
+		deltas[ COUNTER_ASSET_LOAD_TICKS ],
+		deltas[ COUNTER_ASSET_LOADS_COMPLETED ] );
+	s_stats.averageReadMilliseconds = GetAverageMilliseconds(
+		deltas[ COUNTER_READ_TICKS ],
+		deltas[ COUNTER_READS_COMPLETED ] );
+	s_stats.readBytesPerSecond = static_cast< float32_t >(
+		static_cast< float64_t >( deltas[ COUNTER_READ_BYTES ] ) / seconds );
+
+	uint64_t lookupCount = deltas[ COUNTER_CACHE_HITS ] + deltas[ COUNTER_CACHE_MISSES ];
+	s_stats.cacheHitRatio = ( lookupCount != 0
+		? static_cast< float32_t >(
+			static_cast< float64_t >( deltas[ COUNTER_CACHE_HITS ] ) / static_cast< float64_t >( lookupCount ) )
+		: 0.0f );
+
+	s_rateBaseTicks = ticks;
+	MemoryCopy( s_rateBaseCounters, s_stats.counters, sizeof( s_rateBaseCounters ) );
+}
+
+/// Get the current statistics.
+///
+/// @param[out] rStats  Current counters and gauges, along with the averages and rates of the last interval.
+///
+/// @see Update()
+void LoadStatistics::GetStats( Stats& rStats )
+{
+	MutexScopeLock scopeLock( s_statsLock );
+	rStats = s_stats;
+}
+
+/// Get the display name of a counter.
+///
+/// @param[in] counter  Counter.
+///
+/// @return  Counter name.
+const char* LoadStatistics::GetCounterName( ECounter counter )
+{
+	static const char* const counterNames[] =
+	{
+		"assetLoadsBegun",          // COUNTER_ASSET_LOADS_BEGUN
+		"assetLoadsCompleted",      // COUNTER_ASSET_LOADS_COMPLETED
+		"assetLoadTicks",           // COUNTER_ASSET_LOAD_TICKS
+		"cacheHits",                // COUNTER_CACHE_HITS
+		"cacheMisses",              // COUNTER_CACHE_MISSES
+		"prefetchHits",             // COUNTER_PREFETCH_HITS
+		"readsCompleted",           // COUNTER_READS_COMPLETED
+		"readBytes",                // COUNTER_READ_BYTES
+		"readTicks",                // COUNTER_READ_TICKS
+	};
+
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( counterNames ) == COUNTER_MAX );
+	HELIUM_ASSERT( static_cast< size_t >( counter ) < COUNTER_MAX );
+
+	return counterNames[ counter ];
+}
+
+/// Get the display name of a gauge.
+///
+/// @param[in] gauge  Gauge.
+///
+/// @return  Gauge name.
+const char* LoadStatistics::GetGaugeName( EGauge gauge )
+{
+	static const char* const gaugeNames[] =
+	{
+		"assetsPreloading",         // GAUGE_ASSETS_PRELOADING
+		"assetsLinking",            // GAUGE_ASSETS_LINKING
+		"assetsPrecaching",         // GAUGE_ASSETS_PRECACHING
+		"assetsFinalizing",         // GAUGE_ASSETS_FINALIZING
+		"readsInFlight",            // GAUGE_READS_IN_FLIGHT
+		"readBytesInFlight",        // GAUGE_READ_BYTES_IN_FLIGHT
+	};
+
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( gaugeNames ) == GAUGE_MAX );
+	HELIUM_ASSERT( static_cast< size_t >( gauge ) < GAUGE_MAX );
+
+	return gaugeNames[ gauge ];
+}
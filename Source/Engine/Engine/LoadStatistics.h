@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+namespace Helium
+{
+	/// Live counters of asset loading and streaming work.
+	///
+	/// The asset loader, the cache package loader, and the async loader report the load requests in each stage, the
+	/// file reads and bytes in flight, cache lookups, and how long loads and reads take as they go.  Counters are
+	/// running totals since startup, while gauges hold the current amount of outstanding work.  Both may be recorded
+	/// from any thread, and recording takes a lock, so they are recorded once per request rather than per byte.
+	///
+	/// Update() should be called periodically (such as once per frame) to refresh the averages and rates measured over
+	/// the last interval, which are returned by GetStats() along with the counters and gauges.
+	class HELIUM_ENGINE_API LoadStatistics
+	{
+	public:
+		/// Running totals.
+		enum ECounter
+		{
+			COUNTER_FIRST   =  0,
+			COUNTER_INVALID = -1,
+
+			/// Asset load requests begun.
+			COUNTER_ASSET_LOADS_BEGUN = COUNTER_FIRST,
+			/// Asset load requests that finished loading.
+			COUNTER_ASSET_LOADS_COMPLETED,
+			/// Timer ticks between the start and end of each completed asset load, summed.
+			COUNTER_ASSET_LOAD_TICKS,
+			/// Objects found in a cache.
+			COUNTER_CACHE_HITS,
+			/// Objects looked up in a cache but not found.
+			COUNTER_CACHE_MISSES,
+			/// Cache loads served by data that was already prefetched or being prefetched.
+			COUNTER_PREFETCH_HITS,
+			/// File reads completed.
+			COUNTER_READS_COMPLETED,
+			/// Bytes read from files (before decompression).
+			COUNTER_READ_BYTES,
+			/// Timer ticks between queuing and completion of each completed read, summed.
+			COUNTER_READ_TICKS,
+
+			COUNTER_MAX,
+			COUNTER_LAST = COUNTER_MAX - 1
+		};
+
+		/// Current amounts of outstanding work.
+		enum EGauge
+		{
+			GAUGE_FIRST   =  0,
+			GAUGE_INVALID = -1,
+
+			/// Asset load requests waiting to be preloaded by their package loader.
+			GAUGE_ASSETS_PRELOADING = GAUGE_FIRST,
+			/// Asset load requests preloaded and waiting to be linked.
+			GAUGE_ASSETS_LINKING,
+			/// Asset load requests linked and waiting on resource precaching.
+			GAUGE_ASSETS_PRECACHING,
+			/// Asset load requests precached and waiting to be finalized.
+			GAUGE_ASSETS_FINALIZING,
+			/// File reads queued or in progress.
+			GAUGE_READS_IN_FLIGHT,
+			/// Bytes of file reads queued or in progress.
+			GAUGE_READ_BYTES_IN_FLIGHT,
+
+			GAUGE_MAX,
+			GAUGE_LAST = GAUGE_MAX - 1
+		};
+
+		/// Loading and streaming statistics.
+		struct Stats
+		{
+			/// Counter values, indexed by ECounter.
+			uint64_t counters[ COUNTER_MAX ];
+			/// Gauge values, indexed by EGauge.
+			int64_t gauges[ GAUGE_MAX ];
+
+			/// Average time taken by each asset load completed during the last interval, in milliseconds.
+			float32_t averageAssetLoadMilliseconds;
+			/// Average time taken by each file read completed during the last interval, in milliseconds.
+			float32_t averageReadMilliseconds;
+			/// Bytes read per second during the last interval.
+			float32_t readBytesPerSecond;
+			/// Fraction of cache lookups during the last interval that found their object (zero if none were made).
+			float32_t cacheHitRatio;
+		};
+
+		/// @name Recording
+		//@{
+		static void AddCount( ECounter counter, uint64_t value = 1 );
+		static void AdjustGauge( EGauge gauge, int64_t delta );
+		static void SetGauge( EGauge gauge, int64_t value );
+
+		static void RecordReadsQueued( size_t readCount, uint64_t byteCount );
+		static void RecordReadCompleted( uint64_t queuedByteCount, uint64_t bytesRead, uint64_t ticks );
+
+		static void Update();
+		//@}
+
+		/// @name Reading
+		//@{
+		static void GetStats( Stats& rStats );
+		static const char* GetCounterName( ECounter counter );
+		static const char* GetGaugeName( EGauge gauge );
+		//@}
+	};
+}
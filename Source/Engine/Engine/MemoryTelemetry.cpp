@@ -0,0 +1,446 @@
+#include "Precompile.h"
+#include "Engine/MemoryTelemetry.h"
+
+#include "Platform/Locks.h"
+#include "Platform/Timer.h"
+
+#include "Foundation/FileStream.h"
+#include "Foundation/BufferedStream.h"
+#include "Foundation/HashMap.h"
+
+using namespace Helium;
+
+namespace
+{
+	/// Minimum interval between allocation rate measurements, in seconds (rates measured over a single frame are too
+	/// noisy to be of much use).
+	const float64_t RATE_INTERVAL_SECONDS = 1.0;
+
+	/// Memory usage of a single tracker.
+	struct Tracker
+	{
+		/// Current statistics.
+		MemoryTelemetry::Stats stats;
+
+		/// Total bytes allocated as of the last rate measurement.
+		uint64_t rateBaseBytes;
+		/// Total allocation count as of the last rate measurement.
+		uint64_t rateBaseCount;
+
+		/// Sampler reporting the live bytes of the tracker, or null if allocations are recorded individually.
+		MemoryTelemetry::SampleFunction pSampleFunction;
+		/// Data passed to the sampler.
+		void* pSampleData;
+	};
+
+	/// Registered trackers, indexed by tracker ID.
+	DynamicArray< Tracker > s_trackers;
+	/// Tracker ID lookup by name for each category.
+	HashMap< Name, uint32_t > s_trackerMaps[ MemoryTelemetry::CATEGORY_MAX ];
+	/// Lock for all tracker data.
+	Mutex s_trackerLock;
+
+	/// Tick count of the last rate measurement, or zero if rates have not been measured yet.
+	uint64_t s_rateBaseTicks = 0;
+
+	/// Find or add the tracker for a category and name.  The tracker lock must be held.
+	uint32_t GetTrackerLocked( MemoryTelemetry::ECategory category, Name name )
+	{
+		HashMap< Name, uint32_t >& rTrackerMap = s_trackerMaps[ category ];
+		HashMap< Name, uint32_t >::Iterator trackerIterator = rTrackerMap.Find( name );
+		if( trackerIterator != rTrackerMap.End() )
+		{
+			return trackerIterator->Second();
+		}
+
+		uint32_t trackerId = static_cast< uint32_t >( s_trackers.GetSize() );
+
+		Tracker* pTracker = s_trackers.New();
+		HELIUM_ASSERT( pTracker );
+		pTracker->stats.category = category;
+		pTracker->stats.name = name;
+		pTracker->stats.liveBytes = 0;
+		pTracker->stats.peakBytes = 0;
+		pTracker->stats.liveCount = 0;
+		pTracker->stats.totalBytes = 0;
+		pTracker->stats.totalCount = 0;
+		pTracker->stats.bytesPerSecond = 0.0f;
+		pTracker->stats.allocationsPerSecond = 0.0f;
+		pTracker->rateBaseBytes = 0;
+		pTracker->rateBaseCount = 0;
+		pTracker->pSampleFunction = NULL;
+		pTracker->pSampleData = NULL;
+
+		rTrackerMap.Insert( trackerIterator, HashMap< Name, uint32_t >::ValueType( name, trackerId ) );
+
+		return trackerId;
+	}
+
+	/// Update the live byte count of a tracker.  The tracker lock must be held.
+	void SetLiveBytes( Tracker& rTracker, uint64_t liveBytes )
+	{
+		MemoryTelemetry::Stats& rStats = rTracker.stats;
+		if( liveBytes > rStats.liveBytes )
+		{
+			rStats.totalBytes += liveBytes - rStats.liveBytes;
+		}
+
+		rStats.liveBytes = liveBytes;
+		rStats.peakBytes = Max( rStats.peakBytes, liveBytes );
+	}
+
+	/// Query all registered samplers.  The tracker lock must be held.
+	void SampleTrackers()
+	{
+		size_t trackerCount = s_trackers.GetSize();
+		for( size_t trackerIndex = 0; trackerIndex < trackerCount; ++trackerIndex )
+		{
+			Tracker& rTracker = s_trackers[ trackerIndex ];
+			if( rTracker.pSampleFunction )
+			{
+				SetLiveBytes( rTracker, rTracker.pSampleFunction( rTracker.pSampleData ) );
+			}
+		}
+	}
+
+	/// Write a string to a stream.
+	void WriteString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( pString, sizeof( char ), StringLength( pString ) );
+	}
+}
+
+/// Release all trackers.
+///
+/// Tracker IDs acquired before shutdown are no longer valid (recording with them is ignored).
+void MemoryTelemetry::Shutdown()
+{
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	s_trackers.Clear();
+	for( size_t categoryIndex = 0; categoryIndex < CATEGORY_MAX; ++categoryIndex )
+	{
+		s_trackerMaps[ categoryIndex ].Clear();
+	}
+
+	s_rateBaseTicks = 0;
+}
+
+/// Get the tracker for a category and name, adding it if it does not exist yet.
+///
+/// @param[in] category  Tracker category.
+/// @param[in] name      Tracker name.
+///
+/// @return  Tracker ID.
+///
+/// @see RecordAllocation(), RecordFree(), RegisterSampler()
+uint32_t MemoryTelemetry::GetTracker( ECategory category, Name name )
+{
+	HELIUM_ASSERT( static_cast< size_t >( category ) < static_cast< size_t >( CATEGORY_MAX ) );
+
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	return GetTrackerLocked( category, name );
+}
+
+/// Record an allocation.
+///
+/// @param[in] tracker  Tracker ID.
+/// @param[in] size     Number of bytes allocated.
+///
+/// @see RecordFree(), RecordResize(), GetTracker()
+void MemoryTelemetry::RecordAllocation( uint32_t tracker, size_t size )
+{
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	if( tracker >= s_trackers.GetSize() )
+	{
+		return;
+	}
+
+	Tracker& rTracker = s_trackers[ tracker ];
+	HELIUM_ASSERT( !rTracker.pSampleFunction );
+
+	Stats& rStats = rTracker.stats;
+	++rStats.liveCount;
+	++rStats.totalCount;
+	SetLiveBytes( rTracker, rStats.liveBytes + size );
+}
+
+/// Record an allocation being freed.
+///
+/// @param[in] tracker  Tracker ID.
+/// @param[in] size     Number of bytes freed (must match the size recorded when allocating).
+///
+/// @see RecordAllocation(), RecordResize(), GetTracker()
+void MemoryTelemetry::RecordFree( uint32_t tracker, size_t size )
+{
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	if( tracker >= s_trackers.GetSize() )
+	{
+		return;
+	}
+
+	Tracker& rTracker = s_trackers[ tracker ];
+	HELIUM_ASSERT( !rTracker.pSampleFunction );
+
+	Stats& rStats = rTracker.stats;
+	HELIUM_ASSERT( rStats.liveCount != 0 );
+	HELIUM_ASSERT( rStats.liveBytes >= size );
+	rStats.liveCount -= Min< uint64_t >( rStats.liveCount, 1 );
+	rStats.liveBytes -= Min< uint64_t >( rStats.liveBytes, size );
+}
+
+/// Record a live allocation being resized.  Growth counts towards the allocation rate, but not as a new allocation.
+///
+/// @param[in] tracker  Tracker ID.
+/// @param[in] oldSize  Previous allocation size, in bytes.
+/// @param[in] newSize  New allocation size, in bytes.
+///
+/// @see RecordAllocation(), RecordFree(), GetTracker()
+void MemoryTelemetry::RecordResize( uint32_t tracker, size_t oldSize, size_t newSize )
+{
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	if( tracker >= s_trackers.GetSize() )
+	{
+		return;
+	}
+
+	Tracker& rTracker = s_trackers[ tracker ];
+	HELIUM_ASSERT( !rTracker.pSampleFunction );
+
+	Stats& rStats = rTracker.stats;
+	HELIUM_ASSERT( rStats.liveBytes >= oldSize );
+	SetLiveBytes( rTracker, rStats.liveBytes - Min< uint64_t >( rStats.liveBytes, oldSize ) + newSize );
+}
+
+/// Register a function reporting the live bytes of a memory owner that does not record its allocations individually.
+///
+/// The function is called with the telemetry lock held each time the telemetry is updated or read, from whichever
+/// thread is doing so, and must not record any memory itself.
+///
+/// @param[in] category   Tracker category.
+/// @param[in] name       Tracker name.
+/// @param[in] pFunction  Function returning the number of live bytes.
+/// @param[in] pData      Data to pass to the function.
+///
+/// @return  Tracker ID.
+///
+/// @see UnregisterSampler()
+uint32_t MemoryTelemetry::RegisterSampler( ECategory category, Name name, SampleFunction pFunction, void* pData )
+{
+	HELIUM_ASSERT( static_cast< size_t >( category ) < static_cast< size_t >( CATEGORY_MAX ) );
+	HELIUM_ASSERT( pFunction );
+
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	uint32_t trackerId = GetTrackerLocked( category, name );
+
+	Tracker& rTracker = s_trackers[ trackerId ];
+	if( rTracker.pSampleFunction || rTracker.stats.liveCount != 0 )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"MemoryTelemetry::RegisterSampler(): Tracker \"%s\" (%s) is already in use.\n",
+			*name,
+			GetCategoryName( category ) );
+	}
+
+	rTracker.pSampleFunction = pFunction;
+	rTracker.pSampleData = pData;
+	SetLiveBytes( rTracker, pFunction( pData ) );
+
+	return trackerId;
+}
+
+/// Unregister a sampler.  The tracker is kept, with no live bytes, so its peak and totals are still reported.
+///
+/// @param[in] tracker  Tracker ID returned by RegisterSampler().
+///
+/// @see RegisterSampler()
+void MemoryTelemetry::UnregisterSampler( uint32_t tracker )
+{
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	if( tracker >= s_trackers.GetSize() )
+	{
+		return;
+	}
+
+	Tracker& rTracker = s_trackers[ tracker ];
+	rTracker.pSampleFunction = NULL;
+	rTracker.pSampleData = NULL;
+	rTracker.stats.liveBytes = 0;
+}
+
+/// Query all samplers and update the allocation rates.  This should be called once per frame.
+void MemoryTelemetry::Update()
+{
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	SampleTrackers();
+
+	uint64_t ticks = Timer::GetTickCount();
+	if( s_rateBaseTicks == 0 )
+	{
+		s_rateBaseTicks = ticks;
+	}
+
+	float64_t seconds = static_cast< float64_t >( ticks - s_rateBaseTicks ) * Timer::GetSecondsPerTick();
+	if( seconds < RATE_INTERVAL_SECONDS )
+	{
+		return;
+	}
+
+	size_t trackerCount = s_trackers.GetSize();
+	for( size_t trackerIndex = 0; trackerIndex < trackerCount; ++trackerIndex )
+	{
+		Tracker& rTracker = s_trackers[ trackerIndex ];
+		Stats& rStats = rTracker.stats;
+
+		rStats.bytesPerSecond = static_cast< float32_t >(
+			static_cast< float64_t >( rStats.totalBytes - rTracker.rateBaseBytes ) / seconds );
+		rStats.allocationsPerSecond = static_cast< float32_t >(
+			static_cast< float64_t >( rStats.totalCount - rTracker.rateBaseCount ) / seconds );
+
+		rTracker.rateBaseBytes = rStats.totalBytes;
+		rTracker.rateBaseCount = rStats.totalCount;
+	}
+
+	s_rateBaseTicks = ticks;
+}
+
+/// Get the current statistics of every tracker.
+///
+/// @param[out] rStats  Statistics of each tracker, ordered by category, then by tracker registration order.
+void MemoryTelemetry::GetStats( DynamicArray< Stats >& rStats )
+{
+	rStats.Resize( 0 );
+
+	MutexScopeLock scopeLock( s_trackerLock );
+
+	SampleTrackers();
+
+	size_t trackerCount = s_trackers.GetSize();
+	rStats.Reserve( trackerCount );
+	for( size_t categoryIndex = 0; categoryIndex < CATEGORY_MAX; ++categoryIndex )
+	{
+		for( size_t trackerIndex = 0; trackerIndex < trackerCount; ++trackerIndex )
+		{
+			const Stats& rTrackerStats = s_trackers[ trackerIndex ].stats;
+			if( static_cast< size_t >( rTrackerStats.category ) == categoryIndex )
+			{
+				rStats.Push( rTrackerStats );
+			}
+		}
+	}
+}
+
+/// Write the current statistics of every tracker to a text file, as a table per category.
+///
+/// @param[in] rPath  Report file path.
+///
+/// @return  True if the report was written successfully, false if not.
+bool MemoryTelemetry::WriteReport( const FilePath& rPath )
+{
+	DynamicArray< Stats > stats;
+	GetStats( stats );
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"MemoryTelemetry::WriteReport(): Failed to open \"%s\" for writing.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+
+		char buffer[ 512 ];
+
+		ECategory category = CATEGORY_INVALID;
+		uint64_t categoryLiveBytes = 0;
+
+		size_t statCount = stats.GetSize();
+		for( size_t statIndex = 0; statIndex <= statCount; ++statIndex )
+		{
+			const Stats* pStats = ( statIndex < statCount ? &stats[ statIndex ] : NULL );
+			if( category != CATEGORY_INVALID && ( !pStats || pStats->category != category ) )
+			{
+				StringPrint( buffer, "%-48s %14" PRIu64 "\n\n", "Total", categoryLiveBytes );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+			}
+
+			if( !pStats )
+			{
+				break;
+			}
+
+			if( pStats->category != category )
+			{
+				category = pStats->category;
+				categoryLiveBytes = 0;
+
+				StringPrint(
+					buffer,
+					"%-48s %14s %14s %10s %14s %12s %10s\n",
+					GetCategoryName( category ),
+					"Live Bytes",
+					"Peak Bytes",
+					"Live Count",
+					"Total Bytes",
+					"Bytes/sec",
+					"Allocs/sec" );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+			}
+
+			categoryLiveBytes += pStats->liveBytes;
+
+			StringPrint(
+				buffer,
+				"%-48s %14" PRIu64 " %14" PRIu64 " %10" PRIu64 " %14" PRIu64 " %12.0f %10.1f\n",
+				*pStats->name,
+				pStats->liveBytes,
+				pStats->peakBytes,
+				pStats->liveCount,
+				pStats->totalBytes,
+				pStats->bytesPerSecond,
+				pStats->allocationsPerSecond );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+		}
+	}
+
+	delete pFileStream;
+
+	return true;
+}
+
+/// Get the display name of a tracker category.
+///
+/// @param[in] category  Tracker category.
+///
+/// @return  Category name.
+const char* MemoryTelemetry::GetCategoryName( ECategory category )
+{
+	HELIUM_ASSERT( static_cast< size_t >( category ) < static_cast< size_t >( CATEGORY_MAX ) );
+
+	static const char* const CATEGORY_NAMES[] =
+	{
+		"Heaps",             // CATEGORY_HEAP
+		"Asset Types",       // CATEGORY_ASSET_TYPE
+		"Render Resources"   // CATEGORY_RENDER_RESOURCE
+	};
+
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( CATEGORY_NAMES ) == CATEGORY_MAX );
+
+	return CATEGORY_NAMES[ category ];
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/Name.h"
+
+namespace Helium
+{
+	/// Runtime view of memory usage, broken down by heap, asset type, and render resource category.
+	///
+	/// Memory owners report their usage to trackers, each identified by a category and a name.  Owners either record
+	/// individual allocations and frees, or register a sampler that is queried for the number of live bytes each time
+	/// the telemetry is updated.  Recording takes a lock, so it should be done at the granularity of pools, chunks, and
+	/// resources, not of individual small allocations.
+	///
+	/// Live bytes, peak bytes, and allocation rates can be queried from code with GetStats(), or dumped to a file with
+	/// WriteReport().
+	class HELIUM_ENGINE_API MemoryTelemetry
+	{
+	public:
+		/// Tracker categories.
+		enum ECategory
+		{
+			CATEGORY_FIRST   =  0,
+			CATEGORY_INVALID = -1,
+
+			/// Heap or allocator of a module.
+			CATEGORY_HEAP,
+			/// Asset instances, by asset type.
+			CATEGORY_ASSET_TYPE,
+			/// Render resources, by resource category.
+			CATEGORY_RENDER_RESOURCE,
+
+			CATEGORY_MAX,
+			CATEGORY_LAST = CATEGORY_MAX - 1
+		};
+
+		/// Function returning the number of bytes currently held by a sampled memory owner.
+		typedef size_t ( *SampleFunction )( void* pData );
+
+		/// Memory usage of a single tracker.
+		struct Stats
+		{
+			/// Tracker category.
+			ECategory category;
+			/// Tracker name.
+			Name name;
+
+			/// Number of bytes currently allocated.
+			uint64_t liveBytes;
+			/// Highest number of bytes allocated at once.
+			uint64_t peakBytes;
+			/// Number of allocations currently live (zero for sampled trackers).
+			uint64_t liveCount;
+			/// Total number of bytes allocated since startup.
+			uint64_t totalBytes;
+			/// Total number of allocations since startup.
+			uint64_t totalCount;
+
+			/// Number of bytes allocated per second, measured between the last two updates.
+			float32_t bytesPerSecond;
+			/// Number of allocations per second, measured between the last two updates.
+			float32_t allocationsPerSecond;
+		};
+
+		/// @name Initialization
+		//@{
+		static void Shutdown();
+		//@}
+
+		/// @name Recording
+		//@{
+		static uint32_t GetTracker( ECategory category, Name name );
+		static void RecordAllocation( uint32_t tracker, size_t size );
+		static void RecordFree( uint32_t tracker, size_t size );
+		static void RecordResize( uint32_t tracker, size_t oldSize, size_t newSize );
+
+		static uint32_t RegisterSampler( ECategory category, Name name, SampleFunction pFunction, void* pData );
+		static void UnregisterSampler( uint32_t tracker );
+
+		static void Update();
+		//@}
+
+		/// @name Reading
+		//@{
+		static void GetStats( DynamicArray< Stats >& rStats );
+		static bool WriteReport( const FilePath& rPath );
+
+		static const char* GetCategoryName( ECategory category );
+		//@}
+	};
+}
@@ -0,0 +1,627 @@
+#include "Precompile.h"
+#include "Engine/PackageArchive.h"
+
+#include "Foundation/BufferedStream.h"
+#include "Foundation/FileStream.h"
+#include "Foundation/Stream.h"
+#include "Engine/Cache.h"
+#include "Engine/FileLocations.h"
+#include "Engine/ReadAhead.h"
+
+#if HELIUM_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Helium;
+
+const char PackageArchive::ARCHIVE_FILE_EXTENSION[] = ".hpak";
+
+namespace
+{
+	/// Add a string to an archive string table being built, reusing a copy of it already in the table.
+	///
+	/// @param[in,out] rStringTable    String table.
+	/// @param[in,out] rStringOffsets  Offset of each string already in the table.
+	/// @param[in]     rString         String to add.
+	/// @param[out]    rOffset         Offset of the string in the table.
+	/// @param[out]    rLength         Length of the string.
+	void AddArchiveString(
+		DynamicArray< uint8_t >& rStringTable,
+		HashMap< Name, uint32_t >& rStringOffsets,
+		const String& rString,
+		uint32_t& rOffset,
+		uint32_t& rLength )
+	{
+		rLength = static_cast< uint32_t >( rString.GetSize() );
+		if( rLength == 0 )
+		{
+			rOffset = 0;
+
+			return;
+		}
+
+		Name stringName( rString );
+		HashMap< Name, uint32_t >::Iterator offsetIterator = rStringOffsets.Find( stringName );
+		if( offsetIterator != rStringOffsets.End() )
+		{
+			rOffset = offsetIterator->Second();
+
+			return;
+		}
+
+		rOffset = static_cast< uint32_t >( rStringTable.GetSize() );
+		rStringTable.AddArray( reinterpret_cast< const uint8_t* >( rString.GetData() ), rLength );
+		rStringOffsets.Insert( offsetIterator, HashMap< Name, uint32_t >::ValueType( stringName, rOffset ) );
+	}
+}
+
+/// Constructor.
+PackageArchive::PackageArchive()
+	: m_pFileData( NULL )
+	, m_fileSize( 0 )
+	, m_bMapped( false )
+{
+}
+
+/// Destructor.
+PackageArchive::~PackageArchive()
+{
+	Close();
+}
+
+/// Open an archive file.
+///
+/// The file is mapped into memory if possible, and read into memory otherwise.  Either way, the file is only opened
+/// once, and is not accessed again after this returns.
+///
+/// @param[in] rFilePath  Archive file path.
+///
+/// @return  True if the archive was opened successfully, false if it does not exist or is invalid.
+///
+/// @see Close()
+bool PackageArchive::Open( const FilePath& rFilePath )
+{
+	Close();
+
+	if( !MapFile( rFilePath ) && !ReadFile( rFilePath ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"PackageArchive::Open(): Failed to open archive \"%s\".\n",
+			rFilePath.Data() );
+
+		return false;
+	}
+
+	if( !ReadIndex( rFilePath ) )
+	{
+		Close();
+
+		return false;
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Debug,
+		"PackageArchive::Open(): Opened archive \"%s\" (%" PRIuSZ " objects, %" PRIu64 " bytes, %s).\n",
+		rFilePath.Data(),
+		m_objects.GetSize(),
+		m_fileSize,
+		( m_bMapped ? "mapped" : "read" ) );
+
+	return true;
+}
+
+/// Close the open archive, if any.
+///
+/// Any object data pointers previously obtained from this archive are invalid once this has been called.
+///
+/// @see Open()
+void PackageArchive::Close()
+{
+	m_objects.Clear();
+	m_objectIndices.Clear();
+
+	if( m_bMapped )
+	{
+		UnmapFile();
+	}
+
+	m_fileData.Clear();
+	m_pFileData = NULL;
+	m_fileSize = 0;
+	m_bMapped = false;
+}
+
+/// Find an object in the open archive.
+///
+/// @param[in] name  Asset name.
+///
+/// @return  Index of the object, or an invalid index if the archive does not contain an object with the given name.
+///
+/// @see GetObject()
+size_t PackageArchive::FindObject( Name name ) const
+{
+	HashMap< Name, size_t >::ConstIterator indexIterator = m_objectIndices.Find( name );
+	if( indexIterator == m_objectIndices.End() )
+	{
+		return Invalid< size_t >();
+	}
+
+	return indexIterator->Second();
+}
+
+/// Get the uncompressed data of an object.
+///
+/// Uncompressed objects are accessed in place.  Compressed objects are decompressed into the given buffer.  This may
+/// be called concurrently for different objects (with different buffers).
+///
+/// @param[in]  index    Object index.
+/// @param[out] rBuffer  Buffer into which to decompress the data if the object is compressed.
+///
+/// @return  Pointer to the object data (Object::uncompressedSize bytes), or null if the data could not be
+///          decompressed.
+const uint8_t* PackageArchive::GetObjectData( size_t index, DynamicArray< uint8_t >& rBuffer ) const
+{
+	const Object& rObject = GetObject( index );
+	if( rObject.codec == CompressionCodecs::None )
+	{
+		return rObject.pData;
+	}
+
+	rBuffer.Resize( rObject.uncompressedSize );
+	size_t decompressedSize = Compression::Decompress(
+		rObject.codec,
+		rBuffer.GetData(),
+		rBuffer.GetSize(),
+		rObject.pData,
+		rObject.size );
+	if( decompressedSize != rObject.uncompressedSize )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"PackageArchive::GetObjectData(): Failed to decompress data of object \"%s\".\n",
+			*rObject.name );
+
+		rBuffer.Resize( 0 );
+
+		return NULL;
+	}
+
+	return rBuffer.GetData();
+}
+
+/// Hint the OS to start paging in the data of an object that will be accessed soon.
+///
+/// This only has an effect on mapped archives (archives read into memory are already resident).
+///
+/// @param[in] index  Object index.
+void PackageArchive::PrefetchObjectData( size_t index ) const
+{
+	if( !m_bMapped )
+	{
+		return;
+	}
+
+	const Object& rObject = GetObject( index );
+	ReadAhead::HintMemoryRange( rObject.pData, rObject.size );
+}
+
+/// Write an archive file.
+///
+/// The archive is written to a temporary file, which then replaces any existing archive, so a process that has the
+/// existing archive open is not affected.
+///
+/// @param[in] rFilePath    Archive file path.
+/// @param[in] pObjects     Objects to write.
+/// @param[in] objectCount  Number of objects to write.
+/// @param[in] codec        Codec with which to compress the object data.  Objects that compressing does not make any
+///                         smaller are stored uncompressed.
+///
+/// @return  True if the archive was written successfully, false if not.
+bool PackageArchive::Write(
+	const FilePath& rFilePath,
+	const ObjectSource* pObjects,
+	size_t objectCount,
+	CompressionCodec codec )
+{
+	HELIUM_ASSERT( pObjects || objectCount == 0 );
+
+	if( objectCount > UINT32_MAX )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"PackageArchive::Write(): Too many objects to write to archive \"%s\".\n",
+			rFilePath.Data() );
+
+		return false;
+	}
+
+	// Build the index and string table, and compress the object data, so all offsets are known before writing.
+	DynamicArray< IndexEntry > indexEntries;
+	indexEntries.Reserve( objectCount );
+	DynamicArray< uint8_t > stringTable;
+	HashMap< Name, uint32_t > stringOffsets;
+	DynamicArray< DynamicArray< uint8_t > > compressedData;
+	compressedData.Resize( objectCount );
+
+	for( size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex )
+	{
+		const ObjectSource& rSource = pObjects[ objectIndex ];
+		HELIUM_ASSERT( !rSource.name.IsEmpty() );
+		HELIUM_ASSERT( !rSource.typeName.IsEmpty() );
+		HELIUM_ASSERT( rSource.pData || rSource.size == 0 );
+
+		if( rSource.size > UINT32_MAX )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"PackageArchive::Write(): Object \"%s\" is too large to write to archive \"%s\".\n",
+				*rSource.name,
+				rFilePath.Data() );
+
+			return false;
+		}
+
+		IndexEntry* pEntry = indexEntries.New();
+		HELIUM_ASSERT( pEntry );
+		MemoryZero( pEntry, sizeof( *pEntry ) );
+
+		AddArchiveString( stringTable, stringOffsets, String( *rSource.name ), pEntry->nameOffset, pEntry->nameLength );
+		AddArchiveString(
+			stringTable, stringOffsets, String( *rSource.typeName ), pEntry->typeNameOffset, pEntry->typeNameLength );
+		AddArchiveString(
+			stringTable, stringOffsets, rSource.templatePath, pEntry->templatePathOffset, pEntry->templatePathLength );
+
+		pEntry->uncompressedSize = static_cast< uint32_t >( rSource.size );
+		pEntry->size = pEntry->uncompressedSize;
+		pEntry->codec = static_cast< uint8_t >( CompressionCodecs::None );
+
+		if( codec != CompressionCodecs::None &&
+			Compression::Compress( codec, rSource.pData, rSource.size, compressedData[ objectIndex ] ) &&
+			compressedData[ objectIndex ].GetSize() < rSource.size )
+		{
+			pEntry->size = static_cast< uint32_t >( compressedData[ objectIndex ].GetSize() );
+			pEntry->codec = static_cast< uint8_t >( codec );
+		}
+		else
+		{
+			compressedData[ objectIndex ].Clear();
+		}
+	}
+
+	if( stringTable.GetSize() > UINT32_MAX )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"PackageArchive::Write(): String table of archive \"%s\" is too large.\n",
+			rFilePath.Data() );
+
+		return false;
+	}
+
+	Header header;
+	header.signature = SIGNATURE;
+	header.version = VERSION;
+	header.objectCount = static_cast< uint32_t >( objectCount );
+	header.stringTableSize = static_cast< uint32_t >( stringTable.GetSize() );
+
+	uint64_t dataOffset = sizeof( header ) + sizeof( IndexEntry ) * objectCount + stringTable.GetSize();
+	for( size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex )
+	{
+		indexEntries[ objectIndex ].dataOffset = dataOffset;
+		dataOffset += indexEntries[ objectIndex ].size;
+	}
+
+	String fileName( rFilePath.Data() );
+	String temporaryFileName = fileName + ".tmp";
+
+	FileStream* pFileStream = FileStream::OpenFileStream( temporaryFileName, FileStream::MODE_WRITE, true );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"PackageArchive::Write(): Failed to open \"%s\" for writing.\n",
+			*temporaryFileName );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+		bufferedStream.Write( &header, sizeof( header ), 1 );
+		bufferedStream.Write( indexEntries.GetData(), sizeof( IndexEntry ), indexEntries.GetSize() );
+		bufferedStream.Write( stringTable.GetData(), 1, stringTable.GetSize() );
+
+		for( size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex )
+		{
+			const DynamicArray< uint8_t >& rCompressedData = compressedData[ objectIndex ];
+			if( rCompressedData.IsEmpty() )
+			{
+				bufferedStream.Write( pObjects[ objectIndex ].pData, 1, pObjects[ objectIndex ].size );
+			}
+			else
+			{
+				bufferedStream.Write( rCompressedData.GetData(), 1, rCompressedData.GetSize() );
+			}
+		}
+	}
+
+	delete pFileStream;
+
+	if( !Cache::RenameFile( temporaryFileName, fileName ) )
+	{
+		Cache::RemoveFile( temporaryFileName );
+
+		return false;
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"PackageArchive::Write(): Wrote %" PRIuSZ " objects (%" PRIu64 " bytes) to archive \"%s\".\n",
+		objectCount,
+		dataOffset,
+		*fileName );
+
+	return true;
+}
+
+/// Get the path of the archive file for a package.
+///
+/// Archives live in the data directory, next to where the package's directory of object files would be.
+///
+/// @param[in]  packagePath  Package path.
+/// @param[out] rPath        Archive file path.
+///
+/// @return  True if the path was determined, false if no data directory is available.
+bool PackageArchive::GetArchiveFilePath( AssetPath packagePath, FilePath& rPath )
+{
+	HELIUM_ASSERT( packagePath.IsPackage() );
+
+	FilePath dataDirectory;
+	if( !FileLocations::GetDataDirectory( dataDirectory ) )
+	{
+		return false;
+	}
+
+	rPath = dataDirectory + packagePath.ToFilePathString().GetData() + ARCHIVE_FILE_EXTENSION;
+
+	return true;
+}
+
+/// Map an archive file into memory for read-only access.
+///
+/// @param[in] rFilePath  Archive file path.
+///
+/// @return  True if the file was mapped, false if not.
+bool PackageArchive::MapFile( const FilePath& rFilePath )
+{
+	HELIUM_ASSERT( !m_pFileData );
+
+	const void* pMappedData = NULL;
+	uint64_t mappedSize = 0;
+
+#if HELIUM_OS_WIN
+	HANDLE hFile = CreateFileA(
+		rFilePath.Data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( hFile != INVALID_HANDLE_VALUE )
+	{
+		LARGE_INTEGER fileSize;
+		if( GetFileSizeEx( hFile, &fileSize ) && fileSize.QuadPart > 0 &&
+			static_cast< uint64_t >( fileSize.QuadPart ) <= static_cast< uint64_t >( static_cast< size_t >( -1 ) ) )
+		{
+			HANDLE hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+			if( hMapping )
+			{
+				// The view keeps the mapping object alive, so neither handle needs to be kept around.
+				pMappedData = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+				if( pMappedData )
+				{
+					mappedSize = static_cast< uint64_t >( fileSize.QuadPart );
+				}
+
+				CloseHandle( hMapping );
+			}
+		}
+
+		CloseHandle( hFile );
+	}
+#else
+	int fileDescriptor = open( rFilePath.Data(), O_RDONLY );
+	if( fileDescriptor >= 0 )
+	{
+		struct stat fileStat;
+		if( fstat( fileDescriptor, &fileStat ) == 0 && fileStat.st_size > 0 &&
+			static_cast< uint64_t >( fileStat.st_size ) <= static_cast< uint64_t >( static_cast< size_t >( -1 ) ) )
+		{
+			void* pView = mmap( NULL, static_cast< size_t >( fileStat.st_size ), PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+			if( pView != MAP_FAILED )
+			{
+				pMappedData = pView;
+				mappedSize = static_cast< uint64_t >( fileStat.st_size );
+			}
+		}
+
+		// The mapping remains valid after the file is closed.
+		close( fileDescriptor );
+	}
+#endif
+
+	if( !pMappedData )
+	{
+		return false;
+	}
+
+	m_pFileData = static_cast< const uint8_t* >( pMappedData );
+	m_fileSize = mappedSize;
+	m_bMapped = true;
+
+	return true;
+}
+
+/// Release the memory mapping of the archive file.
+void PackageArchive::UnmapFile()
+{
+	HELIUM_ASSERT( m_bMapped );
+	HELIUM_ASSERT( m_pFileData );
+
+#if HELIUM_OS_WIN
+	HELIUM_VERIFY( UnmapViewOfFile( m_pFileData ) );
+#else
+	HELIUM_VERIFY( munmap( const_cast< uint8_t* >( m_pFileData ), static_cast< size_t >( m_fileSize ) ) == 0 );
+#endif
+
+	m_pFileData = NULL;
+	m_fileSize = 0;
+	m_bMapped = false;
+}
+
+/// Read an archive file into memory, for when it cannot be mapped.
+///
+/// @param[in] rFilePath  Archive file path.
+///
+/// @return  True if the file was read, false if not.
+bool PackageArchive::ReadFile( const FilePath& rFilePath )
+{
+	HELIUM_ASSERT( !m_pFileData );
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rFilePath.Data(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		return false;
+	}
+
+	int64_t size64 = pFileStream->GetSize();
+	if( size64 <= 0 || static_cast< uint64_t >( size64 ) > static_cast< size_t >( -1 ) )
+	{
+		delete pFileStream;
+
+		return false;
+	}
+
+	m_fileData.Resize( static_cast< size_t >( size64 ) );
+	size_t bytesRead = pFileStream->Read( m_fileData.GetData(), 1, m_fileData.GetSize() );
+
+	delete pFileStream;
+
+	if( bytesRead != m_fileData.GetSize() )
+	{
+		m_fileData.Clear();
+
+		return false;
+	}
+
+	m_pFileData = m_fileData.GetData();
+	m_fileSize = static_cast< uint64_t >( m_fileData.GetSize() );
+
+	return true;
+}
+
+/// Read the index of the archive file in memory, checking that every object lies within the file.
+///
+/// @param[in] rFilePath  Archive file path (for logging).
+///
+/// @return  True if the index was read successfully, false if the archive is invalid.
+bool PackageArchive::ReadIndex( const FilePath& rFilePath )
+{
+	HELIUM_ASSERT( m_pFileData );
+
+	Header header;
+	if( m_fileSize < sizeof( header ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"PackageArchive: Archive \"%s\" is too small to hold its header.\n",
+			rFilePath.Data() );
+
+		return false;
+	}
+
+	MemoryCopy( &header, m_pFileData, sizeof( header ) );
+	if( header.signature != SIGNATURE || header.version != VERSION )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"PackageArchive: \"%s\" is not an archive of the current version (%" PRIu32 ").\n",
+			rFilePath.Data(),
+			VERSION );
+
+		return false;
+	}
+
+	uint64_t stringTableOffset = sizeof( header ) + static_cast< uint64_t >( sizeof( IndexEntry ) ) * header.objectCount;
+	if( stringTableOffset + header.stringTableSize > m_fileSize )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"PackageArchive: Index of archive \"%s\" extends past the end of the file.\n",
+			rFilePath.Data() );
+
+		return false;
+	}
+
+	const char* pStringTable = reinterpret_cast< const char* >( m_pFileData + stringTableOffset );
+
+	m_objects.Reserve( header.objectCount );
+	for( uint32_t objectIndex = 0; objectIndex < header.objectCount; ++objectIndex )
+	{
+		IndexEntry entry;
+		MemoryCopy( &entry, m_pFileData + sizeof( header ) + sizeof( IndexEntry ) * objectIndex, sizeof( entry ) );
+
+		if( static_cast< uint64_t >( entry.nameOffset ) + entry.nameLength > header.stringTableSize ||
+			static_cast< uint64_t >( entry.typeNameOffset ) + entry.typeNameLength > header.stringTableSize ||
+			static_cast< uint64_t >( entry.templatePathOffset ) + entry.templatePathLength > header.stringTableSize ||
+			entry.nameLength == 0 ||
+			entry.typeNameLength == 0 ||
+			entry.dataOffset > m_fileSize ||
+			entry.size > m_fileSize - entry.dataOffset ||
+			entry.codec >= CompressionCodecs::Count ||
+			( entry.codec == CompressionCodecs::None && entry.size != entry.uncompressedSize ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"PackageArchive: Index entry %" PRIu32 " of archive \"%s\" is invalid.\n",
+				objectIndex,
+				rFilePath.Data() );
+
+			m_objects.Clear();
+			m_objectIndices.Clear();
+
+			return false;
+		}
+
+		Object* pObject = m_objects.New();
+		HELIUM_ASSERT( pObject );
+		pObject->name.Set( String( pStringTable + entry.nameOffset, entry.nameLength ) );
+		pObject->typeName.Set( String( pStringTable + entry.typeNameOffset, entry.typeNameLength ) );
+		pObject->templatePath = String( pStringTable + entry.templatePathOffset, entry.templatePathLength );
+		pObject->pData = m_pFileData + entry.dataOffset;
+		pObject->size = entry.size;
+		pObject->uncompressedSize = entry.uncompressedSize;
+		pObject->codec = static_cast< CompressionCodec >( entry.codec );
+
+		HashMap< Name, size_t >::Iterator indexIterator = m_objectIndices.Find( pObject->name );
+		if( indexIterator != m_objectIndices.End() )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"PackageArchive: Archive \"%s\" contains object \"%s\" more than once; using the last copy.\n",
+				rFilePath.Data(),
+				*pObject->name );
+
+			m_objects[ indexIterator->Second() ] = *pObject;
+			m_objects.Pop();
+
+			continue;
+		}
+
+		m_objectIndices.Insert(
+			indexIterator, HashMap< Name, size_t >::ValueType( pObject->name, m_objects.GetSize() - 1 ) );
+	}
+
+	return true;
+}
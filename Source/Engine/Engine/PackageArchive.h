@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/HashMap.h"
+
+#include "Engine/AssetPath.h"
+#include "Engine/Compression.h"
+
+namespace Helium
+{
+	/// Packed archive of the object files of a loose package.
+	///
+	/// An archive bundles the serialized (JSON) object files of one package into a single file, so loading the package
+	/// takes one file open instead of a directory scan and one open per object.  The file starts with a header and an
+	/// index holding the name, type and template of each object, followed by a string table and the object data.
+	/// Object data may be compressed.  Archives are mapped read-only, so uncompressed objects are deserialized in
+	/// place.
+	class HELIUM_ENGINE_API PackageArchive : NonCopyable
+	{
+	public:
+		/// Archive file signature ("HPAK").
+		static const uint32_t SIGNATURE = 0x4b415048;
+		/// Archive format version.
+		static const uint32_t VERSION = 1;
+		/// Extension of archive files, which are placed next to where the package directory would be.
+		static const char ARCHIVE_FILE_EXTENSION[];
+
+		/// Object in an open archive.
+		struct Object
+		{
+			/// Asset name.
+			Name name;
+			/// Type name.
+			Name typeName;
+			/// Template path (empty for the type's default template).
+			String templatePath;
+
+			/// Object data as stored in the archive.
+			const uint8_t* pData;
+			/// Size of the data as stored in the archive.
+			uint32_t size;
+			/// Size of the data once decompressed (the same as the stored size for uncompressed objects).
+			uint32_t uncompressedSize;
+			/// Codec with which the data is compressed.
+			CompressionCodec codec;
+		};
+
+		/// Object to write to an archive.
+		struct ObjectSource
+		{
+			/// Asset name.
+			Name name;
+			/// Type name.
+			Name typeName;
+			/// Template path (empty for the type's default template).
+			String templatePath;
+
+			/// Object file contents.
+			const void* pData;
+			/// Size of the object file contents.
+			size_t size;
+		};
+
+		/// @name Construction/Destruction
+		//@{
+		PackageArchive();
+		~PackageArchive();
+		//@}
+
+		/// @name Loading
+		//@{
+		bool Open( const FilePath& rFilePath );
+		void Close();
+		inline bool IsOpen() const;
+		inline bool IsMapped() const;
+		//@}
+
+		/// @name Object Access
+		//@{
+		inline size_t GetObjectCount() const;
+		inline const Object& GetObject( size_t index ) const;
+		size_t FindObject( Name name ) const;
+
+		const uint8_t* GetObjectData( size_t index, DynamicArray< uint8_t >& rBuffer ) const;
+		void PrefetchObjectData( size_t index ) const;
+		//@}
+
+		/// @name Writing
+		//@{
+		static bool Write(
+			const FilePath& rFilePath, const ObjectSource* pObjects, size_t objectCount, CompressionCodec codec );
+		//@}
+
+		/// @name Static Utility Functions
+		//@{
+		static bool GetArchiveFilePath( AssetPath packagePath, FilePath& rPath );
+		//@}
+
+	private:
+		/// Archive file header.
+		struct Header
+		{
+			/// Archive file signature.
+			uint32_t signature;
+			/// Archive format version.
+			uint32_t version;
+			/// Number of objects in the index.
+			uint32_t objectCount;
+			/// Size of the string table following the index.
+			uint32_t stringTableSize;
+		};
+
+		/// Index entry of an object, as stored in the archive file.
+		struct IndexEntry
+		{
+			/// Offset of the object data from the start of the file.
+			uint64_t dataOffset;
+			/// Size of the data as stored in the archive.
+			uint32_t size;
+			/// Size of the data once decompressed.
+			uint32_t uncompressedSize;
+
+			/// Offset of the asset name in the string table.
+			uint32_t nameOffset;
+			/// Length of the asset name.
+			uint32_t nameLength;
+			/// Offset of the type name in the string table.
+			uint32_t typeNameOffset;
+			/// Length of the type name.
+			uint32_t typeNameLength;
+			/// Offset of the template path in the string table.
+			uint32_t templatePathOffset;
+			/// Length of the template path (zero if the object uses its type's default template).
+			uint32_t templatePathLength;
+
+			/// Codec with which the data is compressed (CompressionCodec value).
+			uint8_t codec;
+			/// Padding.
+			uint8_t padding[ 7 ];
+		};
+
+		/// Archive file contents, either mapped or read into m_fileData.
+		const uint8_t* m_pFileData;
+		/// Size of the archive file contents.
+		uint64_t m_fileSize;
+		/// True if m_pFileData points to a mapping of the file.
+		bool m_bMapped;
+		/// Archive file contents, if the file could not be mapped.
+		DynamicArray< uint8_t > m_fileData;
+
+		/// Objects in the archive.
+		DynamicArray< Object > m_objects;
+		/// Index in m_objects of each object name.
+		HashMap< Name, size_t > m_objectIndices;
+
+		/// @name Private Utility Functions
+		//@{
+		bool MapFile( const FilePath& rFilePath );
+		void UnmapFile();
+		bool ReadFile( const FilePath& rFilePath );
+		bool ReadIndex( const FilePath& rFilePath );
+		//@}
+	};
+}
+
+#include "Engine/PackageArchive.inl"
@@ -0,0 +1,44 @@
+namespace Helium
+{
+	/// Get whether an archive file is open.
+	///
+	/// @return  True if an archive is open, false if not.
+	///
+	/// @see Open(), Close()
+	bool PackageArchive::IsOpen() const
+	{
+		return m_pFileData != NULL;
+	}
+
+	/// Get whether the open archive file is mapped into memory, rather than read into a buffer.
+	///
+	/// @return  True if the archive is mapped, false if not.
+	bool PackageArchive::IsMapped() const
+	{
+		return m_bMapped;
+	}
+
+	/// Get the number of objects in the open archive.
+	///
+	/// @return  Object count.
+	///
+	/// @see GetObject()
+	size_t PackageArchive::GetObjectCount() const
+	{
+		return m_objects.GetSize();
+	}
+
+	/// Get the object with the given index.
+	///
+	/// @param[in] index  Object index.
+	///
+	/// @return  Object information.
+	///
+	/// @see GetObjectCount(), FindObject()
+	const PackageArchive::Object& PackageArchive::GetObject( size_t index ) const
+	{
+		HELIUM_ASSERT( index < m_objects.GetSize() );
+
+		return m_objects[ index ];
+	}
+}
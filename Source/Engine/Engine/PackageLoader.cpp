@@ -26,6 +26,16 @@ int64_t PackageLoader::GetAssetFileSystemTimestamp( const AssetPath &path ) cons
 	return INT64_MIN;
 }
 
+/// Get the type name of an asset in this package without loading the asset.
+///
+/// @param[in] path  Asset path.
+///
+/// @return  Name of the asset's type, or a null name if it isn't known by this loader.
+Name PackageLoader::GetAssetTypeName( const AssetPath &path ) const
+{
+	return Name( NULL_NAME );
+}
+
 void PackageLoader::EnumerateChildren( DynamicArray< AssetPath > &children ) const
 {
 	HELIUM_BREAK_MSG("We tried to enumerate children with a package loader that doesn't support doing that!");
@@ -37,6 +47,23 @@ bool PackageLoader::SaveAsset( Asset *pAsset ) const
 	return false;
 }
 
+/// Serialize an asset into memory instead of saving it, so the file can be written later (and elsewhere).
+///
+/// This may be called for different assets concurrently.  The asset must not be modified during the call.
+///
+/// @param[in]  pAsset     Asset to serialize.
+/// @param[out] rBuffer    Contents to write to the asset file.
+/// @param[out] rFilePath  Asset file to write.
+///
+/// @return  True if the asset was serialized, false if not.
+///
+/// @see SaveAsset()
+bool PackageLoader::SerializeAsset( Asset *pAsset, DynamicArray< uint8_t > &rBuffer, FilePath &rFilePath ) const
+{
+	HELIUM_BREAK_MSG("We tried to serialize an asset with a package loader that doesn't support doing that!");
+	return false;
+}
+
 #endif
 
 /// @fn size_t PackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResolver *pResolver )
@@ -35,11 +35,13 @@ namespace Helium
 		virtual bool HasAssetFileState() const;
 		virtual const FilePath &GetAssetFileSystemPath( const AssetPath &path ) const;
 		virtual int64_t GetAssetFileSystemTimestamp( const AssetPath &path ) const;
+		virtual Name GetAssetTypeName( const AssetPath &path ) const;
 		//@}
 		
 		virtual void EnumerateChildren( DynamicArray< AssetPath > &children ) const;
 
 		virtual bool SaveAsset( Asset *pAsset ) const;
+		virtual bool SerializeAsset( Asset *pAsset, DynamicArray< uint8_t > &rBuffer, FilePath &rFilePath ) const;
 #endif // #if HELIUM_TOOLS
 	};
 }
@@ -0,0 +1,448 @@
+#include "Precompile.h"
+#include "Engine/PrefetchManifest.h"
+
+#include "Foundation/Stream.h"
+
+using namespace Helium;
+
+/// Visit state flags used while sorting and gathering records.
+enum EVisitFlag
+{
+	VISIT_FLAG_STARTED  = 1 << 0,
+	VISIT_FLAG_FINISHED = 1 << 1,
+};
+
+/// Read a value from a manifest buffer, advancing the read position.
+///
+/// @param[out]    rValue    Value read.
+/// @param[in,out] rpCurrent Current read position.
+/// @param[in]     pEnd      End of the manifest buffer.
+///
+/// @return  True if the value was read, false if the end of the buffer was reached.
+template< typename T >
+static bool ReadManifestValue( T& rValue, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+{
+	if( static_cast< size_t >( pEnd - rpCurrent ) < sizeof( T ) )
+	{
+		return false;
+	}
+
+	MemoryCopy( &rValue, rpCurrent, sizeof( T ) );
+	rpCurrent += sizeof( T );
+
+	return true;
+}
+
+/// Find a path in a path list.
+///
+/// @param[in] rPaths  Path list.
+/// @param[in] path    Path to find.
+///
+/// @return  Index of the path in the list, or an invalid index if it is not in the list.
+static size_t FindPath( const DynamicArray< AssetPath >& rPaths, AssetPath path )
+{
+	size_t pathCount = rPaths.GetSize();
+	for( size_t pathIndex = 0; pathIndex < pathCount; ++pathIndex )
+	{
+		if( rPaths[ pathIndex ] == path )
+		{
+			return pathIndex;
+		}
+	}
+
+	return Invalid< size_t >();
+}
+
+/// Constructor.
+PrefetchManifest::PrefetchManifest()
+: m_bSorted( true )
+{
+}
+
+/// Remove all records from this manifest.
+void PrefetchManifest::Clear()
+{
+	m_records.Clear();
+	m_bSorted = true;
+}
+
+/// Set the dependencies of an asset, adding a record for it if it does not have one yet.
+///
+/// Sort() must be called after updating records and before writing the manifest or gathering dependencies.
+///
+/// @param[in] path           Asset path.
+/// @param[in] rDependencies  Paths of the assets referenced by the asset.
+///
+/// @see Sort()
+void PrefetchManifest::SetDependencies( AssetPath path, const DynamicArray< AssetPath >& rDependencies )
+{
+	HELIUM_ASSERT( !path.IsEmpty() );
+
+	Record* pRecord;
+	size_t recordIndex = FindRecord( path );
+	if( IsValid( recordIndex ) )
+	{
+		pRecord = &m_records[ recordIndex ];
+	}
+	else
+	{
+		pRecord = m_records.New();
+		HELIUM_ASSERT( pRecord );
+		pRecord->path = path;
+	}
+
+	pRecord->dependencies = rDependencies;
+	pRecord->recordDependencies.Resize( 0 );
+
+	m_bSorted = false;
+}
+
+/// Find the record for an asset.
+///
+/// @param[in] path  Asset path.
+///
+/// @return  Index of the record for the asset, or an invalid index if the manifest has no record for it.
+size_t PrefetchManifest::FindRecord( AssetPath path ) const
+{
+	size_t recordCount = m_records.GetSize();
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		if( m_records[ recordIndex ].path == path )
+		{
+			return recordIndex;
+		}
+	}
+
+	return Invalid< size_t >();
+}
+
+/// Put the records in dependency order and link each record to the records of its dependencies in this manifest.
+///
+/// Records that depend on each other in a cycle are kept in the order in which the cycle was found.
+void PrefetchManifest::Sort()
+{
+	if( m_bSorted )
+	{
+		return;
+	}
+
+	size_t recordCount = m_records.GetSize();
+
+	DynamicArray< uint8_t > visitFlags;
+	visitFlags.Resize( recordCount );
+	MemoryZero( visitFlags.GetData(), recordCount );
+
+	DynamicArray< Record > sortedRecords;
+	sortedRecords.Reserve( recordCount );
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		SortRecord( recordIndex, visitFlags, sortedRecords );
+	}
+
+	m_records.Swap( sortedRecords );
+
+	// Link the records now that their indices are final.
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		Record& rRecord = m_records[ recordIndex ];
+		rRecord.recordDependencies.Resize( 0 );
+
+		size_t dependencyCount = rRecord.dependencies.GetSize();
+		for( size_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+		{
+			size_t dependencyRecordIndex = FindRecord( rRecord.dependencies[ dependencyIndex ] );
+			rRecord.recordDependencies.Push( IsValid( dependencyRecordIndex )
+				? static_cast< uint32_t >( dependencyRecordIndex )
+				: Invalid< uint32_t >() );
+		}
+	}
+
+	m_bSorted = true;
+}
+
+/// Get the paths of all assets an asset depends on, directly or through other assets in this manifest.
+///
+/// Paths are added in dependency order, and the asset itself is not included.  Dependencies outside of the package
+/// are included, but not followed any further, and may be listed more than once.
+///
+/// @param[in]  path    Asset path.
+/// @param[out] rPaths  Dependency paths.
+void PrefetchManifest::GatherDependencies( AssetPath path, DynamicArray< AssetPath >& rPaths ) const
+{
+	HELIUM_ASSERT( m_bSorted );
+
+	rPaths.Resize( 0 );
+
+	size_t recordIndex = FindRecord( path );
+	if( IsInvalid( recordIndex ) )
+	{
+		return;
+	}
+
+	size_t recordCount = m_records.GetSize();
+	m_visitFlags.Resize( recordCount );
+	MemoryZero( m_visitFlags.GetData(), recordCount );
+
+	GatherRecordDependencies( recordIndex, rPaths );
+
+	// Drop the asset itself, which is added last (or not at all if it is part of a dependency cycle).
+	if( !rPaths.IsEmpty() && rPaths.GetLast() == path )
+	{
+		rPaths.Pop();
+	}
+}
+
+/// Write this manifest to a stream.
+///
+/// The manifest must be sorted (see Sort()).  Values are written through the stream, so a byte swapping stream can
+/// be used to write a manifest for a platform of a different endianness.
+///
+/// @param[in] rStream  Stream to which the manifest should be written.
+///
+/// @see Read()
+void PrefetchManifest::Write( Stream& rStream ) const
+{
+	HELIUM_ASSERT( m_bSorted );
+
+	uint32_t version = VERSION;
+	rStream.Write( &version, sizeof( version ), 1 );
+
+	// Paths of the records come first in the path table, followed by those of dependencies outside of the package.
+	DynamicArray< AssetPath > paths;
+	size_t recordCount = m_records.GetSize();
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		paths.Push( m_records[ recordIndex ].path );
+	}
+
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		const Record& rRecord = m_records[ recordIndex ];
+		size_t dependencyCount = rRecord.dependencies.GetSize();
+		for( size_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+		{
+			AssetPath dependencyPath = rRecord.dependencies[ dependencyIndex ];
+			if( IsInvalid( FindPath( paths, dependencyPath ) ) )
+			{
+				paths.Push( dependencyPath );
+			}
+		}
+	}
+
+	HELIUM_ASSERT( paths.GetSize() <= UINT32_MAX );
+	uint32_t pathCount = static_cast< uint32_t >( paths.GetSize() );
+	rStream.Write( &pathCount, sizeof( pathCount ), 1 );
+
+	String pathString;
+	for( uint32_t pathIndex = 0; pathIndex < pathCount; ++pathIndex )
+	{
+		paths[ pathIndex ].ToString( pathString );
+
+		uint32_t pathLength = static_cast< uint32_t >( pathString.GetSize() );
+		rStream.Write( &pathLength, sizeof( pathLength ), 1 );
+		rStream.Write( pathString.GetData(), sizeof( char ), pathLength );
+	}
+
+	uint32_t recordCount32 = static_cast< uint32_t >( recordCount );
+	rStream.Write( &recordCount32, sizeof( recordCount32 ), 1 );
+
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		const Record& rRecord = m_records[ recordIndex ];
+
+		uint32_t dependencyCount = static_cast< uint32_t >( rRecord.dependencies.GetSize() );
+		rStream.Write( &dependencyCount, sizeof( dependencyCount ), 1 );
+
+		for( uint32_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+		{
+			size_t pathIndex = FindPath( paths, rRecord.dependencies[ dependencyIndex ] );
+			HELIUM_ASSERT( IsValid( pathIndex ) );
+
+			uint32_t pathIndex32 = static_cast< uint32_t >( pathIndex );
+			rStream.Write( &pathIndex32, sizeof( pathIndex32 ), 1 );
+		}
+	}
+}
+
+/// Read a manifest written by Write(), replacing the contents of this manifest.
+///
+/// @param[in] pData  Manifest data, in the byte order of the current platform.
+/// @param[in] size   Size of the manifest data.
+///
+/// @return  True if the manifest was read successfully, false if the data is invalid (in which case this manifest is
+///          left empty).
+///
+/// @see Write()
+bool PrefetchManifest::Read( const uint8_t* pData, size_t size )
+{
+	HELIUM_ASSERT( pData || size == 0 );
+
+	Clear();
+
+	const uint8_t* pCurrent = pData;
+	const uint8_t* pEnd = pData + size;
+
+	uint32_t version = 0;
+	if( !ReadManifestValue( version, pCurrent, pEnd ) || version != VERSION )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"PrefetchManifest::Read(): Manifest version %" PRIu32 " does not match the current version (%" PRIu32 ").\n",
+			version,
+			VERSION );
+
+		return false;
+	}
+
+	uint32_t pathCount = 0;
+	if( !ReadManifestValue( pathCount, pCurrent, pEnd ) )
+	{
+		return false;
+	}
+
+	DynamicArray< AssetPath > paths;
+	paths.Reserve( pathCount );
+
+	for( uint32_t pathIndex = 0; pathIndex < pathCount; ++pathIndex )
+	{
+		uint32_t pathLength = 0;
+		if( !ReadManifestValue( pathLength, pCurrent, pEnd ) || pathLength > static_cast< size_t >( pEnd - pCurrent ) )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "PrefetchManifest::Read(): Path table is truncated.\n" );
+
+			return false;
+		}
+
+		String pathString( reinterpret_cast< const char* >( pCurrent ), pathLength );
+		pCurrent += pathLength;
+
+		AssetPath* pPath = paths.New();
+		HELIUM_ASSERT( pPath );
+		if( !pPath->Set( pathString ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"PrefetchManifest::Read(): Invalid path \"%s\" in the path table.\n",
+				*pathString );
+
+			return false;
+		}
+	}
+
+	uint32_t recordCount = 0;
+	if( !ReadManifestValue( recordCount, pCurrent, pEnd ) || recordCount > pathCount )
+	{
+		return false;
+	}
+
+	m_records.Reserve( recordCount );
+	for( uint32_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		Record* pRecord = m_records.New();
+		HELIUM_ASSERT( pRecord );
+		pRecord->path = paths[ recordIndex ];
+
+		uint32_t dependencyCount = 0;
+		if( !ReadManifestValue( dependencyCount, pCurrent, pEnd ) )
+		{
+			Clear();
+
+			return false;
+		}
+
+		pRecord->dependencies.Reserve( dependencyCount );
+		for( uint32_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+		{
+			uint32_t pathIndex = 0;
+			if( !ReadManifestValue( pathIndex, pCurrent, pEnd ) || pathIndex >= pathCount )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Warning,
+					"PrefetchManifest::Read(): Invalid dependency for \"%s\".\n",
+					*pRecord->path.ToString() );
+
+				Clear();
+
+				return false;
+			}
+
+			pRecord->dependencies.Push( paths[ pathIndex ] );
+
+			// Record paths come first in the path table, so their path table indices are also their record indices.
+			pRecord->recordDependencies.Push( pathIndex < recordCount ? pathIndex : Invalid< uint32_t >() );
+		}
+	}
+
+	return true;
+}
+
+/// Add a record to the sorted record list after the records it depends on.
+///
+/// @param[in]     recordIndex     Index of the record to add.
+/// @param[in,out] rVisitFlags     Visit flags for each record.
+/// @param[in,out] rSortedRecords  Sorted record list.
+void PrefetchManifest::SortRecord(
+	size_t recordIndex,
+	DynamicArray< uint8_t >& rVisitFlags,
+	DynamicArray< Record >& rSortedRecords )
+{
+	HELIUM_ASSERT( recordIndex < m_records.GetSize() );
+
+	if( rVisitFlags[ recordIndex ] & VISIT_FLAG_STARTED )
+	{
+		return;
+	}
+
+	rVisitFlags[ recordIndex ] |= VISIT_FLAG_STARTED;
+
+	const Record& rRecord = m_records[ recordIndex ];
+	size_t dependencyCount = rRecord.dependencies.GetSize();
+	for( size_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+	{
+		size_t dependencyRecordIndex = FindRecord( rRecord.dependencies[ dependencyIndex ] );
+		if( IsValid( dependencyRecordIndex ) )
+		{
+			SortRecord( dependencyRecordIndex, rVisitFlags, rSortedRecords );
+		}
+	}
+
+	rSortedRecords.Push( rRecord );
+	rVisitFlags[ recordIndex ] |= VISIT_FLAG_FINISHED;
+}
+
+/// Add the dependencies of a record to a path list, followed by the path of the record itself.
+///
+/// @param[in]     recordIndex  Record index.
+/// @param[in,out] rPaths       Path list.
+void PrefetchManifest::GatherRecordDependencies( size_t recordIndex, DynamicArray< AssetPath >& rPaths ) const
+{
+	HELIUM_ASSERT( recordIndex < m_records.GetSize() );
+
+	if( m_visitFlags[ recordIndex ] & VISIT_FLAG_STARTED )
+	{
+		return;
+	}
+
+	m_visitFlags[ recordIndex ] |= VISIT_FLAG_STARTED;
+
+	// Dependencies outside of the package have no record here, so they are added directly.
+	const Record& rRecord = m_records[ recordIndex ];
+	HELIUM_ASSERT( rRecord.recordDependencies.GetSize() == rRecord.dependencies.GetSize() );
+
+	size_t dependencyCount = rRecord.dependencies.GetSize();
+	for( size_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+	{
+		uint32_t dependencyRecordIndex = rRecord.recordDependencies[ dependencyIndex ];
+		if( IsValid( dependencyRecordIndex ) )
+		{
+			GatherRecordDependencies( dependencyRecordIndex, rPaths );
+		}
+		else
+		{
+			rPaths.Push( rRecord.dependencies[ dependencyIndex ] );
+		}
+	}
+
+	rPaths.Push( rRecord.path );
+	m_visitFlags[ recordIndex ] |= VISIT_FLAG_FINISHED;
+}
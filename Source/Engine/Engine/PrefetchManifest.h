@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Foundation/DynamicArray.h"
+
+#include "Engine/Engine.h"
+#include "Engine/AssetPath.h"
+
+namespace Helium
+{
+	class Stream;
+
+	/// Dependency list for the assets in a package, cached so that a package loader can read an asset's dependencies
+	/// along with the asset itself instead of discovering them one reference at a time.
+	///
+	/// Records are kept in dependency order (each record follows the records of the package assets it depends on).
+	/// Dependencies outside of the package are listed by path only.
+	class HELIUM_ENGINE_API PrefetchManifest
+	{
+	public:
+		/// Manifest format version.
+		static const uint32_t VERSION = 1;
+
+		/// Asset dependency record.
+		struct Record
+		{
+			/// Asset path.
+			AssetPath path;
+			/// Paths of the assets referenced by the asset.
+			DynamicArray< AssetPath > dependencies;
+			/// Record index of each dependency, or an invalid index for dependencies outside of the package (set by
+			/// Sort()).
+			DynamicArray< uint32_t > recordDependencies;
+		};
+
+		/// @name Construction/Destruction
+		//@{
+		PrefetchManifest();
+		//@}
+
+		/// @name Record Access
+		//@{
+		void Clear();
+		void SetDependencies( AssetPath path, const DynamicArray< AssetPath >& rDependencies );
+
+		inline size_t GetRecordCount() const;
+		inline const Record& GetRecord( size_t index ) const;
+		size_t FindRecord( AssetPath path ) const;
+
+		void Sort();
+		void GatherDependencies( AssetPath path, DynamicArray< AssetPath >& rPaths ) const;
+		//@}
+
+		/// @name Serialization
+		//@{
+		void Write( Stream& rStream ) const;
+		bool Read( const uint8_t* pData, size_t size );
+		//@}
+
+	private:
+		/// Dependency records.
+		DynamicArray< Record > m_records;
+		/// True if the records are in dependency order with their record dependencies set.
+		bool m_bSorted;
+
+		/// Scratch flags for GatherDependencies(), one per record.
+		mutable DynamicArray< uint8_t > m_visitFlags;
+
+		/// @name Private Utility Functions
+		//@{
+		void SortRecord(
+			size_t recordIndex, DynamicArray< uint8_t >& rVisitFlags, DynamicArray< Record >& rSortedRecords );
+		void GatherRecordDependencies( size_t recordIndex, DynamicArray< AssetPath >& rPaths ) const;
+		//@}
+	};
+}
+
+#include "Engine/PrefetchManifest.inl"
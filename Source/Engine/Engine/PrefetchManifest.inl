@@ -0,0 +1,23 @@
+/// Get the number of dependency records in this manifest.
+///
+/// @return  Record count.
+///
+/// @see GetRecord(), FindRecord()
+size_t Helium::PrefetchManifest::GetRecordCount() const
+{
+    return m_records.GetSize();
+}
+
+/// Get the dependency record with the given index.
+///
+/// @param[in] index  Record index.
+///
+/// @return  Dependency record.
+///
+/// @see GetRecordCount(), FindRecord()
+const Helium::PrefetchManifest::Record& Helium::PrefetchManifest::GetRecord( size_t index ) const
+{
+    HELIUM_ASSERT( index < m_records.GetSize() );
+
+    return m_records[ index ];
+}
@@ -0,0 +1,107 @@
+#include "Precompile.h"
+#include "Engine/ReadAhead.h"
+
+#if HELIUM_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace Helium;
+
+/// Get whether file range hints are supported on this platform.
+///
+/// @return  True if HintFileRanges() can issue hints, false if it always does nothing.
+bool ReadAhead::IsFileHintSupported()
+{
+#if HELIUM_OS_LINUX
+	return true;
+#else
+	return false;
+#endif
+}
+
+/// Hint that ranges of a file are about to be read.
+///
+/// @param[in] pFileName   Name of the file.
+/// @param[in] pRanges     Ranges to be read.
+/// @param[in] rangeCount  Number of ranges.
+///
+/// @return  True if the hints were issued, false if the file could not be opened or hints are not supported.
+bool ReadAhead::HintFileRanges( const char* pFileName, const Range* pRanges, size_t rangeCount )
+{
+	HELIUM_ASSERT( pFileName );
+	HELIUM_ASSERT( pRanges || rangeCount == 0 );
+
+#if HELIUM_OS_LINUX
+	int fileDescriptor = open( pFileName, O_RDONLY );
+	if( fileDescriptor < 0 )
+	{
+		return false;
+	}
+
+	// The page cache is shared by every handle to the file, so hints on this descriptor also benefit the stream that
+	// later reads the data.
+	bool bHinted = true;
+	for( size_t rangeIndex = 0; rangeIndex < rangeCount; ++rangeIndex )
+	{
+		const Range& rRange = pRanges[ rangeIndex ];
+		if( posix_fadvise(
+			fileDescriptor,
+			static_cast< off_t >( rRange.offset ),
+			static_cast< off_t >( rRange.size ),
+			POSIX_FADV_WILLNEED ) != 0 )
+		{
+			bHinted = false;
+		}
+	}
+
+	close( fileDescriptor );
+
+	return bHinted;
+#else
+	HELIUM_UNREF( pFileName );
+	HELIUM_UNREF( pRanges );
+	HELIUM_UNREF( rangeCount );
+
+	return false;
+#endif
+}
+
+/// Hint that a range of a mapped file is about to be accessed.
+///
+/// @param[in] pMemory  Start of the range.
+/// @param[in] size     Number of bytes in the range.
+///
+/// @return  True if the hint was issued, false if not.
+bool ReadAhead::HintMemoryRange( const void* pMemory, size_t size )
+{
+	if( !pMemory || size == 0 )
+	{
+		return false;
+	}
+
+#if HELIUM_OS_WIN
+#if _WIN32_WINNT >= 0x0602
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = const_cast< void* >( pMemory );
+	range.NumberOfBytes = size;
+
+	return ( PrefetchVirtualMemory( GetCurrentProcess(), 1, &range, 0 ) != FALSE );
+#else
+	return false;
+#endif
+#else
+	// madvise() requires a page-aligned start address.
+	uintptr_t pageSize = static_cast< uintptr_t >( sysconf( _SC_PAGESIZE ) );
+	uintptr_t address = reinterpret_cast< uintptr_t >( pMemory );
+	uintptr_t alignedAddress = address & ~( pageSize - 1 );
+
+	return ( madvise(
+		reinterpret_cast< void* >( alignedAddress ),
+		size + static_cast< size_t >( address - alignedAddress ),
+		MADV_WILLNEED ) == 0 );
+#endif
+}
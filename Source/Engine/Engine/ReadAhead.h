@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+namespace Helium
+{
+	/// Hints to the operating system about file data that is about to be read.
+	///
+	/// Hints start reading the given ranges into the OS page cache in the background, so a later read is served from
+	/// memory rather than paying seek latency on spinning disks and network shares.  They never change the data read
+	/// and may be ignored by the OS, so failures are not reported as errors.
+	///
+	/// File range hints are only supported on Linux (through posix_fadvise()); other platforms offer no way to hint
+	/// arbitrary ranges of a file that is read through a separate handle.  Memory range hints for mapped files are
+	/// supported on Windows (through PrefetchVirtualMemory()) and POSIX platforms (through madvise()).
+	class HELIUM_ENGINE_API ReadAhead
+	{
+	public:
+		/// Range of a file.
+		struct Range
+		{
+			/// Byte offset of the start of the range.
+			uint64_t offset;
+			/// Number of bytes in the range.
+			uint64_t size;
+		};
+
+		/// @name File Hints
+		//@{
+		static bool IsFileHintSupported();
+		static bool HintFileRanges( const char* pFileName, const Range* pRanges, size_t rangeCount );
+		//@}
+
+		/// @name Memory Hints
+		//@{
+		static bool HintMemoryRange( const void* pMemory, size_t size );
+		//@}
+	};
+}
@@ -0,0 +1,230 @@
+#include "Precompile.h"
+#include "Engine/RenderStatistics.h"
+
+#include "Platform/Locks.h"
+
+using namespace Helium;
+
+namespace
+{
+	/// Counters of the frame currently being recorded.
+	RenderStatistics::FrameStats s_currentFrame;
+	/// Counters of the last completed frame.
+	RenderStatistics::FrameStats s_lastFrame;
+
+	/// Upload byte totals of the frame currently being recorded (uploads can be recorded from any thread).
+	uint64_t s_uploadBytes[ RenderStatistics::COUNTER_MAX ];
+	/// Lock for the upload byte totals.
+	Mutex s_uploadLock;
+
+	/// Index of the current pass in the current frame, or an invalid index if the pass has not been looked up yet.
+	uint32_t s_currentPassIndex = Invalid< uint32_t >();
+
+	/// Find or add the current frame entry of a pass.
+	uint32_t GetPassIndex( const char* pName )
+	{
+		uint32_t passCount = s_currentFrame.passCount;
+		for( uint32_t passIndex = 0; passIndex < passCount; ++passIndex )
+		{
+			if( s_currentFrame.passes[ passIndex ].pName == pName )
+			{
+				return passIndex;
+			}
+		}
+
+		if( passCount >= RenderStatistics::MAX_PASS_COUNT )
+		{
+			return RenderStatistics::MAX_PASS_COUNT - 1;
+		}
+
+		RenderStatistics::PassStats& rPass = s_currentFrame.passes[ passCount ];
+		rPass.pName = pName;
+		MemoryZero( rPass.counters, sizeof( rPass.counters ) );
+		rPass.gpuMilliseconds = 0.0f;
+		s_currentFrame.passCount = passCount + 1;
+
+		return passCount;
+	}
+
+	/// Get the current frame entry of the current pass.
+	RenderStatistics::PassStats& GetCurrentPass()
+	{
+		if( IsInvalid( s_currentPassIndex ) )
+		{
+			s_currentPassIndex = GetPassIndex( RenderStatistics::GetPass() );
+		}
+
+		return s_currentFrame.passes[ s_currentPassIndex ];
+	}
+}
+
+const char* RenderStatistics::sm_pPassName = NULL;
+bool RenderStatistics::sm_bOverlayEnabled = false;
+
+/// Set the render pass to which subsequent draws and state changes are attributed.
+///
+/// Passes are identified by the address of their name, which must therefore be a static string.  This must only be
+/// called from the thread issuing commands to the renderer.
+///
+/// @param[in] pName  Pass name, or null to record work outside of any pass.
+///
+/// @return  Name of the previous pass, so that it can be restored once the new pass is done.
+///
+/// @see GetPass()
+const char* RenderStatistics::SetPass( const char* pName )
+{
+	const char* pPreviousName = sm_pPassName;
+	if( pName != pPreviousName )
+	{
+		sm_pPassName = pName;
+		SetInvalid( s_currentPassIndex );
+	}
+
+	return pPreviousName;
+}
+
+/// Record a draw call in the current pass.
+///
+/// @param[in] primitiveCount  Number of primitives drawn per instance.
+/// @param[in] instanceCount   Number of instances drawn, or zero for a non-instanced draw call.
+void RenderStatistics::RecordDraw( uint32_t primitiveCount, uint32_t instanceCount )
+{
+	PassStats& rPass = GetCurrentPass();
+
+	++rPass.counters[ COUNTER_DRAW_CALLS ];
+	if( instanceCount != 0 )
+	{
+		++rPass.counters[ COUNTER_INSTANCED_DRAW_CALLS ];
+		rPass.counters[ COUNTER_PRIMITIVES ] += static_cast< uint64_t >( primitiveCount ) * instanceCount;
+		rPass.counters[ COUNTER_INSTANCES ] += instanceCount;
+	}
+	else
+	{
+		rPass.counters[ COUNTER_PRIMITIVES ] += primitiveCount;
+		++rPass.counters[ COUNTER_INSTANCES ];
+	}
+}
+
+/// Record state and resource binds in the current pass.
+///
+/// @param[in] issuedCount    Number of binds issued to the graphics API.
+/// @param[in] filteredCount  Number of redundant binds filtered out.
+void RenderStatistics::RecordStateChanges( uint32_t issuedCount, uint32_t filteredCount )
+{
+	PassStats& rPass = GetCurrentPass();
+	rPass.counters[ COUNTER_STATE_CHANGES ] += issuedCount;
+	rPass.counters[ COUNTER_FILTERED_STATE_CHANGES ] += filteredCount;
+}
+
+/// Record bytes uploaded to a buffer or texture.
+///
+/// This can be called from any thread.
+///
+/// @param[in] counter    Upload counter (COUNTER_CONSTANT_BUFFER_BYTES, COUNTER_BUFFER_BYTES, or
+///                       COUNTER_TEXTURE_BYTES).
+/// @param[in] byteCount  Number of bytes uploaded.
+void RenderStatistics::RecordUpload( ECounter counter, size_t byteCount )
+{
+	HELIUM_ASSERT(
+		counter == COUNTER_CONSTANT_BUFFER_BYTES ||
+		counter == COUNTER_BUFFER_BYTES ||
+		counter == COUNTER_TEXTURE_BYTES );
+
+	MutexScopeLock scopeLock( s_uploadLock );
+	s_uploadBytes[ counter ] += byteCount;
+}
+
+/// Record GPU time spent in a pass.
+///
+/// This must only be called from the thread issuing commands to the renderer.
+///
+/// @param[in] pName         Pass name (static string, as passed to SetPass()).
+/// @param[in] milliseconds  GPU time, in milliseconds.  This is added to any time already recorded for the pass.
+void RenderStatistics::RecordGpuTime( const char* pName, float32_t milliseconds )
+{
+	uint32_t passIndex = GetPassIndex( pName );
+	s_currentFrame.passes[ passIndex ].gpuMilliseconds += milliseconds;
+}
+
+/// Close the current frame and start recording the next one.
+///
+/// This must only be called from the thread issuing commands to the renderer, once all work for the frame has been
+/// issued.
+///
+/// @see GetLastFrameStats()
+void RenderStatistics::EndFrame()
+{
+	uint32_t passCount = s_currentFrame.passCount;
+	MemoryZero( s_currentFrame.totals, sizeof( s_currentFrame.totals ) );
+	s_currentFrame.gpuMilliseconds = 0.0f;
+	for( uint32_t passIndex = 0; passIndex < passCount; ++passIndex )
+	{
+		const PassStats& rPass = s_currentFrame.passes[ passIndex ];
+		s_currentFrame.gpuMilliseconds += rPass.gpuMilliseconds;
+		for( size_t counterIndex = 0; counterIndex < COUNTER_MAX; ++counterIndex )
+		{
+			s_currentFrame.totals[ counterIndex ] += rPass.counters[ counterIndex ];
+		}
+	}
+
+	{
+		MutexScopeLock scopeLock( s_uploadLock );
+		for( size_t counterIndex = 0; counterIndex < COUNTER_MAX; ++counterIndex )
+		{
+			s_currentFrame.totals[ counterIndex ] += s_uploadBytes[ counterIndex ];
+		}
+
+		MemoryZero( s_uploadBytes, sizeof( s_uploadBytes ) );
+	}
+
+	s_lastFrame = s_currentFrame;
+
+	s_currentFrame.passCount = 0;
+	SetInvalid( s_currentPassIndex );
+}
+
+/// Get the counters of the last completed frame.
+///
+/// @return  Last frame counters.
+///
+/// @see EndFrame()
+const RenderStatistics::FrameStats& RenderStatistics::GetLastFrameStats()
+{
+	return s_lastFrame;
+}
+
+/// Get the display name of a counter.
+///
+/// @param[in] counter  Counter.
+///
+/// @return  Counter name.
+const char* RenderStatistics::GetCounterName( ECounter counter )
+{
+	static const char* const counterNames[] =
+	{
+		"drawCalls",                // COUNTER_DRAW_CALLS
+		"instancedDrawCalls",       // COUNTER_INSTANCED_DRAW_CALLS
+		"primitives",               // COUNTER_PRIMITIVES
+		"instances",                // COUNTER_INSTANCES
+		"stateChanges",             // COUNTER_STATE_CHANGES
+		"filteredStateChanges",     // COUNTER_FILTERED_STATE_CHANGES
+		"constantBufferBytes",      // COUNTER_CONSTANT_BUFFER_BYTES
+		"bufferBytes",              // COUNTER_BUFFER_BYTES
+		"textureBytes",             // COUNTER_TEXTURE_BYTES
+	};
+
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( counterNames ) == COUNTER_MAX );
+	HELIUM_ASSERT( static_cast< size_t >( counter ) < COUNTER_MAX );
+
+	return counterNames[ counter ];
+}
+
+/// Set whether the statistics overlay should be drawn.
+///
+/// @param[in] bEnabled  True to draw the overlay, false to hide it.
+///
+/// @see IsOverlayEnabled()
+void RenderStatistics::SetOverlayEnabled( bool bEnabled )
+{
+	sm_bOverlayEnabled = bEnabled;
+}
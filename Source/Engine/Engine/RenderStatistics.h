@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+namespace Helium
+{
+	/// Per-frame rendering work counters, broken down by render pass.
+	///
+	/// Renderer implementations record each draw call, each state bind issued or filtered out as redundant, and the
+	/// bytes of every constant buffer, vertex or index buffer, and texture mapped or created with initial data.  Draws
+	/// and binds are attributed to the render pass set with SetPass() (or to an untagged pass if none is set) and must
+	/// be recorded on the thread issuing commands to the renderer.  Uploads may be recorded from any thread, and are
+	/// only counted in the frame totals.
+	///
+	/// GPU time spent in each pass can be reported with RecordGpuTime().  GPU timings are read back several frames after
+	/// they were measured, so they are included in the statistics of a later frame than the draws they cover.
+	///
+	/// EndFrame() closes the current frame, after which its counters can be read with GetLastFrameStats().
+	class HELIUM_ENGINE_API RenderStatistics
+	{
+	public:
+		/// Maximum number of distinct passes counted in a frame (passes past this count are merged into the last one).
+		static const uint32_t MAX_PASS_COUNT = 16;
+
+		/// Counters.
+		enum ECounter
+		{
+			COUNTER_FIRST   =  0,
+			COUNTER_INVALID = -1,
+
+			/// Draw calls issued (instanced or not).
+			COUNTER_DRAW_CALLS = COUNTER_FIRST,
+			/// Instanced draw calls issued.
+			COUNTER_INSTANCED_DRAW_CALLS,
+			/// Primitives drawn (counting every instance).
+			COUNTER_PRIMITIVES,
+			/// Instances drawn (one for each non-instanced draw call).
+			COUNTER_INSTANCES,
+			/// State and resource binds issued to the graphics API.
+			COUNTER_STATE_CHANGES,
+			/// Redundant state and resource binds filtered out.
+			COUNTER_FILTERED_STATE_CHANGES,
+			/// Bytes of constant buffers mapped.
+			COUNTER_CONSTANT_BUFFER_BYTES,
+			/// Bytes of vertex and index buffers mapped or created with initial data.
+			COUNTER_BUFFER_BYTES,
+			/// Bytes of textures mapped or created with initial data.
+			COUNTER_TEXTURE_BYTES,
+
+			COUNTER_MAX,
+			COUNTER_LAST = COUNTER_MAX - 1
+		};
+
+		/// Counters of a single pass.
+		struct PassStats
+		{
+			/// Pass name (static string), or null for work issued outside of any pass.
+			const char* pName;
+			/// Counter values, indexed by ECounter.
+			uint64_t counters[ COUNTER_MAX ];
+			/// GPU time spent in the pass, in milliseconds, or zero if not measured.
+			float32_t gpuMilliseconds;
+		};
+
+		/// Counters of a frame.
+		struct FrameStats
+		{
+			/// Number of passes with work recorded.
+			uint32_t passCount;
+			/// Counters of each pass with work recorded, in the order each pass was first set during the frame.
+			PassStats passes[ MAX_PASS_COUNT ];
+			/// Counter totals over all passes.
+			uint64_t totals[ COUNTER_MAX ];
+			/// Total GPU time spent in all measured passes, in milliseconds.
+			float32_t gpuMilliseconds;
+		};
+
+		/// @name Recording
+		//@{
+		static const char* SetPass( const char* pName );
+		inline static const char* GetPass();
+
+		static void RecordDraw( uint32_t primitiveCount, uint32_t instanceCount );
+		static void RecordStateChanges( uint32_t issuedCount, uint32_t filteredCount );
+		static void RecordUpload( ECounter counter, size_t byteCount );
+		static void RecordGpuTime( const char* pName, float32_t milliseconds );
+
+		static void EndFrame();
+		//@}
+
+		/// @name Reading
+		//@{
+		static const FrameStats& GetLastFrameStats();
+		static const char* GetCounterName( ECounter counter );
+		//@}
+
+		/// @name Overlay
+		//@{
+		static void SetOverlayEnabled( bool bEnabled );
+		inline static bool IsOverlayEnabled();
+		//@}
+
+	private:
+		/// Name of the pass currently being recorded, or null if outside of any pass.
+		static const char* sm_pPassName;
+		/// True if the statistics overlay should be drawn.
+		static bool sm_bOverlayEnabled;
+	};
+}
+
+#include "Engine/RenderStatistics.inl"
@@ -0,0 +1,22 @@
+namespace Helium
+{
+	/// Get the name of the pass currently being recorded.
+	///
+	/// @return  Pass name, or null if outside of any pass.
+	///
+	/// @see SetPass()
+	const char* RenderStatistics::GetPass()
+	{
+		return sm_pPassName;
+	}
+
+	/// Get whether the statistics overlay should be drawn.
+	///
+	/// @return  True if the overlay is enabled, false if not.
+	///
+	/// @see SetOverlayEnabled()
+	bool RenderStatistics::IsOverlayEnabled()
+	{
+		return sm_bOverlayEnabled;
+	}
+}
@@ -0,0 +1,405 @@
+#include "Precompile.h"
+#include "Engine/ResidencyManager.h"
+
+#include "Engine/Resource.h"
+
+#include <algorithm>
+
+using namespace Helium;
+
+static uint32_t g_InitCount = 0;
+ResidencyManager* ResidencyManager::sm_pInstance = NULL;
+
+/// Constructor.
+ResidencyManager::ResidencyManager()
+	: m_budget( 0 )
+	, m_residentSize( 0 )
+	, m_pendingRestoreCount( 0 )
+	, m_frameIndex( 0 )
+{
+}
+
+/// Destructor.
+ResidencyManager::~ResidencyManager()
+{
+	Cleanup();
+}
+
+/// Add a loaded resource to the set of resources whose data can be evicted.
+///
+/// The resource is assigned to the residency group of the package that owns it.
+///
+/// @param[in] pResource  Resource to register.
+///
+/// @see UnregisterResource(), SetResourceGroup()
+void ResidencyManager::RegisterResource( Resource* pResource )
+{
+	HELIUM_ASSERT( pResource );
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	if( IsValid( pResource->m_residencyIndex ) )
+	{
+		return;
+	}
+
+	Package* pPackage = pResource->GetOwningPackage();
+
+	Entry* pEntry = m_entries.New();
+	HELIUM_ASSERT( pEntry );
+	pEntry->pResource = pResource;
+	pEntry->group = ( pPackage ? pPackage->GetPath() : AssetPath() );
+	pEntry->gpuSize = 0;
+	pEntry->cpuSize = 0;
+	pEntry->lastUseFrame = m_frameIndex;
+	pEntry->bUsed = false;
+	pEntry->state = STATE_RESIDENT;
+
+	pResource->m_residencyIndex = m_entries.GetSize() - 1;
+}
+
+/// Remove a resource from the set of resources whose data can be evicted.
+///
+/// Once this returns, the manager will no longer access the resource.  If its GPU data is being restored, the resource
+/// is left to finish the restore itself.
+///
+/// @param[in] pResource  Resource to unregister.
+///
+/// @see RegisterResource()
+void ResidencyManager::UnregisterResource( Resource* pResource )
+{
+	HELIUM_ASSERT( pResource );
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryIndex = pResource->m_residencyIndex;
+	if( IsInvalid( entryIndex ) )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( entryIndex < m_entries.GetSize() );
+	HELIUM_ASSERT( m_entries[ entryIndex ].pResource == pResource );
+
+	if( m_entries[ entryIndex ].state == STATE_GPU_RESTORING )
+	{
+		HELIUM_ASSERT( m_pendingRestoreCount != 0 );
+		--m_pendingRestoreCount;
+	}
+
+	m_entries.RemoveSwap( entryIndex );
+	if( entryIndex < m_entries.GetSize() )
+	{
+		m_entries[ entryIndex ].pResource->m_residencyIndex = entryIndex;
+	}
+
+	SetInvalid( pResource->m_residencyIndex );
+}
+
+/// Move a registered resource to a different residency group.
+///
+/// @param[in] pResource  Resource to move.  Resources that are not registered are ignored.
+/// @param[in] group      Residency group path.
+///
+/// @see PinGroup(), UnpinGroup()
+void ResidencyManager::SetResourceGroup( Resource* pResource, AssetPath group )
+{
+	HELIUM_ASSERT( pResource );
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryIndex = pResource->m_residencyIndex;
+	if( IsInvalid( entryIndex ) )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( entryIndex < m_entries.GetSize() );
+	m_entries[ entryIndex ].group = group;
+}
+
+/// Report that a resource is in use during the current frame.
+///
+/// This should be called each frame for each resource in use, prior to calling Update().  If the GPU data of the
+/// resource has been evicted, it will be restored during the next update.
+///
+/// @param[in] pResource  Resource in use.  Resources that are not registered are ignored.
+///
+/// @see Update()
+void ResidencyManager::TouchResource( Resource* pResource )
+{
+	HELIUM_ASSERT( pResource );
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryIndex = pResource->m_residencyIndex;
+	if( IsInvalid( entryIndex ) )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( entryIndex < m_entries.GetSize() );
+	Entry& rEntry = m_entries[ entryIndex ];
+	HELIUM_ASSERT( rEntry.pResource == pResource );
+
+	rEntry.lastUseFrame = m_frameIndex;
+	rEntry.bUsed = true;
+}
+
+/// Restore the data of resources used during the current frame, and evict the data of the least recently used
+/// resources if the budget has been exceeded.
+///
+/// This should be called once per frame, after all resources in use for the frame have been reported.
+///
+/// @see TouchResource()
+void ResidencyManager::Update()
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryCount = m_entries.GetSize();
+	HELIUM_ASSERT( entryCount <= UINT32_MAX );
+
+	// Finish any GPU data restores that have completed, and start restoring the data of evicted resources that were
+	// used during this frame.
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Entry& rEntry = m_entries[ entryIndex ];
+		if( rEntry.state == STATE_GPU_RESTORING )
+		{
+			if( rEntry.pResource->TryFinishPrecacheResourceData() )
+			{
+				HELIUM_ASSERT( m_pendingRestoreCount != 0 );
+				--m_pendingRestoreCount;
+
+				rEntry.state = STATE_RESIDENT;
+			}
+		}
+		else if( rEntry.state == STATE_GPU_EVICTED &&
+			rEntry.lastUseFrame == m_frameIndex &&
+			m_pendingRestoreCount < MAX_PENDING_RESTORE_COUNT )
+		{
+			if( rEntry.pResource->BeginPrecacheResourceData() )
+			{
+				rEntry.state = STATE_GPU_RESTORING;
+				++m_pendingRestoreCount;
+			}
+			else
+			{
+				HELIUM_TRACE(
+					TraceLevels::Warning,
+					"ResidencyManager::Update(): Failed to restore the GPU data of \"%s\".\n",
+					*rEntry.pResource->GetPath().ToString() );
+
+				rEntry.state = STATE_RESIDENT;
+			}
+		}
+	}
+
+	// Refresh the resident size of each resource.
+	size_t residentSize = 0;
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Entry& rEntry = m_entries[ entryIndex ];
+		rEntry.gpuSize = rEntry.pResource->GetGpuResidentSize();
+		rEntry.cpuSize = rEntry.pResource->GetCpuResidentSize();
+
+		residentSize += rEntry.gpuSize + rEntry.cpuSize;
+	}
+
+	if( m_budget != 0 && residentSize > m_budget )
+	{
+		// Sort the resources that can be evicted from least to most recently used.
+		m_sortKeys.Resize( 0 );
+		m_sortKeys.Reserve( entryCount );
+
+		for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+		{
+			const Entry& rEntry = m_entries[ entryIndex ];
+			if( IsEvictable( rEntry ) )
+			{
+				uint32_t idleFrameCount = m_frameIndex - rEntry.lastUseFrame;
+				m_sortKeys.Push(
+					( static_cast< uint64_t >( UINT32_MAX - idleFrameCount ) << 32 ) |
+					static_cast< uint64_t >( entryIndex ) );
+			}
+		}
+
+		std::sort( m_sortKeys.GetData(), m_sortKeys.GetData() + m_sortKeys.GetSize() );
+
+		// GPU data is usually both the largest and the cheapest to restore, so evict it from every candidate before
+		// touching any CPU data.
+		size_t excessSize = residentSize - m_budget;
+		size_t evictedSize = EvictData( excessSize, true );
+		if( evictedSize < excessSize )
+		{
+			evictedSize += EvictData( excessSize - evictedSize, false );
+		}
+
+		residentSize -= evictedSize;
+	}
+
+	m_residentSize = residentSize;
+
+	++m_frameIndex;
+}
+
+/// Prevent the data of all resources in a residency group from being evicted.
+///
+/// Groups are pin counted, so each call to this function must be matched by a call to UnpinGroup().
+///
+/// @param[in] group  Residency group path.
+///
+/// @see UnpinGroup(), SetResourceGroup()
+void ResidencyManager::PinGroup( AssetPath group )
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	HashMap< AssetPath, uint32_t >::Iterator pinIterator = m_groupPinCounts.Find( group );
+	if( pinIterator != m_groupPinCounts.End() )
+	{
+		++pinIterator->Second();
+	}
+	else
+	{
+		m_groupPinCounts.Insert( pinIterator, HashMap< AssetPath, uint32_t >::ValueType( group, 1 ) );
+	}
+}
+
+/// Release a pin on a residency group.
+///
+/// @param[in] group  Residency group path.
+///
+/// @see PinGroup()
+void ResidencyManager::UnpinGroup( AssetPath group )
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	HashMap< AssetPath, uint32_t >::Iterator pinIterator = m_groupPinCounts.Find( group );
+	HELIUM_ASSERT( pinIterator != m_groupPinCounts.End() );
+	if( pinIterator != m_groupPinCounts.End() && --pinIterator->Second() == 0 )
+	{
+		m_groupPinCounts.Remove( pinIterator );
+	}
+}
+
+/// Set the memory budget for resource data.
+///
+/// The new budget takes effect during the next call to Update().
+///
+/// @param[in] budget  Resource memory budget, in bytes, or zero to disable eviction.
+///
+/// @see GetBudget()
+void ResidencyManager::SetBudget( size_t budget )
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	m_budget = budget;
+}
+
+/// Get the singleton ResidencyManager instance.
+///
+/// @return  Pointer to the ResidencyManager instance, or null if it has not been created.
+///
+/// @see Startup(), Shutdown()
+ResidencyManager* ResidencyManager::GetInstance()
+{
+	return sm_pInstance;
+}
+
+/// Create the singleton ResidencyManager instance.
+///
+/// The instance starts out with eviction disabled until a budget is set.
+///
+/// @see Shutdown(), GetInstance()
+void ResidencyManager::Startup()
+{
+	if( ++g_InitCount == 1 )
+	{
+		HELIUM_ASSERT( !sm_pInstance );
+		sm_pInstance = new ResidencyManager;
+		HELIUM_ASSERT( sm_pInstance );
+	}
+}
+
+/// Destroy the singleton ResidencyManager instance.
+///
+/// @see Startup(), GetInstance()
+void ResidencyManager::Shutdown()
+{
+	if( --g_InitCount == 0 )
+	{
+		delete sm_pInstance;
+		sm_pInstance = NULL;
+	}
+}
+
+/// Release all registered resource references.
+///
+/// Any resources still registered keep their currently resident data.
+void ResidencyManager::Cleanup()
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryCount = m_entries.GetSize();
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		SetInvalid( m_entries[ entryIndex ].pResource->m_residencyIndex );
+	}
+
+	m_entries.Clear();
+	m_sortKeys.Clear();
+	m_groupPinCounts.Clear();
+	m_residentSize = 0;
+	m_pendingRestoreCount = 0;
+}
+
+/// Get whether the data of a registered resource can be evicted.
+///
+/// @param[in] rEntry  Registered resource entry.
+///
+/// @return  True if the resource has been used before, has been idle for long enough, and is not in a pinned group.
+bool ResidencyManager::IsEvictable( const Entry& rEntry ) const
+{
+	if( !rEntry.bUsed || rEntry.state == STATE_GPU_RESTORING || m_frameIndex - rEntry.lastUseFrame < MIN_IDLE_FRAME_COUNT )
+	{
+		return false;
+	}
+
+	return ( rEntry.gpuSize + rEntry.cpuSize != 0 && m_groupPinCounts.Find( rEntry.group ) == m_groupPinCounts.End() );
+}
+
+/// Evict either the GPU or CPU data of the resources in the eviction order built by Update().
+///
+/// @param[in] targetSize  Amount of memory to free, in bytes.
+/// @param[in] bGpuData    True to evict GPU data, false to evict CPU data.
+///
+/// @return  Amount of memory actually freed, in bytes.
+size_t ResidencyManager::EvictData( size_t targetSize, bool bGpuData )
+{
+	size_t evictedSize = 0;
+
+	size_t keyCount = m_sortKeys.GetSize();
+	for( size_t keyIndex = 0; keyIndex < keyCount && evictedSize < targetSize; ++keyIndex )
+	{
+		Entry& rEntry = m_entries[ static_cast< size_t >( static_cast< uint32_t >( m_sortKeys[ keyIndex ] ) ) ];
+		if( bGpuData )
+		{
+			if( rEntry.gpuSize != 0 && rEntry.pResource->EvictGpuData() )
+			{
+				evictedSize += rEntry.gpuSize;
+				rEntry.gpuSize = 0;
+				rEntry.state = STATE_GPU_EVICTED;
+			}
+		}
+		else
+		{
+			if( rEntry.cpuSize != 0 && rEntry.pResource->EvictCpuData() )
+			{
+				evictedSize += rEntry.cpuSize;
+				rEntry.cpuSize = 0;
+			}
+		}
+	}
+
+	return evictedSize;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/HashMap.h"
+
+#include "Engine/AssetPath.h"
+
+namespace Helium
+{
+	class Resource;
+
+	/// Manager for keeping the memory used by loaded resources within a fixed budget.
+	///
+	/// Each loaded resource is registered with the manager and assigned to a residency group (by default, the package
+	/// that owns it).  Systems using a resource report each frame that it is in use, and Update() tracks when each
+	/// resource was last used.  Whenever the resources hold more memory than the budget allows, the data of the least
+	/// recently used resources is evicted until they fit again: GPU data first, as it can be restored by precaching
+	/// the resource again, and then CPU data kept around for the editor, which can be read back from the resource's
+	/// cache.  Evicted GPU data is restored in the background as soon as the resource is used again, so eviction is
+	/// transparent to anything holding onto the resource.
+	///
+	/// Resources in pinned groups (such as the packages of the scene being played) and resources that have never been
+	/// reported as used are never evicted.  A budget of zero disables eviction entirely.
+	class HELIUM_ENGINE_API ResidencyManager : NonCopyable
+	{
+	public:
+		/// Number of frames a resource must go without being used before its data can be evicted.
+		static const uint32_t MIN_IDLE_FRAME_COUNT = 300;
+		/// Maximum number of resources that can be restoring their GPU data at the same time.
+		static const size_t MAX_PENDING_RESTORE_COUNT = 8;
+
+		/// @name Resource Registration
+		//@{
+		void RegisterResource( Resource* pResource );
+		void UnregisterResource( Resource* pResource );
+
+		void SetResourceGroup( Resource* pResource, AssetPath group );
+		//@}
+
+		/// @name Residency
+		//@{
+		void TouchResource( Resource* pResource );
+		void Update();
+
+		void PinGroup( AssetPath group );
+		void UnpinGroup( AssetPath group );
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline size_t GetBudget() const;
+		void SetBudget( size_t budget );
+
+		inline size_t GetResidentSize() const;
+		//@}
+
+		/// @name Static Access
+		//@{
+		static ResidencyManager* GetInstance();
+		static void Startup();
+		static void Shutdown();
+		//@}
+
+	private:
+		/// Resource residency states.
+		enum EState
+		{
+			/// All resource data is resident.
+			STATE_RESIDENT,
+			/// GPU data has been evicted.
+			STATE_GPU_EVICTED,
+			/// GPU data is being restored.
+			STATE_GPU_RESTORING
+		};
+
+		/// Registered resource information.
+		struct Entry
+		{
+			/// Registered resource.
+			Resource* pResource;
+			/// Residency group.
+			AssetPath group;
+			/// Size of the resident GPU data as of the last update, in bytes.
+			size_t gpuSize;
+			/// Size of the resident CPU data as of the last update, in bytes.
+			size_t cpuSize;
+			/// Index of the frame in which the resource was last used.
+			uint32_t lastUseFrame;
+			/// True once the resource has been used at least once.
+			bool bUsed;
+			/// Residency state (EState value).
+			uint8_t state;
+		};
+
+		/// Registered resources.
+		DynamicArray< Entry > m_entries;
+		/// Eviction order sort keys (scratch space for Update()).
+		DynamicArray< uint64_t > m_sortKeys;
+		/// Pin count of each pinned residency group.
+		HashMap< AssetPath, uint32_t > m_groupPinCounts;
+		/// Lock for synchronizing access to the registered resource list.
+		Mutex m_entryLock;
+
+		/// Memory budget for resource data, in bytes (zero to disable eviction).
+		size_t m_budget;
+		/// Memory used by the resident data of all registered resources as of the last update, in bytes.
+		size_t m_residentSize;
+		/// Number of resources currently restoring their GPU data.
+		size_t m_pendingRestoreCount;
+		/// Index of the current frame.
+		uint32_t m_frameIndex;
+
+		/// Singleton instance.
+		static ResidencyManager* sm_pInstance;
+
+		/// @name Construction/Destruction
+		//@{
+		ResidencyManager();
+		~ResidencyManager();
+		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		void Cleanup();
+
+		bool IsEvictable( const Entry& rEntry ) const;
+		size_t EvictData( size_t targetSize, bool bGpuData );
+		//@}
+	};
+}
+
+#include "Engine/ResidencyManager.inl"
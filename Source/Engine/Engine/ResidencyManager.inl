@@ -0,0 +1,24 @@
+namespace Helium
+{
+	/// Get the memory budget for resource data.
+	///
+	/// @return  Resource memory budget, in bytes, or zero if eviction is disabled.
+	///
+	/// @see SetBudget(), GetResidentSize()
+	size_t ResidencyManager::GetBudget() const
+	{
+		return m_budget;
+	}
+
+	/// Get the amount of memory used by the resident data of all registered resources.
+	///
+	/// This is updated during each call to Update(), and includes the data of resources that cannot be evicted.
+	///
+	/// @return  Resident resource data size, in bytes.
+	///
+	/// @see GetBudget()
+	size_t ResidencyManager::GetResidentSize() const
+	{
+		return m_residentSize;
+	}
+}
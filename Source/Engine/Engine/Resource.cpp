@@ -4,7 +4,9 @@
 #include "Engine/AsyncLoader.h"
 #include "Reflect/MetaClass.h"
 #include "Engine/Asset.h"
+#include "Engine/CacheAccessTrace.h"
 #include "Engine/CacheManager.h"
+#include "Engine/ResidencyManager.h"
 
 HELIUM_IMPLEMENT_ASSET( Helium::Resource, Engine, 0 );
 
@@ -12,6 +14,7 @@ using namespace Helium;
 
 /// Constructor.
 Resource::Resource()
+	: m_residencyIndex( Invalid< size_t >() )
 {
 #if HELIUM_TOOLS
 	for( size_t preprocessedDataIndex = 0;
@@ -28,6 +31,31 @@ Resource::~Resource()
 {
 }
 
+/// @copydoc Asset::RefCountPreDestroy()
+void Resource::RefCountPreDestroy()
+{
+	ResidencyManager* pResidencyManager = ResidencyManager::GetInstance();
+	if( pResidencyManager )
+	{
+		pResidencyManager->UnregisterResource( this );
+	}
+
+	Base::RefCountPreDestroy();
+}
+
+/// @copydoc Asset::FinalizeLoad()
+void Resource::FinalizeLoad()
+{
+	Base::FinalizeLoad();
+
+	// Default templates never hold any resource data worth tracking.
+	ResidencyManager* pResidencyManager = ResidencyManager::GetInstance();
+	if( pResidencyManager && !IsDefaultTemplate() )
+	{
+		pResidencyManager->RegisterResource( this );
+	}
+}
+
 /// Get the name of the resource cache to use for this resource.
 ///
 /// @return  Resource cache name.
@@ -36,6 +64,121 @@ Name Resource::GetCacheName() const
 	return Name( NULL_NAME );
 }
 
+/// Get the amount of GPU memory used by the resident data of this resource.
+///
+/// @return  Resident GPU data size, in bytes.
+///
+/// @see EvictGpuData(), GetCpuResidentSize()
+size_t Resource::GetGpuResidentSize() const
+{
+	return 0;
+}
+
+/// Get the amount of CPU memory used by resource data that can be evicted from this resource.
+///
+/// By default, this is the size of the preprocessed resource data kept in memory for the current platform in tools
+/// builds.
+///
+/// @return  Evictable CPU data size, in bytes.
+///
+/// @see EvictCpuData(), GetGpuResidentSize()
+size_t Resource::GetCpuResidentSize() const
+{
+#if HELIUM_TOOLS
+	CacheManager* pCacheManager = CacheManager::GetInstance();
+	HELIUM_ASSERT( pCacheManager );
+
+	const PreprocessedData& rPreprocessedData = GetPreprocessedData( pCacheManager->GetCurrentPlatform() );
+	if( rPreprocessedData.bLoaded )
+	{
+		size_t dataSize = rPreprocessedData.persistentDataBuffer.GetSize();
+
+		const DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
+		size_t subDataCount = rSubDataBuffers.GetSize();
+		for( size_t subDataIndex = 0; subDataIndex < subDataCount; ++subDataIndex )
+		{
+			dataSize += rSubDataBuffers[ subDataIndex ].GetSize();
+		}
+
+		return dataSize;
+	}
+#endif
+
+	return 0;
+}
+
+/// Release the GPU data of this resource.
+///
+/// The data is restored by precaching the resource again (see BeginPrecacheResourceData()), so resources that
+/// support eviction must be able to run their precache process more than once.
+///
+/// @return  True if the GPU data was released, false if this resource does not support eviction or cannot release its
+///          data at this time.
+///
+/// @see GetGpuResidentSize(), EvictCpuData()
+bool Resource::EvictGpuData()
+{
+	return false;
+}
+
+/// Release the CPU data of this resource that can be reloaded on demand.
+///
+/// By default, this releases the preprocessed resource data kept in memory for the current platform in tools builds,
+/// as long as the resource has not been changed since it was loaded and its cache holds the same data, so that later
+/// sub-data loads can be served from the cache instead.
+///
+/// @return  True if the CPU data was released, false if this resource has no data that can be released safely.
+///
+/// @see GetCpuResidentSize(), EvictGpuData()
+bool Resource::EvictCpuData()
+{
+#if HELIUM_TOOLS
+	if( GetAnyFlagSet( FLAG_CHANGED_SINCE_LOADED ) )
+	{
+		return false;
+	}
+
+	CacheManager* pCacheManager = CacheManager::GetInstance();
+	HELIUM_ASSERT( pCacheManager );
+
+	PreprocessedData& rPreprocessedData = GetPreprocessedData( pCacheManager->GetCurrentPlatform() );
+	if( !rPreprocessedData.bLoaded )
+	{
+		return false;
+	}
+
+	Name cacheName = GetCacheName();
+	Cache* pCache = ( !cacheName.IsEmpty() ? pCacheManager->GetCache( cacheName ) : NULL );
+	if( !pCache )
+	{
+		return false;
+	}
+
+	pCache->EnforceTocLoad();
+
+	// Only drop the in-memory copy if every sub-data can be read back from the cache.
+	AssetPath resourcePath = GetPath();
+	const DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
+	size_t subDataCount = rSubDataBuffers.GetSize();
+	for( size_t subDataIndex = 0; subDataIndex < subDataCount; ++subDataIndex )
+	{
+		const Cache::Entry* pCacheEntry = pCache->FindEntry( resourcePath, static_cast< uint32_t >( subDataIndex ) );
+		if( !pCacheEntry || pCacheEntry->uncompressedSize != rSubDataBuffers[ subDataIndex ].GetSize() )
+		{
+			return false;
+		}
+	}
+
+	rPreprocessedData.persistentDataBuffer.Clear();
+	rPreprocessedData.subDataBuffers.Clear();
+	rPreprocessedData.bLoaded = false;
+
+	return true;
+#else
+	return false;
+#endif
+}
+
 /// Get the size of the specified sub-data of this resource.
 ///
 /// @param[in] subDataIndex  Resource sub-data index.
@@ -73,7 +216,7 @@ size_t Resource::GetSubDataSize( uint32_t subDataIndex ) const
 	AssetPath resourcePath = GetPath();
 	const Cache::Entry* pCacheEntry = pCache->FindEntry( resourcePath, subDataIndex );
 
-	return ( pCacheEntry ? pCacheEntry->size : Invalid< size_t >() );
+	return ( pCacheEntry ? pCacheEntry->uncompressedSize : Invalid< size_t >() );
 }
 
 /// Begin asynchronous loading of the specified resource sub-data.
@@ -91,6 +234,8 @@ size_t Resource::BeginLoadSubData( void* pBuffer, uint32_t subDataIndex, size_t
 {
 	HELIUM_ASSERT( pBuffer );
 
+	CacheAccessTrace::RecordAccess( GetCacheName(), GetPath(), subDataIndex );
+
 	CacheManager* pCacheManager = CacheManager::GetInstance();
 	HELIUM_ASSERT( pCacheManager );
 
@@ -133,18 +278,236 @@ size_t Resource::BeginLoadSubData( void* pBuffer, uint32_t subDataIndex, size_t
 		return Invalid< size_t >();
 	}
 
-	// Begin an asynchronous load.
-	size_t subDataSize = pCacheEntry->size;
+	size_t subDataSize = pCacheEntry->uncompressedSize;
 	size_t loadSize = Min( subDataSize, loadSizeMax );
+	CompressionCodec codec = static_cast< CompressionCodec >( pCacheEntry->codec );
+
+	// If the cache file is mapped, copy straight from the mapping into the target buffer (which is typically mapped
+	// GPU memory) and assign a dummy ID, skipping the round trip through the async loader.  Compressed sub-data still
+	// goes through the async loader so that it is decompressed on a loader worker rather than on this thread.
+	const uint8_t* pMappedData =
+		( codec == CompressionCodecs::None ? pCache->GetMappedEntryData( *pCacheEntry ) : NULL );
+	if( pMappedData )
+	{
+		MemoryCopy( pBuffer, pMappedData, loadSize );
 
+		return static_cast< size_t >( -2 );
+	}
+
+	// Begin an asynchronous load.
 	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
 	HELIUM_ASSERT( pAsyncLoader );
 
-	size_t loadId = pAsyncLoader->QueueRequest( pBuffer, pCache->GetCacheFileName(), pCacheEntry->offset, loadSize );
+	size_t loadId;
+	if( codec == CompressionCodecs::None )
+	{
+		loadId = pAsyncLoader->QueueRequest( pBuffer, pCache->GetCacheFileName(), pCacheEntry->offset, loadSize );
+	}
+	else
+	{
+		// The whole compressed entry has to be read, though decompression stops once the buffer is full.
+		loadId = pAsyncLoader->QueueRequest(
+			pBuffer,
+			pCache->GetCacheFileName(),
+			pCacheEntry->offset,
+			pCacheEntry->size,
+			AsyncLoader::PRIORITY_NORMAL,
+			codec,
+			loadSize );
+	}
 
 	return loadId;
 }
 
+/// Begin asynchronous loading of a range of consecutive resource sub-data.
+///
+/// This is equivalent to calling BeginLoadSubData() for each sub-data index in the range, but the cache lookup is only
+/// done once for the whole range, and all the sub-data that has to be read from the cache file is queued with the
+/// async loader in a single batch.  Sub-data is cached in index order, so the async loader can serve the whole range
+/// with a single seek and scatter it into the target buffers as it is read.
+///
+/// @param[in]  ppBuffers         Buffer in which to load each resource sub-data, or null to skip loading the
+///                               corresponding sub-data.  Each buffer must be at least as large as the size returned by
+///                               GetSubDataSize() for its sub-data.
+/// @param[in]  subDataIndexBase  Index of the first resource sub-data to load.
+/// @param[in]  subDataCount      Number of consecutive resource sub-data to load.
+/// @param[out] pLoadIds          Set to the ID associated with the load request for each resource sub-data, or an
+///                               invalid index if the request failed to be queued or its buffer was null.
+/// @param[in]  pLoadSizesMax     Maximum load request size for each resource sub-data (see BeginLoadSubData()), or
+///                               null to load each sub-data in full.
+///
+/// @return  Number of load requests successfully queued.
+///
+/// @see BeginLoadSubData(), TryFinishLoadSubData(), GetSubDataSize()
+size_t Resource::BeginLoadSubDataRange(
+	void* const* ppBuffers,
+	uint32_t subDataIndexBase,
+	uint32_t subDataCount,
+	size_t* pLoadIds,
+	const size_t* pLoadSizesMax )
+{
+	HELIUM_ASSERT( ppBuffers || subDataCount == 0 );
+	HELIUM_ASSERT( pLoadIds || subDataCount == 0 );
+
+	for( uint32_t loadIndex = 0; loadIndex < subDataCount; ++loadIndex )
+	{
+		SetInvalid( pLoadIds[ loadIndex ] );
+	}
+
+	if( subDataCount == 0 )
+	{
+		return 0;
+	}
+
+	if( CacheAccessTrace::IsRecording() )
+	{
+		Name cacheName = GetCacheName();
+		AssetPath resourcePath = GetPath();
+		for( uint32_t loadIndex = 0; loadIndex < subDataCount; ++loadIndex )
+		{
+			if( ppBuffers[ loadIndex ] )
+			{
+				CacheAccessTrace::RecordAccess( cacheName, resourcePath, subDataIndexBase + loadIndex );
+			}
+		}
+	}
+
+	CacheManager* pCacheManager = CacheManager::GetInstance();
+	HELIUM_ASSERT( pCacheManager );
+
+	size_t loadCount = 0;
+
+#if HELIUM_TOOLS
+	// Check for in-memory data first.
+	Cache::EPlatform platform = pCacheManager->GetCurrentPlatform();
+	const PreprocessedData& rPreprocessedData = GetPreprocessedData( platform );
+	if( rPreprocessedData.bLoaded )
+	{
+		const DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
+
+		for( uint32_t loadIndex = 0; loadIndex < subDataCount; ++loadIndex )
+		{
+			void* pBuffer = ppBuffers[ loadIndex ];
+			uint32_t subDataIndex = subDataIndexBase + loadIndex;
+			if( !pBuffer || subDataIndex >= rSubDataBuffers.GetSize() )
+			{
+				continue;
+			}
+
+			// Copy the sub-data immediately and assign a dummy ID.
+			const DynamicArray< uint8_t >& rSubData = rSubDataBuffers[ subDataIndex ];
+
+			size_t subDataSize = rSubData.GetSize();
+			size_t copySize = ( pLoadSizesMax ? Min( subDataSize, pLoadSizesMax[ loadIndex ] ) : subDataSize );
+
+			MemoryCopy( pBuffer, rSubData.GetData(), copySize );
+
+			pLoadIds[ loadIndex ] = static_cast< size_t >( -2 );
+			++loadCount;
+		}
+
+		return loadCount;
+	}
+#endif
+
+	// Search for the sub-data in this resource's cache.
+	Name cacheName = GetCacheName();
+	HELIUM_ASSERT( !cacheName.IsEmpty() );
+
+	Cache* pCache = pCacheManager->GetCache( cacheName );
+	HELIUM_ASSERT( pCache );
+	pCache->EnforceTocLoad();
+
+	AssetPath resourcePath = GetPath();
+
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	HELIUM_ASSERT( pAsyncLoader );
+	uint32_t cacheFileId = Invalid< uint32_t >();
+
+	// Copy mapped sub-data immediately and gather the rest into a single batch of async load requests.
+	DynamicArray< AsyncLoader::RequestInfo > requests;
+	DynamicArray< uint32_t > requestLoadIndices;
+
+	for( uint32_t loadIndex = 0; loadIndex < subDataCount; ++loadIndex )
+	{
+		void* pBuffer = ppBuffers[ loadIndex ];
+		if( !pBuffer )
+		{
+			continue;
+		}
+
+		const Cache::Entry* pCacheEntry = pCache->FindEntry( resourcePath, subDataIndexBase + loadIndex );
+		if( !pCacheEntry )
+		{
+			continue;
+		}
+
+		size_t subDataSize = pCacheEntry->uncompressedSize;
+		size_t loadSize = ( pLoadSizesMax ? Min( subDataSize, pLoadSizesMax[ loadIndex ] ) : subDataSize );
+		CompressionCodec codec = static_cast< CompressionCodec >( pCacheEntry->codec );
+
+		const uint8_t* pMappedData =
+			( codec == CompressionCodecs::None ? pCache->GetMappedEntryData( *pCacheEntry ) : NULL );
+		if( pMappedData )
+		{
+			MemoryCopy( pBuffer, pMappedData, loadSize );
+
+			pLoadIds[ loadIndex ] = static_cast< size_t >( -2 );
+			++loadCount;
+
+			continue;
+		}
+
+		if( IsInvalid( cacheFileId ) )
+		{
+			cacheFileId = pAsyncLoader->GetFileId( pCache->GetCacheFileName() );
+		}
+
+		AsyncLoader::RequestInfo* pRequest = requests.New();
+		HELIUM_ASSERT( pRequest );
+		pRequest->pBuffer = pBuffer;
+		pRequest->fileId = cacheFileId;
+		pRequest->offset = pCacheEntry->offset;
+		pRequest->codec = codec;
+		pRequest->pCompletionCounter = NULL;
+
+		if( codec == CompressionCodecs::None )
+		{
+			pRequest->size = loadSize;
+			pRequest->uncompressedSize = 0;
+		}
+		else
+		{
+			// The whole compressed entry has to be read, though decompression stops once the buffer is full.
+			pRequest->size = pCacheEntry->size;
+			pRequest->uncompressedSize = loadSize;
+		}
+
+		requestLoadIndices.Push( loadIndex );
+	}
+
+	size_t requestCount = requests.GetSize();
+	if( requestCount != 0 )
+	{
+		DynamicArray< size_t > requestIds;
+		requestIds.Resize( requestCount );
+
+		pAsyncLoader->QueueRequests( requests.GetData(), requestCount, requestIds.GetData() );
+
+		for( size_t requestIndex = 0; requestIndex < requestCount; ++requestIndex )
+		{
+			size_t loadId = requestIds[ requestIndex ];
+			if( IsValid( loadId ) )
+			{
+				pLoadIds[ requestLoadIndices[ requestIndex ] ] = loadId;
+				++loadCount;
+			}
+		}
+	}
+
+	return loadCount;
+}
+
 /// Test for completion of an asynchronous sub-data load request.
 ///
 /// @param[in] loadId  ID associated with the load request.
@@ -154,13 +517,12 @@ bool Resource::TryFinishLoadSubData( size_t loadId )
 {
 	HELIUM_ASSERT( IsValid( loadId ) );
 
-#if HELIUM_TOOLS
-	// If the load request was an in-memory request, we don't need to sync as they are performed immediately.
+	// If the load request was an in-memory or mapped cache request, we don't need to sync as they are performed
+	// immediately.
 	if( loadId == static_cast< size_t >( -2 ) )
 	{
 		return true;
 	}
-#endif
 
 	// Check the async load request.
 	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
@@ -42,6 +42,16 @@ namespace Helium
 		virtual ~Resource();
 		//@}
 
+		/// @name Asset Interface
+		//@{
+		virtual void RefCountPreDestroy() override;
+		//@}
+
+		/// @name Serialization
+		//@{
+		virtual void FinalizeLoad() override;
+		//@}
+
 		/// @name Resource Serialization
 		//@{
 		virtual bool LoadPersistentResourceObject(Reflect::ObjectPtr &_object) { return false; }
@@ -52,6 +62,14 @@ namespace Helium
 		virtual Name GetCacheName() const;
 		//@}
 
+		/// @name Residency
+		//@{
+		virtual size_t GetGpuResidentSize() const;
+		virtual size_t GetCpuResidentSize() const;
+		virtual bool EvictGpuData();
+		virtual bool EvictCpuData();
+		//@}
+
 #if HELIUM_TOOLS
 		/// @name Editor Support
 		//@{
@@ -65,10 +83,18 @@ namespace Helium
 		//@{
 		size_t GetSubDataSize( uint32_t subDataIndex ) const;
 		size_t BeginLoadSubData( void* pBuffer, uint32_t subDataIndex, size_t loadSizeMax = Invalid< size_t >() );
+		size_t BeginLoadSubDataRange(
+			void* const* ppBuffers, uint32_t subDataIndexBase, uint32_t subDataCount, size_t* pLoadIds,
+			const size_t* pLoadSizesMax = NULL );
 		bool TryFinishLoadSubData( size_t loadId );
 		//@}
 
 	private:
+		friend class ResidencyManager;
+
+		/// Index of this resource in the residency manager (invalid if not registered).
+		size_t m_residencyIndex;
+
 #if HELIUM_TOOLS
 		/// In-memory preprocessed resource data for each platform.
 		PreprocessedData m_preprocessedData[ Cache::PLATFORM_MAX ];
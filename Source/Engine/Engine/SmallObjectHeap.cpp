@@ -0,0 +1,422 @@
+#include "Precompile.h"
+#include "Engine/SmallObjectHeap.h"
+
+#include "Engine/ConcurrentObjectPool.h"
+
+#include "Platform/Locks.h"
+#include "Platform/MemoryHeap.h"
+
+#include "Foundation/DynamicArray.h"
+
+using namespace Helium;
+
+namespace
+{
+	/// Size of the memory blocks each size class carves its allocations from.
+	const size_t SIZE_CLASS_BLOCK_BYTES = 16 * 1024;
+	/// Number of free allocations of each size class a thread may keep cached.
+	const size_t SIZE_CLASS_THREAD_CACHE_LIMIT = 128;
+
+	/// Usable size of each size class.
+	const size_t s_sizeClassSizes[] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+	/// Bookkeeping stored in front of each allocation.
+	struct AllocationHeader
+	{
+		/// Size class the allocation came from, or SIZE_CLASS_LARGE if it came from the default heap.
+		uint32_t sizeClass;
+		/// Offset of the allocation from the start of its size class slot or default heap block.
+		uint32_t offset;
+		/// Requested allocation size.
+		size_t size;
+	};
+
+	/// Space reserved in front of each allocation for its header (keeps allocations at the default alignment).
+	const size_t HEADER_SIZE = SmallObjectHeap::DEFAULT_ALIGNMENT;
+
+	/// Pool of allocations of a single size class.
+	class SizeClassPool : public ConcurrentObjectPoolBase
+	{
+	public:
+		explicit SizeClassPool( size_t slotSize )
+			: ConcurrentObjectPoolBase(
+				slotSize,
+				SmallObjectHeap::DEFAULT_ALIGNMENT,
+				SIZE_CLASS_BLOCK_BYTES / slotSize,
+				SIZE_CLASS_THREAD_CACHE_LIMIT )
+		{
+		}
+
+		using ConcurrentObjectPoolBase::AllocateSlot;
+		using ConcurrentObjectPoolBase::ReleaseSlot;
+	};
+
+	/// Pools for every size class, created on first use.
+	struct SizeClassPools
+	{
+		/// Pools, indexed by size class (null after shutdown).
+		SizeClassPool* pPools[ SmallObjectHeap::SIZE_CLASS_COUNT ];
+
+		SizeClassPools()
+		{
+			HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( s_sizeClassSizes ) == SmallObjectHeap::SIZE_CLASS_COUNT );
+			HELIUM_COMPILE_ASSERT( sizeof( AllocationHeader ) <= HEADER_SIZE );
+
+			for( size_t sizeClass = 0; sizeClass < SmallObjectHeap::SIZE_CLASS_COUNT; ++sizeClass )
+			{
+				pPools[ sizeClass ] = new SizeClassPool( HEADER_SIZE + s_sizeClassSizes[ sizeClass ] );
+				HELIUM_ASSERT( pPools[ sizeClass ] );
+			}
+		}
+	};
+
+	/// Allocation counts of a single thread.  Only the owning thread writes them.
+	struct ThreadCounters
+	{
+		/// Allocations made, indexed by size class.
+		uint64_t allocationCounts[ SmallObjectHeap::SIZE_CLASS_COUNT + 1 ];
+		/// Allocations freed, indexed by size class.
+		uint64_t freeCounts[ SmallObjectHeap::SIZE_CLASS_COUNT + 1 ];
+	};
+
+	/// Registered thread counters, only released on shutdown.
+	DynamicArray< ThreadCounters* > s_threadCounters;
+	/// Lock for the thread counter list and the gathered statistics (not taken while allocating).
+	Mutex s_statsLock;
+
+	/// Counters for the current thread, created when the thread first allocates.
+	thread_local ThreadCounters* s_pCurrentThreadCounters = NULL;
+
+	/// Statistics gathered by the last call to BeginFrame().
+	SmallObjectHeap::Stats s_stats;
+	/// Hook called with the statistics gathered by BeginFrame().
+	SmallObjectHeap::FrameStatsCallback s_pFrameStatsCallback = NULL;
+
+	/// Get the pools for every size class, creating them on first use.
+	SizeClassPools& GetSizeClassPools()
+	{
+		static SizeClassPools s_pools;
+
+		return s_pools;
+	}
+
+	/// Get the pool for a size class.
+	SizeClassPool& GetSizeClassPool( size_t sizeClass )
+	{
+		SizeClassPool* pPool = GetSizeClassPools().pPools[ sizeClass ];
+		HELIUM_ASSERT( pPool );
+
+		return *pPool;
+	}
+
+	/// Get the counters of the current thread, registering them if needed.
+	ThreadCounters& GetThreadCounters()
+	{
+		ThreadCounters* pCounters = s_pCurrentThreadCounters;
+		if( !pCounters )
+		{
+			pCounters = new ThreadCounters;
+			HELIUM_ASSERT( pCounters );
+			MemoryZero( pCounters, sizeof( *pCounters ) );
+
+			MutexScopeLock scopeLock( s_statsLock );
+			s_threadCounters.Push( pCounters );
+
+			s_pCurrentThreadCounters = pCounters;
+		}
+
+		return *pCounters;
+	}
+
+	/// Get the size class serving an allocation.
+	size_t GetSizeClass( size_t alignment, size_t size )
+	{
+		if( alignment <= SmallObjectHeap::DEFAULT_ALIGNMENT )
+		{
+			for( size_t sizeClass = 0; sizeClass < SmallObjectHeap::SIZE_CLASS_COUNT; ++sizeClass )
+			{
+				if( size <= s_sizeClassSizes[ sizeClass ] )
+				{
+					return sizeClass;
+				}
+			}
+		}
+
+		return SmallObjectHeap::SIZE_CLASS_LARGE;
+	}
+
+	/// Get the header stored in front of an allocation.
+	AllocationHeader* GetHeader( void* pMemory )
+	{
+		return reinterpret_cast< AllocationHeader* >( static_cast< uint8_t* >( pMemory ) - HEADER_SIZE );
+	}
+}
+
+/// Release the statistics of all threads and the memory of all size classes.
+///
+/// All allocations must have been freed beforehand, and no thread may use the heap during or after shutdown.
+void SmallObjectHeap::Shutdown()
+{
+	MutexScopeLock scopeLock( s_statsLock );
+
+	SizeClassPools& rPools = GetSizeClassPools();
+	for( size_t sizeClass = 0; sizeClass < SIZE_CLASS_COUNT; ++sizeClass )
+	{
+		delete rPools.pPools[ sizeClass ];
+		rPools.pPools[ sizeClass ] = NULL;
+	}
+
+	size_t counterCount = s_threadCounters.GetSize();
+	for( size_t counterIndex = 0; counterIndex < counterCount; ++counterIndex )
+	{
+		delete s_threadCounters[ counterIndex ];
+	}
+
+	s_threadCounters.Clear();
+	s_pCurrentThreadCounters = NULL;
+	s_pFrameStatsCallback = NULL;
+}
+
+/// Allocate a block of memory from the small object heap.
+///
+/// @param[in] size  Number of bytes to allocate.
+///
+/// @return  Base address of the allocation if successful, null if allocation failed.
+///
+/// @see AllocateAligned(), Reallocate(), Free()
+void* SmallObjectHeap::Allocate( size_t size )
+{
+	return AllocateAligned( DEFAULT_ALIGNMENT, size );
+}
+
+/// Allocate an aligned block of memory from the small object heap.
+///
+/// @param[in] alignment  Allocation alignment (must be a power of two).
+/// @param[in] size       Number of bytes to allocate.
+///
+/// @return  Base address of the allocation if successful, null if allocation failed.
+///
+/// @see Allocate(), ReallocateAligned(), Free()
+void* SmallObjectHeap::AllocateAligned( size_t alignment, size_t size )
+{
+	HELIUM_ASSERT( ( alignment & ( alignment - 1 ) ) == 0 );
+
+	size_t sizeClass = GetSizeClass( alignment, size );
+
+	uint8_t* pMemory;
+	size_t offset = HEADER_SIZE;
+	if( sizeClass != SIZE_CLASS_LARGE )
+	{
+		pMemory = static_cast< uint8_t* >( GetSizeClassPool( sizeClass ).AllocateSlot() );
+	}
+	else
+	{
+		offset = Max( alignment, HEADER_SIZE );
+		pMemory = static_cast< uint8_t* >( DefaultAllocator().AllocateAligned(
+			Max( alignment, DEFAULT_ALIGNMENT ),
+			offset + size ) );
+	}
+
+	if( !pMemory )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"SmallObjectHeap::AllocateAligned(): Failed to allocate %" PRIuSZ " bytes.\n",
+			size );
+
+		return NULL;
+	}
+
+	pMemory += offset;
+
+	AllocationHeader* pHeader = GetHeader( pMemory );
+	pHeader->sizeClass = static_cast< uint32_t >( sizeClass );
+	pHeader->offset = static_cast< uint32_t >( offset );
+	pHeader->size = size;
+
+	++GetThreadCounters().allocationCounts[ sizeClass ];
+
+	return pMemory;
+}
+
+/// Resize a block of memory allocated from the small object heap.
+///
+/// @param[in] pMemory  Base address of the allocation to resize (can be null).
+/// @param[in] size     New allocation size, in bytes.
+///
+/// @return  Base address of the resized allocation if successful, null if reallocation failed.
+///
+/// @see ReallocateAligned(), Allocate(), Free()
+void* SmallObjectHeap::Reallocate( void* pMemory, size_t size )
+{
+	return ReallocateAligned( pMemory, DEFAULT_ALIGNMENT, size );
+}
+
+/// Resize an aligned block of memory allocated from the small object heap.
+///
+/// Allocations are resized in place as long as they stay within their size class, and moved otherwise.
+///
+/// @param[in] pMemory    Base address of the allocation to resize (can be null).
+/// @param[in] alignment  Allocation alignment (must be a power of two).
+/// @param[in] size       New allocation size, in bytes.
+///
+/// @return  Base address of the resized allocation if successful, null if reallocation failed.
+///
+/// @see Reallocate(), AllocateAligned(), Free()
+void* SmallObjectHeap::ReallocateAligned( void* pMemory, size_t alignment, size_t size )
+{
+	if( !pMemory )
+	{
+		return AllocateAligned( alignment, size );
+	}
+
+	if( size == 0 )
+	{
+		Free( pMemory );
+
+		return NULL;
+	}
+
+	AllocationHeader* pHeader = GetHeader( pMemory );
+	if( pHeader->sizeClass != SIZE_CLASS_LARGE && pHeader->sizeClass == GetSizeClass( alignment, size ) )
+	{
+		pHeader->size = size;
+
+		return pMemory;
+	}
+
+	void* pNewMemory = AllocateAligned( alignment, size );
+	if( pNewMemory )
+	{
+		MemoryCopy( pNewMemory, pMemory, Min( pHeader->size, size ) );
+		Free( pMemory );
+	}
+
+	return pNewMemory;
+}
+
+/// Free a block of memory allocated from the small object heap.
+///
+/// @param[in] pMemory  Base address of the allocation to free (can be null).  This may have been allocated on any
+///                     thread.
+///
+/// @see Allocate(), Reallocate()
+void SmallObjectHeap::Free( void* pMemory )
+{
+	if( !pMemory )
+	{
+		return;
+	}
+
+	AllocationHeader* pHeader = GetHeader( pMemory );
+	size_t sizeClass = pHeader->sizeClass;
+	uint8_t* pBase = static_cast< uint8_t* >( pMemory ) - pHeader->offset;
+
+	if( sizeClass != SIZE_CLASS_LARGE )
+	{
+		HELIUM_ASSERT( sizeClass < SIZE_CLASS_COUNT );
+		GetSizeClassPool( sizeClass ).ReleaseSlot( pBase );
+	}
+	else
+	{
+		DefaultAllocator().FreeAligned( pBase );
+	}
+
+	++GetThreadCounters().freeCounts[ sizeClass ];
+}
+
+/// Get the size of a block of memory allocated from the small object heap.
+///
+/// @param[in] pMemory  Base address of the allocation.
+///
+/// @return  Allocation size, in bytes.
+size_t SmallObjectHeap::GetMemorySize( void* pMemory )
+{
+	HELIUM_ASSERT( pMemory );
+
+	return GetHeader( pMemory )->size;
+}
+
+/// Gather the allocation counts of all threads and pass the statistics for the frame that ended to the frame
+/// statistics hook.
+///
+/// Other threads may keep allocating while this runs, so allocations made around the frame boundary may be counted
+/// towards either frame.
+///
+/// @see GetStats(), SetFrameStatsCallback()
+void SmallObjectHeap::BeginFrame()
+{
+	Stats stats;
+	FrameStatsCallback pCallback;
+
+	{
+		MutexScopeLock scopeLock( s_statsLock );
+
+		uint64_t freeCounts[ SIZE_CLASS_COUNT + 1 ] = {};
+		uint64_t allocationCounts[ SIZE_CLASS_COUNT + 1 ] = {};
+
+		size_t counterCount = s_threadCounters.GetSize();
+		for( size_t counterIndex = 0; counterIndex < counterCount; ++counterIndex )
+		{
+			const ThreadCounters* pCounters = s_threadCounters[ counterIndex ];
+			HELIUM_ASSERT( pCounters );
+
+			for( size_t sizeClass = 0; sizeClass <= SIZE_CLASS_COUNT; ++sizeClass )
+			{
+				allocationCounts[ sizeClass ] += pCounters->allocationCounts[ sizeClass ];
+				freeCounts[ sizeClass ] += pCounters->freeCounts[ sizeClass ];
+			}
+		}
+
+		for( size_t sizeClass = 0; sizeClass <= SIZE_CLASS_COUNT; ++sizeClass )
+		{
+			s_stats.frameAllocationCounts[ sizeClass ] =
+				allocationCounts[ sizeClass ] - s_stats.allocationCounts[ sizeClass ];
+			s_stats.allocationCounts[ sizeClass ] = allocationCounts[ sizeClass ];
+			s_stats.liveCounts[ sizeClass ] =
+				static_cast< int64_t >( allocationCounts[ sizeClass ] - freeCounts[ sizeClass ] );
+		}
+
+		stats = s_stats;
+		pCallback = s_pFrameStatsCallback;
+	}
+
+	if( pCallback )
+	{
+		pCallback( stats );
+	}
+}
+
+/// Get the statistics gathered by the last call to BeginFrame().
+///
+/// @param[out] rStats  Allocation statistics.
+///
+/// @see BeginFrame()
+void SmallObjectHeap::GetStats( Stats& rStats )
+{
+	MutexScopeLock scopeLock( s_statsLock );
+	rStats = s_stats;
+}
+
+/// Set the hook called by BeginFrame() with the statistics of the frame that ended.
+///
+/// @param[in] pCallback  Function to call, or null to stop calling one.
+///
+/// @see BeginFrame()
+void SmallObjectHeap::SetFrameStatsCallback( FrameStatsCallback pCallback )
+{
+	MutexScopeLock scopeLock( s_statsLock );
+	s_pFrameStatsCallback = pCallback;
+}
+
+/// Get the largest allocation size served by a size class.
+///
+/// @param[in] sizeClass  Size class index.
+///
+/// @return  Size class allocation size, in bytes, or zero for SIZE_CLASS_LARGE.
+size_t SmallObjectHeap::GetSizeClassSize( size_t sizeClass )
+{
+	HELIUM_ASSERT( sizeClass <= SIZE_CLASS_COUNT );
+
+	return ( sizeClass < SIZE_CLASS_COUNT ? s_sizeClassSizes[ sizeClass ] : 0 );
+}
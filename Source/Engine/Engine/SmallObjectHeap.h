@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Engine/Engine.h"
+
+namespace Helium
+{
+	/// Size-class heap for short-lived small allocations made from any thread.
+	///
+	/// Allocations of up to MAX_SMALL_SIZE bytes are rounded up to one of a few size classes, each backed by a
+	/// ConcurrentObjectPoolBase, so allocating and freeing normally touches only the calling thread's free list and
+	/// never takes a lock.  Unlike the thread-local stack allocator, allocations may be freed in any order and on any
+	/// thread, and unlike the frame arena they may live for as long as needed.  Larger or more strictly aligned
+	/// allocations are passed through to the default heap.
+	///
+	/// Allocation counts are kept per thread and gathered by BeginFrame(), which also passes the statistics for the
+	/// frame that ended to a hook set with SetFrameStatsCallback(), if any.
+	///
+	/// @see SmallObjectAllocator
+	class HELIUM_ENGINE_API SmallObjectHeap
+	{
+	public:
+		/// Largest allocation size served from a size class.
+		static const size_t MAX_SMALL_SIZE = 256;
+		/// Alignment of allocations made without an explicit alignment (also the largest alignment served from a size
+		/// class).
+		static const size_t DEFAULT_ALIGNMENT = 16;
+
+		/// Number of size classes.
+		static const size_t SIZE_CLASS_COUNT = 8;
+		/// Statistics index of allocations passed through to the default heap.
+		static const size_t SIZE_CLASS_LARGE = SIZE_CLASS_COUNT;
+
+		/// Allocation statistics, indexed by size class (with SIZE_CLASS_LARGE for default heap allocations).
+		struct Stats
+		{
+			/// Allocations made since startup.
+			uint64_t allocationCounts[ SIZE_CLASS_COUNT + 1 ];
+			/// Allocations not yet freed.
+			int64_t liveCounts[ SIZE_CLASS_COUNT + 1 ];
+			/// Allocations made between the last two calls to BeginFrame().
+			uint64_t frameAllocationCounts[ SIZE_CLASS_COUNT + 1 ];
+		};
+
+		/// Hook called by BeginFrame() with the statistics of the frame that ended.
+		typedef void (*FrameStatsCallback)( const Stats& rStats );
+
+		/// @name Initialization
+		//@{
+		static void Shutdown();
+		//@}
+
+		/// @name Allocation
+		//@{
+		static void* Allocate( size_t size );
+		static void* AllocateAligned( size_t alignment, size_t size );
+		static void* Reallocate( void* pMemory, size_t size );
+		static void* ReallocateAligned( void* pMemory, size_t alignment, size_t size );
+		static void Free( void* pMemory );
+		static size_t GetMemorySize( void* pMemory );
+		//@}
+
+		/// @name Statistics
+		//@{
+		static void BeginFrame();
+		static void GetStats( Stats& rStats );
+		static void SetFrameStatsCallback( FrameStatsCallback pCallback );
+		static size_t GetSizeClassSize( size_t sizeClass );
+		//@}
+	};
+
+	/// Allocator interface to the small object heap, for use with DynamicArray and other containers taking an
+	/// allocator parameter.
+	class SmallObjectAllocator
+	{
+	public:
+		/// @name Allocation
+		//@{
+		inline void* Allocate( size_t size );
+		inline void* AllocateAligned( size_t alignment, size_t size );
+		inline void* Reallocate( void* pMemory, size_t size );
+		inline void* ReallocateAligned( void* pMemory, size_t alignment, size_t size );
+		inline void Free( void* pMemory );
+		inline void FreeAligned( void* pMemory );
+		inline size_t GetMemorySize( void* pMemory );
+		//@}
+	};
+}
+
+#include "Engine/SmallObjectHeap.inl"
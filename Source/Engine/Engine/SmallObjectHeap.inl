@@ -0,0 +1,72 @@
+namespace Helium
+{
+	/// Allocate a block of memory from the small object heap.
+	///
+	/// @param[in] size  Number of bytes to allocate.
+	///
+	/// @return  Base address of the allocation if successful, null if allocation failed.
+	void* SmallObjectAllocator::Allocate( size_t size )
+	{
+		return SmallObjectHeap::Allocate( size );
+	}
+
+	/// Allocate an aligned block of memory from the small object heap.
+	///
+	/// @param[in] alignment  Allocation alignment (must be a power of two).
+	/// @param[in] size       Number of bytes to allocate.
+	///
+	/// @return  Base address of the allocation if successful, null if allocation failed.
+	void* SmallObjectAllocator::AllocateAligned( size_t alignment, size_t size )
+	{
+		return SmallObjectHeap::AllocateAligned( alignment, size );
+	}
+
+	/// Resize a block of memory allocated from the small object heap.
+	///
+	/// @param[in] pMemory  Base address of the allocation to resize (can be null).
+	/// @param[in] size     New allocation size, in bytes.
+	///
+	/// @return  Base address of the resized allocation if successful, null if reallocation failed.
+	void* SmallObjectAllocator::Reallocate( void* pMemory, size_t size )
+	{
+		return SmallObjectHeap::Reallocate( pMemory, size );
+	}
+
+	/// Resize an aligned block of memory allocated from the small object heap.
+	///
+	/// @param[in] pMemory    Base address of the allocation to resize (can be null).
+	/// @param[in] alignment  Allocation alignment (must be a power of two).
+	/// @param[in] size       New allocation size, in bytes.
+	///
+	/// @return  Base address of the resized allocation if successful, null if reallocation failed.
+	void* SmallObjectAllocator::ReallocateAligned( void* pMemory, size_t alignment, size_t size )
+	{
+		return SmallObjectHeap::ReallocateAligned( pMemory, alignment, size );
+	}
+
+	/// Free a block of memory allocated from the small object heap.
+	///
+	/// @param[in] pMemory  Base address of the allocation to free (can be null).
+	void SmallObjectAllocator::Free( void* pMemory )
+	{
+		SmallObjectHeap::Free( pMemory );
+	}
+
+	/// Free an aligned block of memory allocated from the small object heap.
+	///
+	/// @param[in] pMemory  Base address of the allocation to free (can be null).
+	void SmallObjectAllocator::FreeAligned( void* pMemory )
+	{
+		SmallObjectHeap::Free( pMemory );
+	}
+
+	/// Get the size of a block of memory allocated from the small object heap.
+	///
+	/// @param[in] pMemory  Base address of the allocation.
+	///
+	/// @return  Allocation size, in bytes.
+	size_t SmallObjectAllocator::GetMemorySize( void* pMemory )
+	{
+		return SmallObjectHeap::GetMemorySize( pMemory );
+	}
+}
@@ -54,7 +54,84 @@ private:
     Parameters m_parameters;
 };
 
+/// Parallel least-significant-digit radix sort of unsigned integer sort keys.
+///
+/// Keys are sorted eight bits at a time.  Each pass builds per-chunk digit histograms and scatters each chunk in
+/// separate jobs, so the sort is stable and scales with the number of job workers.  Callers sorting other data
+/// typically pack a sort key into the upper bits of each element and an element index into the lower bits.
+template< typename T >
+class RadixSortJob : Helium::NonCopyable
+{
+public:
+    class Parameters
+    {
+    public:
+        /// [inout] Pointer to the first key to sort.
+        T* pBase;
+        /// [in] Scratch buffer of at least "count" keys, used as the destination for alternating passes.
+        T* pScratch;
+        /// [in] Number of keys to sort.
+        size_t count;
+        /// [in] Number of keys below which each pass runs within a single job.
+        size_t singleJobCount;
+
+        /// @name Construction/Destruction
+        //@{
+        inline Parameters();
+        //@}
+    };
+
+    /// Number of key bits sorted in each pass.
+    static const size_t DIGIT_BIT_COUNT = 8;
+    /// Number of buckets for each digit.
+    static const size_t DIGIT_BUCKET_COUNT = 1 << DIGIT_BIT_COUNT;
+    /// Maximum number of chunks across which each pass is split.
+    static const size_t CHUNK_MAX = 32;
+
+    /// @name Construction/Destruction
+    //@{
+    inline RadixSortJob();
+    inline ~RadixSortJob();
+    //@}
+
+    /// @name Parameters
+    //@{
+    inline Parameters& GetParameters();
+    inline const Parameters& GetParameters() const;
+    inline void SetParameters( const Parameters& rParameters );
+    //@}
+
+    /// @name Job Execution
+    //@{
+    void Run();
+    inline static void RunCallback( void* pJob );
+    //@}
+
+private:
+    /// Work for a single chunk of keys within a pass.
+    class ChunkJob
+    {
+    public:
+        /// First key of the chunk in the source buffer.
+        const T* pSource;
+        /// Destination buffer for the whole pass.
+        T* pDestination;
+        /// Number of keys in the chunk.
+        size_t count;
+        /// Bit shift of the digit sorted by this pass.
+        size_t shift;
+        /// Digit histogram for the chunk, replaced by the destination offset of each bucket before scattering.
+        size_t buckets[ DIGIT_BUCKET_COUNT ];
+
+        static void HistogramCallback( void* pJob );
+        static void ScatterCallback( void* pJob );
+    };
+
+    Parameters m_parameters;
+};
+
 }  // namespace Helium
 
 #include "EngineJobs/EngineJobsInterface.inl"
 #include "EngineJobs/SortJob.inl"
+#include "EngineJobs/RadixSortJob.inl"
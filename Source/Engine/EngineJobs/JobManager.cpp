@@ -0,0 +1,465 @@
+#include "Precompile.h"
+#include "EngineJobs/JobManager.h"
+
+#include "Platform/Atomic.h"
+#include "Engine/FrameProfiler.h"
+#include "Platform/Trace.h"
+
+#include <thread>
+
+using namespace Helium;
+
+static uint32_t g_InitCount = 0;
+JobManager* JobManager::sm_pInstance = NULL;
+
+/// Job manager owning the current thread, or null if the current thread is not a job worker.
+static thread_local JobManager* s_pCurrentWorkerManager = NULL;
+/// Index of the worker (and deque) owned by the current thread, valid only if s_pCurrentWorkerManager is set.
+static thread_local uint32_t s_CurrentWorkerIndex = 0;
+
+/// Constructor.
+JobManager::JobDequeContents::JobDequeContents()
+    : headIndex( 0 )
+{
+}
+
+/// Constructor.
+///
+/// @param[in] pManager     Owning job manager.
+/// @param[in] workerIndex  Index of this worker.
+JobManager::Worker::Worker( JobManager* pManager, uint32_t workerIndex )
+    : m_pManager( pManager )
+    , m_workerIndex( workerIndex )
+{
+    HELIUM_ASSERT( pManager );
+}
+
+/// Destructor.
+JobManager::Worker::~Worker()
+{
+}
+
+/// Run jobs until the owning manager shuts down, sleeping whenever no work can be found or stolen.
+void JobManager::Worker::Run()
+{
+    s_pCurrentWorkerManager = m_pManager;
+    s_CurrentWorkerIndex = m_workerIndex;
+    FrameProfiler::SetThreadName( "Job Worker" );
+
+    while( m_pManager->m_stopCounter == 0 )
+    {
+        if( !m_pManager->RunPendingJob() )
+        {
+            m_pManager->m_wakeUpSemaphore.Decrement();
+        }
+    }
+
+    s_pCurrentWorkerManager = NULL;
+}
+
+/// Constructor.
+JobManager::JobManager()
+    : m_pDeques( NULL )
+    , m_workerCount( 0 )
+    , m_stopCounter( 0 )
+{
+}
+
+/// Destructor.
+JobManager::~JobManager()
+{
+    Cleanup();
+}
+
+/// Initialize the job manager and start its worker threads.
+///
+/// @param[in] workerCount  Number of worker threads to start.  If this is zero, all jobs will run inline on the
+///                         thread that spawns them.
+///
+/// @return  True if initialization was successful, false if not.
+///
+/// @see Cleanup()
+bool JobManager::Initialize( uint32_t workerCount )
+{
+    Cleanup();
+
+    m_workerCount = workerCount;
+    AtomicExchangeRelease( m_stopCounter, 0 );
+
+    // One deque per worker, plus one shared by every thread that is not a worker.
+    m_pDeques = new JobDeque [ workerCount + 1 ];
+    HELIUM_ASSERT( m_pDeques );
+
+    m_workers.Reserve( workerCount );
+    m_workerThreads.Reserve( workerCount );
+    for( uint32_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+    {
+        Worker* pWorker = new Worker( this, workerIndex );
+        HELIUM_ASSERT( pWorker );
+
+        RunnableThread* pThread = new RunnableThread( pWorker );
+        HELIUM_ASSERT( pThread );
+        HELIUM_VERIFY( pThread->Start( "JobManager - job worker" ) );
+
+        m_workers.Push( pWorker );
+        m_workerThreads.Push( pThread );
+    }
+
+    HELIUM_TRACE( TraceLevels::Info, "JobManager: Started %" PRIu32 " job worker threads.\n", workerCount );
+
+    return true;
+}
+
+/// Stop all worker threads and release the job deques.
+///
+/// All jobs spawned through this manager must have completed prior to calling this function.
+///
+/// @see Initialize()
+void JobManager::Cleanup()
+{
+    AtomicExchangeRelease( m_stopCounter, 1 );
+
+    size_t workerCount = m_workerThreads.GetSize();
+    for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+    {
+        m_wakeUpSemaphore.Increment();
+    }
+
+    for( size_t workerIndex = 0; workerIndex < workerCount; ++workerIndex )
+    {
+        m_workerThreads[ workerIndex ]->Join();
+        delete m_workerThreads[ workerIndex ];
+        delete m_workers[ workerIndex ];
+    }
+
+    m_workerThreads.Clear();
+    m_workers.Clear();
+    m_wakeUpSemaphore.Reset();
+
+#if HELIUM_ASSERT_ENABLED
+    if( m_pDeques )
+    {
+        for( uint32_t dequeIndex = 0; dequeIndex <= m_workerCount; ++dequeIndex )
+        {
+            JobDeque::Handle handle( m_pDeques[ dequeIndex ] );
+            HELIUM_ASSERT( handle->jobs.GetSize() == handle->headIndex );
+        }
+    }
+#endif
+
+    delete [] m_pDeques;
+    m_pDeques = NULL;
+    m_workerCount = 0;
+}
+
+/// Queue a job for execution.
+///
+/// Jobs spawned from a worker thread are queued with that worker so that child jobs tend to run on the same core as
+/// their parent.  Jobs spawned from any other thread are queued in a deque shared by all non-worker threads.
+///
+/// @param[in] pCallback  Job entry point.
+/// @param[in] pJob       Job to run.  This must remain valid until the counter reports completion.
+/// @param[in] rCounter   Counter to increment for the job and decrement once the job has finished.
+///
+/// @see WaitForCounter()
+void JobManager::Spawn( JOB_CALLBACK pCallback, void* pJob, JobCounter& rCounter )
+{
+    HELIUM_ASSERT( pCallback );
+
+    Job job;
+    job.pCallback = pCallback;
+    job.pJob = pJob;
+    job.pCounter = &rCounter;
+
+    AtomicIncrementAcquire( rCounter.m_pendingCount );
+
+    if( m_workerCount == 0 )
+    {
+        ExecuteJob( job );
+
+        return;
+    }
+
+    {
+        JobDeque::Handle handle( m_pDeques[ GetCurrentDequeIndex() ] );
+        handle->jobs.Push( job );
+    }
+
+    m_wakeUpSemaphore.Increment();
+}
+
+/// Block until all jobs spawned against the given counter have completed, running pending jobs in the meantime.
+///
+/// @param[in] rCounter  Counter on which to wait.
+///
+/// @see Spawn()
+void JobManager::WaitForCounter( JobCounter& rCounter )
+{
+    while( !rCounter.IsComplete() )
+    {
+        if( !RunPendingJob() )
+        {
+            Thread::Yield();
+        }
+    }
+}
+
+/// Run a single pending job on the current thread, if one can be found.
+///
+/// The current thread's own deque is checked first, after which jobs are stolen from other threads.
+///
+/// @return  True if a job was run, false if no pending job was found.
+bool JobManager::RunPendingJob()
+{
+    if( m_workerCount == 0 )
+    {
+        return false;
+    }
+
+    Job job;
+    if( !TakeJob( GetCurrentDequeIndex(), job ) )
+    {
+        return false;
+    }
+
+    ExecuteJob( job );
+
+    return true;
+}
+
+/// Get whether the current thread is one of this manager's worker threads.
+///
+/// @return  True if the current thread is a worker of this manager, false if not.
+bool JobManager::IsWorkerThread() const
+{
+    return ( s_pCurrentWorkerManager == this );
+}
+
+/// Get the singleton JobManager instance.
+///
+/// @return  Pointer to the JobManager instance, or null if it has not been started.
+///
+/// @see Startup(), Shutdown()
+JobManager* JobManager::GetInstance()
+{
+    return sm_pInstance;
+}
+
+/// Create the singleton JobManager instance.
+///
+/// @param[in] workerCount  Number of worker threads to start (ignored if the instance already exists).
+///
+/// @see Shutdown(), GetInstance()
+void JobManager::Startup( uint32_t workerCount )
+{
+    if( ++g_InitCount == 1 )
+    {
+        HELIUM_ASSERT( !sm_pInstance );
+        sm_pInstance = new JobManager;
+        HELIUM_ASSERT( sm_pInstance );
+        if( !HELIUM_VERIFY( sm_pInstance->Initialize( workerCount ) ) )
+        {
+            Shutdown();
+        }
+    }
+}
+
+/// Destroy the singleton JobManager instance.
+///
+/// @see Startup(), GetInstance()
+void JobManager::Shutdown()
+{
+    if( --g_InitCount == 0 )
+    {
+        HELIUM_ASSERT( sm_pInstance );
+        sm_pInstance->Cleanup();
+        delete sm_pInstance;
+        sm_pInstance = NULL;
+    }
+}
+
+/// Get the number of worker threads to start by default.
+///
+/// @return  One worker for each hardware thread beyond the one running the main loop.
+uint32_t JobManager::GetDefaultWorkerCount()
+{
+    uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+
+    return ( hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 0 );
+}
+
+/// Queue a job with the JobManager instance if one exists, or run it immediately if not.
+///
+/// @param[in] pCallback  Job entry point.
+/// @param[in] pJob       Job to run.  This must remain valid until the counter reports completion.
+/// @param[in] rCounter   Counter to increment for the job and decrement once the job has finished.
+///
+/// @see WaitOrReturn()
+void JobManager::SpawnOrRun( JOB_CALLBACK pCallback, void* pJob, JobCounter& rCounter )
+{
+    HELIUM_ASSERT( pCallback );
+
+    if( sm_pInstance )
+    {
+        sm_pInstance->Spawn( pCallback, pJob, rCounter );
+    }
+    else
+    {
+        pCallback( pJob );
+    }
+}
+
+/// Wait on a counter with the JobManager instance if one exists, or return immediately if not (in which case all
+/// jobs given to SpawnOrRun() have already been run inline).
+///
+/// @param[in] rCounter  Counter on which to wait.
+///
+/// @see SpawnOrRun()
+void JobManager::WaitOrReturn( JobCounter& rCounter )
+{
+    if( sm_pInstance )
+    {
+        sm_pInstance->WaitForCounter( rCounter );
+    }
+
+    HELIUM_ASSERT( rCounter.IsComplete() );
+}
+
+/// Run a callback once for each index in [0, count), spreading the work across the JobManager instance's workers if
+/// one exists, and return once every index has been processed.
+///
+/// Indices are split into a few contiguous ranges per worker so that uneven items still balance out through
+/// stealing.  The calling thread runs pending jobs while it waits.
+///
+/// @param[in] pCallback  Callback to run for each index.
+/// @param[in] pContext   Context passed to the callback.
+/// @param[in] count      Number of indices to process.
+void JobManager::ParallelFor( PARALLEL_FOR_CALLBACK pCallback, void* pContext, size_t count )
+{
+    HELIUM_ASSERT( pCallback );
+
+    uint32_t workerCount = ( sm_pInstance ? sm_pInstance->GetWorkerCount() : 0 );
+    if( workerCount == 0 || count <= 1 )
+    {
+        for( size_t index = 0; index < count; ++index )
+        {
+            pCallback( pContext, index );
+        }
+
+        return;
+    }
+
+    static const size_t JOBS_PER_THREAD = 4;
+
+    size_t jobCount = Min( count, static_cast< size_t >( workerCount + 1 ) * JOBS_PER_THREAD );
+    size_t itemsPerJob = count / jobCount;
+    size_t extraItemCount = count % jobCount;
+
+    DynamicArray< ParallelForJob > jobs;
+    jobs.Resize( jobCount );
+
+    size_t beginIndex = 0;
+    for( size_t jobIndex = 0; jobIndex < jobCount; ++jobIndex )
+    {
+        ParallelForJob& rJob = jobs[ jobIndex ];
+        rJob.pCallback = pCallback;
+        rJob.pContext = pContext;
+        rJob.beginIndex = beginIndex;
+        beginIndex += itemsPerJob + ( jobIndex < extraItemCount ? 1 : 0 );
+        rJob.endIndex = beginIndex;
+    }
+
+    HELIUM_ASSERT( beginIndex == count );
+
+    JobCounter counter;
+    for( size_t jobIndex = 0; jobIndex < jobCount; ++jobIndex )
+    {
+        sm_pInstance->Spawn( &jobs[ jobIndex ], counter );
+    }
+
+    sm_pInstance->WaitForCounter( counter );
+}
+
+/// Run the items of a ParallelFor() range.
+///
+/// @param[in] pJob  ParallelForJob to run.
+void JobManager::ParallelForJob::RunCallback( void* pJob )
+{
+    ParallelForJob* pThis = static_cast< ParallelForJob* >( pJob );
+    HELIUM_ASSERT( pThis );
+    HELIUM_ASSERT( pThis->pCallback );
+
+    for( size_t index = pThis->beginIndex; index < pThis->endIndex; ++index )
+    {
+        pThis->pCallback( pThis->pContext, index );
+    }
+}
+
+/// Get the index of the deque to which jobs spawned from the current thread should be queued.
+///
+/// @return  Deque index.
+uint32_t JobManager::GetCurrentDequeIndex() const
+{
+    return ( s_pCurrentWorkerManager == this ? s_CurrentWorkerIndex : m_workerCount );
+}
+
+/// Take a job from the given deque, stealing from the other deques if it is empty.
+///
+/// @param[in]  dequeIndex  Index of the deque owned by the current thread.
+/// @param[out] rJob        Job taken, if any.
+///
+/// @return  True if a job was taken, false if all deques were empty.
+bool JobManager::TakeJob( uint32_t dequeIndex, Job& rJob )
+{
+    HELIUM_ASSERT( dequeIndex <= m_workerCount );
+
+    // Pop the most recently queued job from our own deque first.
+    {
+        JobDeque::Handle handle( m_pDeques[ dequeIndex ] );
+        if( handle->jobs.GetSize() > handle->headIndex )
+        {
+            rJob = handle->jobs.Pop();
+            if( handle->jobs.GetSize() == handle->headIndex )
+            {
+                handle->jobs.Resize( 0 );
+                handle->headIndex = 0;
+            }
+
+            return true;
+        }
+    }
+
+    // Steal the oldest job from the next deque that has work, starting with our neighbor.
+    uint32_t dequeCount = m_workerCount + 1;
+    for( uint32_t offset = 1; offset < dequeCount; ++offset )
+    {
+        JobDeque::Handle handle( m_pDeques[ ( dequeIndex + offset ) % dequeCount ] );
+        if( handle->jobs.GetSize() > handle->headIndex )
+        {
+            rJob = handle->jobs[ handle->headIndex ];
+            ++handle->headIndex;
+            if( handle->jobs.GetSize() == handle->headIndex )
+            {
+                handle->jobs.Resize( 0 );
+                handle->headIndex = 0;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Run a job and signal its completion.
+///
+/// @param[in] rJob  Job to run.
+void JobManager::ExecuteJob( const Job& rJob )
+{
+    HELIUM_ASSERT( rJob.pCallback );
+    HELIUM_ASSERT( rJob.pCounter );
+
+    rJob.pCallback( rJob.pJob );
+
+    AtomicDecrementRelease( rJob.pCounter->m_pendingCount );
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include "Platform/Locks.h"
+#include "Platform/Semaphore.h"
+#include "Platform/Thread.h"
+
+#include "Foundation/DynamicArray.h"
+
+#include "EngineJobs/EngineJobs.h"
+
+namespace Helium
+{
+    /// Job entry point.
+    ///
+    /// @param[in] pJob  Job to run (the same signature as the static RunCallback() of each job type).
+    typedef void ( *JOB_CALLBACK )( void* pJob );
+
+    /// Parallel-for item callback.
+    ///
+    /// @param[in] pContext  Context given to JobManager::ParallelFor().
+    /// @param[in] index     Index of the item to process.
+    typedef void ( *PARALLEL_FOR_CALLBACK )( void* pContext, size_t index );
+
+    /// Counter tracking the completion of a group of jobs.
+    ///
+    /// The counter is incremented when a job is spawned against it and decremented once that job has finished, so a
+    /// group of jobs (including any child jobs spawned against the same counter) has completed once it reaches zero.
+    class HELIUM_ENGINE_JOBS_API JobCounter : NonCopyable
+    {
+    public:
+        /// @name Construction/Destruction
+        //@{
+        inline JobCounter();
+        inline ~JobCounter();
+        //@}
+
+        /// @name Status
+        //@{
+        inline bool IsComplete() const;
+        inline int32_t GetPendingCount() const;
+        //@}
+
+    private:
+        /// Number of jobs spawned against this counter that have not yet completed.
+        volatile int32_t m_pendingCount;
+
+        friend class JobManager;
+    };
+
+    /// Work-stealing job runtime.
+    ///
+    /// Each worker thread owns a job deque.  Jobs spawned from a worker (child jobs) are pushed to the back of that
+    /// worker's deque and popped from the back again so related work stays on the same core, while idle workers steal
+    /// from the front of other deques.  Jobs spawned from any thread that is not a worker go to a shared deque that
+    /// every worker steals from.  Threads waiting on a JobCounter run pending jobs instead of blocking.
+    ///
+    /// When no JobManager instance exists, or it was started with no workers, jobs run inline on the spawning thread.
+    class HELIUM_ENGINE_JOBS_API JobManager : NonCopyable
+    {
+    public:
+        /// @name Initialization
+        //@{
+        bool Initialize( uint32_t workerCount );
+        void Cleanup();
+        //@}
+
+        /// @name Job Spawning
+        //@{
+        void Spawn( JOB_CALLBACK pCallback, void* pJob, JobCounter& rCounter );
+        template< typename JobType > void Spawn( JobType* pJob, JobCounter& rCounter );
+
+        void WaitForCounter( JobCounter& rCounter );
+        bool RunPendingJob();
+        //@}
+
+        /// @name Data Access
+        //@{
+        inline uint32_t GetWorkerCount() const;
+        bool IsWorkerThread() const;
+        //@}
+
+        /// @name Static Access
+        //@{
+        static JobManager* GetInstance();
+        static void Startup( uint32_t workerCount = GetDefaultWorkerCount() );
+        static void Shutdown();
+
+        static uint32_t GetDefaultWorkerCount();
+
+        static void SpawnOrRun( JOB_CALLBACK pCallback, void* pJob, JobCounter& rCounter );
+        template< typename JobType > static void SpawnOrRun( JobType* pJob, JobCounter& rCounter );
+        static void WaitOrReturn( JobCounter& rCounter );
+
+        static void ParallelFor( PARALLEL_FOR_CALLBACK pCallback, void* pContext, size_t count );
+        //@}
+
+    private:
+        /// Queued job.
+        struct Job
+        {
+            /// Job entry point.
+            JOB_CALLBACK pCallback;
+            /// Job instance passed to the callback.
+            void* pJob;
+            /// Counter to decrement once the job completes.
+            JobCounter* pCounter;
+        };
+
+        /// Range of items processed by one ParallelFor() job.
+        struct ParallelForJob
+        {
+            /// Item callback.
+            PARALLEL_FOR_CALLBACK pCallback;
+            /// Context passed to the callback.
+            void* pContext;
+            /// First item index.
+            size_t beginIndex;
+            /// One past the last item index.
+            size_t endIndex;
+
+            static void RunCallback( void* pJob );
+        };
+
+        /// Job deque contents.
+        struct JobDequeContents
+        {
+            /// Queued jobs.  Entries before the head index have already been stolen.
+            DynamicArray< Job > jobs;
+            /// Index of the first job still in the deque.
+            size_t headIndex;
+
+            /// @name Construction/Destruction
+            //@{
+            JobDequeContents();
+            //@}
+        };
+
+        /// Job deque owned by a single thread (or shared by all non-worker threads), locked so that other threads
+        /// may steal from it.
+        typedef Locker< JobDequeContents, SpinLock > JobDeque;
+
+        /// Job worker thread runnable.
+        class Worker : public Runnable
+        {
+        public:
+            /// @name Construction/Destruction
+            //@{
+            Worker( JobManager* pManager, uint32_t workerIndex );
+            virtual ~Worker();
+            //@}
+
+            /// @name Runnable Interface
+            //@{
+            virtual void Run();
+            //@}
+
+        private:
+            /// Owning job manager.
+            JobManager* m_pManager;
+            /// Index of this worker (and its deque).
+            uint32_t m_workerIndex;
+        };
+
+        /// Per-worker deques, followed by the deque shared by all non-worker threads.
+        JobDeque* m_pDeques;
+        /// Worker runnables.
+        DynamicArray< Worker* > m_workers;
+        /// Worker threads.
+        DynamicArray< RunnableThread* > m_workerThreads;
+        /// Number of worker threads.
+        uint32_t m_workerCount;
+
+        /// Semaphore used to wake up sleeping workers when jobs are spawned (or when they should shut down).
+        Semaphore m_wakeUpSemaphore;
+        /// Non-zero if the workers should stop when next possible, zero if they should continue.
+        volatile int32_t m_stopCounter;
+
+        /// Singleton instance.
+        static JobManager* sm_pInstance;
+
+        /// @name Construction/Destruction
+        //@{
+        JobManager();
+        ~JobManager();
+        //@}
+
+        /// @name Private Utility Functions
+        //@{
+        uint32_t GetCurrentDequeIndex() const;
+        bool TakeJob( uint32_t dequeIndex, Job& rJob );
+        void ExecuteJob( const Job& rJob );
+        //@}
+    };
+}
+
+#include "EngineJobs/JobManager.inl"
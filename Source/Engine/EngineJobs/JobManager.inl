@@ -0,0 +1,66 @@
+namespace Helium
+{
+    /// Constructor.
+    JobCounter::JobCounter()
+        : m_pendingCount( 0 )
+    {
+    }
+
+    /// Destructor.
+    JobCounter::~JobCounter()
+    {
+        HELIUM_ASSERT( m_pendingCount == 0 );
+    }
+
+    /// Get whether all jobs spawned against this counter have completed.
+    ///
+    /// @return  True if no jobs are pending, false if any jobs are still queued or running.
+    ///
+    /// @see GetPendingCount()
+    bool JobCounter::IsComplete() const
+    {
+        return ( m_pendingCount == 0 );
+    }
+
+    /// Get the number of jobs spawned against this counter that have not yet completed.
+    ///
+    /// @return  Pending job count.
+    ///
+    /// @see IsComplete()
+    int32_t JobCounter::GetPendingCount() const
+    {
+        return m_pendingCount;
+    }
+
+    /// Get the number of worker threads owned by this manager.
+    ///
+    /// @return  Worker thread count.
+    uint32_t JobManager::GetWorkerCount() const
+    {
+        return m_workerCount;
+    }
+
+    /// Queue a job for execution.
+    ///
+    /// @param[in] pJob      Job to run.  This must remain valid until the counter reports completion.
+    /// @param[in] rCounter  Counter to increment for the job and decrement once the job has finished.
+    ///
+    /// @see WaitForCounter()
+    template< typename JobType >
+    void JobManager::Spawn( JobType* pJob, JobCounter& rCounter )
+    {
+        Spawn( &JobType::RunCallback, pJob, rCounter );
+    }
+
+    /// Queue a job with the JobManager instance if one exists, or run it immediately if not.
+    ///
+    /// @param[in] pJob      Job to run.  This must remain valid until the counter reports completion.
+    /// @param[in] rCounter  Counter to increment for the job and decrement once the job has finished.
+    ///
+    /// @see WaitOrReturn()
+    template< typename JobType >
+    void JobManager::SpawnOrRun( JobType* pJob, JobCounter& rCounter )
+    {
+        SpawnOrRun( &JobType::RunCallback, pJob, rCounter );
+    }
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "EngineJobs/EngineJobs.h"
+#include "EngineJobs/JobManager.h"
+#include "Platform/MemoryHeap.h"
+
+namespace Helium
+{
+
+	/// Constructor.
+	template< typename T >
+	RadixSortJob< T >::RadixSortJob()
+	{
+	}
+
+	/// Destructor.
+	template< typename T >
+	RadixSortJob< T >::~RadixSortJob()
+	{
+	}
+
+	/// Get the parameters for this job.
+	///
+	/// @return  Reference to the structure containing the job parameters.
+	///
+	/// @see SetParameters()
+	template< typename T >
+	typename RadixSortJob< T >::Parameters& RadixSortJob< T >::GetParameters()
+	{
+		return m_parameters;
+	}
+
+	/// Get the parameters for this job.
+	///
+	/// @return  Constant reference to the structure containing the job parameters.
+	///
+	/// @see SetParameters()
+	template< typename T >
+	const typename RadixSortJob< T >::Parameters& RadixSortJob< T >::GetParameters() const
+	{
+		return m_parameters;
+	}
+
+	/// Set the job parameters.
+	///
+	/// @param[in] rParameters  Structure containing the job parameters.
+	///
+	/// @see GetParameters()
+	template< typename T >
+	void RadixSortJob< T >::SetParameters( const Parameters& rParameters )
+	{
+		m_parameters = rParameters;
+	}
+
+	/// Callback executed to run the job.
+	///
+	/// @param[in] pJob  Job to run.
+	template< typename T >
+	void RadixSortJob< T >::RunCallback( void* pJob )
+	{
+		HELIUM_ASSERT( pJob );
+		static_cast< RadixSortJob* >( pJob )->Run();
+	}
+
+	/// Constructor.
+	template< typename T >
+	RadixSortJob< T >::Parameters::Parameters()
+		: pBase( NULL )
+		, pScratch( NULL )
+		, count( 0 )
+		, singleJobCount( 4096 )
+	{
+	}
+
+}  // namespace Helium
+
+namespace Helium
+{
+    /// Build the digit histogram for a chunk of keys.
+    ///
+    /// @param[in] pJob  Chunk to process.
+    template< typename T >
+    void RadixSortJob< T >::ChunkJob::HistogramCallback( void* pJob )
+    {
+        HELIUM_ASSERT( pJob );
+        ChunkJob& rChunk = *static_cast< ChunkJob* >( pJob );
+
+        MemoryZero( rChunk.buckets, sizeof( rChunk.buckets ) );
+
+        const T* pSource = rChunk.pSource;
+        const T* pSourceEnd = pSource + rChunk.count;
+        size_t shift = rChunk.shift;
+        for( ; pSource < pSourceEnd; ++pSource )
+        {
+            ++rChunk.buckets[ ( *pSource >> shift ) & ( DIGIT_BUCKET_COUNT - 1 ) ];
+        }
+    }
+
+    /// Scatter a chunk of keys to their destination offsets.
+    ///
+    /// @param[in] pJob  Chunk to process.
+    template< typename T >
+    void RadixSortJob< T >::ChunkJob::ScatterCallback( void* pJob )
+    {
+        HELIUM_ASSERT( pJob );
+        ChunkJob& rChunk = *static_cast< ChunkJob* >( pJob );
+
+        const T* pSource = rChunk.pSource;
+        const T* pSourceEnd = pSource + rChunk.count;
+        T* pDestination = rChunk.pDestination;
+        size_t shift = rChunk.shift;
+        for( ; pSource < pSourceEnd; ++pSource )
+        {
+            T key = *pSource;
+            pDestination[ rChunk.buckets[ ( key >> shift ) & ( DIGIT_BUCKET_COUNT - 1 ) ]++ ] = key;
+        }
+    }
+
+    /// Sort the array of keys.
+    ///
+    /// Passes in which every key shares the same digit are skipped.  The sorted result is always left in the
+    /// "pBase" buffer.
+    template< typename T >
+    void RadixSortJob< T >::Run()
+    {
+        size_t count = m_parameters.count;
+        if( count <= 1 )
+        {
+            return;
+        }
+
+        T* pSource = m_parameters.pBase;
+        HELIUM_ASSERT( pSource );
+        T* pDestination = m_parameters.pScratch;
+        HELIUM_ASSERT( pDestination );
+
+        size_t singleJobCount = Max< size_t >( m_parameters.singleJobCount, 1 );
+        size_t chunkCount = Min< size_t >( ( count + singleJobCount - 1 ) / singleJobCount, CHUNK_MAX );
+        size_t chunkSize = ( count + chunkCount - 1 ) / chunkCount;
+        chunkCount = ( count + chunkSize - 1 ) / chunkSize;
+
+        ChunkJob chunks[ CHUNK_MAX ];
+
+        for( size_t shift = 0; shift < sizeof( T ) * 8; shift += DIGIT_BIT_COUNT )
+        {
+            JobCounter counter;
+            for( size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex )
+            {
+                ChunkJob& rChunk = chunks[ chunkIndex ];
+                size_t chunkStart = chunkIndex * chunkSize;
+                rChunk.pSource = pSource + chunkStart;
+                rChunk.pDestination = pDestination;
+                rChunk.count = Min( chunkSize, count - chunkStart );
+                rChunk.shift = shift;
+
+                JobManager::SpawnOrRun( &ChunkJob::HistogramCallback, &rChunk, counter );
+            }
+
+            JobManager::WaitOrReturn( counter );
+
+            // Convert the histograms into destination offsets, ordering by bucket and then by chunk so that the sort
+            // remains stable.
+            bool bSingleBucket = false;
+            size_t offset = 0;
+            for( size_t bucketIndex = 0; bucketIndex < DIGIT_BUCKET_COUNT; ++bucketIndex )
+            {
+                size_t bucketStart = offset;
+                for( size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex )
+                {
+                    size_t& rBucket = chunks[ chunkIndex ].buckets[ bucketIndex ];
+                    size_t bucketCount = rBucket;
+                    rBucket = offset;
+                    offset += bucketCount;
+                }
+
+                if( offset - bucketStart == count )
+                {
+                    bSingleBucket = true;
+                    break;
+                }
+            }
+
+            if( bSingleBucket )
+            {
+                // Every key has the same digit in this pass, so the keys are already in order for it.
+                continue;
+            }
+
+            for( size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex )
+            {
+                JobManager::SpawnOrRun( &ChunkJob::ScatterCallback, &chunks[ chunkIndex ], counter );
+            }
+
+            JobManager::WaitOrReturn( counter );
+
+            Swap( pSource, pDestination );
+        }
+
+        if( pSource != m_parameters.pBase )
+        {
+            MemoryCopy( m_parameters.pBase, pSource, count * sizeof( T ) );
+        }
+    }
+}
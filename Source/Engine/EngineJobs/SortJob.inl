@@ -64,9 +64,55 @@ namespace Helium
         }
     }
 
+    /// Recursively sort an array of elements, splitting each partition that is still larger than the given size
+    /// into a child job.
+    template< typename T, typename CompareFunction >
+    static void _ParallelQuicksort( T* pBase, size_t count, CompareFunction& rCompare, size_t singleJobCount )
+    {
+        HELIUM_ASSERT( pBase );
+        HELIUM_ASSERT( singleJobCount >= 2 );
+
+        if( count <= singleJobCount )
+        {
+            if( count > 1 )
+            {
+                _Quicksort( pBase, count, rCompare );
+            }
+
+            return;
+        }
+
+        size_t pivotIndex = _Partition( pBase, count, rCompare );
+
+        // Hand the lower partition off to a child job and keep sorting the upper partition on this thread.
+        JobCounter counter;
+        SortJob< T, CompareFunction > childJob;
+        if( pivotIndex > 1 )
+        {
+            typename SortJob< T, CompareFunction >::Parameters& rChildParameters = childJob.GetParameters();
+            rChildParameters.pBase = pBase;
+            rChildParameters.count = pivotIndex;
+            rChildParameters.compare = rCompare;
+            rChildParameters.singleJobCount = singleJobCount;
+
+            JobManager::SpawnOrRun( &childJob, counter );
+        }
+
+        size_t startIndex = pivotIndex + 1;
+        HELIUM_ASSERT( startIndex <= count );
+        size_t partitionSize = count - startIndex;
+        if( partitionSize > 1 )
+        {
+            _ParallelQuicksort( pBase + startIndex, partitionSize, rCompare, singleJobCount );
+        }
+
+        JobManager::WaitOrReturn( counter );
+    }
+
     /// Recursively sort an array of elements.
     ///
-    /// @param[in] pContext  Context in which this job is running.
+    /// Partitions larger than the singleJobCount parameter are split across child jobs when a JobManager is running;
+    /// otherwise the whole sort runs on the calling thread.
     template< typename T, typename CompareFunction >
     void SortJob< T, CompareFunction >::Run()
     {
@@ -80,7 +126,15 @@ namespace Helium
         HELIUM_ASSERT( pBase );
 
         CompareFunction& rCompare = m_parameters.compare;
-        
-		_Quicksort( pBase, count, rCompare );
+
+        JobManager* pJobManager = JobManager::GetInstance();
+        if( !pJobManager || pJobManager->GetWorkerCount() == 0 || count <= m_parameters.singleJobCount )
+        {
+            _Quicksort( pBase, count, rCompare );
+
+            return;
+        }
+
+        _ParallelQuicksort( pBase, count, rCompare, Max< size_t >( m_parameters.singleJobCount, 2 ) );
     }
 }
@@ -0,0 +1,758 @@
+#include "Precompile.h"
+#include "Framework/Benchmark.h"
+
+#include "Platform/Timer.h"
+#include "Foundation/FileStream.h"
+#include "Foundation/BufferedStream.h"
+#include "Foundation/DirectoryIterator.h"
+#include "Engine/AssetLoader.h"
+#include "Engine/AssetLoadTrace.h"
+#include "Engine/FileLocations.h"
+#include "Engine/MemoryTelemetry.h"
+#include "Engine/RenderStatistics.h"
+#include "Framework/TaskScheduler.h"
+#include "Framework/WorldManager.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+
+#if HELIUM_OS_WIN
+#include <windows.h>
+#elif HELIUM_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Helium;
+
+namespace
+{
+	/// Write a string to a stream.
+	void WriteString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( pString, sizeof( char ), StringLength( pString ) );
+	}
+
+	/// Write a string to a stream as a quoted JSON string.
+	void WriteJsonString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( "\"", sizeof( char ), 1 );
+
+		for( const char* pCharacter = pString; *pCharacter != '\0'; ++pCharacter )
+		{
+			if( *pCharacter == '"' || *pCharacter == '\\' )
+			{
+				rStream.Write( "\\", sizeof( char ), 1 );
+			}
+
+			rStream.Write( pCharacter, sizeof( char ), 1 );
+		}
+
+		rStream.Write( "\"", sizeof( char ), 1 );
+	}
+
+	/// Convert a tick count to milliseconds.
+	float64_t TicksToMilliseconds( uint64_t ticks )
+	{
+		return static_cast< float64_t >( ticks ) * Timer::GetSecondsPerTick() * 1000.0;
+	}
+
+	/// Evict a file from the OS page cache.
+	bool EvictFileFromPageCache( const FilePath& rPath )
+	{
+#if HELIUM_OS_WIN
+		// Opening a file without buffering makes the cache manager flush and purge the pages it holds for the file.
+		HANDLE hFile = CreateFileA(
+			rPath.Data(),
+			GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_WRITE,
+			NULL,
+			OPEN_EXISTING,
+			FILE_FLAG_NO_BUFFERING,
+			NULL );
+		if( hFile == INVALID_HANDLE_VALUE )
+		{
+			return false;
+		}
+
+		CloseHandle( hFile );
+
+		return true;
+#elif HELIUM_OS_LINUX
+		int fileDescriptor = open( rPath.Data(), O_RDONLY );
+		if( fileDescriptor < 0 )
+		{
+			return false;
+		}
+
+		bool bEvicted = ( posix_fadvise( fileDescriptor, 0, 0, POSIX_FADV_DONTNEED ) == 0 );
+		close( fileDescriptor );
+
+		return bEvicted;
+#else
+		HELIUM_UNREF( rPath );
+
+		return false;
+#endif
+	}
+
+	/// Get a percentile of a sorted set of samples, using the nearest-rank method.
+	uint64_t GetPercentile( const DynamicArray< uint64_t >& rSortedSamples, uint32_t percentile )
+	{
+		size_t sampleCount = rSortedSamples.GetSize();
+		HELIUM_ASSERT( sampleCount != 0 );
+
+		size_t rank = ( static_cast< size_t >( percentile ) * sampleCount + 99 ) / 100;
+		rank = Clamp< size_t >( rank, 1, sampleCount );
+
+		return rSortedSamples[ rank - 1 ];
+	}
+}
+
+/// Constructor.
+BenchmarkParameters::BenchmarkParameters()
+: bEnabled( false )
+, bNullRenderer( false )
+, frameCount( DEFAULT_FRAME_COUNT )
+, warmupFrameCount( DEFAULT_WARMUP_FRAME_COUNT )
+, seed( 0 )
+, frameDeltaSeconds( 1.0f / 60.0f )
+, outputPath( "benchmark.json" )
+, loadTracePath( "assetload_trace.json" )
+, bFlushPageCache( false )
+{
+}
+
+/// Constructor.
+///
+/// If the benchmark is enabled, this seeds the random number generator, so the benchmark should be created before any
+/// scene is loaded in order for scene setup to be repeatable as well.  If this is a load benchmark of a cold start,
+/// this also evicts the data files from the OS page cache, so it should be created before the engine opens or maps
+/// any of them.
+///
+/// @param[in] rParameters  Benchmark settings.
+Benchmark::Benchmark( const BenchmarkParameters& rParameters )
+: m_parameters( rParameters )
+, m_frameStartTickCount( 0 )
+, m_profilerReadTickCount( 0 )
+, m_frameIndex( 0 )
+, m_previousFixedFrameDeltaSeconds( 0.0f )
+, m_bPreviousTaskTimingEnabled( true )
+, m_bPreviousFrameProfilerEnabled( false )
+{
+	MemoryZero( m_renderCounterTotals, sizeof( m_renderCounterTotals ) );
+	MemoryZero( m_renderCounterMaxima, sizeof( m_renderCounterMaxima ) );
+	m_gpuMillisecondsTotal = 0.0;
+	m_gpuMillisecondsMax = 0.0f;
+
+	if( m_parameters.bEnabled )
+	{
+		srand( m_parameters.seed );
+	}
+
+	if( IsLoadBenchmark() && m_parameters.bFlushPageCache )
+	{
+		FilePath baseDirectory;
+		if( FileLocations::GetBaseDirectory( baseDirectory ) )
+		{
+			FlushPageCache( baseDirectory );
+		}
+	}
+}
+
+/// Read benchmark settings from the application command line.
+///
+/// Recognized arguments are "-benchmark" (run the benchmark), "-frames <count>", "-warmup <count>", "-seed <value>",
+/// "-fixeddelta <seconds>", "-nullrenderer", "-input <script path>", "-output <results path>", and, for load
+/// benchmarks, "-loadbenchmark <asset path>", "-loadtrace <trace path>", and "-flushpagecache".  Other arguments are
+/// ignored.
+///
+/// @param[in]  argc         Number of command line arguments.
+/// @param[in]  argv         Command line arguments, including the program name.
+/// @param[out] rParameters  Settings read from the command line.  Settings not given keep their current values.
+///
+/// @return  True if "-benchmark" was given, false if not.
+bool Benchmark::ParseCommandLine( int argc, const char* const* argv, BenchmarkParameters& rParameters )
+{
+	HELIUM_ASSERT( argc == 0 || argv );
+
+	for( int argumentIndex = 1; argumentIndex < argc; ++argumentIndex )
+	{
+		const char* pArgument = argv[ argumentIndex ];
+		HELIUM_ASSERT( pArgument );
+
+		const char* pValue = ( argumentIndex + 1 < argc ? argv[ argumentIndex + 1 ] : NULL );
+
+		if( CaseInsensitiveCompareString( pArgument, "-benchmark" ) == 0 )
+		{
+			rParameters.bEnabled = true;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-nullrenderer" ) == 0 )
+		{
+			rParameters.bNullRenderer = true;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-flushpagecache" ) == 0 )
+		{
+			rParameters.bFlushPageCache = true;
+		}
+		else if( !pValue )
+		{
+			continue;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-frames" ) == 0 )
+		{
+			rParameters.frameCount = static_cast< uint32_t >( strtoul( pValue, NULL, 10 ) );
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-warmup" ) == 0 )
+		{
+			rParameters.warmupFrameCount = static_cast< uint32_t >( strtoul( pValue, NULL, 10 ) );
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-seed" ) == 0 )
+		{
+			rParameters.seed = static_cast< uint32_t >( strtoul( pValue, NULL, 10 ) );
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-fixeddelta" ) == 0 )
+		{
+			rParameters.frameDeltaSeconds = Max( static_cast< float32_t >( atof( pValue ) ), 0.0f );
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-input" ) == 0 )
+		{
+			rParameters.inputScriptPath = pValue;
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-output" ) == 0 )
+		{
+			rParameters.outputPath = pValue;
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-loadbenchmark" ) == 0 )
+		{
+			rParameters.loadAssetPath = pValue;
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-loadtrace" ) == 0 )
+		{
+			rParameters.loadTracePath = pValue;
+			++argumentIndex;
+		}
+	}
+
+	return rParameters.bEnabled;
+}
+
+/// Prepare for the benchmark frames.
+///
+/// This fixes the world manager time step and makes sure task timing and the frame profiler are enabled.  It must be
+/// called after the world manager has been initialized, and before the first frame is run.
+///
+/// @see End()
+void Benchmark::Begin()
+{
+	WorldManager* pWorldManager = WorldManager::GetInstance();
+	HELIUM_ASSERT( pWorldManager );
+	m_previousFixedFrameDeltaSeconds = pWorldManager->GetFixedFrameDeltaSeconds();
+	pWorldManager->SetFixedFrameDeltaSeconds( m_parameters.frameDeltaSeconds );
+
+	m_bPreviousTaskTimingEnabled = TaskScheduler::IsTaskTimingEnabled();
+	TaskScheduler::SetTaskTimingEnabled( true );
+
+	m_bPreviousFrameProfilerEnabled = FrameProfiler::IsEnabled();
+	FrameProfiler::SetEnabled( true );
+
+	m_frameTicks.Resize( 0 );
+	m_frameTicks.Reserve( m_parameters.frameCount );
+	m_taskTimings.Resize( 0 );
+	m_scopeTimings.Resize( 0 );
+	m_profilerReadTickCount = Timer::GetTickCount();
+	MemoryZero( m_renderCounterTotals, sizeof( m_renderCounterTotals ) );
+	MemoryZero( m_renderCounterMaxima, sizeof( m_renderCounterMaxima ) );
+	m_gpuMillisecondsTotal = 0.0;
+	m_gpuMillisecondsMax = 0.0f;
+	m_frameIndex = 0;
+}
+
+/// Mark the start of a frame.
+///
+/// @see EndFrame()
+void Benchmark::BeginFrame()
+{
+	m_frameStartTickCount = Timer::GetTickCount();
+}
+
+/// Mark the end of a frame, and record its timings if it is not a warmup frame.
+///
+/// @param[in] rSchedule  Task schedule executed during the frame.
+///
+/// @see BeginFrame()
+void Benchmark::EndFrame( const TaskSchedule& rSchedule )
+{
+	uint64_t frameEndTickCount = Timer::GetTickCount();
+	uint64_t frameTicks = frameEndTickCount - m_frameStartTickCount;
+
+	uint32_t frameIndex = m_frameIndex++;
+	bool bMeasured = ( frameIndex >= m_parameters.warmupFrameCount );
+	RecordScopeTimings( frameEndTickCount, bMeasured );
+	if( !bMeasured )
+	{
+		return;
+	}
+
+	m_frameTicks.Push( frameTicks );
+
+	const RenderStatistics::FrameStats& rRenderStats = RenderStatistics::GetLastFrameStats();
+	for( size_t counterIndex = 0; counterIndex < RenderStatistics::COUNTER_MAX; ++counterIndex )
+	{
+		uint64_t value = rRenderStats.totals[ counterIndex ];
+		m_renderCounterTotals[ counterIndex ] += value;
+		m_renderCounterMaxima[ counterIndex ] = Max( m_renderCounterMaxima[ counterIndex ], value );
+	}
+
+	m_gpuMillisecondsTotal += rRenderStats.gpuMilliseconds;
+	m_gpuMillisecondsMax = Max( m_gpuMillisecondsMax, rRenderStats.gpuMilliseconds );
+
+	// Schedules can be recalculated between frames, so tasks are matched by name rather than by index.
+	const DynamicArray< TaskTiming >& rTaskTimings = TaskScheduler::GetTaskTimings();
+	size_t taskCount = Min( rTaskTimings.GetSize(), rSchedule.m_ScheduleInfo.GetSize() );
+	for( size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex )
+	{
+		const char* pName = rSchedule.m_ScheduleInfo[ taskIndex ]->m_Name;
+
+		TaskTiming* pTiming = NULL;
+		size_t timingCount = m_taskTimings.GetSize();
+		for( size_t timingIndex = 0; timingIndex < timingCount; ++timingIndex )
+		{
+			if( m_taskTimings[ timingIndex ].pName == pName )
+			{
+				pTiming = &m_taskTimings[ timingIndex ];
+				break;
+			}
+		}
+
+		if( !pTiming )
+		{
+			pTiming = m_taskTimings.New();
+			HELIUM_ASSERT( pTiming );
+			pTiming->pName = pName;
+			pTiming->totalTicks = 0;
+			pTiming->maxTicks = 0;
+			pTiming->frameCount = 0;
+		}
+
+		uint64_t taskTicks = rTaskTimings[ taskIndex ].m_EndTicks - rTaskTimings[ taskIndex ].m_StartTicks;
+		pTiming->totalTicks += taskTicks;
+		pTiming->maxTicks = Max( pTiming->maxTicks, taskTicks );
+		++pTiming->frameCount;
+	}
+}
+
+/// Restore the settings changed by Begin().
+///
+/// @see Begin()
+void Benchmark::End()
+{
+	TaskScheduler::SetTaskTimingEnabled( m_bPreviousTaskTimingEnabled );
+	FrameProfiler::SetEnabled( m_bPreviousFrameProfilerEnabled );
+
+	WorldManager* pWorldManager = WorldManager::GetInstance();
+	if( pWorldManager )
+	{
+		pWorldManager->SetFixedFrameDeltaSeconds( m_previousFixedFrameDeltaSeconds );
+	}
+}
+
+/// Accumulate the time spent in each frame profiler scope exited since the scopes were last read.
+///
+/// Scopes are read at the end of every frame, warmup frames included, so that each scope is counted in exactly one
+/// frame.  Scopes running on other threads (such as the render thread) may finish after the frame in which they were
+/// started ends, in which case they are counted in the next frame.  Times of all scopes with the same name are summed
+/// per frame, including nested and concurrent ones.
+///
+/// @param[in] endTickCount  Tick count at the end of the frame.
+/// @param[in] bMeasured     True if the frame is measured, false if it is a warmup frame.
+void Benchmark::RecordScopeTimings( uint64_t endTickCount, bool bMeasured )
+{
+	uint64_t startTickCount = m_profilerReadTickCount;
+	m_profilerReadTickCount = endTickCount;
+	if( !bMeasured )
+	{
+		return;
+	}
+
+	FrameProfiler::GetEvents( startTickCount, m_profilerThreads );
+
+	size_t threadCount = m_profilerThreads.GetSize();
+	for( size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex )
+	{
+		const DynamicArray< FrameProfiler::Event >& rEvents = m_profilerThreads[ threadIndex ].events;
+		size_t eventCount = rEvents.GetSize();
+		for( size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex )
+		{
+			// Scopes exited after the end of the frame are left for the next frame.
+			const FrameProfiler::Event& rEvent = rEvents[ eventIndex ];
+			if( rEvent.endTicks >= endTickCount )
+			{
+				break;
+			}
+
+			// The same scope name may be a different string in each module, so names are compared by value as well.
+			ScopeTiming* pTiming = NULL;
+			size_t timingCount = m_scopeTimings.GetSize();
+			for( size_t timingIndex = 0; timingIndex < timingCount; ++timingIndex )
+			{
+				const char* pName = m_scopeTimings[ timingIndex ].pName;
+				if( pName == rEvent.pName || CompareString( pName, rEvent.pName ) == 0 )
+				{
+					pTiming = &m_scopeTimings[ timingIndex ];
+					break;
+				}
+			}
+
+			if( !pTiming )
+			{
+				pTiming = m_scopeTimings.New();
+				HELIUM_ASSERT( pTiming );
+				pTiming->pName = rEvent.pName;
+				pTiming->totalTicks = 0;
+				pTiming->maxTicks = 0;
+				pTiming->frameTicks = 0;
+				pTiming->totalCount = 0;
+			}
+
+			pTiming->frameTicks += rEvent.endTicks - rEvent.startTicks;
+			++pTiming->totalCount;
+		}
+	}
+
+	size_t timingCount = m_scopeTimings.GetSize();
+	for( size_t timingIndex = 0; timingIndex < timingCount; ++timingIndex )
+	{
+		ScopeTiming& rTiming = m_scopeTimings[ timingIndex ];
+		rTiming.totalTicks += rTiming.frameTicks;
+		rTiming.maxTicks = Max( rTiming.maxTicks, rTiming.frameTicks );
+		rTiming.frameTicks = 0;
+	}
+}
+
+/// Write the benchmark results to the output file as JSON.
+///
+/// Results include frame time statistics and percentiles, the average and longest time of each task, the average and
+/// longest time per frame and the average number of calls per frame of each frame profiler scope, the average and
+/// highest value of each render statistics counter and of the GPU time per frame, and the live and peak bytes of each
+/// memory telemetry tracker.  All times are in milliseconds.
+///
+/// @return  True if the results were written successfully, false if not.
+bool Benchmark::WriteResults() const
+{
+	size_t frameCount = m_frameTicks.GetSize();
+	if( frameCount == 0 )
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "Benchmark::WriteResults(): No frames were measured.\n" );
+
+		return false;
+	}
+
+	const char* pOutputPath = *m_parameters.outputPath;
+	FileStream* pFileStream = FileStream::OpenFileStream( pOutputPath, FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"Benchmark::WriteResults(): Failed to open \"%s\" for writing.\n",
+			pOutputPath );
+
+		return false;
+	}
+
+	DynamicArray< uint64_t > sortedFrameTicks( m_frameTicks );
+	std::sort( sortedFrameTicks.GetData(), sortedFrameTicks.GetData() + frameCount );
+
+	uint64_t totalFrameTicks = 0;
+	for( size_t frameIndex = 0; frameIndex < frameCount; ++frameIndex )
+	{
+		totalFrameTicks += sortedFrameTicks[ frameIndex ];
+	}
+
+	DynamicArray< MemoryTelemetry::Stats > memoryStats;
+	MemoryTelemetry::GetStats( memoryStats );
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+
+		char buffer[ 256 ];
+
+		StringPrint(
+			buffer,
+			"{\n\"frameCount\":%" PRIuSZ ",\n\"warmupFrameCount\":%" PRIu32 ",\n\"seed\":%" PRIu32
+			",\n\"frameDeltaSeconds\":%.6f,\n",
+			frameCount,
+			m_parameters.warmupFrameCount,
+			m_parameters.seed,
+			m_parameters.frameDeltaSeconds );
+		buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+		WriteString( bufferedStream, buffer );
+
+		StringPrint(
+			buffer,
+			"\"frameTime\":{\"min\":%.4f,\"mean\":%.4f,\"p50\":%.4f,\"p90\":%.4f,\"p95\":%.4f,\"p99\":%.4f,\"max\":%.4f},\n",
+			TicksToMilliseconds( sortedFrameTicks[ 0 ] ),
+			TicksToMilliseconds( totalFrameTicks ) / static_cast< float64_t >( frameCount ),
+			TicksToMilliseconds( GetPercentile( sortedFrameTicks, 50 ) ),
+			TicksToMilliseconds( GetPercentile( sortedFrameTicks, 90 ) ),
+			TicksToMilliseconds( GetPercentile( sortedFrameTicks, 95 ) ),
+			TicksToMilliseconds( GetPercentile( sortedFrameTicks, 99 ) ),
+			TicksToMilliseconds( sortedFrameTicks[ frameCount - 1 ] ) );
+		buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+		WriteString( bufferedStream, buffer );
+
+		WriteString( bufferedStream, "\"tasks\":[" );
+
+		size_t timingCount = m_taskTimings.GetSize();
+		for( size_t timingIndex = 0; timingIndex < timingCount; ++timingIndex )
+		{
+			const TaskTiming& rTiming = m_taskTimings[ timingIndex ];
+			HELIUM_ASSERT( rTiming.frameCount != 0 );
+
+			WriteString( bufferedStream, ( timingIndex == 0 ? "\n{\"name\":" : ",\n{\"name\":" ) );
+			WriteJsonString( bufferedStream, rTiming.pName ? rTiming.pName : "" );
+
+			StringPrint(
+				buffer,
+				",\"frames\":%" PRIu32 ",\"mean\":%.4f,\"max\":%.4f}",
+				rTiming.frameCount,
+				TicksToMilliseconds( rTiming.totalTicks ) / static_cast< float64_t >( rTiming.frameCount ),
+				TicksToMilliseconds( rTiming.maxTicks ) );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+		}
+
+		WriteString( bufferedStream, "\n],\n\"scopes\":[" );
+
+		size_t scopeTimingCount = m_scopeTimings.GetSize();
+		for( size_t timingIndex = 0; timingIndex < scopeTimingCount; ++timingIndex )
+		{
+			const ScopeTiming& rTiming = m_scopeTimings[ timingIndex ];
+
+			WriteString( bufferedStream, ( timingIndex == 0 ? "\n{\"name\":" : ",\n{\"name\":" ) );
+			WriteJsonString( bufferedStream, rTiming.pName ? rTiming.pName : "" );
+
+			StringPrint(
+				buffer,
+				",\"callsPerFrame\":%.2f,\"mean\":%.4f,\"max\":%.4f}",
+				static_cast< float64_t >( rTiming.totalCount ) / static_cast< float64_t >( frameCount ),
+				TicksToMilliseconds( rTiming.totalTicks ) / static_cast< float64_t >( frameCount ),
+				TicksToMilliseconds( rTiming.maxTicks ) );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+		}
+
+		WriteString( bufferedStream, "\n],\n\"render\":{" );
+
+		for( size_t counterIndex = 0; counterIndex < RenderStatistics::COUNTER_MAX; ++counterIndex )
+		{
+			WriteString( bufferedStream, ( counterIndex == 0 ? "\n" : ",\n" ) );
+			WriteJsonString(
+				bufferedStream,
+				RenderStatistics::GetCounterName( static_cast< RenderStatistics::ECounter >( counterIndex ) ) );
+
+			float64_t mean =
+				static_cast< float64_t >( m_renderCounterTotals[ counterIndex ] ) / static_cast< float64_t >( frameCount );
+
+			StringPrint(
+				buffer,
+				":{\"mean\":%.2f,\"max\":%" PRIu64 "}",
+				mean,
+				m_renderCounterMaxima[ counterIndex ] );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+		}
+
+		// GPU times are only measured if the renderer supports timer queries, and are zero otherwise.
+		StringPrint(
+			buffer,
+			",\n\"gpuMilliseconds\":{\"mean\":%.3f,\"max\":%.3f}",
+			m_gpuMillisecondsTotal / static_cast< float64_t >( frameCount ),
+			static_cast< float64_t >( m_gpuMillisecondsMax ) );
+		buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+		WriteString( bufferedStream, buffer );
+
+		WriteString( bufferedStream, "\n},\n\"memory\":[" );
+
+		size_t statsCount = memoryStats.GetSize();
+		for( size_t statsIndex = 0; statsIndex < statsCount; ++statsIndex )
+		{
+			const MemoryTelemetry::Stats& rStats = memoryStats[ statsIndex ];
+
+			WriteString( bufferedStream, ( statsIndex == 0 ? "\n{\"category\":" : ",\n{\"category\":" ) );
+			WriteJsonString( bufferedStream, MemoryTelemetry::GetCategoryName( rStats.category ) );
+			WriteString( bufferedStream, ",\"name\":" );
+			WriteJsonString( bufferedStream, *rStats.name );
+
+			StringPrint(
+				buffer,
+				",\"liveBytes\":%" PRIu64 ",\"peakBytes\":%" PRIu64 "}",
+				rStats.liveBytes,
+				rStats.peakBytes );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+		}
+
+		WriteString( bufferedStream, "\n]\n}\n" );
+	}
+
+	delete pFileStream;
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"Benchmark::WriteResults(): Wrote results of %" PRIuSZ " frames to \"%s\".\n",
+		frameCount,
+		pOutputPath );
+
+	return true;
+}
+
+/// Load the asset of a load benchmark, and write the load results and trace.
+///
+/// The asset and everything it references are loaded through the asset loader with load stage recording enabled.
+/// The results file holds the total load time and whether the load succeeded, and the trace file holds the time
+/// spent in each load stage per asset type along with a waterfall of every asset load (see
+/// AssetLoadTrace::WriteReport()).
+///
+/// @return  True if the asset was loaded and the results were written successfully, false if not.
+///
+/// @see IsLoadBenchmark()
+bool Benchmark::RunLoad()
+{
+	HELIUM_ASSERT( IsLoadBenchmark() );
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+
+	AssetPath assetPath;
+	if( !assetPath.Set( m_parameters.loadAssetPath ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"Benchmark::RunLoad(): \"%s\" is not a valid asset path.\n",
+			*m_parameters.loadAssetPath );
+
+		return false;
+	}
+
+	AssetLoadTrace::Clear();
+	AssetLoadTrace::SetEnabled( true );
+
+	uint64_t startTickCount = Timer::GetTickCount();
+
+	AssetPtr spAsset;
+	pAssetLoader->LoadObject( assetPath, spAsset );
+	bool bLoaded = ( spAsset && !spAsset->GetAnyFlagSet( Asset::FLAG_BROKEN ) );
+
+	uint64_t loadTicks = Timer::GetTickCount() - startTickCount;
+
+	AssetLoadTrace::SetEnabled( false );
+
+	if( !bLoaded )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "Benchmark::RunLoad(): Failed to load \"%s\".\n", *assetPath.ToString() );
+	}
+
+	DynamicArray< AssetLoadTrace::Event > events;
+	AssetLoadTrace::GetEvents( events );
+
+	bool bTraceWritten = AssetLoadTrace::WriteReport( FilePath( *m_parameters.loadTracePath ) );
+
+	const char* pOutputPath = *m_parameters.outputPath;
+	FileStream* pFileStream = FileStream::OpenFileStream( pOutputPath, FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"Benchmark::RunLoad(): Failed to open \"%s\" for writing.\n",
+			pOutputPath );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+
+		char buffer[ 256 ];
+
+		WriteString( bufferedStream, "{\n\"asset\":" );
+		WriteJsonString( bufferedStream, *assetPath.ToString() );
+#if HELIUM_TOOLS
+		WriteString( bufferedStream, ",\n\"source\":\"loose\"" );
+#else
+		WriteString( bufferedStream, ",\n\"source\":\"cache\"" );
+#endif
+		WriteString( bufferedStream, ",\n\"trace\":" );
+		WriteJsonString( bufferedStream, *m_parameters.loadTracePath );
+
+		StringPrint(
+			buffer,
+			",\n\"pageCacheFlushed\":%s,\n\"loaded\":%s,\n\"loadMs\":%.4f,\n\"stageEvents\":%" PRIuSZ "\n}\n",
+			( m_parameters.bFlushPageCache ? "true" : "false" ),
+			( bLoaded ? "true" : "false" ),
+			TicksToMilliseconds( loadTicks ),
+			events.GetSize() );
+		buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+		WriteString( bufferedStream, buffer );
+	}
+
+	delete pFileStream;
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"Benchmark::RunLoad(): Loaded \"%s\" in %.3f ms.\n",
+		*assetPath.ToString(),
+		TicksToMilliseconds( loadTicks ) );
+
+	return bLoaded && bTraceWritten;
+}
+
+/// Evict every file in a directory and its subdirectories from the OS page cache.
+///
+/// This is supported on Windows and Linux only.  Files mapped or opened by another process may stay cached.
+///
+/// @param[in] rDirectory  Directory to flush.
+///
+/// @return  True if every file was evicted, false if any could not be (or if eviction is not supported).
+bool Benchmark::FlushPageCache( const FilePath& rDirectory )
+{
+	std::set< FilePath > files;
+	DirectoryIterator::GetFiles( rDirectory, files, true );
+
+	size_t evictedCount = 0;
+	for( std::set< FilePath >::const_iterator fileIterator = files.begin(); fileIterator != files.end(); ++fileIterator )
+	{
+		if( EvictFileFromPageCache( *fileIterator ) )
+		{
+			++evictedCount;
+		}
+	}
+
+	if( evictedCount != files.size() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"Benchmark::FlushPageCache(): Evicted %" PRIuSZ " of %" PRIuSZ " files in \"%s\" from the page cache.\n",
+			evictedCount,
+			files.size(),
+			rDirectory.Data() );
+
+		return false;
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"Benchmark::FlushPageCache(): Evicted %" PRIuSZ " files in \"%s\" from the page cache.\n",
+		evictedCount,
+		rDirectory.Data() );
+
+	return true;
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Framework/Framework.h"
+
+#include "Platform/Utility.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/String.h"
+#include "Engine/FrameProfiler.h"
+#include "Engine/RenderStatistics.h"
+
+namespace Helium
+{
+	struct TaskSchedule;
+
+	/// Settings for a benchmark run.
+	struct HELIUM_FRAMEWORK_API BenchmarkParameters
+	{
+		/// Default number of frames measured.
+		static const uint32_t DEFAULT_FRAME_COUNT = 1000;
+		/// Default number of frames run before measuring starts.
+		static const uint32_t DEFAULT_WARMUP_FRAME_COUNT = 30;
+
+		/// True if the application should run the benchmark instead of its regular loop.
+		bool bEnabled;
+		/// True to create a null renderer instead of the regular renderer.
+		bool bNullRenderer;
+		/// Number of frames measured.
+		uint32_t frameCount;
+		/// Number of frames run before measuring starts (not included in the results).
+		uint32_t warmupFrameCount;
+		/// Random number generator seed.
+		uint32_t seed;
+		/// Fixed time step of each frame, in seconds, or zero to follow the actual time elapsed.
+		float32_t frameDeltaSeconds;
+		/// Input script played back in place of the input devices, or empty to use the devices.
+		String inputScriptPath;
+		/// Path of the JSON results file.
+		String outputPath;
+
+		/// Asset to load for a load benchmark (run instead of the frame benchmark), or empty to run frames.
+		String loadAssetPath;
+		/// Path of the load trace file written by a load benchmark.
+		String loadTracePath;
+		/// True to evict the data files from the OS page cache before a load benchmark, to measure a cold start.
+		bool bFlushPageCache;
+
+		/// @name Construction/Destruction
+		//@{
+		BenchmarkParameters();
+		//@}
+	};
+
+	/// Fixed-length, repeatable application run that records frame times, task times, frame profiler scope times,
+	/// render statistics, and memory high-water marks.
+	///
+	/// A benchmark seeds the random number generator, fixes the frame time step, and times every scheduled task and
+	/// every frame profiler scope (such as GraphicsScene::Update, scene view culling, and render queue sorting) for a set
+	/// number of frames.  Results are written as JSON so that runs can be compared automatically.  Run with the null
+	/// renderer, this measures the CPU cost of building and submitting each frame, along with the draws and state
+	/// changes it submits, without depending on a GPU.
+	///
+	/// A load benchmark instead measures loading a single asset (usually a SceneDefinition) along with everything it
+	/// references, recording the time each asset spends in each load stage with AssetLoadTrace.  Whether assets are
+	/// loaded from loose files or from the cache depends on the build (tool builds load loose files), and cold starts
+	/// are measured by evicting the data files from the OS page cache first.
+	///
+	/// @see GameSystem::RunBenchmark()
+	class HELIUM_FRAMEWORK_API Benchmark : NonCopyable
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		explicit Benchmark( const BenchmarkParameters& rParameters );
+		//@}
+
+		/// @name Configuration
+		//@{
+		static bool ParseCommandLine( int argc, const char* const* argv, BenchmarkParameters& rParameters );
+		inline const BenchmarkParameters& GetParameters() const;
+		//@}
+
+		/// @name Measurement
+		//@{
+		void Begin();
+		void BeginFrame();
+		void EndFrame( const TaskSchedule& rSchedule );
+		void End();
+
+		inline bool IsComplete() const;
+		//@}
+
+		/// @name Load Measurement
+		//@{
+		inline bool IsLoadBenchmark() const;
+		bool RunLoad();
+
+		static bool FlushPageCache( const FilePath& rDirectory );
+		//@}
+
+		/// @name Results
+		//@{
+		bool WriteResults() const;
+		//@}
+
+	private:
+		/// Accumulated timing of a single task.
+		struct TaskTiming
+		{
+			/// Task name (static string).
+			const char* pName;
+			/// Total ticks spent in the task over all measured frames.
+			uint64_t totalTicks;
+			/// Most ticks spent in the task in a single frame.
+			uint64_t maxTicks;
+			/// Number of measured frames in which the task ran.
+			uint32_t frameCount;
+		};
+
+		/// Accumulated timing of a frame profiler scope.
+		struct ScopeTiming
+		{
+			/// Scope name (static string).
+			const char* pName;
+			/// Total ticks spent in the scope over all measured frames.
+			uint64_t totalTicks;
+			/// Most ticks spent in the scope in a single frame.
+			uint64_t maxTicks;
+			/// Ticks spent in the scope during the current frame.
+			uint64_t frameTicks;
+			/// Number of times the scope was exited over all measured frames.
+			uint64_t totalCount;
+		};
+
+		/// Benchmark settings.
+		BenchmarkParameters m_parameters;
+
+		/// Ticks taken by each measured frame.
+		DynamicArray< uint64_t > m_frameTicks;
+		/// Timing of each task run during the measured frames.
+		DynamicArray< TaskTiming > m_taskTimings;
+		/// Timing of each frame profiler scope exited during the measured frames.
+		DynamicArray< ScopeTiming > m_scopeTimings;
+		/// Frame profiler scopes read at the end of the last frame (kept to reuse their memory).
+		DynamicArray< FrameProfiler::ThreadEvents > m_profilerThreads;
+		/// Render statistics counter totals over all measured frames.
+		uint64_t m_renderCounterTotals[ RenderStatistics::COUNTER_MAX ];
+		/// Highest render statistics counter values in a single measured frame.
+		uint64_t m_renderCounterMaxima[ RenderStatistics::COUNTER_MAX ];
+		/// Total GPU milliseconds over all measured frames (as reported in the render statistics of each frame).
+		float64_t m_gpuMillisecondsTotal;
+		/// Most GPU milliseconds reported in a single measured frame.
+		float32_t m_gpuMillisecondsMax;
+
+		/// Tick count at the start of the current frame.
+		uint64_t m_frameStartTickCount;
+		/// Tick count at which frame profiler scopes were last read.
+		uint64_t m_profilerReadTickCount;
+		/// Number of frames run so far, including warmup frames.
+		uint32_t m_frameIndex;
+
+		/// World manager fixed time step before Begin() was called.
+		float32_t m_previousFixedFrameDeltaSeconds;
+		/// True if task timing was enabled before Begin() was called.
+		bool m_bPreviousTaskTimingEnabled;
+		/// True if the frame profiler was enabled before Begin() was called.
+		bool m_bPreviousFrameProfilerEnabled;
+
+		/// @name Private Utility Functions
+		//@{
+		void RecordScopeTimings( uint64_t endTickCount, bool bMeasured );
+		//@}
+	};
+}
+
+#include "Framework/Benchmark.inl"
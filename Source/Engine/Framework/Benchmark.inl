@@ -0,0 +1,28 @@
+namespace Helium
+{
+	/// Get the settings of this benchmark.
+	///
+	/// @return  Benchmark settings.
+	const BenchmarkParameters& Benchmark::GetParameters() const
+	{
+		return m_parameters;
+	}
+
+	/// Get whether this benchmark measures an asset load instead of running frames.
+	///
+	/// @return  True if this is a load benchmark, false if not.
+	///
+	/// @see RunLoad()
+	bool Benchmark::IsLoadBenchmark() const
+	{
+		return !m_parameters.loadAssetPath.IsEmpty();
+	}
+
+	/// Get whether all warmup and measured frames have run.
+	///
+	/// @return  True if the benchmark is complete, false if not.
+	bool Benchmark::IsComplete() const
+	{
+		return m_frameIndex >= m_parameters.warmupFrameCount + m_parameters.frameCount;
+	}
+}
@@ -21,6 +21,10 @@ namespace Helium
 		// Allocates a component. Initialization is not complete without calling FinalizeComponent()
 		inline Helium::Component *CreateComponent(struct Components::IHasComponents &target) const;
 
+		// Allocates a component of the given type by copying an image captured from a component this definition created
+		// earlier (see Prefab). Initialization is not complete without calling FinalizeComponent()
+		inline Helium::Component *CreateComponentFromImage(struct Components::IHasComponents &target, Components::TypeId type, const void *pImage) const;
+
 		// Implemented by child classes to allocate a component of the appropriate type and return it
 		inline virtual Helium::Component *CreateComponentInternal(struct Components::IHasComponents &rHasComponents) const;
 
@@ -30,6 +34,10 @@ namespace Helium
 		// Gets the component that this definition generated previously
 		inline Helium::Component *GetCreatedComponent() const;
 
+		// Points the definition back at a component it created earlier, so that a FinalizeComponent() that was held
+		// back (see Prefab::Deploy()) finishes the right component
+		inline void SetCreatedComponent(Helium::Component *pComponent) const;
+
 		void Clear() const { m_Instance.Reset(NULL); }
 
 	private:
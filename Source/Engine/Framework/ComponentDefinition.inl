@@ -7,6 +7,13 @@ namespace Helium
         return m_Instance.Get();
     }
 
+    Helium::Component *ComponentDefinition::CreateComponentFromImage(struct Components::IHasComponents &rHasComponents, Components::TypeId type, const void *pImage) const
+    {
+        HELIUM_ASSERT(pImage);
+        m_Instance.Reset(rHasComponents.VirtualGetComponentManager()->Allocate(type, &rHasComponents, rHasComponents.VirtualGetComponents(), pImage));
+        return m_Instance.Get();
+    }
+
     Helium::Component *ComponentDefinition::CreateComponentInternal(struct Components::IHasComponents &rHasComponents) const 
     { 
         HELIUM_ASSERT(0); 
@@ -21,4 +28,9 @@ namespace Helium
     { 
         return m_Instance.Get(); 
     }
+
+    void ComponentDefinition::SetCreatedComponent(Helium::Component *pComponent) const
+    {
+        m_Instance.Reset(pComponent);
+    }
 }
@@ -1,8 +1,11 @@
 
 #include "Precompile.h"
 #include "Framework/ComponentQuery.h"
+#include "Framework/TaskScheduler.h"
+#include "Engine/FrameArena.h"
+#include "EngineJobs/JobManager.h"
+#include <algorithm>
 #include <limits>
-#include <vector>
 
 using namespace Helium;
 
@@ -14,12 +17,16 @@ struct FoundComponentList
 	Components::TypeId m_TypeId;
 };
 
+// Query scratch data only lives for the duration of the query, so it comes from the frame arena
+typedef DynamicArray<FoundComponentList, FrameAllocator> FoundComponentLists;
+
 bool SortFoundComponentList(const FoundComponentList &lhs, const FoundComponentList &rhs)
 {
 	return lhs.m_Count < rhs.m_Count;
 }
 
-void EmitTuples(DynamicArray<Component *> &tuple, std::vector<FoundComponentList> &found_components, size_t type_index, ComponentTupleCallback emit_tuple_callback)
+template <class SinkT>
+void EmitTuples(DynamicArray<Component *> &tuple, FoundComponentLists &found_components, size_t type_index, SinkT &sink)
 {
 	Component *c = found_components[ type_index ].m_Component;
 	HELIUM_ASSERT( c );
@@ -27,19 +34,20 @@ void EmitTuples(DynamicArray<Component *> &tuple, std::vector<FoundComponentList
 	{
 		tuple[found_components[type_index].m_TypeIndex] = c;
 		
-		if (type_index < found_components.size() - 1)
+		if (type_index < found_components.GetSize() - 1)
 		{
-			EmitTuples(tuple, found_components, ++type_index, emit_tuple_callback);
+			EmitTuples(tuple, found_components, type_index + 1, sink);
 		}
 		else
 		{
-			emit_tuple_callback(tuple);
+			sink(tuple);
 		}
 	} 
 	while ( ( c = c->GetNextComponent() ) );
 }
 
-void Helium::QueryComponentsInternal(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback emit_tuple_callback)
+template <class SinkT>
+void QueryTuples(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, SinkT &sink)
 {
 	// If no types to query, do nothing
 	if (!typesCount)
@@ -48,8 +56,8 @@ void Helium::QueryComponentsInternal(ComponentManager &rManager, const Component
 	}
 	
 	// Prepare the structure that will help us emit all permutations of found components
-	std::vector<FoundComponentList> found_components;
-	found_components.resize(typesCount);
+	FoundComponentLists found_components;
+	found_components.Resize(typesCount);
 	
 	// Find the component with the least instances
 	for (size_t index = 0; index < typesCount; ++index)
@@ -66,10 +74,13 @@ void Helium::QueryComponentsInternal(ComponentManager &rManager, const Component
 	}
 
 	// Sort the types by commonality
-	std::sort(found_components.begin(), found_components.end(), SortFoundComponentList);
+	std::sort(found_components.GetData(), found_components.GetData() + found_components.GetSize(), SortFoundComponentList);
 	
 	const DynamicArray< Components::TypeId > &implementing_types = Components::GetTypeData( found_components[0].m_TypeId )->m_ImplementingTypes;
 	
+	DynamicArray<Component *> tuple;
+	tuple.Resize(typesCount);
+
 	// For every component
 	for ( ComponentIteratorBase iterator(rManager, implementing_types); iterator.GetBaseComponent(); iterator.Advance() )
 	{
@@ -82,7 +93,7 @@ void Helium::QueryComponentsInternal(ComponentManager &rManager, const Component
 		
 		// Walk the other types we need components of
 		bool emit_tuples = true;
-		for (size_t type_index = 1; type_index < found_components.size(); ++type_index)
+		for (size_t type_index = 1; type_index < found_components.GetSize(); ++type_index)
 		{
 			found_components[type_index].m_Component = collection->GetFirst( found_components[type_index].m_TypeId );
 			if ( !found_components[type_index].m_Component )
@@ -94,10 +105,388 @@ void Helium::QueryComponentsInternal(ComponentManager &rManager, const Component
 		
 		if (emit_tuples)
 		{
-			DynamicArray<Component *> tuple;
-			tuple.Resize(typesCount);
 			tuple[found_components[0].m_TypeIndex] = outer_component;
-			EmitTuples(tuple, found_components, 1, emit_tuple_callback);
+			if (typesCount > 1)
+			{
+				EmitTuples(tuple, found_components, 1, sink);
+			}
+			else
+			{
+				sink(tuple);
+			}
+		}
+	}
+}
+
+struct CallbackTupleSink
+{
+	ComponentTupleCallback m_Callback;
+
+	void operator()(DynamicArray<Component *> &tuple)
+	{
+		m_Callback(tuple);
+	}
+};
+
+struct GatherTupleSink
+{
+	DynamicArray<Component *, FrameAllocator> m_Tuples;
+
+	void operator()(DynamicArray<Component *> &tuple)
+	{
+		m_Tuples.AddArray(tuple.GetData(), tuple.GetSize());
+	}
+};
+
+// A contiguous run of gathered tuples, emitted by one job
+struct ParallelQueryJob
+{
+	Component * const *m_pTuples;
+	size_t m_TupleCount;
+	size_t m_TypesCount;
+	ComponentTupleCallback m_Callback;
+};
+
+void RunParallelQueryJob(void *pJob)
+{
+	const ParallelQueryJob &rJob = *static_cast<const ParallelQueryJob *>(pJob);
+	bool bPreviousAllowed = TaskScheduler::SetSplitExecutionAllowed(true);
+
+	DynamicArray<Component *> tuple;
+	tuple.Resize(rJob.m_TypesCount);
+	for (size_t tupleIndex = 0; tupleIndex < rJob.m_TupleCount; ++tupleIndex)
+	{
+		Component * const *pTuple = rJob.m_pTuples + tupleIndex * rJob.m_TypesCount;
+		for (size_t type_index = 0; type_index < rJob.m_TypesCount; ++type_index)
+		{
+			tuple[type_index] = pTuple[type_index];
 		}
+
+		rJob.m_Callback(tuple);
 	}
+
+	TaskScheduler::SetSplitExecutionAllowed(bPreviousAllowed);
+}
+
+#if HELIUM_ASSERT_ENABLED
+// Tuple callbacks can't tell which of their components they write, so queried types only need to be declared
+void CheckQueriedComponentAccess(const Components::TypeId *types, size_t typesCount)
+{
+	for (size_t index = 0; index < typesCount; ++index)
+	{
+		TaskScheduler::CheckComponentAccess(types[index], false);
+	}
+}
+#endif
+
+void Helium::QueryComponentsInternal(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback emit_tuple_callback)
+{
+#if HELIUM_ASSERT_ENABLED
+	CheckQueriedComponentAccess(types, typesCount);
+#endif
+
+	CallbackTupleSink sink = { emit_tuple_callback };
+	QueryTuples(rManager, types, typesCount, sink);
+}
+
+void Helium::ParallelQueryComponentsInternal(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback emit_tuple_callback)
+{
+#if HELIUM_ASSERT_ENABLED
+	CheckQueriedComponentAccess(types, typesCount);
+#endif
+
+	JobManager *pJobManager = JobManager::GetInstance();
+	if (!typesCount || !pJobManager || !pJobManager->GetWorkerCount() || !TaskScheduler::IsSplitExecutionAllowed())
+	{
+		QueryComponentsInternal(rManager, types, typesCount, emit_tuple_callback);
+		return;
+	}
+
+	// Tuples are gathered up front so that chunks can be handed out without walking the pools from several threads
+	GatherTupleSink sink;
+	QueryTuples(rManager, types, typesCount, sink);
+
+	const size_t tupleCount = sink.m_Tuples.GetSize() / typesCount;
+	if (tupleCount < 2 * PARALLEL_QUERY_TUPLES_PER_JOB)
+	{
+		ParallelQueryJob job = { sink.m_Tuples.GetData(), tupleCount, typesCount, emit_tuple_callback };
+		RunParallelQueryJob(&job);
+		return;
+	}
+
+	// A few jobs per thread so that workers that finish early can steal the remainder
+	const size_t maxJobCount = 4 * ( pJobManager->GetWorkerCount() + 1 );
+	const size_t jobCount = Min( tupleCount / PARALLEL_QUERY_TUPLES_PER_JOB, maxJobCount );
+	const size_t tuplesPerJob = ( tupleCount + jobCount - 1 ) / jobCount;
+
+	DynamicArray<ParallelQueryJob, FrameAllocator> jobs;
+	jobs.Reserve(jobCount);
+
+	JobCounter counter;
+	for (size_t firstTuple = 0; firstTuple < tupleCount; firstTuple += tuplesPerJob)
+	{
+		ParallelQueryJob *pJob = jobs.New();
+		HELIUM_ASSERT(pJob);
+		pJob->m_pTuples = sink.m_Tuples.GetData() + firstTuple * typesCount;
+		pJob->m_TupleCount = Min( tuplesPerJob, tupleCount - firstTuple );
+		pJob->m_TypesCount = typesCount;
+		pJob->m_Callback = emit_tuple_callback;
+
+		pJobManager->Spawn(RunParallelQueryJob, pJob, counter);
+	}
+
+	pJobManager->WaitForCounter(counter);
+}
+
+ComponentQueryCache::ComponentQueryCache( ComponentManager &rManager, const Components::TypeId *types, size_t typesCount )
+	: m_Manager( rManager )
+	, m_Types( types )
+	, m_TypesCount( typesCount )
+	, m_Built( false )
+	, m_Running( false )
+{
+	HELIUM_ASSERT( types );
+	HELIUM_ASSERT( typesCount );
+}
+
+void ComponentQueryCache::OnComponentAllocated( Component *pComponent )
+{
+	if ( m_Built )
+	{
+		m_AllocatedComponents.Push( pComponent );
+	}
+}
+
+void ComponentQueryCache::OnComponentFreed( Component *pComponent )
+{
+	if ( m_Built )
+	{
+		m_FreedComponents.Push( pComponent );
+	}
+}
+
+void ComponentQueryCache::Run( ComponentTupleCallback callback )
+{
+	HELIUM_ASSERT( !m_Running );
+	Refresh();
+
+	m_Running = true;
+
+	DynamicArray<Component *> tuple;
+	tuple.Resize( m_TypesCount );
+
+	// Callbacks may free components we have yet to visit, so once anything is freed the rest of the walk checks
+	// against it. Allocations are picked up on the next run.
+	const size_t firstFreedIndex = m_FreedComponents.GetSize();
+	const size_t tupleCount = m_TupleCollections.GetSize();
+	for (size_t tupleIndex = 0; tupleIndex < tupleCount; ++tupleIndex)
+	{
+		Component * const *pTuple = m_Tuples.GetData() + tupleIndex * m_TypesCount;
+		if ( m_FreedComponents.GetSize() != firstFreedIndex && WasFreedSince( pTuple, firstFreedIndex ) )
+		{
+			continue;
+		}
+
+		for (size_t type_index = 0; type_index < m_TypesCount; ++type_index)
+		{
+			tuple[type_index] = pTuple[type_index];
+		}
+
+		callback( tuple );
+	}
+
+	m_Running = false;
+}
+
+bool ComponentQueryCache::WasFreedSince( const Component * const *pTuple, size_t firstFreedIndex ) const
+{
+	for (size_t freedIndex = firstFreedIndex; freedIndex < m_FreedComponents.GetSize(); ++freedIndex)
+	{
+		for (size_t type_index = 0; type_index < m_TypesCount; ++type_index)
+		{
+			if ( pTuple[type_index] == m_FreedComponents[freedIndex] )
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void ComponentQueryCache::Refresh()
+{
+	if ( !m_Built )
+	{
+		// First run discovers everything by walking the outer type's pools once
+		const DynamicArray< Components::TypeId > &implementing_types = Components::GetTypeData( m_Types[0] )->m_ImplementingTypes;
+		for ( ComponentIteratorBase iterator(m_Manager, implementing_types); iterator.GetBaseComponent(); iterator.Advance() )
+		{
+			Component *outer_component = iterator.GetBaseComponent();
+			GatherTuplesForOuter( outer_component, outer_component->GetComponentCollection() );
+		}
+
+		m_Built = true;
+		return;
+	}
+
+	if ( m_AllocatedComponents.IsEmpty() && m_FreedComponents.IsEmpty() )
+	{
+		return;
+	}
+
+	// Collections that gained a component are rediscovered completely. A component that has since been freed has no
+	// collection (and its collection may no longer exist), and is handled through the freed list instead.
+	m_DirtyCollections.Resize( 0 );
+	for (DynamicArray<Component *>::ConstIterator iter = m_AllocatedComponents.Begin(); iter != m_AllocatedComponents.End(); ++iter)
+	{
+		ComponentCollection *pCollection = Components::Pool::GetPool( *iter )->GetComponentCollection( *iter );
+		if ( pCollection )
+		{
+			m_DirtyCollections.Push( pCollection );
+		}
+	}
+
+	ComponentCollection **pDirtyBegin = m_DirtyCollections.GetData();
+	ComponentCollection **pDirtyEnd = pDirtyBegin + m_DirtyCollections.GetSize();
+	std::sort( pDirtyBegin, pDirtyEnd );
+	pDirtyEnd = std::unique( pDirtyBegin, pDirtyEnd );
+	m_DirtyCollections.Resize( pDirtyEnd - pDirtyBegin );
+	pDirtyBegin = m_DirtyCollections.GetData();
+	pDirtyEnd = pDirtyBegin + m_DirtyCollections.GetSize();
+
+	Component **pFreedBegin = m_FreedComponents.GetData();
+	Component **pFreedEnd = pFreedBegin + m_FreedComponents.GetSize();
+	std::sort( pFreedBegin, pFreedEnd );
+
+	// Compact away tuples from dirty collections and tuples holding a freed component
+	size_t keptCount = 0;
+	const size_t tupleCount = m_TupleCollections.GetSize();
+	for (size_t tupleIndex = 0; tupleIndex < tupleCount; ++tupleIndex)
+	{
+		if ( std::binary_search( pDirtyBegin, pDirtyEnd, m_TupleCollections[tupleIndex] ) )
+		{
+			continue;
+		}
+
+		Component **pTuple = m_Tuples.GetData() + tupleIndex * m_TypesCount;
+		bool keep = true;
+		for (size_t type_index = 0; type_index < m_TypesCount && keep; ++type_index)
+		{
+			keep = !std::binary_search( pFreedBegin, pFreedEnd, pTuple[type_index] );
+		}
+
+		if ( !keep )
+		{
+			continue;
+		}
+
+		if ( keptCount != tupleIndex )
+		{
+			Component **pKeptTuple = m_Tuples.GetData() + keptCount * m_TypesCount;
+			for (size_t type_index = 0; type_index < m_TypesCount; ++type_index)
+			{
+				pKeptTuple[type_index] = pTuple[type_index];
+			}
+
+			m_TupleCollections[keptCount] = m_TupleCollections[tupleIndex];
+		}
+
+		++keptCount;
+	}
+
+	m_Tuples.Resize( keptCount * m_TypesCount );
+	m_TupleCollections.Resize( keptCount );
+
+	for (DynamicArray<ComponentCollection *>::ConstIterator iter = m_DirtyCollections.Begin(); iter != m_DirtyCollections.End(); ++iter)
+	{
+		GatherCollection( *iter );
+	}
+
+	m_AllocatedComponents.Resize( 0 );
+	m_FreedComponents.Resize( 0 );
+}
+
+void ComponentQueryCache::GatherCollection( ComponentCollection *pCollection )
+{
+	HELIUM_ASSERT( pCollection );
+
+	// Gather into the candidate scratch first; GatherTuplesForOuter reuses it from the offset onward
+	const size_t outerStart = m_Candidates.GetSize();
+	pCollection->GetAllThatImplement( m_Types[0], m_Candidates );
+	const size_t outerEnd = m_Candidates.GetSize();
+
+	for (size_t outerIndex = outerStart; outerIndex < outerEnd; ++outerIndex)
+	{
+		GatherTuplesForOuter( m_Candidates[outerIndex], pCollection );
+	}
+
+	m_Candidates.Resize( outerStart );
+}
+
+void ComponentQueryCache::GatherTuplesForOuter( Component *pOuterComponent, ComponentCollection *pCollection )
+{
+	HELIUM_ASSERT( pOuterComponent );
+	HELIUM_ASSERT( pCollection );
+
+	// Gather the candidates for every other slot from the collection
+	const size_t candidatesStart = m_Candidates.GetSize();
+	m_CandidateOffsets.Resize( m_TypesCount + 1 );
+	m_CandidateOffsets[0] = candidatesStart;
+	m_Candidates.Push( pOuterComponent );
+	for (size_t type_index = 1; type_index < m_TypesCount; ++type_index)
+	{
+		m_CandidateOffsets[type_index] = m_Candidates.GetSize();
+		pCollection->GetAllThatImplement( m_Types[type_index], m_Candidates );
+		if ( m_Candidates.GetSize() == m_CandidateOffsets[type_index] )
+		{
+			m_Candidates.Resize( candidatesStart );
+			return;
+		}
+	}
+
+	m_CandidateOffsets[m_TypesCount] = m_Candidates.GetSize();
+
+	// Emit every combination of candidates
+	m_CandidateCursor.Resize( m_TypesCount );
+	for (size_t type_index = 0; type_index < m_TypesCount; ++type_index)
+	{
+		m_CandidateCursor[type_index] = m_CandidateOffsets[type_index];
+	}
+
+	for (;;)
+	{
+		for (size_t type_index = 0; type_index < m_TypesCount; ++type_index)
+		{
+			m_Tuples.Push( m_Candidates[ m_CandidateCursor[type_index] ] );
+		}
+
+		m_TupleCollections.Push( pCollection );
+
+		// Advance over slots 1..n-1 like an odometer; slot 0 is always the outer component
+		size_t type_index = m_TypesCount - 1;
+		while ( type_index > 0 && ++m_CandidateCursor[type_index] == m_CandidateOffsets[type_index + 1] )
+		{
+			m_CandidateCursor[type_index] = m_CandidateOffsets[type_index];
+			--type_index;
+		}
+
+		if ( type_index == 0 )
+		{
+			break;
+		}
+	}
+
+	m_Candidates.Resize( candidatesStart );
+}
+
+void Helium::QueryComponentsCached(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback callback)
+{
+#if HELIUM_ASSERT_ENABLED
+	CheckQueriedComponentAccess(types, typesCount);
+#endif
+
+	ComponentQueryCache *pCache = rManager.GetQueryCache( types, typesCount );
+	HELIUM_ASSERT( pCache );
+	pCache->Run( callback );
 }
@@ -4,12 +4,78 @@
 #include "Framework/Framework.h"
 #include "Foundation/DynamicArray.h"
 #include "Framework/Components.h"
+#include "Framework/TaskScheduler.h"
+
+#include <type_traits>
 
 namespace Helium
 {
 	typedef void (*ComponentTupleCallback)(DynamicArray<Component *> &tuple);
 	
 	void HELIUM_FRAMEWORK_API QueryComponentsInternal(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback callback);
+
+	// Minimum number of tuples handed to each job by ParallelQueryComponentsInternal
+	const static size_t PARALLEL_QUERY_TUPLES_PER_JOB = 64;
+
+	// Gathers all tuples first, then emits them from jobs in chunks. Falls back to QueryComponentsInternal if the
+	// running task did not declare DisjointComponentWrites() or there are too few tuples to be worth splitting
+	void HELIUM_FRAMEWORK_API ParallelQueryComponentsInternal(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback callback);
+
+	// Persistent query over a component manager. Matching tuples are kept packed between runs and only the
+	// collections whose membership changed (through Pool::Allocate/Free) are rediscovered, so running the query is
+	// a linear walk. Every queried slot matches components of any type implementing the queried type
+	class HELIUM_FRAMEWORK_API ComponentQueryCache
+	{
+	public:
+		ComponentQueryCache( ComponentManager &rManager, const Components::TypeId *types, size_t typesCount );
+
+		void Run( ComponentTupleCallback callback );
+
+		const Components::TypeId *GetTypes() const { return m_Types; }
+		size_t GetTypesCount() const { return m_TypesCount; }
+		size_t GetTupleCount() const { return m_TupleCollections.GetSize(); }
+
+		void OnComponentAllocated( Component *pComponent );
+		void OnComponentFreed( Component *pComponent );
+
+		// Bring the cached tuples up to date with membership changes. Run() does this automatically
+		void Refresh();
+
+	private:
+		void GatherCollection( ComponentCollection *pCollection );
+		void GatherTuplesForOuter( Component *pOuterComponent, ComponentCollection *pCollection );
+		bool WasFreedSince( const Component * const *pTuple, size_t firstFreedIndex ) const;
+
+		ComponentManager &m_Manager;
+		const Components::TypeId *m_Types;
+		size_t m_TypesCount;
+
+		// m_TypesCount components per tuple, and the collection each tuple came from
+		DynamicArray<Component *> m_Tuples;
+		DynamicArray<ComponentCollection *> m_TupleCollections;
+
+		// Membership changes since the last refresh
+		DynamicArray<Component *> m_AllocatedComponents;
+		DynamicArray<Component *> m_FreedComponents;
+
+		// Scratch space reused between refreshes
+		DynamicArray<ComponentCollection *> m_DirtyCollections;
+		DynamicArray<Component *> m_Candidates;
+		DynamicArray<size_t> m_CandidateOffsets;
+		DynamicArray<size_t> m_CandidateCursor;
+
+		bool m_Built;
+		bool m_Running;
+	};
+
+	void HELIUM_FRAMEWORK_API QueryComponentsCached(ComponentManager &rManager, const Components::TypeId *types, size_t typesCount, ComponentTupleCallback callback);
+
+	template <class A, void (*F)(A *)>
+	void TupleHandler(DynamicArray<Component *> &components)
+	{
+		F(
+			static_cast<A *>(components[0]));
+	}
 	
 	template <class A, class B, void (*F)(A *, B *)>
 	void TupleHandler(DynamicArray<Component *> &components)
@@ -27,4 +93,94 @@ namespace Helium
 			static_cast<B *>(components[1]), 
 			static_cast<C *>(components[2]));
 	}
+
+	namespace ComponentQueryDetail
+	{
+		// Emits every combination of components of the remaining types in a collection, one type per level. Typed
+		// pointers found so far are carried as arguments, so the functor is called directly with no tuple storage.
+		// The slot at outerIndex is pinned to the outer component being walked instead of its collection chain
+		template <class... Ts>
+		struct TupleEmitter;
+
+		template <>
+		struct TupleEmitter<>
+		{
+			template <class FunctorT, class... FoundTs>
+			static void Emit( ComponentCollection &, Component *, size_t, size_t, FunctorT &rFunctor, FoundTs *... pFound )
+			{
+				rFunctor( pFound... );
+			}
+		};
+
+		template <class T, class... RestTs>
+		struct TupleEmitter<T, RestTs...>
+		{
+			template <class FunctorT, class... FoundTs>
+			static void Emit( ComponentCollection &rCollection, Component *pOuter, size_t outerIndex, size_t index, FunctorT &rFunctor, FoundTs *... pFound )
+			{
+				if ( index == outerIndex )
+				{
+					TupleEmitter<RestTs...>::Emit( rCollection, pOuter, outerIndex, index + 1, rFunctor, pFound..., static_cast<T *>( pOuter ) );
+					return;
+				}
+
+				for ( T *pComponent = rCollection.GetFirst<T>(); pComponent; pComponent = static_cast<T *>( pComponent->GetNextComponent() ) )
+				{
+					TupleEmitter<RestTs...>::Emit( rCollection, pOuter, outerIndex, index + 1, rFunctor, pFound..., pComponent );
+				}
+			}
+		};
+	}
+
+	// Calls functor with typed pointers for every tuple of components (one of each type in Ts) sharing a collection,
+	// the same tuples QueryComponentsInternal emits. The type with the fewest instances is walked in its pools, and
+	// the rest are found through each of its collections. Nothing is allocated per tuple and the functor is called
+	// directly, so lambdas and functors with state inline. Returns the functor so that state it gathered is kept.
+	// Types may be const qualified, which declares them read only to the task access checks
+	template <class... Ts, class FunctorT>
+	FunctorT QueryComponents( ComponentManager &rManager, FunctorT functor )
+	{
+		static const Components::TypeId types[] = { Components::GetType<Ts>()... };
+		const size_t typesCount = sizeof...( Ts );
+		HELIUM_COMPILE_ASSERT( sizeof...( Ts ) > 0 );
+
+#if HELIUM_ASSERT_ENABLED
+		// Types queried as const are only read
+		static const bool writes[] = { !std::is_const<Ts>::value... };
+		for ( size_t index = 0; index < typesCount; ++index )
+		{
+			TaskScheduler::CheckComponentAccess( types[ index ], writes[ index ] );
+		}
+#endif
+
+		// Walk the rarest type, and bail if any type has no instances at all
+		size_t outerIndex = 0;
+		size_t outerCount = 0;
+		for ( size_t index = 0; index < typesCount; ++index )
+		{
+			const size_t count = rManager.CountAllocatedComponentsThatImplement( types[ index ] );
+			if ( !count )
+			{
+				return functor;
+			}
+
+			if ( !index || count < outerCount )
+			{
+				outerIndex = index;
+				outerCount = count;
+			}
+		}
+
+		const DynamicArray< Components::TypeId > &implementingTypes = Components::GetTypeData( types[ outerIndex ] )->m_ImplementingTypes;
+		for ( ComponentIteratorBase iterator( rManager, implementingTypes ); iterator.GetBaseComponent(); iterator.Advance() )
+		{
+			Component *pOuter = iterator.GetBaseComponent();
+			ComponentCollection *pCollection = pOuter->GetComponentCollection();
+			HELIUM_ASSERT( pCollection );
+
+			ComponentQueryDetail::TupleEmitter<Ts...>::Emit( *pCollection, pOuter, outerIndex, 0, functor );
+		}
+
+		return functor;
+	}
 }
@@ -39,6 +39,7 @@ namespace Helium
 			Components::IHasComponents &rHasComponents, 
 			const Helium::ComponentSet &components, 
 			const ParameterSet *parameters);
+		friend class Prefab;
 
 	private:
 
@@ -1,11 +1,13 @@
 
 #include "Precompile.h"
 #include "Framework/Components.h"
+#include "Framework/ComponentQuery.h"
 #include "Framework/SystemDefinition.h"
 
 #include "Foundation/Numeric.h"
 #include "Reflect/TranslatorDeduction.h"
 #include "Engine/Asset.h"
+#include "Engine/MemoryTelemetry.h"
 
 HELIUM_DEFINE_BASE_STRUCT(Helium::Component);
 
@@ -78,6 +80,8 @@ void Components::Shutdown()
 			data->m_DefaultCount = 0;
 			data->m_ImplementedTypes.Clear();
 			data->m_ImplementingTypes.Clear();
+			data->m_Streams.m_ElementSizes.Clear();
+			data->m_CachedSlot = COLLECTION_CACHED_SLOT_COUNT;
 			data->m_Structure = NULL;
 			data->m_TypeId = Invalid<TypeId>();
 		}
@@ -109,6 +113,19 @@ TypeId Components::RegisterType(
 	rTypeData.m_TypeId = type_id;
 	rTypeData.m_Name = Name( pStructure->m_Name );
 
+#if HELIUM_ASSERT_ENABLED
+	// Fixed collection slots are assigned by hand across modules, so catch two types claiming the same one
+	if ( rTypeData.m_CachedSlot < COLLECTION_CACHED_SLOT_COUNT )
+	{
+		for (DynamicArray<TypeData *>::Iterator iter = g_ComponentTypes.Begin(); iter != g_ComponentTypes.End(); ++iter)
+		{
+			HELIUM_ASSERT_MSG( *iter == &rTypeData || (*iter)->m_CachedSlot != rTypeData.m_CachedSlot,
+				"Component types %s and %s both use collection slot %d",
+				*(*iter)->m_Name, pStructure->m_Name, rTypeData.m_CachedSlot );
+		}
+	}
+#endif
+
 	// Update bookkeeping fields
 	rTypeData.m_Structure = pStructure;
 	rTypeData.m_DefaultCount = defaultCount;
@@ -151,6 +168,17 @@ ComponentManagerPtr Components::CreateManager( World *pWorld )
 
 #define PAD_VALUE( _VALUE , _PAD ) ((_VALUE + (_PAD-1)) & (~(_PAD-1)))
 
+static const size_t CHUNK_HEADER_SIZE = PAD_VALUE( sizeof( Components::PoolChunk ), HELIUM_COMPONENT_CHUNK_ALIGN_SIZE );
+
+// Component pools are all reported under a single heap tracker
+static uint32_t GetMemoryTracker()
+{
+	return MemoryTelemetry::GetTracker( MemoryTelemetry::CATEGORY_HEAP, Name( "Components" ) );
+}
+
+// m_OffsetToPoolStart counts POOL_ALIGN_SIZE units in 16 bits, which limits how large a chunk may be
+static const size_t CHUNK_MAX_SIZE = static_cast<size_t>( NumericLimits<uint16_t>::Maximum ) * HELIUM_COMPONENT_POOL_ALIGN_SIZE;
+
 Pool* Pool::CreatePool( ComponentManager *pComponentManager, const TypeData &rTypeData, ComponentIndex count )
 {
 	if ( !count )
@@ -166,52 +194,40 @@ Pool* Pool::CreatePool( ComponentManager *pComponentManager, const TypeData &rTy
 	HELIUM_ASSERT( componentSize );
 	componentSize = PAD_VALUE(componentSize, HELIUM_SIMD_ALIGNMENT);
 
-	size_t poolSize = PAD_VALUE( sizeof( Components::Pool ), HELIUM_SIMD_ALIGNMENT );
-	size_t memoryRequried = poolSize + componentSize * count;
-	Pool *pool = (Pool *)g_ComponentAllocator.AllocateAligned( POOL_ALIGN_SIZE, memoryRequried );
+	Pool *pool = (Pool *)g_ComponentAllocator.AllocateAligned( HELIUM_COMPONENT_CHUNK_ALIGN_SIZE, sizeof( Pool ) );
 	new(pool) Pool();
 	
-	pool->m_ParallelData = HELIUM_NEW_A( g_ComponentAllocator, DataParallel, count );
-
+	pool->m_ParallelData = NULL;
 	pool->m_World = pComponentManager->GetWorld();
 	pool->m_ComponentManager = pComponentManager;
 	pool->m_Type = &rTypeData;
 	pool->m_TypeId = rTypeData.m_TypeId;
 	pool->m_ComponentSize = componentSize;
 	pool->m_FirstUnallocatedIndex = 0;
+	pool->m_PendingCompactionCount = 0;
 	pool->m_ComponentOffset = rTypeData.GetOffsetOfComponent();
-		
-	pool->m_Roster.Resize( count );
-
-	for (uint16_t i = 0; i < count; ++i)
+	pool->m_TrackedMemory = 0;
+
+	// Round the chunk capacity up to a power of two so that indices split into chunk/offset with a shift and mask
+	pool->m_ChunkCapacity = 1;
+	pool->m_ChunkShift = 0;
+	while ( pool->m_ChunkCapacity < count && 
+		pool->m_ChunkCapacity < ( NumericLimits<ComponentIndex>::Maximum >> 1 ) + 1 &&
+		CHUNK_HEADER_SIZE + static_cast<size_t>( componentSize ) * ( pool->m_ChunkCapacity << 1 ) <= CHUNK_MAX_SIZE )
 	{
-		Component *component = pool->GetComponent( i );
-		pool->m_Roster[i] = component;
-
-		uintptr_t offset = (static_cast<uintptr_t>(reinterpret_cast<uintptr_t>(component) & POOL_ALIGN_SIZE_MASK) - reinterpret_cast<uintptr_t>(pool)) / HELIUM_COMPONENT_POOL_ALIGN_SIZE;
-		HELIUM_ASSERT(offset <= NumericLimits<uint16_t>::Maximum);
-		HELIUM_ASSERT(offset);
-		component->m_InlineData.m_OffsetToPoolStart = static_cast<uint16_t>(offset);
-			
-		component->m_InlineData.m_Owner = NULL;
-		component->m_InlineData.m_Next = Invalid<ComponentIndex>();
-		component->m_InlineData.m_Previous = Invalid<ComponentIndex>();
-		component->m_InlineData.m_Delete = false;
-		component->m_InlineData.m_Generation = 0;
-		pool->m_ParallelData[i].m_Collection = NULL;
-		pool->m_ParallelData[i].m_RosterIndex = i;
-
-		HELIUM_ASSERT( Pool::GetPool( component ) == pool );
-		HELIUM_ASSERT( Pool::GetPool( component )->GetComponentIndex( component ) == i );
-		HELIUM_ASSERT( Pool::GetPool( component )->GetComponent( i ) == component );
+		pool->m_ChunkCapacity <<= 1;
+		++pool->m_ChunkShift;
 	}
 
+	HELIUM_VERIFY( pool->AddChunk() );
+
 	HELIUM_TRACE(
 		TraceLevels::Debug,
-		"Components::Pool::CreatePool - [%5d] %s (%d bytes at %x)\n",
+		"Components::Pool::CreatePool - [%5d] %s (%d bytes per chunk of %d at %x)\n",
 		count,
 		rTypeData.m_Structure->m_Name,
-		memoryRequried,
+		CHUNK_HEADER_SIZE + componentSize * pool->m_ChunkCapacity,
+		pool->m_ChunkCapacity,
 		pool);
 
 	return pool;
@@ -226,12 +242,205 @@ void Pool::DestroyPool( Pool *pPool )
 			pPool->m_Type->m_Structure->m_Name);
 	}
 
+	for (DynamicArray<PoolChunk *>::Iterator iter = pPool->m_Chunks.Begin(); iter != pPool->m_Chunks.End(); ++iter)
+	{
+		g_ComponentAllocator.FreeAligned( *iter );
+	}
+
+	for (DynamicArray<uint8_t *>::Iterator iter = pPool->m_Streams.Begin(); iter != pPool->m_Streams.End(); ++iter)
+	{
+		g_ComponentAllocator.FreeAligned( *iter );
+	}
+
 	HELIUM_DELETE_A( g_ComponentAllocator, pPool->m_ParallelData );
+
+	if ( pPool->m_TrackedMemory )
+	{
+		MemoryTelemetry::RecordFree( GetMemoryTracker(), pPool->m_TrackedMemory );
+	}
+
 	pPool->~Pool();
 	g_ComponentAllocator.FreeAligned( pPool );
 	
 }
 
+bool Pool::AddChunk()
+{
+	// Index space is limited by ComponentIndex, and the invalid index is reserved
+	const size_t capacity = m_Roster.GetSize();
+	const size_t count = Min<size_t>( m_ChunkCapacity, NumericLimits<ComponentIndex>::Maximum - capacity );
+	if ( !count )
+	{
+		return false;
+	}
+
+	PoolChunk *pChunk = (PoolChunk *)g_ComponentAllocator.AllocateAligned(
+		HELIUM_COMPONENT_CHUNK_ALIGN_SIZE,
+		CHUNK_HEADER_SIZE + static_cast<size_t>( m_ComponentSize ) * count );
+	HELIUM_ASSERT( pChunk );
+	pChunk->m_Pool = this;
+	pChunk->m_FirstIndex = static_cast<ComponentIndex>( capacity );
+	pChunk->m_AllocatedCount = 0;
+	pChunk->m_FreedAtTick = g_ComponentProcessPendingDeletesCallCount;
+	m_Chunks.Push( pChunk );
+
+	ResizeParallelData( capacity, capacity + count );
+	ResizeStreams( capacity, capacity + count );
+	m_Roster.Resize( capacity + count );
+	UpdateTrackedMemory();
+
+	for (size_t i = capacity; i < capacity + count; ++i)
+	{
+		ComponentIndex index = static_cast<ComponentIndex>( i );
+		Component *component = GetComponent( index );
+		m_Roster[i] = component;
+
+		uintptr_t offset = (static_cast<uintptr_t>(reinterpret_cast<uintptr_t>(component) & POOL_ALIGN_SIZE_MASK) - reinterpret_cast<uintptr_t>(pChunk)) / HELIUM_COMPONENT_POOL_ALIGN_SIZE;
+		HELIUM_ASSERT(offset <= NumericLimits<uint16_t>::Maximum);
+		HELIUM_ASSERT(offset);
+		component->m_InlineData.m_OffsetToPoolStart = static_cast<uint16_t>(offset);
+			
+		component->m_InlineData.m_Owner = NULL;
+		component->m_InlineData.m_Next = Invalid<ComponentIndex>();
+		component->m_InlineData.m_Previous = Invalid<ComponentIndex>();
+		component->m_InlineData.m_Delete = false;
+		component->m_InlineData.m_Generation = 0;
+		m_ParallelData[i].m_Collection = NULL;
+		m_ParallelData[i].m_RosterIndex = index;
+
+		HELIUM_ASSERT( Pool::GetPool( component ) == this );
+		HELIUM_ASSERT( Pool::GetPool( component )->GetComponentIndex( component ) == index );
+		HELIUM_ASSERT( Pool::GetPool( component )->GetComponent( index ) == component );
+	}
+
+	return true;
+}
+
+void Pool::ResizeParallelData( size_t oldCount, size_t newCount )
+{
+	DataParallel *pParallelData = HELIUM_NEW_A( g_ComponentAllocator, DataParallel, newCount );
+	HELIUM_ASSERT( pParallelData );
+
+	const size_t copyCount = Min( oldCount, newCount );
+	for (size_t i = 0; i < copyCount; ++i)
+	{
+		pParallelData[i] = m_ParallelData[i];
+	}
+
+	if ( m_ParallelData )
+	{
+		HELIUM_DELETE_A( g_ComponentAllocator, m_ParallelData );
+	}
+
+	m_ParallelData = pParallelData;
+
+	// Handle generations outlive released chunks, so they only ever grow
+	const size_t generationCount = m_HandleGenerations.GetSize();
+	if ( newCount > generationCount )
+	{
+		m_HandleGenerations.Resize( newCount );
+		MemoryZero( m_HandleGenerations.GetData() + generationCount, ( newCount - generationCount ) * sizeof( uint32_t ) );
+	}
+}
+
+void Pool::ResizeStreams( size_t oldCount, size_t newCount )
+{
+	const DynamicArray<ComponentSizeType> &elementSizes = m_Type->m_Streams.m_ElementSizes;
+	while ( m_Streams.GetSize() < elementSizes.GetSize() )
+	{
+		m_Streams.Push( NULL );
+	}
+
+	const size_t copyCount = Min( oldCount, newCount );
+	for (size_t streamIndex = 0; streamIndex < elementSizes.GetSize(); ++streamIndex)
+	{
+		const size_t elementSize = elementSizes[ streamIndex ];
+		uint8_t *pStream = (uint8_t *)g_ComponentAllocator.AllocateAligned( HELIUM_COMPONENT_CHUNK_ALIGN_SIZE, elementSize * newCount );
+		HELIUM_ASSERT( pStream );
+
+		if ( m_Streams[ streamIndex ] )
+		{
+			MemoryCopy( pStream, m_Streams[ streamIndex ], elementSize * copyCount );
+			g_ComponentAllocator.FreeAligned( m_Streams[ streamIndex ] );
+		}
+
+		m_Streams[ streamIndex ] = pStream;
+	}
+}
+
+void Pool::ReleaseIdleChunks()
+{
+	// Only trailing chunks can go, since component indices have to stay dense. The first chunk is always kept.
+	while ( m_Chunks.GetSize() > 1 )
+	{
+		PoolChunk *pChunk = m_Chunks.GetLast();
+		if ( pChunk->m_AllocatedCount || 
+			static_cast<uint16_t>( g_ComponentProcessPendingDeletesCallCount - pChunk->m_FreedAtTick ) < COMPONENT_PTR_CHECK_FREQUENCY )
+		{
+			break;
+		}
+
+		// Every component in the chunk is free, so all of its roster entries are past m_FirstUnallocatedIndex. Drop
+		// those entries, fixing up the roster index of any free component that moves down to fill the gap.
+		const ComponentIndex firstIndex = pChunk->m_FirstIndex;
+		size_t writeIndex = m_FirstUnallocatedIndex;
+		for (size_t readIndex = m_FirstUnallocatedIndex; readIndex < m_Roster.GetSize(); ++readIndex)
+		{
+			Component *component = m_Roster[readIndex];
+			ComponentIndex index = GetComponentIndex( component );
+			if ( index >= firstIndex )
+			{
+				continue;
+			}
+
+			m_Roster[writeIndex] = component;
+			m_ParallelData[index].m_RosterIndex = static_cast<ComponentIndex>( writeIndex );
+			++writeIndex;
+		}
+
+		HELIUM_ASSERT( writeIndex == firstIndex );
+		m_Roster.Resize( firstIndex );
+		ResizeParallelData( firstIndex, firstIndex );
+		ResizeStreams( firstIndex, firstIndex );
+
+		m_Chunks.Pop();
+		g_ComponentAllocator.FreeAligned( pChunk );
+		UpdateTrackedMemory();
+	}
+}
+
+size_t Pool::GetMemoryUsage() const
+{
+	const size_t capacity = m_Roster.GetSize();
+
+	size_t streamElementSize = 0;
+	const DynamicArray<ComponentSizeType> &elementSizes = m_Type->m_Streams.m_ElementSizes;
+	for (size_t streamIndex = 0; streamIndex < elementSizes.GetSize(); ++streamIndex)
+	{
+		streamElementSize += elementSizes[ streamIndex ];
+	}
+
+	return sizeof( Pool ) +
+		m_Chunks.GetSize() * CHUNK_HEADER_SIZE +
+		capacity * ( static_cast<size_t>( m_ComponentSize ) + sizeof( DataParallel ) + sizeof( Component * ) + streamElementSize );
+}
+
+void Pool::UpdateTrackedMemory()
+{
+	// Each pool is reported as a single allocation that resizes as chunks come and go
+	const size_t memory = GetMemoryUsage();
+	if ( !m_TrackedMemory )
+	{
+		MemoryTelemetry::RecordAllocation( GetMemoryTracker(), memory );
+	}
+	else if ( memory != m_TrackedMemory )
+	{
+		MemoryTelemetry::RecordResize( GetMemoryTracker(), m_TrackedMemory, memory );
+	}
+
+	m_TrackedMemory = memory;
+}
+
 void Pool::InsertIntoChain(Component *_insertee, ComponentIndex _insertee_index, Component *nextComponent)
 {
 	// If we are inserting into a 0-length chain do nothing
@@ -275,12 +484,11 @@ void Pool::RemoveFromChain(Component *_component, ComponentIndex index)
 	}
 	else if ( _component->m_InlineData.m_Next != Invalid<uint16_t>() )
 	{
-		//m_ParallelData[ index ].m_Collection->m_Components[m_TypeId] = GetComponent( _component->m_InlineData.m_Next );
-		m_ParallelData[ index ].m_Collection->m_Components[m_TypeId] = pNextComponent;
+		m_ParallelData[ index ].m_Collection->SetHead( m_TypeId, pNextComponent );
 	}
 	else
 	{
-		m_ParallelData[ index ].m_Collection->m_Components.Remove( m_TypeId );
+		m_ParallelData[ index ].m_Collection->RemoveHead( m_TypeId );
 	}
 
 	// If we have a next node, repoint its previous pointer to our previous pointer
@@ -296,14 +504,14 @@ void Pool::RemoveFromChain(Component *_component, ComponentIndex index)
 	_component->m_InlineData.m_Previous = Invalid<uint16_t>();
 }
 
-Component* Pool::Allocate( IHasComponents *owner, ComponentCollection &collection )
+Component* Pool::Allocate( IHasComponents *owner, ComponentCollection &collection, const void *pImage )
 {
 	// Null owner is allowed
 
-	// Do we have a free component to allocate?
-	if (m_FirstUnallocatedIndex >= m_Roster.GetSize())
+	// Do we have a free component to allocate? If not, grow by another chunk
+	if (m_FirstUnallocatedIndex >= m_Roster.GetSize() && !AddChunk())
 	{
-		// Could not allocate the component because we ran out..
+		// Could not allocate the component because the index space ran out..
 		HELIUM_ASSERT_MSG( false, "Could not allocate component of type %s for host %x. No free instances are available. Maximum instances: %d", 
 			g_ComponentTypes[ m_TypeId ]->m_Structure->m_Name,
 			owner,
@@ -316,30 +524,55 @@ Component* Pool::Allocate( IHasComponents *owner, ComponentCollection &collectio
 	
 	Component *component = m_Roster[roster_index];
 	ComponentIndex component_index = GetComponentIndex( component );
+	++m_HandleGenerations[ component_index ];
 
 	// Insert into chain
-	Map<TypeId, Component *>::Iterator iter = collection.m_Components.Find(m_TypeId);
-	if (iter != collection.m_Components.End())
-	{
-		InsertIntoChain(component, component_index, iter->Second());
-		iter->Second() = component;
-	}
-	else
+	ComponentCollection::Entry *pEntry = collection.FindEntry(m_TypeId);
+	if (pEntry)
 	{
-		collection.m_Components.Insert(iter, Map<TypeId, Component *>::ValueType(m_TypeId, component));
+		InsertIntoChain(component, component_index, pEntry->m_Component);
 	}
 
+	collection.SetHead(m_TypeId, component);
+
 	//m_ParallelData[ component_index ].m_Owner =  owner;
 	component->m_InlineData.m_Owner = owner;
 
 	m_ParallelData[ component_index ].m_Collection = &collection;
+	++GetChunk( component )->m_AllocatedCount;
 
-	m_Type->Construct( component );
+	if ( pImage )
+	{
+		// The image is a whole component captured by CaptureImage(), so it replaces construction. Everything but this
+		// slot's inline data is copied over
+		HELIUM_ASSERT( m_Type->m_PrefabImage );
+		uint8_t *pDest = reinterpret_cast<uint8_t *>( component ) - m_ComponentOffset;
+		const uint8_t *pSource = static_cast<const uint8_t *>( pImage );
+		const uintptr_t inlineEnd = m_ComponentOffset + sizeof( DataInline );
+
+		MemoryCopy( pDest, pSource, m_ComponentOffset );
+		MemoryCopy( pDest + inlineEnd, pSource + inlineEnd, m_Type->GetSize() - inlineEnd );
+	}
+	else
+	{
+		m_Type->Construct( component );
+	}
 	HELIUM_ASSERT( component->m_InlineData.m_OffsetToPoolStart);
 
+	m_ComponentManager->NotifyComponentAllocated( m_TypeId, component );
+
 	return component;
 }
 
+void Pool::CaptureImage( const Component *component, DynamicArray<uint8_t> &rImage ) const
+{
+	HELIUM_ASSERT( m_Type->m_PrefabImage );
+	HELIUM_ASSERT( GetPool( component ) == this );
+
+	rImage.Resize( m_Type->GetSize() );
+	MemoryCopy( rImage.GetData(), reinterpret_cast<const uint8_t *>( component ) - m_ComponentOffset, rImage.GetSize() );
+}
+
 void Pool::Free( Component *component )
 {
 	ComponentIndex index = GetComponentIndex( component );
@@ -347,6 +580,8 @@ void Pool::Free( Component *component )
 	// Component is already freed or component doesn't have a good handle for some reason
 	HELIUM_ASSERT( m_ParallelData[ index ].m_Collection );
 
+	m_ComponentManager->NotifyComponentFreed( m_TypeId, component );
+
 	m_Type->Destruct( component );
 	RemoveFromChain( component, index );
 	
@@ -357,6 +592,24 @@ void Pool::Free( Component *component )
 
 	m_ParallelData[ index ].m_Collection = NULL;
 
+	PoolChunk *pChunk = GetChunk( component );
+	HELIUM_ASSERT( pChunk->m_AllocatedCount );
+	if ( --pChunk->m_AllocatedCount == 0 )
+	{
+		pChunk->m_FreedAtTick = g_ComponentProcessPendingDeletesCallCount;
+	}
+
+	// During a batch the roster is compacted once per pool when the batch ends
+	if ( m_ComponentManager->IsBatchingFrees() )
+	{
+		if ( m_PendingCompactionCount++ == 0 )
+		{
+			m_ComponentManager->m_PoolsPendingCompaction.Push( this );
+		}
+
+		return;
+	}
+
 	// Get roster indices we will manipulate
 	ComponentIndex used_roster_index = m_ParallelData[ index ].m_RosterIndex;
 	HELIUM_ASSERT( m_FirstUnallocatedIndex );
@@ -383,6 +636,275 @@ void Pool::Free( Component *component )
 		// Swap the roster index of the highest in-use component and the recently freed component
 		m_ParallelData[ index ].m_RosterIndex = freed_roster_index;
 		m_ParallelData[ GetComponentIndex( other_component_index ) ].m_RosterIndex = used_roster_index;
+
+		// Stream elements live at the roster index, so the highest in-use component's elements follow it down
+		const DynamicArray<ComponentSizeType> &elementSizes = m_Type->m_Streams.m_ElementSizes;
+		for (size_t streamIndex = 0; streamIndex < elementSizes.GetSize(); ++streamIndex)
+		{
+			const size_t elementSize = elementSizes[ streamIndex ];
+			MemoryCopy(
+				m_Streams[ streamIndex ] + used_roster_index * elementSize,
+				m_Streams[ streamIndex ] + freed_roster_index * elementSize,
+				elementSize );
+		}
+	}
+}
+
+void Pool::CompactRoster()
+{
+	if ( !m_PendingCompactionCount )
+	{
+		return;
+	}
+
+	// Slide the components that are still allocated down over the freed ones, keeping their order (and moving their
+	// stream elements with them), then put the freed components after them in the unallocated part of the roster
+	const DynamicArray<ComponentSizeType> &elementSizes = m_Type->m_Streams.m_ElementSizes;
+	DynamicArray<Component *> freedComponents;
+	freedComponents.Reserve( m_PendingCompactionCount );
+
+	size_t writeIndex = 0;
+	for (size_t readIndex = 0; readIndex < m_FirstUnallocatedIndex; ++readIndex)
+	{
+		Component *component = m_Roster[ readIndex ];
+		ComponentIndex index = GetComponentIndex( component );
+		if ( !m_ParallelData[ index ].m_Collection )
+		{
+			freedComponents.Push( component );
+			continue;
+		}
+
+		if ( writeIndex != readIndex )
+		{
+			m_Roster[ writeIndex ] = component;
+			m_ParallelData[ index ].m_RosterIndex = static_cast<ComponentIndex>( writeIndex );
+
+			for (size_t streamIndex = 0; streamIndex < elementSizes.GetSize(); ++streamIndex)
+			{
+				const size_t elementSize = elementSizes[ streamIndex ];
+				MemoryCopy(
+					m_Streams[ streamIndex ] + writeIndex * elementSize,
+					m_Streams[ streamIndex ] + readIndex * elementSize,
+					elementSize );
+			}
+		}
+
+		++writeIndex;
+	}
+
+	HELIUM_ASSERT( freedComponents.GetSize() == m_PendingCompactionCount );
+	m_FirstUnallocatedIndex = static_cast<ComponentIndex>( writeIndex );
+
+	for (DynamicArray<Component *>::Iterator iter = freedComponents.Begin(); iter != freedComponents.End(); ++iter)
+	{
+		m_Roster[ writeIndex ] = *iter;
+		m_ParallelData[ GetComponentIndex( *iter ) ].m_RosterIndex = static_cast<ComponentIndex>( writeIndex );
+		++writeIndex;
+	}
+
+	m_PendingCompactionCount = 0;
+}
+
+void Pool::CaptureSnapshot( PoolSnapshot &rSnapshot ) const
+{
+	HELIUM_ASSERT( m_Type->m_SnapshotType != SnapshotTypes::None );
+	HELIUM_ASSERT( !m_PendingCompactionCount );
+
+	const ComponentIndex count = GetAllocatedCount();
+	const DynamicArray<ComponentSizeType> &elementSizes = m_Type->m_Streams.m_ElementSizes;
+
+	rSnapshot.m_Roster.Resize( 0 );
+	rSnapshot.m_Roster.AddArray( m_Roster.GetData(), count );
+	rSnapshot.m_Generations.Resize( count );
+	for (ComponentIndex i = 0; i < count; ++i)
+	{
+		rSnapshot.m_Generations[ i ] = m_Roster[ i ]->m_InlineData.m_Generation;
+	}
+
+	// Stream elements are packed in roster order, so each stream is a single copy
+	rSnapshot.m_Data.Resize( 0 );
+	for (size_t streamIndex = 0; streamIndex < elementSizes.GetSize(); ++streamIndex)
+	{
+		rSnapshot.m_Data.AddArray( m_Streams[ streamIndex ], static_cast<size_t>( count ) * elementSizes[ streamIndex ] );
+	}
+
+	if ( m_Type->m_SnapshotType == SnapshotTypes::Custom )
+	{
+		for (ComponentIndex i = 0; i < count; ++i)
+		{
+			m_Type->m_SaveSnapshot( m_Roster[ i ], rSnapshot.m_Data );
+		}
+
+		return;
+	}
+
+	// Everything but the inline data, which only describes where the component is in the pool
+	const uintptr_t inlineEnd = m_ComponentOffset + sizeof( DataInline );
+	for (ComponentIndex i = 0; i < count; ++i)
+	{
+		const uint8_t *pSource = reinterpret_cast<const uint8_t *>( m_Roster[ i ] ) - m_ComponentOffset;
+		rSnapshot.m_Data.AddArray( pSource, m_ComponentOffset );
+		rSnapshot.m_Data.AddArray( pSource + inlineEnd, m_Type->GetSize() - inlineEnd );
+	}
+}
+
+bool Pool::CanRestoreSnapshot( const PoolSnapshot &rSnapshot ) const
+{
+	const ComponentIndex count = GetAllocatedCount();
+	if ( m_PendingCompactionCount || rSnapshot.m_Roster.GetSize() != count )
+	{
+		return false;
+	}
+
+	// The same components must still be allocated in the same roster order, or streams would not line up
+	for (ComponentIndex i = 0; i < count; ++i)
+	{
+		if ( m_Roster[ i ] != rSnapshot.m_Roster[ i ] || m_Roster[ i ]->m_InlineData.m_Generation != rSnapshot.m_Generations[ i ] )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Pool::RestoreSnapshot( const PoolSnapshot &rSnapshot )
+{
+	HELIUM_ASSERT( CanRestoreSnapshot( rSnapshot ) );
+
+	const ComponentIndex count = GetAllocatedCount();
+	const DynamicArray<ComponentSizeType> &elementSizes = m_Type->m_Streams.m_ElementSizes;
+	const uint8_t *pSource = rSnapshot.m_Data.GetData();
+
+	for (size_t streamIndex = 0; streamIndex < elementSizes.GetSize(); ++streamIndex)
+	{
+		const size_t streamSize = static_cast<size_t>( count ) * elementSizes[ streamIndex ];
+		MemoryCopy( m_Streams[ streamIndex ], pSource, streamSize );
+		pSource += streamSize;
+	}
+
+	if ( m_Type->m_SnapshotType == SnapshotTypes::Custom )
+	{
+		for (ComponentIndex i = 0; i < count; ++i)
+		{
+			m_Type->m_RestoreSnapshot( m_Roster[ i ], pSource );
+		}
+	}
+	else
+	{
+		const uintptr_t inlineEnd = m_ComponentOffset + sizeof( DataInline );
+		const size_t restSize = m_Type->GetSize() - inlineEnd;
+		for (ComponentIndex i = 0; i < count; ++i)
+		{
+			uint8_t *pDest = reinterpret_cast<uint8_t *>( m_Roster[ i ] ) - m_ComponentOffset;
+			MemoryCopy( pDest, pSource, m_ComponentOffset );
+			MemoryCopy( pDest + inlineEnd, pSource + m_ComponentOffset, restSize );
+			pSource += m_ComponentOffset + restSize;
+		}
+	}
+
+	HELIUM_ASSERT( pSource == rSnapshot.m_Data.GetData() + rSnapshot.m_Data.GetSize() );
+}
+
+bool Pool::CanAdopt( const Pool &rSource ) const
+{
+	// Adopted chunks go after the existing ones, so every chunk but the last has to be full for indices to stay dense
+	const size_t capacity = m_Roster.GetSize();
+	return rSource.m_TypeId == m_TypeId &&
+		rSource.m_ChunkCapacity == m_ChunkCapacity &&
+		rSource.m_World == m_World &&
+		!rSource.m_PendingCompactionCount &&
+		!m_PendingCompactionCount &&
+		( capacity & ( m_ChunkCapacity - 1 ) ) == 0 &&
+		capacity + rSource.m_Roster.GetSize() <= NumericLimits<ComponentIndex>::Maximum;
+}
+
+void Pool::Adopt( Pool &rSource )
+{
+	HELIUM_ASSERT( CanAdopt( rSource ) );
+
+	const size_t targetCapacity = m_Roster.GetSize();
+	const size_t sourceCapacity = rSource.m_Roster.GetSize();
+	if ( !sourceCapacity )
+	{
+		return;
+	}
+
+	// Source component indices all move up by the same amount since the source chunks are appended in order
+	const ComponentIndex indexOffset = static_cast<ComponentIndex>( targetCapacity );
+	for (DynamicArray<PoolChunk *>::Iterator iter = rSource.m_Chunks.Begin(); iter != rSource.m_Chunks.End(); ++iter)
+	{
+		PoolChunk *pChunk = *iter;
+		pChunk->m_Pool = this;
+		pChunk->m_FirstIndex = static_cast<ComponentIndex>( pChunk->m_FirstIndex + indexOffset );
+		m_Chunks.Push( pChunk );
+	}
+
+	ResizeParallelData( targetCapacity, targetCapacity + sourceCapacity );
+	for (size_t i = 0; i < sourceCapacity; ++i)
+	{
+		m_ParallelData[ targetCapacity + i ] = rSource.m_ParallelData[ i ];
+
+		Component *component = rSource.m_Roster[ i ];
+		if ( IsValid( component->m_InlineData.m_Next ) )
+		{
+			component->m_InlineData.m_Next = static_cast<ComponentIndex>( component->m_InlineData.m_Next + indexOffset );
+		}
+
+		if ( IsValid( component->m_InlineData.m_Previous ) )
+		{
+			component->m_InlineData.m_Previous = static_cast<ComponentIndex>( component->m_InlineData.m_Previous + indexOffset );
+		}
+	}
+
+	// The roster becomes [target allocated, source allocated, target free, source free]. Stream elements follow the
+	// allocated components; elements of free components are never read, so they are left uninitialized
+	const size_t targetAllocated = m_FirstUnallocatedIndex;
+	const size_t sourceAllocated = rSource.m_FirstUnallocatedIndex;
+
+	DynamicArray<Component *> roster;
+	roster.Reserve( targetCapacity + sourceCapacity );
+	roster.AddArray( m_Roster.GetData(), targetAllocated );
+	roster.AddArray( rSource.m_Roster.GetData(), sourceAllocated );
+	roster.AddArray( m_Roster.GetData() + targetAllocated, targetCapacity - targetAllocated );
+	roster.AddArray( rSource.m_Roster.GetData() + sourceAllocated, sourceCapacity - sourceAllocated );
+	m_Roster = roster;
+
+	for (size_t rosterIndex = 0; rosterIndex < m_Roster.GetSize(); ++rosterIndex)
+	{
+		m_ParallelData[ GetComponentIndex( m_Roster[ rosterIndex ] ) ].m_RosterIndex = static_cast<ComponentIndex>( rosterIndex );
+	}
+
+	const DynamicArray<ComponentSizeType> &elementSizes = m_Type->m_Streams.m_ElementSizes;
+	for (size_t streamIndex = 0; streamIndex < elementSizes.GetSize(); ++streamIndex)
+	{
+		const size_t elementSize = elementSizes[ streamIndex ];
+		uint8_t *pStream = (uint8_t *)g_ComponentAllocator.AllocateAligned(
+			HELIUM_COMPONENT_CHUNK_ALIGN_SIZE,
+			elementSize * ( targetCapacity + sourceCapacity ) );
+		HELIUM_ASSERT( pStream );
+
+		MemoryCopy( pStream, m_Streams[ streamIndex ], elementSize * targetAllocated );
+		MemoryCopy( pStream + elementSize * targetAllocated, rSource.m_Streams[ streamIndex ], elementSize * sourceAllocated );
+
+		g_ComponentAllocator.FreeAligned( m_Streams[ streamIndex ] );
+		m_Streams[ streamIndex ] = pStream;
+	}
+
+	m_FirstUnallocatedIndex = static_cast<ComponentIndex>( targetAllocated + sourceAllocated );
+
+	// The source keeps its (now unused) parallel data and streams for DestroyPool() to free, and grows new chunks if
+	// it is allocated from again
+	rSource.m_Chunks.Clear();
+	rSource.m_Roster.Clear();
+	rSource.m_FirstUnallocatedIndex = 0;
+
+	UpdateTrackedMemory();
+	rSource.UpdateTrackedMemory();
+
+	for (size_t rosterIndex = targetAllocated; rosterIndex < targetAllocated + sourceAllocated; ++rosterIndex)
+	{
+		m_ComponentManager->NotifyComponentAllocated( m_TypeId, m_Roster[ rosterIndex ] );
 	}
 }
 
@@ -410,6 +932,7 @@ void Helium::Components::Pool::SpewRosterToTty()
 
 Helium::ComponentManager::ComponentManager(World *pWorld)
 	: m_World(pWorld)
+	, m_BatchedFreeDepth(0)
 {
 	for (DynamicArray<TypeData *>::Iterator iter = g_ComponentTypes.Begin();
 		iter != g_ComponentTypes.End(); ++iter)
@@ -422,7 +945,8 @@ Helium::ComponentManager::ComponentManager(World *pWorld)
 
 Helium::ComponentManager::~ComponentManager()
 {
-	Tick(); // Process pending deletes if necessary
+	HELIUM_ASSERT( !m_BatchedFreeDepth );
+	FreeDeferredComponents();
 
 	for (DynamicArray<Pool *>::Iterator iter = m_Pools.Begin();
 		iter != m_Pools.End(); ++iter)
@@ -443,6 +967,256 @@ Helium::ComponentManager::~ComponentManager()
 	}
 
 	m_Pools.Clear();
+
+	for (DynamicArray<ComponentQueryCache *>::Iterator iter = m_QueryCaches.Begin();
+		iter != m_QueryCaches.End(); ++iter)
+	{
+		delete *iter;
+	}
+
+	m_QueryCaches.Clear();
+	m_QueryCachesByType.Clear();
+}
+
+void Helium::ComponentManager::BeginBatchedFrees()
+{
+	++m_BatchedFreeDepth;
+}
+
+void Helium::ComponentManager::EndBatchedFrees()
+{
+	HELIUM_ASSERT( m_BatchedFreeDepth );
+	if ( --m_BatchedFreeDepth )
+	{
+		return;
+	}
+
+	for (DynamicArray<Pool *>::Iterator iter = m_PoolsPendingCompaction.Begin();
+		iter != m_PoolsPendingCompaction.End(); ++iter)
+	{
+		(*iter)->CompactRoster();
+	}
+
+	m_PoolsPendingCompaction.Resize( 0 );
+}
+
+void Helium::ComponentManager::QueueDeferredFree( Component *pComponent )
+{
+	HELIUM_ASSERT( pComponent );
+
+	DeferredFree *pDeferredFree = m_DeferredFrees.New();
+	HELIUM_ASSERT( pDeferredFree );
+	pDeferredFree->m_Component = pComponent;
+	pDeferredFree->m_Generation = pComponent->GetInlineData().m_Generation;
+}
+
+void Helium::ComponentManager::FreeDeferredComponents()
+{
+	if ( m_DeferredFrees.IsEmpty() )
+	{
+		return;
+	}
+
+	BeginBatchedFrees();
+
+	// Destructors may queue more frees, so the size is re-read every iteration
+	for (size_t index = 0; index < m_DeferredFrees.GetSize(); ++index)
+	{
+		DeferredFree deferredFree = m_DeferredFrees[ index ];
+		Component *pComponent = deferredFree.m_Component;
+
+		// Skip components that were freed some other way since being marked (and possibly reallocated)
+		if ( pComponent->GetInlineData().m_Generation != deferredFree.m_Generation ||
+			!pComponent->GetInlineData().m_Delete ||
+			!pComponent->GetComponentCollection() )
+		{
+			continue;
+		}
+
+		pComponent->FreeComponent();
+	}
+
+	m_DeferredFrees.Resize( 0 );
+
+	EndBatchedFrees();
+}
+
+void Helium::ComponentManager::ReleaseIdleChunks()
+{
+	// Query caches may still hold freed components from those chunks; let them catch up before the memory goes away
+	for (DynamicArray<ComponentQueryCache *>::Iterator iter = m_QueryCaches.Begin();
+		iter != m_QueryCaches.End(); ++iter)
+	{
+		(*iter)->Refresh();
+	}
+
+	for (DynamicArray<Pool *>::Iterator iter = m_Pools.Begin();
+		iter != m_Pools.End(); ++iter)
+	{
+		if ( *iter )
+		{
+			(*iter)->ReleaseIdleChunks();
+		}
+	}
+}
+
+void Helium::ComponentManager::CaptureSnapshot( ComponentSnapshot &rSnapshot ) const
+{
+	HELIUM_ASSERT( !m_BatchedFreeDepth );
+
+	rSnapshot.m_Pools.Resize( m_Pools.GetSize() );
+	for (size_t typeId = 0; typeId < m_Pools.GetSize(); ++typeId)
+	{
+		const Pool *pPool = m_Pools[ typeId ];
+		if ( pPool && g_ComponentTypes[ typeId ]->m_SnapshotType != SnapshotTypes::None )
+		{
+			pPool->CaptureSnapshot( rSnapshot.m_Pools[ typeId ] );
+		}
+	}
+}
+
+bool Helium::ComponentManager::RestoreSnapshot( const ComponentSnapshot &rSnapshot )
+{
+	HELIUM_ASSERT( !m_BatchedFreeDepth );
+
+	if ( rSnapshot.m_Pools.GetSize() != m_Pools.GetSize() )
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "ComponentManager::RestoreSnapshot - Snapshot was not captured from this manager\n" );
+		return false;
+	}
+
+	// Check every pool first so a failure leaves every component as it was
+	for (size_t typeId = 0; typeId < m_Pools.GetSize(); ++typeId)
+	{
+		const Pool *pPool = m_Pools[ typeId ];
+		if ( pPool && g_ComponentTypes[ typeId ]->m_SnapshotType != SnapshotTypes::None &&
+			!pPool->CanRestoreSnapshot( rSnapshot.m_Pools[ typeId ] ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"ComponentManager::RestoreSnapshot - Components of type %s were allocated or freed since the snapshot was captured\n",
+				g_ComponentTypes[ typeId ]->m_Structure->m_Name);
+			return false;
+		}
+	}
+
+	for (size_t typeId = 0; typeId < m_Pools.GetSize(); ++typeId)
+	{
+		Pool *pPool = m_Pools[ typeId ];
+		if ( pPool && g_ComponentTypes[ typeId ]->m_SnapshotType != SnapshotTypes::None )
+		{
+			pPool->RestoreSnapshot( rSnapshot.m_Pools[ typeId ] );
+		}
+	}
+
+	return true;
+}
+
+bool Helium::ComponentManager::AdoptComponents( ComponentManager &rSource )
+{
+	HELIUM_ASSERT( &rSource != this );
+	HELIUM_ASSERT( rSource.m_World == m_World );
+	HELIUM_ASSERT( !m_BatchedFreeDepth && !rSource.m_BatchedFreeDepth );
+	HELIUM_ASSERT( rSource.m_Pools.GetSize() == m_Pools.GetSize() );
+
+	// Check every pool first so a failure leaves both managers as they were
+	for (size_t typeId = 0; typeId < m_Pools.GetSize(); ++typeId)
+	{
+		Pool *pPool = m_Pools[ typeId ];
+		Pool *pSourcePool = rSource.m_Pools[ typeId ];
+		if ( pPool && pSourcePool && !pPool->CanAdopt( *pSourcePool ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"ComponentManager::AdoptComponents - Cannot adopt %d components of type %s\n",
+				pSourcePool->GetAllocatedCount(),
+				g_ComponentTypes[ typeId ]->m_Structure->m_Name);
+			return false;
+		}
+
+		HELIUM_ASSERT( !pPool == !pSourcePool );
+	}
+
+	for (size_t typeId = 0; typeId < m_Pools.GetSize(); ++typeId)
+	{
+		if ( m_Pools[ typeId ] )
+		{
+			m_Pools[ typeId ]->Adopt( *rSource.m_Pools[ typeId ] );
+		}
+	}
+
+	// Components marked for deferred free still have to go at the end of the frame
+	m_DeferredFrees.AddArray( rSource.m_DeferredFrees.GetData(), rSource.m_DeferredFrees.GetSize() );
+	rSource.m_DeferredFrees.Resize( 0 );
+
+	return true;
+}
+
+ComponentQueryCache* Helium::ComponentManager::GetQueryCache( const Components::TypeId *types, size_t typesCount )
+{
+	for (DynamicArray<ComponentQueryCache *>::Iterator iter = m_QueryCaches.Begin();
+		iter != m_QueryCaches.End(); ++iter)
+	{
+		if ( (*iter)->GetTypes() == types )
+		{
+			HELIUM_ASSERT( (*iter)->GetTypesCount() == typesCount );
+			return *iter;
+		}
+	}
+
+	ComponentQueryCache *pCache = new ComponentQueryCache( *this, types, typesCount );
+	HELIUM_ASSERT( pCache );
+	m_QueryCaches.Push( pCache );
+
+	// Register the cache with every concrete type that can affect its matches
+	if ( m_QueryCachesByType.IsEmpty() )
+	{
+		m_QueryCachesByType.Resize( g_ComponentTypes.GetSize() );
+	}
+
+	for (size_t index = 0; index < typesCount; ++index)
+	{
+		const DynamicArray< TypeId > &implementingTypes = g_ComponentTypes[ types[ index ] ]->m_ImplementingTypes;
+		for (DynamicArray< TypeId >::ConstIterator typeIter = implementingTypes.Begin();
+			typeIter != implementingTypes.End(); ++typeIter)
+		{
+			DynamicArray<ComponentQueryCache *> &rCaches = m_QueryCachesByType[ *typeIter ];
+			if ( rCaches.IsEmpty() || rCaches.GetLast() != pCache )
+			{
+				rCaches.Push( pCache );
+			}
+		}
+	}
+
+	return pCache;
+}
+
+void Helium::ComponentManager::NotifyComponentAllocated( Components::TypeId typeId, Component *pComponent )
+{
+	if ( m_QueryCachesByType.IsEmpty() )
+	{
+		return;
+	}
+
+	DynamicArray<ComponentQueryCache *> &rCaches = m_QueryCachesByType[ typeId ];
+	for (DynamicArray<ComponentQueryCache *>::Iterator iter = rCaches.Begin(); iter != rCaches.End(); ++iter)
+	{
+		(*iter)->OnComponentAllocated( pComponent );
+	}
+}
+
+void Helium::ComponentManager::NotifyComponentFreed( Components::TypeId typeId, Component *pComponent )
+{
+	if ( m_QueryCachesByType.IsEmpty() )
+	{
+		return;
+	}
+
+	DynamicArray<ComponentQueryCache *> &rCaches = m_QueryCachesByType[ typeId ];
+	for (DynamicArray<ComponentQueryCache *>::Iterator iter = rCaches.Begin(); iter != rCaches.End(); ++iter)
+	{
+		(*iter)->OnComponentFreed( pComponent );
+	}
 }
 
 void Helium::Components::Tick()
@@ -551,10 +1325,10 @@ void Helium::ComponentCollection::SpewToTty()
 		"-- SPEWING COMPONENTS for component set %x--\n",
 		this);
 
-	for (Map< Components::TypeId, Component * >::Iterator iter = m_Components.Begin(); iter != m_Components.End(); ++iter)
+	for (DynamicArray< Entry >::Iterator iter = m_Components.Begin(); iter != m_Components.End(); ++iter)
 	{
-		TypeId typeId = iter->First();
-		Component *pComponent = iter->Second();
+		TypeId typeId = iter->m_TypeId;
+		Component *pComponent = iter->m_Component;
 
 		HELIUM_TRACE(
 			TraceLevels::Debug,
@@ -55,9 +55,45 @@
 	Helium::Components::ComponentRegistrar<__Type, __Type::ComponentBase> __Type::s_ComponentRegistrar(#__Type, __Count); \
 	HELIUM_DEFINE_DERIVED_STRUCT( __Type )
 
+		//! Give a component type one of the fixed lookup slots in every ComponentCollection, so GetFirst<T>() for it is
+		//! a single load. Use at global scope in the component's header, after the class. Slots are shared by all
+		//! modules, so keep this for the few sibling types that are looked up constantly
+#define HELIUM_CACHE_COMPONENT_SLOT( __Type, __Slot ) \
+	namespace Helium { namespace Components { \
+		template <> struct CachedSlot< __Type > { static const uint8_t Value = __Slot; }; \
+	} }
+
+		//! Allow a component type to be spawned from a prefab image: EntityDefinition captures the component's bytes
+		//! once after Initialize() and later copies of the entity memcpy that image into the pool instead of running
+		//! the constructor and Initialize() again. Only for plain data components whose Initialize() reads nothing but
+		//! the definition (no pointers to owned memory, no ComponentPtrs, no streams). Use at global scope in the
+		//! component's header, after the class
+#define HELIUM_COMPONENT_PREFAB_IMAGE( __Type ) \
+	namespace Helium { namespace Components { \
+		template <> struct PrefabImage< __Type > { static const bool Value = true; }; \
+	} }
+
+		//! Save a component type in snapshots by copying its bytes (see ComponentManager::CaptureSnapshot()). Only for plain
+		//! data components (no pointers to owned memory, no ComponentPtrs). Use at global scope in the component's header,
+		//! after the class
+#define HELIUM_COMPONENT_SNAPSHOT( __Type ) \
+	namespace Helium { namespace Components { \
+		template <> struct SnapshotTypeOf< __Type > { static const SnapshotType Value = SnapshotTypes::Memory; }; \
+	} }
+
+		//! Save a component type in snapshots through its own SaveSnapshot( DynamicArray<uint8_t> &rData ) const, which
+		//! appends the component's state, and RestoreSnapshot( const uint8_t *&rpData ), which reads it back and advances
+		//! rpData past it. Stream elements are always copied for the type and are restored before RestoreSnapshot() is
+		//! called. Use at global scope in the component's header, after the class
+#define HELIUM_COMPONENT_CUSTOM_SNAPSHOT( __Type ) \
+	namespace Helium { namespace Components { \
+		template <> struct SnapshotTypeOf< __Type > { static const SnapshotType Value = SnapshotTypes::Custom; }; \
+	} }
+
 #define HELIUM_COMPONENT_PTR_CHECK_FREQUENCY (256)
 #define HELIUM_COMPONENT_POOL_ALIGN_SIZE (32)
 #define HELIUM_COMPONENT_POOL_ALIGN_SIZE_MASK (~(POOL_ALIGN_SIZE-1))
+#define HELIUM_COMPONENT_CHUNK_ALIGN_SIZE (64)
 
 namespace Helium
 {
@@ -66,6 +102,7 @@ namespace Helium
 	class Component;
 	class World;
 	class ComponentPtrBase;
+	class ComponentQueryCache;
 	class SystemDefinition;
 
 	namespace Components
@@ -92,6 +129,63 @@ namespace Helium
 		typedef uint8_t GenerationIndex;
 
 		const static uint32_t COMPONENT_PTR_CHECK_FREQUENCY = 256;
+		const static uint8_t  COLLECTION_CACHED_SLOT_COUNT = 4;
+
+		//! Fixed ComponentCollection slot of a type, or COLLECTION_CACHED_SLOT_COUNT if it has none. Specialized
+		//! by HELIUM_CACHE_COMPONENT_SLOT
+		template <class T>
+		struct CachedSlot
+		{
+			static const uint8_t Value = COLLECTION_CACHED_SLOT_COUNT;
+		};
+
+		//! Whether a type may be spawned from a prefab image. Specialized by HELIUM_COMPONENT_PREFAB_IMAGE
+		template <class T>
+		struct PrefabImage
+		{
+			static const bool Value = false;
+		};
+
+		namespace SnapshotTypes
+		{
+			enum SnapshotType
+			{
+				None,   //< Not saved, restoring a snapshot leaves these components as they are
+				Memory, //< Saved by copying the component's bytes
+				Custom, //< Saved by the component's own SaveSnapshot() and RestoreSnapshot()
+			};
+		}
+		typedef SnapshotTypes::SnapshotType SnapshotType;
+
+		//! How a type is saved in snapshots. Specialized by HELIUM_COMPONENT_SNAPSHOT and
+		//! HELIUM_COMPONENT_CUSTOM_SNAPSHOT
+		template <class T>
+		struct SnapshotTypeOf
+		{
+			static const SnapshotType Value = SnapshotTypes::None;
+		};
+
+		typedef void (*SaveSnapshotFunc)( const Component *ptr, DynamicArray<uint8_t> &rData );
+		typedef void (*RestoreSnapshotFunc)( Component *ptr, const uint8_t *&rpData );
+
+		//! Snapshot functions of a type using SnapshotTypes::Custom. Other types get none, so they need not declare them
+		template <class T, bool bCustom = SnapshotTypeOf< T >::Value == SnapshotTypes::Custom>
+		struct CustomSnapshot
+		{
+			static SaveSnapshotFunc    GetSave()    { return NULL; }
+			static RestoreSnapshotFunc GetRestore() { return NULL; }
+		};
+
+		template <class T>
+		struct CustomSnapshot< T, true >
+		{
+			static void Save( const Component *ptr, DynamicArray<uint8_t> &rData ) { static_cast<const T *>( ptr )->SaveSnapshot( rData ); }
+			static void Restore( Component *ptr, const uint8_t *&rpData ) { static_cast<T *>( ptr )->RestoreSnapshot( rpData ); }
+
+			static SaveSnapshotFunc    GetSave()    { return Save; }
+			static RestoreSnapshotFunc GetRestore() { return Restore; }
+		};
+
 		const static uintptr_t POOL_ALIGN_SIZE = 32;
 		const static uintptr_t POOL_ALIGN_SIZE_MASK = ~(POOL_ALIGN_SIZE-1);
 		
@@ -101,6 +195,16 @@ namespace Helium
 		static Helium::DefaultAllocator g_ComponentAllocator;
 #endif
 
+		//! Structure-of-arrays streams declared by a component type through its static DeclareStreams(). Each stream
+		//! holds one trivially copyable element per allocated component, packed in roster order, so a task can walk
+		//! a single hot field of every component in a pool without touching the rest of the component
+		struct StreamList
+		{
+			template <class T> void Add() { m_ElementSizes.Push( static_cast<ComponentSizeType>( sizeof( T ) ) ); }
+
+			DynamicArray<ComponentSizeType> m_ElementSizes;
+		};
+
 		struct TypeData
 		{
 			inline TypeData();
@@ -111,6 +215,12 @@ namespace Helium
 			DynamicArray<TypeId>       m_ImplementedTypes;       //< Parent type IDs of this type
 			DynamicArray<TypeId>       m_ImplementingTypes;      //< Child types IDs of this type
 			ComponentIndex             m_DefaultCount;           //< Default number of components of this type to make
+			StreamList                 m_Streams;                //< SoA streams of this type, in stream index order
+			uint8_t                    m_CachedSlot;             //< Fixed ComponentCollection slot, or COLLECTION_CACHED_SLOT_COUNT
+			bool                       m_PrefabImage;            //< Components may be spawned by copying a captured image
+			SnapshotType               m_SnapshotType;           //< How components are saved in snapshots
+			SaveSnapshotFunc           m_SaveSnapshot;           //< Saves a component, for SnapshotTypes::Custom
+			RestoreSnapshotFunc        m_RestoreSnapshot;        //< Restores a component, for SnapshotTypes::Custom
 
 			virtual void       Construct(Component *ptr) const = 0;
 			virtual void       Destruct(Component *ptr) const = 0;
@@ -168,6 +278,29 @@ namespace Helium
 			ComponentIndex        m_RosterIndex;
 		};
 		
+		struct Pool;
+
+		//! Saved state of the components of one pool, see ComponentSnapshot
+		struct PoolSnapshot
+		{
+			DynamicArray<Component *>     m_Roster;       //< Allocated components when captured, in roster order
+			DynamicArray<GenerationIndex> m_Generations;  //< Generation of each component in m_Roster
+			DynamicArray<uint8_t>         m_Data;         //< Stream elements, then the saved state of each component
+		};
+
+		//! Header at the start of every block of components in a pool. m_OffsetToPoolStart in each component's
+		//! inline data is the distance back to the header of the chunk holding it
+		struct HELIUM_FRAMEWORK_API PoolChunk
+		{
+			Pool*            m_Pool;
+			ComponentIndex   m_FirstIndex;        //< Component index of the first component in this chunk
+			ComponentIndex   m_AllocatedCount;    //< Number of components in this chunk that are allocated
+			uint16_t         m_FreedAtTick;       //< Components::Tick() count when m_AllocatedCount last reached zero
+		};
+
+		//! Components of one type within a ComponentManager. The pool starts with one chunk sized from the count given
+		//! to HELIUM_DEFINE_COMPONENT (or the SystemDefinition's pool size) and grows by more chunks of the same size
+		//! when it runs out, so components never move once allocated
 		struct HELIUM_FRAMEWORK_API Pool
 		{
 		public:
@@ -194,11 +327,28 @@ namespace Helium
 			inline ComponentIndex      GetPreviousIndex(ComponentIndex index) const;
 			inline GenerationIndex     GetGeneration(ComponentIndex index) const;
 			inline ComponentIndex      GetAllocatedCount() const;
+			inline ComponentIndex      GetCapacity() const;
 			inline Component * const * GetAllocatedComponents() const;
 			inline Component *         GetComponentByRosterIndex(ComponentIndex index) const;
+			inline uint32_t            GetHandleGeneration(ComponentIndex index) const;
+			inline Component*          ResolveHandle(ComponentIndex index, uint32_t generation) const;
+			size_t                     GetMemoryUsage() const;
 
-			Component*                 Allocate(Components::IHasComponents *owner, ComponentCollection &collection);
+			inline uint16_t            GetStreamCount() const;
+			inline void*               GetStreamData( uint16_t streamIndex ) const;
+			inline void*               GetStreamElement( uint16_t streamIndex, const Component *component ) const;
+			template <class T> T*      GetStream( uint16_t streamIndex ) const;
+
+			Component*                 Allocate(Components::IHasComponents *owner, ComponentCollection &collection, const void *pImage = NULL);
+			void                       CaptureImage(const Component *component, DynamicArray<uint8_t> &rImage) const;
 			void                       Free(Component *component);
+			void                       ReleaseIdleChunks();
+			void                       CompactRoster();
+			void                       CaptureSnapshot(PoolSnapshot &rSnapshot) const;
+			bool                       CanRestoreSnapshot(const PoolSnapshot &rSnapshot) const;
+			void                       RestoreSnapshot(const PoolSnapshot &rSnapshot);
+			bool                       CanAdopt(const Pool &rSource) const;
+			void                       Adopt(Pool &rSource);
 			void                       InsertIntoChain(Component *_insertee, ComponentIndex _insertee_index, Component *nextComponent);
 			void                       RemoveFromChain(Component *_component, ComponentIndex index);
 
@@ -208,10 +358,18 @@ namespace Helium
 
 		private:
 
-			inline uintptr_t           GetFirstComponentPtr() const;
+			static inline PoolChunk*   GetChunk( const Component *component );
+			inline uintptr_t           GetFirstComponentPtr( const PoolChunk *pChunk ) const;
+			bool                       AddChunk();
+			void                       ResizeParallelData( size_t oldCount, size_t newCount );
+			void                       ResizeStreams( size_t oldCount, size_t newCount );
+			void                       UpdateTrackedMemory();
 									   
 			DynamicArray<Component *>  m_Roster;
+			DynamicArray<PoolChunk *>  m_Chunks;
+			DynamicArray<uint8_t *>    m_Streams;           //< One array per declared stream, indexed by roster index
 			DataParallel*              m_ParallelData;
+			DynamicArray<uint32_t>     m_HandleGenerations; //< Bumped whenever an index is allocated; never shrinks, so stale handles stay stale
 			World*                     m_World;
 			ComponentManager*          m_ComponentManager;
 			const TypeData*            m_Type;
@@ -219,6 +377,10 @@ namespace Helium
 			TypeId                     m_TypeId;
 			ComponentSizeType          m_ComponentSize;
 			ComponentIndex             m_FirstUnallocatedIndex;
+			ComponentIndex             m_ChunkCapacity;     //< Components per chunk, always a power of two
+			ComponentIndex             m_PendingCompactionCount;  //< Components freed during a batch but still in the allocated part of the roster
+			uint8_t                    m_ChunkShift;        //< log2 of m_ChunkCapacity
+			size_t                     m_TrackedMemory;     //< Memory usage last reported to MemoryTelemetry
 		};
 		
 		HELIUM_FRAMEWORK_API void                Startup( SystemDefinition *pSystemDefinition );
@@ -237,6 +399,17 @@ namespace Helium
 		template <class T>  TypeId GetType();
 	}
 
+	//! Saved component state of a ComponentManager, see ComponentManager::CaptureSnapshot(). Capturing into the same
+	//! snapshot again reuses its buffers, so snapshots taken every frame stop allocating once pool sizes settle
+	class HELIUM_FRAMEWORK_API ComponentSnapshot
+	{
+	private:
+		friend class ComponentManager;
+
+		// Indexed by type id, left empty for types that aren't saved
+		DynamicArray<Components::PoolSnapshot> m_Pools;
+	};
+
 	class HELIUM_FRAMEWORK_API ComponentManager
 	{
 	public:
@@ -246,7 +419,7 @@ namespace Helium
 		inline World*            GetWorld() const;
 		inline const Components::Pool*  GetPool( Components::TypeId typeId );
 
-		inline Component*        Allocate(Components::TypeId type, Components::IHasComponents *pOwner, ComponentCollection &rCollection);
+		inline Component*        Allocate(Components::TypeId type, Components::IHasComponents *pOwner, ComponentCollection &rCollection, const void *pImage = NULL);
 		inline size_t            CountAllocatedComponents( Components::TypeId typeId ) const;
 		size_t                   CountAllocatedComponentsThatImplement( Components::TypeId typeId ) const;
 
@@ -254,12 +427,65 @@ namespace Helium
 		template < class T > size_t    CountAllocatedComponents();
 		template < class T > size_t    CountAllocatedComponentsThatImplement();
 
+		// Get the persistent query for the given types, creating it on first use. The types array is used as the key
+		// and must outlive this manager (queries pass a function-local static array)
+		ComponentQueryCache*     GetQueryCache( const Components::TypeId *types, size_t typesCount );
+
+		// Frees between Begin/EndBatchedFrees() skip the per-free roster swap; each pool that had frees compacts its
+		// roster once at the end instead. Iterating components while a batch is open is not supported
+		void                     BeginBatchedFrees();
+		void                     EndBatchedFrees();
+		inline bool              IsBatchingFrees() const;
+
+		// Components marked with Component::FreeComponentDeferred() are queued here and freed as one batch
+		void                     QueueDeferredFree( Component *pComponent );
+		void                     FreeDeferredComponents();
+
+		// Give chunks back to the allocator from pools that grew for a spike. A chunk is only released once all of its
+		// components have been free for COMPONENT_PTR_CHECK_FREQUENCY ticks, so no ComponentPtr can still refer to it
+		void                     ReleaseIdleChunks();
+
+		// Move every component of rSource into this manager's pools without copying or moving any of them. Chunks are
+		// handed over as they are and only the bookkeeping is rebuilt, so the cost is in the number of chunks and roster
+		// entries rather than in component sizes. Both managers must belong to the same world. Returns false and leaves
+		// both managers untouched if a pool would run out of index space
+		bool                     AdoptComponents( ComponentManager &rSource );
+
+		// Save the state of every component whose type opted in with HELIUM_COMPONENT_SNAPSHOT or
+		// HELIUM_COMPONENT_CUSTOM_SNAPSHOT, for rollback, replays or restoring the editor when play stops. Pools are
+		// copied directly instead of going through reflection
+		void                     CaptureSnapshot( ComponentSnapshot &rSnapshot ) const;
+
+		// Put every saved component back in the state it had when rSnapshot was captured from this manager. Only
+		// component state is restored, not which components exist: if components of a saved type were allocated or
+		// freed since, returns false and leaves every component untouched
+		bool                     RestoreSnapshot( const ComponentSnapshot &rSnapshot );
+
 	private:
 		friend ComponentManagerPtr Helium::Components::CreateManager( World *pWorld );
+		friend struct Components::Pool;
 		ComponentManager(World *pWorld);
 
+		// Called by pools so that query caches interested in the component's type can update their matches
+		void                     NotifyComponentAllocated( Components::TypeId typeId, Component *pComponent );
+		void                     NotifyComponentFreed( Components::TypeId typeId, Component *pComponent );
+
 		World *m_World;
 		DynamicArray<Components::Pool *> m_Pools;
+
+		struct DeferredFree
+		{
+			Component*                 m_Component;
+			Components::GenerationIndex m_Generation;
+		};
+
+		DynamicArray<DeferredFree> m_DeferredFrees;
+		DynamicArray<Components::Pool *> m_PoolsPendingCompaction;
+		uint32_t m_BatchedFreeDepth;
+
+		DynamicArray<ComponentQueryCache *> m_QueryCaches;
+		// For each concrete component type, every query cache with a queried type that it implements
+		DynamicArray< DynamicArray<ComponentQueryCache *> > m_QueryCachesByType;
 	};
 
 
@@ -327,7 +553,7 @@ namespace Helium
 		inline void       ReleaseEach( Components::TypeId type );
 		inline void       ReleaseAll();
 
-		template <class T> inline T *GetFirst() { return static_cast<T *>( GetFirst( Components::GetType<T>() ) ); }
+		template <class T> inline T *GetFirst();
 		template <class T> void      ReleaseEach() { ReleaseEach( Components::GetType<T>() ); }
 
 #if HELIUM_TOOLS
@@ -336,7 +562,23 @@ namespace Helium
 
 	private:
 		friend Components::Pool;
-		Map< Components::TypeId, Component * > m_Components;
+
+		// Head of the chain of components of one type in this collection
+		struct Entry
+		{
+			Components::TypeId m_TypeId;
+			Component*         m_Component;
+		};
+
+		inline Entry*     FindEntry( Components::TypeId type );
+		inline void       SetHead( Components::TypeId type, Component *pComponent );
+		inline void       RemoveHead( Components::TypeId type );
+		inline void       UpdateCachedSlot( Components::TypeId type, Component *pComponent );
+
+		// Entities only carry a handful of component types, so a short array sorted by type id is scanned linearly.
+		// Types with a cached slot are also mirrored in m_CachedSlots
+		DynamicArray< Entry > m_Components;
+		Component*            m_CachedSlots[ Components::COLLECTION_CACHED_SLOT_COUNT ];
 	};
 
 	//! All components have some data for bookkeeping
@@ -346,6 +588,10 @@ namespace Helium
 		HELIUM_DECLARE_BASE_COMPONENT( Helium::Component )
 		static void PopulateMetaType( Reflect::MetaStruct& comp ) { }
 
+		// Components that keep hot fields in SoA streams hide this with their own declaration. Derived component types
+		// inherit their base's streams so the base's stream accessors keep working
+		static void DeclareStreams( Components::StreamList& rStreams ) { }
+
 		inline ComponentManager*             GetComponentManager() const;
 		inline ComponentCollection*          GetComponentCollection() const;
 		inline Components::IHasComponents*   GetOwner() const;
@@ -356,6 +602,9 @@ namespace Helium
 		inline const Components::DataInline& GetInlineData() const;
 
 		template <class T> T* AllocateSiblingComponent();
+
+		template <class T> inline T&       GetStreamElement( uint16_t streamIndex );
+		template <class T> inline const T& GetStreamElement( uint16_t streamIndex ) const;
 		
 		static Components::ComponentRegistrar<Component, void> s_ComponentRegistrar;
 
@@ -428,4 +677,46 @@ namespace Helium
 	};
 }
 
+namespace Helium
+{
+	// Reference to a component by pool and index, checked against the generation of that pool slot on every access
+	// instead of being linked into the ComponentPtr registry. Handles are plain data: copying, destroying and reading
+	// them touches nothing but the handle, so they may be used from any thread, and Components::Tick() never walks
+	// them. A handle does not follow its component into another manager through AdoptComponents()
+	class HELIUM_FRAMEWORK_API ComponentHandleBase
+	{
+	public:
+		inline bool IsGood() const;
+		inline void Reset( Component *_component = 0 );
+
+	protected:
+		inline ComponentHandleBase();
+
+		inline Component* GetComponent() const;
+		inline Component* UncheckedGetComponent() const;
+
+		Components::Pool*          m_Pool;
+		Components::ComponentIndex m_Index;
+		uint32_t                   m_Generation;
+	};
+
+	template <class T>
+	class ComponentHandle : public Helium::ComponentHandleBase
+	{
+	public:
+		ComponentHandle();
+		explicit ComponentHandle( T *_component );
+
+		void operator=( T *_component );
+
+		// Only safe to call this if you know the component was not freed since the handle was set
+		T *UncheckedGet() const;
+
+		T *Get() const;
+
+		T &operator*() const;
+		T *operator->() const;
+	};
+}
+
 #include "Framework/Components.inl"
@@ -7,6 +7,11 @@ namespace Helium
 		
 		TypeData::TypeData() 
 			: m_TypeId(Invalid<TypeId>())
+			, m_CachedSlot(COLLECTION_CACHED_SLOT_COUNT)
+			, m_PrefabImage(false)
+			, m_SnapshotType(SnapshotTypes::None)
+			, m_SaveSnapshot(NULL)
+			, m_RestoreSnapshot(NULL)
 		{
 
 		}
@@ -55,6 +60,13 @@ namespace Helium
 			{
 				BaseT::s_ComponentRegistrar.Register();
 				Reflect::MetaStructRegistrar<ClassT, BaseT>::Register();
+				ClassT::DeclareStreams( ClassT::GetStaticComponentTypeData().m_Streams );
+				ClassT::GetStaticComponentTypeData().m_CachedSlot = CachedSlot< ClassT >::Value;
+				ClassT::GetStaticComponentTypeData().m_PrefabImage = PrefabImage< ClassT >::Value;
+				ClassT::GetStaticComponentTypeData().m_SnapshotType = SnapshotTypeOf< ClassT >::Value;
+				ClassT::GetStaticComponentTypeData().m_SaveSnapshot = CustomSnapshot< ClassT >::GetSave();
+				ClassT::GetStaticComponentTypeData().m_RestoreSnapshot = CustomSnapshot< ClassT >::GetRestore();
+				HELIUM_ASSERT( !PrefabImage< ClassT >::Value || ClassT::GetStaticComponentTypeData().m_Streams.m_ElementSizes.IsEmpty() );
 				TypeId type_id = RegisterType(
 					Reflect::GetMetaStruct< ClassT >(), 
 					ClassT::GetStaticComponentTypeData(), 
@@ -84,13 +96,18 @@ namespace Helium
 			}
 		}
 
-		Pool* Pool::GetPool( const Component *component )
+		PoolChunk* Pool::GetChunk( const Component *component )
 		{
 			HELIUM_ASSERT( component->m_InlineData.m_OffsetToPoolStart );
-			return reinterpret_cast<Pool *>( 
+			return reinterpret_cast<PoolChunk *>( 
 				( reinterpret_cast<uintptr_t>(component) & POOL_ALIGN_SIZE_MASK ) - 
 				( static_cast<uintptr_t>( component->m_InlineData.m_OffsetToPoolStart ) * HELIUM_COMPONENT_POOL_ALIGN_SIZE ) );
 		}
+
+		Pool* Pool::GetPool( const Component *component )
+		{
+			return GetChunk( component )->m_Pool;
+		}
 		
 		TypeId Pool::GetTypeId() const
 		{
@@ -111,7 +128,9 @@ namespace Helium
 		{
 			if ( IsValid<ComponentIndex>( index ) )
 			{
-				return reinterpret_cast<Component *>( GetFirstComponentPtr() + index * m_ComponentSize );
+				HELIUM_ASSERT( index < m_Roster.GetSize() );
+				const PoolChunk *pChunk = m_Chunks[ index >> m_ChunkShift ];
+				return reinterpret_cast<Component *>( GetFirstComponentPtr( pChunk ) + ( index & ( m_ChunkCapacity - 1 ) ) * m_ComponentSize );
 			}
 
 			return NULL;
@@ -119,7 +138,10 @@ namespace Helium
 
 		ComponentIndex Pool::GetComponentIndex( const Component *component ) const
 		{
-			return static_cast<ComponentIndex>( ( reinterpret_cast<uintptr_t>( component ) - GetFirstComponentPtr() ) / static_cast<uintptr_t>(m_ComponentSize) );
+			const PoolChunk *pChunk = GetChunk( component );
+			HELIUM_ASSERT( pChunk->m_Pool == this );
+			return static_cast<ComponentIndex>( pChunk->m_FirstIndex + 
+				( reinterpret_cast<uintptr_t>( component ) - GetFirstComponentPtr( pChunk ) ) / static_cast<uintptr_t>(m_ComponentSize) );
 		}
 		
 		ComponentCollection* Pool::GetComponentCollection( const Component *component ) const
@@ -185,7 +207,28 @@ namespace Helium
 		{
 			return m_FirstUnallocatedIndex;
 		}
+
+		ComponentIndex Pool::GetCapacity() const
+		{
+			return static_cast<ComponentIndex>( m_Roster.GetSize() );
+		}
 		
+		uint32_t Pool::GetHandleGeneration( ComponentIndex index ) const
+		{
+			return m_HandleGenerations[ index ];
+		}
+
+		Component* Pool::ResolveHandle( ComponentIndex index, uint32_t generation ) const
+		{
+			// Released chunks take their indices out of the roster, but their generations are kept
+			if ( index >= m_Roster.GetSize() || m_HandleGenerations[ index ] != generation || !m_ParallelData[ index ].m_Collection )
+			{
+				return NULL;
+			}
+
+			return GetComponent( index );
+		}
+
 		Component * const * Pool::GetAllocatedComponents() const
 		{
 			return m_Roster.GetData();
@@ -197,10 +240,35 @@ namespace Helium
 			return m_Roster[index];
 		}
 				
-		uintptr_t Pool::GetFirstComponentPtr() const
+		uint16_t Pool::GetStreamCount() const
 		{
-			static const uintptr_t POOL_SIZE = (  (sizeof(Pool) + (HELIUM_SIMD_ALIGNMENT-1))  &  (~(HELIUM_SIMD_ALIGNMENT-1))  );
-			return reinterpret_cast<uintptr_t>(this) + POOL_SIZE + m_ComponentOffset;
+			return static_cast<uint16_t>( m_Streams.GetSize() );
+		}
+
+		void* Pool::GetStreamData( uint16_t streamIndex ) const
+		{
+			return m_Streams[ streamIndex ];
+		}
+
+		void* Pool::GetStreamElement( uint16_t streamIndex, const Component *component ) const
+		{
+			ComponentIndex rosterIndex = m_ParallelData[ GetComponentIndex( component ) ].m_RosterIndex;
+			return m_Streams[ streamIndex ] + static_cast<size_t>( rosterIndex ) * m_Type->m_Streams.m_ElementSizes[ streamIndex ];
+		}
+
+		template <class T>
+		T* Pool::GetStream( uint16_t streamIndex ) const
+		{
+			HELIUM_ASSERT( m_Type->m_Streams.m_ElementSizes[ streamIndex ] == sizeof( T ) );
+			return reinterpret_cast<T *>( m_Streams[ streamIndex ] );
+		}
+
+		uintptr_t Pool::GetFirstComponentPtr( const PoolChunk *pChunk ) const
+		{
+			// Padding the header to a whole cache line keeps the first component cache aligned, and guarantees a non-zero
+			// m_OffsetToPoolStart for every component in the chunk
+			static const uintptr_t CHUNK_HEADER_SIZE = (  (sizeof(PoolChunk) + (HELIUM_COMPONENT_CHUNK_ALIGN_SIZE-1))  &  (~(HELIUM_COMPONENT_CHUNK_ALIGN_SIZE-1))  );
+			return reinterpret_cast<uintptr_t>(pChunk) + CHUNK_HEADER_SIZE + m_ComponentOffset;
 		}
 				
 		template <class T>
@@ -337,9 +405,9 @@ namespace Helium
 		this->ResetToBeginning();
 	}
 	
-	Component* ComponentManager::Allocate( Components::TypeId type, Components::IHasComponents *pOwner, ComponentCollection &rCollection )
+	Component* ComponentManager::Allocate( Components::TypeId type, Components::IHasComponents *pOwner, ComponentCollection &rCollection, const void *pImage )
 	{
-		return m_Pools[ type ]->Allocate( pOwner, rCollection );
+		return m_Pools[ type ]->Allocate( pOwner, rCollection, pImage );
 	}
 
 	size_t ComponentManager::CountAllocatedComponents( Components::TypeId typeId ) const
@@ -352,6 +420,11 @@ namespace Helium
 		return m_World;
 	}
 
+	bool ComponentManager::IsBatchingFrees() const
+	{
+		return m_BatchedFreeDepth > 0;
+	}
+
 	template < class T >
 	size_t Helium::ComponentManager::CountAllocatedComponentsThatImplement()
 	{
@@ -376,7 +449,10 @@ namespace Helium
 	
 	Helium::ComponentCollection::ComponentCollection()
 	{
-
+		for (uint8_t slot = 0; slot < Components::COLLECTION_CACHED_SLOT_COUNT; ++slot)
+		{
+			m_CachedSlots[ slot ] = NULL;
+		}
 	}
 
 	Helium::ComponentCollection::~ComponentCollection()
@@ -386,15 +462,82 @@ namespace Helium
 
 	Component * Helium::ComponentCollection::GetFirst( Components::TypeId type )
 	{
-		Map< Components::TypeId, Component * >::Iterator iter = m_Components.Find( type );
-		if ( iter != m_Components.End() )
+		Entry *pEntry = FindEntry( type );
+		return pEntry ? pEntry->m_Component : NULL;
+	}
+
+	template <class T>
+	T * Helium::ComponentCollection::GetFirst()
+	{
+		// Resolved at compile time; types without a slot fall back to the search
+		const uint8_t slot = Components::CachedSlot<T>::Value;
+		if ( slot < Components::COLLECTION_CACHED_SLOT_COUNT )
 		{
-			return iter->Second();
+			return static_cast<T *>( m_CachedSlots[ slot < Components::COLLECTION_CACHED_SLOT_COUNT ? slot : 0 ] );
+		}
+
+		return static_cast<T *>( GetFirst( Components::GetType<T>() ) );
+	}
+
+	ComponentCollection::Entry * ComponentCollection::FindEntry( Components::TypeId type )
+	{
+		Entry *pEntry = m_Components.GetData();
+		Entry *pEnd = pEntry + m_Components.GetSize();
+		for ( ; pEntry != pEnd && pEntry->m_TypeId <= type; ++pEntry )
+		{
+			if ( pEntry->m_TypeId == type )
+			{
+				return pEntry;
+			}
 		}
 
 		return NULL;
 	}
 
+	void ComponentCollection::SetHead( Components::TypeId type, Component *pComponent )
+	{
+		HELIUM_ASSERT( pComponent );
+
+		size_t index = 0;
+		const size_t size = m_Components.GetSize();
+		while ( index < size && m_Components[ index ].m_TypeId < type )
+		{
+			++index;
+		}
+
+		if ( index < size && m_Components[ index ].m_TypeId == type )
+		{
+			m_Components[ index ].m_Component = pComponent;
+		}
+		else
+		{
+			Entry entry;
+			entry.m_TypeId = type;
+			entry.m_Component = pComponent;
+			m_Components.Insert( index, entry );
+		}
+
+		UpdateCachedSlot( type, pComponent );
+	}
+
+	void ComponentCollection::RemoveHead( Components::TypeId type )
+	{
+		Entry *pEntry = FindEntry( type );
+		HELIUM_ASSERT( pEntry );
+		m_Components.Remove( static_cast<size_t>( pEntry - m_Components.GetData() ) );
+
+		UpdateCachedSlot( type, NULL );
+	}
+
+	void ComponentCollection::UpdateCachedSlot( Components::TypeId type, Component *pComponent )
+	{
+		const uint8_t slot = Components::GetTypeData( type )->m_CachedSlot;
+		if ( slot < Components::COLLECTION_CACHED_SLOT_COUNT )
+		{
+			m_CachedSlots[ slot ] = pComponent;
+		}
+	}
+
 	void ComponentCollection::GetAll( Components::TypeId type, DynamicArray<Component *> &components )
 	{
 		Component *c = GetFirst( type );
@@ -443,7 +586,7 @@ namespace Helium
 		{
 			HELIUM_ASSERT( i == m_Components.GetSize() );
 
-			Component *c = m_Components.Begin()->Second();
+			Component *c = m_Components[ 0 ].m_Component;
 			HELIUM_ASSERT( c );
 
 			Components::Pool *pool = Components::Pool::GetPool( c );
@@ -495,7 +638,11 @@ namespace Helium
 
 	void Component::FreeComponentDeferred()
 	{
-		m_InlineData.m_Delete = true;
+		if ( !m_InlineData.m_Delete )
+		{
+			m_InlineData.m_Delete = true;
+			GetComponentManager()->QueueDeferredFree( this );
+		}
 	}
 	
 	const Components::DataInline &Component::GetInlineData() const
@@ -504,6 +651,22 @@ namespace Helium
 	}
 
 
+	template <class T>
+	T& Component::GetStreamElement( uint16_t streamIndex )
+	{
+		Components::Pool* pool = Components::Pool::GetPool( this );
+		HELIUM_ASSERT( pool );
+		return *static_cast<T *>( pool->GetStreamElement( streamIndex, this ) );
+	}
+
+	template <class T>
+	const T& Component::GetStreamElement( uint16_t streamIndex ) const
+	{
+		Components::Pool* pool = Components::Pool::GetPool( this );
+		HELIUM_ASSERT( pool );
+		return *static_cast<const T *>( pool->GetStreamElement( streamIndex, this ) );
+	}
+
 	template <class T>
 	T* Helium::Component::AllocateSiblingComponent()
 	{
@@ -628,4 +791,82 @@ namespace Helium
 	{
 		return Get();
 	}
+
+	ComponentHandleBase::ComponentHandleBase()
+		: m_Pool(NULL)
+		, m_Index(Invalid<Components::ComponentIndex>())
+		, m_Generation(0)
+	{
+
+	}
+
+	bool ComponentHandleBase::IsGood() const
+	{
+		return GetComponent() != NULL;
+	}
+
+	void ComponentHandleBase::Reset( Component *_component )
+	{
+		if (!_component)
+		{
+			m_Pool = NULL;
+			return;
+		}
+
+		m_Pool = Components::Pool::GetPool( _component );
+		m_Index = m_Pool->GetComponentIndex( _component );
+		m_Generation = m_Pool->GetHandleGeneration( m_Index );
+	}
+
+	Component* ComponentHandleBase::GetComponent() const
+	{
+		return m_Pool ? m_Pool->ResolveHandle( m_Index, m_Generation ) : NULL;
+	}
+
+	Component* ComponentHandleBase::UncheckedGetComponent() const
+	{
+		return m_Pool ? m_Pool->GetComponent( m_Index ) : NULL;
+	}
+
+	template <class T>
+	ComponentHandle<T>::ComponentHandle()
+	{
+
+	}
+
+	template <class T>
+	ComponentHandle<T>::ComponentHandle( T *_component )
+	{
+		Reset(_component);
+	}
+
+	template <class T>
+	void ComponentHandle<T>::operator=( T *_component )
+	{
+		Reset(_component);
+	}
+
+	template <class T>
+	T * ComponentHandle<T>::UncheckedGet() const
+	{
+		return static_cast<T*>(UncheckedGetComponent());
+	}
+
+	template <class T>
+	T * ComponentHandle<T>::Get() const
+	{
+		return static_cast<T*>(GetComponent());
+	}
+
+	template <class T>
+	T & ComponentHandle<T>::operator*() const
+	{
+		return *Get();
+	}
+
+	template <class T>
+	T * ComponentHandle<T>::operator->() const
+	{
+		return Get();
+	}
 }
@@ -61,6 +61,20 @@ void Entity::ClearSliceInfo()
 	SetInvalid( m_sliceIndex );
 }
 
+/// Set a callback to execute when this entity is destroyed.
+///
+/// The callback is executed by Slice::DestroyEntity() (for deferred destruction, at the end of the frame in which
+/// DeferredDestroy() was called) while the entity is still bound to its slice, so it can still reach its world and
+/// components.  Only one callback is kept.
+///
+/// @param[in] rOnDestroyed  Callback to execute when this entity is destroyed.
+///
+/// @see GetOnDestroyed()
+void Entity::SetOnDestroyed( const Delegate<Entity*>& rOnDestroyed )
+{
+	m_OnDestroyed = rOnDestroyed;
+}
+
 ComponentCollection& Helium::Entity::VirtualGetComponents()
 {
 	return GetComponents();
@@ -68,5 +82,6 @@ ComponentCollection& Helium::Entity::VirtualGetComponents()
 
 ComponentManager* Helium::Entity::VirtualGetComponentManager()
 {
-	return GetWorld()->GetComponentManager();
+	// Entities of a detached slice allocate from the slice's own pools
+	return m_spSlice ? m_spSlice->GetComponentManager() : NULL;
 }
@@ -2,6 +2,7 @@
 
 #include "Framework/Framework.h"
 
+#include "Foundation/Event.h"
 #include "Framework/Components.h"
 #include "Framework/ComponentSet.h"
 #include "Framework/Slice.h"
@@ -58,6 +59,12 @@ namespace Helium
 
 		void DeferredDestroy() { m_DeferredDestroy = true; }
 		bool IsDeferredDestroySet() { return m_DeferredDestroy; }
+
+		/// @name Destruction Notification
+		//@{
+		void SetOnDestroyed( const Delegate<Entity*>& rOnDestroyed );
+		inline const Delegate<Entity*>& GetOnDestroyed() const;
+		//@}
 		
 	private:
 		// Avoid using these vfuncs if you can! Use GetComponents() and GetWorld
@@ -74,6 +81,9 @@ namespace Helium
 		AssetPath m_DefinitionPath;
 
 		bool m_DeferredDestroy;
+
+		/// Callback executed when this entity is removed from its slice.
+		Delegate<Entity*> m_OnDestroyed;
 		
 	};
 	typedef Helium::StrongPtr<Entity> EntityPtr;
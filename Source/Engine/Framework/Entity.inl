@@ -22,6 +22,16 @@ namespace Helium
 		Components::DeployComponents(*this, _components );
 	}
 
+	/// Get the callback executed when this entity is removed from its slice.
+	///
+	/// @return  Entity destruction callback.
+	///
+	/// @see SetOnDestroyed()
+	const Delegate<Entity*>& Entity::GetOnDestroyed() const
+	{
+		return m_OnDestroyed;
+	}
+
 	template <class T>
 	T* Entity::GetFirst()
 	{
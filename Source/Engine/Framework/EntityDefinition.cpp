@@ -28,6 +28,7 @@ EntityDefinition::~EntityDefinition()
 void Helium::EntityDefinition::AddComponentDefinition( Helium::Name name, Helium::ComponentDefinition *pComponentDefinition )
 {
 	m_ComponentSet.AddComponentDefinition(name, pComponentDefinition);
+	m_Prefab.Clear();
 }
 
 Helium::EntityPtr Helium::EntityDefinition::CreateEntity()
@@ -39,6 +40,34 @@ void Helium::EntityDefinition::FinalizeEntity( Entity *pEntity, const ParameterS
 {
 	HELIUM_ASSERT(pEntity);
 	
-	pEntity->DeployComponents(m_Components);
-	pEntity->DeployComponents(m_ComponentSet, pParameterSet);
+	if (!m_Prefab.IsBaked())
+	{
+		BakePrefab();
+	}
+
+	m_Prefab.Deploy(*pEntity, pParameterSet);
+}
+
+void Helium::EntityDefinition::FinalizeEntityDeferred( Entity *pEntity, DynamicArray<Prefab::PendingFinalize> &rPending )
+{
+	HELIUM_ASSERT(pEntity);
+	
+	if (!m_Prefab.IsBaked())
+	{
+		BakePrefab();
+	}
+
+	m_Prefab.Deploy(*pEntity, NULL, &rPending);
+}
+
+void Helium::EntityDefinition::FinalizePendingEntity( const Prefab::PendingFinalize *pPending, size_t count )
+{
+	HELIUM_ASSERT(m_Prefab.IsBaked());
+
+	m_Prefab.FinalizePending(pPending, count);
+}
+
+void Helium::EntityDefinition::BakePrefab()
+{
+	m_Prefab.Bake(m_Components, m_ComponentSet);
 }
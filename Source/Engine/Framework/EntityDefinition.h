@@ -4,6 +4,7 @@
 #include "Framework/ComponentDefinition.h"
 #include "Framework/ComponentSet.h"
 #include "Framework/Entity.h"
+#include "Framework/Prefab.h"
 
 namespace Helium
 {
@@ -38,10 +39,21 @@ namespace Helium
 		EntityPtr CreateEntity();
 		void FinalizeEntity(Entity *pEntity, const ParameterSet *pParameterSet = NULL);
 
+		// Deferred form of FinalizeEntity() for entities built outside of their world (see Slice::BeginDetachedBuild()).
+		// Components are created and initialized right away, and finalized by FinalizePendingEntity() once in the world
+		void FinalizeEntityDeferred(Entity *pEntity, DynamicArray<Prefab::PendingFinalize> &rPending);
+		void FinalizePendingEntity(const Prefab::PendingFinalize *pPending, size_t count);
+
+		// FinalizeEntity() deploys from a prefab baked on first use. Bake ahead of time to keep the cost out of the
+		// first spawn, and clear it if the definitions are edited after spawning
+		void BakePrefab();
+		void ClearPrefab() { m_Prefab.Clear(); }
+
 	private:
 
 		ComponentSet m_ComponentSet;
 		DynamicArray<ComponentDefinitionPtr> m_Components;
+		Prefab m_Prefab;
 	};
 	typedef Helium::StrongPtr<EntityDefinition> EntityDefinitionPtr;
 }
@@ -56,3 +56,40 @@ void Helium::FlagSetDefinition::FinalizeLoad()
 		++m_FlagCount;
 	}
 }
+
+size_t Helium::FindMatchingFlags( const FlagMask *pFlags, size_t count, FlagMask required, FlagMask excluded, uint32_t *pIndices )
+{
+	HELIUM_ASSERT( pFlags || !count );
+	HELIUM_ASSERT( pIndices || !count );
+
+	const FlagMask tested = required | excluded;
+
+	// Every index is written and only kept if it matched, so there is no branch to mispredict. Four at a time to
+	// give the compiler independent loads to work with
+	size_t matchCount = 0;
+	size_t index = 0;
+	for ( ; index + 4 <= count; index += 4 )
+	{
+		const FlagMask flags0 = pFlags[ index ] & tested;
+		const FlagMask flags1 = pFlags[ index + 1 ] & tested;
+		const FlagMask flags2 = pFlags[ index + 2 ] & tested;
+		const FlagMask flags3 = pFlags[ index + 3 ] & tested;
+
+		pIndices[ matchCount ] = static_cast< uint32_t >( index );
+		matchCount += ( flags0 == required );
+		pIndices[ matchCount ] = static_cast< uint32_t >( index + 1 );
+		matchCount += ( flags1 == required );
+		pIndices[ matchCount ] = static_cast< uint32_t >( index + 2 );
+		matchCount += ( flags2 == required );
+		pIndices[ matchCount ] = static_cast< uint32_t >( index + 3 );
+		matchCount += ( flags3 == required );
+	}
+
+	for ( ; index < count; ++index )
+	{
+		pIndices[ matchCount ] = static_cast< uint32_t >( index );
+		matchCount += ( ( pFlags[ index ] & tested ) == required );
+	}
+
+	return matchCount;
+}
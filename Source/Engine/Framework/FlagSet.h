@@ -3,10 +3,25 @@
 #include "Framework/Framework.h"
 
 #include "Foundation/Numeric.h"
+#include "Foundation/HashMap.h"
 #include "Engine/Asset.h"
 
 namespace Helium
 {
+	// Flags are only looked up by name when data is loaded. Everything evaluated at runtime works on bitmasks
+	typedef uint64_t FlagMask;
+
+	// True if all the required flags are set and none of the excluded ones are
+	template <class T>
+	inline bool FlagsMatch( T flags, T required, T excluded )
+	{
+		return ( flags & ( required | excluded ) ) == required;
+	}
+
+	// Write the index of every element of pFlags matching the required and excluded flags to pIndices (which must
+	// have room for count indices), returning how many matched. Branch free so that it stays fast over long arrays
+	HELIUM_FRAMEWORK_API size_t FindMatchingFlags( const FlagMask *pFlags, size_t count, FlagMask required, FlagMask excluded, uint32_t *pIndices );
+
 	class HELIUM_FRAMEWORK_API FlagSetDefinition : public Helium::Asset
 	{
 		HELIUM_DECLARE_ASSET( FlagSetDefinition, Asset );
@@ -21,9 +36,9 @@ namespace Helium
 		}
 
 		template <class T>
-		bool GetFlag( const Name &name, T &flag )
+		bool GetFlag( const Name &name, T &flag ) const
 		{
-			HashMap<Name, uint64_t>::Iterator iter = m_FlagLookup.Find( name );
+			HashMap<Name, uint64_t>::ConstIterator iter = m_FlagLookup.Find( name );
 			
 			if ( iter == m_FlagLookup.End() )
 			{
@@ -38,7 +53,7 @@ namespace Helium
 		}
 
 		template <class T>
-		bool GetBitset( const DynamicArray<Name> &names, T &bitset )
+		bool GetBitset( const DynamicArray<Name> &names, T &bitset ) const
 		{
 			bitset = 0;
 			bool success = true;
@@ -79,11 +94,15 @@ namespace Helium
 			NUM_BITS_IN_BYTE = 8
 		};
 
+	public:
+		FlagSetT() : m_Flags( 0 ) { }
+
 		bool SupportsFlagSetDefinition( const FlagSetDefinition &flagSet ) const
 		{
 			return flagSet.GetFlagCount() <= ( sizeof(T) * NUM_BITS_IN_BYTE );
 		}
 
+		// Looks the flag up by name, so keep it out of hot loops. Resolve a mask with GetBitset() at load instead
 		bool HasFlag( const FlagSetDefinition *flagSet, const Name &name ) const
 		{
 			T bitfield;
@@ -92,6 +111,16 @@ namespace Helium
 			return ( flagExists && (m_Flags & bitfield) );
 		}
 
+		T GetFlags() const { return m_Flags; }
+		void SetFlags( T flags ) { m_Flags = flags; }
+		void AddFlags( T flags ) { m_Flags |= flags; }
+		void RemoveFlags( T flags ) { m_Flags &= ~flags; }
+
+		bool HasAll( T flags ) const { return ( m_Flags & flags ) == flags; }
+		bool HasAny( T flags ) const { return ( m_Flags & flags ) != 0; }
+		bool Matches( T required, T excluded ) const { return FlagsMatch( m_Flags, required, excluded ); }
+
+	private:
 		T m_Flags;
 	};
 
@@ -0,0 +1,733 @@
+#include "Platform/Timer.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FileStream.h"
+#include "Foundation/String.h"
+#include "Reflect/Registry.h"
+#include "Reflect/TranslatorDeduction.h"
+
+#include "Framework/Components.h"
+#include "Framework/ComponentQuery.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if HELIUM_OS_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Helium;
+
+// Microbenchmarks for the component system.
+//
+// Each benchmark runs over a scene of entities (component collections) that all carry a component of type A, with
+// some percentage also carrying B and C, at several entity counts and type mixes. Results are written to standard
+// output as one JSON object per line:
+//
+//     {"benchmark":"QueryComponents<A,B>","entities":10000,"mix":"50:25","iterations":...,"ns_per_op":...,"cache_misses_per_op":...}
+//
+// An "op" is one entity of the scene, whatever the benchmark does with it, so results are comparable across
+// benchmarks. Cache misses are read from the hardware counters where the OS exposes them (Linux perf events) and are
+// null elsewhere. Only the part of each kernel doing the work being measured is timed; set up and tear down are not.
+//
+// Arguments (all optional):
+//     <filter>                Run only benchmarks whose name contains this substring
+//     -entities=N[,N...]      Entity counts (default 1000,10000,100000)
+//     -mixes=B:C[,B:C...]     Percentages of entities also carrying B and C (default 100:100,50:25)
+//     -baseline=<path>        Output of an earlier run; each result then also reports the baseline time and the
+//                             relative change, so a proposed change can be checked against a committed baseline
+
+// Minimum time to spend measuring each benchmark at each entity count and mix, in seconds
+static const float64_t MIN_BENCHMARK_SECONDS = 0.25;
+
+// Sink for kernel results so that the compiler cannot discard the work being timed
+static volatile float32_t s_sink;
+
+namespace Helium
+{
+	// Component carried by every benchmark entity
+	struct BenchmarkComponentA : public Component
+	{
+		HELIUM_DECLARE_COMPONENT( Helium::BenchmarkComponentA, Helium::Component );
+		static void PopulateMetaType( Reflect::MetaStruct& comp ) { }
+
+		float32_t m_Values[ 4 ];
+	};
+
+	// Component carried by a configurable share of the benchmark entities
+	struct BenchmarkComponentB : public Component
+	{
+		HELIUM_DECLARE_COMPONENT( Helium::BenchmarkComponentB, Helium::Component );
+		static void PopulateMetaType( Reflect::MetaStruct& comp ) { }
+
+		float32_t m_Values[ 8 ];
+	};
+
+	// Component carried by a configurable share of the benchmark entities
+	struct BenchmarkComponentC : public Component
+	{
+		HELIUM_DECLARE_COMPONENT( Helium::BenchmarkComponentC, Helium::Component );
+		static void PopulateMetaType( Reflect::MetaStruct& comp ) { }
+
+		float32_t m_Values[ 2 ];
+	};
+}
+
+HELIUM_DEFINE_COMPONENT( Helium::BenchmarkComponentA, 1024 );
+HELIUM_DEFINE_COMPONENT( Helium::BenchmarkComponentB, 1024 );
+HELIUM_DEFINE_COMPONENT( Helium::BenchmarkComponentC, 1024 );
+
+// Share of the entities carrying each optional component type
+struct TypeMix
+{
+	uint32_t m_PercentB;
+	uint32_t m_PercentC;
+};
+
+// Entities and references the kernels run over
+struct BenchmarkScene
+{
+	ComponentManagerPtr                                    m_spManager;
+	DynamicArray< ComponentCollection >                    m_Collections;
+	DynamicArray< ComponentPtr< BenchmarkComponentA > >    m_Ptrs;        //< Pointers to every A, in shuffled order
+	DynamicArray< ComponentHandle< BenchmarkComponentA > > m_Handles;     //< Handles to every A, in shuffled order
+
+	// Allocation benchmarks use their own manager so that the scene above is left untouched
+	ComponentManagerPtr                                    m_spScratchManager;
+	DynamicArray< ComponentCollection >                    m_ScratchCollections;
+};
+
+// Hardware cache miss counter, or -1 if not available
+static int s_CacheMissCounter = -1;
+
+static void OpenCacheMissCounter()
+{
+#if HELIUM_OS_LINUX
+	perf_event_attr attributes;
+	memset( &attributes, 0, sizeof( attributes ) );
+	attributes.type = PERF_TYPE_HARDWARE;
+	attributes.size = sizeof( attributes );
+	attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+	attributes.exclude_kernel = 1;
+	attributes.exclude_hv = 1;
+
+	s_CacheMissCounter = static_cast< int >( syscall( __NR_perf_event_open, &attributes, 0, -1, -1, 0 ) );
+	if ( s_CacheMissCounter >= 0 )
+	{
+		ioctl( s_CacheMissCounter, PERF_EVENT_IOC_RESET, 0 );
+		ioctl( s_CacheMissCounter, PERF_EVENT_IOC_ENABLE, 0 );
+	}
+#endif
+}
+
+static void CloseCacheMissCounter()
+{
+#if HELIUM_OS_LINUX
+	if ( s_CacheMissCounter >= 0 )
+	{
+		close( s_CacheMissCounter );
+		s_CacheMissCounter = -1;
+	}
+#endif
+}
+
+static uint64_t ReadCacheMissCounter()
+{
+	uint64_t count = 0;
+#if HELIUM_OS_LINUX
+	if ( s_CacheMissCounter >= 0 && read( s_CacheMissCounter, &count, sizeof( count ) ) != sizeof( count ) )
+	{
+		count = 0;
+	}
+#endif
+	return count;
+}
+
+// Ticks and cache misses accumulated over the measured parts of kernel runs. The counter is read outside of the
+// timed span so that the system call is not part of the timing
+struct Measurement
+{
+	uint64_t m_Ticks;
+	uint64_t m_CacheMisses;
+	uint64_t m_StartTicks;
+	uint64_t m_StartCacheMisses;
+
+	Measurement()
+		: m_Ticks( 0 )
+		, m_CacheMisses( 0 )
+		, m_StartTicks( 0 )
+		, m_StartCacheMisses( 0 )
+	{
+	}
+
+	void Start()
+	{
+		m_StartCacheMisses = ReadCacheMissCounter();
+		m_StartTicks = Timer::GetTickCount();
+	}
+
+	void Stop()
+	{
+		m_Ticks += Timer::GetTickCount() - m_StartTicks;
+		m_CacheMisses += ReadCacheMissCounter() - m_StartCacheMisses;
+	}
+};
+
+// Kernel callback. Brackets the work being measured with rMeasurement.Start() and Stop()
+typedef void ( *KERNEL_CALLBACK )( BenchmarkScene &rScene, Measurement &rMeasurement );
+
+// Get a deterministic pseudo-random value in the range [0, 100)
+static uint32_t GetRandomPercent( uint32_t &rSeed )
+{
+	rSeed = rSeed * 1664525 + 1013904223;
+
+	return ( rSeed >> 8 ) % 100;
+}
+
+static void BuildScene( BenchmarkScene &rScene, size_t entityCount, const TypeMix &rMix )
+{
+	rScene.m_spManager = Components::CreateManager( NULL );
+	rScene.m_spScratchManager = Components::CreateManager( NULL );
+
+	ComponentManager &rManager = *rScene.m_spManager.Ptr();
+
+	rScene.m_Collections.Resize( entityCount );
+	rScene.m_ScratchCollections.Resize( entityCount );
+	rScene.m_Ptrs.Resize( entityCount );
+	rScene.m_Handles.Resize( entityCount );
+
+	DynamicArray< BenchmarkComponentA* > components;
+	components.Reserve( entityCount );
+
+	uint32_t seed = 1;
+	for ( size_t index = 0; index < entityCount; ++index )
+	{
+		ComponentCollection &rCollection = rScene.m_Collections[ index ];
+
+		BenchmarkComponentA *pA = rManager.Allocate< BenchmarkComponentA >( NULL, rCollection );
+		HELIUM_ASSERT( pA );
+		pA->m_Values[ 0 ] = static_cast< float32_t >( index );
+		components.Push( pA );
+
+		if ( GetRandomPercent( seed ) < rMix.m_PercentB )
+		{
+			BenchmarkComponentB *pB = rManager.Allocate< BenchmarkComponentB >( NULL, rCollection );
+			HELIUM_ASSERT( pB );
+			pB->m_Values[ 0 ] = 1.0f;
+		}
+
+		if ( GetRandomPercent( seed ) < rMix.m_PercentC )
+		{
+			BenchmarkComponentC *pC = rManager.Allocate< BenchmarkComponentC >( NULL, rCollection );
+			HELIUM_ASSERT( pC );
+			pC->m_Values[ 0 ] = 2.0f;
+		}
+	}
+
+	// References are followed between unrelated entities in practice, so resolve them in a shuffled order
+	for ( size_t index = entityCount; index > 1; --index )
+	{
+		seed = seed * 1664525 + 1013904223;
+		size_t swapIndex = ( seed >> 8 ) % index;
+
+		BenchmarkComponentA *pSwap = components[ index - 1 ];
+		components[ index - 1 ] = components[ swapIndex ];
+		components[ swapIndex ] = pSwap;
+	}
+
+	for ( size_t index = 0; index < entityCount; ++index )
+	{
+		rScene.m_Ptrs[ index ] = components[ index ];
+		rScene.m_Handles[ index ] = components[ index ];
+	}
+}
+
+static void DestroyScene( BenchmarkScene &rScene )
+{
+	rScene.m_Ptrs.Clear();
+	rScene.m_Handles.Clear();
+
+	for ( size_t index = 0; index < rScene.m_Collections.GetSize(); ++index )
+	{
+		rScene.m_Collections[ index ].ReleaseAll();
+	}
+
+	rScene.m_Collections.Clear();
+	rScene.m_ScratchCollections.Clear();
+	rScene.m_spManager.Reset();
+	rScene.m_spScratchManager.Reset();
+}
+
+// Allocate an A in every scratch collection, measuring the allocations
+static void AllocateKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	ComponentManager &rManager = *rScene.m_spScratchManager.Ptr();
+	const size_t entityCount = rScene.m_ScratchCollections.GetSize();
+
+	rMeasurement.Start();
+	for ( size_t index = 0; index < entityCount; ++index )
+	{
+		rManager.Allocate< BenchmarkComponentA >( NULL, rScene.m_ScratchCollections[ index ] );
+	}
+	rMeasurement.Stop();
+
+	for ( size_t index = 0; index < entityCount; ++index )
+	{
+		rScene.m_ScratchCollections[ index ].ReleaseAll();
+	}
+}
+
+// Allocate an A in every scratch collection, measuring the frees
+static void FreeKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	ComponentManager &rManager = *rScene.m_spScratchManager.Ptr();
+	const size_t entityCount = rScene.m_ScratchCollections.GetSize();
+
+	for ( size_t index = 0; index < entityCount; ++index )
+	{
+		rManager.Allocate< BenchmarkComponentA >( NULL, rScene.m_ScratchCollections[ index ] );
+	}
+
+	rMeasurement.Start();
+	for ( size_t index = 0; index < entityCount; ++index )
+	{
+		rScene.m_ScratchCollections[ index ].ReleaseAll();
+	}
+	rMeasurement.Stop();
+}
+
+// Walk the pool of A
+static void IterateKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	float32_t sum = 0.0f;
+
+	rMeasurement.Start();
+	for ( ComponentIteratorT< BenchmarkComponentA > iterator( *rScene.m_spManager.Ptr() ); iterator.GetBaseComponent(); iterator.Advance() )
+	{
+		sum += iterator->m_Values[ 0 ];
+	}
+	rMeasurement.Stop();
+
+	s_sink = sum;
+}
+
+static void QueryOneKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	float32_t sum = 0.0f;
+
+	rMeasurement.Start();
+	QueryComponents< const BenchmarkComponentA >( *rScene.m_spManager.Ptr(), [&sum]( const BenchmarkComponentA *pA )
+	{
+		sum += pA->m_Values[ 0 ];
+	} );
+	rMeasurement.Stop();
+
+	s_sink = sum;
+}
+
+static void QueryTwoKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	float32_t sum = 0.0f;
+
+	rMeasurement.Start();
+	QueryComponents< const BenchmarkComponentA, const BenchmarkComponentB >(
+		*rScene.m_spManager.Ptr(), [&sum]( const BenchmarkComponentA *pA, const BenchmarkComponentB *pB )
+	{
+		sum += pA->m_Values[ 0 ] * pB->m_Values[ 0 ];
+	} );
+	rMeasurement.Stop();
+
+	s_sink = sum;
+}
+
+static void QueryThreeKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	float32_t sum = 0.0f;
+
+	rMeasurement.Start();
+	QueryComponents< const BenchmarkComponentA, const BenchmarkComponentB, const BenchmarkComponentC >(
+		*rScene.m_spManager.Ptr(), [&sum]( const BenchmarkComponentA *pA, const BenchmarkComponentB *pB, const BenchmarkComponentC *pC )
+	{
+		sum += pA->m_Values[ 0 ] * pB->m_Values[ 0 ] + pC->m_Values[ 0 ];
+	} );
+	rMeasurement.Stop();
+
+	s_sink = sum;
+}
+
+static void ComponentPtrKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	float32_t sum = 0.0f;
+	const size_t ptrCount = rScene.m_Ptrs.GetSize();
+
+	rMeasurement.Start();
+	for ( size_t index = 0; index < ptrCount; ++index )
+	{
+		sum += rScene.m_Ptrs[ index ].Get()->m_Values[ 0 ];
+	}
+	rMeasurement.Stop();
+
+	s_sink = sum;
+}
+
+static void ComponentHandleKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	float32_t sum = 0.0f;
+	const size_t handleCount = rScene.m_Handles.GetSize();
+
+	rMeasurement.Start();
+	for ( size_t index = 0; index < handleCount; ++index )
+	{
+		sum += rScene.m_Handles[ index ].Get()->m_Values[ 0 ];
+	}
+	rMeasurement.Stop();
+
+	s_sink = sum;
+}
+
+// Look up B in every collection (present in only some of them, depending on the mix)
+static void CollectionLookupKernel( BenchmarkScene &rScene, Measurement &rMeasurement )
+{
+	float32_t sum = 0.0f;
+	const size_t collectionCount = rScene.m_Collections.GetSize();
+
+	rMeasurement.Start();
+	for ( size_t index = 0; index < collectionCount; ++index )
+	{
+		BenchmarkComponentB *pB = rScene.m_Collections[ index ].GetFirst< BenchmarkComponentB >();
+		if ( pB )
+		{
+			sum += pB->m_Values[ 0 ];
+		}
+	}
+	rMeasurement.Stop();
+
+	s_sink = sum;
+}
+
+// Result of an earlier run
+struct BaselineResult
+{
+	String    m_Key;
+	float64_t m_NanosecondsPerOp;
+};
+
+static void GetResultKey( String &rKey, const char *pName, size_t entityCount, const char *pMix )
+{
+	rKey.Format( "%s|%u|%s", pName, static_cast< unsigned int >( entityCount ), pMix );
+}
+
+// Copy the string value of a JSON field from a single result line
+static bool GetStringField( const char *pLine, const char *pField, char *pValue, size_t valueSize )
+{
+	const char *pStart = strstr( pLine, pField );
+	if ( !pStart )
+	{
+		return false;
+	}
+
+	pStart += strlen( pField );
+	const char *pEnd = strchr( pStart, '"' );
+	if ( !pEnd || static_cast< size_t >( pEnd - pStart ) >= valueSize )
+	{
+		return false;
+	}
+
+	memcpy( pValue, pStart, pEnd - pStart );
+	pValue[ pEnd - pStart ] = '\0';
+
+	return true;
+}
+
+// Load the results of an earlier run, as written to standard output by this program
+static bool LoadBaseline( const char *pPath, DynamicArray< BaselineResult > &rResults )
+{
+	FileStream *pFileStream = FileStream::OpenFileStream( pPath, FileStream::MODE_READ );
+	if ( !pFileStream )
+	{
+		fprintf( stderr, "Could not open baseline file '%s'.\n", pPath );
+		return false;
+	}
+
+	int64_t size64 = pFileStream->GetSize();
+	DynamicArray< char > data;
+	if ( size64 > 0 )
+	{
+		data.Resize( static_cast< size_t >( size64 ) );
+		data.Resize( pFileStream->Read( data.GetData(), 1, data.GetSize() ) );
+	}
+
+	delete pFileStream;
+
+	// Terminate every line so that each can be scanned as a string
+	data.Push( '\0' );
+	for ( size_t index = 0; index < data.GetSize(); ++index )
+	{
+		if ( data[ index ] == '\n' || data[ index ] == '\r' )
+		{
+			data[ index ] = '\0';
+		}
+	}
+
+	for ( size_t lineStart = 0; lineStart < data.GetSize(); lineStart += strlen( &data[ lineStart ] ) + 1 )
+	{
+		const char *pLine = &data[ lineStart ];
+
+		char name[ 128 ];
+		char mix[ 32 ];
+		const char *pEntities = strstr( pLine, "\"entities\":" );
+		const char *pNanoseconds = strstr( pLine, "\"ns_per_op\":" );
+		if ( !pEntities || !pNanoseconds ||
+			!GetStringField( pLine, "\"benchmark\":\"", name, sizeof( name ) ) ||
+			!GetStringField( pLine, "\"mix\":\"", mix, sizeof( mix ) ) )
+		{
+			continue;
+		}
+
+		BaselineResult *pResult = rResults.New();
+		HELIUM_ASSERT( pResult );
+		GetResultKey( pResult->m_Key, name, strtoul( pEntities + strlen( "\"entities\":" ), NULL, 10 ), mix );
+		pResult->m_NanosecondsPerOp = strtod( pNanoseconds + strlen( "\"ns_per_op\":" ), NULL );
+	}
+
+	return true;
+}
+
+// Time a kernel over a scene and print the result
+static void RunBenchmark(
+	const char *pName,
+	KERNEL_CALLBACK pCallback,
+	BenchmarkScene &rScene,
+	const char *pMix,
+	const DynamicArray< BaselineResult > &rBaseline )
+{
+	const size_t entityCount = rScene.m_Collections.GetSize();
+
+	// Warm the caches, branch predictors and pools before measuring
+	{
+		Measurement warmup;
+		pCallback( rScene, warmup );
+	}
+
+	const uint64_t minTicks =
+		static_cast< uint64_t >( MIN_BENCHMARK_SECONDS * static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+
+	// Double the iteration count until a single measured run is long enough to swamp the timer resolution
+	uint64_t iterationCount = 1;
+	Measurement measurement;
+	for ( ; ; )
+	{
+		measurement = Measurement();
+		for ( uint64_t iteration = 0; iteration < iterationCount; ++iteration )
+		{
+			pCallback( rScene, measurement );
+		}
+
+		if ( measurement.m_Ticks >= minTicks )
+		{
+			break;
+		}
+
+		iterationCount *= 2;
+	}
+
+	float64_t opCount = static_cast< float64_t >( iterationCount ) * static_cast< float64_t >( entityCount );
+	float64_t nanosecondsPerOp = static_cast< float64_t >( measurement.m_Ticks ) * Timer::GetSecondsPerTick() * 1.0e9 / opCount;
+
+	printf(
+		"{\"benchmark\":\"%s\",\"entities\":%u,\"mix\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.3f",
+		pName,
+		static_cast< unsigned int >( entityCount ),
+		pMix,
+		static_cast< unsigned long long >( iterationCount ),
+		nanosecondsPerOp );
+
+	if ( s_CacheMissCounter >= 0 )
+	{
+		printf( ",\"cache_misses_per_op\":%.3f", static_cast< float64_t >( measurement.m_CacheMisses ) / opCount );
+	}
+	else
+	{
+		printf( ",\"cache_misses_per_op\":null" );
+	}
+
+	String key;
+	GetResultKey( key, pName, entityCount, pMix );
+	for ( size_t index = 0; index < rBaseline.GetSize(); ++index )
+	{
+		const BaselineResult &rResult = rBaseline[ index ];
+		if ( rResult.m_Key == key && rResult.m_NanosecondsPerOp > 0.0 )
+		{
+			printf(
+				",\"baseline_ns_per_op\":%.3f,\"change\":%.4f",
+				rResult.m_NanosecondsPerOp,
+				nanosecondsPerOp / rResult.m_NanosecondsPerOp - 1.0 );
+			break;
+		}
+	}
+
+	printf( "}\n" );
+	fflush( stdout );
+}
+
+// Parse a comma-separated list of entity counts
+static bool ParseEntityCounts( const char *pList, DynamicArray< size_t > &rCounts )
+{
+	rCounts.Clear();
+	for ( const char *pItem = pList; *pItem; )
+	{
+		char *pEnd = NULL;
+		unsigned long count = strtoul( pItem, &pEnd, 10 );
+		if ( pEnd == pItem || count == 0 || ( *pEnd && *pEnd != ',' ) )
+		{
+			return false;
+		}
+
+		rCounts.Push( static_cast< size_t >( count ) );
+		pItem = ( *pEnd ? pEnd + 1 : pEnd );
+	}
+
+	return !rCounts.IsEmpty();
+}
+
+// Parse a comma-separated list of B:C percentage pairs
+static bool ParseMixes( const char *pList, DynamicArray< TypeMix > &rMixes )
+{
+	rMixes.Clear();
+	for ( const char *pItem = pList; *pItem; )
+	{
+		char *pEnd = NULL;
+		unsigned long percentB = strtoul( pItem, &pEnd, 10 );
+		if ( pEnd == pItem || *pEnd != ':' || percentB > 100 )
+		{
+			return false;
+		}
+
+		pItem = pEnd + 1;
+		unsigned long percentC = strtoul( pItem, &pEnd, 10 );
+		if ( pEnd == pItem || ( *pEnd && *pEnd != ',' ) || percentC > 100 )
+		{
+			return false;
+		}
+
+		TypeMix mix;
+		mix.m_PercentB = static_cast< uint32_t >( percentB );
+		mix.m_PercentC = static_cast< uint32_t >( percentC );
+		rMixes.Push( mix );
+		pItem = ( *pEnd ? pEnd + 1 : pEnd );
+	}
+
+	return !rMixes.IsEmpty();
+}
+
+// Benchmark to run
+struct BenchmarkEntry
+{
+	const char*     pName;
+	KERNEL_CALLBACK pCallback;
+};
+
+int main( int argc, const char* argv[] )
+{
+	const char* pFilter = NULL;
+	const char* pBaselinePath = NULL;
+
+	DynamicArray< size_t > entityCounts;
+	entityCounts.Push( 1000 );
+	entityCounts.Push( 10000 );
+	entityCounts.Push( 100000 );
+
+	DynamicArray< TypeMix > mixes;
+	TypeMix fullMix = { 100, 100 };
+	TypeMix partialMix = { 50, 25 };
+	mixes.Push( fullMix );
+	mixes.Push( partialMix );
+
+	for ( int argIndex = 1; argIndex < argc; ++argIndex )
+	{
+		const char* pArg = argv[ argIndex ];
+		if ( !strncmp( pArg, "-entities=", 10 ) )
+		{
+			if ( !ParseEntityCounts( pArg + 10, entityCounts ) )
+			{
+				fprintf( stderr, "Invalid entity counts '%s'.\n", pArg + 10 );
+				return 1;
+			}
+		}
+		else if ( !strncmp( pArg, "-mixes=", 7 ) )
+		{
+			if ( !ParseMixes( pArg + 7, mixes ) )
+			{
+				fprintf( stderr, "Invalid type mixes '%s'.\n", pArg + 7 );
+				return 1;
+			}
+		}
+		else if ( !strncmp( pArg, "-baseline=", 10 ) )
+		{
+			pBaselinePath = pArg + 10;
+		}
+		else
+		{
+			pFilter = pArg;
+		}
+	}
+
+	DynamicArray< BaselineResult > baseline;
+	if ( pBaselinePath && !LoadBaseline( pBaselinePath, baseline ) )
+	{
+		return 1;
+	}
+
+	Reflect::Startup();
+	Components::Startup( NULL );
+	OpenCacheMissCounter();
+
+	const BenchmarkEntry benchmarks[] =
+	{
+		{ "Components::Allocate", AllocateKernel },
+		{ "Components::Free", FreeKernel },
+		{ "ComponentIteratorT<A>", IterateKernel },
+		{ "QueryComponents<A>", QueryOneKernel },
+		{ "QueryComponents<A,B>", QueryTwoKernel },
+		{ "QueryComponents<A,B,C>", QueryThreeKernel },
+		{ "ComponentPtr::Get", ComponentPtrKernel },
+		{ "ComponentHandle::Get", ComponentHandleKernel },
+		{ "ComponentCollection::GetFirst<B>", CollectionLookupKernel },
+	};
+
+	for ( size_t mixIndex = 0; mixIndex < mixes.GetSize(); ++mixIndex )
+	{
+		const TypeMix &rMix = mixes[ mixIndex ];
+
+		String mixName;
+		mixName.Format( "%u:%u", rMix.m_PercentB, rMix.m_PercentC );
+
+		for ( size_t countIndex = 0; countIndex < entityCounts.GetSize(); ++countIndex )
+		{
+			BenchmarkScene scene;
+			BuildScene( scene, entityCounts[ countIndex ], rMix );
+
+			for ( size_t benchmarkIndex = 0; benchmarkIndex < HELIUM_ARRAY_COUNT( benchmarks ); ++benchmarkIndex )
+			{
+				const BenchmarkEntry& rBenchmark = benchmarks[ benchmarkIndex ];
+				if ( pFilter && !strstr( rBenchmark.pName, pFilter ) )
+				{
+					continue;
+				}
+
+				RunBenchmark( rBenchmark.pName, rBenchmark.pCallback, scene, *mixName, baseline );
+			}
+
+			DestroyScene( scene );
+		}
+	}
+
+	CloseCacheMissCounter();
+	Components::Shutdown();
+	Reflect::Shutdown();
+
+	return 0;
+}
@@ -3,14 +3,21 @@
 
 #include "Engine/AsyncLoader.h"
 #include "Engine/FileLocations.h"
+#include "Engine/FrameProfiler.h"
+#include "Engine/FrameArena.h"
+#include "Engine/SmallObjectHeap.h"
+#include "Engine/MemoryTelemetry.h"
 #include "Foundation/FilePath.h"
 #include "Foundation/DirectoryIterator.h"
 #include "Reflect/Registry.h"
 #include "Persist/Archive.h"
 #include "Platform/Timer.h"
+#include "Platform/Thread.h"
 #include "Platform/Process.h"
 #include "Engine/Config.h"
 #include "Engine/CacheManager.h"
+#include "Engine/ResidencyManager.h"
+#include "EngineJobs/JobManager.h"
 #include "Framework/MemoryHeapPreInitialization.h"
 #include "Framework/AssetLoaderInitialization.h"
 #include "Framework/ConfigInitialization.h"
@@ -20,6 +27,7 @@
 #include "Framework/WorldManager.h"
 #include "Framework/SceneDefinition.h"
 #include "Framework/TaskScheduler.h"
+#include "Framework/Benchmark.h"
 
 #if !HELIUM_SHARED
 namespace Helium
@@ -33,6 +41,14 @@ using namespace Helium;
 static uint32_t g_InitCount = 0;
 GameSystem* GameSystem::sm_pInstance = NULL;
 
+/// Constructor.
+HeadlessParameters::HeadlessParameters()
+: bEnabled( false )
+, tickRate( DEFAULT_TICK_RATE )
+, worldCount( 1 )
+{
+}
+
 /// Constructor.
 GameSystem::GameSystem()
 : m_pAssetLoaderInitialization( NULL )
@@ -55,6 +71,9 @@ GameSystem::GameSystem()
 /// @param[in] rRendererInitialization       Interface for creating and initializing the global renderer instance.
 /// @param[in] pWorldType                    Type of World to create for the main world.  If this is null, the
 ///                                          actual World type will be used.
+///
+/// If headless mode was set with SetHeadlessParameters(), the window manager and renderer are not initialized, so
+/// no render resources are loaded, and only gameplay tasks are scheduled.
 bool GameSystem::Initialize(
 	MemoryHeapPreInitialization& rMemoryHeapPreInitialization,
 	AssetLoaderInitialization& rAssetLoaderInitialization,
@@ -87,8 +106,11 @@ bool GameSystem::Initialize(
 	Asset::s_CheckPreDestroy = checkPreDestroy;
 #endif
 
+	InitEngineJobsDefaultHeap();
+	JobManager::Startup();
 	AsyncLoader::Startup();
 	CacheManager::Startup();
+	ResidencyManager::Startup();
 	Reflect::Startup();
 	Persist::Startup();
 
@@ -97,12 +119,18 @@ bool GameSystem::Initialize(
 
 	m_pAssetLoaderInitialization = &rAssetLoaderInitialization;
 
+	// Spread object deserialization and reference linking across the job workers.
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+	if( pAssetLoader )
+	{
+		pAssetLoader->SetParallelFor( JobManager::ParallelFor );
+	}
+
 	rConfigInitialization.Startup();
 
 	if ( !rSystemDefinitionPath.IsEmpty() )
 	{
-		AssetLoader* pAssetLoader = AssetLoader::GetInstance();
-		HELIUM_ASSERT( pAssetLoader );
 		if( !pAssetLoader )
 		{
 			HELIUM_TRACE( TraceLevels::Error, "GameSystem::Initialize(): Asset loader initialization failed.\n" );
@@ -122,25 +150,55 @@ bool GameSystem::Initialize(
 
 	Components::Startup( m_spSystemDefinition.Get() );
 
-	TaskScheduler::CalculateSchedule( TickTypes::RenderingGame, m_Schedule );
+	bool bHeadless = IsHeadless();
+	uint32_t tickType = bHeadless ? TickTypes::HeadlessGame : TickTypes::RenderingGame;
 
-	rWindowManagerInitialization.Startup();
-	m_pWindowManagerInitialization = &rWindowManagerInitialization;
-	
-	// Create and initialize the renderer.
-	bool bRendererInitSuccess = rRendererInitialization.Initialize();
-	HELIUM_ASSERT( bRendererInitSuccess );
-	if( !bRendererInitSuccess )
+	// Reuse the schedule saved by a previous run if no task contract has changed since.
+	FilePath scheduleCachePath;
+	bool bHaveScheduleCachePath = TaskScheduler::GetScheduleCachePath( tickType, scheduleCachePath );
+	if( !bHaveScheduleCachePath || !TaskScheduler::LoadSchedule( tickType, scheduleCachePath, m_Schedule ) )
 	{
-		HELIUM_TRACE( TraceLevels::Error, "GameSystem::Initialize(): Renderer initialization failed.\n" );
+		if( TaskScheduler::CalculateSchedule( tickType, m_Schedule ) && bHaveScheduleCachePath )
+		{
+			TaskScheduler::SaveSchedule( tickType, m_Schedule, scheduleCachePath );
+		}
+	}
 
-		return false;
+	if( bHeadless )
+	{
+		// Without a renderer, graphics assets skip loading their render resource data.
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"GameSystem::Initialize(): Running headless at %" PRIu32 " ticks per second.\n",
+			m_headlessParameters.tickRate );
 	}
+	else
+	{
+		rWindowManagerInitialization.Startup();
+		m_pWindowManagerInitialization = &rWindowManagerInitialization;
+	
+		// Create and initialize the renderer.
+		bool bRendererInitSuccess = rRendererInitialization.Initialize();
+		HELIUM_ASSERT( bRendererInitSuccess );
+		if( !bRendererInitSuccess )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "GameSystem::Initialize(): Renderer initialization failed.\n" );
+
+			return false;
+		}
 
-	m_pRendererInitialization = &rRendererInitialization;
+		m_pRendererInitialization = &rRendererInitialization;
+	}
 	
 	WorldManager::Startup();
 
+	if( bHeadless )
+	{
+		WorldManager* pWorldManager = WorldManager::GetInstance();
+		HELIUM_ASSERT( pWorldManager );
+		pWorldManager->SetFixedFrameDeltaSeconds( 1.0f / static_cast< float32_t >( m_headlessParameters.tickRate ) );
+	}
+
 	// Initialization complete.
 	return true;
 }
@@ -184,7 +242,24 @@ void GameSystem::Cleanup()
 	Reflect::Shutdown();
 	AssetType::Shutdown();
 	Asset::Shutdown();
+	ResidencyManager::Shutdown();
 	AsyncLoader::Shutdown();
+	JobManager::Shutdown();
+	FrameArena::Shutdown();
+	SmallObjectHeap::Shutdown();
+
+	// Leave a trace of the last recorded frames for chrome://tracing if the profiler was enabled.
+	if( FrameProfiler::IsEnabled() )
+	{
+		FilePath userDirectory;
+		if( FileLocations::GetUserDirectory( userDirectory ) )
+		{
+			FrameProfiler::WriteChromeTrace( FilePath( userDirectory.Get() + "FrameProfile.json" ) );
+		}
+	}
+
+	FrameProfiler::Shutdown();
+	MemoryTelemetry::Shutdown();
 
 	Reflect::ObjectRefCountSupport::Shutdown();
 
@@ -196,24 +271,111 @@ void GameSystem::Cleanup()
 
 /// Run the application loop.
 ///
-/// This will not return until the application is ready to shut down and terminate.
+/// This will not return until the application is ready to shut down and terminate.  When running headless, each
+/// frame is a single gameplay tick, and the loop sleeps between ticks to hold the tick rate.  Ticks that run late
+/// are not skipped; the following ticks start immediately until the loop has caught up.
+///
+/// If a hitch capture threshold was set with SetHitchCaptureParameters(), the most recent frames are written to a
+/// trace file each time a frame runs over it.
 ///
 /// @return  Result code of application execution.
 int32_t GameSystem::Run()
 {
+	FrameProfiler::SetThreadName( "Main" );
+
+	bool bHeadless = IsHeadless();
+	uint64_t tickIntervalTicks = 0;
+	uint64_t nextTickTickCount = Timer::GetTickCount();
+	if( bHeadless )
+	{
+		tickIntervalTicks = Timer::GetTicksPerSecond() / m_headlessParameters.tickRate;
+	}
+
+	HitchCapture hitchCapture( m_hitchCaptureParameters );
+	hitchCapture.Begin();
+
 	while ( !m_bStopRunning )
 	{
+		if( bHeadless )
+		{
+			uint64_t tickCount = Timer::GetTickCount();
+			if( tickCount < nextTickTickCount )
+			{
+				uint64_t sleepMilliseconds =
+					( ( nextTickTickCount - tickCount ) * 1000 ) / Timer::GetTicksPerSecond();
+				if( sleepMilliseconds != 0 )
+				{
+					Thread::Sleep( static_cast< uint32_t >( sleepMilliseconds ) );
+				}
+
+				continue;
+			}
+
+			nextTickTickCount += tickIntervalTicks;
+		}
+
+		hitchCapture.BeginFrame();
+
+		{
+			HELIUM_FRAME_PROFILER_SCOPE( "Frame" );
+
+			AssetLoader::GetInstance()->Tick();
+			m_AssetSyncUtility.Sync();
+
+			WorldManager* pWorldManager = WorldManager::GetInstance();
+			HELIUM_ASSERT( pWorldManager );
+			pWorldManager->Update( m_Schedule );
+		}
+
+		hitchCapture.EndFrame( m_Schedule );
+	}
+
+	hitchCapture.End();
+
+	m_bStopRunning = false;
+
+	return 0;
+}
+
+/// Run the application loop for the frames of a benchmark, then write the benchmark results.
+///
+/// @param[in] rBenchmark  Benchmark to run.
+///
+/// @return  Result code of the application (zero if the benchmark completed and its results were written).
+int32_t GameSystem::RunBenchmark( Benchmark& rBenchmark )
+{
+	FrameProfiler::SetThreadName( "Main" );
+
+	WorldManager* pWorldManager = WorldManager::GetInstance();
+	HELIUM_ASSERT( pWorldManager );
+
+	rBenchmark.Begin();
+
+	while ( !m_bStopRunning && !rBenchmark.IsComplete() )
+	{
+		HELIUM_FRAME_PROFILER_SCOPE( "Frame" );
+
+		rBenchmark.BeginFrame();
+
 		AssetLoader::GetInstance()->Tick();
 		m_AssetSyncUtility.Sync();
 
-		WorldManager* pWorldManager = WorldManager::GetInstance();
-		HELIUM_ASSERT( pWorldManager );
 		pWorldManager->Update( m_Schedule );
+
+		rBenchmark.EndFrame( m_Schedule );
 	}
 
+	rBenchmark.End();
+
+	bool bCompleted = rBenchmark.IsComplete();
 	m_bStopRunning = false;
 
-	return 0;
+	if ( !bCompleted )
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "GameSystem::RunBenchmark(): Application stopped before the benchmark completed.\n" );
+	}
+
+	return ( rBenchmark.WriteResults() && bCompleted ) ? 0 : 1;
 }
 
 /// Get the singleton GameSystem instance.
@@ -252,6 +414,104 @@ void GameSystem::Shutdown()
 	}
 }
 
+/// Read headless mode settings from the application command line.
+///
+/// Recognized arguments are "-headless" (run headless), "-tickrate <ticks per second>", and "-worlds <count>".  Other
+/// arguments are ignored.
+///
+/// @param[in]  argc         Number of command line arguments.
+/// @param[in]  argv         Command line arguments, including the program name.
+/// @param[out] rParameters  Settings read from the command line.  Settings not given keep their current values.
+///
+/// @return  True if "-headless" was given, false if not.
+bool GameSystem::ParseHeadlessCommandLine( int argc, const char* const* argv, HeadlessParameters& rParameters )
+{
+	HELIUM_ASSERT( argc == 0 || argv );
+
+	for( int argumentIndex = 1; argumentIndex < argc; ++argumentIndex )
+	{
+		const char* pArgument = argv[ argumentIndex ];
+		HELIUM_ASSERT( pArgument );
+
+		const char* pValue = ( argumentIndex + 1 < argc ? argv[ argumentIndex + 1 ] : NULL );
+
+		if( CaseInsensitiveCompareString( pArgument, "-headless" ) == 0 )
+		{
+			rParameters.bEnabled = true;
+		}
+		else if( !pValue )
+		{
+			continue;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-tickrate" ) == 0 )
+		{
+			rParameters.tickRate = Max< uint32_t >( static_cast< uint32_t >( strtoul( pValue, NULL, 10 ) ), 1 );
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-worlds" ) == 0 )
+		{
+			rParameters.worldCount = Max< uint32_t >( static_cast< uint32_t >( strtoul( pValue, NULL, 10 ) ), 1 );
+			++argumentIndex;
+		}
+	}
+
+	return rParameters.bEnabled;
+}
+
+/// Set the headless mode settings.
+///
+/// This must be called before Initialize() for headless mode to take effect.
+///
+/// @param[in] rParameters  Headless mode settings.
+///
+/// @see GetHeadlessParameters(), IsHeadless()
+void GameSystem::SetHeadlessParameters( const HeadlessParameters& rParameters )
+{
+	HELIUM_ASSERT( rParameters.tickRate != 0 );
+
+	m_headlessParameters = rParameters;
+}
+
+/// Get the headless mode settings.
+///
+/// @return  Headless mode settings.
+///
+/// @see SetHeadlessParameters()
+const HeadlessParameters& GameSystem::GetHeadlessParameters() const
+{
+	return m_headlessParameters;
+}
+
+/// Set the hitch capture settings used by Run().
+///
+/// @param[in] rParameters  Hitch capture settings.
+///
+/// @see GetHitchCaptureParameters()
+void GameSystem::SetHitchCaptureParameters( const HitchCaptureParameters& rParameters )
+{
+	m_hitchCaptureParameters = rParameters;
+}
+
+/// Get the hitch capture settings used by Run().
+///
+/// @return  Hitch capture settings.
+///
+/// @see SetHitchCaptureParameters()
+const HitchCaptureParameters& GameSystem::GetHitchCaptureParameters() const
+{
+	return m_hitchCaptureParameters;
+}
+
+/// Get whether this system runs headless.
+///
+/// @return  True if running without a window, renderer, or input, false if not.
+///
+/// @see SetHeadlessParameters()
+bool GameSystem::IsHeadless() const
+{
+	return m_headlessParameters.bEnabled;
+}
+
 World *GameSystem::LoadScene( SceneDefinition *pSceneDefinition )
 {
 	WorldManager* pWorldManager = WorldManager::GetInstance();
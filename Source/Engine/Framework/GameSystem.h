@@ -3,12 +3,14 @@
 #include "Platform/Utility.h"
 #include "Framework/SystemDefinition.h"
 #include "Framework/TaskScheduler.h"
+#include "Framework/HitchCapture.h"
 
 #define NO_GFX (1)
 
 namespace Helium
 {
 	class AssetType;
+	class Benchmark;
 
 	class MemoryHeapPreInitialization;
 	class AssetLoaderInitialization;
@@ -19,6 +21,25 @@ namespace Helium
 	class Window;
 	class World;
 
+	/// Settings for a headless run, such as a dedicated server.
+	struct HELIUM_FRAMEWORK_API HeadlessParameters
+	{
+		/// Default number of gameplay ticks per second.
+		static const uint32_t DEFAULT_TICK_RATE = 30;
+
+		/// True to run without a window, renderer, or input, ticking only gameplay tasks.
+		bool bEnabled;
+		/// Number of gameplay ticks per second.
+		uint32_t tickRate;
+		/// Number of worlds the application should create from its scene.
+		uint32_t worldCount;
+
+		/// @name Construction/Destruction
+		//@{
+		HeadlessParameters();
+		//@}
+	};
+
 	/// Base interface for game application systems.
 	class HELIUM_FRAMEWORK_API GameSystem : NonCopyable
 	{
@@ -42,9 +63,25 @@ namespace Helium
 		World *LoadScene( Helium::SceneDefinition *spSceneDefinition );
 		//@}
 
+		/// @name Headless Mode
+		//@{
+		static bool ParseHeadlessCommandLine( int argc, const char* const* argv, HeadlessParameters& rParameters );
+
+		void SetHeadlessParameters( const HeadlessParameters& rParameters );
+		const HeadlessParameters& GetHeadlessParameters() const;
+		bool IsHeadless() const;
+		//@}
+
+		/// @name Hitch Capture
+		//@{
+		void SetHitchCaptureParameters( const HitchCaptureParameters& rParameters );
+		const HitchCaptureParameters& GetHitchCaptureParameters() const;
+		//@}
+
 		/// @name Application Loop
 		//@{
 		virtual int32_t Run();
+		virtual int32_t RunBenchmark( Benchmark& rBenchmark );
 		//@}
 
 		/// @name Static Initialization
@@ -69,6 +106,8 @@ namespace Helium
 		SystemDefinitionPtr          m_spSystemDefinition;
 		AssetAwareThreadSynchronizer m_AssetSyncUtility;
 		TaskSchedule                 m_Schedule;
+		HeadlessParameters           m_headlessParameters;
+		HitchCaptureParameters       m_hitchCaptureParameters;
 		bool                         m_bStopRunning;
 	};
 }
@@ -0,0 +1,505 @@
+#include "Precompile.h"
+#include "Framework/HitchCapture.h"
+
+#include "Platform/Timer.h"
+#include "Foundation/FileStream.h"
+#include "Foundation/BufferedStream.h"
+#include "Engine/AsyncLoader.h"
+#include "Engine/FileLocations.h"
+#include "Framework/TaskScheduler.h"
+
+#include <cstdlib>
+
+using namespace Helium;
+
+namespace
+{
+	/// Write a string to a stream.
+	void WriteString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( pString, sizeof( char ), StringLength( pString ) );
+	}
+
+	/// Write a string to a stream as a quoted JSON string.
+	void WriteJsonString( Stream& rStream, const char* pString )
+	{
+		rStream.Write( "\"", sizeof( char ), 1 );
+
+		for( const char* pCharacter = pString; *pCharacter != '\0'; ++pCharacter )
+		{
+			if( *pCharacter == '"' || *pCharacter == '\\' )
+			{
+				rStream.Write( "\\", sizeof( char ), 1 );
+			}
+
+			rStream.Write( pCharacter, sizeof( char ), 1 );
+		}
+
+		rStream.Write( "\"", sizeof( char ), 1 );
+	}
+
+	/// Trace process ID of the frame profiler scopes.
+	const uint32_t TRACE_PROCESS_SCOPES = 0;
+	/// Trace process ID of the frame markers and counters.
+	const uint32_t TRACE_PROCESS_FRAMES = 1;
+	/// Trace process ID of the scheduled tasks.
+	const uint32_t TRACE_PROCESS_TASKS = 2;
+}
+
+/// Constructor.
+HitchCaptureParameters::HitchCaptureParameters()
+: thresholdMilliseconds( 0.0f )
+, frameCount( DEFAULT_FRAME_COUNT )
+, captureLimit( 0 )
+{
+}
+
+/// Constructor.
+///
+/// @param[in] rParameters  Capture settings.
+HitchCapture::HitchCapture( const HitchCaptureParameters& rParameters )
+: m_parameters( rParameters )
+, m_frameIndex( 0 )
+, m_nextCaptureFrameIndex( 0 )
+, m_captureCount( 0 )
+, m_thresholdTicks( 0 )
+, m_frameStartTickCount( 0 )
+, m_previousAllocationCount( 0 )
+, m_bPreviousTaskTimingEnabled( true )
+, m_bPreviousFrameProfilerEnabled( false )
+{
+}
+
+/// Read capture settings from the application command line.
+///
+/// Recognized arguments are "-hitchms <milliseconds>" (capture frames slower than this), "-hitchframes <count>",
+/// "-hitchlimit <count>", and "-hitchdir <directory>".  Other arguments are ignored.
+///
+/// @param[in]  argc         Number of command line arguments.
+/// @param[in]  argv         Command line arguments, including the program name.
+/// @param[out] rParameters  Settings read from the command line.  Settings not given keep their current values.
+///
+/// @return  True if capturing is enabled by the resulting settings, false if not.
+bool HitchCapture::ParseCommandLine( int argc, const char* const* argv, HitchCaptureParameters& rParameters )
+{
+	HELIUM_ASSERT( argc == 0 || argv );
+
+	for( int argumentIndex = 1; argumentIndex + 1 < argc; ++argumentIndex )
+	{
+		const char* pArgument = argv[ argumentIndex ];
+		HELIUM_ASSERT( pArgument );
+
+		const char* pValue = argv[ argumentIndex + 1 ];
+		HELIUM_ASSERT( pValue );
+
+		if( CaseInsensitiveCompareString( pArgument, "-hitchms" ) == 0 )
+		{
+			rParameters.thresholdMilliseconds = Max( static_cast< float32_t >( atof( pValue ) ), 0.0f );
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-hitchframes" ) == 0 )
+		{
+			rParameters.frameCount = static_cast< uint32_t >( strtoul( pValue, NULL, 10 ) );
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-hitchlimit" ) == 0 )
+		{
+			rParameters.captureLimit = static_cast< uint32_t >( strtoul( pValue, NULL, 10 ) );
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-hitchdir" ) == 0 )
+		{
+			rParameters.outputDirectory = pValue;
+			++argumentIndex;
+		}
+	}
+
+	return ( rParameters.thresholdMilliseconds > 0.0f && rParameters.frameCount != 0 );
+}
+
+/// Start recording frames.
+///
+/// If capturing is enabled, this makes sure task timing and the frame profiler are enabled, as their results are
+/// part of each capture.  Nothing is recorded if capturing is disabled.
+///
+/// @see End()
+void HitchCapture::Begin()
+{
+	m_frameIndex = 0;
+	m_nextCaptureFrameIndex = 0;
+	m_captureCount = 0;
+
+	if( !IsEnabled() )
+	{
+		return;
+	}
+
+	m_bPreviousTaskTimingEnabled = TaskScheduler::IsTaskTimingEnabled();
+	TaskScheduler::SetTaskTimingEnabled( true );
+
+	m_bPreviousFrameProfilerEnabled = FrameProfiler::IsEnabled();
+	FrameProfiler::SetEnabled( true );
+
+	m_thresholdTicks = static_cast< uint64_t >(
+		static_cast< float64_t >( m_parameters.thresholdMilliseconds ) * 0.001 *
+		static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+
+	m_frames.Resize( m_parameters.frameCount );
+
+	uint64_t liveBytes;
+	ReadHeapTotals( m_previousAllocationCount, liveBytes );
+}
+
+/// Mark the start of a frame.
+///
+/// @see EndFrame()
+void HitchCapture::BeginFrame()
+{
+	m_frameStartTickCount = Timer::GetTickCount();
+}
+
+/// Mark the end of a frame, record it in the ring of recent frames, and write a capture if it ran over the threshold.
+///
+/// @param[in] rSchedule  Task schedule executed during the frame.
+///
+/// @see BeginFrame()
+void HitchCapture::EndFrame( const TaskSchedule& rSchedule )
+{
+	if( !IsEnabled() )
+	{
+		return;
+	}
+
+	uint64_t frameEndTickCount = Timer::GetTickCount();
+
+	size_t frameSlot = m_frameIndex % m_frames.GetSize();
+	FrameRecord& rFrame = m_frames[ frameSlot ];
+	rFrame.frameIndex = m_frameIndex;
+	rFrame.startTicks = m_frameStartTickCount;
+	rFrame.endTicks = frameEndTickCount;
+
+	// Tasks run less often than every frame keep the timing of their last run, so only tasks that started during
+	// this frame are recorded.
+	rFrame.tasks.Resize( 0 );
+	const DynamicArray< TaskTiming >& rTaskTimings = TaskScheduler::GetTaskTimings();
+	size_t taskCount = Min( rTaskTimings.GetSize(), rSchedule.m_ScheduleInfo.GetSize() );
+	for( size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex )
+	{
+		const TaskTiming& rTiming = rTaskTimings[ taskIndex ];
+		if( rTiming.m_StartTicks < m_frameStartTickCount )
+		{
+			continue;
+		}
+
+		TaskRecord* pTask = rFrame.tasks.New();
+		HELIUM_ASSERT( pTask );
+		pTask->pName = rSchedule.m_ScheduleInfo[ taskIndex ]->m_Name;
+		pTask->readyTicks = rTiming.m_ReadyTicks;
+		pTask->startTicks = rTiming.m_StartTicks;
+		pTask->endTicks = rTiming.m_EndTicks;
+		pTask->threadIndex = rTiming.m_ThreadIndex;
+	}
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	if( pAssetLoader )
+	{
+		rFrame.assetLoaderStats = pAssetLoader->GetLastTickStats();
+	}
+	else
+	{
+		MemoryZero( &rFrame.assetLoaderStats, sizeof( rFrame.assetLoaderStats ) );
+	}
+
+	AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
+	rFrame.asyncQueuedRequestCount = ( pAsyncLoader ? pAsyncLoader->GetQueuedRequestCount() : 0 );
+	rFrame.asyncBusyWorkerCount = ( pAsyncLoader ? pAsyncLoader->GetBusyWorkerCount() : 0 );
+
+	uint64_t allocationCount;
+	ReadHeapTotals( allocationCount, rFrame.liveBytes );
+	rFrame.allocationCount = allocationCount - m_previousAllocationCount;
+	m_previousAllocationCount = allocationCount;
+
+	uint32_t frameIndex = m_frameIndex++;
+
+	if( frameEndTickCount - m_frameStartTickCount <= m_thresholdTicks || frameIndex < m_nextCaptureFrameIndex )
+	{
+		return;
+	}
+
+	if( m_parameters.captureLimit != 0 && m_captureCount >= m_parameters.captureLimit )
+	{
+		return;
+	}
+
+	// The frames written with this capture are not written again, so the next capture waits for the ring to refill.
+	m_nextCaptureFrameIndex = m_frameIndex + m_parameters.frameCount;
+
+	if( WriteCapture( rFrame ) )
+	{
+		++m_captureCount;
+	}
+}
+
+/// Restore the settings changed by Begin().
+///
+/// @see Begin()
+void HitchCapture::End()
+{
+	if( !IsEnabled() )
+	{
+		return;
+	}
+
+	TaskScheduler::SetTaskTimingEnabled( m_bPreviousTaskTimingEnabled );
+	FrameProfiler::SetEnabled( m_bPreviousFrameProfilerEnabled );
+
+	m_frames.Clear();
+	m_profilerThreads.Clear();
+	m_memoryStats.Clear();
+}
+
+/// Sum the allocation counts and live bytes of every heap tracker.
+///
+/// @param[out] rAllocationCount  Total number of heap allocations since startup.
+/// @param[out] rLiveBytes        Number of heap bytes currently allocated.
+void HitchCapture::ReadHeapTotals( uint64_t& rAllocationCount, uint64_t& rLiveBytes )
+{
+	rAllocationCount = 0;
+	rLiveBytes = 0;
+
+	// Asset and render resource trackers count memory that is also counted by the heaps, so only heaps are summed.
+	MemoryTelemetry::GetStats( m_memoryStats );
+	size_t trackerCount = m_memoryStats.GetSize();
+	for( size_t trackerIndex = 0; trackerIndex < trackerCount; ++trackerIndex )
+	{
+		const MemoryTelemetry::Stats& rStats = m_memoryStats[ trackerIndex ];
+		if( rStats.category == MemoryTelemetry::CATEGORY_HEAP )
+		{
+			rAllocationCount += rStats.totalCount;
+			rLiveBytes += rStats.liveBytes;
+		}
+	}
+}
+
+/// Write the recorded frames to a Chrome trace file.
+///
+/// The trace holds the frame profiler scopes recorded over the frames in the ring, a marker for each frame, the
+/// scheduled tasks on the threads they ran on, and counters for the asset loader stage counts, the async loader
+/// queue depth, and heap allocations.
+///
+/// @param[in] rHitchFrame  Frame that ran over the threshold.
+///
+/// @return  True if the capture was written successfully, false if not.
+bool HitchCapture::WriteCapture( const FrameRecord& rHitchFrame )
+{
+	FilePath directory;
+	if( m_parameters.outputDirectory.IsEmpty() )
+	{
+		FilePath userDirectory;
+		if( !FileLocations::GetUserDirectory( userDirectory ) )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "HitchCapture::WriteCapture(): No user directory is available.\n" );
+
+			return false;
+		}
+
+		directory = FilePath( userDirectory.Get() + "Hitches" );
+	}
+	else
+	{
+		directory = FilePath( *m_parameters.outputDirectory );
+	}
+
+	if( !directory.Exists() && !directory.MakePath() && !directory.Exists() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"HitchCapture::WriteCapture(): Failed to create directory \"%s\".\n",
+			directory.Data() );
+
+		return false;
+	}
+
+	char buffer[ 512 ];
+	StringPrint( buffer, "/Hitch_%" PRIu32 ".json", rHitchFrame.frameIndex );
+	buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+	FilePath path( directory.Get() + buffer );
+
+	FileStream* pFileStream = FileStream::OpenFileStream( path.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"HitchCapture::WriteCapture(): Failed to open \"%s\" for writing.\n",
+			path.Data() );
+
+		return false;
+	}
+
+	// Frames are written from oldest to newest.
+	size_t frameSlotCount = m_frames.GetSize();
+	size_t recordedFrameCount = Min( static_cast< size_t >( m_frameIndex ), frameSlotCount );
+	size_t firstFrameIndex = m_frameIndex - recordedFrameCount;
+
+	// Timestamps are in microseconds, relative to the start of the oldest recorded frame.
+	uint64_t baseTicks = m_frames[ firstFrameIndex % frameSlotCount ].startTicks;
+	float64_t microsecondsPerTick = Timer::GetSecondsPerTick() * 1000000.0;
+	float64_t millisecondsPerTick = Timer::GetSecondsPerTick() * 1000.0;
+
+	FrameProfiler::GetEvents( baseTicks, m_profilerThreads );
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+
+		StringPrint(
+			buffer,
+			"{\"traceEvents\":[\n"
+			"{\"ph\":\"M\",\"pid\":%" PRIu32 ",\"name\":\"process_name\",\"args\":{\"name\":\"Scopes\"}},\n"
+			"{\"ph\":\"M\",\"pid\":%" PRIu32 ",\"name\":\"process_name\",\"args\":{\"name\":\"Frames\"}},\n"
+			"{\"ph\":\"M\",\"pid\":%" PRIu32 ",\"name\":\"process_name\",\"args\":{\"name\":\"Tasks\"}}",
+			TRACE_PROCESS_SCOPES,
+			TRACE_PROCESS_FRAMES,
+			TRACE_PROCESS_TASKS );
+		buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+		WriteString( bufferedStream, buffer );
+
+		// Frame profiler scopes, on the threads that recorded them.
+		size_t threadCount = m_profilerThreads.GetSize();
+		for( size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex )
+		{
+			const FrameProfiler::ThreadEvents& rThread = m_profilerThreads[ threadIndex ];
+
+			if( rThread.pThreadName )
+			{
+				StringPrint(
+					buffer,
+					",\n{\"ph\":\"M\",\"pid\":%" PRIu32 ",\"tid\":%" PRIu32 ",\"name\":\"thread_name\",\"args\":{\"name\":",
+					TRACE_PROCESS_SCOPES,
+					rThread.threadIndex );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+				WriteJsonString( bufferedStream, rThread.pThreadName );
+				WriteString( bufferedStream, "}}" );
+			}
+
+			size_t eventCount = rThread.events.GetSize();
+			for( size_t eventIndex = 0; eventIndex < eventCount; ++eventIndex )
+			{
+				const FrameProfiler::Event& rEvent = rThread.events[ eventIndex ];
+				if( rEvent.startTicks < baseTicks )
+				{
+					continue;
+				}
+
+				StringPrint(
+					buffer,
+					",\n{\"ph\":\"X\",\"pid\":%" PRIu32 ",\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+					TRACE_PROCESS_SCOPES,
+					rThread.threadIndex,
+					static_cast< float64_t >( rEvent.startTicks - baseTicks ) * microsecondsPerTick,
+					static_cast< float64_t >( rEvent.endTicks - rEvent.startTicks ) * microsecondsPerTick );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+				WriteJsonString( bufferedStream, rEvent.pName ? rEvent.pName : "" );
+				WriteString( bufferedStream, "}" );
+			}
+		}
+
+		for( size_t frameIndex = firstFrameIndex; frameIndex < m_frameIndex; ++frameIndex )
+		{
+			const FrameRecord& rFrame = m_frames[ frameIndex % frameSlotCount ];
+			float64_t frameStartMicroseconds =
+				static_cast< float64_t >( rFrame.startTicks - baseTicks ) * microsecondsPerTick;
+
+			// Frame marker.
+			StringPrint(
+				buffer,
+				",\n{\"ph\":\"X\",\"pid\":%" PRIu32 ",\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"%s\","
+				"\"args\":{\"frame\":%" PRIu32 ",\"milliseconds\":%.4f}}",
+				TRACE_PROCESS_FRAMES,
+				frameStartMicroseconds,
+				static_cast< float64_t >( rFrame.endTicks - rFrame.startTicks ) * microsecondsPerTick,
+				( &rFrame == &rHitchFrame ? "Hitch" : "Frame" ),
+				rFrame.frameIndex,
+				static_cast< float64_t >( rFrame.endTicks - rFrame.startTicks ) * millisecondsPerTick );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+
+			// Counters, sampled at the start of the frame so that they line up with the frame markers.
+			const AssetLoader::TickStats& rLoaderStats = rFrame.assetLoaderStats;
+			StringPrint(
+				buffer,
+				",\n{\"ph\":\"C\",\"pid\":%" PRIu32 ",\"ts\":%.3f,\"name\":\"AssetLoader::Tick\",\"args\":{"
+				"\"queued\":%" PRIuSZ ",\"updated\":%" PRIuSZ ",\"blocked\":%" PRIuSZ ",\"linked\":%" PRIuSZ
+				",\"completed\":%" PRIuSZ ",\"active\":%" PRIuSZ "}}",
+				TRACE_PROCESS_FRAMES,
+				frameStartMicroseconds,
+				rLoaderStats.queuedRequestCount,
+				rLoaderStats.updatedRequestCount,
+				rLoaderStats.blockedRequestCount,
+				rLoaderStats.linkedRequestCount,
+				rLoaderStats.completedRequestCount,
+				rLoaderStats.activeRequestCount );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+
+			StringPrint(
+				buffer,
+				",\n{\"ph\":\"C\",\"pid\":%" PRIu32 ",\"ts\":%.3f,\"name\":\"AsyncLoader\",\"args\":{"
+				"\"queued\":%" PRIuSZ ",\"busyWorkers\":%" PRIu32 "}}",
+				TRACE_PROCESS_FRAMES,
+				frameStartMicroseconds,
+				rFrame.asyncQueuedRequestCount,
+				rFrame.asyncBusyWorkerCount );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+
+			StringPrint(
+				buffer,
+				",\n{\"ph\":\"C\",\"pid\":%" PRIu32 ",\"ts\":%.3f,\"name\":\"Heap\",\"args\":{"
+				"\"allocations\":%" PRIu64 ",\"liveMegabytes\":%.3f}}",
+				TRACE_PROCESS_FRAMES,
+				frameStartMicroseconds,
+				rFrame.allocationCount,
+				static_cast< float64_t >( rFrame.liveBytes ) / ( 1024.0 * 1024.0 ) );
+			buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+			WriteString( bufferedStream, buffer );
+
+			// Scheduled tasks, on the threads they ran on.
+			size_t taskCount = rFrame.tasks.GetSize();
+			for( size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex )
+			{
+				const TaskRecord& rTask = rFrame.tasks[ taskIndex ];
+				uint64_t waitTicks = ( rTask.startTicks > rTask.readyTicks ? rTask.startTicks - rTask.readyTicks : 0 );
+
+				StringPrint(
+					buffer,
+					",\n{\"ph\":\"X\",\"pid\":%" PRIu32 ",\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f,"
+					"\"args\":{\"waitMilliseconds\":%.4f},\"name\":",
+					TRACE_PROCESS_TASKS,
+					rTask.threadIndex,
+					static_cast< float64_t >( rTask.startTicks - baseTicks ) * microsecondsPerTick,
+					static_cast< float64_t >( rTask.endTicks - rTask.startTicks ) * microsecondsPerTick,
+					static_cast< float64_t >( waitTicks ) * millisecondsPerTick );
+				buffer[ HELIUM_ARRAY_COUNT( buffer ) - 1 ] = '\0';
+				WriteString( bufferedStream, buffer );
+				WriteJsonString( bufferedStream, rTask.pName ? rTask.pName : "" );
+				WriteString( bufferedStream, "}" );
+			}
+		}
+
+		WriteString( bufferedStream, "\n]}\n" );
+	}
+
+	delete pFileStream;
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"HitchCapture::WriteCapture(): Frame %" PRIu32 " took %.2f ms; wrote the last %" PRIuSZ " frames to \"%s\".\n",
+		rHitchFrame.frameIndex,
+		static_cast< float64_t >( rHitchFrame.endTicks - rHitchFrame.startTicks ) * millisecondsPerTick,
+		recordedFrameCount,
+		path.Data() );
+
+	return true;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Framework/Framework.h"
+
+#include "Platform/Utility.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/String.h"
+#include "Engine/AssetLoader.h"
+#include "Engine/FrameProfiler.h"
+#include "Engine/MemoryTelemetry.h"
+
+namespace Helium
+{
+	struct TaskSchedule;
+
+	/// Settings for capturing slow frames.
+	struct HELIUM_FRAMEWORK_API HitchCaptureParameters
+	{
+		/// Default number of recent frames kept and written with each capture.
+		static const uint32_t DEFAULT_FRAME_COUNT = 120;
+
+		/// Frame time above which a frame is captured, in milliseconds, or zero to disable capturing.
+		float32_t thresholdMilliseconds;
+		/// Number of recent frames kept and written with each capture.
+		uint32_t frameCount;
+		/// Maximum number of captures written in a run, or zero for no limit.
+		uint32_t captureLimit;
+		/// Directory in which to write captures, or empty to use the user directory.
+		String outputDirectory;
+
+		/// @name Construction/Destruction
+		//@{
+		HitchCaptureParameters();
+		//@}
+	};
+
+	/// Rolling record of recent frames, written out as a trace whenever a frame takes longer than a set threshold.
+	///
+	/// While enabled, every task is timed and the frame profiler records, and each frame appends a record of its task
+	/// timings, the number of asset load requests that reached each AssetLoader::Tick() stage, the async loader queue
+	/// depth, and the heap allocation count to a ring of the most recent frames.  When a frame exceeds the threshold,
+	/// the ring is written to a Chrome trace file (viewable with chrome://tracing) along with the frame profiler scopes
+	/// recorded over the same frames, so that one-off spikes (garbage collection, streaming, physics substep spirals)
+	/// can be examined after the fact.  Captures are spaced at least a full ring apart, so a run of slow frames is
+	/// written once rather than on every frame.
+	///
+	/// @see GameSystem::Run()
+	class HELIUM_FRAMEWORK_API HitchCapture : NonCopyable
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		explicit HitchCapture( const HitchCaptureParameters& rParameters );
+		//@}
+
+		/// @name Configuration
+		//@{
+		static bool ParseCommandLine( int argc, const char* const* argv, HitchCaptureParameters& rParameters );
+		inline const HitchCaptureParameters& GetParameters() const;
+		inline bool IsEnabled() const;
+		//@}
+
+		/// @name Recording
+		//@{
+		void Begin();
+		void BeginFrame();
+		void EndFrame( const TaskSchedule& rSchedule );
+		void End();
+
+		inline uint32_t GetCaptureCount() const;
+		//@}
+
+	private:
+		/// Timing of a single task during a recorded frame.
+		struct TaskRecord
+		{
+			/// Task name (static string).
+			const char* pName;
+			/// Tick count when every task the task waits on had completed.
+			uint64_t readyTicks;
+			/// Tick count when the task started.
+			uint64_t startTicks;
+			/// Tick count when the task ended.
+			uint64_t endTicks;
+			/// Index of the thread the task ran on.
+			uint32_t threadIndex;
+		};
+
+		/// Record of a single frame.
+		struct FrameRecord
+		{
+			/// Index of the frame since Begin() was called.
+			uint32_t frameIndex;
+			/// Tick count at the start of the frame.
+			uint64_t startTicks;
+			/// Tick count at the end of the frame.
+			uint64_t endTicks;
+
+			/// Timing of each task run during the frame.
+			DynamicArray< TaskRecord > tasks;
+
+			/// Asset loader stage counts of the last tick run during the frame.
+			AssetLoader::TickStats assetLoaderStats;
+			/// Number of async load requests queued at the end of the frame.
+			size_t asyncQueuedRequestCount;
+			/// Number of busy async loader workers at the end of the frame.
+			uint32_t asyncBusyWorkerCount;
+
+			/// Number of heap allocations made during the frame.
+			uint64_t allocationCount;
+			/// Number of heap bytes allocated at the end of the frame.
+			uint64_t liveBytes;
+		};
+
+		/// Capture settings.
+		HitchCaptureParameters m_parameters;
+
+		/// Ring of the most recent frames.
+		DynamicArray< FrameRecord > m_frames;
+		/// Number of frames recorded since Begin() was called.
+		uint32_t m_frameIndex;
+		/// Index of the first frame that may be captured (frames before it are already part of a written capture).
+		uint32_t m_nextCaptureFrameIndex;
+		/// Number of captures written since Begin() was called.
+		uint32_t m_captureCount;
+
+		/// Frame time threshold in timer ticks.
+		uint64_t m_thresholdTicks;
+		/// Tick count at the start of the current frame.
+		uint64_t m_frameStartTickCount;
+		/// Total heap allocation count at the end of the previous frame.
+		uint64_t m_previousAllocationCount;
+
+		/// Memory telemetry read at the end of the last frame (kept to reuse its memory).
+		DynamicArray< MemoryTelemetry::Stats > m_memoryStats;
+		/// Frame profiler scopes read for the last capture (kept to reuse their memory).
+		DynamicArray< FrameProfiler::ThreadEvents > m_profilerThreads;
+
+		/// True if task timing was enabled before Begin() was called.
+		bool m_bPreviousTaskTimingEnabled;
+		/// True if the frame profiler was enabled before Begin() was called.
+		bool m_bPreviousFrameProfilerEnabled;
+
+		/// @name Private Utility Functions
+		//@{
+		void ReadHeapTotals( uint64_t& rAllocationCount, uint64_t& rLiveBytes );
+		bool WriteCapture( const FrameRecord& rHitchFrame );
+		//@}
+	};
+}
+
+#include "Framework/HitchCapture.inl"
@@ -0,0 +1,26 @@
+namespace Helium
+{
+	/// Get the settings of this capture.
+	///
+	/// @return  Capture settings.
+	const HitchCaptureParameters& HitchCapture::GetParameters() const
+	{
+		return m_parameters;
+	}
+
+	/// Get whether slow frames are captured.
+	///
+	/// @return  True if a frame time threshold is set, false if not.
+	bool HitchCapture::IsEnabled() const
+	{
+		return m_parameters.thresholdMilliseconds > 0.0f && m_parameters.frameCount != 0;
+	}
+
+	/// Get the number of captures written since Begin() was called.
+	///
+	/// @return  Number of captures written.
+	uint32_t HitchCapture::GetCaptureCount() const
+	{
+		return m_captureCount;
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "Foundation/DynamicArray.h"
 #include "Platform/MemoryHeap.h"
+#include "Platform/Utility.h"
 #include "Reflect/Object.h"
 
 #include "MathSimd/Quat.h"
@@ -38,34 +39,78 @@ namespace Helium
 
 	private:
 		friend class ParameterSetBuilder;
-		ParameterSetPtr m_NextParams;
+		friend class Prefab;
+
+		// Not a strong pointer since chains usually live in a ParameterSetBuilder's block
+		ParameterSet *m_NextParams;
 	};
 
-	class ParameterSetBuilder
+	// Builds a chain of parameter sets to pass to a spawn. Sets are constructed in a block inside the builder while
+	// they fit, so a builder on the stack spawns without touching the heap. The builder owns every set it adds, which
+	// are only valid for as long as the builder is
+	class ParameterSetBuilder : NonCopyable
 	{
 	public:
+		static const size_t INLINE_BLOCK_SIZE = 256;
+
 		ParameterSetBuilder( ParameterSet *parameterSet = 0)
 			: m_ParameterSet( parameterSet )
+			, m_BaseSet( parameterSet )
+			, m_BlockUsed( 0 )
 		{
 			
 		}
 
+		~ParameterSetBuilder()
+		{
+			// Heap sets are released by m_HeapSets, only the ones in the block need destroying here
+			ParameterSet *parameterSet = m_ParameterSet;
+			while ( parameterSet != m_BaseSet )
+			{
+				ParameterSet *next = parameterSet->m_NextParams;
+				if ( reinterpret_cast<uint8_t *>( parameterSet ) >= m_Block &&
+					reinterpret_cast<uint8_t *>( parameterSet ) < m_Block + INLINE_BLOCK_SIZE )
+				{
+					parameterSet->~ParameterSet();
+				}
+
+				parameterSet = next;
+			}
+		}
+
 		template <class T>
 		T *AddParameterSet()
 		{
-			ParameterSetPtr temp = m_ParameterSet;
-			m_ParameterSet = new T();
-			m_ParameterSet->m_NextParams = temp;
-			return static_cast<T *>(m_ParameterSet.Get());
+			T *parameterSet;
+
+			size_t offset = Align( m_BlockUsed, HELIUM_SIMD_ALIGNMENT );
+			if ( offset + sizeof( T ) <= INLINE_BLOCK_SIZE )
+			{
+				parameterSet = new( m_Block + offset ) T();
+				m_BlockUsed = offset + sizeof( T );
+			}
+			else
+			{
+				parameterSet = new T();
+				m_HeapSets.Push( parameterSet );
+			}
+
+			parameterSet->m_NextParams = m_ParameterSet;
+			m_ParameterSet = parameterSet;
+			return parameterSet;
 		}
 
 		ParameterSet *GetSet()
 		{
-			return m_ParameterSet.Get();
+			return m_ParameterSet;
 		}
 
 	private:
-		ParameterSetPtr m_ParameterSet;
+		ParameterSet *m_ParameterSet;
+		ParameterSet *m_BaseSet;                  //< Set passed to the constructor, not owned
+		size_t        m_BlockUsed;
+		HELIUM_SIMD_ALIGN_PRE uint8_t m_Block[ INLINE_BLOCK_SIZE ] HELIUM_SIMD_ALIGN_POST;
+		DynamicArray<ParameterSetPtr> m_HeapSets; //< Sets that did not fit in the block
 	};
 
 #if 0
@@ -11,6 +11,11 @@ namespace Helium
 	{
 		HELIUM_DECLARE_ASSET( Predicate, Asset );
 		virtual bool Evaluate( World &pWorld, ParameterSet *parameters ) { HELIUM_ASSERT( 0 ); return false; }
+
+		// Stamp that changes whenever the result of Evaluate may have changed, so that callers can keep the last
+		// result and only evaluate again once the stamp differs. Predicates that can't tell when their inputs change
+		// return an invalid stamp, and are evaluated every time
+		virtual uint32_t GetInputStamp( World &pWorld, ParameterSet *parameters ) { return Invalid< uint32_t >(); }
 	};
 	typedef Helium::StrongPtr< Predicate > PredicatePtr;
 }
@@ -0,0 +1,327 @@
+#include "Precompile.h"
+#include "Framework/Prefab.h"
+
+#include "Foundation/Log.h"
+#include "Foundation/Map.h"
+#include "Framework/ComponentSet.h"
+#include "Reflect/TranslatorDeduction.h"
+
+using namespace Helium;
+
+Prefab::Prefab()
+	: m_SetStart( 0 )
+	, m_Baked( false )
+{
+
+}
+
+void Prefab::Bake( const DynamicArray<ComponentDefinitionPtr> &components, const ComponentSet &componentSet )
+{
+	Clear();
+
+	HELIUM_TRACE(
+		TraceLevels::Debug,
+		"Prefab::Bake() - Baking %d component definitions and a component set of %d\n",
+		components.GetSize(),
+		componentSet.m_Components.GetSize());
+
+	// Plain definitions are deployed as they are, so they are shared rather than cloned
+	for (DynamicArray<ComponentDefinitionPtr>::ConstIterator iter = components.Begin();
+		iter != components.End(); ++iter)
+	{
+		if (!*iter)
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"Prefab::Bake() - A ComponentDefinitionPtr in the supplied list was null - ignoring.\n" );
+			continue;
+		}
+
+		BakedComponent *pBaked = m_Components.New();
+		pBaked->m_Definition = *iter;
+		pBaked->m_TypeId = Invalid<Components::TypeId>();
+		pBaked->m_AllowImage = true;
+	}
+
+	m_SetStart = m_Components.GetSize();
+
+	// Index the component set by name, which is also the order DeployComponents() creates them in
+	typedef Map<Name, size_t> M_ComponentIndices;
+	M_ComponentIndices sourceIndices;
+
+	for (size_t i = 0; i < componentSet.m_Components.GetSize(); ++i)
+	{
+		const ComponentSet::NameDefinitionPair &pair = componentSet.m_Components[i];
+		M_ComponentIndices::Iterator iter = sourceIndices.Find(pair.m_Name);
+
+		if (iter != sourceIndices.End())
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"  Multiple components named '%s'\n",
+				*pair.m_Name);
+			continue;
+		}
+
+		if ( !pair.m_Definition.ReferencesObject() )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"  Cannot clone null component named '%s'\n",
+				*pair.m_Name);
+			continue;
+		}
+
+		sourceIndices.Insert(iter, M_ComponentIndices::ValueType(pair.m_Name, i));
+	}
+
+	// Clone each definition once. The clones belong to the prefab and are reused by every deploy
+	M_ComponentIndices bakedIndices;
+	for (M_ComponentIndices::Iterator iter = sourceIndices.Begin(); iter != sourceIndices.End(); ++iter)
+	{
+		Reflect::ObjectPtr object_ptr = componentSet.m_Components[iter->Second()].m_Definition->Clone();
+
+		BakedComponent *pBaked = m_Components.New();
+		pBaked->m_Definition = Reflect::AssertCast<Helium::ComponentDefinition>(object_ptr.Get());
+		pBaked->m_TypeId = Invalid<Components::TypeId>();
+		pBaked->m_AllowImage = true;
+
+		M_ComponentIndices::Iterator bakedIter = bakedIndices.Find(iter->First());
+		bakedIndices.Insert(bakedIter, M_ComponentIndices::ValueType(iter->First(), m_Components.GetSize() - 1));
+	}
+
+	// Resolve exposed parameters to fields now so that deploying only has to copy values
+	for (size_t parameter_index = 0; parameter_index < componentSet.m_Parameters.GetSize(); ++parameter_index)
+	{
+		const ComponentSet::Parameter &parameter = componentSet.m_Parameters[parameter_index];
+
+		M_ComponentIndices::Iterator component_iter = bakedIndices.Find(parameter.m_ComponentName);
+		if (component_iter == bakedIndices.End())
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"  Parameter '%s' refers to a component '%s' that cannot be found - ignored.\n",
+				*parameter.m_ParameterName,
+				*parameter.m_ComponentName);
+
+			continue;
+		}
+
+		BakedComponent &rTarget = m_Components[component_iter->Second()];
+
+		uint32_t fieldNameCrc = Crc32( parameter.m_ComponentFieldName.Get() );
+		const Helium::Reflect::Field *field = rTarget.m_Definition->GetMetaClass()->FindFieldByName(fieldNameCrc);
+
+		if (!field)
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"  Parameter '%s' cannot find field named '%s' on component '%s' - ignored.\n",
+				*parameter.m_ParameterName,
+				*parameter.m_ComponentFieldName,
+				*parameter.m_ComponentName);
+
+			continue;
+		}
+
+		M_ComponentIndices::Iterator default_iter = bakedIndices.Find(parameter.m_ParameterName);
+
+		BakedParameter *pBaked = m_Parameters.New();
+		pBaked->m_ParameterName = parameter.m_ParameterName;
+		pBaked->m_Field = field;
+		pBaked->m_ComponentIndex = component_iter->Second();
+		pBaked->m_Source = componentSet.m_Components[sourceIndices.Find(parameter.m_ComponentName)->Second()].m_Definition;
+		pBaked->m_DefaultIndex = ( default_iter != bakedIndices.End() ) ? default_iter->Second() : Invalid<size_t>();
+
+		// The component's initial state now depends on what each deploy supplies
+		rTarget.m_AllowImage = false;
+	}
+
+	m_Baked = true;
+}
+
+void Prefab::Clear()
+{
+	m_Components.Clear();
+	m_Parameters.Clear();
+	m_Bindings.Clear();
+	m_BindingFields.Clear();
+	m_SetStart = 0;
+	m_Baked = false;
+}
+
+void Prefab::Deploy( Components::IHasComponents &rHasComponents, const ParameterSet *pParameterSet, DynamicArray<PendingFinalize> *pPending )
+{
+	HELIUM_ASSERT( m_Baked );
+	HELIUM_ASSERT( !pPending || !pParameterSet );
+
+	ApplyParameters( pParameterSet );
+
+	DeployRange( rHasComponents, 0, m_SetStart, pPending );
+	DeployRange( rHasComponents, m_SetStart, m_Components.GetSize(), pPending );
+}
+
+void Prefab::FinalizePending( const PendingFinalize *pPending, size_t count )
+{
+	HELIUM_ASSERT( m_Baked );
+	HELIUM_ASSERT( pPending || !count );
+
+	// Other deploys since may have left different values in the definitions
+	ApplyParameters( NULL );
+
+	// Definitions may wire to each other's created components, so every one is pointed back at its component first
+	for (size_t i = 0; i < count; ++i)
+	{
+		const PendingFinalize &rPending = pPending[ i ];
+		rPending.m_Definition->SetCreatedComponent(
+			rPending.m_Component->GetInlineData().m_Generation == rPending.m_Generation ? rPending.m_Component : NULL );
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if ( pPending[ i ].m_Definition->GetCreatedComponent() )
+		{
+			pPending[ i ].m_Definition->FinalizeComponent();
+		}
+	}
+}
+
+void Prefab::ApplyParameters( const ParameterSet *pParameterSet )
+{
+	m_SuppliedValues.Resize( m_Parameters.GetSize() );
+	for (size_t i = 0; i < m_SuppliedValues.GetSize(); ++i)
+	{
+		m_SuppliedValues[ i ].m_Set = NULL;
+	}
+
+	// The first set in the chain to supply a parameter wins, as with the EnumerateParameters() order
+	if ( !m_Parameters.IsEmpty() )
+	{
+		for ( const ParameterSet *pSet = pParameterSet; pSet; pSet = pSet->m_NextParams )
+		{
+			const SuppliedBinding &rBinding = m_Bindings[ GetBinding( pSet->GetMetaClass() ) ];
+			for (size_t i = rBinding.m_FirstField; i < rBinding.m_FirstField + rBinding.m_FieldCount; ++i)
+			{
+				SuppliedValue &rValue = m_SuppliedValues[ m_BindingFields[ i ].m_ParameterIndex ];
+				if ( !rValue.m_Set )
+				{
+					rValue.m_Set = pSet;
+					rValue.m_Field = m_BindingFields[ i ].m_Field;
+				}
+			}
+		}
+	}
+
+	// Every parameter is written on every deploy, so nothing supplied for a previous entity leaks into this one.
+	// As in DeployComponents(), a supplied value wins over a component of the same name
+	for (size_t parameter_index = 0; parameter_index < m_Parameters.GetSize(); ++parameter_index)
+	{
+		BakedParameter &rParameter = m_Parameters[ parameter_index ];
+		Reflect::Pointer destination( rParameter.m_Field, m_Components[ rParameter.m_ComponentIndex ].m_Definition.Get() );
+
+		const SuppliedValue &rSupplied = m_SuppliedValues[ parameter_index ];
+		if ( rSupplied.m_Set )
+		{
+			ParameterSet *pSet = const_cast< ParameterSet * >( rSupplied.m_Set );
+			Reflect::Pointer value( rSupplied.m_Field, pSet, pSet );
+			rParameter.m_Field->m_Translator->Copy( value, destination, Reflect::CopyFlags::Shallow );
+		}
+		else if ( IsValid( rParameter.m_DefaultIndex ) )
+		{
+			Reflect::Pointer value( m_Components[ rParameter.m_DefaultIndex ].m_Definition );
+			rParameter.m_Field->m_Translator->Copy( value, destination, Reflect::CopyFlags::Shallow );
+		}
+		else
+		{
+			Reflect::Pointer value( rParameter.m_Field, rParameter.m_Source.Get() );
+			rParameter.m_Field->m_Translator->Copy( value, destination, Reflect::CopyFlags::Shallow );
+		}
+	}
+}
+
+size_t Prefab::GetBinding( const Reflect::MetaStruct *pType )
+{
+	HELIUM_ASSERT( pType );
+
+	// An entity is only ever spawned with a handful of parameter set types
+	for (size_t i = 0; i < m_Bindings.GetSize(); ++i)
+	{
+		if ( m_Bindings[ i ].m_Type == pType )
+		{
+			return i;
+		}
+	}
+
+	SuppliedBinding *pBinding = m_Bindings.New();
+	pBinding->m_Type = pType;
+	pBinding->m_FirstField = m_BindingFields.GetSize();
+
+	for (DynamicArray< Reflect::Field >::ConstIterator iter = pType->m_Fields.Begin();
+		iter != pType->m_Fields.End(); ++iter)
+	{
+		Name fieldName( iter->m_Name );
+		for (size_t parameter_index = 0; parameter_index < m_Parameters.GetSize(); ++parameter_index)
+		{
+			if ( m_Parameters[ parameter_index ].m_ParameterName == fieldName )
+			{
+				BindingField *pField = m_BindingFields.New();
+				pField->m_Field = &*iter;
+				pField->m_ParameterIndex = parameter_index;
+			}
+		}
+	}
+
+	pBinding->m_FieldCount = m_BindingFields.GetSize() - pBinding->m_FirstField;
+	return m_Bindings.GetSize() - 1;
+}
+
+void Prefab::DeployRange( Components::IHasComponents &rHasComponents, size_t begin, size_t end, DynamicArray<PendingFinalize> *pPending )
+{
+	for (size_t i = begin; i < end; ++i)
+	{
+		BakedComponent &rBaked = m_Components[ i ];
+
+		if ( !rBaked.m_Image.IsEmpty() )
+		{
+			rBaked.m_Definition->CreateComponentFromImage( rHasComponents, rBaked.m_TypeId, rBaked.m_Image.GetData() );
+			continue;
+		}
+
+		Component *pComponent = rBaked.m_Definition->CreateComponent( rHasComponents );
+		if ( rBaked.m_AllowImage && pComponent )
+		{
+			// Capture before finalizing, since FinalizeComponent() runs for every copy anyway
+			Components::Pool *pPool = Components::Pool::GetPool( pComponent );
+			rBaked.m_TypeId = pPool->GetTypeId();
+
+			if ( Components::GetTypeData( rBaked.m_TypeId )->m_PrefabImage )
+			{
+				pPool->CaptureImage( pComponent, rBaked.m_Image );
+			}
+			else
+			{
+				rBaked.m_AllowImage = false;
+			}
+		}
+	}
+
+	// Second pass to allow components to get references to each other if need be
+	for (size_t i = begin; i < end; ++i)
+	{
+		const ComponentDefinition *pDefinition = m_Components[ i ].m_Definition;
+		if ( !pPending )
+		{
+			pDefinition->FinalizeComponent();
+			continue;
+		}
+
+		Component *pComponent = pDefinition->GetCreatedComponent();
+		if ( pComponent )
+		{
+			PendingFinalize *pFinalize = pPending->New();
+			pFinalize->m_Definition = pDefinition;
+			pFinalize->m_Component = pComponent;
+			pFinalize->m_Generation = pComponent->GetInlineData().m_Generation;
+		}
+	}
+}
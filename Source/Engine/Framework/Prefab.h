@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Framework/Framework.h"
+#include "Foundation/DynamicArray.h"
+#include "Framework/Components.h"
+#include "Framework/ComponentDefinition.h"
+#include "Framework/ParameterSet.h"
+
+namespace Helium
+{
+	class ComponentSet;
+
+	// Baked form of an entity's component definitions, so that each copy of the entity skips most of the work done by
+	// Components::DeployComponents(). Baking clones the ComponentSet's definitions and wires them to each other once,
+	// and resolves every exposed parameter to its target field. A component whose type uses
+	// HELIUM_COMPONENT_PREFAB_IMAGE and that no parameter targets is captured as an image the first time it is
+	// deployed, after which each copy is a memcpy into its pool. FinalizeComponent() still runs for every component.
+	// Supplied parameter sets are bound to baked parameters once per parameter set type rather than by name per deploy
+	class HELIUM_FRAMEWORK_API Prefab
+	{
+	public:
+		// Component created by a deploy whose FinalizeComponent() was held back
+		struct PendingFinalize
+		{
+			const ComponentDefinition*  m_Definition;
+			Component*              m_Component;
+			Components::GenerationIndex m_Generation;  //< To skip components freed before they were finalized
+		};
+
+		Prefab();
+
+		void Bake( const DynamicArray<ComponentDefinitionPtr> &components, const ComponentSet &componentSet );
+		void Clear();
+		inline bool IsBaked() const;
+
+		// Same result as deploying the definitions and then the component set the prefab was baked from. If pPending
+		// is given, components are only created and initialized, and what FinalizeComponent() would have been called
+		// on is appended to pPending for a later FinalizePending(). Deferred deploys take no parameter set, since the
+		// definitions are rewritten by every deploy in between and only the defaults can be reapplied
+		void Deploy( Components::IHasComponents &rHasComponents, const ParameterSet *pParameterSet, DynamicArray<PendingFinalize> *pPending = NULL );
+
+		// Finalize the components of one deferred deploy, in the order Deploy() would have
+		void FinalizePending( const PendingFinalize *pPending, size_t count );
+
+	private:
+		struct BakedComponent
+		{
+			// A private clone for component set entries, the shared definition for plain definitions
+			ComponentDefinitionPtr  m_Definition;
+			DynamicArray<uint8_t>   m_Image;
+			Components::TypeId      m_TypeId;
+			bool                    m_AllowImage;      //< False once a parameter targets it or its type has no image
+		};
+
+		struct BakedParameter
+		{
+			Name                    m_ParameterName;
+			const Reflect::Field*   m_Field;
+			size_t                  m_ComponentIndex;  //< Baked component receiving the value
+			ComponentDefinitionPtr  m_Source;          //< Original definition, supplies the value if nothing else does
+			size_t                  m_DefaultIndex;    //< Baked component passed by name if not supplied, or invalid
+		};
+
+		// Baked parameters fed by one type of parameter set, resolved by name the first time a deploy is passed that
+		// type so later deploys copy values without any name lookups
+		struct SuppliedBinding
+		{
+			const Reflect::MetaStruct*  m_Type;
+			size_t                  m_FirstField;      //< First entry in m_BindingFields
+			size_t                  m_FieldCount;
+		};
+
+		struct BindingField
+		{
+			const Reflect::Field*   m_Field;           //< Field of the parameter set
+			size_t                  m_ParameterIndex;  //< Baked parameter it feeds
+		};
+
+		struct SuppliedValue
+		{
+			const ParameterSet*     m_Set;             //< Null if nothing in the chain supplies the parameter
+			const Reflect::Field*   m_Field;
+		};
+
+		size_t GetBinding( const Reflect::MetaStruct *pType );
+		void ApplyParameters( const ParameterSet *pParameterSet );
+		void DeployRange( Components::IHasComponents &rHasComponents, size_t begin, size_t end, DynamicArray<PendingFinalize> *pPending );
+
+		DynamicArray<BakedComponent> m_Components;
+		DynamicArray<BakedParameter> m_Parameters;
+		DynamicArray<SuppliedBinding> m_Bindings;
+		DynamicArray<BindingField>   m_BindingFields;
+		DynamicArray<SuppliedValue>  m_SuppliedValues;       //< Scratch for Deploy(), one per baked parameter
+		size_t                       m_SetStart;             //< First baked component that came from the component set
+		bool                         m_Baked;
+	};
+}
+
+#include "Framework/Prefab.inl"
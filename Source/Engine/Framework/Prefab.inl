@@ -0,0 +1,7 @@
+namespace Helium
+{
+	bool Prefab::IsBaked() const
+	{
+		return m_Baked;
+	}
+}
@@ -56,6 +56,14 @@ Entity* Slice::CreateEntity(EntityDefinition *pEntityDefinition, ParameterSet *p
         return NULL;
     }
 
+    if( pParameterSet && IsDetached() )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "Slice::CreateEntity(): Parameter sets are not supported while a slice is detached.\n" );
+        return NULL;
+    }
+
     EntityPtr entity = pEntityDefinition->CreateEntity();
     HELIUM_ASSERT( entity.Get() );
     if (!entity)
@@ -68,7 +76,22 @@ Entity* Slice::CreateEntity(EntityDefinition *pEntityDefinition, ParameterSet *p
     HELIUM_ASSERT( IsValid( sliceIndex ) );
     entity->SetSliceInfo( this, sliceIndex );
 
-    pEntityDefinition->FinalizeEntity(entity, pParameterSet);
+    if( IsDetached() )
+    {
+        // Finalizing reaches into world systems, so it waits until the slice is attached.
+        PendingEntity* pPendingEntity = m_pendingEntities.New();
+        HELIUM_ASSERT( pPendingEntity );
+        pPendingEntity->spDefinition = pEntityDefinition;
+        pPendingEntity->firstFinalize = m_pendingFinalizes.GetSize();
+
+        pEntityDefinition->FinalizeEntityDeferred( entity, m_pendingFinalizes );
+
+        pPendingEntity->finalizeCount = m_pendingFinalizes.GetSize() - pPendingEntity->firstFinalize;
+    }
+    else
+    {
+        pEntityDefinition->FinalizeEntity(entity, pParameterSet);
+    }
 
     return entity.Get();
 }
@@ -96,6 +119,13 @@ bool Slice::DestroyEntity( Entity* pEntity )
         return false;
     }
 
+    // Notify any listener while the entity is still bound to this slice.
+    const Delegate<Entity*>& rOnDestroyed = pEntity->GetOnDestroyed();
+    if( rOnDestroyed.Valid() )
+    {
+        rOnDestroyed.Invoke( pEntity );
+    }
+
     // Clear the entity's references back to this slice and remove it from the entity list.
     size_t index = pEntity->GetSliceIndex();
     HELIUM_ASSERT( index < m_entities.GetSize() );
@@ -117,6 +147,121 @@ bool Slice::DestroyEntity( Entity* pEntity )
 }
 
 
+/// Start building this slice outside of any world.
+///
+/// Until the slice is added to a world with World::AddSlice(), entities created in it get their components from
+/// pools owned by the slice, so nothing running in the world sees them.  Components are created and initialized
+/// right away, while finalizing them (which is where components register with world systems such as physics and
+/// rendering) waits until the slice is attached.  Attaching splices the slice's pools into the world's pools without
+/// moving any component, so entities can be built over several frames and then appear in the world all at once.
+///
+/// Prefab deploys and ComponentPtr bookkeeping are shared with the rest of the engine, so a detached slice must
+/// still be built on the main thread.
+///
+/// @param[in] pWorld  World to which the slice will be added.
+///
+/// @return  True if the slice is now detached, false if it already has entities or is bound to a world.
+///
+/// @see IsDetached(), AttachDetachedComponents(), World::AddSlice()
+bool Slice::BeginDetachedBuild( World* pWorld )
+{
+    HELIUM_ASSERT( pWorld );
+    HELIUM_ASSERT( pWorld->GetComponentManager() );
+
+    if( m_spWorld || IsDetached() || !m_entities.IsEmpty() )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "Slice::BeginDetachedBuild(): Slice must be empty and not yet bound to a world.\n" );
+
+        return false;
+    }
+
+    // Components already know their world while detached, so they can find it during initialization.
+    m_spDetachedComponents = Components::CreateManager( pWorld );
+    HELIUM_ASSERT( m_spDetachedComponents.Ptr() );
+
+    return true;
+}
+
+/// Get the component manager from which entities in this slice allocate their components.
+///
+/// @return  Slice-owned component manager while detached, the world's component manager when bound to a world, or
+///          null otherwise.
+///
+/// @see BeginDetachedBuild(), IsDetached()
+ComponentManager* Slice::GetComponentManager()
+{
+    if( IsDetached() )
+    {
+        return m_spDetachedComponents.Ptr();
+    }
+
+    World* pWorld = GetWorld();
+
+    return pWorld ? pWorld->GetComponentManager() : NULL;
+}
+
+/// Move the components of a detached slice into the pools of the world it was built for.
+///
+/// This is only called by World::AddSlice(), before the slice is registered with the world.  Entities are not
+/// finalized until FinalizePendingEntities() is called.
+///
+/// @param[in] pWorld  World to which the slice is being added.
+///
+/// @return  True if the components were moved and the slice is no longer detached, false if not.
+///
+/// @see BeginDetachedBuild(), FinalizePendingEntities()
+bool Slice::AttachDetachedComponents( World* pWorld )
+{
+    HELIUM_ASSERT( pWorld );
+    HELIUM_ASSERT( IsDetached() );
+
+    ComponentManager* pDetachedComponents = m_spDetachedComponents.Ptr();
+    if( pDetachedComponents->GetWorld() != pWorld )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "Slice::AttachDetachedComponents(): Slice was built for a different world.\n" );
+
+        return false;
+    }
+
+    ComponentManager* pWorldComponents = pWorld->GetComponentManager();
+    HELIUM_ASSERT( pWorldComponents );
+    if( !pWorldComponents->AdoptComponents( *pDetachedComponents ) )
+    {
+        return false;
+    }
+
+    m_spDetachedComponents.Reset();
+
+    return true;
+}
+
+/// Finalize the components of entities created while this slice was detached.
+///
+/// @see BeginDetachedBuild(), AttachDetachedComponents()
+void Slice::FinalizePendingEntities()
+{
+    HELIUM_ASSERT( !IsDetached() );
+    HELIUM_ASSERT( m_spWorld );
+
+    size_t pendingEntityCount = m_pendingEntities.GetSize();
+    for( size_t pendingEntityIndex = 0; pendingEntityIndex < pendingEntityCount; ++pendingEntityIndex )
+    {
+        const PendingEntity& rPendingEntity = m_pendingEntities[ pendingEntityIndex ];
+        HELIUM_ASSERT( rPendingEntity.spDefinition );
+
+        rPendingEntity.spDefinition->FinalizePendingEntity(
+            m_pendingFinalizes.GetData() + rPendingEntity.firstFinalize,
+            rPendingEntity.finalizeCount );
+    }
+
+    m_pendingEntities.Clear();
+    m_pendingFinalizes.Clear();
+}
+
 /// Set the world to which this slice is currently bound, along with the index of this slice within the world.
 ///
 /// @param[in] pWorld      World to set.
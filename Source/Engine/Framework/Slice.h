@@ -3,11 +3,13 @@
 #include "Framework/Framework.h"
 
 #include "Framework/ParameterSet.h"
+#include "Framework/Prefab.h"
 #include "Reflect/Object.h"
 
 namespace Helium
 {
     class EntityDefinition;
+    typedef Helium::StrongPtr< EntityDefinition > EntityDefinitionPtr;
 
     class World;
     typedef Helium::WeakPtr< World > WorldWPtr;
@@ -58,14 +60,44 @@ namespace Helium
         void ClearWorldInfo();
         //@}
 
+        /// @name Detached Building
+        //@{
+        bool BeginDetachedBuild( World* pWorld );
+        inline bool IsDetached() const;
+        ComponentManager* GetComponentManager();
+
+        bool AttachDetachedComponents( World* pWorld );
+        void FinalizePendingEntities();
+        //@}
+
         Helium::SceneDefinition *GetSceneDefinition() const;
 
     private:
+        /// Entity created while detached that still has components to finalize.
+        struct PendingEntity
+        {
+            /// Definition the entity was created from.
+            EntityDefinitionPtr spDefinition;
+            /// Index of the first of its entries in m_pendingFinalizes.
+            size_t firstFinalize;
+            /// Number of its entries in m_pendingFinalizes.
+            size_t finalizeCount;
+        };
+
         Helium::SceneDefinitionPtr m_spSceneDefinition;
 
+        /// Components of the entities built while detached, or null once attached (declared ahead of the entities so
+        /// that it outlives them).
+        ComponentManagerPtr m_spDetachedComponents;
+
         /// Entities.
         DynamicArray< EntityPtr > m_entities;
 
+        /// Entities created while detached, in creation order.
+        DynamicArray< PendingEntity > m_pendingEntities;
+        /// Components created while detached that are finalized once the slice is attached.
+        DynamicArray< Prefab::PendingFinalize > m_pendingFinalizes;
+
         /// Slice world.
         WorldWPtr m_spWorld;
         /// Runtime index for the slice within its world.
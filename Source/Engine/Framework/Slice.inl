@@ -21,4 +21,14 @@ namespace Helium
         return m_entities.GetSize();
     }
 
+    /// Get whether this slice is being built outside of its world.
+    ///
+    /// @return  True if BeginDetachedBuild() was called and the slice has not been added to its world yet.
+    ///
+    /// @see BeginDetachedBuild(), GetComponentManager()
+    bool Slice::IsDetached() const
+    {
+        return m_spDetachedComponents.Ptr() != NULL;
+    }
+
 }
@@ -45,6 +45,8 @@ void StateMachineDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
 
 /// Constructor.
 StateMachineDefinition::StateMachineDefinition()
+: m_InitialState( NULL )
+, m_MaxTransitionCount( 0 )
 {
 }
 
@@ -119,24 +121,8 @@ void StateMachineDefinition::FinalizeLoad()
 			}
 			else
 			{
-				for ( DynamicArray< Name >::Iterator flagIter = stateIter->m_StateFlags.Begin();
-					flagIter != stateIter->m_StateFlags.End(); ++flagIter )
-				{
-					StateBitmask bits = 0;
-					if (m_StateFlagSet->GetFlag(*flagIter, bits))
-					{
-						stateIter->m_StateBitmask |= bits;
-					}
-					else
-					{
-						HELIUM_TRACE(
-							TraceLevels::Warning,
-							"BulletBodyComponentDefinition::FinalizeLoad - Body '%s' refers to a body flag '%s' in field m_AssignedGroupFlags that does not exist. Is the flag defined in '%s'?\n",
-							*GetPath().ToString(),
-							**flagIter,
-							*m_StateFlagSet->GetPath().ToString());
-					}
-				}
+				// Warns about any flag missing from the flag set
+				m_StateFlagSet->GetBitset( stateIter->m_StateFlags, stateIter->m_StateBitmask );
 			}
 		}
 
@@ -175,6 +161,52 @@ void StateMachineDefinition::FinalizeLoad()
 			*GetPath().ToString(),
 			*m_InitialStateName);
 	}
+
+	CompileTransitions();
+}
+
+void StateMachineDefinition::CompileTransitions()
+{
+	m_CompiledStates.Resize( 0 );
+	m_CompiledTransitions.Resize( 0 );
+	m_MaxTransitionCount = 0;
+
+	m_CompiledStates.Reserve( m_States.GetSize() );
+	for ( DynamicArray<State>::Iterator stateIter = m_States.Begin();
+		stateIter != m_States.End(); ++stateIter )
+	{
+		stateIter->m_CompiledIndex = static_cast< uint32_t >( m_CompiledStates.GetSize() );
+
+		CompiledState *pCompiledState = m_CompiledStates.New();
+		HELIUM_ASSERT( pCompiledState );
+		pCompiledState->m_FirstTransition = static_cast< uint32_t >( m_CompiledTransitions.GetSize() );
+		pCompiledState->m_TransitionCount = 0;
+		pCompiledState->m_EarliestTransitionTime = NumericLimits< float32_t >::Maximum;
+
+		for ( DynamicArray<StateTransition>::Iterator transitionIter = stateIter->m_Transitions.Begin();
+			transitionIter != stateIter->m_Transitions.End(); ++transitionIter )
+		{
+			// Transitions to unknown states were reported above and can never be taken
+			if ( !transitionIter->m_NextState )
+			{
+				continue;
+			}
+
+			CompiledTransition *pCompiledTransition = m_CompiledTransitions.New();
+			HELIUM_ASSERT( pCompiledTransition );
+			pCompiledTransition->m_NextState = transitionIter->m_NextState;
+			pCompiledTransition->m_RequiredPredicate = transitionIter->m_RequiredPredicate.Get();
+			pCompiledTransition->m_MinimumTimeInState = Max( transitionIter->m_MinimumTimeInState, 0.0f );
+			pCompiledTransition->m_RequiredPredicateResult = transitionIter->m_RequiredPredicateResult;
+
+			++pCompiledState->m_TransitionCount;
+			pCompiledState->m_EarliestTransitionTime = Min(
+				pCompiledState->m_EarliestTransitionTime,
+				pCompiledTransition->m_MinimumTimeInState );
+		}
+
+		m_MaxTransitionCount = Max( m_MaxTransitionCount, pCompiledState->m_TransitionCount );
+	}
 }
 
 void StateMachineInstance::Initialize( World &world, const StateMachineDefinition *pStateMachineDefinition )
@@ -182,26 +214,49 @@ void StateMachineInstance::Initialize( World &world, const StateMachineDefinitio
 	HELIUM_ASSERT( pStateMachineDefinition );
 	m_Definition = pStateMachineDefinition;
 	m_CurrentState = pStateMachineDefinition->m_InitialState;
-	OnEnterState( world, m_CurrentState );
+	m_TransitionCaches.Resize( pStateMachineDefinition->m_MaxTransitionCount );
+
+	if ( m_CurrentState )
+	{
+		OnEnterState( world, m_CurrentState );
+	}
 }
 
 void StateMachineInstance::Tick( World &world, float dt )
 {
+	if ( !m_CurrentState )
+	{
+		return;
+	}
+
 	float timeInTick = dt;
 
 	while ( timeInTick > 0.0f )
 	{
+		HELIUM_ASSERT( m_CurrentState->m_CompiledIndex < m_Definition->m_CompiledStates.GetSize() );
+		const StateMachineDefinition::CompiledState &compiledState =
+			m_Definition->m_CompiledStates[ m_CurrentState->m_CompiledIndex ];
+
+		// Time-only transitions act as timers: nothing can happen before the earliest of them is due
+		if ( m_TimeInState + timeInTick < compiledState.m_EarliestTransitionTime )
+		{
+			m_TimeInState += timeInTick;
+			break;
+		}
+
 		bool m_Transitioned = false;
-		for ( DynamicArray<StateTransition>::Iterator iter = m_CurrentState->m_Transitions.Begin();
-			iter != m_CurrentState->m_Transitions.End(); ++iter )
+		for ( uint32_t i = 0; i < compiledState.m_TransitionCount; ++i )
 		{
+			const StateMachineDefinition::CompiledTransition &transition =
+				m_Definition->m_CompiledTransitions[ compiledState.m_FirstTransition + i ];
+
 			float timeToConsume;
-			if ( EvaluateTransition( world, *iter, timeInTick, timeToConsume ) )
+			if ( EvaluateTransition( world, transition, m_TransitionCaches[ i ], timeInTick, timeToConsume ) )
 			{
 				timeInTick -= timeToConsume;
 				m_TimeInState += timeToConsume;
 
-				DoTransition( world, m_CurrentState, iter->m_NextState );
+				DoTransition( world, m_CurrentState, transition.m_NextState );
 
 				m_Transitioned = true;
 				break;
@@ -216,21 +271,37 @@ void StateMachineInstance::Tick( World &world, float dt )
 	}
 }
 
-bool StateMachineInstance::EvaluateTransition( World &world, StateTransition &transition, float dt, float &timeToConsume )
+bool StateMachineInstance::EvaluateTransition(
+	World &world,
+	const StateMachineDefinition::CompiledTransition &transition,
+	TransitionCache &cache,
+	float dt,
+	float &timeToConsume )
 {
 	if ( m_TimeInState + dt < transition.m_MinimumTimeInState )
 	{
 		return false;
 	}
 
-	// Do additional checking
-	if ( transition.m_RequiredPredicate && !transition.m_RequiredPredicate->Evaluate( world, NULL ) )
+	// Do additional checking, only evaluating the predicate again if its inputs have changed since it last was
+	if ( transition.m_RequiredPredicate )
 	{
-		return false;
+		uint32_t inputStamp = transition.m_RequiredPredicate->GetInputStamp( world, NULL );
+		if ( IsInvalid( inputStamp ) || inputStamp != cache.m_InputStamp )
+		{
+			cache.m_PredicateResult = transition.m_RequiredPredicate->Evaluate( world, NULL );
+			cache.m_InputStamp = inputStamp;
+		}
+
+		if ( cache.m_PredicateResult != transition.m_RequiredPredicateResult )
+		{
+			return false;
+		}
 	}
 
-	timeToConsume = transition.m_MinimumTimeInState - m_TimeInState;
-	HELIUM_ASSERT(timeToConsume >= 0.0f);
+	// The transition happens as soon as the minimum time in state is reached, which may have been earlier than this
+	// tick if the predicate only just passed
+	timeToConsume = Max( transition.m_MinimumTimeInState - m_TimeInState, 0.0f );
 	HELIUM_ASSERT(timeToConsume <= dt);
 	return true;
 }
@@ -254,6 +325,13 @@ void StateMachineInstance::OnEnterState( World &world, State *pState )
 
 	m_TimeInState = 0.0f;
 
+	for ( DynamicArray<TransitionCache>::Iterator cacheIter = m_TransitionCaches.Begin();
+		cacheIter != m_TransitionCaches.End(); ++cacheIter )
+	{
+		SetInvalid( cacheIter->m_InputStamp );
+		cacheIter->m_PredicateResult = false;
+	}
+
 	if (pState->m_OnEnterAction)
 	{
 		pState->m_OnEnterAction->PerformAction( world, NULL );
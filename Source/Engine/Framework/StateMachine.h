@@ -46,7 +46,7 @@ namespace Helium
 
 	public:
 
-		State() : m_StateBitmask(0) { }
+		State() : m_StateBitmask(0), m_CompiledIndex(Invalid< uint32_t >()) { }
 		virtual ~State() { }
 
 		DynamicArray<StateTransition> m_Transitions;
@@ -54,6 +54,7 @@ namespace Helium
 		DynamicArray<Name> m_StateFlags;
 
 		StateBitmask m_StateBitmask; // Generated based on m_StateFlags
+		uint32_t m_CompiledIndex; // Index in the compiled state table of the state machine, generated on load
 
 		ActionPtr m_OnEnterAction;
 		ActionPtr m_OnExitAction;
@@ -78,39 +79,84 @@ namespace Helium
 	private:
 		friend StateMachineInstance;
 
+		// Transition of the flat transition table (only transitions to a valid state are compiled)
+		struct CompiledTransition
+		{
+			State *m_NextState;
+			Predicate *m_RequiredPredicate;
+			float m_MinimumTimeInState;
+			bool m_RequiredPredicateResult;
+		};
+
+		// Range of the flat transition table holding the transitions of a state
+		struct CompiledState
+		{
+			uint32_t m_FirstTransition;
+			uint32_t m_TransitionCount;
+			float m_EarliestTransitionTime; // No transition out of the state can happen before this long in the state
+		};
+
+		void CompileTransitions();
+
 		DynamicArray<State> m_States;
 		FlagSetDefinitionPtr m_StateFlagSet;
 		Name m_InitialStateName;
 
 		State *m_InitialState; // Generated based on name
+
+		DynamicArray<CompiledState> m_CompiledStates; // Indexed by State::m_CompiledIndex
+		DynamicArray<CompiledTransition> m_CompiledTransitions;
+		uint32_t m_MaxTransitionCount; // Most transitions out of a single state
 	};
 	typedef Helium::StrongPtr<StateMachineDefinition> StateMachineDefinitionPtr;
 	typedef Helium::StrongPtr<const StateMachineDefinition> ConstStateMachineDefinitionPtr;
 
+	// Transitions are evaluated from the compiled transition table of the definition. Nothing is evaluated until the
+	// earliest time a transition out of the current state could happen, and the result of each predicate is kept
+	// until its input stamp changes
 	class HELIUM_FRAMEWORK_API StateMachineInstance : public Reflect::Object
 	{
 	public:
-		StateMachineInstance() { }
+		StateMachineInstance() : m_CurrentState(NULL), m_TimeInState(0.0f) { }
 		virtual ~StateMachineInstance() { }
 
 		void Initialize( World &world, const StateMachineDefinition *pStateMachineDefinition );
 
 		void Tick( World &pWorld, float dt );
 
-		bool EvaluateTransition( World &world, StateTransition &transition, float dt, float &timeToConsume );
 		void DoTransition( World &world, State *pOldState, State *pNewState );
 		void OnEnterState( World &world, State *pState );
 		void OnExitState( World &world, State *pState );
 
 		StateBitmask GetCurrentFlags() const { return m_CurrentState ? m_CurrentState->m_StateBitmask : 0; }
 
+		// True if the current state has all the required flags and none of the excluded ones
+		bool HasFlags( StateBitmask required, StateBitmask excluded = 0 ) const { return FlagsMatch( GetCurrentFlags(), required, excluded ); }
+
 	private:
+		// Last predicate result of a transition out of the current state
+		struct TransitionCache
+		{
+			uint32_t m_InputStamp; // Invalid until the predicate has been evaluated in the current state
+			bool m_PredicateResult;
+		};
+
+		bool EvaluateTransition(
+			World &world,
+			const StateMachineDefinition::CompiledTransition &transition,
+			TransitionCache &cache,
+			float dt,
+			float &timeToConsume );
+
 		ConstStateMachineDefinitionPtr m_Definition;
 
 		// Current state
 		State *m_CurrentState;
 		float m_TimeInState;
 
+		// Indexed like the transitions of the current state
+		DynamicArray<TransitionCache> m_TransitionCaches;
+
 		DynamicArray<StateMachineInstance> m_SubStateMachines;
 	};
 }
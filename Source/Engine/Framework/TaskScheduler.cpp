@@ -1,7 +1,18 @@
 
 #include "Precompile.h"
 #include "TaskScheduler.h"
+#include "Framework/World.h"
 #include "Foundation/Map.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/FileStream.h"
+#include "Foundation/BufferedStream.h"
+#include "Engine/FileLocations.h"
+#include "Platform/Atomic.h"
+#include "Platform/Locks.h"
+#include "Platform/Thread.h"
+#include "EngineJobs/JobManager.h"
+#include "Engine/FrameProfiler.h"
+#include "Platform/Timer.h"
 
 using namespace Helium;
 
@@ -9,27 +20,494 @@ using namespace Helium;
 TaskDefinition *TaskDefinition::s_FirstTaskDefinition = NULL;
 bool TaskScheduler::m_ContractsDefined = false;
 
+/// Whether DefineContract has been called on every task (contracts may be defined without being resolved into
+/// required tasks, when a saved schedule is loaded).
+static bool s_ContractTermsDefined = false;
+
+/// Version of the saved schedule format.
+static const uint32_t SCHEDULE_FILE_VERSION = 1;
+
+/// Whether the task (or job split from a task) running on this thread may split its work further.
+static thread_local bool s_SplitExecutionAllowed = false;
+
+#if HELIUM_ASSERT_ENABLED
+/// Task running on this thread, for checking its component accesses against its contract.
+static thread_local const TaskDefinition *s_pRunningTask = NULL;
+#endif
+
+/// Number of schedules executed so far, used to stagger tasks that don't run every frame.
+static uint32_t s_ScheduleFrameIndex = 0;
+/// Frames since each task of the executing schedule last ran, or zero if it is skipped this frame. Only written before
+/// the schedule starts executing, and indexed like the schedule.
+static DynamicArray< uint32_t > s_TaskFramesSinceLastRun;
+
+/// Frames since the task running on this thread last ran.
+static thread_local uint32_t s_RunningTaskFramesSinceLastRun = 1;
+/// Tick count at which the task running on this thread runs out of its time budget, or zero if it has none.
+static thread_local uint64_t s_RunningTaskBudgetEndTicks = 0;
+
+/// Whether tasks are timed as they run.
+static bool s_TaskTimingEnabled = true;
+/// How each task of the last executed schedule ran. Each task only writes its own entry (its ready time is written by
+/// the thread that queued it, before it starts), and the array is only resized before a schedule starts executing.
+static DynamicArray< TaskTiming > s_TaskTimings;
+
+/// Index of this thread in task timings, or invalid until it first runs a task.
+static thread_local uint32_t s_TaskThreadIndex = Invalid< uint32_t >();
+/// Number of threads that have run a task.
+static volatile int32_t s_TaskThreadCount = 0;
+
+/// Whether the last schedule was executed in parallel.
+static bool s_LastScheduleParallel = false;
+
+/// Executed schedules between timing summaries, or zero to not log them.
+static uint32_t s_TimingLogInterval = 0;
+/// Executed schedules accumulated since the last timing summary.
+static uint32_t s_TimingLogFrameCount = 0;
+
+namespace
+{
+	/// Task timing accumulated since the last timing summary.
+	struct TaskTimingTotals
+	{
+		uint64_t m_WallTicks;
+		uint64_t m_MaxWallTicks;
+		uint64_t m_WaitTicks;
+		/// Bit set for each thread the task ran on (threads past the 64th share the last bit).
+		uint64_t m_ThreadMask;
+	};
+
+	/// Totals for each task of the schedule given to s_pTimingTotalsSchedule.
+	DynamicArray< TaskTimingTotals > s_TaskTimingTotals;
+	const TaskSchedule *s_pTimingTotalsSchedule = NULL;
+
+	/// Get the index of the calling thread in task timings.
+	uint32_t GetTaskThreadIndex()
+	{
+		if ( IsInvalid( s_TaskThreadIndex ) )
+		{
+			s_TaskThreadIndex = static_cast< uint32_t >( AtomicIncrementUnsafe( s_TaskThreadCount ) - 1 );
+		}
+
+		return s_TaskThreadIndex;
+	}
+
+	/// Convert a tick count to milliseconds.
+	float64_t TaskTicksToMilliseconds( uint64_t ticks )
+	{
+		return static_cast< float64_t >( ticks ) * Timer::GetSecondsPerTick() * 1000.0;
+	}
+
+	/// Call the function of a scheduled task, unless the task is skipped this frame.
+	void CallScheduledTask( const TaskSchedule &rSchedule, uint32_t taskIndex, DynamicArray< WorldPtr > &rWorlds )
+	{
+		const uint32_t framesSinceLastRun = s_TaskFramesSinceLastRun[ taskIndex ];
+		if ( !framesSinceLastRun )
+		{
+			return;
+		}
+
+		const TaskDefinition *pTask = rSchedule.m_ScheduleInfo[ taskIndex ];
+		const TaskContract &rContract = pTask->m_Contract;
+
+		// Pass the task only the worlds that have it enabled. Worlds rarely disable anything, so the filtered list is
+		// only built once a world is found that disables this task
+		DynamicArray< WorldPtr > *pWorlds = &rWorlds;
+		DynamicArray< WorldPtr > enabledWorlds;
+		for ( size_t i = 0; i < rWorlds.GetSize(); ++i )
+		{
+			World *pWorld = rWorlds[ i ].Get();
+			if ( pWorld->HasDisabledTasks() && !pWorld->IsTaskEnabled( *pTask ) )
+			{
+				if ( pWorlds == &rWorlds )
+				{
+					enabledWorlds.Add( rWorlds.GetData(), i );
+					pWorlds = &enabledWorlds;
+				}
+			}
+			else if ( pWorlds != &rWorlds )
+			{
+				enabledWorlds.Push( rWorlds[ i ] );
+			}
+		}
+
+		if ( !rWorlds.IsEmpty() && pWorlds->IsEmpty() )
+		{
+			return;
+		}
+
+		bool bPreviousAllowed = TaskScheduler::SetSplitExecutionAllowed( rContract.m_DisjointComponentWrites );
+#if HELIUM_ASSERT_ENABLED
+		const TaskDefinition *pPreviousTask = s_pRunningTask;
+		s_pRunningTask = pTask;
+#endif
+		const uint32_t previousFramesSinceLastRun = s_RunningTaskFramesSinceLastRun;
+		const uint64_t previousBudgetEndTicks = s_RunningTaskBudgetEndTicks;
+		s_RunningTaskFramesSinceLastRun = framesSinceLastRun;
+		s_RunningTaskBudgetEndTicks = 0;
+		if ( rContract.m_TimeBudgetMilliseconds > 0.0f )
+		{
+			const float64_t budgetTicks = static_cast< float64_t >( rContract.m_TimeBudgetMilliseconds ) / ( Timer::GetSecondsPerTick() * 1000.0 );
+			s_RunningTaskBudgetEndTicks = Timer::GetTickCount() + static_cast< uint64_t >( budgetTicks );
+		}
+
+		rSchedule.m_ScheduleFunc[ taskIndex ]( *pWorlds );
+
+		s_RunningTaskFramesSinceLastRun = previousFramesSinceLastRun;
+		s_RunningTaskBudgetEndTicks = previousBudgetEndTicks;
+#if HELIUM_ASSERT_ENABLED
+		s_pRunningTask = pPreviousTask;
+#endif
+		TaskScheduler::SetSplitExecutionAllowed( bPreviousAllowed );
+	}
+
+	typedef Locker< DynamicArray< uint32_t >, SpinLock > ReadyTaskQueue;
+
+	/// State shared between the thread executing a schedule and the jobs running its concurrent tasks.
+	struct ParallelScheduleState
+	{
+		const TaskSchedule *m_pSchedule;
+		DynamicArray< WorldPtr > *m_pWorlds;
+		JobManager *m_pJobManager;
+
+		/// Dependencies not yet completed for each scheduled task this frame.
+		DynamicArray< int32_t > m_RemainingDependencies;
+		/// Identity table of task indices, so each concurrent task job can be handed a stable pointer to its index.
+		DynamicArray< uint32_t > m_TaskIndices;
+		/// Ready tasks that must run on the thread executing the schedule.
+		ReadyTaskQueue m_ExecutingThreadQueue;
+		/// Counter for the concurrent task jobs spawned this frame.
+		JobCounter m_ConcurrentTaskCounter;
+
+		/// Number of tasks completed this frame.
+		volatile int32_t m_CompletedCount;
+	};
+
+	ParallelScheduleState s_ParallelState;
+
+	void RunScheduledTaskJob( void *pTaskIndex );
+
+	/// Queue a task whose dependencies have all completed.
+	void QueueReadyTask( uint32_t taskIndex )
+	{
+		ParallelScheduleState &rState = s_ParallelState;
+
+		if ( s_TaskTimingEnabled )
+		{
+			s_TaskTimings[ taskIndex ].m_ReadyTicks = Timer::GetTickCount();
+		}
+
+		if ( rState.m_pSchedule->m_ScheduleInfo[ taskIndex ]->m_Contract.IsConcurrent() )
+		{
+			rState.m_pJobManager->Spawn( RunScheduledTaskJob, &rState.m_TaskIndices[ taskIndex ], rState.m_ConcurrentTaskCounter );
+		}
+		else
+		{
+			ReadyTaskQueue::Handle handle( rState.m_ExecutingThreadQueue );
+			handle->Push( taskIndex );
+		}
+	}
+
+	/// Run a scheduled task, then queue any task that was only waiting on it.
+	void RunScheduledTask( uint32_t taskIndex )
+	{
+		ParallelScheduleState &rState = s_ParallelState;
+		const TaskSchedule &rSchedule = *rState.m_pSchedule;
+		{
+			HELIUM_FRAME_PROFILER_SCOPE( rSchedule.m_ScheduleInfo[ taskIndex ]->m_Name );
+			const uint64_t startTicks = s_TaskTimingEnabled ? Timer::GetTickCount() : 0;
+			CallScheduledTask( rSchedule, taskIndex, *rState.m_pWorlds );
+			if ( s_TaskTimingEnabled )
+			{
+				TaskTiming &rTiming = s_TaskTimings[ taskIndex ];
+				rTiming.m_StartTicks = startTicks;
+				rTiming.m_EndTicks = Timer::GetTickCount();
+				rTiming.m_ThreadIndex = GetTaskThreadIndex();
+			}
+		}
+
+		// Release any task that was only waiting on this one
+		const uint32_t dependentsEnd = rSchedule.m_DependentsOffsets[ taskIndex + 1 ];
+		for ( uint32_t i = rSchedule.m_DependentsOffsets[ taskIndex ]; i < dependentsEnd; ++i )
+		{
+			const uint32_t dependentIndex = rSchedule.m_Dependents[ i ];
+			if ( AtomicDecrementRelease( rState.m_RemainingDependencies[ dependentIndex ] ) == 0 )
+			{
+				QueueReadyTask( dependentIndex );
+			}
+		}
+
+		AtomicIncrementRelease( rState.m_CompletedCount );
+	}
+
+	/// Job entry point for tasks that allow concurrent execution.
+	void RunScheduledTaskJob( void *pTaskIndex )
+	{
+		HELIUM_ASSERT( pTaskIndex );
+		RunScheduledTask( *static_cast< const uint32_t * >( pTaskIndex ) );
+	}
+
+	/// Pop and run the next task that must run on the thread executing the schedule.
+	///
+	/// @return  True if a task was run, false if none was ready.
+	bool RunNextExecutingThreadTask()
+	{
+		uint32_t taskIndex;
+		{
+			ReadyTaskQueue::Handle handle( s_ParallelState.m_ExecutingThreadQueue );
+			if ( handle->IsEmpty() )
+			{
+				return false;
+			}
+
+			taskIndex = handle->Pop();
+		}
+
+		RunScheduledTask( taskIndex );
+		return true;
+	}
+
+	/// Run a task on the calling thread over the given worlds, recording its timing in rTiming if timing is enabled.
+	void RunTaskOnThisThread( const TaskSchedule &rSchedule, uint32_t taskIndex, DynamicArray< WorldPtr > &rWorlds, TaskTiming &rTiming )
+	{
+		HELIUM_FRAME_PROFILER_SCOPE( rSchedule.m_ScheduleInfo[ taskIndex ]->m_Name );
+		const uint64_t startTicks = s_TaskTimingEnabled ? Timer::GetTickCount() : 0;
+
+		// Worlds and component tuples may still be split into jobs, if the job manager is running
+		CallScheduledTask( rSchedule, taskIndex, rWorlds );
+		if ( s_TaskTimingEnabled )
+		{
+			// Tasks run one after another are ready as soon as the previous task ends, so they never wait
+			rTiming.m_ReadyTicks = startTicks;
+			rTiming.m_StartTicks = startTicks;
+			rTiming.m_EndTicks = Timer::GetTickCount();
+			rTiming.m_ThreadIndex = GetTaskThreadIndex();
+		}
+	}
+
+	/// A world and the range of scheduled tasks it runs as one job of a sharded schedule.
+	struct WorldShard
+	{
+		const TaskSchedule *m_pSchedule;
+		/// Just the shard's world, since task functions take an array of worlds.
+		DynamicArray< WorldPtr > m_Worlds;
+		/// Timing of each scheduled task in this shard, indexed like the schedule (only set if timing is enabled).
+		TaskTiming *m_pTimings;
+		uint32_t m_FirstTask;
+		uint32_t m_EndTask;
+	};
+
+	/// Shards of the schedule being executed by ExecuteScheduleSharded(), one per world.
+	DynamicArray< WorldShard > s_WorldShards;
+	/// Task timings of every shard, one schedule's worth per world.
+	DynamicArray< TaskTiming > s_WorldShardTimings;
+
+	/// Job entry point running the current range of a world shard.
+	void RunWorldShardJob( void *pShard )
+	{
+		HELIUM_ASSERT( pShard );
+		WorldShard &rShard = *static_cast< WorldShard * >( pShard );
+
+		TaskTiming unusedTiming;
+		for ( uint32_t taskIndex = rShard.m_FirstTask; taskIndex < rShard.m_EndTask; ++taskIndex )
+		{
+			RunTaskOnThisThread( *rShard.m_pSchedule, taskIndex, rShard.m_Worlds, rShard.m_pTimings ? rShard.m_pTimings[ taskIndex ] : unusedTiming );
+		}
+	}
+
+	/// Whether a task touches engine-wide state, either itself or through a dependency it contributes to.
+	bool IsEngineGlobalTask( const TaskDefinition *pTask )
+	{
+		if ( pTask->m_Contract.m_EngineGlobal )
+		{
+			return true;
+		}
+
+		// Every task contributes to itself
+		for ( A_TaskDefinitionPtr::ConstIterator iter = pTask->m_Contract.m_ContributedDependencies.Begin();
+			iter != pTask->m_Contract.m_ContributedDependencies.End(); ++iter )
+		{
+			if ( *iter != pTask && IsEngineGlobalTask( *iter ) )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/// Fold a value into a contract signature.
+	void MixSignature( uint64_t &rSignature, uint64_t value )
+	{
+		rSignature = ( rSignature ^ value ) * 1099511628211ULL;
+	}
+
+	/// Read a value from a saved schedule buffer, advancing the read position.
+	template< typename T >
+	bool ReadScheduleValue( T &rValue, const uint8_t *&rpCurrent, const uint8_t *pEnd )
+	{
+		if ( static_cast< size_t >( pEnd - rpCurrent ) < sizeof( T ) )
+		{
+			return false;
+		}
+
+		MemoryCopy( &rValue, rpCurrent, sizeof( T ) );
+		rpCurrent += sizeof( T );
+
+		return true;
+	}
+
+	/// Read an array of indices from a saved schedule buffer, advancing the read position. Every index must be less
+	/// than indexLimit.
+	bool ReadScheduleIndices(
+		DynamicArray< uint32_t > &rIndices,
+		size_t count,
+		uint32_t indexLimit,
+		const uint8_t *&rpCurrent,
+		const uint8_t *pEnd )
+	{
+		rIndices.Resize( count );
+		for ( size_t i = 0; i < count; ++i )
+		{
+			if ( !ReadScheduleValue( rIndices[ i ], rpCurrent, pEnd ) || rIndices[ i ] >= indexLimit )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// Collect the scheduled tasks that must complete before a task may run. Tasks that were dropped from the
+	/// schedule (abstract tasks, or tasks for another tick type) are looked through so that ordering implied through
+	/// them is kept. Only tasks earlier in the serial order are considered, so the graph can never wait on itself.
+	/// Whether two component types overlap, because they are the same type or one implements the other.
+	bool DoComponentTypesOverlap( Components::TypeId typeA, Components::TypeId typeB )
+	{
+		if ( typeA == typeB )
+		{
+			return true;
+		}
+
+		const DynamicArray< Components::TypeId > &rImplementingA = Components::GetTypeData( typeA )->m_ImplementingTypes;
+		for ( DynamicArray< Components::TypeId >::ConstIterator iter = rImplementingA.Begin(); iter != rImplementingA.End(); ++iter )
+		{
+			if ( *iter == typeB )
+			{
+				return true;
+			}
+		}
+
+		const DynamicArray< Components::TypeId > &rImplementingB = Components::GetTypeData( typeB )->m_ImplementingTypes;
+		for ( DynamicArray< Components::TypeId >::ConstIterator iter = rImplementingB.Begin(); iter != rImplementingB.End(); ++iter )
+		{
+			if ( *iter == typeA )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/// Whether any type of one declared access list overlaps any type of the other.
+	bool DoComponentAccessesOverlap( const DynamicArray< ComponentTypeGetter > &rTypesA, const DynamicArray< ComponentTypeGetter > &rTypesB )
+	{
+		for ( DynamicArray< ComponentTypeGetter >::ConstIterator iterA = rTypesA.Begin(); iterA != rTypesA.End(); ++iterA )
+		{
+			for ( DynamicArray< ComponentTypeGetter >::ConstIterator iterB = rTypesB.Begin(); iterB != rTypesB.End(); ++iterB )
+			{
+				if ( DoComponentTypesOverlap( ( *iterA )(), ( *iterB )() ) )
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+#if HELIUM_ASSERT_ENABLED
+	/// Whether a type is covered by a declared access list, either directly or by implementing a declared type.
+	bool IsComponentTypeDeclared( const DynamicArray< ComponentTypeGetter > &rDeclared, Components::TypeId type )
+	{
+		for ( DynamicArray< ComponentTypeGetter >::ConstIterator iter = rDeclared.Begin(); iter != rDeclared.End(); ++iter )
+		{
+			const Components::TypeId declaredType = ( *iter )();
+			if ( declaredType == type )
+			{
+				return true;
+			}
+
+			const DynamicArray< Components::TypeId > &rImplementing = Components::GetTypeData( declaredType )->m_ImplementingTypes;
+			for ( DynamicArray< Components::TypeId >::ConstIterator typeIter = rImplementing.Begin(); typeIter != rImplementing.End(); ++typeIter )
+			{
+				if ( *typeIter == type )
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+#endif
+
+	void GatherScheduledPrerequisites(
+		const TaskDefinition *pTask,
+		uint32_t taskIndex,
+		const Map< const TaskDefinition *, uint32_t > &scheduleIndices,
+		A_TaskDefinitionPtr &rVisited,
+		DynamicArray< uint32_t > &rPrerequisites )
+	{
+		for ( A_TaskDefinitionPtr::ConstIterator iter = pTask->m_RequiredTasks.Begin();
+			iter != pTask->m_RequiredTasks.End(); ++iter )
+		{
+			bool bVisited = false;
+			for ( A_TaskDefinitionPtr::ConstIterator visitedIter = rVisited.Begin(); visitedIter != rVisited.End(); ++visitedIter )
+			{
+				if ( *visitedIter == *iter )
+				{
+					bVisited = true;
+					break;
+				}
+			}
+
+			if ( bVisited )
+			{
+				continue;
+			}
+
+			rVisited.Push( *iter );
+
+			Map< const TaskDefinition *, uint32_t >::ConstIterator indexIter = scheduleIndices.Find( *iter );
+			if ( indexIter == scheduleIndices.End() )
+			{
+				GatherScheduledPrerequisites( *iter, taskIndex, scheduleIndices, rVisited, rPrerequisites );
+			}
+			else if ( indexIter->Second() < taskIndex )
+			{
+				rPrerequisites.Push( indexIter->Second() );
+			}
+		}
+	}
+}
+
 bool InsertToTaskList(A_TaskDefinitionPtr &rTaskInfoList, DynamicArray<TaskFunc> &rTaskFuncList, A_TaskDefinitionPtr &rTaskStack, const TaskDefinition *pTask, uint32_t tickType);
 
 bool TaskScheduler::CalculateSchedule(uint32_t tickType, TaskSchedule &schedule)
 {	
-	// Call DoDefineContract on everything once, if we haven't already done so
+	// Resolve the contracts of everything once, if we haven't already done so
 	if (!TaskScheduler::m_ContractsDefined)
 	{
 		typedef DynamicArray<TaskDefinition *> A_TaskDefinitionPtrNonConst;
 		typedef Helium::Map<const TaskDefinition *, A_TaskDefinitionPtrNonConst > M_DependencyTaskMap;
 		M_DependencyTaskMap dependencyContributingTaskMap;
 
-		// For each task
-		TaskDefinition *task = TaskDefinition::s_FirstTaskDefinition;
-		while (task)
-		{
-			task->DoDefineContract();
-			task = task->m_Next;
-		}
+		DefineContracts();
 
 		// For each task
-		task = TaskDefinition::s_FirstTaskDefinition;
+		TaskDefinition *task = TaskDefinition::s_FirstTaskDefinition;
 		while (task)
 		{
 			// Look at all of its dependencies
@@ -205,57 +683,446 @@ bool TaskScheduler::CalculateSchedule(uint32_t tickType, TaskSchedule &schedule)
 	}
 #endif
 
+	BuildDependencyGraph(schedule);
+	FindShardBarriers(schedule);
+
 	return true;
 }
 
-bool InsertToTaskList(A_TaskDefinitionPtr &rTaskInfoList, DynamicArray<TaskFunc> &rTaskFuncList, A_TaskDefinitionPtr &rTaskStack, const TaskDefinition *pTask, uint32_t tickType)
+void TaskScheduler::BuildDependencyGraph( TaskSchedule &schedule )
 {
-	// Don't add functions that do not run under the given tick type
-	if ((pTask->m_Contract.m_TickType & tickType) == 0)
+	const uint32_t taskCount = static_cast< uint32_t >( schedule.m_ScheduleInfo.GetSize() );
+
+	Map< const TaskDefinition *, uint32_t > scheduleIndices;
+	for (uint32_t i = 0; i < taskCount; ++i)
 	{
-		return true;
+		scheduleIndices.Insert( Map< const TaskDefinition *, uint32_t >::ValueType( schedule.m_ScheduleInfo[i], i ) );
 	}
 
-	for (size_t i = 0; i < rTaskStack.GetSize(); ++i)
+	// Gather every (prerequisite, dependent) pair, counting the dependents of each task as we go
+	DynamicArray< uint32_t > edgePrerequisites;
+	DynamicArray< uint32_t > edgeDependents;
+	DynamicArray< uint32_t > prerequisites;
+	A_TaskDefinitionPtr visited;
+
+	schedule.m_DependencyCounts.Resize( taskCount );
+	schedule.m_DependentsOffsets.Resize( taskCount + 1 );
+	MemoryZero( schedule.m_DependentsOffsets.GetData(), schedule.m_DependentsOffsets.GetSize() * sizeof( uint32_t ) );
+
+	// Every task that runs before each task through its prerequisites, as one bit per scheduled task
+	const size_t ancestorWordCount = ( taskCount + 63 ) / 64;
+	DynamicArray< uint64_t > ancestors;
+	ancestors.Resize( taskCount * ancestorWordCount );
+	MemoryZero( ancestors.GetData(), ancestors.GetSize() * sizeof( uint64_t ) );
+
+	for (uint32_t i = 0; i < taskCount; ++i)
 	{
-		if (rTaskStack[i] == pTask)
+		prerequisites.Resize( 0 );
+		visited.Resize( 0 );
+		GatherScheduledPrerequisites( schedule.m_ScheduleInfo[i], i, scheduleIndices, visited, prerequisites );
+
+		// Prerequisites are always earlier in the schedule, so their ancestors are already complete
+		uint64_t *pAncestors = ancestors.GetData() + i * ancestorWordCount;
+		for (DynamicArray< uint32_t >::ConstIterator iter = prerequisites.Begin(); iter != prerequisites.End(); ++iter)
 		{
-#if HELIUM_TOOLS
-			HELIUM_TRACE(TraceLevels::Error, "Dependency cycle detected in task scheduler. Verify both explicit task order requirements as well as indirect order requirements by fulfilling/requiring TaskDefinitions. Dependency cycle is:\n" );
+			const uint64_t *pPrerequisiteAncestors = ancestors.GetData() + *iter * ancestorWordCount;
+			for (size_t word = 0; word < ancestorWordCount; ++word)
+			{
+				pAncestors[ word ] |= pPrerequisiteAncestors[ word ];
+			}
 
-			rTaskStack.Push(pTask);
+			pAncestors[ *iter / 64 ] |= 1ULL << ( *iter % 64 );
+		}
 
-			HELIUM_ASSERT(rTaskStack.GetSize() > 1);
-			for (; i < rTaskStack.GetSize() - 1; ++i)
+		// Order this task after every earlier task it is not yet ordered with but conflicts with. Latest first, so
+		// that an added edge already orders the earlier tasks it depends on
+		for (uint32_t j = i; j-- > 0; )
+		{
+			if ( ( pAncestors[ j / 64 ] & ( 1ULL << ( j % 64 ) ) ) || !DoTasksConflict( schedule.m_ScheduleInfo[j], schedule.m_ScheduleInfo[i] ) )
 			{
-				const TaskDefinition *pBeforeTask = rTaskStack[i];
-				const TaskDefinition *pAfterTask = rTaskStack[i + 1];
-
-				HELIUM_TRACE(TraceLevels::Error, " - %s must execute after %s\n", pBeforeTask->m_Name, pAfterTask->m_Name);
+				continue;
 			}
-#else
-			HELIUM_TRACE(TraceLevels::Error, "Dependency cycle detected in task scheduler. Verify both explicit task order requirements as well as indirect order requirements by fulfilling/requiring TaskDefinitions. Dependency cycle would be printed here if HELIUM_TOOLS=1\n" );
-#endif
 
-			rTaskStack.Pop();
+			prerequisites.Push( j );
 
-			// TODO: Spew the contracts of the tasks in the cycle
-			return false;
+			const uint64_t *pPrerequisiteAncestors = ancestors.GetData() + j * ancestorWordCount;
+			for (size_t word = 0; word < ancestorWordCount; ++word)
+			{
+				pAncestors[ word ] |= pPrerequisiteAncestors[ word ];
+			}
+
+			pAncestors[ j / 64 ] |= 1ULL << ( j % 64 );
 		}
-	}
 
-	bool already_inserted = false;
-	for (A_TaskDefinitionPtr::Iterator iter = rTaskInfoList.Begin();
-		iter != rTaskInfoList.End(); ++iter)
-	{
-		if (*iter == pTask)
+		schedule.m_DependencyCounts[i] = static_cast< uint32_t >( prerequisites.GetSize() );
+		for (DynamicArray< uint32_t >::ConstIterator iter = prerequisites.Begin(); iter != prerequisites.End(); ++iter)
 		{
-			already_inserted = true;
-			break;
+			edgePrerequisites.Push( *iter );
+			edgeDependents.Push( i );
+			++schedule.m_DependentsOffsets[ *iter + 1 ];
 		}
 	}
 
-	if (already_inserted)
+	// Turn the counts into offsets and bucket the dependents by prerequisite
+	for (uint32_t i = 0; i < taskCount; ++i)
+	{
+		schedule.m_DependentsOffsets[ i + 1 ] += schedule.m_DependentsOffsets[ i ];
+	}
+
+	DynamicArray< uint32_t > writeOffsets( schedule.m_DependentsOffsets );
+	schedule.m_Dependents.Resize( edgeDependents.GetSize() );
+	for (size_t i = 0; i < edgeDependents.GetSize(); ++i)
+	{
+		schedule.m_Dependents[ writeOffsets[ edgePrerequisites[i] ]++ ] = edgeDependents[i];
+	}
+}
+
+// Tasks that declared their component accesses conflict when one writes a type the other touches. A declaring task
+// also conflicts with a task that declared nothing, unless that task allowed concurrent execution (claiming nothing
+// unordered touches its data), since it may touch anything
+bool TaskScheduler::DoTasksConflict( const TaskDefinition *pTaskA, const TaskDefinition *pTaskB )
+{
+	const TaskContract &rContractA = pTaskA->m_Contract;
+	const TaskContract &rContractB = pTaskB->m_Contract;
+
+	const bool bDeclaredA = rContractA.DeclaresComponentAccess();
+	const bool bDeclaredB = rContractB.DeclaresComponentAccess();
+	if ( !bDeclaredA && !bDeclaredB )
+	{
+		return false;
+	}
+
+	if ( !bDeclaredA || !bDeclaredB )
+	{
+		const TaskContract &rUndeclared = bDeclaredA ? rContractB : rContractA;
+		return !rUndeclared.m_AllowConcurrentExecution;
+	}
+
+	return
+		DoComponentAccessesOverlap( rContractA.m_ComponentWrites, rContractB.m_ComponentWrites ) ||
+		DoComponentAccessesOverlap( rContractA.m_ComponentWrites, rContractB.m_ComponentReads ) ||
+		DoComponentAccessesOverlap( rContractA.m_ComponentReads, rContractB.m_ComponentWrites );
+}
+
+void TaskScheduler::FindShardBarriers( TaskSchedule &schedule )
+{
+	schedule.m_ShardBarriers.Resize( 0 );
+	for (uint32_t i = 0; i < static_cast< uint32_t >( schedule.m_ScheduleInfo.GetSize() ); ++i)
+	{
+		if ( IsEngineGlobalTask( schedule.m_ScheduleInfo[i] ) )
+		{
+			schedule.m_ShardBarriers.Push( i );
+		}
+	}
+}
+
+// Saved schedules store each scheduled task as its index in the task definition list, followed by the dependency
+// graph. List order depends on static initialization order, so it is part of the contract signature
+bool TaskScheduler::SaveSchedule( uint32_t tickType, const TaskSchedule &schedule, const FilePath &rPath )
+{
+	const TaskDefinition *pListTask = TaskDefinition::s_FirstTaskDefinition;
+	DynamicArray< const TaskDefinition * > definitions;
+	while ( pListTask )
+	{
+		definitions.Push( pListTask );
+		pListTask = pListTask->m_Next;
+	}
+
+	const uint32_t taskCount = static_cast< uint32_t >( schedule.m_ScheduleInfo.GetSize() );
+	DynamicArray< uint32_t > definitionIndices;
+	definitionIndices.Resize( taskCount );
+	for ( uint32_t i = 0; i < taskCount; ++i )
+	{
+		size_t definitionIndex = Invalid< size_t >();
+		for ( size_t j = 0; j < definitions.GetSize(); ++j )
+		{
+			if ( definitions[ j ] == schedule.m_ScheduleInfo[ i ] )
+			{
+				definitionIndex = j;
+				break;
+			}
+		}
+
+		if ( IsInvalid( definitionIndex ) )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "TaskScheduler::SaveSchedule(): Schedule contains an unknown task.\n" );
+			return false;
+		}
+
+		definitionIndices[ i ] = static_cast< uint32_t >( definitionIndex );
+	}
+
+	FileStream *pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_WRITE );
+	if ( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"TaskScheduler::SaveSchedule(): Failed to open \"%s\" for writing.\n",
+			rPath.Data() );
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+
+		const uint32_t version = SCHEDULE_FILE_VERSION;
+		const uint64_t signature = ComputeContractSignature();
+		const uint32_t dependentCount = static_cast< uint32_t >( schedule.m_Dependents.GetSize() );
+		bufferedStream.Write( &version, sizeof( version ), 1 );
+		bufferedStream.Write( &tickType, sizeof( tickType ), 1 );
+		bufferedStream.Write( &signature, sizeof( signature ), 1 );
+		bufferedStream.Write( &taskCount, sizeof( taskCount ), 1 );
+		bufferedStream.Write( &dependentCount, sizeof( dependentCount ), 1 );
+		bufferedStream.Write( definitionIndices.GetData(), sizeof( uint32_t ), taskCount );
+		bufferedStream.Write( schedule.m_DependencyCounts.GetData(), sizeof( uint32_t ), taskCount );
+		bufferedStream.Write( schedule.m_DependentsOffsets.GetData(), sizeof( uint32_t ), taskCount + 1 );
+		bufferedStream.Write( schedule.m_Dependents.GetData(), sizeof( uint32_t ), dependentCount );
+	}
+
+	delete pFileStream;
+
+	return true;
+}
+
+// Task contracts are defined (which only records each task's requirements) but not resolved, and tasks are not
+// ordered, so this is much cheaper than CalculateSchedule. On failure the schedule is left empty
+bool TaskScheduler::LoadSchedule( uint32_t tickType, const FilePath &rPath, TaskSchedule &schedule )
+{
+	schedule.m_ScheduleInfo.Clear();
+	schedule.m_ScheduleFunc.Clear();
+	schedule.m_DependencyCounts.Clear();
+	schedule.m_DependentsOffsets.Clear();
+	schedule.m_Dependents.Clear();
+
+	if ( !rPath.Exists() )
+	{
+		return false;
+	}
+
+	FileStream *pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_READ );
+	if ( !pFileStream )
+	{
+		return false;
+	}
+
+	int64_t size64 = pFileStream->GetSize();
+	if ( size64 < 0 || static_cast< uint64_t >( size64 ) > static_cast< size_t >( -1 ) )
+	{
+		delete pFileStream;
+		return false;
+	}
+
+	DynamicArray< uint8_t > data;
+	data.Resize( static_cast< size_t >( size64 ) );
+	size_t bytesRead = pFileStream->Read( data.GetData(), 1, data.GetSize() );
+
+	delete pFileStream;
+
+	if ( bytesRead != data.GetSize() )
+	{
+		return false;
+	}
+
+	DefineContracts();
+
+	const uint8_t *pCurrent = data.GetData();
+	const uint8_t *pEnd = pCurrent + data.GetSize();
+
+	uint32_t version = 0;
+	uint32_t savedTickType = 0;
+	uint64_t signature = 0;
+	uint32_t taskCount = 0;
+	uint32_t dependentCount = 0;
+	if ( !ReadScheduleValue( version, pCurrent, pEnd ) || version != SCHEDULE_FILE_VERSION ||
+		!ReadScheduleValue( savedTickType, pCurrent, pEnd ) || savedTickType != tickType ||
+		!ReadScheduleValue( signature, pCurrent, pEnd ) || signature != ComputeContractSignature() ||
+		!ReadScheduleValue( taskCount, pCurrent, pEnd ) ||
+		!ReadScheduleValue( dependentCount, pCurrent, pEnd ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"TaskScheduler::LoadSchedule(): Saved schedule \"%s\" is out of date.\n",
+			rPath.Data() );
+		return false;
+	}
+
+	DynamicArray< const TaskDefinition * > definitions;
+	const TaskDefinition *pListTask = TaskDefinition::s_FirstTaskDefinition;
+	while ( pListTask )
+	{
+		definitions.Push( pListTask );
+		pListTask = pListTask->m_Next;
+	}
+
+	DynamicArray< uint32_t > definitionIndices;
+	if ( !ReadScheduleIndices( definitionIndices, taskCount, static_cast< uint32_t >( definitions.GetSize() ), pCurrent, pEnd ) ||
+		!ReadScheduleIndices( schedule.m_DependencyCounts, taskCount, taskCount + 1, pCurrent, pEnd ) ||
+		!ReadScheduleIndices( schedule.m_DependentsOffsets, taskCount + 1, dependentCount + 1, pCurrent, pEnd ) ||
+		!ReadScheduleIndices( schedule.m_Dependents, dependentCount, taskCount, pCurrent, pEnd ) ||
+		schedule.m_DependentsOffsets[ taskCount ] != dependentCount )
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "TaskScheduler::LoadSchedule(): Saved schedule \"%s\" is invalid.\n", rPath.Data() );
+		schedule.m_DependencyCounts.Clear();
+		schedule.m_DependentsOffsets.Clear();
+		schedule.m_Dependents.Clear();
+		return false;
+	}
+
+	schedule.m_ScheduleInfo.Resize( taskCount );
+	schedule.m_ScheduleFunc.Resize( taskCount );
+	for ( uint32_t i = 0; i < taskCount; ++i )
+	{
+		const TaskDefinition *pTask = definitions[ definitionIndices[ i ] ];
+		HELIUM_ASSERT( pTask->m_Func );
+		schedule.m_ScheduleInfo[ i ] = pTask;
+		schedule.m_ScheduleFunc[ i ] = pTask->m_Func;
+	}
+
+	FindShardBarriers( schedule );
+
+	HELIUM_TRACE( TraceLevels::Info, "Loaded a saved schedule for all tasks.\n" );
+
+	return true;
+}
+
+// Saved schedules live in the user directory, one file per tick type
+bool TaskScheduler::GetScheduleCachePath( uint32_t tickType, FilePath &rPath )
+{
+	FilePath userDirectory;
+	if ( !FileLocations::GetUserDirectory( userDirectory ) )
+	{
+		return false;
+	}
+
+	char fileName[ 64 ];
+	StringPrint( fileName, "TaskSchedule_%08x.bin", tickType );
+	fileName[ HELIUM_ARRAY_COUNT( fileName ) - 1 ] = '\0';
+
+	rPath = FilePath( userDirectory.Get() + fileName );
+
+	return true;
+}
+
+void TaskScheduler::DefineContracts()
+{
+	if ( s_ContractTermsDefined )
+	{
+		return;
+	}
+
+	TaskDefinition *task = TaskDefinition::s_FirstTaskDefinition;
+	while ( task )
+	{
+		task->DoDefineContract();
+		task = task->m_Next;
+	}
+
+	s_ContractTermsDefined = true;
+}
+
+// Covers everything CalculateSchedule reads: the task list order, and each task's name, tick type, flags, order
+// requirements and contributed dependencies (tasks are identified by name, since their addresses vary between runs)
+uint64_t TaskScheduler::ComputeContractSignature()
+{
+	uint64_t signature = 14695981039346656037ULL;
+
+	const TaskDefinition *task = TaskDefinition::s_FirstTaskDefinition;
+	while ( task )
+	{
+		const TaskContract &rContract = task->m_Contract;
+
+		MixSignature( signature, StringHash( task->m_Name ) );
+		MixSignature( signature, StringHash( task->m_DependencyReverseLookup.m_Name ) );
+		MixSignature( signature, task->m_Func ? 1 : 0 );
+		MixSignature( signature, static_cast< uint32_t >( rContract.m_TickType ) );
+		MixSignature( signature, rContract.m_AllowConcurrentExecution ? 1 : 0 );
+		MixSignature( signature, rContract.m_DisjointComponentWrites ? 1 : 0 );
+		MixSignature( signature, rContract.m_EngineGlobal ? 1 : 0 );
+		MixSignature( signature, rContract.m_FrameInterval );
+
+		MixSignature( signature, rContract.m_OrderRequirements.GetSize() );
+		for ( DynamicArray< OrderRequirement >::ConstIterator iter = rContract.m_OrderRequirements.Begin();
+			iter != rContract.m_OrderRequirements.End(); ++iter )
+		{
+			MixSignature( signature, StringHash( iter->m_Dependency->m_Name ) );
+			MixSignature( signature, static_cast< uint64_t >( iter->m_Type ) );
+		}
+
+		MixSignature( signature, rContract.m_ComponentReads.GetSize() );
+		for ( DynamicArray< ComponentTypeGetter >::ConstIterator iter = rContract.m_ComponentReads.Begin();
+			iter != rContract.m_ComponentReads.End(); ++iter )
+		{
+			MixSignature( signature, StringHash( *Components::GetTypeData( ( *iter )() )->m_Name ) );
+		}
+
+		MixSignature( signature, rContract.m_ComponentWrites.GetSize() );
+		for ( DynamicArray< ComponentTypeGetter >::ConstIterator iter = rContract.m_ComponentWrites.Begin();
+			iter != rContract.m_ComponentWrites.End(); ++iter )
+		{
+			MixSignature( signature, StringHash( *Components::GetTypeData( ( *iter )() )->m_Name ) );
+		}
+
+		MixSignature( signature, rContract.m_ContributedDependencies.GetSize() );
+		for ( DynamicArray< const TaskDefinition * >::ConstIterator iter = rContract.m_ContributedDependencies.Begin();
+			iter != rContract.m_ContributedDependencies.End(); ++iter )
+		{
+			MixSignature( signature, StringHash( ( *iter )->m_Name ) );
+		}
+
+		task = task->m_Next;
+	}
+
+	return signature;
+}
+
+bool InsertToTaskList(A_TaskDefinitionPtr &rTaskInfoList, DynamicArray<TaskFunc> &rTaskFuncList, A_TaskDefinitionPtr &rTaskStack, const TaskDefinition *pTask, uint32_t tickType)
+{
+	// Don't add functions that do not run under the given tick type
+	if ((pTask->m_Contract.m_TickType & tickType) == 0)
+	{
+		return true;
+	}
+
+	for (size_t i = 0; i < rTaskStack.GetSize(); ++i)
+	{
+		if (rTaskStack[i] == pTask)
+		{
+#if HELIUM_TOOLS
+			HELIUM_TRACE(TraceLevels::Error, "Dependency cycle detected in task scheduler. Verify both explicit task order requirements as well as indirect order requirements by fulfilling/requiring TaskDefinitions. Dependency cycle is:\n" );
+
+			rTaskStack.Push(pTask);
+
+			HELIUM_ASSERT(rTaskStack.GetSize() > 1);
+			for (; i < rTaskStack.GetSize() - 1; ++i)
+			{
+				const TaskDefinition *pBeforeTask = rTaskStack[i];
+				const TaskDefinition *pAfterTask = rTaskStack[i + 1];
+
+				HELIUM_TRACE(TraceLevels::Error, " - %s must execute after %s\n", pBeforeTask->m_Name, pAfterTask->m_Name);
+			}
+#else
+			HELIUM_TRACE(TraceLevels::Error, "Dependency cycle detected in task scheduler. Verify both explicit task order requirements as well as indirect order requirements by fulfilling/requiring TaskDefinitions. Dependency cycle would be printed here if HELIUM_TOOLS=1\n" );
+#endif
+
+			rTaskStack.Pop();
+
+			// TODO: Spew the contracts of the tasks in the cycle
+			return false;
+		}
+	}
+
+	bool already_inserted = false;
+	for (A_TaskDefinitionPtr::Iterator iter = rTaskInfoList.Begin();
+		iter != rTaskInfoList.End(); ++iter)
+	{
+		if (*iter == pTask)
+		{
+			already_inserted = true;
+			break;
+		}
+	}
+
+	if (already_inserted)
 	{
 		return true;
 	}
@@ -280,12 +1147,452 @@ bool InsertToTaskList(A_TaskDefinitionPtr &rTaskInfoList, DynamicArray<TaskFunc>
 
 void TaskScheduler::ExecuteSchedule( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds )
 {
-	int i = 0;
-	for (DynamicArray<TaskFunc>::ConstIterator iter = schedule.m_ScheduleFunc.Begin(); iter != schedule.m_ScheduleFunc.End(); ++iter)
+	BeginScheduleFrame( schedule );
+
+	if ( s_TaskTimingEnabled )
 	{
-		(*iter)( rWorlds );
-		HELIUM_ASSERT(schedule.m_ScheduleInfo[i++]->m_Func == *iter);
+		s_TaskTimings.Resize( schedule.m_ScheduleFunc.GetSize() );
+		MemoryZero( s_TaskTimings.GetData(), s_TaskTimings.GetSize() * sizeof( TaskTiming ) );
 	}
+
+	JobManager *pJobManager = JobManager::GetInstance();
+	if ( !pJobManager || pJobManager->GetWorkerCount() == 0 || schedule.m_DependencyCounts.GetSize() != schedule.m_ScheduleFunc.GetSize() )
+	{
+		s_LastScheduleParallel = false;
+		ExecuteScheduleSerial( schedule, rWorlds );
+	}
+	else
+	{
+		s_LastScheduleParallel = true;
+		ExecuteScheduleParallel( schedule, rWorlds );
+	}
+
+	if ( s_TaskTimingEnabled && s_TimingLogInterval != 0 )
+	{
+		AccumulateTimings( schedule );
+		if ( ++s_TimingLogFrameCount >= s_TimingLogInterval )
+		{
+			LogTimingSummary( schedule );
+		}
+	}
+}
+
+// Decide which tasks run this frame. A task running every N frames runs when the frame index plus its place in the
+// schedule is a multiple of N, which spreads tasks sharing an interval over different frames
+void TaskScheduler::BeginScheduleFrame( const TaskSchedule &schedule )
+{
+	const uint32_t taskCount = static_cast< uint32_t >( schedule.m_ScheduleInfo.GetSize() );
+	s_TaskFramesSinceLastRun.Resize( taskCount );
+
+	for (uint32_t i = 0; i < taskCount; ++i)
+	{
+		const TaskDefinition *pTask = schedule.m_ScheduleInfo[i];
+		const uint32_t frameInterval = pTask->m_Contract.m_FrameInterval;
+		if ( frameInterval > 1 && ( s_ScheduleFrameIndex + i ) % frameInterval != 0 )
+		{
+			s_TaskFramesSinceLastRun[i] = 0;
+			continue;
+		}
+
+		s_TaskFramesSinceLastRun[i] = IsValid( pTask->m_LastRunFrame ) ? s_ScheduleFrameIndex - pTask->m_LastRunFrame : s_ScheduleFrameIndex + 1;
+		pTask->m_LastRunFrame = s_ScheduleFrameIndex;
+	}
+
+	++s_ScheduleFrameIndex;
+}
+
+void TaskScheduler::ExecuteScheduleSerial( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds )
+{
+	TaskTiming unusedTiming;
+	for (uint32_t i = 0; i < static_cast< uint32_t >( schedule.m_ScheduleFunc.GetSize() ); ++i)
+	{
+		HELIUM_ASSERT(schedule.m_ScheduleInfo[i]->m_Func == schedule.m_ScheduleFunc[i]);
+		RunTaskOnThisThread( schedule, i, rWorlds, s_TaskTimingEnabled ? s_TaskTimings[i] : unusedTiming );
+	}
+}
+
+void TaskScheduler::ExecuteScheduleSharded( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds )
+{
+	JobManager *pJobManager = JobManager::GetInstance();
+	if ( rWorlds.GetSize() < 2 || !pJobManager || pJobManager->GetWorkerCount() == 0 )
+	{
+		ExecuteSchedule( schedule, rWorlds );
+		return;
+	}
+
+	BeginScheduleFrame( schedule );
+
+	const uint32_t taskCount = static_cast< uint32_t >( schedule.m_ScheduleFunc.GetSize() );
+	const size_t worldCount = rWorlds.GetSize();
+
+	if ( s_TaskTimingEnabled )
+	{
+		s_TaskTimings.Resize( taskCount );
+		MemoryZero( s_TaskTimings.GetData(), s_TaskTimings.GetSize() * sizeof( TaskTiming ) );
+		s_WorldShardTimings.Resize( taskCount * worldCount );
+		MemoryZero( s_WorldShardTimings.GetData(), s_WorldShardTimings.GetSize() * sizeof( TaskTiming ) );
+	}
+
+	s_WorldShards.Resize( worldCount );
+	for (size_t i = 0; i < worldCount; ++i)
+	{
+		WorldShard &rShard = s_WorldShards[i];
+		rShard.m_pSchedule = &schedule;
+		rShard.m_Worlds.Resize( 1 );
+		rShard.m_Worlds[0] = rWorlds[i];
+		rShard.m_pTimings = s_TaskTimingEnabled ? &s_WorldShardTimings[ i * taskCount ] : NULL;
+	}
+
+	// Each world runs up to the next barrier in a job of its own, then the barrier runs here over every world
+	uint32_t segmentStart = 0;
+	for (size_t barrierIndex = 0; barrierIndex <= schedule.m_ShardBarriers.GetSize(); ++barrierIndex)
+	{
+		const uint32_t segmentEnd = ( barrierIndex < schedule.m_ShardBarriers.GetSize() ) ? schedule.m_ShardBarriers[ barrierIndex ] : taskCount;
+		if ( segmentStart < segmentEnd )
+		{
+			JobCounter counter;
+			for (DynamicArray< WorldShard >::Iterator iter = s_WorldShards.Begin(); iter != s_WorldShards.End(); ++iter)
+			{
+				iter->m_FirstTask = segmentStart;
+				iter->m_EndTask = segmentEnd;
+				JobManager::SpawnOrRun( RunWorldShardJob, &*iter, counter );
+			}
+
+			JobManager::WaitOrReturn( counter );
+		}
+
+		if ( segmentEnd < taskCount )
+		{
+			TaskTiming unusedTiming;
+			RunTaskOnThisThread( schedule, segmentEnd, rWorlds, s_TaskTimingEnabled ? s_TaskTimings[ segmentEnd ] : unusedTiming );
+		}
+
+		segmentStart = segmentEnd + 1;
+	}
+
+	// Worlds are released here rather than by a job, since dropping the last reference destroys the world
+	for (DynamicArray< WorldShard >::Iterator iter = s_WorldShards.Begin(); iter != s_WorldShards.End(); ++iter)
+	{
+		iter->m_Worlds.Clear();
+	}
+
+	// A sharded task is reported as running from the first world starting it to the last world finishing it, on the
+	// thread that finished it last. Tasks still complete in schedule order, so the critical path is the whole schedule
+	s_LastScheduleParallel = false;
+	if ( s_TaskTimingEnabled )
+	{
+		size_t barrierIndex = 0;
+		for (uint32_t taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+		{
+			if ( barrierIndex < schedule.m_ShardBarriers.GetSize() && schedule.m_ShardBarriers[ barrierIndex ] == taskIndex )
+			{
+				++barrierIndex;
+				continue;
+			}
+
+			TaskTiming &rTiming = s_TaskTimings[ taskIndex ];
+			rTiming = s_WorldShardTimings[ taskIndex ];
+			for (size_t worldIndex = 1; worldIndex < worldCount; ++worldIndex)
+			{
+				const TaskTiming &rShardTiming = s_WorldShardTimings[ worldIndex * taskCount + taskIndex ];
+				rTiming.m_ReadyTicks = Min( rTiming.m_ReadyTicks, rShardTiming.m_ReadyTicks );
+				rTiming.m_StartTicks = Min( rTiming.m_StartTicks, rShardTiming.m_StartTicks );
+				if ( rShardTiming.m_EndTicks > rTiming.m_EndTicks )
+				{
+					rTiming.m_EndTicks = rShardTiming.m_EndTicks;
+					rTiming.m_ThreadIndex = rShardTiming.m_ThreadIndex;
+				}
+			}
+		}
+
+		if ( s_TimingLogInterval != 0 )
+		{
+			AccumulateTimings( schedule );
+			if ( ++s_TimingLogFrameCount >= s_TimingLogInterval )
+			{
+				LogTimingSummary( schedule );
+			}
+		}
+	}
+}
+
+#if HELIUM_ASSERT_ENABLED
+void TaskScheduler::CheckComponentAccess( Components::TypeId type, bool bWrite )
+{
+	const TaskDefinition *pTask = s_pRunningTask;
+	if ( !pTask || !pTask->m_Contract.DeclaresComponentAccess() )
+	{
+		return;
+	}
+
+	// A declared write covers reads as well
+	if ( IsComponentTypeDeclared( pTask->m_Contract.m_ComponentWrites, type ) ||
+		( !bWrite && IsComponentTypeDeclared( pTask->m_Contract.m_ComponentReads, type ) ) )
+	{
+		return;
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Error,
+		"TaskScheduler::CheckComponentAccess - Task '%s' %s components of type '%s' without declaring it in its contract\n",
+		pTask->m_Name,
+		bWrite ? "writes" : "reads",
+		*Components::GetTypeData( type )->m_Name );
+	HELIUM_ASSERT_MSG( false, "TaskScheduler: Task accessed a component type it did not declare" );
+}
+#endif
+
+uint32_t TaskScheduler::GetFramesSinceLastRun()
+{
+	return s_RunningTaskFramesSinceLastRun;
+}
+
+bool TaskScheduler::IsTimeBudgetExhausted()
+{
+	return s_RunningTaskBudgetEndTicks != 0 && Timer::GetTickCount() >= s_RunningTaskBudgetEndTicks;
+}
+
+bool TaskScheduler::IsSplitExecutionAllowed()
+{
+	return s_SplitExecutionAllowed;
+}
+
+bool TaskScheduler::SetSplitExecutionAllowed( bool bAllowed )
+{
+	bool bPreviousAllowed = s_SplitExecutionAllowed;
+	s_SplitExecutionAllowed = bAllowed;
+	return bPreviousAllowed;
+}
+
+void TaskScheduler::SetTaskTimingEnabled( bool bEnabled )
+{
+	s_TaskTimingEnabled = bEnabled;
+	if ( !bEnabled )
+	{
+		s_TaskTimings.Clear();
+		s_TaskTimingTotals.Clear();
+		s_pTimingTotalsSchedule = NULL;
+		s_TimingLogFrameCount = 0;
+	}
+}
+
+bool TaskScheduler::IsTaskTimingEnabled()
+{
+	return s_TaskTimingEnabled;
+}
+
+const DynamicArray< TaskTiming > &TaskScheduler::GetTaskTimings()
+{
+	return s_TaskTimings;
+}
+
+void TaskScheduler::GetCriticalPath( const TaskSchedule &schedule, DynamicArray< uint32_t > &rTaskIndices )
+{
+	rTaskIndices.Resize( 0 );
+
+	const uint32_t taskCount = static_cast< uint32_t >( schedule.m_ScheduleFunc.GetSize() );
+	if ( taskCount == 0 || s_TaskTimings.GetSize() != taskCount )
+	{
+		return;
+	}
+
+	// Tasks executed serially ran one after another, so every task is on the critical path
+	if ( !s_LastScheduleParallel )
+	{
+		for (uint32_t i = 0; i < taskCount; ++i)
+		{
+			rTaskIndices.Push( i );
+		}
+
+		return;
+	}
+
+	uint32_t taskIndex = 0;
+	for (uint32_t i = 1; i < taskCount; ++i)
+	{
+		if ( s_TaskTimings[i].m_EndTicks > s_TaskTimings[ taskIndex ].m_EndTicks )
+		{
+			taskIndex = i;
+		}
+	}
+
+	// Walk back through the prerequisite that released each task. Prerequisites always come earlier in the schedule
+	for (;;)
+	{
+		rTaskIndices.Push( taskIndex );
+		if ( schedule.m_DependencyCounts[ taskIndex ] == 0 )
+		{
+			break;
+		}
+
+		uint32_t releasingIndex = Invalid< uint32_t >();
+		for (uint32_t i = 0; i < taskIndex; ++i)
+		{
+			const uint32_t dependentsEnd = schedule.m_DependentsOffsets[ i + 1 ];
+			for (uint32_t j = schedule.m_DependentsOffsets[i]; j < dependentsEnd; ++j)
+			{
+				if ( schedule.m_Dependents[j] == taskIndex &&
+					( IsInvalid( releasingIndex ) || s_TaskTimings[i].m_EndTicks > s_TaskTimings[ releasingIndex ].m_EndTicks ) )
+				{
+					releasingIndex = i;
+				}
+			}
+		}
+
+		if ( IsInvalid( releasingIndex ) )
+		{
+			break;
+		}
+
+		taskIndex = releasingIndex;
+	}
+
+	const size_t pathLength = rTaskIndices.GetSize();
+	for (size_t i = 0; i < pathLength / 2; ++i)
+	{
+		const uint32_t index = rTaskIndices[i];
+		rTaskIndices[i] = rTaskIndices[ pathLength - 1 - i ];
+		rTaskIndices[ pathLength - 1 - i ] = index;
+	}
+}
+
+void TaskScheduler::SetTimingLogInterval( uint32_t frameCount )
+{
+	s_TimingLogInterval = frameCount;
+	s_TimingLogFrameCount = 0;
+	s_TaskTimingTotals.Clear();
+	s_pTimingTotalsSchedule = NULL;
+}
+
+void TaskScheduler::AccumulateTimings( const TaskSchedule &schedule )
+{
+	const size_t taskCount = s_TaskTimings.GetSize();
+
+	// Start over whenever a different schedule runs, since the totals are indexed like the schedule
+	if ( s_pTimingTotalsSchedule != &schedule || s_TaskTimingTotals.GetSize() != taskCount )
+	{
+		s_pTimingTotalsSchedule = &schedule;
+		s_TaskTimingTotals.Resize( taskCount );
+		MemoryZero( s_TaskTimingTotals.GetData(), taskCount * sizeof( TaskTimingTotals ) );
+		s_TimingLogFrameCount = 0;
+	}
+
+	for (size_t i = 0; i < taskCount; ++i)
+	{
+		const TaskTiming &rTiming = s_TaskTimings[i];
+		TaskTimingTotals &rTotals = s_TaskTimingTotals[i];
+
+		const uint64_t wallTicks = rTiming.m_EndTicks - rTiming.m_StartTicks;
+		rTotals.m_WallTicks += wallTicks;
+		rTotals.m_MaxWallTicks = Max( rTotals.m_MaxWallTicks, wallTicks );
+		rTotals.m_WaitTicks += rTiming.m_StartTicks - rTiming.m_ReadyTicks;
+		rTotals.m_ThreadMask |= static_cast< uint64_t >( 1 ) << Min< uint32_t >( rTiming.m_ThreadIndex, 63 );
+	}
+}
+
+void TaskScheduler::LogTimingSummary( const TaskSchedule &schedule )
+{
+	const uint32_t frameCount = Max< uint32_t >( s_TimingLogFrameCount, 1 );
+	const size_t taskCount = s_TaskTimingTotals.GetSize();
+
+	HELIUM_TRACE( TraceLevels::Info, "TaskScheduler: Task timings over the last %" PRIu32 " frames:\n", frameCount );
+	for (size_t i = 0; i < taskCount; ++i)
+	{
+		const TaskTimingTotals &rTotals = s_TaskTimingTotals[i];
+
+		uint32_t threadCount = 0;
+		for (uint64_t mask = rTotals.m_ThreadMask; mask != 0; mask &= mask - 1)
+		{
+			++threadCount;
+		}
+
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			" - %s: %.3f ms average, %.3f ms peak, %.3f ms average wait, %" PRIu32 " thread(s)\n",
+			schedule.m_ScheduleInfo[i]->m_Name,
+			TaskTicksToMilliseconds( rTotals.m_WallTicks ) / frameCount,
+			TaskTicksToMilliseconds( rTotals.m_MaxWallTicks ),
+			TaskTicksToMilliseconds( rTotals.m_WaitTicks ) / frameCount,
+			threadCount );
+	}
+
+	DynamicArray< uint32_t > criticalPath;
+	GetCriticalPath( schedule, criticalPath );
+	if ( !criticalPath.IsEmpty() )
+	{
+		const TaskTiming &rFirst = s_TaskTimings[ criticalPath[0] ];
+		const TaskTiming &rLast = s_TaskTimings[ criticalPath[ criticalPath.GetSize() - 1 ] ];
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"TaskScheduler: Critical path of the last frame (%.3f ms):\n",
+			TaskTicksToMilliseconds( rLast.m_EndTicks - rFirst.m_ReadyTicks ) );
+
+		for (DynamicArray< uint32_t >::ConstIterator iter = criticalPath.Begin(); iter != criticalPath.End(); ++iter)
+		{
+			const TaskTiming &rTiming = s_TaskTimings[ *iter ];
+			HELIUM_TRACE(
+				TraceLevels::Info,
+				" - %s (%.3f ms, waited %.3f ms, thread %" PRIu32 ")\n",
+				schedule.m_ScheduleInfo[ *iter ]->m_Name,
+				TaskTicksToMilliseconds( rTiming.m_EndTicks - rTiming.m_StartTicks ),
+				TaskTicksToMilliseconds( rTiming.m_StartTicks - rTiming.m_ReadyTicks ),
+				rTiming.m_ThreadIndex );
+		}
+	}
+
+	MemoryZero( s_TaskTimingTotals.GetData(), taskCount * sizeof( TaskTimingTotals ) );
+	s_TimingLogFrameCount = 0;
+}
+
+void TaskScheduler::ExecuteScheduleParallel( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds )
+{
+	ParallelScheduleState &rState = s_ParallelState;
+	HELIUM_ASSERT( rState.m_ConcurrentTaskCounter.IsComplete() );
+
+	const uint32_t taskCount = static_cast< uint32_t >( schedule.m_ScheduleFunc.GetSize() );
+	if ( taskCount == 0 )
+	{
+		return;
+	}
+
+	rState.m_pSchedule = &schedule;
+	rState.m_pWorlds = &rWorlds;
+	rState.m_pJobManager = JobManager::GetInstance();
+	rState.m_RemainingDependencies.Resize( taskCount );
+	AtomicExchangeRelease( rState.m_CompletedCount, 0 );
+
+	if ( rState.m_TaskIndices.GetSize() < taskCount )
+	{
+		for (uint32_t i = static_cast< uint32_t >( rState.m_TaskIndices.GetSize() ); i < taskCount; ++i)
+		{
+			rState.m_TaskIndices.Push( i );
+		}
+	}
+
+	for (uint32_t i = 0; i < taskCount; ++i)
+	{
+		rState.m_RemainingDependencies[i] = static_cast< int32_t >( schedule.m_DependencyCounts[i] );
+	}
+
+	// Queue in reverse so that tasks are popped in their serial order when nothing else is competing
+	for (uint32_t i = taskCount; i-- > 0; )
+	{
+		if ( schedule.m_DependencyCounts[i] == 0 )
+		{
+			QueueReadyTask( i );
+		}
+	}
+
+	// Run the tasks that must stay on this thread as they become ready, and help with concurrent tasks otherwise
+	while ( static_cast< uint32_t >( rState.m_CompletedCount ) < taskCount )
+	{
+		if ( !RunNextExecutingThreadTask() && !rState.m_pJobManager->RunPendingJob() )
+		{
+			Thread::Yield();
+		}
+	}
+
+	rState.m_pJobManager->WaitForCounter( rState.m_ConcurrentTaskCounter );
 }
 
 void Helium::TaskScheduler::ResetContracts()
@@ -296,10 +1603,13 @@ void Helium::TaskScheduler::ResetContracts()
 		task->m_RequiredTasks.Clear();
 		task->m_Contract.m_ContributedDependencies.Clear();
 		task->m_Contract.m_OrderRequirements.Clear();
+		task->m_Contract.m_ComponentReads.Clear();
+		task->m_Contract.m_ComponentWrites.Clear();
 		task = task->m_Next;
 	}
 
 	m_ContractsDefined = false;
+	s_ContractTermsDefined = false;
 }
 
 using namespace Helium::StandardDependencies;
@@ -307,6 +1617,8 @@ using namespace Helium::StandardDependencies;
 HELIUM_DEFINE_ABSTRACT_TASK(ReceiveInput);
 void Helium::StandardDependencies::ReceiveInput::DefineContract( TaskContract &rContract )
 {
+	// Input devices are shared by every world
+	rContract.EngineGlobal();
 	rContract.ExecuteBefore<StandardDependencies::PrePhysicsGameplay>();
 }
 
@@ -331,11 +1643,14 @@ void Helium::StandardDependencies::PostPhysicsGameplay::DefineContract( TaskCont
 HELIUM_DEFINE_ABSTRACT_TASK(Render);
 void Helium::StandardDependencies::Render::DefineContract( TaskContract &rContract )
 {
+	// Submits to the one renderer
+	rContract.EngineGlobal();
 	rContract.ExecuteAfter<StandardDependencies::PostPhysicsGameplay>();
 }
 
 HELIUM_DEFINE_ABSTRACT_TASK(PostRender);
 void Helium::StandardDependencies::PostRender::DefineContract( TaskContract &rContract )
 {
+	rContract.EngineGlobal();
 	rContract.ExecuteAfter<StandardDependencies::Render>();
 }
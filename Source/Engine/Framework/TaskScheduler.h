@@ -2,10 +2,13 @@
 #pragma once
 
 #include "Framework/Framework.h"
+#include "Framework/Components.h"
 
 #include "Foundation/DynamicArray.h"
 #include "Foundation/ReferenceCounting.h"
 
+#include "EngineJobs/JobManager.h"
+
 #define HELIUM_DECLARE_TASK(__Type)                         \
 		__Type();                                           \
 		static __Type m_This; 
@@ -67,6 +70,9 @@ namespace Helium
 	}
 	typedef TickTypes::TickType TickType;
 
+	// Deferred lookup of a component type, so that contracts can name types before they are registered
+	typedef Components::TypeId (*ComponentTypeGetter)();
+
 	struct OrderRequirement
 	{
 		TaskDefinition *m_Dependency;
@@ -78,6 +84,11 @@ namespace Helium
 	{
 		TaskContract()
 			: m_TickType( TickTypes::Never )
+			, m_AllowConcurrentExecution( false )
+			, m_DisjointComponentWrites( false )
+			, m_EngineGlobal( false )
+			, m_FrameInterval( 1 )
+			, m_TimeBudgetMilliseconds( 0.0f )
 		{
 
 		}
@@ -126,15 +137,103 @@ namespace Helium
 			m_TickType = tickType;
 		}
 
+		// The task only touches data that no unordered task touches, so when the schedule is executed in parallel
+		// it may run as a job on a JobManager worker at the same time as other tasks. Tasks that don't opt in always
+		// run on the thread that calls TaskScheduler::ExecuteSchedule
+		void AllowConcurrentExecution()
+		{
+			m_AllowConcurrentExecution = true;
+		}
+
+		// Every world, and every component tuple within a world, is updated independently of the others (the task
+		// never writes to a component or to shared state reached from another world or tuple), so the work may be
+		// split into jobs by ParallelForEachWorld and ParallelQueryComponents. Without this they run serially
+		void DisjointComponentWrites()
+		{
+			m_DisjointComponentWrites = true;
+		}
+
+		// The task touches engine-wide state (input devices, the renderer, statics shared by every world). When worlds
+		// are sharded across threads (see TaskScheduler::ExecuteScheduleSharded) such a task is a barrier: every world
+		// first runs up to it, then it runs once over all worlds on the executing thread. Tasks contributing to an
+		// engine-global dependency are engine-global as well
+		void EngineGlobal()
+		{
+			m_EngineGlobal = true;
+		}
+
+		// Run the task only once every frameInterval executed schedules instead of every frame. Tasks sharing an
+		// interval are staggered across frames by their place in the schedule, and a task can find how many frames
+		// passed since it last ran with TaskScheduler::GetFramesSinceLastRun()
+		void RunEveryNFrames(uint32_t frameInterval)
+		{
+			HELIUM_ASSERT( frameInterval > 0 );
+			m_FrameInterval = frameInterval;
+		}
+
+		// Give the task a time budget for each run. The scheduler does not interrupt the task: it is expected to poll
+		// TaskScheduler::IsTimeBudgetExhausted() between units of work and pick up where it left off on its next run
+		void SetTimeBudget(float32_t milliseconds)
+		{
+			m_TimeBudgetMilliseconds = milliseconds;
+		}
+
+		// The task reads components of type T (or of any type implementing T). Declaring any component access claims
+		// that the declared components are the only shared data the task touches, so it may run as a job at the same
+		// time as any task it does not conflict with. CalculateSchedule orders every unordered pair of tasks whose
+		// accesses conflict (one writes a type the other reads or writes), and each declaring task after or before
+		// any unordered task that declared nothing and did not AllowConcurrentExecution()
+		template <class T>
+		void Reads()
+		{
+			m_ComponentReads.Push(&Components::GetType<T>);
+		}
+
+		// The task writes components of type T (or of any type implementing T). See Reads()
+		template <class T>
+		void Writes()
+		{
+			m_ComponentWrites.Push(&Components::GetType<T>);
+		}
+
+		bool DeclaresComponentAccess() const
+		{
+			return !m_ComponentReads.IsEmpty() || !m_ComponentWrites.IsEmpty();
+		}
+
+		// Whether the task may run as a job when the schedule is executed in parallel
+		bool IsConcurrent() const
+		{
+			return m_AllowConcurrentExecution || DeclaresComponentAccess();
+		}
+
 		// Every requirement to be before or after another dependency goes here
 		DynamicArray<OrderRequirement> m_OrderRequirements;
 
+		// Component types the task declared it reads and writes
+		DynamicArray<ComponentTypeGetter> m_ComponentReads;
+		DynamicArray<ComponentTypeGetter> m_ComponentWrites;
+
 		// All dependencies we contribute to fulfilling
 		DynamicArray<const TaskDefinition *> m_ContributedDependencies;
 
 		TickType m_TickType;
+
+		bool m_AllowConcurrentExecution;
+
+		bool m_DisjointComponentWrites;
+
+		bool m_EngineGlobal;
+
+		// The task runs once every this many frames
+		uint32_t m_FrameInterval;
+
+		// Time each run of the task should stay within, or zero for no budget
+		float32_t m_TimeBudgetMilliseconds;
 	};
 
+	class FilePath;
+
 	class World;
 	typedef Helium::StrongPtr< World > WorldPtr;
 	typedef void (*TaskFunc)( DynamicArray< WorldPtr > & );
@@ -145,9 +244,8 @@ namespace Helium
 			: m_DependencyReverseLookup(rDependency)
 			, m_Func(pFunc)
 			, m_Next(s_FirstTaskDefinition)
-#if HELIUM_TOOLS
 			, m_Name(pName)
-#endif
+			, m_LastRunFrame(Invalid< uint32_t >())
 		{
 			m_Contract.ExecutesWithin(rDependency);
 
@@ -164,14 +262,15 @@ namespace Helium
 		// We build this list of tasks that must execute before us in TaskScheduler::CalculateSchedule()
 		DynamicArray<const TaskDefinition *> m_RequiredTasks;
 
-#if HELIUM_TOOLS
-		// Task name useful for debug purposes
+		// Task name useful for debug purposes (and shown by the frame profiler)
 		const char *m_Name;
-#endif
 
 		// Our contract to be filled out by subclass
 		TaskContract m_Contract;
 
+		// Executed schedule count when the task last ran, or invalid if it never ran
+		mutable uint32_t m_LastRunFrame;
+
 		// The callback that will execute this task
 		TaskFunc m_Func;
 		
@@ -187,6 +286,23 @@ namespace Helium
 	{
 		A_TaskDefinitionPtr m_ScheduleInfo;
 		DynamicArray<TaskFunc> m_ScheduleFunc; // Compact version of our schedule
+
+		// Dependency graph over the indices of m_ScheduleFunc, used when executing the schedule in parallel
+		DynamicArray<uint32_t> m_DependencyCounts; // Number of scheduled tasks that must complete before each task may run
+		DynamicArray<uint32_t> m_DependentsOffsets; // Where each task's dependents start in m_Dependents (one extra entry marks the end)
+		DynamicArray<uint32_t> m_Dependents; // Tasks that wait on each task, grouped by the task they wait on
+
+		// Engine-global tasks, by index in m_ScheduleFunc and in order, which split the schedule when it is sharded
+		DynamicArray<uint32_t> m_ShardBarriers;
+	};
+
+	// How a single task ran during the last executed schedule. Ticks are Timer::GetTickCount() values
+	struct TaskTiming
+	{
+		uint64_t m_ReadyTicks; // When every task this one waits on had completed
+		uint64_t m_StartTicks;
+		uint64_t m_EndTicks;
+		uint32_t m_ThreadIndex; // Index of the thread the task ran on, in the order threads first ran a task
 	};
 
 	class HELIUM_FRAMEWORK_API TaskScheduler
@@ -195,9 +311,69 @@ namespace Helium
 		static bool CalculateSchedule( uint32_t tickType, TaskSchedule &schedule );
 		static void ExecuteSchedule( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds );
 
+		// Run the schedule with each world as its own shard: every world runs its tasks in schedule order as a job of
+		// its own, so worlds tick in parallel with each other. Engine-global tasks are barriers between the shards and
+		// run once over every world on this thread. Falls back to ExecuteSchedule without a job manager or with fewer
+		// than two worlds
+		static void ExecuteScheduleSharded( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds );
+
 		static void ResetContracts();
 
+		// A calculated schedule can be saved and loaded back by later runs (or shipped alongside cooked data), which
+		// skips resolving contracts and ordering tasks at startup. Saved schedules carry a signature of every task
+		// contract, and are rejected by LoadSchedule whenever a task is added, removed, or changes its contract
+		static bool SaveSchedule( uint32_t tickType, const TaskSchedule &schedule, const FilePath &rPath );
+		static bool LoadSchedule( uint32_t tickType, const FilePath &rPath, TaskSchedule &schedule );
+		static bool GetScheduleCachePath( uint32_t tickType, FilePath &rPath );
+
+#if HELIUM_ASSERT_ENABLED
+		// Flag a component access the task running on this thread did not declare in its contract. Component queries
+		// call this for every queried type; accesses outside of a scheduled task, from jobs split off a task, or by
+		// tasks that declared no component access at all are not checked
+		static void CheckComponentAccess( Components::TypeId type, bool bWrite );
+#endif
+
+		// Number of executed schedules since the task running on this thread last ran (1 for tasks that run every
+		// frame), or since the first executed schedule if it never ran before
+		static uint32_t GetFramesSinceLastRun();
+		// Whether the task running on this thread has used up the time budget it set in its contract. Always false
+		// for tasks without a budget
+		static bool IsTimeBudgetExhausted();
+
+		// Whether the task running on this thread declared disjoint component writes, so its work may be split
+		static bool IsSplitExecutionAllowed();
+		// Returns the previous value so that it can be restored once the work has run
+		static bool SetSplitExecutionAllowed( bool bAllowed );
+
+		// Every task is timed unless disabled. GetTaskTimings() holds how each task of the last executed schedule
+		// ran, indexed like the schedule
+		static void SetTaskTimingEnabled( bool bEnabled );
+		static bool IsTaskTimingEnabled();
+		static const DynamicArray< TaskTiming > &GetTaskTimings();
+
+		// The chain of tasks that bounded the last executed schedule, first to last: starting from the task that
+		// finished last, each task is preceded by the task it waited on that finished last. Edges along this chain
+		// are the ExecuteBefore/ExecuteAfter requirements serializing the frame
+		static void GetCriticalPath( const TaskSchedule &schedule, DynamicArray< uint32_t > &rTaskIndices );
+
+		// Log a summary of the task timings every frameCount executed schedules (zero to stop logging): average and
+		// peak wall time, average queue wait, and the threads used for each task, followed by the critical path of the
+		// last frame
+		static void SetTimingLogInterval( uint32_t frameCount );
+
 		static bool m_ContractsDefined;
+
+	private:
+		static void DefineContracts();
+		static uint64_t ComputeContractSignature();
+		static void BeginScheduleFrame( const TaskSchedule &schedule );
+		static void ExecuteScheduleSerial( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds );
+		static void ExecuteScheduleParallel( const TaskSchedule &schedule, DynamicArray< WorldPtr > &rWorlds );
+		static void BuildDependencyGraph( TaskSchedule &schedule );
+		static bool DoTasksConflict( const TaskDefinition *pTaskA, const TaskDefinition *pTaskB );
+		static void FindShardBarriers( TaskSchedule &schedule );
+		static void AccumulateTimings( const TaskSchedule &schedule );
+		static void LogTimingSummary( const TaskSchedule &schedule );
 	};
 
 	namespace StandardDependencies
@@ -248,4 +424,33 @@ namespace Helium
 			Fn( iter->Get() );
 		}
 	}
+
+	template < void (*Fn)(World *) >
+	void ParallelForEachWorldJob( void *pWorld )
+	{
+		bool bPreviousAllowed = TaskScheduler::SetSplitExecutionAllowed( true );
+		Fn( static_cast< World * >( pWorld ) );
+		TaskScheduler::SetSplitExecutionAllowed( bPreviousAllowed );
+	}
+
+	// Same as ForEachWorld, but each world is updated as a separate job when the running task declared
+	// DisjointComponentWrites() in its contract
+	template < void (*Fn)(World *) >
+	void ParallelForEachWorld(DynamicArray< WorldPtr > &rWorlds)
+	{
+		if ( rWorlds.GetSize() < 2 || !TaskScheduler::IsSplitExecutionAllowed() )
+		{
+			ForEachWorld< Fn >( rWorlds );
+			return;
+		}
+
+		JobCounter counter;
+		for (DynamicArray< WorldPtr >::Iterator iter = rWorlds.Begin();
+			iter != rWorlds.End(); ++iter)
+		{
+			JobManager::SpawnOrRun( ParallelForEachWorldJob< Fn >, iter->Get(), counter );
+		}
+
+		JobManager::WaitOrReturn( counter );
+	}
 }
@@ -205,6 +205,9 @@ void World::RefCountPreDestroy()
 
 /// Add a slice to this world.
 ///
+/// A slice built with Slice::BeginDetachedBuild() has its component pools spliced into the world's pools and its
+/// entities finalized here, so all of its entities appear in the world at once.
+///
 /// @param[in] pSlice  SceneDefinition to add.
 ///
 /// @return  True if the slice was added successfully, false if not.
@@ -233,11 +236,30 @@ bool World::AddSlice( Slice* pSlice )
 		return false;
 	}
 
+	// Slices built detached bring their own component pools, which are spliced into ours before the slice is
+	// registered.
+	bool bDetached = pSlice->IsDetached();
+	if( bDetached && !pSlice->AttachDetachedComponents( this ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"World::AddSlice(): Failed to attach the components of detached slice \"%s\".\n",
+			pSlice->GetSceneDefinition() ? *pSlice->GetSceneDefinition()->GetPath().ToString() : "" );
+
+		return false;
+	}
+
 	// Add the slice to our slice list and set it referencing back to this world.
 	size_t sliceIndex = m_Slices.Push( SlicePtr( pSlice ) );
 	HELIUM_ASSERT( IsValid( sliceIndex ) );
 	pSlice->SetWorldInfo( this, sliceIndex );
 
+	// Now that its entities can reach the world, finish the components that were held back while detached.
+	if( bDetached )
+	{
+		pSlice->FinalizePendingEntities();
+	}
+
 	// Attach all entities in the slice.
 	//size_t entityCount = pSlice->GetEntityCount();
 	//for( size_t entityIndex = 0; entityIndex < entityCount; ++entityIndex )
@@ -314,3 +336,68 @@ Slice* World::GetSlice( size_t index ) const
 
 	return m_Slices[ index ];
 }
+
+/// Enable or disable a task for this world without recalculating the schedule.
+///
+/// Disabled tasks are skipped by TaskScheduler for this world only.  Disabling an abstract task (such as
+/// StandardDependencies::ProcessPhysics) disables every task that contributes to it.  Tasks should not be toggled while
+/// a schedule is executing.
+///
+/// @param[in] rTask     Task or dependency to toggle.
+/// @param[in] bEnabled  True to run the task for this world, false to skip it.
+///
+/// @see IsTaskEnabled(), HasDisabledTasks()
+void World::SetTaskEnabled( const TaskDefinition& rTask, bool bEnabled )
+{
+	size_t disabledCount = m_DisabledTasks.GetSize();
+	for( size_t index = 0; index < disabledCount; ++index )
+	{
+		if( m_DisabledTasks[ index ] == &rTask )
+		{
+			if( bEnabled )
+			{
+				m_DisabledTasks.RemoveSwap( index );
+			}
+
+			return;
+		}
+	}
+
+	if( !bEnabled )
+	{
+		m_DisabledTasks.Push( &rTask );
+	}
+}
+
+/// Get whether a task runs for this world.
+///
+/// @param[in] rTask  Task to check.
+///
+/// @return  False if the task, or any dependency it contributes to, was disabled with SetTaskEnabled(), true if not.
+///
+/// @see SetTaskEnabled()
+bool World::IsTaskEnabled( const TaskDefinition& rTask ) const
+{
+	const DynamicArray< const TaskDefinition* >& rContributed = rTask.m_Contract.m_ContributedDependencies;
+
+	size_t disabledCount = m_DisabledTasks.GetSize();
+	for( size_t index = 0; index < disabledCount; ++index )
+	{
+		const TaskDefinition* pDisabled = m_DisabledTasks[ index ];
+		if( pDisabled == &rTask )
+		{
+			return false;
+		}
+
+		size_t contributedCount = rContributed.GetSize();
+		for( size_t contributedIndex = 0; contributedIndex < contributedCount; ++contributedIndex )
+		{
+			if( rContributed[ contributedIndex ] == pDisabled )
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -7,6 +7,7 @@ namespace Helium
 {
 	class Entity;
 	class EntityDefinition;
+	struct TaskDefinition;
 	
 	class Slice;
 	typedef Helium::StrongPtr< Slice > SlicePtr;
@@ -40,6 +41,13 @@ namespace Helium
 		inline ComponentManager *GetComponentManager();
 		//@}
 
+		/// @name Task Toggles
+		//@{
+		void SetTaskEnabled( const TaskDefinition& rTask, bool bEnabled );
+		bool IsTaskEnabled( const TaskDefinition& rTask ) const;
+		inline bool HasDisabledTasks() const;
+		//@}
+
 		/// @name Asset Interface
 		//@{
 		virtual void RefCountPreDestroy() override;
@@ -74,6 +82,9 @@ namespace Helium
 
 		ComponentCollection m_Components;
 
+		/// Tasks (or dependencies grouping tasks) that are skipped for this world.
+		DynamicArray< const TaskDefinition* > m_DisabledTasks;
+
 		/// Active slices.
 		DynamicArray< SlicePtr > m_Slices;
 		SlicePtr m_RootSlice;
@@ -87,6 +98,9 @@ namespace Helium
 	{ 
 		ComponentManager *pComponentManager = pWorld->GetComponentManager();
 		HELIUM_ASSERT( pComponentManager );
+#if HELIUM_ASSERT_ENABLED
+		TaskScheduler::CheckComponentAccess( Components::GetType<A>(), false );
+#endif
 		for (ImplementingComponentIterator<A> iter( *pComponentManager ); iter.GetBaseComponent(); iter.Advance())
 		{
 			F( *iter );
@@ -95,6 +109,25 @@ namespace Helium
 
 	template <class A, class B, void (*F)(A *, B *)>
 	inline void QueryComponents( World *pWorld )
+	{
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+		QueryComponents<A, B>( *pComponentManager, F );
+	}
+	
+	template <class A, class B, class C, void (*F)(A *, B *, C *)>
+	inline void QueryComponents( World *pWorld )
+	{
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+		QueryComponents<A, B, C>( *pComponentManager, F );
+	}
+
+	// Cached variants of QueryComponents. Matches persist in the world's ComponentManager between calls and are only
+	// rediscovered for entities whose components changed, so per-frame queries don't pay for finding them again.
+	// Unlike QueryComponents, every slot also matches components that derive from the queried type
+	template <class A, class B, void (*F)(A *, B *)>
+	inline void CachedQueryComponents( World *pWorld )
 	{
 		static Components::TypeId types[] = {
 			Components::GetType<A>(),
@@ -103,11 +136,52 @@ namespace Helium
 
 		ComponentManager *pComponentManager = pWorld->GetComponentManager();
 		HELIUM_ASSERT( pComponentManager );
-		QueryComponentsInternal( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, B, F> );
+		QueryComponentsCached( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, B, F> );
 	}
 	
 	template <class A, class B, class C, void (*F)(A *, B *, C *)>
-	inline void QueryComponents( World *pWorld )
+	inline void CachedQueryComponents( World *pWorld )
+	{
+		static Components::TypeId types[] = {
+			Components::GetType<A>(),
+			Components::GetType<B>(),
+			Components::GetType<C>()
+		};
+
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+		QueryComponentsCached( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, B, C, F> );
+	}
+
+	// Parallel variants of QueryComponents. Tuples are split into jobs only when the running task declared
+	// DisjointComponentWrites() in its contract; otherwise these behave the same as QueryComponents
+	template <class A, void (*F)(A *)>
+	inline void ParallelQueryComponents( World *pWorld )
+	{ 
+		static Components::TypeId types[] = {
+			Components::GetType<A>()
+		};
+
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+		ParallelQueryComponentsInternal( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, F> );
+	}
+
+	template <class A, class B, void (*F)(A *, B *)>
+	inline void ParallelQueryComponents( World *pWorld )
+	{
+		static Components::TypeId types[] = {
+			Components::GetType<A>(),
+			Components::GetType<B>()
+		};
+
+		ComponentManager *pComponentManager = pWorld->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+		ParallelQueryComponentsInternal( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, B, F> );
+	}
+	
+	template <class A, class B, class C, void (*F)(A *, B *, C *)>
+	inline void ParallelQueryComponents( World *pWorld )
 	{
 		static Components::TypeId types[] = {
 			Components::GetType<A>(),
@@ -117,7 +191,7 @@ namespace Helium
 
 		ComponentManager *pComponentManager = pWorld->GetComponentManager();
 		HELIUM_ASSERT( pComponentManager );
-		QueryComponentsInternal( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, B, C, F> );
+		ParallelQueryComponentsInternal( *pComponentManager, types, HELIUM_ARRAY_COUNT(types), TupleHandler<A, B, C, F> );
 	}
 }
 
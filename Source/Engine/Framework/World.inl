@@ -10,6 +10,16 @@ namespace Helium
 		return m_ComponentManager.Ptr();
 	}
 
+    /// Get whether any task is disabled for this world.
+    ///
+    /// @return  True if at least one task or dependency was disabled with SetTaskEnabled(), false if every task runs.
+    ///
+    /// @see SetTaskEnabled(), IsTaskEnabled()
+    bool World::HasDisabledTasks() const
+    {
+        return !m_DisabledTasks.IsEmpty();
+    }
+
     /// Get the number of slices currently active in this world.
     ///
     /// @return  Slice count.
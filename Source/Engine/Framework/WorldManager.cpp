@@ -3,6 +3,11 @@
 #include "Framework/WorldDefinition.h"
 
 #include "Platform/Timer.h"
+#include "Engine/CacheAccessTrace.h"
+#include "Engine/FrameArena.h"
+#include "Engine/SmallObjectHeap.h"
+#include "Engine/MemoryTelemetry.h"
+#include "Engine/ResidencyManager.h"
 #include "Framework/Slice.h"
 #include "Framework/Entity.h"
 #include "Framework/SceneDefinition.h"
@@ -15,10 +20,15 @@ WorldManager* WorldManager::sm_pInstance = NULL;
 
 /// Constructor.
 WorldManager::WorldManager()
-: m_actualFrameTickCount( 0 )
+: m_streamRequestPool( STREAM_REQUEST_POOL_BLOCK_SIZE )
+, m_actualFrameTickCount( 0 )
 , m_frameTickCount( 0 )
 , m_frameDeltaTickCount( 0 )
 , m_frameDeltaSeconds( 0.0f )
+, m_fixedFrameDeltaTickCount( 0 )
+, m_fixedFrameDeltaSeconds( 0.0f )
+, m_bShardWorlds( false )
+, m_bRecordCacheAccessTraces( false )
 , m_bProcessedFirstFrame( false )
 {
 }
@@ -75,6 +85,32 @@ bool WorldManager::Initialize()
 /// @see Initialize()
 void WorldManager::Cleanup()
 {
+	// Drop any streams still in progress, waiting on their scene definition loads so the load requests are released.
+	size_t streamRequestCount = m_streamRequests.GetSize();
+	for( size_t streamRequestIndex = 0; streamRequestIndex < streamRequestCount; ++streamRequestIndex )
+	{
+		StreamRequest* pRequest = m_streamRequests[ streamRequestIndex ];
+		HELIUM_ASSERT( pRequest );
+
+		if( IsValid( pRequest->loadRequestId ) )
+		{
+			AssetPtr spSceneAsset;
+			AssetLoader::GetInstance()->FinishLoad( pRequest->loadRequestId, spSceneAsset );
+		}
+
+		FinishCacheAccessTrace( pRequest, false );
+
+		pRequest->spWorld.Release();
+		pRequest->spSceneDefinition.Release();
+		pRequest->spSlice.Release();
+		m_streamRequestPool.Release( pRequest );
+	}
+
+	m_streamRequests.Clear();
+
+	// Slices still unloading go with their worlds.
+	m_unloadRequests.Clear();
+
 	size_t worldCount = m_worlds.GetSize();
 	for( size_t worldIndex = 0; worldIndex < worldCount; ++worldIndex )
 	{
@@ -156,6 +192,169 @@ Helium::World* WorldManager::CreateWorld( SceneDefinition* pSceneDefinition )
 	return spWorld;
 }
 
+/// Begin streaming a scene into a world.
+///
+/// Once the scene definition has loaded, a new detached slice is filled with the scene's entities over the following
+/// frames, and is then attached to the world through World::AddSlice().  Nothing in the world sees the entities
+/// until the slice is attached, at which point they all appear at once and TryFinishStreamScene() returns true.
+///
+/// @param[in] scenePath           Path of the SceneDefinition to stream.
+/// @param[in] pWorld              World into which the scene is streamed.
+/// @param[in] priority            Priority at which to load the scene definition and its dependencies.
+/// @param[in] budgetMilliseconds  Time each frame may spend creating entities for this stream.  At least one entity
+///                                is created each frame regardless.
+///
+/// @return  ID for the stream request if started successfully, invalid index if not.
+///
+/// @see TryFinishStreamScene()
+size_t WorldManager::BeginStreamScene(
+	AssetPath scenePath,
+	World* pWorld,
+	AssetLoader::EPriority priority,
+	float32_t budgetMilliseconds )
+{
+	HELIUM_ASSERT( pWorld );
+	HELIUM_ASSERT( budgetMilliseconds >= 0.0f );
+
+	// Only one trace is recorded at a time, so scenes streamed while another is being traced are not traced.
+	bool bRecordingCacheAccesses = ( m_bRecordCacheAccessTraces && !CacheAccessTrace::IsRecording() );
+	if( bRecordingCacheAccesses )
+	{
+		CacheAccessTrace::BeginRecording();
+	}
+
+	size_t loadRequestId = AssetLoader::GetInstance()->BeginLoadObject( scenePath, false, priority );
+	if( IsInvalid( loadRequestId ) )
+	{
+		if( bRecordingCacheAccesses )
+		{
+			CacheAccessTrace discardedTrace;
+			CacheAccessTrace::EndRecording( discardedTrace );
+		}
+
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"WorldManager::BeginStreamScene(): Failed to begin loading scene \"%s\".\n",
+			*scenePath.ToString() );
+
+		return Invalid< size_t >();
+	}
+
+	StreamRequest* pRequest = m_streamRequestPool.Allocate();
+	HELIUM_ASSERT( pRequest );
+	pRequest->spWorld = pWorld;
+	pRequest->loadRequestId = loadRequestId;
+	HELIUM_ASSERT( !pRequest->spSceneDefinition );
+	HELIUM_ASSERT( !pRequest->spSlice );
+	pRequest->entityIndex = 0;
+	pRequest->budgetTicks = static_cast< uint64_t >(
+		static_cast< float64_t >( budgetMilliseconds ) * 0.001 *
+		static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+	pRequest->bComplete = false;
+	pRequest->scenePath = scenePath;
+	pRequest->bRecordingCacheAccesses = bRecordingCacheAccesses;
+
+	m_streamRequests.Push( pRequest );
+
+	return m_streamRequestPool.GetIndex( pRequest );
+}
+
+/// Test whether a scene stream request has completed, getting the slice created for it if so.
+///
+/// Note that after a stream request has completed (this function returns true), the request ID should no longer be
+/// considered valid.
+///
+/// @param[in]  id        Stream request ID.
+/// @param[out] rspSlice  Set to the slice holding the streamed scene if the stream has completed, or a null reference
+///                       if the scene failed to load.
+///
+/// @return  True if the stream request has completed, false if it is still being processed.
+///
+/// @see BeginStreamScene()
+bool WorldManager::TryFinishStreamScene( size_t id, SlicePtr& rspSlice )
+{
+	HELIUM_ASSERT( IsValid( id ) );
+
+	StreamRequest* pRequest = m_streamRequestPool.GetObject( id );
+	HELIUM_ASSERT( pRequest );
+	if( !pRequest->bComplete )
+	{
+		return false;
+	}
+
+	rspSlice = pRequest->spSlice;
+
+	pRequest->spWorld.Release();
+	pRequest->spSceneDefinition.Release();
+	pRequest->spSlice.Release();
+	m_streamRequestPool.Release( pRequest );
+
+	return true;
+}
+
+/// Unload a slice from its world over the following frames.
+///
+/// The slice's entities are destroyed a few at a time each frame, within the budget given, and the slice is removed
+/// from its world once it is empty.  Component destructors unregister from world systems such as physics and
+/// rendering, so the work stays on the main thread at the start of each frame.
+///
+/// @param[in] pSlice              Slice to unload.
+/// @param[in] budgetMilliseconds  Time each frame may spend destroying entities for this slice.  At least one entity
+///                                is destroyed each frame regardless.
+///
+/// @return  True if the slice will be unloaded, false if it is not bound to a world or is already being unloaded.
+///
+/// @see GetUnloadingSliceCount(), BeginStreamScene()
+bool WorldManager::BeginUnloadSlice( Slice* pSlice, float32_t budgetMilliseconds )
+{
+	HELIUM_ASSERT( pSlice );
+	HELIUM_ASSERT( budgetMilliseconds >= 0.0f );
+
+	World* pWorld = pSlice->GetWorld();
+	if( !pWorld || pSlice == pWorld->GetRootSlice() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"WorldManager::BeginUnloadSlice(): Slice is not bound to a world or is the root slice of its world.\n" );
+
+		return false;
+	}
+
+	size_t unloadRequestCount = m_unloadRequests.GetSize();
+	for( size_t unloadRequestIndex = 0; unloadRequestIndex < unloadRequestCount; ++unloadRequestIndex )
+	{
+		if( m_unloadRequests[ unloadRequestIndex ].spSlice.Get() == pSlice )
+		{
+			return false;
+		}
+	}
+
+	UnloadRequest* pRequest = m_unloadRequests.New();
+	HELIUM_ASSERT( pRequest );
+	pRequest->spSlice = pSlice;
+	pRequest->budgetTicks = static_cast< uint64_t >(
+		static_cast< float64_t >( budgetMilliseconds ) * 0.001 *
+		static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+
+	return true;
+}
+
+/// Set whether a cache access trace is recorded for each scene streamed.
+///
+/// While enabled, the cache entries read by each scene stream, from the start of the stream until its slice is ready
+/// to be attached, are recorded and saved as the trace of the scene (see CacheAccessTrace::GetTraceFilePath()).  The
+/// cook lays out caches in the order of these traces, so this is meant to be enabled while running through the
+/// scenes to package.  Only one scene is traced at a time, and anything else read from the caches while a scene is
+/// traced is recorded as part of it.
+///
+/// @param[in] bEnabled  True to record cache access traces, false to stop.
+///
+/// @see IsCacheAccessTraceRecordingEnabled(), BeginStreamScene()
+void WorldManager::SetCacheAccessTraceRecordingEnabled( bool bEnabled )
+{
+	m_bRecordCacheAccessTraces = bEnabled;
+}
+
 /// Release a managed World instance.
 ///
 /// @param[in] pWorld  World to release.
@@ -178,10 +377,36 @@ bool WorldManager::ReleaseWorld( World* pWorld )
 /// Update all worlds for the current frame.
 void WorldManager::Update( TaskSchedule &schedule )
 {
+	// Release the transient data of the frame before last.
+	FrameArena::BeginFrame();
+
+	// Gather the small object heap statistics of the last frame.
+	SmallObjectHeap::BeginFrame();
+
+	// Sample memory owners and refresh the allocation rates.
+	MemoryTelemetry::Update();
+
+	// Restore the resources used last frame and evict idle ones if over budget.
+	ResidencyManager* pResidencyManager = ResidencyManager::GetInstance();
+	if( pResidencyManager )
+	{
+		pResidencyManager->Update();
+	}
+
 	// Update the world time.
 	UpdateTime();
+
+	// Add streamed entities before the worlds are updated, so they take part in this frame.
+	UpdateStreaming();
 	
-	Helium::TaskScheduler::ExecuteSchedule( schedule, m_worlds );
+	if ( m_bShardWorlds )
+	{
+		Helium::TaskScheduler::ExecuteScheduleSharded( schedule, m_worlds );
+	}
+	else
+	{
+		Helium::TaskScheduler::ExecuteSchedule( schedule, m_worlds );
+	}
 	
 	Components::Tick();
 
@@ -190,23 +415,47 @@ void WorldManager::Update( TaskSchedule &schedule )
 	// than this abomination
 	for ( DynamicArray< WorldPtr >::Iterator worldIter = m_worlds.Begin(); worldIter != m_worlds.End(); ++worldIter )
 	{
+		// Free everything destroyed this frame as one batch so each pool compacts its roster once
+		ComponentManager *pComponentManager = (*worldIter)->GetComponentManager();
+		HELIUM_ASSERT( pComponentManager );
+		pComponentManager->BeginBatchedFrees();
+		pComponentManager->FreeDeferredComponents();
+
 		for ( size_t sliceIndex = 0; sliceIndex < (*worldIter)->GetSliceCount(); ++sliceIndex )
 		{
 			Slice *pSlice = (*worldIter)->GetSlice( sliceIndex );
-			for ( size_t entityIndex = 0; entityIndex < pSlice->GetEntityCount(); ++entityIndex )
+			for ( size_t entityIndex = 0; entityIndex < pSlice->GetEntityCount(); )
 			{
 				Entity *pEntity = pSlice->GetEntity( entityIndex );
 
-				if ( pEntity->IsDeferredDestroySet() )
+				// TODO: I don't like that strong pointers might be holding these references alive.. need to find a way to fix this
+				// Destroying swaps the last entity into this index, so only move on if nothing was destroyed
+				if ( !pEntity->IsDeferredDestroySet() || !pSlice->DestroyEntity( pEntity ) )
 				{
-					// TODO: I don't like that strong pointers might be holding these references alive.. need to find a way to fix this
-					pSlice->DestroyEntity( pEntity );
+					++entityIndex;
 				}
 			}
 		}
+
+		pComponentManager->EndBatchedFrees();
 	}
 }
 
+/// Set whether worlds are ticked in parallel with each other.
+///
+/// When enabled, each world runs the schedule as its own shard, on a job manager worker, and only waits on the other
+/// worlds at engine-global tasks (such as input capture and render submission), which run once over every world.
+/// This suits processes hosting many independent worlds, such as a server running several matches.  Every task that
+/// is not engine-global must then only touch the world it is given.
+///
+/// @param[in] bEnabled  True to shard worlds across threads, false to update every world with each task in turn.
+///
+/// @see IsWorldShardingEnabled(), TaskContract::EngineGlobal(), TaskScheduler::ExecuteScheduleSharded()
+void WorldManager::SetWorldShardingEnabled( bool bEnabled )
+{
+	m_bShardWorlds = bEnabled;
+}
+
 /// Get the singleton WorldManager instance.
 ///
 /// @return  Pointer to the WorldManager instance.
@@ -270,7 +519,11 @@ void WorldManager::UpdateTime()
 	m_actualFrameTickCount = newFrameTickCount;
 
 	// Clamp the timer delta based on the timer limit settings.
-	if( deltaTickCount == 0 )
+	if( m_fixedFrameDeltaTickCount != 0 )
+	{
+		deltaTickCount = m_fixedFrameDeltaTickCount;
+	}
+	else if( deltaTickCount == 0 )
 	{
 		deltaTickCount = 1;
 	}
@@ -290,3 +543,240 @@ void WorldManager::UpdateTime()
 	m_frameDeltaSeconds =
 		static_cast< float32_t >( static_cast< float64_t >( deltaTickCount ) * Timer::GetSecondsPerTick() );
 }
+
+/// Set a fixed time step for each frame to advance by, regardless of the actual time elapsed.
+///
+/// This makes simulation results independent of the frame rate, so runs with the same input can be compared (for
+/// example, when benchmarking).
+///
+/// @param[in] seconds  Fixed frame time step, in seconds, or zero to follow the actual time elapsed.
+///
+/// @see GetFixedFrameDeltaSeconds()
+void WorldManager::SetFixedFrameDeltaSeconds( float32_t seconds )
+{
+	HELIUM_ASSERT( seconds >= 0.0f );
+
+	m_fixedFrameDeltaSeconds = Max( seconds, 0.0f );
+	m_fixedFrameDeltaTickCount =
+		static_cast< uint64_t >( static_cast< float64_t >( m_fixedFrameDeltaSeconds ) * Timer::GetTicksPerSecond() );
+	if( m_fixedFrameDeltaSeconds > 0.0f && m_fixedFrameDeltaTickCount == 0 )
+	{
+		m_fixedFrameDeltaTickCount = 1;
+	}
+}
+
+/// Update all scene stream requests that are still in progress.
+void WorldManager::UpdateStreaming()
+{
+	size_t streamRequestIndex = 0;
+	while( streamRequestIndex < m_streamRequests.GetSize() )
+	{
+		StreamRequest* pRequest = m_streamRequests[ streamRequestIndex ];
+		HELIUM_ASSERT( pRequest );
+
+		if( !TickStreamRequest( pRequest ) )
+		{
+			++streamRequestIndex;
+
+			continue;
+		}
+
+		FinishCacheAccessTrace( pRequest, true );
+
+		pRequest->bComplete = true;
+		m_streamRequests.RemoveSwap( streamRequestIndex );
+	}
+
+	size_t unloadRequestIndex = 0;
+	while( unloadRequestIndex < m_unloadRequests.GetSize() )
+	{
+		if( !TickUnloadRequest( m_unloadRequests[ unloadRequestIndex ] ) )
+		{
+			++unloadRequestIndex;
+
+			continue;
+		}
+
+		m_unloadRequests.RemoveSwap( unloadRequestIndex );
+	}
+}
+
+/// Stop recording the cache access trace of a scene stream, if it is being recorded.
+///
+/// @param[in] pRequest  Stream request.
+/// @param[in] bSave     True to save the recorded trace as the trace of the scene, false to discard it.
+void WorldManager::FinishCacheAccessTrace( StreamRequest* pRequest, bool bSave )
+{
+	HELIUM_ASSERT( pRequest );
+
+	if( !pRequest->bRecordingCacheAccesses )
+	{
+		return;
+	}
+
+	pRequest->bRecordingCacheAccesses = false;
+
+	CacheAccessTrace trace;
+	CacheAccessTrace::EndRecording( trace );
+
+	// Streams that failed to load their scene don't reflect how the scene loads.
+	if( !bSave || !pRequest->spSlice )
+	{
+		return;
+	}
+
+	FilePath tracePath;
+	if( !CacheAccessTrace::GetTraceFilePath( pRequest->scenePath, tracePath ) || !trace.SaveToFile( tracePath ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"WorldManager: Failed to save the cache access trace of scene \"%s\".\n",
+			*pRequest->scenePath.ToString() );
+
+		return;
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"WorldManager: Saved %" PRIuSZ " cache accesses of scene \"%s\" to \"%s\".\n",
+		trace.GetRecordCount(),
+		*pRequest->scenePath.ToString(),
+		tracePath.Data() );
+}
+
+/// Update a scene stream request for the current frame.
+///
+/// @param[in] pRequest  Stream request to update.
+///
+/// @return  True if the stream has finished, false if it still needs processing.
+bool WorldManager::TickStreamRequest( StreamRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+
+	if( IsValid( pRequest->loadRequestId ) )
+	{
+		AssetPtr spSceneAsset;
+		if( !AssetLoader::GetInstance()->TryFinishLoad( pRequest->loadRequestId, spSceneAsset ) )
+		{
+			return false;
+		}
+
+		SetInvalid( pRequest->loadRequestId );
+
+		SceneDefinition* pSceneDefinition = Reflect::SafeCast< SceneDefinition >( spSceneAsset.Get() );
+		if( !pSceneDefinition )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"WorldManager::TickStreamRequest(): Streamed asset is not a loaded scene definition.\n" );
+
+			return true;
+		}
+
+		pRequest->spSceneDefinition = pSceneDefinition;
+
+		// The slice is filled while detached so the world never sees a partly streamed scene.
+		SlicePtr spSlice = Reflect::AssertCast< Slice >( Slice::CreateObject() );
+		HELIUM_ASSERT( spSlice );
+		spSlice->Initialize( pSceneDefinition );
+
+		World* pWorld = pRequest->spWorld;
+		HELIUM_ASSERT( pWorld );
+		if( !spSlice->BeginDetachedBuild( pWorld ) )
+		{
+			return true;
+		}
+
+		pRequest->spSlice = spSlice;
+	}
+
+	SceneDefinition* pSceneDefinition = pRequest->spSceneDefinition;
+	HELIUM_ASSERT( pSceneDefinition );
+	Slice* pSlice = pRequest->spSlice;
+	HELIUM_ASSERT( pSlice );
+
+	uint64_t startTickCount = Timer::GetTickCount();
+	size_t entityDefinitionCount = pSceneDefinition->GetEntityDefinitionCount();
+	while( pRequest->entityIndex < entityDefinitionCount )
+	{
+		EntityDefinition *pEntityDefinition = pSceneDefinition->GetEntityDefinition( pRequest->entityIndex );
+		HELIUM_ASSERT( pEntityDefinition );
+		pSlice->CreateEntity( pEntityDefinition );
+		++pRequest->entityIndex;
+
+		if( Timer::GetTickCount() - startTickCount >= pRequest->budgetTicks )
+		{
+			break;
+		}
+	}
+
+	if( pRequest->entityIndex < entityDefinitionCount )
+	{
+		return false;
+	}
+
+	// Every entity is built, so splice the slice into the world before this frame's tasks run.
+	World* pWorld = pRequest->spWorld;
+	HELIUM_ASSERT( pWorld );
+	if( !pWorld->AddSlice( pSlice ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"WorldManager::TickStreamRequest(): Failed to add slice for scene \"%s\" to its world.\n",
+			*pSceneDefinition->GetPath().ToString() );
+
+		pRequest->spSlice.Release();
+	}
+
+	return true;
+}
+
+/// Update a slice unload request for the current frame.
+///
+/// @param[in] rRequest  Unload request to update.
+///
+/// @return  True if the slice has been removed from its world (or was no longer bound to one), false if it still has
+///          entities left to destroy.
+bool WorldManager::TickUnloadRequest( UnloadRequest& rRequest )
+{
+	Slice* pSlice = rRequest.spSlice;
+	HELIUM_ASSERT( pSlice );
+
+	World* pWorld = pSlice->GetWorld();
+	if( !pWorld )
+	{
+		rRequest.spSlice.Release();
+
+		return true;
+	}
+
+	// Destroy from the back so that no other entity has to move to fill the gap.
+	ComponentManager* pComponentManager = pWorld->GetComponentManager();
+	HELIUM_ASSERT( pComponentManager );
+	pComponentManager->BeginBatchedFrees();
+
+	uint64_t startTickCount = Timer::GetTickCount();
+	while( pSlice->GetEntityCount() != 0 )
+	{
+		EntityPtr spEntity( pSlice->GetEntity( pSlice->GetEntityCount() - 1 ) );
+		HELIUM_VERIFY( pSlice->DestroyEntity( spEntity ) );
+		spEntity.Release();
+
+		if( Timer::GetTickCount() - startTickCount >= rRequest.budgetTicks )
+		{
+			break;
+		}
+	}
+
+	pComponentManager->EndBatchedFrees();
+
+	if( pSlice->GetEntityCount() != 0 )
+	{
+		return false;
+	}
+
+	HELIUM_VERIFY( pWorld->RemoveSlice( pSlice ) );
+	rRequest.spSlice.Release();
+
+	return true;
+}
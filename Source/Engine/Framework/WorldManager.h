@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Engine/AssetPath.h"
+#include "Engine/AssetLoader.h"
+#include "Foundation/ObjectPool.h"
 
 #include "Framework/World.h"
 #include "Framework/TaskScheduler.h"
@@ -13,11 +15,21 @@
 namespace Helium
 {
 	class SceneDefinition;
+	typedef Helium::StrongPtr< SceneDefinition > SceneDefinitionPtr;
 
 	/// Manager for individual World instances.
+	///
+	/// Scenes can also be streamed into an existing world in the background.  The scene definition is loaded through
+	/// the AssetLoader at the priority given, after which its entities are created a few at a time each frame, within
+	/// the budget given for the stream, into a detached slice (see Slice::BeginDetachedBuild()).  Once every entity
+	/// has been created the slice is attached to the world through World::AddSlice() at the start of a frame.
+	/// Streamed-in slices can be unloaded the same way, destroying a budgeted number of entities each frame.
 	class HELIUM_FRAMEWORK_API WorldManager : NonCopyable
 	{
 	public:
+		/// Number of stream request objects to allocate in each block of the request pool.
+		static const size_t STREAM_REQUEST_POOL_BLOCK_SIZE = 16;
+
 		/// @name Initialization
 		//@{
 		bool Initialize();
@@ -33,9 +45,26 @@ namespace Helium
 		Package* GetRootSceneDefinitionsPackage() const;
 		//@}
 
+		/// @name Scene Streaming
+		//@{
+		size_t BeginStreamScene(
+			AssetPath scenePath, World* pWorld, AssetLoader::EPriority priority = AssetLoader::PRIORITY_LOW,
+			float32_t budgetMilliseconds = 1.0f );
+		bool TryFinishStreamScene( size_t id, SlicePtr& rspSlice );
+
+		bool BeginUnloadSlice( Slice* pSlice, float32_t budgetMilliseconds = 1.0f );
+		inline size_t GetUnloadingSliceCount() const;
+
+		void SetCacheAccessTraceRecordingEnabled( bool bEnabled );
+		inline bool IsCacheAccessTraceRecordingEnabled() const;
+		//@}
+
 		/// @name Updating
 		//@{
 		void Update( TaskSchedule &schedule );
+
+		void SetWorldShardingEnabled( bool bEnabled );
+		inline bool IsWorldShardingEnabled() const;
 		//@}
 
 		/// @name Timing
@@ -43,6 +72,9 @@ namespace Helium
 		inline uint64_t GetFrameTickCount() const;
 		inline uint64_t GetFrameDeltaTickCount() const;
 		inline float32_t GetFrameDeltaSeconds() const;
+
+		void SetFixedFrameDeltaSeconds( float32_t seconds );
+		inline float32_t GetFixedFrameDeltaSeconds() const;
 		//@}
 
 		/// @name Static Access
@@ -53,11 +85,50 @@ namespace Helium
 		//@}
 
 	private:
+		/// Scene stream request information.
+		struct StreamRequest
+		{
+			/// World into which the scene is streamed.
+			WorldPtr spWorld;
+			/// Scene definition load request ID, or invalid once the scene definition has loaded.
+			size_t loadRequestId;
+			/// Scene definition, once loaded.
+			SceneDefinitionPtr spSceneDefinition;
+			/// Slice created for the scene, once the scene definition has loaded (detached until the stream completes).
+			SlicePtr spSlice;
+			/// Index of the next entity definition to create an entity for.
+			size_t entityIndex;
+			/// Time each frame may spend creating entities for this stream, in timer ticks.
+			uint64_t budgetTicks;
+			/// True once the stream has finished (successfully or not).
+			bool bComplete;
+			/// Path of the scene definition streamed.
+			AssetPath scenePath;
+			/// True if the cache accesses of this stream are being recorded.
+			bool bRecordingCacheAccesses;
+		};
+
+		/// Slice unload request information.
+		struct UnloadRequest
+		{
+			/// Slice being unloaded.
+			SlicePtr spSlice;
+			/// Time each frame may spend destroying entities for this unload, in timer ticks.
+			uint64_t budgetTicks;
+		};
+
 		/// World package.
 		PackagePtr m_spRootSceneDefinitionsPackage;
 		/// World instances.
 		DynamicArray< WorldPtr > m_worlds;
 
+		/// Stream request pool.
+		ObjectPool< StreamRequest > m_streamRequestPool;
+		/// Stream requests that are still in progress.
+		DynamicArray< StreamRequest* > m_streamRequests;
+		/// Slices still being unloaded.
+		DynamicArray< UnloadRequest > m_unloadRequests;
+
 		/// Actual application tick count at the start of the current frame.
 		uint64_t m_actualFrameTickCount;
 		/// Elapsed tick count for the current frame (adjusted for frame rate limits).
@@ -66,6 +137,15 @@ namespace Helium
 		uint64_t m_frameDeltaTickCount;
 		/// Seconds elapsed since the previous frame (adjusted for frame rate limits).
 		float32_t m_frameDeltaSeconds;
+		/// Ticks each frame advances by regardless of the actual time elapsed, or zero to follow the actual time.
+		uint64_t m_fixedFrameDeltaTickCount;
+		/// Seconds each frame advances by regardless of the actual time elapsed, or zero to follow the actual time.
+		float32_t m_fixedFrameDeltaSeconds;
+
+		/// True to tick each world as its own shard of the schedule, in parallel with the other worlds.
+		bool m_bShardWorlds;
+		/// True to record a cache access trace for each scene streamed.
+		bool m_bRecordCacheAccessTraces;
 
 		/// True if the first frame has been processed.
 		bool m_bProcessedFirstFrame;
@@ -83,6 +163,14 @@ namespace Helium
 		//@{
 		void UpdateTime();
 		//@}
+
+		/// @name Scene Streaming Updating
+		//@{
+		void UpdateStreaming();
+		bool TickStreamRequest( StreamRequest* pRequest );
+		bool TickUnloadRequest( UnloadRequest& rRequest );
+		void FinishCacheAccessTrace( StreamRequest* pRequest, bool bSave );
+		//@}
 	};
 }
 
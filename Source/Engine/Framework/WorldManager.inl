@@ -35,4 +35,44 @@ namespace Helium
     {
         return m_frameDeltaSeconds;
     }
+
+    /// Get the number of slices still being unloaded.
+    ///
+    /// @return  Number of slices passed to BeginUnloadSlice() that still have entities left to destroy.
+    ///
+    /// @see BeginUnloadSlice()
+    size_t WorldManager::GetUnloadingSliceCount() const
+    {
+        return m_unloadRequests.GetSize();
+    }
+
+    /// Get whether worlds are ticked in parallel with each other.
+    ///
+    /// @return  True if each world runs as its own shard of the schedule, false if every task updates all worlds.
+    ///
+    /// @see SetWorldShardingEnabled()
+    bool WorldManager::IsWorldShardingEnabled() const
+    {
+        return m_bShardWorlds;
+    }
+
+    /// Get whether a cache access trace is recorded for each scene streamed.
+    ///
+    /// @return  True if cache access traces are recorded, false if not.
+    ///
+    /// @see SetCacheAccessTraceRecordingEnabled()
+    bool WorldManager::IsCacheAccessTraceRecordingEnabled() const
+    {
+        return m_bRecordCacheAccessTraces;
+    }
+
+    /// Get the fixed number of seconds each frame advances by.
+    ///
+    /// @return  Fixed frame time step, in seconds, or zero if frames follow the actual time elapsed.
+    ///
+    /// @see SetFixedFrameDeltaSeconds()
+    float32_t WorldManager::GetFixedFrameDeltaSeconds() const
+    {
+        return m_fixedFrameDeltaSeconds;
+    }
 }
\ No newline at end of file
@@ -20,15 +20,24 @@ void ConfigInitializationImpl::Startup()
 
 	HELIUM_TRACE( TraceLevels::Info, "Loading configuration settings.\n" );
 
-	pConfig->BeginLoad();
-	while( !pConfig->TryFinishLoad() )
+	// Tools builds always load through the asset pipeline so that edits to the default configuration are picked up,
+	// and cook the result for non-tools builds to map directly.
+#if !HELIUM_TOOLS
+	if( !pConfig->LoadCooked() )
+#endif
 	{
-		pAssetLoader->Tick();
+		pConfig->BeginLoad();
+		while( !pConfig->TryFinishLoad() )
+		{
+			pAssetLoader->Tick();
+		}
 	}
 
 	HELIUM_TRACE( TraceLevels::Debug, "Configuration settings loaded.\n" );
 
 #if HELIUM_TOOLS
+	pConfig->WriteCooked();
+
 	HELIUM_TRACE( TraceLevels::Info, "Saving user configuration.\n" );
 	ConfigPc::SaveUserConfig();
 	HELIUM_TRACE( TraceLevels::Info, "User configuration saved.\n" );
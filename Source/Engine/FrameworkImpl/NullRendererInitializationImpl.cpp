@@ -0,0 +1,65 @@
+#include "Precompile.h"
+#include "FrameworkImpl/NullRendererInitializationImpl.h"
+#include "Engine/Config.h"
+#include "Graphics/GraphicsConfig.h"
+#include "Rendering/NullRenderer.h"
+
+#include "Graphics/RenderResourceManager.h"
+#include "Graphics/TextureStreamingManager.h"
+#include "Graphics/DynamicDrawer.h"
+#include "Graphics/GpuTimerManager.h"
+#include "Graphics/RenderThread.h"
+
+using namespace Helium;
+
+/// @copydoc RendererInitialization::Initialize()
+bool NullRendererInitializationImpl::Initialize()
+{
+	NullRenderer::Startup();
+	Renderer* pRenderer = NullRenderer::GetInstance();
+	if ( !HELIUM_VERIFY( pRenderer ) )
+	{
+		return false;
+	}
+
+	// The main context has no window, but still takes the display size and threading mode from the graphics config so
+	// that scene views and the render thread are set up the same way as with the regular renderer.
+	Config* pConfig = Config::GetInstance();
+	HELIUM_ASSERT( pConfig );
+
+	StrongPtr< GraphicsConfig > spGraphicsConfig( pConfig->GetConfigObject< GraphicsConfig >( Name( "GraphicsConfig" ) ) );
+	HELIUM_ASSERT( spGraphicsConfig );
+
+	Renderer::ContextInitParameters contextInitParams;
+	contextInitParams.displayWidth = spGraphicsConfig->GetWidth();
+	contextInitParams.displayHeight = spGraphicsConfig->GetHeight();
+	contextInitParams.bMultithreaded = spGraphicsConfig->GetPipelinedRendering();
+	if( !HELIUM_VERIFY( pRenderer->CreateMainContext( contextInitParams ) ) )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "Failed to create null renderer context.\n" );
+		return false;
+	}
+
+	RenderResourceManager::Startup();
+	TextureStreamingManager::Startup();
+	DynamicDrawer::Startup();
+	GpuTimerManager::Startup();
+	RenderThread::Startup();
+
+	return true;
+}
+
+void Helium::NullRendererInitializationImpl::Shutdown()
+{
+	// Stop the render thread before the systems it renders with are shut down.
+	RenderThread::Shutdown();
+	GpuTimerManager::Shutdown();
+	DynamicDrawer::Shutdown();
+	TextureStreamingManager::Shutdown();
+	RenderResourceManager::Shutdown();
+
+	if( Renderer::GetInstance() )
+	{
+		NullRenderer::Shutdown();
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "FrameworkImpl/FrameworkImpl.h"
+#include "Framework/RendererInitialization.h"
+
+namespace Helium
+{
+	/// Renderer factory implementation creating a NullRenderer, so that the full rendering pipeline runs on the CPU
+	/// without a window or GPU.
+	class HELIUM_FRAMEWORK_IMPL_API NullRendererInitializationImpl : public RendererInitialization
+	{
+	public:
+		/// @name Renderer Initialization
+		//@{
+		virtual bool Initialize();
+		//@}
+
+		virtual void Shutdown();
+	};
+}
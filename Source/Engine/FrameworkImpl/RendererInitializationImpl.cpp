@@ -2,6 +2,7 @@
 #include "FrameworkImpl/RendererInitializationImpl.h"
 #include "Windowing/WindowManager.h"
 #include "Engine/Config.h"
+#include "Engine/ResidencyManager.h"
 #include "Graphics/GraphicsConfig.h"
 
 #if HELIUM_DIRECT3D
@@ -11,7 +12,10 @@
 #endif
 
 #include "Graphics/RenderResourceManager.h"
+#include "Graphics/TextureStreamingManager.h"
 #include "Graphics/DynamicDrawer.h"
+#include "Graphics/GpuTimerManager.h"
+#include "Graphics/RenderThread.h"
 
 using namespace Helium;
 
@@ -52,7 +56,13 @@ bool RendererInitializationImpl::Initialize()
 	uint32_t displayWidth = spGraphicsConfig->GetWidth();
 	uint32_t displayHeight = spGraphicsConfig->GetHeight();
 	bool bFullscreen = spGraphicsConfig->GetFullscreen();
-	bool bVsync = spGraphicsConfig->GetVsync();
+	ERendererPresentMode presentMode = RENDERER_PRESENT_MODE_IMMEDIATE;
+	if( spGraphicsConfig->GetVsync() )
+	{
+		presentMode =
+			( spGraphicsConfig->GetAdaptiveVsync() ? RENDERER_PRESENT_MODE_ADAPTIVE_VSYNC : RENDERER_PRESENT_MODE_VSYNC );
+	}
+	bool bPipelinedRendering = spGraphicsConfig->GetPipelinedRendering();
 
 	Window::Parameters windowParameters;
 	windowParameters.pTitle = "Helium";
@@ -77,7 +87,9 @@ bool RendererInitializationImpl::Initialize()
 	contextInitParams.displayWidth = displayWidth;
 	contextInitParams.displayHeight = displayHeight;
 	contextInitParams.bFullscreen = bFullscreen;
-	contextInitParams.bVsync = bVsync;
+	contextInitParams.presentMode = presentMode;
+	contextInitParams.frameRateLimit = spGraphicsConfig->GetFrameRateLimit();
+	contextInitParams.bMultithreaded = bPipelinedRendering;
 	if( !HELIUM_VERIFY( pRenderer->CreateMainContext( contextInitParams ) ) )
 	{
 		HELIUM_TRACE( TraceLevels::Error, "Failed to create main renderer context.\n" );
@@ -85,7 +97,17 @@ bool RendererInitializationImpl::Initialize()
 	}
 
 	RenderResourceManager::Startup();
+	TextureStreamingManager::Startup();
 	DynamicDrawer::Startup();
+	GpuTimerManager::Startup();
+	RenderThread::Startup();
+
+	ResidencyManager* pResidencyManager = ResidencyManager::GetInstance();
+	if( pResidencyManager )
+	{
+		pResidencyManager->SetBudget( static_cast< size_t >( spGraphicsConfig->GetResidencyBudget() ) << 20 );
+	}
+
 	return true;
 }
 
@@ -112,7 +134,11 @@ void RendererInitializationImpl::OnMainWindowDestroyed( Window* pWindow )
 
 void Helium::RendererInitializationImpl::Shutdown()
 {
+	// Stop the render thread before the systems it renders with are shut down.
+	RenderThread::Shutdown();
+	GpuTimerManager::Shutdown();
 	DynamicDrawer::Shutdown();
+	TextureStreamingManager::Shutdown();
 	RenderResourceManager::Shutdown();
 
 	Renderer* pRenderer = Renderer::GetInstance();
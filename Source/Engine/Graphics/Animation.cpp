@@ -1,15 +1,29 @@
 #include "Precompile.h"
 #include "Graphics/Animation.h"
+#include "Engine/CookedObjectLayout.h"
 
 #if HELIUM_USE_GRANNY_ANIMATION
 #include "GrannyAnimationInterface.h"
 #include "GrannyAnimationInterface.cpp.inl"
+#else
+#include "Reflect/TranslatorDeduction.h"
 #endif
 
 HELIUM_IMPLEMENT_ASSET( Helium::Animation, Graphics, AssetType::FLAG_NO_TEMPLATE );
+#if !HELIUM_USE_GRANNY_ANIMATION
+HELIUM_DEFINE_CLASS( Helium::Animation::PersistentResourceData );
+HELIUM_DEFINE_COOKED_LAYOUT( Helium::Animation::PersistentResourceData );
+#endif
 
 using namespace Helium;
 
+#if !HELIUM_USE_GRANNY_ANIMATION
+/// Largest magnitude of the three smallest components of a unit quaternion (one over the square root of two).
+static const float32_t ROTATION_COMPONENT_MAX = 0.70710678f;
+/// Largest value of a packed rotation component.
+static const uint16_t ROTATION_COMPONENT_SCALE = 0x7fff;
+#endif
+
 /// Constructor.
 Animation::Animation()
 {
@@ -27,3 +41,333 @@ Name Animation::GetCacheName() const
 
     return cacheName;
 }
+
+#if !HELIUM_USE_GRANNY_ANIMATION
+
+Animation::PersistentResourceData::PersistentResourceData()
+: m_frameCount( 0 )
+, m_framesPerSecond( 0.0f )
+{
+}
+
+void Animation::PersistentResourceData::PopulateMetaType( Reflect::MetaStruct& comp )
+{
+    comp.AddField( &PersistentResourceData::m_trackNames,             "m_trackNames" );
+    comp.AddField( &PersistentResourceData::m_trackKeyOffsets,        "m_trackKeyOffsets" );
+    comp.AddField( &PersistentResourceData::m_trackTranslationRanges, "m_trackTranslationRanges" );
+    comp.AddField( &PersistentResourceData::m_trackScaleRanges,       "m_trackScaleRanges" );
+    comp.AddField( &PersistentResourceData::m_keyFrames,              "m_keyFrames" );
+    comp.AddField( &PersistentResourceData::m_keyRotations,           "m_keyRotations" );
+    comp.AddField( &PersistentResourceData::m_keyTranslations,        "m_keyTranslations" );
+    comp.AddField( &PersistentResourceData::m_keyScales,              "m_keyScales" );
+    comp.AddField( &PersistentResourceData::m_frameCount,             "m_frameCount" );
+    comp.AddField( &PersistentResourceData::m_framesPerSecond,        "m_framesPerSecond" );
+}
+
+void Animation::PersistentResourceData::PopulateCookedLayout( CookedObjectLayout& rLayout )
+{
+    rLayout.AddNameArray( &PersistentResourceData::m_trackNames );
+    rLayout.AddArray( &PersistentResourceData::m_trackKeyOffsets );
+    rLayout.AddArray( &PersistentResourceData::m_trackTranslationRanges );
+    rLayout.AddArray( &PersistentResourceData::m_trackScaleRanges );
+    rLayout.AddArray( &PersistentResourceData::m_keyFrames );
+    rLayout.AddArray( &PersistentResourceData::m_keyRotations );
+    rLayout.AddArray( &PersistentResourceData::m_keyTranslations );
+    rLayout.AddArray( &PersistentResourceData::m_keyScales );
+    rLayout.AddPlainData( &PersistentResourceData::m_frameCount );
+    rLayout.AddPlainData( &PersistentResourceData::m_framesPerSecond );
+}
+
+/// @copydoc Resource::LoadPersistentResourceObject()
+bool Animation::LoadPersistentResourceObject( Reflect::ObjectPtr& _object )
+{
+    HELIUM_ASSERT( _object.ReferencesObject() );
+    if( !_object.ReferencesObject() )
+    {
+        return false;
+    }
+
+    _object->CopyTo( &m_persistentResourceData );
+
+    const PersistentResourceData& rData = m_persistentResourceData;
+    size_t trackCount = rData.m_trackNames.GetSize();
+    size_t keyCount = rData.m_keyFrames.GetSize();
+    if( rData.m_trackKeyOffsets.GetSize() != trackCount + 1 ||
+        rData.m_trackKeyOffsets[ trackCount ] != keyCount ||
+        rData.m_trackTranslationRanges.GetSize() != trackCount * 6 ||
+        rData.m_trackScaleRanges.GetSize() != trackCount * 6 ||
+        rData.m_keyRotations.GetSize() != keyCount * 3 ||
+        rData.m_keyTranslations.GetSize() != keyCount * 3 ||
+        rData.m_keyScales.GetSize() != keyCount * 3 )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "Animation::LoadPersistentResourceObject(): Key frame data for animation \"%s\" is inconsistent.\n",
+            *GetPath().ToString() );
+
+        m_persistentResourceData.m_trackNames.Clear();
+        m_persistentResourceData.m_trackKeyOffsets.Clear();
+        m_persistentResourceData.m_frameCount = 0;
+
+        return false;
+    }
+
+    for( size_t trackIndex = 0; trackIndex < trackCount; ++trackIndex )
+    {
+        HELIUM_ASSERT( rData.m_trackKeyOffsets[ trackIndex ] < rData.m_trackKeyOffsets[ trackIndex + 1 ] );
+    }
+
+    return true;
+}
+
+/// Find the track animating a given bone.
+///
+/// @param[in] boneName  Bone name.
+///
+/// @return  Index of the track animating the bone, or an invalid index if the bone is not animated.
+///
+/// @see GetTrackCount(), GetTrackNames()
+size_t Animation::FindTrack( Name boneName ) const
+{
+    const DynamicArray< Name >& rTrackNames = m_persistentResourceData.m_trackNames;
+
+    size_t trackCount = rTrackNames.GetSize();
+    for( size_t trackIndex = 0; trackIndex < trackCount; ++trackIndex )
+    {
+        if( rTrackNames[ trackIndex ] == boneName )
+        {
+            return trackIndex;
+        }
+    }
+
+    return Invalid< size_t >();
+}
+
+/// Get the frame to sample at a given playback time.
+///
+/// @param[in] time   Playback time, in seconds.
+/// @param[in] bLoop  True to wrap the time around the animation duration, false to clamp it.
+///
+/// @return  Fractional frame index.
+///
+/// @see FindKeys()
+float32_t Animation::GetFrame( float32_t time, bool bLoop ) const
+{
+    uint32_t frameCount = m_persistentResourceData.m_frameCount;
+    if( frameCount <= 1 )
+    {
+        return 0.0f;
+    }
+
+    float32_t lastFrame = static_cast< float32_t >( frameCount - 1 );
+    float32_t frame = time * m_persistentResourceData.m_framesPerSecond;
+    if( bLoop )
+    {
+        frame -= Floor( frame / lastFrame ) * lastFrame;
+    }
+
+    return Clamp( frame, 0.0f, lastFrame );
+}
+
+/// Find the pair of keys of a track to interpolate between for a given frame.
+///
+/// @param[in]  trackIndex  Track index.
+/// @param[in]  frame       Fractional frame index (see GetFrame()).
+/// @param[out] rKey0       Index of the key at or before the frame.
+/// @param[out] rKey1       Index of the key after the frame (the same as rKey0 past the last key).
+///
+/// @return  Interpolation factor between the two keys.
+///
+/// @see DecodeKey()
+float32_t Animation::FindKeys( size_t trackIndex, float32_t frame, size_t& rKey0, size_t& rKey1 ) const
+{
+    const PersistentResourceData& rData = m_persistentResourceData;
+    HELIUM_ASSERT( trackIndex < rData.m_trackNames.GetSize() );
+
+    size_t beginKey = rData.m_trackKeyOffsets[ trackIndex ];
+    size_t endKey = rData.m_trackKeyOffsets[ trackIndex + 1 ];
+    const uint16_t* pKeyFrames = rData.m_keyFrames.GetData();
+
+    // Binary search for the last key at or before the frame (the first key of each track is always frame zero).
+    size_t lowKey = beginKey;
+    size_t highKey = endKey;
+    while( highKey - lowKey > 1 )
+    {
+        size_t middleKey = ( lowKey + highKey ) / 2;
+        if( static_cast< float32_t >( pKeyFrames[ middleKey ] ) <= frame )
+        {
+            lowKey = middleKey;
+        }
+        else
+        {
+            highKey = middleKey;
+        }
+    }
+
+    rKey0 = lowKey;
+    if( lowKey + 1 >= endKey )
+    {
+        rKey1 = lowKey;
+
+        return 0.0f;
+    }
+
+    rKey1 = lowKey + 1;
+
+    float32_t frame0 = static_cast< float32_t >( pKeyFrames[ lowKey ] );
+    float32_t frame1 = static_cast< float32_t >( pKeyFrames[ lowKey + 1 ] );
+
+    return Clamp( ( frame - frame0 ) / ( frame1 - frame0 ), 0.0f, 1.0f );
+}
+
+/// Decode the transform of a single key.
+///
+/// @param[in]  trackIndex    Index of the track to which the key belongs.
+/// @param[in]  keyIndex      Key index (see FindKeys()).
+/// @param[out] pRotation     Rotation quaternion (x, y, z, w).
+/// @param[out] pTranslation  Translation (x, y, z).
+/// @param[out] pScale        Scale (x, y, z).
+void Animation::DecodeKey(
+    size_t trackIndex,
+    size_t keyIndex,
+    float32_t* pRotation,
+    float32_t* pTranslation,
+    float32_t* pScale ) const
+{
+    const PersistentResourceData& rData = m_persistentResourceData;
+    HELIUM_ASSERT( keyIndex >= rData.m_trackKeyOffsets[ trackIndex ] );
+    HELIUM_ASSERT( keyIndex < rData.m_trackKeyOffsets[ trackIndex + 1 ] );
+    HELIUM_ASSERT( pRotation );
+    HELIUM_ASSERT( pTranslation );
+    HELIUM_ASSERT( pScale );
+
+    UnpackRotation( rData.m_keyRotations.GetData() + keyIndex * 3, pRotation );
+
+    const uint16_t* pQuantizedTranslation = rData.m_keyTranslations.GetData() + keyIndex * 3;
+    const uint16_t* pQuantizedScale = rData.m_keyScales.GetData() + keyIndex * 3;
+    const float32_t* pTranslationRange = rData.m_trackTranslationRanges.GetData() + trackIndex * 6;
+    const float32_t* pScaleRange = rData.m_trackScaleRanges.GetData() + trackIndex * 6;
+    for( size_t componentIndex = 0; componentIndex < 3; ++componentIndex )
+    {
+        pTranslation[ componentIndex ] = DequantizeComponent(
+            pQuantizedTranslation[ componentIndex ],
+            pTranslationRange[ componentIndex ],
+            pTranslationRange[ componentIndex + 3 ] );
+        pScale[ componentIndex ] = DequantizeComponent(
+            pQuantizedScale[ componentIndex ],
+            pScaleRange[ componentIndex ],
+            pScaleRange[ componentIndex + 3 ] );
+    }
+}
+
+/// Pack a unit quaternion into 48 bits.
+///
+/// The largest component is dropped (and rebuilt from the other three when unpacking), and the remaining three are
+/// stored in 15 bits each.  The index of the dropped component is stored in the top bits of the first two values.
+///
+/// @param[in]  rRotation  Rotation to pack.
+/// @param[out] pPacked    Three packed values.
+///
+/// @see UnpackRotation()
+void Animation::PackRotation( const Simd::Quat& rRotation, uint16_t* pPacked )
+{
+    HELIUM_ASSERT( pPacked );
+
+    float32_t components[ 4 ] =
+    {
+        rRotation.GetElement( 0 ),
+        rRotation.GetElement( 1 ),
+        rRotation.GetElement( 2 ),
+        rRotation.GetElement( 3 )
+    };
+
+    uint16_t largestIndex = 0;
+    for( uint16_t componentIndex = 1; componentIndex < 4; ++componentIndex )
+    {
+        if( Abs( components[ componentIndex ] ) > Abs( components[ largestIndex ] ) )
+        {
+            largestIndex = componentIndex;
+        }
+    }
+
+    // q and -q are the same rotation, so flip the quaternion to make the dropped component positive.
+    float32_t sign = ( components[ largestIndex ] < 0.0f ? -1.0f : 1.0f );
+
+    size_t packedIndex = 0;
+    for( uint16_t componentIndex = 0; componentIndex < 4; ++componentIndex )
+    {
+        if( componentIndex == largestIndex )
+        {
+            continue;
+        }
+
+        float32_t normalized = Clamp(
+            ( components[ componentIndex ] * sign / ROTATION_COMPONENT_MAX ) * 0.5f + 0.5f,
+            0.0f,
+            1.0f );
+        pPacked[ packedIndex ] = static_cast< uint16_t >(
+            normalized * static_cast< float32_t >( ROTATION_COMPONENT_SCALE ) + 0.5f );
+        ++packedIndex;
+    }
+
+    pPacked[ 0 ] |= static_cast< uint16_t >( ( largestIndex & 1 ) << 15 );
+    pPacked[ 1 ] |= static_cast< uint16_t >( ( largestIndex >> 1 ) << 15 );
+}
+
+/// Unpack a quaternion packed with PackRotation().
+///
+/// @param[in]  pPacked    Three packed values.
+/// @param[out] pRotation  Unit quaternion (x, y, z, w).
+///
+/// @see PackRotation()
+void Animation::UnpackRotation( const uint16_t* pPacked, float32_t* pRotation )
+{
+    HELIUM_ASSERT( pPacked );
+    HELIUM_ASSERT( pRotation );
+
+    size_t largestIndex = ( pPacked[ 0 ] >> 15 ) | ( ( pPacked[ 1 ] >> 15 ) << 1 );
+
+    static const float32_t componentScale = 2.0f * ROTATION_COMPONENT_MAX / static_cast< float32_t >( ROTATION_COMPONENT_SCALE );
+
+    float32_t sumSquares = 0.0f;
+    size_t packedIndex = 0;
+    for( size_t componentIndex = 0; componentIndex < 4; ++componentIndex )
+    {
+        if( componentIndex == largestIndex )
+        {
+            continue;
+        }
+
+        float32_t component =
+            static_cast< float32_t >( pPacked[ packedIndex ] & ROTATION_COMPONENT_SCALE ) * componentScale -
+            ROTATION_COMPONENT_MAX;
+        pRotation[ componentIndex ] = component;
+        sumSquares += component * component;
+        ++packedIndex;
+    }
+
+    pRotation[ largestIndex ] = sqrtf( Max( 1.0f - sumSquares, 0.0f ) );
+}
+
+/// Quantize a key component to 16 bits.
+///
+/// @param[in] value    Component value.
+/// @param[in] minimum  Minimum value of the component in its track.
+/// @param[in] range    Range of values of the component in its track.
+///
+/// @return  Quantized value.
+///
+/// @see DequantizeComponent()
+uint16_t Animation::QuantizeComponent( float32_t value, float32_t minimum, float32_t range )
+{
+    if( range <= 0.0f )
+    {
+        return 0;
+    }
+
+    float32_t normalized = Clamp( ( value - minimum ) / range, 0.0f, 1.0f );
+
+    return static_cast< uint16_t >( normalized * 65535.0f + 0.5f );
+}
+
+#endif  // !HELIUM_USE_GRANNY_ANIMATION
@@ -7,22 +7,74 @@
 
 #if HELIUM_USE_GRANNY_ANIMATION
 #include "GrannyAnimationInterface.h"
+#else
+#include "MathSimd/Quat.h"
+#include "MathSimd/Vector3.h"
 #endif
 
 namespace Helium
 {
+    class CookedObjectLayout;
+
     /// Animation resource data.
     class HELIUM_GRAPHICS_API Animation : public Resource
     {
         HELIUM_DECLARE_ASSET( Animation, Resource );
 
     public:
+#if !HELIUM_USE_GRANNY_ANIMATION
+        /// Compressed key frame data.
+        ///
+        /// Each track holds the parent-relative transform of one bone.  Keys are only kept for the frames that linear
+        /// interpolation between their neighbors cannot reproduce within tolerance, so every track has its own key
+        /// frame list (a constant track is a single key).  Rotations are packed as their three smallest components,
+        /// and translations and scales are quantized to 16 bits within the range of their track.
+        struct HELIUM_GRAPHICS_API PersistentResourceData : public Object
+        {
+            HELIUM_DECLARE_CLASS( Animation::PersistentResourceData, Reflect::Object );
+
+            PersistentResourceData();
+            static void PopulateMetaType( Reflect::MetaStruct& comp );
+            static void PopulateCookedLayout( CookedObjectLayout& rLayout );
+
+            /// Name of the bone animated by each track.
+            DynamicArray< Name > m_trackNames;
+            /// Index of the first key of each track, followed by the total key count.
+            DynamicArray< uint32_t > m_trackKeyOffsets;
+            /// Minimum translation and translation range of each track (six values per track).
+            DynamicArray< float32_t > m_trackTranslationRanges;
+            /// Minimum scale and scale range of each track (six values per track).
+            DynamicArray< float32_t > m_trackScaleRanges;
+
+            /// Frame index of each key.
+            DynamicArray< uint16_t > m_keyFrames;
+            /// Packed rotation of each key (three values per key).
+            DynamicArray< uint16_t > m_keyRotations;
+            /// Quantized translation of each key (three values per key).
+            DynamicArray< uint16_t > m_keyTranslations;
+            /// Quantized scale of each key (three values per key).
+            DynamicArray< uint16_t > m_keyScales;
+
+            /// Number of frames sampled from the source animation.
+            uint32_t m_frameCount;
+            /// Frame rate.
+            float32_t m_framesPerSecond;
+        };
+#endif
+
         /// @name Construction/Destruction
         //@{
         Animation();
         virtual ~Animation();
         //@}
 
+#if !HELIUM_USE_GRANNY_ANIMATION
+        /// @name Resource Serialization
+        //@{
+        virtual bool LoadPersistentResourceObject( Reflect::ObjectPtr& _object ) override;
+        //@}
+#endif
+
         /// @name Resource Caching Support
         //@{
         virtual Name GetCacheName() const override;
@@ -32,13 +84,44 @@ namespace Helium
         //@{
 #if HELIUM_USE_GRANNY_ANIMATION
         inline const Granny::AnimationData& GetGrannyData() const;
+#else
+        inline size_t GetTrackCount() const;
+        inline const Name* GetTrackNames() const;
+        size_t FindTrack( Name boneName ) const;
+
+        inline uint32_t GetFrameCount() const;
+        inline float32_t GetFramesPerSecond() const;
+        inline float32_t GetDuration() const;
 #endif
         //@}
 
+#if !HELIUM_USE_GRANNY_ANIMATION
+        /// @name Sampling
+        //@{
+        float32_t GetFrame( float32_t time, bool bLoop ) const;
+        float32_t FindKeys( size_t trackIndex, float32_t frame, size_t& rKey0, size_t& rKey1 ) const;
+        void DecodeKey(
+            size_t trackIndex, size_t keyIndex, float32_t* pRotation, float32_t* pTranslation,
+            float32_t* pScale ) const;
+        //@}
+
+        /// @name Key Compression
+        //@{
+        static void PackRotation( const Simd::Quat& rRotation, uint16_t* pPacked );
+        static void UnpackRotation( const uint16_t* pPacked, float32_t* pRotation );
+
+        static uint16_t QuantizeComponent( float32_t value, float32_t minimum, float32_t range );
+        inline static float32_t DequantizeComponent( uint16_t value, float32_t minimum, float32_t range );
+        //@}
+#endif
+
     private:
 #if HELIUM_USE_GRANNY_ANIMATION
         /// Granny-specific animation data.
         Granny::AnimationData m_grannyData;
+#else
+        /// Compressed key frame data.
+        PersistentResourceData m_persistentResourceData;
 #endif
     };
 }
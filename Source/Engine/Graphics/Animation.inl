@@ -8,5 +8,74 @@ namespace Helium
     {
         return m_grannyData;
     }
+#else  // HELIUM_USE_GRANNY_ANIMATION
+    /// Get the number of tracks in this animation.
+    ///
+    /// @return  Track count.
+    ///
+    /// @see GetTrackNames(), FindTrack()
+    size_t Animation::GetTrackCount() const
+    {
+        return m_persistentResourceData.m_trackNames.GetSize();
+    }
+
+    /// Get the name of the bone animated by each track.
+    ///
+    /// @return  Array of track bone names.
+    ///
+    /// @see GetTrackCount(), FindTrack()
+    const Name* Animation::GetTrackNames() const
+    {
+        return m_persistentResourceData.m_trackNames.GetData();
+    }
+
+    /// Get the number of frames sampled from the source animation.
+    ///
+    /// @return  Frame count.
+    ///
+    /// @see GetFramesPerSecond(), GetDuration()
+    uint32_t Animation::GetFrameCount() const
+    {
+        return m_persistentResourceData.m_frameCount;
+    }
+
+    /// Get the animation frame rate.
+    ///
+    /// @return  Frames per second.
+    ///
+    /// @see GetFrameCount(), GetDuration()
+    float32_t Animation::GetFramesPerSecond() const
+    {
+        return m_persistentResourceData.m_framesPerSecond;
+    }
+
+    /// Get the length of this animation.
+    ///
+    /// @return  Time between the first and last frames, in seconds.
+    ///
+    /// @see GetFrameCount(), GetFramesPerSecond()
+    float32_t Animation::GetDuration() const
+    {
+        uint32_t frameCount = m_persistentResourceData.m_frameCount;
+        float32_t framesPerSecond = m_persistentResourceData.m_framesPerSecond;
+
+        return ( frameCount > 1 && framesPerSecond > 0.0f
+            ? static_cast< float32_t >( frameCount - 1 ) / framesPerSecond
+            : 0.0f );
+    }
+
+    /// Convert a quantized key component back to its floating-point value.
+    ///
+    /// @param[in] value    Quantized value.
+    /// @param[in] minimum  Minimum value of the component in its track.
+    /// @param[in] range    Range of values of the component in its track.
+    ///
+    /// @return  Component value.
+    ///
+    /// @see QuantizeComponent()
+    float32_t Animation::DequantizeComponent( uint16_t value, float32_t minimum, float32_t range )
+    {
+        return minimum + static_cast< float32_t >( value ) * ( range * ( 1.0f / 65535.0f ) );
+    }
 #endif  // HELIUM_USE_GRANNY_ANIMATION
 }
@@ -0,0 +1,196 @@
+#include "Precompile.h"
+#include "Graphics/AnimationLod.h"
+
+#if !HELIUM_USE_GRANNY_ANIMATION
+
+#include "Platform/Atomic.h"
+
+using namespace Helium;
+
+volatile int32_t AnimationLod::sm_lastUpdatePhase = 0;
+
+/// Constructor.
+///
+/// The defaults sample every frame at or above 160 pixels, every other frame with six levels of bones at or above
+/// 48 pixels, and every fourth frame with three levels of bones below that.
+AnimationLod::Settings::Settings()
+{
+    levels[ LEVEL_FULL ].minScreenSize = 160.0f;
+    levels[ LEVEL_FULL ].updateInterval = 1;
+    levels[ LEVEL_FULL ].maxBoneDepth = Invalid< uint8_t >();
+
+    levels[ LEVEL_REDUCED ].minScreenSize = 48.0f;
+    levels[ LEVEL_REDUCED ].updateInterval = 2;
+    levels[ LEVEL_REDUCED ].maxBoneDepth = 6;
+
+    levels[ LEVEL_FAR ].minScreenSize = 0.0f;
+    levels[ LEVEL_FAR ].updateInterval = 4;
+    levels[ LEVEL_FAR ].maxBoneDepth = 3;
+}
+
+/// Constructor.
+AnimationLod::AnimationLod()
+: m_pSettings( NULL )
+, m_latestPoseIndex( 0 )
+, m_sampledPoseCount( 0 )
+, m_level( LEVEL_FULL )
+, m_framesSinceUpdate( 0 )
+, m_updatePhase( 0 )
+{
+}
+
+/// Set up this instance for a skeleton.
+///
+/// @param[in] pSettings           Level of detail settings (must stay valid as long as this instance uses them), or
+///                                null to use the default settings.
+/// @param[in] boneCount           Number of bones in the skeleton.
+/// @param[in] pParentBoneIndices  Parent index of each bone (invalid index for root bones), or null if all bones are
+///                                root bones.  Parents must come before their children.
+///
+/// @see Reset()
+void AnimationLod::Initialize( const Settings* pSettings, uint8_t boneCount, const uint8_t* pParentBoneIndices )
+{
+    m_pSettings = pSettings;
+
+    m_boneDepths.Resize( boneCount );
+    for( size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex )
+    {
+        uint8_t parentIndex = ( pParentBoneIndices ? pParentBoneIndices[ boneIndex ] : Invalid< uint8_t >() );
+        if( IsValid( parentIndex ) )
+        {
+            HELIUM_ASSERT( parentIndex < boneIndex );
+            m_boneDepths[ boneIndex ] = static_cast< uint8_t >( Min< uint32_t >( m_boneDepths[ parentIndex ] + 1u, 0xfe ) );
+        }
+        else
+        {
+            m_boneDepths[ boneIndex ] = 0;
+        }
+    }
+
+    size_t blockCount = ( boneCount + AnimationPose::BLOCK_BONE_COUNT - 1 ) / AnimationPose::BLOCK_BONE_COUNT;
+    for( size_t historyIndex = 0; historyIndex < HELIUM_ARRAY_COUNT( m_poseHistory ); ++historyIndex )
+    {
+        m_poseHistory[ historyIndex ].Resize( blockCount );
+        m_poseHistoryAnimatedLanes[ historyIndex ].Resize( blockCount );
+    }
+
+    m_updatePhase = static_cast< uint32_t >( AtomicIncrementUnsafe( sm_lastUpdatePhase ) );
+
+    Reset();
+}
+
+/// Discard the sampled pose history, so that the next update samples a new pose and snaps to it.
+///
+/// This should be called whenever playback jumps (such as when switching animations without blending).
+///
+/// @see Initialize()
+void AnimationLod::Reset()
+{
+    m_sampledPoseCount = 0;
+    m_framesSinceUpdate = 0;
+    m_level = LEVEL_FULL;
+}
+
+/// Pick the level of detail for the current frame.
+///
+/// @param[in] screenSize  Projected screen size of the instance, in pixels, or zero if it is not visible.
+///
+/// @return  True if a new pose should be sampled and passed to EndUpdate(), false if the pose should be
+///          interpolated from the pose history (or not updated at all if the instance is frozen).
+///
+/// @see EndUpdate(), IsFrozen()
+bool AnimationLod::BeginUpdate( float32_t screenSize )
+{
+    if( screenSize <= 0.0f )
+    {
+        // Frozen instances need a fresh pose when they come back into view, since the pose history is stale.
+        m_level = LEVEL_FROZEN;
+        m_sampledPoseCount = 0;
+
+        return false;
+    }
+
+    const Settings& rSettings = ( m_pSettings ? *m_pSettings : GetDefaultSettings() );
+
+    ELevel level = LEVEL_FULL;
+    while( level + 1 < LEVEL_FROZEN && screenSize < rSettings.levels[ level ].minScreenSize )
+    {
+        level = static_cast< ELevel >( level + 1 );
+    }
+
+    m_level = level;
+    ++m_framesSinceUpdate;
+
+    uint32_t updateInterval = Max< uint32_t >( rSettings.levels[ level ].updateInterval, 1 );
+
+    return ( m_sampledPoseCount == 0 || m_framesSinceUpdate >= updateInterval );
+}
+
+/// Update the pose history and fill in the pose to display this frame.
+///
+/// @param[in,out] rPose     Newly sampled pose if bSampled is true.  Set to the pose to display on return.
+/// @param[in]     bSampled  True if a new pose was sampled this frame (as requested by BeginUpdate()).
+///
+/// @see BeginUpdate()
+void AnimationLod::EndUpdate( AnimationPose& rPose, bool bSampled )
+{
+    HELIUM_ASSERT( !IsFrozen() );
+    HELIUM_ASSERT( bSampled || m_sampledPoseCount != 0 );
+
+    size_t blockCount = m_poseHistory[ 0 ].GetSize();
+    HELIUM_ASSERT( rPose.GetBoneCount() <= blockCount * AnimationPose::BLOCK_BONE_COUNT );
+
+    const Settings& rSettings = ( m_pSettings ? *m_pSettings : GetDefaultSettings() );
+    uint32_t updateInterval = Max< uint32_t >( rSettings.levels[ m_level ].updateInterval, 1 );
+
+    if( bSampled )
+    {
+        m_latestPoseIndex ^= 1;
+        rPose.Store( m_poseHistory[ m_latestPoseIndex ].GetData(), m_poseHistoryAnimatedLanes[ m_latestPoseIndex ].GetData() );
+
+        // Start the first interval after a reset part of the way through, so that the update frames of instances
+        // that were reset together end up staggered.
+        m_framesSinceUpdate = ( m_sampledPoseCount == 0 ? m_updatePhase % updateInterval : 0 );
+        if( m_sampledPoseCount < 2 )
+        {
+            ++m_sampledPoseCount;
+        }
+    }
+
+    // Full rate instances (and instances that only have a single pose so far) show the latest pose as is.
+    if( updateInterval <= 1 || m_sampledPoseCount < 2 )
+    {
+        if( !bSampled )
+        {
+            rPose.Load(
+                m_poseHistory[ m_latestPoseIndex ].GetData(),
+                m_poseHistoryAnimatedLanes[ m_latestPoseIndex ].GetData() );
+        }
+
+        return;
+    }
+
+    float32_t weight = Min(
+        static_cast< float32_t >( m_framesSinceUpdate + 1 ) / static_cast< float32_t >( updateInterval ),
+        1.0f );
+
+    size_t previousPoseIndex = m_latestPoseIndex ^ 1;
+    rPose.LoadInterpolated(
+        m_poseHistory[ previousPoseIndex ].GetData(),
+        m_poseHistoryAnimatedLanes[ previousPoseIndex ].GetData(),
+        m_poseHistory[ m_latestPoseIndex ].GetData(),
+        m_poseHistoryAnimatedLanes[ m_latestPoseIndex ].GetData(),
+        weight );
+}
+
+/// Get the default level of detail settings.
+///
+/// @return  Default settings.
+const AnimationLod::Settings& AnimationLod::GetDefaultSettings()
+{
+    static const Settings defaultSettings;
+
+    return defaultSettings;
+}
+
+#endif  // !HELIUM_USE_GRANNY_ANIMATION
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#include "Graphics/AnimationPose.h"
+
+#if !HELIUM_USE_GRANNY_ANIMATION
+
+namespace Helium
+{
+    /// Animation level of detail and update-rate throttling for a single animated instance.
+    ///
+    /// Each frame, an instance picks a level from the projected screen size of its scene object (see
+    /// GraphicsScene::GetSceneObjectScreenSize()).  Large instances are evaluated every frame with all of their bones,
+    /// smaller ones are only sampled every few frames with their deeper bones held in the reference pose, and
+    /// instances that are not visible in any view are frozen in their last pose.  Update frames of throttled
+    /// instances are staggered so that instances sharing a level do not all update on the same frame.
+    ///
+    /// Between two updates of a throttled instance, its pose is interpolated from the second most recent sampled
+    /// pose to the most recent one.  This keeps lower update rates smooth at the cost of lagging one update behind.
+    class HELIUM_GRAPHICS_API AnimationLod
+    {
+    public:
+        /// Levels of detail.
+        enum ELevel
+        {
+            LEVEL_FIRST   =  0,
+            LEVEL_INVALID = -1,
+
+            /// Sampled every frame with all bones.
+            LEVEL_FULL = LEVEL_FIRST,
+            /// Sampled at a reduced rate.
+            LEVEL_REDUCED,
+            /// Sampled at a low rate with fewer bones.
+            LEVEL_FAR,
+            /// Not sampled or rebuilt (not visible in any view).
+            LEVEL_FROZEN,
+
+            LEVEL_MAX,
+            LEVEL_LAST = LEVEL_MAX - 1
+        };
+
+        /// Settings of a level of detail.
+        struct LevelSettings
+        {
+            /// Smallest projected screen size, in pixels, at which the level is used.
+            float32_t minScreenSize;
+            /// Number of frames between pose samples.
+            uint32_t updateInterval;
+            /// Deepest bone in the hierarchy that is animated (root bones have a depth of zero).
+            uint8_t maxBoneDepth;
+        };
+
+        /// Level of detail settings shared by a set of instances.
+        struct HELIUM_GRAPHICS_API Settings
+        {
+            /// Settings of each level but LEVEL_FROZEN, from largest to smallest screen size.
+            LevelSettings levels[ LEVEL_FROZEN ];
+
+            /// @name Construction/Destruction
+            //@{
+            Settings();
+            //@}
+        };
+
+        /// @name Construction/Destruction
+        //@{
+        AnimationLod();
+        //@}
+
+        /// @name Initialization
+        //@{
+        void Initialize( const Settings* pSettings, uint8_t boneCount, const uint8_t* pParentBoneIndices );
+        void Reset();
+        //@}
+
+        /// @name Updating
+        //@{
+        bool BeginUpdate( float32_t screenSize );
+        void EndUpdate( AnimationPose& rPose, bool bSampled );
+        //@}
+
+        /// @name Data Access
+        //@{
+        inline ELevel GetLevel() const;
+        inline bool IsFrozen() const;
+
+        inline const uint8_t* GetBoneDepths() const;
+        inline uint8_t GetMaxBoneDepth() const;
+        //@}
+
+        /// @name Static Access
+        //@{
+        static const Settings& GetDefaultSettings();
+        //@}
+
+    private:
+        /// Level of detail settings, or null to use the default settings.
+        const Settings* m_pSettings;
+
+        /// Depth of each bone in the hierarchy.
+        DynamicArray< uint8_t > m_boneDepths;
+
+        /// Second most recent and most recent sampled poses.
+        DynamicArray< AnimationPose::Block > m_poseHistory[ 2 ];
+        /// Animated lanes of each block of the sampled poses.
+        DynamicArray< uint8_t > m_poseHistoryAnimatedLanes[ 2 ];
+        /// Index of the most recent sampled pose in m_poseHistory.
+        uint8_t m_latestPoseIndex;
+        /// Number of poses sampled since the last reset (up to two).
+        uint8_t m_sampledPoseCount;
+
+        /// Current level of detail.
+        ELevel m_level;
+        /// Number of frames since the most recent sample.
+        uint32_t m_framesSinceUpdate;
+        /// Offset applied to stagger the update frames of instances.
+        uint32_t m_updatePhase;
+
+        /// Counter used to assign the update phase of each instance.
+        static volatile int32_t sm_lastUpdatePhase;
+    };
+}
+
+#include "Graphics/AnimationLod.inl"
+
+#endif  // !HELIUM_USE_GRANNY_ANIMATION
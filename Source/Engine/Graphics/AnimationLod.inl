@@ -0,0 +1,44 @@
+namespace Helium
+{
+    /// Get the level of detail picked by the most recent update.
+    ///
+    /// @return  Current level of detail.
+    ///
+    /// @see IsFrozen(), BeginUpdate()
+    AnimationLod::ELevel AnimationLod::GetLevel() const
+    {
+        return m_level;
+    }
+
+    /// Get whether this instance is frozen in its last pose.
+    ///
+    /// @return  True if the pose is neither sampled nor rebuilt this frame, false if not.
+    ///
+    /// @see GetLevel(), BeginUpdate()
+    bool AnimationLod::IsFrozen() const
+    {
+        return ( m_level == LEVEL_FROZEN );
+    }
+
+    /// Get the depth of each bone in the skeleton hierarchy.
+    ///
+    /// @return  Array of bone depths, for use with AnimationPose::Sample().
+    ///
+    /// @see GetMaxBoneDepth()
+    const uint8_t* AnimationLod::GetBoneDepths() const
+    {
+        return m_boneDepths.GetData();
+    }
+
+    /// Get the deepest bone animated at the current level of detail.
+    ///
+    /// @return  Maximum animated bone depth, for use with AnimationPose::Sample().
+    ///
+    /// @see GetBoneDepths()
+    uint8_t AnimationLod::GetMaxBoneDepth() const
+    {
+        const Settings& rSettings = ( m_pSettings ? *m_pSettings : GetDefaultSettings() );
+
+        return ( m_level < LEVEL_FROZEN ? rSettings.levels[ m_level ].maxBoneDepth : 0 );
+    }
+}
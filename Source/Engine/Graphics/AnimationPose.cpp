@@ -0,0 +1,559 @@
+#include "Precompile.h"
+#include "Graphics/AnimationPose.h"
+
+#if !HELIUM_USE_GRANNY_ANIMATION
+
+#include "EngineJobs/JobManager.h"
+#include "Graphics/Animation.h"
+#include "Graphics/AnimationLod.h"
+#include "MathSimd/Matrix44Soa.h"
+#include "MathSimd/QuatSoa.h"
+#include "MathSimd/Vector3Soa.h"
+
+using namespace Helium;
+
+/// Set a lane of a block to the identity transform.
+///
+/// @param[in] rBlock  Block to update.
+/// @param[in] lane    Lane index.
+static void SetIdentityLane( AnimationPose::Block& rBlock, size_t lane )
+{
+    rBlock.rotation[ 0 ][ lane ] = 0.0f;
+    rBlock.rotation[ 1 ][ lane ] = 0.0f;
+    rBlock.rotation[ 2 ][ lane ] = 0.0f;
+    rBlock.rotation[ 3 ][ lane ] = 1.0f;
+
+    for( size_t componentIndex = 0; componentIndex < 3; ++componentIndex )
+    {
+        rBlock.translation[ componentIndex ][ lane ] = 0.0f;
+        rBlock.scale[ componentIndex ][ lane ] = 1.0f;
+    }
+}
+
+/// Decode a key of an animation track into a lane of a block.
+///
+/// @param[in] pAnimation  Animation to which the key belongs.
+/// @param[in] trackIndex  Track index.
+/// @param[in] keyIndex    Key index.
+/// @param[in] rBlock      Block to update.
+/// @param[in] lane        Lane index.
+static void DecodeLane(
+    const Animation* pAnimation,
+    size_t trackIndex,
+    size_t keyIndex,
+    AnimationPose::Block& rBlock,
+    size_t lane )
+{
+    float32_t rotation[ 4 ];
+    float32_t translation[ 3 ];
+    float32_t scale[ 3 ];
+    pAnimation->DecodeKey( trackIndex, keyIndex, rotation, translation, scale );
+
+    rBlock.rotation[ 0 ][ lane ] = rotation[ 0 ];
+    rBlock.rotation[ 1 ][ lane ] = rotation[ 1 ];
+    rBlock.rotation[ 2 ][ lane ] = rotation[ 2 ];
+    rBlock.rotation[ 3 ][ lane ] = rotation[ 3 ];
+
+    for( size_t componentIndex = 0; componentIndex < 3; ++componentIndex )
+    {
+        rBlock.translation[ componentIndex ][ lane ] = translation[ componentIndex ];
+        rBlock.scale[ componentIndex ][ lane ] = scale[ componentIndex ];
+    }
+}
+
+/// Evaluate a single entry of an EvaluateBatch() call.
+///
+/// @param[in] pContext  Array of pose evaluations.
+/// @param[in] index     Index of the evaluation to run.
+static void EvaluateBatchItem( void* pContext, size_t index )
+{
+    const AnimationPose::Evaluation* pEvaluations = static_cast< const AnimationPose::Evaluation* >( pContext );
+    HELIUM_ASSERT( pEvaluations );
+
+    AnimationPose::Evaluate( pEvaluations[ index ] );
+}
+
+/// Constructor.
+///
+/// @param[in] boneCount  Number of bones in the pose.
+AnimationPose::AnimationPose( size_t boneCount )
+{
+    SetBoneCount( boneCount );
+}
+
+/// Set the number of bones in this pose.
+///
+/// All bones are reset to the identity transform and flagged as not animated.
+///
+/// @param[in] boneCount  Number of bones in the pose (no more than BONE_COUNT_MAX).
+///
+/// @see GetBoneCount()
+void AnimationPose::SetBoneCount( size_t boneCount )
+{
+    HELIUM_ASSERT( boneCount <= BONE_COUNT_MAX );
+    boneCount = Min( boneCount, BONE_COUNT_MAX );
+
+    m_boneCount = boneCount;
+
+    size_t blockCount = ( boneCount + BLOCK_BONE_COUNT - 1 ) / BLOCK_BONE_COUNT;
+    for( size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex )
+    {
+        for( size_t lane = 0; lane < BLOCK_BONE_COUNT; ++lane )
+        {
+            SetIdentityLane( m_blocks[ blockIndex ], lane );
+        }
+
+        m_animatedLanes[ blockIndex ] = 0;
+    }
+}
+
+/// Sample an animation into this pose.
+///
+/// Bones animated by the animation are flagged as animated, while all other bones are reset to the identity and
+/// will use the reference pose when building bone transforms.  Bones deeper in the hierarchy than a given depth can
+/// be skipped to reduce the cost of sampling skeletons at a low level of detail.
+///
+/// @param[in] pAnimation    Animation to sample.
+/// @param[in] pBoneTracks   Track of the animation animating each bone of this pose (see MapBoneTracks()).
+/// @param[in] time          Playback time, in seconds.
+/// @param[in] bLoop         True to loop playback, false to hold the last frame.
+/// @param[in] pBoneDepths   Depth of each bone in the hierarchy, or null to sample all bones.
+/// @param[in] maxBoneDepth  Deepest bone to sample if pBoneDepths is given (deeper bones keep their reference pose).
+///
+/// @see Blend(), BuildTransforms()
+void AnimationPose::Sample(
+    const Animation* pAnimation,
+    const uint16_t* pBoneTracks,
+    float32_t time,
+    bool bLoop,
+    const uint8_t* pBoneDepths,
+    uint8_t maxBoneDepth )
+{
+    HELIUM_ASSERT( pAnimation );
+    HELIUM_ASSERT( pBoneTracks || m_boneCount == 0 );
+
+    float32_t frame = pAnimation->GetFrame( time, bLoop );
+    size_t trackCount = pAnimation->GetTrackCount();
+
+    Block keys0;
+    Block keys1;
+    HELIUM_SIMD_ALIGN_PRE float32_t weights[ BLOCK_BONE_COUNT ] HELIUM_SIMD_ALIGN_POST;
+
+    size_t blockCount = ( m_boneCount + BLOCK_BONE_COUNT - 1 ) / BLOCK_BONE_COUNT;
+    for( size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex )
+    {
+        // Decode the pair of keys surrounding the frame for each lane, then interpolate all lanes at once.
+        uint8_t animatedLanes = 0;
+        for( size_t lane = 0; lane < BLOCK_BONE_COUNT; ++lane )
+        {
+            size_t boneIndex = blockIndex * BLOCK_BONE_COUNT + lane;
+            size_t trackIndex = ( boneIndex < m_boneCount ? pBoneTracks[ boneIndex ] : Invalid< uint16_t >() );
+            if( trackIndex >= trackCount || ( pBoneDepths && pBoneDepths[ boneIndex ] > maxBoneDepth ) )
+            {
+                SetIdentityLane( keys0, lane );
+                SetIdentityLane( keys1, lane );
+                weights[ lane ] = 0.0f;
+
+                continue;
+            }
+
+            size_t keyIndex0;
+            size_t keyIndex1;
+            weights[ lane ] = pAnimation->FindKeys( trackIndex, frame, keyIndex0, keyIndex1 );
+
+            DecodeLane( pAnimation, trackIndex, keyIndex0, keys0, lane );
+            DecodeLane( pAnimation, trackIndex, keyIndex1, keys1, lane );
+
+            animatedLanes |= static_cast< uint8_t >( 1 << lane );
+        }
+
+        InterpolateBlock( keys0, keys1, weights, m_blocks[ blockIndex ] );
+        m_animatedLanes[ blockIndex ] = animatedLanes;
+    }
+}
+
+/// Blend this pose toward another pose.
+///
+/// Bones animated in both poses are interpolated, bones only animated in the target pose are copied from it, and
+/// bones only animated in this pose are left unchanged.
+///
+/// @param[in] rTarget  Pose toward which to blend (must have the same bone count as this pose).
+/// @param[in] weight   Weight of the target pose, from zero (this pose only) to one (target pose only).
+///
+/// @see Sample(), BuildTransforms()
+void AnimationPose::Blend( const AnimationPose& rTarget, float32_t weight )
+{
+    HELIUM_ASSERT( rTarget.m_boneCount == m_boneCount );
+
+    weight = Clamp( weight, 0.0f, 1.0f );
+    if( weight <= 0.0f )
+    {
+        return;
+    }
+
+    HELIUM_SIMD_ALIGN_PRE float32_t weights[ BLOCK_BONE_COUNT ] HELIUM_SIMD_ALIGN_POST;
+
+    size_t blockCount = ( m_boneCount + BLOCK_BONE_COUNT - 1 ) / BLOCK_BONE_COUNT;
+    for( size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex )
+    {
+        uint8_t animatedLanes = m_animatedLanes[ blockIndex ];
+        uint8_t targetAnimatedLanes = rTarget.m_animatedLanes[ blockIndex ];
+        if( targetAnimatedLanes == 0 )
+        {
+            continue;
+        }
+
+        for( size_t lane = 0; lane < BLOCK_BONE_COUNT; ++lane )
+        {
+            uint8_t laneBit = static_cast< uint8_t >( 1 << lane );
+            weights[ lane ] = ( targetAnimatedLanes & laneBit ? ( animatedLanes & laneBit ? weight : 1.0f ) : 0.0f );
+        }
+
+        InterpolateBlock( m_blocks[ blockIndex ], rTarget.m_blocks[ blockIndex ], weights, m_blocks[ blockIndex ] );
+        m_animatedLanes[ blockIndex ] = animatedLanes | targetAnimatedLanes;
+    }
+}
+
+/// Copy the bone transforms of this pose out to external storage.
+///
+/// @param[out] pBlocks         Bone transform blocks (one for each block of bones in this pose).
+/// @param[out] pAnimatedLanes  Animated lanes of each block.
+///
+/// @see Load(), LoadInterpolated()
+void AnimationPose::Store( Block* pBlocks, uint8_t* pAnimatedLanes ) const
+{
+    size_t blockCount = ( m_boneCount + BLOCK_BONE_COUNT - 1 ) / BLOCK_BONE_COUNT;
+    HELIUM_ASSERT( pBlocks || blockCount == 0 );
+    HELIUM_ASSERT( pAnimatedLanes || blockCount == 0 );
+
+    MemoryCopy( pBlocks, m_blocks, blockCount * sizeof( Block ) );
+    MemoryCopy( pAnimatedLanes, m_animatedLanes, blockCount );
+}
+
+/// Copy bone transforms stored with Store() back into this pose.
+///
+/// @param[in] pBlocks         Bone transform blocks (one for each block of bones in this pose).
+/// @param[in] pAnimatedLanes  Animated lanes of each block.
+///
+/// @see Store(), LoadInterpolated()
+void AnimationPose::Load( const Block* pBlocks, const uint8_t* pAnimatedLanes )
+{
+    size_t blockCount = ( m_boneCount + BLOCK_BONE_COUNT - 1 ) / BLOCK_BONE_COUNT;
+    HELIUM_ASSERT( pBlocks || blockCount == 0 );
+    HELIUM_ASSERT( pAnimatedLanes || blockCount == 0 );
+
+    MemoryCopy( m_blocks, pBlocks, blockCount * sizeof( Block ) );
+    MemoryCopy( m_animatedLanes, pAnimatedLanes, blockCount );
+}
+
+/// Set this pose to an interpolation between two poses stored with Store().
+///
+/// Bones animated in both poses are interpolated and bones only animated in the second pose are copied from it.
+/// Bones not animated in the second pose are flagged as not animated.
+///
+/// @param[in] pBlocks0         Bone transform blocks of the first pose.
+/// @param[in] pAnimatedLanes0  Animated lanes of each block of the first pose.
+/// @param[in] pBlocks1         Bone transform blocks of the second pose.
+/// @param[in] pAnimatedLanes1  Animated lanes of each block of the second pose.
+/// @param[in] weight           Weight of the second pose, from zero to one.
+///
+/// @see Store(), Load()
+void AnimationPose::LoadInterpolated(
+    const Block* pBlocks0,
+    const uint8_t* pAnimatedLanes0,
+    const Block* pBlocks1,
+    const uint8_t* pAnimatedLanes1,
+    float32_t weight )
+{
+    weight = Clamp( weight, 0.0f, 1.0f );
+
+    HELIUM_SIMD_ALIGN_PRE float32_t weights[ BLOCK_BONE_COUNT ] HELIUM_SIMD_ALIGN_POST;
+
+    size_t blockCount = ( m_boneCount + BLOCK_BONE_COUNT - 1 ) / BLOCK_BONE_COUNT;
+    for( size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex )
+    {
+        uint8_t animatedLanes0 = pAnimatedLanes0[ blockIndex ];
+        uint8_t animatedLanes1 = pAnimatedLanes1[ blockIndex ];
+        for( size_t lane = 0; lane < BLOCK_BONE_COUNT; ++lane )
+        {
+            uint8_t laneBit = static_cast< uint8_t >( 1 << lane );
+            weights[ lane ] = ( animatedLanes0 & laneBit ? weight : 1.0f );
+        }
+
+        InterpolateBlock( pBlocks0[ blockIndex ], pBlocks1[ blockIndex ], weights, m_blocks[ blockIndex ] );
+        m_animatedLanes[ blockIndex ] = animatedLanes1;
+    }
+}
+
+/// Build the transform of each bone in this pose.
+///
+/// Parent-relative bone matrices are built four bones at a time, after which each bone is concatenated with its
+/// parent in skeleton order.
+///
+/// @param[in]  pParentBoneIndices  Parent index of each bone (invalid index for root bones), or null if all bones
+///                                 are root bones.  Parents must come before their children.
+/// @param[in]  pReferencePose      Parent-relative reference pose of each bone used for bones that are not
+///                                 animated, or null to use the identity.
+/// @param[in]  rRootTransform      Transform applied to the root bones.
+/// @param[out] pTransforms         Resulting bone transforms (one for each bone).  This can be passed as the bone
+///                                 palette of a skinned GraphicsSceneObject.
+///
+/// @see Sample(), Blend()
+void AnimationPose::BuildTransforms(
+    const uint8_t* pParentBoneIndices,
+    const Simd::Matrix44* pReferencePose,
+    const Simd::Matrix44& rRootTransform,
+    Simd::Matrix44* pTransforms ) const
+{
+    HELIUM_ASSERT( pTransforms || m_boneCount == 0 );
+
+    HELIUM_SIMD_ALIGN_PRE float32_t elements[ 16 ][ BLOCK_BONE_COUNT ] HELIUM_SIMD_ALIGN_POST;
+    Simd::Matrix44 localTransform;
+
+    size_t blockCount = ( m_boneCount + BLOCK_BONE_COUNT - 1 ) / BLOCK_BONE_COUNT;
+    for( size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex )
+    {
+        const Block& rBlock = m_blocks[ blockIndex ];
+
+        Simd::QuatSoa rotation;
+        rotation.Load( rBlock.rotation[ 0 ], rBlock.rotation[ 1 ], rBlock.rotation[ 2 ], rBlock.rotation[ 3 ] );
+
+        Simd::Vector3Soa translation;
+        translation.Load( rBlock.translation[ 0 ], rBlock.translation[ 1 ], rBlock.translation[ 2 ] );
+
+        Simd::Vector3Soa scale;
+        scale.Load( rBlock.scale[ 0 ], rBlock.scale[ 1 ], rBlock.scale[ 2 ] );
+
+        Simd::Matrix44Soa transform;
+        transform.SetRotationTranslationScaling( rotation, translation, scale );
+
+        for( size_t elementIndex = 0; elementIndex < 16; ++elementIndex )
+        {
+            Simd::StoreAligned( elements[ elementIndex ], transform.m_matrix[ elementIndex / 4 ][ elementIndex % 4 ] );
+        }
+
+        uint8_t animatedLanes = m_animatedLanes[ blockIndex ];
+        size_t laneCount = Min( BLOCK_BONE_COUNT, m_boneCount - blockIndex * BLOCK_BONE_COUNT );
+        for( size_t lane = 0; lane < laneCount; ++lane )
+        {
+            size_t boneIndex = blockIndex * BLOCK_BONE_COUNT + lane;
+
+            const Simd::Matrix44* pLocalTransform = &Simd::Matrix44::IDENTITY;
+            if( animatedLanes & ( 1 << lane ) )
+            {
+                for( size_t elementIndex = 0; elementIndex < 16; ++elementIndex )
+                {
+                    localTransform.SetElement( elementIndex, elements[ elementIndex ][ lane ] );
+                }
+
+                pLocalTransform = &localTransform;
+            }
+            else if( pReferencePose )
+            {
+                pLocalTransform = &pReferencePose[ boneIndex ];
+            }
+
+            uint8_t parentIndex = ( pParentBoneIndices ? pParentBoneIndices[ boneIndex ] : Invalid< uint8_t >() );
+            if( IsValid( parentIndex ) )
+            {
+                HELIUM_ASSERT( parentIndex < boneIndex );
+                pTransforms[ boneIndex ].MultiplySet( *pLocalTransform, pTransforms[ parentIndex ] );
+            }
+            else
+            {
+                pTransforms[ boneIndex ].MultiplySet( *pLocalTransform, rRootTransform );
+            }
+        }
+    }
+}
+
+/// Find the track of an animation animating each bone of a skeleton.
+///
+/// Track maps only depend on the skeleton and animation, so they should be built once and reused every time the
+/// animation is sampled.
+///
+/// @param[in]  pAnimation   Animation (can be null, in which case no bones are animated).
+/// @param[in]  pBoneNames   Name of each bone.
+/// @param[in]  boneCount    Number of bones in the skeleton.
+/// @param[out] pBoneTracks  Index of the track animating each bone, or an invalid index for bones the animation
+///                          does not animate.
+void AnimationPose::MapBoneTracks(
+    const Animation* pAnimation,
+    const Name* pBoneNames,
+    size_t boneCount,
+    uint16_t* pBoneTracks )
+{
+    HELIUM_ASSERT( pBoneNames || boneCount == 0 );
+    HELIUM_ASSERT( pBoneTracks || boneCount == 0 );
+
+    for( size_t boneIndex = 0; boneIndex < boneCount; ++boneIndex )
+    {
+        size_t trackIndex = ( pAnimation ? pAnimation->FindTrack( pBoneNames[ boneIndex ] ) : Invalid< size_t >() );
+        pBoneTracks[ boneIndex ] =
+            ( trackIndex < Invalid< uint16_t >() ? static_cast< uint16_t >( trackIndex ) : Invalid< uint16_t >() );
+    }
+}
+
+/// Sample, blend, and build the bone transforms of a single skeleton.
+///
+/// If the evaluation has a level of detail state, the skeleton may instead be interpolated from its previously
+/// sampled poses, or left untouched while it is off-screen (see AnimationLod).
+///
+/// @param[in] rEvaluation  Playback state of the skeleton.
+///
+/// @see EvaluateBatch()
+void AnimationPose::Evaluate( const Evaluation& rEvaluation )
+{
+    // Let the level of detail decide whether to sample a new pose, interpolate the last ones, or leave the bone
+    // transforms as they are.
+    AnimationLod* pLod = rEvaluation.pLod;
+    const uint8_t* pBoneDepths = NULL;
+    uint8_t maxBoneDepth = Invalid< uint8_t >();
+
+    bool bSample = true;
+    if( pLod )
+    {
+        bSample = pLod->BeginUpdate( rEvaluation.screenSize );
+        if( pLod->IsFrozen() )
+        {
+            return;
+        }
+
+        pBoneDepths = pLod->GetBoneDepths();
+        maxBoneDepth = pLod->GetMaxBoneDepth();
+    }
+
+    AnimationPose pose( rEvaluation.boneCount );
+    if( bSample )
+    {
+        if( rEvaluation.pAnimation )
+        {
+            pose.Sample(
+                rEvaluation.pAnimation,
+                rEvaluation.pBoneTracks,
+                rEvaluation.time,
+                rEvaluation.bLoop,
+                pBoneDepths,
+                maxBoneDepth );
+        }
+
+        if( rEvaluation.pBlendAnimation && rEvaluation.blendWeight > 0.0f )
+        {
+            AnimationPose blendPose( rEvaluation.boneCount );
+            blendPose.Sample(
+                rEvaluation.pBlendAnimation,
+                rEvaluation.pBlendBoneTracks,
+                rEvaluation.blendTime,
+                rEvaluation.bLoop,
+                pBoneDepths,
+                maxBoneDepth );
+            pose.Blend( blendPose, rEvaluation.blendWeight );
+        }
+    }
+
+    if( pLod )
+    {
+        pLod->EndUpdate( pose, bSample );
+    }
+
+    pose.BuildTransforms(
+        rEvaluation.pParentBoneIndices,
+        rEvaluation.pReferencePose,
+        ( rEvaluation.pRootTransform ? *rEvaluation.pRootTransform : Simd::Matrix44::IDENTITY ),
+        rEvaluation.pTransforms );
+}
+
+/// Evaluate the poses of a set of skeletons in parallel.
+///
+/// Each evaluation only reads its animations and writes its own bone transforms, so the skeletons are spread over
+/// the job worker threads with JobManager::ParallelFor().  This call returns once every pose has been evaluated.
+///
+/// @param[in] pEvaluations     Playback state of each skeleton.
+/// @param[in] evaluationCount  Number of skeletons to evaluate.
+///
+/// @see Evaluate()
+void AnimationPose::EvaluateBatch( const Evaluation* pEvaluations, size_t evaluationCount )
+{
+    HELIUM_ASSERT( pEvaluations || evaluationCount == 0 );
+
+    JobManager::ParallelFor( EvaluateBatchItem, const_cast< Evaluation* >( pEvaluations ), evaluationCount );
+}
+
+/// Interpolate between the transforms of two blocks with a separate weight for each lane.
+///
+/// Rotations are interpolated with a normalized linear interpolation along the shortest arc.  The result may be
+/// either of the source blocks.
+///
+/// @param[in]  rBlock0       First block.
+/// @param[in]  rBlock1       Second block.
+/// @param[in]  pLaneWeights  Weight of the second block for each lane (SIMD-aligned).
+/// @param[out] rResult       Interpolated block.
+void AnimationPose::InterpolateBlock(
+    const Block& rBlock0,
+    const Block& rBlock1,
+    const float32_t* pLaneWeights,
+    Block& rResult )
+{
+    HELIUM_ASSERT( pLaneWeights );
+
+    Simd::Register weight1 = Simd::LoadAligned( pLaneWeights );
+    Simd::Register one = Simd::SetSplatF32( 1.0f );
+
+    Simd::QuatSoa rotation0;
+    rotation0.Load( rBlock0.rotation[ 0 ], rBlock0.rotation[ 1 ], rBlock0.rotation[ 2 ], rBlock0.rotation[ 3 ] );
+
+    Simd::QuatSoa rotation1;
+    rotation1.Load( rBlock1.rotation[ 0 ], rBlock1.rotation[ 1 ], rBlock1.rotation[ 2 ], rBlock1.rotation[ 3 ] );
+
+    Simd::Vector3Soa translation0;
+    translation0.Load( rBlock0.translation[ 0 ], rBlock0.translation[ 1 ], rBlock0.translation[ 2 ] );
+
+    Simd::Vector3Soa translation1;
+    translation1.Load( rBlock1.translation[ 0 ], rBlock1.translation[ 1 ], rBlock1.translation[ 2 ] );
+
+    Simd::Vector3Soa scale0;
+    scale0.Load( rBlock0.scale[ 0 ], rBlock0.scale[ 1 ], rBlock0.scale[ 2 ] );
+
+    Simd::Vector3Soa scale1;
+    scale1.Load( rBlock1.scale[ 0 ], rBlock1.scale[ 1 ], rBlock1.scale[ 2 ] );
+
+    // Negate the weight of the second rotation in lanes where the two rotations are in opposite hemispheres, so
+    // the interpolation takes the shortest arc.
+    Simd::Register dot = Simd::MultiplyF32( rotation0.m_x, rotation1.m_x );
+    dot = Simd::MultiplyAddF32( rotation0.m_y, rotation1.m_y, dot );
+    dot = Simd::MultiplyAddF32( rotation0.m_z, rotation1.m_z, dot );
+    dot = Simd::MultiplyAddF32( rotation0.m_w, rotation1.m_w, dot );
+
+    Simd::Register weight0 = Simd::SubtractF32( one, weight1 );
+    Simd::Register rotationWeight1 = Simd::Select(
+        weight1,
+        Simd::SubtractF32( Simd::LoadZeros(), weight1 ),
+        Simd::LessF32( dot, Simd::LoadZeros() ) );
+
+    Simd::QuatSoa rotation(
+        Simd::MultiplyAddF32( rotation1.m_x, rotationWeight1, Simd::MultiplyF32( rotation0.m_x, weight0 ) ),
+        Simd::MultiplyAddF32( rotation1.m_y, rotationWeight1, Simd::MultiplyF32( rotation0.m_y, weight0 ) ),
+        Simd::MultiplyAddF32( rotation1.m_z, rotationWeight1, Simd::MultiplyF32( rotation0.m_z, weight0 ) ),
+        Simd::MultiplyAddF32( rotation1.m_w, rotationWeight1, Simd::MultiplyF32( rotation0.m_w, weight0 ) ) );
+    rotation.Normalize();
+
+    Simd::Vector3Soa laneWeights( weight1, weight1, weight1 );
+
+    Simd::Vector3Soa translationDelta;
+    translationDelta.SubtractSet( translation1, translation0 );
+
+    Simd::Vector3Soa translation;
+    translation.MultiplyAddSet( translationDelta, laneWeights, translation0 );
+
+    Simd::Vector3Soa scaleDelta;
+    scaleDelta.SubtractSet( scale1, scale0 );
+
+    Simd::Vector3Soa scale;
+    scale.MultiplyAddSet( scaleDelta, laneWeights, scale0 );
+
+    rotation.Store( rResult.rotation[ 0 ], rResult.rotation[ 1 ], rResult.rotation[ 2 ], rResult.rotation[ 3 ] );
+    translation.Store( rResult.translation[ 0 ], rResult.translation[ 1 ], rResult.translation[ 2 ] );
+    scale.Store( rResult.scale[ 0 ], rResult.scale[ 1 ], rResult.scale[ 2 ] );
+}
+
+#endif  // !HELIUM_USE_GRANNY_ANIMATION
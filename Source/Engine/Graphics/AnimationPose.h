@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#include "GraphicsTypes/GraphicsTypes.h"
+#include "MathSimd/Matrix44.h"
+
+#if !HELIUM_USE_GRANNY_ANIMATION
+
+namespace Helium
+{
+    class Animation;
+    class AnimationLod;
+
+    /// Parent-relative pose of a skeleton, sampled and blended four bones at a time.
+    ///
+    /// Bone transforms are stored in structure-of-arrays blocks so that key interpolation, blending, and building
+    /// bone matrices all run one SIMD lane per bone.  The pose has fixed storage for BONE_COUNT_MAX bones, so it can
+    /// live on the stack of a job without any allocation.  Each bone is flagged as animated once an animation with a
+    /// track for the bone is sampled into it; bones that are not animated use the skeleton reference pose when
+    /// building bone matrices.
+    class HELIUM_GRAPHICS_API AnimationPose
+    {
+    public:
+        /// Number of bones in each block (one per SIMD lane).
+        static const size_t BLOCK_BONE_COUNT = 4;
+        /// Maximum number of bones in a pose.
+        static const size_t BONE_COUNT_MAX = 256;
+        /// Maximum number of blocks in a pose.
+        static const size_t BLOCK_COUNT_MAX = BONE_COUNT_MAX / BLOCK_BONE_COUNT;
+
+        /// Transforms of the bones in a block, indexed by component and then by lane.
+        HELIUM_SIMD_ALIGN_PRE struct Block
+        {
+            /// Rotation quaternion components (x, y, z, w).
+            float32_t rotation[ 4 ][ BLOCK_BONE_COUNT ];
+            /// Translation components.
+            float32_t translation[ 3 ][ BLOCK_BONE_COUNT ];
+            /// Scale components.
+            float32_t scale[ 3 ][ BLOCK_BONE_COUNT ];
+        } HELIUM_SIMD_ALIGN_POST;
+
+        /// Playback state of a single skeleton, evaluated by EvaluateBatch().
+        struct Evaluation
+        {
+            /// Animation to play.
+            const Animation* pAnimation;
+            /// Track of pAnimation animating each bone (see MapBoneTracks()).
+            const uint16_t* pBoneTracks;
+            /// Playback time of pAnimation, in seconds.
+            float32_t time;
+
+            /// Animation to blend toward, or null to only play pAnimation.
+            const Animation* pBlendAnimation;
+            /// Track of pBlendAnimation animating each bone.
+            const uint16_t* pBlendBoneTracks;
+            /// Playback time of pBlendAnimation, in seconds.
+            float32_t blendTime;
+            /// Weight of pBlendAnimation, from zero (pAnimation only) to one (pBlendAnimation only).
+            float32_t blendWeight;
+
+            /// True to loop playback, false to hold the last frame.
+            bool bLoop;
+
+            /// Number of bones in the skeleton.
+            uint8_t boneCount;
+            /// Parent index of each bone (invalid index for root bones).  Parents must come before their children.
+            const uint8_t* pParentBoneIndices;
+            /// Parent-relative reference pose of each bone, used for bones that are not animated (can be null).
+            const Simd::Matrix44* pReferencePose;
+            /// Transform applied to the root bones, or null for the identity.
+            const Simd::Matrix44* pRootTransform;
+
+            /// Level of detail state of the skeleton, or null to always evaluate every bone.
+            AnimationLod* pLod;
+            /// Projected screen size of the skeleton, in pixels, or zero if it is not visible (only used with pLod).
+            float32_t screenSize;
+
+            /// Bone transforms written by the evaluation (boneCount entries, left unchanged while frozen by pLod).
+            Simd::Matrix44* pTransforms;
+        };
+
+        /// @name Construction/Destruction
+        //@{
+        explicit AnimationPose( size_t boneCount = 0 );
+        //@}
+
+        /// @name Data Access
+        //@{
+        void SetBoneCount( size_t boneCount );
+        inline size_t GetBoneCount() const;
+
+        inline Block& GetBlock( size_t blockIndex );
+        inline const Block& GetBlock( size_t blockIndex ) const;
+        inline bool IsBoneAnimated( size_t boneIndex ) const;
+        //@}
+
+        /// @name Pose Building
+        //@{
+        void Sample(
+            const Animation* pAnimation, const uint16_t* pBoneTracks, float32_t time, bool bLoop,
+            const uint8_t* pBoneDepths = NULL, uint8_t maxBoneDepth = Invalid< uint8_t >() );
+        void Blend( const AnimationPose& rTarget, float32_t weight );
+
+        void Store( Block* pBlocks, uint8_t* pAnimatedLanes ) const;
+        void Load( const Block* pBlocks, const uint8_t* pAnimatedLanes );
+        void LoadInterpolated(
+            const Block* pBlocks0, const uint8_t* pAnimatedLanes0, const Block* pBlocks1,
+            const uint8_t* pAnimatedLanes1, float32_t weight );
+
+        void BuildTransforms(
+            const uint8_t* pParentBoneIndices, const Simd::Matrix44* pReferencePose,
+            const Simd::Matrix44& rRootTransform, Simd::Matrix44* pTransforms ) const;
+        //@}
+
+        /// @name Batch Evaluation
+        //@{
+        static void MapBoneTracks(
+            const Animation* pAnimation, const Name* pBoneNames, size_t boneCount, uint16_t* pBoneTracks );
+        static void Evaluate( const Evaluation& rEvaluation );
+        static void EvaluateBatch( const Evaluation* pEvaluations, size_t evaluationCount );
+        //@}
+
+    private:
+        /// Bone transforms.
+        Block m_blocks[ BLOCK_COUNT_MAX ];
+        /// Lanes of each block holding animated bones (one bit per lane).
+        uint8_t m_animatedLanes[ BLOCK_COUNT_MAX ];
+        /// Number of bones in the pose.
+        size_t m_boneCount;
+
+        /// @name Private Utility Functions
+        //@{
+        static void InterpolateBlock(
+            const Block& rBlock0, const Block& rBlock1, const float32_t* pLaneWeights, Block& rResult );
+        //@}
+    };
+}
+
+#include "Graphics/AnimationPose.inl"
+
+#endif  // !HELIUM_USE_GRANNY_ANIMATION
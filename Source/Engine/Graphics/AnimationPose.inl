@@ -0,0 +1,48 @@
+namespace Helium
+{
+    /// Get the number of bones in this pose.
+    ///
+    /// @return  Bone count.
+    ///
+    /// @see SetBoneCount()
+    size_t AnimationPose::GetBoneCount() const
+    {
+        return m_boneCount;
+    }
+
+    /// Get a block of bone transforms.
+    ///
+    /// @param[in] blockIndex  Block index (the bone index divided by BLOCK_BONE_COUNT).
+    ///
+    /// @return  Bone transform block.
+    AnimationPose::Block& AnimationPose::GetBlock( size_t blockIndex )
+    {
+        HELIUM_ASSERT( blockIndex < BLOCK_COUNT_MAX );
+
+        return m_blocks[ blockIndex ];
+    }
+
+    /// Get a block of bone transforms.
+    ///
+    /// @param[in] blockIndex  Block index (the bone index divided by BLOCK_BONE_COUNT).
+    ///
+    /// @return  Bone transform block.
+    const AnimationPose::Block& AnimationPose::GetBlock( size_t blockIndex ) const
+    {
+        HELIUM_ASSERT( blockIndex < BLOCK_COUNT_MAX );
+
+        return m_blocks[ blockIndex ];
+    }
+
+    /// Get whether a bone has been animated by a sampled animation.
+    ///
+    /// @param[in] boneIndex  Bone index.
+    ///
+    /// @return  True if the bone is animated, false if it is in its reference pose.
+    bool AnimationPose::IsBoneAnimated( size_t boneIndex ) const
+    {
+        HELIUM_ASSERT( boneIndex < m_boneCount );
+
+        return ( m_animatedLanes[ boneIndex / BLOCK_BONE_COUNT ] & ( 1 << ( boneIndex % BLOCK_BONE_COUNT ) ) ) != 0;
+    }
+}
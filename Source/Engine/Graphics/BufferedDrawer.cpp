@@ -3,6 +3,7 @@
 
 #include "MathSimd/Matrix44.h"
 #include "Foundation/StringConverter.h"
+#include "Engine/FrameProfiler.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/RendererUtil.h"
 #include "Rendering/RConstantBuffer.h"
@@ -16,16 +17,40 @@
 #include "Graphics/Font.h"
 #include "Graphics/Shader.h"
 
+#include <algorithm>
+
 using namespace Helium;
 
+/// Number of floating-point values stored for each instance in the instance vertex buffer (three rows of the
+/// transposed world transform).
+static const size_t INSTANCE_VERTEX_FLOAT_COUNT = 12;
+/// Size of each instance in the instance vertex buffer, in bytes.
+static const uint32_t INSTANCE_VERTEX_STRIDE =
+	static_cast< uint32_t >( sizeof( float32_t ) * INSTANCE_VERTEX_FLOAT_COUNT );
+
+/// Get the number of elements to allocate for a dynamic draw buffer that must hold at least a given number of elements.
+///
+/// Buffers are only recreated when they run out of room, so leaving headroom over the current high-water mark keeps a
+/// workload that grows a little every frame from recreating its buffers every frame.
+///
+/// @param[in] requiredCount  Number of elements the buffer needs to hold.
+///
+/// @return  Number of elements to allocate.
+static uint_fast32_t GetDynamicBufferCapacity( uint_fast32_t requiredCount )
+{
+	return requiredCount + requiredCount / 2;
+}
+
 /// Constructor.
 BufferedDrawer::BufferedDrawer()
-	: m_instanceVertexConstantTransform( Simd::Matrix44::IDENTITY )
+	: m_textGlyphCacheFrame( 0 )
+	, m_instanceVertexConstantTransform( Simd::Matrix44::IDENTITY )
 	, m_instanceVertexConstantBufferIndex( Invalid< uint32_t >() )
 	, m_instancePixelConstantBlendColor( Color( 0xffffffff ) )
 	, m_instancePixelConstantBufferIndex( Invalid< uint32_t >() )
 	, m_currentResourceSetIndex( 0 )
 	, m_bDrawing( false )
+	, m_activeRecorderCount( 0 )
 {
 	for( size_t resourceSetIndex = 0; resourceSetIndex < HELIUM_ARRAY_COUNT( m_resourceSets ); ++resourceSetIndex )
 	{
@@ -36,12 +61,24 @@ BufferedDrawer::BufferedDrawer()
 		rResourceSet.texturedIndexBufferSize = 0;
 		rResourceSet.screenSpaceTextVertexBufferSize = 0;
 		rResourceSet.projectedTextVertexBufferSize = 0;
+		rResourceSet.instanceVertexBufferSize = 0;
+	}
+
+	for( size_t stateIndex = 0;
+		 stateIndex < HELIUM_ARRAY_COUNT( m_untexturedBufferInstanceOffsets );
+		 ++stateIndex )
+	{
+		m_untexturedBufferInstanceOffsets[ stateIndex ] = 0;
 	}
 }
 
 /// Destructor.
 BufferedDrawer::~BufferedDrawer()
 {
+	for( size_t recorderIndex = 0; recorderIndex < m_recorders.GetSize(); ++recorderIndex )
+	{
+		delete m_recorders[ recorderIndex ];
+	}
 }
 
 /// Initialize this buffered drawing interface.
@@ -98,6 +135,28 @@ bool BufferedDrawer::Initialize()
 			return false;
 		}
 
+		// Allocate the index buffer to use for drawing instances of unindexed primitives.  Instanced rendering
+		// requires indexed draw calls, so this simply maps each index to the vertex of the same offset.  Unindexed
+		// primitives are still drawn one at a time if this fails.
+		DynamicArray< uint16_t > sequentialIndices;
+		sequentialIndices.Reserve( SEQUENTIAL_INDEX_COUNT );
+		for( uint32_t index = 0; index < SEQUENTIAL_INDEX_COUNT; ++index )
+		{
+			sequentialIndices.Push( static_cast< uint16_t >( index ) );
+		}
+
+		m_spSequentialIndexBuffer = pRenderer->CreateIndexBuffer(
+			sizeof( uint16_t ) * SEQUENTIAL_INDEX_COUNT,
+			RENDERER_BUFFER_USAGE_STATIC,
+			RENDERER_INDEX_FORMAT_UINT16,
+			sequentialIndices.GetData() );
+		if( !m_spSequentialIndexBuffer )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"BufferedDrawer::Initialize(): Failed to create index buffer for instanced rendering of unindexed primitives.\n" );
+		}
+
 		// Allocate constant buffers for per-instance vertex and pixel shader constants.
 		for( size_t resourceSetIndex = 0; resourceSetIndex < HELIUM_ARRAY_COUNT( m_resourceSets ); ++resourceSetIndex )
 		{
@@ -167,6 +226,10 @@ void BufferedDrawer::Shutdown()
 		m_untexturedBufferDrawCalls[ stateIndex ].Clear();
 		m_texturedBufferDrawCalls[ stateIndex ].Clear();
 
+		m_untexturedBufferDrawCallOrders[ stateIndex ].Clear();
+		m_untexturedBufferInstanceCounts[ stateIndex ].Clear();
+		m_untexturedBufferInstanceOffsets[ stateIndex ] = 0;
+
 		m_worldTextDrawCalls[ stateIndex ].Clear();
 	}
 
@@ -180,8 +243,21 @@ void BufferedDrawer::Shutdown()
 	m_projectedTextDrawCalls.Clear();
 	m_screenTextGlyphIndices.Clear();
 
+	m_textGlyphCache.Clear();
+	m_evictedTextGlyphKeys.Clear();
+	m_textGlyphCacheFrame = 0;
+
+	for( size_t recorderIndex = 0; recorderIndex < m_recorders.GetSize(); ++recorderIndex )
+	{
+		delete m_recorders[ recorderIndex ];
+	}
+
+	m_recorders.Clear();
+	m_activeRecorderCount = 0;
+
 	m_spQuadVertexBuffer.Release();
 	m_spScreenSpaceTextIndexBuffer.Release();
+	m_spSequentialIndexBuffer.Release();
 
 	for( size_t fenceIndex = 0; fenceIndex < HELIUM_ARRAY_COUNT( m_instanceVertexConstantFences ); ++fenceIndex )
 	{
@@ -207,12 +283,14 @@ void BufferedDrawer::Shutdown()
 		rResourceSet.spTexturedVertexBuffer.Release();
 		rResourceSet.spTexturedIndexBuffer.Release();
 		rResourceSet.spScreenSpaceTextVertexBuffer.Release();
+		rResourceSet.spInstanceVertexBuffer.Release();
 		rResourceSet.untexturedVertexBufferSize = 0;
 		rResourceSet.untexturedIndexBufferSize = 0;
 		rResourceSet.texturedVertexBufferSize = 0;
 		rResourceSet.texturedIndexBufferSize = 0;
 		rResourceSet.screenSpaceTextVertexBufferSize = 0;
 		rResourceSet.projectedTextVertexBufferSize = 0;
+		rResourceSet.instanceVertexBufferSize = 0;
 
 		for( size_t bufferIndex = 0;
 			 bufferIndex < HELIUM_ARRAY_COUNT( rResourceSet.instancePixelConstantBuffers );
@@ -271,29 +349,21 @@ void BufferedDrawer::DrawUntextured(
 		return;
 	}
 
-	uint32_t baseVertexIndex = static_cast< uint32_t >( m_untexturedVertices.GetSize() );
-	m_untexturedVertices.AddArray( pVertices, vertexCount );
-
-	uint32_t startIndex;
-	SetInvalid( startIndex );
-	if( pIndices )
-	{
-		startIndex = static_cast< uint32_t >( m_untexturedIndices.GetSize() );
-		m_untexturedIndices.AddArray(
-			pIndices,
-			RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
-	}
-
-	size_t stateIndex = GetStateIndex( rasterizerState, depthStencilState );
-	UntexturedDrawCall* pDrawCall = m_untexturedDrawCalls[ stateIndex ].New();
-	HELIUM_ASSERT( pDrawCall );
-	pDrawCall->transform = rTransform;
-	pDrawCall->primitiveType = primitiveType;
-	pDrawCall->baseVertexIndex = baseVertexIndex;
-	pDrawCall->vertexCount = vertexCount;
-	pDrawCall->startIndex = startIndex;
-	pDrawCall->primitiveCount = primitiveCount;
-	pDrawCall->blendColor = blendColor;
+	uint32_t baseVertexIndex;
+	SimpleVertex* pAllocatedVertices = AllocateUntexturedVertices( vertexCount, baseVertexIndex );
+	HELIUM_ASSERT( pAllocatedVertices );
+	MemoryCopy( pAllocatedVertices, pVertices, sizeof( SimpleVertex ) * vertexCount );
+
+	DrawAllocatedUntextured(
+		primitiveType,
+		rTransform,
+		baseVertexIndex,
+		vertexCount,
+		pIndices,
+		primitiveCount,
+		blendColor,
+		rasterizerState,
+		depthStencilState );
 }
 
 /// Buffer an untextured primitive draw call.
@@ -408,30 +478,22 @@ void BufferedDrawer::DrawTextured(
 		return;
 	}
 
-	uint32_t baseVertexIndex = static_cast< uint32_t >( m_texturedVertices.GetSize() );
-	m_texturedVertices.AddArray( pVertices, vertexCount );
-
-	uint32_t startIndex;
-	SetInvalid( startIndex );
-	if( pIndices )
-	{
-		startIndex = static_cast< uint32_t >( m_texturedIndices.GetSize() );
-		m_texturedIndices.AddArray(
-			pIndices,
-			RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
-	}
-
-	size_t stateIndex = GetStateIndex( rasterizerState, depthStencilState );
-	TexturedDrawCall* pDrawCall = m_texturedDrawCalls[ stateIndex ].New();
-	HELIUM_ASSERT( pDrawCall );
-	pDrawCall->transform = rTransform;
-	pDrawCall->primitiveType = primitiveType;
-	pDrawCall->baseVertexIndex = baseVertexIndex;
-	pDrawCall->vertexCount = vertexCount;
-	pDrawCall->startIndex = startIndex;
-	pDrawCall->primitiveCount = primitiveCount;
-	pDrawCall->blendColor = blendColor;
-	pDrawCall->spTexture = pTexture;
+	uint32_t baseVertexIndex;
+	SimpleTexturedVertex* pAllocatedVertices = AllocateTexturedVertices( vertexCount, baseVertexIndex );
+	HELIUM_ASSERT( pAllocatedVertices );
+	MemoryCopy( pAllocatedVertices, pVertices, sizeof( SimpleTexturedVertex ) * vertexCount );
+
+	DrawAllocatedTextured(
+		primitiveType,
+		rTransform,
+		baseVertexIndex,
+		vertexCount,
+		pIndices,
+		primitiveCount,
+		pTexture,
+		blendColor,
+		rasterizerState,
+		depthStencilState );
 }
 
 /// Buffer a textured primitive draw call.
@@ -503,6 +565,218 @@ void BufferedDrawer::DrawTextured(
 	pDrawCall->transform = rTransform;
 }
 
+/// Reserve space for untextured vertices in the buffered vertex list, to be filled in by the caller.
+///
+/// This lets callers that generate geometry write it straight into the buffered vertex data instead of building it in a
+/// separate array that DrawUntextured() then copies.  The allocated vertices can be referenced by any number of
+/// DrawAllocatedUntextured() calls.  The returned pointer is only valid until the next untextured vertex allocation or
+/// draw call on this drawer.
+///
+/// @param[in]  vertexCount       Number of vertices to allocate.
+/// @param[out] rBaseVertexIndex  Index of the first allocated vertex, for passing to DrawAllocatedUntextured().
+///
+/// @return  Allocated vertices, or null if draw calls are not being buffered because no renderer is initialized.
+///
+/// @see DrawAllocatedUntextured(), AllocateTexturedVertices()
+SimpleVertex* BufferedDrawer::AllocateUntexturedVertices( uint32_t vertexCount, uint32_t& rBaseVertexIndex )
+{
+	HELIUM_ASSERT( vertexCount );
+
+	// Cannot add draw calls while rendering.
+	HELIUM_ASSERT( !m_bDrawing );
+
+	SetInvalid( rBaseVertexIndex );
+
+	// Don't buffer any drawing information if we have no renderer.
+	if( !Renderer::GetInstance() )
+	{
+		return NULL;
+	}
+
+	size_t baseVertexIndex = m_untexturedVertices.GetSize();
+	m_untexturedVertices.Resize( baseVertexIndex + vertexCount );
+	rBaseVertexIndex = static_cast< uint32_t >( baseVertexIndex );
+
+	return m_untexturedVertices.GetData() + baseVertexIndex;
+}
+
+/// Reserve space for textured vertices in the buffered vertex list, to be filled in by the caller.
+///
+/// This lets callers that generate geometry write it straight into the buffered vertex data instead of building it in a
+/// separate array that DrawTextured() then copies.  The allocated vertices can be referenced by any number of
+/// DrawAllocatedTextured() calls.  The returned pointer is only valid until the next textured vertex allocation or draw
+/// call on this drawer.
+///
+/// @param[in]  vertexCount       Number of vertices to allocate.
+/// @param[out] rBaseVertexIndex  Index of the first allocated vertex, for passing to DrawAllocatedTextured().
+///
+/// @return  Allocated vertices, or null if draw calls are not being buffered because no renderer is initialized.
+///
+/// @see DrawAllocatedTextured(), AllocateUntexturedVertices()
+SimpleTexturedVertex* BufferedDrawer::AllocateTexturedVertices( uint32_t vertexCount, uint32_t& rBaseVertexIndex )
+{
+	HELIUM_ASSERT( vertexCount );
+
+	// Cannot add draw calls while rendering.
+	HELIUM_ASSERT( !m_bDrawing );
+
+	SetInvalid( rBaseVertexIndex );
+
+	// Don't buffer any drawing information if we have no renderer.
+	if( !Renderer::GetInstance() )
+	{
+		return NULL;
+	}
+
+	size_t baseVertexIndex = m_texturedVertices.GetSize();
+	m_texturedVertices.Resize( baseVertexIndex + vertexCount );
+	rBaseVertexIndex = static_cast< uint32_t >( baseVertexIndex );
+
+	return m_texturedVertices.GetData() + baseVertexIndex;
+}
+
+/// Buffer an untextured primitive draw call using vertices from AllocateUntexturedVertices().
+///
+/// @param[in] primitiveType      Type of primitive to draw.
+/// @param[in] rTransform         World transform to apply when rendering.
+/// @param[in] baseVertexIndex    Index of the first allocated vertex to use for drawing.  Index values will be relative
+///                               to this vertex.
+/// @param[in] vertexCount        Number of vertices used for drawing.
+/// @param[in] pIndices           Indices to use for drawing.  If this is null, unindexed rendering will be performed.
+/// @param[in] primitiveCount     Number of primitives to draw.
+/// @param[in] blendColor         Color with which to blend each vertex color.
+/// @param[in] rasterizerState    Rasterizer state to use during rendering.
+/// @param[in] depthStencilState  Depth-stencil state to use during rendering.
+///
+/// @see AllocateUntexturedVertices(), DrawUntextured()
+void BufferedDrawer::DrawAllocatedUntextured(
+	ERendererPrimitiveType primitiveType,
+	const Simd::Matrix44& rTransform,
+	uint32_t baseVertexIndex,
+	uint32_t vertexCount,
+	const uint16_t* pIndices,
+	uint32_t primitiveCount,
+	Color blendColor,
+	RenderResourceManager::ERasterizerState rasterizerState,
+	RenderResourceManager::EDepthStencilState depthStencilState )
+{
+	HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
+	HELIUM_ASSERT( vertexCount );
+	HELIUM_ASSERT( pIndices || vertexCount == RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
+	HELIUM_ASSERT( primitiveCount );
+	HELIUM_ASSERT(
+		static_cast< size_t >( rasterizerState ) <
+		static_cast< size_t >( RenderResourceManager::RASTERIZER_STATE_MAX ) );
+	HELIUM_ASSERT(
+		static_cast< size_t >( depthStencilState ) <
+		static_cast< size_t >( RenderResourceManager::DEPTH_STENCIL_STATE_MAX ) );
+
+	// Cannot add draw calls while rendering.
+	HELIUM_ASSERT( !m_bDrawing );
+
+	// Don't buffer any drawing information if we have no renderer.
+	if( !Renderer::GetInstance() )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( static_cast< size_t >( baseVertexIndex ) + vertexCount <= m_untexturedVertices.GetSize() );
+
+	uint32_t startIndex;
+	SetInvalid( startIndex );
+	if( pIndices )
+	{
+		startIndex = static_cast< uint32_t >( m_untexturedIndices.GetSize() );
+		m_untexturedIndices.AddArray(
+			pIndices,
+			RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
+	}
+
+	size_t stateIndex = GetStateIndex( rasterizerState, depthStencilState );
+	UntexturedDrawCall* pDrawCall = m_untexturedDrawCalls[ stateIndex ].New();
+	HELIUM_ASSERT( pDrawCall );
+	pDrawCall->transform = rTransform;
+	pDrawCall->primitiveType = primitiveType;
+	pDrawCall->baseVertexIndex = baseVertexIndex;
+	pDrawCall->vertexCount = vertexCount;
+	pDrawCall->startIndex = startIndex;
+	pDrawCall->primitiveCount = primitiveCount;
+	pDrawCall->blendColor = blendColor;
+}
+
+/// Buffer a textured primitive draw call using vertices from AllocateTexturedVertices().
+///
+/// @param[in] primitiveType      Type of primitive to draw.
+/// @param[in] rTransform         World transform to apply when rendering.
+/// @param[in] baseVertexIndex    Index of the first allocated vertex to use for drawing.  Index values will be relative
+///                               to this vertex.
+/// @param[in] vertexCount        Number of vertices used for drawing.
+/// @param[in] pIndices           Indices to use for drawing.  If this is null, unindexed rendering will be performed.
+/// @param[in] primitiveCount     Number of primitives to draw.
+/// @param[in] pTexture           Texture to apply to the mesh.
+/// @param[in] blendColor         Color with which to blend each vertex color.
+/// @param[in] rasterizerState    Rasterizer state to use during rendering.
+/// @param[in] depthStencilState  Depth-stencil state to use during rendering.
+///
+/// @see AllocateTexturedVertices(), DrawTextured()
+void BufferedDrawer::DrawAllocatedTextured(
+	ERendererPrimitiveType primitiveType,
+	const Simd::Matrix44& rTransform,
+	uint32_t baseVertexIndex,
+	uint32_t vertexCount,
+	const uint16_t* pIndices,
+	uint32_t primitiveCount,
+	RTexture2d* pTexture,
+	Color blendColor,
+	RenderResourceManager::ERasterizerState rasterizerState,
+	RenderResourceManager::EDepthStencilState depthStencilState )
+{
+	HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
+	HELIUM_ASSERT( vertexCount );
+	HELIUM_ASSERT( pIndices || vertexCount == RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
+	HELIUM_ASSERT( primitiveCount );
+	HELIUM_ASSERT( pTexture );
+	HELIUM_ASSERT(
+		static_cast< size_t >( rasterizerState ) <
+		static_cast< size_t >( RenderResourceManager::RASTERIZER_STATE_MAX ) );
+	HELIUM_ASSERT(
+		static_cast< size_t >( depthStencilState ) <
+		static_cast< size_t >( RenderResourceManager::DEPTH_STENCIL_STATE_MAX ) );
+
+	// Cannot add draw calls while rendering.
+	HELIUM_ASSERT( !m_bDrawing );
+
+	// Don't buffer any drawing information if we have no renderer.
+	if( !Renderer::GetInstance() )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( static_cast< size_t >( baseVertexIndex ) + vertexCount <= m_texturedVertices.GetSize() );
+
+	uint32_t startIndex;
+	SetInvalid( startIndex );
+	if( pIndices )
+	{
+		startIndex = static_cast< uint32_t >( m_texturedIndices.GetSize() );
+		m_texturedIndices.AddArray(
+			pIndices,
+			RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
+	}
+
+	size_t stateIndex = GetStateIndex( rasterizerState, depthStencilState );
+	TexturedDrawCall* pDrawCall = m_texturedDrawCalls[ stateIndex ].New();
+	HELIUM_ASSERT( pDrawCall );
+	pDrawCall->transform = rTransform;
+	pDrawCall->primitiveType = primitiveType;
+	pDrawCall->baseVertexIndex = baseVertexIndex;
+	pDrawCall->vertexCount = vertexCount;
+	pDrawCall->startIndex = startIndex;
+	pDrawCall->primitiveCount = primitiveCount;
+	pDrawCall->blendColor = blendColor;
+	pDrawCall->spTexture = pTexture;
+}
+
 /// Buffer a point list draw call using points larger than a pixel.
 ///
 /// @param[in] pVertices          Vertices to use for drawing.
@@ -682,8 +956,23 @@ void BufferedDrawer::DrawScreenText(
 	}
 
 	// Store the information needed for drawing the text later.
-	ScreenSpaceTextGlyphHandler glyphHandler( this, pFont, x, y, color, size );
-	pFont->ProcessText( rText, glyphHandler );
+	const CachedTextGlyphs* pGlyphs = GetTextGlyphs( pFont, rText );
+	HELIUM_ASSERT( pGlyphs );
+	uint32_t glyphCount = static_cast< uint32_t >( pGlyphs->glyphIndices.GetSize() );
+	if( glyphCount == 0 )
+	{
+		return;
+	}
+
+	m_screenTextGlyphIndices.AddArray( pGlyphs->glyphIndices.GetData(), glyphCount );
+
+	ScreenTextDrawCall* pDrawCall = m_screenTextDrawCalls.New();
+	HELIUM_ASSERT( pDrawCall );
+	pDrawCall->x = x;
+	pDrawCall->y = y;
+	pDrawCall->color = color;
+	pDrawCall->size = size;
+	pDrawCall->glyphCount = glyphCount;
 }
 
 /// Draw text in screen space based off a world-space origin point.
@@ -727,11 +1016,29 @@ void BufferedDrawer::DrawProjectedText(
 	}
 
 	// Store the information needed for drawing the text later.
-	ProjectedTextGlyphHandler glyphHandler( this, pFont, rWorldOffset, screenOffsetX, screenOffsetY, color, size );
-	pFont->ProcessText( rText, glyphHandler );
-}
+	const CachedTextGlyphs* pGlyphs = GetTextGlyphs( pFont, rText );
+	HELIUM_ASSERT( pGlyphs );
+	uint32_t glyphCount = static_cast< uint32_t >( pGlyphs->glyphIndices.GetSize() );
+	if( glyphCount == 0 )
+	{
+		return;
+	}
 
-/// Push buffered draw command data into vertex and index buffers for rendering.
+	m_screenTextGlyphIndices.AddArray( pGlyphs->glyphIndices.GetData(), glyphCount );
+
+	ProjectedTextDrawCall* pDrawCall = m_projectedTextDrawCalls.New();
+	HELIUM_ASSERT( pDrawCall );
+	pDrawCall->x = screenOffsetX;
+	pDrawCall->y = screenOffsetY;
+	pDrawCall->color = color;
+	pDrawCall->size = size;
+	pDrawCall->glyphCount = glyphCount;
+	pDrawCall->worldPosition[ 0 ] = rWorldOffset.GetElement( 0 );
+	pDrawCall->worldPosition[ 1 ] = rWorldOffset.GetElement( 1 );
+	pDrawCall->worldPosition[ 2 ] = rWorldOffset.GetElement( 2 );
+}
+
+/// Push buffered draw command data into vertex and index buffers for rendering.
 ///
 /// This must be called prior to calling DrawWorldElements() or DrawScreenElements().  EndDrawing() should be called
 /// when rendering is complete.  No new draw calls can be added between a BeginDrawing() and EndDrawing() call pair.
@@ -739,8 +1046,14 @@ void BufferedDrawer::DrawProjectedText(
 /// @see EndDrawing(), DrawWorldElements(), DrawScreenElements()
 void BufferedDrawer::BeginDrawing()
 {
+	HELIUM_FRAME_PROFILER_SCOPE( "BufferedDrawer::BeginDrawing" );
+
 	// Flag that we have begun drawing.
 	HELIUM_ASSERT( !m_bDrawing );
+
+	// Pull in anything recorded on other threads since the last frame.
+	MergeRecorders();
+
 	m_bDrawing = true;
 
 	// If a renderer is not initialized, we don't need to do anything.
@@ -772,9 +1085,11 @@ void BufferedDrawer::BeginDrawing()
 
 	if( untexturedVertexCount > rResourceSet.untexturedVertexBufferSize )
 	{
+		uint_fast32_t untexturedVertexCapacity = GetDynamicBufferCapacity( untexturedVertexCount );
+
 		rResourceSet.spUntexturedVertexBuffer.Release();
 		rResourceSet.spUntexturedVertexBuffer = pRenderer->CreateVertexBuffer(
-			untexturedVertexCount * sizeof( SimpleVertex ),
+			untexturedVertexCapacity * sizeof( SimpleVertex ),
 			RENDERER_BUFFER_USAGE_DYNAMIC );
 		if( !rResourceSet.spUntexturedVertexBuffer )
 		{
@@ -787,15 +1102,17 @@ void BufferedDrawer::BeginDrawing()
 		}
 		else
 		{
-			rResourceSet.untexturedVertexBufferSize = static_cast< uint32_t >( untexturedVertexCount );
+			rResourceSet.untexturedVertexBufferSize = static_cast< uint32_t >( untexturedVertexCapacity );
 		}
 	}
 
 	if( untexturedIndexCount > rResourceSet.untexturedIndexBufferSize )
 	{
+		uint_fast32_t untexturedIndexCapacity = GetDynamicBufferCapacity( untexturedIndexCount );
+
 		rResourceSet.spUntexturedIndexBuffer.Release();
 		rResourceSet.spUntexturedIndexBuffer = pRenderer->CreateIndexBuffer(
-			untexturedIndexCount * sizeof( uint16_t ),
+			untexturedIndexCapacity * sizeof( uint16_t ),
 			RENDERER_BUFFER_USAGE_DYNAMIC,
 			RENDERER_INDEX_FORMAT_UINT16 );
 		if( !rResourceSet.spUntexturedIndexBuffer )
@@ -809,15 +1126,17 @@ void BufferedDrawer::BeginDrawing()
 		}
 		else
 		{
-			rResourceSet.untexturedIndexBufferSize = static_cast< uint32_t >( untexturedIndexCount );
+			rResourceSet.untexturedIndexBufferSize = static_cast< uint32_t >( untexturedIndexCapacity );
 		}
 	}
 
 	if( texturedVertexCount > rResourceSet.texturedVertexBufferSize )
 	{
+		uint_fast32_t texturedVertexCapacity = GetDynamicBufferCapacity( texturedVertexCount );
+
 		rResourceSet.spTexturedVertexBuffer.Release();
 		rResourceSet.spTexturedVertexBuffer = pRenderer->CreateVertexBuffer(
-			texturedVertexCount * sizeof( SimpleTexturedVertex ),
+			texturedVertexCapacity * sizeof( SimpleTexturedVertex ),
 			RENDERER_BUFFER_USAGE_DYNAMIC );
 		if( !rResourceSet.spTexturedVertexBuffer )
 		{
@@ -830,15 +1149,17 @@ void BufferedDrawer::BeginDrawing()
 		}
 		else
 		{
-			rResourceSet.texturedVertexBufferSize = static_cast< uint32_t >( texturedVertexCount );
+			rResourceSet.texturedVertexBufferSize = static_cast< uint32_t >( texturedVertexCapacity );
 		}
 	}
 
 	if( texturedIndexCount > rResourceSet.texturedIndexBufferSize )
 	{
+		uint_fast32_t texturedIndexCapacity = GetDynamicBufferCapacity( texturedIndexCount );
+
 		rResourceSet.spTexturedIndexBuffer.Release();
 		rResourceSet.spTexturedIndexBuffer = pRenderer->CreateIndexBuffer(
-			texturedIndexCount * sizeof( uint16_t ),
+			texturedIndexCapacity * sizeof( uint16_t ),
 			RENDERER_BUFFER_USAGE_DYNAMIC,
 			RENDERER_INDEX_FORMAT_UINT16 );
 		if( !rResourceSet.spTexturedIndexBuffer )
@@ -852,15 +1173,17 @@ void BufferedDrawer::BeginDrawing()
 		}
 		else
 		{
-			rResourceSet.texturedIndexBufferSize = static_cast< uint32_t >( texturedIndexCount );
+			rResourceSet.texturedIndexBufferSize = static_cast< uint32_t >( texturedIndexCapacity );
 		}
 	}
 
 	if( screenTextVertexCount > rResourceSet.screenSpaceTextVertexBufferSize )
 	{
+		uint_fast32_t screenTextVertexCapacity = GetDynamicBufferCapacity( screenTextVertexCount );
+
 		rResourceSet.spScreenSpaceTextVertexBuffer.Release();
 		rResourceSet.spScreenSpaceTextVertexBuffer = pRenderer->CreateVertexBuffer(
-			screenTextVertexCount * sizeof( ScreenVertex ),
+			screenTextVertexCapacity * sizeof( ScreenVertex ),
 			RENDERER_BUFFER_USAGE_DYNAMIC );
 		if( !rResourceSet.spScreenSpaceTextVertexBuffer )
 		{
@@ -873,15 +1196,17 @@ void BufferedDrawer::BeginDrawing()
 		}
 		else
 		{
-			rResourceSet.screenSpaceTextVertexBufferSize = static_cast< uint32_t >( screenTextVertexCount );
+			rResourceSet.screenSpaceTextVertexBufferSize = static_cast< uint32_t >( screenTextVertexCapacity );
 		}
 	}
 
 	if( projectedTextVertexCount > rResourceSet.projectedTextVertexBufferSize )
 	{
+		uint_fast32_t projectedTextVertexCapacity = GetDynamicBufferCapacity( projectedTextVertexCount );
+
 		rResourceSet.spProjectedTextVertexBuffer.Release();
 		rResourceSet.spProjectedTextVertexBuffer = pRenderer->CreateVertexBuffer(
-			projectedTextVertexCount * sizeof( ProjectedVertex ),
+			projectedTextVertexCapacity * sizeof( ProjectedVertex ),
 			RENDERER_BUFFER_USAGE_DYNAMIC );
 		if( !rResourceSet.spProjectedTextVertexBuffer )
 		{
@@ -894,7 +1219,7 @@ void BufferedDrawer::BeginDrawing()
 		}
 		else
 		{
-			rResourceSet.projectedTextVertexBufferSize = static_cast< uint32_t >( projectedTextVertexCount );
+			rResourceSet.projectedTextVertexBufferSize = static_cast< uint32_t >( projectedTextVertexCapacity );
 		}
 	}
 
@@ -1202,6 +1527,9 @@ void BufferedDrawer::BeginDrawing()
 		rResourceSet.spProjectedTextVertexBuffer->Unmap();
 	}
 
+	// Group untextured draw calls that can be rendered as instances of one another and fill the instance data.
+	PrepareInstancedDrawCalls( rResourceSet );
+
 	// Clear the buffered vertex and index data, as it is no longer needed.
 	m_untexturedVertices.RemoveAll();
 	m_texturedVertices.RemoveAll();
@@ -1249,6 +1577,9 @@ void BufferedDrawer::EndDrawing()
 
 		m_texturedBufferDrawCalls[ stateIndex ].RemoveAll();
 		m_untexturedBufferDrawCalls[ stateIndex ].RemoveAll();
+		m_untexturedBufferDrawCallOrders[ stateIndex ].RemoveAll();
+		m_untexturedBufferInstanceCounts[ stateIndex ].RemoveAll();
+		m_untexturedBufferInstanceOffsets[ stateIndex ] = 0;
 
 		m_texturedDrawCalls[ stateIndex ].RemoveAll();
 		m_untexturedDrawCalls[ stateIndex ].RemoveAll();
@@ -1275,10 +1606,60 @@ void BufferedDrawer::EndDrawing()
 	SetInvalid( m_instanceVertexConstantBufferIndex );
 	SetInvalid( m_instancePixelConstantBufferIndex );
 
+	// Age the cached text glyphs, freeing text that hasn't been drawn in a while.
+	++m_textGlyphCacheFrame;
+	if( m_textGlyphCacheFrame % TEXT_GLYPH_CACHE_IDLE_FRAME_MAX == 0 )
+	{
+		EvictIdleTextGlyphs();
+	}
+
 	// Swap rendering resources for the next set of buffered draw calls.
 	m_currentResourceSetIndex = ( m_currentResourceSetIndex + 1 ) % HELIUM_ARRAY_COUNT( m_resourceSets );
 }
 
+/// Get a recorder for buffering draw calls from the calling thread.
+///
+/// The recorder is only valid until the next BeginDrawing() call, when its draw calls are merged into this drawer, and
+/// should only be used by one thread at a time.  Only handing out the recorder takes a lock, so a job can acquire one
+/// recorder up front and record any number of draw calls into it without contending with other threads.
+///
+/// @return  Recorder to use.
+///
+/// @see BeginDrawing()
+BufferedDrawer::Recorder* BufferedDrawer::AcquireRecorder()
+{
+	MutexScopeLock scopeLock( m_recorderLock );
+
+	HELIUM_ASSERT( !m_bDrawing );
+
+	if( m_activeRecorderCount == m_recorders.GetSize() )
+	{
+		Recorder* pRecorder = new Recorder;
+		HELIUM_ASSERT( pRecorder );
+		m_recorders.Push( pRecorder );
+	}
+
+	return m_recorders[ m_activeRecorderCount++ ];
+}
+
+/// Merge the draw calls of every recorder handed out since the last BeginDrawing() call into the main draw call
+/// lists, in the order in which the recorders were acquired.
+///
+/// @see AcquireRecorder()
+void BufferedDrawer::MergeRecorders()
+{
+	MutexScopeLock scopeLock( m_recorderLock );
+
+	for( size_t recorderIndex = 0; recorderIndex < m_activeRecorderCount; ++recorderIndex )
+	{
+		Recorder* pRecorder = m_recorders[ recorderIndex ];
+		HELIUM_ASSERT( pRecorder );
+		pRecorder->MergeInto( *this );
+	}
+
+	m_activeRecorderCount = 0;
+}
+
 /// Issue draw commands for buffered development-mode draw calls in world space.
 ///
 /// BeginDrawing() must be called before issuing calls to this function.  This function can be called multiple times
@@ -1293,6 +1674,8 @@ void BufferedDrawer::EndDrawing()
 /// @see BeginDrawing(), EndDrawing(), DrawScreenElements()
 void BufferedDrawer::DrawWorldElements( const Simd::Matrix44& rInverseViewProjection )
 {
+	HELIUM_FRAME_PROFILER_SCOPE( "BufferedDrawer::DrawWorldElements" );
+
 	HELIUM_ASSERT( m_bDrawing );
 
 	// If a renderer is not initialized, we don't need to do anything.
@@ -1370,6 +1753,33 @@ void BufferedDrawer::DrawWorldElements( const Simd::Matrix44& rInverseViewProjec
 	HELIUM_ASSERT( !pShaderResource || pShaderResource->GetType() == RShader::TYPE_VERTEX );
 	worldResources.spUntexturedPointsVertexShader = static_cast< RVertexShader* >( pShaderResource );
 
+	// Shaders without the instancing select resolve to the same option set as the non-instanced variant, in which case
+	// instanced rendering is not used.
+	static const Shader::SelectPair untexturedInstancedSelectOptions[] =
+	{
+		Shader::SelectPair( Name( "TEXTURING" ), Name( "NONE" ) ),
+		Shader::SelectPair( Name( "INSTANCING" ), Name( "INSTANCING_TRANSFORM" ) ),
+	};
+
+	size_t untexturedOptionSetIndex = rSystemOptions.GetOptionSetIndex(
+		RShader::TYPE_VERTEX,
+		NULL,
+		0,
+		untexturedSelectOptions,
+		HELIUM_ARRAY_COUNT( untexturedSelectOptions ) );
+	optionSetIndex = rSystemOptions.GetOptionSetIndex(
+		RShader::TYPE_VERTEX,
+		NULL,
+		0,
+		untexturedInstancedSelectOptions,
+		HELIUM_ARRAY_COUNT( untexturedInstancedSelectOptions ) );
+	if( optionSetIndex != untexturedOptionSetIndex )
+	{
+		pShaderResource = pVertexShaderVariant->GetRenderResource( optionSetIndex );
+		HELIUM_ASSERT( !pShaderResource || pShaderResource->GetType() == RShader::TYPE_VERTEX );
+		worldResources.spUntexturedInstancedVertexShader = static_cast< RVertexShader* >( pShaderResource );
+	}
+
 	static const Shader::SelectPair textureBlendSelectOptions[] =
 	{
 		Shader::SelectPair( Name( "TEXTURING" ), Name( "TEXTURING_BLEND" ) ),
@@ -1424,6 +1834,9 @@ void BufferedDrawer::DrawWorldElements( const Simd::Matrix44& rInverseViewProjec
 	worldResources.spSimpleVertexDescription = pRenderResourceManager->GetSimpleVertexDescription();
 	HELIUM_ASSERT( worldResources.spSimpleVertexDescription );
 
+	worldResources.spInstancedSimpleVertexDescription =
+		pRenderResourceManager->GetInstancedSimpleVertexDescription();
+
 	worldResources.spSimpleTexturedVertexDescription = pRenderResourceManager->GetSimpleTexturedVertexDescription();
 	HELIUM_ASSERT( worldResources.spSimpleTexturedVertexDescription );
 
@@ -1468,6 +1881,8 @@ void BufferedDrawer::DrawWorldElements( const Simd::Matrix44& rInverseViewProjec
 /// @see BeginDrawing(), EndDrawing(), DrawWorldElements()
 void BufferedDrawer::DrawScreenElements()
 {
+	HELIUM_FRAME_PROFILER_SCOPE( "BufferedDrawer::DrawScreenElements" );
+
 	HELIUM_ASSERT( m_bDrawing );
 
 	// If a renderer is not initialized, we don't need to do anything.
@@ -1921,7 +2336,6 @@ void BufferedDrawer::DrawDepthStencilStateWorldElements(
 				pStateCache->SetBlendState( pBlendStateTransparent );
 				pStateCache->SetDepthStencilState( pDepthStencilState, 0 );
 
-				pStateCache->SetVertexShader( rWorldResources.spUntexturedVertexShader );
 				pStateCache->SetPixelShader( rWorldResources.spUntexturedPixelShader );
 
 				rWorldResources.spUntexturedVertexShader->CacheDescription(
@@ -1930,13 +2344,95 @@ void BufferedDrawer::DrawDepthStencilStateWorldElements(
 				RVertexInputLayout* pVertexInputLayout =
 					rWorldResources.spUntexturedVertexShader->GetCachedInputLayout();
 				HELIUM_ASSERT( pVertexInputLayout );
-				pStateCache->SetVertexInputLayout( pVertexInputLayout );
+
+				// Runs of draw calls sharing the same geometry are drawn with a single instanced draw call, taking
+				// their transforms from the instance vertex buffer.
+				RVertexShader* pInstancedVertexShader = rWorldResources.spUntexturedInstancedVertexShader;
+				RVertexInputLayout* pInstancedVertexInputLayout = NULL;
+				if( pInstancedVertexShader &&
+					rWorldResources.spInstancedSimpleVertexDescription &&
+					rResourceSet.spInstanceVertexBuffer )
+				{
+					pInstancedVertexShader->CacheDescription(
+						pRenderer,
+						rWorldResources.spInstancedSimpleVertexDescription );
+					pInstancedVertexInputLayout = pInstancedVertexShader->GetCachedInputLayout();
+				}
 
 				pStateCache->SetTexture( NULL );
 
-				for( size_t drawCallIndex = 0; drawCallIndex < untexturedBufferDrawCallCount; ++drawCallIndex )
+				const DynamicArray< uint32_t >& rDrawCallOrder = m_untexturedBufferDrawCallOrders[ stateIndex ];
+				const DynamicArray< uint32_t >& rInstanceCounts = m_untexturedBufferInstanceCounts[ stateIndex ];
+				HELIUM_ASSERT( rDrawCallOrder.GetSize() == untexturedBufferDrawCallCount );
+				HELIUM_ASSERT( rInstanceCounts.GetSize() == untexturedBufferDrawCallCount );
+
+				uint32_t instanceOffset = m_untexturedBufferInstanceOffsets[ stateIndex ];
+
+				for( size_t orderIndex = 0; orderIndex < untexturedBufferDrawCallCount; ++orderIndex )
 				{
-					const UntexturedBufferDrawCall& rDrawCall = rUntexturedBufferDrawCalls[ drawCallIndex ];
+					const UntexturedBufferDrawCall& rDrawCall = rUntexturedBufferDrawCalls[ rDrawCallOrder[ orderIndex ] ];
+
+					uint32_t instanceCount = rInstanceCounts[ orderIndex ];
+					if( instanceCount > 1 )
+					{
+						uint32_t runInstanceOffset = instanceOffset;
+						instanceOffset += instanceCount;
+
+						if( pInstancedVertexInputLayout )
+						{
+							pStateCache->SetVertexShader( pInstancedVertexShader );
+							pStateCache->SetVertexInputLayout( pInstancedVertexInputLayout );
+							pStateCache->SetInstancedVertexBuffers(
+								rDrawCall.spVertexBuffer,
+								static_cast< uint32_t >( sizeof( SimpleVertex ) ),
+								rResourceSet.spInstanceVertexBuffer,
+								INSTANCE_VERTEX_STRIDE,
+								runInstanceOffset );
+
+							RConstantBuffer* pConstantBuffer = SetInstanceVertexConstantData(
+								pCommandProxy,
+								rResourceSet,
+								rInverseViewProjection,
+								Simd::Matrix44::IDENTITY );
+							HELIUM_ASSERT( pConstantBuffer );
+							pStateCache->SetVertexConstantBuffer( pConstantBuffer );
+
+							RConstantBuffer* pPixelConstantBuffer = SetInstancePixelConstantData(
+								pCommandProxy,
+								rResourceSet,
+								rDrawCall.blendColor );
+							HELIUM_ASSERT( pPixelConstantBuffer );
+							pStateCache->SetPixelConstantBuffer( pPixelConstantBuffer );
+
+							// Unindexed primitives are drawn using the sequential index buffer.
+							RIndexBuffer* pIndexBuffer = rDrawCall.spIndexBuffer;
+							uint32_t startIndex = rDrawCall.startIndex;
+							if( !pIndexBuffer )
+							{
+								pIndexBuffer = m_spSequentialIndexBuffer;
+								startIndex = 0;
+							}
+
+							HELIUM_ASSERT( pIndexBuffer );
+							pStateCache->SetIndexBuffer( pIndexBuffer );
+							pCommandProxy->DrawIndexedInstanced(
+								rDrawCall.primitiveType,
+								rDrawCall.baseVertexIndex,
+								0,
+								rDrawCall.vertexCount,
+								startIndex,
+								rDrawCall.primitiveCount,
+								instanceCount );
+
+							// Skip the remaining draw calls rendered as part of this run.
+							orderIndex += instanceCount - 1;
+
+							continue;
+						}
+					}
+
+					pStateCache->SetVertexShader( rWorldResources.spUntexturedVertexShader );
+					pStateCache->SetVertexInputLayout( pVertexInputLayout );
 
 					pStateCache->SetVertexBuffer(
 						rDrawCall.spVertexBuffer,
@@ -2304,6 +2800,174 @@ RConstantBuffer* BufferedDrawer::SetInstancePixelConstantData(
 	return rResourceSet.instancePixelConstantBuffers[ bufferIndex ];
 }
 
+/// Sort the untextured draw calls using external vertex/index buffers so that draw calls sharing the same geometry are
+/// next to each other, find the runs of draw calls that can be rendered as instances of a single draw call, and fill
+/// the instance vertex buffer with their transforms.
+///
+/// Only opaque draw calls using full depth testing and writing are reordered, as their result does not depend on the
+/// order in which they are drawn.  Translucent draw calls and draw calls using other depth-stencil states keep their
+/// order, and only consecutive matching draw calls among them are combined.
+///
+/// @param[in] rResourceSet  Active resource set data for the current frame.
+///
+/// @see CanInstanceDrawCalls()
+void BufferedDrawer::PrepareInstancedDrawCalls( ResourceSet& rResourceSet )
+{
+	uint32_t totalInstanceCount = 0;
+
+	for( size_t stateIndex = 0; stateIndex < HELIUM_ARRAY_COUNT( m_untexturedBufferDrawCalls ); ++stateIndex )
+	{
+		const DynamicArray< UntexturedBufferDrawCall >& rDrawCalls = m_untexturedBufferDrawCalls[ stateIndex ];
+		DynamicArray< uint32_t >& rOrder = m_untexturedBufferDrawCallOrders[ stateIndex ];
+		DynamicArray< uint32_t >& rInstanceCounts = m_untexturedBufferInstanceCounts[ stateIndex ];
+
+		m_untexturedBufferInstanceOffsets[ stateIndex ] = totalInstanceCount;
+
+		uint32_t drawCallCount = static_cast< uint32_t >( rDrawCalls.GetSize() );
+		rOrder.Resize( 0 );
+		rOrder.Reserve( drawCallCount );
+		for( uint32_t drawCallIndex = 0; drawCallIndex < drawCallCount; ++drawCallIndex )
+		{
+			rOrder.Push( drawCallIndex );
+		}
+
+		rInstanceCounts.Resize( 0 );
+		rInstanceCounts.Add( 0, drawCallCount );
+
+		if( drawCallCount < 2 )
+		{
+			continue;
+		}
+
+		RenderResourceManager::ERasterizerState rasterizerState;
+		RenderResourceManager::EDepthStencilState depthStencilState;
+		GetStatesFromIndex( stateIndex, rasterizerState, depthStencilState );
+		if( depthStencilState == RenderResourceManager::DEPTH_STENCIL_STATE_DEFAULT )
+		{
+			std::stable_sort(
+				rOrder.GetData(),
+				rOrder.GetData() + drawCallCount,
+				UntexturedBufferDrawCallCompare( rDrawCalls ) );
+		}
+
+		uint32_t runStart = 0;
+		while( runStart < drawCallCount )
+		{
+			const UntexturedBufferDrawCall& rRunDrawCall = rDrawCalls[ rOrder[ runStart ] ];
+
+			uint32_t runEnd = runStart + 1;
+			if( rRunDrawCall.spIndexBuffer ||
+				( m_spSequentialIndexBuffer &&
+				  RendererUtil::PrimitiveCountToIndexCount( rRunDrawCall.primitiveType, rRunDrawCall.primitiveCount ) <=
+				  SEQUENTIAL_INDEX_COUNT ) )
+			{
+				while( runEnd < drawCallCount && CanInstanceDrawCalls( rRunDrawCall, rDrawCalls[ rOrder[ runEnd ] ] ) )
+				{
+					++runEnd;
+				}
+			}
+
+			uint32_t runLength = runEnd - runStart;
+			if( runLength > 1 )
+			{
+				rInstanceCounts[ runStart ] = runLength;
+				totalInstanceCount += runLength;
+			}
+
+			runStart = runEnd;
+		}
+	}
+
+	if( totalInstanceCount == 0 )
+	{
+		return;
+	}
+
+	if( totalInstanceCount > rResourceSet.instanceVertexBufferSize )
+	{
+		Renderer* pRenderer = Renderer::GetInstance();
+		HELIUM_ASSERT( pRenderer );
+
+		rResourceSet.spInstanceVertexBuffer.Release();
+		rResourceSet.spInstanceVertexBuffer = pRenderer->CreateVertexBuffer(
+			totalInstanceCount * INSTANCE_VERTEX_STRIDE,
+			RENDERER_BUFFER_USAGE_DYNAMIC );
+		if( !rResourceSet.spInstanceVertexBuffer )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"Failed to create vertex buffer for instanced drawing of %" PRIu32 " instances.\n",
+				totalInstanceCount );
+
+			rResourceSet.instanceVertexBufferSize = 0;
+
+			return;
+		}
+
+		rResourceSet.instanceVertexBufferSize = totalInstanceCount;
+	}
+
+	float32_t* pInstanceData = static_cast< float32_t* >( rResourceSet.spInstanceVertexBuffer->Map(
+		RENDERER_BUFFER_MAP_HINT_DISCARD ) );
+	HELIUM_ASSERT( pInstanceData );
+
+	for( size_t stateIndex = 0; stateIndex < HELIUM_ARRAY_COUNT( m_untexturedBufferDrawCalls ); ++stateIndex )
+	{
+		const DynamicArray< UntexturedBufferDrawCall >& rDrawCalls = m_untexturedBufferDrawCalls[ stateIndex ];
+		const DynamicArray< uint32_t >& rOrder = m_untexturedBufferDrawCallOrders[ stateIndex ];
+		const DynamicArray< uint32_t >& rInstanceCounts = m_untexturedBufferInstanceCounts[ stateIndex ];
+
+		size_t drawCallCount = rOrder.GetSize();
+		for( size_t orderIndex = 0; orderIndex < drawCallCount; ++orderIndex )
+		{
+			uint32_t instanceCount = rInstanceCounts[ orderIndex ];
+			for( uint32_t instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex )
+			{
+				const Simd::Matrix44& rTransform = rDrawCalls[ rOrder[ orderIndex + instanceIndex ] ].transform;
+
+				// Store the transposed transform, matching the layout of the per-instance constant buffers.
+				*( pInstanceData++ ) = rTransform.GetElement( 0 );
+				*( pInstanceData++ ) = rTransform.GetElement( 4 );
+				*( pInstanceData++ ) = rTransform.GetElement( 8 );
+				*( pInstanceData++ ) = rTransform.GetElement( 12 );
+				*( pInstanceData++ ) = rTransform.GetElement( 1 );
+				*( pInstanceData++ ) = rTransform.GetElement( 5 );
+				*( pInstanceData++ ) = rTransform.GetElement( 9 );
+				*( pInstanceData++ ) = rTransform.GetElement( 13 );
+				*( pInstanceData++ ) = rTransform.GetElement( 2 );
+				*( pInstanceData++ ) = rTransform.GetElement( 6 );
+				*( pInstanceData++ ) = rTransform.GetElement( 10 );
+				*( pInstanceData++ ) = rTransform.GetElement( 14 );
+			}
+		}
+	}
+
+	rResourceSet.spInstanceVertexBuffer->Unmap();
+}
+
+/// Get whether two untextured draw calls using external vertex/index buffers can be rendered as instances of the same
+/// draw call.
+///
+/// Draw calls can be instanced if they only differ by their transform.
+///
+/// @param[in] rDrawCall0  First draw call.
+/// @param[in] rDrawCall1  Second draw call.
+///
+/// @return  True if the draw calls can be combined into a single instanced draw call, false if not.
+bool BufferedDrawer::CanInstanceDrawCalls(
+	const UntexturedBufferDrawCall& rDrawCall0,
+	const UntexturedBufferDrawCall& rDrawCall1 ) const
+{
+	return ( rDrawCall0.spVertexBuffer == rDrawCall1.spVertexBuffer &&
+			 rDrawCall0.spIndexBuffer == rDrawCall1.spIndexBuffer &&
+			 rDrawCall0.primitiveType == rDrawCall1.primitiveType &&
+			 rDrawCall0.baseVertexIndex == rDrawCall1.baseVertexIndex &&
+			 rDrawCall0.vertexCount == rDrawCall1.vertexCount &&
+			 rDrawCall0.startIndex == rDrawCall1.startIndex &&
+			 rDrawCall0.primitiveCount == rDrawCall1.primitiveCount &&
+			 rDrawCall0.blendColor.GetArgb() == rDrawCall1.blendColor.GetArgb() );
+}
+
 /// Get the index into draw call arrays for the given rasterizer state and depth-stencil state combination.
 ///
 /// @param[in] rasterizerState    Rasterizer state identifier.
@@ -2433,6 +3097,33 @@ void BufferedDrawer::StateCache::SetVertexBuffer( RVertexBuffer* pBuffer, uint32
 	}
 }
 
+/// Set the vertex buffers for instanced rendering.
+///
+/// @param[in] pBuffer          Vertex buffer to set.
+/// @param[in] stride           Bytes between consecutive vertices.
+/// @param[in] pInstanceBuffer  Per-instance vertex buffer to set.
+/// @param[in] instanceStride   Bytes between consecutive instances.
+/// @param[in] instanceOffset   Index of the first instance to use in the per-instance vertex buffer.
+void BufferedDrawer::StateCache::SetInstancedVertexBuffers(
+	RVertexBuffer* pBuffer,
+	uint32_t stride,
+	RVertexBuffer* pInstanceBuffer,
+	uint32_t instanceStride,
+	uint32_t instanceOffset )
+{
+	HELIUM_ASSERT( m_spRenderCommandProxy );
+
+	// The instance offset changes with each instanced draw call, so these are always set.  The per-instance buffer
+	// does not need to be unset afterward, as vertex input layouts for non-instanced rendering do not read from it.
+	m_spVertexBuffer = pBuffer;
+	m_vertexStride = stride;
+
+	RVertexBuffer* vertexBuffers[] = { pBuffer, pInstanceBuffer };
+	uint32_t vertexStrides[] = { stride, instanceStride };
+	uint32_t vertexOffsets[] = { 0, instanceOffset * instanceStride };
+	m_spRenderCommandProxy->SetVertexBuffers( 0, 2, vertexBuffers, vertexStrides, vertexOffsets );
+}
+
 /// Set the current index buffer.
 ///
 /// @param[in] pBuffer  Index buffer to set.
@@ -2554,6 +3245,83 @@ void BufferedDrawer::StateCache::ResetStateCache()
 	m_spTexture.Release();
 }
 
+/// Constructor.
+///
+/// @param[in] rDrawCalls  Draw calls referenced by the indices being sorted.
+BufferedDrawer::UntexturedBufferDrawCallCompare::UntexturedBufferDrawCallCompare(
+	const DynamicArray< UntexturedBufferDrawCall >& rDrawCalls )
+	: m_pDrawCalls( &rDrawCalls )
+{
+}
+
+/// Compare two draw calls for sorting.
+///
+/// @param[in] drawCallIndex0  Index of the first draw call.
+/// @param[in] drawCallIndex1  Index of the second draw call.
+///
+/// @return  True if the first draw call should be issued before the second, false if not.
+bool BufferedDrawer::UntexturedBufferDrawCallCompare::operator()(
+	uint32_t drawCallIndex0,
+	uint32_t drawCallIndex1 ) const
+{
+	const UntexturedBufferDrawCall& rDrawCall0 = ( *m_pDrawCalls )[ drawCallIndex0 ];
+	const UntexturedBufferDrawCall& rDrawCall1 = ( *m_pDrawCalls )[ drawCallIndex1 ];
+
+	// Opaque draw calls go first, while translucent draw calls are left in their original order afterward.
+	bool bOpaque0 = ( rDrawCall0.blendColor.GetA() == 0xff );
+	bool bOpaque1 = ( rDrawCall1.blendColor.GetA() == 0xff );
+	if( bOpaque0 != bOpaque1 )
+	{
+		return bOpaque0;
+	}
+
+	if( !bOpaque0 )
+	{
+		return false;
+	}
+
+	const RVertexBuffer* pVertexBuffer0 = rDrawCall0.spVertexBuffer;
+	const RVertexBuffer* pVertexBuffer1 = rDrawCall1.spVertexBuffer;
+	if( pVertexBuffer0 != pVertexBuffer1 )
+	{
+		return pVertexBuffer0 < pVertexBuffer1;
+	}
+
+	const RIndexBuffer* pIndexBuffer0 = rDrawCall0.spIndexBuffer;
+	const RIndexBuffer* pIndexBuffer1 = rDrawCall1.spIndexBuffer;
+	if( pIndexBuffer0 != pIndexBuffer1 )
+	{
+		return pIndexBuffer0 < pIndexBuffer1;
+	}
+
+	if( rDrawCall0.primitiveType != rDrawCall1.primitiveType )
+	{
+		return rDrawCall0.primitiveType < rDrawCall1.primitiveType;
+	}
+
+	if( rDrawCall0.baseVertexIndex != rDrawCall1.baseVertexIndex )
+	{
+		return rDrawCall0.baseVertexIndex < rDrawCall1.baseVertexIndex;
+	}
+
+	if( rDrawCall0.vertexCount != rDrawCall1.vertexCount )
+	{
+		return rDrawCall0.vertexCount < rDrawCall1.vertexCount;
+	}
+
+	if( rDrawCall0.startIndex != rDrawCall1.startIndex )
+	{
+		return rDrawCall0.startIndex < rDrawCall1.startIndex;
+	}
+
+	if( rDrawCall0.primitiveCount != rDrawCall1.primitiveCount )
+	{
+		return rDrawCall0.primitiveCount < rDrawCall1.primitiveCount;
+	}
+
+	return rDrawCall0.blendColor.GetArgb() < rDrawCall1.blendColor.GetArgb();
+}
+
 /// Constructor.
 ///
 /// @param[in] pDrawer            Buffered drawer instance being used to perform the rendering.
@@ -2659,108 +3427,355 @@ void BufferedDrawer::WorldSpaceTextGlyphHandler::operator()( const Font::Charact
 
 /// Constructor.
 ///
-/// @param[in] pDrawer  Buffered drawer instance being used to perform the rendering.
-/// @param[in] pFont    Font being used for rendering.
-/// @param[in] x        Pixel x-coordinate at which to begin rendering the text.
-/// @param[in] y        Pixel y-coordinate at which to begin rendering the text.
-/// @param[in] color    Color with which to render the text.
-/// @param[in] size     Size at which to render the text.
-BufferedDrawer::ScreenSpaceTextGlyphHandler::ScreenSpaceTextGlyphHandler(
-	BufferedDrawer* pDrawer,
-	Font* pFont,
-	int32_t x,
-	int32_t y,
-	Color color,
-	RenderResourceManager::EDebugFontSize size )
-	: m_pDrawer( pDrawer )
-	, m_pFont( pFont )
-	, m_pDrawCall( NULL )
-	, m_x( x )
-	, m_y( y )
-	, m_color( color )
-	, m_size( size )
+/// @param[in] pFont          Font being used for rendering.
+/// @param[in] rGlyphIndices  Glyph index list to which to append the character index of each glyph.
+BufferedDrawer::GlyphIndexCollector::GlyphIndexCollector( Font* pFont, DynamicArray< uint32_t >& rGlyphIndices )
+	: m_pFont( pFont )
+	, m_rGlyphIndices( rGlyphIndices )
 {
 }
 
-/// Draw the specified character.
+/// Add the specified character.
 ///
-/// @param[in] pCharacter  Character to draw.
-void BufferedDrawer::ScreenSpaceTextGlyphHandler::operator()( const Font::Character* pCharacter )
+/// @param[in] pCharacter  Character to add.
+void BufferedDrawer::GlyphIndexCollector::operator()( const Font::Character* pCharacter )
 {
 	HELIUM_ASSERT( pCharacter );
 
-	uint32_t characterIndex = m_pFont->GetCharacterIndex( pCharacter );
+	m_rGlyphIndices.Push( m_pFont->GetCharacterIndex( pCharacter ) );
+}
+
+/// Get the glyph indices for drawing a string with a given font, processing the string only if it isn't cached.
+///
+/// @param[in] pFont  Font to use.
+/// @param[in] rText  Text to draw.
+///
+/// @return  Cached glyphs.  The pointer is only valid until the next call to this function.
+///
+/// @see EvictIdleTextGlyphs()
+const BufferedDrawer::CachedTextGlyphs* BufferedDrawer::GetTextGlyphs( Font* pFont, const String& rText )
+{
+	HELIUM_ASSERT( pFont );
+
+	static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+	uint64_t key = FNV_OFFSET_BASIS;
+	key = ( key ^ static_cast< uint64_t >( reinterpret_cast< uintptr_t >( pFont ) ) ) * FNV_PRIME;
+	if( !rText.IsEmpty() )
+	{
+		key = ( key ^ static_cast< uint64_t >( StringHash( rText.GetData() ) ) ) * FNV_PRIME;
+	}
+
+	HashMap< uint64_t, CachedTextGlyphs >::Iterator entryIterator = m_textGlyphCache.Find( key );
+	if( entryIterator != m_textGlyphCache.End() )
+	{
+		CachedTextGlyphs& rEntry = entryIterator->Second();
+		if( rEntry.pFont == pFont && rEntry.text == rText )
+		{
+			rEntry.lastUsedFrame = m_textGlyphCacheFrame;
+
+			return &rEntry;
+		}
+
+		// Hash collision with a different string, so replace the existing entry.
+		m_textGlyphCache.Remove( entryIterator );
+	}
+
+	CachedTextGlyphs entry;
+	entry.pFont = pFont;
+	entry.text = rText;
+	entry.lastUsedFrame = m_textGlyphCacheFrame;
+
+	GlyphIndexCollector glyphCollector( pFont, entry.glyphIndices );
+	pFont->ProcessText( rText, glyphCollector );
+
+	m_textGlyphCache.Insert( entryIterator, HashMap< uint64_t, CachedTextGlyphs >::ValueType( key, entry ) );
+	HELIUM_ASSERT( entryIterator != m_textGlyphCache.End() );
 
-	m_pDrawer->m_screenTextGlyphIndices.Push( characterIndex );
+	return &entryIterator->Second();
+}
+
+/// Free the cached glyphs of text that has not been drawn for TEXT_GLYPH_CACHE_IDLE_FRAME_MAX frames.
+///
+/// @see GetTextGlyphs()
+void BufferedDrawer::EvictIdleTextGlyphs()
+{
+	HELIUM_ASSERT( m_evictedTextGlyphKeys.IsEmpty() );
 
-	if( !m_pDrawCall )
+	for( HashMap< uint64_t, CachedTextGlyphs >::ConstIterator entryIterator = m_textGlyphCache.Begin();
+		entryIterator != m_textGlyphCache.End();
+		++entryIterator )
 	{
-		m_pDrawCall = m_pDrawer->m_screenTextDrawCalls.New();
-		HELIUM_ASSERT( m_pDrawCall );
-		m_pDrawCall->x = m_x;
-		m_pDrawCall->y = m_y;
-		m_pDrawCall->color = m_color;
-		m_pDrawCall->size = m_size;
-		m_pDrawCall->glyphCount = 0;
+		if( m_textGlyphCacheFrame - entryIterator->Second().lastUsedFrame >= TEXT_GLYPH_CACHE_IDLE_FRAME_MAX )
+		{
+			m_evictedTextGlyphKeys.Push( entryIterator->First() );
+		}
 	}
 
-	++m_pDrawCall->glyphCount;
+	size_t evictedCount = m_evictedTextGlyphKeys.GetSize();
+	for( size_t keyIndex = 0; keyIndex < evictedCount; ++keyIndex )
+	{
+		HashMap< uint64_t, CachedTextGlyphs >::Iterator entryIterator =
+			m_textGlyphCache.Find( m_evictedTextGlyphKeys[ keyIndex ] );
+		HELIUM_ASSERT( entryIterator != m_textGlyphCache.End() );
+		m_textGlyphCache.Remove( entryIterator );
+	}
+
+	m_evictedTextGlyphKeys.Resize( 0 );
 }
 
 /// Constructor.
+BufferedDrawer::Recorder::Recorder()
+{
+}
+
+/// Buffer an untextured primitive draw call.
 ///
-/// @param[in] pDrawer        Buffered drawer instance being used to perform the rendering.
-/// @param[in] pFont          Font being used for rendering.
-/// @param[in] rWorldOffset   World-space offset at which to begin rendering the text.
-/// @param[in] screenOffsetX  Horizontal pixel offset at which to begin rendering the text.
-/// @param[in] screenOffsetY  Vertical pixel offset at which to begin rendering the text.
-/// @param[in] color          Color with which to render the text.
-/// @param[in] size           Size at which to render the text.
-BufferedDrawer::ProjectedTextGlyphHandler::ProjectedTextGlyphHandler(
-	BufferedDrawer* pDrawer,
-	Font* pFont,
-	const Simd::Vector3& rWorldOffset,
-	int32_t screenOffsetX,
-	int32_t screenOffsetY,
-	Color color,
-	RenderResourceManager::EDebugFontSize size )
-	: m_pDrawer( pDrawer )
-	, m_pFont( pFont )
-	, m_pDrawCall( NULL )
-	, m_worldOffsetX( rWorldOffset.GetElement( 0 ) )
-	, m_worldOffsetY( rWorldOffset.GetElement( 1 ) )
-	, m_worldOffsetZ( rWorldOffset.GetElement( 2 ) )
-	, m_screenOffsetX( screenOffsetX )
-	, m_screenOffsetY( screenOffsetY )
-	, m_color( color )
-	, m_size( size )
+/// @param[in] primitiveType      Type of primitive to draw.
+/// @param[in] rTransform         World transform to apply when rendering.
+/// @param[in] pVertices          Vertices to use for drawing.
+/// @param[in] vertexCount        Number of vertices used for drawing.
+/// @param[in] pIndices           Indices to use for drawing.  If this is null, unindexed rendering will be performed.
+/// @param[in] primitiveCount     Number of primitives to draw.
+/// @param[in] blendColor         Color with which to blend each vertex color.
+/// @param[in] rasterizerState    Rasterizer state to use during rendering.
+/// @param[in] depthStencilState  Depth-stencil state to use during rendering.
+///
+/// @see BufferedDrawer::DrawUntextured()
+void BufferedDrawer::Recorder::DrawUntextured(
+	ERendererPrimitiveType primitiveType,
+	const Simd::Matrix44& rTransform,
+	const SimpleVertex* pVertices,
+	uint32_t vertexCount,
+	const uint16_t* pIndices,
+	uint32_t primitiveCount,
+	Color blendColor,
+	RenderResourceManager::ERasterizerState rasterizerState,
+	RenderResourceManager::EDepthStencilState depthStencilState )
 {
+	HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
+	HELIUM_ASSERT( pVertices );
+	HELIUM_ASSERT( vertexCount );
+	HELIUM_ASSERT( pIndices || vertexCount == RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
+	HELIUM_ASSERT( primitiveCount );
+	HELIUM_ASSERT(
+		static_cast< size_t >( rasterizerState ) <
+		static_cast< size_t >( RenderResourceManager::RASTERIZER_STATE_MAX ) );
+	HELIUM_ASSERT(
+		static_cast< size_t >( depthStencilState ) <
+		static_cast< size_t >( RenderResourceManager::DEPTH_STENCIL_STATE_MAX ) );
+
+	// Don't buffer any drawing information if we have no renderer.
+	if( !Renderer::GetInstance() )
+	{
+		return;
+	}
+
+	uint32_t baseVertexIndex = static_cast< uint32_t >( m_untexturedVertices.GetSize() );
+	m_untexturedVertices.AddArray( pVertices, vertexCount );
+
+	uint32_t startIndex;
+	SetInvalid( startIndex );
+	if( pIndices )
+	{
+		startIndex = static_cast< uint32_t >( m_untexturedIndices.GetSize() );
+		m_untexturedIndices.AddArray(
+			pIndices,
+			RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
+	}
+
+	size_t stateIndex = GetStateIndex( rasterizerState, depthStencilState );
+	UntexturedDrawCall* pDrawCall = m_untexturedDrawCalls[ stateIndex ].New();
+	HELIUM_ASSERT( pDrawCall );
+	pDrawCall->transform = rTransform;
+	pDrawCall->primitiveType = primitiveType;
+	pDrawCall->baseVertexIndex = baseVertexIndex;
+	pDrawCall->vertexCount = vertexCount;
+	pDrawCall->startIndex = startIndex;
+	pDrawCall->primitiveCount = primitiveCount;
+	pDrawCall->blendColor = blendColor;
 }
 
-/// Draw the specified character.
+/// Buffer a textured primitive draw call.
 ///
-/// @param[in] pCharacter  Character to draw.
-void BufferedDrawer::ProjectedTextGlyphHandler::operator()( const Font::Character* pCharacter )
+/// @param[in] primitiveType      Type of primitive to draw.
+/// @param[in] rTransform         World transform to apply when rendering.
+/// @param[in] pVertices          Vertices to use for drawing.
+/// @param[in] vertexCount        Number of vertices used for drawing.
+/// @param[in] pIndices           Indices to use for drawing.  If this is null, unindexed rendering will be performed.
+/// @param[in] primitiveCount     Number of primitives to draw.
+/// @param[in] pTexture           Texture to apply to the mesh.
+/// @param[in] blendColor         Color with which to blend each vertex color.
+/// @param[in] rasterizerState    Rasterizer state to use during rendering.
+/// @param[in] depthStencilState  Depth-stencil state to use during rendering.
+///
+/// @see BufferedDrawer::DrawTextured()
+void BufferedDrawer::Recorder::DrawTextured(
+	ERendererPrimitiveType primitiveType,
+	const Simd::Matrix44& rTransform,
+	const SimpleTexturedVertex* pVertices,
+	uint32_t vertexCount,
+	const uint16_t* pIndices,
+	uint32_t primitiveCount,
+	RTexture2d* pTexture,
+	Color blendColor,
+	RenderResourceManager::ERasterizerState rasterizerState,
+	RenderResourceManager::EDepthStencilState depthStencilState )
 {
-	HELIUM_ASSERT( pCharacter );
+	HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
+	HELIUM_ASSERT( pVertices );
+	HELIUM_ASSERT( vertexCount );
+	HELIUM_ASSERT( pIndices || vertexCount == RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
+	HELIUM_ASSERT( primitiveCount );
+	HELIUM_ASSERT( pTexture );
+	HELIUM_ASSERT(
+		static_cast< size_t >( rasterizerState ) <
+		static_cast< size_t >( RenderResourceManager::RASTERIZER_STATE_MAX ) );
+	HELIUM_ASSERT(
+		static_cast< size_t >( depthStencilState ) <
+		static_cast< size_t >( RenderResourceManager::DEPTH_STENCIL_STATE_MAX ) );
 
-	uint32_t characterIndex = m_pFont->GetCharacterIndex( pCharacter );
+	// Don't buffer any drawing information if we have no renderer.
+	if( !Renderer::GetInstance() )
+	{
+		return;
+	}
 
-	m_pDrawer->m_screenTextGlyphIndices.Push( characterIndex );
+	uint32_t baseVertexIndex = static_cast< uint32_t >( m_texturedVertices.GetSize() );
+	m_texturedVertices.AddArray( pVertices, vertexCount );
 
-	if( !m_pDrawCall )
+	uint32_t startIndex;
+	SetInvalid( startIndex );
+	if( pIndices )
 	{
-		m_pDrawCall = m_pDrawer->m_projectedTextDrawCalls.New();
-		HELIUM_ASSERT( m_pDrawCall );
-		m_pDrawCall->x = m_screenOffsetX;
-		m_pDrawCall->y = m_screenOffsetY;
-		m_pDrawCall->color = m_color;
-		m_pDrawCall->size = m_size;
-		m_pDrawCall->glyphCount = 0;
-		m_pDrawCall->worldPosition[ 0 ] = m_worldOffsetX;
-		m_pDrawCall->worldPosition[ 1 ] = m_worldOffsetY;
-		m_pDrawCall->worldPosition[ 2 ] = m_worldOffsetZ;
+		startIndex = static_cast< uint32_t >( m_texturedIndices.GetSize() );
+		m_texturedIndices.AddArray(
+			pIndices,
+			RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) );
+	}
+
+	size_t stateIndex = GetStateIndex( rasterizerState, depthStencilState );
+	TexturedDrawCall* pDrawCall = m_texturedDrawCalls[ stateIndex ].New();
+	HELIUM_ASSERT( pDrawCall );
+	pDrawCall->transform = rTransform;
+	pDrawCall->primitiveType = primitiveType;
+	pDrawCall->baseVertexIndex = baseVertexIndex;
+	pDrawCall->vertexCount = vertexCount;
+	pDrawCall->startIndex = startIndex;
+	pDrawCall->primitiveCount = primitiveCount;
+	pDrawCall->blendColor = blendColor;
+	pDrawCall->spTexture = pTexture;
+}
+
+/// Buffer a point list draw call using points larger than a pixel.
+///
+/// @param[in] pVertices          Vertices to use for drawing.
+/// @param[in] pointCount         Number of points to draw.
+/// @param[in] blendColor         Color with which to blend each vertex color.
+/// @param[in] depthStencilState  Depth-stencil state to use during rendering.
+///
+/// @see BufferedDrawer::DrawPoints()
+void BufferedDrawer::Recorder::DrawPoints(
+	const SimpleVertex* pVertices,
+	uint32_t pointCount,
+	Color blendColor,
+	RenderResourceManager::EDepthStencilState depthStencilState )
+{
+	HELIUM_ASSERT( pVertices );
+	HELIUM_ASSERT( pointCount );
+	HELIUM_ASSERT(
+		static_cast< size_t >( depthStencilState ) <
+		static_cast< size_t >( RenderResourceManager::DEPTH_STENCIL_STATE_MAX ) );
+
+	// Don't buffer any drawing information if we have no renderer.
+	if( !Renderer::GetInstance() )
+	{
+		return;
+	}
+
+	uint32_t baseVertexIndex = static_cast< uint32_t >( m_untexturedVertices.GetSize() );
+	m_untexturedVertices.AddArray( pVertices, pointCount );
+
+	UntexturedDrawCall* pDrawCall = m_pointDrawCalls[ depthStencilState ].New();
+	HELIUM_ASSERT( pDrawCall );
+	pDrawCall->primitiveType = RENDERER_PRIMITIVE_TYPE_POINT_LIST;
+	pDrawCall->baseVertexIndex = baseVertexIndex;
+	pDrawCall->vertexCount = pointCount;
+	SetInvalid( pDrawCall->startIndex );
+	pDrawCall->primitiveCount = pointCount;
+	pDrawCall->blendColor = blendColor;
+}
+
+/// Append this recorder's draw calls to a drawer's draw call lists and reset this recorder for reuse.
+///
+/// @param[in] rDrawer  Drawer into which to merge the recorded draw calls.
+void BufferedDrawer::Recorder::MergeInto( BufferedDrawer& rDrawer )
+{
+	uint32_t untexturedVertexOffset = static_cast< uint32_t >( rDrawer.m_untexturedVertices.GetSize() );
+	uint32_t untexturedIndexOffset = static_cast< uint32_t >( rDrawer.m_untexturedIndices.GetSize() );
+	uint32_t texturedVertexOffset = static_cast< uint32_t >( rDrawer.m_texturedVertices.GetSize() );
+	uint32_t texturedIndexOffset = static_cast< uint32_t >( rDrawer.m_texturedIndices.GetSize() );
+
+	rDrawer.m_untexturedVertices.AddArray( m_untexturedVertices.GetData(), m_untexturedVertices.GetSize() );
+	rDrawer.m_untexturedIndices.AddArray( m_untexturedIndices.GetData(), m_untexturedIndices.GetSize() );
+	rDrawer.m_texturedVertices.AddArray( m_texturedVertices.GetData(), m_texturedVertices.GetSize() );
+	rDrawer.m_texturedIndices.AddArray( m_texturedIndices.GetData(), m_texturedIndices.GetSize() );
+
+	for( size_t stateIndex = 0; stateIndex < HELIUM_ARRAY_COUNT( m_untexturedDrawCalls ); ++stateIndex )
+	{
+		AppendDrawCalls(
+			rDrawer.m_untexturedDrawCalls[ stateIndex ],
+			m_untexturedDrawCalls[ stateIndex ],
+			untexturedVertexOffset,
+			untexturedIndexOffset );
+		AppendDrawCalls(
+			rDrawer.m_texturedDrawCalls[ stateIndex ],
+			m_texturedDrawCalls[ stateIndex ],
+			texturedVertexOffset,
+			texturedIndexOffset );
+	}
+
+	for( size_t stateIndex = 0; stateIndex < HELIUM_ARRAY_COUNT( m_pointDrawCalls ); ++stateIndex )
+	{
+		AppendDrawCalls(
+			rDrawer.m_pointDrawCalls[ stateIndex ],
+			m_pointDrawCalls[ stateIndex ],
+			untexturedVertexOffset,
+			untexturedIndexOffset );
+	}
+
+	// Keep the capacity for the next frame.
+	m_untexturedVertices.RemoveAll();
+	m_untexturedIndices.RemoveAll();
+	m_texturedVertices.RemoveAll();
+	m_texturedIndices.RemoveAll();
+}
+
+/// Move draw calls from a recorder list to a drawer list, rebasing their vertex and index offsets.
+///
+/// @param[in] rDestination  Draw call list to which to append.
+/// @param[in] rSource       Recorded draw calls.  This is emptied on return.
+/// @param[in] vertexOffset  Offset of the recorder's first vertex in the drawer's vertex list.
+/// @param[in] indexOffset   Offset of the recorder's first index in the drawer's index list.
+template< typename DrawCallType >
+void BufferedDrawer::Recorder::AppendDrawCalls(
+	DynamicArray< DrawCallType >& rDestination,
+	DynamicArray< DrawCallType >& rSource,
+	uint32_t vertexOffset,
+	uint32_t indexOffset )
+{
+	size_t drawCallCount = rSource.GetSize();
+	for( size_t drawCallIndex = 0; drawCallIndex < drawCallCount; ++drawCallIndex )
+	{
+		DrawCallType* pDrawCall = rDestination.New( rSource[ drawCallIndex ] );
+		HELIUM_ASSERT( pDrawCall );
+		pDrawCall->baseVertexIndex += vertexOffset;
+		if( IsValid( pDrawCall->startIndex ) )
+		{
+			pDrawCall->startIndex += indexOffset;
+		}
 	}
 
-	++m_pDrawCall->glyphCount;
+	rSource.RemoveAll();
 }
@@ -2,11 +2,13 @@
 
 #include "Graphics/Graphics.h"
 
+#include "Foundation/HashMap.h"
 #include "MathSimd/Matrix44.h"
 #include "Rendering/RRenderResource.h"
 #include "GraphicsTypes/VertexTypes.h"
 #include "Graphics/Font.h"
 #include "Graphics/RenderResourceManager.h"
+#include "Platform/Locks.h"
 
 namespace Helium
 {
@@ -29,9 +31,15 @@ namespace Helium
 		static const size_t INSTANCE_VERTEX_CONSTANT_BUFFER_COUNT = 64;
 		/// Number of constant buffers to cycle through for pixel shader blend color parameters.
 		static const size_t INSTANCE_PIXEL_CONSTANT_BUFFER_COUNT = 16;
+		/// Number of indices in the index buffer used when drawing instances of unindexed primitives.
+		static const uint32_t SEQUENTIAL_INDEX_COUNT = 4096;
 
 		/// Maximum number of characters to convert for rendered text strings (including null terminator).
 		static const size_t TEXT_CHARACTER_COUNT_MAX = 1024;
+		/// Number of frames after which the cached glyphs of screen-space or projected text not drawn since are freed.
+		static const uint32_t TEXT_GLYPH_CACHE_IDLE_FRAME_MAX = 120;
+
+		class Recorder;
 
 		/// @name Construction/Destruction
 		//@{
@@ -71,6 +79,21 @@ namespace Helium
 			uint32_t primitiveCount, RTexture2d* pTexture, Color blendColor = Color( 0xffffffff ),
 			RenderResourceManager::ERasterizerState rasterizerState = RenderResourceManager::RASTERIZER_STATE_DEFAULT,
 			RenderResourceManager::EDepthStencilState depthStencilState = RenderResourceManager::DEPTH_STENCIL_STATE_DEFAULT );
+
+		SimpleVertex* AllocateUntexturedVertices( uint32_t vertexCount, uint32_t& rBaseVertexIndex );
+		SimpleTexturedVertex* AllocateTexturedVertices( uint32_t vertexCount, uint32_t& rBaseVertexIndex );
+
+		void DrawAllocatedUntextured(
+			ERendererPrimitiveType primitiveType, const Simd::Matrix44& rTransform, uint32_t baseVertexIndex, uint32_t vertexCount,
+			const uint16_t* pIndices, uint32_t primitiveCount, Color blendColor = Color( 0xffffffff ),
+			RenderResourceManager::ERasterizerState rasterizerState = RenderResourceManager::RASTERIZER_STATE_DEFAULT,
+			RenderResourceManager::EDepthStencilState depthStencilState = RenderResourceManager::DEPTH_STENCIL_STATE_DEFAULT );
+		void DrawAllocatedTextured(
+			ERendererPrimitiveType primitiveType, const Simd::Matrix44& rTransform, uint32_t baseVertexIndex, uint32_t vertexCount,
+			const uint16_t* pIndices, uint32_t primitiveCount, RTexture2d* pTexture,
+			Color blendColor = Color( 0xffffffff ),
+			RenderResourceManager::ERasterizerState rasterizerState = RenderResourceManager::RASTERIZER_STATE_DEFAULT,
+			RenderResourceManager::EDepthStencilState depthStencilState = RenderResourceManager::DEPTH_STENCIL_STATE_DEFAULT );
 				
 		void DrawPoints(
 			const SimpleVertex* pVertices, uint32_t pointCount, Color blendColor = Color( 0xffffffff ),
@@ -161,6 +184,11 @@ namespace Helium
 		void DrawScreenElements();
 		//@}
 
+		/// @name Multithreaded Recording
+		//@{
+		Recorder* AcquireRecorder();
+		//@}
+
 	private:
 		/// Untextured primitive draw call information using internal vertex/index buffers.
 		struct UntexturedDrawCall
@@ -244,6 +272,9 @@ namespace Helium
 			/// Vertex buffer for projected text rendering.
 			RVertexBufferPtr spProjectedTextVertexBuffer;
 
+			/// Vertex buffer of per-instance transforms for instanced primitive rendering.
+			RVertexBufferPtr spInstanceVertexBuffer;
+
 			/// Vertex constant buffers.
 			RConstantBufferPtr instanceVertexConstantBuffers[ INSTANCE_VERTEX_CONSTANT_BUFFER_COUNT ];
 			/// Pixel constant buffers.
@@ -263,6 +294,9 @@ namespace Helium
 			uint32_t screenSpaceTextVertexBufferSize;
 			/// Maximum number of vertices in the projected text vertex buffer.
 			uint32_t projectedTextVertexBufferSize;
+
+			/// Maximum number of instances in the instance vertex buffer.
+			uint32_t instanceVertexBufferSize;
 		} HELIUM_SIMD_ALIGN_POST;
 
 		/// Cached renderer state information.
@@ -286,6 +320,9 @@ namespace Helium
 			void SetDepthStencilState( RDepthStencilState* pState, uint8_t stencilReferenceValue );
 
 			void SetVertexBuffer( RVertexBuffer* pBuffer, uint32_t stride );
+			void SetInstancedVertexBuffers(
+				RVertexBuffer* pBuffer, uint32_t stride, RVertexBuffer* pInstanceBuffer, uint32_t instanceStride,
+				uint32_t instanceOffset );
 			void SetIndexBuffer( RIndexBuffer* pBuffer );
 
 			void SetVertexShader( RVertexShader* pShader );
@@ -353,6 +390,8 @@ namespace Helium
 			RVertexShaderPtr spUntexturedVertexShader;
 			/// Untextured point sprite vertex shader.
 			RVertexShaderPtr spUntexturedPointsVertexShader;
+			/// Untextured instanced rendering vertex shader.
+			RVertexShaderPtr spUntexturedInstancedVertexShader;
 			/// Untextured rendering pixel shader.
 			RPixelShaderPtr spUntexturedPixelShader;
 
@@ -368,6 +407,8 @@ namespace Helium
 
 			/// Cached reference to the vertex description for SimpleVertex.
 			RVertexDescriptionPtr spSimpleVertexDescription;
+			/// Cached reference to the instanced vertex description for SimpleVertex.
+			RVertexDescriptionPtr spInstancedSimpleVertexDescription;
 			/// Cached reference to the vertex description for SimpleTexturedVertex;
 			RVertexDescriptionPtr spSimpleTexturedVertexDescription;
 
@@ -416,15 +457,13 @@ namespace Helium
 			float32_t m_penX;
 		};
 
-		/// Glyph handler for rendering screen-space text.
-		class HELIUM_GRAPHICS_API ScreenSpaceTextGlyphHandler : NonCopyable
+		/// Glyph handler collecting the font character index of each glyph in a string.
+		class HELIUM_GRAPHICS_API GlyphIndexCollector : NonCopyable
 		{
 		public:
 			/// @name Construction/Destruction
 			//@{
-			ScreenSpaceTextGlyphHandler(
-				BufferedDrawer* pDrawer, Font* pFont, int32_t x, int32_t y, Color color,
-				RenderResourceManager::EDebugFontSize size );
+			GlyphIndexCollector( Font* pFont, DynamicArray< uint32_t >& rGlyphIndices );
 			//@}
 
 			/// @name Overloaded Operators
@@ -433,63 +472,23 @@ namespace Helium
 			//@}
 
 		private:
-			/// Pointer to the BufferedDrawer instance performing the rendering.
-			BufferedDrawer* m_pDrawer;
 			/// Font resource being used for rendering.
 			Font* m_pFont;
-			/// Text draw call to update.
-			ScreenTextDrawCall* m_pDrawCall;
-
-			/// Pixel x-coordinate at which to begin rendering the text.
-			int32_t m_x;
-			/// Pixel y-coordinate at which to begin rendering the text.
-			int32_t m_y;
-			/// Color with which to render the text.
-			Color m_color;
-			/// Size at which to render the text.
-			RenderResourceManager::EDebugFontSize m_size;
+			/// Glyph index list to fill.
+			DynamicArray< uint32_t >& m_rGlyphIndices;
 		};
 
-		/// Glyph handler for rendering projected text.
-		class HELIUM_GRAPHICS_API ProjectedTextGlyphHandler : NonCopyable
+		/// Cached glyph indices of a string drawn as screen-space or projected text.
+		struct CachedTextGlyphs
 		{
-		public:
-			/// @name Construction/Destruction
-			//@{
-			ProjectedTextGlyphHandler(
-				BufferedDrawer* pDrawer, Font* pFont, const Simd::Vector3& rWorldOffset, int32_t screenOffsetX,
-				int32_t screenOffsetY, Color color, RenderResourceManager::EDebugFontSize size );
-			//@}
-
-			/// @name Overloaded Operators
-			//@{
-			void operator()( const Font::Character* pCharacter );
-			//@}
-
-		private:
-			/// Pointer to the BufferedDrawer instance performing the rendering.
-			BufferedDrawer* m_pDrawer;
-			/// Font resource being used for rendering.
-			Font* m_pFont;
-			/// Text draw call to update.
-			ProjectedTextDrawCall* m_pDrawCall;
-
-			/// World x-coordinate at which to begin rendering the text.
-			float32_t m_worldOffsetX;
-			/// World y-coordinate at which to begin rendering the text.
-			float32_t m_worldOffsetY;
-			/// World z-coordinate at which to begin rendering the text.
-			float32_t m_worldOffsetZ;
-
-			/// Pixel x-coordinate at which to begin rendering the text.
-			int32_t m_screenOffsetX;
-			/// Pixel y-coordinate at which to begin rendering the text.
-			int32_t m_screenOffsetY;
-
-			/// Color with which to render the text.
-			Color m_color;
-			/// Size at which to render the text.
-			RenderResourceManager::EDebugFontSize m_size;
+			/// Font used to process the string.
+			Font* pFont;
+			/// String that was processed.
+			String text;
+			/// Font character index of each glyph.
+			DynamicArray< uint32_t > glyphIndices;
+			/// Frame number when the glyphs were last drawn.
+			uint32_t lastUsedFrame;
 		};
 
 		/// Untextured draw call vertices.
@@ -516,6 +515,15 @@ namespace Helium
 		/// Point draw call data using external vertex/index buffers.
 		DynamicArray< UntexturedBufferDrawCall > m_pointBufferDrawCalls[ RenderResourceManager::DEPTH_STENCIL_STATE_MAX ];
 
+		/// Order in which to issue the untextured draw calls using external vertex/index buffers, with draw calls that can
+		/// be drawn as instances of each other next to each other.
+		DynamicArray< uint32_t > m_untexturedBufferDrawCallOrders[ RenderResourceManager::RASTERIZER_STATE_MAX * RenderResourceManager::DEPTH_STENCIL_STATE_MAX ];
+		/// Number of draw calls in the instanced run starting at each position in the untextured buffer draw call order,
+		/// or zero if no run of two or more draw calls starts at that position.
+		DynamicArray< uint32_t > m_untexturedBufferInstanceCounts[ RenderResourceManager::RASTERIZER_STATE_MAX * RenderResourceManager::DEPTH_STENCIL_STATE_MAX ];
+		/// Index of the first instance transform of each state's instanced runs in the instance vertex buffer.
+		uint32_t m_untexturedBufferInstanceOffsets[ RenderResourceManager::RASTERIZER_STATE_MAX * RenderResourceManager::DEPTH_STENCIL_STATE_MAX ];
+
 		/// World-space text draw call data.
 		DynamicArray< TexturedDrawCall > m_worldTextDrawCalls[ RenderResourceManager::RASTERIZER_STATE_MAX * RenderResourceManager::DEPTH_STENCIL_STATE_MAX ];
 
@@ -529,12 +537,23 @@ namespace Helium
 		/// Projected text draw call glyph indices.
 		DynamicArray< uint32_t > m_projectedTextGlyphIndices;
 
+		/// Glyph indices of recently drawn screen-space and projected text, keyed by a hash of the font and string, so
+		/// text drawn every frame (HUD counters, debug labels) isn't converted and looked up glyph by glyph every frame.
+		HashMap< uint64_t, CachedTextGlyphs > m_textGlyphCache;
+		/// Scratch list of keys of text glyph cache entries being evicted.
+		DynamicArray< uint64_t > m_evictedTextGlyphKeys;
+		/// Number of EndDrawing() calls, used to age text glyph cache entries.
+		uint32_t m_textGlyphCacheFrame;
+
 		/// Index buffer for screen-space text rendering.
 		RIndexBufferPtr m_spScreenSpaceTextIndexBuffer;
 
 		/// Vertices for drawing quads
 		RVertexBufferPtr m_spQuadVertexBuffer;
 
+		/// Index buffer counting up from zero, used for drawing instances of unindexed primitives.
+		RIndexBufferPtr m_spSequentialIndexBuffer;
+
 		/// Render fences used to mark the end of when a per-instance vertex shader constant buffer is in use.
 		RFencePtr m_instanceVertexConstantFences[ INSTANCE_VERTEX_CONSTANT_BUFFER_COUNT ];
 		/// Current instance vertex constant buffer transform.
@@ -558,8 +577,42 @@ namespace Helium
 		/// (new commands can be buffered).
 		bool m_bDrawing;
 
+		/// Recorders created for this drawer, kept from frame to frame so their lists keep their capacity.
+		DynamicArray< Recorder* > m_recorders;
+		/// Number of recorders handed out since the last BeginDrawing() call.
+		size_t m_activeRecorderCount;
+		/// Lock guarding recorder hand-out.
+		Mutex m_recorderLock;
+
+		/// Sort comparison for untextured draw calls using external vertex/index buffers, placing opaque draw calls of the
+		/// same geometry next to each other and translucent draw calls last in their original order.
+		class UntexturedBufferDrawCallCompare
+		{
+		public:
+			/// @name Construction/Destruction
+			//@{
+			explicit UntexturedBufferDrawCallCompare( const DynamicArray< UntexturedBufferDrawCall >& rDrawCalls );
+			//@}
+
+			/// @name Overloaded Operators
+			//@{
+			bool operator()( uint32_t drawCallIndex0, uint32_t drawCallIndex1 ) const;
+			//@}
+
+		private:
+			/// Draw calls being sorted.
+			const DynamicArray< UntexturedBufferDrawCall >* m_pDrawCalls;
+		};
+
 		/// @name Rendering Utility Functions
 		//@{
+		void MergeRecorders();
+		const CachedTextGlyphs* GetTextGlyphs( Font* pFont, const String& rText );
+		void EvictIdleTextGlyphs();
+		void PrepareInstancedDrawCalls( ResourceSet& rResourceSet );
+		bool CanInstanceDrawCalls(
+			const UntexturedBufferDrawCall& rDrawCall0, const UntexturedBufferDrawCall& rDrawCall1 ) const;
+
 		RConstantBuffer* SetInstanceVertexConstantData(
 			RRenderCommandProxy* pCommandProxy, ResourceSet& rResourceSet, const Simd::Matrix44& rInverseViewProjection,
 			const Simd::Matrix44& rTransform );
@@ -583,4 +636,72 @@ namespace Helium
 			RenderResourceManager::EDepthStencilState& rDepthStencilState );
 		//@}
 	};
+
+	/// Draw call recording context for a single thread.
+	///
+	/// Each recorder has its own vertex, index, and draw call lists, so any number of threads can record draw calls at
+	/// the same time without locking as long as each uses its own recorder (see BufferedDrawer::AcquireRecorder()).
+	/// Recorded draw calls are merged into the drawer when BufferedDrawer::BeginDrawing() is next called, which must not
+	/// overlap with any recording.
+	class HELIUM_GRAPHICS_API BufferedDrawer::Recorder : NonCopyable
+	{
+	public:
+		/// @name Draw Call Generation
+		//@{
+		void DrawUntextured(
+			ERendererPrimitiveType primitiveType, const Simd::Matrix44& rTransform, const SimpleVertex* pVertices, uint32_t vertexCount,
+			const uint16_t* pIndices, uint32_t primitiveCount, Color blendColor = Color( 0xffffffff ),
+			RenderResourceManager::ERasterizerState rasterizerState = RenderResourceManager::RASTERIZER_STATE_DEFAULT,
+			RenderResourceManager::EDepthStencilState depthStencilState = RenderResourceManager::DEPTH_STENCIL_STATE_DEFAULT );
+		void DrawTextured(
+			ERendererPrimitiveType primitiveType, const Simd::Matrix44& rTransform, const SimpleTexturedVertex* pVertices, uint32_t vertexCount,
+			const uint16_t* pIndices, uint32_t primitiveCount, RTexture2d* pTexture,
+			Color blendColor = Color( 0xffffffff ),
+			RenderResourceManager::ERasterizerState rasterizerState = RenderResourceManager::RASTERIZER_STATE_DEFAULT,
+			RenderResourceManager::EDepthStencilState depthStencilState = RenderResourceManager::DEPTH_STENCIL_STATE_DEFAULT );
+		void DrawPoints(
+			const SimpleVertex* pVertices, uint32_t pointCount, Color blendColor = Color( 0xffffffff ),
+			RenderResourceManager::EDepthStencilState depthStencilState = RenderResourceManager::DEPTH_STENCIL_STATE_NONE );
+
+		void DrawLineList(const SimpleVertex* pVertices, uint32_t pointCount, Color blendColor = Color( 0xffffffff ))
+		{
+			DrawUntextured(RENDERER_PRIMITIVE_TYPE_LINE_LIST, Simd::Matrix44::IDENTITY, pVertices, pointCount, NULL, pointCount / 2, blendColor);
+		}
+		//@}
+
+	private:
+		friend class BufferedDrawer;
+
+		/// Untextured draw call vertices.
+		DynamicArray< SimpleVertex > m_untexturedVertices;
+		/// Textured draw call vertices.
+		DynamicArray< SimpleTexturedVertex > m_texturedVertices;
+
+		/// Untextured draw call indices.
+		DynamicArray< uint16_t > m_untexturedIndices;
+		/// Textured draw call indices.
+		DynamicArray< uint16_t > m_texturedIndices;
+
+		/// Untextured draw call data, relative to this recorder's vertex and index lists.
+		DynamicArray< UntexturedDrawCall > m_untexturedDrawCalls[ RenderResourceManager::RASTERIZER_STATE_MAX * RenderResourceManager::DEPTH_STENCIL_STATE_MAX ];
+		/// Textured draw call data, relative to this recorder's vertex and index lists.
+		DynamicArray< TexturedDrawCall > m_texturedDrawCalls[ RenderResourceManager::RASTERIZER_STATE_MAX * RenderResourceManager::DEPTH_STENCIL_STATE_MAX ];
+		/// Point draw call data, relative to this recorder's vertex list.
+		DynamicArray< UntexturedDrawCall > m_pointDrawCalls[ RenderResourceManager::DEPTH_STENCIL_STATE_MAX ];
+
+		/// @name Construction/Destruction
+		//@{
+		Recorder();
+		//@}
+
+		/// @name Merging
+		//@{
+		void MergeInto( BufferedDrawer& rDrawer );
+
+		template< typename DrawCallType >
+		static void AppendDrawCalls(
+			DynamicArray< DrawCallType >& rDestination, DynamicArray< DrawCallType >& rSource, uint32_t vertexOffset,
+			uint32_t indexOffset );
+		//@}
+	};
 }
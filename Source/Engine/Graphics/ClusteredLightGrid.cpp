@@ -0,0 +1,513 @@
+#include "Precompile.h"
+#include "Graphics/ClusteredLightGrid.h"
+
+#include "MathSimd/Sphere.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/RTexture2d.h"
+#include "GraphicsTypes/GraphicsSceneLight.h"
+#include "GraphicsTypes/GraphicsSceneView.h"
+
+#include <cmath>
+
+using namespace Helium;
+
+const float32_t ClusteredLightGrid::INFINITE_FAR_SLICE_DISTANCE = 1000.0f;
+
+/// Distance of the first depth slice boundary for views with a near clip plane at (or very close to) the camera.
+static const float32_t MIN_SLICE_NEAR_DISTANCE = 0.01f;
+
+/// Number of texels in each row of the light data texture (view position, color, and spot direction).
+static const uint32_t LIGHT_TEXTURE_ROW_COUNT = 3;
+
+/// Compute the base-2 logarithm of a floating-point value.
+///
+/// @param[in] value  Value (must be greater than zero).
+///
+/// @return  Base-2 logarithm of the value.
+static float32_t LogBase2( float32_t value )
+{
+	return static_cast< float32_t >( std::log( value ) * 1.4426950408889634 );
+}
+
+/// Compute the view-space planes separating the tiles along one axis of the view.
+///
+/// The projection matrix elements given are those contributing to the clip-space coordinate along the axis
+/// (coordinate = axis * scale + z * zScale + offset) and to the clip-space w coordinate (w = z * wScale + wOffset).
+/// Each plane is normalized and oriented so that its distance is positive on the side of the higher tiles.
+///
+/// @param[in]  scale       Projection scale along the axis.
+/// @param[in]  zScale      Projection contribution of view-space depth to the axis.
+/// @param[in]  offset      Projection offset along the axis.
+/// @param[in]  wScale      Projection contribution of view-space depth to w.
+/// @param[in]  wOffset     Projection offset of w.
+/// @param[in]  tileCount   Number of tiles along the axis.
+/// @param[out] pPlanes     Array in which to store the axis, depth, and constant terms of the (tileCount - 1) planes.
+static void ComputeTilePlanes(
+	float32_t scale,
+	float32_t zScale,
+	float32_t offset,
+	float32_t wScale,
+	float32_t wOffset,
+	uint32_t tileCount,
+	float32_t ( *pPlanes )[ 3 ] )
+{
+	HELIUM_ASSERT( pPlanes );
+
+	float32_t tileSize = 2.0f / static_cast< float32_t >( tileCount );
+	for( uint32_t boundaryIndex = 1; boundaryIndex < tileCount; ++boundaryIndex )
+	{
+		float32_t boundary = static_cast< float32_t >( boundaryIndex ) * tileSize - 1.0f;
+
+		float32_t axisTerm = scale;
+		float32_t depthTerm = zScale - boundary * wScale;
+		float32_t constantTerm = offset - boundary * wOffset;
+
+		float32_t inverseLength = 1.0f / Sqrt( axisTerm * axisTerm + depthTerm * depthTerm );
+
+		float32_t* pPlane = pPlanes[ boundaryIndex - 1 ];
+		pPlane[ 0 ] = axisTerm * inverseLength;
+		pPlane[ 1 ] = depthTerm * inverseLength;
+		pPlane[ 2 ] = constantTerm * inverseLength;
+	}
+}
+
+/// Compute the range of tiles along one axis of the view overlapped by a view-space sphere.
+///
+/// @param[in]  pPlanes     Tile boundary planes computed by ComputeTilePlanes().
+/// @param[in]  tileCount   Number of tiles along the axis.
+/// @param[in]  axis        Sphere center coordinate along the axis.
+/// @param[in]  depth       Sphere center depth.
+/// @param[in]  radius      Sphere radius.
+/// @param[out] pTileRange  First and last tile overlapped by the sphere.
+static void ComputeTileRange(
+	const float32_t ( *pPlanes )[ 3 ],
+	uint32_t tileCount,
+	float32_t axis,
+	float32_t depth,
+	float32_t radius,
+	uint8_t* pTileRange )
+{
+	HELIUM_ASSERT( pPlanes );
+	HELIUM_ASSERT( pTileRange );
+
+	// Boundary planes are ordered from the lowest tile to the highest, so the tiles skipped on either side are simply
+	// the number of planes the sphere lies entirely beyond.
+	uint32_t minTile = 0;
+	uint32_t maxTile = tileCount - 1;
+	for( uint32_t planeIndex = 0; planeIndex < tileCount - 1; ++planeIndex )
+	{
+		const float32_t* pPlane = pPlanes[ planeIndex ];
+		float32_t distance = axis * pPlane[ 0 ] + depth * pPlane[ 1 ] + pPlane[ 2 ];
+		if( distance >= radius )
+		{
+			++minTile;
+		}
+		else if( distance <= -radius )
+		{
+			--maxTile;
+		}
+	}
+
+	pTileRange[ 0 ] = static_cast< uint8_t >( minTile );
+	pTileRange[ 1 ] = static_cast< uint8_t >( maxTile );
+}
+
+/// Compute the depth slice containing a given view-space depth.
+///
+/// @param[in] depth       View-space depth.
+/// @param[in] sliceScale  Depth slice scale computed by ClusteredLightGrid::GetDepthSliceParameters().
+/// @param[in] sliceBias   Depth slice bias computed by ClusteredLightGrid::GetDepthSliceParameters().
+///
+/// @return  Depth slice index.
+static uint32_t ComputeDepthSlice( float32_t depth, float32_t sliceScale, float32_t sliceBias )
+{
+	if( depth <= MIN_SLICE_NEAR_DISTANCE )
+	{
+		return 0;
+	}
+
+	float32_t slice = Floor( LogBase2( depth ) * sliceScale + sliceBias );
+	if( slice <= 0.0f )
+	{
+		return 0;
+	}
+
+	uint32_t lastSlice = ClusteredLightGrid::DEPTH_SLICE_COUNT - 1;
+	if( slice >= static_cast< float32_t >( lastSlice ) )
+	{
+		return lastSlice;
+	}
+
+	return static_cast< uint32_t >( slice );
+}
+
+/// Constructor.
+ClusteredLightGrid::ClusteredLightGrid()
+{
+}
+
+/// Destructor.
+ClusteredLightGrid::~ClusteredLightGrid()
+{
+}
+
+/// Gather the lights affecting a view and prepare for assigning them to clusters.
+///
+/// Lights are culled against the view frustum using their bounding spheres (spot lights are culled as spheres as
+/// well), transformed to view space, and the range of clusters overlapped by each is computed.  Only the first
+/// LIGHT_COUNT_MAX lights intersecting the view are kept.
+///
+/// @param[in] rView    Scene view.
+/// @param[in] rLights  Scene lights.
+///
+/// @see AssignDepthSlice(), EndAssignment()
+void ClusteredLightGrid::BeginAssignment(
+	const GraphicsSceneView& rView,
+	const SparseArray< GraphicsSceneLight >& rLights )
+{
+	m_lights.Resize( 0 );
+
+	size_t lightCount = rLights.GetSize();
+	if( lightCount == 0 )
+	{
+		return;
+	}
+
+	const Simd::Frustum& rFrustum = rView.GetFrustum();
+	const Simd::Matrix44& rInverseViewMatrix = rView.GetInverseViewMatrix();
+	const Simd::Matrix44& rProjectionMatrix = rView.GetProjectionMatrix();
+
+	float32_t sliceScale, sliceBias;
+	GetDepthSliceParameters( rView, sliceScale, sliceBias );
+
+	float32_t columnPlanes[ TILE_COUNT_X - 1 ][ 3 ];
+	ComputeTilePlanes(
+		rProjectionMatrix.GetElement( 0 ),
+		rProjectionMatrix.GetElement( 8 ),
+		rProjectionMatrix.GetElement( 12 ),
+		rProjectionMatrix.GetElement( 11 ),
+		rProjectionMatrix.GetElement( 15 ),
+		TILE_COUNT_X,
+		columnPlanes );
+
+	float32_t rowPlanes[ TILE_COUNT_Y - 1 ][ 3 ];
+	ComputeTilePlanes(
+		rProjectionMatrix.GetElement( 5 ),
+		rProjectionMatrix.GetElement( 9 ),
+		rProjectionMatrix.GetElement( 13 ),
+		rProjectionMatrix.GetElement( 11 ),
+		rProjectionMatrix.GetElement( 15 ),
+		TILE_COUNT_Y,
+		rowPlanes );
+
+	for( size_t lightIndex = 0; lightIndex < lightCount; ++lightIndex )
+	{
+		if( !rLights.IsElementValid( lightIndex ) )
+		{
+			continue;
+		}
+
+		if( m_lights.GetSize() >= LIGHT_COUNT_MAX )
+		{
+			break;
+		}
+
+		const GraphicsSceneLight& rLight = rLights[ lightIndex ];
+		float32_t radius = rLight.GetRadius();
+		float32_t brightness = rLight.GetBrightness();
+		if( radius <= 0.0f || brightness <= 0.0f )
+		{
+			continue;
+		}
+
+		const Simd::Vector3& rPosition = rLight.GetPosition();
+		if( !rFrustum.Intersects( Simd::Sphere( rPosition, radius ) ) )
+		{
+			continue;
+		}
+
+		Simd::Vector3 viewPosition;
+		rInverseViewMatrix.TransformPoint( rPosition, viewPosition );
+
+		float32_t x = viewPosition.GetElement( 0 );
+		float32_t y = viewPosition.GetElement( 1 );
+		float32_t z = viewPosition.GetElement( 2 );
+
+		ViewLight* pViewLight = m_lights.New();
+		HELIUM_ASSERT( pViewLight );
+
+		pViewLight->position[ 0 ] = x;
+		pViewLight->position[ 1 ] = y;
+		pViewLight->position[ 2 ] = z;
+		pViewLight->inverseRadius = 1.0f / radius;
+
+		const Color& rColor = rLight.GetColor();
+		pViewLight->color[ 0 ] = rColor.GetFloatR() * brightness;
+		pViewLight->color[ 1 ] = rColor.GetFloatG() * brightness;
+		pViewLight->color[ 2 ] = rColor.GetFloatB() * brightness;
+
+		if( rLight.GetType() == GraphicsSceneLight::TYPE_SPOT )
+		{
+			Simd::Vector3 viewDirection;
+			rInverseViewMatrix.TransformVector( rLight.GetDirection(), viewDirection );
+			pViewLight->direction[ 0 ] = viewDirection.GetElement( 0 );
+			pViewLight->direction[ 1 ] = viewDirection.GetElement( 1 );
+			pViewLight->direction[ 2 ] = viewDirection.GetElement( 2 );
+
+			// Cone attenuation is saturate( cos( angle ) * scale + offset ), ramping from zero at the outer angle to
+			// one at the inner angle.
+			float32_t cosInner = Cos( rLight.GetSpotInnerAngle() );
+			float32_t cosOuter = Cos( rLight.GetSpotOuterAngle() );
+			pViewLight->spotScale = 1.0f / Max( cosInner - cosOuter, 1.0e-4f );
+			pViewLight->spotOffset = -cosOuter * pViewLight->spotScale;
+		}
+		else
+		{
+			pViewLight->direction[ 0 ] = 0.0f;
+			pViewLight->direction[ 1 ] = 0.0f;
+			pViewLight->direction[ 2 ] = 1.0f;
+			pViewLight->spotScale = 0.0f;
+			pViewLight->spotOffset = 1.0f;
+		}
+
+		ComputeTileRange( columnPlanes, TILE_COUNT_X, x, z, radius, pViewLight->tileRangeX );
+		ComputeTileRange( rowPlanes, TILE_COUNT_Y, y, z, radius, pViewLight->tileRangeY );
+
+		pViewLight->sliceRange[ 0 ] = static_cast< uint8_t >( ComputeDepthSlice( z - radius, sliceScale, sliceBias ) );
+		pViewLight->sliceRange[ 1 ] = static_cast< uint8_t >( ComputeDepthSlice( z + radius, sliceScale, sliceBias ) );
+	}
+
+	if( m_clusterLightCounts.GetSize() != CLUSTER_COUNT )
+	{
+		m_clusterLightCounts.Resize( CLUSTER_COUNT );
+		m_clusterLightIndices.Resize( CLUSTER_COUNT * CLUSTER_LIGHT_COUNT_MAX );
+	}
+}
+
+/// Build the light lists of the clusters in a single depth slice.
+///
+/// Each depth slice only writes to its own clusters, so this can be called for all slices in parallel once
+/// BeginAssignment() has been called.
+///
+/// @param[in] sliceIndex  Index of the depth slice to update.
+///
+/// @see BeginAssignment(), EndAssignment()
+void ClusteredLightGrid::AssignDepthSlice( uint32_t sliceIndex )
+{
+	HELIUM_ASSERT( sliceIndex < DEPTH_SLICE_COUNT );
+
+	size_t lightCount = m_lights.GetSize();
+	if( lightCount == 0 )
+	{
+		return;
+	}
+
+	uint32_t sliceClusterStart = sliceIndex * TILE_COUNT_X * TILE_COUNT_Y;
+	uint8_t* pLightCounts = m_clusterLightCounts.GetData() + sliceClusterStart;
+	uint8_t* pLightIndices = m_clusterLightIndices.GetData() + sliceClusterStart * CLUSTER_LIGHT_COUNT_MAX;
+	MemoryZero( pLightCounts, TILE_COUNT_X * TILE_COUNT_Y );
+
+	for( size_t lightIndex = 0; lightIndex < lightCount; ++lightIndex )
+	{
+		const ViewLight& rLight = m_lights[ lightIndex ];
+		if( sliceIndex < rLight.sliceRange[ 0 ] || sliceIndex > rLight.sliceRange[ 1 ] )
+		{
+			continue;
+		}
+
+		for( uint32_t tileY = rLight.tileRangeY[ 0 ]; tileY <= rLight.tileRangeY[ 1 ]; ++tileY )
+		{
+			for( uint32_t tileX = rLight.tileRangeX[ 0 ]; tileX <= rLight.tileRangeX[ 1 ]; ++tileX )
+			{
+				uint32_t clusterIndex = tileY * TILE_COUNT_X + tileX;
+				uint8_t& rCount = pLightCounts[ clusterIndex ];
+				if( rCount < CLUSTER_LIGHT_COUNT_MAX )
+				{
+					pLightIndices[ clusterIndex * CLUSTER_LIGHT_COUNT_MAX + rCount ] = static_cast< uint8_t >( lightIndex );
+					++rCount;
+				}
+			}
+		}
+	}
+}
+
+/// Upload the light data and cluster light lists for rendering.
+///
+/// This must be called on the thread owning the renderer, after AssignDepthSlice() has completed for every depth
+/// slice.  Nothing is uploaded if no lights affect the view.  The light lists of all clusters are packed into the
+/// light index texture in order, and lists that no longer fit are truncated.
+///
+/// @see BeginAssignment(), AssignDepthSlice()
+void ClusteredLightGrid::EndAssignment()
+{
+	size_t lightCount = m_lights.GetSize();
+	if( lightCount == 0 )
+	{
+		return;
+	}
+
+	if( !CreateTextures() )
+	{
+		m_lights.Resize( 0 );
+
+		return;
+	}
+
+	// Upload the light data, one row per float4 of data for each light.
+	size_t pitch = 0;
+	uint8_t* pMappedData = static_cast< uint8_t* >(
+		m_spLightTexture->Map( 0, pitch, RENDERER_BUFFER_MAP_HINT_DISCARD ) );
+	HELIUM_ASSERT( pMappedData );
+
+	for( size_t lightIndex = 0; lightIndex < lightCount; ++lightIndex )
+	{
+		const ViewLight& rLight = m_lights[ lightIndex ];
+		for( uint32_t rowIndex = 0; rowIndex < LIGHT_TEXTURE_ROW_COUNT; ++rowIndex )
+		{
+			float32_t* pTexel = reinterpret_cast< float32_t* >( pMappedData + rowIndex * pitch ) + lightIndex * 4;
+			MemoryCopy( pTexel, &rLight.position[ 0 ] + rowIndex * 4, sizeof( float32_t ) * 4 );
+		}
+	}
+
+	m_spLightTexture->Unmap( 0 );
+
+	// Pack the light lists of each cluster into the index texture, and store the offset and size of each list in the
+	// cluster texture.  Each list starts on a new texel.
+	size_t clusterPitch = 0;
+	uint8_t* pClusterData = static_cast< uint8_t* >(
+		m_spClusterTexture->Map( 0, clusterPitch, RENDERER_BUFFER_MAP_HINT_DISCARD ) );
+	HELIUM_ASSERT( pClusterData );
+
+	size_t indexPitch = 0;
+	uint8_t* pIndexData = static_cast< uint8_t* >(
+		m_spLightIndexTexture->Map( 0, indexPitch, RENDERER_BUFFER_MAP_HINT_DISCARD ) );
+	HELIUM_ASSERT( pIndexData );
+
+	const uint32_t indexTexelCapacity = LIGHT_INDEX_TEXTURE_WIDTH * LIGHT_INDEX_TEXTURE_HEIGHT;
+	uint32_t indexTexelOffset = 0;
+
+	const uint8_t* pLightCounts = m_clusterLightCounts.GetData();
+	const uint8_t* pLightIndices = m_clusterLightIndices.GetData();
+
+	for( uint32_t sliceIndex = 0; sliceIndex < DEPTH_SLICE_COUNT; ++sliceIndex )
+	{
+		float32_t* pClusterTexel = reinterpret_cast< float32_t* >( pClusterData + sliceIndex * clusterPitch );
+		for( uint32_t tileIndex = 0; tileIndex < TILE_COUNT_X * TILE_COUNT_Y; ++tileIndex )
+		{
+			uint32_t clusterIndex = sliceIndex * TILE_COUNT_X * TILE_COUNT_Y + tileIndex;
+			uint32_t clusterLightCount = pLightCounts[ clusterIndex ];
+
+			uint32_t texelCount = ( clusterLightCount + 3 ) / 4;
+			if( texelCount > indexTexelCapacity - indexTexelOffset )
+			{
+				texelCount = indexTexelCapacity - indexTexelOffset;
+				clusterLightCount = texelCount * 4;
+			}
+
+			pClusterTexel[ 0 ] = static_cast< float32_t >( indexTexelOffset );
+			pClusterTexel[ 1 ] = static_cast< float32_t >( clusterLightCount );
+			pClusterTexel[ 2 ] = 0.0f;
+			pClusterTexel[ 3 ] = 0.0f;
+			pClusterTexel += 4;
+
+			const uint8_t* pClusterIndices = pLightIndices + clusterIndex * CLUSTER_LIGHT_COUNT_MAX;
+			for( uint32_t texelIndex = 0; texelIndex < texelCount; ++texelIndex )
+			{
+				uint32_t offset = indexTexelOffset + texelIndex;
+				float32_t* pIndexTexel = reinterpret_cast< float32_t* >(
+					pIndexData + ( offset / LIGHT_INDEX_TEXTURE_WIDTH ) * indexPitch ) +
+					( offset % LIGHT_INDEX_TEXTURE_WIDTH ) * 4;
+
+				for( uint32_t componentIndex = 0; componentIndex < 4; ++componentIndex )
+				{
+					uint32_t listIndex = texelIndex * 4 + componentIndex;
+					pIndexTexel[ componentIndex ] =
+						( listIndex < clusterLightCount ? static_cast< float32_t >( pClusterIndices[ listIndex ] ) : 0.0f );
+				}
+			}
+
+			indexTexelOffset += texelCount;
+		}
+	}
+
+	m_spLightIndexTexture->Unmap( 0 );
+	m_spClusterTexture->Unmap( 0 );
+}
+
+/// Compute the parameters for mapping view-space depth to a depth slice index in a given view.
+///
+/// Depth slices are spaced exponentially between the near and far clip planes, so the slice index of a given depth
+/// is floor( log2( depth ) * scale + bias ).  Views with an infinite far clip plane are sliced up to
+/// INFINITE_FAR_SLICE_DISTANCE past the near clip plane.  Depths outside the sliced range belong to the first or last
+/// slice.
+///
+/// @param[in]  rView   Scene view.
+/// @param[out] rScale  Depth slice scale.
+/// @param[out] rBias   Depth slice bias.
+void ClusteredLightGrid::GetDepthSliceParameters( const GraphicsSceneView& rView, float32_t& rScale, float32_t& rBias )
+{
+	float32_t nearClip = Max( rView.GetNearClip(), MIN_SLICE_NEAR_DISTANCE );
+	float32_t farClip = rView.GetFarClip();
+	if( farClip < 0.0f )
+	{
+		farClip = nearClip + INFINITE_FAR_SLICE_DISTANCE;
+	}
+
+	farClip = Max( farClip, nearClip * 2.0f );
+
+	float32_t logNear = LogBase2( nearClip );
+	float32_t logFar = LogBase2( farClip );
+
+	rScale = static_cast< float32_t >( DEPTH_SLICE_COUNT ) / ( logFar - logNear );
+	rBias = -logNear * rScale;
+}
+
+/// Create the textures used to upload the light data and cluster light lists if they do not already exist.
+///
+/// @return  True if all textures exist, false if creation failed.
+bool ClusteredLightGrid::CreateTextures()
+{
+	if( m_spLightTexture && m_spClusterTexture && m_spLightIndexTexture )
+	{
+		return true;
+	}
+
+	Renderer* pRenderer = Renderer::GetInstance();
+	if( !pRenderer )
+	{
+		return false;
+	}
+
+	m_spLightTexture = pRenderer->CreateTexture2d(
+		LIGHT_COUNT_MAX,
+		LIGHT_TEXTURE_ROW_COUNT,
+		1,
+		RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT,
+		RENDERER_BUFFER_USAGE_DYNAMIC );
+	m_spClusterTexture = pRenderer->CreateTexture2d(
+		TILE_COUNT_X * TILE_COUNT_Y,
+		DEPTH_SLICE_COUNT,
+		1,
+		RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT,
+		RENDERER_BUFFER_USAGE_DYNAMIC );
+	m_spLightIndexTexture = pRenderer->CreateTexture2d(
+		LIGHT_INDEX_TEXTURE_WIDTH,
+		LIGHT_INDEX_TEXTURE_HEIGHT,
+		1,
+		RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT,
+		RENDERER_BUFFER_USAGE_DYNAMIC );
+	if( !m_spLightTexture || !m_spClusterTexture || !m_spLightIndexTexture )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"ClusteredLightGrid::CreateTextures(): Failed to create clustered light textures.\n" );
+
+		m_spLightTexture.Release();
+		m_spClusterTexture.Release();
+		m_spLightIndexTexture.Release();
+
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/SparseArray.h"
+#include "Rendering/RRenderResource.h"
+
+namespace Helium
+{
+	class GraphicsSceneLight;
+	class GraphicsSceneView;
+
+	HELIUM_DECLARE_RPTR( RTexture2d );
+
+	/// View-space grid of light lists for clustered forward shading of dynamic point and spot lights.
+	///
+	/// The view frustum is split into screen-space tiles, and each tile is split into depth slices spaced
+	/// exponentially between the near and far clip planes.  Each frame, the lights intersecting the view are assigned
+	/// to every cluster their bounding sphere overlaps.  BeginAssignment() culls the lights and computes their cluster
+	/// bounds, AssignDepthSlice() builds the light lists of a single depth slice (and can run for all slices in
+	/// parallel), and EndAssignment() uploads the results for the base pass shaders.
+	///
+	/// The results are stored in three floating-point textures so that they can be read by shader model 3 pixel
+	/// shaders: the view-space data of each light, the offset and size of each cluster's light list, and the packed
+	/// light index lists of all clusters (four indices per texel).  These layouts must match the declarations in
+	/// Data/Shaders/Common.inl.
+	class HELIUM_GRAPHICS_API ClusteredLightGrid
+	{
+	public:
+		/// Number of tile columns across the view.
+		static const uint32_t TILE_COUNT_X = 16;
+		/// Number of tile rows across the view.
+		static const uint32_t TILE_COUNT_Y = 8;
+		/// Number of depth slices in each tile.
+		static const uint32_t DEPTH_SLICE_COUNT = 24;
+		/// Total number of clusters.
+		static const uint32_t CLUSTER_COUNT = TILE_COUNT_X * TILE_COUNT_Y * DEPTH_SLICE_COUNT;
+
+		/// Maximum number of lights affecting a single view (additional lights are ignored).
+		static const uint32_t LIGHT_COUNT_MAX = 256;
+		/// Maximum number of lights assigned to a single cluster (additional lights are ignored).
+		static const uint32_t CLUSTER_LIGHT_COUNT_MAX = 32;
+
+		/// Width of the light index texture, in texels.
+		static const uint32_t LIGHT_INDEX_TEXTURE_WIDTH = 1024;
+		/// Height of the light index texture, in texels.
+		static const uint32_t LIGHT_INDEX_TEXTURE_HEIGHT = 8;
+
+		/// Distance covered by the depth slices of views with an infinite far clip plane.
+		static const float32_t INFINITE_FAR_SLICE_DISTANCE;
+
+		/// @name Construction/Destruction
+		//@{
+		ClusteredLightGrid();
+		~ClusteredLightGrid();
+		//@}
+
+		/// @name Light Assignment
+		//@{
+		void BeginAssignment( const GraphicsSceneView& rView, const SparseArray< GraphicsSceneLight >& rLights );
+		void AssignDepthSlice( uint32_t sliceIndex );
+		void EndAssignment();
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline uint32_t GetLightCount() const;
+
+		inline RTexture2d* GetLightTexture() const;
+		inline RTexture2d* GetClusterTexture() const;
+		inline RTexture2d* GetLightIndexTexture() const;
+		//@}
+
+		/// @name Static Utility Functions
+		//@{
+		static void GetDepthSliceParameters( const GraphicsSceneView& rView, float32_t& rScale, float32_t& rBias );
+		//@}
+
+	private:
+		/// View-space light data.
+		struct ViewLight
+		{
+			/// View-space position.
+			float32_t position[ 3 ];
+			/// Inverse of the light radius.
+			float32_t inverseRadius;
+			/// Light color, scaled by the light brightness.
+			float32_t color[ 3 ];
+			/// Spot light cone attenuation scale (zero for point lights).
+			float32_t spotScale;
+			/// View-space spot light direction.
+			float32_t direction[ 3 ];
+			/// Spot light cone attenuation offset (one for point lights).
+			float32_t spotOffset;
+
+			/// First and last tile column overlapped by the light.
+			uint8_t tileRangeX[ 2 ];
+			/// First and last tile row overlapped by the light.
+			uint8_t tileRangeY[ 2 ];
+			/// First and last depth slice overlapped by the light.
+			uint8_t sliceRange[ 2 ];
+		};
+
+		/// Lights affecting the view.
+		DynamicArray< ViewLight > m_lights;
+		/// Number of lights assigned to each cluster.
+		DynamicArray< uint8_t > m_clusterLightCounts;
+		/// Indices of the lights assigned to each cluster (CLUSTER_LIGHT_COUNT_MAX entries per cluster).
+		DynamicArray< uint8_t > m_clusterLightIndices;
+
+		/// Texture holding the view-space data of each light.
+		RTexture2dPtr m_spLightTexture;
+		/// Texture holding the light list offset and size of each cluster.
+		RTexture2dPtr m_spClusterTexture;
+		/// Texture holding the light index lists of all clusters.
+		RTexture2dPtr m_spLightIndexTexture;
+
+		/// @name Private Utility Functions
+		//@{
+		bool CreateTextures();
+		//@}
+	};
+}
+
+#include "Graphics/ClusteredLightGrid.inl"
@@ -0,0 +1,40 @@
+namespace Helium
+{
+	/// Get the number of lights affecting the view as of the last call to BeginAssignment().
+	///
+	/// @return  Number of lights assigned to the grid.
+	uint32_t ClusteredLightGrid::GetLightCount() const
+	{
+		return static_cast< uint32_t >( m_lights.GetSize() );
+	}
+
+	/// Get the texture holding the view-space data of each light.
+	///
+	/// @return  Light data texture, or null if no lights have been uploaded yet.
+	///
+	/// @see GetClusterTexture(), GetLightIndexTexture()
+	RTexture2d* ClusteredLightGrid::GetLightTexture() const
+	{
+		return m_spLightTexture;
+	}
+
+	/// Get the texture holding the light list offset and size of each cluster.
+	///
+	/// @return  Cluster texture, or null if no lights have been uploaded yet.
+	///
+	/// @see GetLightTexture(), GetLightIndexTexture()
+	RTexture2d* ClusteredLightGrid::GetClusterTexture() const
+	{
+		return m_spClusterTexture;
+	}
+
+	/// Get the texture holding the light index lists of all clusters.
+	///
+	/// @return  Light index texture, or null if no lights have been uploaded yet.
+	///
+	/// @see GetLightTexture(), GetClusterTexture()
+	RTexture2d* ClusteredLightGrid::GetLightIndexTexture() const
+	{
+		return m_spLightIndexTexture;
+	}
+}
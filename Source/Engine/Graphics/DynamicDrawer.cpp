@@ -154,13 +154,11 @@ void DynamicDrawer::DrawScreenSpaceQuad(
 	bool bFlush )
 {
 	// Do nothing if we have no untextured dynamic buffers.
-	if ( !m_untexturedTriangles.m_spVertices )
+	if ( !m_untexturedTriangles.IsInitialized() )
 	{
 		return;
 	}
 
-	HELIUM_ASSERT( m_untexturedTriangles.m_spIndices );
-
 	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
 	HELIUM_ASSERT( pRenderResourceManager );
 
@@ -170,10 +168,10 @@ void DynamicDrawer::DrawScreenSpaceQuad(
 	RRenderCommandProxyPtr spCommandProxy = pRenderer->GetImmediateCommandProxy();
 	HELIUM_ASSERT( spCommandProxy );
 
-	// Flush the untextured dynamic buffers if we don't have enough space left in the vertex and index buffers for
-	// this quad.
-	if ( m_untexturedTriangles.m_vertexCountTotal > BUFFER_DIVISION_VERTEX_COUNT - 4 ||
-		m_untexturedTriangles.m_indexCountTotal > BUFFER_DIVISION_INDEX_COUNT - 6 )
+	// Flush the untextured dynamic buffers and move on to the next buffer chunk if we don't have enough space left in
+	// the current chunk for this quad.
+	if ( m_untexturedTriangles.m_vertexCountTotal > BUFFER_CHUNK_VERTEX_COUNT - 4 ||
+		m_untexturedTriangles.m_indexCountTotal > BUFFER_CHUNK_INDEX_COUNT - 6 )
 	{
 		FlushUntexturedTriangles( pRenderResourceManager, pRenderer, spCommandProxy, true );
 	}
@@ -236,7 +234,7 @@ void DynamicDrawer::DrawScreenSpaceQuad(
 	bool bFlush )
 {
 	// Do nothing if we have no dynamic buffers.
-	if ( !m_untexturedTriangles.m_spVertices )
+	if ( !m_untexturedTriangles.IsInitialized() )
 	{
 		return;
 	}
@@ -250,17 +248,23 @@ void DynamicDrawer::DrawScreenSpaceQuad(
 	RRenderCommandProxyPtr spCommandProxy = pRenderer->GetImmediateCommandProxy();
 	HELIUM_ASSERT( spCommandProxy );
 
-	// Attempt to find a textured triangle buffer set using the same texture as the one specified.  If one cannot be
-	// located, flush and use the one with the most triangles already set.
+	// Batch the quad with any pending quads using the same texture.  If there are none, use a textured triangle
+	// buffer set with nothing pending, or flush the one with the most pending triangles if all of them are in use.
+	size_t freeBufferSetIndex = Invalid< size_t >();
 	size_t largestUsedBufferSetIndex = 0;
-	uint32_t largestUsedBufferSetIndexCount = m_texturedTriangles[0].m_indexCountTotal;
+	uint32_t largestUsedBufferSetIndexCount = 0;
 
 	size_t bufferSetIndex;
 	for ( bufferSetIndex = 0; bufferSetIndex < HELIUM_ARRAY_COUNT( m_texturedTriangles ); ++bufferSetIndex )
 	{
-		uint32_t indexCount = m_texturedTriangles[bufferSetIndex].m_indexCountTotal;
+		uint32_t indexCount = m_texturedTriangles[bufferSetIndex].m_indexCountPending;
 		if ( indexCount == 0 )
 		{
+			if ( IsInvalid( freeBufferSetIndex ) )
+			{
+				freeBufferSetIndex = bufferSetIndex;
+			}
+
 			continue;
 		}
 
@@ -278,14 +282,24 @@ void DynamicDrawer::DrawScreenSpaceQuad(
 
 	if ( bufferSetIndex >= HELIUM_ARRAY_COUNT( m_texturedTriangles ) )
 	{
-		bufferSetIndex = largestUsedBufferSetIndex;
-		FlushTexturedTriangles( pRenderResourceManager, pRenderer, spCommandProxy, bufferSetIndex, true );
+		if ( IsValid( freeBufferSetIndex ) )
+		{
+			bufferSetIndex = freeBufferSetIndex;
+		}
+		else
+		{
+			// The flushed buffer set keeps writing to its current chunk after the triangles just drawn, so this does
+			// not wait on the GPU.
+			bufferSetIndex = largestUsedBufferSetIndex;
+			FlushTexturedTriangles( pRenderResourceManager, pRenderer, spCommandProxy, bufferSetIndex, false );
+		}
 	}
 
-	// Flush the buffers if we don't have enough space left in the vertex and index buffers for this quad.
-	BufferData< SimpleTexturedVertex, TexturedBufferFunctions, BUFFER_DIVISION_COUNT, BUFFER_DIVISION_VERTEX_COUNT, BUFFER_DIVISION_INDEX_COUNT >& rBufferData = m_texturedTriangles[bufferSetIndex];
-	if ( rBufferData.m_vertexCountTotal > BUFFER_DIVISION_VERTEX_COUNT - 4 ||
-		rBufferData.m_indexCountTotal > BUFFER_DIVISION_INDEX_COUNT - 6 )
+	// Flush the buffers and move on to the next buffer chunk if we don't have enough space left in the current chunk
+	// for this quad.
+	BufferData< SimpleTexturedVertex, TexturedBufferFunctions >& rBufferData = m_texturedTriangles[bufferSetIndex];
+	if ( rBufferData.m_vertexCountTotal > BUFFER_CHUNK_VERTEX_COUNT - 4 ||
+		rBufferData.m_indexCountTotal > BUFFER_CHUNK_INDEX_COUNT - 6 )
 	{
 		FlushTexturedTriangles( pRenderResourceManager, pRenderer, spCommandProxy, bufferSetIndex, true );
 	}
@@ -308,7 +322,7 @@ void DynamicDrawer::DrawScreenSpaceQuad(
 	pMappedVertices += sizeof( rVertex2 );
 	MemoryCopy( pMappedVertices, &rVertex3, sizeof( rVertex3 ) );
 
-	uint16_t startVertexIndex = static_cast<uint16_t>( m_untexturedTriangles.m_vertexCountTotal );
+	uint16_t startVertexIndex = static_cast<uint16_t>( rBufferData.m_vertexCountTotal );
 	*( pMappedIndices++ ) = startVertexIndex;
 	*( pMappedIndices++ ) = startVertexIndex + 1;
 	*( pMappedIndices++ ) = startVertexIndex + 2;
@@ -410,17 +424,17 @@ void DynamicDrawer::Shutdown()
 /// @param[in] pRenderResourceManager  Render resource manager instance.
 /// @param[in] pRenderer               Renderer interface.
 /// @param[in] pCommandProxy           Interface to use for issuing render commands.
-/// @param[in] bAdvanceDivision        True to advance to the next dynamic buffer division, false to continue writing
-///                                    vertex data to the current division.
+/// @param[in] bAdvanceChunk           True to advance to the next dynamic buffer chunk, false to continue writing
+///                                    vertex data to the current chunk.
 ///
 /// @see FlushTexturedTriangles()
 void DynamicDrawer::FlushUntexturedTriangles(
 	RenderResourceManager* pRenderResourceManager,
 	Renderer* pRenderer,
 	RRenderCommandProxy* pCommandProxy,
-	bool bAdvanceDivision )
+	bool bAdvanceChunk )
 {
-	m_untexturedTriangles.FlushTriangles( this, pRenderResourceManager, pRenderer, pCommandProxy, bAdvanceDivision );
+	m_untexturedTriangles.FlushTriangles( this, pRenderResourceManager, pRenderer, pCommandProxy, bAdvanceChunk );
 }
 
 /// Flush buffered drawing of textured triangles.
@@ -429,8 +443,8 @@ void DynamicDrawer::FlushUntexturedTriangles(
 /// @param[in] pRenderResourceManager  Render resource manager instance.
 /// @param[in] pCommandProxy           Interface to use for issuing render commands.
 /// @param[in] bufferSetIndex          Index of the textured triangle buffer set to flush.
-/// @param[in] bAdvanceDivision        True to advance to the next dynamic buffer division, false to continue writing
-///                                    vertex data to the current division.
+/// @param[in] bAdvanceChunk           True to advance to the next dynamic buffer chunk, false to continue writing
+///                                    vertex data to the current chunk.
 ///
 /// @see FlushUntexturedTriangles()
 void DynamicDrawer::FlushTexturedTriangles(
@@ -438,7 +452,7 @@ void DynamicDrawer::FlushTexturedTriangles(
 	Renderer* pRenderer,
 	RRenderCommandProxy* pCommandProxy,
 	size_t bufferSetIndex,
-	bool bAdvanceDivision )
+	bool bAdvanceChunk )
 {
 	HELIUM_ASSERT( bufferSetIndex < HELIUM_ARRAY_COUNT( m_texturedTriangles ) );
 
@@ -447,20 +461,15 @@ void DynamicDrawer::FlushTexturedTriangles(
 		pRenderResourceManager,
 		pRenderer,
 		pCommandProxy,
-		bAdvanceDivision );
+		bAdvanceChunk );
 }
 
 /// Constructor.
-template<
-	typename VertexType,
-	typename Functions,
-	uint32_t DivisionCount,
-	uint32_t DivisionVertexCount,
-	uint32_t DivisionIndexCount >
-	DynamicDrawer::BufferData< VertexType, Functions, DivisionCount, DivisionVertexCount, DivisionIndexCount >::BufferData()
+template< typename VertexType, typename Functions >
+DynamicDrawer::BufferData< VertexType, Functions >::BufferData()
 	: m_pMappedVertices( NULL )
 	, m_pMappedIndices( NULL )
-	, m_divisionIndex( 0 )
+	, m_chunkIndex( 0 )
 	, m_vertexCountTotal( 0 )
 	, m_indexCountTotal( 0 )
 	, m_vertexCountPending( 0 )
@@ -468,55 +477,29 @@ template<
 {
 }
 
-/// Allocate vertex and index buffers and initialize this buffer data object for use.
+/// Allocate the initial vertex and index buffer chunks and initialize this buffer data object for use.
 ///
 /// @return  True if initialization was successful, false if not.
 ///
 /// @see Cleanup()
-template<
-	typename VertexType,
-	typename Functions,
-	uint32_t DivisionCount,
-	uint32_t DivisionVertexCount,
-	uint32_t DivisionIndexCount >
-	bool DynamicDrawer::BufferData< VertexType, Functions, DivisionCount, DivisionVertexCount, DivisionIndexCount >::Initialize()
+template< typename VertexType, typename Functions >
+bool DynamicDrawer::BufferData< VertexType, Functions >::Initialize()
 {
 	Cleanup();
 
 	Renderer* pRenderer = Renderer::GetInstance();
 	HELIUM_ASSERT( pRenderer );
 
-	size_t vertexBufferSize = DivisionVertexCount * DivisionCount * sizeof( VertexType );
-	m_spVertices = pRenderer->CreateVertexBuffer( vertexBufferSize, RENDERER_BUFFER_USAGE_DYNAMIC );
-	HELIUM_ASSERT( m_spVertices );
-	if ( !m_spVertices )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"DynamicDrawer::BufferData::Initialize(): Failed to allocate vertex buffer of %" PRIuSZ " bytes.\n",
-			vertexBufferSize );
-
-		Cleanup();
-
-		return false;
-	}
-
-	size_t indexBufferSize = DivisionIndexCount * DivisionCount * sizeof( uint16_t );
-	m_spIndices = pRenderer->CreateIndexBuffer(
-		indexBufferSize,
-		RENDERER_BUFFER_USAGE_DYNAMIC,
-		RENDERER_INDEX_FORMAT_UINT16 );
-	HELIUM_ASSERT( m_spIndices );
-	if ( !m_spIndices )
+	m_chunks.Reserve( BUFFER_CHUNK_COUNT_MAX );
+	m_chunks.Resize( BUFFER_CHUNK_COUNT_INITIAL );
+	for ( size_t chunkIndex = 0; chunkIndex < BUFFER_CHUNK_COUNT_INITIAL; ++chunkIndex )
 	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"DynamicDrawer::BufferData::Initialize(): Failed to allocate index buffer of %" PRIuSZ " bytes.\n",
-			indexBufferSize );
-
-		Cleanup();
+		if ( !CreateChunk( pRenderer, m_chunks[chunkIndex] ) )
+		{
+			Cleanup();
 
-		return false;
+			return false;
+		}
 	}
 
 	return true;
@@ -525,85 +508,77 @@ template<
 /// Free all allocated resources and reset this object to its initial state.
 ///
 /// @see Initialize()
-template<
-	typename VertexType,
-	typename Functions,
-	uint32_t DivisionCount,
-	uint32_t DivisionVertexCount,
-	uint32_t DivisionIndexCount >
-	void DynamicDrawer::BufferData< VertexType, Functions, DivisionCount, DivisionVertexCount, DivisionIndexCount >::Cleanup()
+template< typename VertexType, typename Functions >
+void DynamicDrawer::BufferData< VertexType, Functions >::Cleanup()
 {
 	if ( m_pMappedVertices )
 	{
-		HELIUM_ASSERT( m_spVertices );
-		m_spVertices->Unmap();
+		HELIUM_ASSERT( m_chunkIndex < m_chunks.GetSize() );
+		HELIUM_ASSERT( m_chunks[m_chunkIndex].spVertices );
+		m_chunks[m_chunkIndex].spVertices->Unmap();
 		m_pMappedVertices = NULL;
 	}
 
 	if ( m_pMappedIndices )
 	{
-		HELIUM_ASSERT( m_spIndices );
-		m_spIndices->Unmap();
+		HELIUM_ASSERT( m_chunkIndex < m_chunks.GetSize() );
+		HELIUM_ASSERT( m_chunks[m_chunkIndex].spIndices );
+		m_chunks[m_chunkIndex].spIndices->Unmap();
 		m_pMappedIndices = NULL;
 	}
 
-	m_spVertices.Release();
-	m_spIndices.Release();
-
-	for ( size_t divisionIndex = 0; divisionIndex < HELIUM_ARRAY_COUNT( m_divisionFences ); ++divisionIndex )
-	{
-		m_divisionFences[divisionIndex].Release();
-	}
+	m_chunks.Clear();
 
-	m_divisionIndex = 0;
+	m_chunkIndex = 0;
 	m_vertexCountTotal = 0;
 	m_indexCountTotal = 0;
 	m_vertexCountPending = 0;
 	m_indexCountPending = 0;
 }
 
-/// Get mapped pointers to the vertex and index buffers in this buffer set.
+/// Get whether this buffer data object has been successfully initialized.
+///
+/// @return  True if buffer chunks have been allocated, false if not.
+template< typename VertexType, typename Functions >
+bool DynamicDrawer::BufferData< VertexType, Functions >::IsInitialized() const
+{
+	return !m_chunks.IsEmpty();
+}
+
+/// Get mapped pointers to the vertex and index buffers of the current buffer chunk.
 ///
 /// @param[in]  pRenderer         Renderer interface.
 /// @param[out] rpMappedVertices  Base address of the mapped vertex buffer.
 /// @param[out] rpMappedIndices   Base address of the mapped index buffer.
-template<
-	typename VertexType,
-	typename Functions,
-	uint32_t DivisionCount,
-	uint32_t DivisionVertexCount,
-	uint32_t DivisionIndexCount >
-	void DynamicDrawer::BufferData< VertexType, Functions, DivisionCount, DivisionVertexCount, DivisionIndexCount >::Map(
+template< typename VertexType, typename Functions >
+void DynamicDrawer::BufferData< VertexType, Functions >::Map(
 	Renderer* pRenderer,
 	uint8_t*& rpMappedVertices,
 	uint16_t*& rpMappedIndices )
 {
 	HELIUM_ASSERT( pRenderer );
-
-	ERendererBufferMapHint mapHint =
-		( m_divisionIndex == 0 ? RENDERER_BUFFER_MAP_HINT_DISCARD : RENDERER_BUFFER_MAP_HINT_NO_OVERWRITE );
+	HELIUM_UNREF( pRenderer );
 
 	if ( !m_pMappedVertices )
 	{
 		HELIUM_ASSERT( !m_pMappedIndices );
 
-		RFencePtr& rspDivisionFence = m_divisionFences[m_divisionIndex];
-		RFence* pDivisionFence = rspDivisionFence;
-		if ( pDivisionFence )
-		{
-			pRenderer->SyncFence( pDivisionFence );
-			rspDivisionFence.Release();
-		}
+		HELIUM_ASSERT( m_chunkIndex < m_chunks.GetSize() );
+		Chunk& rChunk = m_chunks[m_chunkIndex];
+
+		// AdvanceChunk() only moves on to chunks the GPU is no longer using, so mapping never needs to wait.
+		HELIUM_ASSERT( !rChunk.spFence );
 
-		HELIUM_ASSERT( m_spVertices );
-		m_pMappedVertices = static_cast<uint8_t*>( m_spVertices->Map( mapHint ) );
+		ERendererBufferMapHint mapHint =
+			( m_vertexCountTotal == 0 ? RENDERER_BUFFER_MAP_HINT_DISCARD : RENDERER_BUFFER_MAP_HINT_NO_OVERWRITE );
+
+		HELIUM_ASSERT( rChunk.spVertices );
+		m_pMappedVertices = static_cast<uint8_t*>( rChunk.spVertices->Map( mapHint ) );
 		HELIUM_ASSERT( m_pMappedVertices );
-		m_pMappedVertices += m_divisionIndex * DivisionVertexCount * sizeof( VertexType );
 
-		HELIUM_ASSERT( m_spIndices );
-		m_pMappedIndices = static_cast<uint16_t*>( m_spIndices->Map( mapHint ) );
+		HELIUM_ASSERT( rChunk.spIndices );
+		m_pMappedIndices = static_cast<uint16_t*>( rChunk.spIndices->Map( mapHint ) );
 		HELIUM_ASSERT( m_pMappedIndices );
-		m_pMappedIndices += m_divisionIndex * DivisionIndexCount;
 	}
 
 	rpMappedVertices = m_pMappedVertices;
@@ -616,20 +591,15 @@ template<
 /// @param[in] pRenderResourceManager  Render resource manager instance.
 /// @param[in] pRenderer               Renderer interface.
 /// @param[in] pCommandProxy           Interface to use for issuing render commands.
-/// @param[in] bAdvanceDivision        True to advance to the next dynamic buffer division, false to continue writing
-///                                    vertex data to the current division.
-template<
-	typename VertexType,
-	typename Functions,
-	uint32_t DivisionCount,
-	uint32_t DivisionVertexCount,
-	uint32_t DivisionIndexCount >
-	void DynamicDrawer::BufferData< VertexType, Functions, DivisionCount, DivisionVertexCount, DivisionIndexCount >::FlushTriangles(
+/// @param[in] bAdvanceChunk           True to advance to the next dynamic buffer chunk, false to continue writing
+///                                    vertex data to the current chunk.
+template< typename VertexType, typename Functions >
+void DynamicDrawer::BufferData< VertexType, Functions >::FlushTriangles(
 	DynamicDrawer* pDynamicDrawer,
 	RenderResourceManager* pRenderResourceManager,
 	Renderer* pRenderer,
 	RRenderCommandProxy* pCommandProxy,
-	bool bAdvanceDivision )
+	bool bAdvanceChunk )
 {
 	HELIUM_ASSERT( pDynamicDrawer );
 	HELIUM_ASSERT( pRenderer );
@@ -637,13 +607,15 @@ template<
 
 	if ( m_indexCountPending != 0 )
 	{
-		HELIUM_ASSERT( m_spVertices );
-		HELIUM_ASSERT( m_spIndices );
+		HELIUM_ASSERT( m_chunkIndex < m_chunks.GetSize() );
+		Chunk& rChunk = m_chunks[m_chunkIndex];
+		HELIUM_ASSERT( rChunk.spVertices );
+		HELIUM_ASSERT( rChunk.spIndices );
 		HELIUM_ASSERT( m_pMappedVertices );
 		HELIUM_ASSERT( m_pMappedIndices );
 
-		m_spVertices->Unmap();
-		m_spIndices->Unmap();
+		rChunk.spVertices->Unmap();
+		rChunk.spIndices->Unmap();
 		m_pMappedVertices = NULL;
 		m_pMappedIndices = NULL;
 
@@ -672,16 +644,16 @@ template<
 
 		uint32_t minIndexValue = m_vertexCountTotal - m_vertexCountPending;
 
-		uint32_t startIndex = m_divisionIndex * DivisionIndexCount + m_indexCountTotal - m_indexCountPending;
+		uint32_t startIndex = m_indexCountTotal - m_indexCountPending;
 
 		uint32_t stride = static_cast<uint32_t>( sizeof( VertexType ) );
 		uint32_t offset = 0;
-		pCommandProxy->SetVertexBuffers( 0, 1, &m_spVertices, &stride, &offset );
-		pCommandProxy->SetIndexBuffer( m_spIndices );
+		pCommandProxy->SetVertexBuffers( 0, 1, &rChunk.spVertices, &stride, &offset );
+		pCommandProxy->SetIndexBuffer( rChunk.spIndices );
 		m_functions.PrepareDraw( pDynamicDrawer, pCommandProxy, this );
 		pCommandProxy->DrawIndexed(
 			RENDERER_PRIMITIVE_TYPE_TRIANGLE_LIST,
-			m_divisionIndex * DivisionVertexCount,
+			0,
 			minIndexValue,
 			m_vertexCountPending,
 			startIndex,
@@ -693,17 +665,18 @@ template<
 
 	HELIUM_ASSERT( m_vertexCountPending == 0 );
 
-	if ( bAdvanceDivision )
+	if ( bAdvanceChunk )
 	{
 		if ( m_indexCountTotal != 0 )
 		{
-			RFencePtr& rspDivisionFence = m_divisionFences[m_divisionIndex];
-			HELIUM_ASSERT( !rspDivisionFence );
-			rspDivisionFence = pRenderer->CreateFence();
-			HELIUM_ASSERT( rspDivisionFence );
-			pCommandProxy->SetFence( rspDivisionFence );
-
-			m_divisionIndex = ( m_divisionIndex + 1 ) % DivisionCount;
+			HELIUM_ASSERT( m_chunkIndex < m_chunks.GetSize() );
+			RFencePtr& rspChunkFence = m_chunks[m_chunkIndex].spFence;
+			HELIUM_ASSERT( !rspChunkFence );
+			rspChunkFence = pRenderer->CreateFence();
+			HELIUM_ASSERT( rspChunkFence );
+			pCommandProxy->SetFence( rspChunkFence );
+
+			AdvanceChunk( pRenderer );
 			m_vertexCountTotal = 0;
 			m_indexCountTotal = 0;
 		}
@@ -712,6 +685,97 @@ template<
 	}
 }
 
+/// Allocate the vertex and index buffers for a buffer chunk.
+///
+/// @param[in]  pRenderer  Renderer interface.
+/// @param[out] rChunk     Chunk to initialize.
+///
+/// @return  True if the buffers were allocated successfully, false if not.
+template< typename VertexType, typename Functions >
+bool DynamicDrawer::BufferData< VertexType, Functions >::CreateChunk( Renderer* pRenderer, Chunk& rChunk )
+{
+	HELIUM_ASSERT( pRenderer );
+
+	size_t vertexBufferSize = BUFFER_CHUNK_VERTEX_COUNT * sizeof( VertexType );
+	rChunk.spVertices = pRenderer->CreateVertexBuffer( vertexBufferSize, RENDERER_BUFFER_USAGE_DYNAMIC );
+	HELIUM_ASSERT( rChunk.spVertices );
+	if ( !rChunk.spVertices )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"DynamicDrawer::BufferData::CreateChunk(): Failed to allocate vertex buffer of %" PRIuSZ " bytes.\n",
+			vertexBufferSize );
+
+		return false;
+	}
+
+	size_t indexBufferSize = BUFFER_CHUNK_INDEX_COUNT * sizeof( uint16_t );
+	rChunk.spIndices = pRenderer->CreateIndexBuffer(
+		indexBufferSize,
+		RENDERER_BUFFER_USAGE_DYNAMIC,
+		RENDERER_INDEX_FORMAT_UINT16 );
+	HELIUM_ASSERT( rChunk.spIndices );
+	if ( !rChunk.spIndices )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"DynamicDrawer::BufferData::CreateChunk(): Failed to allocate index buffer of %" PRIuSZ " bytes.\n",
+			indexBufferSize );
+
+		rChunk.spVertices.Release();
+
+		return false;
+	}
+
+	return true;
+}
+
+/// Move on to the next buffer chunk in the ring once the current chunk has been fenced.
+///
+/// If the GPU is still using the next chunk, a new chunk is inserted into the ring ahead of it instead of waiting.
+/// This only blocks on the GPU once the ring has grown to BUFFER_CHUNK_COUNT_MAX chunks (or a chunk could not be
+/// allocated).
+///
+/// @param[in] pRenderer  Renderer interface.
+template< typename VertexType, typename Functions >
+void DynamicDrawer::BufferData< VertexType, Functions >::AdvanceChunk( Renderer* pRenderer )
+{
+	HELIUM_ASSERT( pRenderer );
+	HELIUM_ASSERT( !m_pMappedVertices );
+	HELIUM_ASSERT( !m_pMappedIndices );
+
+	size_t chunkCount = m_chunks.GetSize();
+	HELIUM_ASSERT( m_chunkIndex < chunkCount );
+
+	size_t nextChunkIndex = ( m_chunkIndex + 1 ) % chunkCount;
+	RFence* pNextChunkFence = m_chunks[nextChunkIndex].spFence;
+	if ( pNextChunkFence && !pRenderer->TrySyncFence( pNextChunkFence ) )
+	{
+		if ( chunkCount < BUFFER_CHUNK_COUNT_MAX )
+		{
+			Chunk newChunk;
+			if ( CreateChunk( pRenderer, newChunk ) )
+			{
+				// Inserting right after the current chunk keeps the remaining chunks in the order they were fenced.
+				++m_chunkIndex;
+				m_chunks.Insert( m_chunkIndex, newChunk );
+
+				return;
+			}
+		}
+
+		HELIUM_TRACE(
+			TraceLevels::Debug,
+			"DynamicDrawer::BufferData::AdvanceChunk(): Waiting on the GPU for a buffer chunk (%" PRIuSZ " chunks in use).\n",
+			chunkCount );
+
+		pRenderer->SyncFence( pNextChunkFence );
+	}
+
+	m_chunks[nextChunkIndex].spFence.Release();
+	m_chunkIndex = nextChunkIndex;
+}
+
 /// Get the description for untextured vertices.
 ///
 /// @param[in] pRenderResourceManager  Render resource manager instance.
@@ -761,12 +825,7 @@ RPixelShader* DynamicDrawer::UntexturedBufferFunctions::GetPixelShader( DynamicD
 void DynamicDrawer::UntexturedBufferFunctions::PrepareDraw(
 	DynamicDrawer* /*pDynamicDrawer*/,
 	RRenderCommandProxy* /*pCommandProxy*/,
-	BufferData<
-	SimpleVertex,
-	UntexturedBufferFunctions,
-	BUFFER_DIVISION_COUNT,
-	BUFFER_DIVISION_VERTEX_COUNT,
-	BUFFER_DIVISION_INDEX_COUNT >* /*pBufferData*/ ) const
+	BufferData< SimpleVertex, UntexturedBufferFunctions >* /*pBufferData*/ ) const
 {
 	// Nothing needs to be done for untextured rendering.
 }
@@ -820,7 +879,7 @@ RPixelShader* DynamicDrawer::TexturedBufferFunctions::GetPixelShader( DynamicDra
 void DynamicDrawer::TexturedBufferFunctions::PrepareDraw(
 	DynamicDrawer* pDynamicDrawer,
 	RRenderCommandProxy* pCommandProxy,
-	BufferData< SimpleTexturedVertex, TexturedBufferFunctions, BUFFER_DIVISION_COUNT, BUFFER_DIVISION_VERTEX_COUNT, BUFFER_DIVISION_INDEX_COUNT >* pBufferData ) const
+	BufferData< SimpleTexturedVertex, TexturedBufferFunctions >* pBufferData ) const
 {
 	HELIUM_ASSERT( pDynamicDrawer );
 	HELIUM_ASSERT( pCommandProxy );
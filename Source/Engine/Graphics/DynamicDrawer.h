@@ -2,6 +2,7 @@
 
 #include "Graphics/Graphics.h"
 
+#include "Foundation/DynamicArray.h"
 #include "Rendering/RRenderResource.h"
 #include "GraphicsTypes/VertexTypes.h"
 
@@ -24,12 +25,15 @@ namespace Helium
 	class HELIUM_GRAPHICS_API DynamicDrawer : NonCopyable
 	{
 	public:
-		/// Number of vertices per dynamic buffer division.
-		static const uint32_t BUFFER_DIVISION_VERTEX_COUNT = 128 * 4;
-		/// Number of vertex indices per dynamic buffer division.
-		static const uint32_t BUFFER_DIVISION_INDEX_COUNT = 128 * 6;
-		/// Number of dynamic buffer divisions.
-		static const uint32_t BUFFER_DIVISION_COUNT = 8;
+		/// Number of vertices per dynamic buffer chunk.
+		static const uint32_t BUFFER_CHUNK_VERTEX_COUNT = 128 * 4;
+		/// Number of vertex indices per dynamic buffer chunk.
+		static const uint32_t BUFFER_CHUNK_INDEX_COUNT = 128 * 6;
+		/// Number of dynamic buffer chunks allocated up front for each buffer ring.
+		static const size_t BUFFER_CHUNK_COUNT_INITIAL = 4;
+		/// Maximum number of dynamic buffer chunks in each buffer ring (only once this is reached will filling a buffer
+		/// ring wait on the GPU).
+		static const size_t BUFFER_CHUNK_COUNT_MAX = 64;
 
 		/// Number of simultaneous textured triangle buffers.
 		static const size_t TEXTURED_TRIANGLE_BUFFER_COUNT = 4;
@@ -63,34 +67,43 @@ namespace Helium
 		//@}
 
 	private:
-		/// Dynamic primitive buffer information.
-		template<
-			typename VertexType, typename Functions, uint32_t DivisionCount, uint32_t DivisionVertexCount,
-			uint32_t DivisionIndexCount >
+		/// Dynamic primitive buffer ring.
+		///
+		/// Primitives are written to a ring of fixed-size vertex and index buffer chunks.  When a chunk is full, a fence
+		/// is issued for its draw calls and writing moves on to the next chunk in the ring.  If the GPU has not finished
+		/// with that chunk yet, a new chunk is inserted into the ring instead of waiting, so the ring grows to fit the
+		/// largest amount of dynamic geometry in flight.
+		template< typename VertexType, typename Functions >
 		class BufferData
 		{
 		public:
-			/// Vertex buffer.
-			RVertexBufferPtr m_spVertices;
-			/// Index buffer.
-			RIndexBufferPtr m_spIndices;
-			/// Mapped pointer for the vertex buffer data.
+			/// Vertex and index buffer chunk.
+			struct Chunk
+			{
+				/// Vertex buffer.
+				RVertexBufferPtr spVertices;
+				/// Index buffer.
+				RIndexBufferPtr spIndices;
+				/// Pending fence for draw calls using this chunk.
+				RFencePtr spFence;
+			};
+
+			/// Buffer chunks, in the order in which they are filled.
+			DynamicArray< Chunk > m_chunks;
+			/// Mapped pointer for the vertex buffer data of the current chunk.
 			uint8_t* m_pMappedVertices;
-			/// Mapped pointer for the index buffer data.
+			/// Mapped pointer for the index buffer data of the current chunk.
 			uint16_t* m_pMappedIndices;
 
-			/// Pending fences for draw calls for each buffer division.
-			RFencePtr m_divisionFences[DivisionCount];
-
-			/// Current buffer division.
-			uint32_t m_divisionIndex;
-			/// Total number of vertices in the current division.
+			/// Current buffer chunk.
+			size_t m_chunkIndex;
+			/// Total number of vertices in the current chunk.
 			uint32_t m_vertexCountTotal;
-			/// Total number of indices in the current division.
+			/// Total number of indices in the current chunk.
 			uint32_t m_indexCountTotal;
-			/// Unflushed number of vertices in the current division.
+			/// Unflushed number of vertices in the current chunk.
 			uint32_t m_vertexCountPending;
-			/// Unflushed number of indices in the current division.
+			/// Unflushed number of indices in the current chunk.
 			uint32_t m_indexCountPending;
 
 			/// Buffer utility functions.
@@ -106,10 +119,19 @@ namespace Helium
 			bool Initialize();
 			void Cleanup();
 
+			bool IsInitialized() const;
+
 			void Map( Renderer* pRenderer, uint8_t*& rpMappedVertices, uint16_t*& rpMappedIndices );
 			void FlushTriangles(
 				DynamicDrawer* pDynamicDrawer, RenderResourceManager* pRenderResourceManager, Renderer* pRenderer,
-				RRenderCommandProxy* pCommandProxy, bool bAdvanceDivision );
+				RRenderCommandProxy* pCommandProxy, bool bAdvanceChunk );
+			//@}
+
+		private:
+			/// @name Private Utility Functions
+			//@{
+			bool CreateChunk( Renderer* pRenderer, Chunk& rChunk );
+			void AdvanceChunk( Renderer* pRenderer );
 			//@}
 		};
 
@@ -125,7 +147,7 @@ namespace Helium
 
 			void PrepareDraw(
 				DynamicDrawer* pDynamicDrawer, RRenderCommandProxy* pCommandProxy,
-				BufferData< SimpleVertex, UntexturedBufferFunctions, BUFFER_DIVISION_COUNT, BUFFER_DIVISION_VERTEX_COUNT, BUFFER_DIVISION_INDEX_COUNT >* pBufferData ) const;
+				BufferData< SimpleVertex, UntexturedBufferFunctions >* pBufferData ) const;
 			//@}
 		};
 
@@ -141,15 +163,15 @@ namespace Helium
 
 			void PrepareDraw(
 				DynamicDrawer* pDynamicDrawer, RRenderCommandProxy* pCommandProxy,
-				BufferData< SimpleTexturedVertex, TexturedBufferFunctions, BUFFER_DIVISION_COUNT, BUFFER_DIVISION_VERTEX_COUNT, BUFFER_DIVISION_INDEX_COUNT >* pBufferData ) const;
+				BufferData< SimpleTexturedVertex, TexturedBufferFunctions >* pBufferData ) const;
 			//@}
 		};
 
 		/// Untextured triangle buffer.
-		BufferData< SimpleVertex, UntexturedBufferFunctions, BUFFER_DIVISION_COUNT, BUFFER_DIVISION_VERTEX_COUNT, BUFFER_DIVISION_INDEX_COUNT > m_untexturedTriangles;
+		BufferData< SimpleVertex, UntexturedBufferFunctions > m_untexturedTriangles;
 		/// Textured triangle buffers.
-		BufferData< SimpleTexturedVertex, TexturedBufferFunctions, BUFFER_DIVISION_COUNT, BUFFER_DIVISION_VERTEX_COUNT, BUFFER_DIVISION_INDEX_COUNT > m_texturedTriangles[TEXTURED_TRIANGLE_BUFFER_COUNT];
-		/// Textured triangle buffer textures.
+		BufferData< SimpleTexturedVertex, TexturedBufferFunctions > m_texturedTriangles[TEXTURED_TRIANGLE_BUFFER_COUNT];
+		/// Texture of the pending triangles in each textured triangle buffer.
 		RTexture2dPtr m_texturedTriangleTextures[TEXTURED_TRIANGLE_BUFFER_COUNT];
 
 		/// Active vertex description.
@@ -177,10 +199,10 @@ namespace Helium
 		//@{
 		void FlushUntexturedTriangles(
 			RenderResourceManager* pRenderResourceManager, Renderer* pRenderer, RRenderCommandProxy* pCommandProxy,
-			bool bAdvanceDivision );
+			bool bAdvanceChunk );
 		void FlushTexturedTriangles(
 			RenderResourceManager* pRenderResourceManager, Renderer* pRenderer, RRenderCommandProxy* pCommandProxy,
-			size_t bufferSetIndex, bool bAdvanceDivision );
+			size_t bufferSetIndex, bool bAdvanceChunk );
 		//@}
 	};
 }
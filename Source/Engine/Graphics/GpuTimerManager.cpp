@@ -0,0 +1,277 @@
+#include "Precompile.h"
+#include "Graphics/GpuTimerManager.h"
+
+#include "Engine/RenderStatistics.h"
+#include "Rendering/Renderer.h"
+#include "Rendering/RRenderCommandProxy.h"
+#include "Rendering/RTimerQuery.h"
+
+using namespace Helium;
+
+static uint32_t g_InitCount = 0;
+GpuTimerManager* GpuTimerManager::sm_pInstance = NULL;
+
+/// Constructor.
+GpuTimerManager::GpuTimerManager()
+	: m_currentFrameIndex( 0 )
+	, m_frequency( 0 )
+	, m_frameMilliseconds( 0.0f )
+{
+	for ( uint32_t frameIndex = 0; frameIndex < QUERY_FRAME_COUNT; ++frameIndex )
+	{
+		m_frames[frameIndex].timingCount = 0;
+	}
+}
+
+/// Destructor.
+GpuTimerManager::~GpuTimerManager()
+{
+	Cleanup();
+}
+
+/// Issue the query marking the start of a timed pass.
+///
+/// Passes are identified by the address of their name, which must therefore be a static string.  Passes timed more
+/// than once in a frame (i.e. once for each scene view) are reported as the sum of their timings.
+///
+/// @param[in] pCommandProxy  Immediate command proxy through which the pass rendering commands are issued.
+/// @param[in] pName          Pass name.
+///
+/// @return  Index of the timing to pass to EndPass(), or an invalid index if the pass could not be timed.
+///
+/// @see EndPass()
+uint32_t GpuTimerManager::BeginPass( RRenderCommandProxy* pCommandProxy, const char* pName )
+{
+	HELIUM_ASSERT( pCommandProxy );
+	HELIUM_ASSERT( pName );
+
+	FrameQueries& rFrame = m_frames[m_currentFrameIndex];
+
+	uint32_t timingIndex = rFrame.timingCount;
+	if ( timingIndex >= MAX_TIMING_COUNT )
+	{
+		return Invalid< uint32_t >();
+	}
+
+	RTimerQueryPtr& rspBeginQuery = rFrame.spBeginQueries[timingIndex];
+	RTimerQueryPtr& rspEndQuery = rFrame.spEndQueries[timingIndex];
+	if ( !rspBeginQuery || !rspEndQuery )
+	{
+		Renderer* pRenderer = Renderer::GetInstance();
+		HELIUM_ASSERT( pRenderer );
+
+		if ( !rspBeginQuery )
+		{
+			rspBeginQuery = pRenderer->CreateTimerQuery();
+		}
+
+		if ( !rspEndQuery )
+		{
+			rspEndQuery = pRenderer->CreateTimerQuery();
+		}
+
+		if ( !rspBeginQuery || !rspEndQuery )
+		{
+			return Invalid< uint32_t >();
+		}
+	}
+
+	pCommandProxy->IssueTimerQuery( rspBeginQuery );
+
+	rFrame.passNames[timingIndex] = pName;
+	rFrame.bEnded[timingIndex] = false;
+	rFrame.timingCount = timingIndex + 1;
+
+	return timingIndex;
+}
+
+/// Issue the query marking the end of a timed pass.
+///
+/// @param[in] pCommandProxy  Immediate command proxy through which the pass rendering commands are issued.
+/// @param[in] timingIndex    Timing index returned by BeginPass().  If this is invalid, this function does nothing.
+///
+/// @see BeginPass()
+void GpuTimerManager::EndPass( RRenderCommandProxy* pCommandProxy, uint32_t timingIndex )
+{
+	HELIUM_ASSERT( pCommandProxy );
+
+	if ( IsInvalid( timingIndex ) )
+	{
+		return;
+	}
+
+	FrameQueries& rFrame = m_frames[m_currentFrameIndex];
+	HELIUM_ASSERT( timingIndex < rFrame.timingCount );
+	HELIUM_ASSERT( !rFrame.bEnded[timingIndex] );
+
+	pCommandProxy->IssueTimerQuery( rFrame.spEndQueries[timingIndex] );
+	rFrame.bEnded[timingIndex] = true;
+}
+
+/// Close the current frame of timer queries and report the results of the oldest frame in flight.
+///
+/// This must be called once all passes of the frame have been issued, before RenderStatistics::EndFrame(), so that
+/// the results are included in the render statistics of the frame being closed.
+void GpuTimerManager::EndFrame()
+{
+	m_currentFrameIndex = ( m_currentFrameIndex + 1 ) % QUERY_FRAME_COUNT;
+
+	// The queries for the next frame were issued FRAME_LATENCY frames ago, so read their results before reusing them.
+	FrameQueries& rFrame = m_frames[m_currentFrameIndex];
+	ReadFrame( rFrame );
+	rFrame.timingCount = 0;
+}
+
+/// Get the GPU time of the most recent frame whose results have been read back.
+///
+/// This spans from the start of the first timed pass to the end of the last one, so it covers any untimed work in
+/// between as well.  As with the per-pass results, it trails the frame currently being issued by FRAME_LATENCY frames.
+///
+/// @return  GPU frame time, in milliseconds, or zero if the results of that frame were not available.
+///
+/// @see EndFrame()
+float32_t GpuTimerManager::GetFrameMilliseconds() const
+{
+	return m_frameMilliseconds;
+}
+
+/// Get the singleton GpuTimerManager instance.
+///
+/// @return  Pointer to the GpuTimerManager instance, or null if GPU timing is not supported.
+///
+/// @see Startup(), Shutdown()
+GpuTimerManager* GpuTimerManager::GetInstance()
+{
+	return sm_pInstance;
+}
+
+/// Create the singleton GpuTimerManager instance.
+///
+/// No instance is created if the renderer does not support timer queries.  This must be called after the renderer
+/// main context has been created.
+///
+/// @see Shutdown(), GetInstance()
+void GpuTimerManager::Startup()
+{
+	if ( ++g_InitCount == 1 )
+	{
+		HELIUM_ASSERT( !sm_pInstance );
+		sm_pInstance = new GpuTimerManager;
+		HELIUM_ASSERT( sm_pInstance );
+		if ( !sm_pInstance->Initialize() )
+		{
+			delete sm_pInstance;
+			sm_pInstance = NULL;
+		}
+	}
+}
+
+/// Destroy the singleton GpuTimerManager instance.
+///
+/// @see Startup(), GetInstance()
+void GpuTimerManager::Shutdown()
+{
+	if ( --g_InitCount == 0 )
+	{
+		delete sm_pInstance;
+		sm_pInstance = NULL;
+	}
+}
+
+/// Check for timer query support and get the timestamp frequency.
+///
+/// @return  True if GPU timing is supported, false if not.
+///
+/// @see Cleanup()
+bool GpuTimerManager::Initialize()
+{
+	Renderer* pRenderer = Renderer::GetInstance();
+	if ( !pRenderer || !pRenderer->SupportsAllFeatures( RENDERER_FEATURE_FLAG_TIMER_QUERY ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"GpuTimerManager::Initialize(): Timer queries not supported; GPU timing disabled.\n" );
+		return false;
+	}
+
+	m_frequency = pRenderer->GetTimerQueryFrequency();
+	if ( m_frequency == 0 )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"GpuTimerManager::Initialize(): Timer query frequency unavailable; GPU timing disabled.\n" );
+		return false;
+	}
+
+	return true;
+}
+
+/// Release all timer queries.
+///
+/// @see Initialize()
+void GpuTimerManager::Cleanup()
+{
+	for ( uint32_t frameIndex = 0; frameIndex < QUERY_FRAME_COUNT; ++frameIndex )
+	{
+		FrameQueries& rFrame = m_frames[frameIndex];
+		for ( uint32_t timingIndex = 0; timingIndex < MAX_TIMING_COUNT; ++timingIndex )
+		{
+			rFrame.spBeginQueries[timingIndex].Release();
+			rFrame.spEndQueries[timingIndex].Release();
+		}
+
+		rFrame.timingCount = 0;
+	}
+}
+
+/// Report the timings of a frame of queries to RenderStatistics.
+///
+/// The results are only reported if every query of the frame is available, so that partial frames are never mixed
+/// into the statistics; a frame that is not complete yet is dropped instead of waited on.
+///
+/// @param[in] rFrame  Frame of queries to read.
+void GpuTimerManager::ReadFrame( FrameQueries& rFrame )
+{
+	Renderer* pRenderer = Renderer::GetInstance();
+	HELIUM_ASSERT( pRenderer );
+
+	uint64_t beginTimestamps[ MAX_TIMING_COUNT ];
+	uint64_t endTimestamps[ MAX_TIMING_COUNT ];
+
+	m_frameMilliseconds = 0.0f;
+
+	uint32_t timingCount = rFrame.timingCount;
+	for ( uint32_t timingIndex = 0; timingIndex < timingCount; ++timingIndex )
+	{
+		if ( !rFrame.bEnded[timingIndex] ||
+			!pRenderer->TryGetTimerQueryTimestamp( rFrame.spBeginQueries[timingIndex], beginTimestamps[timingIndex] ) ||
+			!pRenderer->TryGetTimerQueryTimestamp( rFrame.spEndQueries[timingIndex], endTimestamps[timingIndex] ) )
+		{
+			return;
+		}
+	}
+
+	if ( timingCount == 0 )
+	{
+		return;
+	}
+
+	float32_t millisecondsPerTick = 1000.0f / static_cast< float32_t >( m_frequency );
+	uint64_t frameBeginTimestamp = beginTimestamps[0];
+	uint64_t frameEndTimestamp = endTimestamps[0];
+	for ( uint32_t timingIndex = 0; timingIndex < timingCount; ++timingIndex )
+	{
+		uint64_t beginTimestamp = beginTimestamps[timingIndex];
+		uint64_t endTimestamp = endTimestamps[timingIndex];
+		uint64_t ticks = ( endTimestamp > beginTimestamp ? endTimestamp - beginTimestamp : 0 );
+
+		RenderStatistics::RecordGpuTime(
+			rFrame.passNames[timingIndex],
+			static_cast< float32_t >( ticks ) * millisecondsPerTick );
+
+		frameBeginTimestamp = Min( frameBeginTimestamp, beginTimestamp );
+		frameEndTimestamp = Max( frameEndTimestamp, endTimestamp );
+	}
+
+	m_frameMilliseconds = static_cast< float32_t >( frameEndTimestamp - frameBeginTimestamp ) * millisecondsPerTick;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#include "Rendering/RRenderResource.h"
+
+namespace Helium
+{
+	class RRenderCommandProxy;
+
+	HELIUM_DECLARE_RPTR( RTimerQuery );
+
+	/// Manager for measuring the GPU time spent in each render pass.
+	///
+	/// Each timed pass is bracketed by a pair of timestamp queries, issued with BeginPass() and EndPass().  Queries are
+	/// pooled per frame and only read back FRAME_LATENCY frames after they were issued, so that reading them never
+	/// stalls the CPU waiting on the GPU.  If the results of a frame are still not available by then, that frame is
+	/// dropped rather than waited on.  Results are reported to RenderStatistics under the names of the timed passes,
+	/// and therefore appear in the render statistics of a later frame than the one they were measured in.
+	///
+	/// No manager instance is created if the renderer does not support timer queries.
+	class HELIUM_GRAPHICS_API GpuTimerManager : NonCopyable
+	{
+	public:
+		/// Number of frames between issuing timer queries and reading back their results.
+		static const uint32_t FRAME_LATENCY = 3;
+		/// Maximum number of passes that can be timed in a single frame.
+		static const uint32_t MAX_TIMING_COUNT = 32;
+
+		/// @name Timing
+		//@{
+		uint32_t BeginPass( RRenderCommandProxy* pCommandProxy, const char* pName );
+		void EndPass( RRenderCommandProxy* pCommandProxy, uint32_t timingIndex );
+
+		void EndFrame();
+
+		float32_t GetFrameMilliseconds() const;
+		//@}
+
+		/// @name Static Access
+		//@{
+		static GpuTimerManager* GetInstance();
+		static void Startup();
+		static void Shutdown();
+		//@}
+
+	private:
+		/// Number of frames of queries kept in flight.
+		static const uint32_t QUERY_FRAME_COUNT = FRAME_LATENCY + 1;
+
+		/// Timer queries of a single frame.
+		struct FrameQueries
+		{
+			/// Name of each pass timed (static strings).
+			const char* passNames[ MAX_TIMING_COUNT ];
+			/// Query issued at the start of each timed pass.
+			RTimerQueryPtr spBeginQueries[ MAX_TIMING_COUNT ];
+			/// Query issued at the end of each timed pass.
+			RTimerQueryPtr spEndQueries[ MAX_TIMING_COUNT ];
+			/// True for each timed pass for which EndPass() has been called.
+			bool bEnded[ MAX_TIMING_COUNT ];
+			/// Number of passes timed.
+			uint32_t timingCount;
+		};
+
+		/// Queries of each frame in flight.
+		FrameQueries m_frames[ QUERY_FRAME_COUNT ];
+		/// Index of the entry in m_frames for the current frame.
+		uint32_t m_currentFrameIndex;
+		/// Timestamp tick frequency, in ticks per second.
+		uint64_t m_frequency;
+		/// GPU time spent on the timed passes of the most recently read frame, in milliseconds (zero if that frame
+		/// was dropped).
+		float32_t m_frameMilliseconds;
+
+		/// Singleton instance.
+		static GpuTimerManager* sm_pInstance;
+
+		/// @name Construction/Destruction
+		//@{
+		GpuTimerManager();
+		~GpuTimerManager();
+		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		bool Initialize();
+		void Cleanup();
+
+		void ReadFrame( FrameQueries& rFrame );
+		//@}
+	};
+}
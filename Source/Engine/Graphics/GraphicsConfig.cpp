@@ -17,8 +17,15 @@ GraphicsConfig::GraphicsConfig()
 , m_maxAnisotropy( 0 )
 , m_shadowMode( EShadowMode::PCF_DITHERED )
 , m_shadowBufferSize( DEFAULT_SHADOW_BUFFER_SIZE )
+, m_textureStreamingBudget( DEFAULT_TEXTURE_STREAMING_BUDGET )
+, m_residencyBudget( 0 )
+, m_dynamicResolutionTargetMilliseconds( 0.0f )
+, m_dynamicResolutionMinScale( 0.5f )
 , m_bFullscreen( false )
 , m_bVsync( true )
+, m_bAdaptiveVsync( false )
+, m_frameRateLimit( 0 )
+, m_bPipelinedRendering( false )
 {
 }
 
@@ -33,8 +40,15 @@ void GraphicsConfig::PopulateMetaType( Reflect::MetaStruct& comp )
     comp.AddField( &GraphicsConfig::m_height, "m_Height" );
     comp.AddField( &GraphicsConfig::m_bFullscreen, "m_bFullscreen" );
     comp.AddField( &GraphicsConfig::m_bVsync, "m_bVsync" );
+    comp.AddField( &GraphicsConfig::m_bAdaptiveVsync, "m_bAdaptiveVsync" );
+    comp.AddField( &GraphicsConfig::m_frameRateLimit, "m_FrameRateLimit" );
+    comp.AddField( &GraphicsConfig::m_bPipelinedRendering, "m_bPipelinedRendering" );
     comp.AddField( &GraphicsConfig::m_textureFiltering, "m_TextureFiltering" );
     comp.AddField( &GraphicsConfig::m_maxAnisotropy, "m_MaxAnisotropy" );
     comp.AddField( &GraphicsConfig::m_shadowMode, "m_ShadowMode" );
     comp.AddField( &GraphicsConfig::m_shadowBufferSize, "m_ShadowBufferSize" );
+    comp.AddField( &GraphicsConfig::m_textureStreamingBudget, "m_TextureStreamingBudget" );
+    comp.AddField( &GraphicsConfig::m_residencyBudget, "m_ResidencyBudget" );
+    comp.AddField( &GraphicsConfig::m_dynamicResolutionTargetMilliseconds, "m_DynamicResolutionTargetMilliseconds" );
+    comp.AddField( &GraphicsConfig::m_dynamicResolutionMinScale, "m_DynamicResolutionMinScale" );
 }
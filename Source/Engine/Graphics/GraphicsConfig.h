@@ -62,6 +62,9 @@ namespace Helium
         /// Default shadow buffer size.
         static const uint32_t DEFAULT_SHADOW_BUFFER_SIZE = 1024;
 
+        /// Default texture streaming memory budget, in megabytes.
+        static const uint32_t DEFAULT_TEXTURE_STREAMING_BUDGET = 256;
+
         /// @name Construction/Destruction
         //@{
         GraphicsConfig();
@@ -81,8 +84,18 @@ namespace Helium
         inline EShadowMode GetShadowMode() const;
         inline uint32_t GetShadowBufferSize() const;
 
+        inline uint32_t GetTextureStreamingBudget() const;
+        inline uint32_t GetResidencyBudget() const;
+
+        inline float32_t GetDynamicResolutionTargetMilliseconds() const;
+        inline float32_t GetDynamicResolutionMinScale() const;
+
         inline bool GetFullscreen() const;
         inline bool GetVsync() const;
+        inline bool GetAdaptiveVsync() const;
+        inline uint32_t GetFrameRateLimit() const;
+
+        inline bool GetPipelinedRendering() const;
         //@}
 
     public:
@@ -101,10 +114,29 @@ namespace Helium
         /// Shadow buffer size (width/height, in texels).
         uint32_t m_shadowBufferSize;
 
+        /// Memory budget for streamed texture mip levels, in megabytes (zero to disable texture streaming and keep all
+        /// mip levels resident).
+        uint32_t m_textureStreamingBudget;
+        /// Memory budget for the data of loaded resources, in megabytes (zero to never evict resource data).
+        uint32_t m_residencyBudget;
+
+        /// GPU frame time that dynamic resolution scaling aims for, in milliseconds (zero to always render scene views
+        /// at full resolution).
+        float32_t m_dynamicResolutionTargetMilliseconds;
+        /// Smallest scale dynamic resolution scaling may apply to the width and height of scene views.
+        float32_t m_dynamicResolutionMinScale;
+
         /// True to run in fullscreen mode, false to run in windowed mode.
         bool m_bFullscreen;
         /// True to enable vsync.
         bool m_bVsync;
+        /// True to present late frames without waiting for the next vertical sync when vsync is enabled.
+        bool m_bAdaptiveVsync;
+        /// Maximum number of frames presented per second (zero for no limit).
+        uint32_t m_frameRateLimit;
+
+        /// True to render each frame on a dedicated render thread while the next gameplay frame is running.
+        bool m_bPipelinedRendering;
     };
 }
 
@@ -52,6 +52,38 @@ namespace Helium
         return m_shadowBufferSize;
     }
 
+    /// Get the memory budget for streamed texture mip levels.
+    ///
+    /// @return  Texture streaming budget, in megabytes, or zero if texture streaming is disabled.
+    uint32_t GraphicsConfig::GetTextureStreamingBudget() const
+    {
+        return m_textureStreamingBudget;
+    }
+
+    /// Get the memory budget for the data of loaded resources.
+    ///
+    /// @return  Resource residency budget, in megabytes, or zero if resource data is never evicted.
+    uint32_t GraphicsConfig::GetResidencyBudget() const
+    {
+        return m_residencyBudget;
+    }
+
+    /// Get the GPU frame time that dynamic resolution scaling aims for.
+    ///
+    /// @return  Target GPU frame time, in milliseconds, or zero if dynamic resolution scaling is disabled.
+    float32_t GraphicsConfig::GetDynamicResolutionTargetMilliseconds() const
+    {
+        return m_dynamicResolutionTargetMilliseconds;
+    }
+
+    /// Get the smallest scale dynamic resolution scaling may apply to scene views.
+    ///
+    /// @return  Minimum resolution scale, relative to the full viewport width and height.
+    float32_t GraphicsConfig::GetDynamicResolutionMinScale() const
+    {
+        return m_dynamicResolutionMinScale;
+    }
+
     /// Get whether fullscreen mode is enabled.
     ///
     /// @return  True if fullscreen mode is enabled, false if not.
@@ -67,4 +99,30 @@ namespace Helium
     {
         return m_bVsync;
     }
+
+    /// Get whether adaptive vsync is enabled.
+    ///
+    /// This only has an effect if vsync is enabled.
+    ///
+    /// @return  True if adaptive vsync is enabled, false if not.
+    bool GraphicsConfig::GetAdaptiveVsync() const
+    {
+        return m_bAdaptiveVsync;
+    }
+
+    /// Get the maximum number of frames presented per second.
+    ///
+    /// @return  Frame rate limit, or zero if the frame rate is not limited.
+    uint32_t GraphicsConfig::GetFrameRateLimit() const
+    {
+        return m_frameRateLimit;
+    }
+
+    /// Get whether rendering is pipelined with gameplay on a dedicated render thread.
+    ///
+    /// @return  True if pipelined rendering is enabled, false if not.
+    bool GraphicsConfig::GetPipelinedRendering() const
+    {
+        return m_bPipelinedRendering;
+    }
 }
@@ -1,9 +1,13 @@
 
 #include "Precompile.h"
 #include "Graphics/GraphicsManagerComponent.h"
+#include "Graphics/GpuTimerManager.h"
 #include "Graphics/GraphicsScene.h"
 #include "Graphics/RenderResourceManager.h"
+#include "Graphics/RenderThread.h"
+#include "Graphics/TextureStreamingManager.h"
 #include "Rendering/Renderer.h"
+#include "Engine/RenderStatistics.h"
 #include "Framework/TaskScheduler.h"
 #include "Framework/World.h"
 
@@ -13,7 +17,7 @@ HELIUM_DEFINE_CLASS( Helium::GraphicsManagerComponentDefinition );
 
 void GraphicsManagerComponentDefinition::PopulateMetaType( Reflect::MetaStruct& comp )
 {
-
+	comp.AddField( &GraphicsManagerComponentDefinition::m_shaderVariantManifestName, "m_ShaderVariantManifestName" );
 }
 
 GraphicsManagerComponentDefinition::GraphicsManagerComponentDefinition()
@@ -38,6 +42,11 @@ void GraphicsManagerComponent::Initialize( const GraphicsManagerComponentDefinit
 		return;
 	}
 
+	if ( !definition.m_shaderVariantManifestName.IsEmpty() )
+	{
+		m_spGraphicsScene->SetShaderVariantManifestName( definition.m_shaderVariantManifestName );
+	}
+
 	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
 	HELIUM_ASSERT( pRenderResourceManager );
 
@@ -84,4 +93,86 @@ HELIUM_DEFINE_TASK( GraphicsManagerDrawTask, ForEachWorld< DrawGraphics >, TickT
 void Helium::GraphicsManagerDrawTask::DefineContract( TaskContract &rContract )
 {
 	rContract.ExecutesWithin< Helium::StandardDependencies::Render >();
-}
\ No newline at end of file
+}
+
+static void UpdateTextureStreamingCommand( void* /*pData*/ )
+{
+	TextureStreamingManager* pStreamingManager = TextureStreamingManager::GetInstance();
+	if ( pStreamingManager )
+	{
+		pStreamingManager->Update();
+	}
+}
+
+void UpdateTextureStreaming( DynamicArray< WorldPtr > & )
+{
+	// Streaming swaps the render resources of textures, so it runs with rendering when rendering is pipelined.
+	RenderThread* pRenderThread = RenderThread::GetInstance();
+	if ( pRenderThread )
+	{
+		pRenderThread->QueueCommand( UpdateTextureStreamingCommand, NULL );
+	}
+	else
+	{
+		UpdateTextureStreamingCommand( NULL );
+	}
+}
+
+// Texture requests are made while drawing each world's graphics scene, so the streaming manager is updated once all
+// worlds have been drawn.
+HELIUM_DEFINE_TASK( TextureStreamingUpdateTask, UpdateTextureStreaming, TickTypes::Client )
+
+void Helium::TextureStreamingUpdateTask::DefineContract( TaskContract &rContract )
+{
+	rContract.ExecuteAfter< Helium::GraphicsManagerDrawTask >();
+	rContract.ExecutesWithin< Helium::StandardDependencies::Render >();
+}
+
+static void EndRenderStatisticsFrameCommand( void* /*pData*/ )
+{
+	// GPU timings read back this frame are reported before the frame is closed.
+	GpuTimerManager* pGpuTimerManager = GpuTimerManager::GetInstance();
+	if ( pGpuTimerManager )
+	{
+		pGpuTimerManager->EndFrame();
+
+		// Pick the scene resolution of the next frame from the GPU time just read back.
+		RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+		if ( pRenderResourceManager )
+		{
+			pRenderResourceManager->UpdateResolutionScale( pGpuTimerManager->GetFrameMilliseconds() );
+		}
+	}
+
+	// Pooled render targets are only held for a single frame.
+	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+	if ( pRenderResourceManager )
+	{
+		pRenderResourceManager->EndRenderTargetFrame();
+	}
+
+	RenderStatistics::EndFrame();
+}
+
+void EndRenderStatisticsFrame( DynamicArray< WorldPtr > & )
+{
+	RenderThread* pRenderThread = RenderThread::GetInstance();
+	if ( pRenderThread )
+	{
+		pRenderThread->QueueCommand( EndRenderStatisticsFrameCommand, NULL );
+	}
+	else
+	{
+		EndRenderStatisticsFrameCommand( NULL );
+	}
+}
+
+// All worlds are drawn on the same thread (the render thread if rendering is pipelined), so the render statistics
+// frame is closed once every scene has been drawn.
+HELIUM_DEFINE_TASK( RenderStatisticsEndFrameTask, EndRenderStatisticsFrame, TickTypes::Client )
+
+void Helium::RenderStatisticsEndFrameTask::DefineContract( TaskContract &rContract )
+{
+	rContract.ExecuteAfter< Helium::GraphicsManagerDrawTask >();
+	rContract.ExecutesWithin< Helium::StandardDependencies::Render >();
+}
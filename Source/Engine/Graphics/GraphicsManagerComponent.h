@@ -42,6 +42,10 @@ namespace Helium
 		static void PopulateMetaType( Reflect::MetaStruct& comp );
 
 		GraphicsManagerComponentDefinition();
+
+		/// Name of the shader variant manifest file used to warm up the shader variants used by this world (empty to
+		/// load shader variants only as they are first used).
+		Name m_shaderVariantManifestName;
 	};
 	typedef StrongPtr<GraphicsManagerComponentDefinition> GraphicsManagerComponentDefinitionPtr;
 
@@ -52,6 +56,20 @@ namespace Helium
 		HELIUM_DECLARE_TASK(GraphicsManagerDrawTask)
 		virtual void DefineContract(TaskContract &rContract);
 	};
+
+	struct HELIUM_GRAPHICS_API TextureStreamingUpdateTask : public TaskDefinition
+	{
+		HELIUM_DECLARE_TASK(TextureStreamingUpdateTask)
+		virtual void DefineContract(TaskContract &rContract);
+	};
+
+	struct HELIUM_GRAPHICS_API RenderStatisticsEndFrameTask : public TaskDefinition
+	{
+		HELIUM_DECLARE_TASK(RenderStatisticsEndFrameTask)
+		virtual void DefineContract(TaskContract &rContract);
+	};
 }
 
+HELIUM_CACHE_COMPONENT_SLOT( Helium::GraphicsManagerComponent, 1 )
+
 #include "Graphics/GraphicsManagerComponent.inl"
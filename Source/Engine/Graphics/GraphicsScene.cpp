@@ -1,10 +1,14 @@
 #include "Precompile.h"
 #include "Graphics/GraphicsScene.h"
+#include "Engine/FrameProfiler.h"
+#include "Engine/RenderStatistics.h"
+#include "Engine/ResidencyManager.h"
 
 #include "MathSimd/Plane.h"
 #include "MathSimd/Vector3Soa.h"
 #include "MathSimd/VectorConversion.h"
 #include "EngineJobs/EngineJobsInterface.h"
+#include "EngineJobs/JobManager.h"
 #include "Rendering/RConstantBuffer.h"
 #include "Rendering/RIndexBuffer.h"
 #include "Rendering/RPixelShader.h"
@@ -18,14 +22,22 @@
 #include "GraphicsTypes/VertexTypes.h"
 #include "GraphicsJobs/GraphicsJobsInterface.h"
 #include "Graphics/DynamicDrawer.h"
+#include "Graphics/GpuTimerManager.h"
 #include "Graphics/Material.h"
+#include "Graphics/RenderGraph.h"
 #include "Graphics/RenderResourceManager.h"
-#include "Graphics/Texture.h"
+#include "Graphics/RenderThread.h"
+#include "Graphics/ShaderVariantManifest.h"
+#include "Graphics/Texture2d.h"
+#include "Graphics/TextureStreamingManager.h"
 #include "Framework/World.h"
 #include "Framework/Entity.h"
 #include "Framework/Slice.h"
 #include "Framework/EntityDefinition.h"
 #include "Framework/WorldDefinition.h"
+#include "Engine/FileLocations.h"
+
+#include <cmath>
 
 HELIUM_DEFINE_CLASS( Helium::GraphicsScene );
 
@@ -37,9 +49,136 @@ HELIUM_DEFINE_COMPONENT( Helium::SceneObjectTransform, 32 );
 static const size_t SCENE_VIEW_BUFFERED_DRAWER_POOL_BLOCK_SIZE = 4;
 #endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 
-namespace Helium
+/// Size of each page of the per-frame instance vertex constant arena, in bytes (kept well under the largest constant
+/// buffer the renderers support).
+static const size_t INSTANCE_CONSTANT_PAGE_SIZE = 512 * 1024;
+/// Size of the slot assigned to each non-skinned scene object in the persistent object constant pages, in bytes.
+static const size_t OBJECT_CONSTANT_SLOT_SIZE =
+	( sizeof( float32_t ) * 12 + CONSTANT_BUFFER_OFFSET_ALIGNMENT - 1 ) & ~( CONSTANT_BUFFER_OFFSET_ALIGNMENT - 1 );
+/// Number of scene object slots in each persistent object constant page.
+static const size_t OBJECT_CONSTANT_PAGE_SLOT_COUNT = INSTANCE_CONSTANT_PAGE_SIZE / OBJECT_CONSTANT_SLOT_SIZE;
+
+/// Number of steps per doubling of size to which shadow view dimensions are rounded up.
+static const float32_t SHADOW_VIEW_SIZE_STEPS_PER_OCTAVE = 8.0f;
+/// Fraction of the shadow view dimensions by which its center is snapped.  The shadow view is enlarged by the same
+/// fraction so that it still covers the shadowed region.
+static const float32_t SHADOW_VIEW_CENTER_SNAP_FRACTION = 1.0f / 16.0f;
+
+/// Fraction by which the projected size of a scene object must exceed the switching size of its current level of
+/// detail before switching back to a finer level of detail.
+static const float32_t LOD_SCREEN_SIZE_HYSTERESIS = 0.15f;
+
+/// Render queue passes, stored in the highest bits of each render queue sort key.
+enum ERenderQueuePass
+{
+	RENDER_QUEUE_PASS_DEPTH,
+	RENDER_QUEUE_PASS_BASE,
+	RENDER_QUEUE_PASS_SHADOW,
+
+	RENDER_QUEUE_PASS_MAX
+};
+
+/// Bit offset of the pass in render queue sort keys.
+static const uint_fast32_t RENDER_QUEUE_PASS_SHIFT = 62;
+/// Number of bits used for the pass-specific sort value (depth, or material and vertex buffer IDs) in render queue
+/// sort keys.
+static const uint_fast32_t RENDER_QUEUE_VALUE_BITS = 30;
+/// Bit offset of the pass-specific sort value in render queue sort keys.
+static const uint_fast32_t RENDER_QUEUE_VALUE_SHIFT = 32;
+/// Mask for the sub-mesh index stored in the lowest bits of render queue sort keys.
+static const uint64_t RENDER_QUEUE_PAYLOAD_MASK = 0xffffffff;
+
+/// Number of bits used for the vertex buffer ID in base pass sort values.
+static const uint_fast32_t RENDER_QUEUE_VERTEX_BUFFER_ID_BITS = 16;
+/// Maximum vertex buffer ID in base pass sort values (later vertex buffers share this ID).
+static const size_t RENDER_QUEUE_VERTEX_BUFFER_ID_MAX = ( 1 << RENDER_QUEUE_VERTEX_BUFFER_ID_BITS ) - 1;
+/// Maximum material ID in base pass sort values (later materials share this ID).
+static const size_t RENDER_QUEUE_MATERIAL_ID_MAX =
+	( 1 << ( RENDER_QUEUE_VALUE_BITS - RENDER_QUEUE_VERTEX_BUFFER_ID_BITS ) ) - 1;
+
+/// Number of floating-point values stored for each instance in the instance vertex buffer (three rows of the
+/// transposed world transform).
+static const size_t INSTANCE_VERTEX_FLOAT_COUNT = 12;
+/// Size of each instance in the instance vertex buffer, in bytes.
+static const uint32_t INSTANCE_VERTEX_STRIDE =
+	static_cast<uint32_t>( sizeof( float32_t ) * INSTANCE_VERTEX_FLOAT_COUNT );
+
+/// Get whether a set of shader options includes a given vertex shader select.
+///
+/// @param[in] rOptions    Shader options to check.
+/// @param[in] selectName  Name of the select to find.
+///
+/// @return  True if the select is supported by the vertex shader, false if not.
+static bool HasVertexShaderSelect( const Shader::Options& rOptions, Name selectName )
+{
+	uint32_t vertexShaderTypeMask = ( 1 << RShader::TYPE_VERTEX );
+
+	const DynamicArray< Shader::Select >& rSelects = rOptions.GetSelects();
+	size_t selectCount = rSelects.GetSize();
+	for ( size_t selectIndex = 0; selectIndex < selectCount; ++selectIndex )
+	{
+		const Shader::Select& rSelect = rSelects[selectIndex];
+		if ( rSelect.name == selectName && ( rSelect.shaderTypeFlags & vertexShaderTypeMask ) )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/// Bind all of the material-specific state for drawing with a material: its constant buffers and the sampler states
+/// and textures of one of its binding blocks.
+///
+/// @param[in] pCommandProxy        Interface through which render commands should be issued.
+/// @param[in] pMaterial            Material being drawn.
+/// @param[in] rBlock               Material binding block for the pixel shader render resource in use.
+/// @param[in] ppSamplerStates      Sampler state to bind for each Material::BindingBlock::ESampler value.
+/// @param[in] ppSceneTextures      Texture to bind for each Material::BindingBlock::ESceneTexture value.
+static void SetMaterialBindings(
+	RRenderCommandProxy* pCommandProxy,
+	const Material* pMaterial,
+	const Material::BindingBlock& rBlock,
+	RSamplerState* const* ppSamplerStates,
+	RTexture* const* ppSceneTextures )
 {
-	HELIUM_DECLARE_RPTR( RRenderCommandProxy );
+	HELIUM_ASSERT( pCommandProxy );
+	HELIUM_ASSERT( pMaterial );
+	HELIUM_ASSERT( ppSamplerStates );
+	HELIUM_ASSERT( ppSceneTextures );
+
+	RConstantBuffer* pMaterialVertexConstantBuffer = pMaterial->GetConstantBuffer( RShader::TYPE_VERTEX );
+	RConstantBuffer* pMaterialPixelConstantBuffer = pMaterial->GetConstantBuffer( RShader::TYPE_PIXEL );
+	pCommandProxy->SetVertexConstantBuffers( 3, 1, &pMaterialVertexConstantBuffer );
+	pCommandProxy->SetPixelConstantBuffers( 1, 1, &pMaterialPixelConstantBuffer );
+
+	size_t samplerCount = rBlock.samplers.GetSize();
+	for ( size_t samplerIndex = 0; samplerIndex < samplerCount; ++samplerIndex )
+	{
+		const Material::BindingBlock::SamplerBinding& rBinding = rBlock.samplers[samplerIndex];
+		HELIUM_ASSERT( static_cast<size_t>( rBinding.sampler ) < Material::BindingBlock::SAMPLER_MAX );
+		pCommandProxy->SetSamplerStates( rBinding.bindIndex, 1, &ppSamplerStates[rBinding.sampler] );
+	}
+
+	size_t textureCount = rBlock.textures.GetSize();
+	for ( size_t textureIndex = 0; textureIndex < textureCount; ++textureIndex )
+	{
+		const Material::BindingBlock::TextureBinding& rBinding = rBlock.textures[textureIndex];
+
+		// Texture render resources can be replaced while streaming, so they are looked up at bind time.
+		RTexture* pTextureResource = NULL;
+		if ( rBinding.sceneTexture != Material::BindingBlock::SCENE_TEXTURE_NONE )
+		{
+			HELIUM_ASSERT( static_cast<size_t>( rBinding.sceneTexture ) < Material::BindingBlock::SCENE_TEXTURE_MAX );
+			pTextureResource = ppSceneTextures[rBinding.sceneTexture];
+		}
+		else if ( rBinding.pTexture )
+		{
+			pTextureResource = rBinding.pTexture->GetRenderResource();
+		}
+
+		pCommandProxy->SetTexture( rBinding.bindIndex, pTextureResource );
+	}
 }
 
 /// Constructor.
@@ -57,142 +196,93 @@ GraphicsScene::GraphicsScene()
 	, m_directionalLightColor( 0xffffffff )
 	, m_directionalLightBrightness( 1.0f )
 	, m_activeViewId( Invalid< uint32_t >() )
+	, m_pCachedShadowDepthTexture( NULL )
+	, m_cachedShadowViewIndex( Invalid< uint32_t >() )
+	, m_cachedShadowCasterSignature( 0 )
+	, m_bShadowDepthCacheValid( false )
+	, m_bPrepareShadowVisibility( false )
 	, m_constantBufferSetIndex( 0 )
+	, m_instanceVertexBufferCapacity( 0 )
+	, m_bBaseInstancingEnabled( false )
+	, m_recordingViewIndex( Invalid< uint_fast32_t >() )
+	, m_renderGraphViewIndex( Invalid< uint_fast32_t >() )
+	, m_renderGraphSceneTextureId( Invalid< uint32_t >() )
+	, m_renderGraphShadowDepthTextureId( Invalid< uint32_t >() )
+	, m_pShaderVariantManifest( NULL )
+	, m_bShaderVariantWarmupPending( false )
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+	, m_bufferedDrawerSetIndex( 0 )
+	, m_renderBufferedDrawerSetIndex( 0 )
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+	, m_renderFrameCondition( true, true )
+	, m_bRenderFramePending( false )
 {
 #if GRAPHICS_SCENE_BUFFERED_DRAWER
-	HELIUM_VERIFY( m_sceneBufferedDrawer.Initialize() );
+	for ( size_t setIndex = 0; setIndex < HELIUM_ARRAY_COUNT( m_sceneBufferedDrawers ); ++setIndex )
+	{
+		HELIUM_VERIFY( m_sceneBufferedDrawers[setIndex].Initialize() );
+	}
 #endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 }
 
 /// Destructor.
 GraphicsScene::~GraphicsScene()
 {
+	WaitForRenderFrame();
+
+	SaveShaderVariantManifest();
 }
 
 /// Update this graphics scene for the current frame.
+///
+/// The scene data needed for rendering is gathered from the world here (see ExtractFrame()).  If rendering is
+/// pipelined with gameplay (see RenderThread), the frame is then queued to be rendered on the render thread while
+/// the next gameplay frame runs, otherwise it is rendered immediately.
+///
+/// @param[in] pWorld  World whose scene object transforms to update.
+///
+/// @see WaitForRenderFrame()
 void GraphicsScene::Update( World *pWorld )
 {
-	// Check for lost devices.
-	Renderer* pRenderer = Renderer::GetInstance();
-	if ( !pRenderer )
-	{
-		return;
-	}
-
-	Renderer::EStatus rendererStatus = pRenderer->GetStatus();
-	if ( rendererStatus != Renderer::STATUS_READY )
-	{
-		if ( rendererStatus == Renderer::STATUS_NOT_RESET )
-		{
-			rendererStatus = pRenderer->Reset();
-		}
-
-		if ( rendererStatus != Renderer::STATUS_READY )
-		{
-			return;
-		}
-	}
-
-	// No need to update anything if we have no scene render texture or scene views.
-	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
-	HELIUM_ASSERT( pRenderResourceManager );
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::Update" );
 
-	RTexture2dPtr spSceneTexture = pRenderResourceManager->GetSceneTexture();
-	if ( !spSceneTexture )
-	{
-		return;
-	}
+	// The previous frame must be done rendering before the scene data it renders from is updated.
+	WaitForRenderFrame();
 
-	size_t sceneViewCount = m_sceneViews.GetSize();
-	if ( sceneViewCount == 0 )
+	if ( !ExtractFrame( pWorld ) )
 	{
 		return;
 	}
 
-	// Prepare the array of inverse view/projection matrices for each view's shadow depth pass.
-	if ( m_shadowViewInverseViewProjectionMatrices.GetSize() < sceneViewCount )
-	{
-		m_shadowViewInverseViewProjectionMatrices.Reserve( sceneViewCount );
-		m_shadowViewInverseViewProjectionMatrices.Resize( sceneViewCount );
-	}
-
-	// Update each scene view as necessary and compute their inverse view/projection matrices.
-	for ( size_t viewIndex = 0; viewIndex < sceneViewCount; ++viewIndex )
+	RenderThread* pRenderThread = RenderThread::GetInstance();
+	if ( pRenderThread )
 	{
-		if ( !m_sceneViews.IsElementValid( viewIndex ) )
-		{
-			continue;
-		}
-
-		m_sceneViews[viewIndex].ConditionalUpdate();
-		UpdateShadowInverseViewProjectionMatrixSimple( viewIndex );
+		m_renderFrameCondition.Reset();
+		m_bRenderFramePending = true;
+		pRenderThread->QueueCommand( RenderFrameCallback, this );
 	}
-
-	// Update each scene object as necessary.
-	size_t sceneObjectCount = m_sceneObjects.GetSize();
-	//for( size_t objectIndex = 0; objectIndex < sceneObjectCount; ++objectIndex )
-	//{
-	//    if( !m_sceneObjects.IsElementValid( objectIndex ) )
-	//    {
-	//        continue;
-	//    }
-
-	//    m_sceneObjects[ objectIndex ].ConditionalUpdate( this );
-	//}
-
-	for ( ImplementingComponentIterator<SceneObjectTransform> iter( *pWorld->m_ComponentManager ); *iter; iter.Advance() )
+	else
 	{
-		iter->GraphicsSceneObjectUpdate( this );
+		RenderFrame();
 	}
+}
 
-	// Swap dynamic constant buffers and update their contents.
-	SwapDynamicConstantBuffers();
-
-	// Resize the visible object bit array as necessary.
-	m_visibleSceneObjects.Reserve( sceneObjectCount );
-	m_visibleSceneObjects.Resize( sceneObjectCount );
-
-#if GRAPHICS_SCENE_BUFFERED_DRAWER
-	// Set up the scene's buffered drawer for the current frame.
-	m_sceneBufferedDrawer.BeginDrawing();
-#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
-
-	// Update and render each scene view.
-	for ( size_t viewIndex = 0; viewIndex < sceneViewCount; ++viewIndex )
+/// Block until this scene is no longer being rendered on the render thread.
+///
+/// Scene views, objects, sub-meshes, and lighting are read by the render thread while a frame is rendered, so this
+/// is called automatically before any of them are accessed or modified.  This returns immediately if rendering is not
+/// pipelined.
+///
+/// @see Update()
+void GraphicsScene::WaitForRenderFrame() const
+{
+	if ( m_bRenderFramePending )
 	{
-		if ( m_activeViewId != Invalid< uint32_t >() && viewIndex != m_activeViewId )
-		{
-			continue;
-		}
-
-#if GRAPHICS_SCENE_BUFFERED_DRAWER
-		// Set up the current view's buffered drawer for the current frame.
-		BufferedDrawer* pDrawer = NULL;
-		if ( viewIndex < m_viewBufferedDrawers.GetSize() )
-		{
-			pDrawer = m_viewBufferedDrawers[viewIndex];
-			if ( pDrawer )
-			{
-				pDrawer->BeginDrawing();
-			}
-		}
-#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+		HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::WaitForRenderFrame" );
 
-		DrawSceneView( static_cast<uint_fast32_t>( viewIndex ) );
-
-#if GRAPHICS_SCENE_BUFFERED_DRAWER
-		// Finish drawing with the current view's buffered drawer.
-		if ( pDrawer )
-		{
-			pDrawer->EndDrawing();
-		}
-#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+		m_renderFrameCondition.Wait();
+		m_bRenderFramePending = false;
 	}
-
-#if GRAPHICS_SCENE_BUFFERED_DRAWER
-	// Finish drawing with the scene's buffered drawer.
-	m_sceneBufferedDrawer.EndDrawing();
-#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 }
 
 /// Allocate a new scene view.
@@ -202,6 +292,8 @@ void GraphicsScene::Update( World *pWorld )
 /// @see ReleaseSceneView(), GetSceneView(), SetActiveSceneView()
 uint32_t GraphicsScene::AllocateSceneView()
 {
+	WaitForRenderFrame();
+
 	GraphicsSceneView* pSceneView = m_sceneViews.New();
 	HELIUM_ASSERT( pSceneView );
 
@@ -215,6 +307,8 @@ uint32_t GraphicsScene::AllocateSceneView()
 /// @see AllocateSceneView(), GetSceneView(), SetActiveSceneView()
 void GraphicsScene::ReleaseSceneView( uint32_t id )
 {
+	WaitForRenderFrame();
+
 	HELIUM_ASSERT( id < m_sceneViews.GetSize() );
 	HELIUM_ASSERT( m_sceneViews.IsElementValid( id ) );
 
@@ -227,14 +321,18 @@ void GraphicsScene::ReleaseSceneView( uint32_t id )
 
 	// Release any allocated buffered drawing interface for the view being released.
 #if GRAPHICS_SCENE_BUFFERED_DRAWER
-	if ( id < m_viewBufferedDrawers.GetSize() )
+	for ( size_t setIndex = 0; setIndex < HELIUM_ARRAY_COUNT( m_viewBufferedDrawers ); ++setIndex )
 	{
-		BufferedDrawer* pDrawer = m_viewBufferedDrawers[id];
-		if ( pDrawer )
+		DynamicArray< BufferedDrawer* >& rViewDrawers = m_viewBufferedDrawers[setIndex];
+		if ( id < rViewDrawers.GetSize() )
 		{
-			pDrawer->Shutdown();
-			m_viewBufferedDrawerPool.Release( pDrawer );
-			m_viewBufferedDrawers[id] = NULL;
+			BufferedDrawer* pDrawer = rViewDrawers[id];
+			if ( pDrawer )
+			{
+				pDrawer->Shutdown();
+				m_viewBufferedDrawerPool.Release( pDrawer );
+				rViewDrawers[id] = NULL;
+			}
 		}
 	}
 #endif // GRAPHICS_SCENE_BUFFERED_DRAWER
@@ -247,6 +345,8 @@ void GraphicsScene::ReleaseSceneView( uint32_t id )
 /// @see AllocateSceneView(), ReleaseSceneView(), GetSceneView()
 void GraphicsScene::SetActiveSceneView( uint32_t id )
 {
+	WaitForRenderFrame();
+
 	HELIUM_ASSERT( IsInvalid( id ) || ( id < m_sceneViews.GetSize() && m_sceneViews.IsElementValid( id ) ) );
 
 	m_activeViewId = id;
@@ -259,10 +359,20 @@ void GraphicsScene::SetActiveSceneView( uint32_t id )
 /// @see ReleaseSceneObject(), GetSceneObject()
 size_t GraphicsScene::AllocateSceneObject()
 {
+	WaitForRenderFrame();
+
 	GraphicsSceneObject* pSceneObject = m_sceneObjects.New();
 	HELIUM_ASSERT( pSceneObject );
 
-	return m_sceneObjects.GetElementIndex( pSceneObject );
+	size_t id = m_sceneObjects.GetElementIndex( pSceneObject );
+	pSceneObject->SetVisibilityGrid( &m_visibilityGrid, id );
+
+	if ( id >= m_sceneObjectSubMeshIds.GetSize() )
+	{
+		m_sceneObjectSubMeshIds.Resize( id + 1 );
+	}
+
+	return id;
 }
 
 /// Detach and release a previously allocated scene object.
@@ -272,9 +382,14 @@ size_t GraphicsScene::AllocateSceneObject()
 /// @see AllocateSceneObject(), GetSceneObject()
 void GraphicsScene::ReleaseSceneObject( size_t id )
 {
+	WaitForRenderFrame();
+
 	HELIUM_ASSERT( id < m_sceneObjects.GetSize() );
 	HELIUM_ASSERT( m_sceneObjects.IsElementValid( id ) );
 
+	m_visibilityGrid.Remove( id );
+	m_sceneObjectSubMeshIds[id].Clear();
+
 	m_sceneObjects.Remove( id );
 }
 
@@ -288,13 +403,18 @@ void GraphicsScene::ReleaseSceneObject( size_t id )
 /// @see ReleaseSceneObjectSubMeshData(), GetSceneObjectSubMeshData()
 size_t GraphicsScene::AllocateSceneObjectSubMeshData( size_t sceneObjectId )
 {
+	WaitForRenderFrame();
+
 	HELIUM_ASSERT( sceneObjectId < m_sceneObjects.GetSize() );
 	HELIUM_ASSERT( m_sceneObjects.IsElementValid( sceneObjectId ) );
 
 	GraphicsSceneObject::SubMeshData* pSubMeshData = m_sceneObjectSubMeshes.New( sceneObjectId );
 	HELIUM_ASSERT( pSubMeshData );
 
-	return m_sceneObjectSubMeshes.GetElementIndex( pSubMeshData );
+	size_t id = m_sceneObjectSubMeshes.GetElementIndex( pSubMeshData );
+	m_sceneObjectSubMeshIds[sceneObjectId].Push( id );
+
+	return id;
 }
 
 /// Detach and release previously allocated scene object sub-mesh data.
@@ -304,9 +424,23 @@ size_t GraphicsScene::AllocateSceneObjectSubMeshData( size_t sceneObjectId )
 /// @see AllocateScenObjectSubMeshData(), GetSceneObjectSubMeshData()
 void GraphicsScene::ReleaseSceneObjectSubMeshData( size_t id )
 {
+	WaitForRenderFrame();
+
 	HELIUM_ASSERT( id < m_sceneObjectSubMeshes.GetSize() );
 	HELIUM_ASSERT( m_sceneObjectSubMeshes.IsElementValid( id ) );
 
+	// The sub-mesh ID list will already be cleared if the parent scene object was released first.
+	DynamicArray< size_t >& rSubMeshIds = m_sceneObjectSubMeshIds[m_sceneObjectSubMeshes[id].GetSceneObjectId()];
+	size_t subMeshIdCount = rSubMeshIds.GetSize();
+	for ( size_t subMeshIdIndex = 0; subMeshIdIndex < subMeshIdCount; ++subMeshIdIndex )
+	{
+		if ( rSubMeshIds[subMeshIdIndex] == id )
+		{
+			rSubMeshIds.RemoveSwap( subMeshIdIndex );
+			break;
+		}
+	}
+
 	m_sceneObjectSubMeshes.Remove( id );
 }
 
@@ -325,6 +459,8 @@ void GraphicsScene::SetAmbientLight(
 	const Color& rBottomColor,
 	float32_t bottomBrightness )
 {
+	WaitForRenderFrame();
+
 	m_ambientLightTopColor = rTopColor;
 	m_ambientLightTopBrightness = topBrightness;
 	m_ambientLightBottomColor = rBottomColor;
@@ -340,6 +476,8 @@ void GraphicsScene::SetAmbientLight(
 /// @see GetDirectionalLightDirection(), GetDirectionalLightColor(), GetDirectionalLightBrightness()
 void GraphicsScene::SetDirectionalLight( const Simd::Vector3& rDirection, const Color& rColor, float32_t brightness )
 {
+	WaitForRenderFrame();
+
 	m_directionalLightDirection = rDirection;
 	m_directionalLightDirection.Normalize();
 
@@ -347,6 +485,36 @@ void GraphicsScene::SetDirectionalLight( const Simd::Vector3& rDirection, const
 	m_directionalLightBrightness = brightness;
 }
 
+/// Allocate a new dynamic point or spot light and add it to the scene.
+///
+/// @return  ID of the newly allocated light.
+///
+/// @see ReleaseLight(), GetLight()
+size_t GraphicsScene::AllocateLight()
+{
+	WaitForRenderFrame();
+
+	GraphicsSceneLight* pLight = m_lights.New();
+	HELIUM_ASSERT( pLight );
+
+	return m_lights.GetElementIndex( pLight );
+}
+
+/// Remove and release a previously allocated dynamic light.
+///
+/// @param[in] id  ID of the light to release.
+///
+/// @see AllocateLight(), GetLight()
+void GraphicsScene::ReleaseLight( size_t id )
+{
+	WaitForRenderFrame();
+
+	HELIUM_ASSERT( id < m_lights.GetSize() );
+	HELIUM_ASSERT( m_lights.IsElementValid( id ) );
+
+	m_lights.Remove( id );
+}
+
 #if GRAPHICS_SCENE_BUFFERED_DRAWER
 /// Get the buffered drawing interface for the specified scene view.
 ///
@@ -369,10 +537,11 @@ BufferedDrawer* GraphicsScene::GetSceneViewBufferedDrawer( uint32_t id )
 	// If a buffered drawer does not already exist for the specified view, allocate one from the object pool.
 	BufferedDrawer* pDrawer = NULL;
 
-	size_t viewBufferedDrawerCount = m_viewBufferedDrawers.GetSize();
+	DynamicArray< BufferedDrawer* >& rViewDrawers = m_viewBufferedDrawers[m_bufferedDrawerSetIndex];
+	size_t viewBufferedDrawerCount = rViewDrawers.GetSize();
 	if ( id < viewBufferedDrawerCount )
 	{
-		pDrawer = m_viewBufferedDrawers[id];
+		pDrawer = rViewDrawers[id];
 	}
 
 	if ( !pDrawer )
@@ -382,10 +551,10 @@ BufferedDrawer* GraphicsScene::GetSceneViewBufferedDrawer( uint32_t id )
 		{
 			if ( id >= viewBufferedDrawerCount )
 			{
-				m_viewBufferedDrawers.Add( NULL, id - viewBufferedDrawerCount + 1 );
+				rViewDrawers.Add( NULL, id - viewBufferedDrawerCount + 1 );
 			}
 
-			m_viewBufferedDrawers[id] = pDrawer;
+			rViewDrawers[id] = pDrawer;
 
 			HELIUM_VERIFY( pDrawer->Initialize() );
 		}
@@ -426,28 +595,68 @@ Name GraphicsScene::GetShadowMapTextureName()
 	return shadowMapTextureName;
 }
 
-/// Update the shadow depth pass inverse view/projection matrix for a given scene view.
+/// Get the reserved name for the clustered light data texture in material shaders.  Note that this must match the
+/// name given in Data/Shaders/Common.inl.
 ///
-/// @param[in] viewIndex  Index of the scene view for which to update the shadow depth pass transform matrix.
-void GraphicsScene::UpdateShadowInverseViewProjectionMatrixSimple( size_t viewIndex )
+/// @return  Clustered light data shader texture input name.
+///
+/// @see GetClusterGridTextureName(), GetClusterLightIndicesTextureName()
+Name GraphicsScene::GetClusterLightsTextureName()
 {
-	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
-	HELIUM_ASSERT( m_sceneViews.IsElementValid( viewIndex ) );
-	HELIUM_ASSERT( viewIndex < m_shadowViewInverseViewProjectionMatrices.GetSize() );
+	static Name clusterLightsTextureName( "_ClusterLights" );
 
-	// Compute the scene directional light's view basis for shadow calculation.
-	Simd::Vector3 shadowViewForward = m_directionalLightDirection;
-	Simd::Vector3 shadowViewUp( 0.0f, 1.0f, 0.0f );
+	return clusterLightsTextureName;
+}
 
-	Simd::Vector3 shadowViewRight;
-	shadowViewRight.CrossSet( shadowViewUp, shadowViewForward );
-	shadowViewRight.Normalize();
+/// Get the reserved name for the clustered light grid texture in material shaders.  Note that this must match the
+/// name given in Data/Shaders/Common.inl.
+///
+/// @return  Clustered light grid shader texture input name.
+///
+/// @see GetClusterLightsTextureName(), GetClusterLightIndicesTextureName()
+Name GraphicsScene::GetClusterGridTextureName()
+{
+	static Name clusterGridTextureName( "_ClusterGrid" );
 
-	shadowViewUp.CrossSet( shadowViewForward, shadowViewRight );
+	return clusterGridTextureName;
+}
 
-	// Compute the corners of the view frustum region affected by shadowing.
-	GraphicsSceneView& rView = m_sceneViews[viewIndex];
+/// Get the reserved name for the clustered light index list texture in material shaders.  Note that this must match
+/// the name given in Data/Shaders/Common.inl.
+///
+/// @return  Clustered light index list shader texture input name.
+///
+/// @see GetClusterLightsTextureName(), GetClusterGridTextureName()
+Name GraphicsScene::GetClusterLightIndicesTextureName()
+{
+	static Name clusterLightIndicesTextureName( "_ClusterLightIndices" );
+
+	return clusterLightIndicesTextureName;
+}
+
+/// Round a shadow view dimension up to the next of SHADOW_VIEW_SIZE_STEPS_PER_OCTAVE steps per power of two.
+///
+/// @param[in] size  Shadow view dimension.
+///
+/// @return  Rounded dimension.
+static float32_t SnapShadowViewSize( float32_t size )
+{
+	if ( size <= 0.0f )
+	{
+		return size;
+	}
+
+	float64_t step = std::ceil( std::log( size ) * 1.4426950408889634 * SHADOW_VIEW_SIZE_STEPS_PER_OCTAVE );
 
+	return static_cast<float32_t>( std::pow( 2.0, step / SHADOW_VIEW_SIZE_STEPS_PER_OCTAVE ) );
+}
+
+/// Compute the region of a scene view in which shadows are drawn.
+///
+/// @param[in]  rView     Scene view.
+/// @param[out] rFrustum  View frustum clipped to the shadow cutoff distance of the view.
+static void GetShadowReceiverFrustum( const GraphicsSceneView& rView, Simd::Frustum& rFrustum )
+{
 	float32_t shadowCutoffDistance = rView.GetShadowCutoffDistance();
 
 	const Simd::Matrix44& rViewMatrix = rView.GetViewMatrix();
@@ -458,35 +667,245 @@ void GraphicsScene::UpdateShadowInverseViewProjectionMatrixSimple( size_t viewIn
 
 	Simd::Plane shadowClipPlane( shadowClipNormal, shadowClipNormal.Dot( shadowClipPoint ) );
 
-	Simd::Frustum shadowClippedViewFrustum = rView.GetFrustum();
-	shadowClippedViewFrustum.SetFarClip( shadowClipPlane );
+	rFrustum = rView.GetFrustum();
+	rFrustum.SetFarClip( shadowClipPlane );
+}
 
-	HELIUM_SIMD_ALIGN_PRE float32_t shadowFrustumPointsX[
-		( 8 + ( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 ) ) & ~( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 )]
-			HELIUM_SIMD_ALIGN_POST;
-		HELIUM_SIMD_ALIGN_PRE float32_t shadowFrustumPointsY[
-			( 8 + ( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 ) ) & ~( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 )]
-				HELIUM_SIMD_ALIGN_POST;
-			HELIUM_SIMD_ALIGN_PRE float32_t shadowFrustumPointsZ[
-				( 8 + ( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 ) ) & ~( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 )]
-					HELIUM_SIMD_ALIGN_POST;
+/// Gather the scene data needed to render the current frame.
+///
+/// This is run on the main thread, and takes care of everything that reads from the world or may reset the
+/// renderer.  Once it returns, RenderFrame() only needs the scene's own data, which is left untouched until the next
+/// call to WaitForRenderFrame().
+///
+/// @param[in] pWorld  World whose scene object transforms to update.
+///
+/// @return  True if the frame should be rendered, false if there is nothing to render.
+///
+/// @see RenderFrame()
+bool GraphicsScene::ExtractFrame( World* pWorld )
+{
+	// Check for lost devices.
+	Renderer* pRenderer = Renderer::GetInstance();
+	if ( !pRenderer )
+	{
+		return false;
+	}
 
-				size_t cornerCount = shadowClippedViewFrustum.ComputeCornersSoa(
-					shadowFrustumPointsX,
-					shadowFrustumPointsY,
-					shadowFrustumPointsZ );
-				HELIUM_ASSERT( cornerCount == 8 );
-				HELIUM_UNREF( cornerCount );
+	Renderer::EStatus rendererStatus = pRenderer->GetStatus();
+	if ( rendererStatus != Renderer::STATUS_READY )
+	{
+		if ( rendererStatus == Renderer::STATUS_NOT_RESET )
+		{
+			rendererStatus = pRenderer->Reset();
+		}
 
-				// Project the view frustum corners onto the shadow viewing plane and compute the bounds needed to
-				// contain the frustum points.
-				Simd::Vector3Soa shadowViewXSoa( shadowViewRight );
-				Simd::Vector3Soa shadowViewYSoa( shadowViewUp );
+		if ( rendererStatus != Renderer::STATUS_READY )
+		{
+			return false;
+		}
 
-#if HELIUM_SIMD_SSE
-				Simd::Vector3Soa points;
+		// Render target contents don't survive a reset.
+		m_bShadowDepthCacheValid = false;
+	}
 
-				points.m_x = Helium::Simd::LoadAligned( shadowFrustumPointsX );
+	// Make any resource uploads deferred by the renderer for this frame.
+	pRenderer->ProcessResourceUploads();
+
+	// No need to update anything if we have no scene render texture or scene views.
+	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+	HELIUM_ASSERT( pRenderResourceManager );
+
+	RTexture2dPtr spSceneTexture = pRenderResourceManager->GetSceneTexture();
+	if ( !spSceneTexture )
+	{
+		return false;
+	}
+
+	// Keep warming up the shader variants from the manifest until they have all loaded.
+	if ( m_bShaderVariantWarmupPending )
+	{
+		HELIUM_ASSERT( m_pShaderVariantManifest );
+		m_bShaderVariantWarmupPending = !m_pShaderVariantManifest->TryFinishWarmup();
+	}
+
+	size_t sceneViewCount = m_sceneViews.GetSize();
+	if ( sceneViewCount == 0 )
+	{
+		return false;
+	}
+
+	// Prepare the array of inverse view/projection matrices for each view's shadow depth pass.
+	if ( m_shadowViewInverseViewProjectionMatrices.GetSize() < sceneViewCount )
+	{
+		m_shadowViewInverseViewProjectionMatrices.Reserve( sceneViewCount );
+		m_shadowViewInverseViewProjectionMatrices.Resize( sceneViewCount );
+	}
+
+	// Update each scene view as necessary and compute their inverse view/projection matrices.
+	for ( size_t viewIndex = 0; viewIndex < sceneViewCount; ++viewIndex )
+	{
+		if ( !m_sceneViews.IsElementValid( viewIndex ) )
+		{
+			continue;
+		}
+
+		m_sceneViews[viewIndex].ConditionalUpdate();
+		UpdateShadowInverseViewProjectionMatrixSimple( viewIndex );
+	}
+
+	// Update each scene object as necessary.
+	//size_t sceneObjectCount = m_sceneObjects.GetSize();
+	//for( size_t objectIndex = 0; objectIndex < sceneObjectCount; ++objectIndex )
+	//{
+	//    if( !m_sceneObjects.IsElementValid( objectIndex ) )
+	//    {
+	//        continue;
+	//    }
+
+	//    m_sceneObjects[ objectIndex ].ConditionalUpdate( this );
+	//}
+
+	for ( ImplementingComponentIterator<SceneObjectTransform> iter( *pWorld->m_ComponentManager ); *iter; iter.Advance() )
+	{
+		iter->GraphicsSceneObjectUpdate( this );
+	}
+
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+	// Render the draw calls buffered so far.  When pipelined, the next frame is buffered into the other set of drawers
+	// while this one is rendered.
+	m_renderBufferedDrawerSetIndex = m_bufferedDrawerSetIndex;
+	if ( RenderThread::GetInstance() )
+	{
+		m_bufferedDrawerSetIndex ^= 1;
+	}
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+
+	return true;
+}
+
+/// Render the frame gathered by the last call to ExtractFrame().
+///
+/// This is run on the render thread if rendering is pipelined, and on the main thread otherwise.
+///
+/// @see ExtractFrame()
+void GraphicsScene::RenderFrame()
+{
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::RenderFrame" );
+
+	// Swap dynamic constant buffers and update their contents.
+	SwapDynamicConstantBuffers();
+
+	// Determine what is visible in each view to render, and which dynamic lights affect each part of each view.
+	PrepareSceneViews();
+	AssignClusteredLights();
+
+	// Record how large each visible object is on screen for level of detail decisions made next frame, and let the
+	// texture streaming manager know which textures are about to be drawn, and at what size.
+	UpdateSceneObjectScreenSizes();
+	RequestStreamedTextures();
+
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+	BufferedDrawer& rSceneDrawer = m_sceneBufferedDrawers[m_renderBufferedDrawerSetIndex];
+	const DynamicArray< BufferedDrawer* >& rViewDrawers = m_viewBufferedDrawers[m_renderBufferedDrawerSetIndex];
+
+	// Queue the render statistics of the last frame if the overlay is enabled.
+	if ( RenderStatistics::IsOverlayEnabled() )
+	{
+		DrawRenderStatisticsOverlay();
+	}
+
+	// Set up the scene's buffered drawer for the current frame.
+	rSceneDrawer.BeginDrawing();
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+
+	// Update and render each scene view.
+	size_t sceneViewCount = m_sceneViews.GetSize();
+	for ( size_t viewIndex = 0; viewIndex < sceneViewCount; ++viewIndex )
+	{
+		if ( m_activeViewId != Invalid< uint32_t >() && viewIndex != m_activeViewId )
+		{
+			continue;
+		}
+
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+		// Set up the current view's buffered drawer for the current frame.
+		BufferedDrawer* pDrawer = NULL;
+		if ( viewIndex < rViewDrawers.GetSize() )
+		{
+			pDrawer = rViewDrawers[viewIndex];
+			if ( pDrawer )
+			{
+				pDrawer->BeginDrawing();
+			}
+		}
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+
+		DrawSceneView( static_cast<uint_fast32_t>( viewIndex ) );
+
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+		// Finish drawing with the current view's buffered drawer.
+		if ( pDrawer )
+		{
+			pDrawer->EndDrawing();
+		}
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+	}
+
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+	// Finish drawing with the scene's buffered drawer.
+	rSceneDrawer.EndDrawing();
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+}
+
+/// Update the shadow depth pass inverse view/projection matrix for a given scene view.
+///
+/// @param[in] viewIndex  Index of the scene view for which to update the shadow depth pass transform matrix.
+void GraphicsScene::UpdateShadowInverseViewProjectionMatrixSimple( size_t viewIndex )
+{
+	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
+	HELIUM_ASSERT( m_sceneViews.IsElementValid( viewIndex ) );
+	HELIUM_ASSERT( viewIndex < m_shadowViewInverseViewProjectionMatrices.GetSize() );
+
+	// Compute the scene directional light's view basis for shadow calculation.
+	Simd::Vector3 shadowViewForward = m_directionalLightDirection;
+	Simd::Vector3 shadowViewUp( 0.0f, 1.0f, 0.0f );
+
+	Simd::Vector3 shadowViewRight;
+	shadowViewRight.CrossSet( shadowViewUp, shadowViewForward );
+	shadowViewRight.Normalize();
+
+	shadowViewUp.CrossSet( shadowViewForward, shadowViewRight );
+
+	// Compute the corners of the view frustum region affected by shadowing.
+	Simd::Frustum shadowClippedViewFrustum;
+	GetShadowReceiverFrustum( m_sceneViews[viewIndex], shadowClippedViewFrustum );
+
+	HELIUM_SIMD_ALIGN_PRE float32_t shadowFrustumPointsX[
+		( 8 + ( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 ) ) & ~( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 )]
+			HELIUM_SIMD_ALIGN_POST;
+		HELIUM_SIMD_ALIGN_PRE float32_t shadowFrustumPointsY[
+			( 8 + ( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 ) ) & ~( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 )]
+				HELIUM_SIMD_ALIGN_POST;
+			HELIUM_SIMD_ALIGN_PRE float32_t shadowFrustumPointsZ[
+				( 8 + ( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 ) ) & ~( HELIUM_SIMD_SIZE / sizeof( float32_t ) - 1 )]
+					HELIUM_SIMD_ALIGN_POST;
+
+				size_t cornerCount = shadowClippedViewFrustum.ComputeCornersSoa(
+					shadowFrustumPointsX,
+					shadowFrustumPointsY,
+					shadowFrustumPointsZ );
+				HELIUM_ASSERT( cornerCount == 8 );
+				HELIUM_UNREF( cornerCount );
+
+				// Project the view frustum corners onto the shadow viewing plane and compute the bounds needed to
+				// contain the frustum points.
+				Simd::Vector3Soa shadowViewXSoa( shadowViewRight );
+				Simd::Vector3Soa shadowViewYSoa( shadowViewUp );
+
+#if HELIUM_SIMD_SIZE == 16
+				Simd::Vector3Soa points;
+
+				points.m_x = Helium::Simd::LoadAligned( shadowFrustumPointsX );
 				points.m_y = Helium::Simd::LoadAligned( shadowFrustumPointsY );
 				points.m_z = Helium::Simd::LoadAligned( shadowFrustumPointsZ );
 
@@ -507,15 +926,15 @@ void GraphicsScene::UpdateShadowInverseViewProjectionMatrixSimple( size_t viewIn
 				projectedMaxX = Helium::Simd::MaxF32( projectedMaxX, projectedX );
 				projectedMaxY = Helium::Simd::MaxF32( projectedMaxY, projectedY );
 
-				Helium::Simd::Register projectedMinXYLo = _mm_unpacklo_ps( projectedMinX, projectedMinY );
-				Helium::Simd::Register projectedMinXYHi = _mm_unpackhi_ps( projectedMinX, projectedMinY );
+				Helium::Simd::Register projectedMinXYLo = Helium::Simd::UnpackLow( projectedMinX, projectedMinY );
+				Helium::Simd::Register projectedMinXYHi = Helium::Simd::UnpackHigh( projectedMinX, projectedMinY );
 				Helium::Simd::Register projectedMinXY = Helium::Simd::MinF32( projectedMinXYLo, projectedMinXYHi );
-				projectedMinXY = Helium::Simd::MinF32( projectedMinXY, _mm_movehl_ps( projectedMinXY, projectedMinXY ) );
+				projectedMinXY = Helium::Simd::MinF32( projectedMinXY, Helium::Simd::MoveHighLow( projectedMinXY, projectedMinXY ) );
 
-				Helium::Simd::Register projectedMaxXYLo = _mm_unpacklo_ps( projectedMaxX, projectedMaxY );
-				Helium::Simd::Register projectedMaxXYHi = _mm_unpackhi_ps( projectedMaxX, projectedMaxY );
+				Helium::Simd::Register projectedMaxXYLo = Helium::Simd::UnpackLow( projectedMaxX, projectedMaxY );
+				Helium::Simd::Register projectedMaxXYHi = Helium::Simd::UnpackHigh( projectedMaxX, projectedMaxY );
 				Helium::Simd::Register projectedMaxXY = Helium::Simd::MaxF32( projectedMaxXYLo, projectedMaxXYHi );
-				projectedMaxXY = Helium::Simd::MaxF32( projectedMaxXY, _mm_movehl_ps( projectedMaxXY, projectedMaxXY ) );
+				projectedMaxXY = Helium::Simd::MaxF32( projectedMaxXY, Helium::Simd::MoveHighLow( projectedMaxXY, projectedMaxXY ) );
 
 				Helium::Simd::Register halfVec = Helium::Simd::SetSplatF32( 0.5f );
 
@@ -524,40 +943,54 @@ void GraphicsScene::UpdateShadowInverseViewProjectionMatrixSimple( size_t viewIn
 					halfVec );
 				Helium::Simd::Register projectedWidthHeight = Helium::Simd::SubtractF32( projectedMaxXY, projectedMinXY );
 
-				Helium::Simd::Register projectedCenterX = _mm_shuffle_ps(
-					projectedCenter,
-					projectedCenter,
-					_MM_SHUFFLE( 0, 0, 0, 0 ) );
-				Helium::Simd::Register projectedCenterY = _mm_shuffle_ps(
-					projectedCenter,
-					projectedCenter,
-					_MM_SHUFFLE( 1, 1, 1, 1 ) );
-				Helium::Simd::Register projectedCenterZ = Helium::Simd::SetSplatF32( -32767.0f );
-
-				Simd::Vector3 shadowViewOrigin = shadowViewRight * Simd::Vector3( projectedCenterX ) +
-					shadowViewUp * Simd::Vector3( projectedCenterY ) +
-					shadowViewForward * Simd::Vector3( projectedCenterZ );
+				HELIUM_SIMD_ALIGN_PRE float32_t shadowViewCenter[4] HELIUM_SIMD_ALIGN_POST;
+				Helium::Simd::StoreAligned( shadowViewCenter, projectedCenter );
 
 				HELIUM_SIMD_ALIGN_PRE float32_t shadowViewWidthHeight[4] HELIUM_SIMD_ALIGN_POST;
 				Helium::Simd::StoreAligned( shadowViewWidthHeight, projectedWidthHeight );
+#else
+#error Implement for other SIMD architectures.
+#endif  // HELIUM_SIMD_SIZE == 16
+
+				// Quantize the shadow view so that it only changes once the camera has moved or turned past a
+				// threshold.  This keeps shadow edges from crawling as the camera moves, and lets the shadow depth
+				// texture be reused across frames (see DrawShadowDepthPass()).
+				float32_t shadowViewWidth =
+					SnapShadowViewSize( shadowViewWidthHeight[0] ) / ( 1.0f - SHADOW_VIEW_CENTER_SNAP_FRACTION );
+				float32_t shadowViewHeight =
+					SnapShadowViewSize( shadowViewWidthHeight[1] ) / ( 1.0f - SHADOW_VIEW_CENTER_SNAP_FRACTION );
+
+				float32_t shadowViewSnapX = shadowViewWidth * SHADOW_VIEW_CENTER_SNAP_FRACTION;
+				float32_t shadowViewSnapY = shadowViewHeight * SHADOW_VIEW_CENTER_SNAP_FRACTION;
+				float32_t shadowViewCenterX = shadowViewCenter[0];
+				float32_t shadowViewCenterY = shadowViewCenter[1];
+				if ( shadowViewSnapX > 0.0f )
+				{
+					shadowViewCenterX = Floor( shadowViewCenterX / shadowViewSnapX + 0.5f ) * shadowViewSnapX;
+				}
+				if ( shadowViewSnapY > 0.0f )
+				{
+					shadowViewCenterY = Floor( shadowViewCenterY / shadowViewSnapY + 0.5f ) * shadowViewSnapY;
+				}
+
+				Simd::Vector3 shadowViewOrigin = shadowViewRight * shadowViewCenterX +
+					shadowViewUp * shadowViewCenterY +
+					shadowViewForward * -32767.0f;
 
 				Simd::Matrix44 projection(
 					Simd::Matrix44::INIT_ORTHOGONAL_PROJECTION,
-					shadowViewWidthHeight[0],
-					shadowViewWidthHeight[1],
+					shadowViewWidth,
+					shadowViewHeight,
 					0.0f,
 					65536.0f );
-#else
-#error Implement for other SIMD architectures.
-#endif  // HELIUM_SIMD_SSE
 
-				// Compute the inverse view matrix.
+				// Compute the inverse view matrix (the shadow view basis is orthonormal, so only a rigid inverse is needed).
 				Simd::Matrix44 inverseView(
 					RayToVector4( shadowViewRight ),
 					RayToVector4( shadowViewUp ),
 					RayToVector4( shadowViewForward ),
 					PointToVector4( shadowViewOrigin ) );
-				inverseView.Invert();
+				Simd::Matrix44::InvertRigidArray( &inverseView, &inverseView, 1 );
 
 				// Compute the combined inverse view/projection matrix.
 				m_shadowViewInverseViewProjectionMatrices[viewIndex].MultiplySet( inverseView, projection );
@@ -771,8 +1204,18 @@ void GraphicsScene::SwapDynamicConstantBuffers()
 			*( pMappedData++ ) = lightDir.GetElement( 2 );
 			*( pMappedData++ ) = 0.0f;
 
-			*( pMappedData++ ) = static_cast<float32_t>( rView.GetViewportWidth() ) * 0.5f;
-			*( pMappedData++ ) = static_cast<float32_t>( rView.GetViewportHeight() ) * 0.5f;
+			// The scene is rendered at the dynamic resolution, so screen positions in the scene passes are relative
+			// to the scaled viewport.
+			uint32_t sceneWidth;
+			uint32_t sceneHeight;
+			pRenderResourceManager->GetScaledViewportSize(
+				rView.GetViewportWidth(),
+				rView.GetViewportHeight(),
+				sceneWidth,
+				sceneHeight );
+
+			*( pMappedData++ ) = static_cast<float32_t>( sceneWidth ) * 0.5f;
+			*( pMappedData++ ) = static_cast<float32_t>( sceneHeight ) * 0.5f;
 			*( pMappedData++ ) = 0.0f;
 			*pMappedData = 0.0f;
 
@@ -835,7 +1278,7 @@ void GraphicsScene::SwapDynamicConstantBuffers()
 		spBuffer = rViewPixelBasePassDataBuffers[viewIndex];
 		if ( !spBuffer )
 		{
-			spBuffer = pRenderer->CreateConstantBuffer( sizeof( float32_t ) * 16, RENDERER_BUFFER_USAGE_DYNAMIC );
+			spBuffer = pRenderer->CreateConstantBuffer( sizeof( float32_t ) * 28, RENDERER_BUFFER_USAGE_DYNAMIC );
 			if ( !spBuffer )
 			{
 				HELIUM_TRACE(
@@ -869,7 +1312,29 @@ void GraphicsScene::SwapDynamicConstantBuffers()
 			*( pMappedData++ ) = inverseShadowMapResolutionX;
 			*( pMappedData++ ) = inverseShadowMapResolutionY;
 			*( pMappedData++ ) = 0.0f;
-			*pMappedData = 0.0f;
+			*( pMappedData++ ) = 0.0f;
+
+			// Projection terms for locating the clustered light grid cell of view-space positions.
+			GraphicsSceneView& rView = m_sceneViews[viewIndex];
+			const Simd::Matrix44& rProjectionMatrix = rView.GetProjectionMatrix();
+
+			float32_t depthSliceScale, depthSliceBias;
+			ClusteredLightGrid::GetDepthSliceParameters( rView, depthSliceScale, depthSliceBias );
+
+			*( pMappedData++ ) = rProjectionMatrix.GetElement( 0 );
+			*( pMappedData++ ) = rProjectionMatrix.GetElement( 8 );
+			*( pMappedData++ ) = rProjectionMatrix.GetElement( 12 );
+			*( pMappedData++ ) = 0.0f;
+
+			*( pMappedData++ ) = rProjectionMatrix.GetElement( 5 );
+			*( pMappedData++ ) = rProjectionMatrix.GetElement( 9 );
+			*( pMappedData++ ) = rProjectionMatrix.GetElement( 13 );
+			*( pMappedData++ ) = 0.0f;
+
+			*( pMappedData++ ) = rProjectionMatrix.GetElement( 11 );
+			*( pMappedData++ ) = rProjectionMatrix.GetElement( 15 );
+			*( pMappedData++ ) = depthSliceScale;
+			*pMappedData = depthSliceBias;
 
 			spBuffer->Unmap();
 		}
@@ -918,24 +1383,19 @@ void GraphicsScene::SwapDynamicConstantBuffers()
 		}
 	}
 
-	// Map each instance constant buffer for updating.
-	DynamicArray< RConstantBufferPtr >& rStaticInstanceVertexGlobalDataBufferPool =
-		m_staticInstanceVertexGlobalDataBufferPool[bufferSetIndex];
-	DynamicArray< RConstantBufferPtr >& rSkinnedInstanceVertexGlobalDataBufferPool =
-		m_skinnedInstanceVertexGlobalDataBufferPool[bufferSetIndex];
-	HELIUM_UNREF( rSkinnedInstanceVertexGlobalDataBufferPool );
+	// Non-skinned scene objects keep their transform constants in a fixed slot of the persistent object pages, so
+	// only objects whose transform changed since their slot was last written need updating.  Skinned sub-meshes
+	// change every frame, so each is allocated a range of the per-frame instance constant arena instead.  Ranges are
+	// aligned for binding by offset, and each page is mapped once instead of mapping a buffer per instance.
+	// Consecutive sub-meshes of the same object with identical palette maps share a single range, which every pass
+	// drawing them binds.
+	InstanceConstantRange invalidRange;
+	SetInvalid( invalidRange.pageIndex );
+	invalidRange.offset = 0;
 
 	size_t sceneObjectCount = m_sceneObjects.GetSize();
-	size_t instanceBufferCount = m_objectVertexGlobalDataBuffers.GetSize();
-	if ( instanceBufferCount < sceneObjectCount )
-	{
-		MemoryZero( m_objectVertexGlobalDataBuffers.GetData(), instanceBufferCount * sizeof( RConstantBuffer* ) );
-		m_objectVertexGlobalDataBuffers.Add( NULL, sceneObjectCount - instanceBufferCount );
-	}
-	else
-	{
-		MemoryZero( m_objectVertexGlobalDataBuffers.GetData(), sceneObjectCount * sizeof( RConstantBuffer* ) );
-	}
+	m_objectVertexGlobalDataRanges.Resize( 0 );
+	m_objectVertexGlobalDataRanges.Add( invalidRange, sceneObjectCount );
 
 	size_t mappedBufferCount = m_mappedObjectVertexGlobalDataBuffers.GetSize();
 	if ( mappedBufferCount < sceneObjectCount )
@@ -949,16 +1409,8 @@ void GraphicsScene::SwapDynamicConstantBuffers()
 	}
 
 	size_t subMeshCount = m_sceneObjectSubMeshes.GetSize();
-	instanceBufferCount = m_subMeshVertexGlobalDataBuffers.GetSize();
-	if ( instanceBufferCount < subMeshCount )
-	{
-		MemoryZero( m_subMeshVertexGlobalDataBuffers.GetData(), instanceBufferCount * sizeof( RConstantBuffer* ) );
-		m_subMeshVertexGlobalDataBuffers.Add( NULL, subMeshCount - instanceBufferCount );
-	}
-	else
-	{
-		MemoryZero( m_subMeshVertexGlobalDataBuffers.GetData(), subMeshCount * sizeof( RConstantBuffer* ) );
-	}
+	m_subMeshVertexGlobalDataRanges.Resize( 0 );
+	m_subMeshVertexGlobalDataRanges.Add( invalidRange, subMeshCount );
 
 	mappedBufferCount = m_mappedSubMeshVertexGlobalDataBuffers.GetSize();
 	if ( mappedBufferCount < subMeshCount )
@@ -971,9 +1423,20 @@ void GraphicsScene::SwapDynamicConstantBuffers()
 		MemoryZero( m_mappedSubMeshVertexGlobalDataBuffers.GetData(), subMeshCount * sizeof( float32_t* ) );
 	}
 
-	size_t staticBufferIndex = 0;
-	size_t skinnedBufferIndex = 0;
-	HELIUM_UNREF( skinnedBufferIndex );
+	m_dirtyObjectIds.Resize( 0 );
+
+	size_t invalidSkinningMatrixOffset;
+	SetInvalid( invalidSkinningMatrixOffset );
+	m_objectSkinningMatrixOffsets.Resize( 0 );
+	m_objectSkinningMatrixOffsets.Add( invalidSkinningMatrixOffset, sceneObjectCount );
+
+	size_t skinningMatrixCount = 0;
+
+	size_t previousSkinnedSubMeshIndex;
+	SetInvalid( previousSkinnedSubMeshIndex );
+
+	size_t pageCount = 0;
+	size_t pageOffset = INSTANCE_CONSTANT_PAGE_SIZE;
 
 	for ( size_t subMeshIndex = 0; subMeshIndex < subMeshCount; ++subMeshIndex )
 	{
@@ -987,204 +1450,1240 @@ void GraphicsScene::SwapDynamicConstantBuffers()
 		size_t sceneObjectIndex = rSubMesh.GetSceneObjectId();
 		HELIUM_ASSERT( sceneObjectIndex < sceneObjectCount );
 
-		// If the main scene object for the sub mesh already has a constant buffer assigned, we know it is a static
-		// mesh that has already been processed, so we can skip it.
-		if ( m_objectVertexGlobalDataBuffers[sceneObjectIndex] )
+		// If the main scene object for the sub mesh already has a range assigned, we know it is a static mesh that
+		// has already been processed, so we can skip it.
+		if ( IsValid( m_objectVertexGlobalDataRanges[sceneObjectIndex].pageIndex ) )
 		{
 			continue;
 		}
 
-		// Determine whether the object should be rendered as a static mesh (vertex constant buffer per scene
-		// object) or skinned mesh (vertex constant buffer per sub-mesh).
+		// Determine whether the object should be rendered as a static mesh (vertex constants per scene object) or
+		// skinned mesh (vertex constants per sub-mesh).
 		HELIUM_ASSERT( m_sceneObjects.IsElementValid( sceneObjectIndex ) );
 		GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectIndex];
 
-		RConstantBuffer* pBuffer = NULL;
-
-		uint_fast8_t boneCount = rSceneObject.GetBoneCount();
-		if ( boneCount != 0 )
+		if ( rSceneObject.GetBoneCount() == 0 || !rSceneObject.GetBonePalette() || !rSubMesh.GetSkinningPaletteMap() )
 		{
-			const Simd::Matrix44* pBonePalette = rSceneObject.GetBonePalette();
-			if ( pBonePalette )
+			InstanceConstantRange& rRange = m_objectVertexGlobalDataRanges[sceneObjectIndex];
+			rRange.pageIndex = static_cast< uint32_t >( sceneObjectIndex / OBJECT_CONSTANT_PAGE_SLOT_COUNT );
+			rRange.offset = static_cast< uint32_t >(
+				( sceneObjectIndex % OBJECT_CONSTANT_PAGE_SLOT_COUNT ) * OBJECT_CONSTANT_SLOT_SIZE );
+
+			if ( rSceneObject.GetTransformDirty() )
 			{
-				const uint8_t* pSkinningPaletteMap = rSubMesh.GetSkinningPaletteMap();
-				if ( pSkinningPaletteMap )
-				{
-					RConstantBuffer* pBuffer;
-					if ( skinnedBufferIndex < rSkinnedInstanceVertexGlobalDataBufferPool.GetSize() )
-					{
-						pBuffer = rSkinnedInstanceVertexGlobalDataBufferPool[skinnedBufferIndex];
-						HELIUM_ASSERT( pBuffer );
-					}
-					else
-					{
-						HELIUM_ASSERT( skinnedBufferIndex == rSkinnedInstanceVertexGlobalDataBufferPool.GetSize() );
-
-						pBuffer = pRenderer->CreateConstantBuffer(
-							sizeof( float32_t ) * 12 * BONE_COUNT_MAX,
-							RENDERER_BUFFER_USAGE_DYNAMIC );
-						if ( !pBuffer )
-						{
-							HELIUM_TRACE(
-								TraceLevels::Error,
-								"GraphicsScene::SwapDynamicConstantBuffers(): Skinned mesh instance vertex constant global data buffer creation failed!\n" );
-						}
-						else
-						{
-							rSkinnedInstanceVertexGlobalDataBufferPool.Push( pBuffer );
-						}
-					}
-
-					if ( pBuffer )
-					{
-						++skinnedBufferIndex;
-
-						m_subMeshVertexGlobalDataBuffers[subMeshIndex] = pBuffer;
-
-						void* pMappedData = pBuffer->Map( RENDERER_BUFFER_MAP_HINT_DISCARD );
-						HELIUM_ASSERT( pMappedData );
-						m_mappedSubMeshVertexGlobalDataBuffers[subMeshIndex] =
-							static_cast<float32_t*>( pMappedData );
-
-						continue;
-					}
-				}
+				m_dirtyObjectIds.Push( sceneObjectIndex );
 			}
+
+			continue;
 		}
 
-		// Instance data not mapped as a skinned mesh, so map as a static mesh.
-		if ( staticBufferIndex < rStaticInstanceVertexGlobalDataBufferPool.GetSize() )
+		size_t& rSkinningMatrixOffset = m_objectSkinningMatrixOffsets[sceneObjectIndex];
+		if ( IsInvalid( rSkinningMatrixOffset ) )
 		{
-			pBuffer = rStaticInstanceVertexGlobalDataBufferPool[staticBufferIndex];
-			HELIUM_ASSERT( pBuffer );
+			rSkinningMatrixOffset = skinningMatrixCount;
+			skinningMatrixCount += rSceneObject.GetBoneCount();
 		}
-		else
-		{
-			HELIUM_ASSERT( staticBufferIndex == rStaticInstanceVertexGlobalDataBufferPool.GetSize() );
 
-			pBuffer = pRenderer->CreateConstantBuffer(
-				sizeof( float32_t ) * 12,
-				RENDERER_BUFFER_USAGE_DYNAMIC );
-			if ( !pBuffer )
-			{
-				HELIUM_TRACE(
-					TraceLevels::Error,
-					"GraphicsScene::SwapDynamicConstantBuffers(): Static mesh instance vertex constant global data buffer creation failed!\n" );
-			}
-			else
+		if ( IsValid( previousSkinnedSubMeshIndex ) )
+		{
+			const GraphicsSceneObject::SubMeshData& rPreviousSubMesh = m_sceneObjectSubMeshes[previousSkinnedSubMeshIndex];
+			if ( rPreviousSubMesh.GetSceneObjectId() == sceneObjectIndex &&
+				MemoryCompare(
+					rPreviousSubMesh.GetSkinningPaletteMap(),
+					rSubMesh.GetSkinningPaletteMap(),
+					rSceneObject.GetBoneCount() ) == 0 )
 			{
-				rStaticInstanceVertexGlobalDataBufferPool.Push( pBuffer );
+				m_subMeshVertexGlobalDataRanges[subMeshIndex] = m_subMeshVertexGlobalDataRanges[previousSkinnedSubMeshIndex];
+
+				continue;
 			}
 		}
 
-		if ( pBuffer )
+		previousSkinnedSubMeshIndex = subMeshIndex;
+
+		size_t rangeSize = sizeof( float32_t ) * 12 * BONE_COUNT_MAX;
+		if ( pageOffset + rangeSize > INSTANCE_CONSTANT_PAGE_SIZE )
 		{
-			++staticBufferIndex;
+			++pageCount;
+			pageOffset = 0;
+		}
 
-			m_objectVertexGlobalDataBuffers[sceneObjectIndex] = pBuffer;
+		InstanceConstantRange& rRange = m_subMeshVertexGlobalDataRanges[subMeshIndex];
+		rRange.pageIndex = static_cast< uint32_t >( pageCount - 1 );
+		rRange.offset = static_cast< uint32_t >( pageOffset );
 
-			void* pMappedData = pBuffer->Map( RENDERER_BUFFER_MAP_HINT_DISCARD );
-			HELIUM_ASSERT( pMappedData );
-			m_mappedObjectVertexGlobalDataBuffers[sceneObjectIndex] = static_cast<float32_t*>( pMappedData );
-		}
+		pageOffset += ( rangeSize + CONSTANT_BUFFER_OFFSET_ALIGNMENT - 1 ) & ~( CONSTANT_BUFFER_OFFSET_ALIGNMENT - 1 );
 	}
 
-	// Update each constant buffer in parallel.
+	// Flag the objects that moved for the shadow depth texture cache.
+	m_objectTransformUpdatedFlags.Resize( 0 );
+	m_objectTransformUpdatedFlags.Add( 0, sceneObjectCount );
+
+	size_t dirtyObjectCount = m_dirtyObjectIds.GetSize();
+	for ( size_t dirtyObjectIndex = 0; dirtyObjectIndex < dirtyObjectCount; ++dirtyObjectIndex )
 	{
-		UpdateGraphicsSceneConstantBuffersJobSpawner job;
-		UpdateGraphicsSceneConstantBuffersJobSpawner::Parameters& rParameters = job.GetParameters();
-		rParameters.sceneObjectCount = static_cast<uint32_t>( sceneObjectCount );
-		rParameters.subMeshCount = static_cast<uint32_t>( subMeshCount );
-		rParameters.pSceneObjects = m_sceneObjects.GetData();
-		rParameters.ppSceneObjectConstantBufferData = m_mappedObjectVertexGlobalDataBuffers.GetData();
-		rParameters.pSubMeshes = m_sceneObjectSubMeshes.GetData();
-		rParameters.ppSubMeshConstantBufferData = m_mappedSubMeshVertexGlobalDataBuffers.GetData();
-		job.Run();
+		m_objectTransformUpdatedFlags[m_dirtyObjectIds[dirtyObjectIndex]] = 1;
 	}
 
-	// Unmap the constant buffers.
-	for ( size_t objectIndex = 0; objectIndex < sceneObjectCount; ++objectIndex )
+	// Create any persistent object pages we don't have yet, and map the pages holding dirty objects for updating.
+	size_t objectPageCount =
+		( sceneObjectCount + OBJECT_CONSTANT_PAGE_SLOT_COUNT - 1 ) / OBJECT_CONSTANT_PAGE_SLOT_COUNT;
+	while ( m_objectVertexGlobalDataPages.GetSize() < objectPageCount )
 	{
-		if ( m_mappedObjectVertexGlobalDataBuffers[objectIndex] )
+		RConstantBufferPtr spPage = pRenderer->CreateConstantBuffer(
+			INSTANCE_CONSTANT_PAGE_SIZE,
+			RENDERER_BUFFER_USAGE_DYNAMIC );
+		if ( !spPage )
 		{
-			RConstantBuffer* pBuffer = m_objectVertexGlobalDataBuffers[objectIndex];
-			HELIUM_ASSERT( pBuffer );
-			pBuffer->Unmap();
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"GraphicsScene::SwapDynamicConstantBuffers(): Static mesh instance vertex constant global data page creation failed!\n" );
+
+			break;
 		}
+
+		m_objectVertexGlobalDataPages.Push( spPage );
 	}
 
-	for ( size_t subMeshIndex = 0; subMeshIndex < subMeshCount; ++subMeshIndex )
+	objectPageCount = Min( objectPageCount, m_objectVertexGlobalDataPages.GetSize() );
+	m_mappedObjectVertexGlobalDataPages.Resize( 0 );
+	m_mappedObjectVertexGlobalDataPages.Add( NULL, objectPageCount );
+
+	for ( size_t dirtyObjectIndex = 0; dirtyObjectIndex < dirtyObjectCount; ++dirtyObjectIndex )
 	{
-		if ( m_mappedSubMeshVertexGlobalDataBuffers[subMeshIndex] )
+		size_t objectIndex = m_dirtyObjectIds[dirtyObjectIndex];
+		const InstanceConstantRange& rRange = m_objectVertexGlobalDataRanges[objectIndex];
+		if ( rRange.pageIndex >= objectPageCount )
 		{
-			RConstantBuffer* pBuffer = m_subMeshVertexGlobalDataBuffers[subMeshIndex];
-			HELIUM_ASSERT( pBuffer );
-			pBuffer->Unmap();
+			continue;
 		}
-	}
-}
 
-/// Render the specified scene view.
-///
-/// @param[in] viewIndex  Index of the scene view to render (can be an invalid element, but must be less than the size
-///                       of the scene view sparse array).
-void GraphicsScene::DrawSceneView( uint_fast32_t viewIndex )
-{
-	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
+		uint8_t*& rpMappedPage = m_mappedObjectVertexGlobalDataPages[rRange.pageIndex];
+		if ( !rpMappedPage )
+		{
+			RConstantBuffer* pPage = m_objectVertexGlobalDataPages[rRange.pageIndex];
+			HELIUM_ASSERT( pPage );
 
-	if ( !m_sceneViews.IsElementValid( viewIndex ) )
-	{
-		return;
+			// Slots of objects that did not move must be preserved, so the existing contents can't be discarded.
+			void* pMappedData = pPage->Map( RENDERER_BUFFER_MAP_HINT_NONE );
+			HELIUM_ASSERT( pMappedData );
+			rpMappedPage = static_cast< uint8_t* >( pMappedData );
+		}
+
+		m_mappedObjectVertexGlobalDataBuffers[objectIndex] = reinterpret_cast< float32_t* >( rpMappedPage + rRange.offset );
 	}
 
-	RConstantBuffer* pViewVertexGlobalDataBuffer =
-		m_viewVertexGlobalDataBuffers[m_constantBufferSetIndex][viewIndex];
-	if ( !pViewVertexGlobalDataBuffer )
+	// Drop the ranges of any objects in pages that could not be created.  They stay dirty so they can be written
+	// once their page exists.
+	for ( size_t objectIndex = 0; objectIndex < sceneObjectCount; ++objectIndex )
 	{
-		return;
+		InstanceConstantRange& rRange = m_objectVertexGlobalDataRanges[objectIndex];
+		if ( IsValid( rRange.pageIndex ) && rRange.pageIndex >= objectPageCount )
+		{
+			rRange = invalidRange;
+		}
 	}
 
-	GraphicsSceneView& rView = m_sceneViews[viewIndex];
-	RRenderContext* pRenderContext = rView.GetRenderContext();
-	if ( !pRenderContext )
+	// Create any arena pages we don't have yet, and map each page for updating.
+	DynamicArray< RConstantBufferPtr >& rInstanceVertexGlobalDataPages =
+		m_instanceVertexGlobalDataPages[bufferSetIndex];
+	while ( rInstanceVertexGlobalDataPages.GetSize() < pageCount )
+	{
+		RConstantBufferPtr spPage = pRenderer->CreateConstantBuffer(
+			INSTANCE_CONSTANT_PAGE_SIZE,
+			RENDERER_BUFFER_USAGE_DYNAMIC );
+		if ( !spPage )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"GraphicsScene::SwapDynamicConstantBuffers(): Skinned mesh instance vertex constant global data page creation failed!\n" );
+
+			break;
+		}
+
+		rInstanceVertexGlobalDataPages.Push( spPage );
+	}
+
+	m_mappedInstanceVertexGlobalDataPages.Resize( 0 );
+	m_mappedInstanceVertexGlobalDataPages.Add( NULL, pageCount );
+	for ( size_t pageIndex = 0; pageIndex < pageCount && pageIndex < rInstanceVertexGlobalDataPages.GetSize(); ++pageIndex )
+	{
+		RConstantBuffer* pPage = rInstanceVertexGlobalDataPages[pageIndex];
+		HELIUM_ASSERT( pPage );
+
+		void* pMappedData = pPage->Map( RENDERER_BUFFER_MAP_HINT_DISCARD );
+		HELIUM_ASSERT( pMappedData );
+		m_mappedInstanceVertexGlobalDataPages[pageIndex] = static_cast< uint8_t* >( pMappedData );
+	}
+
+	// Resolve the mapped address of each sub-mesh range, dropping any ranges on pages that could not be created.
+	// Shared ranges are only written through the first sub-mesh using them.
+	InstanceConstantRange previousRange = invalidRange;
+	for ( size_t subMeshIndex = 0; subMeshIndex < subMeshCount; ++subMeshIndex )
+	{
+		InstanceConstantRange& rRange = m_subMeshVertexGlobalDataRanges[subMeshIndex];
+		if ( IsValid( rRange.pageIndex ) )
+		{
+			uint8_t* pMappedPage = m_mappedInstanceVertexGlobalDataPages[rRange.pageIndex];
+			if ( pMappedPage )
+			{
+				if ( rRange.pageIndex != previousRange.pageIndex || rRange.offset != previousRange.offset )
+				{
+					m_mappedSubMeshVertexGlobalDataBuffers[subMeshIndex] =
+						reinterpret_cast< float32_t* >( pMappedPage + rRange.offset );
+					previousRange = rRange;
+				}
+			}
+			else
+			{
+				rRange = invalidRange;
+			}
+		}
+	}
+
+	// Lay out the per-frame bone buffer.  The skinning matrices of each skinned object are computed into it once, and
+	// each sub-mesh palette is then gathered from it instead of recomputing every bone for every sub-mesh.
+	m_skinningMatrices.Resize( skinningMatrixCount * 12 );
+	m_objectSkinningMatrixData.Resize( 0 );
+	m_objectSkinningMatrixData.Add( NULL, sceneObjectCount );
+
+	float32_t* pSkinningMatrices = m_skinningMatrices.GetData();
+	for ( size_t objectIndex = 0; objectIndex < sceneObjectCount; ++objectIndex )
+	{
+		size_t skinningMatrixOffset = m_objectSkinningMatrixOffsets[objectIndex];
+		if ( IsValid( skinningMatrixOffset ) )
+		{
+			m_objectSkinningMatrixData[objectIndex] = pSkinningMatrices + skinningMatrixOffset * 12;
+		}
+	}
+
+	// Update each constant buffer in parallel (scene objects without a mapped address are skipped).
+	{
+		UpdateGraphicsSceneConstantBuffersJobSpawner job;
+		UpdateGraphicsSceneConstantBuffersJobSpawner::Parameters& rParameters = job.GetParameters();
+		rParameters.sceneObjectCount = static_cast<uint32_t>( sceneObjectCount );
+		rParameters.subMeshCount = static_cast<uint32_t>( subMeshCount );
+		rParameters.pSceneObjects = m_sceneObjects.GetData();
+		rParameters.ppSceneObjectConstantBufferData = m_mappedObjectVertexGlobalDataBuffers.GetData();
+		rParameters.pSubMeshes = m_sceneObjectSubMeshes.GetData();
+		rParameters.ppSubMeshConstantBufferData = m_mappedSubMeshVertexGlobalDataBuffers.GetData();
+		rParameters.ppSkinningMatrixData = m_objectSkinningMatrixData.GetData();
+		job.Run();
+	}
+
+	// Mark the transforms written this frame as up to date.
+	for ( size_t dirtyObjectIndex = 0; dirtyObjectIndex < dirtyObjectCount; ++dirtyObjectIndex )
+	{
+		size_t objectIndex = m_dirtyObjectIds[dirtyObjectIndex];
+		if ( m_mappedObjectVertexGlobalDataBuffers[objectIndex] )
+		{
+			m_sceneObjects[objectIndex].ClearTransformDirty();
+		}
+	}
+
+	// Unmap the constant pages.
+	for ( size_t pageIndex = 0; pageIndex < objectPageCount; ++pageIndex )
+	{
+		if ( m_mappedObjectVertexGlobalDataPages[pageIndex] )
+		{
+			RConstantBuffer* pPage = m_objectVertexGlobalDataPages[pageIndex];
+			HELIUM_ASSERT( pPage );
+			pPage->Unmap();
+		}
+	}
+
+	for ( size_t pageIndex = 0; pageIndex < pageCount; ++pageIndex )
+	{
+		if ( m_mappedInstanceVertexGlobalDataPages[pageIndex] )
+		{
+			RConstantBuffer* pPage = rInstanceVertexGlobalDataPages[pageIndex];
+			HELIUM_ASSERT( pPage );
+			pPage->Unmap();
+		}
+	}
+}
+
+/// Get the constant buffer range holding the global vertex constants of a sub-mesh.
+///
+/// @param[in]  subMeshIndex   Sub-mesh index.
+/// @param[in]  sceneObjectId  ID of the scene object owning the sub-mesh.
+/// @param[out] rOffset        Byte offset of the constants within the returned buffer.
+/// @param[out] rSize          Size of the constants, in bytes.
+///
+/// @return  Page holding the constants for the sub-mesh (its own arena range if skinned, or the persistent slot of its
+///          scene object if not), or null if no constants are available for the sub-mesh this frame.
+RConstantBuffer* GraphicsScene::GetInstanceVertexGlobalData(
+	size_t subMeshIndex, size_t sceneObjectId, size_t& rOffset, size_t& rSize ) const
+{
+	HELIUM_ASSERT( subMeshIndex < m_subMeshVertexGlobalDataRanges.GetSize() );
+	const InstanceConstantRange& rSubMeshRange = m_subMeshVertexGlobalDataRanges[subMeshIndex];
+	if ( IsValid( rSubMeshRange.pageIndex ) )
+	{
+		const DynamicArray< RConstantBufferPtr >& rPages = m_instanceVertexGlobalDataPages[m_constantBufferSetIndex];
+		HELIUM_ASSERT( rSubMeshRange.pageIndex < rPages.GetSize() );
+		rOffset = rSubMeshRange.offset;
+		rSize = sizeof( float32_t ) * 12 * BONE_COUNT_MAX;
+
+		return rPages[rSubMeshRange.pageIndex];
+	}
+
+	HELIUM_ASSERT( sceneObjectId < m_objectVertexGlobalDataRanges.GetSize() );
+	const InstanceConstantRange& rObjectRange = m_objectVertexGlobalDataRanges[sceneObjectId];
+	if ( IsInvalid( rObjectRange.pageIndex ) )
+	{
+		return NULL;
+	}
+
+	HELIUM_ASSERT( rObjectRange.pageIndex < m_objectVertexGlobalDataPages.GetSize() );
+	rOffset = rObjectRange.offset;
+	rSize = sizeof( float32_t ) * 12;
+
+	return m_objectVertexGlobalDataPages[rObjectRange.pageIndex];
+}
+
+/// Determine the visible scene objects and sorted sub-mesh lists for each scene view that will be rendered during
+/// the current update.
+///
+/// Each view is prepared by a separate job, with its own result buffers, so the views can be drawn afterward without
+/// any further culling or sorting.
+///
+/// @see PrepareSceneView(), DrawSceneView()
+void GraphicsScene::PrepareSceneViews()
+{
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::PrepareSceneViews" );
+
+	size_t sceneViewCount = m_sceneViews.GetSize();
+	if ( m_viewVisibility.GetSize() < sceneViewCount )
+	{
+		m_viewVisibility.Resize( sceneViewCount );
+	}
+
+	m_preparedViewIds.Resize( 0 );
+	for ( size_t viewIndex = 0; viewIndex < sceneViewCount; ++viewIndex )
+	{
+		if ( m_activeViewId != Invalid< uint32_t >() && viewIndex != m_activeViewId )
+		{
+			continue;
+		}
+
+		if ( m_sceneViews.IsElementValid( viewIndex ) )
+		{
+			m_preparedViewIds.Push( static_cast<uint32_t>( viewIndex ) );
+		}
+	}
+
+	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+	HELIUM_ASSERT( pRenderResourceManager );
+
+	GraphicsConfig::EShadowMode shadowMode = pRenderResourceManager->GetShadowMode();
+	m_bPrepareShadowVisibility =
+		( shadowMode != GraphicsConfig::EShadowMode::INVALID && shadowMode != GraphicsConfig::EShadowMode::NONE );
+
+	// Bring the culling structure and base pass sort values up to date before preparing all views in parallel.
+	m_visibilityGrid.UpdateCellBounds();
+	UpdateSubMeshStateSortValues();
+
+	JobManager::ParallelFor( PrepareSceneViewCallback, this, m_preparedViewIds.GetSize() );
+}
+
+/// Assign the dynamic lights of the scene to the clusters of each scene view prepared for rendering.
+///
+/// Lights are culled and transformed for each view up front, after which the light lists of every depth slice of
+/// every view are built in parallel, and the results are uploaded for the base pass.
+///
+/// @see ClusteredLightGrid, PrepareSceneViews()
+void GraphicsScene::AssignClusteredLights()
+{
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::AssignClusteredLights" );
+
+	bool bLightsVisible = false;
+
+	size_t preparedViewCount = m_preparedViewIds.GetSize();
+	for ( size_t preparedViewIndex = 0; preparedViewIndex < preparedViewCount; ++preparedViewIndex )
+	{
+		uint32_t viewId = m_preparedViewIds[preparedViewIndex];
+		ClusteredLightGrid& rLightGrid = m_viewVisibility[viewId].lightGrid;
+		rLightGrid.BeginAssignment( m_sceneViews[viewId], m_lights );
+		bLightsVisible |= ( rLightGrid.GetLightCount() != 0 );
+	}
+
+	if ( !bLightsVisible )
+	{
+		return;
+	}
+
+	JobManager::ParallelFor(
+		AssignClusteredLightsCallback,
+		this,
+		preparedViewCount * ClusteredLightGrid::DEPTH_SLICE_COUNT );
+
+	for ( size_t preparedViewIndex = 0; preparedViewIndex < preparedViewCount; ++preparedViewIndex )
+	{
+		m_viewVisibility[m_preparedViewIds[preparedViewIndex]].lightGrid.EndAssignment();
+	}
+}
+
+/// Set the name of the shader variant manifest file to use for this scene.
+///
+/// Shader variants recorded in the manifest file by previous runs begin loading immediately, so they are ready (or at
+/// least compiling) before objects using them are first drawn.  All shader variants loaded from then on are recorded
+/// to the manifest, which is written back to the user data directory when this scene is destroyed or another
+/// manifest is set.
+///
+/// @param[in] name  Manifest file name (without extension), or an empty name to stop using a manifest.
+void GraphicsScene::SetShaderVariantManifestName( Name name )
+{
+	WaitForRenderFrame();
+
+	SaveShaderVariantManifest();
+
+	m_shaderVariantManifestName = name;
+	if ( m_shaderVariantManifestName.IsEmpty() )
+	{
+		return;
+	}
+
+	m_pShaderVariantManifest = new ShaderVariantManifest;
+	HELIUM_ASSERT( m_pShaderVariantManifest );
+
+	FilePath manifestPath;
+	if ( GetShaderVariantManifestPath( manifestPath ) )
+	{
+		m_pShaderVariantManifest->LoadFromFile( manifestPath );
+	}
+
+	m_pShaderVariantManifest->BeginWarmup();
+	m_bShaderVariantWarmupPending = true;
+
+	ShaderVariantManifest::SetRecordingManifest( m_pShaderVariantManifest );
+}
+
+/// Get the path of the shader variant manifest file for this scene.
+///
+/// @param[out] rPath  Manifest file path.
+///
+/// @return  True if the path was determined, false if this scene does not use a manifest or no user data directory
+///          is available.
+bool GraphicsScene::GetShaderVariantManifestPath( FilePath& rPath ) const
+{
+	if ( m_shaderVariantManifestName.IsEmpty() )
+	{
+		return false;
+	}
+
+	FilePath userDirectory;
+	if ( !FileLocations::GetUserDirectory( userDirectory ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"GraphicsScene::GetShaderVariantManifestPath(): No user data directory could be determined.\n" );
+
+		return false;
+	}
+
+	String pathString( userDirectory.Data() );
+	pathString += *m_shaderVariantManifestName;
+	pathString += ".shadervariants";
+
+	rPath = FilePath( *pathString );
+
+	return true;
+}
+
+/// Stop recording to the current shader variant manifest (if any), write it to its file, and release it.
+void GraphicsScene::SaveShaderVariantManifest()
+{
+	if ( !m_pShaderVariantManifest )
+	{
+		return;
+	}
+
+	if ( ShaderVariantManifest::GetRecordingManifest() == m_pShaderVariantManifest )
+	{
+		ShaderVariantManifest::SetRecordingManifest( NULL );
+	}
+
+	FilePath manifestPath;
+	if ( GetShaderVariantManifestPath( manifestPath ) )
+	{
+		m_pShaderVariantManifest->SaveToFile( manifestPath );
+	}
+
+	delete m_pShaderVariantManifest;
+	m_pShaderVariantManifest = NULL;
+	m_bShaderVariantWarmupPending = false;
+}
+
+/// Determine the visible scene objects and sorted sub-mesh lists for a given scene view.
+///
+/// The sub-meshes for every pass are added to a single render queue of 64-bit sort keys, each packing the pass, a
+/// pass-specific sort value (depth, or base pass material and vertex buffer IDs), and the sub-mesh index.  A single
+/// radix sort of the keys then orders every pass at once.
+///
+/// This only reads shared scene data and writes to the visibility results of the given view, so multiple views can
+/// be prepared at the same time.
+///
+/// @param[in] viewIndex  Index of the scene view to prepare (must be a valid view).
+///
+/// @see PrepareSceneViews()
+void GraphicsScene::PrepareSceneView( uint_fast32_t viewIndex )
+{
+	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
+	HELIUM_ASSERT( m_sceneViews.IsElementValid( viewIndex ) );
+	HELIUM_ASSERT( viewIndex < m_viewVisibility.GetSize() );
+
+	const GraphicsSceneView& rView = m_sceneViews[viewIndex];
+	ViewVisibility& rVisibility = m_viewVisibility[viewIndex];
+
+	DynamicArray< uint64_t >& rSortKeys = rVisibility.sortKeys;
+	rSortKeys.Resize( 0 );
+
+	// Queue the visible sub-meshes for the depth pre-pass (front to back) and base pass (by material).
+	// Sub-meshes with their own bounds are culled individually as they are queued.
+	const Simd::Frustum& rFrustum = rView.GetFrustum();
+	{
+		HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::CullSceneView" );
+		m_visibilityGrid.Cull( rFrustum, rVisibility.sceneObjectIds );
+		CullOccludedSceneObjects( rView, rVisibility );
+	}
+
+	SelectSceneObjectLods( rView, rVisibility.sceneObjectIds, rVisibility.sceneObjectLods );
+	QueueDepthSortedSubMeshes(
+		rVisibility.sceneObjectIds,
+		RENDER_QUEUE_PASS_DEPTH,
+		rView.GetForward(),
+		rFrustum,
+		rSortKeys );
+	QueueStateSortedSubMeshes( rVisibility.sceneObjectIds, RENDER_QUEUE_PASS_BASE, rFrustum, rSortKeys );
+
+	// Shadow casters are culled against the shadow depth pass frustum, as they may be outside of the view itself.
+	// Casters whose shadows (their bounds swept along the light direction) never reach the part of the view that
+	// receives shadows are skipped as well.
+	if ( m_bPrepareShadowVisibility )
+	{
+		HELIUM_ASSERT( viewIndex < m_shadowViewInverseViewProjectionMatrices.GetSize() );
+		Simd::Frustum shadowFrustum( m_shadowViewInverseViewProjectionMatrices[viewIndex].GetTranspose() );
+
+		Simd::Frustum receiverFrustum;
+		GetShadowReceiverFrustum( rView, receiverFrustum );
+
+		m_visibilityGrid.CullShadowCasters(
+			shadowFrustum,
+			receiverFrustum,
+			m_directionalLightDirection,
+			rVisibility.shadowSceneObjectIds );
+		SelectSceneObjectLods( rView, rVisibility.shadowSceneObjectIds, rVisibility.sceneObjectLods );
+		QueueDepthSortedSubMeshes(
+			rVisibility.shadowSceneObjectIds,
+			RENDER_QUEUE_PASS_SHADOW,
+			m_directionalLightDirection,
+			shadowFrustum,
+			rSortKeys );
+	}
+	else
+	{
+		rVisibility.shadowSceneObjectIds.Resize( 0 );
+	}
+
+	// Sort the entire queue at once, then split it into the sub-mesh lists for each pass.
+	size_t sortKeyCount = rSortKeys.GetSize();
+	rVisibility.sortKeyScratch.Resize( sortKeyCount );
+
+	{
+		HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::SortRenderQueue" );
+
+		RadixSortJob< uint64_t > job;
+		RadixSortJob< uint64_t >::Parameters& rParameters = job.GetParameters();
+		rParameters.pBase = rSortKeys.GetData();
+		rParameters.pScratch = rVisibility.sortKeyScratch.GetData();
+		rParameters.count = sortKeyCount;
+		job.Run();
+	}
+
+	DynamicArray< size_t >* passSubMeshIndices[] =
+	{
+		&rVisibility.depthSubMeshIndices,
+		&rVisibility.baseSubMeshIndices,
+		&rVisibility.shadowSubMeshIndices
+	};
+
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( passSubMeshIndices ) == RENDER_QUEUE_PASS_MAX );
+
+	for ( size_t passIndex = 0; passIndex < HELIUM_ARRAY_COUNT( passSubMeshIndices ); ++passIndex )
+	{
+		passSubMeshIndices[passIndex]->Resize( 0 );
+	}
+
+	for ( size_t keyIndex = 0; keyIndex < sortKeyCount; ++keyIndex )
+	{
+		uint64_t sortKey = rSortKeys[keyIndex];
+		size_t passIndex = static_cast<size_t>( sortKey >> RENDER_QUEUE_PASS_SHIFT );
+		HELIUM_ASSERT( passIndex < HELIUM_ARRAY_COUNT( passSubMeshIndices ) );
+
+		passSubMeshIndices[passIndex]->Push( static_cast<size_t>( sortKey & RENDER_QUEUE_PAYLOAD_MASK ) );
+	}
+
+	FindInstanceRuns( rVisibility.baseSubMeshIndices, rVisibility.sceneObjectLods, rVisibility.baseInstanceCounts );
+}
+
+/// Remove the scene objects hidden behind occluders from the visible object list of a scene view.
+///
+/// The occluder boxes of the visible scene objects are rasterized into the software occlusion buffer of the view,
+/// after which every visible object is tested against its hierarchical-Z levels.  Views with no visible occluders are
+/// left untouched.
+///
+/// @param[in]     rView        Scene view.
+/// @param[in,out] rVisibility  Visibility results of the view, with the objects passing the frustum test.
+///
+/// @see PrepareSceneView()
+void GraphicsScene::CullOccludedSceneObjects( const GraphicsSceneView& rView, ViewVisibility& rVisibility ) const
+{
+	DynamicArray< size_t >& rSceneObjectIds = rVisibility.sceneObjectIds;
+	OcclusionBuffer& rOcclusionBuffer = rVisibility.occlusionBuffer;
+
+	rOcclusionBuffer.Begin( rView.GetInverseViewProjectionMatrix() );
+
+	size_t visibleObjectCount = rSceneObjectIds.GetSize();
+	for ( size_t visibleObjectIndex = 0; visibleObjectIndex < visibleObjectCount; ++visibleObjectIndex )
+	{
+		const GraphicsSceneObject& rSceneObject = m_sceneObjects[rSceneObjectIds[visibleObjectIndex]];
+		const Simd::AaBox* pOccluderBox = rSceneObject.GetOccluderBox();
+		if ( pOccluderBox )
+		{
+			rOcclusionBuffer.AddOccluder( rSceneObject.GetTransform(), *pOccluderBox );
+		}
+	}
+
+	if ( !rOcclusionBuffer.HasOccluders() )
+	{
+		return;
+	}
+
+	rOcclusionBuffer.End();
+
+	size_t keptObjectCount = 0;
+	for ( size_t visibleObjectIndex = 0; visibleObjectIndex < visibleObjectCount; ++visibleObjectIndex )
+	{
+		size_t sceneObjectId = rSceneObjectIds[visibleObjectIndex];
+		if ( !rOcclusionBuffer.IsOccluded( m_sceneObjects[sceneObjectId].GetWorldBox() ) )
+		{
+			rSceneObjectIds[keptObjectCount] = sceneObjectId;
+			++keptObjectCount;
+		}
+	}
+
+	rSceneObjectIds.Resize( keptObjectCount );
+}
+
+/// Estimate the on-screen size of a bounding sphere in a scene view.
+///
+/// @param[in] rView    Scene view.
+/// @param[in] rSphere  World-space bounding sphere.
+///
+/// @return  Projected diameter of the sphere, in pixels (clamped to the size of the viewport).
+static float32_t GetProjectedScreenSize( const GraphicsSceneView& rView, const Simd::Sphere& rSphere )
+{
+	// Conversion from world-space size to pixels (at unit distance for perspective projections).
+	const Simd::Matrix44& rProjectionMatrix = rView.GetProjectionMatrix();
+	bool bOrthographic = ( rProjectionMatrix.GetElement( 15 ) != 0.0f );
+	float32_t pixelScale =
+		0.5f * rProjectionMatrix.GetElement( 0 ) * static_cast< float32_t >( rView.GetViewportWidth() );
+	float32_t fullScreenSize =
+		static_cast< float32_t >( Max( rView.GetViewportWidth(), rView.GetViewportHeight() ) );
+
+	float32_t radius = rSphere.GetElement( 3 );
+
+	float32_t screenSize;
+	if ( bOrthographic )
+	{
+		screenSize = 2.0f * radius * pixelScale;
+	}
+	else
+	{
+		Simd::Vector3 center( rSphere.GetElement( 0 ), rSphere.GetElement( 1 ), rSphere.GetElement( 2 ) );
+		float32_t distance = ( center - rView.GetOrigin() ).GetMagnitude();
+
+		// Objects surrounding the view origin may cover the entire screen.
+		screenSize = ( distance > radius ? 2.0f * radius * pixelScale / distance : fullScreenSize );
+	}
+
+	return Min( screenSize, fullScreenSize );
+}
+
+/// Select the level of detail to draw for each of a list of scene objects in a scene view.
+///
+/// Scene objects switch to a coarser level of detail as soon as their projected size drops below its switching size,
+/// but only switch back to a finer level of detail once their projected size is larger than the switching size by
+/// LOD_SCREEN_SIZE_HYSTERESIS, so that objects hovering around a switching size do not flicker between levels.
+///
+/// @param[in]     rView             Scene view.
+/// @param[in]     rSceneObjectIds   IDs of the scene objects to update.
+/// @param[in,out] rSceneObjectLods  Level of detail for each scene object in the view, indexed by scene object ID.
+///
+/// @see PrepareSceneView(), GetSceneObjectLod()
+void GraphicsScene::SelectSceneObjectLods(
+	const GraphicsSceneView& rView,
+	const DynamicArray< size_t >& rSceneObjectIds,
+	DynamicArray< uint8_t >& rSceneObjectLods ) const
+{
+	size_t lodCount = rSceneObjectLods.GetSize();
+	size_t sceneObjectCount = m_sceneObjects.GetSize();
+	if ( lodCount < sceneObjectCount )
+	{
+		rSceneObjectLods.Add( 0, sceneObjectCount - lodCount );
+	}
+
+	size_t objectCount = rSceneObjectIds.GetSize();
+	for ( size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex )
+	{
+		size_t sceneObjectId = rSceneObjectIds[objectIndex];
+		const GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectId];
+
+		size_t objectLodCount = rSceneObject.GetLodCount();
+		const float32_t* pLodScreenSizes = rSceneObject.GetLodScreenSizes();
+		if ( objectLodCount <= 1 || !pLodScreenSizes )
+		{
+			rSceneObjectLods[sceneObjectId] = 0;
+
+			continue;
+		}
+
+		float32_t screenSize = GetProjectedScreenSize( rView, rSceneObject.GetWorldSphere() );
+
+		// Screen sizes are stored for each level of detail past the first, so level N switches at index N - 1.
+		size_t lod = Min( static_cast<size_t>( rSceneObjectLods[sceneObjectId] ), objectLodCount - 1 );
+		while ( lod + 1 < objectLodCount && screenSize < pLodScreenSizes[lod] )
+		{
+			++lod;
+		}
+
+		while ( lod > 0 && screenSize > pLodScreenSizes[lod - 1] * ( 1.0f + LOD_SCREEN_SIZE_HYSTERESIS ) )
+		{
+			--lod;
+		}
+
+		rSceneObjectLods[sceneObjectId] = static_cast<uint8_t>( lod );
+	}
+}
+
+/// Get the level of detail drawn for a scene object in a scene view.
+///
+/// @param[in] viewIndex      Index of the scene view.
+/// @param[in] sceneObjectId  ID of the scene object.
+///
+/// @return  Level of detail selected for the scene object when the view was last prepared.
+///
+/// @see SelectSceneObjectLods()
+size_t GraphicsScene::GetSceneObjectLod( uint_fast32_t viewIndex, size_t sceneObjectId ) const
+{
+	HELIUM_ASSERT( viewIndex < m_viewVisibility.GetSize() );
+
+	const DynamicArray< uint8_t >& rSceneObjectLods = m_viewVisibility[viewIndex].sceneObjectLods;
+	if ( sceneObjectId >= rSceneObjectLods.GetSize() )
+	{
+		return 0;
+	}
+
+	return Min( static_cast<size_t>( rSceneObjectLods[sceneObjectId] ), m_sceneObjects[sceneObjectId].GetLodCount() - 1 );
+}
+
+/// Record the largest projected size of each scene object visible in the views prepared this update.
+///
+/// Objects not visible in any prepared view get a size of zero.  This must be called on the main thread after
+/// PrepareSceneViews().
+///
+/// @see GetSceneObjectScreenSize(), PrepareSceneViews()
+void GraphicsScene::UpdateSceneObjectScreenSizes()
+{
+	size_t sceneObjectCount = m_sceneObjects.GetSize();
+	m_sceneObjectScreenSizes.Resize( sceneObjectCount );
+	if ( sceneObjectCount != 0 )
+	{
+		MemoryZero( m_sceneObjectScreenSizes.GetData(), sceneObjectCount * sizeof( float32_t ) );
+	}
+
+	size_t preparedViewCount = m_preparedViewIds.GetSize();
+	for ( size_t preparedViewIndex = 0; preparedViewIndex < preparedViewCount; ++preparedViewIndex )
+	{
+		uint32_t viewIndex = m_preparedViewIds[preparedViewIndex];
+		HELIUM_ASSERT( viewIndex < m_viewVisibility.GetSize() );
+
+		const GraphicsSceneView& rView = m_sceneViews[viewIndex];
+		const DynamicArray< size_t >& rSceneObjectIds = m_viewVisibility[viewIndex].sceneObjectIds;
+
+		size_t visibleObjectCount = rSceneObjectIds.GetSize();
+		for ( size_t visibleObjectIndex = 0; visibleObjectIndex < visibleObjectCount; ++visibleObjectIndex )
+		{
+			size_t sceneObjectId = rSceneObjectIds[visibleObjectIndex];
+			HELIUM_ASSERT( sceneObjectId < sceneObjectCount );
+
+			float32_t screenSize = GetProjectedScreenSize( rView, m_sceneObjects[sceneObjectId].GetWorldSphere() );
+			float32_t& rScreenSize = m_sceneObjectScreenSizes[sceneObjectId];
+			rScreenSize = Max( rScreenSize, screenSize );
+		}
+	}
+}
+
+/// Report the on-screen size of the textures used by each visible sub-mesh to the texture streaming manager.
+///
+/// The screen size of each sub-mesh is estimated from the projected diameter of the bounding sphere of its scene
+/// object, and is requested for every 2D texture in its material.  The materials and textures of visible sub-meshes
+/// are also reported as in use to the residency manager.  This must be called on the main thread after
+/// PrepareSceneViews().
+///
+/// @see PrepareSceneViews()
+void GraphicsScene::RequestStreamedTextures()
+{
+	TextureStreamingManager* pStreamingManager = TextureStreamingManager::GetInstance();
+	ResidencyManager* pResidencyManager = ResidencyManager::GetInstance();
+	if ( !pStreamingManager && !pResidencyManager )
+	{
+		return;
+	}
+
+	size_t preparedViewCount = m_preparedViewIds.GetSize();
+	for ( size_t preparedViewIndex = 0; preparedViewIndex < preparedViewCount; ++preparedViewIndex )
+	{
+		uint32_t viewIndex = m_preparedViewIds[preparedViewIndex];
+		HELIUM_ASSERT( viewIndex < m_viewVisibility.GetSize() );
+
+		const GraphicsSceneView& rView = m_sceneViews[viewIndex];
+		const DynamicArray< size_t >& rSubMeshIndices = m_viewVisibility[viewIndex].baseSubMeshIndices;
+
+		size_t subMeshIndexCount = rSubMeshIndices.GetSize();
+		for ( size_t subMeshIndexIndex = 0; subMeshIndexIndex < subMeshIndexCount; ++subMeshIndexIndex )
+		{
+			const GraphicsSceneObject::SubMeshData& rSubMeshData =
+				m_sceneObjectSubMeshes[rSubMeshIndices[subMeshIndexIndex]];
+
+			Material* pMaterial = rSubMeshData.GetMaterial();
+			if ( !pMaterial )
+			{
+				continue;
+			}
+
+			if ( pResidencyManager )
+			{
+				pResidencyManager->TouchResource( pMaterial );
+			}
+
+			size_t textureParameterCount = pMaterial->GetTextureParameterCount();
+			if ( textureParameterCount == 0 )
+			{
+				continue;
+			}
+
+			float32_t screenSize = ( pStreamingManager
+				? GetProjectedScreenSize( rView, m_sceneObjects[rSubMeshData.GetSceneObjectId()].GetWorldSphere() )
+				: 0.0f );
+
+			for ( size_t textureParameterIndex = 0;
+				textureParameterIndex < textureParameterCount;
+				++textureParameterIndex )
+			{
+				const Material::TextureParameter& rTextureParameter = pMaterial->GetTextureParameter(
+					textureParameterIndex );
+				Texture2d* pTexture = Reflect::SafeCast< Texture2d >( rTextureParameter.value.Get() );
+				if ( !pTexture )
+				{
+					continue;
+				}
+
+				if ( pStreamingManager )
+				{
+					pStreamingManager->RequestTexture( pTexture, screenSize );
+				}
+
+				if ( pResidencyManager )
+				{
+					pResidencyManager->TouchResource( pTexture );
+				}
+			}
+		}
+	}
+}
+
+/// Compute the base pass render queue sort value of each sub-mesh.
+///
+/// Materials in use are ranked so that those sharing the same shaders receive adjacent IDs, and vertex buffers are
+/// given IDs in order of first use.  The sort value of each sub-mesh combines the two, so the base pass can be sorted
+/// for fewer state changes without inspecting any materials during the sort itself.
+///
+/// @see PrepareSceneViews()
+void GraphicsScene::UpdateSubMeshStateSortValues()
+{
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::UpdateSubMeshStateSortValues" );
+
+	m_materialSortIdMap.Clear();
+	m_vertexBufferSortIdMap.Clear();
+	m_sortMaterials.Resize( 0 );
+
+	size_t subMeshCount = m_sceneObjectSubMeshes.GetSize();
+	for ( size_t subMeshIndex = 0; subMeshIndex < subMeshCount; ++subMeshIndex )
+	{
+		if ( !m_sceneObjectSubMeshes.IsElementValid( subMeshIndex ) )
+		{
+			continue;
+		}
+
+		Material* pMaterial = m_sceneObjectSubMeshes[subMeshIndex].GetMaterial();
+		uint64_t materialKey = static_cast<uint64_t>( reinterpret_cast<uintptr_t>( pMaterial ) );
+
+		HashMap< uint64_t, uint32_t >::Iterator materialIter = m_materialSortIdMap.Find( materialKey );
+		if ( materialIter == m_materialSortIdMap.End() )
+		{
+			m_materialSortIdMap.Insert( materialIter, HashMap< uint64_t, uint32_t >::ValueType( materialKey, 0 ) );
+			m_sortMaterials.Push( pMaterial );
+
+			// Swap in any shader variants that have finished compiling in place of the fallbacks used so far.  This
+			// must happen before sorting, as materials are sorted by shader variant.
+			if ( pMaterial )
+			{
+				pMaterial->UpdateShaderVariants();
+			}
+		}
+	}
+
+	{
+		SortJob< Material*, MaterialSortCompare > job;
+		SortJob< Material*, MaterialSortCompare >::Parameters& rParameters = job.GetParameters();
+		rParameters.pBase = m_sortMaterials.GetData();
+		rParameters.count = m_sortMaterials.GetSize();
+		rParameters.singleJobCount = 100;
+		job.Run();
+	}
+
+	size_t materialCount = m_sortMaterials.GetSize();
+	for ( size_t materialIndex = 0; materialIndex < materialCount; ++materialIndex )
+	{
+		uint64_t materialKey = static_cast<uint64_t>( reinterpret_cast<uintptr_t>( m_sortMaterials[materialIndex] ) );
+
+		HashMap< uint64_t, uint32_t >::Iterator materialIter = m_materialSortIdMap.Find( materialKey );
+		HELIUM_ASSERT( materialIter != m_materialSortIdMap.End() );
+		materialIter->Second() = static_cast<uint32_t>( Min< size_t >( materialIndex, RENDER_QUEUE_MATERIAL_ID_MAX ) );
+	}
+
+	m_subMeshStateSortValues.Resize( subMeshCount );
+	for ( size_t subMeshIndex = 0; subMeshIndex < subMeshCount; ++subMeshIndex )
+	{
+		if ( !m_sceneObjectSubMeshes.IsElementValid( subMeshIndex ) )
+		{
+			continue;
+		}
+
+		const GraphicsSceneObject::SubMeshData& rSubMeshData = m_sceneObjectSubMeshes[subMeshIndex];
+
+		Material* pMaterial = rSubMeshData.GetMaterial();
+		uint64_t materialKey = static_cast<uint64_t>( reinterpret_cast<uintptr_t>( pMaterial ) );
+
+		HashMap< uint64_t, uint32_t >::Iterator materialIter = m_materialSortIdMap.Find( materialKey );
+		HELIUM_ASSERT( materialIter != m_materialSortIdMap.End() );
+		uint32_t materialId = materialIter->Second();
+
+		RVertexBuffer* pVertexBuffer = m_sceneObjects[rSubMeshData.GetSceneObjectId()].GetVertexBuffer();
+		uint64_t vertexBufferKey = static_cast<uint64_t>( reinterpret_cast<uintptr_t>( pVertexBuffer ) );
+
+		uint32_t vertexBufferId;
+		HashMap< uint64_t, uint32_t >::Iterator vertexBufferIter = m_vertexBufferSortIdMap.Find( vertexBufferKey );
+		if ( vertexBufferIter != m_vertexBufferSortIdMap.End() )
+		{
+			vertexBufferId = vertexBufferIter->Second();
+		}
+		else
+		{
+			vertexBufferId = static_cast<uint32_t>(
+				Min< size_t >( m_vertexBufferSortIdMap.GetSize(), RENDER_QUEUE_VERTEX_BUFFER_ID_MAX ) );
+			m_vertexBufferSortIdMap.Insert(
+				vertexBufferIter,
+				HashMap< uint64_t, uint32_t >::ValueType( vertexBufferKey, vertexBufferId ) );
+		}
+
+		m_subMeshStateSortValues[subMeshIndex] =
+			( materialId << RENDER_QUEUE_VERTEX_BUFFER_ID_BITS ) | vertexBufferId;
+	}
+}
+
+/// Add render queue entries for the sub-meshes of a set of scene objects, sorted by the distance of each scene
+/// object along a given direction.
+///
+/// @param[in]     rSceneObjectIds  IDs of the scene objects.
+/// @param[in]     pass             Render queue pass for the entries.
+/// @param[in]     rDirection       Direction along which to sort (sub-meshes are sorted from nearest to farthest).
+/// @param[in]     rFrustum         Frustum against which to cull sub-meshes with their own bounds.
+/// @param[in,out] rSortKeys        Render queue sort keys to which the entries should be added.
+///
+/// @see QueueStateSortedSubMeshes()
+void GraphicsScene::QueueDepthSortedSubMeshes(
+	const DynamicArray< size_t >& rSceneObjectIds,
+	uint64_t pass,
+	const Simd::Vector3& rDirection,
+	const Simd::Frustum& rFrustum,
+	DynamicArray< uint64_t >& rSortKeys ) const
+{
+	HELIUM_ASSERT( pass < RENDER_QUEUE_PASS_MAX );
+
+	size_t sceneObjectIdCount = rSceneObjectIds.GetSize();
+	for ( size_t sceneObjectIdIndex = 0; sceneObjectIdIndex < sceneObjectIdCount; ++sceneObjectIdIndex )
 	{
-		return;
+		size_t sceneObjectId = rSceneObjectIds[sceneObjectIdIndex];
+		HELIUM_ASSERT( m_sceneObjects.IsElementValid( sceneObjectId ) );
+
+		const GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectId];
+		Simd::Vector3 position = Simd::Vector4ToVector3( rSceneObject.GetTransform().GetRow( 3 ) );
+
+		// Map the distance to an unsigned integer with the same ordering, dropping the lowest mantissa bits to fit
+		// the sort value.
+		float32_t distance = position.Dot( rDirection );
+		uint32_t distanceBits;
+		MemoryCopy( &distanceBits, &distance, sizeof( distanceBits ) );
+		distanceBits = ( ( distanceBits & 0x80000000 ) ? ~distanceBits : ( distanceBits | 0x80000000 ) );
+
+		uint64_t keyBase =
+			( pass << RENDER_QUEUE_PASS_SHIFT ) |
+			( static_cast<uint64_t>( distanceBits >> ( 32 - RENDER_QUEUE_VALUE_BITS ) ) << RENDER_QUEUE_VALUE_SHIFT );
+
+		const DynamicArray< size_t >& rSubMeshIds = m_sceneObjectSubMeshIds[sceneObjectId];
+		size_t subMeshIdCount = rSubMeshIds.GetSize();
+		for ( size_t subMeshIdIndex = 0; subMeshIdIndex < subMeshIdCount; ++subMeshIdIndex )
+		{
+			size_t subMeshIndex = rSubMeshIds[subMeshIdIndex];
+			HELIUM_ASSERT( subMeshIndex <= RENDER_QUEUE_PAYLOAD_MASK );
+
+			if ( IsSubMeshInFrustum( subMeshIndex, rSceneObject, rFrustum ) )
+			{
+				rSortKeys.Push( keyBase | subMeshIndex );
+			}
+		}
 	}
+}
 
-	// Determine which scene objects are visible in the current view.
-	m_visibleSceneObjects.UnsetAll();
+/// Add render queue entries for the sub-meshes of a set of scene objects, sorted to minimize render state changes.
+///
+/// @param[in]     rSceneObjectIds  IDs of the scene objects.
+/// @param[in]     pass             Render queue pass for the entries.
+/// @param[in]     rFrustum         Frustum against which to cull sub-meshes with their own bounds.
+/// @param[in,out] rSortKeys        Render queue sort keys to which the entries should be added.
+///
+/// @see QueueDepthSortedSubMeshes(), UpdateSubMeshStateSortValues()
+void GraphicsScene::QueueStateSortedSubMeshes(
+	const DynamicArray< size_t >& rSceneObjectIds,
+	uint64_t pass,
+	const Simd::Frustum& rFrustum,
+	DynamicArray< uint64_t >& rSortKeys ) const
+{
+	HELIUM_ASSERT( pass < RENDER_QUEUE_PASS_MAX );
 
-	const Simd::Frustum& rViewFrustum = rView.GetFrustum();
+	uint64_t keyBase = ( pass << RENDER_QUEUE_PASS_SHIFT );
 
-	size_t sceneObjectCount = m_sceneObjects.GetSize();
-	for ( size_t sceneObjectIndex = 0; sceneObjectIndex < sceneObjectCount; ++sceneObjectIndex )
+	size_t sceneObjectIdCount = rSceneObjectIds.GetSize();
+	for ( size_t sceneObjectIdIndex = 0; sceneObjectIdIndex < sceneObjectIdCount; ++sceneObjectIdIndex )
 	{
-		if ( m_sceneObjects.IsElementValid( sceneObjectIndex ) )
+		size_t sceneObjectId = rSceneObjectIds[sceneObjectIdIndex];
+		HELIUM_ASSERT( m_sceneObjects.IsElementValid( sceneObjectId ) );
+
+		const GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectId];
+
+		const DynamicArray< size_t >& rSubMeshIds = m_sceneObjectSubMeshIds[sceneObjectId];
+		size_t subMeshIdCount = rSubMeshIds.GetSize();
+		for ( size_t subMeshIdIndex = 0; subMeshIdIndex < subMeshIdCount; ++subMeshIdIndex )
 		{
-			//const AaBox& rObjectBounds = m_sceneObjects[ sceneObjectIndex ].GetWorldBox();
-			const Simd::Sphere& rObjectBounds = m_sceneObjects[sceneObjectIndex].GetWorldSphere();
-			if ( rViewFrustum.Intersects( rObjectBounds ) )
+			size_t subMeshIndex = rSubMeshIds[subMeshIdIndex];
+			HELIUM_ASSERT( subMeshIndex <= RENDER_QUEUE_PAYLOAD_MASK );
+			HELIUM_ASSERT( subMeshIndex < m_subMeshStateSortValues.GetSize() );
+
+			if ( !IsSubMeshInFrustum( subMeshIndex, rSceneObject, rFrustum ) )
 			{
-				m_visibleSceneObjects.SetElement( sceneObjectIndex );
+				continue;
 			}
+
+			uint64_t sortValue = m_subMeshStateSortValues[subMeshIndex];
+			rSortKeys.Push( keyBase | ( sortValue << RENDER_QUEUE_VALUE_SHIFT ) | subMeshIndex );
 		}
 	}
+}
 
-	// Build a list of indices for each visible sub-mesh for sorting.
-	m_sceneObjectSubMeshIndices.Resize( 0 );
+/// Test whether a sub-mesh of a visible scene object intersects a given frustum.
+///
+/// Only sub-meshes with local bounds set are tested individually; all other sub-meshes are considered visible along
+/// with their parent scene object.
+///
+/// @param[in] subMeshIndex  Sub-mesh index.
+/// @param[in] rSceneObject  Parent scene object of the sub-mesh.
+/// @param[in] rFrustum      World-space frustum.
+///
+/// @return  True if the sub-mesh may be visible, false if it lies entirely outside the frustum.
+///
+/// @see GraphicsSceneObject::SubMeshData::SetLocalBounds()
+bool GraphicsScene::IsSubMeshInFrustum(
+	size_t subMeshIndex,
+	const GraphicsSceneObject& rSceneObject,
+	const Simd::Frustum& rFrustum ) const
+{
+	HELIUM_ASSERT( m_sceneObjectSubMeshes.IsElementValid( subMeshIndex ) );
 
-	size_t subMeshCount = m_sceneObjectSubMeshes.GetSize();
-	for ( size_t subMeshIndex = 0; subMeshIndex < subMeshCount; ++subMeshIndex )
+	const Simd::AaBox* pLocalBounds = m_sceneObjectSubMeshes[subMeshIndex].GetLocalBounds();
+	if ( !pLocalBounds )
+	{
+		return true;
+	}
+
+	Simd::AaBox worldBounds = *pLocalBounds;
+	worldBounds.TransformBy( rSceneObject.GetTransform() );
+
+	return rFrustum.Intersects( worldBounds );
+}
+
+/// Find runs of consecutive sub-meshes that draw the same mesh data with the same material, and can therefore be
+/// drawn using a single instanced draw call.
+///
+/// @param[in]  rSubMeshIndices   Sorted list of sub-mesh indices.
+/// @param[in]  rSceneObjectLods  Level of detail drawn for each scene object, indexed by scene object ID.
+/// @param[out] rInstanceCounts  Number of sub-meshes in the run starting at each position in the sub-mesh list, or zero
+///                              if no run of two or more sub-meshes starts at that position.  Existing contents are
+///                              discarded.
+///
+/// @see CanInstanceSubMesh()
+void GraphicsScene::FindInstanceRuns(
+	const DynamicArray< size_t >& rSubMeshIndices,
+	const DynamicArray< uint8_t >& rSceneObjectLods,
+	DynamicArray< uint32_t >& rInstanceCounts ) const
+{
+	size_t subMeshIndexCount = rSubMeshIndices.GetSize();
+
+	rInstanceCounts.Resize( 0 );
+	rInstanceCounts.Add( 0, subMeshIndexCount );
+
+	size_t runStart = 0;
+	while ( runStart < subMeshIndexCount )
 	{
-		if ( m_sceneObjectSubMeshes.IsElementValid( subMeshIndex ) )
+		size_t runEnd = runStart + 1;
+
+		size_t firstSubMeshIndex = rSubMeshIndices[runStart];
+		if ( CanInstanceSubMesh( firstSubMeshIndex ) )
 		{
-			size_t sceneObjectId = m_sceneObjectSubMeshes[subMeshIndex].GetSceneObjectId();
-			HELIUM_ASSERT( sceneObjectId < m_visibleSceneObjects.GetSize() );
-			if ( m_visibleSceneObjects[sceneObjectId] )
+			const GraphicsSceneObject::SubMeshData& rFirstSubMesh = m_sceneObjectSubMeshes[firstSubMeshIndex];
+			const GraphicsSceneObject& rFirstSceneObject = m_sceneObjects[rFirstSubMesh.GetSceneObjectId()];
+
+			size_t firstSceneObjectId = rFirstSubMesh.GetSceneObjectId();
+			uint32_t firstStartIndex;
+			uint32_t firstPrimitiveCount;
+			rFirstSubMesh.GetIndexRange(
+				( firstSceneObjectId < rSceneObjectLods.GetSize() ? rSceneObjectLods[firstSceneObjectId] : 0 ),
+				firstStartIndex,
+				firstPrimitiveCount );
+
+			for ( ; runEnd < subMeshIndexCount; ++runEnd )
 			{
-				m_sceneObjectSubMeshIndices.Push( subMeshIndex );
+				size_t subMeshIndex = rSubMeshIndices[runEnd];
+				if ( !CanInstanceSubMesh( subMeshIndex ) )
+				{
+					break;
+				}
+
+				const GraphicsSceneObject::SubMeshData& rSubMesh = m_sceneObjectSubMeshes[subMeshIndex];
+				const GraphicsSceneObject& rSceneObject = m_sceneObjects[rSubMesh.GetSceneObjectId()];
+
+				size_t sceneObjectId = rSubMesh.GetSceneObjectId();
+				uint32_t startIndex;
+				uint32_t primitiveCount;
+				rSubMesh.GetIndexRange(
+					( sceneObjectId < rSceneObjectLods.GetSize() ? rSceneObjectLods[sceneObjectId] : 0 ),
+					startIndex,
+					primitiveCount );
+
+				if ( rSubMesh.GetMaterial().Get() != rFirstSubMesh.GetMaterial().Get() ||
+					rSceneObject.GetVertexBuffer() != rFirstSceneObject.GetVertexBuffer() ||
+					rSceneObject.GetIndexBuffer() != rFirstSceneObject.GetIndexBuffer() ||
+					rSceneObject.GetVertexDescription() != rFirstSceneObject.GetVertexDescription() ||
+					rSubMesh.GetPrimitiveType() != rFirstSubMesh.GetPrimitiveType() ||
+					primitiveCount != firstPrimitiveCount ||
+					rSubMesh.GetStartVertex() != rFirstSubMesh.GetStartVertex() ||
+					rSubMesh.GetVertexRange() != rFirstSubMesh.GetVertexRange() ||
+					startIndex != firstStartIndex )
+				{
+					break;
+				}
 			}
 		}
+
+		if ( runEnd - runStart > 1 )
+		{
+			rInstanceCounts[runStart] = static_cast<uint32_t>( runEnd - runStart );
+		}
+
+		runStart = runEnd;
+	}
+}
+
+/// Get whether a sub-mesh can be drawn as part of an instanced draw call.
+///
+/// Only sub-meshes of non-skinned scene objects can be instanced, as their per-instance data consists only of their
+/// world transform.
+///
+/// @param[in] subMeshIndex  Index of the sub-mesh to check.
+///
+/// @return  True if the sub-mesh can be instanced, false if not.
+///
+/// @see FindInstanceRuns()
+bool GraphicsScene::CanInstanceSubMesh( size_t subMeshIndex ) const
+{
+	HELIUM_ASSERT( m_sceneObjectSubMeshes.IsElementValid( subMeshIndex ) );
+
+	if ( subMeshIndex < m_subMeshVertexGlobalDataRanges.GetSize() &&
+		IsValid( m_subMeshVertexGlobalDataRanges[subMeshIndex].pageIndex ) )
+	{
+		return false;
+	}
+
+	const GraphicsSceneObject::SubMeshData& rSubMeshData = m_sceneObjectSubMeshes[subMeshIndex];
+	if ( !rSubMeshData.GetMaterial() )
+	{
+		return false;
+	}
+
+	size_t sceneObjectId = rSubMeshData.GetSceneObjectId();
+	HELIUM_ASSERT( m_sceneObjects.IsElementValid( sceneObjectId ) );
+
+	const GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectId];
+	if ( !rSceneObject.GetVertexBuffer() || !rSceneObject.GetIndexBuffer() || !rSceneObject.GetVertexDescription() )
+	{
+		return false;
+	}
+
+	return ( rSceneObject.GetBoneCount() == 0 || !rSceneObject.GetBonePalette() );
+}
+
+/// Render the specified scene view.
+///
+/// The view is rendered through a render graph: the shadow depth pass writes the shadow depth texture, the scene pass
+/// reads it and writes the scene texture, and the screen pass presents the scene texture.  New passes (and transient
+/// textures for them) can be added to the graph here without changing how the existing passes are set up.
+///
+/// @param[in] viewIndex  Index of the scene view to render (can be an invalid element, but must be less than the size
+///                       of the scene view sparse array).
+void GraphicsScene::DrawSceneView( uint_fast32_t viewIndex )
+{
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::DrawSceneView" );
+
+	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
+
+	if ( !m_sceneViews.IsElementValid( viewIndex ) )
+	{
+		return;
+	}
+
+	RConstantBuffer* pViewVertexGlobalDataBuffer =
+		m_viewVertexGlobalDataBuffers[m_constantBufferSetIndex][viewIndex];
+	if ( !pViewVertexGlobalDataBuffer )
+	{
+		return;
+	}
+
+	GraphicsSceneView& rView = m_sceneViews[viewIndex];
+	RRenderContext* pRenderContext = rView.GetRenderContext();
+	if ( !pRenderContext )
+	{
+		return;
 	}
 
 	// Get the renderer interface and the main command proxy for the renderer.
@@ -1197,85 +2696,217 @@ void GraphicsScene::DrawSceneView( uint_fast32_t viewIndex )
 	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
 	HELIUM_ASSERT( pRenderResourceManager );
 
-	// Get the state objects that we will use during rendering.
-	RRasterizerState* pRasterizerStateDefault = pRenderResourceManager->GetRasterizerState(
-		RenderResourceManager::RASTERIZER_STATE_DEFAULT );
-	RBlendState* pBlendStateOpaque = pRenderResourceManager->GetBlendState( RenderResourceManager::BLEND_STATE_OPAQUE );
 	RDepthStencilState* pDepthStateDefault = pRenderResourceManager->GetDepthStencilState(
 		RenderResourceManager::DEPTH_STENCIL_STATE_DEFAULT );
-	RDepthStencilState* pDepthStateNone = pRenderResourceManager->GetDepthStencilState(
-		RenderResourceManager::DEPTH_STENCIL_STATE_NONE );
-	RSamplerState* pSamplerStatePointClamp = pRenderResourceManager->GetSamplerState(
-		RenderResourceManager::TEXTURE_FILTER_POINT,
-		RENDERER_TEXTURE_ADDRESS_MODE_CLAMP );
+
+	// Fill the instance vertex buffer before recording, as the base pass only references it.
+	m_bBaseInstancingEnabled = ( UpdateInstanceVertexBuffer( viewIndex ) != 0 );
+
+	// Record the scene passes on job threads, then submit them in order along with the remaining scene commands.
+	RecordScenePasses( viewIndex );
+
+	// Describe the passes rendering the view.
+	RTexture2d* pSceneTexture = pRenderResourceManager->GetSceneTexture();
+	HELIUM_ASSERT( pSceneTexture );
+	RTexture2d* pShadowDepthTexture = pRenderResourceManager->GetShadowDepthTexture();
+
+	m_renderGraph.Clear();
+
+	m_renderGraphViewIndex = viewIndex;
+	m_renderGraphSceneTextureId = m_renderGraph.ImportTexture( "Scene", pSceneTexture );
+	SetInvalid( m_renderGraphShadowDepthTextureId );
+
+	if ( pShadowDepthTexture )
+	{
+		m_renderGraphShadowDepthTextureId = m_renderGraph.ImportTexture( "ShadowDepth", pShadowDepthTexture );
+
+		uint32_t shadowPassId = m_renderGraph.AddPass( "ShadowDepth", ExecuteShadowDepthGraphPass, this );
+		m_renderGraph.WriteTexture( shadowPassId, m_renderGraphShadowDepthTextureId );
+	}
+
+	uint32_t scenePassId = m_renderGraph.AddPass( "Scene", ExecuteSceneGraphPass, this );
+	if ( IsValid( m_renderGraphShadowDepthTextureId ) )
+	{
+		m_renderGraph.ReadTexture( scenePassId, m_renderGraphShadowDepthTextureId );
+	}
+	m_renderGraph.WriteTexture( scenePassId, m_renderGraphSceneTextureId );
+
+	uint32_t screenPassId = m_renderGraph.AddPass( "Screen", ExecuteScreenGraphPass, this );
+	m_renderGraph.ReadTexture( screenPassId, m_renderGraphSceneTextureId );
+	m_renderGraph.KeepPass( screenPassId );
 
 	// Set the default depth state.
 	spCommandProxy->SetDepthStencilState( pDepthStateDefault, 0 );
 
-	// Draw shadow depth pass (this will also set up the shadow depth scene as needed).
-	DrawShadowDepthPass( viewIndex );
+	m_renderGraph.Execute( spCommandProxy );
+
+	// Drop any recorded passes the graph did not use, so that they are not left over for the next view.
+	for ( size_t passIndex = RECORDED_PASS_FIRST; passIndex < RECORDED_PASS_MAX; ++passIndex )
+	{
+		m_passCommandLists[passIndex].Release();
+	}
+
+	m_renderGraph.Clear();
+	SetInvalid( m_renderGraphViewIndex );
+
+	spCommandProxy->UnbindResources();
+
+	pRenderContext->Swap();
+}
+
+/// Draw the depth pre-pass, base pass, and world-space buffered draw calls of a scene view into the scene texture.
+///
+/// @param[in] viewIndex      Index of the scene view being rendered.
+/// @param[in] pSceneTexture  Scene texture to render into.
+/// @param[in] pCommandProxy  Command proxy through which to issue the rendering commands.
+///
+/// @see DrawSceneView(), DrawSceneTextureToScreen()
+void GraphicsScene::DrawSceneTexture(
+	uint_fast32_t viewIndex, RTexture2d* pSceneTexture, RRenderCommandProxy* pCommandProxy )
+{
+	HELIUM_ASSERT( pSceneTexture );
+	HELIUM_ASSERT( pCommandProxy );
+
+	GraphicsSceneView& rView = m_sceneViews[viewIndex];
+
+	RConstantBuffer* pViewVertexGlobalDataBuffer =
+		m_viewVertexGlobalDataBuffers[m_constantBufferSetIndex][viewIndex];
+	HELIUM_ASSERT( pViewVertexGlobalDataBuffer );
+
+	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+	HELIUM_ASSERT( pRenderResourceManager );
+
+	RRasterizerState* pRasterizerStateDefault = pRenderResourceManager->GetRasterizerState(
+		RenderResourceManager::RASTERIZER_STATE_DEFAULT );
 
 	// Set up normal scene rendering.
 	RSurface* pDepthStencilSurface = rView.GetDepthStencilSurface();
 
 	// Depth-stencil surfaces can be null, so we don't assert on the depth-stencil surface returned.
-	RTexture2dPtr spSceneTexture = pRenderResourceManager->GetSceneTexture();
-	HELIUM_ASSERT( spSceneTexture );
-	RSurfacePtr spSceneTextureSurface = spSceneTexture->GetSurface( 0 );
+	RSurfacePtr spSceneTextureSurface = pSceneTexture->GetSurface( 0 );
 	HELIUM_ASSERT( spSceneTextureSurface );
 
-	spCommandProxy->SetRenderSurfaces( spSceneTextureSurface, pDepthStencilSurface );
+	pCommandProxy->SetRenderSurfaces( spSceneTextureSurface, pDepthStencilSurface );
 
-	spCommandProxy->SetViewport(
-		rView.GetViewportX(),
-		rView.GetViewportY(),
+	// The scene is rendered into the top-left corner of the scene texture at the current dynamic resolution, and
+	// scaled up to the view's viewport when it is drawn to the screen, so the render targets never need resizing.
+	uint32_t sceneWidth;
+	uint32_t sceneHeight;
+	pRenderResourceManager->GetScaledViewportSize(
 		rView.GetViewportWidth(),
-		rView.GetViewportHeight() );
+		rView.GetViewportHeight(),
+		sceneWidth,
+		sceneHeight );
+
+	pCommandProxy->SetViewport( 0, 0, sceneWidth, sceneHeight );
 
-	spCommandProxy->BeginScene();
-	spCommandProxy->Clear( RENDERER_CLEAR_FLAG_ALL, rView.GetClearColor() );
+	pCommandProxy->BeginScene();
+	pCommandProxy->Clear( RENDERER_CLEAR_FLAG_ALL, rView.GetClearColor() );
 
-	spCommandProxy->SetRasterizerState( pRasterizerStateDefault );
-	spCommandProxy->SetVertexConstantBuffers( 0, 1, &pViewVertexGlobalDataBuffer );
+	pCommandProxy->SetRasterizerState( pRasterizerStateDefault );
+	pCommandProxy->SetVertexConstantBuffers( 0, 1, &pViewVertexGlobalDataBuffer );
 
 	// Draw passes...
-	DrawDepthPrePass( viewIndex );
-	DrawBasePass( viewIndex );
+	SubmitScenePass( RECORDED_PASS_DEPTH_PRE_PASS, viewIndex, pCommandProxy );
+	SubmitScenePass( RECORDED_PASS_BASE, viewIndex, pCommandProxy );
 
 #if GRAPHICS_SCENE_BUFFERED_DRAWER
 	// Draw buffered world-space draw calls for the current scene and view.
+	static const char bufferedDrawerPassName[] = "BufferedDrawer";
+	const char* pPreviousPassName = RenderStatistics::SetPass( bufferedDrawerPassName );
+	uint32_t bufferedDrawerTimingIndex = BeginGpuTiming( bufferedDrawerPassName, pCommandProxy );
+
+	BufferedDrawer& rSceneDrawer = m_sceneBufferedDrawers[m_renderBufferedDrawerSetIndex];
+	const DynamicArray< BufferedDrawer* >& rViewDrawers = m_viewBufferedDrawers[m_renderBufferedDrawerSetIndex];
+
 	const Simd::Matrix44& rInverseViewProjectionMatrix = rView.GetInverseViewProjectionMatrix();
-	m_sceneBufferedDrawer.DrawWorldElements( rInverseViewProjectionMatrix );
+	rSceneDrawer.DrawWorldElements( rInverseViewProjectionMatrix );
 
-	if ( viewIndex < m_viewBufferedDrawers.GetSize() )
+	if ( viewIndex < rViewDrawers.GetSize() )
 	{
-		BufferedDrawer* pDrawer = m_viewBufferedDrawers[viewIndex];
+		BufferedDrawer* pDrawer = rViewDrawers[viewIndex];
 		if ( pDrawer )
 		{
 			pDrawer->DrawWorldElements( rInverseViewProjectionMatrix );
 		}
 	}
+
+	EndGpuTiming( bufferedDrawerTimingIndex, pCommandProxy );
+	RenderStatistics::SetPass( pPreviousPassName );
 #endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 
-	spCommandProxy->EndScene();
+	pCommandProxy->EndScene();
+}
+
+/// Draw the scene texture of a scene view to its viewport on screen, followed by the screen-space buffered draw
+/// calls.
+///
+/// @param[in] viewIndex      Index of the scene view being rendered.
+/// @param[in] pSceneTexture  Scene texture holding the rendered scene.
+/// @param[in] pCommandProxy  Command proxy through which to issue the rendering commands.
+///
+/// @see DrawSceneView(), DrawSceneTexture()
+void GraphicsScene::DrawSceneTextureToScreen(
+	uint_fast32_t viewIndex, RTexture2d* pSceneTexture, RRenderCommandProxy* pCommandProxy )
+{
+	HELIUM_ASSERT( pSceneTexture );
+	HELIUM_ASSERT( pCommandProxy );
+
+	GraphicsSceneView& rView = m_sceneViews[viewIndex];
+	RRenderContext* pRenderContext = rView.GetRenderContext();
+	HELIUM_ASSERT( pRenderContext );
+
+	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+	HELIUM_ASSERT( pRenderResourceManager );
+
+	RRasterizerState* pRasterizerStateDefault = pRenderResourceManager->GetRasterizerState(
+		RenderResourceManager::RASTERIZER_STATE_DEFAULT );
+	RBlendState* pBlendStateOpaque = pRenderResourceManager->GetBlendState( RenderResourceManager::BLEND_STATE_OPAQUE );
+	RDepthStencilState* pDepthStateNone = pRenderResourceManager->GetDepthStencilState(
+		RenderResourceManager::DEPTH_STENCIL_STATE_NONE );
+	RSamplerState* pSamplerStatePointClamp = pRenderResourceManager->GetSamplerState(
+		RenderResourceManager::TEXTURE_FILTER_POINT,
+		RENDERER_TEXTURE_ADDRESS_MODE_CLAMP );
+
+	uint32_t sceneWidth;
+	uint32_t sceneHeight;
+	pRenderResourceManager->GetScaledViewportSize(
+		rView.GetViewportWidth(),
+		rView.GetViewportHeight(),
+		sceneWidth,
+		sceneHeight );
 
 	// Draw the scene texture to the screen.
 	RSurface* pBackBuffer = pRenderContext->GetBackBufferSurface();
 	HELIUM_ASSERT( pBackBuffer );
-	spCommandProxy->SetRenderSurfaces( pBackBuffer, NULL );
+	pCommandProxy->SetRenderSurfaces( pBackBuffer, NULL );
 
-	spCommandProxy->SetViewport(
+	pCommandProxy->SetViewport(
 		rView.GetViewportX(),
 		rView.GetViewportY(),
 		rView.GetViewportWidth(),
 		rView.GetViewportHeight() );
 
-	spCommandProxy->BeginScene();
+	pCommandProxy->BeginScene();
 
-	spCommandProxy->SetRasterizerState( pRasterizerStateDefault );
-	spCommandProxy->SetBlendState( pBlendStateOpaque );
-	spCommandProxy->SetDepthStencilState( pDepthStateNone, 0 );
-	spCommandProxy->SetSamplerStates( 0, 1, &pSamplerStatePointClamp );
+	static const char screenPassName[] = "Screen";
+	const char* pPreviousScreenPassName = RenderStatistics::SetPass( screenPassName );
+	uint32_t screenTimingIndex = BeginGpuTiming( screenPassName, pCommandProxy );
+
+	pCommandProxy->SetRasterizerState( pRasterizerStateDefault );
+	pCommandProxy->SetBlendState( pBlendStateOpaque );
+	pCommandProxy->SetDepthStencilState( pDepthStateNone, 0 );
+	if ( sceneWidth == rView.GetViewportWidth() && sceneHeight == rView.GetViewportHeight() )
+	{
+		pCommandProxy->SetSamplerStates( 0, 1, &pSamplerStatePointClamp );
+	}
+	else
+	{
+		RSamplerState* pSamplerStateLinearClamp = pRenderResourceManager->GetSamplerState(
+			RenderResourceManager::TEXTURE_FILTER_LINEAR,
+			RENDERER_TEXTURE_ADDRESS_MODE_CLAMP );
+		pCommandProxy->SetSamplerStates( 0, 1, &pSamplerStateLinearClamp );
+	}
 
 	DynamicDrawer* pDynamicDrawer = DynamicDrawer::GetInstance();
 	HELIUM_ASSERT( pDynamicDrawer );
@@ -1289,10 +2920,10 @@ void GraphicsScene::DrawSceneView( uint_fast32_t viewIndex )
 
 	Float32 floatPacker;
 
-	floatPacker.value = viewportWidthFloat / static_cast<float32_t>( spSceneTexture->GetWidth() );
+	floatPacker.value = static_cast<float32_t>( sceneWidth ) / static_cast<float32_t>( pSceneTexture->GetWidth() );
 	Float16 sceneWidthFloat16 = Float32To16( floatPacker );
 
-	floatPacker.value = viewportHeightFloat / static_cast<float32_t>( spSceneTexture->GetHeight() );
+	floatPacker.value = static_cast<float32_t>( sceneHeight ) / static_cast<float32_t>( pSceneTexture->GetHeight() );
 	Float16 sceneHeightFloat16 = Float32To16( floatPacker );
 
 	float32_t halfPixelX = 1.0f / viewportWidthFloat;
@@ -1309,54 +2940,200 @@ void GraphicsScene::DrawSceneView( uint_fast32_t viewIndex )
 		SimpleTexturedVertex( quadMinX, quadMinY, 0.0f, zeroFloat16, zeroFloat16 ),
 		SimpleTexturedVertex( quadMaxX, quadMinY, 0.0f, sceneWidthFloat16, zeroFloat16 ),
 		SimpleTexturedVertex( quadMaxX, quadMaxY, 0.0f, sceneWidthFloat16, sceneHeightFloat16 ),
-		spSceneTexture );
+		pSceneTexture );
 	pDynamicDrawer->Flush();
 #endif
 
-#if GRAPHICS_SCENE_BUFFERED_DRAWER
-	// Draw buffered screen-space draw calls for the current scene and view.
-	RConstantBuffer* pScreenSpaceVertexConstantBuffer =
-		m_viewVertexScreenDataBuffers[m_constantBufferSetIndex][viewIndex];
-	if ( pScreenSpaceVertexConstantBuffer )
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+	// Draw buffered screen-space draw calls for the current scene and view.
+	BufferedDrawer& rSceneDrawer = m_sceneBufferedDrawers[m_renderBufferedDrawerSetIndex];
+	const DynamicArray< BufferedDrawer* >& rViewDrawers = m_viewBufferedDrawers[m_renderBufferedDrawerSetIndex];
+
+	RConstantBuffer* pScreenSpaceVertexConstantBuffer =
+		m_viewVertexScreenDataBuffers[m_constantBufferSetIndex][viewIndex];
+	if ( pScreenSpaceVertexConstantBuffer )
+	{
+		pCommandProxy->SetVertexConstantBuffers( 0, 1, &pScreenSpaceVertexConstantBuffer );
+		pCommandProxy->SetRasterizerState( pRasterizerStateDefault );
+
+		RBlendState* pBlendStateTranslucent = pRenderResourceManager->GetBlendState(
+			RenderResourceManager::BLEND_STATE_TRANSPARENT );
+		pCommandProxy->SetBlendState( pBlendStateTranslucent );
+
+		rSceneDrawer.DrawScreenElements();
+
+		if ( viewIndex < rViewDrawers.GetSize() )
+		{
+			BufferedDrawer* pDrawer = rViewDrawers[viewIndex];
+			if ( pDrawer )
+			{
+				pDrawer->DrawScreenElements();
+			}
+		}
+	}
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
+
+	EndGpuTiming( screenTimingIndex, pCommandProxy );
+	RenderStatistics::SetPass( pPreviousScreenPassName );
+
+	pCommandProxy->EndScene();
+}
+
+/// Record the shadow depth, depth pre-pass, and base passes for a scene view into separate command lists in
+/// parallel.
+///
+/// Passes are left unrecorded if the renderer does not support deferred command proxies, in which case they are
+/// drawn directly when submitted.
+///
+/// @param[in] viewIndex  Index of the scene view being rendered.
+///
+/// @see SubmitScenePass(), DrawSceneView()
+void GraphicsScene::RecordScenePasses( uint_fast32_t viewIndex )
+{
+	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
+	HELIUM_ASSERT( m_sceneViews.IsElementValid( viewIndex ) );
+
+	Renderer* pRenderer = Renderer::GetInstance();
+	HELIUM_ASSERT( pRenderer );
+
+	for ( size_t passIndex = RECORDED_PASS_FIRST; passIndex < RECORDED_PASS_MAX; ++passIndex )
+	{
+		HELIUM_ASSERT( !m_passCommandLists[passIndex] );
+
+		if ( !m_passCommandProxies[passIndex] )
+		{
+			m_passCommandProxies[passIndex] = pRenderer->CreateDeferredCommandProxy();
+			if ( !m_passCommandProxies[passIndex] )
+			{
+				return;
+			}
+		}
+	}
+
+	m_recordingViewIndex = viewIndex;
+	JobManager::ParallelFor( RecordScenePassCallback, this, RECORDED_PASS_MAX );
+	SetInvalid( m_recordingViewIndex );
+}
+
+/// Submit a scene view pass for rendering, executing its recorded command list if one is available or drawing it
+/// directly otherwise.
+///
+/// @param[in] pass           Pass to submit.
+/// @param[in] viewIndex      Index of the scene view being rendered.
+/// @param[in] pCommandProxy  Immediate command proxy through which to submit the pass.
+///
+/// @see RecordScenePasses(), DrawSceneView()
+void GraphicsScene::SubmitScenePass( ERecordedPass pass, uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy )
+{
+	HELIUM_ASSERT( static_cast<size_t>( pass ) < RECORDED_PASS_MAX );
+	HELIUM_ASSERT( pCommandProxy );
+
+	static const char* const passNames[] =
 	{
-		spCommandProxy->SetVertexConstantBuffers( 0, 1, &pScreenSpaceVertexConstantBuffer );
-		spCommandProxy->SetRasterizerState( pRasterizerStateDefault );
+		"ShadowDepth",   // RECORDED_PASS_SHADOW_DEPTH
+		"DepthPrePass",  // RECORDED_PASS_DEPTH_PRE_PASS
+		"Base",          // RECORDED_PASS_BASE
+	};
 
-		RBlendState* pBlendStateTranslucent = pRenderResourceManager->GetBlendState(
-			RenderResourceManager::BLEND_STATE_TRANSPARENT );
-		spCommandProxy->SetBlendState( pBlendStateTranslucent );
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( passNames ) == RECORDED_PASS_MAX );
 
-		m_sceneBufferedDrawer.DrawScreenElements();
+	// Recorded command lists are replayed through the immediate proxy here, so draws and binds are attributed to the
+	// pass being submitted.
+	const char* pPreviousPassName = RenderStatistics::SetPass( passNames[pass] );
+	uint32_t timingIndex = BeginGpuTiming( passNames[pass], pCommandProxy );
 
-		if ( viewIndex < m_viewBufferedDrawers.GetSize() )
-		{
-			BufferedDrawer* pDrawer = m_viewBufferedDrawers[viewIndex];
-			if ( pDrawer )
-			{
-				pDrawer->DrawScreenElements();
-			}
-		}
+	RRenderCommandListPtr& rspCommandList = m_passCommandLists[pass];
+	if ( rspCommandList )
+	{
+		pCommandProxy->ExecuteCommandList( rspCommandList );
+		rspCommandList.Release();
+	}
+	else
+	{
+		DrawScenePass( pass, viewIndex, pCommandProxy );
 	}
-#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 
-	spCommandProxy->EndScene();
+	EndGpuTiming( timingIndex, pCommandProxy );
+	RenderStatistics::SetPass( pPreviousPassName );
+}
 
-	spCommandProxy->UnbindResources();
+/// Start measuring the GPU time of a pass, if GPU timing is supported.
+///
+/// @param[in] pName          Pass name (static string).
+/// @param[in] pCommandProxy  Immediate command proxy through which the pass is issued.
+///
+/// @return  Timing index to pass to EndGpuTiming(), or an invalid index if the pass is not timed.
+///
+/// @see EndGpuTiming()
+uint32_t GraphicsScene::BeginGpuTiming( const char* pName, RRenderCommandProxy* pCommandProxy )
+{
+	GpuTimerManager* pGpuTimerManager = GpuTimerManager::GetInstance();
+	if ( !pGpuTimerManager )
+	{
+		return Invalid< uint32_t >();
+	}
 
-	pRenderContext->Swap();
+	return pGpuTimerManager->BeginPass( pCommandProxy, pName );
+}
+
+/// Finish measuring the GPU time of a pass.
+///
+/// @param[in] timingIndex    Timing index returned by BeginGpuTiming().
+/// @param[in] pCommandProxy  Immediate command proxy through which the pass is issued.
+///
+/// @see BeginGpuTiming()
+void GraphicsScene::EndGpuTiming( uint32_t timingIndex, RRenderCommandProxy* pCommandProxy )
+{
+	GpuTimerManager* pGpuTimerManager = GpuTimerManager::GetInstance();
+	if ( pGpuTimerManager )
+	{
+		pGpuTimerManager->EndPass( pCommandProxy, timingIndex );
+	}
+}
+
+/// Draw a scene view pass through the given command proxy.
+///
+/// @param[in] pass           Pass to draw.
+/// @param[in] viewIndex      Index of the scene view being rendered.
+/// @param[in] pCommandProxy  Command proxy through which to issue the pass rendering commands.
+///
+/// @see DrawShadowDepthPass(), DrawDepthPrePass(), DrawBasePass()
+void GraphicsScene::DrawScenePass( ERecordedPass pass, uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy )
+{
+	switch ( pass )
+	{
+	case RECORDED_PASS_SHADOW_DEPTH:
+		DrawShadowDepthPass( viewIndex, pCommandProxy );
+		break;
+
+	case RECORDED_PASS_DEPTH_PRE_PASS:
+		DrawDepthPrePass( viewIndex, pCommandProxy );
+		break;
+
+	case RECORDED_PASS_BASE:
+		DrawBasePass( viewIndex, pCommandProxy, m_bBaseInstancingEnabled );
+		break;
+
+	default:
+		HELIUM_BREAK();
+		break;
+	}
 }
 
 /// Draw the shadow depth render pass.
 ///
-/// - The m_sceneObjectSubMeshIndices array should already be prepared with the (unsorted) list of visible sub
-///   meshes.  This function will sort by depth if rendering is performed.
+/// - The shadow sub-mesh list for the view should already be prepared by PrepareSceneViews().
 /// - Default rasterizer and depth states should be already set.
 ///
-/// @param[in] viewIndex  Index of the view for which the shadow depth pass is being rendered.
+/// @param[in] viewIndex      Index of the view for which the shadow depth pass is being rendered.
+/// @param[in] pCommandProxy  Command proxy through which to issue the pass rendering commands.
 ///
 /// @see DrawDepthPrePass(), DrawBasePass()
-void GraphicsScene::DrawShadowDepthPass( uint_fast32_t viewIndex )
+void GraphicsScene::DrawShadowDepthPass( uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy )
 {
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::DrawShadowDepthPass" );
+
+	HELIUM_ASSERT( pCommandProxy );
 	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
 	HELIUM_ASSERT( m_sceneViews.IsElementValid( viewIndex ) );
 
@@ -1432,59 +3209,65 @@ void GraphicsScene::DrawShadowDepthPass( uint_fast32_t viewIndex )
 	RSurfacePtr spShadowDepthTextureSurface = pShadowDepthTexture->GetSurface( 0 );
 	HELIUM_ASSERT( spShadowDepthTextureSurface );
 
-	// Sort meshes based on distance from front to back in order to reduce overdraw.
-	size_t subMeshIndexCount = m_sceneObjectSubMeshIndices.GetSize();
-
-	{
-		SortJob< size_t, SubMeshFrontToBackCompare > job;
-
-		SortJob< size_t, SubMeshFrontToBackCompare >::Parameters& rParameters = job.GetParameters();
-		rParameters.pBase = m_sceneObjectSubMeshIndices.GetData();
-		rParameters.count = subMeshIndexCount;
-		rParameters.compare = SubMeshFrontToBackCompare(
-			m_directionalLightDirection,
-			m_sceneObjects,
-			m_sceneObjectSubMeshes );
-		rParameters.singleJobCount = 100;
-
-		job.Run();
-	}
+	// Meshes are already sorted from front to back along the light direction in order to reduce overdraw.
+	HELIUM_ASSERT( viewIndex < m_viewVisibility.GetSize() );
+	const DynamicArray< size_t >& rSubMeshIndices = m_viewVisibility[viewIndex].shadowSubMeshIndices;
+	size_t subMeshIndexCount = rSubMeshIndices.GetSize();
 
 	// Prepare the shadow depth pass scene for rendering.
 	Renderer* pRenderer = Renderer::GetInstance();
 	HELIUM_ASSERT( pRenderer );
 
-	RRenderCommandProxyPtr spCommandProxy = pRenderer->GetImmediateCommandProxy();
-	HELIUM_ASSERT( spCommandProxy );
-
 	RTexture2d* pSceneTexture = pRenderResourceManager->GetSceneTexture();
 	HELIUM_ASSERT( pSceneTexture );
 	RSurfacePtr spSceneTextureSurface = pSceneTexture->GetSurface( 0 );
 	HELIUM_ASSERT( spSceneTextureSurface );
 
-	spCommandProxy->SetRenderSurfaces( spSceneTextureSurface, spShadowDepthTextureSurface );
-	spCommandProxy->SetViewport( 0, 0, shadowDepthTextureUsableSize, shadowDepthTextureUsableSize );
+	// Reuse the shadow depth texture as is if it was last rendered for this view with the same shadow transform and
+	// the same casters, none of which have moved since.
+	HELIUM_ASSERT( viewIndex < m_shadowViewInverseViewProjectionMatrices.GetSize() );
+	const Simd::Matrix44& rShadowViewInvViewProj = m_shadowViewInverseViewProjectionMatrices[viewIndex];
+	uint64_t casterSignature = GetShadowCasterSignature( viewIndex, rSubMeshIndices );
+	if ( m_bShadowDepthCacheValid &&
+		IsValid( casterSignature ) &&
+		casterSignature == m_cachedShadowCasterSignature &&
+		m_pCachedShadowDepthTexture == pShadowDepthTexture &&
+		m_cachedShadowViewIndex == viewIndex &&
+		MemoryCompare( &m_cachedShadowInverseViewProjection, &rShadowViewInvViewProj, sizeof( Simd::Matrix44 ) ) == 0 )
+	{
+		return;
+	}
+
+	m_bShadowDepthCacheValid = IsValid( casterSignature );
+	m_cachedShadowCasterSignature = casterSignature;
+	m_pCachedShadowDepthTexture = pShadowDepthTexture;
+	m_cachedShadowViewIndex = static_cast<uint32_t>( viewIndex );
+	m_cachedShadowInverseViewProjection = rShadowViewInvViewProj;
+
+	pCommandProxy->SetRenderSurfaces( spSceneTextureSurface, spShadowDepthTextureSurface );
+	pCommandProxy->SetViewport( 0, 0, shadowDepthTextureUsableSize, shadowDepthTextureUsableSize );
 
 	RRasterizerState* pRasterizerStateShadowDepth = pRenderResourceManager->GetRasterizerState(
 		RenderResourceManager::RASTERIZER_STATE_SHADOW_DEPTH );
-	spCommandProxy->SetRasterizerState( pRasterizerStateShadowDepth );
+	pCommandProxy->SetRasterizerState( pRasterizerStateShadowDepth );
 
 	RBlendState* pBlendStateNoColor = pRenderResourceManager->GetBlendState(
 		RenderResourceManager::BLEND_STATE_NO_COLOR );
-	spCommandProxy->SetBlendState( pBlendStateNoColor );
+	pCommandProxy->SetBlendState( pBlendStateNoColor );
 
 	// Draw the scene.
-	spCommandProxy->BeginScene();
-	spCommandProxy->Clear( RENDERER_CLEAR_FLAG_DEPTH );
+	pCommandProxy->BeginScene();
+	pCommandProxy->Clear( RENDERER_CLEAR_FLAG_DEPTH );
 
-	spCommandProxy->SetVertexConstantBuffers( 0, 1, &pShadowViewVertexDataBuffer );
-	spCommandProxy->SetPixelShader( NULL );
+	pCommandProxy->SetVertexConstantBuffers( 0, 1, &pShadowViewVertexDataBuffer );
+	pCommandProxy->SetPixelShader( NULL );
 
+	// Casters that can't be drawn this frame may be drawable later, so don't reuse the result if any are skipped.
 	RVertexShader* pPreviousVertexShader = NULL;
 
 	for ( size_t meshIndexIndex = 0; meshIndexIndex < subMeshIndexCount; ++meshIndexIndex )
 	{
-		size_t meshIndex = m_sceneObjectSubMeshIndices[meshIndexIndex];
+		size_t meshIndex = rSubMeshIndices[meshIndexIndex];
 		HELIUM_ASSERT( m_sceneObjectSubMeshes.IsElementValid( meshIndex ) );
 
 		GraphicsSceneObject::SubMeshData& rSubMeshData = m_sceneObjectSubMeshes[meshIndex];
@@ -1494,16 +3277,15 @@ void GraphicsScene::DrawShadowDepthPass( uint_fast32_t viewIndex )
 		HELIUM_ASSERT( sceneObjectId < m_sceneObjects.GetSize() );
 		HELIUM_ASSERT( m_sceneObjects.IsElementValid( sceneObjectId ) );
 
-		HELIUM_ASSERT( meshIndex < m_subMeshVertexGlobalDataBuffers.GetSize() );
-		RConstantBuffer* pInstanceVertexGlobalDataBuffer = m_subMeshVertexGlobalDataBuffers[meshIndex];
+		size_t instanceVertexGlobalDataOffset;
+		size_t instanceVertexGlobalDataSize;
+		RConstantBuffer* pInstanceVertexGlobalDataBuffer = GetInstanceVertexGlobalData(
+			meshIndex, sceneObjectId, instanceVertexGlobalDataOffset, instanceVertexGlobalDataSize );
 		if ( !pInstanceVertexGlobalDataBuffer )
 		{
-			HELIUM_ASSERT( sceneObjectId < m_objectVertexGlobalDataBuffers.GetSize() );
-			pInstanceVertexGlobalDataBuffer = m_objectVertexGlobalDataBuffers[sceneObjectId];
-			if ( !pInstanceVertexGlobalDataBuffer )
-			{
-				continue;
-			}
+			m_bShadowDepthCacheValid = false;
+
+			continue;
 		}
 
 		GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectId];
@@ -1511,18 +3293,24 @@ void GraphicsScene::DrawShadowDepthPass( uint_fast32_t viewIndex )
 		RVertexBuffer* pVertexBuffer = rSceneObject.GetVertexBuffer();
 		if ( !pVertexBuffer )
 		{
+			m_bShadowDepthCacheValid = false;
+
 			continue;
 		}
 
 		RVertexDescription* pVertexDescription = rSceneObject.GetVertexDescription();
 		if ( !pVertexDescription )
 		{
+			m_bShadowDepthCacheValid = false;
+
 			continue;
 		}
 
 		RIndexBuffer* pIndexBuffer = rSceneObject.GetIndexBuffer();
 		if ( !pIndexBuffer )
 		{
+			m_bShadowDepthCacheValid = false;
+
 			continue;
 		}
 
@@ -1536,10 +3324,11 @@ void GraphicsScene::DrawShadowDepthPass( uint_fast32_t viewIndex )
 			pVertexShader = pPrePassSmoothSkinningVertexShader;
 		}
 
-		pVertexShader->CacheDescription( pRenderer, pVertexDescription );
-		RVertexInputLayout* pInputLayout = pVertexShader->GetCachedInputLayout();
+		RVertexInputLayout* pInputLayout = pVertexShader->GetInputLayout( pRenderer, pVertexDescription );
 		if ( !pInputLayout )
 		{
+			m_bShadowDepthCacheValid = false;
+
 			continue;
 		}
 
@@ -1547,23 +3336,25 @@ void GraphicsScene::DrawShadowDepthPass( uint_fast32_t viewIndex )
 		uint32_t offset = 0;
 
 		ERendererPrimitiveType primitiveType = rSubMeshData.GetPrimitiveType();
-		uint32_t primitiveCount = rSubMeshData.GetPrimitiveCount();
 		uint32_t startVertex = rSubMeshData.GetStartVertex();
 		uint32_t vertexRange = rSubMeshData.GetVertexRange();
-		uint32_t startIndex = rSubMeshData.GetStartIndex();
+		uint32_t startIndex;
+		uint32_t primitiveCount;
+		rSubMeshData.GetIndexRange( GetSceneObjectLod( viewIndex, sceneObjectId ), startIndex, primitiveCount );
 
 		if ( pPreviousVertexShader != pVertexShader )
 		{
-			spCommandProxy->SetVertexShader( pVertexShader );
+			pCommandProxy->SetVertexShader( pVertexShader );
 			pPreviousVertexShader = pVertexShader;
 		}
 
-		spCommandProxy->SetVertexConstantBuffers( 1, 1, &pInstanceVertexGlobalDataBuffer );
-		spCommandProxy->SetVertexBuffers( 0, 1, &pVertexBuffer, &vertexStride, &offset );
-		spCommandProxy->SetIndexBuffer( pIndexBuffer );
-		spCommandProxy->SetVertexInputLayout( pInputLayout );
+		pCommandProxy->SetVertexConstantBuffers(
+			1, 1, &pInstanceVertexGlobalDataBuffer, &instanceVertexGlobalDataSize, &instanceVertexGlobalDataOffset );
+		pCommandProxy->SetVertexBuffers( 0, 1, &pVertexBuffer, &vertexStride, &offset );
+		pCommandProxy->SetIndexBuffer( pIndexBuffer );
+		pCommandProxy->SetVertexInputLayout( pInputLayout );
 
-		spCommandProxy->DrawIndexed(
+		pCommandProxy->DrawIndexed(
 			primitiveType,
 			startVertex,
 			0,
@@ -1572,22 +3363,74 @@ void GraphicsScene::DrawShadowDepthPass( uint_fast32_t viewIndex )
 			primitiveCount );
 	}
 
-	spCommandProxy->EndScene();
+	pCommandProxy->EndScene();
+}
+
+/// Compute a signature identifying the shadow casters to render into the shadow depth texture and how they are drawn.
+///
+/// @param[in] viewIndex        Index of the scene view being rendered.
+/// @param[in] rSubMeshIndices  Indices of the sub-meshes to render into the shadow depth texture.
+///
+/// @return  Caster signature, or an invalid value if any of the casters is skinned or moved this frame, in which
+///          case the shadow depth texture can't be reused.
+uint64_t GraphicsScene::GetShadowCasterSignature(
+	uint_fast32_t viewIndex, const DynamicArray< size_t >& rSubMeshIndices ) const
+{
+	uint64_t signature = 14695981039346656037ULL;
+
+	size_t subMeshIndexCount = rSubMeshIndices.GetSize();
+	for ( size_t meshIndexIndex = 0; meshIndexIndex < subMeshIndexCount; ++meshIndexIndex )
+	{
+		size_t meshIndex = rSubMeshIndices[meshIndexIndex];
+		const GraphicsSceneObject::SubMeshData& rSubMeshData = m_sceneObjectSubMeshes[meshIndex];
+
+		size_t sceneObjectId = rSubMeshData.GetSceneObjectId();
+		const GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectId];
+		if ( ( rSceneObject.GetBoneCount() != 0 && rSceneObject.GetBonePalette() ) ||
+			( sceneObjectId < m_objectTransformUpdatedFlags.GetSize() && m_objectTransformUpdatedFlags[sceneObjectId] ) )
+		{
+			return Invalid< uint64_t >();
+		}
+
+		uint32_t startIndex;
+		uint32_t primitiveCount;
+		rSubMeshData.GetIndexRange( GetSceneObjectLod( viewIndex, sceneObjectId ), startIndex, primitiveCount );
+
+		uint64_t values[] =
+		{
+			meshIndex,
+			reinterpret_cast<uintptr_t>( rSceneObject.GetVertexBuffer() ),
+			reinterpret_cast<uintptr_t>( rSceneObject.GetIndexBuffer() ),
+			rSubMeshData.GetStartVertex(),
+			startIndex,
+			primitiveCount
+		};
+
+		for ( size_t valueIndex = 0; valueIndex < HELIUM_ARRAY_COUNT( values ); ++valueIndex )
+		{
+			signature = ( signature ^ values[valueIndex] ) * 1099511628211ULL;
+		}
+	}
+
+	return signature;
 }
 
 /// Draw the depth-only pre-pass for the given scene view.
 ///
-/// - The m_sceneObjectSubMeshIndices array should already be prepared with the (unsorted) list of visible sub
-///   meshes.  This function will sort by depth if rendering is performed.
+/// - The depth pre-pass sub-mesh list for the view should already be prepared by PrepareSceneViews().
 /// - Standard viewport render surfaces are expected to have already been set, with the depth buffer cleared.
 /// - Default rasterizer and depth states should be already set.
 /// - Global per-view constant buffers should be already set.
 ///
-/// @param[in] viewIndex  Index of the view for which the depth-only pre-pass is being rendered.
+/// @param[in] viewIndex      Index of the view for which the depth-only pre-pass is being rendered.
+/// @param[in] pCommandProxy  Command proxy through which to issue the pass rendering commands.
 ///
 /// @see DrawShadowDepthPass(), DrawBasePass()
-void GraphicsScene::DrawDepthPrePass( uint_fast32_t viewIndex )
+void GraphicsScene::DrawDepthPrePass( uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy )
 {
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::DrawDepthPrePass" );
+
+	HELIUM_ASSERT( pCommandProxy );
 	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
 	HELIUM_ASSERT( m_sceneViews.IsElementValid( viewIndex ) );
 
@@ -1637,41 +3480,27 @@ void GraphicsScene::DrawDepthPrePass( uint_fast32_t viewIndex )
 	HELIUM_ASSERT( pPrePassShaderResource->GetType() == RShader::TYPE_VERTEX );
 	RVertexShader* pPrePassSmoothSkinningVertexShader = static_cast<RVertexShader*>( pPrePassShaderResource );
 
-	// Sort meshes based on distance from front to back in order to reduce overdraw.
-	GraphicsSceneView& rView = m_sceneViews[viewIndex];
-	const Simd::Vector3& rViewDirection = rView.GetForward();
-
-	size_t subMeshIndexCount = m_sceneObjectSubMeshIndices.GetSize();
-
-	{
-		SortJob< size_t, SubMeshFrontToBackCompare > job;
-		SortJob< size_t, SubMeshFrontToBackCompare >::Parameters& rParameters = job.GetParameters();
-		rParameters.pBase = m_sceneObjectSubMeshIndices.GetData();
-		rParameters.count = subMeshIndexCount;
-		rParameters.compare = SubMeshFrontToBackCompare( rViewDirection, m_sceneObjects, m_sceneObjectSubMeshes );
-		rParameters.singleJobCount = 100;
-		job.Run();
-	}
+	// Meshes are already sorted from front to back in order to reduce overdraw.
+	HELIUM_ASSERT( viewIndex < m_viewVisibility.GetSize() );
+	const DynamicArray< size_t >& rSubMeshIndices = m_viewVisibility[viewIndex].depthSubMeshIndices;
+	size_t subMeshIndexCount = rSubMeshIndices.GetSize();
 
 	// Initialize the blend state and shaders for performing no color writes.
 	Renderer* pRenderer = Renderer::GetInstance();
 	HELIUM_ASSERT( pRenderer );
 
-	RRenderCommandProxyPtr spCommandProxy = pRenderer->GetImmediateCommandProxy();
-	HELIUM_ASSERT( spCommandProxy );
-
 	RBlendState* pBlendStateNoColor = pRenderResourceManager->GetBlendState(
 		RenderResourceManager::BLEND_STATE_NO_COLOR );
-	spCommandProxy->SetBlendState( pBlendStateNoColor );
+	pCommandProxy->SetBlendState( pBlendStateNoColor );
 
-	spCommandProxy->SetPixelShader( NULL );
+	pCommandProxy->SetPixelShader( NULL );
 
 	// Draw each visible mesh instance.
 	RVertexShader* pPreviousVertexShader = NULL;
 
 	for ( size_t meshIndexIndex = 0; meshIndexIndex < subMeshIndexCount; ++meshIndexIndex )
 	{
-		size_t meshIndex = m_sceneObjectSubMeshIndices[meshIndexIndex];
+		size_t meshIndex = rSubMeshIndices[meshIndexIndex];
 		HELIUM_ASSERT( m_sceneObjectSubMeshes.IsElementValid( meshIndex ) );
 
 		GraphicsSceneObject::SubMeshData& rSubMeshData = m_sceneObjectSubMeshes[meshIndex];
@@ -1681,16 +3510,13 @@ void GraphicsScene::DrawDepthPrePass( uint_fast32_t viewIndex )
 		HELIUM_ASSERT( sceneObjectId < m_sceneObjects.GetSize() );
 		HELIUM_ASSERT( m_sceneObjects.IsElementValid( sceneObjectId ) );
 
-		HELIUM_ASSERT( meshIndex < m_subMeshVertexGlobalDataBuffers.GetSize() );
-		RConstantBuffer* pInstanceVertexGlobalDataBuffer = m_subMeshVertexGlobalDataBuffers[meshIndex];
+		size_t instanceVertexGlobalDataOffset;
+		size_t instanceVertexGlobalDataSize;
+		RConstantBuffer* pInstanceVertexGlobalDataBuffer = GetInstanceVertexGlobalData(
+			meshIndex, sceneObjectId, instanceVertexGlobalDataOffset, instanceVertexGlobalDataSize );
 		if ( !pInstanceVertexGlobalDataBuffer )
 		{
-			HELIUM_ASSERT( sceneObjectId < m_objectVertexGlobalDataBuffers.GetSize() );
-			pInstanceVertexGlobalDataBuffer = m_objectVertexGlobalDataBuffers[sceneObjectId];
-			if ( !pInstanceVertexGlobalDataBuffer )
-			{
-				continue;
-			}
+			continue;
 		}
 
 		GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectId];
@@ -1723,8 +3549,7 @@ void GraphicsScene::DrawDepthPrePass( uint_fast32_t viewIndex )
 			pVertexShader = pPrePassSmoothSkinningVertexShader;
 		}
 
-		pVertexShader->CacheDescription( pRenderer, pVertexDescription );
-		RVertexInputLayout* pInputLayout = pVertexShader->GetCachedInputLayout();
+		RVertexInputLayout* pInputLayout = pVertexShader->GetInputLayout( pRenderer, pVertexDescription );
 		if ( !pInputLayout )
 		{
 			continue;
@@ -1734,23 +3559,25 @@ void GraphicsScene::DrawDepthPrePass( uint_fast32_t viewIndex )
 		uint32_t offset = 0;
 
 		ERendererPrimitiveType primitiveType = rSubMeshData.GetPrimitiveType();
-		uint32_t primitiveCount = rSubMeshData.GetPrimitiveCount();
 		uint32_t startVertex = rSubMeshData.GetStartVertex();
 		uint32_t vertexRange = rSubMeshData.GetVertexRange();
-		uint32_t startIndex = rSubMeshData.GetStartIndex();
+		uint32_t startIndex;
+		uint32_t primitiveCount;
+		rSubMeshData.GetIndexRange( GetSceneObjectLod( viewIndex, sceneObjectId ), startIndex, primitiveCount );
 
 		if ( pPreviousVertexShader != pVertexShader )
 		{
-			spCommandProxy->SetVertexShader( pVertexShader );
+			pCommandProxy->SetVertexShader( pVertexShader );
 			pPreviousVertexShader = pVertexShader;
 		}
 
-		spCommandProxy->SetVertexConstantBuffers( 1, 1, &pInstanceVertexGlobalDataBuffer );
-		spCommandProxy->SetVertexBuffers( 0, 1, &pVertexBuffer, &vertexStride, &offset );
-		spCommandProxy->SetIndexBuffer( pIndexBuffer );
-		spCommandProxy->SetVertexInputLayout( pInputLayout );
+		pCommandProxy->SetVertexConstantBuffers(
+			1, 1, &pInstanceVertexGlobalDataBuffer, &instanceVertexGlobalDataSize, &instanceVertexGlobalDataOffset );
+		pCommandProxy->SetVertexBuffers( 0, 1, &pVertexBuffer, &vertexStride, &offset );
+		pCommandProxy->SetIndexBuffer( pIndexBuffer );
+		pCommandProxy->SetVertexInputLayout( pInputLayout );
 
-		spCommandProxy->DrawIndexed(
+		pCommandProxy->DrawIndexed(
 			primitiveType,
 			startVertex,
 			0,
@@ -1762,19 +3589,28 @@ void GraphicsScene::DrawDepthPrePass( uint_fast32_t viewIndex )
 
 /// Draw the base pass for the given scene view.
 ///
-/// - The m_sceneObjectSubMeshIndices array should already be prepared with the (unsorted) list of visible sub
-///   meshes.  This function will sort as appropriate if rendering is performed.
+/// - The base pass sub-mesh list for the view should already be prepared by PrepareSceneViews().
 /// - Standard viewport render surfaces are expected to have already been set, with the depth buffer either cleared
 ///   or prepared by the depth-only pre-pass.
 /// - Default rasterizer and depth states should be already set.
 /// - Global per-view constant buffers should be already set (buffers specific to the base pass will be set by this
 ///   function).
 ///
-/// @param[in] viewIndex  Index of the view for which the base pass is being rendered.
+/// - The instance vertex buffer should already be filled by UpdateInstanceVertexBuffer() if instancing is enabled.
+///
+/// @param[in] viewIndex           Index of the view for which the base pass is being rendered.
+/// @param[in] pCommandProxy       Command proxy through which to issue the pass rendering commands.
+/// @param[in] bInstancingEnabled  True to draw runs of identical sub-meshes using the instance vertex buffer.
 ///
 /// @see DrawShadowDepthPass(), DrawDepthPrePass()
-void GraphicsScene::DrawBasePass( uint_fast32_t viewIndex )
+void GraphicsScene::DrawBasePass(
+	uint_fast32_t viewIndex,
+	RRenderCommandProxy* pCommandProxy,
+	bool bInstancingEnabled )
 {
+	HELIUM_FRAME_PROFILER_SCOPE( "GraphicsScene::DrawBasePass" );
+
+	HELIUM_ASSERT( pCommandProxy );
 	HELIUM_ASSERT( viewIndex < m_sceneViews.GetSize() );
 	HELIUM_ASSERT( m_sceneViews.IsElementValid( viewIndex ) );
 
@@ -1806,11 +3642,19 @@ void GraphicsScene::DrawBasePass( uint_fast32_t viewIndex )
 	Shader::SelectPair systemSelections[] =
 	{
 		Shader::SelectPair( Name( "SHADOWS" ), Name( NULL_NAME ) ),
-		Shader::SelectPair( GetSkinningSysSelectName(), Name( NULL_NAME ) )
+		Shader::SelectPair( GetSkinningSysSelectName(), Name( NULL_NAME ) ),
+		Shader::SelectPair( GetInstancingSysSelectName(), Name( NULL_NAME ) )
 	};
 
 	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( shadowSelectOptions ) == GraphicsConfig::EShadowMode::MAX );
 
+	// Clustered lighting is only enabled for views affected by dynamic lights.
+	HELIUM_ASSERT( viewIndex < m_viewVisibility.GetSize() );
+	const ClusteredLightGrid& rLightGrid = m_viewVisibility[viewIndex].lightGrid;
+
+	Name systemToggles[] = { GetClusteredLightsSysToggleName() };
+	size_t systemToggleCount = ( rLightGrid.GetLightCount() != 0 ? HELIUM_ARRAY_COUNT( systemToggles ) : 0 );
+
 	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
 	HELIUM_ASSERT( pRenderResourceManager );
 
@@ -1822,58 +3666,62 @@ void GraphicsScene::DrawBasePass( uint_fast32_t viewIndex )
 
 	systemSelections[0].choice = shadowSelectOptions[shadowMode];
 
-	// Sort meshes based on material in order to reduce shader switches.
-	size_t subMeshIndexCount = m_sceneObjectSubMeshIndices.GetSize();
+	// Meshes are already sorted by material in order to reduce shader switches.
+	const DynamicArray< size_t >& rSubMeshIndices = m_viewVisibility[viewIndex].baseSubMeshIndices;
+	size_t subMeshIndexCount = rSubMeshIndices.GetSize();
 
-	{
-		SortJob< size_t, SubMeshMaterialCompare > job;
-		SortJob< size_t, SubMeshMaterialCompare >::Parameters& rParameters = job.GetParameters();
-		rParameters.pBase = m_sceneObjectSubMeshIndices.GetData();
-		rParameters.count = subMeshIndexCount;
-		rParameters.compare = SubMeshMaterialCompare( m_sceneObjectSubMeshes );
-		rParameters.singleJobCount = 100;
+	// Runs of sub-meshes drawing the same mesh data can be drawn with a single instanced draw call, reading their
+	// transforms from the instance vertex buffer.
+	const DynamicArray< uint32_t >& rInstanceCounts = m_viewVisibility[viewIndex].baseInstanceCounts;
+	HELIUM_ASSERT( rInstanceCounts.GetSize() == subMeshIndexCount );
 
-		job.Run();
-	}
+	uint32_t nextInstanceOffset = 0;
 
 	// Set the opaque rendering blend state and per-view constant buffers for this pass.
 	Renderer* pRenderer = Renderer::GetInstance();
 	HELIUM_ASSERT( pRenderer );
 
-	RRenderCommandProxyPtr spCommandProxy = pRenderer->GetImmediateCommandProxy();
-	HELIUM_ASSERT( spCommandProxy );
-
 	RBlendState* pBlendStateOpaque = pRenderResourceManager->GetBlendState(
 		RenderResourceManager::BLEND_STATE_OPAQUE );
-	spCommandProxy->SetBlendState( pBlendStateOpaque );
+	pCommandProxy->SetBlendState( pBlendStateOpaque );
 
-	spCommandProxy->SetVertexConstantBuffers( 1, 1, &pViewVertexBasePassDataBuffer );
-	spCommandProxy->SetPixelConstantBuffers( 0, 1, &pViewPixelBasePassDataBuffer );
+	pCommandProxy->SetVertexConstantBuffers( 1, 1, &pViewVertexBasePassDataBuffer );
+	pCommandProxy->SetPixelConstantBuffers( 0, 1, &pViewPixelBasePassDataBuffer );
 
 	// Draw each visible sub-mesh.
-	Name defaultSamplerStateName = GetDefaultSamplerStateName();
-	Name shadowSamplerStateName = GetShadowSamplerStateName();
-	Name shadowMapTextureName = GetShadowMapTextureName();
-
-	RSamplerState* pSamplerStateDefault = pRenderResourceManager->GetSamplerState(
+	RSamplerState* samplerStates[Material::BindingBlock::SAMPLER_MAX] = { NULL };
+	samplerStates[Material::BindingBlock::SAMPLER_DEFAULT] = pRenderResourceManager->GetSamplerState(
 		RenderResourceManager::TEXTURE_FILTER_LINEAR,
 		RENDERER_TEXTURE_ADDRESS_MODE_WRAP );
-	RSamplerState* pSamplerStateShadowMap = pRenderResourceManager->GetSamplerState(
+	samplerStates[Material::BindingBlock::SAMPLER_SHADOW_MAP] = pRenderResourceManager->GetSamplerState(
 		RenderResourceManager::TEXTURE_FILTER_LINEAR,
 		RENDERER_TEXTURE_ADDRESS_MODE_CLAMP );
+	samplerStates[Material::BindingBlock::SAMPLER_POINT_CLAMP] = pRenderResourceManager->GetSamplerState(
+		RenderResourceManager::TEXTURE_FILTER_POINT,
+		RENDERER_TEXTURE_ADDRESS_MODE_CLAMP );
 
-	RTexture2d* pShadowDepthTexture = pRenderResourceManager->GetShadowDepthTexture();
+	RTexture* sceneTextures[Material::BindingBlock::SCENE_TEXTURE_MAX] = { NULL };
+	sceneTextures[Material::BindingBlock::SCENE_TEXTURE_SHADOW_MAP] = pRenderResourceManager->GetShadowDepthTexture();
+	sceneTextures[Material::BindingBlock::SCENE_TEXTURE_CLUSTER_LIGHTS] = rLightGrid.GetLightTexture();
+	sceneTextures[Material::BindingBlock::SCENE_TEXTURE_CLUSTER_GRID] = rLightGrid.GetClusterTexture();
+	sceneTextures[Material::BindingBlock::SCENE_TEXTURE_CLUSTER_LIGHT_INDICES] = rLightGrid.GetLightIndexTexture();
 
 	RVertexShader* pPreviousVertexShader = NULL;
 	RPixelShader* pPreviousPixelShader = NULL;
-	RConstantBuffer* pPreviousMaterialVertexConstantBuffer = NULL;
-	RConstantBuffer* pPreviousMaterialPixelConstantBuffer = NULL;
+
+	// Materials are only rebound when the binding block changes (sub-meshes are sorted by material binding ID).
+	const Material::BindingBlock* pPreviousBindingBlock = NULL;
+	uint32_t previousBindingId = 0;
 
 	for ( size_t meshIndexIndex = 0; meshIndexIndex < subMeshIndexCount; ++meshIndexIndex )
 	{
-		size_t meshIndex = m_sceneObjectSubMeshIndices[meshIndexIndex];
+		size_t meshIndex = rSubMeshIndices[meshIndexIndex];
 		HELIUM_ASSERT( m_sceneObjectSubMeshes.IsElementValid( meshIndex ) );
 
+		uint32_t instanceCount = rInstanceCounts[meshIndexIndex];
+		uint32_t instanceOffset = nextInstanceOffset;
+		nextInstanceOffset += instanceCount;
+
 		GraphicsSceneObject::SubMeshData& rSubMeshData = m_sceneObjectSubMeshes[meshIndex];
 
 		size_t sceneObjectId = rSubMeshData.GetSceneObjectId();
@@ -1881,16 +3729,13 @@ void GraphicsScene::DrawBasePass( uint_fast32_t viewIndex )
 		HELIUM_ASSERT( sceneObjectId < m_sceneObjects.GetSize() );
 		HELIUM_ASSERT( m_sceneObjects.IsElementValid( sceneObjectId ) );
 
-		HELIUM_ASSERT( meshIndex < m_subMeshVertexGlobalDataBuffers.GetSize() );
-		RConstantBuffer* pInstanceVertexGlobalDataBuffer = m_subMeshVertexGlobalDataBuffers[meshIndex];
+		size_t instanceVertexGlobalDataOffset;
+		size_t instanceVertexGlobalDataSize;
+		RConstantBuffer* pInstanceVertexGlobalDataBuffer = GetInstanceVertexGlobalData(
+			meshIndex, sceneObjectId, instanceVertexGlobalDataOffset, instanceVertexGlobalDataSize );
 		if ( !pInstanceVertexGlobalDataBuffer )
 		{
-			HELIUM_ASSERT( sceneObjectId < m_objectVertexGlobalDataBuffers.GetSize() );
-			pInstanceVertexGlobalDataBuffer = m_objectVertexGlobalDataBuffers[sceneObjectId];
-			if ( !pInstanceVertexGlobalDataBuffer )
-			{
-				continue;
-			}
+			continue;
 		}
 
 		GraphicsSceneObject& rSceneObject = m_sceneObjects[sceneObjectId];
@@ -1947,21 +3792,50 @@ void GraphicsScene::DrawBasePass( uint_fast32_t viewIndex )
 		}
 
 		const Shader::Options& rSystemOptions = pShaderResource->GetSystemOptions();
+
+		RVertexDescription* pInstancedVertexDescription = NULL;
+		if ( bInstancingEnabled &&
+			instanceCount > 1 &&
+			HasVertexShaderSelect( rSystemOptions, GetInstancingSysSelectName() ) )
+		{
+			pInstancedVertexDescription =
+				pRenderResourceManager->GetInstancedStaticMeshVertexDescription( pVertexDescription );
+		}
+
+		systemSelections[2].choice =
+			( pInstancedVertexDescription ? GetInstancingTransformOptionName() : GetNoneOptionName() );
+
 		size_t vertexShaderIndex = rSystemOptions.GetOptionSetIndex(
 			RShader::TYPE_VERTEX,
-			NULL,
-			0,
+			systemToggles,
+			systemToggleCount,
 			systemSelections,
 			HELIUM_ARRAY_COUNT( systemSelections ) );
 		size_t pixelShaderIndex = rSystemOptions.GetOptionSetIndex(
 			RShader::TYPE_PIXEL,
-			NULL,
-			0,
+			systemToggles,
+			systemToggleCount,
 			systemSelections,
 			HELIUM_ARRAY_COUNT( systemSelections ) );
 
 		RVertexShader* pVertexShader =
 			static_cast<RVertexShader*>( pVertexShaderVariant->GetRenderResource( vertexShaderIndex ) );
+		if ( !pVertexShader && pInstancedVertexDescription )
+		{
+			// Fall back to drawing each sub-mesh separately if the instanced shader variant is not available.
+			pInstancedVertexDescription = NULL;
+			systemSelections[2].choice = GetNoneOptionName();
+
+			vertexShaderIndex = rSystemOptions.GetOptionSetIndex(
+				RShader::TYPE_VERTEX,
+				systemToggles,
+				systemToggleCount,
+				systemSelections,
+				HELIUM_ARRAY_COUNT( systemSelections ) );
+			pVertexShader =
+				static_cast<RVertexShader*>( pVertexShaderVariant->GetRenderResource( vertexShaderIndex ) );
+		}
+
 		if ( !pVertexShader )
 		{
 			continue;
@@ -1974,135 +3848,247 @@ void GraphicsScene::DrawBasePass( uint_fast32_t viewIndex )
 			continue;
 		}
 
-		pVertexShader->CacheDescription( pRenderer, pVertexDescription );
-		RVertexInputLayout* pInputLayout = pVertexShader->GetCachedInputLayout();
+		RVertexInputLayout* pInputLayout = pVertexShader->GetInputLayout(
+			pRenderer,
+			( pInstancedVertexDescription ? pInstancedVertexDescription : pVertexDescription ) );
 		if ( !pInputLayout )
 		{
 			continue;
 		}
 
-		RConstantBuffer* pMaterialVertexConstantBuffer = pMaterial->GetConstantBuffer(
-			RShader::TYPE_VERTEX );
-		RConstantBuffer* pMaterialPixelConstantBuffer = pMaterial->GetConstantBuffer(
-			RShader::TYPE_PIXEL );
+		const Material::BindingBlock* pBindingBlock = pMaterial->GetBindingBlock( pixelShaderIndex );
+		if ( !pBindingBlock )
+		{
+			continue;
+		}
 
 		uint32_t vertexStride = rSceneObject.GetVertexStride();
 		uint32_t offset = 0;
 
 		ERendererPrimitiveType primitiveType = rSubMeshData.GetPrimitiveType();
-		uint32_t primitiveCount = rSubMeshData.GetPrimitiveCount();
 		uint32_t startVertex = rSubMeshData.GetStartVertex();
 		uint32_t vertexRange = rSubMeshData.GetVertexRange();
-		uint32_t startIndex = rSubMeshData.GetStartIndex();
+		uint32_t startIndex;
+		uint32_t primitiveCount;
+		rSubMeshData.GetIndexRange( GetSceneObjectLod( viewIndex, sceneObjectId ), startIndex, primitiveCount );
 
-		spCommandProxy->SetVertexConstantBuffers( 2, 1, &pInstanceVertexGlobalDataBuffer );
+		pCommandProxy->SetVertexConstantBuffers(
+			2, 1, &pInstanceVertexGlobalDataBuffer, &instanceVertexGlobalDataSize, &instanceVertexGlobalDataOffset );
 
-		if ( pMaterialVertexConstantBuffer != pPreviousMaterialVertexConstantBuffer )
+		if ( pBindingBlock != pPreviousBindingBlock || pMaterial->GetBindingId() != previousBindingId )
 		{
-			spCommandProxy->SetVertexConstantBuffers( 3, 1, &pMaterialVertexConstantBuffer );
-			pPreviousMaterialVertexConstantBuffer = pMaterialVertexConstantBuffer;
+			SetMaterialBindings( pCommandProxy, pMaterial, *pBindingBlock, samplerStates, sceneTextures );
+			pPreviousBindingBlock = pBindingBlock;
+			previousBindingId = pMaterial->GetBindingId();
 		}
 
-		if ( pMaterialPixelConstantBuffer != pPreviousMaterialPixelConstantBuffer )
+		if ( pInstancedVertexDescription )
+		{
+			RVertexBuffer* vertexBuffers[] = { pVertexBuffer, m_spInstanceVertexBuffer };
+			uint32_t vertexStrides[] = { vertexStride, INSTANCE_VERTEX_STRIDE };
+			uint32_t vertexOffsets[] = { offset, instanceOffset * INSTANCE_VERTEX_STRIDE };
+			pCommandProxy->SetVertexBuffers( 0, 2, vertexBuffers, vertexStrides, vertexOffsets );
+		}
+		else
 		{
-			spCommandProxy->SetPixelConstantBuffers( 1, 1, &pMaterialPixelConstantBuffer );
-			pPreviousMaterialPixelConstantBuffer = pMaterialPixelConstantBuffer;
+			pCommandProxy->SetVertexBuffers( 0, 1, &pVertexBuffer, &vertexStride, &offset );
 		}
 
-		spCommandProxy->SetVertexBuffers( 0, 1, &pVertexBuffer, &vertexStride, &offset );
-		spCommandProxy->SetIndexBuffer( pIndexBuffer );
+		pCommandProxy->SetIndexBuffer( pIndexBuffer );
 
 		if ( pVertexShader != pPreviousVertexShader )
 		{
-			spCommandProxy->SetVertexShader( pVertexShader );
+			pCommandProxy->SetVertexShader( pVertexShader );
 			pPreviousVertexShader = pVertexShader;
 		}
 
 		if ( pPixelShader != pPreviousPixelShader )
 		{
-			spCommandProxy->SetPixelShader( pPixelShader );
+			pCommandProxy->SetPixelShader( pPixelShader );
 			pPreviousPixelShader = pPixelShader;
 		}
 
-		spCommandProxy->SetVertexInputLayout( pInputLayout );
+		pCommandProxy->SetVertexInputLayout( pInputLayout );
 
-		const ShaderSamplerInfoSet* pSamplerInfoSet = pPixelShaderVariant->GetSamplerInfoSet( pixelShaderIndex );
-		if ( pSamplerInfoSet )
+		if ( pInstancedVertexDescription )
 		{
-			const DynamicArray< ShaderSamplerInfo >& samplerInputs = pSamplerInfoSet->inputs;
-			size_t samplerInputCount = samplerInputs.GetSize();
-			for ( size_t inputIndex = 0; inputIndex < samplerInputCount; ++inputIndex )
-			{
-				const ShaderSamplerInfo& rInputInfo = samplerInputs[inputIndex];
-				Name samplerName = rInputInfo.name;
+			pCommandProxy->DrawIndexedInstanced(
+				primitiveType,
+				startVertex,
+				0,
+				vertexRange,
+				startIndex,
+				primitiveCount,
+				instanceCount );
+
+			// Skip the remaining sub-meshes drawn by this call.
+			meshIndexIndex += instanceCount - 1;
+		}
+		else
+		{
+			pCommandProxy->DrawIndexed(
+				primitiveType,
+				startVertex,
+				0,
+				vertexRange,
+				startIndex,
+				primitiveCount );
+		}
+	}
+}
 
-				RSamplerState* pSamplerState = NULL;
-				if ( samplerName == defaultSamplerStateName )
-				{
-					pSamplerState = pSamplerStateDefault;
-				}
-				else if ( samplerName == shadowSamplerStateName ||  // Shader model 4+
-					samplerName == shadowMapTextureName )     // Older shader versions
-				{
-					pSamplerState = pSamplerStateShadowMap;
-				}
+/// Fill the instance vertex buffer with the transforms of each sub-mesh that will be instanced during the base pass
+/// for a given scene view, growing the buffer if necessary.
+///
+/// @param[in] viewIndex  Index of the view for which the base pass is being rendered.
+///
+/// @return  Number of instances written to the instance vertex buffer, or zero if nothing in the view will be drawn
+///          using instancing.
+///
+/// @see DrawSceneView(), DrawBasePass()
+size_t GraphicsScene::UpdateInstanceVertexBuffer( uint_fast32_t viewIndex )
+{
+	HELIUM_ASSERT( viewIndex < m_viewVisibility.GetSize() );
 
-				spCommandProxy->SetSamplerStates( rInputInfo.bindIndex, 1, &pSamplerState );
-			}
-		}
+	const ViewVisibility& rVisibility = m_viewVisibility[viewIndex];
+	const DynamicArray< size_t >& rSubMeshIndices = rVisibility.baseSubMeshIndices;
+	const DynamicArray< uint32_t >& rInstanceCounts = rVisibility.baseInstanceCounts;
+
+	size_t subMeshIndexCount = rInstanceCounts.GetSize();
+
+	size_t totalInstanceCount = 0;
+	for ( size_t meshIndexIndex = 0; meshIndexIndex < subMeshIndexCount; ++meshIndexIndex )
+	{
+		totalInstanceCount += rInstanceCounts[meshIndexIndex];
+	}
+
+	if ( totalInstanceCount == 0 )
+	{
+		return 0;
+	}
 
-		const ShaderTextureInfoSet* pTextureInfoSet = pPixelShaderVariant->GetTextureInfoSet( pixelShaderIndex );
-		if ( pTextureInfoSet )
+	if ( totalInstanceCount > m_instanceVertexBufferCapacity )
+	{
+		Renderer* pRenderer = Renderer::GetInstance();
+		HELIUM_ASSERT( pRenderer );
+
+		size_t instanceCapacity = Max( totalInstanceCount, m_instanceVertexBufferCapacity * 2 );
+		m_spInstanceVertexBuffer = pRenderer->CreateVertexBuffer(
+			instanceCapacity * INSTANCE_VERTEX_STRIDE,
+			RENDERER_BUFFER_USAGE_DYNAMIC );
+		if ( !m_spInstanceVertexBuffer )
 		{
-			size_t materialTextureCount = pMaterial->GetTextureParameterCount();
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"GraphicsScene::UpdateInstanceVertexBuffer(): Instance vertex buffer creation failed!\n" );
 
-			const DynamicArray< ShaderTextureInfo >& textureInputs = pTextureInfoSet->inputs;
-			size_t textureInputCount = textureInputs.GetSize();
-			for ( size_t inputIndex = 0; inputIndex < textureInputCount; ++inputIndex )
-			{
-				const ShaderTextureInfo& rInputInfo = textureInputs[inputIndex];
-				Name textureName = rInputInfo.name;
+			m_instanceVertexBufferCapacity = 0;
 
-				RTexture* pTextureResource = NULL;
+			return 0;
+		}
 
-				if ( textureName == shadowMapTextureName )
-				{
-					pTextureResource = pShadowDepthTexture;
-				}
-				else
-				{
-					for ( size_t materialTextureIndex = 0;
-						materialTextureIndex < materialTextureCount;
-						++materialTextureIndex )
-					{
-						const Material::TextureParameter& rTextureParameter = pMaterial->GetTextureParameter(
-							materialTextureIndex );
-						if ( rTextureParameter.name == textureName )
-						{
-							Texture* pTexture = rTextureParameter.value;
-							if ( pTexture )
-							{
-								pTextureResource = pTexture->GetRenderResource();
-							}
-
-							break;
-						}
-					}
-				}
+		m_instanceVertexBufferCapacity = instanceCapacity;
+	}
 
-				spCommandProxy->SetTexture( rInputInfo.bindIndex, pTextureResource );
-			}
+	float32_t* pInstanceData = static_cast<float32_t*>(
+		m_spInstanceVertexBuffer->Map( RENDERER_BUFFER_MAP_HINT_DISCARD ) );
+	if ( !pInstanceData )
+	{
+		return 0;
+	}
+
+	for ( size_t meshIndexIndex = 0; meshIndexIndex < subMeshIndexCount; ++meshIndexIndex )
+	{
+		uint32_t instanceCount = rInstanceCounts[meshIndexIndex];
+		for ( uint32_t instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex )
+		{
+			const GraphicsSceneObject::SubMeshData& rSubMeshData =
+				m_sceneObjectSubMeshes[rSubMeshIndices[meshIndexIndex + instanceIndex]];
+			const Simd::Matrix44& rTransform = m_sceneObjects[rSubMeshData.GetSceneObjectId()].GetTransform();
+
+			// Store the transposed transform, matching the layout of the per-object constant buffers.
+			*( pInstanceData++ ) = rTransform.GetElement( 0 );
+			*( pInstanceData++ ) = rTransform.GetElement( 4 );
+			*( pInstanceData++ ) = rTransform.GetElement( 8 );
+			*( pInstanceData++ ) = rTransform.GetElement( 12 );
+			*( pInstanceData++ ) = rTransform.GetElement( 1 );
+			*( pInstanceData++ ) = rTransform.GetElement( 5 );
+			*( pInstanceData++ ) = rTransform.GetElement( 9 );
+			*( pInstanceData++ ) = rTransform.GetElement( 13 );
+			*( pInstanceData++ ) = rTransform.GetElement( 2 );
+			*( pInstanceData++ ) = rTransform.GetElement( 6 );
+			*( pInstanceData++ ) = rTransform.GetElement( 10 );
+			*( pInstanceData++ ) = rTransform.GetElement( 14 );
 		}
+	}
 
-		spCommandProxy->DrawIndexed(
-			primitiveType,
-			startVertex,
-			0,
-			vertexRange,
-			startIndex,
-			primitiveCount );
+	m_spInstanceVertexBuffer->Unmap();
+
+	return totalInstanceCount;
+}
+
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+/// Queue text showing the render statistics of the last frame, one line per pass, in the scene's buffered drawer.
+///
+/// @see RenderStatistics::GetLastFrameStats()
+void GraphicsScene::DrawRenderStatisticsOverlay()
+{
+	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+	HELIUM_ASSERT( pRenderResourceManager );
+
+	Font* pFont = pRenderResourceManager->GetDebugFont( RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+	if ( !pFont )
+	{
+		return;
+	}
+
+	const int32_t lineHeight = static_cast<int32_t>( pFont->GetHeightFloat() + 0.5f );
+	const Color textColor( 0xffffffff );
+
+	const RenderStatistics::FrameStats& rFrameStats = RenderStatistics::GetLastFrameStats();
+	const uint64_t* pTotals = rFrameStats.totals;
+
+	BufferedDrawer& rSceneDrawer = m_sceneBufferedDrawers[m_renderBufferedDrawerSetIndex];
+
+	int32_t y = lineHeight;
+
+	String text;
+	text.Format(
+		"Draws %" PRIu64 " (%" PRIu64 " instanced), primitives %" PRIu64 ", binds %" PRIu64 " (%" PRIu64
+		" filtered)",
+		pTotals[RenderStatistics::COUNTER_DRAW_CALLS],
+		pTotals[RenderStatistics::COUNTER_INSTANCED_DRAW_CALLS],
+		pTotals[RenderStatistics::COUNTER_PRIMITIVES],
+		pTotals[RenderStatistics::COUNTER_STATE_CHANGES],
+		pTotals[RenderStatistics::COUNTER_FILTERED_STATE_CHANGES] );
+	rSceneDrawer.DrawScreenText( 0, y, text, textColor, RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+	y += lineHeight;
+
+	text.Format(
+		"Uploads: constants %" PRIu64 " KiB, buffers %" PRIu64 " KiB, textures %" PRIu64 " KiB, GPU %.2f ms",
+		pTotals[RenderStatistics::COUNTER_CONSTANT_BUFFER_BYTES] / 1024,
+		pTotals[RenderStatistics::COUNTER_BUFFER_BYTES] / 1024,
+		pTotals[RenderStatistics::COUNTER_TEXTURE_BYTES] / 1024,
+		rFrameStats.gpuMilliseconds );
+	rSceneDrawer.DrawScreenText( 0, y, text, textColor, RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+	y += lineHeight;
+
+	for ( uint32_t passIndex = 0; passIndex < rFrameStats.passCount; ++passIndex )
+	{
+		const RenderStatistics::PassStats& rPass = rFrameStats.passes[passIndex];
+		text.Format(
+			"  %s: draws %" PRIu64 ", primitives %" PRIu64 ", binds %" PRIu64 " (%" PRIu64 " filtered), GPU %.2f ms",
+			( rPass.pName ? rPass.pName : "Other" ),
+			rPass.counters[RenderStatistics::COUNTER_DRAW_CALLS],
+			rPass.counters[RenderStatistics::COUNTER_PRIMITIVES],
+			rPass.counters[RenderStatistics::COUNTER_STATE_CHANGES],
+			rPass.counters[RenderStatistics::COUNTER_FILTERED_STATE_CHANGES],
+			rPass.gpuMilliseconds );
+		rSceneDrawer.DrawScreenText( 0, y, text, textColor, RenderResourceManager::DEBUG_FONT_SIZE_SMALL );
+		y += lineHeight;
 	}
 }
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 
 /// Get a name identifier for "NONE" select options.
 ///
@@ -2150,87 +4136,165 @@ Name GraphicsScene::GetSkinningRigidOptionName()
 	return skinningRigidOptionName;
 }
 
-/// Constructor.
-GraphicsScene::SubMeshFrontToBackCompare::SubMeshFrontToBackCompare()
-	: m_cameraDirection( 0.0f )
-	, m_pSceneObjects( NULL )
-	, m_pSubMeshes( NULL )
+/// Get the name of the instancing system select for shaders.
+///
+/// @return  Instancing system select name.
+///
+/// @see GetInstancingTransformOptionName()
+Name GraphicsScene::GetInstancingSysSelectName()
 {
+	static Name instancingSysSelectName( "INSTANCING" );
+
+	return instancingSysSelectName;
 }
 
-/// Constructor.
+/// Get the name of the per-instance transform instancing system select option for shaders.
+///
+/// @return  Per-instance transform instancing select option name.
+///
+/// @see GetInstancingSysSelectName()
+Name GraphicsScene::GetInstancingTransformOptionName()
+{
+	static Name instancingTransformOptionName( "INSTANCING_TRANSFORM" );
+
+	return instancingTransformOptionName;
+}
+
+/// Get the name of the clustered dynamic lighting system toggle for shaders.
+///
+/// @return  Clustered lighting system toggle name.
+Name GraphicsScene::GetClusteredLightsSysToggleName()
+{
+	static Name clusteredLightsSysToggleName( "CLUSTERED_LIGHTS" );
+
+	return clusteredLightsSysToggleName;
+}
+
+/// RenderThread command for rendering a frame of a scene.
+///
+/// @param[in] pData  Graphics scene.
+///
+/// @see Update(), WaitForRenderFrame()
+void GraphicsScene::RenderFrameCallback( void* pData )
+{
+	GraphicsScene* pThis = static_cast<GraphicsScene*>( pData );
+	HELIUM_ASSERT( pThis );
+
+	pThis->RenderFrame();
+	pThis->m_renderFrameCondition.Signal();
+}
+
+/// JobManager::ParallelFor() callback for preparing each scene view.
+///
+/// @param[in] pContext  Graphics scene.
+/// @param[in] index     Index of the view ID in the list of views being prepared.
 ///
-/// @param[in] rCameraDirection  Camera world direction.
-/// @param[in] rSceneObjects     List of graphics scene objects in the scene.
-/// @param[in] rSubMeshes        List of scene object sub-meshes in the scene.
-GraphicsScene::SubMeshFrontToBackCompare::SubMeshFrontToBackCompare(
-	const Simd::Vector3& rCameraDirection,
-	const SparseArray< GraphicsSceneObject >& rSceneObjects,
-	const SparseArray< GraphicsSceneObject::SubMeshData >& rSubMeshes )
-	: m_cameraDirection( rCameraDirection )
-	, m_pSceneObjects( &rSceneObjects )
-	, m_pSubMeshes( &rSubMeshes )
+/// @see PrepareSceneViews()
+void GraphicsScene::PrepareSceneViewCallback( void* pContext, size_t index )
 {
+	GraphicsScene* pThis = static_cast<GraphicsScene*>( pContext );
+	HELIUM_ASSERT( pThis );
+	HELIUM_ASSERT( index < pThis->m_preparedViewIds.GetSize() );
+
+	pThis->PrepareSceneView( pThis->m_preparedViewIds[index] );
 }
 
-/// Compare two sub-meshes for sorting.
+/// JobManager::ParallelFor() callback for assigning dynamic lights to each depth slice of each scene view.
 ///
-/// @param[in] subMeshIndex0  Index of the first sub-mesh to compare.
-/// @param[in] subMeshIndex1  Index of the second sub-mesh to compare.
+/// @param[in] pContext  Graphics scene.
+/// @param[in] index     Index of the view ID in the list of views being prepared, multiplied by the number of depth
+///                      slices, plus the index of the depth slice to update.
 ///
-/// @return  True if the first sub-mesh should be sorted before the second, false if it should be sorted after or if
-///          they share the same sorting priority.
-bool GraphicsScene::SubMeshFrontToBackCompare::operator()( size_t subMeshIndex0, size_t subMeshIndex1 ) const
+/// @see AssignClusteredLights()
+void GraphicsScene::AssignClusteredLightsCallback( void* pContext, size_t index )
 {
-	const GraphicsSceneObject::SubMeshData& rSubMesh0 = m_pSubMeshes->GetElement( subMeshIndex0 );
-	const GraphicsSceneObject::SubMeshData& rSubMesh1 = m_pSubMeshes->GetElement( subMeshIndex1 );
+	GraphicsScene* pThis = static_cast<GraphicsScene*>( pContext );
+	HELIUM_ASSERT( pThis );
 
-	size_t sceneObjectIndex0 = rSubMesh0.GetSceneObjectId();
-	HELIUM_ASSERT( m_pSceneObjects->IsElementValid( sceneObjectIndex0 ) );
-	size_t sceneObjectIndex1 = rSubMesh1.GetSceneObjectId();
-	HELIUM_ASSERT( m_pSceneObjects->IsElementValid( sceneObjectIndex1 ) );
+	size_t preparedViewIndex = index / ClusteredLightGrid::DEPTH_SLICE_COUNT;
+	uint32_t sliceIndex = static_cast<uint32_t>( index % ClusteredLightGrid::DEPTH_SLICE_COUNT );
+	HELIUM_ASSERT( preparedViewIndex < pThis->m_preparedViewIds.GetSize() );
 
-	const GraphicsSceneObject& rSceneObject0 = m_pSceneObjects->GetElement( sceneObjectIndex0 );
-	const GraphicsSceneObject& rSceneObject1 = m_pSceneObjects->GetElement( sceneObjectIndex1 );
+	uint32_t viewId = pThis->m_preparedViewIds[preparedViewIndex];
+	pThis->m_viewVisibility[viewId].lightGrid.AssignDepthSlice( sliceIndex );
+}
 
-	Simd::Vector3 object0Pos = Simd::Vector4ToVector3( rSceneObject0.GetTransform().GetRow( 3 ) );
-	Simd::Vector3 object1Pos = Simd::Vector4ToVector3( rSceneObject1.GetTransform().GetRow( 3 ) );
+/// JobManager::ParallelFor() callback for recording each scene view pass.
+///
+/// @param[in] pContext  Graphics scene.
+/// @param[in] index     Pass to record.
+///
+/// @see RecordScenePasses()
+void GraphicsScene::RecordScenePassCallback( void* pContext, size_t index )
+{
+	GraphicsScene* pThis = static_cast<GraphicsScene*>( pContext );
+	HELIUM_ASSERT( pThis );
+	HELIUM_ASSERT( index < RECORDED_PASS_MAX );
 
-	float distance0 = object0Pos.Dot( m_cameraDirection );
-	float distance1 = object1Pos.Dot( m_cameraDirection );
+	RRenderCommandProxy* pCommandProxy = pThis->m_passCommandProxies[index];
+	HELIUM_ASSERT( pCommandProxy );
 
-	return ( distance0 < distance1 );
+	pThis->DrawScenePass( static_cast<ERecordedPass>( index ), pThis->m_recordingViewIndex, pCommandProxy );
+	pCommandProxy->FinishCommandList( pThis->m_passCommandLists[index] );
 }
 
-/// Constructor.
-GraphicsScene::SubMeshMaterialCompare::SubMeshMaterialCompare()
-	: m_pSubMeshes( NULL )
+/// RenderGraph callback for the shadow depth pass of the scene view being drawn.
+///
+/// @param[in] pUserData      Graphics scene.
+/// @param[in] rGraph         Render graph being executed.
+/// @param[in] pCommandProxy  Command proxy through which to issue the pass rendering commands.
+///
+/// @see DrawSceneView()
+void GraphicsScene::ExecuteShadowDepthGraphPass(
+	void* pUserData, const RenderGraph& /*rGraph*/, RRenderCommandProxy* pCommandProxy )
 {
+	GraphicsScene* pThis = static_cast<GraphicsScene*>( pUserData );
+	HELIUM_ASSERT( pThis );
+
+	pThis->SubmitScenePass( RECORDED_PASS_SHADOW_DEPTH, pThis->m_renderGraphViewIndex, pCommandProxy );
 }
 
-/// Constructor.
+/// RenderGraph callback for drawing the scene view being drawn into the scene texture.
 ///
-/// @param[in] rSubMeshes  List of scene object sub-meshes in the scene.
-GraphicsScene::SubMeshMaterialCompare::SubMeshMaterialCompare(
-	const SparseArray< GraphicsSceneObject::SubMeshData >& rSubMeshes )
-	: m_pSubMeshes( &rSubMeshes )
+/// @param[in] pUserData      Graphics scene.
+/// @param[in] rGraph         Render graph being executed.
+/// @param[in] pCommandProxy  Command proxy through which to issue the pass rendering commands.
+///
+/// @see DrawSceneView()
+void GraphicsScene::ExecuteSceneGraphPass( void* pUserData, const RenderGraph& rGraph, RRenderCommandProxy* pCommandProxy )
 {
+	GraphicsScene* pThis = static_cast<GraphicsScene*>( pUserData );
+	HELIUM_ASSERT( pThis );
+
+	RTexture2d* pSceneTexture = rGraph.GetTexture( pThis->m_renderGraphSceneTextureId );
+	pThis->DrawSceneTexture( pThis->m_renderGraphViewIndex, pSceneTexture, pCommandProxy );
 }
 
-/// Compare two sub-meshes for sorting.
+/// RenderGraph callback for presenting the scene texture of the scene view being drawn.
 ///
-/// @param[in] subMeshIndex0  Index of the first sub-mesh to compare.
-/// @param[in] subMeshIndex1  Index of the second sub-mesh to compare.
+/// @param[in] pUserData      Graphics scene.
+/// @param[in] rGraph         Render graph being executed.
+/// @param[in] pCommandProxy  Command proxy through which to issue the pass rendering commands.
 ///
-/// @return  True if the first sub-mesh should be sorted before the second, false if it should be sorted after or if
-///          they share the same sorting priority.
-bool GraphicsScene::SubMeshMaterialCompare::operator()( size_t subMeshIndex0, size_t subMeshIndex1 ) const
+/// @see DrawSceneView()
+void GraphicsScene::ExecuteScreenGraphPass( void* pUserData, const RenderGraph& rGraph, RRenderCommandProxy* pCommandProxy )
 {
-	const GraphicsSceneObject::SubMeshData& rSubMesh0 = m_pSubMeshes->GetElement( subMeshIndex0 );
-	const GraphicsSceneObject::SubMeshData& rSubMesh1 = m_pSubMeshes->GetElement( subMeshIndex1 );
+	GraphicsScene* pThis = static_cast<GraphicsScene*>( pUserData );
+	HELIUM_ASSERT( pThis );
 
-	Material* pMaterial0 = rSubMesh0.GetMaterial();
-	Material* pMaterial1 = rSubMesh1.GetMaterial();
+	RTexture2d* pSceneTexture = rGraph.GetTexture( pThis->m_renderGraphSceneTextureId );
+	pThis->DrawSceneTextureToScreen( pThis->m_renderGraphViewIndex, pSceneTexture, pCommandProxy );
+}
+
+/// Compare two materials for ranking.
+///
+/// @param[in] pMaterial0  First material to compare.
+/// @param[in] pMaterial1  Second material to compare.
+///
+/// @return  True if the first material should be sorted before the second, false if it should be sorted after or if
+///          they are the same material.
+bool GraphicsScene::MaterialSortCompare::operator()( Material* pMaterial0, Material* pMaterial1 ) const
+{
 	if ( pMaterial0 == pMaterial1 )
 	{
 		return false;
@@ -2255,6 +4319,18 @@ bool GraphicsScene::SubMeshMaterialCompare::operator()( size_t subMeshIndex0, si
 
 	pVariant0 = pMaterial0->GetShaderVariant( RShader::TYPE_PIXEL );
 	pVariant1 = pMaterial1->GetShaderVariant( RShader::TYPE_PIXEL );
+	if ( pVariant0 != pVariant1 )
+	{
+		return ( pVariant0 < pVariant1 );
+	}
+
+	// Binding IDs are unique, so materials are only equivalent here if neither has been baked yet.
+	uint32_t bindingId0 = pMaterial0->GetBindingId();
+	uint32_t bindingId1 = pMaterial1->GetBindingId();
+	if ( bindingId0 != bindingId1 )
+	{
+		return ( bindingId0 < bindingId1 );
+	}
 
-	return ( pVariant0 < pVariant1 );
+	return ( pMaterial0 < pMaterial1 );
 }
@@ -4,19 +4,33 @@
 //#include "Engine/Asset.h"
 #include "Reflect/Object.h"
 
+#include "Platform/Condition.h"
 #include "Foundation/BitArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/HashMap.h"
 #include "Rendering/RRenderResource.h"
+#include "GraphicsTypes/GraphicsSceneLight.h"
 #include "GraphicsTypes/GraphicsSceneObject.h"
 #include "GraphicsTypes/GraphicsSceneView.h"
+#include "GraphicsTypes/OcclusionBuffer.h"
+#include "GraphicsTypes/VisibilityGrid.h"
+#include "Graphics/ClusteredLightGrid.h"
+#include "Graphics/RenderGraph.h"
 
 #if GRAPHICS_SCENE_BUFFERED_DRAWER
-#include "Foundation/ObjectPool.h"
+#include "Engine/ConcurrentObjectPool.h"
 #include "Graphics/BufferedDrawer.h"
 #endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 
 namespace Helium
 {
     HELIUM_DECLARE_RPTR( RConstantBuffer );
+    HELIUM_DECLARE_RPTR( RVertexBuffer );
+    HELIUM_DECLARE_RPTR( RRenderCommandProxy );
+    HELIUM_DECLARE_RPTR( RRenderCommandList );
+    HELIUM_DECLARE_RPTR( RTexture2d );
+
+    class ShaderVariantManifest;
 
     class HELIUM_GRAPHICS_API SceneObjectTransform : public Helium::Component
     {
@@ -40,6 +54,7 @@ namespace Helium
         /// @name Updating
         //@{
         virtual void Update( World *pWorld );
+        void WaitForRenderFrame() const;
         //@}
 
         /// @name Scene View Management
@@ -49,6 +64,7 @@ namespace Helium
         inline GraphicsSceneView* GetSceneView( uint32_t id );
 
         void SetActiveSceneView( uint32_t id );
+        inline uint32_t GetActiveSceneViewId() const;
         //@}
 
         /// @name Scene Asset Allocation
@@ -56,6 +72,7 @@ namespace Helium
         size_t AllocateSceneObject();
         void ReleaseSceneObject( size_t id );
         inline GraphicsSceneObject* GetSceneObject( size_t id );
+        inline float32_t GetSceneObjectScreenSize( size_t id ) const;
         //@}
 
         /// @name Scene Asset Sub-mesh Allocation
@@ -78,6 +95,10 @@ namespace Helium
         inline const Simd::Vector3& GetDirectionalLightDirection() const;
         inline const Color& GetDirectionalLightColor() const;
         inline float32_t GetDirectionalLightBrightness() const;
+
+        size_t AllocateLight();
+        void ReleaseLight( size_t id );
+        inline GraphicsSceneLight* GetLight( size_t id );
         //@}
 
 #if GRAPHICS_SCENE_BUFFERED_DRAWER
@@ -88,58 +109,83 @@ namespace Helium
         //@}
 #endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 
+        /// @name Shader Variant Warm-up
+        //@{
+        void SetShaderVariantManifestName( Name name );
+        //@}
+
         /// @name Static Reserved Names
         //@{
         static Name GetDefaultSamplerStateName();
         static Name GetShadowSamplerStateName();
         static Name GetShadowMapTextureName();
+        static Name GetClusterLightsTextureName();
+        static Name GetClusterGridTextureName();
+        static Name GetClusterLightIndicesTextureName();
         //@}
 
     private:
-        /// Front-to-back sub-mesh sort comparison function
-        class HELIUM_GRAPHICS_API SubMeshFrontToBackCompare
+        /// Scene view passes recorded into deferred command lists.
+        enum ERecordedPass
         {
-        public:
-            /// @name Construction/Destruction
-            //@{
-            SubMeshFrontToBackCompare();
-            SubMeshFrontToBackCompare(
-                const Simd::Vector3& rCameraDirection, const SparseArray< GraphicsSceneObject >& rSceneObjects,
-                const SparseArray< GraphicsSceneObject::SubMeshData >& rSubMeshes );
-            //@}
+            RECORDED_PASS_FIRST,
+            RECORDED_PASS_SHADOW_DEPTH = RECORDED_PASS_FIRST,
+            RECORDED_PASS_DEPTH_PRE_PASS,
+            RECORDED_PASS_BASE,
 
-            /// @name Overloaded Operators
-            //@{
-            bool operator()( size_t subMeshIndex0, size_t subMeshIndex1 ) const;
-            //@}
-
-        private:
-            /// Camera direction.
-            Simd::Vector3 m_cameraDirection;
-            /// Scene object list.
-            const SparseArray< GraphicsSceneObject >* m_pSceneObjects;
-            /// Scene object sub-mesh list.
-            const SparseArray< GraphicsSceneObject::SubMeshData >* m_pSubMeshes;
+            RECORDED_PASS_MAX
         };
 
-        /// Material-based sub-mesh sort comparison function
-        class HELIUM_GRAPHICS_API SubMeshMaterialCompare
+        /// Material sort comparison function, used to rank materials so that materials sharing the same shaders
+        /// receive adjacent sort IDs (ordered by material binding ID within each shader).
+        class HELIUM_GRAPHICS_API MaterialSortCompare
         {
         public:
-            /// @name Construction/Destruction
-            //@{
-            SubMeshMaterialCompare();
-            explicit SubMeshMaterialCompare( const SparseArray< GraphicsSceneObject::SubMeshData >& rSubMeshes );
-            //@}
-
             /// @name Overloaded Operators
             //@{
-            bool operator()( size_t subMeshIndex0, size_t subMeshIndex1 ) const;
+            bool operator()( Material* pMaterial0, Material* pMaterial1 ) const;
             //@}
+        };
 
-        private:
-            /// Scene object sub-mesh list.
-            const SparseArray< GraphicsSceneObject::SubMeshData >* m_pSubMeshes;
+        /// Location of a range of per-instance vertex constants in a constant buffer page.
+        struct InstanceConstantRange
+        {
+            /// Index of the arena page holding the range, or an invalid index if no range is allocated.
+            uint32_t pageIndex;
+            /// Byte offset of the range within its page.
+            uint32_t offset;
+        };
+
+        /// Visibility results prepared for a single scene view.
+        struct ViewVisibility
+        {
+            /// IDs of the scene objects visible in the view.
+            DynamicArray< size_t > sceneObjectIds;
+            /// Occluders visible in the view, for culling hidden scene objects.
+            OcclusionBuffer occlusionBuffer;
+            /// Level of detail drawn for each scene object in the view, indexed by scene object ID (kept across frames
+            /// so that level of detail changes can be delayed near the switching sizes).
+            DynamicArray< uint8_t > sceneObjectLods;
+            /// IDs of the scene objects within the shadow depth pass frustum for the view.
+            DynamicArray< size_t > shadowSceneObjectIds;
+
+            /// Indices of the visible sub-meshes, sorted front to back for the depth pre-pass.
+            DynamicArray< size_t > depthSubMeshIndices;
+            /// Indices of the visible sub-meshes, sorted by material for the base pass.
+            DynamicArray< size_t > baseSubMeshIndices;
+            /// Render queue sort keys for the depth pre-pass, base pass, and shadow depth pass sub-meshes.
+            DynamicArray< uint64_t > sortKeys;
+            /// Scratch buffer for sorting the render queue keys.
+            DynamicArray< uint64_t > sortKeyScratch;
+
+            /// Number of base pass sub-meshes that can be drawn as instances of the same mesh, starting at each
+            /// position in the base pass sub-mesh list (only set at the start of each run, zero elsewhere).
+            DynamicArray< uint32_t > baseInstanceCounts;
+            /// Indices of the sub-meshes to render into the shadow depth map, sorted front to back along the light.
+            DynamicArray< size_t > shadowSubMeshIndices;
+
+            /// Dynamic lights assigned to the clusters of the view.
+            ClusteredLightGrid lightGrid;
         };
 
         /// Scene view list.
@@ -148,20 +194,50 @@ namespace Helium
         SparseArray< GraphicsSceneObject > m_sceneObjects;
         /// Scene object sub-data list.
         SparseArray< GraphicsSceneObject::SubMeshData > m_sceneObjectSubMeshes;
+        /// Sub-data IDs for each scene object, indexed by scene object ID.
+        DynamicArray< DynamicArray< size_t > > m_sceneObjectSubMeshIds;
+        /// Scene object bounds lookup for visibility culling.
+        VisibilityGrid m_visibilityGrid;
+        /// Dynamic point and spot light list.
+        SparseArray< GraphicsSceneLight > m_lights;
+
+        /// Base pass render queue sort value for each sub-mesh (material and vertex buffer sort IDs), indexed by
+        /// sub-mesh ID.
+        DynamicArray< uint32_t > m_subMeshStateSortValues;
+        /// Sort ID lookup for each material in use, keyed by material address.
+        HashMap< uint64_t, uint32_t > m_materialSortIdMap;
+        /// Sort ID lookup for each vertex buffer in use, keyed by vertex buffer address.
+        HashMap< uint64_t, uint32_t > m_vertexBufferSortIdMap;
+        /// Materials in use, sorted by rank.
+        DynamicArray< Material* > m_sortMaterials;
 
 #if GRAPHICS_SCENE_BUFFERED_DRAWER
         /// Buffered drawing support for the entire scene (presented in all views).
-        BufferedDrawer m_sceneBufferedDrawer;
-        /// Pool of buffered drawing objects for various scene views.
-        ObjectPool< BufferedDrawer > m_viewBufferedDrawerPool;
+        BufferedDrawer m_sceneBufferedDrawers[ 2 ];
+        /// Pool of buffered drawing objects for various scene views (safe to use from per-view job threads).
+        ConcurrentObjectPool< BufferedDrawer > m_viewBufferedDrawerPool;
         /// Buffered drawing objects for each scene view.
-        DynamicArray< BufferedDrawer* > m_viewBufferedDrawers;
+        DynamicArray< BufferedDrawer* > m_viewBufferedDrawers[ 2 ];
+        /// Index of the buffered drawer set receiving draw calls for the next frame.
+        size_t m_bufferedDrawerSetIndex;
+        /// Index of the buffered drawer set being rendered.
+        size_t m_renderBufferedDrawerSetIndex;
 #endif // GRAPHICS_SCENE_BUFFERED_DRAWER
 
-        /// Visible scene objects for the current view.
-        BitArray<> m_visibleSceneObjects;
-        /// Scene object sub-data index list (for sorting during rendering).
-        DynamicArray< size_t > m_sceneObjectSubMeshIndices;
+        /// Condition signaled when this scene is not being rendered on the render thread.
+        mutable Condition m_renderFrameCondition;
+        /// True if a frame of this scene has been queued on the render thread and not yet waited on.
+        mutable bool m_bRenderFramePending;
+
+        /// Visibility results for each scene view, indexed by view ID.
+        DynamicArray< ViewVisibility > m_viewVisibility;
+        /// IDs of the scene views being prepared for rendering during the current update.
+        DynamicArray< uint32_t > m_preparedViewIds;
+        /// Largest projected size, in pixels, of each scene object in the views prepared during the last update (zero
+        /// for objects not visible in any view), indexed by scene object ID.
+        DynamicArray< float32_t > m_sceneObjectScreenSizes;
+        /// True if shadow visibility is being prepared during the current update.
+        bool m_bPrepareShadowVisibility;
 
         /// Ambient light top color.
         Color m_ambientLightTopColor;
@@ -185,6 +261,17 @@ namespace Helium
         /// Pre-computed shadow depth pass inverse view/projection matrices.
         DynamicArray< Simd::Matrix44 > m_shadowViewInverseViewProjectionMatrices;
 
+        /// Shadow depth pass inverse view/projection matrix with which the shadow depth texture was last rendered.
+        Simd::Matrix44 m_cachedShadowInverseViewProjection;
+        /// Shadow depth texture last rendered.
+        RTexture2d* m_pCachedShadowDepthTexture;
+        /// Index of the view for which the shadow depth texture was last rendered.
+        uint32_t m_cachedShadowViewIndex;
+        /// Signature of the shadow casters last rendered into the shadow depth texture.
+        uint64_t m_cachedShadowCasterSignature;
+        /// True if the shadow depth texture contents can be reused when nothing affecting them has changed.
+        bool m_bShadowDepthCacheValid;
+
         /// Per-view global vertex constant buffers.
         DynamicArray< RConstantBufferPtr > m_viewVertexGlobalDataBuffers[ 2 ];
         /// Per-view base-pass vertex constant buffers.
@@ -198,36 +285,129 @@ namespace Helium
         /// Per-view vertex constant buffers for shadow depth rendering.
         DynamicArray< RConstantBufferPtr > m_shadowViewVertexDataBuffers[ 2 ];
 
-        /// Pool of per-instance vertex constant buffers for non-skinned meshes.
-        DynamicArray< RConstantBufferPtr > m_staticInstanceVertexGlobalDataBufferPool[ 2 ];
-        /// Pool of per-instance vertex constant buffers for skinned meshes.
-        DynamicArray< RConstantBufferPtr > m_skinnedInstanceVertexGlobalDataBufferPool[ 2 ];
-
-        /// Scene object global vertex constant buffers.
-        DynamicArray< RConstantBuffer* > m_objectVertexGlobalDataBuffers;
+        /// Pages of the per-frame arena holding the per-instance vertex constants of every skinned sub-mesh.
+        DynamicArray< RConstantBufferPtr > m_instanceVertexGlobalDataPages[ 2 ];
+        /// Mapped instance constant arena page addresses.
+        DynamicArray< uint8_t* > m_mappedInstanceVertexGlobalDataPages;
+
+        /// Pages of persistent per-object vertex constants for non-skinned meshes, with a fixed slot for each scene
+        /// object ID.  Only the slots of objects whose transform changed are rewritten each frame.
+        DynamicArray< RConstantBufferPtr > m_objectVertexGlobalDataPages;
+        /// Mapped persistent object constant page addresses (null for pages with no dirty objects this frame).
+        DynamicArray< uint8_t* > m_mappedObjectVertexGlobalDataPages;
+        /// IDs of the non-skinned scene objects whose transform constants are being written this frame.
+        DynamicArray< size_t > m_dirtyObjectIds;
+        /// Flags set for each scene object whose transform changed this frame, indexed by scene object ID.
+        DynamicArray< uint8_t > m_objectTransformUpdatedFlags;
+
+        /// Scene object global vertex constant ranges in the persistent object constant pages.
+        DynamicArray< InstanceConstantRange > m_objectVertexGlobalDataRanges;
         /// Mapped scene object global vertex constant buffer addresses.
         DynamicArray< float32_t* > m_mappedObjectVertexGlobalDataBuffers;
 
-        /// Sub-mesh global vertex constant buffers.
-        DynamicArray< RConstantBuffer* > m_subMeshVertexGlobalDataBuffers;
+        /// Sub-mesh global vertex constant ranges in the instance constant arena.
+        DynamicArray< InstanceConstantRange > m_subMeshVertexGlobalDataRanges;
         /// Mapped sub-mesh global veretex constant buffer addresses.
         DynamicArray< float32_t* > m_mappedSubMeshVertexGlobalDataBuffers;
 
+        /// Per-frame bone buffer holding the packed 3x4 skinning matrices of every skinned scene object.
+        DynamicArray< float32_t > m_skinningMatrices;
+        /// Offset of the first skinning matrix of each scene object in the bone buffer (invalid if not skinned).
+        DynamicArray< size_t > m_objectSkinningMatrixOffsets;
+        /// Address of the skinning matrices of each scene object in the bone buffer (null if not skinned).
+        DynamicArray< float32_t* > m_objectSkinningMatrixData;
+
         /// Current dynamic constant buffer set index.
         size_t m_constantBufferSetIndex;
 
+        /// Per-instance transform vertex buffer for instanced base pass rendering.
+        RVertexBufferPtr m_spInstanceVertexBuffer;
+        /// Number of instances for which space is allocated in the instance vertex buffer.
+        size_t m_instanceVertexBufferCapacity;
+        /// True if the base pass of the view being drawn uses instancing.
+        bool m_bBaseInstancingEnabled;
+
+        /// Deferred command proxies for recording each scene view pass.
+        RRenderCommandProxyPtr m_passCommandProxies[ RECORDED_PASS_MAX ];
+        /// Command lists recorded for each pass of the view being drawn.
+        RRenderCommandListPtr m_passCommandLists[ RECORDED_PASS_MAX ];
+        /// Index of the view for which passes are being recorded.
+        uint_fast32_t m_recordingViewIndex;
+
+        /// Render graph describing the passes of the view being drawn.
+        RenderGraph m_renderGraph;
+        /// Index of the view being drawn through the render graph.
+        uint_fast32_t m_renderGraphViewIndex;
+        /// Render graph ID of the scene texture.
+        uint32_t m_renderGraphSceneTextureId;
+        /// Render graph ID of the shadow depth texture (invalid if shadows are disabled).
+        uint32_t m_renderGraphShadowDepthTextureId;
+
+        /// Name of the shader variant manifest file for this scene (empty if not using a manifest).
+        Name m_shaderVariantManifestName;
+        /// Shader variants used by this scene, recorded for warming up the next time the scene is loaded.
+        ShaderVariantManifest* m_pShaderVariantManifest;
+        /// True if shader variants from the manifest are still being warmed up.
+        bool m_bShaderVariantWarmupPending;
+
         /// @name Rendering
         //@{
+        bool ExtractFrame( World* pWorld );
+        void RenderFrame();
+
         void UpdateShadowInverseViewProjectionMatrixSimple( size_t viewIndex );
         void UpdateShadowInverseViewProjectionMatrixLspsm( size_t viewIndex );
 
         void SwapDynamicConstantBuffers();
 
+        bool GetShaderVariantManifestPath( FilePath& rPath ) const;
+        void SaveShaderVariantManifest();
+
+        void PrepareSceneViews();
+        void PrepareSceneView( uint_fast32_t viewIndex );
+        void AssignClusteredLights();
+        void UpdateSceneObjectScreenSizes();
+        void RequestStreamedTextures();
+        void UpdateSubMeshStateSortValues();
+        void CullOccludedSceneObjects( const GraphicsSceneView& rView, ViewVisibility& rVisibility ) const;
+        void SelectSceneObjectLods(
+            const GraphicsSceneView& rView, const DynamicArray< size_t >& rSceneObjectIds,
+            DynamicArray< uint8_t >& rSceneObjectLods ) const;
+        size_t GetSceneObjectLod( uint_fast32_t viewIndex, size_t sceneObjectId ) const;
+        void QueueDepthSortedSubMeshes(
+            const DynamicArray< size_t >& rSceneObjectIds, uint64_t pass, const Simd::Vector3& rDirection,
+            const Simd::Frustum& rFrustum, DynamicArray< uint64_t >& rSortKeys ) const;
+        void QueueStateSortedSubMeshes(
+            const DynamicArray< size_t >& rSceneObjectIds, uint64_t pass, const Simd::Frustum& rFrustum,
+            DynamicArray< uint64_t >& rSortKeys ) const;
+        bool IsSubMeshInFrustum(
+            size_t subMeshIndex, const GraphicsSceneObject& rSceneObject, const Simd::Frustum& rFrustum ) const;
+        void FindInstanceRuns(
+            const DynamicArray< size_t >& rSubMeshIndices, const DynamicArray< uint8_t >& rSceneObjectLods,
+            DynamicArray< uint32_t >& rInstanceCounts ) const;
+        bool CanInstanceSubMesh( size_t subMeshIndex ) const;
+        RConstantBuffer* GetInstanceVertexGlobalData(
+            size_t subMeshIndex, size_t sceneObjectId, size_t& rOffset, size_t& rSize ) const;
+
         void DrawSceneView( uint_fast32_t viewIndex );
+        void DrawSceneTexture( uint_fast32_t viewIndex, RTexture2d* pSceneTexture, RRenderCommandProxy* pCommandProxy );
+        void DrawSceneTextureToScreen(
+            uint_fast32_t viewIndex, RTexture2d* pSceneTexture, RRenderCommandProxy* pCommandProxy );
+        void RecordScenePasses( uint_fast32_t viewIndex );
+        void SubmitScenePass( ERecordedPass pass, uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy );
+        void DrawScenePass( ERecordedPass pass, uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy );
+        uint32_t BeginGpuTiming( const char* pName, RRenderCommandProxy* pCommandProxy );
+        void EndGpuTiming( uint32_t timingIndex, RRenderCommandProxy* pCommandProxy );
+
+        void DrawShadowDepthPass( uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy );
+        uint64_t GetShadowCasterSignature( uint_fast32_t viewIndex, const DynamicArray< size_t >& rSubMeshIndices ) const;
+        void DrawDepthPrePass( uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy );
+        void DrawBasePass( uint_fast32_t viewIndex, RRenderCommandProxy* pCommandProxy, bool bInstancingEnabled );
+        size_t UpdateInstanceVertexBuffer( uint_fast32_t viewIndex );
 
-        void DrawShadowDepthPass( uint_fast32_t viewIndex );
-        void DrawDepthPrePass( uint_fast32_t viewIndex );
-        void DrawBasePass( uint_fast32_t viewIndex );
+#if GRAPHICS_SCENE_BUFFERED_DRAWER
+        void DrawRenderStatisticsOverlay();
+#endif // GRAPHICS_SCENE_BUFFERED_DRAWER
         //@}
 
         /// @name Private Static Utility Functions
@@ -237,6 +417,20 @@ namespace Helium
         static Name GetSkinningSysSelectName();
         static Name GetSkinningSmoothOptionName();
         static Name GetSkinningRigidOptionName();
+
+        static Name GetInstancingSysSelectName();
+        static Name GetInstancingTransformOptionName();
+
+        static Name GetClusteredLightsSysToggleName();
+
+        static void RenderFrameCallback( void* pData );
+        static void PrepareSceneViewCallback( void* pContext, size_t index );
+        static void AssignClusteredLightsCallback( void* pContext, size_t index );
+        static void RecordScenePassCallback( void* pContext, size_t index );
+        static void ExecuteShadowDepthGraphPass(
+            void* pUserData, const RenderGraph& rGraph, RRenderCommandProxy* pCommandProxy );
+        static void ExecuteSceneGraphPass( void* pUserData, const RenderGraph& rGraph, RRenderCommandProxy* pCommandProxy );
+        static void ExecuteScreenGraphPass( void* pUserData, const RenderGraph& rGraph, RRenderCommandProxy* pCommandProxy );
         //@}
     };
 }
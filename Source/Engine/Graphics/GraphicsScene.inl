@@ -9,12 +9,24 @@ namespace Helium
     /// @see AllocateSceneView(), ReleaseSceneView(), SetActiveSceneView()
     GraphicsSceneView* GraphicsScene::GetSceneView( uint32_t id )
     {
+        WaitForRenderFrame();
+
         HELIUM_ASSERT( id < m_sceneViews.GetSize() );
         HELIUM_ASSERT( m_sceneViews.IsElementValid( id ) );
 
         return &m_sceneViews[ id ];
     }
 
+    /// Get the ID of the active scene view used for rendering.
+    ///
+    /// @return  Active scene view ID, or an invalid index if no view is active.
+    ///
+    /// @see SetActiveSceneView(), GetSceneView()
+    uint32_t GraphicsScene::GetActiveSceneViewId() const
+    {
+        return m_activeViewId;
+    }
+
     /// Access the scene object with the specified ID.
     ///
     /// @param[in] id  ID of the object to retrieve.
@@ -24,12 +36,30 @@ namespace Helium
     /// @see AllocateSceneObject(), ReleaseSceneObject()
     GraphicsSceneObject* GraphicsScene::GetSceneObject( size_t id )
     {
+        WaitForRenderFrame();
+
         HELIUM_ASSERT( id < m_sceneObjects.GetSize() );
         HELIUM_ASSERT( m_sceneObjects.IsElementValid( id ) );
 
         return &m_sceneObjects[ id ];
     }
 
+    /// Get the projected size of a scene object in the views prepared during the last update.
+    ///
+    /// This is meant for picking the level of detail of per-object work done before the next update, such as animation
+    /// (see AnimationLod), so it lags one frame behind.
+    ///
+    /// @param[in] id  Scene object ID.
+    ///
+    /// @return  Largest projected diameter of the object bounds over all prepared views, in pixels, or zero if the
+    ///          object was not visible in any view.
+    float32_t GraphicsScene::GetSceneObjectScreenSize( size_t id ) const
+    {
+        WaitForRenderFrame();
+
+        return ( id < m_sceneObjectScreenSizes.GetSize() ? m_sceneObjectScreenSizes[ id ] : 0.0f );
+    }
+
     /// Access the scene object sub-mesh data with the specified ID.
     ///
     /// @param[in] id  ID of the sub-mesh data to retrieve.
@@ -39,12 +69,31 @@ namespace Helium
     /// @see AllocateSceneObjectSubMeshData(), ReleaseSceneObjectSubMeshData()
     GraphicsSceneObject::SubMeshData* GraphicsScene::GetSceneObjectSubMeshData( size_t id )
     {
+        WaitForRenderFrame();
+
         HELIUM_ASSERT( id < m_sceneObjectSubMeshes.GetSize() );
         HELIUM_ASSERT( m_sceneObjectSubMeshes.IsElementValid( id ) );
 
         return &m_sceneObjectSubMeshes[ id ];
     }
 
+    /// Access the dynamic light with the specified ID.
+    ///
+    /// @param[in] id  ID of the light to retrieve.
+    ///
+    /// @return  Pointer to the specified light.
+    ///
+    /// @see AllocateLight(), ReleaseLight()
+    GraphicsSceneLight* GraphicsScene::GetLight( size_t id )
+    {
+        WaitForRenderFrame();
+
+        HELIUM_ASSERT( id < m_lights.GetSize() );
+        HELIUM_ASSERT( m_lights.IsElementValid( id ) );
+
+        return &m_lights[ id ];
+    }
+
     /// Get the ambient light color for upward-facing normals.
     ///
     /// @return  Ambient light color for upward-facing normals.
@@ -128,7 +177,7 @@ namespace Helium
     /// @see GetSceneViewBufferedDrawer()
     BufferedDrawer& GraphicsScene::GetSceneBufferedDrawer()
     {
-        return m_sceneBufferedDrawer;
+        return m_sceneBufferedDrawers[ m_bufferedDrawerSetIndex ];
     }
 #endif  // !HELIUM_RELEASE && !HELIUM_PROFILE
 }
@@ -3,7 +3,11 @@
 
 #include "Rendering/RConstantBuffer.h"
 #include "Rendering/Renderer.h"
+#include "Rendering/RVertexShader.h"
+#include "Platform/Atomic.h"
+#include "Graphics/GraphicsScene.h"
 #include "Graphics/Texture.h"
+#include "Engine/AssetLoader.h"
 
 #include "Reflect/TranslatorDeduction.h"
 
@@ -17,14 +21,18 @@ HELIUM_DEFINE_CLASS( Helium::Material::PersistentResourceData );
 
 using namespace Helium;
 
+volatile int32_t Material::sm_lastBindingId = 0;
+
 /// Constructor.
 Material::Material()
+: m_bindingId( 0 )
 {
 	MemoryZero( m_persistentResourceData.m_shaderVariantIndices, sizeof( m_persistentResourceData.m_shaderVariantIndices ) );
 
 	for( size_t shaderTypeIndex = 0; shaderTypeIndex < HELIUM_ARRAY_COUNT( m_persistentResourceData.m_shaderVariantIndices ); ++shaderTypeIndex )
 	{
 		SetInvalid( m_shaderVariantLoadIds[ shaderTypeIndex ] );
+		SetInvalid( m_fallbackShaderVariantLoadIds[ shaderTypeIndex ] );
 		SetInvalid( m_constantBufferLoadIds[ shaderTypeIndex ] );
 	}
 
@@ -154,6 +162,14 @@ bool Material::BeginPrecacheResourceData()
 	}
 #endif
 
+	// Finish any shader variant loads still running from a previous precache.
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+	while( !UpdateShaderVariants() )
+	{
+		pAssetLoader->Tick();
+	}
+
 	// Preload shader variant resources.
 	Shader* pShader = m_spShader;
 	if( !pShader )
@@ -169,9 +185,22 @@ bool Material::BeginPrecacheResourceData()
 		for( size_t shaderTypeIndex = 0; shaderTypeIndex < HELIUM_ARRAY_COUNT( m_shaderVariants ); ++shaderTypeIndex )
 		{
 			HELIUM_ASSERT( IsInvalid( m_shaderVariantLoadIds[ shaderTypeIndex ] ) );
+			HELIUM_ASSERT( IsInvalid( m_fallbackShaderVariantLoadIds[ shaderTypeIndex ] ) );
+
+			uint32_t variantIndex = m_persistentResourceData.m_shaderVariantIndices[ shaderTypeIndex ];
 			m_shaderVariantLoadIds[ shaderTypeIndex ] = pShader->BeginLoadVariant(
 				static_cast< RShader::EType >( shaderTypeIndex ),
-				m_persistentResourceData.m_shaderVariantIndices[ shaderTypeIndex ] );
+				variantIndex );
+
+			// Also load the variant for the default user options so that the material can be drawn with it if the
+			// actual variant takes a while to compile.  The default variant is shared by most materials using the
+			// same shader, so it is usually ready much sooner.
+			if( variantIndex != 0 && IsValid( m_shaderVariantLoadIds[ shaderTypeIndex ] ) )
+			{
+				m_fallbackShaderVariantLoadIds[ shaderTypeIndex ] = pShader->BeginLoadVariant(
+					static_cast< RShader::EType >( shaderTypeIndex ),
+					0 );
+			}
 		}
 	}
 
@@ -241,19 +270,14 @@ bool Material::BeginPrecacheResourceData()
 /// @copydoc Asset::TryFinishPrecacheResourceData()
 bool Material::TryFinishPrecacheResourceData()
 {
-	Shader* pShader = m_spShader;
-	if( pShader )
+	// Precaching can finish once each shader type has either its actual variant or a fallback variant.  Variant loads
+	// still running afterward are finished by UpdateShaderVariants().
+	bool bShaderVariantsLoaded = TryFinishShaderVariantLoads();
+	for( size_t shaderTypeIndex = 0; shaderTypeIndex < HELIUM_ARRAY_COUNT( m_shaderVariants ); ++shaderTypeIndex )
 	{
-		for( size_t shaderTypeIndex = 0; shaderTypeIndex < HELIUM_ARRAY_COUNT( m_shaderVariants ); ++shaderTypeIndex )
+		if( IsValid( m_shaderVariantLoadIds[ shaderTypeIndex ] ) && !m_shaderVariants[ shaderTypeIndex ] )
 		{
-			size_t loadId = m_shaderVariantLoadIds[ shaderTypeIndex ];
-			if( IsValid( loadId ) &&
-				!pShader->TryFinishLoadVariant( loadId, m_shaderVariants[ shaderTypeIndex ] ) )
-			{
-				return false;
-			}
-
-			SetInvalid( m_shaderVariantLoadIds[ shaderTypeIndex ] );
+			return false;
 		}
 	}
 
@@ -278,13 +302,266 @@ bool Material::TryFinishPrecacheResourceData()
 	}
 
 #if HELIUM_TOOLS
-	// Synchronize shader constant parameters with those exposed by the shader variant resources.
-	SynchronizeShaderParameters();
+	// Synchronize shader constant parameters with those exposed by the shader variant resources (deferred until the
+	// actual variants have loaded if we are using fallbacks).
+	if( bShaderVariantsLoaded )
+	{
+		SynchronizeShaderParameters();
+	}
+#else
+	HELIUM_UNREF( bShaderVariantsLoaded );
 #endif
 
+	BakeBindingBlocks();
+
 	return true;
 }
 
+/// Poll shader variant loads still running after precaching finished with fallback variants, and replace the
+/// fallbacks with the actual shader variants once they are ready.
+///
+/// This should be called regularly from the main thread for materials in use, and not while the material may be
+/// drawn from other threads.
+///
+/// @return  True if all shader variant loads have finished, false if some are still pending.
+///
+/// @see IsUsingFallbackShaderVariants()
+bool Material::UpdateShaderVariants()
+{
+	bool bUsingFallbacks = IsUsingFallbackShaderVariants();
+	ShaderVariant* pPreviousPixelShaderVariant = m_shaderVariants[ RShader::TYPE_PIXEL ];
+	bool bFinished = TryFinishShaderVariantLoads();
+
+#if HELIUM_TOOLS
+	// Now that the actual variants are available, synchronize the shader parameters we skipped while precaching.
+	if( bUsingFallbacks && !IsUsingFallbackShaderVariants() )
+	{
+		SynchronizeShaderParameters();
+	}
+#else
+	HELIUM_UNREF( bUsingFallbacks );
+#endif
+
+	// Texture and sampler inputs may differ between the fallback and actual pixel shader variants.
+	if( m_shaderVariants[ RShader::TYPE_PIXEL ] != pPreviousPixelShaderVariant )
+	{
+		BakeBindingBlocks();
+	}
+
+	return bFinished;
+}
+
+/// Perform a non-blocking attempt to finish loading the material shader variants and their fallbacks.
+///
+/// Fallback variants are only assigned while the corresponding actual variant is still loading.
+///
+/// @return  True if all shader variant loads (including fallback loads) have finished, false if not.
+bool Material::TryFinishShaderVariantLoads()
+{
+	Shader* pShader = m_spShader;
+	if( !pShader )
+	{
+		return true;
+	}
+
+	bool bFinished = true;
+
+	for( size_t shaderTypeIndex = 0; shaderTypeIndex < HELIUM_ARRAY_COUNT( m_shaderVariants ); ++shaderTypeIndex )
+	{
+		size_t& rFallbackLoadId = m_fallbackShaderVariantLoadIds[ shaderTypeIndex ];
+		if( IsValid( rFallbackLoadId ) )
+		{
+			ShaderVariantPtr spFallbackVariant;
+			if( pShader->TryFinishLoadVariant( rFallbackLoadId, spFallbackVariant ) )
+			{
+				SetInvalid( rFallbackLoadId );
+
+				if( IsValid( m_shaderVariantLoadIds[ shaderTypeIndex ] ) )
+				{
+					m_shaderVariants[ shaderTypeIndex ] = spFallbackVariant;
+				}
+			}
+			else
+			{
+				bFinished = false;
+			}
+		}
+
+		size_t& rLoadId = m_shaderVariantLoadIds[ shaderTypeIndex ];
+		if( IsValid( rLoadId ) )
+		{
+			if( pShader->TryFinishLoadVariant( rLoadId, m_shaderVariants[ shaderTypeIndex ] ) )
+			{
+				SetInvalid( rLoadId );
+			}
+			else
+			{
+				bFinished = false;
+			}
+		}
+	}
+
+	return bFinished;
+}
+
+/// Create the input layouts for drawing a vertex format with each loaded render resource of the vertex shader
+/// variant, so that the first draw using this material does not need to create them.
+///
+/// Input layouts are shared through Renderer::GetVertexInputLayout(), so this only creates driver objects for vertex
+/// formats and shader input signatures that have not been used together before.
+///
+/// @param[in] pDescription  Vertex description of the mesh being drawn with this material.
+///
+/// @see Renderer::GetVertexInputLayout(), RVertexShader::GetInputLayout()
+void Material::PrecacheVertexInputLayouts( RVertexDescription* pDescription ) const
+{
+	Renderer* pRenderer = Renderer::GetInstance();
+	ShaderVariant* pVertexShaderVariant = m_shaderVariants[ RShader::TYPE_VERTEX ];
+	if( !pRenderer || !pVertexShaderVariant || !pDescription )
+	{
+		return;
+	}
+
+	size_t resourceCount = pVertexShaderVariant->GetRenderResourceCount();
+	for( size_t resourceIndex = 0; resourceIndex < resourceCount; ++resourceIndex )
+	{
+		RShader* pShader = pVertexShaderVariant->GetRenderResource( resourceIndex );
+		if( pShader )
+		{
+			HELIUM_ASSERT( pShader->GetType() == RShader::TYPE_VERTEX );
+			static_cast< RVertexShader* >( pShader )->GetInputLayout( pRenderer, pDescription );
+		}
+	}
+}
+
+/// Resolve the sampler and texture inputs of each pixel shader render resource against the material parameters,
+/// replacing any previously baked binding blocks and assigning a new binding ID.
+///
+/// @see GetBindingBlock(), GetBindingId()
+void Material::BakeBindingBlocks()
+{
+	m_bindingBlocks.Resize( 0 );
+	m_bindingId = static_cast< uint32_t >( AtomicIncrementUnsafe( sm_lastBindingId ) );
+
+	ShaderVariant* pPixelShaderVariant = m_shaderVariants[ RShader::TYPE_PIXEL ];
+	if( !pPixelShaderVariant )
+	{
+		return;
+	}
+
+	Name defaultSamplerStateName = GraphicsScene::GetDefaultSamplerStateName();
+	Name shadowSamplerStateName = GraphicsScene::GetShadowSamplerStateName();
+	Name shadowMapTextureName = GraphicsScene::GetShadowMapTextureName();
+
+	// Scene textures looked up by name, indexed by BindingBlock::ESceneTexture value.
+	Name sceneTextureNames[ BindingBlock::SCENE_TEXTURE_MAX ];
+	sceneTextureNames[ BindingBlock::SCENE_TEXTURE_SHADOW_MAP ] = shadowMapTextureName;
+	sceneTextureNames[ BindingBlock::SCENE_TEXTURE_CLUSTER_LIGHTS ] = GraphicsScene::GetClusterLightsTextureName();
+	sceneTextureNames[ BindingBlock::SCENE_TEXTURE_CLUSTER_GRID ] = GraphicsScene::GetClusterGridTextureName();
+	sceneTextureNames[ BindingBlock::SCENE_TEXTURE_CLUSTER_LIGHT_INDICES ] =
+		GraphicsScene::GetClusterLightIndicesTextureName();
+
+	size_t resourceCount = pPixelShaderVariant->GetRenderResourceCount();
+	m_bindingBlocks.Resize( resourceCount );
+
+	for( size_t resourceIndex = 0; resourceIndex < resourceCount; ++resourceIndex )
+	{
+		BindingBlock& rBlock = m_bindingBlocks[ resourceIndex ];
+
+		const ShaderSamplerInfoSet* pSamplerInfoSet = pPixelShaderVariant->GetSamplerInfoSet( resourceIndex );
+		if( pSamplerInfoSet )
+		{
+			const DynamicArray< ShaderSamplerInfo >& rSamplerInputs = pSamplerInfoSet->inputs;
+			size_t samplerInputCount = rSamplerInputs.GetSize();
+			rBlock.samplers.Reserve( samplerInputCount );
+			for( size_t inputIndex = 0; inputIndex < samplerInputCount; ++inputIndex )
+			{
+				const ShaderSamplerInfo& rInputInfo = rSamplerInputs[ inputIndex ];
+				Name samplerName = rInputInfo.name;
+
+				BindingBlock::SamplerBinding binding;
+				binding.bindIndex = rInputInfo.bindIndex;
+				binding.sampler = BindingBlock::SAMPLER_NONE;
+				if( samplerName == defaultSamplerStateName )
+				{
+					binding.sampler = BindingBlock::SAMPLER_DEFAULT;
+				}
+				else if( samplerName == shadowSamplerStateName ||  // Shader model 4+
+					samplerName == shadowMapTextureName )           // Older shader versions
+				{
+					binding.sampler = BindingBlock::SAMPLER_SHADOW_MAP;
+				}
+				else
+				{
+					// Scene data lookup textures are sampled with point filtering in older shader versions.
+					for( size_t sceneTextureIndex = BindingBlock::SCENE_TEXTURE_CLUSTER_LIGHTS;
+						sceneTextureIndex < BindingBlock::SCENE_TEXTURE_MAX;
+						++sceneTextureIndex )
+					{
+						if( samplerName == sceneTextureNames[ sceneTextureIndex ] )
+						{
+							binding.sampler = BindingBlock::SAMPLER_POINT_CLAMP;
+
+							break;
+						}
+					}
+				}
+
+				rBlock.samplers.Push( binding );
+			}
+		}
+
+		const ShaderTextureInfoSet* pTextureInfoSet = pPixelShaderVariant->GetTextureInfoSet( resourceIndex );
+		if( pTextureInfoSet )
+		{
+			size_t materialTextureCount = m_textureParameters.GetSize();
+
+			const DynamicArray< ShaderTextureInfo >& rTextureInputs = pTextureInfoSet->inputs;
+			size_t textureInputCount = rTextureInputs.GetSize();
+			rBlock.textures.Reserve( textureInputCount );
+			for( size_t inputIndex = 0; inputIndex < textureInputCount; ++inputIndex )
+			{
+				const ShaderTextureInfo& rInputInfo = rTextureInputs[ inputIndex ];
+				Name textureName = rInputInfo.name;
+
+				BindingBlock::TextureBinding binding;
+				binding.bindIndex = rInputInfo.bindIndex;
+				binding.pTexture = NULL;
+				binding.sceneTexture = BindingBlock::SCENE_TEXTURE_NONE;
+				for( size_t sceneTextureIndex = BindingBlock::SCENE_TEXTURE_SHADOW_MAP;
+					sceneTextureIndex < BindingBlock::SCENE_TEXTURE_MAX;
+					++sceneTextureIndex )
+				{
+					if( textureName == sceneTextureNames[ sceneTextureIndex ] )
+					{
+						binding.sceneTexture = static_cast< BindingBlock::ESceneTexture >( sceneTextureIndex );
+
+						break;
+					}
+				}
+
+				if( binding.sceneTexture == BindingBlock::SCENE_TEXTURE_NONE )
+				{
+					for( size_t materialTextureIndex = 0;
+						materialTextureIndex < materialTextureCount;
+						++materialTextureIndex )
+					{
+						const TextureParameter& rTextureParameter = m_textureParameters[ materialTextureIndex ];
+						if( rTextureParameter.name == textureName )
+						{
+							binding.pTexture = rTextureParameter.value;
+
+							break;
+						}
+					}
+				}
+
+				rBlock.textures.Push( binding );
+			}
+		}
+	}
+}
+
 bool Helium::Material::LoadPersistentResourceObject( Reflect::ObjectPtr &_object )
 {
 	HELIUM_ASSERT(_object.ReferencesObject());
@@ -20,6 +20,7 @@ namespace Helium
 	typedef Helium::StrongPtr< const ShaderVariant > ConstShaderVariantPtr;
 
 	HELIUM_DECLARE_RPTR( RConstantBuffer );
+	HELIUM_DECLARE_RPTR( RVertexDescription );
 
 	/// Material resource type.
 	class HELIUM_GRAPHICS_API Material : public Resource
@@ -115,6 +116,80 @@ namespace Helium
 			uint32_t m_shaderVariantIndices[ RShader::TYPE_MAX ];
 		};
 
+		/// Resources bound for drawing with a material using a specific pixel shader variant resource.
+		///
+		/// Blocks are baked once the material has loaded, resolving the sampler and texture inputs of each system
+		/// option set of the pixel shader against the material parameters, so that a material can be bound without any
+		/// name lookups.  Along with the material constant buffers, they make up all of the material-specific state set
+		/// for a draw.
+		struct HELIUM_GRAPHICS_API BindingBlock
+		{
+			/// Sampler states bound to sampler inputs.
+			enum ESampler
+			{
+				SAMPLER_FIRST   =  0,
+				SAMPLER_INVALID = -1,
+
+				/// No sampler state.
+				SAMPLER_NONE,
+				/// Default material sampler state.
+				SAMPLER_DEFAULT,
+				/// Shadow map sampler state.
+				SAMPLER_SHADOW_MAP,
+				/// Point-filtered, clamped sampler state for scene data lookup textures.
+				SAMPLER_POINT_CLAMP,
+
+				SAMPLER_MAX,
+				SAMPLER_LAST = SAMPLER_MAX - 1
+			};
+
+			/// Scene textures bound to texture inputs in place of material textures.
+			enum ESceneTexture
+			{
+				SCENE_TEXTURE_FIRST   =  0,
+				SCENE_TEXTURE_INVALID = -1,
+
+				/// No scene texture (bind a material texture).
+				SCENE_TEXTURE_NONE,
+				/// Shadow depth texture.
+				SCENE_TEXTURE_SHADOW_MAP,
+				/// Clustered light data texture.
+				SCENE_TEXTURE_CLUSTER_LIGHTS,
+				/// Clustered light grid texture.
+				SCENE_TEXTURE_CLUSTER_GRID,
+				/// Clustered light index list texture.
+				SCENE_TEXTURE_CLUSTER_LIGHT_INDICES,
+
+				SCENE_TEXTURE_MAX,
+				SCENE_TEXTURE_LAST = SCENE_TEXTURE_MAX - 1
+			};
+
+			/// Sampler input binding.
+			struct SamplerBinding
+			{
+				/// Sampler bind index.
+				uint32_t bindIndex;
+				/// Sampler state to bind.
+				ESampler sampler;
+			};
+
+			/// Texture input binding.
+			struct TextureBinding
+			{
+				/// Texture bind index.
+				uint32_t bindIndex;
+				/// Material texture to bind (null if not bound to a material texture parameter).
+				Texture* pTexture;
+				/// Scene texture to bind instead of a material texture.
+				ESceneTexture sceneTexture;
+			};
+
+			/// Sampler input bindings.
+			DynamicArray< SamplerBinding > samplers;
+			/// Texture input bindings.
+			DynamicArray< TextureBinding > textures;
+		};
+
 		/// @name Construction/Destruction
 		//@{
 		Material();
@@ -150,6 +225,7 @@ namespace Helium
 		inline Shader* GetShader() const;
 		inline uint32_t GetShaderVariantIndex( RShader::EType shaderType ) const;
 		inline ShaderVariant* GetShaderVariant( RShader::EType shaderType ) const;
+		inline bool IsUsingFallbackShaderVariants() const;
 
 		inline RConstantBuffer* GetConstantBuffer( RShader::EType shaderType ) const;
 
@@ -173,6 +249,19 @@ namespace Helium
 #endif
 		//@}
 
+		/// @name Shader Variant Loading
+		//@{
+		bool UpdateShaderVariants();
+		//@}
+
+		/// @name Resource Binding
+		//@{
+		inline uint32_t GetBindingId() const;
+		inline const BindingBlock* GetBindingBlock( size_t pixelShaderIndex ) const;
+
+		void PrecacheVertexInputLayouts( RVertexDescription* pDescription ) const;
+		//@}
+
 		/// @name Static Information
 		//@{
 		static Name GetParameterConstantBufferName();
@@ -187,6 +276,12 @@ namespace Helium
 		//@}
 
 	private:
+		/// @name Private Utility Functions
+		//@{
+		bool TryFinishShaderVariantLoads();
+		void BakeBindingBlocks();
+		//@}
+
 		/// Material shader.
 		//AssetPtr m_spShaderAsAsset;
 		ShaderPtr m_spShader;
@@ -196,6 +291,8 @@ namespace Helium
 		ShaderVariantPtr m_shaderVariants[ RShader::TYPE_MAX ];
 		/// Shader variant load IDs.
 		size_t m_shaderVariantLoadIds[ RShader::TYPE_MAX ];
+		/// Fallback shader variant (default user options) load IDs.
+		size_t m_fallbackShaderVariantLoadIds[ RShader::TYPE_MAX ];
 
 		/// Constant buffers for material parameters.
 		RConstantBufferPtr m_constantBuffers[ RShader::TYPE_MAX ];
@@ -205,6 +302,14 @@ namespace Helium
 		/// Shader texture parameters.
 		DynamicArray< TextureParameter > m_textureParameters;
 
+		/// Resource bindings for each render resource of the pixel shader variant, indexed by system option set index.
+		DynamicArray< BindingBlock > m_bindingBlocks;
+		/// Unique ID assigned each time the binding blocks are baked (zero if they have never been baked).
+		uint32_t m_bindingId;
+
+		/// Last binding ID assigned.
+		static volatile int32_t sm_lastBindingId;
+
 #if HELIUM_TOOLS
 		/// User options cached during loading.
 		DynamicArray< Shader::SelectPair > m_userOptions;
@@ -32,6 +32,25 @@ namespace Helium
         return m_shaderVariants[ shaderType ];
     }
 
+    /// Get whether any of the shader variants returned by GetShaderVariant() are fallback variants used in place of
+    /// variants that are still loading.
+    ///
+    /// @return  True if a fallback shader variant is being used, false if not.
+    ///
+    /// @see UpdateShaderVariants()
+    bool Material::IsUsingFallbackShaderVariants() const
+    {
+        for( size_t shaderTypeIndex = 0; shaderTypeIndex < HELIUM_ARRAY_COUNT( m_shaderVariantLoadIds ); ++shaderTypeIndex )
+        {
+            if( IsValid( m_shaderVariantLoadIds[ shaderTypeIndex ] ) )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     /// Get the constant buffer render resource for the specified shader type.
     ///
     /// @param[in] shaderType  Shader type.
@@ -44,6 +63,31 @@ namespace Helium
         return m_constantBuffers[ shaderType ];
     }
 
+    /// Get the ID of the binding blocks currently baked for this material.
+    ///
+    /// A new ID is assigned whenever the blocks are baked again (such as when a fallback shader variant is replaced),
+    /// so two draws with the same binding ID and pixel shader system option set share the same material bindings.
+    ///
+    /// @return  Binding ID, or zero if no binding blocks have been baked.
+    ///
+    /// @see GetBindingBlock()
+    uint32_t Material::GetBindingId() const
+    {
+        return m_bindingId;
+    }
+
+    /// Get the resource bindings for drawing with a given render resource of the pixel shader variant.
+    ///
+    /// @param[in] pixelShaderIndex  System option set index of the pixel shader render resource.
+    ///
+    /// @return  Binding block for the pixel shader render resource, or null if no block has been baked for it.
+    ///
+    /// @see GetBindingId()
+    const Material::BindingBlock* Material::GetBindingBlock( size_t pixelShaderIndex ) const
+    {
+        return ( pixelShaderIndex < m_bindingBlocks.GetSize() ? &m_bindingBlocks[ pixelShaderIndex ] : NULL );
+    }
+
     /// Get the number of texture parameters exposed in this material.
     ///
     /// @return  Texture parameter count.
@@ -4,6 +4,7 @@
 #include "Engine/AsyncLoader.h"
 #include "MathSimd/Matrix44.h"
 #include "Engine/CacheManager.h"
+#include "Engine/CookedObjectLayout.h"
 #include "Rendering/RIndexBuffer.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/RVertexBuffer.h"
@@ -15,6 +16,7 @@
 
 HELIUM_IMPLEMENT_ASSET( Helium::Mesh, Graphics, AssetType::FLAG_NO_TEMPLATE );
 HELIUM_DEFINE_CLASS( Helium::Mesh::PersistentResourceData );
+HELIUM_DEFINE_COOKED_LAYOUT( Helium::Mesh::PersistentResourceData );
 
 using namespace Helium;
 
@@ -32,6 +34,7 @@ Mesh::~Mesh()
     HELIUM_ASSERT( !m_spIndexBuffer );
     HELIUM_ASSERT( IsInvalid( m_vertexBufferLoadId ) );
     HELIUM_ASSERT( IsInvalid( m_indexBufferLoadId ) );
+    HELIUM_ASSERT( m_lodIndexBufferLoadIds.IsEmpty() );
 }
 
 /// @copydoc Asset::PreDestroy()
@@ -39,6 +42,7 @@ void Mesh::RefCountPreDestroy()
 {
     HELIUM_ASSERT( IsInvalid( m_vertexBufferLoadId ) );
     HELIUM_ASSERT( IsInvalid( m_indexBufferLoadId ) );
+    HELIUM_ASSERT( m_lodIndexBufferLoadIds.IsEmpty() );
 
     m_spVertexBuffer.Release();
     m_spIndexBuffer.Release();
@@ -62,6 +66,7 @@ bool Mesh::BeginPrecacheResourceData()
 {
     HELIUM_ASSERT( IsInvalid( m_vertexBufferLoadId ) );
     HELIUM_ASSERT( IsInvalid( m_indexBufferLoadId ) );
+    HELIUM_ASSERT( m_lodIndexBufferLoadIds.IsEmpty() );
 
     Renderer* pRenderer = Renderer::GetInstance();
     if( !pRenderer )
@@ -123,6 +128,32 @@ bool Mesh::BeginPrecacheResourceData()
     if( m_persistentResourceData.m_triangleCount != 0 )
     {
         size_t indexDataSize = GetSubDataSize( 1 );
+
+        // The indices of each level of detail past the first are stored in their own sub-data, and loaded after those
+        // of the full-detail mesh in the same index buffer.
+        size_t lodRangeCount = m_persistentResourceData.m_lodScreenSizes.GetSize();
+        size_t fullIndexDataSize = indexDataSize;
+        for( size_t lodRangeIndex = 0; lodRangeIndex < lodRangeCount && IsValid( fullIndexDataSize ); ++lodRangeIndex )
+        {
+            size_t lodIndexDataSize = GetSubDataSize( static_cast< uint32_t >( 2 + lodRangeIndex ) );
+            if( IsInvalid( lodIndexDataSize ) )
+            {
+                HELIUM_TRACE(
+                    TraceLevels::Warning,
+                    "Mesh::BeginPrecacheResourceData(): Failed to locate cached index buffer data for level of detail %" PRIuSZ " of mesh \"%s\".  Only the full-detail mesh will be used.\n",
+                    lodRangeIndex + 1,
+                    *GetPath().ToString() );
+
+                ClearLods();
+                lodRangeCount = 0;
+                fullIndexDataSize = indexDataSize;
+
+                break;
+            }
+
+            fullIndexDataSize += lodIndexDataSize;
+        }
+
         if( IsInvalid( indexDataSize ) )
         {
             HELIUM_TRACE(
@@ -132,6 +163,8 @@ bool Mesh::BeginPrecacheResourceData()
         }
         else
         {
+            indexDataSize = fullIndexDataSize;
+
             m_spIndexBuffer = pRenderer->CreateIndexBuffer(
                 indexDataSize,
                 RENDERER_BUFFER_USAGE_STATIC,
@@ -169,6 +202,34 @@ bool Mesh::BeginPrecacheResourceData()
                         m_spIndexBuffer->Unmap();
                         m_spIndexBuffer.Release();
                     }
+                    else
+                    {
+                        uint8_t* pLodData = static_cast< uint8_t* >( pData ) + GetSubDataSize( 1 );
+                        m_lodIndexBufferLoadIds.Reserve( lodRangeCount );
+                        for( size_t lodRangeIndex = 0; lodRangeIndex < lodRangeCount; ++lodRangeIndex )
+                        {
+                            uint32_t subDataIndex = static_cast< uint32_t >( 2 + lodRangeIndex );
+                            size_t loadId = BeginLoadSubData( pLodData, subDataIndex );
+                            if( IsInvalid( loadId ) )
+                            {
+                                HELIUM_TRACE(
+                                    TraceLevels::Warning,
+                                    "Mesh::BeginPrecacheResourceData(): Failed to queue async load request for index buffer data for level of detail %" PRIuSZ " of mesh \"%s\".  Only the levels of detail loaded so far will be used.\n",
+                                    lodRangeIndex + 1,
+                                    *GetPath().ToString() );
+
+                                m_persistentResourceData.m_lodScreenSizes.Resize( lodRangeIndex );
+                                m_persistentResourceData.m_lodSectionTriangleCounts.Resize(
+                                    lodRangeIndex * m_persistentResourceData.m_sectionTriangleCounts.GetSize() );
+                                UpdateLodSectionIndexRanges();
+
+                                break;
+                            }
+
+                            m_lodIndexBufferLoadIds.Push( loadId );
+                            pLodData += GetSubDataSize( subDataIndex );
+                        }
+                    }
                 }
             }
         }
@@ -193,6 +254,17 @@ bool Mesh::TryFinishPrecacheResourceData()
         m_spVertexBuffer->Unmap();
     }
 
+    // Level of detail indices are loaded into the same mapped index buffer, so wait for them before unmapping it.
+    while( !m_lodIndexBufferLoadIds.IsEmpty() )
+    {
+        if( !TryFinishLoadSubData( m_lodIndexBufferLoadIds.GetLast() ) )
+        {
+            return false;
+        }
+
+        m_lodIndexBufferLoadIds.Pop();
+    }
+
     if( IsValid( m_indexBufferLoadId ) )
     {
         if( !TryFinishLoadSubData( m_indexBufferLoadId ) )
@@ -206,6 +278,13 @@ bool Mesh::TryFinishPrecacheResourceData()
         m_spIndexBuffer->Unmap();
     }
 
+    // Wait for the renderer to finish any uploads it deferred when the buffers were unmapped.
+    if( ( m_spVertexBuffer && m_spVertexBuffer->IsUploadPending() ) ||
+        ( m_spIndexBuffer && m_spIndexBuffer->IsUploadPending() ) )
+    {
+        return false;
+    }
+
     return true;
 }
 
@@ -227,6 +306,9 @@ void Mesh::PersistentResourceData::PopulateMetaType( Reflect::MetaStruct& comp )
     comp.AddField( &PersistentResourceData::m_vertexCount,              "m_vertexCount" );
     comp.AddField( &PersistentResourceData::m_triangleCount,            "m_triangleCount" );
     comp.AddField( &PersistentResourceData::m_bounds,                   "m_bounds" );
+    comp.AddField( &PersistentResourceData::m_sectionBounds,            "m_sectionBounds" );
+    comp.AddField( &PersistentResourceData::m_lodScreenSizes,           "m_lodScreenSizes" );
+    comp.AddField( &PersistentResourceData::m_lodSectionTriangleCounts, "m_lodSectionTriangleCounts" );
 #if !HELIUM_USE_GRANNY_ANIMATION
     comp.AddField( &PersistentResourceData::m_boneCount,                "m_boneCount" );
     comp.AddField( &PersistentResourceData::m_pBoneNames,               "m_pBoneNames" );
@@ -235,6 +317,25 @@ void Mesh::PersistentResourceData::PopulateMetaType( Reflect::MetaStruct& comp )
 #endif
 }
 
+void Mesh::PersistentResourceData::PopulateCookedLayout( CookedObjectLayout& rLayout )
+{
+    rLayout.AddArray( &PersistentResourceData::m_sectionVertexCounts );
+    rLayout.AddArray( &PersistentResourceData::m_sectionTriangleCounts );
+    rLayout.AddArray( &PersistentResourceData::m_skinningPaletteMap );
+    rLayout.AddPlainData( &PersistentResourceData::m_vertexCount );
+    rLayout.AddPlainData( &PersistentResourceData::m_triangleCount );
+    rLayout.AddPlainData( &PersistentResourceData::m_bounds );
+    rLayout.AddArray( &PersistentResourceData::m_sectionBounds );
+    rLayout.AddArray( &PersistentResourceData::m_lodScreenSizes );
+    rLayout.AddArray( &PersistentResourceData::m_lodSectionTriangleCounts );
+#if !HELIUM_USE_GRANNY_ANIMATION
+    rLayout.AddPlainData( &PersistentResourceData::m_boneCount );
+    rLayout.AddNameArray( &PersistentResourceData::m_pBoneNames );
+    rLayout.AddArray( &PersistentResourceData::m_pParentBoneIndices );
+    rLayout.AddArray( &PersistentResourceData::m_pReferencePose );
+#endif
+}
+
 bool Helium::Mesh::LoadPersistentResourceObject( Reflect::ObjectPtr &_object )
 {    
     m_spVertexBuffer.Release();
@@ -248,6 +349,20 @@ bool Helium::Mesh::LoadPersistentResourceObject( Reflect::ObjectPtr &_object )
 
     _object->CopyTo(&m_persistentResourceData);
 
+    size_t lodRangeCount = m_persistentResourceData.m_lodScreenSizes.GetSize();
+    size_t sectionCount = m_persistentResourceData.m_sectionTriangleCounts.GetSize();
+    if( m_persistentResourceData.m_lodSectionTriangleCounts.GetSize() != lodRangeCount * sectionCount )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Warning,
+            "Mesh::LoadPersistentResourceObject(): Level of detail data for mesh \"%s\" does not match its section count.  Only the full-detail mesh will be used.\n",
+            *GetPath().ToString() );
+
+        ClearLods();
+    }
+
+    UpdateLodSectionIndexRanges();
+
     return true;
 }
 
@@ -260,6 +375,53 @@ Name Mesh::GetCacheName() const
 }
 
 
+/// Update the index buffer ranges of each mesh section for the levels of detail past the first.
+///
+/// The index buffer holds the indices of the full-detail mesh followed by those of each level of detail in turn, with
+/// the sections of each level of detail stored in sequence.
+///
+/// @see GetSectionLodIndexRanges()
+void Mesh::UpdateLodSectionIndexRanges()
+{
+    const DynamicArray< uint32_t >& rLodTriangleCounts = m_persistentResourceData.m_lodSectionTriangleCounts;
+    size_t lodRangeCount = m_persistentResourceData.m_lodScreenSizes.GetSize();
+    size_t sectionCount = m_persistentResourceData.m_sectionTriangleCounts.GetSize();
+    HELIUM_ASSERT( rLodTriangleCounts.GetSize() == lodRangeCount * sectionCount );
+
+    m_lodSectionIndexRanges.Resize( 0 );
+    if( lodRangeCount == 0 )
+    {
+        return;
+    }
+
+    m_lodSectionIndexRanges.Resize( sectionCount * lodRangeCount * 2 );
+
+    uint32_t startIndex = m_persistentResourceData.m_triangleCount * 3;
+    for( size_t lodRangeIndex = 0; lodRangeIndex < lodRangeCount; ++lodRangeIndex )
+    {
+        for( size_t sectionIndex = 0; sectionIndex < sectionCount; ++sectionIndex )
+        {
+            uint32_t triangleCount = rLodTriangleCounts[ lodRangeIndex * sectionCount + sectionIndex ];
+
+            uint32_t* pRange = &m_lodSectionIndexRanges[ ( sectionIndex * lodRangeCount + lodRangeIndex ) * 2 ];
+            pRange[ 0 ] = startIndex;
+            pRange[ 1 ] = triangleCount;
+
+            startIndex += triangleCount * 3;
+        }
+    }
+}
+
+/// Drop all levels of detail past the first from this mesh.
+///
+/// @see UpdateLodSectionIndexRanges()
+void Mesh::ClearLods()
+{
+    m_persistentResourceData.m_lodScreenSizes.Resize( 0 );
+    m_persistentResourceData.m_lodSectionTriangleCounts.Resize( 0 );
+    m_lodSectionIndexRanges.Resize( 0 );
+}
+
 /// Get the GPU skinning palette map for a specific mesh section.
 ///
 /// The skinning palette map provides the indices within the bone palette passed to a shader for each bone defined
@@ -25,6 +25,8 @@ namespace Helium
     HELIUM_DECLARE_RPTR( RVertexBuffer );
     HELIUM_DECLARE_RPTR( RIndexBuffer );
 
+    class CookedObjectLayout;
+
     class Material;
     typedef Helium::StrongPtr< Material > MaterialPtr;
     typedef Helium::StrongPtr< const Material > ConstMaterialPtr;
@@ -43,6 +45,7 @@ namespace Helium
 
             PersistentResourceData();
             static void PopulateMetaType( Reflect::MetaStruct& comp );
+            static void PopulateCookedLayout( CookedObjectLayout& rLayout );
             
             /// Number of vertices used by each mesh section.
             DynamicArray< uint16_t > m_sectionVertexCounts;
@@ -58,6 +61,15 @@ namespace Helium
         
             /// Mesh bounds.
             Simd::AaBox m_bounds;
+            /// Bounds of each mesh section (empty if not cached with the mesh).
+            DynamicArray< Simd::AaBox > m_sectionBounds;
+
+            /// Projected size, in pixels, below which each level of detail past the first is used (empty if the mesh
+            /// has a single level of detail).
+            DynamicArray< float32_t > m_lodScreenSizes;
+            /// Number of triangles in each mesh section for each level of detail past the first (indexed by level of
+            /// detail minus one, then by section).
+            DynamicArray< uint32_t > m_lodSectionTriangleCounts;
         
 #if !HELIUM_USE_GRANNY_ANIMATION
             /// Bone count (if the mesh is a skinned mesh).  Note we place this variable separate from the other skinned
@@ -129,6 +141,11 @@ namespace Helium
         inline uint32_t GetTriangleCount() const;
 
         inline const Simd::AaBox& GetBounds() const;
+        inline const Simd::AaBox* GetSectionBounds( size_t sectionIndex ) const;
+
+        inline size_t GetLodCount() const;
+        inline const float32_t* GetLodScreenSizes() const;
+        inline const uint32_t* GetSectionLodIndexRanges( size_t sectionIndex ) const;
 
         inline RVertexBuffer* GetVertexBuffer() const;
         inline RIndexBuffer* GetIndexBuffer() const;
@@ -153,6 +170,18 @@ namespace Helium
         size_t m_vertexBufferLoadId;
         /// Asynchronous load ID for the index buffer data.
         size_t m_indexBufferLoadId;
+        /// Asynchronous load IDs for the index buffer data of each level of detail past the first.
+        DynamicArray< size_t > m_lodIndexBufferLoadIds;
+
+        /// Start index and triangle count of each mesh section for each level of detail past the first (indexed by
+        /// section, then by level of detail minus one).
+        DynamicArray< uint32_t > m_lodSectionIndexRanges;
+
+        /// @name Private Utility Functions
+        //@{
+        void UpdateLodSectionIndexRanges();
+        void ClearLods();
+        //@}
 
     };
 }
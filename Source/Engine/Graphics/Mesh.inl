@@ -171,6 +171,78 @@ namespace Helium
         return m_persistentResourceData.m_bounds;
     }
 
+    /// Get the bounds of a specific mesh section.
+    ///
+    /// Section bounds are computed when the mesh is cached, so they may be missing for mesh data cached by older
+    /// builds.
+    ///
+    /// @param[in] sectionIndex  Mesh section index.
+    ///
+    /// @return  Axis-aligned bounding box encompassing the vertices of the specified section, or null if no section
+    ///          bounds are available.
+    ///
+    /// @see GetBounds(), GetSectionCount()
+    const Simd::AaBox* Mesh::GetSectionBounds( size_t sectionIndex ) const
+    {
+        const DynamicArray< Simd::AaBox >& rSectionBounds = m_persistentResourceData.m_sectionBounds;
+        if( sectionIndex >= rSectionBounds.GetSize() )
+        {
+            return NULL;
+        }
+
+        return &rSectionBounds[ sectionIndex ];
+    }
+
+    /// Get the number of levels of detail in this mesh.
+    ///
+    /// Levels of detail past the first share the vertex buffer of the full-detail mesh, and only address fewer of its
+    /// vertices through their own range of the index buffer.
+    ///
+    /// @return  Number of levels of detail (at least one).
+    ///
+    /// @see GetLodScreenSizes(), GetSectionLodIndexRanges()
+    size_t Mesh::GetLodCount() const
+    {
+        return m_persistentResourceData.m_lodScreenSizes.GetSize() + 1;
+    }
+
+    /// Get the projected sizes below which the levels of detail of this mesh are used.
+    ///
+    /// @return  Projected size, in pixels, below which each level of detail past the first is used (GetLodCount()
+    ///          minus one entries, in decreasing order), or null if this mesh has a single level of detail.
+    ///
+    /// @see GetLodCount()
+    const float32_t* Mesh::GetLodScreenSizes() const
+    {
+        if( m_persistentResourceData.m_lodScreenSizes.IsEmpty() )
+        {
+            return NULL;
+        }
+
+        return m_persistentResourceData.m_lodScreenSizes.GetData();
+    }
+
+    /// Get the index buffer ranges of a specific mesh section for the levels of detail of this mesh.
+    ///
+    /// @param[in] sectionIndex  Mesh section index.
+    ///
+    /// @return  Start index and triangle count of the section for each level of detail past the first (GetLodCount()
+    ///          minus one pairs of values), or null if this mesh has a single level of detail.
+    ///
+    /// @see GetLodCount(), GetSectionTriangleCount()
+    const uint32_t* Mesh::GetSectionLodIndexRanges( size_t sectionIndex ) const
+    {
+        if( m_lodSectionIndexRanges.IsEmpty() )
+        {
+            return NULL;
+        }
+
+        size_t lodRangeCount = m_persistentResourceData.m_lodScreenSizes.GetSize();
+        HELIUM_ASSERT( ( sectionIndex + 1 ) * lodRangeCount * 2 <= m_lodSectionIndexRanges.GetSize() );
+
+        return m_lodSectionIndexRanges.GetData() + sectionIndex * lodRangeCount * 2;
+    }
+
     /// Get the vertex buffer for this mesh.
     ///
     /// @return  Vertex buffer.
@@ -0,0 +1,504 @@
+#include "Precompile.h"
+#include "Graphics/RenderGraph.h"
+
+#include "Rendering/RTexture2d.h"
+#include "Graphics/RenderResourceManager.h"
+
+using namespace Helium;
+
+/// Add an ID to an array of IDs if it is not already in the array.
+///
+/// @param[in] rIds  Array of IDs.
+/// @param[in] id    ID to add.
+static void AddUniqueId( DynamicArray< uint32_t >& rIds, uint32_t id )
+{
+	size_t idCount = rIds.GetSize();
+	for( size_t idIndex = 0; idIndex < idCount; ++idIndex )
+	{
+		if( rIds[ idIndex ] == id )
+		{
+			return;
+		}
+	}
+
+	rIds.Push( id );
+}
+
+/// Get whether an array of IDs contains a given ID.
+///
+/// @param[in] rIds  Array of IDs.
+/// @param[in] id    ID to find.
+///
+/// @return  True if the ID is in the array, false if not.
+static bool ContainsId( const DynamicArray< uint32_t >& rIds, uint32_t id )
+{
+	size_t idCount = rIds.GetSize();
+	for( size_t idIndex = 0; idIndex < idCount; ++idIndex )
+	{
+		if( rIds[ idIndex ] == id )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/// Constructor.
+RenderGraph::RenderGraph()
+	: m_passCount( 0 )
+{
+}
+
+/// Destructor.
+RenderGraph::~RenderGraph()
+{
+}
+
+/// Add a texture owned outside of the graph.
+///
+/// @param[in] pName     Texture name, for debugging (must remain valid until the graph is cleared).
+/// @param[in] pTexture  Texture resource (can be null if the texture is not available, in which case the passes
+///                      using it are expected to check for it).
+///
+/// @return  Texture ID.
+///
+/// @see CreateTexture()
+uint32_t RenderGraph::ImportTexture( const char* pName, RTexture2d* pTexture )
+{
+	Texture* pGraphTexture = m_textures.New();
+	HELIUM_ASSERT( pGraphTexture );
+	pGraphTexture->pName = pName;
+	pGraphTexture->spTexture = pTexture;
+	pGraphTexture->width = 0;
+	pGraphTexture->height = 0;
+	pGraphTexture->format = RENDERER_PIXEL_FORMAT_INVALID;
+	pGraphTexture->usage = RENDERER_BUFFER_USAGE_INVALID;
+	pGraphTexture->bImported = true;
+
+	return static_cast< uint32_t >( m_textures.GetSize() - 1 );
+}
+
+/// Add a transient texture, only available while the passes reading or writing it are executed.
+///
+/// The contents of transient textures are undefined until written by a pass.
+///
+/// @param[in] pName   Texture name, for debugging (must remain valid until the graph is cleared).
+/// @param[in] width   Texture width, in pixels.
+/// @param[in] height  Texture height, in pixels.
+/// @param[in] format  Texture pixel format.
+/// @param[in] usage   Texture usage (either RENDERER_BUFFER_USAGE_RENDER_TARGET or
+///                    RENDERER_BUFFER_USAGE_DEPTH_STENCIL).
+///
+/// @return  Texture ID.
+///
+/// @see ImportTexture()
+uint32_t RenderGraph::CreateTexture(
+	const char* pName,
+	uint32_t width,
+	uint32_t height,
+	ERendererPixelFormat format,
+	ERendererBufferUsage usage )
+{
+	HELIUM_ASSERT( width != 0 );
+	HELIUM_ASSERT( height != 0 );
+	HELIUM_ASSERT( usage == RENDERER_BUFFER_USAGE_RENDER_TARGET || usage == RENDERER_BUFFER_USAGE_DEPTH_STENCIL );
+
+	Texture* pGraphTexture = m_textures.New();
+	HELIUM_ASSERT( pGraphTexture );
+	pGraphTexture->pName = pName;
+	pGraphTexture->width = width;
+	pGraphTexture->height = height;
+	pGraphTexture->format = format;
+	pGraphTexture->usage = usage;
+	pGraphTexture->bImported = false;
+
+	return static_cast< uint32_t >( m_textures.GetSize() - 1 );
+}
+
+/// Add a pass to the graph.
+///
+/// @param[in] pName      Pass name, for debugging (must remain valid until the graph is cleared).
+/// @param[in] pFunction  Function to call to execute the pass.
+/// @param[in] pUserData  User data to pass to the function.
+///
+/// @return  Pass ID.
+///
+/// @see ReadTexture(), WriteTexture(), KeepPass()
+uint32_t RenderGraph::AddPass( const char* pName, ExecuteFunction* pFunction, void* pUserData )
+{
+	HELIUM_ASSERT( pFunction );
+
+	// Pass entries are reused across graph rebuilds so that their texture ID arrays keep their allocations.
+	if( m_passCount == m_passes.GetSize() )
+	{
+		HELIUM_VERIFY( m_passes.New() );
+	}
+
+	Pass& rPass = m_passes[ m_passCount ];
+	rPass.pName = pName;
+	rPass.pFunction = pFunction;
+	rPass.pUserData = pUserData;
+	rPass.reads.Resize( 0 );
+	rPass.writes.Resize( 0 );
+	rPass.bKeep = false;
+
+	return static_cast< uint32_t >( m_passCount++ );
+}
+
+/// Declare that a pass reads a texture.
+///
+/// @param[in] passId     Pass ID.
+/// @param[in] textureId  Texture ID.
+///
+/// @see WriteTexture()
+void RenderGraph::ReadTexture( uint32_t passId, uint32_t textureId )
+{
+	HELIUM_ASSERT( passId < m_passCount );
+	HELIUM_ASSERT( textureId < m_textures.GetSize() );
+
+	AddUniqueId( m_passes[ passId ].reads, textureId );
+}
+
+/// Declare that a pass writes a texture.
+///
+/// A pass that both reads and writes a texture updates it in place, and is ordered against other passes doing the
+/// same in the order in which the passes were added.
+///
+/// @param[in] passId     Pass ID.
+/// @param[in] textureId  Texture ID.
+///
+/// @see ReadTexture()
+void RenderGraph::WriteTexture( uint32_t passId, uint32_t textureId )
+{
+	HELIUM_ASSERT( passId < m_passCount );
+	HELIUM_ASSERT( textureId < m_textures.GetSize() );
+
+	AddUniqueId( m_passes[ passId ].writes, textureId );
+}
+
+/// Mark a pass as having effects outside of the graph (such as presenting to the screen), so that it and the passes
+/// it depends on are never culled.
+///
+/// @param[in] passId  Pass ID.
+void RenderGraph::KeepPass( uint32_t passId )
+{
+	HELIUM_ASSERT( passId < m_passCount );
+
+	m_passes[ passId ].bKeep = true;
+}
+
+/// Remove all passes and textures from the graph.
+void RenderGraph::Clear()
+{
+	m_textures.Resize( 0 );
+	m_passCount = 0;
+	m_executionOrder.Resize( 0 );
+}
+
+/// Cull unused passes, order the remaining passes, and execute them.
+///
+/// @param[in] pCommandProxy  Command proxy through which to issue the pass rendering commands.
+void RenderGraph::Execute( RRenderCommandProxy* pCommandProxy )
+{
+	HELIUM_ASSERT( pCommandProxy );
+
+	CullPasses();
+	if( !SortPasses() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"RenderGraph::Execute(): Pass dependencies contain a cycle; executing passes in the order they were added.\n" );
+
+		m_executionOrder.Resize( 0 );
+		for( size_t passIndex = 0; passIndex < m_passCount; ++passIndex )
+		{
+			const Pass& rPass = m_passes[ passIndex ];
+			if( rPass.bKeep || rPass.usedWriteCount != 0 )
+			{
+				m_executionOrder.Push( static_cast< uint32_t >( passIndex ) );
+			}
+		}
+	}
+
+	// Find the range of passes using each texture, so that transient textures are only held for as long as needed.
+	size_t textureCount = m_textures.GetSize();
+	for( size_t textureIndex = 0; textureIndex < textureCount; ++textureIndex )
+	{
+		Texture& rTexture = m_textures[ textureIndex ];
+		SetInvalid( rTexture.firstUse );
+		SetInvalid( rTexture.lastUse );
+	}
+
+	uint32_t executionCount = static_cast< uint32_t >( m_executionOrder.GetSize() );
+	for( uint32_t position = 0; position < executionCount; ++position )
+	{
+		const Pass& rPass = m_passes[ m_executionOrder[ position ] ];
+
+		const DynamicArray< uint32_t >* pTextureIdArrays[] = { &rPass.reads, &rPass.writes };
+		for( size_t arrayIndex = 0; arrayIndex < HELIUM_ARRAY_COUNT( pTextureIdArrays ); ++arrayIndex )
+		{
+			const DynamicArray< uint32_t >& rTextureIds = *pTextureIdArrays[ arrayIndex ];
+			size_t textureIdCount = rTextureIds.GetSize();
+			for( size_t textureIdIndex = 0; textureIdIndex < textureIdCount; ++textureIdIndex )
+			{
+				Texture& rTexture = m_textures[ rTextureIds[ textureIdIndex ] ];
+				if( IsInvalid( rTexture.firstUse ) )
+				{
+					rTexture.firstUse = position;
+				}
+
+				rTexture.lastUse = position;
+			}
+		}
+	}
+
+	RenderResourceManager* pRenderResourceManager = RenderResourceManager::GetInstance();
+	HELIUM_ASSERT( pRenderResourceManager );
+
+	for( uint32_t position = 0; position < executionCount; ++position )
+	{
+		const Pass& rPass = m_passes[ m_executionOrder[ position ] ];
+
+		// Acquire the transient textures first used by this pass.
+		for( size_t textureIndex = 0; textureIndex < textureCount; ++textureIndex )
+		{
+			Texture& rTexture = m_textures[ textureIndex ];
+			if( !rTexture.bImported && rTexture.firstUse == position )
+			{
+				rTexture.spTexture = pRenderResourceManager->AcquireRenderTarget(
+					rTexture.width,
+					rTexture.height,
+					rTexture.format,
+					rTexture.usage );
+				if( !rTexture.spTexture )
+				{
+					HELIUM_TRACE(
+						TraceLevels::Error,
+						"RenderGraph::Execute(): Failed to acquire transient texture \"%s\" for pass \"%s\".\n",
+						rTexture.pName,
+						rPass.pName );
+				}
+			}
+		}
+
+		rPass.pFunction( rPass.pUserData, *this, pCommandProxy );
+
+		// Hand back the transient textures last used by this pass so that later passes can reuse them.
+		for( size_t textureIndex = 0; textureIndex < textureCount; ++textureIndex )
+		{
+			Texture& rTexture = m_textures[ textureIndex ];
+			if( !rTexture.bImported && rTexture.lastUse == position && rTexture.spTexture )
+			{
+				pRenderResourceManager->ReleaseRenderTarget( rTexture.spTexture );
+				rTexture.spTexture.Release();
+			}
+		}
+	}
+}
+
+/// Determine which passes contribute to a kept pass, clearing the used write count of those that don't.
+void RenderGraph::CullPasses()
+{
+	size_t textureCount = m_textures.GetSize();
+	for( size_t textureIndex = 0; textureIndex < textureCount; ++textureIndex )
+	{
+		m_textures[ textureIndex ].readerCount = 0;
+	}
+
+	for( size_t passIndex = 0; passIndex < m_passCount; ++passIndex )
+	{
+		Pass& rPass = m_passes[ passIndex ];
+		rPass.usedWriteCount = static_cast< uint32_t >( rPass.writes.GetSize() );
+
+		size_t readCount = rPass.reads.GetSize();
+		for( size_t readIndex = 0; readIndex < readCount; ++readIndex )
+		{
+			++m_textures[ rPass.reads[ readIndex ] ].readerCount;
+		}
+	}
+
+	// A texture that is read and written by the same pass is only being updated in place by that pass; it still needs
+	// a reader other than the pass itself to be of any use.
+	for( size_t passIndex = 0; passIndex < m_passCount; ++passIndex )
+	{
+		const Pass& rPass = m_passes[ passIndex ];
+		size_t readCount = rPass.reads.GetSize();
+		for( size_t readIndex = 0; readIndex < readCount; ++readIndex )
+		{
+			uint32_t textureId = rPass.reads[ readIndex ];
+			if( ContainsId( rPass.writes, textureId ) )
+			{
+				--m_textures[ textureId ].readerCount;
+			}
+		}
+	}
+
+	// Passes that never wrote anything are culled outright unless kept, so their reads don't count.
+	for( size_t passIndex = 0; passIndex < m_passCount; ++passIndex )
+	{
+		Pass& rPass = m_passes[ passIndex ];
+		if( rPass.writes.IsEmpty() && !rPass.bKeep )
+		{
+			size_t readCount = rPass.reads.GetSize();
+			for( size_t readIndex = 0; readIndex < readCount; ++readIndex )
+			{
+				--m_textures[ rPass.reads[ readIndex ] ].readerCount;
+			}
+		}
+	}
+
+	m_unusedTextureIds.Resize( 0 );
+	for( size_t textureIndex = 0; textureIndex < textureCount; ++textureIndex )
+	{
+		if( m_textures[ textureIndex ].readerCount == 0 )
+		{
+			m_unusedTextureIds.Push( static_cast< uint32_t >( textureIndex ) );
+		}
+	}
+
+	// Walk back from the unused textures, culling the passes whose writes are all unused.
+	while( !m_unusedTextureIds.IsEmpty() )
+	{
+		uint32_t textureId = m_unusedTextureIds.GetLast();
+		m_unusedTextureIds.Pop();
+
+		for( size_t passIndex = 0; passIndex < m_passCount; ++passIndex )
+		{
+			Pass& rPass = m_passes[ passIndex ];
+			if( rPass.usedWriteCount == 0 || !ContainsId( rPass.writes, textureId ) )
+			{
+				continue;
+			}
+
+			--rPass.usedWriteCount;
+			if( rPass.usedWriteCount != 0 || rPass.bKeep )
+			{
+				continue;
+			}
+
+			size_t readCount = rPass.reads.GetSize();
+			for( size_t readIndex = 0; readIndex < readCount; ++readIndex )
+			{
+				uint32_t readTextureId = rPass.reads[ readIndex ];
+				if( ContainsId( rPass.writes, readTextureId ) )
+				{
+					continue;
+				}
+
+				Texture& rReadTexture = m_textures[ readTextureId ];
+				HELIUM_ASSERT( rReadTexture.readerCount != 0 );
+				if( --rReadTexture.readerCount == 0 )
+				{
+					m_unusedTextureIds.Push( readTextureId );
+				}
+			}
+		}
+	}
+
+}
+
+/// Order the passes that were not culled so that every pass runs after the passes it depends on, keeping the order
+/// in which passes were added where possible.
+///
+/// @return  True if the passes were ordered successfully, false if their dependencies contain a cycle.
+bool RenderGraph::SortPasses()
+{
+	m_executionOrder.Resize( 0 );
+
+	size_t livePassCount = 0;
+	for( size_t passIndex = 0; passIndex < m_passCount; ++passIndex )
+	{
+		Pass& rPass = m_passes[ passIndex ];
+		if( !rPass.bKeep && rPass.usedWriteCount == 0 )
+		{
+			continue;
+		}
+
+		++livePassCount;
+
+		rPass.dependencyCount = 0;
+		for( size_t otherPassIndex = 0; otherPassIndex < m_passCount; ++otherPassIndex )
+		{
+			const Pass& rOtherPass = m_passes[ otherPassIndex ];
+			if( otherPassIndex != passIndex && ( rOtherPass.bKeep || rOtherPass.usedWriteCount != 0 ) &&
+				DependsOn( rPass, rOtherPass ) )
+			{
+				++rPass.dependencyCount;
+			}
+		}
+	}
+
+	while( m_executionOrder.GetSize() < livePassCount )
+	{
+		// Take the first ready pass in the order they were added.
+		size_t readyPassIndex = m_passCount;
+		for( size_t passIndex = 0; passIndex < m_passCount; ++passIndex )
+		{
+			const Pass& rPass = m_passes[ passIndex ];
+			if( ( rPass.bKeep || rPass.usedWriteCount != 0 ) && rPass.dependencyCount == 0 &&
+				!ContainsId( m_executionOrder, static_cast< uint32_t >( passIndex ) ) )
+			{
+				readyPassIndex = passIndex;
+
+				break;
+			}
+		}
+
+		if( readyPassIndex == m_passCount )
+		{
+			return false;
+		}
+
+		m_executionOrder.Push( static_cast< uint32_t >( readyPassIndex ) );
+
+		const Pass& rReadyPass = m_passes[ readyPassIndex ];
+		for( size_t passIndex = 0; passIndex < m_passCount; ++passIndex )
+		{
+			Pass& rPass = m_passes[ passIndex ];
+			if( passIndex != readyPassIndex && ( rPass.bKeep || rPass.usedWriteCount != 0 ) &&
+				DependsOn( rPass, rReadyPass ) )
+			{
+				HELIUM_ASSERT( rPass.dependencyCount != 0 );
+				--rPass.dependencyCount;
+			}
+		}
+	}
+
+	return true;
+}
+
+/// Get whether a pass needs to run after another pass.
+///
+/// A pass depends on the passes writing the textures it reads.  Passes updating the same texture in place, or both
+/// writing it without reading it, run in the order they were added.
+///
+/// @param[in] rPass       Pass to check.
+/// @param[in] rOtherPass  Other pass.
+///
+/// @return  True if the pass must run after the other pass, false if not.
+bool RenderGraph::DependsOn( const Pass& rPass, const Pass& rOtherPass ) const
+{
+	bool bOtherPassFirst = ( &rOtherPass < &rPass );
+
+	size_t writeCount = rOtherPass.writes.GetSize();
+	for( size_t writeIndex = 0; writeIndex < writeCount; ++writeIndex )
+	{
+		uint32_t textureId = rOtherPass.writes[ writeIndex ];
+		bool bOtherPassReads = ContainsId( rOtherPass.reads, textureId );
+
+		if( ContainsId( rPass.reads, textureId ) )
+		{
+			if( !bOtherPassReads || bOtherPassFirst )
+			{
+				return true;
+			}
+		}
+		else if( bOtherPassFirst && !bOtherPassReads && ContainsId( rPass.writes, textureId ) )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
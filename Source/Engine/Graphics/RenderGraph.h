@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Rendering/RendererTypes.h"
+#include "Rendering/RRenderResource.h"
+
+namespace Helium
+{
+	class RRenderCommandProxy;
+
+	HELIUM_DECLARE_RPTR( RTexture2d );
+
+	/// Description of the passes needed to render a frame and the textures they read and write.
+	///
+	/// Passes are added along with the textures they read and write, then Execute() orders them so that each texture
+	/// is written before it is read, culls passes whose results are never used, and runs the remaining passes.
+	/// Textures are either imported (persistent render targets owned elsewhere, such as the scene texture) or
+	/// transient.  Transient textures are acquired from the RenderResourceManager render target pool right before the
+	/// first pass using them runs, and handed back right after the last one, so that passes later in the frame can
+	/// reuse the same memory for their own transient textures.
+	///
+	/// A graph is meant to be rebuilt each time it is rendered, and must only be executed on the thread that renders
+	/// scene views.
+	class HELIUM_GRAPHICS_API RenderGraph : NonCopyable
+	{
+	public:
+		/// Pass execution callback.
+		///
+		/// @param[in] pUserData      User data registered with the pass.
+		/// @param[in] rGraph         Graph being executed, from which the textures of the pass can be retrieved.
+		/// @param[in] pCommandProxy  Command proxy through which to issue the pass rendering commands.
+		typedef void ( ExecuteFunction )( void* pUserData, const RenderGraph& rGraph, RRenderCommandProxy* pCommandProxy );
+
+		/// @name Construction/Destruction
+		//@{
+		RenderGraph();
+		~RenderGraph();
+		//@}
+
+		/// @name Graph Construction
+		//@{
+		uint32_t ImportTexture( const char* pName, RTexture2d* pTexture );
+		uint32_t CreateTexture(
+			const char* pName, uint32_t width, uint32_t height, ERendererPixelFormat format, ERendererBufferUsage usage );
+
+		uint32_t AddPass( const char* pName, ExecuteFunction* pFunction, void* pUserData );
+		void ReadTexture( uint32_t passId, uint32_t textureId );
+		void WriteTexture( uint32_t passId, uint32_t textureId );
+		void KeepPass( uint32_t passId );
+
+		void Clear();
+		//@}
+
+		/// @name Execution
+		//@{
+		void Execute( RRenderCommandProxy* pCommandProxy );
+
+		inline RTexture2d* GetTexture( uint32_t textureId ) const;
+		inline size_t GetExecutedPassCount() const;
+		//@}
+
+	private:
+		/// Texture read or written by the graph passes.
+		struct Texture
+		{
+			/// Texture name, for debugging.
+			const char* pName;
+			/// Texture resource (set for imported textures, and for transient textures while they are acquired).
+			RTexture2dPtr spTexture;
+			/// Transient texture width, in pixels.
+			uint32_t width;
+			/// Transient texture height, in pixels.
+			uint32_t height;
+			/// Transient texture pixel format.
+			ERendererPixelFormat format;
+			/// Transient texture usage.
+			ERendererBufferUsage usage;
+			/// True if the texture is owned outside of the graph.
+			bool bImported;
+
+			/// Number of passes that read the texture and have not been culled.
+			uint32_t readerCount;
+			/// Position in the execution order of the first pass using the texture.
+			uint32_t firstUse;
+			/// Position in the execution order of the last pass using the texture.
+			uint32_t lastUse;
+		};
+
+		/// Graph pass.
+		struct Pass
+		{
+			/// Pass name, for debugging.
+			const char* pName;
+			/// Execution callback.
+			ExecuteFunction* pFunction;
+			/// User data passed to the callback.
+			void* pUserData;
+			/// IDs of the textures read by the pass.
+			DynamicArray< uint32_t > reads;
+			/// IDs of the textures written by the pass.
+			DynamicArray< uint32_t > writes;
+			/// True if the pass has effects outside of the graph and should never be culled.
+			bool bKeep;
+
+			/// Number of written textures that are still read by a pass that has not been culled.
+			uint32_t usedWriteCount;
+			/// Number of passes that must run before this one and have not been ordered yet.
+			uint32_t dependencyCount;
+		};
+
+		/// Graph textures.
+		DynamicArray< Texture > m_textures;
+		/// Graph passes.
+		DynamicArray< Pass > m_passes;
+		/// Number of passes currently in use (passes beyond this count are kept only to reuse their arrays).
+		size_t m_passCount;
+
+		/// IDs of the passes to run, in execution order.
+		DynamicArray< uint32_t > m_executionOrder;
+		/// Scratch stack of textures with no remaining readers, for culling.
+		DynamicArray< uint32_t > m_unusedTextureIds;
+
+		/// @name Private Utility Functions
+		//@{
+		void CullPasses();
+		bool SortPasses();
+		bool DependsOn( const Pass& rPass, const Pass& rOtherPass ) const;
+		//@}
+	};
+}
+
+#include "Graphics/RenderGraph.inl"
@@ -0,0 +1,24 @@
+namespace Helium
+{
+	/// Get the texture resource of a graph texture.
+	///
+	/// Transient textures only have a resource while the passes using them are being executed.
+	///
+	/// @param[in] textureId  Texture ID, as returned by ImportTexture() or CreateTexture().
+	///
+	/// @return  Texture resource, or null if the texture is not currently available.
+	RTexture2d* RenderGraph::GetTexture( uint32_t textureId ) const
+	{
+		HELIUM_ASSERT( textureId < m_textures.GetSize() );
+
+		return m_textures[ textureId ].spTexture;
+	}
+
+	/// Get the number of passes that were run by the last call to Execute().
+	///
+	/// @return  Number of passes executed (passes culled from the graph are not included).
+	size_t RenderGraph::GetExecutedPassCount() const
+	{
+		return m_executionOrder.GetSize();
+	}
+}
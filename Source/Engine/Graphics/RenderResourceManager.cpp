@@ -9,6 +9,7 @@
 #include "Rendering/Renderer.h"
 #include "Rendering/RSamplerState.h"
 #include "Rendering/RSurface.h"
+#include "Rendering/RTexture2d.h"
 #include "Rendering/RVertexDescription.h"
 #include "Graphics/Font.h"
 #include "Graphics/GraphicsConfig.h"
@@ -16,6 +17,16 @@
 
 using namespace Helium;
 
+/// Smallest resolution scale that can be configured.
+static const float32_t RESOLUTION_SCALE_LIMIT = 0.25f;
+/// Relative deviation of the GPU frame time from its target below which the resolution scale is left alone.
+static const float32_t RESOLUTION_SCALE_TOLERANCE = 0.05f;
+/// Fraction of the distance to the ideal resolution scale covered in each update.
+static const float32_t RESOLUTION_SCALE_RATE = 0.1f;
+
+/// Number of frames a pooled render target can go unused before it is released.
+static const uint32_t RENDER_TARGET_POOL_IDLE_FRAME_COUNT = 30;
+
 static uint32_t g_InitCount = 0;
 RenderResourceManager* RenderResourceManager::sm_pInstance = NULL;
 
@@ -25,6 +36,10 @@ RenderResourceManager::RenderResourceManager()
 	, m_viewportWidthMax( 0 )
 	, m_viewportHeightMax( 0 )
 	, m_shadowDepthTextureUsableSize( 0 )
+	, m_resolutionScale( 1.0f )
+	, m_resolutionTargetMilliseconds( 0.0f )
+	, m_resolutionScaleMin( 1.0f )
+	, m_renderTargetFrameIndex( 0 )
 {
 }
 
@@ -189,13 +204,33 @@ bool RenderResourceManager::Initialize()
 	vertexElements[3].semanticIndex = 1;
 	vertexElements[3].bufferIndex = 0;
 
-	m_spSimpleVertexDescription = pRenderer->CreateVertexDescription( vertexElements, 2 );
+	m_spSimpleVertexDescription = pRenderer->GetVertexDescription( vertexElements, 2 );
 	HELIUM_ASSERT( m_spSimpleVertexDescription );
 
-	m_spSimpleTexturedVertexDescription = pRenderer->CreateVertexDescription( vertexElements, 3 );
+	m_spSimpleTexturedVertexDescription = pRenderer->GetVertexDescription( vertexElements, 3 );
 	HELIUM_ASSERT( m_spSimpleTexturedVertexDescription );
 
-	m_spProjectedVertexDescription = pRenderer->CreateVertexDescription( vertexElements, 4 );
+	// Instanced simple vertices read the rows of each instance's transposed world transform from vertex stream 1, using
+	// the same texture coordinate sets as instanced static meshes.
+	RVertexDescription::Element instancedSimpleVertexElements[2 + 3];
+	instancedSimpleVertexElements[0] = vertexElements[0];
+	instancedSimpleVertexElements[1] = vertexElements[1];
+
+	for ( size_t rowIndex = 0; rowIndex < 3; ++rowIndex )
+	{
+		RVertexDescription::Element& rElement = instancedSimpleVertexElements[2 + rowIndex];
+		rElement.type = RENDERER_VERTEX_DATA_TYPE_FLOAT32_4;
+		rElement.semantic = RENDERER_VERTEX_SEMANTIC_TEXCOORD;
+		rElement.semanticIndex = static_cast<uint8_t>( 4 + rowIndex );
+		rElement.bufferIndex = 1;
+	}
+
+	m_spInstancedSimpleVertexDescription = pRenderer->GetVertexDescription(
+		instancedSimpleVertexElements,
+		HELIUM_ARRAY_COUNT( instancedSimpleVertexElements ) );
+	HELIUM_ASSERT( m_spInstancedSimpleVertexDescription );
+
+	m_spProjectedVertexDescription = pRenderer->GetVertexDescription( vertexElements, 4 );
 	HELIUM_ASSERT( m_spProjectedVertexDescription );
 
 	vertexElements[1].type = RENDERER_VERTEX_DATA_TYPE_UINT8_4_NORM;
@@ -223,12 +258,41 @@ bool RenderResourceManager::Initialize()
 	vertexElements[5].semanticIndex = 1;
 	vertexElements[5].bufferIndex = 0;
 
-	m_staticMeshVertexDescriptions[0] = pRenderer->CreateVertexDescription( vertexElements, 5 );
+	m_staticMeshVertexDescriptions[0] = pRenderer->GetVertexDescription( vertexElements, 5 );
 	HELIUM_ASSERT( m_staticMeshVertexDescriptions[0] );
 
-	m_staticMeshVertexDescriptions[1] = pRenderer->CreateVertexDescription( vertexElements, 6 );
+	m_staticMeshVertexDescriptions[1] = pRenderer->GetVertexDescription( vertexElements, 6 );
 	HELIUM_ASSERT( m_staticMeshVertexDescriptions[1] );
 
+	// Instanced static meshes read the rows of each instance's transposed world transform from vertex stream 1 (using
+	// texture coordinate sets 4 through 6, which are left unused by mesh vertex data).
+	RVertexDescription::Element instancedVertexElements[6 + 3];
+
+	for ( size_t descriptionIndex = 0;
+		descriptionIndex < HELIUM_ARRAY_COUNT( m_instancedStaticMeshVertexDescriptions );
+		++descriptionIndex )
+	{
+		size_t meshElementCount = 5 + descriptionIndex;
+		for ( size_t elementIndex = 0; elementIndex < meshElementCount; ++elementIndex )
+		{
+			instancedVertexElements[elementIndex] = vertexElements[elementIndex];
+		}
+
+		for ( size_t rowIndex = 0; rowIndex < 3; ++rowIndex )
+		{
+			RVertexDescription::Element& rElement = instancedVertexElements[meshElementCount + rowIndex];
+			rElement.type = RENDERER_VERTEX_DATA_TYPE_FLOAT32_4;
+			rElement.semantic = RENDERER_VERTEX_SEMANTIC_TEXCOORD;
+			rElement.semanticIndex = static_cast<uint8_t>( 4 + rowIndex );
+			rElement.bufferIndex = 1;
+		}
+
+		m_instancedStaticMeshVertexDescriptions[descriptionIndex] = pRenderer->GetVertexDescription(
+			instancedVertexElements,
+			meshElementCount + 3 );
+		HELIUM_ASSERT( m_instancedStaticMeshVertexDescriptions[descriptionIndex] );
+	}
+
 	vertexElements[1].type = RENDERER_VERTEX_DATA_TYPE_UINT8_4_NORM;
 	vertexElements[1].semantic = RENDERER_VERTEX_SEMANTIC_BLENDWEIGHT;
 	vertexElements[1].semanticIndex = 0;
@@ -254,7 +318,7 @@ bool RenderResourceManager::Initialize()
 	vertexElements[5].semanticIndex = 0;
 	vertexElements[5].bufferIndex = 0;
 
-	m_spSkinnedMeshVertexDescription = pRenderer->CreateVertexDescription( vertexElements, 6 );
+	m_spSkinnedMeshVertexDescription = pRenderer->GetVertexDescription( vertexElements, 6 );
 	HELIUM_ASSERT( m_spSkinnedMeshVertexDescription );
 
 	vertexElements[0].type = RENDERER_VERTEX_DATA_TYPE_FLOAT32_2;
@@ -272,7 +336,7 @@ bool RenderResourceManager::Initialize()
 	vertexElements[2].semanticIndex = 0;
 	vertexElements[2].bufferIndex = 0;
 
-	m_spScreenVertexDescription = pRenderer->CreateVertexDescription( vertexElements, 3 );
+	m_spScreenVertexDescription = pRenderer->GetVertexDescription( vertexElements, 3 );
 	HELIUM_ASSERT( m_spScreenVertexDescription );
 
 	// Create configuration-dependent render resources.
@@ -432,6 +496,8 @@ void RenderResourceManager::Cleanup()
 	m_spSimpleScreenSpaceVertexShader.Release();
 	m_spPrePassVertexShader.Release();
 
+	ClearRenderTargetPool();
+
 	m_spDepthStencilSurface.Release();
 
 	m_spShadowDepthTexture.Release();
@@ -464,6 +530,7 @@ void RenderResourceManager::Cleanup()
 	}
 
 	m_spSimpleTexturedVertexDescription.Release();
+	m_spInstancedSimpleVertexDescription.Release();
 	m_spSimpleVertexDescription.Release();
 	m_spScreenVertexDescription.Release();
 	m_spProjectedVertexDescription.Release();
@@ -473,6 +540,7 @@ void RenderResourceManager::Cleanup()
 		++descriptionIndex )
 	{
 		m_staticMeshVertexDescriptions[descriptionIndex].Release();
+		m_instancedStaticMeshVertexDescriptions[descriptionIndex].Release();
 	}
 
 	m_spSkinnedMeshVertexDescription.Release();
@@ -495,6 +563,8 @@ void RenderResourceManager::PostConfigUpdate()
 		pLinearSamplerStates[addressModeIndex].Release();
 	}
 
+	ClearRenderTargetPool();
+
 	m_spDepthStencilSurface.Release();
 
 	m_spShadowDepthTexture.Release();
@@ -506,6 +576,10 @@ void RenderResourceManager::PostConfigUpdate()
 	m_shadowMode = GraphicsConfig::EShadowMode::NONE;
 	m_shadowDepthTextureUsableSize = 0;
 
+	m_resolutionScale = 1.0f;
+	m_resolutionTargetMilliseconds = 0.0f;
+	m_resolutionScaleMin = 1.0f;
+
 	// Get the renderer and graphics configuration.
 	Renderer* pRenderer = Renderer::GetInstance();
 	if ( !pRenderer )
@@ -583,6 +657,10 @@ void RenderResourceManager::PostConfigUpdate()
 	m_shadowMode = shadowMode;
 	m_shadowDepthTextureUsableSize = shadowBufferUsableSize;
 
+	// Store dynamic resolution settings.
+	m_resolutionTargetMilliseconds = Max( spGraphicsConfig->GetDynamicResolutionTargetMilliseconds(), 0.0f );
+	m_resolutionScaleMin = Clamp( spGraphicsConfig->GetDynamicResolutionMinScale(), RESOLUTION_SCALE_LIMIT, 1.0f );
+
 	// Recreate render and depth targets.
 	UpdateMaxViewportSize( spGraphicsConfig->m_width, spGraphicsConfig->m_height );
 
@@ -592,6 +670,10 @@ void RenderResourceManager::PostConfigUpdate()
 
 /// Reconstruct render resources based on the maximum render viewport size.
 ///
+/// Scene views only render to a sub-rectangle of the render targets, so the existing targets are kept if they are
+/// already large enough for the new size.  When they do need to grow, they are rounded up to a multiple of
+/// VIEWPORT_SIZE_BUCKET, so that resizing a window a few pixels at a time only reallocates them every so often.
+///
 /// @param[in] width   Maximum viewport width, in pixels.
 /// @param[in] height  Maximum viewport height, in pixels.
 void RenderResourceManager::UpdateMaxViewportSize( uint32_t width, uint32_t height )
@@ -601,6 +683,15 @@ void RenderResourceManager::UpdateMaxViewportSize( uint32_t width, uint32_t heig
 		return;
 	}
 
+	if ( m_spSceneTexture && width != 0 && height != 0 &&
+		width <= m_spSceneTexture->GetWidth() && height <= m_spSceneTexture->GetHeight() )
+	{
+		m_viewportWidthMax = width;
+		m_viewportHeightMax = height;
+
+		return;
+	}
+
 	m_spDepthStencilSurface.Release();
 	m_spShadowDepthTexture.Release();
 	m_spSceneTexture.Release();
@@ -628,8 +719,13 @@ void RenderResourceManager::UpdateMaxViewportSize( uint32_t width, uint32_t heig
 	// Due to restrictions with render target settings on certain platforms (namely when using Direct3D), the scene
 	// texture, depth-stencil surface, and shadow depth texture must all be the same size.
 	// XXX WDI: Implement support for the NULL FOURCC format for Direct3D to avoid this restriction when possible.
-	uint32_t bufferWidth = Max( width, m_shadowDepthTextureUsableSize );
-	uint32_t bufferHeight = Max( height, m_shadowDepthTextureUsableSize );
+	uint32_t bucketWidth = ( width + VIEWPORT_SIZE_BUCKET - 1 ) / VIEWPORT_SIZE_BUCKET * VIEWPORT_SIZE_BUCKET;
+	uint32_t bucketHeight = ( height + VIEWPORT_SIZE_BUCKET - 1 ) / VIEWPORT_SIZE_BUCKET * VIEWPORT_SIZE_BUCKET;
+	uint32_t bufferWidth = Max( bucketWidth, m_shadowDepthTextureUsableSize );
+	uint32_t bufferHeight = Max( bucketHeight, m_shadowDepthTextureUsableSize );
+
+	m_viewportWidthMax = width;
+	m_viewportHeightMax = height;
 
 	m_spSceneTexture = pRenderer->CreateTexture2d(
 		bufferWidth,
@@ -680,6 +776,211 @@ void RenderResourceManager::UpdateMaxViewportSize( uint32_t width, uint32_t heig
 	}
 }
 
+/// Adjust the resolution at which scene views are rendered based on the measured GPU frame time.
+///
+/// GPU time is assumed to scale with the number of pixels rendered, so the scale is moved towards the value that
+/// would bring the frame time to the configured target.  As GPU timings arrive several frames late, the scale only
+/// moves part of the way each frame, and small deviations from the target are ignored, so that it does not oscillate.
+/// This must be called on the thread that renders scene views, once per frame.
+///
+/// @param[in] gpuFrameMilliseconds  GPU time of a recent frame, in milliseconds, or zero if no measurement is
+///                                  available.
+///
+/// @see GetResolutionScale(), GetScaledViewportSize()
+void RenderResourceManager::UpdateResolutionScale( float32_t gpuFrameMilliseconds )
+{
+	if ( m_resolutionTargetMilliseconds <= 0.0f )
+	{
+		m_resolutionScale = 1.0f;
+
+		return;
+	}
+
+	if ( gpuFrameMilliseconds <= 0.0f )
+	{
+		return;
+	}
+
+	float32_t frameTimeRatio = m_resolutionTargetMilliseconds / gpuFrameMilliseconds;
+	if ( Abs( frameTimeRatio - 1.0f ) < RESOLUTION_SCALE_TOLERANCE )
+	{
+		return;
+	}
+
+	float32_t idealScale = m_resolutionScale * sqrtf( frameTimeRatio );
+	m_resolutionScale += ( idealScale - m_resolutionScale ) * RESOLUTION_SCALE_RATE;
+	m_resolutionScale = Clamp( m_resolutionScale, m_resolutionScaleMin, 1.0f );
+}
+
+/// Compute the size of the region of the scene render targets into which a scene view is rendered.
+///
+/// @param[in]  viewportWidth   Width of the view's viewport on screen, in pixels.
+/// @param[in]  viewportHeight  Height of the view's viewport on screen, in pixels.
+/// @param[out] rScaledWidth    Width at which to render the scene, in pixels.
+/// @param[out] rScaledHeight   Height at which to render the scene, in pixels.
+///
+/// @see GetResolutionScale()
+void RenderResourceManager::GetScaledViewportSize(
+	uint32_t viewportWidth,
+	uint32_t viewportHeight,
+	uint32_t& rScaledWidth,
+	uint32_t& rScaledHeight ) const
+{
+	uint32_t scaledWidth = static_cast< uint32_t >( static_cast< float32_t >( viewportWidth ) * m_resolutionScale + 0.5f );
+	uint32_t scaledHeight = static_cast< uint32_t >( static_cast< float32_t >( viewportHeight ) * m_resolutionScale + 0.5f );
+
+	if ( m_spSceneTexture )
+	{
+		scaledWidth = Min( scaledWidth, m_spSceneTexture->GetWidth() );
+		scaledHeight = Min( scaledHeight, m_spSceneTexture->GetHeight() );
+	}
+
+	rScaledWidth = Max< uint32_t >( scaledWidth, 1 );
+	rScaledHeight = Max< uint32_t >( scaledHeight, 1 );
+}
+
+/// Acquire a transient render target from the render target pool.
+///
+/// A pooled texture with the same size, format, and usage that is not currently acquired is reused if one exists,
+/// otherwise a new one is created and added to the pool.  The texture must be handed back using
+/// ReleaseRenderTarget() once the pass writing and reading it has been drawn, so that later passes and views in the
+/// same frame can reuse it; any texture still acquired when EndRenderTargetFrame() is called is returned to the pool
+/// automatically.  The contents of an acquired texture are undefined.  This must only be called on the thread that
+/// renders scene views.
+///
+/// @param[in] width   Texture width, in pixels.
+/// @param[in] height  Texture height, in pixels.
+/// @param[in] format  Texture pixel format.
+/// @param[in] usage   Texture usage (either RENDERER_BUFFER_USAGE_RENDER_TARGET or
+///                    RENDERER_BUFFER_USAGE_DEPTH_STENCIL).
+///
+/// @return  Render target texture, or null if no renderer is initialized or the texture could not be created.
+///
+/// @see ReleaseRenderTarget(), EndRenderTargetFrame()
+RTexture2d* RenderResourceManager::AcquireRenderTarget(
+	uint32_t width,
+	uint32_t height,
+	ERendererPixelFormat format,
+	ERendererBufferUsage usage )
+{
+	HELIUM_ASSERT( width != 0 );
+	HELIUM_ASSERT( height != 0 );
+	HELIUM_ASSERT( static_cast< size_t >( format ) < static_cast< size_t >( RENDERER_PIXEL_FORMAT_MAX ) );
+	HELIUM_ASSERT( usage == RENDERER_BUFFER_USAGE_RENDER_TARGET || usage == RENDERER_BUFFER_USAGE_DEPTH_STENCIL );
+
+	size_t poolSize = m_renderTargetPool.GetSize();
+	for ( size_t targetIndex = 0; targetIndex < poolSize; ++targetIndex )
+	{
+		PooledRenderTarget& rTarget = m_renderTargetPool[ targetIndex ];
+		if ( !rTarget.bInUse && rTarget.width == width && rTarget.height == height && rTarget.format == format &&
+			rTarget.usage == usage )
+		{
+			rTarget.lastUsedFrame = m_renderTargetFrameIndex;
+			rTarget.bInUse = true;
+
+			return rTarget.spTexture;
+		}
+	}
+
+	Renderer* pRenderer = Renderer::GetInstance();
+	if ( !pRenderer )
+	{
+		return NULL;
+	}
+
+	RTexture2dPtr spTexture = pRenderer->CreateTexture2d( width, height, 1, format, usage );
+	if ( !spTexture )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"RenderResourceManager::AcquireRenderTarget(): Failed to create pooled render target of size %" PRIu32
+			"x%" PRIu32 ".\n",
+			width,
+			height );
+
+		return NULL;
+	}
+
+	PooledRenderTarget* pTarget = m_renderTargetPool.New();
+	HELIUM_ASSERT( pTarget );
+	pTarget->spTexture = spTexture;
+	pTarget->width = width;
+	pTarget->height = height;
+	pTarget->format = format;
+	pTarget->usage = usage;
+	pTarget->lastUsedFrame = m_renderTargetFrameIndex;
+	pTarget->bInUse = true;
+
+	return spTexture;
+}
+
+/// Return a render target acquired using AcquireRenderTarget() to the render target pool.
+///
+/// @param[in] pTexture  Render target texture to release (can be null).
+///
+/// @see AcquireRenderTarget(), EndRenderTargetFrame()
+void RenderResourceManager::ReleaseRenderTarget( RTexture2d* pTexture )
+{
+	if ( !pTexture )
+	{
+		return;
+	}
+
+	size_t poolSize = m_renderTargetPool.GetSize();
+	for ( size_t targetIndex = 0; targetIndex < poolSize; ++targetIndex )
+	{
+		PooledRenderTarget& rTarget = m_renderTargetPool[ targetIndex ];
+		if ( rTarget.spTexture == pTexture )
+		{
+			HELIUM_ASSERT( rTarget.bInUse );
+			rTarget.bInUse = false;
+
+			return;
+		}
+	}
+
+	HELIUM_ASSERT_MSG( false, "Texture released to the render target pool was not acquired from it" );
+}
+
+/// Finish the current frame of render target pool usage.
+///
+/// Render targets still acquired are returned to the pool, and render targets that have not been acquired for
+/// several frames are released so that the pool shrinks back when targets of a given size or format are no longer
+/// needed (i.e. after a view is resized or a pass is disabled).  This must be called on the thread that renders scene
+/// views, once per frame after all views have been drawn.
+///
+/// @see AcquireRenderTarget(), ReleaseRenderTarget()
+void RenderResourceManager::EndRenderTargetFrame()
+{
+	size_t targetIndex = 0;
+	while ( targetIndex < m_renderTargetPool.GetSize() )
+	{
+		PooledRenderTarget& rTarget = m_renderTargetPool[ targetIndex ];
+		rTarget.bInUse = false;
+
+		if ( m_renderTargetFrameIndex - rTarget.lastUsedFrame >= RENDER_TARGET_POOL_IDLE_FRAME_COUNT )
+		{
+			m_renderTargetPool.RemoveSwap( targetIndex );
+		}
+		else
+		{
+			++targetIndex;
+		}
+	}
+
+	++m_renderTargetFrameIndex;
+}
+
+/// Release all render targets held by the render target pool.
+///
+/// No pooled render target may be in use when this is called.
+///
+/// @see AcquireRenderTarget(), EndRenderTargetFrame()
+void RenderResourceManager::ClearRenderTargetPool()
+{
+	m_renderTargetPool.Clear();
+}
+
 /// Get the rasterizer state instance for the specified state type.
 ///
 /// @param[in] type  Rasterizer state type.
@@ -743,6 +1044,19 @@ RVertexDescription* RenderResourceManager::GetSimpleVertexDescription() const
 	return m_spSimpleVertexDescription;
 }
 
+/// Get the description for instanced SimpleVertex vertices.
+///
+/// The instanced description reads SimpleVertex data from vertex stream 0, along with the three rows of each
+/// instance's transposed world transform from vertex stream 1.
+///
+/// @return  Instanced SimpleVertex vertex description.
+///
+/// @see GetSimpleVertexDescription(), GetInstancedStaticMeshVertexDescription()
+RVertexDescription* RenderResourceManager::GetInstancedSimpleVertexDescription() const
+{
+	return m_spInstancedSimpleVertexDescription;
+}
+
 /// Get the description for SimpleTexturedVertex vertices.
 ///
 /// @return  SimpleTexturedVertex vertex description.
@@ -793,6 +1107,33 @@ RVertexDescription* RenderResourceManager::GetStaticMeshVertexDescription( size_
 	return m_staticMeshVertexDescriptions[textureCoordinateSetCount - 1];
 }
 
+/// Get the instanced counterpart of a static mesh vertex description.
+///
+/// The instanced description reads the same vertex data from vertex stream 0, along with the three rows of each
+/// instance's transposed world transform from vertex stream 1.
+///
+/// @param[in] pDescription  Static mesh vertex description.
+///
+/// @return  Instanced static mesh vertex description, or null if the given description is not a static mesh vertex
+///          description.
+///
+/// @see GetStaticMeshVertexDescription()
+RVertexDescription* RenderResourceManager::GetInstancedStaticMeshVertexDescription(
+	RVertexDescription* pDescription ) const
+{
+	for ( size_t descriptionIndex = 0;
+		descriptionIndex < HELIUM_ARRAY_COUNT( m_staticMeshVertexDescriptions );
+		++descriptionIndex )
+	{
+		if ( pDescription && m_staticMeshVertexDescriptions[descriptionIndex].Get() == pDescription )
+		{
+			return m_instancedStaticMeshVertexDescriptions[descriptionIndex];
+		}
+	}
+
+	return NULL;
+}
+
 /// Get the description for skinned mesh vertices.
 ///
 /// @return  Skinned mesh vertex description.
@@ -2,6 +2,7 @@
 
 #include "Graphics/Graphics.h"
 
+#include "Foundation/DynamicArray.h"
 #include "Rendering/RendererTypes.h"
 #include "Rendering/RRenderResource.h"
 #include "Graphics/GraphicsConfig.h"
@@ -30,6 +31,8 @@ namespace Helium
 	public:
 		/// Maximum number of texture coordinate sets allowed for meshes.
 		static const size_t MESH_TEXTURE_COORDINATE_SET_COUNT_MAX = 2;
+		/// Granularity, in pixels, to which the scene render and depth targets are rounded up when they need to grow.
+		static const uint32_t VIEWPORT_SIZE_BUCKET = 256;
 
 		/// Standard rasterizer states.
 		enum ERasterizerState
@@ -145,10 +148,12 @@ namespace Helium
 		/// @name Vertex Description Access
 		//@{
 		RVertexDescription* GetSimpleVertexDescription() const;
+		RVertexDescription* GetInstancedSimpleVertexDescription() const;
 		RVertexDescription* GetSimpleTexturedVertexDescription() const;
 		RVertexDescription* GetScreenVertexDescription() const;
 		RVertexDescription* GetProjectedVertexDescription() const;
 		RVertexDescription* GetStaticMeshVertexDescription( size_t textureCoordinateSetCount ) const;
+		RVertexDescription* GetInstancedStaticMeshVertexDescription( RVertexDescription* pDescription ) const;
 		RVertexDescription* GetSkinnedMeshVertexDescription() const;
 		//@}
 
@@ -173,6 +178,25 @@ namespace Helium
 		inline uint32_t GetShadowDepthTextureUsableSize() const;
 		//@}
 
+		/// @name Dynamic Resolution
+		//@{
+		void UpdateResolutionScale( float32_t gpuFrameMilliseconds );
+		inline float32_t GetResolutionScale() const;
+		void GetScaledViewportSize(
+			uint32_t viewportWidth, uint32_t viewportHeight, uint32_t& rScaledWidth, uint32_t& rScaledHeight ) const;
+		//@}
+
+		/// @name Render Target Pool
+		//@{
+		RTexture2d* AcquireRenderTarget(
+			uint32_t width, uint32_t height, ERendererPixelFormat format,
+			ERendererBufferUsage usage = RENDERER_BUFFER_USAGE_RENDER_TARGET );
+		void ReleaseRenderTarget( RTexture2d* pTexture );
+		void EndRenderTargetFrame();
+		void ClearRenderTargetPool();
+		inline size_t GetPooledRenderTargetCount() const;
+		//@}
+
 		/// @name Static Access
 		//@{
 		static RenderResourceManager* GetInstance();
@@ -181,6 +205,25 @@ namespace Helium
 		//@}
 
 	private:
+		/// Transient render target owned by the render target pool.
+		struct PooledRenderTarget
+		{
+			/// Texture.
+			RTexture2dPtr spTexture;
+			/// Texture width, in pixels.
+			uint32_t width;
+			/// Texture height, in pixels.
+			uint32_t height;
+			/// Texture pixel format.
+			ERendererPixelFormat format;
+			/// Texture usage.
+			ERendererBufferUsage usage;
+			/// Index of the last frame during which the texture was acquired.
+			uint32_t lastUsedFrame;
+			/// True if the texture is currently acquired.
+			bool bInUse;
+		};
+
 		/// Standard rasterizer states.
 		RRasterizerStatePtr m_rasterizerStates[RASTERIZER_STATE_MAX];
 		/// Standard blend states.
@@ -192,6 +235,8 @@ namespace Helium
 
 		/// Simple vertex description.
 		RVertexDescriptionPtr m_spSimpleVertexDescription;
+		/// Instanced simple vertex description (simple vertices in stream 0, per-instance transforms in stream 1).
+		RVertexDescriptionPtr m_spInstancedSimpleVertexDescription;
 		/// Simple textured vertex description.
 		RVertexDescriptionPtr m_spSimpleTexturedVertexDescription;
 		/// Screen-space vertex description.
@@ -200,6 +245,9 @@ namespace Helium
 		RVertexDescriptionPtr m_spProjectedVertexDescription;
 		/// Static mesh vertex descriptions.
 		RVertexDescriptionPtr m_staticMeshVertexDescriptions[MESH_TEXTURE_COORDINATE_SET_COUNT_MAX];
+		/// Instanced static mesh vertex descriptions (static mesh vertices in stream 0, per-instance transforms in
+		/// stream 1).
+		RVertexDescriptionPtr m_instancedStaticMeshVertexDescriptions[MESH_TEXTURE_COORDINATE_SET_COUNT_MAX];
 		/// Skinned mesh vertex description.
 		RVertexDescriptionPtr m_spSkinnedMeshVertexDescription;
 
@@ -240,6 +288,18 @@ namespace Helium
 		/// Shadow depth texture usable size (cached from graphics config object value).
 		uint32_t m_shadowDepthTextureUsableSize;
 
+		/// Scale currently applied to the width and height of scene views.
+		float32_t m_resolutionScale;
+		/// GPU frame time targeted by dynamic resolution scaling, in milliseconds (zero if disabled).
+		float32_t m_resolutionTargetMilliseconds;
+		/// Smallest resolution scale allowed.
+		float32_t m_resolutionScaleMin;
+
+		/// Pooled transient render targets.
+		DynamicArray< PooledRenderTarget > m_renderTargetPool;
+		/// Index of the current render target pool frame.
+		uint32_t m_renderTargetFrameIndex;
+
 		/// Singleton instance.
 		static RenderResourceManager* sm_pInstance;
 
@@ -18,4 +18,24 @@ namespace Helium
     {
         return m_shadowDepthTextureUsableSize;
     }
+
+    /// Get the scale currently applied to the width and height of scene views.
+    ///
+    /// @return  Resolution scale, or one if dynamic resolution scaling is disabled.
+    ///
+    /// @see UpdateResolutionScale(), GetScaledViewportSize()
+    float32_t RenderResourceManager::GetResolutionScale() const
+    {
+        return m_resolutionScale;
+    }
+
+    /// Get the number of render targets currently held by the render target pool.
+    ///
+    /// @return  Number of pooled render targets, both acquired and available.
+    ///
+    /// @see AcquireRenderTarget(), EndRenderTargetFrame()
+    size_t RenderResourceManager::GetPooledRenderTargetCount() const
+    {
+        return m_renderTargetPool.GetSize();
+    }
 }
@@ -0,0 +1,235 @@
+#include "Precompile.h"
+#include "Graphics/RenderThread.h"
+
+#include "Platform/Atomic.h"
+#include "Engine/Config.h"
+#include "Engine/FrameProfiler.h"
+#include "Graphics/GraphicsConfig.h"
+#include "Rendering/Renderer.h"
+
+using namespace Helium;
+
+static uint32_t g_InitCount = 0;
+RenderThread* RenderThread::sm_pInstance = NULL;
+
+/// Constructor.
+///
+/// @param[in] pRenderThread  Owning render thread.
+RenderThread::Worker::Worker( RenderThread* pRenderThread )
+	: m_pRenderThread( pRenderThread )
+{
+	HELIUM_ASSERT( pRenderThread );
+}
+
+/// Run queued commands until the render thread is shut down.
+void RenderThread::Worker::Run()
+{
+	FrameProfiler::SetThreadName( "Render" );
+
+	for ( ;; )
+	{
+		m_pRenderThread->m_wakeUpSemaphore.Decrement();
+
+		if ( !m_pRenderThread->RunNextCommand() && m_pRenderThread->m_stopCounter != 0 )
+		{
+			break;
+		}
+	}
+}
+
+/// Constructor.
+RenderThread::RenderThread()
+	: m_nextCommandIndex( 0 )
+	, m_idleCondition( true, true )
+	, m_pThread( NULL )
+	, m_pWorker( NULL )
+	, m_stopCounter( 0 )
+{
+}
+
+/// Destructor.
+RenderThread::~RenderThread()
+{
+	Cleanup();
+}
+
+/// Queue a command to run on the render thread.
+///
+/// @param[in] pCommand  Command callback.
+/// @param[in] pData     Data to pass to the callback.  This must remain valid until the command has run.
+///
+/// @see Flush()
+void RenderThread::QueueCommand( Command pCommand, void* pData )
+{
+	HELIUM_ASSERT( pCommand );
+
+	{
+		MutexScopeLock scopeLock( m_commandLock );
+
+		QueuedCommand* pQueuedCommand = m_commands.New();
+		HELIUM_ASSERT( pQueuedCommand );
+		pQueuedCommand->pCommand = pCommand;
+		pQueuedCommand->pData = pData;
+
+		m_idleCondition.Reset();
+	}
+
+	m_wakeUpSemaphore.Increment();
+}
+
+/// Block until all commands queued so far have been run.
+///
+/// @see QueueCommand()
+void RenderThread::Flush()
+{
+	HELIUM_FRAME_PROFILER_SCOPE( "RenderThread::Flush" );
+
+	m_idleCondition.Wait();
+}
+
+/// Get the singleton RenderThread instance.
+///
+/// @return  Pointer to the RenderThread instance, or null if rendering is not pipelined.
+///
+/// @see Startup(), Shutdown()
+RenderThread* RenderThread::GetInstance()
+{
+	return sm_pInstance;
+}
+
+/// Create the singleton RenderThread instance and start the render thread.
+///
+/// No instance is created if pipelined rendering is not enabled in the GraphicsConfig or the renderer does not support
+/// multithreaded use.  This must be called after the renderer main context has been created.
+///
+/// @see Shutdown(), GetInstance()
+void RenderThread::Startup()
+{
+	if ( ++g_InitCount == 1 )
+	{
+		HELIUM_ASSERT( !sm_pInstance );
+		sm_pInstance = new RenderThread;
+		HELIUM_ASSERT( sm_pInstance );
+		if ( !sm_pInstance->Initialize() )
+		{
+			delete sm_pInstance;
+			sm_pInstance = NULL;
+		}
+	}
+}
+
+/// Run any remaining commands, stop the render thread, and destroy the singleton RenderThread instance.
+///
+/// @see Startup(), GetInstance()
+void RenderThread::Shutdown()
+{
+	if ( --g_InitCount == 0 )
+	{
+		delete sm_pInstance;
+		sm_pInstance = NULL;
+	}
+}
+
+/// Check whether pipelined rendering is enabled and supported, and start the render thread if so.
+///
+/// @return  True if rendering is pipelined, false if not.
+///
+/// @see Cleanup()
+bool RenderThread::Initialize()
+{
+	Config* pConfig = Config::GetInstance();
+	if ( !pConfig )
+	{
+		return false;
+	}
+
+	StrongPtr< GraphicsConfig > spGraphicsConfig(
+		pConfig->GetConfigObject< GraphicsConfig >( Name( "GraphicsConfig" ) ) );
+	if ( !spGraphicsConfig || !spGraphicsConfig->GetPipelinedRendering() )
+	{
+		return false;
+	}
+
+	Renderer* pRenderer = Renderer::GetInstance();
+	if ( !pRenderer || !pRenderer->SupportsAllFeatures( RENDERER_FEATURE_FLAG_MULTITHREADED ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"RenderThread::Initialize(): Renderer does not support multithreading.  Rendering will not be pipelined.\n" );
+
+		return false;
+	}
+
+	AtomicExchangeRelease( m_stopCounter, 0 );
+
+	m_pWorker = new Worker( this );
+	HELIUM_ASSERT( m_pWorker );
+
+	m_pThread = new RunnableThread( m_pWorker );
+	HELIUM_ASSERT( m_pThread );
+	HELIUM_VERIFY( m_pThread->Start( "Render" ) );
+
+	HELIUM_TRACE( TraceLevels::Info, "RenderThread: Rendering is pipelined with gameplay.\n" );
+
+	return true;
+}
+
+/// Run any remaining commands and stop the render thread.
+///
+/// @see Initialize()
+void RenderThread::Cleanup()
+{
+	if ( !m_pThread )
+	{
+		return;
+	}
+
+	AtomicExchangeRelease( m_stopCounter, 1 );
+	m_wakeUpSemaphore.Increment();
+
+	m_pThread->Join();
+	delete m_pThread;
+	m_pThread = NULL;
+
+	delete m_pWorker;
+	m_pWorker = NULL;
+
+	HELIUM_ASSERT( m_nextCommandIndex == m_commands.GetSize() );
+	m_commands.Clear();
+	m_nextCommandIndex = 0;
+}
+
+/// Run the next queued command, if any.
+///
+/// @return  True if a command was run, false if the queue was empty.
+bool RenderThread::RunNextCommand()
+{
+	QueuedCommand command;
+
+	{
+		MutexScopeLock scopeLock( m_commandLock );
+
+		if ( m_nextCommandIndex >= m_commands.GetSize() )
+		{
+			return false;
+		}
+
+		command = m_commands[m_nextCommandIndex];
+		++m_nextCommandIndex;
+	}
+
+	command.pCommand( command.pData );
+
+	// Signal waiting threads once the queue has been drained, recycling the queue storage for the next frame.
+	MutexScopeLock scopeLock( m_commandLock );
+
+	if ( m_nextCommandIndex >= m_commands.GetSize() )
+	{
+		m_commands.Resize( 0 );
+		m_nextCommandIndex = 0;
+
+		m_idleCondition.Signal();
+	}
+
+	return true;
+}
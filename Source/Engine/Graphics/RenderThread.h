@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#include "Platform/Condition.h"
+#include "Platform/Locks.h"
+#include "Platform/Semaphore.h"
+#include "Platform/Thread.h"
+#include "Foundation/DynamicArray.h"
+
+namespace Helium
+{
+	/// Dedicated thread issuing rendering commands, used when rendering is pipelined with gameplay.
+	///
+	/// Each frame, the game thread extracts what it needs to render into its graphics scenes (see
+	/// GraphicsScene::Update()) and queues the scenes to be rendered here, then moves on to the next gameplay frame
+	/// while the render thread draws the previous one.  Commands are run one at a time in the order in which they were
+	/// queued.
+	///
+	/// No instance is created unless pipelined rendering is enabled in the GraphicsConfig and the renderer supports
+	/// being driven from a thread other than the one creating resources (RENDERER_FEATURE_FLAG_MULTITHREADED).  Code
+	/// that would otherwise queue commands should run them inline when GetInstance() returns null.
+	class HELIUM_GRAPHICS_API RenderThread : NonCopyable
+	{
+	public:
+		/// Render thread command callback.
+		///
+		/// @param[in] pData  Data passed to QueueCommand().
+		typedef void ( *Command )( void* pData );
+
+		/// @name Command Queuing
+		//@{
+		void QueueCommand( Command pCommand, void* pData );
+		void Flush();
+		//@}
+
+		/// @name Static Access
+		//@{
+		static RenderThread* GetInstance();
+		static void Startup();
+		static void Shutdown();
+		//@}
+
+	private:
+		/// Queued command.
+		struct QueuedCommand
+		{
+			/// Command callback.
+			Command pCommand;
+			/// Data to pass to the callback.
+			void* pData;
+		};
+
+		/// Render thread runnable.
+		class Worker : public Runnable
+		{
+		public:
+			/// @name Construction/Destruction
+			//@{
+			explicit Worker( RenderThread* pRenderThread );
+			//@}
+
+			/// @name Runnable Interface
+			//@{
+			virtual void Run();
+			//@}
+
+		private:
+			/// Owning render thread.
+			RenderThread* m_pRenderThread;
+		};
+
+		/// Commands waiting to be run, in FIFO order.
+		DynamicArray< QueuedCommand > m_commands;
+		/// Index of the next command in m_commands to run.
+		size_t m_nextCommandIndex;
+		/// Lock for the command queue.
+		Mutex m_commandLock;
+		/// Semaphore incremented once for each queued command (and once to shut down).
+		Semaphore m_wakeUpSemaphore;
+		/// Condition signaled whenever all queued commands have been run.
+		Condition m_idleCondition;
+
+		/// Render thread.
+		RunnableThread* m_pThread;
+		/// Render thread runnable.
+		Worker* m_pWorker;
+		/// Non-zero if the render thread should stop once it runs out of commands.
+		volatile int32_t m_stopCounter;
+
+		/// Singleton instance.
+		static RenderThread* sm_pInstance;
+
+		/// @name Construction/Destruction
+		//@{
+		RenderThread();
+		~RenderThread();
+		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		bool Initialize();
+		void Cleanup();
+
+		bool RunNextCommand();
+		//@}
+	};
+}
@@ -6,6 +6,7 @@
 #include "Rendering/RPixelShader.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/RVertexShader.h"
+#include "Graphics/ShaderVariantManifest.h"
 
 #include "Reflect/TranslatorDeduction.h"
 
@@ -251,6 +252,9 @@ size_t Shader::BeginLoadVariant( RShader::EType shaderType, uint32_t userOptionI
         return Invalid< size_t >();
     }
 
+    // Record the variant as used if a level is recording a shader variant manifest.
+    ShaderVariantManifest::RecordVariantLoad( this, shaderType, userOptionIndex );
+
     // Use the begin-load override if one is registered.
     if( sm_pBeginLoadVariantOverride )
     {
@@ -394,6 +394,7 @@ namespace Helium
 
 		/// @name Data Access
 		//@{
+		inline size_t GetRenderResourceCount() const;
 		inline RShader* GetRenderResource( size_t index ) const;
 		inline const ShaderConstantBufferInfoSet* GetConstantBufferInfoSet( size_t index ) const;
 		inline const ShaderSamplerInfoSet* GetSamplerInfoSet( size_t index ) const;
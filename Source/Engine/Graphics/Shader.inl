@@ -298,6 +298,16 @@ namespace Helium
         return m_userOptions;
     }
 
+    /// Get the number of render resources in this shader variant (one for each system option set).
+    ///
+    /// @return  Render resource count.
+    ///
+    /// @see GetRenderResource()
+    size_t ShaderVariant::GetRenderResourceCount() const
+    {
+        return m_renderResources.GetSize();
+    }
+
     /// Get the render resource associated with the specified system option set index for this shader variant.
     ///
     /// @param[in] index  Index of the specific render resource to retrieve (based on system options).
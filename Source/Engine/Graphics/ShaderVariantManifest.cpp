@@ -0,0 +1,526 @@
+#include "Precompile.h"
+#include "Graphics/ShaderVariantManifest.h"
+
+#include "Foundation/FileStream.h"
+#include "Foundation/Stream.h"
+#include "Engine/AssetLoader.h"
+#include "Graphics/Shader.h"
+
+using namespace Helium;
+
+ShaderVariantManifest* ShaderVariantManifest::sm_pRecordingManifest = NULL;
+Mutex ShaderVariantManifest::sm_recordingLock;
+
+/// Read a value from a manifest buffer, advancing the read position.
+///
+/// @param[out]    rValue    Value read.
+/// @param[in,out] rpCurrent Current read position.
+/// @param[in]     pEnd      End of the manifest buffer.
+///
+/// @return  True if the value was read, false if the end of the buffer was reached.
+template< typename T >
+static bool ReadManifestValue( T& rValue, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+{
+	if( static_cast< size_t >( pEnd - rpCurrent ) < sizeof( T ) )
+	{
+		return false;
+	}
+
+	MemoryCopy( &rValue, rpCurrent, sizeof( T ) );
+	rpCurrent += sizeof( T );
+
+	return true;
+}
+
+/// Constructor.
+ShaderVariantManifest::ShaderVariantManifest()
+{
+}
+
+/// Destructor.
+ShaderVariantManifest::~ShaderVariantManifest()
+{
+	{
+		MutexScopeLock scopeLock( sm_recordingLock );
+		if( sm_pRecordingManifest == this )
+		{
+			sm_pRecordingManifest = NULL;
+		}
+	}
+
+	ReleaseWarmup();
+}
+
+/// Remove all records from this manifest.
+void ShaderVariantManifest::Clear()
+{
+	MutexScopeLock scopeLock( m_recordLock );
+	m_records.Clear();
+}
+
+/// Add a record for a shader variant if this manifest does not have one for it yet.
+///
+/// @param[in] shaderPath       Shader path.
+/// @param[in] shaderType       Shader type.
+/// @param[in] userOptionIndex  User option index of the variant.
+void ShaderVariantManifest::AddRecord( AssetPath shaderPath, RShader::EType shaderType, uint32_t userOptionIndex )
+{
+	HELIUM_ASSERT( !shaderPath.IsEmpty() );
+	HELIUM_ASSERT( static_cast< size_t >( shaderType ) < static_cast< size_t >( RShader::TYPE_MAX ) );
+
+	MutexScopeLock scopeLock( m_recordLock );
+
+	if( IsValid( FindRecord( shaderPath, shaderType, userOptionIndex ) ) )
+	{
+		return;
+	}
+
+	Record* pRecord = m_records.New();
+	HELIUM_ASSERT( pRecord );
+	pRecord->shaderPath = shaderPath;
+	pRecord->shaderType = shaderType;
+	pRecord->userOptionIndex = userOptionIndex;
+}
+
+/// Begin loading every shader variant in this manifest.
+///
+/// Loaded shaders and variants are held until ReleaseWarmup() is called (or this manifest is destroyed), so they
+/// stay resident for as long as the level using them.
+///
+/// @see TryFinishWarmup(), ReleaseWarmup()
+void ShaderVariantManifest::BeginWarmup()
+{
+	ReleaseWarmup();
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+
+	MutexScopeLock scopeLock( m_recordLock );
+
+	size_t recordCount = m_records.GetSize();
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		AssetPath shaderPath = m_records[ recordIndex ].shaderPath;
+
+		size_t shaderLoadCount = m_shaderLoads.GetSize();
+		size_t shaderLoadIndex;
+		for( shaderLoadIndex = 0; shaderLoadIndex < shaderLoadCount; ++shaderLoadIndex )
+		{
+			if( m_shaderLoads[ shaderLoadIndex ].path == shaderPath )
+			{
+				break;
+			}
+		}
+
+		if( shaderLoadIndex < shaderLoadCount )
+		{
+			continue;
+		}
+
+		ShaderLoad* pShaderLoad = m_shaderLoads.New();
+		HELIUM_ASSERT( pShaderLoad );
+		pShaderLoad->path = shaderPath;
+		pShaderLoad->loadId = pAssetLoader->BeginLoadObject( shaderPath );
+	}
+}
+
+/// Perform a non-blocking attempt to finish loading the shader variants in this manifest.
+///
+/// Variants of each shader begin loading as soon as the shader itself has loaded.
+///
+/// @return  True if all shader variants have finished loading (or failed to load), false if some are still loading.
+///
+/// @see BeginWarmup()
+bool ShaderVariantManifest::TryFinishWarmup()
+{
+	bool bFinished = true;
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+
+	size_t shaderLoadCount = m_shaderLoads.GetSize();
+	for( size_t shaderLoadIndex = 0; shaderLoadIndex < shaderLoadCount; ++shaderLoadIndex )
+	{
+		ShaderLoad& rShaderLoad = m_shaderLoads[ shaderLoadIndex ];
+		if( IsInvalid( rShaderLoad.loadId ) )
+		{
+			continue;
+		}
+
+		AssetPtr spObject;
+		if( !pAssetLoader->TryFinishLoad( rShaderLoad.loadId, spObject ) )
+		{
+			bFinished = false;
+
+			continue;
+		}
+
+		SetInvalid( rShaderLoad.loadId );
+
+		rShaderLoad.spShader = Reflect::SafeCast< Shader >( spObject.Get() );
+		if( !rShaderLoad.spShader )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"ShaderVariantManifest::TryFinishWarmup(): Failed to load shader \"%s\".\n",
+				*rShaderLoad.path.ToString() );
+
+			continue;
+		}
+
+		BeginVariantLoads( shaderLoadIndex );
+		bFinished = false;
+	}
+
+	size_t variantLoadCount = m_variantLoads.GetSize();
+	for( size_t variantLoadIndex = 0; variantLoadIndex < variantLoadCount; ++variantLoadIndex )
+	{
+		VariantLoad& rVariantLoad = m_variantLoads[ variantLoadIndex ];
+		if( IsInvalid( rVariantLoad.loadId ) )
+		{
+			continue;
+		}
+
+		Shader* pShader = m_shaderLoads[ rVariantLoad.shaderLoadIndex ].spShader;
+		HELIUM_ASSERT( pShader );
+		if( !pShader->TryFinishLoadVariant( rVariantLoad.loadId, rVariantLoad.spVariant ) )
+		{
+			bFinished = false;
+
+			continue;
+		}
+
+		SetInvalid( rVariantLoad.loadId );
+	}
+
+	return bFinished;
+}
+
+/// Release the shaders and shader variants loaded by BeginWarmup().
+///
+/// Any loads still in progress are finished first.
+///
+/// @see BeginWarmup()
+void ShaderVariantManifest::ReleaseWarmup()
+{
+	if( !m_shaderLoads.IsEmpty() )
+	{
+		AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+		HELIUM_ASSERT( pAssetLoader );
+
+		while( !TryFinishWarmup() )
+		{
+			pAssetLoader->Tick();
+		}
+	}
+
+	m_variantLoads.Clear();
+	m_shaderLoads.Clear();
+}
+
+/// Write this manifest to a stream.
+///
+/// @param[in] rStream  Stream to which the manifest should be written.
+///
+/// @see Read()
+void ShaderVariantManifest::Write( Stream& rStream ) const
+{
+	MutexScopeLock scopeLock( m_recordLock );
+
+	uint32_t version = VERSION;
+	rStream.Write( &version, sizeof( version ), 1 );
+
+	HELIUM_ASSERT( m_records.GetSize() <= UINT32_MAX );
+	uint32_t recordCount = static_cast< uint32_t >( m_records.GetSize() );
+	rStream.Write( &recordCount, sizeof( recordCount ), 1 );
+
+	String pathString;
+	for( uint32_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		const Record& rRecord = m_records[ recordIndex ];
+
+		rRecord.shaderPath.ToString( pathString );
+
+		uint32_t pathLength = static_cast< uint32_t >( pathString.GetSize() );
+		rStream.Write( &pathLength, sizeof( pathLength ), 1 );
+		rStream.Write( pathString.GetData(), sizeof( char ), pathLength );
+
+		uint32_t shaderType = static_cast< uint32_t >( rRecord.shaderType );
+		rStream.Write( &shaderType, sizeof( shaderType ), 1 );
+		rStream.Write( &rRecord.userOptionIndex, sizeof( rRecord.userOptionIndex ), 1 );
+	}
+}
+
+/// Read a manifest written by Write(), replacing the contents of this manifest.
+///
+/// @param[in] pData  Manifest data, in the byte order of the current platform.
+/// @param[in] size   Size of the manifest data.
+///
+/// @return  True if the manifest was read successfully, false if the data is invalid (in which case this manifest is
+///          left empty).
+///
+/// @see Write()
+bool ShaderVariantManifest::Read( const uint8_t* pData, size_t size )
+{
+	HELIUM_ASSERT( pData || size == 0 );
+
+	Clear();
+
+	const uint8_t* pCurrent = pData;
+	const uint8_t* pEnd = pData + size;
+
+	uint32_t version = 0;
+	if( !ReadManifestValue( version, pCurrent, pEnd ) || version != VERSION )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"ShaderVariantManifest::Read(): Manifest version %" PRIu32 " does not match the current version (%" PRIu32 ").\n",
+			version,
+			VERSION );
+
+		return false;
+	}
+
+	uint32_t recordCount = 0;
+	if( !ReadManifestValue( recordCount, pCurrent, pEnd ) )
+	{
+		return false;
+	}
+
+	MutexScopeLock scopeLock( m_recordLock );
+
+	for( uint32_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		uint32_t pathLength = 0;
+		if( !ReadManifestValue( pathLength, pCurrent, pEnd ) || pathLength > static_cast< size_t >( pEnd - pCurrent ) )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "ShaderVariantManifest::Read(): Record list is truncated.\n" );
+			m_records.Clear();
+
+			return false;
+		}
+
+		String pathString( reinterpret_cast< const char* >( pCurrent ), pathLength );
+		pCurrent += pathLength;
+
+		uint32_t shaderType = 0;
+		uint32_t userOptionIndex = 0;
+		AssetPath shaderPath;
+		if( !ReadManifestValue( shaderType, pCurrent, pEnd ) ||
+			!ReadManifestValue( userOptionIndex, pCurrent, pEnd ) ||
+			shaderType >= static_cast< uint32_t >( RShader::TYPE_MAX ) ||
+			!shaderPath.Set( pathString ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"ShaderVariantManifest::Read(): Invalid record for shader \"%s\".\n",
+				*pathString );
+			m_records.Clear();
+
+			return false;
+		}
+
+		Record* pRecord = m_records.New();
+		HELIUM_ASSERT( pRecord );
+		pRecord->shaderPath = shaderPath;
+		pRecord->shaderType = static_cast< RShader::EType >( shaderType );
+		pRecord->userOptionIndex = userOptionIndex;
+	}
+
+	return true;
+}
+
+/// Replace the contents of this manifest with those of a manifest file.
+///
+/// @param[in] rPath  Manifest file path.
+///
+/// @return  True if the manifest file was read successfully, false if it does not exist or is invalid (in which case
+///          this manifest is left empty).
+///
+/// @see SaveToFile()
+bool ShaderVariantManifest::LoadFromFile( const FilePath& rPath )
+{
+	Clear();
+
+	if( !rPath.Exists() )
+	{
+		return false;
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"ShaderVariantManifest::LoadFromFile(): Failed to open \"%s\" for reading.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	int64_t size64 = pFileStream->GetSize();
+	if( size64 < 0 || static_cast< uint64_t >( size64 ) > static_cast< size_t >( -1 ) )
+	{
+		delete pFileStream;
+
+		return false;
+	}
+
+	DynamicArray< uint8_t > data;
+	data.Resize( static_cast< size_t >( size64 ) );
+	size_t bytesRead = pFileStream->Read( data.GetData(), 1, data.GetSize() );
+
+	delete pFileStream;
+
+	if( bytesRead != data.GetSize() )
+	{
+		return false;
+	}
+
+	return Read( data.GetData(), data.GetSize() );
+}
+
+/// Write this manifest to a file.
+///
+/// @param[in] rPath  Manifest file path.
+///
+/// @return  True if the manifest was written successfully, false if not.
+///
+/// @see LoadFromFile()
+bool ShaderVariantManifest::SaveToFile( const FilePath& rPath ) const
+{
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"ShaderVariantManifest::SaveToFile(): Failed to open \"%s\" for writing.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+		Write( bufferedStream );
+	}
+
+	delete pFileStream;
+
+	return true;
+}
+
+/// Set the manifest to which all shader variant loads should be recorded.
+///
+/// @param[in] pManifest  Manifest to record to, or null to stop recording.
+///
+/// @see GetRecordingManifest(), RecordVariantLoad()
+void ShaderVariantManifest::SetRecordingManifest( ShaderVariantManifest* pManifest )
+{
+	MutexScopeLock scopeLock( sm_recordingLock );
+	sm_pRecordingManifest = pManifest;
+}
+
+/// Get the manifest to which all shader variant loads are currently recorded.
+///
+/// @return  Recording manifest, or null if shader variant loads are not being recorded.
+///
+/// @see SetRecordingManifest()
+ShaderVariantManifest* ShaderVariantManifest::GetRecordingManifest()
+{
+	return sm_pRecordingManifest;
+}
+
+/// Add a shader variant load to the recording manifest, if one is set.
+///
+/// This is called by Shader::BeginLoadVariant().
+///
+/// @param[in] pShader          Parent shader resource.
+/// @param[in] shaderType       Shader type.
+/// @param[in] userOptionIndex  User option index of the variant.
+///
+/// @see SetRecordingManifest()
+void ShaderVariantManifest::RecordVariantLoad( Shader* pShader, RShader::EType shaderType, uint32_t userOptionIndex )
+{
+	HELIUM_ASSERT( pShader );
+
+	MutexScopeLock scopeLock( sm_recordingLock );
+	if( sm_pRecordingManifest )
+	{
+		sm_pRecordingManifest->AddRecord( pShader->GetPath(), shaderType, userOptionIndex );
+	}
+}
+
+/// Find the record for a shader variant.
+///
+/// The record lock must be held by the caller.
+///
+/// @param[in] shaderPath       Shader path.
+/// @param[in] shaderType       Shader type.
+/// @param[in] userOptionIndex  User option index of the variant.
+///
+/// @return  Index of the record, or an invalid index if this manifest has no record for the variant.
+size_t ShaderVariantManifest::FindRecord(
+	AssetPath shaderPath,
+	RShader::EType shaderType,
+	uint32_t userOptionIndex ) const
+{
+	size_t recordCount = m_records.GetSize();
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		const Record& rRecord = m_records[ recordIndex ];
+		if( rRecord.shaderPath == shaderPath &&
+			rRecord.shaderType == shaderType &&
+			rRecord.userOptionIndex == userOptionIndex )
+		{
+			return recordIndex;
+		}
+	}
+
+	return Invalid< size_t >();
+}
+
+/// Begin loading the recorded variants of a shader that has finished loading during warm-up.
+///
+/// @param[in] shaderLoadIndex  Index of the shader load.
+void ShaderVariantManifest::BeginVariantLoads( size_t shaderLoadIndex )
+{
+	HELIUM_ASSERT( shaderLoadIndex < m_shaderLoads.GetSize() );
+
+	const ShaderLoad& rShaderLoad = m_shaderLoads[ shaderLoadIndex ];
+	Shader* pShader = rShaderLoad.spShader;
+	HELIUM_ASSERT( pShader );
+
+	// Copy the matching records first, as beginning a variant load records it to the recording manifest, which may be
+	// this manifest.
+	DynamicArray< Record > records;
+	{
+		MutexScopeLock scopeLock( m_recordLock );
+
+		size_t recordCount = m_records.GetSize();
+		for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+		{
+			if( m_records[ recordIndex ].shaderPath == rShaderLoad.path )
+			{
+				records.Push( m_records[ recordIndex ] );
+			}
+		}
+	}
+
+	size_t recordCount = records.GetSize();
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		const Record& rRecord = records[ recordIndex ];
+
+		size_t loadId = pShader->BeginLoadVariant( rRecord.shaderType, rRecord.userOptionIndex );
+		if( IsInvalid( loadId ) )
+		{
+			continue;
+		}
+
+		VariantLoad* pVariantLoad = m_variantLoads.New();
+		HELIUM_ASSERT( pVariantLoad );
+		pVariantLoad->shaderLoadIndex = shaderLoadIndex;
+		pVariantLoad->loadId = loadId;
+	}
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Engine/AssetPath.h"
+#include "Rendering/RShader.h"
+
+namespace Helium
+{
+	class Stream;
+
+	class Shader;
+	typedef Helium::StrongPtr< Shader > ShaderPtr;
+
+	class ShaderVariant;
+	typedef Helium::StrongPtr< ShaderVariant > ShaderVariantPtr;
+
+	/// List of the shader variants used by a level, recorded while the level runs so that the same variants can be
+	/// loaded (and compiled, if they are not yet cached) while the level loads the next time instead of when they are
+	/// first drawn.
+	///
+	/// While a manifest is set as the recording manifest, every shader variant load is added to it.  Records are only
+	/// ever added, so a manifest saved after each run covers every variant the level has used so far.
+	class HELIUM_GRAPHICS_API ShaderVariantManifest : NonCopyable
+	{
+	public:
+		/// Manifest format version.
+		static const uint32_t VERSION = 1;
+
+		/// Shader variant record.
+		struct Record
+		{
+			/// Shader path.
+			AssetPath shaderPath;
+			/// Shader type.
+			RShader::EType shaderType;
+			/// User option index of the variant.
+			uint32_t userOptionIndex;
+		};
+
+		/// @name Construction/Destruction
+		//@{
+		ShaderVariantManifest();
+		~ShaderVariantManifest();
+		//@}
+
+		/// @name Record Access
+		//@{
+		void Clear();
+		void AddRecord( AssetPath shaderPath, RShader::EType shaderType, uint32_t userOptionIndex );
+
+		inline size_t GetRecordCount() const;
+		inline const Record& GetRecord( size_t index ) const;
+		//@}
+
+		/// @name Warm-up
+		//@{
+		void BeginWarmup();
+		bool TryFinishWarmup();
+		void ReleaseWarmup();
+		//@}
+
+		/// @name Serialization
+		//@{
+		void Write( Stream& rStream ) const;
+		bool Read( const uint8_t* pData, size_t size );
+
+		bool LoadFromFile( const FilePath& rPath );
+		bool SaveToFile( const FilePath& rPath ) const;
+		//@}
+
+		/// @name Static Recording Support
+		//@{
+		static void SetRecordingManifest( ShaderVariantManifest* pManifest );
+		static ShaderVariantManifest* GetRecordingManifest();
+
+		static void RecordVariantLoad( Shader* pShader, RShader::EType shaderType, uint32_t userOptionIndex );
+		//@}
+
+	private:
+		/// Shader load during warm-up.
+		struct ShaderLoad
+		{
+			/// Shader path.
+			AssetPath path;
+			/// Shader reference, once loaded.
+			ShaderPtr spShader;
+			/// Shader load ID (invalid once loading has finished).
+			size_t loadId;
+		};
+
+		/// Shader variant load during warm-up.
+		struct VariantLoad
+		{
+			/// Index of the shader load for the parent shader.
+			size_t shaderLoadIndex;
+			/// Shader variant reference, once loaded.
+			ShaderVariantPtr spVariant;
+			/// Shader variant load ID (invalid once loading has finished).
+			size_t loadId;
+		};
+
+		/// Shader variant records.
+		DynamicArray< Record > m_records;
+		/// Lock for synchronizing record updates.
+		mutable Mutex m_recordLock;
+
+		/// Shaders loaded during warm-up.
+		DynamicArray< ShaderLoad > m_shaderLoads;
+		/// Shader variants loaded during warm-up.
+		DynamicArray< VariantLoad > m_variantLoads;
+
+		/// Manifest to which shader variant loads are currently recorded.
+		static ShaderVariantManifest* sm_pRecordingManifest;
+		/// Lock for synchronizing access to the recording manifest.
+		static Mutex sm_recordingLock;
+
+		/// @name Private Utility Functions
+		//@{
+		size_t FindRecord( AssetPath shaderPath, RShader::EType shaderType, uint32_t userOptionIndex ) const;
+		void BeginVariantLoads( size_t shaderLoadIndex );
+		//@}
+	};
+}
+
+#include "Graphics/ShaderVariantManifest.inl"
@@ -0,0 +1,26 @@
+namespace Helium
+{
+	/// Get the number of shader variant records in this manifest.
+	///
+	/// @return  Record count.
+	///
+	/// @see GetRecord()
+	size_t ShaderVariantManifest::GetRecordCount() const
+	{
+		return m_records.GetSize();
+	}
+
+	/// Get a shader variant record.
+	///
+	/// @param[in] index  Record index.
+	///
+	/// @return  Shader variant record.
+	///
+	/// @see GetRecordCount()
+	const ShaderVariantManifest::Record& ShaderVariantManifest::GetRecord( size_t index ) const
+	{
+		HELIUM_ASSERT( index < m_records.GetSize() );
+
+		return m_records[ index ];
+	}
+}
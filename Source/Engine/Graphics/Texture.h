@@ -40,6 +40,10 @@ namespace Helium
                 NORMAL_MAP,
                 /// Compressed normal map, higher compression (DXT1 with special handling during mip level generation).
                 NORMAL_MAP_COMPACT,
+                /// High-quality color with optional alpha (BC7).
+                COLOR_HIGH_QUALITY,
+                /// High-quality compressed normal map (BC5 with two independent channels).
+                NORMAL_MAP_HIGH_QUALITY,
 
                 MAX,
             };
@@ -54,6 +58,8 @@ namespace Helium
                 info.AddElement( COLOR_SMOOTH_ALPHA,    "COLOR_SMOOTH_ALPHA" );
                 info.AddElement( NORMAL_MAP,            "NORMAL_MAP" );
                 info.AddElement( NORMAL_MAP_COMPACT,    "NORMAL_MAP_COMPACT" );
+                info.AddElement( COLOR_HIGH_QUALITY,    "COLOR_HIGH_QUALITY" );
+                info.AddElement( NORMAL_MAP_HIGH_QUALITY, "NORMAL_MAP_HIGH_QUALITY" );
             }
         };
 
@@ -45,6 +45,8 @@ namespace Helium
     /// @return  True if the compression scheme is a normal map compression scheme, false if not.
     bool Texture::IsNormalMapCompression( ECompression compression )
     {
-        return ( compression == ECompression::NORMAL_MAP || compression == ECompression::NORMAL_MAP_COMPACT );
+        return ( compression == ECompression::NORMAL_MAP ||
+                 compression == ECompression::NORMAL_MAP_COMPACT ||
+                 compression == ECompression::NORMAL_MAP_HIGH_QUALITY );
     }
 }
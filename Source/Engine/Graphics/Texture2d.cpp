@@ -1,14 +1,19 @@
 #include "Precompile.h"
 #include "Graphics/Texture2d.h"
 
+#include "Platform/Thread.h"
 #include "Rendering/RendererUtil.h"
 #include "Rendering/Renderer.h"
 #include "Rendering/RTexture2d.h"
+#include "Graphics/TextureStreamingManager.h"
+#include "Graphics/TextureTranscoder.h"
+#include "Engine/CookedObjectLayout.h"
 #include "Reflect/TranslatorDeduction.h"
 
 HELIUM_IMPLEMENT_ASSET( Helium::Texture2d, Graphics, AssetType::FLAG_NO_TEMPLATE );
 
 HELIUM_DEFINE_CLASS( Helium::Texture2d::PersistentResourceData );
+HELIUM_DEFINE_COOKED_LAYOUT( Helium::Texture2d::PersistentResourceData );
 
 using namespace Helium;
 
@@ -29,8 +34,19 @@ void Texture2d::PersistentResourceData::PopulateMetaType( Reflect::MetaStruct& c
     comp.AddField( &PersistentResourceData::m_pixelFormatIndex,   "m_pixelFormatIndex" );
 }
 
+void Texture2d::PersistentResourceData::PopulateCookedLayout( CookedObjectLayout& rLayout )
+{
+    rLayout.AddPlainData( &PersistentResourceData::m_baseLevelWidth );
+    rLayout.AddPlainData( &PersistentResourceData::m_baseLevelHeight );
+    rLayout.AddPlainData( &PersistentResourceData::m_mipCount );
+    rLayout.AddPlainData( &PersistentResourceData::m_pixelFormatIndex );
+}
+
 /// Constructor.
 Texture2d::Texture2d()
+: m_residentMipBase( 0 )
+, m_pendingMipBase( 0 )
+, m_streamingIndex( Invalid< size_t >() )
 {
 }
 
@@ -39,6 +55,14 @@ Texture2d::~Texture2d()
 {
 }
 
+/// @copydoc Asset::RefCountPreDestroy()
+void Texture2d::RefCountPreDestroy()
+{
+    StopStreaming();
+
+    Base::RefCountPreDestroy();
+}
+
 /// @copydoc Asset::NeedsPrecacheResourceData()
 bool Texture2d::NeedsPrecacheResourceData() const
 {
@@ -48,7 +72,7 @@ bool Texture2d::NeedsPrecacheResourceData() const
 /// @copydoc Asset::BeginPrecacheResourceData()
 bool Texture2d::BeginPrecacheResourceData()
 {
-    HELIUM_ASSERT( m_renderResourceLoadIds.IsEmpty() );
+    HELIUM_ASSERT( m_renderResourceLoads.IsEmpty() );
 
     Renderer* pRenderer = Renderer::GetInstance();
     if ( !pRenderer )
@@ -59,50 +83,312 @@ bool Texture2d::BeginPrecacheResourceData()
     const uint32_t baseLevelWidth = m_persistentResourceData.m_baseLevelWidth;
     const uint32_t baseLevelHeight = m_persistentResourceData.m_baseLevelHeight;
     const uint32_t mipCount = m_persistentResourceData.m_mipCount;
+
+    // If texture streaming is enabled, only the smallest mip levels are loaded up front, and the texture streaming
+    // manager loads the rest once they are needed.
+    uint32_t mipBase = 0;
+    m_mipLevelsSizes.Clear();
+
+    TextureStreamingManager* pStreamingManager = TextureStreamingManager::GetInstance();
+    if ( pStreamingManager )
+    {
+        mipBase = TextureStreamingManager::GetMinResidentMipBase( baseLevelWidth, baseLevelHeight, mipCount );
+    }
+
+    if ( mipBase != 0 )
+    {
+        m_mipLevelsSizes.Reserve( mipCount );
+        m_mipLevelsSizes.Resize( mipCount );
+        m_mipLevelsSizes.Trim();
+
+        size_t levelsSize = 0;
+        for ( uint32_t mipIndex = mipCount; mipIndex != 0; --mipIndex )
+        {
+            size_t mipLevelSize = GetSubDataSize( mipIndex - 1 );
+            HELIUM_ASSERT( IsValid( mipLevelSize ) );
+            if ( IsValid( mipLevelSize ) )
+            {
+                levelsSize += mipLevelSize;
+            }
+
+            m_mipLevelsSizes[ mipIndex - 1 ] = levelsSize;
+        }
+    }
+    else
+    {
+        pStreamingManager = NULL;
+    }
+
+    RTexture2d* pTexture2d = CreateMipLevelsTexture( mipBase );
+    if ( !pTexture2d )
+    {
+        m_mipLevelsSizes.Clear();
+
+        return false;
+    }
+
+    m_spTexture = pTexture2d;
+    m_residentMipBase = mipBase;
+
+    BeginLoadMipLevels( pTexture2d, mipBase, m_renderResourceLoads );
+
+    if ( pStreamingManager )
+    {
+        pStreamingManager->RegisterTexture( this );
+    }
+
+    return true;
+}
+
+/// @copydoc Asset::TryFinishPrecacheResourceData()
+bool Texture2d::TryFinishPrecacheResourceData()
+{
+    // Check all pending load requests.
+    size_t loadRequestCount = m_renderResourceLoads.GetSize();
+    if( loadRequestCount == 0 )
+    {
+        return true;
+    }
+
+    RTexture2d* pTexture2d = static_cast< RTexture2d* >( m_spTexture.Get() );
+    HELIUM_ASSERT( pTexture2d );
+    HELIUM_ASSERT( loadRequestCount == pTexture2d->GetMipCount() );
+
+    // Keep the load IDs around until the renderer has also finished uploading any mip levels it deferred when they
+    // were unmapped.
+    if( !TryFinishLoadMipLevels( pTexture2d, m_renderResourceLoads ) || pTexture2d->IsUploadPending() )
+    {
+        return false;
+    }
+
+    m_renderResourceLoads.Clear();
+
+    return true;
+}
+
+bool Texture2d::LoadPersistentResourceObject( Reflect::ObjectPtr& _object )
+{
+    StopStreaming();
+    m_spTexture.Release();
+
+    HELIUM_ASSERT(_object.ReferencesObject());
+    if (!_object.ReferencesObject())
+    {
+        return false;
+    }
+
+    _object->CopyTo(&m_persistentResourceData);
+
+    return true;
+}
+
+/// @copydoc Resource::GetGpuResidentSize()
+size_t Texture2d::GetGpuResidentSize() const
+{
+    RTexture2d* pTexture2d = static_cast< RTexture2d* >( m_spTexture.Get() );
+    if( !pTexture2d )
+    {
+        return 0;
+    }
+
+    return RendererUtil::GetTexture2dMemorySize(
+        pTexture2d->GetWidth(),
+        pTexture2d->GetHeight(),
+        pTexture2d->GetMipCount(),
+        pTexture2d->GetPixelFormat() );
+}
+
+/// @copydoc Resource::EvictGpuData()
+bool Texture2d::EvictGpuData()
+{
+    // Leave textures alone while any of their mip levels are still being loaded.
+    if( !m_spTexture || !m_renderResourceLoads.IsEmpty() || IsStreamingMips() )
+    {
+        return false;
+    }
+
+    StopStreaming();
+    m_spTexture.Release();
+
+    return true;
+}
+
+/// @copydoc Texture::GetRenderResource2d()
+RTexture2d* Texture2d::GetRenderResource2d() const
+{
+    return static_cast< RTexture2d* >( m_spTexture.Get() );
+}
+
+/// Begin loading a different set of mip levels for this texture.
+///
+/// A new render resource containing the given mip level and all smaller levels is created and loaded in the
+/// background, and replaces the current render resource once TryFinishStreamMips() reports that loading has
+/// completed.  This is used by the TextureStreamingManager to both stream in finer mip levels and evict them.
+///
+/// @param[in] mipBase  Index of the top mip level to load.
+///
+/// @return  True if streaming was started, false if the texture is still loading or streaming was not necessary.
+///
+/// @see TryFinishStreamMips(), IsStreamingMips()
+bool Texture2d::BeginStreamMips( uint32_t mipBase )
+{
+    HELIUM_ASSERT( !IsStreamingMips() );
+    HELIUM_ASSERT( mipBase < m_persistentResourceData.m_mipCount );
+
+    if( IsStreamingMips() || !m_renderResourceLoads.IsEmpty() || !m_spTexture || mipBase == m_residentMipBase )
+    {
+        return false;
+    }
+
+    RTexture2d* pTexture2d = CreateMipLevelsTexture( mipBase );
+    if( !pTexture2d )
+    {
+        return false;
+    }
+
+    m_spPendingTexture = pTexture2d;
+    m_pendingMipBase = mipBase;
+
+    BeginLoadMipLevels( pTexture2d, mipBase, m_streamLoads );
+
+    return true;
+}
+
+/// Test for completion of mip level streaming, swapping in the new mip levels if loading has completed.
+///
+/// @return  True if streaming has completed and the new render resource is in use, false if loading is still in
+///          progress.
+///
+/// @see BeginStreamMips(), IsStreamingMips()
+bool Texture2d::TryFinishStreamMips()
+{
+    RTexture2d* pTexture2d = m_spPendingTexture.Get();
+    HELIUM_ASSERT( pTexture2d );
+    if( !pTexture2d )
+    {
+        return true;
+    }
+
+    // Don't swap in the new texture until the renderer has finished uploading its mip levels.
+    if( !TryFinishLoadMipLevels( pTexture2d, m_streamLoads ) || pTexture2d->IsUploadPending() )
+    {
+        return false;
+    }
+
+    m_streamLoads.Clear();
+
+    m_spTexture = pTexture2d;
+    m_residentMipBase = m_pendingMipBase;
+    m_spPendingTexture.Release();
+
+    return true;
+}
+
+/// Create a render resource containing a given mip level of this texture and all smaller levels.
+///
+/// @param[in] mipBase  Index of the top mip level to include.
+///
+/// @return  Newly created texture, or null if creation failed.
+RTexture2d* Texture2d::CreateMipLevelsTexture( uint32_t mipBase ) const
+{
+    Renderer* pRenderer = Renderer::GetInstance();
+    HELIUM_ASSERT( pRenderer );
+
+    const uint32_t width = Max< uint32_t >( m_persistentResourceData.m_baseLevelWidth >> mipBase, 1 );
+    const uint32_t height = Max< uint32_t >( m_persistentResourceData.m_baseLevelHeight >> mipBase, 1 );
+    const uint32_t mipCount = m_persistentResourceData.m_mipCount - mipBase;
     const int32_t pixelFormatIndex = m_persistentResourceData.m_pixelFormatIndex;
 
+    // Formats the renderer cannot sample are transcoded as each mip level is loaded.
+    const ERendererPixelFormat format = TextureTranscoder::GetLoadFormat(
+        static_cast< ERendererPixelFormat >( pixelFormatIndex ),
+        pRenderer->GetFeatureFlags() );
+
     RTexture2d* pTexture2d = pRenderer->CreateTexture2d(
-        baseLevelWidth,
-        baseLevelHeight,
+        width,
+        height,
         mipCount,
-        static_cast< ERendererPixelFormat >( pixelFormatIndex ),
+        format,
         RENDERER_BUFFER_USAGE_STATIC );
 
     if ( !pTexture2d )
     {
         HELIUM_TRACE(
             TraceLevels::Error,
-            "Texture2d::BeginPrecacheResourceData(): Failed to create texture render resource (width: %" PRIu32 "; height: %" PRIu32 "; mip count: %" PRIu32 "; pixel format index: %" PRId32 ").\n",
-            baseLevelWidth,
-            baseLevelHeight,
+            "Texture2d::CreateMipLevelsTexture(): Failed to create texture render resource (width: %" PRIu32 "; height: %" PRIu32 "; mip count: %" PRIu32 "; pixel format index: %" PRId32 ").\n",
+            width,
+            height,
             mipCount,
             pixelFormatIndex );
-
-        return false;
     }
 
-    m_spTexture = pTexture2d;
+    return pTexture2d;
+}
+
+/// Begin loading the cached data for each mip level of a texture render resource.
+///
+/// Each mip level of the render resource is locked until its load has completed (see TryFinishLoadMipLevels()).  If
+/// the render resource was created in a different format than the cached data (see TextureTranscoder), the cached
+/// data is loaded into staging memory and transcoded once its load has completed.
+///
+/// @param[in]  pTexture2d  Texture render resource to load.
+/// @param[in]  mipBase     Index of the mip level of this texture corresponding to the top level of the render
+///                         resource.
+/// @param[out] rLoads      Async loads for each mip level of the render resource (with invalid load IDs for levels
+///                         that failed to begin loading).
+void Texture2d::BeginLoadMipLevels( RTexture2d* pTexture2d, uint32_t mipBase, DynamicArray< MipLevelLoad >& rLoads )
+{
+    HELIUM_ASSERT( pTexture2d );
 
-    m_renderResourceLoadIds.Reserve( mipCount );
-    m_renderResourceLoadIds.Resize( mipCount );
-    m_renderResourceLoadIds.Trim();
+    const uint32_t mipCount = pTexture2d->GetMipCount();
 
-    const ERendererPixelFormat format = static_cast< ERendererPixelFormat >( pixelFormatIndex );
+    rLoads.Reserve( mipCount );
+    rLoads.Resize( mipCount );
+    rLoads.Trim();
+
+    const ERendererPixelFormat format = static_cast< ERendererPixelFormat >( m_persistentResourceData.m_pixelFormatIndex );
     HELIUM_ASSERT( static_cast< size_t >( format ) < static_cast< size_t >( RENDERER_PIXEL_FORMAT_MAX ) );
 
+    const bool bTranscode = ( pTexture2d->GetPixelFormat() != format );
+
+    // Lock every mip level first so that all of them can be loaded with a single batch of reads.
+    DynamicArray< void* > mipData;
+    DynamicArray< size_t > mipLevelSizes;
+    DynamicArray< size_t > loadIds;
+    mipData.Resize( mipCount );
+    mipLevelSizes.Resize( mipCount );
+    loadIds.Resize( mipCount );
+
     for ( uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex )
     {
-        SetInvalid( m_renderResourceLoadIds[ mipIndex ] );
+        MipLevelLoad& rLoad = rLoads[ mipIndex ];
+        SetInvalid( rLoad.loadId );
+        rLoad.pStagingData = NULL;
 
         size_t pitch;
         void* pMipData = pTexture2d->Map( mipIndex, pitch );
         HELIUM_ASSERT( pMipData );
+        rLoad.pMipData = pMipData;
+        rLoad.pitch = pitch;
+        mipData[ mipIndex ] = pMipData;
+        mipLevelSizes[ mipIndex ] = 0;
         if ( !pMipData )
         {
             HELIUM_TRACE(
                 TraceLevels::Error,
-                "Texture2d::BeginPrecacheResourceData(): Failed to lock mip level %" PRIu32 ".\n",
-                mipIndex );
+                "Texture2d::BeginLoadMipLevels(): Failed to lock mip level %" PRIu32 ".\n",
+                mipBase + mipIndex );
+
+            continue;
+        }
+
+        if ( bTranscode )
+        {
+            size_t mipLevelSize = GetSubDataSize( mipBase + mipIndex );
+            rLoad.pStagingData = DefaultAllocator().Allocate( mipLevelSize );
+            HELIUM_ASSERT( rLoad.pStagingData );
+            mipData[ mipIndex ] = rLoad.pStagingData;
+            mipLevelSizes[ mipIndex ] = mipLevelSize;
 
             continue;
         }
@@ -111,90 +397,106 @@ bool Texture2d::BeginPrecacheResourceData()
         size_t rowCount = RendererUtil::PixelToBlockRowCount( mipLevelHeight, format );
         size_t mipLevelSize = pitch * rowCount;
 
-        HELIUM_ASSERT( mipLevelSize == GetSubDataSize( mipIndex ) );
+        HELIUM_ASSERT( mipLevelSize == GetSubDataSize( mipBase + mipIndex ) );
+
+        mipLevelSizes[ mipIndex ] = mipLevelSize;
+    }
+
+    BeginLoadSubDataRange( mipData.GetData(), mipBase, mipCount, loadIds.GetData(), mipLevelSizes.GetData() );
 
-        size_t loadId = BeginLoadSubData( pMipData, mipIndex, mipLevelSize );
-        HELIUM_ASSERT( IsValid( loadId ) );
-        if ( IsInvalid( loadId ) )
+    for ( uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex )
+    {
+        MipLevelLoad& rLoad = rLoads[ mipIndex ];
+        rLoad.loadId = loadIds[ mipIndex ];
+        if ( rLoad.pMipData && IsInvalid( rLoad.loadId ) )
         {
             HELIUM_TRACE(
                 TraceLevels::Error,
-                "Texture2d::BeginPrecacheResourceData(): Failed to begin loading of cached data for mip level %" PRIu32 ".\n",
-                mipIndex );
+                "Texture2d::BeginLoadMipLevels(): Failed to begin loading of cached data for mip level %" PRIu32 ".\n",
+                mipBase + mipIndex );
 
-            pTexture2d->Unmap( mipIndex );
+            DefaultAllocator().Free( rLoad.pStagingData );
+            rLoad.pStagingData = NULL;
 
-            continue;
+            pTexture2d->Unmap( mipIndex );
         }
-
-        m_renderResourceLoadIds[ mipIndex ] = loadId;
     }
-
-    return true;
 }
 
-/// @copydoc Asset::TryFinishPrecacheResourceData()
-bool Texture2d::TryFinishPrecacheResourceData()
+/// Test for completion of the mip level loads started by BeginLoadMipLevels().
+///
+/// Each mip level is transcoded if necessary and unlocked as soon as its load completes.
+///
+/// @param[in]     pTexture2d  Texture render resource being loaded.
+/// @param[in,out] rLoads      Async loads for each mip level of the render resource.  IDs of completed loads are set
+///                            to invalid values.
+///
+/// @return  True if all loads have completed, false if any are still in progress.
+bool Texture2d::TryFinishLoadMipLevels( RTexture2d* pTexture2d, DynamicArray< MipLevelLoad >& rLoads )
 {
-    // Check all pending load requests.
-    size_t loadRequestCount = m_renderResourceLoadIds.GetSize();
-    if( loadRequestCount == 0 )
-    {
-        return true;
-    }
-
-    RTexture2d* pTexture2d = static_cast< RTexture2d* >( m_spTexture.Get() );
     HELIUM_ASSERT( pTexture2d );
-    HELIUM_ASSERT( loadRequestCount == pTexture2d->GetMipCount() );
 
     bool bHaveUnfinishedLoad = false;
 
+    size_t loadRequestCount = rLoads.GetSize();
     for( size_t loadRequestIndex = 0; loadRequestIndex < loadRequestCount; ++loadRequestIndex )
     {
-        size_t loadId = m_renderResourceLoadIds[ loadRequestIndex ];
-        if( IsInvalid( loadId ) )
+        MipLevelLoad& rLoad = rLoads[ loadRequestIndex ];
+        if( IsInvalid( rLoad.loadId ) )
         {
             continue;
         }
 
-        if( !TryFinishLoadSubData( loadId ) )
+        if( !TryFinishLoadSubData( rLoad.loadId ) )
         {
             bHaveUnfinishedLoad = true;
 
             continue;
         }
 
-        SetInvalid( m_renderResourceLoadIds[ loadRequestIndex ] );
-        pTexture2d->Unmap( static_cast< uint32_t >( loadRequestIndex ) );
-    }
+        uint32_t mipIndex = static_cast< uint32_t >( loadRequestIndex );
+        if( rLoad.pStagingData )
+        {
+            TextureTranscoder::Transcode(
+                static_cast< ERendererPixelFormat >( m_persistentResourceData.m_pixelFormatIndex ),
+                rLoad.pStagingData,
+                pTexture2d->GetPixelFormat(),
+                rLoad.pMipData,
+                rLoad.pitch,
+                pTexture2d->GetWidth( mipIndex ),
+                pTexture2d->GetHeight( mipIndex ) );
+
+            DefaultAllocator().Free( rLoad.pStagingData );
+            rLoad.pStagingData = NULL;
+        }
 
-    if( bHaveUnfinishedLoad )
-    {
-        return false;
+        SetInvalid( rLoad.loadId );
+        pTexture2d->Unmap( mipIndex );
     }
 
-    m_renderResourceLoadIds.Clear();
-
-    return true;
+    return !bHaveUnfinishedLoad;
 }
 
-bool Texture2d::LoadPersistentResourceObject( Reflect::ObjectPtr& _object )
+/// Stop streaming mip levels for this texture, waiting for any mip level loads in progress to complete.
+void Texture2d::StopStreaming()
 {
-    m_spTexture.Release();
-
-    HELIUM_ASSERT(_object.ReferencesObject());
-    if (!_object.ReferencesObject())
+    TextureStreamingManager* pStreamingManager = TextureStreamingManager::GetInstance();
+    if( pStreamingManager )
     {
-        return false;
+        pStreamingManager->UnregisterTexture( this );
     }
 
-    _object->CopyTo(&m_persistentResourceData);
+    RTexture2d* pPendingTexture = m_spPendingTexture.Get();
+    if( pPendingTexture )
+    {
+        while( !TryFinishLoadMipLevels( pPendingTexture, m_streamLoads ) )
+        {
+            Thread::Yield();
+        }
 
-    return true;
-}
+        m_streamLoads.Clear();
+        m_spPendingTexture.Release();
+    }
 
-/// @copydoc Texture::GetRenderResource2d()
-RTexture2d* Texture2d::GetRenderResource2d() const
-{
-    return static_cast< RTexture2d* >( m_spTexture.Get() );
+    m_mipLevelsSizes.Clear();
 }
@@ -4,6 +4,10 @@
 
 namespace Helium
 {
+	HELIUM_DECLARE_RPTR( RTexture2d );
+
+	class CookedObjectLayout;
+
 	class Texture2d;
 	typedef Helium::StrongPtr< Texture2d > Texture2dPtr;
 	typedef Helium::StrongPtr< const Texture2d > ConstTexture2dPtr;
@@ -20,12 +24,18 @@ namespace Helium
 		virtual ~Texture2d();
 		//@}
 
+		/// @name Asset Interface
+		//@{
+		virtual void RefCountPreDestroy() override;
+		//@}
+
 		struct HELIUM_GRAPHICS_API PersistentResourceData : public Object
 		{
 			HELIUM_DECLARE_CLASS(Texture2d::PersistentResourceData, Reflect::Object);
 
 			PersistentResourceData();
 			static void PopulateMetaType( Reflect::MetaStruct& comp );
+			static void PopulateCookedLayout( CookedObjectLayout& rLayout );
 
 			uint32_t m_baseLevelWidth;
 			uint32_t m_baseLevelHeight;
@@ -45,20 +55,75 @@ namespace Helium
 
 		inline uint32_t GetWidth() const;
 		inline uint32_t GetHeight() const;
+		inline uint32_t GetMipCount() const;
 
 		/// @name Resource Serialization
 		//@{
 		virtual bool LoadPersistentResourceObject( Reflect::ObjectPtr& _object ) override;
 		//@}
 
+		/// @name Residency
+		//@{
+		virtual size_t GetGpuResidentSize() const override;
+		virtual bool EvictGpuData() override;
+		//@}
+
 		/// @name Data Access
 		//@{
 		virtual RTexture2d* GetRenderResource2d() const override;
 		//@}
 
+		/// @name Mip Level Streaming
+		//@{
+		bool BeginStreamMips( uint32_t mipBase );
+		bool TryFinishStreamMips();
+		inline bool IsStreamingMips() const;
+
+		inline uint32_t GetResidentMipBase() const;
+		inline size_t GetMipLevelsSize( uint32_t mipBase ) const;
+		//@}
+
 	private:
-		/// Async load IDs for cached texture data.
-		DynamicArray< size_t > m_renderResourceLoadIds;
+		friend class TextureStreamingManager;
+
+		/// Async load of the cached data of a single mip level.
+		struct MipLevelLoad
+		{
+			/// Async load ID (invalid once the load has completed, or if it failed to begin).
+			size_t loadId;
+			/// Mapped mip level of the render resource.
+			void* pMipData;
+			/// Row pitch of the mapped mip level, in bytes.
+			size_t pitch;
+			/// Memory into which cached data is loaded for transcoding (null if loaded directly into the mip level).
+			void* pStagingData;
+		};
+
+		/// Async loads of cached texture data.
+		DynamicArray< MipLevelLoad > m_renderResourceLoads;
+
+		/// Index of the top mip level loaded into the current render resource.
+		uint32_t m_residentMipBase;
+		/// Combined size of each mip level and all smaller levels, in bytes (only set if mip levels are streamed).
+		DynamicArray< size_t > m_mipLevelsSizes;
+
+		/// Render resource being loaded with a new set of mip levels.
+		RTexture2dPtr m_spPendingTexture;
+		/// Index of the top mip level being loaded into the pending render resource.
+		uint32_t m_pendingMipBase;
+		/// Async loads of mip levels being streamed into the pending render resource.
+		DynamicArray< MipLevelLoad > m_streamLoads;
+
+		/// Index of this texture in the texture streaming manager (invalid if not streamed).
+		size_t m_streamingIndex;
+
+		/// @name Private Utility Functions
+		//@{
+		RTexture2d* CreateMipLevelsTexture( uint32_t mipBase ) const;
+		void BeginLoadMipLevels( RTexture2d* pTexture2d, uint32_t mipBase, DynamicArray< MipLevelLoad >& rLoads );
+		bool TryFinishLoadMipLevels( RTexture2d* pTexture2d, DynamicArray< MipLevelLoad >& rLoads );
+		void StopStreaming();
+		//@}
 	};
 }
 
@@ -10,4 +10,41 @@ namespace Helium
 	{
 		return m_persistentResourceData.m_baseLevelHeight;
 	}
+
+	/// Get the number of mip levels in this texture.
+	///
+	/// @return  Mip level count, including any levels that are not currently resident.
+	uint32_t Helium::Texture2d::GetMipCount() const
+	{
+		return m_persistentResourceData.m_mipCount;
+	}
+
+	/// Get whether a new set of mip levels is being streamed in for this texture.
+	///
+	/// @return  True if mip level streaming is in progress, false if not.
+	///
+	/// @see BeginStreamMips(), TryFinishStreamMips()
+	bool Helium::Texture2d::IsStreamingMips() const
+	{
+		return m_spPendingTexture.Get() != NULL;
+	}
+
+	/// Get the index of the top mip level currently resident in the render resource.
+	///
+	/// @return  Top resident mip level index.  Level zero of the render resource corresponds to this mip level of the
+	///          texture.
+	uint32_t Helium::Texture2d::GetResidentMipBase() const
+	{
+		return m_residentMipBase;
+	}
+
+	/// Get the amount of memory needed to keep a range of mip levels resident.
+	///
+	/// @param[in] mipBase  Index of the top mip level of the range (the range includes all smaller levels).
+	///
+	/// @return  Combined size of the mip levels, in bytes, or zero if mip levels are not streamed for this texture.
+	size_t Helium::Texture2d::GetMipLevelsSize( uint32_t mipBase ) const
+	{
+		return ( mipBase < m_mipLevelsSizes.GetSize() ? m_mipLevelsSizes[ mipBase ] : 0 );
+	}
 }
@@ -0,0 +1,433 @@
+#include "Precompile.h"
+#include "Graphics/TextureStreamingManager.h"
+
+#include "Engine/Config.h"
+#include "Graphics/GraphicsConfig.h"
+#include "Graphics/Texture2d.h"
+
+#include <algorithm>
+
+using namespace Helium;
+
+static uint32_t g_InitCount = 0;
+TextureStreamingManager* TextureStreamingManager::sm_pInstance = NULL;
+
+/// Constructor.
+TextureStreamingManager::TextureStreamingManager()
+	: m_budget( 0 )
+	, m_residentSize( 0 )
+	, m_pendingStreamCount( 0 )
+	, m_frameIndex( 0 )
+{
+}
+
+/// Destructor.
+TextureStreamingManager::~TextureStreamingManager()
+{
+	Cleanup();
+}
+
+/// Add a texture to the set of textures with streamed mip levels.
+///
+/// The texture should have only its minimum resident mip levels loaded (see GetMinResidentMipBase()).
+///
+/// @param[in] pTexture  Texture to register.
+///
+/// @see UnregisterTexture()
+void TextureStreamingManager::RegisterTexture( Texture2d* pTexture )
+{
+	HELIUM_ASSERT( pTexture );
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	HELIUM_ASSERT( IsInvalid( pTexture->m_streamingIndex ) );
+	if ( IsValid( pTexture->m_streamingIndex ) )
+	{
+		return;
+	}
+
+	uint32_t minMipBase = GetMinResidentMipBase( pTexture->GetWidth(), pTexture->GetHeight(), pTexture->GetMipCount() );
+
+	Entry* pEntry = m_entries.New();
+	HELIUM_ASSERT( pEntry );
+	pEntry->pTexture = pTexture;
+	pEntry->requestedMipBase = minMipBase;
+	pEntry->wantedMipBase = minMipBase;
+	pEntry->targetMipBase = minMipBase;
+	pEntry->minMipBase = minMipBase;
+	pEntry->requestedScreenSize = 0.0f;
+	pEntry->priority = 0.0f;
+	pEntry->lastRequestFrame = m_frameIndex - REQUEST_TIMEOUT_FRAME_COUNT - 1;
+
+	pTexture->m_streamingIndex = m_entries.GetSize() - 1;
+}
+
+/// Remove a texture from the set of textures with streamed mip levels.
+///
+/// Once this returns, the manager will no longer access the texture, although any mip level loads it has already
+/// started for the texture may still be pending.
+///
+/// @param[in] pTexture  Texture to unregister.
+///
+/// @see RegisterTexture()
+void TextureStreamingManager::UnregisterTexture( Texture2d* pTexture )
+{
+	HELIUM_ASSERT( pTexture );
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryIndex = pTexture->m_streamingIndex;
+	if ( IsInvalid( entryIndex ) )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( entryIndex < m_entries.GetSize() );
+	HELIUM_ASSERT( m_entries[entryIndex].pTexture == pTexture );
+
+	if ( pTexture->IsStreamingMips() )
+	{
+		HELIUM_ASSERT( m_pendingStreamCount != 0 );
+		--m_pendingStreamCount;
+	}
+
+	m_entries.RemoveSwap( entryIndex );
+	if ( entryIndex < m_entries.GetSize() )
+	{
+		m_entries[entryIndex].pTexture->m_streamingIndex = entryIndex;
+	}
+
+	SetInvalid( pTexture->m_streamingIndex );
+}
+
+/// Request the mip levels of a texture needed to display it at a given size on screen.
+///
+/// This should be called each frame for each texture in use by visible objects, prior to calling Update().  Multiple
+/// requests for the same texture within a frame are combined, using the largest requested size.
+///
+/// @param[in] pTexture    Texture being displayed.  Textures that are not streamed are ignored.
+/// @param[in] screenSize  Approximate size (width or height) covered by the texture on screen, in pixels.
+///
+/// @see Update()
+void TextureStreamingManager::RequestTexture( Texture2d* pTexture, float32_t screenSize )
+{
+	HELIUM_ASSERT( pTexture );
+
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryIndex = pTexture->m_streamingIndex;
+	if ( IsInvalid( entryIndex ) )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( entryIndex < m_entries.GetSize() );
+	Entry& rEntry = m_entries[entryIndex];
+	HELIUM_ASSERT( rEntry.pTexture == pTexture );
+
+	// Use the smallest mip level that still covers the requested size with at least one texel per pixel.
+	uint32_t baseLevelSize = Max( pTexture->GetWidth(), pTexture->GetHeight() );
+	uint32_t mipCount = pTexture->GetMipCount();
+
+	uint32_t mipBase = 0;
+	while ( mipBase + 1 < mipCount && static_cast< float32_t >( baseLevelSize >> ( mipBase + 1 ) ) >= screenSize )
+	{
+		++mipBase;
+	}
+
+	mipBase = Min( mipBase, rEntry.minMipBase );
+
+	if ( rEntry.lastRequestFrame != m_frameIndex )
+	{
+		rEntry.requestedMipBase = mipBase;
+		rEntry.requestedScreenSize = screenSize;
+		rEntry.lastRequestFrame = m_frameIndex;
+	}
+	else
+	{
+		rEntry.requestedMipBase = Min( rEntry.requestedMipBase, mipBase );
+		rEntry.requestedScreenSize = Max( rEntry.requestedScreenSize, screenSize );
+	}
+}
+
+/// Update the resident mip levels of all streamed textures based on the requests made during the current frame.
+///
+/// This should be called once per frame, after all texture requests for the frame have been made.
+///
+/// @see RequestTexture()
+void TextureStreamingManager::Update()
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryCount = m_entries.GetSize();
+	HELIUM_ASSERT( entryCount <= UINT32_MAX );
+
+	// Finish any mip level streaming that has completed.
+	for ( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Texture2d* pTexture = m_entries[entryIndex].pTexture;
+		HELIUM_ASSERT( pTexture );
+		if ( pTexture->IsStreamingMips() && pTexture->TryFinishStreamMips() )
+		{
+			HELIUM_ASSERT( m_pendingStreamCount != 0 );
+			--m_pendingStreamCount;
+		}
+	}
+
+	// Update the levels wanted by each texture based on recent requests, and charge the minimum resident levels of
+	// each texture against the budget up front, as they can never be evicted.
+	size_t minResidentSize = 0;
+	size_t residentSize = 0;
+
+	m_sortKeys.Resize( 0 );
+	m_sortKeys.Reserve( entryCount );
+
+	for ( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Entry& rEntry = m_entries[entryIndex];
+		Texture2d* pTexture = rEntry.pTexture;
+
+		uint32_t requestAge = m_frameIndex - rEntry.lastRequestFrame;
+		if ( requestAge == 0 )
+		{
+			rEntry.wantedMipBase = rEntry.requestedMipBase;
+			rEntry.priority = rEntry.requestedScreenSize;
+		}
+		else if ( requestAge > REQUEST_TIMEOUT_FRAME_COUNT )
+		{
+			rEntry.wantedMipBase = rEntry.minMipBase;
+			rEntry.priority = 0.0f;
+		}
+
+		minResidentSize += pTexture->GetMipLevelsSize( rEntry.minMipBase );
+		residentSize += pTexture->GetMipLevelsSize( pTexture->GetResidentMipBase() );
+
+		// Priorities are never negative, so their bit patterns sort in the same order as their values.
+		HELIUM_ASSERT( rEntry.priority >= 0.0f );
+		uint32_t priorityBits;
+		MemoryCopy( &priorityBits, &rEntry.priority, sizeof( priorityBits ) );
+
+		m_sortKeys.Push( ( static_cast< uint64_t >( priorityBits ) << 32 ) | static_cast< uint64_t >( entryIndex ) );
+	}
+
+	m_residentSize = residentSize;
+
+	std::sort( m_sortKeys.GetData(), m_sortKeys.GetData() + entryCount );
+
+	// Grant the remaining budget to the textures with the largest on-screen size first.
+	size_t remainingBudget = ( m_budget > minResidentSize ? m_budget - minResidentSize : 0 );
+	for ( size_t keyIndex = entryCount; keyIndex != 0; --keyIndex )
+	{
+		Entry& rEntry = m_entries[static_cast< size_t >( static_cast< uint32_t >( m_sortKeys[keyIndex - 1] ) )];
+		rEntry.targetMipBase = ComputeTargetMipBase( rEntry, remainingBudget );
+	}
+
+	// Start evicting mip levels before streaming any in, so the memory they free is available as soon as possible.
+	for ( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Entry& rEntry = m_entries[entryIndex];
+		if ( rEntry.targetMipBase > rEntry.pTexture->GetResidentMipBase() )
+		{
+			BeginStreaming( rEntry );
+		}
+	}
+
+	for ( size_t keyIndex = entryCount; keyIndex != 0; --keyIndex )
+	{
+		Entry& rEntry = m_entries[static_cast< size_t >( static_cast< uint32_t >( m_sortKeys[keyIndex - 1] ) )];
+		if ( rEntry.targetMipBase < rEntry.pTexture->GetResidentMipBase() )
+		{
+			BeginStreaming( rEntry );
+		}
+	}
+
+	++m_frameIndex;
+}
+
+/// Set the memory budget for streamed textures.
+///
+/// The new budget takes effect during the next call to Update().
+///
+/// @param[in] budget  Texture streaming budget, in bytes.
+///
+/// @see GetBudget()
+void TextureStreamingManager::SetBudget( size_t budget )
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	m_budget = budget;
+}
+
+/// Get the singleton TextureStreamingManager instance.
+///
+/// @return  Pointer to the TextureStreamingManager instance, or null if texture streaming is disabled.
+///
+/// @see Startup(), Shutdown()
+TextureStreamingManager* TextureStreamingManager::GetInstance()
+{
+	return sm_pInstance;
+}
+
+/// Create the singleton TextureStreamingManager instance.
+///
+/// No instance is created if texture streaming is disabled in the graphics configuration.
+///
+/// @see Shutdown(), GetInstance()
+void TextureStreamingManager::Startup()
+{
+	if ( ++g_InitCount == 1 )
+	{
+		Config::Startup();
+
+		HELIUM_ASSERT( !sm_pInstance );
+		sm_pInstance = new TextureStreamingManager;
+		HELIUM_ASSERT( sm_pInstance );
+		if ( !sm_pInstance->Initialize() )
+		{
+			delete sm_pInstance;
+			sm_pInstance = NULL;
+		}
+	}
+}
+
+/// Destroy the singleton TextureStreamingManager instance.
+///
+/// @see Startup(), GetInstance()
+void TextureStreamingManager::Shutdown()
+{
+	if ( --g_InitCount == 0 )
+	{
+		if ( sm_pInstance )
+		{
+			sm_pInstance->Cleanup();
+			delete sm_pInstance;
+			sm_pInstance = NULL;
+		}
+
+		Config::Shutdown();
+	}
+}
+
+/// Get the finest mip level of a texture that is always kept resident.
+///
+/// @param[in] baseLevelWidth   Width of the top mip level of the texture.
+/// @param[in] baseLevelHeight  Height of the top mip level of the texture.
+/// @param[in] mipCount         Number of mip levels in the texture.
+///
+/// @return  Index of the first mip level no larger than MIN_RESIDENT_MIP_SIZE, or the index of the last mip level if
+///          all levels are larger.
+uint32_t TextureStreamingManager::GetMinResidentMipBase(
+	uint32_t baseLevelWidth,
+	uint32_t baseLevelHeight,
+	uint32_t mipCount )
+{
+	uint32_t mipBase = 0;
+	while ( mipBase + 1 < mipCount &&
+		Max( baseLevelWidth >> mipBase, baseLevelHeight >> mipBase ) > MIN_RESIDENT_MIP_SIZE )
+	{
+		++mipBase;
+	}
+
+	return mipBase;
+}
+
+/// Initialize this manager from the graphics configuration.
+///
+/// @return  True if texture streaming is enabled, false if it is disabled or the configuration is missing.
+///
+/// @see Cleanup()
+bool TextureStreamingManager::Initialize()
+{
+	Config* pConfig = Config::GetInstance();
+	if ( !HELIUM_VERIFY( pConfig ) )
+	{
+		return false;
+	}
+
+	StrongPtr< GraphicsConfig > spGraphicsConfig( pConfig->GetConfigObject< GraphicsConfig >( Name( "GraphicsConfig" ) ) );
+	if ( !spGraphicsConfig )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "TextureStreamingManager::Initialize(): Initialization failed; missing GraphicsConfig.\n" );
+		return false;
+	}
+
+	uint32_t budgetMegabytes = spGraphicsConfig->GetTextureStreamingBudget();
+	if ( budgetMegabytes == 0 )
+	{
+		HELIUM_TRACE( TraceLevels::Info, "TextureStreamingManager::Initialize(): Texture streaming disabled.\n" );
+		return false;
+	}
+
+	m_budget = static_cast< size_t >( budgetMegabytes ) << 20;
+
+	return true;
+}
+
+/// Release all streamed texture references.
+///
+/// Any textures still registered keep their currently resident mip levels.
+///
+/// @see Initialize()
+void TextureStreamingManager::Cleanup()
+{
+	MutexScopeLock scopeLock( m_entryLock );
+
+	size_t entryCount = m_entries.GetSize();
+	for ( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		SetInvalid( m_entries[entryIndex].pTexture->m_streamingIndex );
+	}
+
+	m_entries.Clear();
+	m_sortKeys.Clear();
+	m_residentSize = 0;
+	m_pendingStreamCount = 0;
+}
+
+/// Compute the finest mip level of a texture that fits within the remaining budget.
+///
+/// @param[in]     rEntry            Streamed texture entry.
+/// @param[in,out] rRemainingBudget  Budget still available for mip levels above the minimum resident levels of each
+///                                  texture.  This is reduced by the additional memory needed by the returned level.
+///
+/// @return  Finest mip level to keep resident.
+uint32_t TextureStreamingManager::ComputeTargetMipBase( const Entry& rEntry, size_t& rRemainingBudget ) const
+{
+	const Texture2d* pTexture = rEntry.pTexture;
+	HELIUM_ASSERT( pTexture );
+
+	size_t minLevelsSize = pTexture->GetMipLevelsSize( rEntry.minMipBase );
+	for ( uint32_t mipBase = rEntry.wantedMipBase; mipBase < rEntry.minMipBase; ++mipBase )
+	{
+		size_t extraSize = pTexture->GetMipLevelsSize( mipBase ) - minLevelsSize;
+		if ( extraSize <= rRemainingBudget )
+		{
+			rRemainingBudget -= extraSize;
+
+			return mipBase;
+		}
+	}
+
+	return rEntry.minMipBase;
+}
+
+/// Start streaming a texture to its target mip level, if possible.
+///
+/// Nothing is done if the texture is still streaming a previous change or too many textures are already streaming.
+///
+/// @param[in] rEntry  Streamed texture entry.
+void TextureStreamingManager::BeginStreaming( Entry& rEntry )
+{
+	Texture2d* pTexture = rEntry.pTexture;
+	HELIUM_ASSERT( pTexture );
+
+	if ( m_pendingStreamCount >= MAX_PENDING_STREAM_COUNT || pTexture->IsStreamingMips() )
+	{
+		return;
+	}
+
+	if ( pTexture->BeginStreamMips( rEntry.targetMipBase ) )
+	{
+		++m_pendingStreamCount;
+	}
+}
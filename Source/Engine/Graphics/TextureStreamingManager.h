@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+
+namespace Helium
+{
+	class Texture2d;
+
+	/// Manager for streaming texture mip levels in and out of memory within a fixed budget.
+	///
+	/// Streamed textures always keep their lowest-resolution mip levels resident (down from the first level no larger
+	/// than MIN_RESIDENT_MIP_SIZE), and load finer levels only when they are requested for display.  Each frame, the
+	/// graphics scene reports the on-screen size of the textures on visible objects, and Update() grants the requested
+	/// levels to the largest textures on screen first until the memory budget is exhausted.  Textures that have not
+	/// been requested for a while drop back to their minimum resident levels.
+	///
+	/// Texture streaming is disabled entirely if the budget set in the graphics configuration is zero, in which case no
+	/// manager instance is created and all textures are loaded with every mip level resident.
+	class HELIUM_GRAPHICS_API TextureStreamingManager : NonCopyable
+	{
+	public:
+		/// Largest mip level size (width or height, in texels) that is always kept resident.
+		static const uint32_t MIN_RESIDENT_MIP_SIZE = 64;
+		/// Number of frames a texture can go without being requested before its finer mip levels are evicted.
+		static const uint32_t REQUEST_TIMEOUT_FRAME_COUNT = 60;
+		/// Maximum number of textures that can be streaming mip levels at the same time.
+		static const size_t MAX_PENDING_STREAM_COUNT = 8;
+
+		/// @name Texture Registration
+		//@{
+		void RegisterTexture( Texture2d* pTexture );
+		void UnregisterTexture( Texture2d* pTexture );
+		//@}
+
+		/// @name Streaming
+		//@{
+		void RequestTexture( Texture2d* pTexture, float32_t screenSize );
+		void Update();
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline size_t GetBudget() const;
+		void SetBudget( size_t budget );
+
+		inline size_t GetResidentSize() const;
+		//@}
+
+		/// @name Static Access
+		//@{
+		static TextureStreamingManager* GetInstance();
+		static void Startup();
+		static void Shutdown();
+
+		static uint32_t GetMinResidentMipBase( uint32_t baseLevelWidth, uint32_t baseLevelHeight, uint32_t mipCount );
+		//@}
+
+	private:
+		/// Streamed texture information.
+		struct Entry
+		{
+			/// Streamed texture.
+			Texture2d* pTexture;
+			/// Finest mip level requested during the frame of the most recent request.
+			uint32_t requestedMipBase;
+			/// Finest mip level wanted based on recent requests.
+			uint32_t wantedMipBase;
+			/// Finest mip level granted within the budget during the last update.
+			uint32_t targetMipBase;
+			/// Finest mip level that is always kept resident.
+			uint32_t minMipBase;
+			/// Largest on-screen size reported during the frame of the most recent request.
+			float32_t requestedScreenSize;
+			/// Streaming priority (on-screen size of the texture based on recent requests).
+			float32_t priority;
+			/// Index of the frame in which the texture was last requested.
+			uint32_t lastRequestFrame;
+		};
+
+		/// Streamed textures.
+		DynamicArray< Entry > m_entries;
+		/// Streamed texture priority sort keys (scratch space for Update()).
+		DynamicArray< uint64_t > m_sortKeys;
+		/// Lock for synchronizing access to the streamed texture list.
+		Mutex m_entryLock;
+
+		/// Memory budget for streamed textures, in bytes.
+		size_t m_budget;
+		/// Memory used by the resident mip levels of all streamed textures as of the last update, in bytes.
+		size_t m_residentSize;
+		/// Number of textures currently streaming mip levels.
+		size_t m_pendingStreamCount;
+		/// Index of the current frame.
+		uint32_t m_frameIndex;
+
+		/// Singleton instance.
+		static TextureStreamingManager* sm_pInstance;
+
+		/// @name Construction/Destruction
+		//@{
+		TextureStreamingManager();
+		~TextureStreamingManager();
+		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		bool Initialize();
+		void Cleanup();
+
+		uint32_t ComputeTargetMipBase( const Entry& rEntry, size_t& rRemainingBudget ) const;
+		void BeginStreaming( Entry& rEntry );
+		//@}
+	};
+}
+
+#include "Graphics/TextureStreamingManager.inl"
@@ -0,0 +1,25 @@
+namespace Helium
+{
+	/// Get the memory budget for streamed textures.
+	///
+	/// @return  Texture streaming budget, in bytes.
+	///
+	/// @see SetBudget(), GetResidentSize()
+	size_t TextureStreamingManager::GetBudget() const
+	{
+		return m_budget;
+	}
+
+	/// Get the amount of memory used by the resident mip levels of all streamed textures.
+	///
+	/// This is updated during each call to Update(), and includes the minimum resident mip levels of each texture,
+	/// which are kept in memory regardless of the budget.
+	///
+	/// @return  Resident texture size, in bytes.
+	///
+	/// @see GetBudget()
+	size_t TextureStreamingManager::GetResidentSize() const
+	{
+		return m_residentSize;
+	}
+}
@@ -0,0 +1,496 @@
+#include "Precompile.h"
+#include "Graphics/TextureTranscoder.h"
+
+#include "Rendering/RendererUtil.h"
+
+using namespace Helium;
+
+/// BC7 encoding mode parameters.
+struct Bc7Mode
+{
+	/// Number of subsets.
+	uint8_t subsetCount;
+	/// Number of partition selection bits.
+	uint8_t partitionBits;
+	/// Number of channel rotation bits.
+	uint8_t rotationBits;
+	/// Number of index selection bits.
+	uint8_t indexSelectionBits;
+	/// Number of bits per color endpoint channel.
+	uint8_t colorBits;
+	/// Number of bits per alpha endpoint channel (zero if alpha is not stored).
+	uint8_t alphaBits;
+	/// True if each endpoint has its own P-bit.
+	uint8_t bEndpointPBits;
+	/// True if both endpoints of each subset share a P-bit.
+	uint8_t bSharedPBits;
+	/// Number of bits per primary index.
+	uint8_t indexBits;
+	/// Number of bits per secondary index (zero if there is no secondary index set).
+	uint8_t secondaryIndexBits;
+};
+
+/// Parameters of each BC7 mode.
+static const Bc7Mode BC7_MODES[] =
+{
+	{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+	{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+	{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+	{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+	{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+	{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+	{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+	{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+/// Two-subset partitions (one bit per texel, set for texels in the second subset).
+static const uint16_t BC7_PARTITIONS_2[ 64 ] =
+{
+	0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+	0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+	0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+	0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+	0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+	0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+	0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+	0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+};
+
+/// Three-subset partitions (two bits per texel holding the subset index).
+static const uint32_t BC7_PARTITIONS_3[ 64 ] =
+{
+	0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+	0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+	0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+	0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+	0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+	0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+	0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+	0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254,
+};
+
+/// Anchor texel of the second subset of each two-subset partition.
+static const uint8_t BC7_ANCHORS_2[ 64 ] =
+{
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+	15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+	 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+};
+
+/// Anchor texel of the second subset of each three-subset partition.
+static const uint8_t BC7_ANCHORS_3_SECOND[ 64 ] =
+{
+	 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+	 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+	 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+	 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+};
+
+/// Anchor texel of the third subset of each three-subset partition.
+static const uint8_t BC7_ANCHORS_3_THIRD[ 64 ] =
+{
+	15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+	15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+	15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+	15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+};
+
+/// Interpolation weights for 2-bit indices.
+static const uint8_t BC7_WEIGHTS_2[] = { 0, 21, 43, 64 };
+/// Interpolation weights for 3-bit indices.
+static const uint8_t BC7_WEIGHTS_3[] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+/// Interpolation weights for 4-bit indices.
+static const uint8_t BC7_WEIGHTS_4[] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/// Sequential reader of the bits of a 128-bit block, starting with the least-significant bit of the first byte.
+struct BlockBitReader
+{
+	/// Block data.
+	const uint8_t* pData;
+	/// Index of the next bit to read.
+	uint32_t bitOffset;
+
+	/// Read a value from the block.
+	///
+	/// @param[in] bitCount  Number of bits in the value.
+	///
+	/// @return  Value read.
+	uint32_t Read( uint32_t bitCount )
+	{
+		uint32_t value = 0;
+		for( uint32_t bitIndex = 0; bitIndex < bitCount; ++bitIndex, ++bitOffset )
+		{
+			value |= static_cast< uint32_t >( ( pData[ bitOffset >> 3 ] >> ( bitOffset & 7 ) ) & 1 ) << bitIndex;
+		}
+
+		return value;
+	}
+};
+
+/// Get the interpolation weight for a BC7 index.
+///
+/// @param[in] indexBits  Number of bits in the index.
+/// @param[in] index      Index value.
+///
+/// @return  Weight of the second endpoint, out of 64.
+static uint32_t GetBc7Weight( uint32_t indexBits, uint32_t index )
+{
+	if( indexBits == 2 )
+	{
+		return BC7_WEIGHTS_2[ index ];
+	}
+
+	if( indexBits == 3 )
+	{
+		return BC7_WEIGHTS_3[ index ];
+	}
+
+	return BC7_WEIGHTS_4[ index ];
+}
+
+/// Get the format in which to create the render resource for texture data cached in a given format.
+///
+/// @param[in] format        Format of the cached texture data.
+/// @param[in] featureFlags  Feature flags of the active renderer (see Renderer::GetFeatureFlags()).
+///
+/// @return  The cached format if the renderer supports it, or the uncompressed format to which the data should be
+///          transcoded otherwise.
+ERendererPixelFormat TextureTranscoder::GetLoadFormat( ERendererPixelFormat format, uint32_t featureFlags )
+{
+	switch( format )
+	{
+	case RENDERER_PIXEL_FORMAT_BC4:
+		return ( ( featureFlags & RENDERER_FEATURE_FLAG_BC4_BC5 ) ? format : RENDERER_PIXEL_FORMAT_R8 );
+
+	case RENDERER_PIXEL_FORMAT_BC5:
+		return ( ( featureFlags & RENDERER_FEATURE_FLAG_BC4_BC5 ) ? format : RENDERER_PIXEL_FORMAT_R8G8B8A8 );
+
+	case RENDERER_PIXEL_FORMAT_BC7:
+		return ( ( featureFlags & RENDERER_FEATURE_FLAG_BC7 ) ? format : RENDERER_PIXEL_FORMAT_R8G8B8A8 );
+
+	case RENDERER_PIXEL_FORMAT_BC7_SRGB:
+		return ( ( featureFlags & RENDERER_FEATURE_FLAG_BC7 ) ? format : RENDERER_PIXEL_FORMAT_R8G8B8A8_SRGB );
+
+	default:
+		return format;
+	}
+}
+
+/// Decode a mip level of block-compressed data into the format returned by GetLoadFormat().
+///
+/// @param[in]  sourceFormat  Format of the source data (BC4, BC5, or BC7).
+/// @param[in]  pSource       Source data, with block rows tightly packed.
+/// @param[in]  targetFormat  Format of the target data.
+/// @param[out] pTarget       Target data.
+/// @param[in]  targetPitch   Number of bytes between each row of pixels in the target data.
+/// @param[in]  width         Mip level width, in pixels.
+/// @param[in]  height        Mip level height, in pixels.
+///
+/// @return  True if the data was transcoded, false if the source and target formats are not a supported pair.
+bool TextureTranscoder::Transcode(
+	ERendererPixelFormat sourceFormat,
+	const void* pSource,
+	ERendererPixelFormat targetFormat,
+	void* pTarget,
+	size_t targetPitch,
+	uint32_t width,
+	uint32_t height )
+{
+	HELIUM_ASSERT( pSource );
+	HELIUM_ASSERT( pTarget );
+
+	bool bSupported;
+	switch( sourceFormat )
+	{
+	case RENDERER_PIXEL_FORMAT_BC4:
+		bSupported = ( targetFormat == RENDERER_PIXEL_FORMAT_R8 );
+		break;
+
+	case RENDERER_PIXEL_FORMAT_BC5:
+	case RENDERER_PIXEL_FORMAT_BC7:
+		bSupported = ( targetFormat == RENDERER_PIXEL_FORMAT_R8G8B8A8 );
+		break;
+
+	case RENDERER_PIXEL_FORMAT_BC7_SRGB:
+		bSupported = ( targetFormat == RENDERER_PIXEL_FORMAT_R8G8B8A8_SRGB );
+		break;
+
+	default:
+		bSupported = false;
+		break;
+	}
+
+	if( !bSupported )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"TextureTranscoder::Transcode(): Cannot transcode pixel format %d to pixel format %d.\n",
+			static_cast< int >( sourceFormat ),
+			static_cast< int >( targetFormat ) );
+
+		return false;
+	}
+
+	const size_t blockSize = RendererUtil::GetTexture2dMemorySize( 4, 4, 1, sourceFormat );
+	const size_t texelSize = ( targetFormat == RENDERER_PIXEL_FORMAT_R8 ? 1 : 4 );
+	const uint8_t* pBlock = static_cast< const uint8_t* >( pSource );
+
+	uint8_t texels[ 16 * 4 ];
+
+	for( uint32_t blockY = 0; blockY < height; blockY += 4 )
+	{
+		for( uint32_t blockX = 0; blockX < width; blockX += 4, pBlock += blockSize )
+		{
+			switch( sourceFormat )
+			{
+			case RENDERER_PIXEL_FORMAT_BC4:
+				DecodeBc4Block( pBlock, texels, 1 );
+				break;
+
+			case RENDERER_PIXEL_FORMAT_BC5:
+				DecodeBc4Block( pBlock, texels, 4 );
+				DecodeBc4Block( pBlock + 8, texels + 1, 4 );
+				for( size_t texelIndex = 0; texelIndex < 16; ++texelIndex )
+				{
+					texels[ texelIndex * 4 + 2 ] = 0;
+					texels[ texelIndex * 4 + 3 ] = 0xff;
+				}
+
+				break;
+
+			default:
+				DecodeBc7Block( pBlock, texels );
+				break;
+			}
+
+			// Copy the texels within the bounds of the mip level.
+			uint32_t copyWidth = Min< uint32_t >( width - blockX, 4 );
+			uint32_t copyHeight = Min< uint32_t >( height - blockY, 4 );
+			for( uint32_t row = 0; row < copyHeight; ++row )
+			{
+				uint8_t* pTargetRow =
+					static_cast< uint8_t* >( pTarget ) + ( blockY + row ) * targetPitch + blockX * texelSize;
+				MemoryCopy( pTargetRow, texels + row * 4 * texelSize, copyWidth * texelSize );
+			}
+		}
+	}
+
+	return true;
+}
+
+/// Decode a BC4 block (also used for each channel of BC5 blocks).
+///
+/// @param[in]  pBlock   Block data (8 bytes).
+/// @param[out] pValues  Decoded value of each texel, in row-major order.
+/// @param[in]  stride   Number of bytes between each decoded value.
+void TextureTranscoder::DecodeBc4Block( const uint8_t* pBlock, uint8_t* pValues, size_t stride )
+{
+	HELIUM_ASSERT( pBlock );
+	HELIUM_ASSERT( pValues );
+
+	uint32_t endpoint0 = pBlock[ 0 ];
+	uint32_t endpoint1 = pBlock[ 1 ];
+
+	uint8_t palette[ 8 ];
+	palette[ 0 ] = static_cast< uint8_t >( endpoint0 );
+	palette[ 1 ] = static_cast< uint8_t >( endpoint1 );
+	if( endpoint0 > endpoint1 )
+	{
+		for( uint32_t paletteIndex = 1; paletteIndex < 7; ++paletteIndex )
+		{
+			palette[ paletteIndex + 1 ] = static_cast< uint8_t >(
+				( ( 7 - paletteIndex ) * endpoint0 + paletteIndex * endpoint1 ) / 7 );
+		}
+	}
+	else
+	{
+		for( uint32_t paletteIndex = 1; paletteIndex < 5; ++paletteIndex )
+		{
+			palette[ paletteIndex + 1 ] = static_cast< uint8_t >(
+				( ( 5 - paletteIndex ) * endpoint0 + paletteIndex * endpoint1 ) / 5 );
+		}
+
+		palette[ 6 ] = 0;
+		palette[ 7 ] = 0xff;
+	}
+
+	// The 48 bits following the endpoints hold a 3-bit palette index for each texel.
+	uint64_t indices = 0;
+	for( size_t byteIndex = 0; byteIndex < 6; ++byteIndex )
+	{
+		indices |= static_cast< uint64_t >( pBlock[ 2 + byteIndex ] ) << ( byteIndex * 8 );
+	}
+
+	for( size_t texelIndex = 0; texelIndex < 16; ++texelIndex, indices >>= 3 )
+	{
+		pValues[ texelIndex * stride ] = palette[ indices & 7 ];
+	}
+}
+
+/// Decode a BC7 block.
+///
+/// @param[in]  pBlock    Block data (16 bytes).
+/// @param[out] pTexels  Red, green, blue, and alpha bytes of each texel, in row-major order.
+void TextureTranscoder::DecodeBc7Block( const uint8_t* pBlock, uint8_t* pTexels )
+{
+	HELIUM_ASSERT( pBlock );
+	HELIUM_ASSERT( pTexels );
+
+	// The mode is given by the position of the lowest set bit.  Blocks without a mode bit decode to transparent black.
+	uint32_t modeIndex = 0;
+	while( modeIndex < 8 && !( pBlock[ 0 ] & ( 1 << modeIndex ) ) )
+	{
+		++modeIndex;
+	}
+
+	if( modeIndex >= 8 )
+	{
+		MemoryZero( pTexels, 16 * 4 );
+
+		return;
+	}
+
+	const Bc7Mode& rMode = BC7_MODES[ modeIndex ];
+
+	BlockBitReader reader;
+	reader.pData = pBlock;
+	reader.bitOffset = modeIndex + 1;
+
+	uint32_t partition = reader.Read( rMode.partitionBits );
+	uint32_t rotation = reader.Read( rMode.rotationBits );
+	uint32_t indexSelection = reader.Read( rMode.indexSelectionBits );
+
+	// Endpoints are stored channel by channel, followed by their P-bits.
+	uint32_t endpointCount = rMode.subsetCount * 2u;
+	uint32_t endpoints[ 6 ][ 4 ];
+	for( uint32_t channel = 0; channel < 3; ++channel )
+	{
+		for( uint32_t endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex )
+		{
+			endpoints[ endpointIndex ][ channel ] = reader.Read( rMode.colorBits );
+		}
+	}
+
+	for( uint32_t endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex )
+	{
+		endpoints[ endpointIndex ][ 3 ] = reader.Read( rMode.alphaBits );
+	}
+
+	uint32_t pBits[ 6 ] = { 0, 0, 0, 0, 0, 0 };
+	if( rMode.bEndpointPBits )
+	{
+		for( uint32_t endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex )
+		{
+			pBits[ endpointIndex ] = reader.Read( 1 );
+		}
+	}
+	else if( rMode.bSharedPBits )
+	{
+		for( uint32_t subsetIndex = 0; subsetIndex < rMode.subsetCount; ++subsetIndex )
+		{
+			pBits[ subsetIndex * 2 ] = pBits[ subsetIndex * 2 + 1 ] = reader.Read( 1 );
+		}
+	}
+
+	// Expand each endpoint channel to 8 bits by appending its P-bit and replicating its high bits.
+	bool bHasPBits = ( rMode.bEndpointPBits || rMode.bSharedPBits );
+	for( uint32_t endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex )
+	{
+		for( uint32_t channel = 0; channel < 4; ++channel )
+		{
+			uint32_t bitCount = ( channel < 3 ? rMode.colorBits : rMode.alphaBits );
+			if( bitCount == 0 )
+			{
+				endpoints[ endpointIndex ][ channel ] = 0xff;
+
+				continue;
+			}
+
+			uint32_t value = endpoints[ endpointIndex ][ channel ];
+			if( bHasPBits )
+			{
+				value = ( value << 1 ) | pBits[ endpointIndex ];
+				++bitCount;
+			}
+
+			value <<= ( 8 - bitCount );
+			endpoints[ endpointIndex ][ channel ] = value | ( value >> bitCount );
+		}
+	}
+
+	// Read the indices.  The anchor texel of each subset has its index stored with one bit fewer.
+	uint8_t subsets[ 16 ];
+	uint8_t primaryIndices[ 16 ];
+	uint8_t secondaryIndices[ 16 ];
+	for( uint32_t texelIndex = 0; texelIndex < 16; ++texelIndex )
+	{
+		bool bAnchor = ( texelIndex == 0 );
+		if( rMode.subsetCount == 1 )
+		{
+			subsets[ texelIndex ] = 0;
+		}
+		else if( rMode.subsetCount == 2 )
+		{
+			subsets[ texelIndex ] = static_cast< uint8_t >( ( BC7_PARTITIONS_2[ partition ] >> texelIndex ) & 1 );
+			bAnchor |= ( texelIndex == BC7_ANCHORS_2[ partition ] );
+		}
+		else
+		{
+			subsets[ texelIndex ] = static_cast< uint8_t >( ( BC7_PARTITIONS_3[ partition ] >> ( texelIndex * 2 ) ) & 3 );
+			bAnchor |= ( texelIndex == BC7_ANCHORS_3_SECOND[ partition ] || texelIndex == BC7_ANCHORS_3_THIRD[ partition ] );
+		}
+
+		primaryIndices[ texelIndex ] = static_cast< uint8_t >( reader.Read( rMode.indexBits - ( bAnchor ? 1 : 0 ) ) );
+	}
+
+	if( rMode.secondaryIndexBits )
+	{
+		for( uint32_t texelIndex = 0; texelIndex < 16; ++texelIndex )
+		{
+			secondaryIndices[ texelIndex ] = static_cast< uint8_t >(
+				reader.Read( rMode.secondaryIndexBits - ( texelIndex == 0 ? 1 : 0 ) ) );
+		}
+	}
+
+	// Interpolate each texel.  Modes with two index sets use one for color and the other for alpha.
+	for( uint32_t texelIndex = 0; texelIndex < 16; ++texelIndex )
+	{
+		const uint32_t* pEndpoint0 = endpoints[ subsets[ texelIndex ] * 2 ];
+		const uint32_t* pEndpoint1 = endpoints[ subsets[ texelIndex ] * 2 + 1 ];
+
+		uint32_t colorWeight;
+		uint32_t alphaWeight;
+		if( !rMode.secondaryIndexBits )
+		{
+			colorWeight = GetBc7Weight( rMode.indexBits, primaryIndices[ texelIndex ] );
+			alphaWeight = colorWeight;
+		}
+		else if( indexSelection )
+		{
+			colorWeight = GetBc7Weight( rMode.secondaryIndexBits, secondaryIndices[ texelIndex ] );
+			alphaWeight = GetBc7Weight( rMode.indexBits, primaryIndices[ texelIndex ] );
+		}
+		else
+		{
+			colorWeight = GetBc7Weight( rMode.indexBits, primaryIndices[ texelIndex ] );
+			alphaWeight = GetBc7Weight( rMode.secondaryIndexBits, secondaryIndices[ texelIndex ] );
+		}
+
+		uint8_t* pTexel = pTexels + texelIndex * 4;
+		for( uint32_t channel = 0; channel < 4; ++channel )
+		{
+			uint32_t weight = ( channel < 3 ? colorWeight : alphaWeight );
+			pTexel[ channel ] = static_cast< uint8_t >(
+				( ( 64 - weight ) * pEndpoint0[ channel ] + weight * pEndpoint1[ channel ] + 32 ) >> 6 );
+		}
+
+		// Rotation swaps alpha with one of the color channels.
+		if( rotation != 0 )
+		{
+			uint8_t alpha = pTexel[ 3 ];
+			pTexel[ 3 ] = pTexel[ rotation - 1 ];
+			pTexel[ rotation - 1 ] = alpha;
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Graphics/Graphics.h"
+#include "Rendering/RendererTypes.h"
+
+namespace Helium
+{
+	/// Load-time transcoding of cached texture data into formats supported by the active renderer.
+	///
+	/// Textures are cached in the most compact format chosen for them (i.e. BC5 for high-quality normal maps, BC7 for
+	/// high-quality color), regardless of the hardware on which they will be used.  When a texture is loaded on a
+	/// renderer that cannot sample its cached format, GetLoadFormat() picks the format to create the render resource
+	/// with instead, and Transcode() decodes each cached mip level into it.
+	///
+	/// Decoded data uses the byte order of the uncompressed formats: one byte per texel for R8, and red, green, blue,
+	/// and alpha bytes for R8G8B8A8.  BC5 data is decoded with blue set to zero and alpha set to one, which normal map
+	/// unpacking in the shaders handles the same way as the compressed data.
+	class HELIUM_GRAPHICS_API TextureTranscoder
+	{
+	public:
+		/// @name Format Selection
+		//@{
+		static ERendererPixelFormat GetLoadFormat( ERendererPixelFormat format, uint32_t featureFlags );
+		//@}
+
+		/// @name Transcoding
+		//@{
+		static bool Transcode(
+			ERendererPixelFormat sourceFormat, const void* pSource, ERendererPixelFormat targetFormat, void* pTarget,
+			size_t targetPitch, uint32_t width, uint32_t height );
+		//@}
+
+	private:
+		/// @name Private Utility Functions
+		//@{
+		static void DecodeBc4Block( const uint8_t* pBlock, uint8_t* pValues, size_t stride );
+		static void DecodeBc7Block( const uint8_t* pBlock, uint8_t* pTexels );
+		//@}
+	};
+}
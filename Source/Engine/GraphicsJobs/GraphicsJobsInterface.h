@@ -26,6 +26,9 @@ public:
         const GraphicsSceneObject::SubMeshData* pSubMeshes;
         /// [in] Array of buffers in which to store the constant buffer data for each sub-mesh.
         float32_t* const* ppSubMeshConstantBufferData;
+        /// [in] Array of buffers in which to store the packed skinning matrices of each scene object (null entries
+        ///      for objects that are not skinned).
+        float32_t* const* ppSkinningMatrixData;
 
         /// @name Construction/Destruction
         //@{
@@ -69,6 +72,9 @@ public:
         const GraphicsSceneObject* pSceneObjects;
         /// [out] Array of buffers in which to store the constant buffer data for each scene object.
         float32_t* const* ppConstantBufferData;
+        /// [out] Array of buffers in which to store the packed skinning matrices of each scene object (null entries
+        ///       are skipped).
+        float32_t* const* ppSkinningMatrixData;
 
         /// @name Construction/Destruction
         //@{
@@ -114,6 +120,8 @@ public:
         const GraphicsSceneObject* pSceneObjects;
         /// [out] Array of buffers in which to store the constant buffer data for each sub-mesh.
         float32_t* const* ppConstantBufferData;
+        /// [in] Array of packed skinning matrices of each graphics scene object.
+        float32_t* const* ppSkinningMatrixData;
 
         /// @name Construction/Destruction
         //@{
@@ -157,6 +165,9 @@ public:
         const GraphicsSceneObject* pSceneObjects;
         /// [out] Array of buffers in which to store the constant buffer data for each scene object.
         float32_t* const* ppConstantBufferData;
+        /// [out] Array of buffers in which to store the packed skinning matrices of each scene object (null entries
+        ///       are skipped).
+        float32_t* const* ppSkinningMatrixData;
 
         /// @name Construction/Destruction
         //@{
@@ -202,6 +213,8 @@ public:
         const GraphicsSceneObject* pSceneObjects;
         /// [out] Array of buffers in which to store the constant buffer data for each sub-mesh.
         float32_t* const* ppConstantBufferData;
+        /// [in] Array of packed skinning matrices of each graphics scene object.
+        float32_t* const* ppSkinningMatrixData;
 
         /// @name Construction/Destruction
         //@{
@@ -1,6 +1,8 @@
 #include "Precompile.h"
 #include "GraphicsJobs/GraphicsJobsInterface.h"
 
+#include "EngineJobs/JobManager.h"
+
 /// Maximum number of jobs to spawn at once for scene instance buffer updates.
 #define GRAPHICS_SCENE_INSTANCE_UPDATE_JOB_MAX 128
 
@@ -11,14 +13,24 @@ using namespace Helium;
 /// @param[in] pContext  Context in which this job is running.
 void UpdateGraphicsSceneConstantBuffersJobSpawner::Run()
 {
+	// Sub-mesh palettes are gathered from the skinning matrices computed by the scene object updates, so the object
+	// updates need to finish first.
 	{
-		// NOTE: These were running in parallel, but now synchronous since we're removing tbb
+		JobCounter counter;
+
 		UpdateGraphicsSceneObjectBuffersJobSpawner objectJob;
 		UpdateGraphicsSceneObjectBuffersJobSpawner::Parameters& rObjectParameters = objectJob.GetParameters();
 		rObjectParameters.sceneObjectCount = m_parameters.sceneObjectCount;
 		rObjectParameters.pSceneObjects = m_parameters.pSceneObjects;
 		rObjectParameters.ppConstantBufferData = m_parameters.ppSceneObjectConstantBufferData;
-		objectJob.Run();
+		rObjectParameters.ppSkinningMatrixData = m_parameters.ppSkinningMatrixData;
+		JobManager::SpawnOrRun( &objectJob, counter );
+
+		JobManager::WaitOrReturn( counter );
+	}
+
+	{
+		JobCounter counter;
 
 		UpdateGraphicsSceneSubMeshBuffersJobSpawner subMeshJob;
 		UpdateGraphicsSceneSubMeshBuffersJobSpawner::Parameters& rSubMeshParameters = subMeshJob.GetParameters();
@@ -26,6 +38,9 @@ void UpdateGraphicsSceneConstantBuffersJobSpawner::Run()
 		rSubMeshParameters.pSubMeshes = m_parameters.pSubMeshes;
 		rSubMeshParameters.pSceneObjects = m_parameters.pSceneObjects;
 		rSubMeshParameters.ppConstantBufferData = m_parameters.ppSubMeshConstantBufferData;
-		subMeshJob.Run();
+		rSubMeshParameters.ppSkinningMatrixData = m_parameters.ppSkinningMatrixData;
+		JobManager::SpawnOrRun( &subMeshJob, counter );
+
+		JobManager::WaitOrReturn( counter );
 	}
 }
@@ -3,6 +3,10 @@
 
 #include "GraphicsTypes/VertexTypes.h"
 
+#if HELIUM_USE_GRANNY_ANIMATION
+#include "GrannySceneObjectInterface.h"
+#endif
+
 namespace Helium
 {
     /// Update the instance buffer data for a set of graphics scene objects.
@@ -16,34 +20,100 @@ namespace Helium
         float32_t* const* ppConstantBufferData = m_parameters.ppConstantBufferData;
         HELIUM_ASSERT( ppConstantBufferData );
 
+        float32_t* const* ppSkinningMatrixData = m_parameters.ppSkinningMatrixData;
+        HELIUM_ASSERT( ppSkinningMatrixData );
+
         uint_fast32_t sceneObjectCount = m_parameters.sceneObjectCount;
         for( uint_fast32_t sceneObjectIndex = 0;
              sceneObjectIndex < sceneObjectCount;
-             ++sceneObjectIndex, ++pSceneObjects, ++ppConstantBufferData )
+             ++sceneObjectIndex, ++pSceneObjects, ++ppConstantBufferData, ++ppSkinningMatrixData )
         {
+            const GraphicsSceneObject& rSceneObject = *pSceneObjects;
+
             float32_t* pConstantBuffer = *ppConstantBufferData;
-            if( !pConstantBuffer )
+            if( pConstantBuffer )
+            {
+                const Simd::Matrix44& rTransform = rSceneObject.GetTransform();
+
+                // Transpose the matrix when loading into the constant buffer for proper interpretation by the shader.
+                *( pConstantBuffer++ ) = rTransform.GetElement( 0 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 4 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 8 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 12 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 1 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 5 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 9 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 13 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 2 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 6 );
+                *( pConstantBuffer++ ) = rTransform.GetElement( 10 );
+                *pConstantBuffer       = rTransform.GetElement( 14 );
+            }
+
+            float32_t* pSkinningMatrix43 = *ppSkinningMatrixData;
+            if( !pSkinningMatrix43 )
             {
                 continue;
             }
 
-            const GraphicsSceneObject& rSceneObject = *pSceneObjects;
+            // Compute the skinning matrix of each bone once, packed as transposed 3x4 matrices, so that sub-meshes
+            // only need to gather them into their palettes.
+            const Simd::Matrix44* pBonePalette = rSceneObject.GetBonePalette();
+            HELIUM_ASSERT( pBonePalette );
 
-            const Simd::Matrix44& rTransform = rSceneObject.GetTransform();
-
-            // Transpose the matrix when loading into the constant buffer for proper interpretation by the shader.
-            *( pConstantBuffer++ ) = rTransform.GetElement( 0 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 4 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 8 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 12 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 1 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 5 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 9 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 13 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 2 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 6 );
-            *( pConstantBuffer++ ) = rTransform.GetElement( 10 );
-            *pConstantBuffer       = rTransform.GetElement( 14 );
+#if HELIUM_USE_GRANNY_ANIMATION
+            const void* pBoneData = rSceneObject.GetBoneData();
+            HELIUM_ASSERT( pBoneData );
+
+            Simd::Matrix44 inverseBoneReferencePose;
+#else
+            const Simd::Matrix44* pInverseReferencePose = rSceneObject.GetInverseReferencePose();
+            HELIUM_ASSERT( pInverseReferencePose );
+#endif
+
+            // Skinning matrices are computed in small batches so that the matrix products can be done with a single
+            // array multiply without needing a full-size temporary palette.
+            static const uint_fast32_t SKINNING_BATCH_SIZE = 16;
+            Simd::Matrix44 skinningMatrices[ SKINNING_BATCH_SIZE ];
+
+            uint_fast32_t boneCount = rSceneObject.GetBoneCount();
+            for( uint_fast32_t batchStart = 0; batchStart < boneCount; batchStart += SKINNING_BATCH_SIZE )
+            {
+                uint_fast32_t batchCount = Min( boneCount - batchStart, SKINNING_BATCH_SIZE );
+
+#if HELIUM_USE_GRANNY_ANIMATION
+                for( uint_fast32_t batchIndex = 0; batchIndex < batchCount; ++batchIndex )
+                {
+                    Granny::GetInverseBoneReferencePose(
+                        inverseBoneReferencePose, pBoneData, static_cast< uint_fast8_t >( batchStart + batchIndex ) );
+                    skinningMatrices[ batchIndex ].MultiplySet( inverseBoneReferencePose, pBonePalette[ batchStart + batchIndex ] );
+                }
+#else
+                Simd::Matrix44::MultiplyArray(
+                    pInverseReferencePose + batchStart,
+                    pBonePalette + batchStart,
+                    skinningMatrices,
+                    batchCount );
+#endif
+
+                for( uint_fast32_t batchIndex = 0; batchIndex < batchCount; ++batchIndex )
+                {
+                    const Simd::Matrix44& rSkinningMatrix = skinningMatrices[ batchIndex ];
+
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 0 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 4 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 8 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 12 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 1 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 5 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 9 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 13 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 2 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 6 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 10 );
+                    *( pSkinningMatrix43++ ) = rSkinningMatrix.GetElement( 14 );
+                }
+            }
         }
     }
 }
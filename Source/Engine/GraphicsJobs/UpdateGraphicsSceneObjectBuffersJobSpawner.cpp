@@ -1,6 +1,8 @@
 #include "Precompile.h"
 #include "GraphicsJobs/GraphicsJobsInterface.h"
 
+#include "EngineJobs/JobManager.h"
+
 /// Maximum number of child jobs to spawn at once.
 static const uint_fast32_t SCENE_OBJECT_CHILD_JOB_MAX = 128;
 /// Maximum number of graphics scene objects to update in each child job.
@@ -15,6 +17,7 @@ void UpdateGraphicsSceneObjectBuffersJobSpawner::Run()
 
     const GraphicsSceneObject* pSceneObjects = m_parameters.pSceneObjects;
     float32_t* const* ppConstantBufferData = m_parameters.ppConstantBufferData;
+    float32_t* const* ppSkinningMatrixData = m_parameters.ppSkinningMatrixData;
 
     uint_fast32_t sceneObjectCount = m_parameters.sceneObjectCount;
 
@@ -26,33 +29,40 @@ void UpdateGraphicsSceneObjectBuffersJobSpawner::Run()
     }
 
     {
+        UpdateGraphicsSceneObjectBuffersJob childJobs[ SCENE_OBJECT_CHILD_JOB_MAX ];
+        JobCounter counter;
+
         for( uint_fast32_t jobIndex = 0; jobIndex < jobCount; ++jobIndex )
         {
             uint_fast32_t jobObjectCount = Min( sceneObjectCount, SCENE_OBJECT_CHILD_JOB_OBJECT_COUNT_MAX );
             HELIUM_ASSERT( jobObjectCount != 0 );
             sceneObjectCount -= jobObjectCount;
 
-			// NOTE: These were run in parallel but now synchronous since TBB has been removed
-			UpdateGraphicsSceneObjectBuffersJob job;
-            UpdateGraphicsSceneObjectBuffersJob::Parameters& rParameters = job.GetParameters();
+            UpdateGraphicsSceneObjectBuffersJob& rJob = childJobs[ jobIndex ];
+            UpdateGraphicsSceneObjectBuffersJob::Parameters& rParameters = rJob.GetParameters();
             rParameters.sceneObjectCount = static_cast< uint32_t >( jobObjectCount );
             rParameters.pSceneObjects = pSceneObjects;
             rParameters.ppConstantBufferData = ppConstantBufferData;
-			job.Run();
+            rParameters.ppSkinningMatrixData = ppSkinningMatrixData;
+            JobManager::SpawnOrRun( &rJob, counter );
 
             pSceneObjects += jobObjectCount;
             ppConstantBufferData += jobObjectCount;
+            ppSkinningMatrixData += jobObjectCount;
         }
 
-		// This was a continuation task but now just exectues inline here since TBB was removed
+        // Continue with any remaining objects while the child jobs run.
         if( sceneObjectCount != 0 )
         {
-			UpdateGraphicsSceneObjectBuffersJobSpawner job;
+            UpdateGraphicsSceneObjectBuffersJobSpawner job;
             UpdateGraphicsSceneObjectBuffersJobSpawner::Parameters& rParameters = job.GetParameters();
             rParameters.sceneObjectCount = sceneObjectCount;
             rParameters.pSceneObjects = pSceneObjects;
             rParameters.ppConstantBufferData = ppConstantBufferData;
-			job.Run();
+            rParameters.ppSkinningMatrixData = ppSkinningMatrixData;
+            job.Run();
         }
+
+        JobManager::WaitOrReturn( counter );
     }
 }
@@ -1,6 +1,8 @@
 #include "Precompile.h"
 #include "GraphicsJobs/GraphicsJobsInterface.h"
 
+#include "EngineJobs/JobManager.h"
+
 /// Maximum number of child jobs to spawn at once.
 static const uint_fast32_t SUB_MESH_CHILD_JOB_MAX = 128;
 /// Maximum number of sub-meshes to update in each child job.
@@ -15,6 +17,7 @@ void UpdateGraphicsSceneSubMeshBuffersJobSpawner::Run()
 {
     const GraphicsSceneObject::SubMeshData* pSubMeshes = m_parameters.pSubMeshes;
     float32_t* const* ppConstantBufferData = m_parameters.ppConstantBufferData;
+    float32_t* const* ppSkinningMatrixData = m_parameters.ppSkinningMatrixData;
 
     const GraphicsSceneObject* pSceneObjects = m_parameters.pSceneObjects;
 
@@ -28,36 +31,41 @@ void UpdateGraphicsSceneSubMeshBuffersJobSpawner::Run()
     }
 
     {
+        UpdateGraphicsSceneSubMeshBuffersJob childJobs[ SUB_MESH_CHILD_JOB_MAX ];
+        JobCounter counter;
+
         for( uint_fast32_t jobIndex = 0; jobIndex < jobCount; ++jobIndex )
         {
-			// These were all in parallel but TBB was removed
             uint_fast32_t jobObjectCount = Min( subMeshCount, SUB_MESH_CHILD_JOB_OBJECT_COUNT_MAX );
             HELIUM_ASSERT( jobObjectCount != 0 );
             subMeshCount -= jobObjectCount;
 
-			UpdateGraphicsSceneSubMeshBuffersJob job;
-            UpdateGraphicsSceneSubMeshBuffersJob::Parameters& rParameters = job.GetParameters();
+            UpdateGraphicsSceneSubMeshBuffersJob& rJob = childJobs[ jobIndex ];
+            UpdateGraphicsSceneSubMeshBuffersJob::Parameters& rParameters = rJob.GetParameters();
             rParameters.subMeshCount = static_cast< uint32_t >( jobObjectCount );
             rParameters.pSubMeshes = pSubMeshes;
             rParameters.pSceneObjects = pSceneObjects;
             rParameters.ppConstantBufferData = ppConstantBufferData;
-			job.Run();
+            rParameters.ppSkinningMatrixData = ppSkinningMatrixData;
+            JobManager::SpawnOrRun( &rJob, counter );
 
             pSubMeshes += jobObjectCount;
             ppConstantBufferData += jobObjectCount;
         }
 
+        // Continue with any remaining sub-meshes while the child jobs run.
         if( subMeshCount != 0 )
         {
-			// NOTE: This was a continuation job from above but is now inline since TBB was removed
-			UpdateGraphicsSceneSubMeshBuffersJobSpawner job;
-            UpdateGraphicsSceneSubMeshBuffersJobSpawner::Parameters& rParameters =
-                job.GetParameters();
+            UpdateGraphicsSceneSubMeshBuffersJobSpawner job;
+            UpdateGraphicsSceneSubMeshBuffersJobSpawner::Parameters& rParameters = job.GetParameters();
             rParameters.subMeshCount = subMeshCount;
             rParameters.pSubMeshes = pSubMeshes;
             rParameters.pSceneObjects = pSceneObjects;
             rParameters.ppConstantBufferData = ppConstantBufferData;
-			job.Run();
+            rParameters.ppSkinningMatrixData = ppSkinningMatrixData;
+            job.Run();
         }
+
+        JobManager::WaitOrReturn( counter );
     }
 }
@@ -0,0 +1,89 @@
+#include "Precompile.h"
+#include "GraphicsTypes/GraphicsSceneLight.h"
+
+using namespace Helium;
+
+/// Constructor.
+GraphicsSceneLight::GraphicsSceneLight()
+: m_position( 0.0f, 0.0f, 0.0f )
+, m_direction( 0.0f, 0.0f, 1.0f )
+, m_color( 0xffffffff )
+, m_brightness( 1.0f )
+, m_radius( 1.0f )
+, m_spotInnerAngle( 0.5235988f )
+, m_spotOuterAngle( 0.7853982f )
+, m_type( static_cast< uint8_t >( TYPE_POINT ) )
+{
+}
+
+/// Set the light type.
+///
+/// @param[in] type  Light type.
+///
+/// @see GetType()
+void GraphicsSceneLight::SetType( EType type )
+{
+    HELIUM_ASSERT( static_cast< size_t >( type ) < static_cast< size_t >( TYPE_MAX ) );
+
+    m_type = static_cast< uint8_t >( type );
+}
+
+/// Set the world-space light position.
+///
+/// @param[in] rPosition  Light position.
+///
+/// @see GetPosition()
+void GraphicsSceneLight::SetPosition( const Simd::Vector3& rPosition )
+{
+    m_position = rPosition;
+}
+
+/// Set the world-space direction in which a spot light is pointing.
+///
+/// @param[in] rDirection  Light direction (does not need to be normalized).
+///
+/// @see GetDirection()
+void GraphicsSceneLight::SetDirection( const Simd::Vector3& rDirection )
+{
+    m_direction = rDirection;
+    m_direction.Normalize();
+}
+
+/// Set the light color.
+///
+/// @param[in] rColor      Light color.
+/// @param[in] brightness  Light brightness factor.
+///
+/// @see GetColor(), GetBrightness()
+void GraphicsSceneLight::SetColor( const Color& rColor, float32_t brightness )
+{
+    m_color = rColor;
+    m_brightness = brightness;
+}
+
+/// Set the distance at which the light attenuates to zero.
+///
+/// @param[in] radius  Light radius.
+///
+/// @see GetRadius()
+void GraphicsSceneLight::SetRadius( float32_t radius )
+{
+    HELIUM_ASSERT( radius > 0.0f );
+
+    m_radius = radius;
+}
+
+/// Set the cone angles of a spot light.
+///
+/// @param[in] innerAngle  Angle from the light direction within which the light is at full intensity, in radians.
+/// @param[in] outerAngle  Angle from the light direction beyond which the light has no effect, in radians.
+///
+/// @see GetSpotInnerAngle(), GetSpotOuterAngle()
+void GraphicsSceneLight::SetSpotAngles( float32_t innerAngle, float32_t outerAngle )
+{
+    HELIUM_ASSERT( innerAngle >= 0.0f );
+    HELIUM_ASSERT( outerAngle >= innerAngle );
+
+    m_spotInnerAngle = innerAngle;
+    m_spotOuterAngle = outerAngle;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "GraphicsTypes/GraphicsTypes.h"
+
+#include "MathSimd/Vector3.h"
+#include "Math/Color.h"
+
+namespace Helium
+{
+    /// Information related to a single dynamic point or spot light attached to the graphics scene.
+    ///
+    /// Each frame, the lights affecting each scene view are assigned to the clusters of a view-space grid (see
+    /// ClusteredLightGrid), and the base pass shaders only evaluate the lights assigned to the cluster containing each
+    /// pixel.
+    HELIUM_SIMD_ALIGN_PRE class HELIUM_GRAPHICS_TYPES_API GraphicsSceneLight
+    {
+    public:
+        /// Light types.
+        enum EType
+        {
+            TYPE_FIRST   =  0,
+            TYPE_INVALID = -1,
+
+            /// Omnidirectional light.
+            TYPE_POINT,
+            /// Light restricted to a cone along its direction.
+            TYPE_SPOT,
+
+            TYPE_MAX,
+            TYPE_LAST = TYPE_MAX - 1
+        };
+
+        /// @name Construction/Destruction
+        //@{
+        GraphicsSceneLight();
+        //@}
+
+        /// @name Data Access
+        //@{
+        void SetType( EType type );
+        void SetPosition( const Simd::Vector3& rPosition );
+        void SetDirection( const Simd::Vector3& rDirection );
+        void SetColor( const Color& rColor, float32_t brightness );
+        void SetRadius( float32_t radius );
+        void SetSpotAngles( float32_t innerAngle, float32_t outerAngle );
+
+        inline EType GetType() const;
+        inline const Simd::Vector3& GetPosition() const;
+        inline const Simd::Vector3& GetDirection() const;
+        inline const Color& GetColor() const;
+        inline float32_t GetBrightness() const;
+        inline float32_t GetRadius() const;
+        inline float32_t GetSpotInnerAngle() const;
+        inline float32_t GetSpotOuterAngle() const;
+        //@}
+
+    private:
+        /// World-space light position.
+        Simd::Vector3 m_position;
+        /// World-space light direction (spot lights only).
+        Simd::Vector3 m_direction;
+
+        /// Light color.
+        Color m_color;
+        /// Light brightness factor.
+        float32_t m_brightness;
+        /// Distance at which the light attenuates to zero.
+        float32_t m_radius;
+
+        /// Angle from the spot light direction within which the light is at full intensity, in radians.
+        float32_t m_spotInnerAngle;
+        /// Angle from the spot light direction beyond which the light has no effect, in radians.
+        float32_t m_spotOuterAngle;
+
+        /// Light type.
+        uint8_t m_type;
+    } HELIUM_SIMD_ALIGN_POST;
+}
+
+#include "GraphicsTypes/GraphicsSceneLight.inl"
@@ -0,0 +1,82 @@
+namespace Helium
+{
+    /// Get the light type.
+    ///
+    /// @return  Light type.
+    ///
+    /// @see SetType()
+    GraphicsSceneLight::EType GraphicsSceneLight::GetType() const
+    {
+        return static_cast< EType >( m_type );
+    }
+
+    /// Get the world-space light position.
+    ///
+    /// @return  Light position.
+    ///
+    /// @see SetPosition()
+    const Simd::Vector3& GraphicsSceneLight::GetPosition() const
+    {
+        return m_position;
+    }
+
+    /// Get the world-space direction in which a spot light is pointing.
+    ///
+    /// @return  Normalized light direction.
+    ///
+    /// @see SetDirection()
+    const Simd::Vector3& GraphicsSceneLight::GetDirection() const
+    {
+        return m_direction;
+    }
+
+    /// Get the light color.
+    ///
+    /// @return  Light color.
+    ///
+    /// @see SetColor(), GetBrightness()
+    const Color& GraphicsSceneLight::GetColor() const
+    {
+        return m_color;
+    }
+
+    /// Get the light brightness factor.
+    ///
+    /// @return  Light brightness.
+    ///
+    /// @see SetColor(), GetColor()
+    float32_t GraphicsSceneLight::GetBrightness() const
+    {
+        return m_brightness;
+    }
+
+    /// Get the distance at which the light attenuates to zero.
+    ///
+    /// @return  Light radius.
+    ///
+    /// @see SetRadius()
+    float32_t GraphicsSceneLight::GetRadius() const
+    {
+        return m_radius;
+    }
+
+    /// Get the angle from the direction of a spot light within which the light is at full intensity.
+    ///
+    /// @return  Spot light inner cone angle, in radians.
+    ///
+    /// @see SetSpotAngles(), GetSpotOuterAngle()
+    float32_t GraphicsSceneLight::GetSpotInnerAngle() const
+    {
+        return m_spotInnerAngle;
+    }
+
+    /// Get the angle from the direction of a spot light beyond which the light has no effect.
+    ///
+    /// @return  Spot light outer cone angle, in radians.
+    ///
+    /// @see SetSpotAngles(), GetSpotInnerAngle()
+    float32_t GraphicsSceneLight::GetSpotOuterAngle() const
+    {
+        return m_spotOuterAngle;
+    }
+}
@@ -1,6 +1,8 @@
 #include "Precompile.h"
 #include "GraphicsTypes/GraphicsSceneObject.h"
 
+#include "GraphicsTypes/VisibilityGrid.h"
+
 #include "Rendering/RIndexBuffer.h"
 #include "Rendering/RVertexBuffer.h"
 #include "Rendering/RVertexDescription.h"
@@ -16,31 +18,93 @@ GraphicsSceneObject::GraphicsSceneObject()
 : m_pInverseReferencePose( NULL )
 #endif
 , m_pBonePalette( NULL )
+, m_pLodScreenSizes( NULL )
+, m_pVisibilityGrid( NULL )
+, m_visibilityId( Invalid< size_t >() )
 , m_vertexStride( 0 )
 , m_boneCount( 0 )
+, m_lodCount( 1 )
 , m_updateMode( static_cast< uint8_t >( UPDATE_INVALID ) )
+, m_bTransformDirty( true )
+, m_bOccluder( false )
+{
+}
+
+/// Set the visibility grid to keep up to date with the world bounds of this instance.
+///
+/// @param[in] pGrid  Visibility grid to update whenever the world bounds are set, or null to stop updating.
+/// @param[in] id     ID of this instance in the visibility grid.
+///
+/// @see SetWorldBounds()
+void GraphicsSceneObject::SetVisibilityGrid( VisibilityGrid* pGrid, size_t id )
 {
+    m_pVisibilityGrid = pGrid;
+    m_visibilityId = id;
 }
 
 /// Set the instance transform matrix.
 ///
 /// @param[in] rTransform  Transform matrix to set.
 ///
-/// @see GetTransform()
+/// @see GetTransform(), GetTransformDirty()
 void GraphicsSceneObject::SetTransform( const Simd::Matrix44& rTransform )
 {
     m_transform = rTransform;
+    m_bTransformDirty = true;
 }
 
 /// Set the world-space axis-aligned bounding box for this instance.
 ///
 /// @param[in] rBox  World-space axis-aligned bounding box to set.
 ///
-/// @see GetWorldBox(), GetWorldSphere()
+/// @see GetWorldBox(), GetWorldSphere(), SetVisibilityGrid()
 void GraphicsSceneObject::SetWorldBounds( const Simd::AaBox& rBox )
 {
     m_worldBox = rBox;
     m_worldSphere.Set( rBox );
+
+    if( m_pVisibilityGrid )
+    {
+        m_pVisibilityGrid->Update( m_visibilityId, rBox );
+    }
+}
+
+/// Set the box used to occlude other objects behind this instance.
+///
+/// The box must lie entirely inside of the solid geometry of this instance (for example, the inner volume of a wall or
+/// building), as objects hidden behind it are culled from the view.
+///
+/// @param[in] pLocalBox  Occluder box in the local space of this instance, or null if this instance should not
+///                       occlude other objects.
+///
+/// @see GetOccluderBox()
+void GraphicsSceneObject::SetOccluderBox( const Simd::AaBox* pLocalBox )
+{
+    m_bOccluder = ( pLocalBox != NULL );
+    if( pLocalBox )
+    {
+        m_occluderBox = *pLocalBox;
+    }
+}
+
+/// Set the levels of detail of this instance.
+///
+/// The level of detail is selected separately for each view from the projected size of this instance, and the
+/// sub-meshes of this instance draw the matching index buffer range set with SubMeshData::SetLodIndexRanges().  The
+/// screen size array must remain valid for as long as it is set.
+///
+/// @param[in] pScreenSizes  Projected size, in pixels, below which each level of detail past the first is used
+///                          (lodCount minus one entries, in decreasing order), or null if lodCount is one.
+/// @param[in] lodCount      Number of levels of detail.
+///
+/// @see GetLodCount(), GetLodScreenSizes()
+void GraphicsSceneObject::SetLodScreenSizes( const float32_t* pScreenSizes, size_t lodCount )
+{
+    HELIUM_ASSERT( lodCount != 0 && lodCount <= UINT8_MAX );
+    HELIUM_ASSERT( pScreenSizes || lodCount == 1 );
+
+    m_pLodScreenSizes = ( lodCount > 1 ? pScreenSizes : NULL );
+    m_lodCount = static_cast< uint8_t >( lodCount > 1 ? lodCount : 1 );
 }
 
 /// Set the instance vertex information.
@@ -130,6 +194,14 @@ void GraphicsSceneObject::SetNeedsUpdate( EUpdate updateMode )
     }
 }
 
+/// Flag the transform of this object as written to its persistent instance constants.
+///
+/// @see GetTransformDirty(), SetTransform()
+void GraphicsSceneObject::ClearTransformDirty()
+{
+    m_bTransformDirty = false;
+}
+
 /// Constructor.
 ///
 /// @param[in] sceneObjectId  ID of the parent graphics scene object used to control the placement of this object as
@@ -142,6 +214,8 @@ GraphicsSceneObject::SubMeshData::SubMeshData( size_t sceneObjectId )
 , m_startVertex( 0 )
 , m_vertexRange( 0 )
 , m_startIndex( 0 )
+, m_pLocalBounds( NULL )
+, m_pLodIndexRanges( NULL )
 {
     HELIUM_ASSERT( IsValid( sceneObjectId ) );
 }
@@ -218,3 +292,31 @@ void GraphicsSceneObject::SubMeshData::SetStartIndex( uint32_t startIndex )
 {
     m_startIndex = startIndex;
 }
+
+/// Set the bounds of this sub-mesh in the local space of the parent scene object.
+///
+/// Sub-meshes with bounds are culled individually against each view once their parent scene object is found to be
+/// visible.  The bounds must remain valid for as long as they are set, and should only be set for geometry that is not
+/// deformed at runtime (i.e. not for skinned meshes).
+///
+/// @param[in] pBounds  Local-space sub-mesh bounds, or null to draw the sub-mesh whenever its parent is visible.
+///
+/// @see GetLocalBounds()
+void GraphicsSceneObject::SubMeshData::SetLocalBounds( const Simd::AaBox* pBounds )
+{
+    m_pLocalBounds = pBounds;
+}
+
+/// Set the index buffer ranges of this sub-mesh for the levels of detail of its parent scene object.
+///
+/// The ranges must remain valid for as long as they are set.
+///
+/// @param[in] pRanges  Start index and primitive count for each level of detail past the first (one pair for each
+///                     level of detail set on the parent scene object), or null if the sub-mesh has a single level of
+///                     detail.
+///
+/// @see GetLodIndexRanges(), GraphicsSceneObject::SetLodScreenSizes()
+void GraphicsSceneObject::SubMeshData::SetLodIndexRanges( const uint32_t* pRanges )
+{
+    m_pLodIndexRanges = pRanges;
+}
@@ -13,6 +13,7 @@
 namespace Helium
 {
     class GraphicsScene;
+    class VisibilityGrid;
 
     class Material;
     typedef Helium::StrongPtr< Material > MaterialPtr;
@@ -60,6 +61,8 @@ namespace Helium
             void SetStartVertex( uint32_t startVertex );
             void SetVertexRange( uint32_t count );
             void SetStartIndex( uint32_t startIndex );
+            void SetLocalBounds( const Simd::AaBox* pBounds );
+            void SetLodIndexRanges( const uint32_t* pRanges );
 
             inline size_t GetSceneObjectId() const;
 
@@ -70,6 +73,10 @@ namespace Helium
             inline uint32_t GetStartVertex() const;
             inline uint32_t GetVertexRange() const;
             inline uint32_t GetStartIndex() const;
+            inline const Simd::AaBox* GetLocalBounds() const;
+            inline const uint32_t* GetLodIndexRanges() const;
+
+            inline void GetIndexRange( size_t lodIndex, uint32_t& rStartIndex, uint32_t& rPrimitiveCount ) const;
             //@}
 
         private:
@@ -90,6 +97,11 @@ namespace Helium
             uint32_t m_vertexRange;
             /// Offset of the first index to use within the index buffer.
             uint32_t m_startIndex;
+            /// Sub-mesh bounds in the local space of the parent scene object (null if not culled individually).
+            const Simd::AaBox* m_pLocalBounds;
+            /// Start index and primitive count for each level of detail past the first (null if the sub-mesh has a
+            /// single level of detail).
+            const uint32_t* m_pLodIndexRanges;
         };
 
         /// @name Construction/Destruction
@@ -99,8 +111,12 @@ namespace Helium
 
         /// @name Data Access
         //@{
+        void SetVisibilityGrid( VisibilityGrid* pGrid, size_t id );
+
         void SetTransform( const Simd::Matrix44& rTransform );
         void SetWorldBounds( const Simd::AaBox& rBox );
+        void SetOccluderBox( const Simd::AaBox* pLocalBox );
+        void SetLodScreenSizes( const float32_t* pScreenSizes, size_t lodCount );
         void SetVertexData( RVertexBuffer* pVertexBuffer, RVertexDescription* pVertexDescription, uint32_t vertexStride );
         void SetIndexBuffer( RIndexBuffer* pIndexBuffer );
 
@@ -114,6 +130,9 @@ namespace Helium
         inline const Simd::Matrix44& GetTransform() const;
         inline const Simd::AaBox& GetWorldBox() const;
         inline const Simd::Sphere& GetWorldSphere() const;
+        inline const Simd::AaBox* GetOccluderBox() const;
+        inline size_t GetLodCount() const;
+        inline const float32_t* GetLodScreenSizes() const;
         inline RVertexBuffer* GetVertexBuffer() const;
         inline RVertexDescription* GetVertexDescription() const;
         inline uint32_t GetVertexStride() const;
@@ -131,6 +150,9 @@ namespace Helium
         void SetNeedsUpdate( EUpdate updateMode = UPDATE_FULL );
         inline bool GetNeedsUpdate() const;
         inline EUpdate GetUpdateMode() const;
+
+        inline bool GetTransformDirty() const;
+        void ClearTransformDirty();
         //@}
 
     private:
@@ -140,6 +162,8 @@ namespace Helium
         Simd::AaBox m_worldBox;
         /// World-space bounding sphere.
         Simd::Sphere m_worldSphere;
+        /// Occluder box in local space (only valid if m_bOccluder is set).
+        Simd::AaBox m_occluderBox;
 
         /// Vertex buffer.
         RVertexBufferPtr m_spVertexBuffer;
@@ -157,15 +181,28 @@ namespace Helium
 #endif
         /// Bone palette.
         const Simd::Matrix44* m_pBonePalette;
+        /// Projected size below which each level of detail past the first is used (null if there is only one level).
+        const float32_t* m_pLodScreenSizes;
+
+        /// Visibility grid to update with the world bounds of this object.
+        VisibilityGrid* m_pVisibilityGrid;
+        /// ID of this object in the visibility grid.
+        size_t m_visibilityId;
         
         /// Vertex stride, in bytes.
         uint32_t m_vertexStride;
 
         /// Number of bones in the bone palette.
         uint8_t m_boneCount;
+        /// Number of levels of detail.
+        uint8_t m_lodCount;
 
         /// Update mode.
         uint8_t m_updateMode;
+        /// True if the transform has changed since its constants were last written by the graphics scene.
+        bool m_bTransformDirty;
+        /// True if this object has an occluder box.
+        bool m_bOccluder;
     } HELIUM_SIMD_ALIGN_POST;
 }
 
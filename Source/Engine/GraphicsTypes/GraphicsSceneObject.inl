@@ -30,6 +30,38 @@ namespace Helium
         return m_worldSphere;
     }
 
+    /// Get the occluder box for this instance.
+    ///
+    /// @return  Occluder box in the local space of this instance, or null if this instance does not occlude other
+    ///          objects.
+    ///
+    /// @see SetOccluderBox()
+    const Simd::AaBox* GraphicsSceneObject::GetOccluderBox() const
+    {
+        return ( m_bOccluder ? &m_occluderBox : NULL );
+    }
+
+    /// Get the number of levels of detail of this instance.
+    ///
+    /// @return  Level of detail count (at least one).
+    ///
+    /// @see GetLodScreenSizes(), SetLodScreenSizes()
+    size_t GraphicsSceneObject::GetLodCount() const
+    {
+        return m_lodCount;
+    }
+
+    /// Get the projected sizes below which the levels of detail of this instance are used.
+    ///
+    /// @return  Projected size, in pixels, below which each level of detail past the first is used (GetLodCount() minus
+    ///          one entries, in decreasing order), or null if this instance has a single level of detail.
+    ///
+    /// @see GetLodCount(), SetLodScreenSizes()
+    const float32_t* GraphicsSceneObject::GetLodScreenSizes() const
+    {
+        return m_pLodScreenSizes;
+    }
+
     /// Get the instance vertex buffer.
     ///
     /// @return  Instance vertex buffer.
@@ -137,7 +169,20 @@ namespace Helium
                  ? UPDATE_INVALID
                  : static_cast< EUpdate >( m_updateMode ) );
     }
-    
+
+    /// Get whether the transform of this object has changed since its persistent instance constants were last
+    /// written.
+    ///
+    /// New objects always start out dirty.
+    ///
+    /// @return  True if the transform constants need to be written, false if they are up to date.
+    ///
+    /// @see SetTransform(), ClearTransformDirty()
+    bool GraphicsSceneObject::GetTransformDirty() const
+    {
+        return m_bTransformDirty;
+    }
+
     /// Get the ID of the parent graphics scene object used to control the placement of this object as well as provide
     /// its vertex data.
     ///
@@ -217,4 +262,49 @@ namespace Helium
     {
         return m_startIndex;
     }
+
+    /// Get the bounds of this sub-mesh in the local space of the parent scene object.
+    ///
+    /// @return  Local-space sub-mesh bounds, or null if the sub-mesh is not culled individually.
+    ///
+    /// @see SetLocalBounds()
+    const Simd::AaBox* GraphicsSceneObject::SubMeshData::GetLocalBounds() const
+    {
+        return m_pLocalBounds;
+    }
+
+    /// Get the index buffer ranges of this sub-mesh for the levels of detail of its parent scene object.
+    ///
+    /// @return  Start index and primitive count for each level of detail past the first, or null if this sub-mesh has a
+    ///          single level of detail.
+    ///
+    /// @see SetLodIndexRanges(), GetIndexRange()
+    const uint32_t* GraphicsSceneObject::SubMeshData::GetLodIndexRanges() const
+    {
+        return m_pLodIndexRanges;
+    }
+
+    /// Get the index buffer range to draw for this sub-mesh at a given level of detail.
+    ///
+    /// @param[in]  lodIndex         Level of detail (must be less than the level of detail count of the parent scene
+    ///                              object, and zero if this sub-mesh has no level of detail ranges).
+    /// @param[out] rStartIndex      Index of the first index to draw.
+    /// @param[out] rPrimitiveCount  Number of primitives to draw.
+    ///
+    /// @see GetStartIndex(), GetPrimitiveCount(), GetLodIndexRanges()
+    void GraphicsSceneObject::SubMeshData::GetIndexRange(
+        size_t lodIndex, uint32_t& rStartIndex, uint32_t& rPrimitiveCount ) const
+    {
+        if( lodIndex == 0 || !m_pLodIndexRanges )
+        {
+            rStartIndex = m_startIndex;
+            rPrimitiveCount = m_primitiveCount;
+
+            return;
+        }
+
+        const uint32_t* pRange = m_pLodIndexRanges + ( lodIndex - 1 ) * 2;
+        rStartIndex = pRange[ 0 ];
+        rPrimitiveCount = pRange[ 1 ];
+    }
 }
@@ -87,6 +87,9 @@ namespace Helium
 
 		inline const Simd::Frustum& GetFrustum() const;
 
+		inline float32_t GetNearClip() const;
+		inline float32_t GetFarClip() const;
+
 		inline RConstantBuffer* GetScreenSpaceVertexConstantBuffer() const;
 
 		inline float32_t GetShadowCutoffDistance() const;
@@ -155,6 +155,26 @@ namespace Helium
         return m_frustum;
     }
 
+    /// Get the near clip plane distance.
+    ///
+    /// @return  Near clip distance.
+    ///
+    /// @see SetNearClip(), GetFarClip()
+    float32_t GraphicsSceneView::GetNearClip() const
+    {
+        return m_nearClip;
+    }
+
+    /// Get the far clip plane distance.
+    ///
+    /// @return  Far clip distance, or a negative value if the far clip plane is at infinity.
+    ///
+    /// @see SetFarClip(), GetNearClip()
+    float32_t GraphicsSceneView::GetFarClip() const
+    {
+        return m_farClip;
+    }
+
     /// Get the distance from the camera at which shadows should no longer be rendered.
     ///
     /// @return  Shadow cutoff distance.
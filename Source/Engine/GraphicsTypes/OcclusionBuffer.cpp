@@ -0,0 +1,335 @@
+#include "Precompile.h"
+#include "GraphicsTypes/OcclusionBuffer.h"
+
+using namespace Helium;
+
+/// Depth of texels not covered by any occluder (the far clip plane).
+static const float32_t OCCLUSION_FAR_DEPTH = 1.0f;
+
+/// Corner indices of the two triangles making up each face of a box (corner index bits 0, 1, and 2 select the maximum
+/// x, y, and z coordinates, respectively).
+static const uint8_t BOX_TRIANGLE_CORNERS[ 12 ][ 3 ] =
+{
+    { 0, 2, 6 }, { 0, 6, 4 },
+    { 1, 3, 7 }, { 1, 7, 5 },
+    { 0, 1, 5 }, { 0, 5, 4 },
+    { 2, 3, 7 }, { 2, 7, 6 },
+    { 0, 1, 3 }, { 0, 3, 2 },
+    { 4, 5, 7 }, { 4, 7, 6 }
+};
+
+/// Constructor.
+OcclusionBuffer::OcclusionBuffer()
+    : m_bHasOccluders( false )
+{
+    HELIUM_COMPILE_ASSERT( ( WIDTH >> ( LEVEL_COUNT - 1 ) ) != 0 && ( HEIGHT >> ( LEVEL_COUNT - 1 ) ) != 0 );
+}
+
+/// Clear this buffer and begin rasterizing occluders for a new view.
+///
+/// @param[in] rViewProjection  World-to-clip space transform of the view.
+///
+/// @see AddOccluder(), End()
+void OcclusionBuffer::Begin( const Simd::Matrix44& rViewProjection )
+{
+    m_viewProjection = rViewProjection;
+    m_bHasOccluders = false;
+
+    size_t depthCount = GetLevelOffset( LEVEL_COUNT );
+    m_depths.Resize( depthCount );
+
+    float32_t* pDepths = m_depths.GetData();
+    for( size_t depthIndex = 0; depthIndex < WIDTH * HEIGHT; ++depthIndex )
+    {
+        pDepths[ depthIndex ] = OCCLUSION_FAR_DEPTH;
+    }
+}
+
+/// Rasterize an occluder box into the finest level of this buffer.
+///
+/// The box must lie entirely inside of the solid geometry of its object, as anything behind it may be culled.
+///
+/// @param[in] rTransform  Local-to-world transform of the occluder.
+/// @param[in] rLocalBox   Occluder box, in the local space of the occluder.
+///
+/// @see Begin(), End()
+void OcclusionBuffer::AddOccluder( const Simd::Matrix44& rTransform, const Simd::AaBox& rLocalBox )
+{
+    HELIUM_ASSERT( m_depths.GetSize() == GetLevelOffset( LEVEL_COUNT ) );
+
+    Simd::Matrix44 clipTransform;
+    clipTransform.MultiplySet( rTransform, m_viewProjection );
+
+    ScreenVertex corners[ 8 ];
+    if( !ProjectBox( clipTransform, rLocalBox, corners ) )
+    {
+        return;
+    }
+
+    for( size_t triangleIndex = 0; triangleIndex < HELIUM_ARRAY_COUNT( BOX_TRIANGLE_CORNERS ); ++triangleIndex )
+    {
+        const uint8_t* pTriangleCorners = BOX_TRIANGLE_CORNERS[ triangleIndex ];
+        RasterizeTriangle(
+            corners[ pTriangleCorners[ 0 ] ],
+            corners[ pTriangleCorners[ 1 ] ],
+            corners[ pTriangleCorners[ 2 ] ] );
+    }
+
+    m_bHasOccluders = true;
+}
+
+/// Finish rasterizing occluders and build the hierarchical-Z levels of this buffer.
+///
+/// Each texel of a coarser level holds the farthest depth of the four texels it covers in the level above.
+///
+/// @see Begin(), AddOccluder(), IsOccluded()
+void OcclusionBuffer::End()
+{
+    if( !m_bHasOccluders )
+    {
+        return;
+    }
+
+    float32_t* pDepths = m_depths.GetData();
+
+    for( uint32_t level = 1; level < LEVEL_COUNT; ++level )
+    {
+        const float32_t* pSource = pDepths + GetLevelOffset( level - 1 );
+        float32_t* pDest = pDepths + GetLevelOffset( level );
+
+        uint32_t sourceWidth = WIDTH >> ( level - 1 );
+        uint32_t width = WIDTH >> level;
+        uint32_t height = HEIGHT >> level;
+
+        for( uint32_t y = 0; y < height; ++y )
+        {
+            const float32_t* pSourceRow0 = pSource + ( y * 2 ) * sourceWidth;
+            const float32_t* pSourceRow1 = pSourceRow0 + sourceWidth;
+            for( uint32_t x = 0; x < width; ++x )
+            {
+                float32_t depth0 = Max( pSourceRow0[ x * 2 ], pSourceRow0[ x * 2 + 1 ] );
+                float32_t depth1 = Max( pSourceRow1[ x * 2 ], pSourceRow1[ x * 2 + 1 ] );
+                pDest[ y * width + x ] = Max( depth0, depth1 );
+            }
+        }
+    }
+}
+
+/// Test whether a bounding box is entirely hidden behind the occluders in this buffer.
+///
+/// The box is tested against the coarsest level at which its projection covers no more than two texels in each
+/// direction.
+///
+/// @param[in] rWorldBox  World-space bounding box to test.
+///
+/// @return  True if the box is hidden, false if it may be visible.
+///
+/// @see End()
+bool OcclusionBuffer::IsOccluded( const Simd::AaBox& rWorldBox ) const
+{
+    if( !m_bHasOccluders )
+    {
+        return false;
+    }
+
+    ScreenVertex corners[ 8 ];
+    if( !ProjectBox( m_viewProjection, rWorldBox, corners ) )
+    {
+        return false;
+    }
+
+    float32_t minX = corners[ 0 ].x;
+    float32_t minY = corners[ 0 ].y;
+    float32_t maxX = minX;
+    float32_t maxY = minY;
+    float32_t minDepth = corners[ 0 ].depth;
+    for( size_t cornerIndex = 1; cornerIndex < HELIUM_ARRAY_COUNT( corners ); ++cornerIndex )
+    {
+        const ScreenVertex& rCorner = corners[ cornerIndex ];
+        minX = Min( minX, rCorner.x );
+        minY = Min( minY, rCorner.y );
+        maxX = Max( maxX, rCorner.x );
+        maxY = Max( maxY, rCorner.y );
+        minDepth = Min( minDepth, rCorner.depth );
+    }
+
+    const float32_t widthFloat = static_cast< float32_t >( WIDTH );
+    const float32_t heightFloat = static_cast< float32_t >( HEIGHT );
+    if( maxX < 0.0f || maxY < 0.0f || minX >= widthFloat || minY >= heightFloat )
+    {
+        return false;
+    }
+
+    uint32_t minTexelX = static_cast< uint32_t >( Max( minX, 0.0f ) );
+    uint32_t minTexelY = static_cast< uint32_t >( Max( minY, 0.0f ) );
+    uint32_t maxTexelX = static_cast< uint32_t >( Min( maxX, widthFloat - 1.0f ) );
+    uint32_t maxTexelY = static_cast< uint32_t >( Min( maxY, heightFloat - 1.0f ) );
+
+    uint32_t level = 0;
+    while( level + 1 < LEVEL_COUNT &&
+        ( ( maxTexelX >> level ) - ( minTexelX >> level ) > 1 || ( maxTexelY >> level ) - ( minTexelY >> level ) > 1 ) )
+    {
+        ++level;
+    }
+
+    const float32_t* pLevelDepths = m_depths.GetData() + GetLevelOffset( level );
+    uint32_t levelWidth = WIDTH >> level;
+
+    for( uint32_t y = minTexelY >> level; y <= ( maxTexelY >> level ); ++y )
+    {
+        for( uint32_t x = minTexelX >> level; x <= ( maxTexelX >> level ); ++x )
+        {
+            if( pLevelDepths[ y * levelWidth + x ] >= minDepth )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/// Rasterize a triangle into the finest level of this buffer, keeping the nearest depth in each texel.
+///
+/// @param[in] rVertex0  First triangle vertex.
+/// @param[in] rVertex1  Second triangle vertex.
+/// @param[in] rVertex2  Third triangle vertex.
+void OcclusionBuffer::RasterizeTriangle(
+    const ScreenVertex& rVertex0, const ScreenVertex& rVertex1, const ScreenVertex& rVertex2 )
+{
+    const ScreenVertex* pVertex0 = &rVertex0;
+    const ScreenVertex* pVertex1 = &rVertex1;
+    const ScreenVertex* pVertex2 = &rVertex2;
+
+    // Box faces are rasterized regardless of their facing, so flip back-facing triangles to a consistent winding.
+    float32_t area =
+        ( pVertex1->x - pVertex0->x ) * ( pVertex2->y - pVertex0->y ) -
+        ( pVertex1->y - pVertex0->y ) * ( pVertex2->x - pVertex0->x );
+    if( area < 0.0f )
+    {
+        const ScreenVertex* pTempVertex = pVertex1;
+        pVertex1 = pVertex2;
+        pVertex2 = pTempVertex;
+        area = -area;
+    }
+
+    if( area < HELIUM_EPSILON )
+    {
+        return;
+    }
+
+    const float32_t widthFloat = static_cast< float32_t >( WIDTH );
+    const float32_t heightFloat = static_cast< float32_t >( HEIGHT );
+
+    float32_t minX = Min( Min( pVertex0->x, pVertex1->x ), pVertex2->x );
+    float32_t minY = Min( Min( pVertex0->y, pVertex1->y ), pVertex2->y );
+    float32_t maxX = Max( Max( pVertex0->x, pVertex1->x ), pVertex2->x );
+    float32_t maxY = Max( Max( pVertex0->y, pVertex1->y ), pVertex2->y );
+    if( maxX < 0.0f || maxY < 0.0f || minX >= widthFloat || minY >= heightFloat )
+    {
+        return;
+    }
+
+    uint32_t minTexelX = static_cast< uint32_t >( Max( minX, 0.0f ) );
+    uint32_t minTexelY = static_cast< uint32_t >( Max( minY, 0.0f ) );
+    uint32_t maxTexelX = static_cast< uint32_t >( Min( maxX, widthFloat - 1.0f ) );
+    uint32_t maxTexelY = static_cast< uint32_t >( Min( maxY, heightFloat - 1.0f ) );
+
+    float32_t inverseArea = 1.0f / area;
+    float32_t* pDepths = m_depths.GetData();
+
+    // Texels are covered if their centers are inside of the triangle.  The depth is interpolated from the edge
+    // function values, each of which is the (doubled) area of the sub-triangle opposite of a vertex.
+    for( uint32_t y = minTexelY; y <= maxTexelY; ++y )
+    {
+        float32_t pointY = static_cast< float32_t >( y ) + 0.5f;
+        float32_t* pRow = pDepths + y * WIDTH;
+
+        for( uint32_t x = minTexelX; x <= maxTexelX; ++x )
+        {
+            float32_t pointX = static_cast< float32_t >( x ) + 0.5f;
+
+            float32_t weight0 =
+                ( pVertex2->x - pVertex1->x ) * ( pointY - pVertex1->y ) -
+                ( pVertex2->y - pVertex1->y ) * ( pointX - pVertex1->x );
+            float32_t weight1 =
+                ( pVertex0->x - pVertex2->x ) * ( pointY - pVertex2->y ) -
+                ( pVertex0->y - pVertex2->y ) * ( pointX - pVertex2->x );
+            float32_t weight2 =
+                ( pVertex1->x - pVertex0->x ) * ( pointY - pVertex0->y ) -
+                ( pVertex1->y - pVertex0->y ) * ( pointX - pVertex0->x );
+            if( weight0 < 0.0f || weight1 < 0.0f || weight2 < 0.0f )
+            {
+                continue;
+            }
+
+            float32_t depth =
+                ( weight0 * pVertex0->depth + weight1 * pVertex1->depth + weight2 * pVertex2->depth ) * inverseArea;
+            pRow[ x ] = Min( pRow[ x ], depth );
+        }
+    }
+}
+
+/// Get the offset of the first depth value of a buffer level.
+///
+/// @param[in] level  Buffer level (can be LEVEL_COUNT to get the total number of depth values in all levels).
+///
+/// @return  Offset of the level in the depth value array.
+size_t OcclusionBuffer::GetLevelOffset( uint32_t level )
+{
+    HELIUM_ASSERT( level <= LEVEL_COUNT );
+
+    size_t offset = 0;
+    for( uint32_t levelIndex = 0; levelIndex < level; ++levelIndex )
+    {
+        offset += static_cast< size_t >( WIDTH >> levelIndex ) * static_cast< size_t >( HEIGHT >> levelIndex );
+    }
+
+    return offset;
+}
+
+/// Project the corners of a box into buffer space.
+///
+/// @param[in]  rTransform  Transform from the space of the box to clip space.
+/// @param[in]  rBox        Box to project.
+/// @param[out] pCorners    Projected corners (eight entries, indexed as in BOX_TRIANGLE_CORNERS).
+///
+/// @return  True if the box was projected, false if any of its corners is in front of the near clip plane.
+bool OcclusionBuffer::ProjectBox( const Simd::Matrix44& rTransform, const Simd::AaBox& rBox, ScreenVertex* pCorners )
+{
+    HELIUM_ASSERT( pCorners );
+
+    const Simd::Vector3& rMinimum = rBox.GetMinimum();
+    const Simd::Vector3& rMaximum = rBox.GetMaximum();
+
+    const float32_t widthFloat = static_cast< float32_t >( WIDTH );
+    const float32_t heightFloat = static_cast< float32_t >( HEIGHT );
+
+    for( size_t cornerIndex = 0; cornerIndex < 8; ++cornerIndex )
+    {
+        Simd::Vector4 corner(
+            ( cornerIndex & 1 ) ? rMaximum.GetElement( 0 ) : rMinimum.GetElement( 0 ),
+            ( cornerIndex & 2 ) ? rMaximum.GetElement( 1 ) : rMinimum.GetElement( 1 ),
+            ( cornerIndex & 4 ) ? rMaximum.GetElement( 2 ) : rMinimum.GetElement( 2 ),
+            1.0f );
+
+        Simd::Vector4 clipCorner;
+        rTransform.Transform( corner, clipCorner );
+
+        float32_t clipZ = clipCorner.GetElement( 2 );
+        float32_t clipW = clipCorner.GetElement( 3 );
+        if( clipZ < 0.0f || clipW <= HELIUM_EPSILON )
+        {
+            return false;
+        }
+
+        float32_t inverseW = 1.0f / clipW;
+
+        ScreenVertex& rCorner = pCorners[ cornerIndex ];
+        rCorner.x = ( clipCorner.GetElement( 0 ) * inverseW * 0.5f + 0.5f ) * widthFloat;
+        rCorner.y = ( 0.5f - clipCorner.GetElement( 1 ) * inverseW * 0.5f ) * heightFloat;
+        rCorner.depth = clipZ * inverseW;
+    }
+
+    return true;
+}
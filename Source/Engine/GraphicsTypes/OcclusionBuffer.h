@@ -0,0 +1,83 @@
+#pragma once
+
+#include "GraphicsTypes/GraphicsTypes.h"
+
+#include "Foundation/DynamicArray.h"
+#include "MathSimd/AaBox.h"
+#include "MathSimd/Matrix44.h"
+
+namespace Helium
+{
+    /// Low-resolution software depth buffer for occlusion culling.
+    ///
+    /// Occluder boxes (conservative volumes fully inside of the solid geometry of large objects, such as walls and
+    /// buildings) are rasterized on the CPU into a small depth buffer covering the view, from which a hierarchical-Z
+    /// pyramid of maximum depths is built.  Bounding boxes of other objects can then be tested against the pyramid by
+    /// comparing their nearest depth against the farthest occluder depth in the few texels covering their projection.
+    ///
+    /// Occluders crossing the near plane are skipped, and objects crossing the near plane are never considered
+    /// occluded, so that nothing needs to be clipped.  Once built, any number of threads can test against the buffer at
+    /// the same time.
+    class HELIUM_GRAPHICS_TYPES_API OcclusionBuffer
+    {
+    public:
+        /// Width of the finest buffer level, in texels.
+        static const uint32_t WIDTH = 256;
+        /// Height of the finest buffer level, in texels.
+        static const uint32_t HEIGHT = 128;
+        /// Number of hierarchical-Z levels (each level halves the resolution of the previous one).
+        static const uint32_t LEVEL_COUNT = 8;
+
+        /// @name Construction/Destruction
+        //@{
+        OcclusionBuffer();
+        //@}
+
+        /// @name Occluder Rendering
+        //@{
+        void Begin( const Simd::Matrix44& rViewProjection );
+        void AddOccluder( const Simd::Matrix44& rTransform, const Simd::AaBox& rLocalBox );
+        void End();
+
+        inline bool HasOccluders() const;
+        //@}
+
+        /// @name Occlusion Testing
+        //@{
+        bool IsOccluded( const Simd::AaBox& rWorldBox ) const;
+        //@}
+
+    private:
+        /// Screen-space vertex of a rasterized triangle.
+        struct ScreenVertex
+        {
+            /// Horizontal position, in finest level texels.
+            float32_t x;
+            /// Vertical position, in finest level texels.
+            float32_t y;
+            /// Post-projection depth.
+            float32_t depth;
+        };
+
+        /// World-to-clip space transform of the view.
+        Simd::Matrix44 m_viewProjection;
+        /// Depth values of every level, finest level first.
+        DynamicArray< float32_t > m_depths;
+        /// True if any occluder was rasterized since the last call to Begin().
+        bool m_bHasOccluders;
+
+        /// @name Private Utility Functions
+        //@{
+        void RasterizeTriangle( const ScreenVertex& rVertex0, const ScreenVertex& rVertex1, const ScreenVertex& rVertex2 );
+        //@}
+
+        /// @name Private Static Utility Functions
+        //@{
+        static size_t GetLevelOffset( uint32_t level );
+        static bool ProjectBox(
+            const Simd::Matrix44& rTransform, const Simd::AaBox& rBox, ScreenVertex* pCorners );
+        //@}
+    };
+}
+
+#include "GraphicsTypes/OcclusionBuffer.inl"
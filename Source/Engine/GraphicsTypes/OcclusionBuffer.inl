@@ -0,0 +1,13 @@
+namespace Helium
+{
+    /// Get whether any occluders were rasterized into this buffer.
+    ///
+    /// @return  True if at least one occluder was rasterized since the last call to Begin(), false if not (in which
+    ///          case nothing can be occluded).
+    ///
+    /// @see AddOccluder(), IsOccluded()
+    bool OcclusionBuffer::HasOccluders() const
+    {
+        return m_bHasOccluders;
+    }
+}
@@ -0,0 +1,427 @@
+#include "Precompile.h"
+#include "GraphicsTypes/VisibilityGrid.h"
+
+#include "MathSimd/Frustum.h"
+#include "MathSimd/Vector3Soa.h"
+
+using namespace Helium;
+
+/// Number of bits used for each cell coordinate in a cell key.
+static const uint32_t CELL_COORDINATE_BITS = 20;
+/// Offset applied to signed cell coordinates to store them unsigned in a cell key.
+static const int64_t CELL_COORDINATE_BIAS = static_cast< int64_t >( 1 ) << ( CELL_COORDINATE_BITS - 1 );
+
+const float32_t VisibilityGrid::DEFAULT_CELL_SIZE = 16.0f;
+
+/// Constructor.
+///
+/// @param[in] cellSize  Size of the cells in the finest grid level.
+VisibilityGrid::VisibilityGrid( float32_t cellSize )
+    : m_cellSize( cellSize )
+{
+    HELIUM_ASSERT( cellSize > 0.0f );
+}
+
+/// Add an object to this grid or update its bounds if it has already been added.
+///
+/// @param[in] objectId  ID of the object to update.
+/// @param[in] rBox      World-space bounding box of the object.
+///
+/// @see Remove(), Contains()
+void VisibilityGrid::Update( size_t objectId, const Simd::AaBox& rBox )
+{
+    HELIUM_ASSERT( IsValid( objectId ) );
+
+    size_t objectCount = m_objects.GetSize();
+    if( objectId >= objectCount )
+    {
+        m_objects.Resize( objectId + 1 );
+        for( size_t objectIndex = objectCount; objectIndex <= objectId; ++objectIndex )
+        {
+            SetInvalid( m_objects[ objectIndex ].cellIndex );
+            SetInvalid( m_objects[ objectIndex ].slotIndex );
+        }
+    }
+
+    uint32_t cellIndex = GetCellIndex( rBox );
+    ObjectEntry& rEntry = m_objects[ objectId ];
+
+    // Objects that stay within the same cell only need their bounds updated.
+    if( rEntry.cellIndex == cellIndex )
+    {
+        SetGroupBox( m_cells[ cellIndex ].objectBounds, rEntry.slotIndex, rBox );
+        MarkCellDirty( cellIndex );
+
+        return;
+    }
+
+    if( IsValid( rEntry.cellIndex ) )
+    {
+        Remove( objectId );
+    }
+
+    Cell& rCell = m_cells[ cellIndex ];
+    size_t slotIndex = rCell.objectIds.GetSize();
+    rCell.objectIds.Push( objectId );
+
+    size_t boundsSize = ( ( slotIndex + 4 ) / 4 ) * BOX_GROUP_FLOAT_COUNT;
+    if( rCell.objectBounds.GetSize() < boundsSize )
+    {
+        rCell.objectBounds.Resize( boundsSize );
+    }
+
+    SetGroupBox( rCell.objectBounds, slotIndex, rBox );
+    MarkCellDirty( cellIndex );
+
+    rEntry.cellIndex = cellIndex;
+    rEntry.slotIndex = static_cast< uint32_t >( slotIndex );
+}
+
+/// Remove an object from this grid.
+///
+/// @param[in] objectId  ID of the object to remove.  Objects that have not been added are ignored.
+///
+/// @see Update(), Contains()
+void VisibilityGrid::Remove( size_t objectId )
+{
+    if( !Contains( objectId ) )
+    {
+        return;
+    }
+
+    ObjectEntry& rEntry = m_objects[ objectId ];
+    uint32_t cellIndex = rEntry.cellIndex;
+    uint32_t slotIndex = rEntry.slotIndex;
+
+    // Move the last object in the cell into the freed slot.
+    Cell& rCell = m_cells[ cellIndex ];
+    size_t lastSlotIndex = rCell.objectIds.GetSize() - 1;
+    if( slotIndex != lastSlotIndex )
+    {
+        size_t movedObjectId = rCell.objectIds[ lastSlotIndex ];
+        rCell.objectIds[ slotIndex ] = movedObjectId;
+        CopyGroupBox( rCell.objectBounds, slotIndex, lastSlotIndex );
+
+        m_objects[ movedObjectId ].slotIndex = slotIndex;
+    }
+
+    rCell.objectIds.Pop();
+    MarkCellDirty( cellIndex );
+
+    SetInvalid( rEntry.cellIndex );
+    SetInvalid( rEntry.slotIndex );
+}
+
+/// Remove all objects and cells from this grid.
+void VisibilityGrid::Clear()
+{
+    m_cells.Clear();
+    m_cellBounds.Clear();
+    m_cellMap.Clear();
+    m_dirtyCellIndices.Clear();
+    m_objects.Clear();
+}
+
+/// Gather the IDs of all objects with bounds that intersect a given view frustum.
+///
+/// UpdateCellBounds() must be called after objects are updated or removed and before culling.
+///
+/// @param[in]  rFrustum           Frustum to test.
+/// @param[out] rVisibleObjectIds  IDs of the objects that intersect the frustum.  Existing contents are discarded.
+///
+/// @see CullShadowCasters(), UpdateCellBounds()
+void VisibilityGrid::Cull( const Simd::Frustum& rFrustum, DynamicArray< size_t >& rVisibleObjectIds ) const
+{
+    CullInternal( rFrustum, NULL, Simd::Vector3( 0.0f ), rVisibleObjectIds );
+}
+
+/// Gather the IDs of all objects that may cast a visible shadow from a directional light.
+///
+/// Objects must intersect the shadow depth pass frustum, and their bounds swept along the light direction must also
+/// intersect the frustum of the region receiving shadows (typically the camera frustum clipped to the shadow
+/// distance).  Casters that pass the first test but only shadow areas outside of the view are skipped.
+///
+/// UpdateCellBounds() must be called after objects are updated or removed and before culling.
+///
+/// @param[in]  rShadowFrustum    Shadow depth pass frustum.
+/// @param[in]  rReceiverFrustum  Frustum of the region in which shadows are visible.
+/// @param[in]  rLightDirection   Direction in which light travels.
+/// @param[out] rCasterObjectIds  IDs of the objects that may cast visible shadows.  Existing contents are discarded.
+///
+/// @see Cull(), UpdateCellBounds()
+void VisibilityGrid::CullShadowCasters(
+    const Simd::Frustum& rShadowFrustum,
+    const Simd::Frustum& rReceiverFrustum,
+    const Simd::Vector3& rLightDirection,
+    DynamicArray< size_t >& rCasterObjectIds ) const
+{
+    CullInternal( rShadowFrustum, &rReceiverFrustum, rLightDirection, rCasterObjectIds );
+}
+
+/// Gather the IDs of all objects that pass the frustum tests of Cull() or CullShadowCasters().
+///
+/// @param[in]  rFrustum          Frustum that objects must intersect.
+/// @param[in]  pReceiverFrustum  Frustum that objects swept along rSweepDirection must also intersect, or null to skip
+///                               the swept test.
+/// @param[in]  rSweepDirection   Direction along which to sweep objects for testing against pReceiverFrustum.
+/// @param[out] rObjectIds        IDs of the objects passing the tests.  Existing contents are discarded.
+void VisibilityGrid::CullInternal(
+    const Simd::Frustum& rFrustum,
+    const Simd::Frustum* pReceiverFrustum,
+    const Simd::Vector3& rSweepDirection,
+    DynamicArray< size_t >& rObjectIds ) const
+{
+    HELIUM_ASSERT( m_dirtyCellIndices.IsEmpty() );
+
+    rObjectIds.Resize( 0 );
+
+    const float32_t* pCellBounds = m_cellBounds.GetData();
+
+    size_t cellCount = m_cells.GetSize();
+    for( size_t baseCellIndex = 0; baseCellIndex < cellCount; baseCellIndex += 4 )
+    {
+        const float32_t* pCellGroup = pCellBounds + ( baseCellIndex / 4 ) * BOX_GROUP_FLOAT_COUNT;
+
+        uint32_t cellMask = TestGroup( pCellGroup, rFrustum, pReceiverFrustum, rSweepDirection );
+
+        for( size_t cellLane = 0; cellMask != 0; ++cellLane, cellMask >>= 1 )
+        {
+            if( !( cellMask & 1 ) )
+            {
+                continue;
+            }
+
+            // Unused lanes in the last group are never set, so they may report an intersection.
+            size_t cellIndex = baseCellIndex + cellLane;
+            if( cellIndex >= cellCount )
+            {
+                break;
+            }
+
+            const Cell& rCell = m_cells[ cellIndex ];
+            const size_t* pObjectIds = rCell.objectIds.GetData();
+            const float32_t* pObjectBounds = rCell.objectBounds.GetData();
+
+            size_t objectCount = rCell.objectIds.GetSize();
+            for( size_t baseSlotIndex = 0; baseSlotIndex < objectCount; baseSlotIndex += 4 )
+            {
+                const float32_t* pObjectGroup = pObjectBounds + ( baseSlotIndex / 4 ) * BOX_GROUP_FLOAT_COUNT;
+
+                uint32_t objectMask = TestGroup( pObjectGroup, rFrustum, pReceiverFrustum, rSweepDirection );
+
+                size_t laneCount = Min< size_t >( objectCount - baseSlotIndex, 4 );
+                objectMask &= ( 1 << laneCount ) - 1;
+
+                for( size_t slotIndex = baseSlotIndex; objectMask != 0; ++slotIndex, objectMask >>= 1 )
+                {
+                    if( objectMask & 1 )
+                    {
+                        rObjectIds.Push( pObjectIds[ slotIndex ] );
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// Get the index of the cell in which to store an object with the given bounds, creating the cell if necessary.
+///
+/// @param[in] rBox  World-space bounding box of the object.
+///
+/// @return  Index of the cell for the object.
+uint32_t VisibilityGrid::GetCellIndex( const Simd::AaBox& rBox )
+{
+    const Simd::Vector3& rMinimum = rBox.GetMinimum();
+    const Simd::Vector3& rMaximum = rBox.GetMaximum();
+
+    float32_t extent = Max(
+        rMaximum.GetElement( 0 ) - rMinimum.GetElement( 0 ),
+        Max(
+            rMaximum.GetElement( 1 ) - rMinimum.GetElement( 1 ),
+            rMaximum.GetElement( 2 ) - rMinimum.GetElement( 2 ) ) );
+
+    // Use the finest level with cells at least as large as the object.
+    uint32_t level = 0;
+    float32_t cellSize = m_cellSize;
+    while( cellSize < extent && level < MAX_LEVEL )
+    {
+        cellSize *= 2.0f;
+        ++level;
+    }
+
+    uint64_t key = static_cast< uint64_t >( level ) << ( CELL_COORDINATE_BITS * 3 );
+    for( size_t axis = 0; axis < 3; ++axis )
+    {
+        float32_t center = ( rMinimum.GetElement( axis ) + rMaximum.GetElement( axis ) ) * 0.5f;
+        int64_t coordinate = static_cast< int64_t >( Floor( center / cellSize ) ) + CELL_COORDINATE_BIAS;
+        coordinate = Min( Max( coordinate, static_cast< int64_t >( 0 ) ), CELL_COORDINATE_BIAS * 2 - 1 );
+
+        key |= static_cast< uint64_t >( coordinate ) << ( CELL_COORDINATE_BITS * axis );
+    }
+
+    CellMapType::Iterator cellIter = m_cellMap.Find( key );
+    if( cellIter != m_cellMap.End() )
+    {
+        return cellIter->Second();
+    }
+
+    uint32_t cellIndex = static_cast< uint32_t >( m_cells.GetSize() );
+    m_cells.Resize( cellIndex + 1 );
+    m_cells[ cellIndex ].bDirty = false;
+
+    size_t cellBoundsSize = ( ( cellIndex + 4 ) / 4 ) * BOX_GROUP_FLOAT_COUNT;
+    if( m_cellBounds.GetSize() < cellBoundsSize )
+    {
+        m_cellBounds.Resize( cellBoundsSize );
+    }
+
+    m_cellMap.Insert( cellIter, CellMapType::ValueType( key, cellIndex ) );
+
+    return cellIndex;
+}
+
+/// Flag a cell as needing its combined bounds recomputed before the next cull.
+///
+/// @param[in] cellIndex  Index of the cell to flag.
+void VisibilityGrid::MarkCellDirty( uint32_t cellIndex )
+{
+    Cell& rCell = m_cells[ cellIndex ];
+    if( !rCell.bDirty )
+    {
+        rCell.bDirty = true;
+        m_dirtyCellIndices.Push( cellIndex );
+    }
+}
+
+/// Recompute the combined bounds of all cells that have changed since the last update.
+///
+/// @see Cull()
+void VisibilityGrid::UpdateCellBounds()
+{
+    size_t dirtyCellCount = m_dirtyCellIndices.GetSize();
+    for( size_t dirtyCellIndex = 0; dirtyCellIndex < dirtyCellCount; ++dirtyCellIndex )
+    {
+        uint32_t cellIndex = m_dirtyCellIndices[ dirtyCellIndex ];
+        Cell& rCell = m_cells[ cellIndex ];
+        rCell.bDirty = false;
+
+        size_t objectCount = rCell.objectIds.GetSize();
+        if( objectCount == 0 )
+        {
+            // Empty cells get an inverted box, which is outside of any frustum.
+            const float32_t maximum = NumericLimits< float32_t >::Maximum;
+            SetGroupBox(
+                m_cellBounds,
+                cellIndex,
+                Simd::AaBox(
+                    Simd::Vector3( maximum, maximum, maximum ),
+                    Simd::Vector3( -maximum, -maximum, -maximum ) ) );
+
+            continue;
+        }
+
+        const float32_t* pObjectBounds = rCell.objectBounds.GetData();
+
+        float32_t cellBounds[ 6 ];
+        for( size_t component = 0; component < 6; ++component )
+        {
+            cellBounds[ component ] = pObjectBounds[ component * 4 ];
+        }
+
+        for( size_t slotIndex = 1; slotIndex < objectCount; ++slotIndex )
+        {
+            const float32_t* pObjectBox = pObjectBounds + ( slotIndex / 4 ) * BOX_GROUP_FLOAT_COUNT + ( slotIndex % 4 );
+            for( size_t component = 0; component < 3; ++component )
+            {
+                cellBounds[ component ] = Min( cellBounds[ component ], pObjectBox[ component * 4 ] );
+            }
+
+            for( size_t component = 3; component < 6; ++component )
+            {
+                cellBounds[ component ] = Max( cellBounds[ component ], pObjectBox[ component * 4 ] );
+            }
+        }
+
+        SetGroupBox(
+            m_cellBounds,
+            cellIndex,
+            Simd::AaBox(
+                Simd::Vector3( cellBounds[ 0 ], cellBounds[ 1 ], cellBounds[ 2 ] ),
+                Simd::Vector3( cellBounds[ 3 ], cellBounds[ 4 ], cellBounds[ 5 ] ) ) );
+    }
+
+    m_dirtyCellIndices.Resize( 0 );
+}
+
+/// Store a box in an array of box groups.
+///
+/// @param[in] rBounds  Box group array.
+/// @param[in] index    Index of the box to set.
+/// @param[in] rBox     Box to store.
+void VisibilityGrid::SetGroupBox( DynamicArray< float32_t >& rBounds, size_t index, const Simd::AaBox& rBox )
+{
+    float32_t* pBox = rBounds.GetData() + ( index / 4 ) * BOX_GROUP_FLOAT_COUNT + ( index % 4 );
+    HELIUM_ASSERT( pBox + 20 < rBounds.GetData() + rBounds.GetSize() );
+
+    const Simd::Vector3& rMinimum = rBox.GetMinimum();
+    const Simd::Vector3& rMaximum = rBox.GetMaximum();
+
+    pBox[ 0 ] = rMinimum.GetElement( 0 );
+    pBox[ 4 ] = rMinimum.GetElement( 1 );
+    pBox[ 8 ] = rMinimum.GetElement( 2 );
+    pBox[ 12 ] = rMaximum.GetElement( 0 );
+    pBox[ 16 ] = rMaximum.GetElement( 1 );
+    pBox[ 20 ] = rMaximum.GetElement( 2 );
+}
+
+/// Copy a box from one location to another in an array of box groups.
+///
+/// @param[in] rBounds      Box group array.
+/// @param[in] destIndex    Index of the box to overwrite.
+/// @param[in] sourceIndex  Index of the box to copy.
+void VisibilityGrid::CopyGroupBox( DynamicArray< float32_t >& rBounds, size_t destIndex, size_t sourceIndex )
+{
+    float32_t* pBounds = rBounds.GetData();
+    float32_t* pDestBox = pBounds + ( destIndex / 4 ) * BOX_GROUP_FLOAT_COUNT + ( destIndex % 4 );
+    const float32_t* pSourceBox = pBounds + ( sourceIndex / 4 ) * BOX_GROUP_FLOAT_COUNT + ( sourceIndex % 4 );
+
+    for( size_t component = 0; component < 6; ++component )
+    {
+        pDestBox[ component * 4 ] = pSourceBox[ component * 4 ];
+    }
+}
+
+/// Test a group of four boxes against the frustums used for culling.
+///
+/// @param[in] pGroup            Box group bounds.
+/// @param[in] rFrustum          Frustum that the boxes must intersect.
+/// @param[in] pReceiverFrustum  Frustum that the boxes swept along rSweepDirection must also intersect, or null to skip
+///                              the swept test.
+/// @param[in] rSweepDirection   Direction along which to sweep the boxes for testing against pReceiverFrustum.
+///
+/// @return  Mask with bit n set if box n passes the tests.
+uint32_t VisibilityGrid::TestGroup(
+    const float32_t* pGroup,
+    const Simd::Frustum& rFrustum,
+    const Simd::Frustum* pReceiverFrustum,
+    const Simd::Vector3& rSweepDirection )
+{
+    HELIUM_ASSERT( pGroup );
+
+    Simd::Vector3Soa minimum(
+        Simd::LoadUnaligned( pGroup ),
+        Simd::LoadUnaligned( pGroup + 4 ),
+        Simd::LoadUnaligned( pGroup + 8 ) );
+    Simd::Vector3Soa maximum(
+        Simd::LoadUnaligned( pGroup + 12 ),
+        Simd::LoadUnaligned( pGroup + 16 ),
+        Simd::LoadUnaligned( pGroup + 20 ) );
+
+    uint32_t mask = rFrustum.IntersectsSoa( minimum, maximum );
+    if( mask != 0 && pReceiverFrustum )
+    {
+        mask &= pReceiverFrustum->IntersectsSweptSoa( minimum, maximum, rSweepDirection );
+    }
+
+    return mask;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "GraphicsTypes/GraphicsTypes.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/HashMap.h"
+#include "MathSimd/AaBox.h"
+
+namespace Helium
+{
+    namespace Simd
+    {
+        class Frustum;
+    }
+
+    /// Spatial lookup of graphics scene object bounds for visibility culling.
+    ///
+    /// Objects are placed in a loose grid of cells by the center of their bounding box, using coarser grid levels for
+    /// larger objects (each level doubles the cell size).  Each cell keeps the bounds of its objects in groups of four,
+    /// along with the combined bounds of all its objects, so culling can reject entire cells at once and test the
+    /// objects in the remaining cells four at a time.
+    ///
+    /// Once the cell bounds are up to date (see UpdateCellBounds()), any number of threads can cull against the grid at
+    /// the same time as long as no objects are being updated.
+    class HELIUM_GRAPHICS_TYPES_API VisibilityGrid
+    {
+    public:
+        /// Default size of the cells in the finest grid level.
+        static const float32_t DEFAULT_CELL_SIZE;
+        /// Highest grid level.
+        static const uint32_t MAX_LEVEL = 15;
+
+        /// @name Construction/Destruction
+        //@{
+        explicit VisibilityGrid( float32_t cellSize = DEFAULT_CELL_SIZE );
+        //@}
+
+        /// @name Object Management
+        //@{
+        void Update( size_t objectId, const Simd::AaBox& rBox );
+        void Remove( size_t objectId );
+        void Clear();
+
+        inline bool Contains( size_t objectId ) const;
+        //@}
+
+        /// @name Culling
+        //@{
+        void UpdateCellBounds();
+        void Cull( const Simd::Frustum& rFrustum, DynamicArray< size_t >& rVisibleObjectIds ) const;
+        void CullShadowCasters(
+            const Simd::Frustum& rShadowFrustum, const Simd::Frustum& rReceiverFrustum,
+            const Simd::Vector3& rLightDirection, DynamicArray< size_t >& rCasterObjectIds ) const;
+        //@}
+
+    private:
+        /// Number of floating-point values stored for each group of four boxes (minimum and maximum x, y, and z for
+        /// each box, in that order).
+        static const size_t BOX_GROUP_FLOAT_COUNT = 24;
+
+        /// Grid cell.
+        struct Cell
+        {
+            /// IDs of the objects in this cell.
+            DynamicArray< size_t > objectIds;
+            /// Object bounds, in groups of four boxes.
+            DynamicArray< float32_t > objectBounds;
+            /// True if the combined cell bounds need to be recomputed.
+            bool bDirty;
+        };
+
+        /// Object location within the grid.
+        struct ObjectEntry
+        {
+            /// Index of the cell containing the object (invalid if the object is not in the grid).
+            uint32_t cellIndex;
+            /// Index of the object within its cell.
+            uint32_t slotIndex;
+        };
+
+        /// Cell index map type.
+        typedef HashMap< uint64_t, uint32_t > CellMapType;
+
+        /// Size of the cells in the finest grid level.
+        float32_t m_cellSize;
+
+        /// Grid cells.
+        DynamicArray< Cell > m_cells;
+        /// Combined bounds of the objects in each cell, in groups of four boxes.
+        DynamicArray< float32_t > m_cellBounds;
+        /// Cell index lookup by grid level and coordinates.
+        CellMapType m_cellMap;
+        /// Indices of cells with bounds that need to be recomputed.
+        DynamicArray< uint32_t > m_dirtyCellIndices;
+
+        /// Grid location of each object, indexed by object ID.
+        DynamicArray< ObjectEntry > m_objects;
+
+        /// @name Private Utility Functions
+        //@{
+        uint32_t GetCellIndex( const Simd::AaBox& rBox );
+        void MarkCellDirty( uint32_t cellIndex );
+
+        void CullInternal(
+            const Simd::Frustum& rFrustum, const Simd::Frustum* pReceiverFrustum, const Simd::Vector3& rSweepDirection,
+            DynamicArray< size_t >& rObjectIds ) const;
+        //@}
+
+        /// @name Private Static Utility Functions
+        //@{
+        static void SetGroupBox( DynamicArray< float32_t >& rBounds, size_t index, const Simd::AaBox& rBox );
+        static void CopyGroupBox( DynamicArray< float32_t >& rBounds, size_t destIndex, size_t sourceIndex );
+
+        static uint32_t TestGroup(
+            const float32_t* pGroup, const Simd::Frustum& rFrustum, const Simd::Frustum* pReceiverFrustum,
+            const Simd::Vector3& rSweepDirection );
+        //@}
+    };
+}
+
+#include "GraphicsTypes/VisibilityGrid.inl"
@@ -0,0 +1,14 @@
+namespace Helium
+{
+    /// Get whether an object has been added to this grid.
+    ///
+    /// @param[in] objectId  ID of the object to check.
+    ///
+    /// @return  True if the object is in this grid, false if not.
+    ///
+    /// @see Update(), Remove()
+    bool VisibilityGrid::Contains( size_t objectId ) const
+    {
+        return ( objectId < m_objects.GetSize() && IsValid( m_objects[ objectId ].cellIndex ) );
+    }
+}
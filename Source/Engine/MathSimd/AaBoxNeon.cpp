@@ -0,0 +1,87 @@
+#include "Precompile.h"
+
+#include "MathSimd/Simd.h"
+
+#if HELIUM_SIMD_NEON
+
+#include "MathSimd/AaBox.h"
+#include "MathSimd/Matrix44.h"
+#include "MathSimd/Matrix44Soa.h"
+#include "MathSimd/Vector3Soa.h"
+
+/// Expand this box to include the given point.
+///
+/// Note that this will expand this box based on whatever current minimum and maximum are set.  If the box is newly
+/// created, this will also include the origin (0, 0, 0).  To prevent including the origin, explicitly set the box
+/// minimum and maximum to the first point in the sample set and expand the box with each subsequent point.
+///
+/// @param[in] rPoint  Point to encompass.
+void Helium::Simd::AaBox::Expand( const Vector3& rPoint )
+{
+    Register pointVec = rPoint.GetSimdVector();
+
+    m_minimum.SetSimdVector( Simd::MinF32( m_minimum.GetSimdVector(), pointVec ) );
+    m_maximum.SetSimdVector( Simd::MaxF32( m_maximum.GetSimdVector(), pointVec ) );
+}
+
+/// Transform this box using the specified transform matrix.
+///
+/// @param[in] rTransform  Matrix by which to transform.
+void Helium::Simd::AaBox::TransformBy( const Matrix44& rTransform )
+{
+    // Expand each corner position.
+    Register minVec = m_minimum.GetSimdVector();
+    Register maxVec = m_maximum.GetSimdVector();
+
+    Vector3Soa corners0;
+    corners0.m_x = Simd::Shuffle< 0, 0, 0, 0 >( minVec, minVec );
+    corners0.m_y = Simd::Shuffle< 1, 1, 1, 1 >( minVec, maxVec );
+    corners0.m_z = Simd::UnpackHigh( minVec, maxVec );
+    corners0.m_z = Simd::MoveLowHigh( corners0.m_z, corners0.m_z );
+
+    Vector3Soa corners1;
+    corners1.m_x = Simd::Shuffle< 0, 0, 0, 0 >( maxVec, maxVec );
+    corners1.m_y = corners0.m_y;
+    corners1.m_z = corners0.m_z;
+
+    // Transform all corners by the provided transformation matrix.
+    Matrix44Soa transformSplat( rTransform );
+    transformSplat.TransformPoint( corners0, corners0 );
+    transformSplat.TransformPoint( corners1, corners1 );
+
+    // Compute the minimum.
+    Register minX = Simd::MinF32( corners0.m_x, corners1.m_x );
+    Register minY = Simd::MinF32( corners0.m_y, corners1.m_y );
+    Register minXYLo = Simd::UnpackLow( minX, minY );
+    Register minXYHi = Simd::UnpackHigh( minX, minY );
+    Register minXY = Simd::MinF32( minXYLo, minXYHi );
+
+    Register minZ = Simd::MinF32( corners0.m_z, corners1.m_z );
+    Register minZLo = Simd::UnpackLow( minZ, minZ );
+    Register minZHi = Simd::UnpackHigh( minZ, minZ );
+    minZ = Simd::MinF32( minZLo, minZHi );
+
+    Register minLo = Simd::MoveLowHigh( minXY, minZ );
+    Register minHi = Simd::MoveHighLow( minZ, minXY );
+
+    m_minimum.SetSimdVector( Simd::MinF32( minLo, minHi ) );
+
+    // Compute the maximum.
+    Register maxX = Simd::MaxF32( corners0.m_x, corners1.m_x );
+    Register maxY = Simd::MaxF32( corners0.m_y, corners1.m_y );
+    Register maxXYLo = Simd::UnpackLow( maxX, maxY );
+    Register maxXYHi = Simd::UnpackHigh( maxX, maxY );
+    Register maxXY = Simd::MaxF32( maxXYLo, maxXYHi );
+
+    Register maxZ = Simd::MaxF32( corners0.m_z, corners1.m_z );
+    Register maxZLo = Simd::UnpackLow( maxZ, maxZ );
+    Register maxZHi = Simd::UnpackHigh( maxZ, maxZ );
+    maxZ = Simd::MaxF32( maxZLo, maxZHi );
+
+    Register maxLo = Simd::MoveLowHigh( maxXY, maxZ );
+    Register maxHi = Simd::MoveHighLow( maxZ, maxXY );
+
+    m_maximum.SetSimdVector( Simd::MaxF32( maxLo, maxHi ) );
+}
+
+#endif  // HELIUM_SIMD_NEON
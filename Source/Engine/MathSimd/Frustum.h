@@ -10,6 +10,7 @@ namespace Helium
         class Plane;
         struct AaBox;
         class Sphere;
+        class Vector3Soa;
 
         /// View frustum.
         HELIUM_SIMD_ALIGN_PRE class HELIUM_MATH_SIMD_API Frustum
@@ -59,6 +60,9 @@ namespace Helium
             bool Contains( const Vector3& rPoint ) const;
             bool Intersects( const AaBox& rBox ) const;
             bool Intersects( const Sphere& rSphere ) const;
+            uint32_t IntersectsSoa( const Vector3Soa& rMinimum, const Vector3Soa& rMaximum ) const;
+            uint32_t IntersectsSweptSoa(
+                const Vector3Soa& rMinimum, const Vector3Soa& rMaximum, const Vector3& rDirection ) const;
             //@}
 
             /// @name Math
@@ -0,0 +1,447 @@
+#include "Precompile.h"
+
+#include "MathSimd/Simd.h"
+
+#if HELIUM_SIMD_NEON
+
+#include "MathSimd/Frustum.h"
+#include "MathSimd/AaBox.h"
+#include "MathSimd/PlaneSoa.h"
+#include "MathSimd/Sphere.h"
+#include "MathSimd/Vector3.h"
+#include "MathSimd/Vector3Soa.h"
+
+/// Test whether this frustum fully contains a given point in world space.
+///
+/// @param[in] rPoint  Point to test.
+///
+/// @return  True if the point is within this frustum, false if not.
+bool Helium::Simd::Frustum::Contains( const Vector3& rPoint ) const
+{
+    // Test the point against each plane set.
+    Vector3Soa pointSplat( rPoint );
+
+    Helium::Simd::Register zeroVec = Helium::Simd::LoadZeros();
+    PlaneSoa planes;
+    for( size_t basePlaneIndex = 0; basePlaneIndex < PLANE_ARRAY_SIZE; basePlaneIndex += 4 )
+    {
+        planes.Load(
+            m_planeA + basePlaneIndex,
+            m_planeB + basePlaneIndex,
+            m_planeC + basePlaneIndex,
+            m_planeD + basePlaneIndex );
+
+        Helium::Simd::Register distances = planes.GetDistance( pointSplat );
+        int resultMask = Simd::GetMaskBits( Helium::Simd::GreaterEqualsF32( distances, zeroVec ) );
+        if( resultMask != 0xf )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Test whether this frustum intersects a given axis-aligned bounding box in world space.
+///
+/// @param[in] rBox  Box to test.
+///
+/// @return  True if the box intersects this frustum, false if not.
+bool Helium::Simd::Frustum::Intersects( const AaBox& rBox ) const
+{
+    Helium::Simd::Register boxMinVec = rBox.GetMinimum().GetSimdVector();
+    Helium::Simd::Register boxMaxVec = rBox.GetMaximum().GetSimdVector();
+
+    Helium::Simd::Register boxX0 = Simd::Shuffle< 0, 0, 0, 0 >( boxMinVec, boxMinVec );
+    Helium::Simd::Register boxX1 = Simd::Shuffle< 0, 0, 0, 0 >( boxMaxVec, boxMaxVec );
+    Helium::Simd::Register boxY = Simd::Shuffle< 1, 1, 1, 1 >( boxMinVec, boxMaxVec );
+    Helium::Simd::Register boxZ = Simd::UnpackHigh( boxMinVec, boxMaxVec );
+    boxZ = Simd::MoveLowHigh( boxZ, boxZ );
+
+    PlaneSoa plane;
+    Vector3Soa points( boxX0, boxY, boxZ );
+    Helium::Simd::Register zeroVec = Helium::Simd::LoadZeros();
+
+    size_t planeCount = ( m_bInfiniteFarClip ? PLANE_FAR : PLANE_MAX );
+    for( size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex )
+    {
+        plane.Load1Splat(
+            m_planeA + planeIndex,
+            m_planeB + planeIndex,
+            m_planeC + planeIndex,
+            m_planeD + planeIndex );
+
+        points.m_x = boxX0;
+        Helium::Simd::Mask containsPoints0 = Helium::Simd::GreaterEqualsF32( plane.GetDistance( points ), zeroVec );
+
+        points.m_x = boxX1;
+        Helium::Simd::Mask containsPoints1 = Helium::Simd::GreaterEqualsF32( plane.GetDistance( points ), zeroVec );
+
+        int resultMask = Simd::GetMaskBits( Helium::Simd::Or( containsPoints0, containsPoints1 ) );
+        if( resultMask == 0 )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Test whether this frustum intersects a given sphere in world space.
+///
+/// @param[in] rSphere  Sphere to test.
+///
+/// @return  True if the sphere intersects this frustum, false if not.
+bool Helium::Simd::Frustum::Intersects( const Sphere& rSphere ) const
+{
+    Helium::Simd::Register sphereVec = rSphere.GetSimdVector();
+
+    Vector3Soa center(
+        Simd::Shuffle< 0, 0, 0, 0 >( sphereVec, sphereVec ),
+        Simd::Shuffle< 1, 1, 1, 1 >( sphereVec, sphereVec ),
+        Simd::Shuffle< 2, 2, 2, 2 >( sphereVec, sphereVec ) );
+
+    Helium::Simd::Register radius = Simd::Shuffle< 3, 3, 3, 3 >( sphereVec, sphereVec );
+
+    Helium::Simd::Register zeroVec = Helium::Simd::LoadZeros();
+    PlaneSoa planes;
+    for( size_t basePlaneIndex = 0; basePlaneIndex < PLANE_ARRAY_SIZE; basePlaneIndex += 4 )
+    {
+        planes.Load(
+            m_planeA + basePlaneIndex,
+            m_planeB + basePlaneIndex,
+            m_planeC + basePlaneIndex,
+            m_planeD + basePlaneIndex );
+
+        Helium::Simd::Register distances = Helium::Simd::AddF32( planes.GetDistance( center ), radius );
+        int resultMask = Simd::GetMaskBits( Helium::Simd::GreaterEqualsF32( distances, zeroVec ) );
+        if( resultMask != 0xf )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Test whether this frustum intersects each of a set of four axis-aligned bounding boxes in world space.
+///
+/// @param[in] rMinimum  Minimum corners of the boxes to test.
+/// @param[in] rMaximum  Maximum corners of the boxes to test.
+///
+/// @return  Mask with bit n set if box n intersects this frustum.
+///
+/// @see Intersects()
+uint32_t Helium::Simd::Frustum::IntersectsSoa( const Vector3Soa& rMinimum, const Vector3Soa& rMaximum ) const
+{
+    PlaneSoa plane;
+    Vector3Soa points;
+    Helium::Simd::Register zeroVec = Helium::Simd::LoadZeros();
+
+    int resultMask = 0xf;
+
+    size_t planeCount = ( m_bInfiniteFarClip ? PLANE_FAR : PLANE_MAX );
+    for( size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex )
+    {
+        plane.Load1Splat(
+            m_planeA + planeIndex,
+            m_planeB + planeIndex,
+            m_planeC + planeIndex,
+            m_planeD + planeIndex );
+
+        // A box is only outside a plane if the corner furthest along the plane normal is outside of it.
+        points.m_x = ( m_planeA[ planeIndex ] >= 0.0f ? rMaximum.m_x : rMinimum.m_x );
+        points.m_y = ( m_planeB[ planeIndex ] >= 0.0f ? rMaximum.m_y : rMinimum.m_y );
+        points.m_z = ( m_planeC[ planeIndex ] >= 0.0f ? rMaximum.m_z : rMinimum.m_z );
+
+        resultMask &= Simd::GetMaskBits( Helium::Simd::GreaterEqualsF32( plane.GetDistance( points ), zeroVec ) );
+        if( resultMask == 0 )
+        {
+            return 0;
+        }
+    }
+
+    return static_cast< uint32_t >( resultMask );
+}
+
+/// Test whether this frustum intersects each of a set of four axis-aligned bounding boxes swept infinitely along a
+/// given direction, such as the region shadowed by a set of shadow casters.
+///
+/// Like IntersectsSoa(), this is conservative: a swept box is only rejected if it lies entirely outside of one of
+/// the frustum planes.
+///
+/// @param[in] rMinimum    Minimum corners of the boxes to test.
+/// @param[in] rMaximum    Maximum corners of the boxes to test.
+/// @param[in] rDirection  Direction along which the boxes are swept.
+///
+/// @return  Mask with bit n set if swept box n intersects this frustum.
+///
+/// @see IntersectsSoa()
+uint32_t Helium::Simd::Frustum::IntersectsSweptSoa(
+    const Vector3Soa& rMinimum,
+    const Vector3Soa& rMaximum,
+    const Vector3& rDirection ) const
+{
+    PlaneSoa plane;
+    Vector3Soa points;
+    Helium::Simd::Register zeroVec = Helium::Simd::LoadZeros();
+
+    float32_t directionX = rDirection.GetElement( 0 );
+    float32_t directionY = rDirection.GetElement( 1 );
+    float32_t directionZ = rDirection.GetElement( 2 );
+
+    int resultMask = 0xf;
+
+    size_t planeCount = ( m_bInfiniteFarClip ? PLANE_FAR : PLANE_MAX );
+    for( size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex )
+    {
+        // Boxes swept toward the inside of a plane always end up crossing it.
+        float32_t planeA = m_planeA[ planeIndex ];
+        float32_t planeB = m_planeB[ planeIndex ];
+        float32_t planeC = m_planeC[ planeIndex ];
+        if( planeA * directionX + planeB * directionY + planeC * directionZ > 0.0f )
+        {
+            continue;
+        }
+
+        plane.Load1Splat(
+            m_planeA + planeIndex,
+            m_planeB + planeIndex,
+            m_planeC + planeIndex,
+            m_planeD + planeIndex );
+
+        // Otherwise, the swept box only gets further away from the plane, so it is outside if the corner furthest
+        // along the plane normal is outside.
+        points.m_x = ( planeA >= 0.0f ? rMaximum.m_x : rMinimum.m_x );
+        points.m_y = ( planeB >= 0.0f ? rMaximum.m_y : rMinimum.m_y );
+        points.m_z = ( planeC >= 0.0f ? rMaximum.m_z : rMinimum.m_z );
+
+        resultMask &= Simd::GetMaskBits( Helium::Simd::GreaterEqualsF32( plane.GetDistance( points ), zeroVec ) );
+        if( resultMask == 0 )
+        {
+            return 0;
+        }
+    }
+
+    return static_cast< uint32_t >( resultMask );
+}
+
+/// Compute the corners of this view frustum.
+///
+/// A view frustum can have either four or eight corners depending on whether a far clip plane exists (eight
+/// corners) or whether an infinite far clip plane is used (four corners).
+///
+/// Note that this assumes that the frustum is always properly defined, with each possible combination of
+/// neighboring clip planes intersecting at a valid point.
+///
+/// @param[out] pCorners  Array in which the frustum corners will be stored.  This must point to a region of memory
+///                       large enough for four points if this frustum has an infinite far clip plane, or eight
+///                       points if this frustum has a normal far clip plane.
+///
+/// @return  Number of clip planes computed (either four or eight).
+size_t Helium::Simd::Frustum::ComputeCorners( Vector3* pCorners ) const
+{
+    HELIUM_ASSERT( pCorners );
+
+    // Compute the corners in struct-of-arrays format.
+    HELIUM_SIMD_ALIGN_PRE float32_t cornersX[ 8 ] HELIUM_SIMD_ALIGN_POST;
+    HELIUM_SIMD_ALIGN_PRE float32_t cornersY[ 8 ] HELIUM_SIMD_ALIGN_POST;
+    HELIUM_SIMD_ALIGN_PRE float32_t cornersZ[ 8 ] HELIUM_SIMD_ALIGN_POST;
+
+    size_t cornerCount = ComputeCornersSoa( cornersX, cornersY, cornersZ );
+    HELIUM_ASSERT( cornerCount == 4 || cornerCount == 8 );
+
+    // Swizzle the results and store in the output array.
+    Helium::Simd::Register cornerXVec = Helium::Simd::LoadAligned( cornersX );
+    Helium::Simd::Register cornerYVec = Helium::Simd::LoadAligned( cornersY );
+    Helium::Simd::Register cornerZVec = Helium::Simd::LoadAligned( cornersZ );
+
+    Helium::Simd::Register xy01 = Simd::UnpackLow( cornerXVec, cornerYVec );
+    Helium::Simd::Register xy23 = Simd::UnpackHigh( cornerXVec, cornerYVec );
+    Helium::Simd::Register zz01 = Simd::UnpackLow( cornerZVec, cornerZVec );
+    Helium::Simd::Register zz23 = Simd::UnpackHigh( cornerZVec, cornerZVec );
+
+    pCorners[ 0 ].SetSimdVector( Simd::MoveLowHigh( xy01, zz01 ) );
+    pCorners[ 1 ].SetSimdVector( Simd::MoveHighLow( zz01, xy01 ) );
+    pCorners[ 2 ].SetSimdVector( Simd::MoveLowHigh( xy23, zz23 ) );
+    pCorners[ 3 ].SetSimdVector( Simd::MoveHighLow( zz23, xy23 ) );
+
+    if( cornerCount == 8 )
+    {
+        cornerXVec = Helium::Simd::LoadAligned( cornersX + 4 );
+        cornerYVec = Helium::Simd::LoadAligned( cornersY + 4 );
+        cornerZVec = Helium::Simd::LoadAligned( cornersZ + 4 );
+
+        xy01 = Simd::UnpackLow( cornerXVec, cornerYVec );
+        xy23 = Simd::UnpackHigh( cornerXVec, cornerYVec );
+        zz01 = Simd::UnpackLow( cornerZVec, cornerZVec );
+        zz23 = Simd::UnpackHigh( cornerZVec, cornerZVec );
+
+        pCorners[ 4 ].SetSimdVector( Simd::MoveLowHigh( xy01, zz01 ) );
+        pCorners[ 5 ].SetSimdVector( Simd::MoveHighLow( zz01, xy01 ) );
+        pCorners[ 6 ].SetSimdVector( Simd::MoveLowHigh( xy23, zz23 ) );
+        pCorners[ 7 ].SetSimdVector( Simd::MoveHighLow( zz23, xy23 ) );
+    }
+
+    return cornerCount;
+}
+
+/// Compute the corners of this view frustum, outputting the result in separate arrays for each component.
+///
+/// A view frustum can have either four or eight corners depending on whether a far clip plane exists (eight
+/// corners) or whether an infinite far clip plane is used (four corners).
+///
+/// Note that this assumes that the frustum is always properly defined, with each possible combination of
+/// neighboring clip planes intersecting at a valid point.
+///
+/// @param[out] pCornersX  SIMD-aligned array in which the frustum corner x coordinates will be stored.  This must
+///                        point to a region of memory large enough for four points if this frustum has an infinite
+///                        far clip plane, or eight points if this frustum has a normal far clip plane.
+/// @param[out] pCornersY  SIMD-aligned array in which the frustum corner y coordinates will be stored.  This must
+///                        point to a region of memory large enough for four points if this frustum has an infinite
+///                        far clip plane, or eight points if this frustum has a normal far clip plane.
+/// @param[out] pCornersZ  SIMD-aligned array in which the frustum corner z coordinates will be stored.  This must
+///                        point to a region of memory large enough for four points if this frustum has an infinite
+///                        far clip plane, or eight points if this frustum has a normal far clip plane.
+///
+/// @return  Number of clip planes computed (either four or eight).
+size_t Helium::Simd::Frustum::ComputeCornersSoa( float32_t* pCornersX, float32_t* pCornersY, float32_t* pCornersZ ) const
+{
+    HELIUM_ASSERT( pCornersX );
+    HELIUM_ASSERT( pCornersY );
+    HELIUM_ASSERT( pCornersZ );
+
+    // Load the plane combinations used to compute the four corners on the near clip plane.
+    Helium::Simd::Register plane0A = Helium::Simd::LoadAligned( m_planeA );
+    Helium::Simd::Register plane0B = Helium::Simd::LoadAligned( m_planeB );
+    Helium::Simd::Register plane0C = Helium::Simd::LoadAligned( m_planeC );
+    Helium::Simd::Register plane0D = Helium::Simd::LoadAligned( m_planeD );
+
+    Helium::Simd::Register plane1A = Simd::Shuffle< 2, 3, 1, 0 >( plane0A, plane0A );
+    Helium::Simd::Register plane1B = Simd::Shuffle< 2, 3, 1, 0 >( plane0B, plane0B );
+    Helium::Simd::Register plane1C = Simd::Shuffle< 2, 3, 1, 0 >( plane0C, plane0C );
+    Helium::Simd::Register plane1D = Simd::Shuffle< 2, 3, 1, 0 >( plane0D, plane0D );
+
+    Helium::Simd::Register plane2A = Helium::Simd::LoadSplat32( m_planeA + PLANE_NEAR );
+    Helium::Simd::Register plane2B = Helium::Simd::LoadSplat32( m_planeB + PLANE_NEAR );
+    Helium::Simd::Register plane2C = Helium::Simd::LoadSplat32( m_planeC + PLANE_NEAR );
+    Helium::Simd::Register plane2D = Helium::Simd::LoadSplat32( m_planeD + PLANE_NEAR );
+
+    // Compute all four near clip corners.
+    Helium::Simd::Register detAB = Simd::SubtractF32( Simd::MultiplyF32( plane0A, plane1B ), Simd::MultiplyF32( plane0B, plane1A ) );
+    Helium::Simd::Register detAC = Simd::SubtractF32( Simd::MultiplyF32( plane0A, plane1C ), Simd::MultiplyF32( plane0C, plane1A ) );
+    Helium::Simd::Register detBC = Simd::SubtractF32( Simd::MultiplyF32( plane0B, plane1C ), Simd::MultiplyF32( plane0C, plane1B ) );
+
+    Helium::Simd::Register detAD = Simd::SubtractF32( Simd::MultiplyF32( plane0A, plane1D ), Simd::MultiplyF32( plane0D, plane1A ) );
+    Helium::Simd::Register detBD = Simd::SubtractF32( Simd::MultiplyF32( plane0B, plane1D ), Simd::MultiplyF32( plane0D, plane1B ) );
+    Helium::Simd::Register detDC = Simd::SubtractF32( Simd::MultiplyF32( plane0D, plane1C ), Simd::MultiplyF32( plane0C, plane1D ) );
+
+    // XXX: Denominator sign is flipped here to handle the fact our plane D component is the negative distance from
+    // the origin (sign gets flipped when placed at the opposite side of the linear equation set for each plane when
+    // solving).
+    //
+    // Our plane equation:
+    //     Ax + By + Cz + D = 0
+    ///
+    // ...in the form needed for solving using Cramer's rule:
+    //     Ax + By + Cz = -D
+    Helium::Simd::Register denominator = Simd::InverseF32(
+        Simd::SubtractF32(
+            Simd::MultiplyF32( plane2B, detAC ),
+            Simd::AddF32(
+                Simd::MultiplyF32( plane2A, detBC ),
+                Simd::MultiplyF32( plane2C, detAB ) ) ) );
+
+    //Helium::Simd::Register cornerXVec = Simd::MultiplyF32(
+    //    Simd::AddF32(
+    //        Simd::SubtractF32(
+    //            Simd::MultiplyF32( plane2D, detBC ),
+    //            Simd::MultiplyF32( plane2B, detDC ) ),
+    //        Simd::MultiplyF32( plane2C, detDB ) ),
+    //    denominator );
+    Helium::Simd::Register cornerXVec = Simd::MultiplyF32(
+        Simd::SubtractF32(  // Note that we subtract...
+            Simd::SubtractF32(
+                Simd::MultiplyF32( plane2D, detBC ),
+                Simd::MultiplyF32( plane2B, detDC ) ),
+            Simd::MultiplyF32( plane2C, detBD ) ),  // ...because the 2x2 sub-matrix components are switched here.
+        denominator );
+
+    Helium::Simd::Register cornerYVec = Simd::MultiplyF32(
+        Simd::AddF32(
+            Simd::SubtractF32(
+                Simd::MultiplyF32( plane2A, detDC ),
+                Simd::MultiplyF32( plane2D, detAC ) ),
+            Simd::MultiplyF32( plane2C, detAD ) ),
+        denominator );
+
+    Helium::Simd::Register cornerZVec = Simd::MultiplyF32(
+        Simd::AddF32(
+            Simd::SubtractF32(
+                Simd::MultiplyF32( plane2A, detBD ),
+                Simd::MultiplyF32( plane2B, detAD ) ),
+            Simd::MultiplyF32( plane2D, detAB ) ),
+        denominator );
+
+    Helium::Simd::StoreAligned( pCornersX, cornerXVec );
+    Helium::Simd::StoreAligned( pCornersY, cornerYVec );
+    Helium::Simd::StoreAligned( pCornersZ, cornerZVec );
+
+    // If this frustum has an infinite far clip plane, we are done.
+    if( m_bInfiniteFarClip )
+    {
+        return 4;
+    }
+
+    // Compute the far clip plane corners, reusing data from the near clip plane corner calculations where possible.
+    plane2A = Helium::Simd::LoadSplat32( m_planeA + PLANE_FAR );
+    plane2B = Helium::Simd::LoadSplat32( m_planeB + PLANE_FAR );
+    plane2C = Helium::Simd::LoadSplat32( m_planeC + PLANE_FAR );
+    plane2D = Helium::Simd::LoadSplat32( m_planeD + PLANE_FAR );
+
+    denominator = Simd::InverseF32(
+        Simd::SubtractF32(
+            Simd::MultiplyF32( plane2B, detAC ),
+            Simd::AddF32(
+                Simd::MultiplyF32( plane2A, detBC ),
+                Simd::MultiplyF32( plane2C, detAB ) ) ) );
+
+    //cornerXVec = Simd::MultiplyF32(
+    //    Simd::AddF32(
+    //        Simd::SubtractF32(
+    //            Simd::MultiplyF32( plane2D, detBC ),
+    //            Simd::MultiplyF32( plane2B, detDC ) ),
+    //        Simd::MultiplyF32( plane2C, detDB ) ),
+    //    denominator );
+    cornerXVec = Simd::MultiplyF32(
+        Simd::SubtractF32(  // Note that we subtract...
+            Simd::SubtractF32(
+                Simd::MultiplyF32( plane2D, detBC ),
+                Simd::MultiplyF32( plane2B, detDC ) ),
+            Simd::MultiplyF32( plane2C, detBD ) ),  // ...because the 2x2 sub-matrix components are switched here.
+        denominator );
+
+    cornerYVec = Simd::MultiplyF32(
+        Simd::AddF32(
+            Simd::SubtractF32(
+                Simd::MultiplyF32( plane2A, detDC ),
+                Simd::MultiplyF32( plane2D, detAC ) ),
+            Simd::MultiplyF32( plane2C, detAD ) ),
+        denominator );
+
+    cornerZVec = Simd::MultiplyF32(
+        Simd::AddF32(
+            Simd::SubtractF32(
+                Simd::MultiplyF32( plane2A, detBD ),
+                Simd::MultiplyF32( plane2B, detAD ) ),
+            Simd::MultiplyF32( plane2D, detAB ) ),
+        denominator );
+
+    Helium::Simd::StoreAligned( pCornersX + 4, cornerXVec );
+    Helium::Simd::StoreAligned( pCornersY + 4, cornerYVec );
+    Helium::Simd::StoreAligned( pCornersZ + 4, cornerZVec );
+
+    return 8;
+}
+
+#endif  // HELIUM_SIMD_NEON
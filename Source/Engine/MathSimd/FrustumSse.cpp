@@ -124,6 +124,108 @@ bool Helium::Simd::Frustum::Intersects( const Sphere& rSphere ) const
     return true;
 }
 
+/// Test whether this frustum intersects each of a set of four axis-aligned bounding boxes in world space.
+///
+/// @param[in] rMinimum  Minimum corners of the boxes to test.
+/// @param[in] rMaximum  Maximum corners of the boxes to test.
+///
+/// @return  Mask with bit n set if box n intersects this frustum.
+///
+/// @see Intersects()
+uint32_t Helium::Simd::Frustum::IntersectsSoa( const Vector3Soa& rMinimum, const Vector3Soa& rMaximum ) const
+{
+    PlaneSoa plane;
+    Vector3Soa points;
+    Helium::Simd::Register zeroVec = Helium::Simd::LoadZeros();
+
+    int resultMask = 0xf;
+
+    size_t planeCount = ( m_bInfiniteFarClip ? PLANE_FAR : PLANE_MAX );
+    for( size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex )
+    {
+        plane.Load1Splat(
+            m_planeA + planeIndex,
+            m_planeB + planeIndex,
+            m_planeC + planeIndex,
+            m_planeD + planeIndex );
+
+        // A box is only outside a plane if the corner furthest along the plane normal is outside of it.
+        points.m_x = ( m_planeA[ planeIndex ] >= 0.0f ? rMaximum.m_x : rMinimum.m_x );
+        points.m_y = ( m_planeB[ planeIndex ] >= 0.0f ? rMaximum.m_y : rMinimum.m_y );
+        points.m_z = ( m_planeC[ planeIndex ] >= 0.0f ? rMaximum.m_z : rMinimum.m_z );
+
+        resultMask &= _mm_movemask_ps( Helium::Simd::GreaterEqualsF32( plane.GetDistance( points ), zeroVec ) );
+        if( resultMask == 0 )
+        {
+            return 0;
+        }
+    }
+
+    return static_cast< uint32_t >( resultMask );
+}
+
+/// Test whether this frustum intersects each of a set of four axis-aligned bounding boxes swept infinitely along a
+/// given direction, such as the region shadowed by a set of shadow casters.
+///
+/// Like IntersectsSoa(), this is conservative: a swept box is only rejected if it lies entirely outside of one of
+/// the frustum planes.
+///
+/// @param[in] rMinimum    Minimum corners of the boxes to test.
+/// @param[in] rMaximum    Maximum corners of the boxes to test.
+/// @param[in] rDirection  Direction along which the boxes are swept.
+///
+/// @return  Mask with bit n set if swept box n intersects this frustum.
+///
+/// @see IntersectsSoa()
+uint32_t Helium::Simd::Frustum::IntersectsSweptSoa(
+    const Vector3Soa& rMinimum,
+    const Vector3Soa& rMaximum,
+    const Vector3& rDirection ) const
+{
+    PlaneSoa plane;
+    Vector3Soa points;
+    Helium::Simd::Register zeroVec = Helium::Simd::LoadZeros();
+
+    float32_t directionX = rDirection.GetElement( 0 );
+    float32_t directionY = rDirection.GetElement( 1 );
+    float32_t directionZ = rDirection.GetElement( 2 );
+
+    int resultMask = 0xf;
+
+    size_t planeCount = ( m_bInfiniteFarClip ? PLANE_FAR : PLANE_MAX );
+    for( size_t planeIndex = 0; planeIndex < planeCount; ++planeIndex )
+    {
+        // Boxes swept toward the inside of a plane always end up crossing it.
+        float32_t planeA = m_planeA[ planeIndex ];
+        float32_t planeB = m_planeB[ planeIndex ];
+        float32_t planeC = m_planeC[ planeIndex ];
+        if( planeA * directionX + planeB * directionY + planeC * directionZ > 0.0f )
+        {
+            continue;
+        }
+
+        plane.Load1Splat(
+            m_planeA + planeIndex,
+            m_planeB + planeIndex,
+            m_planeC + planeIndex,
+            m_planeD + planeIndex );
+
+        // Otherwise, the swept box only gets further away from the plane, so it is outside if the corner furthest
+        // along the plane normal is outside.
+        points.m_x = ( planeA >= 0.0f ? rMaximum.m_x : rMinimum.m_x );
+        points.m_y = ( planeB >= 0.0f ? rMaximum.m_y : rMinimum.m_y );
+        points.m_z = ( planeC >= 0.0f ? rMaximum.m_z : rMinimum.m_z );
+
+        resultMask &= _mm_movemask_ps( Helium::Simd::GreaterEqualsF32( plane.GetDistance( points ), zeroVec ) );
+        if( resultMask == 0 )
+        {
+            return 0;
+        }
+    }
+
+    return static_cast< uint32_t >( resultMask );
+}
+
 /// Compute the corners of this view frustum.
 ///
 /// A view frustum can have either four or eight corners depending on whether a far clip plane exists (eight
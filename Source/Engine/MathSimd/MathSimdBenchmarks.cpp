@@ -0,0 +1,528 @@
+#include "Platform/Timer.h"
+#include "Foundation/DynamicArray.h"
+
+#include "MathSimd/AaBox.h"
+#include "MathSimd/Frustum.h"
+#include "MathSimd/Matrix44.h"
+#include "MathSimd/QuatSoa.h"
+#include "MathSimd/Sphere.h"
+#include "MathSimd/Vector3Soa.h"
+
+#include <new>
+#include <stdio.h>
+#include <string.h>
+
+using namespace Helium;
+using namespace Helium::Simd;
+
+/// Kernel microbenchmarks for MathSimd.
+///
+/// Each kernel is timed over arrays of several sizes (small enough to stay in L1, in L2, and well past both) so that
+/// changes to arithmetic throughput can be told apart from changes in memory behavior.  Results are written to
+/// standard output as one JSON object per line:
+///
+///     {"benchmark":"Matrix44::MultiplySet","simd":"sse","batch":256,"iterations":...,"ns_per_op":...,"ops_per_sec":...}
+///
+/// An "op" is one element of the batch (one matrix, one box, or one SoA lane), so results are comparable across batch
+/// sizes and across backends with different register widths.  Pass a substring as the first argument to run only the
+/// matching benchmarks.
+
+/// Element counts at which each kernel is run.
+static const size_t BATCH_SIZES[] = { 16, 256, 4096, 65536 };
+
+/// Minimum time to spend timing each kernel and batch size, in seconds.
+static const float64_t MIN_BENCHMARK_SECONDS = 0.25;
+
+/// Sink for kernel results so that the compiler cannot discard the work being timed.
+static volatile float32_t s_sink;
+
+/// Kernel callback.
+///
+/// @param[in] pContext   Kernel data.
+/// @param[in] batchSize  Number of elements to process.
+typedef void ( *KERNEL_CALLBACK )( void* pContext, size_t batchSize );
+
+/// Get the name of the SIMD backend being measured.
+///
+/// @return  Backend name.
+static const char* GetSimdBackendName()
+{
+#if HELIUM_SIMD_SSE
+#if HELIUM_SIMD_SSE_FMA
+    return "sse-fma";
+#else
+    return "sse";
+#endif
+#elif HELIUM_SIMD_NEON
+    return "neon";
+#else
+    return "none";
+#endif
+}
+
+/// Allocate an array of SIMD-aligned elements.
+///
+/// @param[in] count  Number of elements.
+///
+/// @return  Uninitialized element array.  Release with FreeArray().
+template< typename T >
+static T* AllocateArray( size_t count )
+{
+    return static_cast< T* >( DefaultAllocator().AllocateAligned( HELIUM_SIMD_ALIGNMENT, sizeof( T ) * count ) );
+}
+
+/// Release an array allocated with AllocateArray().
+///
+/// @param[in] pArray  Array to release.
+static void FreeArray( void* pArray )
+{
+    DefaultAllocator().FreeAligned( pArray );
+}
+
+/// Get a deterministic pseudo-random value in the range [-1, 1].
+///
+/// @param[in,out] rSeed  Generator state.
+///
+/// @return  Pseudo-random value.
+static float32_t GetRandomValue( uint32_t& rSeed )
+{
+    rSeed = rSeed * 1664525 + 1013904223;
+
+    return static_cast< float32_t >( rSeed >> 8 ) * ( 2.0f / 16777216.0f ) - 1.0f;
+}
+
+/// Time a kernel at one batch size and print the result.
+///
+/// @param[in] pName      Benchmark name.
+/// @param[in] pCallback  Kernel to run.
+/// @param[in] pContext   Kernel data.
+/// @param[in] batchSize  Number of elements to process per kernel invocation.
+static void RunBenchmark( const char* pName, KERNEL_CALLBACK pCallback, void* pContext, size_t batchSize )
+{
+    // Warm the caches and branch predictors before timing.
+    pCallback( pContext, batchSize );
+
+    const uint64_t minTicks =
+        static_cast< uint64_t >( MIN_BENCHMARK_SECONDS * static_cast< float64_t >( Timer::GetTicksPerSecond() ) );
+
+    // Double the iteration count until a single timed run is long enough to swamp the timer resolution.
+    uint64_t iterationCount = 1;
+    uint64_t elapsedTicks = 0;
+    for( ; ; )
+    {
+        uint64_t startTicks = Timer::GetTickCount();
+        for( uint64_t iteration = 0; iteration < iterationCount; ++iteration )
+        {
+            pCallback( pContext, batchSize );
+        }
+        elapsedTicks = Timer::GetTickCount() - startTicks;
+
+        if( elapsedTicks >= minTicks )
+        {
+            break;
+        }
+
+        iterationCount *= 2;
+    }
+
+    float64_t opCount = static_cast< float64_t >( iterationCount ) * static_cast< float64_t >( batchSize );
+    float64_t seconds = static_cast< float64_t >( elapsedTicks ) * Timer::GetSecondsPerTick();
+
+    printf(
+        "{\"benchmark\":\"%s\",\"simd\":\"%s\",\"batch\":%u,\"iterations\":%llu,\"ns_per_op\":%.3f,"
+        "\"ops_per_sec\":%.1f}\n",
+        pName,
+        GetSimdBackendName(),
+        static_cast< unsigned int >( batchSize ),
+        static_cast< unsigned long long >( iterationCount ),
+        seconds * 1.0e9 / opCount,
+        opCount / seconds );
+    fflush( stdout );
+}
+
+/// Matrix kernel data.
+struct MatrixContext
+{
+    /// Source matrices.
+    Matrix44* pMatrices0;
+    /// Source matrices.
+    Matrix44* pMatrices1;
+    /// Result matrices.
+    Matrix44* pResults;
+};
+
+/// Multiply pairs of matrices.
+static void MatrixMultiplyKernel( void* pContext, size_t batchSize )
+{
+    MatrixContext& rContext = *static_cast< MatrixContext* >( pContext );
+    for( size_t index = 0; index < batchSize; ++index )
+    {
+        rContext.pResults[ index ].MultiplySet( rContext.pMatrices0[ index ], rContext.pMatrices1[ index ] );
+    }
+
+    s_sink = rContext.pResults[ 0 ].GetElement( 0 );
+}
+
+/// Invert matrices.
+static void MatrixInverseKernel( void* pContext, size_t batchSize )
+{
+    MatrixContext& rContext = *static_cast< MatrixContext* >( pContext );
+    for( size_t index = 0; index < batchSize; ++index )
+    {
+        rContext.pMatrices0[ index ].GetInverse( rContext.pResults[ index ] );
+    }
+
+    s_sink = rContext.pResults[ 0 ].GetElement( 0 );
+}
+
+/// Multiply pairs of matrices with a single batch call.
+static void MatrixMultiplyArrayKernel( void* pContext, size_t batchSize )
+{
+    MatrixContext& rContext = *static_cast< MatrixContext* >( pContext );
+    Matrix44::MultiplyArray( rContext.pMatrices0, rContext.pMatrices1, rContext.pResults, batchSize );
+
+    s_sink = rContext.pResults[ 0 ].GetElement( 0 );
+}
+
+/// Invert affine matrices with a single batch call.
+static void MatrixInvertAffineArrayKernel( void* pContext, size_t batchSize )
+{
+    MatrixContext& rContext = *static_cast< MatrixContext* >( pContext );
+    Matrix44::InvertAffineArray( rContext.pMatrices0, rContext.pResults, batchSize );
+
+    s_sink = rContext.pResults[ 0 ].GetElement( 0 );
+}
+
+/// Frustum kernel data.
+struct FrustumContext
+{
+    /// Frustum to test against.
+    Frustum frustum;
+    /// Boxes to test.
+    AaBox* pBoxes;
+    /// Spheres to test.
+    Sphere* pSpheres;
+    /// SoA box minimum corners (four boxes per element).
+    Vector3Soa* pBoxMinimums;
+    /// SoA box maximum corners (four boxes per element).
+    Vector3Soa* pBoxMaximums;
+};
+
+/// Test boxes against a frustum.
+static void FrustumBoxKernel( void* pContext, size_t batchSize )
+{
+    FrustumContext& rContext = *static_cast< FrustumContext* >( pContext );
+
+    uint32_t visibleCount = 0;
+    for( size_t index = 0; index < batchSize; ++index )
+    {
+        visibleCount += rContext.frustum.Intersects( rContext.pBoxes[ index ] );
+    }
+
+    s_sink = static_cast< float32_t >( visibleCount );
+}
+
+/// Test spheres against a frustum.
+static void FrustumSphereKernel( void* pContext, size_t batchSize )
+{
+    FrustumContext& rContext = *static_cast< FrustumContext* >( pContext );
+
+    uint32_t visibleCount = 0;
+    for( size_t index = 0; index < batchSize; ++index )
+    {
+        visibleCount += rContext.frustum.Intersects( rContext.pSpheres[ index ] );
+    }
+
+    s_sink = static_cast< float32_t >( visibleCount );
+}
+
+/// Test boxes against a frustum four at a time.
+static void FrustumBoxSoaKernel( void* pContext, size_t batchSize )
+{
+    FrustumContext& rContext = *static_cast< FrustumContext* >( pContext );
+
+    uint32_t visibleMask = 0;
+    for( size_t index = 0; index < batchSize / 4; ++index )
+    {
+        visibleMask ^= rContext.frustum.IntersectsSoa( rContext.pBoxMinimums[ index ], rContext.pBoxMaximums[ index ] );
+    }
+
+    s_sink = static_cast< float32_t >( visibleMask );
+}
+
+/// SoA vector and quaternion kernel data (four lanes per element).
+struct SoaContext
+{
+    /// Source vectors.
+    Vector3Soa* pVectors0;
+    /// Source vectors.
+    Vector3Soa* pVectors1;
+    /// Result vectors.
+    Vector3Soa* pVectorResults;
+
+    /// Source quaternions.
+    QuatSoa* pQuats0;
+    /// Source quaternions.
+    QuatSoa* pQuats1;
+    /// Result quaternions.
+    QuatSoa* pQuatResults;
+};
+
+/// Compute normalized cross products of SoA vectors.
+static void Vector3SoaCrossNormalizeKernel( void* pContext, size_t batchSize )
+{
+    SoaContext& rContext = *static_cast< SoaContext* >( pContext );
+    for( size_t index = 0; index < batchSize / 4; ++index )
+    {
+        Vector3Soa& rResult = rContext.pVectorResults[ index ];
+        rResult.CrossSet( rContext.pVectors0[ index ], rContext.pVectors1[ index ] );
+        rResult.Normalize();
+    }
+
+    Simd::Store32( const_cast< float32_t* >( &s_sink ), rContext.pVectorResults[ 0 ].m_x );
+}
+
+/// Compute dot products of SoA vectors.
+static void Vector3SoaDotKernel( void* pContext, size_t batchSize )
+{
+    SoaContext& rContext = *static_cast< SoaContext* >( pContext );
+
+    Register sum = Simd::LoadZeros();
+    for( size_t index = 0; index < batchSize / 4; ++index )
+    {
+        sum = Simd::AddF32( sum, rContext.pVectors0[ index ].Dot( rContext.pVectors1[ index ] ) );
+    }
+
+    Simd::Store32( const_cast< float32_t* >( &s_sink ), sum );
+}
+
+/// Blend between pairs of SoA quaternions (normalized linear interpolation).
+static void QuatSoaBlendKernel( void* pContext, size_t batchSize )
+{
+    SoaContext& rContext = *static_cast< SoaContext* >( pContext );
+
+    Register weight1 = Simd::SetSplatF32( 0.3f );
+    Register weight0 = Simd::SetSplatF32( 0.7f );
+    QuatSoa weights0( weight0, weight0, weight0, weight0 );
+    QuatSoa weights1( weight1, weight1, weight1, weight1 );
+
+    for( size_t index = 0; index < batchSize / 4; ++index )
+    {
+        QuatSoa& rResult = rContext.pQuatResults[ index ];
+        rResult.AddSet(
+            rContext.pQuats0[ index ].MultiplyComponents( weights0 ),
+            rContext.pQuats1[ index ].MultiplyComponents( weights1 ) );
+        rResult.Normalize();
+    }
+
+    Simd::Store32( const_cast< float32_t* >( &s_sink ), rContext.pQuatResults[ 0 ].m_w );
+}
+
+/// Multiply pairs of SoA quaternions.
+static void QuatSoaMultiplyKernel( void* pContext, size_t batchSize )
+{
+    SoaContext& rContext = *static_cast< SoaContext* >( pContext );
+    for( size_t index = 0; index < batchSize / 4; ++index )
+    {
+        rContext.pQuatResults[ index ].MultiplySet( rContext.pQuats0[ index ], rContext.pQuats1[ index ] );
+    }
+
+    Simd::Store32( const_cast< float32_t* >( &s_sink ), rContext.pQuatResults[ 0 ].m_w );
+}
+
+/// Compute the sine and cosine of SoA lanes.
+static void SinCosKernel( void* pContext, size_t batchSize )
+{
+    SoaContext& rContext = *static_cast< SoaContext* >( pContext );
+    for( size_t index = 0; index < batchSize / 4; ++index )
+    {
+        Vector3Soa& rResult = rContext.pVectorResults[ index ];
+        Simd::SinCosF32( rContext.pVectors0[ index ].m_x, rResult.m_x, rResult.m_y );
+    }
+
+    Simd::Store32( const_cast< float32_t* >( &s_sink ), rContext.pVectorResults[ 0 ].m_x );
+}
+
+/// Compute the angle of SoA 2D vectors.
+static void Atan2Kernel( void* pContext, size_t batchSize )
+{
+    SoaContext& rContext = *static_cast< SoaContext* >( pContext );
+    for( size_t index = 0; index < batchSize / 4; ++index )
+    {
+        const Vector3Soa& rVector = rContext.pVectors0[ index ];
+        rContext.pVectorResults[ index ].m_x = Simd::Atan2F32( rVector.m_y, rVector.m_x );
+    }
+
+    Simd::Store32( const_cast< float32_t* >( &s_sink ), rContext.pVectorResults[ 0 ].m_x );
+}
+
+/// Round-trip SoA lanes through an exponential and a logarithm.
+static void ExpLogKernel( void* pContext, size_t batchSize )
+{
+    SoaContext& rContext = *static_cast< SoaContext* >( pContext );
+    for( size_t index = 0; index < batchSize / 4; ++index )
+    {
+        rContext.pVectorResults[ index ].m_x = Simd::LogF32( Simd::ExpF32( rContext.pVectors0[ index ].m_x ) );
+    }
+
+    Simd::Store32( const_cast< float32_t* >( &s_sink ), rContext.pVectorResults[ 0 ].m_x );
+}
+
+/// Benchmark registration.
+struct Benchmark
+{
+    /// Benchmark name.
+    const char* pName;
+    /// Kernel to run.
+    KERNEL_CALLBACK pCallback;
+    /// Kernel data.
+    void* pContext;
+};
+
+int main( int argc, const char* argv[] )
+{
+    const char* pFilter = ( argc > 1 ? argv[ 1 ] : NULL );
+
+    const size_t maxBatchSize = BATCH_SIZES[ HELIUM_ARRAY_COUNT( BATCH_SIZES ) - 1 ];
+    const size_t maxSoaCount = maxBatchSize / 4;
+
+    uint32_t seed = 1;
+
+    // Rigid transforms with a little scale so that every matrix is invertible.
+    MatrixContext matrixContext;
+    matrixContext.pMatrices0 = AllocateArray< Matrix44 >( maxBatchSize );
+    matrixContext.pMatrices1 = AllocateArray< Matrix44 >( maxBatchSize );
+    matrixContext.pResults = AllocateArray< Matrix44 >( maxBatchSize );
+    for( size_t index = 0; index < maxBatchSize; ++index )
+    {
+        Quat rotation0( GetRandomValue( seed ), GetRandomValue( seed ), GetRandomValue( seed ) );
+        Quat rotation1( GetRandomValue( seed ), GetRandomValue( seed ), GetRandomValue( seed ) );
+        Vector3 translation0( GetRandomValue( seed ), GetRandomValue( seed ), GetRandomValue( seed ) );
+        Vector3 translation1( GetRandomValue( seed ), GetRandomValue( seed ), GetRandomValue( seed ) );
+
+        new( &matrixContext.pMatrices0[ index ] ) Matrix44(
+            Matrix44::INIT_ROTATION_TRANSLATION_SCALING, rotation0, translation0, 1.5f + GetRandomValue( seed ) );
+        new( &matrixContext.pMatrices1[ index ] ) Matrix44(
+            Matrix44::INIT_ROTATION_TRANSLATION_SCALING, rotation1, translation1, 1.5f + GetRandomValue( seed ) );
+        new( &matrixContext.pResults[ index ] ) Matrix44();
+    }
+
+    // A camera at the origin looking down +z, with objects scattered around it so that roughly half are visible.
+    Matrix44 projection( Matrix44::INIT_PERSPECTIVE_PROJECTION, 1.5707963f, 16.0f / 9.0f, 0.1f, 100.0f );
+
+    FrustumContext frustumContext;
+    frustumContext.frustum.Set( projection.GetInverse().GetTranspose() );
+    frustumContext.pBoxes = AllocateArray< AaBox >( maxBatchSize );
+    frustumContext.pSpheres = AllocateArray< Sphere >( maxBatchSize );
+    frustumContext.pBoxMinimums = AllocateArray< Vector3Soa >( maxSoaCount );
+    frustumContext.pBoxMaximums = AllocateArray< Vector3Soa >( maxSoaCount );
+
+    HELIUM_SIMD_ALIGN_PRE float32_t boxValues[ 6 ][ 4 ] HELIUM_SIMD_ALIGN_POST;
+    for( size_t index = 0; index < maxBatchSize; ++index )
+    {
+        Vector3 center( GetRandomValue( seed ) * 100.0f, GetRandomValue( seed ) * 100.0f, GetRandomValue( seed ) * 100.0f );
+        float32_t halfExtent = 1.0f + GetRandomValue( seed ) * 0.5f;
+        Vector3 extent( halfExtent, halfExtent, halfExtent );
+
+        new( &frustumContext.pBoxes[ index ] ) AaBox( center - extent, center + extent );
+        new( &frustumContext.pSpheres[ index ] ) Sphere( center, halfExtent );
+
+        size_t lane = index % 4;
+        for( size_t axis = 0; axis < 3; ++axis )
+        {
+            boxValues[ axis ][ lane ] = center.GetElement( axis ) - halfExtent;
+            boxValues[ axis + 3 ][ lane ] = center.GetElement( axis ) + halfExtent;
+        }
+
+        if( lane == 3 )
+        {
+            new( &frustumContext.pBoxMinimums[ index / 4 ] ) Vector3Soa( boxValues[ 0 ], boxValues[ 1 ], boxValues[ 2 ] );
+            new( &frustumContext.pBoxMaximums[ index / 4 ] ) Vector3Soa( boxValues[ 3 ], boxValues[ 4 ], boxValues[ 5 ] );
+        }
+    }
+
+    SoaContext soaContext;
+    soaContext.pVectors0 = AllocateArray< Vector3Soa >( maxSoaCount );
+    soaContext.pVectors1 = AllocateArray< Vector3Soa >( maxSoaCount );
+    soaContext.pVectorResults = AllocateArray< Vector3Soa >( maxSoaCount );
+    soaContext.pQuats0 = AllocateArray< QuatSoa >( maxSoaCount );
+    soaContext.pQuats1 = AllocateArray< QuatSoa >( maxSoaCount );
+    soaContext.pQuatResults = AllocateArray< QuatSoa >( maxSoaCount );
+
+    HELIUM_SIMD_ALIGN_PRE float32_t soaValues[ 4 ][ 4 ] HELIUM_SIMD_ALIGN_POST;
+    for( size_t index = 0; index < maxSoaCount; ++index )
+    {
+        for( size_t component = 0; component < 4; ++component )
+        {
+            for( size_t lane = 0; lane < 4; ++lane )
+            {
+                soaValues[ component ][ lane ] = GetRandomValue( seed );
+            }
+        }
+        new( &soaContext.pVectors0[ index ] ) Vector3Soa( soaValues[ 0 ], soaValues[ 1 ], soaValues[ 2 ] );
+        new( &soaContext.pQuats0[ index ] ) QuatSoa( soaValues[ 0 ], soaValues[ 1 ], soaValues[ 2 ], soaValues[ 3 ] );
+        soaContext.pQuats0[ index ].Normalize();
+
+        for( size_t component = 0; component < 4; ++component )
+        {
+            for( size_t lane = 0; lane < 4; ++lane )
+            {
+                soaValues[ component ][ lane ] = GetRandomValue( seed );
+            }
+        }
+        new( &soaContext.pVectors1[ index ] ) Vector3Soa( soaValues[ 0 ], soaValues[ 1 ], soaValues[ 2 ] );
+        new( &soaContext.pQuats1[ index ] ) QuatSoa( soaValues[ 0 ], soaValues[ 1 ], soaValues[ 2 ], soaValues[ 3 ] );
+        soaContext.pQuats1[ index ].Normalize();
+
+        new( &soaContext.pVectorResults[ index ] ) Vector3Soa();
+        new( &soaContext.pQuatResults[ index ] ) QuatSoa();
+    }
+
+    const Benchmark benchmarks[] =
+    {
+        { "Matrix44::MultiplySet", MatrixMultiplyKernel, &matrixContext },
+        { "Matrix44::GetInverse", MatrixInverseKernel, &matrixContext },
+        { "Matrix44::MultiplyArray", MatrixMultiplyArrayKernel, &matrixContext },
+        { "Matrix44::InvertAffineArray", MatrixInvertAffineArrayKernel, &matrixContext },
+        { "Frustum::Intersects(AaBox)", FrustumBoxKernel, &frustumContext },
+        { "Frustum::Intersects(Sphere)", FrustumSphereKernel, &frustumContext },
+        { "Frustum::IntersectsSoa", FrustumBoxSoaKernel, &frustumContext },
+        { "Vector3Soa::Dot", Vector3SoaDotKernel, &soaContext },
+        { "Vector3Soa::CrossSet+Normalize", Vector3SoaCrossNormalizeKernel, &soaContext },
+        { "QuatSoa::MultiplySet", QuatSoaMultiplyKernel, &soaContext },
+        { "QuatSoa::Blend", QuatSoaBlendKernel, &soaContext },
+        { "Simd::SinCosF32", SinCosKernel, &soaContext },
+        { "Simd::Atan2F32", Atan2Kernel, &soaContext },
+        { "Simd::ExpF32+LogF32", ExpLogKernel, &soaContext },
+    };
+
+    for( size_t benchmarkIndex = 0; benchmarkIndex < HELIUM_ARRAY_COUNT( benchmarks ); ++benchmarkIndex )
+    {
+        const Benchmark& rBenchmark = benchmarks[ benchmarkIndex ];
+        if( pFilter && !strstr( rBenchmark.pName, pFilter ) )
+        {
+            continue;
+        }
+
+        for( size_t batchIndex = 0; batchIndex < HELIUM_ARRAY_COUNT( BATCH_SIZES ); ++batchIndex )
+        {
+            RunBenchmark( rBenchmark.pName, rBenchmark.pCallback, rBenchmark.pContext, BATCH_SIZES[ batchIndex ] );
+        }
+    }
+
+    FreeArray( matrixContext.pMatrices0 );
+    FreeArray( matrixContext.pMatrices1 );
+    FreeArray( matrixContext.pResults );
+    FreeArray( frustumContext.pBoxes );
+    FreeArray( frustumContext.pSpheres );
+    FreeArray( frustumContext.pBoxMinimums );
+    FreeArray( frustumContext.pBoxMaximums );
+    FreeArray( soaContext.pVectors0 );
+    FreeArray( soaContext.pVectors1 );
+    FreeArray( soaContext.pVectorResults );
+    FreeArray( soaContext.pQuats0 );
+    FreeArray( soaContext.pQuats1 );
+    FreeArray( soaContext.pQuatResults );
+
+    return 0;
+}
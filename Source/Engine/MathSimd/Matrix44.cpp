@@ -2,6 +2,78 @@
 #include "MathSimd/Matrix44.h"
 #include "Reflect/TranslatorDeduction.h"
 
+namespace Helium
+{
+	namespace Simd
+	{
+		/// Compute a row of the product of two matrices.
+		///
+		/// @param[in] rMatrix0Row   Row of the first matrix.
+		/// @param[in] rMatrix1Rows  Rows of the second matrix.
+		///
+		/// @return  Corresponding row of the product.
+		static HELIUM_FORCEINLINE Register BatchMultiplyRow( const Register& rMatrix0Row, const Register ( &rMatrix1Rows )[ 4 ] )
+		{
+			Register result = Simd::MultiplyF32( Simd::Shuffle< 0, 0, 0, 0 >( rMatrix0Row, rMatrix0Row ), rMatrix1Rows[ 0 ] );
+			result = Simd::MultiplyAddF32( Simd::Shuffle< 1, 1, 1, 1 >( rMatrix0Row, rMatrix0Row ), rMatrix1Rows[ 1 ], result );
+			result = Simd::MultiplyAddF32( Simd::Shuffle< 2, 2, 2, 2 >( rMatrix0Row, rMatrix0Row ), rMatrix1Rows[ 2 ], result );
+			result = Simd::MultiplyAddF32( Simd::Shuffle< 3, 3, 3, 3 >( rMatrix0Row, rMatrix0Row ), rMatrix1Rows[ 3 ], result );
+
+			return result;
+		}
+
+		/// Transpose the upper 3x3 portion of a matrix whose rows all have a w-component of zero.
+		///
+		/// @param[in]  row0      First matrix row.
+		/// @param[in]  row1      Second matrix row.
+		/// @param[in]  row2      Third matrix row.
+		/// @param[out] rColumns  First three columns of the matrix, each with a w-component of zero.
+		static HELIUM_FORCEINLINE void BatchTranspose33( Register row0, Register row1, Register row2, Register ( &rColumns )[ 3 ] )
+		{
+			Register zero = Simd::LoadZeros();
+
+			Register xyxy = Simd::UnpackLow( row0, row1 );
+			Register zwzw = Simd::UnpackHigh( row0, row1 );
+			Register xyxy2 = Simd::UnpackLow( row2, zero );
+			Register zwzw2 = Simd::UnpackHigh( row2, zero );
+
+			rColumns[ 0 ] = Simd::MoveLowHigh( xyxy, xyxy2 );
+			rColumns[ 1 ] = Simd::MoveHighLow( xyxy2, xyxy );
+			rColumns[ 2 ] = Simd::MoveLowHigh( zwzw, zwzw2 );
+		}
+
+		/// Compute the inverse translation row of an affine matrix given the rows of its inverted upper 3x3 portion.
+		///
+		/// @param[in] translation   Translation row of the matrix being inverted.
+		/// @param[in] rInverseRows  First three rows of the inverse matrix.
+		///
+		/// @return  Translation row of the inverse matrix.
+		static HELIUM_FORCEINLINE Register BatchInverseTranslation( Register translation, const Register ( &rInverseRows )[ 3 ] )
+		{
+			Register offset = Simd::MultiplyF32( Simd::Shuffle< 0, 0, 0, 0 >( translation, translation ), rInverseRows[ 0 ] );
+			offset = Simd::MultiplyAddF32( Simd::Shuffle< 1, 1, 1, 1 >( translation, translation ), rInverseRows[ 1 ], offset );
+			offset = Simd::MultiplyAddF32( Simd::Shuffle< 2, 2, 2, 2 >( translation, translation ), rInverseRows[ 2 ], offset );
+
+			return Simd::SubtractF32( Simd::SetF32( 0.0f, 0.0f, 0.0f, 1.0f ), offset );
+		}
+
+		/// Compute the cross product of the xyz-components of two SIMD vectors.
+		///
+		/// @param[in] vec0  First vector.
+		/// @param[in] vec1  Second vector.
+		///
+		/// @return  Cross product, with a w-component of zero if both vectors have a w-component of zero.
+		static HELIUM_FORCEINLINE Register BatchCross( Register vec0, Register vec1 )
+		{
+			Register vec0Yzx = Simd::Shuffle< 1, 2, 0, 3 >( vec0, vec0 );
+			Register vec1Yzx = Simd::Shuffle< 1, 2, 0, 3 >( vec1, vec1 );
+			Register result = Simd::SubtractF32( Simd::MultiplyF32( vec0, vec1Yzx ), Simd::MultiplyF32( vec0Yzx, vec1 ) );
+
+			return Simd::Shuffle< 1, 2, 0, 3 >( result, result );
+		}
+	}
+}
+
 HELIUM_DEFINE_BASE_STRUCT( Helium::Simd::Matrix44 );
 
 const Helium::Simd::Matrix44 Helium::Simd::Matrix44::IDENTITY(
@@ -85,4 +157,189 @@ void Helium::Simd::Matrix44::SetOrthographicProjection( float32_t width, float32
 		0.0f,   yScale, 0.0f,   0.0f,
 		0.0f,   0.0f,   zScale, 0.0f,
 		0.0f,   0.0f,   tScale, 1.0f );
-}
\ No newline at end of file
+}
+
+/// Transform an array of 3-component vectors as points in 3D space.
+///
+/// This is equivalent to calling TransformPoint() on each point, but only loads the matrix rows once.
+///
+/// @param[in]  pPoints   Points to transform.
+/// @param[out] pResults  Transformed results (can be the same array as pPoints).
+/// @param[in]  count     Number of points to transform.
+///
+/// @see TransformPoint()
+void Helium::Simd::Matrix44::TransformPointsArray( const Vector3* pPoints, Vector3* pResults, size_t count ) const
+{
+	HELIUM_ASSERT( pPoints || count == 0 );
+	HELIUM_ASSERT( pResults || count == 0 );
+
+	Register row0 = m_matrix[ 0 ];
+	Register row1 = m_matrix[ 1 ];
+	Register row2 = m_matrix[ 2 ];
+	Register row3 = m_matrix[ 3 ];
+
+	for( size_t pointIndex = 0; pointIndex < count; ++pointIndex )
+	{
+		Register vec = pPoints[ pointIndex ].GetSimdVector();
+
+		Register result = Simd::MultiplyAddF32( Simd::Shuffle< 0, 0, 0, 0 >( vec, vec ), row0, row3 );
+		result = Simd::MultiplyAddF32( Simd::Shuffle< 1, 1, 1, 1 >( vec, vec ), row1, result );
+		result = Simd::MultiplyAddF32( Simd::Shuffle< 2, 2, 2, 2 >( vec, vec ), row2, result );
+
+		pResults[ pointIndex ].SetSimdVector( result );
+	}
+}
+
+/// Multiply each matrix in an array by the matrix at the same index in a second array.
+///
+/// @param[in]  pMatrices0  Matrices to multiply.
+/// @param[in]  pMatrices1  Matrices by which to multiply.
+/// @param[out] pResults    Products (can be the same array as either input).
+/// @param[in]  count       Number of matrices in each array.
+///
+/// @see MultiplySet()
+void Helium::Simd::Matrix44::MultiplyArray(
+	const Matrix44* pMatrices0,
+	const Matrix44* pMatrices1,
+	Matrix44* pResults,
+	size_t count )
+{
+	HELIUM_ASSERT( pMatrices0 || count == 0 );
+	HELIUM_ASSERT( pMatrices1 || count == 0 );
+	HELIUM_ASSERT( pResults || count == 0 );
+
+	for( size_t matrixIndex = 0; matrixIndex < count; ++matrixIndex )
+	{
+		const Register ( &rMatrix0Rows )[ 4 ] = pMatrices0[ matrixIndex ].m_matrix;
+		const Register ( &rMatrix1Rows )[ 4 ] = pMatrices1[ matrixIndex ].m_matrix;
+
+		Register row0 = BatchMultiplyRow( rMatrix0Rows[ 0 ], rMatrix1Rows );
+		Register row1 = BatchMultiplyRow( rMatrix0Rows[ 1 ], rMatrix1Rows );
+		Register row2 = BatchMultiplyRow( rMatrix0Rows[ 2 ], rMatrix1Rows );
+		Register row3 = BatchMultiplyRow( rMatrix0Rows[ 3 ], rMatrix1Rows );
+
+		Register ( &rResultRows )[ 4 ] = pResults[ matrixIndex ].m_matrix;
+		rResultRows[ 0 ] = row0;
+		rResultRows[ 1 ] = row1;
+		rResultRows[ 2 ] = row2;
+		rResultRows[ 3 ] = row3;
+	}
+}
+
+/// Multiply each matrix in an array by the same matrix.
+///
+/// @param[in]  pMatrices  Matrices to multiply.
+/// @param[in]  rMatrix    Matrix by which to multiply each matrix.
+/// @param[out] pResults   Products (can be the same array as pMatrices).
+/// @param[in]  count      Number of matrices to multiply.
+///
+/// @see MultiplySet()
+void Helium::Simd::Matrix44::MultiplyArray(
+	const Matrix44* pMatrices,
+	const Matrix44& rMatrix,
+	Matrix44* pResults,
+	size_t count )
+{
+	HELIUM_ASSERT( pMatrices || count == 0 );
+	HELIUM_ASSERT( pResults || count == 0 );
+
+	Register matrixRows[ 4 ] = { rMatrix.m_matrix[ 0 ], rMatrix.m_matrix[ 1 ], rMatrix.m_matrix[ 2 ], rMatrix.m_matrix[ 3 ] };
+
+	for( size_t matrixIndex = 0; matrixIndex < count; ++matrixIndex )
+	{
+		const Register ( &rMatrix0Rows )[ 4 ] = pMatrices[ matrixIndex ].m_matrix;
+
+		Register row0 = BatchMultiplyRow( rMatrix0Rows[ 0 ], matrixRows );
+		Register row1 = BatchMultiplyRow( rMatrix0Rows[ 1 ], matrixRows );
+		Register row2 = BatchMultiplyRow( rMatrix0Rows[ 2 ], matrixRows );
+		Register row3 = BatchMultiplyRow( rMatrix0Rows[ 3 ], matrixRows );
+
+		Register ( &rResultRows )[ 4 ] = pResults[ matrixIndex ].m_matrix;
+		rResultRows[ 0 ] = row0;
+		rResultRows[ 1 ] = row1;
+		rResultRows[ 2 ] = row2;
+		rResultRows[ 3 ] = row3;
+	}
+}
+
+/// Compute the inverse of each affine matrix in an array.
+///
+/// Each matrix must have a last column of (0, 0, 0, 1) and an invertible upper 3x3 portion.  This is much cheaper than
+/// GetInverse(), as only the 3x3 portion needs a full inverse, computed from the cross products of its rows.
+///
+/// @param[in]  pMatrices  Affine matrices to invert.
+/// @param[out] pResults   Inverse matrices (can be the same array as pMatrices).
+/// @param[in]  count      Number of matrices to invert.
+///
+/// @see InvertRigidArray(), GetInverse()
+void Helium::Simd::Matrix44::InvertAffineArray( const Matrix44* pMatrices, Matrix44* pResults, size_t count )
+{
+	HELIUM_ASSERT( pMatrices || count == 0 );
+	HELIUM_ASSERT( pResults || count == 0 );
+
+	Register one = Simd::SetSplatF32( 1.0f );
+
+	for( size_t matrixIndex = 0; matrixIndex < count; ++matrixIndex )
+	{
+		const Register ( &rMatrixRows )[ 4 ] = pMatrices[ matrixIndex ].m_matrix;
+
+		// The columns of the adjugate are the cross products of the rows.
+		Register adjugateColumns[ 3 ];
+		adjugateColumns[ 0 ] = BatchCross( rMatrixRows[ 1 ], rMatrixRows[ 2 ] );
+		adjugateColumns[ 1 ] = BatchCross( rMatrixRows[ 2 ], rMatrixRows[ 0 ] );
+		adjugateColumns[ 2 ] = BatchCross( rMatrixRows[ 0 ], rMatrixRows[ 1 ] );
+
+		Register determinant = Simd::MultiplyF32( rMatrixRows[ 0 ], adjugateColumns[ 0 ] );
+		determinant = Simd::AddF32(
+			Simd::AddF32( determinant, Simd::Shuffle< 1, 1, 1, 1 >( determinant, determinant ) ),
+			Simd::Shuffle< 2, 2, 2, 2 >( determinant, determinant ) );
+		determinant = Simd::Shuffle< 0, 0, 0, 0 >( determinant, determinant );
+		Register inverseDeterminant = Simd::DivideF32( one, determinant );
+
+		Register inverseRows[ 3 ];
+		BatchTranspose33( adjugateColumns[ 0 ], adjugateColumns[ 1 ], adjugateColumns[ 2 ], inverseRows );
+		inverseRows[ 0 ] = Simd::MultiplyF32( inverseRows[ 0 ], inverseDeterminant );
+		inverseRows[ 1 ] = Simd::MultiplyF32( inverseRows[ 1 ], inverseDeterminant );
+		inverseRows[ 2 ] = Simd::MultiplyF32( inverseRows[ 2 ], inverseDeterminant );
+
+		Register translation = BatchInverseTranslation( rMatrixRows[ 3 ], inverseRows );
+
+		Register ( &rResultRows )[ 4 ] = pResults[ matrixIndex ].m_matrix;
+		rResultRows[ 0 ] = inverseRows[ 0 ];
+		rResultRows[ 1 ] = inverseRows[ 1 ];
+		rResultRows[ 2 ] = inverseRows[ 2 ];
+		rResultRows[ 3 ] = translation;
+	}
+}
+
+/// Compute the inverse of each rigid transform matrix in an array.
+///
+/// Each matrix must have a last column of (0, 0, 0, 1) and an orthonormal upper 3x3 portion (rotation and translation
+/// only, without scaling), which can then be inverted by simply transposing it.
+///
+/// @param[in]  pMatrices  Rigid transform matrices to invert.
+/// @param[out] pResults   Inverse matrices (can be the same array as pMatrices).
+/// @param[in]  count      Number of matrices to invert.
+///
+/// @see InvertAffineArray(), GetInverse()
+void Helium::Simd::Matrix44::InvertRigidArray( const Matrix44* pMatrices, Matrix44* pResults, size_t count )
+{
+	HELIUM_ASSERT( pMatrices || count == 0 );
+	HELIUM_ASSERT( pResults || count == 0 );
+
+	for( size_t matrixIndex = 0; matrixIndex < count; ++matrixIndex )
+	{
+		const Register ( &rMatrixRows )[ 4 ] = pMatrices[ matrixIndex ].m_matrix;
+
+		Register inverseRows[ 3 ];
+		BatchTranspose33( rMatrixRows[ 0 ], rMatrixRows[ 1 ], rMatrixRows[ 2 ], inverseRows );
+
+		Register translation = BatchInverseTranslation( rMatrixRows[ 3 ], inverseRows );
+
+		Register ( &rResultRows )[ 4 ] = pResults[ matrixIndex ].m_matrix;
+		rResultRows[ 0 ] = inverseRows[ 0 ];
+		rResultRows[ 1 ] = inverseRows[ 1 ];
+		rResultRows[ 2 ] = inverseRows[ 2 ];
+		rResultRows[ 3 ] = translation;
+	}
+}
@@ -197,6 +197,19 @@ namespace Helium
 
 			inline void TransformVector( const Vector3& rVector, Vector3& rResult ) const;
 			inline Vector3 TransformVector( const Vector3& rVector ) const;
+
+			void TransformPointsArray( const Vector3* pPoints, Vector3* pResults, size_t count ) const;
+			//@}
+
+			/// @name Batch Operations
+			//@{
+			static void MultiplyArray(
+				const Matrix44* pMatrices0, const Matrix44* pMatrices1, Matrix44* pResults, size_t count );
+			static void MultiplyArray(
+				const Matrix44* pMatrices, const Matrix44& rMatrix, Matrix44* pResults, size_t count );
+
+			static void InvertAffineArray( const Matrix44* pMatrices, Matrix44* pResults, size_t count );
+			static void InvertRigidArray( const Matrix44* pMatrices, Matrix44* pResults, size_t count );
 			//@}
 
 			/// @name Comparison
@@ -249,4 +262,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/Matrix44Sse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/Matrix44Neon.inl"
 #endif
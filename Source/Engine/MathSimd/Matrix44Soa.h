@@ -238,4 +238,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/Matrix44SoaSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/Matrix44SoaNeon.inl"
 #endif
@@ -0,0 +1,25 @@
+#if HELIUM_SIMD_NEON
+
+/// Splat each component of the given matrix across each SIMD vector for each component in this matrix set.
+///
+/// @param[in] rMatrix  Matrix from which to set this matrix.
+void Helium::Simd::Matrix44Soa::Splat( const Matrix44& rMatrix )
+{
+    Register rowVec;
+
+#define SPLAT_ROW( N ) \
+    rowVec = rMatrix.GetSimdVector( N ); \
+    m_matrix[ N ][ 0 ] = Simd::Shuffle< 0, 0, 0, 0 >( rowVec, rowVec ); \
+    m_matrix[ N ][ 1 ] = Simd::Shuffle< 1, 1, 1, 1 >( rowVec, rowVec ); \
+    m_matrix[ N ][ 2 ] = Simd::Shuffle< 2, 2, 2, 2 >( rowVec, rowVec ); \
+    m_matrix[ N ][ 3 ] = Simd::Shuffle< 3, 3, 3, 3 >( rowVec, rowVec );
+
+    SPLAT_ROW( 0 );
+    SPLAT_ROW( 1 );
+    SPLAT_ROW( 2 );
+    SPLAT_ROW( 3 );
+
+#undef SPLAT_ROW
+}
+
+#endif  // HELIUM_SIMD_NEON
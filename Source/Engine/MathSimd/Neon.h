@@ -0,0 +1,45 @@
+#pragma once
+
+#include "MathSimd/Simd.h"
+
+#if HELIUM_SIMD_NEON
+
+#include <arm_neon.h>
+
+/// @defgroup simdvector SIMD Types
+//@{
+
+#ifndef HELIUM_SIMD_SIZE
+/// Size of a SIMD vector, in bytes.
+#define HELIUM_SIMD_SIZE ( 16 )
+#endif
+#ifndef HELIUM_SIMD_ALIGNMENT
+/// Required SIMD vector alignment, in bytes.
+#define HELIUM_SIMD_ALIGNMENT ( 16 )
+#define HELIUM_SIMD_ALIGN_PRE HELIUM_ALIGN_PRE( 16 )
+#define HELIUM_SIMD_ALIGN_POST HELIUM_ALIGN_POST( 16 )
+#endif
+
+/// Non-zero if SIMD multiply-and-add is supported in a single instruction.
+#define HELIUM_SIMD_BUILTIN_MULTIPLY_ADD 1
+/// Non-zero if SIMD multiply is supported in a single instruction.
+#define HELIUM_SIMD_BUILTIN_MULTIPLY 1
+
+namespace Helium
+{
+    namespace Simd
+    {
+        /// Generic SIMD vector.
+        typedef float32x4_t Register;
+
+        /// Mask type for SIMD vector operations.
+        ///
+        /// Masks are stored in floating-point registers so that the same bitwise operations can be shared with
+        /// Register values, matching the SSE backend.
+        typedef float32x4_t Mask;
+    }
+}
+
+//@}
+
+#endif  // HELIUM_SIMD_NEON
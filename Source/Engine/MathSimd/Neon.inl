@@ -0,0 +1,605 @@
+#if HELIUM_SIMD_NEON
+
+/// Load a SIMD vector from aligned memory.
+///
+/// @param[in] pSource  Memory, aligned to HELIUM_SIMD_ALIGNMENT, from which to load.
+///
+/// @return  SIMD vector.
+Helium::Simd::Register Helium::Simd::LoadAligned( const void* pSource )
+{
+    return vld1q_f32( static_cast< const float32_t* >( pSource ) );
+}
+
+/// Load a SIMD vector from unaligned memory.
+///
+/// @param[in] pSource  Memory from which to load.
+///
+/// @return  SIMD vector.
+Helium::Simd::Register Helium::Simd::LoadUnaligned( const void* pSource )
+{
+    return vld1q_f32( static_cast< const float32_t* >( pSource ) );
+}
+
+/// Store the contents of a SIMD vector in aligned memory.
+///
+/// @param[out] pDest  Memory, aligned to HELIUM_SIMD_ALIGNMENT, in which to store the data.
+/// @param[in]  vec    SIMD vector to store.
+void Helium::Simd::StoreAligned( void* pDest, Helium::Simd::Register vec )
+{
+    vst1q_f32( static_cast< float32_t* >( pDest ), vec );
+}
+
+/// Store the contents of a SIMD vector in unaligned memory.
+///
+/// @param[out] pDest  Memory in which to store the data.
+/// @param[in]  vec    SIMD vector to store.
+void Helium::Simd::StoreUnaligned( void* pDest, Helium::Simd::Register vec )
+{
+    vst1q_f32( static_cast< float32_t* >( pDest ), vec );
+}
+
+/// Load a 32-bit value into each component of a SIMD vector.
+///
+/// @param[in] pSource  Address of the 32-bit value to load (must be aligned to a 4-byte boundary).
+///
+/// @return  SIMD vector.
+///
+/// @see Store32(), LoadSplat128()
+Helium::Simd::Register Helium::Simd::LoadSplat32( const void* pSource )
+{
+    return vld1q_dup_f32( static_cast< const float32_t* >( pSource ) );
+}
+
+/// Load 16 bytes of data into a SIMD vector, repeating the data as necessary to fill.
+///
+/// For platforms with only 16-byte SIMD vectors, this has the same effect as LoadAligned().
+///
+/// @param[in] pSource  Address of the data to load (must be aligned to a 16-byte boundary).
+///
+/// @return  SIMD vector.
+///
+/// @see Store128(), LoadSplat32()
+Helium::Simd::Register Helium::Simd::LoadSplat128( const void* pSource )
+{
+    return vld1q_f32( static_cast< const float32_t* >( pSource ) );
+}
+
+/// Store the first 32-bit value of a SIMD vector into memory.
+///
+/// @param[in] pDest  Address in which to store the value (must be aligned to a 4-byte boundary).
+/// @param[in] vec    Vector containing the value to store.
+///
+/// @see LoadSplat32(), Store128()
+void Helium::Simd::Store32( void* pDest, Helium::Simd::Register vec )
+{
+    vst1q_lane_f32( static_cast< float32_t* >( pDest ), vec, 0 );
+}
+
+/// Store 16 bytes of data from a SIMD vector into memory.
+///
+/// For platforms with only 16-byte SIMD vectors, this has the same effect as StoreAligned().
+///
+/// @param[in] pDest  Address in which to store the data (must be aligned to a 16-byte boundary).
+/// @param[in] vec    Vector containing the data to store.
+///
+/// @see LoadSplat128(), Store32()
+void Helium::Simd::Store128( void* pDest, Helium::Simd::Register vec )
+{
+    vst1q_f32( static_cast< float32_t* >( pDest ), vec );
+}
+
+/// Fill a SIMD vector with a single-precision floating-point value splat across all vector components.
+///
+/// @param[in] value  Value to splat.
+///
+/// @return  SIMD vector containing the splat value.
+Helium::Simd::Register Helium::Simd::SetSplatF32( float32_t value )
+{
+    return vdupq_n_f32( value );
+}
+
+/// Fill a SIMD vector with a 32-bit unsigned integer value splat across all vector components.
+///
+/// @param[in] value  Value to splat.
+///
+/// @return  SIMD vector containing the splat value.
+Helium::Simd::Register Helium::Simd::SetSplatU32( uint32_t value )
+{
+    return vreinterpretq_f32_u32( vdupq_n_u32( value ) );
+}
+
+/// Load a vector containing all zeros.
+///
+/// @return  Vector containing all zeros.
+Helium::Simd::Register Helium::Simd::LoadZeros()
+{
+    return vdupq_n_f32( 0.0f );
+}
+
+/// Select components from one of two vectors based on the given mask.
+///
+/// If a given bit in the select mask is unset, the corresponding element of the first vector will be passed
+/// through, otherwise the corresponding element of the second vector will be passed through.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+/// @param[in] mask  Selection mask.
+Helium::Simd::Register Helium::Simd::Select( Helium::Simd::Register vec0, Helium::Simd::Register vec1, Helium::Simd::Mask mask )
+{
+    return vbslq_f32( vreinterpretq_u32_f32( mask ), vec1, vec0 );
+}
+
+/// Fill a SIMD vector with four single-precision floating-point values.
+///
+/// @param[in] x  First component value.
+/// @param[in] y  Second component value.
+/// @param[in] z  Third component value.
+/// @param[in] w  Fourth component value.
+///
+/// @return  SIMD vector containing the given values.
+Helium::Simd::Register Helium::Simd::SetF32( float32_t x, float32_t y, float32_t z, float32_t w )
+{
+    HELIUM_SIMD_ALIGN_PRE float32_t values[ 4 ] HELIUM_SIMD_ALIGN_POST = { x, y, z, w };
+
+    return vld1q_f32( values );
+}
+
+/// Build a SIMD vector from two components of each of two vectors.
+///
+/// The first two components of the result are taken from the first vector, and the last two are taken from the
+/// second vector.
+///
+/// @param[in] vec0  SIMD vector from which to take the first two result components.
+/// @param[in] vec1  SIMD vector from which to take the last two result components.
+///
+/// @return  SIMD vector with the result of the operation.
+template< uint32_t X, uint32_t Y, uint32_t Z, uint32_t W >
+Helium::Simd::Register Helium::Simd::Shuffle( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+#if defined( __clang__ )
+    return __builtin_shufflevector( vec0, vec1, X, Y, Z + 4, W + 4 );
+#elif defined( __GNUC__ )
+    return __builtin_shuffle( vec0, vec1, uint32x4_t{ X, Y, Z + 4, W + 4 } );
+#else
+    Register result = vmovq_n_f32( vgetq_lane_f32( vec0, X ) );
+    result = vsetq_lane_f32( vgetq_lane_f32( vec0, Y ), result, 1 );
+    result = vsetq_lane_f32( vgetq_lane_f32( vec1, Z ), result, 2 );
+    result = vsetq_lane_f32( vgetq_lane_f32( vec1, W ), result, 3 );
+
+    return result;
+#endif
+}
+
+/// Interleave the first two components of two SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector containing ( vec0.x, vec1.x, vec0.y, vec1.y ).
+///
+/// @see UnpackHigh()
+Helium::Simd::Register Helium::Simd::UnpackLow( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vzip1q_f32( vec0, vec1 );
+}
+
+/// Interleave the last two components of two SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector containing ( vec0.z, vec1.z, vec0.w, vec1.w ).
+///
+/// @see UnpackLow()
+Helium::Simd::Register Helium::Simd::UnpackHigh( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vzip2q_f32( vec0, vec1 );
+}
+
+/// Combine the last two components of one SIMD vector with the last two components of another.
+///
+/// @param[in] vec0  SIMD vector providing the last two result components.
+/// @param[in] vec1  SIMD vector providing the first two result components.
+///
+/// @return  SIMD vector containing ( vec1.z, vec1.w, vec0.z, vec0.w ).
+///
+/// @see MoveLowHigh()
+Helium::Simd::Register Helium::Simd::MoveHighLow( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vcombine_f32( vget_high_f32( vec1 ), vget_high_f32( vec0 ) );
+}
+
+/// Combine the first two components of one SIMD vector with the first two components of another.
+///
+/// @param[in] vec0  SIMD vector providing the first two result components.
+/// @param[in] vec1  SIMD vector providing the last two result components.
+///
+/// @return  SIMD vector containing ( vec0.x, vec0.y, vec1.x, vec1.y ).
+///
+/// @see MoveHighLow()
+Helium::Simd::Register Helium::Simd::MoveLowHigh( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vcombine_f32( vget_low_f32( vec0 ), vget_low_f32( vec1 ) );
+}
+
+/// Perform a component-wise addition of two SIMD vectors of single-precision floating-point values.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector to add.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::AddF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vaddq_f32( vec0, vec1 );
+}
+
+/// Perform a component-wise subtraction of one SIMD vector of single-precision floating-point values from another.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector to subtract.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::SubtractF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vsubq_f32( vec0, vec1 );
+}
+
+/// Perform a component-wise multiplication of two SIMD vectors of single-precision floating-point values.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector by which to multiply.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::MultiplyF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vmulq_f32( vec0, vec1 );
+}
+
+/// Perform a component-wise division of one SIMD vector of single-precision floating-point values by another.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector by which to divide.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::DivideF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vdivq_f32( vec0, vec1 );
+}
+
+/// Perform a component-wise multiplication of two SIMD vectors of single-precision floating-point values, and add
+/// the resulting values with those in a third vector.
+///
+/// The result is computed with the following formula:
+/// vecMul0 * vecMul1 + vecAdd
+///
+/// @param[in] vecMul0  SIMD vector.
+/// @param[in] vecMul1  SIMD vector by which to multiply.
+/// @param[in] vecAdd   SIMD vector to add to the result.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::MultiplyAddF32(
+    Helium::Simd::Register vecMul0,
+    Helium::Simd::Register vecMul1,
+    Helium::Simd::Register vecAdd )
+{
+    return vfmaq_f32( vecAdd, vecMul0, vecMul1 );
+}
+
+/// Perform a component-wise multiplication of two SIMD vectors of single-precision floating-point values, and
+/// subtract the resulting values from those in a third vector.
+///
+/// The result is computed with the following formula:
+/// vecSub - vecMul0 * vecMul1
+///
+/// @param[in] vecMul0  SIMD vector.
+/// @param[in] vecMul1  SIMD vector by which to multiply.
+/// @param[in] vecAdd   SIMD vector from which to subtract the result.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::MultiplySubtractReverseF32(
+    Helium::Simd::Register vecMul0,
+    Helium::Simd::Register vecMul1,
+    Helium::Simd::Register vecSub )
+{
+    return vfmsq_f32( vecSub, vecMul0, vecMul1 );
+}
+
+/// Compute the square root of each component in a SIMD vector of single-precision floating-point values.
+///
+/// Note that this may be only an approximation on certain platforms, so its precision is not guaranteed to be the
+/// same as using the C-library sqrtf() function on each component.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::SqrtF32( Helium::Simd::Register vec )
+{
+    return vsqrtq_f32( vec );
+}
+
+/// Compute the multiplicative inverse of each component in a SIMD vector of single-precision floating-point values.
+///
+/// Note that this may be only an approximation on certain platforms, so its precision is not guaranteed to be the
+/// same as actually computing the reciprocal of each component using scalar division.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::InverseF32( Helium::Simd::Register vec )
+{
+    // Refine the estimate with a single Newton-Raphson step to match the precision of the SSE approximation.
+    Register estimate = vrecpeq_f32( vec );
+    estimate = vmulq_f32( vrecpsq_f32( vec, estimate ), estimate );
+
+    return estimate;
+}
+
+/// Compute the multiplicative inverse of the square root of each component in a SIMD vector of single-precision
+/// floating-point values.
+///
+/// Note that this may be only an approximation on certain platforms, so its precision is not guaranteed to be the
+/// same as actually computing the reciprocal of the square root of each component using the C-library sqrtf()
+/// function and scalar division.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::InverseSqrtF32( Helium::Simd::Register vec )
+{
+    // Refine the estimate with a single Newton-Raphson step to match the precision of the SSE approximation.
+    Register estimate = vrsqrteq_f32( vec );
+    estimate = vmulq_f32( vrsqrtsq_f32( vmulq_f32( vec, estimate ), estimate ), estimate );
+
+    return estimate;
+}
+
+/// Create a SIMD vector of single-precision floating-point values containing the minimum between each component in
+/// the two given SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::MinF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vminq_f32( vec0, vec1 );
+}
+
+/// Create a SIMD vector of single-precision floating-point values containing the maximum between each component in
+/// the two given SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::MaxF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vmaxq_f32( vec0, vec1 );
+}
+
+/// Round each component in a SIMD vector of single-precision floating-point values to the nearest integer.
+///
+/// Components must be within the range of a signed 32-bit integer.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::RoundF32( Helium::Simd::Register vec )
+{
+    return vrndnq_f32( vec );
+}
+
+/// Extract the unbiased binary exponent of each component in a SIMD vector of single-precision floating-point values.
+///
+/// The result is floor(log2(abs(x))) for normalized values.  Zero, denormal, infinite and NaN components give
+/// undefined results.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the exponent of each component, as floating-point values.
+Helium::Simd::Register Helium::Simd::ExponentF32( Helium::Simd::Register vec )
+{
+    uint32x4_t biasedExponent = vandq_u32( vshrq_n_u32( vreinterpretq_u32_f32( vec ), 23 ), vdupq_n_u32( 0xff ) );
+
+    return vcvtq_f32_s32( vsubq_s32( vreinterpretq_s32_u32( biasedExponent ), vdupq_n_s32( 127 ) ) );
+}
+
+/// Compute two raised to the power of each component in a SIMD vector of integer-valued single-precision
+/// floating-point values.
+///
+/// The result is exact for exponents in the range [-126, 127], and undefined for other exponents.
+///
+/// @param[in] exponent  SIMD vector of exponents.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::PowerOfTwoF32( Helium::Simd::Register exponent )
+{
+    int32x4_t biasedExponent = vaddq_s32( vcvtnq_s32_f32( exponent ), vdupq_n_s32( 127 ) );
+
+    return vreinterpretq_f32_s32( vshlq_n_s32( biasedExponent, 23 ) );
+}
+
+/// Compare each component in two SIMD vectors of single-precision floating-point values for equality, setting each
+/// component in the result mask based on the result of the comparison.
+///
+/// If the corresponding components in the two given vectors are equal, the corresponding component in the result
+/// mask will be set, otherwise it will be cleared.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  Mask with the result of the operation.
+Helium::Simd::Mask Helium::Simd::EqualsF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( vceqq_f32( vec0, vec1 ) );
+}
+
+/// Compare each component in two SIMD vectors of single-precision floating-point values for whether the component
+/// in the first vector is less than the corresponding component in the second, setting each component in the result
+/// mask based on the result of the comparison.
+///
+/// If a component in the first vector is less than the corresponding component in the second vector, the
+/// corresponding component in the result mask will be set, otherwise it will be cleared.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  Mask with the result of the operation.
+Helium::Simd::Mask Helium::Simd::LessF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( vcltq_f32( vec0, vec1 ) );
+}
+
+/// Compare each component in two SIMD vectors of single-precision floating-point values for whether the component
+/// in the first vector is greater than the corresponding component in the second, setting each component in the
+/// result mask based on the result of the comparison.
+///
+/// If a component in the first vector is greater than the corresponding component in the second vector, the
+/// corresponding component in the result mask will be set, otherwise it will be cleared.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  Mask with the result of the operation.
+Helium::Simd::Mask Helium::Simd::GreaterF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( vcgtq_f32( vec0, vec1 ) );
+}
+
+/// Compare each component in two SIMD vectors of single-precision floating-point values for whether the component
+/// in the first vector is less than or equal to the corresponding component in the second, setting each component
+/// in the result mask based on the result of the comparison.
+///
+/// If a component in the first vector is less than or equal to the corresponding component in the second vector,
+/// the corresponding component in the result mask will be set, otherwise it will be cleared.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  Mask with the result of the operation.
+Helium::Simd::Mask Helium::Simd::LessEqualsF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( vcleq_f32( vec0, vec1 ) );
+}
+
+/// Compare each component in two SIMD vectors of single-precision floating-point values for whether the component
+/// in the first vector is greater than or equal to the corresponding component in the second, setting each
+/// component in the result mask based on the result of the comparison.
+///
+/// If a component in the first vector is greater than or equal to the corresponding component in the second vector,
+/// the corresponding component in the result mask will be set, otherwise it will be cleared.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  Mask with the result of the operation.
+Helium::Simd::Mask Helium::Simd::GreaterEqualsF32( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( vcgeq_f32( vec0, vec1 ) );
+}
+
+/// Compute the bitwise-AND of two SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::And( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( vandq_u32( vreinterpretq_u32_f32( vec0 ), vreinterpretq_u32_f32( vec1 ) ) );
+}
+
+/// Compute the bitwise-AND of the one's complement (bitwise-NOT) of a vector with another vector.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation (that is, the bitwise-AND of the second vector and the
+///          complement of the first vector).
+Helium::Simd::Register Helium::Simd::AndNot( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( vbicq_u32( vreinterpretq_u32_f32( vec1 ), vreinterpretq_u32_f32( vec0 ) ) );
+}
+
+/// Compute the bitwise-OR of two SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::Or( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( vorrq_u32( vreinterpretq_u32_f32( vec0 ), vreinterpretq_u32_f32( vec1 ) ) );
+}
+
+/// Compute the bitwise-XOR of two SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::Xor( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return vreinterpretq_f32_u32( veorq_u32( vreinterpretq_u32_f32( vec0 ), vreinterpretq_u32_f32( vec1 ) ) );
+}
+
+/// Get a bit field of the sign bit of each component in a SIMD mask.
+///
+/// @param[in] mask  SIMD mask.
+///
+/// @return  Bit field with bit N set if component N of the mask is set.
+uint32_t Helium::Simd::GetMaskBits( Helium::Simd::Mask mask )
+{
+    static const int32_t shifts[ 4 ] = (0, 1, 2, 3);
+
+    uint32x4_t signBits = vshrq_n_u32( vreinterpretq_u32_f32( mask ), 31 );
+
+    return vaddvq_u32( vshlq_u32( signBits, vld1q_s32( shifts ) ) );
+}
+
+/// Compute the bitwise-AND of two SIMD masks.
+///
+/// @param[in] mask0  SIMD mask.
+/// @param[in] mask1  SIMD mask.
+///
+/// @return  SIMD mask with the result of the operation.
+Helium::Simd::Mask Helium::Simd::MaskAnd( Helium::Simd::Mask mask0, Helium::Simd::Mask mask1 )
+{
+    return vreinterpretq_f32_u32( vandq_u32( vreinterpretq_u32_f32( mask0 ), vreinterpretq_u32_f32( mask1 ) ) );
+}
+
+/// Compute the bitwise-AND of the one's complement (bitwise-NOT) of a mask with another mask.
+///
+/// @param[in] mask0  SIMD mask.
+/// @param[in] mask1  SIMD mask.
+///
+/// @return  SIMD mask with the result of the operation (that is, the bitwise-AND of the second mask and the
+///          complement of the first mask).
+Helium::Simd::Mask Helium::Simd::MaskAndNot( Helium::Simd::Mask mask0, Helium::Simd::Mask mask1 )
+{
+    return vreinterpretq_f32_u32( vbicq_u32( vreinterpretq_u32_f32( mask1 ), vreinterpretq_u32_f32( mask0 ) ) );
+}
+
+/// Compute the bitwise-OR of two SIMD masks.
+///
+/// @param[in] mask0  SIMD mask.
+/// @param[in] mask1  SIMD mask.
+///
+/// @return  SIMD mask with the result of the operation.
+Helium::Simd::Mask Helium::Simd::MaskOr( Helium::Simd::Mask mask0, Helium::Simd::Mask mask1 )
+{
+    return vreinterpretq_f32_u32( vorrq_u32( vreinterpretq_u32_f32( mask0 ), vreinterpretq_u32_f32( mask1 ) ) );
+}
+
+/// Compute the bitwise-XOR of two SIMD masks.
+///
+/// @param[in] mask0  SIMD mask.
+/// @param[in] mask1  SIMD mask.
+///
+/// @return  SIMD mask with the result of the operation.
+Helium::Simd::Mask Helium::Simd::MaskXor( Helium::Simd::Mask mask0, Helium::Simd::Mask mask1 )
+{
+    return vreinterpretq_f32_u32( veorq_u32( vreinterpretq_u32_f32( mask0 ), vreinterpretq_u32_f32( mask1 ) ) );
+}
+
+#endif  // HELIUM_SIMD_NEON
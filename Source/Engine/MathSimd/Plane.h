@@ -86,4 +86,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/PlaneSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/PlaneNeon.inl"
 #endif
@@ -0,0 +1,251 @@
+#if HELIUM_SIMD_NEON
+
+/// Constructor.
+///
+/// Initializes this plane directly with the specified plane equation coefficients.
+///
+/// @param[in] a  Plane equation coefficient multiplied by point x-coordinates (also the x-component of the plane
+///               normal).
+/// @param[in] b  Plane equation coefficient multiplied by point y-coordinates (also the y-component of the plane
+///               normal).
+/// @param[in] c  Plane equation coefficient multiplied by point z-coordinates (also the z-component of the plane
+///               normal).
+/// @param[in] d  Plane equation constant (also the negative distance of the plane from the origin along the
+///               direction of its normal).
+Helium::Simd::Plane::Plane( float32_t a, float32_t b, float32_t c, float32_t d )
+{
+	m_plane = Simd::SetF32( a, b, c, d );
+}
+
+/// Constructor.
+///
+/// Initializes this plane directly with each value in the given vector.  The vector x, y, z, and w components are
+/// mapped directly to the plane a, b, c, and d coefficients, respectively.
+///
+/// @param[in] rVector  Vector containing the values with which to initialize this plane.
+Helium::Simd::Plane::Plane( const Vector4& rVector )
+	: m_plane( rVector.GetSimdVector() )
+{
+}
+
+/// Constructor.
+///
+/// Initializes this plane directly with the values in the given SIMD vector.
+///
+/// @param[in] rVector  SIMD vector from which to initialize this plane.
+Helium::Simd::Plane::Plane( const Register& rVector )
+	: m_plane( rVector )
+{
+}
+
+/// Set the plane element stored at the specified index.
+///
+/// Note that accessing individual elements within a plane can incur a performance penalty, especially on particular
+/// platforms like the PowerPC, so use it with care.
+///
+/// @param[in] index  Index of the element to retrieve (less than 4).
+///
+/// @return  Reference to the value stored at the specified element.
+///
+/// @see SetElement()
+float32_t& Helium::Simd::Plane::GetElement( size_t index )
+{
+	HELIUM_ASSERT( index < 4 );
+
+	return reinterpret_cast< float32_t* >( &m_plane )[ index ];
+}
+
+/// Set the plane element stored at the specified index.
+///
+/// Note that accessing individual elements within a plane can incur a performance penalty, especially on particular
+/// platforms like the PowerPC, so use it with care.
+///
+/// @param[in] index  Index of the element to retrieve (less than 4).
+///
+/// @return  Value stored at the specified element.
+///
+/// @see SetElement()
+float32_t Helium::Simd::Plane::GetElement( size_t index ) const
+{
+	HELIUM_ASSERT( index < 4 );
+
+	return reinterpret_cast< const float32_t* >( &m_plane )[ index ];
+}
+
+/// Set the plane element at the specified index.
+///
+/// Note that accessing individual elements within a plane can incur a performance penalty, especially on particular
+/// platforms like the PowerPC, so use it with care.
+///
+/// @param[in] index  Index of the element to set (less than 4).
+/// @param[in] value  Value to set.
+///
+/// @see GetElement()
+void Helium::Simd::Plane::SetElement( size_t index, float32_t value )
+{
+	HELIUM_ASSERT( index < 4 );
+
+	reinterpret_cast< float32_t* >( &m_plane )[ index ] = value;
+}
+
+/// Set this plane based on a vector normal to the plane and the distance of the plane from the origin.
+///
+/// @param[in] rNormal   Plane normal.
+/// @param[in] distance  Distance of the plane from the origin along the plane normal, scaled by the normal
+///                      magnitude.
+void Helium::Simd::Plane::Set( const Vector3& rNormal, float32_t distance )
+{
+	Register distanceSplat = Simd::SetSplatF32( distance );
+
+	HELIUM_SIMD_ALIGN_PRE const uint32_t distanceMaskValues[] HELIUM_SIMD_ALIGN_POST = { 0x0, 0x0, 0x0, 0xffffffff };
+	Register distanceMask = Simd::LoadAligned( reinterpret_cast< const float32_t* >( distanceMaskValues ) );
+
+	m_plane = Simd::SubtractF32(
+		Simd::AndNot( distanceMask, rNormal.GetSimdVector() ),
+		Simd::And( distanceMask, distanceSplat ) );
+}
+
+/// Set this plane based on three points on the plane.  The plane normal is computed using the cross product of the
+/// vector from the first point to the second and the vector from the first point to the third.
+///
+/// Note that the plane normal is normalized automatically using Vector3::Normalize() with the default epsilon
+/// value.
+///
+/// @param[in] rPoint0  First point on the plane.
+/// @param[in] rPoint1  Second point on the plane.
+/// @param[in] rPoint2  Third point on the plane.
+void Helium::Simd::Plane::Set( const Vector3& rPoint0, const Vector3& rPoint1, const Vector3& rPoint2 )
+{
+	Vector3 toPoint1, toPoint2;
+	toPoint1.SubtractSet( rPoint1, rPoint0 );
+	toPoint1.SubtractSet( rPoint2, rPoint0 );
+
+	Vector3 normal;
+	normal.CrossSet( toPoint1, toPoint2 );
+	normal.Normalize();
+
+	// Make sure the dot product of the plane normal and a point on the plane (Ax + By + Cz portion of the plane
+	// equation, which equates to -D) is stored in the w-component of the dot product vector so we can mask and
+	// apply it to proper location in the final coefficient vector.
+	Register normalPointProduct = Simd::MultiplyF32( normal.GetSimdVector(), rPoint0.GetSimdVector() );
+	Register productX = Simd::Shuffle< 1, 2, 3, 0 >( normalPointProduct, normalPointProduct );
+	Register productY = Simd::Shuffle< 2, 3, 0, 1 >( normalPointProduct, normalPointProduct );
+	Register productZ = Simd::Shuffle< 3, 0, 1, 2 >( normalPointProduct, normalPointProduct );
+	Register normalDotPoint = Simd::AddF32( Simd::AddF32( productX, productY ), productZ );
+
+	HELIUM_SIMD_ALIGN_PRE const uint32_t distanceMaskValues[] HELIUM_SIMD_ALIGN_POST = { 0x0, 0x0, 0x0, 0xffffffff };
+	Register distanceMask = Simd::LoadAligned( reinterpret_cast< const float32_t* >( distanceMaskValues ) );
+
+	m_plane = Simd::SubtractF32(
+		Simd::AndNot( distanceMask, normal.GetSimdVector() ),
+		Simd::And( distanceMask, normalDotPoint ) );
+}
+
+/// Apply the equation for this plane to the given point in order to compute its distance from this plane.
+///
+/// Note that the distance is scaled by the magnitude of the plane normal.  In order to get the actual distance of
+/// a point from a plane, the plane must first be normalized.
+///
+/// @param[in] rPoint  Point to which the plane equation should be applied.
+///
+/// @return  Distance of the given point from this plane, scaled by the magnitude of the plane normal.
+///
+/// @see GetNormalized(), Normalize()
+float32_t Helium::Simd::Plane::GetDistance( const Vector3& rPoint ) const
+{
+	Register productX = Simd::MultiplyF32( m_plane, rPoint.GetSimdVector() );
+	Register productY = Simd::Shuffle< 1, 2, 3, 0 >( productX, productX );
+	Register productZ = Simd::Shuffle< 2, 3, 0, 1 >( productX, productX );
+	Register constant = Simd::Shuffle< 3, 0, 1, 2 >( m_plane, m_plane );
+
+	Register sum = Simd::AddF32( Simd::AddF32( Simd::AddF32( productX, productY ), productZ ), constant );
+
+	return reinterpret_cast< const float32_t* >( &sum )[ 0 ];
+}
+
+/// Normalize this plane, with safety threshold checking.
+///
+/// If the magnitude of the plane normal is below the given epsilon, the normal will be set to a unit vector
+/// pointing along the x-axis, and the D component will be set to zero.
+///
+/// @param[in] epsilon  Threshold at which to test for zero-length plane normals.
+///
+/// @see GetNormalized()
+void Helium::Simd::Plane::Normalize( float32_t epsilon )
+{
+	epsilon *= epsilon;
+
+	Register productX = Simd::MultiplyF32( m_plane, m_plane );
+	Register productY = Simd::Shuffle< 1, 2, 3, 0 >( productX, productX );
+	Register productZ = Simd::Shuffle< 2, 3, 0, 1 >( productX, productX );
+
+	Register magnitudeSquared = Simd::AddF32( Simd::AddF32( productX, productY ), productZ );
+	magnitudeSquared = Simd::Shuffle< 0, 0, 0, 0 >( magnitudeSquared, magnitudeSquared );
+
+	Register epsilonVec = Simd::SetSplatF32( epsilon );
+
+	Mask thresholdMask = Simd::LessF32( magnitudeSquared, epsilonVec );
+
+	Register invMagnitude = Simd::InverseSqrtF32( magnitudeSquared );
+
+	Register planeNormalized = Simd::MultiplyF32( m_plane, invMagnitude );
+	Register planeFallback = Simd::SetF32( 1.0f, 0.0f, 0.0f, 0.0f );
+
+	planeNormalized = Simd::AndNot( thresholdMask, planeNormalized );
+	planeFallback = Simd::And( thresholdMask, planeFallback );
+
+	m_plane = Simd::Or( planeNormalized, planeFallback );
+}
+
+/// Find where a line intersects on this plane.
+///
+/// If the line is orthogonal to the plane's normal, there is no intersection and this function returns false
+///
+/// @param[in] linePoint  A point on the line.
+/// @param[in] lineDirectionNormalized  Direction of line. If you have two points p0 and p1, you could provide p0, and (p1-p0).Normalized()
+/// @param[out] intersectPoint  Where the intersection occurs
+///
+/// @see GetNormalized()
+bool Helium::Simd::Plane::CalculateLineIntersect(const Simd::Vector3 &linePoint, const Simd::Vector3 &lineDirectionNormalized, Simd::Vector3 &intersectPoint) const
+{
+	// TODO: this implementation sucks because it goes back and forth between SIMD/SISD operations. 
+	// TODO: Might be better if we let the caller give a line point and normal to indicate direction
+	Simd::Vector3 planeNormal = GetNormal();
+	Simd::Vector3 pointOnPlane = planeNormal * GetElement(3);
+
+	Simd::Vector3 d = planeNormal.Dot( pointOnPlane - linePoint ) * planeNormal;
+	float denominator = d.GetNormalized().Dot( lineDirectionNormalized );
+
+	if ( Helium::Abs(denominator) > HELIUM_EPSILON )
+	{
+		intersectPoint = linePoint + ( lineDirectionNormalized * ( d.GetMagnitude() / denominator ) );
+		return true;
+	}
+
+	return false;
+}
+
+/// Test whether each component in this plane is equal to the corresponding component in another plane within a
+/// given threshold.
+///
+/// @param[in] rPlane   Plane.
+/// @param[in] epsilon  Comparison threshold.
+///
+/// @return  True if this plane and the given plane are equal within the given threshold, false if not.
+bool Helium::Simd::Plane::Equals( const Plane& rPlane, float32_t epsilon ) const
+{
+	epsilon *= epsilon;
+
+	Register differenceSquared = Simd::SubtractF32( m_plane, rPlane.m_plane );
+	differenceSquared = Simd::MultiplyF32( differenceSquared, differenceSquared );
+
+	Register epsilonVec = Simd::SetSplatF32( epsilon );
+
+	Register testResult = Simd::GreaterF32( differenceSquared, epsilonVec );
+	testResult = Simd::Or( testResult, Simd::MoveHighLow( testResult, testResult ) );
+	testResult = Simd::Or( testResult, Simd::Shuffle< 1, 2, 3, 0 >( testResult, testResult ) );
+
+	return ( reinterpret_cast< const uint32_t* >( &testResult )[ 0 ] == 0 );
+}
+
+#endif  // HELIUM_SIMD_NEON
@@ -84,4 +84,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/PlaneSoaSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/PlaneSoaNeon.inl"
 #endif
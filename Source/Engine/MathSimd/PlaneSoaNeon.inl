@@ -0,0 +1,15 @@
+#if HELIUM_SIMD_NEON
+
+/// Splat each component of the given plane across each SIMD vector for each component in this plane set.
+///
+/// @param[in] rPlane  Plane from which to set this plane.
+void Helium::Simd::PlaneSoa::Splat( const Plane& rPlane )
+{
+    Register planeVec = rPlane.GetSimdVector();
+    m_a = Simd::Shuffle< 0, 0, 0, 0 >( planeVec, planeVec );
+    m_b = Simd::Shuffle< 1, 1, 1, 1 >( planeVec, planeVec );
+    m_c = Simd::Shuffle< 2, 2, 2, 2 >( planeVec, planeVec );
+    m_d = Simd::Shuffle< 3, 3, 3, 3 >( planeVec, planeVec );
+}
+
+#endif  // HELIUM_SIMD_NEON
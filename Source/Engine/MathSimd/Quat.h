@@ -129,4 +129,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/QuatSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/QuatNeon.inl"
 #endif
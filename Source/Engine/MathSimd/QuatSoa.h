@@ -102,4 +102,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/QuatSoaSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/QuatSoaNeon.inl"
 #endif
@@ -0,0 +1,15 @@
+#if HELIUM_SIMD_NEON
+
+/// Splat each component of the given quaternion across each SIMD vector for each component in this quaternion set.
+///
+/// @param[in] rQuat  Quaternion from which to set this quaternion.
+void Helium::Simd::QuatSoa::Splat( const Quat& rQuat )
+{
+    Register quatVec = rQuat.GetSimdVector();
+    m_x = Simd::Shuffle< 0, 0, 0, 0 >( quatVec, quatVec );
+    m_y = Simd::Shuffle< 1, 1, 1, 1 >( quatVec, quatVec );
+    m_z = Simd::Shuffle< 2, 2, 2, 2 >( quatVec, quatVec );
+    m_w = Simd::Shuffle< 3, 3, 3, 3 >( quatVec, quatVec );
+}
+
+#endif  // HELIUM_SIMD_NEON
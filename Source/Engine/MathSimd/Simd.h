@@ -7,10 +7,14 @@
 
 #if HELIUM_CPU_X86
 #define HELIUM_SIMD_SSE 1
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+#define HELIUM_SIMD_NEON 1
 #endif
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/Sse.h"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/Neon.h"
 #else
 #define HELIUM_SIMD_DISABLED ( 1 )
 #define HELIUM_SIMD_SIZE ( 0 )
@@ -49,6 +53,16 @@ namespace Helium
         /// @name Data Manipulation
         //@{
         HELIUM_FORCEINLINE Register Select( Register vec0, Register vec1, Mask mask );
+
+        HELIUM_FORCEINLINE Register SetF32( float32_t x, float32_t y, float32_t z, float32_t w );
+
+        template< uint32_t X, uint32_t Y, uint32_t Z, uint32_t W >
+        HELIUM_FORCEINLINE Register Shuffle( Register vec0, Register vec1 );
+
+        HELIUM_FORCEINLINE Register UnpackLow( Register vec0, Register vec1 );
+        HELIUM_FORCEINLINE Register UnpackHigh( Register vec0, Register vec1 );
+        HELIUM_FORCEINLINE Register MoveHighLow( Register vec0, Register vec1 );
+        HELIUM_FORCEINLINE Register MoveLowHigh( Register vec0, Register vec1 );
         //@}
 
         /// @name Component-wise Single-precision Floating-point Math Operations
@@ -69,6 +83,23 @@ namespace Helium
         HELIUM_FORCEINLINE Register MaxF32( Register vec0, Register vec1 );
         //@}
 
+        /// @name Component-wise Single-precision Floating-point Decomposition
+        //@{
+        HELIUM_FORCEINLINE Register RoundF32( Register vec );
+        HELIUM_FORCEINLINE Register ExponentF32( Register vec );
+        HELIUM_FORCEINLINE Register PowerOfTwoF32( Register exponent );
+        //@}
+
+        /// @name Component-wise Single-precision Floating-point Approximations
+        //@{
+        inline Register RefinedInverseF32( Register vec );
+        inline Register RefinedInverseSqrtF32( Register vec );
+        inline void SinCosF32( Register angle, Register& rSin, Register& rCos );
+        inline Register Atan2F32( Register y, Register x );
+        inline Register ExpF32( Register vec );
+        inline Register LogF32( Register vec );
+        //@}
+
         /// @name Component-wise Single-precision Floating-point Logical Comparison Operations
         //@{
         HELIUM_FORCEINLINE Mask EqualsF32( Register vec0, Register vec1 );
@@ -92,10 +123,18 @@ namespace Helium
         HELIUM_FORCEINLINE Mask MaskAndNot( Mask mask0, Mask mask1 );
         HELIUM_FORCEINLINE Mask MaskOr( Mask mask0, Mask mask1 );
         HELIUM_FORCEINLINE Mask MaskXor( Mask mask0, Mask mask1 );
+
+        HELIUM_FORCEINLINE uint32_t GetMaskBits( Mask mask );
         //@}
     };
 }
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/Sse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/Neon.inl"
+#endif
+
+#if !HELIUM_SIMD_DISABLED
+#include "MathSimd/Simd.inl"
 #endif
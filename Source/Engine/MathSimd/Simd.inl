@@ -0,0 +1,195 @@
+/// Compute the multiplicative inverse of each component in a SIMD vector of single-precision floating-point values,
+/// refining the InverseF32() estimate with a Newton-Raphson step.
+///
+/// The relative error is below 2^-22 for finite non-zero components (InverseF32() alone only guarantees 2^-12 on
+/// SSE).  Zero components give infinity with the sign of the input only on platforms where the estimate does.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+///
+/// @see InverseF32()
+Helium::Simd::Register Helium::Simd::RefinedInverseF32( Helium::Simd::Register vec )
+{
+    // x' = x * (2 - v * x)
+    Register estimate = InverseF32( vec );
+    Register error = MultiplySubtractReverseF32( vec, estimate, SetSplatF32( 2.0f ) );
+
+    return MultiplyF32( estimate, error );
+}
+
+/// Compute the multiplicative inverse of the square root of each component in a SIMD vector of single-precision
+/// floating-point values, refining the InverseSqrtF32() estimate with a Newton-Raphson step.
+///
+/// The relative error is below 2^-21 for positive normalized components (InverseSqrtF32() alone only guarantees 2^-12
+/// on SSE).  Zero and negative components give undefined results.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+///
+/// @see InverseSqrtF32()
+Helium::Simd::Register Helium::Simd::RefinedInverseSqrtF32( Helium::Simd::Register vec )
+{
+    // x' = x * (1.5 - 0.5 * v * x * x)
+    Register estimate = InverseSqrtF32( vec );
+    Register halfVecEstimate = MultiplyF32( MultiplyF32( vec, SetSplatF32( 0.5f ) ), estimate );
+    Register error = MultiplySubtractReverseF32( halfVecEstimate, estimate, SetSplatF32( 1.5f ) );
+
+    return MultiplyF32( estimate, error );
+}
+
+/// Compute the sine and cosine of each component in a SIMD vector of single-precision floating-point angles.
+///
+/// Angles are reduced to [-pi/4, pi/4] and evaluated with minimax polynomials.  For angles within [-8192, 8192]
+/// radians the absolute error of both results is below 2^-22 (about 3e-7); accuracy degrades gradually for larger
+/// angles as the range reduction loses precision.  Infinite and NaN angles give undefined results.
+///
+/// @param[in]  angle  SIMD vector of angles, in radians.
+/// @param[out] rSin   Sine of each angle.
+/// @param[out] rCos   Cosine of each angle.
+void Helium::Simd::SinCosF32( Helium::Simd::Register angle, Helium::Simd::Register& rSin, Helium::Simd::Register& rCos )
+{
+    // Reduce to the quadrant offset r = angle - q * pi/2, with pi/2 split in three parts so that q * part is exact.
+    Register quadrant = RoundF32( MultiplyF32( angle, SetSplatF32( 0.63661977236758134f ) ) );
+    Register r = MultiplySubtractReverseF32( quadrant, SetSplatF32( 1.5703125f ), angle );
+    r = MultiplySubtractReverseF32( quadrant, SetSplatF32( 4.837512969970703125e-4f ), r );
+    r = MultiplySubtractReverseF32( quadrant, SetSplatF32( 7.54978995489188216e-8f ), r );
+
+    Register r2 = MultiplyF32( r, r );
+
+    Register sinPoly = MultiplyAddF32( r2, SetSplatF32( -1.9515295891e-4f ), SetSplatF32( 8.3321608736e-3f ) );
+    sinPoly = MultiplyAddF32( sinPoly, r2, SetSplatF32( -1.6666654611e-1f ) );
+    Register sinR = MultiplyAddF32( MultiplyF32( sinPoly, r2 ), r, r );
+
+    Register cosPoly = MultiplyAddF32( r2, SetSplatF32( 2.443315711809948e-5f ), SetSplatF32( -1.388731625493765e-3f ) );
+    cosPoly = MultiplyAddF32( cosPoly, r2, SetSplatF32( 4.166664568298827e-2f ) );
+    Register cosR = MultiplyAddF32(
+        MultiplyF32( cosPoly, r2 ), r2, MultiplySubtractReverseF32( r2, SetSplatF32( 0.5f ), SetSplatF32( 1.0f ) ) );
+
+    // Quadrant q mod 4 selects between the sine and cosine of r and their signs, without leaving floating-point
+    // registers: floor(q / 4) is round(q / 4 - 3/8) for integer q.
+    Register quadrantMod4 = MultiplySubtractReverseF32(
+        RoundF32( MultiplySubtractReverseF32( quadrant, SetSplatF32( -0.25f ), SetSplatF32( -0.375f ) ) ),
+        SetSplatF32( 4.0f ),
+        quadrant );
+
+    Mask swapMask = MaskOr(
+        EqualsF32( quadrantMod4, SetSplatF32( 1.0f ) ), EqualsF32( quadrantMod4, SetSplatF32( 3.0f ) ) );
+    Mask sinNegateMask = GreaterEqualsF32( quadrantMod4, SetSplatF32( 2.0f ) );
+    Mask cosNegateMask = MaskOr(
+        EqualsF32( quadrantMod4, SetSplatF32( 1.0f ) ), EqualsF32( quadrantMod4, SetSplatF32( 2.0f ) ) );
+
+    Register signBit = SetSplatU32( 0x80000000 );
+    rSin = Xor( Select( sinR, cosR, swapMask ), And( signBit, sinNegateMask ) );
+    rCos = Xor( Select( cosR, sinR, swapMask ), And( signBit, cosNegateMask ) );
+}
+
+/// Compute the arc tangent of y / x for each pair of components in two SIMD vectors of single-precision
+/// floating-point values, using the signs of both to find the quadrant of the result.
+///
+/// The absolute error is below 2^-21 (about 5e-7) for finite inputs.  Like atan2f(), a zero x with a zero y gives
+/// zero, except that the sign of zero components is ignored when choosing the quadrant.
+///
+/// @param[in] y  SIMD vector of y coordinates.
+/// @param[in] x  SIMD vector of x coordinates.
+///
+/// @return  SIMD vector with the angle of each (x, y) coordinate pair, in radians within [-pi, pi].
+Helium::Simd::Register Helium::Simd::Atan2F32( Helium::Simd::Register y, Helium::Simd::Register x )
+{
+    Register signBit = SetSplatU32( 0x80000000 );
+    Register absY = AndNot( signBit, y );
+    Register absX = AndNot( signBit, x );
+
+    // Take the arc tangent of a ratio within [0, 1], guarding against a zero denominator.
+    Register numerator = MinF32( absX, absY );
+    Register denominator = MaxF32( absX, absY );
+    Register zero = LoadZeros();
+    denominator = Select( denominator, SetSplatF32( 1.0f ), EqualsF32( denominator, zero ) );
+    Register t = DivideF32( numerator, denominator );
+
+    // Ratios above tan(pi/8) use atan(t) = pi/4 + atan((t - 1) / (t + 1)) to stay within the polynomial's range.
+    Mask reduceMask = GreaterF32( t, SetSplatF32( 0.41421356237309503f ) );
+    Register one = SetSplatF32( 1.0f );
+    t = Select( t, DivideF32( SubtractF32( t, one ), AddF32( t, one ) ), reduceMask );
+    Register offset = And( SetSplatF32( 0.78539816339744831f ), reduceMask );
+
+    Register t2 = MultiplyF32( t, t );
+    Register poly = MultiplyAddF32( t2, SetSplatF32( 8.05374449538e-2f ), SetSplatF32( -1.38776856032e-1f ) );
+    poly = MultiplyAddF32( poly, t2, SetSplatF32( 1.99777106478e-1f ) );
+    poly = MultiplyAddF32( poly, t2, SetSplatF32( -3.33329491539e-1f ) );
+    Register angle = AddF32( offset, MultiplyAddF32( MultiplyF32( poly, t2 ), t, t ) );
+
+    // Unfold the octant: swap axes, then mirror for negative x, then take the sign of y.
+    angle = Select( angle, SubtractF32( SetSplatF32( 1.57079632679489662f ), angle ), GreaterF32( absY, absX ) );
+    angle = Select( angle, SubtractF32( SetSplatF32( 3.14159265358979324f ), angle ), LessF32( x, zero ) );
+
+    return Or( angle, And( signBit, y ) );
+}
+
+/// Compute e raised to the power of each component in a SIMD vector of single-precision floating-point values.
+///
+/// Components are clamped to [-87.3, 88.0] so that results stay normalized and finite.  Within that range the
+/// relative error is below 2^-22 (about 2.4e-7).  NaN components give undefined results.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::ExpF32( Helium::Simd::Register vec )
+{
+    Register x = MinF32( MaxF32( vec, SetSplatF32( -87.3f ) ), SetSplatF32( 88.0f ) );
+
+    // e^x = 2^n * e^r, with r = x - n * ln(2) computed with ln(2) split in two parts so that n * part is exact.
+    Register n = RoundF32( MultiplyF32( x, SetSplatF32( 1.44269504088896341f ) ) );
+    Register r = MultiplySubtractReverseF32( n, SetSplatF32( 0.693359375f ), x );
+    r = MultiplySubtractReverseF32( n, SetSplatF32( -2.12194440e-4f ), r );
+
+    Register poly = MultiplyAddF32( r, SetSplatF32( 1.9875691500e-4f ), SetSplatF32( 1.3981999507e-3f ) );
+    poly = MultiplyAddF32( poly, r, SetSplatF32( 8.3334519073e-3f ) );
+    poly = MultiplyAddF32( poly, r, SetSplatF32( 4.1665795894e-2f ) );
+    poly = MultiplyAddF32( poly, r, SetSplatF32( 1.6666665459e-1f ) );
+    poly = MultiplyAddF32( poly, r, SetSplatF32( 5.0000001201e-1f ) );
+    Register expR = AddF32( MultiplyAddF32( MultiplyF32( poly, r ), r, r ), SetSplatF32( 1.0f ) );
+
+    return MultiplyF32( expR, PowerOfTwoF32( n ) );
+}
+
+/// Compute the natural logarithm of each component in a SIMD vector of single-precision floating-point values.
+///
+/// The absolute error is below 2^-22 (about 2.4e-7) for results near zero and the relative error is below 2^-22
+/// elsewhere, for positive normalized components.  Zero, negative, denormal, infinite and NaN components give
+/// undefined results.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::LogF32( Helium::Simd::Register vec )
+{
+    // log(x) = e * ln(2) + log(m), with the mantissa m moved to [sqrt(1/2), sqrt(2)) to keep m - 1 small.
+    Register exponent = ExponentF32( vec );
+    Register mantissa = Or( And( vec, SetSplatU32( 0x007fffff ) ), SetSplatF32( 1.0f ) );
+
+    Mask halveMask = GreaterF32( mantissa, SetSplatF32( 1.41421356237309505f ) );
+    mantissa = Select( mantissa, MultiplyF32( mantissa, SetSplatF32( 0.5f ) ), halveMask );
+    exponent = AddF32( exponent, And( SetSplatF32( 1.0f ), halveMask ) );
+
+    Register f = SubtractF32( mantissa, SetSplatF32( 1.0f ) );
+    Register f2 = MultiplyF32( f, f );
+
+    Register poly = MultiplyAddF32( f, SetSplatF32( 7.0376836292e-2f ), SetSplatF32( -1.1514610310e-1f ) );
+    poly = MultiplyAddF32( poly, f, SetSplatF32( 1.1676998740e-1f ) );
+    poly = MultiplyAddF32( poly, f, SetSplatF32( -1.2420140846e-1f ) );
+    poly = MultiplyAddF32( poly, f, SetSplatF32( 1.4249322787e-1f ) );
+    poly = MultiplyAddF32( poly, f, SetSplatF32( -1.6668057665e-1f ) );
+    poly = MultiplyAddF32( poly, f, SetSplatF32( 2.0000714765e-1f ) );
+    poly = MultiplyAddF32( poly, f, SetSplatF32( -2.4999993993e-1f ) );
+    poly = MultiplyAddF32( poly, f, SetSplatF32( 3.3333331174e-1f ) );
+
+    // ln(2) is split in two parts so that e * part is exact.
+    Register result = MultiplyF32( MultiplyF32( poly, f ), f2 );
+    result = MultiplyAddF32( exponent, SetSplatF32( -2.12194440e-4f ), result );
+    result = MultiplySubtractReverseF32( f2, SetSplatF32( 0.5f ), result );
+    result = AddF32( result, f );
+
+    return MultiplyAddF32( exponent, SetSplatF32( 0.693359375f ), result );
+}
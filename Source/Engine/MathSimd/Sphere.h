@@ -72,4 +72,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/SphereSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/SphereNeon.inl"
 #endif
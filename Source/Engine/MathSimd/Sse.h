@@ -5,12 +5,21 @@
 #if HELIUM_SIMD_SSE
 
 #include <xmmintrin.h>
+#include <emmintrin.h>
+
+/// Non-zero if fused multiply-add instructions (FMA3, available on all AVX2-capable processors) can be used.
+#if defined( __FMA__ ) || defined( __AVX2__ )
+#define HELIUM_SIMD_SSE_FMA 1
+#include <immintrin.h>
+#else
+#define HELIUM_SIMD_SSE_FMA 0
+#endif
 
 /// @defgroup simdvector SIMD Types
 //@{
 
 /// Non-zero if SIMD multiply-and-add is supported in a single instruction.
-#define HELIUM_SIMD_BUILTIN_MULTIPLY_ADD 0
+#define HELIUM_SIMD_BUILTIN_MULTIPLY_ADD HELIUM_SIMD_SSE_FMA
 /// Non-zero if SIMD multiply is supported in a single instruction.
 #define HELIUM_SIMD_BUILTIN_MULTIPLY 1
 
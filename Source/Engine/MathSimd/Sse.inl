@@ -130,6 +130,86 @@ Helium::Simd::Register Helium::Simd::Select( Helium::Simd::Register vec0, Helium
     return _mm_or_ps( _mm_andnot_ps( mask, vec0 ), _mm_and_ps( mask, vec1 ) );
 }
 
+/// Fill a SIMD vector with four single-precision floating-point values.
+///
+/// @param[in] x  First component value.
+/// @param[in] y  Second component value.
+/// @param[in] z  Third component value.
+/// @param[in] w  Fourth component value.
+///
+/// @return  SIMD vector containing the given values.
+Helium::Simd::Register Helium::Simd::SetF32( float32_t x, float32_t y, float32_t z, float32_t w )
+{
+    return _mm_set_ps( w, z, y, x );
+}
+
+/// Build a SIMD vector from two components of each of two vectors.
+///
+/// The first two components of the result are taken from the first vector, and the last two are taken from the
+/// second vector (equivalent to _mm_shuffle_ps( vec0, vec1, _MM_SHUFFLE( W, Z, Y, X ) )).
+///
+/// @param[in] vec0  SIMD vector from which to take the first two result components.
+/// @param[in] vec1  SIMD vector from which to take the last two result components.
+///
+/// @return  SIMD vector with the result of the operation.
+template< uint32_t X, uint32_t Y, uint32_t Z, uint32_t W >
+Helium::Simd::Register Helium::Simd::Shuffle( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return _mm_shuffle_ps( vec0, vec1, _MM_SHUFFLE( W, Z, Y, X ) );
+}
+
+/// Interleave the first two components of two SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector containing ( vec0.x, vec1.x, vec0.y, vec1.y ).
+///
+/// @see UnpackHigh()
+Helium::Simd::Register Helium::Simd::UnpackLow( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return _mm_unpacklo_ps( vec0, vec1 );
+}
+
+/// Interleave the last two components of two SIMD vectors.
+///
+/// @param[in] vec0  SIMD vector.
+/// @param[in] vec1  SIMD vector.
+///
+/// @return  SIMD vector containing ( vec0.z, vec1.z, vec0.w, vec1.w ).
+///
+/// @see UnpackLow()
+Helium::Simd::Register Helium::Simd::UnpackHigh( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return _mm_unpackhi_ps( vec0, vec1 );
+}
+
+/// Combine the last two components of one SIMD vector with the last two components of another.
+///
+/// @param[in] vec0  SIMD vector providing the last two result components.
+/// @param[in] vec1  SIMD vector providing the first two result components.
+///
+/// @return  SIMD vector containing ( vec1.z, vec1.w, vec0.z, vec0.w ).
+///
+/// @see MoveLowHigh()
+Helium::Simd::Register Helium::Simd::MoveHighLow( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return _mm_movehl_ps( vec0, vec1 );
+}
+
+/// Combine the first two components of one SIMD vector with the first two components of another.
+///
+/// @param[in] vec0  SIMD vector providing the first two result components.
+/// @param[in] vec1  SIMD vector providing the last two result components.
+///
+/// @return  SIMD vector containing ( vec0.x, vec0.y, vec1.x, vec1.y ).
+///
+/// @see MoveHighLow()
+Helium::Simd::Register Helium::Simd::MoveLowHigh( Helium::Simd::Register vec0, Helium::Simd::Register vec1 )
+{
+    return _mm_movelh_ps( vec0, vec1 );
+}
+
 /// Perform a component-wise addition of two SIMD vectors of single-precision floating-point values.
 ///
 /// @param[in] vec0  SIMD vector.
@@ -190,7 +270,11 @@ Helium::Simd::Register Helium::Simd::MultiplyAddF32(
     Helium::Simd::Register vecMul1,
     Helium::Simd::Register vecAdd )
 {
+#if HELIUM_SIMD_SSE_FMA
+    return _mm_fmadd_ps( vecMul0, vecMul1, vecAdd );
+#else
     return _mm_add_ps( _mm_mul_ps( vecMul0, vecMul1 ), vecAdd );
+#endif
 }
 
 /// Perform a component-wise multiplication of two SIMD vectors of single-precision floating-point values, and
@@ -209,7 +293,11 @@ Helium::Simd::Register Helium::Simd::MultiplySubtractReverseF32(
     Helium::Simd::Register vecMul1,
     Helium::Simd::Register vecSub )
 {
+#if HELIUM_SIMD_SSE_FMA
+    return _mm_fnmadd_ps( vecMul0, vecMul1, vecSub );
+#else
     return _mm_sub_ps( vecSub, _mm_mul_ps( vecMul0, vecMul1 ) );
+#endif
 }
 
 /// Compute the square root of each component in a SIMD vector of single-precision floating-point values.
@@ -277,6 +365,48 @@ Helium::Simd::Register Helium::Simd::MaxF32( Helium::Simd::Register vec0, Helium
     return _mm_max_ps( vec0, vec1 );
 }
 
+/// Round each component in a SIMD vector of single-precision floating-point values to the nearest integer.
+///
+/// Components must be within the range of a signed 32-bit integer.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::RoundF32( Helium::Simd::Register vec )
+{
+    return _mm_cvtepi32_ps( _mm_cvtps_epi32( vec ) );
+}
+
+/// Extract the unbiased binary exponent of each component in a SIMD vector of single-precision floating-point values.
+///
+/// The result is floor(log2(abs(x))) for normalized values.  Zero, denormal, infinite and NaN components give
+/// undefined results.
+///
+/// @param[in] vec  SIMD vector.
+///
+/// @return  SIMD vector with the exponent of each component, as floating-point values.
+Helium::Simd::Register Helium::Simd::ExponentF32( Helium::Simd::Register vec )
+{
+    __m128i biasedExponent = _mm_and_si128( _mm_srli_epi32( _mm_castps_si128( vec ), 23 ), _mm_set1_epi32( 0xff ) );
+
+    return _mm_cvtepi32_ps( _mm_sub_epi32( biasedExponent, _mm_set1_epi32( 127 ) ) );
+}
+
+/// Compute two raised to the power of each component in a SIMD vector of integer-valued single-precision
+/// floating-point values.
+///
+/// The result is exact for exponents in the range [-126, 127], and undefined for other exponents.
+///
+/// @param[in] exponent  SIMD vector of exponents.
+///
+/// @return  SIMD vector with the result of the operation.
+Helium::Simd::Register Helium::Simd::PowerOfTwoF32( Helium::Simd::Register exponent )
+{
+    __m128i biasedExponent = _mm_add_epi32( _mm_cvtps_epi32( exponent ), _mm_set1_epi32( 127 ) );
+
+    return _mm_castsi128_ps( _mm_slli_epi32( biasedExponent, 23 ) );
+}
+
 /// Compare each component in two SIMD vectors of single-precision floating-point values for equality, setting each
 /// component in the result mask based on the result of the comparison.
 ///
@@ -401,6 +531,16 @@ Helium::Simd::Register Helium::Simd::Xor( Helium::Simd::Register vec0, Helium::S
     return _mm_xor_ps( vec0, vec1 );
 }
 
+/// Get a bit field of the sign bit of each component in a SIMD mask.
+///
+/// @param[in] mask  SIMD mask.
+///
+/// @return  Bit field with bit N set if component N of the mask is set.
+uint32_t Helium::Simd::GetMaskBits( Helium::Simd::Mask mask )
+{
+    return static_cast< uint32_t >( _mm_movemask_ps( mask ) );
+}
+
 /// Compute the bitwise-AND of two SIMD masks.
 ///
 /// @param[in] mask0  SIMD mask.
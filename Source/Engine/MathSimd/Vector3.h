@@ -143,4 +143,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/Vector3Sse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/Vector3Neon.inl"
 #endif
@@ -112,4 +112,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/Vector3SoaSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/Vector3SoaNeon.inl"
 #endif
@@ -0,0 +1,14 @@
+#if HELIUM_SIMD_NEON
+
+/// Splat each component of the given vector across each SIMD vector for each component in this vector set.
+///
+/// @param[in] rVector  Vector from which to set this vector.
+void Helium::Simd::Vector3Soa::Splat( const Vector3& rVector )
+{
+    Register vectorVec = rVector.GetSimdVector();
+    m_x = Simd::Shuffle< 0, 0, 0, 0 >( vectorVec, vectorVec );
+    m_y = Simd::Shuffle< 1, 1, 1, 1 >( vectorVec, vectorVec );
+    m_z = Simd::Shuffle< 2, 2, 2, 2 >( vectorVec, vectorVec );
+}
+
+#endif  // HELIUM_SIMD_NEON
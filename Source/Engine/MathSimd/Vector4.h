@@ -135,4 +135,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/Vector4Sse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/Vector4Neon.inl"
 #endif
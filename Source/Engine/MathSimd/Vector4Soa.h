@@ -111,4 +111,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/Vector4SoaSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/Vector4SoaNeon.inl"
 #endif
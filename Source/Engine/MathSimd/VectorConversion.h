@@ -21,4 +21,6 @@ namespace Helium
 
 #if HELIUM_SIMD_SSE
 #include "MathSimd/VectorConversionSse.inl"
+#elif HELIUM_SIMD_NEON
+#include "MathSimd/VectorConversionNeon.inl"
 #endif
@@ -1,8 +1,17 @@
 #include "Precompile.h"
 #include "OisSystem.h"
 
+#include "Platform/Atomic.h"
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
+#include "Platform/Trace.h"
+
 #include <OIS.h>
 
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
 using namespace Helium;
 
 static int g_OisInitCount = 0;
@@ -14,6 +23,246 @@ static OIS::Mouse *g_Mouse = 0;
 char g_PreviousFrameKeyStates[MAX_KEY_STATES];
 int g_PreviousFrameMouseButtonState;
 
+namespace
+{
+	enum ScriptedEventType
+	{
+		SCRIPTED_EVENT_KEY,
+		SCRIPTED_EVENT_BUTTON,
+		SCRIPTED_EVENT_MOUSE
+	};
+
+	struct ScriptedEvent
+	{
+		uint32_t m_Frame;
+		ScriptedEventType m_Type;
+		int m_A; // Key code, button mask or mouse x
+		int m_B; // Key state or mouse y
+	};
+
+	bool IsScriptedEventEarlier( const ScriptedEvent &rA, const ScriptedEvent &rB )
+	{
+		return rA.m_Frame < rB.m_Frame;
+	}
+}
+
+// Scripted input state, used in place of the devices while a script is active
+static bool g_ScriptActive = false;
+static std::vector< ScriptedEvent > g_ScriptEvents;
+static size_t g_ScriptNextEvent = 0;
+static uint32_t g_ScriptFrame = 0;
+static char g_ScriptKeyStates[MAX_KEY_STATES];
+static int g_ScriptMouseButtonState = 0;
+static int g_ScriptMouseX = 0;
+static int g_ScriptMouseY = 0;
+static int g_ScriptMouseDeltaX = 0;
+static int g_ScriptMouseDeltaY = 0;
+static int g_ScriptWindowWidth = 1;
+static int g_ScriptWindowHeight = 1;
+
+// Capture thread state. The thread owns the devices while it runs and hands events to Capture() through a
+// single-producer, single-consumer ring. Only published counts are shared; each side owns its own state
+#define EVENT_QUEUE_SIZE (1024)
+
+static CallbackThread g_CaptureThread;
+static bool g_CaptureThreadRunning = false;
+static volatile int32_t g_CaptureThreadStop = 0;
+static uint64_t g_CaptureIntervalTicks = 0;
+static volatile int32_t g_PendingWindowWidth = 0;
+static volatile int32_t g_PendingWindowHeight = 0;
+
+static Input::Event g_EventQueue[EVENT_QUEUE_SIZE];
+static volatile int32_t g_EventWriteCount = 0;
+static volatile int32_t g_EventReadCount = 0;
+
+// Device state as last published by the capture thread (only touched by the thread)
+static char g_PublishedKeyStates[MAX_KEY_STATES];
+static int g_PublishedMouseButtonState = 0;
+static int g_PublishedMouseX = 0;
+static int g_PublishedMouseY = 0;
+
+// Device state rebuilt from the events by Capture() (only touched by the main thread)
+static std::vector< Input::Event > g_FrameEvents;
+static char g_ThreadKeyStates[MAX_KEY_STATES];
+static char g_FrameKeysDown[MAX_KEY_STATES];
+static char g_FrameKeysPressed[MAX_KEY_STATES];
+static int g_ThreadMouseButtonState = 0;
+static int g_FrameMouseButtonsDown = 0;
+static int g_FrameMouseButtonsPressed = 0;
+static int g_ThreadMouseX = 0;
+static int g_ThreadMouseY = 0;
+static int g_ThreadMouseDeltaX = 0;
+static int g_ThreadMouseDeltaY = 0;
+static int g_ThreadWindowWidth = 1;
+static int g_ThreadWindowHeight = 1;
+static uint64_t g_FrameStartTicks = 0;
+static uint64_t g_FrameEndTicks = 0;
+
+namespace
+{
+	// Queue an event, or return false if the ring is full. Changes that could not be queued are seen again on the
+	// next poll because the published state is only updated once the event is in, so no release is ever lost
+	bool PushEvent( const Input::Event &rEvent )
+	{
+		int32_t writeCount = g_EventWriteCount;
+		if ( writeCount - AtomicOrAcquire( g_EventReadCount, 0 ) >= EVENT_QUEUE_SIZE )
+		{
+			return false;
+		}
+
+		g_EventQueue[ writeCount & ( EVENT_QUEUE_SIZE - 1 ) ] = rEvent;
+		AtomicExchangeRelease( g_EventWriteCount, writeCount + 1 );
+		return true;
+	}
+
+	void PollDevices()
+	{
+		int32_t windowWidth = AtomicExchangeAcquire( g_PendingWindowWidth, 0 );
+		int32_t windowHeight = AtomicExchangeAcquire( g_PendingWindowHeight, 0 );
+		if ( windowWidth > 0 && windowHeight > 0 )
+		{
+			const OIS::MouseState &mouseState = g_Mouse->getMouseState();
+			mouseState.width  = windowWidth;
+			mouseState.height = windowHeight;
+		}
+
+		g_Keyboard->capture();
+		g_Mouse->capture();
+
+		Input::Event event;
+		event.m_TickCount = Timer::GetTickCount();
+		event.m_Code = 0;
+		event.m_bDown = false;
+		event.m_X = 0;
+		event.m_Y = 0;
+		event.m_DeltaX = 0;
+		event.m_DeltaY = 0;
+
+		char keyStates[MAX_KEY_STATES];
+		g_Keyboard->copyKeyStates( keyStates );
+		for (int i = 0; i < MAX_KEY_STATES; ++i)
+		{
+			if ( ( keyStates[i] != 0 ) != ( g_PublishedKeyStates[i] != 0 ) )
+			{
+				event.m_Type = Input::EventTypes::Key;
+				event.m_Code = i;
+				event.m_bDown = keyStates[i] != 0;
+				if ( PushEvent( event ) )
+				{
+					g_PublishedKeyStates[i] = keyStates[i];
+				}
+			}
+		}
+
+		const OIS::MouseState &mouseState = g_Mouse->getMouseState();
+		if ( mouseState.buttons != g_PublishedMouseButtonState )
+		{
+			event.m_Type = Input::EventTypes::MouseButtons;
+			event.m_Code = mouseState.buttons;
+			if ( PushEvent( event ) )
+			{
+				g_PublishedMouseButtonState = mouseState.buttons;
+			}
+		}
+
+		if ( mouseState.X.abs != g_PublishedMouseX || mouseState.Y.abs != g_PublishedMouseY || mouseState.X.rel || mouseState.Y.rel )
+		{
+			event.m_Type = Input::EventTypes::MouseMove;
+			event.m_Code = 0;
+			event.m_X = mouseState.X.abs;
+			event.m_Y = mouseState.Y.abs;
+			event.m_DeltaX = mouseState.X.rel;
+			event.m_DeltaY = mouseState.Y.rel;
+			if ( PushEvent( event ) )
+			{
+				g_PublishedMouseX = mouseState.X.abs;
+				g_PublishedMouseY = mouseState.Y.abs;
+			}
+		}
+	}
+
+	void CaptureThreadEntry( void* )
+	{
+		uint64_t nextPollTicks = Timer::GetTickCount();
+		while ( !AtomicOrAcquire( g_CaptureThreadStop, 0 ) )
+		{
+			PollDevices();
+
+			// Keep to the schedule rather than the time taken by each poll, skipping polls that were missed entirely
+			nextPollTicks += g_CaptureIntervalTicks;
+			uint64_t tickCount = Timer::GetTickCount();
+			if ( nextPollTicks <= tickCount )
+			{
+				nextPollTicks = tickCount;
+				continue;
+			}
+
+			uint64_t sleepMilliseconds = ( nextPollTicks - tickCount ) * 1000 / Timer::GetTicksPerSecond();
+			Thread::Sleep( static_cast< uint32_t >( sleepMilliseconds ) );
+		}
+	}
+
+	void ApplyEvent( const Input::Event &rEvent )
+	{
+		switch ( rEvent.m_Type )
+		{
+		case Input::EventTypes::Key:
+			g_ThreadKeyStates[ rEvent.m_Code ] = rEvent.m_bDown ? 1 : 0;
+			if ( rEvent.m_bDown )
+			{
+				g_FrameKeysDown[ rEvent.m_Code ] = 1;
+				g_FrameKeysPressed[ rEvent.m_Code ] = 1;
+			}
+			break;
+
+		case Input::EventTypes::MouseButtons:
+			g_FrameMouseButtonsPressed |= rEvent.m_Code & ~g_ThreadMouseButtonState;
+			g_FrameMouseButtonsDown |= rEvent.m_Code;
+			g_ThreadMouseButtonState = rEvent.m_Code;
+			break;
+
+		case Input::EventTypes::MouseMove:
+			g_ThreadMouseX = rEvent.m_X;
+			g_ThreadMouseY = rEvent.m_Y;
+			g_ThreadMouseDeltaX += rEvent.m_DeltaX;
+			g_ThreadMouseDeltaY += rEvent.m_DeltaY;
+			break;
+		}
+	}
+
+	void CaptureFromThread()
+	{
+		for (int i =0; i < MAX_KEY_STATES; ++i)
+		{
+			g_PreviousFrameKeyStates[i] = g_ThreadKeyStates[i];
+			g_FrameKeysDown[i] = g_ThreadKeyStates[i];
+			g_FrameKeysPressed[i] = 0;
+		}
+		g_PreviousFrameMouseButtonState = g_ThreadMouseButtonState;
+		g_FrameMouseButtonsDown = g_ThreadMouseButtonState;
+		g_FrameMouseButtonsPressed = 0;
+		g_ThreadMouseDeltaX = 0;
+		g_ThreadMouseDeltaY = 0;
+
+		g_FrameEvents.clear();
+
+		// Events sampled before the end of this frame but published after the read are applied next frame
+		g_FrameStartTicks = g_FrameEndTicks;
+		g_FrameEndTicks = Timer::GetTickCount();
+
+		int32_t readCount = g_EventReadCount;
+		int32_t writeCount = AtomicOrAcquire( g_EventWriteCount, 0 );
+		for ( ; readCount != writeCount; ++readCount )
+		{
+			const Input::Event &rEvent = g_EventQueue[ readCount & ( EVENT_QUEUE_SIZE - 1 ) ];
+			g_FrameEvents.push_back( rEvent );
+			ApplyEvent( rEvent );
+		}
+
+		AtomicExchangeRelease( g_EventReadCount, readCount );
+	}
+}
+
 void Input::Initialize(Input::NativeHandle window, bool bExclusive)
 {
 	if (!g_OisInitCount++)
@@ -69,14 +318,211 @@ void Input::Cleanup()
 	--g_OisInitCount;
 	if (!g_OisInitCount)
 	{
+		StopCaptureThread();
+
 		HELIUM_ASSERT(g_InputSystem);
 		g_InputSystem->destroyInputSystem( g_InputSystem );
 		g_InputSystem = 0;
 	}
 }
 
+bool Input::StartCaptureThread(uint32_t frequency)
+{
+	HELIUM_ASSERT( frequency );
+	if ( g_CaptureThreadRunning )
+	{
+		return true;
+	}
+
+	if ( !g_Keyboard || !g_Mouse || !frequency )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "Input::StartCaptureThread(): Input devices are not initialized.\n" );
+		return false;
+	}
+
+	// Start from the current device state so that keys already held don't show up as presses
+	g_Keyboard->capture();
+	g_Mouse->capture();
+	g_Keyboard->copyKeyStates( g_PublishedKeyStates );
+	const OIS::MouseState &mouseState = g_Mouse->getMouseState();
+	g_PublishedMouseButtonState = mouseState.buttons;
+	g_PublishedMouseX = mouseState.X.abs;
+	g_PublishedMouseY = mouseState.Y.abs;
+
+	for (int i =0; i < MAX_KEY_STATES; ++i)
+	{
+		g_ThreadKeyStates[i] = g_PublishedKeyStates[i];
+		g_PreviousFrameKeyStates[i] = g_PublishedKeyStates[i];
+		g_FrameKeysDown[i] = g_PublishedKeyStates[i];
+		g_FrameKeysPressed[i] = 0;
+	}
+
+	g_ThreadMouseButtonState = g_PublishedMouseButtonState;
+	g_PreviousFrameMouseButtonState = g_PublishedMouseButtonState;
+	g_FrameMouseButtonsDown = g_PublishedMouseButtonState;
+	g_FrameMouseButtonsPressed = 0;
+	g_ThreadMouseX = g_PublishedMouseX;
+	g_ThreadMouseY = g_PublishedMouseY;
+	g_ThreadMouseDeltaX = 0;
+	g_ThreadMouseDeltaY = 0;
+	g_ThreadWindowWidth = mouseState.width > 0 ? mouseState.width : 1;
+	g_ThreadWindowHeight = mouseState.height > 0 ? mouseState.height : 1;
+	g_FrameEvents.clear();
+	g_FrameStartTicks = Timer::GetTickCount();
+	g_FrameEndTicks = g_FrameStartTicks;
+
+	g_EventWriteCount = 0;
+	g_EventReadCount = 0;
+	g_CaptureIntervalTicks = Timer::GetTicksPerSecond() / frequency;
+	AtomicExchangeRelease( g_CaptureThreadStop, 0 );
+
+	if ( !g_CaptureThread.Create( &CaptureThreadEntry, NULL, "Input Capture Thread" ) )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "Input::StartCaptureThread(): Failed to create the input capture thread.\n" );
+		return false;
+	}
+
+	g_CaptureThreadRunning = true;
+	return true;
+}
+
+void Input::StopCaptureThread()
+{
+	if ( !g_CaptureThreadRunning )
+	{
+		return;
+	}
+
+	AtomicExchangeRelease( g_CaptureThreadStop, 1 );
+	g_CaptureThread.Join();
+	g_CaptureThreadRunning = false;
+	g_FrameEvents.clear();
+}
+
+bool Input::IsCaptureThreadRunning()
+{
+	return g_CaptureThreadRunning;
+}
+
+const Input::Event* Input::GetFrameEvents(size_t &rCount)
+{
+	rCount = g_FrameEvents.size();
+	return g_FrameEvents.empty() ? NULL : &g_FrameEvents[ 0 ];
+}
+
+bool Input::BeginScriptedInput(const char *pScriptPath)
+{
+	std::vector< ScriptedEvent > events;
+
+	std::ifstream scriptFile;
+	if ( pScriptPath && pScriptPath[ 0 ] != '\0' )
+	{
+		scriptFile.open( pScriptPath );
+		if ( !scriptFile.is_open() )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "Input::BeginScriptedInput(): Failed to open input script \"%s\".\n", pScriptPath );
+			return false;
+		}
+	}
+
+	std::string line;
+	for ( uint32_t lineNumber = 1; scriptFile.is_open() && std::getline( scriptFile, line ); ++lineNumber )
+	{
+		size_t start = line.find_first_not_of( " \t\r" );
+		if ( start == std::string::npos || line[ start ] == '#' )
+		{
+			continue;
+		}
+
+		std::istringstream lineStream( line );
+		std::string type;
+		ScriptedEvent event;
+		event.m_A = 0;
+		event.m_B = 0;
+
+		bool bValid = static_cast< bool >( lineStream >> event.m_Frame >> type );
+		if ( bValid && type == "key" )
+		{
+			event.m_Type = SCRIPTED_EVENT_KEY;
+			bValid = static_cast< bool >( lineStream >> event.m_A >> event.m_B ) && event.m_A >= 0 && event.m_A < MAX_KEY_STATES;
+		}
+		else if ( bValid && type == "button" )
+		{
+			event.m_Type = SCRIPTED_EVENT_BUTTON;
+			bValid = static_cast< bool >( lineStream >> event.m_A );
+		}
+		else if ( bValid && type == "mouse" )
+		{
+			event.m_Type = SCRIPTED_EVENT_MOUSE;
+			bValid = static_cast< bool >( lineStream >> event.m_A >> event.m_B );
+		}
+		else
+		{
+			bValid = false;
+		}
+
+		if ( !bValid )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "Input::BeginScriptedInput(): Invalid event on line %" PRIu32 " of \"%s\".\n", lineNumber, pScriptPath );
+			return false;
+		}
+
+		events.push_back( event );
+	}
+
+	// Events of the same frame are applied in the order they are listed
+	std::stable_sort( events.begin(), events.end(), IsScriptedEventEarlier );
+
+	g_ScriptEvents.swap( events );
+	g_ScriptNextEvent = 0;
+	g_ScriptFrame = 0;
+	g_ScriptMouseButtonState = 0;
+	g_ScriptMouseX = 0;
+	g_ScriptMouseY = 0;
+	g_ScriptMouseDeltaX = 0;
+	g_ScriptMouseDeltaY = 0;
+	g_PreviousFrameMouseButtonState = 0;
+	for (int i =0; i < MAX_KEY_STATES; ++i)
+	{
+		g_ScriptKeyStates[i] = 0;
+		g_PreviousFrameKeyStates[i] = 0;
+	}
+
+	g_ScriptActive = true;
+	return true;
+}
+
+void Input::EndScriptedInput()
+{
+	g_ScriptActive = false;
+	g_ScriptEvents.clear();
+	g_ScriptNextEvent = 0;
+}
+
+bool Input::IsScriptedInputActive()
+{
+	return g_ScriptActive;
+}
+
 void Input::SetWindowSize(int x, int y)
 {
+	if ( g_ScriptActive )
+	{
+		g_ScriptWindowWidth = x > 0 ? x : 1;
+		g_ScriptWindowHeight = y > 0 ? y : 1;
+		return;
+	}
+
+	if ( g_CaptureThreadRunning )
+	{
+		// The thread applies the size to the device before its next poll
+		g_ThreadWindowWidth = x > 0 ? x : 1;
+		g_ThreadWindowHeight = y > 0 ? y : 1;
+		AtomicExchangeRelease( g_PendingWindowHeight, g_ThreadWindowHeight );
+		AtomicExchangeRelease( g_PendingWindowWidth, g_ThreadWindowWidth );
+		return;
+	}
+
 	const OIS::MouseState &mouseState = g_Mouse->getMouseState();
 	mouseState.width  = x;
 	mouseState.height = y;
@@ -84,6 +530,48 @@ void Input::SetWindowSize(int x, int y)
 
 void Input::Capture()
 {
+	if ( g_ScriptActive )
+	{
+		for (int i =0; i < MAX_KEY_STATES; ++i)
+		{
+			g_PreviousFrameKeyStates[i] = g_ScriptKeyStates[i];
+		}
+		g_PreviousFrameMouseButtonState = g_ScriptMouseButtonState;
+
+		const int previousMouseX = g_ScriptMouseX;
+		const int previousMouseY = g_ScriptMouseY;
+		for ( ; g_ScriptNextEvent < g_ScriptEvents.size() && g_ScriptEvents[ g_ScriptNextEvent ].m_Frame <= g_ScriptFrame; ++g_ScriptNextEvent )
+		{
+			const ScriptedEvent &rEvent = g_ScriptEvents[ g_ScriptNextEvent ];
+			switch ( rEvent.m_Type )
+			{
+			case SCRIPTED_EVENT_KEY:
+				g_ScriptKeyStates[ rEvent.m_A ] = rEvent.m_B ? 1 : 0;
+				break;
+
+			case SCRIPTED_EVENT_BUTTON:
+				g_ScriptMouseButtonState = rEvent.m_A;
+				break;
+
+			case SCRIPTED_EVENT_MOUSE:
+				g_ScriptMouseX = rEvent.m_A;
+				g_ScriptMouseY = rEvent.m_B;
+				break;
+			}
+		}
+
+		g_ScriptMouseDeltaX = g_ScriptMouseX - previousMouseX;
+		g_ScriptMouseDeltaY = g_ScriptMouseY - previousMouseY;
+		++g_ScriptFrame;
+		return;
+	}
+
+	if ( g_CaptureThreadRunning )
+	{
+		CaptureFromThread();
+		return;
+	}
+
 	if ( HELIUM_VERIFY( g_Keyboard ) )
 	{
 		g_Keyboard->copyKeyStates(g_PreviousFrameKeyStates);
@@ -99,6 +587,16 @@ void Input::Capture()
 
 bool Input::IsKeyDown(Input::KeyCode keyCode)
 {
+	if ( g_ScriptActive )
+	{
+		return g_ScriptKeyStates[keyCode] != 0;
+	}
+
+	if ( g_CaptureThreadRunning )
+	{
+		return g_ThreadKeyStates[keyCode] != 0;
+	}
+
 	if( HELIUM_VERIFY( g_Keyboard ) )
 	{
 		return g_Keyboard->isKeyDown(static_cast<OIS::KeyCode>(keyCode));
@@ -109,6 +607,16 @@ bool Input::IsKeyDown(Input::KeyCode keyCode)
 
 bool Input::WasKeyPressedThisFrame(Input::KeyCode keyCode)
 {
+	if ( g_ScriptActive )
+	{
+		return !g_PreviousFrameKeyStates[keyCode] && g_ScriptKeyStates[keyCode];
+	}
+
+	if ( g_CaptureThreadRunning )
+	{
+		return g_FrameKeysPressed[keyCode] != 0;
+	}
+
 	if ( HELIUM_VERIFY( g_Keyboard ) )
 	{
 		return !g_PreviousFrameKeyStates[keyCode] && g_Keyboard->isKeyDown(static_cast<OIS::KeyCode>(keyCode));
@@ -119,6 +627,36 @@ bool Input::WasKeyPressedThisFrame(Input::KeyCode keyCode)
 
 bool Input::IsModifierDown(Input::KeyboardModifier keyCode)
 {
+	if ( g_ScriptActive )
+	{
+		switch ( keyCode )
+		{
+		case KeyboardModifiers::Shift:
+			return g_ScriptKeyStates[KeyCodes::KC_LSHIFT] || g_ScriptKeyStates[KeyCodes::KC_RSHIFT];
+		case KeyboardModifiers::Ctrl:
+			return g_ScriptKeyStates[KeyCodes::KC_LCONTROL] || g_ScriptKeyStates[KeyCodes::KC_RCONTROL];
+		case KeyboardModifiers::Alt:
+			return g_ScriptKeyStates[KeyCodes::KC_LMENU] || g_ScriptKeyStates[KeyCodes::KC_RMENU];
+		}
+
+		return false;
+	}
+
+	if ( g_CaptureThreadRunning )
+	{
+		switch ( keyCode )
+		{
+		case KeyboardModifiers::Shift:
+			return g_ThreadKeyStates[KeyCodes::KC_LSHIFT] || g_ThreadKeyStates[KeyCodes::KC_RSHIFT];
+		case KeyboardModifiers::Ctrl:
+			return g_ThreadKeyStates[KeyCodes::KC_LCONTROL] || g_ThreadKeyStates[KeyCodes::KC_RCONTROL];
+		case KeyboardModifiers::Alt:
+			return g_ThreadKeyStates[KeyCodes::KC_LMENU] || g_ThreadKeyStates[KeyCodes::KC_RMENU];
+		}
+
+		return false;
+	}
+
 	if ( HELIUM_VERIFY( g_Keyboard )  )
 	{
 		return g_Keyboard->isModifierDown(static_cast< OIS::Keyboard::Modifier >(keyCode));
@@ -129,6 +667,16 @@ bool Input::IsModifierDown(Input::KeyboardModifier keyCode)
 
 bool Input::IsMouseButtonDown( MouseButton button )
 {
+	if ( g_ScriptActive )
+	{
+		return (g_ScriptMouseButtonState & button) != 0;
+	}
+
+	if ( g_CaptureThreadRunning )
+	{
+		return (g_ThreadMouseButtonState & button) != 0;
+	}
+
 	if ( HELIUM_VERIFY( g_Mouse ) )
 	{
 		return (g_Mouse->getMouseState().buttons & button) != 0;
@@ -139,11 +687,82 @@ bool Input::IsMouseButtonDown( MouseButton button )
 
 bool Input::WasMouseButtonPressedThisFrame( MouseButton button )
 {
+	if ( g_CaptureThreadRunning && !g_ScriptActive )
+	{
+		return (g_FrameMouseButtonsPressed & button) != 0;
+	}
+
 	return IsMouseButtonDown( button ) && ( (g_PreviousFrameMouseButtonState & button) == 0 );
 }
 
+bool Input::WasKeyDownThisFrame(Input::KeyCode keyCode)
+{
+	if ( g_CaptureThreadRunning && !g_ScriptActive )
+	{
+		return g_FrameKeysDown[keyCode] != 0;
+	}
+
+	return IsKeyDown( keyCode );
+}
+
+float32_t Input::GetKeyHeldFractionThisFrame(Input::KeyCode keyCode)
+{
+	if ( !g_CaptureThreadRunning || g_ScriptActive || g_FrameEndTicks <= g_FrameStartTicks )
+	{
+		return IsKeyDown( keyCode ) ? 1.0f : 0.0f;
+	}
+
+	// Walk the key's transitions within the frame, timing how long it spent down
+	bool bDown = g_PreviousFrameKeyStates[keyCode] != 0;
+	uint64_t heldTicks = 0;
+	uint64_t lastTicks = g_FrameStartTicks;
+	for ( std::vector< Event >::const_iterator iter = g_FrameEvents.begin(); iter != g_FrameEvents.end(); ++iter )
+	{
+		if ( iter->m_Type != EventTypes::Key || iter->m_Code != keyCode )
+		{
+			continue;
+		}
+
+		uint64_t tickCount = std::min( std::max( iter->m_TickCount, g_FrameStartTicks ), g_FrameEndTicks );
+		if ( bDown )
+		{
+			heldTicks += tickCount - lastTicks;
+		}
+
+		lastTicks = tickCount;
+		bDown = iter->m_bDown;
+	}
+
+	if ( bDown )
+	{
+		heldTicks += g_FrameEndTicks - lastTicks;
+	}
+
+	return static_cast< float32_t >( static_cast< float64_t >( heldTicks ) / static_cast< float64_t >( g_FrameEndTicks - g_FrameStartTicks ) );
+}
+
+bool Input::WasMouseButtonDownThisFrame( MouseButton button )
+{
+	if ( g_CaptureThreadRunning && !g_ScriptActive )
+	{
+		return (g_FrameMouseButtonsDown & button) != 0;
+	}
+
+	return IsMouseButtonDown( button );
+}
+
 Point Input::GetMousePos()
 {
+	if ( g_ScriptActive )
+	{
+		return Point( g_ScriptMouseX, g_ScriptMouseY );
+	}
+
+	if ( g_CaptureThreadRunning )
+	{
+		return Point( g_ThreadMouseX, g_ThreadMouseY );
+	}
+
 	if ( HELIUM_VERIFY( g_Mouse ) )
 	{
 		return Point( g_Mouse->getMouseState().X.abs, g_Mouse->getMouseState().X.abs);
@@ -156,7 +775,17 @@ Simd::Vector2 Input::GetMousePosNormalized()
 {
 	Simd::Vector2 v2( 0.f, 0.f );
 	
-	if ( HELIUM_VERIFY( g_Mouse ) )
+	if ( g_ScriptActive )
+	{
+		v2.SetX( (static_cast<float>(g_ScriptMouseX) / static_cast<float>(g_ScriptWindowWidth) - 0.5f) * 2.0f );
+		v2.SetY( (static_cast<float>(g_ScriptMouseY) / static_cast<float>(g_ScriptWindowHeight) - 0.5f) * -2.0f );
+	}
+	else if ( g_CaptureThreadRunning )
+	{
+		v2.SetX( (static_cast<float>(g_ThreadMouseX) / static_cast<float>(g_ThreadWindowWidth) - 0.5f) * 2.0f );
+		v2.SetY( (static_cast<float>(g_ThreadMouseY) / static_cast<float>(g_ThreadWindowHeight) - 0.5f) * -2.0f );
+	}
+	else if ( HELIUM_VERIFY( g_Mouse ) )
 	{
 		v2.SetX( (static_cast<float>(g_Mouse->getMouseState().X.abs) / static_cast<float>(g_Mouse->getMouseState().width) - 0.5f) * 2.0f );
 		v2.SetY( (static_cast<float>(g_Mouse->getMouseState().Y.abs) / static_cast<float>(g_Mouse->getMouseState().height) - 0.5f) * -2.0f );
@@ -169,7 +798,17 @@ Simd::Vector2 Input::GetMousePosDelta()
 {
 	Simd::Vector2 v2( 0.f, 0.f );
 
-	if ( HELIUM_VERIFY( g_Mouse ) )
+	if ( g_ScriptActive )
+	{
+		v2.SetX( static_cast<float>(g_ScriptMouseDeltaX) );
+		v2.SetY( static_cast<float>(g_ScriptMouseDeltaY) );
+	}
+	else if ( g_CaptureThreadRunning )
+	{
+		v2.SetX( static_cast<float>(g_ThreadMouseDeltaX) );
+		v2.SetY( static_cast<float>(g_ThreadMouseDeltaY) );
+	}
+	else if ( HELIUM_VERIFY( g_Mouse ) )
 	{
 		v2.SetX( static_cast<float>(g_Mouse->getMouseState().X.rel) );
 		v2.SetY( static_cast<float>(g_Mouse->getMouseState().Y.rel) );
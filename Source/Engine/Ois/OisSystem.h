@@ -202,10 +202,57 @@ namespace Helium
 		HELIUM_OIS_API void Initialize(Input::NativeHandle window, bool bExclusive);
 		HELIUM_OIS_API void Cleanup();
 
+		// Scripted input replaces the keyboard and mouse devices with input read from a file, so that runs (like
+		// benchmarks) are repeatable and need no window. Each line of the script is one of:
+		//   <frame> key <scan code> <0|1>
+		//   <frame> button <mouse button mask>
+		//   <frame> mouse <x> <y>
+		// where frame counts calls to Capture() from zero. Lines starting with '#' are ignored. A null or empty path
+		// starts scripted input with no events at all.
+		HELIUM_OIS_API bool BeginScriptedInput(const char *pScriptPath);
+		HELIUM_OIS_API void EndScriptedInput();
+		HELIUM_OIS_API bool IsScriptedInputActive();
+
 		HELIUM_OIS_API void SetWindowSize(int x, int y);
 
 		HELIUM_OIS_API void Capture();
 
+		namespace EventTypes
+		{
+			enum EventType
+			{
+				Key,              // m_Code is the key code and m_bDown its new state
+				MouseButtons,     // m_Code is the new mouse button mask
+				MouseMove         // m_X/m_Y are the new position and m_DeltaX/m_DeltaY the motion since the last event
+			};
+		}
+		typedef EventTypes::EventType EventType;
+
+		//! Change in device state seen by the capture thread
+		struct Event
+		{
+			uint64_t  m_TickCount;     // Timer::GetTickCount() when the change was sampled
+			EventType m_Type;
+			int32_t   m_Code;
+			bool      m_bDown;
+			int32_t   m_X;
+			int32_t   m_Y;
+			int32_t   m_DeltaX;
+			int32_t   m_DeltaY;
+		};
+
+		// The capture thread polls the devices at a fixed rate, independent of the frame rate, and queues a timestamped
+		// event for every change it sees. Capture() then applies everything queued since the previous frame, so the
+		// state queries below work as before, and GetFrameEvents() returns the time-ordered changes within the frame.
+		// While the thread runs it is the only one touching the devices. Without it, Capture() polls the devices itself
+		// and records no events. Scripted input takes precedence over both
+		const uint32_t DEFAULT_CAPTURE_FREQUENCY = 1000;
+
+		HELIUM_OIS_API bool StartCaptureThread(uint32_t frequency = DEFAULT_CAPTURE_FREQUENCY);
+		HELIUM_OIS_API void StopCaptureThread();
+		HELIUM_OIS_API bool IsCaptureThreadRunning();
+		HELIUM_OIS_API const Event* GetFrameEvents(size_t &rCount);
+
 		HELIUM_OIS_API bool IsKeyDown(Input::KeyCode keyCode);
 		HELIUM_OIS_API bool WasKeyPressedThisFrame(Input::KeyCode keyCode);
 		HELIUM_OIS_API bool IsModifierDown(Input::KeyboardModifier keyCode);
@@ -213,6 +260,15 @@ namespace Helium
 		HELIUM_OIS_API bool IsMouseButtonDown(MouseButton button);
 		HELIUM_OIS_API bool WasMouseButtonPressedThisFrame(MouseButton button);
 
+		// True if the key or button was down at any point since the previous Capture(), so that taps shorter than a
+		// frame are not lost. Same as IsKeyDown()/IsMouseButtonDown() without the capture thread
+		HELIUM_OIS_API bool WasKeyDownThisFrame(Input::KeyCode keyCode);
+		HELIUM_OIS_API bool WasMouseButtonDownThisFrame(MouseButton button);
+
+		// Fraction of the time between the last two Capture() calls the key spent down, from the event timestamps.
+		// Without the capture thread this is 1 or 0, from IsKeyDown()
+		HELIUM_OIS_API float32_t GetKeyHeldFractionThisFrame(Input::KeyCode keyCode);
+
 		HELIUM_OIS_API Point GetMousePos();
 		HELIUM_OIS_API Simd::Vector2 GetMousePosNormalized();
 		HELIUM_OIS_API Simd::Vector2 GetMousePosDelta();
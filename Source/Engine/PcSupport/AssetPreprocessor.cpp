@@ -2,15 +2,20 @@
 #include "AssetPreprocessor.h"
 
 #include "Platform/File.h"
+#include "Platform/Timer.h"
+#include "Foundation/DirectoryIterator.h"
 #include "Foundation/FilePath.h"
 #include "Foundation/FileStream.h"
 #include "Foundation/MemoryStream.h"
 #include "Foundation/Numeric.h"
 #include "Engine/FileLocations.h"
+#include "Engine/CacheAccessTrace.h"
 #include "Engine/CacheManager.h"
 #include "Engine/AssetLoader.h"
 #include "Engine/Resource.h"
 #include "Engine/Config.h"
+#include "Engine/PackageArchive.h"
+#include "PcSupport/LoosePackageLoader.h"
 #include "PcSupport/PlatformPreprocessor.h"
 #include "PcSupport/ResourceHandler.h"
 #include "Engine/PackageLoader.h"
@@ -24,6 +29,12 @@ AssetPreprocessor* AssetPreprocessor::sm_pInstance = NULL;
 AssetPreprocessor::AssetPreprocessor()
 {
 	MemoryZero( m_pPlatformPreprocessors, sizeof( m_pPlatformPreprocessors ) );
+
+#if HELIUM_TOOLS
+	m_bCookBatchActive = false;
+	m_bCookDatabaseLoaded = false;
+	m_pCookRecords = NULL;
+#endif
 }
 
 /// Destructor.
@@ -53,6 +64,9 @@ void AssetPreprocessor::SetPlatformPreprocessor( Cache::EPlatform platform, Plat
 
 /// Cache an object for all registered platforms.
 ///
+/// While a cook batch is active, the object is only queued, and is cached along with the rest of the batch when
+/// EndCookBatch() is called.
+///
 /// @param[in] pObject                                 Asset to cache.
 /// @param[in] timestamp                               Asset timestamp.
 /// @param[in] bEvictPlatformPreprocessedResourceData  If the object being cached is a Resource-based object,
@@ -63,7 +77,7 @@ void AssetPreprocessor::SetPlatformPreprocessor( Cache::EPlatform platform, Plat
 ///                                                    resource itself, but certain resource preprocessors may want
 ///                                                    to keep this data intact.
 ///
-/// @return  True if object caching was successful, false if not.
+/// @return  True if object caching was successful (or the object was queued for caching), false if not.
 bool AssetPreprocessor::CacheObject(
 	const AssetPath &objectPath,
 	Asset* pObject,
@@ -74,225 +88,398 @@ bool AssetPreprocessor::CacheObject(
 
 	HELIUM_ASSERT( pObject );
 
-	bool bCacheFailure = false;
+	if( m_bCookBatchActive )
+	{
+		HashMap< AssetPath, size_t >::Iterator indexIterator = m_cookObjectIndices.Find( objectPath );
+		if( indexIterator == m_cookObjectIndices.End() )
+		{
+			m_cookObjectIndices.Insert(
+				indexIterator,
+				HashMap< AssetPath, size_t >::ValueType( objectPath, m_cookObjects.GetSize() ) );
+			m_cookObjects.New();
+		}
 
-	DynamicArray< uint8_t > objectStreamBuffer;
+		CookObject& rCookObject = m_cookObjects[ indexIterator->Second() ];
+		rCookObject.path = objectPath;
+		rCookObject.spObject = pObject;
+		rCookObject.timestamp = timestamp;
+		rCookObject.bEvictPlatformPreprocessedResourceData = bEvictPlatformPreprocessedResourceData;
 
-	Helium::DynamicMemoryStream directStream;
-	Helium::ByteSwappingStream byteSwappingStream( &directStream );
+		return true;
+	}
 
-	// Only worry about resource data caching if the object is a Resource type that's not the default template
-	// object for its specific type.
-	Resource* pResource = ( !pObject->IsDefaultTemplate() ? Reflect::SafeCast< Resource >( pObject ) : NULL );
+	DynamicArray< PendingCacheEntry > entries;
+	uint32_t recachedPlatformMask = BuildCacheEntries( objectPath, pObject, timestamp, entries );
 
-	CacheManager* pCacheManager = CacheManager::GetInstance();
-	HELIUM_ASSERT( pCacheManager );
+	bool bCacheResult = CommitCacheEntries( entries );
+	if( !bCacheResult )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"AssetPreprocessor: Failed to cache object \"%s\".\n",
+			*objectPath.ToString() );
+	}
 
-	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
-	HELIUM_ASSERT( pAssetLoader );
+	FinishCachedObject( pObject, recachedPlatformMask, bEvictPlatformPreprocessedResourceData );
 
-	// Non-user configuration objects should have special caching logic
-	Name objectCacheName( NULL_NAME );
+	return bCacheResult;
 
-	Config* pConfig = Config::GetInstance();
-	HELIUM_ASSERT( pConfig );
+#else  // HELIUM_TOOLS
 
-	// TODO: We should only cache the platform-required configs
-	if( pConfig->IsAssetPathInConfigContainerPackage( objectPath ) )
-	{
-		objectCacheName = Name( HELIUM_CONFIG_CACHE_NAME );
-	}
-	
-	if (objectCacheName.IsEmpty())
+	HELIUM_UNREF( pObject );
+	HELIUM_UNREF( timestamp );
+	HELIUM_UNREF( bEvictPlatformPreprocessedResourceData );
+
+	return false;
+
+#endif  // HELIUM_TOOLS
+}
+
+/// Write the prefetch manifests of all packages with assets cached since the manifests were last written.
+///
+/// Each manifest starts from the one already cached for the current platform, so that assets that were not recached
+/// keep their records, and is written to the asset cache of every platform with a preprocessor.  This is also done
+/// when the preprocessor is shut down.
+void AssetPreprocessor::FlushPrefetchManifests()
+{
+#if HELIUM_TOOLS
+
+	if( m_packageDependencies.IsEmpty() )
 	{
-		objectCacheName = Name( HELIUM_ASSET_CACHE_NAME );
+		return;
 	}
 
-	bool bUpdatedAnyCache = false;
+	CacheManager* pCacheManager = CacheManager::GetInstance();
+	HELIUM_ASSERT( pCacheManager );
 
-	for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+	Name assetCacheName( HELIUM_ASSET_CACHE_NAME );
+	Cache::EPlatform currentPlatform = pCacheManager->GetCurrentPlatform();
+
+	DynamicArray< uint8_t > manifestBuffer;
+	Helium::DynamicMemoryStream directStream;
+	Helium::ByteSwappingStream byteSwappingStream( &directStream );
+
+	size_t packageCount = m_packageDependencies.GetSize();
+	for( size_t packageIndex = 0; packageIndex < packageCount; ++packageIndex )
 	{
-		// Don't cache on platforms for which we don't have a preprocessor.
-		PlatformPreprocessor* pPreprocessor = m_pPlatformPreprocessors[ platformIndex ];
-		if( !pPreprocessor )
+		const PackageDependencies& rPackageDependencies = m_packageDependencies[ packageIndex ];
+		AssetPath packagePath = rPackageDependencies.packagePath;
+
+		PrefetchManifest manifest;
+		if( m_pPlatformPreprocessors[ currentPlatform ] )
 		{
-			continue;
+			Cache* pCurrentCache = pCacheManager->GetCache( assetCacheName, currentPlatform );
+			HELIUM_ASSERT( pCurrentCache );
+			pCurrentCache->EnforceTocLoad();
+
+			LoadPrefetchManifest( pCurrentCache, packagePath, manifest );
 		}
 
-		// Retrieve the cache for the current platform.
-		Cache* pCache = pCacheManager->GetCache( objectCacheName, static_cast< Cache::EPlatform >( platformIndex ) );
-		HELIUM_ASSERT( pCache );
-		pCache->EnforceTocLoad();
+		const PrefetchManifest& rUpdates = rPackageDependencies.manifest;
+		size_t recordCount = rUpdates.GetRecordCount();
+		for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+		{
+			const PrefetchManifest::Record& rRecord = rUpdates.GetRecord( recordIndex );
+			manifest.SetDependencies( rRecord.path, rRecord.dependencies );
+		}
 
-		// Don't recache the object if an up-to-date cache entry already exists for it.
-		const Cache::Entry* pEntry = pCache->FindEntry( objectPath, 0 );
-		if( pEntry && pEntry->timestamp == timestamp )
+		manifest.Sort();
+
+		for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
 		{
-			continue;
+			PlatformPreprocessor* pPreprocessor = m_pPlatformPreprocessors[ platformIndex ];
+			if( !pPreprocessor )
+			{
+				continue;
+			}
+
+			Cache* pCache = pCacheManager->GetCache( assetCacheName, static_cast< Cache::EPlatform >( platformIndex ) );
+			HELIUM_ASSERT( pCache );
+			pCache->EnforceTocLoad();
+
+			manifestBuffer.Resize( 0 );
+			directStream.Open( &manifestBuffer );
+
+			Stream& rManifestStream = ( pPreprocessor->SwapBytes()
+				? static_cast< Stream& >( byteSwappingStream )
+				: static_cast< Stream& >( directStream ) );
+			manifest.Write( rManifestStream );
+
+			directStream.Close();
+
+			HELIUM_ASSERT( manifestBuffer.GetSize() <= UINT32_MAX );
+			bool bCacheResult = pCache->CacheEntry(
+				packagePath,
+				Cache::PREFETCH_MANIFEST_SUB_DATA_INDEX,
+				manifestBuffer.GetData(),
+				0,
+				static_cast< uint32_t >( manifestBuffer.GetSize() ) );
+			if( !bCacheResult )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					"AssetPreprocessor: Failed to cache the prefetch manifest of package \"%s\".\n",
+					*packagePath.ToString() );
+			}
 		}
+	}
 
-		HELIUM_TRACE(
-			TraceLevels::Info,
-			"AssetPreprocessor: Object \"%s\" is out of date.  Recaching...\n",
-			*objectPath.ToString() );
+	m_packageDependencies.Clear();
 
-		bUpdatedAnyCache = true;
+#endif  // HELIUM_TOOLS
+}
 
-		// Prepare for writing out the property and persistent resource data for the current platform.
-		objectStreamBuffer.Resize( 0 );
-		directStream.Open( &objectStreamBuffer );
+/// Lay out the caches read by a set of scenes in the order in which the scenes read them.
+///
+/// The recorded cache access traces of the scenes (see WorldManager::SetCacheAccessTraceRecordingEnabled()) are
+/// appended in the order given, and every cache they read is compacted in that order (see Cache::Compact()) for each
+/// platform with a preprocessor.  Entries that no scene reads are kept after the traced entries.  This is meant to be
+/// run when packaging, once everything has been cached.
+///
+/// @param[in] pScenePaths  Paths of the scenes to lay out the caches for, in the order in which they are loaded.
+/// @param[in] sceneCount   Number of scenes.
+///
+/// @return  True if every cache read by the scenes was laid out successfully, false if any failed.
+bool AssetPreprocessor::LayoutCachesForScenes( const AssetPath* pScenePaths, size_t sceneCount )
+{
+#if HELIUM_TOOLS
 
-		bool bSwapBytes = pPreprocessor->SwapBytes();
-		Stream& rObjectStream =
-			( bSwapBytes ? static_cast< Stream& >( byteSwappingStream ) : static_cast< Stream& >( directStream ) );
-		
-		DynamicArray<uint8_t> data_buffer;
-		Cache::WriteCacheObjectToBuffer( pObject, data_buffer);
+	HELIUM_ASSERT( pScenePaths || sceneCount == 0 );
 
-		if (!data_buffer.IsEmpty())
+	FlushPrefetchManifests();
+
+	CacheAccessTrace trace;
+	CacheAccessTrace sceneTrace;
+	for( size_t sceneIndex = 0; sceneIndex < sceneCount; ++sceneIndex )
+	{
+		FilePath tracePath;
+		if( !CacheAccessTrace::GetTraceFilePath( pScenePaths[ sceneIndex ], tracePath ) ||
+			!sceneTrace.LoadFromFile( tracePath ) )
 		{
-			HELIUM_ASSERT(data_buffer.GetSize() <= Helium::NumericLimits<uint32_t>::Maximum);
-			uint32_t data_size = static_cast<uint32_t>(data_buffer.GetSize()) + 1; // Add one for null terminator
-			rObjectStream.Write(&data_size, sizeof(data_size), 1);
-			rObjectStream.Write(&data_buffer[0], sizeof(data_buffer[0]), data_size - 1); // Copy the data (it is not null terminated).
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"AssetPreprocessor: No cache access trace has been recorded for scene \"%s\".\n",
+				*pScenePaths[ sceneIndex ].ToString() );
 
-			char nullTerminator = 0;
-			rObjectStream.Write(&nullTerminator, sizeof(nullTerminator), 1); // Add the null terminator
+			continue;
 		}
-		else
+
+		trace.Append( sceneTrace );
+	}
+
+	DynamicArray< Name > cacheNames;
+	size_t recordCount = trace.GetRecordCount();
+	for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		Name cacheName = trace.GetRecord( recordIndex ).cacheName;
+
+		size_t cacheNameCount = cacheNames.GetSize();
+		size_t cacheNameIndex;
+		for( cacheNameIndex = 0; cacheNameIndex < cacheNameCount; ++cacheNameIndex )
 		{
-			uint32_t data_size = 0;
-			rObjectStream.Write(&data_size, sizeof(data_size), 1);
+			if( cacheNames[ cacheNameIndex ] == cacheName )
+			{
+				break;
+			}
 		}
-		
-		// Serialize persistent resource data and the number of chunks of sub-data.
-		if( pResource )
+
+		if( cacheNameIndex == cacheNameCount )
 		{
-			const Resource::PreprocessedData& rResourceData = pResource->GetPreprocessedData(
+			cacheNames.Push( cacheName );
+		}
+	}
+
+	CacheManager* pCacheManager = CacheManager::GetInstance();
+	HELIUM_ASSERT( pCacheManager );
+
+	bool bSuccess = true;
+
+	for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+	{
+		if( !m_pPlatformPreprocessors[ platformIndex ] )
+		{
+			continue;
+		}
+
+		size_t cacheNameCount = cacheNames.GetSize();
+		for( size_t cacheNameIndex = 0; cacheNameIndex < cacheNameCount; ++cacheNameIndex )
+		{
+			Cache* pCache = pCacheManager->GetCache(
+				cacheNames[ cacheNameIndex ],
 				static_cast< Cache::EPlatform >( platformIndex ) );
-			if( !rResourceData.bLoaded )
+			if( !pCache )
 			{
-				HELIUM_TRACE(
-					TraceLevels::Warning,
-					"AssetPreprocessor::CacheObject(): Cannot cache resource data for \"%s\" for platform index %" PRIuSZ " as the resource data is not in memory.  Make sure AssetPreprocessor::LoadResourceData() has been called on the object prior to caching.\n",
-					*objectPath.ToString(),
-					platformIndex );
+				bSuccess = false;
+
+				continue;
 			}
-			else
-			{
-				rObjectStream.Write(
-					rResourceData.persistentDataBuffer.GetData(),
-					1,
-					rResourceData.persistentDataBuffer.GetSize() );
 
-				// If we write anything, add a null terminator
-				if (rResourceData.persistentDataBuffer.GetSize() > 0)
-				{
-					char nullTerminator = 0;
-					rObjectStream.Write(&nullTerminator, sizeof(nullTerminator), 1); // Add the null terminator
-				}
+			pCache->EnforceTocLoad();
 
-				size_t subDataCountActual = rResourceData.subDataBuffers.GetSize();
-				HELIUM_ASSERT( subDataCountActual <= UINT32_MAX );
+			if( !pCache->Compact( trace ) )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					"AssetPreprocessor: Failed to lay out cache \"%s\" in scene access order.\n",
+					*pCache->GetCacheFileName() );
 
-				uint32_t subDataCount = static_cast< uint32_t >( subDataCountActual );
-				rObjectStream.Write( &subDataCount, sizeof( subDataCount ), 1 );
+				bSuccess = false;
 			}
 		}
+	}
 
-		directStream.Close();
+	return bSuccess;
+
+#else  // HELIUM_TOOLS
+
+	HELIUM_UNREF( pScenePaths );
+	HELIUM_UNREF( sceneCount );
+
+	return false;
+
+#endif  // HELIUM_TOOLS
+}
+
+/// Pack the object files of loose packages into packed archives (see PackageArchive).
+///
+/// Each package's archive holds the object files directly in its directory.  Child packages are not included, and need
+/// to be packed separately.
+///
+/// @param[in] pPackagePaths  Paths of the packages to pack.
+/// @param[in] packageCount   Number of packages to pack.
+/// @param[in] codec          Codec with which to compress the object data.
+///
+/// @return  True if all archives were written successfully, false if not.
+bool AssetPreprocessor::PackLoosePackages( const AssetPath* pPackagePaths, size_t packageCount, CompressionCodec codec )
+{
+#if HELIUM_TOOLS
 
-		// Cache the object data stream.
-		size_t objectDataSize = objectStreamBuffer.GetSize();
-		HELIUM_ASSERT( objectDataSize <= UINT32_MAX );
+	HELIUM_ASSERT( pPackagePaths || packageCount == 0 );
+
+	FilePath dataDirectory;
+	if( !FileLocations::GetDataDirectory( dataDirectory ) )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "AssetPreprocessor::PackLoosePackages(): Could not obtain data directory.\n" );
+
+		return false;
+	}
+
+	bool bSuccess = true;
+
+	DynamicArray< DynamicArray< char > > fileContents;
+	DynamicArray< PackageArchive::ObjectSource > objects;
+	for( size_t packageIndex = 0; packageIndex < packageCount; ++packageIndex )
+	{
+		const AssetPath& rPackagePath = pPackagePaths[ packageIndex ];
+		HELIUM_ASSERT( rPackagePath.IsPackage() );
 
-		bool bCacheResult = pCache->CacheEntry(
-			objectPath,
-			0,
-			objectStreamBuffer.GetData(),
-			timestamp,
-			static_cast< uint32_t >( objectDataSize ) );
-		if( !bCacheResult )
+		FilePath packageDirectory( dataDirectory + rPackagePath.ToFilePathString().GetData() + "/" );
+		if( !packageDirectory.IsDirectory() )
 		{
 			HELIUM_TRACE(
 				TraceLevels::Error,
-				"AssetPreprocessor: Failed to cache object \"%s\".\n",
-				*objectPath.ToString() );
+				"AssetPreprocessor::PackLoosePackages(): Package directory \"%s\" does not exist.\n",
+				packageDirectory.Data() );
 
-			bCacheFailure = true;
+			bSuccess = false;
+
+			continue;
 		}
 
-		// Finish resource data caching.
-		if( pResource )
+		fileContents.Resize( 0 );
+		objects.Resize( 0 );
+
+		bool bPackageSuccess = true;
+		for( DirectoryIterator fileIterator( packageDirectory ); !fileIterator.IsDone(); fileIterator.Next() )
 		{
-			Resource::PreprocessedData& rResourceData = pResource->GetPreprocessedData(
-				static_cast< Cache::EPlatform >( platformIndex ) );
-			if( rResourceData.bLoaded )
+			const DirectoryIteratorItem& rItem = fileIterator.GetItem();
+			if( !rItem.m_Path.IsFile() || rItem.m_Path.Extension() != "json" )
 			{
-				const DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rResourceData.subDataBuffers;
-				size_t subDataBufferCount = rSubDataBuffers.GetSize();
-				if( subDataBufferCount != 0 )
-				{
-					// Cache resource sub-data.
-					Name resourceCacheName = pResource->GetCacheName();
-					HELIUM_ASSERT( !resourceCacheName.IsEmpty() );
-
-					Cache* pResourceCache = pCacheManager->GetCache(
-						resourceCacheName,
-						static_cast< Cache::EPlatform >( platformIndex ) );
-					HELIUM_ASSERT( pResourceCache );
-					pResourceCache->EnforceTocLoad();
-
-					for( size_t subDataBufferIndex = 0;
-						subDataBufferIndex < subDataBufferCount;
-						++subDataBufferIndex )
-					{
-						const DynamicArray< uint8_t >& rSubData = rSubDataBuffers[ subDataBufferIndex ];
-
-						bCacheResult = pResourceCache->CacheEntry(
-							objectPath,
-							static_cast< uint32_t >( subDataBufferIndex ),
-							rSubData.GetData(),
-							timestamp,
-							static_cast< uint32_t >( rSubData.GetSize() ) );
-						if( !bCacheResult )
-						{
-							HELIUM_TRACE(
-								TraceLevels::Error,
-								"AssetPreprocessor: Failed to cache resource sub-data %" PRIuSZ " for resource \"%s\".\n",
-								subDataBufferIndex,
-								*objectPath.ToString() );
-
-							bCacheFailure = true;
-						}
-					}
-				}
+				continue;
+			}
 
-				// Since all resource data has now been recached for the current platform, we can evict the current
-				// platform data from memory.
-				if( bEvictPlatformPreprocessedResourceData )
+			// Read the file null-terminated, for parsing its preliminary data.
+			DynamicArray< char >* pContents = fileContents.New();
+			HELIUM_ASSERT( pContents );
+
+			FileStream* pFileStream = FileStream::OpenFileStream( rItem.m_Path.Data(), FileStream::MODE_READ );
+			int64_t size64 = ( pFileStream ? pFileStream->GetSize() : -1 );
+			if( size64 >= 0 && static_cast< uint64_t >( size64 ) < static_cast< size_t >( -1 ) )
+			{
+				pContents->Resize( static_cast< size_t >( size64 ) + 1 );
+				if( pFileStream->Read( pContents->GetData(), 1, static_cast< size_t >( size64 ) ) !=
+					static_cast< size_t >( size64 ) )
 				{
-					rResourceData.persistentDataBuffer.Clear();
-					rResourceData.subDataBuffers.Clear();
-					rResourceData.bLoaded = false;
+					pContents->Resize( 0 );
 				}
 			}
+
+			delete pFileStream;
+
+			Name objectName( rItem.m_Path.Basename().c_str() );
+			Name typeName( NULL_NAME );
+			String templatePath;
+			if( pContents->IsEmpty() )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					"AssetPreprocessor::PackLoosePackages(): Failed to read object file \"%s\".\n",
+					rItem.m_Path.Data() );
+
+				bPackageSuccess = false;
+
+				break;
+			}
+
+			pContents->GetLast() = '\0';
+			if( !LoosePackageLoader::ReadPreliminaryData(
+				pContents->GetData(), objectName, rItem.m_Path.Data(), typeName, templatePath ) )
+			{
+				bPackageSuccess = false;
+
+				break;
+			}
+
+			PackageArchive::ObjectSource* pObject = objects.New();
+			HELIUM_ASSERT( pObject );
+			pObject->name = objectName;
+			pObject->typeName = typeName;
+			pObject->templatePath = templatePath;
+			pObject->size = pContents->GetSize() - 1;
 		}
-	}
 
-	// Notify the object that it has been cached.
-	if( bUpdatedAnyCache )
-	{
-		pObject->PostSave();
+		if( bPackageSuccess )
+		{
+			// Object data pointers are only set once all files are read, as reading grows the file contents array.
+			HELIUM_ASSERT( objects.GetSize() == fileContents.GetSize() );
+			for( size_t objectIndex = 0; objectIndex < objects.GetSize(); ++objectIndex )
+			{
+				objects[ objectIndex ].pData = fileContents[ objectIndex ].GetData();
+			}
+
+			FilePath archiveFilePath;
+			bPackageSuccess = PackageArchive::GetArchiveFilePath( rPackagePath, archiveFilePath ) &&
+				PackageArchive::Write( archiveFilePath, objects.GetData(), objects.GetSize(), codec );
+		}
+
+		if( !bPackageSuccess )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"AssetPreprocessor: Failed to pack package \"%s\".\n",
+				*rPackagePath.ToString() );
+
+			bSuccess = false;
+		}
 	}
 
-	return !bCacheFailure;
+	return bSuccess;
 
 #else  // HELIUM_TOOLS
 
-	HELIUM_UNREF( pObject );
-	HELIUM_UNREF( timestamp );
-	HELIUM_UNREF( bEvictPlatformPreprocessedResourceData );
+	HELIUM_UNREF( pPackagePaths );
+	HELIUM_UNREF( packageCount );
+	HELIUM_UNREF( codec );
 
 	return false;
 
@@ -301,6 +488,9 @@ bool AssetPreprocessor::CacheObject(
 
 /// Load data for the specified resource into memory, preprocessing it from source data if it is out-of-date.
 ///
+/// While a cook batch is active, resources that need preprocessing are only queued, and are preprocessed along with
+/// the rest of the batch when EndCookBatch() is called.
+///
 /// @param[in] pResource        Resource to load.
 /// @param[in] objectTimestamp  Timestamp of the object data stored on disk.  This will be combined with the source
 ///                             asset timestamp to get the timestamp value with which to compare against the cached
@@ -311,43 +501,411 @@ void AssetPreprocessor::LoadResourceData( const AssetPath &resourcePath, Resourc
 
 	HELIUM_ASSERT( pResource );
 
-	// Locate the source asset file of the source template resource and combine its timestamp with the object timestamp.
-	// This will be the asset that extends the default asset (i.e. test.png, which would have Helium::Texture2D as template)
-	Resource* pSourceResource = pResource;
-	Asset* pTestTemplate = Reflect::AssertCast< Asset >( pResource->GetTemplate() );
-	while( pTestTemplate && !pTestTemplate->IsDefaultTemplate() )
+	String sourceFilePath;
+	if( !NeedsPreprocessing( resourcePath, pResource, sourceFilePath ) )
 	{
-		pSourceResource = Reflect::AssertCast< Resource >( pTestTemplate );
-		pTestTemplate = Reflect::AssertCast< Asset >( pSourceResource->GetTemplate() );
+		return;
 	}
 
-	AssetPath parentPath = pSourceResource == pResource ? resourcePath : pSourceResource->GetPath();
-	AssetPath baseResourcePath;
-	do
+	if( m_bCookBatchActive )
 	{
-		baseResourcePath = parentPath;
-		parentPath = parentPath.GetParent();
-	} while( !parentPath.IsEmpty() && !parentPath.IsPackage() );
+		HashMap< AssetPath, size_t >::Iterator indexIterator = m_cookResourceIndices.Find( resourcePath );
+		if( indexIterator == m_cookResourceIndices.End() )
+		{
+			m_cookResourceIndices.Insert(
+				indexIterator,
+				HashMap< AssetPath, size_t >::ValueType( resourcePath, m_cookResources.GetSize() ) );
+
+			CookResource* pCookResource = m_cookResources.New();
+			HELIUM_ASSERT( pCookResource );
+			pCookResource->path = resourcePath;
+			pCookResource->spResource = pResource;
+			pCookResource->sourceFilePath = sourceFilePath;
+			pCookResource->pHandler = NULL;
+			pCookResource->sharedKey = 0;
+			pCookResource->bSharedKey = false;
+			pCookResource->bFetched = false;
+			pCookResource->bSuccess = false;
+			pCookResource->preprocessTicks = 0;
+		}
 
-	FilePath sourceFilePath;
-	if ( !FileLocations::GetDataDirectory( sourceFilePath ) )
+		return;
+	}
+
+	// Preprocess all resources for each supported platform.
+	if( !PreprocessResource( resourcePath, pResource, sourceFilePath ) )
 	{
 		HELIUM_TRACE(
 			TraceLevels::Error,
-			"AssetPreprocessor::LoadResourceData(): Could not retrieve data directory.\n" );
+			"AssetPreprocessor::LoadResourceData(): Preprocessing of resource \"%s\" failed.\n",
+			*resourcePath.ToString() );
+	}
 
-		return;
+#else  // HELIUM_TOOLS
+
+	HELIUM_UNREF( pResource );
+
+#endif  // HELIUM_TOOLS
+}
+
+/// Record a file read while preprocessing a resource, besides its own source and object files.
+///
+/// Resource handlers call this for every additional file their output depends on (such as shader include files), so
+/// that the resource is preprocessed again once any of them changes.  This may be called from any thread.
+///
+/// @param[in] pResource  Resource being preprocessed.
+/// @param[in] rFilePath  Path of the file read.
+void AssetPreprocessor::AddCookDependency( Resource* pResource, const FilePath& rFilePath )
+{
+#if HELIUM_TOOLS
+
+	HELIUM_ASSERT( pResource );
+
+	String filePath( rFilePath.Data() );
+
+	MutexScopeLock scopeLock( m_cookDatabaseLock );
+
+	HashMap< AssetPath, DynamicArray< String > >::Iterator dependencyIterator =
+		m_cookDependencies.Find( pResource->GetPath() );
+	if( dependencyIterator == m_cookDependencies.End() )
+	{
+		m_cookDependencies.Insert(
+			dependencyIterator,
+			HashMap< AssetPath, DynamicArray< String > >::ValueType( pResource->GetPath(), DynamicArray< String >() ) );
+	}
+
+	DynamicArray< String >& rDependencyFiles = dependencyIterator->Second();
+	size_t dependencyCount = rDependencyFiles.GetSize();
+	for( size_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+	{
+		if( rDependencyFiles[ dependencyIndex ] == filePath )
+		{
+			return;
+		}
+	}
+
+	rDependencyFiles.Push( filePath );
+
+#else  // HELIUM_TOOLS
+
+	HELIUM_UNREF( pResource );
+	HELIUM_UNREF( rFilePath );
+
+#endif  // HELIUM_TOOLS
+}
+
+/// Set the directory in which preprocessed resource data is shared with other machines.
+///
+/// Resources are keyed by the content hash of their inputs.  Before a resource is preprocessed, its data is fetched
+/// from this directory if another machine has already preprocessed the same inputs, and the data of every resource
+/// preprocessed locally is stored in it afterwards.  Entries used are also kept in a local directory, trimmed to
+/// the size set with SetSharedCookCacheLocalSizeMax().  This should only be changed while no cook batch is active.
+///
+/// @param[in] rDirectory  Shared directory (such as a network share), or an empty path to disable sharing.
+///
+/// @see SetSharedCookCacheLocalSizeMax()
+void AssetPreprocessor::SetSharedCookCacheDirectory( const FilePath& rDirectory )
+{
+#if HELIUM_TOOLS
+	HELIUM_ASSERT( !m_bCookBatchActive );
+
+	m_sharedCookCache.SetRemoteDirectory( rDirectory );
+#else
+	HELIUM_UNREF( rDirectory );
+#endif
+}
+
+/// Set the maximum size of the shared cook cache entries kept in the local directory.
+///
+/// @param[in] sizeMax  Maximum local size, in bytes.
+///
+/// @see SetSharedCookCacheDirectory()
+void AssetPreprocessor::SetSharedCookCacheLocalSizeMax( uint64_t sizeMax )
+{
+#if HELIUM_TOOLS
+	m_sharedCookCache.SetLocalSizeMax( sizeMax );
+#else
+	HELIUM_UNREF( sizeMax );
+#endif
+}
+
+/// Begin a cook batch.
+///
+/// Until EndCookBatch() is called, resources that need preprocessing and assets to cache are queued instead of being
+/// processed as they are loaded.  Their preprocessed resource data is kept in memory until the batch ends, so large
+/// cooks should be split into several batches (such as one per package).
+///
+/// @see EndCookBatch(), IsCookBatchActive()
+void AssetPreprocessor::BeginCookBatch()
+{
+#if HELIUM_TOOLS
+	HELIUM_ASSERT( !m_bCookBatchActive );
+
+	m_bCookBatchActive = true;
+#endif
+}
+
+/// End the active cook batch, preprocessing every queued resource and caching every queued asset.
+///
+/// If a shared cook cache directory is set, the data of every queued resource is first fetched from it in parallel,
+/// and only the resources not found are preprocessed.  Resources whose handlers can cache concurrently are preprocessed first, through AssetLoader::RunParallel().  The
+/// remaining resources are then preprocessed one at a time on the calling thread, since their handlers may load (and
+/// so depend on) other resources.  Assets loaded during this are processed immediately rather than queued.  Finally,
+/// the cache entries of all queued assets are written with a single update of each cache.
+/// The data of the resources preprocessed is then stored in the shared cook cache, again in parallel.
+///
+/// This must be called from the thread ticking the AssetLoader.
+///
+/// @return  True if every resource was preprocessed and every asset was cached successfully, false if not.
+///
+/// @see BeginCookBatch(), IsCookBatchActive()
+bool AssetPreprocessor::EndCookBatch()
+{
+#if HELIUM_TOOLS
+
+	HELIUM_ASSERT( m_bCookBatchActive );
+
+	m_bCookBatchActive = false;
+
+	bool bSuccess = true;
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+
+	CookResourceContext context;
+	context.pPreprocessor = this;
+
+	size_t resourceCount = m_cookResources.GetSize();
+
+	// Fetch the data of resources already preprocessed by other machines.
+	if( m_sharedCookCache.IsEnabled() && resourceCount != 0 )
+	{
+		DynamicArray< CookResource* > sharedResources;
+		sharedResources.Reserve( resourceCount );
+		for( size_t resourceIndex = 0; resourceIndex < resourceCount; ++resourceIndex )
+		{
+			sharedResources.Push( &m_cookResources[ resourceIndex ] );
+		}
+
+		context.ppResources = sharedResources.GetData();
+		pAssetLoader->RunParallel( FetchSharedResourceCallback, &context, resourceCount );
+	}
+
+	DynamicArray< CookResource* > concurrentResources;
+	DynamicArray< CookResource* > serialResources;
+	size_t fetchedResourceCount = 0;
+
+	for( size_t resourceIndex = 0; resourceIndex < resourceCount; ++resourceIndex )
+	{
+		CookResource& rCookResource = m_cookResources[ resourceIndex ];
+		if( rCookResource.bFetched )
+		{
+			++fetchedResourceCount;
+
+			continue;
+		}
+
+		Resource* pResource = Reflect::AssertCast< Resource >( rCookResource.spResource.Get() );
+
+		rCookResource.pHandler = BeginPreprocessResource( rCookResource.path, pResource );
+		if( !rCookResource.pHandler )
+		{
+			bSuccess = false;
+
+			continue;
+		}
+
+		if( rCookResource.pHandler->CanCacheConcurrently() )
+		{
+			concurrentResources.Push( &rCookResource );
+		}
+		else
+		{
+			serialResources.Push( &rCookResource );
+		}
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"AssetPreprocessor::EndCookBatch(): Preprocessing %" PRIuSZ " resources (%" PRIuSZ " concurrently, %" PRIuSZ " fetched from the shared cook cache) and caching %" PRIuSZ " assets.\n",
+		concurrentResources.GetSize() + serialResources.GetSize(),
+		concurrentResources.GetSize(),
+		fetchedResourceCount,
+		m_cookObjects.GetSize() );
+
+	context.ppResources = concurrentResources.GetData();
+	pAssetLoader->RunParallel( CookResourceCallback, &context, concurrentResources.GetSize() );
+
+	context.ppResources = serialResources.GetData();
+	size_t serialResourceCount = serialResources.GetSize();
+	for( size_t resourceIndex = 0; resourceIndex < serialResourceCount; ++resourceIndex )
+	{
+		CookResourceCallback( &context, resourceIndex );
+	}
+
+	DynamicArray< CookResource* > storeResources;
+
+	for( size_t resourceIndex = 0; resourceIndex < resourceCount; ++resourceIndex )
+	{
+		CookResource& rCookResource = m_cookResources[ resourceIndex ];
+		Resource* pResource = Reflect::AssertCast< Resource >( rCookResource.spResource.Get() );
+
+		if( m_pCookRecords )
+		{
+			CookRecord* pRecord = m_pCookRecords->New();
+			HELIUM_ASSERT( pRecord );
+			pRecord->path = rCookResource.path;
+			pRecord->milliseconds = Timer::TicksToMilliseconds( rCookResource.preprocessTicks );
+			pRecord->bFetched = rCookResource.bFetched;
+			pRecord->bSuccess = rCookResource.bFetched || ( rCookResource.pHandler && rCookResource.bSuccess );
+		}
+
+		if( rCookResource.bFetched )
+		{
+			FinishPreprocessResource( pResource );
+			RecordCookInputs( rCookResource.path, pResource, true );
+
+			continue;
+		}
+
+		if( !rCookResource.pHandler )
+		{
+			continue;
+		}
+
+		if( !rCookResource.bSuccess )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"AssetPreprocessor::EndCookBatch(): Preprocessing of resource \"%s\" failed.\n",
+				*rCookResource.path.ToString() );
+
+			RecordCookInputs( rCookResource.path, pResource, false );
+			bSuccess = false;
+
+			continue;
+		}
+
+		FinishPreprocessResource( pResource );
+		RecordCookInputs( rCookResource.path, pResource, true );
+
+		if( rCookResource.bSharedKey )
+		{
+			storeResources.Push( &rCookResource );
+		}
+	}
+
+	// Share the data of the resources preprocessed, before caching evicts any of it.
+	context.ppResources = storeResources.GetData();
+	pAssetLoader->RunParallel( StoreSharedResourceCallback, &context, storeResources.GetSize() );
+
+	// Cache all queued assets, writing each cache only once.
+	size_t objectCount = m_cookObjects.GetSize();
+
+	DynamicArray< PendingCacheEntry > entries;
+	DynamicArray< uint32_t > recachedPlatformMasks;
+	recachedPlatformMasks.Reserve( objectCount );
+
+	for( size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex )
+	{
+		const CookObject& rCookObject = m_cookObjects[ objectIndex ];
+		recachedPlatformMasks.Push(
+			BuildCacheEntries( rCookObject.path, rCookObject.spObject.Get(), rCookObject.timestamp, entries ) );
+	}
+
+	if( !CommitCacheEntries( entries ) )
+	{
+		bSuccess = false;
+	}
+
+	entries.Clear();
+
+	for( size_t objectIndex = 0; objectIndex < objectCount; ++objectIndex )
+	{
+		const CookObject& rCookObject = m_cookObjects[ objectIndex ];
+		FinishCachedObject(
+			rCookObject.spObject.Get(),
+			recachedPlatformMasks[ objectIndex ],
+			rCookObject.bEvictPlatformPreprocessedResourceData );
 	}
 
-	sourceFilePath += baseResourcePath.ToFilePathString().GetData();
+	m_cookResources.Clear();
+	m_cookObjects.Clear();
+	m_cookResourceIndices.Clear();
+	m_cookObjectIndices.Clear();
+
+	SaveCookDatabase();
+	m_sharedCookCache.Flush();
+
+	return bSuccess;
+
+#else  // HELIUM_TOOLS
+
+	return false;
+
+#endif  // HELIUM_TOOLS
+}
+
+/// Set the array to which to append a record of each resource handled by a cook batch.
+///
+/// Records are appended when each batch ends, with the time spent preprocessing each resource (for instance, to
+/// write a cook report).  This should only be changed while no cook batch is active.
+///
+/// @param[in] pRecords  Array to which to append records, or null to stop recording.
+///
+/// @see EndCookBatch()
+void AssetPreprocessor::SetCookRecords( DynamicArray< CookRecord >* pRecords )
+{
+#if HELIUM_TOOLS
+	HELIUM_ASSERT( !m_bCookBatchActive );
+
+	m_pCookRecords = pRecords;
+#else
+	HELIUM_UNREF( pRecords );
+#endif
+}
 
-	Helium::Status stat;
-	stat.Read( sourceFilePath.Data() );
 
-	int64_t sourceFileTimestamp = stat.m_ModifiedTime;
-	int64_t assetFileTimestamp = AssetLoader::GetAssetFileTimestamp( baseResourcePath );
+#if HELIUM_TOOLS
+
+/// Get whether a resource needs to be preprocessed, loading its data from the cache for every supported platform if
+/// the cached data is up to date.
+///
+/// Cached data is only up to date if the combined hash of the resource's inputs is the same as when it was last
+/// preprocessed, and the cache entries were written with that hash.
+///
+/// @param[in]  resourcePath     Resource path.
+/// @param[in]  pResource        Resource to check.
+/// @param[out] rSourceFilePath  Path of the source file from which to preprocess the resource, if it needs to be.
+///
+/// @return  True if the resource needs to be preprocessed, false if its data is loaded (or cannot be preprocessed).
+bool AssetPreprocessor::NeedsPreprocessing( const AssetPath &resourcePath, Resource* pResource, String& rSourceFilePath )
+{
+	HELIUM_ASSERT( pResource );
+
+	AssetPath baseResourcePath;
+	FilePath sourceFilePath;
+	if( !GetResourceSourcePaths( resourcePath, pResource, baseResourcePath, sourceFilePath ) )
+	{
+		return false;
+	}
 
-	int64_t timestamp = Max( assetFileTimestamp, sourceFileTimestamp );
+	bool bInputsUnchanged = false;
+	int64_t timestamp = 0;
+	{
+		MutexScopeLock scopeLock( m_cookDatabaseLock );
+		LoadCookDatabase();
+
+		const CookDatabase::Record* pRecord = m_cookDatabase.FindRecord( resourcePath );
+		uint64_t inputHash = 0;
+		if( pRecord &&
+			ComputeInputHash( resourcePath, pResource, pRecord->dependencyFiles, inputHash ) &&
+			inputHash == pRecord->inputHash )
+		{
+			bInputsUnchanged = true;
+			timestamp = static_cast< int64_t >( inputHash );
+		}
+	}
 
 	// Check if data is loaded for each supported platform, attempting to load the data from the cache if it exists
 	// and is up-to-date.
@@ -383,11 +941,11 @@ void AssetPreprocessor::LoadResourceData( const AssetPath &resourcePath, Resourc
 		pCache->EnforceTocLoad();
 
 		const Cache::Entry* pCacheEntry = pCache->FindEntry( resourcePath, 0 );
-		if( !pCacheEntry || pCacheEntry->timestamp != timestamp )
+		if( !bInputsUnchanged || !pCacheEntry || pCacheEntry->timestamp != timestamp )
 		{
 			HELIUM_TRACE(
 				TraceLevels::Info,
-				"AssetPreprocessor::LoadResourceData(): Cached resource data not found or is out-of-date for resource \"%s\".  Resource will be preprocessed.\n",
+				"AssetPreprocessor::NeedsPreprocessing(): Cached resource data not found or is out-of-date for resource \"%s\".  Resource will be preprocessed.\n",
 				*resourcePath.ToString() );
 
 			break;
@@ -398,7 +956,7 @@ void AssetPreprocessor::LoadResourceData( const AssetPath &resourcePath, Resourc
 		{
 			HELIUM_TRACE(
 				TraceLevels::Warning,
-				"AssetPreprocessor::LoadResourceData(): Failed to load cached resource data for \"%s\".  Resource will be preprocessed again.\n",
+				"AssetPreprocessor::NeedsPreprocessing(): Failed to load cached resource data for \"%s\".  Resource will be preprocessed again.\n",
 				*resourcePath.ToString() );
 
 			break;
@@ -408,90 +966,284 @@ void AssetPreprocessor::LoadResourceData( const AssetPath &resourcePath, Resourc
 	if( platformIndex >= HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ) )
 	{
 		// All supported platforms loaded successfully, so nothing else needs to be done.
-		return;
-	}
-
-	// Preprocess all resources for each supported platform.
-	if( !PreprocessResource( resourcePath, pResource, String( sourceFilePath.Data() ) ) )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"AssetPreprocessor::LoadResourceData(): Preprocessing of resource \"%s\" failed.\n",
-			*resourcePath.ToString() );
+		return false;
 	}
 
-#else  // HELIUM_TOOLS
-
-	HELIUM_UNREF( pResource );
+	rSourceFilePath = String( sourceFilePath.Data() );
 
-#endif  // HELIUM_TOOLS
+	return true;
 }
 
-
-#if HELIUM_TOOLS
-
-/// Load the persistent resource data for the specified resource from the object cache.
+/// Locate the source file of a resource.
 ///
-/// @param[in]  resourcePath           FilePath of the resource object.
-/// @param[in]  platform               Platform for which to retrieve the cached data.
-/// @param[out] rPersistentDataBuffer  Buffer in which the persistent resource data should be stored.
+/// The source file belongs to the first resource in the template chain of the given resource that extends a default
+/// template (i.e. test.png, which would have Helium::Texture2D as template).
 ///
-/// @return  Number of resource sub-data chunks if loaded successfully, Invalid< uint32_t >() if not loaded
-///          successfully.
-uint32_t AssetPreprocessor::LoadPersistentResourceData(
-	AssetPath resourcePath,
-	Cache::EPlatform platform,
-	DynamicArray< uint8_t >& rPersistentDataBuffer )
+/// @param[in]  resourcePath       Resource path.
+/// @param[in]  pResource          Resource.
+/// @param[out] rBaseResourcePath  Path of the top-level asset providing the source file.
+/// @param[out] rSourceFilePath    Path of the source file.
+///
+/// @return  True if the paths were determined, false if the data directory could not be retrieved.
+bool AssetPreprocessor::GetResourceSourcePaths(
+	const AssetPath &resourcePath,
+	Resource* pResource,
+	AssetPath& rBaseResourcePath,
+	FilePath& rSourceFilePath )
 {
-	HELIUM_ASSERT( !resourcePath.IsEmpty() );
-	HELIUM_ASSERT( static_cast< size_t >( platform ) < static_cast< size_t >( Cache::PLATFORM_MAX ) );
+	HELIUM_ASSERT( pResource );
 
-	rPersistentDataBuffer.Resize( 0 );
+	Resource* pSourceResource = pResource;
+	Asset* pTestTemplate = Reflect::AssertCast< Asset >( pResource->GetTemplate() );
+	while( pTestTemplate && !pTestTemplate->IsDefaultTemplate() )
+	{
+		pSourceResource = Reflect::AssertCast< Resource >( pTestTemplate );
+		pTestTemplate = Reflect::AssertCast< Asset >( pSourceResource->GetTemplate() );
+	}
 
-	// Get the platform preprocessor.
-	PlatformPreprocessor* pPreprocessor = m_pPlatformPreprocessors[ platform ];
-	if( !pPreprocessor )
+	AssetPath parentPath = pSourceResource == pResource ? resourcePath : pSourceResource->GetPath();
+	do
+	{
+		rBaseResourcePath = parentPath;
+		parentPath = parentPath.GetParent();
+	} while( !parentPath.IsEmpty() && !parentPath.IsPackage() );
+
+	if ( !FileLocations::GetDataDirectory( rSourceFilePath ) )
 	{
 		HELIUM_TRACE(
 			TraceLevels::Error,
-			"AssetPreprocessor::LoadPersistentResourceData(): Platform preprocessor does not exist for platform index %" PRId32 ".\n",
-			static_cast< int32_t >( platform ) );
+			"AssetPreprocessor::GetResourceSourcePaths(): Could not retrieve data directory.\n" );
 
-		return Invalid< uint32_t >();
+		return false;
 	}
 
-	// Retrieve the object cache for the specified platform.
-	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
-	HELIUM_ASSERT( pAssetLoader );
+	rSourceFilePath += rBaseResourcePath.ToFilePathString().GetData();
 
-	CacheManager* pCacheManager = CacheManager::GetInstance();
-	HELIUM_ASSERT( pCacheManager );
+	return true;
+}
 
-	Cache* pCache = pCacheManager->GetCache( Name( HELIUM_ASSET_CACHE_NAME ), platform );
-	HELIUM_ASSERT( pCache );
-	pCache->EnforceTocLoad();
+/// Add the path and content hashes of a file to the inputs of a resource.
+///
+/// @param[in]     rDatabase  Cook database providing the content hash.
+/// @param[in]     rPath      File path (files that do not exist are hashed as empty).
+/// @param[in,out] rInputs    Input hashes.
+static void AddFileInput( CookDatabase& rDatabase, const FilePath& rPath, DynamicArray< uint64_t >& rInputs )
+{
+	const std::string& rPathString = rPath.Get();
+	rInputs.Push( Cache::ComputeContentHash( rPathString.c_str(), rPathString.size() ) );
 
-	// Locate the cache entry for the resource.
-	const Cache::Entry* pCacheEntry = pCache->FindEntry( resourcePath, 0 );
-	if( !pCacheEntry )
+	uint64_t contentHash = 0;
+	if( rPathString.empty() || !rDatabase.HashFile( rPath, contentHash ) )
 	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"AssetPreprocessor::LoadPersistentResourceData(): Failed to locate cached persistent resource data for \"%s\".\n",
-			*resourcePath.ToString() );
-
-		return Invalid< uint32_t >();
+		contentHash = 0;
 	}
 
-	if( pCacheEntry->size < sizeof( uint32_t ) )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"AssetPreprocessor::LoadPersistentResourceData(): Asset cache entry for \"%s\" is smaller than the size needed to provide the property data stream byte count.\n",
-			*resourcePath.ToString() );
+	rInputs.Push( contentHash );
+}
 
-		return Invalid< uint32_t >();
-	}
+/// Compute the combined hash of the inputs of a resource.
+///
+/// The inputs are the version of the resource's handler, the options of every enabled platform preprocessor, the
+/// contents of the resource's object and source files, and the contents of the given dependency files.  The cook
+/// database lock must be held when calling this.
+///
+/// @param[in]  resourcePath      Resource path.
+/// @param[in]  pResource         Resource.
+/// @param[in]  rDependencyFiles  Paths of the additional files read when the resource was preprocessed.
+/// @param[out] rHash             Input hash.
+///
+/// @return  True if the hash was computed, false if the source file could not be located.
+bool AssetPreprocessor::ComputeInputHash(
+	const AssetPath &resourcePath,
+	Resource* pResource,
+	const DynamicArray< String >& rDependencyFiles,
+	uint64_t& rHash )
+{
+	HELIUM_ASSERT( pResource );
+
+	AssetPath baseResourcePath;
+	FilePath sourceFilePath;
+	if( !GetResourceSourcePaths( resourcePath, pResource, baseResourcePath, sourceFilePath ) )
+	{
+		return false;
+	}
+
+	DynamicArray< uint64_t > inputs;
+
+	const AssetType* pResourceType = pResource->GetAssetType();
+	HELIUM_ASSERT( pResourceType );
+	ResourceHandler* pResourceHandler = ResourceHandler::FindResourceHandlerForType( pResourceType );
+	inputs.Push( pResourceHandler ? pResourceHandler->GetCookVersion() : 0 );
+
+	for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+	{
+		PlatformPreprocessor* pPreprocessor = m_pPlatformPreprocessors[ platformIndex ];
+		if( pPreprocessor )
+		{
+			inputs.Push( platformIndex );
+			inputs.Push( pPreprocessor->GetCookOptionsHash() );
+		}
+	}
+
+	AddFileInput( m_cookDatabase, AssetLoader::GetAssetFilePath( resourcePath ), inputs );
+	if( baseResourcePath != resourcePath )
+	{
+		AddFileInput( m_cookDatabase, AssetLoader::GetAssetFilePath( baseResourcePath ), inputs );
+	}
+
+	AddFileInput( m_cookDatabase, sourceFilePath, inputs );
+
+	size_t dependencyCount = rDependencyFiles.GetSize();
+	for( size_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+	{
+		AddFileInput( m_cookDatabase, FilePath( rDependencyFiles[ dependencyIndex ].GetData() ), inputs );
+	}
+
+	rHash = Cache::ComputeContentHash( inputs.GetData(), inputs.GetSize() * sizeof( uint64_t ) );
+
+	return true;
+}
+
+/// Update the cook database record of a resource once it has been preprocessed.
+///
+/// @param[in] resourcePath  Resource path.
+/// @param[in] pResource     Resource preprocessed.
+/// @param[in] bSuccess      True if preprocessing succeeded, false if it failed (in which case the record of the
+///                          resource is removed, so that it is preprocessed again the next time it is loaded).
+void AssetPreprocessor::RecordCookInputs( const AssetPath &resourcePath, Resource* pResource, bool bSuccess )
+{
+	HELIUM_ASSERT( pResource );
+
+	MutexScopeLock scopeLock( m_cookDatabaseLock );
+	LoadCookDatabase();
+
+	CookDatabase::Record record;
+
+	HashMap< AssetPath, DynamicArray< String > >::Iterator dependencyIterator =
+		m_cookDependencies.Find( resourcePath );
+	if( dependencyIterator != m_cookDependencies.End() )
+	{
+		record.dependencyFiles = dependencyIterator->Second();
+		m_cookDependencies.Remove( dependencyIterator );
+	}
+
+	if( !bSuccess || !ComputeInputHash( resourcePath, pResource, record.dependencyFiles, record.inputHash ) )
+	{
+		m_cookDatabase.RemoveRecord( resourcePath );
+
+		return;
+	}
+
+	m_cookDatabase.SetRecord( resourcePath, record );
+}
+
+/// Load the cook database saved by a previous run, if it has not been loaded yet.
+///
+/// The cook database lock must be held when calling this.
+///
+/// @see SaveCookDatabase()
+void AssetPreprocessor::LoadCookDatabase()
+{
+	if( m_bCookDatabaseLoaded )
+	{
+		return;
+	}
+
+	m_bCookDatabaseLoaded = true;
+
+	FilePath databasePath;
+	if( CookDatabase::GetDatabaseFilePath( databasePath ) && m_cookDatabase.LoadFromFile( databasePath ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"AssetPreprocessor::LoadCookDatabase(): Loaded cook database \"%s\".\n",
+			databasePath.Data() );
+	}
+}
+
+/// Save the cook database if it has changed since it was loaded or last saved.
+///
+/// @see LoadCookDatabase()
+void AssetPreprocessor::SaveCookDatabase()
+{
+	MutexScopeLock scopeLock( m_cookDatabaseLock );
+
+	if( !m_cookDatabase.IsDirty() )
+	{
+		return;
+	}
+
+	FilePath databasePath;
+	if( !CookDatabase::GetDatabaseFilePath( databasePath ) || !m_cookDatabase.SaveToFile( databasePath ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"AssetPreprocessor::SaveCookDatabase(): Failed to save the cook database.\n" );
+	}
+}
+
+/// Load the persistent resource data for the specified resource from the object cache.
+///
+/// @param[in]  resourcePath           FilePath of the resource object.
+/// @param[in]  platform               Platform for which to retrieve the cached data.
+/// @param[out] rPersistentDataBuffer  Buffer in which the persistent resource data should be stored.
+///
+/// @return  Number of resource sub-data chunks if loaded successfully, Invalid< uint32_t >() if not loaded
+///          successfully.
+uint32_t AssetPreprocessor::LoadPersistentResourceData(
+	AssetPath resourcePath,
+	Cache::EPlatform platform,
+	DynamicArray< uint8_t >& rPersistentDataBuffer )
+{
+	HELIUM_ASSERT( !resourcePath.IsEmpty() );
+	HELIUM_ASSERT( static_cast< size_t >( platform ) < static_cast< size_t >( Cache::PLATFORM_MAX ) );
+
+	rPersistentDataBuffer.Resize( 0 );
+
+	// Get the platform preprocessor.
+	PlatformPreprocessor* pPreprocessor = m_pPlatformPreprocessors[ platform ];
+	if( !pPreprocessor )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"AssetPreprocessor::LoadPersistentResourceData(): Platform preprocessor does not exist for platform index %" PRId32 ".\n",
+			static_cast< int32_t >( platform ) );
+
+		return Invalid< uint32_t >();
+	}
+
+	// Retrieve the object cache for the specified platform.
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+
+	CacheManager* pCacheManager = CacheManager::GetInstance();
+	HELIUM_ASSERT( pCacheManager );
+
+	Cache* pCache = pCacheManager->GetCache( Name( HELIUM_ASSET_CACHE_NAME ), platform );
+	HELIUM_ASSERT( pCache );
+	pCache->EnforceTocLoad();
+
+	// Locate the cache entry for the resource.
+	const Cache::Entry* pCacheEntry = pCache->FindEntry( resourcePath, 0 );
+	if( !pCacheEntry )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"AssetPreprocessor::LoadPersistentResourceData(): Failed to locate cached persistent resource data for \"%s\".\n",
+			*resourcePath.ToString() );
+
+		return Invalid< uint32_t >();
+	}
+
+	if( pCacheEntry->size < sizeof( uint32_t ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"AssetPreprocessor::LoadPersistentResourceData(): Asset cache entry for \"%s\" is smaller than the size needed to provide the property data stream byte count.\n",
+			*resourcePath.ToString() );
+
+		return Invalid< uint32_t >();
+	}
 
 	FileStream* pFileStream = FileStream::OpenFileStream( pCache->GetCacheFileName(), FileStream::MODE_READ );
 	if( !pFileStream )
@@ -628,109 +1380,580 @@ uint32_t AssetPreprocessor::LoadPersistentResourceData(
 
 	return subDataCount;
 }
-#endif  // HELIUM_TOOLS
 
-/// Get the singleton AssetPreprocessor instance.
+/// Build the cache entries of an object for every registered platform whose cache does not already hold an up-to-date
+/// entry for it.
 ///
-/// @return  Pointer to the AssetPreprocessor instance if one exists, null if not.
+/// The entries of resource sub-data reference the preprocessed data kept with the resource, so it must stay in
+/// memory until the entries have been written.
 ///
-/// @see Startup(), Shutdown()
-AssetPreprocessor* AssetPreprocessor::GetInstance()
-{
-	return sm_pInstance;
-}
-
-/// Create the singleton AssetPreprocessor instance.
+/// @param[in]  objectPath  Path of the object to cache.
+/// @param[in]  pObject     Asset to cache.
+/// @param[in]  timestamp   Asset timestamp.  Resources with a cook database record use their recorded input hash
+///                         instead.
+/// @param[out] rEntries    Built entries are added to this array.
 ///
-/// @return  Pointer to the created instance.
+/// @return  Bit mask of the platforms for which the object was recached (zero if it was up to date everywhere).
 ///
-/// @see Shutdown(), GetInstance()
-void AssetPreprocessor::Startup()
+/// @see CommitCacheEntries(), FinishCachedObject()
+uint32_t AssetPreprocessor::BuildCacheEntries(
+	const AssetPath &objectPath,
+	Asset* pObject,
+	int64_t timestamp,
+	DynamicArray< PendingCacheEntry >& rEntries )
 {
-	if ( ++g_InitCount == 1 )
-	{
-		HELIUM_ASSERT( !sm_pInstance );
-		sm_pInstance = new AssetPreprocessor;
-		HELIUM_ASSERT( sm_pInstance );
-	}
-}
+	HELIUM_ASSERT( pObject );
+	HELIUM_ASSERT( static_cast< size_t >( Cache::PLATFORM_MAX ) <= sizeof( uint32_t ) * 8 );
 
-/// Destroy the singleton AssetPreprocessor instance.
-///
-/// @see Startup(), GetInstance()
-void AssetPreprocessor::Shutdown()
-{
-	if ( --g_InitCount == 0 )
+	Helium::DynamicMemoryStream directStream;
+	Helium::ByteSwappingStream byteSwappingStream( &directStream );
+
+	// Only worry about resource data caching if the object is a Resource type that's not the default template
+	// object for its specific type.
+	Resource* pResource = ( !pObject->IsDefaultTemplate() ? Reflect::SafeCast< Resource >( pObject ) : NULL );
+
+	// Resources are cached with the input hash recorded when they were last preprocessed in place of a timestamp, as
+	// that is what NeedsPreprocessing() compares against.
+	if( pResource )
 	{
-		HELIUM_ASSERT( sm_pInstance );
-		delete sm_pInstance;
-		sm_pInstance = NULL;
+		MutexScopeLock scopeLock( m_cookDatabaseLock );
+		LoadCookDatabase();
+
+		const CookDatabase::Record* pRecord = m_cookDatabase.FindRecord( objectPath );
+		if( pRecord )
+		{
+			timestamp = static_cast< int64_t >( pRecord->inputHash );
+		}
 	}
-}
 
-#if HELIUM_TOOLS
-/// Helper function for loading the cached resource data for a specific platform.
-///
-/// @param[in] pResource  Resource to load.  The data will be loaded into the proper Resource::PreprocessedData
-///                       structure stored in memory with the resource.
-/// @param[in] platform   Platform for which to load the resource data.
-///
-/// @return  True if the resource data was loaded successfully, false if loading failed.
-bool AssetPreprocessor::LoadCachedResourceData( const AssetPath &path, Resource* pResource, Cache::EPlatform platform )
-{
-	HELIUM_ASSERT( pResource );
-	HELIUM_ASSERT( static_cast< size_t >( platform ) < static_cast< size_t >( Cache::PLATFORM_MAX ) );
+	CacheManager* pCacheManager = CacheManager::GetInstance();
+	HELIUM_ASSERT( pCacheManager );
 
-	Resource::PreprocessedData& rPreprocessedData = pResource->GetPreprocessedData( platform );
-	rPreprocessedData.bLoaded = false;
+	// Non-user configuration objects should have special caching logic
+	Name objectCacheName( NULL_NAME );
 
-	// Load the persistent resource data and retrieve the number of sub-data chunks.
-	uint32_t subDataCount = LoadPersistentResourceData(
-		path,
-		platform,
-		rPreprocessedData.persistentDataBuffer );
-	if( IsInvalid( subDataCount ) )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"AssetPreprocessor::LoadCachedResourceData(): Failed to load persistent resource data for \"%s\".\n",
-			*path.ToString() );
+	Config* pConfig = Config::GetInstance();
+	HELIUM_ASSERT( pConfig );
 
-		return false;
+	// TODO: We should only cache the platform-required configs
+	if( pConfig->IsAssetPathInConfigContainerPackage( objectPath ) )
+	{
+		objectCacheName = Name( HELIUM_CONFIG_CACHE_NAME );
 	}
-
-	// Load the sub-data from the resource cache.
-	if( subDataCount != 0 )
+	
+	if (objectCacheName.IsEmpty())
 	{
-		Name resourceCacheName = pResource->GetCacheName();
-		HELIUM_ASSERT( !resourceCacheName.IsEmpty() );
+		objectCacheName = Name( HELIUM_ASSET_CACHE_NAME );
+	}
 
-		CacheManager* pCacheManager = CacheManager::GetInstance();
-		HELIUM_ASSERT( pCacheManager );
+	uint32_t recachedPlatformMask = 0;
 
-		Cache* pResourceCache = pCacheManager->GetCache( resourceCacheName, platform );
-		HELIUM_ASSERT( pResourceCache );
-		pResourceCache->EnforceTocLoad();
+	// Assets referenced by the object, gathered while serializing it for the first platform recached.
+	DynamicArray< AssetPath > referencedPaths;
+	bool bGatheredReferences = false;
 
-		FilePath resourceCachePath( pResourceCache->GetCacheFileName().GetData() );
-		if( !resourceCachePath.Exists() )
+	for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+	{
+		// Don't cache on platforms for which we don't have a preprocessor.
+		PlatformPreprocessor* pPreprocessor = m_pPlatformPreprocessors[ platformIndex ];
+		if( !pPreprocessor )
 		{
-			HELIUM_TRACE(
-				TraceLevels::Info,
-				"AssetPreprocessor::LoadCachedResourceData(): Cache file for cache \"%s\" does not exist when loading resource data for \"%s\".\n",
-				*resourceCacheName,
-				*path.ToString() );
-
-			return false;
+			continue;
 		}
 
-		FileStream* pFileStream = FileStream::OpenFileStream( resourceCachePath.Data(), FileStream::MODE_READ );
-		if( !pFileStream )
-		{
-			HELIUM_TRACE(
-				TraceLevels::Error,
-				"AssetPreprocessor::LoadCachedResourceData(): Failed to open cache file for cache \"%s\" for resource \"%s\".\n",
-				*resourceCacheName,
+		// Retrieve the cache for the current platform.
+		Cache* pCache = pCacheManager->GetCache( objectCacheName, static_cast< Cache::EPlatform >( platformIndex ) );
+		HELIUM_ASSERT( pCache );
+		pCache->EnforceTocLoad();
+
+		// Don't recache the object if an up-to-date cache entry already exists for it.
+		const Cache::Entry* pEntry = pCache->FindEntry( objectPath, 0 );
+		if( pEntry && pEntry->timestamp == timestamp )
+		{
+			continue;
+		}
+
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"AssetPreprocessor: Object \"%s\" is out of date.  Recaching...\n",
+			*objectPath.ToString() );
+
+		recachedPlatformMask |= 1U << platformIndex;
+
+		// Prepare for writing out the property and persistent resource data for the current platform.
+		PendingCacheEntry* pObjectEntry = rEntries.New();
+		HELIUM_ASSERT( pObjectEntry );
+		pObjectEntry->pCache = pCache;
+		pObjectEntry->path = objectPath;
+		pObjectEntry->subDataIndex = 0;
+		pObjectEntry->timestamp = timestamp;
+		pObjectEntry->codec = CompressionCodecs::None;
+		pObjectEntry->pExternalData = NULL;
+
+		directStream.Open( &pObjectEntry->data );
+
+		bool bSwapBytes = pPreprocessor->SwapBytes();
+		Stream& rObjectStream =
+			( bSwapBytes ? static_cast< Stream& >( byteSwappingStream ) : static_cast< Stream& >( directStream ) );
+		
+		DynamicArray<uint8_t> data_buffer;
+		Cache::WriteCacheObjectToBuffer( pObject, data_buffer, bGatheredReferences ? NULL : &referencedPaths );
+		bGatheredReferences = true;
+
+		if (!data_buffer.IsEmpty())
+		{
+			HELIUM_ASSERT(data_buffer.GetSize() <= Helium::NumericLimits<uint32_t>::Maximum);
+			uint32_t data_size = static_cast<uint32_t>(data_buffer.GetSize()) + 1; // Add one for null terminator
+			rObjectStream.Write(&data_size, sizeof(data_size), 1);
+			rObjectStream.Write(&data_buffer[0], sizeof(data_buffer[0]), data_size - 1); // Copy the data (it is not null terminated).
+
+			char nullTerminator = 0;
+			rObjectStream.Write(&nullTerminator, sizeof(nullTerminator), 1); // Add the null terminator
+		}
+		else
+		{
+			uint32_t data_size = 0;
+			rObjectStream.Write(&data_size, sizeof(data_size), 1);
+		}
+		
+		// Serialize persistent resource data and the number of chunks of sub-data.
+		if( pResource )
+		{
+			const Resource::PreprocessedData& rResourceData = pResource->GetPreprocessedData(
+				static_cast< Cache::EPlatform >( platformIndex ) );
+			if( !rResourceData.bLoaded )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Warning,
+					"AssetPreprocessor::CacheObject(): Cannot cache resource data for \"%s\" for platform index %" PRIuSZ " as the resource data is not in memory.  Make sure AssetPreprocessor::LoadResourceData() has been called on the object prior to caching.\n",
+					*objectPath.ToString(),
+					platformIndex );
+			}
+			else
+			{
+				rObjectStream.Write(
+					rResourceData.persistentDataBuffer.GetData(),
+					1,
+					rResourceData.persistentDataBuffer.GetSize() );
+
+				// If we write anything, add a null terminator
+				if (rResourceData.persistentDataBuffer.GetSize() > 0)
+				{
+					char nullTerminator = 0;
+					rObjectStream.Write(&nullTerminator, sizeof(nullTerminator), 1); // Add the null terminator
+				}
+
+				size_t subDataCountActual = rResourceData.subDataBuffers.GetSize();
+				HELIUM_ASSERT( subDataCountActual <= UINT32_MAX );
+
+				uint32_t subDataCount = static_cast< uint32_t >( subDataCountActual );
+				rObjectStream.Write( &subDataCount, sizeof( subDataCount ), 1 );
+			}
+		}
+
+		directStream.Close();
+
+		// Cache resource sub-data.
+		if( pResource )
+		{
+			const Resource::PreprocessedData& rResourceData = pResource->GetPreprocessedData(
+				static_cast< Cache::EPlatform >( platformIndex ) );
+			const DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rResourceData.subDataBuffers;
+			size_t subDataBufferCount = rSubDataBuffers.GetSize();
+			if( rResourceData.bLoaded && subDataBufferCount != 0 )
+			{
+				Name resourceCacheName = pResource->GetCacheName();
+				HELIUM_ASSERT( !resourceCacheName.IsEmpty() );
+
+				Cache* pResourceCache = pCacheManager->GetCache(
+					resourceCacheName,
+					static_cast< Cache::EPlatform >( platformIndex ) );
+				HELIUM_ASSERT( pResourceCache );
+				pResourceCache->EnforceTocLoad();
+
+				for( size_t subDataBufferIndex = 0;
+					subDataBufferIndex < subDataBufferCount;
+					++subDataBufferIndex )
+				{
+					PendingCacheEntry* pSubDataEntry = rEntries.New();
+					HELIUM_ASSERT( pSubDataEntry );
+					pSubDataEntry->pCache = pResourceCache;
+					pSubDataEntry->path = objectPath;
+					pSubDataEntry->subDataIndex = static_cast< uint32_t >( subDataBufferIndex );
+					pSubDataEntry->timestamp = timestamp;
+					pSubDataEntry->codec = CompressionCodecs::Deflate;
+					pSubDataEntry->pExternalData = &rSubDataBuffers[ subDataBufferIndex ];
+				}
+			}
+		}
+	}
+
+	// Keep the dependencies for the prefetch manifest of the object's package.
+	if( bGatheredReferences && objectCacheName == Name( HELIUM_ASSET_CACHE_NAME ) )
+	{
+		RecordDependencies( objectPath, referencedPaths );
+	}
+
+	return recachedPlatformMask;
+}
+
+/// Write a set of built cache entries, with a single CacheEntries() call (and so a single lock and TOC update) for
+/// each cache they update.
+///
+/// @param[in] rEntries  Entries to write.
+///
+/// @return  True if every entry was written successfully, false if any failed.
+///
+/// @see BuildCacheEntries()
+bool AssetPreprocessor::CommitCacheEntries( const DynamicArray< PendingCacheEntry >& rEntries )
+{
+	size_t entryCount = rEntries.GetSize();
+
+	DynamicArray< Cache* > caches;
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Cache* pCache = rEntries[ entryIndex ].pCache;
+		HELIUM_ASSERT( pCache );
+
+		size_t cacheIndex;
+		for( cacheIndex = 0; cacheIndex < caches.GetSize() && caches[ cacheIndex ] != pCache; ++cacheIndex )
+		{
+		}
+
+		if( cacheIndex == caches.GetSize() )
+		{
+			caches.Push( pCache );
+		}
+	}
+
+	bool bSuccess = true;
+
+	DynamicArray< Cache::EntryUpdate > updates;
+	updates.Reserve( entryCount );
+
+	size_t cacheCount = caches.GetSize();
+	for( size_t cacheIndex = 0; cacheIndex < cacheCount; ++cacheIndex )
+	{
+		Cache* pCache = caches[ cacheIndex ];
+
+		updates.Resize( 0 );
+		for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+		{
+			const PendingCacheEntry& rEntry = rEntries[ entryIndex ];
+			if( rEntry.pCache != pCache )
+			{
+				continue;
+			}
+
+			const DynamicArray< uint8_t >& rData = ( rEntry.pExternalData ? *rEntry.pExternalData : rEntry.data );
+			HELIUM_ASSERT( rData.GetSize() <= UINT32_MAX );
+
+			Cache::EntryUpdate* pUpdate = updates.New();
+			HELIUM_ASSERT( pUpdate );
+			pUpdate->path = rEntry.path;
+			pUpdate->subDataIndex = rEntry.subDataIndex;
+			pUpdate->pData = rData.GetData();
+			pUpdate->timestamp = rEntry.timestamp;
+			pUpdate->size = static_cast< uint32_t >( rData.GetSize() );
+			pUpdate->codec = rEntry.codec;
+		}
+
+		if( !pCache->CacheEntries( updates.GetData(), updates.GetSize() ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"AssetPreprocessor: Failed to write %" PRIuSZ " entries to cache \"%s\".\n",
+				updates.GetSize(),
+				*pCache->GetName() );
+
+			bSuccess = false;
+		}
+	}
+
+	return bSuccess;
+}
+
+/// Finish caching an object once its cache entries have been written.
+///
+/// @param[in] pObject                                 Asset cached.
+/// @param[in] recachedPlatformMask                    Bit mask of the platforms for which the object was recached.
+/// @param[in] bEvictPlatformPreprocessedResourceData  True to free the preprocessed resource data of the recached
+///                                                    platforms.
+///
+/// @see BuildCacheEntries()
+void AssetPreprocessor::FinishCachedObject(
+	Asset* pObject,
+	uint32_t recachedPlatformMask,
+	bool bEvictPlatformPreprocessedResourceData )
+{
+	HELIUM_ASSERT( pObject );
+
+	if( recachedPlatformMask == 0 )
+	{
+		return;
+	}
+
+	// Since all resource data has now been recached for the recached platforms, we can evict their data from memory.
+	Resource* pResource = ( !pObject->IsDefaultTemplate() ? Reflect::SafeCast< Resource >( pObject ) : NULL );
+	if( pResource && bEvictPlatformPreprocessedResourceData )
+	{
+		for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+		{
+			if( !( recachedPlatformMask & ( 1U << platformIndex ) ) )
+			{
+				continue;
+			}
+
+			Resource::PreprocessedData& rResourceData = pResource->GetPreprocessedData(
+				static_cast< Cache::EPlatform >( platformIndex ) );
+			if( rResourceData.bLoaded )
+			{
+				rResourceData.persistentDataBuffer.Clear();
+				rResourceData.subDataBuffers.Clear();
+				rResourceData.bLoaded = false;
+			}
+		}
+	}
+
+	// Notify the object that it has been cached.
+	pObject->PostSave();
+}
+
+/// Keep the dependencies of a cached object for the prefetch manifest of its package.
+///
+/// @param[in] objectPath     Path of the object cached.
+/// @param[in] rDependencies  Paths of the assets referenced by the object.
+///
+/// @see FlushPrefetchManifests()
+void AssetPreprocessor::RecordDependencies( AssetPath objectPath, const DynamicArray< AssetPath >& rDependencies )
+{
+	AssetPath packagePath = objectPath.GetParentPackage();
+	if( packagePath.IsEmpty() )
+	{
+		return;
+	}
+
+	// Owners are loaded before the objects they own (packages are created on load, so they are not cached).
+	DynamicArray< AssetPath > dependencies;
+	AssetPath ownerPath = objectPath.GetParent();
+	if( !ownerPath.IsEmpty() && !ownerPath.IsPackage() )
+	{
+		dependencies.Push( ownerPath );
+	}
+
+	size_t dependencyCount = rDependencies.GetSize();
+	for( size_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+	{
+		AssetPath dependencyPath = rDependencies[ dependencyIndex ];
+		if( dependencyPath != objectPath && dependencyPath != ownerPath && !dependencyPath.IsPackage() )
+		{
+			dependencies.Push( dependencyPath );
+		}
+	}
+
+	PackageDependencies* pPackageDependencies = NULL;
+
+	size_t packageCount = m_packageDependencies.GetSize();
+	for( size_t packageIndex = 0; packageIndex < packageCount; ++packageIndex )
+	{
+		if( m_packageDependencies[ packageIndex ].packagePath == packagePath )
+		{
+			pPackageDependencies = &m_packageDependencies[ packageIndex ];
+
+			break;
+		}
+	}
+
+	if( !pPackageDependencies )
+	{
+		pPackageDependencies = m_packageDependencies.New();
+		HELIUM_ASSERT( pPackageDependencies );
+		pPackageDependencies->packagePath = packagePath;
+	}
+
+	pPackageDependencies->manifest.SetDependencies( objectPath, dependencies );
+}
+
+/// Read the prefetch manifest of a package from a cache of the current platform.
+///
+/// @param[in]  pCache       Cache from which to read the manifest.
+/// @param[in]  packagePath  Package path.
+/// @param[out] rManifest    Manifest read (empty if the package has no manifest or it could not be read).
+///
+/// @return  True if the manifest was read, false if not.
+bool AssetPreprocessor::LoadPrefetchManifest( Cache* pCache, AssetPath packagePath, PrefetchManifest& rManifest )
+{
+	HELIUM_ASSERT( pCache );
+
+	rManifest.Clear();
+
+	const Cache::Entry* pCacheEntry = pCache->FindEntry( packagePath, Cache::PREFETCH_MANIFEST_SUB_DATA_INDEX );
+	if( !pCacheEntry )
+	{
+		return false;
+	}
+
+	if( pCacheEntry->codec != CompressionCodecs::None )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"AssetPreprocessor::LoadPrefetchManifest(): Prefetch manifest of package \"%s\" is compressed.  It will be rebuilt.\n",
+			*packagePath.ToString() );
+
+		return false;
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( pCache->GetCacheFileName(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"AssetPreprocessor::LoadPrefetchManifest(): Failed to open cache file \"%s\" for reading the prefetch manifest of package \"%s\".\n",
+			*pCache->GetCacheFileName(),
+			*packagePath.ToString() );
+
+		return false;
+	}
+
+	DynamicArray< uint8_t > manifestData;
+	manifestData.Resize( pCacheEntry->size );
+
+	size_t bytesRead = 0;
+	int64_t seekLocation = pFileStream->Seek( pCacheEntry->offset, SeekOrigins::Begin );
+	if( static_cast< uint64_t >( seekLocation ) == pCacheEntry->offset )
+	{
+		bytesRead = pFileStream->Read( manifestData.GetData(), 1, manifestData.GetSize() );
+	}
+
+	pFileStream->Close();
+	delete pFileStream;
+
+	if( bytesRead != manifestData.GetSize() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"AssetPreprocessor::LoadPrefetchManifest(): Failed to read the prefetch manifest of package \"%s\" from cache file \"%s\".\n",
+			*packagePath.ToString(),
+			*pCache->GetCacheFileName() );
+
+		return false;
+	}
+
+	return rManifest.Read( manifestData.GetData(), manifestData.GetSize() );
+}
+#endif  // HELIUM_TOOLS
+
+/// Get the singleton AssetPreprocessor instance.
+///
+/// @return  Pointer to the AssetPreprocessor instance if one exists, null if not.
+///
+/// @see Startup(), Shutdown()
+AssetPreprocessor* AssetPreprocessor::GetInstance()
+{
+	return sm_pInstance;
+}
+
+/// Create the singleton AssetPreprocessor instance.
+///
+/// @return  Pointer to the created instance.
+///
+/// @see Shutdown(), GetInstance()
+void AssetPreprocessor::Startup()
+{
+	if ( ++g_InitCount == 1 )
+	{
+		HELIUM_ASSERT( !sm_pInstance );
+		sm_pInstance = new AssetPreprocessor;
+		HELIUM_ASSERT( sm_pInstance );
+	}
+}
+
+/// Destroy the singleton AssetPreprocessor instance.
+///
+/// @see Startup(), GetInstance()
+void AssetPreprocessor::Shutdown()
+{
+	if ( --g_InitCount == 0 )
+	{
+		HELIUM_ASSERT( sm_pInstance );
+		if( sm_pInstance->IsCookBatchActive() )
+		{
+			sm_pInstance->EndCookBatch();
+		}
+
+		sm_pInstance->FlushPrefetchManifests();
+#if HELIUM_TOOLS
+		sm_pInstance->SaveCookDatabase();
+		sm_pInstance->m_sharedCookCache.Flush();
+#endif
+		delete sm_pInstance;
+		sm_pInstance = NULL;
+	}
+}
+
+#if HELIUM_TOOLS
+/// Helper function for loading the cached resource data for a specific platform.
+///
+/// @param[in] pResource  Resource to load.  The data will be loaded into the proper Resource::PreprocessedData
+///                       structure stored in memory with the resource.
+/// @param[in] platform   Platform for which to load the resource data.
+///
+/// @return  True if the resource data was loaded successfully, false if loading failed.
+bool AssetPreprocessor::LoadCachedResourceData( const AssetPath &path, Resource* pResource, Cache::EPlatform platform )
+{
+	HELIUM_ASSERT( pResource );
+	HELIUM_ASSERT( static_cast< size_t >( platform ) < static_cast< size_t >( Cache::PLATFORM_MAX ) );
+
+	Resource::PreprocessedData& rPreprocessedData = pResource->GetPreprocessedData( platform );
+	rPreprocessedData.bLoaded = false;
+
+	// Load the persistent resource data and retrieve the number of sub-data chunks.
+	uint32_t subDataCount = LoadPersistentResourceData(
+		path,
+		platform,
+		rPreprocessedData.persistentDataBuffer );
+	if( IsInvalid( subDataCount ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"AssetPreprocessor::LoadCachedResourceData(): Failed to load persistent resource data for \"%s\".\n",
+			*path.ToString() );
+
+		return false;
+	}
+
+	// Load the sub-data from the resource cache.
+	if( subDataCount != 0 )
+	{
+		Name resourceCacheName = pResource->GetCacheName();
+		HELIUM_ASSERT( !resourceCacheName.IsEmpty() );
+
+		CacheManager* pCacheManager = CacheManager::GetInstance();
+		HELIUM_ASSERT( pCacheManager );
+
+		Cache* pResourceCache = pCacheManager->GetCache( resourceCacheName, platform );
+		HELIUM_ASSERT( pResourceCache );
+		pResourceCache->EnforceTocLoad();
+
+		FilePath resourceCachePath( pResourceCache->GetCacheFileName().GetData() );
+		if( !resourceCachePath.Exists() )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Info,
+				"AssetPreprocessor::LoadCachedResourceData(): Cache file for cache \"%s\" does not exist when loading resource data for \"%s\".\n",
+				*resourceCacheName,
+				*path.ToString() );
+
+			return false;
+		}
+
+		FileStream* pFileStream = FileStream::OpenFileStream( resourceCachePath.Data(), FileStream::MODE_READ );
+		if( !pFileStream )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"AssetPreprocessor::LoadCachedResourceData(): Failed to open cache file for cache \"%s\" for resource \"%s\".\n",
+				*resourceCacheName,
 				*path.ToString() );
 
 			return false;
@@ -740,6 +1963,8 @@ bool AssetPreprocessor::LoadCachedResourceData( const AssetPath &path, Resource*
 		rSubDataBuffers.Reserve( subDataCount );
 		rSubDataBuffers.Resize( subDataCount );
 
+		DynamicArray< uint8_t > compressedData;
+
 		for( uint32_t subDataIndex = 0; subDataIndex < subDataCount; ++subDataIndex )
 		{
 			const Cache::Entry* pResourceCacheEntry = pResourceCache->FindEntry( path, subDataIndex );
@@ -774,13 +1999,22 @@ bool AssetPreprocessor::LoadCachedResourceData( const AssetPath &path, Resource*
 			}
 
 			uint32_t subDataSize = pResourceCacheEntry->size;
+			uint32_t uncompressedSize = pResourceCacheEntry->uncompressedSize;
+			CompressionCodec codec = static_cast< CompressionCodec >( pResourceCacheEntry->codec );
 
 			DynamicArray< uint8_t >& rSubData = rSubDataBuffers[ subDataIndex ];
-			rSubData.Reserve( subDataSize );
-			rSubData.Resize( subDataSize );
+			rSubData.Reserve( uncompressedSize );
+			rSubData.Resize( uncompressedSize );
 			rSubData.Trim();
 
-			size_t bytesRead = pFileStream->Read( rSubData.GetData(), 1, subDataSize );
+			// Compressed sub-data is read into a scratch buffer first and then decompressed in place.
+			if( codec != CompressionCodecs::None )
+			{
+				compressedData.Resize( subDataSize );
+			}
+
+			uint8_t* pReadData = ( codec != CompressionCodecs::None ? compressedData.GetData() : rSubData.GetData() );
+			size_t bytesRead = pFileStream->Read( pReadData, 1, subDataSize );
 			if( bytesRead != subDataSize )
 			{
 				HELIUM_TRACE(
@@ -796,6 +2030,29 @@ bool AssetPreprocessor::LoadCachedResourceData( const AssetPath &path, Resource*
 
 				return false;
 			}
+
+			if( codec != CompressionCodecs::None )
+			{
+				size_t decompressedSize = Compression::Decompress(
+					codec,
+					rSubData.GetData(),
+					uncompressedSize,
+					compressedData.GetData(),
+					subDataSize );
+				if( decompressedSize != uncompressedSize )
+				{
+					HELIUM_TRACE(
+						TraceLevels::Error,
+						"AssetPreprocessor::LoadCachedResourceData(): Failed to decompress sub-data %" PRIu32 " of resource \"%s\" from cache \"%s\".\n",
+						subDataIndex,
+						*path.ToString(),
+						*resourceCacheName );
+
+					delete pFileStream;
+
+					return false;
+				}
+			}
 		}
 
 		delete pFileStream;
@@ -809,11 +2066,64 @@ bool AssetPreprocessor::LoadCachedResourceData( const AssetPath &path, Resource*
 
 /// Preprocess a resource for all enabled platforms, storing the resource data in memory with the resource.
 ///
-/// @param[in] pResource        Resource to preprocess.
-/// @param[in] rSourceFilePath  FilePath name of the source resource data file.
+/// The data is fetched from the shared cook cache instead if it is found there, and stored in it otherwise once
+/// preprocessed.
+///
+/// @param[in] pResource        Resource to preprocess.
+/// @param[in] rSourceFilePath  FilePath name of the source resource data file.
+///
+/// @return  True if preprocessing was successful, false if not.
+bool AssetPreprocessor::PreprocessResource( const AssetPath &path, Resource* pResource, const String& rSourceFilePath )
+{
+	uint64_t sharedKey = 0;
+	bool bSharedKey = m_sharedCookCache.IsEnabled() && ComputeSharedCookKey( path, pResource, sharedKey );
+	if( bSharedKey && FetchSharedResourceData( path, pResource, sharedKey ) )
+	{
+		FinishPreprocessResource( pResource );
+		RecordCookInputs( path, pResource, true );
+
+		return true;
+	}
+
+	ResourceHandler* pResourceHandler = BeginPreprocessResource( path, pResource );
+	if( !pResourceHandler )
+	{
+		return false;
+	}
+
+	// Preprocess and cache the resource for the each enabled platform.
+	if( !pResourceHandler->CacheResource( this, pResource, rSourceFilePath ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"AssetPreprocessor::PreprocessResource(): Failed to preprocess resource \"%s\".\n",
+			*path.ToString() );
+
+		RecordCookInputs( path, pResource, false );
+
+		return false;
+	}
+
+	FinishPreprocessResource( pResource );
+	RecordCookInputs( path, pResource, true );
+
+	if( bSharedKey )
+	{
+		StoreSharedResourceData( path, pResource, sharedKey );
+	}
+
+	return true;
+}
+
+/// Prepare a resource for preprocessing, clearing out its existing resource data.
+///
+/// @param[in] path       Resource path.
+/// @param[in] pResource  Resource to preprocess.
+///
+/// @return  Handler with which to preprocess the resource, or null if no handler exists for its type.
 ///
-/// @return  True if preprocessing was successful, false if not.
-bool AssetPreprocessor::PreprocessResource( const AssetPath &path, Resource* pResource, const String& rSourceFilePath )
+/// @see FinishPreprocessResource()
+ResourceHandler* AssetPreprocessor::BeginPreprocessResource( const AssetPath &path, Resource* pResource )
 {
 	HELIUM_ASSERT( pResource );
 	HELIUM_ASSERT( !pResource->IsDefaultTemplate() );
@@ -833,6 +2143,17 @@ bool AssetPreprocessor::PreprocessResource( const AssetPath &path, Resource* pRe
 		rPreprocessedData.bLoaded = false;
 	}
 
+	// Forget any dependencies recorded by a previous attempt.
+	{
+		MutexScopeLock scopeLock( m_cookDatabaseLock );
+
+		HashMap< AssetPath, DynamicArray< String > >::Iterator dependencyIterator = m_cookDependencies.Find( path );
+		if( dependencyIterator != m_cookDependencies.End() )
+		{
+			m_cookDependencies.Remove( dependencyIterator );
+		}
+	}
+
 	// Locate a resource handler for the resource type.
 	const AssetType* pResourceType = pResource->GetAssetType();
 	HELIUM_ASSERT( pResourceType );
@@ -844,22 +2165,21 @@ bool AssetPreprocessor::PreprocessResource( const AssetPath &path, Resource* pRe
 			"AssetPreprocessor::PreprocessResource(): Failed to locate resource handler for resource \"%s\" of type \"%s\".\n",
 			*path.ToString(),
 			*pResourceType->GetName() );
-
-		return false;
 	}
 
-	// Preprocess and cache the resource for the each enabled platform.
-	if( !pResourceHandler->CacheResource( this, pResource, rSourceFilePath ) )
-	{
-		HELIUM_TRACE(
-			TraceLevels::Error,
-			"AssetPreprocessor::PreprocessResource(): Failed to preprocess resource \"%s\".\n",
-			*path.ToString() );
+	return pResourceHandler;
+}
 
-		return false;
-	}
+/// Finish preprocessing a resource once its handler has cached its data, reserializing the current platform's
+/// persistent resource data into it.
+///
+/// @param[in] pResource  Resource preprocessed.
+///
+/// @see BeginPreprocessResource()
+void AssetPreprocessor::FinishPreprocessResource( Resource* pResource )
+{
+	HELIUM_ASSERT( pResource );
 
-	// Reserialize the current platform's persistent resource data.
 	CacheManager* pCacheManager = CacheManager::GetInstance();
 	HELIUM_ASSERT( pCacheManager );
 
@@ -881,7 +2201,498 @@ bool AssetPreprocessor::PreprocessResource( const AssetPath &path, Resource* pRe
 			}
 		}
 	}
+}
+
+/// Run the handler of a resource queued by a cook batch.
+///
+/// @param[in] pContext  CookResourceContext of the batch.
+/// @param[in] index     Index of the resource in the context's resource list.
+///
+/// @see EndCookBatch()
+void AssetPreprocessor::CookResourceCallback( void* pContext, size_t index )
+{
+	CookResourceContext* pCookContext = static_cast< CookResourceContext* >( pContext );
+	HELIUM_ASSERT( pCookContext );
+
+	CookResource* pCookResource = pCookContext->ppResources[ index ];
+	HELIUM_ASSERT( pCookResource );
+	HELIUM_ASSERT( pCookResource->pHandler );
+
+	Resource* pResource = Reflect::AssertCast< Resource >( pCookResource->spResource.Get() );
+
+	uint64_t startTicks = Timer::GetTickCount();
+	pCookResource->bSuccess = pCookResource->pHandler->CacheResource(
+		pCookContext->pPreprocessor,
+		pResource,
+		pCookResource->sourceFilePath );
+	pCookResource->preprocessTicks = Timer::GetTickCount() - startTicks;
+}
+
+/// Shared cook cache entry data format version.
+static const uint32_t SHARED_RESOURCE_DATA_VERSION = 1;
+
+/// Read a value from shared cook cache entry data, advancing the read position.
+///
+/// @param[out]    rValue     Value read.
+/// @param[in,out] rpCurrent  Current read position.
+/// @param[in]     pEnd       End of the entry data.
+///
+/// @return  True if the value was read, false if the end of the data was reached.
+template< typename T >
+static bool ReadSharedValue( T& rValue, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+{
+	if( static_cast< size_t >( pEnd - rpCurrent ) < sizeof( T ) )
+	{
+		return false;
+	}
+
+	MemoryCopy( &rValue, rpCurrent, sizeof( T ) );
+	rpCurrent += sizeof( T );
+
+	return true;
+}
+
+/// Read a length-prefixed buffer from shared cook cache entry data, advancing the read position.
+///
+/// @param[out]    rBuffer    Buffer read.
+/// @param[in,out] rpCurrent  Current read position.
+/// @param[in]     pEnd       End of the entry data.
+///
+/// @return  True if the buffer was read, false if the end of the data was reached.
+static bool ReadSharedBuffer( DynamicArray< uint8_t >& rBuffer, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+{
+	uint32_t size = 0;
+	if( !ReadSharedValue( size, rpCurrent, pEnd ) || size > static_cast< size_t >( pEnd - rpCurrent ) )
+	{
+		return false;
+	}
+
+	rBuffer.Resize( size );
+	MemoryCopy( rBuffer.GetData(), rpCurrent, size );
+	rpCurrent += size;
+
+	return true;
+}
+
+/// Write a length-prefixed buffer to shared cook cache entry data.
+///
+/// @param[in] rStream  Stream to write to.
+/// @param[in] pData    Buffer data.
+/// @param[in] size     Buffer size, in bytes.
+static void WriteSharedBuffer( Stream& rStream, const void* pData, size_t size )
+{
+	HELIUM_ASSERT( size <= UINT32_MAX );
+
+	uint32_t size32 = static_cast< uint32_t >( size );
+	rStream.Write( &size32, sizeof( size32 ), 1 );
+	rStream.Write( pData, 1, size );
+}
+
+/// Compute the key of a resource in the shared cook cache.
+///
+/// Unlike the input hash (see ComputeInputHash()), the key does not depend on the location of the data directory, so
+/// that it is the same on every machine.  It only covers the inputs known before the resource is preprocessed (the
+/// version of its handler, the options of every enabled platform preprocessor, and its path, object files and source
+/// file).  The additional files read while preprocessing are checked against the content hashes stored with the
+/// entry when it is fetched instead.
+///
+/// @param[in]  resourcePath  Resource path.
+/// @param[in]  pResource     Resource.
+/// @param[out] rKey          Shared cook cache key.
+///
+/// @return  True if the key was computed, false if the source file could not be located.
+bool AssetPreprocessor::ComputeSharedCookKey( const AssetPath &resourcePath, Resource* pResource, uint64_t& rKey )
+{
+	HELIUM_ASSERT( pResource );
+
+	AssetPath baseResourcePath;
+	FilePath sourceFilePath;
+	if( !GetResourceSourcePaths( resourcePath, pResource, baseResourcePath, sourceFilePath ) )
+	{
+		return false;
+	}
+
+	DynamicArray< uint64_t > inputs;
+	inputs.Push( SHARED_RESOURCE_DATA_VERSION );
+
+	const AssetType* pResourceType = pResource->GetAssetType();
+	HELIUM_ASSERT( pResourceType );
+	ResourceHandler* pResourceHandler = ResourceHandler::FindResourceHandlerForType( pResourceType );
+	inputs.Push( pResourceHandler ? pResourceHandler->GetCookVersion() : 0 );
+
+	for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+	{
+		PlatformPreprocessor* pPreprocessor = m_pPlatformPreprocessors[ platformIndex ];
+		if( pPreprocessor )
+		{
+			inputs.Push( platformIndex );
+			inputs.Push( pPreprocessor->GetCookOptionsHash() );
+		}
+	}
+
+	AssetPath inputPaths[ 2 ] = { resourcePath, baseResourcePath };
+	FilePath inputFilePaths[ 3 ] =
+	{
+		AssetLoader::GetAssetFilePath( resourcePath ),
+		AssetLoader::GetAssetFilePath( baseResourcePath ),
+		sourceFilePath
+	};
+
+	for( size_t pathIndex = 0; pathIndex < HELIUM_ARRAY_COUNT( inputPaths ); ++pathIndex )
+	{
+		String pathString = inputPaths[ pathIndex ].ToString();
+		inputs.Push( Cache::ComputeContentHash( pathString.GetData(), pathString.GetSize() ) );
+	}
+
+	MutexScopeLock scopeLock( m_cookDatabaseLock );
+	LoadCookDatabase();
+
+	for( size_t fileIndex = 0; fileIndex < HELIUM_ARRAY_COUNT( inputFilePaths ); ++fileIndex )
+	{
+		uint64_t contentHash = 0;
+		if( inputFilePaths[ fileIndex ].Get().empty() || !m_cookDatabase.HashFile( inputFilePaths[ fileIndex ], contentHash ) )
+		{
+			contentHash = 0;
+		}
+
+		inputs.Push( contentHash );
+	}
+
+	rKey = Cache::ComputeContentHash( inputs.GetData(), inputs.GetSize() * sizeof( uint64_t ) );
+
+	return true;
+}
+
+/// Load the data of a resource for every enabled platform from the shared cook cache.
+///
+/// The entry is only used if every additional file read when it was preprocessed has the same contents here.  On
+/// success, those files are recorded as the resource's cook dependencies, as if it had been preprocessed locally.
+///
+/// @param[in] resourcePath  Resource path.
+/// @param[in] pResource     Resource to load.
+/// @param[in] sharedKey     Shared cook cache key of the resource (see ComputeSharedCookKey()).
+///
+/// @return  True if the resource data was loaded, false if it was not found or is out of date.
+///
+/// @see StoreSharedResourceData()
+bool AssetPreprocessor::FetchSharedResourceData( const AssetPath &resourcePath, Resource* pResource, uint64_t sharedKey )
+{
+	HELIUM_ASSERT( pResource );
+
+	DynamicArray< uint8_t > data;
+	if( !m_sharedCookCache.Fetch( sharedKey, data ) )
+	{
+		return false;
+	}
+
+	FilePath dataDirectory;
+	if( !FileLocations::GetDataDirectory( dataDirectory ) )
+	{
+		return false;
+	}
+
+	const uint8_t* pCurrent = data.GetData();
+	const uint8_t* pEnd = pCurrent + data.GetSize();
+
+	uint32_t version = 0;
+	uint32_t dependencyCount = 0;
+	bool bValid =
+		ReadSharedValue( version, pCurrent, pEnd ) &&
+		version == SHARED_RESOURCE_DATA_VERSION &&
+		ReadSharedValue( dependencyCount, pCurrent, pEnd );
+
+	// Check that the files read when the entry was preprocessed have not changed.
+	DynamicArray< String > dependencyFiles;
+	bool bUpToDate = true;
+	{
+		MutexScopeLock scopeLock( m_cookDatabaseLock );
+		LoadCookDatabase();
+
+		DynamicArray< uint8_t > pathBuffer;
+		for( uint32_t dependencyIndex = 0; bValid && dependencyIndex < dependencyCount; ++dependencyIndex )
+		{
+			uint8_t bDataRelative = 0;
+			uint64_t contentHash = 0;
+			bValid =
+				ReadSharedValue( bDataRelative, pCurrent, pEnd ) &&
+				ReadSharedBuffer( pathBuffer, pCurrent, pEnd ) &&
+				ReadSharedValue( contentHash, pCurrent, pEnd );
+			if( !bValid )
+			{
+				break;
+			}
+
+			std::string dependencyPath( reinterpret_cast< const char* >( pathBuffer.GetData() ), pathBuffer.GetSize() );
+			if( bDataRelative )
+			{
+				dependencyPath = dataDirectory.Get() + dependencyPath;
+			}
+
+			uint64_t localContentHash = 0;
+			if( !m_cookDatabase.HashFile( FilePath( dependencyPath ), localContentHash ) )
+			{
+				localContentHash = 0;
+			}
+
+			if( localContentHash != contentHash )
+			{
+				bUpToDate = false;
+			}
+
+			dependencyFiles.Push( String( dependencyPath.c_str() ) );
+		}
+	}
+
+	if( bValid && !bUpToDate )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"AssetPreprocessor::FetchSharedResourceData(): Shared cook cache entry for resource \"%s\" was preprocessed with different dependencies.\n",
+			*resourcePath.ToString() );
+
+		return false;
+	}
+
+	// Load the data of each platform.
+	uint32_t platformCount = 0;
+	bValid = bValid && ReadSharedValue( platformCount, pCurrent, pEnd );
+
+	uint32_t loadedPlatformMask = 0;
+	for( uint32_t platformIndexIndex = 0; bValid && platformIndexIndex < platformCount; ++platformIndexIndex )
+	{
+		uint32_t platformIndex = 0;
+		bValid =
+			ReadSharedValue( platformIndex, pCurrent, pEnd ) &&
+			platformIndex < static_cast< uint32_t >( Cache::PLATFORM_MAX );
+		if( !bValid )
+		{
+			break;
+		}
+
+		Resource::PreprocessedData& rPreprocessedData = pResource->GetPreprocessedData(
+			static_cast< Cache::EPlatform >( platformIndex ) );
+		DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
+
+		uint32_t subDataCount = 0;
+		bValid =
+			ReadSharedBuffer( rPreprocessedData.persistentDataBuffer, pCurrent, pEnd ) &&
+			ReadSharedValue( subDataCount, pCurrent, pEnd ) &&
+			subDataCount <= static_cast< size_t >( pEnd - pCurrent ) / sizeof( uint32_t );
+		if( !bValid )
+		{
+			break;
+		}
+
+		rSubDataBuffers.Resize( 0 );
+		rSubDataBuffers.Resize( subDataCount );
+		for( uint32_t subDataIndex = 0; bValid && subDataIndex < subDataCount; ++subDataIndex )
+		{
+			bValid = ReadSharedBuffer( rSubDataBuffers[ subDataIndex ], pCurrent, pEnd );
+		}
+
+		rPreprocessedData.bLoaded = bValid;
+		loadedPlatformMask |= ( 1 << platformIndex );
+	}
+
+	for( size_t platformIndex = 0; bValid && platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+	{
+		if( m_pPlatformPreprocessors[ platformIndex ] && !( loadedPlatformMask & ( 1 << platformIndex ) ) )
+		{
+			bValid = false;
+		}
+	}
+
+	if( !bValid )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"AssetPreprocessor::FetchSharedResourceData(): Shared cook cache entry for resource \"%s\" is invalid.\n",
+			*resourcePath.ToString() );
+
+		for( size_t platformIndex = 0; platformIndex < static_cast< size_t >( Cache::PLATFORM_MAX ); ++platformIndex )
+		{
+			Resource::PreprocessedData& rPreprocessedData = pResource->GetPreprocessedData(
+				static_cast< Cache::EPlatform >( platformIndex ) );
+			rPreprocessedData.persistentDataBuffer.Clear();
+			rPreprocessedData.subDataBuffers.Clear();
+			rPreprocessedData.bLoaded = false;
+		}
+
+		return false;
+	}
+
+	{
+		MutexScopeLock scopeLock( m_cookDatabaseLock );
+
+		HashMap< AssetPath, DynamicArray< String > >::Iterator dependencyIterator =
+			m_cookDependencies.Find( resourcePath );
+		if( dependencyIterator == m_cookDependencies.End() )
+		{
+			m_cookDependencies.Insert(
+				dependencyIterator,
+				HashMap< AssetPath, DynamicArray< String > >::ValueType( resourcePath, DynamicArray< String >() ) );
+		}
+
+		dependencyIterator->Second() = dependencyFiles;
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"AssetPreprocessor::FetchSharedResourceData(): Fetched resource \"%s\" from the shared cook cache.\n",
+		*resourcePath.ToString() );
 
 	return true;
 }
+
+/// Store the data of a preprocessed resource for every enabled platform in the shared cook cache.
+///
+/// This must be called after the cook inputs of the resource have been recorded (see RecordCookInputs()), as the
+/// content hashes of its dependency files are stored with the entry.  Dependency files in the data directory are
+/// stored relative to it, so that they can be checked on other machines.
+///
+/// @param[in] resourcePath  Resource path.
+/// @param[in] pResource     Resource preprocessed.
+/// @param[in] sharedKey     Shared cook cache key of the resource (see ComputeSharedCookKey()).
+///
+/// @see FetchSharedResourceData()
+void AssetPreprocessor::StoreSharedResourceData( const AssetPath &resourcePath, Resource* pResource, uint64_t sharedKey )
+{
+	HELIUM_ASSERT( pResource );
+
+	FilePath dataDirectory;
+	FileLocations::GetDataDirectory( dataDirectory );
+	const std::string& rDataDirectory = dataDirectory.Get();
+
+	DynamicArray< uint8_t > data;
+	DynamicMemoryStream stream( &data );
+
+	uint32_t version = SHARED_RESOURCE_DATA_VERSION;
+	stream.Write( &version, sizeof( version ), 1 );
+
+	{
+		MutexScopeLock scopeLock( m_cookDatabaseLock );
+		LoadCookDatabase();
+
+		const CookDatabase::Record* pRecord = m_cookDatabase.FindRecord( resourcePath );
+		if( !pRecord )
+		{
+			return;
+		}
+
+		const DynamicArray< String >& rDependencyFiles = pRecord->dependencyFiles;
+		HELIUM_ASSERT( rDependencyFiles.GetSize() <= UINT32_MAX );
+		uint32_t dependencyCount = static_cast< uint32_t >( rDependencyFiles.GetSize() );
+		stream.Write( &dependencyCount, sizeof( dependencyCount ), 1 );
+
+		for( uint32_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+		{
+			std::string dependencyPath( rDependencyFiles[ dependencyIndex ].GetData() );
+
+			uint64_t contentHash = 0;
+			if( !m_cookDatabase.HashFile( FilePath( dependencyPath ), contentHash ) )
+			{
+				contentHash = 0;
+			}
+
+			uint8_t bDataRelative =
+				( !rDataDirectory.empty() && dependencyPath.compare( 0, rDataDirectory.size(), rDataDirectory ) == 0 );
+			if( bDataRelative )
+			{
+				dependencyPath.erase( 0, rDataDirectory.size() );
+			}
+
+			stream.Write( &bDataRelative, sizeof( bDataRelative ), 1 );
+			WriteSharedBuffer( stream, dependencyPath.c_str(), dependencyPath.size() );
+			stream.Write( &contentHash, sizeof( contentHash ), 1 );
+		}
+	}
+
+	uint32_t platformCount = 0;
+	for( size_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+	{
+		if( m_pPlatformPreprocessors[ platformIndex ] )
+		{
+			++platformCount;
+		}
+	}
+
+	stream.Write( &platformCount, sizeof( platformCount ), 1 );
+
+	for( uint32_t platformIndex = 0; platformIndex < HELIUM_ARRAY_COUNT( m_pPlatformPreprocessors ); ++platformIndex )
+	{
+		if( !m_pPlatformPreprocessors[ platformIndex ] )
+		{
+			continue;
+		}
+
+		const Resource::PreprocessedData& rPreprocessedData = pResource->GetPreprocessedData(
+			static_cast< Cache::EPlatform >( platformIndex ) );
+		if( !rPreprocessedData.bLoaded )
+		{
+			return;
+		}
+
+		stream.Write( &platformIndex, sizeof( platformIndex ), 1 );
+		WriteSharedBuffer(
+			stream,
+			rPreprocessedData.persistentDataBuffer.GetData(),
+			rPreprocessedData.persistentDataBuffer.GetSize() );
+
+		const DynamicArray< DynamicArray< uint8_t > >& rSubDataBuffers = rPreprocessedData.subDataBuffers;
+		HELIUM_ASSERT( rSubDataBuffers.GetSize() <= UINT32_MAX );
+		uint32_t subDataCount = static_cast< uint32_t >( rSubDataBuffers.GetSize() );
+		stream.Write( &subDataCount, sizeof( subDataCount ), 1 );
+		for( uint32_t subDataIndex = 0; subDataIndex < subDataCount; ++subDataIndex )
+		{
+			WriteSharedBuffer( stream, rSubDataBuffers[ subDataIndex ].GetData(), rSubDataBuffers[ subDataIndex ].GetSize() );
+		}
+	}
+
+	m_sharedCookCache.Store( sharedKey, data );
+}
+
+/// Compute the shared cook cache key of a resource queued by a cook batch and fetch its data.
+///
+/// @param[in] pContext  CookResourceContext of the batch.
+/// @param[in] index     Index of the resource in the context's resource list.
+///
+/// @see EndCookBatch()
+void AssetPreprocessor::FetchSharedResourceCallback( void* pContext, size_t index )
+{
+	CookResourceContext* pCookContext = static_cast< CookResourceContext* >( pContext );
+	HELIUM_ASSERT( pCookContext );
+	HELIUM_ASSERT( pCookContext->pPreprocessor );
+
+	CookResource* pCookResource = pCookContext->ppResources[ index ];
+	HELIUM_ASSERT( pCookResource );
+
+	AssetPreprocessor* pPreprocessor = pCookContext->pPreprocessor;
+	Resource* pResource = Reflect::AssertCast< Resource >( pCookResource->spResource.Get() );
+	pCookResource->bSharedKey = pPreprocessor->ComputeSharedCookKey(
+		pCookResource->path,
+		pResource,
+		pCookResource->sharedKey );
+	pCookResource->bFetched =
+		pCookResource->bSharedKey &&
+		pPreprocessor->FetchSharedResourceData( pCookResource->path, pResource, pCookResource->sharedKey );
+}
+
+/// Store the data of a resource preprocessed by a cook batch in the shared cook cache.
+///
+/// @param[in] pContext  CookResourceContext of the batch.
+/// @param[in] index     Index of the resource in the context's resource list.
+///
+/// @see EndCookBatch()
+void AssetPreprocessor::StoreSharedResourceCallback( void* pContext, size_t index )
+{
+	CookResourceContext* pCookContext = static_cast< CookResourceContext* >( pContext );
+	HELIUM_ASSERT( pCookContext );
+	HELIUM_ASSERT( pCookContext->pPreprocessor );
+
+	CookResource* pCookResource = pCookContext->ppResources[ index ];
+	HELIUM_ASSERT( pCookResource );
+
+	Resource* pResource = Reflect::AssertCast< Resource >( pCookResource->spResource.Get() );
+	pCookContext->pPreprocessor->StoreSharedResourceData( pCookResource->path, pResource, pCookResource->sharedKey );
+}
 #endif  // HELIUM_TOOLS
@@ -2,18 +2,39 @@
 
 #include "PcSupport/PcSupport.h"
 
+#include "Platform/Locks.h"
+#include "Foundation/HashMap.h"
+
+#include "Engine/Asset.h"
 #include "Engine/Cache.h"
+#include "Engine/PrefetchManifest.h"
+#include "PcSupport/CookDatabase.h"
+#include "PcSupport/SharedCookCache.h"
 
 namespace Helium
 {
     class Asset;
     class Resource;
     class PlatformPreprocessor;
+    class ResourceHandler;
 
     /// Asset caching and resource preprocessing interface.
     class HELIUM_PC_SUPPORT_API AssetPreprocessor : NonCopyable
     {
     public:
+        /// Record of a resource handled by a cook batch.
+        struct CookRecord
+        {
+            /// Resource path.
+            AssetPath path;
+            /// Time spent preprocessing the resource, in milliseconds (zero if its data was fetched).
+            float64_t milliseconds;
+            /// True if the resource data was fetched from the shared cook cache.
+            bool bFetched;
+            /// True if the resource was preprocessed or fetched successfully.
+            bool bSuccess;
+        };
+
         /// @name Platform Preprocessor Registration
         //@{
         void SetPlatformPreprocessor( Cache::EPlatform platform, PlatformPreprocessor* pPreprocessor );
@@ -23,11 +44,30 @@ namespace Helium
         /// @name Asset Caching
         //@{
         bool CacheObject( const AssetPath &objectPath, Asset* pObject, int64_t timestamp, bool bEvictPlatformPreprocessedResourceData = true );
+        void FlushPrefetchManifests();
+        bool LayoutCachesForScenes( const AssetPath* pScenePaths, size_t sceneCount );
+        bool PackLoosePackages( const AssetPath* pPackagePaths, size_t packageCount, CompressionCodec codec );
         //@}
 
         /// @name Resource Preprocessing
         //@{
         void LoadResourceData( const AssetPath &path, Resource* pResource );
+        void AddCookDependency( Resource* pResource, const FilePath& rFilePath );
+        //@}
+
+        /// @name Shared Cook Cache
+        //@{
+        void SetSharedCookCacheDirectory( const FilePath& rDirectory );
+        void SetSharedCookCacheLocalSizeMax( uint64_t sizeMax );
+        //@}
+
+        /// @name Batch Cooking
+        //@{
+        void BeginCookBatch();
+        bool EndCookBatch();
+        inline bool IsCookBatchActive() const;
+
+        void SetCookRecords( DynamicArray< CookRecord >* pRecords );
         //@}
 
         /// @name Static Access
@@ -41,6 +81,110 @@ namespace Helium
         /// Platform-specific preprocessing support.
         PlatformPreprocessor* m_pPlatformPreprocessors[ Cache::PLATFORM_MAX ];
 
+#if HELIUM_TOOLS
+        /// Dependencies recorded for the assets of a package since its prefetch manifest was last written.
+        struct PackageDependencies
+        {
+            /// Package path.
+            AssetPath packagePath;
+            /// Records for the assets cached.
+            PrefetchManifest manifest;
+        };
+
+        /// Packages with assets cached since the prefetch manifests were last written.
+        DynamicArray< PackageDependencies > m_packageDependencies;
+
+        /// Resource queued for preprocessing by the active cook batch.
+        struct CookResource
+        {
+            /// Resource path.
+            AssetPath path;
+            /// Resource.
+            AssetPtr spResource;
+            /// Source file path.
+            String sourceFilePath;
+            /// Handler with which to preprocess the resource.
+            ResourceHandler* pHandler;
+            /// Key of the resource in the shared cook cache (valid if bSharedKey is true).
+            uint64_t sharedKey;
+            /// True if sharedKey was computed.
+            bool bSharedKey;
+            /// True if the resource data was fetched from the shared cook cache, so it does not need to be
+            /// preprocessed.
+            bool bFetched;
+            /// True if the resource was preprocessed successfully.
+            bool bSuccess;
+            /// Ticks spent preprocessing the resource.
+            uint64_t preprocessTicks;
+        };
+
+        /// Asset queued for caching by the active cook batch.
+        struct CookObject
+        {
+            /// Asset path.
+            AssetPath path;
+            /// Asset.
+            AssetPtr spObject;
+            /// Asset timestamp.
+            int64_t timestamp;
+            /// True to free the preprocessed resource data of the recached platforms once cached.
+            bool bEvictPlatformPreprocessedResourceData;
+        };
+
+        /// Cache entry built for an asset, written to its cache along with the other entries built with it.
+        struct PendingCacheEntry
+        {
+            /// Cache to update.
+            Cache* pCache;
+            /// Asset path.
+            AssetPath path;
+            /// Sub-data index.
+            uint32_t subDataIndex;
+            /// Timestamp value to associate with the entry.
+            int64_t timestamp;
+            /// Codec with which to compress the data.
+            CompressionCodec codec;
+            /// Data owned by the entry (used if pExternalData is null).
+            DynamicArray< uint8_t > data;
+            /// Data owned by a resource, which must be kept in memory until the entry is written.
+            const DynamicArray< uint8_t >* pExternalData;
+        };
+
+        /// Context passed to the parallel resource preprocessing callback.
+        struct CookResourceContext
+        {
+            /// Asset preprocessor.
+            AssetPreprocessor* pPreprocessor;
+            /// Resources to preprocess.
+            CookResource* const* ppResources;
+        };
+
+        /// True while a cook batch is active.
+        bool m_bCookBatchActive;
+        /// Resources queued for preprocessing by the active cook batch.
+        DynamicArray< CookResource > m_cookResources;
+        /// Assets queued for caching by the active cook batch.
+        DynamicArray< CookObject > m_cookObjects;
+        /// Index in m_cookResources of each queued resource.
+        HashMap< AssetPath, size_t > m_cookResourceIndices;
+        /// Index in m_cookObjects of each queued asset.
+        HashMap< AssetPath, size_t > m_cookObjectIndices;
+        /// Array to which to append a record of each resource handled by a cook batch (if not null).
+        DynamicArray< CookRecord >* m_pCookRecords;
+
+        /// Input hashes of the resources preprocessed by previous runs.
+        CookDatabase m_cookDatabase;
+        /// Files added with AddCookDependency() for each resource being preprocessed.
+        HashMap< AssetPath, DynamicArray< String > > m_cookDependencies;
+        /// Mutex synchronizing access to the cook database and the dependencies being recorded.
+        Mutex m_cookDatabaseLock;
+        /// True once loading of the cook database has been attempted.
+        bool m_bCookDatabaseLoaded;
+
+        /// Resource data shared with other machines.
+        SharedCookCache m_sharedCookCache;
+#endif
+
         /// Singleton instance.
         static AssetPreprocessor* sm_pInstance;
 
@@ -54,10 +198,38 @@ namespace Helium
         //@{
 #if HELIUM_TOOLS
         bool LoadCachedResourceData( const AssetPath &path, Resource* pResource, Cache::EPlatform platform );
+        bool NeedsPreprocessing( const AssetPath &path, Resource* pResource, String& rSourceFilePath );
+        bool GetResourceSourcePaths(
+            const AssetPath &path, Resource* pResource, AssetPath& rBaseResourcePath, FilePath& rSourceFilePath );
+
+        bool ComputeInputHash(
+            const AssetPath &path, Resource* pResource, const DynamicArray< String >& rDependencyFiles, uint64_t& rHash );
+        void RecordCookInputs( const AssetPath &path, Resource* pResource, bool bSuccess );
+        void LoadCookDatabase();
+        void SaveCookDatabase();
         bool PreprocessResource( const AssetPath &path, Resource* pResource, const String& rSourceFilePath );
+        ResourceHandler* BeginPreprocessResource( const AssetPath &path, Resource* pResource );
+        void FinishPreprocessResource( Resource* pResource );
+
+        uint32_t BuildCacheEntries(
+            const AssetPath &objectPath, Asset* pObject, int64_t timestamp, DynamicArray< PendingCacheEntry >& rEntries );
+        bool CommitCacheEntries( const DynamicArray< PendingCacheEntry >& rEntries );
+        void FinishCachedObject( Asset* pObject, uint32_t recachedPlatformMask, bool bEvictPlatformPreprocessedResourceData );
+
+        static void CookResourceCallback( void* pContext, size_t index );
+
+        bool ComputeSharedCookKey( const AssetPath &path, Resource* pResource, uint64_t& rKey );
+        bool FetchSharedResourceData( const AssetPath &path, Resource* pResource, uint64_t sharedKey );
+        void StoreSharedResourceData( const AssetPath &path, Resource* pResource, uint64_t sharedKey );
+
+        static void FetchSharedResourceCallback( void* pContext, size_t index );
+        static void StoreSharedResourceCallback( void* pContext, size_t index );
 
         uint32_t LoadPersistentResourceData(
             AssetPath resourcePath, Cache::EPlatform platform, DynamicArray< uint8_t >& rPersistentDataBuffer );
+
+        void RecordDependencies( AssetPath objectPath, const DynamicArray< AssetPath >& rDependencies );
+        bool LoadPrefetchManifest( Cache* pCache, AssetPath packagePath, PrefetchManifest& rManifest );
 #endif
         //@}
     };
@@ -13,4 +13,18 @@ namespace Helium
 
         return m_pPlatformPreprocessors[ platform ];
     }
+
+    /// Get whether a cook batch is active.
+    ///
+    /// @return  True if resource preprocessing and asset caching are being queued for a cook batch, false if not.
+    ///
+    /// @see BeginCookBatch(), EndCookBatch()
+    bool AssetPreprocessor::IsCookBatchActive() const
+    {
+#if HELIUM_TOOLS
+        return m_bCookBatchActive;
+#else
+        return false;
+#endif
+    }
 }
@@ -0,0 +1,460 @@
+#include "Precompile.h"
+#include "PcSupport/CookDatabase.h"
+
+#include "Platform/File.h"
+#include "Foundation/FileStream.h"
+#include "Foundation/Stream.h"
+#include "Engine/Cache.h"
+#include "Engine/FileLocations.h"
+
+using namespace Helium;
+
+/// Read a value from a database buffer, advancing the read position.
+///
+/// @param[out]    rValue    Value read.
+/// @param[in,out] rpCurrent Current read position.
+/// @param[in]     pEnd      End of the database buffer.
+///
+/// @return  True if the value was read, false if the end of the buffer was reached.
+template< typename T >
+static bool ReadDatabaseValue( T& rValue, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+{
+	if( static_cast< size_t >( pEnd - rpCurrent ) < sizeof( T ) )
+	{
+		return false;
+	}
+
+	MemoryCopy( &rValue, rpCurrent, sizeof( T ) );
+	rpCurrent += sizeof( T );
+
+	return true;
+}
+
+/// Read a length-prefixed string from a database buffer, advancing the read position.
+///
+/// @param[out]    rString   String read.
+/// @param[in,out] rpCurrent Current read position.
+/// @param[in]     pEnd      End of the database buffer.
+///
+/// @return  True if the string was read, false if the end of the buffer was reached.
+static bool ReadDatabaseString( String& rString, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+{
+	uint32_t length = 0;
+	if( !ReadDatabaseValue( length, rpCurrent, pEnd ) || length > static_cast< size_t >( pEnd - rpCurrent ) )
+	{
+		return false;
+	}
+
+	rString = String( reinterpret_cast< const char* >( rpCurrent ), length );
+	rpCurrent += length;
+
+	return true;
+}
+
+/// Write a length-prefixed string to a database stream.
+///
+/// @param[in] rStream  Stream to write to.
+/// @param[in] rString  String to write.
+static void WriteDatabaseString( Stream& rStream, const String& rString )
+{
+	uint32_t length = static_cast< uint32_t >( rString.GetSize() );
+	rStream.Write( &length, sizeof( length ), 1 );
+	rStream.Write( rString.GetData(), sizeof( char ), length );
+}
+
+/// Constructor.
+CookDatabase::CookDatabase()
+	: m_bDirty( false )
+{
+}
+
+/// Remove all records from this database.
+void CookDatabase::Clear()
+{
+	m_records.Clear();
+	m_files.Clear();
+	m_bDirty = false;
+}
+
+/// Find the record of a resource.
+///
+/// @param[in] resourcePath  Resource path.
+///
+/// @return  Resource record, or null if the resource has no record.
+const CookDatabase::Record* CookDatabase::FindRecord( AssetPath resourcePath ) const
+{
+	HashMap< AssetPath, Record >::ConstIterator recordIterator = m_records.Find( resourcePath );
+
+	return ( recordIterator != m_records.End() ? &recordIterator->Second() : NULL );
+}
+
+/// Set the record of a resource, replacing any record it already has.
+///
+/// @param[in] resourcePath  Resource path.
+/// @param[in] rRecord       Resource record.
+void CookDatabase::SetRecord( AssetPath resourcePath, const Record& rRecord )
+{
+	HELIUM_ASSERT( !resourcePath.IsEmpty() );
+
+	m_bDirty = true;
+
+	HashMap< AssetPath, Record >::Iterator recordIterator = m_records.Find( resourcePath );
+	if( recordIterator != m_records.End() )
+	{
+		recordIterator->Second() = rRecord;
+		return;
+	}
+
+	m_records.Insert( recordIterator, HashMap< AssetPath, Record >::ValueType( resourcePath, rRecord ) );
+}
+
+/// Remove the record of a resource, so that it is preprocessed again the next time it is checked.
+///
+/// @param[in] resourcePath  Resource path.
+void CookDatabase::RemoveRecord( AssetPath resourcePath )
+{
+	HashMap< AssetPath, Record >::Iterator recordIterator = m_records.Find( resourcePath );
+	if( recordIterator != m_records.End() )
+	{
+		m_records.Remove( recordIterator );
+		m_bDirty = true;
+	}
+}
+
+/// Get the content hash of an input file.
+///
+/// The hash recorded for the file is returned as long as its time stamp and size have not changed.  Otherwise, the
+/// file is read and hashed again.
+///
+/// @param[in]  rPath  File path.
+/// @param[out] rHash  Content hash of the file.
+///
+/// @return  True if the hash was determined, false if the file does not exist or could not be read.
+bool CookDatabase::HashFile( const FilePath& rPath, uint64_t& rHash )
+{
+	Status stat;
+	if( !stat.Read( rPath.Data() ) )
+	{
+		return false;
+	}
+
+	Name pathName( rPath.Data() );
+	HashMap< Name, FileRecord >::Iterator fileIterator = m_files.Find( pathName );
+	if( fileIterator != m_files.End() )
+	{
+		const FileRecord& rFileRecord = fileIterator->Second();
+		if( rFileRecord.timestamp == stat.m_ModifiedTime && rFileRecord.size == stat.m_Size )
+		{
+			rHash = rFileRecord.hash;
+
+			return true;
+		}
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"CookDatabase::HashFile(): Failed to open \"%s\" for reading.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	int64_t size64 = pFileStream->GetSize();
+	if( size64 < 0 || static_cast< uint64_t >( size64 ) > static_cast< size_t >( -1 ) )
+	{
+		delete pFileStream;
+
+		return false;
+	}
+
+	DynamicArray< uint8_t > data;
+	data.Resize( static_cast< size_t >( size64 ) );
+	size_t bytesRead = pFileStream->Read( data.GetData(), 1, data.GetSize() );
+
+	delete pFileStream;
+
+	if( bytesRead != data.GetSize() )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"CookDatabase::HashFile(): Failed to read \"%s\".\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	FileRecord fileRecord;
+	fileRecord.timestamp = stat.m_ModifiedTime;
+	fileRecord.size = static_cast< uint64_t >( size64 );
+	fileRecord.hash = Cache::ComputeContentHash( data.GetData(), data.GetSize() );
+
+	if( fileIterator != m_files.End() )
+	{
+		fileIterator->Second() = fileRecord;
+	}
+	else
+	{
+		m_files.Insert( fileIterator, HashMap< Name, FileRecord >::ValueType( pathName, fileRecord ) );
+	}
+
+	m_bDirty = true;
+	rHash = fileRecord.hash;
+
+	return true;
+}
+
+/// Write this database to a stream.
+///
+/// @param[in] rStream  Stream to write to.
+///
+/// @see Read()
+void CookDatabase::Write( Stream& rStream ) const
+{
+	uint32_t version = VERSION;
+	rStream.Write( &version, sizeof( version ), 1 );
+
+	HELIUM_ASSERT( m_records.GetSize() <= UINT32_MAX );
+	uint32_t recordCount = static_cast< uint32_t >( m_records.GetSize() );
+	rStream.Write( &recordCount, sizeof( recordCount ), 1 );
+
+	for( HashMap< AssetPath, Record >::ConstIterator recordIterator = m_records.Begin();
+		recordIterator != m_records.End(); ++recordIterator )
+	{
+		const Record& rRecord = recordIterator->Second();
+
+		WriteDatabaseString( rStream, recordIterator->First().ToString() );
+		rStream.Write( &rRecord.inputHash, sizeof( rRecord.inputHash ), 1 );
+
+		HELIUM_ASSERT( rRecord.dependencyFiles.GetSize() <= UINT32_MAX );
+		uint32_t dependencyCount = static_cast< uint32_t >( rRecord.dependencyFiles.GetSize() );
+		rStream.Write( &dependencyCount, sizeof( dependencyCount ), 1 );
+		for( uint32_t dependencyIndex = 0; dependencyIndex < dependencyCount; ++dependencyIndex )
+		{
+			WriteDatabaseString( rStream, rRecord.dependencyFiles[ dependencyIndex ] );
+		}
+	}
+
+	HELIUM_ASSERT( m_files.GetSize() <= UINT32_MAX );
+	uint32_t fileCount = static_cast< uint32_t >( m_files.GetSize() );
+	rStream.Write( &fileCount, sizeof( fileCount ), 1 );
+
+	for( HashMap< Name, FileRecord >::ConstIterator fileIterator = m_files.Begin();
+		fileIterator != m_files.End(); ++fileIterator )
+	{
+		const FileRecord& rFileRecord = fileIterator->Second();
+
+		WriteDatabaseString( rStream, String( *fileIterator->First() ) );
+		rStream.Write( &rFileRecord.timestamp, sizeof( rFileRecord.timestamp ), 1 );
+		rStream.Write( &rFileRecord.size, sizeof( rFileRecord.size ), 1 );
+		rStream.Write( &rFileRecord.hash, sizeof( rFileRecord.hash ), 1 );
+	}
+}
+
+/// Replace the contents of this database with those read from a buffer.
+///
+/// @param[in] pData  Database data.
+/// @param[in] size   Size of the database data, in bytes.
+///
+/// @return  True if the database was read successfully, false if it is invalid (in which case this database is left
+///          empty).
+///
+/// @see Write()
+bool CookDatabase::Read( const uint8_t* pData, size_t size )
+{
+	HELIUM_ASSERT( pData || size == 0 );
+
+	Clear();
+
+	const uint8_t* pCurrent = pData;
+	const uint8_t* pEnd = pData + size;
+
+	uint32_t version = 0;
+	if( !ReadDatabaseValue( version, pCurrent, pEnd ) || version != VERSION )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"CookDatabase::Read(): Database version %" PRIu32 " does not match the current version (%" PRIu32 ").\n",
+			version,
+			VERSION );
+
+		return false;
+	}
+
+	uint32_t recordCount = 0;
+	if( !ReadDatabaseValue( recordCount, pCurrent, pEnd ) )
+	{
+		return false;
+	}
+
+	String pathString;
+	for( uint32_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+	{
+		AssetPath resourcePath;
+		Record record;
+		uint32_t dependencyCount = 0;
+		bool bValid =
+			ReadDatabaseString( pathString, pCurrent, pEnd ) &&
+			resourcePath.Set( pathString ) &&
+			ReadDatabaseValue( record.inputHash, pCurrent, pEnd ) &&
+			ReadDatabaseValue( dependencyCount, pCurrent, pEnd );
+
+		for( uint32_t dependencyIndex = 0; bValid && dependencyIndex < dependencyCount; ++dependencyIndex )
+		{
+			String* pDependencyFile = record.dependencyFiles.New();
+			HELIUM_ASSERT( pDependencyFile );
+			bValid = ReadDatabaseString( *pDependencyFile, pCurrent, pEnd );
+		}
+
+		if( !bValid )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "CookDatabase::Read(): Database is truncated.\n" );
+
+			Clear();
+
+			return false;
+		}
+
+		SetRecord( resourcePath, record );
+	}
+
+	uint32_t fileCount = 0;
+	if( !ReadDatabaseValue( fileCount, pCurrent, pEnd ) )
+	{
+		Clear();
+
+		return false;
+	}
+
+	for( uint32_t fileIndex = 0; fileIndex < fileCount; ++fileIndex )
+	{
+		FileRecord fileRecord;
+		if( !ReadDatabaseString( pathString, pCurrent, pEnd ) ||
+			!ReadDatabaseValue( fileRecord.timestamp, pCurrent, pEnd ) ||
+			!ReadDatabaseValue( fileRecord.size, pCurrent, pEnd ) ||
+			!ReadDatabaseValue( fileRecord.hash, pCurrent, pEnd ) ||
+			pathString.IsEmpty() )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "CookDatabase::Read(): Database is truncated.\n" );
+
+			Clear();
+
+			return false;
+		}
+
+		Name pathName( pathString );
+		HashMap< Name, FileRecord >::Iterator fileIterator = m_files.Find( pathName );
+		if( fileIterator == m_files.End() )
+		{
+			m_files.Insert( fileIterator, HashMap< Name, FileRecord >::ValueType( pathName, fileRecord ) );
+		}
+	}
+
+	m_bDirty = false;
+
+	return true;
+}
+
+/// Replace the contents of this database with those of a database file.
+///
+/// @param[in] rPath  Database file path.
+///
+/// @return  True if the database file was read successfully, false if it does not exist or is invalid (in which case
+///          this database is left empty).
+///
+/// @see SaveToFile()
+bool CookDatabase::LoadFromFile( const FilePath& rPath )
+{
+	Clear();
+
+	if( !rPath.Exists() )
+	{
+		return false;
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"CookDatabase::LoadFromFile(): Failed to open \"%s\" for reading.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	int64_t size64 = pFileStream->GetSize();
+	if( size64 < 0 || static_cast< uint64_t >( size64 ) > static_cast< size_t >( -1 ) )
+	{
+		delete pFileStream;
+
+		return false;
+	}
+
+	DynamicArray< uint8_t > data;
+	data.Resize( static_cast< size_t >( size64 ) );
+	size_t bytesRead = pFileStream->Read( data.GetData(), 1, data.GetSize() );
+
+	delete pFileStream;
+
+	if( bytesRead != data.GetSize() )
+	{
+		return false;
+	}
+
+	return Read( data.GetData(), data.GetSize() );
+}
+
+/// Write this database to a file.
+///
+/// @param[in] rPath  Database file path.
+///
+/// @return  True if the database was written successfully, false if not.
+///
+/// @see LoadFromFile()
+bool CookDatabase::SaveToFile( const FilePath& rPath )
+{
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"CookDatabase::SaveToFile(): Failed to open \"%s\" for writing.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+		Write( bufferedStream );
+	}
+
+	delete pFileStream;
+
+	m_bDirty = false;
+
+	return true;
+}
+
+/// Get the path of the cook database file.
+///
+/// The database is kept in the user data directory, next to the package indices.
+///
+/// @param[out] rPath  Database file path.
+///
+/// @return  True if the path was determined, false if no user data directory is available.
+bool CookDatabase::GetDatabaseFilePath( FilePath& rPath )
+{
+	FilePath userDirectory;
+	if( !FileLocations::GetUserDirectory( userDirectory ) )
+	{
+		return false;
+	}
+
+	rPath = FilePath( userDirectory.Get() + "CookDatabase.db" );
+
+	return true;
+}
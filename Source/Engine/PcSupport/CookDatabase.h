@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/HashMap.h"
+
+#include "Engine/AssetPath.h"
+#include "PcSupport/PcSupport.h"
+
+namespace Helium
+{
+	class Stream;
+
+	/// Inputs of every preprocessed resource, saved between runs so that a resource is only preprocessed again once
+	/// the combined hash of its inputs changes.
+	///
+	/// Besides the resource records, the database keeps the content hash of every input file it has hashed, which is
+	/// reused while the file's time stamp and size are the same as when it was hashed.
+	class HELIUM_PC_SUPPORT_API CookDatabase
+	{
+	public:
+		/// Database format version.
+		static const uint32_t VERSION = 1;
+
+		/// Inputs recorded for a preprocessed resource.
+		struct Record
+		{
+			/// Combined hash of every input, also stored in place of a time stamp in the resource's cache entries.
+			uint64_t inputHash;
+			/// Files read while preprocessing besides the resource's own source and object files (such as shader
+			/// includes).
+			DynamicArray< String > dependencyFiles;
+		};
+
+		/// @name Construction/Destruction
+		//@{
+		CookDatabase();
+		//@}
+
+		/// @name Record Access
+		//@{
+		void Clear();
+		const Record* FindRecord( AssetPath resourcePath ) const;
+		void SetRecord( AssetPath resourcePath, const Record& rRecord );
+		void RemoveRecord( AssetPath resourcePath );
+
+		bool HashFile( const FilePath& rPath, uint64_t& rHash );
+
+		inline bool IsDirty() const;
+		//@}
+
+		/// @name Serialization
+		//@{
+		void Write( Stream& rStream ) const;
+		bool Read( const uint8_t* pData, size_t size );
+
+		bool LoadFromFile( const FilePath& rPath );
+		bool SaveToFile( const FilePath& rPath );
+
+		static bool GetDatabaseFilePath( FilePath& rPath );
+		//@}
+
+	private:
+		/// Content hash of an input file.
+		struct FileRecord
+		{
+			/// File time stamp when hashed.
+			int64_t timestamp;
+			/// File size when hashed.
+			uint64_t size;
+			/// Content hash.
+			uint64_t hash;
+		};
+
+		/// Resource records by resource path.
+		HashMap< AssetPath, Record > m_records;
+		/// Input file hashes by file path.
+		HashMap< Name, FileRecord > m_files;
+		/// True if the database has changed since it was loaded or saved.
+		bool m_bDirty;
+	};
+}
+
+#include "PcSupport/CookDatabase.inl"
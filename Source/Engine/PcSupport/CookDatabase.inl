@@ -0,0 +1,9 @@
+/// Get whether this database has changed since it was loaded or last saved.
+///
+/// @return  True if the database should be saved, false if not.
+///
+/// @see SaveToFile()
+bool Helium::CookDatabase::IsDirty() const
+{
+    return m_bDirty;
+}
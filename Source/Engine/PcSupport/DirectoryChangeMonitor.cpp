@@ -0,0 +1,438 @@
+#include "Precompile.h"
+#include "PcSupport/DirectoryChangeMonitor.h"
+
+#include "Platform/Thread.h"
+
+#if HELIUM_OS_WIN
+#include <windows.h>
+#elif HELIUM_OS_LINUX
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace Helium;
+
+/// Add a watch ID to a list of changed watches if it is not already in it.
+///
+/// @param[in] rChangedWatchIds  List of changed watch IDs.
+/// @param[in] watchId           Watch ID to add.
+static void AddChangedWatch( DynamicArray< uint32_t >& rChangedWatchIds, uint32_t watchId )
+{
+	size_t changedCount = rChangedWatchIds.GetSize();
+	for( size_t changedIndex = 0; changedIndex < changedCount; ++changedIndex )
+	{
+		if( rChangedWatchIds[ changedIndex ] == watchId )
+		{
+			return;
+		}
+	}
+
+	rChangedWatchIds.Push( watchId );
+}
+
+#if HELIUM_OS_WIN
+
+/// Size of the buffer each watch receives change records into.  Only whether a change happened matters, so this is
+/// kept small; a buffer overflow is reported like any other change.
+static const DWORD WATCH_BUFFER_SIZE = 4096;
+
+/// Notification filter for directory watches.
+static const DWORD WATCH_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+/// Directory watch state.
+struct DirectoryChangeMonitor::PlatformWatch
+{
+	/// Watch ID.
+	uint32_t id;
+	/// Directory handle.
+	HANDLE hDirectory;
+	/// Overlapped read state (its event is signaled when changes are reported).
+	OVERLAPPED overlapped;
+	/// Change record buffer (DWORD-aligned, as ReadDirectoryChangesW requires).
+	DWORD buffer[ WATCH_BUFFER_SIZE / sizeof( DWORD ) ];
+};
+
+/// Start an asynchronous read of the next changes to a watched directory.
+///
+/// @param[in] hDirectory   Watched directory handle.
+/// @param[in] rOverlapped  Overlapped read state of the watch.
+/// @param[in] pBuffer      Change record buffer of the watch.
+///
+/// @return  True if the read was started, false if not.
+static bool IssueWatchRead( HANDLE hDirectory, OVERLAPPED& rOverlapped, void* pBuffer )
+{
+	return ( ReadDirectoryChangesW( hDirectory, pBuffer, WATCH_BUFFER_SIZE, FALSE, WATCH_FILTER, NULL, &rOverlapped, NULL ) != FALSE );
+}
+
+/// Constructor.
+DirectoryChangeMonitor::DirectoryChangeMonitor()
+	: m_nextWatchId( 0 )
+{
+}
+
+/// Destructor.
+DirectoryChangeMonitor::~DirectoryChangeMonitor()
+{
+	while( !m_watches.IsEmpty() )
+	{
+		UnwatchDirectory( m_watches.GetLast()->id );
+	}
+}
+
+/// Get whether the operating system reports directory changes to this monitor.
+///
+/// @return  True if changes are reported, false if callers have to poll for them.
+bool DirectoryChangeMonitor::IsAvailable() const
+{
+	return true;
+}
+
+/// Start watching a directory for changes.
+///
+/// @param[in] rDirectory  Directory to watch.
+///
+/// @return  ID of the new watch, or an invalid index if the directory could not be watched.
+///
+/// @see UnwatchDirectory()
+uint32_t DirectoryChangeMonitor::WatchDirectory( const FilePath& rDirectory )
+{
+	HANDLE hDirectory = CreateFileA(
+		rDirectory.Data(),
+		FILE_LIST_DIRECTORY,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL,
+		OPEN_EXISTING,
+		FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+		NULL );
+	if( hDirectory == INVALID_HANDLE_VALUE )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"DirectoryChangeMonitor::WatchDirectory(): Failed to open \"%s\" (error %u).\n",
+			rDirectory.Data(),
+			static_cast< uint32_t >( GetLastError() ) );
+
+		return Invalid< uint32_t >();
+	}
+
+	PlatformWatch* pWatch = new PlatformWatch;
+	HELIUM_ASSERT( pWatch );
+	MemoryZero( &pWatch->overlapped, sizeof( pWatch->overlapped ) );
+	pWatch->hDirectory = hDirectory;
+	pWatch->overlapped.hEvent = CreateEvent( NULL, TRUE, FALSE, NULL );
+
+	if( !pWatch->overlapped.hEvent || !IssueWatchRead( hDirectory, pWatch->overlapped, pWatch->buffer ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"DirectoryChangeMonitor::WatchDirectory(): Failed to watch \"%s\" (error %u).\n",
+			rDirectory.Data(),
+			static_cast< uint32_t >( GetLastError() ) );
+
+		if( pWatch->overlapped.hEvent )
+		{
+			CloseHandle( pWatch->overlapped.hEvent );
+		}
+
+		CloseHandle( hDirectory );
+		delete pWatch;
+
+		return Invalid< uint32_t >();
+	}
+
+	pWatch->id = m_nextWatchId;
+	m_nextWatchId = ( m_nextWatchId + 1 ) % Invalid< uint32_t >();
+	m_watches.Push( pWatch );
+
+	return pWatch->id;
+}
+
+/// Stop watching a directory.
+///
+/// @param[in] watchId  ID of the watch to remove, as returned by WatchDirectory().
+///
+/// @see WatchDirectory()
+void DirectoryChangeMonitor::UnwatchDirectory( uint32_t watchId )
+{
+	size_t watchCount = m_watches.GetSize();
+	for( size_t watchIndex = 0; watchIndex < watchCount; ++watchIndex )
+	{
+		PlatformWatch* pWatch = m_watches[ watchIndex ];
+		HELIUM_ASSERT( pWatch );
+		if( pWatch->id != watchId )
+		{
+			continue;
+		}
+
+		// The pending read has to finish before its buffer and overlapped state can be released.
+		DWORD bytesTransferred = 0;
+		CancelIo( pWatch->hDirectory );
+		GetOverlappedResult( pWatch->hDirectory, &pWatch->overlapped, &bytesTransferred, TRUE );
+
+		CloseHandle( pWatch->overlapped.hEvent );
+		CloseHandle( pWatch->hDirectory );
+		delete pWatch;
+
+		m_watches.RemoveSwap( watchIndex );
+
+		return;
+	}
+}
+
+/// Wait for changes to any of the watched directories.
+///
+/// @param[in]  timeoutMilliseconds  Maximum time to wait, in milliseconds.
+/// @param[out] rChangedWatchIds     IDs of the watches whose directories changed are added to this list.  If the
+///                                  changes to a directory could not all be recorded, an invalid index is added, in
+///                                  which case every watched directory should be treated as changed.
+///
+/// @return  True if any changes were reported, false if the wait timed out.
+bool DirectoryChangeMonitor::WaitForChanges( uint32_t timeoutMilliseconds, DynamicArray< uint32_t >& rChangedWatchIds )
+{
+	size_t watchCount = m_watches.GetSize();
+	if( watchCount == 0 || watchCount > MAXIMUM_WAIT_OBJECTS )
+	{
+		// Too many watches to wait on at once, so sleep and check each of them afterward.
+		Thread::Sleep( timeoutMilliseconds );
+	}
+	else
+	{
+		HANDLE events[ MAXIMUM_WAIT_OBJECTS ];
+		for( size_t watchIndex = 0; watchIndex < watchCount; ++watchIndex )
+		{
+			events[ watchIndex ] = m_watches[ watchIndex ]->overlapped.hEvent;
+		}
+
+		DWORD waitResult = WaitForMultipleObjects( static_cast< DWORD >( watchCount ), events, FALSE, timeoutMilliseconds );
+		if( waitResult == WAIT_TIMEOUT )
+		{
+			return false;
+		}
+	}
+
+	bool bChanged = false;
+	for( size_t watchIndex = 0; watchIndex < watchCount; ++watchIndex )
+	{
+		PlatformWatch* pWatch = m_watches[ watchIndex ];
+		HELIUM_ASSERT( pWatch );
+
+		DWORD bytesTransferred = 0;
+		if( !GetOverlappedResult( pWatch->hDirectory, &pWatch->overlapped, &bytesTransferred, FALSE ) &&
+			GetLastError() == ERROR_IO_INCOMPLETE )
+		{
+			continue;
+		}
+
+		// No bytes transferred means the change records did not fit in the buffer.
+		AddChangedWatch( rChangedWatchIds, bytesTransferred != 0 ? pWatch->id : Invalid< uint32_t >() );
+		bChanged = true;
+
+		if( !IssueWatchRead( pWatch->hDirectory, pWatch->overlapped, pWatch->buffer ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"DirectoryChangeMonitor::WaitForChanges(): Failed to restart watch %" PRIu32 " (error %u).\n",
+				pWatch->id,
+				static_cast< uint32_t >( GetLastError() ) );
+		}
+	}
+
+	return bChanged;
+}
+
+#elif HELIUM_OS_LINUX
+
+/// Events that count as a change to a watched directory.
+static const uint32_t WATCH_EVENT_MASK =
+	IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB;
+
+/// Constructor.
+DirectoryChangeMonitor::DirectoryChangeMonitor()
+	: m_inotifyFd( inotify_init1( IN_NONBLOCK | IN_CLOEXEC ) )
+{
+	if( m_inotifyFd < 0 )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"DirectoryChangeMonitor::DirectoryChangeMonitor(): inotify is not available (errno %d).\n",
+			errno );
+	}
+}
+
+/// Destructor.
+DirectoryChangeMonitor::~DirectoryChangeMonitor()
+{
+	if( m_inotifyFd >= 0 )
+	{
+		close( m_inotifyFd );
+	}
+}
+
+/// Get whether the operating system reports directory changes to this monitor.
+///
+/// @return  True if changes are reported, false if callers have to poll for them.
+bool DirectoryChangeMonitor::IsAvailable() const
+{
+	return ( m_inotifyFd >= 0 );
+}
+
+/// Start watching a directory for changes.
+///
+/// @param[in] rDirectory  Directory to watch.
+///
+/// @return  ID of the new watch, or an invalid index if the directory could not be watched.
+///
+/// @see UnwatchDirectory()
+uint32_t DirectoryChangeMonitor::WatchDirectory( const FilePath& rDirectory )
+{
+	if( m_inotifyFd < 0 )
+	{
+		return Invalid< uint32_t >();
+	}
+
+	int watchDescriptor = inotify_add_watch( m_inotifyFd, rDirectory.Data(), WATCH_EVENT_MASK | IN_ONLYDIR );
+	if( watchDescriptor < 0 )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"DirectoryChangeMonitor::WatchDirectory(): Failed to watch \"%s\" (errno %d).\n",
+			rDirectory.Data(),
+			errno );
+
+		return Invalid< uint32_t >();
+	}
+
+	return static_cast< uint32_t >( watchDescriptor );
+}
+
+/// Stop watching a directory.
+///
+/// @param[in] watchId  ID of the watch to remove, as returned by WatchDirectory().
+///
+/// @see WatchDirectory()
+void DirectoryChangeMonitor::UnwatchDirectory( uint32_t watchId )
+{
+	if( m_inotifyFd >= 0 && IsValid( watchId ) )
+	{
+		inotify_rm_watch( m_inotifyFd, static_cast< int >( watchId ) );
+	}
+}
+
+/// Wait for changes to any of the watched directories.
+///
+/// @param[in]  timeoutMilliseconds  Maximum time to wait, in milliseconds.
+/// @param[out] rChangedWatchIds     IDs of the watches whose directories changed are added to this list.  If the
+///                                  changes to a directory could not all be recorded, an invalid index is added, in
+///                                  which case every watched directory should be treated as changed.
+///
+/// @return  True if any changes were reported, false if the wait timed out.
+bool DirectoryChangeMonitor::WaitForChanges( uint32_t timeoutMilliseconds, DynamicArray< uint32_t >& rChangedWatchIds )
+{
+	if( m_inotifyFd < 0 )
+	{
+		Thread::Sleep( timeoutMilliseconds );
+
+		return false;
+	}
+
+	pollfd pollDescriptor;
+	pollDescriptor.fd = m_inotifyFd;
+	pollDescriptor.events = POLLIN;
+	pollDescriptor.revents = 0;
+	if( poll( &pollDescriptor, 1, static_cast< int >( timeoutMilliseconds ) ) <= 0 )
+	{
+		return false;
+	}
+
+	bool bChanged = false;
+
+	// Drain every queued event; the descriptor is non-blocking, so the read fails once the queue is empty.
+	uint8_t buffer[ 4096 ] __attribute__( ( aligned( __alignof__( inotify_event ) ) ) );
+	for( ; ; )
+	{
+		ssize_t bytesRead = read( m_inotifyFd, buffer, sizeof( buffer ) );
+		if( bytesRead <= 0 )
+		{
+			break;
+		}
+
+		const uint8_t* pCurrent = buffer;
+		const uint8_t* pEnd = buffer + bytesRead;
+		while( pCurrent < pEnd )
+		{
+			const inotify_event* pEvent = reinterpret_cast< const inotify_event* >( pCurrent );
+			pCurrent += sizeof( inotify_event ) + pEvent->len;
+
+			if( pEvent->mask & IN_Q_OVERFLOW )
+			{
+				AddChangedWatch( rChangedWatchIds, Invalid< uint32_t >() );
+				bChanged = true;
+			}
+			else if( !( pEvent->mask & IN_IGNORED ) && pEvent->wd >= 0 )
+			{
+				AddChangedWatch( rChangedWatchIds, static_cast< uint32_t >( pEvent->wd ) );
+				bChanged = true;
+			}
+		}
+	}
+
+	return bChanged;
+}
+
+#else
+
+/// Constructor.
+DirectoryChangeMonitor::DirectoryChangeMonitor()
+{
+}
+
+/// Destructor.
+DirectoryChangeMonitor::~DirectoryChangeMonitor()
+{
+}
+
+/// Get whether the operating system reports directory changes to this monitor.
+///
+/// @return  True if changes are reported, false if callers have to poll for them.
+bool DirectoryChangeMonitor::IsAvailable() const
+{
+	return false;
+}
+
+/// Start watching a directory for changes.
+///
+/// @param[in] rDirectory  Directory to watch.
+///
+/// @return  ID of the new watch, or an invalid index if the directory could not be watched.
+///
+/// @see UnwatchDirectory()
+uint32_t DirectoryChangeMonitor::WatchDirectory( const FilePath& /*rDirectory*/ )
+{
+	return Invalid< uint32_t >();
+}
+
+/// Stop watching a directory.
+///
+/// @param[in] watchId  ID of the watch to remove, as returned by WatchDirectory().
+///
+/// @see WatchDirectory()
+void DirectoryChangeMonitor::UnwatchDirectory( uint32_t /*watchId*/ )
+{
+}
+
+/// Wait for changes to any of the watched directories.
+///
+/// @param[in]  timeoutMilliseconds  Maximum time to wait, in milliseconds.
+/// @param[out] rChangedWatchIds     IDs of the watches whose directories changed are added to this list.
+///
+/// @return  True if any changes were reported, false if the wait timed out.
+bool DirectoryChangeMonitor::WaitForChanges( uint32_t timeoutMilliseconds, DynamicArray< uint32_t >& /*rChangedWatchIds*/ )
+{
+	Thread::Sleep( timeoutMilliseconds );
+
+	return false;
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+
+#include "PcSupport/PcSupport.h"
+
+namespace Helium
+{
+	/// Waits for the operating system to report changes to the files in a set of directories, so that they only have
+	/// to be scanned when something in them has actually changed.
+	///
+	/// Changes are reported with inotify on Linux and ReadDirectoryChangesW on Windows.  Where no backend is available,
+	/// IsAvailable() returns false and WaitForChanges() only sleeps, so callers have to fall back to polling.  Only the
+	/// watched directories themselves are monitored, not their subdirectories.
+	///
+	/// A monitor is not thread-safe, and on Windows it must be used from the thread that created it.
+	class HELIUM_PC_SUPPORT_API DirectoryChangeMonitor : public NonCopyable
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		DirectoryChangeMonitor();
+		~DirectoryChangeMonitor();
+		//@}
+
+		/// @name Directory Watching
+		//@{
+		bool IsAvailable() const;
+
+		uint32_t WatchDirectory( const FilePath& rDirectory );
+		void UnwatchDirectory( uint32_t watchId );
+
+		bool WaitForChanges( uint32_t timeoutMilliseconds, DynamicArray< uint32_t >& rChangedWatchIds );
+		//@}
+
+	private:
+#if HELIUM_OS_WIN
+		struct PlatformWatch;
+
+		/// Active watches.
+		DynamicArray< PlatformWatch* > m_watches;
+		/// ID to assign to the next watch.
+		uint32_t m_nextWatchId;
+#elif HELIUM_OS_LINUX
+		/// inotify instance file descriptor (-1 if inotify is not available).
+		int m_inotifyFd;
+#endif
+	};
+}
@@ -2,34 +2,15 @@
 #include "LooseAssetFileWatcher.h"
 
 #include "Foundation/DirectoryIterator.h"
+#include "PcSupport/DirectoryChangeMonitor.h"
 #include "PcSupport/LoosePackageLoader.h"
 #include "Foundation/Log.h"
+#include "Platform/Timer.h"
 #include "Persist/ArchiveJson.h"
 #include "PcSupport/ResourceHandler.h"
 
 using namespace Helium;
 
-///////////////////////////////////////////////////////////////////////////////
-// Sleep between runs and yield to other threads
-// The complex loop is to prevent Editor from hanging on exit (max hang will be "increments" seconds)
-inline void SleepBetweenTracking( bool* cancel = NULL, const uint32_t minutes = 1 )
-{
-	//const uint32_t increments = 1;
-	//uint32_t totalSeconds = 60 * minutes;
-	//for ( uint32_t seconds = 0; seconds < totalSeconds; seconds += increments )
-	//{
-	//	Thread::Sleep( increments * 1000 );
-
-	//	if ( ( cancel != NULL )
-	//		&& *cancel )
-	//	{
-	//		break;
-	//	}
-	//}
-
-	Thread::Sleep( 1000 );
-}
-
 LooseAssetFileWatcher::LooseAssetFileWatcher() 
 : m_StopTracking( false )
 , m_InterruptTracking( 0 )
@@ -61,6 +42,9 @@ void LooseAssetFileWatcher::AddPackage( LoosePackageLoader *pPackageLoader )
 	WatchedPackage *pWatchedPackage = m_PathsToWatch.New();
 	pWatchedPackage->m_Path = pPackageLoader->m_packageDirPath;
 	pWatchedPackage->m_Loader = pPackageLoader;
+	pWatchedPackage->m_WatchId = Invalid< uint32_t >();
+	pWatchedPackage->m_NeedsWatch = true;
+	pWatchedPackage->m_NeedsScan = true;
 	AtomicDecrement( m_InterruptTracking );
 }
 
@@ -73,6 +57,11 @@ void LooseAssetFileWatcher::RemovePackage( LoosePackageLoader *pPackageLoader )
 	{
 		if (pPackageLoader == m_PathsToWatch[i].m_Loader)
 		{
+			if ( IsValid( m_PathsToWatch[i].m_WatchId ) )
+			{
+				m_RemovedWatchIds.Push( m_PathsToWatch[i].m_WatchId );
+			}
+
 			m_PathsToWatch.RemoveSwap(i);
 			break;
 		}
@@ -117,153 +106,242 @@ void LooseAssetFileWatcher::TrackEverything()
 
 	AssetAwareThreadSynchronizer assetSync;
 
-	while ( !m_StopTracking )
+	// Owned by this thread, as some backends require all of their calls to come from one thread
+	DirectoryChangeMonitor monitor;
+	if ( !monitor.IsAvailable() )
 	{
-		Log::Print( Log::Levels::Default, "Tracker: Scanning packages for changes...\n" );
+		Log::Print( Log::Levels::Default, "Tracker: Directory change notifications are not available, polling packages for changes\n" );
+	}
 
+	DynamicArray<uint32_t> changedWatchIds;
+	uint64_t lastPollTicks = 0;
+
+	while ( !m_StopTracking )
+	{
 		// Do this once outside the inner loop in case we are iterating over nothing
 		assetSync.Sync();
 
 		{
 			SpinLock lock( m_PathsToWatchLock );
 
+			UpdateWatches( monitor );
+
+			bool pollDue = Timer::TicksToMilliseconds( Timer::GetTickCount() - lastPollTicks ) >= static_cast<float32_t>( POLL_MILLISECONDS );
+			if ( pollDue )
+			{
+				lastPollTicks = Timer::GetTickCount();
+			}
+
 			// Go through all the packages we're tracking
 			for ( DynamicArray<WatchedPackage>::Iterator packageIter = m_PathsToWatch.Begin(); packageIter != m_PathsToWatch.End(); ++packageIter )
 			{
+				if ( !packageIter->m_NeedsScan && !( pollDue && IsInvalid( packageIter->m_WatchId ) ) )
+				{
+					continue;
+				}
+
 				assetSync.Sync();
 
-				//Log::Print( Log::Levels::Default, "Tracker: Scanning package %s\n", packageIter->m_Path.c_str() );
+				ScanPackage( *packageIter );
+
+				if ( m_StopTracking || m_InterruptTracking != 0 )
+				{
+					// Our thread is supposed to die, bail early. Packages that weren't scanned keep their flag for the next pass
+					break;
+				}
 
-				SimpleTimer packageTimer;
-				Helium::DirectoryIterator directory( packageIter->m_Path );
+				packageIter->m_NeedsScan = false;
+			}
+		}
+
+		SendNotifications();
+
+		if ( m_StopTracking )
+		{
+			break;
+		}
 
-				// For each file
-				for( ; !directory.IsDone(); directory.Next() )
+		// Sleep until something changes, waking up regularly to pick up new packages and stop requests
+		changedWatchIds.Resize( 0 );
+		if ( !monitor.WaitForChanges( WAIT_MILLISECONDS, changedWatchIds ) )
+		{
+			continue;
+		}
+
+		// Let the burst of changes settle so it results in one scan per package
+		uint64_t debounceStartTicks = Timer::GetTickCount();
+		while ( !m_StopTracking &&
+			Timer::TicksToMilliseconds( Timer::GetTickCount() - debounceStartTicks ) < static_cast<float32_t>( MAX_DEBOUNCE_MILLISECONDS ) &&
+			monitor.WaitForChanges( DEBOUNCE_MILLISECONDS, changedWatchIds ) )
+		{
+		}
+
+		{
+			SpinLock lock( m_PathsToWatchLock );
+
+			bool rescanAll = false;
+			for ( DynamicArray<uint32_t>::Iterator watchIter = changedWatchIds.Begin(); watchIter != changedWatchIds.End(); ++watchIter )
+			{
+				// An invalid ID means changes were lost, so nothing can be skipped
+				if ( IsInvalid( *watchIter ) )
 				{
-					// If our thread is supposed to die, bail early
-					if ( m_StopTracking )
+					rescanAll = true;
+					break;
+				}
+			}
+
+			for ( DynamicArray<WatchedPackage>::Iterator packageIter = m_PathsToWatch.Begin(); packageIter != m_PathsToWatch.End(); ++packageIter )
+			{
+				if ( rescanAll )
+				{
+					packageIter->m_NeedsScan = true;
+					continue;
+				}
+
+				for ( DynamicArray<uint32_t>::Iterator watchIter = changedWatchIds.Begin(); watchIter != changedWatchIds.End(); ++watchIter )
+				{
+					if ( *watchIter == packageIter->m_WatchId )
 					{
+						packageIter->m_NeedsScan = true;
 						break;
 					}
+				}
+			}
+		}
+	}
+}
 
-					const DirectoryIteratorItem& item = directory.GetItem();
+void LooseAssetFileWatcher::UpdateWatches( DirectoryChangeMonitor &rMonitor )
+{
+	for ( DynamicArray<uint32_t>::Iterator watchIter = m_RemovedWatchIds.Begin(); watchIter != m_RemovedWatchIds.End(); ++watchIter )
+	{
+		rMonitor.UnwatchDirectory( *watchIter );
+	}
 
-					bool isNewFile = true;
-					bool isChangedFile = false;
+	m_RemovedWatchIds.Resize( 0 );
 
-					Name objectName;
-					size_t objectIndex = Invalid< size_t >();
+	for ( DynamicArray<WatchedPackage>::Iterator packageIter = m_PathsToWatch.Begin(); packageIter != m_PathsToWatch.End(); ++packageIter )
+	{
+		if ( !packageIter->m_NeedsWatch )
+		{
+			continue;
+		}
 
-					if ( item.m_Path.IsDirectory() )
-					{
-						// Skip directories
-						continue;
-					}
-					else if ( item.m_Path.Extension() == "json" )
-					{
-						// JSON files get handled special
-						objectName.Set( item.m_Path.Basename().c_str() );
-						objectIndex = packageIter->m_Loader->FindObjectByName( objectName );
-					}
-					else
-					{
-						// See if it's a raw asset that we can handle
-						String objectNameString( item.m_Path.Filename().Data() );
+		// If the directory can't be watched, the package is polled instead. The scan queued when the package was added
+		// picks up anything that changed before the watch started
+		packageIter->m_WatchId = rMonitor.WatchDirectory( packageIter->m_Path );
+		packageIter->m_NeedsWatch = false;
+	}
+}
 
-						ResourceHandler* pBestHandler = ResourceHandler::GetBestResourceHandlerForFile( objectNameString );
+void LooseAssetFileWatcher::ScanPackage( WatchedPackage &rPackage )
+{
+	//Log::Print( Log::Levels::Default, "Tracker: Scanning package %s\n", rPackage.m_Path.c_str() );
 
-						if (!pBestHandler)
-						{
-							// We don't know what this file is.. skip it
-							continue;
-						}
+	Helium::DirectoryIterator directory( rPackage.m_Path );
 
-						objectName.Set( item.m_Path.Filename().Data() );
-						objectIndex = packageIter->m_Loader->FindObjectByName( objectName );
-					}
+	// For each file
+	for( ; !directory.IsDone(); directory.Next() )
+	{
+		// If our thread is supposed to die, bail early
+		if ( m_StopTracking )
+		{
+			break;
+		}
 
-					// If the package says it loaded something as fresh as the file, do nothing
-					if ( objectIndex != Invalid< size_t >() &&
-						packageIter->m_Loader->m_objects[objectIndex].fileTimeStamp >= static_cast<int64_t>( directory.GetItem().m_ModTime ))
-					{
-						continue;
-					}
+		const DirectoryIteratorItem& item = directory.GetItem();
 
-					// If we have already emitted a message for this object, skip it
-					HashMap< Name, WatchedAsset >::Iterator watchedAssetItr = packageIter->m_Assets.Find( objectName );
-					if (watchedAssetItr != packageIter->m_Assets.End())
-					{
-						if (watchedAssetItr->Second().m_LastMessageTime >= static_cast<int64_t>( directory.GetItem().m_ModTime ) )
-						{
-							// We already emitted a message for this file change, so don't do anything
-							continue;
-						}
-
-						// We've emitted a message, but it's been modified again. Emit another message and update the timestamp
-						watchedAssetItr->Second().m_LastMessageTime = static_cast<int64_t>( directory.GetItem().m_ModTime );
-					}
-					else
-					{
-						// We've never emitted a message, so record that we will
-						WatchedAsset watchedAsset;
-						watchedAsset.m_LastMessageTime = static_cast<int64_t>( directory.GetItem().m_ModTime );
+		Name objectName;
+		size_t objectIndex = Invalid< size_t >();
 
-						packageIter->m_Assets.Insert(
-							watchedAssetItr, 
-							KeyValue< Name, WatchedAsset >( objectName, watchedAsset ) );
-					}
-				
-					// We know the file is changed and we should throw an event.. choose a different event based on new vs. changed
-					if (objectIndex != Invalid< size_t >())
-					{
-						m_ChangeNotifications.Add( packageIter->m_Loader->GetAssetPath( objectIndex ) );
-					}
-					else
-					{
-						AssetPath path;
-						path.Set( objectName, false, packageIter->m_Loader->GetPackagePath());
+		if ( item.m_Path.IsDirectory() )
+		{
+			// Skip directories
+			continue;
+		}
+		else if ( item.m_Path.Extension() == "json" )
+		{
+			// JSON files get handled special
+			objectName.Set( item.m_Path.Basename().c_str() );
+			objectIndex = rPackage.m_Loader->FindObjectByName( objectName );
+		}
+		else
+		{
+			// See if it's a raw asset that we can handle
+			String objectNameString( item.m_Path.Filename().Data() );
 
-						m_NewNotifications.Add( path );
-					}
-				}
+			ResourceHandler* pBestHandler = ResourceHandler::GetBestResourceHandlerForFile( objectNameString );
 
-				if ( m_StopTracking || m_InterruptTracking != 0 )
-				{
-					// Our thread is supposed to die, bail early
-					//Log::Print( Log::Levels::Default, "Tracker: Pre-empted after %.2fm\n", packageTimer.Elapsed() / 1000.f / 60.f );
-					break;
-				}
-				else 
-				{
-					//Log::Print( Log::Levels::Default, "Tracker: Package scanned in %.2fm\n" , packageTimer.Elapsed() / 1000.f / 60.f );
-				}
+			if (!pBestHandler)
+			{
+				// We don't know what this file is.. skip it
+				continue;
 			}
+
+			objectName.Set( item.m_Path.Filename().Data() );
+			objectIndex = rPackage.m_Loader->FindObjectByName( objectName );
 		}
 
-		for ( DynamicArray<AssetPath>::Iterator changedAssetIter = m_ChangeNotifications.Begin(); changedAssetIter != m_ChangeNotifications.End(); ++changedAssetIter )
+		// If the package says it loaded something as fresh as the file, do nothing
+		if ( objectIndex != Invalid< size_t >() &&
+			rPackage.m_Loader->m_objects[objectIndex].fileTimeStamp >= static_cast<int64_t>( item.m_ModTime ))
 		{
-			HELIUM_TRACE( TraceLevels::Info, " %s IS MODIFIED\n", *changedAssetIter->ToString());
-			AssetTracker::GetInstance()->NotifyAssetChangedExternally( *changedAssetIter );
-
-			AssetPtr asset;
-			AssetLoader::GetInstance()->LoadObject( *changedAssetIter, asset, true );
-			Asset::ReplaceAsset( asset.Get(), *changedAssetIter );
+			continue;
 		}
 
-		for ( DynamicArray<AssetPath>::Iterator newAssetIter = m_NewNotifications.Begin(); newAssetIter != m_NewNotifications.End(); ++newAssetIter )
+		// If we have already emitted a message for this object, skip it
+		HashMap< Name, WatchedAsset >::Iterator watchedAssetItr = rPackage.m_Assets.Find( objectName );
+		if (watchedAssetItr != rPackage.m_Assets.End())
 		{
-			HELIUM_TRACE( TraceLevels::Info, " %s IS MODIFIED\n", *newAssetIter->ToString());
-			AssetTracker::GetInstance()->NotifyAssetCreatedExternally( *newAssetIter );
+			if (watchedAssetItr->Second().m_LastMessageTime >= static_cast<int64_t>( item.m_ModTime ) )
+			{
+				// We already emitted a message for this file change, so don't do anything
+				continue;
+			}
+
+			// We've emitted a message, but it's been modified again. Emit another message and update the timestamp
+			watchedAssetItr->Second().m_LastMessageTime = static_cast<int64_t>( item.m_ModTime );
 		}
+		else
+		{
+			// We've never emitted a message, so record that we will
+			WatchedAsset watchedAsset;
+			watchedAsset.m_LastMessageTime = static_cast<int64_t>( item.m_ModTime );
 
-		m_ChangeNotifications.Clear();
-		m_NewNotifications.Clear();
+			rPackage.m_Assets.Insert( 
+				watchedAssetItr, 
+				KeyValue< Name, WatchedAsset >( objectName, watchedAsset ) );
+		}
 
-		if ( !m_StopTracking )
+		// We know the file is changed and we should throw an event.. choose a different event based on new vs. changed
+		if (objectIndex != Invalid< size_t >())
+		{
+			m_ChangeNotifications.Add( rPackage.m_Loader->GetAssetPath( objectIndex ) );
+		}
+		else
 		{
-			// Sleep between runs and yield to other threads
-			// The complex loop is to prevent Editor from hanging on exit (max hang will be "increments" seconds)
-			SleepBetweenTracking( &m_StopTracking );
+			AssetPath path;
+			path.Set( objectName, false, rPackage.m_Loader->GetPackagePath());
+
+			m_NewNotifications.Add( path );
 		}
 	}
-}
\ No newline at end of file
+}
+
+void LooseAssetFileWatcher::SendNotifications()
+{
+	for ( DynamicArray<AssetPath>::Iterator changedAssetIter = m_ChangeNotifications.Begin(); changedAssetIter != m_ChangeNotifications.End(); ++changedAssetIter )
+	{
+		HELIUM_TRACE( TraceLevels::Info, " %s IS MODIFIED\n", *changedAssetIter->ToString());
+		AssetTracker::GetInstance()->NotifyAssetChangedExternally( *changedAssetIter );
+	}
+
+	for ( DynamicArray<AssetPath>::Iterator newAssetIter = m_NewNotifications.Begin(); newAssetIter != m_NewNotifications.End(); ++newAssetIter )
+	{
+		HELIUM_TRACE( TraceLevels::Info, " %s IS MODIFIED\n", *newAssetIter->ToString());
+		AssetTracker::GetInstance()->NotifyAssetCreatedExternally( *newAssetIter );
+	}
+
+	m_ChangeNotifications.Clear();
+	m_NewNotifications.Clear();
+}
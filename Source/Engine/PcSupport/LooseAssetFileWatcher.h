@@ -3,6 +3,11 @@
 namespace Helium
 {
 	class LoosePackageLoader;
+	class DirectoryChangeMonitor;
+
+	/// Watches the directories of loose packages and reports asset files that were changed or created by other
+	/// programs.  Where the operating system can report directory changes, a package is only scanned after something in
+	/// it changed (once changes have settled for a moment); otherwise every package is polled once a second.
 
 	class HELIUM_PC_SUPPORT_API LooseAssetFileWatcher
 	{
@@ -20,6 +25,16 @@ namespace Helium
 		void TrackEverything();
 
 	protected:
+		/// Time to keep collecting directory changes after the first one before scanning, so that a burst of writes
+		/// (such as an editor saving several files, or a file written in pieces) results in a single scan.
+		static const uint32_t DEBOUNCE_MILLISECONDS = 100;
+		/// Upper limit on the time spent collecting changes before scanning.
+		static const uint32_t MAX_DEBOUNCE_MILLISECONDS = 1000;
+		/// Time to wait for directory changes before checking for new packages or a stop request.
+		static const uint32_t WAIT_MILLISECONDS = 250;
+		/// Interval between scans of packages that are polled instead of watched.
+		static const uint32_t POLL_MILLISECONDS = 1000;
+
 		Helium::CallbackThread m_Thread;
 		bool m_StopTracking;
 		volatile int m_InterruptTracking;
@@ -35,11 +50,25 @@ namespace Helium
 			LoosePackageLoader *m_Loader;
 
 			HashMap< Name, WatchedAsset > m_Assets;
+
+			// Directory watch of the package, or invalid if the package is polled
+			uint32_t m_WatchId;
+			// True until a watch has been attempted for this package
+			bool m_NeedsWatch;
+			// True if the package must be scanned on the next pass
+			bool m_NeedsScan;
 		};
 
+		void UpdateWatches( DirectoryChangeMonitor &rMonitor );
+		void ScanPackage( WatchedPackage &rPackage );
+		void SendNotifications();
+
 		DynamicArray<WatchedPackage> m_PathsToWatch;
 		SpinLock m_PathsToWatchLock;
 
+		// Watches of removed packages, released by the tracking thread (which owns the monitor)
+		DynamicArray<uint32_t> m_RemovedWatchIds;
+
 		DynamicArray<AssetPath> m_ChangeNotifications;
 		DynamicArray<AssetPath> m_NewNotifications;
 	};
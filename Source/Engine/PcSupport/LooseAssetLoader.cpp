@@ -71,7 +71,7 @@ void LooseAssetLoader::Shutdown()
 /// @copydoc AssetLoader::GetPackageLoader()
 PackageLoader* LooseAssetLoader::GetPackageLoader( AssetPath path )
 {
-	LoosePackageLoader* pLoader = m_packageLoaderMap.GetPackageLoader( path );
+	PackageLoader* pLoader = m_packageLoaderMap.GetPackageLoader( path );
 
 	return pLoader;
 }
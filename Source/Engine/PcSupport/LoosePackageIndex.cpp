@@ -0,0 +1,330 @@
+#include "Precompile.h"
+#include "PcSupport/LoosePackageIndex.h"
+
+#include "Foundation/FileStream.h"
+#include "Foundation/Stream.h"
+#include "Engine/FileLocations.h"
+
+using namespace Helium;
+
+/// Read a value from an index buffer, advancing the read position.
+///
+/// @param[out]    rValue    Value read.
+/// @param[in,out] rpCurrent Current read position.
+/// @param[in]     pEnd      End of the index buffer.
+///
+/// @return  True if the value was read, false if the end of the buffer was reached.
+template< typename T >
+static bool ReadIndexValue( T& rValue, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+{
+	if( static_cast< size_t >( pEnd - rpCurrent ) < sizeof( T ) )
+	{
+		return false;
+	}
+
+	MemoryCopy( &rValue, rpCurrent, sizeof( T ) );
+	rpCurrent += sizeof( T );
+
+	return true;
+}
+
+/// Read a length-prefixed string from an index buffer, advancing the read position.
+///
+/// @param[out]    rString   String read.
+/// @param[in,out] rpCurrent Current read position.
+/// @param[in]     pEnd      End of the index buffer.
+///
+/// @return  True if the string was read, false if the end of the buffer was reached.
+static bool ReadIndexString( String& rString, const uint8_t*& rpCurrent, const uint8_t* pEnd )
+{
+	uint32_t length = 0;
+	if( !ReadIndexValue( length, rpCurrent, pEnd ) || length > static_cast< size_t >( pEnd - rpCurrent ) )
+	{
+		return false;
+	}
+
+	rString = String( reinterpret_cast< const char* >( rpCurrent ), length );
+	rpCurrent += length;
+
+	return true;
+}
+
+/// Write a length-prefixed string to an index stream.
+///
+/// @param[in] rStream  Stream to write to.
+/// @param[in] rString  String to write.
+static void WriteIndexString( Stream& rStream, const String& rString )
+{
+	uint32_t length = static_cast< uint32_t >( rString.GetSize() );
+	rStream.Write( &length, sizeof( length ), 1 );
+	rStream.Write( rString.GetData(), sizeof( char ), length );
+}
+
+/// Constructor.
+LoosePackageIndex::LoosePackageIndex()
+{
+}
+
+/// Remove all entries from this index.
+void LoosePackageIndex::Clear()
+{
+	m_packagePath.Clear();
+	m_entries.Clear();
+}
+
+/// Set the entry for an object file, replacing any entry it already has.
+///
+/// @param[in] objectName  Name of the object (the object file name without its extension).
+/// @param[in] rEntry      Object file entry.
+void LoosePackageIndex::SetEntry( Name objectName, const Entry& rEntry )
+{
+	HELIUM_ASSERT( !objectName.IsEmpty() );
+
+	HashMap< Name, Entry >::Iterator entryIterator = m_entries.Find( objectName );
+	if( entryIterator != m_entries.End() )
+	{
+		entryIterator->Second() = rEntry;
+		return;
+	}
+
+	m_entries.Insert( entryIterator, HashMap< Name, Entry >::ValueType( objectName, rEntry ) );
+}
+
+/// Find the entry for an object file, if the file is unchanged since it was indexed.
+///
+/// @param[in] objectName     Name of the object.
+/// @param[in] fileTimestamp  Current time stamp of the object file.
+/// @param[in] fileSize       Current size of the object file.
+///
+/// @return  Object file entry, or null if the file is not indexed or has changed.
+const LoosePackageIndex::Entry* LoosePackageIndex::FindEntry( Name objectName, int64_t fileTimestamp, uint64_t fileSize ) const
+{
+	HashMap< Name, Entry >::ConstIterator entryIterator = m_entries.Find( objectName );
+	if( entryIterator == m_entries.End() )
+	{
+		return NULL;
+	}
+
+	const Entry& rEntry = entryIterator->Second();
+	if( rEntry.fileTimestamp != fileTimestamp || rEntry.fileSize != fileSize )
+	{
+		return NULL;
+	}
+
+	return &rEntry;
+}
+
+/// Write this index to a stream.
+///
+/// @param[in] rStream  Stream to write to.
+///
+/// @see Read()
+void LoosePackageIndex::Write( Stream& rStream ) const
+{
+	uint32_t version = VERSION;
+	rStream.Write( &version, sizeof( version ), 1 );
+
+	WriteIndexString( rStream, m_packagePath.ToString() );
+
+	HELIUM_ASSERT( m_entries.GetSize() <= UINT32_MAX );
+	uint32_t entryCount = static_cast< uint32_t >( m_entries.GetSize() );
+	rStream.Write( &entryCount, sizeof( entryCount ), 1 );
+
+	for( HashMap< Name, Entry >::ConstIterator entryIterator = m_entries.Begin();
+		entryIterator != m_entries.End(); ++entryIterator )
+	{
+		const Entry& rEntry = entryIterator->Second();
+
+		WriteIndexString( rStream, String( *entryIterator->First() ) );
+		WriteIndexString( rStream, String( *rEntry.typeName ) );
+		WriteIndexString( rStream, rEntry.templatePath );
+		rStream.Write( &rEntry.fileTimestamp, sizeof( rEntry.fileTimestamp ), 1 );
+		rStream.Write( &rEntry.fileSize, sizeof( rEntry.fileSize ), 1 );
+	}
+}
+
+/// Replace the contents of this index with those read from a buffer.
+///
+/// @param[in] pData  Index data.
+/// @param[in] size   Size of the index data, in bytes.
+///
+/// @return  True if the index was read successfully, false if it is invalid (in which case this index is left empty).
+///
+/// @see Write()
+bool LoosePackageIndex::Read( const uint8_t* pData, size_t size )
+{
+	HELIUM_ASSERT( pData || size == 0 );
+
+	Clear();
+
+	const uint8_t* pCurrent = pData;
+	const uint8_t* pEnd = pData + size;
+
+	uint32_t version = 0;
+	if( !ReadIndexValue( version, pCurrent, pEnd ) || version != VERSION )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"LoosePackageIndex::Read(): Index version %" PRIu32 " does not match the current version (%" PRIu32 ").\n",
+			version,
+			VERSION );
+
+		return false;
+	}
+
+	String packagePathString;
+	uint32_t entryCount = 0;
+	if( !ReadIndexString( packagePathString, pCurrent, pEnd ) ||
+		!m_packagePath.Set( packagePathString ) ||
+		!ReadIndexValue( entryCount, pCurrent, pEnd ) )
+	{
+		Clear();
+
+		return false;
+	}
+
+	String objectName;
+	String typeName;
+	for( uint32_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		Entry entry;
+		if( !ReadIndexString( objectName, pCurrent, pEnd ) ||
+			!ReadIndexString( typeName, pCurrent, pEnd ) ||
+			!ReadIndexString( entry.templatePath, pCurrent, pEnd ) ||
+			!ReadIndexValue( entry.fileTimestamp, pCurrent, pEnd ) ||
+			!ReadIndexValue( entry.fileSize, pCurrent, pEnd ) ||
+			objectName.IsEmpty() || typeName.IsEmpty() )
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "LoosePackageIndex::Read(): Index is truncated.\n" );
+
+			Clear();
+
+			return false;
+		}
+
+		entry.typeName.Set( typeName );
+		SetEntry( Name( objectName ), entry );
+	}
+
+	return true;
+}
+
+/// Replace the contents of this index with those of an index file.
+///
+/// @param[in] rPath  Index file path.
+///
+/// @return  True if the index file was read successfully, false if it does not exist or is invalid (in which case
+///          this index is left empty).
+///
+/// @see SaveToFile()
+bool LoosePackageIndex::LoadFromFile( const FilePath& rPath )
+{
+	Clear();
+
+	if( !rPath.Exists() )
+	{
+		return false;
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"LoosePackageIndex::LoadFromFile(): Failed to open \"%s\" for reading.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	int64_t size64 = pFileStream->GetSize();
+	if( size64 < 0 || static_cast< uint64_t >( size64 ) > static_cast< size_t >( -1 ) )
+	{
+		delete pFileStream;
+
+		return false;
+	}
+
+	DynamicArray< uint8_t > data;
+	data.Resize( static_cast< size_t >( size64 ) );
+	size_t bytesRead = pFileStream->Read( data.GetData(), 1, data.GetSize() );
+
+	delete pFileStream;
+
+	if( bytesRead != data.GetSize() )
+	{
+		return false;
+	}
+
+	return Read( data.GetData(), data.GetSize() );
+}
+
+/// Write this index to a file.
+///
+/// @param[in] rPath  Index file path.
+///
+/// @return  True if the index was written successfully, false if not.
+///
+/// @see LoadFromFile()
+bool LoosePackageIndex::SaveToFile( const FilePath& rPath ) const
+{
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"LoosePackageIndex::SaveToFile(): Failed to open \"%s\" for writing.\n",
+			rPath.Data() );
+
+		return false;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+		Write( bufferedStream );
+	}
+
+	delete pFileStream;
+
+	return true;
+}
+
+/// Get the path of the index file for a package.
+///
+/// Index files are kept in the user data directory rather than next to the object files, so they are never checked
+/// in or picked up as package contents.  The index directory is created if it does not exist yet.
+///
+/// @param[in]  packagePath  Package path.
+/// @param[out] rPath        Index file path.
+///
+/// @return  True if the path was determined, false if no user data directory is available.
+bool LoosePackageIndex::GetIndexFilePath( AssetPath packagePath, FilePath& rPath )
+{
+	FilePath userDirectory;
+	if( !FileLocations::GetUserDirectory( userDirectory ) )
+	{
+		return false;
+	}
+
+	FilePath indexDirectory( userDirectory.Get() + "PackageIndex" );
+	if( !indexDirectory.Exists() && !indexDirectory.MakePath() )
+	{
+		return false;
+	}
+
+	// Flatten the package path into a single file name.  Index files of packages whose names flatten the same way
+	// are told apart by the package path stored in them.
+	std::string fileName( packagePath.ToFilePathString().GetData() );
+	for( size_t characterIndex = 0; characterIndex < fileName.size(); ++characterIndex )
+	{
+		char character = fileName[ characterIndex ];
+		if( character == '/' || character == '\\' || character == ':' )
+		{
+			fileName[ characterIndex ] = '_';
+		}
+	}
+
+	rPath = FilePath( indexDirectory.Get() + "/" + fileName + ".index" );
+
+	return true;
+}
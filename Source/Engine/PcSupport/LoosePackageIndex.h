@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/HashMap.h"
+
+#include "Engine/AssetPath.h"
+#include "PcSupport/PcSupport.h"
+
+namespace Helium
+{
+	class Stream;
+
+	/// Preliminary data of every object file in a loose package, saved between runs so that preloading a package only
+	/// has to read the object files that changed since the index was written.
+	///
+	/// Entries are matched to object files by name, and are only used while the file's time stamp and size are the
+	/// same as when it was indexed.
+	class HELIUM_PC_SUPPORT_API LoosePackageIndex
+	{
+	public:
+		/// Index format version.
+		static const uint32_t VERSION = 1;
+
+		/// Object file entry.
+		struct Entry
+		{
+			/// Type name.
+			Name typeName;
+			/// Template path (empty for the type's default template).
+			String templatePath;
+			/// Object file time stamp.
+			int64_t fileTimestamp;
+			/// Object file size.
+			uint64_t fileSize;
+		};
+
+		/// @name Construction/Destruction
+		//@{
+		LoosePackageIndex();
+		//@}
+
+		/// @name Entry Access
+		//@{
+		void Clear();
+		inline void SetPackagePath( AssetPath packagePath );
+		inline AssetPath GetPackagePath() const;
+		void SetEntry( Name objectName, const Entry& rEntry );
+		const Entry* FindEntry( Name objectName, int64_t fileTimestamp, uint64_t fileSize ) const;
+		inline size_t GetEntryCount() const;
+		//@}
+
+		/// @name Serialization
+		//@{
+		void Write( Stream& rStream ) const;
+		bool Read( const uint8_t* pData, size_t size );
+
+		bool LoadFromFile( const FilePath& rPath );
+		bool SaveToFile( const FilePath& rPath ) const;
+
+		static bool GetIndexFilePath( AssetPath packagePath, FilePath& rPath );
+		//@}
+
+	private:
+		/// Package path, stored to reject index files of another package.
+		AssetPath m_packagePath;
+		/// Entries by object name.
+		HashMap< Name, Entry > m_entries;
+	};
+}
+
+#include "PcSupport/LoosePackageIndex.inl"
@@ -0,0 +1,25 @@
+/// Set the path of the package this index describes.
+///
+/// @param[in] packagePath  Package path.
+void Helium::LoosePackageIndex::SetPackagePath( AssetPath packagePath )
+{
+    m_packagePath = packagePath;
+}
+
+/// Get the path of the package this index describes.
+///
+/// @return  Package path.
+Helium::AssetPath Helium::LoosePackageIndex::GetPackagePath() const
+{
+    return m_packagePath;
+}
+
+/// Get the number of object file entries in this index.
+///
+/// @return  Entry count.
+///
+/// @see FindEntry()
+size_t Helium::LoosePackageIndex::GetEntryCount() const
+{
+    return m_entries.GetSize();
+}
@@ -7,6 +7,9 @@
 #include "Foundation/FileStream.h"
 #include "Foundation/MemoryStream.h"
 #include "Engine/AsyncLoader.h"
+#include "Engine/AssetLoadTrace.h"
+#include "Platform/Timer.h"
+#include "Engine/Cache.h"
 #include "Engine/CacheManager.h"
 #include "Engine/Config.h"
 #include "Engine/AssetLoader.h"
@@ -15,17 +18,79 @@
 #include "PcSupport/ResourceHandler.h"
 #include "Reflect/TranslatorDeduction.h"
 #include "Persist/ArchiveJson.h"
+#include "Persist/ArchiveMessagePack.h"
 
 #include "LooseAssetLoader.h"
 
 using namespace Helium;
 
+namespace
+{
+	/// Reader handler picking the type name and template path out of an object file.
+	struct PreliminaryObjectHandler : rapidjson::BaseReaderHandler<>
+	{
+		Helium::Name typeName;
+		Helium::String templatePath;
+		bool templateIsNext;
+
+		PreliminaryObjectHandler()
+			: typeName( ENullName() )
+			, templatePath( "" )
+		{
+			templateIsNext = false;
+		}
+
+		bool Key( const Ch* chars, rapidjson::SizeType length, bool copy )
+		{
+			if ( typeName.IsEmpty() )
+			{
+				typeName.Set( Helium::String( chars, length ) );
+				return true;
+			}
+
+			if ( templatePath.IsEmpty() )
+			{
+				Helium::String str( chars, length );
+
+				if ( str == "m_spTemplate" )
+				{
+					templateIsNext = true;
+					return true;
+				}
+			}
+
+			return true;
+		}
+
+		bool String( const Ch* chars, rapidjson::SizeType length, bool copy )
+		{
+			if ( templatePath.IsEmpty() )
+			{
+				Helium::String str( chars, length );
+
+				if ( templateIsNext )
+				{
+					templatePath = str;
+					templateIsNext = false;
+					return true;
+				}
+			}
+
+			return true;
+		}
+	};
+}
+
+bool LoosePackageLoader::sm_bBinarySidecarsEnabled = false;
+
 /// Constructor.
 LoosePackageLoader::LoosePackageLoader()
 	: m_startPreloadCounter( 0 )
 	, m_preloadedCounter( 0 )
 	, m_loadRequestPool( LOAD_REQUEST_POOL_BLOCK_SIZE )
 	, m_parentPackageLoadId( Invalid< size_t >() )
+	, m_bPackageIndexDirty( false )
+	, m_retainedFileBytes( 0 )
 	//, m_pTocLoadBuffer( 0 )
 	//, m_tocAsyncLoadId( Invalid<size_t>() )
 	//, m_packageTocFileSize( 0 )
@@ -178,6 +243,12 @@ void LoosePackageLoader::Cleanup()
 	AtomicExchangeRelease( m_startPreloadCounter, 0 );
 	AtomicExchangeRelease( m_preloadedCounter, 0 );
 
+	for ( size_t objectIndex = 0; objectIndex < m_objects.GetSize(); ++objectIndex )
+	{
+		ReleaseRetainedFile( m_objects[objectIndex] );
+	}
+
+	HELIUM_ASSERT( m_retainedFileBytes == 0 );
 	m_objects.Clear();
 
 	size_t loadRequestCount = m_loadRequests.GetSize();
@@ -193,6 +264,9 @@ void LoosePackageLoader::Cleanup()
 
 	m_loadRequests.Clear();
 
+	m_packageIndex.Clear();
+	m_bPackageIndexDirty = false;
+
 	m_packageDirPath.Clear();
 }
 
@@ -238,9 +312,22 @@ bool LoosePackageLoader::BeginPreload()
 	}
 	else
 	{
+		// Object files that are unchanged since the index was saved don't need to be read at all
+		LoosePackageIndex savedIndex;
+		FilePath indexFilePath;
+		if ( LoosePackageIndex::GetIndexFilePath( m_packagePath, indexFilePath ) &&
+			savedIndex.LoadFromFile( indexFilePath ) &&
+			savedIndex.GetPackagePath() != m_packagePath )
+		{
+			savedIndex.Clear();
+		}
+
+		m_packageIndex.Clear();
+		m_packageIndex.SetPackagePath( m_packagePath );
+
 		DirectoryIterator packageDirectory( m_packageDirPath );
 
-		HELIUM_TRACE( TraceLevels::Info, " LoosePackageLoader::BeginPreload - Issuing read requests for all files in %s\n", m_packageDirPath.Data() );
+		HELIUM_TRACE( TraceLevels::Info, " LoosePackageLoader::BeginPreload - Issuing read requests for changed files in %s\n", m_packageDirPath.Data() );
 
 		for ( ; !packageDirectory.IsDone(); packageDirectory.Next() )
 		{
@@ -261,6 +348,28 @@ bool LoosePackageLoader::BeginPreload()
 #endif
 				if ( item.m_Path.Extension() == "json" )
 				{
+					Name name( item.m_Path.Basename().c_str() );
+					const LoosePackageIndex::Entry* pIndexEntry = savedIndex.FindEntry(
+						name,
+						static_cast<int64_t>( item.m_ModTime ),
+						static_cast<uint64_t>( item.m_Size ) );
+					if ( pIndexEntry )
+					{
+						SerializedObjectData* pObjectData = m_objects.New();
+						HELIUM_ASSERT( pObjectData );
+						HELIUM_VERIFY( pObjectData->objectPath.Set( name, false, m_packagePath ) );
+						pObjectData->templatePath.Set( pIndexEntry->templatePath );
+						pObjectData->typeName = pIndexEntry->typeName;
+						pObjectData->filePath = item.m_Path;
+						pObjectData->fileTimeStamp = pIndexEntry->fileTimestamp;
+						pObjectData->bMetadataGood = true;
+						pObjectData->pRetainedFileBuffer = NULL;
+						pObjectData->retainedFileSize = 0;
+
+						m_packageIndex.SetEntry( name, *pIndexEntry );
+						continue;
+					}
+
 					HELIUM_TRACE( TraceLevels::Info, "- Reading file [%s]\n", item.m_Path.Data() );
 
 					FileReadRequest *request = m_fileReadRequests.New();
@@ -279,12 +388,20 @@ bool LoosePackageLoader::BeginPreload()
 
 					request->filePath = item.m_Path;
 					request->fileTimestamp = item.m_ModTime;
+
+					m_bPackageIndexDirty = true;
 				}
 				else
 				{
 					HELIUM_TRACE( TraceLevels::Info, "- Skipping file [%s] (Extension is %s)\n", item.m_Path.Data(), item.m_Path.Extension().c_str() );
 				}
 		}
+
+		// Files removed since the index was saved leave entries behind that weren't reused
+		if ( m_packageIndex.GetEntryCount() != savedIndex.GetEntryCount() )
+		{
+			m_bPackageIndexDirty = true;
+		}
 	}
 
 	AtomicExchangeRelease( m_startPreloadCounter, 1 );
@@ -343,6 +460,7 @@ size_t LoosePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 		SetInvalid( pRequest->asyncFileLoadId );
 		pRequest->pAsyncFileLoadBuffer = NULL;
 		pRequest->asyncFileLoadBufferSize = 0;
+		pRequest->asyncFileLoadStartTicks = 0;
 		pRequest->pResolver = NULL;
 		pRequest->forceReload = forceReload;
 
@@ -440,6 +558,7 @@ size_t LoosePackageLoader::BeginLoadObject( AssetPath path, Reflect::ObjectResol
 	SetInvalid( pRequest->asyncFileLoadId );
 	pRequest->pAsyncFileLoadBuffer = NULL;
 	pRequest->asyncFileLoadBufferSize = 0;
+	pRequest->asyncFileLoadStartTicks = 0;
 	pRequest->pResolver = pResolver;
 	pRequest->forceReload = forceReload;
 
@@ -605,6 +724,19 @@ int64_t LoosePackageLoader::GetAssetFileSystemTimestamp( const AssetPath &path )
 	}
 }
 
+/// @copydoc PackageLoader::GetAssetTypeName()
+Name LoosePackageLoader::GetAssetTypeName( const AssetPath &path ) const
+{
+	// The type is read from the object file metadata during preload, so no load is needed.
+	size_t index = FindObjectByName( path.GetRootName() );
+	if ( index < m_objects.GetSize() )
+	{
+		return m_objects[index].typeName;
+	}
+
+	return Name( NULL_NAME );
+}
+
 void LoosePackageLoader::EnumerateChildren( DynamicArray< AssetPath > &children ) const
 {
 	for ( DynamicArray< AssetPath >::ConstIterator iter = m_childPackagePaths.Begin();
@@ -620,6 +752,10 @@ void LoosePackageLoader::EnumerateChildren( DynamicArray< AssetPath > &children
 	}
 }
 
+/// @copydoc PackageLoader::SaveAsset()
+///
+/// The object file is only rewritten if its contents changed, and is replaced atomically so that an interrupted save
+/// never leaves a truncated file behind.  If binary sidecars are enabled, the sidecar is brought up to date as well.
 bool LoosePackageLoader::SaveAsset( Asset *pAsset ) const
 {
 	HELIUM_ASSERT( pAsset );
@@ -628,16 +764,74 @@ bool LoosePackageLoader::SaveAsset( Asset *pAsset ) const
 	HELIUM_ASSERT( pAsset->GetOwningPackage()->GetLoader() == this );
 	HELIUM_ASSERT( pAsset->GetPath().GetParent() == GetPackagePath() );
 
-	AssetIdentifier assetIdentifier;
-	FilePath filepath = GetAssetFileSystemPath( pAsset->GetPath() );
-	if ( HELIUM_VERIFY( !filepath.Get().empty() ) )
+	DynamicArray< uint8_t > buffer;
+	FilePath filepath;
+	if ( !SerializeAsset( pAsset, buffer, filepath ) )
 	{
-		Persist::ArchiveWriter::WriteToFile( filepath, pAsset, &assetIdentifier );
-		pAsset->ClearFlags( Asset::FLAG_CHANGED_SINCE_LOADED );
-		return true;
+		return false;
+	}
+
+	bool bObjectFileChanged = !FileContentsMatch( filepath, buffer );
+	if ( bObjectFileChanged && !WriteFileAtomic( filepath, buffer ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"LoosePackageLoader::SaveAsset(): Failed to write object file \"%s\" for \"%s\".\n",
+			filepath.Data(),
+			*pAsset->GetPath().ToString() );
+
+		return false;
 	}
 
-	return false;
+	FilePath sidecarPath;
+	if ( sm_bBinarySidecarsEnabled && ( bObjectFileChanged || !FindBinarySidecar( filepath, sidecarPath ) ) )
+	{
+		sidecarPath = filepath + ".msgpack";
+
+		buffer.Resize( 0 );
+
+		AssetIdentifier assetIdentifier;
+		DynamicMemoryStream archiveStream( &buffer );
+		Persist::ArchiveWriterMessagePack::WriteToStream( pAsset, archiveStream, &assetIdentifier );
+
+		// The object file is still good, so a failure here only costs the fast path on the next load.
+		if ( !WriteFileAtomic( sidecarPath, buffer ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"LoosePackageLoader::SaveAsset(): Failed to write binary sidecar \"%s\".\n",
+				sidecarPath.Data() );
+
+			Cache::RemoveFile( String( sidecarPath.Data() ) );
+		}
+	}
+
+	pAsset->ClearFlags( Asset::FLAG_CHANGED_SINCE_LOADED );
+
+	return true;
+}
+
+/// @copydoc PackageLoader::SerializeAsset()
+bool LoosePackageLoader::SerializeAsset( Asset *pAsset, DynamicArray< uint8_t > &rBuffer, FilePath &rFilePath ) const
+{
+	HELIUM_ASSERT( pAsset );
+	HELIUM_ASSERT( pAsset->GetOwningPackage() );
+	HELIUM_ASSERT( pAsset->GetOwningPackage()->GetLoader() == this );
+	HELIUM_ASSERT( pAsset->GetPath().GetParent() == GetPackagePath() );
+
+	rFilePath = GetAssetFileSystemPath( pAsset->GetPath() );
+	if ( !HELIUM_VERIFY( !rFilePath.Get().empty() ) )
+	{
+		return false;
+	}
+
+	rBuffer.Resize( 0 );
+
+	AssetIdentifier assetIdentifier;
+	DynamicMemoryStream archiveStream( &rBuffer );
+	Persist::ArchiveWriterJson::WriteToStream( pAsset, archiveStream, &assetIdentifier );
+
+	return true;
 }
 
 /// Get the package managed by this loader.
@@ -716,75 +910,38 @@ void LoosePackageLoader::TickPreload()
 			// the name is deduced from the file name (bad idea to store it in the file)
 			Name name( m_fileReadRequests[i].filePath.Basename().c_str() );
 
-			// read some preliminary data from the json
-			struct PreliminaryObjectHandler : rapidjson::BaseReaderHandler<>
-			{
-				Helium::Name typeName;
-				Helium::String templatePath;
-				bool templateIsNext;
-
-				PreliminaryObjectHandler()
-					: typeName( ENullName() )
-					, templatePath( "" )
-				{
-					templateIsNext = false;
-				}
-
-				bool Key( const Ch* chars, rapidjson::SizeType length, bool copy )
-				{
-					if ( typeName.IsEmpty() )
-					{
-						typeName.Set( Helium::String( chars, length ) );
-						return true;
-					}
-
-					if ( templatePath.IsEmpty() )
-					{
-						Helium::String str( chars, length );
-
-						if ( str == "m_spTemplate" )
-						{
-							templateIsNext = true;
-							return true;
-						}
-					}
-
-					return true;
-				}
-
-				bool String( const Ch* chars, rapidjson::SizeType length, bool copy )
-				{
-					if ( templatePath.IsEmpty() )
-					{
-						Helium::String str( chars, length );
-
-						if ( templateIsNext )
-						{
-							templatePath = str;
-							templateIsNext = false;
-							return true;
-						}
-					}
-
-					return true;
-				}
-			} handler;
-
-			// non destructive in-place stream helper
-			rapidjson::StringStream stream( static_cast<char*>( rRequest.pLoadBuffer ) );
-
-			// the main reader object
-			rapidjson::Reader reader;
-			if ( reader.Parse< rapidjson::kParseDefaultFlags >( stream, handler ) )
+			// Read some preliminary data from the json
+			Name typeName( NULL_NAME );
+			String templatePath;
+			if ( ReadPreliminaryData(
+				static_cast<const char*>( rRequest.pLoadBuffer ), name, rRequest.filePath.Data(), typeName, templatePath ) )
 			{
 				SerializedObjectData* pObjectData = m_objects.New();
 				HELIUM_ASSERT( pObjectData );
 				HELIUM_VERIFY( pObjectData->objectPath.Set( name, false, m_packagePath ) );
-				pObjectData->templatePath.Set( handler.templatePath );
-				pObjectData->typeName = handler.typeName;
+				pObjectData->templatePath.Set( templatePath );
+				pObjectData->typeName = typeName;
 				pObjectData->filePath = rRequest.filePath;
 				pObjectData->fileTimeStamp = rRequest.fileTimestamp;
 				pObjectData->bMetadataGood = true;
+				pObjectData->pRetainedFileBuffer = NULL;
+				pObjectData->retainedFileSize = 0;
+
+				// Keep the file contents around for deserializing the object, unless too much is kept already
+				if ( m_retainedFileBytes + rRequest.expectedSize <= RETAINED_FILE_BUDGET )
+				{
+					pObjectData->pRetainedFileBuffer = rRequest.pLoadBuffer;
+					pObjectData->retainedFileSize = static_cast<size_t>( rRequest.expectedSize );
+					m_retainedFileBytes += pObjectData->retainedFileSize;
+					rRequest.pLoadBuffer = NULL;
+				}
+
+				LoosePackageIndex::Entry indexEntry;
+				indexEntry.typeName = typeName;
+				indexEntry.templatePath = templatePath;
+				indexEntry.fileTimestamp = static_cast<int64_t>( rRequest.fileTimestamp );
+				indexEntry.fileSize = rRequest.expectedSize;
+				m_packageIndex.SetEntry( name, indexEntry );
 
 				HELIUM_TRACE(
 					TraceLevels::Debug,
@@ -792,21 +949,14 @@ void LoosePackageLoader::TickPreload()
 					*name,
 					rRequest.filePath.Data() );
 			}
-			else
-			{
-				HELIUM_TRACE(
-					TraceLevels::Error,
-					"LoosePackageLoader: Failure reading preliminary data for object '%s' from file '%s': Error parsing JSON (%d): %s\n",
-					*name,
-					rRequest.filePath.Data(),
-					reader.GetErrorOffset(),
-					rapidjson::GetParseError_En( reader.GetParseErrorCode() ) );
-			}
 		}
 
-		// We're finished with this load, so deallocate memory and get rid of the request
-		DefaultAllocator().Free( rRequest.pLoadBuffer );
-		rRequest.pLoadBuffer = NULL;
+		// We're finished with this load, so deallocate memory (unless it was retained) and get rid of the request
+		if ( rRequest.pLoadBuffer )
+		{
+			DefaultAllocator().Free( rRequest.pLoadBuffer );
+			rRequest.pLoadBuffer = NULL;
+		}
 		SetInvalid( rRequest.asyncLoadId );
 		m_fileReadRequests.RemoveSwap( i );
 	}
@@ -907,6 +1057,8 @@ void LoosePackageLoader::TickPreload()
 			pObjectData->filePath.Clear();
 			pObjectData->fileTimeStamp = packageDirectory.GetItem().m_ModTime;
 			pObjectData->bMetadataGood = true;
+			pObjectData->pRetainedFileBuffer = NULL;
+			pObjectData->retainedFileSize = 0;
 		}
 		else
 		{
@@ -927,6 +1079,18 @@ void LoosePackageLoader::TickPreload()
 		}
 	}
 
+	// Save what was learned about the files read this time, so the next preload can skip them.
+	if ( m_bPackageIndexDirty )
+	{
+		FilePath indexFilePath;
+		if ( LoosePackageIndex::GetIndexFilePath( m_packagePath, indexFilePath ) )
+		{
+			m_packageIndex.SaveToFile( indexFilePath );
+		}
+
+		m_bPackageIndexDirty = false;
+	}
+
 	// Package preloading is now complete.
 	pPackage->SetFlags( Asset::FLAG_PRELOADED | Asset::FLAG_LINKED );
 	pPackage->ConditionalFinalizeLoad();
@@ -970,6 +1134,193 @@ void LoosePackageLoader::TickLoadRequests()
 			}
 		}
 	}
+
+	// Read the properties of every object whose file is ready, then finish them here on the ticking thread.
+	if ( !m_deserializeRequests.IsEmpty() )
+	{
+		AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+		HELIUM_ASSERT( pAssetLoader );
+		pAssetLoader->RunParallel( DeserializeCallback, this, m_deserializeRequests.GetSize() );
+
+		for ( size_t deserializeIndex = 0; deserializeIndex < m_deserializeRequests.GetSize(); ++deserializeIndex )
+		{
+			FinishDeserialize( m_deserializeRequests[deserializeIndex], false );
+		}
+
+		m_deserializeRequests.Resize( 0 );
+	}
+}
+
+/// Read the type name and template path of an object from the contents of its object file, without deserializing it.
+///
+/// @param[in]  pText          Object file contents (null-terminated).
+/// @param[in]  objectName     Name of the object (for logging).
+/// @param[in]  pSourceName    Name of the file the contents were read from (for logging).
+/// @param[out] rTypeName      Type name.
+/// @param[out] rTemplatePath  Template path (empty for the type's default template).
+///
+/// @return  True if the data was read successfully, false if the object file could not be parsed.
+bool LoosePackageLoader::ReadPreliminaryData(
+	const char* pText,
+	Name objectName,
+	const char* pSourceName,
+	Name& rTypeName,
+	String& rTemplatePath )
+{
+	HELIUM_ASSERT( pText );
+
+	PreliminaryObjectHandler handler;
+
+	// non destructive in-place stream helper
+	rapidjson::StringStream stream( pText );
+
+	// the main reader object
+	rapidjson::Reader reader;
+	if ( !reader.Parse< rapidjson::kParseDefaultFlags >( stream, handler ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"LoosePackageLoader: Failure reading preliminary data for object '%s' from file '%s': Error parsing JSON (%d): %s\n",
+			*objectName,
+			pSourceName,
+			reader.GetErrorOffset(),
+			rapidjson::GetParseError_En( reader.GetParseErrorCode() ) );
+
+		return false;
+	}
+
+	rTypeName = handler.typeName;
+	rTemplatePath = handler.templatePath;
+
+	return true;
+}
+
+/// Set whether binary sidecar files are used.
+///
+/// A binary sidecar holds the same object as an object file, but in a format that is much faster to read.  It lives
+/// next to the object file with ".msgpack" appended to its name.  While enabled, saving an asset also writes its
+/// sidecar, and loading reads the sidecar instead of the object file as long as the sidecar is not older than it.
+/// The object file stays the authoritative copy, so sidecars can be deleted at any time.
+///
+/// @param[in] bEnabled  True to write and read binary sidecars, false to use only the object files.
+///
+/// @see GetBinarySidecarsEnabled()
+void LoosePackageLoader::SetBinarySidecarsEnabled( bool bEnabled )
+{
+	sm_bBinarySidecarsEnabled = bEnabled;
+}
+
+/// Get whether binary sidecar files are used.
+///
+/// @return  True if binary sidecars are written and read, false if only the object files are used.
+///
+/// @see SetBinarySidecarsEnabled()
+bool LoosePackageLoader::GetBinarySidecarsEnabled()
+{
+	return sm_bBinarySidecarsEnabled;
+}
+
+/// Find the binary sidecar of an object file that is still up to date.
+///
+/// @param[in]  rObjectFilePath  Object file path.
+/// @param[out] rSidecarPath     Sidecar file path.
+///
+/// @return  True if the sidecar exists and is not older than the object file, false if not.
+bool LoosePackageLoader::FindBinarySidecar( const FilePath& rObjectFilePath, FilePath& rSidecarPath )
+{
+	rSidecarPath = rObjectFilePath + ".msgpack";
+
+	Status objectFileStatus;
+	Status sidecarStatus;
+
+	return
+		objectFileStatus.Read( rObjectFilePath.Get().c_str() ) &&
+		sidecarStatus.Read( rSidecarPath.Get().c_str() ) &&
+		sidecarStatus.m_Size > 0 &&
+		sidecarStatus.m_ModifiedTime >= objectFileStatus.m_ModifiedTime;
+}
+
+#if HELIUM_TOOLS
+/// Check whether a file already holds the given contents.
+///
+/// @param[in] rPath  File path.
+/// @param[in] rData  Contents to compare against.
+///
+/// @return  True if the file exists and its contents are identical, false if not.
+bool LoosePackageLoader::FileContentsMatch( const FilePath& rPath, const DynamicArray< uint8_t >& rData )
+{
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_READ );
+	if ( !pFileStream )
+	{
+		return false;
+	}
+
+	bool bMatch = false;
+
+	int64_t fileSize = pFileStream->GetSize();
+	if ( fileSize >= 0 && static_cast< uint64_t >( fileSize ) == rData.GetSize() )
+	{
+		DynamicArray< uint8_t > fileData;
+		fileData.Resize( rData.GetSize() );
+
+		bMatch =
+			pFileStream->Read( fileData.GetData(), 1, fileData.GetSize() ) == fileData.GetSize() &&
+			MemoryCompare( fileData.GetData(), rData.GetData(), rData.GetSize() ) == 0;
+	}
+
+	delete pFileStream;
+
+	return bMatch;
+}
+
+/// Replace the contents of a file by writing them to a temporary file and renaming it over the original.
+///
+/// @param[in] rPath  File path.
+/// @param[in] rData  New file contents.
+///
+/// @return  True if the file was written, false if not (the original file is left untouched).
+bool LoosePackageLoader::WriteFileAtomic( const FilePath& rPath, const DynamicArray< uint8_t >& rData )
+{
+	String tempFileName;
+	tempFileName.Format( "%s.%016" PRIx64 ".tmp", rPath.Data(), static_cast< uint64_t >( Timer::GetTickCount() ) );
+
+	FileStream* pFileStream = FileStream::OpenFileStream( tempFileName.GetData(), FileStream::MODE_WRITE );
+	if ( !pFileStream )
+	{
+		return false;
+	}
+
+	bool bWritten = pFileStream->Write( rData.GetData(), 1, rData.GetSize() ) == rData.GetSize();
+
+	delete pFileStream;
+
+	if ( !bWritten || !Cache::RenameFile( tempFileName, String( rPath.Data() ) ) )
+	{
+		Cache::RemoveFile( tempFileName );
+
+		return false;
+	}
+
+	return true;
+}
+#endif
+
+/// Free the contents of an object file kept from preloading, if any.
+///
+/// @param[in] rObjectData  Object data holding the file contents.
+void LoosePackageLoader::ReleaseRetainedFile( SerializedObjectData& rObjectData )
+{
+	if ( !rObjectData.pRetainedFileBuffer )
+	{
+		return;
+	}
+
+	HELIUM_ASSERT( m_retainedFileBytes >= rObjectData.retainedFileSize );
+	m_retainedFileBytes -= rObjectData.retainedFileSize;
+
+	DefaultAllocator().Free( rObjectData.pRetainedFileBuffer );
+	rObjectData.pRetainedFileBuffer = NULL;
+	rObjectData.retainedFileSize = 0;
 }
 
 size_t LoosePackageLoader::FindObjectByPath( const AssetPath &path ) const
@@ -1103,10 +1454,37 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 
 	FilePath object_file_path = m_packageDirPath + *rObjectData.objectPath.GetName() + ".json";
 
+	// Contents of the file read during preload are handed over instead of reading the file again. They are only used
+	// once, and a forced reload always reads what is on disk now.
+	bool bRetainedFile = false;
+	if ( rObjectData.pRetainedFileBuffer && IsInvalid( pRequest->asyncFileLoadId ) && !pRequest->forceReload )
+	{
+		HELIUM_ASSERT( !pRequest->pAsyncFileLoadBuffer );
+		pRequest->pAsyncFileLoadBuffer = rObjectData.pRetainedFileBuffer;
+		pRequest->asyncFileLoadBufferSize = rObjectData.retainedFileSize;
+
+		m_retainedFileBytes -= rObjectData.retainedFileSize;
+		rObjectData.pRetainedFileBuffer = NULL;
+		rObjectData.retainedFileSize = 0;
+
+		bRetainedFile = true;
+	}
+	else
+	{
+		ReleaseRetainedFile( rObjectData );
+	}
+
 	bool load_properties_from_file = true;
 	size_t object_file_size = 0;
-	if ( !IsValid( pRequest->asyncFileLoadId ) )
+	if ( !bRetainedFile && !IsValid( pRequest->asyncFileLoadId ) )
 	{
+		FilePath sidecarPath;
+		if ( sm_bBinarySidecarsEnabled && FindBinarySidecar( object_file_path, sidecarPath ) )
+		{
+			object_file_path = sidecarPath;
+			pRequest->flags |= LOAD_FLAG_BINARY_FILE;
+		}
+
 		if ( !object_file_path.IsFile() )
 		{
 			if ( pType->GetMetaClass()->IsType( Reflect::GetMetaClass< Resource >() ) )
@@ -1184,6 +1562,11 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 
 			pRequest->asyncFileLoadBufferSize = object_file_size;
 
+			if ( AssetLoadTrace::IsEnabled() )
+			{
+				pRequest->asyncFileLoadStartTicks = Timer::GetTickCount();
+			}
+
 			pRequest->asyncFileLoadId = pAsyncLoader->QueueRequest(
 				pRequest->pAsyncFileLoadBuffer,
 				String( object_file_path.Data() ),
@@ -1194,7 +1577,11 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 	}
 
 	size_t bytesRead = 0;
-	if ( load_properties_from_file )
+	if ( bRetainedFile )
+	{
+		bytesRead = pRequest->asyncFileLoadBufferSize;
+	}
+	else if ( load_properties_from_file )
 	{
 		HELIUM_ASSERT( IsValid( pRequest->asyncFileLoadId ) );
 
@@ -1202,6 +1589,16 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 		{
 			return false;
 		}
+
+		if ( pRequest->asyncFileLoadStartTicks != 0 )
+		{
+			AssetLoadTrace::RecordStage(
+				AssetLoadTrace::STAGE_IO_WAIT,
+				rObjectData.objectPath,
+				pRequest->asyncFileLoadStartTicks,
+				Timer::GetTickCount() );
+			pRequest->asyncFileLoadStartTicks = 0;
+		}
 	}
 
 	/////// POINT OF NO RETURN: We *will* return true after this point, and the object *will* be finished preloading,
@@ -1291,22 +1688,92 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 		}
 		else
 		{
-			StaticMemoryStream archiveStream( pRequest->pAsyncFileLoadBuffer, pRequest->asyncFileLoadBufferSize );
-
-			HELIUM_TRACE(
-				TraceLevels::Info,
-				"LoosePackageLoader: Reading %s. pResolver = %x\n",
-				object_file_path.Data(),
-				pRequest->pResolver );
+			// Properties are read in parallel with those of the other objects ready this tick, after which
+			// FinishDeserialize() completes the request.
+			m_deserializeRequests.Push( pRequest );
 
-			DynamicArray< Reflect::ObjectPtr > objects;
-			objects.Push( pRequest->spObject.Get() ); // use existing objects
-			Persist::ArchiveReaderJson::ReadFromStream( archiveStream, objects, pRequest->pResolver );
-			HELIUM_ASSERT( objects[0].Get() == pRequest->spObject.Get() );
+			return false;
 		}
 	}
 
-	if ( load_properties_from_file )
+	FinishDeserialize( pRequest, object_creation_failure );
+
+	// Asset is now preloaded.
+	return true;
+}
+
+/// Read the properties of the object for a load request from its object file.
+///
+/// This runs through AssetLoader::RunParallel(), so it may run concurrently for different load requests.  Load
+/// requests begun by resolving object references are queued by the asset loader until its next tick.
+///
+/// @param[in] pRequest  Load request, for which the object has been created and the object file has been read.
+void LoosePackageLoader::DeserializeProperties( LoadRequest* pRequest )
+{
+	HELIUM_ASSERT( pRequest );
+	HELIUM_ASSERT( pRequest->spObject );
+	HELIUM_ASSERT( pRequest->pAsyncFileLoadBuffer );
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"LoosePackageLoader: Reading %s. pResolver = %x\n",
+		*m_objects[pRequest->index].objectPath.ToString(),
+		pRequest->pResolver );
+
+	uint64_t startTicks = AssetLoadTrace::IsEnabled() ? Timer::GetTickCount() : 0;
+
+	StaticMemoryStream archiveStream( pRequest->pAsyncFileLoadBuffer, pRequest->asyncFileLoadBufferSize );
+
+	DynamicArray< Reflect::ObjectPtr > objects;
+	objects.Push( pRequest->spObject.Get() ); // use existing objects
+	if ( pRequest->flags & LOAD_FLAG_BINARY_FILE )
+	{
+		Persist::ArchiveReaderMessagePack::ReadFromStream( archiveStream, objects, pRequest->pResolver );
+	}
+	else
+	{
+		Persist::ArchiveReaderJson::ReadFromStream( archiveStream, objects, pRequest->pResolver );
+	}
+	HELIUM_ASSERT( objects[0].Get() == pRequest->spObject.Get() );
+
+	if ( startTicks != 0 )
+	{
+		AssetLoadTrace::RecordStage(
+			AssetLoadTrace::STAGE_DESERIALIZE,
+			m_objects[pRequest->index].objectPath,
+			startTicks,
+			Timer::GetTickCount() );
+	}
+}
+
+/// AssetLoader::RunParallel() callback reading the properties of one request in the current tick's deserialize list.
+///
+/// @param[in] pContext  Package loader.
+/// @param[in] index     Index of the request in the deserialize list.
+void LoosePackageLoader::DeserializeCallback( void* pContext, size_t index )
+{
+	LoosePackageLoader* pLoader = static_cast< LoosePackageLoader* >( pContext );
+	HELIUM_ASSERT( pLoader );
+	HELIUM_ASSERT( index < pLoader->m_deserializeRequests.GetSize() );
+
+	pLoader->DeserializeProperties( pLoader->m_deserializeRequests[ index ] );
+}
+
+/// Complete property preloading for a load request, and begin loading its persistent resource data if it has any.
+///
+/// @param[in] pRequest                Load request to finish.
+/// @param[in] bObjectCreationFailure  True if the object could not be created or reused.
+void LoosePackageLoader::FinishDeserialize( LoadRequest* pRequest, bool bObjectCreationFailure )
+{
+	HELIUM_ASSERT( pRequest );
+
+	HELIUM_ASSERT( pRequest->index < m_objects.GetSize() );
+	SerializedObjectData& rObjectData = m_objects[pRequest->index];
+
+	Asset* pObject = pRequest->spObject;
+	HELIUM_ASSERT( pObject );
+
+	if ( pRequest->pAsyncFileLoadBuffer )
 	{
 		DefaultAllocator().Free( pRequest->pAsyncFileLoadBuffer );
 		pRequest->pAsyncFileLoadBuffer = NULL;
@@ -1315,7 +1782,7 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 
 	pRequest->flags |= LOAD_FLAG_PROPERTY_PRELOADED;
 
-	if ( object_creation_failure )
+	if ( bObjectCreationFailure )
 	{
 		HELIUM_TRACE(
 			TraceLevels::Error,
@@ -1349,9 +1816,9 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 				HELIUM_ASSERT( !pRequest->pCachedObjectDataBuffer );
 
 				pRequest->pCachedObjectDataBuffer =
-					static_cast<uint8_t*>( DefaultAllocator().Allocate( pEntry->size ) );
+					static_cast<uint8_t*>( DefaultAllocator().Allocate( pEntry->uncompressedSize ) );
 				HELIUM_ASSERT( pRequest->pCachedObjectDataBuffer );
-				pRequest->cachedObjectDataBufferSize = pEntry->size;
+				pRequest->cachedObjectDataBufferSize = pEntry->uncompressedSize;
 
 				AsyncLoader* pAsyncLoader = AsyncLoader::GetInstance();
 				HELIUM_ASSERT( pAsyncLoader );
@@ -1360,7 +1827,10 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 					pRequest->pCachedObjectDataBuffer,
 					pCache->GetCacheFileName(),
 					pEntry->offset,
-					pEntry->size );
+					pEntry->size,
+					AsyncLoader::PRIORITY_NORMAL,
+					static_cast< CompressionCodec >( pEntry->codec ),
+					pEntry->uncompressedSize );
 				HELIUM_ASSERT( IsValid( pRequest->persistentResourceDataLoadId ) );
 			}
 		}
@@ -1372,9 +1842,6 @@ bool LoosePackageLoader::TickDeserialize( LoadRequest* pRequest )
 		pObject->SetFlags( Asset::FLAG_PRELOADED );
 		pRequest->flags |= LOAD_FLAG_PERSISTENT_RESOURCE_PRELOADED;
 	}
-
-	// Asset is now preloaded.
-	return true;
 }
 
 /// Update processing of persistent resource data loading for a given load request.
@@ -6,6 +6,8 @@
 
 #include "Foundation/FilePath.h"
 
+#include "PcSupport/LoosePackageIndex.h"
+
 namespace Helium
 {
 	class LooseAssetFileWatcher;
@@ -18,6 +20,8 @@ namespace Helium
 
 		/// Maximum number of bytes to parse at a time.
 		static const size_t PARSE_CHUNK_SIZE = 4 * 1024;
+		/// Maximum number of bytes of object files read during preload kept for deserializing their objects.
+		static const size_t RETAINED_FILE_BUDGET = 16 * 1024 * 1024;
 
 		/// Serialized object data.
 		struct SerializedObjectData
@@ -34,6 +38,10 @@ namespace Helium
 			AssetPath templatePath;
 			/// Is metadata good?
 			bool bMetadataGood;
+			/// Object file contents read during preload (null-terminated), kept until the object is deserialized.
+			void* pRetainedFileBuffer;
+			/// Size of the retained object file contents, not counting the terminator.
+			size_t retainedFileSize;
 		};
 
 		/// @name Construction/Destruction
@@ -68,17 +76,32 @@ namespace Helium
 		AssetPath GetPackagePath() const;
 		//@}
 
+		/// @name Object File Parsing
+		//@{
+		static bool ReadPreliminaryData(
+			const char* pText, Name objectName, const char* pSourceName, Name& rTypeName, String& rTemplatePath );
+		//@}
+
+		/// @name Binary Sidecar Files
+		//@{
+		static void SetBinarySidecarsEnabled( bool bEnabled );
+		static bool GetBinarySidecarsEnabled();
+		static bool FindBinarySidecar( const FilePath& rObjectFilePath, FilePath& rSidecarPath );
+		//@}
+
 #if HELIUM_TOOLS
 		/// @name Package File Information
 		//@{
 		virtual bool HasAssetFileState() const;
 		virtual const FilePath &GetAssetFileSystemPath( const AssetPath &path ) const;
 		virtual int64_t GetAssetFileSystemTimestamp( const AssetPath &path ) const;
+		virtual Name GetAssetTypeName( const AssetPath &path ) const;
 		//@}
 		
 		virtual void EnumerateChildren( DynamicArray< AssetPath > &children ) const;
 
 		virtual bool SaveAsset( Asset *pAsset ) const;
+		virtual bool SerializeAsset( Asset *pAsset, DynamicArray< uint8_t > &rBuffer, FilePath &rFilePath ) const;
 #endif
 
 	private:
@@ -94,7 +117,10 @@ namespace Helium
 			LOAD_FLAG_PRELOADED = LOAD_FLAG_PROPERTY_PRELOADED | LOAD_FLAG_PERSISTENT_RESOURCE_PRELOADED,
 
 			/// Set when an error has occurred in the load process.
-			LOAD_FLAG_ERROR = 1 << 2
+			LOAD_FLAG_ERROR = 1 << 2,
+
+			/// Set when the properties are read from the binary sidecar instead of the object file.
+			LOAD_FLAG_BINARY_FILE = 1 << 3
 		};
 
 		/// Asset load request data.
@@ -129,6 +155,8 @@ namespace Helium
 			size_t asyncFileLoadId;
 			void* pAsyncFileLoadBuffer;
 			size_t asyncFileLoadBufferSize;
+			/// Tick count when the object file load was issued (only set while the load trace is enabled).
+			uint64_t asyncFileLoadStartTicks;
 
 			/// Load flags.
 			uint32_t flags;
@@ -172,19 +200,41 @@ namespace Helium
 		};
 		DynamicArray<FileReadRequest> m_fileReadRequests;
 
+		/// Preliminary data of the package's object files, rebuilt from the saved index and the files read during
+		/// preload.
+		LoosePackageIndex m_packageIndex;
+		/// True if the saved index is out of date and must be rewritten once preloading completes.
+		bool m_bPackageIndexDirty;
+		/// Total size of the object files kept from preloading.
+		size_t m_retainedFileBytes;
+
+		/// Load requests whose properties are read in parallel at the end of the current tick.
+		DynamicArray< LoadRequest* > m_deserializeRequests;
+
 		/// Parent package load request ID.
 		size_t m_parentPackageLoadId;
 
 		/// Mutex for synchronizing access between threads.
 		mutable Mutex m_accessLock;
 
+		/// True if binary sidecars are written when saving and preferred when loading.
+		static bool sm_bBinarySidecarsEnabled;
+
 		/// @name Private Utility Functions
 		//@{
 		void TickPreload();
 
 		void TickLoadRequests();
 		bool TickDeserialize( LoadRequest* pRequest );
+		void DeserializeProperties( LoadRequest* pRequest );
+		void FinishDeserialize( LoadRequest* pRequest, bool bObjectCreationFailure );
+		static void DeserializeCallback( void* pContext, size_t index );
+		void ReleaseRetainedFile( SerializedObjectData& rObjectData );
 		bool TickPersistentResourcePreload( LoadRequest* pRequest );
+#if HELIUM_TOOLS
+		static bool FileContentsMatch( const FilePath& rPath, const DynamicArray< uint8_t >& rData );
+		static bool WriteFileAtomic( const FilePath& rPath, const DynamicArray< uint8_t >& rData );
+#endif
 		//@}
 
 		size_t FindObjectByPath( const AssetPath &path ) const;
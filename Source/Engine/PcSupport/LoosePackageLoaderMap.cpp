@@ -5,6 +5,8 @@
 #include "Precompile.h"
 #include "PcSupport/LoosePackageLoaderMap.h"
 
+#include "Engine/ArchivePackageLoader.h"
+#include "Engine/FileLocations.h"
 #include "PcSupport/LoosePackageLoader.h"
 
 namespace Helium
@@ -17,12 +19,12 @@ namespace Helium
     /// Destructor.
     LoosePackageLoaderMap::~LoosePackageLoaderMap()
     {
-        ConcurrentHashMap< AssetPath, LoosePackageLoader* >::ConstAccessor loaderAccessor;
+        ConcurrentHashMap< AssetPath, PackageLoader* >::ConstAccessor loaderAccessor;
         if( m_packageLoaderMap.First( loaderAccessor ) )
         {
             do
             {
-                LoosePackageLoader* pLoader = loaderAccessor->Second();
+                PackageLoader* pLoader = loaderAccessor->Second();
                 HELIUM_ASSERT( pLoader );
 
                 delete pLoader;
@@ -37,7 +39,7 @@ namespace Helium
     /// @param[in] path  Asset path.
     ///
     /// @return  Package loader to use to load the specified object.
-    LoosePackageLoader* LoosePackageLoaderMap::GetPackageLoader( AssetPath path )
+    PackageLoader* LoosePackageLoaderMap::GetPackageLoader( AssetPath path )
     {
         HELIUM_ASSERT( !path.IsEmpty() );
 
@@ -58,29 +60,25 @@ namespace Helium
         }
 
         // Locate an existing package loader.
-        ConcurrentHashMap< AssetPath, LoosePackageLoader* >::ConstAccessor constMapAccessor;
+        ConcurrentHashMap< AssetPath, PackageLoader* >::ConstAccessor constMapAccessor;
         if( m_packageLoaderMap.Find( constMapAccessor, packagePath ) )
         {
-            LoosePackageLoader* pLoader = constMapAccessor->Second();
+            PackageLoader* pLoader = constMapAccessor->Second();
             HELIUM_ASSERT( pLoader );
 
             return pLoader;
         }
 
         // Add a new package loader entry.
-        ConcurrentHashMap< AssetPath, LoosePackageLoader* >::Accessor mapAccessor;
+        ConcurrentHashMap< AssetPath, PackageLoader* >::Accessor mapAccessor;
         bool bInserted = m_packageLoaderMap.Insert(
             mapAccessor,
-            KeyValue< AssetPath, LoosePackageLoader* >( packagePath, NULL ) );
+            KeyValue< AssetPath, PackageLoader* >( packagePath, NULL ) );
         if( bInserted )
         {
             // Entry added, so create and initialize the package loader.
-            LoosePackageLoader* pLoader = new LoosePackageLoader;
-            HELIUM_ASSERT( pLoader );
-
-            bool bInitResult = pLoader->Initialize( packagePath );
-            HELIUM_ASSERT( bInitResult );
-            if( !bInitResult )
+            PackageLoader* pLoader = CreatePackageLoader( packagePath );
+            if( !pLoader )
             {
                 HELIUM_TRACE(
                     TraceLevels::Error,
@@ -92,8 +90,6 @@ namespace Helium
                 return NULL;
             }
 
-            HELIUM_VERIFY( pLoader->BeginPreload() );
-
             mapAccessor->Second() = pLoader;
         }
 
@@ -108,30 +104,90 @@ namespace Helium
         // Easy fix may be to allocate and construct (but don't completely init) an LoosePackageLoader, and try
         // to insert that directly rather than the null above. If insert succeeds, finish, else ditch our loader
         // and grab the one out of the array
-        LoosePackageLoader* pLoader = mapAccessor->Second();
+        PackageLoader* pLoader = mapAccessor->Second();
         HELIUM_ASSERT( pLoader );
 
         return pLoader;
     }
 
+    /// Create, initialize and begin preloading the loader for a package.
+    ///
+    /// Packages are loaded from their packed archive if there is one and either their directory of object files does
+    /// not exist or HELIUM_PREFER_PACKAGE_ARCHIVES is set.  Otherwise, they are loaded from the object files.
+    ///
+    /// @param[in] packagePath  Package path.
+    ///
+    /// @return  Package loader, or null if the loader could not be initialized.
+    PackageLoader* LoosePackageLoaderMap::CreatePackageLoader( AssetPath packagePath )
+    {
+        FilePath archiveFilePath;
+        if( PackageArchive::GetArchiveFilePath( packagePath, archiveFilePath ) && archiveFilePath.IsFile() )
+        {
+            bool bUseArchive = ( HELIUM_PREFER_PACKAGE_ARCHIVES != 0 );
+            if( !bUseArchive )
+            {
+                FilePath dataDirectory;
+                bUseArchive = FileLocations::GetDataDirectory( dataDirectory ) &&
+                    !FilePath( dataDirectory + packagePath.ToFilePathString().GetData() ).IsDirectory();
+            }
+
+            if( bUseArchive )
+            {
+                ArchivePackageLoader* pArchiveLoader = new ArchivePackageLoader;
+                HELIUM_ASSERT( pArchiveLoader );
+                if( pArchiveLoader->Initialize( packagePath, archiveFilePath ) )
+                {
+                    HELIUM_VERIFY( pArchiveLoader->BeginPreload() );
+
+                    return pArchiveLoader;
+                }
+
+                // Fall back to the object files if the archive is unusable.
+                HELIUM_TRACE(
+                    TraceLevels::Warning,
+                    "LoosePackageLoaderMap: Could not load package \"%s\" from archive \"%s\"; loading its object files instead.\n",
+                    *packagePath.ToString(),
+                    archiveFilePath.Data() );
+
+                delete pArchiveLoader;
+            }
+        }
+
+        LoosePackageLoader* pLoader = new LoosePackageLoader;
+        HELIUM_ASSERT( pLoader );
+
+        bool bInitResult = pLoader->Initialize( packagePath );
+        HELIUM_ASSERT( bInitResult );
+        if( !bInitResult )
+        {
+            delete pLoader;
+
+            return NULL;
+        }
+
+        HELIUM_VERIFY( pLoader->BeginPreload() );
+
+        return pLoader;
+    }
+
     /// Tick all package loaders for a given AssetLoader tick.
     void LoosePackageLoaderMap::TickPackageLoaders()
     {        
         /// Cached list of package loaders iterated over in Tick() (separated to avoid deadlocks with concurrent hash
         /// map access).
-        DynamicArray< LoosePackageLoader* > m_packageLoaderTickArray;
+        DynamicArray< PackageLoader* > m_packageLoaderTickArray;
 
         // Build the list of package loaders to update this tick from the loader map (the Tick() for a given package
         // loader could require modification to the package loader map, which would cause a deadlock if we have the same
         // part of the hash map locked as which needs to be updated).
         //HELIUM_ASSERT( m_packageLoaderTickArray.IsEmpty() );
 
-        ConcurrentHashMap< AssetPath, LoosePackageLoader* >::ConstAccessor loaderAccessor;
+        ConcurrentHashMap< AssetPath, PackageLoader* >::ConstAccessor loaderAccessor;
         if( m_packageLoaderMap.First( loaderAccessor ) )
         {
             do
             {
-                LoosePackageLoader* pLoader = loaderAccessor->Second();
+                PackageLoader* pLoader = loaderAccessor->Second();
                 HELIUM_ASSERT( pLoader );
                 m_packageLoaderTickArray.Push( pLoader );
 
@@ -143,7 +199,7 @@ namespace Helium
         size_t loaderCount = m_packageLoaderTickArray.GetSize();
         for( size_t loaderIndex = 0; loaderIndex < loaderCount; ++loaderIndex )
         {
-            LoosePackageLoader* pLoader = m_packageLoaderTickArray[ loaderIndex ];
+            PackageLoader* pLoader = m_packageLoaderTickArray[ loaderIndex ];
             HELIUM_ASSERT( pLoader );
             pLoader->Tick();
         }
@@ -6,9 +6,15 @@
 
 #include "Engine/AssetPath.h"
 
+/// Non-zero to load packages from their packed archive (see PackageArchive) even if their directory of object files
+/// exists.  Packages that only exist as an archive are always loaded from it.
+#ifndef HELIUM_PREFER_PACKAGE_ARCHIVES
+#define HELIUM_PREFER_PACKAGE_ARCHIVES 0
+#endif
+
 namespace Helium
 {
-    class LoosePackageLoader;
+    class PackageLoader;
 
     /// Archive package loader management for object loaders.
     class HELIUM_PC_SUPPORT_API LoosePackageLoaderMap
@@ -22,13 +28,18 @@ namespace Helium
 
         /// @name Package Loader Access
         //@{
-        LoosePackageLoader* GetPackageLoader( AssetPath path );
+        PackageLoader* GetPackageLoader( AssetPath path );
         void TickPackageLoaders();
         //@}
 
     private:
         /// Package loader hash map (package path used as loader key).
-        ConcurrentHashMap< AssetPath, LoosePackageLoader* > m_packageLoaderMap;
+        ConcurrentHashMap< AssetPath, PackageLoader* > m_packageLoaderMap;
+
+        /// @name Private Utility Functions
+        //@{
+        static PackageLoader* CreatePackageLoader( AssetPath packagePath );
+        //@}
 
     };
 }
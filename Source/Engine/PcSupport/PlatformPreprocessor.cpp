@@ -13,6 +13,17 @@ PlatformPreprocessor::~PlatformPreprocessor()
 ///
 /// @return  Preferred platform byte order.
 
+/// Get a hash of the options with which this preprocessor generates data (such as shader compiler flags).
+///
+/// The hash is part of the input hash recorded for each preprocessed resource, so resources are preprocessed again
+/// for this platform whenever the options change.
+///
+/// @return  Preprocessing options hash.
+uint64_t PlatformPreprocessor::GetCookOptionsHash() const
+{
+    return 0;
+}
+
 /// @fn size_t PlatformPreprocessor::GetShaderProfileCount() const
 /// Get the number of different shader profiles for the target platform.
 ///
@@ -20,7 +31,7 @@ PlatformPreprocessor::~PlatformPreprocessor()
 ///
 /// @see CompileShader()
 
-/// @fn bool PlatformPreprocessor::CompileShader( size_t profileIndex, RShader::EType type, const void* pShaderCode, size_t shaderCodeSize, const ShaderToken* pTokens, size_t tokenCount, DynamicArray< uint8_t >& rMicrocode, DynamicArray< String >* pErrorMessages )
+/// @fn bool PlatformPreprocessor::CompileShader( size_t profileIndex, RShader::EType type, const void* pShaderCode, size_t shaderCodeSize, const ShaderToken* pTokens, size_t tokenCount, DynamicArray< uint8_t >& rMicrocode, DynamicArray< String >* pErrorMessages, DynamicArray< FilePath >* pIncludedFiles )
 /// Compile a shader for the target platform.
 ///
 /// @param[in]  rShaderPath     FilePath to the shader file being compiled.
@@ -34,10 +45,47 @@ PlatformPreprocessor::~PlatformPreprocessor()
 /// @param[out] rCompiledCode   Buffer in which the compiled shader code will be stored.
 /// @param[out] pErrorMessages  Optional array in which to store error messages generated during the shader
 ///                             compilation process.
+/// @param[out] pIncludedFiles  Optional array to which the path of every file included by the shader is added.
 ///
 /// @return  True if the shader was compiled successfully, false if not.
 ///
-/// @see GetShaderProfileCount()
+/// @see GetShaderProfileCount(), PreprocessShader()
+
+/// Run the preprocessor of the target platform's shader compiler on a shader without compiling it.
+///
+/// The output covers everything that affects compiling the shader with CompileShader() using the same arguments
+/// (including the contents of any included files), so its hash can be used to share compiled code between shader
+/// variants and machines.  Platforms that do not support this return false, in which case shaders are always
+/// compiled.
+///
+/// @param[in]  rShaderPath        FilePath to the shader file being preprocessed.
+/// @param[in]  profileIndex       Index of the target shader profile.
+/// @param[in]  type               Shader type.
+/// @param[in]  pShaderCode        Pointer to the loaded shader code to preprocess.
+/// @param[in]  shaderCodeSize     Size of the shader code, in bytes.
+/// @param[in]  pTokens            Array of shader preprocessor tokens.
+/// @param[in]  tokenCount         Number of shader preprocessor tokens in the given array.
+/// @param[out] rPreprocessedCode  Buffer in which the preprocessed shader code will be stored.
+/// @param[out] pIncludedFiles     Optional array to which the path of every file included by the shader is added.
+///
+/// @return  True if the shader was preprocessed successfully, false if not.
+///
+/// @see CompileShader()
+bool PlatformPreprocessor::PreprocessShader(
+    const FilePath& /*rShaderPath*/,
+    size_t /*profileIndex*/,
+    RShader::EType /*type*/,
+    const void* /*pShaderCode*/,
+    size_t /*shaderCodeSize*/,
+    const ShaderToken* /*pTokens*/,
+    size_t /*tokenCount*/,
+    DynamicArray< uint8_t >& rPreprocessedCode,
+    DynamicArray< FilePath >* /*pIncludedFiles*/ )
+{
+    rPreprocessedCode.Resize( 0 );
+
+    return false;
+}
 
 /// @fn bool PlatformPreprocessor::FillShaderReflectionData( size_t profileIndex, const void* pCompiledCode, size_t compiledCodeSize, DynamicArray< ShaderConstantBufferInfo >& rConstantBuffers, DynamicArray< ShaderSamplerInfo >& rSamplers, DynamicArray< ShaderTextureInfo >& rTextures )
 /// Fill out data about the shader constants and texture inputs.
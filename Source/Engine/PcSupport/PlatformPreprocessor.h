@@ -55,6 +55,8 @@ namespace Helium
         //@{
         virtual EByteOrder GetByteOrder() const = 0;
         inline bool SwapBytes() const;
+
+        virtual uint64_t GetCookOptionsHash() const;
         //@}
 
         /// @name Shader Compiling
@@ -63,7 +65,11 @@ namespace Helium
         virtual bool CompileShader(
             const FilePath& rShaderPath, size_t profileIndex, RShader::EType type, const void* pShaderCode,
             size_t shaderCodeSize, const ShaderToken* pTokens, size_t tokenCount, DynamicArray< uint8_t >& rCompiledCode,
-            DynamicArray< String >* pErrorMessages ) = 0;
+            DynamicArray< String >* pErrorMessages, DynamicArray< FilePath >* pIncludedFiles = NULL ) = 0;
+        virtual bool PreprocessShader(
+            const FilePath& rShaderPath, size_t profileIndex, RShader::EType type, const void* pShaderCode,
+            size_t shaderCodeSize, const ShaderToken* pTokens, size_t tokenCount,
+            DynamicArray< uint8_t >& rPreprocessedCode, DynamicArray< FilePath >* pIncludedFiles = NULL );
         virtual bool FillShaderReflectionData(
             size_t profileIndex, const void* pCompiledCode, size_t compiledCodeSize,
             DynamicArray< ShaderConstantBufferInfo >& rConstantBuffers, DynamicArray< ShaderSamplerInfo >& rSamplers,
@@ -48,6 +48,33 @@ bool ResourceHandler::CacheResource(
 {
     return false;
 }
+
+/// Get whether CacheResource() may be called for several resources at once from different threads.
+///
+/// Handlers that keep shared state (such as a third-party library instance) or that load other assets while caching
+/// must return false, in which case AssetPreprocessor runs them one at a time on the thread ending a cook batch, after
+/// every concurrent handler of the batch has finished.
+///
+/// @return  True if resources can be cached concurrently, false if not.
+///
+/// @see AssetPreprocessor::EndCookBatch()
+bool ResourceHandler::CanCacheConcurrently() const
+{
+    return false;
+}
+
+/// Get the version of the preprocessing performed by this handler.
+///
+/// The version is part of the input hash recorded for each preprocessed resource, so handlers should increase it
+/// whenever a change to CacheResource() would produce different data from the same source file.
+///
+/// @return  Preprocessing version.
+///
+/// @see AssetPreprocessor::LoadResourceData()
+uint32_t ResourceHandler::GetCookVersion() const
+{
+    return 1;
+}
 #endif  // HELIUM_TOOLS
 
 
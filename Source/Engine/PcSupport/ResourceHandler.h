@@ -34,6 +34,8 @@ namespace Helium
 #if HELIUM_TOOLS
         virtual bool CacheResource(
             AssetPreprocessor* pAssetPreprocessor, Resource* pResource, const String& rSourceFilePath );
+        virtual bool CanCacheConcurrently() const;
+        virtual uint32_t GetCookVersion() const;
         
         void SaveObjectToPersistentDataBuffer(Reflect::Object *_object, DynamicArray< uint8_t > &_buffer);
 #endif
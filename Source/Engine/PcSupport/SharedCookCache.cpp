@@ -0,0 +1,560 @@
+#include "Precompile.h"
+#include "PcSupport/SharedCookCache.h"
+
+#include "Platform/File.h"
+#include "Platform/Timer.h"
+#include "Foundation/BufferedStream.h"
+#include "Foundation/DirectoryIterator.h"
+#include "Foundation/FileStream.h"
+#include "Engine/Cache.h"
+#include "Engine/FileLocations.h"
+
+#include <algorithm>
+
+using namespace Helium;
+
+/// Index file format version.
+static const uint32_t LOCAL_INDEX_VERSION = 1;
+
+/// Local entry considered for removal when trimming the local directory.
+struct TrimCandidate
+{
+	/// Entry key.
+	uint64_t key;
+	/// Entry file size, in bytes.
+	uint64_t size;
+	/// Use counter value when the entry was last used.
+	uint64_t lastUse;
+};
+
+/// Sort predicate ordering trim candidates from least to most recently used.
+struct TrimCandidateLess
+{
+	bool operator()( const TrimCandidate& rA, const TrimCandidate& rB ) const
+	{
+		return ( rA.lastUse != rB.lastUse ? rA.lastUse < rB.lastUse : rA.key < rB.key );
+	}
+};
+
+/// Parse the key of an entry from its file name (without extension).
+///
+/// @param[in]  rName  File name.
+/// @param[out] rKey   Entry key.
+///
+/// @return  True if the name is a valid key, false if not.
+static bool ParseEntryKey( const std::string& rName, uint64_t& rKey )
+{
+	if( rName.size() != 16 )
+	{
+		return false;
+	}
+
+	uint64_t key = 0;
+	for( size_t characterIndex = 0; characterIndex < rName.size(); ++characterIndex )
+	{
+		char character = rName[ characterIndex ];
+
+		uint64_t digit;
+		if( character >= '0' && character <= '9' )
+		{
+			digit = static_cast< uint64_t >( character - '0' );
+		}
+		else if( character >= 'a' && character <= 'f' )
+		{
+			digit = static_cast< uint64_t >( character - 'a' + 10 );
+		}
+		else
+		{
+			return false;
+		}
+
+		key = ( key << 4 ) | digit;
+	}
+
+	rKey = key;
+
+	return true;
+}
+
+/// Constructor.
+SharedCookCache::SharedCookCache()
+	: m_localSizeMax( DEFAULT_LOCAL_SIZE_MAX )
+	, m_localSize( 0 )
+	, m_useCounter( 0 )
+	, m_bLocalEntriesLoaded( false )
+	, m_bLocalIndexDirty( false )
+{
+}
+
+/// Set the directory in which shared entries are kept.
+///
+/// This should only be changed while no entries are being fetched or stored.
+///
+/// @param[in] rDirectory  Remote directory path, or an empty path to disable sharing.
+///
+/// @see GetRemoteDirectory(), IsEnabled()
+void SharedCookCache::SetRemoteDirectory( const FilePath& rDirectory )
+{
+	m_remoteDirectory = rDirectory;
+}
+
+/// Set the maximum size of the entries kept in the local directory.
+///
+/// The local directory is only trimmed to this size on the next call to Flush().
+///
+/// @param[in] sizeMax  Maximum local size, in bytes.
+///
+/// @see GetLocalSizeMax()
+void SharedCookCache::SetLocalSizeMax( uint64_t sizeMax )
+{
+	MutexScopeLock scopeLock( m_localLock );
+
+	m_localSizeMax = sizeMax;
+}
+
+/// Fetch the data of an entry.
+///
+/// The local directory is checked first.  Entries only found in the remote directory are copied to the local
+/// directory.
+///
+/// @param[in]  key    Entry key.
+/// @param[out] rData  Entry data.
+///
+/// @return  True if the entry was found, false if not (or if sharing is disabled).
+///
+/// @see Store()
+bool SharedCookCache::Fetch( uint64_t key, DynamicArray< uint8_t >& rData )
+{
+	rData.Resize( 0 );
+
+	if( !IsEnabled() )
+	{
+		return false;
+	}
+
+	FilePath localDirectory;
+	FilePath localPath;
+	bool bLocal = GetLocalDirectory( localDirectory ) && GetEntryFilePath( localDirectory, key, localPath );
+	if( bLocal && ReadEntryFile( localPath, key, rData ) )
+	{
+		TouchLocalEntry( key, sizeof( EntryFileHeader ) + rData.GetSize() );
+
+		return true;
+	}
+
+	FilePath remotePath;
+	if( !GetEntryFilePath( m_remoteDirectory, key, remotePath ) || !ReadEntryFile( remotePath, key, rData ) )
+	{
+		return false;
+	}
+
+	if( bLocal && WriteEntryFile( localPath, key, rData ) )
+	{
+		TouchLocalEntry( key, sizeof( EntryFileHeader ) + rData.GetSize() );
+	}
+
+	return true;
+}
+
+/// Store the data of an entry in both the local and remote directories.
+///
+/// The remote entry is left alone if it already exists, as entries with the same key are built from the same inputs.
+///
+/// @param[in] key    Entry key.
+/// @param[in] rData  Entry data.
+///
+/// @see Fetch()
+void SharedCookCache::Store( uint64_t key, const DynamicArray< uint8_t >& rData )
+{
+	if( !IsEnabled() || rData.GetSize() > UINT32_MAX )
+	{
+		return;
+	}
+
+	FilePath localDirectory;
+	FilePath localPath;
+	if( GetLocalDirectory( localDirectory ) &&
+		GetEntryFilePath( localDirectory, key, localPath ) &&
+		WriteEntryFile( localPath, key, rData ) )
+	{
+		TouchLocalEntry( key, sizeof( EntryFileHeader ) + rData.GetSize() );
+	}
+
+	FilePath remotePath;
+	if( GetEntryFilePath( m_remoteDirectory, key, remotePath ) && !remotePath.Exists() )
+	{
+		if( !WriteEntryFile( remotePath, key, rData ) )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"SharedCookCache::Store(): Failed to write shared entry \"%s\".\n",
+				remotePath.Data() );
+		}
+	}
+}
+
+/// Trim the local directory to its maximum size, removing the least recently used entries first, and save the
+/// local index if it has changed.
+void SharedCookCache::Flush()
+{
+	MutexScopeLock scopeLock( m_localLock );
+
+	if( !m_bLocalEntriesLoaded )
+	{
+		return;
+	}
+
+	FilePath localDirectory;
+	if( !GetLocalDirectory( localDirectory ) )
+	{
+		return;
+	}
+
+	if( m_localSize > m_localSizeMax )
+	{
+		DynamicArray< TrimCandidate > candidates;
+		candidates.Reserve( m_localEntries.GetSize() );
+		for( HashMap< uint64_t, LocalEntry >::ConstIterator entryIterator = m_localEntries.Begin();
+			entryIterator != m_localEntries.End(); ++entryIterator )
+		{
+			TrimCandidate* pCandidate = candidates.New();
+			HELIUM_ASSERT( pCandidate );
+			pCandidate->key = entryIterator->First();
+			pCandidate->size = entryIterator->Second().size;
+			pCandidate->lastUse = entryIterator->Second().lastUse;
+		}
+
+		std::sort( candidates.GetData(), candidates.GetData() + candidates.GetSize(), TrimCandidateLess() );
+
+		size_t removedCount = 0;
+		size_t candidateCount = candidates.GetSize();
+		for( size_t candidateIndex = 0;
+			candidateIndex < candidateCount && m_localSize > m_localSizeMax;
+			++candidateIndex )
+		{
+			const TrimCandidate& rCandidate = candidates[ candidateIndex ];
+
+			FilePath entryPath;
+			if( GetEntryFilePath( localDirectory, rCandidate.key, entryPath ) )
+			{
+				Cache::RemoveFile( String( entryPath.Data() ) );
+			}
+
+			HashMap< uint64_t, LocalEntry >::Iterator entryIterator = m_localEntries.Find( rCandidate.key );
+			HELIUM_ASSERT( entryIterator != m_localEntries.End() );
+			m_localEntries.Remove( entryIterator );
+
+			m_localSize -= rCandidate.size;
+			++removedCount;
+		}
+
+		HELIUM_TRACE(
+			TraceLevels::Info,
+			"SharedCookCache::Flush(): Removed %" PRIuSZ " least recently used local entries.\n",
+			removedCount );
+
+		m_bLocalIndexDirty = true;
+	}
+
+	if( !m_bLocalIndexDirty )
+	{
+		return;
+	}
+
+	FilePath indexPath( localDirectory.Get() + "/index.db" );
+	FileStream* pFileStream = FileStream::OpenFileStream( indexPath.Data(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"SharedCookCache::Flush(): Failed to open \"%s\" for writing.\n",
+			indexPath.Data() );
+
+		return;
+	}
+
+	{
+		BufferedStream bufferedStream( pFileStream );
+
+		uint32_t version = LOCAL_INDEX_VERSION;
+		bufferedStream.Write( &version, sizeof( version ), 1 );
+		bufferedStream.Write( &m_useCounter, sizeof( m_useCounter ), 1 );
+
+		uint64_t entryCount = m_localEntries.GetSize();
+		bufferedStream.Write( &entryCount, sizeof( entryCount ), 1 );
+		for( HashMap< uint64_t, LocalEntry >::ConstIterator entryIterator = m_localEntries.Begin();
+			entryIterator != m_localEntries.End(); ++entryIterator )
+		{
+			bufferedStream.Write( &entryIterator->First(), sizeof( uint64_t ), 1 );
+			bufferedStream.Write( &entryIterator->Second().lastUse, sizeof( uint64_t ), 1 );
+		}
+	}
+
+	delete pFileStream;
+
+	m_bLocalIndexDirty = false;
+}
+
+/// Scan the entries in the local directory, restoring when each was last used from the local index.
+///
+/// The directory itself is the authority on which entries exist, so entries written by a process that exited before
+/// saving the index are still accounted for (as least recently used).  The local lock must be held when calling this.
+void SharedCookCache::LoadLocalEntries()
+{
+	if( m_bLocalEntriesLoaded )
+	{
+		return;
+	}
+
+	m_bLocalEntriesLoaded = true;
+
+	FilePath localDirectory;
+	if( !GetLocalDirectory( localDirectory ) )
+	{
+		return;
+	}
+
+	HashMap< uint64_t, uint64_t > lastUses;
+
+	FilePath indexPath( localDirectory.Get() + "/index.db" );
+	FileStream* pFileStream = NULL;
+	if( indexPath.Exists() )
+	{
+		pFileStream = FileStream::OpenFileStream( indexPath.Data(), FileStream::MODE_READ );
+	}
+
+	if( pFileStream )
+	{
+		uint32_t version = 0;
+		uint64_t entryCount = 0;
+		if( pFileStream->Read( &version, sizeof( version ), 1 ) == 1 &&
+			version == LOCAL_INDEX_VERSION &&
+			pFileStream->Read( &m_useCounter, sizeof( m_useCounter ), 1 ) == 1 &&
+			pFileStream->Read( &entryCount, sizeof( entryCount ), 1 ) == 1 )
+		{
+			for( uint64_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+			{
+				uint64_t entry[ 2 ];
+				if( pFileStream->Read( entry, sizeof( uint64_t ), 2 ) != 2 )
+				{
+					break;
+				}
+
+				HashMap< uint64_t, uint64_t >::Iterator useIterator = lastUses.Find( entry[ 0 ] );
+				if( useIterator == lastUses.End() )
+				{
+					lastUses.Insert( useIterator, HashMap< uint64_t, uint64_t >::ValueType( entry[ 0 ], entry[ 1 ] ) );
+				}
+			}
+		}
+
+		delete pFileStream;
+	}
+
+	for( DirectoryIterator directory( localDirectory ); !directory.IsDone(); directory.Next() )
+	{
+		const DirectoryIteratorItem& rItem = directory.GetItem();
+
+		uint64_t key = 0;
+		if( rItem.m_Path.IsDirectory() || rItem.m_Path.Extension() != "cook" || !ParseEntryKey( rItem.m_Path.Basename(), key ) )
+		{
+			continue;
+		}
+
+		Status stat;
+		if( !stat.Read( rItem.m_Path.Data() ) )
+		{
+			continue;
+		}
+
+		LocalEntry localEntry;
+		localEntry.size = stat.m_Size;
+		localEntry.lastUse = 0;
+
+		HashMap< uint64_t, uint64_t >::ConstIterator useIterator = lastUses.Find( key );
+		if( useIterator != lastUses.End() )
+		{
+			localEntry.lastUse = useIterator->Second();
+		}
+
+		HashMap< uint64_t, LocalEntry >::Iterator entryIterator = m_localEntries.Find( key );
+		if( entryIterator == m_localEntries.End() )
+		{
+			m_localEntries.Insert( entryIterator, HashMap< uint64_t, LocalEntry >::ValueType( key, localEntry ) );
+			m_localSize += localEntry.size;
+		}
+	}
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"SharedCookCache::LoadLocalEntries(): Found %" PRIuSZ " local entries (%" PRIu64 " bytes).\n",
+		m_localEntries.GetSize(),
+		m_localSize );
+}
+
+/// Mark a local entry as the most recently used, adding it if it is not known yet.
+///
+/// @param[in] key   Entry key.
+/// @param[in] size  Entry file size, in bytes.
+void SharedCookCache::TouchLocalEntry( uint64_t key, uint64_t size )
+{
+	MutexScopeLock scopeLock( m_localLock );
+
+	LoadLocalEntries();
+
+	LocalEntry localEntry;
+	localEntry.size = size;
+	localEntry.lastUse = ++m_useCounter;
+
+	HashMap< uint64_t, LocalEntry >::Iterator entryIterator = m_localEntries.Find( key );
+	if( entryIterator != m_localEntries.End() )
+	{
+		m_localSize -= entryIterator->Second().size;
+		entryIterator->Second() = localEntry;
+	}
+	else
+	{
+		m_localEntries.Insert( entryIterator, HashMap< uint64_t, LocalEntry >::ValueType( key, localEntry ) );
+	}
+
+	m_localSize += size;
+	m_bLocalIndexDirty = true;
+}
+
+/// Get the local directory, creating it if it does not exist.
+///
+/// @param[out] rDirectory  Local directory path.
+///
+/// @return  True if the directory exists, false if no user data directory is available or it could not be created.
+bool SharedCookCache::GetLocalDirectory( FilePath& rDirectory )
+{
+	FilePath userDirectory;
+	if( !FileLocations::GetUserDirectory( userDirectory ) )
+	{
+		return false;
+	}
+
+	rDirectory = FilePath( userDirectory.Get() + "SharedCookCache" );
+
+	// Another process may create the directory at the same time, so only fail if it still does not exist.
+	return ( rDirectory.Exists() || rDirectory.MakePath() || rDirectory.Exists() );
+}
+
+/// Get the path of an entry file.
+///
+/// @param[in]  rDirectory  Directory holding the entry.
+/// @param[in]  key         Entry key.
+/// @param[out] rPath       Entry file path.
+///
+/// @return  True if the path was determined, false if the directory path is empty.
+bool SharedCookCache::GetEntryFilePath( const FilePath& rDirectory, uint64_t key, FilePath& rPath )
+{
+	if( rDirectory.Get().empty() )
+	{
+		return false;
+	}
+
+	String fileName;
+	fileName.Format( "%016" PRIx64 ".cook", key );
+
+	rPath = FilePath( rDirectory.Get() + "/" + fileName.GetData() );
+
+	return true;
+}
+
+/// Read the data of an entry file.
+///
+/// @param[in]  rPath  Entry file path.
+/// @param[in]  key    Key the entry is expected to have.
+/// @param[out] rData  Entry data.
+///
+/// @return  True if the entry was read, false if the file does not exist or is invalid.
+bool SharedCookCache::ReadEntryFile( const FilePath& rPath, uint64_t key, DynamicArray< uint8_t >& rData )
+{
+	rData.Resize( 0 );
+
+	if( !rPath.Exists() )
+	{
+		return false;
+	}
+
+	FileStream* pFileStream = FileStream::OpenFileStream( rPath.Data(), FileStream::MODE_READ );
+	if( !pFileStream )
+	{
+		return false;
+	}
+
+	EntryFileHeader header;
+	bool bRead =
+		pFileStream->Read( &header, sizeof( header ), 1 ) == 1 &&
+		header.version == VERSION &&
+		header.key == key;
+	if( bRead )
+	{
+		rData.Resize( header.size );
+		bRead =
+			pFileStream->Read( rData.GetData(), 1, header.size ) == header.size &&
+			Cache::ComputeContentHash( rData.GetData(), rData.GetSize() ) == header.contentHash;
+	}
+
+	delete pFileStream;
+
+	if( !bRead )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"SharedCookCache::ReadEntryFile(): Ignoring invalid entry file \"%s\".\n",
+			rPath.Data() );
+
+		rData.Resize( 0 );
+
+		return false;
+	}
+
+	return true;
+}
+
+/// Write an entry file.
+///
+/// The entry is written to a temporary file first and then renamed, so that readers never see a partial file under
+/// the entry's name.
+///
+/// @param[in] rPath  Entry file path.
+/// @param[in] key    Entry key.
+/// @param[in] rData  Entry data.
+///
+/// @return  True if the entry file was written, false if not.
+bool SharedCookCache::WriteEntryFile( const FilePath& rPath, uint64_t key, const DynamicArray< uint8_t >& rData )
+{
+	HELIUM_ASSERT( rData.GetSize() <= UINT32_MAX );
+
+	String tempFileName;
+	tempFileName.Format( "%s.%016" PRIx64 ".tmp", rPath.Data(), static_cast< uint64_t >( Timer::GetTickCount() ) );
+
+	FileStream* pFileStream = FileStream::OpenFileStream( tempFileName.GetData(), FileStream::MODE_WRITE );
+	if( !pFileStream )
+	{
+		return false;
+	}
+
+	EntryFileHeader header;
+	header.version = VERSION;
+	header.size = static_cast< uint32_t >( rData.GetSize() );
+	header.key = key;
+	header.contentHash = Cache::ComputeContentHash( rData.GetData(), rData.GetSize() );
+
+	bool bWritten =
+		pFileStream->Write( &header, sizeof( header ), 1 ) == 1 &&
+		pFileStream->Write( rData.GetData(), 1, rData.GetSize() ) == rData.GetSize();
+
+	delete pFileStream;
+
+	if( !bWritten || !Cache::RenameFile( tempFileName, String( rPath.Data() ) ) )
+	{
+		Cache::RemoveFile( tempFileName );
+
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/HashMap.h"
+
+#include "PcSupport/PcSupport.h"
+
+namespace Helium
+{
+	/// Preprocessed resource data shared between machines, keyed by the content hash of each resource's inputs.
+	///
+	/// Entries are kept in a remote directory (such as a network share that every developer and build agent can
+	/// reach), and each entry fetched from or stored to it is also kept in a local directory in the user data
+	/// directory.  The local directory is trimmed to a maximum size by removing the least recently used entries first
+	/// (see Flush()).
+	///
+	/// Entry data is opaque to this cache.  Entry files are validated against the hash of their contents, so partially
+	/// written files are ignored.  Entries can be fetched and stored from any thread.
+	class HELIUM_PC_SUPPORT_API SharedCookCache
+	{
+	public:
+		/// Entry file format version.
+		static const uint32_t VERSION = 1;
+		/// Default maximum size of the local entries, in bytes.
+		static const uint64_t DEFAULT_LOCAL_SIZE_MAX = 4ULL * 1024 * 1024 * 1024;
+
+		/// @name Construction/Destruction
+		//@{
+		SharedCookCache();
+		//@}
+
+		/// @name Configuration
+		//@{
+		void SetRemoteDirectory( const FilePath& rDirectory );
+		inline const FilePath& GetRemoteDirectory() const;
+		inline bool IsEnabled() const;
+
+		void SetLocalSizeMax( uint64_t sizeMax );
+		inline uint64_t GetLocalSizeMax() const;
+		//@}
+
+		/// @name Entry Access
+		//@{
+		bool Fetch( uint64_t key, DynamicArray< uint8_t >& rData );
+		void Store( uint64_t key, const DynamicArray< uint8_t >& rData );
+
+		void Flush();
+		//@}
+
+	private:
+		/// Entry file header.
+		struct EntryFileHeader
+		{
+			/// Entry file format version.
+			uint32_t version;
+			/// Size of the entry data, in bytes.
+			uint32_t size;
+			/// Entry key.
+			uint64_t key;
+			/// Content hash of the entry data.
+			uint64_t contentHash;
+		};
+
+		/// Entry kept in the local directory.
+		struct LocalEntry
+		{
+			/// Entry file size, in bytes.
+			uint64_t size;
+			/// Use counter value when the entry was last fetched or stored.
+			uint64_t lastUse;
+		};
+
+		/// Remote directory path (empty if sharing is disabled).
+		FilePath m_remoteDirectory;
+		/// Maximum size of the local entries, in bytes.
+		uint64_t m_localSizeMax;
+
+		/// Entries in the local directory by key.
+		HashMap< uint64_t, LocalEntry > m_localEntries;
+		/// Combined size of the local entries, in bytes.
+		uint64_t m_localSize;
+		/// Use counter incremented each time an entry is used.
+		uint64_t m_useCounter;
+		/// True once the local entries have been scanned.
+		bool m_bLocalEntriesLoaded;
+		/// True if the local entries have changed since the index was last saved.
+		bool m_bLocalIndexDirty;
+
+		/// Mutex synchronizing access to the local entries.
+		Mutex m_localLock;
+
+		/// @name Private Utility Functions
+		//@{
+		void LoadLocalEntries();
+		void TouchLocalEntry( uint64_t key, uint64_t size );
+		//@}
+
+		/// @name Private Static Utility Functions
+		//@{
+		static bool GetLocalDirectory( FilePath& rDirectory );
+		static bool GetEntryFilePath( const FilePath& rDirectory, uint64_t key, FilePath& rPath );
+
+		static bool ReadEntryFile( const FilePath& rPath, uint64_t key, DynamicArray< uint8_t >& rData );
+		static bool WriteEntryFile( const FilePath& rPath, uint64_t key, const DynamicArray< uint8_t >& rData );
+		//@}
+	};
+}
+
+#include "PcSupport/SharedCookCache.inl"
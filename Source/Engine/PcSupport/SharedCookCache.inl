@@ -0,0 +1,29 @@
+/// Get the directory in which shared entries are kept.
+///
+/// @return  Remote directory path, or an empty path if sharing is disabled.
+///
+/// @see SetRemoteDirectory(), IsEnabled()
+const Helium::FilePath& Helium::SharedCookCache::GetRemoteDirectory() const
+{
+	return m_remoteDirectory;
+}
+
+/// Get whether a remote directory has been set.
+///
+/// @return  True if entries are fetched and stored, false if sharing is disabled.
+///
+/// @see SetRemoteDirectory()
+bool Helium::SharedCookCache::IsEnabled() const
+{
+	return !m_remoteDirectory.Get().empty();
+}
+
+/// Get the maximum size of the entries kept in the local directory.
+///
+/// @return  Maximum local size, in bytes.
+///
+/// @see SetLocalSizeMax()
+uint64_t Helium::SharedCookCache::GetLocalSizeMax() const
+{
+	return m_localSizeMax;
+}
@@ -7,6 +7,7 @@
 #include "Rendering/ShaderProfiles.h"
 #include "Graphics/Shader.h"
 #include "Engine/FileLocations.h"
+#include "Engine/Cache.h"
 
 #if HELIUM_DIRECT3D
 
@@ -33,7 +34,7 @@ class D3DIncludeHandler : public ID3D10Include
 public:
     /// @name Construction/Destruction
     //@{
-    explicit D3DIncludeHandler( const FilePath& rShaderPath );
+    D3DIncludeHandler( const FilePath& rShaderPath, DynamicArray< FilePath >* pIncludedFiles );
     virtual ~D3DIncludeHandler();
     //@}
 
@@ -46,12 +47,16 @@ public:
 private:
     /// Directory containing the shader file being processed.
     FilePath m_shaderDirectory;
+    /// Optional array to which the path of each include file opened is added.
+    DynamicArray< FilePath >* m_pIncludedFiles;
 };
 
 /// Constructor.
 ///
-/// @param[in] rShaderPath  FilePath to the shader file being processed.
-D3DIncludeHandler::D3DIncludeHandler( const FilePath& rShaderPath )
+/// @param[in] rShaderPath     FilePath to the shader file being processed.
+/// @param[in] pIncludedFiles  Optional array to which the path of each include file opened is added.
+D3DIncludeHandler::D3DIncludeHandler( const FilePath& rShaderPath, DynamicArray< FilePath >* pIncludedFiles )
+    : m_pIncludedFiles( pIncludedFiles )
 {
     m_shaderDirectory.Set( rShaderPath.Directory().Get() );
 }
@@ -148,6 +153,11 @@ HRESULT D3DIncludeHandler::Open(
 
     delete pIncludeFileStream;
 
+    if( m_pIncludedFiles )
+    {
+        m_pIncludedFiles->Push( includePath );
+    }
+
     *ppData = pBuffer;
     *pBytes = fileSize;
 
@@ -170,73 +180,49 @@ HRESULT D3DIncludeHandler::Close( LPCVOID pData )
     return S_OK;
 }
 
-#endif // HELIUM_DIRECT3D
+/// Flags with which all shaders are compiled.
+// XXX TMC: Always use row-major packing, since that's the only option with Cg.
+static const UINT SHADER_COMPILE_FLAGS =
+    D3D10_SHADER_OPTIMIZATION_LEVEL3 | D3D10_SHADER_PACK_MATRIX_ROW_MAJOR | D3D10_SHADER_WARNINGS_ARE_ERRORS;
 
-/// Constructor.
-PcPreprocessor::PcPreprocessor()
-{
-}
-
-/// Destructor.
-PcPreprocessor::~PcPreprocessor()
-{
-}
-
-/// @copydoc PlatformPreprocessor::GetByteOrder()
-PlatformPreprocessor::EByteOrder PcPreprocessor::GetByteOrder() const
-{
-	return BYTE_ORDER_LITTLE;
-}
-
-/// @copydoc PlatformPreprocessor::GetShaderProfileCount()
-size_t PcPreprocessor::GetShaderProfileCount() const
-{
-	return static_cast< size_t >( ShaderProfile::PC_MAX );
-}
-
-/// @copydoc PlatformPreprocessor::CompileShader()
-bool PcPreprocessor::CompileShader(
-								   const FilePath& rShaderPath,
-								   size_t profileIndex,
-								   RShader::EType type,
-								   const void* pShaderCode,
-								   size_t shaderCodeSize,
-								   const ShaderToken* pTokens,
-								   size_t tokenCount,
-								   DynamicArray< uint8_t >& rCompiledCode,
-								   DynamicArray< String >* pErrorMessages )
+/// Build the list of preprocessor macros with which to compile or preprocess a shader.
+///
+/// @param[in]  profileIndex  Index of the target shader profile.
+/// @param[in]  type          Shader type.
+/// @param[in]  pTokens       Array of shader preprocessor tokens.
+/// @param[in]  tokenCount    Number of shader preprocessor tokens in the given array.
+/// @param[in]  rStackHeap    Stack heap from which to allocate the macro strings (which remain valid until the heap
+///                           is popped past its current position).
+/// @param[out] rDefines      Macro list, terminated with a null entry.
+/// @param[out] rpProfile     Name of the target compiler profile.
+///
+/// @return  True if the macros were built, false if the profile index or shader type is invalid.
+static bool BuildShaderDefines(
+	size_t profileIndex,
+	RShader::EType type,
+	const PlatformPreprocessor::ShaderToken* pTokens,
+	size_t tokenCount,
+	StackMemoryHeap<>& rStackHeap,
+	DynamicArray< D3D10_SHADER_MACRO >& rDefines,
+	const char*& rpProfile )
 {
-	HELIUM_ASSERT( profileIndex < static_cast< size_t >( ShaderProfile::PC_MAX ) );
-	HELIUM_ASSERT( static_cast< size_t >( type ) < static_cast< size_t >( RShader::TYPE_MAX ) );
-	HELIUM_ASSERT( pShaderCode );
-	HELIUM_ASSERT( pTokens || tokenCount == 0 );
+	rDefines.Resize( 0 );
 
-	rCompiledCode.Resize( 0 );
-	if( pErrorMessages )
-	{
-		pErrorMessages->Resize( 0 );
-	}
-
-#if HELIUM_DIRECT3D
-
-	DynamicArray< D3D10_SHADER_MACRO > defines;
 	D3D10_SHADER_MACRO macro;
 
-	const char* pProfile;
-
 	switch( static_cast< ShaderProfile::EPc >( profileIndex ) )
 	{
 	case ShaderProfile::PC_SM2b:
 		{
 			macro.Name = "HELIUM_PROFILE_PC_SM2b";
 			macro.Definition = "1";
-			defines.Push( macro );
+			rDefines.Push( macro );
 
 			// Also define HELIUM_PROFILE_PC_SM2 for consistency and legacy support.
 			macro.Name = "HELIUM_PROFILE_PC_SM2";
-			defines.Push( macro );
+			rDefines.Push( macro );
 
-			pProfile = ( type == RShader::TYPE_VERTEX ? "vs_2_0" : "ps_2_b" );
+			rpProfile = ( type == RShader::TYPE_VERTEX ? "vs_2_0" : "ps_2_b" );
 
 			break;
 		}
@@ -245,9 +231,9 @@ bool PcPreprocessor::CompileShader(
 		{
 			macro.Name = "HELIUM_PROFILE_PC_SM3";
 			macro.Definition = "1";
-			defines.Push( macro );
+			rDefines.Push( macro );
 
-			pProfile = ( type == RShader::TYPE_VERTEX ? "vs_3_0" : "ps_3_0" );
+			rpProfile = ( type == RShader::TYPE_VERTEX ? "vs_3_0" : "ps_3_0" );
 
 			break;
 		}
@@ -256,16 +242,16 @@ bool PcPreprocessor::CompileShader(
 		{
 			macro.Name = "HELIUM_PROFILE_PC_SM4";
 			macro.Definition = "1";
-			defines.Push( macro );
+			rDefines.Push( macro );
 
-			pProfile = ( type == RShader::TYPE_VERTEX ? "vs_4_0" : "ps_4_0" );
+			rpProfile = ( type == RShader::TYPE_VERTEX ? "vs_4_0" : "ps_4_0" );
 
 			break;
 		}
 
 	default:
 		{
-			HELIUM_BREAK_MSG( "PcPreprocessor::CompileShader(): Invalid shader profile index.\n" );
+			HELIUM_BREAK_MSG( "BuildShaderDefines(): Invalid shader profile index.\n" );
 
 			return false;
 		}
@@ -277,7 +263,7 @@ bool PcPreprocessor::CompileShader(
 		{
 			macro.Name = "HELIUM_TYPE_VERTEX";
 			macro.Definition = "1";
-			defines.Push( macro );
+			rDefines.Push( macro );
 
 			break;
 		}
@@ -286,25 +272,22 @@ bool PcPreprocessor::CompileShader(
 		{
 			macro.Name = "HELIUM_TYPE_PIXEL";
 			macro.Definition = "1";
-			defines.Push( macro );
+			rDefines.Push( macro );
 
 			break;
 		}
 
 	default:
 		{
-			HELIUM_BREAK_MSG( "PcPreprocessor::CompileShader(): Invalid shader type.\n" );
+			HELIUM_BREAK_MSG( "BuildShaderDefines(): Invalid shader type.\n" );
 
 			return false;
 		}
 	}
 
-	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
-	StackMemoryHeap<>::Marker stackMarker( rStackHeap );
-
 	for( size_t tokenIndex = 0; tokenIndex < tokenCount; ++tokenIndex )
 	{
-		const ShaderToken& rToken = pTokens[ tokenIndex ];
+		const PlatformPreprocessor::ShaderToken& rToken = pTokens[ tokenIndex ];
 
 		size_t nameBufferSize = rToken.name.GetSize() + 1;
 		char* pNameBuffer = static_cast< char* >( rStackHeap.Allocate( nameBufferSize ) );
@@ -320,22 +303,94 @@ bool PcPreprocessor::CompileShader(
 		
 		HELIUM_TRACE(
 			TraceLevels::Debug,
-			"PcPreprocessor::CompileShader(): Defining option %s = %s (profile index: %" PRIuSZ ").\n",
+			"BuildShaderDefines(): Defining option %s = %s (profile index: %" PRIuSZ ").\n",
 			macro.Name,
 			macro.Definition,
 			profileIndex );
 
-		defines.Push( macro );
+		rDefines.Push( macro );
 	}
 
 	macro.Name = NULL;
 	macro.Definition = NULL;
-	defines.Push( macro );
+	rDefines.Push( macro );
+
+	return true;
+}
+
+#endif // HELIUM_DIRECT3D
+
+/// Constructor.
+PcPreprocessor::PcPreprocessor()
+{
+}
+
+/// Destructor.
+PcPreprocessor::~PcPreprocessor()
+{
+}
+
+/// @copydoc PlatformPreprocessor::GetByteOrder()
+PlatformPreprocessor::EByteOrder PcPreprocessor::GetByteOrder() const
+{
+	return BYTE_ORDER_LITTLE;
+}
+
+/// @copydoc PlatformPreprocessor::GetCookOptionsHash()
+uint64_t PcPreprocessor::GetCookOptionsHash() const
+{
+#if HELIUM_DIRECT3D
+	return Cache::ComputeContentHash( &SHADER_COMPILE_FLAGS, sizeof( SHADER_COMPILE_FLAGS ) );
+#else
+	return 0;
+#endif
+}
 
-	D3DIncludeHandler includeHandler( rShaderPath );
+/// @copydoc PlatformPreprocessor::GetShaderProfileCount()
+size_t PcPreprocessor::GetShaderProfileCount() const
+{
+	return static_cast< size_t >( ShaderProfile::PC_MAX );
+}
+
+/// @copydoc PlatformPreprocessor::CompileShader()
+bool PcPreprocessor::CompileShader(
+								   const FilePath& rShaderPath,
+								   size_t profileIndex,
+								   RShader::EType type,
+								   const void* pShaderCode,
+								   size_t shaderCodeSize,
+								   const ShaderToken* pTokens,
+								   size_t tokenCount,
+								   DynamicArray< uint8_t >& rCompiledCode,
+								   DynamicArray< String >* pErrorMessages,
+								   DynamicArray< FilePath >* pIncludedFiles )
+{
+	HELIUM_ASSERT( profileIndex < static_cast< size_t >( ShaderProfile::PC_MAX ) );
+	HELIUM_ASSERT( static_cast< size_t >( type ) < static_cast< size_t >( RShader::TYPE_MAX ) );
+	HELIUM_ASSERT( pShaderCode );
+	HELIUM_ASSERT( pTokens || tokenCount == 0 );
+
+	rCompiledCode.Resize( 0 );
+	if( pErrorMessages )
+	{
+		pErrorMessages->Resize( 0 );
+	}
+
+#if HELIUM_DIRECT3D
+
+	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+	StackMemoryHeap<>::Marker stackMarker( rStackHeap );
+
+	DynamicArray< D3D10_SHADER_MACRO > defines;
+	const char* pProfile = NULL;
+	if( !BuildShaderDefines( profileIndex, type, pTokens, tokenCount, rStackHeap, defines, pProfile ) )
+	{
+		return false;
+	}
+
+	D3DIncludeHandler includeHandler( rShaderPath, pIncludedFiles );
 	ID3D10Blob* pCompiledCodeBlob = NULL;
 	ID3D10Blob* pErrorMessageBlob = NULL;
-	// XXX TMC: Always use row-major packing, since that's the only option with Cg.
 	HRESULT hResult = D3DCompile(
 		pShaderCode,
 		shaderCodeSize,
@@ -344,7 +399,7 @@ bool PcPreprocessor::CompileShader(
 		&includeHandler,
 		"main",
 		pProfile,
-		D3D10_SHADER_OPTIMIZATION_LEVEL3 | D3D10_SHADER_PACK_MATRIX_ROW_MAJOR | D3D10_SHADER_WARNINGS_ARE_ERRORS,
+		SHADER_COMPILE_FLAGS,
 		0,
 		&pCompiledCodeBlob,
 		( pErrorMessages ? &pErrorMessageBlob : NULL ) );
@@ -508,6 +563,84 @@ bool PcPreprocessor::CompileShader(
 	return true;
 }
 
+/// @copydoc PlatformPreprocessor::PreprocessShader()
+bool PcPreprocessor::PreprocessShader(
+	const FilePath& rShaderPath,
+	size_t profileIndex,
+	RShader::EType type,
+	const void* pShaderCode,
+	size_t shaderCodeSize,
+	const ShaderToken* pTokens,
+	size_t tokenCount,
+	DynamicArray< uint8_t >& rPreprocessedCode,
+	DynamicArray< FilePath >* pIncludedFiles )
+{
+	HELIUM_ASSERT( profileIndex < static_cast< size_t >( ShaderProfile::PC_MAX ) );
+	HELIUM_ASSERT( static_cast< size_t >( type ) < static_cast< size_t >( RShader::TYPE_MAX ) );
+	HELIUM_ASSERT( pShaderCode );
+	HELIUM_ASSERT( pTokens || tokenCount == 0 );
+
+	rPreprocessedCode.Resize( 0 );
+
+#if HELIUM_DIRECT3D
+
+	StackMemoryHeap<>& rStackHeap = ThreadLocalStackAllocator::GetMemoryHeap();
+	StackMemoryHeap<>::Marker stackMarker( rStackHeap );
+
+	DynamicArray< D3D10_SHADER_MACRO > defines;
+	const char* pProfile = NULL;
+	if( !BuildShaderDefines( profileIndex, type, pTokens, tokenCount, rStackHeap, defines, pProfile ) )
+	{
+		return false;
+	}
+
+	D3DIncludeHandler includeHandler( rShaderPath, pIncludedFiles );
+	ID3D10Blob* pPreprocessedCodeBlob = NULL;
+	HRESULT hResult = D3DPreprocess(
+		pShaderCode,
+		shaderCodeSize,
+		NULL,
+		defines.GetData(),
+		&includeHandler,
+		&pPreprocessedCodeBlob,
+		NULL );
+
+	stackMarker.Pop();
+
+	if( FAILED( hResult ) || !pPreprocessedCodeBlob )
+	{
+		if( pPreprocessedCodeBlob )
+		{
+			pPreprocessedCodeBlob->Release();
+		}
+
+		return false;
+	}
+
+	const uint8_t* pPreprocessedData = static_cast< const uint8_t* >( pPreprocessedCodeBlob->GetBufferPointer() );
+	size_t preprocessedSize = pPreprocessedCodeBlob->GetBufferSize();
+	HELIUM_ASSERT( pPreprocessedData || preprocessedSize == 0 );
+
+	// The profile name is not part of the macros, so append it to keep the output of each profile distinct.
+	rPreprocessedCode.Reserve( preprocessedSize + StringLength( pProfile ) );
+	rPreprocessedCode.AddArray( pPreprocessedData, preprocessedSize );
+	rPreprocessedCode.AddArray( reinterpret_cast< const uint8_t* >( pProfile ), StringLength( pProfile ) );
+
+	pPreprocessedCodeBlob->Release();
+
+	return true;
+
+#else  // HELIUM_DIRECT3D
+
+	HELIUM_UNREF( rShaderPath );
+	HELIUM_UNREF( shaderCodeSize );
+	HELIUM_UNREF( pIncludedFiles );
+
+	return false;
+
+#endif  // HELIUM_DIRECT3D
+}
+
 /// @copydoc PlatformPreprocessor::FillShaderReflectionData()
 bool PcPreprocessor::FillShaderReflectionData(
 	size_t profileIndex,
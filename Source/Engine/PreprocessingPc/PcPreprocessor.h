@@ -18,6 +18,7 @@ namespace Helium
         /// @name Platform Parameters
         //@{
         virtual EByteOrder GetByteOrder() const;
+        virtual uint64_t GetCookOptionsHash() const;
         //@}
 
         /// @name Shader Compiling
@@ -26,7 +27,11 @@ namespace Helium
         virtual bool CompileShader(
             const FilePath& rShaderPath, size_t profileIndex, RShader::EType type, const void* pShaderCode,
             size_t shaderCodeSize, const ShaderToken* pTokens, size_t tokenCount, DynamicArray< uint8_t >& rCompiledCode,
-            DynamicArray< String >* pErrorMessages );
+            DynamicArray< String >* pErrorMessages, DynamicArray< FilePath >* pIncludedFiles = NULL );
+        virtual bool PreprocessShader(
+            const FilePath& rShaderPath, size_t profileIndex, RShader::EType type, const void* pShaderCode,
+            size_t shaderCodeSize, const ShaderToken* pTokens, size_t tokenCount,
+            DynamicArray< uint8_t >& rPreprocessedCode, DynamicArray< FilePath >* pIncludedFiles = NULL );
         virtual bool FillShaderReflectionData(
             size_t profileIndex, const void* pCompiledCode, size_t compiledCodeSize,
             DynamicArray< ShaderConstantBufferInfo >& rConstantBuffers, DynamicArray< ShaderSamplerInfo >& rSamplers,
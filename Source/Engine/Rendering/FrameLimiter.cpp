@@ -0,0 +1,59 @@
+#include "Precompile.h"
+#include "Rendering/FrameLimiter.h"
+
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
+
+using namespace Helium;
+
+/// Constructor.
+///
+/// @param[in] frameRateLimit  Maximum number of frames presented per second (0 for no limit).
+FrameLimiter::FrameLimiter( uint32_t frameRateLimit )
+    : m_frameRateLimit( 0 )
+    , m_frameIntervalTicks( 0 )
+    , m_nextFrameTickCount( 0 )
+{
+    SetFrameRateLimit( frameRateLimit );
+}
+
+/// Set the maximum number of frames presented per second.
+///
+/// @param[in] frameRateLimit  Frame rate limit, or zero to disable frame rate limiting.
+///
+/// @see GetFrameRateLimit()
+void FrameLimiter::SetFrameRateLimit( uint32_t frameRateLimit )
+{
+    m_frameRateLimit = frameRateLimit;
+    m_frameIntervalTicks = ( frameRateLimit != 0 ? Timer::GetTicksPerSecond() / frameRateLimit : 0 );
+    m_nextFrameTickCount = 0;
+}
+
+/// Wait until the next frame is due to be presented.
+///
+/// This returns immediately if the frame rate is not limited.
+void FrameLimiter::Wait()
+{
+    if( m_frameIntervalTicks == 0 )
+    {
+        return;
+    }
+
+    uint64_t tickCount = Timer::GetTickCount();
+    if( tickCount < m_nextFrameTickCount )
+    {
+        uint64_t waitMilliseconds = ( ( m_nextFrameTickCount - tickCount ) * 1000 ) / Timer::GetTicksPerSecond();
+        if( waitMilliseconds > SPIN_MILLISECONDS )
+        {
+            Thread::Sleep( static_cast< uint32_t >( waitMilliseconds - SPIN_MILLISECONDS ) );
+        }
+
+        for( tickCount = Timer::GetTickCount(); tickCount < m_nextFrameTickCount; tickCount = Timer::GetTickCount() )
+        {
+            Thread::Yield();
+        }
+    }
+
+    // Schedule the next frame relative to when this one was due, unless this frame is already late.
+    m_nextFrameTickCount = Max( m_nextFrameTickCount, tickCount ) + m_frameIntervalTicks;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Rendering/Rendering.h"
+
+namespace Helium
+{
+    /// CPU-side limiter for the rate at which a render context presents frames.
+    ///
+    /// Wait() is called right before each frame is presented and blocks until the frame is due.  Most of the wait is
+    /// spent sleeping, but since the scheduler can oversleep by a millisecond or more, the last SPIN_MILLISECONDS of the
+    /// wait are spent yielding in a loop instead so that frames are presented at an even rate.  Frames are scheduled
+    /// relative to the previous frame's due time rather than to when it was actually presented so that timing errors do
+    /// not accumulate, but a frame that is presented late pushes back the schedule instead of letting the frames after
+    /// it run faster to catch up.
+    class HELIUM_RENDERING_API FrameLimiter
+    {
+    public:
+        /// Amount of time at the end of each wait spent spinning instead of sleeping, in milliseconds.
+        static const uint32_t SPIN_MILLISECONDS = 2;
+
+        /// @name Construction/Destruction
+        //@{
+        explicit FrameLimiter( uint32_t frameRateLimit = 0 );
+        //@}
+
+        /// @name Frame Pacing
+        //@{
+        inline uint32_t GetFrameRateLimit() const;
+        void SetFrameRateLimit( uint32_t frameRateLimit );
+
+        void Wait();
+        //@}
+
+    private:
+        /// Maximum number of frames presented per second (0 for no limit).
+        uint32_t m_frameRateLimit;
+        /// Minimum time between frames, in timer ticks.
+        uint64_t m_frameIntervalTicks;
+        /// Tick count at which the next frame is due (0 if no frame has been presented yet).
+        uint64_t m_nextFrameTickCount;
+    };
+}
+
+#include "Rendering/FrameLimiter.inl"
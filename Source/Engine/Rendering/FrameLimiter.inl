@@ -0,0 +1,12 @@
+namespace Helium
+{
+    /// Get the maximum number of frames presented per second.
+    ///
+    /// @return  Frame rate limit, or zero if the frame rate is not limited.
+    ///
+    /// @see SetFrameRateLimit()
+    uint32_t FrameLimiter::GetFrameRateLimit() const
+    {
+        return m_frameRateLimit;
+    }
+}
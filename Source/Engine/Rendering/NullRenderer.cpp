@@ -0,0 +1,1036 @@
+#include "Precompile.h"
+#include "Rendering/NullRenderer.h"
+
+#include "Rendering/RConstantBuffer.h"
+#include "Rendering/RFence.h"
+#include "Rendering/RIndexBuffer.h"
+#include "Rendering/RPixelShader.h"
+#include "Rendering/RRenderCommandList.h"
+#include "Rendering/RRenderCommandProxy.h"
+#include "Rendering/RRenderContext.h"
+#include "Rendering/RSurface.h"
+#include "Rendering/RVertexBuffer.h"
+#include "Rendering/RVertexInputLayout.h"
+#include "Rendering/RVertexShader.h"
+#include "Rendering/RendererUtil.h"
+#include "Engine/RenderStatistics.h"
+
+namespace Helium
+{
+	HELIUM_DECLARE_RPTR( RRenderResource );
+	HELIUM_DECLARE_RPTR( RSurface );
+}
+
+using namespace Helium;
+
+static uint32_t g_InitCount = 0;
+
+namespace
+{
+	/// State object holding a copy of its description.
+	template< typename Base >
+	class NullStateObject : public Base
+	{
+	public:
+		explicit NullStateObject( const typename Base::Description& rDescription )
+			: m_description( rDescription )
+		{
+		}
+
+		void GetDescription( typename Base::Description& rDescription ) const
+		{
+			rDescription = m_description;
+		}
+
+	private:
+		/// State description.
+		typename Base::Description m_description;
+	};
+
+	/// Buffer backed by system memory.
+	template< typename Base, RRenderResource::EMemoryCategory Category, RenderStatistics::ECounter Counter >
+	class NullBuffer : public Base
+	{
+	public:
+		NullBuffer( size_t size, const void* pData )
+		{
+			m_data.Resize( size );
+			if( pData && size != 0 )
+			{
+				MemoryCopy( m_data.GetData(), pData, size );
+				RenderStatistics::RecordUpload( Counter, size );
+			}
+
+			this->SetTrackedMemory( Category, size );
+		}
+
+		void* Map( ERendererBufferMapHint /*hint*/ )
+		{
+			RenderStatistics::RecordUpload( Counter, m_data.GetSize() );
+
+			return m_data.GetData();
+		}
+
+		void Unmap()
+		{
+		}
+
+	private:
+		/// Buffer contents.
+		DynamicArray< uint8_t > m_data;
+	};
+
+	typedef NullBuffer<
+		RVertexBuffer, RRenderResource::MEMORY_CATEGORY_VERTEX_BUFFER, RenderStatistics::COUNTER_BUFFER_BYTES >
+		NullVertexBuffer;
+	typedef NullBuffer<
+		RIndexBuffer, RRenderResource::MEMORY_CATEGORY_INDEX_BUFFER, RenderStatistics::COUNTER_BUFFER_BYTES >
+		NullIndexBuffer;
+	typedef NullBuffer<
+		RConstantBuffer, RRenderResource::MEMORY_CATEGORY_CONSTANT_BUFFER,
+		RenderStatistics::COUNTER_CONSTANT_BUFFER_BYTES >
+		NullConstantBuffer;
+
+	/// Shader holding a copy of its compiled code.
+	template< typename Base >
+	class NullShader : public Base
+	{
+	public:
+		NullShader( size_t size, const void* pData )
+		{
+			m_data.Resize( size );
+			if( pData && size != 0 )
+			{
+				MemoryCopy( m_data.GetData(), pData, size );
+			}
+
+			this->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
+		}
+
+		void* Lock()
+		{
+			return m_data.GetData();
+		}
+
+		bool Unlock()
+		{
+			return true;
+		}
+
+	private:
+		/// Compiled shader code.
+		DynamicArray< uint8_t > m_data;
+	};
+
+	/// Render target or depth-stencil surface.
+	class NullSurface : public RSurface
+	{
+	};
+
+	/// Vertex description.
+	class NullVertexDescription : public RVertexDescription
+	{
+	};
+
+	/// Vertex input layout.
+	class NullVertexInputLayout : public RVertexInputLayout
+	{
+	};
+
+	/// Fence (always signaled).
+	class NullFence : public RFence
+	{
+	};
+
+	/// Texture whose mip levels are only staged in system memory while mapped.
+	class NullTexture2d : public RTexture2d
+	{
+	public:
+		NullTexture2d( uint32_t width, uint32_t height, uint32_t mipCount, ERendererPixelFormat format )
+			: m_width( width )
+			, m_height( height )
+			, m_mipCount( mipCount )
+			, m_format( format )
+		{
+			m_mipStagingData.Resize( mipCount );
+			MemoryZero( m_mipStagingData.GetData(), mipCount * sizeof( void* ) );
+
+			SetTrackedMemory(
+				MEMORY_CATEGORY_TEXTURE,
+				RendererUtil::GetTexture2dMemorySize( width, height, mipCount, format ) );
+		}
+
+		~NullTexture2d()
+		{
+			for( uint32_t mipLevel = 0; mipLevel < m_mipCount; ++mipLevel )
+			{
+				if( m_mipStagingData[ mipLevel ] )
+				{
+					DefaultAllocator().Free( m_mipStagingData[ mipLevel ] );
+				}
+			}
+		}
+
+		void* Map( uint32_t mipLevel, size_t& rPitch, ERendererBufferMapHint /*hint*/ )
+		{
+			HELIUM_ASSERT( mipLevel < m_mipCount );
+			if( mipLevel >= m_mipCount )
+			{
+				return NULL;
+			}
+
+			HELIUM_ASSERT( !m_mipStagingData[ mipLevel ] );
+
+			size_t mipLevelSize = RendererUtil::GetTexture2dMemorySize(
+				GetWidth( mipLevel ),
+				GetHeight( mipLevel ),
+				1,
+				m_format );
+			void* pStagingData = DefaultAllocator().Allocate( mipLevelSize );
+			HELIUM_ASSERT( pStagingData );
+			m_mipStagingData[ mipLevel ] = pStagingData;
+
+			// A single block row of the mip level is exactly one pitch.
+			rPitch = RendererUtil::GetTexture2dMemorySize( GetWidth( mipLevel ), 1, 1, m_format );
+
+			RenderStatistics::RecordUpload( RenderStatistics::COUNTER_TEXTURE_BYTES, mipLevelSize );
+
+			return pStagingData;
+		}
+
+		void Unmap( uint32_t mipLevel )
+		{
+			HELIUM_ASSERT( mipLevel < m_mipCount );
+			if( mipLevel < m_mipCount && m_mipStagingData[ mipLevel ] )
+			{
+				DefaultAllocator().Free( m_mipStagingData[ mipLevel ] );
+				m_mipStagingData[ mipLevel ] = NULL;
+			}
+		}
+
+		bool CanMapWholeResource() const
+		{
+			return true;
+		}
+
+		uint32_t GetMipCount() const
+		{
+			return m_mipCount;
+		}
+
+		uint32_t GetWidth( uint32_t mipLevel ) const
+		{
+			return Max< uint32_t >( m_width >> mipLevel, 1 );
+		}
+
+		uint32_t GetHeight( uint32_t mipLevel ) const
+		{
+			return Max< uint32_t >( m_height >> mipLevel, 1 );
+		}
+
+		ERendererPixelFormat GetPixelFormat() const
+		{
+			return m_format;
+		}
+
+		RSurface* GetSurface( uint32_t /*mipLevel*/ )
+		{
+			return new NullSurface;
+		}
+
+	private:
+		/// Width of the top mip level, in pixels.
+		uint32_t m_width;
+		/// Height of the top mip level, in pixels.
+		uint32_t m_height;
+		/// Number of mip levels.
+		uint32_t m_mipCount;
+		/// Pixel format.
+		ERendererPixelFormat m_format;
+		/// Staging memory of each currently mapped mip level.
+		DynamicArray< void* > m_mipStagingData;
+	};
+
+	/// Rendering context with no display.
+	class NullRenderContext : public RRenderContext
+	{
+	public:
+		NullRenderContext()
+			: m_spBackBufferSurface( new NullSurface )
+		{
+		}
+
+		RSurface* GetBackBufferSurface()
+		{
+			return m_spBackBufferSurface;
+		}
+
+		void Swap()
+		{
+		}
+
+		bool Resize( uint32_t /*width*/, uint32_t /*height*/ )
+		{
+			return true;
+		}
+
+	private:
+		/// Back buffer surface.
+		RSurfacePtr m_spBackBufferSurface;
+	};
+
+	/// Command recorded by a deferred command proxy.
+	///
+	/// Only commands that affect the render statistics are recorded.  Binds to multiple slots are split into one
+	/// command per slot, which the state filter counts the same way.
+	struct NullRenderCommand
+	{
+		/// Command types.
+		enum EType
+		{
+			TYPE_RASTERIZER_STATE,
+			TYPE_BLEND_STATE,
+			TYPE_DEPTH_STENCIL_STATE,
+			TYPE_SAMPLER_STATE,
+			TYPE_INDEX_BUFFER,
+			TYPE_VERTEX_BUFFER,
+			TYPE_VERTEX_INPUT_LAYOUT,
+			TYPE_VERTEX_SHADER,
+			TYPE_PIXEL_SHADER,
+			TYPE_TEXTURE,
+			TYPE_DRAW,
+			TYPE_UNBIND_RESOURCES
+		};
+
+		/// Command type.
+		EType type;
+		/// Bound resource, if any.
+		RRenderResourcePtr spResource;
+		/// Slot index, or stencil reference value for depth-stencil state binds.
+		uint32_t slot;
+		/// Stride and offset for vertex buffer binds, primitive and instance counts for draws.
+		uint32_t values[ 2 ];
+	};
+
+	/// Command list recorded by a deferred command proxy.
+	class NullRenderCommandList : public RRenderCommandList
+	{
+	public:
+		/// Recorded commands.
+		DynamicArray< NullRenderCommand > m_commands;
+	};
+
+	HELIUM_DECLARE_RPTR( NullRenderCommandList );
+
+	/// Immediate command proxy, counting binds and draws.
+	class NullImmediateCommandProxy : public RRenderCommandProxy
+	{
+	public:
+		void SetRasterizerState( RRasterizerState* pState )
+		{
+			m_stateFilter.SetRasterizerState( pState );
+		}
+
+		void SetBlendState( RBlendState* pState )
+		{
+			m_stateFilter.SetBlendState( pState );
+		}
+
+		void SetDepthStencilState( RDepthStencilState* pState, uint8_t stencilReferenceValue )
+		{
+			m_stateFilter.SetDepthStencilState( pState, stencilReferenceValue );
+		}
+
+		void SetSamplerStates( size_t startIndex, size_t samplerCount, RSamplerState* const* ppStates )
+		{
+			m_stateFilter.SetSamplerStates( startIndex, samplerCount, ppStates );
+		}
+
+		void SetRenderSurfaces( RSurface* /*pRenderTargetSurface*/, RSurface* /*pDepthStencilSurface*/ )
+		{
+		}
+
+		void SetViewport( uint32_t /*x*/, uint32_t /*y*/, uint32_t /*width*/, uint32_t /*height*/ )
+		{
+		}
+
+		void BeginScene()
+		{
+		}
+
+		void EndScene()
+		{
+		}
+
+		void Clear( uint32_t /*clearFlags*/, const Color& /*rColor*/, float32_t /*depth*/, uint8_t /*stencil*/ )
+		{
+		}
+
+		void SetIndexBuffer( RIndexBuffer* pBuffer )
+		{
+			m_stateFilter.SetIndexBuffer( pBuffer );
+		}
+
+		void SetVertexBuffers(
+			size_t startIndex, size_t bufferCount, RVertexBuffer* const* ppBuffers, uint32_t* pStrides,
+			uint32_t* pOffsets )
+		{
+			m_stateFilter.SetVertexBuffers( startIndex, bufferCount, ppBuffers, pStrides, pOffsets );
+		}
+
+		void SetVertexInputLayout( RVertexInputLayout* pLayout )
+		{
+			m_stateFilter.SetVertexInputLayout( pLayout );
+		}
+
+		void SetVertexShader( RVertexShader* pShader )
+		{
+			m_stateFilter.SetVertexShader( pShader );
+		}
+
+		void SetPixelShader( RPixelShader* pShader )
+		{
+			m_stateFilter.SetPixelShader( pShader );
+		}
+
+		void SetVertexConstantBuffers(
+			size_t /*startIndex*/, size_t /*bufferCount*/, RConstantBuffer* const* /*ppBuffers*/,
+			const size_t* /*pLimitSizes*/, const size_t* /*pOffsets*/ )
+		{
+		}
+
+		void SetPixelConstantBuffers(
+			size_t /*startIndex*/, size_t /*bufferCount*/, RConstantBuffer* const* /*ppBuffers*/,
+			const size_t* /*pLimitSizes*/, const size_t* /*pOffsets*/ )
+		{
+		}
+
+		void SetTexture( size_t samplerIndex, RTexture* pTexture )
+		{
+			m_stateFilter.SetTexture( samplerIndex, pTexture );
+		}
+
+		void DrawIndexed(
+			ERendererPrimitiveType /*primitiveType*/, uint32_t /*baseVertexIndex*/, uint32_t /*minIndex*/,
+			uint32_t /*usedVertexCount*/, uint32_t /*startIndex*/, uint32_t primitiveCount )
+		{
+			RenderStatistics::RecordDraw( primitiveCount, 0 );
+		}
+
+		void DrawIndexedInstanced(
+			ERendererPrimitiveType /*primitiveType*/, uint32_t /*baseVertexIndex*/, uint32_t /*minIndex*/,
+			uint32_t /*usedVertexCount*/, uint32_t /*startIndex*/, uint32_t primitiveCount, uint32_t instanceCount )
+		{
+			RenderStatistics::RecordDraw( primitiveCount, instanceCount );
+		}
+
+		void DrawUnindexed(
+			ERendererPrimitiveType /*primitiveType*/, uint32_t /*baseVertexIndex*/, uint32_t primitiveCount )
+		{
+			RenderStatistics::RecordDraw( primitiveCount, 0 );
+		}
+
+		void CullGpuDraws(
+			RGpuCullingBatch* /*pBatch*/, const float32_t* /*pViewProjection*/, RTexture2d* /*pDepthPyramid*/ )
+		{
+		}
+
+		void DrawGpuCulled( ERendererPrimitiveType /*primitiveType*/, RGpuCullingBatch* /*pBatch*/ )
+		{
+		}
+
+		void SetFence( RFence* /*pFence*/ )
+		{
+		}
+
+		void IssueTimerQuery( RTimerQuery* /*pQuery*/ )
+		{
+		}
+
+		void UnbindResources()
+		{
+			m_stateFilter.Reset();
+		}
+
+		void ExecuteCommandList( RRenderCommandList* pCommandList )
+		{
+			HELIUM_ASSERT( pCommandList );
+
+			const DynamicArray< NullRenderCommand >& rCommands =
+				static_cast< NullRenderCommandList* >( pCommandList )->m_commands;
+			size_t commandCount = rCommands.GetSize();
+			for( size_t commandIndex = 0; commandIndex < commandCount; ++commandIndex )
+			{
+				ExecuteCommand( rCommands[ commandIndex ] );
+			}
+		}
+
+		void FinishCommandList( RRenderCommandListPtr& rspCommandList )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"NullImmediateCommandProxy: FinishCommandList() called on an immediate command proxy.\n" );
+
+			HELIUM_BREAK_MSG( "NullImmediateCommandProxy: FinishCommandList() called on an immediate command proxy" );
+
+			rspCommandList.Release();
+		}
+
+	private:
+		/// Replay a command recorded by a deferred command proxy.
+		void ExecuteCommand( const NullRenderCommand& rCommand )
+		{
+			RRenderResource* pResource = rCommand.spResource;
+
+			switch( rCommand.type )
+			{
+				case NullRenderCommand::TYPE_RASTERIZER_STATE:
+				{
+					SetRasterizerState( static_cast< RRasterizerState* >( pResource ) );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_BLEND_STATE:
+				{
+					SetBlendState( static_cast< RBlendState* >( pResource ) );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_DEPTH_STENCIL_STATE:
+				{
+					SetDepthStencilState(
+						static_cast< RDepthStencilState* >( pResource ),
+						static_cast< uint8_t >( rCommand.slot ) );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_SAMPLER_STATE:
+				{
+					RSamplerState* pState = static_cast< RSamplerState* >( pResource );
+					SetSamplerStates( rCommand.slot, 1, &pState );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_INDEX_BUFFER:
+				{
+					SetIndexBuffer( static_cast< RIndexBuffer* >( pResource ) );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_VERTEX_BUFFER:
+				{
+					RVertexBuffer* pBuffer = static_cast< RVertexBuffer* >( pResource );
+					uint32_t stride = rCommand.values[ 0 ];
+					uint32_t offset = rCommand.values[ 1 ];
+					SetVertexBuffers( rCommand.slot, 1, &pBuffer, &stride, &offset );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_VERTEX_INPUT_LAYOUT:
+				{
+					SetVertexInputLayout( static_cast< RVertexInputLayout* >( pResource ) );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_VERTEX_SHADER:
+				{
+					SetVertexShader( static_cast< RVertexShader* >( pResource ) );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_PIXEL_SHADER:
+				{
+					SetPixelShader( static_cast< RPixelShader* >( pResource ) );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_TEXTURE:
+				{
+					SetTexture( rCommand.slot, static_cast< RTexture* >( pResource ) );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_DRAW:
+				{
+					RenderStatistics::RecordDraw( rCommand.values[ 0 ], rCommand.values[ 1 ] );
+					break;
+				}
+
+				case NullRenderCommand::TYPE_UNBIND_RESOURCES:
+				{
+					UnbindResources();
+					break;
+				}
+			}
+		}
+	};
+
+	/// Deferred command proxy, recording binds and draws for replay through the immediate command proxy.
+	class NullDeferredCommandProxy : public RRenderCommandProxy
+	{
+	public:
+		NullDeferredCommandProxy()
+			: m_spCommandList( new NullRenderCommandList )
+		{
+		}
+
+		void SetRasterizerState( RRasterizerState* pState )
+		{
+			Record( NullRenderCommand::TYPE_RASTERIZER_STATE, pState );
+		}
+
+		void SetBlendState( RBlendState* pState )
+		{
+			Record( NullRenderCommand::TYPE_BLEND_STATE, pState );
+		}
+
+		void SetDepthStencilState( RDepthStencilState* pState, uint8_t stencilReferenceValue )
+		{
+			Record( NullRenderCommand::TYPE_DEPTH_STENCIL_STATE, pState, stencilReferenceValue );
+		}
+
+		void SetSamplerStates( size_t startIndex, size_t samplerCount, RSamplerState* const* ppStates )
+		{
+			HELIUM_ASSERT( ppStates || samplerCount == 0 );
+
+			for( size_t samplerIndex = 0; samplerIndex < samplerCount; ++samplerIndex )
+			{
+				Record(
+					NullRenderCommand::TYPE_SAMPLER_STATE,
+					ppStates[ samplerIndex ],
+					static_cast< uint32_t >( startIndex + samplerIndex ) );
+			}
+		}
+
+		void SetRenderSurfaces( RSurface* /*pRenderTargetSurface*/, RSurface* /*pDepthStencilSurface*/ )
+		{
+		}
+
+		void SetViewport( uint32_t /*x*/, uint32_t /*y*/, uint32_t /*width*/, uint32_t /*height*/ )
+		{
+		}
+
+		void BeginScene()
+		{
+		}
+
+		void EndScene()
+		{
+		}
+
+		void Clear( uint32_t /*clearFlags*/, const Color& /*rColor*/, float32_t /*depth*/, uint8_t /*stencil*/ )
+		{
+		}
+
+		void SetIndexBuffer( RIndexBuffer* pBuffer )
+		{
+			Record( NullRenderCommand::TYPE_INDEX_BUFFER, pBuffer );
+		}
+
+		void SetVertexBuffers(
+			size_t startIndex, size_t bufferCount, RVertexBuffer* const* ppBuffers, uint32_t* pStrides,
+			uint32_t* pOffsets )
+		{
+			HELIUM_ASSERT( ppBuffers || bufferCount == 0 );
+			HELIUM_ASSERT( pStrides || bufferCount == 0 );
+			HELIUM_ASSERT( pOffsets || bufferCount == 0 );
+
+			for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+			{
+				Record(
+					NullRenderCommand::TYPE_VERTEX_BUFFER,
+					ppBuffers[ bufferIndex ],
+					static_cast< uint32_t >( startIndex + bufferIndex ),
+					pStrides[ bufferIndex ],
+					pOffsets[ bufferIndex ] );
+			}
+		}
+
+		void SetVertexInputLayout( RVertexInputLayout* pLayout )
+		{
+			Record( NullRenderCommand::TYPE_VERTEX_INPUT_LAYOUT, pLayout );
+		}
+
+		void SetVertexShader( RVertexShader* pShader )
+		{
+			Record( NullRenderCommand::TYPE_VERTEX_SHADER, pShader );
+		}
+
+		void SetPixelShader( RPixelShader* pShader )
+		{
+			Record( NullRenderCommand::TYPE_PIXEL_SHADER, pShader );
+		}
+
+		void SetVertexConstantBuffers(
+			size_t /*startIndex*/, size_t /*bufferCount*/, RConstantBuffer* const* /*ppBuffers*/,
+			const size_t* /*pLimitSizes*/, const size_t* /*pOffsets*/ )
+		{
+		}
+
+		void SetPixelConstantBuffers(
+			size_t /*startIndex*/, size_t /*bufferCount*/, RConstantBuffer* const* /*ppBuffers*/,
+			const size_t* /*pLimitSizes*/, const size_t* /*pOffsets*/ )
+		{
+		}
+
+		void SetTexture( size_t samplerIndex, RTexture* pTexture )
+		{
+			Record( NullRenderCommand::TYPE_TEXTURE, pTexture, static_cast< uint32_t >( samplerIndex ) );
+		}
+
+		void DrawIndexed(
+			ERendererPrimitiveType /*primitiveType*/, uint32_t /*baseVertexIndex*/, uint32_t /*minIndex*/,
+			uint32_t /*usedVertexCount*/, uint32_t /*startIndex*/, uint32_t primitiveCount )
+		{
+			Record( NullRenderCommand::TYPE_DRAW, NULL, 0, primitiveCount, 0 );
+		}
+
+		void DrawIndexedInstanced(
+			ERendererPrimitiveType /*primitiveType*/, uint32_t /*baseVertexIndex*/, uint32_t /*minIndex*/,
+			uint32_t /*usedVertexCount*/, uint32_t /*startIndex*/, uint32_t primitiveCount, uint32_t instanceCount )
+		{
+			Record( NullRenderCommand::TYPE_DRAW, NULL, 0, primitiveCount, instanceCount );
+		}
+
+		void DrawUnindexed(
+			ERendererPrimitiveType /*primitiveType*/, uint32_t /*baseVertexIndex*/, uint32_t primitiveCount )
+		{
+			Record( NullRenderCommand::TYPE_DRAW, NULL, 0, primitiveCount, 0 );
+		}
+
+		void CullGpuDraws(
+			RGpuCullingBatch* /*pBatch*/, const float32_t* /*pViewProjection*/, RTexture2d* /*pDepthPyramid*/ )
+		{
+		}
+
+		void DrawGpuCulled( ERendererPrimitiveType /*primitiveType*/, RGpuCullingBatch* /*pBatch*/ )
+		{
+		}
+
+		void SetFence( RFence* /*pFence*/ )
+		{
+		}
+
+		void IssueTimerQuery( RTimerQuery* /*pQuery*/ )
+		{
+		}
+
+		void UnbindResources()
+		{
+			Record( NullRenderCommand::TYPE_UNBIND_RESOURCES, NULL );
+		}
+
+		void ExecuteCommandList( RRenderCommandList* pCommandList )
+		{
+			HELIUM_ASSERT( pCommandList );
+
+			const DynamicArray< NullRenderCommand >& rCommands =
+				static_cast< NullRenderCommandList* >( pCommandList )->m_commands;
+			m_spCommandList->m_commands.AddArray( rCommands.GetData(), rCommands.GetSize() );
+		}
+
+		void FinishCommandList( RRenderCommandListPtr& rspCommandList )
+		{
+			rspCommandList = m_spCommandList.Get();
+			m_spCommandList = new NullRenderCommandList;
+		}
+
+	private:
+		/// Command list being recorded.
+		NullRenderCommandListPtr m_spCommandList;
+
+		/// Record a command.
+		void Record(
+			NullRenderCommand::EType type, RRenderResource* pResource, uint32_t slot = 0, uint32_t value0 = 0,
+			uint32_t value1 = 0 )
+		{
+			NullRenderCommand* pCommand = m_spCommandList->m_commands.New();
+			HELIUM_ASSERT( pCommand );
+			pCommand->type = type;
+			pCommand->spResource = pResource;
+			pCommand->slot = slot;
+			pCommand->values[ 0 ] = value0;
+			pCommand->values[ 1 ] = value1;
+		}
+	};
+}
+
+/// Constructor.
+NullRenderer::NullRenderer()
+{
+}
+
+/// Destructor.
+NullRenderer::~NullRenderer()
+{
+}
+
+/// @copydoc Renderer::Initialize()
+bool NullRenderer::Initialize()
+{
+	HELIUM_TRACE( TraceLevels::Info, "Initializing null rendering support.\n" );
+
+	// Timer queries and GPU-driven culling are left unsupported so that timing and culling stay on the CPU, where they
+	// can be measured.  Compressed formats are supported so that textures are never transcoded on load.
+	m_featureFlags =
+		RENDERER_FEATURE_FLAG_DEPTH_TEXTURE |
+		RENDERER_FEATURE_FLAG_MULTITHREADED |
+		RENDERER_FEATURE_FLAG_BC4_BC5 |
+		RENDERER_FEATURE_FLAG_BC7;
+
+	m_spImmediateCommandProxy = new NullImmediateCommandProxy;
+
+	return true;
+}
+
+/// @copydoc Renderer::Cleanup()
+void NullRenderer::Cleanup()
+{
+	HELIUM_TRACE( TraceLevels::Info, "Shutting down null rendering support.\n" );
+
+	m_spMainContext.Release();
+	m_spImmediateCommandProxy.Release();
+
+	ClearVertexInputCache();
+
+	m_featureFlags = 0;
+}
+
+/// @copydoc Renderer::CreateMainContext()
+bool NullRenderer::CreateMainContext( const ContextInitParameters& /*rInitParameters*/ )
+{
+	HELIUM_ASSERT( !m_spMainContext );
+	m_spMainContext = new NullRenderContext;
+
+	return true;
+}
+
+/// @copydoc Renderer::ResetMainContext()
+bool NullRenderer::ResetMainContext( const ContextInitParameters& /*rInitParameters*/ )
+{
+	return true;
+}
+
+/// @copydoc Renderer::GetMainContext()
+RRenderContext* NullRenderer::GetMainContext()
+{
+	return m_spMainContext;
+}
+
+/// @copydoc Renderer::CreateSubContext()
+RRenderContext* NullRenderer::CreateSubContext( const ContextInitParameters& /*rInitParameters*/ )
+{
+	return new NullRenderContext;
+}
+
+/// @copydoc Renderer::GetStatus()
+Renderer::EStatus NullRenderer::GetStatus()
+{
+	return STATUS_READY;
+}
+
+/// @copydoc Renderer::Reset()
+Renderer::EStatus NullRenderer::Reset()
+{
+	return STATUS_READY;
+}
+
+/// @copydoc Renderer::CreateRasterizerState()
+RRasterizerState* NullRenderer::CreateRasterizerState( const RRasterizerState::Description& rDescription )
+{
+	return new NullStateObject< RRasterizerState >( rDescription );
+}
+
+/// @copydoc Renderer::CreateBlendState()
+RBlendState* NullRenderer::CreateBlendState( const RBlendState::Description& rDescription )
+{
+	return new NullStateObject< RBlendState >( rDescription );
+}
+
+/// @copydoc Renderer::CreateDepthStencilState()
+RDepthStencilState* NullRenderer::CreateDepthStencilState( const RDepthStencilState::Description& rDescription )
+{
+	return new NullStateObject< RDepthStencilState >( rDescription );
+}
+
+/// @copydoc Renderer::CreateSamplerState()
+RSamplerState* NullRenderer::CreateSamplerState( const RSamplerState::Description& rDescription )
+{
+	return new NullStateObject< RSamplerState >( rDescription );
+}
+
+/// @copydoc Renderer::CreateDepthStencilSurface()
+RSurface* NullRenderer::CreateDepthStencilSurface(
+	uint32_t /*width*/,
+	uint32_t /*height*/,
+	ERendererSurfaceFormat /*format*/,
+	uint32_t /*multisampleCount*/ )
+{
+	return new NullSurface;
+}
+
+/// @copydoc Renderer::CreateVertexShader()
+RVertexShader* NullRenderer::CreateVertexShader( size_t size, const void* pData )
+{
+	return new NullShader< RVertexShader >( size, pData );
+}
+
+/// @copydoc Renderer::CreatePixelShader()
+RPixelShader* NullRenderer::CreatePixelShader( size_t size, const void* pData )
+{
+	return new NullShader< RPixelShader >( size, pData );
+}
+
+/// @copydoc Renderer::CreateVertexBuffer()
+RVertexBuffer* NullRenderer::CreateVertexBuffer( size_t size, ERendererBufferUsage /*usage*/, const void* pData )
+{
+	return new NullVertexBuffer( size, pData );
+}
+
+/// @copydoc Renderer::CreateIndexBuffer()
+RIndexBuffer* NullRenderer::CreateIndexBuffer(
+	size_t size,
+	ERendererBufferUsage /*usage*/,
+	ERendererIndexFormat /*format*/,
+	const void* pData )
+{
+	return new NullIndexBuffer( size, pData );
+}
+
+/// @copydoc Renderer::CreateConstantBuffer()
+RConstantBuffer* NullRenderer::CreateConstantBuffer( size_t size, ERendererBufferUsage /*usage*/, const void* pData )
+{
+	return new NullConstantBuffer( size, pData );
+}
+
+/// @copydoc Renderer::CreateVertexDescription()
+RVertexDescription* NullRenderer::CreateVertexDescription(
+	const RVertexDescription::Element* /*pElements*/,
+	size_t /*elementCount*/ )
+{
+	return new NullVertexDescription;
+}
+
+/// @copydoc Renderer::CreateVertexInputLayout()
+RVertexInputLayout* NullRenderer::CreateVertexInputLayout(
+	RVertexDescription* /*pDescription*/,
+	RVertexShader* /*pShader*/ )
+{
+	return new NullVertexInputLayout;
+}
+
+/// @copydoc Renderer::CreateTexture2d()
+RTexture2d* NullRenderer::CreateTexture2d(
+	uint32_t width,
+	uint32_t height,
+	uint32_t mipCount,
+	ERendererPixelFormat format,
+	ERendererBufferUsage /*usage*/,
+	const RTexture2d::CreateData* pData )
+{
+	HELIUM_ASSERT( width != 0 );
+	HELIUM_ASSERT( height != 0 );
+	HELIUM_ASSERT( mipCount != 0 );
+
+	NullTexture2d* pTexture = new NullTexture2d( width, height, mipCount, format );
+	HELIUM_ASSERT( pTexture );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_TEXTURE_BYTES, pTexture->GetTrackedMemorySize() );
+	}
+
+	return pTexture;
+}
+
+/// @copydoc Renderer::CreateGpuCullingBatch()
+RGpuCullingBatch* NullRenderer::CreateGpuCullingBatch( uint32_t /*objectCapacity*/, uint32_t /*drawCapacity*/ )
+{
+	HELIUM_TRACE( TraceLevels::Error, "NullRenderer::CreateGpuCullingBatch(): GPU-driven culling is not supported.\n" );
+
+	return NULL;
+}
+
+/// @copydoc Renderer::CreateFence()
+RFence* NullRenderer::CreateFence()
+{
+	return new NullFence;
+}
+
+/// @copydoc Renderer::SyncFence()
+void NullRenderer::SyncFence( RFence* /*pFence*/ )
+{
+}
+
+/// @copydoc Renderer::TrySyncFence()
+bool NullRenderer::TrySyncFence( RFence* /*pFence*/ )
+{
+	return true;
+}
+
+/// @copydoc Renderer::CreateTimerQuery()
+RTimerQuery* NullRenderer::CreateTimerQuery()
+{
+	return NULL;
+}
+
+/// @copydoc Renderer::TryGetTimerQueryTimestamp()
+bool NullRenderer::TryGetTimerQueryTimestamp( RTimerQuery* /*pQuery*/, uint64_t& rTimestamp )
+{
+	rTimestamp = 0;
+
+	return false;
+}
+
+/// @copydoc Renderer::GetTimerQueryFrequency()
+uint64_t NullRenderer::GetTimerQueryFrequency()
+{
+	return 0;
+}
+
+/// @copydoc Renderer::GetImmediateCommandProxy()
+RRenderCommandProxy* NullRenderer::GetImmediateCommandProxy()
+{
+	return m_spImmediateCommandProxy;
+}
+
+/// @copydoc Renderer::CreateDeferredCommandProxy()
+RRenderCommandProxy* NullRenderer::CreateDeferredCommandProxy()
+{
+	return new NullDeferredCommandProxy;
+}
+
+/// @copydoc Renderer::Flush()
+void NullRenderer::Flush()
+{
+}
+
+/// Create the global null renderer instance.
+///
+/// @see Shutdown()
+void NullRenderer::Startup()
+{
+	if ( ++g_InitCount == 1 )
+	{
+		HELIUM_ASSERT( !sm_pInstance );
+		sm_pInstance = new NullRenderer;
+		HELIUM_ASSERT( sm_pInstance );
+		if ( !HELIUM_VERIFY( sm_pInstance->Initialize() ) )
+		{
+			Shutdown();
+		}
+	}
+}
+
+/// Destroy the global null renderer instance if one exists.
+///
+/// @see Startup()
+void NullRenderer::Shutdown()
+{
+	if ( --g_InitCount == 0 )
+	{
+		HELIUM_ASSERT( sm_pInstance );
+		sm_pInstance->Cleanup();
+		delete sm_pInstance;
+		sm_pInstance = NULL;
+	}
+}
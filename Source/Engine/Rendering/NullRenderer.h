@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Rendering/Renderer.h"
+
+namespace Helium
+{
+	HELIUM_DECLARE_RPTR( RRenderCommandProxy );
+	HELIUM_DECLARE_RPTR( RRenderContext );
+
+	/// Renderer implementation that issues no commands to a GPU.
+	///
+	/// Resources are backed by system memory so they can be created, mapped, and filled as usual, and command proxies
+	/// run every bind through the redundant state filter and record every draw in the render statistics, exactly as the
+	/// hardware renderers do.  This allows the CPU side of the rendering pipeline (scene updates, culling, render queue
+	/// sorting, and command recording) to be run and measured on machines without a usable GPU, such as build servers.
+	///
+	/// Deferred command proxies record commands into command lists that are replayed through the immediate command
+	/// proxy when executed, so draws and binds are counted against the pass in which they are submitted.
+	class HELIUM_RENDERING_API NullRenderer : public Renderer
+	{
+	public:
+		/// @name Initialization
+		//@{
+		bool Initialize();
+		void Cleanup();
+		//@}
+
+		/// @name Display Initialization
+		//@{
+		bool CreateMainContext( const ContextInitParameters& rInitParameters );
+		bool ResetMainContext( const ContextInitParameters& rInitParameters );
+		RRenderContext* GetMainContext();
+
+		RRenderContext* CreateSubContext( const ContextInitParameters& rInitParameters );
+
+		EStatus GetStatus();
+		EStatus Reset();
+		//@}
+
+		/// @name State Object Creation
+		//@{
+		RRasterizerState* CreateRasterizerState( const RRasterizerState::Description& rDescription );
+		RBlendState* CreateBlendState( const RBlendState::Description& rDescription );
+		RDepthStencilState* CreateDepthStencilState( const RDepthStencilState::Description& rDescription );
+		RSamplerState* CreateSamplerState( const RSamplerState::Description& rDescription );
+		//@}
+
+		/// @name Resource Allocation
+		//@{
+		RSurface* CreateDepthStencilSurface(
+			uint32_t width, uint32_t height, ERendererSurfaceFormat format, uint32_t multisampleCount );
+
+		RVertexShader* CreateVertexShader( size_t size, const void* pData );
+		RPixelShader* CreatePixelShader( size_t size, const void* pData );
+
+		RVertexBuffer* CreateVertexBuffer( size_t size, ERendererBufferUsage usage, const void* pData );
+		RIndexBuffer* CreateIndexBuffer(
+			size_t size, ERendererBufferUsage usage, ERendererIndexFormat format, const void* pData );
+		RConstantBuffer* CreateConstantBuffer( size_t size, ERendererBufferUsage usage, const void* pData );
+
+		RVertexDescription* CreateVertexDescription( const RVertexDescription::Element* pElements, size_t elementCount );
+		RVertexInputLayout* CreateVertexInputLayout( RVertexDescription* pDescription, RVertexShader* pShader );
+
+		RTexture2d* CreateTexture2d(
+			uint32_t width, uint32_t height, uint32_t mipCount, ERendererPixelFormat format, ERendererBufferUsage usage,
+			const RTexture2d::CreateData* pData );
+
+		RGpuCullingBatch* CreateGpuCullingBatch( uint32_t objectCapacity, uint32_t drawCapacity );
+		//@}
+
+		/// @name Deferred Query Allocation
+		//@{
+		RFence* CreateFence();
+		void SyncFence( RFence* pFence );
+		bool TrySyncFence( RFence* pFence );
+
+		RTimerQuery* CreateTimerQuery();
+		bool TryGetTimerQueryTimestamp( RTimerQuery* pQuery, uint64_t& rTimestamp );
+		uint64_t GetTimerQueryFrequency();
+		//@}
+
+		/// @name Command Interfaces
+		//@{
+		RRenderCommandProxy* GetImmediateCommandProxy();
+		RRenderCommandProxy* CreateDeferredCommandProxy();
+
+		void Flush();
+		//@}
+
+		/// @name Static Initialization
+		//@{
+		static void Startup();
+		static void Shutdown();
+		//@}
+
+	private:
+		/// Immediate render command proxy.
+		RRenderCommandProxyPtr m_spImmediateCommandProxy;
+		/// Main rendering context.
+		RRenderContextPtr m_spMainContext;
+
+		/// @name Construction/Destruction
+		//@{
+		NullRenderer();
+		virtual ~NullRenderer();
+		//@}
+	};
+}
@@ -0,0 +1,33 @@
+#include "Precompile.h"
+#include "Rendering/RGpuCullingBatch.h"
+
+using namespace Helium;
+
+/// Constructor.
+///
+/// @param[in] objectCapacity  Maximum number of objects.
+/// @param[in] drawCapacity    Maximum number of draws.
+RGpuCullingBatch::RGpuCullingBatch( uint32_t objectCapacity, uint32_t drawCapacity )
+: m_objectCapacity( objectCapacity )
+, m_drawCapacity( drawCapacity )
+, m_drawCount( 0 )
+{
+}
+
+/// Destructor.
+RGpuCullingBatch::~RGpuCullingBatch()
+{
+}
+
+/// Set the number of draw records culled and drawn from this batch.
+///
+/// Only the first @c drawCount records written using MapDraws() are used.
+///
+/// @param[in] drawCount  Number of draws (clamped to the draw capacity).
+///
+/// @see GetDrawCount()
+void RGpuCullingBatch::SetDrawCount( uint32_t drawCount )
+{
+    HELIUM_ASSERT( drawCount <= m_drawCapacity );
+    m_drawCount = Min( drawCount, m_drawCapacity );
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Rendering/RRenderResource.h"
+
+namespace Helium
+{
+    /// GPU-driven culling batch interface.
+    ///
+    /// A batch holds the bounds of a set of objects and a list of indexed draw records referencing them, both stored in
+    /// GPU buffers.  RRenderCommandProxy::CullGpuDraws() runs a compute pass that tests each draw's object against the
+    /// view frustum (and optionally a depth pyramid for occlusion) and writes indirect draw arguments, and
+    /// RRenderCommandProxy::DrawGpuCulled() issues all of the batch's draws with a single indirect multi-draw call, so
+    /// the CPU cost of drawing a batch does not depend on the number of objects in it.
+    ///
+    /// All draws in a batch read from the vertex and index buffers bound when the batch is drawn, and each draw's
+    /// object index is passed to the shaders as its base instance so that per-object data can be fetched.  Batches are
+    /// only supported by renderers reporting RENDERER_FEATURE_FLAG_GPU_CULLING.
+    class HELIUM_RENDERING_API RGpuCullingBatch : public RRenderResource
+    {
+    public:
+        /// Object bounding sphere.
+        struct ObjectBounds
+        {
+            /// World-space sphere center.
+            float32_t center[ 3 ];
+            /// Sphere radius.
+            float32_t radius;
+        };
+
+        /// Indexed draw record.
+        struct Draw
+        {
+            /// Index of the object whose bounds are used to cull the draw.
+            uint32_t objectIndex;
+            /// Number of indices to draw.
+            uint32_t indexCount;
+            /// Index of the first index to read.
+            uint32_t startIndex;
+            /// Offset added to each index.
+            int32_t baseVertexIndex;
+        };
+
+        /// @name Data Access
+        //@{
+        virtual ObjectBounds* MapObjects() = 0;
+        virtual void UnmapObjects() = 0;
+
+        virtual Draw* MapDraws() = 0;
+        virtual void UnmapDraws() = 0;
+
+        inline uint32_t GetObjectCapacity() const;
+        inline uint32_t GetDrawCapacity() const;
+
+        void SetDrawCount( uint32_t drawCount );
+        inline uint32_t GetDrawCount() const;
+        //@}
+
+    protected:
+        /// Maximum number of objects.
+        uint32_t m_objectCapacity;
+        /// Maximum number of draws.
+        uint32_t m_drawCapacity;
+        /// Number of draws in use.
+        uint32_t m_drawCount;
+
+        /// @name Construction/Destruction
+        //@{
+        RGpuCullingBatch( uint32_t objectCapacity, uint32_t drawCapacity );
+        virtual ~RGpuCullingBatch() = 0;
+        //@}
+    };
+}
+
+#include "Rendering/RGpuCullingBatch.inl"
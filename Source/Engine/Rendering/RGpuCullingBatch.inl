@@ -0,0 +1,28 @@
+namespace Helium
+{
+    /// Get the maximum number of objects whose bounds can be stored in this batch.
+    ///
+    /// @return  Object capacity.
+    uint32_t RGpuCullingBatch::GetObjectCapacity() const
+    {
+        return m_objectCapacity;
+    }
+
+    /// Get the maximum number of draws that can be stored in this batch.
+    ///
+    /// @return  Draw capacity.
+    uint32_t RGpuCullingBatch::GetDrawCapacity() const
+    {
+        return m_drawCapacity;
+    }
+
+    /// Get the number of draw records culled and drawn from this batch.
+    ///
+    /// @return  Draw count.
+    ///
+    /// @see SetDrawCount()
+    uint32_t RGpuCullingBatch::GetDrawCount() const
+    {
+        return m_drawCount;
+    }
+}
@@ -121,7 +121,7 @@ RRenderCommandProxy::~RRenderCommandProxy()
 ///
 /// @see SetVertexShader()
 
-/// @fn void RRenderCommandProxy::SetVertexConstantBuffers( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes )
+/// @fn void RRenderCommandProxy::SetVertexConstantBuffers( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes, const size_t* pOffsets )
 /// Set a range of vertex shader constant buffers to use for rendering.
 ///
 /// @param[in] startIndex   Starting vertex shader constant buffer index to set.
@@ -133,10 +133,14 @@ RRenderCommandProxy::~RRenderCommandProxy()
 ///                         should be updated.  On platforms that don't support storage of constant buffers on the
 ///                         GPU (i.e. Direct3D 9 and such, where shader constants must be passed in the command
 ///                         buffer when changing), this can provide a significant performance improvement.
+/// @param[in] pOffsets     Optional array of offsets (in bytes, multiples of CONSTANT_BUFFER_OFFSET_ALIGNMENT) at which
+///                         to start reading each constant buffer, so that ranges of a single large buffer can be bound
+///                         for each draw.  When given, the bound range of each buffer also ends after its limit size
+///                         (if any), rather than at the end of the buffer.
 ///
 /// @see SetPixelConstantBuffers()
 
-/// @fn void RRenderCommandProxy::SetPixelConstantBuffers( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes )
+/// @fn void RRenderCommandProxy::SetPixelConstantBuffers( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes, const size_t* pOffsets )
 /// Set a range of pixel shader constant buffers to use for rendering.
 ///
 /// @param[in] startIndex   Starting pixel shader constant buffer index to set.
@@ -148,6 +152,10 @@ RRenderCommandProxy::~RRenderCommandProxy()
 ///                         should be updated.  On platforms that don't support storage of constant buffers on the
 ///                         GPU (i.e. Direct3D 9 and such, where shader constants must be passed in the command
 ///                         buffer when changing), this can provide a significant performance improvement.
+/// @param[in] pOffsets     Optional array of offsets (in bytes, multiples of CONSTANT_BUFFER_OFFSET_ALIGNMENT) at which
+///                         to start reading each constant buffer, so that ranges of a single large buffer can be bound
+///                         for each draw.  When given, the bound range of each buffer also ends after its limit size
+///                         (if any), rather than at the end of the buffer.
 ///
 /// @see SetVertexConstantBuffers()
 
@@ -168,7 +176,24 @@ RRenderCommandProxy::~RRenderCommandProxy()
 /// @param[in] startIndex       Offset of the first index within the index buffer to use for rendering.
 /// @param[in] primitiveCount   Number of primitives to render.
 ///
-/// @see DrawUnindexed()
+/// @see DrawIndexedInstanced(), DrawUnindexed()
+
+/// @fn void RRenderCommandProxy::DrawIndexedInstanced( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount, uint32_t startIndex, uint32_t primitiveCount, uint32_t instanceCount )
+/// Draw multiple instances of primitives based on a list of indexed vertices.
+///
+/// Vertex stream 0 provides the per-vertex data shared by all instances, while vertex stream 1 provides per-instance
+/// data, advancing once per instance.  All other streams are ignored.
+///
+/// @param[in] primitiveType    Type of primitive to render.
+/// @param[in] baseVertexIndex  Vertex offset of the first vertex to use from the start of vertex stream 0.
+/// @param[in] minIndex         Minimum vertex index value.
+/// @param[in] usedVertexCount  Range of vertices used during this call, starting from the vertex addressed by the
+///                             minimum vertex index value.
+/// @param[in] startIndex       Offset of the first index within the index buffer to use for rendering.
+/// @param[in] primitiveCount   Number of primitives to render for each instance.
+/// @param[in] instanceCount    Number of instances to render.
+///
+/// @see DrawIndexed()
 
 /// @fn void RRenderCommandProxy::DrawUnindexed( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t primitiveCount )
 /// Draw primitives based on an unindexed list of vertices.
@@ -188,6 +213,42 @@ RRenderCommandProxy::~RRenderCommandProxy()
 ///
 /// @see Renderer::CreateFence(), Renderer::SyncFence(), Renderer::TrySyncFence()
 
+/// @fn void RRenderCommandProxy::CullGpuDraws( RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid )
+/// Cull the draws of a GPU culling batch on the GPU and write their indirect draw arguments.
+///
+/// Each draw whose object bounding sphere lies outside the view frustum, or behind the depth stored in the depth
+/// pyramid, is written with an instance count of zero.  The depth pyramid must be a single-channel floating-point
+/// texture with a full mip chain, with each texel holding the farthest window-space depth (in the range [0, 1]) of
+/// the texels it covers in the level above.
+///
+/// @param[in] pBatch           Batch to cull.
+/// @param[in] pViewProjection  Combined view and projection matrix (16 row-major elements, transforming row
+///                             vectors).
+/// @param[in] pDepthPyramid    Optional depth pyramid of the previous depth pass for occlusion culling.
+///
+/// @see DrawGpuCulled(), Renderer::CreateGpuCullingBatch()
+
+/// @fn void RRenderCommandProxy::DrawGpuCulled( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch )
+/// Issue the draws of a GPU culling batch using the indirect draw arguments written by the last call to
+/// CullGpuDraws() for the batch.
+///
+/// All draws read from the currently bound vertex buffers, index buffer, input layout, and shaders.  The index
+/// buffer must be a static buffer.
+///
+/// @param[in] primitiveType  Type of primitives to draw.
+/// @param[in] pBatch         Batch to draw.
+///
+/// @see CullGpuDraws(), Renderer::CreateGpuCullingBatch()
+
+/// @fn void RRenderCommandProxy::IssueTimerQuery( RTimerQuery* pQuery )
+/// Record the GPU timestamp in a timer query once all previously issued commands have been processed by the GPU.
+///
+/// Information about timer queries and their use can be found in the description for Renderer::CreateTimerQuery()
+///
+/// @param[in] pQuery  Timer query to issue.
+///
+/// @see Renderer::CreateTimerQuery(), Renderer::TryGetTimerQueryTimestamp()
+
 /// @fn void RRenderCommandProxy::UnbindResources()
 /// Unbind all currently bound state objects, buffers, and textures, and reset the target render surfaces to the
 /// default set provided by the main render context.
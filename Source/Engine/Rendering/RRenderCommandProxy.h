@@ -4,6 +4,7 @@
 
 #include "Math/Color.h"
 #include "Rendering/RendererTypes.h"
+#include "Rendering/RenderStateFilter.h"
 
 namespace Helium
 {
@@ -19,8 +20,11 @@ namespace Helium
     class RPixelShader;
 
     class RTexture;
+    class RTexture2d;
+    class RGpuCullingBatch;
 
     class RFence;
+    class RTimerQuery;
 
     HELIUM_DECLARE_RPTR( RSamplerState );
     HELIUM_DECLARE_RPTR( RVertexBuffer );
@@ -69,31 +73,46 @@ namespace Helium
 
         virtual void SetVertexConstantBuffers(
             size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
-            const size_t* pLimitSizes = NULL ) = 0;
+            const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL ) = 0;
         inline void SetVertexConstantBuffers(
             size_t startIndex, size_t bufferCount, RConstantBufferPtr const* pspBuffers,
-            const size_t* pLimitSizes = NULL );
+            const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL );
         virtual void SetPixelConstantBuffers(
             size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
-            const size_t* pLimitSizes = NULL ) = 0;
+            const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL ) = 0;
         inline void SetPixelConstantBuffers(
             size_t startIndex, size_t bufferCount, RConstantBufferPtr const* pspBuffers,
-            const size_t* pLimitSizes = NULL );
+            const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL );
 
         virtual void SetTexture( size_t samplerIndex, RTexture* pTexture ) = 0;
 
         virtual void DrawIndexed(
             ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
             uint32_t startIndex, uint32_t primitiveCount ) = 0;
+        virtual void DrawIndexedInstanced(
+            ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
+            uint32_t startIndex, uint32_t primitiveCount, uint32_t instanceCount ) = 0;
         virtual void DrawUnindexed(
             ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t primitiveCount ) = 0;
         //@}
 
+        /// @name GPU-Driven Culling Commands
+        //@{
+        virtual void CullGpuDraws(
+            RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid = NULL ) = 0;
+        virtual void DrawGpuCulled( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch ) = 0;
+        //@}
+
         /// @name Fence Commands
         //@{
         virtual void SetFence( RFence* pFence ) = 0;
         //@}
 
+        /// @name Timer Query Commands
+        //@{
+        virtual void IssueTimerQuery( RTimerQuery* pQuery ) = 0;
+        //@}
+
         /// @name Miscellaneous Resource Management
         //@{
         virtual void UnbindResources() = 0;
@@ -106,7 +125,17 @@ namespace Helium
         virtual void FinishCommandList( RRenderCommandListPtr& rspCommandList ) = 0;
         //@}
 
+        /// @name Redundant State Filtering
+        //@{
+        inline const RenderStateFilter& GetStateFilter() const;
+        inline void ResetStateFilter();
+        inline void ResetStateFilterStats();
+        //@}
+
     protected:
+        /// Filter used to drop redundant state and resource binds before they reach the renderer.
+        RenderStateFilter m_stateFilter;
+
         /// @name Construction/Destruction
         //@{
         virtual ~RRenderCommandProxy() = 0;
@@ -53,19 +53,25 @@ namespace Helium
     ///                         should be updated.  On platforms that don't support storage of constant buffers on the
     ///                         GPU (i.e. Direct3D 9 and such, where shader constants must be passed in the command
     ///                         buffer when changing), this can provide a significant performance improvement.
+    /// @param[in] pOffsets     Optional array of offsets (in bytes, multiples of CONSTANT_BUFFER_OFFSET_ALIGNMENT) at which
+    ///                         to start reading each constant buffer, so that ranges of a single large buffer can be bound
+    ///                         for each draw.  When given, the bound range of each buffer also ends after its limit size
+    ///                         (if any), rather than at the end of the buffer.
     ///
     /// @see SetPixelConstantBuffers()
     void RRenderCommandProxy::SetVertexConstantBuffers(
         size_t startIndex,
         size_t bufferCount,
         RConstantBufferPtr const* pspBuffers,
-        const size_t* pLimitSizes )
+        const size_t* pLimitSizes,
+        const size_t* pOffsets )
     {
         SetVertexConstantBuffers(
             startIndex,
             bufferCount,
             &static_cast< RConstantBuffer* const& >( pspBuffers[ 0 ] ),
-            pLimitSizes );
+            pLimitSizes,
+            pOffsets );
     }
 
     /// Set a range of pixel shader constant buffers to use for rendering.
@@ -79,18 +85,57 @@ namespace Helium
     ///                         should be updated.  On platforms that don't support storage of constant buffers on the
     ///                         GPU (i.e. Direct3D 9 and such, where shader constants must be passed in the command
     ///                         buffer when changing), this can provide a significant performance improvement.
+    /// @param[in] pOffsets     Optional array of offsets (in bytes, multiples of CONSTANT_BUFFER_OFFSET_ALIGNMENT) at which
+    ///                         to start reading each constant buffer, so that ranges of a single large buffer can be bound
+    ///                         for each draw.  When given, the bound range of each buffer also ends after its limit size
+    ///                         (if any), rather than at the end of the buffer.
     ///
     /// @see SetVertexConstantBuffers()
     void RRenderCommandProxy::SetPixelConstantBuffers(
         size_t startIndex,
         size_t bufferCount,
         RConstantBufferPtr const* pspBuffers,
-        const size_t* pLimitSizes )
+        const size_t* pLimitSizes,
+        const size_t* pOffsets )
     {
         SetPixelConstantBuffers(
             startIndex,
             bufferCount,
             &static_cast< RConstantBuffer* const& >( pspBuffers[ 0 ] ),
-            pLimitSizes );
+            pLimitSizes,
+            pOffsets );
+    }
+
+    /// Get the filter used to drop redundant state and resource binds issued through this command proxy.
+    ///
+    /// The filter statistics can be used to inspect how many binds were issued and how many were dropped as redundant.
+    /// Command proxies that do not issue commands directly to the renderer (such as deferred command proxies) may not
+    /// filter binds themselves, in which case the binds are filtered once the recorded command list is executed.
+    ///
+    /// @return  Redundant state filter.
+    ///
+    /// @see ResetStateFilter(), ResetStateFilterStats()
+    const RenderStateFilter& RRenderCommandProxy::GetStateFilter() const
+    {
+        return m_stateFilter;
+    }
+
+    /// Forget all state tracked by the redundant state filter, forcing the next bind of each type to be issued.
+    ///
+    /// This must be called if the renderer state is changed without going through this command proxy.  Bind counters
+    /// are left intact.
+    ///
+    /// @see GetStateFilter(), ResetStateFilterStats()
+    void RRenderCommandProxy::ResetStateFilter()
+    {
+        m_stateFilter.Reset();
+    }
+
+    /// Reset the bind counters of the redundant state filter to zero.
+    ///
+    /// @see GetStateFilter(), ResetStateFilter()
+    void RRenderCommandProxy::ResetStateFilterStats()
+    {
+        m_stateFilter.ResetStats();
     }
 }
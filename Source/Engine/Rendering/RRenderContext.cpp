@@ -17,3 +17,14 @@ RRenderContext::~RRenderContext()
 /// Swap out the front buffer with the next buffer in queue, presenting the next frame of render data to the screen.
 ///
 /// @see RRenderCommandProxy::BeginScene(), RRenderCommandProxy::EndScene()
+
+/// @fn bool RRenderContext::Resize( uint32_t width, uint32_t height )
+/// Resize the back buffer of this context to match a resized window, without recreating the context.
+///
+/// Any back buffer surface previously returned by GetBackBufferSurface() should be fetched again afterward.
+///
+/// @param[in] width   New back buffer width, in pixels.
+/// @param[in] height  New back buffer height, in pixels.
+///
+/// @return  True if the back buffer was resized, false if this context cannot be resized in place (in which case the
+///          context needs to be recreated or reset).
@@ -14,6 +14,8 @@ namespace Helium
         //@{
         virtual RSurface* GetBackBufferSurface() = 0;
         virtual void Swap() = 0;
+
+        virtual bool Resize( uint32_t width, uint32_t height ) = 0;
         //@}
 
     protected:
@@ -1,9 +1,79 @@
 #include "Precompile.h"
 #include "Rendering/RRenderResource.h"
 
+#include "Engine/MemoryTelemetry.h"
+
 using namespace Helium;
 
+/// Constructor.
+RRenderResource::RRenderResource()
+	: m_memoryTracker( Invalid< uint32_t >() )
+	, m_trackedMemorySize( 0 )
+{
+}
+
 /// Destructor.
 RRenderResource::~RRenderResource()
 {
+	if( m_trackedMemorySize != 0 )
+	{
+		MemoryTelemetry::RecordFree( m_memoryTracker, m_trackedMemorySize );
+	}
+}
+
+/// Report the memory used by this resource to MemoryTelemetry.
+///
+/// This is called by the renderer when creating the resource.  The memory is reported as freed when the resource is
+/// destroyed.
+///
+/// @param[in] category  Resource memory category.
+/// @param[in] size      Number of bytes of (video or system) memory allocated for the resource.
+void RRenderResource::SetTrackedMemory( EMemoryCategory category, size_t size )
+{
+	HELIUM_ASSERT( static_cast< size_t >( category ) < static_cast< size_t >( MEMORY_CATEGORY_MAX ) );
+
+	static const char* const CATEGORY_NAMES[] =
+	{
+		"VertexBuffer",    // MEMORY_CATEGORY_VERTEX_BUFFER
+		"IndexBuffer",     // MEMORY_CATEGORY_INDEX_BUFFER
+		"ConstantBuffer",  // MEMORY_CATEGORY_CONSTANT_BUFFER
+		"Texture",         // MEMORY_CATEGORY_TEXTURE
+		"Surface",         // MEMORY_CATEGORY_SURFACE
+		"Shader"           // MEMORY_CATEGORY_SHADER
+	};
+
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( CATEGORY_NAMES ) == MEMORY_CATEGORY_MAX );
+
+	if( m_trackedMemorySize != 0 )
+	{
+		MemoryTelemetry::RecordFree( m_memoryTracker, m_trackedMemorySize );
+	}
+
+	m_memoryTracker = MemoryTelemetry::GetTracker(
+		MemoryTelemetry::CATEGORY_RENDER_RESOURCE,
+		Name( CATEGORY_NAMES[ category ] ) );
+	m_trackedMemorySize = size;
+
+	MemoryTelemetry::RecordAllocation( m_memoryTracker, size );
+}
+
+/// Get the number of bytes of memory reported for this resource.
+///
+/// @return  Reported memory size, or zero if no memory has been reported.
+///
+/// @see SetTrackedMemory()
+size_t RRenderResource::GetTrackedMemorySize() const
+{
+	return m_trackedMemorySize;
+}
+
+/// Get whether any data written to this resource is still waiting to be uploaded by the renderer.
+///
+/// Renderers that defer resource uploads (see Renderer::ProcessResourceUploads()) report resources as pending until
+/// their data has been copied over, so loading code should not consider a resource ready until this returns false.
+///
+/// @return  True if an upload is pending, false if not.
+bool RRenderResource::IsUploadPending() const
+{
+	return false;
 }
@@ -15,10 +15,52 @@ namespace Helium
     {
         friend class AtomicRefCountBase< RRenderResource >;
 
+    public:
+        /// Render resource memory categories reported to MemoryTelemetry.
+        enum EMemoryCategory
+        {
+            MEMORY_CATEGORY_FIRST   =  0,
+            MEMORY_CATEGORY_INVALID = -1,
+
+            /// Vertex buffer.
+            MEMORY_CATEGORY_VERTEX_BUFFER,
+            /// Index buffer.
+            MEMORY_CATEGORY_INDEX_BUFFER,
+            /// Constant buffer.
+            MEMORY_CATEGORY_CONSTANT_BUFFER,
+            /// Texture.
+            MEMORY_CATEGORY_TEXTURE,
+            /// Render target or depth-stencil surface.
+            MEMORY_CATEGORY_SURFACE,
+            /// Vertex or pixel shader.
+            MEMORY_CATEGORY_SHADER,
+
+            MEMORY_CATEGORY_MAX,
+            MEMORY_CATEGORY_LAST = MEMORY_CATEGORY_MAX - 1
+        };
+
+        /// @name Memory Tracking
+        //@{
+        void SetTrackedMemory( EMemoryCategory category, size_t size );
+        size_t GetTrackedMemorySize() const;
+        //@}
+
+        /// @name Upload Status
+        //@{
+        virtual bool IsUploadPending() const;
+        //@}
+
     protected:
         /// @name Construction/Destruction
         //@{
+        RRenderResource();
         virtual ~RRenderResource() = 0;
         //@}
+
+    private:
+        /// MemoryTelemetry tracker to which the memory of this resource is reported.
+        uint32_t m_memoryTracker;
+        /// Number of bytes of memory reported for this resource.
+        size_t m_trackedMemorySize;
     };
 }
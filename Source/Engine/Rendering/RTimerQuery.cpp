@@ -0,0 +1,9 @@
+#include "Precompile.h"
+#include "Rendering/RTimerQuery.h"
+
+using namespace Helium;
+
+/// Destructor.
+RTimerQuery::~RTimerQuery()
+{
+}
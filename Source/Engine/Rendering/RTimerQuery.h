@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Rendering/RRenderResource.h"
+
+namespace Helium
+{
+    /// GPU timestamp query interface.
+    ///
+    /// A timer query records the GPU clock once all commands issued before it have completed.  Results are read back
+    /// with Renderer::TryGetTimerQueryTimestamp() and converted to seconds using Renderer::GetTimerQueryFrequency().
+    class HELIUM_RENDERING_API RTimerQuery : public RRenderResource
+    {
+    protected:
+        /// @name Construction/Destruction
+        //@{
+        virtual ~RTimerQuery() = 0;
+        //@}
+    };
+}
@@ -39,7 +39,7 @@ void RVertexShader::CacheDescription( Renderer* pRenderer, RVertexDescription* p
         if( pDescription )
         {
             HELIUM_ASSERT( pRenderer );
-            m_spCachedInputLayout = pRenderer->CreateVertexInputLayout( pDescription, this );
+            m_spCachedInputLayout = pRenderer->GetVertexInputLayout( pDescription, this );
             HELIUM_ASSERT( m_spCachedInputLayout );
         }
     }
@@ -54,3 +54,42 @@ RVertexInputLayout* RVertexShader::GetCachedInputLayout() const
 {
     return m_spCachedInputLayout;
 }
+
+/// Get the input layout for the specified description, creating it if necessary.
+///
+/// Unlike CacheDescription(), this keeps the input layout for every description used with this shader and can be
+/// called safely from multiple threads at once (such as when recording command lists in parallel).
+///
+/// @param[in] pRenderer     Renderer instance.
+/// @param[in] pDescription  Vertex description.
+///
+/// @return  Input layout for the given description.
+RVertexInputLayout* RVertexShader::GetInputLayout( Renderer* pRenderer, RVertexDescription* pDescription )
+{
+    if( !pDescription )
+    {
+        return NULL;
+    }
+
+    MutexScopeLock scopeLock( m_inputLayoutLock );
+
+    size_t layoutCount = m_inputLayouts.GetSize();
+    for( size_t layoutIndex = 0; layoutIndex < layoutCount; ++layoutIndex )
+    {
+        const InputLayoutEntry& rEntry = m_inputLayouts[ layoutIndex ];
+        if( rEntry.spDescription.Get() == pDescription )
+        {
+            return rEntry.spInputLayout;
+        }
+    }
+
+    HELIUM_ASSERT( pRenderer );
+
+    InputLayoutEntry* pEntry = m_inputLayouts.New();
+    HELIUM_ASSERT( pEntry );
+    pEntry->spDescription = pDescription;
+    pEntry->spInputLayout = pRenderer->GetVertexInputLayout( pDescription, this );
+    HELIUM_ASSERT( pEntry->spInputLayout );
+
+    return pEntry->spInputLayout;
+}
@@ -2,6 +2,9 @@
 
 #include "Rendering/RShader.h"
 
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+
 namespace Helium
 {
     class Renderer;
@@ -22,14 +25,30 @@ namespace Helium
         //@{
         void CacheDescription( Renderer* pRenderer, RVertexDescription* pDescription );
         RVertexInputLayout* GetCachedInputLayout() const;
+
+        RVertexInputLayout* GetInputLayout( Renderer* pRenderer, RVertexDescription* pDescription );
         //@}
 
     protected:
+        /// Vertex description and its associated input layout.
+        struct InputLayoutEntry
+        {
+            /// Vertex description.
+            RVertexDescriptionPtr spDescription;
+            /// Input layout for the vertex description.
+            RVertexInputLayoutPtr spInputLayout;
+        };
+
         /// Most recently used vertex description.
         RVertexDescriptionPtr m_spCachedDescription;
         /// Input layout associated with the most recently used vertex description.
         RVertexInputLayoutPtr m_spCachedInputLayout;
 
+        /// Input layouts created for each vertex description used through GetInputLayout().
+        DynamicArray< InputLayoutEntry > m_inputLayouts;
+        /// Input layout lookup synchronization.
+        Mutex m_inputLayoutLock;
+
         /// @name Construction/Destruction
         //@{
         RVertexShader();
@@ -0,0 +1,461 @@
+#include "Precompile.h"
+#include "Rendering/RenderStateFilter.h"
+
+#include "Rendering/RBlendState.h"
+#include "Rendering/RDepthStencilState.h"
+#include "Rendering/RIndexBuffer.h"
+#include "Rendering/RPixelShader.h"
+#include "Rendering/RRasterizerState.h"
+#include "Rendering/RSamplerState.h"
+#include "Rendering/RTexture.h"
+#include "Rendering/RVertexBuffer.h"
+#include "Rendering/RVertexInputLayout.h"
+#include "Rendering/RVertexShader.h"
+#include "Engine/RenderStatistics.h"
+
+using namespace Helium;
+
+/// Constructor.
+RenderStateFilter::RenderStateFilter()
+    : m_stencilReferenceValue( 0 )
+    , m_knownBindFlags( 0 )
+    , m_knownSamplerStateFlags( 0 )
+    , m_knownVertexStreamFlags( 0 )
+    , m_knownTextureFlags( 0 )
+{
+    HELIUM_COMPILE_ASSERT( BIND_MAX <= sizeof( m_knownBindFlags ) * 8 );
+    HELIUM_COMPILE_ASSERT( SAMPLER_SLOT_COUNT <= sizeof( m_knownSamplerStateFlags ) * 8 );
+    HELIUM_COMPILE_ASSERT( VERTEX_STREAM_SLOT_COUNT <= sizeof( m_knownVertexStreamFlags ) * 8 );
+
+    ResetStats();
+}
+
+/// Destructor.
+RenderStateFilter::~RenderStateFilter()
+{
+}
+
+/// Filter a rasterizer state bind.
+///
+/// @param[in] pState  Rasterizer state being set.
+///
+/// @return  True if the bind should be issued, false if the state is already set.
+///
+/// @see SetBlendState(), SetDepthStencilState(), SetSamplerStates()
+bool RenderStateFilter::SetRasterizerState( RRasterizerState* pState )
+{
+    return SetSingle( BIND_RASTERIZER_STATE, m_spRasterizerState, pState );
+}
+
+/// Filter a blend state bind.
+///
+/// @param[in] pState  Blend state being set.
+///
+/// @return  True if the bind should be issued, false if the state is already set.
+///
+/// @see SetRasterizerState(), SetDepthStencilState(), SetSamplerStates()
+bool RenderStateFilter::SetBlendState( RBlendState* pState )
+{
+    return SetSingle( BIND_BLEND_STATE, m_spBlendState, pState );
+}
+
+/// Filter a depth-stencil state bind.
+///
+/// @param[in] pState                 Depth-stencil state being set.
+/// @param[in] stencilReferenceValue  Stencil reference value being set.
+///
+/// @return  True if the bind should be issued, false if both the state and the stencil reference value are already
+///          set.
+///
+/// @see SetRasterizerState(), SetBlendState(), SetSamplerStates()
+bool RenderStateFilter::SetDepthStencilState( RDepthStencilState* pState, uint8_t stencilReferenceValue )
+{
+    if( m_stencilReferenceValue != stencilReferenceValue )
+    {
+        m_knownBindFlags &= ~( 1U << BIND_DEPTH_STENCIL_STATE );
+        m_stencilReferenceValue = stencilReferenceValue;
+    }
+
+    return SetSingle( BIND_DEPTH_STENCIL_STATE, m_spDepthStencilState, pState );
+}
+
+/// Filter a sampler state bind for a range of sampler slots.
+///
+/// The sampler range is narrowed to the smallest range containing all slots that change.  Slots outside the range
+/// tracked by this filter are never filtered.
+///
+/// @param[in,out] rStartIndex    Index of the first sampler slot being set.
+/// @param[in,out] rSamplerCount  Number of sampler slots being set.
+/// @param[in,out] rppStates      Array of sampler states being set.
+///
+/// @return  True if the (narrowed) bind should be issued, false if all the given states are already set.
+///
+/// @see SetRasterizerState(), SetBlendState(), SetDepthStencilState()
+bool RenderStateFilter::SetSamplerStates(
+    size_t& rStartIndex,
+    size_t& rSamplerCount,
+    RSamplerState* const*& rppStates )
+{
+    size_t startIndex = rStartIndex;
+    size_t samplerCount = rSamplerCount;
+    RSamplerState* const* ppStates = rppStates;
+    HELIUM_ASSERT( ppStates || samplerCount == 0 );
+
+    bool bOutOfRange = ( startIndex > SAMPLER_SLOT_COUNT || samplerCount > SAMPLER_SLOT_COUNT - startIndex );
+
+    size_t firstIndex = Invalid< size_t >();
+    size_t lastIndex = 0;
+    for( size_t samplerIndex = 0; samplerIndex < samplerCount; ++samplerIndex )
+    {
+        size_t slotIndex = startIndex + samplerIndex;
+        if( slotIndex >= SAMPLER_SLOT_COUNT )
+        {
+            break;
+        }
+
+        if( SetSlot( m_knownSamplerStateFlags, slotIndex, m_samplerStates[ slotIndex ], ppStates[ samplerIndex ] ) )
+        {
+            if( IsInvalid( firstIndex ) )
+            {
+                firstIndex = samplerIndex;
+            }
+
+            lastIndex = samplerIndex;
+        }
+    }
+
+    if( bOutOfRange )
+    {
+        CountBinds( BIND_SAMPLER_STATE, samplerCount, 0 );
+
+        return true;
+    }
+
+    if( IsInvalid( firstIndex ) )
+    {
+        CountBinds( BIND_SAMPLER_STATE, 0, samplerCount );
+
+        return false;
+    }
+
+    size_t issuedCount = lastIndex + 1 - firstIndex;
+    CountBinds( BIND_SAMPLER_STATE, issuedCount, samplerCount - issuedCount );
+
+    rStartIndex = startIndex + firstIndex;
+    rSamplerCount = issuedCount;
+    rppStates = ppStates + firstIndex;
+
+    return true;
+}
+
+/// Filter an index buffer bind.
+///
+/// @param[in] pBuffer  Index buffer being set.
+///
+/// @return  True if the bind should be issued, false if the buffer is already set.
+///
+/// @see SetVertexBuffers(), SetVertexInputLayout()
+bool RenderStateFilter::SetIndexBuffer( RIndexBuffer* pBuffer )
+{
+    return SetSingle( BIND_INDEX_BUFFER, m_spIndexBuffer, pBuffer );
+}
+
+/// Filter a vertex buffer bind for a range of vertex streams.
+///
+/// A vertex stream only matches if its buffer, stride, and offset are all unchanged.  The stream range is narrowed to
+/// the smallest range containing all streams that change.  Streams outside the range tracked by this filter are never
+/// filtered.
+///
+/// @param[in,out] rStartIndex   Index of the first vertex stream being set.
+/// @param[in,out] rBufferCount  Number of vertex streams being set.
+/// @param[in,out] rppBuffers    Array of vertex buffers being set.
+/// @param[in,out] rpStrides     Array of vertex strides being set.
+/// @param[in,out] rpOffsets     Array of vertex buffer offsets being set.
+///
+/// @return  True if the (narrowed) bind should be issued, false if all the given streams are already set.
+///
+/// @see SetIndexBuffer(), SetVertexInputLayout()
+bool RenderStateFilter::SetVertexBuffers(
+    size_t& rStartIndex,
+    size_t& rBufferCount,
+    RVertexBuffer* const*& rppBuffers,
+    uint32_t*& rpStrides,
+    uint32_t*& rpOffsets )
+{
+    size_t startIndex = rStartIndex;
+    size_t bufferCount = rBufferCount;
+    RVertexBuffer* const* ppBuffers = rppBuffers;
+    uint32_t* pStrides = rpStrides;
+    uint32_t* pOffsets = rpOffsets;
+    HELIUM_ASSERT( ppBuffers || bufferCount == 0 );
+    HELIUM_ASSERT( pStrides || bufferCount == 0 );
+    HELIUM_ASSERT( pOffsets || bufferCount == 0 );
+
+    bool bOutOfRange = ( startIndex > VERTEX_STREAM_SLOT_COUNT || bufferCount > VERTEX_STREAM_SLOT_COUNT - startIndex );
+
+    size_t firstIndex = Invalid< size_t >();
+    size_t lastIndex = 0;
+    for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+    {
+        size_t streamIndex = startIndex + bufferIndex;
+        if( streamIndex >= VERTEX_STREAM_SLOT_COUNT )
+        {
+            break;
+        }
+
+        VertexStream& rStream = m_vertexStreams[ streamIndex ];
+        uint32_t streamFlag = ( 1U << streamIndex );
+
+        RVertexBuffer* pBuffer = ppBuffers[ bufferIndex ];
+        uint32_t stride = pStrides[ bufferIndex ];
+        uint32_t offset = pOffsets[ bufferIndex ];
+
+        RVertexBuffer* pCurrentBuffer = rStream.spBuffer;
+        if( ( m_knownVertexStreamFlags & streamFlag ) &&
+            pCurrentBuffer == pBuffer &&
+            rStream.stride == stride &&
+            rStream.offset == offset )
+        {
+            continue;
+        }
+
+        m_knownVertexStreamFlags |= streamFlag;
+        rStream.spBuffer = pBuffer;
+        rStream.stride = stride;
+        rStream.offset = offset;
+
+        if( IsInvalid( firstIndex ) )
+        {
+            firstIndex = bufferIndex;
+        }
+
+        lastIndex = bufferIndex;
+    }
+
+    if( bOutOfRange )
+    {
+        CountBinds( BIND_VERTEX_BUFFER, bufferCount, 0 );
+
+        return true;
+    }
+
+    if( IsInvalid( firstIndex ) )
+    {
+        CountBinds( BIND_VERTEX_BUFFER, 0, bufferCount );
+
+        return false;
+    }
+
+    size_t issuedCount = lastIndex + 1 - firstIndex;
+    CountBinds( BIND_VERTEX_BUFFER, issuedCount, bufferCount - issuedCount );
+
+    rStartIndex = startIndex + firstIndex;
+    rBufferCount = issuedCount;
+    rppBuffers = ppBuffers + firstIndex;
+    rpStrides = pStrides + firstIndex;
+    rpOffsets = pOffsets + firstIndex;
+
+    return true;
+}
+
+/// Filter a vertex input layout bind.
+///
+/// @param[in] pLayout  Vertex input layout being set.
+///
+/// @return  True if the bind should be issued, false if the layout is already set.
+///
+/// @see SetIndexBuffer(), SetVertexBuffers()
+bool RenderStateFilter::SetVertexInputLayout( RVertexInputLayout* pLayout )
+{
+    return SetSingle( BIND_VERTEX_INPUT_LAYOUT, m_spVertexInputLayout, pLayout );
+}
+
+/// Filter a vertex shader bind.
+///
+/// @param[in] pShader  Vertex shader being set.
+///
+/// @return  True if the bind should be issued, false if the shader is already set.
+///
+/// @see SetPixelShader()
+bool RenderStateFilter::SetVertexShader( RVertexShader* pShader )
+{
+    return SetSingle( BIND_VERTEX_SHADER, m_spVertexShader, pShader );
+}
+
+/// Filter a pixel shader bind.
+///
+/// @param[in] pShader  Pixel shader being set.
+///
+/// @return  True if the bind should be issued, false if the shader is already set.
+///
+/// @see SetVertexShader()
+bool RenderStateFilter::SetPixelShader( RPixelShader* pShader )
+{
+    return SetSingle( BIND_PIXEL_SHADER, m_spPixelShader, pShader );
+}
+
+/// Filter a texture bind.
+///
+/// @param[in] samplerIndex  Index of the sampler slot being set.
+/// @param[in] pTexture      Texture being set.
+///
+/// @return  True if the bind should be issued, false if the texture is already set.  Binds to sampler slots outside
+///          the range tracked by this filter are never filtered.
+bool RenderStateFilter::SetTexture( size_t samplerIndex, RTexture* pTexture )
+{
+    if( samplerIndex >= SAMPLER_SLOT_COUNT )
+    {
+        CountBinds( BIND_TEXTURE, 1, 0 );
+
+        return true;
+    }
+
+    if( !SetSlot( m_knownTextureFlags, samplerIndex, m_textures[ samplerIndex ], pTexture ) )
+    {
+        CountBinds( BIND_TEXTURE, 0, 1 );
+
+        return false;
+    }
+
+    CountBinds( BIND_TEXTURE, 1, 0 );
+
+    return true;
+}
+
+/// Forget all tracked state, releasing any references held to state objects and resources.
+///
+/// This should be called whenever the renderer state may have changed without going through this filter (such as
+/// when unbinding all resources or after a device reset).  The next bind to each slot will always be issued.
+void RenderStateFilter::Reset()
+{
+    m_spRasterizerState.Release();
+    m_spBlendState.Release();
+    m_spDepthStencilState.Release();
+
+    for( size_t slotIndex = 0; slotIndex < SAMPLER_SLOT_COUNT; ++slotIndex )
+    {
+        m_samplerStates[ slotIndex ].Release();
+        m_textures[ slotIndex ].Release();
+    }
+
+    m_spIndexBuffer.Release();
+
+    for( size_t streamIndex = 0; streamIndex < VERTEX_STREAM_SLOT_COUNT; ++streamIndex )
+    {
+        m_vertexStreams[ streamIndex ].spBuffer.Release();
+    }
+
+    m_spVertexInputLayout.Release();
+
+    m_spVertexShader.Release();
+    m_spPixelShader.Release();
+
+    m_knownBindFlags = 0;
+    m_knownSamplerStateFlags = 0;
+    m_knownVertexStreamFlags = 0;
+    m_knownTextureFlags = 0;
+}
+
+/// Get the total number of binds issued to the renderer since construction or the last call to ResetStats().
+///
+/// @return  Total number of binds issued.
+///
+/// @see GetFilteredCount(), GetStats(), ResetStats()
+uint32_t RenderStateFilter::GetIssuedCount() const
+{
+    uint32_t count = 0;
+    for( size_t bindIndex = 0; bindIndex < BIND_MAX; ++bindIndex )
+    {
+        count += m_stats.issuedCounts[ bindIndex ];
+    }
+
+    return count;
+}
+
+/// Get the total number of redundant binds filtered out since construction or the last call to ResetStats().
+///
+/// @return  Total number of binds filtered.
+///
+/// @see GetIssuedCount(), GetStats(), ResetStats()
+uint32_t RenderStateFilter::GetFilteredCount() const
+{
+    uint32_t count = 0;
+    for( size_t bindIndex = 0; bindIndex < BIND_MAX; ++bindIndex )
+    {
+        count += m_stats.filteredCounts[ bindIndex ];
+    }
+
+    return count;
+}
+
+/// Reset all bind counters to zero.
+///
+/// @see GetStats(), GetIssuedCount(), GetFilteredCount()
+void RenderStateFilter::ResetStats()
+{
+    MemoryZero( &m_stats, sizeof( m_stats ) );
+}
+
+/// Update the bind counters for a bind type, and report the binds to the per-frame render statistics.
+///
+/// @param[in] bind           Bind type.
+/// @param[in] issuedCount    Number of binds issued.
+/// @param[in] filteredCount  Number of binds filtered out.
+///
+/// @see RenderStatistics::RecordStateChanges()
+void RenderStateFilter::CountBinds( EBind bind, size_t issuedCount, size_t filteredCount )
+{
+    m_stats.issuedCounts[ bind ] += static_cast< uint32_t >( issuedCount );
+    m_stats.filteredCounts[ bind ] += static_cast< uint32_t >( filteredCount );
+
+    RenderStatistics::RecordStateChanges(
+        static_cast< uint32_t >( issuedCount ),
+        static_cast< uint32_t >( filteredCount ) );
+}
+
+/// Filter a bind to a single-slot bind type, updating the bind counters.
+///
+/// @param[in]     bind        Bind type.
+/// @param[in,out] rspCurrent  Currently bound object.
+/// @param[in]     pObject     Object being bound.
+///
+/// @return  True if the bind should be issued, false if it is redundant.
+template< typename T >
+bool RenderStateFilter::SetSingle( EBind bind, SmartPtr< T >& rspCurrent, T* pObject )
+{
+    if( !SetSlot( m_knownBindFlags, static_cast< size_t >( bind ), rspCurrent, pObject ) )
+    {
+        CountBinds( bind, 0, 1 );
+
+        return false;
+    }
+
+    CountBinds( bind, 1, 0 );
+
+    return true;
+}
+
+/// Filter a bind to a given slot, updating the tracked state.
+///
+/// @param[in,out] rKnownFlags  Bit flags specifying which slots have a known current value.
+/// @param[in]     slotIndex    Index of the slot being set.
+/// @param[in,out] rspCurrent   Currently bound object.
+/// @param[in]     pObject      Object being bound.
+///
+/// @return  True if the bind should be issued, false if it is redundant.
+template< typename T >
+bool RenderStateFilter::SetSlot( uint32_t& rKnownFlags, size_t slotIndex, SmartPtr< T >& rspCurrent, T* pObject )
+{
+    uint32_t slotFlag = ( 1U << slotIndex );
+
+    T* pCurrentObject = rspCurrent;
+    if( ( rKnownFlags & slotFlag ) && pCurrentObject == pObject )
+    {
+        return false;
+    }
+
+    rKnownFlags |= slotFlag;
+    rspCurrent = pObject;
+
+    return true;
+}
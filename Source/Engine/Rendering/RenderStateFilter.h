@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Rendering/RRenderResource.h"
+
+namespace Helium
+{
+    HELIUM_DECLARE_RPTR( RRasterizerState );
+    HELIUM_DECLARE_RPTR( RBlendState );
+    HELIUM_DECLARE_RPTR( RDepthStencilState );
+    HELIUM_DECLARE_RPTR( RSamplerState );
+
+    HELIUM_DECLARE_RPTR( RIndexBuffer );
+    HELIUM_DECLARE_RPTR( RVertexBuffer );
+    HELIUM_DECLARE_RPTR( RVertexInputLayout );
+
+    HELIUM_DECLARE_RPTR( RVertexShader );
+    HELIUM_DECLARE_RPTR( RPixelShader );
+
+    HELIUM_DECLARE_RPTR( RTexture );
+
+    /// Renderer-independent filter for redundant state and resource binds.
+    ///
+    /// Render command proxies pass each bind through this filter before issuing it to the underlying graphics API, and
+    /// skip the bind entirely if the filter reports that the given object is already bound.  Objects are compared by
+    /// identity, and references to all tracked objects are held until Reset() is called, so an object that has been
+    /// released can never be mistaken for a new object allocated at the same address.  Until a slot has been set since
+    /// construction or the last Reset(), its current value is treated as unknown and the next bind to it is always
+    /// issued.
+    ///
+    /// Constant buffers are not tracked, as binding the same constant buffer again after updating its contents must
+    /// still reach the renderer.
+    class HELIUM_RENDERING_API RenderStateFilter : NonCopyable
+    {
+    public:
+        /// Number of texture and sampler state slots tracked.
+        static const size_t SAMPLER_SLOT_COUNT = 16;
+        /// Number of vertex stream slots tracked.
+        static const size_t VERTEX_STREAM_SLOT_COUNT = 16;
+
+        /// Bind types.
+        enum EBind
+        {
+            BIND_FIRST   =  0,
+            BIND_INVALID = -1,
+
+            /// Rasterizer state.
+            BIND_RASTERIZER_STATE,
+            /// Blend state.
+            BIND_BLEND_STATE,
+            /// Depth-stencil state (and stencil reference value).
+            BIND_DEPTH_STENCIL_STATE,
+            /// Sampler state (counted per sampler slot).
+            BIND_SAMPLER_STATE,
+            /// Index buffer.
+            BIND_INDEX_BUFFER,
+            /// Vertex buffer (counted per vertex stream).
+            BIND_VERTEX_BUFFER,
+            /// Vertex input layout.
+            BIND_VERTEX_INPUT_LAYOUT,
+            /// Vertex shader.
+            BIND_VERTEX_SHADER,
+            /// Pixel shader.
+            BIND_PIXEL_SHADER,
+            /// Texture.
+            BIND_TEXTURE,
+
+            BIND_MAX,
+            BIND_LAST = BIND_MAX - 1
+        };
+
+        /// Bind counters.
+        struct Stats
+        {
+            /// Number of binds passed on to the renderer, by bind type.
+            uint32_t issuedCounts[ BIND_MAX ];
+            /// Number of redundant binds filtered out, by bind type.
+            uint32_t filteredCounts[ BIND_MAX ];
+        };
+
+        /// @name Construction/Destruction
+        //@{
+        RenderStateFilter();
+        ~RenderStateFilter();
+        //@}
+
+        /// @name State Filtering
+        //@{
+        bool SetRasterizerState( RRasterizerState* pState );
+        bool SetBlendState( RBlendState* pState );
+        bool SetDepthStencilState( RDepthStencilState* pState, uint8_t stencilReferenceValue );
+        bool SetSamplerStates( size_t& rStartIndex, size_t& rSamplerCount, RSamplerState* const*& rppStates );
+
+        bool SetIndexBuffer( RIndexBuffer* pBuffer );
+        bool SetVertexBuffers(
+            size_t& rStartIndex, size_t& rBufferCount, RVertexBuffer* const*& rppBuffers, uint32_t*& rpStrides,
+            uint32_t*& rpOffsets );
+        bool SetVertexInputLayout( RVertexInputLayout* pLayout );
+
+        bool SetVertexShader( RVertexShader* pShader );
+        bool SetPixelShader( RPixelShader* pShader );
+
+        bool SetTexture( size_t samplerIndex, RTexture* pTexture );
+
+        void Reset();
+        //@}
+
+        /// @name Statistics
+        //@{
+        inline const Stats& GetStats() const;
+        uint32_t GetIssuedCount() const;
+        uint32_t GetFilteredCount() const;
+        void ResetStats();
+        //@}
+
+    private:
+        /// Vertex stream binding.
+        struct VertexStream
+        {
+            /// Bound vertex buffer.
+            RVertexBufferPtr spBuffer;
+            /// Vertex stride.
+            uint32_t stride;
+            /// Byte offset of the first vertex.
+            uint32_t offset;
+        };
+
+        /// Current rasterizer state.
+        RRasterizerStatePtr m_spRasterizerState;
+        /// Current blend state.
+        RBlendStatePtr m_spBlendState;
+        /// Current depth-stencil state.
+        RDepthStencilStatePtr m_spDepthStencilState;
+        /// Current sampler states.
+        RSamplerStatePtr m_samplerStates[ SAMPLER_SLOT_COUNT ];
+
+        /// Current index buffer.
+        RIndexBufferPtr m_spIndexBuffer;
+        /// Current vertex streams.
+        VertexStream m_vertexStreams[ VERTEX_STREAM_SLOT_COUNT ];
+        /// Current vertex input layout.
+        RVertexInputLayoutPtr m_spVertexInputLayout;
+
+        /// Current vertex shader.
+        RVertexShaderPtr m_spVertexShader;
+        /// Current pixel shader.
+        RPixelShaderPtr m_spPixelShader;
+
+        /// Current textures.
+        RTexturePtr m_textures[ SAMPLER_SLOT_COUNT ];
+
+        /// Current stencil reference value.
+        uint8_t m_stencilReferenceValue;
+
+        /// Bit flags specifying which single-slot bind types (indexed by EBind) have a known current value.
+        uint32_t m_knownBindFlags;
+        /// Bit flags specifying which sampler state slots have a known current value.
+        uint32_t m_knownSamplerStateFlags;
+        /// Bit flags specifying which vertex streams have a known current value.
+        uint32_t m_knownVertexStreamFlags;
+        /// Bit flags specifying which texture slots have a known current value.
+        uint32_t m_knownTextureFlags;
+
+        /// Bind counters.
+        Stats m_stats;
+
+        /// @name Private Utility Functions
+        //@{
+        void CountBinds( EBind bind, size_t issuedCount, size_t filteredCount );
+        template< typename T > bool SetSingle( EBind bind, SmartPtr< T >& rspCurrent, T* pObject );
+        template< typename T > bool SetSlot(
+            uint32_t& rKnownFlags, size_t slotIndex, SmartPtr< T >& rspCurrent, T* pObject );
+        //@}
+    };
+}
+
+#include "Rendering/RenderStateFilter.inl"
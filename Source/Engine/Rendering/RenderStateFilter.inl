@@ -0,0 +1,12 @@
+namespace Helium
+{
+    /// Get the bind counters accumulated since construction or the last call to ResetStats().
+    ///
+    /// @return  Bind counters.
+    ///
+    /// @see GetIssuedCount(), GetFilteredCount(), ResetStats()
+    const RenderStateFilter::Stats& RenderStateFilter::GetStats() const
+    {
+        return m_stats;
+    }
+}
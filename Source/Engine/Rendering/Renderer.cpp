@@ -1,6 +1,9 @@
 #include "Precompile.h"
 #include "Rendering/Renderer.h"
 
+#include "Rendering/RVertexInputLayout.h"
+#include "Rendering/RVertexShader.h"
+
 using namespace Helium;
 
 Renderer* Renderer::sm_pInstance = NULL;
@@ -195,6 +198,8 @@ Renderer* Renderer::sm_pInstance = NULL;
 /// @param[in] elementCount  Number of vertex elements.
 ///
 /// @return  Vertex description interface.
+///
+/// @see GetVertexDescription()
 
 /// @fn RVertexInputLayout* Renderer::CreateVertexInputLayout( RVertexDescription* pDescription, RVertexShader* pShader )
 /// Create an input layout object for defining the mapping between a vertex type and the input for a vertex shader.
@@ -203,6 +208,8 @@ Renderer* Renderer::sm_pInstance = NULL;
 /// @param[in] pShader       Vertex shader for which to create the input layout.
 ///
 /// @return  Vertex input layout interface.
+///
+/// @see GetVertexInputLayout()
 
 /// @fn RTexture2d* Renderer::CreateTexture2d( uint32_t width, uint32_t height, uint32_t mipCount, ERendererPixelFormat format, ERendererBufferUsage usage, const RTexture2d::CreateData* pData )
 /// Create a 2D texture.
@@ -218,6 +225,18 @@ Renderer* Renderer::sm_pInstance = NULL;
 ///
 /// @return  Pointer to the texture resource if created successfully, null if not.
 
+/// @fn RGpuCullingBatch* Renderer::CreateGpuCullingBatch( uint32_t objectCapacity, uint32_t drawCapacity )
+/// Create a batch of object bounds and indexed draw records for compute-based culling and indirect drawing.
+///
+/// This is only supported if RENDERER_FEATURE_FLAG_GPU_CULLING is set in the renderer's feature flags.
+///
+/// @param[in] objectCapacity  Maximum number of objects whose bounds can be stored in the batch.
+/// @param[in] drawCapacity    Maximum number of draw records that can be stored in the batch.
+///
+/// @return  Pointer to the culling batch if created successfully, null if not (or if not supported).
+///
+/// @see RRenderCommandProxy::CullGpuDraws(), RRenderCommandProxy::DrawGpuCulled()
+
 /// @fn RFence* Renderer::CreateFence()
 /// Create a GPU command buffer fence object.
 ///
@@ -256,6 +275,40 @@ Renderer* Renderer::sm_pInstance = NULL;
 ///
 /// @see SyncFence(), CreateFence(), RRenderCommandProxy::SetFence()
 
+/// @fn RTimerQuery* Renderer::CreateTimerQuery()
+/// Create a GPU timestamp query object.
+///
+/// A timer query records the GPU clock once all commands issued before it have been completed.  A command to issue
+/// a timer query can be inserted into the command buffer using RRenderCommandProxy::IssueTimerQuery(), and the
+/// result can later be read using TryGetTimerQueryTimestamp().  Results usually take a frame or more to become
+/// available, so callers should keep several sets of queries in flight rather than waiting on them.  Unlike fences,
+/// timer queries can be issued again once their result has been read.
+///
+/// This is only supported if the renderer has the RENDERER_FEATURE_FLAG_TIMER_QUERY feature flag set.
+///
+/// @return  Pointer to the timer query object, or null if timer queries are not supported.
+///
+/// @see RRenderCommandProxy::IssueTimerQuery(), TryGetTimerQueryTimestamp(), GetTimerQueryFrequency()
+
+/// @fn bool Renderer::TryGetTimerQueryTimestamp( RTimerQuery* pQuery, uint64_t& rTimestamp )
+/// Read the result of a timer query without blocking.
+///
+/// More information about timer queries and their use can be found in the description for CreateTimerQuery().
+///
+/// @param[in]  pQuery      Timer query to read.
+/// @param[out] rTimestamp  GPU timestamp recorded by the query, in ticks of GetTimerQueryFrequency(), if available.
+///
+/// @return  True if the result was available, false if the GPU has not reached the query yet (or the query was lost).
+///
+/// @see CreateTimerQuery(), GetTimerQueryFrequency(), RRenderCommandProxy::IssueTimerQuery()
+
+/// @fn uint64_t Renderer::GetTimerQueryFrequency()
+/// Get the number of timer query ticks per second.
+///
+/// @return  Timer query tick frequency, or zero if timer queries are not supported.
+///
+/// @see CreateTimerQuery(), TryGetTimerQueryTimestamp()
+
 /// @fn RRenderCommandProxy* Renderer::GetImmediateCommandProxy()
 /// Get a reference to the render command proxy interface for immediate issuing of render commands.
 ///
@@ -283,6 +336,17 @@ Renderer* Renderer::sm_pInstance = NULL;
 /// It should only be reserved for cases where the normal application flow has already been interrupted (i.e. making
 /// sure resources that need to be updated during a window resize are no longer being used by the GPU).
 
+/// Make the resource uploads deferred by the renderer for the current frame.
+///
+/// Renderers that cannot fill resources from arbitrary threads without stalling can defer copying mapped data to
+/// their resources, making the copies within a per-frame budget when this is called.  This should be called once per
+/// frame from the thread that owns the renderer.  The default implementation does nothing.
+///
+/// @see RRenderResource::IsUploadPending()
+void Renderer::ProcessResourceUploads()
+{
+}
+
 /// Get the global renderer instance.
 ///
 /// A renderer instance must be initialized first through the interface of one of the Renderer subclasses.
@@ -302,4 +366,157 @@ Renderer::Renderer()
 /// Destructor.
 Renderer::~Renderer()
 {
+	ClearVertexInputCache();
+}
+
+/// Get a vertex description for a set of vertex elements, sharing the description with any previous request for the
+/// same elements.
+///
+/// This should be preferred over calling CreateVertexDescription() directly, as it avoids creating duplicate driver
+/// objects for identical vertex formats.  It can safely be called from multiple threads at once.
+///
+/// @param[in] pElements     Array of vertex elements.
+/// @param[in] elementCount  Number of vertex elements.
+///
+/// @return  Vertex description, or null if description creation failed.
+///
+/// @see GetVertexInputLayout(), ClearVertexInputCache()
+RVertexDescription* Renderer::GetVertexDescription(
+	const RVertexDescription::Element* pElements,
+	size_t elementCount )
+{
+	HELIUM_ASSERT( pElements || elementCount == 0 );
+
+	uint32_t hash = 2166136261u;
+	for( size_t elementIndex = 0; elementIndex < elementCount; ++elementIndex )
+	{
+		const RVertexDescription::Element& rElement = pElements[ elementIndex ];
+		hash = ( hash ^ static_cast< uint32_t >( rElement.type ) ) * 16777619u;
+		hash = ( hash ^ static_cast< uint32_t >( rElement.semantic ) ) * 16777619u;
+		hash = ( hash ^ rElement.semanticIndex ) * 16777619u;
+		hash = ( hash ^ rElement.bufferIndex ) * 16777619u;
+	}
+
+	MutexScopeLock scopeLock( m_vertexInputCacheLock );
+
+	size_t entryCount = m_vertexDescriptionCache.GetSize();
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		const VertexDescriptionEntry& rEntry = m_vertexDescriptionCache[ entryIndex ];
+		if( rEntry.hash != hash || rEntry.elements.GetSize() != elementCount )
+		{
+			continue;
+		}
+
+		size_t elementIndex;
+		for( elementIndex = 0; elementIndex < elementCount; ++elementIndex )
+		{
+			const RVertexDescription::Element& rElement = pElements[ elementIndex ];
+			const RVertexDescription::Element& rEntryElement = rEntry.elements[ elementIndex ];
+			if( rElement.type != rEntryElement.type ||
+				rElement.semantic != rEntryElement.semantic ||
+				rElement.semanticIndex != rEntryElement.semanticIndex ||
+				rElement.bufferIndex != rEntryElement.bufferIndex )
+			{
+				break;
+			}
+		}
+
+		if( elementIndex >= elementCount )
+		{
+			return rEntry.spDescription;
+		}
+	}
+
+	RVertexDescription* pDescription = CreateVertexDescription( pElements, elementCount );
+	if( !pDescription )
+	{
+		return NULL;
+	}
+
+	VertexDescriptionEntry* pEntry = m_vertexDescriptionCache.New();
+	HELIUM_ASSERT( pEntry );
+	pEntry->elements.AddArray( pElements, elementCount );
+	pEntry->hash = hash;
+	pEntry->spDescription = pDescription;
+
+	return pDescription;
+}
+
+/// Get the input layout for using a vertex description with a vertex shader, sharing the layout with any other
+/// shader that has the same vertex input signature.
+///
+/// This should be preferred over calling CreateVertexInputLayout() directly.  It can safely be called from multiple
+/// threads at once.
+///
+/// @param[in] pDescription  Vertex description.
+/// @param[in] pShader       Vertex shader.
+///
+/// @return  Input layout, or null if input layout creation failed.
+///
+/// @see GetVertexInputSignature(), GetVertexDescription(), ClearVertexInputCache()
+RVertexInputLayout* Renderer::GetVertexInputLayout( RVertexDescription* pDescription, RVertexShader* pShader )
+{
+	if( !pDescription )
+	{
+		return NULL;
+	}
+
+	uint32_t signature = GetVertexInputSignature( pShader );
+
+	MutexScopeLock scopeLock( m_vertexInputCacheLock );
+
+	size_t entryCount = m_vertexInputLayoutCache.GetSize();
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		const VertexInputLayoutEntry& rEntry = m_vertexInputLayoutCache[ entryIndex ];
+		if( rEntry.spDescription.Get() == pDescription && rEntry.signature == signature )
+		{
+			return rEntry.spInputLayout;
+		}
+	}
+
+	RVertexInputLayout* pInputLayout = CreateVertexInputLayout( pDescription, pShader );
+	if( !pInputLayout )
+	{
+		return NULL;
+	}
+
+	VertexInputLayoutEntry* pEntry = m_vertexInputLayoutCache.New();
+	HELIUM_ASSERT( pEntry );
+	pEntry->spDescription = pDescription;
+	pEntry->signature = signature;
+	pEntry->spInputLayout = pInputLayout;
+
+	return pInputLayout;
+}
+
+/// Get the value identifying the vertex input signature of a shader for sharing input layouts.
+///
+/// Shaders with the same signature share the input layouts returned by GetVertexInputLayout().  Neither the
+/// Direct3D 9 vertex declarations nor OpenGL vertex attribute setups depend on the shader, so by default all shaders
+/// share the same signature.  Renderers whose input layouts are validated against the shader (such as Direct3D 10 and
+/// later) should override this to return a hash of the shader input signature.
+///
+/// @param[in] pShader  Vertex shader.
+///
+/// @return  Vertex input signature value.
+///
+/// @see GetVertexInputLayout()
+uint32_t Renderer::GetVertexInputSignature( RVertexShader* /*pShader*/ )
+{
+	return 0;
+}
+
+/// Release all vertex descriptions and input layouts cached by GetVertexDescription() and GetVertexInputLayout().
+///
+/// Renderer implementations should call this before releasing their device.
+///
+/// @see GetVertexDescription(), GetVertexInputLayout()
+void Renderer::ClearVertexInputCache()
+{
+	MutexScopeLock scopeLock( m_vertexInputCacheLock );
+
+	m_vertexInputLayoutCache.Clear();
+	m_vertexDescriptionCache.Clear();
 }
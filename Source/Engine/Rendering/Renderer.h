@@ -7,6 +7,9 @@
 #include "Rendering/RTexture2d.h"
 #include "Rendering/RVertexDescription.h"
 
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+
 namespace Helium
 {
 	class RRenderCommandProxy;
@@ -21,9 +24,12 @@ namespace Helium
 	class RIndexBuffer;
 	class RConstantBuffer;
 
-	class RVertexInputLayout;
+	HELIUM_DECLARE_RPTR( RVertexDescription );
+	HELIUM_DECLARE_RPTR( RVertexInputLayout );
 
 	class RFence;
+	class RTimerQuery;
+	class RGpuCullingBatch;
 
 	/// Main renderer base class.
 	class HELIUM_RENDERING_API Renderer : NonCopyable
@@ -62,8 +68,12 @@ namespace Helium
 
 			/// True to render fullscreen.
 			bool bFullscreen;
-			/// True to enable vsync.
-			bool bVsync;
+			/// Presentation mode.
+			ERendererPresentMode presentMode;
+			/// Maximum number of frames presented per second (0 for no limit).
+			uint32_t frameRateLimit;
+			/// True to allow the renderer to be used from multiple threads at once (for pipelined rendering).
+			bool bMultithreaded;
 
 			/// @name Construction/Destruction
 			//@{
@@ -127,6 +137,19 @@ namespace Helium
 		virtual RTexture2d* CreateTexture2d(
 			uint32_t width, uint32_t height, uint32_t mipCount, ERendererPixelFormat format, ERendererBufferUsage usage,
 			const RTexture2d::CreateData* pData = NULL ) = 0;
+
+		virtual RGpuCullingBatch* CreateGpuCullingBatch( uint32_t objectCapacity, uint32_t drawCapacity ) = 0;
+		//@}
+
+		/// @name Vertex Input Caching
+		//@{
+		RVertexDescription* GetVertexDescription(
+			const RVertexDescription::Element* pElements, size_t elementCount );
+		RVertexInputLayout* GetVertexInputLayout( RVertexDescription* pDescription, RVertexShader* pShader );
+
+		virtual uint32_t GetVertexInputSignature( RVertexShader* pShader );
+
+		void ClearVertexInputCache();
 		//@}
 
 		/// @name Deferred Query Allocation
@@ -134,6 +157,10 @@ namespace Helium
 		virtual RFence* CreateFence() = 0;
 		virtual void SyncFence( RFence* pFence ) = 0;
 		virtual bool TrySyncFence( RFence* pFence ) = 0;
+
+		virtual RTimerQuery* CreateTimerQuery() = 0;
+		virtual bool TryGetTimerQueryTimestamp( RTimerQuery* pQuery, uint64_t& rTimestamp ) = 0;
+		virtual uint64_t GetTimerQueryFrequency() = 0;
 		//@}
 
 		/// @name Command Interfaces
@@ -144,6 +171,11 @@ namespace Helium
 		virtual void Flush() = 0;
 		//@}
 
+		/// @name Resource Uploading
+		//@{
+		virtual void ProcessResourceUploads();
+		//@}
+
 		/// @name Static Access
 		//@{
 		static Renderer* GetInstance();
@@ -159,6 +191,35 @@ namespace Helium
 		/// Renderer feature flags.
 		uint32_t m_featureFlags;
 
+		/// Shared vertex description for a set of vertex elements.
+		struct VertexDescriptionEntry
+		{
+			/// Vertex elements.
+			DynamicArray< RVertexDescription::Element > elements;
+			/// Hash of the vertex elements.
+			uint32_t hash;
+			/// Vertex description.
+			RVertexDescriptionPtr spDescription;
+		};
+
+		/// Shared input layout for a vertex description and vertex shader input signature.
+		struct VertexInputLayoutEntry
+		{
+			/// Vertex description.
+			RVertexDescriptionPtr spDescription;
+			/// Vertex shader input signature (see GetVertexInputSignature()).
+			uint32_t signature;
+			/// Input layout.
+			RVertexInputLayoutPtr spInputLayout;
+		};
+
+		/// Vertex descriptions created through GetVertexDescription().
+		DynamicArray< VertexDescriptionEntry > m_vertexDescriptionCache;
+		/// Input layouts created through GetVertexInputLayout().
+		DynamicArray< VertexInputLayoutEntry > m_vertexInputLayoutCache;
+		/// Vertex input cache synchronization.
+		Mutex m_vertexInputCacheLock;
+
 		/// Singleton instance.
 		static Renderer* sm_pInstance;
 	};
@@ -46,7 +46,9 @@ namespace Helium
         , displayHeight( 0 )
         , multisampleCount( 0 )
         , bFullscreen( false )
-        , bVsync( false )
+        , presentMode( RENDERER_PRESENT_MODE_IMMEDIATE )
+        , frameRateLimit( 0 )
+        , bMultithreaded( false )
     {
     }
 }
@@ -6,12 +6,44 @@ namespace Helium
 {
     /// Maximum simultaneous render targets supported by the engine (note that the render device may support less).
     static const size_t SIMULTANEOUS_RENDER_TARGET_COUNT_MAX = 16;
+    /// Alignment (in bytes) required of offsets when binding a range of a constant buffer (the strictest alignment
+    /// required by the graphics APIs supported, 16 shader constants).
+    static const size_t CONSTANT_BUFFER_OFFSET_ALIGNMENT = 256;
 
     /// Renderer feature support flags.
     enum ERendererFeatureFlag
     {
         /// Depth texture support (for shadow mapping and depth-based post effects).
-        RENDERER_FEATURE_FLAG_DEPTH_TEXTURE = ( 1 << 0 )
+        RENDERER_FEATURE_FLAG_DEPTH_TEXTURE = ( 1 << 0 ),
+        /// GPU timestamp query support (see Renderer::CreateTimerQuery()).
+        RENDERER_FEATURE_FLAG_TIMER_QUERY   = ( 1 << 1 ),
+        /// Rendering commands can be issued from a dedicated render thread while resources are created and mapped on
+        /// other threads (see Renderer::ContextInitParameters::bMultithreaded).
+        RENDERER_FEATURE_FLAG_MULTITHREADED = ( 1 << 2 ),
+        /// Compute-based culling of indirect draws (see Renderer::CreateGpuCullingBatch()).
+        RENDERER_FEATURE_FLAG_GPU_CULLING   = ( 1 << 3 ),
+        /// BC4 and BC5 compressed texture support.
+        RENDERER_FEATURE_FLAG_BC4_BC5       = ( 1 << 4 ),
+        /// BC7 compressed texture support.
+        RENDERER_FEATURE_FLAG_BC7           = ( 1 << 5 )
+    };
+
+    /// Main context presentation modes.
+    enum ERendererPresentMode
+    {
+        RENDERER_PRESENT_MODE_FIRST   =  0,
+        RENDERER_PRESENT_MODE_INVALID = -1,
+
+        /// Present frames as soon as they are ready, without waiting for vertical sync (may tear).
+        RENDERER_PRESENT_MODE_IMMEDIATE,
+        /// Wait for vertical sync before presenting each frame.
+        RENDERER_PRESENT_MODE_VSYNC,
+        /// Wait for vertical sync before presenting each frame, but present late frames immediately instead of
+        /// waiting for the next vertical sync (falls back to RENDERER_PRESENT_MODE_VSYNC where not supported).
+        RENDERER_PRESENT_MODE_ADAPTIVE_VSYNC,
+
+        RENDERER_PRESENT_MODE_MAX,
+        RENDERER_PRESENT_MODE_LAST = RENDERER_PRESENT_MODE_MAX - 1
     };
 
     /// Triangle fill modes.
@@ -362,9 +394,28 @@ namespace Helium
         RENDERER_PIXEL_FORMAT_BC3,
         /// BC3 (DXT5) compressed in sRGB color space.
         RENDERER_PIXEL_FORMAT_BC3_SRGB,
+        /// BC4 (RGTC1) compressed.
+        /// - Compressed single channel (8-bit interpolation, as with the BC3 alpha channel).
+        /// - 4x4 texel compressed blocks.
+        /// - 64 bits per compressed block (4 bits per texel within each block).
+        RENDERER_PIXEL_FORMAT_BC4,
+        /// BC5 (RGTC2) compressed.
+        /// - Two independently compressed channels (red and green), used for normal maps.
+        /// - 4x4 texel compressed blocks.
+        /// - 128 bits per compressed block (8 bits per texel within each block).
+        RENDERER_PIXEL_FORMAT_BC5,
+        /// BC7 (BPTC) compressed.
+        /// - High-quality compressed RGB with optional alpha, with per-block encoding modes.
+        /// - 4x4 texel compressed blocks.
+        /// - 128 bits per compressed block (8 bits per texel within each block).
+        RENDERER_PIXEL_FORMAT_BC7,
+        /// BC7 (BPTC) compressed in sRGB color space.
+        RENDERER_PIXEL_FORMAT_BC7_SRGB,
 
         /// Uncompressed, 64-bit floating-point RGB pixel with alpha (16-bit floating-point value per channel).
         RENDERER_PIXEL_FORMAT_R16G16B16A16_FLOAT,
+        /// Uncompressed, 128-bit floating-point RGB pixel with alpha (32-bit floating-point value per channel).
+        RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT,
 
         /// Depth texture format.
         RENDERER_PIXEL_FORMAT_DEPTH,
@@ -5,7 +5,7 @@ using namespace Helium;
 
 /// Get whether a given pixel format is a compressed pixel format.
 ///
-/// @return  True if the format is compressed using BC1, BC2, or BC3, false otherwise.
+/// @return  True if the format is block-compressed (BC1 through BC7), false otherwise.
 bool RendererUtil::IsCompressedFormat( ERendererPixelFormat format )
 {
 	HELIUM_ASSERT( static_cast< size_t >( format ) < static_cast< size_t >( RENDERER_PIXEL_FORMAT_MAX ) );
@@ -21,7 +21,12 @@ bool RendererUtil::IsCompressedFormat( ERendererPixelFormat format )
 		true,   // RENDERER_PIXEL_FORMAT_BC2_SRGB
 		true,   // RENDERER_PIXEL_FORMAT_BC3
 		true,   // RENDERER_PIXEL_FORMAT_BC3_SRGB
+		true,   // RENDERER_PIXEL_FORMAT_BC4
+		true,   // RENDERER_PIXEL_FORMAT_BC5
+		true,   // RENDERER_PIXEL_FORMAT_BC7
+		true,   // RENDERER_PIXEL_FORMAT_BC7_SRGB
 		false,  // RENDERER_PIXEL_FORMAT_R16G16B16A16_FLOAT
+		false,  // RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT
 		false   // RENDERER_PIXEL_FORMAT_DEPTH
 	};
 
@@ -38,7 +43,8 @@ bool RendererUtil::IsSrgbPixelFormat( ERendererPixelFormat format )
     return ( format == RENDERER_PIXEL_FORMAT_R8G8B8A8_SRGB ||
              format == RENDERER_PIXEL_FORMAT_BC1_SRGB ||
              format == RENDERER_PIXEL_FORMAT_BC2_SRGB ||
-             format == RENDERER_PIXEL_FORMAT_BC3_SRGB );
+             format == RENDERER_PIXEL_FORMAT_BC3_SRGB ||
+             format == RENDERER_PIXEL_FORMAT_BC7_SRGB );
 }
 
 /// Compute the number of block rows for the specified pixel format to accommodate the given number of rows of
@@ -64,7 +70,12 @@ uint32_t RendererUtil::PixelToBlockRowCount( uint32_t pixelRowCount, ERendererPi
         4,  // RENDERER_PIXEL_FORMAT_BC2_SRGB
         4,  // RENDERER_PIXEL_FORMAT_BC3
         4,  // RENDERER_PIXEL_FORMAT_BC3_SRGB
+        4,  // RENDERER_PIXEL_FORMAT_BC4
+        4,  // RENDERER_PIXEL_FORMAT_BC5
+        4,  // RENDERER_PIXEL_FORMAT_BC7
+        4,  // RENDERER_PIXEL_FORMAT_BC7_SRGB
         1,  // RENDERER_PIXEL_FORMAT_R16G16B16A16_FLOAT
+        1,  // RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT
         1   // RENDERER_PIXEL_FORMAT_DEPTH
     };
 
@@ -77,6 +88,60 @@ uint32_t RendererUtil::PixelToBlockRowCount( uint32_t pixelRowCount, ERendererPi
     return blockRowCount;
 }
 
+/// Compute the number of bytes of memory used by a 2D texture.
+///
+/// @param[in] width     Width of the top mip level, in pixels.
+/// @param[in] height    Height of the top mip level, in pixels.
+/// @param[in] mipCount  Number of mip levels.
+/// @param[in] format    Pixel format.
+///
+/// @return  Size of all mip levels of the texture, in bytes.
+size_t RendererUtil::GetTexture2dMemorySize(
+    uint32_t width,
+    uint32_t height,
+    uint32_t mipCount,
+    ERendererPixelFormat format )
+{
+    HELIUM_ASSERT( static_cast< size_t >( format ) < static_cast< size_t >( RENDERER_PIXEL_FORMAT_MAX ) );
+
+    // Bytes per pixel for uncompressed formats, bytes per 4x4 block for compressed formats.
+    static const uint32_t BYTES_PER_BLOCK[] =
+    {
+        4,   // RENDERER_PIXEL_FORMAT_R8G8B8A8
+        4,   // RENDERER_PIXEL_FORMAT_R8G8B8A8_SRGB
+        1,   // RENDERER_PIXEL_FORMAT_R8
+        8,   // RENDERER_PIXEL_FORMAT_BC1
+        8,   // RENDERER_PIXEL_FORMAT_BC1_SRGB
+        16,  // RENDERER_PIXEL_FORMAT_BC2
+        16,  // RENDERER_PIXEL_FORMAT_BC2_SRGB
+        16,  // RENDERER_PIXEL_FORMAT_BC3
+        16,  // RENDERER_PIXEL_FORMAT_BC3_SRGB
+        8,   // RENDERER_PIXEL_FORMAT_BC4
+        16,  // RENDERER_PIXEL_FORMAT_BC5
+        16,  // RENDERER_PIXEL_FORMAT_BC7
+        16,  // RENDERER_PIXEL_FORMAT_BC7_SRGB
+        8,   // RENDERER_PIXEL_FORMAT_R16G16B16A16_FLOAT
+        16,  // RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT
+        4    // RENDERER_PIXEL_FORMAT_DEPTH
+    };
+
+    HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( BYTES_PER_BLOCK ) == RENDERER_PIXEL_FORMAT_MAX );
+
+    size_t size = 0;
+    for( uint32_t mipIndex = 0; mipIndex < mipCount; ++mipIndex )
+    {
+        // Blocks are square, so the block column count is computed the same way as the block row count.
+        size += static_cast< size_t >( PixelToBlockRowCount( width, format ) ) *
+            PixelToBlockRowCount( height, format ) *
+            BYTES_PER_BLOCK[ format ];
+
+        width = Max< uint32_t >( width / 2, 1 );
+        height = Max< uint32_t >( height / 2, 1 );
+    }
+
+    return size;
+}
+
 /// Computer the pixel pack alignment for a given pixel pitch.
 ///
 /// @param[in] pixelPitch    Number of bytes for a row of pixel/block data.
@@ -1,6 +1,8 @@
 #include "Precompile.h"
 #include "RenderingD3D9/D3D9ConstantBuffer.h"
 
+#include "Engine/RenderStatistics.h"
+
 using namespace Helium;
 
 /// Constructor.
@@ -26,6 +28,8 @@ D3D9ConstantBuffer::~D3D9ConstantBuffer()
 /// @copydoc RConstantBuffer::Map()
 void* D3D9ConstantBuffer::Map( ERendererBufferMapHint /*hint*/ )
 {
+    RenderStatistics::RecordUpload( RenderStatistics::COUNTER_CONSTANT_BUFFER_BYTES, GetTrackedMemorySize() );
+
     return m_pData;
 }
 
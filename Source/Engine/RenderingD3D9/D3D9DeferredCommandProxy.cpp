@@ -3,9 +3,12 @@
 
 #include "Rendering/RConstantBuffer.h"
 #include "Rendering/RFence.h"
+#include "Rendering/RGpuCullingBatch.h"
 #include "Rendering/RIndexBuffer.h"
 #include "Rendering/RPixelShader.h"
 #include "Rendering/RSurface.h"
+#include "Rendering/RTexture2d.h"
+#include "Rendering/RTimerQuery.h"
 #include "Rendering/RVertexBuffer.h"
 #include "Rendering/RVertexInputLayout.h"
 #include "Rendering/RVertexShader.h"
@@ -27,8 +30,11 @@ namespace Helium
     HELIUM_DECLARE_RPTR( RPixelShader );
 
     HELIUM_DECLARE_RPTR( RTexture );
+    HELIUM_DECLARE_RPTR( RTexture2d );
+    HELIUM_DECLARE_RPTR( RGpuCullingBatch );
 
     HELIUM_DECLARE_RPTR( RFence );
+    HELIUM_DECLARE_RPTR( RTimerQuery );
 }
 
 using namespace Helium;
@@ -395,7 +401,8 @@ public:
         size_t startIndex,
         size_t bufferCount,
         RConstantBuffer* const* ppBuffers,
-        const size_t* pLimitSizes )
+        const size_t* pLimitSizes,
+        const size_t* pOffsets )
         : m_startIndex( startIndex )
         , m_bufferCount( bufferCount )
     {
@@ -420,6 +427,13 @@ public:
         {
             MemorySet( m_limitSizes, 0xff, bufferCount * sizeof( size_t ) );
         }
+
+        // Offsets are only recorded when given, since giving them changes how the limit sizes are interpreted.
+        m_bOffsets = ( pOffsets != NULL );
+        if( pOffsets )
+        {
+            MemoryCopy( m_offsets, pOffsets, bufferCount * sizeof( size_t ) );
+        }
     }
 
     ~D3D9SetConstantBuffersCommand()
@@ -431,6 +445,8 @@ protected:
     size_t m_bufferCount;
     RConstantBufferPtr m_buffers[ D3D9ImmediateCommandProxy::CONSTANT_BUFFER_SLOT_COUNT ];
     size_t m_limitSizes[ D3D9ImmediateCommandProxy::CONSTANT_BUFFER_SLOT_COUNT ];
+    size_t m_offsets[ D3D9ImmediateCommandProxy::CONSTANT_BUFFER_SLOT_COUNT ];
+    bool m_bOffsets;
 };
 
 class D3D9SetVertexConstantBuffersCommand : public D3D9SetConstantBuffersCommand
@@ -440,8 +456,9 @@ public:
         size_t startIndex,
         size_t bufferCount,
         RConstantBuffer* const* ppBuffers,
-        const size_t* pLimitSizes )
-        : D3D9SetConstantBuffersCommand( startIndex, bufferCount, ppBuffers, pLimitSizes )
+        const size_t* pLimitSizes,
+        const size_t* pOffsets )
+        : D3D9SetConstantBuffersCommand( startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets )
     {
     }
 
@@ -451,7 +468,8 @@ public:
             m_startIndex,
             m_bufferCount,
             &static_cast< RConstantBuffer* const& >( m_buffers[ 0 ] ),
-            m_limitSizes );
+            m_limitSizes,
+            ( m_bOffsets ? m_offsets : NULL ) );
     }
 };
 
@@ -462,8 +480,9 @@ public:
         size_t startIndex,
         size_t bufferCount,
         RConstantBuffer* const* ppBuffers,
-        const size_t* pLimitSizes )
-        : D3D9SetConstantBuffersCommand( startIndex, bufferCount, ppBuffers, pLimitSizes )
+        const size_t* pLimitSizes,
+        const size_t* pOffsets )
+        : D3D9SetConstantBuffersCommand( startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets )
     {
     }
 
@@ -473,7 +492,8 @@ public:
             m_startIndex,
             m_bufferCount,
             &static_cast< RConstantBuffer* const& >( m_buffers[ 0 ] ),
-            m_limitSizes );
+            m_limitSizes,
+            ( m_bOffsets ? m_offsets : NULL ) );
     }
 };
 
@@ -531,7 +551,7 @@ public:
             m_minIndex,
             m_usedVertexCount,
             m_startIndex,
-            m_primitiveType );
+            m_primitiveCount );
     }
 
 private:
@@ -543,6 +563,53 @@ private:
     uint32_t m_primitiveCount;
 };
 
+class D3D9DrawIndexedInstancedCommand : public D3D9RenderCommand
+{
+public:
+    D3D9DrawIndexedInstancedCommand(
+        ERendererPrimitiveType primitiveType,
+        uint32_t baseVertexIndex,
+        uint32_t minIndex,
+        uint32_t usedVertexCount,
+        uint32_t startIndex,
+        uint32_t primitiveCount,
+        uint32_t instanceCount )
+        : m_primitiveType( primitiveType )
+        , m_baseVertexIndex( baseVertexIndex )
+        , m_minIndex( minIndex )
+        , m_usedVertexCount( usedVertexCount )
+        , m_startIndex( startIndex )
+        , m_primitiveCount( primitiveCount )
+        , m_instanceCount( instanceCount )
+    {
+    }
+
+    ~D3D9DrawIndexedInstancedCommand()
+    {
+    }
+
+    void Execute( D3D9ImmediateCommandProxy* pCommandProxy )
+    {
+        pCommandProxy->DrawIndexedInstanced(
+            m_primitiveType,
+            m_baseVertexIndex,
+            m_minIndex,
+            m_usedVertexCount,
+            m_startIndex,
+            m_primitiveCount,
+            m_instanceCount );
+    }
+
+private:
+    ERendererPrimitiveType m_primitiveType;
+    uint32_t m_baseVertexIndex;
+    uint32_t m_minIndex;
+    uint32_t m_usedVertexCount;
+    uint32_t m_startIndex;
+    uint32_t m_primitiveCount;
+    uint32_t m_instanceCount;
+};
+
 class D3D9DrawUnindexedCommand : public D3D9RenderCommand
 {
 public:
@@ -568,6 +635,55 @@ private:
     uint32_t m_primitiveCount;
 };
 
+class D3D9CullGpuDrawsCommand : public D3D9RenderCommand
+{
+public:
+    D3D9CullGpuDrawsCommand( RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid )
+        : m_spBatch( pBatch )
+        , m_spDepthPyramid( pDepthPyramid )
+    {
+        HELIUM_ASSERT( pViewProjection );
+        MemoryCopy( m_viewProjection, pViewProjection, sizeof( m_viewProjection ) );
+    }
+
+    ~D3D9CullGpuDrawsCommand()
+    {
+    }
+
+    void Execute( D3D9ImmediateCommandProxy* pCommandProxy )
+    {
+        pCommandProxy->CullGpuDraws( m_spBatch, m_viewProjection, m_spDepthPyramid );
+    }
+
+private:
+    RGpuCullingBatchPtr m_spBatch;
+    RTexture2dPtr m_spDepthPyramid;
+    float32_t m_viewProjection[ 16 ];
+};
+
+class D3D9DrawGpuCulledCommand : public D3D9RenderCommand
+{
+public:
+    D3D9DrawGpuCulledCommand( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch )
+        : m_primitiveType( primitiveType )
+        , m_spBatch( pBatch )
+    {
+    }
+
+    ~D3D9DrawGpuCulledCommand()
+    {
+    }
+
+    void Execute( D3D9ImmediateCommandProxy* pCommandProxy )
+    {
+        pCommandProxy->DrawGpuCulled( m_primitiveType, m_spBatch );
+    }
+
+private:
+    ERendererPrimitiveType m_primitiveType;
+    RGpuCullingBatchPtr m_spBatch;
+};
+
 class D3D9SetFenceCommand : public D3D9RenderCommand
 {
 public:
@@ -589,6 +705,27 @@ private:
     RFencePtr m_spFence;
 };
 
+class D3D9IssueTimerQueryCommand : public D3D9RenderCommand
+{
+public:
+    D3D9IssueTimerQueryCommand( RTimerQuery* pQuery )
+        : m_spQuery( pQuery )
+    {
+    }
+
+    ~D3D9IssueTimerQueryCommand()
+    {
+    }
+
+    void Execute( D3D9ImmediateCommandProxy* pCommandProxy )
+    {
+        pCommandProxy->IssueTimerQuery( m_spQuery );
+    }
+
+private:
+    RTimerQueryPtr m_spQuery;
+};
+
 class D3D9UnbindResourcesCommand : public D3D9RenderCommand
 {
 public:
@@ -630,17 +767,17 @@ private:
 #define HELIUM_DEFERRED_COMMAND_PROXY_METHOD( COMMAND, PARAM_LIST, ARGUMENT_LIST ) \
     void D3D9DeferredCommandProxy::COMMAND PARAM_LIST \
     { \
-        if( !m_spCommandList ) \
+        D3D9RenderCommandList* pCommandList = GetCommandList(); \
+        if( !pCommandList->NewCommand< D3D9##COMMAND##Command > ARGUMENT_LIST ) \
         { \
-            m_spCommandList = new D3D9RenderCommandList; \
-            HELIUM_ASSERT( m_spCommandList ); \
+            pCommandList = AddCommandList(); \
+            HELIUM_VERIFY( pCommandList->NewCommand< D3D9##COMMAND##Command > ARGUMENT_LIST ); \
         } \
-        \
-        HELIUM_VERIFY( m_spCommandList->NewCommand< D3D9##COMMAND##Command > ARGUMENT_LIST ); \
     }
 
 /// Constructor.
 D3D9DeferredCommandProxy::D3D9DeferredCommandProxy()
+    : m_pLastCommandList( NULL )
 {
 }
 
@@ -649,6 +786,42 @@ D3D9DeferredCommandProxy::~D3D9DeferredCommandProxy()
 {
 }
 
+/// Get the command list into which new commands should be recorded, starting a new command list if necessary.
+///
+/// @return  Last command list in the chain being recorded.
+///
+/// @see AddCommandList()
+D3D9RenderCommandList* D3D9DeferredCommandProxy::GetCommandList()
+{
+    if( !m_spCommandList )
+    {
+        m_spCommandList = new D3D9RenderCommandList;
+        HELIUM_ASSERT( m_spCommandList );
+
+        m_pLastCommandList = m_spCommandList;
+    }
+
+    return m_pLastCommandList;
+}
+
+/// Chain a new command list after the last command list being recorded, once the last list has run out of space.
+///
+/// @return  New last command list in the chain being recorded.
+///
+/// @see GetCommandList()
+D3D9RenderCommandList* D3D9DeferredCommandProxy::AddCommandList()
+{
+    HELIUM_ASSERT( m_pLastCommandList );
+
+    D3D9RenderCommandList* pCommandList = new D3D9RenderCommandList;
+    HELIUM_ASSERT( pCommandList );
+
+    m_pLastCommandList->SetNext( pCommandList );
+    m_pLastCommandList = pCommandList;
+
+    return pCommandList;
+}
+
 HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
     SetRasterizerState,
     ( RRasterizerState* pState ),
@@ -721,13 +894,13 @@ HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
 
 HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
     SetVertexConstantBuffers,
-    ( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes ),
-    ( startIndex, bufferCount, ppBuffers, pLimitSizes ) )
+    ( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes, const size_t* pOffsets ),
+    ( startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets ) )
 
 HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
     SetPixelConstantBuffers,
-    ( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes ),
-    ( startIndex, bufferCount, ppBuffers, pLimitSizes ) )
+    ( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes, const size_t* pOffsets ),
+    ( startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets ) )
 
 HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
     SetTexture,
@@ -740,16 +913,37 @@ HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
       uint32_t startIndex, uint32_t primitiveCount ),
     ( primitiveType, baseVertexIndex, minIndex, usedVertexCount, startIndex, primitiveCount ) )
 
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+    DrawIndexedInstanced,
+    ( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
+      uint32_t startIndex, uint32_t primitiveCount, uint32_t instanceCount ),
+    ( primitiveType, baseVertexIndex, minIndex, usedVertexCount, startIndex, primitiveCount, instanceCount ) )
+
 HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
     DrawUnindexed,
     ( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t primitiveCount ),
     ( primitiveType, baseVertexIndex, primitiveCount ) )
 
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+    CullGpuDraws,
+    ( RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid ),
+    ( pBatch, pViewProjection, pDepthPyramid ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+    DrawGpuCulled,
+    ( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch ),
+    ( primitiveType, pBatch ) )
+
 HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
     SetFence,
     ( RFence* pFence ),
     ( pFence ) )
 
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+    IssueTimerQuery,
+    ( RTimerQuery* pQuery ),
+    ( pQuery ) )
+
 HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
     UnbindResources,
     (),
@@ -771,4 +965,5 @@ void D3D9DeferredCommandProxy::FinishCommandList( RRenderCommandListPtr& rspComm
     }
 
     m_spCommandList.Release();
+    m_pLastCommandList = NULL;
 }
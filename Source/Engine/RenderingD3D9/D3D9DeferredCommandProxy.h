@@ -49,24 +49,38 @@ namespace Helium
 
         void SetVertexConstantBuffers(
             size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
-            const size_t* pLimitSizes = NULL );
+            const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL );
         void SetPixelConstantBuffers(
             size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
-            const size_t* pLimitSizes = NULL );
+            const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL );
 
         void SetTexture( size_t samplerIndex, RTexture* pTexture );
 
         void DrawIndexed(
             ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
             uint32_t startIndex, uint32_t primitiveCount );
+        void DrawIndexedInstanced(
+            ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
+            uint32_t startIndex, uint32_t primitiveCount, uint32_t instanceCount );
         void DrawUnindexed( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t primitiveCount );
         //@}
 
+        /// @name GPU-Driven Culling Commands
+        //@{
+        void CullGpuDraws( RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid );
+        void DrawGpuCulled( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch );
+        //@}
+
         /// @name Fence Commands
         //@{
         void SetFence( RFence* pFence );
         //@}
 
+        /// @name Timer Query Commands
+        //@{
+        void IssueTimerQuery( RTimerQuery* pQuery );
+        //@}
+
         /// @name Miscellaneous Resource Management
         //@{
         void UnbindResources();
@@ -80,12 +94,20 @@ namespace Helium
         //@}
 
     private:
-        /// Command list.
+        /// First command list being recorded.
         D3D9RenderCommandListPtr m_spCommandList;
+        /// Last command list in the chain being recorded, into which new commands are added.
+        D3D9RenderCommandList* m_pLastCommandList;
 
         /// @name Construction/Destruction
         //@{
         ~D3D9DeferredCommandProxy();
         //@}
+
+        /// @name Private Utility Functions
+        //@{
+        D3D9RenderCommandList* GetCommandList();
+        D3D9RenderCommandList* AddCommandList();
+        //@}
     };
 }
@@ -12,9 +12,11 @@
 #include "RenderingD3D9/D3D9SamplerState.h"
 #include "RenderingD3D9/D3D9Surface.h"
 #include "RenderingD3D9/D3D9Texture2d.h"
+#include "RenderingD3D9/D3D9TimerQuery.h"
 #include "RenderingD3D9/D3D9VertexBuffer.h"
 #include "RenderingD3D9/D3D9VertexInputLayout.h"
 #include "RenderingD3D9/D3D9VertexShader.h"
+#include "Engine/RenderStatistics.h"
 
 using namespace Helium;
 
@@ -39,6 +41,11 @@ D3D9ImmediateCommandProxy::~D3D9ImmediateCommandProxy()
 /// @copydoc RRenderCommandProxy::SetRasterizerState()
 void D3D9ImmediateCommandProxy::SetRasterizerState( RRasterizerState* pState )
 {
+    if( !m_stateFilter.SetRasterizerState( pState ) )
+    {
+        return;
+    }
+
     D3D9RasterizerState* pD3D9State = static_cast< D3D9RasterizerState* >( pState );
     D3D9RasterizerState* pCurrentState = m_spRasterizerState;
     if( pCurrentState == pD3D9State )
@@ -95,6 +102,11 @@ void D3D9ImmediateCommandProxy::SetRasterizerState( RRasterizerState* pState )
 /// @copydoc RRenderCommandProxy::SetBlendState()
 void D3D9ImmediateCommandProxy::SetBlendState( RBlendState* pState )
 {
+    if( !m_stateFilter.SetBlendState( pState ) )
+    {
+        return;
+    }
+
     D3D9BlendState* pD3D9State = static_cast< D3D9BlendState* >( pState );
     D3D9BlendState* pCurrentState = m_spBlendState;
     if( pCurrentState == pD3D9State )
@@ -149,6 +161,11 @@ void D3D9ImmediateCommandProxy::SetBlendState( RBlendState* pState )
 /// @copydoc RRenderCommandProxy::SetDepthStencilState()
 void D3D9ImmediateCommandProxy::SetDepthStencilState( RDepthStencilState* pState, uint8_t stencilReferenceValue )
 {
+    if( !m_stateFilter.SetDepthStencilState( pState, stencilReferenceValue ) )
+    {
+        return;
+    }
+
     HELIUM_D3D9_VERIFY( m_pDevice->SetRenderState( D3DRS_STENCILREF, stencilReferenceValue ) );
 
     D3D9DepthStencilState* pD3D9State = static_cast< D3D9DepthStencilState* >( pState );
@@ -240,6 +257,11 @@ void D3D9ImmediateCommandProxy::SetSamplerStates(
 {
     HELIUM_ASSERT( ppStates || samplerCount == 0 );
 
+    if( !m_stateFilter.SetSamplerStates( startIndex, samplerCount, ppStates ) )
+    {
+        return;
+    }
+
     if( startIndex >= HELIUM_ARRAY_COUNT( m_samplerStates ) )
     {
         HELIUM_TRACE(
@@ -444,6 +466,11 @@ void D3D9ImmediateCommandProxy::Clear( uint32_t clearFlags, const Color& rColor,
 /// @copydoc RRenderCommandProxy::SetIndexBuffer()
 void D3D9ImmediateCommandProxy::SetIndexBuffer( RIndexBuffer* pBuffer )
 {
+    if( !m_stateFilter.SetIndexBuffer( pBuffer ) )
+    {
+        return;
+    }
+
     IDirect3DIndexBuffer9* pD3DBuffer = NULL;
     if( pBuffer )
     {
@@ -465,6 +492,11 @@ void D3D9ImmediateCommandProxy::SetVertexBuffers(
     HELIUM_ASSERT( pStrides || bufferCount == 0 );
     HELIUM_ASSERT( pOffsets || bufferCount == 0 );
 
+    if( !m_stateFilter.SetVertexBuffers( startIndex, bufferCount, ppBuffers, pStrides, pOffsets ) )
+    {
+        return;
+    }
+
     if( startIndex >= STREAM_SOURCE_COUNT )
     {
         HELIUM_TRACE(
@@ -519,6 +551,11 @@ void D3D9ImmediateCommandProxy::SetVertexBuffers(
 /// @copydoc RRenderCommandProxy::SetVertexInputLayout()
 void D3D9ImmediateCommandProxy::SetVertexInputLayout( RVertexInputLayout* pLayout )
 {
+    if( !m_stateFilter.SetVertexInputLayout( pLayout ) )
+    {
+        return;
+    }
+
     IDirect3DVertexDeclaration9* pD3DDeclaration = NULL;
     if( pLayout )
     {
@@ -532,6 +569,11 @@ void D3D9ImmediateCommandProxy::SetVertexInputLayout( RVertexInputLayout* pLayou
 /// @copydoc RRenderCommandProxy::SetVertexShader()
 void D3D9ImmediateCommandProxy::SetVertexShader( RVertexShader* pShader )
 {
+    if( !m_stateFilter.SetVertexShader( pShader ) )
+    {
+        return;
+    }
+
     IDirect3DVertexShader9* pD3DShader = NULL;
     if( pShader )
     {
@@ -545,6 +587,11 @@ void D3D9ImmediateCommandProxy::SetVertexShader( RVertexShader* pShader )
 /// @copydoc RRenderCommandProxy::SetPixelShader()
 void D3D9ImmediateCommandProxy::SetPixelShader( RPixelShader* pShader )
 {
+    if( !m_stateFilter.SetPixelShader( pShader ) )
+    {
+        return;
+    }
+
     IDirect3DPixelShader9* pD3DShader = NULL;
     if( pShader )
     {
@@ -560,7 +607,8 @@ void D3D9ImmediateCommandProxy::SetVertexConstantBuffers(
     size_t startIndex,
     size_t bufferCount,
     RConstantBuffer* const* ppBuffers,
-    const size_t* pLimitSizes )
+    const size_t* pLimitSizes,
+    const size_t* pOffsets )
 {
     HELIUM_ASSERT( ppBuffers || bufferCount == 0 );
 
@@ -588,25 +636,13 @@ void D3D9ImmediateCommandProxy::SetVertexConstantBuffers(
         bufferCount = availableSlots;
     }
 
-    if( pLimitSizes )
+    for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
     {
-        for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
-        {
-            m_vertexConstantManager.SetBuffer(
-                startIndex + bufferIndex,
-                static_cast< D3D9ConstantBuffer* >( ppBuffers[ bufferIndex ] ),
-                pLimitSizes[ bufferIndex ] );
-        }
-    }
-    else
-    {
-        for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
-        {
-            m_vertexConstantManager.SetBuffer(
-                startIndex + bufferIndex,
-                static_cast< D3D9ConstantBuffer* >( ppBuffers[ bufferIndex ] ),
-                Invalid< size_t >() );
-        }
+        m_vertexConstantManager.SetBuffer(
+            startIndex + bufferIndex,
+            static_cast< D3D9ConstantBuffer* >( ppBuffers[ bufferIndex ] ),
+            ( pLimitSizes ? pLimitSizes[ bufferIndex ] : Invalid< size_t >() ),
+            ( pOffsets ? pOffsets[ bufferIndex ] : Invalid< size_t >() ) );
     }
 }
 
@@ -615,7 +651,8 @@ void D3D9ImmediateCommandProxy::SetPixelConstantBuffers(
     size_t startIndex,
     size_t bufferCount,
     RConstantBuffer* const* ppBuffers,
-    const size_t* pLimitSizes )
+    const size_t* pLimitSizes,
+    const size_t* pOffsets )
 {
     HELIUM_ASSERT( ppBuffers || bufferCount == 0 );
 
@@ -643,31 +680,24 @@ void D3D9ImmediateCommandProxy::SetPixelConstantBuffers(
         bufferCount = availableSlots;
     }
 
-    if( pLimitSizes )
-    {
-        for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
-        {
-            m_pixelConstantManager.SetBuffer(
-                startIndex + bufferIndex,
-                static_cast< D3D9ConstantBuffer* >( ppBuffers[ bufferIndex ] ),
-                pLimitSizes[ bufferIndex ] );
-        }
-    }
-    else
+    for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
     {
-        for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
-        {
-            m_pixelConstantManager.SetBuffer(
-                startIndex + bufferIndex,
-                static_cast< D3D9ConstantBuffer* >( ppBuffers[ bufferIndex ] ),
-                Invalid< size_t >() );
-        }
+        m_pixelConstantManager.SetBuffer(
+            startIndex + bufferIndex,
+            static_cast< D3D9ConstantBuffer* >( ppBuffers[ bufferIndex ] ),
+            ( pLimitSizes ? pLimitSizes[ bufferIndex ] : Invalid< size_t >() ),
+            ( pOffsets ? pOffsets[ bufferIndex ] : Invalid< size_t >() ) );
     }
 }
 
 /// @copydoc RRenderCommandProxy::SetTexture()
 void D3D9ImmediateCommandProxy::SetTexture( size_t samplerIndex, RTexture* pTexture )
 {
+    if( !m_stateFilter.SetTexture( samplerIndex, pTexture ) )
+    {
+        return;
+    }
+
     HELIUM_ASSERT( samplerIndex < HELIUM_ARRAY_COUNT( m_textures ) );
     if( samplerIndex >= HELIUM_ARRAY_COUNT( m_textures ) )
     {
@@ -744,6 +774,29 @@ void D3D9ImmediateCommandProxy::DrawIndexed(
     uint32_t usedVertexCount,
     uint32_t startIndex,
     uint32_t primitiveCount )
+{
+    RenderStatistics::RecordDraw( primitiveCount, 0 );
+
+    IssueDrawIndexed( primitiveType, baseVertexIndex, minIndex, usedVertexCount, startIndex, primitiveCount );
+}
+
+/// Push pending shader constants and issue an indexed draw call.
+///
+/// @param[in] primitiveType    Type of primitives to draw.
+/// @param[in] baseVertexIndex  Offset added to each index.
+/// @param[in] minIndex         Lowest vertex index used.
+/// @param[in] usedVertexCount  Number of vertices used, starting at the lowest index.
+/// @param[in] startIndex       Index of the first index to read.
+/// @param[in] primitiveCount   Number of primitives to draw.
+///
+/// @see DrawIndexed(), DrawIndexedInstanced()
+void D3D9ImmediateCommandProxy::IssueDrawIndexed(
+    ERendererPrimitiveType primitiveType,
+    uint32_t baseVertexIndex,
+    uint32_t minIndex,
+    uint32_t usedVertexCount,
+    uint32_t startIndex,
+    uint32_t primitiveCount )
 {
     HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
 
@@ -777,6 +830,30 @@ void D3D9ImmediateCommandProxy::DrawIndexed(
         primitiveCount ) );
 }
 
+/// @copydoc RRenderCommandProxy::DrawIndexedInstanced()
+void D3D9ImmediateCommandProxy::DrawIndexedInstanced(
+    ERendererPrimitiveType primitiveType,
+    uint32_t baseVertexIndex,
+    uint32_t minIndex,
+    uint32_t usedVertexCount,
+    uint32_t startIndex,
+    uint32_t primitiveCount,
+    uint32_t instanceCount )
+{
+    HELIUM_ASSERT( instanceCount != 0 );
+
+    // Stream 0 is repeated for each instance, while stream 1 advances once per instance.
+    HELIUM_D3D9_VERIFY( m_pDevice->SetStreamSourceFreq( 0, D3DSTREAMSOURCE_INDEXEDDATA | instanceCount ) );
+    HELIUM_D3D9_VERIFY( m_pDevice->SetStreamSourceFreq( 1, D3DSTREAMSOURCE_INSTANCEDATA | 1 ) );
+
+    RenderStatistics::RecordDraw( primitiveCount, instanceCount );
+
+    IssueDrawIndexed( primitiveType, baseVertexIndex, minIndex, usedVertexCount, startIndex, primitiveCount );
+
+    HELIUM_D3D9_VERIFY( m_pDevice->SetStreamSourceFreq( 0, 1 ) );
+    HELIUM_D3D9_VERIFY( m_pDevice->SetStreamSourceFreq( 1, 1 ) );
+}
+
 /// @copydoc RRenderCommandProxy::DrawUnindexed()
 void D3D9ImmediateCommandProxy::DrawUnindexed(
     ERendererPrimitiveType primitiveType,
@@ -806,6 +883,8 @@ void D3D9ImmediateCommandProxy::DrawUnindexed(
     m_vertexConstantManager.Push( m_pDevice );
     m_pixelConstantManager.Push( m_pDevice );
 
+    RenderStatistics::RecordDraw( primitiveCount, 0 );
+
     HELIUM_D3D9_VERIFY( m_pDevice->DrawPrimitive( d3dPrimitiveTypes[ primitiveType ], baseVertexIndex, primitiveCount ) );
 }
 
@@ -820,9 +899,44 @@ void D3D9ImmediateCommandProxy::SetFence( RFence* pFence )
     HELIUM_D3D9_VERIFY( pD3DQuery->Issue( D3DISSUE_END ) );
 }
 
+/// @copydoc RRenderCommandProxy::CullGpuDraws()
+void D3D9ImmediateCommandProxy::CullGpuDraws(
+    RGpuCullingBatch* /*pBatch*/,
+    const float32_t* /*pViewProjection*/,
+    RTexture2d* /*pDepthPyramid*/ )
+{
+    // Culling batches cannot be created on this renderer (see D3D9Renderer::CreateGpuCullingBatch()).
+    HELIUM_TRACE(
+        TraceLevels::Error,
+        "D3D9ImmediateCommandProxy::CullGpuDraws(): GPU-driven culling is not supported by the Direct3D 9 renderer.\n" );
+}
+
+/// @copydoc RRenderCommandProxy::DrawGpuCulled()
+void D3D9ImmediateCommandProxy::DrawGpuCulled( ERendererPrimitiveType /*primitiveType*/, RGpuCullingBatch* /*pBatch*/ )
+{
+    HELIUM_TRACE(
+        TraceLevels::Error,
+        "D3D9ImmediateCommandProxy::DrawGpuCulled(): GPU-driven culling is not supported by the Direct3D 9 renderer.\n" );
+}
+
+/// @copydoc RRenderCommandProxy::IssueTimerQuery()
+void D3D9ImmediateCommandProxy::IssueTimerQuery( RTimerQuery* pQuery )
+{
+    HELIUM_ASSERT( pQuery );
+
+    // The Direct3D query is released on device reset until it has been recreated.
+    IDirect3DQuery9* pD3DQuery = static_cast< D3D9TimerQuery* >( pQuery )->GetQuery();
+    if( pD3DQuery )
+    {
+        HELIUM_D3D9_VERIFY( pD3DQuery->Issue( D3DISSUE_END ) );
+    }
+}
+
 /// @copydoc RRenderCommandProxy::UnbindResources()
 void D3D9ImmediateCommandProxy::UnbindResources()
 {
+    m_stateFilter.Reset();
+
     m_spRasterizerState.Release();
     m_spBlendState.Release();
     m_spDepthStencilState.Release();
@@ -848,8 +962,8 @@ void D3D9ImmediateCommandProxy::UnbindResources()
 
     for( size_t constantBufferIndex = 0; constantBufferIndex < CONSTANT_BUFFER_SLOT_COUNT; ++constantBufferIndex )
     {
-        m_vertexConstantManager.SetBuffer( constantBufferIndex, NULL, Invalid< size_t >() );
-        m_pixelConstantManager.SetBuffer( constantBufferIndex, NULL, Invalid< size_t >() );
+        m_vertexConstantManager.SetBuffer( constantBufferIndex, NULL, Invalid< size_t >(), Invalid< size_t >() );
+        m_pixelConstantManager.SetBuffer( constantBufferIndex, NULL, Invalid< size_t >(), Invalid< size_t >() );
     }
 }
 
@@ -858,13 +972,16 @@ void D3D9ImmediateCommandProxy::ExecuteCommandList( RRenderCommandList* pCommand
 {
     HELIUM_ASSERT( pCommandList );
 
-    D3D9RenderCommandList* pRenderCommandList = static_cast< D3D9RenderCommandList* >( pCommandList );
-
-    D3D9RenderCommandList::Iterator listEnd = pRenderCommandList->End();
-    for( D3D9RenderCommandList::Iterator listIter = pRenderCommandList->Begin(); listIter != listEnd; ++listIter )
+    for( D3D9RenderCommandList* pRenderCommandList = static_cast< D3D9RenderCommandList* >( pCommandList );
+         pRenderCommandList != NULL;
+         pRenderCommandList = pRenderCommandList->GetNext() )
     {
-        D3D9RenderCommand& rCommand = *listIter;
-        rCommand.Execute( this );
+        D3D9RenderCommandList::Iterator listEnd = pRenderCommandList->End();
+        for( D3D9RenderCommandList::Iterator listIter = pRenderCommandList->Begin(); listIter != listEnd; ++listIter )
+        {
+            D3D9RenderCommand& rCommand = *listIter;
+            rCommand.Execute( this );
+        }
     }
 }
 
@@ -885,6 +1002,8 @@ void D3D9ImmediateCommandProxy::FinishCommandList( RRenderCommandListPtr& rspCom
 template< typename Pusher, size_t RegisterCount >
 D3D9ImmediateCommandProxy::ConstantManager< Pusher, RegisterCount >::ConstantManager()
 {
+    MemoryZero( m_bufferOffsets, sizeof( m_bufferOffsets ) );
+    MemoryZero( m_bufferRegisterCounts, sizeof( m_bufferRegisterCounts ) );
 }
 
 /// Destructor.
@@ -895,17 +1014,24 @@ D3D9ImmediateCommandProxy::ConstantManager< Pusher, RegisterCount >::~ConstantMa
 
 /// Assign a constant buffer to the specified slot.
 ///
+/// Constant buffers are laid out in consecutive registers, each slot taking up as many registers as the buffer bound
+/// to it.  When a buffer is bound with an offset, only the range of registers starting at the offset is bound, ending
+/// after the limit size if one is given, so that ranges of a single large buffer can be bound like separate buffers.
+///
 /// @param[in] index      Constant buffer slot index.
 /// @param[in] pBuffer    Constant buffer to set.
-/// @param[in] limitSize  Number of bytes, starting from the beginning of the buffer, in which to limit updates to
+/// @param[in] limitSize  Number of bytes, starting from the beginning of the bound range, in which to limit updates to
 ///                       shader constant registers.
+/// @param[in] offset     Offset in bytes of the range of the buffer to bind, or an invalid index to bind the entire
+///                       buffer.
 ///
 /// @see GetBuffer()
 template< typename Pusher, size_t RegisterCount >
 void D3D9ImmediateCommandProxy::ConstantManager< Pusher, RegisterCount >::SetBuffer(
     size_t index,
     D3D9ConstantBuffer* pBuffer,
-    size_t limitSize )
+    size_t limitSize,
+    size_t offset )
 {
     HELIUM_ASSERT( index < HELIUM_ARRAY_COUNT( m_buffers ) );
 
@@ -921,54 +1047,65 @@ void D3D9ImmediateCommandProxy::ConstantManager< Pusher, RegisterCount >::SetBuf
         SetInvalid( m_bufferLimitSizes[ index ] );
     }
 
-    D3D9ConstantBuffer* pOldBuffer = m_buffers[ index ];
-    if( pOldBuffer != pBuffer )
+    // Determine the range of registers in the buffer bound to the slot.
+    uint16_t newRegisterOffset = 0;
+    uint_fast16_t newRegisterCount = 0;
+    if( pBuffer )
     {
-        uint_fast16_t oldRegisterCount = 0;
-        if( pOldBuffer )
+        newRegisterCount = pBuffer->GetRegisterCount();
+        if( IsValid( offset ) )
         {
-            oldRegisterCount = pOldBuffer->GetRegisterCount();
-        }
-
-        uint_fast16_t newRegisterCount = 0;
-        if( pBuffer )
-        {
-            newRegisterCount = pBuffer->GetRegisterCount();
+            HELIUM_ASSERT( offset % CONSTANT_BUFFER_OFFSET_ALIGNMENT == 0 );
+            newRegisterOffset = static_cast< uint16_t >( Min< size_t >(
+                offset / ( sizeof( float32_t ) * 4 ),
+                newRegisterCount ) );
+            newRegisterCount -= newRegisterOffset;
+            if( IsValid( m_bufferLimitSizes[ index ] ) )
+            {
+                newRegisterCount = Min< uint_fast16_t >( newRegisterCount, m_bufferLimitSizes[ index ] );
+            }
         }
+    }
 
-        if( oldRegisterCount != newRegisterCount )
+    D3D9ConstantBuffer* pOldBuffer = m_buffers[ index ];
+    uint_fast16_t oldRegisterCount = ( pOldBuffer ? m_bufferRegisterCounts[ index ] : 0 );
+    if( oldRegisterCount != newRegisterCount )
+    {
+        // Register count changed, so invalidate all registers in buffers that follow the one being assigned.
+        uint_fast16_t invalidRegisterStart = newRegisterCount;
+        for( size_t previousIndex = 0; previousIndex < index; ++previousIndex )
         {
-            // Register count changed, so invalidate all registers in buffers that follow the one being assigned.
-            uint_fast16_t invalidRegisterStart = newRegisterCount;
-            for( size_t previousIndex = 0; previousIndex < index; ++previousIndex )
+            if( m_buffers[ previousIndex ] )
             {
-                D3D9ConstantBuffer* pPreviousBuffer = m_buffers[ previousIndex ];
-                if( pPreviousBuffer )
-                {
-                    invalidRegisterStart += pPreviousBuffer->GetRegisterCount();
-                }
+                invalidRegisterStart += m_bufferRegisterCounts[ previousIndex ];
             }
+        }
 
-            uint_fast16_t invalidRegisterElementIndex = invalidRegisterStart / ( sizeof( uint32_t ) * 8 );
-            if( invalidRegisterElementIndex < HELIUM_ARRAY_COUNT( m_dirtyRegisters ) )
+        uint_fast16_t invalidRegisterElementIndex = invalidRegisterStart / ( sizeof( uint32_t ) * 8 );
+        if( invalidRegisterElementIndex < HELIUM_ARRAY_COUNT( m_dirtyRegisters ) )
+        {
+            uint_fast16_t invalidRegisterBit = invalidRegisterStart % ( sizeof( uint32_t ) * 8 );
+            if( invalidRegisterBit != 0 )
             {
-                uint_fast16_t invalidRegisterBit = invalidRegisterStart % ( sizeof( uint32_t ) * 8 );
-                if( invalidRegisterBit != 0 )
-                {
-                    uint32_t bitMask = ~( ( 1U << invalidRegisterBit ) - 1 );
-                    m_dirtyRegisters[ invalidRegisterElementIndex ] |= bitMask;
-
-                    ++invalidRegisterElementIndex;
-                }
+                uint32_t bitMask = ~( ( 1U << invalidRegisterBit ) - 1 );
+                m_dirtyRegisters[ invalidRegisterElementIndex ] |= bitMask;
 
-                MemorySet(
-                    m_dirtyRegisters,
-                    0xff,
-                    ( HELIUM_ARRAY_COUNT( m_dirtyRegisters ) - invalidRegisterElementIndex ) * sizeof( uint32_t ) );
+                ++invalidRegisterElementIndex;
             }
+
+            MemorySet(
+                m_dirtyRegisters,
+                0xff,
+                ( HELIUM_ARRAY_COUNT( m_dirtyRegisters ) - invalidRegisterElementIndex ) * sizeof( uint32_t ) );
         }
+    }
+
+    m_bufferRegisterCounts[ index ] = static_cast< uint16_t >( newRegisterCount );
 
+    if( pOldBuffer != pBuffer || m_bufferOffsets[ index ] != newRegisterOffset )
+    {
         m_buffers[ index ] = pBuffer;
+        m_bufferOffsets[ index ] = newRegisterOffset;
         if( pBuffer )
         {
             // Set the buffer tag as one minus its actual tag to force its contents to be updated during the next
@@ -1029,8 +1166,9 @@ void D3D9ImmediateCommandProxy::ConstantManager< Pusher, RegisterCount >::Push(
 
         // Push dirty registers.
         const float32_t* pData = static_cast< const float32_t* >( pBuffer->GetData() );
-        uint_fast16_t bufferRegisterCount = pBuffer->GetRegisterCount();
+        uint_fast16_t bufferRegisterCount = m_bufferRegisterCounts[ bufferIndex ];
         HELIUM_ASSERT( pData || bufferRegisterCount == 0 );
+        pData += static_cast< size_t >( m_bufferOffsets[ bufferIndex ] ) * 4;
 
         uint_fast16_t bufferRegisterLimit = Min< uint_fast16_t >(
             m_bufferLimitSizes[ bufferIndex ],
@@ -71,24 +71,38 @@ namespace Helium
 
         void SetVertexConstantBuffers(
             size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
-            const size_t* pLimitSizes = NULL );
+            const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL );
         void SetPixelConstantBuffers(
             size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
-            const size_t* pLimitSizes = NULL );
+            const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL );
 
         void SetTexture( size_t samplerIndex, RTexture* pTexture );
 
         void DrawIndexed(
             ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
             uint32_t startIndex, uint32_t primitiveCount );
+        void DrawIndexedInstanced(
+            ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
+            uint32_t startIndex, uint32_t primitiveCount, uint32_t instanceCount );
         void DrawUnindexed( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t primitiveCount );
         //@}
 
+        /// @name GPU-Driven Culling Commands
+        //@{
+        void CullGpuDraws( RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid );
+        void DrawGpuCulled( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch );
+        //@}
+
         /// @name Fence Commands
         //@{
         void SetFence( RFence* pFence );
         //@}
 
+        /// @name Timer Query Commands
+        //@{
+        void IssueTimerQuery( RTimerQuery* pQuery );
+        //@}
+
         /// @name Miscellaneous Resource Management
         //@{
         void UnbindResources();
@@ -115,7 +129,7 @@ namespace Helium
 
             /// @name Constant Buffer Access
             //@{
-            void SetBuffer( size_t index, D3D9ConstantBuffer* pBuffer, size_t limitSize );
+            void SetBuffer( size_t index, D3D9ConstantBuffer* pBuffer, size_t limitSize, size_t offset );
             D3D9ConstantBuffer* GetBuffer( size_t index ) const;
             //@}
 
@@ -133,6 +147,10 @@ namespace Helium
             uint32_t m_dirtyRegisters[ ( RegisterCount + sizeof( uint32_t ) * 8 - 1 ) / ( sizeof( uint32_t ) * 8 ) ];
             /// Constant buffer update range limits.
             uint16_t m_bufferLimitSizes[ CONSTANT_BUFFER_SLOT_COUNT ];
+            /// Register offset of the bound range of each constant buffer.
+            uint16_t m_bufferOffsets[ CONSTANT_BUFFER_SLOT_COUNT ];
+            /// Number of registers taken up by the bound range of each constant buffer.
+            uint16_t m_bufferRegisterCounts[ CONSTANT_BUFFER_SLOT_COUNT ];
             /// Constant value pusher.
             Pusher m_pusher;
         };
@@ -190,5 +208,12 @@ namespace Helium
         //@{
         ~D3D9ImmediateCommandProxy();
         //@}
+
+        /// @name Private Utility Functions
+        //@{
+        void IssueDrawIndexed(
+            ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
+            uint32_t startIndex, uint32_t primitiveCount );
+        //@}
     };
 }
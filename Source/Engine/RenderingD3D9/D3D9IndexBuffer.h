@@ -6,8 +6,14 @@
 namespace Helium
 {
     /// Direct3D 9 index buffer implementation.
+    ///
+    /// Static buffers in the default pool (as allocated with Direct3D 9Ex) are mapped to system memory staging data,
+    /// which is copied over to the buffer through the renderer's D3D9UploadQueue once unmapped.  Such buffers must be
+    /// fully updated whenever they are mapped.
     class D3D9IndexBuffer : public RIndexBuffer
     {
+        friend class D3D9UploadQueue;
+
     public:
         /// @name Construction/Destruction
         //@{
@@ -19,6 +25,8 @@ namespace Helium
         void* Map( ERendererBufferMapHint hint );
         void Unmap();
 
+        bool IsUploadPending() const;
+
         inline IDirect3DIndexBuffer9* GetD3DBuffer() const;
         //@}
 
@@ -26,10 +34,22 @@ namespace Helium
         /// Vertex buffer instance.
         IDirect3DIndexBuffer9* m_pBuffer;
 
+        /// Mapped staging data, or null if the buffer is not mapped to staging data.
+        void* m_pStagingData;
+        /// Number of staged uploads waiting in the upload queue.
+        volatile int32_t m_pendingUploadCount;
+        /// True if the buffer is mapped to staging data instead of being locked directly.
+        bool m_bStaged;
+
         /// @name Construction/Destruction
         //@{
         virtual ~D3D9IndexBuffer();
         //@}
+
+        /// @name Staging Data Uploading
+        //@{
+        void CommitStagingData( void* pStagingData, bool bCopy );
+        //@}
     };
 }
 
@@ -1,16 +1,20 @@
 #include "Precompile.h"
 #include "RenderingD3D9/D3D9MainContext.h"
 
+#include "RenderingD3D9/D3D9Fence.h"
 #include "RenderingD3D9/D3D9Surface.h"
 
 using namespace Helium;
 
 /// Constructor.
 ///
-/// @param[in] pD3DDevice  Direct3D 9 device to use for rendering.  Its reference count will be incremented when
-///                        this object is constructed and decremented back when this object is destroyed.
-D3D9MainContext::D3D9MainContext( IDirect3DDevice9* pD3DDevice )
+/// @param[in] pD3DDevice      Direct3D 9 device to use for rendering.  Its reference count will be incremented when
+///                            this object is constructed and decremented back when this object is destroyed.
+/// @param[in] frameRateLimit  Maximum number of frames presented per second (0 for no limit).
+D3D9MainContext::D3D9MainContext( IDirect3DDevice9* pD3DDevice, uint32_t frameRateLimit )
 : m_pDevice( pD3DDevice )
+, m_frameFenceIndex( 0 )
+, m_frameLimiter( frameRateLimit )
 {
     HELIUM_ASSERT( pD3DDevice );
     pD3DDevice->AddRef();
@@ -42,24 +46,56 @@ RSurface* D3D9MainContext::GetBackBufferSurface()
     return m_spBackBufferSurface;
 }
 
+/// @copydoc RRenderContext::Resize()
+///
+/// The implicit swap chain of a Direct3D 9 device can only be resized by resetting the device, so this always fails
+/// (see Renderer::ResetMainContext()).
+bool D3D9MainContext::Resize( uint32_t /*width*/, uint32_t /*height*/ )
+{
+    return false;
+}
+
 /// @copydoc RRenderContext::Swap()
 void D3D9MainContext::Swap()
 {
     // Release the current back buffer surface.
     m_spBackBufferSurface.Release();
 
-    // Present the scene.
+    D3D9Renderer* pRenderer = static_cast< D3D9Renderer* >( Renderer::GetInstance() );
+    HELIUM_ASSERT( pRenderer );
+
+    // Present the scene once it is due.
+    m_frameLimiter.Wait();
     HRESULT result = m_pDevice->Present( NULL, NULL, NULL, NULL );
     if( result == D3DERR_DEVICELOST )
     {
-        D3D9Renderer* pRenderer = static_cast< D3D9Renderer* >( Renderer::GetInstance() );
-        HELIUM_ASSERT( pRenderer );
         pRenderer->NotifyLost();
+
+        return;
+    }
+
+    HELIUM_D3D9_ASSERT( result );
+
+    // Wait for the oldest frame still allowed in flight to finish before letting the CPU start on another one, then
+    // fence the frame just presented in its place.  Fence queries are released when the device is reset, in which
+    // case the fence is simply recreated.
+    D3D9FencePtr& rspFrameFence = m_frameFences[ m_frameFenceIndex ];
+    if( rspFrameFence && rspFrameFence->GetQuery() )
+    {
+        pRenderer->SyncFence( rspFrameFence );
     }
     else
     {
-        HELIUM_D3D9_ASSERT( result );
+        rspFrameFence = static_cast< D3D9Fence* >( pRenderer->CreateFence() );
+        if( !rspFrameFence )
+        {
+            return;
+        }
     }
+
+    HELIUM_D3D9_VERIFY( rspFrameFence->GetQuery()->Issue( D3DISSUE_END ) );
+
+    m_frameFenceIndex = ( m_frameFenceIndex + 1 ) % HELIUM_ARRAY_COUNT( m_frameFences );
 }
 
 /// Release this context's reference to the back buffer surface.
@@ -69,3 +105,11 @@ void D3D9MainContext::ReleaseBackBufferSurface()
 {
     m_spBackBufferSurface.Release();
 }
+
+/// Set the maximum number of frames presented per second.
+///
+/// @param[in] frameRateLimit  Frame rate limit, or zero to disable frame rate limiting.
+void D3D9MainContext::SetFrameRateLimit( uint32_t frameRateLimit )
+{
+    m_frameLimiter.SetFrameRateLimit( frameRateLimit );
+}
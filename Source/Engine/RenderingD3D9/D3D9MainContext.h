@@ -2,18 +2,28 @@
 
 #include "RenderingD3D9/RenderingD3D9.h"
 #include "Rendering/RRenderContext.h"
+#include "Rendering/FrameLimiter.h"
 
 namespace Helium
 {
     HELIUM_DECLARE_RPTR( D3D9Surface );
+    HELIUM_DECLARE_RPTR( D3D9Fence );
 
     /// Interface to the main Direct3D 9 render context (that managed directly by the IDirect3DDevice9 instance).
+    ///
+    /// As with the OpenGL main context, presenting a frame waits as needed so that the CPU never gets more than
+    /// MAX_FRAMES_IN_FLIGHT - 1 frames ahead of the GPU, rather than leaving the frame latency up to the driver (which
+    /// may queue several frames).  If a frame rate limit is set, the frame limiter paces frames before they are
+    /// presented.
     class D3D9MainContext : public RRenderContext
     {
     public:
+        /// Maximum number of frames being processed at once, counting the frame being prepared by the CPU.
+        static const size_t MAX_FRAMES_IN_FLIGHT = 2;
+
         /// @name Construction/Destruction
         //@{
-        D3D9MainContext( IDirect3DDevice9* pD3DDevice );
+        D3D9MainContext( IDirect3DDevice9* pD3DDevice, uint32_t frameRateLimit = 0 );
         //@}
 
         /// @name Render Control
@@ -21,15 +31,30 @@ namespace Helium
         RSurface* GetBackBufferSurface();
         void Swap();
 
+        bool Resize( uint32_t width, uint32_t height );
+
         void ReleaseBackBufferSurface();
         //@}
 
+        /// @name Frame Pacing
+        //@{
+        void SetFrameRateLimit( uint32_t frameRateLimit );
+        //@}
+
     private:
         /// Direct3D 9 device instance.
         IDirect3DDevice9* m_pDevice;
         /// Active backbuffer surface.
         D3D9SurfacePtr m_spBackBufferSurface;
 
+        /// Fences set after presenting each of the most recent frames that may still be in flight.
+        D3D9FencePtr m_frameFences[ MAX_FRAMES_IN_FLIGHT - 1 ];
+        /// Index of the frame fence to reuse for the next frame.
+        size_t m_frameFenceIndex;
+
+        /// Frame rate limiter applied before presenting each frame.
+        FrameLimiter m_frameLimiter;
+
         /// @name Construction/Destruction
         //@{
         ~D3D9MainContext();
@@ -5,6 +5,8 @@
 
 namespace Helium
 {
+    HELIUM_DECLARE_RPTR( D3D9RenderCommandList );
+
     /// Direct3D 9 render command.
     class D3D9RenderCommand
     {
@@ -21,6 +23,9 @@ namespace Helium
     };
 
     /// Direct3D 9 render command list.
+    ///
+    /// Each command list has a fixed-size buffer.  Commands that do not fit are recorded into additional command lists
+    /// chained after the first, which are executed in order along with it.
     class D3D9RenderCommandList : public RRenderCommandList
     {
     public:
@@ -71,6 +76,17 @@ namespace Helium
             T* NewCommand(
                 const P0& rParam0, const P1& rParam1, const P2& rParam2, const P3& rParam3, const P4& rParam4,
                 const P5& rParam5 );
+        template<
+            typename T, typename P0, typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+            T* NewCommand(
+                const P0& rParam0, const P1& rParam1, const P2& rParam2, const P3& rParam3, const P4& rParam4,
+                const P5& rParam5, const P6& rParam6 );
+        //@}
+
+        /// @name Command List Chaining
+        //@{
+        inline D3D9RenderCommandList* GetNext() const;
+        inline void SetNext( D3D9RenderCommandList* pNext );
         //@}
 
         /// @name Command Iteration
@@ -86,6 +102,8 @@ namespace Helium
         size_t m_size;
         /// Current command buffer write offset.
         size_t m_writeOffset;
+        /// Command list containing the commands recorded after this list ran out of space.
+        D3D9RenderCommandListPtr m_spNext;
 
         /// @name Construction/Destruction
         //@{
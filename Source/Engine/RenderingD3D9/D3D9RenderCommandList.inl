@@ -7,7 +7,10 @@ namespace Helium
     T* D3D9RenderCommandList::NewCommand()
     {
         void* pAddress = AllocateCommandSpace< T >();
-        HELIUM_ASSERT( pAddress );
+        if( !pAddress )
+        {
+            return NULL;
+        }
 
         return new( pAddress ) T;
     }
@@ -21,7 +24,10 @@ namespace Helium
     T* D3D9RenderCommandList::NewCommand( const P0& rParam0 )
     {
         void* pAddress = AllocateCommandSpace< T >();
-        HELIUM_ASSERT( pAddress );
+        if( !pAddress )
+        {
+            return NULL;
+        }
 
         return new( pAddress ) T( rParam0 );
     }
@@ -36,7 +42,10 @@ namespace Helium
     T* D3D9RenderCommandList::NewCommand( const P0& rParam0, const P1& rParam1 )
     {
         void* pAddress = AllocateCommandSpace< T >();
-        HELIUM_ASSERT( pAddress );
+        if( !pAddress )
+        {
+            return NULL;
+        }
 
         return new( pAddress ) T( rParam0, rParam1 );
     }
@@ -52,7 +61,10 @@ namespace Helium
     T* D3D9RenderCommandList::NewCommand( const P0& rParam0, const P1& rParam1, const P2& rParam2 )
     {
         void* pAddress = AllocateCommandSpace< T >();
-        HELIUM_ASSERT( pAddress );
+        if( !pAddress )
+        {
+            return NULL;
+        }
 
         return new( pAddress ) T( rParam0, rParam1, rParam2 );
     }
@@ -69,7 +81,10 @@ namespace Helium
     T* D3D9RenderCommandList::NewCommand( const P0& rParam0, const P1& rParam1, const P2& rParam2, const P3& rParam3 )
     {
         void* pAddress = AllocateCommandSpace< T >();
-        HELIUM_ASSERT( pAddress );
+        if( !pAddress )
+        {
+            return NULL;
+        }
 
         return new( pAddress ) T( rParam0, rParam1, rParam2, rParam3 );
     }
@@ -92,7 +107,10 @@ namespace Helium
         const P4& rParam4 )
     {
         void* pAddress = AllocateCommandSpace< T >();
-        HELIUM_ASSERT( pAddress );
+        if( !pAddress )
+        {
+            return NULL;
+        }
 
         return new( pAddress ) T( rParam0, rParam1, rParam2, rParam3, rParam4 );
     }
@@ -117,30 +135,81 @@ namespace Helium
         const P5& rParam5 )
     {
         void* pAddress = AllocateCommandSpace< T >();
-        HELIUM_ASSERT( pAddress );
+        if( !pAddress )
+        {
+            return NULL;
+        }
 
         return new( pAddress ) T( rParam0, rParam1, rParam2, rParam3, rParam4, rParam5 );
     }
 
+    /// Allocate a new command with seven parameters.
+    ///
+    /// @param[in] rParam0  Command parameter.
+    /// @param[in] rParam1  Command parameter.
+    /// @param[in] rParam2  Command parameter.
+    /// @param[in] rParam3  Command parameter.
+    /// @param[in] rParam4  Command parameter.
+    /// @param[in] rParam5  Command parameter.
+    /// @param[in] rParam6  Command parameter.
+    ///
+    /// @return  New command.
+    template< typename T, typename P0, typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+    T* D3D9RenderCommandList::NewCommand(
+        const P0& rParam0,
+        const P1& rParam1,
+        const P2& rParam2,
+        const P3& rParam3,
+        const P4& rParam4,
+        const P5& rParam5,
+        const P6& rParam6 )
+    {
+        void* pAddress = AllocateCommandSpace< T >();
+        if( !pAddress )
+        {
+            return NULL;
+        }
+
+        return new( pAddress ) T( rParam0, rParam1, rParam2, rParam3, rParam4, rParam5, rParam6 );
+    }
+
+    /// Get the command list chained after this list.
+    ///
+    /// @return  Next command list in the chain, or null if this is the last command list.
+    ///
+    /// @see SetNext()
+    D3D9RenderCommandList* D3D9RenderCommandList::GetNext() const
+    {
+        return m_spNext;
+    }
+
+    /// Set the command list chained after this list.
+    ///
+    /// @param[in] pNext  Next command list in the chain.
+    ///
+    /// @see GetNext()
+    void D3D9RenderCommandList::SetNext( D3D9RenderCommandList* pNext )
+    {
+        m_spNext = pNext;
+    }
+
     /// Allocate space in this command buffer for a command of the template type.
     ///
-    /// @return  Allocated address if allocated successfully, null if there is not enough space in this command buffer.
+    /// @return  Allocated address if allocated successfully, null if there is not enough space in this command buffer
+    ///          (the command should be allocated in a new command list chained after this one instead).
     template< typename T >
     void* D3D9RenderCommandList::AllocateCommandSpace()
     {
         // Make sure we have enough space remaining in the command buffer and the command size.  Note that we are
         // explicitly using 64-bit sizes for commands to ensure platform consistency and 8-byte padding.
         size_t alignedSize = Align( sizeof( T ), sizeof( uint64_t ) );
+        HELIUM_ASSERT_MSG(
+            alignedSize + sizeof( uint64_t ) <= m_size,
+            "D3D9RenderCommandList: Command size exceeds the command list buffer size" );
+
         size_t bytesRemaining = m_size - m_writeOffset;
-        if( bytesRemaining < alignedSize + sizeof( size_t ) )
+        if( bytesRemaining < alignedSize + sizeof( uint64_t ) )
         {
-            HELIUM_TRACE(
-                TraceLevels::Error,
-                "D3D9RenderCommandList: Failed to allocate a command of size %" PRIuSZ " (%" PRIuSZ " bytes needed; %" PRIuSZ " bytes remaining in buffer).\n",
-                alignedSize,
-                alignedSize + sizeof( size_t ),
-                bytesRemaining );
-
             // Move the write offset to the end of the buffer to prevent out-of-order writing of commands.
             m_writeOffset = m_size;
 
@@ -199,8 +268,8 @@ namespace Helium
     /// @return  Reference to this iterator.
     D3D9RenderCommandList::Iterator& D3D9RenderCommandList::Iterator::operator++()
     {
-        size_t size = *reinterpret_cast< uint32_t* >( m_pCurrent );
-        m_pCurrent += sizeof( uint32_t ) + size;
+        size_t size = static_cast< size_t >( *reinterpret_cast< uint64_t* >( m_pCurrent ) );
+        m_pCurrent += sizeof( uint64_t ) + size;
 
         return *this;
     }
@@ -210,7 +279,7 @@ namespace Helium
     /// @return  Reference to the current render command.
     D3D9RenderCommand& D3D9RenderCommandList::Iterator::operator*()
     {
-        return *reinterpret_cast< D3D9RenderCommand* >( m_pCurrent + sizeof( uint32_t ) );
+        return *reinterpret_cast< D3D9RenderCommand* >( m_pCurrent + sizeof( uint64_t ) );
     }
 
     /// Get the render command referenced by this iterator.
@@ -218,7 +287,7 @@ namespace Helium
     /// @return  Pointer to the current render command.
     D3D9RenderCommand* D3D9RenderCommandList::Iterator::operator->()
     {
-        return reinterpret_cast< D3D9RenderCommand* >( m_pCurrent + sizeof( uint32_t ) );
+        return reinterpret_cast< D3D9RenderCommand* >( m_pCurrent + sizeof( uint64_t ) );
     }
 
     /// Check whether this iterator references the same render command as the given iterator.
@@ -3,6 +3,7 @@
 
 #include "Platform/Thread.h"
 #include "Rendering/RendererUtil.h"
+#include "Engine/RenderStatistics.h"
 
 #include "RenderingD3D9/D3D9BlendState.h"
 #include "RenderingD3D9/D3D9ConstantBuffer.h"
@@ -20,6 +21,8 @@
 #include "RenderingD3D9/D3D9SamplerState.h"
 #include "RenderingD3D9/D3D9StaticTexture2d.h"
 #include "RenderingD3D9/D3D9SubContext.h"
+#include "RenderingD3D9/D3D9TimerQuery.h"
+#include "RenderingD3D9/D3D9UploadQueue.h"
 #include "RenderingD3D9/D3D9VertexDescription.h"
 #include "RenderingD3D9/D3D9VertexInputLayout.h"
 #include "RenderingD3D9/D3D9VertexShader.h"
@@ -62,8 +65,10 @@ D3D9Renderer::D3D9Renderer()
 	, m_pD3DDevice( NULL )
 	, m_bExDevice( false )
 	, m_bLost( false )
+	, m_timerQueryFrequency( 0 )
 	, m_depthTextureFormat( D3DFMT_UNKNOWN )
 	, m_pDeviceResetListenerHead( NULL )
+	, m_pUploadQueue( NULL )
 {
 }
 
@@ -201,6 +206,13 @@ void D3D9Renderer::Cleanup()
 	m_spMainContext.Release();
 	m_spImmediateCommandProxy.Release();
 
+	// Release the upload queue before the static texture map target pools, as discarding pending texture uploads
+	// returns their staging textures to the pools.
+	delete m_pUploadQueue;
+	m_pUploadQueue = NULL;
+
+	ClearVertexInputCache();
+
 	for( size_t mapPoolIndex = 0; mapPoolIndex < HELIUM_ARRAY_COUNT( m_staticTextureMapTargetPools ); ++mapPoolIndex )
 	{
 		DynamicArray< IDirect3DTexture9* >* pTextureMapPools = m_staticTextureMapTargetPools[ mapPoolIndex ];
@@ -270,6 +282,13 @@ bool D3D9Renderer::CreateMainContext( const ContextInitParameters& rInitParamete
 		return false;
 	}
 
+	// Direct3D only serializes access to the device if asked to, as doing so adds some overhead to every call.
+	DWORD behaviorFlags = D3DCREATE_HARDWARE_VERTEXPROCESSING;
+	if( rInitParameters.bMultithreaded )
+	{
+		behaviorFlags |= D3DCREATE_MULTITHREADED;
+	}
+
 	HRESULT createResult;
 	if( m_bExDevice )
 	{
@@ -278,7 +297,7 @@ bool D3D9Renderer::CreateMainContext( const ContextInitParameters& rInitParamete
 			D3DADAPTER_DEFAULT,
 			D3DDEVTYPE_HAL,
 			static_cast< HWND >( rInitParameters.pWindow ),
-			D3DCREATE_HARDWARE_VERTEXPROCESSING,
+			behaviorFlags,
 			&m_presentParameters,
 			( rInitParameters.bFullscreen ? &m_fullscreenDisplayMode : NULL ),
 			&pD3DDeviceEx );
@@ -291,7 +310,7 @@ bool D3D9Renderer::CreateMainContext( const ContextInitParameters& rInitParamete
 			D3DADAPTER_DEFAULT,
 			D3DDEVTYPE_HAL,
 			static_cast< HWND >( rInitParameters.pWindow ),
-			D3DCREATE_HARDWARE_VERTEXPROCESSING,
+			behaviorFlags,
 			&m_presentParameters,
 			&m_pD3DDevice );
 	}
@@ -305,23 +324,52 @@ bool D3D9Renderer::CreateMainContext( const ContextInitParameters& rInitParamete
 
 	HELIUM_ASSERT( m_pD3DDevice );
 
+	if( rInitParameters.bMultithreaded )
+	{
+		m_featureFlags |= RENDERER_FEATURE_FLAG_MULTITHREADED;
+	}
+
+	// Timestamp queries can only be checked for support once the device exists (passing a null query pointer only
+	// tests whether the query type is supported).
+	if( SUCCEEDED( m_pD3DDevice->CreateQuery( D3DQUERYTYPE_TIMESTAMP, NULL ) ) &&
+		SUCCEEDED( m_pD3DDevice->CreateQuery( D3DQUERYTYPE_TIMESTAMPFREQ, NULL ) ) )
+	{
+		m_featureFlags |= RENDERER_FEATURE_FLAG_TIMER_QUERY;
+	}
+	else
+	{
+		HELIUM_TRACE(
+			TraceLevels::Warning,
+			"D3D9Renderer: Timestamp queries not supported.  GPU pass timings will not be provided.\n" );
+	}
+
 	HELIUM_TRACE(
 		TraceLevels::Info,
-		"D3D9Renderer: Display context created:\n- Dimensions: %ux%u\n- Multisample count: %u\n- Fullscreen: %d\n- VSync: %d\n",
+		"D3D9Renderer: Display context created:\n- Dimensions: %ux%u\n- Multisample count: %u\n- Fullscreen: %d\n- Present mode: %d\n- Frame rate limit: %u\n",
 		rInitParameters.displayWidth,
 		rInitParameters.displayHeight,
 		rInitParameters.multisampleCount,
 		static_cast< int32_t >( rInitParameters.bFullscreen ),
-		static_cast< int32_t >( rInitParameters.bVsync ) );
+		static_cast< int32_t >( rInitParameters.presentMode ),
+		rInitParameters.frameRateLimit );
 
 	// Create the immediate render command proxy interface.
 	m_spImmediateCommandProxy = new D3D9ImmediateCommandProxy( m_pD3DDevice );
 	HELIUM_ASSERT( m_spImmediateCommandProxy );
 
 	// Create the main rendering context interface.
-	m_spMainContext = new D3D9MainContext( m_pD3DDevice );
+	m_spMainContext = new D3D9MainContext( m_pD3DDevice, rInitParameters.frameRateLimit );
 	HELIUM_ASSERT( m_spMainContext );
 
+	// Static resources can only be allocated in the default pool with Direct3D 9Ex, so have their uploads go through
+	// the upload queue instead of being copied over by whichever thread unmaps them.
+	if( m_bExDevice )
+	{
+		m_pUploadQueue = new D3D9UploadQueue;
+		HELIUM_ASSERT( m_pUploadQueue );
+		RegisterDeviceResetListener( m_pUploadQueue );
+	}
+
 	return true;
 }
 
@@ -362,6 +410,7 @@ bool D3D9Renderer::ResetMainContext( const ContextInitParameters& rInitParameter
 	{
 		m_presentParameters = presentParameters;
 		m_fullscreenDisplayMode = fullscreenDisplayMode;
+		m_spMainContext->SetFrameRateLimit( rInitParameters.frameRateLimit );
 	}
 
 	return bResetSuccess;
@@ -626,6 +675,9 @@ RSurface* D3D9Renderer::CreateDepthStencilSurface(
 	}
 
 	HELIUM_ASSERT( pSurface );
+	pSurface->SetTrackedMemory(
+		RRenderResource::MEMORY_CATEGORY_SURFACE,
+		static_cast< size_t >( width ) * height * 4 * Max< uint32_t >( multisampleCount, 1 ) );
 
 	pD3DSurface->Release();
 
@@ -657,6 +709,7 @@ RVertexShader* D3D9Renderer::CreateVertexShader( size_t size, const void* pData
 
 		D3D9VertexShader* pShader = new D3D9VertexShader( pD3DShader, false );
 		HELIUM_ASSERT( pShader );
+		pShader->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
 
 		pD3DShader->Release();
 
@@ -677,6 +730,7 @@ RVertexShader* D3D9Renderer::CreateVertexShader( size_t size, const void* pData
 
 	D3D9VertexShader* pShader = new D3D9VertexShader( pStaging, true );
 	HELIUM_ASSERT( pShader );
+	pShader->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
 
 	return pShader;
 }
@@ -704,6 +758,7 @@ RPixelShader* D3D9Renderer::CreatePixelShader( size_t size, const void* pData )
 
 		D3D9PixelShader* pShader = new D3D9PixelShader( pD3DShader, false );
 		HELIUM_ASSERT( pShader );
+		pShader->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
 
 		pD3DShader->Release();
 
@@ -724,6 +779,7 @@ RPixelShader* D3D9Renderer::CreatePixelShader( size_t size, const void* pData )
 
 	D3D9PixelShader* pShader = new D3D9PixelShader( pStaging, true );
 	HELIUM_ASSERT( pShader );
+	pShader->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
 
 	return pShader;
 }
@@ -793,6 +849,11 @@ RVertexBuffer* D3D9Renderer::CreateVertexBuffer( size_t size, ERendererBufferUsa
 	}
 
 	HELIUM_ASSERT( pBuffer );
+	pBuffer->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_VERTEX_BUFFER, size );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, pBuffer->GetTrackedMemorySize() );
+	}
 
 	pD3DBuffer->Release();
 
@@ -873,6 +934,11 @@ RIndexBuffer* D3D9Renderer::CreateIndexBuffer(
 	}
 
 	HELIUM_ASSERT( pBuffer );
+	pBuffer->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_INDEX_BUFFER, size );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, pBuffer->GetTrackedMemorySize() );
+	}
 
 	pD3DBuffer->Release();
 
@@ -926,6 +992,13 @@ RConstantBuffer* D3D9Renderer::CreateConstantBuffer(
 	// Create the buffer interface.
 	D3D9ConstantBuffer* pBuffer = new D3D9ConstantBuffer( pBufferMemory, static_cast< uint16_t >( registerCount ) );
 	HELIUM_ASSERT( pBuffer );
+	pBuffer->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_CONSTANT_BUFFER, actualSize );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload(
+			RenderStatistics::COUNTER_CONSTANT_BUFFER_BYTES,
+			pBuffer->GetTrackedMemorySize() );
+	}
 
 	return pBuffer;
 }
@@ -1162,12 +1235,29 @@ RTexture2d* D3D9Renderer::CreateTexture2d(
 	}
 
 	HELIUM_ASSERT( pTexture );
+	pTexture->SetTrackedMemory(
+		RRenderResource::MEMORY_CATEGORY_TEXTURE,
+		RendererUtil::GetTexture2dMemorySize( width, height, mipCount, format ) );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_TEXTURE_BYTES, pTexture->GetTrackedMemorySize() );
+	}
 
 	pD3DTexture->Release();
 
 	return pTexture;
 }
 
+/// @copydoc Renderer::CreateGpuCullingBatch()
+RGpuCullingBatch* D3D9Renderer::CreateGpuCullingBatch( uint32_t /*objectCapacity*/, uint32_t /*drawCapacity*/ )
+{
+	HELIUM_TRACE(
+		TraceLevels::Error,
+		"D3D9Renderer::CreateGpuCullingBatch(): GPU-driven culling is not supported by the Direct3D 9 renderer.\n" );
+
+	return NULL;
+}
+
 /// @copydoc Renderer::CreateFence()
 RFence* D3D9Renderer::CreateFence()
 {
@@ -1252,6 +1342,113 @@ bool D3D9Renderer::TrySyncFence( RFence* pFence )
 	return ( syncResult != S_FALSE );
 }
 
+/// @copydoc Renderer::CreateTimerQuery()
+RTimerQuery* D3D9Renderer::CreateTimerQuery()
+{
+	if( !SupportsAllFeatures( RENDERER_FEATURE_FLAG_TIMER_QUERY ) )
+	{
+		return NULL;
+	}
+
+	IDirect3DQuery9* pD3DQuery = NULL;
+	HRESULT createResult = m_pD3DDevice->CreateQuery( D3DQUERYTYPE_TIMESTAMP, &pD3DQuery );
+	if( FAILED( createResult ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"D3D9Renderer::CreateTimerQuery(): Failed to create Direct3D timestamp query instance (error code: 0x%x).\n",
+			createResult );
+
+		return NULL;
+	}
+
+	D3D9TimerQuery* pQuery = new D3D9TimerQuery( pD3DQuery );
+	HELIUM_ASSERT( pQuery );
+
+	RegisterDeviceResetListener( pQuery );
+
+	pD3DQuery->Release();
+
+	return pQuery;
+}
+
+/// @copydoc Renderer::TryGetTimerQueryTimestamp()
+bool D3D9Renderer::TryGetTimerQueryTimestamp( RTimerQuery* pQuery, uint64_t& rTimestamp )
+{
+	HELIUM_ASSERT( pQuery );
+
+	IDirect3DQuery9* pD3DQuery = static_cast< D3D9TimerQuery* >( pQuery )->GetQuery();
+	if( !pD3DQuery )
+	{
+		// Direct3D query interface was released due to a device reset, so the result is lost.
+		return false;
+	}
+
+	UINT64 timestamp = 0;
+	HRESULT queryResult = pD3DQuery->GetData( &timestamp, sizeof( timestamp ), 0 );
+	if( queryResult != S_OK )
+	{
+		return false;
+	}
+
+	rTimestamp = static_cast< uint64_t >( timestamp );
+
+	return true;
+}
+
+/// @copydoc Renderer::GetTimerQueryFrequency()
+uint64_t D3D9Renderer::GetTimerQueryFrequency()
+{
+	if( m_timerQueryFrequency != 0 || !SupportsAllFeatures( RENDERER_FEATURE_FLAG_TIMER_QUERY ) )
+	{
+		return m_timerQueryFrequency;
+	}
+
+	// The frequency is only queried once and cached.  It can change if the GPU clock changes, but keeping a frequency
+	// query and disjoint query in flight every frame is not worth the cost for profiling purposes.
+	IDirect3DQuery9* pD3DQuery = NULL;
+	HRESULT createResult = m_pD3DDevice->CreateQuery( D3DQUERYTYPE_TIMESTAMPFREQ, &pD3DQuery );
+	if( FAILED( createResult ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"D3D9Renderer::GetTimerQueryFrequency(): Failed to create Direct3D timestamp frequency query (error code: 0x%x).\n",
+			createResult );
+
+		return 0;
+	}
+
+	HELIUM_D3D9_VERIFY( pD3DQuery->Issue( D3DISSUE_END ) );
+
+	UINT64 frequency = 0;
+	for( ; ; )
+	{
+		HRESULT queryResult = pD3DQuery->GetData( &frequency, sizeof( frequency ), D3DGETDATA_FLUSH );
+		if( queryResult != S_FALSE )
+		{
+			if( queryResult != S_OK )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Error,
+					"D3D9Renderer::GetTimerQueryFrequency(): Failed to read timestamp frequency (error code: 0x%x).\n",
+					queryResult );
+
+				frequency = 0;
+			}
+
+			break;
+		}
+
+		Thread::Yield();
+	}
+
+	pD3DQuery->Release();
+
+	m_timerQueryFrequency = static_cast< uint64_t >( frequency );
+
+	return m_timerQueryFrequency;
+}
+
 /// @copydoc Renderer::GetImmediateCommandProxy()
 RRenderCommandProxy* D3D9Renderer::GetImmediateCommandProxy()
 {
@@ -1275,6 +1472,15 @@ void D3D9Renderer::Flush()
 	SyncFence( spFence );
 }
 
+/// @copydoc Renderer::ProcessResourceUploads()
+void D3D9Renderer::ProcessResourceUploads()
+{
+	if( m_pUploadQueue && !m_bLost )
+	{
+		m_pUploadQueue->Process();
+	}
+}
+
 /// Notify this renderer that a call on another resource has signaled that we have lost the device.
 void D3D9Renderer::NotifyLost()
 {
@@ -1506,7 +1712,12 @@ D3DFORMAT D3D9Renderer::PixelFormatToD3DFormat( ERendererPixelFormat format ) co
 		D3DFMT_DXT3,           // RENDERER_PIXEL_FORMAT_BC2_SRGB
 		D3DFMT_DXT5,           // RENDERER_PIXEL_FORMAT_BC3
 		D3DFMT_DXT5,           // RENDERER_PIXEL_FORMAT_BC3_SRGB
+		D3DFMT_UNKNOWN,        // RENDERER_PIXEL_FORMAT_BC4 (not supported)
+		D3DFMT_UNKNOWN,        // RENDERER_PIXEL_FORMAT_BC5 (not supported)
+		D3DFMT_UNKNOWN,        // RENDERER_PIXEL_FORMAT_BC7 (not supported)
+		D3DFMT_UNKNOWN,        // RENDERER_PIXEL_FORMAT_BC7_SRGB (not supported)
 		D3DFMT_A16B16G16R16F,  // RENDERER_PIXEL_FORMAT_R16G16B16A16_FLOAT
+		D3DFMT_A32B32G32R32F,  // RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT
 		D3DFMT_UNKNOWN         // RENDERER_PIXEL_FORMAT_DEPTH (dummy entry; depth formats handled manually)
 	};
 
@@ -1718,8 +1929,12 @@ bool D3D9Renderer::GetPresentParameters(
 	rParameters.EnableAutoDepthStencil = FALSE;
 	rParameters.Flags = 0;
 	rParameters.FullScreen_RefreshRateInHz = fullscreenRefreshRate;
+
+	// Direct3D 9 has no equivalent of adaptive vsync, so it falls back to regular vsync.
 	rParameters.PresentationInterval =
-		rContextInitParameters.bVsync ? D3DPRESENT_INTERVAL_ONE : D3DPRESENT_INTERVAL_IMMEDIATE;
+		( rContextInitParameters.presentMode == RENDERER_PRESENT_MODE_IMMEDIATE
+		  ? D3DPRESENT_INTERVAL_IMMEDIATE
+		  : D3DPRESENT_INTERVAL_ONE );
 
 	return true;
 }
@@ -1767,6 +1982,11 @@ ERendererPixelFormat D3D9Renderer::D3DFormatToPixelFormat( D3DFORMAT d3dFormat,
 			return RENDERER_PIXEL_FORMAT_R16G16B16A16_FLOAT;
 		}
 
+	case D3DFMT_A32B32G32R32F:
+		{
+			return RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT;
+		}
+
 	case D3DFMT_D24X8:
 	case D3DFMT_D16:
 	case MAKEFOURCC( 'D', 'F', '2', '4' ):
@@ -1822,6 +2042,13 @@ HRESULT D3D9Renderer::ResetDevice( D3DPRESENT_PARAMETERS& rPresentParameters, D3
 
 	m_bLost = false;
 
+	// Device state is restored to its defaults by a reset, so any state tracked for filtering redundant binds is no
+	// longer valid.
+	if( m_spImmediateCommandProxy )
+	{
+		m_spImmediateCommandProxy->ResetStateFilter();
+	}
+
 	if( resetResult == D3DERR_DEVICELOST )
 	{
 		NotifyLost();
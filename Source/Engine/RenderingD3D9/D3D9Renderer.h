@@ -63,6 +63,7 @@
 namespace Helium
 {
 	class D3D9DeviceResetListener;
+	class D3D9UploadQueue;
 
 	HELIUM_DECLARE_RPTR( D3D9ImmediateCommandProxy );
 	HELIUM_DECLARE_RPTR( D3D9MainContext );
@@ -119,6 +120,8 @@ namespace Helium
 		RTexture2d* CreateTexture2d(
 			uint32_t width, uint32_t height, uint32_t mipCount, ERendererPixelFormat format, ERendererBufferUsage usage,
 			const RTexture2d::CreateData* pData );
+
+		RGpuCullingBatch* CreateGpuCullingBatch( uint32_t objectCapacity, uint32_t drawCapacity );
 		//@}
 
 		/// @name Deferred Query Allocation
@@ -126,6 +129,10 @@ namespace Helium
 		RFence* CreateFence();
 		void SyncFence( RFence* pFence );
 		bool TrySyncFence( RFence* pFence );
+
+		RTimerQuery* CreateTimerQuery();
+		bool TryGetTimerQueryTimestamp( RTimerQuery* pQuery, uint64_t& rTimestamp );
+		uint64_t GetTimerQueryFrequency();
 		//@}
 
 		/// @name Command Interfaces
@@ -136,6 +143,13 @@ namespace Helium
 		void Flush();
 		//@}
 
+		/// @name Resource Uploading
+		//@{
+		void ProcessResourceUploads();
+
+		inline D3D9UploadQueue* GetUploadQueue() const;
+		//@}
+
 		/// @name Data Access
 		//@{
 		inline IDirect3D9* GetD3D() const;
@@ -195,6 +209,9 @@ namespace Helium
 		/// True if the device has been signaled that it has been lost (NotifyLost() has been called).
 		bool m_bLost;
 
+		/// Timer query tick frequency, or zero if it has not been queried yet.
+		uint64_t m_timerQueryFrequency;
+
 		/// Immediate render command proxy.
 		D3D9ImmediateCommandProxyPtr m_spImmediateCommandProxy;
 		/// Main rendering context.
@@ -215,6 +232,9 @@ namespace Helium
 		/// Device reset listener list head.
 		D3D9DeviceResetListener* m_pDeviceResetListenerHead;
 
+		/// Queue of deferred uploads to static default pool resources (Direct3D 9Ex only).
+		D3D9UploadQueue* m_pUploadQueue;
+
 		/// GUID associated with engine-specific private data stored in Direct3D resources.
 		static const GUID sm_privateDataGuid;
 
@@ -40,6 +40,16 @@ namespace Helium
         return m_depthTextureFormat;
     }
 
+    /// Get the queue of deferred uploads to static default pool resources.
+    ///
+    /// @return  Upload queue, or null if resources are uploaded directly (when not using a Direct3D 9Ex device).
+    ///
+    /// @see ProcessResourceUploads()
+    D3D9UploadQueue* D3D9Renderer::GetUploadQueue() const
+    {
+        return m_pUploadQueue;
+    }
+
     /// Get the GUID associated with private data stored by the engine in Direct3D resources.
     ///
     /// @return  GUID for Direct3D resource private data.
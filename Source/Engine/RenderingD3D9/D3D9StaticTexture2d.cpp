@@ -1,6 +1,11 @@
 #include "Precompile.h"
 #include "RenderingD3D9/D3D9StaticTexture2d.h"
 
+#include "Platform/Atomic.h"
+#include "Rendering/RendererUtil.h"
+#include "RenderingD3D9/D3D9UploadQueue.h"
+#include "Engine/RenderStatistics.h"
+
 using namespace Helium;
 
 /// Constructor.
@@ -13,6 +18,7 @@ D3D9StaticTexture2d::D3D9StaticTexture2d( IDirect3DTexture9* pD3DTexture, bool b
 , m_pMappedTexture( NULL )
 , m_baseMipLevel( 0 )
 , m_mapCount( 0 )
+, m_pendingUploadCount( 0 )
 , m_bIsMappedTexturePooled( false )
 {
 }
@@ -117,6 +123,10 @@ void* D3D9StaticTexture2d::Map( uint32_t mipLevel, size_t& rPitch, ERendererBuff
 
     rPitch = static_cast< size_t >( lockedRect.Pitch );
 
+    RenderStatistics::RecordUpload(
+        RenderStatistics::COUNTER_TEXTURE_BYTES,
+        rPitch * RendererUtil::PixelToBlockRowCount( GetHeight( mipLevel ), GetPixelFormat() ) );
+
     return lockedRect.pBits;
 }
 
@@ -142,33 +152,33 @@ void D3D9StaticTexture2d::Unmap( uint32_t mipLevel )
             result );
     }
 
-    // Copy over the mip level contents.
-    IDirect3DSurface9* pSourceSurface;
-    HELIUM_D3D9_VERIFY( m_pMappedTexture->GetSurfaceLevel( mappedMipLevel, &pSourceSurface ) );
-    HELIUM_ASSERT( pSourceSurface );
-
-    IDirect3DSurface9* pDestSurface;
-    HELIUM_D3D9_VERIFY( m_pTexture->GetSurfaceLevel( mipLevel, &pDestSurface ) );
-    HELIUM_ASSERT( pDestSurface );
-
+    // Queue the copy to the texture itself with the renderer, which makes it on the render thread within its
+    // per-frame upload budget.  The staging texture is kept mapped until the copy has been made.
     D3D9Renderer* pRenderer = static_cast< D3D9Renderer* >( Renderer::GetInstance() );
     HELIUM_ASSERT( pRenderer );
 
-    IDirect3DDevice9* pD3DDevice = pRenderer->GetD3DDevice();
-    HELIUM_ASSERT( pD3DDevice );
-
-    result = pD3DDevice->UpdateSurface( pSourceSurface, NULL, pDestSurface, NULL );
-    if( FAILED( result ) )
+    D3D9UploadQueue* pUploadQueue = pRenderer->GetUploadQueue();
+    if( pUploadQueue )
     {
-        HELIUM_TRACE( TraceLevels::Error, "D3D9StaticTexture2d::Unmap(): Failed to update unmapped texture data.\n" );
-    }
+        AtomicIncrementRelease( m_pendingUploadCount );
+        pUploadQueue->QueueTextureUpload(
+            this,
+            mipLevel,
+            RendererUtil::GetTexture2dMemorySize( GetWidth( mipLevel ), GetHeight( mipLevel ), 1, GetPixelFormat() ) );
 
-    pSourceSurface->Release();
-    pDestSurface->Release();
+        return;
+    }
 
+    CopyMipLevel( mipLevel );
     DecrementMapCount();
 }
 
+/// @copydoc RRenderResource::IsUploadPending()
+bool D3D9StaticTexture2d::IsUploadPending() const
+{
+    return ( m_pendingUploadCount != 0 );
+}
+
 /// Handle decrementing the resource map count, releasing any allocated texture resources as necessary.
 void D3D9StaticTexture2d::DecrementMapCount()
 {
@@ -183,11 +193,68 @@ void D3D9StaticTexture2d::DecrementMapCount()
             HELIUM_ASSERT( pRenderer );
 
             pRenderer->ReleasePooledStaticTextureMapTarget( m_pMappedTexture, m_bSrgb );
-            m_pMappedTexture = NULL;
         }
         else
         {
             m_pMappedTexture->Release();
         }
+
+        m_pMappedTexture = NULL;
     }
 }
+
+/// Copy the contents of a mip level from the staging texture to the texture itself.
+///
+/// @param[in] mipLevel  Index of the mip level to copy.
+void D3D9StaticTexture2d::CopyMipLevel( uint32_t mipLevel )
+{
+    HELIUM_ASSERT( m_pMappedTexture );
+
+    uint32_t mappedMipLevel = static_cast< uint32_t >( m_baseMipLevel ) + mipLevel;
+
+    IDirect3DSurface9* pSourceSurface;
+    HELIUM_D3D9_VERIFY( m_pMappedTexture->GetSurfaceLevel( mappedMipLevel, &pSourceSurface ) );
+    HELIUM_ASSERT( pSourceSurface );
+
+    IDirect3DSurface9* pDestSurface;
+    HELIUM_D3D9_VERIFY( m_pTexture->GetSurfaceLevel( mipLevel, &pDestSurface ) );
+    HELIUM_ASSERT( pDestSurface );
+
+    D3D9Renderer* pRenderer = static_cast< D3D9Renderer* >( Renderer::GetInstance() );
+    HELIUM_ASSERT( pRenderer );
+
+    IDirect3DDevice9* pD3DDevice = pRenderer->GetD3DDevice();
+    HELIUM_ASSERT( pD3DDevice );
+
+    HRESULT result = pD3DDevice->UpdateSurface( pSourceSurface, NULL, pDestSurface, NULL );
+    if( FAILED( result ) )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "D3D9StaticTexture2d::CopyMipLevel(): Failed to update mip level %" PRIu32 " (error code 0x%x).\n",
+            mipLevel,
+            result );
+    }
+
+    pSourceSurface->Release();
+    pDestSurface->Release();
+}
+
+/// Finish a mip level upload queued by Unmap().
+///
+/// This is called by D3D9UploadQueue on the render thread.
+///
+/// @param[in] mipLevel  Index of the mip level to upload.
+/// @param[in] bCopy     True to copy the mip level contents, false to discard them.
+void D3D9StaticTexture2d::CommitMipLevel( uint32_t mipLevel, bool bCopy )
+{
+    if( bCopy )
+    {
+        CopyMipLevel( mipLevel );
+    }
+
+    DecrementMapCount();
+
+    HELIUM_ASSERT( m_pendingUploadCount != 0 );
+    AtomicDecrementRelease( m_pendingUploadCount );
+}
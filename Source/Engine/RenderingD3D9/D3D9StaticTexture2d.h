@@ -12,8 +12,13 @@ namespace Helium
     ///
     /// Note that we only ever copy from the staging area to the texture itself, so a given texture mip level must
     /// always be fully updated when locked.
+    ///
+    /// Copies from the staging area are queued with the renderer's D3D9UploadQueue when a mip level is unmapped, so
+    /// the staging texture stays alive until every unmapped mip level has been uploaded.
     class D3D9StaticTexture2d : public D3D9Texture2d
     {
+        friend class D3D9UploadQueue;
+
     public:
         /// @name Construction/Destruction
         //@{
@@ -24,6 +29,8 @@ namespace Helium
         //@{
         void* Map( uint32_t mipLevel, size_t& rPitch, ERendererBufferMapHint hint );
         void Unmap( uint32_t mipLevel );
+
+        bool IsUploadPending() const;
         //@}
 
     protected:
@@ -31,8 +38,10 @@ namespace Helium
         IDirect3DTexture9* m_pMappedTexture;
         /// Base mip level in the mapped texture.
         uint8_t m_baseMipLevel;
-        /// Current number of active Map() calls than have not yet been unmapped.
+        /// Current number of active Map() calls than have not yet been unmapped or uploaded.
         uint8_t m_mapCount;
+        /// Number of unmapped mip levels waiting in the upload queue.
+        volatile int32_t m_pendingUploadCount;
         /// True if the mapped texture is a pooled mapped texture.
         bool m_bIsMappedTexturePooled;
 
@@ -45,5 +54,11 @@ namespace Helium
         //@{
         void DecrementMapCount();
         //@}
+
+        /// @name Staging Area Uploading
+        //@{
+        void CopyMipLevel( uint32_t mipLevel );
+        void CommitMipLevel( uint32_t mipLevel, bool bCopy );
+        //@}
     };
 }
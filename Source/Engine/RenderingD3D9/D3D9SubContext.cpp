@@ -65,6 +65,50 @@ void D3D9SubContext::Swap()
     }
 }
 
+/// @copydoc RRenderContext::Resize()
+///
+/// Only the additional swap chain of this context is recreated at the new size; the device and its resources are left
+/// untouched.
+bool D3D9SubContext::Resize( uint32_t width, uint32_t height )
+{
+    if( width == 0 || height == 0 ||
+        ( m_cachedPresentParameters.BackBufferWidth == width && m_cachedPresentParameters.BackBufferHeight == height ) )
+    {
+        return true;
+    }
+
+    D3D9Renderer* pRenderer = static_cast< D3D9Renderer* >( Renderer::GetInstance() );
+    HELIUM_ASSERT( pRenderer );
+    IDirect3DDevice9* pDevice = pRenderer->GetD3DDevice();
+    HELIUM_ASSERT( pDevice );
+
+    D3DPRESENT_PARAMETERS presentParameters = m_cachedPresentParameters;
+    presentParameters.BackBufferWidth = width;
+    presentParameters.BackBufferHeight = height;
+
+    IDirect3DSwapChain9* pSwapChain = NULL;
+    if( FAILED( pDevice->CreateAdditionalSwapChain( &presentParameters, &pSwapChain ) ) )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "D3D9SubContext: Failed to resize swap chain to %" PRIu32 "x%" PRIu32 ".\n",
+            width,
+            height );
+
+        return false;
+    }
+
+    m_spBackBufferSurface.Release();
+
+    HELIUM_ASSERT( m_pSwapChain );
+    m_pSwapChain->Release();
+    m_pSwapChain = pSwapChain;
+
+    HELIUM_D3D9_VERIFY( pSwapChain->GetPresentParameters( &m_cachedPresentParameters ) );
+
+    return true;
+}
+
 /// @copydoc D3D9DeviceResetListener::OnPreReset()
 void D3D9SubContext::OnPreReset()
 {
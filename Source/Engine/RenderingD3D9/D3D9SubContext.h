@@ -22,6 +22,8 @@ namespace Helium
         //@{
         RSurface* GetBackBufferSurface();
         void Swap();
+
+        bool Resize( uint32_t width, uint32_t height );
         //@}
 
         /// @name Device Reset Event Handlers
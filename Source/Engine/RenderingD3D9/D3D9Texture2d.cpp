@@ -3,6 +3,9 @@
 
 #include "RenderingD3D9/D3D9Surface.h"
 
+#include "Rendering/RendererUtil.h"
+#include "Engine/RenderStatistics.h"
+
 using namespace Helium;
 
 /// Constructor.
@@ -67,6 +70,10 @@ void* D3D9Texture2d::Map( uint32_t mipLevel, size_t& rPitch, ERendererBufferMapH
 
     rPitch = static_cast< size_t >( lockedRect.Pitch );
 
+    RenderStatistics::RecordUpload(
+        RenderStatistics::COUNTER_TEXTURE_BYTES,
+        rPitch * RendererUtil::PixelToBlockRowCount( GetHeight( mipLevel ), GetPixelFormat() ) );
+
     return lockedRect.pBits;
 }
 
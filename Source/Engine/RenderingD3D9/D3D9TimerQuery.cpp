@@ -0,0 +1,58 @@
+#include "Precompile.h"
+#include "RenderingD3D9/D3D9TimerQuery.h"
+
+#include "RenderingD3D9/D3D9Renderer.h"
+
+using namespace Helium;
+
+/// Constructor.
+///
+/// @param[in] pD3DQuery  Direct3D timestamp query interface to wrap.  Its reference count will be incremented when
+///                       this object is constructed and decremented back when this object is destroyed.
+D3D9TimerQuery::D3D9TimerQuery( IDirect3DQuery9* pD3DQuery )
+: m_pQuery( pD3DQuery )
+{
+    HELIUM_ASSERT( pD3DQuery );
+    pD3DQuery->AddRef();
+}
+
+/// Destructor.
+D3D9TimerQuery::~D3D9TimerQuery()
+{
+    if( m_pQuery )
+    {
+        m_pQuery->Release();
+    }
+}
+
+/// @copydoc D3D9DeviceResetListener::OnPreReset()
+void D3D9TimerQuery::OnPreReset()
+{
+    if( m_pQuery )
+    {
+        m_pQuery->Release();
+        m_pQuery = NULL;
+    }
+}
+
+/// @copydoc D3D9DeviceResetListener::OnPostReset()
+void D3D9TimerQuery::OnPostReset( D3D9Renderer* pRenderer )
+{
+    // Unlike fences, timer queries are reused every frame, so the query is recreated (any pending result is lost).
+    HELIUM_ASSERT( pRenderer );
+    HELIUM_ASSERT( !m_pQuery );
+
+    IDirect3DDevice9* pD3DDevice = pRenderer->GetD3DDevice();
+    HELIUM_ASSERT( pD3DDevice );
+
+    HRESULT createResult = pD3DDevice->CreateQuery( D3DQUERYTYPE_TIMESTAMP, &m_pQuery );
+    if( FAILED( createResult ) )
+    {
+        HELIUM_TRACE(
+            TraceLevels::Error,
+            "D3D9TimerQuery::OnPostReset(): Failed to recreate Direct3D timestamp query (error code: 0x%x).\n",
+            createResult );
+
+        m_pQuery = NULL;
+    }
+}
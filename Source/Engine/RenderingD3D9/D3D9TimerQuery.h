@@ -0,0 +1,41 @@
+#pragma once
+
+#include "RenderingD3D9/RenderingD3D9.h"
+#include "Rendering/RTimerQuery.h"
+
+#include "RenderingD3D9/D3D9DeviceResetListener.h"
+
+namespace Helium
+{
+    /// Direct3D 9 GPU timestamp query implementation.
+    class D3D9TimerQuery : public RTimerQuery, public D3D9DeviceResetListener
+    {
+    public:
+        /// @name Construction/Destruction
+        //@{
+        explicit D3D9TimerQuery( IDirect3DQuery9* pD3DQuery );
+        //@}
+
+        /// @name Data Access
+        //@{
+        inline IDirect3DQuery9* GetQuery() const;
+        //@}
+
+        /// @name Device Reset Event Handlers
+        //@{
+        void OnPreReset();
+        void OnPostReset( D3D9Renderer* pRenderer );
+        //@}
+
+    protected:
+        /// Direct3D timestamp query interface.
+        IDirect3DQuery9* m_pQuery;
+
+        /// @name Construction/Destruction
+        //@{
+        ~D3D9TimerQuery();
+        //@}
+    };
+}
+
+#include "RenderingD3D9/D3D9TimerQuery.inl"
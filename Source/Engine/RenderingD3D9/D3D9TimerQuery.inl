@@ -0,0 +1,10 @@
+namespace Helium
+{
+    /// Get the Direct3D timestamp query instance associated with this timer query.
+    ///
+    /// @return  Direct3D timestamp query instance, or null if the query was released due to a device reset.
+    IDirect3DQuery9* D3D9TimerQuery::GetQuery() const
+    {
+        return m_pQuery;
+    }
+}
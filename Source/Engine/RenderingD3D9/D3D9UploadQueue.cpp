@@ -0,0 +1,224 @@
+#include "Precompile.h"
+#include "RenderingD3D9/D3D9UploadQueue.h"
+
+#include "RenderingD3D9/D3D9IndexBuffer.h"
+#include "RenderingD3D9/D3D9StaticTexture2d.h"
+#include "RenderingD3D9/D3D9VertexBuffer.h"
+
+using namespace Helium;
+
+/// Constructor.
+D3D9UploadQueue::D3D9UploadQueue()
+: m_frameByteBudget( DEFAULT_FRAME_BYTE_BUDGET )
+, m_bResetting( false )
+{
+}
+
+/// Destructor.
+D3D9UploadQueue::~D3D9UploadQueue()
+{
+    Discard();
+}
+
+/// Queue the upload of a static texture mip level from its mapped staging texture.
+///
+/// The texture keeps its staging texture until the upload has been made.
+///
+/// @param[in] pTexture  Texture to update.
+/// @param[in] mipLevel  Index of the mip level to upload.
+/// @param[in] size      Number of bytes in the mip level.
+void D3D9UploadQueue::QueueTextureUpload( D3D9StaticTexture2d* pTexture, uint32_t mipLevel, size_t size )
+{
+    HELIUM_ASSERT( pTexture );
+
+    QueueUpload( pTexture, ENTRY_TYPE_TEXTURE, mipLevel, NULL, size );
+}
+
+/// Queue the upload of a static vertex buffer from staging memory.
+///
+/// @param[in] pBuffer       Vertex buffer to update.
+/// @param[in] pStagingData  Buffer contents, allocated using DefaultAllocator.  The queue takes ownership of this
+///                          memory and frees it once the upload has been made.
+/// @param[in] size          Number of bytes to upload.
+void D3D9UploadQueue::QueueVertexBufferUpload( D3D9VertexBuffer* pBuffer, void* pStagingData, size_t size )
+{
+    HELIUM_ASSERT( pBuffer );
+    HELIUM_ASSERT( pStagingData );
+
+    QueueUpload( pBuffer, ENTRY_TYPE_VERTEX_BUFFER, 0, pStagingData, size );
+}
+
+/// Queue the upload of a static index buffer from staging memory.
+///
+/// @param[in] pBuffer       Index buffer to update.
+/// @param[in] pStagingData  Buffer contents, allocated using DefaultAllocator.  The queue takes ownership of this
+///                          memory and frees it once the upload has been made.
+/// @param[in] size          Number of bytes to upload.
+void D3D9UploadQueue::QueueIndexBufferUpload( D3D9IndexBuffer* pBuffer, void* pStagingData, size_t size )
+{
+    HELIUM_ASSERT( pBuffer );
+    HELIUM_ASSERT( pStagingData );
+
+    QueueUpload( pBuffer, ENTRY_TYPE_INDEX_BUFFER, 0, pStagingData, size );
+}
+
+/// Make the pending uploads for the current frame.
+///
+/// Uploads are made in the order in which they were queued until the frame byte budget is reached.  At least one
+/// upload is always made if any are pending, so resources larger than the budget still make progress.  This must
+/// only be called from the thread that owns the Direct3D device.
+///
+/// @see SetFrameByteBudget(), Discard()
+void D3D9UploadQueue::Process()
+{
+    if( m_bResetting )
+    {
+        return;
+    }
+
+    HELIUM_ASSERT( m_processEntries.IsEmpty() );
+
+    {
+        MutexScopeLock scopeLock( m_lock );
+
+        size_t entryCount = m_entries.GetSize();
+        size_t processCount = 0;
+        size_t byteCount = 0;
+        while( processCount < entryCount && ( processCount == 0 || byteCount < m_frameByteBudget ) )
+        {
+            byteCount += m_entries[ processCount ].size;
+            ++processCount;
+        }
+
+        if( processCount == 0 )
+        {
+            return;
+        }
+
+        m_processEntries.AddArray( m_entries.GetData(), processCount );
+        m_entries.Remove( 0, processCount );
+    }
+
+    // Make the uploads outside the lock so that loading threads can keep queuing uploads in the meantime.
+    size_t processCount = m_processEntries.GetSize();
+    for( size_t entryIndex = 0; entryIndex < processCount; ++entryIndex )
+    {
+        CommitEntry( m_processEntries[ entryIndex ], true );
+    }
+
+    m_processEntries.Resize( 0 );
+}
+
+/// Release all pending uploads without making them.
+///
+/// This is called when shutting down the renderer.  Resources with discarded uploads are left with undefined
+/// contents.
+///
+/// @see Process()
+void D3D9UploadQueue::Discard()
+{
+    MutexScopeLock scopeLock( m_lock );
+
+    size_t entryCount = m_entries.GetSize();
+    for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+    {
+        CommitEntry( m_entries[ entryIndex ], false );
+    }
+
+    m_entries.Clear();
+}
+
+/// Set the number of bytes to upload each frame.
+///
+/// @param[in] budget  Upload byte budget.
+///
+/// @see GetFrameByteBudget(), Process()
+void D3D9UploadQueue::SetFrameByteBudget( size_t budget )
+{
+    m_frameByteBudget = budget;
+}
+
+/// Get the number of bytes to upload each frame.
+///
+/// @return  Upload byte budget.
+///
+/// @see SetFrameByteBudget(), Process()
+size_t D3D9UploadQueue::GetFrameByteBudget() const
+{
+    return m_frameByteBudget;
+}
+
+/// @copydoc D3D9DeviceResetListener::OnPreReset()
+void D3D9UploadQueue::OnPreReset()
+{
+    // Staging data lives in system memory, so pending uploads can simply wait until the device is usable again.
+    m_bResetting = true;
+}
+
+/// @copydoc D3D9DeviceResetListener::OnPostReset()
+void D3D9UploadQueue::OnPostReset( D3D9Renderer* /*pRenderer*/ )
+{
+    m_bResetting = false;
+}
+
+/// Add an upload entry to the queue.
+///
+/// @param[in] pResource     Resource to update.
+/// @param[in] type          Entry type.
+/// @param[in] mipLevel      Texture mip level to upload (texture entries only).
+/// @param[in] pStagingData  Staging memory from which to copy (buffer entries only).
+/// @param[in] size          Number of bytes to upload.
+void D3D9UploadQueue::QueueUpload(
+    RRenderResource* pResource,
+    EEntryType type,
+    uint32_t mipLevel,
+    void* pStagingData,
+    size_t size )
+{
+    MutexScopeLock scopeLock( m_lock );
+
+    Entry* pEntry = m_entries.New();
+    HELIUM_ASSERT( pEntry );
+    pEntry->spResource = pResource;
+    pEntry->pStagingData = pStagingData;
+    pEntry->size = size;
+    pEntry->mipLevel = mipLevel;
+    pEntry->type = type;
+}
+
+/// Make or discard the upload for a given entry and release the entry's staging resources.
+///
+/// @param[in] rEntry  Upload entry.
+/// @param[in] bCopy   True to copy the staging data to the resource, false to only release the staging resources.
+void D3D9UploadQueue::CommitEntry( Entry& rEntry, bool bCopy )
+{
+    RRenderResource* pResource = rEntry.spResource;
+    HELIUM_ASSERT( pResource );
+
+    switch( rEntry.type )
+    {
+        case ENTRY_TYPE_TEXTURE:
+        {
+            static_cast< D3D9StaticTexture2d* >( pResource )->CommitMipLevel( rEntry.mipLevel, bCopy );
+
+            break;
+        }
+
+        case ENTRY_TYPE_VERTEX_BUFFER:
+        {
+            static_cast< D3D9VertexBuffer* >( pResource )->CommitStagingData( rEntry.pStagingData, bCopy );
+
+            break;
+        }
+
+        case ENTRY_TYPE_INDEX_BUFFER:
+        {
+            static_cast< D3D9IndexBuffer* >( pResource )->CommitStagingData( rEntry.pStagingData, bCopy );
+
+            break;
+        }
+    }
+
+    rEntry.pStagingData = NULL;
+    rEntry.spResource.Release();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "RenderingD3D9/D3D9DeviceResetListener.h"
+#include "Rendering/RRenderResource.h"
+
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+
+namespace Helium
+{
+    class D3D9StaticTexture2d;
+    class D3D9VertexBuffer;
+    class D3D9IndexBuffer;
+
+    /// Queue of pending copies from staging memory into Direct3D 9 default pool resources.
+    ///
+    /// Static resources in the default pool (the only pool available to static resources with Direct3D 9Ex) cannot be
+    /// filled directly without going through the device.  Rather than copying the data over as soon as a resource is
+    /// unmapped, which stalls whichever thread is loading the resource, unmapping a staged resource adds an entry to
+    /// this queue.  The renderer then copies the data over on the render thread once per frame (see Process()), up to a
+    /// byte budget to keep large streaming loads from hitching the frame.  Resources report themselves as having an
+    /// upload pending (RRenderResource::IsUploadPending()) until their queued copies have been made.
+    ///
+    /// Staging memory is always in system memory and the destination resources are never lost by a Direct3D 9Ex
+    /// device, so pending uploads are simply held back while the device is being reset.
+    class D3D9UploadQueue : public D3D9DeviceResetListener
+    {
+    public:
+        /// Default number of bytes to upload each frame.
+        static const size_t DEFAULT_FRAME_BYTE_BUDGET = 4 * 1024 * 1024;
+
+        /// @name Construction/Destruction
+        //@{
+        D3D9UploadQueue();
+        ~D3D9UploadQueue();
+        //@}
+
+        /// @name Upload Queuing
+        //@{
+        void QueueTextureUpload( D3D9StaticTexture2d* pTexture, uint32_t mipLevel, size_t size );
+        void QueueVertexBufferUpload( D3D9VertexBuffer* pBuffer, void* pStagingData, size_t size );
+        void QueueIndexBufferUpload( D3D9IndexBuffer* pBuffer, void* pStagingData, size_t size );
+        //@}
+
+        /// @name Upload Processing
+        //@{
+        void Process();
+        void Discard();
+
+        void SetFrameByteBudget( size_t budget );
+        size_t GetFrameByteBudget() const;
+        //@}
+
+        /// @name Device Reset Event Handlers
+        //@{
+        void OnPreReset();
+        void OnPostReset( D3D9Renderer* pRenderer );
+        //@}
+
+    private:
+        /// Upload entry types.
+        enum EEntryType
+        {
+            /// Static texture mip level.
+            ENTRY_TYPE_TEXTURE,
+            /// Static vertex buffer.
+            ENTRY_TYPE_VERTEX_BUFFER,
+            /// Static index buffer.
+            ENTRY_TYPE_INDEX_BUFFER
+        };
+
+        /// Pending upload.
+        struct Entry
+        {
+            /// Resource to which to upload.
+            SmartPtr< RRenderResource > spResource;
+            /// Staging memory from which to copy (buffer entries only, owned by the entry).
+            void* pStagingData;
+            /// Number of bytes to upload.
+            size_t size;
+            /// Texture mip level to upload (texture entries only).
+            uint32_t mipLevel;
+            /// Entry type.
+            EEntryType type;
+        };
+
+        /// Pending uploads, in the order in which they were queued.
+        DynamicArray< Entry > m_entries;
+        /// Entries taken off the queue for processing.
+        DynamicArray< Entry > m_processEntries;
+        /// Mutex synchronizing access to the pending upload list.
+        Mutex m_lock;
+
+        /// Number of bytes to upload each frame.
+        size_t m_frameByteBudget;
+        /// True while the device is being reset.
+        bool m_bResetting;
+
+        /// @name Private Utility Functions
+        //@{
+        void QueueUpload(
+            RRenderResource* pResource, EEntryType type, uint32_t mipLevel, void* pStagingData, size_t size );
+        static void CommitEntry( Entry& rEntry, bool bCopy );
+        //@}
+    };
+}
@@ -1,6 +1,10 @@
 #include "Precompile.h"
 #include "RenderingD3D9/D3D9VertexBuffer.h"
 
+#include "Platform/Atomic.h"
+#include "Engine/RenderStatistics.h"
+#include "RenderingD3D9/D3D9UploadQueue.h"
+
 using namespace Helium;
 
 /// Constructor.
@@ -9,14 +13,24 @@ using namespace Helium;
 ///                        object is constructed and decremented back when this object is destroyed.
 D3D9VertexBuffer::D3D9VertexBuffer( IDirect3DVertexBuffer9* pD3DBuffer )
 : m_pBuffer( pD3DBuffer )
+, m_pStagingData( NULL )
+, m_pendingUploadCount( 0 )
+, m_bStaged( false )
 {
     HELIUM_ASSERT( pD3DBuffer );
     pD3DBuffer->AddRef();
+
+    D3DVERTEXBUFFER_DESC bufferDesc;
+    HELIUM_D3D9_VERIFY( pD3DBuffer->GetDesc( &bufferDesc ) );
+    m_bStaged = ( bufferDesc.Pool == D3DPOOL_DEFAULT && !( bufferDesc.Usage & D3DUSAGE_DYNAMIC ) );
 }
 
 /// Destructor.
 D3D9VertexBuffer::~D3D9VertexBuffer()
 {
+    // Buffer should not be mapped when its reference count reaches zero.
+    HELIUM_ASSERT( !m_pStagingData );
+
     m_pBuffer->Release();
 }
 
@@ -32,6 +46,19 @@ void* D3D9VertexBuffer::Map( ERendererBufferMapHint hint )
         return NULL;
     }
 
+    // Map static default pool buffers to staging data, which is then uploaded by the renderer once unmapped.
+    D3D9Renderer* pRenderer = static_cast< D3D9Renderer* >( Renderer::GetInstance() );
+    HELIUM_ASSERT( pRenderer );
+    if( m_bStaged && pRenderer->GetUploadQueue() )
+    {
+        HELIUM_ASSERT( !m_pStagingData );
+
+        m_pStagingData = DefaultAllocator().Allocate( GetTrackedMemorySize() );
+        HELIUM_ASSERT( m_pStagingData );
+
+        return m_pStagingData;
+    }
+
     DWORD lockFlags = 0;
     if( hint == RENDERER_BUFFER_MAP_HINT_DISCARD )
     {
@@ -53,6 +80,8 @@ void* D3D9VertexBuffer::Map( ERendererBufferMapHint hint )
 
     HELIUM_ASSERT( pData );
 
+    RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, GetTrackedMemorySize() );
+
     return pData;
 }
 
@@ -68,9 +97,66 @@ void D3D9VertexBuffer::Unmap()
         return;
     }
 
+    if( m_pStagingData )
+    {
+        D3D9Renderer* pRenderer = static_cast< D3D9Renderer* >( Renderer::GetInstance() );
+        HELIUM_ASSERT( pRenderer );
+
+        D3D9UploadQueue* pUploadQueue = pRenderer->GetUploadQueue();
+        HELIUM_ASSERT( pUploadQueue );
+
+        AtomicIncrementRelease( m_pendingUploadCount );
+        pUploadQueue->QueueVertexBufferUpload( this, m_pStagingData, GetTrackedMemorySize() );
+        m_pStagingData = NULL;
+
+        return;
+    }
+
     HRESULT hResult = m_pBuffer->Unlock();
     if( FAILED( hResult ) )
     {
         HELIUM_TRACE( TraceLevels::Error, "D3D9VertexBuffer::Unmap(): Failed to unlock Direct3D buffer.\n" );
     }
 }
+
+/// @copydoc RRenderResource::IsUploadPending()
+bool D3D9VertexBuffer::IsUploadPending() const
+{
+    return ( m_pendingUploadCount != 0 );
+}
+
+/// Finish a staged upload queued by Unmap().
+///
+/// This is called by D3D9UploadQueue on the render thread.
+///
+/// @param[in] pStagingData  Staging data to upload.  This will be freed.
+/// @param[in] bCopy         True to copy the staging data to the buffer, false to discard it.
+void D3D9VertexBuffer::CommitStagingData( void* pStagingData, bool bCopy )
+{
+    HELIUM_ASSERT( pStagingData );
+
+    if( bCopy && m_pBuffer )
+    {
+        size_t size = GetTrackedMemorySize();
+
+        void* pData = NULL;
+        HRESULT hResult = m_pBuffer->Lock( 0, 0, &pData, 0 );
+        if( FAILED( hResult ) )
+        {
+            HELIUM_TRACE( TraceLevels::Error, "D3D9VertexBuffer::CommitStagingData(): Failed to lock Direct3D buffer.\n" );
+        }
+        else
+        {
+            HELIUM_ASSERT( pData );
+            MemoryCopy( pData, pStagingData, size );
+            HELIUM_D3D9_VERIFY( m_pBuffer->Unlock() );
+
+            RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, size );
+        }
+    }
+
+    DefaultAllocator().Free( pStagingData );
+
+    HELIUM_ASSERT( m_pendingUploadCount != 0 );
+    AtomicDecrementRelease( m_pendingUploadCount );
+}
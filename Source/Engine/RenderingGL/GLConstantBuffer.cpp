@@ -3,6 +3,8 @@
 #include "RenderingGL.h"
 #include "RenderingGL/GLConstantBuffer.h"
 
+#include "Engine/RenderStatistics.h"
+
 #include "GL/glew.h"
 
 using namespace Helium;
@@ -34,6 +36,8 @@ GLConstantBuffer::~GLConstantBuffer()
 /// @copydoc RConstantBuffer::Map()
 void* GLConstantBuffer::Map( ERendererBufferMapHint /*hint*/ )
 {
+	RenderStatistics::RecordUpload( RenderStatistics::COUNTER_CONSTANT_BUFFER_BYTES, GetTrackedMemorySize() );
+
 	return m_pData;
 }
 
@@ -0,0 +1,969 @@
+#include "Precompile.h"
+#include "RenderingGL/GLDeferredCommandProxy.h"
+
+#include "Rendering/RConstantBuffer.h"
+#include "Rendering/RFence.h"
+#include "Rendering/RGpuCullingBatch.h"
+#include "Rendering/RIndexBuffer.h"
+#include "Rendering/RPixelShader.h"
+#include "Rendering/RSurface.h"
+#include "Rendering/RTexture2d.h"
+#include "Rendering/RTimerQuery.h"
+#include "Rendering/RVertexBuffer.h"
+#include "Rendering/RVertexInputLayout.h"
+#include "Rendering/RVertexShader.h"
+#include "RenderingGL/GLImmediateCommandProxy.h"
+#include "RenderingGL/GLRenderCommandList.h"
+
+namespace Helium
+{
+	HELIUM_DECLARE_RPTR( RRasterizerState );
+	HELIUM_DECLARE_RPTR( RBlendState );
+	HELIUM_DECLARE_RPTR( RDepthStencilState );
+
+	HELIUM_DECLARE_RPTR( RSurface );
+
+	HELIUM_DECLARE_RPTR( RIndexBuffer );
+	HELIUM_DECLARE_RPTR( RVertexInputLayout );
+
+	HELIUM_DECLARE_RPTR( RVertexShader );
+	HELIUM_DECLARE_RPTR( RPixelShader );
+
+	HELIUM_DECLARE_RPTR( RTexture );
+	HELIUM_DECLARE_RPTR( RTexture2d );
+	HELIUM_DECLARE_RPTR( RGpuCullingBatch );
+
+	HELIUM_DECLARE_RPTR( RFence );
+	HELIUM_DECLARE_RPTR( RTimerQuery );
+}
+
+using namespace Helium;
+
+class GLSetRasterizerStateCommand : public GLRenderCommand
+{
+public:
+	GLSetRasterizerStateCommand( RRasterizerState* pState )
+		: m_spState( pState )
+	{
+	}
+
+	~GLSetRasterizerStateCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetRasterizerState( m_spState );
+	}
+
+private:
+	RRasterizerStatePtr m_spState;
+};
+
+class GLSetBlendStateCommand : public GLRenderCommand
+{
+public:
+	GLSetBlendStateCommand( RBlendState* pState )
+		: m_spState( pState )
+	{
+	}
+
+	~GLSetBlendStateCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetBlendState( m_spState );
+	}
+
+private:
+	RBlendStatePtr m_spState;
+};
+
+class GLSetDepthStencilStateCommand : public GLRenderCommand
+{
+public:
+	GLSetDepthStencilStateCommand( RDepthStencilState* pState, uint8_t stencilReferenceValue )
+		: m_spState( pState )
+		, m_stencilReferenceValue( stencilReferenceValue )
+	{
+	}
+
+	~GLSetDepthStencilStateCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetDepthStencilState( m_spState, m_stencilReferenceValue );
+	}
+
+private:
+	RDepthStencilStatePtr m_spState;
+	uint8_t m_stencilReferenceValue;
+};
+
+class GLSetSamplerStatesCommand : public GLRenderCommand
+{
+public:
+	static const size_t STATE_COUNT_MAX = 16;
+
+	GLSetSamplerStatesCommand( size_t startIndex, size_t samplerCount, RSamplerState* const* ppStates )
+		: m_startIndex( startIndex )
+	{
+		HELIUM_ASSERT_MSG(
+			samplerCount < HELIUM_ARRAY_COUNT( m_states ),
+			"GLDeferredCommandProxy: Sampler state count exceeds the maximum supported for deferred render commands (16)" );
+		samplerCount = Min( samplerCount, HELIUM_ARRAY_COUNT( m_states ) );
+		m_samplerCount = samplerCount;
+
+		HELIUM_ASSERT( ppStates || samplerCount == 0 );
+
+		for( size_t samplerIndex = 0; samplerIndex < samplerCount; ++samplerIndex )
+		{
+			m_states[ samplerIndex ] = ppStates[ samplerIndex ];
+		}
+	}
+
+	~GLSetSamplerStatesCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetSamplerStates(
+			m_startIndex,
+			m_samplerCount,
+			&static_cast< RSamplerState* const& >( m_states[ 0 ] ) );
+	}
+
+private:
+	size_t m_startIndex;
+	size_t m_samplerCount;
+	RSamplerStatePtr m_states[ STATE_COUNT_MAX ];
+};
+
+class GLSetRenderSurfacesCommand : public GLRenderCommand
+{
+public:
+	GLSetRenderSurfacesCommand( RSurface* pRenderTargetSurface, RSurface* pDepthStencilSurface )
+		: m_spRenderTargetSurface( pRenderTargetSurface )
+		, m_spDepthStencilSurface( pDepthStencilSurface )
+	{
+	}
+
+	~GLSetRenderSurfacesCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetRenderSurfaces( m_spRenderTargetSurface, m_spDepthStencilSurface );
+	}
+
+private:
+	RSurfacePtr m_spRenderTargetSurface;
+	RSurfacePtr m_spDepthStencilSurface;
+};
+
+class GLSetViewportCommand : public GLRenderCommand
+{
+public:
+	GLSetViewportCommand( uint32_t x, uint32_t y, uint32_t width, uint32_t height )
+		: m_x( x )
+		, m_y( y )
+		, m_width( width )
+		, m_height( height )
+	{
+	}
+
+	~GLSetViewportCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetViewport( m_x, m_y, m_width, m_height );
+	}
+
+private:
+	uint32_t m_x;
+	uint32_t m_y;
+	uint32_t m_width;
+	uint32_t m_height;
+};
+
+class GLBeginSceneCommand : public GLRenderCommand
+{
+public:
+	GLBeginSceneCommand()
+	{
+	}
+
+	~GLBeginSceneCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->BeginScene();
+	}
+};
+
+class GLEndSceneCommand : public GLRenderCommand
+{
+public:
+	GLEndSceneCommand()
+	{
+	}
+
+	~GLEndSceneCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->EndScene();
+	}
+};
+
+class GLClearCommand : public GLRenderCommand
+{
+public:
+	GLClearCommand( uint32_t clearFlags, const Color& rColor, float32_t depth, uint8_t stencil )
+		: m_clearFlags( clearFlags )
+		, m_color( rColor )
+		, m_depth( depth )
+		, m_stencil( stencil )
+	{
+	}
+
+	~GLClearCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->Clear( m_clearFlags, m_color, m_depth, m_stencil );
+	}
+
+private:
+	uint32_t m_clearFlags;
+	Color m_color;
+	float32_t m_depth;
+	uint8_t m_stencil;
+};
+
+class GLSetIndexBufferCommand : public GLRenderCommand
+{
+public:
+	GLSetIndexBufferCommand( RIndexBuffer* pBuffer )
+		: m_spBuffer( pBuffer )
+	{
+	}
+
+	~GLSetIndexBufferCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetIndexBuffer( m_spBuffer );
+	}
+
+private:
+	RIndexBufferPtr m_spBuffer;
+};
+
+class GLSetVertexBuffersCommand : public GLRenderCommand
+{
+public:
+	static const size_t BUFFER_COUNT_MAX = 16;
+
+	GLSetVertexBuffersCommand(
+		size_t startIndex,
+		size_t bufferCount,
+		RVertexBuffer* const* ppBuffers,
+		uint32_t* pStrides,
+		uint32_t* pOffsets )
+		: m_startIndex( startIndex )
+		, m_bufferCount( bufferCount )
+	{
+		HELIUM_ASSERT_MSG(
+			bufferCount < HELIUM_ARRAY_COUNT( m_buffers ),
+			"GLDeferredCommandProxy: Vertex buffer count exceeds the maximum supported for deferred render commands (16)" );
+		bufferCount = Min( bufferCount, HELIUM_ARRAY_COUNT( m_buffers ) );
+		m_bufferCount = bufferCount;
+
+		HELIUM_ASSERT( ppBuffers || bufferCount == 0 );
+		HELIUM_ASSERT( pStrides || bufferCount == 0 );
+		HELIUM_ASSERT( pOffsets || bufferCount == 0 );
+
+		for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+		{
+			m_buffers[ bufferIndex ] = ppBuffers[ bufferIndex ];
+		}
+
+		MemoryCopy( m_strides, pStrides, sizeof( m_strides[ 0 ] ) * bufferCount );
+		MemoryCopy( m_offsets, pOffsets, sizeof( m_offsets[ 0 ] ) * bufferCount );
+	}
+
+	~GLSetVertexBuffersCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetVertexBuffers(
+			m_startIndex,
+			m_bufferCount,
+			&static_cast< RVertexBuffer* const& >( m_buffers[ 0 ] ),
+			m_strides,
+			m_offsets );
+	}
+
+private:
+	size_t m_startIndex;
+	size_t m_bufferCount;
+	RVertexBufferPtr m_buffers[ BUFFER_COUNT_MAX ];
+	uint32_t m_strides[ BUFFER_COUNT_MAX ];
+	uint32_t m_offsets[ BUFFER_COUNT_MAX ];
+};
+
+class GLSetVertexInputLayoutCommand : public GLRenderCommand
+{
+public:
+	GLSetVertexInputLayoutCommand( RVertexInputLayout* pLayout )
+		: m_spLayout( pLayout )
+	{
+	}
+
+	~GLSetVertexInputLayoutCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetVertexInputLayout( m_spLayout );
+	}
+
+private:
+	RVertexInputLayoutPtr m_spLayout;
+};
+
+class GLSetVertexShaderCommand : public GLRenderCommand
+{
+public:
+	GLSetVertexShaderCommand( RVertexShader* pShader )
+		: m_spShader( pShader )
+	{
+	}
+
+	~GLSetVertexShaderCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetVertexShader( m_spShader );
+	}
+
+private:
+	RVertexShaderPtr m_spShader;
+};
+
+class GLSetPixelShaderCommand : public GLRenderCommand
+{
+public:
+	GLSetPixelShaderCommand( RPixelShader* pShader )
+		: m_spShader( pShader )
+	{
+	}
+
+	~GLSetPixelShaderCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetPixelShader( m_spShader );
+	}
+
+private:
+	RPixelShaderPtr m_spShader;
+};
+
+class GLSetConstantBuffersCommand : public GLRenderCommand
+{
+public:
+	GLSetConstantBuffersCommand(
+		size_t startIndex,
+		size_t bufferCount,
+		RConstantBuffer* const* ppBuffers,
+		const size_t* pLimitSizes,
+		const size_t* pOffsets )
+		: m_startIndex( startIndex )
+		, m_bufferCount( bufferCount )
+	{
+		HELIUM_ASSERT_MSG(
+			bufferCount < HELIUM_ARRAY_COUNT( m_buffers ),
+			"GLDeferredCommandProxy: Constant buffer count exceeds the supported number of command buffer slots" );
+		bufferCount = Min( bufferCount, HELIUM_ARRAY_COUNT( m_buffers ) );
+		m_bufferCount = bufferCount;
+
+		HELIUM_ASSERT( ppBuffers || bufferCount == 0 );
+
+		for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+		{
+			m_buffers[ bufferIndex ] = ppBuffers[ bufferIndex ];
+		}
+
+		if( pLimitSizes )
+		{
+			MemoryCopy( m_limitSizes, pLimitSizes, bufferCount * sizeof( size_t ) );
+		}
+		else
+		{
+			MemorySet( m_limitSizes, 0xff, bufferCount * sizeof( size_t ) );
+		}
+
+		// Offsets are only recorded when given, since giving them changes how the limit sizes are interpreted.
+		m_bOffsets = ( pOffsets != NULL );
+		if( pOffsets )
+		{
+			MemoryCopy( m_offsets, pOffsets, bufferCount * sizeof( size_t ) );
+		}
+	}
+
+	~GLSetConstantBuffersCommand()
+	{
+	}
+
+protected:
+	size_t m_startIndex;
+	size_t m_bufferCount;
+	RConstantBufferPtr m_buffers[ GLImmediateCommandProxy::CONSTANT_BUFFER_SLOT_COUNT ];
+	size_t m_limitSizes[ GLImmediateCommandProxy::CONSTANT_BUFFER_SLOT_COUNT ];
+	size_t m_offsets[ GLImmediateCommandProxy::CONSTANT_BUFFER_SLOT_COUNT ];
+	bool m_bOffsets;
+};
+
+class GLSetVertexConstantBuffersCommand : public GLSetConstantBuffersCommand
+{
+public:
+	GLSetVertexConstantBuffersCommand(
+		size_t startIndex,
+		size_t bufferCount,
+		RConstantBuffer* const* ppBuffers,
+		const size_t* pLimitSizes,
+		const size_t* pOffsets )
+		: GLSetConstantBuffersCommand( startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets )
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetVertexConstantBuffers(
+			m_startIndex,
+			m_bufferCount,
+			&static_cast< RConstantBuffer* const& >( m_buffers[ 0 ] ),
+			m_limitSizes,
+			( m_bOffsets ? m_offsets : NULL ) );
+	}
+};
+
+class GLSetPixelConstantBuffersCommand : public GLSetConstantBuffersCommand
+{
+public:
+	GLSetPixelConstantBuffersCommand(
+		size_t startIndex,
+		size_t bufferCount,
+		RConstantBuffer* const* ppBuffers,
+		const size_t* pLimitSizes,
+		const size_t* pOffsets )
+		: GLSetConstantBuffersCommand( startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets )
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetPixelConstantBuffers(
+			m_startIndex,
+			m_bufferCount,
+			&static_cast< RConstantBuffer* const& >( m_buffers[ 0 ] ),
+			m_limitSizes,
+			( m_bOffsets ? m_offsets : NULL ) );
+	}
+};
+
+class GLSetTextureCommand : public GLRenderCommand
+{
+public:
+	GLSetTextureCommand( size_t samplerIndex, RTexture* pTexture )
+		: m_samplerIndex( samplerIndex )
+		, m_spTexture( pTexture )
+	{
+	}
+
+	~GLSetTextureCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetTexture( m_samplerIndex, m_spTexture );
+	}
+
+private:
+	size_t m_samplerIndex;
+	RTexturePtr m_spTexture;
+};
+
+class GLDrawIndexedCommand : public GLRenderCommand
+{
+public:
+	GLDrawIndexedCommand(
+		ERendererPrimitiveType primitiveType,
+		uint32_t baseVertexIndex,
+		uint32_t minIndex,
+		uint32_t usedVertexCount,
+		uint32_t startIndex,
+		uint32_t primitiveCount )
+		: m_primitiveType( primitiveType )
+		, m_baseVertexIndex( baseVertexIndex )
+		, m_minIndex( minIndex )
+		, m_usedVertexCount( usedVertexCount )
+		, m_startIndex( startIndex )
+		, m_primitiveCount( primitiveCount )
+	{
+	}
+
+	~GLDrawIndexedCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->DrawIndexed(
+			m_primitiveType,
+			m_baseVertexIndex,
+			m_minIndex,
+			m_usedVertexCount,
+			m_startIndex,
+			m_primitiveCount );
+	}
+
+private:
+	ERendererPrimitiveType m_primitiveType;
+	uint32_t m_baseVertexIndex;
+	uint32_t m_minIndex;
+	uint32_t m_usedVertexCount;
+	uint32_t m_startIndex;
+	uint32_t m_primitiveCount;
+};
+
+class GLDrawIndexedInstancedCommand : public GLRenderCommand
+{
+public:
+	GLDrawIndexedInstancedCommand(
+		ERendererPrimitiveType primitiveType,
+		uint32_t baseVertexIndex,
+		uint32_t minIndex,
+		uint32_t usedVertexCount,
+		uint32_t startIndex,
+		uint32_t primitiveCount,
+		uint32_t instanceCount )
+		: m_primitiveType( primitiveType )
+		, m_baseVertexIndex( baseVertexIndex )
+		, m_minIndex( minIndex )
+		, m_usedVertexCount( usedVertexCount )
+		, m_startIndex( startIndex )
+		, m_primitiveCount( primitiveCount )
+		, m_instanceCount( instanceCount )
+	{
+	}
+
+	~GLDrawIndexedInstancedCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->DrawIndexedInstanced(
+			m_primitiveType,
+			m_baseVertexIndex,
+			m_minIndex,
+			m_usedVertexCount,
+			m_startIndex,
+			m_primitiveCount,
+			m_instanceCount );
+	}
+
+private:
+	ERendererPrimitiveType m_primitiveType;
+	uint32_t m_baseVertexIndex;
+	uint32_t m_minIndex;
+	uint32_t m_usedVertexCount;
+	uint32_t m_startIndex;
+	uint32_t m_primitiveCount;
+	uint32_t m_instanceCount;
+};
+
+class GLDrawUnindexedCommand : public GLRenderCommand
+{
+public:
+	GLDrawUnindexedCommand( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t primitiveCount )
+		: m_primitiveType( primitiveType )
+		, m_baseVertexIndex( baseVertexIndex )
+		, m_primitiveCount( primitiveCount )
+	{
+	}
+
+	~GLDrawUnindexedCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->DrawUnindexed( m_primitiveType, m_baseVertexIndex, m_primitiveType );
+	}
+
+private:
+	ERendererPrimitiveType m_primitiveType;
+	uint32_t m_baseVertexIndex;
+	uint32_t m_primitiveCount;
+};
+
+class GLCullGpuDrawsCommand : public GLRenderCommand
+{
+public:
+	GLCullGpuDrawsCommand( RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid )
+		: m_spBatch( pBatch )
+		, m_spDepthPyramid( pDepthPyramid )
+	{
+		HELIUM_ASSERT( pViewProjection );
+		MemoryCopy( m_viewProjection, pViewProjection, sizeof( m_viewProjection ) );
+	}
+
+	~GLCullGpuDrawsCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->CullGpuDraws( m_spBatch, m_viewProjection, m_spDepthPyramid );
+	}
+
+private:
+	RGpuCullingBatchPtr m_spBatch;
+	RTexture2dPtr m_spDepthPyramid;
+	float32_t m_viewProjection[ 16 ];
+};
+
+class GLDrawGpuCulledCommand : public GLRenderCommand
+{
+public:
+	GLDrawGpuCulledCommand( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch )
+		: m_primitiveType( primitiveType )
+		, m_spBatch( pBatch )
+	{
+	}
+
+	~GLDrawGpuCulledCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->DrawGpuCulled( m_primitiveType, m_spBatch );
+	}
+
+private:
+	ERendererPrimitiveType m_primitiveType;
+	RGpuCullingBatchPtr m_spBatch;
+};
+
+class GLSetFenceCommand : public GLRenderCommand
+{
+public:
+	GLSetFenceCommand( RFence* pFence )
+		: m_spFence( pFence )
+	{
+	}
+
+	~GLSetFenceCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->SetFence( m_spFence );
+	}
+
+private:
+	RFencePtr m_spFence;
+};
+
+class GLIssueTimerQueryCommand : public GLRenderCommand
+{
+public:
+	GLIssueTimerQueryCommand( RTimerQuery* pQuery )
+		: m_spQuery( pQuery )
+	{
+	}
+
+	~GLIssueTimerQueryCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->IssueTimerQuery( m_spQuery );
+	}
+
+private:
+	RTimerQueryPtr m_spQuery;
+};
+
+class GLUnbindResourcesCommand : public GLRenderCommand
+{
+public:
+	GLUnbindResourcesCommand()
+	{
+	}
+
+	~GLUnbindResourcesCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->UnbindResources();
+	}
+};
+
+class GLExecuteCommandListCommand : public GLRenderCommand
+{
+public:
+	GLExecuteCommandListCommand( RRenderCommandList* pCommandList )
+		: m_spCommandList( pCommandList )
+	{
+	}
+
+	~GLExecuteCommandListCommand()
+	{
+	}
+
+	void Execute( GLImmediateCommandProxy* pCommandProxy )
+	{
+		pCommandProxy->ExecuteCommandList( m_spCommandList );
+	}
+
+private:
+	RRenderCommandListPtr m_spCommandList;
+};
+
+#define HELIUM_DEFERRED_COMMAND_PROXY_METHOD( COMMAND, PARAM_LIST, ARGUMENT_LIST ) \
+	void GLDeferredCommandProxy::COMMAND PARAM_LIST \
+	{ \
+		GLRenderCommandList* pCommandList = GetCommandList(); \
+		if( !pCommandList->NewCommand< GL##COMMAND##Command > ARGUMENT_LIST ) \
+		{ \
+			pCommandList = AddCommandList(); \
+			HELIUM_VERIFY( pCommandList->NewCommand< GL##COMMAND##Command > ARGUMENT_LIST ); \
+		} \
+	}
+
+/// Constructor.
+GLDeferredCommandProxy::GLDeferredCommandProxy()
+	: m_pLastCommandList( NULL )
+{
+}
+
+/// Destructor.
+GLDeferredCommandProxy::~GLDeferredCommandProxy()
+{
+}
+
+/// Get the command list into which new commands should be recorded, starting a new command list if necessary.
+///
+/// @return  Last command list in the chain being recorded.
+///
+/// @see AddCommandList()
+GLRenderCommandList* GLDeferredCommandProxy::GetCommandList()
+{
+	if( !m_spCommandList )
+	{
+		m_spCommandList = new GLRenderCommandList;
+		HELIUM_ASSERT( m_spCommandList );
+
+		m_pLastCommandList = m_spCommandList;
+	}
+
+	return m_pLastCommandList;
+}
+
+/// Chain a new command list after the last command list being recorded, once the last list has run out of space.
+///
+/// @return  New last command list in the chain being recorded.
+///
+/// @see GetCommandList()
+GLRenderCommandList* GLDeferredCommandProxy::AddCommandList()
+{
+	HELIUM_ASSERT( m_pLastCommandList );
+
+	GLRenderCommandList* pCommandList = new GLRenderCommandList;
+	HELIUM_ASSERT( pCommandList );
+
+	m_pLastCommandList->SetNext( pCommandList );
+	m_pLastCommandList = pCommandList;
+
+	return pCommandList;
+}
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetRasterizerState,
+	( RRasterizerState* pState ),
+	( pState ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetBlendState,
+	( RBlendState* pState ),
+	( pState ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetDepthStencilState,
+	( RDepthStencilState* pState, uint8_t stencilReferenceValue ),
+	( pState, stencilReferenceValue ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetSamplerStates,
+	( size_t startIndex, size_t samplerCount, RSamplerState* const* ppStates ),
+	( startIndex, samplerCount, ppStates ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetRenderSurfaces,
+	( RSurface* pRenderTargetSurface, RSurface* pDepthStencilSurface ),
+	( pRenderTargetSurface, pDepthStencilSurface ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetViewport,
+	( uint32_t x, uint32_t y, uint32_t width, uint32_t height ),
+	( x, y, width, height ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	BeginScene,
+	(),
+	() )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	EndScene,
+	(),
+	() )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	Clear,
+	( uint32_t clearFlags, const Color& rColor, float32_t depth, uint8_t stencil ),
+	( clearFlags, rColor, depth, stencil ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetIndexBuffer,
+	( RIndexBuffer* pBuffer ),
+	( pBuffer ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetVertexBuffers,
+	( size_t startIndex, size_t bufferCount, RVertexBuffer* const* ppBuffers, uint32_t* pStrides, uint32_t* pOffsets ),
+	( startIndex, bufferCount, ppBuffers, pStrides, pOffsets ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetVertexInputLayout,
+	( RVertexInputLayout* pLayout ),
+	( pLayout ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetVertexShader,
+	( RVertexShader* pShader ),
+	( pShader ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetPixelShader,
+	( RPixelShader* pShader ),
+	( pShader ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetVertexConstantBuffers,
+	( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes, const size_t* pOffsets ),
+	( startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetPixelConstantBuffers,
+	( size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers, const size_t* pLimitSizes, const size_t* pOffsets ),
+	( startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetTexture,
+	( size_t samplerIndex, RTexture* pTexture ),
+	( samplerIndex, pTexture ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	DrawIndexed,
+	( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
+	  uint32_t startIndex, uint32_t primitiveCount ),
+	( primitiveType, baseVertexIndex, minIndex, usedVertexCount, startIndex, primitiveCount ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	DrawIndexedInstanced,
+	( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
+	  uint32_t startIndex, uint32_t primitiveCount, uint32_t instanceCount ),
+	( primitiveType, baseVertexIndex, minIndex, usedVertexCount, startIndex, primitiveCount, instanceCount ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	DrawUnindexed,
+	( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t primitiveCount ),
+	( primitiveType, baseVertexIndex, primitiveCount ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	CullGpuDraws,
+	( RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid ),
+	( pBatch, pViewProjection, pDepthPyramid ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	DrawGpuCulled,
+	( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch ),
+	( primitiveType, pBatch ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	SetFence,
+	( RFence* pFence ),
+	( pFence ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	IssueTimerQuery,
+	( RTimerQuery* pQuery ),
+	( pQuery ) )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	UnbindResources,
+	(),
+	() )
+
+HELIUM_DEFERRED_COMMAND_PROXY_METHOD(
+	ExecuteCommandList,
+	( RRenderCommandList* pCommandList ),
+	( pCommandList ) )
+
+/// @copydoc GLDeferredCommandProxy::FinishCommandList()
+void GLDeferredCommandProxy::FinishCommandList( RRenderCommandListPtr& rspCommandList )
+{
+	rspCommandList = m_spCommandList;
+	if( !rspCommandList )
+	{
+		rspCommandList = new GLRenderCommandList;
+		HELIUM_ASSERT( rspCommandList );
+	}
+
+	m_spCommandList.Release();
+	m_pLastCommandList = NULL;
+}
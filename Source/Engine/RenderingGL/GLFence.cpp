@@ -0,0 +1,106 @@
+#include "Precompile.h"
+#include "RenderingGL/GLFence.h"
+
+#include "GL/glew.h"
+
+using namespace Helium;
+
+/// Timeout for each wait on a fence, in nanoseconds.
+static const GLuint64 FENCE_WAIT_TIMEOUT = 1000000;
+
+/// Constructor.
+GLFence::GLFence()
+: m_sync( NULL )
+{
+}
+
+/// Destructor.
+GLFence::~GLFence()
+{
+	ReleaseSync();
+}
+
+/// Set this fence at the current point in the GPU command stream, replacing any previous sync point.
+///
+/// @see Wait(), TryWait()
+void GLFence::Set()
+{
+	ReleaseSync();
+
+	m_sync = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	HELIUM_ASSERT( m_sync );
+	if( !m_sync )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLFence::Set(): Failed to create OpenGL sync object.\n" );
+	}
+}
+
+/// Block until the GPU has finished all commands issued before this fence was set.
+///
+/// @see TryWait(), Set()
+void GLFence::Wait()
+{
+	if( !m_sync )
+	{
+		return;
+	}
+
+	// Pending commands only need to be flushed on the first wait to make sure the fence will eventually signal.
+	GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	for( ; ; )
+	{
+		GLenum result = glClientWaitSync( m_sync, waitFlags, FENCE_WAIT_TIMEOUT );
+		if( result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED )
+		{
+			break;
+		}
+
+		if( result == GL_WAIT_FAILED )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "GLFence::Wait(): Failed to wait on OpenGL sync object, aborting sync.\n" );
+			break;
+		}
+
+		waitFlags = 0;
+	}
+
+	ReleaseSync();
+}
+
+/// Check whether the GPU has finished all commands issued before this fence was set, without blocking.
+///
+/// @return  True if the fence has been signaled (or was never set), false if the GPU is still working.
+///
+/// @see Wait(), Set()
+bool GLFence::TryWait()
+{
+	if( !m_sync )
+	{
+		return true;
+	}
+
+	GLenum result = glClientWaitSync( m_sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0 );
+	if( result == GL_TIMEOUT_EXPIRED )
+	{
+		return false;
+	}
+
+	if( result == GL_WAIT_FAILED )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLFence::TryWait(): Failed to query OpenGL sync object.\n" );
+	}
+
+	ReleaseSync();
+
+	return true;
+}
+
+/// Release the current sync object, if any.
+void GLFence::ReleaseSync()
+{
+	if( m_sync )
+	{
+		glDeleteSync( m_sync );
+		m_sync = NULL;
+	}
+}
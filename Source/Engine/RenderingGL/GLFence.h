@@ -0,0 +1,47 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Rendering/RFence.h"
+
+#include "GL/glew.h"
+
+namespace Helium
+{
+	/// OpenGL GPU command fence implementation.
+	///
+	/// Each fence wraps a sync object that is recreated every time the fence is set.  A fence that has never been set
+	/// is treated as already signaled.
+	class GLFence : public RFence
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		GLFence();
+		//@}
+
+		/// @name Synchronization
+		//@{
+		void Set();
+		void Wait();
+		bool TryWait();
+
+		inline GLsync GetSync() const;
+		//@}
+
+	protected:
+		/// Sync object for the most recent point at which the fence was set.
+		GLsync m_sync;
+
+		/// @name Construction/Destruction
+		//@{
+		~GLFence();
+		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		void ReleaseSync();
+		//@}
+	};
+}
+
+#include "RenderingGL/GLFence.inl"
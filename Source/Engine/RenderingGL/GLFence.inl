@@ -0,0 +1,10 @@
+namespace Helium
+{
+	/// Get the OpenGL sync object associated with this fence.
+	///
+	/// @return  Sync object, or null if the fence has not been set or has already been found to be signaled.
+	GLsync GLFence::GetSync() const
+	{
+		return m_sync;
+	}
+}
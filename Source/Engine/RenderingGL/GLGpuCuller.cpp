@@ -0,0 +1,221 @@
+#include "Precompile.h"
+#include "RenderingGL/GLGpuCuller.h"
+
+#include "RenderingGL/GLGpuCullingBatch.h"
+#include "RenderingGL/GLRenderer.h"
+#include "RenderingGL/GLTexture2d.h"
+
+using namespace Helium;
+
+/// Culling compute shader source.
+///
+/// Matrices are stored row-major for row vectors, so loading the view-projection matrix as-is gives the column-major
+/// matrix for column vectors.  Clip-space depth uses the [0, w] range of the engine's projection matrices.
+static const char CULL_SHADER_SOURCE[] =
+	"#version 430\n"
+	"layout( local_size_x = 64 ) in;\n"
+	"struct Draw { uint objectIndex; uint indexCount; uint startIndex; int baseVertexIndex; };\n"
+	"struct Command { uint count; uint instanceCount; uint firstIndex; int baseVertex; uint baseInstance; };\n"
+	"layout( std430, binding = 0 ) readonly buffer Objects { vec4 objects[]; };\n"
+	"layout( std430, binding = 1 ) readonly buffer Draws { Draw draws[]; };\n"
+	"layout( std430, binding = 2 ) writeonly buffer Commands { Command commands[]; };\n"
+	"uniform mat4 viewProjection;\n"
+	"uniform uint drawCount;\n"
+	"uniform int occlusionEnabled;\n"
+	"uniform sampler2D depthPyramid;\n"
+	"bool IsInFrustum( vec4 sphere )\n"
+	"{\n"
+	"	mat4 t = transpose( viewProjection );\n"
+	"	vec4 planes[ 6 ] = vec4[ 6 ]( t[ 3 ] + t[ 0 ], t[ 3 ] - t[ 0 ], t[ 3 ] + t[ 1 ], t[ 3 ] - t[ 1 ], t[ 2 ], t[ 3 ] - t[ 2 ] );\n"
+	"	for( int i = 0; i < 6; ++i )\n"
+	"	{\n"
+	"		if( dot( planes[ i ].xyz, sphere.xyz ) + planes[ i ].w < -sphere.w * length( planes[ i ].xyz ) )\n"
+	"			return false;\n"
+	"	}\n"
+	"	return true;\n"
+	"}\n"
+	"bool IsUnoccluded( vec4 sphere )\n"
+	"{\n"
+	"	vec3 minNdc = vec3( 1.0 );\n"
+	"	vec3 maxNdc = vec3( -1.0 );\n"
+	"	for( int i = 0; i < 8; ++i )\n"
+	"	{\n"
+	"		vec3 corner = sphere.xyz + sphere.w * vec3( ( i & 1 ) != 0 ? 1.0 : -1.0, ( i & 2 ) != 0 ? 1.0 : -1.0, ( i & 4 ) != 0 ? 1.0 : -1.0 );\n"
+	"		vec4 clip = viewProjection * vec4( corner, 1.0 );\n"
+	"		if( clip.w <= 0.0 )\n"
+	"			return true;\n"
+	"		vec3 ndc = clip.xyz / clip.w;\n"
+	"		minNdc = min( minNdc, ndc );\n"
+	"		maxNdc = max( maxNdc, ndc );\n"
+	"	}\n"
+	"	vec2 minUv = clamp( minNdc.xy * 0.5 + 0.5, 0.0, 1.0 );\n"
+	"	vec2 maxUv = clamp( maxNdc.xy * 0.5 + 0.5, 0.0, 1.0 );\n"
+	"	vec2 baseSize = vec2( textureSize( depthPyramid, 0 ) );\n"
+	"	vec2 extent = ( maxUv - minUv ) * baseSize;\n"
+	"	int levelCount = textureQueryLevels( depthPyramid );\n"
+	"	int level = clamp( int( ceil( log2( max( max( extent.x, extent.y ), 1.0 ) ) ) ), 0, levelCount - 1 );\n"
+	"	ivec2 levelSize = textureSize( depthPyramid, level );\n"
+	"	ivec2 minTexel = clamp( ivec2( minUv * vec2( levelSize ) ), ivec2( 0 ), levelSize - 1 );\n"
+	"	ivec2 maxTexel = clamp( ivec2( maxUv * vec2( levelSize ) ), ivec2( 0 ), levelSize - 1 );\n"
+	"	float maxDepth = max(\n"
+	"		max( texelFetch( depthPyramid, minTexel, level ).r, texelFetch( depthPyramid, ivec2( maxTexel.x, minTexel.y ), level ).r ),\n"
+	"		max( texelFetch( depthPyramid, ivec2( minTexel.x, maxTexel.y ), level ).r, texelFetch( depthPyramid, maxTexel, level ).r ) );\n"
+	"	return minNdc.z <= maxDepth;\n"
+	"}\n"
+	"void main()\n"
+	"{\n"
+	"	uint drawIndex = gl_GlobalInvocationID.x;\n"
+	"	if( drawIndex >= drawCount )\n"
+	"		return;\n"
+	"	Draw draw = draws[ drawIndex ];\n"
+	"	vec4 sphere = objects[ draw.objectIndex ];\n"
+	"	bool bVisible = IsInFrustum( sphere ) && ( occlusionEnabled == 0 || IsUnoccluded( sphere ) );\n"
+	"	commands[ drawIndex ] = Command(\n"
+	"		draw.indexCount, bVisible ? 1u : 0u, draw.startIndex, draw.baseVertexIndex, draw.objectIndex );\n"
+	"}\n";
+
+/// Constructor.
+GLGpuCuller::GLGpuCuller()
+: m_program( 0 )
+, m_viewProjectionLocation( -1 )
+, m_drawCountLocation( -1 )
+, m_occlusionEnabledLocation( -1 )
+, m_depthPyramidUnit( 0 )
+{
+}
+
+/// Destructor.
+GLGpuCuller::~GLGpuCuller()
+{
+	Shutdown();
+}
+
+/// Compile and link the culling compute shader.
+///
+/// This must be called from the thread that owns the OpenGL context, and requires OpenGL 4.3 support.
+///
+/// @return  True if initialization was successful, false if not.
+///
+/// @see Shutdown()
+bool GLGpuCuller::Initialize()
+{
+	HELIUM_ASSERT( !m_program );
+
+	GLuint shader = GLRenderer::CompileShader( GL_COMPUTE_SHADER, CULL_SHADER_SOURCE, sizeof( CULL_SHADER_SOURCE ) - 1 );
+	if( !shader )
+	{
+		return false;
+	}
+
+	GLuint program = glCreateProgram();
+	if( !program )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLGpuCuller: Failed to create program object.\n" );
+		glDeleteShader( shader );
+
+		return false;
+	}
+
+	glAttachShader( program, shader );
+	glLinkProgram( program );
+	glDetachShader( program, shader );
+	glDeleteShader( shader );
+
+	GLint linkStatus = GL_FALSE;
+	glGetProgramiv( program, GL_LINK_STATUS, &linkStatus );
+	if( linkStatus != GL_TRUE )
+	{
+		GLchar infoLog[ 1024 ];
+		infoLog[ 0 ] = '\0';
+		glGetProgramInfoLog( program, static_cast< GLsizei >( sizeof( infoLog ) ), NULL, infoLog );
+		HELIUM_TRACE( TraceLevels::Error, "GLGpuCuller: Failed to link culling program:\n%s\n", infoLog );
+
+		glDeleteProgram( program );
+
+		return false;
+	}
+
+	m_program = program;
+	m_viewProjectionLocation = glGetUniformLocation( program, "viewProjection" );
+	m_drawCountLocation = glGetUniformLocation( program, "drawCount" );
+	m_occlusionEnabledLocation = glGetUniformLocation( program, "occlusionEnabled" );
+
+	// Reserve the last texture unit for the depth pyramid so it never collides with material textures.
+	GLint textureUnitCount = 0;
+	glGetIntegerv( GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &textureUnitCount );
+	HELIUM_ASSERT( textureUnitCount > 0 );
+	m_depthPyramidUnit = static_cast< GLuint >( textureUnitCount - 1 );
+
+	// Sampler uniforms can only be set on the current program.
+	glUseProgram( program );
+	glUniform1i( glGetUniformLocation( program, "depthPyramid" ), static_cast< GLint >( m_depthPyramidUnit ) );
+	glUseProgram( 0 );
+
+	return true;
+}
+
+/// Delete the culling compute program.
+///
+/// @see Initialize()
+void GLGpuCuller::Shutdown()
+{
+	if( m_program )
+	{
+		glDeleteProgram( m_program );
+		m_program = 0;
+	}
+}
+
+/// Cull the draws of a batch and write their indirect draw commands.
+///
+/// The batch's pending data is uploaded first.  A command barrier is issued after the dispatch, so the command buffer
+/// can be used by indirect draws immediately.  The culling program is left bound.
+///
+/// @param[in] pBatch           Batch to cull.
+/// @param[in] pViewProjection  Combined view-projection matrix (16 values, row-major).
+/// @param[in] pDepthPyramid    Optional depth pyramid for occlusion culling, or null to only cull against the frustum.
+///
+/// @see GetGLProgram()
+void GLGpuCuller::Cull( GLGpuCullingBatch* pBatch, const float32_t* pViewProjection, GLTexture2d* pDepthPyramid )
+{
+	HELIUM_ASSERT( m_program );
+	HELIUM_ASSERT( pBatch );
+	HELIUM_ASSERT( pViewProjection );
+
+	pBatch->Upload();
+
+	uint32_t drawCount = pBatch->GetDrawCount();
+	if( drawCount == 0 )
+	{
+		return;
+	}
+
+	glUseProgram( m_program );
+	glUniformMatrix4fv( m_viewProjectionLocation, 1, GL_FALSE, pViewProjection );
+	glUniform1ui( m_drawCountLocation, drawCount );
+	glUniform1i( m_occlusionEnabledLocation, pDepthPyramid ? 1 : 0 );
+
+	glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 0, pBatch->GetGLObjectBuffer() );
+	glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 1, pBatch->GetGLDrawBuffer() );
+	glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 2, pBatch->GetGLCommandBuffer() );
+
+	if( pDepthPyramid )
+	{
+		glActiveTexture( GL_TEXTURE0 + m_depthPyramidUnit );
+		glBindTexture( GL_TEXTURE_2D, pDepthPyramid->GetGLTexture() );
+	}
+
+	glDispatchCompute( ( drawCount + GROUP_SIZE - 1 ) / GROUP_SIZE, 1, 1 );
+
+	// Make the command buffer writes visible to indirect draws.
+	glMemoryBarrier( GL_COMMAND_BARRIER_BIT );
+
+	if( pDepthPyramid )
+	{
+		glBindTexture( GL_TEXTURE_2D, 0 );
+	}
+
+	glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 0, 0 );
+	glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 1, 0 );
+	glBindBufferBase( GL_SHADER_STORAGE_BUFFER, 2, 0 );
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+
+#include "GL/glew.h"
+
+namespace Helium
+{
+	class GLGpuCullingBatch;
+	class GLTexture2d;
+
+	/// Compute shader pass culling the draws of a GLGpuCullingBatch on the GPU.
+	///
+	/// One invocation is run per draw record.  Each invocation tests the bounding sphere of the draw's object against
+	/// the view frustum and, if a depth pyramid is given, against the farthest depth covered by the sphere's screen
+	/// bounds, then writes a DrawElementsIndirectCommand for the draw to the batch's command buffer with an instance
+	/// count of one if the draw is visible or zero if it was culled.  The object index is passed as the base instance
+	/// so vertex shaders can look up per-object data through gl_BaseInstance (or an instanced vertex stream).
+	///
+	/// This requires OpenGL 4.3 (compute shaders, shader storage buffers, and multi-draw indirect).
+	class GLGpuCuller
+	{
+	public:
+		/// Number of draws culled by each compute shader work group.
+		static const uint32_t GROUP_SIZE = 64;
+
+		/// @name Construction/Destruction
+		//@{
+		GLGpuCuller();
+		~GLGpuCuller();
+		//@}
+
+		/// @name Initialization
+		//@{
+		bool Initialize();
+		void Shutdown();
+		//@}
+
+		/// @name Culling
+		//@{
+		void Cull( GLGpuCullingBatch* pBatch, const float32_t* pViewProjection, GLTexture2d* pDepthPyramid );
+
+		inline GLuint GetGLProgram() const;
+		//@}
+
+	private:
+		/// Linked compute program.
+		GLuint m_program;
+		/// Location of the view-projection matrix uniform.
+		GLint m_viewProjectionLocation;
+		/// Location of the draw count uniform.
+		GLint m_drawCountLocation;
+		/// Location of the occlusion test toggle uniform.
+		GLint m_occlusionEnabledLocation;
+		/// Texture unit reserved for the depth pyramid.
+		GLuint m_depthPyramidUnit;
+	};
+}
+
+#include "RenderingGL/GLGpuCuller.inl"
@@ -0,0 +1,12 @@
+namespace Helium
+{
+	/// Get the compute program used for culling.
+	///
+	/// The program remains bound after Cull() returns.
+	///
+	/// @return  Linked compute program, or zero if the culler is not initialized.
+	GLuint GLGpuCuller::GetGLProgram() const
+	{
+		return m_program;
+	}
+}
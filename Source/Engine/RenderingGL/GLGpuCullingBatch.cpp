@@ -0,0 +1,103 @@
+#include "Precompile.h"
+#include "RenderingGL/GLGpuCullingBatch.h"
+
+#include "Engine/RenderStatistics.h"
+
+using namespace Helium;
+
+/// Constructor.
+///
+/// @param[in] objectCapacity  Maximum number of objects.
+/// @param[in] drawCapacity    Maximum number of draws.
+/// @param[in] objectBuffer    Shader storage buffer sized for the object bounds.  This object takes ownership of it.
+/// @param[in] drawBuffer      Shader storage buffer sized for the draw records.  This object takes ownership of it.
+/// @param[in] commandBuffer   Buffer sized for one indirect draw command per draw.  This object takes ownership of it.
+GLGpuCullingBatch::GLGpuCullingBatch(
+	uint32_t objectCapacity,
+	uint32_t drawCapacity,
+	GLuint objectBuffer,
+	GLuint drawBuffer,
+	GLuint commandBuffer )
+: RGpuCullingBatch( objectCapacity, drawCapacity )
+, m_objectBuffer( objectBuffer )
+, m_drawBuffer( drawBuffer )
+, m_commandBuffer( commandBuffer )
+, m_pObjectStaging( NULL )
+, m_pDrawStaging( NULL )
+, m_bObjectsDirty( false )
+, m_bDrawsDirty( false )
+{
+	HELIUM_ASSERT( objectBuffer );
+	HELIUM_ASSERT( drawBuffer );
+	HELIUM_ASSERT( commandBuffer );
+
+	DefaultAllocator allocator;
+	m_pObjectStaging = static_cast< ObjectBounds* >( allocator.Allocate( sizeof( ObjectBounds ) * objectCapacity ) );
+	HELIUM_ASSERT( m_pObjectStaging );
+	m_pDrawStaging = static_cast< Draw* >( allocator.Allocate( sizeof( Draw ) * drawCapacity ) );
+	HELIUM_ASSERT( m_pDrawStaging );
+}
+
+/// Destructor.
+GLGpuCullingBatch::~GLGpuCullingBatch()
+{
+	DefaultAllocator allocator;
+	allocator.Free( m_pObjectStaging );
+	allocator.Free( m_pDrawStaging );
+
+	GLuint buffers[] = { m_objectBuffer, m_drawBuffer, m_commandBuffer };
+	glDeleteBuffers( static_cast< GLsizei >( HELIUM_ARRAY_COUNT( buffers ) ), buffers );
+}
+
+/// @copydoc RGpuCullingBatch::MapObjects()
+RGpuCullingBatch::ObjectBounds* GLGpuCullingBatch::MapObjects()
+{
+	return m_pObjectStaging;
+}
+
+/// @copydoc RGpuCullingBatch::UnmapObjects()
+void GLGpuCullingBatch::UnmapObjects()
+{
+	m_bObjectsDirty = true;
+}
+
+/// @copydoc RGpuCullingBatch::MapDraws()
+RGpuCullingBatch::Draw* GLGpuCullingBatch::MapDraws()
+{
+	return m_pDrawStaging;
+}
+
+/// @copydoc RGpuCullingBatch::UnmapDraws()
+void GLGpuCullingBatch::UnmapDraws()
+{
+	m_bDrawsDirty = true;
+}
+
+/// Copy any object bounds and draw records changed since the last upload to their shader storage buffers.
+///
+/// This must only be called from the thread that owns the OpenGL context.
+void GLGpuCullingBatch::Upload()
+{
+	if( m_bObjectsDirty )
+	{
+		size_t size = sizeof( ObjectBounds ) * m_objectCapacity;
+		glBindBuffer( GL_SHADER_STORAGE_BUFFER, m_objectBuffer );
+		glBufferSubData( GL_SHADER_STORAGE_BUFFER, 0, static_cast< GLsizeiptr >( size ), m_pObjectStaging );
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, size );
+
+		m_bObjectsDirty = false;
+	}
+
+	if( m_bDrawsDirty && m_drawCount != 0 )
+	{
+		// Only the draw records in use need to be copied.
+		size_t size = sizeof( Draw ) * m_drawCount;
+		glBindBuffer( GL_SHADER_STORAGE_BUFFER, m_drawBuffer );
+		glBufferSubData( GL_SHADER_STORAGE_BUFFER, 0, static_cast< GLsizeiptr >( size ), m_pDrawStaging );
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, size );
+
+		m_bDrawsDirty = false;
+	}
+
+	glBindBuffer( GL_SHADER_STORAGE_BUFFER, 0 );
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Rendering/RGpuCullingBatch.h"
+
+#include "GL/glew.h"
+
+namespace Helium
+{
+	/// OpenGL GPU-driven culling batch implementation.
+	///
+	/// Object bounds and draw records are written to staging memory in system memory when mapped, so they can be
+	/// filled from any thread, and are copied to their shader storage buffers the next time the batch is culled.  The
+	/// culling pass writes one DrawElementsIndirectCommand per draw record to the indirect command buffer.
+	class GLGpuCullingBatch : public RGpuCullingBatch
+	{
+	public:
+		/// Size of each indirect draw command, in bytes.
+		static const size_t COMMAND_SIZE = sizeof( uint32_t ) * 5;
+
+		/// @name Construction/Destruction
+		//@{
+		GLGpuCullingBatch(
+			uint32_t objectCapacity, uint32_t drawCapacity, GLuint objectBuffer, GLuint drawBuffer,
+			GLuint commandBuffer );
+		//@}
+
+		/// @name Data Access
+		//@{
+		ObjectBounds* MapObjects();
+		void UnmapObjects();
+
+		Draw* MapDraws();
+		void UnmapDraws();
+
+		inline GLuint GetGLObjectBuffer() const;
+		inline GLuint GetGLDrawBuffer() const;
+		inline GLuint GetGLCommandBuffer() const;
+		//@}
+
+		/// @name Uploading
+		//@{
+		void Upload();
+		//@}
+
+	private:
+		/// Shader storage buffer holding the object bounds.
+		GLuint m_objectBuffer;
+		/// Shader storage buffer holding the draw records.
+		GLuint m_drawBuffer;
+		/// Indirect draw command buffer written by the culling pass.
+		GLuint m_commandBuffer;
+
+		/// Object bounds staging memory.
+		ObjectBounds* m_pObjectStaging;
+		/// Draw record staging memory.
+		Draw* m_pDrawStaging;
+		/// True if the object bounds staging memory has changed since it was last uploaded.
+		bool m_bObjectsDirty;
+		/// True if the draw record staging memory has changed since it was last uploaded.
+		bool m_bDrawsDirty;
+
+		/// @name Construction/Destruction
+		//@{
+		~GLGpuCullingBatch();
+		//@}
+	};
+}
+
+#include "RenderingGL/GLGpuCullingBatch.inl"
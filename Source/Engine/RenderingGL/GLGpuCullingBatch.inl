@@ -0,0 +1,26 @@
+namespace Helium
+{
+	/// Get the shader storage buffer holding the object bounds.
+	///
+	/// @return  OpenGL buffer object.
+	GLuint GLGpuCullingBatch::GetGLObjectBuffer() const
+	{
+		return m_objectBuffer;
+	}
+
+	/// Get the shader storage buffer holding the draw records.
+	///
+	/// @return  OpenGL buffer object.
+	GLuint GLGpuCullingBatch::GetGLDrawBuffer() const
+	{
+		return m_drawBuffer;
+	}
+
+	/// Get the indirect draw command buffer written by the culling pass.
+	///
+	/// @return  OpenGL buffer object.
+	GLuint GLGpuCullingBatch::GetGLCommandBuffer() const
+	{
+		return m_commandBuffer;
+	}
+}
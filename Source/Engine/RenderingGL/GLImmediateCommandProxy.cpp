@@ -1,23 +1,112 @@
 #include "Precompile.h"
 #include "RenderingGL/GLImmediateCommandProxy.h"
 
+#include "RenderingGL/GLConstantBuffer.h"
+#include "RenderingGL/GLFence.h"
+#include "RenderingGL/GLGpuCullingBatch.h"
+#include "RenderingGL/GLIndexBuffer.h"
+#include "RenderingGL/GLPixelShader.h"
+#include "RenderingGL/GLRenderCommandList.h"
 #include "RenderingGL/GLSurface.h"
+#include "RenderingGL/GLTexture2d.h"
+#include "RenderingGL/GLTimerQuery.h"
+#include "RenderingGL/GLVertexBuffer.h"
+#include "RenderingGL/GLVertexInputLayout.h"
+#include "RenderingGL/GLVertexShader.h"
+#include "Rendering/RendererUtil.h"
+#include "Engine/RenderStatistics.h"
 
 #include "GL/glew.h"
 #include "GLFW/glfw3.h"
 
 using namespace Helium;
 
+/// OpenGL primitive modes for each renderer primitive type.
+static const GLenum glPrimitiveTypes[] =
+{
+	// RENDERER_PRIMITIVE_TYPE_POINT_LIST
+	GL_POINTS,
+	// RENDERER_PRIMITIVE_TYPE_LINE_LIST
+	GL_LINES,
+	// RENDERER_PRIMITIVE_TYPE_LINE_STRIP
+	GL_LINE_STRIP,
+	// RENDERER_PRIMITIVE_TYPE_TRIANGLE_LIST
+	GL_TRIANGLES,
+	// RENDERER_PRIMITIVE_TYPE_TRIANGLE_STRIP
+	GL_TRIANGLE_STRIP,
+	// RENDERER_PRIMITIVE_TYPE_TRIANGLE_FAN
+	GL_TRIANGLE_FAN,
+};
+
 /// Constructor.
 GLImmediateCommandProxy::GLImmediateCommandProxy( GLFWwindow* pGlfwWindow )
 : m_pGlfwWindow( pGlfwWindow )
+, m_uniformBufferOffsetAlignment( 1 )
+, m_boundVertexArray( 0 )
+, m_boundProgram( 0 )
 {
     HELIUM_ASSERT( pGlfwWindow );
+	HELIUM_COMPILE_ASSERT( HELIUM_ARRAY_COUNT( glPrimitiveTypes ) == RENDERER_PRIMITIVE_TYPE_MAX );
+
+	ResetConstantBufferBindings();
+	ResetDrawBindings();
+}
+
+/// Create the stream buffer used for binding constant buffers.
+///
+/// This must be called once the OpenGL context is current and extensions have been loaded.
+///
+/// @param[in] bPersistentMapping  True if the stream buffer can be mapped persistently (GL 4.4 or
+///                                ARB_buffer_storage).
+///
+/// @return  True if initialization was successful, false if not.
+bool GLImmediateCommandProxy::InitializeConstantStreaming( bool bPersistentMapping )
+{
+	GLint maxBindings = 0;
+	glGetIntegerv( GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings );
+	if( static_cast< size_t >( maxBindings ) < HELIUM_ARRAY_COUNT( m_constantBufferBindings ) )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"GLImmediateCommandProxy: %" PRIuSZ " uniform buffer binding points are needed, but only %d are supported.\n",
+			HELIUM_ARRAY_COUNT( m_constantBufferBindings ),
+			maxBindings );
+		return false;
+	}
+
+	GLint offsetAlignment = 1;
+	glGetIntegerv( GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment );
+	m_uniformBufferOffsetAlignment = static_cast< size_t >( Max( offsetAlignment, 1 ) );
+
+	ResetConstantBufferBindings();
+
+	return m_constantStreamBuffer.Initialize(
+		GL_UNIFORM_BUFFER,
+		CONSTANT_STREAM_SEGMENT_SIZE,
+		bPersistentMapping );
+}
+
+/// Compile the compute program used for GPU-driven culling.
+///
+/// This must be called once the OpenGL context is current and extensions have been loaded, and requires OpenGL 4.3
+/// support.
+///
+/// @return  True if initialization was successful, false if not.
+bool GLImmediateCommandProxy::InitializeGpuCulling()
+{
+	return m_gpuCuller.Initialize();
 }
 
 /// Destructor.
 GLImmediateCommandProxy::~GLImmediateCommandProxy()
 {
+	glBindVertexArray( 0 );
+	glUseProgram( 0 );
+
+	m_vertexArrayCache.Clear();
+	m_programCache.Clear();
+	m_gpuCuller.Shutdown();
+
 	m_pGlfwWindow = NULL;
 }
 
@@ -27,7 +116,10 @@ void GLImmediateCommandProxy::SetRasterizerState( RRasterizerState* pState )
 	GLRasterizerState *pGLState = static_cast< GLRasterizerState* >( pState );
 	HELIUM_ASSERT( pGLState != NULL );
 
-	// TODO: don't make redundant state changes.
+	if( !m_stateFilter.SetRasterizerState( pState ) )
+	{
+		return;
+	}
 
 	glPolygonMode( GL_FRONT_AND_BACK, pGLState->m_fillMode );
 
@@ -59,7 +151,10 @@ void GLImmediateCommandProxy::SetBlendState( RBlendState* pState )
 	GLBlendState *pGLState = static_cast< GLBlendState* >( pState );
 	HELIUM_ASSERT( pGLState != NULL );
 
-	// TODO: don't make redundant state changes.
+	if( !m_stateFilter.SetBlendState( pState ) )
+	{
+		return;
+	}
 
 	glColorMask(
 		pGLState->m_redWriteMaskEnable,
@@ -87,7 +182,10 @@ void GLImmediateCommandProxy::SetDepthStencilState( RDepthStencilState* pState,
 	GLDepthStencilState *pGLState = static_cast< GLDepthStencilState* >( pState );
 	HELIUM_ASSERT( pGLState != NULL );
 
-	// TODO: don't make redundant state changes.
+	if( !m_stateFilter.SetDepthStencilState( pState, stencilReferenceValue ) )
+	{
+		return;
+	}
 
 	if( pGLState->m_depthTestEnable )
 	{
@@ -263,7 +361,12 @@ void GLImmediateCommandProxy::Clear( uint32_t clearFlags, const Color& rColor, f
 /// @copydoc RRenderCommandProxy::SetIndexBuffer()
 void GLImmediateCommandProxy::SetIndexBuffer( RIndexBuffer* pBuffer )
 {
-	HELIUM_BREAK();
+	if( !m_stateFilter.SetIndexBuffer( pBuffer ) )
+	{
+		return;
+	}
+
+	m_pIndexBuffer = static_cast< GLIndexBuffer* >( pBuffer );
 }
 
 /// @copydoc RRenderCommandProxy::SetVertexBuffers()
@@ -274,25 +377,67 @@ void GLImmediateCommandProxy::SetVertexBuffers(
 	uint32_t* pStrides,
 	uint32_t* pOffsets )
 {
-	HELIUM_BREAK();
+	HELIUM_ASSERT( ppBuffers || bufferCount == 0 );
+	HELIUM_ASSERT( pStrides || bufferCount == 0 );
+	HELIUM_ASSERT( pOffsets || bufferCount == 0 );
+
+	if( !m_stateFilter.SetVertexBuffers( startIndex, bufferCount, ppBuffers, pStrides, pOffsets ) )
+	{
+		return;
+	}
+
+	if( startIndex >= GLVertexDescription::BUFFER_COUNT_MAX )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"GLImmediateCommandProxy::SetVertexBuffers(): Start index (%" PRIuSZ ") exceeds the number of vertex streams available (%" PRIu32 ").\n",
+			startIndex,
+			GLVertexDescription::BUFFER_COUNT_MAX );
+
+		return;
+	}
+
+	bufferCount = Min< size_t >( bufferCount, GLVertexDescription::BUFFER_COUNT_MAX - startIndex );
+	for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+	{
+		GLVertexArrayCache::Stream& rStream = m_vertexStreams[ startIndex + bufferIndex ];
+		rStream.pBuffer = static_cast< GLVertexBuffer* >( ppBuffers[ bufferIndex ] );
+		rStream.stride = pStrides[ bufferIndex ];
+		rStream.offset = pOffsets[ bufferIndex ];
+	}
 }
 
 /// @copydoc RRenderCommandProxy::SetVertexInputLayout()
 void GLImmediateCommandProxy::SetVertexInputLayout( RVertexInputLayout* pLayout )
 {
-	HELIUM_BREAK();
+	if( !m_stateFilter.SetVertexInputLayout( pLayout ) )
+	{
+		return;
+	}
+
+	m_pVertexInputLayout = static_cast< GLVertexInputLayout* >( pLayout );
 }
 
 /// @copydoc RRenderCommandProxy::SetVertexShader()
 void GLImmediateCommandProxy::SetVertexShader( RVertexShader* pShader )
 {
-	HELIUM_BREAK();
+	if( !m_stateFilter.SetVertexShader( pShader ) )
+	{
+		return;
+	}
+
+	m_pVertexShader = static_cast< GLVertexShader* >( pShader );
 }
 
 /// @copydoc RRenderCommandProxy::SetPixelShader()
 void GLImmediateCommandProxy::SetPixelShader( RPixelShader* pShader )
 {
-	HELIUM_BREAK();
+	if( !m_stateFilter.SetPixelShader( pShader ) )
+	{
+		return;
+	}
+
+	m_pPixelShader = static_cast< GLPixelShader* >( pShader );
 }
 
 /// @copydoc RRenderCommandProxy::SetVertexConstantBuffers()
@@ -300,9 +445,10 @@ void GLImmediateCommandProxy::SetVertexConstantBuffers(
 	size_t startIndex,
 	size_t bufferCount,
 	RConstantBuffer* const* ppBuffers,
-	const size_t* pLimitSizes )
+	const size_t* pLimitSizes,
+	const size_t* pOffsets )
 {
-	// TODO: Implement later. HELIUM_BREAK();
+	SetConstantBuffers( 0, startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets );
 }
 
 /// @copydoc RRenderCommandProxy::SetPixelConstantBuffers()
@@ -310,15 +456,28 @@ void GLImmediateCommandProxy::SetPixelConstantBuffers(
 	size_t startIndex,
 	size_t bufferCount,
 	RConstantBuffer* const* ppBuffers,
-	const size_t* pLimitSizes )
+	const size_t* pLimitSizes,
+	const size_t* pOffsets )
 {
-	// TODO: Implement later. HELIUM_BREAK();
+	SetConstantBuffers( CONSTANT_BUFFER_SLOT_COUNT, startIndex, bufferCount, ppBuffers, pLimitSizes, pOffsets );
 }
 
 /// @copydoc RRenderCommandProxy::SetTexture()
 void GLImmediateCommandProxy::SetTexture( size_t samplerIndex, RTexture* pTexture )
 {
-	HELIUM_BREAK();
+	if( !m_stateFilter.SetTexture( samplerIndex, pTexture ) )
+	{
+		return;
+	}
+
+	GLuint texture = 0;
+	if( pTexture && pTexture->GetType() == RTexture::TYPE_2D )
+	{
+		texture = static_cast< GLTexture2d* >( pTexture )->GetGLTexture();
+	}
+
+	glActiveTexture( GL_TEXTURE0 + static_cast< GLenum >( samplerIndex ) );
+	glBindTexture( GL_TEXTURE_2D, texture );
 }
 
 /// @copydoc RRenderCommandProxy::DrawIndexed()
@@ -330,7 +489,61 @@ void GLImmediateCommandProxy::DrawIndexed(
 	uint32_t startIndex,
 	uint32_t primitiveCount )
 {
-	HELIUM_BREAK();
+	HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
+
+	if( !PrepareDraw( true ) )
+	{
+		return;
+	}
+
+	RenderStatistics::RecordDraw( primitiveCount, 0 );
+
+	GLenum elementType = m_pIndexBuffer->GetGLElementType();
+	size_t indexSize = ( elementType == GL_UNSIGNED_INT ? sizeof( uint32_t ) : sizeof( uint16_t ) );
+	size_t indexOffset = m_pIndexBuffer->GetGLOffset() + static_cast< size_t >( startIndex ) * indexSize;
+
+	glDrawRangeElementsBaseVertex(
+		glPrimitiveTypes[ primitiveType ],
+		minIndex,
+		minIndex + usedVertexCount - 1,
+		static_cast< GLsizei >( RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) ),
+		elementType,
+		reinterpret_cast< const void* >( indexOffset ),
+		static_cast< GLint >( baseVertexIndex ) );
+}
+
+/// @copydoc RRenderCommandProxy::DrawIndexedInstanced()
+void GLImmediateCommandProxy::DrawIndexedInstanced(
+	ERendererPrimitiveType primitiveType,
+	uint32_t baseVertexIndex,
+	uint32_t /*minIndex*/,
+	uint32_t /*usedVertexCount*/,
+	uint32_t startIndex,
+	uint32_t primitiveCount,
+	uint32_t instanceCount )
+{
+	HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
+	HELIUM_ASSERT( instanceCount != 0 );
+
+	// Attributes from the second vertex stream onward advance once per instance (see GLVertexArrayCache).
+	if( !PrepareDraw( true ) )
+	{
+		return;
+	}
+
+	RenderStatistics::RecordDraw( primitiveCount, instanceCount );
+
+	GLenum elementType = m_pIndexBuffer->GetGLElementType();
+	size_t indexSize = ( elementType == GL_UNSIGNED_INT ? sizeof( uint32_t ) : sizeof( uint16_t ) );
+	size_t indexOffset = m_pIndexBuffer->GetGLOffset() + static_cast< size_t >( startIndex ) * indexSize;
+
+	glDrawElementsInstancedBaseVertex(
+		glPrimitiveTypes[ primitiveType ],
+		static_cast< GLsizei >( RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) ),
+		elementType,
+		reinterpret_cast< const void* >( indexOffset ),
+		static_cast< GLsizei >( instanceCount ),
+		static_cast< GLint >( baseVertexIndex ) );
 }
 
 /// @copydoc RRenderCommandProxy::DrawUnindexed()
@@ -339,28 +552,333 @@ void GLImmediateCommandProxy::DrawUnindexed(
 	uint32_t baseVertexIndex,
 	uint32_t primitiveCount )
 {
-	HELIUM_BREAK();}
+	HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
+
+	if( !PrepareDraw( false ) )
+	{
+		return;
+	}
+
+	RenderStatistics::RecordDraw( primitiveCount, 0 );
+
+	glDrawArrays(
+		glPrimitiveTypes[ primitiveType ],
+		static_cast< GLint >( baseVertexIndex ),
+		static_cast< GLsizei >( RendererUtil::PrimitiveCountToIndexCount( primitiveType, primitiveCount ) ) );
+}
+
+/// @copydoc RRenderCommandProxy::CullGpuDraws()
+void GLImmediateCommandProxy::CullGpuDraws(
+	RGpuCullingBatch* pBatch,
+	const float32_t* pViewProjection,
+	RTexture2d* pDepthPyramid )
+{
+	HELIUM_ASSERT( pBatch );
+	HELIUM_ASSERT( pViewProjection );
+
+	if( !m_gpuCuller.GetGLProgram() )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLImmediateCommandProxy: GPU culling is not supported.\n" );
+
+		return;
+	}
+
+	m_gpuCuller.Cull(
+		static_cast< GLGpuCullingBatch* >( pBatch ),
+		pViewProjection,
+		static_cast< GLTexture2d* >( pDepthPyramid ) );
+
+	// The culling program is left bound, so the next draw needs to rebind its own program.
+	m_boundProgram = m_gpuCuller.GetGLProgram();
+}
+
+/// @copydoc RRenderCommandProxy::DrawGpuCulled()
+void GLImmediateCommandProxy::DrawGpuCulled( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch )
+{
+	HELIUM_ASSERT( static_cast< size_t >( primitiveType ) < static_cast< size_t >( RENDERER_PRIMITIVE_TYPE_MAX ) );
+	HELIUM_ASSERT( pBatch );
+
+	GLGpuCullingBatch* pGLBatch = static_cast< GLGpuCullingBatch* >( pBatch );
+	uint32_t drawCount = pGLBatch->GetDrawCount();
+	if( drawCount == 0 || !PrepareDraw( true ) )
+	{
+		return;
+	}
+
+	// Indirect commands address indices relative to the start of the buffer, so streamed index buffers cannot be used.
+	HELIUM_ASSERT_MSG(
+		m_pIndexBuffer->GetGLOffset() == 0,
+		"GLImmediateCommandProxy: GPU-culled draws require a static index buffer" );
+
+	// Primitive counts are only known on the GPU, so only the draw call itself is recorded.
+	RenderStatistics::RecordDraw( 0, 0 );
+
+	glBindBuffer( GL_DRAW_INDIRECT_BUFFER, pGLBatch->GetGLCommandBuffer() );
+	glMultiDrawElementsIndirect(
+		glPrimitiveTypes[ primitiveType ],
+		m_pIndexBuffer->GetGLElementType(),
+		NULL,
+		static_cast< GLsizei >( drawCount ),
+		0 );
+	glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+}
 
 /// @copydoc RRenderCommandProxy::SetFence()
 void GLImmediateCommandProxy::SetFence( RFence* pFence )
 {
-	HELIUM_BREAK();
+	HELIUM_ASSERT( pFence );
+
+	static_cast< GLFence* >( pFence )->Set();
+}
+
+/// @copydoc RRenderCommandProxy::IssueTimerQuery()
+void GLImmediateCommandProxy::IssueTimerQuery( RTimerQuery* pQuery )
+{
+	HELIUM_ASSERT( pQuery );
+
+	static_cast< GLTimerQuery* >( pQuery )->Issue();
 }
 
 /// @copydoc RRenderCommandProxy::UnbindResources()
 void GLImmediateCommandProxy::UnbindResources()
 {
-	// TODO: Implement later.  HELIUM_BREAK();
+	m_stateFilter.Reset();
+
+	// Forget the bound constant buffers so that buffers released afterward cannot be mistaken for the bound ones.
+	ResetConstantBufferBindings();
+	ResetDrawBindings();
+
+	// Unbind the vertex array and program so that cached objects can be deleted, then age the caches.
+	if( m_boundVertexArray )
+	{
+		glBindVertexArray( 0 );
+		m_boundVertexArray = 0;
+	}
+
+	if( m_boundProgram )
+	{
+		glUseProgram( 0 );
+		m_boundProgram = 0;
+	}
+
+	m_vertexArrayCache.Tick();
+	m_programCache.Tick();
 }
 
 /// @copydoc RRenderCommandProxy::ExecuteCommandList()
 void GLImmediateCommandProxy::ExecuteCommandList( RRenderCommandList* pCommandList )
 {
-	HELIUM_BREAK();
+	HELIUM_ASSERT( pCommandList );
+
+	for( GLRenderCommandList* pRenderCommandList = static_cast< GLRenderCommandList* >( pCommandList );
+		pRenderCommandList != NULL;
+		pRenderCommandList = pRenderCommandList->GetNext() )
+	{
+		GLRenderCommandList::Iterator listEnd = pRenderCommandList->End();
+		for( GLRenderCommandList::Iterator listIter = pRenderCommandList->Begin(); listIter != listEnd; ++listIter )
+		{
+			GLRenderCommand& rCommand = *listIter;
+			rCommand.Execute( this );
+		}
+	}
 }
 
 /// @copydoc RRenderCommandProxy::FinishCommandList()
 void GLImmediateCommandProxy::FinishCommandList( RRenderCommandListPtr& rspCommandList )
 {
-	HELIUM_BREAK();
+	HELIUM_TRACE(
+		TraceLevels::Error,
+		"GLImmediateCommandProxy: FinishCommandList() called on an immediate command proxy.\n" );
+
+	HELIUM_BREAK_MSG( "GLImmediateCommandProxy: FinishCommandList() called on an immediate command proxy" );
+
+	rspCommandList.Release();
+}
+
+/// Copy the contents of a set of constant buffers to the constant stream buffer and bind them as uniform buffer
+/// ranges.
+///
+/// Buffers already bound to the same binding point are only copied again if their contents have changed or their
+/// previous copy is about to be overwritten.
+///
+/// @param[in] bindingBase  First uniform buffer binding point for the shader type being set.
+/// @param[in] startIndex   Index of the first constant buffer slot to set.
+/// @param[in] bufferCount  Number of constant buffer slots to set.
+/// @param[in] ppBuffers    Constant buffers to bind (individual entries can be null to unbind a slot).
+/// @param[in] pLimitSizes  Optional maximum number of bytes to use from each buffer.
+/// @param[in] pOffsets     Optional offset of the first byte to use from each buffer.
+void GLImmediateCommandProxy::SetConstantBuffers(
+	size_t bindingBase,
+	size_t startIndex,
+	size_t bufferCount,
+	RConstantBuffer* const* ppBuffers,
+	const size_t* pLimitSizes,
+	const size_t* pOffsets )
+{
+	HELIUM_ASSERT( ppBuffers || bufferCount == 0 );
+
+	HELIUM_ASSERT( startIndex + bufferCount <= CONSTANT_BUFFER_SLOT_COUNT );
+	if( startIndex >= CONSTANT_BUFFER_SLOT_COUNT )
+	{
+		return;
+	}
+
+	bufferCount = Min( bufferCount, CONSTANT_BUFFER_SLOT_COUNT - startIndex );
+
+	if( !m_constantStreamBuffer.GetGLBuffer() )
+	{
+		return;
+	}
+
+	uint64_t segmentSerial = m_constantStreamBuffer.GetSegmentSerial();
+
+	for( size_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+	{
+		size_t bindingIndex = bindingBase + startIndex + bufferIndex;
+		ConstantBufferBinding& rBinding = m_constantBufferBindings[ bindingIndex ];
+
+		const GLConstantBuffer* pBuffer = static_cast< const GLConstantBuffer* >( ppBuffers[ bufferIndex ] );
+		if( !pBuffer )
+		{
+			if( rBinding.pBuffer )
+			{
+				glBindBufferBase( GL_UNIFORM_BUFFER, static_cast< GLuint >( bindingIndex ), 0 );
+				rBinding.pBuffer = NULL;
+			}
+
+			continue;
+		}
+
+		size_t size = static_cast< size_t >( pBuffer->GetRegisterCount() ) * sizeof( float32_t ) * 4;
+		size_t bufferOffset = 0;
+		if( pOffsets )
+		{
+			HELIUM_ASSERT( pOffsets[ bufferIndex ] % CONSTANT_BUFFER_OFFSET_ALIGNMENT == 0 );
+			bufferOffset = Min( size, pOffsets[ bufferIndex ] );
+			size -= bufferOffset;
+		}
+
+		if( pLimitSizes )
+		{
+			size = Min( size, pLimitSizes[ bufferIndex ] );
+		}
+
+		if( size == 0 )
+		{
+			continue;
+		}
+
+		// Skip redundant copies of buffers that have not changed since they were last bound here.
+		uint32_t tag = pBuffer->GetTag();
+		if( rBinding.pBuffer == pBuffer &&
+			rBinding.tag == tag &&
+			rBinding.bufferOffset == bufferOffset &&
+			rBinding.size == size &&
+			segmentSerial - rBinding.segmentSerial < GLStreamBuffer::SEGMENT_COUNT - 1 )
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		void* pStreamData = m_constantStreamBuffer.Allocate( size, m_uniformBufferOffsetAlignment, offset );
+		if( !pStreamData )
+		{
+			continue;
+		}
+
+		MemoryCopy( pStreamData, static_cast< const uint8_t* >( pBuffer->GetData() ) + bufferOffset, size );
+		m_constantStreamBuffer.Unmap();
+
+		glBindBufferRange(
+			GL_UNIFORM_BUFFER,
+			static_cast< GLuint >( bindingIndex ),
+			m_constantStreamBuffer.GetGLBuffer(),
+			static_cast< GLintptr >( offset ),
+			static_cast< GLsizeiptr >( size ) );
+
+		rBinding.pBuffer = pBuffer;
+		rBinding.tag = tag;
+		rBinding.bufferOffset = bufferOffset;
+		rBinding.size = size;
+
+		// Allocation may have moved on to a new segment.
+		segmentSerial = m_constantStreamBuffer.GetSegmentSerial();
+		rBinding.segmentSerial = segmentSerial;
+	}
+}
+
+/// Clear the record of constant buffers bound to each uniform buffer binding point.
+void GLImmediateCommandProxy::ResetConstantBufferBindings()
+{
+	for( size_t bindingIndex = 0; bindingIndex < HELIUM_ARRAY_COUNT( m_constantBufferBindings ); ++bindingIndex )
+	{
+		ConstantBufferBinding& rBinding = m_constantBufferBindings[ bindingIndex ];
+		rBinding.pBuffer = NULL;
+		rBinding.tag = 0;
+		rBinding.bufferOffset = 0;
+		rBinding.size = 0;
+		rBinding.segmentSerial = 0;
+	}
+}
+
+/// Bind the vertex array object and program for the current draw inputs, creating them if necessary.
+///
+/// @param[in] bIndexed  True if preparing for an indexed draw, false if preparing for an unindexed draw.
+///
+/// @return  True if the draw can be issued, false if an input is missing or its GL objects could not be created.
+bool GLImmediateCommandProxy::PrepareDraw( bool bIndexed )
+{
+	if( !m_pVertexInputLayout || ( bIndexed && !m_pIndexBuffer ) )
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "GLImmediateCommandProxy: Draw issued without a complete set of inputs.\n" );
+
+		return false;
+	}
+
+	// Program linking and vertex array creation both leave the new object bound.
+	GLuint program = m_programCache.GetProgram( m_pVertexShader, m_pPixelShader );
+	if( !program )
+	{
+		return false;
+	}
+
+	if( program != m_boundProgram )
+	{
+		glUseProgram( program );
+		m_boundProgram = program;
+	}
+
+	GLuint vertexArray = m_vertexArrayCache.GetVertexArray(
+		m_pVertexInputLayout->GetDescription(),
+		m_vertexStreams,
+		( bIndexed ? m_pIndexBuffer : NULL ) );
+	if( !vertexArray )
+	{
+		return false;
+	}
+
+	if( vertexArray != m_boundVertexArray )
+	{
+		glBindVertexArray( vertexArray );
+		m_boundVertexArray = vertexArray;
+	}
+
+	return true;
+}
+
+/// Clear the record of the vertex buffers, index buffer, input layout, and shaders set for draws.
+void GLImmediateCommandProxy::ResetDrawBindings()
+{
+	for( size_t streamIndex = 0; streamIndex < HELIUM_ARRAY_COUNT( m_vertexStreams ); ++streamIndex )
+	{
+		GLVertexArrayCache::Stream& rStream = m_vertexStreams[ streamIndex ];
+		rStream.pBuffer = NULL;
+		rStream.stride = 0;
+		rStream.offset = 0;
+	}
+
+	m_pIndexBuffer = NULL;
+	m_pVertexInputLayout = NULL;
+	m_pVertexShader = NULL;
+	m_pPixelShader = NULL;
 }
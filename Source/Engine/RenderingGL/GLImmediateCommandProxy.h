@@ -5,6 +5,10 @@
 #include "RenderingGL/GLBlendState.h"
 #include "RenderingGL/GLDepthStencilState.h"
 #include "RenderingGL/GLSamplerState.h"
+#include "RenderingGL/GLStreamBuffer.h"
+#include "RenderingGL/GLVertexArrayCache.h"
+#include "RenderingGL/GLProgramCache.h"
+#include "RenderingGL/GLGpuCuller.h"
 #include "Rendering/RRenderCommandProxy.h"
 
 struct GLFWwindow;
@@ -16,15 +20,37 @@ namespace Helium
 	HELIUM_DECLARE_RPTR( GLDepthStencilState );
 	HELIUM_DECLARE_RPTR( GLSamplerState );
 
+	class GLConstantBuffer;
+	class GLVertexInputLayout;
+
 	/// Render command proxy for immediate issuing of rendering commands to the GPU command buffer.
+	///
+	/// Constant buffer contents are copied into a stream buffer when bound, and each buffer is bound as a range of the
+	/// stream buffer to a uniform buffer binding point.  Vertex constant buffer slots map to the first
+	/// CONSTANT_BUFFER_SLOT_COUNT binding points, followed by the pixel constant buffer slots.
+	///
+	/// Vertex buffers, the index buffer, the input layout, and shaders are only recorded when set.  At draw time, the
+	/// vertex array object for the recorded inputs and the linked program for the recorded shader pair are looked up in
+	/// their caches, and each is only bound if it differs from the one currently bound.
 	class GLImmediateCommandProxy : public RRenderCommandProxy
 	{
 	public:
+		/// Number of constant buffer slots for each shader type.
+		static const size_t CONSTANT_BUFFER_SLOT_COUNT = 8;
+		/// Size of each segment of the constant buffer stream, in bytes.
+		static const size_t CONSTANT_STREAM_SEGMENT_SIZE = 1024 * 1024;
+
 		/// @name Construction/Destruction
 		//@{
 		GLImmediateCommandProxy( GLFWwindow* pGlfwWindow );
 		//@}
 
+		/// @name Initialization
+		//@{
+		bool InitializeConstantStreaming( bool bPersistentMapping );
+		bool InitializeGpuCulling();
+		//@}
+
 		/// @name State Management
 		//@{
 		void SetRasterizerState( RRasterizerState* pState );
@@ -57,24 +83,38 @@ namespace Helium
 
 		void SetVertexConstantBuffers(
 			size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
-			const size_t* pLimitSizes = NULL );
+			const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL );
 		void SetPixelConstantBuffers(
 			size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
-			const size_t* pLimitSizes = NULL );
+			const size_t* pLimitSizes = NULL, const size_t* pOffsets = NULL );
 
 		void SetTexture( size_t samplerIndex, RTexture* pTexture );
 
 		void DrawIndexed(
 			ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
 			uint32_t startIndex, uint32_t primitiveCount );
+		void DrawIndexedInstanced(
+			ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t minIndex, uint32_t usedVertexCount,
+			uint32_t startIndex, uint32_t primitiveCount, uint32_t instanceCount );
 		void DrawUnindexed( ERendererPrimitiveType primitiveType, uint32_t baseVertexIndex, uint32_t primitiveCount );
 		//@}
 
+		/// @name GPU-Driven Culling Commands
+		//@{
+		void CullGpuDraws( RGpuCullingBatch* pBatch, const float32_t* pViewProjection, RTexture2d* pDepthPyramid );
+		void DrawGpuCulled( ERendererPrimitiveType primitiveType, RGpuCullingBatch* pBatch );
+		//@}
+
 		/// @name Fence Commands
 		//@{
 		void SetFence( RFence* pFence );
 		//@}
 
+		/// @name Timer Query Commands
+		//@{
+		void IssueTimerQuery( RTimerQuery* pQuery );
+		//@}
+
 		/// @name Miscellaneous Resource Management
 		//@{
 		void UnbindResources();
@@ -87,12 +127,68 @@ namespace Helium
 		//@}
 
 	private:
+		/// Constant buffer bound to a uniform buffer binding point.
+		struct ConstantBufferBinding
+		{
+			/// Bound constant buffer.
+			const GLConstantBuffer* pBuffer;
+			/// Constant buffer map tag when its contents were copied to the stream buffer.
+			uint32_t tag;
+			/// Offset within the constant buffer of the first byte copied to the stream buffer.
+			size_t bufferOffset;
+			/// Number of bytes copied to the stream buffer.
+			size_t size;
+			/// Stream buffer segment serial number when the contents were copied.
+			uint64_t segmentSerial;
+		};
+
 		/// GLFW window / OpenGL context
 		GLFWwindow *m_pGlfwWindow;
 
+		/// Stream buffer to which constant buffer contents are copied for binding.
+		GLStreamBuffer m_constantStreamBuffer;
+		/// Required alignment of uniform buffer range offsets.
+		size_t m_uniformBufferOffsetAlignment;
+		/// Constant buffers bound to each uniform buffer binding point.
+		ConstantBufferBinding m_constantBufferBindings[ CONSTANT_BUFFER_SLOT_COUNT * 2 ];
+
+		/// Vertex buffers set for each vertex stream.
+		GLVertexArrayCache::Stream m_vertexStreams[ GLVertexDescription::BUFFER_COUNT_MAX ];
+		/// Index buffer set for indexed draws.
+		GLIndexBuffer* m_pIndexBuffer;
+		/// Vertex input layout set for draws.
+		GLVertexInputLayout* m_pVertexInputLayout;
+		/// Vertex shader set for draws.
+		GLVertexShader* m_pVertexShader;
+		/// Pixel shader set for draws.
+		GLPixelShader* m_pPixelShader;
+
+		/// Vertex array objects for each vertex description and set of buffers.
+		GLVertexArrayCache m_vertexArrayCache;
+		/// Linked programs for each shader pair.
+		GLProgramCache m_programCache;
+		/// Currently bound vertex array object.
+		GLuint m_boundVertexArray;
+		/// Currently bound program.
+		GLuint m_boundProgram;
+
+		/// Compute pass used to cull GPU-driven draw batches.
+		GLGpuCuller m_gpuCuller;
+
 		/// @name Construction/Destruction
 		//@{
 		~GLImmediateCommandProxy();
 		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		void SetConstantBuffers(
+			size_t bindingBase, size_t startIndex, size_t bufferCount, RConstantBuffer* const* ppBuffers,
+			const size_t* pLimitSizes, const size_t* pOffsets );
+		void ResetConstantBufferBindings();
+
+		bool PrepareDraw( bool bIndexed );
+		void ResetDrawBindings();
+		//@}
 	};
 }
@@ -3,6 +3,9 @@
 #include "RenderingGL.h"
 #include "RenderingGL/GLIndexBuffer.h"
 
+#include "RenderingGL/GLStreamBuffer.h"
+#include "Engine/RenderStatistics.h"
+
 #include "GL/glew.h"
 
 using namespace Helium;
@@ -13,13 +16,38 @@ using namespace Helium;
 GLIndexBuffer::GLIndexBuffer( GLenum elementType, unsigned buffer )
 : m_elementType( elementType )
 , m_buffer( buffer )
+, m_pStreamBuffer( NULL )
+, m_offset( 0 )
 {
 	HELIUM_ASSERT( buffer != 0 );
 }
 
+/// Constructor.
+///
+/// @param[in] pStreamBuffer  Stream buffer holding the index data of a dynamic buffer, with a segment size matching
+///                           the buffer size.  It will be deleted when this object is destroyed.
+GLIndexBuffer::GLIndexBuffer( GLenum elementType, GLStreamBuffer* pStreamBuffer )
+: m_elementType( elementType )
+, m_buffer( 0 )
+, m_pStreamBuffer( pStreamBuffer )
+, m_offset( 0 )
+{
+	HELIUM_ASSERT( pStreamBuffer );
+	m_buffer = pStreamBuffer->GetGLBuffer();
+	HELIUM_ASSERT( m_buffer != 0 );
+}
+
 /// Destructor.
 GLIndexBuffer::~GLIndexBuffer()
 {
+	if( m_pStreamBuffer )
+	{
+		// The stream buffer owns the buffer object.
+		delete m_pStreamBuffer;
+		m_pStreamBuffer = NULL;
+		m_buffer = 0;
+	}
+
 	if( m_buffer )
 	{
 		glDeleteBuffers( 1, &m_buffer );
@@ -38,6 +66,32 @@ void* GLIndexBuffer::Map( ERendererBufferMapHint hint )
 		return NULL;
 	}
 
+	// Dynamic buffers write discarded contents to the next stream buffer segment instead of waiting for the GPU.
+	if( m_pStreamBuffer )
+	{
+		size_t size = m_pStreamBuffer->GetSegmentSize();
+		void* pStreamData = NULL;
+		if( hint == RENDERER_BUFFER_MAP_HINT_DISCARD )
+		{
+			pStreamData = m_pStreamBuffer->Allocate( size, 1, m_offset );
+		}
+		else
+		{
+			pStreamData = m_pStreamBuffer->MapRange( m_offset, size );
+		}
+
+		if( !pStreamData )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "GLIndexBuffer::Map(): Failed to map OpenGL stream buffer.\n" );
+		}
+		else
+		{
+			RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, size );
+		}
+
+		return pStreamData;
+	}
+
 	// Determine usage hints for mapping the buffer.
 	// "Discard" assumes only write operations, while "NO_OVERWRITE" assumes
 	// only read operations.
@@ -51,15 +105,18 @@ void* GLIndexBuffer::Map( ERendererBufferMapHint hint )
 		accessFlags |= GL_MAP_READ_BIT;
 	}
 
-	// Map the buffer to client memory.
-	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_buffer );
-	void* pData = glMapBuffer( GL_ELEMENT_ARRAY_BUFFER, accessFlags );
+	// Map the buffer to client memory.  The element array binding is part of the bound vertex array object state, so
+	// the array buffer binding point is used instead.
+	glBindBuffer( GL_ARRAY_BUFFER, m_buffer );
+	void* pData = glMapBuffer( GL_ARRAY_BUFFER, accessFlags );
 	if( !pData )
 	{
 		HELIUM_TRACE( TraceLevels::Error, "GLIndexBuffer::Map(): Failed to map OpenGL buffer.\n" );
 		return NULL;
 	}
 
+	RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, GetTrackedMemorySize() );
+
 	// Return a pointer to the mapped buffer data.
 	HELIUM_ASSERT( pData );
 	return pData;
@@ -76,9 +133,15 @@ void GLIndexBuffer::Unmap()
 		return;
 	}
 
+	if( m_pStreamBuffer )
+	{
+		m_pStreamBuffer->Unmap();
+		return;
+	}
+
 	// Unbind the buffer from client memory.
-	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_buffer );
-	GLboolean result = glUnmapBuffer( GL_ELEMENT_ARRAY_BUFFER );
+	glBindBuffer( GL_ARRAY_BUFFER, m_buffer );
+	GLboolean result = glUnmapBuffer( GL_ARRAY_BUFFER );
 	if( result == GL_FALSE )
 	{
 		HELIUM_TRACE(
@@ -8,13 +8,19 @@
 
 namespace Helium
 {
+	class GLStreamBuffer;
+
 	/// OpenGL index buffer implementation.
+	///
+	/// Dynamic index buffers are backed by a stream buffer, with each discarding Map() call writing to the next
+	/// segment, so the buffer can be refilled without waiting for draw calls using its previous contents.
 	class GLIndexBuffer : public RIndexBuffer
 	{
 	public:
 		/// @name Construction/Destruction
 		//@{
 		GLIndexBuffer( GLenum elementType, unsigned buffer );
+		GLIndexBuffer( GLenum elementType, GLStreamBuffer* pStreamBuffer );
 		//@}
 
 		/// @name Data Access
@@ -23,6 +29,7 @@ namespace Helium
 		virtual void Unmap() override;
 
 		inline unsigned GetGLBuffer() const;
+		inline size_t GetGLOffset() const;
 		inline GLenum GetGLElementType() const;
 		//@}
 
@@ -30,6 +37,10 @@ namespace Helium
 		/// Buffer instance and type
 		GLenum m_elementType;
 		unsigned m_buffer;
+		/// Stream buffer holding the index data for dynamic buffers (null for static buffers).
+		GLStreamBuffer* m_pStreamBuffer;
+		/// Offset of the current index data within the buffer object.
+		size_t m_offset;
 
 		/// @name Construction/Destruction
 		//@{
@@ -8,6 +8,17 @@ namespace Helium
 		return m_buffer;
 	}
 
+	/// Get the offset of the current index data within the OpenGL index buffer.
+	///
+	/// This is always zero for static buffers, while dynamic buffers move to a new offset each time they are mapped
+	/// with RENDERER_BUFFER_MAP_HINT_DISCARD.
+	///
+	/// @return  Index data offset, in bytes.
+	size_t GLIndexBuffer::GetGLOffset() const
+	{
+		return m_offset;
+	}
+
 	/// Get the OpenGL index buffer.
 	///
 	/// @return  OpenGL index buffer handle.
@@ -1,5 +1,6 @@
 #include "Precompile.h"
 #include "RenderingGL/GLMainContext.h"
+#include "RenderingGL/GLFence.h"
 #include "RenderingGL/GLSurface.h"
 
 #include "GL/glew.h"
@@ -8,9 +9,14 @@
 using namespace Helium;
 
 /// Constructor.
-GLMainContext::GLMainContext( GLFWwindow* pGlfwWindow )
+///
+/// @param[in] pGlfwWindow     GLFW window owning the OpenGL context.
+/// @param[in] frameRateLimit  Maximum number of frames presented per second (0 for no limit).
+GLMainContext::GLMainContext( GLFWwindow* pGlfwWindow, uint32_t frameRateLimit )
 : m_pGlfwWindow( pGlfwWindow )
 , m_spBackBufferSurface( NULL )
+, m_frameFenceIndex( 0 )
+, m_frameLimiter( frameRateLimit )
 {
 	HELIUM_ASSERT( pGlfwWindow );
 }
@@ -57,9 +63,49 @@ RSurface* GLMainContext::GetBackBufferSurface()
 	return m_spBackBufferSurface;
 }
 
+/// @copydoc RRenderContext::Resize()
+///
+/// The default framebuffer follows the size of the window on its own, so only the storage of the back buffer
+/// renderbuffer is reallocated (the renderbuffer object and the surface referencing it are kept).
+bool GLMainContext::Resize( uint32_t width, uint32_t height )
+{
+	if( !m_spBackBufferSurface || width == 0 || height == 0 )
+	{
+		return true;
+	}
+
+	GLint curRenderbuffer = 0;
+	glGetIntegerv( GL_RENDERBUFFER_BINDING, &curRenderbuffer );
+
+	glBindRenderbuffer( GL_RENDERBUFFER, m_spBackBufferSurface->GetGLSurface() );
+	glRenderbufferStorage( GL_RENDERBUFFER, GL_RGBA8, static_cast< GLsizei >( width ), static_cast< GLsizei >( height ) );
+
+	glBindRenderbuffer( GL_RENDERBUFFER, curRenderbuffer );
+
+	return true;
+}
+
 /// @copydoc RRenderContext::Swap()
 void GLMainContext::Swap()
 {
-	// Present the scene.
+	// Present the scene once it is due.
+	m_frameLimiter.Wait();
 	glfwSwapBuffers( m_pGlfwWindow );
+
+	// Wait for the oldest frame still allowed in flight to finish before letting the CPU start on another one, then
+	// fence the frame just presented in its place.
+	GLFencePtr& rspFrameFence = m_frameFences[ m_frameFenceIndex ];
+	if( rspFrameFence )
+	{
+		rspFrameFence->Wait();
+	}
+	else
+	{
+		rspFrameFence = new GLFence;
+		HELIUM_ASSERT( rspFrameFence );
+	}
+
+	rspFrameFence->Set();
+
+	m_frameFenceIndex = ( m_frameFenceIndex + 1 ) % HELIUM_ARRAY_COUNT( m_frameFences );
 }
@@ -2,26 +2,39 @@
 
 #include "RenderingGL/RenderingGL.h"
 #include "Rendering/RRenderContext.h"
+#include "Rendering/FrameLimiter.h"
 
 struct GLFWwindow;
 
 namespace Helium
 {
 	HELIUM_DECLARE_RPTR( GLSurface );
+	HELIUM_DECLARE_RPTR( GLFence );
 
 	/// Interface to the main GLFW render context.
+	///
+	/// Presenting a frame waits as needed so that the CPU never gets more than MAX_FRAMES_IN_FLIGHT - 1 frames ahead
+	/// of the GPU.  Resources written by the CPU once per frame are then safe to reuse after MAX_FRAMES_IN_FLIGHT
+	/// frames, such as the double-buffered dynamic constant buffers of GraphicsScene.  If a frame rate limit is set, the
+	/// frame limiter paces frames before they are presented, so any time spent waiting on the GPU afterward counts
+	/// towards the next frame's interval instead of adding to it.
 	class GLMainContext : public RRenderContext
 	{
 	public:
+		/// Maximum number of frames being processed at once, counting the frame being prepared by the CPU.
+		static const size_t MAX_FRAMES_IN_FLIGHT = 2;
+
 		/// @name Construction/Destruction
 		//@{
-		GLMainContext( GLFWwindow* pGlfwWindow );
+		GLMainContext( GLFWwindow* pGlfwWindow, uint32_t frameRateLimit = 0 );
 		//@}
 
 		/// @name Render Control
 		//@{
 		RSurface* GetBackBufferSurface();
 		void Swap();
+
+		bool Resize( uint32_t width, uint32_t height );
 		//@}
 
 	private:
@@ -30,6 +43,14 @@ namespace Helium
         /// Active backbuffer surface.
         GLSurfacePtr m_spBackBufferSurface;
 
+		/// Fences set after presenting each of the most recent frames that may still be in flight.
+		GLFencePtr m_frameFences[ MAX_FRAMES_IN_FLIGHT - 1 ];
+		/// Index of the frame fence to reuse for the next frame.
+		size_t m_frameFenceIndex;
+
+		/// Frame rate limiter applied before presenting each frame.
+		FrameLimiter m_frameLimiter;
+
         /// @name Construction/Destruction
         //@{
         ~GLMainContext();
@@ -0,0 +1,76 @@
+#include "Precompile.h"
+#include "RenderingGL/GLPixelShader.h"
+
+#include "RenderingGL/GLRenderer.h"
+
+using namespace Helium;
+
+/// Constructor.
+///
+/// @param[in] shader  OpenGL fragment shader object to wrap.  The shader object is deleted when this object is destroyed.
+GLPixelShader::GLPixelShader( GLuint shader )
+: m_shader( shader )
+, m_pStagingData( NULL )
+, m_stagingSize( 0 )
+{
+	HELIUM_ASSERT( shader != 0 );
+}
+
+/// Constructor.
+///
+/// @param[in] pStagingData  Staging buffer for loading the shader source, allocated using DefaultAllocator.  This
+///                          object takes ownership of the buffer.
+/// @param[in] stagingSize   Size of the staging buffer, in bytes.
+GLPixelShader::GLPixelShader( void* pStagingData, size_t stagingSize )
+: m_shader( 0 )
+, m_pStagingData( pStagingData )
+, m_stagingSize( stagingSize )
+{
+	HELIUM_ASSERT( pStagingData );
+}
+
+/// Destructor.
+GLPixelShader::~GLPixelShader()
+{
+	if( m_pStagingData )
+	{
+		DefaultAllocator().Free( m_pStagingData );
+	}
+
+	if( m_shader )
+	{
+		glDeleteShader( m_shader );
+	}
+}
+
+/// @copydoc RShader::Lock()
+void* GLPixelShader::Lock()
+{
+	if( !m_pStagingData )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLPixelShader::Lock(): Pixel shader has already been loaded.\n" );
+
+		return NULL;
+	}
+
+	return m_pStagingData;
+}
+
+/// @copydoc RShader::Unlock()
+bool GLPixelShader::Unlock()
+{
+	if( !m_pStagingData )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLPixelShader::Unlock(): Pixel shader has already been loaded.\n" );
+
+		return false;
+	}
+
+	m_shader = GLRenderer::CompileShader( GL_FRAGMENT_SHADER, m_pStagingData, m_stagingSize );
+
+	DefaultAllocator().Free( m_pStagingData );
+	m_pStagingData = NULL;
+	m_stagingSize = 0;
+
+	return ( m_shader != 0 );
+}
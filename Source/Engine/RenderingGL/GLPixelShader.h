@@ -0,0 +1,49 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Rendering/RPixelShader.h"
+
+#include "GL/glew.h"
+
+namespace Helium
+{
+	/// OpenGL pixel (fragment) shader implementation.
+	///
+	/// Shader data is GLSL source text.  Shaders created without data are loaded through a staging buffer that is
+	/// compiled when unlocked.
+	class GLPixelShader : public RPixelShader
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		GLPixelShader( GLuint shader );
+		GLPixelShader( void* pStagingData, size_t stagingSize );
+		//@}
+
+		/// @name Loading
+		//@{
+		void* Lock();
+		bool Unlock();
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline GLuint GetGLShader() const;
+		//@}
+
+	private:
+		/// OpenGL shader object (zero if not yet loaded).
+		GLuint m_shader;
+		/// Staging buffer for loading the shader source (null once loaded).
+		void* m_pStagingData;
+		/// Size of the staging buffer, in bytes.
+		size_t m_stagingSize;
+
+		/// @name Construction/Destruction
+		//@{
+		~GLPixelShader();
+		//@}
+	};
+}
+
+#include "RenderingGL/GLPixelShader.inl"
@@ -0,0 +1,229 @@
+#include "Precompile.h"
+#include "RenderingGL/GLProgramCache.h"
+
+#include "RenderingGL/GLImmediateCommandProxy.h"
+#include "RenderingGL/GLPixelShader.h"
+#include "RenderingGL/GLVertexDescription.h"
+#include "RenderingGL/GLVertexShader.h"
+
+using namespace Helium;
+
+/// Number of calls to Tick() between scans for idle programs.
+static const uint32_t PROGRAM_EVICTION_INTERVAL = 256;
+
+/// Constructor.
+GLProgramCache::GLProgramCache()
+: m_tickCount( 0 )
+{
+}
+
+/// Destructor.
+GLProgramCache::~GLProgramCache()
+{
+	Clear();
+}
+
+/// Get the linked program for a given vertex and pixel shader pair, linking it if it has not been cached yet.
+///
+/// This must only be called from the thread that owns the OpenGL context.  Linking a new program leaves it as the
+/// current program.
+///
+/// @param[in] pVertexShader  Vertex shader.
+/// @param[in] pPixelShader   Pixel shader.
+///
+/// @return  Linked program, or zero if either shader has not been loaded or the program failed to link.
+GLuint GLProgramCache::GetProgram( GLVertexShader* pVertexShader, GLPixelShader* pPixelShader )
+{
+	if( !pVertexShader || !pPixelShader )
+	{
+		return 0;
+	}
+
+	GLuint vertexShader = pVertexShader->GetGLShader();
+	GLuint pixelShader = pPixelShader->GetGLShader();
+	if( !vertexShader || !pixelShader )
+	{
+		return 0;
+	}
+
+	static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+	uint64_t key = FNV_OFFSET_BASIS;
+	key = ( key ^ static_cast< uint64_t >( reinterpret_cast< uintptr_t >( pVertexShader ) ) ) * FNV_PRIME;
+	key = ( key ^ static_cast< uint64_t >( reinterpret_cast< uintptr_t >( pPixelShader ) ) ) * FNV_PRIME;
+
+	HashMap< uint64_t, Entry >::Iterator entryIterator = m_entries.Find( key );
+	if( entryIterator != m_entries.End() )
+	{
+		Entry& rEntry = entryIterator->Second();
+		if( rEntry.spVertexShader.Get() == pVertexShader && rEntry.spPixelShader.Get() == pPixelShader )
+		{
+			rEntry.lastUsedTick = m_tickCount;
+
+			return rEntry.program;
+		}
+
+		// Hash collision with a different shader pair, so replace the existing entry.
+		if( rEntry.program )
+		{
+			glDeleteProgram( rEntry.program );
+		}
+
+		m_entries.Remove( entryIterator );
+	}
+
+	Entry entry;
+	entry.spVertexShader = pVertexShader;
+	entry.spPixelShader = pPixelShader;
+	entry.program = LinkProgram( vertexShader, pixelShader );
+	entry.lastUsedTick = m_tickCount;
+
+	// Failed links are cached as well so that they are not retried on every draw.
+	m_entries.Insert( entryIterator, HashMap< uint64_t, Entry >::ValueType( key, entry ) );
+
+	return entry.program;
+}
+
+/// Advance the cache age, deleting programs that have not been used recently.
+///
+/// @see IDLE_TICK_COUNT_MAX
+void GLProgramCache::Tick()
+{
+	++m_tickCount;
+	if( m_tickCount % PROGRAM_EVICTION_INTERVAL == 0 )
+	{
+		EvictIdleEntries();
+	}
+}
+
+/// Delete all cached programs and release their shader references.
+void GLProgramCache::Clear()
+{
+	for( HashMap< uint64_t, Entry >::Iterator entryIterator = m_entries.Begin();
+		entryIterator != m_entries.End();
+		++entryIterator )
+	{
+		GLuint program = entryIterator->Second().program;
+		if( program )
+		{
+			glDeleteProgram( program );
+		}
+	}
+
+	m_entries.Clear();
+}
+
+/// Delete programs that have not been used for IDLE_TICK_COUNT_MAX ticks.
+void GLProgramCache::EvictIdleEntries()
+{
+	HELIUM_ASSERT( m_evictedKeys.IsEmpty() );
+
+	for( HashMap< uint64_t, Entry >::ConstIterator entryIterator = m_entries.Begin();
+		entryIterator != m_entries.End();
+		++entryIterator )
+	{
+		if( m_tickCount - entryIterator->Second().lastUsedTick >= IDLE_TICK_COUNT_MAX )
+		{
+			m_evictedKeys.Push( entryIterator->First() );
+		}
+	}
+
+	size_t evictedCount = m_evictedKeys.GetSize();
+	for( size_t keyIndex = 0; keyIndex < evictedCount; ++keyIndex )
+	{
+		HashMap< uint64_t, Entry >::Iterator entryIterator = m_entries.Find( m_evictedKeys[ keyIndex ] );
+		HELIUM_ASSERT( entryIterator != m_entries.End() );
+
+		GLuint program = entryIterator->Second().program;
+		if( program )
+		{
+			glDeleteProgram( program );
+		}
+
+		m_entries.Remove( entryIterator );
+	}
+
+	m_evictedKeys.Resize( 0 );
+}
+
+/// Link a program from a vertex and pixel shader and bind its vertex inputs, uniform blocks, and samplers.
+///
+/// @param[in] vertexShader  Compiled vertex shader object.
+/// @param[in] pixelShader   Compiled fragment shader object.
+///
+/// @return  Linked program, or zero if linking failed.
+GLuint GLProgramCache::LinkProgram( GLuint vertexShader, GLuint pixelShader )
+{
+	GLuint program = glCreateProgram();
+	if( !program )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLProgramCache: Failed to create program object.\n" );
+
+		return 0;
+	}
+
+	glAttachShader( program, vertexShader );
+	glAttachShader( program, pixelShader );
+
+	// Bind each vertex input to the fixed location used for its semantic by all vertex descriptions.
+	for( GLuint location = 0; location < GLVertexDescription::ATTRIBUTE_LOCATION_COUNT; ++location )
+	{
+		glBindAttribLocation( program, location, GLVertexDescription::GetAttributeName( location ) );
+	}
+
+	glLinkProgram( program );
+
+	glDetachShader( program, vertexShader );
+	glDetachShader( program, pixelShader );
+
+	GLint linkStatus = GL_FALSE;
+	glGetProgramiv( program, GL_LINK_STATUS, &linkStatus );
+	if( linkStatus != GL_TRUE )
+	{
+		GLchar infoLog[ 1024 ];
+		infoLog[ 0 ] = '\0';
+		glGetProgramInfoLog( program, static_cast< GLsizei >( sizeof( infoLog ) ), NULL, infoLog );
+		HELIUM_TRACE( TraceLevels::Error, "GLProgramCache: Failed to link program:\n%s\n", infoLog );
+
+		glDeleteProgram( program );
+
+		return 0;
+	}
+
+	// Bind constant buffer uniform blocks to the binding points used by the command proxy for each slot.
+	char name[ 32 ];
+	for( uint32_t slotIndex = 0; slotIndex < GLImmediateCommandProxy::CONSTANT_BUFFER_SLOT_COUNT; ++slotIndex )
+	{
+		StringPrint( name, "VertexConstants%" PRIu32, slotIndex );
+		GLuint blockIndex = glGetUniformBlockIndex( program, name );
+		if( blockIndex != GL_INVALID_INDEX )
+		{
+			glUniformBlockBinding( program, blockIndex, slotIndex );
+		}
+
+		StringPrint( name, "PixelConstants%" PRIu32, slotIndex );
+		blockIndex = glGetUniformBlockIndex( program, name );
+		if( blockIndex != GL_INVALID_INDEX )
+		{
+			glUniformBlockBinding(
+				program,
+				blockIndex,
+				static_cast< GLuint >( GLImmediateCommandProxy::CONSTANT_BUFFER_SLOT_COUNT + slotIndex ) );
+		}
+	}
+
+	// Sampler uniforms can only be set on the current program.
+	glUseProgram( program );
+	for( uint32_t samplerIndex = 0; samplerIndex < SAMPLER_COUNT_MAX; ++samplerIndex )
+	{
+		StringPrint( name, "Sampler%" PRIu32, samplerIndex );
+		GLint uniformLocation = glGetUniformLocation( program, name );
+		if( uniformLocation >= 0 )
+		{
+			glUniform1i( uniformLocation, static_cast< GLint >( samplerIndex ) );
+		}
+	}
+
+	return program;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Rendering/RRenderResource.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/HashMap.h"
+
+#include "GL/glew.h"
+
+namespace Helium
+{
+	class GLVertexShader;
+	class GLPixelShader;
+
+	HELIUM_DECLARE_RPTR( GLVertexShader );
+	HELIUM_DECLARE_RPTR( GLPixelShader );
+
+	/// Cache of linked OpenGL programs for each vertex and pixel shader pair.
+	///
+	/// Linking is done the first time a shader pair is drawn with.  Before linking, vertex inputs are bound to the fixed
+	/// attribute locations of GLVertexDescription.  After linking, uniform blocks named "VertexConstants<n>" and
+	/// "PixelConstants<n>" are bound to the uniform buffer binding points used for the corresponding constant buffer
+	/// slots by GLImmediateCommandProxy, and sampler uniforms named "Sampler<n>" are bound to texture unit n.
+	///
+	/// Cached programs hold references to their shaders.  Programs not used for IDLE_TICK_COUNT_MAX calls to Tick() are
+	/// deleted.
+	class GLProgramCache
+	{
+	public:
+		/// Number of calls to Tick() after which an unused program is deleted.
+		static const uint32_t IDLE_TICK_COUNT_MAX = 4096;
+		/// Number of sampler uniforms bound to texture units.
+		static const uint32_t SAMPLER_COUNT_MAX = 16;
+
+		/// @name Construction/Destruction
+		//@{
+		GLProgramCache();
+		~GLProgramCache();
+		//@}
+
+		/// @name Program Lookup
+		//@{
+		GLuint GetProgram( GLVertexShader* pVertexShader, GLPixelShader* pPixelShader );
+		//@}
+
+		/// @name Cache Management
+		//@{
+		void Tick();
+		void Clear();
+		//@}
+
+	private:
+		/// Linked program entry.
+		struct Entry
+		{
+			/// Vertex shader.
+			GLVertexShaderPtr spVertexShader;
+			/// Pixel shader.
+			GLPixelShaderPtr spPixelShader;
+			/// Linked program (zero if linking failed).
+			GLuint program;
+			/// Tick count when the program was last used.
+			uint32_t lastUsedTick;
+		};
+
+		/// Linked programs, keyed by a hash of their shader pair.
+		HashMap< uint64_t, Entry > m_entries;
+		/// Scratch list of keys of entries being evicted.
+		DynamicArray< uint64_t > m_evictedKeys;
+		/// Number of calls to Tick().
+		uint32_t m_tickCount;
+
+		/// @name Private Utility Functions
+		//@{
+		void EvictIdleEntries();
+
+		static GLuint LinkProgram( GLuint vertexShader, GLuint pixelShader );
+		//@}
+	};
+}
@@ -0,0 +1,46 @@
+#include "Precompile.h"
+#include "RenderingGL/GLRenderCommandList.h"
+
+using namespace Helium;
+
+/// Destructor.
+GLRenderCommand::~GLRenderCommand()
+{
+}
+
+/// @fn void GLRenderCommand::Execute( RRenderCommandProxy* pCommandProxy )
+/// Execute this render command through the given command proxy.
+///
+/// @param[in] pCommandProxy  Command proxy through which to execute the command.
+
+/// Constructor.
+///
+/// Creates a render command list with the given size.  Note that the size of a command list is fixed after
+/// creation.
+///
+/// @param[in] size  Command list buffer size, in bytes.
+GLRenderCommandList::GLRenderCommandList( size_t size )
+{
+	if( size == 0 )
+	{
+		size = 1;
+	}
+
+	m_pBuffer = new uint8_t [ size ];
+	HELIUM_ASSERT( m_pBuffer );
+
+	m_size = size;
+	m_writeOffset = 0;
+}
+
+/// Destructor.
+GLRenderCommandList::~GLRenderCommandList()
+{
+	Iterator listEnd = End();
+	for( Iterator listIter = Begin(); listIter != listEnd; ++listIter )
+	{
+		listIter->~GLRenderCommand();
+	}
+
+	delete [] m_pBuffer;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Rendering/RRenderCommandList.h"
+
+namespace Helium
+{
+	class GLImmediateCommandProxy;
+
+	HELIUM_DECLARE_RPTR( GLRenderCommandList );
+
+	/// OpenGL render command.
+	class GLRenderCommand
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		virtual ~GLRenderCommand() = 0;
+		//@}
+
+		/// @name Command Execution
+		//@{
+		virtual void Execute( GLImmediateCommandProxy* pCommandProxy ) = 0;
+		//@}
+	};
+
+	/// OpenGL render command list.
+	///
+	/// Each command list has a fixed-size buffer.  Commands that do not fit are recorded into additional command lists
+	/// chained after the first, which are executed in order along with it.
+	class GLRenderCommandList : public RRenderCommandList
+	{
+	public:
+		/// Command iterator.
+		class Iterator
+		{
+		public:
+			/// @name Construction/Destruction
+			//@{
+			inline Iterator();
+			inline Iterator( uint8_t* pCurrent );
+			//@}
+
+			/// @name Overloaded Operators
+			//@{
+			inline Iterator& operator++();
+			inline GLRenderCommand& operator*();
+			inline GLRenderCommand* operator->();
+			inline bool operator==( const Iterator& rIterator );
+			inline bool operator!=( const Iterator& rIterator );
+			//@}
+
+		private:
+			/// Current command pointer.
+			uint8_t* m_pCurrent;
+		};
+
+		/// Default command list size, in bytes.
+		static const size_t DEFAULT_SIZE = 32 * 1024;
+
+		/// @name Construction/Destruction
+		//@{
+		GLRenderCommandList( size_t size = DEFAULT_SIZE );
+		//@}
+
+		/// @name Command Allocation
+		//@{
+		template< typename T > T* NewCommand();
+		template< typename T, typename P0 > T* NewCommand( const P0& rParam0 );
+		template< typename T, typename P0, typename P1 > T* NewCommand( const P0& rParam0, const P1& rParam1 );
+		template< typename T, typename P0, typename P1, typename P2 > T* NewCommand(
+			const P0& rParam0, const P1& rParam1, const P2& rParam2 );
+		template< typename T, typename P0, typename P1, typename P2, typename P3 > T* NewCommand(
+			const P0& rParam0, const P1& rParam1, const P2& rParam2, const P3& rParam3 );
+		template< typename T, typename P0, typename P1, typename P2, typename P3, typename P4 > T* NewCommand(
+			const P0& rParam0, const P1& rParam1, const P2& rParam2, const P3& rParam3, const P4& rParam4 );
+		template< typename T, typename P0, typename P1, typename P2, typename P3, typename P4, typename P5 >
+			T* NewCommand(
+				const P0& rParam0, const P1& rParam1, const P2& rParam2, const P3& rParam3, const P4& rParam4,
+				const P5& rParam5 );
+		template<
+			typename T, typename P0, typename P1, typename P2, typename P3, typename P4, typename P5, typename P6 >
+			T* NewCommand(
+				const P0& rParam0, const P1& rParam1, const P2& rParam2, const P3& rParam3, const P4& rParam4,
+				const P5& rParam5, const P6& rParam6 );
+		//@}
+
+		/// @name Command List Chaining
+		//@{
+		inline GLRenderCommandList* GetNext() const;
+		inline void SetNext( GLRenderCommandList* pNext );
+		//@}
+
+		/// @name Command Iteration
+		//@{
+		inline Iterator Begin();
+		inline Iterator End();
+		//@}
+
+	private:
+		/// Command buffer.
+		uint8_t* m_pBuffer;
+		/// Total command buffer size.
+		size_t m_size;
+		/// Current command buffer write offset.
+		size_t m_writeOffset;
+		/// Command list containing the commands recorded after this list ran out of space.
+		GLRenderCommandListPtr m_spNext;
+
+		/// @name Construction/Destruction
+		//@{
+		~GLRenderCommandList();
+		//@}
+
+		/// @name Private Utility Functions
+		//@{
+		template< typename T > void* AllocateCommandSpace();
+		//@}
+	};
+}
+
+#include "RenderingGL/GLRenderCommandList.inl"
@@ -2,6 +2,9 @@
 #include "RenderingGL/GLRenderer.h"
 
 #include "RenderingGL/GLDebug.h"
+#include "RenderingGL/GLDeferredCommandProxy.h"
+#include "RenderingGL/GLFence.h"
+#include "RenderingGL/GLGpuCullingBatch.h"
 #include "RenderingGL/GLImmediateCommandProxy.h"
 #include "RenderingGL/GLMainContext.h"
 #include "RenderingGL/GLRasterizerState.h"
@@ -11,14 +14,26 @@
 #include "RenderingGL/GLIndexBuffer.h"
 #include "RenderingGL/GLConstantBuffer.h"
 #include "RenderingGL/GLVertexDescription.h"
+#include "RenderingGL/GLVertexInputLayout.h"
+#include "RenderingGL/GLVertexShader.h"
+#include "RenderingGL/GLPixelShader.h"
 #include "RenderingGL/GLTexture2d.h"
+#include "RenderingGL/GLStreamBuffer.h"
 #include "RenderingGL/GLSurface.h"
+#include "RenderingGL/GLTimerQuery.h"
+#include "RenderingGL/GLUploadQueue.h"
 
 #include "Rendering/RendererUtil.h"
+#include "Engine/RenderStatistics.h"
 
 #include "GL/glew.h"
 #include "GLFW/glfw3.h"
 
+namespace Helium
+{
+	HELIUM_DECLARE_RPTR( RFence );
+}
+
 using namespace Helium;
 
 static uint32_t g_InitCount = 0;
@@ -45,7 +60,12 @@ void GLRenderer::PixelFormatToGLFormat(
 		{ GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, GL_RGBA, GL_UNSIGNED_BYTE }, // RENDERER_PIXEL_FORMAT_BC2_SRGB
 		{ GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,       GL_RGBA, GL_UNSIGNED_BYTE }, // RENDERER_PIXEL_FORMAT_BC3
 		{ GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, GL_RGBA, GL_UNSIGNED_BYTE }, // RENDERER_PIXEL_FORMAT_BC3_SRGB
+		{ GL_COMPRESSED_RED_RGTC1,                GL_RED,  GL_UNSIGNED_BYTE }, // RENDERER_PIXEL_FORMAT_BC4
+		{ GL_COMPRESSED_RG_RGTC2,                 GL_RG,   GL_UNSIGNED_BYTE }, // RENDERER_PIXEL_FORMAT_BC5
+		{ GL_COMPRESSED_RGBA_BPTC_UNORM,          GL_RGBA, GL_UNSIGNED_BYTE }, // RENDERER_PIXEL_FORMAT_BC7
+		{ GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM,    GL_RGBA, GL_UNSIGNED_BYTE }, // RENDERER_PIXEL_FORMAT_BC7_SRGB
 		{ GL_RGBA16F,                             GL_RGBA, GL_HALF_FLOAT    }, // RENDERER_PIXEL_FORMAT_R16G16B16A16_FLOAT
+		{ GL_RGBA32F,                             GL_RGBA, GL_FLOAT         }, // RENDERER_PIXEL_FORMAT_R32G32B32A32_FLOAT
 		{ GL_NONE,                                GL_NONE, GL_NONE          }  // RENDERER_PIXEL_FORMAT_DEPTH (dummy entry; depth formats handled manually)
 	};
 
@@ -88,16 +108,52 @@ void GLRenderer::PixelFormatToGLFormat(
 	}
 }
 
+/// Create the stream buffer backing a dynamic vertex or index buffer.
+///
+/// @param[in] size                Buffer size, in bytes.
+/// @param[in] pData               Initial buffer data, or null to leave the buffer contents undefined.
+/// @param[in] bPersistentMapping  True if the stream buffer can be mapped persistently.
+///
+/// @return  Stream buffer if created successfully, null if not.
+static GLStreamBuffer* CreateDynamicBufferStream( size_t size, const void* pData, bool bPersistentMapping )
+{
+	GLStreamBuffer* pStreamBuffer = new GLStreamBuffer;
+	HELIUM_ASSERT( pStreamBuffer );
+
+	if( !pStreamBuffer->Initialize( GL_ARRAY_BUFFER, size, bPersistentMapping ) )
+	{
+		delete pStreamBuffer;
+		return NULL;
+	}
+
+	// Write any initial data into the first segment, which the buffer will start out using.
+	if( pData )
+	{
+		size_t offset = 0;
+		void* pMappedData = pStreamBuffer->Allocate( size, 1, offset );
+		HELIUM_ASSERT( offset == 0 );
+		if( pMappedData )
+		{
+			MemoryCopy( pMappedData, pData, size );
+			pStreamBuffer->Unmap();
+		}
+	}
+
+	return pStreamBuffer;
+}
+
 /// Constructor.
 GLRenderer::GLRenderer()
 : m_pGlfwWindow(NULL)
 , m_spImmediateCommandProxy(NULL)
 , m_spMainContext(NULL)
+, m_pUploadQueue(NULL)
 , m_depthTextureFormat(GL_DEPTH_COMPONENT24)
 , m_bHasS3tcExt(false)
 , m_bHasSRGBExt(false)
 , m_bHasAnisotropicExt(false)
 , m_bHasDebugExt(false)
+, m_bHasBufferStorageExt(false)
 {
 }
 
@@ -127,9 +183,14 @@ void GLRenderer::Cleanup()
 {
 	HELIUM_TRACE( TraceLevels::Info, "Shutting down OpenGL rendering support.\n" );
 
+	delete m_pUploadQueue;
+	m_pUploadQueue = NULL;
+
 	m_spMainContext.Release();
 	m_spImmediateCommandProxy.Release();
 
+	ClearVertexInputCache();
+
 	m_featureFlags = 0;
 
 	HELIUM_TRACE( TraceLevels::Info, "OpenGL renderer shutdown complete.\n" );
@@ -147,9 +208,31 @@ bool GLRenderer::CreateMainContext( const ContextInitParameters& rInitParameters
 
 	// Create the main rendering context interface.
 	glfwMakeContextCurrent( m_pGlfwWindow );
-	m_spMainContext = new GLMainContext( m_pGlfwWindow );
+	m_spMainContext = new GLMainContext( m_pGlfwWindow, rInitParameters.frameRateLimit );
 	HELIUM_ASSERT( m_spMainContext );
 
+	// Set the swap interval for the requested presentation mode.  Adaptive vsync is requested with a negative swap
+	// interval, which is only valid if the swap control tear extension is available.
+	int swapInterval = 0;
+	if( rInitParameters.presentMode == RENDERER_PRESENT_MODE_ADAPTIVE_VSYNC )
+	{
+		if( glfwExtensionSupported( "WGL_EXT_swap_control_tear" ) || glfwExtensionSupported( "GLX_EXT_swap_control_tear" ) )
+		{
+			swapInterval = -1;
+		}
+		else
+		{
+			HELIUM_TRACE( TraceLevels::Warning, "GLRenderer: Adaptive vsync not available.  Falling back to regular vsync.\n" );
+			swapInterval = 1;
+		}
+	}
+	else if( rInitParameters.presentMode == RENDERER_PRESENT_MODE_VSYNC )
+	{
+		swapInterval = 1;
+	}
+
+	glfwSwapInterval( swapInterval );
+
 	// Initialize GLEW before any GL calls are made.
 	glewExperimental = GL_TRUE;
 	HELIUM_ASSERT( GLEW_OK == glewInit() );
@@ -175,6 +258,60 @@ bool GLRenderer::CreateMainContext( const ContextInitParameters& rInitParameters
 	{
 		HELIUM_TRACE( TraceLevels::Warning, "GLRenderer: OpenGL Debug output extension not available.  Debugging information will not be provided.\n" );
 	}
+	m_bHasBufferStorageExt = GLEW_ARB_buffer_storage != 0;
+	if( !m_bHasBufferStorageExt )
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "GLRenderer: OpenGL buffer storage extension not available.  Dynamic buffer ranges will be mapped individually.\n" );
+	}
+	if( GLEW_ARB_texture_compression_rgtc )
+	{
+		m_featureFlags |= RENDERER_FEATURE_FLAG_BC4_BC5;
+	}
+	else
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "GLRenderer: OpenGL RGTC texture compression extension not available.  BC4 and BC5 textures will be transcoded when loaded.\n" );
+	}
+	if( GLEW_ARB_texture_compression_bptc )
+	{
+		m_featureFlags |= RENDERER_FEATURE_FLAG_BC7;
+	}
+	else
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "GLRenderer: OpenGL BPTC texture compression extension not available.  BC7 textures will be transcoded when loaded.\n" );
+	}
+	if( GLEW_ARB_timer_query )
+	{
+		m_featureFlags |= RENDERER_FEATURE_FLAG_TIMER_QUERY;
+	}
+	else
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "GLRenderer: OpenGL timer query extension not available.  GPU pass timings will not be provided.\n" );
+	}
+
+	// Set up streaming of constant buffer data through uniform buffers.
+	if( !m_spImmediateCommandProxy->InitializeConstantStreaming( m_bHasBufferStorageExt ) )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLRenderer: Failed to initialize constant buffer streaming.\n" );
+		return false;
+	}
+
+	// Set up GPU-driven culling through compute shaders and multi-draw indirect.
+	if( GLEW_VERSION_4_3 && m_spImmediateCommandProxy->InitializeGpuCulling() )
+	{
+		m_featureFlags |= RENDERER_FEATURE_FLAG_GPU_CULLING;
+	}
+	else
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "GLRenderer: OpenGL 4.3 compute shaders not available.  GPU-driven culling will not be supported.\n" );
+	}
+
+	// Set up deferred texture uploads through a pixel unpack buffer.
+	m_pUploadQueue = new GLUploadQueue;
+	HELIUM_ASSERT( m_pUploadQueue );
+	if( !m_pUploadQueue->Initialize( m_bHasBufferStorageExt ) )
+	{
+		HELIUM_TRACE( TraceLevels::Warning, "GLRenderer: Failed to create texture upload buffer.  Textures will be uploaded directly.\n" );
+	}
 
 #if !HELIUM_RELEASE && !HELIUM_PROFILE
 	// Register callback function for OpenGL debug messages in this context.
@@ -331,6 +468,9 @@ RSurface* GLRenderer::CreateDepthStencilSurface(
 	// Construct the GLSurface object.
 	GLSurface *depthStencilSurface = new GLSurface( newDepthStencil, glFormats[ format ][ 1 ], false );
 	HELIUM_ASSERT( depthStencilSurface != NULL );
+	depthStencilSurface->SetTrackedMemory(
+		RRenderResource::MEMORY_CATEGORY_SURFACE,
+		static_cast< size_t >( width ) * height * 4 * Max< uint32_t >( multisampleCount, 1 ) );
 
 	return depthStencilSurface;
 }
@@ -338,17 +478,81 @@ RSurface* GLRenderer::CreateDepthStencilSurface(
 /// @copydoc Renderer::CreateVertexShader()
 RVertexShader* GLRenderer::CreateVertexShader( size_t size, const void* pData )
 {
-	HELIUM_BREAK();
+	// Compile the shader immediately if shader data was provided.
+	if( pData )
+	{
+		GLuint shader = CompileShader( GL_VERTEX_SHADER, pData, size );
+		if( !shader )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "GLRenderer::CreateVertexShader(): Vertex shader creation failed.\n" );
 
-	return NULL;
+			return NULL;
+		}
+
+		GLVertexShader* pShader = new GLVertexShader( shader );
+		HELIUM_ASSERT( pShader );
+		pShader->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
+
+		return pShader;
+	}
+
+	// Allocate a staging buffer for deferred loading of the shader source.
+	void* pStaging = DefaultAllocator().Allocate( size );
+	if( !pStaging )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"GLRenderer::CreateVertexShader(): Failed to allocate staging buffer of %" PRIuSZ " bytes for loading.\n",
+			size );
+
+		return NULL;
+	}
+
+	GLVertexShader* pShader = new GLVertexShader( pStaging, size );
+	HELIUM_ASSERT( pShader );
+	pShader->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
+
+	return pShader;
 }
 
 /// @copydoc Renderer::CreatePixelShader()
 RPixelShader* GLRenderer::CreatePixelShader( size_t size, const void* pData )
 {
-	HELIUM_BREAK();
+	// Compile the shader immediately if shader data was provided.
+	if( pData )
+	{
+		GLuint shader = CompileShader( GL_FRAGMENT_SHADER, pData, size );
+		if( !shader )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "GLRenderer::CreatePixelShader(): Pixel shader creation failed.\n" );
 
-	return NULL;
+			return NULL;
+		}
+
+		GLPixelShader* pShader = new GLPixelShader( shader );
+		HELIUM_ASSERT( pShader );
+		pShader->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
+
+		return pShader;
+	}
+
+	// Allocate a staging buffer for deferred loading of the shader source.
+	void* pStaging = DefaultAllocator().Allocate( size );
+	if( !pStaging )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"GLRenderer::CreatePixelShader(): Failed to allocate staging buffer of %" PRIuSZ " bytes for loading.\n",
+			size );
+
+		return NULL;
+	}
+
+	GLPixelShader* pShader = new GLPixelShader( pStaging, size );
+	HELIUM_ASSERT( pShader );
+	pShader->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_SHADER, size );
+
+	return pShader;
 }
 
 /// @copydoc Renderer::CreateVertexBuffer()
@@ -363,13 +567,35 @@ RVertexBuffer* GLRenderer::CreateVertexBuffer( size_t size, ERendererBufferUsage
 		return NULL;
 	}
 
-	// Determine buffer usage.
+	// Dynamic buffers are streamed so that they can be refilled without waiting on the GPU.
 	const bool bDynamic = ( usage == RENDERER_BUFFER_USAGE_DYNAMIC );
-	const GLenum usageGl = bDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+	if( bDynamic )
+	{
+		GLStreamBuffer* pStreamBuffer = CreateDynamicBufferStream( size, pData, m_bHasBufferStorageExt );
+		if( !pStreamBuffer )
+		{
+			HELIUM_TRACE(TraceLevels::Error,
+				"GLRenderer::CreateVertexBuffer(): Failed to create dynamic buffer stream.\n" );
+			return NULL;
+		}
+
+		GLVertexBuffer* pVertexBuffer = new GLVertexBuffer( pStreamBuffer );
+		HELIUM_ASSERT( pVertexBuffer );
+		pVertexBuffer->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_VERTEX_BUFFER, size );
+		if( pData )
+		{
+			RenderStatistics::RecordUpload(
+				RenderStatistics::COUNTER_BUFFER_BYTES,
+				pVertexBuffer->GetTrackedMemorySize() );
+		}
+
+		return pVertexBuffer;
+	}
+
+	const GLenum usageGl = GL_STATIC_DRAW;
 
 	// Create vertex buffer object.
 	unsigned buffer = 0;
-	glBindVertexArray( 0 );
 	glGenBuffers( 1, &buffer );
 	HELIUM_ASSERT( buffer != 0 );
 
@@ -388,6 +614,12 @@ RVertexBuffer* GLRenderer::CreateVertexBuffer( size_t size, ERendererBufferUsage
 		return NULL;
 	}
 
+	vertexBuffer->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_VERTEX_BUFFER, size );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, vertexBuffer->GetTrackedMemorySize() );
+	}
+
 	return vertexBuffer;
 }
 
@@ -407,13 +639,38 @@ RIndexBuffer* GLRenderer::CreateIndexBuffer(
 		return NULL;
 	}
 
-	// Determine buffer usage.
+	// Determine index element type.
+	const GLenum elementType = (format == RENDERER_INDEX_FORMAT_UINT32) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+
+	// Dynamic buffers are streamed so that they can be refilled without waiting on the GPU.
 	const bool bDynamic = ( usage == RENDERER_BUFFER_USAGE_DYNAMIC );
-	const GLenum usageGl = bDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+	if( bDynamic )
+	{
+		GLStreamBuffer* pStreamBuffer = CreateDynamicBufferStream( size, pData, m_bHasBufferStorageExt );
+		if( !pStreamBuffer )
+		{
+			HELIUM_TRACE(TraceLevels::Error,
+				"GLRenderer::CreateIndexBuffer(): Failed to create dynamic buffer stream.\n" );
+			return NULL;
+		}
+
+		GLIndexBuffer* pIndexBuffer = new GLIndexBuffer( elementType, pStreamBuffer );
+		HELIUM_ASSERT( pIndexBuffer );
+		pIndexBuffer->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_INDEX_BUFFER, size );
+		if( pData )
+		{
+			RenderStatistics::RecordUpload(
+				RenderStatistics::COUNTER_BUFFER_BYTES,
+				pIndexBuffer->GetTrackedMemorySize() );
+		}
+
+		return pIndexBuffer;
+	}
+
+	const GLenum usageGl = GL_STATIC_DRAW;
 
 	// Create buffer object.
 	unsigned buffer = 0;
-	glBindVertexArray( 0 );
 	glGenBuffers( 1, &buffer );
 	HELIUM_ASSERT( buffer != 0 );
 	
@@ -423,9 +680,6 @@ RIndexBuffer* GLRenderer::CreateIndexBuffer(
 	glBufferData( GL_ARRAY_BUFFER, size, pData, usageGl );
 	const bool bValidData = (pData != NULL);
 
-	// Determine index element type.
-	const GLenum elementType = (format == RENDERER_INDEX_FORMAT_UINT32) ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
-
 	// Create Helium GL vertex buffer object.
 	GLIndexBuffer *indexBuffer = new GLIndexBuffer( elementType, buffer );
 	if( !indexBuffer )
@@ -435,6 +689,12 @@ RIndexBuffer* GLRenderer::CreateIndexBuffer(
 		return NULL;
 	}
 
+	indexBuffer->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_INDEX_BUFFER, size );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, indexBuffer->GetTrackedMemorySize() );
+	}
+
 	return indexBuffer;
 }
 
@@ -484,6 +744,14 @@ RConstantBuffer* GLRenderer::CreateConstantBuffer(
 	GLConstantBuffer* pBuffer = new GLConstantBuffer( pBufferMemory, static_cast< uint16_t >( registerCount ) );
 	
 	HELIUM_ASSERT( pBuffer );
+	pBuffer->SetTrackedMemory( RRenderResource::MEMORY_CATEGORY_CONSTANT_BUFFER, actualSize );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload(
+			RenderStatistics::COUNTER_CONSTANT_BUFFER_BYTES,
+			pBuffer->GetTrackedMemorySize() );
+	}
+
 	return pBuffer;
 }
 
@@ -520,9 +788,17 @@ RVertexInputLayout* GLRenderer::CreateVertexInputLayout(
 	RVertexDescription* pDescription,
 	RVertexShader* /*pShader*/ )
 {
-	HELIUM_BREAK();
+	HELIUM_ASSERT( pDescription );
+	if( !pDescription )
+	{
+		return NULL;
+	}
 
-	return NULL;
+	// Attribute locations are fixed for each vertex semantic, so the layout does not depend on the shader.
+	GLVertexInputLayout* pLayout = new GLVertexInputLayout( static_cast< GLVertexDescription* >( pDescription ) );
+	HELIUM_ASSERT( pLayout );
+
+	return pLayout;
 }
 
 /// @copydoc Renderer::CreateTexture2d()
@@ -609,34 +885,134 @@ RTexture2d* GLRenderer::CreateTexture2d(
 		}
 	}
 
-	GLTexture2d *pTexture = new GLTexture2d( buffer, mipCount, format );
+	GLTexture2d *pTexture = new GLTexture2d( buffer, width, height, mipCount, format, usage );
 	HELIUM_ASSERT( pTexture );
+	pTexture->SetTrackedMemory(
+		RRenderResource::MEMORY_CATEGORY_TEXTURE,
+		RendererUtil::GetTexture2dMemorySize( width, height, mipCount, format ) );
+	if( pData )
+	{
+		RenderStatistics::RecordUpload( RenderStatistics::COUNTER_TEXTURE_BYTES, pTexture->GetTrackedMemorySize() );
+	}
 
 	glBindTexture( GL_TEXTURE_2D, curTexture2D );
 
 	return pTexture;
 }
 
+/// @copydoc Renderer::CreateGpuCullingBatch()
+RGpuCullingBatch* GLRenderer::CreateGpuCullingBatch( uint32_t objectCapacity, uint32_t drawCapacity )
+{
+	HELIUM_ASSERT( objectCapacity != 0 );
+	HELIUM_ASSERT( drawCapacity != 0 );
+
+	if( !( m_featureFlags & RENDERER_FEATURE_FLAG_GPU_CULLING ) )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLRenderer::CreateGpuCullingBatch(): GPU-driven culling is not supported.\n" );
+		return NULL;
+	}
+
+	GLuint buffers[ 3 ] = { 0, 0, 0 };
+	glGenBuffers( 3, buffers );
+	if( !buffers[ 0 ] || !buffers[ 1 ] || !buffers[ 2 ] )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLRenderer::CreateGpuCullingBatch(): Failed to create buffer objects.\n" );
+		glDeleteBuffers( 3, buffers );
+		return NULL;
+	}
+
+	// The object and draw buffers are refilled from staging memory, while the command buffer is only written by the GPU.
+	glBindBuffer( GL_SHADER_STORAGE_BUFFER, buffers[ 0 ] );
+	glBufferData(
+		GL_SHADER_STORAGE_BUFFER,
+		static_cast< GLsizeiptr >( sizeof( RGpuCullingBatch::ObjectBounds ) * objectCapacity ),
+		NULL,
+		GL_DYNAMIC_DRAW );
+	glBindBuffer( GL_SHADER_STORAGE_BUFFER, buffers[ 1 ] );
+	glBufferData(
+		GL_SHADER_STORAGE_BUFFER,
+		static_cast< GLsizeiptr >( sizeof( RGpuCullingBatch::Draw ) * drawCapacity ),
+		NULL,
+		GL_DYNAMIC_DRAW );
+	glBindBuffer( GL_SHADER_STORAGE_BUFFER, buffers[ 2 ] );
+	glBufferData(
+		GL_SHADER_STORAGE_BUFFER,
+		static_cast< GLsizeiptr >( GLGpuCullingBatch::COMMAND_SIZE * drawCapacity ),
+		NULL,
+		GL_DYNAMIC_COPY );
+	glBindBuffer( GL_SHADER_STORAGE_BUFFER, 0 );
+
+	GLGpuCullingBatch* pBatch = new GLGpuCullingBatch(
+		objectCapacity,
+		drawCapacity,
+		buffers[ 0 ],
+		buffers[ 1 ],
+		buffers[ 2 ] );
+	HELIUM_ASSERT( pBatch );
+
+	return pBatch;
+}
+
 /// @copydoc Renderer::CreateFence()
 RFence* GLRenderer::CreateFence()
 {
-	HELIUM_BREAK();
+	GLFence* pFence = new GLFence;
+	HELIUM_ASSERT( pFence );
 
-	return NULL;
+	return pFence;
 }
 
 /// @copydoc Renderer::SyncFence()
 void GLRenderer::SyncFence( RFence* pFence )
 {
-	HELIUM_BREAK();
+	HELIUM_ASSERT( pFence );
+
+	static_cast< GLFence* >( pFence )->Wait();
 }
 
 /// @copydoc Renderer::TrySyncFence()
 bool GLRenderer::TrySyncFence( RFence* pFence )
 {
-	HELIUM_BREAK();
+	HELIUM_ASSERT( pFence );
+
+	return static_cast< GLFence* >( pFence )->TryWait();
+}
+
+/// @copydoc Renderer::CreateTimerQuery()
+RTimerQuery* GLRenderer::CreateTimerQuery()
+{
+	if( !SupportsAllFeatures( RENDERER_FEATURE_FLAG_TIMER_QUERY ) )
+	{
+		return NULL;
+	}
 
-	return false;
+	GLuint query = 0;
+	glGenQueries( 1, &query );
+	if( query == 0 )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLRenderer::CreateTimerQuery(): Failed to create OpenGL query object.\n" );
+		return NULL;
+	}
+
+	GLTimerQuery* pQuery = new GLTimerQuery( query );
+	HELIUM_ASSERT( pQuery );
+
+	return pQuery;
+}
+
+/// @copydoc Renderer::TryGetTimerQueryTimestamp()
+bool GLRenderer::TryGetTimerQueryTimestamp( RTimerQuery* pQuery, uint64_t& rTimestamp )
+{
+	HELIUM_ASSERT( pQuery );
+
+	return static_cast< GLTimerQuery* >( pQuery )->TryGetTimestamp( rTimestamp );
+}
+
+/// @copydoc Renderer::GetTimerQueryFrequency()
+uint64_t GLRenderer::GetTimerQueryFrequency()
+{
+	// GL_TIMESTAMP results are always in nanoseconds.
+	return ( SupportsAllFeatures( RENDERER_FEATURE_FLAG_TIMER_QUERY ) ? 1000000000 : 0 );
 }
 
 /// @copydoc Renderer::GetImmediateCommandProxy()
@@ -648,15 +1024,71 @@ RRenderCommandProxy* GLRenderer::GetImmediateCommandProxy()
 /// @copydoc Renderer::CreateDeferredCommandProxy()
 RRenderCommandProxy* GLRenderer::CreateDeferredCommandProxy()
 {
-	HELIUM_BREAK();
+	GLDeferredCommandProxy* pCommandProxy = new GLDeferredCommandProxy;
+	HELIUM_ASSERT( pCommandProxy );
 
-	return NULL;
+	return pCommandProxy;
 }
 
 /// @copydoc Renderer::Flush()
 void GLRenderer::Flush()
 {
-	HELIUM_BREAK();
+	HELIUM_ASSERT( m_spImmediateCommandProxy );
+
+	RFencePtr spFence = CreateFence();
+	HELIUM_ASSERT( spFence );
+	m_spImmediateCommandProxy->SetFence( spFence );
+	SyncFence( spFence );
+}
+
+/// @copydoc Renderer::ProcessResourceUploads()
+void GLRenderer::ProcessResourceUploads()
+{
+	if( m_pUploadQueue )
+	{
+		m_pUploadQueue->Process();
+	}
+}
+
+/// Compile an OpenGL shader from GLSL source.
+///
+/// @param[in] shaderType  OpenGL shader type (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER).
+/// @param[in] pSource     Shader source text (does not need to be null-terminated).
+/// @param[in] size        Size of the shader source, in bytes.
+///
+/// @return  Compiled shader object, or zero if compilation failed.
+GLuint GLRenderer::CompileShader( GLenum shaderType, const void* pSource, size_t size )
+{
+	HELIUM_ASSERT( pSource );
+
+	GLuint shader = glCreateShader( shaderType );
+	if( !shader )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLRenderer::CompileShader(): Failed to create shader object.\n" );
+
+		return 0;
+	}
+
+	const GLchar* pSourceText = static_cast< const GLchar* >( pSource );
+	GLint sourceLength = static_cast< GLint >( size );
+	glShaderSource( shader, 1, &pSourceText, &sourceLength );
+	glCompileShader( shader );
+
+	GLint compileStatus = GL_FALSE;
+	glGetShaderiv( shader, GL_COMPILE_STATUS, &compileStatus );
+	if( compileStatus != GL_TRUE )
+	{
+		GLchar infoLog[ 1024 ];
+		infoLog[ 0 ] = '\0';
+		glGetShaderInfoLog( shader, static_cast< GLsizei >( sizeof( infoLog ) ), NULL, infoLog );
+		HELIUM_TRACE( TraceLevels::Error, "GLRenderer::CompileShader(): Failed to compile shader:\n%s\n", infoLog );
+
+		glDeleteShader( shader );
+
+		return 0;
+	}
+
+	return shader;
 }
 
 /// Create the static renderer instance as a D3D9Renderer.
@@ -9,6 +9,8 @@ struct GLFWwindow;
 
 namespace Helium
 {
+	class GLUploadQueue;
+
 	HELIUM_DECLARE_RPTR( GLImmediateCommandProxy );
 	HELIUM_DECLARE_RPTR( GLMainContext );
 
@@ -61,6 +63,8 @@ namespace Helium
 		RTexture2d* CreateTexture2d(
 			uint32_t width, uint32_t height, uint32_t mipCount, ERendererPixelFormat format, ERendererBufferUsage usage,
 			const RTexture2d::CreateData* pData );
+
+		RGpuCullingBatch* CreateGpuCullingBatch( uint32_t objectCapacity, uint32_t drawCapacity );
 		//@}
 
 		/// @name Deferred Query Allocation
@@ -68,6 +72,10 @@ namespace Helium
 		RFence* CreateFence();
 		void SyncFence( RFence* pFence );
 		bool TrySyncFence( RFence* pFence );
+
+		RTimerQuery* CreateTimerQuery();
+		bool TryGetTimerQueryTimestamp( RTimerQuery* pQuery, uint64_t& rTimestamp );
+		uint64_t GetTimerQueryFrequency();
 		//@}
 
 		/// @name Command Interfaces
@@ -78,10 +86,19 @@ namespace Helium
 		void Flush();
 		//@}
 
+		/// @name Resource Uploading
+		//@{
+		void ProcessResourceUploads();
+
+		inline GLUploadQueue* GetUploadQueue() const;
+		//@}
+
 		/// @name Utility Functions
 		//@{
 		void PixelFormatToGLFormat(
 			ERendererPixelFormat format, GLenum &internalFormat, GLenum &pixelFormat, GLenum &elementType ) const;
+
+		static GLuint CompileShader( GLenum shaderType, const void* pSource, size_t size );
 		//@}
 
 		/// @name Static Initialization
@@ -98,6 +115,8 @@ namespace Helium
 		GLImmediateCommandProxyPtr m_spImmediateCommandProxy;
 		/// Main rendering context.
 		GLMainContextPtr m_spMainContext;
+		/// Queue of deferred texture uploads.
+		GLUploadQueue* m_pUploadQueue;
 
 		/// Depth buffer format
 		GLenum m_depthTextureFormat;
@@ -110,6 +129,8 @@ namespace Helium
 		bool m_bHasAnisotropicExt;
 		/// Debug callback availability.
 		bool m_bHasDebugExt;
+		/// Persistent buffer mapping availability.
+		bool m_bHasBufferStorageExt;
 
 		/// @name Construction/Destruction
 		//@{
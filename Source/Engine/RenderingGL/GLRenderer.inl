@@ -1,4 +1,12 @@
 namespace Helium
 {
-
+	/// Get the queue of deferred texture uploads.
+	///
+	/// @return  Upload queue, or null if the main context has not been created.
+	///
+	/// @see ProcessResourceUploads()
+	GLUploadQueue* GLRenderer::GetUploadQueue() const
+	{
+		return m_pUploadQueue;
+	}
 }
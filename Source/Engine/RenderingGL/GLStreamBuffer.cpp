@@ -0,0 +1,288 @@
+#include "Precompile.h"
+
+#include "RenderingGL.h"
+#include "RenderingGL/GLStreamBuffer.h"
+
+#include "GL/glew.h"
+
+using namespace Helium;
+
+/// Timeout for each wait on a segment fence, in nanoseconds.
+static const GLuint64 SEGMENT_FENCE_WAIT_TIMEOUT = 1000000;
+
+/// Constructor.
+GLStreamBuffer::GLStreamBuffer()
+: m_target( GL_ARRAY_BUFFER )
+, m_buffer( 0 )
+, m_pMappedData( NULL )
+, m_segmentSize( 0 )
+, m_segmentIndex( 0 )
+, m_writeOffset( 0 )
+, m_segmentSerial( 0 )
+, m_bRangeMapped( false )
+{
+	for( size_t segmentIndex = 0; segmentIndex < SEGMENT_COUNT; ++segmentIndex )
+	{
+		m_segmentFences[ segmentIndex ] = NULL;
+	}
+}
+
+/// Destructor.
+GLStreamBuffer::~GLStreamBuffer()
+{
+	Shutdown();
+}
+
+/// Create the buffer object.
+///
+/// @param[in] target              Target to which the buffer is bound for creation and mapping.
+/// @param[in] segmentSize         Size of each segment, in bytes (the buffer holds SEGMENT_COUNT segments).
+/// @param[in] bPersistentMapping  True to map the buffer persistently, false to map each range individually.  This
+///                                should only be true if GL 4.4 or ARB_buffer_storage is supported.
+///
+/// @return  True if initialization was successful, false if not.
+///
+/// @see Shutdown()
+bool GLStreamBuffer::Initialize( GLenum target, size_t segmentSize, bool bPersistentMapping )
+{
+	HELIUM_ASSERT( segmentSize != 0 );
+
+	Shutdown();
+
+	const size_t bufferSize = segmentSize * SEGMENT_COUNT;
+
+	glGenBuffers( 1, &m_buffer );
+	HELIUM_ASSERT( m_buffer != 0 );
+	if( m_buffer == 0 )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLStreamBuffer::Initialize(): Failed to create OpenGL buffer object.\n" );
+		return false;
+	}
+
+	glBindBuffer( target, m_buffer );
+
+	if( bPersistentMapping )
+	{
+		// Buffer storage is immutable, so the buffer object needs to be recreated if persistent mapping fails.
+		const GLbitfield storageFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage( target, bufferSize, NULL, storageFlags );
+		m_pMappedData = static_cast< uint8_t* >( glMapBufferRange( target, 0, bufferSize, storageFlags ) );
+		if( !m_pMappedData )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"GLStreamBuffer::Initialize(): Failed to persistently map buffer; mapping ranges individually instead.\n" );
+
+			glDeleteBuffers( 1, &m_buffer );
+			glGenBuffers( 1, &m_buffer );
+			HELIUM_ASSERT( m_buffer != 0 );
+			glBindBuffer( target, m_buffer );
+		}
+	}
+
+	if( !m_pMappedData )
+	{
+		glBufferData( target, bufferSize, NULL, GL_STREAM_DRAW );
+	}
+
+	m_target = target;
+	m_segmentSize = segmentSize;
+	m_segmentIndex = 0;
+	m_writeOffset = 0;
+	m_segmentSerial = 0;
+
+	return true;
+}
+
+/// Release the buffer object and any pending fences.
+///
+/// @see Initialize()
+void GLStreamBuffer::Shutdown()
+{
+	for( size_t segmentIndex = 0; segmentIndex < SEGMENT_COUNT; ++segmentIndex )
+	{
+		if( m_segmentFences[ segmentIndex ] )
+		{
+			glDeleteSync( m_segmentFences[ segmentIndex ] );
+			m_segmentFences[ segmentIndex ] = NULL;
+		}
+	}
+
+	if( m_buffer )
+	{
+		if( m_pMappedData || m_bRangeMapped )
+		{
+			glBindBuffer( m_target, m_buffer );
+			glUnmapBuffer( m_target );
+		}
+
+		glDeleteBuffers( 1, &m_buffer );
+		m_buffer = 0;
+	}
+
+	m_pMappedData = NULL;
+	m_bRangeMapped = false;
+	m_segmentSize = 0;
+}
+
+/// Allocate a range of this buffer for writing new data, moving on to the next segment if the current segment does
+/// not have enough space left.
+///
+/// The returned range should be unmapped using Unmap() once written.
+///
+/// @param[in]  size       Number of bytes to allocate (cannot be larger than the segment size).
+/// @param[in]  alignment  Required alignment of the range offset, in bytes.
+/// @param[out] rOffset    Offset of the allocated range within the buffer object.
+///
+/// @return  Pointer to the mapped range, or null if allocation failed.
+///
+/// @see MapRange(), Unmap()
+void* GLStreamBuffer::Allocate( size_t size, size_t alignment, size_t& rOffset )
+{
+	HELIUM_ASSERT( m_buffer );
+	HELIUM_ASSERT( alignment != 0 );
+
+	if( size > m_segmentSize )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"GLStreamBuffer::Allocate(): Allocation size (%" PRIuSZ ") is larger than the segment size (%" PRIuSZ ").\n",
+			size,
+			m_segmentSize );
+		return NULL;
+	}
+
+	size_t segmentEnd = ( m_segmentIndex + 1 ) * m_segmentSize;
+	size_t offset = ( ( m_writeOffset + alignment - 1 ) / alignment ) * alignment;
+	if( offset + size > segmentEnd )
+	{
+		BeginNextSegment();
+
+		segmentEnd = ( m_segmentIndex + 1 ) * m_segmentSize;
+		offset = ( ( m_writeOffset + alignment - 1 ) / alignment ) * alignment;
+		HELIUM_ASSERT( offset + size <= segmentEnd );
+	}
+
+	m_writeOffset = offset + size;
+	rOffset = offset;
+
+	return MapRange( offset, size, true );
+}
+
+/// Map a range of this buffer for writing, without waiting on any commands using its current contents.
+///
+/// @param[in] offset       Offset of the range within the buffer object.
+/// @param[in] size         Size of the range, in bytes.
+/// @param[in] bInvalidate  True if the previous contents of the range can be discarded.
+///
+/// @return  Pointer to the mapped range, or null if mapping failed.
+///
+/// @see Allocate(), Unmap()
+void* GLStreamBuffer::MapRange( size_t offset, size_t size, bool bInvalidate )
+{
+	HELIUM_ASSERT( m_buffer );
+	HELIUM_ASSERT( offset + size <= m_segmentSize * SEGMENT_COUNT );
+	HELIUM_ASSERT( !m_bRangeMapped );
+
+	if( m_pMappedData )
+	{
+		return m_pMappedData + offset;
+	}
+
+	GLbitfield accessFlags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+	if( bInvalidate )
+	{
+		accessFlags |= GL_MAP_INVALIDATE_RANGE_BIT;
+	}
+
+	glBindBuffer( m_target, m_buffer );
+	void* pData = glMapBufferRange( m_target, offset, size, accessFlags );
+	if( !pData )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLStreamBuffer::MapRange(): Failed to map OpenGL buffer range.\n" );
+		return NULL;
+	}
+
+	m_bRangeMapped = true;
+
+	return pData;
+}
+
+/// Finish writing the most recently mapped range.
+///
+/// @see Allocate(), MapRange()
+void GLStreamBuffer::Unmap()
+{
+	if( !m_bRangeMapped )
+	{
+		// Persistently mapped writes are coherent, so there is nothing to do.
+		return;
+	}
+
+	glBindBuffer( m_target, m_buffer );
+	GLboolean result = glUnmapBuffer( m_target );
+	if( result == GL_FALSE )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"GLStreamBuffer::Unmap(): An error occurred while unmapping a buffer range.\n" );
+	}
+
+	m_bRangeMapped = false;
+}
+
+/// Move on to filling the next segment, waiting for the GPU to finish using its previous contents if necessary.
+void GLStreamBuffer::BeginNextSegment()
+{
+	// Data in the segment being left may still be bound for draw calls that have not been issued yet, but everything
+	// using the segment before it has been issued by now, so fence that one instead.
+	size_t previousIndex = ( m_segmentIndex + SEGMENT_COUNT - 1 ) % SEGMENT_COUNT;
+	if( m_segmentFences[ previousIndex ] )
+	{
+		glDeleteSync( m_segmentFences[ previousIndex ] );
+	}
+
+	m_segmentFences[ previousIndex ] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+
+	m_segmentIndex = ( m_segmentIndex + 1 ) % SEGMENT_COUNT;
+	m_writeOffset = m_segmentIndex * m_segmentSize;
+	++m_segmentSerial;
+
+	WaitForSegment( m_segmentIndex );
+}
+
+/// Wait for the GPU to finish all commands using the data in a given segment.
+///
+/// @param[in] segmentIndex  Index of the segment to wait on.
+void GLStreamBuffer::WaitForSegment( size_t segmentIndex )
+{
+	HELIUM_ASSERT( segmentIndex < SEGMENT_COUNT );
+
+	GLsync fence = m_segmentFences[ segmentIndex ];
+	if( !fence )
+	{
+		return;
+	}
+
+	GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	for( ; ; )
+	{
+		GLenum result = glClientWaitSync( fence, waitFlags, SEGMENT_FENCE_WAIT_TIMEOUT );
+		if( result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED )
+		{
+			break;
+		}
+
+		if( result == GL_WAIT_FAILED )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "GLStreamBuffer: Failed to wait on a buffer segment fence.\n" );
+			break;
+		}
+
+		// Commands only need to be flushed once.
+		waitFlags = 0;
+	}
+
+	glDeleteSync( fence );
+	m_segmentFences[ segmentIndex ] = NULL;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Platform/System.h"
+
+#include "GL/glew.h"
+
+namespace Helium
+{
+	/// OpenGL buffer for streaming data written by the CPU that changes every frame.
+	///
+	/// The buffer is split into a fixed number of segments that are filled in turn, each protected by a fence, so
+	/// writing new data never waits on the driver for data still in use by the GPU.  When persistent buffer mapping
+	/// (GL 4.4 or ARB_buffer_storage) is available, the buffer is mapped once for its entire lifetime.  Otherwise, each
+	/// range is mapped unsynchronized, relying on the segment fences to avoid overwriting data still in use.
+	///
+	/// Data allocated in a segment remains valid for draw calls issued until the segment after it is finished (see
+	/// GetSegmentSerial()).
+	class GLStreamBuffer
+	{
+	public:
+		/// Number of segments in each buffer.
+		static const size_t SEGMENT_COUNT = 3;
+
+		/// @name Construction/Destruction
+		//@{
+		GLStreamBuffer();
+		~GLStreamBuffer();
+		//@}
+
+		/// @name Initialization
+		//@{
+		bool Initialize( GLenum target, size_t segmentSize, bool bPersistentMapping );
+		void Shutdown();
+		//@}
+
+		/// @name Data Access
+		//@{
+		void* Allocate( size_t size, size_t alignment, size_t& rOffset );
+		void* MapRange( size_t offset, size_t size, bool bInvalidate = false );
+		void Unmap();
+
+		inline unsigned GetGLBuffer() const;
+		inline size_t GetSegmentSize() const;
+		inline uint64_t GetSegmentSerial() const;
+		inline bool IsPersistentlyMapped() const;
+		//@}
+
+	private:
+		/// Buffer binding target.
+		GLenum m_target;
+		/// Buffer object.
+		unsigned m_buffer;
+		/// Persistently mapped buffer data, or null if ranges are mapped individually.
+		uint8_t* m_pMappedData;
+
+		/// Size of each segment, in bytes.
+		size_t m_segmentSize;
+		/// Index of the segment currently being filled.
+		size_t m_segmentIndex;
+		/// Offset of the next allocation within the buffer.
+		size_t m_writeOffset;
+		/// Number of segments started since the buffer was initialized.
+		uint64_t m_segmentSerial;
+		/// Fence for the commands using the data in each segment.
+		GLsync m_segmentFences[ SEGMENT_COUNT ];
+
+		/// True if a range is currently mapped individually.
+		bool m_bRangeMapped;
+
+		/// @name Private Utility Functions
+		//@{
+		void BeginNextSegment();
+		void WaitForSegment( size_t segmentIndex );
+		//@}
+	};
+}
+
+#include "RenderingGL/GLStreamBuffer.inl"
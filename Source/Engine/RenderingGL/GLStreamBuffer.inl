@@ -0,0 +1,38 @@
+namespace Helium
+{
+	/// Get the OpenGL buffer object.
+	///
+	/// @return  OpenGL buffer handle.
+	unsigned GLStreamBuffer::GetGLBuffer() const
+	{
+		return m_buffer;
+	}
+
+	/// Get the size of each segment of this buffer.
+	///
+	/// @return  Segment size, in bytes.
+	size_t GLStreamBuffer::GetSegmentSize() const
+	{
+		return m_segmentSize;
+	}
+
+	/// Get the serial number of the segment currently being filled.
+	///
+	/// The serial number is incremented each time allocation moves on to the next segment.  Data allocated while the
+	/// serial number was a given value can be used by draw calls until the serial number has advanced by
+	/// SEGMENT_COUNT - 1, after which it must be allocated again.
+	///
+	/// @return  Current segment serial number.
+	uint64_t GLStreamBuffer::GetSegmentSerial() const
+	{
+		return m_segmentSerial;
+	}
+
+	/// Get whether this buffer is persistently mapped.
+	///
+	/// @return  True if the buffer is mapped for its entire lifetime, false if ranges are mapped individually.
+	bool GLStreamBuffer::IsPersistentlyMapped() const
+	{
+		return ( m_pMappedData != NULL );
+	}
+}
@@ -1,32 +1,66 @@
 #include "Precompile.h"
 #include "RenderingGL/GLTexture2d.h"
 
+#include "RenderingGL/GLRenderer.h"
 #include "RenderingGL/GLSurface.h"
+#include "RenderingGL/GLUploadQueue.h"
 
+#include "Platform/Atomic.h"
 #include "Rendering/RendererUtil.h"
+#include "Engine/RenderStatistics.h"
 
 using namespace Helium;
 
 /// Constructor.
 ///
-/// @param[in] texture  OpenGL texture to wrap.
-/// @param[in] format   Format of the provided texture object.
-GLTexture2d::GLTexture2d( GLuint texture, uint32_t mipCount, ERendererPixelFormat format )
+/// @param[in] texture   OpenGL texture to wrap.
+/// @param[in] width     Width of the top mip level, in pixels.
+/// @param[in] height    Height of the top mip level, in pixels.
+/// @param[in] mipCount  Number of mip levels in the texture.
+/// @param[in] format    Format of the provided texture object.
+/// @param[in] usage     Texture usage.
+GLTexture2d::GLTexture2d(
+	GLuint texture,
+	uint32_t width,
+	uint32_t height,
+	uint32_t mipCount,
+	ERendererPixelFormat format,
+	ERendererBufferUsage usage )
 : m_texture( texture )
+, m_width( width )
+, m_height( height )
 , m_mipCount( mipCount )
 , m_format( format )
+, m_usage( usage )
+, m_pendingUploadCount( 0 )
 {
 	HELIUM_ASSERT( texture );
 	HELIUM_ASSERT( mipCount );
 	HELIUM_ASSERT( format < ERendererPixelFormat::RENDERER_PIXEL_FORMAT_MAX );
+
+	m_mipStagingData.Add( NULL, mipCount );
 }
 
 /// Destructor.
 GLTexture2d::~GLTexture2d()
 {
+	// Queued uploads hold a reference to the texture, so only mip levels that were never unmapped can be left.
+	HELIUM_ASSERT( m_pendingUploadCount == 0 );
+
+	size_t mipCount = m_mipStagingData.GetSize();
+	for( size_t mipIndex = 0; mipIndex < mipCount; ++mipIndex )
+	{
+		void* pStagingData = m_mipStagingData[ mipIndex ];
+		HELIUM_ASSERT( !pStagingData );
+		if( pStagingData )
+		{
+			DefaultAllocator().Free( pStagingData );
+		}
+	}
+
 	if( m_texture )
 	{
-		glDeleteBuffers( 1, &m_texture );
+		glDeleteTextures( 1, &m_texture );
 		m_texture = 0;
 	}
 }
@@ -38,68 +72,80 @@ uint32_t GLTexture2d::GetMipCount() const
 }
 
 /// @copydoc RTexture2d::Map()
-void* GLTexture2d::Map( uint32_t mipLevel, size_t& rPitch, ERendererBufferMapHint hint )
+void* GLTexture2d::Map( uint32_t mipLevel, size_t& rPitch, ERendererBufferMapHint /*hint*/ )
 {
-	/*
-    // Whole-resource mapping is not supported with Direct3D 9 on the PC.
-    HELIUM_ASSERT( IsValid( mipLevel ) );
+	// Whole-resource mapping is not supported.
+	HELIUM_ASSERT( mipLevel < m_mipCount );
+	if( mipLevel >= m_mipCount )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLTexture2d::Map(): Provided mipLevel is out of bounds.\n" );
+		return NULL;
+	}
 
-    // Attempt to lock the requested mip level (we intentionally skip manual mip index validation for performance in
-    // favor of just checking for a successful result when calling IDirect3DTexture9::LockRect()).
-    D3DLOCKED_RECT lockedRect;
-    DWORD flags = 0;
-    if( hint == RENDERER_BUFFER_MAP_HINT_DISCARD )
-    {
-        flags = D3DLOCK_DISCARD;
-    }
-    else if( hint == RENDERER_BUFFER_MAP_HINT_NO_OVERWRITE )
-    {
-        flags = D3DLOCK_NOOVERWRITE;
-    }
+	HELIUM_ASSERT( !m_mipStagingData[ mipLevel ] );
 
-    HRESULT result = m_pTexture->LockRect( mipLevel, &lockedRect, NULL, flags );
-    if( FAILED( result ) )
-    {
-        HELIUM_TRACE(
-            TraceLevels::Error,
-            "D3D9Texture2d::Map(): Failed to lock mip level %" PRIu32 " (error code 0x%x).\n",
-            mipLevel,
-            result );
+	// Staged data is always uploaded in full, so the previous contents of the mip level never need to be read back.
+	size_t mipLevelSize = GetMipLevelSize( mipLevel );
+	void* pStagingData = DefaultAllocator().Allocate( mipLevelSize );
+	HELIUM_ASSERT( pStagingData );
+	if( !pStagingData )
+	{
+		HELIUM_TRACE(
+			TraceLevels::Error,
+			"GLTexture2d::Map(): Failed to allocate %" PRIuSZ " bytes of staging memory for mip level %" PRIu32 ".\n",
+			mipLevelSize,
+			mipLevel );
 
-        return NULL;
-    }
+		return NULL;
+	}
 
-    HELIUM_ASSERT( lockedRect.pBits );
+	m_mipStagingData[ mipLevel ] = pStagingData;
 
-    rPitch = static_cast< size_t >( lockedRect.Pitch );
+	rPitch = GetMipLevelPitch( mipLevel );
 
-    return lockedRect.pBits;
-	*/
+	RenderStatistics::RecordUpload( RenderStatistics::COUNTER_TEXTURE_BYTES, mipLevelSize );
 
-	HELIUM_BREAK();
-	return NULL;
+	return pStagingData;
 }
 
 /// @copydoc RTexture2d::Unmap()
 void GLTexture2d::Unmap( uint32_t mipLevel )
 {
-	/*
-    // Make sure the mip level is valid (whole-resource mapping is not supported with Direct3D 9 on the PC, so we
-    // know an invalid index value should not be provided either).
-    HELIUM_ASSERT( mipLevel < m_mipCount );
+	HELIUM_ASSERT( mipLevel < m_mipCount );
+
+	void* pStagingData = m_mipStagingData[ mipLevel ];
+	HELIUM_ASSERT( pStagingData );
+	if( !pStagingData )
+	{
+		return;
+	}
+
+	m_mipStagingData[ mipLevel ] = NULL;
 
-    HRESULT result = m_pTexture->UnlockRect( mipLevel );
-    if( FAILED( result ) )
-    {
-        HELIUM_TRACE(
-            TraceLevels::Error,
-            "D3D9Texture2d::Unmap(): Failed to unlock texture mip level %" PRIu32 " (error code 0x%x).\n",
-            mipLevel,
-            result );
-    }
-	*/
+	GLRenderer* pRenderer = static_cast< GLRenderer* >( Renderer::GetInstance() );
+	HELIUM_ASSERT( pRenderer );
 
-	HELIUM_BREAK();
+	GLUploadQueue* pUploadQueue = pRenderer->GetUploadQueue();
+	HELIUM_ASSERT( pUploadQueue );
+
+	// Dynamic textures are expected to be used as soon as they are written, so they are uploaded right away.  Uploads
+	// to any other texture are made by the renderer on the GL context thread within its per-frame upload budget.
+	if( m_usage != RENDERER_BUFFER_USAGE_DYNAMIC )
+	{
+		AtomicIncrementRelease( m_pendingUploadCount );
+		pUploadQueue->QueueTextureUpload( this, mipLevel, pStagingData, GetMipLevelSize( mipLevel ) );
+
+		return;
+	}
+
+	pUploadQueue->UploadTexture( this, mipLevel, pStagingData, GetMipLevelSize( mipLevel ) );
+	DefaultAllocator().Free( pStagingData );
+}
+
+/// @copydoc RRenderResource::IsUploadPending()
+bool GLTexture2d::IsUploadPending() const
+{
+	return ( m_pendingUploadCount != 0 );
 }
 
 /// @copydoc RTexture2d::CanMapWholeResource()
@@ -119,11 +165,7 @@ uint32_t GLTexture2d::GetWidth( uint32_t mipLevel ) const
 		return 0;
 	}
 
-	GLint width = 0;
-	glBindTexture( GL_TEXTURE_2D, m_texture );
-	glGetTexLevelParameteriv( GL_TEXTURE_2D, mipLevel, GL_TEXTURE_WIDTH, &width );
-
-	return width;
+	return Max< uint32_t >( m_width >> mipLevel, 1 );
 }
 
 /// @copydoc RTexture2d::GetHeight()
@@ -136,11 +178,7 @@ uint32_t GLTexture2d::GetHeight( uint32_t mipLevel ) const
 		return 0;
 	}
 
-	GLint height = 0;
-	glBindTexture( GL_TEXTURE_2D, m_texture );
-	glGetTexLevelParameteriv( GL_TEXTURE_2D, mipLevel, GL_TEXTURE_HEIGHT, &height );
-
-	return height;
+	return Max< uint32_t >( m_height >> mipLevel, 1 );
 }
 
 /// @copydoc RTexture2d::GetPixelFormat()
@@ -180,3 +218,82 @@ RSurface* GLTexture2d::GetSurface( uint32_t mipLevel )
 
 	return surface;
 }
+
+/// Upload the contents of a mip level to the texture.
+///
+/// Data is tightly packed, with each row taking GetMipLevelPitch() bytes.  If a pixel unpack buffer is bound, the
+/// data pointer is an offset into the buffer.  This must only be called from the thread that owns the OpenGL context.
+///
+/// @param[in] mipLevel  Index of the mip level to upload.
+/// @param[in] pData     Mip level contents, or offset of the contents in the bound pixel unpack buffer.
+void GLTexture2d::UploadMipLevel( uint32_t mipLevel, const void* pData )
+{
+	HELIUM_ASSERT( mipLevel < m_mipCount );
+
+	GLRenderer* pRenderer = static_cast< GLRenderer* >( Renderer::GetInstance() );
+	HELIUM_ASSERT( pRenderer );
+
+	GLenum internalFormat = GL_NONE;
+	GLenum pixelFormat = GL_NONE;
+	GLenum elementType = GL_NONE;
+	pRenderer->PixelFormatToGLFormat( m_format, internalFormat, pixelFormat, elementType );
+
+	const uint32_t mipWidth = GetWidth( mipLevel );
+	const uint32_t mipHeight = GetHeight( mipLevel );
+	const uint32_t pitch = static_cast< uint32_t >( GetMipLevelPitch( mipLevel ) );
+
+	// Store the currently bound 2D texture.
+	GLint curTexture2D;
+	glGetIntegerv( GL_TEXTURE_BINDING_2D, &curTexture2D );
+
+	glBindTexture( GL_TEXTURE_2D, m_texture );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, static_cast< GLint >( RendererUtil::PixelPitchToPackAlignment( pitch, 8 ) ) );
+
+	if( !RendererUtil::IsCompressedFormat( m_format ) )
+	{
+		glTexSubImage2D( GL_TEXTURE_2D, mipLevel, 0, 0, mipWidth, mipHeight, pixelFormat, elementType, pData );
+	}
+	else
+	{
+		const GLsizei imageSize = static_cast< GLsizei >( GetMipLevelSize( mipLevel ) );
+		glCompressedTexSubImage2D( GL_TEXTURE_2D, mipLevel, 0, 0, mipWidth, mipHeight, internalFormat, imageSize, pData );
+	}
+
+	glBindTexture( GL_TEXTURE_2D, curTexture2D );
+}
+
+/// Get the number of bytes in each row of pixels (or blocks, for compressed formats) of a mip level's staging data.
+///
+/// @param[in] mipLevel  Mip level index.
+///
+/// @return  Row pitch, in bytes.
+///
+/// @see GetMipLevelSize()
+size_t GLTexture2d::GetMipLevelPitch( uint32_t mipLevel ) const
+{
+	// A single pixel row covers a single block row for compressed formats as well.
+	return RendererUtil::GetTexture2dMemorySize( GetWidth( mipLevel ), 1, 1, m_format );
+}
+
+/// Get the number of bytes in a mip level's staging data.
+///
+/// @param[in] mipLevel  Mip level index.
+///
+/// @return  Mip level size, in bytes.
+///
+/// @see GetMipLevelPitch()
+size_t GLTexture2d::GetMipLevelSize( uint32_t mipLevel ) const
+{
+	return RendererUtil::GetTexture2dMemorySize( GetWidth( mipLevel ), GetHeight( mipLevel ), 1, m_format );
+}
+
+/// Release the staging memory of a mip level once its queued upload has been made or discarded.
+///
+/// @param[in] pStagingData  Staging memory of the mip level.
+void GLTexture2d::CommitMipLevel( void* pStagingData )
+{
+	DefaultAllocator().Free( pStagingData );
+
+	HELIUM_ASSERT( m_pendingUploadCount != 0 );
+	AtomicDecrementRelease( m_pendingUploadCount );
+}
@@ -3,15 +3,26 @@
 #include "RenderingGL/RenderingGL.h"
 #include "Rendering/RTexture2d.h"
 
+#include "Foundation/DynamicArray.h"
+
 namespace Helium
 {
 	/// OpenGL 2D texture implementation.
+	///
+	/// Mapped mip levels are written to staging memory in system memory, so textures can be filled from any thread.
+	/// Unmapping a mip level of a dynamic texture uploads it immediately (dynamic textures must only be mapped on the
+	/// thread that owns the OpenGL context), while mip levels of other textures are queued with the renderer's
+	/// GLUploadQueue and uploaded within its per-frame budget.
 	class GLTexture2d : public RTexture2d
 	{
+		friend class GLUploadQueue;
+
 	public:
 		/// @name Construction/Destruction
 		//@{
-		GLTexture2d( GLuint texture, uint32_t mipCount, ERendererPixelFormat format );
+		GLTexture2d(
+			GLuint texture, uint32_t width, uint32_t height, uint32_t mipCount, ERendererPixelFormat format,
+			ERendererBufferUsage usage );
 		//@}
 
 		/// @name Base Texture Information
@@ -25,6 +36,8 @@ namespace Helium
 		virtual void Unmap( uint32_t mipLevel );
 		bool CanMapWholeResource() const;
 
+		bool IsUploadPending() const;
+
 		uint32_t GetWidth( uint32_t mipLevel ) const;
 		uint32_t GetHeight( uint32_t mipLevel ) const;
 		ERendererPixelFormat GetPixelFormat() const;
@@ -35,18 +48,41 @@ namespace Helium
 		inline GLuint GetGLTexture() const;
 		//@}
 
+		/// @name Uploading
+		//@{
+		void UploadMipLevel( uint32_t mipLevel, const void* pData );
+		size_t GetMipLevelPitch( uint32_t mipLevel ) const;
+		size_t GetMipLevelSize( uint32_t mipLevel ) const;
+		//@}
+
 	protected:
 		/// OpenGL texture handle.
 		GLuint m_texture;
+		/// Width of the top mip level, in pixels.
+		uint32_t m_width;
+		/// Height of the top mip level, in pixels.
+		uint32_t m_height;
 		/// Number of mip levels in this texture.
 		uint32_t m_mipCount;
 		/// Pixel format of our texture.
 		ERendererPixelFormat m_format;
+		/// Texture usage.
+		ERendererBufferUsage m_usage;
+
+		/// Staging memory for each currently mapped mip level (null for levels that are not mapped).
+		DynamicArray< void* > m_mipStagingData;
+		/// Number of unmapped mip levels waiting in the upload queue.
+		volatile int32_t m_pendingUploadCount;
 
 		/// @name Construction/Destruction
 		//@{
 		virtual ~GLTexture2d();
 		//@}
+
+		/// @name Staging Area Uploading
+		//@{
+		void CommitMipLevel( void* pStagingData );
+		//@}
 	};
 }
 
@@ -0,0 +1,65 @@
+#include "Precompile.h"
+#include "RenderingGL/GLTimerQuery.h"
+
+#include "GL/glew.h"
+
+using namespace Helium;
+
+/// Constructor.
+///
+/// @param[in] query  OpenGL query object to wrap.  This object will take ownership of the query object and delete it
+///                   when destroyed.
+GLTimerQuery::GLTimerQuery( GLuint query )
+: m_query( query )
+, m_bPending( false )
+{
+	HELIUM_ASSERT( query != 0 );
+}
+
+/// Destructor.
+GLTimerQuery::~GLTimerQuery()
+{
+	if( m_query != 0 )
+	{
+		glDeleteQueries( 1, &m_query );
+		m_query = 0;
+	}
+}
+
+/// Record the GPU timestamp once all previously issued commands have completed.
+///
+/// @see TryGetTimestamp()
+void GLTimerQuery::Issue()
+{
+	glQueryCounter( m_query, GL_TIMESTAMP );
+	m_bPending = true;
+}
+
+/// Read the recorded timestamp without blocking.
+///
+/// @param[out] rTimestamp  GPU timestamp, in nanoseconds, if available.
+///
+/// @return  True if the result was available, false if the query has not been issued or the GPU has not reached it.
+///
+/// @see Issue()
+bool GLTimerQuery::TryGetTimestamp( uint64_t& rTimestamp )
+{
+	if( !m_bPending )
+	{
+		return false;
+	}
+
+	GLint bAvailable = GL_FALSE;
+	glGetQueryObjectiv( m_query, GL_QUERY_RESULT_AVAILABLE, &bAvailable );
+	if( !bAvailable )
+	{
+		return false;
+	}
+
+	GLuint64 timestamp = 0;
+	glGetQueryObjectui64v( m_query, GL_QUERY_RESULT, &timestamp );
+	rTimestamp = static_cast< uint64_t >( timestamp );
+	m_bPending = false;
+
+	return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Rendering/RTimerQuery.h"
+
+#include "GL/glew.h"
+
+namespace Helium
+{
+	/// OpenGL GPU timestamp query implementation (GL_TIMESTAMP query counter).
+	class GLTimerQuery : public RTimerQuery
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		explicit GLTimerQuery( GLuint query );
+		//@}
+
+		/// @name Query Operations
+		//@{
+		void Issue();
+		bool TryGetTimestamp( uint64_t& rTimestamp );
+
+		inline GLuint GetQuery() const;
+		//@}
+
+	protected:
+		/// OpenGL query object.
+		GLuint m_query;
+		/// True if the query has been issued and its result has not been read yet.
+		bool m_bPending;
+
+		/// @name Construction/Destruction
+		//@{
+		~GLTimerQuery();
+		//@}
+	};
+}
+
+#include "RenderingGL/GLTimerQuery.inl"
@@ -0,0 +1,10 @@
+namespace Helium
+{
+	/// Get the OpenGL query object associated with this timer query.
+	///
+	/// @return  Query object.
+	GLuint GLTimerQuery::GetQuery() const
+	{
+		return m_query;
+	}
+}
@@ -0,0 +1,216 @@
+#include "Precompile.h"
+#include "RenderingGL/GLUploadQueue.h"
+
+#include "RenderingGL/GLTexture2d.h"
+
+#include "GL/glew.h"
+
+using namespace Helium;
+
+/// Alignment of each upload staged in the pixel unpack buffer, in bytes.
+static const size_t UNPACK_BUFFER_ALIGNMENT = 16;
+
+/// Constructor.
+GLUploadQueue::GLUploadQueue()
+: m_frameByteBudget( DEFAULT_FRAME_BYTE_BUDGET )
+{
+}
+
+/// Destructor.
+GLUploadQueue::~GLUploadQueue()
+{
+	Shutdown();
+}
+
+/// Create the pixel unpack buffer through which uploads are staged.
+///
+/// This must be called from the thread that owns the OpenGL context.  The unpack buffer segment size is set to the
+/// current frame byte budget.  If the unpack buffer cannot be created, uploads are made directly from system memory
+/// instead.
+///
+/// @param[in] bPersistentMapping  True to map the unpack buffer persistently (GL 4.4 or ARB_buffer_storage only).
+///
+/// @return  True if initialization was successful, false if not.
+///
+/// @see Shutdown()
+bool GLUploadQueue::Initialize( bool bPersistentMapping )
+{
+	bool bResult = m_unpackBuffer.Initialize( GL_PIXEL_UNPACK_BUFFER, m_frameByteBudget, bPersistentMapping );
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+
+	return bResult;
+}
+
+/// Release all pending uploads and the pixel unpack buffer.
+///
+/// @see Initialize()
+void GLUploadQueue::Shutdown()
+{
+	Discard();
+
+	m_unpackBuffer.Shutdown();
+}
+
+/// Queue the upload of a texture mip level from staging memory.
+///
+/// @param[in] pTexture      Texture to update.
+/// @param[in] mipLevel      Index of the mip level to upload.
+/// @param[in] pStagingData  Mip level contents, allocated using DefaultAllocator.  The queue takes ownership of this
+///                          memory and frees it once the upload has been made.
+/// @param[in] size          Number of bytes in the mip level.
+void GLUploadQueue::QueueTextureUpload( GLTexture2d* pTexture, uint32_t mipLevel, void* pStagingData, size_t size )
+{
+	HELIUM_ASSERT( pTexture );
+	HELIUM_ASSERT( pStagingData );
+
+	MutexScopeLock scopeLock( m_lock );
+
+	Entry* pEntry = m_entries.New();
+	HELIUM_ASSERT( pEntry );
+	pEntry->spTexture = pTexture;
+	pEntry->pStagingData = pStagingData;
+	pEntry->size = size;
+	pEntry->mipLevel = mipLevel;
+}
+
+/// Upload a texture mip level immediately through the pixel unpack buffer.
+///
+/// Data larger than the unpack buffer segment size is uploaded directly from system memory.  This must only be called
+/// from the thread that owns the OpenGL context.
+///
+/// @param[in] pTexture  Texture to update.
+/// @param[in] mipLevel  Index of the mip level to upload.
+/// @param[in] pData     Mip level contents.
+/// @param[in] size      Number of bytes in the mip level.
+void GLUploadQueue::UploadTexture( GLTexture2d* pTexture, uint32_t mipLevel, const void* pData, size_t size )
+{
+	HELIUM_ASSERT( pTexture );
+	HELIUM_ASSERT( pData );
+
+	unsigned unpackBuffer = m_unpackBuffer.GetGLBuffer();
+	if( unpackBuffer && size <= m_unpackBuffer.GetSegmentSize() )
+	{
+		size_t offset = 0;
+		void* pStreamData = m_unpackBuffer.Allocate( size, UNPACK_BUFFER_ALIGNMENT, offset );
+		if( pStreamData )
+		{
+			MemoryCopy( pStreamData, pData, size );
+			m_unpackBuffer.Unmap();
+
+			// With an unpack buffer bound, the data pointer passed to the texture update is an offset into the buffer.
+			glBindBuffer( GL_PIXEL_UNPACK_BUFFER, unpackBuffer );
+			pTexture->UploadMipLevel( mipLevel, reinterpret_cast< const void* >( offset ) );
+			glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+
+			return;
+		}
+
+		// Make sure a failed mapping attempt did not leave the unpack buffer bound for the direct upload.
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+	}
+
+	pTexture->UploadMipLevel( mipLevel, pData );
+}
+
+/// Make the pending uploads for the current frame.
+///
+/// Uploads are made in the order in which they were queued until the frame byte budget is reached.  At least one
+/// upload is always made if any are pending, so textures larger than the budget still make progress.  This must only
+/// be called from the thread that owns the OpenGL context.
+///
+/// @see SetFrameByteBudget(), Discard()
+void GLUploadQueue::Process()
+{
+	HELIUM_ASSERT( m_processEntries.IsEmpty() );
+
+	{
+		MutexScopeLock scopeLock( m_lock );
+
+		size_t entryCount = m_entries.GetSize();
+		size_t processCount = 0;
+		size_t byteCount = 0;
+		while( processCount < entryCount && ( processCount == 0 || byteCount < m_frameByteBudget ) )
+		{
+			byteCount += m_entries[ processCount ].size;
+			++processCount;
+		}
+
+		if( processCount == 0 )
+		{
+			return;
+		}
+
+		m_processEntries.AddArray( m_entries.GetData(), processCount );
+		m_entries.Remove( 0, processCount );
+	}
+
+	// Make the uploads outside the lock so that loading threads can keep queuing uploads in the meantime.
+	size_t processCount = m_processEntries.GetSize();
+	for( size_t entryIndex = 0; entryIndex < processCount; ++entryIndex )
+	{
+		CommitEntry( m_processEntries[ entryIndex ], true );
+	}
+
+	m_processEntries.Resize( 0 );
+}
+
+/// Release all pending uploads without making them.
+///
+/// This is called when shutting down the renderer.  Textures with discarded uploads are left with undefined contents.
+///
+/// @see Process()
+void GLUploadQueue::Discard()
+{
+	MutexScopeLock scopeLock( m_lock );
+
+	size_t entryCount = m_entries.GetSize();
+	for( size_t entryIndex = 0; entryIndex < entryCount; ++entryIndex )
+	{
+		CommitEntry( m_entries[ entryIndex ], false );
+	}
+
+	m_entries.Clear();
+}
+
+/// Set the number of bytes to upload each frame.
+///
+/// The unpack buffer keeps the segment size it was initialized with, so uploads larger than the segment size at that
+/// point are still made directly from system memory.
+///
+/// @param[in] budget  Upload byte budget.
+///
+/// @see GetFrameByteBudget(), Process()
+void GLUploadQueue::SetFrameByteBudget( size_t budget )
+{
+	m_frameByteBudget = budget;
+}
+
+/// Get the number of bytes to upload each frame.
+///
+/// @return  Upload byte budget.
+///
+/// @see SetFrameByteBudget(), Process()
+size_t GLUploadQueue::GetFrameByteBudget() const
+{
+	return m_frameByteBudget;
+}
+
+/// Make or discard the upload for a given entry and release the entry's staging memory.
+///
+/// @param[in] rEntry   Upload entry.
+/// @param[in] bUpload  True to upload the staging data to the texture, false to only release the staging memory.
+void GLUploadQueue::CommitEntry( Entry& rEntry, bool bUpload )
+{
+	GLTexture2d* pTexture = static_cast< GLTexture2d* >( rEntry.spTexture.Get() );
+	HELIUM_ASSERT( pTexture );
+
+	if( bUpload )
+	{
+		UploadTexture( pTexture, rEntry.mipLevel, rEntry.pStagingData, rEntry.size );
+	}
+
+	pTexture->CommitMipLevel( rEntry.pStagingData );
+
+	rEntry.pStagingData = NULL;
+	rEntry.spTexture.Release();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "RenderingGL/GLStreamBuffer.h"
+#include "Rendering/RRenderResource.h"
+
+#include "Platform/Locks.h"
+#include "Foundation/DynamicArray.h"
+
+namespace Helium
+{
+	class GLTexture2d;
+
+	/// Queue of pending texture uploads from system memory staging areas into OpenGL textures.
+	///
+	/// Static texture mip levels are mapped into system memory, which can be written from any thread (i.e. by async
+	/// loads of texture cache data).  Rather than uploading each mip level synchronously on the GL context thread as
+	/// soon as it is unmapped, unmapping adds an entry to this queue, and the renderer makes the uploads once per frame
+	/// (see Process()), up to a byte budget to keep large streaming loads from hitching the frame.  Textures report
+	/// themselves as having an upload pending (RRenderResource::IsUploadPending()) until their queued uploads have been
+	/// made.
+	///
+	/// Each upload is staged in a pixel unpack buffer and transferred using glTexSubImage2D() from the buffer, so the
+	/// driver can copy the data to the texture asynchronously instead of blocking on the transfer.  The unpack buffer is
+	/// a GLStreamBuffer with one segment per frame byte budget (persistently mapped when available), so its fences keep
+	/// the CPU from overwriting staged data still being transferred.
+	class GLUploadQueue
+	{
+	public:
+		/// Default number of bytes to upload each frame.
+		static const size_t DEFAULT_FRAME_BYTE_BUDGET = 4 * 1024 * 1024;
+
+		/// @name Construction/Destruction
+		//@{
+		GLUploadQueue();
+		~GLUploadQueue();
+		//@}
+
+		/// @name Initialization
+		//@{
+		bool Initialize( bool bPersistentMapping );
+		void Shutdown();
+		//@}
+
+		/// @name Upload Queuing
+		//@{
+		void QueueTextureUpload( GLTexture2d* pTexture, uint32_t mipLevel, void* pStagingData, size_t size );
+		void UploadTexture( GLTexture2d* pTexture, uint32_t mipLevel, const void* pData, size_t size );
+		//@}
+
+		/// @name Upload Processing
+		//@{
+		void Process();
+		void Discard();
+
+		void SetFrameByteBudget( size_t budget );
+		size_t GetFrameByteBudget() const;
+		//@}
+
+	private:
+		/// Pending upload.
+		struct Entry
+		{
+			/// Texture to which to upload.
+			SmartPtr< RRenderResource > spTexture;
+			/// Staging memory from which to copy (owned by the entry).
+			void* pStagingData;
+			/// Number of bytes to upload.
+			size_t size;
+			/// Texture mip level to upload.
+			uint32_t mipLevel;
+		};
+
+		/// Pixel unpack buffer through which uploads are staged.
+		GLStreamBuffer m_unpackBuffer;
+
+		/// Pending uploads, in the order in which they were queued.
+		DynamicArray< Entry > m_entries;
+		/// Entries taken off the queue for processing.
+		DynamicArray< Entry > m_processEntries;
+		/// Mutex synchronizing access to the pending upload list.
+		Mutex m_lock;
+
+		/// Number of bytes to upload each frame.
+		size_t m_frameByteBudget;
+
+		/// @name Private Utility Functions
+		//@{
+		void CommitEntry( Entry& rEntry, bool bUpload );
+		//@}
+	};
+}
@@ -0,0 +1,230 @@
+#include "Precompile.h"
+#include "RenderingGL/GLVertexArrayCache.h"
+
+#include "RenderingGL/GLIndexBuffer.h"
+#include "RenderingGL/GLVertexBuffer.h"
+
+using namespace Helium;
+
+/// Number of calls to Tick() between scans for idle vertex arrays.
+static const uint32_t VERTEX_ARRAY_EVICTION_INTERVAL = 64;
+
+/// Constructor.
+GLVertexArrayCache::GLVertexArrayCache()
+: m_tickCount( 0 )
+{
+}
+
+/// Destructor.
+GLVertexArrayCache::~GLVertexArrayCache()
+{
+	Clear();
+}
+
+/// Get the vertex array object for a given vertex description and set of bound buffers, creating it if it has not
+/// been cached yet.
+///
+/// This must only be called from the thread that owns the OpenGL context.  Creating a new vertex array leaves it
+/// bound.
+///
+/// @param[in] pDescription  Vertex description.
+/// @param[in] pStreams      Vertex buffer bound to each of the GLVertexDescription::BUFFER_COUNT_MAX vertex streams.
+///                          Only the streams used by the description are referenced.
+/// @param[in] pIndexBuffer  Bound index buffer (can be null for unindexed draws).
+///
+/// @return  Vertex array object, or zero if a vertex buffer used by the description is not bound.
+GLuint GLVertexArrayCache::GetVertexArray(
+	GLVertexDescription* pDescription,
+	const Stream* pStreams,
+	GLIndexBuffer* pIndexBuffer )
+{
+	HELIUM_ASSERT( pDescription );
+	HELIUM_ASSERT( pStreams );
+
+	static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+	static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+	uint64_t key = FNV_OFFSET_BASIS;
+	key = ( key ^ static_cast< uint64_t >( reinterpret_cast< uintptr_t >( pDescription ) ) ) * FNV_PRIME;
+	key = ( key ^ static_cast< uint64_t >( reinterpret_cast< uintptr_t >( pIndexBuffer ) ) ) * FNV_PRIME;
+
+	// Dynamic buffers move between stream buffer segments, so the current offset of each buffer's data is part of the
+	// key (at most one vertex array per segment is created for each of them).
+	size_t vertexOffsets[ GLVertexDescription::BUFFER_COUNT_MAX ];
+	uint32_t bufferCount = pDescription->m_bufferCount;
+	HELIUM_ASSERT( bufferCount <= GLVertexDescription::BUFFER_COUNT_MAX );
+	for( uint32_t bufferIndex = 0; bufferIndex < bufferCount; ++bufferIndex )
+	{
+		const Stream& rStream = pStreams[ bufferIndex ];
+		if( !rStream.pBuffer )
+		{
+			return 0;
+		}
+
+		vertexOffsets[ bufferIndex ] = rStream.pBuffer->GetGLOffset() + rStream.offset;
+
+		key = ( key ^ static_cast< uint64_t >( reinterpret_cast< uintptr_t >( rStream.pBuffer ) ) ) * FNV_PRIME;
+		key = ( key ^ static_cast< uint64_t >( vertexOffsets[ bufferIndex ] ) ) * FNV_PRIME;
+		key = ( key ^ static_cast< uint64_t >( rStream.stride ) ) * FNV_PRIME;
+	}
+
+	HashMap< uint64_t, Entry >::Iterator entryIterator = m_entries.Find( key );
+	if( entryIterator != m_entries.End() )
+	{
+		Entry& rEntry = entryIterator->Second();
+
+		bool bMatch = ( rEntry.spDescription.Get() == pDescription && rEntry.spIndexBuffer.Get() == pIndexBuffer );
+		for( uint32_t bufferIndex = 0; bMatch && bufferIndex < bufferCount; ++bufferIndex )
+		{
+			bMatch = ( rEntry.spVertexBuffers[ bufferIndex ].Get() == pStreams[ bufferIndex ].pBuffer &&
+				rEntry.vertexOffsets[ bufferIndex ] == vertexOffsets[ bufferIndex ] &&
+				rEntry.strides[ bufferIndex ] == pStreams[ bufferIndex ].stride );
+		}
+
+		if( bMatch )
+		{
+			rEntry.lastUsedTick = m_tickCount;
+
+			return rEntry.vertexArray;
+		}
+
+		// Hash collision with a different set of inputs, so replace the existing entry.
+		glDeleteVertexArrays( 1, &rEntry.vertexArray );
+		m_entries.Remove( entryIterator );
+	}
+
+	Entry entry;
+	entry.spDescription = pDescription;
+	for( uint32_t bufferIndex = 0; bufferIndex < GLVertexDescription::BUFFER_COUNT_MAX; ++bufferIndex )
+	{
+		if( bufferIndex < bufferCount )
+		{
+			entry.spVertexBuffers[ bufferIndex ] = pStreams[ bufferIndex ].pBuffer;
+			entry.vertexOffsets[ bufferIndex ] = vertexOffsets[ bufferIndex ];
+			entry.strides[ bufferIndex ] = pStreams[ bufferIndex ].stride;
+		}
+		else
+		{
+			entry.vertexOffsets[ bufferIndex ] = 0;
+			entry.strides[ bufferIndex ] = 0;
+		}
+	}
+
+	entry.spIndexBuffer = pIndexBuffer;
+	entry.lastUsedTick = m_tickCount;
+	entry.vertexArray = CreateVertexArray( entry );
+	if( !entry.vertexArray )
+	{
+		return 0;
+	}
+
+	m_entries.Insert( entryIterator, HashMap< uint64_t, Entry >::ValueType( key, entry ) );
+
+	return entry.vertexArray;
+}
+
+/// Advance the cache age, deleting vertex arrays that have not been used recently.
+///
+/// @see IDLE_TICK_COUNT_MAX
+void GLVertexArrayCache::Tick()
+{
+	++m_tickCount;
+	if( m_tickCount % VERTEX_ARRAY_EVICTION_INTERVAL == 0 )
+	{
+		EvictIdleEntries();
+	}
+}
+
+/// Delete all cached vertex arrays and release their description and buffer references.
+void GLVertexArrayCache::Clear()
+{
+	for( HashMap< uint64_t, Entry >::Iterator entryIterator = m_entries.Begin();
+		entryIterator != m_entries.End();
+		++entryIterator )
+	{
+		glDeleteVertexArrays( 1, &entryIterator->Second().vertexArray );
+	}
+
+	m_entries.Clear();
+}
+
+/// Delete vertex arrays that have not been used for IDLE_TICK_COUNT_MAX ticks.
+void GLVertexArrayCache::EvictIdleEntries()
+{
+	HELIUM_ASSERT( m_evictedKeys.IsEmpty() );
+
+	for( HashMap< uint64_t, Entry >::ConstIterator entryIterator = m_entries.Begin();
+		entryIterator != m_entries.End();
+		++entryIterator )
+	{
+		if( m_tickCount - entryIterator->Second().lastUsedTick >= IDLE_TICK_COUNT_MAX )
+		{
+			m_evictedKeys.Push( entryIterator->First() );
+		}
+	}
+
+	size_t evictedCount = m_evictedKeys.GetSize();
+	for( size_t keyIndex = 0; keyIndex < evictedCount; ++keyIndex )
+	{
+		HashMap< uint64_t, Entry >::Iterator entryIterator = m_entries.Find( m_evictedKeys[ keyIndex ] );
+		HELIUM_ASSERT( entryIterator != m_entries.End() );
+
+		glDeleteVertexArrays( 1, &entryIterator->Second().vertexArray );
+		m_entries.Remove( entryIterator );
+	}
+
+	m_evictedKeys.Resize( 0 );
+}
+
+/// Create and bind a vertex array object for the inputs of a given entry.
+///
+/// @param[in] rEntry  Entry describing the vertex description and buffers to use.
+///
+/// @return  Vertex array object, or zero if creation failed.
+GLuint GLVertexArrayCache::CreateVertexArray( const Entry& rEntry )
+{
+	const GLVertexDescription* pDescription = rEntry.spDescription;
+	HELIUM_ASSERT( pDescription );
+
+	GLuint vertexArray = 0;
+	glGenVertexArrays( 1, &vertexArray );
+	if( !vertexArray )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLVertexArrayCache: Failed to create vertex array object.\n" );
+
+		return 0;
+	}
+
+	glBindVertexArray( vertexArray );
+
+	for( size_t elementIndex = 0; elementIndex < pDescription->m_elementCount; ++elementIndex )
+	{
+		const GLVertexDescription::DescriptionElement& rElement = pDescription->m_pDescription[ elementIndex ];
+		uint32_t bufferIndex = rElement.bufferIndex;
+
+		const GLVertexBuffer* pBuffer = rEntry.spVertexBuffers[ bufferIndex ];
+		HELIUM_ASSERT( pBuffer );
+
+		size_t offset = rEntry.vertexOffsets[ bufferIndex ] + static_cast< size_t >( rElement.offset );
+
+		glBindBuffer( GL_ARRAY_BUFFER, pBuffer->GetGLBuffer() );
+		glEnableVertexAttribArray( rElement.location );
+		glVertexAttribPointer(
+			rElement.location,
+			rElement.size,
+			rElement.type,
+			rElement.isNormalized,
+			static_cast< GLsizei >( rEntry.strides[ bufferIndex ] ),
+			reinterpret_cast< const void* >( offset ) );
+
+		// Streams after the first advance once per instance.
+		glVertexAttribDivisor( rElement.location, ( bufferIndex != 0 ? 1 : 0 ) );
+	}
+
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+	const GLIndexBuffer* pIndexBuffer = rEntry.spIndexBuffer;
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, ( pIndexBuffer ? pIndexBuffer->GetGLBuffer() : 0 ) );
+
+	return vertexArray;
+}
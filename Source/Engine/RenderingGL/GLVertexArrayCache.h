@@ -0,0 +1,95 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "RenderingGL/GLVertexDescription.h"
+
+#include "Foundation/DynamicArray.h"
+#include "Foundation/HashMap.h"
+
+namespace Helium
+{
+	class GLVertexBuffer;
+	class GLIndexBuffer;
+
+	HELIUM_DECLARE_RPTR( GLVertexBuffer );
+	HELIUM_DECLARE_RPTR( GLIndexBuffer );
+
+	/// Cache of OpenGL vertex array objects for each vertex description and set of bound buffers.
+	///
+	/// A vertex array object is created the first time a vertex description is drawn with a given set of vertex buffers
+	/// (including their strides and offsets) and index buffer, so subsequent draws with the same inputs only need to
+	/// bind it instead of respecifying each vertex attribute.  Attributes sourced from vertex buffers other than the
+	/// first advance once per instance, matching the instancing convention of the other renderers.
+	///
+	/// Cached vertex arrays hold references to their description and buffers so that buffer objects cannot be deleted
+	/// and their names reused while a vertex array still references them.  Vertex arrays not used for
+	/// IDLE_TICK_COUNT_MAX calls to Tick() are deleted.
+	class GLVertexArrayCache
+	{
+	public:
+		/// Number of calls to Tick() after which an unused vertex array is deleted.
+		static const uint32_t IDLE_TICK_COUNT_MAX = 256;
+
+		/// Vertex buffer bound to a vertex stream.
+		struct Stream
+		{
+			/// Vertex buffer (null if unbound).
+			GLVertexBuffer* pBuffer;
+			/// Stride between vertices, in bytes.
+			uint32_t stride;
+			/// Offset of the first vertex, in bytes.
+			uint32_t offset;
+		};
+
+		/// @name Construction/Destruction
+		//@{
+		GLVertexArrayCache();
+		~GLVertexArrayCache();
+		//@}
+
+		/// @name Vertex Array Lookup
+		//@{
+		GLuint GetVertexArray( GLVertexDescription* pDescription, const Stream* pStreams, GLIndexBuffer* pIndexBuffer );
+		//@}
+
+		/// @name Cache Management
+		//@{
+		void Tick();
+		void Clear();
+		//@}
+
+	private:
+		/// Vertex array entry.
+		struct Entry
+		{
+			/// Vertex description.
+			GLVertexDescriptionPtr spDescription;
+			/// Vertex buffers bound to each stream used by the description.
+			GLVertexBufferPtr spVertexBuffers[ GLVertexDescription::BUFFER_COUNT_MAX ];
+			/// Byte offset within each vertex buffer object of the first vertex.
+			size_t vertexOffsets[ GLVertexDescription::BUFFER_COUNT_MAX ];
+			/// Stride of each vertex stream.
+			uint32_t strides[ GLVertexDescription::BUFFER_COUNT_MAX ];
+			/// Index buffer.
+			GLIndexBufferPtr spIndexBuffer;
+			/// Vertex array object.
+			GLuint vertexArray;
+			/// Tick count when the vertex array was last used.
+			uint32_t lastUsedTick;
+		};
+
+		/// Vertex arrays, keyed by a hash of their inputs.
+		HashMap< uint64_t, Entry > m_entries;
+		/// Scratch list of keys of entries being evicted.
+		DynamicArray< uint64_t > m_evictedKeys;
+		/// Number of calls to Tick().
+		uint32_t m_tickCount;
+
+		/// @name Private Utility Functions
+		//@{
+		void EvictIdleEntries();
+
+		static GLuint CreateVertexArray( const Entry& rEntry );
+		//@}
+	};
+}
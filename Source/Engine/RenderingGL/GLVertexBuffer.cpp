@@ -3,6 +3,9 @@
 #include "RenderingGL.h"
 #include "RenderingGL/GLVertexBuffer.h"
 
+#include "RenderingGL/GLStreamBuffer.h"
+#include "Engine/RenderStatistics.h"
+
 #include "GL/glew.h"
 
 using namespace Helium;
@@ -12,13 +15,37 @@ using namespace Helium;
 /// @param[in] vbo  OpenGL buffer object to wrap.  It will be deleted when this object is destroyed.
 GLVertexBuffer::GLVertexBuffer( unsigned vbo )
 : m_vbo( vbo )
+, m_pStreamBuffer( NULL )
+, m_offset( 0 )
 {
 	HELIUM_ASSERT( vbo != 0 );
 }
 
+/// Constructor.
+///
+/// @param[in] pStreamBuffer  Stream buffer holding the vertex data of a dynamic buffer, with a segment size matching
+///                           the buffer size.  It will be deleted when this object is destroyed.
+GLVertexBuffer::GLVertexBuffer( GLStreamBuffer* pStreamBuffer )
+: m_vbo( 0 )
+, m_pStreamBuffer( pStreamBuffer )
+, m_offset( 0 )
+{
+	HELIUM_ASSERT( pStreamBuffer );
+	m_vbo = pStreamBuffer->GetGLBuffer();
+	HELIUM_ASSERT( m_vbo != 0 );
+}
+
 /// Destructor.
 GLVertexBuffer::~GLVertexBuffer()
 {
+	if( m_pStreamBuffer )
+	{
+		// The stream buffer owns the buffer object.
+		delete m_pStreamBuffer;
+		m_pStreamBuffer = NULL;
+		m_vbo = 0;
+	}
+
 	if( m_vbo )
 	{
 		glDeleteBuffers( 1, &m_vbo );
@@ -37,6 +64,32 @@ void* GLVertexBuffer::Map( ERendererBufferMapHint hint )
 		return NULL;
 	}
 
+	// Dynamic buffers write discarded contents to the next stream buffer segment instead of waiting for the GPU.
+	if( m_pStreamBuffer )
+	{
+		size_t size = m_pStreamBuffer->GetSegmentSize();
+		void* pStreamData = NULL;
+		if( hint == RENDERER_BUFFER_MAP_HINT_DISCARD )
+		{
+			pStreamData = m_pStreamBuffer->Allocate( size, 1, m_offset );
+		}
+		else
+		{
+			pStreamData = m_pStreamBuffer->MapRange( m_offset, size );
+		}
+
+		if( !pStreamData )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "GLVertexBuffer::Map(): Failed to map OpenGL stream buffer.\n" );
+		}
+		else
+		{
+			RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, size );
+		}
+
+		return pStreamData;
+	}
+
 	// Determine usage hints for mapping the vertex buffer.
 	// "Discard" assumes only write operations, while "NO_OVERWRITE" assumes
 	// only read operations.
@@ -59,6 +112,8 @@ void* GLVertexBuffer::Map( ERendererBufferMapHint hint )
 		return NULL;
 	}
 
+	RenderStatistics::RecordUpload( RenderStatistics::COUNTER_BUFFER_BYTES, GetTrackedMemorySize() );
+
 	// Return a pointer to the mapped buffer data.
 	HELIUM_ASSERT( pData );
 	return pData;
@@ -75,6 +130,12 @@ void GLVertexBuffer::Unmap()
 		return;
 	}
 
+	if( m_pStreamBuffer )
+	{
+		m_pStreamBuffer->Unmap();
+		return;
+	}
+
 	// Unbind the buffer from client memory.
 	glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
 	GLboolean result = glUnmapBuffer( GL_ARRAY_BUFFER );
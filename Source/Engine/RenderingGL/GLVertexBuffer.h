@@ -6,13 +6,19 @@
 
 namespace Helium
 {
+	class GLStreamBuffer;
+
 	/// OpenGL vertex buffer implementation.
+	///
+	/// Dynamic vertex buffers are backed by a stream buffer, with each discarding Map() call writing to the next
+	/// segment, so the buffer can be refilled without waiting for draw calls using its previous contents.
 	class GLVertexBuffer : public RVertexBuffer
 	{
 	public:
 		/// @name Construction/Destruction
 		//@{
 		GLVertexBuffer( unsigned vbo );
+		GLVertexBuffer( GLStreamBuffer* pStreamBuffer );
 		//@}
 
 		/// @name Data Access
@@ -21,11 +27,16 @@ namespace Helium
 		virtual void Unmap() override;
 
 		inline unsigned GetGLBuffer() const;
+		inline size_t GetGLOffset() const;
 		//@}
 
 	protected:
 		/// Vertex buffer instance.
 		unsigned m_vbo;
+		/// Stream buffer holding the vertex data for dynamic buffers (null for static buffers).
+		GLStreamBuffer* m_pStreamBuffer;
+		/// Offset of the current vertex data within the buffer object.
+		size_t m_offset;
 
 		/// @name Construction/Destruction
 		//@{
@@ -7,4 +7,15 @@ namespace Helium
 	{
 		return m_vbo;
 	}
+
+	/// Get the offset of the current vertex data within the OpenGL vertex buffer.
+	///
+	/// This is always zero for static buffers, while dynamic buffers move to a new offset each time they are mapped
+	/// with RENDERER_BUFFER_MAP_HINT_DISCARD.
+	///
+	/// @return  Vertex data offset, in bytes.
+	size_t GLVertexBuffer::GetGLOffset() const
+	{
+		return m_offset;
+	}
 }
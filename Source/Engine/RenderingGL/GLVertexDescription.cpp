@@ -7,6 +7,7 @@ using namespace Helium;
 GLVertexDescription::GLVertexDescription()
 : m_pDescription( NULL )
 , m_elementCount( 0 )
+, m_bufferCount( 0 )
 {}
 
 /// Destructor.
@@ -18,6 +19,7 @@ GLVertexDescription::~GLVertexDescription()
 		m_pDescription = NULL;
 	}
 	m_elementCount = 0;
+	m_bufferCount = 0;
 }
 
 /// Initialize this state object.
@@ -37,7 +39,7 @@ bool GLVertexDescription::Initialize( const RVertexDescription::Element* pElemen
 
 	// Allocate memory for our vertex description array.
 	size_t descriptionArraySize = elementCount * sizeof( GLVertexDescription::DescriptionElement );
-	GLVertexDescription::DescriptionElement* pDescription = new DescriptionElement[ descriptionArraySize ];
+	GLVertexDescription::DescriptionElement* pDescription = new DescriptionElement[ elementCount ];
 	HELIUM_ASSERT( pDescription );
 	if( !pDescription )
 	{
@@ -51,18 +53,6 @@ bool GLVertexDescription::Initialize( const RVertexDescription::Element* pElemen
 	m_pDescription = pDescription;
 
 	// Define lookup tables.
-	static const GLchar* vertexAttribNames[ RENDERER_VERTEX_SEMANTIC_MAX ] =
-	{
-		"position",      // RENDERER_VERTEX_SEMANTIC_POSITION
-		"blendweight",   // RENDERER_VERTEX_SEMANTIC_BLENDWEIGHT
-		"blendindices",  // RENDERER_VERTEX_SEMANTIC_BLENDINDICES
-		"normal",        // RENDERER_VERTEX_SEMANTIC_NORMAL
-		"psize",         // RENDERER_VERTEX_SEMANTIC_PSIZE
-		"texcoord",      // RENDERER_VERTEX_SEMANTIC_TEXCOORD
-		"tangent",       // RENDERER_VERTEX_SEMANTIC_TANGENT
-		"binormal",      // RENDERER_VERTEX_SEMANTIC_BINORMAL
-		"color"          // RENDERER_VERTEX_SEMANTIC_COLOR
-	};
 	static const GLint vertexAttribSizes[ RENDERER_VERTEX_DATA_TYPE_MAX ][ 2 ] =
 	{
 		// { Count per vertex, size per element }
@@ -95,7 +85,7 @@ bool GLVertexDescription::Initialize( const RVertexDescription::Element* pElemen
 		GL_FALSE  // RENDERER_VERTEX_DATA_TYPE_FLOAT16_4
 	};
 
-	GLsizei stride = 0;
+	GLsizei bufferStrides[ BUFFER_COUNT_MAX ] = {};
 	for( size_t elementIndex = 0; elementIndex < elementCount; ++elementIndex )
 	{
 		const RVertexDescription::Element& rElement = pElements[ elementIndex ];
@@ -104,23 +94,120 @@ bool GLVertexDescription::Initialize( const RVertexDescription::Element* pElemen
 		// Range check arguments.
 		HELIUM_ASSERT( static_cast< size_t >( rElement.type ) < static_cast< size_t >( RENDERER_VERTEX_DATA_TYPE_MAX ) );
 		HELIUM_ASSERT( static_cast< size_t >( rElement.semantic ) < static_cast< size_t >( RENDERER_VERTEX_SEMANTIC_MAX ) );
+		HELIUM_ASSERT( rElement.bufferIndex < BUFFER_COUNT_MAX );
 		if( (static_cast< size_t >( rElement.type ) >= static_cast< size_t >( RENDERER_VERTEX_DATA_TYPE_MAX ) ) ||
-			(static_cast< size_t >( rElement.type ) >= static_cast< size_t >( RENDERER_VERTEX_DATA_TYPE_MAX ) ) )
+			(static_cast< size_t >( rElement.semantic ) >= static_cast< size_t >( RENDERER_VERTEX_SEMANTIC_MAX ) ) ||
+			rElement.bufferIndex >= BUFFER_COUNT_MAX )
+		{
+			return false;
+		}
+
+		GLint location = GetAttributeLocation( rElement.semantic, rElement.semanticIndex );
+		if( location < 0 )
 		{
+			HELIUM_TRACE(
+				TraceLevels::Error,
+				"GLVertexDescription::Initialize(): No vertex attribute location available for semantic %u, index %u.\n",
+				static_cast< unsigned int >( rElement.semantic ),
+				static_cast< unsigned int >( rElement.semanticIndex ) );
 			return false;
 		}
 
 		/// Internalize vertex attribute description.
-		rDescriptionElement.name = vertexAttribNames[ rElement.semantic ];
+		rDescriptionElement.location = static_cast< GLuint >( location );
+		rDescriptionElement.name = GetAttributeName( rDescriptionElement.location );
 		rDescriptionElement.size = vertexAttribSizes[ rElement.type ][ 0 ];
 		rDescriptionElement.type = vertexAttribTypes[ rElement.type ];
 		rDescriptionElement.isNormalized = vertexAttribNormalized[ rElement.type ];
+		rDescriptionElement.bufferIndex = rElement.bufferIndex;
 
-		// Calculate vertex attribute stride.
+		// Elements are packed in order within each vertex buffer.
 		const GLsizei attribSizeBytes = rDescriptionElement.size * vertexAttribSizes[ rElement.type ][ 1 ];
-		stride += attribSizeBytes;
-		rDescriptionElement.stride = stride;
+		rDescriptionElement.offset = bufferStrides[ rElement.bufferIndex ];
+		bufferStrides[ rElement.bufferIndex ] += attribSizeBytes;
+
+		m_bufferCount = Max< uint32_t >( m_bufferCount, rElement.bufferIndex + 1 );
+	}
+
+	// Store the total vertex size of each element's buffer as its stride.
+	for( size_t elementIndex = 0; elementIndex < elementCount; ++elementIndex )
+	{
+		GLVertexDescription::DescriptionElement& rDescriptionElement = pDescription[ elementIndex ];
+		rDescriptionElement.stride = bufferStrides[ rDescriptionElement.bufferIndex ];
 	}
 
 	return true;
 }
+
+/// Get the vertex attribute location assigned to a given vertex semantic.
+///
+/// Locations are assigned as follows: position (0), blend weights (1), blend indices (2), normal (3), tangent (4),
+/// binormal (5), color (6), point size (7), and texture coordinates 0 through 7 (8 through 15).
+///
+/// @param[in] semantic       Vertex semantic.
+/// @param[in] semanticIndex  Semantic index.
+///
+/// @return  Vertex attribute location, or -1 if no location is assigned to the given semantic and index.
+///
+/// @see GetAttributeName()
+GLint GLVertexDescription::GetAttributeLocation( ERendererVertexSemantic semantic, uint32_t semanticIndex )
+{
+	static const GLint semanticLocations[ RENDERER_VERTEX_SEMANTIC_MAX ] =
+	{
+		0,  // RENDERER_VERTEX_SEMANTIC_POSITION
+		1,  // RENDERER_VERTEX_SEMANTIC_BLENDWEIGHT
+		2,  // RENDERER_VERTEX_SEMANTIC_BLENDINDICES
+		3,  // RENDERER_VERTEX_SEMANTIC_NORMAL
+		7,  // RENDERER_VERTEX_SEMANTIC_PSIZE
+		8,  // RENDERER_VERTEX_SEMANTIC_TEXCOORD
+		4,  // RENDERER_VERTEX_SEMANTIC_TANGENT
+		5,  // RENDERER_VERTEX_SEMANTIC_BINORMAL
+		6   // RENDERER_VERTEX_SEMANTIC_COLOR
+	};
+
+	if( static_cast< size_t >( semantic ) >= static_cast< size_t >( RENDERER_VERTEX_SEMANTIC_MAX ) )
+	{
+		return -1;
+	}
+
+	// Only texture coordinates support more than one semantic index.
+	const uint32_t texcoordCount = ATTRIBUTE_LOCATION_COUNT - semanticLocations[ RENDERER_VERTEX_SEMANTIC_TEXCOORD ];
+	if( semanticIndex >= ( semantic == RENDERER_VERTEX_SEMANTIC_TEXCOORD ? texcoordCount : 1 ) )
+	{
+		return -1;
+	}
+
+	return semanticLocations[ semantic ] + static_cast< GLint >( semanticIndex );
+}
+
+/// Get the name of the vertex shader input bound to a given vertex attribute location.
+///
+/// @param[in] location  Vertex attribute location.
+///
+/// @return  Vertex shader input name, or null if the location is out of range.
+///
+/// @see GetAttributeLocation()
+const GLchar* GLVertexDescription::GetAttributeName( GLuint location )
+{
+	static const GLchar* attributeNames[ ATTRIBUTE_LOCATION_COUNT ] =
+	{
+		"position",
+		"blendweight",
+		"blendindices",
+		"normal",
+		"tangent",
+		"binormal",
+		"color",
+		"psize",
+		"texcoord0",
+		"texcoord1",
+		"texcoord2",
+		"texcoord3",
+		"texcoord4",
+		"texcoord5",
+		"texcoord6",
+		"texcoord7"
+	};
+
+	return ( location < ATTRIBUTE_LOCATION_COUNT ? attributeNames[ location ] : NULL );
+}
@@ -8,9 +8,18 @@
 namespace Helium
 {
 	/// OpenGL vertex description.
+	///
+	/// Each element is assigned a fixed vertex attribute location based on its semantic and semantic index (see
+	/// GetAttributeLocation()).  Linked programs bind their vertex inputs to the same locations by name (see
+	/// GetAttributeName()), so any vertex description can be used with any program without per-pair lookups.
 	class GLVertexDescription : public RVertexDescription
 	{
 	public:
+		/// Maximum number of vertex buffers from which a description can source its elements.
+		static const uint32_t BUFFER_COUNT_MAX = 4;
+		/// Number of vertex attribute locations assigned to vertex semantics.
+		static const uint32_t ATTRIBUTE_LOCATION_COUNT = 16;
+
 		/// @name Construction/Destruction
 		//@{
 		GLVertexDescription();
@@ -28,6 +37,12 @@ namespace Helium
 			GLboolean isNormalized;
 			/// Vertex attribute stride
 			GLsizei stride;
+			/// Vertex attribute location.
+			GLuint location;
+			/// Offset of the attribute within each vertex of its buffer, in bytes.
+			GLsizei offset;
+			/// Index of the vertex buffer from which the attribute is read.
+			uint32_t bufferIndex;
 
 			/// @name Construction/Destruction
 			//@{
@@ -39,12 +54,20 @@ namespace Helium
 		DescriptionElement* m_pDescription;
 		/// Number of elements in description.
 		size_t m_elementCount;
+		/// Number of vertex buffers used by the description (highest buffer index plus one).
+		uint32_t m_bufferCount;
 
 		/// @name Initialization
 		//@{
 		bool Initialize( const RVertexDescription::Element* pElements, size_t elementCount );
 		//@}
 
+		/// @name Static Utility Functions
+		//@{
+		static GLint GetAttributeLocation( ERendererVertexSemantic semantic, uint32_t semanticIndex );
+		static const GLchar* GetAttributeName( GLuint location );
+		//@}
+
 	private:
 
 		/// @name Construction/Destruction
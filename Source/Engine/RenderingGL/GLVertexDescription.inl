@@ -7,5 +7,8 @@ namespace Helium
 	, type( GL_NONE )
 	, isNormalized( GL_FALSE )
 	, stride( 0 )
+	, location( 0 )
+	, offset( 0 )
+	, bufferIndex( 0 )
 	{}
 }
@@ -0,0 +1,20 @@
+#include "Precompile.h"
+#include "RenderingGL/GLVertexInputLayout.h"
+
+#include "RenderingGL/GLVertexDescription.h"
+
+using namespace Helium;
+
+/// Constructor.
+///
+/// @param[in] pDescription  Vertex description for the layout.
+GLVertexInputLayout::GLVertexInputLayout( GLVertexDescription* pDescription )
+: m_spDescription( pDescription )
+{
+	HELIUM_ASSERT( pDescription );
+}
+
+/// Destructor.
+GLVertexInputLayout::~GLVertexInputLayout()
+{
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Rendering/RVertexInputLayout.h"
+
+namespace Helium
+{
+	class GLVertexDescription;
+
+	HELIUM_DECLARE_RPTR( GLVertexDescription );
+
+	/// OpenGL vertex input layout implementation.
+	///
+	/// Vertex attribute locations are fixed for each vertex semantic, so the layout does not depend on the vertex
+	/// shader and only references the vertex description.  Vertex array objects for each layout and set of bound buffers
+	/// are created and cached by the immediate command proxy.
+	class GLVertexInputLayout : public RVertexInputLayout
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		GLVertexInputLayout( GLVertexDescription* pDescription );
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline GLVertexDescription* GetDescription() const;
+		//@}
+
+	private:
+		/// Vertex description.
+		GLVertexDescriptionPtr m_spDescription;
+
+		/// @name Construction/Destruction
+		//@{
+		~GLVertexInputLayout();
+		//@}
+	};
+}
+
+#include "RenderingGL/GLVertexInputLayout.inl"
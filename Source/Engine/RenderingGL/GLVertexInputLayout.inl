@@ -0,0 +1,10 @@
+namespace Helium
+{
+	/// Get the vertex description.
+	///
+	/// @return  Vertex description.
+	GLVertexDescription* GLVertexInputLayout::GetDescription() const
+	{
+		return m_spDescription;
+	}
+}
@@ -0,0 +1,76 @@
+#include "Precompile.h"
+#include "RenderingGL/GLVertexShader.h"
+
+#include "RenderingGL/GLRenderer.h"
+
+using namespace Helium;
+
+/// Constructor.
+///
+/// @param[in] shader  OpenGL vertex shader object to wrap.  The shader object is deleted when this object is destroyed.
+GLVertexShader::GLVertexShader( GLuint shader )
+: m_shader( shader )
+, m_pStagingData( NULL )
+, m_stagingSize( 0 )
+{
+	HELIUM_ASSERT( shader != 0 );
+}
+
+/// Constructor.
+///
+/// @param[in] pStagingData  Staging buffer for loading the shader source, allocated using DefaultAllocator.  This
+///                          object takes ownership of the buffer.
+/// @param[in] stagingSize   Size of the staging buffer, in bytes.
+GLVertexShader::GLVertexShader( void* pStagingData, size_t stagingSize )
+: m_shader( 0 )
+, m_pStagingData( pStagingData )
+, m_stagingSize( stagingSize )
+{
+	HELIUM_ASSERT( pStagingData );
+}
+
+/// Destructor.
+GLVertexShader::~GLVertexShader()
+{
+	if( m_pStagingData )
+	{
+		DefaultAllocator().Free( m_pStagingData );
+	}
+
+	if( m_shader )
+	{
+		glDeleteShader( m_shader );
+	}
+}
+
+/// @copydoc RShader::Lock()
+void* GLVertexShader::Lock()
+{
+	if( !m_pStagingData )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLVertexShader::Lock(): Vertex shader has already been loaded.\n" );
+
+		return NULL;
+	}
+
+	return m_pStagingData;
+}
+
+/// @copydoc RShader::Unlock()
+bool GLVertexShader::Unlock()
+{
+	if( !m_pStagingData )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "GLVertexShader::Unlock(): Vertex shader has already been loaded.\n" );
+
+		return false;
+	}
+
+	m_shader = GLRenderer::CompileShader( GL_VERTEX_SHADER, m_pStagingData, m_stagingSize );
+
+	DefaultAllocator().Free( m_pStagingData );
+	m_pStagingData = NULL;
+	m_stagingSize = 0;
+
+	return ( m_shader != 0 );
+}
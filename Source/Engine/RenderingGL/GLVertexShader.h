@@ -0,0 +1,49 @@
+#pragma once
+
+#include "RenderingGL/RenderingGL.h"
+#include "Rendering/RVertexShader.h"
+
+#include "GL/glew.h"
+
+namespace Helium
+{
+	/// OpenGL vertex shader implementation.
+	///
+	/// Shader data is GLSL source text.  Shaders created without data are loaded through a staging buffer that is
+	/// compiled when unlocked.
+	class GLVertexShader : public RVertexShader
+	{
+	public:
+		/// @name Construction/Destruction
+		//@{
+		GLVertexShader( GLuint shader );
+		GLVertexShader( void* pStagingData, size_t stagingSize );
+		//@}
+
+		/// @name Loading
+		//@{
+		void* Lock();
+		bool Unlock();
+		//@}
+
+		/// @name Data Access
+		//@{
+		inline GLuint GetGLShader() const;
+		//@}
+
+	private:
+		/// OpenGL shader object (zero if not yet loaded).
+		GLuint m_shader;
+		/// Staging buffer for loading the shader source (null once loaded).
+		void* m_pStagingData;
+		/// Size of the staging buffer, in bytes.
+		size_t m_stagingSize;
+
+		/// @name Construction/Destruction
+		//@{
+		~GLVertexShader();
+		//@}
+	};
+}
+
+#include "RenderingGL/GLVertexShader.inl"
@@ -0,0 +1,10 @@
+namespace Helium
+{
+	/// Get the OpenGL shader object.
+	///
+	/// @return  OpenGL shader object, or zero if the shader has not been loaded.
+	GLuint GLVertexShader::GetGLShader() const
+	{
+		return m_shader;
+	}
+}
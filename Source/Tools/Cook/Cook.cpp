@@ -0,0 +1,372 @@
+#include "Platform/Timer.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+#include "Foundation/Log.h"
+
+#include "Reflect/Registry.h"
+#include "Persist/Archive.h"
+
+#include "Engine/Asset.h"
+#include "Engine/AssetLoader.h"
+#include "Engine/AsyncLoader.h"
+#include "Engine/CacheManager.h"
+#include "Engine/Config.h"
+#include "Engine/FileLocations.h"
+#include "Engine/PackageLoader.h"
+
+#include "EngineJobs/EngineJobs.h"
+#include "EngineJobs/JobManager.h"
+
+#include "GraphicsJobs/GraphicsJobs.h"
+
+#include "PcSupport/AssetPreprocessor.h"
+#include "PcSupport/LooseAssetLoader.h"
+
+#include "PreprocessingPc/PcPreprocessor.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Helium;
+
+/// Headless batch cook.
+///
+/// Loads every package of a project (or only the packages given on the command line, and their sub-packages) through
+/// the loose asset loader without a window or a renderer.  Each package is cooked as one AssetPreprocessor cook batch,
+/// so its resources are preprocessed in parallel on the job workers and its cache entries are written with a single
+/// table of contents update per cache.
+///
+///     HeliumCook <project directory> [-report <file>] [-shared <directory>] [package paths...]
+///
+/// The cook report is written as one JSON object per line: one per resource with the time spent preprocessing it, and
+/// one per package with the time spent loading and cooking it.  The exit code is zero only if every asset loaded and
+/// every resource cooked successfully.
+
+/// Command line settings.
+struct CookParameters
+{
+	/// Project base directory.
+	const char* pProjectDirectory;
+	/// Cook report file (null for no report).
+	const char* pReportFile;
+	/// Shared cook cache directory (null for none).
+	const char* pSharedDirectory;
+	/// Packages to cook (all root packages if empty).
+	DynamicArray< AssetPath > packagePaths;
+};
+
+/// Parse the command line.
+///
+/// @param[in]  argc         Argument count.
+/// @param[in]  argv         Arguments.
+/// @param[out] rParameters  Cook settings.
+///
+/// @return  True if the command line was valid, false if not.
+static bool ParseCommandLine( int argc, const char* const* argv, CookParameters& rParameters )
+{
+	rParameters.pProjectDirectory = NULL;
+	rParameters.pReportFile = NULL;
+	rParameters.pSharedDirectory = NULL;
+
+	for( int argumentIndex = 1; argumentIndex < argc; ++argumentIndex )
+	{
+		const char* pArgument = argv[ argumentIndex ];
+		const char* pValue = ( argumentIndex + 1 < argc ? argv[ argumentIndex + 1 ] : NULL );
+
+		if( CaseInsensitiveCompareString( pArgument, "-report" ) == 0 && pValue )
+		{
+			rParameters.pReportFile = pValue;
+			++argumentIndex;
+		}
+		else if( CaseInsensitiveCompareString( pArgument, "-shared" ) == 0 && pValue )
+		{
+			rParameters.pSharedDirectory = pValue;
+			++argumentIndex;
+		}
+		else if( !rParameters.pProjectDirectory )
+		{
+			rParameters.pProjectDirectory = pArgument;
+		}
+		else
+		{
+			AssetPath packagePath;
+			if( !packagePath.Set( pArgument ) || !packagePath.IsPackage() )
+			{
+				HELIUM_TRACE( TraceLevels::Error, "HeliumCook: \"%s\" is not a package path.\n", pArgument );
+				return false;
+			}
+
+			rParameters.packagePaths.Push( packagePath );
+		}
+	}
+
+	return rParameters.pProjectDirectory != NULL;
+}
+
+/// Load a package and cook every asset in it as one batch.
+///
+/// @param[in]     packagePath  Package to cook.
+/// @param[in,out] rPackages    Queue of packages to cook, to which sub-packages are appended.
+/// @param[in]     pReport      Cook report file (may be null).
+///
+/// @return  True if the package and every asset in it loaded and cooked successfully, false if not.
+static bool CookPackage( const AssetPath& packagePath, DynamicArray< AssetPath >& rPackages, FILE* pReport )
+{
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+	AssetPreprocessor* pAssetPreprocessor = AssetPreprocessor::GetInstance();
+	HELIUM_ASSERT( pAssetPreprocessor );
+
+	uint64_t startTicks = Timer::GetTickCount();
+
+	AssetPtr spPackageAsset;
+	Package* pPackage = NULL;
+	if( pAssetLoader->LoadObject( packagePath, spPackageAsset ) )
+	{
+		pPackage = Reflect::SafeCast< Package >( spPackageAsset.Get() );
+	}
+
+	if( !pPackage || !pPackage->GetLoader() )
+	{
+		HELIUM_TRACE( TraceLevels::Error, "HeliumCook: Failed to load package \"%s\".\n", *packagePath.ToString() );
+		return false;
+	}
+
+	DynamicArray< AssetPath > childPaths;
+	pPackage->GetLoader()->EnumerateChildren( childPaths );
+
+	DynamicArray< AssetPath > assetPaths;
+	DynamicArray< size_t > loadIds;
+	size_t childCount = childPaths.GetSize();
+	for( size_t childIndex = 0; childIndex < childCount; ++childIndex )
+	{
+		const AssetPath& rChildPath = childPaths[ childIndex ];
+		if( rChildPath.IsPackage() )
+		{
+			rPackages.Push( rChildPath );
+		}
+		else
+		{
+			assetPaths.Push( rChildPath );
+		}
+	}
+
+	bool bSuccess = true;
+	size_t assetCount = assetPaths.GetSize();
+
+	// Issue every load of the package up front, then tick the loader until they all finish, queuing preprocessing and
+	// caching for the batch.
+	DynamicArray< AssetPreprocessor::CookRecord > records;
+	pAssetPreprocessor->SetCookRecords( &records );
+	pAssetPreprocessor->BeginCookBatch();
+
+	loadIds.Reserve( assetCount );
+	for( size_t assetIndex = 0; assetIndex < assetCount; ++assetIndex )
+	{
+		loadIds.Push( pAssetLoader->BeginLoadObject( assetPaths[ assetIndex ] ) );
+	}
+
+	DynamicArray< AssetPtr > assets;
+	assets.Resize( assetCount );
+
+	size_t pendingCount = assetCount;
+	while( pendingCount != 0 )
+	{
+		pAssetLoader->Tick();
+
+		for( size_t assetIndex = 0; assetIndex < assetCount; ++assetIndex )
+		{
+			if( !IsValid( loadIds[ assetIndex ] ) )
+			{
+				continue;
+			}
+
+			if( pAssetLoader->TryFinishLoad( loadIds[ assetIndex ], assets[ assetIndex ] ) )
+			{
+				SetInvalid( loadIds[ assetIndex ] );
+				--pendingCount;
+
+				if( !assets[ assetIndex ] || assets[ assetIndex ]->GetAnyFlagSet( Asset::FLAG_BROKEN ) )
+				{
+					HELIUM_TRACE(
+						TraceLevels::Error,
+						"HeliumCook: Failed to load asset \"%s\".\n",
+						*assetPaths[ assetIndex ].ToString() );
+
+					bSuccess = false;
+				}
+			}
+		}
+	}
+
+	if( !pAssetPreprocessor->EndCookBatch() )
+	{
+		bSuccess = false;
+	}
+
+	pAssetPreprocessor->SetCookRecords( NULL );
+
+	float64_t milliseconds = Timer::TicksToMilliseconds( Timer::GetTickCount() - startTicks );
+
+	HELIUM_TRACE(
+		TraceLevels::Info,
+		"HeliumCook: Cooked package \"%s\" (%" PRIuSZ " assets, %" PRIuSZ " resources) in %.1f ms.\n",
+		*packagePath.ToString(),
+		assetCount,
+		records.GetSize(),
+		milliseconds );
+
+	if( pReport )
+	{
+		size_t recordCount = records.GetSize();
+		for( size_t recordIndex = 0; recordIndex < recordCount; ++recordIndex )
+		{
+			const AssetPreprocessor::CookRecord& rRecord = records[ recordIndex ];
+			fprintf(
+				pReport,
+				"{\"resource\":\"%s\",\"ms\":%.3f,\"fetched\":%s,\"success\":%s}\n",
+				*rRecord.path.ToString(),
+				rRecord.milliseconds,
+				rRecord.bFetched ? "true" : "false",
+				rRecord.bSuccess ? "true" : "false" );
+		}
+
+		fprintf(
+			pReport,
+			"{\"package\":\"%s\",\"assets\":%" PRIuSZ ",\"resources\":%" PRIuSZ ",\"ms\":%.3f,\"success\":%s}\n",
+			*packagePath.ToString(),
+			assetCount,
+			recordCount,
+			milliseconds,
+			bSuccess ? "true" : "false" );
+	}
+
+	return bSuccess;
+}
+
+int main( int argc, const char* argv[] )
+{
+	CookParameters parameters;
+	if( !ParseCommandLine( argc, argv, parameters ) )
+	{
+		fprintf( stderr, "Usage: HeliumCook <project directory> [-report <file>] [-shared <directory>] [package paths...]\n" );
+		return 2;
+	}
+
+	FilePath projectDirectory( parameters.pProjectDirectory );
+	if( !projectDirectory.Exists() )
+	{
+		fprintf( stderr, "HeliumCook: Project directory \"%s\" does not exist.\n", parameters.pProjectDirectory );
+		return 2;
+	}
+
+	FileLocations::SetBaseDirectory( projectDirectory );
+
+	// Make sure various module-specific heaps are initialized from the main thread before use.
+	InitEngineJobsDefaultHeap();
+	InitGraphicsJobsDefaultHeap();
+
+	JobManager::Startup();
+	AsyncLoader::Startup();
+	CacheManager::Startup();
+	Reflect::Startup();
+	Persist::Startup();
+	LooseAssetLoader::Startup();
+	AssetPreprocessor::Startup();
+
+	AssetPreprocessor* pAssetPreprocessor = AssetPreprocessor::GetInstance();
+	HELIUM_ASSERT( pAssetPreprocessor );
+	pAssetPreprocessor->SetPlatformPreprocessor( Cache::PLATFORM_PC, new PcPreprocessor );
+
+	if( parameters.pSharedDirectory )
+	{
+		pAssetPreprocessor->SetSharedCookCacheDirectory( FilePath( parameters.pSharedDirectory ) );
+	}
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+	HELIUM_ASSERT( pAssetLoader );
+
+	// Preprocess concurrent resource handlers and deserialize packages across the job workers.
+	pAssetLoader->SetParallelFor( JobManager::ParallelFor );
+
+	Config::Startup();
+	Config* pConfig = Config::GetInstance();
+	HELIUM_ASSERT( pConfig );
+
+	pConfig->BeginLoad();
+	while( !pConfig->TryFinishLoad() )
+	{
+		pAssetLoader->Tick();
+	}
+
+	FILE* pReport = NULL;
+	if( parameters.pReportFile )
+	{
+		pReport = fopen( parameters.pReportFile, "w" );
+		if( !pReport )
+		{
+			HELIUM_TRACE( TraceLevels::Error, "HeliumCook: Could not open report file \"%s\".\n", parameters.pReportFile );
+		}
+	}
+
+	DynamicArray< AssetPath > packages( parameters.packagePaths );
+	if( packages.IsEmpty() )
+	{
+		pAssetLoader->EnumerateRootPackages( packages );
+	}
+
+	uint64_t startTicks = Timer::GetTickCount();
+	bool bSuccess = true;
+	size_t failedPackageCount = 0;
+
+	// Sub-packages are appended to the queue as their parents are cooked.
+	for( size_t packageIndex = 0; packageIndex < packages.GetSize(); ++packageIndex )
+	{
+		AssetPath packagePath = packages[ packageIndex ];
+		if( !CookPackage( packagePath, packages, pReport ) )
+		{
+			bSuccess = false;
+			++failedPackageCount;
+		}
+	}
+
+	pAssetPreprocessor->FlushPrefetchManifests();
+
+	float64_t milliseconds = Timer::TicksToMilliseconds( Timer::GetTickCount() - startTicks );
+
+	HELIUM_TRACE(
+		bSuccess ? TraceLevels::Info : TraceLevels::Error,
+		"HeliumCook: Cooked %" PRIuSZ " packages (%" PRIuSZ " failed) in %.1f ms.\n",
+		packages.GetSize(),
+		failedPackageCount,
+		milliseconds );
+
+	if( pReport )
+	{
+		fprintf(
+			pReport,
+			"{\"packages\":%" PRIuSZ ",\"failed\":%" PRIuSZ ",\"ms\":%.3f,\"success\":%s}\n",
+			packages.GetSize(),
+			failedPackageCount,
+			milliseconds,
+			bSuccess ? "true" : "false" );
+
+		fclose( pReport );
+	}
+
+	Config::Shutdown();
+	AssetPreprocessor::Shutdown();
+	LooseAssetLoader::Shutdown();
+	CacheManager::Shutdown();
+	Persist::Shutdown();
+	Reflect::Shutdown();
+	AssetType::Shutdown();
+	Asset::Shutdown();
+	AsyncLoader::Shutdown();
+	JobManager::Shutdown();
+	AssetPath::Shutdown();
+	Name::Shutdown();
+	FileLocations::Shutdown();
+
+	return bSuccess ? 0 : 1;
+}
@@ -23,10 +23,13 @@
 #include "EditorSupport/Precompile.h"
 #include "EditorSupport/FontResourceHandler.h"
 
+#include "PcSupport/LoosePackageLoader.h"
+
 #include "EditorScene/EditorSceneInit.h"
 #include "EditorScene/SettingsManager.h"
 
 #include "Editor/ArtProvider.h"
+#include "Editor/EditorEngine.h"
 #include "Editor/Input.h"
 #include "Editor/EditorGeneratedWrapper.h"
 #include "Editor/Perforce/Perforce.h"
@@ -73,6 +76,7 @@ using namespace Helium::CommandLine;
 
 bool g_HelpFlag = false;
 bool g_DisableTracker = false;
+bool g_BinarySidecars = false;
 
 namespace Helium
 {
@@ -219,6 +223,32 @@ int App::OnExit()
 	return result;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Called for every event before it is processed.  User input, resizing and
+// activation can all change what the viewports show, so the engine is asked
+// to tick for them (it otherwise stays idle).
+// 
+int App::FilterEvent( wxEvent& event )
+{
+	EditorEngine* pEngine = EditorEngine::GetInstance();
+	if ( pEngine )
+	{
+		wxEventType type = event.GetEventType();
+		if ( event.IsKindOf( CLASSINFO( wxMouseEvent ) ) ||
+			type == wxEVT_KEY_DOWN ||
+			type == wxEVT_KEY_UP ||
+			type == wxEVT_CHAR ||
+			type == wxEVT_SIZE ||
+			type == wxEVT_ACTIVATE ||
+			type == wxEVT_ACTIVATE_APP )
+		{
+			pEngine->RequestTick();
+		}
+	}
+
+	return -1;
+}
+
 void App::OnChar( wxKeyEvent& event )
 {
 	// It seems like this is swallowing all events to all text fields.. disabling for now
@@ -509,6 +539,7 @@ int Main( int argc, const char** argv )
 
 	success &= processor.AddOption( new FlagOption( &g_HelpFlag, "h|help", "print program usage" ), error );
 	success &= processor.AddOption( new FlagOption( &g_DisableTracker, "disable_tracker", "disable Asset Tracker" ), error );
+	success &= processor.AddOption( new FlagOption( &g_BinarySidecars, "binary_sidecars", "write and read binary sidecars of loose asset files" ), error );
 	success &= processor.ParseOptions( argsBegin, argsEnd, error );
 
 	if ( success )
@@ -555,6 +586,8 @@ int Main( int argc, const char** argv )
 		}
 		else
 		{
+			LoosePackageLoader::SetBinarySidecarsEnabled( g_BinarySidecars );
+
 #if HELIUM_OS_WIN
 			HELIUM_CONVERT_TO_CHAR( ::GetCommandLineW(), convertedCmdLine );
 			return wxEntry( ::GetModuleHandle(NULL), NULL, convertedCmdLine, SW_SHOWNORMAL );
@@ -26,6 +26,7 @@ namespace Helium
 			virtual bool OnInit() override;
 			virtual int OnRun() override;
 			virtual int OnExit() override;
+			virtual int FilterEvent( wxEvent& event ) override;
 
 			void OnChar( wxKeyEvent& event );
 #ifdef IDLE_LOOP
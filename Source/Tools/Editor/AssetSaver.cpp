@@ -0,0 +1,293 @@
+#include "Precompile.h"
+#include "AssetSaver.h"
+
+#include "Platform/Thread.h"
+#include "Foundation/FileStream.h"
+
+using namespace Helium;
+using namespace Helium::Editor;
+
+// Upper bound on the number of saving threads, writing more files at once than this doesn't get any faster
+static const uint32_t s_MaxSaveThreads = 4;
+
+void* AssetSaver::SaveThread::Entry()
+{
+	while ( true )
+	{
+		m_Saver.m_Signal.Decrement();
+
+		if ( m_Saver.m_Quit )
+		{
+			break;
+		}
+
+		Item* item = NULL;
+		bool serialize = false;
+
+		{
+			MutexScopeLock mutex( m_Saver.m_Mutex );
+
+			if ( !m_Saver.m_SerializeQueue.empty() )
+			{
+				item = m_Saver.m_SerializeQueue.front();
+				m_Saver.m_SerializeQueue.pop_front();
+				serialize = true;
+			}
+			else if ( !m_Saver.m_WriteQueue.empty() )
+			{
+				item = m_Saver.m_WriteQueue.front();
+				m_Saver.m_WriteQueue.pop_front();
+			}
+		}
+
+		HELIUM_ASSERT( item );
+		if ( !item )
+		{
+			continue;
+		}
+
+		if ( serialize )
+		{
+			Serialize( *item );
+		}
+		else
+		{
+			Write( *item );
+		}
+
+		MutexScopeLock mutex( m_Saver.m_Mutex );
+		item->m_Done = true;
+
+		if ( serialize )
+		{
+			++m_Saver.m_SerializedCount;
+		}
+	}
+
+	return NULL;
+}
+
+AssetSaver::AssetSaver()
+	: m_SerializedCount( 0 )
+	, m_Quit( false )
+{
+	// these threads mostly wait on the disk, but leave a core for the UI thread while serializing
+	int cpuCount = wxThread::GetCPUCount();
+	uint32_t threadCount = cpuCount > 2 ? static_cast< uint32_t >( cpuCount - 1 ) : 1;
+	if ( threadCount > s_MaxSaveThreads )
+	{
+		threadCount = s_MaxSaveThreads;
+	}
+
+	for ( uint32_t i = 0; i < threadCount; ++i )
+	{
+		SaveThread* thread = new SaveThread( *this );
+		if ( thread->Create() != wxTHREAD_NO_ERROR || thread->Run() != wxTHREAD_NO_ERROR )
+		{
+			delete thread;
+			break;
+		}
+
+		m_SaveThreads.push_back( thread );
+	}
+
+	HELIUM_ASSERT( !m_SaveThreads.empty() );
+}
+
+AssetSaver::~AssetSaver()
+{
+	// don't lose the files of a save that's still being written
+	Flush();
+
+	m_Quit = true;
+
+	for ( std::vector< SaveThread* >::const_iterator itr = m_SaveThreads.begin(), end = m_SaveThreads.end();
+		itr != end;
+		++itr )
+	{
+		m_Signal.Increment();
+	}
+
+	for ( std::vector< SaveThread* >::const_iterator itr = m_SaveThreads.begin(), end = m_SaveThreads.end();
+		itr != end;
+		++itr )
+	{
+		(*itr)->Wait();
+		delete *itr;
+	}
+
+	m_SaveThreads.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Begins saving the given assets.  They must not be changed until
+//  IsSerializing() returns false.  Only one save can serialize at a time,
+//  returns false if another save is still serializing.
+//
+bool AssetSaver::Save( const std::vector< AssetPtr >& assets )
+{
+	if ( IsSerializing() )
+	{
+		return false;
+	}
+
+	for ( std::vector< AssetPtr >::const_iterator itr = assets.begin(), end = assets.end(); itr != end; ++itr )
+	{
+		Asset* asset = *itr;
+		Package* package = asset ? asset->GetOwningPackage() : NULL;
+		PackageLoader* loader = package ? package->GetLoader() : NULL;
+		if ( !loader )
+		{
+			m_Errors += "Could not save " + std::string( asset ? *asset->GetPath().ToString() : "(null)" ) + ", it does not belong to a package that can be saved.\n";
+			continue;
+		}
+
+		Item* item = new Item;
+		item->m_Asset = asset;
+		item->m_Loader = loader;
+		item->m_Done = false;
+		item->m_Failed = false;
+		m_Serializing.push_back( item );
+	}
+
+	MutexScopeLock mutex( m_Mutex );
+
+	m_SerializedCount = 0;
+
+	for ( std::vector< Item* >::const_iterator itr = m_Serializing.begin(), end = m_Serializing.end(); itr != end; ++itr )
+	{
+		m_SerializeQueue.push_back( *itr );
+		m_Signal.Increment();
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Moves a save on to writing once all of its assets are serialized, and
+//  releases the items that have been written.
+//
+void AssetSaver::Update()
+{
+	MutexScopeLock mutex( m_Mutex );
+
+	if ( !m_Serializing.empty() && m_SerializedCount == m_Serializing.size() )
+	{
+		for ( std::vector< Item* >::const_iterator itr = m_Serializing.begin(), end = m_Serializing.end(); itr != end; ++itr )
+		{
+			Item* item = *itr;
+			if ( item->m_Failed )
+			{
+				m_Errors += "Could not serialize " + std::string( *item->m_Asset->GetPath().ToString() ) + ".\n";
+				delete item;
+				continue;
+			}
+
+			// the file contents are a snapshot of the asset now, so it can be changed again while they're written
+			item->m_Asset->ClearFlags( Asset::FLAG_CHANGED_SINCE_LOADED );
+			item->m_Asset.Release();
+
+			item->m_Done = false;
+			m_Writing.push_back( item );
+			m_WriteQueue.push_back( item );
+			m_Signal.Increment();
+		}
+
+		m_Serializing.clear();
+		m_SerializedCount = 0;
+	}
+
+	std::vector< Item* >::iterator writeEnd = m_Writing.begin();
+	for ( std::vector< Item* >::iterator itr = m_Writing.begin(), end = m_Writing.end(); itr != end; ++itr )
+	{
+		Item* item = *itr;
+		if ( !item->m_Done )
+		{
+			*writeEnd++ = item;
+			continue;
+		}
+
+		if ( item->m_Failed )
+		{
+			m_Errors += "Could not write " + item->m_Path.Get() + ".\n";
+		}
+
+		delete item;
+	}
+
+	m_Writing.erase( writeEnd, m_Writing.end() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Waits until all the saves have been written.
+//
+void AssetSaver::Flush()
+{
+	Update();
+
+	while ( IsSerializing() || IsWriting() )
+	{
+		Thread::Sleep( 1 );
+		Update();
+	}
+}
+
+bool AssetSaver::IsSerializing() const
+{
+	return !m_Serializing.empty();
+}
+
+bool AssetSaver::IsWriting() const
+{
+	return !m_Writing.empty();
+}
+
+void AssetSaver::GetSerializeProgress( uint32_t& serialized, uint32_t& total ) const
+{
+	MutexScopeLock mutex( m_Mutex );
+	serialized = m_SerializedCount;
+	total = static_cast< uint32_t >( m_Serializing.size() );
+}
+
+uint32_t AssetSaver::GetWriteCount() const
+{
+	return static_cast< uint32_t >( m_Writing.size() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Gets the errors of the saves since the last call, returns false if there
+//  were none.
+//
+bool AssetSaver::TakeErrors( std::string& errors )
+{
+	if ( m_Errors.empty() )
+	{
+		return false;
+	}
+
+	errors += m_Errors;
+	m_Errors.clear();
+	return true;
+}
+
+void AssetSaver::Serialize( Item& item )
+{
+	item.m_Failed = !item.m_Loader->SerializeAsset( item.m_Asset, item.m_Buffer, item.m_Path );
+}
+
+void AssetSaver::Write( Item& item )
+{
+	FileStream* stream = FileStream::OpenFileStream( item.m_Path.Data(), FileStream::MODE_WRITE );
+	if ( !stream )
+	{
+		item.m_Failed = true;
+		return;
+	}
+
+	size_t size = item.m_Buffer.GetSize();
+	item.m_Failed = ( size != 0 && stream->Write( item.m_Buffer.GetData(), 1, size ) != size );
+
+	delete stream;
+
+	item.m_Buffer.Clear();
+}
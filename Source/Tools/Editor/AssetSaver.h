@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Platform/Locks.h"
+#include "Platform/Semaphore.h"
+#include "Foundation/DynamicArray.h"
+#include "Foundation/FilePath.h"
+
+#include "Engine/Asset.h"
+#include "Engine/PackageLoader.h"
+
+#include <deque>
+
+namespace Helium
+{
+    namespace Editor
+    {
+        //
+        // Asset saver serializes and writes assets in a pool of threads.  Each
+        //  asset of a save is first serialized into memory by its package loader,
+        //  during which the caller must leave the assets alone.  Once all of them
+        //  are serialized the save is a snapshot: their files are written in the
+        //  background while editing carries on.  Serialization is always worked
+        //  on before writing, so a save is never held up by the writes of the
+        //  previous one.
+        //
+        // Update() has to be called on the main thread to move a serialized save
+        //  on to writing and to collect errors.
+        //
+
+        class AssetSaver
+        {
+        public:
+            AssetSaver();
+            ~AssetSaver();
+
+            bool Save( const std::vector< AssetPtr >& assets );
+            void Update();
+            void Flush();
+
+            bool IsSerializing() const;
+            bool IsWriting() const;
+            void GetSerializeProgress( uint32_t& serialized, uint32_t& total ) const;
+            uint32_t GetWriteCount() const;
+
+            bool TakeErrors( std::string& errors );
+
+        private:
+            struct Item
+            {
+                AssetPtr                    m_Asset;
+                PackageLoader*              m_Loader;
+                DynamicArray< uint8_t >     m_Buffer;
+                FilePath                    m_Path;
+                bool                        m_Done;     // serialized or written (mutex locked)
+                bool                        m_Failed;
+            };
+
+            class SaveThread : public wxThread
+            {
+            public:
+                SaveThread( AssetSaver& saver )
+                    : wxThread ( wxTHREAD_JOINABLE )
+                    , m_Saver( saver )
+                {
+
+                }
+
+                virtual void* Entry();
+
+            private:
+                AssetSaver& m_Saver;
+            };
+
+            static void Serialize( Item& item );
+            static void Write( Item& item );
+
+            std::vector< SaveThread* >  m_SaveThreads;      // The saving thread objects
+
+            std::vector< Item* >        m_Serializing;      // Items of the save being serialized (main thread)
+            std::vector< Item* >        m_Writing;          // Items of previous saves being written (main thread)
+            uint32_t                    m_SerializedCount;  // Items of m_Serializing done (mutex locked)
+
+            mutable Helium::Mutex       m_Mutex;            // Locks the queues and the item states
+            std::deque< Item* >         m_SerializeQueue;   // Items waiting to be serialized (mutex locked)
+            std::deque< Item* >         m_WriteQueue;       // Items waiting to be written (mutex locked)
+            Helium::Semaphore           m_Signal;           // Signalling semaphore to wake up a save thread, once per queued item
+            bool                        m_Quit;
+
+            std::string                 m_Errors;           // Errors not yet taken (main thread)
+        };
+    }
+}
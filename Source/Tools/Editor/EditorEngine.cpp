@@ -13,6 +13,13 @@
 #include "Reflect/Object.h"
 #include "Graphics/BufferedDrawer.h"
 #include "Engine/PackageLoader.h"
+#include "Engine/FrameProfiler.h"
+#include "Platform/Timer.h"
+#include "Engine/FrameArena.h"
+#include "Editor/Perforce/Perforce.h"
+#include "Editor/Perforce/P4StatusCache.h"
+
+#include <algorithm>
 
 using namespace Helium;
 using namespace Helium::Editor;
@@ -45,6 +52,25 @@ void ForciblyFullyLoadedPackageManager::Shutdown()
 	}
 }
 
+namespace
+{
+	// Orders child asset loads by path so that assets stored next to each other are requested back to back
+	struct ChildAssetLoadOrder
+	{
+		const DynamicArray< String >& m_PathStrings;
+
+		ChildAssetLoadOrder( const DynamicArray< String >& pathStrings )
+			: m_PathStrings( pathStrings )
+		{
+		}
+
+		bool operator()( size_t a, size_t b ) const
+		{
+			return CaseInsensitiveCompareString( *m_PathStrings[ a ], *m_PathStrings[ b ] ) < 0;
+		}
+	};
+}
+
 void ForciblyFullyLoadedPackageManager::Tick()
 {
 	AssetLoader *pAssetLoader = AssetLoader::GetInstance();
@@ -54,6 +80,7 @@ void ForciblyFullyLoadedPackageManager::Tick()
 		packageIter != m_ForciblyFullyLoadedPackages.End(); ++packageIter)
 	{
 		ForciblyFullyLoadedPackage &package = *packageIter;
+		HELIUM_ASSERT( m_LoadedAssetBatch.IsEmpty() );
 
 		// Load the package if we need to
 		if ( Helium::IsValid< size_t >( package.m_PackageLoadId ) )
@@ -64,97 +91,126 @@ void ForciblyFullyLoadedPackageManager::Tick()
 			HELIUM_ASSERT( !package.m_Package );
 
 			AssetPtr packagePtr;
-			if ( pAssetLoader->TryFinishLoad( package.m_PackageLoadId, packagePtr ) )
+			if ( !pAssetLoader->TryFinishLoad( package.m_PackageLoadId, packagePtr ) )
+			{
+				continue;
+			}
+
+			// Load request is finished.
+			package.m_PackageLoadId = Helium::Invalid< size_t >();
+			package.m_Package = Reflect::AssertCast<Package>(packagePtr);
+
+			if ( !package.m_Package )
+			{
+				HELIUM_TRACE(
+					TraceLevels::Warning,
+					"Failed to load package '%s' for editor.",
+					*package.m_PackagePath.ToString());
+				continue;
+			}
+
+			if ( !package.m_Package->GetAllFlagsSet( Asset::FLAG_EDITOR_FORCIBLY_LOADED ) )
 			{
-				// Load request is finished.
-				package.m_PackageLoadId = Helium::Invalid< size_t >();
-				package.m_Package = Reflect::AssertCast<Package>(packagePtr);
-
-				if ( package.m_Package )
-				{
-					if ( !package.m_Package->GetAllFlagsSet( Asset::FLAG_EDITOR_FORCIBLY_LOADED ) )
-					{
-						// Package loaded successfully, queue load requests for all children
-						package.m_Package->SetFlags( Asset::FLAG_EDITOR_FORCIBLY_LOADED );
-						e_AssetForciblyLoadedEvent.Raise( AssetEventArgs( package.m_Package ) );
-					}
-
-					PackageLoader *pLoader = package.m_Package->GetLoader();
-					pLoader->EnumerateChildren( package.m_AssetPaths );
-
-					package.m_Assets.Resize( package.m_AssetPaths.GetSize() );
-					package.m_AssetLoadIds.Resize( package.m_AssetPaths.GetSize() );
-
-					DynamicArray< AssetPath >::Iterator assetPathIter = package.m_AssetPaths.Begin();
-					DynamicArray< size_t >::Iterator assetLoadIdIter = package.m_AssetLoadIds.Begin();
-
-					int i = 0;
-					for ( ; assetPathIter != package.m_AssetPaths.End(); ++assetPathIter, ++assetLoadIdIter )
-					{
-						*assetLoadIdIter = pAssetLoader->BeginLoadObject( *assetPathIter );
-						HELIUM_ASSERT( !package.m_Assets[i++] );
-					}
-				}
-				else
-				{
-					HELIUM_TRACE(
-						TraceLevels::Warning,
-						"Failed to load package '%s' for editor.",
-						*package.m_PackagePath.ToString());
-				}
+				package.m_Package->SetFlags( Asset::FLAG_EDITOR_FORCIBLY_LOADED );
+				m_LoadedAssetBatch.Push( package.m_Package.Ptr() );
 			}
+
+			// Package loaded successfully, queue load requests for all children
+			BeginLoadChildAssets( package );
+		}
+
+		if ( package.m_Package )
+		{
+			FinishLoadChildAssets( package );
+		}
+
+		if ( !m_LoadedAssetBatch.IsEmpty() )
+		{
+			e_AssetsForciblyLoadedEvent.Raise( AssetsForciblyLoadedEventArgs( package.m_Package, m_LoadedAssetBatch ) );
+			m_LoadedAssetBatch.Resize( 0 );
 		}
 	}
+}
 
-	// For each editable package
-	for ( DynamicArray< ForciblyFullyLoadedPackage >::Iterator packageIter = m_ForciblyFullyLoadedPackages.Begin();
-		packageIter != m_ForciblyFullyLoadedPackages.End(); ++packageIter)
+void ForciblyFullyLoadedPackageManager::BeginLoadChildAssets( ForciblyFullyLoadedPackage &package )
+{
+	AssetLoader *pAssetLoader = AssetLoader::GetInstance();
+
+	DynamicArray< AssetPath > childPaths;
+	PackageLoader *pLoader = package.m_Package->GetLoader();
+	pLoader->EnumerateChildren( childPaths );
+
+	const size_t childCount = childPaths.GetSize();
+
+	// Issue the whole package as one batch sorted by path rather than in enumeration order
+	DynamicArray< String > pathStrings;
+	pathStrings.Reserve( childCount );
+	DynamicArray< size_t > loadOrder;
+	loadOrder.Reserve( childCount );
+	for ( size_t i = 0; i < childCount; ++i )
 	{
-		ForciblyFullyLoadedPackage &package = *packageIter;
+		pathStrings.Push( childPaths[ i ].ToString() );
+		loadOrder.Push( i );
+	}
 
-		// If the package is loaded
-		if ( package.m_Package )
+	std::sort( loadOrder.GetData(), loadOrder.GetData() + childCount, ChildAssetLoadOrder( pathStrings ) );
+
+	package.m_AssetPaths.Reserve( childCount );
+	package.m_AssetLoadIds.Reserve( childCount );
+	package.m_Assets.Resize( childCount );
+	package.m_PendingAssetIndices.Reserve( childCount );
+
+	for ( size_t i = 0; i < childCount; ++i )
+	{
+		AssetPath path = childPaths[ loadOrder[ i ] ];
+		package.m_AssetPaths.Push( path );
+		package.m_AssetLoadIds.Push( pAssetLoader->BeginLoadObject( path ) );
+		package.m_PendingAssetIndices.Push( i );
+		HELIUM_ASSERT( !package.m_Assets[ i ] );
+	}
+}
+
+void ForciblyFullyLoadedPackageManager::FinishLoadChildAssets( ForciblyFullyLoadedPackage &package )
+{
+	AssetLoader *pAssetLoader = AssetLoader::GetInstance();
+
+	// Only poll the loads that are still outstanding, compacting the pending list as they finish
+	size_t pendingCount = package.m_PendingAssetIndices.GetSize();
+	size_t keptCount = 0;
+	for ( size_t pendingIndex = 0; pendingIndex < pendingCount; ++pendingIndex )
+	{
+		size_t i = package.m_PendingAssetIndices[ pendingIndex ];
+		HELIUM_ASSERT( Helium::IsValid<size_t>( package.m_AssetLoadIds[i] ) );
+		HELIUM_ASSERT( !package.m_Assets[i] );
+
+		if ( !pAssetLoader->TryFinishLoad( package.m_AssetLoadIds[i], package.m_Assets[i] ) )
 		{
-			// Load the child assets if we need to
-			for ( size_t i = 0; i < package.m_AssetPaths.GetSize(); ++i )
+			HELIUM_ASSERT( !package.m_Assets[i] );
+			package.m_PendingAssetIndices[ keptCount++ ] = i;
+			continue;
+		}
+
+		package.m_AssetLoadIds[i] = Invalid< size_t >();
+
+		if ( package.m_Assets[i] )
+		{
+			// Asset loaded successfully
+			if ( !package.m_Assets[i]->IsPackage() && !package.m_Assets[i]->GetAllFlagsSet( Asset::FLAG_EDITOR_FORCIBLY_LOADED ) )
 			{
-				if ( Helium::IsValid<size_t>( package.m_AssetLoadIds[i] ) )
-				{
-					HELIUM_ASSERT( !package.m_Assets[i] );
-					if ( pAssetLoader->TryFinishLoad( package.m_AssetLoadIds[i], package.m_Assets[i] ) )
-					{
-						package.m_AssetLoadIds[i] = Invalid< size_t >();
-
-						if ( package.m_Assets[i] )
-						{
-							// Asset loaded successfully
-							if ( !package.m_Assets[i]->IsPackage() && !package.m_Assets[i]->GetAllFlagsSet( Asset::FLAG_EDITOR_FORCIBLY_LOADED ) )
-							{
-								package.m_Assets[i]->SetFlags( Asset::FLAG_EDITOR_FORCIBLY_LOADED );
-								e_AssetForciblyLoadedEvent.Raise( AssetEventArgs( package.m_Assets[i] ) );
-							}
-						}
-						else
-						{
-							HELIUM_TRACE(
-								TraceLevels::Warning,
-								"Failed to asset '%s' for editor.",
-								*package.m_PackagePath.ToString());
-						}
-					}
-					else
-					{
-						HELIUM_ASSERT( !package.m_Assets[i] );
-					}
-
-					if ( Helium::IsValid<size_t>( package.m_AssetLoadIds[i] ) )
-					{
-						HELIUM_ASSERT( !package.m_Assets[i] );
-					}
-				}
+				package.m_Assets[i]->SetFlags( Asset::FLAG_EDITOR_FORCIBLY_LOADED );
+				m_LoadedAssetBatch.Push( package.m_Assets[i] );
 			}
 		}
+		else
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"Failed to load asset '%s' for editor.",
+				*package.m_AssetPaths[i].ToString());
+		}
 	}
+
+	package.m_PendingAssetIndices.Resize( keptCount );
 }
 
 void ForciblyFullyLoadedPackageManager::ForceFullyLoadRootPackages()
@@ -201,6 +257,26 @@ bool Helium::Editor::ForciblyFullyLoadedPackageManager::IsPackageForcedFullyLoad
 	return false;
 }
 
+bool ForciblyFullyLoadedPackageManager::HasPendingLoads() const
+{
+	for ( size_t packageIndex = 0; packageIndex < m_ForciblyFullyLoadedPackages.GetSize(); ++packageIndex )
+	{
+		const ForciblyFullyLoadedPackage &package = m_ForciblyFullyLoadedPackages[ packageIndex ];
+
+		if ( Helium::IsValid< size_t >( package.m_PackageLoadId ) )
+		{
+			return true;
+		}
+
+		if ( !package.m_PendingAssetIndices.IsEmpty() )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 uint32_t                        ThreadSafeAssetTrackerListener::sm_InitCount = 0;
@@ -284,6 +360,17 @@ void ThreadSafeAssetTrackerListener::Sync()
 	buffer.m_ChangedExternally.Clear();
 }
 
+bool ThreadSafeAssetTrackerListener::HasPendingEvents()
+{
+	MutexScopeLock lock( m_Lock );
+
+	const Buffer &buffer = m_Buffers[ m_GameThreadBufferIndex % 2 ];
+	return !buffer.m_Loaded.IsEmpty() ||
+		!buffer.m_Changed.IsEmpty() ||
+		!buffer.m_CreatedExternally.IsEmpty() ||
+		!buffer.m_ChangedExternally.IsEmpty();
+}
+
 void ThreadSafeAssetTrackerListener::OnAssetLoaded( const AssetEventArgs &args )
 {
 	MutexScopeLock lock( m_Lock );
@@ -311,16 +398,27 @@ void ThreadSafeAssetTrackerListener::OnAssetChangedExternally( const AssetEventA
 
 //////////////////////////////////////////////////////////////////////////
 
+EditorEngine* EditorEngine::sm_pInstance = NULL;
+
 EditorEngine::EditorEngine()
 	: m_SceneManager( NULL )
 	, m_EngineTickTimer( this )
 	, m_bTerminateAssetManagerThread( false )
+	, m_TickRequested( true )
+	, m_ContinuousTick( false )
+	, m_LastTickTime( 0 )
 {
 	TaskScheduler::CalculateSchedule( TickTypes::Editor, m_Schedule );
 }
 
 EditorEngine::~EditorEngine()
 {
+	HELIUM_ASSERT( sm_pInstance != this );
+}
+
+EditorEngine* EditorEngine::GetInstance()
+{
+	return sm_pInstance;
 }
 
 bool EditorEngine::Initialize( Editor::SceneManager* sceneManager, void* hwnd )
@@ -338,7 +436,7 @@ bool EditorEngine::Initialize( Editor::SceneManager* sceneManager, void* hwnd )
 		Renderer::ContextInitParameters mainCtxInitParams;
 		mainCtxInitParams.pWindow = hwnd;
 		mainCtxInitParams.bFullscreen = false;
-		mainCtxInitParams.bVsync = true;
+		mainCtxInitParams.presentMode = RENDERER_PRESENT_MODE_VSYNC;
 		mainCtxInitParams.displayWidth = 64;
 		mainCtxInitParams.displayHeight = 64;
 
@@ -356,8 +454,14 @@ bool EditorEngine::Initialize( Editor::SceneManager* sceneManager, void* hwnd )
 	WorldManager::Startup();
 	ForciblyFullyLoadedPackageManager::Startup();
 
-	// Start engine tick
-	m_EngineTickTimer.Start( 15 );
+	FrameProfiler::SetThreadName( "Main" );
+
+	HELIUM_ASSERT( !sm_pInstance );
+	sm_pInstance = this;
+
+	// Start engine tick, the first one renders the initial state of the viewports
+	m_TickRequested = true;
+	ScheduleNextTick();
 
 	// Make sure asset loader always gets ticked
 	Helium::CallbackThread::Entry entry = &Helium::CallbackThread::EntryHelper<EditorEngine, &EditorEngine::DoAssetManagerThread>;
@@ -375,11 +479,16 @@ void EditorEngine::Cleanup()
 	if ( m_SceneManager )
 	{
 		m_bTerminateAssetManagerThread = true;
+		AssetLoader::GetInstance()->SignalWork();
 		m_TickAssetManagerThread.Join();
 		m_EngineTickTimer.Stop();
 
+		HELIUM_ASSERT( sm_pInstance == this );
+		sm_pInstance = NULL;
+
 		ForciblyFullyLoadedPackageManager::Shutdown();
 		WorldManager::Shutdown();
+		FrameArena::Shutdown();
 		DynamicDrawer::Shutdown();
 		RenderResourceManager::Shutdown();
 #if HELIUM_DIRECT3D
@@ -394,30 +503,116 @@ void EditorEngine::Cleanup()
 
 void EditorEngine::Tick()
 {
+	HELIUM_FRAME_PROFILER_SCOPE( "Frame" );
+
 	// Tick asset loader before every simulation update
 	// This was moved to DoAssetManagerThread() to prevent UI lockups
 	//AssetLoader::GetInstance()->Tick();
 
+	// Anything marking the editor dirty from here on needs another tick
+	m_TickRequested = false;
+	m_LastTickTime = Timer::GetTickCount();
+
 	// Do asset loading events/work that has to be done in the wx thread
 	ForciblyFullyLoadedPackageManager::GetInstance()->Tick();
 	ThreadSafeAssetTrackerListener::GetInstance()->Sync();
 
+	// Report source control status fetched in the background
+	Perforce::StatusCache* pStatusCache = Perforce::GetStatusCache();
+	if ( pStatusCache )
+	{
+		pStatusCache->Sync();
+	}
+
 	WorldManager* pWorldManager = WorldManager::GetInstance();
 	HELIUM_ASSERT( pWorldManager );
 	pWorldManager->Update( m_Schedule );
 }
 
+void EditorEngine::RequestTick()
+{
+	if ( m_TickRequested )
+	{
+		return;
+	}
+
+	m_TickRequested = true;
+
+	// Don't wait out the rest of an idle poll interval
+	if ( m_EngineTickTimer.IsRunning() && m_EngineTickTimer.GetInterval() > TICK_INTERVAL_MS )
+	{
+		ScheduleNextTick();
+	}
+}
+
+void EditorEngine::SetContinuousTick( bool continuous )
+{
+	m_ContinuousTick = continuous;
+
+	if ( continuous )
+	{
+		RequestTick();
+	}
+}
+
+bool EditorEngine::ShouldTick()
+{
+	// Asset events, forced loads and source control updates are only processed by ticking
+	if ( !m_TickRequested )
+	{
+		ThreadSafeAssetTrackerListener* pTrackerListener = ThreadSafeAssetTrackerListener::GetInstance();
+		ForciblyFullyLoadedPackageManager* pPackageManager = ForciblyFullyLoadedPackageManager::GetInstance();
+		Perforce::StatusCache* pStatusCache = Perforce::GetStatusCache();
+		if ( ( pTrackerListener && pTrackerListener->HasPendingEvents() ) ||
+			( pPackageManager && pPackageManager->HasPendingLoads() ) ||
+			( pStatusCache && pStatusCache->HasPendingUpdates() ) )
+		{
+			m_TickRequested = true;
+		}
+	}
+
+	if ( !IsDirty() )
+	{
+		return false;
+	}
+
+	if ( !wxTheApp->IsActive() &&
+		Timer::TicksToMilliseconds( Timer::GetTickCount() - m_LastTickTime ) < UNFOCUSED_TICK_INTERVAL_MS )
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void EditorEngine::ScheduleNextTick()
+{
+	int interval = IDLE_POLL_INTERVAL_MS;
+	if ( IsDirty() )
+	{
+		interval = wxTheApp->IsActive() ? TICK_INTERVAL_MS : UNFOCUSED_TICK_INTERVAL_MS;
+	}
+
+	m_EngineTickTimer.Start( interval, wxTIMER_ONE_SHOT );
+}
+
 void EditorEngine::DoAssetManagerThread()
 {
+	FrameProfiler::SetThreadName( "Editor AssetLoader::Tick Thread" );
+
+	AssetLoader* pAssetLoader = AssetLoader::GetInstance();
+
+	// Tick as soon as loads are begun or reads complete, and keep ticking while loads make progress. The short wait
+	// while work is pending only covers load stages that finish without signaling the loader
 	AssetAwareThreadSynchronizer assetSyncUtil;
 	while ( !m_bTerminateAssetManagerThread )
 	{
 		assetSyncUtil.Sync();
-		AssetLoader::GetInstance()->Tick();
+		pAssetLoader->Tick();
 
 		if ( !m_bTerminateAssetManagerThread )
 		{
-			Thread::Sleep( 100 );
+			pAssetLoader->WaitForWork( pAssetLoader->HasPendingWork() ? ASSET_PENDING_WAIT_MS : ASSET_IDLE_WAIT_MS );
 		}
 	}
 
@@ -437,6 +632,11 @@ EngineTickTimer::~EngineTickTimer()
 
 void EngineTickTimer::Notify()
 {
-	m_AssetSyncUtil.Sync();
-	m_Engine->Tick();
+	if ( m_Engine->ShouldTick() )
+	{
+		m_AssetSyncUtil.Sync();
+		m_Engine->Tick();
+	}
+
+	m_Engine->ScheduleNextTick();
 }
@@ -14,6 +14,20 @@ namespace Helium
 	{
 		class EditorEngine;
 
+		// Assets of a forcibly loaded package that finished loading in the same tick
+		struct AssetsForciblyLoadedEventArgs
+		{
+			Package* m_Package;
+			const DynamicArray< AssetPtr >& m_Assets;
+
+			AssetsForciblyLoadedEventArgs( Package* package, const DynamicArray< AssetPtr >& assets )
+				: m_Package( package )
+				, m_Assets( assets )
+			{
+			}
+		};
+		typedef Helium::Signature< const AssetsForciblyLoadedEventArgs& > AssetsForciblyLoadedSignature;
+
 		// Provides API to allow the editor to force packages and their assets into existence
 		class ForciblyFullyLoadedPackageManager : NonCopyable
 		{
@@ -28,8 +42,10 @@ namespace Helium
 			void ForceFullyLoadPackage( const AssetPath &path );
 
 			bool IsPackageForcedFullyLoaded( const AssetPath &path );
+			bool HasPendingLoads() const;
 
-			AssetEventSignature::Event e_AssetForciblyLoadedEvent;
+			// Raised at most once per package per tick with every asset that became editable in that tick
+			AssetsForciblyLoadedSignature::Event e_AssetsForciblyLoadedEvent;
 
 		private:
 			struct ForciblyFullyLoadedPackage
@@ -38,14 +54,23 @@ namespace Helium
 				size_t m_PackageLoadId;
 				StrongPtr< Package > m_Package;
 
-				// First entry is always the package
+				// Child assets, in the order their loads were issued
 				DynamicArray< AssetPath >        m_AssetPaths;
 				DynamicArray< size_t >           m_AssetLoadIds;
 				DynamicArray< StrongPtr<Asset> > m_Assets;
+
+				// Indices of the child assets whose loads haven't finished yet
+				DynamicArray< size_t >           m_PendingAssetIndices;
 			};
 
+			void BeginLoadChildAssets( ForciblyFullyLoadedPackage &package );
+			void FinishLoadChildAssets( ForciblyFullyLoadedPackage &package );
+
 			DynamicArray< ForciblyFullyLoadedPackage > m_ForciblyFullyLoadedPackages;
 
+			// Assets that became editable during the current tick, raised as one batch per package
+			DynamicArray< AssetPtr > m_LoadedAssetBatch;
+
 			/// Singleton instance.
 			static uint32_t sm_InitCount;
 			static ForciblyFullyLoadedPackageManager* sm_pInstance;
@@ -63,6 +88,7 @@ namespace Helium
 			static void Shutdown();
 
 			void Sync();
+			bool HasPendingEvents();
 
 			AssetEventSignature::Event e_AssetLoaded;
 			AssetEventSignature::Event e_AssetChanged;
@@ -105,25 +131,55 @@ namespace Helium
 			AssetAwareThreadSynchronizer m_AssetSyncUtil;
 		};
 
+		// The engine only ticks (and so renders) while something has marked the editor dirty: input, asset events,
+		// pending forced loads, or a continuous tick request such as a playing simulation. While idle, the tick timer
+		// only polls for asset work at a low rate, and ticks are throttled while the application is in the background
 		class EditorEngine : NonCopyable
 		{
 		public:
+			// Interval between ticks while the editor is dirty and the application is active
+			static const int TICK_INTERVAL_MS = 15;
+			// Minimum interval between ticks while the application is in the background
+			static const int UNFOCUSED_TICK_INTERVAL_MS = 250;
+			// Interval at which an idle editor checks for asset events and loads
+			static const int IDLE_POLL_INTERVAL_MS = 100;
+			// Longest wait between asset loader ticks while loads are in progress, and while the loader is idle
+			static const uint32_t ASSET_PENDING_WAIT_MS = 2;
+			static const uint32_t ASSET_IDLE_WAIT_MS = 1000;
+
 			EditorEngine();
 			~EditorEngine();
 
+			static EditorEngine* GetInstance();
+
 			bool Initialize( Editor::SceneManager* sceneManager, void* hwnd );
 			void Cleanup();
 
 			void Tick();
 
+			// Must be called from the main thread
+			void RequestTick();
+			void SetContinuousTick( bool continuous );
+			bool GetContinuousTick() const { return m_ContinuousTick; }
+
+			bool ShouldTick();
+			void ScheduleNextTick();
+
 		private:
 			void DoAssetManagerThread();
+			bool IsDirty() const { return m_TickRequested || m_ContinuousTick; }
 
 			Editor::SceneManager* m_SceneManager;
 			CallbackThread m_TickAssetManagerThread;
 			bool m_bTerminateAssetManagerThread;
 			EngineTickTimer m_EngineTickTimer;
 			TaskSchedule m_Schedule;
+
+			bool m_TickRequested;
+			bool m_ContinuousTick;
+			uint64_t m_LastTickTime;
+
+			static EditorEngine* sm_pInstance;
 		};
 	}
 }
@@ -72,12 +72,18 @@ void HierarchyOutliner::AddHierarchyNodes()
 
 ///////////////////////////////////////////////////////////////////////////////
 // Recursively adds the specified hierarchy node, and all of it's children, as
-// items in this tree.
+// items in this tree.  Nodes that are already in the tree are skipped (along
+// with their children, which were added with them).
 // 
 void HierarchyOutliner::RecurseAddHierarchyNode( Editor::HierarchyNode* node, bool root )
 {
     HELIUM_EDITOR_SCOPE_TIMER( "" );
 
+    if ( !root && m_Items.find( node ) != m_Items.end() )
+    {
+        return;
+    }
+
     m_TreeCtrl->Freeze();
 
     if ( !root )
@@ -119,6 +125,65 @@ void HierarchyOutliner::AddHierarchyNode( Editor::HierarchyNode* node )
     AddItem( parentItem, node->GetName(), -1, new HierarchyOutlinerItemData( node ), node->IsSelected() );
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Queues a hierarchy node (and its children) to be added to the tree on idle.
+// Loading or duplicating many nodes raises an event per node, so they are
+// added together in one batch instead of one tree insert and sort each.
+// 
+void HierarchyOutliner::QueueHierarchyNode( Editor::HierarchyNode* node )
+{
+    if ( m_PendingNodeSet.insert( node ).second )
+    {
+        m_PendingNodes.push_back( node );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Overridden from the base class to include the queued hierarchy nodes.
+// 
+bool HierarchyOutliner::HasPendingChanges() const
+{
+    return SceneOutliner::HasPendingChanges() || !m_PendingNodes.empty();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Called by the base class with the tree frozen and sorting disabled.  Adds
+// the queued nodes, parents before their children so that every item lands
+// under its parent's item.
+// 
+void HierarchyOutliner::ApplyPendingChanges()
+{
+    HELIUM_EDITOR_SCOPE_TIMER( "" );
+
+    SceneOutliner::ApplyPendingChanges();
+
+    std::vector< Editor::HierarchyNode* >::const_iterator itr = m_PendingNodes.begin();
+    std::vector< Editor::HierarchyNode* >::const_iterator end = m_PendingNodes.end();
+    for ( ; itr != end; ++itr )
+    {
+        // removed since it was queued
+        if ( m_PendingNodeSet.find( *itr ) == m_PendingNodeSet.end() )
+        {
+            continue;
+        }
+
+        // start from the topmost queued ancestor that isn't in the tree yet,
+        //  the recursion adds the rest
+        Editor::HierarchyNode* node = *itr;
+        while ( node->GetParent()
+            && m_PendingNodeSet.find( node->GetParent() ) != m_PendingNodeSet.end()
+            && m_Items.find( node->GetParent() ) == m_Items.end() )
+        {
+            node = node->GetParent();
+        }
+
+        RecurseAddHierarchyNode( node );
+    }
+
+    m_PendingNodes.clear();
+    m_PendingNodeSet.clear();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Required by the base class.  Creates the tree control that this class wraps,
 // and connects GUI event handlers.
@@ -142,6 +207,9 @@ void HierarchyOutliner::Clear()
 {
     SceneOutliner::Clear();
 
+    m_PendingNodes.clear();
+    m_PendingNodeSet.clear();
+
     m_TreeCtrl->DeleteChildren( m_InvisibleRoot );
 }
 
@@ -259,52 +327,23 @@ void HierarchyOutliner::ParentChanged( const Editor::ParentChangedArgs& args )
     HELIUM_EDITOR_SCOPE_TIMER( "" );
 
     Editor::HierarchyNode* child = args.m_Node;
-    m_TreeCtrl->Freeze();
 
-    // Delete the item and re-add it to the tree to update the hierarchy
+    // Delete the item now and re-add it to the tree on idle to update the
+    //  hierarchy, batched with any other reparented nodes
     DeleteItem( child );
-    RecurseAddHierarchyNode( child );
-
-    m_TreeCtrl->Thaw();
+    QueueHierarchyNode( child );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// Callback for when a scene node is added to the scene.  Recursively adds the
-// item (and all of its children) to the scene.
+// Callback for when a scene node is added to the scene.  Queues the item (and
+// all of its children) to be added to the tree on idle.
 // 
 void HierarchyOutliner::NodeAdded( const Editor::NodeChangeArgs& args )
 {
-    HELIUM_EDITOR_SCOPE_TIMER( "" );
-
     Editor::HierarchyNode* hierarchyNode = Reflect::SafeCast< Editor::HierarchyNode >( args.m_Node );
     if ( hierarchyNode )
     {
-        m_TreeCtrl->Freeze();
-        bool isSortingEnabled = m_TreeCtrl->IsSortingEnabled();
-        m_TreeCtrl->DisableSorting();
-
-        AddHierarchyNode( hierarchyNode );
-
-        m_TreeCtrl->EnableSorting( isSortingEnabled );
-        if ( m_TreeCtrl->IsSortingEnabled() )
-        {
-            // Find the item we just added
-            M_TreeItems::const_iterator found = m_Items.find( hierarchyNode );
-            if ( found != m_Items.end() )
-            {
-                // Default to sorting the children of the item we just added (will be changed below if needed)
-                wxTreeItemId itemToSort = found->second;
-                wxTreeItemId parent = m_TreeCtrl->GetItemParent( itemToSort );
-                if ( parent.IsOk() )
-                {
-                    // If the item has a parent, start sorting with the parent
-                    itemToSort = parent;
-                }
-
-                Sort( itemToSort );
-            }
-        }
-        m_TreeCtrl->Thaw();
+        QueueHierarchyNode( hierarchyNode );
     }
 }
 
@@ -320,6 +359,9 @@ void HierarchyOutliner::NodeRemoved( const Editor::NodeChangeArgs& args )
     if ( hierarchyNode )
     {
         hierarchyNode->RemoveParentChangedListener( ParentChangedSignature::Delegate ( this, &HierarchyOutliner::ParentChanged ) );
+
+        // don't add it if it was still waiting to be
+        m_PendingNodeSet.erase( hierarchyNode );
     }
 
     DeleteItem( args.m_Node );
@@ -3,6 +3,8 @@
 
 #include "Platform/System.h"
 #include "Platform/Process.h"
+#include "Platform/Thread.h"
+#include "Platform/Timer.h"
 
 #include "Persist/ArchiveJson.h"
 
@@ -34,6 +36,10 @@
 #include "Editor/Dialogs/ExportOptionsDialog.h"
 #include "Editor/Input.h"
 
+#include <wx/progdlg.h>
+
+#include <algorithm>
+
 #if HELIUM_OS_LINUX
 # include <gtk/gtk.h>
 # include <gdk/gdkx.h>
@@ -42,6 +48,14 @@
 using namespace Helium;
 using namespace Helium::Editor;
 
+// Undo history limits, by estimated memory held and by number of steps
+static const size_t s_MaxUndoMemory = 64 * 1024 * 1024;
+static const uint32_t s_MaxUndoLength = 1000;
+static const uint32_t s_MinUndoLength = 16;
+
+// Memory assumed for undo commands that can't estimate their own (batches, imports)
+static const size_t s_UndoCommandMemoryEstimate = 1024;
+
 ///////////////////////////////////////////////////////////////////////////////
 // Wraps up a pointer to an Editor::Scene so that it can be stored in the combo box that
 // is used for selecting the current scene.  Each item in the combo box stores 
@@ -125,6 +139,9 @@ MainFrame::MainFrame( SettingsManager* settingsManager, wxWindow* parent, wxWind
 	, m_HierarchyPanel( NULL )
 	, m_PropertiesPanel( NULL )
 	, m_VaultPanel( NULL )
+	, m_ProfilerPanel( NULL )
+	, m_UndoMemoryUsage( 0 )
+	, m_UndoCommandCount( 0 )
 {
 	wxIcon appIcon;
 	appIcon.CopyFromBitmap( wxArtProvider::GetBitmap( ArtIDs::Editor::Helium, wxART_OTHER, wxSize( 32, 32 ) ) );
@@ -153,6 +170,17 @@ bool MainFrame::Initialize()
 	Connect( wxID_SELECTALL, wxCommandEventHandler( MainFrame::OnSelectAll ) );
 	Connect( ID_Close, wxCommandEventHandler( MainFrame::OnClose ), NULL, this );
 
+	//
+	// Undo
+	//
+	m_UndoQueue.SetMaxLength( s_MaxUndoLength );
+
+	//
+	// Saving
+	//
+	m_SaveTimer.SetOwner( this );
+	Connect( m_SaveTimer.GetId(), wxEVT_TIMER, wxTimerEventHandler( MainFrame::OnSaveTimer ), NULL, this );
+
 	//EVT_MENU(wxID_HELP_INDEX, MainFrame::OnHelpIndex)
 	//EVT_MENU(wxID_HELP_SEARCH, MainFrame::OnHelpSearch)
 
@@ -241,6 +269,11 @@ bool MainFrame::Initialize()
 	wxAuiPaneInfo vaultPanelInfo = wxAuiPaneInfo().Name( wxT( "vault" ) ).Caption( wxT( "Asset Vault" ) ).Right().Layer( 1 ).Position( 4 ).Hide();
 	m_FrameManager.AddPane( m_VaultPanel, vaultPanelInfo );
 
+	// Profiler (hidden by default)
+	m_ProfilerPanel = new ProfilerPanel( this );
+	wxAuiPaneInfo profilerPaneInfo = wxAuiPaneInfo().Name( wxT( "profiler" ) ).Caption( wxT( "Profiler" ) ).Bottom().Layer( 1 ).Position( 1 ).MinSize( 400, 150 ).BestSize( wxSize( 900, 250 ) ).Hide();
+	m_FrameManager.AddPane( m_ProfilerPanel, profilerPaneInfo );
+
 	m_FrameManager.Update();
 
 	CreatePanelsMenu( m_MenuPanels );
@@ -311,10 +344,16 @@ MainFrame::~MainFrame()
 
 	CloseProject();
 
+	// Finish writing the files of the last saves
+	m_AssetSaver.Flush();
+	m_SaveTimer.Stop();
+
 	//
 	// Detach event handlers
 	//
 
+	Disconnect( m_SaveTimer.GetId(), wxEVT_TIMER, wxTimerEventHandler( MainFrame::OnSaveTimer ), NULL, this );
+
 	m_SceneManager.e_CurrentSceneChanging.RemoveMethod( this, &MainFrame::CurrentSceneChanging );
 	m_SceneManager.e_CurrentSceneChanged.RemoveMethod( this, &MainFrame::CurrentSceneChanged );
 	m_SceneManager.e_SceneAdded.RemoveMethod( this, &MainFrame::SceneAdded );
@@ -416,7 +455,7 @@ void MainFrame::CloseProject()
 
 		m_DocumentManager.CloseAll();
 		m_Project.Clear();
-		m_UndoQueue.Reset();   
+		ResetUndoQueue();
 	}
 }
 
@@ -506,7 +545,9 @@ void MainFrame::OpenScene( SceneDefinition &sceneDefinition )
 void MainFrame::CloseAllScenes()
 {
 	std::string error;
-	m_SceneManager.SaveAllScenes( error );
+	std::vector< AssetPtr > definitions;
+	m_SceneManager.GetSceneDefinitions( definitions );
+	SaveAssets( definitions, error );
 
 	if ( !error.empty() )
 	{
@@ -562,7 +603,65 @@ void MainFrame::InvertSelection()
 
 bool MainFrame::SaveAll( std::string& error )
 {
-	return m_DocumentManager.SaveAll( error );
+	std::vector< AssetPtr > definitions;
+	m_SceneManager.GetSceneDefinitions( definitions );
+	bool result = SaveAssets( definitions, error );
+
+	return m_DocumentManager.SaveAll( error ) && result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Saves assets on the asset saver's threads.  This only waits for the assets
+//  to be serialized, with a progress dialog keeping the user from changing
+//  them in the meantime; their files are written in the background, and any
+//  errors writing them are reported once they're done.
+//
+bool MainFrame::SaveAssets( const std::vector< AssetPtr >& assets, std::string& error )
+{
+	if ( assets.empty() )
+	{
+		return true;
+	}
+
+	if ( !m_AssetSaver.Save( assets ) )
+	{
+		error += "The previous save is still in progress.\n";
+		return false;
+	}
+
+	// leave reporting on earlier saves until this one is serialized
+	m_SaveTimer.Stop();
+
+	// most saves are serialized in no time, only put up progress for the big ones
+	static const float64_t s_ProgressDelaySeconds = 0.25;
+	uint64_t startTicks = Timer::GetTickCount();
+
+	wxProgressDialog* progress = NULL;
+	while ( m_AssetSaver.IsSerializing() )
+	{
+		uint32_t serialized = 0, total = 0;
+		m_AssetSaver.GetSerializeProgress( serialized, total );
+
+		if ( !progress && !IsBeingDeleted() && static_cast< float64_t >( Timer::GetTickCount() - startTicks ) * Timer::GetSecondsPerTick() > s_ProgressDelaySeconds )
+		{
+			progress = new wxProgressDialog( wxT( "Saving" ), wxT( "Serializing assets..." ), Max< int >( total, 1 ), this, wxPD_APP_MODAL | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME );
+		}
+
+		if ( progress )
+		{
+			progress->Update( serialized, wxString::Format( wxT( "Serializing assets (%u of %u)..." ), serialized, total ) );
+		}
+
+		Thread::Sleep( 10 );
+		m_AssetSaver.Update();
+	}
+
+	delete progress;
+
+	// report on the writes as they happen
+	m_SaveTimer.Start( 100 );
+
+	return !m_AssetSaver.TakeErrors( error );
 }
 
 bool MainFrame::ValidateDrag( const Editor::DragArgs& args )
@@ -1066,6 +1165,30 @@ void MainFrame::OnSaveAll( wxCommandEvent& event )
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Keeps the status bar up to date while saved files are being written, and
+//  reports the errors of the saves once they're all done.
+//
+void MainFrame::OnSaveTimer( wxTimerEvent& event )
+{
+	m_AssetSaver.Update();
+
+	if ( m_AssetSaver.IsWriting() )
+	{
+		m_MainStatusBar->SetStatusText( wxString::Format( wxT( "Writing %u saved files..." ), m_AssetSaver.GetWriteCount() ) );
+		return;
+	}
+
+	m_SaveTimer.Stop();
+	m_MainStatusBar->SetStatusText( wxT( "Saved" ) );
+
+	std::string error;
+	if ( m_AssetSaver.TakeErrors( error ) )
+	{
+		wxMessageBox( error.c_str(), wxT( "Error Saving" ), wxCENTER | wxICON_ERROR | wxOK, this );
+	}
+}
+
 void MainFrame::OpenVaultPanel()
 {
 	wxString queryString = m_ToolbarPanel->m_VaultSearchBox->GetLineText(0);
@@ -1868,13 +1991,59 @@ void MainFrame::OnSceneUndoCommand( const Editor::UndoCommandArgs& args )
 		args.m_Scene->e_HasChanged.Raise( DocumentObjectChangedArgs( true ) );
 	}
 
+	// fold bursts of small edits into the previous step instead of growing the queue
+	MergeableUndoCommand* mergeable = dynamic_cast< MergeableUndoCommand* >( args.m_Command.Ptr() );
+	if ( mergeable && m_LastUndoCommand )
+	{
+		size_t previousUsage = m_LastUndoCommand->GetMemoryUsage();
+		if ( m_LastUndoCommand->Merge( mergeable ) )
+		{
+			m_UndoMemoryUsage = m_UndoMemoryUsage - previousUsage + m_LastUndoCommand->GetMemoryUsage();
+			return;
+		}
+	}
+
 	m_UndoQueue.Push( args.m_Command );
+	m_LastUndoCommand = mergeable;
+
+	m_UndoMemoryUsage += mergeable ? mergeable->GetMemoryUsage() : s_UndoCommandMemoryEstimate;
+	++m_UndoCommandCount;
+
+	// trim the oldest commands once the history holds on to too much memory
+	if ( m_UndoMemoryUsage > s_MaxUndoMemory )
+	{
+		size_t averageUsage = m_UndoMemoryUsage / m_UndoCommandCount;
+		uint32_t maxLength = static_cast< uint32_t >( std::max< size_t >( s_MinUndoLength, s_MaxUndoMemory / std::max< size_t >( averageUsage, 1 ) ) );
+		maxLength = std::min( maxLength, s_MaxUndoLength );
+
+		m_UndoQueue.SetMaxLength( maxLength );
+
+		if ( m_UndoCommandCount > maxLength )
+		{
+			m_UndoCommandCount = maxLength;
+			m_UndoMemoryUsage = averageUsage * maxLength;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Clears the undo queue and the bookkeeping used to merge and trim it.
+// 
+void MainFrame::ResetUndoQueue()
+{
+	m_UndoQueue.Reset();
+	m_UndoQueue.SetMaxLength( s_MaxUndoLength );
+
+	m_LastUndoCommand = NULL;
+	m_UndoMemoryUsage = 0;
+	m_UndoCommandCount = 0;
 }
 
 void MainFrame::OnUndo( wxCommandEvent& event )
 {
 	if ( CanUndo() )
 	{
+		m_LastUndoCommand = NULL;
 		m_UndoQueue.Undo();
 		m_ToolbarPanel->GetCanvas().Read();
 		if ( m_SceneManager.HasCurrentScene() )
@@ -1888,6 +2057,7 @@ void MainFrame::OnRedo( wxCommandEvent& event )
 {
 	if ( CanRedo() )
 	{
+		m_LastUndoCommand = NULL;
 		m_UndoQueue.Redo();
 		m_ToolbarPanel->GetCanvas().Read();
 		if ( m_SceneManager.HasCurrentScene() )
@@ -2179,6 +2349,8 @@ void MainFrame::Executed( const ExecuteArgs& args )
 {
 	if ( !m_PropertiesPanel->GetPropertiesManager().IsActive() && !args.m_Interactively )
 	{
+		// the command may have changed the layout of other cached selections
+		m_PropertiesPanel->GetPropertiesManager().InvalidateCache();
 		m_PropertiesPanel->GetCanvas().Read();
 	}
 }
@@ -2201,7 +2373,7 @@ void MainFrame::OnExiting( wxCloseEvent& args )
 {
 	m_PropertiesPanel->GetPropertiesManager().SyncThreads();
 
-	m_UndoQueue.Reset();
+	ResetUndoQueue();
 
 	if ( !m_DocumentManager.CloseAll() )
 	{
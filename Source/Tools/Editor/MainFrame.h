@@ -4,6 +4,7 @@
 #include "EditorScene/PropertiesManager.h"
 #include "EditorScene/Scene.h"
 #include "EditorScene/SceneManager.h"
+#include "EditorScene/MergeableUndoCommand.h"
 
 #include "Editor/Vault/VaultPanel.h"
 #include "Editor/DragDrop/DropTarget.h"
@@ -11,6 +12,7 @@
 #include "Editor/MRU/MenuMRU.h"
 #include "Editor/TreeMonitor.h"
 #include "Editor/MessageDisplayer.h"
+#include "Editor/AssetSaver.h"
 #include "Editor/Dialogs/FileDialogDisplayer.h"
 
 #include "Editor/EditorGeneratedWrapper.h"
@@ -19,6 +21,7 @@
 #include "Editor/ProjectPanel.h"
 #include "Editor/LayersPanel.h"
 #include "Editor/PropertiesPanel.h"
+#include "Editor/ProfilerPanel.h"
 #include "Editor/ToolbarPanel.h"
 #include "Editor/ViewPanel.h"
 #include "Editor/Inspect/TreeCanvas.h"
@@ -85,6 +88,7 @@ namespace Helium
 			void InvertSelection();
 
 			bool SaveAll( std::string& error );
+			bool SaveAssets( const std::vector< AssetPtr >& assets, std::string& error );
 
 			void SelectionChanged( const Editor::SelectionChangeArgs& selection );
 
@@ -103,6 +107,7 @@ namespace Helium
 			HierarchyPanel*						m_HierarchyPanel;
 			PropertiesPanel*					m_PropertiesPanel;
 			VaultPanel*							m_VaultPanel;
+			ProfilerPanel*						m_ProfilerPanel;
 
 			FilePath							m_Project;
 
@@ -118,6 +123,13 @@ namespace Helium
 
 			TreeMonitor							m_TreeMonitor;
 
+			AssetSaver							m_AssetSaver;
+			wxTimer								m_SaveTimer;
+
+			MergeableUndoCommandPtr				m_LastUndoCommand;		// last command pushed, later ones may merge into it
+			size_t								m_UndoMemoryUsage;		// estimated memory held by the commands pushed since the last reset
+			uint32_t							m_UndoCommandCount;		// commands pushed since the last reset
+
 		private:
 			bool ValidateDrag( const Editor::DragArgs& args );
 			void DragOver( const Editor::DragArgs& args );
@@ -137,6 +149,7 @@ namespace Helium
 			// frame events
 			void OnChar( wxKeyEvent& event );
 			void OnMenuOpen( wxMenuEvent& event );
+			void OnSaveTimer( wxTimerEvent& event );
 
 			virtual void OnNewScene( wxCommandEvent& event ) override;
 			virtual void OnNewEntity( wxCommandEvent& event ) override;
@@ -157,6 +170,7 @@ namespace Helium
 			void OnExport( wxCommandEvent& event ) override;
 
 			void OnSceneUndoCommand( const Editor::UndoCommandArgs& command );
+			void ResetUndoQueue();
 
 			void OnUndo( wxCommandEvent& event ) override;
 			void OnRedo( wxCommandEvent& event ) override;
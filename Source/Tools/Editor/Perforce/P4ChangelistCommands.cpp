@@ -167,4 +167,19 @@ void GetChangelistsCommand::OutputStat( StrDict* dict )
   HELIUM_ASSERT( converted );
 
   m_Changesets->push_back( changeset );
-}
\ No newline at end of file
+}
+
+void LatestChangelistCommand::Run()
+{
+  AddArg( "-m" );
+  AddArg( "1" );
+  AddArg( "-s" );
+  AddArg( "submitted" );
+
+  Command::Run();
+}
+
+void LatestChangelistCommand::OutputStat( StrDict* dict )
+{
+  m_Changelist = dict->GetVar( g_ChangeTag )->Atoi();
+}
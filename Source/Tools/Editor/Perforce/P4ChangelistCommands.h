@@ -22,6 +22,27 @@ namespace Helium
             RCS::V_Changeset* m_Changesets;
         };
 
+        class LatestChangelistCommand : public Command
+        {
+        public:
+            LatestChangelistCommand( Provider* provider )
+                : Command ( provider, "changes" )
+                , m_Changelist ( RCS::InvalidChangesetId )
+            {
+            }
+
+            uint64_t GetChangelist()
+            {
+                return m_Changelist;
+            }
+
+            virtual void OutputStat( StrDict* dict ) override;
+            virtual void Run() override;
+
+        protected:
+            uint64_t m_Changelist;
+        };
+
         class CreateChangelistCommand : public Command
         {
         public:
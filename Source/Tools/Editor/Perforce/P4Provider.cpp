@@ -34,6 +34,7 @@ Provider::Provider()
 	, m_Completed( true, false )
 	, m_Command( NULL )
 	, m_Phase( CommandPhases::Unknown )
+	, m_StatusCache( this )
 {
 	if ( IsDebuggerPresent() )
 	{
@@ -63,10 +64,15 @@ void Provider::Initialize()
 	{
 		throw Perforce::Exception( "Unable to create thread for perforce transaction" );
 	}
+
+	m_StatusCache.Initialize();
 }
 
 void Provider::Cleanup()
 {
+	// the status thread runs commands, stop it before the connection goes away
+	m_StatusCache.Cleanup();
+
 	if ( m_IsConnected )
 	{
 		if ( !m_Client.Dropped() )
@@ -395,13 +401,29 @@ void Provider::Sync( RCS::File& file, const uint64_t timestamp )
 	SyncCommand command( this, &file, timestamp );
 
 	command.Run();
+	m_StatusCache.Invalidate( file );
 }
 
 void Provider::GetInfo( RCS::File& file, const RCS::GetInfoFlag flags )
 {
+	// history isn't cached, and only complete queries can be answered from (or fill) the cache
+	bool cacheable = ( ( flags & RCS::GetInfoFlags::GetHistory ) != RCS::GetInfoFlags::GetHistory )
+		&& file.m_FileData == RCS::FileData::All
+		&& file.m_ActionData == RCS::ActionData::All;
+
+	if ( cacheable && m_StatusCache.GetStatus( file.m_DepotPath.empty() ? file.m_LocalPath : file.m_DepotPath, file ) )
+	{
+		return;
+	}
+
 	SingleFStatCommand command( this, &file );
 	command.Run();
 
+	if ( cacheable )
+	{
+		m_StatusCache.Store( file );
+	}
+
 	if ( ( flags & RCS::GetInfoFlags::GetHistory ) == RCS::GetInfoFlags::GetHistory )
 	{
 		FileLogCommand filelogCommand( this, &file, ( ( flags & RCS::GetInfoFlags::GetIntegrationHistory ) == RCS::GetInfoFlags::GetIntegrationHistory ) );
@@ -419,30 +441,36 @@ void Provider::Add( RCS::File& file )
 {
 	OpenCommand command( this, "add", &file );
 	command.Run();
+	m_StatusCache.Invalidate( file );
 }
 
 void Provider::Edit( RCS::File& file )
 {
 	OpenCommand command ( this, "edit", &file );
 	command.Run();
+	m_StatusCache.Invalidate( file );
 }
 
 void Provider::Delete( RCS::File& file )
 {
 	OpenCommand command ( this, "delete", &file );
 	command.Run();
+	m_StatusCache.Invalidate( file );
 }
 
 void Provider::Integrate( RCS::File& source, RCS::File& dest )
 {
 	IntegrateCommand command( this, &source, &dest );
 	command.Run();
+	m_StatusCache.Invalidate( source );
+	m_StatusCache.Invalidate( dest );
 }
 
 void Provider::Reopen( RCS::File& file )
 {
 	OpenCommand command( this, "reopen", &file );
 	command.Run();
+	m_StatusCache.Invalidate( file );
 }
 
 void Provider::GetChangesets( RCS::V_Changeset& changesets )
@@ -471,6 +499,7 @@ void Provider::Commit( RCS::Changeset& changeset )
 	command.AddArg( RCS::GetChangesetIdAsString( changeset.m_Id ) );
 
 	command.Run();
+	m_StatusCache.InvalidateAll();
 }
 
 void Provider::Revert( RCS::Changeset& changeset, bool revertUnchangedOnly )
@@ -488,6 +517,7 @@ void Provider::Revert( RCS::Changeset& changeset, bool revertUnchangedOnly )
 	command.AddArg( "//..." ); // careful
 
 	command.Run();
+	m_StatusCache.InvalidateAll();
 }
 
 
@@ -510,6 +540,7 @@ void Provider::Revert( RCS::File& file, bool revertUnchangedOnly )
 	command.AddArg( narrowPath.c_str() );
 
 	command.Run();
+	m_StatusCache.Invalidate( file );
 }
 
 void Provider::Rename( RCS::File& source, RCS::File& dest )
@@ -519,4 +550,7 @@ void Provider::Rename( RCS::File& source, RCS::File& dest )
 
 	OpenCommand deleteCommand( this, "delete", &source );
 	deleteCommand.Run();
+
+	m_StatusCache.Invalidate( source );
+	m_StatusCache.Invalidate( dest );
 }
@@ -8,6 +8,7 @@
 #include "Platform/Thread.h"
 #include "Platform/Locks.h"
 #include "P4API.h"
+#include "P4StatusCache.h"
 
 namespace Helium
 {
@@ -135,6 +136,8 @@ namespace Helium
             std::string               m_UserName;
             std::string               m_ClientName;
 
+            StatusCache           m_StatusCache;  // batched, background fstat results
+
         private:
             // transaction thread
             Helium::CallbackThread        m_Thread;     // the thread to run commands in
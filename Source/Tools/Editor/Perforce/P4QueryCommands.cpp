@@ -343,6 +343,28 @@ void MultiFStatCommand::OutputStat( StrDict *dict )
     FStatCommand::OutputStat( dict );
 }
 
+void BatchFStatCommand::Run()
+{
+    // one transaction for all of the paths rather than one per file
+    for ( std::vector< std::string >::const_iterator itr = m_Paths.begin(), end = m_Paths.end(); itr != end; ++itr )
+    {
+        AddArg( *itr );
+    }
+
+    FStatCommand::Run();
+}
+
+void BatchFStatCommand::OutputStat( StrDict *dict )
+{
+    m_Files->push_back( RCS::File () );
+
+    m_File = &m_Files->back();
+    m_File->m_FileData = m_FileData;
+    m_File->m_ActionData = m_ActionData;
+
+    FStatCommand::OutputStat( dict );
+}
+
 void FileLogCommand::Run()
 {
     if ( !m_File->m_DepotPath.empty() )
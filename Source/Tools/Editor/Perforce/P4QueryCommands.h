@@ -76,6 +76,29 @@ namespace Helium
             uint32_t m_ActionData;
         };
 
+        class BatchFStatCommand : public FStatCommand
+        {
+        public:
+            BatchFStatCommand( Provider* provider, const std::vector< std::string >& paths, RCS::V_File* files, uint32_t fileData = RCS::FileData::All, uint32_t actionData = RCS::ActionData::All )
+                : FStatCommand ( provider, "fstat", NULL )
+                , m_Paths ( paths )
+                , m_Files ( files )
+                , m_FileData ( fileData )
+                , m_ActionData ( actionData )
+            {
+
+            }
+
+            virtual void Run() override;
+            virtual void OutputStat( StrDict *dict ) override;
+
+        protected:
+            const std::vector< std::string >& m_Paths;
+            RCS::V_File* m_Files;
+            uint32_t m_FileData;
+            uint32_t m_ActionData;
+        };
+
         class FileLogCommand : public Command
         {
         public:
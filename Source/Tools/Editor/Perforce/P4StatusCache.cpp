@@ -0,0 +1,328 @@
+#include "Precompile.h"
+#include "P4StatusCache.h"
+#include "P4Provider.h"
+#include "P4Exceptions.h"
+#include "P4QueryCommands.h"
+#include "P4ChangelistCommands.h"
+
+#include "Foundation/Log.h"
+
+#include <algorithm>
+
+using namespace Helium;
+using namespace Helium::Perforce;
+
+StatusCache::StatusCache( Provider* provider )
+    : m_Provider( provider )
+    , m_Invalidated( false )
+    , m_LatestChangelist( RCS::InvalidChangesetId )
+    , m_IsInitialized( false )
+    , m_Shutdown( false )
+    , m_Wakeup( false, false )
+{
+}
+
+StatusCache::~StatusCache()
+{
+    Cleanup();
+}
+
+void StatusCache::Initialize()
+{
+    m_Shutdown = false;
+
+    Helium::CallbackThread::Entry entry = &Helium::CallbackThread::EntryHelper<StatusCache, &StatusCache::ThreadEntry>;
+    if ( !m_Thread.Create( entry, this, "Perforce Status Thread" ) )
+    {
+        throw Perforce::Exception( "Unable to create thread for perforce status queries" );
+    }
+
+    m_IsInitialized = true;
+}
+
+void StatusCache::Cleanup()
+{
+    if ( m_IsInitialized )
+    {
+        m_Shutdown = true;
+        m_Wakeup.Signal();
+        m_Thread.Join();
+
+        m_IsInitialized = false;
+    }
+
+    Helium::MutexScopeLock mutex ( m_Mutex );
+    m_Files.clear();
+    m_Queued.clear();
+    m_Requested.clear();
+    m_Updated.clear();
+}
+
+bool StatusCache::GetStatus( const std::string& path, RCS::File& file, bool request )
+{
+    {
+        Helium::MutexScopeLock mutex ( m_Mutex );
+
+        M_File::const_iterator found = m_Files.find( GetKey( path ) );
+        if ( found != m_Files.end() )
+        {
+            uint32_t fileData = file.m_FileData;
+            uint32_t actionData = file.m_ActionData;
+
+            file = found->second;
+            file.m_FileData = fileData;
+            file.m_ActionData = actionData;
+            return true;
+        }
+    }
+
+    if ( request )
+    {
+        RequestStatus( path );
+    }
+
+    return false;
+}
+
+void StatusCache::RequestStatus( const std::string& path )
+{
+    std::vector< std::string > paths;
+    paths.push_back( path );
+    RequestStatus( paths );
+}
+
+void StatusCache::RequestStatus( const std::vector< std::string >& paths )
+{
+    bool queued = false;
+
+    {
+        Helium::MutexScopeLock mutex ( m_Mutex );
+
+        for ( std::vector< std::string >::const_iterator itr = paths.begin(), end = paths.end(); itr != end; ++itr )
+        {
+            std::string key = GetKey( *itr );
+            if ( m_Files.find( key ) == m_Files.end() && m_Requested.insert( key ).second )
+            {
+                m_Queued.push_back( *itr );
+                queued = true;
+            }
+        }
+    }
+
+    if ( queued )
+    {
+        m_Wakeup.Signal();
+    }
+}
+
+void StatusCache::Store( const RCS::File& file )
+{
+    Helium::MutexScopeLock mutex ( m_Mutex );
+    StoreLocked( file );
+}
+
+void StatusCache::Invalidate( const RCS::File& file )
+{
+    Helium::MutexScopeLock mutex ( m_Mutex );
+
+    if ( !file.m_LocalPath.empty() )
+    {
+        m_Files.erase( GetKey( file.m_LocalPath ) );
+    }
+
+    if ( !file.m_DepotPath.empty() )
+    {
+        m_Files.erase( GetKey( file.m_DepotPath ) );
+    }
+
+    m_Invalidated = true;
+}
+
+void StatusCache::InvalidateAll()
+{
+    Helium::MutexScopeLock mutex ( m_Mutex );
+
+    m_Files.clear();
+    m_Invalidated = true;
+}
+
+void StatusCache::Sync()
+{
+    RCS::V_File updated;
+    bool invalidated = false;
+
+    {
+        Helium::MutexScopeLock mutex ( m_Mutex );
+
+        updated.swap( m_Updated );
+        invalidated = m_Invalidated;
+        m_Invalidated = false;
+    }
+
+    // one event for everything fetched since the last sync, rather than one per file
+    if ( !updated.empty() || invalidated )
+    {
+        e_StatusUpdated.Raise( StatusUpdateArgs( updated, invalidated ) );
+    }
+}
+
+bool StatusCache::HasPendingUpdates()
+{
+    Helium::MutexScopeLock mutex ( m_Mutex );
+    return !m_Updated.empty() || m_Invalidated;
+}
+
+void StatusCache::ThreadEntry()
+{
+    while ( !m_Shutdown )
+    {
+        m_Wakeup.Wait( CHANGELIST_POLL_INTERVAL_MS );
+
+        if ( m_Shutdown )
+        {
+            break;
+        }
+
+        if ( !m_Provider->IsEnabled() )
+        {
+            continue;
+        }
+
+        std::vector< std::string > batch;
+
+        try
+        {
+            PollLatestChangelist();
+
+            while ( !m_Shutdown )
+            {
+                batch.clear();
+
+                {
+                    Helium::MutexScopeLock mutex ( m_Mutex );
+
+                    size_t count = std::min( m_Queued.size(), MAX_BATCH_SIZE );
+                    batch.assign( m_Queued.begin(), m_Queued.begin() + count );
+                    m_Queued.erase( m_Queued.begin(), m_Queued.begin() + count );
+                }
+
+                if ( batch.empty() )
+                {
+                    break;
+                }
+
+                FetchBatch( batch );
+            }
+        }
+        catch ( const Helium::Exception& ex )
+        {
+            Log::Warning( "Perforce status query failed: %s\n", ex.What() );
+
+            // let these be requested again once the connection recovers
+            Helium::MutexScopeLock mutex ( m_Mutex );
+            for ( std::vector< std::string >::const_iterator itr = batch.begin(), end = batch.end(); itr != end; ++itr )
+            {
+                m_Requested.erase( GetKey( *itr ) );
+            }
+        }
+    }
+}
+
+void StatusCache::FetchBatch( const std::vector< std::string >& paths )
+{
+    RCS::V_File files;
+    BatchFStatCommand command( m_Provider, paths, &files );
+    command.Run();
+
+    Helium::MutexScopeLock mutex ( m_Mutex );
+
+    for ( RCS::V_File::const_iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+    {
+        StoreLocked( *itr );
+        m_Updated.push_back( *itr );
+    }
+
+    for ( std::vector< std::string >::const_iterator itr = paths.begin(), end = paths.end(); itr != end; ++itr )
+    {
+        std::string key = GetKey( *itr );
+        m_Requested.erase( key );
+
+        // fstat doesn't output anything for files that aren't in the depot, remember that too
+        if ( m_Files.find( key ) == m_Files.end() )
+        {
+            RCS::File file;
+            if ( itr->compare( 0, 2, "//" ) == 0 )
+            {
+                file.m_DepotPath = *itr;
+            }
+            else
+            {
+                file.m_LocalPath = *itr;
+            }
+
+            m_Files[ key ] = file;
+            m_Updated.push_back( file );
+        }
+    }
+}
+
+void StatusCache::PollLatestChangelist()
+{
+    {
+        Helium::MutexScopeLock mutex ( m_Mutex );
+
+        // nothing cached to go stale
+        if ( m_Files.empty() && m_LatestChangelist != RCS::InvalidChangesetId )
+        {
+            return;
+        }
+    }
+
+    if ( m_LatestChangelist != RCS::InvalidChangesetId && m_ChangelistTimer.Elapsed() < CHANGELIST_POLL_INTERVAL_MS )
+    {
+        return;
+    }
+
+    m_ChangelistTimer.Reset();
+
+    LatestChangelistCommand command( m_Provider );
+    command.Run();
+
+    uint64_t latest = command.GetChangelist();
+    if ( latest != m_LatestChangelist )
+    {
+        // anything submitted since the cache was filled may have changed head revisions
+        if ( m_LatestChangelist != RCS::InvalidChangesetId )
+        {
+            InvalidateAll();
+        }
+
+        m_LatestChangelist = latest;
+    }
+}
+
+void StatusCache::StoreLocked( const RCS::File& file )
+{
+    if ( !file.m_LocalPath.empty() )
+    {
+        m_Files[ GetKey( file.m_LocalPath ) ] = file;
+    }
+
+    if ( !file.m_DepotPath.empty() )
+    {
+        m_Files[ GetKey( file.m_DepotPath ) ] = file;
+    }
+}
+
+std::string StatusCache::GetKey( const std::string& path )
+{
+    std::string key = path;
+    std::replace( key.begin(), key.end(), '\\', '/' );
+
+#if HELIUM_OS_WIN
+    // local paths (and the depot, on a case insensitive server) can come back in a different case
+    std::transform( key.begin(), key.end(), key.begin(), ::tolower );
+#endif
+
+    return key;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Application/RCS.h"
+#include "Foundation/Event.h"
+#include "Foundation/Profile.h"
+#include "Platform/Condition.h"
+#include "Platform/Thread.h"
+#include "Platform/Locks.h"
+
+#include <map>
+#include <set>
+
+namespace Helium
+{
+    namespace Perforce
+    {
+        class Provider;
+
+        struct StatusUpdateArgs
+        {
+            StatusUpdateArgs( const RCS::V_File& files, bool invalidated )
+                : m_Files( files )
+                , m_Invalidated( invalidated )
+            {
+
+            }
+
+            const RCS::V_File&  m_Files;        // files whose status was fetched since the last update
+            bool                m_Invalidated;  // true if previously reported status may be out of date
+        };
+        typedef Helium::Signature< const StatusUpdateArgs& > StatusUpdateSignature;
+
+        //
+        // Caches fstat results and fetches uncached status in batches on a background thread,
+        //  so browsing folders doesn't block the UI on one perforce transaction per file
+        //
+
+        class StatusCache
+        {
+        public:
+            // most depot paths to pass to a single fstat
+            static const size_t   MAX_BATCH_SIZE = 256;
+
+            // how often to check for newly submitted changelists that make the cache stale
+            static const uint32_t CHANGELIST_POLL_INTERVAL_MS = 30000;
+
+            StatusCache( Provider* provider );
+            ~StatusCache();
+
+            void Initialize();
+            void Cleanup();
+
+            // returns false (and queues a background fetch if requested) if the status isn't cached
+            bool GetStatus( const std::string& path, RCS::File& file, bool request = false );
+            void RequestStatus( const std::string& path );
+            void RequestStatus( const std::vector< std::string >& paths );
+
+            void Store( const RCS::File& file );
+            void Invalidate( const RCS::File& file );
+            void InvalidateAll();
+
+            // raises e_StatusUpdated in the calling (UI) thread for status fetched in the background
+            void Sync();
+            bool HasPendingUpdates();
+
+            StatusUpdateSignature::Event e_StatusUpdated;
+
+        private:
+            void ThreadEntry();
+            void FetchBatch( const std::vector< std::string >& paths );
+            void PollLatestChangelist();
+
+            void StoreLocked( const RCS::File& file );
+            static std::string GetKey( const std::string& path );
+
+            typedef std::map< std::string, RCS::File > M_File;
+
+            Provider*                   m_Provider;
+            M_File                      m_Files;            // cached status, keyed by both local and depot path
+            std::vector< std::string >  m_Queued;           // paths waiting for the next batch
+            std::set< std::string >     m_Requested;        // keys of queued and in-flight paths
+            RCS::V_File                 m_Updated;          // fetched status not yet raised in the UI thread
+            bool                        m_Invalidated;      // the cache was flushed since the last update
+            uint64_t                    m_LatestChangelist; // latest submitted changelist as of the last poll
+            SimpleTimer                 m_ChangelistTimer;
+
+            Helium::CallbackThread      m_Thread;
+            bool                        m_IsInitialized;
+            bool                        m_Shutdown;
+            Helium::Mutex               m_Mutex;
+            Helium::Condition           m_Wakeup;
+        };
+    }
+}
@@ -28,6 +28,11 @@ void Perforce::Shutdown()
 	}
 }
 
+StatusCache* Perforce::GetStatusCache()
+{
+	return g_InitCount ? &g_Provider.m_StatusCache : NULL;
+}
+
 WaitInterface::~WaitInterface()
 {
 
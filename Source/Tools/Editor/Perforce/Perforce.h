@@ -4,7 +4,12 @@ namespace Helium
 {
     namespace Perforce
     {
+        class StatusCache;
+
         void Startup();
         void Shutdown();
+
+        // NULL unless perforce is started up
+        StatusCache* GetStatusCache();
     }
 }
\ No newline at end of file
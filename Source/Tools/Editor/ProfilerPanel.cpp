@@ -0,0 +1,307 @@
+#include "Precompile.h"
+#include "ProfilerPanel.h"
+
+#include "Platform/Timer.h"
+
+#include "Editor/Dialogs/FileDialog.h"
+
+#include <wx/sizer.h>
+#include <wx/dcbuffer.h>
+#include <wx/msgdlg.h>
+
+using namespace Helium;
+using namespace Helium::Editor;
+
+static const int s_LabelWidth = 120;            // width of the thread names left of the timeline
+static const int s_RowHeight = 16;              // height of a scope
+static const int s_HeaderHeight = 16;           // height of the time scale above the threads
+static const uint32_t s_TimelineMilliseconds = 100;
+static const uint32_t s_GridMilliseconds = 10;
+static const int s_RefreshMilliseconds = 250;
+
+///////////////////////////////////////////////////////////////////////////////
+// Picks a stable color for a scope name, so the same scope reads the same
+//  from frame to frame.
+//
+static wxColour GetScopeColor( const char* name )
+{
+    static const unsigned char s_Palette[][ 3 ] =
+    {
+        { 141, 211, 199 },
+        { 255, 255, 179 },
+        { 190, 186, 218 },
+        { 251, 128, 114 },
+        { 128, 177, 211 },
+        { 253, 180,  98 },
+        { 179, 222, 105 },
+        { 252, 205, 229 },
+    };
+
+    uint32_t hash = 2166136261u;
+    for ( const char* c = name; c && *c; ++c )
+    {
+        hash = ( hash ^ static_cast< unsigned char >( *c ) ) * 16777619u;
+    }
+
+    const unsigned char* color = s_Palette[ hash % HELIUM_ARRAY_COUNT( s_Palette ) ];
+    return wxColour( color[ 0 ], color[ 1 ], color[ 2 ] );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ProfilerPanel::ProfilerPanel( wxWindow* parent, wxWindowID id, const wxPoint& pos, const wxSize& size, long style )
+: wxPanel( parent, id, pos, size, style )
+, m_RecordCheckBox( NULL )
+, m_ExportButton( NULL )
+, m_Timeline( NULL )
+, m_StartTicks( 0 )
+, m_EndTicks( 0 )
+{
+    SetHelpText( "This is the profiler.  While recording, it shows the scopes run by each thread over the last frames." );
+
+    m_RecordCheckBox = new wxCheckBox( this, wxID_ANY, wxT( "Record" ) );
+    m_RecordCheckBox->SetValue( FrameProfiler::IsEnabled() );
+
+    m_ExportButton = new wxButton( this, wxID_ANY, wxT( "Export Trace..." ) );
+
+    // drawn through a buffer, so don't let wx erase the background first
+    m_Timeline = new wxPanel( this, wxID_ANY, wxDefaultPosition, wxSize( 400, 200 ) );
+    m_Timeline->SetBackgroundStyle( wxBG_STYLE_CUSTOM );
+
+    wxBoxSizer* toolbarSizer = new wxBoxSizer( wxHORIZONTAL );
+    toolbarSizer->Add( m_RecordCheckBox, 0, wxALIGN_CENTER_VERTICAL | wxALL, 4 );
+    toolbarSizer->Add( m_ExportButton, 0, wxALIGN_CENTER_VERTICAL | wxALL, 4 );
+
+    wxBoxSizer* sizer = new wxBoxSizer( wxVERTICAL );
+    sizer->Add( toolbarSizer, 0, wxEXPAND );
+    sizer->Add( m_Timeline, 1, wxEXPAND );
+    SetSizer( sizer );
+
+    m_RecordCheckBox->Connect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ProfilerPanel::OnRecord ), NULL, this );
+    m_ExportButton->Connect( wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler( ProfilerPanel::OnExport ), NULL, this );
+    m_Timeline->Connect( wxEVT_PAINT, wxPaintEventHandler( ProfilerPanel::OnTimelinePaint ), NULL, this );
+    m_Timeline->Connect( wxEVT_MOTION, wxMouseEventHandler( ProfilerPanel::OnTimelineMotion ), NULL, this );
+
+    m_RefreshTimer.SetOwner( this );
+    Connect( m_RefreshTimer.GetId(), wxEVT_TIMER, wxTimerEventHandler( ProfilerPanel::OnRefreshTimer ), NULL, this );
+
+    if ( FrameProfiler::IsEnabled() )
+    {
+        m_RefreshTimer.Start( s_RefreshMilliseconds );
+    }
+}
+
+ProfilerPanel::~ProfilerPanel()
+{
+    m_RefreshTimer.Stop();
+    Disconnect( m_RefreshTimer.GetId(), wxEVT_TIMER, wxTimerEventHandler( ProfilerPanel::OnRefreshTimer ), NULL, this );
+
+    m_RecordCheckBox->Disconnect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ProfilerPanel::OnRecord ), NULL, this );
+    m_ExportButton->Disconnect( wxEVT_COMMAND_BUTTON_CLICKED, wxCommandEventHandler( ProfilerPanel::OnExport ), NULL, this );
+    m_Timeline->Disconnect( wxEVT_PAINT, wxPaintEventHandler( ProfilerPanel::OnTimelinePaint ), NULL, this );
+    m_Timeline->Disconnect( wxEVT_MOTION, wxMouseEventHandler( ProfilerPanel::OnTimelineMotion ), NULL, this );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Copies the scopes recorded over the timeline's range and lays out the
+//  thread bands.
+//
+void ProfilerPanel::UpdateEvents()
+{
+    m_EndTicks = Timer::GetTickCount();
+    uint64_t rangeTicks = Timer::GetTicksPerSecond() * s_TimelineMilliseconds / 1000;
+    m_StartTicks = m_EndTicks > rangeTicks ? m_EndTicks - rangeTicks : 0;
+
+    FrameProfiler::GetEvents( m_StartTicks, m_Threads );
+
+    m_ThreadTops.clear();
+    m_ThreadDepths.clear();
+
+    int top = s_HeaderHeight;
+    for ( size_t threadIndex = 0; threadIndex < m_Threads.GetSize(); ++threadIndex )
+    {
+        const DynamicArray< FrameProfiler::Event >& events = m_Threads[ threadIndex ].events;
+
+        uint32_t depth = 1;
+        for ( size_t eventIndex = 0; eventIndex < events.GetSize(); ++eventIndex )
+        {
+            depth = Max( depth, events[ eventIndex ].depth + 1 );
+        }
+
+        m_ThreadTops.push_back( top );
+        m_ThreadDepths.push_back( depth );
+        top += static_cast< int >( depth ) * s_RowHeight + 1;
+    }
+
+    m_Timeline->Refresh();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Finds the scope drawn at the given timeline position, if any.
+//
+const FrameProfiler::Event* ProfilerPanel::HitTest( const wxPoint& point ) const
+{
+    int timelineWidth = m_Timeline->GetClientSize().GetWidth() - s_LabelWidth;
+    if ( timelineWidth <= 0 || m_EndTicks <= m_StartTicks || point.x < s_LabelWidth )
+    {
+        return NULL;
+    }
+
+    uint64_t ticks = m_StartTicks + static_cast< uint64_t >(
+        static_cast< double >( point.x - s_LabelWidth ) / static_cast< double >( timelineWidth ) * static_cast< double >( m_EndTicks - m_StartTicks ) );
+
+    for ( size_t threadIndex = 0; threadIndex < m_Threads.GetSize(); ++threadIndex )
+    {
+        int top = m_ThreadTops[ threadIndex ];
+        if ( point.y < top || point.y >= top + static_cast< int >( m_ThreadDepths[ threadIndex ] ) * s_RowHeight )
+        {
+            continue;
+        }
+
+        uint32_t depth = static_cast< uint32_t >( ( point.y - top ) / s_RowHeight );
+
+        const DynamicArray< FrameProfiler::Event >& events = m_Threads[ threadIndex ].events;
+        for ( size_t eventIndex = 0; eventIndex < events.GetSize(); ++eventIndex )
+        {
+            const FrameProfiler::Event& e = events[ eventIndex ];
+            if ( e.depth == depth && e.startTicks <= ticks && ticks <= e.endTicks )
+            {
+                return &e;
+            }
+        }
+
+        break;
+    }
+
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void ProfilerPanel::OnRecord( wxCommandEvent& event )
+{
+    bool record = m_RecordCheckBox->GetValue();
+    FrameProfiler::SetEnabled( record );
+
+    if ( record )
+    {
+        m_RefreshTimer.Start( s_RefreshMilliseconds );
+    }
+    else
+    {
+        // keep the frames recorded last up for inspection
+        m_RefreshTimer.Stop();
+        UpdateEvents();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void ProfilerPanel::OnExport( wxCommandEvent& event )
+{
+    FileDialog fileDialog( this, "Export Trace", "", "", "Chrome Trace (*.json)|*.json", FileDialogStyles::DefaultSave );
+    if ( fileDialog.ShowModal() != wxID_OK )
+    {
+        return;
+    }
+
+    if ( !FrameProfiler::WriteChromeTrace( FilePath( fileDialog.GetFilePath() ) ) )
+    {
+        wxMessageBox( wxT( "The trace file could not be written." ), wxT( "Error Exporting Trace" ), wxOK );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void ProfilerPanel::OnRefreshTimer( wxTimerEvent& event )
+{
+    // don't copy the buffers while no one is looking
+    if ( IsShownOnScreen() )
+    {
+        UpdateEvents();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void ProfilerPanel::OnTimelinePaint( wxPaintEvent& event )
+{
+    wxAutoBufferedPaintDC dc( m_Timeline );
+    dc.SetBackground( *wxWHITE_BRUSH );
+    dc.Clear();
+
+    wxSize size = m_Timeline->GetClientSize();
+    int timelineWidth = size.GetWidth() - s_LabelWidth;
+    if ( timelineWidth <= 0 || m_EndTicks <= m_StartTicks )
+    {
+        return;
+    }
+
+    double pixelsPerTick = static_cast< double >( timelineWidth ) / static_cast< double >( m_EndTicks - m_StartTicks );
+
+    dc.SetFont( *wxSMALL_FONT );
+    dc.SetTextForeground( *wxBLACK );
+
+    // time scale, counting back from the most recent tick
+    uint64_t gridTicks = Timer::GetTicksPerSecond() * s_GridMilliseconds / 1000;
+    for ( uint32_t i = 0; gridTicks != 0 && i * s_GridMilliseconds <= s_TimelineMilliseconds; ++i )
+    {
+        int x = s_LabelWidth + timelineWidth - static_cast< int >( static_cast< double >( i * gridTicks ) * pixelsPerTick );
+
+        dc.SetPen( *wxLIGHT_GREY_PEN );
+        dc.DrawLine( x, 0, x, size.GetHeight() );
+        dc.DrawText( wxString::Format( wxT( "-%u ms" ), i * s_GridMilliseconds ), x + 2, 1 );
+    }
+
+    for ( size_t threadIndex = 0; threadIndex < m_Threads.GetSize(); ++threadIndex )
+    {
+        const FrameProfiler::ThreadEvents& thread = m_Threads[ threadIndex ];
+        int top = m_ThreadTops[ threadIndex ];
+
+        dc.SetPen( *wxLIGHT_GREY_PEN );
+        dc.DrawLine( 0, top - 1, size.GetWidth(), top - 1 );
+
+        wxString label = thread.pThreadName ? wxString( thread.pThreadName ) : wxString::Format( wxT( "Thread %u" ), thread.threadIndex );
+        dc.SetClippingRegion( 0, top, s_LabelWidth - 2, s_RowHeight );
+        dc.DrawText( label, 2, top + 1 );
+        dc.DestroyClippingRegion();
+
+        dc.SetPen( *wxGREY_PEN );
+        for ( size_t eventIndex = 0; eventIndex < thread.events.GetSize(); ++eventIndex )
+        {
+            const FrameProfiler::Event& e = thread.events[ eventIndex ];
+
+            double start = ( static_cast< double >( e.startTicks ) - static_cast< double >( m_StartTicks ) ) * pixelsPerTick;
+            double end = static_cast< double >( e.endTicks - m_StartTicks ) * pixelsPerTick;
+
+            int x0 = s_LabelWidth + static_cast< int >( Max( start, 0.0 ) );
+            int x1 = s_LabelWidth + static_cast< int >( Min( end, static_cast< double >( timelineWidth ) ) );
+            int y = top + static_cast< int >( e.depth ) * s_RowHeight;
+
+            // always draw at least a sliver, so short scopes are still visible
+            wxRect rect( x0, y, Max( x1 - x0, 1 ), s_RowHeight - 1 );
+
+            dc.SetBrush( wxBrush( GetScopeColor( e.pName ) ) );
+            dc.DrawRectangle( rect );
+
+            if ( rect.GetWidth() > 20 && e.pName )
+            {
+                dc.SetClippingRegion( rect );
+                dc.DrawText( e.pName, rect.GetX() + 2, rect.GetY() + 1 );
+                dc.DestroyClippingRegion();
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void ProfilerPanel::OnTimelineMotion( wxMouseEvent& event )
+{
+    event.Skip();
+
+    const FrameProfiler::Event* e = HitTest( event.GetPosition() );
+    if ( e )
+    {
+        float64_t milliseconds = static_cast< float64_t >( e->endTicks - e->startTicks ) * Timer::GetSecondsPerTick() * 1000.0;
+        m_Timeline->SetToolTip( wxString::Format( wxT( "%s: %.3f ms" ), e->pName ? e->pName : "", milliseconds ) );
+    }
+    else
+    {
+        m_Timeline->UnsetToolTip();
+    }
+}
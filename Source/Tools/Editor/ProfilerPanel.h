@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Foundation/DynamicArray.h"
+
+#include "Engine/FrameProfiler.h"
+
+#include <wx/panel.h>
+#include <wx/checkbox.h>
+#include <wx/button.h>
+#include <wx/timer.h>
+
+namespace Helium
+{
+    namespace Editor
+    {
+        ///////////////////////////////////////////////////////////////////////
+        /// class ProfilerPanel
+        //
+        // Live timeline of the scopes recorded by the frame profiler, with one
+        //  band per thread and one row per scope depth.  The timeline shows the
+        //  most recent frames while recording; once recording is stopped it
+        //  keeps the last frames recorded so they can be inspected (hovering a
+        //  scope shows its name and duration) or exported as a Chrome trace.
+        //
+        class ProfilerPanel : public wxPanel
+        {
+        public:
+            ProfilerPanel( wxWindow* parent, wxWindowID id = wxID_ANY, const wxPoint& pos = wxDefaultPosition, const wxSize& size = wxDefaultSize, long style = wxTAB_TRAVERSAL );
+            virtual ~ProfilerPanel();
+
+        private:
+            void UpdateEvents();
+            const FrameProfiler::Event* HitTest( const wxPoint& point ) const;
+
+            void OnRecord( wxCommandEvent& event );
+            void OnExport( wxCommandEvent& event );
+            void OnRefreshTimer( wxTimerEvent& event );
+            void OnTimelinePaint( wxPaintEvent& event );
+            void OnTimelineMotion( wxMouseEvent& event );
+
+        private:
+            wxCheckBox*                                 m_RecordCheckBox;
+            wxButton*                                   m_ExportButton;
+            wxPanel*                                    m_Timeline;
+            wxTimer                                     m_RefreshTimer;
+
+            DynamicArray< FrameProfiler::ThreadEvents > m_Threads;
+            std::vector< int >                          m_ThreadTops;       // y coordinate of each thread's band
+            std::vector< uint32_t >                     m_ThreadDepths;     // number of scope rows in each thread's band
+            uint64_t                                    m_StartTicks;       // tick count at the left of the timeline
+            uint64_t                                    m_EndTicks;         // tick count at the right of the timeline
+        };
+    }
+}
@@ -96,6 +96,7 @@ ProjectPanel::ProjectPanel( wxWindow *parent, DocumentManager* documentManager )
 
 	SetExtraStyle( GetExtraStyle() | wxWS_EX_PROCESS_UI_UPDATES );
 	Connect( wxEVT_UPDATE_UI, wxUpdateUIEventHandler( ProjectPanel::OnUpdateUI ), NULL, this );
+	Connect( wxEVT_IDLE, wxIdleEventHandler( ProjectPanel::OnIdle ), NULL, this );
 
 	wxGetApp().GetSettingsManager()->GetSettings< EditorSettings >()->e_Changed.Add( Reflect::ObjectChangeSignature::Delegate( this, &ProjectPanel::GeneralSettingsChanged ) );
 }
@@ -115,6 +116,7 @@ ProjectPanel::~ProjectPanel()
 	Disconnect( wxEVT_CONTEXT_MENU, wxContextMenuEventHandler( ProjectPanel::OnContextMenu ), NULL, this );
 
 	Disconnect( wxEVT_UPDATE_UI, wxUpdateUIEventHandler( ProjectPanel::OnUpdateUI ), NULL, this );
+	Disconnect( wxEVT_IDLE, wxIdleEventHandler( ProjectPanel::OnIdle ), NULL, this );
 
 	wxGetApp().GetSettingsManager()->GetSettings< EditorSettings >()->e_Changed.Remove( Reflect::ObjectChangeSignature::Delegate( this, &ProjectPanel::GeneralSettingsChanged ) );
 }
@@ -217,7 +219,7 @@ void ProjectPanel::OnActivateItem( wxDataViewEvent& event )
 	// Temporary: Just populate the properties window
 	if (event.GetItem().IsOk())
 	{
-		Asset *pAsset = static_cast< Asset* >( event.GetItem().GetID() );
+		Asset *pAsset = m_Model->GetAsset( event.GetItem() );
 
 		if (HELIUM_VERIFY(pAsset))
 		{
@@ -254,6 +256,17 @@ void ProjectPanel::OnActivateItem( wxDataViewEvent& event )
 
 }
 
+void ProjectPanel::OnIdle( wxIdleEvent& event )
+{
+	// send the tree changes from this tick's asset events in one batch
+	if ( m_Model )
+	{
+		m_Model->FlushPendingItems();
+	}
+
+	event.Skip();
+}
+
 void ProjectPanel::OnUpdateUI( wxUpdateUIEvent& event )
 {
 	if ( !m_RecentProjectsPanel->IsShown() )
@@ -392,7 +405,7 @@ void ProjectPanel::OnLoadForEdit( wxCommandEvent& event )
 
 	for (int i = 0; i < numSelected; ++i)
 	{
-		Asset *pAsset = static_cast<Asset *>( selection[i].GetID() );
+		Asset *pAsset = m_Model->GetAsset( selection[i] );
 
 		if (pAsset && pAsset->IsPackage())
 		{
@@ -406,16 +419,26 @@ void ProjectPanel::OnSave( wxCommandEvent& event )
 	wxDataViewItemArray selection;
 	int numSelected = m_DataViewCtrl->GetSelections( selection );
 
+	std::vector< AssetPtr > assets;
 	for (int i = 0; i < numSelected; ++i)
 	{
-		Asset *pAsset = static_cast<Asset *>( selection[i].GetID() );
-		Package *pPackage = pAsset->GetOwningPackage();
-		HELIUM_ASSERT( pPackage );
+		Asset *pAsset = m_Model->GetAsset( selection[i] );
+		if ( !pAsset )
+		{
+			// not loaded, so nothing to save
+			continue;
+		}
 
-		PackageLoader *pPackageLoader = pPackage->GetLoader();
-		HELIUM_ASSERT( pPackageLoader );
+		HELIUM_ASSERT( pAsset->GetOwningPackage() );
+		HELIUM_ASSERT( pAsset->GetOwningPackage()->GetLoader() );
 
-		pPackageLoader->SaveAsset( pAsset );
+		assets.push_back( pAsset );
+	}
+
+	std::string error;
+	if ( !wxGetApp().GetFrame()->SaveAssets( assets, error ) )
+	{
+		wxMessageBox( error.c_str(), wxT( "Error Saving" ), wxCENTER | wxICON_ERROR | wxOK, this );
 	}
 }
 
@@ -39,6 +39,7 @@ namespace Helium
             virtual void OnActivateItem( wxDataViewEvent& event );
 
             virtual void OnUpdateUI( wxUpdateUIEvent& event );
+            void OnIdle( wxIdleEvent& event );
 
             void OnAddItems( wxCommandEvent& event );
 			void OnDeleteItems( wxCommandEvent& event );
@@ -76,8 +76,18 @@ const wxArtID ProjectViewModel::DefaultFileIcon = ArtIDs::FileSystem::File;
 //}
 //
 
+///////////////////////////////////////////////////////////////////////////////
+ProjectViewModelNode::ProjectViewModelNode( ProjectViewModelNode* parent, const AssetPath& path, const Name& typeName )
+	: m_Parent( parent )
+	, m_Path( path )
+	, m_TypeName( typeName )
+	, m_ChildrenEnumerated( false )
+{
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ProjectViewModel::ProjectViewModel( DocumentManager* documentManager )
+	: m_RootNode( NULL )
 {
 	m_FileIconExtensionLookup.insert( M_FileIconExtensionLookup::value_type( "bin", ArtIDs::MimeTypes::Binary ) );
 	m_FileIconExtensionLookup.insert( M_FileIconExtensionLookup::value_type( "dat",ArtIDs::MimeTypes::Binary ) );
@@ -90,6 +100,8 @@ ProjectViewModel::ProjectViewModel( DocumentManager* documentManager )
 
 ProjectViewModel::~ProjectViewModel()
 {
+	DeleteNodes();
+
 	m_FileIconExtensionLookup.clear();
 }
 
@@ -283,17 +295,26 @@ bool ProjectViewModel::OpenProject( const FilePath& project )
 	m_Engine.Initialize( &wxGetApp().GetFrame()->GetSceneManager(), NULL );
 #endif
 
-	ForciblyFullyLoadedPackageManager::GetInstance()->e_AssetForciblyLoadedEvent.AddMethod( this, &ProjectViewModel::OnAssetEditable );
+	ForciblyFullyLoadedPackageManager::GetInstance()->e_AssetsForciblyLoadedEvent.AddMethod( this, &ProjectViewModel::OnAssetsEditable );
+
+	// have the control ask for the root packages of the new project
+	Cleared();
 
 	return true;
 }
 
 void ProjectViewModel::CloseProject()
 {
+	// drop the tree before the loaders go away, the control won't ask for
+	//  children again without a project
+	m_CurrentProject.Clear();
+	DeleteNodes();
+	Cleared();
+
 	ForciblyFullyLoadedPackageManager* pPackageManager = ForciblyFullyLoadedPackageManager::GetInstance();
 	if ( pPackageManager )
 	{
-		pPackageManager->e_AssetForciblyLoadedEvent.RemoveMethod( this, &ProjectViewModel::OnAssetEditable );
+		pPackageManager->e_AssetsForciblyLoadedEvent.RemoveMethod( this, &ProjectViewModel::OnAssetsEditable );
 	}
 
 	ThreadSafeAssetTrackerListener* pTrackerListener = ThreadSafeAssetTrackerListener::GetInstance();
@@ -365,7 +386,7 @@ void ProjectViewModel::GetValue( wxVariant& variant, const wxDataViewItem& item,
 		return;
 	}
 
-	Asset *node = static_cast< Asset* >( item.GetID() );
+	ProjectViewModelNode *node = static_cast< ProjectViewModelNode* >( item.GetID() );
 	if ( !node )
 	{
 		return;
@@ -380,7 +401,7 @@ void ProjectViewModel::GetValue( wxVariant& variant, const wxDataViewItem& item,
 		{            
 			uint32_t docStatus = DocumentStatus::Default; //  node->GetDocumentStatus();
 
-			String assetString( *node->GetName() );
+			String assetString( *node->m_Path.GetName() );
 			
 
 			wxString name = *assetString;
@@ -389,7 +410,7 @@ void ProjectViewModel::GetValue( wxVariant& variant, const wxDataViewItem& item,
 				name = wxString( '*' ) + name; 
 			}
 
-			wxBitmap bitmap = wxArtProvider::GetBitmap( GetArtIDFromPath( node->GetPath() ), wxART_OTHER, wxSize(16, 16) );
+			wxBitmap bitmap = wxArtProvider::GetBitmap( GetArtIDFromPath( node->m_Path ), wxART_OTHER, wxSize(16, 16) );
 			if ( docStatus > 0 )
 			{
 				wxImage image = bitmap.ConvertToImage();
@@ -462,9 +483,17 @@ void ProjectViewModel::GetValue( wxVariant& variant, const wxDataViewItem& item,
 		break;
 	case ProjectModelColumns::Type:
 		{
-			const AssetType *pType = node->GetAssetType();
-			HELIUM_ASSERT( pType );
-			variant = std::string( *pType->GetName() );
+			// prefer the loaded asset's type, otherwise use the type from the
+			//  package loader's index rather than loading the asset for it
+			Name typeName = node->m_TypeName;
+
+			Asset *pAsset = Asset::FindObject( node->m_Path );
+			if ( pAsset && pAsset->GetAssetType() )
+			{
+				typeName = pAsset->GetAssetType()->GetName();
+			}
+
+			variant = std::string( typeName.IsEmpty() ? "" : *typeName );
 		}
 		break;
 	}
@@ -528,14 +557,21 @@ bool ProjectViewModel::GetAttr( const wxDataViewItem& item, unsigned int column,
 		return false;
 	}
 
-	Asset *node = static_cast< Asset* >( item.GetID() );
+	ProjectViewModelNode *node = static_cast< ProjectViewModelNode* >( item.GetID() );
 	HELIUM_ASSERT( node );
 
 	// bold the entry if the node is active
-	attr.SetBold( node->IsPackage() );
+	attr.SetBold( node->m_Path.IsPackage() );
 
+	Asset *pAsset = Asset::FindObject( node->m_Path );
+	if ( !pAsset )
+	{
+		// not loaded yet
+		attr.SetColour( *wxLIGHT_GREY );
+		return true;
+	}
 	
-	if ( node->GetAllFlagsSet( Asset::FLAG_EDITOR_FORCIBLY_LOADED ) )
+	if ( pAsset->GetAllFlagsSet( Asset::FLAG_EDITOR_FORCIBLY_LOADED ) )
 	{
 		attr.SetColour( *wxBLACK );
 	}
@@ -546,9 +582,9 @@ bool ProjectViewModel::GetAttr( const wxDataViewItem& item, unsigned int column,
 	
 
 	// italicize the entry if it is modified
-	attr.SetItalic( node->GetAllFlagsSet( Asset::FLAG_CHANGED_SINCE_LOADED ) );
+	attr.SetItalic( pAsset->GetAllFlagsSet( Asset::FLAG_CHANGED_SINCE_LOADED ) );
 
-	if ( node->GetAllFlagsSet( Asset::FLAG_CHANGED_SINCE_LOADED ) )
+	if ( pAsset->GetAllFlagsSet( Asset::FLAG_CHANGED_SINCE_LOADED ) )
 	{
 		attr.SetColour( *wxRED );
 	}
@@ -558,45 +594,50 @@ bool ProjectViewModel::GetAttr( const wxDataViewItem& item, unsigned int column,
 
 wxDataViewItem ProjectViewModel::GetParent( const wxDataViewItem& item ) const
 {
-	Asset *node = static_cast< Asset* >( item.GetID() );
+	ProjectViewModelNode *node = static_cast< ProjectViewModelNode* >( item.GetID() );
+	if ( !node || node->m_Parent == m_RootNode )
+	{
+		return wxDataViewItem( NULL );
+	}
 
-	return wxDataViewItem( node->GetOwner() );
+	return wxDataViewItem( node->m_Parent );
 }
 
 unsigned int ProjectViewModel::GetChildren( const wxDataViewItem& item, wxDataViewItemArray& items ) const
 {
-	int count = 0;
-	Asset *pAsset = NULL;
-
-	if (!item.IsOk())
+	if ( m_CurrentProject.Empty() )
 	{
-		ForciblyFullyLoadedPackageManager::GetInstance()->ForceFullyLoadRootPackages();
-		pAsset = Asset::GetFirstTopLevelAsset();
+		return 0;
 	}
-	else
-	{
-		Asset* pParentAsset = static_cast< Asset* >( item.GetID() );
 
-		if ( pParentAsset->IsPackage() )
+	ProjectViewModelNode *node = NULL;
+	if ( !item.IsOk() )
+	{
+		if ( !m_RootNode )
 		{
-			ForciblyFullyLoadedPackageManager::GetInstance()->ForceFullyLoadPackage( pParentAsset->GetPath() );
+			m_RootNode = new ProjectViewModelNode( NULL, AssetPath(), Name( NULL_NAME ) );
 		}
 
-		pAsset = pParentAsset->GetFirstChild();
+		node = m_RootNode;
+	}
+	else
+	{
+		node = static_cast< ProjectViewModelNode* >( item.GetID() );
 	}
 
-	while (pAsset)
+	// the control only asks for the children of expanded nodes, so this is
+	//  where the packages get enumerated
+	if ( !node->m_ChildrenEnumerated )
 	{
-		//if ( m_AssetsInTree.Insert( pAsset ).Second() )
-		{
-			items.Add( wxDataViewItem( pAsset ) );
-			++count;
-		}
+		EnumerateChildren( node );
+	}
 
-		pAsset = pAsset->GetNextSibling();
+	for ( std::vector< ProjectViewModelNode* >::const_iterator itr = node->m_Children.begin(), end = node->m_Children.end(); itr != end; ++itr )
+	{
+		items.Add( wxDataViewItem( *itr ) );
 	}
 
-	return count;
+	return static_cast< unsigned int >( node->m_Children.size() );
 }
 
 bool ProjectViewModel::IsContainer( const wxDataViewItem& item ) const
@@ -607,8 +648,102 @@ bool ProjectViewModel::IsContainer( const wxDataViewItem& item ) const
 		return true;
 	}
 
-	AssetPath *node = static_cast< AssetPath* >( item.GetID() );
-	return node ? node->IsPackage() : false;
+	ProjectViewModelNode *node = static_cast< ProjectViewModelNode* >( item.GetID() );
+	return node ? node->m_Path.IsPackage() : false;
+}
+
+Asset* ProjectViewModel::GetAsset( const wxDataViewItem& item ) const
+{
+	ProjectViewModelNode *node = static_cast< ProjectViewModelNode* >( item.GetID() );
+	return node ? Asset::FindObject( node->m_Path ) : NULL;
+}
+
+ProjectViewModelNode* ProjectViewModel::FindNode( const AssetPath& path ) const
+{
+	HashMap< AssetPath, ProjectViewModelNode* >::ConstIterator found = m_Nodes.Find( path );
+	return found != m_Nodes.End() ? found->Second() : NULL;
+}
+
+ProjectViewModelNode* ProjectViewModel::AddNode( ProjectViewModelNode* parent, const AssetPath& path, const Name& typeName ) const
+{
+	HELIUM_ASSERT( parent );
+
+	ProjectViewModelNode* node = new ProjectViewModelNode( parent, path, typeName );
+	parent->m_Children.push_back( node );
+
+	HashMap< AssetPath, ProjectViewModelNode* >::Iterator found;
+	m_Nodes.Insert( found, HashMap< AssetPath, ProjectViewModelNode* >::ValueType( path, node ) );
+
+	return node;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Lists the children of a node from the package loader, without loading any
+// of the child assets.  Only the package itself has to be loaded to get at
+// its loader.
+//
+void ProjectViewModel::EnumerateChildren( ProjectViewModelNode* node ) const
+{
+	node->m_ChildrenEnumerated = true;
+
+	DynamicArray< AssetPath > childPaths;
+	PackageLoader *pLoader = NULL;
+
+	if ( node == m_RootNode )
+	{
+		AssetLoader::GetInstance()->EnumerateRootPackages( childPaths );
+	}
+	else
+	{
+		AssetLoader::GetInstance()->LoadObject( node->m_Path, node->m_Package );
+		if ( !node->m_Package || !node->m_Package->GetLoader() )
+		{
+			HELIUM_TRACE(
+				TraceLevels::Warning,
+				"ProjectViewModel::EnumerateChildren(): Failed to load package '%s'.\n",
+				*node->m_Path.ToString());
+
+			return;
+		}
+
+		pLoader = node->m_Package->GetLoader();
+		pLoader->EnumerateChildren( childPaths );
+	}
+
+	node->m_Children.reserve( childPaths.GetSize() );
+
+	for ( DynamicArray< AssetPath >::ConstIterator iter = childPaths.Begin(); iter != childPaths.End(); ++iter )
+	{
+		// may have been added already by an asset event
+		if ( FindNode( *iter ) )
+		{
+			continue;
+		}
+
+		Name typeName( NULL_NAME );
+		if ( pLoader && !iter->IsPackage() )
+		{
+			typeName = pLoader->GetAssetTypeName( *iter );
+		}
+
+		AddNode( node, *iter, typeName );
+	}
+}
+
+void ProjectViewModel::DeleteNodes()
+{
+	for ( HashMap< AssetPath, ProjectViewModelNode* >::Iterator iter = m_Nodes.Begin(); iter != m_Nodes.End(); ++iter )
+	{
+		delete iter->Second();
+	}
+
+	m_Nodes.Clear();
+
+	delete m_RootNode;
+	m_RootNode = NULL;
+
+	m_PendingAddedItems.clear();
+	m_PendingChangedNodes.clear();
 }
 
 const wxArtID& ProjectViewModel::GetArtIDFromPath( const AssetPath& path ) const
@@ -639,56 +774,77 @@ const wxArtID& ProjectViewModel::GetArtIDFromPath( const AssetPath& path ) const
 	return DefaultFileIcon;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Asset events come in bursts (a package being loaded for edit raises one per
+// child), so they only queue up the changes to the tree, which are sent to the
+// control by FlushPendingItems().
+//
 void Helium::Editor::ProjectViewModel::OnAssetLoaded( const AssetEventArgs& args )
 {
-	HELIUM_TRACE(
-		TraceLevels::Info,
-		"Asset '%s' now editable\n",
-		*args.m_Asset->GetPath().ToString());
-
-	if (args.m_Asset->GetOwner())
+	if ( FindNode( args.m_Asset->GetPath() ) )
 	{
-		// If we are not in the tree
-		if ( m_AssetsInTree.Find(args.m_Asset) == m_AssetsInTree.End() )
-		{
-			HELIUM_TRACE(
-				TraceLevels::Info,
-				"Adding item %x '%s'\n", 
-				args.m_Asset, 
-				*args.m_Asset->GetPath().ToString());
+		QueueChanged( args.m_Asset->GetPath() );
+		return;
+	}
 
-			if ( ForciblyFullyLoadedPackageManager::GetInstance()->IsPackageForcedFullyLoaded( args.m_Asset->GetOwner()->GetPath() ) )
-			//if ( m_AssetsInTree.Find( args.m_Asset->GetOwner() ) != m_AssetsInTree.End() )
-			{
-				//m_AssetsInTree.Insert( args.m_Asset );
-				ItemAdded( wxDataViewItem( args.m_Asset->GetOwner() ), wxDataViewItem( args.m_Asset ) );
-			}
-		}
-		else
-		{
-			HELIUM_TRACE(
-				TraceLevels::Info,
-				"Changing item %x '%s'\n", 
-				args.m_Asset, 
-				*args.m_Asset->GetPath().ToString());
+	// a new asset only needs a node if its parent has been enumerated,
+	//  otherwise it'll be listed when the parent is expanded
+	ProjectViewModelNode* parent = args.m_Asset->GetOwner() ? FindNode( args.m_Asset->GetOwner()->GetPath() ) : m_RootNode;
+	if ( parent && parent->m_ChildrenEnumerated )
+	{
+		const AssetType *pType = args.m_Asset->GetAssetType();
 
-			ItemChanged( wxDataViewItem( args.m_Asset ) );
-		}
+		ProjectViewModelNode* node = AddNode( parent, args.m_Asset->GetPath(), pType ? pType->GetName() : Name( NULL_NAME ) );
+		m_PendingAddedItems[ parent ].Add( wxDataViewItem( node ) );
 	}
 }
 
-void Helium::Editor::ProjectViewModel::OnAssetEditable( const AssetEventArgs& args )
+void Helium::Editor::ProjectViewModel::OnAssetsEditable( const AssetsForciblyLoadedEventArgs& args )
 {
-	if ( m_AssetsInTree.Find(args.m_Asset) != m_AssetsInTree.End() )
+	for ( size_t i = 0; i < args.m_Assets.GetSize(); ++i )
 	{
-		ItemChanged( wxDataViewItem( args.m_Asset ) );
+		QueueChanged( args.m_Assets[ i ]->GetPath() );
 	}
 }
 
 void Helium::Editor::ProjectViewModel::OnAssetChanged( const AssetEventArgs& args )
 {
-	if ( m_AssetsInTree.Find(args.m_Asset) != m_AssetsInTree.End() )
+	QueueChanged( args.m_Asset->GetPath() );
+}
+
+void ProjectViewModel::QueueChanged( const AssetPath& path )
+{
+	ProjectViewModelNode* node = FindNode( path );
+	if ( node )
 	{
-		ItemChanged( wxDataViewItem( args.m_Asset ) );
+		m_PendingChangedNodes.insert( node );
 	}
-}
\ No newline at end of file
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Called once per UI tick.
+//
+void ProjectViewModel::FlushPendingItems()
+{
+	for ( M_PendingAddedItems::const_iterator itr = m_PendingAddedItems.begin(), end = m_PendingAddedItems.end(); itr != end; ++itr )
+	{
+		ItemsAdded( wxDataViewItem( itr->first == m_RootNode ? NULL : itr->first ), itr->second );
+	}
+
+	m_PendingAddedItems.clear();
+
+	if ( !m_PendingChangedNodes.empty() )
+	{
+		wxDataViewItemArray items;
+		items.Alloc( m_PendingChangedNodes.size() );
+
+		for ( std::set< ProjectViewModelNode* >::const_iterator itr = m_PendingChangedNodes.begin(), end = m_PendingChangedNodes.end(); itr != end; ++itr )
+		{
+			items.Add( wxDataViewItem( *itr ) );
+		}
+
+		m_PendingChangedNodes.clear();
+
+		ItemsChanged( items );
+	}
+}
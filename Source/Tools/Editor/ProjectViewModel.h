@@ -76,6 +76,26 @@ namespace Helium
 		}
 		typedef ProjectModelColumns::ProjectModelColumn ProjectModelColumn;
 
+		///////////////////////////////////////////////////////////////////////
+		// An asset path in the project tree.  Nodes are made from the package
+		//  loaders' indices, so assets don't have to be loaded to be listed,
+		//  and a package's children are only enumerated once it's expanded.
+		//
+		class ProjectViewModelNode
+		{
+		public:
+			ProjectViewModelNode( ProjectViewModelNode* parent, const AssetPath& path, const Name& typeName );
+
+			ProjectViewModelNode* m_Parent;
+			AssetPath m_Path;
+			Name m_TypeName;
+			std::vector< ProjectViewModelNode* > m_Children;
+			bool m_ChildrenEnumerated;
+
+			// keeps enumerated packages (and their loaders) around
+			PackagePtr m_Package;
+		};
+
 		///////////////////////////////////////////////////////////////////////
 		class ProjectViewModel : public wxDataViewModel
 		{
@@ -101,9 +121,15 @@ namespace Helium
 			void OnPathRemoved( const Helium::AssetPath& path );
 
 			void OnAssetLoaded( const AssetEventArgs& args );
-			void OnAssetEditable( const AssetEventArgs& args );
+			void OnAssetsEditable( const AssetsForciblyLoadedEventArgs& args );
 			void OnAssetChanged( const AssetEventArgs& args );
 
+			// Sends the tree changes queued up by the asset events since the
+			// last call to the control, in one batch
+			void FlushPendingItems();
+
+			Asset* GetAsset( const wxDataViewItem& item ) const;
+
 		public:
 			// wxDataViewModel pure virtual interface
 			virtual unsigned int GetColumnCount() const override;
@@ -126,7 +152,19 @@ namespace Helium
 			EditorEngine m_Engine;
 			SystemDefinitionPtr m_pEditorSystemDefinition;
 
-			mutable Set< Asset* > m_AssetsInTree;
+			ProjectViewModelNode* FindNode( const AssetPath& path ) const;
+			ProjectViewModelNode* AddNode( ProjectViewModelNode* parent, const AssetPath& path, const Name& typeName ) const;
+			void EnumerateChildren( ProjectViewModelNode* node ) const;
+			void DeleteNodes();
+			void QueueChanged( const AssetPath& path );
+
+			// nodes are created as the control asks for children
+			mutable ProjectViewModelNode* m_RootNode;
+			mutable HashMap< AssetPath, ProjectViewModelNode* > m_Nodes;
+
+			typedef std::map< ProjectViewModelNode*, wxDataViewItemArray > M_PendingAddedItems;
+			M_PendingAddedItems m_PendingAddedItems;
+			std::set< ProjectViewModelNode* > m_PendingChangedNodes;
 
 			typedef std::vector< uint32_t > M_ColumnLookupTable;
 			M_ColumnLookupTable m_ColumnLookupTable;
@@ -28,6 +28,7 @@ SceneOutliner::SceneOutliner( Editor::SceneManager* sceneManager )
 	, m_TreeCtrl( NULL )
 	, m_IgnoreSelectionChange( false )
 	, m_DisplayCounts( false )
+	, m_PendingSort( false )
 {
 	m_SceneManager->e_CurrentSceneChanged.Add( Editor::SceneChangeSignature::Delegate::Create<SceneOutliner, void (SceneOutliner::*)( const Editor::SceneChangeArgs& args )> ( this, &SceneOutliner::CurrentSceneChanged ) );
 }
@@ -178,12 +179,65 @@ void SceneOutliner::Sort( const wxTreeItemId& root )
 	m_TreeCtrl->Sort( root );
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Applies the tree changes queued up since the last idle in one batch, under
+// a single Freeze/Thaw and followed by a single sort, instead of updating and
+// re-sorting the tree for every node event.
+// 
+void SceneOutliner::FlushPendingChanges()
+{
+	VERIFY_TREE_CTRL();
+
+	if ( !HasPendingChanges() )
+	{
+		return;
+	}
+
+	HELIUM_EDITOR_SCOPE_TIMER( "" );
+
+	m_TreeCtrl->Freeze();
+	bool isSortingEnabled = m_TreeCtrl->IsSortingEnabled();
+	m_TreeCtrl->DisableSorting();
+
+	ApplyPendingChanges();
+
+	// if sorting has been frozen by the tree monitor, it will sort when thawed
+	m_TreeCtrl->EnableSorting( isSortingEnabled );
+	if ( m_TreeCtrl->IsSortingEnabled() )
+	{
+		Sort( m_TreeCtrl->GetRootItem() );
+	}
+
+	m_PendingSort = false;
+
+	m_TreeCtrl->Thaw();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Returns true if there are changes waiting for FlushPendingChanges().
+// Derived classes that queue their own changes should call the base class.
+// 
+bool SceneOutliner::HasPendingChanges() const
+{
+	return m_PendingSort;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Called by FlushPendingChanges.  Override in derived classes to apply the
+// changes they have queued up.
+// 
+void SceneOutliner::ApplyPendingChanges()
+{
+	// Override in derived classes if you need to do something here.
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Clears out the tree.
 // 
 void SceneOutliner::Clear()
 {
 	m_Items.clear();
+	m_PendingSort = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -425,7 +479,8 @@ void SceneOutliner::SceneNodeNameChanged( const SceneNodeChangeArgs& args )
 		//
 		m_TreeCtrl->SetItemText( item, args.m_Node->GetName().c_str() );
 
-		Sort( m_TreeCtrl->GetItemParent( item ) );
+		// renames come in bursts (renaming many nodes at once), sort once on idle
+		m_PendingSort = true;
 	}
 }
 
@@ -585,6 +640,17 @@ void SceneOutliner::OnDeleted( wxTreeEvent& args )
 	m_Items.erase( object );
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Callback once the tree control has processed its pending events.  Applies
+// the changes that were queued up by scene events in the meantime.
+// 
+void SceneOutliner::OnIdle( wxIdleEvent& args )
+{
+	FlushPendingChanges();
+
+	args.Skip();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Pass shortcut keys up to the main frame/view for handling.
 // 
@@ -638,6 +704,7 @@ void SceneOutliner::ConnectDynamicEventTable()
 		m_TreeCtrl->Connect( m_TreeCtrl->GetId(), wxEVT_COMMAND_TREE_ITEM_COLLAPSED, wxTreeEventHandler( SceneOutliner::OnCollapsed ), NULL, this );
 		m_TreeCtrl->Connect( m_TreeCtrl->GetId(), wxEVT_COMMAND_TREE_DELETE_ITEM, wxTreeEventHandler( SceneOutliner::OnDeleted ), NULL, this );
 		m_TreeCtrl->Connect( m_TreeCtrl->GetId(), wxEVT_CHAR, wxKeyEventHandler( SceneOutliner::OnChar ), NULL, this );
+		m_TreeCtrl->Connect( m_TreeCtrl->GetId(), wxEVT_IDLE, wxIdleEventHandler( SceneOutliner::OnIdle ), NULL, this );
 	}
 }
 
@@ -655,5 +722,6 @@ void SceneOutliner::DisconnectDynamicEventTable()
 		m_TreeCtrl->Disconnect( m_TreeCtrl->GetId(), wxEVT_COMMAND_TREE_ITEM_COLLAPSED, wxTreeEventHandler( SceneOutliner::OnCollapsed ), NULL, this );
 		m_TreeCtrl->Disconnect( m_TreeCtrl->GetId(), wxEVT_COMMAND_TREE_DELETE_ITEM, wxTreeEventHandler( SceneOutliner::OnDeleted ), NULL, this );
 		m_TreeCtrl->Disconnect( m_TreeCtrl->GetId(), wxEVT_CHAR, wxKeyEventHandler( SceneOutliner::OnChar ), NULL, this );
+		m_TreeCtrl->Disconnect( m_TreeCtrl->GetId(), wxEVT_IDLE, wxIdleEventHandler( SceneOutliner::OnIdle ), NULL, this );
 	}
 }
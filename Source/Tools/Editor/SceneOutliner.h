@@ -94,6 +94,7 @@ namespace Helium
             SceneOutlinerState m_StateInfo;
             bool m_IgnoreSelectionChange;
             bool m_DisplayCounts; 
+            bool m_PendingSort;
 
         public:
             // Functions
@@ -110,6 +111,7 @@ namespace Helium
             SceneOutlinerItemData* GetTreeItemData( const wxTreeItemId& item );
             void UpdateCurrentScene( Editor::Scene* scene );
             void DoRestoreState();
+            void FlushPendingChanges();
 
         protected:
             // Derived classes can optionally override these functions
@@ -131,6 +133,11 @@ namespace Helium
             virtual void SceneNodeNameChanged( const Editor::SceneNodeChangeArgs& args );
             void SceneNodeVisibilityChanged( const Editor::SceneNodeChangeArgs& args );
 
+            // Derived classes can queue up tree changes and apply them here, once
+            // per idle, with the tree frozen and sorting disabled
+            virtual bool HasPendingChanges() const;
+            virtual void ApplyPendingChanges();
+
         protected:
             // Derived classes must override these functions
             virtual SortTreeCtrl* CreateTreeCtrl( wxWindow* parent, wxWindowID id ) = 0;
@@ -144,6 +151,7 @@ namespace Helium
             virtual void OnCollapsed( wxTreeEvent& args );
             virtual void OnDeleted( wxTreeEvent& args );
             virtual void OnChar( wxKeyEvent& args );
+            void OnIdle( wxIdleEvent& args );
 
         private:
             // Connect/disconnect dynamic event table for GUI callbacks
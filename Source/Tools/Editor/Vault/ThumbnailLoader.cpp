@@ -1,203 +1,245 @@
-#include "Precompile.h"
-#include "ThumbnailLoader.h"
-
-#include "Foundation/DirectoryIterator.h"
-#include "EditorScene/DeviceManager.h"
-#include "EditorScene/Render.h"
-
-using namespace Helium;
-using namespace Helium::Editor;
-
-void* ThumbnailLoader::LoadThread::Entry()
-{
-#ifdef HELIUM_ASSERT_ENABLED
-	bool emptyQueuePollingCheck = false;
-#endif
-
-	while ( true )
-	{
-		m_Loader.m_Signal.Decrement();
-
-		if ( m_Loader.m_Quit )
-		{
-			break;
-		}
-
-#ifdef VIEWPORT_REFACTOR
-		// the device is gone, our glorious benefactor is probably cleaning up
-		IDirect3DDevice9* device = m_Loader.m_DeviceManager->GetD3DDevice();
-		if ( !device )
-		{
-			// You should stop this thread before letting go of the window that
-			// owns the device.
-			HELIUM_BREAK();
-			break;
-		}
-
-		// while the device is lost, just wait for it to come back
-		while ( device->TestCooperativeLevel() != D3D_OK )
-		{
-			if ( m_Loader.m_Quit )
-			{
-				break;
-			}
-
-			wxThread::Sleep( 100 );
-			continue;
-		}
-#endif
-
-		if ( m_Loader.m_Quit )
-		{
-			break;
-		}
-
-		Helium::FilePath path;
-
-		{
-			Helium::Locker< Helium::OrderedSet< Helium::FilePath > >::Handle queue( m_Loader.m_FileQueue );
-			if ( !queue->Empty() )
-			{
-#ifdef HELIUM_ASSERT_ENABLED
-				emptyQueuePollingCheck = false;
-#endif
-				path = queue->Front();
-			}
-			else
-			{
-				// if you hit this then the bookkeeping of the counting semaphore is broken
-				HELIUM_ASSERT( !emptyQueuePollingCheck );
-
-#ifdef HELIUM_ASSERT_ENABLED
-				emptyQueuePollingCheck = true;
-#endif
-				continue;
-			}
-
-			queue->Remove( path );
-		}
-
-		ResultArgs args;
-		args.m_Path = path;
-		args.m_Cancelled = false;
-
-#ifdef VIEWPORT_REFACTOR
-		if ( Editor::IsSupportedTexture( path.Get() ) )
-		{
-			IDirect3DTexture9* texture = NULL;
-			if ( texture = LoadTexture( device, path.Get() ) )
-			{
-				ThumbnailPtr thumbnail = new Thumbnail( m_Loader.m_DeviceManager, texture );
-				args.m_Textures.push_back( thumbnail );
-			}
-		}
-		else
-#endif
-		{
-			// TODO: When we store the thumbnail in the asset file, fix this
-			if ( path.Extension() == "HeliumEntity" )
-			{
-				FilePath thumbnailPath( path.Directory() + path.Basename() + "_thumbnail.png" );
-
-				if ( thumbnailPath.Exists() )
-				{
-#ifdef VIEWPORT_REFACTOR
-					IDirect3DTexture9* texture = NULL;
-					if ( texture = LoadTexture( device, thumbnailPath.Get() ) )
-					{
-						ThumbnailPtr thumbnail = new Thumbnail( m_Loader.m_DeviceManager, texture );
-						args.m_Textures.push_back( thumbnail );
-					}
-#endif
-				}
-			}
-			// Include the color map of a shader as a possible thumbnail image
-			else if ( path.Extension() == "HeliumShader" )
-			{
-#ifdef VIEWPORT_REFACTOR
-				if ( colorMap->GetContentPath().Exists() && Editor::IsSupportedTexture( colorMap->GetContentPath().Get() ) )
-				{
-					IDirect3DTexture9* texture = NULL;
-					if ( texture = LoadTexture( device, colorMap->GetContentPath().Get() ) )
-					{
-						ThumbnailPtr thumbnail = new Thumbnail( m_Loader.m_DeviceManager, texture );
-						args.m_Textures.push_back( thumbnail );
-					}
-				}
-#endif
-			}
-			else if ( path.Extension() == "HeliumTexture" )
-			{
-#ifdef VIEWPORT_REFACTOR
-				if ( textureAsset->GetContentPath().Exists() && Editor::IsSupportedTexture( textureAsset->GetContentPath().Get() ) )
-				{
-					IDirect3DTexture9* texture = NULL;
-					if ( texture = LoadTexture( device, textureAsset->GetContentPath().Get() ) )
-					{
-						ThumbnailPtr thumbnail = new Thumbnail( m_Loader.m_DeviceManager, texture );
-						args.m_Textures.push_back( thumbnail );
-					}
-				}
-#endif
-			}
-		}
-
-		m_Loader.m_Result.Raise( args );
-	}
-
-	return NULL;
-}
-
-ThumbnailLoader::ThumbnailLoader( DeviceManager* d3dManager )
-	: m_LoadThread( *this )
-	, m_Quit( false )
-	, m_DeviceManager( d3dManager )
-{
-	m_LoadThread.Create();
-	m_LoadThread.Run();
-}
-
-ThumbnailLoader::~ThumbnailLoader()
-{
-	m_Quit = true;
-	m_Signal.Increment();
-	m_LoadThread.Wait();
-}
-
-void ThumbnailLoader::Enqueue( const std::set< Helium::FilePath >& files )
-{
-	Helium::Locker< Helium::OrderedSet< Helium::FilePath > >::Handle queue( m_FileQueue );
-
-	for ( std::set< Helium::FilePath >::const_reverse_iterator itr = files.rbegin(), end = files.rend();
-		itr != end;
-		++itr )
-	{
-		bool signal = !queue->Remove( *itr );
-		queue->Prepend( *itr );
-		if ( signal )
-		{
-			m_Signal.Increment();
-		}
-	}
-}
-
-void ThumbnailLoader::Stop()
-{
-	Helium::Locker< Helium::OrderedSet< Helium::FilePath > >::Handle queue( m_FileQueue );
-	if ( queue->Empty() )
-	{
-		return;
-	}
-
-	while ( !queue->Empty() )
-	{
-		ResultArgs args;
-		args.m_Path = ( queue->Front() );
-		args.m_Cancelled = true;
-		m_Result.Raise( args );
-
-		queue->Remove( queue->Front() );
-	}
-
-	m_Signal.Reset();
+#include "Precompile.h"
+#include "ThumbnailLoader.h"
+
+#include "Foundation/DirectoryIterator.h"
+#include "EditorScene/DeviceManager.h"
+#include "EditorScene/Render.h"
+
+using namespace Helium;
+using namespace Helium::Editor;
+
+// Upper bound on the number of loading threads, as each one competes with the UI thread for the device
+static const uint32_t s_MaxLoadThreads = 4;
+
+void* ThumbnailLoader::LoadThread::Entry()
+{
+	while ( true )
+	{
+		m_Loader.m_Signal.Decrement();
+
+		if ( m_Loader.m_Quit )
+		{
+			break;
+		}
+
+#ifdef VIEWPORT_REFACTOR
+		// the device is gone, our glorious benefactor is probably cleaning up
+		IDirect3DDevice9* device = m_Loader.m_DeviceManager->GetD3DDevice();
+		if ( !device )
+		{
+			// You should stop this thread before letting go of the window that
+			// owns the device.
+			HELIUM_BREAK();
+			break;
+		}
+
+		// while the device is lost, just wait for it to come back
+		while ( device->TestCooperativeLevel() != D3D_OK )
+		{
+			if ( m_Loader.m_Quit )
+			{
+				break;
+			}
+
+			wxThread::Sleep( 100 );
+			continue;
+		}
+#endif
+
+		if ( m_Loader.m_Quit )
+		{
+			break;
+		}
+
+		Helium::FilePath path;
+
+		{
+			Helium::Locker< Helium::OrderedSet< Helium::FilePath > >::Handle queue( m_Loader.m_FileQueue );
+			if ( !queue->Empty() )
+			{
+				path = queue->Front();
+			}
+			else
+			{
+				// files cancelled before they were loaded leave their signal behind, so we can wake up to an empty
+				//  queue; just go back to waiting
+				continue;
+			}
+
+			queue->Remove( path );
+		}
+
+		ResultArgs args;
+		args.m_Path = path;
+		args.m_Cancelled = false;
+
+#ifdef VIEWPORT_REFACTOR
+		if ( Editor::IsSupportedTexture( path.Get() ) )
+		{
+			IDirect3DTexture9* texture = NULL;
+			if ( texture = LoadTexture( device, path.Get() ) )
+			{
+				ThumbnailPtr thumbnail = new Thumbnail( m_Loader.m_DeviceManager, texture );
+				args.m_Textures.push_back( thumbnail );
+			}
+		}
+		else
+#endif
+		{
+			// TODO: When we store the thumbnail in the asset file, fix this
+			if ( path.Extension() == "HeliumEntity" )
+			{
+				FilePath thumbnailPath( path.Directory() + path.Basename() + "_thumbnail.png" );
+
+				if ( thumbnailPath.Exists() )
+				{
+#ifdef VIEWPORT_REFACTOR
+					IDirect3DTexture9* texture = NULL;
+					if ( texture = LoadTexture( device, thumbnailPath.Get() ) )
+					{
+						ThumbnailPtr thumbnail = new Thumbnail( m_Loader.m_DeviceManager, texture );
+						args.m_Textures.push_back( thumbnail );
+					}
+#endif
+				}
+			}
+			// Include the color map of a shader as a possible thumbnail image
+			else if ( path.Extension() == "HeliumShader" )
+			{
+#ifdef VIEWPORT_REFACTOR
+				if ( colorMap->GetContentPath().Exists() && Editor::IsSupportedTexture( colorMap->GetContentPath().Get() ) )
+				{
+					IDirect3DTexture9* texture = NULL;
+					if ( texture = LoadTexture( device, colorMap->GetContentPath().Get() ) )
+					{
+						ThumbnailPtr thumbnail = new Thumbnail( m_Loader.m_DeviceManager, texture );
+						args.m_Textures.push_back( thumbnail );
+					}
+				}
+#endif
+			}
+			else if ( path.Extension() == "HeliumTexture" )
+			{
+#ifdef VIEWPORT_REFACTOR
+				if ( textureAsset->GetContentPath().Exists() && Editor::IsSupportedTexture( textureAsset->GetContentPath().Get() ) )
+				{
+					IDirect3DTexture9* texture = NULL;
+					if ( texture = LoadTexture( device, textureAsset->GetContentPath().Get() ) )
+					{
+						ThumbnailPtr thumbnail = new Thumbnail( m_Loader.m_DeviceManager, texture );
+						args.m_Textures.push_back( thumbnail );
+					}
+				}
+#endif
+			}
+		}
+
+		m_Loader.m_Result.Raise( args );
+	}
+
+	return NULL;
+}
+
+ThumbnailLoader::ThumbnailLoader( DeviceManager* d3dManager )
+	: m_Quit( false )
+	, m_DeviceManager( d3dManager )
+{
+	// leave a core for the UI thread
+	int cpuCount = wxThread::GetCPUCount();
+	uint32_t threadCount = cpuCount > 2 ? static_cast< uint32_t >( cpuCount - 1 ) : 1;
+	if ( threadCount > s_MaxLoadThreads )
+	{
+		threadCount = s_MaxLoadThreads;
+	}
+
+	for ( uint32_t i = 0; i < threadCount; ++i )
+	{
+		LoadThread* thread = new LoadThread( *this );
+		if ( thread->Create() != wxTHREAD_NO_ERROR || thread->Run() != wxTHREAD_NO_ERROR )
+		{
+			delete thread;
+			break;
+		}
+
+		m_LoadThreads.push_back( thread );
+	}
+
+	HELIUM_ASSERT( !m_LoadThreads.empty() );
+}
+
+ThumbnailLoader::~ThumbnailLoader()
+{
+	m_Quit = true;
+
+	for ( std::vector< LoadThread* >::const_iterator itr = m_LoadThreads.begin(), end = m_LoadThreads.end();
+		itr != end;
+		++itr )
+	{
+		m_Signal.Increment();
+	}
+
+	for ( std::vector< LoadThread* >::const_iterator itr = m_LoadThreads.begin(), end = m_LoadThreads.end();
+		itr != end;
+		++itr )
+	{
+		(*itr)->Wait();
+		delete *itr;
+	}
+
+	m_LoadThreads.clear();
+}
+
+void ThumbnailLoader::Enqueue( const std::set< Helium::FilePath >& files )
+{
+	Helium::Locker< Helium::OrderedSet< Helium::FilePath > >::Handle queue( m_FileQueue );
+
+	for ( std::set< Helium::FilePath >::const_reverse_iterator itr = files.rbegin(), end = files.rend();
+		itr != end;
+		++itr )
+	{
+		bool signal = !queue->Remove( *itr );
+		queue->Prepend( *itr );
+		if ( signal )
+		{
+			m_Signal.Increment();
+		}
+	}
+}
+
+void ThumbnailLoader::Cancel( const std::set< Helium::FilePath >& files )
+{
+	Helium::Locker< Helium::OrderedSet< Helium::FilePath > >::Handle queue( m_FileQueue );
+
+	// files that a thread has already started loading are not in the queue anymore, and will still report their result
+	for ( std::set< Helium::FilePath >::const_iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+	{
+		if ( queue->Remove( *itr ) )
+		{
+			ResultArgs args;
+			args.m_Path = *itr;
+			args.m_Cancelled = true;
+			m_Result.Raise( args );
+		}
+	}
+}
+
+void ThumbnailLoader::Stop()
+{
+	Helium::Locker< Helium::OrderedSet< Helium::FilePath > >::Handle queue( m_FileQueue );
+	if ( queue->Empty() )
+	{
+		return;
+	}
+
+	while ( !queue->Empty() )
+	{
+		ResultArgs args;
+		args.m_Path = ( queue->Front() );
+		args.m_Cancelled = true;
+		m_Result.Raise( args );
+
+		queue->Remove( queue->Front() );
+	}
+
+	m_Signal.Reset();
 }
\ No newline at end of file
@@ -15,6 +15,8 @@
 #include "Editor/DragDrop/DropSource.h"
 #include "Editor/ArtProvider.h"
 
+#include <algorithm>
+#include <iterator>
 #include <wx/dnd.h>
 
 #if HELIUM_OS_WIN
@@ -223,6 +225,7 @@ void ThumbnailView::SetResults( VaultSearchResults* results )
 		m_MouseOverTiles.Clear();
 		m_SelectedTiles.Clear();
 		m_CurrentTextureRequests.clear();
+		m_PendingTextureRequests.clear();
 
 		m_VisibleTileCorners.clear();
 		m_HighlighedTileCorners.clear();
@@ -1211,7 +1214,20 @@ bool ThumbnailView::Draw()
 		DrawTileFileType( device, tileCorners, thumbnail );
 	}
 
-	// Request some textures to be loaded
+	// Cancel the requests for tiles that scrolled out of view before their thumbnails were loaded, so they don't hold
+	//  up the tiles that are visible now; they are requested again if they come back into view
+	std::set< Helium::FilePath > cancelledRequests;
+	std::set_difference(
+		m_PendingTextureRequests.begin(), m_PendingTextureRequests.end(),
+		m_CurrentTextureRequests.begin(), m_CurrentTextureRequests.end(),
+		std::inserter( cancelledRequests, cancelledRequests.end() ) );
+	if ( !cancelledRequests.empty() )
+	{
+		m_ThumbnailManager->Cancel( cancelledRequests );
+	}
+
+	// Request some textures to be loaded, the visible ones are loaded ahead of anything requested earlier
+	m_PendingTextureRequests = m_CurrentTextureRequests;
 	if ( !m_CurrentTextureRequests.empty() )
 	{
 		m_ThumbnailManager->Request( m_CurrentTextureRequests );
@@ -274,6 +274,7 @@ namespace Helium
 
             ThumbnailManager*   m_ThumbnailManager;
             std::set< Helium::FilePath > m_CurrentTextureRequests;
+            std::set< Helium::FilePath > m_PendingTextureRequests; // requested by the last draw, possibly still loading
 
             M_PathToTilePtr m_Tiles;
             OS_ThumbnailTiles m_VisibleTiles;
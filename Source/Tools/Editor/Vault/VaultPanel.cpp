@@ -7,6 +7,7 @@
 #include "ThumbnailView.h"
 
 #include "Editor/App.h"
+#include "Editor/EditorEngine.h"
 #include "Editor/Controls/MenuButton.h"
 #include "Editor/Vault/VaultSettings.h"
 
@@ -104,6 +105,14 @@ VaultPanel::VaultPanel( wxWindow* parent, wxWindowID id, const wxPoint& pos, con
 	}
 
 	m_VaultSearch.AddSearchResultsAvailableListener( Editor::SearchResultsAvailableSignature::Delegate( this, &VaultPanel::OnSearchResultsAvailable ) );
+
+	// keep the search index up to date with files created or changed outside the editor
+	ThreadSafeAssetTrackerListener* pTrackerListener = ThreadSafeAssetTrackerListener::GetInstance();
+	if ( pTrackerListener )
+	{
+		pTrackerListener->e_AssetCreatedExternally.AddMethod( this, &VaultPanel::OnAssetChangedExternally );
+		pTrackerListener->e_AssetChangedExternally.AddMethod( this, &VaultPanel::OnAssetChangedExternally );
+	}
 }
 
 VaultPanel::~VaultPanel()
@@ -119,6 +128,13 @@ VaultPanel::~VaultPanel()
 
 	m_VaultSettings = NULL;
 
+	ThreadSafeAssetTrackerListener* pTrackerListener = ThreadSafeAssetTrackerListener::GetInstance();
+	if ( pTrackerListener )
+	{
+		pTrackerListener->e_AssetCreatedExternally.RemoveMethod( this, &VaultPanel::OnAssetChangedExternally );
+		pTrackerListener->e_AssetChangedExternally.RemoveMethod( this, &VaultPanel::OnAssetChangedExternally );
+	}
+
 	m_VaultSearch.AddSearchResultsAvailableListener( Editor::SearchResultsAvailableSignature::Delegate( this, &VaultPanel::OnSearchResultsAvailable ) );
 
 	delete m_ThumbnailView;
@@ -448,3 +464,10 @@ void VaultPanel::OnClose( wxCloseEvent& event )
 {
 	SaveSettings();
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// Files have been added or changed on disk, the next search needs to pick them up.
+void VaultPanel::OnAssetChangedExternally( const AssetEventArgs& args )
+{
+	m_VaultSearch.InvalidateSearchIndex();
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Engine/AssetLoader.h"
+
 #include "VaultMenuIDs.h"
 #include "Editor/EditorGeneratedWrapper.h"
 #include "Editor/Vault/VaultSearch.h"
@@ -46,6 +48,8 @@ namespace Helium
 
             void OnClose( wxCloseEvent& event );
 
+            void OnAssetChangedExternally( const AssetEventArgs& args );
+
         private:
             VaultSettings* m_VaultSettings;
 
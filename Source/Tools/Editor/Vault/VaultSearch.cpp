@@ -257,6 +257,14 @@ void VaultSearch::StopSearchThreadAndWait()
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Files have been added or changed on disk, have the next search bring the
+// index up to date before querying it.
+void VaultSearch::InvalidateSearchIndex()
+{
+    m_SearchIndex.Invalidate();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Main thread callbacks to notify listeners when the search has started,
 // when results are available for use and when the search has completed
@@ -369,6 +377,27 @@ void VaultSearch::SearchThreadProc( int32_t searchID )
     {
         return;
     }
+#else
+    // Bring the index up to date; this only walks the project the first time
+    //  and after the index has been invalidated
+    m_SearchIndex.SetRoot( FilePath( m_Project.Directory() ) );
+    m_SearchIndex.Update( m_StopSearching );
+
+    if ( CheckSearchThreadLeave( searchID ) )
+    {
+        return;
+    }
+
+    std::vector< std::string > terms;
+    m_CurrentSearchQuery->GetSearchTerms( terms );
+
+    {
+        Helium::MutexScopeLock mutex (m_SearchResultsMutex);
+
+        m_FoundFiles.clear();
+        m_SearchIndex.Find( terms, m_FoundFiles );
+        m_SearchResults->SetResults( m_FoundFiles );
+    }
 #endif
 
     SearchThreadLeave( searchID );
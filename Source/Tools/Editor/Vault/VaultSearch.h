@@ -1,5 +1,6 @@
 #pragma once
 
+#include "VaultSearchIndex.h"
 #include "VaultSearchQuery.h"
 #include "VaultSearchResults.h"
 
@@ -109,10 +110,13 @@ namespace Helium
             bool StartSearchThread( VaultSearchQuery* searchQuery );
             void StopSearchThreadAndWait();
 
+            void InvalidateSearchIndex();
+
             friend class VaultSearchThread;
 
         private:
             FilePath m_Project;
+            VaultSearchIndex m_SearchIndex;     // Files under the project directory, updated by the search thread
 
             //----------DO NOT ACCESS outside of m_SearchResultsMutex---------//
             // VaultSearchResults and Status
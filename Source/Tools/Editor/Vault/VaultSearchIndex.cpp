@@ -0,0 +1,405 @@
+#include "Precompile.h"
+#include "VaultSearchIndex.h"
+
+#include "Foundation/DirectoryIterator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+using namespace Helium;
+using namespace Helium::Editor;
+
+///////////////////////////////////////////////////////////////////////////////
+VaultSearchIndex::VaultSearchIndex()
+: m_Dirty( true )
+, m_Generation( 0 )
+{
+}
+
+VaultSearchIndex::~VaultSearchIndex()
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Sets the directory to index, clearing the index if it changed.
+//
+void VaultSearchIndex::SetRoot( const FilePath& root )
+{
+    Helium::MutexScopeLock mutex( m_Mutex );
+
+    if ( root.Get() == m_Root.Get() )
+    {
+        return;
+    }
+
+    m_Root = root;
+    m_Dirty = true;
+
+    m_Files.clear();
+    m_IndexedPaths.clear();
+    m_FileGenerations.clear();
+    m_FreeIds.clear();
+    m_FileIds.clear();
+    m_Words.clear();
+    m_Trigrams.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Flags the index to be brought up to date with the directory on the next
+// Update(); called when files have been added or changed on disk.
+//
+void VaultSearchIndex::Invalidate()
+{
+    Helium::MutexScopeLock mutex( m_Mutex );
+    m_Dirty = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Walks the directory if the index is out of date, adding new files and
+// removing files that are gone.  The walk happens without holding the lock,
+// so the main thread isn't blocked by Invalidate() while a search is running.
+// Returns false if the walk was stopped, in which case it's done again on the
+// next call.
+//
+bool VaultSearchIndex::Update( const bool& stop )
+{
+    FilePath root;
+    {
+        Helium::MutexScopeLock mutex( m_Mutex );
+        if ( !m_Dirty )
+        {
+            return true;
+        }
+
+        // clear the flag up front, so an invalidation during the walk is not lost
+        m_Dirty = false;
+        root = m_Root;
+    }
+
+    if ( root.Empty() )
+    {
+        return true;
+    }
+
+    std::vector< FilePath > files;
+    if ( !WalkDirectory( root, files, stop ) )
+    {
+        Helium::MutexScopeLock mutex( m_Mutex );
+        m_Dirty = true;
+        return false;
+    }
+
+    Helium::MutexScopeLock mutex( m_Mutex );
+
+    // the root may have changed while walking
+    if ( root.Get() != m_Root.Get() )
+    {
+        return true;
+    }
+
+    ++m_Generation;
+
+    for ( std::vector< FilePath >::const_iterator itr = files.begin(), end = files.end(); itr != end; ++itr )
+    {
+        AddFile( *itr );
+    }
+
+    for ( uint32_t id = 0; id < m_Files.size(); ++id )
+    {
+        if ( !m_IndexedPaths[ id ].empty() && m_FileGenerations[ id ] != m_Generation )
+        {
+            RemoveFile( id );
+        }
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Finds the files matching all of the given (lower case) terms.  Terms of
+// three or more characters match anywhere in the path, shorter terms match the
+// start of a word in the path.
+//
+void VaultSearchIndex::Find( const std::vector< std::string >& terms, std::set< TrackedFile >& results ) const
+{
+    Helium::MutexScopeLock mutex( m_Mutex );
+
+    S_FileIds matches;
+    bool first = true;
+
+    for ( std::vector< std::string >::const_iterator itr = terms.begin(), end = terms.end(); itr != end; ++itr )
+    {
+        if ( itr->empty() )
+        {
+            continue;
+        }
+
+        S_FileIds termMatches;
+        FindTerm( *itr, termMatches );
+
+        if ( first )
+        {
+            matches.swap( termMatches );
+            first = false;
+        }
+        else
+        {
+            S_FileIds remaining;
+            std::set_intersection(
+                matches.begin(), matches.end(),
+                termMatches.begin(), termMatches.end(),
+                std::inserter( remaining, remaining.end() ) );
+            matches.swap( remaining );
+        }
+
+        if ( matches.empty() )
+        {
+            return;
+        }
+    }
+
+    for ( S_FileIds::const_iterator itr = matches.begin(), end = matches.end(); itr != end; ++itr )
+    {
+        results.insert( TrackedFile( m_Files[ *itr ] ) );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void VaultSearchIndex::AddFile( const FilePath& path )
+{
+    std::string indexedPath = GetIndexedPath( path );
+    if ( indexedPath.empty() )
+    {
+        return;
+    }
+
+    std::map< std::string, uint32_t >::const_iterator found = m_FileIds.find( indexedPath );
+    if ( found != m_FileIds.end() )
+    {
+        m_FileGenerations[ found->second ] = m_Generation;
+        return;
+    }
+
+    uint32_t id;
+    if ( !m_FreeIds.empty() )
+    {
+        id = m_FreeIds.back();
+        m_FreeIds.pop_back();
+    }
+    else
+    {
+        id = static_cast< uint32_t >( m_Files.size() );
+        m_Files.push_back( FilePath() );
+        m_IndexedPaths.push_back( std::string() );
+        m_FileGenerations.push_back( 0 );
+    }
+
+    m_Files[ id ] = path;
+    m_IndexedPaths[ id ] = indexedPath;
+    m_FileGenerations[ id ] = m_Generation;
+    m_FileIds[ indexedPath ] = id;
+
+    std::set< std::string > words;
+    GetWords( indexedPath, words );
+    for ( std::set< std::string >::const_iterator itr = words.begin(), end = words.end(); itr != end; ++itr )
+    {
+        m_Words[ *itr ].insert( id );
+    }
+
+    std::set< uint32_t > trigrams;
+    GetTrigrams( indexedPath, trigrams );
+    for ( std::set< uint32_t >::const_iterator itr = trigrams.begin(), end = trigrams.end(); itr != end; ++itr )
+    {
+        m_Trigrams[ *itr ].insert( id );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void VaultSearchIndex::RemoveFile( uint32_t id )
+{
+    const std::string& indexedPath = m_IndexedPaths[ id ];
+
+    std::set< std::string > words;
+    GetWords( indexedPath, words );
+    for ( std::set< std::string >::const_iterator itr = words.begin(), end = words.end(); itr != end; ++itr )
+    {
+        std::map< std::string, S_FileIds >::iterator found = m_Words.find( *itr );
+        if ( found != m_Words.end() )
+        {
+            found->second.erase( id );
+            if ( found->second.empty() )
+            {
+                m_Words.erase( found );
+            }
+        }
+    }
+
+    std::set< uint32_t > trigrams;
+    GetTrigrams( indexedPath, trigrams );
+    for ( std::set< uint32_t >::const_iterator itr = trigrams.begin(), end = trigrams.end(); itr != end; ++itr )
+    {
+        std::map< uint32_t, S_FileIds >::iterator found = m_Trigrams.find( *itr );
+        if ( found != m_Trigrams.end() )
+        {
+            found->second.erase( id );
+            if ( found->second.empty() )
+            {
+                m_Trigrams.erase( found );
+            }
+        }
+    }
+
+    m_FileIds.erase( indexedPath );
+
+    m_Files[ id ] = FilePath();
+    m_IndexedPaths[ id ].clear();
+    m_FreeIds.push_back( id );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Gathers the files under the directory, skipping hidden directories (such as
+// revision control data).
+//
+bool VaultSearchIndex::WalkDirectory( const FilePath& directory, std::vector< FilePath >& files, const bool& stop )
+{
+    for ( DirectoryIterator itr( directory ); !itr.IsDone(); itr.Next() )
+    {
+        if ( stop )
+        {
+            return false;
+        }
+
+        const DirectoryIteratorItem& item = itr.GetItem();
+        if ( item.m_Path.IsDirectory() )
+        {
+            std::string name = item.m_Path.Filename().Get();
+            if ( !name.empty() && name[ 0 ] == '.' )
+            {
+                continue;
+            }
+
+            if ( !WalkDirectory( item.m_Path, files, stop ) )
+            {
+                return false;
+            }
+        }
+        else if ( item.m_Path.IsFile() )
+        {
+            files.push_back( item.m_Path );
+        }
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void VaultSearchIndex::FindTerm( const std::string& term, S_FileIds& ids ) const
+{
+    if ( term.size() < 3 )
+    {
+        // too short for trigrams, match the start of the path words
+        for ( std::map< std::string, S_FileIds >::const_iterator itr = m_Words.lower_bound( term ), end = m_Words.end();
+            itr != end && itr->first.compare( 0, term.size(), term ) == 0;
+            ++itr )
+        {
+            ids.insert( itr->second.begin(), itr->second.end() );
+        }
+
+        return;
+    }
+
+    // the files containing the term contain all of its trigrams, intersect
+    //  their files starting from the rarest trigram
+    std::set< uint32_t > trigrams;
+    GetTrigrams( term, trigrams );
+
+    std::vector< const S_FileIds* > trigramIds;
+    for ( std::set< uint32_t >::const_iterator itr = trigrams.begin(), end = trigrams.end(); itr != end; ++itr )
+    {
+        std::map< uint32_t, S_FileIds >::const_iterator found = m_Trigrams.find( *itr );
+        if ( found == m_Trigrams.end() )
+        {
+            return;
+        }
+
+        trigramIds.push_back( &found->second );
+    }
+
+    const S_FileIds* rarest = trigramIds.front();
+    for ( std::vector< const S_FileIds* >::const_iterator itr = trigramIds.begin(), end = trigramIds.end(); itr != end; ++itr )
+    {
+        if ( (*itr)->size() < rarest->size() )
+        {
+            rarest = *itr;
+        }
+    }
+
+    // the trigrams could appear apart from each other, so check the candidates
+    for ( S_FileIds::const_iterator itr = rarest->begin(), end = rarest->end(); itr != end; ++itr )
+    {
+        if ( m_IndexedPaths[ *itr ].find( term ) != std::string::npos )
+        {
+            ids.insert( ids.end(), *itr );
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Gets the lower case path relative to the root, with forward slashes.
+//
+std::string VaultSearchIndex::GetIndexedPath( const FilePath& path ) const
+{
+    std::string indexedPath = path.Get();
+    std::transform( indexedPath.begin(), indexedPath.end(), indexedPath.begin(), ::tolower );
+    std::replace( indexedPath.begin(), indexedPath.end(), '\\', '/' );
+
+    std::string root = m_Root.Get();
+    std::transform( root.begin(), root.end(), root.begin(), ::tolower );
+    std::replace( root.begin(), root.end(), '\\', '/' );
+
+    if ( !root.empty() && indexedPath.compare( 0, root.size(), root ) == 0 )
+    {
+        indexedPath.erase( 0, root.size() );
+    }
+
+    return indexedPath;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Splits a path into its directory names, name parts and extension.
+//
+void VaultSearchIndex::GetWords( const std::string& indexedPath, std::set< std::string >& words )
+{
+    std::string word;
+    for ( std::string::const_iterator itr = indexedPath.begin(), end = indexedPath.end(); itr != end; ++itr )
+    {
+        if ( isalnum( static_cast< unsigned char >( *itr ) ) )
+        {
+            word += *itr;
+        }
+        else if ( !word.empty() )
+        {
+            words.insert( word );
+            word.clear();
+        }
+    }
+
+    if ( !word.empty() )
+    {
+        words.insert( word );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void VaultSearchIndex::GetTrigrams( const std::string& text, std::set< uint32_t >& trigrams )
+{
+    for ( size_t i = 0; i + 2 < text.size(); ++i )
+    {
+        uint32_t trigram =
+            ( static_cast< uint32_t >( static_cast< unsigned char >( text[ i ] ) ) << 16 ) |
+            ( static_cast< uint32_t >( static_cast< unsigned char >( text[ i + 1 ] ) ) << 8 ) |
+            static_cast< uint32_t >( static_cast< unsigned char >( text[ i + 2 ] ) );
+        trigrams.insert( trigram );
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Platform/Types.h"
+#include "Platform/Locks.h"
+
+#include "Foundation/FilePath.h"
+
+#include "VaultSearchResults.h"
+
+namespace Helium
+{
+    namespace Editor
+    {
+        ///////////////////////////////////////////////////////////////////////
+        /// class VaultSearchIndex
+        //
+        // Inverted index of the files under the project directory, so searches
+        //  don't have to walk the project.  Every file is indexed by the words
+        //  of its path (directory names, name parts and extension) for prefix
+        //  matching, and by the trigrams of its path for substring matching.
+        //
+        // The directory is only walked the first time the index is updated,
+        //  and again after the index has been invalidated (by asset tracker
+        //  notifications about files created or changed outside the editor).
+        //
+        class VaultSearchIndex
+        {
+        public:
+            VaultSearchIndex();
+            ~VaultSearchIndex();
+
+            void SetRoot( const FilePath& root );
+            void Invalidate();
+
+            bool Update( const bool& stop );
+
+            void Find( const std::vector< std::string >& terms, std::set< TrackedFile >& results ) const;
+
+        private:
+            typedef std::set< uint32_t > S_FileIds;
+
+            void AddFile( const FilePath& path );
+            void RemoveFile( uint32_t id );
+            static bool WalkDirectory( const FilePath& directory, std::vector< FilePath >& files, const bool& stop );
+            void FindTerm( const std::string& term, S_FileIds& ids ) const;
+
+            std::string GetIndexedPath( const FilePath& path ) const;
+            static void GetWords( const std::string& indexedPath, std::set< std::string >& words );
+            static void GetTrigrams( const std::string& text, std::set< uint32_t >& trigrams );
+
+        private:
+            mutable Helium::Mutex               m_Mutex;
+            FilePath                            m_Root;
+            bool                                m_Dirty;            // the directory needs to be walked again
+            uint32_t                            m_Generation;       // incremented on each walk to find removed files
+
+            std::vector< FilePath >             m_Files;            // file path by id, empty for removed files
+            std::vector< std::string >          m_IndexedPaths;     // lower case path relative to the root by id
+            std::vector< uint32_t >             m_FileGenerations;  // walk in which each file was last seen by id
+            std::vector< uint32_t >             m_FreeIds;          // ids of removed files to reuse
+            std::map< std::string, uint32_t >   m_FileIds;          // id by indexed path
+
+            std::map< std::string, S_FileIds >  m_Words;            // ids by path word
+            std::map< uint32_t, S_FileIds >     m_Trigrams;         // ids by path trigram
+        };
+    }
+}
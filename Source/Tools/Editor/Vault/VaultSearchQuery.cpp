@@ -230,3 +230,57 @@ bool VaultSearchQuery::ParseQueryString( const std::string& queryString, std::st
 
     return false;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+// Gets the lower case words to look up in the search index.  Column aliases
+// are not indexed separately, so only their arguments are kept, and wildcards
+// just separate words since the index matches anywhere in the path.
+//
+void VaultSearchQuery::GetSearchTerms( std::vector< std::string >& terms ) const
+{
+    const std::regex parseColumnQuery( s_ParseColumnName, std::regex::icase );
+
+    std::vector< std::string > tokens;
+    if ( !TokenizeQuery( m_QueryString, tokens ) )
+    {
+        return;
+    }
+
+    std::smatch matchResults;
+    std::string phrase;
+    std::string errors;
+    for ( std::vector< std::string >::const_iterator tokenItr = tokens.begin(), tokenEnd = tokens.end(); tokenItr != tokenEnd; ++tokenItr )
+    {
+        if ( std::regex_search( *tokenItr, matchResults, parseColumnQuery ) && matchResults[1].matched )
+        {
+            continue;
+        }
+
+        if ( !ParsePhrase( *tokenItr, matchResults, phrase, errors ) )
+        {
+            continue;
+        }
+
+        std::string term;
+        for ( std::string::const_iterator itr = phrase.begin(), end = phrase.end(); itr != end; ++itr )
+        {
+            if ( *itr == '*' || isspace( static_cast< unsigned char >( *itr ) ) )
+            {
+                if ( !term.empty() )
+                {
+                    terms.push_back( term );
+                    term.clear();
+                }
+            }
+            else
+            {
+                term += ( *itr == '\\' ) ? '/' : static_cast< char >( tolower( static_cast< unsigned char >( *itr ) ) );
+            }
+        }
+
+        if ( !term.empty() )
+        {
+            terms.push_back( term );
+        }
+    }
+}
@@ -29,6 +29,7 @@ namespace Helium
             const std::string& GetQueryString() const { return m_QueryString; }
 
             const std::string& GetSQLQueryString() const;
+            void GetSearchTerms( std::vector< std::string >& terms ) const;
 
             bool operator<( const VaultSearchQuery& rhs ) const;
             bool operator==( const VaultSearchQuery& rhs ) const;
@@ -4,13 +4,9 @@
 using namespace Helium;
 using namespace Helium::Editor;
 
-// TODO: Define Tracked file as a db model
-
 bool Helium::Editor::operator<( const TrackedFile& lhs, const TrackedFile& rhs )
 {
-	// TODO: Implement this
-	HELIUM_ASSERT( false );
-	return true;
+	return lhs.m_Path < rhs.m_Path;
 }
 
 VaultSearchResults::VaultSearchResults( uint32_t vaultSearchID )
@@ -14,6 +14,10 @@ namespace Helium
 	{
 		struct TrackedFile
 		{
+			Helium::FilePath m_Path;
+
+			TrackedFile() {}
+			TrackedFile( const Helium::FilePath& path ) : m_Path( path ) {}
 		};
 		bool operator<( const TrackedFile& lhs, const TrackedFile& rhs );
 
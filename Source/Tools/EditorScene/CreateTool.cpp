@@ -568,6 +568,42 @@ void CreateTool::AddToScene()
 	}
 }
 
+void CreateTool::AddToBatch( const Matrix4& orientation )
+{
+	HELIUM_ASSERT( m_Batch.ReferencesObject() );
+
+	// create the new node directly instead of converting the transient instance and placing another one for each
+	Editor::TransformPtr instance = CreateNode();
+	if ( !instance.ReferencesObject() )
+	{
+		return;
+	}
+
+	if (!m_Created)
+	{
+		m_Batch->Push( m_Scene->GetSelection().Clear() );
+		m_Created = true;
+	}
+
+	instance->SetSelected( true );
+	instance->SetObjectTransform( orientation );
+
+	m_Batch->Push( new SceneNodeExistenceCommand( ExistenceActions::Add, m_Scene, instance ) );
+
+	if ( !instance->IsInitialized() )
+	{
+		instance->SetOwner( m_Scene );
+		instance->Initialize();
+	}
+
+	HELIUM_ASSERT( instance->GetOwner() == m_Scene );
+
+	// later instances in this pass test against this one's placement
+	instance->Evaluate( GraphDirections::Downstream );
+
+	m_Selection.Append( instance );
+}
+
 void CreateTool::SceneNodeAdded( const NodeChangeArgs& args )
 {
 	m_Selection.Append( args.m_Node );
@@ -1114,6 +1150,13 @@ void CreateTool::CreateSingleObject( const Vector3& translation, const Vector3&
 		}
 	}
 
+	if ( m_Batch.ReferencesObject() )
+	{
+		HELIUM_EDITOR_SCENE_SCOPE_TIMER( "Add Instance To Batch" );
+		AddToBatch( orientation );
+		return;
+	}
+
 	if ( m_Instance.ReferencesObject() )
 	{
 		HELIUM_EDITOR_SCENE_SCOPE_TIMER( "Update Temporary Instance At Location" );
@@ -1148,7 +1191,7 @@ void CreateTool::CreateMultipleObjects( bool stamp )
 {
 	HELIUM_EDITOR_SCENE_SCOPE_TIMER( "Place Multiple Instances At Location" );
 
-	if ( m_InstanceRadius <= 0.0f )
+	if ( m_InstanceRadius <= 0.0f || !m_Scene->IsEditable() )
 	{
 		return;
 	}
@@ -1164,6 +1207,8 @@ void CreateTool::CreateMultipleObjects( bool stamp )
 	SimpleTimer instanceTimer;
 	Vector3 instanceNormalOffset = m_InstanceNormal.Normalize() * 2.0f * s_PaintRadius;
 
+	m_Batch = new BatchUndoCommand ();
+
 	while ( m_InstanceOffsets.size() && ( stamp || ( instanceTimer.Elapsed() < maxTime ) ) )
 	{
 		V_Vector3::iterator itr = m_InstanceOffsets.begin();
@@ -1189,6 +1234,16 @@ void CreateTool::CreateMultipleObjects( bool stamp )
 
 		m_InstanceOffsets.erase( itr );
 	}
+
+	// one undo step for everything placed in this pass
+	BatchUndoCommandPtr batch = m_Batch;
+	m_Batch = NULL;
+
+	if ( !batch->IsEmpty() )
+	{
+		HELIUM_EDITOR_SCENE_SCOPE_TIMER( "Push Undo Batch Into Scene" );
+		m_Scene->Push( batch );
+	}
 }
 
 void CreateTool::TimerCallback( const TimerTickArgs& args )
@@ -54,6 +54,9 @@ namespace Helium
 			// The selection of the created objects
 			OS_SceneNodeDumbPtr m_Selection;
 
+			// Collects the instances painted in one pass into a single undo command
+			BatchUndoCommandPtr m_Batch;
+
 			// The instance we are creating
 			bool m_InstanceUpdateOffsets;
 			Editor::TransformPtr m_Instance;
@@ -158,6 +161,7 @@ namespace Helium
 
 		private:
 			void AddToScene();
+			void AddToBatch( const Matrix4& orientation );
 			void SceneNodeAdded( const NodeChangeArgs& args );
 			void SceneNodeRemoved( const NodeChangeArgs& args );
 
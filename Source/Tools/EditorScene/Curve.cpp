@@ -31,6 +31,27 @@ using namespace Helium::Editor;
 Helium::Color Curve::s_Material = Editor::Colors::FORESTGREEN;
 Helium::Color Curve::s_HullMaterial = Editor::Colors::GRAY;
 
+// number of computed curve points covered by each of the bounds used to cull picks
+static const size_t CurvePointsPerBounds = 16;
+
+static bool EqualPoints( const V_Vector3& lhs, const V_Vector3& rhs )
+{
+	if ( lhs.size() != rhs.size() )
+	{
+		return false;
+	}
+
+	for ( size_t i = 0; i < lhs.size(); ++i )
+	{
+		if ( lhs[ i ].x != rhs[ i ].x || lhs[ i ].y != rhs[ i ].y || lhs[ i ].z != rhs[ i ].z )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void Curve::PopulateMetaType( Reflect::MetaStruct& comp )
 {
 	comp.AddField( &Curve::m_Closed,               "m_Closed" );
@@ -44,6 +65,7 @@ Curve::Curve()
 	, m_Type( CurveType::Linear )
 	, m_Resolution( 10 )
 	, m_ControlPointLabel( ControlPointLabel::None )
+	, m_TessellationValid( false )
 	, m_Locator ( NULL )
 	, m_Cone ( NULL )
 {
@@ -91,6 +113,7 @@ int Curve::GetCurveType() const
 void Curve::SetCurveType( int value )
 {
 	m_Type = static_cast< CurveType::Enum >( value );
+	m_TessellationValid = false;
 
 	Dirty();
 }
@@ -103,6 +126,7 @@ bool Curve::GetClosed() const
 void Curve::SetClosed( bool value )
 {
 	m_Closed = value;
+	m_TessellationValid = false;
 
 	Dirty();
 }
@@ -115,6 +139,7 @@ uint32_t Curve::GetResolution() const
 void Curve::SetResolution( uint32_t value )
 {
 	m_Resolution = value;
+	m_TessellationValid = false;
 
 	Dirty();
 }
@@ -476,6 +501,7 @@ void Curve::Delete()
 	// Populate().
 	m_Vertices->SetElementCount( 0 );
 	m_Vertices->Delete();
+	m_TessellationValid = false;
 	m_Locator->Delete();
 	m_Cone->Delete();
 }
@@ -701,7 +727,6 @@ float32_t Curve::CalculateCurveLength() const
 
 void Curve::Evaluate( GraphDirection direction )
 {
-	uint32_t controlCount = 0;
 	V_Vector3 points;
 	{
 		OS_HierarchyNodeDumbPtr::Iterator childItr = GetChildren().Begin();
@@ -712,11 +737,20 @@ void Curve::Evaluate( GraphDirection direction )
 			if ( point )
 			{
 				points.push_back( point->GetPosition() );
-				++controlCount;
 			}
 		}
 	}
 
+	// The computed points are in object space, so only control point edits and curve
+	// settings change them; moving the curve itself reuses the existing tessellation
+	if ( m_TessellationValid && EqualPoints( points, m_TessellatedControlPoints ) )
+	{
+		Base::Evaluate(direction);
+		return;
+	}
+
+	uint32_t controlCount = (uint32_t)points.size();
+
 	if ( controlCount < 4  || m_Type == CurveType::Linear ) 
 	{     
 		m_Points = points;
@@ -735,6 +769,11 @@ void Curve::Evaluate( GraphDirection direction )
 		HELIUM_BREAK();
 	}
 
+	m_TessellatedControlPoints.swap( points );
+	m_TessellationValid = true;
+
+	UpdateSegmentBounds();
+
 
 	//
 	// Update buffer
@@ -757,6 +796,38 @@ void Curve::Evaluate( GraphDirection direction )
 	Base::Evaluate(direction);
 }
 
+void Curve::UpdateSegmentBounds()
+{
+	m_SegmentBounds.clear();
+
+	size_t pointCount = m_Points.size();
+	if ( pointCount == 0 )
+	{
+		return;
+	}
+
+	// Each run of points also covers the first point of the next run, so that it bounds
+	// the segment joining them; the pick error is added so near misses aren't culled
+	const Vector3 pickError( HELIUM_LINEAR_INTERSECTION_ERROR, HELIUM_LINEAR_INTERSECTION_ERROR, HELIUM_LINEAR_INTERSECTION_ERROR );
+
+	m_SegmentBounds.reserve( ( pointCount + CurvePointsPerBounds - 1 ) / CurvePointsPerBounds );
+	for ( size_t first = 0; first < pointCount; first += CurvePointsPerBounds )
+	{
+		size_t last = std::min( first + CurvePointsPerBounds, pointCount - 1 );
+
+		AlignedBox bounds;
+		bounds.Reset();
+		for ( size_t i = first; i <= last; ++i )
+		{
+			bounds.Test( m_Points[ i ] );
+		}
+
+		bounds.minimum -= pickError;
+		bounds.maximum += pickError;
+		m_SegmentBounds.push_back( bounds );
+	}
+}
+
 void Curve::Render( RenderVisitor* render )
 {
 	HELIUM_ASSERT( render );
@@ -985,12 +1056,22 @@ bool Curve::Pick( PickVisitor* pick )
 	if ( !m_Points.empty() )
 	{
 		//
-		// Pick Curve Points
+		// Pick Curve Points, skipping the runs of points whose bounds the pick misses
 		//
 
-		for ( size_t i=0; i < m_Points.size() && !pickHit; ++i )
+		for ( size_t bounds = 0; bounds < m_SegmentBounds.size() && !pickHit; ++bounds )
 		{
-			pickHit |= pick->PickPoint (m_Points[ i ]); 
+			if ( !pick->IntersectsBox( m_SegmentBounds[ bounds ] ) )
+			{
+				continue;
+			}
+
+			size_t first = bounds * CurvePointsPerBounds;
+			size_t end = std::min( first + CurvePointsPerBounds, m_Points.size() );
+			for ( size_t i = first; i < end && !pickHit; ++i )
+			{
+				pickHit |= pick->PickPoint (m_Points[ i ]); 
+			}
 		}
 
 
@@ -998,9 +1079,19 @@ bool Curve::Pick( PickVisitor* pick )
 		// Pick Curve Lines
 		//
 
-		for ( size_t i=0; i < m_Points.size() - 1 && !pickHit; ++i )
+		for ( size_t bounds = 0; bounds < m_SegmentBounds.size() && !pickHit; ++bounds )
 		{
-			pickHit |= pick->PickSegment (m_Points[ i ], m_Points[ i + 1 ]); 
+			if ( !pick->IntersectsBox( m_SegmentBounds[ bounds ] ) )
+			{
+				continue;
+			}
+
+			size_t first = bounds * CurvePointsPerBounds;
+			size_t end = std::min( first + CurvePointsPerBounds, m_Points.size() - 1 );
+			for ( size_t i = first; i < end && !pickHit; ++i )
+			{
+				pickHit |= pick->PickSegment (m_Points[ i ], m_Points[ i + 1 ]); 
+			}
 		}
 
 
@@ -140,6 +140,9 @@ namespace Helium
 		private:
 			void ChildChangingParents( const ParentChangingArgs& args );
 
+			// recompute the bounds of each run of curve points tested by Pick()
+			void UpdateSegmentBounds();
+
 		protected:
 			// Reflected
 			bool                    m_Closed;               // Is the curve closed?
@@ -149,6 +152,9 @@ namespace Helium
 			V_Vector3               m_Points;               // The 3D locations of the computed curve points
 
 			// Non-reflected
+			V_Vector3                   m_TessellatedControlPoints; // The control points m_Points was computed from
+			bool                        m_TessellationValid;        // Are m_Points and the vertex buffer up to date with the settings?
+			std::vector< AlignedBox >   m_SegmentBounds;            // The bounds of each run of computed curve points
 			PrimitiveLocator*           m_Locator;
 			PrimitiveCone*              m_Cone;
 			StrongPtr< VertexResource > m_Vertices;
@@ -115,7 +115,7 @@ bool DeviceManager::Init( void* hwnd, uint32_t back_buffer_width, uint32_t back_
 		Helium::Renderer::ContextInitParameters initParameters;
 		initParameters.pWindow = hwnd;
 		initParameters.bFullscreen = false;
-		initParameters.bVsync = false;
+		initParameters.presentMode = RENDERER_PRESENT_MODE_IMMEDIATE;
 		initParameters.displayWidth = sm_mainRenderContextWidth;
 		initParameters.displayHeight = sm_mainRenderContextHeight;
 
@@ -153,7 +153,7 @@ bool DeviceManager::Init( void* hwnd, uint32_t back_buffer_width, uint32_t back_
 		Helium::Renderer::ContextInitParameters initParameters;
 		initParameters.pWindow = hwnd;
 		initParameters.bFullscreen = false;
-		initParameters.bVsync = false;
+		initParameters.presentMode = RENDERER_PRESENT_MODE_IMMEDIATE;
 		initParameters.displayWidth = back_buffer_width;
 		initParameters.displayHeight = back_buffer_height;
 
@@ -182,7 +182,7 @@ bool DeviceManager::ResizeSwapChain( uint32_t width, uint32_t height )
 	Helium::Renderer::ContextInitParameters initParameters;
 	initParameters.pWindow = m_hWnd;
 	initParameters.bFullscreen = false;
-	initParameters.bVsync = false;
+	initParameters.presentMode = RENDERER_PRESENT_MODE_IMMEDIATE;
 	initParameters.displayWidth = width;
 	initParameters.displayHeight = height;
 
@@ -202,7 +202,7 @@ bool DeviceManager::ResizeDevice( uint32_t width, uint32_t height )
 	Helium::Renderer::ContextInitParameters initParameters;
 	initParameters.pWindow = m_hWnd;
 	initParameters.bFullscreen = false;
-	initParameters.bVsync = false;
+	initParameters.presentMode = RENDERER_PRESENT_MODE_IMMEDIATE;
 	initParameters.displayWidth = width;
 	initParameters.displayHeight = height;
 
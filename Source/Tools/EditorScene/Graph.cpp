@@ -2,6 +2,8 @@
 #include "Graph.h"
 #include "EditorScene/SceneNode.h"
 
+#include "EngineJobs/JobManager.h"
+
 #include <stack>
 
 //#define SCENE_DEBUG_EVALUATE
@@ -11,9 +13,13 @@ HELIUM_DEFINE_CLASS( Helium::Editor::Graph );
 using namespace Helium;
 using namespace Helium::Editor;
 
+// levels smaller than this prepare their nodes inline during evaluation instead of on job threads
+static const size_t ParallelPrepareNodeCountMin = 64;
+
 Graph::Graph()
 	: m_NextID (1)
 	, m_CurrentID (0)
+	, m_PrepareDirection (GraphDirections::Downstream)
 {
 
 }
@@ -41,6 +47,9 @@ void Graph::Reset()
 
 	m_TerminalNodes.clear();
 
+	m_PropagatedNodes[ GraphDirections::Downstream ].clear();
+	m_PropagatedNodes[ GraphDirections::Upstream ].clear();
+
 	m_CurrentID = 0;
 	m_NextID = 1;
 }
@@ -118,6 +127,9 @@ void Graph::RemoveNode(Editor::SceneNode* n)
 	m_IntermediateNodes.erase( n );
 	m_TerminalNodes.erase( n );
 
+	m_PropagatedNodes[ GraphDirections::Downstream ].erase( n );
+	m_PropagatedNodes[ GraphDirections::Upstream ].erase( n );
+
 	n->SetGraph( NULL );
 }
 
@@ -125,6 +137,10 @@ uint32_t Graph::DirtyNode( Editor::SceneNode* node, GraphDirection direction )
 {
 	uint32_t count = 0;
 
+	// this node changed itself, so it will push its evaluation to its dependents unconditionally
+	S_SceneNodeDumbPtr& propagatedNodes = m_PropagatedNodes[direction];
+	propagatedNodes.erase( node );
+
 	node->SetNodeState(direction, NodeStates::Dirty);
 	count++;
 
@@ -149,6 +165,7 @@ uint32_t Graph::DirtyNode( Editor::SceneNode* node, GraphDirection direction )
 				descendantStack.pop();
 
 				descendant->SetNodeState(direction, NodeStates::Dirty);
+				propagatedNodes.insert( descendant );
 				count++;
 
 				for ( S_SceneNodeSmartPtr::const_iterator itr = descendant->GetDescendants().begin(), end = descendant->GetDescendants().end(); itr != end; ++itr )
@@ -182,6 +199,7 @@ uint32_t Graph::DirtyNode( Editor::SceneNode* node, GraphDirection direction )
 				ancestorStack.pop();
 
 				ancestor->SetNodeState(direction, NodeStates::Dirty);
+				propagatedNodes.insert( ancestor );
 				count++;
 
 				for ( S_SceneNodeDumbPtr::const_iterator itr = ancestor->GetAncestors().begin(), end = ancestor->GetAncestors().end(); itr != end; ++itr )
@@ -210,66 +228,197 @@ EvaluateResult Graph::EvaluateGraph(bool silent)
 
 	m_EvaluatedNodes.clear();
 
-	for ( S_SceneNodeDumbPtr::const_iterator itr = m_TerminalNodes.begin(), end = m_TerminalNodes.end(); itr != end; ++itr )
+	Evaluate(GraphDirections::Downstream);
+	Evaluate(GraphDirections::Upstream);
+
+	result.m_NodeCount = (int)m_EvaluatedNodes.size();
+
+	m_EvaluatedEvent.Raise( m_EvaluatedNodes );
+
+	m_CleanupRoots.clear();
+
+	result.m_TotalTime = static_cast< float32_t >( Timer::TicksToMilliseconds( Timer::GetTickCount() - start) );
+
+	return result;
+}
+
+//
+// Helpers for walking either the ancestors or descendants of a node, which are stored in different set types
+//
+
+template< class T >
+static uint32_t CountDirtyNodes( const T& nodes, GraphDirection direction )
+{
+	uint32_t count = 0;
+
+	for ( typename T::const_iterator itr = nodes.begin(), end = nodes.end(); itr != end; ++itr )
 	{
-		if ((*itr)->GetNodeState(GraphDirections::Downstream) == NodeStates::Dirty)
+		if ( (*itr)->GetNodeState(direction) == NodeStates::Dirty )
 		{
-			Evaluate(*itr, GraphDirections::Downstream);
+			count++;
 		}
 	}
 
-	for ( S_SceneNodeDumbPtr::const_iterator itr = m_OriginalNodes.begin(), end = m_OriginalNodes.end(); itr != end; ++itr )
+	return count;
+}
+
+template< class T >
+static bool ContainsAnyNode( const T& nodes, const S_SceneNodeDumbPtr& set )
+{
+	for ( typename T::const_iterator itr = nodes.begin(), end = nodes.end(); itr != end; ++itr )
 	{
-		if ((*itr)->GetNodeState(GraphDirections::Upstream) == NodeStates::Dirty)
+		Editor::SceneNode* node = *itr;
+		if ( set.find( node ) != set.end() )
 		{
-			Evaluate(*itr, GraphDirections::Upstream);
+			return true;
 		}
 	}
 
-	result.m_NodeCount = (int)m_EvaluatedNodes.size();
+	return false;
+}
 
-	m_EvaluatedEvent.Raise( m_EvaluatedNodes );
+template< class T >
+static void ReleaseDependents( const T& nodes, std::map< Editor::SceneNode*, uint32_t >& pendingInputs, V_SceneNodeDumbPtr& nextLevel )
+{
+	for ( typename T::const_iterator itr = nodes.begin(), end = nodes.end(); itr != end; ++itr )
+	{
+		Editor::SceneNode* node = *itr;
+		std::map< Editor::SceneNode*, uint32_t >::iterator found = pendingInputs.find( node );
+		if ( found != pendingInputs.end() && found->second > 0 && --found->second == 0 )
+		{
+			nextLevel.push_back( node );
+		}
+	}
+}
 
-	m_CleanupRoots.clear();
+void Graph::Evaluate(GraphDirection direction)
+{
+	S_SceneNodeDumbPtr& propagatedNodes = m_PropagatedNodes[direction];
 
-	result.m_TotalTime = static_cast< float32_t >( Timer::TicksToMilliseconds( Timer::GetTickCount() - start) );
+	//
+	// Gather dirty nodes, and count the dirty inputs each has to wait on (ancestors downstream, descendants upstream)
+	//
 
-	return result;
-}
+	m_PendingInputs.clear();
+	m_ChangedNodes.clear();
+	m_CurrentLevel.clear();
 
-void Graph::Evaluate(Editor::SceneNode* node, GraphDirection direction)
-{
-	switch (direction)
+	const S_SceneNodeDumbPtr* nodeSets[] = { &m_OriginalNodes, &m_IntermediateNodes, &m_TerminalNodes };
+	for ( size_t i = 0; i < sizeof( nodeSets ) / sizeof( nodeSets[0] ); ++i )
 	{
-	case GraphDirections::Downstream:
+		for ( S_SceneNodeDumbPtr::const_iterator itr = nodeSets[i]->begin(), end = nodeSets[i]->end(); itr != end; ++itr )
 		{
-			for ( S_SceneNodeDumbPtr::const_iterator itr = node->GetAncestors().begin(), end = node->GetAncestors().end(); itr != end; ++itr )
+			Editor::SceneNode* node = *itr;
+			if ( node->GetNodeState(direction) == NodeStates::Dirty )
 			{
-				if ((*itr)->GetNodeState(direction) == NodeStates::Dirty)
+				uint32_t inputCount = direction == GraphDirections::Downstream
+					? CountDirtyNodes( node->GetAncestors(), direction )
+					: CountDirtyNodes( node->GetDescendants(), direction );
+
+				m_PendingInputs[ node ] = inputCount;
+
+				if ( inputCount == 0 )
 				{
-					Evaluate(*itr, direction);
+					m_CurrentLevel.push_back( node );
 				}
 			}
+		}
+	}
 
-			break;
+	//
+	// Evaluate a level at a time, every node in a level only depends on nodes from earlier levels
+	//
+
+	while ( !m_CurrentLevel.empty() )
+	{
+		m_LevelEvaluations.clear();
+
+		for ( V_SceneNodeDumbPtr::const_iterator itr = m_CurrentLevel.begin(), end = m_CurrentLevel.end(); itr != end; ++itr )
+		{
+			Editor::SceneNode* node = *itr;
+
+			// nodes dirtied through an input only need evaluating if one of their inputs actually changed
+			if ( propagatedNodes.find( node ) == propagatedNodes.end() || HasChangedInput( node, direction ) )
+			{
+				m_LevelEvaluations.push_back( node );
+			}
+			else
+			{
+				node->SetNodeState(direction, NodeStates::Clean);
+			}
 		}
 
-	case GraphDirections::Upstream:
+		if ( m_LevelEvaluations.size() >= ParallelPrepareNodeCountMin )
 		{
-			for ( S_SceneNodeSmartPtr::const_iterator itr = node->GetDescendants().begin(), end = node->GetDescendants().end(); itr != end; ++itr )
+			m_PrepareDirection = direction;
+			JobManager::ParallelFor( &Graph::PrepareEvaluateCallback, this, m_LevelEvaluations.size() );
+		}
+
+		for ( V_SceneNodeDumbPtr::const_iterator itr = m_LevelEvaluations.begin(), end = m_LevelEvaluations.end(); itr != end; ++itr )
+		{
+			Editor::SceneNode* node = *itr;
+
+			bool changed = node->DoEvaluate(direction);
+			if ( changed || propagatedNodes.find( node ) == propagatedNodes.end() )
 			{
-				if ((*itr)->GetNodeState(direction) == NodeStates::Dirty)
-				{
-					Evaluate(*itr, direction);
-				}
+				m_ChangedNodes.insert( node );
 			}
 
-			break;
+			m_EvaluatedNodes.insert( node );
 		}
+
+		m_NextLevel.clear();
+
+		for ( V_SceneNodeDumbPtr::const_iterator itr = m_CurrentLevel.begin(), end = m_CurrentLevel.end(); itr != end; ++itr )
+		{
+			Editor::SceneNode* node = *itr;
+
+			if ( direction == GraphDirections::Downstream )
+			{
+				ReleaseDependents( node->GetDescendants(), m_PendingInputs, m_NextLevel );
+			}
+			else
+			{
+				ReleaseDependents( node->GetAncestors(), m_PendingInputs, m_NextLevel );
+			}
+		}
+
+		m_CurrentLevel.swap( m_NextLevel );
 	}
 
-	// perform evaluate
-	node->DoEvaluate(direction);
+	//
+	// Anything still waiting is part of a dependency cycle, evaluate it in any order
+	//
 
-	m_EvaluatedNodes.insert( node );
-}
\ No newline at end of file
+	for ( std::map< Editor::SceneNode*, uint32_t >::const_iterator itr = m_PendingInputs.begin(), end = m_PendingInputs.end(); itr != end; ++itr )
+	{
+		Editor::SceneNode* node = itr->first;
+		if ( itr->second > 0 && node->GetNodeState(direction) == NodeStates::Dirty )
+		{
+			node->DoEvaluate(direction);
+			m_EvaluatedNodes.insert( node );
+		}
+	}
+
+	propagatedNodes.clear();
+	m_ChangedNodes.clear();
+	m_PendingInputs.clear();
+}
+
+bool Graph::HasChangedInput(Editor::SceneNode* node, GraphDirection direction) const
+{
+	if ( direction == GraphDirections::Downstream )
+	{
+		return ContainsAnyNode( node->GetAncestors(), m_ChangedNodes );
+	}
+	else
+	{
+		return ContainsAnyNode( node->GetDescendants(), m_ChangedNodes );
+	}
+}
+
+void Graph::PrepareEvaluateCallback(void* context, size_t index)
+{
+	Graph* graph = static_cast< Graph* >( context );
+	graph->m_LevelEvaluations[ index ]->PrepareEvaluate( graph->m_PrepareDirection );
+}
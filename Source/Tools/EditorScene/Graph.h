@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include "EditorScene/API.h"
 #include "Foundation/Event.h"     // for Helium::Delegate
 #include "EditorScene/SceneNode.h"
@@ -48,6 +50,11 @@ namespace Helium
 		// Manages the dependency graph defining relationships among dependency nodes.
 		// Evaluates dirty nodes when appropriate, and notifies interested listeners
 		// that evaluation has occurred.
+		//
+		// Dirty nodes are evaluated in topological levels.  A node that only became
+		// dirty because one of its inputs did is skipped if none of its inputs
+		// reported changed outputs, and the thread safe part of each level's
+		// evaluation is run in parallel.
 		// 
 		class HELIUM_EDITOR_SCENE_API Graph : public Reflect::Object
 		{
@@ -82,8 +89,14 @@ namespace Helium
 			EvaluateResult EvaluateGraph(bool silent = false);
 
 		private:
-			// walk upstream and evaluate graph
-			void Evaluate(Editor::SceneNode* node, GraphDirection direction);
+			// evaluate the dirty nodes in one direction level by level
+			void Evaluate(GraphDirection direction);
+
+			// did any input of a node change outputs during this evaluation
+			bool HasChangedInput(Editor::SceneNode* node, GraphDirection direction) const;
+
+			// job callback for the thread safe part of a level's evaluation
+			static void PrepareEvaluateCallback(void* context, size_t index);
 
 		protected:
 			mutable SceneGraphEvaluatedSignature::Event m_EvaluatedEvent;
@@ -118,6 +131,23 @@ namespace Helium
 
 			// number of nodes evaluated
 			S_SceneNodeDumbPtr m_EvaluatedNodes;
+
+			// nodes that only became dirty through an input, per direction
+			S_SceneNodeDumbPtr m_PropagatedNodes[ GraphDirections::Count ];
+
+			// evaluated nodes whose outputs changed, for the direction being evaluated
+			S_SceneNodeDumbPtr m_ChangedNodes;
+
+			// dirty nodes and the number of their dirty inputs not yet evaluated
+			std::map< Editor::SceneNode*, uint32_t > m_PendingInputs;
+
+			// nodes of the level being evaluated, the next level, and the nodes of the level that need evaluating
+			V_SceneNodeDumbPtr m_CurrentLevel;
+			V_SceneNodeDumbPtr m_NextLevel;
+			V_SceneNodeDumbPtr m_LevelEvaluations;
+
+			// direction of the level being prepared by job threads
+			GraphDirection m_PrepareDirection;
 		};
 	}
 }
\ No newline at end of file
@@ -40,7 +40,11 @@ HierarchyNode::HierarchyNode()
 	, m_Selectable( true )
 	, m_Highlighted( false )
 	, m_Reactive( false )
+	, m_EvaluatedVisible( true )
+	, m_EvaluatedSelectable( true )
 {
+	m_IsEvaluated[ GraphDirections::Downstream ] = false;
+	m_IsEvaluated[ GraphDirections::Upstream ] = false;
 }
 
 HierarchyNode::~HierarchyNode()
@@ -674,6 +678,42 @@ void HierarchyNode::Evaluate(GraphDirection direction)
 	Base::Evaluate(direction);
 }
 
+bool HierarchyNode::DoEvaluate(GraphDirection direction)
+{
+	Base::DoEvaluate(direction);
+
+	// our descendants read our global transform in both directions
+	const Editor::Transform* transform = GetTransform();
+	Matrix4 globalTransform = transform ? transform->GetGlobalTransform() : Matrix4::Identity;
+
+	bool changed = !m_IsEvaluated[direction] || memcmp( &globalTransform, &m_EvaluatedGlobalTransform[direction], sizeof( Matrix4 ) ) != 0;
+
+	switch (direction)
+	{
+	case GraphDirections::Downstream:
+		{
+			changed |= m_Visible != m_EvaluatedVisible || m_Selectable != m_EvaluatedSelectable;
+
+			m_EvaluatedVisible = m_Visible;
+			m_EvaluatedSelectable = m_Selectable;
+			break;
+		}
+
+	case GraphDirections::Upstream:
+		{
+			changed |= memcmp( &m_ObjectHierarchyBounds, &m_EvaluatedHierarchyBounds, sizeof( AlignedBox ) ) != 0;
+
+			m_EvaluatedHierarchyBounds = m_ObjectHierarchyBounds;
+			break;
+		}
+	}
+
+	m_EvaluatedGlobalTransform[direction] = globalTransform;
+	m_IsEvaluated[direction] = true;
+
+	return changed;
+}
+
 bool HierarchyNode::BoundsCheck(const Matrix4& instanceMatrix) const
 {
 	Editor::Camera* camera = m_Owner->GetViewport()->GetCamera();
@@ -239,6 +239,10 @@ namespace Helium
 			// update our global bounding volume for culling
 			virtual void Evaluate(GraphDirection direction) override;
 
+		protected:
+			// compares our outputs against the last evaluation so unchanged nodes don't dirty their dependents
+			virtual bool DoEvaluate(GraphDirection direction) override;
+
 		public:
 			// do bounds check
 			virtual bool BoundsCheck(const Matrix4& instanceMatrix) const;
@@ -322,6 +326,13 @@ namespace Helium
 			Layer*                      m_LayerColor;               // cached pointers to use for switching color modes in the 3D view
 			AlignedBox            m_ObjectBounds;             // bounds
 			AlignedBox            m_ObjectHierarchyBounds;
+
+			// Non-reflected, outputs as of our last graph evaluation
+			bool                        m_IsEvaluated[ GraphDirections::Count ];
+			Matrix4                     m_EvaluatedGlobalTransform[ GraphDirections::Count ];
+			AlignedBox                  m_EvaluatedHierarchyBounds;
+			bool                        m_EvaluatedVisible;
+			bool                        m_EvaluatedSelectable;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+
+#include "EditorScene/API.h"
+#include "EditorScene/Manipulator.h"
+#include "EditorScene/MergeableUndoCommand.h"
+
+namespace Helium
+{
+	namespace Editor
+	{
+		//
+		// Undo command for a single drag of a transform manipulator, storing
+		//  just the start and end values of each manipulated adapter.  Drags
+		//  of the same nodes in the same mode pushed in quick succession merge
+		//  into one command that keeps the first start and the last end.
+		//
+
+		template< class A, class V >
+		class ManipulatorUndoCommand : public MergeableUndoCommand
+		{
+		public:
+			ManipulatorUndoCommand( ManipulatorMode mode )
+				: m_Mode( mode )
+			{
+
+			}
+
+			// Record an adapter that has already been set to its end value
+			void Add( A* adapter, const V& start, const V& end )
+			{
+				Entry entry;
+				entry.m_Adapter = adapter;
+				entry.m_Start = start;
+				entry.m_End = end;
+				m_Entries.push_back( entry );
+			}
+
+			bool IsEmpty() const
+			{
+				return m_Entries.empty();
+			}
+
+			virtual void Undo() override
+			{
+				for ( typename std::vector< Entry >::const_reverse_iterator itr = m_Entries.rbegin(), end = m_Entries.rend(); itr != end; ++itr )
+				{
+					static_cast< A* >( itr->m_Adapter.Ptr() )->SetValue( itr->m_Start );
+				}
+			}
+
+			virtual void Redo() override
+			{
+				for ( typename std::vector< Entry >::const_iterator itr = m_Entries.begin(), end = m_Entries.end(); itr != end; ++itr )
+				{
+					static_cast< A* >( itr->m_Adapter.Ptr() )->SetValue( itr->m_End );
+				}
+			}
+
+			virtual size_t GetMemoryUsage() const override
+			{
+				return sizeof( *this ) + m_Entries.capacity() * sizeof( Entry );
+			}
+
+		protected:
+			virtual bool MergeCommand( const MergeableUndoCommand* command ) override
+			{
+				const ManipulatorUndoCommand* other = dynamic_cast< const ManipulatorUndoCommand* >( command );
+				if ( !other || other->m_Mode != m_Mode || other->m_Entries.size() != m_Entries.size() )
+				{
+					return false;
+				}
+
+				// the adapters are recreated with the selection, so compare the nodes they manipulate
+				for ( size_t i = 0; i < m_Entries.size(); ++i )
+				{
+					if ( m_Entries[ i ].m_Adapter->GetNode() != other->m_Entries[ i ].m_Adapter->GetNode() )
+					{
+						return false;
+					}
+				}
+
+				for ( size_t i = 0; i < m_Entries.size(); ++i )
+				{
+					m_Entries[ i ].m_Adapter = other->m_Entries[ i ].m_Adapter;
+					m_Entries[ i ].m_End = other->m_Entries[ i ].m_End;
+				}
+
+				return true;
+			}
+
+		private:
+			struct Entry
+			{
+				ManipulatorAdapterPtr   m_Adapter;
+				V                       m_Start;
+				V                       m_End;
+			};
+
+			ManipulatorMode         m_Mode;
+			std::vector< Entry >    m_Entries;
+		};
+	}
+}
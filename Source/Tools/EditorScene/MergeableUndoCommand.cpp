@@ -0,0 +1,36 @@
+#include "Precompile.h"
+#include "EditorScene/MergeableUndoCommand.h"
+
+#include "Platform/Timer.h"
+
+using namespace Helium;
+using namespace Helium::Editor;
+
+// Commands pushed further apart than this are deliberate, separate steps
+static const float32_t s_MergeWindowMilliseconds = 750.0f;
+
+MergeableUndoCommand::MergeableUndoCommand()
+	: m_Time( Timer::GetTickCount() )
+{
+}
+
+bool MergeableUndoCommand::Merge( const MergeableUndoCommand* command )
+{
+	if ( !command || command == this )
+	{
+		return false;
+	}
+
+	if ( command->m_Time < m_Time || Timer::TicksToMilliseconds( command->m_Time - m_Time ) > s_MergeWindowMilliseconds )
+	{
+		return false;
+	}
+
+	if ( !MergeCommand( command ) )
+	{
+		return false;
+	}
+
+	m_Time = command->m_Time;
+	return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Application/UndoQueue.h"
+
+#include "EditorScene/API.h"
+
+namespace Helium
+{
+	namespace Editor
+	{
+		//
+		// Undo command that can absorb the command pushed right after it, so a
+		//  burst of small edits (repeated drags of the same nodes, clicking
+		//  through the outliner) takes up a single undo step.  Only commands
+		//  pushed within a short time of each other are merged.
+		//
+		// Each command also estimates the memory it holds on to, so the owner
+		//  of the undo queue can cap how much the whole history keeps alive.
+		//
+
+		class HELIUM_EDITOR_SCENE_API MergeableUndoCommand : public UndoCommand
+		{
+		public:
+			MergeableUndoCommand();
+
+			// Merge the given command (which has already been applied) into this one,
+			//  returns false if it can't be merged and has to be pushed on its own
+			bool Merge( const MergeableUndoCommand* command );
+
+			// Estimated memory held by this command, in bytes
+			virtual size_t GetMemoryUsage() const = 0;
+
+		protected:
+			// Merge the effect of the given, later command into this one
+			virtual bool MergeCommand( const MergeableUndoCommand* command ) = 0;
+
+		private:
+			uint64_t m_Time;    // tick count of the last change recorded by this command
+		};
+
+		typedef Helium::SmartPtr< MergeableUndoCommand > MergeableUndoCommandPtr;
+	}
+}
@@ -0,0 +1,254 @@
+#include "Precompile.h"
+#include "PickBvh.h"
+
+#include "EditorScene/HierarchyNode.h"
+#include "EditorScene/Pick.h"
+#include "EditorScene/Transform.h"
+
+#include <algorithm>
+
+using namespace Helium;
+using namespace Helium::Editor;
+
+// maximum number of hierarchy nodes in a volume before it gets split
+static const uint32_t LeafVolumeSizeMax = 4;
+
+static const uint32_t InvalidIndex = 0xffffffff;
+
+static float32_t GetAxis( const Vector3& v, uint32_t axis )
+{
+	return axis == 0 ? v.x : ( axis == 1 ? v.y : v.z );
+}
+
+// orders leaf indices by their center along one axis
+struct PickBvh::LeafCenterLess
+{
+	const std::vector< Leaf >& m_Leaves;
+	uint32_t m_Axis;
+
+	LeafCenterLess( const std::vector< Leaf >& leaves, uint32_t axis )
+		: m_Leaves( leaves )
+		, m_Axis( axis )
+	{
+
+	}
+
+	bool operator()( uint32_t lhs, uint32_t rhs ) const
+	{
+		return GetAxis( m_Leaves[ lhs ].m_Center, m_Axis ) < GetAxis( m_Leaves[ rhs ].m_Center, m_Axis );
+	}
+};
+
+PickBvh::PickBvh()
+	: m_Dirty( true )
+{
+
+}
+
+void PickBvh::Clear()
+{
+	m_Leaves.clear();
+	m_LeafOrder.clear();
+	m_Nodes.clear();
+	m_Dirty = true;
+}
+
+void PickBvh::Update( Editor::HierarchyNode* root )
+{
+	if ( !m_Dirty )
+	{
+		return;
+	}
+
+	m_Dirty = false;
+
+	std::vector< Leaf > leaves;
+	leaves.reserve( m_Leaves.size() );
+	if ( root )
+	{
+		CollectLeaves( root, Matrix4::Identity, leaves );
+	}
+
+	// if the same nodes are in the same order, only their bounds can have changed, so refit the existing volumes
+	bool sameNodes = leaves.size() == m_Leaves.size() && !m_Nodes.empty();
+	for ( size_t i = 0; sameNodes && i < leaves.size(); ++i )
+	{
+		sameNodes = leaves[ i ].m_Node == m_Leaves[ i ].m_Node;
+	}
+
+	m_Leaves.swap( leaves );
+
+	if ( sameNodes )
+	{
+		RefitNodes();
+		return;
+	}
+
+	m_Nodes.clear();
+	m_LeafOrder.resize( m_Leaves.size() );
+	for ( uint32_t i = 0; i < m_LeafOrder.size(); ++i )
+	{
+		m_LeafOrder[ i ] = i;
+	}
+
+	if ( !m_Leaves.empty() )
+	{
+		m_Nodes.reserve( 2 * ( m_Leaves.size() / LeafVolumeSizeMax + 1 ) );
+		BuildNode( 0, static_cast< uint32_t >( m_Leaves.size() ) );
+	}
+}
+
+void PickBvh::Pick( PickVisitor* pick ) const
+{
+	if ( m_Nodes.empty() )
+	{
+		return;
+	}
+
+	// gather every leaf whose world space bounds the pick intersects
+	std::vector< uint32_t > candidates;
+	std::vector< uint32_t > stack;
+	stack.push_back( 0 );
+
+	pick->SetCurrentObject( NULL, Matrix4::Identity, Matrix4::Identity );
+
+	while ( !stack.empty() )
+	{
+		const Node& node = m_Nodes[ stack.back() ];
+		stack.pop_back();
+
+		if ( !pick->IntersectsBox( node.m_Bounds ) )
+		{
+			continue;
+		}
+
+		if ( node.m_Left == InvalidIndex )
+		{
+			for ( uint32_t i = node.m_First, end = node.m_First + node.m_Count; i < end; ++i )
+			{
+				uint32_t leafIndex = m_LeafOrder[ i ];
+				if ( pick->IntersectsBox( m_Leaves[ leafIndex ].m_Bounds ) )
+				{
+					candidates.push_back( leafIndex );
+				}
+			}
+		}
+		else
+		{
+			stack.push_back( node.m_Right );
+			stack.push_back( node.m_Left );
+		}
+	}
+
+	// test candidates in hierarchy order so hits are reported in the same order as a full hierarchy traversal
+	std::sort( candidates.begin(), candidates.end() );
+
+	for ( std::vector< uint32_t >::const_iterator itr = candidates.begin(), end = candidates.end(); itr != end; ++itr )
+	{
+		const Leaf& leaf = m_Leaves[ *itr ];
+		Editor::HierarchyNode* node = leaf.m_Node;
+
+		if ( node->BoundsCheck( leaf.m_Matrix ) && node->IsVisible() )
+		{
+			pick->SetCurrentObject( node, leaf.m_Matrix );
+
+			if ( pick->IntersectsBox( node->GetObjectHierarchyBounds() ) )
+			{
+				node->Pick( pick );
+			}
+		}
+	}
+}
+
+void PickBvh::CollectLeaves( Editor::HierarchyNode* node, const Matrix4& parentMatrix, std::vector< Leaf >& leaves ) const
+{
+	// accumulate the matrix the same way HierarchyPickTraverser does
+	Matrix4 matrix = node->GetTransform()->GetGlobalTransform() * parentMatrix;
+
+	leaves.push_back( Leaf() );
+	Leaf& leaf = leaves.back();
+	leaf.m_Node = node;
+	leaf.m_Matrix = matrix;
+	leaf.m_Bounds = node->GetObjectHierarchyBounds();
+	leaf.m_Bounds.Transform( matrix );
+	leaf.m_Center = leaf.m_Bounds.Center();
+
+	for ( OS_HierarchyNodeDumbPtr::Iterator itr = node->GetChildren().Begin(), end = node->GetChildren().End(); itr != end; ++itr )
+	{
+		CollectLeaves( *itr, matrix, leaves );
+	}
+}
+
+uint32_t PickBvh::BuildNode( uint32_t first, uint32_t count )
+{
+	uint32_t nodeIndex = static_cast< uint32_t >( m_Nodes.size() );
+	m_Nodes.push_back( Node() );
+
+	AlignedBox bounds;
+	AlignedBox centerBounds;
+	for ( uint32_t i = first, end = first + count; i < end; ++i )
+	{
+		const Leaf& leaf = m_Leaves[ m_LeafOrder[ i ] ];
+		bounds.Merge( leaf.m_Bounds );
+		centerBounds.Merge( leaf.m_Center );
+	}
+
+	uint32_t left = InvalidIndex;
+	uint32_t right = InvalidIndex;
+
+	if ( count > LeafVolumeSizeMax )
+	{
+		// split at the median center along the longest axis of the centers
+		Vector3 extent = centerBounds.maximum - centerBounds.minimum;
+		uint32_t axis = 0;
+		if ( extent.y > GetAxis( extent, axis ) )
+		{
+			axis = 1;
+		}
+		if ( extent.z > GetAxis( extent, axis ) )
+		{
+			axis = 2;
+		}
+
+		uint32_t half = count / 2;
+		std::vector< uint32_t >::iterator begin = m_LeafOrder.begin() + first;
+		std::nth_element( begin, begin + half, begin + count, LeafCenterLess( m_Leaves, axis ) );
+
+		left = BuildNode( first, half );
+		right = BuildNode( first + half, count - half );
+	}
+
+	Node& node = m_Nodes[ nodeIndex ];
+	node.m_Bounds = bounds;
+	node.m_First = first;
+	node.m_Count = count;
+	node.m_Left = left;
+	node.m_Right = right;
+
+	return nodeIndex;
+}
+
+void PickBvh::RefitNodes()
+{
+	// children always follow their parents, so walking backwards updates children first
+	for ( size_t i = m_Nodes.size(); i-- > 0; )
+	{
+		Node& node = m_Nodes[ i ];
+
+		AlignedBox bounds;
+		if ( node.m_Left == InvalidIndex )
+		{
+			for ( uint32_t j = node.m_First, end = node.m_First + node.m_Count; j < end; ++j )
+			{
+				bounds.Merge( m_Leaves[ m_LeafOrder[ j ] ].m_Bounds );
+			}
+		}
+		else
+		{
+			bounds.Merge( m_Nodes[ node.m_Left ].m_Bounds );
+			bounds.Merge( m_Nodes[ node.m_Right ].m_Bounds );
+		}
+
+		node.m_Bounds = bounds;
+	}
+}
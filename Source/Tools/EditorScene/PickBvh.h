@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Math/AlignedBox.h"
+#include "Math/Matrix4.h"
+
+#include <vector>
+
+#include "EditorScene/API.h"
+
+namespace Helium
+{
+	namespace Editor
+	{
+		class HierarchyNode;
+		class PickVisitor;
+
+		/////////////////////////////////////////////////////////////////////////////
+		// Bounding volume hierarchy over the world space hierarchy bounds of every
+		// hierarchy node in a scene, used to limit the nodes tested during a pick
+		// to those whose bounds the pick intersects.
+		// 
+		// The hierarchy is refit in place when only bounds or transforms have
+		// changed since it was last updated, and rebuilt when the set or order of
+		// hierarchy nodes has changed.
+		// 
+		class HELIUM_EDITOR_SCENE_API PickBvh
+		{
+		public:
+			PickBvh();
+
+			// flag that node bounds, transforms, or the hierarchy itself may have changed
+			void SetDirty()
+			{
+				m_Dirty = true;
+			}
+
+			bool IsDirty() const
+			{
+				return m_Dirty;
+			}
+
+			// free all nodes
+			void Clear();
+
+			// refit or rebuild from the given hierarchy root if dirty
+			void Update( Editor::HierarchyNode* root );
+
+			// test the pick against every node whose bounds it intersects, in hierarchy order
+			void Pick( PickVisitor* pick ) const;
+
+		private:
+			// a hierarchy node tested by picks
+			struct Leaf
+			{
+				Editor::HierarchyNode* m_Node;
+				Matrix4                m_Matrix;    // same pick matrix the hierarchy pick traversal computes
+				AlignedBox             m_Bounds;    // world space hierarchy bounds
+				Vector3                m_Center;
+			};
+
+			// a volume of the hierarchy, covering a range of m_LeafOrder
+			struct Node
+			{
+				AlignedBox m_Bounds;
+				uint32_t   m_First;
+				uint32_t   m_Count;
+				uint32_t   m_Left;             // child nodes, or invalid for leaf volumes
+				uint32_t   m_Right;
+			};
+
+			struct LeafCenterLess;
+
+			void CollectLeaves( Editor::HierarchyNode* node, const Matrix4& parentMatrix, std::vector< Leaf >& leaves ) const;
+			uint32_t BuildNode( uint32_t first, uint32_t count );
+			void RefitNodes();
+
+			std::vector< Leaf >     m_Leaves;      // in hierarchy traversal order
+			std::vector< uint32_t > m_LeafOrder;   // leaf indices grouped by volume
+			std::vector< Node >     m_Nodes;       // parents always precede their children
+			bool                    m_Dirty;
+		};
+	}
+}
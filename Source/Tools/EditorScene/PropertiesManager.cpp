@@ -9,6 +9,9 @@
 using namespace Helium;
 using namespace Helium::Editor;
 
+// number of recent selections to keep generated controls for
+static const size_t PROPERTIES_CACHE_SIZE = 8;
+
 PropertiesManager::PropertiesManager( PropertiesGenerator* generator, CommandQueue* commandQueue )
 	: m_Generator( generator )
 	, m_CommandQueue( commandQueue )
@@ -67,10 +70,10 @@ void PropertiesManager::CreateProperties()
 		m_Generator->Reset();
 	}
 
-	// early out if we have no objects to interpret
-	if ( m_Selection.Empty() )
+	// early out if we have no objects to interpret, or already did for this selection
+	std::vector< Inspect::ControlPtr > controls;
+	if ( m_Selection.Empty() || FindCachedProperties( controls ) )
 	{
-		std::vector< Inspect::ControlPtr > controls;
 		Present( m_SelectionId, controls );
 	}
 	else
@@ -273,6 +276,8 @@ void PropertiesManager::Present( uint32_t selectionId, const std::vector< Inspec
 	Inspect::Canvas* canvas = container->GetCanvas();
 
 	canvas->Realize( NULL );
+
+	CacheProperties( controls );
 }
 
 bool PropertiesManager::IsActive()
@@ -286,4 +291,68 @@ void PropertiesManager::SyncThreads()
 	{
 		Thread::Sleep( 1 );
 	}
-}
\ No newline at end of file
+}
+
+void PropertiesManager::InvalidateCache()
+{
+	m_Cache.clear();
+}
+
+bool PropertiesManager::FindCachedProperties( std::vector< Inspect::ControlPtr >& controls )
+{
+	HELIUM_EDITOR_SCENE_SCOPE_TIMER( "Properties Cache Lookup" );
+
+	for ( std::list< CachedProperties >::iterator itr = m_Cache.begin(), end = m_Cache.end(); itr != end; ++itr )
+	{
+		if ( itr->m_Style != m_Style || itr->m_ObjectRefs.size() != m_Selection.Size() )
+		{
+			continue;
+		}
+
+		// weak references so a new object allocated where a cached one used to be doesn't match
+		bool match = true;
+		size_t index = 0;
+		for ( OS_ObjectDumbPtr::Iterator objItr = m_Selection.Begin(), objEnd = m_Selection.End(); objItr != objEnd && match; ++objItr, ++index )
+		{
+			match = itr->m_ObjectRefs[ index ].Get() == *objItr;
+		}
+
+		if ( match )
+		{
+			controls = itr->m_Controls;
+			m_Cache.splice( m_Cache.begin(), m_Cache, itr );
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void PropertiesManager::CacheProperties( const std::vector< Inspect::ControlPtr >& controls )
+{
+	if ( m_Selection.Empty() || controls.empty() )
+	{
+		return;
+	}
+
+	std::vector< Inspect::ControlPtr > cached;
+	if ( FindCachedProperties( cached ) )
+	{
+		return;
+	}
+
+	m_Cache.push_front( CachedProperties () );
+
+	CachedProperties& entry = m_Cache.front();
+	entry.m_Style = m_Style;
+	entry.m_Controls = controls;
+	for ( OS_ObjectDumbPtr::Iterator itr = m_Selection.Begin(), end = m_Selection.End(); itr != end; ++itr )
+	{
+		entry.m_ObjectRefs.push_back( Helium::WeakPtr< Reflect::Object >( *itr ) );
+	}
+
+	if ( m_Cache.size() > PROPERTIES_CACHE_SIZE )
+	{
+		m_Cache.pop_back();
+	}
+}
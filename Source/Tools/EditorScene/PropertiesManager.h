@@ -1,5 +1,7 @@
 #pragma once
 
+#include <list>
+
 #include "Application/CommandQueue.h"
 #include "Inspect/Controls.h"
 
@@ -92,10 +94,28 @@ namespace Helium
 			// wait for threads to complete
 			void SyncThreads();
 
+			// drop cached controls, for when the structure of the selected objects may have changed
+			void InvalidateCache();
+
 			// event to raise when the properties are done being created
 			PropertiesCreatedSignature::Event e_PropertiesCreated;
 
 		private:
+			// look for controls already generated for the current selection, moving them to the front of the cache
+			bool FindCachedProperties( std::vector< Inspect::ControlPtr >& controls );
+			void CacheProperties( const std::vector< Inspect::ControlPtr >& controls );
+
+			// controls generated for a recent selection, presented again instead of re-interpreting the objects
+			struct CachedProperties
+			{
+				PropertiesStyle                                     m_Style;
+				std::vector< Helium::WeakPtr< Reflect::Object > >   m_ObjectRefs;
+				std::vector< Inspect::ControlPtr >                  m_Controls;
+			};
+
+			// most recently presented first
+			std::list< CachedProperties >   m_Cache;
+
 			// generator container
 			PropertiesGenerator*            m_Generator;
 
@@ -0,0 +1,98 @@
+#include "Precompile.h"
+#include "RenderList.h"
+
+#include "EditorScene/Camera.h"
+#include "EditorScene/HierarchyNode.h"
+#include "EditorScene/Render.h"
+#include "EditorScene/Transform.h"
+#include "EditorScene/Viewport.h"
+
+#include <algorithm>
+
+using namespace Helium;
+using namespace Helium::Editor;
+
+RenderList::RenderList()
+	: m_Dirty( true )
+{
+
+}
+
+void RenderList::Clear()
+{
+	m_Entries.clear();
+	m_Views.clear();
+	m_Dirty = true;
+}
+
+void RenderList::Update( Editor::HierarchyNode* root, const Editor::Viewport* view )
+{
+	// a viewport drawing twice from the same entries means a new frame has started
+	if ( !m_Dirty && std::find( m_Views.begin(), m_Views.end(), view ) == m_Views.end() )
+	{
+		m_Views.push_back( view );
+		return;
+	}
+
+	m_Dirty = false;
+	m_Views.clear();
+	m_Views.push_back( view );
+
+	size_t count = m_Entries.size();
+	m_Entries.clear();
+	m_Entries.reserve( count );
+
+	if ( root )
+	{
+		CollectEntries( root );
+	}
+}
+
+void RenderList::Render( RenderVisitor* render ) const
+{
+	const Editor::Camera* camera = render->GetViewport()->GetCamera();
+	bool culling = camera->IsViewFrustumCulling();
+
+	Matrix4 matrix = render->State().m_Matrix;
+
+	uint32_t count = static_cast< uint32_t >( m_Entries.size() );
+	for ( uint32_t i = 0; i < count; )
+	{
+		const Entry& entry = m_Entries[ i ];
+
+		// not visible, prune this node and its descendants
+		if ( culling && !camera->GetViewFrustum().IntersectsBox( entry.m_Bounds ) )
+		{
+			i = entry.m_SubtreeEnd;
+			continue;
+		}
+
+		if ( entry.m_Node->IsVisible() )
+		{
+			render->State().m_Matrix = entry.m_Matrix * matrix;
+			entry.m_Node->Render( render );
+			render->State().m_Matrix = matrix;
+		}
+
+		++i;
+	}
+}
+
+void RenderList::CollectEntries( Editor::HierarchyNode* node )
+{
+	uint32_t index = static_cast< uint32_t >( m_Entries.size() );
+
+	m_Entries.push_back( Entry() );
+	Entry& entry = m_Entries.back();
+	entry.m_Node = node;
+	entry.m_Matrix = node->GetTransform()->GetGlobalTransform();
+	entry.m_Bounds = node->GetObjectHierarchyBounds();
+	entry.m_Bounds.Transform( entry.m_Matrix );
+
+	for ( OS_HierarchyNodeDumbPtr::Iterator itr = node->GetChildren().Begin(), end = node->GetChildren().End(); itr != end; ++itr )
+	{
+		CollectEntries( *itr );
+	}
+
+	m_Entries[ index ].m_SubtreeEnd = static_cast< uint32_t >( m_Entries.size() );
+}
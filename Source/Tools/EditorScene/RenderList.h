@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Math/AlignedBox.h"
+#include "Math/Matrix4.h"
+
+#include <vector>
+
+#include "EditorScene/API.h"
+
+namespace Helium
+{
+	namespace Editor
+	{
+		class HierarchyNode;
+		class RenderVisitor;
+		class Viewport;
+
+		/////////////////////////////////////////////////////////////////////////////
+		// Flattened hierarchy of a scene's nodes with their world transforms and
+		// bounds, gathered once per frame and shared by every viewport drawing the
+		// scene, so each viewport only culls against its own camera and draws.
+		// 
+		// The list is regathered when the scene flags it dirty, or when a viewport
+		// that has already drawn from it draws again (the start of a new frame).
+		// 
+		class HELIUM_EDITOR_SCENE_API RenderList
+		{
+		public:
+			RenderList();
+
+			// flag that node bounds, transforms, or the hierarchy itself may have changed
+			void SetDirty()
+			{
+				m_Dirty = true;
+			}
+
+			// free all entries
+			void Clear();
+
+			// regather from the given hierarchy root if the viewport needs a fresh list
+			void Update( Editor::HierarchyNode* root, const Editor::Viewport* view );
+
+			// cull against the visitor's viewport camera and render what remains, in hierarchy order
+			void Render( RenderVisitor* render ) const;
+
+		private:
+			// a hierarchy node and the state its render traversal would compute
+			struct Entry
+			{
+				Editor::HierarchyNode* m_Node;
+				Matrix4                m_Matrix;      // global transform
+				AlignedBox             m_Bounds;      // world space hierarchy bounds
+				uint32_t               m_SubtreeEnd;  // index one past this node's last descendant
+			};
+
+			void CollectEntries( Editor::HierarchyNode* node );
+
+			std::vector< Entry >                    m_Entries;   // in hierarchy traversal order
+			std::vector< const Editor::Viewport* >  m_Views;     // viewports that have drawn the current entries
+			bool                                    m_Dirty;
+		};
+	}
+}
@@ -5,6 +5,7 @@
 #include "EditorScene/Viewport.h"
 #include "EditorScene/Camera.h"
 #include "EditorScene/Colors.h"
+#include "EditorScene/ManipulatorUndoCommand.h"
 
 #include "PrimitiveCircle.h"
 
@@ -95,22 +96,16 @@ void RotateManipulator::SetResult()
 				}
 				else
 				{
-					BatchUndoCommandPtr batch = new BatchUndoCommand ();
+					ManipulatorUndoCommand< RotateManipulatorAdapter, EulerAngles >* command = new ManipulatorUndoCommand< RotateManipulatorAdapter, EulerAngles >( m_Mode );
 
 					std::vector< RotateManipulatorAdapter* > set = CompleteSet<RotateManipulatorAdapter>();
 					for ( std::vector<RotateManipulatorAdapter*>::const_iterator itr = set.begin(), end = set.end(); itr != end; ++itr)
 					{
-						// get current (resultant) value
-						Vector3 result = (*itr)->GetValue().angles;
-
-						// set start value without undo support so its set for handling undo state
-						(*itr)->SetValue(EulerAngles (m_ManipulationStart.find( *itr )->second.m_StartValue));
-
-						// set result with undo support
-						batch->Push( (*itr)->SetValue(EulerAngles (result)) );
+						// the adapter already holds the current (resultant) value, just record where it started
+						command->Add( *itr, EulerAngles (m_ManipulationStart.find( *itr )->second.m_StartValue), (*itr)->GetValue() );
 					}
 
-					m_Scene->Push( batch );
+					m_Scene->Push( command );
 				}
 
 				// apply modification
@@ -5,6 +5,7 @@
 #include "EditorScene/Viewport.h"
 #include "EditorScene/Camera.h"
 #include "EditorScene/Colors.h"
+#include "EditorScene/ManipulatorUndoCommand.h"
 
 #include "PrimitiveAxes.h"
 #include "PrimitiveCube.h"
@@ -137,22 +138,16 @@ void ScaleManipulator::SetResult()
 				}
 				else
 				{
-					BatchUndoCommandPtr batch = new BatchUndoCommand ();
+					ManipulatorUndoCommand< ScaleManipulatorAdapter, Scale >* command = new ManipulatorUndoCommand< ScaleManipulatorAdapter, Scale >( m_Mode );
 
 					std::vector< ScaleManipulatorAdapter* > set = CompleteSet<ScaleManipulatorAdapter>();
 					for ( std::vector< ScaleManipulatorAdapter* >::const_iterator itr = set.begin(), end = set.end(); itr != end; ++itr )
 					{
-						// get current (resultant) value
-						Scale result ((*itr)->GetValue());
-
-						// set start value without undo support so its set for handling undo state
-						(*itr)->SetValue(Scale (m_ManipulationStart.find(*itr)->second.m_StartValue));
-
-						// set result with undo support
-						batch->Push ( (*itr)->SetValue(Scale (result)) );
+						// the adapter already holds the current (resultant) value, just record where it started
+						command->Add( *itr, Scale (m_ManipulationStart.find(*itr)->second.m_StartValue), (*itr)->GetValue() );
 					}
 
-					m_Scene->Push( batch );
+					m_Scene->Push( command );
 				}
 
 				// apply modification
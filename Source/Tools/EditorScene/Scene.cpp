@@ -328,6 +328,8 @@ void Scene::Reset()
 
 	// Break down entire graph
 	m_Graph->Reset();
+	m_PickBvh.Clear();
+	m_RenderList.Clear();
 
 	// Clear flat hash of nodes
 	m_Nodes.clear();
@@ -1189,6 +1191,8 @@ void Scene::RemoveObject( SceneNodePtr node )
 void Scene::AddSceneNode( const SceneNodePtr& node )
 {
 	node->SetOwner( this );
+	m_PickBvh.SetDirty();
+	m_RenderList.SetDirty();
 
 	{
 		HELIUM_EDITOR_SCENE_SCOPE_TIMER( "Insert in node list" );
@@ -1249,6 +1253,8 @@ void Scene::RemoveSceneNode( const SceneNodePtr& node )
 
 	// remove shortcuts to node and children
 	m_Nodes.erase( node->GetID() );
+	m_PickBvh.SetDirty();
+	m_RenderList.SetDirty();
 
 	// cleanup name
 	m_Names.erase( node->GetName() );
@@ -1294,9 +1300,9 @@ void Scene::Render( RenderVisitor* render )
 {
 	HELIUM_EDITOR_SCENE_RENDER_SCOPE_TIMER( "" );
 
-	HierarchyRenderTraverser renderTraverser ( render );
-
-	m_Root->TraverseHierarchy( &renderTraverser );
+	// traverse the hierarchy once per frame, however many viewports draw the scene
+	m_RenderList.Update( m_Root.Ptr(), render->GetViewport() );
+	m_RenderList.Render( render );
 }
 
 bool Scene::Pick( PickVisitor* pick ) const
@@ -1305,9 +1311,9 @@ bool Scene::Pick( PickVisitor* pick ) const
 
 	size_t hitCount = pick->GetHits().size();
 
-	HierarchyPickTraverser pickTraverser ( pick );
-
-	m_Root->TraverseHierarchy ( &pickTraverser );
+	// only test the nodes whose bounds the pick intersects
+	m_PickBvh.Update( m_Root.Ptr() );
+	m_PickBvh.Pick( pick );
 
 	return pick->GetHits().size() > hitCount;
 }
@@ -1621,6 +1627,13 @@ void Scene::Evaluate(bool silent)
 	HELIUM_EDITOR_SCENE_EVALUATE_SCOPE_TIMER( "" );
 
 	Editor::EvaluateResult result = m_Graph->EvaluateGraph(silent);
+
+	if ( result.m_NodeCount )
+	{
+		// bounds and transforms may have changed, refit picking volumes and regather render entries
+		m_PickBvh.SetDirty();
+		m_RenderList.SetDirty();
+	}
 }
 
 bool Scene::Push(const UndoCommandPtr& command)
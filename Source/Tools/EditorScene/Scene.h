@@ -18,6 +18,8 @@
 #include "Framework/SceneDefinition.h"
 
 #include "Pick.h"
+#include "PickBvh.h"
+#include "RenderList.h"
 #include "Tool.h"
 #include "SceneNode.h"
 #include "Graph.h"
@@ -470,6 +472,12 @@ namespace Helium
 			// container for nodes sorted by name
 			M_NameToSceneNodeDumbPtr m_Names;
 
+			// bounding volume hierarchy over the hierarchy nodes for picking
+			mutable PickBvh m_PickBvh;
+
+			// hierarchy nodes gathered once per frame for every viewport to render
+			RenderList m_RenderList;
+
 			// selection of this scene
 			Selection m_Selection;
 
@@ -152,6 +152,19 @@ void SceneManager::SaveAllScenes( std::string& error )
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Gathers the definitions of all the scenes, to be saved together.
+// 
+void SceneManager::GetSceneDefinitions( std::vector< AssetPtr >& definitions ) const
+{
+	M_SceneToDefinitionTable::const_iterator itr = m_SceneToDefinitionTable.begin();
+	M_SceneToDefinitionTable::const_iterator end = m_SceneToDefinitionTable.end();
+	for ( ; itr != end; ++itr )
+	{
+		definitions.push_back( itr->second );
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Removes a scene from this manager
 // 
@@ -70,6 +70,7 @@ namespace Helium
 			Editor::Scene* GetScene( const std::string& path ) const;
 			const M_SceneSmartPtr& GetScenes() const;
 			void SaveAllScenes( std::string& error );
+			void GetSceneDefinitions( std::vector< AssetPtr >& definitions ) const;
 			void RemoveScene( Editor::Scene* scene );
 			void RemoveAllScenes();
 
@@ -324,7 +324,7 @@ void SceneNode::Prune( V_SceneNodeDumbPtr& prunedNodes )
 	m_Graph->RemoveNode(this);
 }
 
-void SceneNode::DoEvaluate(GraphDirection direction)
+bool SceneNode::DoEvaluate(GraphDirection direction)
 {
 	HELIUM_EDITOR_SCENE_EVALUATE_SCOPE_TIMER( "Evaluate %s", GetMetaClass()->m_Name );
 
@@ -333,6 +333,9 @@ void SceneNode::DoEvaluate(GraphDirection direction)
 	Evaluate(direction);
 
 	m_NodeStates[direction] = NodeStates::Clean;
+
+	// we don't know what our dependents read, so assume it changed
+	return true;
 }
 
 uint32_t SceneNode::Dirty()
@@ -353,6 +356,11 @@ void SceneNode::Evaluate(GraphDirection direction)
 
 }
 
+void SceneNode::PrepareEvaluate(GraphDirection direction)
+{
+
+}
+
 void SceneNode::PopulateManifest( SceneManifest* manifest ) const
 {
 	// by default we reference no other assets
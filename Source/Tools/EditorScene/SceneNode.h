@@ -257,8 +257,8 @@ namespace Helium
 			//
 
 		protected:
-			// entry point from the graph
-			virtual void DoEvaluate(GraphDirection direction); friend Graph;
+			// entry point from the graph, returns true if any output read by our dependents may have changed
+			virtual bool DoEvaluate(GraphDirection direction); friend Graph;
 
 		public:
 			// Makes us Evaluate() on next graph evaluation
@@ -267,6 +267,10 @@ namespace Helium
 			// overridable method for derived classes
 			virtual void Evaluate(GraphDirection direction);
 
+			// overridable thread safe part of evaluation, called from job threads for every node of an evaluation
+			//  level before the level is evaluated; only write our own data and only read nodes from earlier levels
+			virtual void PrepareEvaluate(GraphDirection direction);
+
 			//
 			// Manifest
 			//
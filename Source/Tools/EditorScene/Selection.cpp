@@ -4,6 +4,7 @@
 #include "Foundation/Log.h"
 
 #include <algorithm>
+#include <set>
 
 using namespace Helium;
 using namespace Helium::Editor;
@@ -51,7 +52,7 @@ UndoCommandPtr Selection::Clear(const SelectionChangingSignature::Delegate& emit
 	m_SelectionChanging.RaiseWithEmitter( args, emitterChanging );
 	if ( !args.m_Veto )
 	{
-		command = new SelectionChangeCommand( this );
+		command = new SelectionChangeCommand( this, m_Items, empty );
 
 		OS_ObjectDumbPtr::Iterator itr = m_Items.Begin();
 		OS_ObjectDumbPtr::Iterator end = m_Items.End();
@@ -121,7 +122,7 @@ UndoCommandPtr Selection::SetItems(const OS_ObjectDumbPtr& items, const Selectio
 	m_SelectionChanging.RaiseWithEmitter( args , emitterChanging);
 	if ( !args.m_Veto )
 	{
-		command = new SelectionChangeCommand( this );
+		command = new SelectionChangeCommand( this, m_Items, selectableItems );
 
 		{
 			OS_ObjectDumbPtr::Iterator itr = m_Items.Begin();
@@ -219,7 +220,7 @@ UndoCommandPtr Selection::AddItems(const OS_ObjectDumbPtr &items, const Selectio
 		m_SelectionChanging.RaiseWithEmitter( args, emitterChanging );
 		if ( !args.m_Veto )
 		{
-			command = new SelectionChangeCommand( this );
+			command = new SelectionChangeCommand( this, m_Items, temp );
 
 			std::vector<Reflect::Object*>::iterator itr = added.begin();
 			std::vector<Reflect::Object*>::iterator end = added.end();
@@ -288,7 +289,7 @@ UndoCommandPtr Selection::RemoveItems(const OS_ObjectDumbPtr& items, const Selec
 	m_SelectionChanging.RaiseWithEmitter( args, emitterChanging );
 	if ( !args.m_Veto )
 	{
-		command = new SelectionChangeCommand( this );
+		command = new SelectionChangeCommand( this, m_Items, temp );
 
 		std::vector<Reflect::Object*>::iterator itr = removed.begin();
 		std::vector<Reflect::Object*>::iterator end = removed.end();
@@ -326,12 +327,107 @@ bool Selection::Contains(Reflect::Object* item) const
 	return false;
 }
 
-void Selection::GetUndo( OS_ObjectDumbPtr& outItems ) const
+void Selection::SetUndo( const std::vector<Reflect::Object*>& added, const std::vector<Reflect::Object*>& removed )
 {
-	outItems = GetItems();
+	OS_ObjectDumbPtr items = m_Items;
+
+	for ( std::vector<Reflect::Object*>::const_iterator itr = removed.begin(), end = removed.end(); itr != end; ++itr )
+	{
+		items.Remove( *itr );
+	}
+
+	for ( std::vector<Reflect::Object*>::const_iterator itr = added.begin(), end = added.end(); itr != end; ++itr )
+	{
+		items.Append( *itr );
+	}
+
+	SetItems( items );
 }
 
-void Selection::SetUndo( const OS_ObjectDumbPtr& items )
+Selection::SelectionChangeCommand::SelectionChangeCommand( Selection* selection, const OS_ObjectDumbPtr& previousItems, const OS_ObjectDumbPtr& items )
+	: m_Selection( selection )
 {
-	SetItems( items );
+	for ( OS_ObjectDumbPtr::Iterator itr = items.Begin(), end = items.End(); itr != end; ++itr )
+	{
+		if ( !previousItems.Contains( *itr ) )
+		{
+			m_Added.push_back( *itr );
+		}
+	}
+
+	for ( OS_ObjectDumbPtr::Iterator itr = previousItems.Begin(), end = previousItems.End(); itr != end; ++itr )
+	{
+		if ( !items.Contains( *itr ) )
+		{
+			m_Removed.push_back( *itr );
+		}
+	}
+}
+
+void Selection::SelectionChangeCommand::Undo()
+{
+	m_Selection->SetUndo( m_Removed, m_Added );
+}
+
+void Selection::SelectionChangeCommand::Redo()
+{
+	m_Selection->SetUndo( m_Added, m_Removed );
+}
+
+size_t Selection::SelectionChangeCommand::GetMemoryUsage() const
+{
+	return sizeof( *this ) + ( m_Added.capacity() + m_Removed.capacity() ) * sizeof( Reflect::Object* );
+}
+
+bool Selection::SelectionChangeCommand::MergeCommand( const MergeableUndoCommand* command )
+{
+	const SelectionChangeCommand* other = dynamic_cast< const SelectionChangeCommand* >( command );
+	if ( !other || other->m_Selection != m_Selection )
+	{
+		return false;
+	}
+
+	// objects added then removed again (or the other way around) didn't change at all
+	std::set<Reflect::Object*> otherAdded ( other->m_Added.begin(), other->m_Added.end() );
+	std::set<Reflect::Object*> otherRemoved ( other->m_Removed.begin(), other->m_Removed.end() );
+
+	std::vector<Reflect::Object*> added;
+	std::vector<Reflect::Object*> removed;
+
+	for ( std::vector<Reflect::Object*>::const_iterator itr = m_Added.begin(), end = m_Added.end(); itr != end; ++itr )
+	{
+		if ( otherRemoved.erase( *itr ) == 0 )
+		{
+			added.push_back( *itr );
+		}
+	}
+
+	for ( std::vector<Reflect::Object*>::const_iterator itr = m_Removed.begin(), end = m_Removed.end(); itr != end; ++itr )
+	{
+		if ( otherAdded.erase( *itr ) == 0 )
+		{
+			removed.push_back( *itr );
+		}
+	}
+
+	for ( std::vector<Reflect::Object*>::const_iterator itr = other->m_Added.begin(), end = other->m_Added.end(); itr != end; ++itr )
+	{
+		if ( otherAdded.find( *itr ) != otherAdded.end() )
+		{
+			added.push_back( *itr );
+		}
+	}
+
+	for ( std::vector<Reflect::Object*>::const_iterator itr = other->m_Removed.begin(), end = other->m_Removed.end(); itr != end; ++itr )
+	{
+		if ( otherRemoved.find( *itr ) != otherRemoved.end() )
+		{
+			removed.push_back( *itr );
+		}
+	}
+
+	m_Added.swap( added );
+	m_Removed.swap( removed );
+
+	return true;
 }
@@ -9,6 +9,7 @@
 
 #include "EditorScene/API.h"
 #include "EditorScene/SceneNode.h"
+#include "EditorScene/MergeableUndoCommand.h"
 
 namespace Helium
 {
@@ -48,22 +49,32 @@ namespace Helium
 		{
 		private:
 			//
-			// Command for item changes
+			// Command for item changes, only stores the objects that entered and
+			//  left the selection so big selections don't get copied every step
 			//
 
-			class SelectionChangeCommand : public PropertyUndoCommand< OS_ObjectDumbPtr >
+			class SelectionChangeCommand : public MergeableUndoCommand
 			{
 			public:
-				SelectionChangeCommand( Selection* selection )
-					: PropertyUndoCommand< OS_ObjectDumbPtr >( new Helium::MemberProperty< Selection, OS_ObjectDumbPtr > (selection, &Selection::GetUndo, &Selection::SetUndo) )
-				{
+				SelectionChangeCommand( Selection* selection, const OS_ObjectDumbPtr& previousItems, const OS_ObjectDumbPtr& items );
 
-				}
+				virtual void Undo() override;
+				virtual void Redo() override;
 
 				virtual bool IsSignificant() const override
 				{
 					return false;
 				}
+
+				virtual size_t GetMemoryUsage() const override;
+
+			protected:
+				virtual bool MergeCommand( const MergeableUndoCommand* command ) override;
+
+			private:
+				Selection*                      m_Selection;
+				std::vector<Reflect::Object*>   m_Added;
+				std::vector<Reflect::Object*>   m_Removed;
 			};
 
 			// The items of selected items
@@ -105,9 +116,8 @@ namespace Helium
 			bool Contains(Reflect::Object* item) const;
 
 		private:
-			// Getter/Setter that matches the prototype required by the undo queue
-			void GetUndo( OS_ObjectDumbPtr& outItems ) const;
-			void SetUndo( const OS_ObjectDumbPtr& items );
+			// Apply a change recorded by a SelectionChangeCommand
+			void SetUndo( const std::vector<Reflect::Object*>& added, const std::vector<Reflect::Object*>& removed );
 
 		private:
 			// fired before item changes, with the exiting set of selected objects
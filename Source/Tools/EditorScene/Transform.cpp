@@ -32,6 +32,11 @@ void Transform::PopulateMetaType( Reflect::MetaStruct& comp )
 Transform::Transform()
 	: m_InheritTransform( true )
 	, m_BindIsDirty( true )
+	, m_MatricesPrepared( false )
+	, m_MatricesValid( false )
+	, m_GlobalGeneration( 0 )
+	, m_ComputedParent( NULL )
+	, m_ComputedParentGeneration( 0 )
 {
 
 }
@@ -137,11 +142,14 @@ void Transform::SetObjectTransform( const Matrix4& transform )
 	m_Rotate = rotate;
 	m_Translate = translate;
 	m_ObjectTransform = transform;
+	m_MatricesValid = false;
 }
 
 void Transform::SetGlobalTransform( const Matrix4& transform )
 {
 	m_GlobalTransform = transform;
+	m_MatricesValid = false;
+	++m_GlobalGeneration;
 
 	ComputeObjectComponents();
 }
@@ -246,77 +254,104 @@ void Transform::Evaluate(GraphDirection direction)
 	{
 	case GraphDirections::Downstream:
 		{
+			if (!m_MatricesPrepared)
 			{
-				HELIUM_EDITOR_SCENE_EVALUATE_SCOPE_TIMER( "Compose Local Matrices" );
+				ComputeMatrices();
+			}
 
-				//
-				// Compute Local Transform
-				//
+			m_MatricesPrepared = false;
+			break;
+		}
 
-				m_ObjectTransform = GetScaleComponent() * GetRotateComponent() * GetTranslateComponent();
-			}
+	case GraphDirections::Upstream:
+		break;
+	}
 
+	Base::Evaluate(direction);
+}
 
-			{
-				HELIUM_EDITOR_SCENE_EVALUATE_SCOPE_TIMER( "Compute Global Matrices" );
-
-				//
-				// Compute Global Transform
-				//
-
-				if (m_Parent == NULL || !GetInheritTransform())
-				{
-					m_GlobalTransform = m_ObjectTransform;
-				}
-				else
-				{
-					m_GlobalTransform = m_ObjectTransform * m_Parent->GetTransform()->GetGlobalTransform();
-				}
-			}
+void Transform::PrepareEvaluate(GraphDirection direction)
+{
+	// matrix math only reads our components and our parent's global transform, which is evaluated in an earlier level
+	if (direction == GraphDirections::Downstream)
+	{
+		ComputeMatrices();
+		m_MatricesPrepared = true;
+	}
 
+	Base::PrepareEvaluate(direction);
+}
 
-			{
-				HELIUM_EDITOR_SCENE_EVALUATE_SCOPE_TIMER( "Compute Inverse Matrices" );
+void Transform::ComputeMatrices()
+{
+	//
+	// Compute Local Transform
+	//
 
-				//
-				// Compute Inverses
-				//
+	Matrix4 objectTransform = GetScaleComponent() * GetRotateComponent() * GetTranslateComponent();
 
-				m_InverseObjectTransform = m_ObjectTransform;
-				m_InverseObjectTransform.Invert();
+	const Editor::Transform* parent = ( m_Parent == NULL || !GetInheritTransform() ) ? NULL : m_Parent->GetTransform();
+	uint32_t parentGeneration = parent ? parent->GetGlobalGeneration() : 0;
 
-				m_InverseGlobalTransform = m_GlobalTransform;
-				m_InverseGlobalTransform.Invert();
-			}
+	// if neither our components nor our parent's global transform changed, the chain and inverses are still good
+	bool upToDate = m_MatricesValid
+		&& parent == m_ComputedParent
+		&& parentGeneration == m_ComputedParentGeneration
+		&& memcmp( &objectTransform, &m_ObjectTransform, sizeof( Matrix4 ) ) == 0;
+
+	if (!upToDate)
+	{
+		m_ObjectTransform = objectTransform;
 
 
-			//
-			// Compute Object and Global Bind Transform, if Dirty
-			//
+		//
+		// Compute Global Transform
+		//
 
-			if (m_BindIsDirty)
-			{
-				HELIUM_EDITOR_SCENE_EVALUATE_SCOPE_TIMER( "Compute Bind Matrix and Inverse" );
+		if (parent == NULL)
+		{
+			m_GlobalTransform = m_ObjectTransform;
+		}
+		else
+		{
+			m_GlobalTransform = m_ObjectTransform * parent->GetGlobalTransform();
+		}
 
-				if (m_Parent == NULL)
-					m_BindTransform = m_ObjectTransform;
-				else
-					m_BindTransform = m_ObjectTransform * m_Parent->GetTransform()->GetBindTransform();
+		++m_GlobalGeneration;
 
-				m_InverseBindTransform = m_BindTransform;
-				m_InverseBindTransform.Invert();
 
-				m_BindIsDirty = false;
-			}
+		//
+		// Compute Inverses
+		//
 
-			break;
-		}
+		m_InverseObjectTransform = m_ObjectTransform;
+		m_InverseObjectTransform.Invert();
 
-	case GraphDirections::Upstream:
-		break;
+		m_InverseGlobalTransform = m_GlobalTransform;
+		m_InverseGlobalTransform.Invert();
+
+		m_ComputedParent = parent;
+		m_ComputedParentGeneration = parentGeneration;
+		m_MatricesValid = true;
 	}
 
-	Base::Evaluate(direction);
+
+	//
+	// Compute Object and Global Bind Transform, if Dirty
+	//
+
+	if (m_BindIsDirty)
+	{
+		if (m_Parent == NULL)
+			m_BindTransform = m_ObjectTransform;
+		else
+			m_BindTransform = m_ObjectTransform * m_Parent->GetTransform()->GetBindTransform();
+
+		m_InverseBindTransform = m_BindTransform;
+		m_InverseBindTransform.Invert();
+
+		m_BindIsDirty = false;
+	}
 }
 
 void Transform::Render( RenderVisitor* render )
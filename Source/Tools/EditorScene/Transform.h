@@ -104,6 +104,12 @@ namespace Helium
 
 			void SetGlobalTransform( const Matrix4& transform );
 
+			// bumped every time the global transform changes, so children can tell when to recompute theirs
+			uint32_t GetGlobalGeneration() const
+			{
+				return m_GlobalGeneration;
+			}
+
 			//
 			// Binding Matrices
 			//
@@ -140,6 +146,15 @@ namespace Helium
 			// compute all member matrices
 			virtual void Evaluate( GraphDirection direction ) override;
 
+			// compute all member matrices from a job thread ahead of Evaluate()
+			virtual void PrepareEvaluate( GraphDirection direction ) override;
+
+		private:
+			// compose our local matrix, chain it to our parent, and compute inverses
+			void ComputeMatrices();
+
+		public:
+
 			// render to viewport
 			virtual void Render( RenderVisitor* render ) override;
 
@@ -164,6 +179,11 @@ namespace Helium
 			bool          m_BindIsDirty;
 			Matrix4       m_BindTransform;
 			Matrix4       m_InverseBindTransform;
+			bool          m_MatricesPrepared;     // were our matrices already computed by PrepareEvaluate()?
+			bool          m_MatricesValid;        // do our matrices match the inputs recorded below?
+			uint32_t      m_GlobalGeneration;
+			const Editor::Transform* m_ComputedParent;            // parent transform our matrices were computed against
+			uint32_t                 m_ComputedParentGeneration;  // and its generation at the time
 		};
 
 		class TransformScaleManipulatorAdapter : public ScaleManipulatorAdapter
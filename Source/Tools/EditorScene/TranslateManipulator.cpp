@@ -5,6 +5,7 @@
 #include "EditorScene/Viewport.h"
 #include "EditorScene/Camera.h"
 #include "EditorScene/Colors.h"
+#include "EditorScene/ManipulatorUndoCommand.h"
 
 #include "PrimitiveAxes.h"
 #include "PrimitiveCone.h"
@@ -157,22 +158,16 @@ void TranslateManipulator::SetResult()
 				}
 				else
 				{
-					BatchUndoCommandPtr batch = new BatchUndoCommand ();
+					ManipulatorUndoCommand< TranslateManipulatorAdapter, Vector3 >* command = new ManipulatorUndoCommand< TranslateManipulatorAdapter, Vector3 >( m_Mode );
 
 					std::vector< TranslateManipulatorAdapter* > set = CompleteSet<TranslateManipulatorAdapter>();
 					for ( std::vector< TranslateManipulatorAdapter* >::const_iterator itr = set.begin(), end = set.end(); itr != end; ++itr )
 					{
-						// get current (resultant) value
-						Vector3 result = (*itr)->GetValue();
-
-						// set start value without undo support so its set for handling undo state
-						(*itr)->SetValue(m_ManipulationStart.find(*itr)->second.m_StartValue);
-
-						// set result with undo support
-						batch->Push( (*itr)->SetValue(result) );
+						// the adapter already holds the current (resultant) value, just record where it started
+						command->Add( *itr, m_ManipulationStart.find(*itr)->second.m_StartValue, (*itr)->GetValue() );
 					}
 
-					m_Scene->Push( batch );
+					m_Scene->Push( command );
 				}
 
 				// apply modification
@@ -283,19 +283,25 @@ void Viewport::OnResize()
 
 	if (m_World)
 	{
-		Renderer* pRenderer = Renderer::GetInstance();
+		GraphicsScene* pGraphicsScene = GetGraphicsScene();
+		GraphicsSceneView* pSceneView = pGraphicsScene->GetSceneView( m_SceneViewId );
 
-		Renderer::ContextInitParameters ctxParams;
-		ctxParams.pWindow = m_Window;
-		ctxParams.displayWidth = width;
-		ctxParams.displayHeight = height;
-		ctxParams.bFullscreen = false;
-		ctxParams.bVsync = false;
+		// Resize the existing swap chain in place if possible, rather than creating a new context on every resize.
+		RRenderContextPtr renderCtx = pSceneView->GetRenderContext();
+		if ( !renderCtx || !renderCtx->Resize( width, height ) )
+		{
+			Renderer* pRenderer = Renderer::GetInstance();
 
-		RRenderContextPtr renderCtx = pRenderer->CreateSubContext( ctxParams );
+			Renderer::ContextInitParameters ctxParams;
+			ctxParams.pWindow = m_Window;
+			ctxParams.displayWidth = width;
+			ctxParams.displayHeight = height;
+			ctxParams.bFullscreen = false;
+			ctxParams.presentMode = RENDERER_PRESENT_MODE_IMMEDIATE;
+
+			renderCtx = pRenderer->CreateSubContext( ctxParams );
+		}
 
-		GraphicsScene* pGraphicsScene = GetGraphicsScene();
-		GraphicsSceneView* pSceneView = pGraphicsScene->GetSceneView( m_SceneViewId );
 		pSceneView->SetRenderContext( renderCtx );
 		HELIUM_ASSERT( RenderResourceManager::GetInstance() );
 		pSceneView->SetDepthStencilSurface( RenderResourceManager::GetInstance()->GetDepthStencilSurface() );
@@ -12,6 +12,11 @@ project( prefix .. "MathSimd" )
 		"Source/Engine/MathSimd/**",
 	}
 
+	excludes
+	{
+		"Source/Engine/MathSimd/*Benchmarks.*",
+	}
+
 	configuration "SharedLib"
 		links
 		{
@@ -24,6 +29,26 @@ project( prefix .. "MathSimd" )
 
 	configuration {}
 
+project( prefix .. "MathSimdBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+
+	files
+	{
+		"Source/Engine/MathSimd/*Benchmarks.*",
+	}
+
+	links
+	{
+		prefix .. "MathSimd",
+
+		-- core
+		prefix .. "Persist",
+		prefix .. "Reflect",
+		prefix .. "Foundation",
+		prefix .. "Platform",
+	}
+
 project( prefix .. "Engine" )
 
 	Helium.DoModuleProjectSettings( "Source/Engine", "HELIUM", "Engine", "ENGINE" )
@@ -33,6 +58,11 @@ project( prefix .. "Engine" )
 		"Source/Engine/Engine/*",
 	}
 
+	includedirs
+	{
+		"Dependencies/zlib",
+	}
+
 	configuration "SharedLib"
 		links
 		{
@@ -44,6 +74,8 @@ project( prefix .. "Engine" )
 			prefix .. "Reflect",
 			prefix .. "Foundation",
 			prefix .. "Platform",
+
+			"zlib",
 		}
 
 project( prefix .. "EngineJobs" )
@@ -295,6 +327,11 @@ project( prefix .. "Components" )
 		"Source/Engine/Components/*",
 	}
 
+	excludes
+	{
+		"Source/Engine/Components/*Benchmarks.*",
+	}
+
 	configuration "SharedLib"
 		links
 		{
@@ -315,6 +352,37 @@ project( prefix .. "Components" )
 			prefix .. "Platform",
 		}
 
+project( prefix .. "PersistBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+	Helium.DoGraphicsProjectSettings()
+
+	files
+	{
+		"Source/Engine/Components/*Benchmarks.*",
+	}
+
+	links
+	{
+		prefix .. "Components",
+		prefix .. "Graphics",
+		prefix .. "GraphicsJobs",
+		prefix .. "GraphicsTypes",
+		prefix .. "Rendering",
+		prefix .. "Framework",
+		prefix .. "Engine",
+		prefix .. "EngineJobs",
+		prefix .. "Ois",
+		prefix .. "MathSimd",
+
+		-- core
+		prefix .. "Math",
+		prefix .. "Persist",
+		prefix .. "Reflect",
+		prefix .. "Foundation",
+		prefix .. "Platform",
+	}
+
 project( prefix .. "Bullet" )
 
 	Helium.DoModuleProjectSettings( "Source/Engine", "HELIUM", "Bullet", "BULLET" )
@@ -396,6 +464,11 @@ project( prefix .. "Framework" )
 		"Source/Engine/Framework/*",
 	}
 
+	excludes
+	{
+		"Source/Engine/Framework/*Benchmarks.*",
+	}
+
 	configuration "SharedLib"
 		links
 		{
@@ -411,6 +484,32 @@ project( prefix .. "Framework" )
 			prefix .. "Platform",
 		}
 
+	configuration {}
+
+project( prefix .. "FrameworkBenchmarks" )
+
+	Helium.DoBenchmarksProjectSettings()
+
+	files
+	{
+		"Source/Engine/Framework/*Benchmarks.*",
+	}
+
+	links
+	{
+		prefix .. "Framework",
+		prefix .. "Engine",
+		prefix .. "EngineJobs",
+		prefix .. "MathSimd",
+
+		-- core
+		prefix .. "Math",
+		prefix .. "Persist",
+		prefix .. "Reflect",
+		prefix .. "Foundation",
+		prefix .. "Platform",
+	}
+
 project( prefix .. "FrameworkImpl" )
 
 	Helium.DoModuleProjectSettings( "Source/Engine", "HELIUM", "FrameworkImpl", "FRAMEWORK_IMPL" )
@@ -167,6 +167,65 @@ project( prefix .. "EditorScene" )
 		}
 	end
 
+-- Headless batch cook, without wxWidgets or a renderer so it can run on build machines.
+project( prefix .. "Cook" )
+
+	kind "ConsoleApp"
+
+	Helium.DoBasicProjectSettings()
+	Helium.DoGraphicsProjectSettings()
+	Helium.DoFbxProjectSettings()
+
+	targetname "HeliumCook"
+
+	files
+	{
+		"Source/Tools/Cook/*",
+	}
+
+	defines
+	{
+		"HELIUM_HEAP=1",
+		"HELIUM_MODULE=Cook",
+	}
+
+	links
+	{
+		prefix .. "PreprocessingPc",
+		prefix .. "PcSupport",
+		prefix .. "EditorSupport",
+		prefix .. "Framework",
+		prefix .. "Graphics",
+		prefix .. "GraphicsJobs",
+		prefix .. "GraphicsTypes",
+		prefix .. "Rendering",
+		prefix .. "Windowing",
+		prefix .. "EngineJobs",
+		prefix .. "Engine",
+		prefix .. "MathSimd",
+
+		-- core
+		prefix .. "Math",
+		prefix .. "Persist",
+		prefix .. "Reflect",
+		prefix .. "Foundation",
+		prefix .. "Platform",
+
+		"mongo-c",
+	}
+
+	configuration "linux"
+		links
+		{
+			"pthread",
+			"dl",
+			"rt",
+			"m",
+			"stdc++",
+		}
+
+	configuration {}
+
 project( prefix .. "Editor" )
 
 	kind "ConsoleApp"
@@ -127,6 +127,12 @@ Helium.DoBasicProjectSettings = function()
 		}
 	end
 
+	-- Bullet is built with its multithreaded pipeline available (see the bullet project), and its headers must agree
+	defines
+	{
+		"BT_THREADSAFE=1",
+	}
+
 	includedirs
 	{
 		"Core/Source",
@@ -209,6 +215,34 @@ Helium.DoTestsProjectSettings = function()
 
 end
 
+-- Benchmarks are console apps like tests, but are not run as a post-build step since timings need a quiet machine.
+Helium.DoBenchmarksProjectSettings = function()
+
+	configuration {}
+
+	kind "ConsoleApp"
+
+	Helium.DoBasicProjectSettings()
+
+	includedirs
+	{
+		".",
+	}
+
+	configuration "linux"
+		links
+		{
+			"pthread",
+			"dl",
+			"rt",
+			"m",
+			"stdc++",
+		}
+
+	configuration {}
+
+end
+
 Helium.DoGraphicsProjectSettings = function()
 
 	configuration {}
@@ -413,6 +447,7 @@ Helium.DoGameProjectSettings = function( name )
 		"bullet",
 		"mongo-c",
 		"ois",
+		"zlib",
 	}
 
 	if _OPTIONS[ "gfxapi" ] == "opengl" then